@@ -14,6 +14,8 @@
 #include <getopt.h>
 #include <unistd.h>
 #include <strings.h>
+#include <signal.h>
+#include <sys/time.h>
 
 #include <rte_eal.h>
 #include <rte_common.h>
@@ -24,6 +26,7 @@
 #include <rte_memzone.h>
 #include <rte_launch.h>
 #include <rte_tailq.h>
+#include <rte_eal_memconfig.h>
 #include <rte_per_lcore.h>
 #include <rte_lcore.h>
 #include <rte_log.h>
@@ -94,6 +97,11 @@ static char *mempool_name;
 /**< Enable iter mempool. */
 static uint32_t enable_iter_mempool;
 static char *mempool_iter_name;
+/**< Enable monitor mode, sampling every interval seconds. */
+static uint32_t enable_monitor;
+static double monitor_interval = 1.0;
+/**< Number of monitor samples, 0 for no limit. */
+static uint32_t monitor_count;
 
 /**< display usage */
 static void
@@ -119,7 +127,12 @@ proc_info_usage(const char *prgname)
 		"  --show-crypto: to display crypto information\n"
 		"  --show-ring[=name]: to display ring information\n"
 		"  --show-mempool[=name]: to display mempool information\n"
-		"  --iter-mempool=name: iterate mempool elements to display content\n",
+		"  --iter-mempool=name: iterate mempool elements to display content\n"
+		"  --monitor[=SECONDS]: to display per second rates of ports, queues,"
+			" and of rings and mempools selected by --show-ring and"
+			" --show-mempool, every SECONDS (default 1) as JSON lines,"
+			" or in collectd format with --collectd-format\n"
+		"  --monitor-count=N: to stop monitoring after N samples\n",
 		prgname);
 }
 
@@ -226,6 +239,8 @@ proc_info_parse_args(int argc, char **argv)
 		{"show-ring", optional_argument, NULL, 0},
 		{"show-mempool", optional_argument, NULL, 0},
 		{"iter-mempool", required_argument, NULL, 0},
+		{"monitor", optional_argument, NULL, 0},
+		{"monitor-count", required_argument, NULL, 0},
 		{NULL, 0, 0, 0}
 	};
 
@@ -288,6 +303,22 @@ proc_info_parse_args(int argc, char **argv)
 					"iter-mempool", MAX_LONG_OPT_SZ)) {
 				enable_iter_mempool = 1;
 				mempool_iter_name = optarg;
+			} else if (!strncmp(long_option[option_index].name,
+					"monitor", MAX_LONG_OPT_SZ)) {
+				enable_monitor = 1;
+				if (optarg != NULL) {
+					char *end;
+
+					monitor_interval = strtod(optarg, &end);
+					if (*end != '\0' ||
+					    !(monitor_interval >= 0.01)) {
+						printf("Invalid monitor interval\n");
+						return -1;
+					}
+				}
+			} else if (!strncmp(long_option[option_index].name,
+					"monitor-count", MAX_LONG_OPT_SZ)) {
+				monitor_count = strtoul(optarg, NULL, 10);
 			}
 			break;
 		case 1:
@@ -1349,6 +1380,324 @@ iter_mempool(char *name)
 	}
 }
 
+/* Monitor mode */
+
+#define MONITOR_MAX_OBJS 256
+
+/* Previous counters of a ring or mempool */
+struct monitor_obj {
+	const void *ptr;
+	uint32_t sample;
+	uint64_t prev[2];
+};
+
+static volatile sig_atomic_t monitor_quit;
+static FILE *monitor_out;
+static uint32_t monitor_sample;
+static double monitor_dt;
+static uint32_t monitor_nb_objs_out;
+static char monitor_plugin[MAX_STRING_LEN];
+static struct rte_eth_stats monitor_port_prev[RTE_MAX_ETHPORTS];
+static struct monitor_obj monitor_objs[MONITOR_MAX_OBJS];
+static uint32_t monitor_nb_objs;
+
+static void
+monitor_signal_handler(int signum __rte_unused)
+{
+	monitor_quit = 1;
+}
+
+/* Per second rate of a counter, 0 if it was reset */
+static double
+monitor_rate(uint64_t cur, uint64_t prev)
+{
+	if (cur < prev)
+		return 0;
+	return (double)(cur - prev) / monitor_dt;
+}
+
+/*
+ * Find the previous counters of a ring or mempool, return NULL the first
+ * time it is seen, as its rates cannot be computed yet.
+ */
+static struct monitor_obj *
+monitor_obj_get(const void *ptr, uint64_t v0, uint64_t v1)
+{
+	struct monitor_obj *obj = NULL;
+	bool known = false;
+	uint32_t i;
+
+	for (i = 0; i < monitor_nb_objs; i++) {
+		if (monitor_objs[i].ptr == ptr) {
+			obj = &monitor_objs[i];
+			known = obj->sample + 1 == monitor_sample;
+			break;
+		}
+	}
+	if (obj == NULL) {
+		if (monitor_nb_objs == MONITOR_MAX_OBJS)
+			return NULL;
+		obj = &monitor_objs[monitor_nb_objs++];
+		obj->ptr = ptr;
+	}
+
+	if (!known) {
+		obj->sample = monitor_sample;
+		obj->prev[0] = v0;
+		obj->prev[1] = v1;
+		return NULL;
+	}
+	return obj;
+}
+
+static void
+monitor_obj_begin(const char *type, const char *id)
+{
+	if (enable_collectd_format) {
+		snprintf(monitor_plugin, sizeof(monitor_plugin),
+			"%s/dpdkstat-%s.%s", host_id, type, id);
+		return;
+	}
+
+	fprintf(monitor_out, "%s{\"type\":\"%s\",\"id\":\"%s\"",
+		monitor_nb_objs_out++ ? "," : "", type, id);
+}
+
+static void
+monitor_obj_value(const char *name, double value)
+{
+	if (enable_collectd_format)
+		fprintf(monitor_out, "PUTVAL %s/gauge-%s interval=%.3f N:%.3f\n",
+			monitor_plugin, name, monitor_interval, value);
+	else
+		fprintf(monitor_out, ",\"%s\":%.3f", name, value);
+}
+
+static void
+monitor_obj_end(void)
+{
+	if (!enable_collectd_format)
+		fprintf(monitor_out, "}");
+}
+
+static void
+monitor_port(uint16_t port_id)
+{
+	struct rte_eth_stats *prev = &monitor_port_prev[port_id];
+	struct rte_eth_dev_info dev_info;
+	struct rte_eth_stats stats;
+	char id[MAX_STRING_LEN];
+	uint16_t q, nb_q;
+
+	if (rte_eth_stats_get(port_id, &stats) != 0)
+		return;
+	if (monitor_sample == 0)
+		goto out;
+
+	snprintf(id, sizeof(id), "%u", port_id);
+	monitor_obj_begin("port", id);
+	monitor_obj_value("rx_pps", monitor_rate(stats.ipackets,
+		prev->ipackets));
+	monitor_obj_value("tx_pps", monitor_rate(stats.opackets,
+		prev->opackets));
+	monitor_obj_value("rx_bps", 8 * monitor_rate(stats.ibytes,
+		prev->ibytes));
+	monitor_obj_value("tx_bps", 8 * monitor_rate(stats.obytes,
+		prev->obytes));
+	monitor_obj_value("rx_missed_ps", monitor_rate(stats.imissed,
+		prev->imissed));
+	monitor_obj_value("rx_errors_ps", monitor_rate(stats.ierrors,
+		prev->ierrors));
+	monitor_obj_value("tx_errors_ps", monitor_rate(stats.oerrors,
+		prev->oerrors));
+	monitor_obj_value("rx_nombuf_ps", monitor_rate(stats.rx_nombuf,
+		prev->rx_nombuf));
+	monitor_obj_end();
+
+	/* per queue counters exist for the first queues only */
+	if (rte_eth_dev_info_get(port_id, &dev_info) != 0)
+		goto out;
+
+	nb_q = RTE_MIN(dev_info.nb_rx_queues, RTE_ETHDEV_QUEUE_STAT_CNTRS);
+	for (q = 0; q < nb_q; q++) {
+		snprintf(id, sizeof(id), "%u.%u", port_id, q);
+		monitor_obj_begin("rxq", id);
+		monitor_obj_value("pps", monitor_rate(stats.q_ipackets[q],
+			prev->q_ipackets[q]));
+		monitor_obj_value("bps", 8 * monitor_rate(stats.q_ibytes[q],
+			prev->q_ibytes[q]));
+		monitor_obj_value("errors_ps", monitor_rate(stats.q_errors[q],
+			prev->q_errors[q]));
+		monitor_obj_end();
+	}
+
+	nb_q = RTE_MIN(dev_info.nb_tx_queues, RTE_ETHDEV_QUEUE_STAT_CNTRS);
+	for (q = 0; q < nb_q; q++) {
+		snprintf(id, sizeof(id), "%u.%u", port_id, q);
+		monitor_obj_begin("txq", id);
+		monitor_obj_value("pps", monitor_rate(stats.q_opackets[q],
+			prev->q_opackets[q]));
+		monitor_obj_value("bps", 8 * monitor_rate(stats.q_obytes[q],
+			prev->q_obytes[q]));
+		monitor_obj_end();
+	}
+
+out:
+	*prev = stats;
+}
+
+static void
+monitor_ring(const struct rte_ring *r)
+{
+	/* the tails are at the same place for all the sync types */
+	uint32_t prod = __atomic_load_n(&r->prod.tail, __ATOMIC_RELAXED);
+	uint32_t cons = __atomic_load_n(&r->cons.tail, __ATOMIC_RELAXED);
+	struct monitor_obj *obj;
+
+	obj = monitor_obj_get(r, prod, cons);
+	if (obj == NULL)
+		return;
+
+	monitor_obj_begin("ring", r->name);
+	monitor_obj_value("count", rte_ring_count(r));
+	monitor_obj_value("free", rte_ring_free_count(r));
+	/* the ring indexes wrap at 2^32 */
+	monitor_obj_value("enqueue_ps",
+		(uint32_t)(prod - (uint32_t)obj->prev[0]) / monitor_dt);
+	monitor_obj_value("dequeue_ps",
+		(uint32_t)(cons - (uint32_t)obj->prev[1]) / monitor_dt);
+	monitor_obj_end();
+
+	obj->sample = monitor_sample;
+	obj->prev[0] = prod;
+	obj->prev[1] = cons;
+}
+
+static void
+monitor_rings(void)
+{
+	struct rte_tailq_entry_head *ring_list;
+	struct rte_tailq_entry *te;
+	struct rte_tailq_head *head;
+
+	head = rte_eal_tailq_lookup("RTE_RING");
+	if (head == NULL)
+		return;
+	ring_list = RTE_TAILQ_CAST(head, rte_tailq_entry_head);
+
+	rte_mcfg_tailq_read_lock();
+	TAILQ_FOREACH(te, ring_list, next) {
+		const struct rte_ring *r = te->data;
+
+		if (ring_name == NULL || !strcmp(ring_name, r->name))
+			monitor_ring(r);
+	}
+	rte_mcfg_tailq_read_unlock();
+}
+
+static void
+monitor_mempool(struct rte_mempool *mp, void *arg __rte_unused)
+{
+	unsigned int in_use, avail;
+	struct monitor_obj *obj;
+
+	if (mempool_name != NULL && strcmp(mempool_name, mp->name))
+		return;
+
+	in_use = rte_mempool_in_use_count(mp);
+	avail = rte_mempool_avail_count(mp);
+	obj = monitor_obj_get(mp, in_use, 0);
+	if (obj == NULL)
+		return;
+
+	monitor_obj_begin("mempool", mp->name);
+	monitor_obj_value("avail", avail);
+	monitor_obj_value("in_use", in_use);
+	/* net number of objects taken from the pool per second */
+	monitor_obj_value("in_use_ps",
+		((double)in_use - (double)obj->prev[0]) / monitor_dt);
+	monitor_obj_end();
+
+	obj->sample = monitor_sample;
+	obj->prev[0] = in_use;
+}
+
+/* Sample all the monitored objects, the first sample is not displayed */
+static void
+monitor_poll(void)
+{
+	struct timeval tv;
+	uint16_t i;
+
+	monitor_nb_objs_out = 0;
+	if (monitor_sample != 0 && !enable_collectd_format) {
+		gettimeofday(&tv, NULL);
+		fprintf(monitor_out,
+			"{\"time\":%ld.%03ld,\"interval\":%.3f,\"stats\":[",
+			(long)tv.tv_sec, (long)tv.tv_usec / 1000, monitor_dt);
+	}
+
+	RTE_ETH_FOREACH_DEV(i) {
+		if (enabled_port_mask & (1ul << i))
+			monitor_port(i);
+	}
+	if (enable_shw_ring)
+		monitor_rings();
+	if (enable_shw_mempool)
+		rte_mempool_walk(monitor_mempool, NULL);
+
+	if (monitor_sample != 0) {
+		if (!enable_collectd_format)
+			fprintf(monitor_out, "]}\n");
+		fflush(monitor_out);
+	}
+	monitor_sample++;
+}
+
+/*
+ * Sample the statistics every interval until the count is reached or the
+ * process is interrupted, staying attached to the primary process.
+ */
+static void
+monitor_run(void)
+{
+	uint64_t hz = rte_get_timer_hz();
+	uint64_t period = monitor_interval * hz;
+	uint64_t last, next, now;
+	uint32_t n;
+
+	monitor_out = stdout;
+	if (enable_collectd_format) {
+		monitor_out = fdopen(stdout_fd, "w");
+		if (monitor_out == NULL)
+			rte_exit(EXIT_FAILURE, "Cannot open output\n");
+	}
+
+	signal(SIGINT, monitor_signal_handler);
+	signal(SIGTERM, monitor_signal_handler);
+
+	last = rte_get_timer_cycles();
+	next = last;
+	/* one more sample, as the first one only sets the reference */
+	for (n = 0; !monitor_quit && (monitor_count == 0 || n <= monitor_count);
+			n++) {
+		now = rte_get_timer_cycles();
+		monitor_dt = (double)(now - last) / hz;
+		last = now;
+		monitor_poll();
+		if (monitor_count != 0 && n == monitor_count)
+			break;
+
+		/* keep the samples on the interval grid */
+		next += period;
+		now = rte_get_timer_cycles();
+		if (next > now)
+			rte_delay_us_sleep((next - now) * US_PER_S / hz);
+		else
+			next = now;
+	}
+}
+
 int
 main(int argc, char **argv)
 {
@@ -1409,6 +1758,11 @@ main(int argc, char **argv)
 			enabled_port_mask = 1ul << i;
 	}
 
+	if (enable_monitor) {
+		monitor_run();
+		goto cleanup;
+	}
+
 	for (i = 0; i < RTE_MAX_ETHPORTS; i++) {
 
 		/* Skip if port is not in mask */
@@ -1455,6 +1809,7 @@ main(int argc, char **argv)
 	if (enable_iter_mempool)
 		iter_mempool(mempool_iter_name);
 
+cleanup:
 	RTE_ETH_FOREACH_DEV(i)
 		rte_eth_dev_close(i);
 
@@ -0,0 +1,387 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <rte_malloc.h>
+#include <rte_mbuf.h>
+
+#include "cperf_dp.h"
+
+struct cperf_dp {
+	uint8_t dev_id;
+	enum cperf_dp_api api;
+	enum cperf_op_type op_type;
+	struct rte_cryptodev_sym_session *sess;
+	struct rte_crypto_raw_dp_ctx *raw_ctx;
+
+	/* cipher and auth lengths are given in bits */
+	uint8_t cipher_bits;
+	uint8_t auth_bits;
+
+	uint16_t iv_offset;
+	uint16_t auth_iv_offset;
+
+	uint32_t max_segs;
+	uint32_t max_burst;
+
+	/* symmetric vector of a burst */
+	struct rte_crypto_sgl *sgl;
+	struct rte_crypto_vec *vec;
+	struct rte_crypto_va_iova_ptr *iv;
+	struct rte_crypto_va_iova_ptr *digest;
+	struct rte_crypto_va_iova_ptr *aad;
+	int32_t *status;
+
+	/* operations processed by the CPU, returned on dequeue */
+	struct rte_crypto_op **done;
+	uint32_t done_mask;
+	uint32_t done_head;
+	uint32_t done_tail;
+};
+
+void
+cperf_dp_free(struct cperf_dp *dp)
+{
+	if (dp == NULL)
+		return;
+
+	rte_free(dp->raw_ctx);
+	rte_free(dp->sgl);
+	rte_free(dp->vec);
+	rte_free(dp->iv);
+	rte_free(dp->digest);
+	rte_free(dp->aad);
+	rte_free(dp->status);
+	rte_free(dp->done);
+	rte_free(dp);
+}
+
+struct cperf_dp *
+cperf_dp_create(uint8_t dev_id, uint16_t qp_id,
+		struct rte_cryptodev_sym_session *sess,
+		const struct cperf_options *options,
+		const struct cperf_test_vector *test_vector,
+		uint16_t iv_offset)
+{
+	uint32_t max_size = options->max_buffer_size + options->digest_sz;
+	union rte_cryptodev_session_ctx sess_ctx;
+	struct rte_cryptodev_info dev_info;
+	struct cperf_dp *dp;
+	uint64_t feature;
+	uint32_t burst;
+	int size;
+
+	feature = options->dp_api == CPERF_DP_API_RAW ?
+			RTE_CRYPTODEV_FF_SYM_RAW_DP :
+			RTE_CRYPTODEV_FF_SYM_CPU_CRYPTO;
+	rte_cryptodev_info_get(dev_id, &dev_info);
+	if ((dev_info.feature_flags & feature) == 0) {
+		RTE_LOG(ERR, USER1, "Device %u does not support the %s data "
+			"path API\n", dev_id,
+			cperf_dp_api_strs[options->dp_api]);
+		return NULL;
+	}
+
+	dp = rte_zmalloc(NULL, sizeof(*dp), 0);
+	if (dp == NULL)
+		return NULL;
+
+	dp->dev_id = dev_id;
+	dp->api = options->dp_api;
+	dp->op_type = options->op_type;
+	dp->sess = sess;
+
+	dp->cipher_bits =
+		options->cipher_algo == RTE_CRYPTO_CIPHER_SNOW3G_UEA2 ||
+		options->cipher_algo == RTE_CRYPTO_CIPHER_KASUMI_F8 ||
+		options->cipher_algo == RTE_CRYPTO_CIPHER_ZUC_EEA3;
+	dp->auth_bits =
+		options->auth_algo == RTE_CRYPTO_AUTH_SNOW3G_UIA2 ||
+		options->auth_algo == RTE_CRYPTO_AUTH_KASUMI_F9 ||
+		options->auth_algo == RTE_CRYPTO_AUTH_ZUC_EIA3;
+
+	/* The auth IV follows the cipher IV, as set by the sessions */
+	dp->iv_offset = iv_offset;
+	dp->auth_iv_offset = iv_offset;
+	if (options->op_type != CPERF_AUTH_ONLY &&
+			options->cipher_algo != RTE_CRYPTO_CIPHER_NULL)
+		dp->auth_iv_offset += test_vector->cipher_iv.length;
+
+	dp->max_segs = (max_size + options->segment_sz - 1) /
+			options->segment_sz;
+	dp->max_burst = burst = options->max_burst_size;
+
+	dp->sgl = rte_zmalloc(NULL, sizeof(*dp->sgl) * burst, 0);
+	dp->vec = rte_zmalloc(NULL,
+			sizeof(*dp->vec) * burst * dp->max_segs, 0);
+	dp->iv = rte_zmalloc(NULL, sizeof(*dp->iv) * burst, 0);
+	dp->digest = rte_zmalloc(NULL, sizeof(*dp->digest) * burst, 0);
+	dp->aad = rte_zmalloc(NULL, sizeof(*dp->aad) * burst, 0);
+	dp->status = rte_zmalloc(NULL, sizeof(*dp->status) * burst, 0);
+	if (dp->sgl == NULL || dp->vec == NULL || dp->iv == NULL ||
+			dp->digest == NULL || dp->aad == NULL ||
+			dp->status == NULL)
+		goto err;
+
+	if (dp->api == CPERF_DP_API_RAW) {
+		size = rte_cryptodev_get_raw_dp_ctx_size(dev_id);
+		if (size < 0)
+			goto err;
+
+		dp->raw_ctx = rte_zmalloc(NULL, size, 0);
+		if (dp->raw_ctx == NULL)
+			goto err;
+
+		sess_ctx.crypto_sess = sess;
+		if (rte_cryptodev_configure_raw_dp_ctx(dev_id, qp_id,
+				dp->raw_ctx, RTE_CRYPTO_OP_WITH_SESSION,
+				sess_ctx, 0) < 0) {
+			RTE_LOG(ERR, USER1, "Failed to configure raw data "
+				"path context of device %u queue pair %u\n",
+				dev_id, qp_id);
+			goto err;
+		}
+	} else {
+		/*
+		 * Bound the processed operations waiting for dequeue
+		 * like the descriptors of a queue pair.
+		 */
+		dp->done_mask = rte_align32pow2(RTE_MAX(options->nb_descriptors,
+				burst)) - 1;
+		dp->done = rte_zmalloc(NULL,
+				sizeof(*dp->done) * (dp->done_mask + 1), 0);
+		if (dp->done == NULL)
+			goto err;
+	}
+
+	return dp;
+err:
+	cperf_dp_free(dp);
+
+	return NULL;
+}
+
+/* Fill the offsets and the pointers of the operation in the vector. */
+static void
+cperf_dp_fill_op(struct cperf_dp *dp, struct rte_crypto_op *op, uint32_t idx,
+		union rte_crypto_sym_ofs *ofs, uint32_t *max_len)
+{
+	struct rte_crypto_sym_op *sop = op->sym;
+	uint32_t cipher_ofs = 0, cipher_len = 0, auth_ofs = 0, auth_len = 0;
+
+	dp->iv[idx].va = NULL;
+	dp->iv[idx].iova = 0;
+	dp->aad[idx].va = NULL;
+	dp->aad[idx].iova = 0;
+	dp->digest[idx].va = NULL;
+	dp->digest[idx].iova = 0;
+
+	if (dp->op_type == CPERF_AEAD) {
+		cipher_ofs = sop->aead.data.offset;
+		cipher_len = sop->aead.data.length;
+		dp->aad[idx].va = sop->aead.aad.data;
+		dp->aad[idx].iova = sop->aead.aad.phys_addr;
+		dp->digest[idx].va = sop->aead.digest.data;
+		dp->digest[idx].iova = sop->aead.digest.phys_addr;
+	} else {
+		if (dp->op_type != CPERF_AUTH_ONLY) {
+			cipher_ofs = sop->cipher.data.offset;
+			cipher_len = sop->cipher.data.length;
+			if (dp->cipher_bits) {
+				cipher_ofs >>= 3;
+				cipher_len >>= 3;
+			}
+		}
+		if (dp->op_type != CPERF_CIPHER_ONLY) {
+			auth_ofs = sop->auth.data.offset;
+			auth_len = sop->auth.data.length;
+			if (dp->auth_bits) {
+				auth_ofs >>= 3;
+				auth_len >>= 3;
+			}
+			dp->aad[idx].va = rte_crypto_op_ctod_offset(op, void *,
+					dp->auth_iv_offset);
+			dp->aad[idx].iova = rte_crypto_op_ctophys_offset(op,
+					dp->auth_iv_offset);
+			dp->digest[idx].va = sop->auth.digest.data;
+			dp->digest[idx].iova = sop->auth.digest.phys_addr;
+		}
+	}
+
+	if (dp->op_type != CPERF_AUTH_ONLY) {
+		dp->iv[idx].va = rte_crypto_op_ctod_offset(op, void *,
+				dp->iv_offset);
+		dp->iv[idx].iova = rte_crypto_op_ctophys_offset(op,
+				dp->iv_offset);
+	}
+
+	*max_len = RTE_MAX(cipher_ofs + cipher_len, auth_ofs + auth_len);
+
+	ofs->raw = 0;
+	if (cipher_len != 0) {
+		ofs->ofs.cipher.head = cipher_ofs;
+		ofs->ofs.cipher.tail = *max_len - cipher_ofs - cipher_len;
+	}
+	if (auth_len != 0) {
+		ofs->ofs.auth.head = auth_ofs;
+		ofs->ofs.auth.tail = *max_len - auth_ofs - auth_len;
+	}
+}
+
+/*
+ * Convert operations into the symmetric vector. The offsets are shared by
+ * the whole vector, so it stops at the first operation with other offsets.
+ */
+static uint32_t
+cperf_dp_fill_vec(struct cperf_dp *dp, struct rte_crypto_op **ops,
+		uint16_t nb_ops, struct rte_crypto_sym_vec *vec,
+		union rte_crypto_sym_ofs *ofs)
+{
+	union rte_crypto_sym_ofs op_ofs;
+	uint32_t i, max_len;
+	int n;
+
+	nb_ops = RTE_MIN(nb_ops, dp->max_burst);
+
+	for (i = 0; i < nb_ops; i++) {
+		cperf_dp_fill_op(dp, ops[i], i, &op_ofs, &max_len);
+		if (i == 0)
+			*ofs = op_ofs;
+		else if (op_ofs.raw != ofs->raw)
+			break;
+
+		dp->sgl[i].vec = &dp->vec[i * dp->max_segs];
+		n = rte_crypto_mbuf_to_vec(ops[i]->sym->m_src, 0, max_len,
+				dp->sgl[i].vec, dp->max_segs);
+		if (n < 0)
+			break;
+		dp->sgl[i].num = n;
+	}
+
+	vec->num = i;
+	vec->sgl = dp->sgl;
+	vec->iv = dp->iv;
+	vec->digest = dp->digest;
+	vec->aad = dp->aad;
+	vec->status = dp->status;
+
+	return i;
+}
+
+static void
+cperf_dp_raw_post_dequeue(void *user_data, uint32_t index __rte_unused,
+		uint8_t is_op_success)
+{
+	struct rte_crypto_op *op = user_data;
+
+	op->status = is_op_success ? RTE_CRYPTO_OP_STATUS_SUCCESS :
+			RTE_CRYPTO_OP_STATUS_ERROR;
+}
+
+static uint16_t
+cperf_dp_raw_enqueue(struct cperf_dp *dp, struct rte_crypto_op **ops,
+		uint16_t nb_ops)
+{
+	union rte_crypto_sym_ofs ofs;
+	struct rte_crypto_sym_vec vec;
+	uint32_t n;
+	int status;
+
+	if (cperf_dp_fill_vec(dp, ops, nb_ops, &vec, &ofs) == 0)
+		return 0;
+
+	n = rte_cryptodev_raw_enqueue_burst(dp->raw_ctx, &vec, ofs,
+			(void **)ops, &status);
+	if (n != 0 && status == 0 &&
+			rte_cryptodev_raw_enqueue_done(dp->raw_ctx, n) < 0) {
+		RTE_LOG(ERR, USER1, "Failed to complete raw enqueue\n");
+		return 0;
+	}
+
+	return n;
+}
+
+static uint16_t
+cperf_dp_raw_dequeue(struct cperf_dp *dp, struct rte_crypto_op **ops,
+		uint16_t nb_ops)
+{
+	uint32_t n, n_success;
+	int status;
+
+	n = rte_cryptodev_raw_dequeue_burst(dp->raw_ctx, NULL, nb_ops,
+			cperf_dp_raw_post_dequeue, (void **)ops, 1,
+			&n_success, &status);
+	if (n != 0 && status == 0)
+		rte_cryptodev_raw_dequeue_done(dp->raw_ctx, n);
+
+	return n;
+}
+
+static uint16_t
+cperf_dp_cpu_enqueue(struct cperf_dp *dp, struct rte_crypto_op **ops,
+		uint16_t nb_ops)
+{
+	union rte_crypto_sym_ofs ofs;
+	struct rte_crypto_sym_vec vec;
+	uint32_t i, n, room;
+
+	/* Stall like a full queue pair until the operations are dequeued */
+	room = dp->done_mask + 1 - (dp->done_tail - dp->done_head);
+	nb_ops = RTE_MIN(nb_ops, room);
+	if (nb_ops == 0)
+		return 0;
+
+	n = cperf_dp_fill_vec(dp, ops, nb_ops, &vec, &ofs);
+	if (n == 0)
+		return 0;
+
+	rte_cryptodev_sym_cpu_crypto_process(dp->dev_id, dp->sess, ofs, &vec);
+
+	for (i = 0; i < n; i++) {
+		if (dp->status[i] == 0)
+			ops[i]->status = RTE_CRYPTO_OP_STATUS_SUCCESS;
+		else if (dp->status[i] == EBADMSG)
+			ops[i]->status = RTE_CRYPTO_OP_STATUS_AUTH_FAILED;
+		else
+			ops[i]->status = RTE_CRYPTO_OP_STATUS_ERROR;
+		dp->done[dp->done_tail++ & dp->done_mask] = ops[i];
+	}
+
+	return n;
+}
+
+static uint16_t
+cperf_dp_cpu_dequeue(struct cperf_dp *dp, struct rte_crypto_op **ops,
+		uint16_t nb_ops)
+{
+	uint32_t i, n;
+
+	n = RTE_MIN((uint32_t)nb_ops, dp->done_tail - dp->done_head);
+	for (i = 0; i < n; i++)
+		ops[i] = dp->done[dp->done_head++ & dp->done_mask];
+
+	return n;
+}
+
+uint16_t
+cperf_dp_enqueue_ops(struct cperf_dp *dp, struct rte_crypto_op **ops,
+		uint16_t nb_ops)
+{
+	if (nb_ops == 0)
+		return 0;
+
+	if (dp->api == CPERF_DP_API_RAW)
+		return cperf_dp_raw_enqueue(dp, ops, nb_ops);
+
+	return cperf_dp_cpu_enqueue(dp, ops, nb_ops);
+}
+
+uint16_t
+cperf_dp_dequeue_ops(struct cperf_dp *dp, struct rte_crypto_op **ops,
+		uint16_t nb_ops)
+{
+	if (dp->api == CPERF_DP_API_RAW)
+		return cperf_dp_raw_dequeue(dp, ops, nb_ops);
+
+	return cperf_dp_cpu_dequeue(dp, ops, nb_ops);
+}
@@ -0,0 +1,64 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#ifndef _CPERF_DP_H_
+#define _CPERF_DP_H_
+
+#include <stdint.h>
+
+#include <rte_crypto.h>
+#include <rte_cryptodev.h>
+
+#include "cperf_options.h"
+#include "cperf_test_vectors.h"
+
+/*
+ * Data path processing the crypto operations of a queue pair with the
+ * raw data path API or the CPU crypto API. The operations are converted
+ * into symmetric vectors on enqueue, and returned on dequeue like with
+ * the crypto operation API, so that the tests can use any of them.
+ */
+struct cperf_dp;
+
+struct cperf_dp *
+cperf_dp_create(uint8_t dev_id, uint16_t qp_id,
+		struct rte_cryptodev_sym_session *sess,
+		const struct cperf_options *options,
+		const struct cperf_test_vector *test_vector,
+		uint16_t iv_offset);
+
+void
+cperf_dp_free(struct cperf_dp *dp);
+
+uint16_t
+cperf_dp_enqueue_ops(struct cperf_dp *dp, struct rte_crypto_op **ops,
+		uint16_t nb_ops);
+
+uint16_t
+cperf_dp_dequeue_ops(struct cperf_dp *dp, struct rte_crypto_op **ops,
+		uint16_t nb_ops);
+
+/* Enqueue a burst with the crypto operation API when dp is NULL. */
+static inline uint16_t
+cperf_dp_enqueue_burst(struct cperf_dp *dp, uint8_t dev_id, uint16_t qp_id,
+		struct rte_crypto_op **ops, uint16_t nb_ops)
+{
+	if (dp == NULL)
+		return rte_cryptodev_enqueue_burst(dev_id, qp_id, ops, nb_ops);
+
+	return cperf_dp_enqueue_ops(dp, ops, nb_ops);
+}
+
+/* Dequeue a burst with the crypto operation API when dp is NULL. */
+static inline uint16_t
+cperf_dp_dequeue_burst(struct cperf_dp *dp, uint8_t dev_id, uint16_t qp_id,
+		struct rte_crypto_op **ops, uint16_t nb_ops)
+{
+	if (dp == NULL)
+		return rte_cryptodev_dequeue_burst(dev_id, qp_id, ops, nb_ops);
+
+	return cperf_dp_dequeue_ops(dp, ops, nb_ops);
+}
+
+#endif /* _CPERF_DP_H_ */
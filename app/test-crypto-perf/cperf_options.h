@@ -56,6 +56,10 @@
 #endif
 
 #define CPERF_CSV		("csv-friendly")
+#define CPERF_JSON		("json")
+
+#define CPERF_DP_API		("dp-api")
+#define CPERF_LCORE_SWEEP	("lcore-sweep")
 
 /* benchmark-specific options */
 #define CPERF_PMDCC_DELAY_MS	("pmd-cyclecount-delay-ms")
@@ -72,6 +76,15 @@ enum cperf_perf_test_type {
 
 extern const char *cperf_test_type_strs[];
 
+/* API used to process the crypto operations */
+enum cperf_dp_api {
+	CPERF_DP_API_OP,	/* rte_cryptodev_enqueue/dequeue_burst() */
+	CPERF_DP_API_RAW,	/* rte_cryptodev_raw_enqueue/dequeue_burst() */
+	CPERF_DP_API_CPU	/* rte_cryptodev_sym_cpu_crypto_process() */
+};
+
+extern const char *cperf_dp_api_strs[];
+
 enum cperf_op_type {
 	CPERF_CIPHER_ONLY = 1,
 	CPERF_AUTH_ONLY,
@@ -101,6 +114,9 @@ struct cperf_options {
 	uint32_t out_of_place:1;
 	uint32_t silent:1;
 	uint32_t csv:1;
+	uint32_t json:1;
+
+	enum cperf_dp_api dp_api;
 
 	enum rte_crypto_cipher_algorithm cipher_algo;
 	enum rte_crypto_cipher_operation cipher_op;
@@ -147,6 +163,14 @@ struct cperf_options {
 	uint32_t min_burst_size;
 	uint32_t inc_burst_size;
 
+	uint32_t lcore_sweep_list[MAX_LIST];
+	uint8_t lcore_sweep_count;
+	uint32_t max_lcore_sweep;
+	uint32_t min_lcore_sweep;
+	uint32_t inc_lcore_sweep;
+	/* number of lcores running the current test */
+	uint32_t test_nb_lcores;
+
 	/* pmd-cyclecount specific options */
 	uint32_t pmdcc_delay;
 	uint32_t imix_distribution_list[MAX_LIST];
@@ -57,6 +57,11 @@ usage(char *progname)
 		" --pmd-cyclecount-delay-ms N: set delay between enqueue\n"
 		"           and dequeue in pmd-cyclecount benchmarking mode\n"
 		" --csv-friendly: enable test result output CSV friendly\n"
+		" --json: enable test result output in JSON, one object per line\n"
+		" --dp-api op / raw / cpu-crypto: set the API processing\n"
+		"           the operations in throughput and latency tests\n"
+		" --lcore-sweep N: set the numbers of worker lcores to run\n"
+		"           the test on, as a list or a min:inc:max range\n"
 #ifdef RTE_LIB_SECURITY
 		" --pdcp-sn-sz N: set PDCP SN size N <5/7/12/15/18>\n"
 		" --pdcp-domain DOMAIN: set PDCP domain <control/user>\n"
@@ -782,6 +787,57 @@ parse_csv_friendly(struct cperf_options *opts, const char *arg __rte_unused)
 	return 0;
 }
 
+static int
+parse_json(struct cperf_options *opts, const char *arg __rte_unused)
+{
+	opts->json = 1;
+	opts->silent = 1;
+	return 0;
+}
+
+static int
+parse_dp_api(struct cperf_options *opts, const char *arg)
+{
+	struct name_id_map dp_api_namemap[] = {
+		{ cperf_dp_api_strs[CPERF_DP_API_OP], CPERF_DP_API_OP },
+		{ cperf_dp_api_strs[CPERF_DP_API_RAW], CPERF_DP_API_RAW },
+		{ cperf_dp_api_strs[CPERF_DP_API_CPU], CPERF_DP_API_CPU }
+	};
+
+	int id = get_str_key_id_mapping(dp_api_namemap,
+			RTE_DIM(dp_api_namemap), arg);
+	if (id < 0) {
+		RTE_LOG(ERR, USER1, "invalid data path API specified\n");
+		return -1;
+	}
+
+	opts->dp_api = (enum cperf_dp_api)id;
+
+	return 0;
+}
+
+static int
+parse_lcore_sweep(struct cperf_options *opts, const char *arg)
+{
+	int ret;
+
+	/* Try parsing the argument as a range, if it fails, parse it as a list */
+	if (parse_range(arg, &opts->min_lcore_sweep, &opts->max_lcore_sweep,
+			&opts->inc_lcore_sweep) < 0) {
+		ret = parse_list(arg, opts->lcore_sweep_list,
+					&opts->min_lcore_sweep,
+					&opts->max_lcore_sweep);
+		if (ret < 0) {
+			RTE_LOG(ERR, USER1, "failed to parse lcore sweep\n");
+			return -1;
+		}
+		opts->lcore_sweep_count = ret;
+	} else
+		opts->lcore_sweep_count = 0;
+
+	return 0;
+}
+
 static int
 parse_pmd_cyclecount_delay_ms(struct cperf_options *opts,
 			const char *arg)
@@ -854,6 +910,10 @@ static struct option lgopts[] = {
 	{ CPERF_DOCSIS_HDR_SZ, required_argument, 0, 0 },
 #endif
 	{ CPERF_CSV, no_argument, 0, 0},
+	{ CPERF_JSON, no_argument, 0, 0},
+
+	{ CPERF_DP_API, required_argument, 0, 0 },
+	{ CPERF_LCORE_SWEEP, required_argument, 0, 0 },
 
 	{ CPERF_PMDCC_DELAY_MS, required_argument, 0, 0 },
 
@@ -900,6 +960,13 @@ cperf_options_default(struct cperf_options *opts)
 	opts->sessionless = 0;
 	opts->out_of_place = 0;
 	opts->csv = 0;
+	opts->json = 0;
+
+	opts->dp_api = CPERF_DP_API_OP;
+
+	/* No sweep: the test is run once on all the lcores */
+	opts->lcore_sweep_count = 0;
+	opts->inc_lcore_sweep = 0;
 
 	opts->cipher_algo = RTE_CRYPTO_CIPHER_AES_CBC;
 	opts->cipher_op = RTE_CRYPTO_CIPHER_OP_ENCRYPT;
@@ -967,6 +1034,9 @@ cperf_opts_parse_long(int opt_idx, struct cperf_options *opts)
 		{ CPERF_DOCSIS_HDR_SZ,	parse_docsis_hdr_sz },
 #endif
 		{ CPERF_CSV,		parse_csv_friendly},
+		{ CPERF_JSON,		parse_json},
+		{ CPERF_DP_API,		parse_dp_api },
+		{ CPERF_LCORE_SWEEP,	parse_lcore_sweep },
 		{ CPERF_PMDCC_DELAY_MS,	parse_pmd_cyclecount_delay_ms},
 	};
 	unsigned int i;
@@ -1228,6 +1298,33 @@ cperf_options_check(struct cperf_options *options)
 	}
 #endif
 
+	if (options->csv && options->json) {
+		RTE_LOG(ERR, USER1, "CSV and JSON outputs cannot be enabled "
+				"together.\n");
+		return -EINVAL;
+	}
+
+	if (options->dp_api != CPERF_DP_API_OP) {
+		if (options->test != CPERF_TEST_TYPE_THROUGHPUT &&
+				options->test != CPERF_TEST_TYPE_LATENCY) {
+			RTE_LOG(ERR, USER1, "The %s data path API is only "
+				"supported by the throughput and latency "
+				"tests.\n", cperf_dp_api_strs[options->dp_api]);
+			return -EINVAL;
+		}
+
+		/* The symmetric vectors only describe in-place operations */
+		if (options->sessionless || options->out_of_place ||
+				options->op_type == CPERF_PDCP ||
+				options->op_type == CPERF_DOCSIS) {
+			RTE_LOG(ERR, USER1, "The %s data path API only "
+				"supports in-place operations with symmetric "
+				"crypto sessions.\n",
+				cperf_dp_api_strs[options->dp_api]);
+			return -EINVAL;
+		}
+	}
+
 	return 0;
 }
 
@@ -1272,6 +1369,19 @@ cperf_options_dump(struct cperf_options *opts)
 	printf("# crypto operation: %s\n", cperf_op_type_strs[opts->op_type]);
 	printf("# sessionless: %s\n", opts->sessionless ? "yes" : "no");
 	printf("# out of place: %s\n", opts->out_of_place ? "yes" : "no");
+	printf("# data path API: %s\n", cperf_dp_api_strs[opts->dp_api]);
+	if (opts->inc_lcore_sweep != 0) {
+		printf("# lcore sweep:\n");
+		printf("#\t min: %u\n", opts->min_lcore_sweep);
+		printf("#\t max: %u\n", opts->max_lcore_sweep);
+		printf("#\t inc: %u\n", opts->inc_lcore_sweep);
+	} else if (opts->lcore_sweep_count != 0) {
+		printf("# lcore sweep: ");
+		for (size_idx = 0; size_idx < opts->lcore_sweep_count;
+				size_idx++)
+			printf("%u ", opts->lcore_sweep_list[size_idx]);
+		printf("\n");
+	}
 	if (opts->test == CPERF_TEST_TYPE_PMDCC)
 		printf("# inter-burst delay: %u ms\n", opts->pmdcc_delay);
 
@@ -2,6 +2,8 @@
  * Copyright(c) 2016-2017 Intel Corporation
  */
 
+#include <stdlib.h>
+
 #include <rte_malloc.h>
 #include <rte_cycles.h>
 #include <rte_crypto.h>
@@ -10,6 +12,13 @@
 #include "cperf_test_latency.h"
 #include "cperf_ops.h"
 #include "cperf_test_common.h"
+#include "cperf_dp.h"
+
+/* Reported latency percentiles, in thousandths */
+static const uint32_t cperf_latency_pct[] = { 500, 900, 990, 999 };
+static const char * const cperf_latency_pct_strs[] = {
+	"p50", "p90", "p99", "p99.9"
+};
 
 struct cperf_op_result {
 	uint64_t tsc_start;
@@ -26,6 +35,9 @@ struct cperf_latency_ctx {
 
 	struct rte_cryptodev_sym_session *sess;
 
+	/* NULL for the crypto operation API */
+	struct cperf_dp *dp;
+
 	cperf_populate_ops_t populate_ops;
 
 	uint32_t src_buf_offset;
@@ -34,6 +46,8 @@ struct cperf_latency_ctx {
 	const struct cperf_options *options;
 	const struct cperf_test_vector *test_vector;
 	struct cperf_op_result *res;
+	/* sorted latencies, to get the percentiles */
+	uint64_t *tsc_sorted;
 };
 
 struct priv_op_data {
@@ -44,6 +58,7 @@ static void
 cperf_latency_test_free(struct cperf_latency_ctx *ctx)
 {
 	if (ctx) {
+		cperf_dp_free(ctx->dp);
 		if (ctx->sess) {
 			rte_cryptodev_sym_session_clear(ctx->dev_id, ctx->sess);
 			rte_cryptodev_sym_session_free(ctx->sess);
@@ -53,6 +68,7 @@ cperf_latency_test_free(struct cperf_latency_ctx *ctx)
 			rte_mempool_free(ctx->pool);
 
 		rte_free(ctx->res);
+		rte_free(ctx->tsc_sorted);
 		rte_free(ctx);
 	}
 }
@@ -68,7 +84,7 @@ cperf_latency_test_constructor(struct rte_mempool *sess_mp,
 	struct cperf_latency_ctx *ctx = NULL;
 	size_t extra_op_priv_size = sizeof(struct priv_op_data);
 
-	ctx = rte_malloc(NULL, sizeof(struct cperf_latency_ctx), 0);
+	ctx = rte_zmalloc(NULL, sizeof(struct cperf_latency_ctx), 0);
 	if (ctx == NULL)
 		goto err;
 
@@ -101,6 +117,19 @@ cperf_latency_test_constructor(struct rte_mempool *sess_mp,
 	if (ctx->res == NULL)
 		goto err;
 
+	ctx->tsc_sorted = rte_malloc(NULL, sizeof(uint64_t) *
+			ctx->options->total_ops, 0);
+
+	if (ctx->tsc_sorted == NULL)
+		goto err;
+
+	if (options->dp_api != CPERF_DP_API_OP) {
+		ctx->dp = cperf_dp_create(dev_id, qp_id, ctx->sess, options,
+				test_vector, iv_offset);
+		if (ctx->dp == NULL)
+			goto err;
+	}
+
 	return ctx;
 err:
 	cperf_latency_test_free(ctx);
@@ -108,6 +137,24 @@ cperf_latency_test_constructor(struct rte_mempool *sess_mp,
 	return NULL;
 }
 
+static int
+cperf_latency_cmp(const void *a, const void *b)
+{
+	uint64_t x = *(const uint64_t *)a;
+	uint64_t y = *(const uint64_t *)b;
+
+	return (x > y) - (x < y);
+}
+
+/* Nearest-rank percentile of sorted values, pct in thousandths */
+static uint64_t
+cperf_latency_percentile(const uint64_t *sorted, uint64_t nb, uint32_t pct)
+{
+	uint64_t rank = (nb * pct + 999) / 1000;
+
+	return sorted[rank != 0 ? rank - 1 : 0];
+}
+
 static inline void
 store_timestamp(struct rte_crypto_op *op, uint64_t timestamp)
 {
@@ -127,6 +174,7 @@ cperf_latency_test_runner(void *arg)
 	uint32_t imix_idx = 0;
 
 	static rte_atomic16_t display_once = RTE_ATOMIC16_INIT(0);
+	static rte_atomic16_t pct_display_once = RTE_ATOMIC16_INIT(0);
 
 	if (ctx == NULL)
 		return 0;
@@ -216,12 +264,13 @@ cperf_latency_test_runner(void *arg)
 #endif /* CPERF_LINEARIZATION_ENABLE */
 
 			/* Enqueue burst of ops on crypto device */
-			ops_enqd = rte_cryptodev_enqueue_burst(ctx->dev_id, ctx->qp_id,
-					ops, burst_size);
+			ops_enqd = cperf_dp_enqueue_burst(ctx->dp, ctx->dev_id,
+					ctx->qp_id, ops, burst_size);
 
 			/* Dequeue processed burst of ops from crypto device */
-			ops_deqd = rte_cryptodev_dequeue_burst(ctx->dev_id, ctx->qp_id,
-					ops_processed, test_burst_size);
+			ops_deqd = cperf_dp_dequeue_burst(ctx->dp, ctx->dev_id,
+					ctx->qp_id, ops_processed,
+					test_burst_size);
 
 			tsc_end = rte_rdtsc_precise();
 
@@ -265,11 +314,13 @@ cperf_latency_test_runner(void *arg)
 		/* Dequeue any operations still in the crypto device */
 		while (deqd_tot < ctx->options->total_ops) {
 			/* Sending 0 length burst to flush sw crypto device */
-			rte_cryptodev_enqueue_burst(ctx->dev_id, ctx->qp_id, NULL, 0);
+			cperf_dp_enqueue_burst(ctx->dp, ctx->dev_id, ctx->qp_id,
+					NULL, 0);
 
 			/* dequeue burst */
-			ops_deqd = rte_cryptodev_dequeue_burst(ctx->dev_id, ctx->qp_id,
-					ops_processed, test_burst_size);
+			ops_deqd = cperf_dp_dequeue_burst(ctx->dp, ctx->dev_id,
+					ctx->qp_id, ops_processed,
+					test_burst_size);
 
 			tsc_end = rte_rdtsc_precise();
 
@@ -291,8 +342,16 @@ cperf_latency_test_runner(void *arg)
 			tsc_max = RTE_MAX(tsc_val, tsc_max);
 			tsc_min = RTE_MIN(tsc_val, tsc_min);
 			tsc_tot += tsc_val;
+			ctx->tsc_sorted[i] = tsc_val;
 		}
 
+		qsort(ctx->tsc_sorted, tsc_idx, sizeof(uint64_t),
+				cperf_latency_cmp);
+
+		uint64_t tsc_pct[RTE_DIM(cperf_latency_pct)];
+		double time_pct[RTE_DIM(cperf_latency_pct)];
+		unsigned int p;
+
 		double time_tot, time_avg, time_max, time_min;
 
 		const uint64_t tunit = 1000000; /* us */
@@ -307,7 +366,36 @@ cperf_latency_test_runner(void *arg)
 		time_max = tunit*(double)(tsc_max) / tsc_hz;
 		time_min = tunit*(double)(tsc_min) / tsc_hz;
 
-		if (ctx->options->csv) {
+		for (p = 0; p < RTE_DIM(cperf_latency_pct); p++) {
+			tsc_pct[p] = cperf_latency_percentile(ctx->tsc_sorted,
+					tsc_idx, cperf_latency_pct[p]);
+			time_pct[p] = tunit * (double)tsc_pct[p] / tsc_hz;
+		}
+
+		if (ctx->options->json) {
+			printf("{\"test\": \"%s\", \"devtype\": \"%s\", "
+				"\"dp_api\": \"%s\", \"lcores\": %u, "
+				"\"lcore_id\": %u, \"buffer_size\": %u, "
+				"\"burst_size\": %u, \"ops\": %"PRIu64", "
+				"\"time_us\": {\"min\": %.3f, "
+				"\"avg\": %.3f, ",
+				cperf_test_type_strs[ctx->options->test],
+				ctx->options->device_type,
+				cperf_dp_api_strs[ctx->options->dp_api],
+				ctx->options->test_nb_lcores,
+				ctx->lcore_id, ctx->options->test_buffer_size,
+				test_burst_size, tsc_idx, time_min, time_avg);
+			for (p = 0; p < RTE_DIM(cperf_latency_pct); p++)
+				printf("\"%s\": %.3f, ",
+					cperf_latency_pct_strs[p], time_pct[p]);
+			printf("\"max\": %.3f}, \"cycles\": {\"min\": %"PRIu64
+				", \"avg\": %"PRIu64", ", time_max, tsc_min,
+				tsc_avg);
+			for (p = 0; p < RTE_DIM(cperf_latency_pct); p++)
+				printf("\"%s\": %"PRIu64", ",
+					cperf_latency_pct_strs[p], tsc_pct[p]);
+			printf("\"max\": %"PRIu64"}}\n", tsc_max);
+		} else if (ctx->options->csv) {
 			if (rte_atomic16_test_and_set(&display_once))
 				printf("\n# lcore, Buffer Size, Burst Size, Pakt Seq #, "
 						"cycles, time (us)");
@@ -323,6 +411,21 @@ cperf_latency_test_runner(void *arg)
 						/ tsc_hz);
 
 			}
+
+			/*
+			 * Summary lines don't start like the header or the rows
+			 * above, so that per operation parsers skip them.
+			 */
+			if (rte_atomic16_test_and_set(&pct_display_once))
+				printf("\n# percentiles,lcore,Buffer Size,"
+					"Burst Size,min (us),p50 (us),p90 (us),"
+					"p99 (us),p99.9 (us),max (us)");
+			printf("\n# percentiles,%u,%u,%u,%.3f,%.3f,%.3f,%.3f,"
+				"%.3f,%.3f", ctx->lcore_id,
+				ctx->options->test_buffer_size,
+				test_burst_size, time_min, time_pct[0],
+				time_pct[1], time_pct[2], time_pct[3],
+				time_max);
 		} else {
 			printf("\n# Device %d on lcore %u\n", ctx->dev_id,
 				ctx->lcore_id);
@@ -346,6 +449,18 @@ cperf_latency_test_runner(void *arg)
 					tsc_avg, tsc_max, tsc_min);
 			printf("\n# time [us]\t%12.0f\t%10.3f\t%10.3f\t%10.3f",
 					time_tot, time_avg, time_max, time_min);
+			printf("\n#");
+			printf("\n#          \t%12s\t%10s\t%10s\t%10s",
+					cperf_latency_pct_strs[0],
+					cperf_latency_pct_strs[1],
+					cperf_latency_pct_strs[2],
+					cperf_latency_pct_strs[3]);
+			printf("\n#    cycles\t%12"PRIu64"\t%10"PRIu64"\t"
+					"%10"PRIu64"\t%10"PRIu64, tsc_pct[0],
+					tsc_pct[1], tsc_pct[2], tsc_pct[3]);
+			printf("\n# time [us]\t%12.3f\t%10.3f\t%10.3f\t%10.3f",
+					time_pct[0], time_pct[1], time_pct[2],
+					time_pct[3]);
 			printf("\n\n");
 
 		}
@@ -10,6 +10,7 @@
 #include "cperf_test_throughput.h"
 #include "cperf_ops.h"
 #include "cperf_test_common.h"
+#include "cperf_dp.h"
 
 struct cperf_throughput_ctx {
 	uint8_t dev_id;
@@ -20,6 +21,9 @@ struct cperf_throughput_ctx {
 
 	struct rte_cryptodev_sym_session *sess;
 
+	/* NULL for the crypto operation API */
+	struct cperf_dp *dp;
+
 	cperf_populate_ops_t populate_ops;
 
 	uint32_t src_buf_offset;
@@ -34,6 +38,7 @@ cperf_throughput_test_free(struct cperf_throughput_ctx *ctx)
 {
 	if (!ctx)
 		return;
+	cperf_dp_free(ctx->dp);
 	if (ctx->sess) {
 #ifdef RTE_LIB_SECURITY
 		if (ctx->options->op_type == CPERF_PDCP ||
@@ -66,7 +71,7 @@ cperf_throughput_test_constructor(struct rte_mempool *sess_mp,
 {
 	struct cperf_throughput_ctx *ctx = NULL;
 
-	ctx = rte_malloc(NULL, sizeof(struct cperf_throughput_ctx), 0);
+	ctx = rte_zmalloc(NULL, sizeof(struct cperf_throughput_ctx), 0);
 	if (ctx == NULL)
 		goto err;
 
@@ -91,6 +96,13 @@ cperf_throughput_test_constructor(struct rte_mempool *sess_mp,
 			&ctx->pool) < 0)
 		goto err;
 
+	if (options->dp_api != CPERF_DP_API_OP) {
+		ctx->dp = cperf_dp_create(dev_id, qp_id, ctx->sess, options,
+				test_vector, iv_offset);
+		if (ctx->dp == NULL)
+			goto err;
+	}
+
 	return ctx;
 err:
 	cperf_throughput_test_free(ctx);
@@ -205,8 +217,8 @@ cperf_throughput_test_runner(void *test_ctx)
 #endif /* CPERF_LINEARIZATION_ENABLE */
 
 			/* Enqueue burst of ops on crypto device */
-			ops_enqd = rte_cryptodev_enqueue_burst(ctx->dev_id, ctx->qp_id,
-					ops, burst_size);
+			ops_enqd = cperf_dp_enqueue_burst(ctx->dp, ctx->dev_id,
+					ctx->qp_id, ops, burst_size);
 			if (ops_enqd < burst_size)
 				ops_enqd_failed++;
 
@@ -219,8 +231,9 @@ cperf_throughput_test_runner(void *test_ctx)
 
 
 			/* Dequeue processed burst of ops from crypto device */
-			ops_deqd = rte_cryptodev_dequeue_burst(ctx->dev_id, ctx->qp_id,
-					ops_processed, test_burst_size);
+			ops_deqd = cperf_dp_dequeue_burst(ctx->dp, ctx->dev_id,
+					ctx->qp_id, ops_processed,
+					test_burst_size);
 
 			if (likely(ops_deqd))  {
 				/* Free crypto ops so they can be reused. */
@@ -243,11 +256,13 @@ cperf_throughput_test_runner(void *test_ctx)
 
 		while (ops_deqd_total < ctx->options->total_ops) {
 			/* Sending 0 length burst to flush sw crypto device */
-			rte_cryptodev_enqueue_burst(ctx->dev_id, ctx->qp_id, NULL, 0);
+			cperf_dp_enqueue_burst(ctx->dp, ctx->dev_id, ctx->qp_id,
+					NULL, 0);
 
 			/* dequeue burst */
-			ops_deqd = rte_cryptodev_dequeue_burst(ctx->dev_id, ctx->qp_id,
-					ops_processed, test_burst_size);
+			ops_deqd = cperf_dp_dequeue_burst(ctx->dp, ctx->dev_id,
+					ctx->qp_id, ops_processed,
+					test_burst_size);
 			if (ops_deqd == 0)
 				ops_deqd_failed++;
 			else {
@@ -272,7 +287,30 @@ cperf_throughput_test_runner(void *test_ctx)
 		double cycles_per_packet = ((double)tsc_duration /
 				ctx->options->total_ops);
 
-		if (!ctx->options->csv) {
+		if (ctx->options->json) {
+			printf("{\"test\": \"%s\", \"devtype\": \"%s\", "
+				"\"dp_api\": \"%s\", \"lcores\": %u, "
+				"\"lcore_id\": %u, \"buffer_size\": %u, "
+				"\"burst_size\": %u, \"enqueued\": %"PRIu64", "
+				"\"dequeued\": %"PRIu64", "
+				"\"failed_enq\": %"PRIu64", "
+				"\"failed_deq\": %"PRIu64", \"mops\": %.4f, "
+				"\"gbps\": %.4f, \"cycles_per_buf\": %.2f}\n",
+				cperf_test_type_strs[ctx->options->test],
+				ctx->options->device_type,
+				cperf_dp_api_strs[ctx->options->dp_api],
+				ctx->options->test_nb_lcores,
+				ctx->lcore_id,
+				ctx->options->test_buffer_size,
+				test_burst_size,
+				ops_enqd_total,
+				ops_deqd_total,
+				ops_enqd_failed,
+				ops_deqd_failed,
+				ops_per_second/1000000,
+				throughput_gbps,
+				cycles_per_packet);
+		} else if (!ctx->options->csv) {
 			if (rte_atomic16_test_and_set(&display_once))
 				printf("%12s%12s%12s%12s%12s%12s%12s%12s%12s%12s\n\n",
 					"lcore id", "Buf Size", "Burst Size",
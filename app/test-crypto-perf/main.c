@@ -33,6 +33,12 @@ const char *cperf_test_type_strs[] = {
 	[CPERF_TEST_TYPE_PMDCC] = "pmd-cyclecount"
 };
 
+const char *cperf_dp_api_strs[] = {
+	[CPERF_DP_API_OP] = "op",
+	[CPERF_DP_API_RAW] = "raw",
+	[CPERF_DP_API_CPU] = "cpu-crypto"
+};
+
 const char *cperf_op_type_strs[] = {
 	[CPERF_CIPHER_ONLY] = "cipher-only",
 	[CPERF_AUTH_ONLY] = "auth-only",
@@ -502,6 +508,70 @@ cperf_check_test_vector(struct cperf_options *opts,
 	return 0;
 }
 
+/* Run the test on the first test_nb_lcores worker lcores. */
+static int
+cperf_run_lcores(const struct cperf_options *opts, void **ctx)
+{
+	uint32_t lcore_id, i;
+	int ret = 0;
+
+	i = 0;
+	RTE_LCORE_FOREACH_WORKER(lcore_id) {
+
+		if (i == opts->test_nb_lcores)
+			break;
+
+		rte_eal_remote_launch(cperf_testmap[opts->test].runner,
+			ctx[i], lcore_id);
+		i++;
+	}
+	i = 0;
+	RTE_LCORE_FOREACH_WORKER(lcore_id) {
+
+		if (i == opts->test_nb_lcores)
+			break;
+		ret |= rte_eal_wait_lcore(lcore_id);
+		i++;
+	}
+
+	return ret;
+}
+
+/* Run the test for the IMIX distribution or each buffer size. */
+static int
+cperf_run_buffer_sizes(struct cperf_options *opts, void **ctx)
+{
+	uint8_t buffer_size_idx = 0;
+	int ret;
+
+	if (opts->imix_distribution_count != 0)
+		return cperf_run_lcores(opts, ctx);
+
+	/* Get next size from range or list */
+	if (opts->inc_buffer_size != 0)
+		opts->test_buffer_size = opts->min_buffer_size;
+	else
+		opts->test_buffer_size = opts->buffer_size_list[0];
+
+	while (opts->test_buffer_size <= opts->max_buffer_size) {
+		ret = cperf_run_lcores(opts, ctx);
+		if (ret != EXIT_SUCCESS)
+			return ret;
+
+		/* Get next size from range or list */
+		if (opts->inc_buffer_size != 0)
+			opts->test_buffer_size += opts->inc_buffer_size;
+		else {
+			if (++buffer_size_idx == opts->buffer_size_count)
+				break;
+			opts->test_buffer_size =
+				opts->buffer_size_list[buffer_size_idx];
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
+
 int
 main(int argc, char **argv)
 {
@@ -514,7 +584,8 @@ main(int argc, char **argv)
 	uint8_t cdev_id, i;
 	uint8_t enabled_cdevs[RTE_CRYPTO_MAX_DEVS] = { 0 };
 
-	uint8_t buffer_size_idx = 0;
+	uint8_t sweep_idx = 0;
+	uint32_t nb_ctx;
 
 	int ret;
 	uint32_t lcore_id;
@@ -623,6 +694,7 @@ main(int argc, char **argv)
 			cdev_index++;
 		i++;
 	}
+	nb_ctx = i;
 
 	if (opts.imix_distribution_count != 0) {
 		uint8_t buffer_size_count = opts.buffer_size_count;
@@ -662,68 +734,45 @@ main(int argc, char **argv)
 
 		opts.test_buffer_size = test_average_size /
 				distribution_total[buffer_size_count - 1];
+	}
 
-		i = 0;
-		RTE_LCORE_FOREACH_WORKER(lcore_id) {
-
-			if (i == total_nb_qps)
-				break;
-
-			rte_eal_remote_launch(cperf_testmap[opts.test].runner,
-				ctx[i], lcore_id);
-			i++;
-		}
-		i = 0;
-		RTE_LCORE_FOREACH_WORKER(lcore_id) {
-
-			if (i == total_nb_qps)
+	/* Get first number of lcores from range or list */
+	if (opts.inc_lcore_sweep != 0)
+		opts.test_nb_lcores = opts.min_lcore_sweep;
+	else if (opts.lcore_sweep_count != 0)
+		opts.test_nb_lcores = opts.lcore_sweep_list[0];
+	else
+		opts.test_nb_lcores = nb_ctx;
+
+	while (1) {
+		if (opts.test_nb_lcores > nb_ctx) {
+			RTE_LOG(WARNING, USER1, "Skipping the test on %u "
+					"lcores, only %u are available\n",
+					opts.test_nb_lcores, nb_ctx);
+			if (opts.inc_lcore_sweep != 0)
 				break;
-			ret |= rte_eal_wait_lcore(lcore_id);
-			i++;
-		}
-
-		if (ret != EXIT_SUCCESS)
-			goto err;
-	} else {
-
-		/* Get next size from range or list */
-		if (opts.inc_buffer_size != 0)
-			opts.test_buffer_size = opts.min_buffer_size;
-		else
-			opts.test_buffer_size = opts.buffer_size_list[0];
-
-		while (opts.test_buffer_size <= opts.max_buffer_size) {
-			i = 0;
-			RTE_LCORE_FOREACH_WORKER(lcore_id) {
-
-				if (i == total_nb_qps)
-					break;
-
-				rte_eal_remote_launch(cperf_testmap[opts.test].runner,
-					ctx[i], lcore_id);
-				i++;
-			}
-			i = 0;
-			RTE_LCORE_FOREACH_WORKER(lcore_id) {
-
-				if (i == total_nb_qps)
-					break;
-				ret |= rte_eal_wait_lcore(lcore_id);
-				i++;
-			}
+		} else {
+			if ((opts.inc_lcore_sweep != 0 ||
+					opts.lcore_sweep_count != 0) &&
+					!opts.json)
+				printf("\n# Running on %u lcores\n",
+						opts.test_nb_lcores);
 
+			ret = cperf_run_buffer_sizes(&opts, ctx);
 			if (ret != EXIT_SUCCESS)
 				goto err;
+		}
 
-			/* Get next size from range or list */
-			if (opts.inc_buffer_size != 0)
-				opts.test_buffer_size += opts.inc_buffer_size;
-			else {
-				if (++buffer_size_idx == opts.buffer_size_count)
-					break;
-				opts.test_buffer_size =
-					opts.buffer_size_list[buffer_size_idx];
-			}
+		/* Get next number of lcores from range or list */
+		if (opts.inc_lcore_sweep != 0) {
+			opts.test_nb_lcores += opts.inc_lcore_sweep;
+			if (opts.test_nb_lcores > opts.max_lcore_sweep)
+				break;
+		} else {
+			if (++sweep_idx >= opts.lcore_sweep_count)
+				break;
+			opts.test_nb_lcores =
+				opts.lcore_sweep_list[sweep_idx];
 		}
 	}
 
@@ -66,6 +66,7 @@ struct evt_options {
 	uint32_t deq_tmo_nsec;
 	uint32_t q_priority:1;
 	uint32_t fwd_latency:1;
+	uint32_t stage_latency:1;
 	uint32_t ena_vector : 1;
 	uint64_t nb_pkts;
 	uint64_t nb_timers;
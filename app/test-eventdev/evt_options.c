@@ -81,6 +81,13 @@ evt_parse_fwd_latency(struct evt_options *opt, const char *arg __rte_unused)
 	return 0;
 }
 
+static int
+evt_parse_stage_latency(struct evt_options *opt, const char *arg __rte_unused)
+{
+	opt->stage_latency = 1;
+	return 0;
+}
+
 static int
 evt_parse_queue_priority(struct evt_options *opt, const char *arg __rte_unused)
 {
@@ -314,6 +321,7 @@ usage(char *program)
 		"\t--nb_pkts          : number of packets to produce\n"
 		"\t--worker_deq_depth : dequeue depth of the worker\n"
 		"\t--fwd_latency      : perform fwd_latency measurement\n"
+		"\t--stage_latency    : record per stage latency histograms\n"
 		"\t--queue_priority   : enable queue priority\n"
 		"\t--deq_tmo_nsec     : global dequeue timeout\n"
 		"\t--prod_type_ethdev : use ethernet device as producer.\n"
@@ -392,6 +400,7 @@ static struct option lgopts[] = {
 	{ EVT_WKR_DEQ_DEP,         1, 0, 0 },
 	{ EVT_SCHED_TYPE_LIST,     1, 0, 0 },
 	{ EVT_FWD_LATENCY,         0, 0, 0 },
+	{ EVT_STAGE_LATENCY,       0, 0, 0 },
 	{ EVT_QUEUE_PRIORITY,      0, 0, 0 },
 	{ EVT_DEQ_TMO_NSEC,        1, 0, 0 },
 	{ EVT_PROD_ETHDEV,         0, 0, 0 },
@@ -430,6 +439,7 @@ evt_opts_parse_long(int opt_idx, struct evt_options *opt)
 		{ EVT_WKR_DEQ_DEP, evt_parse_wkr_deq_dep},
 		{ EVT_SCHED_TYPE_LIST, evt_parse_sched_type_list},
 		{ EVT_FWD_LATENCY, evt_parse_fwd_latency},
+		{ EVT_STAGE_LATENCY, evt_parse_stage_latency},
 		{ EVT_QUEUE_PRIORITY, evt_parse_queue_priority},
 		{ EVT_DEQ_TMO_NSEC, evt_parse_deq_tmo_nsec},
 		{ EVT_PROD_ETHDEV, evt_parse_eth_prod_type},
@@ -30,6 +30,7 @@
 #define EVT_NB_STAGES            ("nb_stages")
 #define EVT_SCHED_TYPE_LIST      ("stlist")
 #define EVT_FWD_LATENCY          ("fwd_latency")
+#define EVT_STAGE_LATENCY        ("stage_latency")
 #define EVT_QUEUE_PRIORITY       ("queue_priority")
 #define EVT_DEQ_TMO_NSEC         ("deq_tmo_nsec")
 #define EVT_PROD_ETHDEV          ("prod_type_ethdev")
@@ -204,6 +205,22 @@ evt_dump_fwd_latency(struct evt_options *opt)
 	evt_dump("fwd_latency", "%s", EVT_BOOL_FMT(opt->fwd_latency));
 }
 
+static inline void
+evt_dump_stage_latency(struct evt_options *opt)
+{
+	evt_dump("stage_latency", "%s", EVT_BOOL_FMT(opt->stage_latency));
+}
+
+static inline void
+evt_dump_vector(struct evt_options *opt)
+{
+	evt_dump("event_vector", "%d", opt->ena_vector);
+	if (opt->ena_vector) {
+		evt_dump("vector_size", "%d", opt->vector_size);
+		evt_dump("vector_tmo_ns", "%" PRIu64 "", opt->vector_tmo_nsec);
+	}
+}
+
 static inline void
 evt_dump_queue_priority(struct evt_options *opt)
 {
@@ -15,13 +15,13 @@ atq_nb_event_queues(struct evt_options *opt)
 }
 
 static __rte_always_inline void
-atq_mark_fwd_latency(struct rte_event *const ev)
+atq_mark_fwd_latency(struct worker_data *const w, struct rte_event *const ev,
+		const uint8_t nb_stages, const uint8_t prod_timer_type)
 {
-	if (unlikely(ev->sub_event_type == 0)) {
-		struct perf_elt *const m = ev->event_ptr;
+	const uint8_t stage = ev->sub_event_type % nb_stages;
 
-		m->timestamp = rte_get_timer_cycles();
-	}
+	/* first stage in pipeline, mark ts to compute fwd latency */
+	perf_mark_latency(w, ev, stage, !prod_timer_type && stage == 0);
 }
 
 static __rte_always_inline void
@@ -34,6 +34,16 @@ atq_fwd_event(struct rte_event *const ev, uint8_t *const sched_type_list,
 	ev->event_type = RTE_EVENT_TYPE_CPU;
 }
 
+static __rte_always_inline void
+atq_fwd_event_vector(struct rte_event *const ev,
+		uint8_t *const sched_type_list, const uint8_t nb_stages)
+{
+	ev->sub_event_type++;
+	ev->sched_type = sched_type_list[ev->sub_event_type % nb_stages];
+	ev->op = RTE_EVENT_OP_FORWARD;
+	ev->event_type = RTE_EVENT_TYPE_CPU_VECTOR;
+}
+
 static int
 perf_atq_worker(void *arg, const int enable_fwd_latency)
 {
@@ -48,9 +58,8 @@ perf_atq_worker(void *arg, const int enable_fwd_latency)
 			continue;
 		}
 
-		if (enable_fwd_latency && !prod_timer_type)
-		/* first stage in pipeline, mark ts to compute fwd latency */
-			atq_mark_fwd_latency(&ev);
+		if (enable_fwd_latency)
+			atq_mark_fwd_latency(w, &ev, nb_stages, prod_timer_type);
 
 		/* last stage in pipeline */
 		if (unlikely((ev.sub_event_type % nb_stages) == laststage)) {
@@ -87,12 +96,10 @@ perf_atq_worker_burst(void *arg, const int enable_fwd_latency)
 		}
 
 		for (i = 0; i < nb_rx; i++) {
-			if (enable_fwd_latency && !prod_timer_type) {
+			if (enable_fwd_latency) {
 				rte_prefetch0(ev[i+1].event_ptr);
-				/* first stage in pipeline.
-				 * mark time stamp to compute fwd latency
-				 */
-				atq_mark_fwd_latency(&ev[i]);
+				atq_mark_fwd_latency(w, &ev[i], nb_stages,
+						prod_timer_type);
 			}
 			/* last stage in pipeline */
 			if (unlikely((ev[i].sub_event_type % nb_stages)
@@ -122,6 +129,54 @@ perf_atq_worker_burst(void *arg, const int enable_fwd_latency)
 	return 0;
 }
 
+static int
+perf_atq_worker_vector(void *arg, const int enable_fwd_latency,
+		const uint16_t deq_sz)
+{
+	PERF_WORKER_INIT;
+	uint16_t i;
+	struct rte_event ev[BURST_SIZE];
+
+	RTE_SET_USED(bufs);
+	RTE_SET_USED(sz);
+	RTE_SET_USED(cnt);
+	while (t->done == false) {
+		uint16_t const nb_rx = rte_event_dequeue_burst(dev, port, ev,
+				deq_sz, 0);
+
+		if (!nb_rx) {
+			rte_pause();
+			continue;
+		}
+
+		for (i = 0; i < nb_rx; i++) {
+			const uint8_t stage = ev[i].sub_event_type % nb_stages;
+
+			if (enable_fwd_latency)
+				perf_mark_vector_latency(w, &ev[i], stage,
+					!prod_timer_type && stage == 0);
+			/* last stage in pipeline */
+			if (unlikely(stage == laststage)) {
+				perf_process_last_stage_vector(pool, &ev[i], w,
+						enable_fwd_latency);
+				ev[i].op = RTE_EVENT_OP_RELEASE;
+			} else {
+				atq_fwd_event_vector(&ev[i], sched_type_list,
+						nb_stages);
+			}
+		}
+
+		uint16_t enq;
+
+		enq = rte_event_enqueue_burst(dev, port, ev, nb_rx);
+		while (enq < nb_rx) {
+			enq += rte_event_enqueue_burst(dev, port,
+							ev + enq, nb_rx - enq);
+		}
+	}
+	return 0;
+}
+
 static int
 worker_wrapper(void *arg)
 {
@@ -129,7 +184,11 @@ worker_wrapper(void *arg)
 	struct evt_options *opt = w->t->opt;
 
 	const bool burst = evt_has_burst_mode(w->dev_id);
-	const int fwd_latency = opt->fwd_latency;
+	const int fwd_latency = opt->fwd_latency || opt->stage_latency;
+
+	if (opt->ena_vector)
+		return perf_atq_worker_vector(arg, fwd_latency,
+				burst ? BURST_SIZE : 1);
 
 	/* allow compiler to optimize */
 	if (!burst && !fwd_latency)
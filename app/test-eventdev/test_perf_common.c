@@ -6,6 +6,66 @@
 
 #include "test_perf_common.h"
 
+static inline double
+perf_lat_bucket_us(int bucket, double cycles_per_us)
+{
+	/* upper bound of the bucket */
+	return (double)(1ULL << bucket) / cycles_per_us;
+}
+
+static void
+perf_stage_latency_dump(struct test_perf *t)
+{
+	static const double pct[] = {50, 90, 99, 99.9};
+	const double cycles_per_us = (double)rte_get_timer_hz() / 1E6;
+	uint64_t hist[PERF_LAT_BUCKETS];
+	uint64_t total, sum;
+	int stage, b, i;
+	unsigned int p;
+
+	printf("Latency since the producer per stage (us):\n");
+	for (stage = 0; stage < t->opt->nb_stages; stage++) {
+		memset(hist, 0, sizeof(hist));
+		total = 0;
+		for (i = 0; i < t->nb_workers; i++) {
+			const uint64_t *h = &t->worker[i].stage_hist[stage *
+				PERF_LAT_BUCKETS];
+
+			for (b = 0; b < PERF_LAT_BUCKETS; b++) {
+				hist[b] += h[b];
+				total += h[b];
+			}
+		}
+
+		printf("Stage %d events: "CLGRN"%"PRIu64 CLNRM, stage, total);
+		if (total == 0) {
+			printf("\n");
+			continue;
+		}
+
+		sum = 0;
+		p = 0;
+		for (b = 0; b < PERF_LAT_BUCKETS && p < RTE_DIM(pct); b++) {
+			sum += hist[b];
+			while (p < RTE_DIM(pct) &&
+					sum >= ceil(pct[p] * total / 100)) {
+				printf(" p%g: "CLGRN"%.3f"CLNRM, pct[p],
+					perf_lat_bucket_us(b, cycles_per_us));
+				p++;
+			}
+		}
+		printf("\n");
+
+		for (b = 0; b < PERF_LAT_BUCKETS; b++) {
+			if (hist[b] == 0)
+				continue;
+			printf("  < %12.3f: %"PRIu64" (%3.2f%%)\n",
+				perf_lat_bucket_us(b, cycles_per_us), hist[b],
+				((double)hist[b] / total) * 100);
+		}
+	}
+}
+
 int
 perf_test_result(struct evt_test *test, struct evt_options *opt)
 {
@@ -24,6 +84,9 @@ perf_test_result(struct evt_test *test, struct evt_options *opt)
 				(((double)t->worker[i].processed_pkts)/total)
 				* 100);
 
+	if (t->stage_hist != NULL)
+		perf_stage_latency_dump(t);
+
 	return t->result;
 }
 
@@ -63,12 +126,14 @@ perf_producer(void *arg)
 			ev.flow_id = flow_counter++ % nb_flows;
 			ev.event_ptr = m[i];
 			m[i]->timestamp = rte_get_timer_cycles();
+			m[i]->prod_timestamp = m[i]->timestamp;
 			while (rte_event_enqueue_burst(dev_id,
 						       port, &ev, 1) != 1) {
 				if (t->done)
 					break;
 				rte_pause();
 				m[i]->timestamp = rte_get_timer_cycles();
+				m[i]->prod_timestamp = m[i]->timestamp;
 			}
 		}
 		count += BURST_SIZE;
@@ -77,6 +142,74 @@ perf_producer(void *arg)
 	return 0;
 }
 
+static inline void
+perf_vector_timestamp(struct rte_event_vector *vec)
+{
+	const uint64_t now = rte_get_timer_cycles();
+	uint16_t i;
+
+	for (i = 0; i < vec->nb_elem; i++) {
+		struct perf_elt *m = vec->ptrs[i];
+
+		m->timestamp = now;
+		m->prod_timestamp = now;
+	}
+}
+
+static inline int
+perf_producer_vector(void *arg)
+{
+	struct prod_data *p  = arg;
+	struct test_perf *t = p->t;
+	struct evt_options *opt = t->opt;
+	const uint8_t dev_id = p->dev_id;
+	const uint8_t port = p->port_id;
+	struct rte_mempool *pool = t->pool;
+	struct rte_mempool *vector_pool = t->vector_pool;
+	const uint64_t nb_pkts = t->nb_pkts;
+	const uint32_t nb_flows = t->nb_flows;
+	const uint16_t vector_size = opt->vector_size;
+	uint32_t flow_counter = 0;
+	uint64_t count = 0;
+	struct rte_event_vector *vec;
+	struct rte_event ev;
+
+	if (opt->verbose_level > 1)
+		printf("%s(): lcore %d dev_id %d port=%d queue %d\n", __func__,
+				rte_lcore_id(), dev_id, port, p->queue_id);
+
+	ev.event = 0;
+	ev.op = RTE_EVENT_OP_NEW;
+	ev.queue_id = p->queue_id;
+	ev.sched_type = t->opt->sched_type_list[0];
+	ev.priority = RTE_EVENT_DEV_PRIORITY_NORMAL;
+	ev.event_type = RTE_EVENT_TYPE_CPU_VECTOR;
+	ev.sub_event_type = 0; /* stage 0 */
+
+	while (count < nb_pkts && t->done == false) {
+		if (rte_mempool_get(vector_pool, (void **)&vec) < 0)
+			continue;
+		if (rte_mempool_get_bulk(pool, vec->ptrs, vector_size) < 0) {
+			rte_mempool_put(vector_pool, vec);
+			continue;
+		}
+		vec->nb_elem = vector_size;
+		vec->attr_valid = 0;
+		ev.flow_id = flow_counter++ % nb_flows;
+		ev.vec = vec;
+		perf_vector_timestamp(vec);
+		while (rte_event_enqueue_burst(dev_id, port, &ev, 1) != 1) {
+			if (t->done)
+				break;
+			rte_pause();
+			perf_vector_timestamp(vec);
+		}
+		count += vector_size;
+	}
+
+	return 0;
+}
+
 static inline int
 perf_event_timer_producer(void *arg)
 {
@@ -123,12 +256,14 @@ perf_event_timer_producer(void *arg)
 			m[i]->tim.ev.flow_id = flow_counter++ % nb_flows;
 			m[i]->tim.ev.event_ptr = m[i];
 			m[i]->timestamp = rte_get_timer_cycles();
+			m[i]->prod_timestamp = m[i]->timestamp;
 			while (rte_event_timer_arm_burst(
 			       adptr[flow_counter % nb_timer_adptrs],
 			       (struct rte_event_timer **)&m[i], 1) != 1) {
 				if (t->done)
 					break;
 				m[i]->timestamp = rte_get_timer_cycles();
+				m[i]->prod_timestamp = m[i]->timestamp;
 			}
 			arm_latency += rte_get_timer_cycles() - m[i]->timestamp;
 		}
@@ -189,6 +324,7 @@ perf_event_timer_producer_burst(void *arg)
 			m[i]->tim.ev.flow_id = flow_counter++ % nb_flows;
 			m[i]->tim.ev.event_ptr = m[i];
 			m[i]->timestamp = rte_get_timer_cycles();
+			m[i]->prod_timestamp = m[i]->timestamp;
 		}
 		rte_event_timer_arm_tmo_tick_burst(
 				adptr[flow_counter % nb_timer_adptrs],
@@ -213,7 +349,9 @@ perf_producer_wrapper(void *arg)
 	struct prod_data *p  = arg;
 	struct test_perf *t = p->t;
 	/* Launch the producer function only in case of synthetic producer. */
-	if (t->opt->prod_type == EVT_PROD_TYPE_SYNT)
+	if (t->opt->prod_type == EVT_PROD_TYPE_SYNT && t->opt->ena_vector)
+		return perf_producer_vector(arg);
+	else if (t->opt->prod_type == EVT_PROD_TYPE_SYNT)
 		return perf_producer(arg);
 	else if (t->opt->prod_type == EVT_PROD_TYPE_EVENT_TIMER_ADPTR &&
 			!t->opt->timdev_use_burst)
@@ -354,18 +492,48 @@ perf_launch_lcores(struct evt_test *test, struct evt_options *opt,
 	return 0;
 }
 
+static int
+perf_vector_limits_check(struct evt_options *opt, uint16_t min_sz,
+		uint16_t max_sz, uint8_t log2_sz, uint64_t min_timeout_ns,
+		uint64_t max_timeout_ns)
+{
+	if (opt->vector_size < min_sz || opt->vector_size > max_sz) {
+		evt_err("Vector size [%d] not within limits max[%d] min[%d]",
+			opt->vector_size, max_sz, min_sz);
+		return -EINVAL;
+	}
+
+	if (log2_sz && !rte_is_power_of_2(opt->vector_size)) {
+		evt_err("Vector size [%d] not power of 2", opt->vector_size);
+		return -EINVAL;
+	}
+
+	if (opt->vector_tmo_nsec > max_timeout_ns ||
+	    opt->vector_tmo_nsec < min_timeout_ns) {
+		evt_err("Vector timeout [%" PRIu64 "] not within limits max[%"
+			PRIu64 "] min[%" PRIu64 "]", opt->vector_tmo_nsec,
+			max_timeout_ns, min_timeout_ns);
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
 static int
 perf_event_rx_adapter_setup(struct evt_options *opt, uint8_t stride,
-		struct rte_event_port_conf prod_conf)
+		struct rte_event_port_conf prod_conf,
+		struct rte_mempool *vector_pool)
 {
 	int ret = 0;
 	uint16_t prod;
 	struct rte_event_eth_rx_adapter_queue_conf queue_conf;
+	struct rte_event_eth_rx_adapter_event_vector_config vec_conf;
 
 	memset(&queue_conf, 0,
 			sizeof(struct rte_event_eth_rx_adapter_queue_conf));
 	queue_conf.ev.sched_type = opt->sched_type_list[0];
 	RTE_ETH_FOREACH_DEV(prod) {
+		struct rte_event_eth_rx_adapter_vector_limits limits;
 		uint32_t cap;
 
 		ret = rte_event_eth_rx_adapter_caps_get(opt->dev_id,
@@ -376,6 +544,30 @@ perf_event_rx_adapter_setup(struct evt_options *opt, uint8_t stride,
 					opt->dev_id);
 			return ret;
 		}
+
+		if (opt->ena_vector) {
+			memset(&limits, 0, sizeof(limits));
+			ret = rte_event_eth_rx_adapter_vector_limits_get(
+				opt->dev_id, prod, &limits);
+			if (ret) {
+				evt_err("failed to get vector limits");
+				return ret;
+			}
+
+			ret = perf_vector_limits_check(opt, limits.min_sz,
+					limits.max_sz, limits.log2_sz,
+					limits.min_timeout_ns,
+					limits.max_timeout_ns);
+			if (ret)
+				return ret;
+
+			if (!(cap & RTE_EVENT_ETH_RX_ADAPTER_CAP_EVENT_VECTOR)) {
+				evt_err("Rx adapter doesn't support event vector");
+				return -EINVAL;
+			}
+			queue_conf.rx_queue_flags |=
+				RTE_EVENT_ETH_RX_ADAPTER_QUEUE_EVENT_VECTOR;
+		}
 		queue_conf.ev.queue_id = prod * stride;
 		ret = rte_event_eth_rx_adapter_create(prod, opt->dev_id,
 				&prod_conf);
@@ -390,6 +582,17 @@ perf_event_rx_adapter_setup(struct evt_options *opt, uint8_t stride,
 			return ret;
 		}
 
+		if (opt->ena_vector) {
+			vec_conf.vector_sz = opt->vector_size;
+			vec_conf.vector_timeout_ns = opt->vector_tmo_nsec;
+			vec_conf.vector_mp = vector_pool;
+			if (rte_event_eth_rx_adapter_queue_event_vector_config(
+				    prod, prod, -1, &vec_conf) < 0) {
+				evt_err("Failed to configure event vectorization for Rx adapter");
+				return -EINVAL;
+			}
+		}
+
 		if (!(cap & RTE_EVENT_ETH_RX_ADAPTER_CAP_INTERNAL_PORT)) {
 			uint32_t service_id;
 
@@ -441,6 +644,44 @@ perf_event_timer_adapter_setup(struct test_perf *t)
 		rte_event_timer_adapter_get_info(wl, &adapter_info);
 		t->opt->optm_timer_tick_nsec = adapter_info.min_resolution_ns;
 
+		if (t->opt->ena_vector) {
+			struct rte_event_timer_adapter_event_vector_config
+				vec_conf = {
+				.vector_sz = t->opt->vector_size,
+				.vector_timeout_ns = t->opt->vector_tmo_nsec,
+				.vector_mp = t->vector_pool,
+			};
+			struct rte_event_timer_adapter_vector_limits limits;
+
+			if (!(adapter_info.caps &
+				RTE_EVENT_TIMER_ADAPTER_CAP_EVENT_VECTOR)) {
+				evt_err("Timer adapter doesn't support event vector");
+				return -EINVAL;
+			}
+
+			memset(&limits, 0, sizeof(limits));
+			ret = rte_event_timer_adapter_vector_limits_get(wl,
+					&limits);
+			if (ret) {
+				evt_err("failed to get vector limits");
+				return ret;
+			}
+
+			ret = perf_vector_limits_check(t->opt, limits.min_sz,
+					limits.max_sz, limits.log2_sz,
+					limits.min_timeout_ns,
+					limits.max_timeout_ns);
+			if (ret)
+				return ret;
+
+			ret = rte_event_timer_adapter_event_vector_config(wl,
+					&vec_conf);
+			if (ret) {
+				evt_err("Failed to configure event vectorization for timer adapter");
+				return ret;
+			}
+		}
+
 		if (!(adapter_info.caps &
 				RTE_EVENT_TIMER_ADAPTER_CAP_INTERNAL_PORT)) {
 			uint32_t service_id = -1U;
@@ -479,6 +720,9 @@ perf_event_dev_port_setup(struct evt_test *test, struct evt_options *opt,
 		w->t = t;
 		w->processed_pkts = 0;
 		w->latency = 0;
+		w->stage_hist = t->stage_hist == NULL ? NULL :
+			&t->stage_hist[port * opt->nb_stages *
+				PERF_LAT_BUCKETS];
 
 		ret = rte_event_port_setup(opt->dev_id, port, port_conf);
 		if (ret) {
@@ -500,7 +744,8 @@ perf_event_dev_port_setup(struct evt_test *test, struct evt_options *opt,
 			p->t = t;
 		}
 
-		ret = perf_event_rx_adapter_setup(opt, stride, *port_conf);
+		ret = perf_event_rx_adapter_setup(opt, stride, *port_conf,
+				t->vector_pool);
 		if (ret)
 			return ret;
 	} else if (opt->prod_type == EVT_PROD_TYPE_EVENT_TIMER_ADPTR) {
@@ -612,7 +857,18 @@ perf_opt_check(struct evt_options *opt, uint64_t nb_queues)
 		opt->fwd_latency = 0;
 	}
 
-	if (opt->fwd_latency && !opt->q_priority) {
+	if (opt->stage_latency &&
+			opt->prod_type == EVT_PROD_TYPE_ETH_RX_ADPTR) {
+		evt_info("stage_latency is not valid with ethdev producer, disabling");
+		opt->stage_latency = 0;
+	}
+
+	if (opt->ena_vector && opt->vector_size == 0) {
+		evt_err("vector size should be greater than 0");
+		return -1;
+	}
+
+	if ((opt->fwd_latency || opt->stage_latency) && !opt->q_priority) {
 		evt_info("enabled queue priority for latency measurement");
 		opt->q_priority = 1;
 	}
@@ -635,6 +891,8 @@ perf_opt_dump(struct evt_options *opt, uint8_t nb_queues)
 	evt_dump_queue_priority(opt);
 	evt_dump_sched_type_list(opt);
 	evt_dump_producer_type(opt);
+	evt_dump_stage_latency(opt);
+	evt_dump_vector(opt);
 }
 
 void
@@ -783,6 +1041,19 @@ perf_mempool_setup(struct evt_test *test, struct evt_options *opt)
 		return -ENOMEM;
 	}
 
+	if (opt->ena_vector) {
+		unsigned int nb_elem = (opt->pool_sz / opt->vector_size) << 1;
+
+		nb_elem = nb_elem ? nb_elem : 1;
+		t->vector_pool = rte_event_vector_pool_create("perf_vector_pool",
+				nb_elem, 0, opt->vector_size, opt->socket_id);
+		if (t->vector_pool == NULL) {
+			evt_err("failed to create event vector pool");
+			rte_mempool_free(t->pool);
+			return -ENOMEM;
+		}
+	}
+
 	return 0;
 }
 
@@ -792,6 +1063,7 @@ perf_mempool_destroy(struct evt_test *test, struct evt_options *opt)
 	RTE_SET_USED(opt);
 	struct test_perf *t = evt_test_priv(test);
 
+	rte_mempool_free(t->vector_pool);
 	rte_mempool_free(t->pool);
 }
 
@@ -827,6 +1099,19 @@ perf_test_setup(struct evt_test *test, struct evt_options *opt)
 	t->opt = opt;
 	memcpy(t->sched_type_list, opt->sched_type_list,
 			sizeof(opt->sched_type_list));
+
+	if (opt->stage_latency) {
+		t->stage_hist = rte_zmalloc_socket(test->name,
+				sizeof(uint64_t) * t->nb_workers *
+				opt->nb_stages * PERF_LAT_BUCKETS,
+				RTE_CACHE_LINE_SIZE, opt->socket_id);
+		if (t->stage_hist == NULL) {
+			evt_err("failed to allocate stage latency memory");
+			rte_free(test_perf);
+			test->test_priv = NULL;
+			goto nomem;
+		}
+	}
 	return 0;
 nomem:
 	return -ENOMEM;
@@ -836,6 +1121,8 @@ void
 perf_test_destroy(struct evt_test *test, struct evt_options *opt)
 {
 	RTE_SET_USED(opt);
+	struct test_perf *t = evt_test_priv(test);
 
+	rte_free(t->stage_hist);
 	rte_free(test->test_priv);
 }
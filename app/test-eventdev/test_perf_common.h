@@ -28,6 +28,8 @@ struct test_perf;
 struct worker_data {
 	uint64_t processed_pkts;
 	uint64_t latency;
+	/* per stage latency histograms, PERF_LAT_BUCKETS per stage */
+	uint64_t *stage_hist;
 	uint8_t dev_id;
 	uint8_t port_id;
 	struct test_perf *t;
@@ -52,6 +54,8 @@ struct test_perf {
 	uint32_t nb_flows;
 	uint64_t nb_pkts;
 	struct rte_mempool *pool;
+	struct rte_mempool *vector_pool;
+	uint64_t *stage_hist;
 	struct prod_data prod[EVT_MAX_PORTS];
 	struct worker_data worker[EVT_MAX_PORTS];
 	struct evt_options *opt;
@@ -66,11 +70,15 @@ struct perf_elt {
 		struct {
 			char pad[offsetof(struct rte_event_timer, user_meta)];
 			uint64_t timestamp;
+			/* set by the producer, for the stage latencies */
+			uint64_t prod_timestamp;
 		};
 	};
 } __rte_cache_aligned;
 
 #define BURST_SIZE 16
+/* log2 buckets of the latency in timer cycles */
+#define PERF_LAT_BUCKETS 64
 
 #define PERF_WORKER_INIT\
 	struct worker_data *w  = arg;\
@@ -141,6 +149,89 @@ perf_process_last_stage_latency(struct rte_mempool *const pool,
 	return count;
 }
 
+static __rte_always_inline void
+perf_stage_latency(struct worker_data *const w, const uint8_t stage,
+		const struct perf_elt *const m, const uint64_t now)
+{
+	const uint64_t latency = now - m->prod_timestamp;
+
+	w->stage_hist[stage * PERF_LAT_BUCKETS +
+		RTE_MIN(rte_fls_u64(latency), PERF_LAT_BUCKETS - 1)]++;
+}
+
+/* Sample the latency since the producer of an event entering a stage, and
+ * mark the forward latency timestamp on the first stage.
+ */
+static __rte_always_inline void
+perf_mark_latency(struct worker_data *const w, struct rte_event *const ev,
+		const uint8_t stage, const uint8_t mark)
+{
+	struct perf_elt *const m = ev->event_ptr;
+	uint64_t now;
+
+	if (!mark && w->stage_hist == NULL)
+		return;
+
+	now = rte_get_timer_cycles();
+	if (mark)
+		m->timestamp = now;
+	if (w->stage_hist != NULL)
+		perf_stage_latency(w, stage, m, now);
+}
+
+static __rte_always_inline void
+perf_mark_vector_latency(struct worker_data *const w,
+		struct rte_event *const ev, const uint8_t stage,
+		const uint8_t mark)
+{
+	struct rte_event_vector *const vec = ev->vec;
+	uint64_t now;
+	uint16_t i;
+
+	if (!mark && w->stage_hist == NULL)
+		return;
+
+	now = rte_get_timer_cycles();
+	for (i = 0; i < vec->nb_elem; i++) {
+		struct perf_elt *const m = vec->ptrs[i];
+
+		if (mark)
+			m->timestamp = now;
+		if (w->stage_hist != NULL)
+			perf_stage_latency(w, stage, m, now);
+	}
+}
+
+static __rte_always_inline void
+perf_process_last_stage_vector(struct rte_mempool *const pool,
+		struct rte_event *const ev, struct worker_data *const w,
+		const int enable_fwd_latency)
+{
+	struct rte_event_vector *const vec = ev->vec;
+	const uint16_t nb_elem = vec->nb_elem;
+	uint16_t i;
+
+	if (enable_fwd_latency) {
+		const uint64_t now = rte_get_timer_cycles();
+		uint64_t latency = 0;
+
+		for (i = 0; i < nb_elem; i++)
+			latency += now -
+				((struct perf_elt *)vec->ptrs[i])->timestamp;
+		w->latency += latency;
+	}
+
+	rte_mempool_put_bulk(pool, vec->ptrs, nb_elem);
+	rte_mempool_put(rte_mempool_from_obj(vec), vec);
+
+	/* release fence here ensures the vector elements are
+	 * stored before updating the number of
+	 * processed packets for worker lcores
+	 */
+	rte_atomic_thread_fence(__ATOMIC_RELEASE);
+	w->processed_pkts += nb_elem;
+}
+
 
 static inline int
 perf_nb_event_ports(struct evt_options *opt)
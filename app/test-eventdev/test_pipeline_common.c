@@ -37,11 +37,7 @@ pipeline_opt_dump(struct evt_options *opt, uint8_t nb_queues)
 	evt_dump_sched_type_list(opt);
 	evt_dump_producer_type(opt);
 	evt_dump("nb_eth_rx_queues", "%d", opt->eth_queues);
-	evt_dump("event_vector", "%d", opt->ena_vector);
-	if (opt->ena_vector) {
-		evt_dump("vector_size", "%d", opt->vector_size);
-		evt_dump("vector_tmo_ns", "%" PRIu64 "", opt->vector_tmo_nsec);
-	}
+	evt_dump_vector(opt);
 }
 
 static inline uint64_t
@@ -16,6 +16,9 @@
 #define NR_RXD  256
 #define NR_TXD  256
 #define MAX_PORTS 64
+#define DEFAULT_ASYNC_QUEUE_SIZE 1024
+#define DEFAULT_ASYNC_PUSH_BATCH 32
+#define ASYNC_PULL_BURST 64
 #define METER_CIR 1250000
 #define DEFAULT_METER_PROF_ID 100
 
@@ -34,6 +34,36 @@ fill_attributes(struct rte_flow_attr *attr,
 	attr->group = group;
 }
 
+static void
+fill_flow(struct rte_flow_attr *attr,
+	struct rte_flow_item *items,
+	struct rte_flow_action *actions,
+	uint16_t group,
+	uint64_t *flow_attrs,
+	uint64_t *flow_items,
+	uint64_t *flow_actions,
+	uint16_t next_table,
+	uint32_t outer_ip_src,
+	uint16_t hairpinq,
+	uint64_t encap_data,
+	uint64_t decap_data,
+	uint8_t core_idx,
+	bool unique_data)
+{
+	memset(items, 0, sizeof(*items) * MAX_ITEMS_NUM);
+	memset(actions, 0, sizeof(*actions) * MAX_ACTIONS_NUM);
+	memset(attr, 0, sizeof(struct rte_flow_attr));
+
+	fill_attributes(attr, flow_attrs, group);
+
+	fill_actions(actions, flow_actions,
+		outer_ip_src, next_table, hairpinq,
+		encap_data, decap_data, core_idx,
+		unique_data);
+
+	fill_items(items, flow_items, outer_ip_src, core_idx);
+}
+
 struct rte_flow *
 generate_flow(uint16_t port_id,
 	uint16_t group,
@@ -54,19 +84,112 @@ generate_flow(uint16_t port_id,
 	struct rte_flow_action actions[MAX_ACTIONS_NUM];
 	struct rte_flow *flow = NULL;
 
-	memset(items, 0, sizeof(items));
-	memset(actions, 0, sizeof(actions));
-	memset(&attr, 0, sizeof(struct rte_flow_attr));
-
-	fill_attributes(&attr, flow_attrs, group);
-
-	fill_actions(actions, flow_actions,
-		outer_ip_src, next_table, hairpinq,
+	fill_flow(&attr, items, actions, group,
+		flow_attrs, flow_items, flow_actions,
+		next_table, outer_ip_src, hairpinq,
 		encap_data, decap_data, core_idx,
 		unique_data);
 
-	fill_items(items, flow_items, outer_ip_src, core_idx);
-
 	flow = rte_flow_create(port_id, &attr, items, actions, error);
 	return flow;
 }
+
+/*
+ * The templates are made of the first rule, all the rules then
+ * having the same items and actions with their own specs and
+ * configurations.
+ */
+struct rte_flow_template_table *
+generate_template_table(uint16_t port_id,
+	uint16_t group,
+	uint64_t *flow_attrs,
+	uint64_t *flow_items,
+	uint64_t *flow_actions,
+	uint16_t next_table,
+	uint16_t hairpinq,
+	uint64_t encap_data,
+	uint64_t decap_data,
+	bool unique_data,
+	uint32_t nb_flows,
+	struct rte_flow_error *error)
+{
+	struct rte_flow_attr attr;
+	struct rte_flow_item items[MAX_ITEMS_NUM];
+	struct rte_flow_action actions[MAX_ACTIONS_NUM];
+	struct rte_flow_action masks[MAX_ACTIONS_NUM];
+	struct rte_flow_pattern_template_attr it_attr;
+	struct rte_flow_actions_template_attr at_attr;
+	struct rte_flow_template_table_attr table_attr;
+	struct rte_flow_pattern_template *it;
+	struct rte_flow_actions_template *at;
+	uint8_t i;
+
+	fill_flow(&attr, items, actions, group,
+		flow_attrs, flow_items, flow_actions,
+		next_table, 0, hairpinq,
+		encap_data, decap_data, 0,
+		unique_data);
+
+	memset(&it_attr, 0, sizeof(it_attr));
+	it_attr.ingress = attr.ingress;
+	it_attr.egress = attr.egress;
+	it_attr.transfer = attr.transfer;
+	it = rte_flow_pattern_template_create(port_id, &it_attr,
+		items, error);
+	if (it == NULL)
+		return NULL;
+
+	/* No constant action configuration, each rule gives its own. */
+	memset(masks, 0, sizeof(masks));
+	for (i = 0; i < MAX_ACTIONS_NUM; i++) {
+		masks[i].type = actions[i].type;
+		if (actions[i].type == RTE_FLOW_ACTION_TYPE_END)
+			break;
+	}
+	memset(&at_attr, 0, sizeof(at_attr));
+	at_attr.ingress = attr.ingress;
+	at_attr.egress = attr.egress;
+	at_attr.transfer = attr.transfer;
+	at = rte_flow_actions_template_create(port_id, &at_attr,
+		actions, masks, error);
+	if (at == NULL)
+		return NULL;
+
+	memset(&table_attr, 0, sizeof(table_attr));
+	table_attr.flow_attr = attr;
+	table_attr.nb_flows = nb_flows;
+	return rte_flow_template_table_create(port_id, &table_attr,
+		&it, 1, &at, 1, error);
+}
+
+struct rte_flow *
+generate_flow_async(uint16_t port_id,
+	uint32_t queue_id,
+	struct rte_flow_template_table *table,
+	uint64_t *flow_attrs,
+	uint64_t *flow_items,
+	uint64_t *flow_actions,
+	uint16_t next_table,
+	uint32_t outer_ip_src,
+	uint16_t hairpinq,
+	uint64_t encap_data,
+	uint64_t decap_data,
+	uint8_t core_idx,
+	bool unique_data,
+	void *user_data,
+	struct rte_flow_error *error)
+{
+	const struct rte_flow_op_attr op_attr = { .postpone = 1 };
+	struct rte_flow_attr attr;
+	struct rte_flow_item items[MAX_ITEMS_NUM];
+	struct rte_flow_action actions[MAX_ACTIONS_NUM];
+
+	fill_flow(&attr, items, actions, 0,
+		flow_attrs, flow_items, flow_actions,
+		next_table, outer_ip_src, hairpinq,
+		encap_data, decap_data, core_idx,
+		unique_data);
+
+	return rte_flow_async_create(port_id, queue_id, &op_attr, table,
+		items, 0, actions, 0, user_data, error);
+}
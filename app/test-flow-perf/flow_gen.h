@@ -38,4 +38,35 @@ generate_flow(uint16_t port_id,
 	bool unique_data,
 	struct rte_flow_error *error);
 
+struct rte_flow_template_table *
+generate_template_table(uint16_t port_id,
+	uint16_t group,
+	uint64_t *flow_attrs,
+	uint64_t *flow_items,
+	uint64_t *flow_actions,
+	uint16_t next_table,
+	uint16_t hairpinq,
+	uint64_t encap_data,
+	uint64_t decap_data,
+	bool unique_data,
+	uint32_t nb_flows,
+	struct rte_flow_error *error);
+
+struct rte_flow *
+generate_flow_async(uint16_t port_id,
+	uint32_t queue_id,
+	struct rte_flow_template_table *table,
+	uint64_t *flow_attrs,
+	uint64_t *flow_items,
+	uint64_t *flow_actions,
+	uint16_t next_table,
+	uint32_t outer_ip_src,
+	uint16_t hairpinq,
+	uint64_t encap_data,
+	uint64_t decap_data,
+	uint8_t core_idx,
+	bool unique_data,
+	void *user_data,
+	struct rte_flow_error *error);
+
 #endif /* FLOW_PERF_FLOW_GEN */
@@ -35,6 +35,7 @@
 #include <rte_ethdev.h>
 #include <rte_flow.h>
 #include <rte_mtr.h>
+#include <rte_pause.h>
 
 #include "config.h"
 #include "flow_gen.h"
@@ -43,6 +44,7 @@
 #define DEFAULT_RULES_COUNT    4000000
 #define DEFAULT_RULES_BATCH     100000
 #define DEFAULT_GROUP                0
+#define DEFAULT_CHURN_TIME          10
 
 struct rte_flow *flow;
 static uint8_t flow_group;
@@ -62,6 +64,9 @@ static bool delete_flag;
 static bool dump_socket_mem_flag;
 static bool enable_fwd;
 static bool unique_data;
+static bool async_mode;
+static bool latency_flag;
+static const char *json_file;
 
 static struct rte_mempool *mbuf_mp;
 static uint32_t nb_lcores;
@@ -69,6 +74,12 @@ static uint32_t rules_count;
 static uint32_t rules_batch;
 static uint32_t hairpin_queues_num; /* total hairpin q number - default: 0 */
 static uint32_t nb_lcores;
+static uint32_t async_queue_size;
+static uint32_t async_push_batch;
+static uint32_t churn_rate; /* rules per second per port - default: 0 */
+static uint32_t churn_time;
+
+static struct rte_flow_template_table *async_tables[MAX_PORTS];
 
 #define MAX_PKT_BURST    32
 #define LCORE_MODE_PKT    1
@@ -102,11 +113,36 @@ struct used_cpu_time {
 	double deletion[MAX_PORTS][RTE_MAX_LCORE];
 };
 
+/* Per rule latency percentiles. */
+#define LATENCY_PCT_NUM 5
+static const double latency_pcts[LATENCY_PCT_NUM] = { 50, 90, 99, 99.9, 100 };
+static const char * const latency_pct_names[LATENCY_PCT_NUM] = {
+	"p50", "p90", "p99", "p99.9", "max",
+};
+
+struct rules_latency {
+	/* Cycles per rule, each core filling its own slice. */
+	uint64_t *insertion[MAX_PORTS];
+	uint64_t *deletion[MAX_PORTS];
+	/* Percentiles in microseconds. */
+	double insertion_pct[MAX_PORTS][LATENCY_PCT_NUM];
+	double deletion_pct[MAX_PORTS][LATENCY_PCT_NUM];
+};
+
+/* State of the flow queue of a core in asynchronous mode. */
+struct async_queue {
+	uint32_t pending; /* Operations whose result is not pulled. */
+	uint32_t unpushed; /* Operations enqueued since the last push. */
+	uint64_t *latency; /* Latency slice to complete, NULL if unused. */
+};
+
 struct multi_cores_pool {
 	uint32_t cores_count;
 	uint32_t rules_count;
 	struct used_cpu_time meters_record;
 	struct used_cpu_time flows_record;
+	struct rules_latency flows_latency;
+	double churn_rate[MAX_PORTS][RTE_MAX_LCORE];
 	int64_t last_alloc[RTE_MAX_LCORE];
 	int64_t current_alloc[RTE_MAX_LCORE];
 } __rte_cache_aligned;
@@ -134,6 +170,18 @@ usage(char *progname)
 	printf("  --portmask=N: hexadecimal bitmask of ports used\n");
 	printf("  --unique-data: flag to set using unique data for all"
 		" actions that support data, such as header modify and encap actions\n");
+	printf("  --async: insert and delete the rules with the asynchronous"
+		" flow API, one flow queue per core\n");
+	printf("  --async-queue-size=N: set the size of the flow queues,"
+		" default is %d\n", DEFAULT_ASYNC_QUEUE_SIZE);
+	printf("  --async-push=N: push the flow queues every N operations,"
+		" default is %d\n", DEFAULT_ASYNC_PUSH_BATCH);
+	printf("  --churn-rate=N: after insertion, replace rules at N rules"
+		" per second on each port\n");
+	printf("  --churn-time=N: run the rules churn for N seconds\n");
+	printf("  --latency: measure the latency percentiles of each rule"
+		" insertion and deletion\n");
+	printf("  --json=FILE: write the results in JSON format to FILE\n");
 
 	printf("To set flow attributes:\n");
 	printf("  --ingress: set ingress attribute in flows\n");
@@ -573,6 +621,13 @@ args_parse(int argc, char **argv)
 		{ "unique-data",                0, 0, 0 },
 		{ "portmask",                   1, 0, 0 },
 		{ "cores",                      1, 0, 0 },
+		{ "async",                      0, 0, 0 },
+		{ "async-queue-size",           1, 0, 0 },
+		{ "async-push",                 1, 0, 0 },
+		{ "churn-rate",                 1, 0, 0 },
+		{ "churn-time",                 1, 0, 0 },
+		{ "latency",                    0, 0, 0 },
+		{ "json",                       1, 0, 0 },
 		/* Attributes */
 		{ "ingress",                    0, 0, 0 },
 		{ "egress",                     0, 0, 0 },
@@ -802,6 +857,45 @@ args_parse(int argc, char **argv)
 						RTE_MAX_LCORE);
 				}
 			}
+			if (strcmp(lgopts[opt_idx].name, "async") == 0)
+				async_mode = true;
+			if (strcmp(lgopts[opt_idx].name,
+					"async-queue-size") == 0) {
+				n = atoi(optarg);
+				if (n > 0)
+					async_queue_size = n;
+				else
+					rte_exit(EXIT_FAILURE,
+						"async-queue-size should be > 0\n");
+			}
+			if (strcmp(lgopts[opt_idx].name, "async-push") == 0) {
+				n = atoi(optarg);
+				if (n > 0)
+					async_push_batch = n;
+				else
+					rte_exit(EXIT_FAILURE,
+						"async-push should be > 0\n");
+			}
+			if (strcmp(lgopts[opt_idx].name, "churn-rate") == 0) {
+				n = atoi(optarg);
+				if (n > 0)
+					churn_rate = n;
+				else
+					rte_exit(EXIT_FAILURE,
+						"churn-rate should be > 0\n");
+			}
+			if (strcmp(lgopts[opt_idx].name, "churn-time") == 0) {
+				n = atoi(optarg);
+				if (n > 0)
+					churn_time = n;
+				else
+					rte_exit(EXIT_FAILURE,
+						"churn-time should be > 0\n");
+			}
+			if (strcmp(lgopts[opt_idx].name, "latency") == 0)
+				latency_flag = true;
+			if (strcmp(lgopts[opt_idx].name, "json") == 0)
+				json_file = optarg;
 			break;
 		default:
 			usage(argv[0]);
@@ -1068,33 +1162,165 @@ create_meter_profile(void)
 	}
 }
 
+/*
+ * Pull the results of the completed operations of the core flow queue,
+ * turning the start time of the rules into their latency.
+ */
+static void
+async_pull(int port_id, uint8_t core_id, struct async_queue *q)
+{
+	struct rte_flow_op_result res[ASYNC_PULL_BURST];
+	struct rte_flow_error error;
+	uint64_t now;
+	int n, i;
+
+	n = rte_flow_pull(port_id, core_id, res, RTE_DIM(res), &error);
+	if (n < 0) {
+		print_flow_error(error);
+		rte_exit(EXIT_FAILURE, "Error in pulling flow operations\n");
+	}
+	now = rte_get_timer_cycles();
+	for (i = 0; i < n; i++) {
+		if (res[i].status != RTE_FLOW_OP_SUCCESS)
+			rte_exit(EXIT_FAILURE,
+				"Error in asynchronous flow operation\n");
+		if (q->latency != NULL)
+			q->latency[(uintptr_t)res[i].user_data] =
+				now - q->latency[(uintptr_t)res[i].user_data];
+	}
+	q->pending -= n;
+}
+
+static void
+async_push(int port_id, uint8_t core_id, struct async_queue *q)
+{
+	struct rte_flow_error error;
+
+	if (rte_flow_push(port_id, core_id, &error)) {
+		print_flow_error(error);
+		rte_exit(EXIT_FAILURE, "Error in pushing flow operations\n");
+	}
+	q->unpushed = 0;
+}
+
+/* Account an enqueued operation, pushing the queue every batch. */
+static void
+async_post(int port_id, uint8_t core_id, struct async_queue *q)
+{
+	q->pending++;
+	if (++q->unpushed < async_push_batch)
+		return;
+	async_push(port_id, core_id, q);
+	async_pull(port_id, core_id, q);
+}
+
+/* Wait for the results of all the enqueued operations. */
+static void
+async_drain(int port_id, uint8_t core_id, struct async_queue *q)
+{
+	async_push(port_id, core_id, q);
+	while (q->pending)
+		async_pull(port_id, core_id, q);
+}
+
+static struct rte_flow *
+async_insert_flow(int port_id, uint8_t core_id, uint32_t counter,
+	uint32_t lat_idx, struct async_queue *q)
+{
+	struct rte_flow_error error;
+	struct rte_flow *flow;
+
+	if (q->latency != NULL)
+		q->latency[lat_idx] = rte_get_timer_cycles();
+	for (;;) {
+		flow = generate_flow_async(port_id, core_id,
+			async_tables[port_id], flow_attrs,
+			flow_items, flow_actions,
+			JUMP_ACTION_TABLE, counter,
+			hairpin_queues_num,
+			encap_data, decap_data,
+			core_id, unique_data,
+			(void *)(uintptr_t)lat_idx, &error);
+		if (flow != NULL)
+			break;
+		if (rte_errno != EAGAIN) {
+			print_flow_error(error);
+			rte_exit(EXIT_FAILURE, "Error in creating flow\n");
+		}
+		/* Queue full, make room. */
+		async_push(port_id, core_id, q);
+		async_pull(port_id, core_id, q);
+	}
+	async_post(port_id, core_id, q);
+	return flow;
+}
+
+static void
+async_destroy_flow(int port_id, uint8_t core_id, struct rte_flow *flow,
+	uint32_t lat_idx, struct async_queue *q)
+{
+	const struct rte_flow_op_attr op_attr = { .postpone = 1 };
+	struct rte_flow_error error;
+
+	if (q->latency != NULL)
+		q->latency[lat_idx] = rte_get_timer_cycles();
+	while (rte_flow_async_destroy(port_id, core_id, &op_attr, flow,
+			(void *)(uintptr_t)lat_idx, &error)) {
+		if (rte_errno != EAGAIN) {
+			print_flow_error(error);
+			rte_exit(EXIT_FAILURE, "Error in deleting flow\n");
+		}
+		async_push(port_id, core_id, q);
+		async_pull(port_id, core_id, q);
+	}
+	async_post(port_id, core_id, q);
+}
+
 static inline void
 destroy_flows(int port_id, uint8_t core_id, struct rte_flow **flows_list)
 {
 	struct rte_flow_error error;
+	struct async_queue q = { 0 };
 	clock_t start_batch, end_batch;
 	double cpu_time_used = 0;
 	double deletion_rate;
 	double cpu_time_per_batch[MAX_BATCHES_COUNT] = { 0 };
 	double delta;
-	uint32_t i;
+	uint64_t start_rule = 0;
+	uint32_t i, first = 0;
 	int rules_batch_idx;
 	int rules_count_per_core;
 
 	rules_count_per_core = rules_count / mc_pool.cores_count;
+	if (latency_flag)
+		q.latency = mc_pool.flows_latency.deletion[port_id] +
+			core_id * rules_count_per_core;
 	/* If group > 0 , should add 1 flow which created in group 0 */
-	if (flow_group > 0 && core_id == 0)
+	if (flow_group > 0 && core_id == 0) {
 		rules_count_per_core++;
+		first = 1;
+	}
 
 	start_batch = rte_get_timer_cycles();
 	for (i = 0; i < (uint32_t) rules_count_per_core; i++) {
 		if (flows_list[i] == 0)
 			break;
 
-		memset(&error, 0x33, sizeof(error));
-		if (rte_flow_destroy(port_id, flows_list[i], &error)) {
-			print_flow_error(error);
-			rte_exit(EXIT_FAILURE, "Error in deleting flow\n");
+		/* The group 0 rule is always synchronous. */
+		if (async_mode && i >= first) {
+			async_destroy_flow(port_id, core_id, flows_list[i],
+				i - first, &q);
+		} else {
+			if (q.latency != NULL)
+				start_rule = rte_get_timer_cycles();
+			memset(&error, 0x33, sizeof(error));
+			if (rte_flow_destroy(port_id, flows_list[i], &error)) {
+				print_flow_error(error);
+				rte_exit(EXIT_FAILURE, "Error in deleting flow\n");
+			}
+			if (q.latency != NULL && i >= first)
+				q.latency[i - first] =
+					rte_get_timer_cycles() - start_rule;
 		}
 
 		/*
@@ -1113,6 +1339,13 @@ destroy_flows(int port_id, uint8_t core_id, struct rte_flow **flows_list)
 		}
 	}
 
+	/* Count the completion of the last operations. */
+	if (async_mode) {
+		async_drain(port_id, core_id, &q);
+		cpu_time_used += (double)(rte_get_timer_cycles() - start_batch) /
+			rte_get_timer_hz();
+	}
+
 	/* Print deletion rates for all batches */
 	if (dump_iterations)
 		print_rules_batches(cpu_time_per_batch);
@@ -1132,7 +1365,9 @@ insert_flows(int port_id, uint8_t core_id)
 {
 	struct rte_flow **flows_list;
 	struct rte_flow_error error;
+	struct async_queue q = { 0 };
 	clock_t start_batch, end_batch;
+	uint64_t start_rule = 0;
 	double first_flow_latency;
 	double cpu_time_used;
 	double insertion_rate;
@@ -1151,6 +1386,9 @@ insert_flows(int port_id, uint8_t core_id)
 	if (core_id)
 		start_counter = core_id * rules_count_per_core;
 	end_counter = (core_id + 1) * rules_count_per_core;
+	if (latency_flag)
+		q.latency = mc_pool.flows_latency.insertion[port_id] +
+			start_counter;
 
 	global_items[0] = FLOW_ITEM_MASK(RTE_FLOW_ITEM_TYPE_ETH);
 	global_actions[0] = FLOW_ITEM_MASK(RTE_FLOW_ACTION_TYPE_JUMP);
@@ -1185,12 +1423,22 @@ insert_flows(int port_id, uint8_t core_id)
 
 	start_batch = rte_get_timer_cycles();
 	for (counter = start_counter; counter < end_counter; counter++) {
-		flow = generate_flow(port_id, flow_group,
-			flow_attrs, flow_items, flow_actions,
-			JUMP_ACTION_TABLE, counter,
-			hairpin_queues_num,
-			encap_data, decap_data,
-			core_id, unique_data, &error);
+		if (async_mode) {
+			flow = async_insert_flow(port_id, core_id, counter,
+				counter - start_counter, &q);
+		} else {
+			if (q.latency != NULL)
+				start_rule = rte_get_timer_cycles();
+			flow = generate_flow(port_id, flow_group,
+				flow_attrs, flow_items, flow_actions,
+				JUMP_ACTION_TABLE, counter,
+				hairpin_queues_num,
+				encap_data, decap_data,
+				core_id, unique_data, &error);
+			if (q.latency != NULL)
+				q.latency[counter - start_counter] =
+					rte_get_timer_cycles() - start_rule;
+		}
 
 		if (!counter) {
 			first_flow_latency = (double) (rte_get_timer_cycles() - start_batch);
@@ -1228,6 +1476,13 @@ insert_flows(int port_id, uint8_t core_id)
 		}
 	}
 
+	/* Count the completion of the last operations. */
+	if (async_mode) {
+		async_drain(port_id, core_id, &q);
+		cpu_time_used += (double)(rte_get_timer_cycles() - start_batch) /
+			rte_get_timer_hz();
+	}
+
 	/* Print insertion rates for all batches */
 	if (dump_iterations)
 		print_rules_batches(cpu_time_per_batch);
@@ -1246,6 +1501,77 @@ insert_flows(int port_id, uint8_t core_id)
 	return flows_list;
 }
 
+/*
+ * Replace the oldest rule of the core by a new one, deleting then
+ * inserting, at the target churn rate of the port shared by the cores.
+ * The operations late on their schedule are not skipped, so that the
+ * achieved rate shows whether the target is sustained.
+ */
+static void
+churn_flows(int port_id, uint8_t core_id, struct rte_flow **flows_list)
+{
+	struct rte_flow_error error;
+	struct async_queue q = { 0 };
+	struct rte_flow *new_flow;
+	uint64_t hz = rte_get_timer_hz();
+	uint64_t start, end, deadline;
+	uint32_t rules_count_per_core;
+	uint32_t first = 0, slot;
+	uint64_t ops;
+	double rate, achieved_rate;
+
+	rules_count_per_core = rules_count / mc_pool.cores_count;
+	/* The group 0 rule is kept. */
+	if (flow_group > 0 && core_id == 0)
+		first = 1;
+	rate = (double)churn_rate / mc_pool.cores_count;
+
+	start = rte_get_timer_cycles();
+	end = start + churn_time * hz;
+	for (ops = 0; !force_quit; ops++) {
+		deadline = start + (uint64_t)(ops * hz / rate);
+		if (deadline >= end)
+			break;
+		while (rte_get_timer_cycles() < deadline)
+			rte_pause();
+
+		slot = first + ops % rules_count_per_core;
+		if (async_mode) {
+			async_destroy_flow(port_id, core_id,
+				flows_list[slot], 0, &q);
+			new_flow = async_insert_flow(port_id, core_id,
+				rules_count + ops * mc_pool.cores_count + core_id,
+				0, &q);
+		} else {
+			if (rte_flow_destroy(port_id, flows_list[slot], &error)) {
+				print_flow_error(error);
+				rte_exit(EXIT_FAILURE, "Error in deleting flow\n");
+			}
+			new_flow = generate_flow(port_id, flow_group,
+				flow_attrs, flow_items, flow_actions,
+				JUMP_ACTION_TABLE,
+				rules_count + ops * mc_pool.cores_count + core_id,
+				hairpin_queues_num,
+				encap_data, decap_data,
+				core_id, unique_data, &error);
+			if (new_flow == NULL) {
+				print_flow_error(error);
+				rte_exit(EXIT_FAILURE, "Error in creating flow\n");
+			}
+		}
+		flows_list[slot] = new_flow;
+	}
+	if (async_mode)
+		async_drain(port_id, core_id, &q);
+
+	achieved_rate = (double)ops /
+		((double)(rte_get_timer_cycles() - start) / hz) / 1000;
+	printf(":: Port %d :: Core %d :: Rules churn rate -> %f K Rule/Sec"
+		" (target %f K Rule/Sec)\n",
+		port_id, core_id, achieved_rate, rate / 1000);
+	mc_pool.churn_rate[port_id][core_id] = achieved_rate;
+}
+
 static void
 flows_handler(uint8_t core_id)
 {
@@ -1274,6 +1600,10 @@ flows_handler(uint8_t core_id)
 			rte_exit(EXIT_FAILURE, "Error: Insertion Failed!\n");
 		mc_pool.current_alloc[core_id] = (int64_t)dump_socket_mem(stdout);
 
+		/* Churn part. */
+		if (churn_rate)
+			churn_flows(port_id, core_id, flows_list);
+
 		/* Deletion part. */
 		if (delete_flag) {
 			destroy_flows(port_id, core_id, flows_list);
@@ -1403,6 +1733,119 @@ dump_used_mem(uint16_t port)
 		port, flow_size_in_bytes);
 }
 
+static int
+cmp_cycles(const void *a, const void *b)
+{
+	uint64_t x = *(const uint64_t *)a;
+	uint64_t y = *(const uint64_t *)b;
+
+	return x < y ? -1 : x > y;
+}
+
+static void
+dump_latency(const char *item, uint16_t port, uint64_t *latency, double *pct)
+{
+	uint32_t nb_rules;
+	uint32_t i, idx;
+
+	nb_rules = (rules_count / mc_pool.cores_count) * mc_pool.cores_count;
+	if (latency == NULL || nb_rules == 0)
+		return;
+
+	qsort(latency, nb_rules, sizeof(*latency), cmp_cycles);
+	printf(":: [Per Rule Latency | %s] All Cores :: Port %d ::",
+		item, port);
+	for (i = 0; i < LATENCY_PCT_NUM; i++) {
+		idx = (uint32_t)((nb_rules - 1) * latency_pcts[i] / 100);
+		pct[i] = (double)latency[idx] * 1e6 / rte_get_timer_hz();
+		printf(" %s %.2f", latency_pct_names[i], pct[i]);
+	}
+	printf(" usec\n");
+}
+
+static void
+dump_json_ops(FILE *f, const char *name, const double *times,
+	const double *pct)
+{
+	double max_time = 0;
+	uint32_t i;
+
+	fprintf(f, ",\n\t\t\t\"%s\": {\n\t\t\t\t\"cores_time_sec\": [",
+		name);
+	for (i = 0; i < mc_pool.cores_count; i++) {
+		fprintf(f, "%s%f", i ? ", " : "", times[i]);
+		if (max_time < times[i])
+			max_time = times[i];
+	}
+	fprintf(f, "],\n\t\t\t\t\"time_sec\": %f", max_time);
+	fprintf(f, ",\n\t\t\t\t\"rate_krps\": %f",
+		max_time ? mc_pool.rules_count / max_time / 1000 : 0);
+	if (pct != NULL) {
+		fprintf(f, ",\n\t\t\t\t\"latency_usec\": {");
+		for (i = 0; i < LATENCY_PCT_NUM; i++)
+			fprintf(f, "%s\"%s\": %f", i ? ", " : "",
+				latency_pct_names[i], pct[i]);
+		fprintf(f, "}");
+	}
+	fprintf(f, "\n\t\t\t}");
+}
+
+/* Write the results of all ports, rates being in K rules per second. */
+static void
+dump_json(void)
+{
+	const char *sep = "";
+	double achieved_rate;
+	uint16_t port;
+	uint32_t i;
+	FILE *f;
+
+	f = fopen(json_file, "w");
+	if (f == NULL) {
+		printf("Cannot open JSON file %s: %s\n",
+			json_file, strerror(errno));
+		return;
+	}
+	fprintf(f, "{\n\t\"mode\": \"%s\",\n",
+		async_mode ? "async" : "sync");
+	if (async_mode)
+		fprintf(f, "\t\"async_queue_size\": %u,\n"
+			"\t\"async_push\": %u,\n",
+			async_queue_size, async_push_batch);
+	fprintf(f, "\t\"cores\": %u,\n\t\"rules_count\": %u,\n"
+		"\t\"ports\": [",
+		mc_pool.cores_count, mc_pool.rules_count);
+
+	RTE_ETH_FOREACH_DEV(port) {
+		/* If port outside portmask */
+		if (!((ports_mask >> port) & 0x1))
+			continue;
+		fprintf(f, "%s\n\t\t{\n\t\t\t\"port\": %u", sep, port);
+		sep = ",";
+		dump_json_ops(f, "insertion",
+			mc_pool.flows_record.insertion[port],
+			latency_flag ?
+			mc_pool.flows_latency.insertion_pct[port] : NULL);
+		if (delete_flag)
+			dump_json_ops(f, "deletion",
+				mc_pool.flows_record.deletion[port],
+				latency_flag ?
+				mc_pool.flows_latency.deletion_pct[port] : NULL);
+		if (churn_rate) {
+			achieved_rate = 0;
+			for (i = 0; i < mc_pool.cores_count; i++)
+				achieved_rate += mc_pool.churn_rate[port][i];
+			fprintf(f, ",\n\t\t\t\"churn\": {"
+				"\"target_krps\": %f, \"achieved_krps\": %f}",
+				(double)churn_rate / 1000, achieved_rate);
+		}
+		fprintf(f, "\n\t\t}");
+	}
+	fprintf(f, "\n\t]\n}\n");
+	fclose(f);
+	printf(":: Results written to %s\n", json_file);
+}
+
 static int
 run_rte_flow_handler_cores(void *data __rte_unused)
 {
@@ -1446,8 +1889,18 @@ run_rte_flow_handler_cores(void *data __rte_unused)
 				port, &mc_pool.meters_record);
 		dump_used_cpu_time("Flows:",
 			port, &mc_pool.flows_record);
+		if (latency_flag) {
+			dump_latency("Insertion", port,
+				mc_pool.flows_latency.insertion[port],
+				mc_pool.flows_latency.insertion_pct[port]);
+			dump_latency("Deletion", port,
+				mc_pool.flows_latency.deletion[port],
+				mc_pool.flows_latency.deletion_pct[port]);
+		}
 		dump_used_mem(port);
 	}
+	if (json_file != NULL)
+		dump_json();
 
 	return 0;
 }
@@ -1743,6 +2196,13 @@ init_port(void)
 	struct rte_eth_txconf txq_conf;
 	struct rte_eth_rxconf rxq_conf;
 	struct rte_eth_dev_info dev_info;
+	struct rte_flow_port_attr flow_port_attr = { 0 };
+	struct rte_flow_queue_attr flow_queue_attr = {
+		.size = async_queue_size,
+	};
+	const struct rte_flow_queue_attr *flow_queue_attrs[RTE_MAX_LCORE];
+	struct rte_flow_error error;
+	uint32_t i;
 
 	nr_queues = RXQ_NUM;
 	if (hairpin_queues_num != 0)
@@ -1846,12 +2306,44 @@ init_port(void)
 			}
 		}
 
+		if (async_mode) {
+			/* One flow queue per core inserting rules. */
+			for (i = 0; i < mc_pool.cores_count; i++)
+				flow_queue_attrs[i] = &flow_queue_attr;
+			ret = rte_flow_configure(port_id, &flow_port_attr,
+					mc_pool.cores_count, flow_queue_attrs,
+					&error);
+			if (ret != 0) {
+				print_flow_error(error);
+				rte_exit(EXIT_FAILURE,
+					":: flow queues configuration failed: err=%d, port=%u\n",
+					ret, port_id);
+			}
+		}
+
 		ret = rte_eth_dev_start(port_id);
 		if (ret < 0)
 			rte_exit(EXIT_FAILURE,
 				"rte_eth_dev_start:err=%d, port=%u\n",
 				ret, port_id);
 
+		if (async_mode) {
+			/* Room for the rules replaced and not yet pulled. */
+			async_tables[port_id] = generate_template_table(port_id,
+				flow_group, flow_attrs, flow_items,
+				flow_actions, JUMP_ACTION_TABLE,
+				hairpin_queues_num, encap_data, decap_data,
+				unique_data,
+				rules_count + mc_pool.cores_count *
+				async_queue_size, &error);
+			if (async_tables[port_id] == NULL) {
+				print_flow_error(error);
+				rte_exit(EXIT_FAILURE,
+					":: template table creation failed, port=%u\n",
+					port_id);
+			}
+		}
+
 		printf(":: initializing port: %d done\n", port_id);
 	}
 }
@@ -1875,6 +2367,9 @@ main(int argc, char **argv)
 	dump_socket_mem_flag = false;
 	flow_group = DEFAULT_GROUP;
 	unique_data = false;
+	async_queue_size = DEFAULT_ASYNC_QUEUE_SIZE;
+	async_push_batch = DEFAULT_ASYNC_PUSH_BATCH;
+	churn_time = DEFAULT_CHURN_TIME;
 
 	signal(SIGINT, signal_handler);
 	signal(SIGTERM, signal_handler);
@@ -1892,6 +2387,24 @@ main(int argc, char **argv)
 
 	printf(":: Flows Count per port: %d\n\n", rules_count);
 
+	if (latency_flag) {
+		RTE_ETH_FOREACH_DEV(port) {
+			if (!((ports_mask >> port) & 0x1))
+				continue;
+			mc_pool.flows_latency.insertion[port] = rte_zmalloc(
+				"insertion_latency",
+				sizeof(uint64_t) * rules_count, 0);
+			if (delete_flag)
+				mc_pool.flows_latency.deletion[port] =
+					rte_zmalloc("deletion_latency",
+					sizeof(uint64_t) * rules_count, 0);
+			if (mc_pool.flows_latency.insertion[port] == NULL ||
+			    (delete_flag &&
+			     mc_pool.flows_latency.deletion[port] == NULL))
+				rte_exit(EXIT_FAILURE, "No Memory available!\n");
+		}
+	}
+
 	if (has_meter())
 		create_meter_profile();
 	rte_eal_mp_remote_launch(run_rte_flow_handler_cores, NULL, CALL_MAIN);
@@ -1905,6 +2418,9 @@ main(int argc, char **argv)
 
 	RTE_ETH_FOREACH_DEV(port) {
 		rte_flow_flush(port, &error);
+		if (async_mode && async_tables[port] != NULL)
+			rte_flow_template_table_destroy(port,
+				async_tables[port], &error);
 		if (rte_eth_dev_stop(port) != 0)
 			printf("Failed to stop device on port %u\n", port);
 		rte_eth_dev_close(port);
@@ -162,7 +162,9 @@ pkt_burst_5tuple_swap(struct fwd_stream *fs)
 		}
 		mbuf_field_set(mb, ol_flags);
 	}
+	get_tx_start_cycles();
 	nb_tx = rte_eth_tx_burst(fs->tx_port, fs->tx_queue, pkts_burst, nb_rx);
+	get_tx_end_cycles(fs);
 	/*
 	 * Retry if necessary
 	 */
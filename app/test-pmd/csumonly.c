@@ -1110,8 +1110,10 @@ pkt_burst_checksum_forward(struct fwd_stream *fs)
 		printf("Preparing packet burst to transmit failed: %s\n",
 				rte_strerror(rte_errno));
 
+	get_tx_start_cycles();
 	nb_tx = rte_eth_tx_burst(fs->tx_port, fs->tx_queue, tx_pkts_burst,
 			nb_prep);
+	get_tx_end_cycles(fs);
 
 	/*
 	 * Retry if necessary
@@ -188,7 +188,9 @@ pkt_burst_flow_gen(struct fwd_stream *fs)
 		next_flow = (next_flow + 1) % cfg_n_flows;
 	}
 
+	get_tx_start_cycles();
 	nb_tx = rte_eth_tx_burst(fs->tx_port, fs->tx_queue, pkts_burst, nb_pkt);
+	get_tx_end_cycles(fs);
 	/*
 	 * Retry if necessary
 	 */
@@ -484,8 +484,10 @@ reply_to_icmp_echo_rqsts(struct fwd_stream *fs)
 
 	/* Send back ICMP echo replies, if any. */
 	if (nb_replies > 0) {
+		get_tx_start_cycles();
 		nb_tx = rte_eth_tx_burst(fs->tx_port, fs->tx_queue, pkts_burst,
 					 nb_replies);
+		get_tx_end_cycles(fs);
 		/*
 		 * Retry if necessary
 		 */
@@ -64,8 +64,10 @@ pkt_burst_io_forward(struct fwd_stream *fs)
 		return;
 	fs->rx_packets += nb_rx;
 
+	get_tx_start_cycles();
 	nb_tx = rte_eth_tx_burst(fs->tx_port, fs->tx_queue,
 			pkts_burst, nb_rx);
+	get_tx_end_cycles(fs);
 	/*
 	 * Retry if necessary
 	 */
@@ -0,0 +1,435 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <inttypes.h>
+
+#include <rte_common.h>
+#include <rte_byteorder.h>
+#include <rte_cycles.h>
+#include <rte_branch_prediction.h>
+#include <rte_malloc.h>
+#include <rte_mbuf.h>
+#include <rte_mbuf_dyn.h>
+#include <rte_ether.h>
+#include <rte_ethdev.h>
+#include <rte_ip.h>
+#include <rte_udp.h>
+
+#include "testpmd.h"
+
+/*
+ * Latency forwarding engine.
+ *
+ * Each stream sends probe packets on its Tx queue and receives them back,
+ * through a loopback or a device under test, on its Rx queue. A probe
+ * carries the TSC read just before its transmission, and the NIC clock of
+ * the Tx port when the Rx hardware timestamp offload is enabled. The
+ * latency is measured with the NIC clock when the probe is received on a
+ * port of the same device, which shares the clock, and with the TSC
+ * otherwise. The latencies are recorded per Rx queue in log-linear
+ * histograms, whose percentiles are displayed when the forwarding stops.
+ */
+
+#define LATENCY_MAGIC 0x4c4154454e435931ULL /* "LATENCY1" */
+#define IP_DEFTTL 64
+
+/* Each power of two is split in 2^LATENCY_HIST_SUB_BITS linear buckets. */
+#define LATENCY_HIST_SUB_BITS 4
+#define LATENCY_HIST_SUB (1 << LATENCY_HIST_SUB_BITS)
+/* Latencies are clamped below 2^40 ns, about 18 minutes. */
+#define LATENCY_HIST_MAX_BITS 40
+#define LATENCY_HIST_SIZE \
+	((LATENCY_HIST_MAX_BITS - LATENCY_HIST_SUB_BITS + 1) * LATENCY_HIST_SUB)
+
+/* Duration of the NIC clock frequency measurement. */
+#define LATENCY_CLOCK_MEASURE_MS 100
+
+struct latency_probe {
+	uint64_t magic;
+	uint64_t tsc;      /**< TSC at transmission. */
+	uint64_t hw_clock; /**< NIC clock of the Tx port, 0 if not read. */
+	uint16_t tx_port;
+} __rte_packed;
+
+struct latency_hist {
+	uint64_t count;
+	uint64_t sum;
+	uint64_t min;
+	uint64_t max;
+	uint64_t hw_count; /**< Latencies measured with the NIC clock. */
+	uint64_t buckets[LATENCY_HIST_SIZE];
+} __rte_cache_aligned;
+
+struct latency_port {
+	const struct rte_device *device;
+	uint64_t hw_hz;     /**< NIC clock frequency, 0 if not used. */
+	uint64_t *next_tsc; /**< Next transmission per Tx queue. */
+	struct latency_hist *hist; /**< Histogram per Rx queue. */
+};
+
+static struct latency_port *lat_ports[RTE_MAX_ETHPORTS];
+static uint64_t ts_flag;
+static int ts_offset = -1;
+
+static inline unsigned int
+latency_bucket(uint64_t ns)
+{
+	unsigned int msb;
+
+	if (ns < LATENCY_HIST_SUB)
+		return ns;
+	if (ns >= (UINT64_C(1) << LATENCY_HIST_MAX_BITS))
+		ns = (UINT64_C(1) << LATENCY_HIST_MAX_BITS) - 1;
+	msb = 63 - __builtin_clzll(ns);
+	return ((msb - LATENCY_HIST_SUB_BITS + 1) << LATENCY_HIST_SUB_BITS) +
+		((ns >> (msb - LATENCY_HIST_SUB_BITS)) & (LATENCY_HIST_SUB - 1));
+}
+
+/* Lowest latency recorded in a bucket. */
+static uint64_t
+latency_bucket_floor(unsigned int b)
+{
+	unsigned int msb;
+
+	if (b < LATENCY_HIST_SUB)
+		return b;
+	msb = (b >> LATENCY_HIST_SUB_BITS) + LATENCY_HIST_SUB_BITS - 1;
+	return (UINT64_C(1) << msb) |
+		((uint64_t)(b & (LATENCY_HIST_SUB - 1)) <<
+		 (msb - LATENCY_HIST_SUB_BITS));
+}
+
+static inline void
+latency_record(struct latency_hist *h, uint64_t ns)
+{
+	h->count++;
+	h->sum += ns;
+	if (ns < h->min)
+		h->min = ns;
+	if (ns > h->max)
+		h->max = ns;
+	h->buckets[latency_bucket(ns)]++;
+}
+
+static uint64_t
+latency_percentile(const struct latency_hist *h, double pct)
+{
+	uint64_t rank = (uint64_t)(h->count * pct / 100.0);
+	uint64_t seen = 0;
+	unsigned int b;
+
+	for (b = 0; b < LATENCY_HIST_SIZE; b++) {
+		seen += h->buckets[b];
+		if (seen > rank)
+			return RTE_MIN(RTE_MAX(latency_bucket_floor(b), h->min),
+				       h->max);
+	}
+	return h->max;
+}
+
+static void
+latency_build_pkt(struct rte_mbuf *pkt, portid_t tx_port,
+		  uint16_t pkt_len)
+{
+	struct rte_ether_hdr *eth_hdr;
+	struct rte_ipv4_hdr *ip_hdr;
+	struct rte_udp_hdr *udp_hdr;
+	struct latency_probe *probe;
+	uint16_t l3_len = pkt_len - sizeof(*eth_hdr);
+
+	eth_hdr = rte_pktmbuf_mtod(pkt, struct rte_ether_hdr *);
+	rte_ether_addr_copy(&peer_eth_addrs[tx_port], &eth_hdr->d_addr);
+	rte_ether_addr_copy(&ports[tx_port].eth_addr, &eth_hdr->s_addr);
+	eth_hdr->ether_type = rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4);
+
+	ip_hdr = (struct rte_ipv4_hdr *)(eth_hdr + 1);
+	memset(ip_hdr, 0, sizeof(*ip_hdr));
+	ip_hdr->version_ihl = RTE_IPV4_VHL_DEF;
+	ip_hdr->time_to_live = IP_DEFTTL;
+	ip_hdr->next_proto_id = IPPROTO_UDP;
+	ip_hdr->total_length = rte_cpu_to_be_16(l3_len);
+	ip_hdr->src_addr = rte_cpu_to_be_32(tx_ip_src_addr);
+	ip_hdr->dst_addr = rte_cpu_to_be_32(tx_ip_dst_addr);
+	ip_hdr->hdr_checksum = rte_ipv4_cksum(ip_hdr);
+
+	udp_hdr = (struct rte_udp_hdr *)(ip_hdr + 1);
+	udp_hdr->src_port = rte_cpu_to_be_16(tx_udp_src_port);
+	udp_hdr->dst_port = rte_cpu_to_be_16(tx_udp_dst_port);
+	udp_hdr->dgram_len = rte_cpu_to_be_16(l3_len - sizeof(*ip_hdr));
+	udp_hdr->dgram_cksum = 0;
+
+	probe = (struct latency_probe *)(udp_hdr + 1);
+	probe->magic = LATENCY_MAGIC;
+	probe->tx_port = tx_port;
+
+	pkt->data_len = pkt_len;
+	pkt->pkt_len = pkt_len;
+	pkt->nb_segs = 1;
+	pkt->ol_flags = 0;
+	pkt->l2_len = sizeof(*eth_hdr);
+	pkt->l3_len = sizeof(*ip_hdr);
+}
+
+static inline struct latency_probe *
+latency_probe_get(struct rte_mbuf *pkt)
+{
+	struct rte_ether_hdr *eth_hdr;
+	struct rte_vlan_hdr *vlan_hdr;
+	struct latency_probe *probe;
+	uint16_t ether_type;
+	uint32_t off;
+
+	eth_hdr = rte_pktmbuf_mtod(pkt, struct rte_ether_hdr *);
+	ether_type = eth_hdr->ether_type;
+	off = sizeof(*eth_hdr);
+	while (ether_type == rte_cpu_to_be_16(RTE_ETHER_TYPE_VLAN) ||
+	       ether_type == rte_cpu_to_be_16(RTE_ETHER_TYPE_QINQ)) {
+		if (off + sizeof(*vlan_hdr) > rte_pktmbuf_data_len(pkt))
+			return NULL;
+		vlan_hdr = rte_pktmbuf_mtod_offset(pkt, struct rte_vlan_hdr *,
+						   off);
+		ether_type = vlan_hdr->eth_proto;
+		off += sizeof(*vlan_hdr);
+	}
+	if (ether_type != rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4))
+		return NULL;
+	off += sizeof(struct rte_ipv4_hdr) + sizeof(struct rte_udp_hdr);
+	if (off + sizeof(*probe) > rte_pktmbuf_data_len(pkt))
+		return NULL;
+	probe = rte_pktmbuf_mtod_offset(pkt, struct latency_probe *, off);
+	if (probe->magic != LATENCY_MAGIC)
+		return NULL;
+	return probe;
+}
+
+static void
+latency_tx(struct fwd_stream *fs, uint64_t now)
+{
+	struct latency_port *lp = lat_ports[fs->tx_port];
+	struct rte_mbuf *pkts_burst[MAX_PKT_BURST];
+	struct rte_mempool *mbp = current_fwd_lcore()->mbp;
+	struct latency_probe *probe;
+	uint64_t hw_clock = 0;
+	uint16_t pkt_len;
+	uint16_t nb_pkt;
+	uint16_t nb_tx;
+	uint32_t retry;
+	uint16_t i;
+
+	if (now < lp->next_tsc[fs->tx_queue])
+		return;
+
+	nb_pkt = latency_interval != 0 ? 1 : nb_pkt_per_burst;
+	if (rte_pktmbuf_alloc_bulk(mbp, pkts_burst, nb_pkt) != 0)
+		return;
+
+	/* Probes are single segment, as small as their headers at least. */
+	pkt_len = RTE_MIN(tx_pkt_length, (uint16_t)
+			  (rte_pktmbuf_data_room_size(mbp) -
+			   RTE_PKTMBUF_HEADROOM));
+	pkt_len = RTE_MAX(pkt_len, (uint16_t)(sizeof(struct rte_ether_hdr) +
+			  sizeof(struct rte_ipv4_hdr) +
+			  sizeof(struct rte_udp_hdr) + sizeof(*probe)));
+	for (i = 0; i < nb_pkt; i++)
+		latency_build_pkt(pkts_burst[i], fs->tx_port, pkt_len);
+
+	/* The NIC clock is only worth reading if the peer compares it. */
+	if (lp->hw_hz != 0)
+		rte_eth_read_clock(fs->tx_port, &hw_clock);
+	/* Stamp as late as possible to exclude the packet building. */
+	now = rte_rdtsc();
+	for (i = 0; i < nb_pkt; i++) {
+		probe = rte_pktmbuf_mtod_offset(pkts_burst[i],
+				struct latency_probe *,
+				sizeof(struct rte_ether_hdr) +
+				sizeof(struct rte_ipv4_hdr) +
+				sizeof(struct rte_udp_hdr));
+		probe->tsc = now;
+		probe->hw_clock = hw_clock;
+	}
+
+	get_tx_start_cycles();
+	nb_tx = rte_eth_tx_burst(fs->tx_port, fs->tx_queue, pkts_burst, nb_pkt);
+	get_tx_end_cycles(fs);
+	if (unlikely(nb_tx < nb_pkt) && fs->retry_enabled) {
+		retry = 0;
+		while (nb_tx < nb_pkt && retry++ < burst_tx_retry_num) {
+			rte_delay_us(burst_tx_delay_time);
+			nb_tx += rte_eth_tx_burst(fs->tx_port, fs->tx_queue,
+					&pkts_burst[nb_tx], nb_pkt - nb_tx);
+		}
+	}
+	fs->tx_packets += nb_tx;
+	inc_tx_burst_stats(fs, nb_tx);
+	if (unlikely(nb_tx < nb_pkt)) {
+		fs->fwd_dropped += nb_pkt - nb_tx;
+		rte_pktmbuf_free_bulk(&pkts_burst[nb_tx], nb_pkt - nb_tx);
+	}
+
+	lp->next_tsc[fs->tx_queue] = now +
+		latency_interval * rte_get_tsc_hz() / US_PER_S;
+}
+
+static void
+latency_rx(struct fwd_stream *fs)
+{
+	struct latency_port *lp = lat_ports[fs->rx_port];
+	struct latency_hist *h = &lp->hist[fs->rx_queue];
+	struct rte_mbuf *pkts_burst[MAX_PKT_BURST];
+	struct latency_probe *probe;
+	struct rte_mbuf *pkt;
+	uint64_t tsc_hz = rte_get_tsc_hz();
+	uint64_t now;
+	uint64_t ns;
+	uint64_t hz;
+	int64_t delta;
+	uint16_t nb_rx;
+	uint16_t i;
+
+	nb_rx = rte_eth_rx_burst(fs->rx_port, fs->rx_queue, pkts_burst,
+				 nb_pkt_per_burst);
+	inc_rx_burst_stats(fs, nb_rx);
+	if (unlikely(nb_rx == 0))
+		return;
+	/* A single TSC read for the burst, the packets came together. */
+	now = rte_rdtsc();
+	fs->rx_packets += nb_rx;
+
+	for (i = 0; i < nb_rx; i++) {
+		pkt = pkts_burst[i];
+		probe = latency_probe_get(pkt);
+		if (probe == NULL)
+			continue;
+		if (lp->hw_hz != 0 && probe->hw_clock != 0 &&
+		    (pkt->ol_flags & ts_flag) != 0 &&
+		    probe->tx_port < RTE_MAX_ETHPORTS &&
+		    lat_ports[probe->tx_port] != NULL &&
+		    lat_ports[probe->tx_port]->device == lp->device) {
+			delta = *RTE_MBUF_DYNFIELD(pkt, ts_offset, uint64_t *) -
+				probe->hw_clock;
+			hz = lp->hw_hz;
+			h->hw_count++;
+		} else {
+			delta = now - probe->tsc;
+			hz = tsc_hz;
+		}
+		/* The clocks of the Tx and Rx cores may be slightly off. */
+		ns = delta > 0 ? (double)delta * NS_PER_S / hz : 0;
+		latency_record(h, ns);
+	}
+	rte_pktmbuf_free_bulk(pkts_burst, nb_rx);
+}
+
+static void
+pkt_burst_latency(struct fwd_stream *fs)
+{
+	uint64_t start_tsc = 0;
+
+	get_start_cycles(&start_tsc);
+	latency_tx(fs, rte_rdtsc());
+	latency_rx(fs);
+	get_end_cycles(fs, start_tsc);
+}
+
+/* Measure the NIC clock frequency against the TSC. */
+static uint64_t
+latency_measure_hw_hz(portid_t pi)
+{
+	uint64_t clk0, clk1, tsc0, tsc1;
+
+	if (rte_eth_read_clock(pi, &clk0) != 0)
+		return 0;
+	tsc0 = rte_rdtsc();
+	rte_delay_ms(LATENCY_CLOCK_MEASURE_MS);
+	if (rte_eth_read_clock(pi, &clk1) != 0)
+		return 0;
+	tsc1 = rte_rdtsc();
+	if (clk1 <= clk0 || tsc1 <= tsc0)
+		return 0;
+	return (clk1 - clk0) * (double)rte_get_tsc_hz() / (tsc1 - tsc0);
+}
+
+static void
+latency_fwd_end(portid_t pi)
+{
+	struct latency_port *lp = lat_ports[pi];
+	struct latency_hist *h;
+	queueid_t q;
+
+	if (lp == NULL)
+		return;
+
+	printf("\n  Latency of port %u in ns, measured with the %s clock:\n",
+	       pi, lp->hw_hz != 0 ? "NIC (same device) or TSC" : "TSC");
+	printf("  %5s %12s %10s %10s %10s %10s %10s %10s %10s\n",
+	       "RxQ", "count", "min", "avg", "p50", "p90", "p99", "p99.9",
+	       "max");
+	for (q = 0; q < nb_rxq; q++) {
+		h = &lp->hist[q];
+		if (h->count == 0)
+			continue;
+		printf("  %5u %12" PRIu64 " %10" PRIu64 " %10" PRIu64
+		       " %10" PRIu64 " %10" PRIu64 " %10" PRIu64
+		       " %10" PRIu64 " %10" PRIu64 "\n",
+		       q, h->count, h->min, h->sum / h->count,
+		       latency_percentile(h, 50), latency_percentile(h, 90),
+		       latency_percentile(h, 99), latency_percentile(h, 99.9),
+		       h->max);
+		if (h->hw_count != 0 && h->hw_count != h->count)
+			printf("  %5s %" PRIu64 " measured with the NIC clock\n",
+			       "", h->hw_count);
+	}
+
+	lat_ports[pi] = NULL;
+	rte_free(lp->next_tsc);
+	rte_free(lp->hist);
+	rte_free(lp);
+}
+
+static void
+latency_fwd_begin(portid_t pi)
+{
+	struct latency_port *lp;
+	queueid_t q;
+
+	lp = rte_zmalloc("testpmd latency", sizeof(*lp), RTE_CACHE_LINE_SIZE);
+	if (lp != NULL) {
+		lp->next_tsc = rte_zmalloc("testpmd latency tx",
+				RTE_MAX(nb_txq, (queueid_t)1) *
+				sizeof(*lp->next_tsc), RTE_CACHE_LINE_SIZE);
+		lp->hist = rte_zmalloc("testpmd latency hist",
+				RTE_MAX(nb_rxq, (queueid_t)1) *
+				sizeof(*lp->hist), RTE_CACHE_LINE_SIZE);
+	}
+	if (lp == NULL || lp->next_tsc == NULL || lp->hist == NULL)
+		rte_exit(EXIT_FAILURE,
+			 "rte_zmalloc(%d) struct latency_port failed\n",
+			 (int)pi);
+	for (q = 0; q < nb_rxq; q++)
+		lp->hist[q].min = UINT64_MAX;
+	lp->device = ports[pi].dev_info.device;
+
+	if (ports[pi].dev_conf.rxmode.offloads & DEV_RX_OFFLOAD_TIMESTAMP) {
+		if (ts_offset < 0) {
+			rte_mbuf_dyn_rx_timestamp_register(&ts_offset,
+							   &ts_flag);
+		}
+		if (ts_offset >= 0)
+			lp->hw_hz = latency_measure_hw_hz(pi);
+		if (lp->hw_hz == 0)
+			printf("Port %u: NIC clock not readable, "
+			       "latency measured with the TSC\n", pi);
+	}
+	lat_ports[pi] = lp;
+}
+
+struct fwd_engine latency_engine = {
+	.fwd_mode_name  = "latency",
+	.port_fwd_begin = latency_fwd_begin,
+	.port_fwd_end   = latency_fwd_end,
+	.packet_fwd     = pkt_burst_latency,
+};
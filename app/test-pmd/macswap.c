@@ -75,7 +75,9 @@ pkt_burst_mac_swap(struct fwd_stream *fs)
 
 	do_macswap(pkts_burst, nb_rx, txp);
 
+	get_tx_start_cycles();
 	nb_tx = rte_eth_tx_burst(fs->tx_port, fs->tx_queue, pkts_burst, nb_rx);
+	get_tx_end_cycles(fs);
 	/*
 	 * Retry if necessary
 	 */
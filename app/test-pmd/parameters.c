@@ -198,6 +198,10 @@ usage(char* progname)
 	printf("  --noisy-lkup-num-writes=N: do N random writes per packet\n");
 	printf("  --noisy-lkup-num-reads=N: do N random reads per packet\n");
 	printf("  --noisy-lkup-num-reads-writes=N: do N random reads and writes per packet\n");
+	printf("  --latency-interval=N: send a latency probe every N us\n");
+#ifdef RTE_LIB_FIB
+	printf("  --route-file=FILE: load the routes of the route mode from FILE\n");
+#endif
 	printf("  --no-iova-contig: mempool memory can be IOVA non contiguous. "
 	       "valid only with --mp-alloc=anon\n");
 	printf("  --rx-mq-mode=0xX: hexadecimal bitmask of RX mq mode can be "
@@ -621,6 +625,10 @@ launch_args_parse(int argc, char** argv)
 		{ "noisy-lkup-num-writes",	1, 0, 0 },
 		{ "noisy-lkup-num-reads",	1, 0, 0 },
 		{ "noisy-lkup-num-reads-writes", 1, 0, 0 },
+		{ "latency-interval",		1, 0, 0 },
+#ifdef RTE_LIB_FIB
+		{ "route-file",			1, 0, 0 },
+#endif
 		{ "no-iova-contig",             0, 0, 0 },
 		{ "rx-mq-mode",                 1, 0, 0 },
 		{ "record-core-cycles",         0, 0, 0 },
@@ -1374,6 +1382,23 @@ launch_args_parse(int argc, char** argv)
 					rte_exit(EXIT_FAILURE,
 						 "noisy-lkup-num-reads-writes must be >= 0\n");
 			}
+			if (!strcmp(lgopts[opt_idx].name, "latency-interval")) {
+				n = atoi(optarg);
+				if (n >= 0)
+					latency_interval = n;
+				else
+					rte_exit(EXIT_FAILURE,
+						 "latency-interval must be >= 0\n");
+			}
+#ifdef RTE_LIB_FIB
+			if (!strcmp(lgopts[opt_idx].name, "route-file")) {
+				if (strlcpy(route_file, optarg,
+					    sizeof(route_file)) >=
+				    sizeof(route_file))
+					rte_exit(EXIT_FAILURE,
+						 "route-file path too long\n");
+			}
+#endif
 			if (!strcmp(lgopts[opt_idx].name, "no-iova-contig"))
 				mempool_flags = MEMPOOL_F_NO_IOVA_CONTIG;
 
@@ -0,0 +1,321 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <arpa/inet.h>
+
+#include <rte_common.h>
+#include <rte_byteorder.h>
+#include <rte_cycles.h>
+#include <rte_branch_prediction.h>
+#include <rte_prefetch.h>
+#include <rte_mbuf.h>
+#include <rte_ether.h>
+#include <rte_ethdev.h>
+#include <rte_ip.h>
+#include <rte_fib.h>
+#include <rte_fib6.h>
+
+#include "testpmd.h"
+
+/*
+ * Forwarding of packets in route mode.
+ * The destination IPv4 or IPv6 address of each packet is looked up in a
+ * FIB loaded from the route file, whose next hops are port IDs. The packet
+ * Ethernet addresses are rewritten with the ones of the next hop port, the
+ * peer address as destination, before it is sent on the Tx port of the
+ * stream, as testpmd streams have a single Tx queue. The packets without
+ * route, or which are not IP, are dropped.
+ *
+ * Without route file, all packets are routed to the Tx port of the stream,
+ * after the same lookups.
+ */
+
+#define ROUTE_MAX_RULES (1 << 16)
+#define ROUTE_NUM_TBL8 (1 << 15)
+
+/* Next hop of the packets without route. */
+#define ROUTE_NH_DROP RTE_MAX_ETHPORTS
+/* Next hop of all packets without route file. */
+#define ROUTE_NH_STREAM (RTE_MAX_ETHPORTS + 1)
+
+static struct rte_fib *route_fib;
+static struct rte_fib6 *route_fib6;
+static unsigned int route_users;
+
+/* Return 1 if a route is added, 0 for a blank or comment line. */
+static int
+route_parse_line(char *line, unsigned int lineno)
+{
+	uint8_t ip6[RTE_FIB6_IPV6_ADDR_SIZE];
+	char *prefix, *depth_str, *port_str, *end;
+	struct in_addr ip4;
+	unsigned long depth, port;
+	int ret;
+
+	prefix = strtok(line, " \t\r\n");
+	if (prefix == NULL || prefix[0] == '#')
+		return 0;
+	port_str = strtok(NULL, " \t\r\n");
+	depth_str = strchr(prefix, '/');
+	if (port_str == NULL || depth_str == NULL)
+		goto invalid;
+	*depth_str++ = '\0';
+	depth = strtoul(depth_str, &end, 10);
+	if (*end != '\0')
+		goto invalid;
+	port = strtoul(port_str, &end, 10);
+	if (*end != '\0' || port >= RTE_MAX_ETHPORTS)
+		goto invalid;
+
+	if (inet_pton(AF_INET, prefix, &ip4) == 1) {
+		if (depth > RTE_FIB_MAXDEPTH)
+			goto invalid;
+		ret = rte_fib_add(route_fib, rte_be_to_cpu_32(ip4.s_addr),
+				  depth, port);
+	} else if (inet_pton(AF_INET6, prefix, ip6) == 1) {
+		if (depth > RTE_FIB6_MAXDEPTH)
+			goto invalid;
+		ret = rte_fib6_add(route_fib6, ip6, depth, port);
+	} else {
+		goto invalid;
+	}
+	if (ret != 0) {
+		fprintf(stderr, "route file line %u: cannot add route: %s\n",
+			lineno, strerror(-ret));
+		return ret;
+	}
+	return 1;
+
+invalid:
+	fprintf(stderr, "route file line %u: expected <prefix>/<depth> <port>\n",
+		lineno);
+	return -EINVAL;
+}
+
+static int
+route_load(const char *path)
+{
+	char line[256];
+	unsigned int lineno = 0;
+	unsigned int nb_routes = 0;
+	FILE *f;
+	int ret = 0;
+
+	f = fopen(path, "r");
+	if (f == NULL) {
+		fprintf(stderr, "Cannot open route file %s: %s\n",
+			path, strerror(errno));
+		return -errno;
+	}
+	while (fgets(line, sizeof(line), f) != NULL) {
+		ret = route_parse_line(line, ++lineno);
+		if (ret < 0)
+			break;
+		nb_routes += ret;
+	}
+	fclose(f);
+	if (ret < 0)
+		return ret;
+	printf("Loaded %u routes from %s\n", nb_routes, path);
+	return 0;
+}
+
+static void
+route_free(void)
+{
+	rte_fib_free(route_fib);
+	rte_fib6_free(route_fib6);
+	route_fib = NULL;
+	route_fib6 = NULL;
+}
+
+static int
+route_create(void)
+{
+	struct rte_fib_conf conf;
+	struct rte_fib6_conf conf6;
+	uint64_t default_nh;
+
+	default_nh = route_file[0] != '\0' ? ROUTE_NH_DROP : ROUTE_NH_STREAM;
+
+	memset(&conf, 0, sizeof(conf));
+	conf.type = RTE_FIB_DIR24_8;
+	conf.default_nh = default_nh;
+	conf.max_routes = ROUTE_MAX_RULES;
+	conf.dir24_8.nh_sz = RTE_FIB_DIR24_8_2B;
+	conf.dir24_8.num_tbl8 = ROUTE_NUM_TBL8;
+	route_fib = rte_fib_create("testpmd_route", SOCKET_ID_ANY, &conf);
+
+	memset(&conf6, 0, sizeof(conf6));
+	conf6.type = RTE_FIB6_TRIE;
+	conf6.default_nh = default_nh;
+	conf6.max_routes = ROUTE_MAX_RULES;
+	conf6.trie.nh_sz = RTE_FIB6_TRIE_2B;
+	conf6.trie.num_tbl8 = ROUTE_NUM_TBL8;
+	route_fib6 = rte_fib6_create("testpmd_route6", SOCKET_ID_ANY, &conf6);
+
+	if (route_fib == NULL || route_fib6 == NULL) {
+		fprintf(stderr, "Cannot create route FIBs: %s\n",
+			rte_strerror(rte_errno));
+		route_free();
+		return -ENOMEM;
+	}
+	if (route_file[0] != '\0' && route_load(route_file) != 0) {
+		route_free();
+		return -EINVAL;
+	}
+	return 0;
+}
+
+/* Rewrite the Ethernet addresses of a packet, false if it has no route. */
+static inline bool
+route_rewrite(struct fwd_stream *fs, struct rte_mbuf *mb, uint64_t nh)
+{
+	struct rte_ether_hdr *eth_hdr;
+
+	if (nh == ROUTE_NH_STREAM)
+		nh = fs->tx_port;
+	else if (unlikely(nh >= RTE_MAX_ETHPORTS))
+		return false;
+	eth_hdr = rte_pktmbuf_mtod(mb, struct rte_ether_hdr *);
+	rte_ether_addr_copy(&peer_eth_addrs[nh], &eth_hdr->d_addr);
+	rte_ether_addr_copy(&ports[nh].eth_addr, &eth_hdr->s_addr);
+	return true;
+}
+
+static void
+pkt_burst_route_forward(struct fwd_stream *fs)
+{
+	struct rte_mbuf *pkts_burst[MAX_PKT_BURST];
+	struct rte_mbuf *pkts_v4[MAX_PKT_BURST];
+	struct rte_mbuf *pkts_v6[MAX_PKT_BURST];
+	struct rte_mbuf *pkts_drop[MAX_PKT_BURST];
+	uint32_t ips_v4[MAX_PKT_BURST];
+	uint8_t ips_v6[MAX_PKT_BURST][RTE_FIB6_IPV6_ADDR_SIZE];
+	uint64_t nhs[MAX_PKT_BURST];
+	struct rte_ether_hdr *eth_hdr;
+	struct rte_ipv4_hdr *ip4_hdr;
+	struct rte_ipv6_hdr *ip6_hdr;
+	struct rte_mbuf *mb;
+	uint16_t nb_v4 = 0;
+	uint16_t nb_v6 = 0;
+	uint16_t nb_fwd = 0;
+	uint16_t nb_drop = 0;
+	uint16_t nb_rx;
+	uint16_t nb_tx;
+	uint32_t retry;
+	uint16_t i;
+	uint64_t start_tsc = 0;
+
+	get_start_cycles(&start_tsc);
+
+	nb_rx = rte_eth_rx_burst(fs->rx_port, fs->rx_queue, pkts_burst,
+				 nb_pkt_per_burst);
+	inc_rx_burst_stats(fs, nb_rx);
+	if (unlikely(nb_rx == 0))
+		return;
+	fs->rx_packets += nb_rx;
+
+	/* Gather the destination addresses for bulk lookups. */
+	for (i = 0; i < nb_rx; i++) {
+		if (likely(i < nb_rx - 1))
+			rte_prefetch0(rte_pktmbuf_mtod(pkts_burst[i + 1],
+						       void *));
+		mb = pkts_burst[i];
+		eth_hdr = rte_pktmbuf_mtod(mb, struct rte_ether_hdr *);
+		if (eth_hdr->ether_type ==
+		    rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4)) {
+			ip4_hdr = (struct rte_ipv4_hdr *)(eth_hdr + 1);
+			ips_v4[nb_v4] = rte_be_to_cpu_32(ip4_hdr->dst_addr);
+			pkts_v4[nb_v4++] = mb;
+		} else if (eth_hdr->ether_type ==
+			   rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV6)) {
+			ip6_hdr = (struct rte_ipv6_hdr *)(eth_hdr + 1);
+			memcpy(ips_v6[nb_v6], ip6_hdr->dst_addr,
+			       RTE_FIB6_IPV6_ADDR_SIZE);
+			pkts_v6[nb_v6++] = mb;
+		} else {
+			pkts_drop[nb_drop++] = mb;
+		}
+	}
+
+	/* Rewrite the addresses of the routed packets, IPv4 first. */
+	if (nb_v4 != 0) {
+		rte_fib_lookup_bulk(route_fib, ips_v4, nhs, nb_v4);
+		for (i = 0; i < nb_v4; i++) {
+			if (likely(route_rewrite(fs, pkts_v4[i], nhs[i])))
+				pkts_burst[nb_fwd++] = pkts_v4[i];
+			else
+				pkts_drop[nb_drop++] = pkts_v4[i];
+		}
+	}
+	if (nb_v6 != 0) {
+		rte_fib6_lookup_bulk(route_fib6, ips_v6, nhs, nb_v6);
+		for (i = 0; i < nb_v6; i++) {
+			if (likely(route_rewrite(fs, pkts_v6[i], nhs[i])))
+				pkts_burst[nb_fwd++] = pkts_v6[i];
+			else
+				pkts_drop[nb_drop++] = pkts_v6[i];
+		}
+	}
+	if (nb_drop != 0) {
+		fs->fwd_dropped += nb_drop;
+		rte_pktmbuf_free_bulk(pkts_drop, nb_drop);
+	}
+	if (nb_fwd == 0) {
+		get_end_cycles(fs, start_tsc);
+		return;
+	}
+
+	get_tx_start_cycles();
+	nb_tx = rte_eth_tx_burst(fs->tx_port, fs->tx_queue, pkts_burst, nb_fwd);
+	get_tx_end_cycles(fs);
+	/*
+	 * Retry if necessary
+	 */
+	if (unlikely(nb_tx < nb_fwd) && fs->retry_enabled) {
+		retry = 0;
+		while (nb_tx < nb_fwd && retry++ < burst_tx_retry_num) {
+			rte_delay_us(burst_tx_delay_time);
+			nb_tx += rte_eth_tx_burst(fs->tx_port, fs->tx_queue,
+					&pkts_burst[nb_tx], nb_fwd - nb_tx);
+		}
+	}
+
+	fs->tx_packets += nb_tx;
+	inc_tx_burst_stats(fs, nb_tx);
+	if (unlikely(nb_tx < nb_fwd)) {
+		fs->fwd_dropped += (nb_fwd - nb_tx);
+		rte_pktmbuf_free_bulk(&pkts_burst[nb_tx], nb_fwd - nb_tx);
+	}
+
+	get_end_cycles(fs, start_tsc);
+}
+
+static void
+route_fwd_begin(portid_t pi __rte_unused)
+{
+	/* The FIBs are shared by the ports, and reloaded at each start. */
+	if (route_users++ == 0 && route_create() != 0)
+		rte_exit(EXIT_FAILURE, "Cannot load the routes\n");
+}
+
+static void
+route_fwd_end(portid_t pi __rte_unused)
+{
+	if (route_users != 0 && --route_users == 0)
+		route_free();
+}
+
+struct fwd_engine route_fwd_engine = {
+	.fwd_mode_name  = "route",
+	.port_fwd_begin = route_fwd_begin,
+	.port_fwd_end   = route_fwd_end,
+	.packet_fwd     = pkt_burst_route_forward,
+};
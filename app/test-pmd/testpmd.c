@@ -46,6 +46,7 @@
 #include <rte_ethdev.h>
 #include <rte_dev.h>
 #include <rte_string_fns.h>
+#include <rte_telemetry.h>
 #ifdef RTE_NET_IXGBE
 #include <rte_pmd_ixgbe.h>
 #endif
@@ -180,6 +181,10 @@ struct fwd_engine * fwd_engines[] = {
 	&icmp_echo_engine,
 	&noisy_vnf_engine,
 	&five_tuple_swap_fwd_engine,
+	&latency_engine,
+#ifdef RTE_LIB_FIB
+	&route_fwd_engine,
+#endif
 #ifdef RTE_LIBRTE_IEEE1588
 	&ieee1588_fwd_engine,
 #endif
@@ -329,6 +334,18 @@ uint64_t noisy_lkup_num_reads;
  */
 uint64_t noisy_lkup_num_reads_writes;
 
+/*
+ * Configurable interval in us between two probes of the latency engine,
+ * 0 to send bursts back to back.
+ */
+uint64_t latency_interval;
+
+/*
+ * Configurable file of the routes of the route forwarding engine,
+ * empty to route all packets to the stream Tx port.
+ */
+char route_file[PATH_MAX];
+
 /*
  * Receive Side Scaling (RSS) configuration.
  */
@@ -487,6 +504,8 @@ uint8_t xstats_hide_zero;
  */
 uint8_t record_core_cycles;
 
+RTE_DEFINE_PER_LCORE(uint64_t, fwd_cycles_mark);
+
 /*
  * Display of RX and TX bursts disabled by default
  */
@@ -1772,6 +1791,86 @@ pkt_burst_stats_display(const char *rx_tx, struct pkt_burst_stats *pbs)
 	}
 }
 
+/* Breakdown of the forwarding cycles, see struct fwd_stream. */
+struct fwd_cycles {
+	uint64_t rx;
+	uint64_t processing;
+	uint64_t tx;
+	uint64_t retry;
+	uint64_t idle;
+};
+
+static void
+fwd_cycles_add(struct fwd_cycles *cyc, const struct fwd_stream *fs)
+{
+	uint64_t bursts = fs->rx_cycles + fs->tx_cycles + fs->retry_cycles;
+
+	cyc->rx += fs->rx_cycles;
+	cyc->tx += fs->tx_cycles;
+	cyc->retry += fs->retry_cycles;
+	cyc->idle += fs->idle_cycles;
+	/* The recording may have been enabled in the middle of a burst. */
+	if (fs->core_cycles > bursts)
+		cyc->processing += fs->core_cycles - bursts;
+}
+
+static void
+fwd_cycles_display(const char *prefix, const struct fwd_cycles *cyc)
+{
+	uint64_t total = cyc->rx + cyc->processing + cyc->tx + cyc->retry +
+		cyc->idle;
+
+	if (total == 0)
+		return;
+	printf("  %sCycles: Rx: %.1f%% Processing: %.1f%% Tx: %.1f%% "
+	       "Retry: %.1f%% Idle: %.1f%% (total=%"PRIu64")\n", prefix,
+	       100.0 * cyc->rx / total, 100.0 * cyc->processing / total,
+	       100.0 * cyc->tx / total, 100.0 * cyc->retry / total,
+	       100.0 * cyc->idle / total, total);
+}
+
+static void
+fwd_lcore_cycles_get(const struct fwd_lcore *fc, struct fwd_cycles *cyc)
+{
+	streamid_t sm_id;
+
+	memset(cyc, 0, sizeof(*cyc));
+	for (sm_id = 0; sm_id < fc->stream_nb; sm_id++)
+		fwd_cycles_add(cyc, fwd_streams[fc->stream_idx + sm_id]);
+}
+
+static int
+fwd_cycles_telemetry(const char *cmd __rte_unused,
+		     const char *params __rte_unused,
+		     struct rte_tel_data *d)
+{
+	struct rte_tel_data *lcore_data;
+	struct fwd_cycles cyc;
+	char name[32];
+	lcoreid_t lc_id;
+
+	rte_tel_data_start_dict(d);
+	if (fwd_lcores == NULL || fwd_streams == NULL)
+		return 0;
+	for (lc_id = 0; lc_id < cur_fwd_config.nb_fwd_lcores; lc_id++) {
+		fwd_lcore_cycles_get(fwd_lcores[lc_id], &cyc);
+		lcore_data = rte_tel_data_alloc();
+		if (lcore_data == NULL)
+			return -ENOMEM;
+		rte_tel_data_start_dict(lcore_data);
+		rte_tel_data_add_dict_u64(lcore_data, "rx", cyc.rx);
+		rte_tel_data_add_dict_u64(lcore_data, "processing",
+					  cyc.processing);
+		rte_tel_data_add_dict_u64(lcore_data, "tx", cyc.tx);
+		rte_tel_data_add_dict_u64(lcore_data, "retry", cyc.retry);
+		rte_tel_data_add_dict_u64(lcore_data, "idle", cyc.idle);
+		snprintf(name, sizeof(name), "lcore%u",
+			 fwd_lcores_cpuids[lc_id]);
+		rte_tel_data_add_dict_container(d, name, lcore_data, 0);
+	}
+	return 0;
+}
+
 static void
 fwd_stream_stats_display(streamid_t stream_id)
 {
@@ -1807,6 +1906,14 @@ fwd_stream_stats_display(streamid_t stream_id)
 		pkt_burst_stats_display("RX", &fs->rx_burst_stats);
 		pkt_burst_stats_display("TX", &fs->tx_burst_stats);
 	}
+
+	if (record_core_cycles) {
+		struct fwd_cycles cyc;
+
+		memset(&cyc, 0, sizeof(cyc));
+		fwd_cycles_add(&cyc, fs);
+		fwd_cycles_display("", &cyc);
+	}
 }
 
 void
@@ -1951,6 +2058,15 @@ fwd_stats_display(void)
 			       fwd_cycles, cur_fwd_eng->fwd_mode_name, total_pkts,
 			       (uint64_t)(rte_get_tsc_hz() / CYC_PER_MHZ));
 		}
+		for (i = 0; i < cur_fwd_config.nb_fwd_lcores; i++) {
+			struct fwd_cycles cyc;
+			char prefix[32];
+
+			fwd_lcore_cycles_get(fwd_lcores[i], &cyc);
+			snprintf(prefix, sizeof(prefix), "Lcore %u ",
+				 fwd_lcores_cpuids[i]);
+			fwd_cycles_display(prefix, &cyc);
+		}
 	}
 }
 
@@ -1979,6 +2095,10 @@ fwd_stats_reset(void)
 		memset(&fs->rx_burst_stats, 0, sizeof(fs->rx_burst_stats));
 		memset(&fs->tx_burst_stats, 0, sizeof(fs->tx_burst_stats));
 		fs->core_cycles = 0;
+		fs->rx_cycles = 0;
+		fs->tx_cycles = 0;
+		fs->retry_cycles = 0;
+		fs->idle_cycles = 0;
 	}
 }
 
@@ -3829,6 +3949,10 @@ main(int argc, char** argv)
 
 	init_config();
 
+	rte_telemetry_register_cmd("/testpmd/cycles", fwd_cycles_telemetry,
+		"Returns the forwarding cycles breakdown per lcore, "
+		"with --record-core-cycles. Parameters: None");
+
 	if (hot_plug) {
 		ret = rte_dev_hotplug_handle_enable();
 		if (ret) {
@@ -11,6 +11,7 @@
 #include <rte_bus_pci.h>
 #include <rte_gro.h>
 #include <rte_gso.h>
+#include <rte_per_lcore.h>
 #include <cmdline.h>
 #include <sys/queue.h>
 
@@ -141,6 +142,11 @@ struct fwd_stream {
 	/**< received packets having bad outer ip checksum */
 	unsigned int gro_times;	/**< GRO operation times */
 	uint64_t     core_cycles; /**< used for RX and TX processing */
+	/* Breakdown of core_cycles, the rest is used for processing. */
+	uint64_t rx_cycles;    /**< used by Rx bursts returning packets */
+	uint64_t tx_cycles;    /**< used by first Tx bursts */
+	uint64_t retry_cycles; /**< used by Tx retries */
+	uint64_t idle_cycles;  /**< used by Rx bursts returning no packet */
 	struct pkt_burst_stats rx_burst_stats;
 	struct pkt_burst_stats tx_burst_stats;
 };
@@ -294,6 +300,10 @@ extern struct fwd_engine csum_fwd_engine;
 extern struct fwd_engine icmp_echo_engine;
 extern struct fwd_engine noisy_vnf_engine;
 extern struct fwd_engine five_tuple_swap_fwd_engine;
+extern struct fwd_engine latency_engine;
+#ifdef RTE_LIB_FIB
+extern struct fwd_engine route_fwd_engine;
+#endif
 #ifdef RTE_LIBRTE_IEEE1588
 extern struct fwd_engine ieee1588_fwd_engine;
 #endif
@@ -423,6 +433,8 @@ extern uint64_t noisy_lkup_mem_sz;
 extern uint64_t noisy_lkup_num_writes;
 extern uint64_t noisy_lkup_num_reads;
 extern uint64_t noisy_lkup_num_reads_writes;
+extern uint64_t latency_interval;
+extern char route_file[PATH_MAX];
 
 extern uint8_t dcb_config;
 
@@ -733,11 +745,43 @@ port_pci_reg_write(struct rte_port *port, uint32_t reg_off, uint32_t reg_v)
 #define port_id_pci_reg_write(pt_id, reg_off, reg_value) \
 	port_pci_reg_write(&ports[(pt_id)], (reg_off), (reg_value))
 
+/* TSC at the end of the last measured step of the forwarding. */
+RTE_DECLARE_PER_LCORE(uint64_t, fwd_cycles_mark);
+
+/* Return the cycles since the last step, and start a new one. */
+static inline uint64_t
+fwd_cycles_step(void)
+{
+	uint64_t now = rte_rdtsc();
+	uint64_t cycles = now - RTE_PER_LCORE(fwd_cycles_mark);
+
+	RTE_PER_LCORE(fwd_cycles_mark) = now;
+	return cycles;
+}
+
 static inline void
 get_start_cycles(uint64_t *start_tsc)
 {
-	if (record_core_cycles)
+	if (record_core_cycles) {
 		*start_tsc = rte_rdtsc();
+		RTE_PER_LCORE(fwd_cycles_mark) = *start_tsc;
+	}
+}
+
+/* To call just before the first Tx burst, ends the processing step. */
+static inline void
+get_tx_start_cycles(void)
+{
+	if (record_core_cycles)
+		RTE_PER_LCORE(fwd_cycles_mark) = rte_rdtsc();
+}
+
+/* To call just after the first Tx burst, before the retries. */
+static inline void
+get_tx_end_cycles(struct fwd_stream *fs)
+{
+	if (record_core_cycles)
+		fs->tx_cycles += fwd_cycles_step();
 }
 
 static inline void
@@ -752,6 +796,12 @@ inc_rx_burst_stats(struct fwd_stream *fs, uint16_t nb_rx)
 {
 	if (record_burst_stats)
 		fs->rx_burst_stats.pkt_burst_spread[nb_rx]++;
+	if (record_core_cycles) {
+		if (nb_rx == 0)
+			fs->idle_cycles += fwd_cycles_step();
+		else
+			fs->rx_cycles += fwd_cycles_step();
+	}
 }
 
 static inline void
@@ -759,6 +809,8 @@ inc_tx_burst_stats(struct fwd_stream *fs, uint16_t nb_tx)
 {
 	if (record_burst_stats)
 		fs->tx_burst_stats.pkt_burst_spread[nb_tx]++;
+	if (record_core_cycles)
+		fs->retry_cycles += fwd_cycles_step();
 }
 
 /* Prototypes */
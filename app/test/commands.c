@@ -41,6 +41,7 @@
 #include <cmdline.h>
 #include <rte_string_fns.h>
 
+#include "perf_harness.h"
 #include "test.h"
 
 /****************/
@@ -67,8 +68,11 @@ static void cmd_autotest_parsed(void *parsed_result,
 	int ret = 0;
 
 	TAILQ_FOREACH(t, &commands_list, next) {
-		if (!strcmp(res->autotest, t->command))
+		if (!strcmp(res->autotest, t->command)) {
+			perf_test_begin(t->command);
 			ret = t->callback();
+			perf_test_end();
+		}
 	}
 
 	last_test_result = ret;
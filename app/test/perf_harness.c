@@ -0,0 +1,365 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include <rte_common.h>
+#include <rte_cycles.h>
+#include <rte_launch.h>
+#include <rte_lcore.h>
+#include <rte_pause.h>
+
+#include "perf_harness.h"
+
+#define PERF_DEFAULT_WARMUP 1
+#define PERF_DEFAULT_REPEAT 10
+
+enum perf_format {
+	PERF_FORMAT_NONE,
+	PERF_FORMAT_JSON,
+	PERF_FORMAT_CSV,
+};
+
+struct perf_result {
+	const char *metric;
+	const char *unit;
+	unsigned int nb_lcores;
+	unsigned int nb_samples;
+	double min;
+	double mean;
+	double p50;
+	double p90;
+	double p99;
+	double max;
+	double ops_per_sec;
+};
+
+static struct {
+	const char *test;
+	enum perf_format format;
+	FILE *out;
+	unsigned int warmup;
+	unsigned int repeat;
+} perf = {
+	.test = "unknown",
+	.warmup = PERF_DEFAULT_WARMUP,
+	.repeat = PERF_DEFAULT_REPEAT,
+};
+
+static unsigned int
+perf_env_uint(const char *name, unsigned int def)
+{
+	const char *val = getenv(name);
+	char *end;
+	unsigned long n;
+
+	if (val == NULL || val[0] == '\0')
+		return def;
+	n = strtoul(val, &end, 0);
+	if (*end != '\0' || n > UINT32_MAX) {
+		printf("Invalid %s value '%s', using %u\n", name, val, def);
+		return def;
+	}
+	return n;
+}
+
+void
+perf_test_begin(const char *test)
+{
+	const char *format = getenv("DPDK_TEST_PERF_FORMAT");
+	const char *path = getenv("DPDK_TEST_PERF_OUTPUT");
+
+	perf.test = test;
+	perf.warmup = perf_env_uint("DPDK_TEST_PERF_WARMUP",
+			PERF_DEFAULT_WARMUP);
+	perf.repeat = RTE_MAX(perf_env_uint("DPDK_TEST_PERF_REPEAT",
+			PERF_DEFAULT_REPEAT), 1u);
+
+	perf.format = PERF_FORMAT_NONE;
+	if (format == NULL || format[0] == '\0')
+		return;
+	if (strcmp(format, "json") == 0) {
+		perf.format = PERF_FORMAT_JSON;
+	} else if (strcmp(format, "csv") == 0) {
+		perf.format = PERF_FORMAT_CSV;
+	} else {
+		printf("Invalid DPDK_TEST_PERF_FORMAT value '%s'\n", format);
+		return;
+	}
+
+	perf.out = stdout;
+	if (path != NULL && path[0] != '\0') {
+		perf.out = fopen(path, "a");
+		if (perf.out == NULL) {
+			printf("Cannot open %s, writing results to stdout\n",
+			       path);
+			perf.out = stdout;
+		}
+	}
+	/* The CSV header starts a new file only. */
+	if (perf.format == PERF_FORMAT_CSV &&
+	    (perf.out == stdout || ftell(perf.out) == 0))
+		fprintf(perf.out, "test,metric,lcores,samples,unit,min,mean,"
+			"p50,p90,p99,max,ops_per_sec\n");
+}
+
+void
+perf_test_end(void)
+{
+	if (perf.out != NULL && perf.out != stdout)
+		fclose(perf.out);
+	else if (perf.out != NULL)
+		fflush(perf.out);
+	perf.out = NULL;
+	perf.format = PERF_FORMAT_NONE;
+	perf.test = "unknown";
+}
+
+/* Write a string in JSON or CSV, the metric names are not trusted. */
+static void
+perf_write_string(const char *s)
+{
+	fputc('"', perf.out);
+	for (; *s != '\0'; s++) {
+		if (*s == '"')
+			fputs(perf.format == PERF_FORMAT_JSON ? "\\\"" : "\"\"",
+			      perf.out);
+		else if (*s == '\\' && perf.format == PERF_FORMAT_JSON)
+			fputs("\\\\", perf.out);
+		else if ((unsigned char)*s >= ' ')
+			fputc(*s, perf.out);
+	}
+	fputc('"', perf.out);
+}
+
+static void
+perf_report(const struct perf_result *res)
+{
+	printf("%s [%u lcore%s]: %.2f %s (min %.2f, p50 %.2f, "
+	       "p90 %.2f, p99 %.2f, max %.2f)",
+	       res->metric, res->nb_lcores, res->nb_lcores > 1 ? "s" : "",
+	       res->mean, res->unit, res->min, res->p50, res->p90, res->p99,
+	       res->max);
+	if (res->ops_per_sec > 0)
+		printf(", %.0f ops/s", res->ops_per_sec);
+	printf("\n");
+
+	switch (perf.format) {
+	case PERF_FORMAT_JSON:
+		fputs("{\"test\": ", perf.out);
+		perf_write_string(perf.test);
+		fputs(", \"metric\": ", perf.out);
+		perf_write_string(res->metric);
+		fprintf(perf.out, ", \"lcores\": %u, \"samples\": %u, "
+			"\"unit\": \"%s\", \"min\": %.3f, "
+			"\"mean\": %.3f, \"p50\": %.3f, \"p90\": %.3f, "
+			"\"p99\": %.3f, \"max\": %.3f, \"ops_per_sec\": %.0f}\n",
+			res->nb_lcores, res->nb_samples, res->unit,
+			res->min, res->mean,
+			res->p50, res->p90, res->p99, res->max,
+			res->ops_per_sec);
+		break;
+	case PERF_FORMAT_CSV:
+		perf_write_string(perf.test);
+		fputc(',', perf.out);
+		perf_write_string(res->metric);
+		fprintf(perf.out, ",%u,%u,%s,%.3f,%.3f,%.3f,%.3f,%.3f,"
+			"%.3f,%.0f\n",
+			res->nb_lcores, res->nb_samples, res->unit,
+			res->min, res->mean,
+			res->p50, res->p90, res->p99, res->max,
+			res->ops_per_sec);
+		break;
+	case PERF_FORMAT_NONE:
+		break;
+	}
+}
+
+static int
+perf_cmp_double(const void *a, const void *b)
+{
+	double x = *(const double *)a;
+	double y = *(const double *)b;
+
+	return (x > y) - (x < y);
+}
+
+/* Nearest rank percentile of sorted samples. */
+static double
+perf_percentile(const double *samples, unsigned int nb, unsigned int pct)
+{
+	unsigned int rank = (nb * pct + 99) / 100;
+
+	return samples[RTE_MAX(rank, 1u) - 1];
+}
+
+/*
+ * Compute the statistics of samples, and report. The operations per second
+ * are derived from cycles per operation samples only.
+ */
+static void
+perf_summarize(const char *metric, const char *unit, unsigned int nb_lcores,
+		double *samples, unsigned int nb)
+{
+	struct perf_result res;
+	double sum = 0;
+	unsigned int i;
+
+	qsort(samples, nb, sizeof(*samples), perf_cmp_double);
+	for (i = 0; i < nb; i++)
+		sum += samples[i];
+
+	memset(&res, 0, sizeof(res));
+	res.metric = metric;
+	res.unit = unit;
+	res.nb_lcores = nb_lcores;
+	res.nb_samples = nb;
+	res.min = samples[0];
+	res.max = samples[nb - 1];
+	res.mean = sum / nb;
+	res.p50 = perf_percentile(samples, nb, 50);
+	res.p90 = perf_percentile(samples, nb, 90);
+	res.p99 = perf_percentile(samples, nb, 99);
+	if (strcmp(unit, "cycles/op") == 0 && res.mean > 0)
+		res.ops_per_sec = nb_lcores * rte_get_tsc_hz() / res.mean;
+	perf_report(&res);
+}
+
+/* Warmup and measured runs of an operation, one sample per run. */
+static void
+perf_measure(perf_op_t op, void *arg, unsigned int n, double *samples)
+{
+	uint64_t start;
+	unsigned int i;
+
+	for (i = 0; i < perf.warmup; i++)
+		op(arg, n);
+	for (i = 0; i < perf.repeat; i++) {
+		start = rte_rdtsc_precise();
+		op(arg, n);
+		samples[i] = (double)(rte_rdtsc_precise() - start) / n;
+	}
+}
+
+int
+perf_run(const char *metric, perf_op_t op, void *arg, unsigned int n)
+{
+	double *samples;
+
+	if (n == 0)
+		return -1;
+	samples = malloc(perf.repeat * sizeof(*samples));
+	if (samples == NULL)
+		return -1;
+	perf_measure(op, arg, n, samples);
+	perf_summarize(metric, "cycles/op", 1, samples, perf.repeat);
+	free(samples);
+	return 0;
+}
+
+struct perf_lcore_args {
+	perf_op_t op;
+	void *arg;
+	unsigned int n;
+	uint32_t *barrier;
+	double *samples;
+};
+
+static int
+perf_lcore_main(void *p)
+{
+	struct perf_lcore_args *args = p;
+
+	/* Start all lcores together to measure the contention. */
+	__atomic_sub_fetch(args->barrier, 1, __ATOMIC_RELAXED);
+	while (__atomic_load_n(args->barrier, __ATOMIC_RELAXED) != 0)
+		rte_pause();
+	perf_measure(args->op, args->arg, args->n, args->samples);
+	return 0;
+}
+
+int
+perf_run_lcores(const char *metric, perf_op_t op, void *arg, unsigned int n)
+{
+	struct perf_lcore_args args[RTE_MAX_LCORE];
+	unsigned int nb_lcores, max_lcores, i;
+	unsigned int lcore_id;
+	uint32_t barrier;
+	double *samples;
+	int ret = 0;
+
+	if (n == 0)
+		return -1;
+	max_lcores = rte_lcore_count();
+	samples = malloc(max_lcores * perf.repeat * sizeof(*samples));
+	if (samples == NULL)
+		return -1;
+
+	for (nb_lcores = 1; nb_lcores <= max_lcores;
+	     nb_lcores = nb_lcores < max_lcores ?
+			RTE_MIN(nb_lcores * 2, max_lcores) : nb_lcores + 1) {
+		__atomic_store_n(&barrier, nb_lcores, __ATOMIC_RELAXED);
+		for (i = 0; i < nb_lcores; i++) {
+			args[i].op = op;
+			args[i].arg = arg;
+			args[i].n = n;
+			args[i].barrier = &barrier;
+			args[i].samples = &samples[i * perf.repeat];
+		}
+
+		i = 1;
+		RTE_LCORE_FOREACH_WORKER(lcore_id) {
+			if (i == nb_lcores)
+				break;
+			if (rte_eal_remote_launch(perf_lcore_main, &args[i],
+					lcore_id) != 0) {
+				printf("Cannot launch lcore %u\n", lcore_id);
+				ret = -1;
+				/* Release the launched lcores. */
+				__atomic_sub_fetch(&barrier, nb_lcores - i + 1,
+						__ATOMIC_RELAXED);
+				break;
+			}
+			i++;
+		}
+		if (ret == 0)
+			perf_lcore_main(&args[0]);
+		rte_eal_mp_wait_lcore();
+		if (ret != 0)
+			break;
+		perf_summarize(metric, "cycles/op", nb_lcores, samples,
+				nb_lcores * perf.repeat);
+	}
+
+	free(samples);
+	return ret;
+}
+
+void
+perf_record(const char *metric, unsigned int nb_lcores, double cycles)
+{
+	struct perf_result res;
+
+	memset(&res, 0, sizeof(res));
+	res.metric = metric;
+	res.unit = "cycles/op";
+	res.nb_lcores = RTE_MAX(nb_lcores, 1u);
+	res.nb_samples = 1;
+	res.min = res.mean = res.p50 = res.p90 = res.p99 = res.max = cycles;
+	if (cycles > 0)
+		res.ops_per_sec = res.nb_lcores * rte_get_tsc_hz() / cycles;
+	perf_report(&res);
+}
+
+void
+perf_record_latency(const char *metric, unsigned int nb_lcores,
+		double *samples, unsigned int nb)
+{
+	if (nb == 0)
+		return;
+	perf_summarize(metric, "cycles", RTE_MAX(nb_lcores, 1u), samples, nb);
+}
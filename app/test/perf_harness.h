@@ -0,0 +1,61 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#ifndef _PERF_HARNESS_H_
+#define _PERF_HARNESS_H_
+
+/*
+ * Common harness of the performance tests.
+ *
+ * An operation is measured over a number of repetitions, after some warmup
+ * runs, and the results are reported with the same statistics and units:
+ * minimum, mean, percentiles and maximum of the cycles per operation, and
+ * the operations per second. Each result is printed as text, and written
+ * in JSON lines or CSV for tracking with the environment variables:
+ *
+ * - DPDK_TEST_PERF_FORMAT: "json" or "csv", none by default
+ * - DPDK_TEST_PERF_OUTPUT: file the results are appended to, stdout if unset
+ * - DPDK_TEST_PERF_WARMUP: number of warmup runs, 1 by default
+ * - DPDK_TEST_PERF_REPEAT: number of measured runs, 10 by default
+ */
+
+#include <stdint.h>
+
+/** Operation measured by the harness, to run n times. */
+typedef void (*perf_op_t)(void *arg, unsigned int n);
+
+/* Start and end the results of a test, called by the test runner. */
+void perf_test_begin(const char *test);
+void perf_test_end(void);
+
+/*
+ * Measure the cycles per operation of op(arg, n) on the calling lcore.
+ * The metric names the result in the output.
+ * Return 0 on success, -1 on error.
+ */
+int perf_run(const char *metric, perf_op_t op, void *arg, unsigned int n);
+
+/*
+ * Measure op(arg, n) run simultaneously on 1, 2, 4... up to all lcores,
+ * the calling one included. The result of each lcore count reports the
+ * cycles per operation on each lcore, and the total operations per second.
+ * Return 0 on success, -1 on error.
+ */
+int perf_run_lcores(const char *metric, perf_op_t op, void *arg,
+		unsigned int n);
+
+/*
+ * Report a single value measured by the test itself, in cycles per
+ * operation on nb_lcores lcores.
+ */
+void perf_record(const char *metric, unsigned int nb_lcores, double cycles);
+
+/*
+ * Report the distribution of latency samples in cycles, measured on
+ * nb_lcores lcores. The samples are sorted by the call.
+ */
+void perf_record_latency(const char *metric, unsigned int nb_lcores,
+		double *samples, unsigned int nb);
+
+#endif /* _PERF_HARNESS_H_ */
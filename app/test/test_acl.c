@@ -13,6 +13,9 @@
 #include <rte_ip.h>
 #include <rte_acl.h>
 #include <rte_common.h>
+#include <rte_lcore.h>
+#include <rte_malloc.h>
+#include <rte_rcu_qsbr.h>
 
 #include "test_acl.h"
 
@@ -1716,6 +1719,279 @@ test_u32_range(void)
 	return rc;
 }
 
+/*
+ * Test rule deletion and building in the background with RCU:
+ * a catch-all rule is added at the lowest priority, then deleted,
+ * each rebuild being published while a pseudo reader is registered.
+ */
+static int
+test_del_rules_rcu(void)
+{
+	struct rte_acl_ctx *acx;
+	struct rte_rcu_qsbr *qsv;
+	struct rte_acl_ipv4vlan_rule rule;
+	struct ipv4_7tuple test_data[RTE_DIM(acl_test_data)];
+	uint32_t i, userdata;
+	size_t sz;
+	int ret;
+
+	acx = rte_acl_create(&acl_param);
+	if (acx == NULL) {
+		printf("Line %i: Error creating ACL context!\n", __LINE__);
+		return -1;
+	}
+
+	sz = rte_rcu_qsbr_get_memsize(1);
+	qsv = rte_zmalloc(NULL, sz, RTE_CACHE_LINE_SIZE);
+	if (qsv == NULL || rte_rcu_qsbr_init(qsv, 1) != 0) {
+		printf("Line %i: Error creating RCU QSBR variable!\n",
+			__LINE__);
+		ret = -1;
+		goto err;
+	}
+
+	ret = rte_acl_rcu_qsbr_add(NULL, qsv);
+	if (ret != -EINVAL) {
+		printf("Line %i: RCU add with NULL context succeeded!\n",
+			__LINE__);
+		ret = -1;
+		goto err;
+	}
+
+	ret = rte_acl_rcu_qsbr_add(acx, qsv);
+	if (ret == 0 && rte_acl_rcu_qsbr_add(acx, qsv) != -EEXIST)
+		ret = -1;
+	if (ret != 0) {
+		printf("Line %i: Error adding RCU QSBR variable!\n", __LINE__);
+		goto err;
+	}
+
+	/* reader is registered but offline, so the builds do not block */
+	rte_rcu_qsbr_thread_register(qsv, 0);
+
+	/* catch-all rule, all the unmatched packets get its userdata */
+	memcpy(&rule, &acl_rule, sizeof(rule));
+	rule.data.priority = RTE_ACL_MIN_PRIORITY;
+	rule.data.category_mask = 1 << ACL_ALLOW;
+	rule.data.userdata = 0x12345;
+	userdata = rule.data.userdata;
+
+	ret = rte_acl_ipv4vlan_add_rules(acx, &rule, 1);
+	if (ret == 0)
+		ret = test_classify_buid(acx, acl_test_rules,
+			RTE_DIM(acl_test_rules));
+	if (ret != 0) {
+		printf("Line %i: Error building ACL context!\n", __LINE__);
+		goto err;
+	}
+
+	memcpy(test_data, acl_test_data, sizeof(test_data));
+	for (i = 0; i != RTE_DIM(test_data); i++)
+		if (test_data[i].allow == 0)
+			test_data[i].allow = userdata;
+
+	ret = test_classify_run(acx, test_data, RTE_DIM(test_data));
+	if (ret != 0) {
+		printf("Line %i: Classify with catch-all rule failed!\n",
+			__LINE__);
+		goto err;
+	}
+
+	/* delete the catch-all rule, twice to check it is gone */
+	ret = rte_acl_del_rules(acx, &userdata, 1);
+	if (ret != 1 || rte_acl_del_rules(acx, &userdata, 1) != 0) {
+		printf("Line %i: Error deleting ACL rule!\n", __LINE__);
+		ret = -1;
+		goto err;
+	}
+
+	ret = rte_acl_ipv4vlan_build(acx, ipv4_7tuple_layout,
+		RTE_ACL_MAX_CATEGORIES);
+	if (ret != 0) {
+		printf("Line %i: Error building ACL context!\n", __LINE__);
+		goto err;
+	}
+
+	ret = test_classify_run(acx, acl_test_data, RTE_DIM(acl_test_data));
+	if (ret != 0)
+		printf("Line %i: Classify after rule deletion failed!\n",
+			__LINE__);
+
+	rte_rcu_qsbr_thread_unregister(qsv, 0);
+err:
+	rte_acl_free(acx);
+	rte_free(qsv);
+	return ret;
+}
+
+/*
+ * Test building the tries on worker lcores.
+ */
+static int
+test_build_parallel(void)
+{
+	struct rte_acl_ctx *acx;
+	struct rte_acl_config cfg;
+	unsigned int lcores[4];
+	unsigned int lcore_id, num;
+	int ret;
+
+	num = 0;
+	RTE_LCORE_FOREACH_WORKER(lcore_id) {
+		if (num == RTE_DIM(lcores))
+			break;
+		lcores[num++] = lcore_id;
+	}
+
+	acx = rte_acl_create(&acl_param);
+	if (acx == NULL) {
+		printf("Line %i: Error creating ACL context!\n", __LINE__);
+		return -1;
+	}
+
+	ret = rte_acl_ipv4vlan_add_rules(acx, acl_test_rules,
+		RTE_DIM(acl_test_rules));
+	if (ret != 0) {
+		printf("Line %i: Adding rules to ACL context failed!\n",
+			__LINE__);
+		goto err;
+	}
+
+	memset(&cfg, 0, sizeof(cfg));
+	acl_ipv4vlan_config(&cfg, ipv4_7tuple_layout, RTE_ACL_MAX_CATEGORIES);
+
+	/* the tries cannot be built on the calling lcore */
+	lcore_id = rte_lcore_id();
+	ret = rte_acl_build_parallel(acx, &cfg, &lcore_id, 1);
+	if (ret != -EINVAL) {
+		printf("Line %i: Parallel build on calling lcore succeeded!\n",
+			__LINE__);
+		ret = -1;
+		goto err;
+	}
+
+	if (num == 0)
+		printf("%s: no worker lcore, building sequentially\n",
+			__func__);
+
+	ret = rte_acl_build_parallel(acx, &cfg, lcores, num);
+	if (ret != 0) {
+		printf("Line %i: Parallel build failed: %d!\n", __LINE__, ret);
+		goto err;
+	}
+
+	ret = test_classify_run(acx, acl_test_data, RTE_DIM(acl_test_data));
+	if (ret != 0)
+		printf("Line %i: Classify after parallel build failed!\n",
+			__LINE__);
+err:
+	rte_acl_free(acx);
+	return ret;
+}
+
+/*
+ * Test the ACL context replicated on each NUMA socket.
+ */
+static int
+test_numa(void)
+{
+	struct rte_acl_numa *an;
+	struct rte_acl_ctx *acx;
+	struct rte_acl_config cfg;
+	struct acl_ipv4vlan_rule rv;
+	struct ipv4_7tuple test_data[RTE_DIM(acl_test_data)];
+	const uint8_t *data[RTE_DIM(acl_test_data)];
+	uint32_t results[RTE_DIM(acl_test_data) * RTE_ACL_MAX_CATEGORIES];
+	uint32_t results_exp[RTE_DIM(acl_test_data) * RTE_ACL_MAX_CATEGORIES];
+	uint32_t i, userdata;
+	int ret;
+
+	an = rte_acl_numa_create(NULL);
+	if (an != NULL) {
+		printf("Line %i: Create with NULL parameters succeeded!\n",
+			__LINE__);
+		rte_acl_numa_free(an);
+		return -1;
+	}
+
+	an = rte_acl_numa_create(&acl_param);
+	if (an == NULL) {
+		printf("Line %i: Error creating replicated ACL context!\n",
+			__LINE__);
+		return -1;
+	}
+
+	acx = rte_acl_numa_get(an, SOCKET_ID_ANY);
+	if (acx == NULL || acx != rte_acl_numa_get(an, rte_socket_id())) {
+		printf("Line %i: Local replica not found!\n", __LINE__);
+		ret = -1;
+		goto err;
+	}
+
+	for (i = 0, ret = 0; i != RTE_DIM(acl_test_rules) && ret == 0; i++) {
+		acl_ipv4vlan_convert_rule(acl_test_rules + i, &rv);
+		ret = rte_acl_numa_add_rules(an, (struct rte_acl_rule *)&rv, 1);
+	}
+	if (ret != 0) {
+		printf("Line %i: Adding rules to ACL context failed!\n",
+			__LINE__);
+		goto err;
+	}
+
+	memset(&cfg, 0, sizeof(cfg));
+	acl_ipv4vlan_config(&cfg, ipv4_7tuple_layout, RTE_ACL_MAX_CATEGORIES);
+	ret = rte_acl_numa_build(an, &cfg);
+	if (ret != 0) {
+		printf("Line %i: Error building ACL context!\n", __LINE__);
+		goto err;
+	}
+
+	memcpy(test_data, acl_test_data, sizeof(test_data));
+	ret = test_classify_run(acx, test_data, RTE_DIM(test_data));
+	if (ret != 0) {
+		printf("Line %i: Classify with local replica failed!\n",
+			__LINE__);
+		goto err;
+	}
+
+	/* classify through the replicated context gets the same results */
+	bswap_test_data(test_data, RTE_DIM(test_data), 1);
+	for (i = 0; i != RTE_DIM(test_data); i++)
+		data[i] = (uint8_t *)&test_data[i];
+
+	ret = rte_acl_classify(acx, data, results_exp, RTE_DIM(test_data),
+		RTE_ACL_MAX_CATEGORIES);
+	if (ret == 0)
+		ret = rte_acl_numa_classify(an, data, results,
+			RTE_DIM(test_data), RTE_ACL_MAX_CATEGORIES);
+	if (ret != 0 || memcmp(results, results_exp, sizeof(results)) != 0) {
+		printf("Line %i: Classify with replicated context failed!\n",
+			__LINE__);
+		ret = -1;
+		goto err;
+	}
+
+	userdata = acl_test_rules[0].data.userdata;
+	ret = rte_acl_numa_del_rules(an, &userdata, 1);
+	if (ret <= 0) {
+		printf("Line %i: Error deleting ACL rule!\n", __LINE__);
+		ret = -1;
+		goto err;
+	}
+
+	/* no rule is left to delete once the rules are reset */
+	userdata = acl_test_rules[1].data.userdata;
+	rte_acl_numa_reset_rules(an);
+	ret = rte_acl_numa_del_rules(an, &userdata, 1);
+	if (ret != 0) {
+		printf("Line %i: Rules left after reset!\n", __LINE__);
+		ret = -1;
+	}
+err:
+	rte_acl_numa_free(an);
+	return ret;
+}
+
 static int
 test_acl(void)
 {
@@ -1737,6 +2013,12 @@ test_acl(void)
 		return -1;
 	if (test_u32_range() < 0)
 		return -1;
+	if (test_del_rules_rcu() < 0)
+		return -1;
+	if (test_build_parallel() < 0)
+		return -1;
+	if (test_numa() < 0)
+		return -1;
 
 	return 0;
 }
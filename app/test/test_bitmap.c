@@ -12,6 +12,9 @@
 #include "test.h"
 
 #define MAX_BITS 1000
+#define SPARSE_BITS (1 << 22)
+#define SPARSE_STEP 100003
+#define SPARSE_NB ((SPARSE_BITS + SPARSE_STEP - 1) / SPARSE_STEP)
 
 static int
 test_bitmap_scan_operations(struct rte_bitmap *bmp)
@@ -261,11 +264,83 @@ test_bitmap_all_set(void)
 
 }
 
+static int
+test_bitmap_sparse(void)
+{
+	uint32_t bits[SPARSE_NB], pos[SPARSE_NB + 1];
+	uint64_t slabs[SPARSE_NB + 1];
+	struct rte_bitmap *bmp;
+	uint32_t bmp_size;
+	uint32_t i, n;
+	void *mem;
+
+	bmp_size = rte_bitmap_get_memory_footprint(SPARSE_BITS);
+	mem = rte_zmalloc("test_bmap", bmp_size, RTE_CACHE_LINE_SIZE);
+	if (mem == NULL) {
+		printf("Failed to allocate memory for bitmap\n");
+		return TEST_FAILED;
+	}
+
+	bmp = rte_bitmap_init(SPARSE_BITS, mem, bmp_size);
+	if (bmp == NULL) {
+		printf("Failed to init bitmap\n");
+		rte_free(mem);
+		return TEST_FAILED;
+	}
+
+	/* One bit per slab, spread over the array1 slabs. */
+	for (i = 0; i < SPARSE_NB; i++)
+		bits[i] = i * SPARSE_STEP;
+	rte_bitmap_set_bulk(bmp, bits, SPARSE_NB);
+
+	/* The bulk scan returns every slab once, in order. */
+	n = rte_bitmap_scan_bulk(bmp, pos, slabs, RTE_DIM(pos));
+	if (n != SPARSE_NB) {
+		printf("Bulk scan found %u slabs, expected %u.\n", n,
+		       SPARSE_NB);
+		goto fail;
+	}
+	for (i = 0; i < n; i++) {
+		if (pos[i] + __builtin_ctzll(slabs[i]) != bits[i]) {
+			printf("Bulk scan returned bit %u, expected %u.\n",
+			       pos[i] + __builtin_ctzll(slabs[i]), bits[i]);
+			goto fail;
+		}
+	}
+
+	/* Wrap around in the middle of a bulk scan. */
+	__rte_bitmap_scan_init(bmp);
+	n = rte_bitmap_scan_bulk(bmp, pos, slabs, SPARSE_NB - 1);
+	if (n == SPARSE_NB - 1)
+		n = rte_bitmap_scan_bulk(bmp, pos, slabs, 2);
+	if (n != 2 || pos[1] + __builtin_ctzll(slabs[1]) != bits[0]) {
+		printf("Bulk scan wrap around failed.\n");
+		goto fail;
+	}
+
+	rte_bitmap_clear_bulk(bmp, bits, SPARSE_NB);
+	if (rte_bitmap_scan(bmp, &pos[0], &slabs[0])) {
+		printf("Bulk clear left bits set.\n");
+		goto fail;
+	}
+
+	rte_bitmap_free(bmp);
+	rte_free(mem);
+	return TEST_SUCCESS;
+
+fail:
+	rte_bitmap_free(bmp);
+	rte_free(mem);
+	return TEST_FAILED;
+}
+
 static int
 test_bitmap(void)
 {
 	if (test_bitmap_all_clear() != TEST_SUCCESS)
 		return TEST_FAILED;
+	if (test_bitmap_sparse() != TEST_SUCCESS)
+		return TEST_FAILED;
 	return test_bitmap_all_set();
 }
 
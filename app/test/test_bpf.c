@@ -45,6 +45,9 @@ struct dummy_net {
 
 #define	DUMMY_MBUF_NUM	2
 
+/* number of inputs for the burst jit tests */
+#define	TEST_BURST_NUM	4
+
 /* first mbuf in the packet, should always be at offset 0 */
 struct dummy_mbuf {
 	struct rte_mbuf mb[DUMMY_MBUF_NUM];
@@ -56,6 +59,8 @@ struct dummy_mbuf {
 #define	TEST_MUL_1	21
 #define TEST_MUL_2	-100
 
+#define TEST_LOOP_LIMIT	100
+
 #define TEST_SHIFT_1	15
 #define TEST_SHIFT_2	33
 
@@ -2859,6 +2864,132 @@ static const struct ebpf_insn test_ld_mbuf3_prog[] = {
 	},
 };
 
+/* bounded loop test-cases */
+static const struct ebpf_insn test_loop1_prog[] = {
+
+	{
+		.code = (EBPF_ALU64 | EBPF_MOV | BPF_K),
+		.dst_reg = EBPF_REG_0,
+		.imm = 0,
+	},
+	{
+		.code = (EBPF_ALU64 | EBPF_MOV | BPF_K),
+		.dst_reg = EBPF_REG_2,
+		.imm = 0,
+	},
+	{
+		.code = (EBPF_ALU64 | EBPF_MOV | BPF_X),
+		.dst_reg = EBPF_REG_3,
+		.src_reg = EBPF_REG_1,
+	},
+	/* loop over in[], summing u32 of the entries with u8 <= 100 */
+	{
+		.code = (BPF_LDX | BPF_MEM | BPF_B),
+		.dst_reg = EBPF_REG_4,
+		.src_reg = EBPF_REG_3,
+		.off = offsetof(struct dummy_vect8, in[0].u8),
+	},
+	{
+		.code = (BPF_JMP | BPF_JGT | BPF_K),
+		.dst_reg = EBPF_REG_4,
+		.off = 2,
+		.imm = TEST_LOOP_LIMIT,
+	},
+	{
+		.code = (BPF_LDX | BPF_MEM | BPF_W),
+		.dst_reg = EBPF_REG_4,
+		.src_reg = EBPF_REG_3,
+		.off = offsetof(struct dummy_vect8, in[0].u32),
+	},
+	{
+		.code = (EBPF_ALU64 | BPF_ADD | BPF_X),
+		.dst_reg = EBPF_REG_0,
+		.src_reg = EBPF_REG_4,
+	},
+	{
+		.code = (EBPF_ALU64 | BPF_ADD | BPF_K),
+		.dst_reg = EBPF_REG_3,
+		.imm = sizeof(struct dummy_offset),
+	},
+	{
+		.code = (EBPF_ALU64 | BPF_ADD | BPF_K),
+		.dst_reg = EBPF_REG_2,
+		.imm = 1,
+	},
+	{
+		.code = (BPF_JMP | EBPF_JLT | BPF_K),
+		.dst_reg = EBPF_REG_2,
+		.off = -7,
+		.imm = RTE_DIM(((struct dummy_vect8 *)NULL)->in),
+	},
+	{
+		.code = (BPF_JMP | EBPF_EXIT),
+	},
+};
+
+static void
+test_loop1_prepare(void *arg)
+{
+	struct dummy_vect8 *dv;
+	uint32_t i;
+
+	dv = arg;
+
+	memset(dv, 0, sizeof(*dv));
+	for (i = 0; i != RTE_DIM(dv->in); i++) {
+		dv->in[i].u32 = rte_rand();
+		dv->in[i].u8 = rte_rand();
+	}
+}
+
+static int
+test_loop1_check(uint64_t rc, const void *arg)
+{
+	uint32_t i;
+	uint64_t v;
+	const struct dummy_vect8 *dvt;
+
+	dvt = arg;
+
+	v = 0;
+	for (i = 0; i != RTE_DIM(dvt->in); i++) {
+		if (dvt->in[i].u8 <= TEST_LOOP_LIMIT)
+			v += dvt->in[i].u32;
+	}
+
+	return cmp_res(__func__, v, rc, dvt, dvt, 0);
+}
+
+/* the number of iterations depends on the input, the loop is not bounded */
+static const struct ebpf_insn test_loop2_prog[] = {
+
+	{
+		.code = (EBPF_ALU64 | EBPF_MOV | BPF_K),
+		.dst_reg = EBPF_REG_0,
+		.imm = 0,
+	},
+	{
+		.code = (BPF_LDX | BPF_MEM | EBPF_DW),
+		.dst_reg = EBPF_REG_2,
+		.src_reg = EBPF_REG_1,
+		.off = offsetof(struct dummy_offset, u64),
+	},
+	{
+		.code = (EBPF_ALU64 | BPF_ADD | BPF_K),
+		.dst_reg = EBPF_REG_0,
+		.imm = 1,
+	},
+	{
+		.code = (BPF_JMP | EBPF_JNE | BPF_X),
+		.dst_reg = EBPF_REG_0,
+		.src_reg = EBPF_REG_2,
+		.off = -2,
+	},
+	{
+		.code = (BPF_JMP | EBPF_EXIT),
+	},
+};
+
 /* all bpf test cases */
 static const struct bpf_test tests[] = {
 	{
@@ -3167,6 +3298,20 @@ static const struct bpf_test tests[] = {
 		/* mbuf as input argument is not supported on 32 bit platform */
 		.allow_fail = (sizeof(uint64_t) != sizeof(uintptr_t)),
 	},
+	{
+		.name = "test_loop1",
+		.arg_sz = sizeof(struct dummy_vect8),
+		.prm = {
+			.ins = test_loop1_prog,
+			.nb_ins = RTE_DIM(test_loop1_prog),
+			.prog_arg = {
+				.type = RTE_BPF_ARG_PTR,
+				.size = sizeof(struct dummy_vect8),
+			},
+		},
+		.prepare = test_loop1_prepare,
+		.check_result = test_loop1_check,
+	},
 };
 
 static int
@@ -3175,8 +3320,13 @@ run_test(const struct bpf_test *tst)
 	int32_t ret, rv;
 	int64_t rc;
 	struct rte_bpf *bpf;
+	uint32_t i, n;
 	struct rte_bpf_jit jit;
+	struct rte_bpf_jit_burst jit_burst;
 	uint8_t tbuf[tst->arg_sz];
+	uint8_t bbuf[TEST_BURST_NUM][tst->arg_sz];
+	void *ctx[TEST_BURST_NUM];
+	uint64_t brc[TEST_BURST_NUM];
 
 	printf("%s(%s) start\n", __func__, tst->name);
 
@@ -3211,11 +3361,66 @@ run_test(const struct bpf_test *tst)
 		}
 	}
 
+	/* and with the burst jit, over a set of inputs */
+	rte_bpf_get_jit_burst(bpf, &jit_burst);
+	if (jit_burst.func != NULL) {
+
+		for (i = 0; i != RTE_DIM(ctx); i++) {
+			tst->prepare(bbuf[i]);
+			ctx[i] = bbuf[i];
+		}
+
+		n = jit_burst.func(ctx, brc, RTE_DIM(ctx));
+		if (n != RTE_DIM(ctx)) {
+			printf("%s@%d: burst jit(%s) processed %u inputs, "
+				"expected %zu;\n", __func__, __LINE__,
+				tst->name, n, RTE_DIM(ctx));
+			ret |= -1;
+		}
+
+		for (i = 0; i != n; i++) {
+			rv = tst->check_result(brc[i], bbuf[i]);
+			ret |= rv;
+			if (rv != 0) {
+				printf("%s@%d: check_result(%s) failed for "
+					"burst input %u, error: %d(%s);\n",
+					__func__, __LINE__, tst->name, i,
+					rv, strerror(rv));
+			}
+		}
+	}
+
 	rte_bpf_destroy(bpf);
 	return ret;
 
 }
 
+/*
+ * loops have to be bounded, the load of test_loop2_prog has to fail.
+ */
+static int
+test_loop_unbounded(void)
+{
+	struct rte_bpf *bpf;
+	const struct rte_bpf_prm prm = {
+		.ins = test_loop2_prog,
+		.nb_ins = RTE_DIM(test_loop2_prog),
+		.prog_arg = {
+			.type = RTE_BPF_ARG_PTR,
+			.size = sizeof(struct dummy_offset),
+		},
+	};
+
+	bpf = rte_bpf_load(&prm);
+	if (bpf != NULL) {
+		printf("%s@%d: unbounded loop loaded;\n", __func__, __LINE__);
+		rte_bpf_destroy(bpf);
+		return -1;
+	}
+
+	return 0;
+}
+
 static int
 test_bpf(void)
 {
@@ -3229,6 +3434,7 @@ test_bpf(void)
 			rc |= rv;
 	}
 
+	rc |= test_loop_unbounded();
 	return rc;
 }
 
@@ -0,0 +1,173 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <string.h>
+
+#include <rte_ip.h>
+#include <rte_malloc.h>
+#include <rte_mbuf.h>
+#include <rte_net_cksum.h>
+#include <rte_random.h>
+
+#include "test.h"
+
+#define CKSUM_BUF_LEN   9216
+#define CKSUM_NB_SEGS   5
+#define CKSUM_MBUF_SIZE (RTE_PKTMBUF_HEADROOM + 2048)
+
+/* Compare the checksums of all the lengths and alignments to rte_raw_cksum. */
+static int
+test_cksum_raw(const uint8_t *buf)
+{
+	uint16_t ref, res;
+	unsigned int off;
+	size_t len;
+
+	for (off = 0; off < 4; off++) {
+		for (len = 0; len <= CKSUM_BUF_LEN - off;
+				len += len < 256 ? 1 : 97) {
+			ref = rte_raw_cksum(buf + off, len);
+			res = rte_net_raw_cksum(buf + off, len);
+			if (ref != res) {
+				printf("Bad checksum %#x, expected %#x, offset %u length %zu\n",
+					res, ref, off, len);
+				return -1;
+			}
+		}
+	}
+	return 0;
+}
+
+/* Compare the checksum of a segmented packet to the contiguous one. */
+static int
+test_cksum_mbuf(struct rte_mempool *mp, const uint8_t *buf)
+{
+	static const uint16_t seg_lens[CKSUM_NB_SEGS] = { 1, 1499, 64, 7, 999 };
+	struct rte_mbuf *m = NULL, *seg;
+	uint32_t pkt_len = 0, off, len;
+	uint16_t ref, res;
+	unsigned int i;
+	int ret = -1;
+
+	for (i = 0; i < CKSUM_NB_SEGS; i++) {
+		seg = rte_pktmbuf_alloc(mp);
+		if (seg == NULL)
+			goto out;
+		memcpy(rte_pktmbuf_append(seg, seg_lens[i]), buf + pkt_len,
+			seg_lens[i]);
+		pkt_len += seg_lens[i];
+		if (m == NULL)
+			m = seg;
+		else if (rte_pktmbuf_chain(m, seg) != 0)
+			goto out;
+	}
+
+	for (off = 0; off < pkt_len; off += 13) {
+		for (len = 0; off + len <= pkt_len; len += 101) {
+			ref = rte_raw_cksum(buf + off, len);
+			if (rte_net_raw_cksum_mbuf(m, off, len, &res) != 0 ||
+					ref != res) {
+				printf("Bad mbuf checksum %#x, expected %#x, offset %u length %u\n",
+					res, ref, off, len);
+				goto out;
+			}
+		}
+	}
+	if (rte_net_raw_cksum_mbuf(m, 1, pkt_len, &res) == 0) {
+		printf("Checksum beyond the packet end\n");
+		goto out;
+	}
+	ret = 0;
+out:
+	rte_pktmbuf_free(m);
+	return ret;
+}
+
+static int
+test_cksum_update(void)
+{
+	uint8_t pkt[64], old[16];
+	uint16_t cksum, ref, old16, new16;
+	uint32_t old32, new32;
+	unsigned int i, n;
+
+	for (n = 0; n < 1000; n++) {
+		for (i = 0; i < sizeof(pkt); i++)
+			pkt[i] = rte_rand();
+		cksum = ~rte_raw_cksum(pkt, sizeof(pkt));
+
+		memcpy(&old16, &pkt[2], sizeof(old16));
+		new16 = rte_rand();
+		memcpy(&pkt[2], &new16, sizeof(new16));
+		cksum = rte_cksum_update16(cksum, old16, new16);
+
+		memcpy(&old32, &pkt[12], sizeof(old32));
+		new32 = rte_rand();
+		memcpy(&pkt[12], &new32, sizeof(new32));
+		cksum = rte_cksum_update32(cksum, old32, new32);
+
+		memcpy(old, &pkt[24], sizeof(old));
+		for (i = 24; i < 24 + sizeof(old); i++)
+			pkt[i] = rte_rand();
+		cksum = rte_cksum_update(cksum, old, &pkt[24], sizeof(old));
+
+		/* 0 and 0xffff are the same in one's complement. */
+		ref = ~rte_raw_cksum(pkt, sizeof(pkt));
+		if (cksum != ref && (cksum | ref) != 0xffff) {
+			printf("Bad updated checksum %#x, expected %#x\n",
+				cksum, ref);
+			return -1;
+		}
+	}
+	return 0;
+}
+
+static const struct {
+	enum rte_net_cksum_alg alg;
+	const char *name;
+} cksum_algs[] = {
+	{ RTE_NET_CKSUM_SCALAR, "scalar" },
+	{ RTE_NET_CKSUM_AVX2, "x86_64 AVX2" },
+	{ RTE_NET_CKSUM_AVX512, "x86_64 AVX512" },
+	{ RTE_NET_CKSUM_NEON, "arm64 NEON" },
+};
+
+static int
+test_cksum(void)
+{
+	struct rte_mempool *mp;
+	uint8_t *buf;
+	unsigned int i;
+	int ret = -1;
+
+	buf = rte_malloc(NULL, CKSUM_BUF_LEN, 0);
+	mp = rte_pktmbuf_pool_create("test_cksum_pool", CKSUM_NB_SEGS * 2, 0,
+		0, CKSUM_MBUF_SIZE, SOCKET_ID_ANY);
+	if (buf == NULL || mp == NULL) {
+		printf("Cannot allocate the test buffers\n");
+		goto out;
+	}
+	for (i = 0; i < CKSUM_BUF_LEN; i++)
+		buf[i] = rte_rand();
+
+	for (i = 0; i < RTE_DIM(cksum_algs); i++) {
+		rte_net_cksum_set_alg(cksum_algs[i].alg);
+		if (test_cksum_raw(buf) < 0 || test_cksum_mbuf(mp, buf) < 0) {
+			printf("test_cksum (%s): failed\n", cksum_algs[i].name);
+			goto out;
+		}
+	}
+
+	if (test_cksum_update() < 0) {
+		printf("test_cksum (update): failed\n");
+		goto out;
+	}
+	ret = 0;
+out:
+	rte_mempool_free(mp);
+	rte_free(buf);
+	return ret;
+}
+
+REGISTER_TEST_COMMAND(cksum_autotest, test_cksum);
@@ -0,0 +1,181 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <inttypes.h>
+
+#include <rte_cohortlock.h>
+#include <rte_cycles.h>
+#include <rte_launch.h>
+#include <rte_lcore.h>
+#include <rte_malloc.h>
+
+#include "test.h"
+
+/*
+ * Cohort lock test
+ * ================
+ * - All the lcores increment a counter under the cohort lock, which must
+ *   end up with the number of increments.
+ * - Some lcores update two words under the write side of the NUMA-aware
+ *   reader-writer lock, while the others check they are equal under the
+ *   read side.
+ * - The trylock functions fail while the locks are held.
+ */
+
+#define ITERATIONS 100000
+#define RUNTIME 1 /* s */
+
+struct data {
+	rte_cohortlock_t cl;
+	rte_cohort_rwlock_t rwl;
+	uint64_t count;
+	uint64_t a;
+	uint64_t b __rte_cache_aligned;
+	uint32_t stop;
+};
+
+static struct data *data;
+
+/* Only a compile-time test */
+static rte_cohortlock_t __rte_unused static_cl = RTE_COHORTLOCK_INITIALIZER;
+static rte_cohort_rwlock_t __rte_unused static_rwl =
+	RTE_COHORT_RWLOCK_INITIALIZER;
+
+static int
+test_cohortlock_count(__rte_unused void *arg)
+{
+	rte_cohortlock_node_t me;
+	unsigned int i;
+
+	for (i = 0; i < ITERATIONS; i++) {
+		rte_cohortlock_lock(&data->cl, &me);
+		data->count++;
+		rte_cohortlock_unlock(&data->cl, &me);
+	}
+
+	return 0;
+}
+
+static int
+test_cohort_rwlock_writer(__rte_unused void *arg)
+{
+	rte_cohortlock_node_t me;
+	uint64_t deadline;
+
+	deadline = rte_get_timer_cycles() + RUNTIME * rte_get_timer_hz();
+	while (rte_get_timer_cycles() < deadline) {
+		rte_cohort_rwlock_write_lock(&data->rwl, &me);
+		data->a++;
+		data->b++;
+		rte_cohort_rwlock_write_unlock(&data->rwl, &me);
+	}
+
+	return 0;
+}
+
+static int
+test_cohort_rwlock_reader(__rte_unused void *arg)
+{
+	uint64_t a, b;
+
+	while (__atomic_load_n(&data->stop, __ATOMIC_RELAXED) == 0) {
+		rte_cohort_rwlock_read_lock(&data->rwl);
+		a = data->a;
+		b = data->b;
+		rte_cohort_rwlock_read_unlock(&data->rwl);
+
+		if (a != b) {
+			printf("Reader observed inconsistent values %"PRIu64
+				" %"PRIu64"\n", a, b);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+static int
+test_cohortlock_try(void)
+{
+	rte_cohortlock_node_t me, other;
+
+	TEST_ASSERT(rte_cohortlock_trylock(&data->cl, &me) == 1,
+		    "Failed to take free lock");
+	TEST_ASSERT(rte_cohortlock_is_locked(&data->cl),
+		    "Lock not reported as taken");
+	TEST_ASSERT(rte_cohortlock_trylock(&data->cl, &other) == 0,
+		    "Took lock twice");
+	rte_cohortlock_unlock(&data->cl, &me);
+	TEST_ASSERT(!rte_cohortlock_is_locked(&data->cl),
+		    "Lock still reported as taken");
+
+	TEST_ASSERT(rte_cohort_rwlock_read_trylock(&data->rwl) == 1,
+		    "Failed to take free read lock");
+	TEST_ASSERT(rte_cohort_rwlock_read_trylock(&data->rwl) == 1,
+		    "Failed to share read lock");
+	TEST_ASSERT(rte_cohort_rwlock_write_trylock(&data->rwl, &me) == 0,
+		    "Took write lock with readers");
+	rte_cohort_rwlock_read_unlock(&data->rwl);
+	rte_cohort_rwlock_read_unlock(&data->rwl);
+
+	TEST_ASSERT(rte_cohort_rwlock_write_trylock(&data->rwl, &me) == 1,
+		    "Failed to take free write lock");
+	TEST_ASSERT(rte_cohort_rwlock_read_trylock(&data->rwl) == 0,
+		    "Took read lock with writer");
+	TEST_ASSERT(rte_cohort_rwlock_write_trylock(&data->rwl, &other) == 0,
+		    "Took write lock twice");
+	rte_cohort_rwlock_write_unlock(&data->rwl, &me);
+
+	return TEST_SUCCESS;
+}
+
+static int
+test_cohortlock(void)
+{
+	unsigned int lcore_id, i;
+	uint64_t expected;
+	int ret = TEST_SUCCESS;
+
+	data = rte_zmalloc(NULL, sizeof(*data), RTE_CACHE_LINE_SIZE);
+	if (data == NULL) {
+		printf("Failed to allocate memory for cohort lock data\n");
+		return TEST_FAILED;
+	}
+	rte_cohortlock_init(&data->cl);
+	rte_cohort_rwlock_init(&data->rwl);
+
+	if (test_cohortlock_try() != TEST_SUCCESS) {
+		ret = TEST_FAILED;
+		goto out;
+	}
+
+	rte_eal_mp_remote_launch(test_cohortlock_count, NULL, CALL_MAIN);
+	rte_eal_mp_wait_lcore();
+	expected = (uint64_t)ITERATIONS * rte_lcore_count();
+	if (data->count != expected) {
+		printf("Counter %"PRIu64" instead of %"PRIu64"\n",
+			data->count, expected);
+		ret = TEST_FAILED;
+		goto out;
+	}
+
+	/* Every other worker lcore is a writer, with the main one. */
+	i = 0;
+	RTE_LCORE_FOREACH_WORKER(lcore_id) {
+		rte_eal_remote_launch(i++ % 2 ? test_cohort_rwlock_writer :
+			test_cohort_rwlock_reader, NULL, lcore_id);
+	}
+	test_cohort_rwlock_writer(NULL);
+	__atomic_store_n(&data->stop, 1, __ATOMIC_RELAXED);
+	RTE_LCORE_FOREACH_WORKER(lcore_id) {
+		if (rte_eal_wait_lcore(lcore_id) < 0)
+			ret = TEST_FAILED;
+	}
+
+out:
+	rte_free(data);
+	return ret;
+}
+
+REGISTER_TEST_COMMAND(cohortlock_autotest, test_cohortlock);
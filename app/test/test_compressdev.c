@@ -2420,6 +2420,87 @@ test_compressdev_deflate_stateless_multi_level(void)
 	return ret;
 }
 
+/* Number and maximum size of the messages of the small messages test */
+#define SMALL_MSG_NUM (NUM_LARGE_MBUFS / 2)
+#define SMALL_MSG_MAX_SIZE 2048
+
+static int
+test_compressdev_deflate_stateless_small_msg(void)
+{
+	struct comp_testsuite_params *ts_params = &testsuite_params;
+	static char msgs[SMALL_MSG_NUM][SMALL_MSG_MAX_SIZE + 1];
+	const char *test_bufs[SMALL_MSG_NUM];
+	uint16_t buf_idx[SMALL_MSG_NUM];
+	unsigned int level;
+	size_t len;
+	uint16_t i;
+	int ret;
+	struct rte_comp_xform *compress_xform =
+			rte_malloc(NULL, sizeof(struct rte_comp_xform), 0);
+
+	if (compress_xform == NULL) {
+		RTE_LOG(ERR, USER1,
+			"Compress xform could not be created\n");
+		ret = TEST_FAILED;
+		goto exit;
+	}
+
+	memcpy(compress_xform, ts_params->def_comp_xform,
+			sizeof(struct rte_comp_xform));
+
+	/* Many small messages of different sizes, processed in one burst */
+	for (i = 0; i < SMALL_MSG_NUM; i++) {
+		len = RTE_MIN((size_t)(SMALL_MSG_MAX_SIZE >> (i % 4)),
+				strlen(compress_test_bufs[0]));
+		memcpy(msgs[i], compress_test_bufs[0], len);
+		msgs[i][len] = '\0';
+		test_bufs[i] = msgs[i];
+		buf_idx[i] = i;
+	}
+
+	struct interim_data_params int_data = {
+		test_bufs,
+		SMALL_MSG_NUM,
+		buf_idx,
+		&compress_xform,
+		&ts_params->def_decomp_xform,
+		1
+	};
+
+	struct test_data_params test_data = {
+		.compress_state = RTE_COMP_OP_STATELESS,
+		.decompress_state = RTE_COMP_OP_STATELESS,
+		.buff_type = LB_BOTH,
+		.zlib_dir = ZLIB_DECOMPRESS,
+		.out_of_space = 0,
+		.big_data = 0,
+		.overflow = OVERFLOW_DISABLED,
+		.ratio = RATIO_ENABLED
+	};
+
+	for (level = RTE_COMP_LEVEL_MIN; level <= RTE_COMP_LEVEL_MAX;
+			level++) {
+		compress_xform->compress.level = level;
+		/* Compress with compressdev, decompress with Zlib */
+		test_data.zlib_dir = ZLIB_DECOMPRESS;
+		ret = test_deflate_comp_decomp(&int_data, &test_data);
+		if (ret < 0)
+			goto exit;
+	}
+
+	/* Compress with Zlib, decompress with compressdev */
+	test_data.zlib_dir = ZLIB_COMPRESS;
+	ret = test_deflate_comp_decomp(&int_data, &test_data);
+	if (ret < 0)
+		goto exit;
+
+	ret = TEST_SUCCESS;
+
+exit:
+	rte_free(compress_xform);
+	return ret;
+}
+
 #define NUM_XFORMS 3
 static int
 test_compressdev_deflate_stateless_multi_xform(void)
@@ -4196,6 +4277,8 @@ static struct unit_test_suite compressdev_testsuite  = {
 			test_compressdev_deflate_stateless_multi_op),
 		TEST_CASE_ST(generic_ut_setup, generic_ut_teardown,
 			test_compressdev_deflate_stateless_multi_level),
+		TEST_CASE_ST(generic_ut_setup, generic_ut_teardown,
+			test_compressdev_deflate_stateless_small_msg),
 		TEST_CASE_ST(generic_ut_setup, generic_ut_teardown,
 			test_compressdev_deflate_stateless_multi_xform),
 		TEST_CASE_ST(generic_ut_setup, generic_ut_teardown,
@@ -10487,6 +10487,62 @@ test_stats(void)
 	return TEST_SUCCESS;
 }
 
+static int
+test_op_tmpl(void)
+{
+	struct crypto_testsuite_params *ts_params = &testsuite_params;
+	struct crypto_unittest_params *ut_params = &unittest_params;
+	static const uint8_t iv[] = {
+		0xde, 0xad, 0xbe, 0xef, 0x00, 0x00, 0x00, 0x01
+	};
+	struct rte_cryptodev_sym_session *sess;
+	struct rte_crypto_op *ops[4];
+	struct rte_crypto_op_tmpl tmpl;
+	uint32_t i;
+
+	/* only the address of the session is used */
+	sess = (struct rte_cryptodev_sym_session *)&tmpl;
+
+	rte_crypto_op_tmpl_init(&tmpl, sess);
+	tmpl.sym.cipher.data.offset = 16;
+	tmpl.sym.cipher.data.length = 64;
+	tmpl.iv_offset = IV_OFFSET;
+	tmpl.iv_len = sizeof(iv);
+	memcpy(tmpl.iv, iv, sizeof(iv));
+
+	ut_params->ibuf = rte_pktmbuf_alloc(ts_params->mbuf_pool);
+	TEST_ASSERT_NOT_NULL(ut_params->ibuf, "Failed to allocate mbuf");
+
+	TEST_ASSERT_EQUAL(rte_crypto_op_bulk_alloc_tmpl(ts_params->op_mpool,
+			&tmpl, ops, RTE_DIM(ops)), RTE_DIM(ops),
+			"Failed to allocate crypto ops from a template");
+
+	for (i = 0; i != RTE_DIM(ops); i++) {
+		struct rte_crypto_op *op = ops[i];
+
+		rte_crypto_op_tmpl_apply(op, &tmpl, ut_params->ibuf);
+
+		TEST_ASSERT(op->type == RTE_CRYPTO_OP_TYPE_SYMMETRIC &&
+			op->status == RTE_CRYPTO_OP_STATUS_NOT_PROCESSED &&
+			op->sess_type == RTE_CRYPTO_OP_WITH_SESSION,
+			"Wrong op header");
+		TEST_ASSERT(op->mempool == ts_params->op_mpool,
+			"Op mempool overwritten");
+		TEST_ASSERT(op->sym->session == sess &&
+			op->sym->m_src == ut_params->ibuf &&
+			op->sym->m_dst == NULL &&
+			op->sym->cipher.data.offset == 16 &&
+			op->sym->cipher.data.length == 64,
+			"Wrong sym op");
+		TEST_ASSERT_BUFFERS_ARE_EQUAL(rte_crypto_op_ctod_offset(op,
+			uint8_t *, IV_OFFSET), iv, sizeof(iv), "Wrong IV");
+
+		rte_crypto_op_free(op);
+	}
+
+	return TEST_SUCCESS;
+}
+
 static int MD5_HMAC_create_session(struct crypto_testsuite_params *ts_params,
 				   struct crypto_unittest_params *ut_params,
 				   enum rte_crypto_auth_operation op,
@@ -13647,6 +13703,15 @@ test_scheduler_mode_pkt_size_distr_op(void)
 	return 0;
 }
 
+static int
+test_scheduler_mode_least_loaded_op(void)
+{
+	TEST_ASSERT(test_scheduler_mode_op(CDEV_SCHED_MODE_LEAST_LOADED) ==
+			0, "Failed to set least-loaded mode");
+
+	return 0;
+}
+
 static int
 scheduler_multicore_testsuite_setup(void)
 {
@@ -13687,6 +13752,16 @@ scheduler_pkt_size_distr_testsuite_setup(void)
 	return 0;
 }
 
+static int
+scheduler_least_loaded_testsuite_setup(void)
+{
+	if (test_scheduler_attach_slave_op() < 0)
+		return TEST_SKIPPED;
+	if (test_scheduler_mode_op(CDEV_SCHED_MODE_LEAST_LOADED) < 0)
+		return TEST_SKIPPED;
+	return 0;
+}
+
 static void
 scheduler_mode_testsuite_teardown(void)
 {
@@ -13737,6 +13812,7 @@ static struct unit_test_suite cryptodev_gen_testsuite  = {
 		TEST_CASE_ST(ut_setup, ut_teardown, test_stats),
 		TEST_CASE_ST(ut_setup, ut_teardown, test_enq_callback_setup),
 		TEST_CASE_ST(ut_setup, ut_teardown, test_deq_callback_setup),
+		TEST_CASE_ST(ut_setup, ut_teardown, test_op_tmpl),
 		TEST_CASES_END() /**< NULL terminate unit test array */
 	}
 };
@@ -14643,11 +14719,18 @@ test_cryptodev_scheduler(void /*argv __rte_unused, int argc __rte_unused*/)
 		.teardown = scheduler_mode_testsuite_teardown,
 		.unit_test_cases = {TEST_CASES_END()}
 	};
+	static struct unit_test_suite scheduler_least_loaded = {
+		.suite_name = "Scheduler Least Loaded Unit Test Suite",
+		.setup = scheduler_least_loaded_testsuite_setup,
+		.teardown = scheduler_mode_testsuite_teardown,
+		.unit_test_cases = {TEST_CASES_END()}
+	};
 	struct unit_test_suite *sched_mode_suites[] = {
 		&scheduler_multicore,
 		&scheduler_round_robin,
 		&scheduler_failover,
-		&scheduler_pkt_size_distr
+		&scheduler_pkt_size_distr,
+		&scheduler_least_loaded
 	};
 	static struct unit_test_suite scheduler_config = {
 		.suite_name = "Crypto Device Scheduler Config Unit Test Suite",
@@ -14657,6 +14740,7 @@ test_cryptodev_scheduler(void /*argv __rte_unused, int argc __rte_unused*/)
 			TEST_CASE(test_scheduler_mode_roundrobin_op),
 			TEST_CASE(test_scheduler_mode_failover_op),
 			TEST_CASE(test_scheduler_mode_pkt_size_distr_op),
+			TEST_CASE(test_scheduler_mode_least_loaded_op),
 			TEST_CASE(test_scheduler_detach_slave_op),
 
 			TEST_CASES_END() /**< NULL terminate array */
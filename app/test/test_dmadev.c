@@ -0,0 +1,406 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 HiSilicon Limited
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <inttypes.h>
+#include <string.h>
+
+#include <rte_bus_vdev.h>
+#include <rte_common.h>
+#include <rte_dmadev.h>
+#include <rte_malloc.h>
+#include <rte_random.h>
+
+#include "test.h"
+
+#define SKELDMA_NAME	"dma_skeleton"
+#define TEST_RINGSIZE	64
+#define TEST_BUFSIZE	1024
+
+static int16_t test_dev_id;
+static uint8_t *src_buf;
+static uint8_t *dst_buf;
+
+static int
+testsuite_setup(void)
+{
+	int ret;
+
+	ret = rte_vdev_init(SKELDMA_NAME, NULL);
+	if (ret != 0) {
+		printf("Cannot create %s vdev, skipping\n", SKELDMA_NAME);
+		return TEST_SKIPPED;
+	}
+
+	test_dev_id = rte_dma_get_dev_id_by_name(SKELDMA_NAME);
+	if (test_dev_id < 0)
+		return TEST_FAILED;
+
+	src_buf = rte_malloc("dmadev_test_src", TEST_BUFSIZE, 0);
+	dst_buf = rte_malloc("dmadev_test_dst", TEST_BUFSIZE, 0);
+	if (src_buf == NULL || dst_buf == NULL) {
+		rte_free(src_buf);
+		rte_free(dst_buf);
+		return TEST_FAILED;
+	}
+
+	return TEST_SUCCESS;
+}
+
+static void
+testsuite_teardown(void)
+{
+	rte_free(src_buf);
+	rte_free(dst_buf);
+	src_buf = NULL;
+	dst_buf = NULL;
+	rte_dma_stop(test_dev_id);
+	rte_vdev_uninit(SKELDMA_NAME);
+}
+
+static int
+setup_one_vchan(void)
+{
+	struct rte_dma_vchan_conf vchan_conf = { 0 };
+	struct rte_dma_conf dev_conf = { 0 };
+	int ret;
+
+	ret = rte_dma_stop(test_dev_id);
+	RTE_TEST_ASSERT_SUCCESS(ret, "Failed to stop, %d", ret);
+
+	dev_conf.nb_vchans = 1;
+	ret = rte_dma_configure(test_dev_id, &dev_conf);
+	RTE_TEST_ASSERT_SUCCESS(ret, "Failed to configure, %d", ret);
+
+	vchan_conf.direction = RTE_DMA_DIR_MEM_TO_MEM;
+	vchan_conf.nb_desc = TEST_RINGSIZE;
+	ret = rte_dma_vchan_setup(test_dev_id, 0, &vchan_conf);
+	RTE_TEST_ASSERT_SUCCESS(ret, "Failed to setup vchan, %d", ret);
+
+	ret = rte_dma_stats_reset(test_dev_id, 0);
+	RTE_TEST_ASSERT_SUCCESS(ret, "Failed to reset stats, %d", ret);
+
+	return rte_dma_start(test_dev_id);
+}
+
+static int
+test_dma_get_dev_id_by_name(void)
+{
+	int ret;
+
+	ret = rte_dma_get_dev_id_by_name("invalid_dmadev_name");
+	RTE_TEST_ASSERT(ret < 0, "Expected failure for invalid name");
+	ret = rte_dma_get_dev_id_by_name(SKELDMA_NAME);
+	RTE_TEST_ASSERT_EQUAL(ret, test_dev_id, "Wrong id for %s",
+			      SKELDMA_NAME);
+
+	return TEST_SUCCESS;
+}
+
+static int
+test_dma_is_valid_dev(void)
+{
+	RTE_TEST_ASSERT(rte_dma_is_valid(-1) == false, "-1 should be invalid");
+	RTE_TEST_ASSERT(rte_dma_is_valid(INT16_MAX) == false,
+			"INT16_MAX should be invalid");
+	RTE_TEST_ASSERT(rte_dma_is_valid(test_dev_id),
+			"Test device should be valid");
+	RTE_TEST_ASSERT(rte_dma_count_avail() >= 1,
+			"At least one device should be available");
+
+	return TEST_SUCCESS;
+}
+
+static int
+test_dma_info_get(void)
+{
+	struct rte_dma_info info = { 0 };
+	int ret;
+
+	ret = rte_dma_info_get(test_dev_id, NULL);
+	RTE_TEST_ASSERT(ret == -EINVAL, "Expected -EINVAL, %d", ret);
+	ret = rte_dma_info_get(test_dev_id, &info);
+	RTE_TEST_ASSERT_SUCCESS(ret, "Failed to obtain device info");
+	RTE_TEST_ASSERT(info.dev_capa & RTE_DMA_CAPA_OPS_COPY,
+			"Skeleton must support copy");
+	RTE_TEST_ASSERT(info.max_vchans >= 1, "No vchan available");
+
+	return TEST_SUCCESS;
+}
+
+static int
+test_dma_configure(void)
+{
+	struct rte_dma_conf conf = { 0 };
+	struct rte_dma_info info = { 0 };
+	int ret;
+
+	ret = rte_dma_stop(test_dev_id);
+	RTE_TEST_ASSERT_SUCCESS(ret, "Failed to stop, %d", ret);
+
+	/* Check for invalid parameters */
+	ret = rte_dma_configure(test_dev_id, NULL);
+	RTE_TEST_ASSERT(ret == -EINVAL, "Expected -EINVAL, %d", ret);
+
+	/* Check for nb_vchans == 0 */
+	ret = rte_dma_configure(test_dev_id, &conf);
+	RTE_TEST_ASSERT(ret == -EINVAL, "Expected -EINVAL, %d", ret);
+
+	/* Check for conf.nb_vchans > info.max_vchans */
+	ret = rte_dma_info_get(test_dev_id, &info);
+	RTE_TEST_ASSERT_SUCCESS(ret, "Failed to obtain device info");
+	conf.nb_vchans = info.max_vchans + 1;
+	ret = rte_dma_configure(test_dev_id, &conf);
+	RTE_TEST_ASSERT(ret == -EINVAL, "Expected -EINVAL, %d", ret);
+
+	/* Check for silent mode not supported */
+	conf.nb_vchans = info.max_vchans;
+	conf.enable_silent = true;
+	ret = rte_dma_configure(test_dev_id, &conf);
+	RTE_TEST_ASSERT(ret == -EINVAL, "Expected -EINVAL, %d", ret);
+
+	/* Configure success */
+	conf.enable_silent = false;
+	ret = rte_dma_configure(test_dev_id, &conf);
+	RTE_TEST_ASSERT_SUCCESS(ret, "Failed to configure, %d", ret);
+
+	ret = rte_dma_info_get(test_dev_id, &info);
+	RTE_TEST_ASSERT_SUCCESS(ret, "Failed to obtain device info");
+	RTE_TEST_ASSERT_EQUAL(conf.nb_vchans, info.nb_vchans,
+			      "Configure nb_vchans not match");
+
+	return TEST_SUCCESS;
+}
+
+static int
+test_dma_vchan_setup(void)
+{
+	struct rte_dma_vchan_conf vchan_conf = { 0 };
+	struct rte_dma_conf dev_conf = { 0 };
+	struct rte_dma_info dev_info = { 0 };
+	int ret;
+
+	ret = rte_dma_vchan_setup(test_dev_id, 0, NULL);
+	RTE_TEST_ASSERT(ret == -EINVAL, "Expected -EINVAL, %d", ret);
+
+	dev_conf.nb_vchans = 1;
+	ret = rte_dma_configure(test_dev_id, &dev_conf);
+	RTE_TEST_ASSERT_SUCCESS(ret, "Failed to configure, %d", ret);
+	ret = rte_dma_info_get(test_dev_id, &dev_info);
+	RTE_TEST_ASSERT_SUCCESS(ret, "Failed to obtain device info");
+
+	/* Check for invalid vchan */
+	ret = rte_dma_vchan_setup(test_dev_id, dev_conf.nb_vchans, &vchan_conf);
+	RTE_TEST_ASSERT(ret == -EINVAL, "Expected -EINVAL, %d", ret);
+
+	/* Check for unsupported direction */
+	vchan_conf.direction = RTE_DMA_DIR_DEV_TO_DEV;
+	vchan_conf.nb_desc = dev_info.min_desc;
+	ret = rte_dma_vchan_setup(test_dev_id, 0, &vchan_conf);
+	RTE_TEST_ASSERT(ret == -EINVAL, "Expected -EINVAL, %d", ret);
+
+	/* Check for out of range nb_desc */
+	vchan_conf.direction = RTE_DMA_DIR_MEM_TO_MEM;
+	vchan_conf.nb_desc = dev_info.min_desc - 1;
+	ret = rte_dma_vchan_setup(test_dev_id, 0, &vchan_conf);
+	RTE_TEST_ASSERT(ret == -EINVAL, "Expected -EINVAL, %d", ret);
+	vchan_conf.nb_desc = dev_info.max_desc + 1;
+	ret = rte_dma_vchan_setup(test_dev_id, 0, &vchan_conf);
+	RTE_TEST_ASSERT(ret == -EINVAL, "Expected -EINVAL, %d", ret);
+
+	/* Check for port type on mem2mem */
+	vchan_conf.nb_desc = dev_info.min_desc;
+	vchan_conf.src_port.port_type = RTE_DMA_PORT_PCIE;
+	ret = rte_dma_vchan_setup(test_dev_id, 0, &vchan_conf);
+	RTE_TEST_ASSERT(ret == -EINVAL, "Expected -EINVAL, %d", ret);
+	vchan_conf.src_port.port_type = RTE_DMA_PORT_NONE;
+
+	/* Check vchan setup success */
+	ret = rte_dma_vchan_setup(test_dev_id, 0, &vchan_conf);
+	RTE_TEST_ASSERT_SUCCESS(ret, "Failed to setup vchan, %d", ret);
+
+	return TEST_SUCCESS;
+}
+
+static int
+test_dma_start_stop(void)
+{
+	struct rte_dma_vchan_conf vchan_conf = { 0 };
+	struct rte_dma_conf dev_conf = { 0 };
+	int ret;
+
+	ret = setup_one_vchan();
+	RTE_TEST_ASSERT_SUCCESS(ret, "Failed to start, %d", ret);
+
+	/* Check reconfigure and vchan setup when device started */
+	dev_conf.nb_vchans = 1;
+	ret = rte_dma_configure(test_dev_id, &dev_conf);
+	RTE_TEST_ASSERT(ret == -EBUSY, "Expected -EBUSY, %d", ret);
+	vchan_conf.direction = RTE_DMA_DIR_MEM_TO_MEM;
+	vchan_conf.nb_desc = TEST_RINGSIZE;
+	ret = rte_dma_vchan_setup(test_dev_id, 0, &vchan_conf);
+	RTE_TEST_ASSERT(ret == -EBUSY, "Expected -EBUSY, %d", ret);
+
+	/* Close must fail while running */
+	ret = rte_dma_close(test_dev_id);
+	RTE_TEST_ASSERT(ret == -EBUSY, "Expected -EBUSY, %d", ret);
+
+	ret = rte_dma_stop(test_dev_id);
+	RTE_TEST_ASSERT_SUCCESS(ret, "Failed to stop, %d", ret);
+
+	return TEST_SUCCESS;
+}
+
+static int
+test_dma_copy(void)
+{
+	struct rte_dma_stats stats = { 0 };
+	uint16_t last_idx = 0;
+	bool has_error = true;
+	uint16_t cpl;
+	uint32_t i;
+	int ret;
+
+	ret = setup_one_vchan();
+	RTE_TEST_ASSERT_SUCCESS(ret, "Failed to setup one vchan, %d", ret);
+
+	for (i = 0; i < TEST_BUFSIZE; i++)
+		src_buf[i] = (uint8_t)rte_rand();
+	memset(dst_buf, 0, TEST_BUFSIZE);
+
+	/* Ring index starts from zero and increments per job */
+	ret = rte_dma_copy(test_dev_id, 0, (rte_iova_t)(uintptr_t)src_buf,
+			   (rte_iova_t)(uintptr_t)dst_buf, TEST_BUFSIZE / 2, 0);
+	RTE_TEST_ASSERT_EQUAL(ret, 0, "Failed to enqueue copy, %d", ret);
+	ret = rte_dma_copy(test_dev_id, 0,
+			   (rte_iova_t)(uintptr_t)(src_buf + TEST_BUFSIZE / 2),
+			   (rte_iova_t)(uintptr_t)(dst_buf + TEST_BUFSIZE / 2),
+			   TEST_BUFSIZE / 2, 0);
+	RTE_TEST_ASSERT_EQUAL(ret, 1, "Failed to enqueue copy, %d", ret);
+
+	/* Nothing completes before the doorbell */
+	cpl = rte_dma_completed(test_dev_id, 0, 32, NULL, NULL);
+	RTE_TEST_ASSERT_EQUAL(cpl, 0, "Unexpected completions %u", cpl);
+	RTE_TEST_ASSERT_EQUAL(rte_dma_burst_capacity(test_dev_id, 0),
+			      TEST_RINGSIZE - 2, "Wrong burst capacity");
+
+	ret = rte_dma_submit(test_dev_id, 0);
+	RTE_TEST_ASSERT_SUCCESS(ret, "Failed to submit, %d", ret);
+
+	cpl = rte_dma_completed(test_dev_id, 0, 32, &last_idx, &has_error);
+	RTE_TEST_ASSERT_EQUAL(cpl, 2, "Unexpected completions %u", cpl);
+	RTE_TEST_ASSERT_EQUAL(last_idx, 1, "Wrong last index %u", last_idx);
+	RTE_TEST_ASSERT(has_error == false, "Unexpected error reported");
+	RTE_TEST_ASSERT_SUCCESS(memcmp(src_buf, dst_buf, TEST_BUFSIZE),
+				"Copied data mismatch");
+
+	ret = rte_dma_stats_get(test_dev_id, 0, &stats);
+	RTE_TEST_ASSERT_SUCCESS(ret, "Failed to get stats, %d", ret);
+	RTE_TEST_ASSERT_EQUAL(stats.submitted, 2, "Wrong submitted count");
+	RTE_TEST_ASSERT_EQUAL(stats.completed, 2, "Wrong completed count");
+	RTE_TEST_ASSERT_EQUAL(stats.errors, 0, "Wrong error count");
+
+	ret = rte_dma_stop(test_dev_id);
+	RTE_TEST_ASSERT_SUCCESS(ret, "Failed to stop, %d", ret);
+
+	return TEST_SUCCESS;
+}
+
+static int
+test_dma_fill_and_wrap(void)
+{
+	enum rte_dma_status_code status[TEST_RINGSIZE];
+	const uint64_t pattern = 0xfedcba9876543210ULL;
+	uint16_t last_idx;
+	uint16_t cpl;
+	uint32_t i, j;
+	int ret;
+
+	ret = setup_one_vchan();
+	RTE_TEST_ASSERT_SUCCESS(ret, "Failed to setup one vchan, %d", ret);
+
+	/* Fill the ring a number of times to exercise index wrapping */
+	for (i = 0; i < 4 * TEST_RINGSIZE; i++) {
+		memset(dst_buf, 0, TEST_BUFSIZE);
+		ret = rte_dma_fill(test_dev_id, 0, pattern,
+				   (rte_iova_t)(uintptr_t)dst_buf,
+				   TEST_BUFSIZE - 3, RTE_DMA_OP_FLAG_SUBMIT);
+		RTE_TEST_ASSERT_EQUAL(ret, (int)i,
+				      "Failed to enqueue fill, %d", ret);
+		cpl = rte_dma_completed_status(test_dev_id, 0,
+					       RTE_DIM(status), &last_idx,
+					       status);
+		RTE_TEST_ASSERT_EQUAL(cpl, 1, "Unexpected completions %u", cpl);
+		RTE_TEST_ASSERT_EQUAL(last_idx, (uint16_t)i,
+				      "Wrong last index %u", last_idx);
+		RTE_TEST_ASSERT_EQUAL(status[0], RTE_DMA_STATUS_SUCCESSFUL,
+				      "Unexpected status %d", status[0]);
+		for (j = 0; j < TEST_BUFSIZE - 3; j++)
+			RTE_TEST_ASSERT_EQUAL(dst_buf[j],
+				((const uint8_t *)&pattern)[j % 8],
+				"Fill mismatch at offset %u", j);
+		for (; j < TEST_BUFSIZE; j++)
+			RTE_TEST_ASSERT_EQUAL(dst_buf[j], 0,
+				"Fill overrun at offset %u", j);
+	}
+
+	/* Ring full returns -ENOSPC */
+	for (i = 0; i < TEST_RINGSIZE; i++) {
+		ret = rte_dma_copy(test_dev_id, 0,
+				   (rte_iova_t)(uintptr_t)src_buf,
+				   (rte_iova_t)(uintptr_t)dst_buf, 8, 0);
+		RTE_TEST_ASSERT(ret >= 0, "Failed to enqueue copy, %d", ret);
+	}
+	ret = rte_dma_copy(test_dev_id, 0, (rte_iova_t)(uintptr_t)src_buf,
+			   (rte_iova_t)(uintptr_t)dst_buf, 8, 0);
+	RTE_TEST_ASSERT(ret == -ENOSPC, "Expected -ENOSPC, %d", ret);
+	RTE_TEST_ASSERT_SUCCESS(rte_dma_submit(test_dev_id, 0),
+				"Failed to submit");
+	cpl = rte_dma_completed(test_dev_id, 0, TEST_RINGSIZE, NULL, NULL);
+	RTE_TEST_ASSERT_EQUAL(cpl, TEST_RINGSIZE, "Unexpected completions");
+
+	ret = rte_dma_stop(test_dev_id);
+	RTE_TEST_ASSERT_SUCCESS(ret, "Failed to stop, %d", ret);
+
+	return TEST_SUCCESS;
+}
+
+static int
+test_dma_dump(void)
+{
+	int ret;
+
+	ret = rte_dma_dump(test_dev_id, NULL);
+	RTE_TEST_ASSERT(ret == -EINVAL, "Expected -EINVAL, %d", ret);
+	ret = rte_dma_dump(test_dev_id, stdout);
+	RTE_TEST_ASSERT_SUCCESS(ret, "Failed to dump, %d", ret);
+
+	return TEST_SUCCESS;
+}
+
+static struct unit_test_suite dmadev_api_testsuite = {
+	.suite_name = "DMA API test suite",
+	.setup = testsuite_setup,
+	.teardown = testsuite_teardown,
+	.unit_test_cases = {
+		TEST_CASE(test_dma_get_dev_id_by_name),
+		TEST_CASE(test_dma_is_valid_dev),
+		TEST_CASE(test_dma_info_get),
+		TEST_CASE(test_dma_configure),
+		TEST_CASE(test_dma_vchan_setup),
+		TEST_CASE(test_dma_start_stop),
+		TEST_CASE(test_dma_copy),
+		TEST_CASE(test_dma_fill_and_wrap),
+		TEST_CASE(test_dma_dump),
+		TEST_CASES_END()
+	}
+};
+
+static int
+test_dma_api(void)
+{
+	return unit_test_suite_runner(&dmadev_api_testsuite);
+}
+
+REGISTER_TEST_COMMAND(dmadev_autotest, test_dma_api);
@@ -917,6 +917,13 @@ test_misc_flags(void)
 	const char * const argv18[] = {prgname, "--file-prefix=uiodev",
 			"--create-uio-dev"};
 
+	/* With parallel probing */
+	const char * const argv19[] = {prgname, prefix, mp_flag,
+			"--probe-threads=4"};
+	/* With invalid number of probe threads */
+	const char * const argv20[] = {prgname, prefix, mp_flag,
+			"--probe-threads=0"};
+
 	/* run all tests also applicable to FreeBSD first */
 
 	if (launch_proc(argv0) == 0) {
@@ -1008,6 +1015,16 @@ test_misc_flags(void)
 				"--create-uio-dev parameter\n");
 		return -1;
 	}
+	if (launch_proc(argv19) != 0) {
+		printf("Error - process did not run ok with "
+				"--probe-threads parameter\n");
+		return -1;
+	}
+	if (launch_proc(argv20) == 0) {
+		printf("Error - process run ok with "
+				"invalid --probe-threads parameter\n");
+		return -1;
+	}
 
 	return 0;
 }
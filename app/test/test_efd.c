@@ -316,6 +316,87 @@ static int test_five_keys(void)
 	return 0;
 }
 
+#define BULK_TABLE_SIZE (1 << 16)
+#define BULK_NUM_KEYS 40000
+#define BULK_BURST 100
+
+static uint8_t bulk_keys[BULK_NUM_KEYS][EFD_TEST_KEY_LEN];
+static efd_value_t bulk_data[BULK_NUM_KEYS];
+
+/*
+ * Sequence of bulk operations:
+ *      - add keys by bursts larger than RTE_EFD_BURST_MAX
+ *      - lookup keys: hit
+ *      - add keys (update)
+ *      - lookup keys: hit (updated data)
+ *      - check the group search statistics
+ */
+static int test_bulk_update(void)
+{
+	struct rte_efd_table *handle;
+	struct rte_efd_group_stats stats;
+	const void *key_array[BULK_BURST];
+	int status[BULK_BURST];
+	uint64_t num_searches = 0;
+	unsigned int i, j, k;
+	printf("Entering %s\n", __func__);
+
+	handle = rte_efd_create("test_bulk_update", BULK_TABLE_SIZE,
+			EFD_TEST_KEY_LEN, efd_get_all_sockets_bitmask(),
+			test_socket_id);
+	TEST_ASSERT_NOT_NULL(handle, "Error creating the efd table\n");
+
+	for (i = 0; i < BULK_NUM_KEYS; i++) {
+		for (j = 0; j < EFD_TEST_KEY_LEN; j++)
+			bulk_keys[i][j] = rte_rand() & 0xFF;
+		bulk_data[i] = rte_rand() & VALUE_BITMASK;
+	}
+
+	for (k = 0; k < 2; k++) {
+		/* Add, then update with the new values on second pass */
+		for (i = 0; i < BULK_NUM_KEYS; i += BULK_BURST) {
+			for (j = 0; j < BULK_BURST; j++)
+				key_array[j] = bulk_keys[i + j];
+			TEST_ASSERT_SUCCESS(rte_efd_update_bulk(handle,
+					test_socket_id, BULK_BURST, key_array,
+					&bulk_data[i], status),
+					"Error inserting the keys");
+			for (j = 0; j < BULK_BURST; j++)
+				TEST_ASSERT(status[j] == 0 ||
+					status[j] == RTE_EFD_UPDATE_WARN_GROUP_FULL,
+					"Wrong status of bulk insert");
+		}
+
+		for (i = 0; i < BULK_NUM_KEYS; i++)
+			TEST_ASSERT_EQUAL(rte_efd_lookup(handle,
+					test_socket_id, bulk_keys[i]),
+					bulk_data[i], "failed to find key");
+
+		for (i = 0; i < BULK_NUM_KEYS; i++)
+			bulk_data[i] = (bulk_data[i] + 1) & VALUE_BITMASK;
+	}
+
+	for (i = 0; i < rte_efd_get_num_groups(handle); i++) {
+		TEST_ASSERT_SUCCESS(rte_efd_group_stats_get(handle, i, &stats),
+				"failed to get group stats");
+		num_searches += stats.num_searches;
+	}
+	TEST_ASSERT(num_searches != 0 && num_searches < 2 * BULK_NUM_KEYS,
+			"Wrong number of perfect hash searches");
+	TEST_ASSERT(rte_efd_group_stats_get(handle,
+			rte_efd_get_num_groups(handle), &stats) < 0,
+			"Stats of an invalid group should fail");
+
+	rte_efd_group_stats_reset(handle);
+	TEST_ASSERT_SUCCESS(rte_efd_group_stats_get(handle, 0, &stats),
+			"failed to get group stats");
+	TEST_ASSERT(stats.num_searches == 0, "failed to reset group stats");
+
+	rte_efd_free(handle);
+
+	return 0;
+}
+
 /*
  * Test to see the average table utilization (entries added/max entries)
  * before hitting a random entry that cannot be added
@@ -453,6 +534,8 @@ test_efd(void)
 		return -1;
 	if (test_five_keys() < 0)
 		return -1;
+	if (test_bulk_update() < 0)
+		return -1;
 	if (test_efd_creation_with_bad_parameters() < 0)
 		return -1;
 	if (test_average_table_utilization() < 0)
@@ -82,6 +82,8 @@ struct rte_event_crypto_request request_info = {
 static struct event_crypto_adapter_test_params params;
 static uint8_t crypto_adapter_setup_done;
 static uint32_t slcore_id;
+/* Set to enqueue crypto ops without going through the adapter event port */
+static bool op_direct_enqueue;
 static int evdev;
 
 static struct rte_mbuf *
@@ -111,7 +113,11 @@ send_recv_ev(struct rte_event *ev)
 	struct rte_event recv_ev;
 	int ret;
 
-	if (params.internal_port_op_fwd)
+	if (op_direct_enqueue) {
+		op = ev->event_ptr;
+		ret = rte_event_crypto_adapter_op_enqueue(TEST_ADAPTER_ID,
+							  &op, NUM);
+	} else if (params.internal_port_op_fwd)
 		ret = rte_event_crypto_adapter_enqueue(evdev, TEST_APP_PORT_ID,
 						       ev, NUM);
 	else
@@ -337,6 +343,32 @@ test_session_with_op_forward_mode(void)
 	return TEST_SUCCESS;
 }
 
+static int
+test_sessionless_with_op_direct_enqueue(void)
+{
+	uint32_t cap;
+	int ret;
+
+	ret = rte_event_crypto_adapter_caps_get(evdev, TEST_CDEV_ID, &cap);
+	TEST_ASSERT_SUCCESS(ret, "Failed to get adapter capabilities\n");
+
+	/* Only the adapters using a service support direct enqueues */
+	if ((cap & RTE_EVENT_CRYPTO_ADAPTER_CAP_INTERNAL_PORT_OP_FWD) ||
+	    (cap & RTE_EVENT_CRYPTO_ADAPTER_CAP_INTERNAL_PORT_OP_NEW))
+		return TEST_SKIPPED;
+
+	map_adapter_service_core();
+
+	TEST_ASSERT_SUCCESS(rte_event_crypto_adapter_start(TEST_ADAPTER_ID),
+				"Failed to start event crypto adapter");
+
+	op_direct_enqueue = true;
+	ret = test_op_forward_mode(1);
+	op_direct_enqueue = false;
+	TEST_ASSERT_SUCCESS(ret, "Sessionless - direct enqueue test failed\n");
+	return TEST_SUCCESS;
+}
+
 static int
 send_op_recv_ev(struct rte_crypto_op *op)
 {
@@ -730,6 +762,64 @@ test_crypto_adapter_qp_add_del(void)
 	return TEST_SUCCESS;
 }
 
+static int
+test_crypto_adapter_vector_config(void)
+{
+	struct rte_event_crypto_adapter_event_vector_config vec_conf;
+	struct rte_event_crypto_adapter_vector_limits limits;
+	uint32_t cap;
+	int ret;
+
+	ret = rte_event_crypto_adapter_caps_get(evdev, TEST_CDEV_ID, &cap);
+	TEST_ASSERT_SUCCESS(ret, "Failed to get adapter capabilities\n");
+
+	ret = rte_event_crypto_adapter_vector_limits_get(evdev, TEST_CDEV_ID,
+							 &limits);
+	if (!(cap & RTE_EVENT_CRYPTO_ADAPTER_CAP_EVENT_VECTOR)) {
+		TEST_ASSERT_EQUAL(ret, -ENOTSUP, "Got vector limits without "
+				  "event vector capability\n");
+		return TEST_SKIPPED;
+	}
+	TEST_ASSERT_SUCCESS(ret, "Failed to get vector limits\n");
+
+	ret = rte_event_crypto_adapter_queue_pair_add(TEST_ADAPTER_ID,
+				TEST_CDEV_ID, TEST_CDEV_QP_ID, NULL);
+	TEST_ASSERT_SUCCESS(ret, "Failed to add queue pair\n");
+
+	vec_conf.vector_sz = limits.max_sz;
+	vec_conf.vector_timeout_ns = limits.min_timeout_ns;
+	vec_conf.vector_mp = rte_event_vector_pool_create("crypto_vec_pool",
+			NUM_MBUFS, 0, vec_conf.vector_sz, rte_socket_id());
+	TEST_ASSERT_NOT_NULL(vec_conf.vector_mp,
+			     "Failed to create vector pool\n");
+
+	ret = rte_event_crypto_adapter_queue_pair_event_vector_config(
+			TEST_ADAPTER_ID, TEST_CDEV_ID, TEST_CDEV_QP_ID,
+			&vec_conf);
+	TEST_ASSERT_SUCCESS(ret, "Failed to configure event vector\n");
+
+	vec_conf.vector_sz = limits.min_sz - 1;
+	ret = rte_event_crypto_adapter_queue_pair_event_vector_config(
+			TEST_ADAPTER_ID, TEST_CDEV_ID, TEST_CDEV_QP_ID,
+			&vec_conf);
+	TEST_ASSERT_EQUAL(ret, -EINVAL, "Configured undersized vector\n");
+
+	vec_conf.vector_sz = limits.max_sz;
+	vec_conf.vector_timeout_ns = limits.max_timeout_ns + 1;
+	ret = rte_event_crypto_adapter_queue_pair_event_vector_config(
+			TEST_ADAPTER_ID, TEST_CDEV_ID, TEST_CDEV_QP_ID,
+			&vec_conf);
+	TEST_ASSERT_EQUAL(ret, -EINVAL, "Configured invalid vector timeout\n");
+
+	ret = rte_event_crypto_adapter_queue_pair_del(TEST_ADAPTER_ID,
+					TEST_CDEV_ID, TEST_CDEV_QP_ID);
+	TEST_ASSERT_SUCCESS(ret, "Failed to delete queue pair\n");
+
+	rte_mempool_free(vec_conf.vector_mp);
+
+	return TEST_SUCCESS;
+}
+
 static int
 configure_event_crypto_adapter(enum rte_event_crypto_adapter_mode mode)
 {
@@ -981,6 +1071,10 @@ static struct unit_test_suite functional_testsuite = {
 				test_crypto_adapter_free,
 				test_crypto_adapter_stats),
 
+		TEST_CASE_ST(test_crypto_adapter_create,
+				test_crypto_adapter_free,
+				test_crypto_adapter_vector_config),
+
 		TEST_CASE_ST(test_crypto_adapter_conf_op_forward_mode,
 				test_crypto_adapter_stop,
 				test_session_with_op_forward_mode),
@@ -989,6 +1083,10 @@ static struct unit_test_suite functional_testsuite = {
 				test_crypto_adapter_stop,
 				test_sessionless_with_op_forward_mode),
 
+		TEST_CASE_ST(test_crypto_adapter_conf_op_forward_mode,
+				test_crypto_adapter_stop,
+				test_sessionless_with_op_direct_enqueue),
+
 		TEST_CASE_ST(test_crypto_adapter_conf_op_new_mode,
 				test_crypto_adapter_stop,
 				test_session_with_op_new_mode),
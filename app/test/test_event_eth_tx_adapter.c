@@ -631,6 +631,73 @@ tx_adapter_service(void)
 	return TEST_SUCCESS;
 }
 
+static int
+tx_adapter_direct_tx(void)
+{
+	struct rte_event_eth_tx_adapter_stats stats;
+	struct rte_mbuf bufs[MAX_NUM_QUEUE * 4];
+	struct rte_event ev[RTE_DIM(bufs)];
+	struct rte_mbuf *r[RTE_DIM(bufs)];
+	uint16_t i, n, q;
+	uint32_t cap;
+	int err;
+
+	err = rte_event_eth_tx_adapter_caps_get(TEST_DEV_ID, TEST_ETHDEV_ID,
+						&cap);
+	TEST_ASSERT(err == 0, "Failed to get adapter cap err %d\n", err);
+	if (cap & RTE_EVENT_ETH_TX_ADAPTER_CAP_INTERNAL_PORT)
+		return TEST_SUCCESS;
+
+	memset(ev, 0, sizeof(ev));
+	n = rte_event_eth_tx_adapter_direct_tx(TEST_INST_ID, ev, RTE_DIM(ev));
+	TEST_ASSERT(n == 0 && rte_errno == EINVAL,
+		    "Expected EINVAL without Tx queue, got %u", n);
+
+	err = rte_event_eth_tx_adapter_queue_add(TEST_INST_ID, TEST_ETHDEV_ID,
+						-1);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	/* runs of packets to each Tx queue in turn */
+	for (i = 0; i < RTE_DIM(bufs); i++) {
+		bufs[i].port = TEST_ETHDEV_ID;
+		rte_event_eth_tx_adapter_txq_set(&bufs[i],
+						 (i / 2) % MAX_NUM_QUEUE);
+		ev[i].event_type = RTE_EVENT_TYPE_CPU;
+		ev[i].mbuf = &bufs[i];
+	}
+
+	n = rte_event_eth_tx_adapter_direct_tx(TEST_INST_ID, ev, RTE_DIM(ev));
+	TEST_ASSERT_EQUAL(n, RTE_DIM(bufs), "Expected %zu packets sent got %u",
+			  RTE_DIM(bufs), n);
+
+	for (q = 0; q < MAX_NUM_QUEUE; q++) {
+		n = rte_eth_rx_burst(TEST_ETHDEV_PAIR_ID, q, r, RTE_DIM(r));
+		TEST_ASSERT_EQUAL(n, RTE_DIM(bufs) / MAX_NUM_QUEUE,
+				  "Unexpected packet count %u on queue %u",
+				  n, q);
+		for (i = 0; i < n; i++)
+			TEST_ASSERT_EQUAL(rte_event_eth_tx_adapter_txq_get(r[i]),
+					  q, "Packet received on wrong queue");
+	}
+
+	/* direct transmits are not accounted by the service */
+	err = rte_event_eth_tx_adapter_stats_get(TEST_INST_ID, &stats);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	TEST_ASSERT_EQUAL(stats.tx_packets, 0,
+			"stats.tx_packets expected 0 got %"PRIu64,
+			stats.tx_packets);
+
+	n = rte_event_eth_tx_adapter_direct_tx(1, ev, RTE_DIM(ev));
+	TEST_ASSERT(n == 0 && rte_errno == EINVAL,
+		    "Expected EINVAL for invalid adapter, got %u", n);
+
+	err = rte_event_eth_tx_adapter_queue_del(TEST_INST_ID, TEST_ETHDEV_ID,
+						-1);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	return TEST_SUCCESS;
+}
+
 static int
 tx_adapter_dynamic_device(void)
 {
@@ -688,6 +755,8 @@ static struct unit_test_suite event_eth_tx_tests = {
 					tx_adapter_start_stop),
 		TEST_CASE_ST(tx_adapter_create, tx_adapter_free,
 					tx_adapter_service),
+		TEST_CASE_ST(tx_adapter_create, tx_adapter_free,
+					tx_adapter_direct_tx),
 		TEST_CASE_ST(NULL, NULL, tx_adapter_dynamic_device),
 		TEST_CASES_END() /**< NULL terminate unit test array */
 	}
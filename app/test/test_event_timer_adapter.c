@@ -364,6 +364,19 @@ timdev_setup_usec_multicore(void)
 		_timdev_setup(1E5, 1E3, flags);
 }
 
+static int
+timdev_setup_usec_wheel(void)
+{
+	uint64_t flags = RTE_EVENT_TIMER_ADAPTER_F_ADJUST_RES |
+			 RTE_EVENT_TIMER_ADAPTER_F_TIMER_WHEEL;
+
+	return using_services ?
+		/* Max timeout is 10,000us and bucket interval is 100us */
+		_timdev_setup(1E7, 1E5, flags) :
+		/* Max timeout is 100us and bucket interval is 1us */
+		_timdev_setup(1E5, 1E3, flags);
+}
+
 static int
 timdev_setup_msec(void)
 {
@@ -402,6 +415,16 @@ timdev_setup_sec_periodic(void)
 	return _timdev_setup(0, NSECPERSEC, flags);
 }
 
+static int
+timdev_setup_sec_wheel(void)
+{
+	uint64_t flags = RTE_EVENT_TIMER_ADAPTER_F_ADJUST_RES |
+			 RTE_EVENT_TIMER_ADAPTER_F_TIMER_WHEEL;
+
+	/* Max timeout is 100sec and bucket interval is 1sec */
+	return _timdev_setup(1E11, 1E9, flags);
+}
+
 static int
 timdev_setup_sec_multicore(void)
 {
@@ -1821,6 +1844,103 @@ adapter_tick_resolution(void)
 	return TEST_SUCCESS;
 }
 
+/* Check that expiry events with the same attributes are delivered as event
+ * vectors once the adapter is configured to aggregate them.
+ */
+static int
+event_timer_arm_vector(void)
+{
+	struct rte_event_timer_adapter_event_vector_config vec_conf = {0};
+	struct rte_event_timer_adapter_vector_limits limits;
+	struct rte_event_timer *evtims[BATCH_SIZE * 4];
+	struct rte_mempool *vec_pool;
+	uint64_t wait_start, max_wait;
+	const int nb_evtims = RTE_DIM(evtims);
+	struct rte_event ev;
+	int i, n = 0, nb_vec = 0;
+	int ret;
+
+	const struct rte_event_timer evtim = {
+		.ev.op = RTE_EVENT_OP_NEW,
+		.ev.queue_id = TEST_QUEUE_ID,
+		.ev.sched_type = RTE_SCHED_TYPE_ATOMIC,
+		.ev.priority = RTE_EVENT_DEV_PRIORITY_NORMAL,
+		.ev.event_type =  RTE_EVENT_TYPE_TIMER,
+		.state = RTE_EVENT_TIMER_NOT_ARMED,
+	};
+
+	ret = rte_event_timer_adapter_vector_limits_get(timdev, &limits);
+	if (ret == -ENOTSUP)
+		return -ENOTSUP;
+	TEST_ASSERT_SUCCESS(ret, "Failed to get vector limits");
+
+	vec_conf.vector_sz = RTE_MIN(limits.max_sz, (uint16_t)nb_evtims);
+	vec_conf.vector_timeout_ns = limits.min_timeout_ns;
+	vec_pool = rte_event_vector_pool_create("timdev_vec_pool", 16, 0,
+						vec_conf.vector_sz,
+						rte_socket_id());
+	TEST_ASSERT_NOT_NULL(vec_pool, "Failed to create vector pool");
+	vec_conf.vector_mp = vec_pool;
+
+	TEST_ASSERT_EQUAL(rte_event_timer_adapter_event_vector_config(timdev,
+			&vec_conf), -EBUSY,
+			"Configured event vectors on a started adapter");
+
+	TEST_ASSERT_SUCCESS(rte_event_timer_adapter_stop(timdev),
+			"Failed to stop adapter");
+	vec_conf.vector_sz = limits.max_sz + 1;
+	TEST_ASSERT_EQUAL(rte_event_timer_adapter_event_vector_config(timdev,
+			&vec_conf), -EINVAL,
+			"Configured event vectors with an invalid size");
+	vec_conf.vector_sz = RTE_MIN(limits.max_sz, (uint16_t)nb_evtims);
+	TEST_ASSERT_SUCCESS(rte_event_timer_adapter_event_vector_config(timdev,
+			&vec_conf), "Failed to configure event vectors");
+	TEST_ASSERT_SUCCESS(rte_event_timer_adapter_start(timdev),
+			"Failed to start adapter");
+
+	TEST_ASSERT_SUCCESS(rte_mempool_get_bulk(eventdev_test_mempool,
+			(void **)evtims, nb_evtims), "mempool alloc failed");
+	for (i = 0; i < nb_evtims; i++) {
+		*evtims[i] = evtim;
+		evtims[i]->ev.event_ptr = evtims[i];
+		evtims[i]->timeout_ticks = CALC_TICKS(5);
+	}
+
+	TEST_ASSERT_EQUAL(rte_event_timer_arm_tmo_tick_burst(timdev, evtims,
+			CALC_TICKS(5), nb_evtims), nb_evtims,
+			"Failed to arm event timers");
+
+	max_wait = rte_get_timer_hz() * 5;
+	wait_start = rte_get_timer_cycles();
+	while (n < nb_evtims &&
+	       rte_get_timer_cycles() - wait_start < max_wait) {
+		if (rte_event_dequeue_burst(evdev, TEST_PORT_ID, &ev, 1, 0)
+		    == 0)
+			continue;
+
+		TEST_ASSERT_EQUAL(ev.event_type, RTE_EVENT_TYPE_TIMER_VECTOR,
+				  "Unexpected event type %u", ev.event_type);
+		TEST_ASSERT_EQUAL(ev.queue_id, TEST_QUEUE_ID,
+				  "Unexpected queue %u", ev.queue_id);
+		for (i = 0; i < ev.vec->nb_elem; i++)
+			rte_mempool_put(eventdev_test_mempool,
+					ev.vec->ptrs[i]);
+		n += ev.vec->nb_elem;
+		nb_vec++;
+		rte_mempool_put(vec_pool, ev.vec);
+	}
+
+	TEST_ASSERT_EQUAL(n, nb_evtims, "Expected %d expired timers, got %d",
+			  nb_evtims, n);
+	TEST_ASSERT(nb_vec < nb_evtims, "Expiry events were not aggregated");
+
+	TEST_ASSERT_SUCCESS(rte_event_timer_adapter_stop(timdev),
+			"Failed to stop adapter");
+	rte_mempool_free(vec_pool);
+
+	return TEST_SUCCESS;
+}
+
 static int
 adapter_create_max(void)
 {
@@ -1910,6 +2030,14 @@ static struct unit_test_suite event_timer_adptr_functional_testsuite  = {
 				test_timer_cancel_multicore),
 		TEST_CASE_ST(timdev_setup_sec_multicore, timdev_teardown,
 				test_timer_cancel_burst_multicore),
+		TEST_CASE_ST(timdev_setup_usec_wheel, timdev_teardown,
+				test_timer_arm),
+		TEST_CASE_ST(timdev_setup_usec_wheel, timdev_teardown,
+				test_timer_arm_burst_multicore),
+		TEST_CASE_ST(timdev_setup_sec_wheel, timdev_teardown,
+				test_timer_cancel),
+		TEST_CASE_ST(timdev_setup_sec_wheel, timdev_teardown,
+				test_timer_cancel_burst_multicore),
 		TEST_CASE(adapter_create),
 		TEST_CASE_ST(timdev_setup_msec, NULL, adapter_free),
 		TEST_CASE_ST(timdev_setup_msec, timdev_teardown,
@@ -1942,6 +2070,8 @@ static struct unit_test_suite event_timer_adptr_functional_testsuite  = {
 				event_timer_cancel_double),
 		TEST_CASE_ST(timdev_setup_msec, timdev_teardown,
 				adapter_tick_resolution),
+		TEST_CASE_ST(timdev_setup_msec, timdev_teardown,
+				event_timer_arm_vector),
 		TEST_CASE(adapter_create_max),
 		TEST_CASES_END() /**< NULL terminate unit test array */
 	}
@@ -0,0 +1,125 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <rte_common.h>
+#include <rte_errno.h>
+#include <rte_ether.h>
+#include <rte_expath.h>
+#include <rte_lcore.h>
+#include <rte_mbuf.h>
+
+#include "test.h"
+
+#define NB_MBUF     512
+#define TX_BATCH    4
+#define NB_PKTS     3
+#define PKT_LEN     64
+#define EXPATH_NAME "dpdkexp0"
+
+static struct rte_mempool *pool;
+
+static int
+test_expath_alloc(struct rte_mbuf **pkts, uint16_t n)
+{
+	struct rte_ether_hdr *eth;
+	uint16_t i;
+
+	if (rte_pktmbuf_alloc_bulk(pool, pkts, n) != 0)
+		return -1;
+
+	for (i = 0; i < n; i++) {
+		eth = (struct rte_ether_hdr *)rte_pktmbuf_append(pkts[i],
+				PKT_LEN);
+		memset(eth, 0, PKT_LEN);
+		memset(&eth->d_addr, 0xff, sizeof(eth->d_addr));
+		eth->ether_type = rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4);
+	}
+
+	return 0;
+}
+
+static int
+test_expath(void)
+{
+	struct rte_mbuf *pkts[NB_PKTS];
+	struct rte_expath_conf conf;
+	struct rte_expath_stats stats;
+	struct rte_expath *ep;
+	uint16_t sent;
+	int ret = TEST_FAILED;
+
+	pool = rte_pktmbuf_pool_create("test_expath_pool", NB_MBUF, 32, 0,
+			RTE_MBUF_DEFAULT_BUF_SIZE, SOCKET_ID_ANY);
+	TEST_ASSERT_NOT_NULL(pool, "cannot create mbuf pool");
+
+	memset(&conf, 0, sizeof(conf));
+	ep = rte_expath_create(&conf, pool);
+	if (ep != NULL || rte_errno != EINVAL) {
+		printf("empty name accepted\n");
+		goto out;
+	}
+
+	strlcpy(conf.name, EXPATH_NAME, sizeof(conf.name));
+	conf.nb_queues = 2;
+	conf.tx_batch = TX_BATCH;
+	conf.socket_id = SOCKET_ID_ANY;
+	ep = rte_expath_create(&conf, pool);
+	if (ep == NULL) {
+		printf("cannot create exception path (%s), skipping test\n",
+			rte_strerror(rte_errno));
+		ret = TEST_SKIPPED;
+		goto out;
+	}
+
+	if (rte_expath_create(&conf, pool) != NULL || rte_errno != EEXIST) {
+		printf("duplicate name accepted\n");
+		goto free;
+	}
+	if (rte_expath_get(EXPATH_NAME) != ep ||
+	    strcmp(rte_expath_get_name(ep), EXPATH_NAME) != 0) {
+		printf("lookup by name failed\n");
+		goto free;
+	}
+
+	/* Buffered packets wait for a full batch or a flush */
+	if (test_expath_alloc(pkts, NB_PKTS) != 0) {
+		printf("cannot allocate packets\n");
+		goto free;
+	}
+	if (rte_expath_tx_buffer(ep, 1, pkts, NB_PKTS) != 0) {
+		printf("packets sent before the batch is full\n");
+		goto free;
+	}
+	sent = rte_expath_tx_flush(ep, 1);
+	rte_expath_stats_get(ep, &stats);
+	if (sent + stats.tx_dropped != NB_PKTS) {
+		printf("%u packets sent and %" PRIu64 " dropped out of %u\n",
+			sent, stats.tx_dropped, NB_PKTS);
+		goto free;
+	}
+	if (rte_expath_tx_flush(ep, 1) != 0) {
+		printf("packets sent twice\n");
+		goto free;
+	}
+
+	ret = TEST_SUCCESS;
+free:
+	if (rte_expath_free(ep) != 0 && ret == TEST_SUCCESS) {
+		printf("cannot free exception path\n");
+		ret = TEST_FAILED;
+	}
+	if (rte_expath_get(EXPATH_NAME) != NULL) {
+		printf("exception path found after free\n");
+		ret = TEST_FAILED;
+	}
+out:
+	rte_mempool_free(pool);
+	return ret;
+}
+
+REGISTER_TEST_COMMAND(expath_autotest, test_expath);
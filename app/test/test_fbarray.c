@@ -709,6 +709,54 @@ static int test_empty(void)
 	return TEST_SUCCESS;
 }
 
+/* a free run in the middle of a large used array, then the other way */
+static int test_large(void)
+{
+	const int len = 1 << 16, run_start = 40000, run_len = 1500;
+	const int run_end = run_start + run_len;
+	struct rte_fbarray arr;
+	int i, ret = TEST_FAILED;
+
+	TEST_ASSERT_SUCCESS(rte_fbarray_init(&arr, "fbarray_autotest_large",
+			len, FBARRAY_TEST_ELT_SZ), "Failed to init large array\n");
+
+	for (i = 0; i < len; i++)
+		if (i < run_start || i >= run_end)
+			rte_fbarray_set_used(&arr, i);
+
+	if (rte_fbarray_find_next_free(&arr, 0) != run_start ||
+			rte_fbarray_find_next_n_free(&arr, 0, run_len) !=
+				run_start ||
+			rte_fbarray_find_next_n_free(&arr, 0, run_len + 1) >= 0 ||
+			rte_fbarray_find_next_used(&arr, run_start) != run_end ||
+			rte_fbarray_find_contig_free(&arr, run_start) !=
+				run_len) {
+		printf("Wrong free run in large used array\n");
+		goto out;
+	}
+
+	for (i = 0; i < len; i++) {
+		if (i < run_start || i >= run_end)
+			rte_fbarray_set_free(&arr, i);
+		else
+			rte_fbarray_set_used(&arr, i);
+	}
+
+	if (rte_fbarray_find_next_used(&arr, 0) != run_start ||
+			rte_fbarray_find_next_n_used(&arr, 0, run_len) !=
+				run_start ||
+			rte_fbarray_find_next_n_used(&arr, 0, run_len + 1) >= 0 ||
+			rte_fbarray_find_next_n_free(&arr, run_start,
+				len - run_end) != run_end ||
+			rte_fbarray_find_next_n_free(&arr, 0, run_start) != 0) {
+		printf("Wrong used run in large free array\n");
+		goto out;
+	}
+	ret = TEST_SUCCESS;
+out:
+	rte_fbarray_destroy(&arr);
+	return ret;
+}
 
 static struct unit_test_suite fbarray_test_suite = {
 	.suite_name = "fbarray autotest",
@@ -723,6 +771,7 @@ static struct unit_test_suite fbarray_test_suite = {
 		TEST_CASE_ST(last_msk_test_setup, reset_array, test_find),
 		TEST_CASE_ST(full_msk_test_setup, reset_array, test_find),
 		TEST_CASE_ST(empty_msk_test_setup, reset_array, test_empty),
+		TEST_CASE(test_large),
 		TEST_CASES_END()
 	}
 };
@@ -6,10 +6,13 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <rte_ip.h>
+#include <rte_lcore.h>
 #include <rte_log.h>
 #include <rte_fib.h>
+#include <rte_malloc.h>
 
 #include "test.h"
 
@@ -21,9 +24,15 @@ static int32_t test_free_null(void);
 static int32_t test_add_del_invalid(void);
 static int32_t test_get_invalid(void);
 static int32_t test_lookup(void);
+static int32_t test_add_bulk(void);
+static int32_t test_rcu_qsbr_add(void);
+static int32_t test_nh_group(void);
+static int32_t test_numa(void);
 
 #define MAX_ROUTES	(1 << 16)
 #define MAX_TBL8	(1 << 15)
+/* number of tbl8s is rounded up to a multiple of 64 */
+#define MIN_TBL8	64
 
 /*
  * Check that rte_fib_create fails gracefully for incorrect user input
@@ -371,6 +380,370 @@ test_lookup(void)
 	return TEST_SUCCESS;
 }
 
+/*
+ * Add routes for one supernet with all possible depths at once,
+ * check that an invalid set of routes leaves the FIB unchanged.
+ */
+int32_t
+test_add_bulk(void)
+{
+	struct rte_fib *fib = NULL;
+	struct rte_fib_conf config;
+	uint64_t def_nh = 100;
+	uint32_t ip_arr[RTE_FIB_MAXDEPTH];
+	uint32_t ips[RTE_FIB_MAXDEPTH + 1];
+	uint8_t depths[RTE_FIB_MAXDEPTH + 1];
+	uint64_t nhs[RTE_FIB_MAXDEPTH + 1];
+	uint32_t ip_add = RTE_IPV4(128, 0, 0, 0);
+	uint32_t i, ip_missing = RTE_IPV4(127, 255, 255, 255);
+	int ret;
+
+	config.max_routes = MAX_ROUTES;
+	config.default_nh = def_nh;
+	config.type = RTE_FIB_DIR24_8;
+	config.dir24_8.nh_sz = RTE_FIB_DIR24_8_4B;
+	config.dir24_8.num_tbl8 = MAX_TBL8;
+
+	fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+
+	ret = rte_fib_add_bulk(NULL, ips, depths, nhs, 1);
+	RTE_TEST_ASSERT(ret < 0, "Call succeeded with invalid parameters\n");
+
+	for (i = 0; i < RTE_FIB_MAXDEPTH; i++) {
+		ip_arr[i] = ip_add + (1ULL << i) - 1;
+		ips[i] = ip_add;
+		depths[i] = i + 1;
+		nhs[i] = i + 1;
+	}
+
+	/* an invalid depth at the end, none of the routes is added */
+	ips[i] = ip_add;
+	depths[i] = RTE_FIB_MAXDEPTH + 1;
+	nhs[i] = 0;
+	ret = rte_fib_add_bulk(fib, ips, depths, nhs, RTE_FIB_MAXDEPTH + 1);
+	RTE_TEST_ASSERT(ret < 0, "Call succeeded with invalid parameters\n");
+	ret = lookup_and_check_desc(fib, ip_arr, ip_missing, def_nh, 0);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS, "Lookup and check fails\n");
+
+	ret = rte_fib_add_bulk(fib, ips, depths, nhs, RTE_FIB_MAXDEPTH);
+	RTE_TEST_ASSERT(ret == 0, "Failed to add routes\n");
+	ret = lookup_and_check_asc(fib, ip_arr, ip_missing, def_nh,
+		RTE_FIB_MAXDEPTH);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS, "Lookup and check fails\n");
+
+	/* the routes added in bulk are deleted one by one */
+	for (i = RTE_FIB_MAXDEPTH; i > 0; i--) {
+		ret = rte_fib_delete(fib, ip_add, i);
+		RTE_TEST_ASSERT(ret == 0, "Failed to delete a route\n");
+	}
+	ret = lookup_and_check_desc(fib, ip_arr, ip_missing, def_nh, 0);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS, "Lookup and check fails\n");
+
+	rte_fib_free(fib);
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * Check RCU QSBR configuration, and that tbl8 groups freed with
+ * the defer queue are reused.
+ */
+int32_t
+test_rcu_qsbr_add(void)
+{
+	struct rte_fib *fib = NULL;
+	struct rte_fib_conf config;
+	struct rte_fib_rcu_config rcu_cfg = {0};
+	struct rte_rcu_qsbr *qsv;
+	uint64_t def_nh = 100;
+	uint32_t ip = RTE_IPV4(10, 0, 0, 0);
+	uint32_t ip_add;
+	uint64_t nh;
+	uint32_t i;
+	size_t sz;
+	int ret;
+
+	sz = rte_rcu_qsbr_get_memsize(RTE_MAX_LCORE);
+	qsv = rte_zmalloc_socket(NULL, sz, RTE_CACHE_LINE_SIZE,
+		SOCKET_ID_ANY);
+	RTE_TEST_ASSERT(qsv != NULL, "Cannot allocate memory for QSBR\n");
+	ret = rte_rcu_qsbr_init(qsv, RTE_MAX_LCORE);
+	RTE_TEST_ASSERT(ret == 0, "QSBR init failed\n");
+
+	config.max_routes = MAX_ROUTES;
+	config.default_nh = def_nh;
+	config.type = RTE_FIB_DUMMY;
+
+	fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+	rcu_cfg.v = qsv;
+	ret = rte_fib_rcu_qsbr_add(fib, &rcu_cfg);
+	RTE_TEST_ASSERT(ret == -ENOTSUP, "RCU accepted for DUMMY type\n");
+	rte_fib_free(fib);
+
+	config.type = RTE_FIB_DIR24_8;
+	config.dir24_8.nh_sz = RTE_FIB_DIR24_8_4B;
+	config.dir24_8.num_tbl8 = 1;
+	fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+
+	ret = rte_fib_rcu_qsbr_add(fib, NULL);
+	RTE_TEST_ASSERT(ret < 0, "Call succeeded with invalid parameters\n");
+	rcu_cfg.mode = 2;
+	ret = rte_fib_rcu_qsbr_add(fib, &rcu_cfg);
+	RTE_TEST_ASSERT(ret < 0, "Call succeeded with invalid mode\n");
+
+	rcu_cfg.mode = RTE_FIB_QSBR_MODE_DQ;
+	ret = rte_fib_rcu_qsbr_add(fib, &rcu_cfg);
+	RTE_TEST_ASSERT(ret == 0, "Failed to add RCU QSBR variable\n");
+	ret = rte_fib_rcu_qsbr_add(fib, &rcu_cfg);
+	RTE_TEST_ASSERT(ret == -EEXIST, "RCU QSBR variable added twice\n");
+
+	/*
+	 * No reader is registered, so the tbl8 groups in the defer queue
+	 * are reclaimed when there is no free one left: the minimal number
+	 * of tbl8s is enough to add and delete a /32 route in turn in twice
+	 * as many different /24s.
+	 */
+	for (i = 0; i < 2 * MIN_TBL8; i++) {
+		ip_add = ip + (i << 8);
+		ret = rte_fib_add(fib, ip_add, 32, i);
+		RTE_TEST_ASSERT(ret == 0, "Failed to add a route\n");
+		ret = rte_fib_lookup_bulk(fib, &ip_add, &nh, 1);
+		RTE_TEST_ASSERT(ret == 0 && nh == i,
+			"Failed to get proper nexthop\n");
+		ret = rte_fib_delete(fib, ip_add, 32);
+		RTE_TEST_ASSERT(ret == 0, "Failed to delete a route\n");
+	}
+
+	rte_fib_free(fib);
+	rte_free(qsv);
+
+	return TEST_SUCCESS;
+}
+
+#define NH_GRP_NUM_BUCKETS	64
+
+/*
+ * Check next hop group configuration, and that the hash of each bucket
+ * selects next hops of weighted and equal cost groups in proportion.
+ */
+int32_t
+test_nh_group(void)
+{
+	struct rte_fib *fib = NULL;
+	struct rte_fib_conf config;
+	struct rte_fib_nh_group_conf grp_conf = {0};
+	uint64_t def_nh = 100;
+	uint64_t grp_nhs[] = {1, 2, 3};
+	uint32_t weights[] = {1, 2, 5};
+	uint32_t expected[RTE_DIM(grp_nhs)];
+	uint32_t count[RTE_DIM(grp_nhs)];
+	uint32_t ips[NH_GRP_NUM_BUCKETS];
+	uint32_t hashes[NH_GRP_NUM_BUCKETS];
+	uint64_t nhs[NH_GRP_NUM_BUCKETS];
+	uint32_t ip = RTE_IPV4(10, 0, 0, 0);
+	uint64_t grp_nh;
+	uint32_t i, j;
+	int ret;
+
+	config.max_routes = MAX_ROUTES;
+	config.default_nh = def_nh;
+	config.type = RTE_FIB_DUMMY;
+
+	fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+	grp_conf.num_groups = 2;
+	grp_conf.num_buckets = NH_GRP_NUM_BUCKETS;
+	ret = rte_fib_nh_group_create(fib, &grp_conf);
+	RTE_TEST_ASSERT(ret == -ENOTSUP, "Groups accepted for DUMMY type\n");
+	rte_fib_free(fib);
+
+	config.type = RTE_FIB_DIR24_8;
+	config.dir24_8.nh_sz = RTE_FIB_DIR24_8_4B;
+	config.dir24_8.num_tbl8 = MIN_TBL8;
+	fib = rte_fib_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+
+	ret = rte_fib_nh_group_create(fib, NULL);
+	RTE_TEST_ASSERT(ret < 0, "Call succeeded with invalid parameters\n");
+	grp_conf.num_buckets = NH_GRP_NUM_BUCKETS - 1;
+	ret = rte_fib_nh_group_create(fib, &grp_conf);
+	RTE_TEST_ASSERT(ret < 0, "Call succeeded with invalid parameters\n");
+	grp_conf.num_buckets = NH_GRP_NUM_BUCKETS;
+	ret = rte_fib_nh_group_set(fib, 0, grp_nhs, NULL, 1);
+	RTE_TEST_ASSERT(ret == -ENOTSUP, "Group set before creation\n");
+
+	/* a route already using a group value out of the groups */
+	grp_nh = RTE_FIB_DIR24_8_NH_GROUP(RTE_FIB_DIR24_8_4B, 2);
+	ret = rte_fib_add(fib, ip, 16, grp_nh);
+	RTE_TEST_ASSERT(ret == 0, "Failed to add a route\n");
+	ret = rte_fib_nh_group_create(fib, &grp_conf);
+	RTE_TEST_ASSERT(ret == -EINVAL, "Groups accepted with invalid route\n");
+	ret = rte_fib_delete(fib, ip, 16);
+	RTE_TEST_ASSERT(ret == 0, "Failed to delete a route\n");
+
+	ret = rte_fib_nh_group_create(fib, &grp_conf);
+	RTE_TEST_ASSERT(ret == 0, "Failed to create next hop groups\n");
+	ret = rte_fib_nh_group_create(fib, &grp_conf);
+	RTE_TEST_ASSERT(ret == -EEXIST, "Next hop groups created twice\n");
+	ret = rte_fib_add(fib, ip, 16, grp_nh);
+	RTE_TEST_ASSERT(ret < 0, "Route to an invalid group added\n");
+	ret = rte_fib_nh_group_set(fib, 2, grp_nhs, NULL, 1);
+	RTE_TEST_ASSERT(ret < 0, "Call succeeded with invalid group\n");
+	ret = rte_fib_nh_group_set(fib, 0, &grp_nh, NULL, 1);
+	RTE_TEST_ASSERT(ret < 0, "Group member set to a group\n");
+
+	grp_nh = RTE_FIB_DIR24_8_NH_GROUP(RTE_FIB_DIR24_8_4B, 1);
+	ret = rte_fib_add(fib, ip, 16, grp_nh);
+	RTE_TEST_ASSERT(ret == 0, "Failed to add a route\n");
+
+	for (i = 0; i < NH_GRP_NUM_BUCKETS; i++) {
+		ips[i] = ip + i;
+		hashes[i] = i;
+	}
+
+	/* a group not set yet leads to the default next hop */
+	ret = rte_fib_lookup_bulk_hash(fib, ips, hashes, nhs,
+		NH_GRP_NUM_BUCKETS);
+	RTE_TEST_ASSERT(ret == 0, "Failed to lookup\n");
+	for (i = 0; i < NH_GRP_NUM_BUCKETS; i++)
+		RTE_TEST_ASSERT(nhs[i] == def_nh,
+			"Failed to get proper nexthop\n");
+
+	/* the plain lookup returns the group next hop value */
+	ret = rte_fib_lookup_bulk(fib, ips, nhs, 1);
+	RTE_TEST_ASSERT(ret == 0 && nhs[0] == grp_nh,
+		"Failed to get proper nexthop\n");
+
+	/* weighted group, then equal cost group */
+	for (j = 0; j < 2; j++) {
+		ret = rte_fib_nh_group_set(fib, 1, grp_nhs,
+			(j == 0) ? weights : NULL, RTE_DIM(grp_nhs));
+		RTE_TEST_ASSERT(ret == 0, "Failed to set next hop group\n");
+		ret = rte_fib_lookup_bulk_hash(fib, ips, hashes, nhs,
+			NH_GRP_NUM_BUCKETS);
+		RTE_TEST_ASSERT(ret == 0, "Failed to lookup\n");
+
+		memset(count, 0, sizeof(count));
+		for (i = 0; i < NH_GRP_NUM_BUCKETS; i++) {
+			RTE_TEST_ASSERT(nhs[i] >= 1 &&
+				nhs[i] <= RTE_DIM(grp_nhs),
+				"Failed to get proper nexthop\n");
+			count[nhs[i] - 1]++;
+		}
+		/* rounded down cumulative shares */
+		expected[0] = (j == 0) ? 8 : 21;
+		expected[1] = (j == 0) ? 16 : 21;
+		expected[2] = (j == 0) ? 40 : 22;
+		for (i = 0; i < RTE_DIM(grp_nhs); i++)
+			RTE_TEST_ASSERT(count[i] == expected[i],
+				"Wrong share of a next hop\n");
+	}
+
+	rte_fib_free(fib);
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * Check that the routes of a replicated FIB are in the replica of each
+ * socket having lcores, and that the lookups find them.
+ */
+static int32_t
+check_numa_route(struct rte_fib_numa *fn, uint32_t ip, uint64_t nh_exp)
+{
+	unsigned int lcore_id;
+	uint64_t nh;
+	int ret;
+
+	ret = rte_fib_numa_lookup_bulk(fn, &ip, &nh, 1);
+	RTE_TEST_ASSERT(ret == 0 && nh == nh_exp,
+		"Failed to get proper nexthop\n");
+
+	RTE_LCORE_FOREACH(lcore_id) {
+		ret = rte_fib_lookup_bulk(rte_fib_numa_get(fn,
+			rte_lcore_to_socket_id(lcore_id)), &ip, &nh, 1);
+		RTE_TEST_ASSERT(ret == 0 && nh == nh_exp,
+			"Failed to get proper nexthop from replica\n");
+	}
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * Check the FIB replicated on each NUMA socket.
+ */
+int32_t
+test_numa(void)
+{
+	struct rte_fib_numa *fn;
+	struct rte_fib_conf config;
+	struct rte_fib_rcu_config rcu_cfg = {0};
+	struct rte_rcu_qsbr *qsv;
+	uint64_t def_nh = 100;
+	uint32_t ip = RTE_IPV4(10, 0, 0, 1);
+	size_t sz;
+	int ret;
+
+	config.max_routes = MAX_ROUTES;
+	config.default_nh = def_nh;
+	config.type = RTE_FIB_DIR24_8;
+	config.dir24_8.nh_sz = RTE_FIB_DIR24_8_4B;
+	config.dir24_8.num_tbl8 = MIN_TBL8;
+
+	fn = rte_fib_numa_create(NULL, &config);
+	RTE_TEST_ASSERT(fn == NULL,
+		"Call succeeded with invalid parameters\n");
+	fn = rte_fib_numa_create(__func__, NULL);
+	RTE_TEST_ASSERT(fn == NULL,
+		"Call succeeded with invalid parameters\n");
+
+	fn = rte_fib_numa_create(__func__, &config);
+	RTE_TEST_ASSERT(fn != NULL, "Failed to create replicated FIB\n");
+	RTE_TEST_ASSERT(rte_fib_numa_get(fn, SOCKET_ID_ANY) ==
+		rte_fib_numa_get(fn, rte_socket_id()),
+		"Lookups do not use the local replica\n");
+	RTE_TEST_ASSERT(rte_fib_numa_get(fn, RTE_MAX_NUMA_NODES) == NULL,
+		"Call succeeded with invalid parameters\n");
+
+	sz = rte_rcu_qsbr_get_memsize(RTE_MAX_LCORE);
+	qsv = rte_zmalloc_socket(NULL, sz, RTE_CACHE_LINE_SIZE,
+		SOCKET_ID_ANY);
+	RTE_TEST_ASSERT(qsv != NULL, "Cannot allocate memory for QSBR\n");
+	ret = rte_rcu_qsbr_init(qsv, RTE_MAX_LCORE);
+	RTE_TEST_ASSERT(ret == 0, "QSBR init failed\n");
+	rcu_cfg.v = qsv;
+	ret = rte_fib_numa_rcu_qsbr_add(fn, &rcu_cfg);
+	RTE_TEST_ASSERT(ret == 0, "Failed to add RCU QSBR variable\n");
+
+	ret = rte_fib_numa_add(fn, ip, 32, 1);
+	RTE_TEST_ASSERT(ret == 0, "Failed to add a route\n");
+	RTE_TEST_ASSERT(check_numa_route(fn, ip, 1) == TEST_SUCCESS,
+		"Route not replicated\n");
+
+	ret = rte_fib_numa_add(fn, ip, 32, 2);
+	RTE_TEST_ASSERT(ret == 0, "Failed to update a route\n");
+	RTE_TEST_ASSERT(check_numa_route(fn, ip, 2) == TEST_SUCCESS,
+		"Route update not replicated\n");
+
+	ret = rte_fib_numa_delete(fn, ip, 32);
+	RTE_TEST_ASSERT(ret == 0, "Failed to delete a route\n");
+	RTE_TEST_ASSERT(check_numa_route(fn, ip, def_nh) == TEST_SUCCESS,
+		"Route deletion not replicated\n");
+
+	ret = rte_fib_numa_delete(fn, ip, 32);
+	RTE_TEST_ASSERT(ret != 0, "Deleted a route twice\n");
+	ret = rte_fib_numa_add(fn, ip, RTE_FIB_MAXDEPTH + 1, 1);
+	RTE_TEST_ASSERT(ret != 0, "Call succeeded with invalid parameters\n");
+
+	rte_fib_numa_free(fn);
+	rte_free(qsv);
+
+	return TEST_SUCCESS;
+}
+
 static struct unit_test_suite fib_fast_tests = {
 	.suite_name = "fib autotest",
 	.setup = NULL,
@@ -381,6 +754,10 @@ static struct unit_test_suite fib_fast_tests = {
 	TEST_CASE(test_add_del_invalid),
 	TEST_CASE(test_get_invalid),
 	TEST_CASE(test_lookup),
+	TEST_CASE(test_add_bulk),
+	TEST_CASE(test_rcu_qsbr_add),
+	TEST_CASE(test_nh_group),
+	TEST_CASE(test_numa),
 	TEST_CASES_END()
 	}
 };
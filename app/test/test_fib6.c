@@ -26,6 +26,9 @@ static int32_t test_lookup(void);
 #define MAX_ROUTES	(1 << 16)
 /** Maximum number of tbl8 for 2-byte entries */
 #define MAX_TBL8	(1 << 15)
+/** Number of internal nodes and leaves of the POPTRIE tests */
+#define MAX_POPTRIE_NODES	(1 << 16)
+#define MAX_POPTRIE_LEAVES	(1 << 18)
 
 /*
  * Check that rte_fib6_create fails gracefully for incorrect user input
@@ -63,7 +66,7 @@ test_create_invalid(void)
 		"Call succeeded with invalid parameters\n");
 	config.max_routes = MAX_ROUTES;
 
-	config.type = RTE_FIB6_TRIE + 1;
+	config.type = RTE_FIB6_POPTRIE + 1;
 	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
 	RTE_TEST_ASSERT(fib == NULL,
 		"Call succeeded with invalid parameters\n");
@@ -82,6 +85,21 @@ test_create_invalid(void)
 	RTE_TEST_ASSERT(fib == NULL,
 		"Call succeeded with invalid parameters\n");
 
+	config.type = RTE_FIB6_POPTRIE;
+	config.poptrie.nh_sz = RTE_FIB6_TRIE_8B;
+	config.poptrie.num_nodes = MAX_POPTRIE_NODES;
+	config.poptrie.num_leaves = 0;
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib == NULL,
+		"Call succeeded with invalid parameters\n");
+
+	config.poptrie.num_leaves = MAX_POPTRIE_LEAVES;
+	config.poptrie.nh_sz = RTE_FIB6_TRIE_2B;
+	config.default_nh = UINT16_MAX;
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib == NULL,
+		"Call succeeded with invalid parameters\n");
+
 	return TEST_SUCCESS;
 }
 
@@ -377,6 +395,34 @@ test_lookup(void)
 		"Check_fib fails for TRIE_8B type\n");
 	rte_fib6_free(fib);
 
+	config.type = RTE_FIB6_POPTRIE;
+	config.poptrie.num_nodes = MAX_POPTRIE_NODES;
+	config.poptrie.num_leaves = MAX_POPTRIE_LEAVES;
+
+	config.poptrie.nh_sz = RTE_FIB6_TRIE_2B;
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+	ret = check_fib(fib);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS,
+		"Check_fib fails for POPTRIE_2B type\n");
+	rte_fib6_free(fib);
+
+	config.poptrie.nh_sz = RTE_FIB6_TRIE_4B;
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+	ret = check_fib(fib);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS,
+		"Check_fib fails for POPTRIE_4B type\n");
+	rte_fib6_free(fib);
+
+	config.poptrie.nh_sz = RTE_FIB6_TRIE_8B;
+	fib = rte_fib6_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(fib != NULL, "Failed to create FIB\n");
+	ret = check_fib(fib);
+	RTE_TEST_ASSERT(ret == TEST_SUCCESS,
+		"Check_fib fails for POPTRIE_8B type\n");
+	rte_fib6_free(fib);
+
 	return TEST_SUCCESS;
 }
 
@@ -14,6 +14,8 @@
 #include <rte_acl.h>
 #include <rte_common.h>
 #include <rte_table_acl.h>
+#include <rte_table_hash.h>
+#include <rte_table_hash_func.h>
 #include <rte_flow.h>
 #include <rte_flow_classify.h>
 
@@ -164,6 +166,68 @@ static struct rte_flow_item  ipv4_sctp_item_1 = { RTE_FLOW_ITEM_TYPE_IPV4,
 static struct rte_flow_item  sctp_item_1 = { RTE_FLOW_ITEM_TYPE_SCTP,
 	&sctp_spec_1, 0, &rte_flow_item_sctp_mask};
 
+/* test exact UDP pattern:
+ * "eth / ipv4 src is 2.2.2.3 dst is 2.2.2.7 / udp src is 32 dst is 33 / end"
+ */
+static struct rte_flow_item_ipv4 ipv4_udp_spec_exact = {
+	.hdr = {
+		.next_proto_id = IPPROTO_UDP,
+		.src_addr = RTE_BE32(RTE_IPV4(2, 2, 2, 3)),
+		.dst_addr = RTE_BE32(RTE_IPV4(2, 2, 2, 7)),
+	},
+};
+static const struct rte_flow_item_ipv4 ipv4_mask_32 = {
+	.hdr = {
+		.next_proto_id = 0xff,
+		.src_addr = 0xffffffff,
+		.dst_addr = 0xffffffff,
+	},
+};
+static struct rte_flow_item_udp udp_spec_exact = {
+	.hdr = {
+		.src_port = RTE_BE16(32),
+		.dst_port = RTE_BE16(33),
+	},
+};
+
+static struct rte_flow_item  ipv4_udp_item_exact = { RTE_FLOW_ITEM_TYPE_IPV4,
+	&ipv4_udp_spec_exact, 0, &ipv4_mask_32};
+static struct rte_flow_item  udp_item_exact = { RTE_FLOW_ITEM_TYPE_UDP,
+	&udp_spec_exact, 0, &rte_flow_item_udp_mask};
+
+/* test IPv6 TCP pattern:
+ * "eth / ipv6 src is 2001:db8::1 dst is 2001:db8::2 / tcp src is 16
+ *  dst is 17 / end"
+ */
+static struct rte_flow_item_ipv6 ipv6_tcp_spec_1 = {
+	.hdr = {
+		.proto = IPPROTO_TCP,
+		.src_addr = { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+			      0, 0, 0, 0, 0, 0, 0, 1 },
+		.dst_addr = { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+			      0, 0, 0, 0, 0, 0, 0, 2 },
+	},
+};
+static const struct rte_flow_item_ipv6 ipv6_mask_64 = {
+	.hdr = {
+		.proto = 0xff,
+		.src_addr = { 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff },
+		.dst_addr = { 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff },
+	},
+};
+static struct rte_flow_item_tcp tcp_spec_exact = {
+	.hdr = {
+		.src_port = RTE_BE16(16),
+		.dst_port = RTE_BE16(17),
+	},
+};
+
+static struct rte_flow_item  ipv6_tcp_item_1 = { RTE_FLOW_ITEM_TYPE_IPV6,
+	&ipv6_tcp_spec_1, 0, &rte_flow_item_ipv6_mask};
+static struct rte_flow_item  ipv6_tcp_item_bad = { RTE_FLOW_ITEM_TYPE_IPV6,
+	&ipv6_tcp_spec_1, 0, &ipv6_mask_64};
+static struct rte_flow_item  tcp_item_exact = { RTE_FLOW_ITEM_TYPE_TCP,
+	&tcp_spec_exact, 0, &rte_flow_item_tcp_mask};
 
 /* test actions:
  * "actions count / end"
@@ -210,6 +274,12 @@ static struct rte_flow_classify_stats sctp_classify_stats = {
 		.stats = (void *)&sctp_ntuple_stats
 };
 
+/* flow classify data for exact UDP burst */
+static struct rte_flow_classify_ipv4_5tuple_stats udp_exact_stats;
+static struct rte_flow_classify_stats udp_exact_classify_stats = {
+		.stats = (void *)&udp_exact_stats
+};
+
 struct flow_classifier_acl *cls;
 
 struct flow_classifier_acl {
@@ -812,9 +882,123 @@ test_query_sctp(void)
 	return 0;
 }
 
+static int
+test_query_udp_exact(void)
+{
+	struct rte_flow_classify_rule *rule;
+	int ret;
+	int i;
+	int key_found;
+
+	ret = init_ipv4_udp_traffic(mbufpool[0], bufs, MAX_PKT_BURST);
+	if (ret != MAX_PKT_BURST) {
+		printf("Line %i: init_udp_ipv4_traffic has failed!\n",
+				__LINE__);
+		return -1;
+	}
+
+	for (i = 0; i < MAX_PKT_BURST; i++)
+		bufs[i]->packet_type = RTE_PTYPE_L3_IPV4;
+
+	/* a rule without wildcard is added to the exact match table */
+	attr.ingress = 1;
+	attr.priority = 1;
+	pattern[0] = eth_item;
+	pattern[1] = ipv4_udp_item_exact;
+	pattern[2] = udp_item_exact;
+	pattern[3] = end_item;
+	actions[0] = count_action;
+	actions[1] = end_action;
+
+	rule = rte_flow_classify_table_entry_add(cls->cls, &attr, pattern,
+			actions, &key_found, &error);
+	if (!rule) {
+		printf("Line %i: flow_classify_table_entry_add", __LINE__);
+		printf(" should not have failed!\n");
+		return -1;
+	}
+
+	ret = rte_flow_classifier_query(cls->cls, bufs, MAX_PKT_BURST,
+			rule, &udp_exact_classify_stats);
+	if (ret) {
+		printf("Line %i: flow_classifier_query", __LINE__);
+		printf(" should not have failed!\n");
+		return -1;
+	}
+
+	if (udp_exact_stats.counter1 != MAX_PKT_BURST) {
+		printf("Line %i: flow_classifier_query", __LINE__);
+		printf(" matched %"PRIu64" packets instead of %u!\n",
+			udp_exact_stats.counter1, MAX_PKT_BURST);
+		return -1;
+	}
+
+	ret = rte_flow_classify_table_entry_delete(cls->cls, rule);
+	if (ret) {
+		printf("Line %i: rte_flow_classify_table_entry_delete",
+			__LINE__);
+		printf(" should not have failed!\n");
+		return -1;
+	}
+
+	ret = rte_flow_classifier_query(cls->cls, bufs, MAX_PKT_BURST,
+			rule, &udp_exact_classify_stats);
+	if (!ret) {
+		printf("Line %i: flow_classifier_query", __LINE__);
+		printf(" should have failed!\n");
+		return -1;
+	}
+	return 0;
+}
+
+static int
+test_ipv6_exact(void)
+{
+	struct rte_flow_classify_rule *rule;
+	int ret;
+	int key_found;
+
+	attr.ingress = 1;
+	attr.priority = 1;
+	pattern[0] = eth_item;
+	pattern[1] = ipv6_tcp_item_bad;
+	pattern[2] = tcp_item_exact;
+	pattern[3] = end_item;
+	actions[0] = count_action;
+	actions[1] = end_action;
+
+	/* IPv6 rules are matched exactly only */
+	ret = rte_flow_classify_validate(cls->cls, &attr, pattern,
+			actions, &error);
+	if (!ret) {
+		printf("Line %i: rte_flow_classify_validate", __LINE__);
+		printf(" should have failed!\n");
+		return -1;
+	}
+
+	pattern[1] = ipv6_tcp_item_1;
+	rule = rte_flow_classify_table_entry_add(cls->cls, &attr, pattern,
+			actions, &key_found, &error);
+	if (!rule) {
+		printf("Line %i: flow_classify_table_entry_add", __LINE__);
+		printf(" should not have failed!\n");
+		return -1;
+	}
+
+	ret = rte_flow_classify_table_entry_delete(cls->cls, rule);
+	if (ret) {
+		printf("Line %i: rte_flow_classify_table_entry_delete",
+			__LINE__);
+		printf(" should not have failed!\n");
+		return -1;
+	}
+	return 0;
+}
+
 static int
 test_flow_classify(void)
 {
+	struct rte_table_hash_params table_hash_params;
 	struct rte_table_acl_params table_acl_params;
 	struct rte_flow_classify_table_params cls_table_params;
 	struct rte_flow_classifier_params cls_params;
@@ -855,6 +1039,40 @@ test_flow_classify(void)
 	}
 	printf("Created table_acl for for IPv4 five tuple packets\n");
 
+	/* initialise exact match tables, keys being set by the library */
+	memset(&table_hash_params, 0, sizeof(table_hash_params));
+	table_hash_params.name = "table_hash_ipv4_5tuple";
+	table_hash_params.n_keys = FLOW_CLASSIFY_MAX_RULE_NUM;
+	table_hash_params.n_buckets = 64;
+	table_hash_params.f_hash = rte_table_hash_crc_key16;
+
+	cls_table_params.ops = &rte_table_hash_key16_ext_ops;
+	cls_table_params.arg_create = &table_hash_params;
+	cls_table_params.type = RTE_FLOW_CLASSIFY_TABLE_HASH_IP4_5TUPLE;
+
+	ret = rte_flow_classify_table_create(cls->cls, &cls_table_params);
+	if (ret) {
+		printf("Line %i: f_create has failed!\n", __LINE__);
+		rte_flow_classifier_free(cls->cls);
+		rte_free(cls);
+		return TEST_FAILED;
+	}
+
+	table_hash_params.name = "table_hash_ipv6_5tuple";
+	table_hash_params.f_hash = rte_table_hash_crc_key64;
+
+	cls_table_params.ops = &rte_table_hash_ext_ops;
+	cls_table_params.type = RTE_FLOW_CLASSIFY_TABLE_HASH_IP6_5TUPLE;
+
+	ret = rte_flow_classify_table_create(cls->cls, &cls_table_params);
+	if (ret) {
+		printf("Line %i: f_create has failed!\n", __LINE__);
+		rte_flow_classifier_free(cls->cls);
+		rte_free(cls);
+		return TEST_FAILED;
+	}
+	printf("Created exact match tables for five tuple packets\n");
+
 	ret = init_mbufpool();
 	if (ret) {
 		printf("Line %i: init_mbufpool has failed!\n", __LINE__);
@@ -875,6 +1093,10 @@ test_flow_classify(void)
 		return TEST_FAILED;
 	if (test_query_sctp() < 0)
 		return TEST_FAILED;
+	if (test_query_udp_exact() < 0)
+		return TEST_FAILED;
+	if (test_ipv6_exact() < 0)
+		return TEST_FAILED;
 
 	return TEST_SUCCESS;
 }
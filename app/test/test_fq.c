@@ -0,0 +1,181 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <rte_common.h>
+#include <rte_errno.h>
+#include <rte_fq.h>
+#include <rte_lcore.h>
+#include <rte_mbuf.h>
+
+#include "test.h"
+
+#define NB_MBUF      256
+#define QUANTUM      1500
+#define QSIZE        64
+
+#define FLOW_A_RSS   1
+#define FLOW_A_LEN   1500
+#define FLOW_A_PKTS  20
+#define FLOW_B_RSS   2
+#define FLOW_B_LEN   300
+#define FLOW_B_PKTS  60
+
+static struct rte_mempool *pool;
+
+static int
+test_fq_alloc(struct rte_mbuf **pkts, uint32_t n, uint32_t rss, uint32_t len)
+{
+	uint32_t i;
+
+	if (rte_pktmbuf_alloc_bulk(pool, pkts, n) != 0)
+		return -1;
+
+	for (i = 0; i < n; i++) {
+		pkts[i]->hash.rss = rss;
+		pkts[i]->data_len = len;
+		pkts[i]->pkt_len = len;
+	}
+
+	return 0;
+}
+
+static int
+test_fq_invalid_params(void)
+{
+	struct rte_fq_params params = {
+		.socket_id = SOCKET_ID_ANY,
+		.n_queues = 1000,
+		.qsize = QSIZE,
+		.quantum = QUANTUM,
+	};
+
+	TEST_ASSERT(rte_fq_create(NULL) == NULL && rte_errno == EINVAL,
+		"NULL params accepted\n");
+	TEST_ASSERT(rte_fq_create(&params) == NULL && rte_errno == EINVAL,
+		"Number of queues not a power of 2 accepted\n");
+
+	params.n_queues = 1024;
+	params.quantum = 0;
+	TEST_ASSERT(rte_fq_create(&params) == NULL && rte_errno == EINVAL,
+		"Null quantum accepted\n");
+
+	return 0;
+}
+
+static int
+test_fq_drr(struct rte_fq *fq)
+{
+	struct rte_mbuf *pkts[FLOW_A_PKTS + FLOW_B_PKTS];
+	uint32_t bytes_a = 0, bytes_b = 0;
+	struct rte_fq_stats stats;
+	uint32_t i, n;
+
+	TEST_ASSERT_SUCCESS(test_fq_alloc(pkts, FLOW_A_PKTS, FLOW_A_RSS,
+		FLOW_A_LEN), "Packet allocation failed\n");
+	TEST_ASSERT_SUCCESS(test_fq_alloc(pkts + FLOW_A_PKTS, FLOW_B_PKTS,
+		FLOW_B_RSS, FLOW_B_LEN), "Packet allocation failed\n");
+
+	n = rte_fq_enqueue(fq, pkts, RTE_DIM(pkts));
+	TEST_ASSERT_EQUAL(n, RTE_DIM(pkts), "Wrong enqueue, n=%u\n", n);
+	TEST_ASSERT_EQUAL(rte_fq_count(fq), RTE_DIM(pkts), "Wrong count\n");
+
+	/* Both flows backlogged: they share the bytes, not the packets */
+	for (i = 0; i < 4; i++) {
+		uint32_t j;
+
+		n = rte_fq_dequeue(fq, pkts, 8);
+		TEST_ASSERT_EQUAL(n, 8, "Wrong dequeue, n=%u\n", n);
+
+		for (j = 0; j < n; j++) {
+			if (pkts[j]->hash.rss == FLOW_A_RSS)
+				bytes_a += pkts[j]->pkt_len;
+			else
+				bytes_b += pkts[j]->pkt_len;
+		}
+		rte_pktmbuf_free_bulk(pkts, n);
+	}
+	TEST_ASSERT(abs((int)bytes_a - (int)bytes_b) <= 2 * QUANTUM,
+		"Unfair dequeue, %u bytes vs %u bytes\n", bytes_a, bytes_b);
+
+	n = rte_fq_dequeue(fq, pkts, RTE_DIM(pkts));
+	TEST_ASSERT_EQUAL(n, RTE_DIM(pkts) - 32, "Wrong dequeue, n=%u\n", n);
+	rte_pktmbuf_free_bulk(pkts, n);
+
+	TEST_ASSERT_EQUAL(rte_fq_count(fq), 0, "Wrong count\n");
+	TEST_ASSERT_EQUAL(rte_fq_dequeue(fq, pkts, 1), 0,
+		"Dequeue from empty scheduler\n");
+
+	TEST_ASSERT_SUCCESS(rte_fq_stats_read(fq, &stats, 1),
+		"Stats read failed\n");
+	TEST_ASSERT_EQUAL(stats.n_pkts, RTE_DIM(pkts), "Wrong stats\n");
+	TEST_ASSERT_EQUAL(stats.n_bytes, FLOW_A_PKTS * FLOW_A_LEN +
+		FLOW_B_PKTS * FLOW_B_LEN, "Wrong stats\n");
+
+	return 0;
+}
+
+static int
+test_fq_drop(struct rte_fq *fq)
+{
+	struct rte_mbuf *pkts[QSIZE + 8];
+	struct rte_fq_stats stats;
+	uint32_t n;
+
+	TEST_ASSERT_SUCCESS(test_fq_alloc(pkts, RTE_DIM(pkts), FLOW_A_RSS,
+		FLOW_A_LEN), "Packet allocation failed\n");
+
+	n = rte_fq_enqueue(fq, pkts, RTE_DIM(pkts));
+	TEST_ASSERT_EQUAL(n, QSIZE, "Wrong enqueue, n=%u\n", n);
+
+	TEST_ASSERT_SUCCESS(rte_fq_stats_read(fq, &stats, 0),
+		"Stats read failed\n");
+	TEST_ASSERT_EQUAL(stats.n_pkts_dropped, 8, "Wrong stats\n");
+
+	n = rte_fq_dequeue(fq, pkts, RTE_DIM(pkts));
+	TEST_ASSERT_EQUAL(n, QSIZE, "Wrong dequeue, n=%u\n", n);
+	rte_pktmbuf_free_bulk(pkts, n);
+
+	return 0;
+}
+
+static int
+test_fq(void)
+{
+	struct rte_fq_params params = {
+		.socket_id = SOCKET_ID_ANY,
+		.n_queues = 1024,
+		.qsize = QSIZE,
+		.quantum = QUANTUM,
+	};
+	struct rte_fq *fq;
+	int ret = -1;
+
+	pool = rte_pktmbuf_pool_create("test_fq", NB_MBUF, 0, 0,
+		RTE_MBUF_DEFAULT_BUF_SIZE, SOCKET_ID_ANY);
+	TEST_ASSERT_NOT_NULL(pool, "Error creating mempool\n");
+
+	if (test_fq_invalid_params() < 0)
+		goto exit_pool;
+
+	fq = rte_fq_create(&params);
+	if (fq == NULL) {
+		printf("Error creating flow queue scheduler\n");
+		goto exit_pool;
+	}
+
+	if (test_fq_drr(fq) < 0 || test_fq_drop(fq) < 0)
+		goto exit;
+
+	ret = 0;
+exit:
+	rte_fq_free(fq);
+exit_pool:
+	rte_mempool_free(pool);
+	return ret;
+}
+
+REGISTER_TEST_COMMAND(fq_autotest, test_fq);
@@ -10,7 +10,9 @@
 
 #include <rte_errno.h>
 #include <rte_graph.h>
+#include <rte_graph_model_dispatch.h>
 #include <rte_graph_worker.h>
+#include <rte_lcore.h>
 #include <rte_mbuf.h>
 #include <rte_mbuf_dyn.h>
 #include <rte_random.h>
@@ -710,6 +712,18 @@ test_graph_lookup_functions(void)
 	return 0;
 }
 
+static uint64_t
+test_hist_calls(const uint64_t *hist)
+{
+	uint64_t calls = 0;
+	int i;
+
+	for (i = 0; i < RTE_GRAPH_STATS_HIST_NB_BUCKETS; i++)
+		calls += hist[i];
+
+	return calls;
+}
+
 static int
 graph_cluster_stats_cb_t(bool is_first, bool is_last, void *cookie,
 			 const struct rte_graph_cluster_node_stats *st)
@@ -736,6 +750,20 @@ graph_cluster_stats_cb_t(bool is_first, bool is_last, void *cookie,
 				       st->calls);
 				return -1;
 			}
+
+			if (rte_graph_has_stats_hist_feature() &&
+			    test_hist_calls(st->hist_objs) != st->calls) {
+				printf("Objs histogram miss match for node = %s\n",
+				       node_patterns[i]);
+				return -1;
+			}
+
+			if (rte_graph_has_stats_hist_feature() &&
+			    test_hist_calls(st->hist_cycles) != st->calls) {
+				printf("Cycles histogram miss match for node = %s\n",
+				       node_patterns[i]);
+				return -1;
+			}
 		}
 	}
 	return 0;
@@ -771,6 +799,82 @@ test_print_stats(void)
 	return 0;
 }
 
+static int
+test_graph_clone_dispatch(void)
+{
+	unsigned int lcore_id = rte_lcore_id();
+	struct rte_graph *graph, *clone;
+	struct rte_node *node, *node_clone;
+	rte_graph_t clone_id;
+	int i, rc;
+
+	clone_id = rte_graph_clone(graph_id, "clone", SOCKET_ID_ANY);
+	if (clone_id == RTE_GRAPH_ID_INVALID) {
+		printf("Graph clone failed with error = %d\n", rte_errno);
+		return -1;
+	}
+
+	graph = rte_graph_lookup("worker0");
+	clone = rte_graph_lookup("worker0-clone");
+	if (!graph || !clone) {
+		printf("Graph lookup failed\n");
+		goto fail;
+	}
+
+	for (i = 0; i < MAX_NODES; i++) {
+		node = rte_graph_node_get_by_name("worker0", node_names[i]);
+		node_clone = rte_graph_node_get_by_name("worker0-clone",
+							node_names[i]);
+		if (!node || !node_clone || node->off != node_clone->off) {
+			printf("Node %s not cloned\n", node_names[i]);
+			goto fail;
+		}
+	}
+
+	rc = rte_graph_model_dispatch_core_bind(clone_id, RTE_MAX_LCORE);
+	if (rc == 0) {
+		printf("Graph bound to invalid lcore\n");
+		goto fail;
+	}
+
+	rc = rte_graph_model_dispatch_core_bind(clone_id, lcore_id);
+	if (rc) {
+		printf("Graph bind failed with error = %d\n", rc);
+		goto fail;
+	}
+
+	rc = rte_graph_model_dispatch_core_bind(graph_id, lcore_id);
+	if (rc != -EEXIST) {
+		printf("Two graphs of a group bound to the same lcore\n");
+		goto fail;
+	}
+
+	if (rte_graph_model_dispatch_lcore_affinity_set("test_node00",
+							RTE_MAX_LCORE + 1) == 0) {
+		printf("Node affine to invalid lcore\n");
+		goto fail;
+	}
+
+	/* Set and clear the affinity of a node */
+	if (rte_graph_model_dispatch_lcore_affinity_set("test_node00",
+							lcore_id) ||
+	    rte_graph_model_dispatch_lcore_affinity_set("test_node00",
+							RTE_MAX_LCORE)) {
+		printf("Node affinity set failed\n");
+		goto fail;
+	}
+
+	if (rte_graph_destroy(clone_id)) {
+		printf("Graph clone destroy failed\n");
+		return -1;
+	}
+
+	return 0;
+fail:
+	rte_graph_destroy(clone_id);
+	return -1;
+}
+
 static int
 graph_setup(void)
 {
@@ -822,6 +926,7 @@ static struct unit_test_suite graph_testsuite = {
 		TEST_CASE(test_graph_lookup_functions),
 		TEST_CASE(test_graph_walk),
 		TEST_CASE(test_print_stats),
+		TEST_CASE(test_graph_clone_dispatch),
 		TEST_CASES_END(), /**< NULL terminate unit test array */
 	},
 };
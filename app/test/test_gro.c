@@ -0,0 +1,514 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include <rte_common.h>
+#include <rte_cycles.h>
+#include <rte_ether.h>
+#include <rte_gro.h>
+#include <rte_ip.h>
+#include <rte_lcore.h>
+#include <rte_mbuf.h>
+#include <rte_tcp.h>
+
+#include "test.h"
+
+#define NUM_MBUFS 256
+#define BURST 32
+#define NB_SEGS 4
+/* multiple of 8 bytes, so that it is a valid IP fragment size */
+#define SEG_LEN 96
+#define TCP_SEQ 1000
+#define TCP_PORT 5000
+#define FRAG_ID 100
+
+static struct rte_mempool *pkt_pool;
+
+/* packet type under test */
+struct gro_test_type {
+	uint64_t gro_type;
+	int ipv6;
+	int udp;
+};
+
+static const struct gro_test_type tcp4 = { RTE_GRO_TCP_IPV4, 0, 0 };
+static const struct gro_test_type tcp6 = { RTE_GRO_TCP_IPV6, 1, 0 };
+static const struct gro_test_type udp4 = { RTE_GRO_UDP_IPV4, 0, 1 };
+static const struct gro_test_type udp6 = { RTE_GRO_UDP_IPV6, 1, 1 };
+
+/* the payload byte at a given position of the stream */
+static inline uint8_t
+payload_byte(uint32_t pos)
+{
+	return (uint8_t)(pos * 7 + 3);
+}
+
+/* Ethernet and IP headers, the caller sets the protocol fields */
+static struct rte_mbuf *
+pkt_init(const struct gro_test_type *type, uint16_t l3_len, uint16_t l4_len,
+	 uint32_t pos, uint16_t len, char **l3)
+{
+	struct rte_ether_hdr *eth;
+	struct rte_ipv4_hdr *ip4;
+	struct rte_ipv6_hdr *ip6;
+	struct rte_mbuf *m;
+	uint16_t hdr_len, i;
+	uint8_t *payload;
+	char *data;
+
+	m = rte_pktmbuf_alloc(pkt_pool);
+	if (m == NULL)
+		return NULL;
+
+	hdr_len = sizeof(*eth) + l3_len + l4_len;
+	data = rte_pktmbuf_append(m, hdr_len + len);
+	if (data == NULL) {
+		rte_pktmbuf_free(m);
+		return NULL;
+	}
+	memset(data, 0, hdr_len);
+
+	eth = (struct rte_ether_hdr *)data;
+	eth->d_addr.addr_bytes[5] = 0x01;
+	eth->s_addr.addr_bytes[5] = 0x02;
+	m->l2_len = sizeof(*eth);
+	m->l3_len = l3_len;
+	m->l4_len = l4_len;
+
+	*l3 = data + sizeof(*eth);
+	if (type->ipv6) {
+		eth->ether_type = rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV6);
+		ip6 = (struct rte_ipv6_hdr *)*l3;
+		ip6->vtc_flow = rte_cpu_to_be_32(6 << 28);
+		ip6->payload_len = rte_cpu_to_be_16(l3_len - sizeof(*ip6) +
+						    l4_len + len);
+		ip6->hop_limits = 64;
+		ip6->src_addr[15] = 1;
+		ip6->dst_addr[15] = 2;
+		m->packet_type = RTE_PTYPE_L2_ETHER | RTE_PTYPE_L3_IPV6;
+	} else {
+		eth->ether_type = rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4);
+		ip4 = (struct rte_ipv4_hdr *)*l3;
+		ip4->version_ihl = RTE_IPV4_VHL_DEF;
+		ip4->total_length = rte_cpu_to_be_16(l3_len + l4_len + len);
+		ip4->time_to_live = 64;
+		ip4->src_addr = rte_cpu_to_be_32(RTE_IPV4(10, 0, 0, 1));
+		ip4->dst_addr = rte_cpu_to_be_32(RTE_IPV4(10, 0, 0, 2));
+		m->packet_type = RTE_PTYPE_L2_ETHER | RTE_PTYPE_L3_IPV4;
+	}
+
+	payload = (uint8_t *)data + hdr_len;
+	for (i = 0; i < len; i++)
+		payload[i] = payload_byte(pos + i);
+
+	return m;
+}
+
+/* TCP segment of SEG_LEN bytes, the sequence number gives the payload */
+static struct rte_mbuf *
+tcp_pkt(const struct gro_test_type *type, uint16_t src_port, uint32_t seq,
+	uint8_t tcp_flags)
+{
+	struct rte_ipv4_hdr *ip4;
+	struct rte_ipv6_hdr *ip6;
+	struct rte_tcp_hdr *tcp;
+	struct rte_mbuf *m;
+	uint16_t l3_len;
+	char *l3;
+
+	l3_len = type->ipv6 ? sizeof(*ip6) : sizeof(*ip4);
+	m = pkt_init(type, l3_len, sizeof(*tcp), seq, SEG_LEN, &l3);
+	if (m == NULL)
+		return NULL;
+
+	if (type->ipv6) {
+		ip6 = (struct rte_ipv6_hdr *)l3;
+		ip6->proto = IPPROTO_TCP;
+	} else {
+		ip4 = (struct rte_ipv4_hdr *)l3;
+		ip4->next_proto_id = IPPROTO_TCP;
+		ip4->fragment_offset = rte_cpu_to_be_16(RTE_IPV4_HDR_DF_FLAG);
+	}
+
+	tcp = (struct rte_tcp_hdr *)(l3 + l3_len);
+	tcp->src_port = rte_cpu_to_be_16(src_port);
+	tcp->dst_port = rte_cpu_to_be_16(80);
+	tcp->sent_seq = rte_cpu_to_be_32(seq);
+	tcp->recv_ack = rte_cpu_to_be_32(1);
+	tcp->data_off = (sizeof(*tcp) / 4) << 4;
+	tcp->tcp_flags = tcp_flags;
+	tcp->rx_win = rte_cpu_to_be_16(UINT16_MAX);
+	m->packet_type |= RTE_PTYPE_L4_TCP;
+
+	return m;
+}
+
+/* IP fragment of a UDP datagram, the offset gives the payload */
+static struct rte_mbuf *
+udp_frag(const struct gro_test_type *type, uint16_t id, uint16_t offset,
+	 int more)
+{
+	struct rte_ipv6_fragment_ext *frag;
+	struct rte_ipv4_hdr *ip4;
+	struct rte_ipv6_hdr *ip6;
+	struct rte_mbuf *m;
+	uint16_t l3_len;
+	char *l3;
+
+	l3_len = type->ipv6 ? sizeof(*ip6) + RTE_IPV6_FRAG_HDR_SIZE :
+		sizeof(*ip4);
+	m = pkt_init(type, l3_len, 0, offset, SEG_LEN, &l3);
+	if (m == NULL)
+		return NULL;
+
+	if (type->ipv6) {
+		ip6 = (struct rte_ipv6_hdr *)l3;
+		ip6->proto = IPPROTO_FRAGMENT;
+		frag = (struct rte_ipv6_fragment_ext *)(ip6 + 1);
+		frag->next_header = IPPROTO_UDP;
+		frag->frag_data = rte_cpu_to_be_16(
+			RTE_IPV6_SET_FRAG_DATA(offset, more ? 1 : 0));
+		frag->id = rte_cpu_to_be_32(id);
+	} else {
+		ip4 = (struct rte_ipv4_hdr *)l3;
+		ip4->next_proto_id = IPPROTO_UDP;
+		ip4->packet_id = rte_cpu_to_be_16(id);
+		ip4->fragment_offset = rte_cpu_to_be_16(
+			offset / RTE_IPV4_HDR_OFFSET_UNITS |
+			(more ? RTE_IPV4_HDR_MF_FLAG : 0));
+	}
+	m->packet_type |= RTE_PTYPE_L4_UDP;
+
+	return m;
+}
+
+/* segment idx of the first flow */
+static struct rte_mbuf *
+flow_pkt(const struct gro_test_type *type, unsigned int idx)
+{
+	if (type->udp)
+		return udp_frag(type, FRAG_ID, idx * SEG_LEN,
+				idx != NB_SEGS - 1);
+	return tcp_pkt(type, TCP_PORT, TCP_SEQ + idx * SEG_LEN,
+		       RTE_TCP_ACK_FLAG);
+}
+
+static int
+alloc_flow_pkts(const struct gro_test_type *type, struct rte_mbuf **pkts,
+		const unsigned int *order, unsigned int nb_pkts)
+{
+	unsigned int i;
+
+	for (i = 0; i < nb_pkts; i++) {
+		pkts[i] = flow_pkt(type, order[i]);
+		if (pkts[i] == NULL) {
+			rte_pktmbuf_free_bulk(pkts, i);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+/* check a merged packet of the first flow, from segment 0 */
+static int
+check_flow_pkt(const struct gro_test_type *type, struct rte_mbuf *m,
+	       unsigned int nb_segs)
+{
+	const struct rte_ipv4_hdr *ip4;
+	const struct rte_ipv6_hdr *ip6;
+	uint32_t hdr_len, pos, i;
+	uint8_t buf;
+	const uint8_t *b;
+
+	hdr_len = m->l2_len + m->l3_len + m->l4_len;
+	pos = type->udp ? 0 : TCP_SEQ;
+
+	TEST_ASSERT_EQUAL(m->nb_segs, nb_segs,
+			  "Packet has %u segments, expected %u",
+			  m->nb_segs, nb_segs);
+	TEST_ASSERT_EQUAL(m->pkt_len, hdr_len + nb_segs * SEG_LEN,
+			  "Packet length %u, expected %u", m->pkt_len,
+			  hdr_len + nb_segs * SEG_LEN);
+
+	if (type->ipv6) {
+		ip6 = rte_pktmbuf_mtod_offset(m, const struct rte_ipv6_hdr *,
+					      m->l2_len);
+		TEST_ASSERT_EQUAL(rte_be_to_cpu_16(ip6->payload_len),
+				  m->pkt_len - m->l2_len - sizeof(*ip6),
+				  "IPv6 payload length not updated");
+	} else {
+		ip4 = rte_pktmbuf_mtod_offset(m, const struct rte_ipv4_hdr *,
+					      m->l2_len);
+		TEST_ASSERT_EQUAL(rte_be_to_cpu_16(ip4->total_length),
+				  m->pkt_len - m->l2_len,
+				  "IPv4 total length not updated");
+	}
+
+	for (i = 0; i < nb_segs * SEG_LEN; i++) {
+		b = rte_pktmbuf_read(m, hdr_len + i, 1, &buf);
+		TEST_ASSERT(b != NULL && *b == payload_byte(pos + i),
+			    "Payload mismatch at byte %u", i);
+	}
+
+	return TEST_SUCCESS;
+}
+
+static int
+gro_burst_check(const struct gro_test_type *type, const unsigned int *order)
+{
+	struct rte_gro_param param = {
+		.gro_types = type->gro_type,
+		.max_flow_num = 4,
+		.max_item_per_flow = NB_SEGS,
+	};
+	struct rte_mbuf *pkts[NB_SEGS];
+	uint16_t nb_pkts;
+	int ret;
+
+	TEST_ASSERT_SUCCESS(alloc_flow_pkts(type, pkts, order, NB_SEGS),
+			    "Cannot allocate packets");
+
+	nb_pkts = rte_gro_reassemble_burst(pkts, NB_SEGS, &param);
+	if (nb_pkts != 1) {
+		rte_pktmbuf_free_bulk(pkts, nb_pkts);
+		TEST_ASSERT_EQUAL(nb_pkts, 1, "%u packets after GRO, expected 1",
+				  nb_pkts);
+	}
+
+	ret = check_flow_pkt(type, pkts[0], NB_SEGS);
+	rte_pktmbuf_free(pkts[0]);
+
+	return ret;
+}
+
+/* all segments of a flow received in order are merged */
+static int
+test_gro_merge(const void *data)
+{
+	static const unsigned int order[NB_SEGS] = { 0, 1, 2, 3 };
+
+	return gro_burst_check(data, order);
+}
+
+/* a segment preceding the stored one is prepended to it */
+static int
+test_gro_out_of_order(const void *data)
+{
+	static const unsigned int order[NB_SEGS] = { 1, 0, 2, 3 };
+
+	return gro_burst_check(data, order);
+}
+
+/*
+ * Segments of different flows and segments with a gap in between are not
+ * merged together, nor are TCP segments with flags other than ACK.
+ */
+static int
+test_gro_mismatch(const void *data)
+{
+	const struct gro_test_type *type = data;
+	struct rte_gro_param param = {
+		.gro_types = type->gro_type,
+		.max_flow_num = 4,
+		.max_item_per_flow = NB_SEGS,
+	};
+	struct rte_mbuf *pkts[8];
+	unsigned int nb_alloc, i, nb_single, nb_merged;
+	uint32_t hdr_len;
+	uint16_t nb_pkts;
+
+	nb_alloc = 0;
+	pkts[nb_alloc++] = flow_pkt(type, 0);
+	/* other flow */
+	if (type->udp) {
+		pkts[nb_alloc++] = udp_frag(type, FRAG_ID + 1, 0, 1);
+		pkts[nb_alloc++] = flow_pkt(type, 1);
+		pkts[nb_alloc++] = udp_frag(type, FRAG_ID + 1, SEG_LEN, 1);
+	} else {
+		pkts[nb_alloc++] = tcp_pkt(type, TCP_PORT + 1, TCP_SEQ,
+					   RTE_TCP_ACK_FLAG);
+		pkts[nb_alloc++] = flow_pkt(type, 1);
+		pkts[nb_alloc++] = tcp_pkt(type, TCP_PORT + 1,
+					   TCP_SEQ + SEG_LEN,
+					   RTE_TCP_ACK_FLAG);
+		/* not mergeable, but next in sequence */
+		pkts[nb_alloc++] = tcp_pkt(type, TCP_PORT,
+					   TCP_SEQ + 2 * SEG_LEN,
+					   RTE_TCP_ACK_FLAG | RTE_TCP_PSH_FLAG);
+	}
+	/* not a neighbor of the merged segments 0 and 1 */
+	pkts[nb_alloc++] = flow_pkt(type, 3);
+
+	for (i = 0; i < nb_alloc; i++) {
+		if (pkts[i] == NULL) {
+			for (i = 0; i < nb_alloc; i++)
+				rte_pktmbuf_free(pkts[i]);
+			TEST_ASSERT(0, "Cannot allocate packets");
+		}
+	}
+
+	nb_pkts = rte_gro_reassemble_burst(pkts, nb_alloc, &param);
+
+	nb_single = 0;
+	nb_merged = 0;
+	for (i = 0; i < nb_pkts; i++) {
+		hdr_len = pkts[i]->l2_len + pkts[i]->l3_len + pkts[i]->l4_len;
+		if (pkts[i]->pkt_len == hdr_len + SEG_LEN)
+			nb_single++;
+		else if (pkts[i]->pkt_len == hdr_len + 2 * SEG_LEN)
+			nb_merged++;
+	}
+	rte_pktmbuf_free_bulk(pkts, nb_pkts);
+
+	TEST_ASSERT_EQUAL(nb_pkts, nb_alloc - 2,
+			  "%u packets after GRO, expected %u",
+			  nb_pkts, nb_alloc - 2);
+	TEST_ASSERT_EQUAL(nb_merged, 2, "%u flows merged, expected 2",
+			  nb_merged);
+	TEST_ASSERT_EQUAL(nb_single, nb_alloc - 4,
+			  "%u packets left alone, expected %u",
+			  nb_single, nb_alloc - 4);
+
+	return TEST_SUCCESS;
+}
+
+/* packets merged in a GRO context are only flushed once timed out */
+static int
+test_gro_timeout_flush(const void *data)
+{
+	static const unsigned int order[NB_SEGS - 1] = { 0, 1, 2 };
+	const struct gro_test_type *type = data;
+	struct rte_gro_param param = {
+		.gro_types = type->gro_type,
+		.max_flow_num = 4,
+		.max_item_per_flow = NB_SEGS,
+		.socket_id = rte_socket_id(),
+	};
+	struct rte_mbuf *pkts[NB_SEGS], *out[BURST];
+	uint64_t other_type;
+	uint16_t nb_pkts;
+	void *ctx;
+	int ret;
+
+	ctx = rte_gro_ctx_create(&param);
+	TEST_ASSERT_NOT_NULL(ctx, "Cannot create GRO context");
+
+	if (alloc_flow_pkts(type, pkts, order, RTE_DIM(order)) < 0) {
+		rte_gro_ctx_destroy(ctx);
+		TEST_ASSERT(0, "Cannot allocate packets");
+	}
+
+	nb_pkts = rte_gro_reassemble(pkts, RTE_DIM(order), ctx);
+	ret = TEST_FAILED;
+	if (nb_pkts != 0) {
+		printf("%u packets not processed\n", nb_pkts);
+		rte_pktmbuf_free_bulk(pkts, nb_pkts);
+		goto out;
+	}
+	if (rte_gro_get_pkt_count(ctx) != 1) {
+		printf("%"PRIu64" packets in GRO context, expected 1\n",
+		       rte_gro_get_pkt_count(ctx));
+		goto out;
+	}
+
+	/* not timed out yet */
+	nb_pkts = rte_gro_timeout_flush(ctx, rte_get_tsc_hz(),
+					type->gro_type, out, RTE_DIM(out));
+	if (nb_pkts != 0) {
+		printf("%u packets flushed before timeout\n", nb_pkts);
+		rte_pktmbuf_free_bulk(out, nb_pkts);
+		goto out;
+	}
+
+	/* other GRO types are left alone */
+	other_type = type->udp ? RTE_GRO_TCP_IPV4 | RTE_GRO_TCP_IPV6 :
+		RTE_GRO_UDP_IPV4 | RTE_GRO_UDP_IPV6;
+	nb_pkts = rte_gro_timeout_flush(ctx, 0, other_type, out, RTE_DIM(out));
+	if (nb_pkts != 0) {
+		printf("%u packets flushed for other GRO types\n", nb_pkts);
+		rte_pktmbuf_free_bulk(out, nb_pkts);
+		goto out;
+	}
+
+	nb_pkts = rte_gro_timeout_flush(ctx, 0, type->gro_type,
+					out, RTE_DIM(out));
+	if (nb_pkts != 1) {
+		printf("%u packets flushed, expected 1\n", nb_pkts);
+		rte_pktmbuf_free_bulk(out, nb_pkts);
+		goto out;
+	}
+
+	ret = check_flow_pkt(type, out[0], RTE_DIM(order));
+	rte_pktmbuf_free(out[0]);
+	if (ret == TEST_SUCCESS && rte_gro_get_pkt_count(ctx) != 0) {
+		printf("packets left in GRO context after flush\n");
+		ret = TEST_FAILED;
+	}
+
+out:
+	rte_gro_ctx_destroy(ctx);
+	return ret;
+}
+
+static int
+testsuite_setup(void)
+{
+	pkt_pool = rte_pktmbuf_pool_create("GRO_MBUF_POOL", NUM_MBUFS, BURST,
+					   0, RTE_MBUF_DEFAULT_BUF_SIZE,
+					   SOCKET_ID_ANY);
+	if (pkt_pool == NULL) {
+		printf("%s: Error creating pkt mempool\n", __func__);
+		return TEST_FAILED;
+	}
+
+	return TEST_SUCCESS;
+}
+
+static void
+testsuite_teardown(void)
+{
+	rte_mempool_free(pkt_pool);
+	pkt_pool = NULL;
+}
+
+#define GRO_TEST_CASE(fn, type) \
+	{ NULL, NULL, NULL, fn, #fn "_" #type, 1, &type }
+
+static struct unit_test_suite gro_testsuite = {
+	.suite_name = "GRO Unit Test Suite",
+	.setup = testsuite_setup,
+	.teardown = testsuite_teardown,
+	.unit_test_cases = {
+		GRO_TEST_CASE(test_gro_merge, tcp4),
+		GRO_TEST_CASE(test_gro_out_of_order, tcp4),
+		GRO_TEST_CASE(test_gro_mismatch, tcp4),
+		GRO_TEST_CASE(test_gro_timeout_flush, tcp4),
+		GRO_TEST_CASE(test_gro_merge, tcp6),
+		GRO_TEST_CASE(test_gro_out_of_order, tcp6),
+		GRO_TEST_CASE(test_gro_mismatch, tcp6),
+		GRO_TEST_CASE(test_gro_timeout_flush, tcp6),
+		GRO_TEST_CASE(test_gro_merge, udp4),
+		GRO_TEST_CASE(test_gro_out_of_order, udp4),
+		GRO_TEST_CASE(test_gro_mismatch, udp4),
+		GRO_TEST_CASE(test_gro_timeout_flush, udp4),
+		GRO_TEST_CASE(test_gro_merge, udp6),
+		GRO_TEST_CASE(test_gro_out_of_order, udp6),
+		GRO_TEST_CASE(test_gro_mismatch, udp6),
+		GRO_TEST_CASE(test_gro_timeout_flush, udp6),
+
+		TEST_CASES_END() /**< NULL terminate unit test array */
+	}
+};
+
+static int
+test_gro(void)
+{
+	return unit_test_suite_runner(&gro_testsuite);
+}
+
+REGISTER_TEST_COMMAND(gro_autotest, test_gro);
@@ -997,6 +997,270 @@ static int test_extendable_bucket(void)
 	return 0;
 }
 
+#define RESIZABLE_ENTRIES	4096
+#define RESIZABLE_KEYS		3000
+
+/*
+ * Resizable bucket array: the table grows while keys are added, keys are
+ * found while they are migrated, and the table shrinks back once most of
+ * them are deleted.
+ */
+static int
+test_resizable_table_keys(struct rte_hash *handle)
+{
+	uint32_t keys[RESIZABLE_KEYS];
+	const void *key_ptrs[RTE_HASH_LOOKUP_BULK_MAX];
+	void *data[RTE_HASH_LOOKUP_BULK_MAX];
+	uint64_t hit_mask;
+	int32_t ret, nb_buckets;
+	unsigned int i, j;
+	void *d;
+
+	for (i = 0; i < RESIZABLE_KEYS; i++)
+		keys[i] = i * 2654435761u;
+
+	nb_buckets = rte_hash_bucket_count(handle);
+	RETURN_IF_ERROR(nb_buckets <= 0, "failed to get bucket count");
+
+	for (i = 0; i < RESIZABLE_KEYS; i++) {
+		ret = rte_hash_add_key_data(handle, &keys[i],
+					    (void *)(uintptr_t)(i + 1));
+		RETURN_IF_ERROR(ret != 0, "failed to add key %u (%d)", i, ret);
+	}
+	RETURN_IF_ERROR(rte_hash_bucket_count(handle) <= nb_buckets,
+			"table did not grow");
+
+	/* Keys must be found whether they were migrated or not */
+	for (i = 0; i < RESIZABLE_KEYS; i++) {
+		ret = rte_hash_lookup_data(handle, &keys[i], &d);
+		RETURN_IF_ERROR(ret < 0 || d != (void *)(uintptr_t)(i + 1),
+				"failed to find key %u during resize", i);
+	}
+
+	do {
+		ret = rte_hash_resize_step(handle, 1);
+		RETURN_IF_ERROR(ret < 0, "resize step failed (%d)", ret);
+	} while (ret > 0);
+
+	for (i = 0; i + RTE_HASH_LOOKUP_BULK_MAX <= RESIZABLE_KEYS;
+			i += RTE_HASH_LOOKUP_BULK_MAX) {
+		for (j = 0; j < RTE_HASH_LOOKUP_BULK_MAX; j++)
+			key_ptrs[j] = &keys[i + j];
+		ret = rte_hash_lookup_bulk_data(handle, key_ptrs,
+				RTE_HASH_LOOKUP_BULK_MAX, &hit_mask, data);
+		RETURN_IF_ERROR(ret != RTE_HASH_LOOKUP_BULK_MAX,
+				"bulk lookup found %d keys", ret);
+		for (j = 0; j < RTE_HASH_LOOKUP_BULK_MAX; j++)
+			RETURN_IF_ERROR(data[j] != (void *)(uintptr_t)(i + j + 1),
+					"bulk lookup returned wrong data");
+	}
+
+	/* Keep one key out of ten and shrink */
+	for (i = 0; i < RESIZABLE_KEYS; i++) {
+		if (i % 10 == 0)
+			continue;
+		ret = rte_hash_del_key(handle, &keys[i]);
+		RETURN_IF_ERROR(ret < 0, "failed to delete key %u", i);
+	}
+
+	nb_buckets = rte_hash_bucket_count(handle);
+	ret = rte_hash_resize(handle, RESIZABLE_KEYS / 5);
+	RETURN_IF_ERROR(ret != 0, "failed to shrink table (%d)", ret);
+	RETURN_IF_ERROR(rte_hash_bucket_count(handle) >= nb_buckets,
+			"table did not shrink");
+
+	for (i = 0; i < RESIZABLE_KEYS; i++) {
+		ret = rte_hash_lookup_data(handle, &keys[i], &d);
+		if (i % 10 == 0)
+			RETURN_IF_ERROR(ret < 0 ||
+					d != (void *)(uintptr_t)(i + 1),
+					"failed to find key %u after shrink", i);
+		else
+			RETURN_IF_ERROR(ret != -ENOENT,
+					"found deleted key %u after shrink", i);
+	}
+
+	rte_hash_free(handle);
+	return 0;
+}
+
+static int
+test_resizable_table(uint32_t lock_free)
+{
+	struct rte_hash_parameters params = {
+		.name = "test_resizable",
+		.entries = RESIZABLE_ENTRIES,
+		.key_len = sizeof(uint32_t),
+		.hash_func = rte_jhash,
+		.socket_id = 0,
+		.extra_flag = RTE_HASH_EXTRA_FLAGS_RESIZABLE,
+	};
+	struct rte_hash_rcu_config rcu_cfg = {0};
+	struct rte_rcu_qsbr *qsv = NULL;
+	struct rte_hash *handle;
+	size_t sz;
+	int ret;
+
+	printf("\n# Running resizable table test, lock free %u\n", lock_free);
+
+	/* Incompatible with extendable buckets */
+	params.extra_flag |= RTE_HASH_EXTRA_FLAGS_EXT_TABLE;
+	handle = rte_hash_create(&params);
+	RETURN_IF_ERROR(handle != NULL,
+			"resizable table with ext buckets should fail");
+	params.extra_flag &= ~RTE_HASH_EXTRA_FLAGS_EXT_TABLE;
+
+	if (lock_free)
+		params.extra_flag |= RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF;
+	handle = rte_hash_create(&params);
+	RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+
+	if (lock_free) {
+		/* Lock-free readers are waited for with RCU only */
+		ret = rte_hash_resize(handle, RESIZABLE_ENTRIES);
+		RETURN_IF_ERROR(ret != -EINVAL,
+				"resize without RCU should fail (%d)", ret);
+
+		sz = rte_rcu_qsbr_get_memsize(RTE_MAX_LCORE);
+		qsv = rte_zmalloc_socket(NULL, sz, RTE_CACHE_LINE_SIZE,
+					 SOCKET_ID_ANY);
+		RETURN_IF_ERROR(qsv == NULL,
+				"RCU QSBR variable creation failed");
+		rte_rcu_qsbr_init(qsv, RTE_MAX_LCORE);
+		rcu_cfg.v = qsv;
+		rcu_cfg.mode = RTE_HASH_QSBR_MODE_SYNC;
+		ret = rte_hash_rcu_qsbr_add(handle, &rcu_cfg);
+		if (ret != 0)
+			rte_free(qsv);
+		RETURN_IF_ERROR(ret != 0,
+				"Attach RCU QSBR to hash table failed");
+	}
+
+	ret = test_resizable_table_keys(handle);
+	rte_free(qsv);
+	if (ret < 0)
+		return -1;
+
+	/* Resizing a non resizable table is not supported */
+	params.extra_flag = 0;
+	handle = rte_hash_create(&params);
+	RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+	ret = rte_hash_resize(handle, RESIZABLE_ENTRIES / 2);
+	RETURN_IF_ERROR(ret != -ENOTSUP,
+			"resize of a fixed table should fail (%d)", ret);
+	rte_hash_free(handle);
+
+	return 0;
+}
+
+#define BULK_ENTRIES	1024
+#define BULK_KEYS	(BULK_ENTRIES + BULK_ENTRIES / 2)
+
+/*
+ * Bulk add and delete: keys are added in bursts, the table is filled up to
+ * the point where keys need cuckoo moves or extendable buckets, duplicates
+ * in a burst update the data, and keys are then deleted in bursts.
+ */
+static int
+test_bulk_add_delete(uint32_t extra_flag)
+{
+	struct rte_hash_parameters params = {
+		.name = "test_bulk",
+		.entries = BULK_ENTRIES,
+		.key_len = sizeof(uint32_t),
+		.hash_func = rte_jhash,
+		.socket_id = 0,
+	};
+	static uint32_t keys[BULK_KEYS];
+	const void *key_ptrs[RTE_HASH_LOOKUP_BULK_MAX];
+	void *data[RTE_HASH_LOOKUP_BULK_MAX];
+	int32_t pos[RTE_HASH_LOOKUP_BULK_MAX];
+	struct rte_hash *handle;
+	unsigned int i, j, n, ok, added = 0;
+	int32_t ret;
+	void *d;
+
+	printf("\n# Running bulk add/delete test, flags 0x%x\n", extra_flag);
+
+	params.extra_flag = extra_flag;
+	handle = rte_hash_create(&params);
+	RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+
+	for (i = 0; i < BULK_KEYS; i++)
+		keys[i] = i * 2654435761u;
+
+	/* Every burst repeats its first key at its end */
+	for (i = 0; i < BULK_KEYS; i += n) {
+		n = RTE_MIN(BULK_KEYS - i, RTE_HASH_LOOKUP_BULK_MAX - 1u);
+		for (j = 0; j < n; j++) {
+			key_ptrs[j] = &keys[i + j];
+			data[j] = (void *)(uintptr_t)(i + j + 1);
+		}
+		key_ptrs[n] = &keys[i];
+		data[n] = (void *)(uintptr_t)(i + 1);
+
+		ret = rte_hash_add_bulk(handle, key_ptrs, n + 1, data, pos);
+		RETURN_IF_ERROR(ret < 0, "bulk add failed (%d)", ret);
+		for (j = 0, ok = 0; j < n; j++) {
+			if (pos[j] < 0) {
+				RETURN_IF_ERROR(pos[j] != -ENOSPC,
+					"bulk add of key %u failed (%d)",
+					i + j, pos[j]);
+				continue;
+			}
+			ok++;
+			RETURN_IF_ERROR(rte_hash_lookup(handle, &keys[i + j])
+					!= pos[j],
+					"wrong position for key %u", i + j);
+		}
+		RETURN_IF_ERROR(pos[n] != pos[0],
+				"duplicate key got a new position");
+		RETURN_IF_ERROR(ret != (int)ok + (pos[n] >= 0),
+				"bulk add reported %d keys", ret);
+		added += ok;
+	}
+
+	/* With ext buckets, all the keys up to the table size must fit */
+	RETURN_IF_ERROR((extra_flag & RTE_HASH_EXTRA_FLAGS_EXT_TABLE) &&
+			added < BULK_ENTRIES,
+			"only %u keys added", added);
+	RETURN_IF_ERROR(rte_hash_count(handle) != (int32_t)added,
+			"table holds %d keys, %u added",
+			rte_hash_count(handle), added);
+
+	for (i = 0; i < BULK_KEYS; i++) {
+		ret = rte_hash_lookup_data(handle, &keys[i], &d);
+		RETURN_IF_ERROR(ret >= 0 && d != (void *)(uintptr_t)(i + 1),
+				"wrong data for key %u", i);
+	}
+
+	/* Delete every other key, the burst is found at most once */
+	for (i = 0; i < BULK_KEYS; i += n) {
+		n = RTE_MIN(BULK_KEYS - i, (unsigned int)RTE_HASH_LOOKUP_BULK_MAX);
+		for (j = 0; j < n; j++)
+			key_ptrs[j] = &keys[i + (j & ~1u)];
+		ret = rte_hash_del_bulk(handle, key_ptrs, n, pos);
+		RETURN_IF_ERROR(ret < 0, "bulk delete failed (%d)", ret);
+		for (j = 1; j < n; j += 2)
+			RETURN_IF_ERROR(pos[j] != -ENOENT,
+					"key %u deleted twice", i + j - 1);
+		for (j = 0; j < n; j += 2) {
+			ret = rte_hash_lookup(handle, &keys[i + j]);
+			RETURN_IF_ERROR(ret != -ENOENT,
+					"key %u still found", i + j);
+		}
+	}
+
+	for (i = 1; i < BULK_KEYS; i += 2) {
+		ret = rte_hash_lookup_data(handle, &keys[i], &d);
+		RETURN_IF_ERROR(ret >= 0 && d != (void *)(uintptr_t)(i + 1),
+				"lost data of key %u", i);
+	}
+
+	rte_hash_free(handle);
+	return 0;
+}
+
 /******************************************************************************/
 static int
 fbk_hash_unit_test(void)
@@ -1292,6 +1556,68 @@ fbk_hash_unit_test(void)
 	return 0;
 }
 
+#define FBK_BULK_ENTRIES	256
+#define FBK_BULK_KEYS		(2 * FBK_BULK_ENTRIES - 3)
+
+/*
+ * Fill a small fbk hash table past its capacity, delete a third of the
+ * keys, and check that bulk lookups find exactly the remaining keys.
+ */
+static int
+fbk_hash_bulk_test(uint32_t entries_per_bucket, uint32_t extra_flag)
+{
+	struct rte_fbk_hash_params params = {
+		.name = "fbk_hash_bulk_test",
+		.entries = FBK_BULK_ENTRIES,
+		.entries_per_bucket = entries_per_bucket,
+		.socket_id = 0,
+		.extra_flag = extra_flag,
+	};
+	struct rte_fbk_hash_table *handle;
+	uint32_t keys[FBK_BULK_KEYS];
+	int expected[FBK_BULK_KEYS];
+	int values[FBK_BULK_KEYS];
+	uint32_t i, hits = 0;
+	int status;
+
+	handle = rte_fbk_hash_create(&params);
+	RETURN_IF_ERROR_FBK(handle == NULL, "fbk hash creation failed");
+
+	for (i = 0; i < FBK_BULK_KEYS; i++) {
+		keys[i] = rte_rand();
+		status = rte_fbk_hash_add_key(handle, keys[i], i);
+		expected[i] = status == 0 ? (int)i : -ENOENT;
+	}
+
+	/* Delete keys from the middle of the buckets too. */
+	for (i = 0; i < FBK_BULK_KEYS; i += 3) {
+		if (expected[i] < 0)
+			continue;
+		status = rte_fbk_hash_delete_key(handle, keys[i]);
+		RETURN_IF_ERROR_FBK(status != 0, "fbk hash delete failed");
+		expected[i] = -ENOENT;
+	}
+
+	for (i = 0; i < FBK_BULK_KEYS; i++)
+		hits += expected[i] >= 0;
+
+	status = rte_fbk_hash_lookup_bulk(handle, keys, values, FBK_BULK_KEYS);
+	RETURN_IF_ERROR_FBK((uint32_t)status != hits,
+			"fbk hash bulk lookup found %d keys instead of %u",
+			status, hits);
+	for (i = 0; i < FBK_BULK_KEYS; i++) {
+		RETURN_IF_ERROR_FBK(values[i] != expected[i],
+				"fbk hash bulk lookup of key %u returned %d",
+				i, values[i]);
+		RETURN_IF_ERROR_FBK(rte_fbk_hash_lookup(handle, keys[i]) !=
+				expected[i], "fbk hash lookup of key %u failed",
+				i);
+	}
+
+	rte_fbk_hash_free(handle);
+	return 0;
+}
+
 /*
  * Sequence of operations for find existing fbk hash table
  *
@@ -1593,6 +1919,114 @@ static int test_hash_iteration(uint32_t ext_table)
 	return -1;
 }
 
+#define ITER_RANGES	3
+#define ITER_BURST	5
+
+/*
+ * Iterate through a table split in bucket ranges, in bursts: each key is
+ * returned once, by a single range.
+ */
+static int test_hash_iteration_range(uint32_t ext_table)
+{
+	struct rte_hash *handle;
+	unsigned int i, r;
+	uint8_t keys[NUM_ENTRIES][MAX_KEYSIZE];
+	void *data[NUM_ENTRIES];
+	int32_t pos[NUM_ENTRIES];
+	uint8_t seen[NUM_ENTRIES];
+	const void *it_keys[ITER_BURST];
+	void *it_data[ITER_BURST];
+	int32_t it_pos[ITER_BURST];
+	const void *next_key;
+	void *next_data;
+	unsigned int added_keys, found_keys = 0;
+	uint32_t nb_buckets, start, end, iter, cnt;
+	int ret;
+
+	ut_params.entries = NUM_ENTRIES;
+	ut_params.name = "test_hash_iteration_range";
+	ut_params.hash_func = rte_jhash;
+	ut_params.key_len = 16;
+	if (ext_table)
+		ut_params.extra_flag |= RTE_HASH_EXTRA_FLAGS_EXT_TABLE;
+	else
+		ut_params.extra_flag &= ~RTE_HASH_EXTRA_FLAGS_EXT_TABLE;
+
+	handle = rte_hash_create(&ut_params);
+	RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+
+	for (added_keys = 0; added_keys < NUM_ENTRIES; added_keys++) {
+		data[added_keys] = (void *) ((uintptr_t) rte_rand());
+		for (i = 0; i < ut_params.key_len; i++)
+			keys[added_keys][i] = rte_rand() % 255;
+		ret = rte_hash_add_key_data(handle, keys[added_keys],
+					    data[added_keys]);
+		if (ret < 0)
+			break;
+		pos[added_keys] = rte_hash_lookup(handle, keys[added_keys]);
+	}
+	memset(seen, 0, sizeof(seen));
+
+	nb_buckets = rte_hash_iterate_bucket_count(handle);
+	if (nb_buckets != (ext_table ? 2 : 1) *
+			(uint32_t)rte_hash_bucket_count(handle)) {
+		printf("Unexpected number of buckets to iterate %u\n",
+		       nb_buckets);
+		goto err;
+	}
+
+	for (r = 0; r < ITER_RANGES; r++) {
+		start = nb_buckets * r / ITER_RANGES;
+		end = nb_buckets * (r + 1) / ITER_RANGES;
+
+		/* one key at a time, counting the keys of the range */
+		for (iter = 0, cnt = 0; rte_hash_iterate_range(handle, start,
+				end, &next_key, &next_data, &iter) >= 0; )
+			cnt++;
+
+		iter = 0;
+		while ((ret = rte_hash_iterate_range_bulk(handle, start, end,
+				it_keys, it_data, it_pos, ITER_BURST,
+				&iter)) > 0) {
+			for (i = 0; i < (unsigned int)ret; i++) {
+				unsigned int k;
+
+				for (k = 0; k < added_keys; k++)
+					if (pos[k] == it_pos[i])
+						break;
+				if (k == added_keys || seen[k] ||
+				    it_data[i] != data[k] ||
+				    memcmp(it_keys[i], keys[k],
+					   ut_params.key_len) != 0) {
+					printf("Unexpected key at position "
+					       "%d\n", it_pos[i]);
+					goto err;
+				}
+				seen[k] = 1;
+			}
+			found_keys += ret;
+			cnt -= ret;
+		}
+		if (ret < 0 || cnt != 0) {
+			printf("Range %u iterated differently in bulk\n", r);
+			goto err;
+		}
+	}
+
+	if (found_keys != added_keys) {
+		printf("Iterated %u keys instead of %u\n", found_keys,
+		       added_keys);
+		goto err;
+	}
+
+	rte_hash_free(handle);
+	return 0;
+
+err:
+	rte_hash_free(handle);
+	return -1;
+}
+
 static uint8_t key[16] = {0x00, 0x01, 0x02, 0x03,
 			0x04, 0x05, 0x06, 0x07,
 			0x08, 0x09, 0x0a, 0x0b,
@@ -2208,11 +2642,34 @@ test_hash(void)
 		return -1;
 	if (test_extendable_bucket() < 0)
 		return -1;
+	if (test_resizable_table(0) < 0)
+		return -1;
+	if (test_resizable_table(1) < 0)
+		return -1;
+	if (test_bulk_add_delete(0) < 0)
+		return -1;
+	if (test_bulk_add_delete(RTE_HASH_EXTRA_FLAGS_EXT_TABLE) < 0)
+		return -1;
+	if (test_bulk_add_delete(RTE_HASH_EXTRA_FLAGS_KEY_SLOT_ALIGN) < 0)
+		return -1;
+	if (test_bulk_add_delete(RTE_HASH_EXTRA_FLAGS_EXT_TABLE |
+				 RTE_HASH_EXTRA_FLAGS_MULTI_WRITER_ADD) < 0)
+		return -1;
 
 	if (test_fbk_hash_find_existing() < 0)
 		return -1;
 	if (fbk_hash_unit_test() < 0)
 		return -1;
+	if (fbk_hash_bulk_test(1, 0) < 0)
+		return -1;
+	if (fbk_hash_bulk_test(4, 0) < 0)
+		return -1;
+	if (fbk_hash_bulk_test(4,
+			RTE_FBK_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF) < 0)
+		return -1;
+	if (fbk_hash_bulk_test(16,
+			RTE_FBK_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF) < 0)
+		return -1;
 	if (test_hash_creation_with_bad_parameters() < 0)
 		return -1;
 	if (test_hash_creation_with_good_parameters() < 0)
@@ -2223,12 +2680,16 @@ test_hash(void)
 		return -1;
 	if (test_hash_iteration(0) < 0)
 		return -1;
+	if (test_hash_iteration_range(0) < 0)
+		return -1;
 
 	/* ext table enabled */
 	if (test_average_table_utilization(1) < 0)
 		return -1;
 	if (test_hash_iteration(1) < 0)
 		return -1;
+	if (test_hash_iteration_range(1) < 0)
+		return -1;
 
 	run_hash_func_tests();
 
@@ -641,6 +641,7 @@ run_all_tbl_perf_tests(unsigned int with_pushes, unsigned int with_locks,
 #define TEST_SIZE 1000000	/* How many operations to time. */
 #define TEST_ITERATIONS 30	/* How many measurements to take. */
 #define ENTRIES (1 << 15)	/* How many entries. */
+#define FBK_BURST 32		/* How many keys per bulk lookup. */
 
 static int
 fbk_hash_perf_test(void)
@@ -654,7 +655,10 @@ fbk_hash_perf_test(void)
 	struct rte_fbk_hash_table *handle = NULL;
 	uint32_t *keys = NULL;
 	unsigned indexes[TEST_SIZE];
+	uint32_t burst_keys[FBK_BURST];
+	int burst_values[FBK_BURST];
 	uint64_t lookup_time = 0;
+	uint64_t bulk_lookup_time = 0;
 	unsigned added = 0;
 	unsigned value = 0;
 	uint32_t key;
@@ -702,6 +706,21 @@ fbk_hash_perf_test(void)
 
 		end = rte_rdtsc();
 		lookup_time += (double)(end - begin);
+
+		/* Do bulk lookups of the same keys */
+		begin = rte_rdtsc();
+		for (j = 0; j < TEST_SIZE; j += FBK_BURST) {
+			unsigned int k, n = RTE_MIN(TEST_SIZE - j, (unsigned int)FBK_BURST);
+
+			for (k = 0; k < n; k++)
+				burst_keys[k] = keys[indexes[j + k]];
+			rte_fbk_hash_lookup_bulk(handle, burst_keys,
+						 burst_values, n);
+			for (k = 0; k < n; k++)
+				value += burst_values[k];
+		}
+		end = rte_rdtsc();
+		bulk_lookup_time += end - begin;
 	}
 
 	printf("\n\n *** FBK Hash function performance test results ***\n");
@@ -709,10 +728,14 @@ fbk_hash_perf_test(void)
 	 * The use of the 'value' variable ensures that the hash lookup is not
 	 * being optimised out by the compiler.
 	 */
-	if (value != 0)
+	if (value != 0) {
 		printf("Number of ticks per lookup = %g\n",
 			(double)lookup_time /
 			((double)TEST_ITERATIONS * (double)TEST_SIZE));
+		printf("Number of ticks per bulk lookup = %g\n",
+			(double)bulk_lookup_time /
+			((double)TEST_ITERATIONS * (double)TEST_SIZE));
+	}
 
 	rte_fbk_hash_free(handle);
 
@@ -238,6 +238,238 @@ test_ip_frag(void)
 	return result;
 }
 
+/* Compare two fragments byte by byte */
+static int
+test_frag_cmp(const struct rte_mbuf *a, const struct rte_mbuf *b)
+{
+	uint8_t buf_a[RTE_MBUF_DEFAULT_BUF_SIZE], buf_b[RTE_MBUF_DEFAULT_BUF_SIZE];
+	const void *da, *db;
+
+	if (a->pkt_len != b->pkt_len || a->nb_segs != b->nb_segs ||
+			a->l3_len != b->l3_len)
+		return -1;
+
+	da = rte_pktmbuf_read(a, 0, a->pkt_len, buf_a);
+	db = rte_pktmbuf_read(b, 0, b->pkt_len, buf_b);
+	if (da == NULL || db == NULL)
+		return -1;
+
+	return memcmp(da, db, a->pkt_len);
+}
+
+/*
+ * Fragment single and chained packets with and without bulk allocation,
+ * the fragments must be the same.
+ */
+static int
+test_ip_frag_bulk_alloc(void)
+{
+	struct rte_mbuf *pkts_ref[BURST], *pkts_out[BURST];
+	size_t i;
+	int32_t j;
+
+	struct test_ip_frags {
+		int      ipv;
+		size_t   mtu_size;
+		size_t   pkt_size;
+		size_t   split;
+		int      expected_frags;
+	} tests[] = {
+		     {4, 1280, 1400,   0, 2},
+		     {4,  600, 1400,   0, 3},
+		     {4,  576,  100,   0, 1},
+		     {4,  600, 1400, 700, 3},
+		     {4,  600, 1400, 572, 3},
+		     {4,    4, 1400,   0, -EINVAL},
+
+		     {6, 1280, 1400,   0, 2},
+		     {6, 1300,  100,   0, 1},
+		     {6, 1280, 1400, 900, 2},
+		     {6, 1280, 1400, 1272, 2},
+		     {6,    4, 1400,   0, -EINVAL},
+	};
+
+	for (i = 0; i < RTE_DIM(tests); i++) {
+		int32_t len, len_ref;
+		struct rte_mbuf *b = rte_pktmbuf_alloc(pkt_pool);
+
+		RTE_TEST_ASSERT_NOT_EQUAL(b, NULL,
+					  "Failed to allocate pkt.");
+
+		if (tests[i].ipv == 4)
+			v4_allocate_packet_of(b, 0x41414141, tests[i].pkt_size,
+					      0, 64, IPPROTO_ICMP, i);
+		else
+			v6_allocate_packet_of(b, 0x41414141, tests[i].pkt_size,
+					      64, IPPROTO_ICMP, i);
+
+		/* Move the end of the packet to a second segment */
+		if (tests[i].split != 0) {
+			struct rte_mbuf *s = rte_pktmbuf_alloc(pkt_pool);
+			uint16_t tail = b->data_len - tests[i].split;
+
+			RTE_TEST_ASSERT_NOT_EQUAL(s, NULL,
+						  "Failed to allocate pkt.");
+			memcpy(rte_pktmbuf_append(s, tail),
+			       rte_pktmbuf_mtod_offset(b, char *,
+						       tests[i].split), tail);
+			rte_pktmbuf_trim(b, tail);
+			RTE_TEST_ASSERT_EQUAL(rte_pktmbuf_chain(b, s), 0,
+					      "Failed to chain pkt.");
+		}
+
+		if (tests[i].ipv == 4) {
+			len_ref = rte_ipv4_fragment_packet(b, pkts_ref, BURST,
+					tests[i].mtu_size, direct_pool,
+					indirect_pool);
+			len = rte_ipv4_fragment_packet_bulk_alloc(b, pkts_out,
+					BURST, tests[i].mtu_size, direct_pool,
+					indirect_pool);
+		} else {
+			len_ref = rte_ipv6_fragment_packet(b, pkts_ref, BURST,
+					tests[i].mtu_size, direct_pool,
+					indirect_pool);
+			len = rte_ipv6_fragment_packet_bulk_alloc(b, pkts_out,
+					BURST, tests[i].mtu_size, direct_pool,
+					indirect_pool);
+		}
+
+		rte_pktmbuf_free(b);
+
+		printf("%zd: checking %d with %d\n", i, len,
+		       tests[i].expected_frags);
+		RTE_TEST_ASSERT_EQUAL(len_ref, tests[i].expected_frags,
+				      "Failed case %zd.\n", i);
+		RTE_TEST_ASSERT_EQUAL(len, tests[i].expected_frags,
+				      "Failed case %zd.\n", i);
+
+		for (j = 0; j < len; j++)
+			RTE_TEST_ASSERT_EQUAL(test_frag_cmp(pkts_ref[j],
+					pkts_out[j]), 0,
+					"Failed case %zd, fragment %d.\n",
+					i, j);
+
+		if (len > 0) {
+			test_free_fragments(pkts_ref, len);
+			test_free_fragments(pkts_out, len);
+		}
+	}
+
+	/* All the buffers must have been given back */
+	RTE_TEST_ASSERT_EQUAL(rte_mempool_in_use_count(direct_pool), 0,
+			      "Direct buffers leaked.\n");
+	RTE_TEST_ASSERT_EQUAL(rte_mempool_in_use_count(indirect_pool), 0,
+			      "Indirect buffers leaked.\n");
+
+	return TEST_SUCCESS;
+}
+
+static int
+test_ip_frag_reassemble_bulk(void)
+{
+	struct rte_ip_frag_death_row dr = { .cnt = 0 };
+	struct rte_mbuf *pkts[BURST], *pkts_out[BURST], *b;
+	struct rte_ip_frag_tbl *tbl;
+	uint32_t i, j, hdr_len, nb_pkts;
+	uint16_t nb_out;
+	int32_t len;
+	int ipv;
+
+	tbl = rte_ip_frag_table_create(64, 4, 256, rte_get_tsc_hz(),
+				       SOCKET_ID_ANY);
+	RTE_TEST_ASSERT_NOT_EQUAL(tbl, NULL, "Failed to create frag table.");
+
+	for (ipv = 4; ipv <= 6; ipv += 2) {
+		nb_pkts = 0;
+
+		/* fragment three packets */
+		for (i = 0; i < 3; i++) {
+			b = rte_pktmbuf_alloc(pkt_pool);
+			RTE_TEST_ASSERT_NOT_EQUAL(b, NULL,
+						  "Failed to allocate pkt.");
+			if (ipv == 4) {
+				v4_allocate_packet_of(b, 0x41414141, 1400, 0,
+						      64, IPPROTO_ICMP, i);
+				len = rte_ipv4_fragment_packet(b,
+						&pkts[nb_pkts],
+						BURST - nb_pkts, 600,
+						direct_pool, indirect_pool);
+			} else {
+				v6_allocate_packet_of(b, 0x41414141, 1400,
+						      64, IPPROTO_ICMP, i);
+				len = rte_ipv6_fragment_packet(b,
+						&pkts[nb_pkts],
+						BURST - nb_pkts, 600,
+						direct_pool, indirect_pool);
+			}
+			rte_pktmbuf_free(b);
+			RTE_TEST_ASSERT(len > 1, "Failed to fragment pkt.");
+
+			/* IPv6 fragments all get the null id */
+			for (j = nb_pkts; ipv == 6 && j < nb_pkts + len; j++) {
+				struct rte_ipv6_hdr *hdr = rte_pktmbuf_mtod(
+					pkts[j], struct rte_ipv6_hdr *);
+				rte_ipv6_frag_get_ipv6_fragment_header(hdr)->id =
+					rte_cpu_to_be_32(i);
+			}
+			nb_pkts += len;
+		}
+
+		/* and add a packet which is not fragmented */
+		b = rte_pktmbuf_alloc(pkt_pool);
+		RTE_TEST_ASSERT_NOT_EQUAL(b, NULL, "Failed to allocate pkt.");
+		if (ipv == 4)
+			v4_allocate_packet_of(b, 0x41414141, 100, 0, 64,
+					      IPPROTO_ICMP, 3);
+		else
+			v6_allocate_packet_of(b, 0x41414141, 100, 64,
+					      IPPROTO_ICMP, 3);
+		pkts[nb_pkts++] = b;
+
+		if (ipv == 4) {
+			hdr_len = sizeof(struct rte_ipv4_hdr);
+			for (i = 0; i < nb_pkts; i++)
+				pkts[i]->l3_len = hdr_len;
+		} else {
+			hdr_len = sizeof(struct rte_ipv6_hdr);
+			for (i = 0; i < nb_pkts - 1; i++)
+				pkts[i]->l3_len = hdr_len +
+					sizeof(struct ipv6_extension_fragment);
+			b->l3_len = hdr_len;
+		}
+
+		/* last fragments first, to hit the out of order path */
+		for (i = 0; i < nb_pkts / 2; i++) {
+			b = pkts[i];
+			pkts[i] = pkts[nb_pkts - 1 - i];
+			pkts[nb_pkts - 1 - i] = b;
+		}
+		b = pkts[0];
+
+		if (ipv == 4)
+			nb_out = rte_ipv4_frag_reassemble_bulk(tbl, &dr, pkts,
+					nb_pkts, rte_rdtsc(), pkts_out);
+		else
+			nb_out = rte_ipv6_frag_reassemble_bulk(tbl, &dr, pkts,
+					nb_pkts, rte_rdtsc(), pkts_out);
+
+		printf("IPv%d: reassembled %u packets out of %u\n", ipv,
+		       nb_out, nb_pkts);
+		RTE_TEST_ASSERT_EQUAL(nb_out, 4, "Failed bulk reassembly.");
+		RTE_TEST_ASSERT_EQUAL(dr.cnt, 0, "Unexpected dropped mbufs.");
+		for (i = 0; i < nb_out; i++)
+			RTE_TEST_ASSERT(pkts_out[i]->pkt_len == 1400 + hdr_len ||
+					pkts_out[i] == b,
+					"Wrong reassembled length %u.",
+					pkts_out[i]->pkt_len);
+
+		test_free_fragments(pkts_out, nb_out);
+	}
+
+	rte_ip_frag_table_destroy(tbl);
+	return TEST_SUCCESS;
+}
+
 static struct unit_test_suite ipfrag_testsuite  = {
 	.suite_name = "IP Frag Unit Test Suite",
 	.setup = testsuite_setup,
@@ -245,6 +477,10 @@ static struct unit_test_suite ipfrag_testsuite  = {
 	.unit_test_cases = {
 		TEST_CASE_ST(ut_setup, ut_teardown,
 			     test_ip_frag),
+		TEST_CASE_ST(ut_setup, ut_teardown,
+			     test_ip_frag_bulk_alloc),
+		TEST_CASE_ST(ut_setup, ut_teardown,
+			     test_ip_frag_reassemble_bulk),
 
 		TEST_CASES_END() /**< NULL terminate unit test array */
 	}
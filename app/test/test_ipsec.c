@@ -947,6 +947,78 @@ crypto_ipsec_2sa(void)
 	return TEST_SUCCESS;
 }
 
+static int
+crypto_ipsec_2sa_bulk(void)
+{
+	struct ipsec_testsuite_params *ts_params = &testsuite_params;
+	struct ipsec_unitest_params *ut_params = &unittest_params;
+	struct rte_ipsec_session *ss[BURST_SIZE];
+	struct rte_ipsec_group grp[BURST_SIZE];
+	struct rte_mbuf *m[BURST_SIZE];
+	uint32_t k, ng, i, j;
+
+	for (i = 0; i < BURST_SIZE; i++) {
+		ss[i] = &ut_params->ss[i % 2];
+		m[i] = ut_params->ibuf[i];
+	}
+
+	/* call crypto prepare for the whole burst */
+	ng = rte_ipsec_pkt_crypto_prepare_bulk(ss, ut_params->ibuf,
+		ut_params->cop, grp, BURST_SIZE);
+	if (ng != 2 || grp[0].id.ptr != &ut_params->ss[0] ||
+			grp[1].id.ptr != &ut_params->ss[1]) {
+		RTE_LOG(ERR, USER1,
+			"rte_ipsec_pkt_crypto_prepare_bulk fail ng=%d\n", ng);
+		return TEST_FAILED;
+	}
+
+	/* each group keeps the order of its packets */
+	for (i = 0; i != ng; i++) {
+		if (grp[i].cnt != BURST_SIZE / 2 || grp[i].rc != 0) {
+			RTE_LOG(ERR, USER1,
+				"rte_ipsec_pkt_crypto_prepare_bulk fail "
+				"grp[%d].cnt=%d\n", i, grp[i].cnt);
+			return TEST_FAILED;
+		}
+		for (j = 0; j != grp[i].cnt; j++) {
+			if (grp[i].m[j] != m[2 * j + i]) {
+				RTE_LOG(ERR, USER1,
+					"grp[%d] packets reordered\n", i);
+				return TEST_FAILED;
+			}
+		}
+	}
+
+	k = rte_cryptodev_enqueue_burst(ts_params->valid_dev, 0,
+		ut_params->cop, BURST_SIZE);
+	if (k != BURST_SIZE) {
+		RTE_LOG(ERR, USER1, "rte_cryptodev_enqueue_burst fail\n");
+		return TEST_FAILED;
+	}
+
+	if (crypto_dequeue_burst(BURST_SIZE) == TEST_FAILED)
+		return TEST_FAILED;
+
+	ng = rte_ipsec_pkt_crypto_group(
+		(const struct rte_crypto_op **)(uintptr_t)ut_params->cop,
+		ut_params->obuf, grp, BURST_SIZE);
+	if (ng != 2) {
+		RTE_LOG(ERR, USER1, "rte_ipsec_pkt_crypto_group fail ng=%d\n",
+			ng);
+		return TEST_FAILED;
+	}
+
+	/* call crypto process for all the groups */
+	k = rte_ipsec_pkt_process_bulk(grp, ng);
+	if (k != BURST_SIZE) {
+		RTE_LOG(ERR, USER1, "rte_ipsec_pkt_process_bulk fail k=%d\n",
+			k);
+		return TEST_FAILED;
+	}
+
+	return TEST_SUCCESS;
+}
+
 #define PKT_4	4
 #define PKT_12	12
 #define PKT_21	21
@@ -2407,6 +2479,92 @@ test_ipsec_crypto_inb_burst_2sa_null_null_wrapper(void)
 	return rc;
 }
 
+static int
+test_ipsec_crypto_inb_burst_2sa_bulk_null_null(int i)
+{
+	struct ipsec_testsuite_params *ts_params = &testsuite_params;
+	struct ipsec_unitest_params *ut_params = &unittest_params;
+	uint16_t num_pkts = test_cfg[i].num_pkts;
+	uint16_t j, r;
+	int rc = 0;
+
+	if (num_pkts != BURST_SIZE)
+		return rc;
+
+	/* create rte_ipsec_sa */
+	rc = create_sa(RTE_SECURITY_ACTION_TYPE_NONE,
+			test_cfg[i].replay_win_sz, test_cfg[i].flags, 0);
+	if (rc != 0) {
+		RTE_LOG(ERR, USER1, "create_sa 0 failed, cfg %d\n", i);
+		return rc;
+	}
+
+	/* create second rte_ipsec_sa */
+	ut_params->ipsec_xform.spi = INBOUND_SPI + 1;
+	rc = create_sa(RTE_SECURITY_ACTION_TYPE_NONE,
+			test_cfg[i].replay_win_sz, test_cfg[i].flags, 1);
+	if (rc != 0) {
+		RTE_LOG(ERR, USER1, "create_sa 1 failed, cfg %d\n", i);
+		destroy_sa(0);
+		return rc;
+	}
+
+	/* Generate test mbuf data, interleaving the two SAs */
+	for (j = 0; j < num_pkts && rc == 0; j++) {
+		r = j % 2;
+		/* packet with sequence number 0 is invalid */
+		ut_params->ibuf[j] = setup_test_string_tunneled(
+			ts_params->mbuf_pool, null_encrypted_data,
+			test_cfg[i].pkt_sz, INBOUND_SPI + r, j + 1);
+		if (ut_params->ibuf[j] == NULL)
+			rc = TEST_FAILED;
+	}
+
+	if (rc == 0)
+		rc = test_ipsec_crypto_op_alloc(num_pkts);
+
+	if (rc == 0) {
+		/* call ipsec library api */
+		rc = crypto_ipsec_2sa_bulk();
+		if (rc == 0)
+			rc = crypto_inb_burst_2sa_null_null_check(
+					ut_params, i);
+		else {
+			RTE_LOG(ERR, USER1, "crypto_ipsec failed, cfg %d\n",
+				i);
+			rc = TEST_FAILED;
+		}
+	}
+
+	if (rc == TEST_FAILED)
+		test_ipsec_dump_buffers(ut_params, i);
+
+	destroy_sa(0);
+	destroy_sa(1);
+	return rc;
+}
+
+static int
+test_ipsec_crypto_inb_burst_2sa_bulk_null_null_wrapper(void)
+{
+	int i;
+	int rc = 0;
+	struct ipsec_unitest_params *ut_params = &unittest_params;
+
+	ut_params->ipsec_xform.spi = INBOUND_SPI;
+	ut_params->ipsec_xform.direction = RTE_SECURITY_IPSEC_SA_DIR_INGRESS;
+	ut_params->ipsec_xform.proto = RTE_SECURITY_IPSEC_SA_PROTO_ESP;
+	ut_params->ipsec_xform.mode = RTE_SECURITY_IPSEC_SA_MODE_TUNNEL;
+	ut_params->ipsec_xform.tunnel.type = RTE_SECURITY_IPSEC_TUNNEL_IPV4;
+
+	for (i = 0; i < num_cfg && rc == 0; i++) {
+		ut_params->ipsec_xform.options.esn = test_cfg[i].esn;
+		rc = test_ipsec_crypto_inb_burst_2sa_bulk_null_null(i);
+	}
+
+	return rc;
+}
+
 static int
 test_ipsec_crypto_inb_burst_2sa_4grp_null_null(int i)
 {
@@ -2527,6 +2685,8 @@ static struct unit_test_suite ipsec_testsuite  = {
 			test_ipsec_crypto_inb_burst_2sa_null_null_wrapper),
 		TEST_CASE_ST(ut_setup_ipsec, ut_teardown_ipsec,
 			test_ipsec_crypto_inb_burst_2sa_4grp_null_null_wrapper),
+		TEST_CASE_ST(ut_setup_ipsec, ut_teardown_ipsec,
+			test_ipsec_crypto_inb_burst_2sa_bulk_null_null_wrapper),
 		TEST_CASES_END() /**< NULL terminate unit test array */
 	}
 };
@@ -0,0 +1,154 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include "test.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <rte_cycles.h>
+#include <rte_common.h>
+#include <rte_lcore.h>
+#include <rte_jobstats_sched.h>
+
+#define N_RUNS_MAX	16
+
+static uint32_t run_order[N_RUNS_MAX];
+static uint32_t n_runs;
+
+/* Job of a given cost, recording the order of the runs. */
+struct test_job {
+	uint32_t id;
+	uint64_t cost;
+};
+
+static int64_t
+test_job_cb(void *arg)
+{
+	struct test_job *tj = arg;
+	uint64_t end = rte_get_timer_cycles() + tj->cost;
+
+	while (rte_get_timer_cycles() < end)
+		;
+
+	if (n_runs < N_RUNS_MAX)
+		run_order[n_runs++] = tj->id;
+
+	return 0;
+}
+
+static int
+test_job_add(struct rte_jobstats_sched *sched, struct test_job *tj,
+		uint32_t priority, uint64_t period, uint64_t deadline)
+{
+	struct rte_jobstats_sched_job_params params = {
+		.name = "test",
+		.job_cb = test_job_cb,
+		.job_arg = tj,
+		.priority = priority,
+		.min_period = period,
+		.max_period = period,
+		.initial_period = period,
+		.deadline = deadline,
+		.target = 0,
+	};
+
+	return rte_jobstats_sched_job_add(sched, &params);
+}
+
+/* The due jobs run once per turn, by priority then by deadline. */
+static int
+test_sched_order(void)
+{
+	struct test_job tj[3] = { {0, 0}, {1, 0}, {2, 0} };
+	uint64_t hz = rte_get_timer_hz();
+	struct rte_jobstats_sched *sched;
+	uint32_t n;
+
+	sched = rte_jobstats_sched_create("test_order", SOCKET_ID_ANY);
+	TEST_ASSERT_NOT_NULL(sched, "Failed to create scheduler");
+
+	TEST_ASSERT(test_job_add(sched, &tj[0], 1, hz, 2 * hz) == 0,
+		    "Failed to add job 0");
+	TEST_ASSERT(test_job_add(sched, &tj[1], 1, hz, hz) == 1,
+		    "Failed to add job 1");
+	TEST_ASSERT(test_job_add(sched, &tj[2], 0, hz, 0) == 2,
+		    "Failed to add job 2");
+
+	n_runs = 0;
+	n = rte_jobstats_sched_run_once(sched);
+	TEST_ASSERT(n == 3, "%u jobs run instead of 3", n);
+	TEST_ASSERT(run_order[0] == 2 && run_order[1] == 1 &&
+		    run_order[2] == 0, "Unexpected job order %u %u %u",
+		    run_order[0], run_order[1], run_order[2]);
+
+	/* None of the jobs is due before its period expires. */
+	n = rte_jobstats_sched_run_once(sched);
+	TEST_ASSERT(n == 0, "%u jobs run before their period", n);
+
+	TEST_ASSERT(rte_jobstats_sched_job_get(sched, 2)->exec_cnt == 1,
+		    "Unexpected job execution count");
+	TEST_ASSERT_NULL(rte_jobstats_sched_job_get(sched, 3),
+			 "Unexpected job 3");
+
+	rte_jobstats_sched_free(sched);
+
+	return TEST_SUCCESS;
+}
+
+/* A job is deferred when it would make a job of higher priority late. */
+static int
+test_sched_deferral(void)
+{
+	uint64_t hz = rte_get_timer_hz();
+	struct test_job tj[2] = { {0, 0}, {1, hz / 100} };
+	struct rte_jobstats_sched_job_stats stats;
+	struct rte_jobstats_sched *sched;
+	uint64_t end;
+	uint32_t n;
+
+	sched = rte_jobstats_sched_create("test_deferral", SOCKET_ID_ANY);
+	TEST_ASSERT_NOT_NULL(sched, "Failed to create scheduler");
+
+	/* High priority job due every 5 ms, low priority job costing 10 ms
+	 * with a 1 s deadline.
+	 */
+	TEST_ASSERT(test_job_add(sched, &tj[0], 0, hz / 200, hz / 1000) == 0,
+		    "Failed to add job 0");
+	TEST_ASSERT(test_job_add(sched, &tj[1], 1, 0, hz) == 1,
+		    "Failed to add job 1");
+
+	/* The cost of the low priority job is unknown on the first turn. */
+	n_runs = 0;
+	n = rte_jobstats_sched_run_once(sched);
+	TEST_ASSERT(n == 2, "%u jobs run instead of 2", n);
+
+	/* Now the low priority job is deferred until its deadline. */
+	end = rte_get_timer_cycles() + hz / 2;
+	while (rte_get_timer_cycles() < end)
+		rte_jobstats_sched_run_once(sched);
+
+	TEST_ASSERT_SUCCESS(rte_jobstats_sched_job_stats_read(sched, 1, &stats),
+			    "Failed to read job stats");
+	TEST_ASSERT(stats.n_deferrals != 0, "Low priority job not deferred");
+	TEST_ASSERT(rte_jobstats_sched_job_get(sched, 1)->exec_cnt == 1,
+		    "Low priority job run before its deadline");
+
+	rte_jobstats_sched_free(sched);
+
+	return TEST_SUCCESS;
+}
+
+static int
+test_jobstats_sched(void)
+{
+	if (test_sched_order() != TEST_SUCCESS)
+		return TEST_FAILED;
+
+	if (test_sched_deferral() != TEST_SUCCESS)
+		return TEST_FAILED;
+
+	return TEST_SUCCESS;
+}
+
+REGISTER_TEST_COMMAND(jobstats_sched_autotest, test_jobstats_sched);
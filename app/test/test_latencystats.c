@@ -14,6 +14,7 @@
 #include "test.h"
 
 #define NUM_STATS 4
+#define NUM_STATS_HIST 7
 #define LATENCY_NUM_PACKETS 10
 #define QUEUE_ID 0
 
@@ -133,6 +134,48 @@ static int test_latencystats_get(void)
 	return TEST_SUCCESS;
 }
 
+/* Test case for latency init with histograms */
+static int test_latency_init_conf(void)
+{
+	struct rte_latencystats_conf conf = {
+		.samp_intvl = 1,
+		.flags = RTE_LATENCYSTATS_F_HIST,
+	};
+	struct rte_metric_value values[NUM_STATS_HIST];
+	int ret;
+
+	rte_metrics_init(rte_socket_id());
+
+	/* Failure Test: Invalid flags */
+	conf.flags = UINT32_MAX;
+	ret = rte_latencystats_init_conf(&conf);
+	TEST_ASSERT(ret == -EINVAL, "Test Failed: invalid flags accepted");
+
+	conf.flags = RTE_LATENCYSTATS_F_HIST;
+	ret = rte_latencystats_init_conf(&conf);
+	TEST_ASSERT(ret >= 0, "Test Failed: rte_latencystats_init_conf failed");
+
+	/* Percentiles are reported along the other stats */
+	ret = rte_latencystats_get_names(NULL, 0);
+	TEST_ASSERT(ret == NUM_STATS_HIST, "Test Failed to get the metrics "
+		    "count, Actual: %d Expected: %d", ret, NUM_STATS_HIST);
+
+	ret = rte_latencystats_update();
+	TEST_ASSERT(ret >= 0, "Test Failed: rte_latencystats_update failed");
+
+	ret = rte_latencystats_get(values, NUM_STATS_HIST);
+	TEST_ASSERT(ret == NUM_STATS_HIST, "Test Failed to get latency "
+		    "metrics values");
+
+	ret = rte_latencystats_uninit();
+	TEST_ASSERT(ret >= 0, "Test Failed: rte_latencystats_uninit failed");
+
+	ret = rte_metrics_deinit();
+	TEST_ASSERT(ret >= 0, "Test Failed: rte_metrics_deinit failed");
+
+	return TEST_SUCCESS;
+}
+
 static int test_latency_ring_setup(void)
 {
 	test_ring_setup(&ring, &portid);
@@ -197,6 +240,9 @@ unit_test_suite latencystats_testsuite = {
 		/* Test Case 5: To check uninit of latency test */
 		TEST_CASE_ST(NULL, NULL, test_latency_uninit),
 
+		/* Test Case 6: To check latency init with histograms */
+		TEST_CASE_ST(NULL, NULL, test_latency_init_conf),
+
 		TEST_CASES_END()
 	}
 };
@@ -0,0 +1,216 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <rte_launch.h>
+#include <rte_lcore_var.h>
+#include <rte_random.h>
+
+#include "test.h"
+
+#define MIN_LCORES 2
+
+RTE_LCORE_VAR_HANDLE(int, test_int);
+RTE_LCORE_VAR_INIT(test_int);
+
+struct int_checker_state {
+	int old_value;
+	int new_value;
+	bool success;
+};
+
+static void
+rand_blk(void *blk, size_t size)
+{
+	size_t i;
+
+	for (i = 0; i < size; i++)
+		((unsigned char *)blk)[i] = (unsigned char)rte_rand();
+}
+
+static bool
+is_ptr_aligned(const void *ptr, size_t align)
+{
+	return ptr != NULL ? (uintptr_t)ptr % align == 0 : false;
+}
+
+static int
+check_int(void *arg)
+{
+	struct int_checker_state *state = arg;
+
+	int *ptr = RTE_LCORE_VAR(test_int);
+
+	bool naturally_aligned = is_ptr_aligned(ptr, sizeof(int));
+
+	bool equal = *(RTE_LCORE_VAR(test_int)) == state->old_value;
+
+	state->success = equal && naturally_aligned;
+
+	*ptr = state->new_value;
+
+	return 0;
+}
+
+static int
+test_int_lvar(void)
+{
+	unsigned int lcore_id;
+
+	struct int_checker_state states[RTE_MAX_LCORE] = {};
+
+	RTE_LCORE_FOREACH_WORKER(lcore_id) {
+		struct int_checker_state *state = &states[lcore_id];
+
+		state->old_value = (int)rte_rand();
+		state->new_value = (int)rte_rand();
+
+		*RTE_LCORE_VAR_LCORE(lcore_id, test_int) = state->old_value;
+	}
+
+	RTE_LCORE_FOREACH_WORKER(lcore_id)
+		rte_eal_remote_launch(check_int, &states[lcore_id], lcore_id);
+
+	rte_eal_mp_wait_lcore();
+
+	RTE_LCORE_FOREACH_WORKER(lcore_id) {
+		struct int_checker_state *state = &states[lcore_id];
+		int value;
+
+		TEST_ASSERT(state->success,
+			"Unexpected value encountered on lcore %u", lcore_id);
+
+		value = *RTE_LCORE_VAR_LCORE(lcore_id, test_int);
+		TEST_ASSERT_EQUAL(state->new_value, value,
+			"Lcore %u failed to update int", lcore_id);
+	}
+
+	/* take the opportunity to test the foreach macro */
+	int *v;
+	unsigned int i = 0;
+	RTE_LCORE_VAR_FOREACH(lcore_id, v, test_int) {
+		TEST_ASSERT_EQUAL(i, lcore_id,
+			"Encountered lcore id %u while expecting %u",
+			lcore_id, i);
+		if (rte_lcore_is_enabled(lcore_id) &&
+				lcore_id != rte_get_main_lcore())
+			TEST_ASSERT_EQUAL(states[lcore_id].new_value, *v,
+				"Unexpected value on lcore %u", lcore_id);
+		i++;
+	}
+
+	return TEST_SUCCESS;
+}
+
+static int
+test_sized_alignment(void)
+{
+	unsigned int lcore_id;
+	long *v;
+
+	RTE_LCORE_VAR_HANDLE(long, handle);
+	RTE_LCORE_VAR_ALLOC_SIZE_ALIGN(handle, sizeof(long), 32);
+
+	RTE_LCORE_VAR_FOREACH(lcore_id, v, handle) {
+		TEST_ASSERT(is_ptr_aligned(v, 32), "Value not 32-byte aligned");
+		TEST_ASSERT_EQUAL(*v, 0, "Value not zeroed");
+	}
+
+	return TEST_SUCCESS;
+}
+
+/* private, larger, struct */
+#define TEST_STRUCT_DATA_SIZE 1234
+
+struct noncopyable_state {
+	char data[TEST_STRUCT_DATA_SIZE];
+};
+
+static RTE_LCORE_VAR_HANDLE(struct noncopyable_state, noncopyable_handles[2]);
+
+static int
+test_struct_lvar(void)
+{
+	struct noncopyable_state *v;
+	unsigned int lcore_id;
+	char data[TEST_STRUCT_DATA_SIZE];
+
+	RTE_LCORE_VAR_ALLOC(noncopyable_handles[0]);
+	RTE_LCORE_VAR_ALLOC(noncopyable_handles[1]);
+
+	/* the two variables of an lcore must not overlap */
+	RTE_LCORE_VAR_FOREACH(lcore_id, v, noncopyable_handles[0]) {
+		rand_blk(data, sizeof(data));
+		memcpy(v->data, data, sizeof(data));
+		memset(RTE_LCORE_VAR_LCORE(lcore_id,
+				noncopyable_handles[1])->data, 0,
+			sizeof(data));
+		TEST_ASSERT(memcmp(v->data, data, sizeof(data)) == 0,
+			"Lcore variables of lcore %u overlap", lcore_id);
+	}
+
+	return TEST_SUCCESS;
+}
+
+#define TEST_ALLOC_SIZE 4096
+
+/* allocate more than one buffer worth of variables */
+#define TEST_ALLOC_NUM (2 * (RTE_MAX_LCORE_VAR / TEST_ALLOC_SIZE))
+
+static int
+test_many_lvars(void)
+{
+	void **handlers = malloc(sizeof(void *) * TEST_ALLOC_NUM);
+	unsigned int i;
+
+	TEST_ASSERT_NOT_NULL(handlers, "Unable to allocate memory");
+
+	for (i = 0; i < TEST_ALLOC_NUM; i++) {
+		unsigned int lcore_id;
+		void *v;
+
+		RTE_LCORE_VAR_ALLOC_SIZE(handlers[i], TEST_ALLOC_SIZE);
+
+		RTE_LCORE_VAR_FOREACH(lcore_id, v, handlers[i]) {
+			TEST_ASSERT(((char *)v)[0] == 0 &&
+				((char *)v)[TEST_ALLOC_SIZE - 1] == 0,
+				"Value not zeroed");
+			memset(v, 0xff, TEST_ALLOC_SIZE);
+		}
+	}
+
+	free(handlers);
+
+	return TEST_SUCCESS;
+}
+
+static struct unit_test_suite lcore_var_testsuite = {
+	.suite_name = "lcore variable autotest",
+	.unit_test_cases = {
+		TEST_CASE(test_int_lvar),
+		TEST_CASE(test_sized_alignment),
+		TEST_CASE(test_struct_lvar),
+		TEST_CASE(test_many_lvars),
+		TEST_CASES_END()
+	},
+};
+
+static int
+test_lcore_var(void)
+{
+	if (rte_lcore_count() < MIN_LCORES) {
+		printf("Not enough cores for lcore_var_autotest, "
+			"expecting at least %d\n", MIN_LCORES);
+		return TEST_SKIPPED;
+	}
+
+	return unit_test_suite_runner(&lcore_var_testsuite);
+}
+
+REGISTER_TEST_COMMAND(lcore_var_autotest, test_lcore_var);
@@ -6,6 +6,7 @@
 #include <string.h>
 
 #include <rte_common.h>
+#include <rte_cycles.h>
 #include <rte_errno.h>
 #include <rte_lcore.h>
 
@@ -340,6 +341,129 @@ test_non_eal_lcores_callback(unsigned int eal_threads_count)
 	return -1;
 }
 
+static int
+test_lcores_topology(void)
+{
+	enum rte_lcore_domain domain;
+	unsigned int i, j;
+	int id;
+
+	if (rte_lcore_domain_id(RTE_MAX_LCORE, RTE_LCORE_DOMAIN_CORE) != -1 ||
+			rte_errno != EINVAL) {
+		printf("Error: domain of invalid lcore\n");
+		return -1;
+	}
+	if (rte_lcore_domain_id(rte_get_main_lcore(),
+			RTE_LCORE_DOMAIN_MAX) != -1 || rte_errno != EINVAL) {
+		printf("Error: invalid domain type\n");
+		return -1;
+	}
+
+	RTE_LCORE_FOREACH(i) {
+		/* A known domain is shared by the lcore with itself. */
+		domain = rte_lcore_shared_domain(i, i);
+		for (j = 0; j < domain; j++) {
+			if (rte_lcore_domain_id(i, j) >= 0) {
+				printf("Error: lcore %u does not share domain %u with itself\n",
+					i, j);
+				return -1;
+			}
+		}
+		id = rte_lcore_domain_id(i, RTE_LCORE_DOMAIN_NUMA);
+		if (id >= 0 && (unsigned int)id != rte_lcore_to_socket_id(i)) {
+			printf("Error: lcore %u NUMA domain %d, socket %u\n",
+				i, id, rte_lcore_to_socket_id(i));
+			return -1;
+		}
+		RTE_LCORE_FOREACH(j) {
+			domain = rte_lcore_shared_domain(i, j);
+			if (domain != rte_lcore_shared_domain(j, i)) {
+				printf("Error: lcores %u and %u share different domains\n",
+					i, j);
+				return -1;
+			}
+			if (domain < RTE_LCORE_DOMAIN_MAX &&
+					rte_lcore_domain_id(i, domain) !=
+					rte_lcore_domain_id(j, domain)) {
+				printf("Error: lcores %u and %u do not share domain %u\n",
+					i, j, domain);
+				return -1;
+			}
+		}
+	}
+
+	return 0;
+}
+
+static int
+test_usage_cb(unsigned int lcore_id, struct rte_lcore_usage *usage)
+{
+	if (lcore_id != rte_get_main_lcore())
+		return -1;
+	usage->total_cycles = 100;
+	usage->busy_cycles = 42;
+	return 0;
+}
+
+static int
+test_lcores_usage(void)
+{
+	unsigned int lcore_id = rte_lcore_id();
+	struct rte_lcore_usage u0, u1, u2;
+
+	if (rte_lcore_usage_get(RTE_MAX_LCORE, &u0) != -EINVAL) {
+		printf("Error: usage of invalid lcore\n");
+		return -1;
+	}
+
+	/* Start the accounting, then close an idle interval. */
+	rte_lcore_usage_poll(0);
+	rte_delay_us_block(100);
+	rte_lcore_usage_poll(1);
+	if (rte_lcore_usage_get(lcore_id, &u0) != 0) {
+		printf("Error: no usage accounted for lcore %u\n", lcore_id);
+		return -1;
+	}
+
+	/* The interval after a busy poll is busy. */
+	rte_delay_us_block(100);
+	rte_lcore_usage_poll(0);
+	rte_lcore_usage_get(lcore_id, &u1);
+	if (u1.total_cycles <= u0.total_cycles ||
+			u1.busy_cycles - u0.busy_cycles !=
+			u1.total_cycles - u0.total_cycles) {
+		printf("Error: busy interval not accounted as busy\n");
+		return -1;
+	}
+
+	/* The interval after an idle poll is idle. */
+	rte_delay_us_block(100);
+	rte_lcore_usage_poll(0);
+	rte_lcore_usage_get(lcore_id, &u2);
+	if (u2.total_cycles <= u1.total_cycles ||
+			u2.busy_cycles != u1.busy_cycles) {
+		printf("Error: idle interval not accounted as idle\n");
+		return -1;
+	}
+
+	/* A registered callback replaces the accounting of EAL. */
+	rte_lcore_register_usage_cb(test_usage_cb);
+	if (rte_lcore_usage_get(rte_get_main_lcore(), &u0) != 0 ||
+			u0.total_cycles != 100 || u0.busy_cycles != 42) {
+		rte_lcore_register_usage_cb(NULL);
+		printf("Error: usage not reported by the callback\n");
+		return -1;
+	}
+	rte_lcore_register_usage_cb(NULL);
+	if (rte_lcore_usage_get(lcore_id, &u0) != 0 ||
+			u0.busy_cycles != u2.busy_cycles) {
+		printf("Error: usage not accounted after the callback\n");
+		return -1;
+	}
+
+	return 0;
+}
+
 static int
 test_lcores(void)
 {
@@ -367,6 +491,12 @@ test_lcores(void)
 	if (test_non_eal_lcores_callback(eal_threads_count) < 0)
 		return TEST_FAILED;
 
+	if (test_lcores_topology() < 0)
+		return TEST_FAILED;
+
+	if (test_lcores_usage() < 0)
+		return TEST_FAILED;
+
 	return TEST_SUCCESS;
 }
 
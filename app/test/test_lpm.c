@@ -5,10 +5,14 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <limits.h>
+#include <unistd.h>
 
+#include <rte_errno.h>
 #include <rte_ip.h>
 #include <rte_lpm.h>
 #include <rte_malloc.h>
+#include <rte_persist.h>
 
 #include "test.h"
 #include "test_xmmt_ops.h"
@@ -44,6 +48,10 @@ static int32_t test18(void);
 static int32_t test19(void);
 static int32_t test20(void);
 static int32_t test21(void);
+static int32_t test22(void);
+static int32_t test23(void);
+static int32_t test24(void);
+static int32_t test25(void);
 
 rte_lpm_test tests[] = {
 /* Test Cases */
@@ -68,7 +76,11 @@ rte_lpm_test tests[] = {
 	test18,
 	test19,
 	test20,
-	test21
+	test21,
+	test22,
+	test23,
+	test24,
+	test25
 };
 
 #define MAX_DEPTH 32
@@ -1563,6 +1575,284 @@ test21(void)
 	return (status == 0) ? PASS : -1;
 }
 
+/*
+ * Create an LPM table in a persistent zone, close the persistent memory
+ * file and open it again, as done across a restart, and check that the
+ * table is attached with its rule.
+ */
+int32_t
+test22(void)
+{
+	char path[PATH_MAX];
+	struct rte_lpm *lpm = NULL;
+	struct rte_lpm_config config;
+	uint32_t ip = RTE_IPV4(192, 168, 10, 1), next_hop_return = 0;
+	int32_t status;
+
+	config.max_rules = MAX_RULES;
+	config.number_tbl8s = NUMBER_TBL8S;
+	config.flags = 0;
+
+	snprintf(path, sizeof(path), "/tmp/test_lpm_persist_%d", getpid());
+	unlink(path);
+
+	status = rte_persist_open(path, NULL, 64 << 20);
+	TEST_LPM_ASSERT(status == 0);
+
+	lpm = rte_lpm_create_persist(__func__, &config);
+	if (lpm == NULL)
+		goto error;
+	status = rte_lpm_add(lpm, ip, 32, 100);
+	if (status != 0)
+		goto error;
+	rte_lpm_free(lpm);
+	rte_persist_close();
+
+	status = rte_persist_open(path, NULL, 64 << 20);
+	if (status != 1)
+		goto error;
+
+	/* another configuration does not match the zone */
+	config.max_rules = MAX_RULES / 2;
+	lpm = rte_lpm_create_persist(__func__, &config);
+	if (lpm != NULL || rte_errno != EINVAL)
+		goto error;
+
+	config.max_rules = MAX_RULES;
+	lpm = rte_lpm_create_persist(__func__, &config);
+	if (lpm == NULL)
+		goto error;
+	status = rte_lpm_lookup(lpm, ip, &next_hop_return);
+	if (status != 0 || next_hop_return != 100)
+		goto error;
+
+	rte_lpm_free(lpm);
+	rte_persist_close();
+	unlink(path);
+
+	return PASS;
+
+error:
+	rte_lpm_free(lpm);
+	rte_persist_close();
+	unlink(path);
+	return -1;
+}
+
+/*
+ * LPM replicated on each NUMA socket: the rules are in the replica of each
+ * socket having lcores, and the lookups of an lcore use its local replica.
+ */
+int32_t
+test23(void)
+{
+	struct rte_lpm_numa *ln;
+	struct rte_lpm_config config;
+	uint32_t ip = RTE_IPV4(10, 0, 0, 1), next_hop_return = 0;
+	unsigned int lcore_id;
+	int32_t status;
+
+	config.max_rules = MAX_RULES;
+	config.number_tbl8s = NUMBER_TBL8S;
+	config.flags = 0;
+
+	ln = rte_lpm_numa_create(NULL, &config);
+	TEST_LPM_ASSERT(ln == NULL);
+	ln = rte_lpm_numa_create("a_name_much_too_long_for_a_replica", &config);
+	TEST_LPM_ASSERT(ln == NULL);
+
+	ln = rte_lpm_numa_create(__func__, &config);
+	TEST_LPM_ASSERT(ln != NULL);
+	TEST_LPM_ASSERT(rte_lpm_numa_local(ln) ==
+			rte_lpm_numa_get(ln, rte_socket_id()));
+	TEST_LPM_ASSERT(rte_lpm_numa_get(ln, RTE_MAX_NUMA_NODES) == NULL);
+
+	status = rte_lpm_numa_add(ln, ip, 32, 100);
+	TEST_LPM_ASSERT(status == 0);
+	status = rte_lpm_numa_add(ln, ip, 32, 200);
+	TEST_LPM_ASSERT(status == 0);
+
+	status = rte_lpm_lookup(rte_lpm_numa_local(ln), ip, &next_hop_return);
+	TEST_LPM_ASSERT(status == 0 && next_hop_return == 200);
+	RTE_LCORE_FOREACH(lcore_id) {
+		status = rte_lpm_is_rule_present(rte_lpm_numa_get(ln,
+				rte_lcore_to_socket_id(lcore_id)), ip, 32,
+				&next_hop_return);
+		TEST_LPM_ASSERT(status == 1 && next_hop_return == 200);
+	}
+
+	status = rte_lpm_numa_delete(ln, ip, 32);
+	TEST_LPM_ASSERT(status == 0);
+	status = rte_lpm_numa_delete(ln, ip, 32);
+	TEST_LPM_ASSERT(status < 0);
+	RTE_LCORE_FOREACH(lcore_id) {
+		status = rte_lpm_lookup(rte_lpm_numa_get(ln,
+				rte_lcore_to_socket_id(lcore_id)), ip,
+				&next_hop_return);
+		TEST_LPM_ASSERT(status == -ENOENT);
+	}
+
+	status = rte_lpm_numa_add(ln, ip, 24, 100);
+	TEST_LPM_ASSERT(status == 0);
+	rte_lpm_numa_delete_all(ln);
+	status = rte_lpm_lookup(rte_lpm_numa_local(ln), ip, &next_hop_return);
+	TEST_LPM_ASSERT(status == -ENOENT);
+
+	rte_lpm_numa_free(ln);
+
+	return PASS;
+}
+
+/*
+ * tbl8 groups growth: the rules needing a tbl8 group are added beyond the
+ * number of groups in the configuration once RCU is configured.
+ */
+int32_t
+test24(void)
+{
+	struct rte_lpm *lpm = NULL;
+	struct rte_lpm_config config;
+	struct rte_lpm_rcu_config rcu_cfg = {0};
+	struct rte_rcu_qsbr *qsv;
+	uint32_t i, next_hop_return;
+	int32_t status;
+
+	config.max_rules = MAX_RULES;
+	config.number_tbl8s = 4;
+	config.flags = RTE_LPM_F_TBL8_GROW;
+
+	/* the tbl8 groups of a persistent table cannot grow */
+	lpm = rte_lpm_create_persist(__func__, &config);
+	TEST_LPM_ASSERT(lpm == NULL && rte_errno == EINVAL);
+
+	lpm = rte_lpm_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(lpm != NULL);
+
+	/* no growth without RCU */
+	for (i = 0; i < 4; i++) {
+		status = rte_lpm_add(lpm, RTE_IPV4(10, 0, i, 1), 32, i);
+		TEST_LPM_ASSERT(status == 0);
+	}
+	status = rte_lpm_add(lpm, RTE_IPV4(10, 0, 4, 1), 32, 4);
+	TEST_LPM_ASSERT(status < 0);
+
+	qsv = rte_zmalloc_socket(NULL, rte_rcu_qsbr_get_memsize(1),
+				RTE_CACHE_LINE_SIZE, SOCKET_ID_ANY);
+	TEST_LPM_ASSERT(qsv != NULL);
+	status = rte_rcu_qsbr_init(qsv, 1);
+	TEST_LPM_ASSERT(status == 0);
+
+	rcu_cfg.v = qsv;
+	rcu_cfg.mode = RTE_LPM_QSBR_MODE_SYNC;
+	status = rte_lpm_rcu_qsbr_add(lpm, &rcu_cfg);
+	TEST_LPM_ASSERT(status == 0);
+
+	for (i = 4; i < 64; i++) {
+		status = rte_lpm_add(lpm, RTE_IPV4(10, 0, i, 1), 32, i);
+		TEST_LPM_ASSERT(status == 0);
+	}
+	for (i = 0; i < 64; i++) {
+		status = rte_lpm_lookup(lpm, RTE_IPV4(10, 0, i, 1),
+				&next_hop_return);
+		TEST_LPM_ASSERT(status == 0 && next_hop_return == i);
+		status = rte_lpm_lookup(lpm, RTE_IPV4(10, 0, i, 2),
+				&next_hop_return);
+		TEST_LPM_ASSERT(status == -ENOENT);
+	}
+
+	rte_lpm_free(lpm);
+	rte_free(qsv);
+
+	return PASS;
+}
+
+/*
+ * tbl8 groups compaction: a group which cannot be freed on deletion, as the
+ * defer queue is full, is kept and freed later by the compaction.
+ *  - Create LPM with a defer queue of one entry and a pseudo reader
+ *  - Delete two rules with depth > 24, the second group cannot be freed
+ *  - Compact once the reader is quiescent
+ */
+int32_t
+test25(void)
+{
+	struct rte_lpm *lpm = NULL;
+	struct rte_lpm_config config;
+	struct rte_lpm_rcu_config rcu_cfg = {0};
+	struct rte_rcu_qsbr *qsv;
+	uint32_t ip1 = RTE_IPV4(10, 0, 0, 1), ip2 = RTE_IPV4(10, 0, 1, 1);
+	uint32_t next_hop_return;
+	int32_t status;
+
+	config.max_rules = MAX_RULES;
+	config.number_tbl8s = 4;
+	config.flags = 0;
+
+	TEST_LPM_ASSERT(rte_lpm_tbl8_compact(NULL, 0) == -EINVAL);
+
+	lpm = rte_lpm_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(lpm != NULL);
+
+	qsv = rte_zmalloc_socket(NULL, rte_rcu_qsbr_get_memsize(1),
+				RTE_CACHE_LINE_SIZE, SOCKET_ID_ANY);
+	TEST_LPM_ASSERT(qsv != NULL);
+	status = rte_rcu_qsbr_init(qsv, 1);
+	TEST_LPM_ASSERT(status == 0);
+
+	rcu_cfg.v = qsv;
+	rcu_cfg.mode = RTE_LPM_QSBR_MODE_DQ;
+	rcu_cfg.dq_size = 1;
+	status = rte_lpm_rcu_qsbr_add(lpm, &rcu_cfg);
+	TEST_LPM_ASSERT(status == 0);
+
+	status = rte_lpm_add(lpm, ip1, 32, 1);
+	TEST_LPM_ASSERT(status == 0);
+	status = rte_lpm_add(lpm, ip2, 32, 2);
+	TEST_LPM_ASSERT(status == 0);
+	/* the groups are in use */
+	TEST_LPM_ASSERT(rte_lpm_tbl8_compact(lpm, 0) == 0);
+
+	/* Register pseudo reader */
+	status = rte_rcu_qsbr_thread_register(qsv, 0);
+	TEST_LPM_ASSERT(status == 0);
+	rte_rcu_qsbr_thread_online(qsv, 0);
+
+	status = rte_lpm_delete(lpm, ip1, 32);
+	TEST_LPM_ASSERT(status == 0);
+	TEST_LPM_ASSERT(!lpm->tbl24[ip1 >> 8].valid);
+
+	/* the defer queue is full, the group is kept */
+	status = rte_lpm_delete(lpm, ip2, 32);
+	TEST_LPM_ASSERT(status == 0);
+	TEST_LPM_ASSERT(lpm->tbl24[ip2 >> 8].valid_group);
+	status = rte_lpm_lookup(lpm, ip2, &next_hop_return);
+	TEST_LPM_ASSERT(status == -ENOENT);
+	TEST_LPM_ASSERT(rte_lpm_tbl8_compact(lpm, 0) == 0);
+	TEST_LPM_ASSERT(lpm->tbl24[ip2 >> 8].valid_group);
+
+	rte_rcu_qsbr_quiescent(qsv, 0);
+
+	/* the compaction resumes at the group it could not free */
+	TEST_LPM_ASSERT(rte_lpm_tbl8_compact(lpm, 1) == 1);
+	TEST_LPM_ASSERT(!lpm->tbl24[ip2 >> 8].valid);
+	status = rte_lpm_lookup(lpm, ip2, &next_hop_return);
+	TEST_LPM_ASSERT(status == -ENOENT);
+
+	/* both groups are available again */
+	status = rte_lpm_add(lpm, ip1, 32, 1);
+	TEST_LPM_ASSERT(status == 0);
+	status = rte_lpm_add(lpm, ip2, 32, 2);
+	TEST_LPM_ASSERT(status == 0);
+
+	rte_rcu_qsbr_thread_offline(qsv, 0);
+	rte_rcu_qsbr_thread_unregister(qsv, 0);
+
+	rte_lpm_free(lpm);
+	rte_free(qsv);
+
+	return PASS;
+}
+
 /*
  * Do all unit tests.
  */
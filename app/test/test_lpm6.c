@@ -8,6 +8,7 @@
 #include <string.h>
 
 #include <rte_memory.h>
+#include <rte_malloc.h>
 #include <rte_lpm6.h>
 
 #include "test.h"
@@ -51,6 +52,9 @@ static int32_t test25(void);
 static int32_t test26(void);
 static int32_t test27(void);
 static int32_t test28(void);
+static int32_t test29(void);
+static int32_t test30(void);
+static int32_t test31(void);
 
 rte_lpm6_test tests6[] = {
 /* Test Cases */
@@ -83,6 +87,9 @@ rte_lpm6_test tests6[] = {
 	test26,
 	test27,
 	test28,
+	test29,
+	test30,
+	test31,
 };
 
 #define MAX_DEPTH                                                    128
@@ -1770,6 +1777,239 @@ test28(void)
 	return PASS;
 }
 
+/*
+ * rte_lpm6_rcu_qsbr_add positive and negative tests.
+ *  - Add RCU QSBR variable to LPM
+ *  - Add another RCU QSBR variable to LPM
+ *  - Check returns
+ */
+int32_t
+test29(void)
+{
+	struct rte_lpm6 *lpm = NULL;
+	struct rte_lpm6_config config;
+	size_t sz;
+	struct rte_rcu_qsbr *qsv;
+	struct rte_rcu_qsbr *qsv2;
+	int32_t status;
+	struct rte_lpm6_rcu_config rcu_cfg = {0};
+
+	config.max_rules = MAX_RULES;
+	config.number_tbl8s = NUMBER_TBL8S;
+	config.flags = 0;
+
+	lpm = rte_lpm6_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(lpm != NULL);
+
+	/* Create RCU QSBR variable */
+	sz = rte_rcu_qsbr_get_memsize(RTE_MAX_LCORE);
+	qsv = (struct rte_rcu_qsbr *)rte_zmalloc_socket(NULL, sz,
+					RTE_CACHE_LINE_SIZE, SOCKET_ID_ANY);
+	TEST_LPM_ASSERT(qsv != NULL);
+
+	status = rte_rcu_qsbr_init(qsv, RTE_MAX_LCORE);
+	TEST_LPM_ASSERT(status == 0);
+
+	/* Invalid arguments */
+	status = rte_lpm6_rcu_qsbr_add(NULL, &rcu_cfg);
+	TEST_LPM_ASSERT(status != 0);
+	status = rte_lpm6_rcu_qsbr_add(lpm, NULL);
+	TEST_LPM_ASSERT(status != 0);
+
+	rcu_cfg.v = qsv;
+	/* Invalid QSBR mode */
+	rcu_cfg.mode = 2;
+	status = rte_lpm6_rcu_qsbr_add(lpm, &rcu_cfg);
+	TEST_LPM_ASSERT(status != 0);
+
+	rcu_cfg.mode = RTE_LPM6_QSBR_MODE_DQ;
+	/* Attach RCU QSBR to LPM table */
+	status = rte_lpm6_rcu_qsbr_add(lpm, &rcu_cfg);
+	TEST_LPM_ASSERT(status == 0);
+
+	/* Create and attach another RCU QSBR to LPM table */
+	qsv2 = (struct rte_rcu_qsbr *)rte_zmalloc_socket(NULL, sz,
+					RTE_CACHE_LINE_SIZE, SOCKET_ID_ANY);
+	TEST_LPM_ASSERT(qsv2 != NULL);
+
+	rcu_cfg.v = qsv2;
+	rcu_cfg.mode = RTE_LPM6_QSBR_MODE_SYNC;
+	status = rte_lpm6_rcu_qsbr_add(lpm, &rcu_cfg);
+	TEST_LPM_ASSERT(status != 0);
+
+	rte_lpm6_free(lpm);
+	rte_free(qsv);
+	rte_free(qsv2);
+
+	return PASS;
+}
+
+/*
+ * rte_lpm6_rcu_qsbr_add DQ mode functional test.
+ * Reader and writer are in the same thread in this test.
+ *  - Create LPM which supports 1 tbl8 at max
+ *  - Add RCU QSBR variable to LPM
+ *  - Add a rule with depth=32 (> 24)
+ *  - Register a reader thread (not a real thread)
+ *  - Reader lookup existing rule
+ *  - Writer delete the rule
+ *  - Reader lookup the rule
+ *  - Writer re-add the rule (no available tbl8)
+ *  - Reader report quiescent state and unregister
+ *  - Writer re-add the rule
+ *  - Reader lookup the rule
+ */
+int32_t
+test30(void)
+{
+	struct rte_lpm6 *lpm = NULL;
+	struct rte_lpm6_config config;
+	size_t sz;
+	struct rte_rcu_qsbr *qsv;
+	int32_t status;
+	uint8_t ip[RTE_LPM6_IPV6_ADDR_SIZE];
+	uint32_t next_hop, next_hop_return;
+	uint8_t depth;
+	struct rte_lpm6_rcu_config rcu_cfg = {0};
+
+	config.max_rules = MAX_RULES;
+	config.number_tbl8s = 1;
+	config.flags = 0;
+
+	lpm = rte_lpm6_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(lpm != NULL);
+
+	/* Create RCU QSBR variable */
+	sz = rte_rcu_qsbr_get_memsize(1);
+	qsv = (struct rte_rcu_qsbr *)rte_zmalloc_socket(NULL, sz,
+				RTE_CACHE_LINE_SIZE, SOCKET_ID_ANY);
+	TEST_LPM_ASSERT(qsv != NULL);
+
+	status = rte_rcu_qsbr_init(qsv, 1);
+	TEST_LPM_ASSERT(status == 0);
+
+	rcu_cfg.v = qsv;
+	rcu_cfg.mode = RTE_LPM6_QSBR_MODE_DQ;
+	/* Attach RCU QSBR to LPM table */
+	status = rte_lpm6_rcu_qsbr_add(lpm, &rcu_cfg);
+	TEST_LPM_ASSERT(status == 0);
+
+	IPv6(ip, 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+	depth = 32;
+	next_hop = 1;
+	status = rte_lpm6_add(lpm, ip, depth, next_hop);
+	TEST_LPM_ASSERT(status == 0);
+
+	/* Register pseudo reader */
+	status = rte_rcu_qsbr_thread_register(qsv, 0);
+	TEST_LPM_ASSERT(status == 0);
+	rte_rcu_qsbr_thread_online(qsv, 0);
+
+	status = rte_lpm6_lookup(lpm, ip, &next_hop_return);
+	TEST_LPM_ASSERT(status == 0);
+	TEST_LPM_ASSERT(next_hop_return == next_hop);
+
+	/* Writer update */
+	status = rte_lpm6_delete(lpm, ip, depth);
+	TEST_LPM_ASSERT(status == 0);
+
+	status = rte_lpm6_lookup(lpm, ip, &next_hop_return);
+	TEST_LPM_ASSERT(status != 0);
+
+	/* The only tbl8 is still waiting for the reader */
+	status = rte_lpm6_add(lpm, ip, depth, next_hop);
+	TEST_LPM_ASSERT(status != 0);
+
+	/* Reader quiescent */
+	rte_rcu_qsbr_quiescent(qsv, 0);
+
+	status = rte_lpm6_add(lpm, ip, depth, next_hop);
+	TEST_LPM_ASSERT(status == 0);
+
+	rte_rcu_qsbr_thread_offline(qsv, 0);
+	status = rte_rcu_qsbr_thread_unregister(qsv, 0);
+	TEST_LPM_ASSERT(status == 0);
+
+	status = rte_lpm6_lookup(lpm, ip, &next_hop_return);
+	TEST_LPM_ASSERT(status == 0);
+	TEST_LPM_ASSERT(next_hop_return == next_hop);
+
+	/* Flushing the defer queue gives every tbl8 back */
+	rte_lpm6_delete_all(lpm);
+	status = rte_lpm6_add(lpm, ip, depth, next_hop);
+	TEST_LPM_ASSERT(status == 0);
+
+	rte_lpm6_free(lpm);
+	rte_free(qsv);
+
+	return PASS;
+}
+
+/*
+ * Bulk lookup of more addresses than a lookup batch, at several depths,
+ * must give the same result as the single lookup for each address.
+ */
+int32_t
+test31(void)
+{
+	struct rte_lpm6 *lpm = NULL;
+	struct rte_lpm6_config config;
+	uint8_t ip_batch[100][RTE_LPM6_IPV6_ADDR_SIZE];
+	int32_t next_hop_return[100];
+	uint32_t next_hop;
+	uint8_t ip[RTE_LPM6_IPV6_ADDR_SIZE];
+	unsigned int i;
+	int32_t status;
+
+	config.max_rules = MAX_RULES;
+	config.number_tbl8s = NUMBER_TBL8S;
+	config.flags = 0;
+
+	lpm = rte_lpm6_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(lpm != NULL);
+
+	IPv6(ip, 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+	status = rte_lpm6_add(lpm, ip, 24, 1);
+	TEST_LPM_ASSERT(status == 0);
+	status = rte_lpm6_add(lpm, ip, 48, 2);
+	TEST_LPM_ASSERT(status == 0);
+	ip[15] = 3;
+	status = rte_lpm6_add(lpm, ip, 128, 3);
+	TEST_LPM_ASSERT(status == 0);
+
+	/* Mix addresses hitting every rule and missing addresses */
+	for (i = 0; i < RTE_DIM(ip_batch); i++) {
+		IPv6(ip_batch[i], 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+				0, 0, 0, 0, 0, 0, 0, i % 5);
+		if (i % 3 == 1)
+			ip_batch[i][4] = 1;
+		else if (i % 3 == 2)
+			ip_batch[i][0] = 0x30;
+	}
+
+	status = rte_lpm6_lookup_bulk_func(lpm, ip_batch, next_hop_return,
+			RTE_DIM(ip_batch));
+	TEST_LPM_ASSERT(status == 0);
+
+	for (i = 0; i < RTE_DIM(ip_batch); i++) {
+		status = rte_lpm6_lookup(lpm, ip_batch[i], &next_hop);
+		if (status == 0)
+			TEST_LPM_ASSERT(next_hop_return[i] == (int32_t)next_hop);
+		else
+			TEST_LPM_ASSERT(next_hop_return[i] == -1);
+	}
+
+	/* Spot check the expected results */
+	TEST_LPM_ASSERT(next_hop_return[3] == 3);
+	TEST_LPM_ASSERT(next_hop_return[1] == 1);
+	TEST_LPM_ASSERT(next_hop_return[2] == -1);
+	TEST_LPM_ASSERT(next_hop_return[0] == 2);
+
+	rte_lpm6_free(lpm);
+
+	return PASS;
+}
+
 /*
  * Do all unit tests.
  */
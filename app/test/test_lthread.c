@@ -0,0 +1,220 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include "test.h"
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <rte_common.h>
+#include <rte_cycles.h>
+#include <rte_launch.h>
+#include <rte_lcore.h>
+#include <rte_timer.h>
+#include <rte_lthread.h>
+
+#define LOG_MAX		32
+#define NB_STEAL	200
+
+static char run_log[LOG_MAX];
+static uint32_t n_log;
+static struct rte_lthread *suspended;
+
+static void
+log_run(char c)
+{
+	if (n_log < LOG_MAX - 1)
+		run_log[n_log++] = c;
+}
+
+/* Lthread yielding twice, logging each run. */
+static void
+test_yield_fn(void *arg)
+{
+	char c = (char)(uintptr_t)arg;
+	int i;
+
+	for (i = 0; i < 3; i++) {
+		log_run(c);
+		if (i < 2)
+			rte_lthread_yield();
+	}
+}
+
+static void
+test_suspend_fn(void *arg __rte_unused)
+{
+	suspended = rte_lthread_self();
+	log_run('S');
+	rte_lthread_suspend();
+	log_run('W');
+}
+
+static void
+test_wakeup_fn(void *arg __rte_unused)
+{
+	rte_lthread_yield();
+	log_run('w');
+	rte_lthread_wakeup(suspended);
+	rte_lthread_yield();
+	rte_lthread_yield();
+	rte_lthread_sched_stop(rte_lcore_id());
+}
+
+/* The ready lthreads run round-robin and a suspended one runs again only
+ * once woken up.
+ */
+static int
+test_lthread_order(void)
+{
+	unsigned int lcore_id = rte_lcore_id();
+
+	TEST_ASSERT_SUCCESS(rte_lthread_sched_create(lcore_id, NULL),
+			    "Failed to create scheduler");
+	TEST_ASSERT(rte_lthread_sched_create(lcore_id, NULL) == -EEXIST,
+		    "Scheduler created twice");
+
+	n_log = 0;
+	memset(run_log, 0, sizeof(run_log));
+	TEST_ASSERT_SUCCESS(rte_lthread_create(NULL, lcore_id, test_yield_fn,
+			    (void *)(uintptr_t)'A', 0), "Failed to create A");
+	TEST_ASSERT_SUCCESS(rte_lthread_create(NULL, lcore_id, test_yield_fn,
+			    (void *)(uintptr_t)'B', 0), "Failed to create B");
+	TEST_ASSERT_SUCCESS(rte_lthread_create(NULL, lcore_id, test_suspend_fn,
+			    NULL, 0), "Failed to create suspended lthread");
+	TEST_ASSERT_SUCCESS(rte_lthread_create(NULL, lcore_id, test_wakeup_fn,
+			    NULL, 0), "Failed to create waking lthread");
+
+	TEST_ASSERT_NULL(rte_lthread_self(), "Not in an lthread");
+	TEST_ASSERT_SUCCESS(rte_lthread_sched_run(NULL),
+			    "Failed to run scheduler");
+
+	TEST_ASSERT(strcmp(run_log, "ABSABwABW") == 0,
+		    "Unexpected run order %s", run_log);
+
+	rte_lthread_sched_free(lcore_id);
+
+	return TEST_SUCCESS;
+}
+
+static void
+test_sleep_fn(void *arg)
+{
+	uint64_t *slept = arg;
+	uint64_t start = rte_get_timer_cycles();
+
+	rte_lthread_sleep(10 * 1000 * 1000);
+	*slept = rte_get_timer_cycles() - start;
+	rte_lthread_sched_stop(rte_lcore_id());
+}
+
+/* A sleeping lthread is woken up by its timer. */
+static int
+test_lthread_sleep(void)
+{
+	unsigned int lcore_id = rte_lcore_id();
+	uint64_t hz = rte_get_timer_hz();
+	uint64_t slept = 0;
+
+	TEST_ASSERT_SUCCESS(rte_lthread_sched_create(lcore_id, NULL),
+			    "Failed to create scheduler");
+	TEST_ASSERT_SUCCESS(rte_lthread_create(NULL, lcore_id, test_sleep_fn,
+			    &slept, 0), "Failed to create lthread");
+	TEST_ASSERT_SUCCESS(rte_lthread_sched_run(NULL),
+			    "Failed to run scheduler");
+
+	TEST_ASSERT(slept >= hz / 100, "Slept only %"PRIu64" cycles", slept);
+
+	rte_lthread_sched_free(lcore_id);
+
+	return TEST_SUCCESS;
+}
+
+static uint32_t steal_done;
+
+static void
+test_steal_fn(void *arg __rte_unused)
+{
+	int i;
+
+	for (i = 0; i < 10; i++)
+		rte_lthread_yield();
+	__atomic_fetch_add(&steal_done, 1, __ATOMIC_RELAXED);
+}
+
+/* An idle scheduler steals the stealable lthreads of a busy one. */
+static int
+test_lthread_steal(void)
+{
+	struct rte_lthread_sched_params params = { .steal = 1 };
+	struct rte_lthread_sched_stats stats;
+	unsigned int lcore[2];
+	unsigned int i;
+	int ret = TEST_SUCCESS;
+
+	lcore[0] = rte_get_next_lcore(-1, 1, 0);
+	lcore[1] = rte_get_next_lcore(lcore[0], 1, 0);
+	if (lcore[1] >= RTE_MAX_LCORE) {
+		printf("Not enough lcores, skipping steal test\n");
+		return TEST_SUCCESS;
+	}
+
+	for (i = 0; i < 2; i++)
+		TEST_ASSERT_SUCCESS(rte_lthread_sched_create(lcore[i], &params),
+				    "Failed to create scheduler %u", i);
+
+	steal_done = 0;
+	for (i = 0; i < NB_STEAL; i++)
+		TEST_ASSERT_SUCCESS(rte_lthread_create(NULL, lcore[0],
+				    test_steal_fn, NULL,
+				    RTE_LTHREAD_F_STEALABLE),
+				    "Failed to create lthread %u", i);
+
+	/* Start the idle scheduler first, so it has time to steal. */
+	rte_eal_remote_launch(rte_lthread_sched_run, NULL, lcore[1]);
+	rte_eal_remote_launch(rte_lthread_sched_run, NULL, lcore[0]);
+
+	while (__atomic_load_n(&steal_done, __ATOMIC_RELAXED) != NB_STEAL)
+		rte_pause();
+
+	for (i = 0; i < 2; i++)
+		rte_lthread_sched_stop(lcore[i]);
+	rte_eal_mp_wait_lcore();
+
+	rte_lthread_sched_stats_get(lcore[1], &stats);
+	if (stats.steals == 0) {
+		printf("No lthread stolen\n");
+		ret = TEST_FAILED;
+	}
+
+	for (i = 0; i < 2; i++)
+		rte_lthread_sched_free(lcore[i]);
+
+	return ret;
+}
+
+static int
+test_lthread(void)
+{
+	int ret = rte_timer_subsystem_init();
+
+	if (ret < 0 && ret != -EALREADY) {
+		printf("Failed to init timer subsystem\n");
+		return TEST_FAILED;
+	}
+
+	if (test_lthread_order() != TEST_SUCCESS)
+		return TEST_FAILED;
+
+	if (test_lthread_sleep() != TEST_SUCCESS)
+		return TEST_FAILED;
+
+	if (test_lthread_steal() != TEST_SUCCESS)
+		return TEST_FAILED;
+
+	return TEST_SUCCESS;
+}
+
+REGISTER_TEST_COMMAND(lthread_autotest, test_lthread);
@@ -899,6 +899,120 @@ test_pktmbuf_pool_bulk(void)
 	return ret;
 }
 
+/*
+ * test the fast bulk allocation and free of single-segment direct mbufs
+ */
+static int
+test_pktmbuf_pool_fast_bulk(void)
+{
+	struct rte_mempool *pool = NULL;
+	struct rte_mempool *pool2 = NULL;
+	unsigned int i;
+	struct rte_mbuf *m, *clone;
+	struct rte_mbuf *mbufs[NB_MBUF];
+	int ret = 0;
+
+	/* Pools without caches, to check the number of available mbufs. */
+	pool = rte_pktmbuf_pool_create("test_pktmbuf_fast",
+			NB_MBUF, 0, 0, MBUF_DATA_SIZE, SOCKET_ID_ANY);
+	if (pool == NULL)
+		GOTO_FAIL("rte_pktmbuf_pool_create() failed: %d", rte_errno);
+	pool2 = rte_pktmbuf_pool_create("test_pktmbuf_fast2",
+			NB_MBUF, 0, 0, MBUF_DATA_SIZE, SOCKET_ID_ANY);
+	if (pool2 == NULL)
+		GOTO_FAIL("rte_pktmbuf_pool_create() failed: %d", rte_errno);
+
+	/* Dirty the fields of all the mbufs, then return them. */
+	ret = rte_pktmbuf_alloc_bulk(pool, mbufs, NB_MBUF);
+	if (ret != 0)
+		GOTO_FAIL("rte_pktmbuf_alloc_bulk() failed: %d", ret);
+	for (i = 0; i < NB_MBUF; i++) {
+		m = mbufs[i];
+		m->data_off = 0;
+		m->port = 1;
+		m->ol_flags = PKT_RX_VLAN | PKT_TX_IPV4;
+		m->packet_type = RTE_PTYPE_L3_IPV4;
+		m->pkt_len = m->data_len = MBUF_TEST_DATA_LEN;
+		m->vlan_tci = m->vlan_tci_outer = 1;
+		m->tx_offload = UINT64_MAX;
+	}
+	rte_pktmbuf_free_bulk(mbufs, NB_MBUF);
+
+	/* Fast allocation resets the fields as rte_pktmbuf_reset() does. */
+	ret = rte_pktmbuf_fast_alloc_bulk(pool, mbufs, NB_MBUF);
+	if (ret != 0)
+		GOTO_FAIL("rte_pktmbuf_fast_alloc_bulk() failed: %d", ret);
+	if (!rte_mempool_empty(pool))
+		GOTO_FAIL("mempool not empty");
+	if (rte_pktmbuf_fast_alloc_bulk(pool, &m, 1) != -ENOENT)
+		GOTO_FAIL("fast allocation from an empty mempool succeeded");
+	for (i = 0; i < NB_MBUF; i++) {
+		m = mbufs[i];
+		if (m->data_off != RTE_PKTMBUF_HEADROOM ||
+				rte_mbuf_refcnt_read(m) != 1 ||
+				m->nb_segs != 1 || m->next != NULL ||
+				m->port != RTE_MBUF_PORT_INVALID ||
+				m->ol_flags != 0 || m->packet_type != 0 ||
+				m->pkt_len != 0 || m->data_len != 0 ||
+				m->vlan_tci != 0 || m->vlan_tci_outer != 0 ||
+				m->tx_offload != 0)
+			GOTO_FAIL("mbuf %u not reset", i);
+	}
+
+	/* Fast free of mbufs meeting all the conditions. */
+	rte_pktmbuf_fast_free_bulk(pool, mbufs, NB_MBUF / 2 + 1);
+	if (rte_mempool_avail_count(pool) != NB_MBUF / 2 + 1)
+		GOTO_FAIL("mempool avail count incorrect");
+	rte_pktmbuf_fast_free_bulk(pool, &mbufs[NB_MBUF / 2 + 1],
+			NB_MBUF / 2 - 1);
+	if (!rte_mempool_full(pool))
+		GOTO_FAIL("mempool not full");
+
+	/* Fast free of mbufs not meeting the conditions. */
+	ret = rte_pktmbuf_fast_alloc_bulk(pool, mbufs, NB_MBUF / 2);
+	if (ret != 0)
+		GOTO_FAIL("rte_pktmbuf_fast_alloc_bulk() failed: %d", ret);
+	/* a chain */
+	m = rte_pktmbuf_alloc(pool);
+	if (m == NULL || rte_pktmbuf_chain(mbufs[1], m) != 0)
+		GOTO_FAIL("cannot chain mbufs");
+	/* another mempool */
+	rte_pktmbuf_free(mbufs[5]);
+	mbufs[5] = rte_pktmbuf_alloc(pool2);
+	if (mbufs[5] == NULL)
+		GOTO_FAIL("rte_pktmbuf_alloc() failed");
+	/* an indirect mbuf and its direct mbuf, still referenced */
+	rte_pktmbuf_free(mbufs[10]);
+	clone = rte_pktmbuf_clone(mbufs[9], pool);
+	if (clone == NULL)
+		GOTO_FAIL("rte_pktmbuf_clone() failed");
+	mbufs[10] = clone;
+	/* a reference held elsewhere */
+	rte_mbuf_refcnt_update(mbufs[NB_MBUF / 2 - 1], 1);
+
+	rte_pktmbuf_fast_free_bulk(pool, mbufs, NB_MBUF / 2);
+	if (rte_mempool_avail_count(pool) != NB_MBUF - 1)
+		GOTO_FAIL("mempool avail count incorrect");
+	if (!rte_mempool_full(pool2))
+		GOTO_FAIL("mempool not full");
+	if (rte_mbuf_refcnt_read(mbufs[NB_MBUF / 2 - 1]) != 1)
+		GOTO_FAIL("referenced mbuf refcnt incorrect");
+	rte_pktmbuf_fast_free_bulk(pool, &mbufs[NB_MBUF / 2 - 1], 1);
+	if (!rte_mempool_full(pool))
+		GOTO_FAIL("mempool not full");
+
+	ret = 0;
+	goto done;
+
+fail:
+	ret = -1;
+
+done:
+	rte_mempool_free(pool);
+	rte_mempool_free(pool2);
+	return ret;
+}
+
 /*
  * test that the pointer to the data on a packet mbuf is set properly
  */
@@ -2577,6 +2691,24 @@ test_mbuf_dyn(struct rte_mempool *pktmbuf_pool)
 		.align = 3,
 		.flags = 0,
 	};
+	const struct rte_mbuf_dynfield dynfield_fail_hint = {
+		.name = "test-dynfield-fail-hint",
+		.size = 1,
+		.align = 1,
+		.flags = RTE_MBUF_DYNFIELD_F_HOT | RTE_MBUF_DYNFIELD_F_COLD,
+	};
+	struct rte_mbuf_dynfield dynfield_hot = {
+		.name = "test-dynfield-hot",
+		.size = sizeof(uint32_t),
+		.align = __alignof__(uint32_t),
+		.flags = RTE_MBUF_DYNFIELD_F_HOT,
+	};
+	const struct rte_mbuf_dynfield dynfield_cold = {
+		.name = "test-dynfield-cold",
+		.size = sizeof(uint32_t),
+		.align = __alignof__(uint32_t),
+		.flags = RTE_MBUF_DYNFIELD_F_COLD,
+	};
 	const struct rte_mbuf_dynflag dynflag = {
 		.name = "test-dynflag",
 		.flags = 0,
@@ -2590,7 +2722,7 @@ test_mbuf_dyn(struct rte_mempool *pktmbuf_pool)
 		.flags = 0,
 	};
 	struct rte_mbuf *m = NULL;
-	int offset, offset2, offset3;
+	int offset, offset2, offset3, offset_hot, offset_cold;
 	int flag, flag2, flag3;
 	int ret;
 
@@ -2638,6 +2770,28 @@ test_mbuf_dyn(struct rte_mempool *pktmbuf_pool)
 	if (ret != -1)
 		GOTO_FAIL("dynamic field creation should fail (not avail)");
 
+	ret = rte_mbuf_dynfield_register(&dynfield_fail_hint);
+	if (ret != -1)
+		GOTO_FAIL("dynamic field creation should fail (bad hint)");
+
+	offset_hot = rte_mbuf_dynfield_register(&dynfield_hot);
+	offset_cold = rte_mbuf_dynfield_register(&dynfield_cold);
+	if (offset_hot == -1 || offset_cold == -1)
+		GOTO_FAIL("failed to register hot and cold dynamic fields");
+	if (offset_hot / RTE_CACHE_LINE_SIZE >
+			offset_cold / RTE_CACHE_LINE_SIZE)
+		GOTO_FAIL("hot dynamic field placed after the cold one");
+
+	/* The placement hint is not part of the field identity. */
+	dynfield_hot.flags = 0;
+	ret = rte_mbuf_dynfield_register(&dynfield_hot);
+	if (ret != offset_hot)
+		GOTO_FAIL("failed to lookup hot dynamic field, ret=%d: %s",
+			ret, strerror(errno));
+
+	printf("dynfield: offset_hot=%d, offset_cold=%d\n",
+		offset_hot, offset_cold);
+
 	flag = rte_mbuf_dynflag_register(&dynflag);
 	if (flag == -1)
 		GOTO_FAIL("failed to register dynamic flag, flag=%d: %s",
@@ -2739,6 +2893,12 @@ test_mbuf(void)
 		goto err;
 	}
 
+	/* test fast bulk alloc and free of single-segment direct mbufs */
+	if (test_pktmbuf_pool_fast_bulk() < 0) {
+		printf("test_pktmbuf_pool_fast_bulk() failed\n");
+		goto err;
+	}
+
 	/* test that the pointer to the data on a packet mbuf is set properly */
 	if (test_pktmbuf_pool_ptr(pktmbuf_pool) < 0) {
 		printf("test_pktmbuf_pool_ptr() failed\n");
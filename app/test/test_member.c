@@ -194,6 +194,31 @@ test_member_create_bad_param(void)
 		return -1;
 	}
 
+	bad_params.name = "bad_param6";
+	bad_params.type = RTE_MEMBER_TYPE_CF;
+	bad_params.num_keys = MAX_ENTRIES;
+	bad_params.num_set = 0;
+	/* Test with 0 set for CF should fail */
+	bad_setsum = rte_member_create(&bad_params);
+	if (bad_setsum != NULL) {
+		rte_member_free(bad_setsum);
+		printf("Impossible creating setsum successfully with invalid "
+			"number of set for CF\n");
+		return -1;
+	}
+
+	bad_params.name = "bad_param7";
+	bad_params.type = RTE_MEMBER_TYPE_SKETCH;
+	bad_params.error_rate = 0;
+	/* Test with 0 error rate for sketch should fail */
+	bad_setsum = rte_member_create(&bad_params);
+	if (bad_setsum != NULL) {
+		rte_member_free(bad_setsum);
+		printf("Impossible creating setsum successfully with invalid "
+			"error rate for sketch\n");
+		return -1;
+	}
+
 	bad_params.name = "bad_param4";
 	bad_params.type = RTE_MEMBER_TYPE_HT;
 	bad_params.num_keys = RTE_MEMBER_BUCKET_ENTRIES / 2;
@@ -517,6 +542,220 @@ static int test_member_multimatch(void)
 	return 0;
 }
 
+/*
+ * Sequence of operations for the cuckoo filter
+ *
+ *  - insert the keys, with an invalid set id: fail
+ *  - single, bulk and multimatch lookup: hit
+ *  - delete with the wrong set id: fail
+ *  - delete the keys: miss
+ *  - fill the filter: no false negative
+ */
+static int test_member_cf(void)
+{
+	struct rte_member_setsum *setsum_cf;
+	const void *key_array[NUM_SAMPLES];
+	member_set_t set_ids[MAX_MATCH] = {0};
+	member_set_t set_id;
+	uint32_t i, num_added = 0;
+	int ret;
+
+	params.name = "test_member_cf";
+	params.type = RTE_MEMBER_TYPE_CF;
+	params.key_len = sizeof(struct flow_key);
+	setsum_cf = rte_member_create(&params);
+	TEST_ASSERT(setsum_cf != NULL, "CF creation failed");
+
+	TEST_ASSERT(rte_member_add(setsum_cf, &keys[0], params.num_set + 1) < 0,
+			"insert with invalid set id error");
+
+	for (i = 0; i < NUM_SAMPLES; i++) {
+		ret = rte_member_add(setsum_cf, &keys[i], test_set[i]);
+		TEST_ASSERT(ret >= 0, "insert error");
+		key_array[i] = &keys[i];
+	}
+
+	for (i = 0; i < NUM_SAMPLES; i++) {
+		ret = rte_member_lookup(setsum_cf, &keys[i], &set_id);
+		TEST_ASSERT(ret == 1 && set_id == test_set[i],
+				"single lookup set value error");
+		ret = rte_member_lookup_multi(setsum_cf, &keys[i], MAX_MATCH,
+				set_ids);
+		TEST_ASSERT(ret == 1 && set_ids[0] == test_set[i],
+				"single lookup_multi error");
+	}
+	ret = rte_member_lookup_bulk(setsum_cf, key_array, NUM_SAMPLES,
+			set_ids);
+	TEST_ASSERT(ret == NUM_SAMPLES, "bulk lookup function error");
+	for (i = 0; i < NUM_SAMPLES; i++)
+		TEST_ASSERT(set_ids[i] == test_set[i],
+				"bulk lookup result error");
+
+	TEST_ASSERT(rte_member_delete(setsum_cf, &keys[0], test_set[1]) ==
+			-ENOENT, "delete with wrong set id error");
+	for (i = 0; i < NUM_SAMPLES; i++) {
+		ret = rte_member_delete(setsum_cf, &keys[i], test_set[i]);
+		TEST_ASSERT(ret == 0, "key deletion function error");
+		ret = rte_member_lookup(setsum_cf, &keys[i], &set_id);
+		TEST_ASSERT(ret == 0 && set_id == RTE_MEMBER_NO_MATCH,
+				"key deletion failed");
+	}
+	rte_member_free(setsum_cf);
+
+	/* Keys that could be added are always found */
+	params.key_len = KEY_SIZE;
+	setsum_cf = rte_member_create(&params);
+	TEST_ASSERT(setsum_cf != NULL, "CF creation failed");
+	for (i = 0; i < MAX_ENTRIES; i++) {
+		ret = rte_member_add(setsum_cf, &generated_keys[i], 1);
+		if (ret < 0)
+			break;
+		num_added++;
+	}
+	TEST_ASSERT(i == MAX_ENTRIES || ret == -ENOSPC, "insert error");
+	for (i = 0; i < num_added; i++) {
+		ret = rte_member_lookup(setsum_cf, &generated_keys[i],
+				&set_id);
+		TEST_ASSERT(ret == 1, "false negative error");
+	}
+	printf("CF filled to %.2f%% (%u/%u)\n",
+		(double)num_added / MAX_ENTRIES * 100, num_added, MAX_ENTRIES);
+	rte_member_free(setsum_cf);
+
+	return 0;
+}
+
+/*
+ * Count-min sketch: the estimated counts never underestimate, and the
+ * heavy hitters are reported by decreasing count.
+ */
+static int test_member_sketch(void)
+{
+	struct rte_member_setsum *setsum_sketch;
+	struct flow_key hh_keys[NUM_SAMPLES];
+	uint64_t counts[NUM_SAMPLES];
+	member_set_t set_id;
+	uint64_t count;
+	uint32_t i, j;
+	int ret;
+
+	params.name = "test_member_sketch";
+	params.type = RTE_MEMBER_TYPE_SKETCH;
+	params.key_len = sizeof(struct flow_key);
+	params.error_rate = 0.001;
+	params.top_k = NUM_SAMPLES;
+	setsum_sketch = rte_member_create(&params);
+	TEST_ASSERT(setsum_sketch != NULL, "sketch creation failed");
+
+	TEST_ASSERT(rte_member_lookup(setsum_sketch, &keys[0], &set_id) < 0,
+			"sketch lookup error");
+	TEST_ASSERT(rte_member_delete(setsum_sketch, &keys[0], 1) < 0,
+			"sketch does not support deletion, error");
+
+	/* key i is counted i + 1 times, 100 bytes each */
+	for (i = 0; i < NUM_SAMPLES; i++) {
+		for (j = 0; j <= i; j++) {
+			ret = rte_member_add_byte_count(setsum_sketch,
+					&keys[i], 100);
+			TEST_ASSERT(ret == 0, "sketch add error");
+		}
+	}
+	for (i = 0; i < NUM_SAMPLES; i++) {
+		ret = rte_member_query_count(setsum_sketch, &keys[i], &count);
+		TEST_ASSERT(ret == 0 && count >= (i + 1) * 100,
+				"sketch count error");
+	}
+
+	ret = rte_member_report_heavyhitter(setsum_sketch, hh_keys, counts);
+	TEST_ASSERT(ret == NUM_SAMPLES, "heavy hitter report error");
+	for (i = 0; i < NUM_SAMPLES; i++)
+		TEST_ASSERT(memcmp(&hh_keys[i], &keys[NUM_SAMPLES - 1 - i],
+				sizeof(struct flow_key)) == 0 &&
+				counts[i] >= (NUM_SAMPLES - i) * 100,
+				"heavy hitter order error");
+
+	rte_member_reset(setsum_sketch);
+	ret = rte_member_query_count(setsum_sketch, &keys[0], &count);
+	TEST_ASSERT(ret == 0 && count == 0, "sketch reset error");
+	ret = rte_member_report_heavyhitter(setsum_sketch, hh_keys, counts);
+	TEST_ASSERT(ret == 0, "heavy hitter reset error");
+
+	TEST_ASSERT(rte_member_add_byte_count(setsum_ht, &keys[0], 1) < 0,
+			"byte count added to HT error");
+
+	rte_member_free(setsum_sketch);
+	printf("sketch success\n");
+	return 0;
+}
+
+static int test_member_sketch_merged(void)
+{
+	const struct rte_member_setsum *sketches[2];
+	struct rte_member_setsum *setsum_sketch[2];
+	const void *key_array[NUM_SAMPLES];
+	struct flow_key hh_keys[NUM_SAMPLES];
+	uint32_t byte_counts[NUM_SAMPLES];
+	uint64_t counts[NUM_SAMPLES];
+	uint64_t count;
+	uint32_t i;
+	int ret;
+
+	params.type = RTE_MEMBER_TYPE_SKETCH;
+	params.key_len = sizeof(struct flow_key);
+	params.error_rate = 0.001;
+	params.top_k = NUM_SAMPLES;
+	params.name = "test_member_sketch0";
+	setsum_sketch[0] = rte_member_create(&params);
+	params.name = "test_member_sketch1";
+	params.prim_hash_seed++;
+	setsum_sketch[1] = rte_member_create(&params);
+	params.prim_hash_seed--;
+	TEST_ASSERT(setsum_sketch[0] != NULL && setsum_sketch[1] != NULL,
+			"sketch creation failed");
+	sketches[0] = setsum_sketch[0];
+	sketches[1] = setsum_sketch[1];
+
+	/* key i is counted (i + 1) * 100 bytes by each sketch */
+	for (i = 0; i < NUM_SAMPLES; i++) {
+		key_array[i] = &keys[i];
+		byte_counts[i] = (i + 1) * 100;
+	}
+	for (i = 0; i < 2; i++) {
+		ret = rte_member_add_byte_count_bulk(setsum_sketch[i],
+				key_array, byte_counts, NUM_SAMPLES);
+		TEST_ASSERT(ret == 0, "sketch bulk add error");
+	}
+
+	for (i = 0; i < NUM_SAMPLES; i++) {
+		ret = rte_member_query_count(setsum_sketch[0], &keys[i],
+				&count);
+		TEST_ASSERT(ret == 0 && count >= byte_counts[i],
+				"sketch bulk count error");
+		ret = rte_member_query_count_merged(sketches, 2, &keys[i],
+				&count);
+		TEST_ASSERT(ret == 0 && count >= 2 * byte_counts[i],
+				"merged sketch count error");
+	}
+
+	ret = rte_member_report_heavyhitter_merged(sketches, 2, hh_keys,
+			counts);
+	TEST_ASSERT(ret == NUM_SAMPLES, "merged heavy hitter report error");
+	for (i = 0; i < NUM_SAMPLES; i++)
+		TEST_ASSERT(memcmp(&hh_keys[i], &keys[NUM_SAMPLES - 1 - i],
+				sizeof(struct flow_key)) == 0 &&
+				counts[i] >= 2 * byte_counts[NUM_SAMPLES - 1 - i],
+				"merged heavy hitter order error");
+
+	sketches[1] = setsum_ht;
+	TEST_ASSERT(rte_member_query_count_merged(sketches, 2, &keys[0],
+			&count) < 0, "HT merged with sketch error");
+
+	rte_member_free(setsum_sketch[0]);
+	rte_member_free(setsum_sketch[1]);
+	printf("merged sketch success\n");
+	return 0;
+}
+
 static int key_compare(const void *key1, const void *key2)
 {
 	return memcmp(key1, key2, KEY_SIZE);
@@ -707,6 +946,11 @@ test_member(void)
 		rte_member_free(setsum_cache);
 		return -1;
 	}
+	if (test_member_cf() < 0 || test_member_sketch() < 0 ||
+			test_member_sketch_merged() < 0) {
+		perform_free();
+		return -1;
+	}
 
 	perform_free();
 	return 0;
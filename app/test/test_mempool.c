@@ -208,6 +208,80 @@ static int test_mempool_creation_with_exceeded_cache_size(void)
 	return 0;
 }
 
+#define ADAPTIVE_CACHE_SIZE	32
+#define ADAPTIVE_BURST		64
+
+/*
+ * Adaptive cache: bursts larger than the cache make it grow, while objects
+ * left unused in the cache make it shrink back.
+ */
+static int
+test_mempool_adaptive_cache(void)
+{
+	struct rte_mempool_cache *cache;
+	struct rte_mempool *mp;
+	void *objs[ADAPTIVE_BURST];
+	uint32_t size;
+	unsigned int i;
+	int ret = 0;
+
+	mp = rte_mempool_create("test_adaptive_cache", MEMPOOL_SIZE,
+		MEMPOOL_ELT_SIZE, ADAPTIVE_CACHE_SIZE, 0,
+		NULL, NULL, my_obj_init, NULL, SOCKET_ID_ANY, 0);
+	if (mp == NULL)
+		RET_ERR();
+	cache = rte_mempool_default_cache(mp, rte_lcore_id());
+
+	/* bounds must include the creation size */
+	if (rte_mempool_cache_adaptive_set(mp, 8, ADAPTIVE_CACHE_SIZE / 2) !=
+			-EINVAL ||
+	    rte_mempool_cache_adaptive_set(mp, 0, 256) != -EINVAL ||
+	    rte_mempool_cache_adaptive_set(mp, 8,
+			RTE_MEMPOOL_CACHE_MAX_SIZE + 1) != -EINVAL)
+		GOTO_ERR(ret, out);
+	if (rte_mempool_cache_adaptive_set(mp, 8, 256) != 0)
+		GOTO_ERR(ret, out);
+
+	for (i = 0; i < 4 * RTE_MEMPOOL_CACHE_PERIOD; i++) {
+		if (rte_mempool_get_bulk(mp, objs, ADAPTIVE_BURST) < 0)
+			GOTO_ERR(ret, out);
+		rte_mempool_put_bulk(mp, objs, ADAPTIVE_BURST);
+	}
+	size = cache->size;
+	printf("adaptive cache grew to %u\n", size);
+	if (size <= ADAPTIVE_BURST)
+		GOTO_ERR(ret, out);
+#ifdef RTE_LIBRTE_MEMPOOL_STATS
+	if (cache->stats.grows == 0 || cache->stats.calls == 0)
+		GOTO_ERR(ret, out);
+#endif
+
+	for (i = 0; i < 4 * RTE_MEMPOOL_CACHE_PERIOD; i++) {
+		if (rte_mempool_get(mp, &objs[0]) < 0)
+			GOTO_ERR(ret, out);
+		rte_mempool_put(mp, objs[0]);
+	}
+	printf("adaptive cache shrank to %u\n", cache->size);
+	if (cache->size >= size)
+		GOTO_ERR(ret, out);
+#ifdef RTE_LIBRTE_MEMPOOL_STATS
+	if (cache->stats.shrinks == 0)
+		GOTO_ERR(ret, out);
+#endif
+
+	if (rte_mempool_avail_count(mp) != mp->size)
+		GOTO_ERR(ret, out);
+
+	/* back to a fixed size */
+	if (rte_mempool_cache_adaptive_set(mp, 0, 0) != 0 ||
+	    cache->size != ADAPTIVE_CACHE_SIZE)
+		GOTO_ERR(ret, out);
+
+out:
+	rte_mempool_free(mp);
+	return ret;
+}
+
 static struct rte_mempool *mp_spsc;
 static rte_spinlock_t scsp_spinlock;
 static void *scsp_obj_table[MAX_KEEP];
@@ -485,6 +559,7 @@ test_mempool(void)
 	struct rte_mempool *mp_stack_anon = NULL;
 	struct rte_mempool *mp_stack_mempool_iter = NULL;
 	struct rte_mempool *mp_stack = NULL;
+	struct rte_mempool *mp_numa = NULL;
 	struct rte_mempool *default_pool = NULL;
 	struct mp_data cb_arg = {
 		.ret = -1
@@ -583,6 +658,27 @@ test_mempool(void)
 	}
 	rte_mempool_obj_iter(mp_stack, my_obj_init, NULL);
 
+	/* create a mempool with per-socket sub-pools */
+	mp_numa = rte_mempool_create_empty("test_numa",
+		MEMPOOL_SIZE,
+		MEMPOOL_ELT_SIZE,
+		RTE_MEMPOOL_CACHE_MAX_SIZE, 0,
+		SOCKET_ID_ANY, 0);
+
+	if (mp_numa == NULL) {
+		printf("cannot allocate mp_numa mempool\n");
+		GOTO_ERR(ret, err);
+	}
+	if (rte_mempool_set_ops_byname(mp_numa, "numa", NULL) < 0) {
+		printf("cannot set numa handler\n");
+		GOTO_ERR(ret, err);
+	}
+	if (rte_mempool_populate_default(mp_numa) < 0) {
+		printf("cannot populate mp_numa mempool\n");
+		GOTO_ERR(ret, err);
+	}
+	rte_mempool_obj_iter(mp_numa, my_obj_init, NULL);
+
 	/* Create a mempool based on Default handler */
 	printf("Testing %s mempool handler\n", default_pool_ops);
 	default_pool = rte_mempool_create_empty("default_pool",
@@ -640,6 +736,9 @@ test_mempool(void)
 	if (test_mempool_creation_with_exceeded_cache_size() < 0)
 		GOTO_ERR(ret, err);
 
+	if (test_mempool_adaptive_cache() < 0)
+		GOTO_ERR(ret, err);
+
 	if (test_mempool_same_name_twice_creation() < 0)
 		GOTO_ERR(ret, err);
 
@@ -647,6 +746,10 @@ test_mempool(void)
 	if (test_mempool_basic(mp_stack, 1) < 0)
 		GOTO_ERR(ret, err);
 
+	/* test the numa handler */
+	if (test_mempool_basic(mp_numa, 1) < 0)
+		GOTO_ERR(ret, err);
+
 	if (test_mempool_basic(default_pool, 1) < 0)
 		GOTO_ERR(ret, err);
 
@@ -660,6 +763,7 @@ test_mempool(void)
 	rte_mempool_free(mp_stack_anon);
 	rte_mempool_free(mp_stack_mempool_iter);
 	rte_mempool_free(mp_stack);
+	rte_mempool_free(mp_numa);
 	rte_mempool_free(default_pool);
 
 	return ret;
@@ -37,6 +37,9 @@
 #define TM_TEST_TRTCM_PBS_DF 4096
 #define TM_TEST_TRTCM_EBS_DF 4096
 
+#define TM_TEST_BULK_SIZE 64
+#define TM_TEST_BULK_N_METERS 13
+
 static struct rte_meter_srtcm_params sparams =
 				{.cir = TM_TEST_SRTCM_CIR_DF,
 				 .cbs = TM_TEST_SRTCM_CBS_DF,
@@ -676,6 +679,195 @@ tm_test_trtcm_rfc4115_color_aware_check(void)
 	return 0;
 }
 
+/**
+ * functional test for rte_meter_srtcm_color_blind_check_bulk and
+ * rte_meter_srtcm_color_aware_check_bulk, against the per packet checks
+ */
+static inline int
+tm_test_srtcm_bulk_check(void)
+{
+#define SRTCM_BULK_CHECK_MSG "srtcm_bulk_check"
+	struct rte_meter_srtcm_profile sp;
+	struct rte_meter_srtcm sm[TM_TEST_BULK_N_METERS];
+	struct rte_meter_srtcm bm[TM_TEST_BULK_N_METERS];
+	struct rte_meter_srtcm *m[TM_TEST_BULK_SIZE];
+	struct rte_meter_srtcm_profile *p[TM_TEST_BULK_SIZE];
+	uint32_t pkt_len[TM_TEST_BULK_SIZE];
+	enum rte_color in[TM_TEST_BULK_SIZE], out[TM_TEST_BULK_SIZE];
+	uint64_t time;
+	uint32_t i, j;
+
+	if (rte_meter_srtcm_profile_config(&sp, &sparams) != 0)
+		melog(SRTCM_BULK_CHECK_MSG);
+	for (i = 0; i < TM_TEST_BULK_N_METERS; i++) {
+		if (rte_meter_srtcm_config(&sm[i], &sp) != 0)
+			melog(SRTCM_BULK_CHECK_MSG);
+		bm[i] = sm[i];
+	}
+
+	/* Several packets of the burst use the same meter */
+	for (i = 0; i < TM_TEST_BULK_SIZE; i++) {
+		m[i] = &bm[(i * 7) % TM_TEST_BULK_N_METERS];
+		p[i] = &sp;
+		pkt_len[i] = 64 + (i * 97) % 1454;
+		in[i] = (enum rte_color)(i % RTE_COLORS);
+	}
+
+	time = rte_get_tsc_cycles();
+	for (j = 0; j < 4; j++) {
+		time += rte_get_tsc_hz() / 100000;
+
+		rte_meter_srtcm_color_blind_check_bulk(m, p, time, pkt_len,
+			out, TM_TEST_BULK_SIZE);
+		for (i = 0; i < TM_TEST_BULK_SIZE; i++)
+			if (rte_meter_srtcm_color_blind_check(
+				&sm[(i * 7) % TM_TEST_BULK_N_METERS], &sp, time,
+				pkt_len[i]) != out[i])
+				melog(SRTCM_BULK_CHECK_MSG" blind %u", i);
+
+		/* In place input and output colors */
+		memcpy(out, in, sizeof(out));
+		rte_meter_srtcm_color_aware_check_bulk(m, p, time, pkt_len,
+			out, out, TM_TEST_BULK_SIZE);
+		for (i = 0; i < TM_TEST_BULK_SIZE; i++)
+			if (rte_meter_srtcm_color_aware_check(
+				&sm[(i * 7) % TM_TEST_BULK_N_METERS], &sp, time,
+				pkt_len[i], in[i]) != out[i])
+				melog(SRTCM_BULK_CHECK_MSG" aware %u", i);
+	}
+
+	if (memcmp(sm, bm, sizeof(sm)) != 0)
+		melog(SRTCM_BULK_CHECK_MSG" state");
+
+	return 0;
+}
+
+/**
+ * functional test for rte_meter_trtcm_color_blind_check_bulk and
+ * rte_meter_trtcm_color_aware_check_bulk, against the per packet checks
+ */
+static inline int
+tm_test_trtcm_bulk_check(void)
+{
+#define TRTCM_BULK_CHECK_MSG "trtcm_bulk_check"
+	struct rte_meter_trtcm_profile sp;
+	struct rte_meter_trtcm sm[TM_TEST_BULK_N_METERS];
+	struct rte_meter_trtcm bm[TM_TEST_BULK_N_METERS];
+	struct rte_meter_trtcm *m[TM_TEST_BULK_SIZE];
+	struct rte_meter_trtcm_profile *p[TM_TEST_BULK_SIZE];
+	uint32_t pkt_len[TM_TEST_BULK_SIZE];
+	enum rte_color in[TM_TEST_BULK_SIZE], out[TM_TEST_BULK_SIZE];
+	uint64_t time;
+	uint32_t i, j;
+
+	if (rte_meter_trtcm_profile_config(&sp, &tparams) != 0)
+		melog(TRTCM_BULK_CHECK_MSG);
+	for (i = 0; i < TM_TEST_BULK_N_METERS; i++) {
+		if (rte_meter_trtcm_config(&sm[i], &sp) != 0)
+			melog(TRTCM_BULK_CHECK_MSG);
+		bm[i] = sm[i];
+	}
+
+	/* Several packets of the burst use the same meter */
+	for (i = 0; i < TM_TEST_BULK_SIZE; i++) {
+		m[i] = &bm[(i * 7) % TM_TEST_BULK_N_METERS];
+		p[i] = &sp;
+		pkt_len[i] = 64 + (i * 97) % 1454;
+		in[i] = (enum rte_color)(i % RTE_COLORS);
+	}
+
+	time = rte_get_tsc_cycles();
+	for (j = 0; j < 4; j++) {
+		time += rte_get_tsc_hz() / 100000;
+
+		rte_meter_trtcm_color_blind_check_bulk(m, p, time, pkt_len,
+			out, TM_TEST_BULK_SIZE);
+		for (i = 0; i < TM_TEST_BULK_SIZE; i++)
+			if (rte_meter_trtcm_color_blind_check(
+				&sm[(i * 7) % TM_TEST_BULK_N_METERS], &sp, time,
+				pkt_len[i]) != out[i])
+				melog(TRTCM_BULK_CHECK_MSG" blind %u", i);
+
+		/* In place input and output colors */
+		memcpy(out, in, sizeof(out));
+		rte_meter_trtcm_color_aware_check_bulk(m, p, time, pkt_len,
+			out, out, TM_TEST_BULK_SIZE);
+		for (i = 0; i < TM_TEST_BULK_SIZE; i++)
+			if (rte_meter_trtcm_color_aware_check(
+				&sm[(i * 7) % TM_TEST_BULK_N_METERS], &sp, time,
+				pkt_len[i], in[i]) != out[i])
+				melog(TRTCM_BULK_CHECK_MSG" aware %u", i);
+	}
+
+	if (memcmp(sm, bm, sizeof(sm)) != 0)
+		melog(TRTCM_BULK_CHECK_MSG" state");
+
+	return 0;
+}
+
+/**
+ * functional test for rte_meter_trtcm_rfc4115_color_blind_check_bulk and
+ * rte_meter_trtcm_rfc4115_color_aware_check_bulk, against the per packet checks
+ */
+static inline int
+tm_test_trtcm_rfc4115_bulk_check(void)
+{
+#define TRTCM_RFC4115_BULK_CHECK_MSG "trtcm_rfc4115_bulk_check"
+	struct rte_meter_trtcm_rfc4115_profile sp;
+	struct rte_meter_trtcm_rfc4115 sm[TM_TEST_BULK_N_METERS];
+	struct rte_meter_trtcm_rfc4115 bm[TM_TEST_BULK_N_METERS];
+	struct rte_meter_trtcm_rfc4115 *m[TM_TEST_BULK_SIZE];
+	struct rte_meter_trtcm_rfc4115_profile *p[TM_TEST_BULK_SIZE];
+	uint32_t pkt_len[TM_TEST_BULK_SIZE];
+	enum rte_color in[TM_TEST_BULK_SIZE], out[TM_TEST_BULK_SIZE];
+	uint64_t time;
+	uint32_t i, j;
+
+	if (rte_meter_trtcm_rfc4115_profile_config(&sp, &rfc4115params) != 0)
+		melog(TRTCM_RFC4115_BULK_CHECK_MSG);
+	for (i = 0; i < TM_TEST_BULK_N_METERS; i++) {
+		if (rte_meter_trtcm_rfc4115_config(&sm[i], &sp) != 0)
+			melog(TRTCM_RFC4115_BULK_CHECK_MSG);
+		bm[i] = sm[i];
+	}
+
+	/* Several packets of the burst use the same meter */
+	for (i = 0; i < TM_TEST_BULK_SIZE; i++) {
+		m[i] = &bm[(i * 7) % TM_TEST_BULK_N_METERS];
+		p[i] = &sp;
+		pkt_len[i] = 64 + (i * 97) % 1454;
+		in[i] = (enum rte_color)(i % RTE_COLORS);
+	}
+
+	time = rte_get_tsc_cycles();
+	for (j = 0; j < 4; j++) {
+		time += rte_get_tsc_hz() / 100000;
+
+		rte_meter_trtcm_rfc4115_color_blind_check_bulk(m, p, time, pkt_len,
+			out, TM_TEST_BULK_SIZE);
+		for (i = 0; i < TM_TEST_BULK_SIZE; i++)
+			if (rte_meter_trtcm_rfc4115_color_blind_check(
+				&sm[(i * 7) % TM_TEST_BULK_N_METERS], &sp, time,
+				pkt_len[i]) != out[i])
+				melog(TRTCM_RFC4115_BULK_CHECK_MSG" blind %u", i);
+
+		/* In place input and output colors */
+		memcpy(out, in, sizeof(out));
+		rte_meter_trtcm_rfc4115_color_aware_check_bulk(m, p, time, pkt_len,
+			out, out, TM_TEST_BULK_SIZE);
+		for (i = 0; i < TM_TEST_BULK_SIZE; i++)
+			if (rte_meter_trtcm_rfc4115_color_aware_check(
+				&sm[(i * 7) % TM_TEST_BULK_N_METERS], &sp, time,
+				pkt_len[i], in[i]) != out[i])
+				melog(TRTCM_RFC4115_BULK_CHECK_MSG" aware %u", i);
+	}
+
+	if (memcmp(sm, bm, sizeof(sm)) != 0)
+		melog(TRTCM_RFC4115_BULK_CHECK_MSG" state");
+
+	return 0;
+}
+
 /**
  * test main entrance for library meter
  */
@@ -709,6 +901,15 @@ test_meter(void)
 	if (tm_test_trtcm_rfc4115_color_aware_check() != 0)
 		return -1;
 
+	if (tm_test_srtcm_bulk_check() != 0)
+		return -1;
+
+	if (tm_test_trtcm_bulk_check() != 0)
+		return -1;
+
+	if (tm_test_trtcm_rfc4115_bulk_check() != 0)
+		return -1;
+
 	return 0;
 
 }
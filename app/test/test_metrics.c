@@ -3,10 +3,12 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
 #include <errno.h>
 
+#include <rte_launch.h>
 #include <rte_lcore.h>
 #include <rte_metrics.h>
 
@@ -16,6 +18,8 @@
 #define	METRIC_LESSER_COUNT	3
 #define	KEY	1
 #define	VALUE	1
+#define	CONCURRENT_SET_SIZE	4
+#define	CONCURRENT_UPDATES	100000
 
 /* Initializes metric module. This function must be called
  * from a primary process before metrics are used
@@ -271,6 +275,85 @@ test_metrics_get_values(void)
 	return TEST_SUCCESS;
 }
 
+struct concurrent_update {
+	int key;
+	uint32_t done;
+};
+
+static int
+concurrent_update_worker(void *arg)
+{
+	struct concurrent_update *cu = arg;
+	uint64_t value[CONCURRENT_SET_SIZE];
+	uint32_t i, j;
+	int err = 0;
+
+	for (i = 1; i <= CONCURRENT_UPDATES && err == 0; i++) {
+		for (j = 0; j != RTE_DIM(value); j++)
+			value[j] = i;
+		err = rte_metrics_update_values(0, cu->key, value,
+				RTE_DIM(value));
+	}
+
+	__atomic_store_n(&cu->done, 1, __ATOMIC_RELEASE);
+	return err;
+}
+
+/* Test that a set of values is never read partially updated */
+static int
+test_metrics_update_values_concurrent(void)
+{
+	const char * const mnames[CONCURRENT_SET_SIZE] = {
+		"concurrent_0", "concurrent_1",
+		"concurrent_2", "concurrent_3",
+	};
+	struct rte_metric_value *getvalues;
+	struct concurrent_update cu;
+	unsigned int lcore_id;
+	int i, cnt, err;
+
+	lcore_id = rte_get_next_lcore(-1, 1, 0);
+	if (lcore_id >= RTE_MAX_LCORE) {
+		printf("%s: no worker lcore, skipping\n", __func__);
+		return TEST_SKIPPED;
+	}
+
+	cu.key = rte_metrics_reg_names(mnames, RTE_DIM(mnames));
+	TEST_ASSERT(cu.key >= 0, "%s, %d", __func__, __LINE__);
+	cu.done = 0;
+
+	cnt = rte_metrics_get_values(0, NULL, 0);
+	TEST_ASSERT(cnt >= cu.key + CONCURRENT_SET_SIZE, "%s, %d",
+			__func__, __LINE__);
+	getvalues = calloc(cnt, sizeof(*getvalues));
+	TEST_ASSERT(getvalues != NULL, "%s, %d", __func__, __LINE__);
+
+	err = rte_eal_remote_launch(concurrent_update_worker, &cu, lcore_id);
+	TEST_ASSERT(err == 0, "%s, %d", __func__, __LINE__);
+
+	err = 0;
+	while (__atomic_load_n(&cu.done, __ATOMIC_ACQUIRE) == 0 && err == 0) {
+		err = rte_metrics_get_values(0, getvalues, cnt);
+		if (err != cnt) {
+			err = -1;
+			break;
+		}
+		err = 0;
+		for (i = 1; i != CONCURRENT_SET_SIZE; i++) {
+			if (getvalues[cu.key + i].value !=
+					getvalues[cu.key].value)
+				err = -1;
+		}
+	}
+
+	if (rte_eal_wait_lcore(lcore_id) != 0)
+		err = -1;
+	free(getvalues);
+	TEST_ASSERT(err == 0, "%s, %d", __func__, __LINE__);
+
+	return TEST_SUCCESS;
+}
+
 static struct unit_test_suite metrics_testsuite  = {
 	.suite_name = "Metrics Unit Test Suite",
 	.setup = NULL,
@@ -313,7 +396,12 @@ static struct unit_test_suite metrics_testsuite  = {
 		 */
 		TEST_CASE(test_metrics_get_values),
 
-		/* TEST CASE 8: Test to unregister metrics*/
+		/* TEST CASE 8: Test that a list of values updated by a worker
+		 * lcore is read consistently
+		 */
+		TEST_CASE(test_metrics_update_values_concurrent),
+
+		/* TEST CASE 9: Test to unregister metrics*/
 		TEST_CASE(test_metrics_deinitialize),
 
 		TEST_CASES_END()
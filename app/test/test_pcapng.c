@@ -0,0 +1,284 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Microsoft Corporation
+ */
+
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <rte_ethdev.h>
+#include <rte_ether.h>
+#include <rte_mbuf.h>
+#include <rte_mempool.h>
+#include <rte_cycles.h>
+#include <rte_pcapng.h>
+#include <rte_time.h>
+
+#include "test.h"
+
+#define NUM_PACKETS	10
+#define DUMMY_MBUF_NUM	1
+#define SNAPLEN		48
+#define BLOCK_SHB	0x0A0D0D0A
+#define BLOCK_ISB	5
+#define BLOCK_EPB	6
+
+static struct rte_mempool *mp;
+static const uint32_t pkt_len = 200;
+static char file_name[] = "/tmp/pcapng_test_XXXXXX.pcapng";
+
+/* first mbuf in the packet, should always be at offset 0 */
+struct dummy_mbuf {
+	struct rte_mbuf mb[DUMMY_MBUF_NUM];
+	uint8_t buf[DUMMY_MBUF_NUM][RTE_MBUF_DEFAULT_BUF_SIZE];
+};
+
+static void
+dummy_mbuf_prep(struct rte_mbuf *mb, uint8_t buf[], uint32_t buf_len,
+	uint32_t data_len)
+{
+	uint32_t i;
+	uint8_t *db;
+
+	mb->buf_addr = buf;
+	mb->buf_iova = (uintptr_t)buf;
+	mb->buf_len = buf_len;
+	rte_mbuf_refcnt_set(mb, 1);
+
+	/* set pool pointer to dummy value, test doesn't use it */
+	mb->pool = (void *)buf;
+
+	rte_pktmbuf_reset(mb);
+	db = (uint8_t *)rte_pktmbuf_append(mb, data_len);
+
+	for (i = 0; i != data_len; i++)
+		db[i] = i;
+}
+
+/* Make an Ethernet packet consisting of a single segment */
+static void
+mbuf1_prepare(struct dummy_mbuf *dm, uint32_t plen)
+{
+	struct rte_ether_hdr eth = {
+		.d_addr.addr_bytes = "\xff\xff\xff\xff\xff\xff",
+		.ether_type = rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4),
+	};
+
+	memset(dm, 0, sizeof(*dm));
+	dummy_mbuf_prep(&dm->mb[0], dm->buf[0], sizeof(dm->buf[0]), plen);
+
+	rte_eth_random_addr(eth.s_addr.addr_bytes);
+	memcpy(rte_pktmbuf_mtod(dm->mb, void *), &eth, sizeof(eth));
+}
+
+static uint64_t
+current_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_REALTIME, &ts);
+	return rte_timespec_to_ns(&ts);
+}
+
+static int
+test_setup(void)
+{
+	int tmp_fd;
+
+	tmp_fd = mkstemps(file_name, strlen(".pcapng"));
+	if (tmp_fd == -1) {
+		perror("mkstemps() failure");
+		return -1;
+	}
+	printf("pcapng: output file %s\n", file_name);
+	close(tmp_fd);
+
+	/* Make a pool for cloned packets */
+	mp = rte_pktmbuf_pool_create("pcapng_test_pool", NUM_PACKETS, 0, 0,
+				     rte_pcapng_mbuf_size(pkt_len),
+				     SOCKET_ID_ANY);
+	if (mp == NULL) {
+		fprintf(stderr, "Cannot create mempool\n");
+		return -1;
+	}
+	return 0;
+}
+
+static int
+test_write_packets(rte_pcapng_t *pcapng, uint32_t snaplen,
+		   unsigned int *count)
+{
+	struct rte_mbuf *orig;
+	struct dummy_mbuf mbfs;
+	unsigned int i;
+	ssize_t len;
+
+	mbuf1_prepare(&mbfs, pkt_len);
+	orig = &mbfs.mb[0];
+
+	for (i = 0; i < NUM_PACKETS; i++) {
+		struct rte_mbuf *mc;
+
+		/* every other packet comes with a stripped VLAN tag */
+		if (i & 1) {
+			orig->ol_flags = PKT_RX_VLAN_STRIPPED | PKT_RX_RSS_HASH;
+			orig->vlan_tci = i;
+			orig->hash.rss = 0x12345678;
+		} else {
+			orig->ol_flags = 0;
+		}
+
+		mc = rte_pcapng_copy(0, i, orig, mp, snaplen,
+				     rte_get_tsc_cycles(),
+				     RTE_PCAPNG_DIRECTION_IN);
+		if (mc == NULL) {
+			fprintf(stderr, "Cannot copy packet\n");
+			return -1;
+		}
+		TEST_ASSERT(rte_pktmbuf_pkt_len(mc) % sizeof(uint32_t) == 0,
+			    "pcapng block not padded");
+
+		len = rte_pcapng_write_packets(pcapng, &mc, 1);
+		rte_pktmbuf_free(mc);
+		if (len <= 0) {
+			fprintf(stderr, "Write of packets failed\n");
+			return -1;
+		}
+		++*count;
+	}
+
+	return 0;
+}
+
+/*
+ * Walk the blocks of the file back and check that the framing is sane:
+ * every block is 32 bit aligned, ends with a copy of its length and the
+ * packet blocks hold the expected amount of data.
+ */
+static int
+test_validate(uint32_t snaplen, unsigned int expected)
+{
+	uint32_t hdr[2], trailer, cap_len, orig_len;
+	unsigned int packets = 0, stats = 0;
+	bool section = false;
+	FILE *f;
+	long pos;
+
+	f = fopen(file_name, "r");
+	TEST_ASSERT_NOT_NULL(f, "Cannot open %s", file_name);
+
+	for (pos = 0; fread(hdr, sizeof(hdr), 1, f) == 1; pos += hdr[1]) {
+		if (hdr[1] % sizeof(uint32_t) != 0 || hdr[1] < 12)
+			goto fail;
+
+		if (!section && hdr[0] != BLOCK_SHB)
+			goto fail;
+		section = true;
+
+		if (hdr[0] == BLOCK_EPB) {
+			uint32_t epb[5];
+
+			if (fread(epb, sizeof(epb), 1, f) != 1)
+				goto fail;
+			cap_len = epb[3];
+			orig_len = epb[4];
+
+			/* stripped VLAN tags are put back in */
+			if (cap_len > RTE_MIN(pkt_len, snaplen) +
+				      sizeof(struct rte_vlan_hdr) ||
+			    orig_len < pkt_len || orig_len < cap_len)
+				goto fail;
+			++packets;
+		} else if (hdr[0] == BLOCK_ISB) {
+			++stats;
+		}
+
+		if (fseek(f, pos + hdr[1] - sizeof(trailer), SEEK_SET) != 0 ||
+		    fread(&trailer, sizeof(trailer), 1, f) != 1 ||
+		    trailer != hdr[1])
+			goto fail;
+	}
+	fclose(f);
+
+	TEST_ASSERT(section, "No section header in file");
+	TEST_ASSERT_EQUAL(packets, expected,
+			  "Found %u packets, expected %u", packets, expected);
+	TEST_ASSERT_EQUAL(stats, 1, "Found %u statistics blocks", stats);
+
+	return 0;
+fail:
+	fclose(f);
+	printf("pcapng: bad block at offset %ld\n", pos);
+	return -1;
+}
+
+static int
+test_write_pcapng(uint32_t snaplen)
+{
+	rte_pcapng_t *pcapng;
+	unsigned int count = 0;
+	uint64_t start_ns;
+	int ret, fd;
+
+	fd = open(file_name, O_WRONLY | O_TRUNC);
+	if (fd < 0) {
+		perror(file_name);
+		return -1;
+	}
+
+	pcapng = rte_pcapng_fdopen(fd, NULL, NULL, "pcapng_autotest",
+				   "Test file");
+	if (pcapng == NULL) {
+		fprintf(stderr, "rte_pcapng_fdopen failed\n");
+		close(fd);
+		return -1;
+	}
+
+	start_ns = current_ns();
+	ret = test_write_packets(pcapng, snaplen, &count);
+	if (ret == 0 &&
+	    rte_pcapng_write_stats(pcapng, 0, "end of test",
+				   start_ns, current_ns(), count, 0) <= 0) {
+		fprintf(stderr, "Write of statistics failed\n");
+		ret = -1;
+	}
+	rte_pcapng_close(pcapng);
+
+	if (ret != 0)
+		return -1;
+
+	return test_validate(snaplen, count);
+}
+
+static void
+test_cleanup(void)
+{
+	if (mp)
+		rte_mempool_free(mp);
+	mp = NULL;
+
+	remove(file_name);
+}
+
+static int
+test_pcapng(void)
+{
+	int ret;
+
+	if (test_setup() < 0)
+		return TEST_FAILED;
+
+	ret = test_write_pcapng(UINT32_MAX);
+	if (ret == 0)
+		ret = test_write_pcapng(SNAPLEN);
+
+	test_cleanup();
+
+	return ret == 0 ? TEST_SUCCESS : TEST_FAILED;
+}
+
+REGISTER_TEST_COMMAND(pcapng_autotest, test_pcapng);
@@ -7,6 +7,9 @@
 #include <limits.h>
 
 #include <ethdev_driver.h>
+#include <rte_bpf.h>
+#include <rte_cycles.h>
+#include <rte_malloc.h>
 #include <rte_pdump.h>
 #include "rte_eal.h"
 #include "rte_lcore.h"
@@ -20,6 +23,9 @@
 
 #define launch_p(ARGV) process_dup(ARGV, RTE_DIM(ARGV), __func__)
 
+/* time given to the primary to forward packets through a capture */
+#define PDUMP_WAIT_MS 1000
+
 struct rte_ring *ring_server;
 uint16_t portid;
 uint16_t flag_for_send_pkts = 1;
@@ -43,6 +49,154 @@ test_pdump_init(void)
 	return ret;
 }
 
+/*
+ * Filter which accepts no packets: "return 0".
+ * The primary process loads the program, so it has to be in shared memory.
+ */
+static struct rte_bpf_prm *
+pdump_alloc_filter(void)
+{
+	static const struct ebpf_insn reject_all[] = {
+		{
+			.code = (EBPF_ALU64 | EBPF_MOV | BPF_K),
+			.dst_reg = EBPF_REG_0,
+			.imm = 0,
+		},
+		{
+			.code = (BPF_JMP | EBPF_EXIT),
+		},
+	};
+	struct rte_bpf_prm *prm;
+	struct ebpf_insn *ins;
+
+	prm = rte_zmalloc("pdump_test_prm", sizeof(*prm) + sizeof(reject_all),
+			  0);
+	if (prm == NULL)
+		return NULL;
+
+	ins = (struct ebpf_insn *)(prm + 1);
+	memcpy(ins, reject_all, sizeof(reject_all));
+	prm->ins = ins;
+	prm->nb_ins = RTE_DIM(reject_all);
+	prm->prog_arg.type = RTE_BPF_ARG_PTR_MBUF;
+	prm->prog_arg.size = sizeof(struct rte_mbuf);
+	prm->prog_arg.buf_size = RTE_MBUF_DEFAULT_BUF_SIZE;
+
+	return prm;
+}
+
+/* wait for the primary to forward packets with capture enabled */
+static int
+pdump_wait_stats(uint16_t port, struct rte_pdump_stats *stats)
+{
+	unsigned int i;
+
+	for (i = 0; i < PDUMP_WAIT_MS; i++) {
+		if (rte_pdump_stats(port, stats) < 0) {
+			printf("rte_pdump_stats failed\n");
+			return -1;
+		}
+		if (stats->accepted + stats->filtered != 0)
+			return 0;
+		rte_delay_ms(1);
+	}
+
+	printf("no packet seen by pdump in %u ms\n", PDUMP_WAIT_MS);
+	return -1;
+}
+
+/* free the captured packets */
+static void
+pdump_drain_ring(struct rte_ring *ring)
+{
+	struct rte_mbuf *m;
+
+	while (rte_ring_dequeue(ring, (void **)&m) == 0)
+		rte_pktmbuf_free(m);
+}
+
+/*
+ * Check that the packets are all filtered out with a reject-all filter,
+ * and all accepted without filter. Stats are reset by each enable.
+ */
+static int
+pdump_check_filter(uint16_t port, struct rte_ring *ring,
+		   struct rte_mempool *mp, const struct rte_bpf_prm *prm)
+{
+	struct rte_pdump_stats stats;
+	int ret, failed = 0;
+
+	if (prm != NULL)
+		ret = rte_pdump_enable_bpf(port, QUEUE_ID, RTE_PDUMP_FLAG_RXTX,
+					   64, ring, mp, prm);
+	else
+		ret = rte_pdump_enable(port, QUEUE_ID, RTE_PDUMP_FLAG_RXTX,
+				       ring, mp, NULL);
+	if (ret < 0) {
+		printf("rte_pdump_enable%s failed\n", prm ? "_bpf" : "");
+		return -1;
+	}
+
+	if (pdump_wait_stats(port, &stats) < 0) {
+		failed++;
+	} else if (prm != NULL) {
+		if (stats.accepted != 0 || stats.filtered == 0) {
+			printf("filter accepted %"PRIu64" and rejected %"PRIu64
+			       " packets\n", stats.accepted, stats.filtered);
+			failed++;
+		}
+	} else if (stats.accepted == 0 || stats.filtered != 0) {
+		printf("no filter accepted %"PRIu64" and rejected %"PRIu64
+		       " packets\n", stats.accepted, stats.filtered);
+		failed++;
+	}
+
+	ret = rte_pdump_disable(port, QUEUE_ID, RTE_PDUMP_FLAG_RXTX);
+	if (ret < 0) {
+		printf("rte_pdump_disable failed\n");
+		failed++;
+	}
+	pdump_drain_ring(ring);
+
+	return failed ? -1 : 0;
+}
+
+static int
+run_pdump_bpf_tests(uint16_t port, struct rte_ring *ring,
+		    struct rte_mempool *mp)
+{
+	struct rte_bpf_prm *prm;
+	int failed = 0;
+
+	prm = pdump_alloc_filter();
+	if (prm == NULL) {
+		printf("cannot allocate BPF program\n");
+		return -1;
+	}
+
+	if (pdump_check_filter(port, ring, mp, prm) < 0)
+		failed++;
+	else
+		printf("pdump_enable_bpf success\n");
+
+	if (pdump_check_filter(port, ring, mp, NULL) < 0)
+		failed++;
+	else
+		printf("pdump_enable without filter success\n");
+
+	/* filter expecting raw data instead of an mbuf */
+	prm->prog_arg.type = RTE_BPF_ARG_PTR;
+	if (rte_pdump_enable_bpf(port, QUEUE_ID, RTE_PDUMP_FLAG_RX,
+				 UINT32_MAX, ring, mp, prm) == 0) {
+		printf("rte_pdump_enable_bpf accepted a bad filter\n");
+		rte_pdump_disable(port, QUEUE_ID, RTE_PDUMP_FLAG_RX);
+		failed++;
+	}
+
+	rte_free(prm);
+	return failed ? -1 : 0;
+}
+
 int
 run_pdump_client_tests(void)
 {
@@ -111,6 +265,9 @@ run_pdump_client_tests(void)
 			printf("\n***** flags = RTE_PDUMP_FLAG_RXTX *****\n");
 		}
 	}
+
+	printf("\n***** BPF filter *****\n");
+	ret = run_pdump_bpf_tests(portid, ring_client, mp);
 	if (ring_client != NULL)
 		test_ring_free(ring_client);
 	if (mp != NULL)
@@ -0,0 +1,111 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include <rte_common.h>
+#include <rte_pie.h>
+
+#include "test.h"
+
+#define TEST_TIME_HZ    1000000 /* time stamps in microseconds */
+#define TEST_PKT_LEN    1000
+#define TEST_TIME_STEP  1000    /* one packet dequeued every millisecond */
+#define TEST_N_STEPS    10000
+
+static const struct rte_pie_params pie_params = {
+	.qdelay_ref = 15,
+	.dp_update_interval = 15,
+	.max_burst = 150,
+	.tailq_th = 256,
+};
+
+static int
+test_pie_invalid_parameters(void)
+{
+	struct rte_pie_config config;
+	struct rte_pie_params params;
+
+	TEST_ASSERT(rte_pie_rt_data_init(NULL) != 0,
+		"NULL run-time data accepted\n");
+	TEST_ASSERT(rte_pie_config_init(NULL, &pie_params, TEST_TIME_HZ) != 0,
+		"NULL config accepted\n");
+	TEST_ASSERT(rte_pie_config_init(&config, &pie_params, 0) != 0,
+		"Null time frequency accepted\n");
+
+	params = pie_params;
+	params.qdelay_ref = 0;
+	TEST_ASSERT(rte_pie_config_init(&config, &params, TEST_TIME_HZ) != 0,
+		"Null latency target accepted\n");
+
+	params = pie_params;
+	params.tailq_th = 0;
+	TEST_ASSERT(rte_pie_config_init(&config, &params, TEST_TIME_HZ) != 0,
+		"Null tail drop threshold accepted\n");
+
+	return 0;
+}
+
+/* Enqueue n_in packets and dequeue one packet per time step */
+static void
+test_pie_run(const struct rte_pie_config *config, struct rte_pie *pie,
+	uint32_t n_in, uint32_t *n_dropped)
+{
+	uint64_t time = 0;
+	uint32_t qlen = 0;
+	uint32_t i, j;
+
+	*n_dropped = 0;
+	for (i = 0; i < TEST_N_STEPS; i++) {
+		time += TEST_TIME_STEP;
+
+		for (j = 0; j < n_in; j++) {
+			if (rte_pie_enqueue(config, pie, qlen, TEST_PKT_LEN,
+					time) == 0)
+				qlen++;
+			else
+				(*n_dropped)++;
+		}
+
+		if (qlen != 0) {
+			rte_pie_dequeue(pie, TEST_PKT_LEN, time);
+			qlen--;
+		}
+	}
+}
+
+static int
+test_pie(void)
+{
+	struct rte_pie_config config;
+	struct rte_pie pie;
+	uint32_t n_dropped;
+
+	if (test_pie_invalid_parameters() < 0)
+		return -1;
+
+	TEST_ASSERT_SUCCESS(rte_pie_config_init(&config, &pie_params,
+		TEST_TIME_HZ), "PIE config init failed\n");
+
+	/* Arrivals at the departure rate: no queueing delay */
+	TEST_ASSERT_SUCCESS(rte_pie_rt_data_init(&pie),
+		"PIE run-time data init failed\n");
+	test_pie_run(&config, &pie, 1, &n_dropped);
+	TEST_ASSERT_EQUAL(n_dropped, 0, "Packets dropped without congestion\n");
+	TEST_ASSERT(pie.drop_prob == 0, "Drop probability without congestion\n");
+
+	/* Arrivals at twice the departure rate: early drops */
+	TEST_ASSERT_SUCCESS(rte_pie_rt_data_init(&pie),
+		"PIE run-time data init failed\n");
+	test_pie_run(&config, &pie, 2, &n_dropped);
+	TEST_ASSERT(n_dropped > 0, "No packet dropped under congestion\n");
+	TEST_ASSERT(pie.drop_prob > 0, "No drop probability under congestion\n");
+	TEST_ASSERT(pie.qlen_bytes < config.tailq_th * TEST_PKT_LEN,
+		"Queue delay not controlled\n");
+
+	return 0;
+}
+
+REGISTER_TEST_COMMAND(pie_autotest, test_pie);
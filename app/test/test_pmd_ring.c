@@ -571,6 +571,112 @@ test_stats_reset_for_port(void)
 	return TEST_SUCCESS;
 }
 
+static int
+test_burst_stats_xstat(int port, const char *name, uint64_t expected)
+{
+	uint64_t id, value;
+
+	TEST_ASSERT(rte_eth_xstats_get_id_by_name(port, name, &id) == 0,
+			"xstat %s not found", name);
+	TEST_ASSERT(rte_eth_xstats_get_by_id(port, &id, &value, 1) == 1,
+			"xstat %s not retrieved", name);
+	TEST_ASSERT(value == expected, "xstat %s is %"PRIu64", expected %"
+			PRIu64, name, value, expected);
+
+	return TEST_SUCCESS;
+}
+
+static int
+test_burst_stats_for_port(void)
+{
+	struct rte_mbuf buf, *pbuf = &buf;
+	int port = rxtx_portc;
+
+	TEST_ASSERT(rte_eth_burst_stats_enable(port) == 0,
+			"burst stats enable failed");
+	TEST_ASSERT(rte_eth_xstats_reset(port) == 0, "xstats reset failed");
+
+	TEST_ASSERT(rte_eth_tx_burst(port, 0, &pbuf, 1) == 1,
+			"Failed to transmit packet burst port %d", port);
+	TEST_ASSERT(rte_eth_rx_burst(port, 0, &pbuf, 1) == 1,
+			"Failed to receive packet burst on port %d", port);
+	TEST_ASSERT(rte_eth_rx_burst(port, 0, &pbuf, 1) == 0,
+			"Unexpected packet on port %d", port);
+
+	if (test_burst_stats_xstat(port, "rx_q0_empty_polls", 1) != 0 ||
+			test_burst_stats_xstat(port, "rx_q0_bursts_1", 1) != 0 ||
+			test_burst_stats_xstat(port, "rx_q0_bursts_2_3", 0) != 0 ||
+			test_burst_stats_xstat(port, "tx_q0_bursts_1", 1) != 0 ||
+			test_burst_stats_xstat(port, "tx_q0_bursts_128_plus",
+				0) != 0)
+		return TEST_FAILED;
+
+	/* No more update once disabled */
+	TEST_ASSERT(rte_eth_burst_stats_disable(port) == 0,
+			"burst stats disable failed");
+	TEST_ASSERT(rte_eth_rx_burst(port, 0, &pbuf, 1) == 0,
+			"Unexpected packet on port %d", port);
+	if (test_burst_stats_xstat(port, "rx_q0_empty_polls", 1) != 0)
+		return TEST_FAILED;
+
+	TEST_ASSERT(rte_eth_xstats_reset(port) == 0, "xstats reset failed");
+	if (test_burst_stats_xstat(port, "rx_q0_empty_polls", 0) != 0)
+		return TEST_FAILED;
+
+	return TEST_SUCCESS;
+}
+
+static int
+test_burst_mode_port(void)
+{
+	struct rte_mbuf bufs[4], *pbufs[4], *rbufs[8];
+	uint16_t port;
+	int i;
+
+	for (i = 0; i < 4; i++)
+		pbufs[i] = &bufs[i];
+
+	/* the zero-copy ring API is not available with MP/MC rings */
+	TEST_ASSERT(rte_vdev_init("net_ring_burstmpmc",
+			"sync=MPMC,burst=1") != 0,
+			"burst mode accepted with MP/MC rings");
+
+	TEST_ASSERT(rte_vdev_init("net_ring_burst", "sync=HTS,burst=1") == 0,
+			"Failed to create burst mode port");
+	TEST_ASSERT(rte_eth_dev_get_port_by_name("net_ring_burst",
+			&port) == 0, "burst mode port not found");
+	TEST_ASSERT(test_ethdev_configure_port(port) == 0,
+			"test ethdev configure burst mode port failed");
+
+	TEST_ASSERT(rte_eth_tx_burst(port, 0, pbufs, 3) == 3,
+			"Failed to transmit burst of 3 on port %u", port);
+	TEST_ASSERT(rte_eth_tx_burst(port, 0, &pbufs[3], 1) == 1,
+			"Failed to transmit burst of 1 on port %u", port);
+
+	/* a burst can be received in parts, but is never merged */
+	TEST_ASSERT(rte_eth_rx_burst(port, 0, rbufs, 2) == 2,
+			"Failed to receive first part of burst on port %u",
+			port);
+	TEST_ASSERT(rbufs[0] == pbufs[0] && rbufs[1] == pbufs[1],
+			"Unexpected mbufs received on port %u", port);
+	TEST_ASSERT(rte_eth_rx_burst(port, 0, rbufs, 8) == 1,
+			"Failed to receive rest of burst on port %u", port);
+	TEST_ASSERT(rbufs[0] == pbufs[2],
+			"Unexpected mbuf received on port %u", port);
+	TEST_ASSERT(rte_eth_rx_burst(port, 0, rbufs, 8) == 1,
+			"Failed to receive second burst on port %u", port);
+	TEST_ASSERT(rbufs[0] == pbufs[3],
+			"Unexpected mbuf received on port %u", port);
+	TEST_ASSERT(rte_eth_rx_burst(port, 0, rbufs, 8) == 0,
+			"Unexpected packet on port %u", port);
+
+	TEST_ASSERT(rte_eth_dev_stop(port) == 0,
+			"Failed to stop burst mode port %u", port);
+	rte_vdev_uninit("net_ring_burst");
+
+	return TEST_SUCCESS;
+}
+
 static struct
 unit_test_suite test_pmd_ring_suite  = {
 	.setup = test_pmd_ringcreate_setup,
@@ -581,6 +687,8 @@ unit_test_suite test_pmd_ring_suite  = {
 		TEST_CASE(test_send_basic_packets),
 		TEST_CASE(test_get_stats_for_port),
 		TEST_CASE(test_stats_reset_for_port),
+		TEST_CASE(test_burst_stats_for_port),
+		TEST_CASE(test_burst_mode_port),
 		TEST_CASE(test_pmd_ring_pair_create_attach),
 		TEST_CASE(test_command_line_ring_port),
 		TEST_CASES_END()
@@ -9,15 +9,18 @@
 #include <rte_cycles.h>
 #include <rte_random.h>
 
+#include "perf_harness.h"
 #include "test.h"
 
 static volatile uint64_t vsum;
 
-#define ITERATIONS (100000000)
+#define ITERATIONS (10000000)
 
 #define BEST_CASE_BOUND (1<<16)
 #define WORST_CASE_BOUND (BEST_CASE_BOUND + 1)
 
+#define BULK_SIZE 32
+
 enum rand_type {
 	rand_type_64,
 	rand_type_bounded_best_case,
@@ -40,17 +43,12 @@ rand_type_desc(enum rand_type rand_type)
 }
 
 static __rte_always_inline void
-test_rand_perf_type(enum rand_type rand_type)
+test_rand_perf_type(enum rand_type rand_type, unsigned int n)
 {
-	uint64_t start;
-	uint32_t i;
-	uint64_t end;
 	uint64_t sum = 0;
-	uint64_t op_latency;
-
-	start = rte_rdtsc();
+	uint32_t i;
 
-	for (i = 0; i < ITERATIONS; i++) {
+	for (i = 0; i < n; i++) {
 		switch (rand_type) {
 		case rand_type_64:
 			sum += rte_rand();
@@ -64,15 +62,71 @@ test_rand_perf_type(enum rand_type rand_type)
 		}
 	}
 
-	end = rte_rdtsc();
-
 	/* to avoid an optimizing compiler removing the whole loop */
 	vsum = sum;
+}
+
+static __rte_always_inline void
+test_rand_perf_bulk_type(enum rand_type rand_type, unsigned int n)
+{
+	uint64_t values[BULK_SIZE];
+	uint64_t sum = 0;
+	uint32_t i, j;
+
+	for (i = 0; i < n; i += BULK_SIZE) {
+		switch (rand_type) {
+		case rand_type_64:
+			rte_rand_bulk(values, BULK_SIZE);
+			break;
+		case rand_type_bounded_best_case:
+			rte_rand_max_bulk(BEST_CASE_BOUND, values, BULK_SIZE);
+			break;
+		case rand_type_bounded_worst_case:
+			rte_rand_max_bulk(WORST_CASE_BOUND, values, BULK_SIZE);
+			break;
+		}
+		for (j = 0; j < BULK_SIZE; j++)
+			sum += values[j];
+	}
+
+	vsum = sum;
+}
+
+/* One function per type, for the loop to be specialized. */
+static void
+test_rand_perf_64(void *arg __rte_unused, unsigned int n)
+{
+	test_rand_perf_type(rand_type_64, n);
+}
 
-	op_latency = (end - start) / ITERATIONS;
+static void
+test_rand_perf_best_case(void *arg __rte_unused, unsigned int n)
+{
+	test_rand_perf_type(rand_type_bounded_best_case, n);
+}
 
-	printf("%s: %"PRId64" TSC cycles/op\n", rand_type_desc(rand_type),
-	       op_latency);
+static void
+test_rand_perf_worst_case(void *arg __rte_unused, unsigned int n)
+{
+	test_rand_perf_type(rand_type_bounded_worst_case, n);
+}
+
+static void
+test_rand_perf_bulk_64(void *arg __rte_unused, unsigned int n)
+{
+	test_rand_perf_bulk_type(rand_type_64, n);
+}
+
+static void
+test_rand_perf_bulk_best_case(void *arg __rte_unused, unsigned int n)
+{
+	test_rand_perf_bulk_type(rand_type_bounded_best_case, n);
+}
+
+static void
+test_rand_perf_bulk_worst_case(void *arg __rte_unused, unsigned int n)
+{
+	test_rand_perf_bulk_type(rand_type_bounded_worst_case, n);
 }
 
 static int
@@ -82,9 +136,21 @@ test_rand_perf(void)
 
 	printf("Pseudo-random number generation latencies:\n");
 
-	test_rand_perf_type(rand_type_64);
-	test_rand_perf_type(rand_type_bounded_best_case);
-	test_rand_perf_type(rand_type_bounded_worst_case);
+	if (perf_run(rand_type_desc(rand_type_64), test_rand_perf_64,
+		     NULL, ITERATIONS) != 0 ||
+	    perf_run(rand_type_desc(rand_type_bounded_best_case),
+		     test_rand_perf_best_case, NULL, ITERATIONS) != 0 ||
+	    perf_run(rand_type_desc(rand_type_bounded_worst_case),
+		     test_rand_perf_worst_case, NULL, ITERATIONS) != 0)
+		return -1;
+
+	if (perf_run("Full 64-bit bulk [rte_rand_bulk()]",
+		     test_rand_perf_bulk_64, NULL, ITERATIONS) != 0 ||
+	    perf_run("Bounded average best-case bulk [rte_rand_max_bulk()]",
+		     test_rand_perf_bulk_best_case, NULL, ITERATIONS) != 0 ||
+	    perf_run("Bounded average worst-case bulk [rte_rand_max_bulk()]",
+		     test_rand_perf_bulk_worst_case, NULL, ITERATIONS) != 0)
+		return -1;
 
 	return 0;
 }
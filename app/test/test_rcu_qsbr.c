@@ -1407,6 +1407,13 @@ test_rcu_qsbr_main(void)
 	if (test_rcu_qsbr_dq_functional(7, 128, RTE_RCU_QSBR_DQ_MT_UNSAFE) < 0)
 		goto test_fail;
 
+	if (test_rcu_qsbr_dq_functional(303, 16, RTE_RCU_QSBR_DQ_PER_LCORE) < 0)
+		goto test_fail;
+
+	if (test_rcu_qsbr_dq_functional(8, 16, RTE_RCU_QSBR_DQ_PER_LCORE |
+			RTE_RCU_QSBR_DQ_RECLAIM_SERVICE) < 0)
+		goto test_fail;
+
 	free_rcu();
 
 	printf("\n");
@@ -330,6 +330,105 @@ test_reorder_drain(void)
 	return ret;
 }
 
+static int
+test_reorder_mp_insert(void)
+{
+	struct rte_reorder_buffer *b = NULL;
+	struct rte_mempool *p = test_params->p;
+	const unsigned int size = 8;
+	const unsigned int num_bufs = 5;
+	const uint32_t seqn[] = {0, 1, 3, 10, 2};
+	struct rte_mbuf *bufs[num_bufs];
+	struct rte_mbuf *robufs[num_bufs];
+	unsigned int i, cnt;
+	int ret = -1;
+
+	memset(robufs, 0, sizeof(robufs));
+	b = rte_reorder_create_with_flags("test_mp_insert", rte_socket_id(),
+			size, RTE_REORDER_F_MP_INSERT);
+	TEST_ASSERT_NOT_NULL(b, "Failed to create reorder buffer");
+
+	for (i = 0; i < num_bufs; i++) {
+		bufs[i] = rte_pktmbuf_alloc(p);
+		TEST_ASSERT_NOT_NULL(bufs[i], "Packet allocation failed\n");
+		*rte_reorder_seqn(bufs[i]) = seqn[i];
+	}
+
+	if (rte_reorder_insert(b, bufs[0]) != -1 || rte_errno != EINVAL) {
+		printf("%s:%d: No error on insert before setting seqn\n",
+				__func__, __LINE__);
+		goto exit;
+	}
+	if (rte_reorder_min_seqn_set(b, 0) != 0) {
+		printf("%s:%d: Cannot set min seqn\n", __func__, __LINE__);
+		goto exit;
+	}
+
+	/* OB[] = {0, 1, NULL, 3, ...} */
+	if (rte_reorder_insert_bulk(b, bufs, 3) != 3) {
+		printf("%s:%d: Cannot insert packets\n", __func__, __LINE__);
+		goto exit;
+	}
+	bufs[0] = bufs[1] = bufs[2] = NULL;
+
+	cnt = rte_reorder_drain(b, robufs, num_bufs);
+	if (cnt != 2 || *rte_reorder_seqn(robufs[0]) != 0 ||
+			*rte_reorder_seqn(robufs[1]) != 1) {
+		printf("%s:%d:%u: Unexpected packets drained\n",
+				__func__, __LINE__, cnt);
+		goto exit;
+	}
+	for (i = 0; i < cnt; i++) {
+		rte_pktmbuf_free(robufs[i]);
+		robufs[i] = NULL;
+	}
+
+	/* seqn 10 does not fit in the window until 2 is skipped */
+	if (rte_reorder_insert(b, bufs[3]) != -1 || rte_errno != ENOSPC) {
+		printf("%s:%d: No error on insert of early packet\n",
+				__func__, __LINE__);
+		goto exit;
+	}
+	cnt = rte_reorder_drain(b, robufs, num_bufs);
+	if (cnt != 1 || *rte_reorder_seqn(robufs[0]) != 3) {
+		printf("%s:%d:%u: Unexpected packets drained\n",
+				__func__, __LINE__, cnt);
+		goto exit;
+	}
+	rte_pktmbuf_free(robufs[0]);
+	robufs[0] = NULL;
+
+	if (rte_reorder_insert(b, bufs[3]) != 0) {
+		printf("%s:%d: Cannot insert packet\n", __func__, __LINE__);
+		goto exit;
+	}
+	bufs[3] = NULL;
+
+	/* seqn 2 was skipped */
+	if (rte_reorder_insert(b, bufs[4]) != -1 || rte_errno != ERANGE) {
+		printf("%s:%d: No error on insert of late packet\n",
+				__func__, __LINE__);
+		goto exit;
+	}
+
+	cnt = rte_reorder_drain(b, robufs, num_bufs);
+	if (cnt != 0) {
+		printf("%s:%d:%u: Unexpected packets drained\n",
+				__func__, __LINE__, cnt);
+		goto exit;
+	}
+	ret = 0;
+exit:
+	rte_reorder_free(b);
+	for (i = 0; i < num_bufs; i++) {
+		if (bufs[i] != NULL)
+			rte_pktmbuf_free(bufs[i]);
+		if (robufs[i] != NULL)
+			rte_pktmbuf_free(robufs[i]);
+	}
+	return ret;
+}
+
 static int
 test_setup(void)
 {
@@ -380,6 +479,7 @@ static struct unit_test_suite reorder_test_suite  = {
 		TEST_CASE(test_reorder_free),
 		TEST_CASE(test_reorder_insert),
 		TEST_CASE(test_reorder_drain),
+		TEST_CASE(test_reorder_mp_insert),
 		TEST_CASES_END()
 	}
 };
@@ -8,6 +8,7 @@
 #include <stdlib.h>
 
 #include <rte_ip.h>
+#include <rte_malloc.h>
 #include <rte_rib.h>
 
 #include "test.h"
@@ -21,6 +22,8 @@ static int32_t test_insert_invalid(void);
 static int32_t test_get_fn(void);
 static int32_t test_basic(void);
 static int32_t test_tree_traversal(void);
+static int32_t test_insert_bulk(void);
+static int32_t test_rcu_qsbr_add(void);
 
 #define MAX_DEPTH 32
 #define MAX_RULES (1 << 22)
@@ -323,6 +326,150 @@ test_tree_traversal(void)
 	return TEST_SUCCESS;
 }
 
+/*
+ * Check that a bulk insert into an empty RIB builds the same routes
+ * as single inserts, and that a bulk insert is all or nothing
+ */
+int32_t
+test_insert_bulk(void)
+{
+	struct rte_rib *rib = NULL;
+	struct rte_rib_node *node;
+	struct rte_rib_conf config;
+
+	uint32_t ips[] = {
+		RTE_IPV4(10, 0, 0, 0), RTE_IPV4(10, 0, 0, 0),
+		RTE_IPV4(10, 0, 2, 0), RTE_IPV4(10, 128, 0, 0),
+		RTE_IPV4(192, 0, 2, 0), RTE_IPV4(192, 0, 2, 128),
+	};
+	uint8_t depths[] = { 8, 24, 24, 9, 24, 25 };
+	uint64_t next_hops[] = { 1, 2, 3, 4, 5, 6 };
+	uint32_t ip_new[] = { RTE_IPV4(172, 16, 0, 0), RTE_IPV4(192, 0, 2, 0) };
+	uint8_t depth_new[] = { 12, 24 };
+	uint64_t next_hop_return;
+	uint32_t i;
+	int ret;
+
+	config.max_nodes = MAX_RULES;
+	config.ext_sz = 0;
+
+	rib = rte_rib_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(rib != NULL, "Failed to create RIB\n");
+
+	ret = rte_rib_insert_bulk(NULL, ips, depths, next_hops, RTE_DIM(ips));
+	RTE_TEST_ASSERT(ret == -EINVAL,
+		"Call succeeded with invalid parameters\n");
+	/* unsorted list */
+	depths[0] = 25;
+	ret = rte_rib_insert_bulk(rib, ips, depths, next_hops, RTE_DIM(ips));
+	RTE_TEST_ASSERT(ret == -EINVAL, "Unsorted rules inserted\n");
+	depths[0] = 8;
+
+	ret = rte_rib_insert_bulk(rib, ips, depths, next_hops, RTE_DIM(ips));
+	RTE_TEST_ASSERT(ret == 0, "Failed to insert rules\n");
+
+	/* the first rule is only visible outside of the more specific ones */
+	for (i = 1; i < RTE_DIM(ips); i++) {
+		node = rte_rib_lookup(rib, ips[i] | 1);
+		RTE_TEST_ASSERT(node != NULL, "Failed to lookup\n");
+		ret = rte_rib_get_nh(node, &next_hop_return);
+		RTE_TEST_ASSERT((ret == 0) && (next_hop_return == next_hops[i]),
+			"Failed to get proper nexthop\n");
+	}
+	node = rte_rib_lookup(rib, RTE_IPV4(10, 0, 1, 0));
+	RTE_TEST_ASSERT(node != NULL, "Failed to lookup\n");
+	ret = rte_rib_get_nh(node, &next_hop_return);
+	RTE_TEST_ASSERT((ret == 0) && (next_hop_return == next_hops[0]),
+		"Failed to get proper nexthop\n");
+
+	/* one of the rules exists: none is inserted */
+	ret = rte_rib_insert_bulk(rib, ip_new, depth_new, NULL,
+		RTE_DIM(ip_new));
+	RTE_TEST_ASSERT(ret == -EEXIST, "Existing rule inserted\n");
+	node = rte_rib_lookup_exact(rib, ip_new[0], depth_new[0]);
+	RTE_TEST_ASSERT(node == NULL, "Rule left after failed insert\n");
+
+	rte_rib_remove_bulk(rib, ips, depths, RTE_DIM(ips));
+	node = rte_rib_get_nxt(rib, 0, 0, NULL, RTE_RIB_GET_NXT_ALL);
+	RTE_TEST_ASSERT(node == NULL, "Rule left after remove\n");
+
+	rte_rib_free(rib);
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * Check RCU QSBR configuration, and that the removed nodes
+ * are reused only once the readers are quiescent
+ */
+int32_t
+test_rcu_qsbr_add(void)
+{
+	struct rte_rib *rib = NULL;
+	struct rte_rib_node *node;
+	struct rte_rib_conf config;
+	struct rte_rib_rcu_config rcu_cfg = {0};
+	struct rte_rcu_qsbr *qsv;
+	uint32_t ip = RTE_IPV4(192, 0, 2, 0);
+	uint8_t depth = 24;
+	size_t sz;
+	int ret;
+
+	sz = rte_rcu_qsbr_get_memsize(RTE_MAX_LCORE);
+	qsv = rte_zmalloc_socket(NULL, sz, RTE_CACHE_LINE_SIZE,
+		SOCKET_ID_ANY);
+	RTE_TEST_ASSERT(qsv != NULL, "Cannot allocate memory for QSBR\n");
+	ret = rte_rcu_qsbr_init(qsv, RTE_MAX_LCORE);
+	RTE_TEST_ASSERT(ret == 0, "QSBR init failed\n");
+
+	/* a single node */
+	config.max_nodes = 1;
+	config.ext_sz = 0;
+
+	rib = rte_rib_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(rib != NULL, "Failed to create RIB\n");
+
+	ret = rte_rib_rcu_qsbr_add(rib, NULL);
+	RTE_TEST_ASSERT(ret < 0, "Call succeeded with invalid parameters\n");
+	ret = rte_rib_rcu_qsbr_add(rib, &rcu_cfg);
+	RTE_TEST_ASSERT(ret < 0, "Call succeeded with invalid parameters\n");
+	rcu_cfg.v = qsv;
+	rcu_cfg.mode = 2;
+	ret = rte_rib_rcu_qsbr_add(rib, &rcu_cfg);
+	RTE_TEST_ASSERT(ret < 0, "Call succeeded with invalid mode\n");
+
+	rcu_cfg.mode = RTE_RIB_QSBR_MODE_DQ;
+	rcu_cfg.dq_size = 16;
+	ret = rte_rib_rcu_qsbr_add(rib, &rcu_cfg);
+	RTE_TEST_ASSERT(ret == 0, "Failed to add RCU QSBR variable\n");
+	ret = rte_rib_rcu_qsbr_add(rib, &rcu_cfg);
+	RTE_TEST_ASSERT(ret == -EEXIST, "RCU QSBR variable added twice\n");
+
+	ret = rte_rcu_qsbr_thread_register(qsv, 0);
+	RTE_TEST_ASSERT(ret == 0, "Failed to register reader\n");
+	rte_rcu_qsbr_thread_online(qsv, 0);
+
+	node = rte_rib_insert(rib, ip, depth);
+	RTE_TEST_ASSERT(node != NULL, "Failed to insert rule\n");
+	rte_rib_remove(rib, ip, depth);
+
+	/* the reader may still use the removed node */
+	node = rte_rib_insert(rib, ip, depth);
+	RTE_TEST_ASSERT(node == NULL, "Node reused before quiescent state\n");
+
+	rte_rcu_qsbr_quiescent(qsv, 0);
+	node = rte_rib_insert(rib, ip, depth);
+	RTE_TEST_ASSERT(node != NULL, "Failed to reuse the removed node\n");
+
+	rte_rcu_qsbr_thread_offline(qsv, 0);
+	rte_rcu_qsbr_thread_unregister(qsv, 0);
+
+	rte_rib_free(rib);
+	rte_free(qsv);
+
+	return TEST_SUCCESS;
+}
+
 static struct unit_test_suite rib_tests = {
 	.suite_name = "rib autotest",
 	.setup = NULL,
@@ -334,6 +481,8 @@ static struct unit_test_suite rib_tests = {
 		TEST_CASE(test_get_fn),
 		TEST_CASE(test_basic),
 		TEST_CASE(test_tree_traversal),
+		TEST_CASE(test_insert_bulk),
+		TEST_CASE(test_rcu_qsbr_add),
 		TEST_CASES_END()
 	}
 };
@@ -8,6 +8,7 @@
 #include <stdlib.h>
 
 #include <rte_ip.h>
+#include <rte_malloc.h>
 #include <rte_rib6.h>
 
 #include "test.h"
@@ -21,6 +22,8 @@ static int32_t test_insert_invalid(void);
 static int32_t test_get_fn(void);
 static int32_t test_basic(void);
 static int32_t test_tree_traversal(void);
+static int32_t test_insert_bulk(void);
+static int32_t test_rcu_qsbr_add(void);
 
 #define MAX_DEPTH 128
 #define MAX_RULES (1 << 22)
@@ -328,6 +331,150 @@ test_tree_traversal(void)
 	return TEST_SUCCESS;
 }
 
+/*
+ * Check that a bulk insert into an empty RIB builds the same routes
+ * as single inserts, and that a bulk insert is all or nothing
+ */
+int32_t
+test_insert_bulk(void)
+{
+	struct rte_rib6 *rib = NULL;
+	struct rte_rib6_node *node;
+	struct rte_rib6_conf config;
+
+	uint8_t ips[][RTE_RIB6_IPV6_ADDR_SIZE] = {
+		{0x20, 0x01, 0x0d, 0xb8},
+		{0x20, 0x01, 0x0d, 0xb8, 0x80},
+		{0x20, 0x01, 0x0d, 0xb8, 0x80, 0x01},
+		{0x20, 0x01, 0x0d, 0xb9},
+		{0x20, 0x01, 0x0d, 0xb9, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2},
+	};
+	uint8_t depths[] = { 32, 40, 48, 32, 128 };
+	uint64_t next_hops[] = { 1, 2, 3, 4, 5 };
+	uint8_t ip_new[][RTE_RIB6_IPV6_ADDR_SIZE] = {
+		{0x20, 0x01, 0x0d, 0xb7},
+		{0x20, 0x01, 0x0d, 0xb8},
+	};
+	uint8_t depth_new[] = { 32, 32 };
+	uint64_t next_hop_return;
+	uint32_t i;
+	int ret;
+
+	config.max_nodes = MAX_RULES;
+	config.ext_sz = 0;
+
+	rib = rte_rib6_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(rib != NULL, "Failed to create RIB\n");
+
+	ret = rte_rib6_insert_bulk(NULL, ips, depths, next_hops,
+		RTE_DIM(depths));
+	RTE_TEST_ASSERT(ret == -EINVAL,
+		"Call succeeded with invalid parameters\n");
+	/* unsorted list */
+	depths[2] = 36;
+	ret = rte_rib6_insert_bulk(rib, ips, depths, next_hops,
+		RTE_DIM(depths));
+	RTE_TEST_ASSERT(ret == -EINVAL, "Unsorted rules inserted\n");
+	depths[2] = 48;
+
+	ret = rte_rib6_insert_bulk(rib, ips, depths, next_hops,
+		RTE_DIM(depths));
+	RTE_TEST_ASSERT(ret == 0, "Failed to insert rules\n");
+
+	for (i = 0; i < RTE_DIM(depths); i++) {
+		node = rte_rib6_lookup(rib, ips[i]);
+		RTE_TEST_ASSERT(node != NULL, "Failed to lookup\n");
+		ret = rte_rib6_get_nh(node, &next_hop_return);
+		RTE_TEST_ASSERT((ret == 0) && (next_hop_return == next_hops[i]),
+			"Failed to get proper nexthop\n");
+	}
+
+	/* one of the rules exists: none is inserted */
+	ret = rte_rib6_insert_bulk(rib, ip_new, depth_new, NULL,
+		RTE_DIM(depth_new));
+	RTE_TEST_ASSERT(ret == -EEXIST, "Existing rule inserted\n");
+	node = rte_rib6_lookup_exact(rib, ip_new[0], depth_new[0]);
+	RTE_TEST_ASSERT(node == NULL, "Rule left after failed insert\n");
+
+	rte_rib6_remove_bulk(rib, ips, depths, RTE_DIM(depths));
+	node = rte_rib6_lookup(rib, ips[0]);
+	RTE_TEST_ASSERT(node == NULL, "Rule left after remove\n");
+
+	rte_rib6_free(rib);
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * Check RCU QSBR configuration, and that the removed nodes
+ * are reused only once the readers are quiescent
+ */
+int32_t
+test_rcu_qsbr_add(void)
+{
+	struct rte_rib6 *rib = NULL;
+	struct rte_rib6_node *node;
+	struct rte_rib6_conf config;
+	struct rte_rib6_rcu_config rcu_cfg = {0};
+	struct rte_rcu_qsbr *qsv;
+	uint8_t ip[RTE_RIB6_IPV6_ADDR_SIZE] = {0x20, 0x01, 0x0d, 0xb8};
+	uint8_t depth = 32;
+	size_t sz;
+	int ret;
+
+	sz = rte_rcu_qsbr_get_memsize(RTE_MAX_LCORE);
+	qsv = rte_zmalloc_socket(NULL, sz, RTE_CACHE_LINE_SIZE,
+		SOCKET_ID_ANY);
+	RTE_TEST_ASSERT(qsv != NULL, "Cannot allocate memory for QSBR\n");
+	ret = rte_rcu_qsbr_init(qsv, RTE_MAX_LCORE);
+	RTE_TEST_ASSERT(ret == 0, "QSBR init failed\n");
+
+	/* a single node */
+	config.max_nodes = 1;
+	config.ext_sz = 0;
+
+	rib = rte_rib6_create(__func__, SOCKET_ID_ANY, &config);
+	RTE_TEST_ASSERT(rib != NULL, "Failed to create RIB\n");
+
+	ret = rte_rib6_rcu_qsbr_add(rib, NULL);
+	RTE_TEST_ASSERT(ret < 0, "Call succeeded with invalid parameters\n");
+	rcu_cfg.v = qsv;
+	rcu_cfg.mode = 2;
+	ret = rte_rib6_rcu_qsbr_add(rib, &rcu_cfg);
+	RTE_TEST_ASSERT(ret < 0, "Call succeeded with invalid mode\n");
+
+	rcu_cfg.mode = RTE_RIB6_QSBR_MODE_DQ;
+	rcu_cfg.dq_size = 16;
+	ret = rte_rib6_rcu_qsbr_add(rib, &rcu_cfg);
+	RTE_TEST_ASSERT(ret == 0, "Failed to add RCU QSBR variable\n");
+	ret = rte_rib6_rcu_qsbr_add(rib, &rcu_cfg);
+	RTE_TEST_ASSERT(ret == -EEXIST, "RCU QSBR variable added twice\n");
+
+	ret = rte_rcu_qsbr_thread_register(qsv, 0);
+	RTE_TEST_ASSERT(ret == 0, "Failed to register reader\n");
+	rte_rcu_qsbr_thread_online(qsv, 0);
+
+	node = rte_rib6_insert(rib, ip, depth);
+	RTE_TEST_ASSERT(node != NULL, "Failed to insert rule\n");
+	rte_rib6_remove(rib, ip, depth);
+
+	/* the reader may still use the removed node */
+	node = rte_rib6_insert(rib, ip, depth);
+	RTE_TEST_ASSERT(node == NULL, "Node reused before quiescent state\n");
+
+	rte_rcu_qsbr_quiescent(qsv, 0);
+	node = rte_rib6_insert(rib, ip, depth);
+	RTE_TEST_ASSERT(node != NULL, "Failed to reuse the removed node\n");
+
+	rte_rcu_qsbr_thread_offline(qsv, 0);
+	rte_rcu_qsbr_thread_unregister(qsv, 0);
+
+	rte_rib6_free(rib);
+	rte_free(qsv);
+
+	return TEST_SUCCESS;
+}
+
 static struct unit_test_suite rib6_tests = {
 	.suite_name = "rib6 autotest",
 	.setup = NULL,
@@ -339,6 +486,8 @@ static struct unit_test_suite rib6_tests = {
 		TEST_CASE(test_get_fn),
 		TEST_CASE(test_basic),
 		TEST_CASE(test_tree_traversal),
+		TEST_CASE(test_insert_bulk),
+		TEST_CASE(test_rcu_qsbr_add),
 		TEST_CASES_END()
 	}
 };
@@ -389,6 +389,19 @@ static const struct {
 			.felem = test_ring_dequeue_zc_bulk_elem,
 		},
 	},
+	{
+		.desc = "MP_RTS/MC_RTS sync mode (ZC)",
+		.api_type = TEST_RING_ELEM_BULK | TEST_RING_THREAD_DEF,
+		.create_flags = RING_F_MP_RTS_ENQ | RING_F_MC_RTS_DEQ,
+		.enq = {
+			.flegacy = test_ring_enqueue_zc_bulk,
+			.felem = test_ring_enqueue_zc_bulk_elem,
+		},
+		.deq = {
+			.flegacy = test_ring_dequeue_zc_bulk,
+			.felem = test_ring_dequeue_zc_bulk_elem,
+		},
+	},
 	{
 		.desc = "SP/SC sync mode (ZC)",
 		.api_type = TEST_RING_ELEM_BURST | TEST_RING_THREAD_SPSC,
@@ -414,6 +427,19 @@ static const struct {
 			.flegacy = test_ring_dequeue_zc_burst,
 			.felem = test_ring_dequeue_zc_burst_elem,
 		},
+	},
+	{
+		.desc = "MP_RTS/MC_RTS sync mode (ZC)",
+		.api_type = TEST_RING_ELEM_BURST | TEST_RING_THREAD_DEF,
+		.create_flags = RING_F_MP_RTS_ENQ | RING_F_MC_RTS_DEQ,
+		.enq = {
+			.flegacy = test_ring_enqueue_zc_burst,
+			.felem = test_ring_enqueue_zc_burst_elem,
+		},
+		.deq = {
+			.flegacy = test_ring_dequeue_zc_burst,
+			.felem = test_ring_dequeue_zc_burst_elem,
+		},
 	}
 };
 
@@ -1191,6 +1217,72 @@ test_ring_with_exact_size(void)
 	return -1;
 }
 
+static int
+test_ring_notify_producer(void *arg)
+{
+	struct rte_ring *r = arg;
+
+	rte_delay_ms(10);
+	return rte_ring_mp_enqueue(r, r);
+}
+
+/*
+ * Test the consumer wakeup notifications.
+ */
+static int
+test_ring_notify(void)
+{
+	struct rte_ring *r;
+	unsigned int lcore_id;
+	void *obj;
+
+	r = rte_ring_create("test_notify", 16, SOCKET_ID_ANY, RING_F_NOTIFY);
+	if (r == NULL) {
+		printf("%s: cannot create ring\n", __func__);
+		return -1;
+	}
+
+	/* empty ring: wait times out */
+	TEST_RING_VERIFY(rte_ring_notify_wait(r, 1000) == -ETIMEDOUT, r,
+		goto test_fail);
+
+	/* non empty ring: wait returns immediately */
+	TEST_RING_VERIFY(rte_ring_enqueue(r, r) == 0, r, goto test_fail);
+	TEST_RING_VERIFY(rte_ring_notify_wait(r, 0) == 0, r, goto test_fail);
+	TEST_RING_VERIFY(rte_ring_dequeue(r, &obj) == 0, r, goto test_fail);
+
+	/* consumer woken up by an enqueue from another lcore */
+	lcore_id = rte_get_next_lcore(-1, 1, 0);
+	if (lcore_id < RTE_MAX_LCORE) {
+		rte_eal_remote_launch(test_ring_notify_producer, r, lcore_id);
+		TEST_RING_VERIFY(rte_ring_notify_wait(r, US_PER_S) == 0, r,
+			goto test_fail);
+		TEST_RING_VERIFY(rte_eal_wait_lcore(lcore_id) == 0, r,
+			goto test_fail);
+		TEST_RING_VERIFY(rte_ring_dequeue(r, &obj) == 0, r,
+			goto test_fail);
+	}
+
+	rte_ring_free(r);
+
+	/* the wait requires the flag */
+	r = rte_ring_create("test_notify", 16, SOCKET_ID_ANY, 0);
+	if (r == NULL) {
+		printf("%s: cannot create ring\n", __func__);
+		return -1;
+	}
+	TEST_RING_VERIFY(rte_ring_notify_wait(r, 0) == -EINVAL, r,
+		goto test_fail);
+	rte_ring_free(r);
+
+	return 0;
+
+test_fail:
+	rte_eal_mp_wait_lcore();
+	rte_ring_free(r);
+	return -1;
+}
+
 static int
 test_ring(void)
 {
@@ -1208,6 +1300,9 @@ test_ring(void)
 	if (test_ring_with_exact_size() < 0)
 		goto test_fail;
 
+	if (test_ring_notify() < 0)
+		goto test_fail;
+
 	/* Burst and bulk operations with sp/sc, mp/mc and default.
 	 * The test cases are split into smaller test cases to
 	 * help clang compile faster.
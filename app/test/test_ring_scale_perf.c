@@ -0,0 +1,264 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <string.h>
+
+#include <rte_common.h>
+#include <rte_cycles.h>
+#include <rte_errno.h>
+#include <rte_launch.h>
+#include <rte_lcore.h>
+#include <rte_malloc.h>
+#include <rte_pause.h>
+#include <rte_ring.h>
+#include <rte_ring_elem.h>
+#include <rte_ring_peek.h>
+
+#include "perf_harness.h"
+#include "test.h"
+
+/*
+ * Ring scaling performance test, runs N producers and M consumers
+ * simultaneously on a ring, for each synchronization mode and element size.
+ * The producers stamp the elements with the TSC, which gives the latency of
+ * the elements through the ring, sampled by the consumers, in addition to
+ * the ring throughput.
+ */
+
+#define RING_NAME "RING_SCALE_PERF"
+#define RING_SIZE 4096
+#define BURST_SIZE 32
+#define MAX_ESIZE 64
+#define DURATION_MS 50
+/* One latency sample every SAMPLE_PERIOD bursts, per consumer. */
+#define SAMPLE_PERIOD 16
+#define MAX_SAMPLES 4096
+
+struct ring_mode {
+	const char *name;
+	unsigned int flags;
+	bool peek;   /**< Use the peek API. */
+	bool single; /**< Single producer and consumer only. */
+};
+
+static const struct ring_mode ring_modes[] = {
+	{ .name = "MP/MC", .flags = 0 },
+	{ .name = "RTS", .flags = RING_F_MP_RTS_ENQ | RING_F_MC_RTS_DEQ },
+	{ .name = "HTS", .flags = RING_F_MP_HTS_ENQ | RING_F_MC_HTS_DEQ },
+	{ .name = "HTS peek", .flags = RING_F_MP_HTS_ENQ | RING_F_MC_HTS_DEQ,
+	  .peek = true },
+	{ .name = "SP/SC", .flags = RING_F_SP_ENQ | RING_F_SC_DEQ,
+	  .single = true },
+};
+
+static const unsigned int esizes[] = { 8, 16, 64 };
+
+struct scale_lcore {
+	uint64_t count;
+	unsigned int nb_samples;
+	double samples[MAX_SAMPLES];
+} __rte_cache_aligned;
+
+struct scale_ctx {
+	struct rte_ring *r;
+	const struct ring_mode *mode;
+	unsigned int esize;
+	unsigned int nb_prod;
+	volatile uint32_t start;
+	volatile uint32_t stop;
+	uint32_t prod_done;
+	struct scale_lcore lcores[RTE_MAX_LCORE];
+};
+
+static struct scale_ctx *ctx;
+
+static inline unsigned int
+scale_enqueue(const struct scale_ctx *c, const void *objs, unsigned int n)
+{
+	if (c->mode->peek) {
+		n = rte_ring_enqueue_burst_elem_start(c->r, n, NULL);
+		if (n != 0)
+			rte_ring_enqueue_elem_finish(c->r, objs, c->esize, n);
+		return n;
+	}
+	return rte_ring_enqueue_burst_elem(c->r, objs, c->esize, n, NULL);
+}
+
+static inline unsigned int
+scale_dequeue(const struct scale_ctx *c, void *objs, unsigned int n)
+{
+	if (c->mode->peek) {
+		n = rte_ring_dequeue_burst_elem_start(c->r, objs, c->esize, n,
+				NULL);
+		if (n != 0)
+			rte_ring_dequeue_elem_finish(c->r, n);
+		return n;
+	}
+	return rte_ring_dequeue_burst_elem(c->r, objs, c->esize, n, NULL);
+}
+
+static int
+scale_producer(void *arg)
+{
+	struct scale_lcore *lc = arg;
+	uint64_t objs[BURST_SIZE * MAX_ESIZE / sizeof(uint64_t)];
+	unsigned int stride = ctx->esize / sizeof(uint64_t);
+	uint64_t tsc;
+	unsigned int i;
+
+	memset(objs, 0, sizeof(objs));
+	while (ctx->start == 0)
+		rte_pause();
+
+	while (ctx->stop == 0) {
+		tsc = rte_rdtsc();
+		for (i = 0; i < BURST_SIZE; i++)
+			objs[i * stride] = tsc;
+		lc->count += scale_enqueue(ctx, objs, BURST_SIZE);
+	}
+
+	__atomic_add_fetch(&ctx->prod_done, 1, __ATOMIC_RELEASE);
+	return 0;
+}
+
+static int
+scale_consumer(void *arg)
+{
+	struct scale_lcore *lc = arg;
+	uint64_t objs[BURST_SIZE * MAX_ESIZE / sizeof(uint64_t)];
+	unsigned int bursts = 0;
+	unsigned int n;
+
+	while (ctx->start == 0)
+		rte_pause();
+
+	for (;;) {
+		n = scale_dequeue(ctx, objs, BURST_SIZE);
+		if (n == 0) {
+			if (__atomic_load_n(&ctx->prod_done,
+					__ATOMIC_ACQUIRE) == ctx->nb_prod &&
+			    rte_ring_empty(ctx->r))
+				break;
+			rte_pause();
+			continue;
+		}
+		/* The first element of the burst waited the longest. */
+		if (++bursts % SAMPLE_PERIOD == 0 &&
+		    lc->nb_samples < MAX_SAMPLES)
+			lc->samples[lc->nb_samples++] = rte_rdtsc() - objs[0];
+		lc->count += n;
+	}
+	return 0;
+}
+
+/* Run nb_prod producers and nb_cons consumers on the worker lcores. */
+static int
+scale_run(const struct ring_mode *mode, unsigned int esize,
+	  unsigned int nb_prod, unsigned int nb_cons, const unsigned int *ids,
+	  double *samples)
+{
+	char metric[96];
+	uint64_t start, end, deq = 0;
+	unsigned int i, nb_samples = 0;
+
+	memset(ctx, 0, sizeof(*ctx));
+	ctx->mode = mode;
+	ctx->esize = esize;
+	ctx->nb_prod = nb_prod;
+	ctx->r = rte_ring_create_elem(RING_NAME, esize, RING_SIZE,
+			rte_socket_id(), mode->flags);
+	if (ctx->r == NULL) {
+		printf("Cannot create ring: %s\n", rte_strerror(rte_errno));
+		return -1;
+	}
+
+	for (i = 0; i < nb_prod + nb_cons; i++)
+		rte_eal_remote_launch(i < nb_prod ? scale_producer :
+				scale_consumer, &ctx->lcores[i], ids[i]);
+
+	start = rte_rdtsc();
+	ctx->start = 1;
+	rte_delay_ms(DURATION_MS);
+	ctx->stop = 1;
+	rte_eal_mp_wait_lcore();
+	end = rte_rdtsc();
+	rte_ring_free(ctx->r);
+
+	for (i = nb_prod; i < nb_prod + nb_cons; i++) {
+		deq += ctx->lcores[i].count;
+		memcpy(&samples[nb_samples], ctx->lcores[i].samples,
+		       ctx->lcores[i].nb_samples * sizeof(*samples));
+		nb_samples += ctx->lcores[i].nb_samples;
+	}
+	if (deq == 0) {
+		printf("No element dequeued\n");
+		return -1;
+	}
+
+	/* The throughput is reported as cycles per element per producer. */
+	snprintf(metric, sizeof(metric), "%s %uP/%uC %uB throughput",
+		 mode->name, nb_prod, nb_cons, esize);
+	perf_record(metric, nb_prod, (double)(end - start) * nb_prod / deq);
+	snprintf(metric, sizeof(metric), "%s %uP/%uC %uB latency",
+		 mode->name, nb_prod, nb_cons, esize);
+	perf_record_latency(metric, nb_cons, samples, nb_samples);
+	return 0;
+}
+
+static int
+test_ring_scale_perf(void)
+{
+	unsigned int ids[RTE_MAX_LCORE];
+	unsigned int nb_workers = 0;
+	unsigned int m, e, p, c;
+	unsigned int lcore_id;
+	double *samples;
+	int ret = 0;
+
+	RTE_LCORE_FOREACH_WORKER(lcore_id)
+		ids[nb_workers++] = lcore_id;
+	if (nb_workers < 2) {
+		printf("At least 2 worker lcores are needed\n");
+		return TEST_SKIPPED;
+	}
+
+	ctx = rte_zmalloc(NULL, sizeof(*ctx), RTE_CACHE_LINE_SIZE);
+	samples = rte_malloc(NULL, RTE_MAX_LCORE * MAX_SAMPLES *
+			sizeof(*samples), 0);
+	if (ctx == NULL || samples == NULL) {
+		rte_free(ctx);
+		rte_free(samples);
+		return -1;
+	}
+
+	/*
+	 * The producers and consumers are placed on the workers in order,
+	 * which usually groups the producers on the first cores.
+	 */
+	for (m = 0; m < RTE_DIM(ring_modes) && ret == 0; m++) {
+		for (e = 0; e < RTE_DIM(esizes) && ret == 0; e++) {
+			for (p = 1; p < nb_workers && ret == 0; p *= 2) {
+				for (c = 1; p + c <= nb_workers && ret == 0;
+				     c *= 2) {
+					if (ring_modes[m].single &&
+					    (p > 1 || c > 1))
+						break;
+					ret = scale_run(&ring_modes[m],
+							esizes[e], p, c, ids,
+							samples);
+				}
+			}
+		}
+	}
+
+	rte_free(samples);
+	rte_free(ctx);
+	ctx = NULL;
+	return ret;
+}
+
+REGISTER_TEST_COMMAND(ring_scale_perf_autotest, test_ring_scale_perf);
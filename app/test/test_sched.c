@@ -131,9 +131,12 @@ test_sched(void)
 {
 	struct rte_mempool *mp = NULL;
 	struct rte_sched_port *port = NULL;
+	struct rte_sched_port *port2 = NULL;
 	uint32_t pipe;
 	struct rte_mbuf *in_mbufs[10];
 	struct rte_mbuf *out_mbufs[10];
+	struct rte_sched_subport_delay_stats delay_stats;
+	uint64_t n_hist;
 	int i;
 
 	int err;
@@ -199,6 +202,125 @@ test_sched(void)
 	TEST_ASSERT_EQUAL(queue_stats.n_pkts, 10, "Wrong queue stats\n");
 #endif
 
+	/* split the subports of a NIC port across two scheduler ports */
+	port_param.rate /= 2;
+	port2 = rte_sched_port_config(&port_param);
+	TEST_ASSERT_NOT_NULL(port2, "Error config sched port\n");
+
+	err = rte_sched_port_time_share(port2, port);
+	TEST_ASSERT(err == -EINVAL, "Time shared with a different rate\n");
+	rte_sched_port_free(port2);
+
+	port_param.rate *= 2;
+	port2 = rte_sched_port_config(&port_param);
+	TEST_ASSERT_NOT_NULL(port2, "Error config sched port\n");
+
+	err = rte_sched_subport_config(port2, SUBPORT, subport_param, 0);
+	TEST_ASSERT_SUCCESS(err, "Error config sched, err=%d\n", err);
+
+	for (pipe = 0; pipe < subport_param[0].n_pipes_per_subport_enabled; pipe++) {
+		err = rte_sched_pipe_config(port2, SUBPORT, pipe, 0);
+		TEST_ASSERT_SUCCESS(err, "Error config sched pipe %u, err=%d\n", pipe, err);
+	}
+
+	err = rte_sched_port_time_share(port2, port2);
+	TEST_ASSERT(err == -EINVAL, "Time shared with the same port\n");
+	err = rte_sched_port_time_share(port2, port);
+	TEST_ASSERT_SUCCESS(err, "Error sharing port time, err=%d\n", err);
+	err = rte_sched_port_time_share(port2, port);
+	TEST_ASSERT(err == -EBUSY, "Time shared twice\n");
+
+	for (i = 0; i < 10; i++)
+		prepare_pkt(port2, out_mbufs[i]);
+
+	err = rte_sched_port_enqueue(port2, out_mbufs, 10);
+	TEST_ASSERT_EQUAL(err, 10, "Wrong enqueue, err=%d\n", err);
+
+	err = rte_sched_port_dequeue(port2, in_mbufs, 10);
+	TEST_ASSERT_EQUAL(err, 10, "Wrong dequeue, err=%d\n", err);
+
+	err = rte_sched_port_dequeue(port, out_mbufs, 10);
+	TEST_ASSERT_EQUAL(err, 0, "Wrong dequeue, err=%d\n", err);
+
+	for (i = 0; i < 10; i++)
+		rte_pktmbuf_free(in_mbufs[i]);
+
+	rte_sched_port_free(port2);
+
+	/* Queueing delay statistics */
+	err = rte_sched_subport_read_delay_stats(port, SUBPORT, &delay_stats);
+	TEST_ASSERT(err == -ENOTSUP, "Delay stats read while disabled\n");
+	err = rte_sched_port_delay_stats_enable(port);
+	TEST_ASSERT_SUCCESS(err, "Error enabling delay stats, err=%d\n", err);
+
+	for (i = 0; i < 10; i++) {
+		in_mbufs[i] = rte_pktmbuf_alloc(mp);
+		TEST_ASSERT_NOT_NULL(in_mbufs[i], "Packet allocation failed\n");
+		prepare_pkt(port, in_mbufs[i]);
+	}
+
+	err = rte_sched_port_enqueue(port, in_mbufs, 10);
+	TEST_ASSERT_EQUAL(err, 10, "Wrong enqueue, err=%d\n", err);
+
+	rte_delay_us_block(100);
+
+	err = rte_sched_port_dequeue(port, out_mbufs, 10);
+	TEST_ASSERT_EQUAL(err, 10, "Wrong dequeue, err=%d\n", err);
+
+	err = rte_sched_subport_read_delay_stats(port, SUBPORT, &delay_stats);
+	TEST_ASSERT_SUCCESS(err, "Error reading delay stats, err=%d\n", err);
+	TEST_ASSERT_EQUAL(delay_stats.n_pkts_tc[TC], 10, "Wrong delay stats\n");
+	TEST_ASSERT(delay_stats.max_ns_tc[TC] >= 100 * 1000,
+		"Wrong max delay %"PRIu64"\n", delay_stats.max_ns_tc[TC]);
+	for (i = 0, n_hist = 0; i < RTE_SCHED_DELAY_HIST_SIZE; i++)
+		n_hist += delay_stats.hist_tc[TC][i];
+	TEST_ASSERT_EQUAL(n_hist, 10, "Wrong delay histogram\n");
+
+	for (i = 0; i < 10; i++)
+		rte_pktmbuf_free(out_mbufs[i]);
+
+	/* Sparse subport, with queue storage for a single pipe */
+	port2 = rte_sched_port_config(&port_param);
+	TEST_ASSERT_NOT_NULL(port2, "Error config sched port\n");
+
+	err = rte_sched_subport_config_sparse(port2, SUBPORT, subport_param, 0, 1);
+	TEST_ASSERT_SUCCESS(err, "Error config sparse sched, err=%d\n", err);
+
+	for (pipe = 0; pipe < subport_param[0].n_pipes_per_subport_enabled; pipe++) {
+		err = rte_sched_pipe_config(port2, SUBPORT, pipe, 0);
+		TEST_ASSERT_SUCCESS(err, "Error config sched pipe %u, err=%d\n", pipe, err);
+	}
+
+	for (i = 0; i < 10; i++) {
+		in_mbufs[i] = rte_pktmbuf_alloc(mp);
+		TEST_ASSERT_NOT_NULL(in_mbufs[i], "Packet allocation failed\n");
+		prepare_pkt(port2, in_mbufs[i]);
+	}
+
+	/* No queue storage left for a second pipe */
+	rte_sched_port_pkt_write(port2, in_mbufs[9], SUBPORT, PIPE + 1, TC, QUEUE,
+					RTE_COLOR_YELLOW);
+
+	err = rte_sched_port_enqueue(port2, in_mbufs, 10);
+	TEST_ASSERT_EQUAL(err, 9, "Wrong sparse enqueue, err=%d\n", err);
+
+	err = rte_sched_port_dequeue(port2, out_mbufs, 10);
+	TEST_ASSERT_EQUAL(err, 9, "Wrong sparse dequeue, err=%d\n", err);
+
+	/* The storage is given back once the first pipe is idle */
+	rte_sched_port_pkt_write(port2, out_mbufs[0], SUBPORT, PIPE + 1, TC, QUEUE,
+					RTE_COLOR_YELLOW);
+
+	err = rte_sched_port_enqueue(port2, out_mbufs, 1);
+	TEST_ASSERT_EQUAL(err, 1, "Wrong sparse enqueue, err=%d\n", err);
+
+	err = rte_sched_port_dequeue(port2, out_mbufs, 1);
+	TEST_ASSERT_EQUAL(err, 1, "Wrong sparse dequeue, err=%d\n", err);
+
+	for (i = 0; i < 9; i++)
+		rte_pktmbuf_free(out_mbufs[i]);
+
+	rte_sched_port_free(port2);
 	rte_sched_port_free(port);
 
 	return 0;
@@ -992,6 +992,137 @@ service_active_two_cores(void)
 	return unregister_all();
 }
 
+static int32_t idle_service_calls;
+
+static int32_t busy_cb(void *args)
+{
+	RTE_SET_USED(args);
+	return 0;
+}
+
+static int32_t idle_cb(void *args)
+{
+	RTE_SET_USED(args);
+	idle_service_calls++;
+	return -EAGAIN;
+}
+
+/* run a service on the service lcore for 100ms, and get its stats */
+static int
+service_run_stats(uint32_t id, uint64_t *calls, uint64_t *idle_calls,
+		uint64_t *loops)
+{
+	uint64_t hist_calls = 0, value;
+	uint32_t i;
+
+	rte_service_attr_reset_all(id);
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_attr_reset_all(slcore_id),
+			"Service lcore attr reset failed");
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_start(slcore_id),
+			"Starting service core failed");
+	rte_delay_ms(100);
+	TEST_ASSERT_EQUAL(0, rte_service_map_lcore_set(id, slcore_id, 0),
+			"Disabling valid service and core failed");
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_stop(slcore_id),
+			"Failed to stop service lcore");
+	wait_slcore_inactive(slcore_id);
+	rte_eal_wait_lcore(slcore_id);
+
+	rte_service_attr_get(id, RTE_SERVICE_ATTR_CALL_COUNT, calls);
+	rte_service_attr_get(id, RTE_SERVICE_ATTR_IDLE_CALL_COUNT, idle_calls);
+	rte_service_lcore_attr_get(slcore_id, RTE_SERVICE_LCORE_ATTR_LOOPS,
+			loops);
+
+	for (i = 0; i < RTE_SERVICE_CYCLES_HIST_SIZE; i++) {
+		TEST_ASSERT_EQUAL(0, rte_service_attr_get(id,
+				RTE_SERVICE_ATTR_CYCLES_HIST(i), &value),
+				"Histogram attr_get() failed");
+		hist_calls += value;
+	}
+	TEST_ASSERT_EQUAL(*calls, hist_calls,
+			"Histogram doesn't count all calls");
+	TEST_ASSERT_EQUAL(-EINVAL, rte_service_attr_get(id,
+			RTE_SERVICE_ATTR_CYCLES_HIST(RTE_SERVICE_CYCLES_HIST_SIZE),
+			&value), "Invalid histogram bucket didn't return -EINVAL");
+
+	return TEST_SUCCESS;
+}
+
+/* verify service weight, idle skip and idle calls statistics */
+static int
+service_weight_idle_skip(void)
+{
+	uint64_t calls, idle_calls, loops;
+	struct rte_service_spec service;
+	uint32_t id;
+
+	unregister_all();
+
+	memset(&service, 0, sizeof(struct rte_service_spec));
+	service.callback = busy_cb;
+	snprintf(service.name, sizeof(service.name), DUMMY_SERVICE_NAME);
+	TEST_ASSERT_EQUAL(0, rte_service_component_register(&service, &id),
+			"Register of service failed");
+	rte_service_component_runstate_set(id, 1);
+	TEST_ASSERT_EQUAL(0, rte_service_runstate_set(id, 1),
+			"Error: Service start returned non-zero");
+	rte_service_set_stats_enable(id, 1);
+
+	TEST_ASSERT_EQUAL(-EINVAL, rte_service_set_weight(id, 0),
+			"Zero weight didn't return -EINVAL");
+	TEST_ASSERT_EQUAL(-EINVAL, rte_service_set_weight(UINT32_MAX, 1),
+			"Invalid service id didn't return -EINVAL");
+	TEST_ASSERT_EQUAL(0, rte_service_set_weight(id, 4),
+			"Setting service weight failed");
+
+	/* a busy service is called weight times per loop */
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_add(slcore_id),
+			"Service core add did not return zero");
+	TEST_ASSERT_EQUAL(0, rte_service_map_lcore_set(id, slcore_id, 1),
+			"Enabling valid service and core failed");
+	TEST_ASSERT_EQUAL(TEST_SUCCESS,
+			service_run_stats(id, &calls, &idle_calls, &loops),
+			"Running service failed");
+	TEST_ASSERT(loops > 0, "Service lcore didn't loop");
+	/* the last loops may run after the service is unmapped */
+	TEST_ASSERT(calls % 4 == 0 && calls > 2 * loops,
+			"Busy service not called weight times per loop");
+	TEST_ASSERT_EQUAL(0, idle_calls, "Busy service reported idle calls");
+
+	unregister_all();
+
+	/* an idle service is called once, then skipped */
+	service.callback = idle_cb;
+	TEST_ASSERT_EQUAL(0, rte_service_component_register(&service, &id),
+			"Register of service failed");
+	rte_service_component_runstate_set(id, 1);
+	TEST_ASSERT_EQUAL(0, rte_service_runstate_set(id, 1),
+			"Error: Service start returned non-zero");
+	rte_service_set_stats_enable(id, 1);
+	TEST_ASSERT_EQUAL(0, rte_service_set_weight(id, 4),
+			"Setting service weight failed");
+	TEST_ASSERT_EQUAL(0, rte_service_set_idle_skip(id, 9),
+			"Setting service idle skip failed");
+
+	idle_service_calls = 0;
+	TEST_ASSERT_EQUAL(0, rte_service_lcore_add(slcore_id),
+			"Service core add did not return zero");
+	TEST_ASSERT_EQUAL(0, rte_service_map_lcore_set(id, slcore_id, 1),
+			"Enabling valid service and core failed");
+	TEST_ASSERT_EQUAL(TEST_SUCCESS,
+			service_run_stats(id, &calls, &idle_calls, &loops),
+			"Running service failed");
+	TEST_ASSERT(calls > 0, "Idle service not called");
+	TEST_ASSERT_EQUAL(calls, idle_calls,
+			"Idle service calls not counted as idle");
+	TEST_ASSERT_EQUAL(calls, (uint64_t)idle_service_calls,
+			"Idle service call count mismatch");
+	TEST_ASSERT(calls <= loops / 10 + 1,
+			"Idle service not skipped by service lcore");
+
+	return unregister_all();
+}
+
 static struct unit_test_suite service_tests  = {
 	.suite_name = "service core test suite",
 	.setup = testsuite_setup,
@@ -1014,6 +1145,7 @@ static struct unit_test_suite service_tests  = {
 		TEST_CASE_ST(dummy_register, NULL, service_app_lcore_mt_unsafe),
 		TEST_CASE_ST(dummy_register, NULL, service_may_be_active),
 		TEST_CASE_ST(dummy_register, NULL, service_active_two_cores),
+		TEST_CASE_ST(dummy_register, NULL, service_weight_idle_skip),
 		TEST_CASES_END() /**< NULL terminate unit test array */
 	}
 };
@@ -380,5 +380,16 @@ test_lf_stack(void)
 #endif
 }
 
+static int
+test_lf_mag_stack(void)
+{
+#if defined(RTE_STACK_LF_SUPPORTED)
+	return __test_stack(RTE_STACK_F_LF_MAG);
+#else
+	return TEST_SKIPPED;
+#endif
+}
+
 REGISTER_TEST_COMMAND(stack_autotest, test_stack);
 REGISTER_TEST_COMMAND(stack_lf_autotest, test_lf_stack);
+REGISTER_TEST_COMMAND(stack_lf_mag_autotest, test_lf_mag_stack);
@@ -4,6 +4,7 @@
 
 
 #include <stdio.h>
+#include <stdbool.h>
 #include <inttypes.h>
 
 #include <rte_atomic.h>
@@ -12,6 +13,7 @@
 #include <rte_pause.h>
 #include <rte_stack.h>
 
+#include "perf_harness.h"
 #include "test.h"
 
 #define STACK_NAME "STACK_PERF"
@@ -106,23 +108,23 @@ get_two_sockets(struct lcore_pair *lcp)
 	return 1;
 }
 
-/* Measure the cycle cost of popping an empty stack. */
+/* Pop an empty stack. */
 static void
-test_empty_pop(struct rte_stack *s)
+empty_pop(void *arg, unsigned int n)
 {
-	unsigned int iterations = 100000000;
+	struct rte_stack *s = arg;
 	void *objs[MAX_BURST];
 	unsigned int i;
 
-	uint64_t start = rte_rdtsc();
-
-	for (i = 0; i < iterations; i++)
+	for (i = 0; i < n; i++)
 		rte_stack_pop(s, objs, bulk_sizes[0]);
+}
 
-	uint64_t end = rte_rdtsc();
-
-	printf("Stack empty pop: %.2F\n",
-	       (double)(end - start) / iterations);
+/* Measure the cycle cost of popping an empty stack. */
+static int
+test_empty_pop(struct rte_stack *s)
+{
+	return perf_run("Stack empty pop", empty_pop, s, 10000000);
 }
 
 struct thread_args {
@@ -168,10 +170,11 @@ bulk_push_pop(void *p)
  * on different sockets.
  */
 static void
-run_on_core_pair(struct lcore_pair *cores, struct rte_stack *s,
-		 lcore_function_t fn)
+run_on_core_pair(const char *name, struct lcore_pair *cores,
+		 struct rte_stack *s, lcore_function_t fn)
 {
 	struct thread_args args[2];
+	char metric[64];
 	unsigned int i;
 
 	for (i = 0; i < RTE_DIM(bulk_sizes); i++) {
@@ -191,58 +194,29 @@ run_on_core_pair(struct lcore_pair *cores, struct rte_stack *s,
 			rte_eal_wait_lcore(cores->c2);
 		}
 
-		printf("Average cycles per object push/pop (bulk size: %u): %.2F\n",
-		       bulk_sizes[i], (args[0].avg + args[1].avg) / 2);
+		snprintf(metric, sizeof(metric),
+			 "%s object push/pop, bulk size %u", name,
+			 bulk_sizes[i]);
+		perf_record(metric, 2, (args[0].avg + args[1].avg) / 2);
 	}
 }
 
-/* Run bulk_push_pop() simultaneously on 1+ cores. */
+struct push_pop_args {
+	struct rte_stack *s;
+	unsigned int sz;
+};
+
+/* Push and pop objects, n counts the objects. */
 static void
-run_on_n_cores(struct rte_stack *s, lcore_function_t fn, int n)
+push_pop(void *p, unsigned int n)
 {
-	struct thread_args args[RTE_MAX_LCORE];
+	struct push_pop_args *args = p;
+	void *objs[MAX_BURST] = {0};
 	unsigned int i;
 
-	for (i = 0; i < RTE_DIM(bulk_sizes); i++) {
-		unsigned int lcore_id;
-		int cnt = 0;
-		double avg;
-
-		rte_atomic32_set(&lcore_barrier, n);
-
-		RTE_LCORE_FOREACH_WORKER(lcore_id) {
-			if (++cnt >= n)
-				break;
-
-			args[lcore_id].s = s;
-			args[lcore_id].sz = bulk_sizes[i];
-
-			if (rte_eal_remote_launch(fn, &args[lcore_id],
-						  lcore_id))
-				rte_panic("Failed to launch lcore %d\n",
-					  lcore_id);
-		}
-
-		lcore_id = rte_lcore_id();
-
-		args[lcore_id].s = s;
-		args[lcore_id].sz = bulk_sizes[i];
-
-		fn(&args[lcore_id]);
-
-		rte_eal_mp_wait_lcore();
-
-		avg = args[rte_lcore_id()].avg;
-
-		cnt = 0;
-		RTE_LCORE_FOREACH_WORKER(lcore_id) {
-			if (++cnt >= n)
-				break;
-			avg += args[lcore_id].avg;
-		}
-
-		printf("Average cycles per object push/pop (bulk size: %u): %.2F\n",
-		       bulk_sizes[i], avg / n);
+	for (i = 0; i < n / args->sz; i++) {
+		rte_stack_push(args->s, objs, args->sz);
+		rte_stack_pop(args->s, objs, args->sz);
 	}
 }
 
@@ -250,50 +224,40 @@ run_on_n_cores(struct rte_stack *s, lcore_function_t fn, int n)
  * Measure the cycle cost of pushing and popping a single pointer on a single
  * lcore.
  */
-static void
+static int
 test_single_push_pop(struct rte_stack *s)
 {
-	unsigned int iterations = 16000000;
-	void *obj = NULL;
-	unsigned int i;
-
-	uint64_t start = rte_rdtsc();
+	struct push_pop_args args = { .s = s, .sz = 1 };
 
-	for (i = 0; i < iterations; i++) {
-		rte_stack_push(s, &obj, 1);
-		rte_stack_pop(s, &obj, 1);
-	}
-
-	uint64_t end = rte_rdtsc();
-
-	printf("Average cycles per single object push/pop: %.2F\n",
-	       ((double)(end - start)) / iterations);
+	return perf_run("Single object push/pop", push_pop, &args, 1600000);
 }
 
-/* Measure the cycle cost of bulk pushing and popping on a single lcore. */
-static void
-test_bulk_push_pop(struct rte_stack *s)
+/*
+ * Measure the cycle cost of bulk pushing and popping, on a single lcore
+ * then simultaneously on 1+ lcores.
+ */
+static int
+test_bulk_push_pop(struct rte_stack *s, bool all_lcores)
 {
-	unsigned int iterations = 8000000;
-	void *objs[MAX_BURST];
-	unsigned int sz, i;
+	struct push_pop_args args = { .s = s };
+	char metric[64];
+	unsigned int sz;
+	int ret;
 
 	for (sz = 0; sz < RTE_DIM(bulk_sizes); sz++) {
-		uint64_t start = rte_rdtsc();
-
-		for (i = 0; i < iterations; i++) {
-			rte_stack_push(s, objs, bulk_sizes[sz]);
-			rte_stack_pop(s, objs, bulk_sizes[sz]);
-		}
-
-		uint64_t end = rte_rdtsc();
-
-		double avg = ((double)(end - start) /
-			      (iterations * bulk_sizes[sz]));
-
-		printf("Average cycles per object push/pop (bulk size: %u): %.2F\n",
-		       bulk_sizes[sz], avg);
+		args.sz = bulk_sizes[sz];
+		snprintf(metric, sizeof(metric),
+			 "Object push/pop, bulk size %u", args.sz);
+		if (all_lcores)
+			ret = perf_run_lcores(metric, push_pop, &args,
+					      args.sz * 100000);
+		else
+			ret = perf_run(metric, push_pop, &args,
+				       args.sz * 800000);
+		if (ret != 0)
+			return ret;
 	}
+	return 0;
 }
 
 static int
@@ -301,6 +265,7 @@ __test_stack_perf(uint32_t flags)
 {
 	struct lcore_pair cores;
 	struct rte_stack *s;
+	int ret;
 
 	rte_atomic32_init(&lcore_barrier);
 
@@ -312,32 +277,35 @@ __test_stack_perf(uint32_t flags)
 	}
 
 	printf("### Testing single element push/pop ###\n");
-	test_single_push_pop(s);
+	ret = test_single_push_pop(s);
 
 	printf("\n### Testing empty pop ###\n");
-	test_empty_pop(s);
+	if (ret == 0)
+		ret = test_empty_pop(s);
 
 	printf("\n### Testing using a single lcore ###\n");
-	test_bulk_push_pop(s);
+	if (ret == 0)
+		ret = test_bulk_push_pop(s, false);
 
-	if (get_two_hyperthreads(&cores) == 0) {
+	if (ret == 0 && get_two_hyperthreads(&cores) == 0) {
 		printf("\n### Testing using two hyperthreads ###\n");
-		run_on_core_pair(&cores, s, bulk_push_pop);
+		run_on_core_pair("Hyperthreads", &cores, s, bulk_push_pop);
 	}
-	if (get_two_cores(&cores) == 0) {
+	if (ret == 0 && get_two_cores(&cores) == 0) {
 		printf("\n### Testing using two physical cores ###\n");
-		run_on_core_pair(&cores, s, bulk_push_pop);
+		run_on_core_pair("Physical cores", &cores, s, bulk_push_pop);
 	}
-	if (get_two_sockets(&cores) == 0) {
+	if (ret == 0 && get_two_sockets(&cores) == 0) {
 		printf("\n### Testing using two NUMA nodes ###\n");
-		run_on_core_pair(&cores, s, bulk_push_pop);
+		run_on_core_pair("NUMA nodes", &cores, s, bulk_push_pop);
 	}
 
-	printf("\n### Testing on all %u lcores ###\n", rte_lcore_count());
-	run_on_n_cores(s, bulk_push_pop, rte_lcore_count());
+	printf("\n### Testing on 1 to %u lcores ###\n", rte_lcore_count());
+	if (ret == 0)
+		ret = test_bulk_push_pop(s, true);
 
 	rte_stack_free(s);
-	return 0;
+	return ret;
 }
 
 static int
@@ -356,5 +324,16 @@ test_lf_stack_perf(void)
 #endif
 }
 
+static int
+test_lf_mag_stack_perf(void)
+{
+#if defined(RTE_STACK_LF_SUPPORTED)
+	return __test_stack_perf(RTE_STACK_F_LF_MAG);
+#else
+	return TEST_SKIPPED;
+#endif
+}
+
 REGISTER_TEST_COMMAND(stack_perf_autotest, test_stack_perf);
 REGISTER_TEST_COMMAND(stack_lf_perf_autotest, test_lf_stack_perf);
+REGISTER_TEST_COMMAND(stack_lf_mag_perf_autotest, test_lf_mag_stack_perf);
@@ -18,6 +18,7 @@ table_test table_tests[] = {
 	test_table_hash_lru,
 	test_table_hash_ext,
 	test_table_hash_cuckoo,
+	test_table_hash_sig,
 };
 
 #define PREPARE_PACKET(mbuf, value) do {				\
@@ -889,6 +890,26 @@ test_table_hash_ext(void)
 	return 0;
 }
 
+int
+test_table_hash_sig(void)
+{
+	int status;
+
+	status = test_table_hash_ext_generic(&rte_table_hash_sig_ops, 8);
+	if (status < 0)
+		return status;
+
+	status = test_table_hash_ext_generic(&rte_table_hash_sig_ops, 16);
+	if (status < 0)
+		return status;
+
+	status = test_table_hash_ext_generic(&rte_table_hash_sig_ops, 32);
+	if (status < 0)
+		return status;
+
+	return 0;
+}
+
 
 int
 test_table_hash_cuckoo(void)
@@ -0,0 +1,153 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include <rte_eal.h>
+#include <rte_common.h>
+#include <rte_telemetry_counters.h>
+
+#include "test.h"
+
+#define NUM_COUNTERS 3
+
+static const char * const counter_names[NUM_COUNTERS] = {
+	"rx_packets", "tx_packets", "drops",
+};
+
+/* Map the region read only, as an external collector would do. */
+static const struct rte_tel_counters_hdr *
+map_region(void)
+{
+	char path[PATH_MAX];
+	void *p;
+	int fd;
+
+	snprintf(path, sizeof(path), "%s/dpdk_counters.%d",
+			rte_eal_get_runtime_dir(), getpid());
+	fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		printf("Cannot open %s: %s\n", path, strerror(errno));
+		return NULL;
+	}
+	p = mmap(NULL, RTE_TEL_COUNTERS_REGION_SIZE, PROT_READ, MAP_SHARED,
+			fd, 0);
+	close(fd);
+	return p == MAP_FAILED ? NULL : p;
+}
+
+/* Snapshot a block descriptor, as an external collector would do. */
+static void
+read_block(const struct rte_tel_counters_hdr *hdr, uint32_t idx,
+		struct rte_tel_counters_block *blk, uint32_t *num_blocks)
+{
+	const struct rte_tel_counters_block *blocks =
+		RTE_PTR_ADD(hdr, hdr->blocks_ofs);
+	uint32_t sn;
+
+	do {
+		sn = rte_seqcount_read_begin(&hdr->seqcount);
+		*num_blocks = hdr->num_blocks;
+		*blk = blocks[idx];
+	} while (rte_seqcount_read_retry(&hdr->seqcount, sn));
+}
+
+static int
+test_telemetry_counters(void)
+{
+	const char *too_long[] = { "drops", NULL };
+	char long_name[RTE_TEL_MAX_STRING_LEN + 1];
+	const struct rte_tel_counters_hdr *hdr;
+	struct rte_tel_counters_block blk;
+	const uint64_t *shared;
+	uint64_t *values, *values2;
+	uint32_t i, num_blocks;
+	int id, id2;
+
+	/* invalid parameters */
+	TEST_ASSERT(rte_telemetry_counters_register(NULL, counter_names,
+			NUM_COUNTERS, &values) == -EINVAL, "NULL name accepted");
+	TEST_ASSERT(rte_telemetry_counters_register("test", counter_names,
+			0, &values) == -EINVAL, "No counters accepted");
+	TEST_ASSERT(rte_telemetry_counters_register("test", too_long,
+			2, &values) == -EINVAL, "NULL counter name accepted");
+	memset(long_name, 'a', sizeof(long_name) - 1);
+	long_name[sizeof(long_name) - 1] = '\0';
+	too_long[1] = long_name;
+	TEST_ASSERT(rte_telemetry_counters_register("test", too_long,
+			2, &values) == -EINVAL, "Long counter name accepted");
+	TEST_ASSERT(rte_telemetry_counters_unregister(-1) == -EINVAL,
+			"Invalid id accepted");
+
+	id = rte_telemetry_counters_register("test", counter_names,
+			NUM_COUNTERS, &values);
+	if (id == -ENOTSUP) {
+		printf("Telemetry is not initialized, skipping\n");
+		return TEST_SKIPPED;
+	}
+	TEST_ASSERT(id >= 0, "Cannot register counters: %d", id);
+	TEST_ASSERT(((uintptr_t)values & (RTE_CACHE_LINE_SIZE - 1)) == 0,
+			"Counters are not cache aligned");
+	for (i = 0; i != NUM_COUNTERS; i++)
+		TEST_ASSERT(values[i] == 0, "Counters are not zeroed");
+
+	id2 = rte_telemetry_counters_register("test2", counter_names,
+			1, &values2);
+	TEST_ASSERT(id2 >= 0 && id2 != id, "Cannot register counters: %d",
+			id2);
+
+	hdr = map_region();
+	TEST_ASSERT_NOT_NULL(hdr, "Cannot map counters region");
+	TEST_ASSERT(hdr->magic == RTE_TEL_COUNTERS_MAGIC &&
+			hdr->version == RTE_TEL_COUNTERS_VERSION &&
+			hdr->pid == (uint32_t)getpid(), "Invalid header");
+
+	read_block(hdr, id, &blk, &num_blocks);
+	TEST_ASSERT((uint32_t)id < num_blocks && (uint32_t)id2 < num_blocks,
+			"Blocks are not published");
+	TEST_ASSERT(strcmp(blk.name, "test") == 0 &&
+			blk.num == NUM_COUNTERS &&
+			(blk.flags & RTE_TEL_COUNTERS_F_ACTIVE) != 0,
+			"Invalid block descriptor");
+	for (i = 0; i != NUM_COUNTERS; i++)
+		TEST_ASSERT(strcmp((const char *)hdr + blk.names_ofs +
+				i * RTE_TEL_MAX_STRING_LEN,
+				counter_names[i]) == 0,
+				"Invalid counter name %u", i);
+
+	/* updates are visible through the collector mapping */
+	shared = RTE_PTR_ADD(hdr, blk.values_ofs);
+	for (i = 0; i != NUM_COUNTERS; i++)
+		values[i] += i + 1;
+	values[0]++;
+	values2[0] = 42;
+	TEST_ASSERT(shared[0] == 2 && shared[1] == 2 && shared[2] == 3,
+			"Counters are not shared");
+
+	TEST_ASSERT(rte_telemetry_counters_unregister(id) == 0,
+			"Cannot unregister counters");
+	TEST_ASSERT(rte_telemetry_counters_unregister(id) == -EINVAL,
+			"Counters unregistered twice");
+	read_block(hdr, id, &blk, &num_blocks);
+	TEST_ASSERT((blk.flags & RTE_TEL_COUNTERS_F_ACTIVE) == 0,
+			"Unregistered block is active");
+	read_block(hdr, id2, &blk, &num_blocks);
+	TEST_ASSERT((blk.flags & RTE_TEL_COUNTERS_F_ACTIVE) != 0 &&
+			((const uint64_t *)RTE_PTR_ADD(hdr,
+				blk.values_ofs))[0] == 42,
+			"Other block is affected");
+	TEST_ASSERT(rte_telemetry_counters_unregister(id2) == 0,
+			"Cannot unregister counters");
+
+	munmap((void *)(uintptr_t)hdr, RTE_TEL_COUNTERS_REGION_SIZE);
+	return TEST_SUCCESS;
+}
+
+REGISTER_TEST_COMMAND(telemetry_counters_autotest, test_telemetry_counters);
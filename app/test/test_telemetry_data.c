@@ -15,11 +15,14 @@
 
 #include "test.h"
 #include "telemetry_data.h"
+#include "telemetry_bin.h"
 
 #define TELEMETRY_VERSION "v2"
 #define REQUEST_CMD "/test"
 #define BUF_SIZE 1024
 #define TEST_OUTPUT(exp) test_output(__func__, exp)
+#define LARGE_OUTPUT_LEN (1024 * 64)
+#define SUBSCRIPTION_PUSHES 3
 
 static struct rte_tel_data response_data;
 static int sock;
@@ -301,6 +304,294 @@ test_array_with_array_u64_values(void)
 	return TEST_OUTPUT("{\"/test\":[[0,1,2,3,4],[0,1,2,3,4]]}");
 }
 
+/*
+ * Sends a command and checks the response, which may follow
+ * pushed messages equal to the expected output of /test.
+ */
+static int
+test_command(const char *func_name, const char *cmd, const char *expected,
+		const char *pushed)
+{
+	int bytes;
+	char buf[BUF_SIZE * 16];
+
+	if (write(sock, cmd, strlen(cmd)) < 0) {
+		printf("%s: Error with socket write - %s\n", __func__,
+				strerror(errno));
+		return -1;
+	}
+	do {
+		bytes = read(sock, buf, sizeof(buf) - 1);
+		if (bytes < 0) {
+			printf("%s: Error with socket read - %s\n", __func__,
+					strerror(errno));
+			return -1;
+		}
+		buf[bytes] = '\0';
+	} while (pushed != NULL && strcmp(buf, pushed) == 0);
+	printf("%s: buf = '%s', expected = '%s'\n", func_name, buf, expected);
+	return strcmp(expected, buf);
+}
+
+/*
+ * Reads the messages of a binary response and concatenates their payloads,
+ * returns the length of the response.
+ */
+static int
+read_bin_response(uint8_t *out, size_t size)
+{
+	static uint8_t buf[LARGE_OUTPUT_LEN];
+	struct tel_bin_hdr hdr;
+	size_t len = 0;
+	int bytes;
+
+	do {
+		bytes = read(sock, buf, sizeof(buf));
+		if (bytes < (int)sizeof(hdr)) {
+			printf("%s: Error with socket read\n", __func__);
+			return -1;
+		}
+		memcpy(&hdr, buf, sizeof(hdr));
+		if (hdr.magic != TEL_BIN_MAGIC ||
+				hdr.len != bytes - sizeof(hdr) ||
+				len + hdr.len > size) {
+			printf("%s: invalid message\n", __func__);
+			return -1;
+		}
+		memcpy(out + len, buf + sizeof(hdr), hdr.len);
+		len += hdr.len;
+	} while (hdr.flags & TEL_BIN_F_MORE);
+
+	return len;
+}
+
+static void
+bin_put(uint8_t **p, const void *v, size_t n)
+{
+	memcpy(*p, v, n);
+	*p += n;
+}
+
+static void
+bin_put_str(uint8_t **p, const char *str)
+{
+	uint16_t len = strlen(str);
+
+	bin_put(p, &len, sizeof(len));
+	bin_put(p, str, len);
+}
+
+static void
+bin_put_name(uint8_t **p, const char *name)
+{
+	uint8_t len = strlen(name);
+
+	bin_put(p, &len, sizeof(len));
+	bin_put(p, name, len);
+}
+
+static void
+bin_put_type(uint8_t **p, enum tel_bin_type type)
+{
+	uint8_t v = type;
+
+	bin_put(p, &v, sizeof(v));
+}
+
+static int
+test_case_output_binary(void)
+{
+	uint8_t buf[BUF_SIZE], exp[BUF_SIZE], *p;
+	const uint64_t u64 = UINT64_MAX;
+	const int32_t ival = -2;
+	const uint32_t one = 1;
+	int len;
+
+	struct rte_tel_data *child_data = rte_tel_data_alloc();
+	rte_tel_data_start_array(child_data, RTE_TEL_U64_VAL);
+	rte_tel_data_add_array_u64(child_data, u64);
+
+	memset(&response_data, 0, sizeof(response_data));
+	rte_tel_data_start_dict(&response_data);
+	rte_tel_data_add_dict_u64(&response_data, "u64", u64);
+	rte_tel_data_add_dict_int(&response_data, "int", ival);
+	rte_tel_data_add_dict_string(&response_data, "str", "aaaa");
+	rte_tel_data_add_dict_container(&response_data, "array",
+			child_data, 0);
+
+	if (write(sock, "/output,binary", strlen("/output,binary")) < 0)
+		return -1;
+	len = read_bin_response(buf, sizeof(buf));
+	if (len < 0)
+		return -1;
+
+	if (write(sock, REQUEST_CMD, strlen(REQUEST_CMD)) < 0)
+		return -1;
+	len = read_bin_response(buf, sizeof(buf));
+
+	p = exp;
+	bin_put_str(&p, REQUEST_CMD);
+	bin_put_type(&p, TEL_BIN_DICT);
+	bin_put(&p, &(uint32_t){4}, sizeof(uint32_t));
+	bin_put_name(&p, "u64");
+	bin_put_type(&p, TEL_BIN_U64);
+	bin_put(&p, &u64, sizeof(u64));
+	bin_put_name(&p, "int");
+	bin_put_type(&p, TEL_BIN_INT);
+	bin_put(&p, &ival, sizeof(ival));
+	bin_put_name(&p, "str");
+	bin_put_type(&p, TEL_BIN_STRING);
+	bin_put_str(&p, "aaaa");
+	bin_put_name(&p, "array");
+	bin_put_type(&p, TEL_BIN_ARRAY);
+	bin_put_type(&p, TEL_BIN_U64);
+	bin_put(&p, &one, sizeof(one));
+	bin_put(&p, &u64, sizeof(u64));
+
+	printf("%s: len = %d, expected = %d\n", __func__, len,
+			(int)(p - exp));
+	if (len != p - exp || memcmp(buf, exp, len) != 0)
+		return -1;
+
+	return test_command(__func__, "/output,json",
+			"{\"/output\":{\"format\":\"json\","
+			"\"max_output_len\":16384}}", NULL);
+}
+
+/* A binary response larger than the output length is split. */
+static int
+test_case_output_binary_chunked(void)
+{
+	static uint8_t buf[RTE_TEL_MAX_ARRAY_ENTRIES * RTE_TEL_MAX_STRING_LEN * 2];
+	char str[RTE_TEL_MAX_STRING_LEN];
+	uint8_t *p;
+	uint32_t count;
+	uint16_t slen;
+	int i, len;
+
+	memset(str, 'a', sizeof(str) - 1);
+	str[sizeof(str) - 1] = '\0';
+
+	memset(&response_data, 0, sizeof(response_data));
+	rte_tel_data_start_array(&response_data, RTE_TEL_STRING_VAL);
+	for (i = 0; i < RTE_TEL_MAX_ARRAY_ENTRIES; i++)
+		rte_tel_data_add_array_string(&response_data, str);
+
+	if (write(sock, "/output,binary", strlen("/output,binary")) < 0)
+		return -1;
+	if (read_bin_response(buf, sizeof(buf)) < 0)
+		return -1;
+
+	if (write(sock, REQUEST_CMD, strlen(REQUEST_CMD)) < 0)
+		return -1;
+	len = read_bin_response(buf, sizeof(buf));
+	printf("%s: len = %d\n", __func__, len);
+	if (len != (int)(sizeof(slen) + strlen(REQUEST_CMD) + 2 +
+			sizeof(count) + RTE_TEL_MAX_ARRAY_ENTRIES *
+			(sizeof(slen) + strlen(str))))
+		return -1;
+
+	p = buf + sizeof(slen) + strlen(REQUEST_CMD);
+	if (p[0] != TEL_BIN_ARRAY || p[1] != TEL_BIN_STRING)
+		return -1;
+	p += 2;
+	memcpy(&count, p, sizeof(count));
+	if (count != RTE_TEL_MAX_ARRAY_ENTRIES)
+		return -1;
+	p += sizeof(count);
+	for (i = 0; i < RTE_TEL_MAX_ARRAY_ENTRIES; i++) {
+		memcpy(&slen, p, sizeof(slen));
+		p += sizeof(slen);
+		if (slen != strlen(str) || memcmp(p, str, slen) != 0)
+			return -1;
+		p += slen;
+	}
+
+	return test_command(__func__, "/output,json",
+			"{\"/output\":{\"format\":\"json\","
+			"\"max_output_len\":16384}}", NULL);
+}
+
+/* A JSON response larger than the default output length is not truncated. */
+static int
+test_case_output_json_large(void)
+{
+	static char buf[LARGE_OUTPUT_LEN];
+	char name[RTE_TEL_MAX_STRING_LEN];
+	char end[RTE_TEL_MAX_STRING_LEN * 2];
+	int i, bytes;
+
+	memset(&response_data, 0, sizeof(response_data));
+	rte_tel_data_start_dict(&response_data);
+	for (i = 0; i < RTE_TEL_MAX_DICT_ENTRIES; i++) {
+		snprintf(name, sizeof(name), "%055d", i);
+		rte_tel_data_add_dict_u64(&response_data, name, UINT64_MAX);
+	}
+
+	if (test_command(__func__, "/output,json,65536",
+			"{\"/output\":{\"format\":\"json\","
+			"\"max_output_len\":65536}}", NULL) != 0)
+		return -1;
+
+	if (write(sock, REQUEST_CMD, strlen(REQUEST_CMD)) < 0)
+		return -1;
+	bytes = read(sock, buf, sizeof(buf) - 1);
+	if (bytes < 0)
+		return -1;
+	buf[bytes] = '\0';
+
+	/* the last entry is in the response */
+	snprintf(end, sizeof(end), "\"%055d\":%" PRIu64 "}}",
+			RTE_TEL_MAX_DICT_ENTRIES - 1, UINT64_MAX);
+	printf("%s: len = %d\n", __func__, bytes);
+	if (bytes <= 1024 * 16 || bytes < (int)strlen(end) ||
+			strcmp(buf + bytes - strlen(end), end) != 0)
+		return -1;
+
+	return test_command(__func__, "/output,json,16384",
+			"{\"/output\":{\"format\":\"json\","
+			"\"max_output_len\":16384}}", NULL);
+}
+
+static int
+test_case_subscribe(void)
+{
+	const char *expected = "{\"/test\":[0,1,2,3,4]}";
+	char buf[BUF_SIZE];
+	int i, bytes;
+
+	memset(&response_data, 0, sizeof(response_data));
+	rte_tel_data_start_array(&response_data, RTE_TEL_INT_VAL);
+	for (i = 0; i < 5; i++)
+		rte_tel_data_add_array_int(&response_data, i);
+
+	/* unknown commands can't be subscribed to */
+	if (test_command(__func__, "/subscribe,10,/unknown",
+			"{\"/subscribe\":null}", NULL) != 0)
+		return -1;
+
+	if (test_command(__func__, "/subscribe,10," REQUEST_CMD,
+			"{\"/subscribe\":{\"cmd\":\"/test\","
+			"\"interval_ms\":10,\"subscriptions\":1}}",
+			NULL) != 0)
+		return -1;
+
+	for (i = 0; i < SUBSCRIPTION_PUSHES; i++) {
+		bytes = read(sock, buf, sizeof(buf) - 1);
+		if (bytes < 0)
+			return -1;
+		buf[bytes] = '\0';
+		printf("%s: buf = '%s', expected = '%s'\n", __func__,
+				buf, expected);
+		if (strcmp(buf, expected) != 0)
+			return -1;
+	}
+
+	return test_command(__func__, "/unsubscribe",
+			"{\"/unsubscribe\":{\"subscriptions\":0}}",
+			expected);
+}
+
 static int
 connect_to_socket(void)
 {
@@ -357,7 +648,11 @@ test_telemetry_data(void)
 			test_dict_with_array_string_values,
 			test_array_with_array_int_values,
 			test_array_with_array_u64_values,
-			test_array_with_array_string_values };
+			test_array_with_array_string_values,
+			test_case_output_binary,
+			test_case_output_binary_chunked,
+			test_case_output_json_large,
+			test_case_subscribe };
 
 	rte_telemetry_register_cmd(REQUEST_CMD, test_cb, "Test");
 	for (i = 0; i < RTE_DIM(test_cases); i++) {
@@ -144,6 +144,88 @@ test_toeplitz_hash_calc(void)
 	return TEST_SUCCESS;
 }
 
+static void
+tuple_to_be(const union rte_thash_tuple *tuple, uint8_t *be, uint32_t nb_words)
+{
+	uint32_t i, w;
+
+	for (i = 0; i < nb_words; i++) {
+		w = rte_cpu_to_be_32(((const uint32_t *)tuple)[i]);
+		memcpy(&be[i * sizeof(uint32_t)], &w, sizeof(w));
+	}
+}
+
+static int
+test_toeplitz_hash_gfni(void)
+{
+	uint64_t rss_key_matrixes[RTE_DIM(default_rss_key)];
+	uint8_t tuples[RTE_DIM(v4_tbl)][TUPLE_SZ];
+	uint8_t *tuple_ptrs[RTE_DIM(v4_tbl)];
+	uint32_t rss_l3l4[RTE_DIM(v4_tbl)];
+	union rte_thash_tuple tuple;
+	uint32_t i;
+
+	printf("GFNI accelerated Toeplitz hash is %savailable\n",
+		rte_thash_gfni_supported() ? "" : "not ");
+
+	rte_thash_complete_matrix(rss_key_matrixes, default_rss_key,
+		RTE_DIM(default_rss_key));
+
+	for (i = 0; i < RTE_DIM(v4_tbl); i++) {
+		memset(&tuple, 0, sizeof(tuple));
+		tuple.v4.src_addr = v4_tbl[i].src_ip;
+		tuple.v4.dst_addr = v4_tbl[i].dst_ip;
+		tuple.v4.sport = v4_tbl[i].src_port;
+		tuple.v4.dport = v4_tbl[i].dst_port;
+		tuple_to_be(&tuple, tuples[i], RTE_THASH_V4_L4_LEN);
+		tuple_ptrs[i] = tuples[i];
+
+		if ((rte_thash_gfni(rss_key_matrixes, tuples[i],
+				RTE_THASH_V4_L3_LEN * 4) != v4_tbl[i].hash_l3) ||
+				(rte_thash_gfni(rss_key_matrixes, tuples[i],
+				TUPLE_SZ) != v4_tbl[i].hash_l3l4))
+			return -TEST_FAILED;
+	}
+
+	/* odd number of tuples covers the unpaired tail of the bulk path */
+	rte_thash_gfni_bulk(rss_key_matrixes, TUPLE_SZ, tuple_ptrs, rss_l3l4,
+		RTE_DIM(v4_tbl));
+	for (i = 0; i < RTE_DIM(v4_tbl); i++)
+		if (rss_l3l4[i] != v4_tbl[i].hash_l3l4)
+			return -TEST_FAILED;
+
+	return TEST_SUCCESS;
+}
+
+static int
+test_toeplitz_hash_gfni_rand(void)
+{
+	const uint32_t max_words = RTE_THASH_V6_L4_LEN;
+	uint8_t key[RTE_THASH_V6_L4_LEN * 4 + 4];
+	uint64_t matrixes[RTE_DIM(key)];
+	union rte_thash_tuple tuple;
+	uint8_t be[RTE_THASH_V6_L4_LEN * 4];
+	uint32_t i, j, len, val;
+
+	for (i = 0; i < 1000; i++) {
+		for (j = 0; j < RTE_DIM(key); j++)
+			key[j] = rte_rand();
+		for (j = 0; j < max_words; j++)
+			((uint32_t *)&tuple)[j] = rte_rand();
+		rte_thash_complete_matrix(matrixes, key, RTE_DIM(key));
+
+		len = 1 + rte_rand() % max_words;
+		tuple_to_be(&tuple, be, len);
+		val = rte_thash_gfni(matrixes, be, len * 4);
+		if (val != rte_softrss((uint32_t *)&tuple, len, key)) {
+			printf("GFNI hash mismatch for %u words\n", len);
+			return -TEST_FAILED;
+		}
+	}
+
+	return TEST_SUCCESS;
+}
+
 static int
 test_create_invalid(void)
 {
@@ -259,6 +341,35 @@ test_add_invalid_helper(void)
 	return TEST_SUCCESS;
 }
 
+static int
+test_ctx_gfni_matrices(void)
+{
+	struct rte_thash_ctx *ctx;
+	uint64_t matrixes[RTE_DIM(default_rss_key)];
+	const uint64_t *ctx_matrixes;
+	int key_len = RTE_DIM(default_rss_key);
+	int reta_sz = 7;
+	int ret;
+
+	ctx = rte_thash_init_ctx("test", key_len, reta_sz, NULL, 0);
+	RTE_TEST_ASSERT(ctx != NULL, "Can not create CTX\n");
+
+	ctx_matrixes = rte_thash_get_gfni_matrices(ctx);
+	RTE_TEST_ASSERT(ctx_matrixes != NULL, "Matrices are not allocated\n");
+
+	ret = rte_thash_add_helper(ctx, "first_range", reta_sz, 8);
+	RTE_TEST_ASSERT(ret == 0, "Can not create helper\n");
+
+	/* matrices have to follow the key updated by the helper */
+	rte_thash_complete_matrix(matrixes, rte_thash_get_key(ctx), key_len);
+	RTE_TEST_ASSERT(memcmp(matrixes, ctx_matrixes,
+		sizeof(matrixes)) == 0, "Matrices do not match the key\n");
+
+	rte_thash_free_ctx(ctx);
+
+	return TEST_SUCCESS;
+}
+
 static int
 test_find_existing(void)
 {
@@ -577,10 +688,13 @@ static struct unit_test_suite thash_tests = {
 	.teardown = NULL,
 	.unit_test_cases = {
 	TEST_CASE(test_toeplitz_hash_calc),
+	TEST_CASE(test_toeplitz_hash_gfni),
+	TEST_CASE(test_toeplitz_hash_gfni_rand),
 	TEST_CASE(test_create_invalid),
 	TEST_CASE(test_multiple_create),
 	TEST_CASE(test_free_null),
 	TEST_CASE(test_add_invalid_helper),
+	TEST_CASE(test_ctx_gfni_matrices),
 	TEST_CASE(test_find_existing),
 	TEST_CASE(test_get_helper),
 	TEST_CASE(test_period_overflow),
@@ -2,6 +2,7 @@
  * Copyright(c) 2010-2014 Intel Corporation
  */
 
+#include "perf_harness.h"
 #include "test.h"
 
 #include <stdio.h>
@@ -33,6 +34,15 @@ timer_cb(struct rte_timer *t __rte_unused, void *param __rte_unused)
 #define do_delay() rte_pause()
 #endif
 
+static void
+timer_perf_record(const char *op, unsigned int iterations, uint64_t cycles)
+{
+	char metric[64];
+
+	snprintf(metric, sizeof(metric), "%s, %u timers", op, iterations);
+	perf_record(metric, 1, (double)cycles / iterations);
+}
+
 static int
 test_timer_perf(void)
 {
@@ -48,8 +58,6 @@ test_timer_perf(void)
 		rte_timer_init(&tms[i]);
 
 	const uint64_t ticks = rte_get_timer_hz() * DELAY_SECONDS;
-	const uint64_t ticks_per_ms = rte_get_tsc_hz()/1000;
-	const uint64_t ticks_per_us = ticks_per_ms/1000;
 
 	while (iterations <= MAX_ITERATIONS) {
 
@@ -59,11 +67,7 @@ test_timer_perf(void)
 			rte_timer_reset(&tms[i], ticks, SINGLE, lcore_id,
 					timer_cb, NULL);
 		end_tsc = rte_rdtsc();
-		printf("Time for %u timers: %"PRIu64" (%"PRIu64"ms), ", iterations,
-				end_tsc-start_tsc, (end_tsc-start_tsc+ticks_per_ms/2)/(ticks_per_ms));
-		printf("Time per timer: %"PRIu64" (%"PRIu64"us)\n",
-				(end_tsc-start_tsc)/iterations,
-				((end_tsc-start_tsc)/iterations+ticks_per_us/2)/(ticks_per_us));
+		timer_perf_record("Append", iterations, end_tsc - start_tsc);
 		outstanding_count = iterations;
 		delay_start = rte_get_timer_cycles();
 		while (rte_get_timer_cycles() < delay_start + ticks)
@@ -73,11 +77,7 @@ test_timer_perf(void)
 		while (outstanding_count)
 			rte_timer_manage();
 		end_tsc = rte_rdtsc();
-		printf("Time for %u callbacks: %"PRIu64" (%"PRIu64"ms), ", iterations,
-				end_tsc-start_tsc, (end_tsc-start_tsc+ticks_per_ms/2)/(ticks_per_ms));
-		printf("Time per callback: %"PRIu64" (%"PRIu64"us)\n",
-				(end_tsc-start_tsc)/iterations,
-				((end_tsc-start_tsc)/iterations+ticks_per_us/2)/(ticks_per_us));
+		timer_perf_record("Callback", iterations, end_tsc - start_tsc);
 
 		printf("Resetting %u timers\n", iterations);
 		start_tsc = rte_rdtsc();
@@ -85,11 +85,7 @@ test_timer_perf(void)
 			rte_timer_reset(&tms[i], rte_rand() % ticks, SINGLE, lcore_id,
 					timer_cb, NULL);
 		end_tsc = rte_rdtsc();
-		printf("Time for %u timers: %"PRIu64" (%"PRIu64"ms), ", iterations,
-				end_tsc-start_tsc, (end_tsc-start_tsc+ticks_per_ms/2)/(ticks_per_ms));
-		printf("Time per timer: %"PRIu64" (%"PRIu64"us)\n",
-				(end_tsc-start_tsc)/iterations,
-				((end_tsc-start_tsc)/iterations+ticks_per_us/2)/(ticks_per_us));
+		timer_perf_record("Reset", iterations, end_tsc - start_tsc);
 		outstanding_count = iterations;
 
 		delay_start = rte_get_timer_cycles();
@@ -113,8 +109,8 @@ test_timer_perf(void)
 	for (i = 0; i < iterations; i++)
 		rte_timer_manage();
 	end_tsc = rte_rdtsc();
-	printf("\nTime per rte_timer_manage with zero timers: %"PRIu64" cycles\n",
-			(end_tsc - start_tsc + iterations/2) / iterations);
+	perf_record("rte_timer_manage with zero timers", 1,
+		    (double)(end_tsc - start_tsc) / iterations);
 
 	/* measure time to poll a timer list with timers, but without
 	 * calling any callbacks */
@@ -124,8 +120,8 @@ test_timer_perf(void)
 	for (i = 0; i < iterations; i++)
 		rte_timer_manage();
 	end_tsc = rte_rdtsc();
-	printf("Time per rte_timer_manage with zero callbacks: %"PRIu64" cycles\n",
-			(end_tsc - start_tsc + iterations/2) / iterations);
+	perf_record("rte_timer_manage with zero callbacks", 1,
+		    (double)(end_tsc - start_tsc) / iterations);
 
 	rte_free(tms);
 	return 0;
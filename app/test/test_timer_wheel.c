@@ -0,0 +1,260 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include "test.h"
+
+#include <stdio.h>
+#include <inttypes.h>
+#include <string.h>
+#include <rte_cycles.h>
+#include <rte_timer.h>
+#include <rte_common.h>
+#include <rte_lcore.h>
+#include <rte_random.h>
+#include <rte_pause.h>
+
+#define N_TIMERS	1000
+#define MAX_DELAY_US	10000
+
+static struct rte_timer timer[N_TIMERS];
+static unsigned int n_fired[N_TIMERS];
+static unsigned int n_early;
+static uint32_t timer_data_id;
+static volatile unsigned int stop_workers;
+
+/* callback for rte_timer_alt_manage() */
+static void
+timer_cb(struct rte_timer *tim)
+{
+	/* a timer must never expire before its time */
+	if (rte_get_timer_cycles() < tim->expire)
+		n_early++;
+	n_fired[tim - timer]++;
+}
+
+static void
+manage_for_us(uint64_t us)
+{
+	uint64_t end = rte_get_timer_cycles() +
+		us * rte_get_timer_hz() / US_PER_S;
+
+	while (rte_get_timer_cycles() < end)
+		rte_timer_alt_manage(timer_data_id, NULL, 0, timer_cb);
+}
+
+static void
+reset_counters(void)
+{
+	memset(n_fired, 0, sizeof(n_fired));
+	n_early = 0;
+}
+
+static int
+test_wheel_expiry(unsigned int main_lcore)
+{
+	uint64_t hz = rte_get_timer_hz();
+	unsigned int i;
+	int ret;
+
+	reset_counters();
+	for (i = 0; i < N_TIMERS; i++) {
+		ret = rte_timer_alt_reset(timer_data_id, &timer[i],
+				rte_rand_max(MAX_DELAY_US) * hz / US_PER_S,
+				SINGLE, main_lcore, NULL, NULL);
+		TEST_ASSERT(ret == 0, "Failed to reset timer %u", i);
+	}
+
+	/* every third timer is stopped before it expires */
+	for (i = 0; i < N_TIMERS; i += 3) {
+		ret = rte_timer_alt_stop(timer_data_id, &timer[i]);
+		TEST_ASSERT(ret == 0, "Failed to stop timer %u", i);
+		TEST_ASSERT(!rte_timer_pending(&timer[i]),
+			    "Timer %u still pending", i);
+	}
+
+	manage_for_us(2 * MAX_DELAY_US);
+
+	TEST_ASSERT(n_early == 0, "%u timers expired early", n_early);
+	for (i = 0; i < N_TIMERS; i++) {
+		TEST_ASSERT(n_fired[i] == (i % 3 ? 1 : 0),
+			    "Timer %u expired %u times", i, n_fired[i]);
+		TEST_ASSERT(timer[i].status.state == RTE_TIMER_STOP &&
+			    timer[i].status.owner == RTE_TIMER_NO_OWNER,
+			    "Timer %u not released", i);
+	}
+
+	return TEST_SUCCESS;
+}
+
+static int
+test_wheel_periodic(unsigned int main_lcore)
+{
+	uint64_t period = rte_get_timer_hz() / 1000;
+	int ret;
+
+	reset_counters();
+	ret = rte_timer_alt_reset(timer_data_id, &timer[0], period,
+				  PERIODICAL, main_lcore, NULL, NULL);
+	TEST_ASSERT(ret == 0, "Failed to reset periodic timer");
+
+	manage_for_us(50 * 1000);
+
+	ret = rte_timer_alt_stop(timer_data_id, &timer[0]);
+	TEST_ASSERT(ret == 0, "Failed to stop periodic timer");
+	TEST_ASSERT(n_early == 0, "%u timers expired early", n_early);
+	TEST_ASSERT(n_fired[0] >= 40 && n_fired[0] <= 50,
+		    "Periodic timer expired %u times in 50 ms", n_fired[0]);
+
+	return TEST_SUCCESS;
+}
+
+static int
+test_wheel_next_ticks(unsigned int main_lcore)
+{
+	uint64_t hz = rte_get_timer_hz();
+	int64_t left;
+	int ret;
+
+	reset_counters();
+	left = rte_timer_alt_next_ticks(timer_data_id);
+	TEST_ASSERT(left == -ENOENT, "Next ticks %"PRId64" without timer",
+		    left);
+
+	/* the earliest timer is found whatever the wheel level */
+	ret = rte_timer_alt_reset(timer_data_id, &timer[0], hz,
+				  SINGLE, main_lcore, NULL, NULL);
+	TEST_ASSERT(ret == 0, "Failed to reset timer 0");
+	ret = rte_timer_alt_reset(timer_data_id, &timer[1], hz / 100,
+				  SINGLE, main_lcore, NULL, NULL);
+	TEST_ASSERT(ret == 0, "Failed to reset timer 1");
+
+	left = rte_timer_alt_next_ticks(timer_data_id);
+	TEST_ASSERT(left > 0 && (uint64_t)left <= hz / 100,
+		    "Next ticks %"PRId64", expected at most %"PRIu64,
+		    left, hz / 100);
+
+	ret = rte_timer_alt_stop(timer_data_id, &timer[1]);
+	TEST_ASSERT(ret == 0, "Failed to stop timer 1");
+	left = rte_timer_alt_next_ticks(timer_data_id);
+	TEST_ASSERT(left > (int64_t)(hz / 100) && (uint64_t)left <= hz,
+		    "Next ticks %"PRId64" after stop, expected at most %"PRIu64,
+		    left, hz);
+
+	/* an expired timer is due at the next manage */
+	rte_delay_us_block(MAX_DELAY_US);
+	ret = rte_timer_alt_reset(timer_data_id, &timer[1], 0,
+				  SINGLE, main_lcore, NULL, NULL);
+	TEST_ASSERT(ret == 0, "Failed to reset timer 1");
+	rte_delay_us_block(1000);
+	left = rte_timer_alt_next_ticks(timer_data_id);
+	TEST_ASSERT(left == 0, "Next ticks %"PRId64" for expired timer", left);
+
+	rte_timer_alt_manage(timer_data_id, NULL, 0, timer_cb);
+	TEST_ASSERT(n_fired[1] == 1, "Expired timer not run");
+
+	ret = rte_timer_alt_stop(timer_data_id, &timer[0]);
+	TEST_ASSERT(ret == 0, "Failed to stop timer 0");
+	left = rte_timer_alt_next_ticks(timer_data_id);
+	TEST_ASSERT(left == -ENOENT, "Next ticks %"PRId64" after stop", left);
+
+	return TEST_SUCCESS;
+}
+
+/* re-arm and stop the timers of the main lcore, without any lock */
+static int
+worker_main_loop(void *arg)
+{
+	unsigned int main_lcore = *(unsigned int *)arg;
+	uint64_t hz = rte_get_timer_hz();
+	unsigned int i;
+
+	while (!stop_workers) {
+		i = rte_rand_max(N_TIMERS);
+		if (rte_rand() & 1)
+			rte_timer_alt_reset(timer_data_id, &timer[i],
+				rte_rand_max(MAX_DELAY_US) * hz / US_PER_S,
+				SINGLE, main_lcore, NULL, NULL);
+		else
+			rte_timer_alt_stop(timer_data_id, &timer[i]);
+	}
+
+	return 0;
+}
+
+static int
+test_wheel_cross_lcore(unsigned int main_lcore)
+{
+	unsigned int i, lcore_id;
+	int ret;
+
+	lcore_id = rte_get_next_lcore(main_lcore, 1, 0);
+	if (lcore_id >= RTE_MAX_LCORE) {
+		printf("Not enough lcores, skipping cross lcore test\n");
+		return TEST_SUCCESS;
+	}
+
+	/* the wheel of a lcore can only be polled by that lcore */
+	ret = rte_timer_alt_manage(timer_data_id, &lcore_id, 1, timer_cb);
+	TEST_ASSERT(ret == -ENOTSUP, "Polled the wheel of another lcore");
+
+	reset_counters();
+	stop_workers = 0;
+	rte_eal_mp_remote_launch(worker_main_loop, &main_lcore, SKIP_MAIN);
+
+	manage_for_us(500 * 1000);
+
+	stop_workers = 1;
+	rte_eal_mp_wait_lcore();
+
+	for (i = 0; i < N_TIMERS; i++)
+		while (rte_timer_alt_stop(timer_data_id, &timer[i]) != 0)
+			rte_pause();
+
+	/* release the timers stopped by the workers */
+	rte_timer_alt_manage(timer_data_id, NULL, 0, timer_cb);
+
+	TEST_ASSERT(n_early == 0, "%u timers expired early", n_early);
+	for (i = 0; i < N_TIMERS; i++)
+		TEST_ASSERT(timer[i].status.owner == RTE_TIMER_NO_OWNER,
+			    "Timer %u not released", i);
+
+	return TEST_SUCCESS;
+}
+
+static int
+test_timer_wheel(void)
+{
+	struct rte_timer_data_conf conf = {
+		.backend = RTE_TIMER_BACKEND_WHEEL,
+	};
+	unsigned int main_lcore = rte_lcore_id();
+	unsigned int i;
+	int ret;
+
+	conf.backend = RTE_TIMER_BACKEND_WHEEL + 1;
+	ret = rte_timer_data_alloc_conf(&timer_data_id, &conf);
+	TEST_ASSERT(ret == -EINVAL, "Allocated unknown timer backend");
+
+	conf.backend = RTE_TIMER_BACKEND_WHEEL;
+	ret = rte_timer_data_alloc_conf(&timer_data_id, &conf);
+	TEST_ASSERT(ret == 0, "Failed to allocate timer data: %d", ret);
+
+	for (i = 0; i < N_TIMERS; i++)
+		rte_timer_init(&timer[i]);
+
+	ret = test_wheel_expiry(main_lcore);
+	if (ret == TEST_SUCCESS)
+		ret = test_wheel_periodic(main_lcore);
+	if (ret == TEST_SUCCESS)
+		ret = test_wheel_next_ticks(main_lcore);
+	if (ret == TEST_SUCCESS)
+		ret = test_wheel_cross_lcore(main_lcore);
+
+	rte_timer_stop_all(timer_data_id, &main_lcore, 1, NULL, NULL);
+	rte_timer_data_dealloc(timer_data_id);
+
+	return ret;
+}
+
+REGISTER_TEST_COMMAND(timer_wheel_autotest, test_timer_wheel);
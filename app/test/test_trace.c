@@ -120,6 +120,48 @@ test_trace_mode(void)
 
 }
 
+static int
+test_trace_point_sampling(void)
+{
+	int i;
+
+	if (rte_trace_point_sampling_get(&__app_dpdk_test_tp) != 1)
+		goto failed;
+
+	if (rte_trace_point_sampling_set(&__app_dpdk_test_tp, 3) != -EINVAL)
+		goto failed;
+
+	if (rte_trace_point_sampling_set(&__app_dpdk_test_tp, 0) != -EINVAL)
+		goto failed;
+
+	if (rte_trace_point_sampling_set(&__app_dpdk_test_tp, 16) < 0)
+		goto failed;
+
+	if (rte_trace_point_sampling_get(&__app_dpdk_test_tp) != 16)
+		goto failed;
+
+	/* sampling is independent of enabling */
+	if (rte_trace_point_disable(&__app_dpdk_test_tp) < 0 ||
+			rte_trace_point_enable(&__app_dpdk_test_tp) < 0)
+		goto failed;
+	if (rte_trace_point_sampling_get(&__app_dpdk_test_tp) != 16)
+		goto failed;
+
+	for (i = 0; i < 64; i++)
+		app_dpdk_test_tp("app.dpdk.test.tp.sampled");
+
+	if (rte_trace_point_sampling_set(&__app_dpdk_test_tp, 1) < 0)
+		goto failed;
+
+	if (rte_trace_point_sampling_get(&__app_dpdk_test_tp) != 1)
+		goto failed;
+
+	return TEST_SUCCESS;
+
+failed:
+	return TEST_FAILED;
+}
+
 static int
 test_trace_points_lookup(void)
 {
@@ -183,6 +225,7 @@ static struct unit_test_suite trace_tests = {
 		TEST_CASE(test_trace_point_disable_enable),
 		TEST_CASE(test_trace_point_globbing),
 		TEST_CASE(test_trace_point_regex),
+		TEST_CASE(test_trace_point_sampling),
 		TEST_CASE(test_trace_points_lookup),
 		TEST_CASES_END()
 	}
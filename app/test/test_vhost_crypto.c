@@ -0,0 +1,537 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <inttypes.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <linux/virtio_ring.h>
+
+#include <rte_bus_vdev.h>
+#include <rte_common.h>
+#include <rte_crypto.h>
+#include <rte_cryptodev.h>
+#include <rte_lcore.h>
+#include <rte_mbuf.h>
+#include <rte_mempool.h>
+#include <rte_vhost.h>
+#include <rte_vhost_crypto.h>
+
+#include "test.h"
+
+/* the test plays the frontend side of the vhost-user protocol */
+#include "vhost.h"
+#include "vhost_user.h"
+#include "virtio_crypto.h"
+
+#define GUEST_MEM_SIZE	(1 << 20)
+#define GUEST_PHYS_BASE	0x40000000ULL
+#define QUEUE_SIZE	64
+#define DESC_OFF	0x0
+#define AVAIL_OFF	0x400
+#define USED_OFF	0x1000
+#define REQ_BASE_OFF	0x2000
+#define REQ_SIZE	0x400
+
+/* layout of one request, relative to its slot */
+#define REQ_TABLE_OFF	0x0
+#define REQ_HDR_OFF	0x80
+#define REQ_IV_OFF	0x100
+#define REQ_SRC_OFF	0x180
+#define REQ_DST_OFF	0x200
+#define REQ_INHDR_OFF	0x300
+#define REQ_N_DESCS	5
+
+#define IV_LEN		16
+#define KEY_LEN		16
+#define DATA_LEN	64
+#define BURST		8
+#define NB_REQS		(BURST * 2)
+#define NB_OPS		128
+
+static const char * const crypto_vdevs[] = {
+	"crypto_openssl",
+	"crypto_aesni_mb",
+};
+
+static volatile int test_vid = -1;
+static uint8_t test_cid;
+static struct rte_mempool *sess_pool;
+static struct rte_mempool *sess_priv_pool;
+static struct rte_mempool *op_pool;
+static uint8_t *guest_mem;
+
+static int
+new_device(int vid)
+{
+	int ret;
+
+	ret = rte_vhost_crypto_create(vid, test_cid, sess_pool,
+			sess_priv_pool, rte_socket_id());
+	if (ret != 0)
+		return ret;
+
+	ret = rte_vhost_crypto_set_zero_copy(vid,
+			RTE_VHOST_CRYPTO_ZERO_COPY_ENABLE);
+	if (ret != 0) {
+		rte_vhost_crypto_free(vid);
+		return ret;
+	}
+
+	test_vid = vid;
+	return 0;
+}
+
+static void
+destroy_device(int vid)
+{
+	rte_vhost_crypto_free(vid);
+	test_vid = -1;
+}
+
+static const struct vhost_device_ops vhost_crypto_test_ops = {
+	.new_device = new_device,
+	.destroy_device = destroy_device,
+};
+
+static uint64_t
+gpa(uint64_t off)
+{
+	return GUEST_PHYS_BASE + off;
+}
+
+static int
+vu_send(int sock, VhostUserMsg *msg, int *fds, int fd_num)
+{
+	char control[CMSG_SPACE(VHOST_MEMORY_MAX_NREGIONS * sizeof(int))];
+	struct msghdr mh;
+	struct cmsghdr *cmsg;
+	struct iovec iov;
+
+	msg->flags = VHOST_USER_VERSION;
+
+	iov.iov_base = msg;
+	iov.iov_len = VHOST_USER_HDR_SIZE + msg->size;
+
+	memset(&mh, 0, sizeof(mh));
+	mh.msg_iov = &iov;
+	mh.msg_iovlen = 1;
+
+	if (fd_num > 0) {
+		memset(control, 0, sizeof(control));
+		mh.msg_control = control;
+		mh.msg_controllen = CMSG_SPACE(fd_num * sizeof(int));
+		cmsg = CMSG_FIRSTHDR(&mh);
+		cmsg->cmsg_len = CMSG_LEN(fd_num * sizeof(int));
+		cmsg->cmsg_level = SOL_SOCKET;
+		cmsg->cmsg_type = SCM_RIGHTS;
+		memcpy(CMSG_DATA(cmsg), fds, fd_num * sizeof(int));
+	}
+
+	if (sendmsg(sock, &mh, 0) != (ssize_t)iov.iov_len)
+		return -1;
+
+	return 0;
+}
+
+static int
+vu_recv(int sock, VhostUserMsg *msg)
+{
+	if (recv(sock, msg, VHOST_USER_HDR_SIZE, MSG_WAITALL) !=
+			VHOST_USER_HDR_SIZE)
+		return -1;
+
+	if (msg->size > sizeof(msg->payload))
+		return -1;
+
+	if (msg->size > 0 && recv(sock, (char *)msg + VHOST_USER_HDR_SIZE,
+			msg->size, MSG_WAITALL) != (ssize_t)msg->size)
+		return -1;
+
+	return 0;
+}
+
+static int
+vu_send_u64(int sock, uint32_t request, uint64_t val)
+{
+	VhostUserMsg msg;
+
+	memset(&msg, 0, sizeof(msg));
+	msg.request.master = request;
+	msg.size = sizeof(msg.payload.u64);
+	msg.payload.u64 = val;
+
+	return vu_send(sock, &msg, NULL, 0);
+}
+
+static int
+vu_send_state(int sock, uint32_t request, uint32_t num)
+{
+	VhostUserMsg msg;
+
+	memset(&msg, 0, sizeof(msg));
+	msg.request.master = request;
+	msg.size = sizeof(msg.payload.state);
+	msg.payload.state.index = 0;
+	msg.payload.state.num = num;
+
+	return vu_send(sock, &msg, NULL, 0);
+}
+
+static int
+vu_send_vring_fd(int sock, uint32_t request, int fd)
+{
+	VhostUserMsg msg;
+
+	memset(&msg, 0, sizeof(msg));
+	msg.request.master = request;
+	msg.size = sizeof(msg.payload.u64);
+	msg.payload.u64 = 0;
+
+	return vu_send(sock, &msg, &fd, 1);
+}
+
+/* Negotiate the device and bring its only queue up. */
+static int
+vu_setup(int sock, int mem_fd, int kick_fd, int call_fd)
+{
+	VhostUserMsg msg;
+	uint64_t features;
+
+	memset(&msg, 0, sizeof(msg));
+	msg.request.master = VHOST_USER_GET_FEATURES;
+	if (vu_send(sock, &msg, NULL, 0) < 0 || vu_recv(sock, &msg) < 0)
+		return -1;
+	features = msg.payload.u64 & ((1ULL << VIRTIO_F_VERSION_1) |
+			(1ULL << VIRTIO_RING_F_INDIRECT_DESC));
+
+	if (vu_send_u64(sock, VHOST_USER_SET_OWNER, 0) < 0 ||
+			vu_send_u64(sock, VHOST_USER_SET_FEATURES,
+				features) < 0)
+		return -1;
+
+	memset(&msg, 0, sizeof(msg));
+	msg.request.master = VHOST_USER_SET_MEM_TABLE;
+	msg.size = sizeof(msg.payload.memory);
+	msg.payload.memory.nregions = 1;
+	msg.payload.memory.regions[0].guest_phys_addr = GUEST_PHYS_BASE;
+	msg.payload.memory.regions[0].memory_size = GUEST_MEM_SIZE;
+	msg.payload.memory.regions[0].userspace_addr =
+			(uint64_t)(uintptr_t)guest_mem;
+	msg.payload.memory.regions[0].mmap_offset = 0;
+	if (vu_send(sock, &msg, &mem_fd, 1) < 0)
+		return -1;
+
+	if (vu_send_state(sock, VHOST_USER_SET_VRING_NUM, QUEUE_SIZE) < 0 ||
+			vu_send_state(sock, VHOST_USER_SET_VRING_BASE, 0) < 0)
+		return -1;
+
+	memset(&msg, 0, sizeof(msg));
+	msg.request.master = VHOST_USER_SET_VRING_ADDR;
+	msg.size = sizeof(msg.payload.addr);
+	msg.payload.addr.index = 0;
+	msg.payload.addr.desc_user_addr =
+			(uint64_t)(uintptr_t)(guest_mem + DESC_OFF);
+	msg.payload.addr.avail_user_addr =
+			(uint64_t)(uintptr_t)(guest_mem + AVAIL_OFF);
+	msg.payload.addr.used_user_addr =
+			(uint64_t)(uintptr_t)(guest_mem + USED_OFF);
+	if (vu_send(sock, &msg, NULL, 0) < 0)
+		return -1;
+
+	/* without protocol features, the ring is enabled by its kick fd */
+	if (vu_send_vring_fd(sock, VHOST_USER_SET_VRING_CALL, call_fd) < 0 ||
+			vu_send_vring_fd(sock, VHOST_USER_SET_VRING_KICK,
+				kick_fd) < 0)
+		return -1;
+
+	return 0;
+}
+
+static int64_t
+vu_create_session(int sock)
+{
+	VhostUserCryptoSessionParam *param;
+	VhostUserMsg msg;
+
+	memset(&msg, 0, sizeof(msg));
+	msg.request.master = VHOST_USER_CRYPTO_CREATE_SESS;
+	msg.size = sizeof(msg.payload.crypto_session);
+	param = &msg.payload.crypto_session;
+	param->op_type = VIRTIO_CRYPTO_SYM_OP_CIPHER;
+	param->cipher_algo = VIRTIO_CRYPTO_CIPHER_AES_CBC;
+	param->cipher_key_len = KEY_LEN;
+	param->dir = VIRTIO_CRYPTO_OP_ENCRYPT;
+	memset(param->cipher_key_buf, 0x5a, KEY_LEN);
+
+	if (vu_send(sock, &msg, NULL, 0) < 0 || vu_recv(sock, &msg) < 0)
+		return -1;
+
+	return msg.payload.crypto_session.session_id;
+}
+
+/* Write request number idx in guest memory and make it available. */
+static void
+guest_post_request(uint16_t idx, uint64_t session_id)
+{
+	struct vring_desc *ring = (struct vring_desc *)(guest_mem + DESC_OFF);
+	struct vring_avail *avail =
+			(struct vring_avail *)(guest_mem + AVAIL_OFF);
+	uint64_t slot = REQ_BASE_OFF + (uint64_t)idx * REQ_SIZE;
+	struct vring_desc *table =
+			(struct vring_desc *)(guest_mem + slot + REQ_TABLE_OFF);
+	struct virtio_crypto_op_data_req *req =
+			(void *)(guest_mem + slot + REQ_HDR_OFF);
+	static const struct {
+		uint32_t off;
+		uint32_t len;
+		uint16_t flags;
+	} descs[REQ_N_DESCS] = {
+		{ REQ_HDR_OFF, sizeof(struct virtio_crypto_op_data_req), 0 },
+		{ REQ_IV_OFF, IV_LEN, 0 },
+		{ REQ_SRC_OFF, DATA_LEN, 0 },
+		{ REQ_DST_OFF, DATA_LEN, VRING_DESC_F_WRITE },
+		{ REQ_INHDR_OFF, 1, VRING_DESC_F_WRITE },
+	};
+	uint16_t avail_idx;
+	uint32_t i;
+
+	memset(guest_mem + slot, 0, REQ_SIZE);
+
+	for (i = 0; i < REQ_N_DESCS; i++) {
+		table[i].addr = gpa(slot + descs[i].off);
+		table[i].len = descs[i].len;
+		table[i].flags = descs[i].flags;
+		if (i < REQ_N_DESCS - 1) {
+			table[i].flags |= VRING_DESC_F_NEXT;
+			table[i].next = i + 1;
+		}
+	}
+
+	req->header.opcode = VIRTIO_CRYPTO_CIPHER_ENCRYPT;
+	req->header.session_id = session_id;
+	req->u.sym_req.op_type = VIRTIO_CRYPTO_SYM_OP_CIPHER;
+	req->u.sym_req.u.cipher.para.iv_len = IV_LEN;
+	req->u.sym_req.u.cipher.para.src_data_len = DATA_LEN;
+	req->u.sym_req.u.cipher.para.dst_data_len = DATA_LEN;
+
+	memset(guest_mem + slot + REQ_IV_OFF, 0x11, IV_LEN);
+	memset(guest_mem + slot + REQ_SRC_OFF, (int)(idx + 1), DATA_LEN);
+	guest_mem[slot + REQ_INHDR_OFF] = 0xff;
+
+	ring[idx].addr = gpa(slot + REQ_TABLE_OFF);
+	ring[idx].len = REQ_N_DESCS * sizeof(struct vring_desc);
+	ring[idx].flags = VRING_DESC_F_INDIRECT;
+
+	avail_idx = avail->idx;
+	avail->ring[avail_idx & (QUEUE_SIZE - 1)] = idx;
+	__atomic_store_n(&avail->idx, avail_idx + 1, __ATOMIC_RELEASE);
+}
+
+static int
+fetch_burst(uint16_t first, uint64_t session_id, struct rte_crypto_op **ops)
+{
+	uint16_t i, nb;
+
+	for (i = 0; i < BURST; i++)
+		guest_post_request(first + i, session_id);
+
+	if (rte_crypto_op_bulk_alloc(op_pool, RTE_CRYPTO_OP_TYPE_SYMMETRIC,
+			ops, BURST) != BURST)
+		return -1;
+
+	nb = rte_vhost_crypto_fetch_requests(test_vid, 0, ops, BURST);
+	if (nb != BURST) {
+		printf("Fetched %u requests out of %u\n", nb, BURST);
+		for (i = 0; i < BURST; i++)
+			rte_crypto_op_free(ops[i]);
+		return -1;
+	}
+
+	return 0;
+}
+
+/*
+ * Switch the zero copy mode between two bursts and while they are in flight:
+ * each request must complete with the mode it was fetched with.
+ */
+static int
+test_zero_copy_toggle(int sock)
+{
+	struct rte_crypto_op *ops[NB_REQS];
+	struct vring_used *used = (struct vring_used *)(guest_mem + USED_OFF);
+	int callfds[VIRTIO_CRYPTO_MAX_NUM_BURST_VQS];
+	uint16_t nb_callfds;
+	uint64_t slot;
+	int64_t session_id;
+	uint16_t i, nb;
+
+	session_id = vu_create_session(sock);
+	TEST_ASSERT(session_id >= 0, "Failed to create session (%" PRId64 ")",
+			session_id);
+	TEST_ASSERT(test_vid >= 0, "Vhost crypto device not created");
+
+	TEST_ASSERT_SUCCESS(fetch_burst(0, session_id, ops),
+			"Failed to fetch zero copy burst");
+
+	TEST_ASSERT_SUCCESS(rte_vhost_crypto_set_zero_copy(test_vid,
+			RTE_VHOST_CRYPTO_ZERO_COPY_DISABLE),
+			"Failed to disable zero copy");
+
+	TEST_ASSERT_SUCCESS(fetch_burst(BURST, session_id, &ops[BURST]),
+			"Failed to fetch copy burst");
+	for (i = BURST; i < NB_REQS; i++)
+		TEST_ASSERT_NULL(ops[i]->sym->m_dst,
+				"Copy request %u has a destination mbuf", i);
+
+	TEST_ASSERT_SUCCESS(rte_vhost_crypto_set_zero_copy(test_vid,
+			RTE_VHOST_CRYPTO_ZERO_COPY_ENABLE),
+			"Failed to enable zero copy");
+
+	/* the data is not ciphered, the requests only go through the vring */
+	for (i = 0; i < NB_REQS; i++)
+		ops[i]->status = RTE_CRYPTO_OP_STATUS_SUCCESS;
+
+	nb = rte_vhost_crypto_finalize_requests(ops, NB_REQS, callfds,
+			&nb_callfds);
+	TEST_ASSERT_EQUAL(nb, NB_REQS, "Finalized %u requests out of %u",
+			nb, NB_REQS);
+	TEST_ASSERT_EQUAL(__atomic_load_n(&used->idx, __ATOMIC_ACQUIRE),
+			NB_REQS, "Wrong used index %u", used->idx);
+
+	for (i = 0; i < NB_REQS; i++) {
+		rte_crypto_op_free(ops[i]);
+
+		TEST_ASSERT_EQUAL(used->ring[i].id, i,
+				"Wrong used descriptor %u at %u",
+				used->ring[i].id, i);
+		TEST_ASSERT_EQUAL(used->ring[i].len, DATA_LEN + 1,
+				"Wrong used length %u at %u",
+				used->ring[i].len, i);
+
+		slot = REQ_BASE_OFF + (uint64_t)i * REQ_SIZE;
+		TEST_ASSERT_EQUAL(guest_mem[slot + REQ_INHDR_OFF],
+				VIRTIO_CRYPTO_OK, "Request %u failed", i);
+
+		/* copied requests write their mbuf back to the guest */
+		if (i >= BURST)
+			TEST_ASSERT_BUFFERS_ARE_EQUAL(
+					guest_mem + slot + REQ_DST_OFF,
+					guest_mem + slot + REQ_SRC_OFF,
+					DATA_LEN, "Request %u not written back",
+					i);
+	}
+
+	return TEST_SUCCESS;
+}
+
+static int
+test_vhost_crypto(void)
+{
+	char vdev_name[RTE_CRYPTODEV_NAME_MAX_LEN] = "";
+	char path[PATH_MAX];
+	struct sockaddr_un un;
+	int mem_fd = -1, kick_fd = -1, call_fd = -1, sock = -1;
+	int ret = TEST_FAILED;
+	unsigned int i;
+	int dev_id;
+
+	for (i = 0; i < RTE_DIM(crypto_vdevs); i++) {
+		snprintf(vdev_name, sizeof(vdev_name), "%s_vhost_test",
+				crypto_vdevs[i]);
+		if (rte_vdev_init(vdev_name, NULL) == 0)
+			break;
+	}
+	if (i == RTE_DIM(crypto_vdevs)) {
+		printf("No AES-CBC crypto device, skipping\n");
+		return TEST_SKIPPED;
+	}
+	dev_id = rte_cryptodev_get_dev_id(vdev_name);
+	if (dev_id < 0)
+		goto exit_vdev;
+	test_cid = dev_id;
+
+	sess_pool = rte_cryptodev_sym_session_pool_create(
+			"vhost_crypto_test_sess", NB_OPS, 0, 0, 0,
+			rte_socket_id());
+	sess_priv_pool = rte_mempool_create("vhost_crypto_test_priv",
+			NB_OPS, rte_cryptodev_sym_get_private_session_size(
+				test_cid), 0, 0, NULL, NULL, NULL, NULL,
+			rte_socket_id(), 0);
+	op_pool = rte_crypto_op_pool_create("vhost_crypto_test_op",
+			RTE_CRYPTO_OP_TYPE_SYMMETRIC, NB_OPS, 0,
+			VHOST_CRYPTO_MAX_IV_LEN, rte_socket_id());
+	if (sess_pool == NULL || sess_priv_pool == NULL || op_pool == NULL) {
+		printf("Cannot create pools\n");
+		goto exit_pools;
+	}
+
+	mem_fd = memfd_create("vhost_crypto_test", 0);
+	if (mem_fd < 0 || ftruncate(mem_fd, GUEST_MEM_SIZE) < 0)
+		goto exit_mem;
+	guest_mem = mmap(NULL, GUEST_MEM_SIZE, PROT_READ | PROT_WRITE,
+			MAP_SHARED, mem_fd, 0);
+	if (guest_mem == MAP_FAILED) {
+		guest_mem = NULL;
+		goto exit_mem;
+	}
+	kick_fd = eventfd(0, EFD_NONBLOCK);
+	call_fd = eventfd(0, EFD_NONBLOCK);
+	if (kick_fd < 0 || call_fd < 0)
+		goto exit_mem;
+
+	snprintf(path, sizeof(path), "/tmp/vhost_crypto_test.%d", getpid());
+	unlink(path);
+	if (rte_vhost_driver_register(path, 0) < 0)
+		goto exit_mem;
+	if (rte_vhost_driver_callback_register(path,
+			&vhost_crypto_test_ops) < 0 ||
+			rte_vhost_crypto_driver_start(path) < 0)
+		goto exit_driver;
+
+	sock = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (sock < 0)
+		goto exit_driver;
+	memset(&un, 0, sizeof(un));
+	un.sun_family = AF_UNIX;
+	strlcpy(un.sun_path, path, sizeof(un.sun_path));
+	if (connect(sock, (struct sockaddr *)&un, sizeof(un)) < 0 ||
+			vu_setup(sock, mem_fd, kick_fd, call_fd) < 0) {
+		printf("Cannot set the vhost-user device up\n");
+		goto exit_driver;
+	}
+
+	ret = test_zero_copy_toggle(sock);
+
+exit_driver:
+	if (sock >= 0)
+		close(sock);
+	rte_vhost_driver_unregister(path);
+exit_mem:
+	if (guest_mem != NULL)
+		munmap(guest_mem, GUEST_MEM_SIZE);
+	guest_mem = NULL;
+	if (call_fd >= 0)
+		close(call_fd);
+	if (kick_fd >= 0)
+		close(kick_fd);
+	if (mem_fd >= 0)
+		close(mem_fd);
+exit_pools:
+	rte_mempool_free(op_pool);
+	rte_mempool_free(sess_priv_pool);
+	rte_mempool_free(sess_pool);
+exit_vdev:
+	rte_vdev_uninit(vdev_name);
+	return ret;
+}
+
+REGISTER_TEST_COMMAND(vhost_crypto_autotest, test_vhost_crypto);
@@ -11,6 +11,8 @@
 #include <rte_kvargs.h>
 #include <rte_cycles.h>
 #include <rte_errno.h>
+#include <rte_pause.h>
+#include <rte_service_component.h>
 
 #include <rte_bbdev.h>
 #include <rte_bbdev_pmd.h>
@@ -50,24 +52,38 @@ RTE_LOG_REGISTER_DEFAULT(bbdev_turbo_sw_logtype, NOTICE);
 #define DEINT_OUTPUT_BUF_SIZE (DEINT_INPUT_BUF_SIZE * 6)
 #define ADAPTER_OUTPUT_BUF_SIZE ((RTE_BBDEV_TURBO_MAX_CB_SIZE + 4) * 48)
 
+/* Max number of LDPC decode workers */
+#define TURBO_SW_MAX_WORKERS 32
+/* Max number of LDPC decode ops dispatched to the workers at once */
+#define TURBO_SW_JOB_BURST 32
+
+struct turbo_sw_worker;
+
 /* private data structure */
 struct bbdev_private {
 	unsigned int max_nb_queues;  /**< Max number of queues */
+	uint16_t nb_workers;  /**< Number of LDPC decode workers */
+	struct turbo_sw_worker *workers;  /**< LDPC decode workers */
+	struct rte_ring *jobs;  /**< LDPC decode ops awaiting a worker */
 };
 
 /*  Initialisation params structure that can be used by Turbo SW driver */
 struct turbo_sw_params {
 	int socket_id;  /*< Turbo SW device socket */
 	uint16_t queues_num;  /*< Turbo SW device queues number */
+	uint16_t nb_workers;  /*< Turbo SW device LDPC decode workers */
 };
 
 /* Accecptable params for Turbo SW devices */
 #define TURBO_SW_MAX_NB_QUEUES_ARG  "max_nb_queues"
 #define TURBO_SW_SOCKET_ID_ARG      "socket_id"
+#define TURBO_SW_WORKERS_ARG        "workers"
 
 static const char * const turbo_sw_valid_params[] = {
 	TURBO_SW_MAX_NB_QUEUES_ARG,
-	TURBO_SW_SOCKET_ID_ARG
+	TURBO_SW_SOCKET_ID_ARG,
+	TURBO_SW_WORKERS_ARG,
+	NULL
 };
 
 /* queue */
@@ -92,10 +108,40 @@ struct turbo_sw_queue {
 	uint8_t *deint_output;
 	/* Output buf for bblib_turbodec_adapter_lte() function */
 	uint8_t *adapter_output;
+	/* LDPC decode ops awaiting a worker, shared by the queues */
+	struct rte_ring *jobs;
+	/* LDPC decode ops dispatched to the workers, in enqueue order */
+	struct rte_bbdev_dec_op **inflight;
+	/* Completion flags of the dispatched ops, set by the workers */
+	uint8_t *done;
+	uint32_t inflight_mask;
+	/* Next in-flight slot to fill on enqueue */
+	uint32_t head;
+	/* Next in-flight slot to return on dequeue */
+	uint32_t tail;
 	/* Operation type of this queue */
 	enum rte_bbdev_op_type type;
 } __rte_cache_aligned;
 
+/* LDPC decode op dispatched to the workers */
+struct turbo_sw_job {
+	struct turbo_sw_queue *q;
+	struct rte_bbdev_dec_op *op;
+	uint32_t slot;  /* Index of the op in the in-flight array of q */
+};
+
+/* LDPC decode worker, run as an EAL service */
+struct turbo_sw_worker {
+	/* Jobs shared by all the workers of the device */
+	struct rte_ring *jobs;
+	/* Decoder buffers, only ag, enc_out and adapter_output are used */
+	struct turbo_sw_queue scratch;
+	/* Offload cycles of the decoder, not reported */
+	struct rte_bbdev_stats stats;
+	uint32_t service_id;
+	bool registered;
+} __rte_cache_aligned;
+
 
 #ifdef RTE_BBDEV_SDK_AVX2
 static inline char *
@@ -270,6 +316,8 @@ q_release(struct rte_bbdev *dev, uint16_t q_id)
 		rte_free(q->deint_input);
 		rte_free(q->deint_output);
 		rte_free(q->adapter_output);
+		rte_free(q->inflight);
+		rte_free(q->done);
 		rte_free(q);
 		dev->data->queues[q_id].queue_private = NULL;
 	}
@@ -285,6 +333,7 @@ q_setup(struct rte_bbdev *dev, uint16_t q_id,
 		const struct rte_bbdev_queue_conf *queue_conf)
 {
 	int ret;
+	struct bbdev_private *priv = dev->data->dev_private;
 	struct turbo_sw_queue *q;
 	char name[RTE_RING_NAMESIZE];
 
@@ -459,6 +508,25 @@ q_setup(struct rte_bbdev *dev, uint16_t q_id,
 		goto free_q;
 	}
 
+	/* LDPC decode ops are dispatched to the workers when there are some. */
+	if (queue_conf->op_type == RTE_BBDEV_OP_LDPC_DEC &&
+			priv->nb_workers > 0) {
+		q->inflight = rte_zmalloc_socket(NULL,
+				queue_conf->queue_size * sizeof(*q->inflight),
+				RTE_CACHE_LINE_SIZE, queue_conf->socket);
+		q->done = rte_zmalloc_socket(NULL,
+				queue_conf->queue_size * sizeof(*q->done),
+				RTE_CACHE_LINE_SIZE, queue_conf->socket);
+		if (q->inflight == NULL || q->done == NULL) {
+			rte_bbdev_log(ERR,
+				"Failed to allocate in-flight ops for %s", name);
+			ret = -ENOMEM;
+			goto free_q;
+		}
+		q->inflight_mask = queue_conf->queue_size - 1;
+		q->jobs = priv->jobs;
+	}
+
 	q->type = queue_conf->op_type;
 
 	dev->data->queues[q_id].queue_private = q;
@@ -474,16 +542,12 @@ q_setup(struct rte_bbdev *dev, uint16_t q_id,
 	rte_free(q->deint_input);
 	rte_free(q->deint_output);
 	rte_free(q->adapter_output);
+	rte_free(q->inflight);
+	rte_free(q->done);
 	rte_free(q);
 	return ret;
 }
 
-static const struct rte_bbdev_ops pmd_ops = {
-	.info_get = info_get,
-	.queue_setup = q_setup,
-	.queue_release = q_release
-};
-
 #ifdef RTE_BBDEV_SDK_AVX2
 #ifdef RTE_LIBRTE_BBDEV_DEBUG
 /* Checks if the encoder input buffer is correct.
@@ -1850,6 +1914,151 @@ dequeue_enc_ops(struct rte_bbdev_queue_data *q_data,
 	return nb_dequeued;
 }
 
+/* Decode an LDPC op on a worker and flag its completion */
+static inline void
+turbo_sw_job_process(struct turbo_sw_worker *w, const struct turbo_sw_job *job)
+{
+	enqueue_ldpc_dec_one_op(&w->scratch, job->op, &w->stats);
+	__atomic_store_n(&job->q->done[job->slot], 1, __ATOMIC_RELEASE);
+}
+
+/* Worker service function */
+static int32_t
+turbo_sw_worker_run(void *arg)
+{
+	struct turbo_sw_worker *w = arg;
+	struct turbo_sw_job job;
+
+	/* Take one op at a time, so that a burst is spread over the workers. */
+	if (rte_ring_dequeue_elem(w->jobs, &job, sizeof(job)) != 0)
+		return -EAGAIN;
+	turbo_sw_job_process(w, &job);
+	return 0;
+}
+
+/* Enqueue LDPC decode burst to the workers */
+static uint16_t
+enqueue_ldpc_dec_ops_workers(struct rte_bbdev_queue_data *q_data,
+		struct rte_bbdev_dec_op **ops, uint16_t nb_ops)
+{
+	struct turbo_sw_queue *q = q_data->queue_private;
+	struct turbo_sw_job jobs[TURBO_SW_JOB_BURST];
+	uint32_t head = q->head;
+	uint32_t nb_free, slot;
+	uint16_t nb_enqueued = 0, nb, burst, n, i;
+
+	nb_free = q->inflight_mask + 1 -
+			(head - __atomic_load_n(&q->tail, __ATOMIC_ACQUIRE));
+	nb = RTE_MIN(nb_ops, nb_free);
+
+	while (nb_enqueued < nb) {
+		burst = RTE_MIN(nb - nb_enqueued, TURBO_SW_JOB_BURST);
+		for (i = 0; i < burst; i++) {
+			slot = (head + i) & q->inflight_mask;
+			q->inflight[slot] = ops[nb_enqueued + i];
+			jobs[i].q = q;
+			jobs[i].op = ops[nb_enqueued + i];
+			jobs[i].slot = slot;
+		}
+		n = rte_ring_enqueue_burst_elem(q->jobs, jobs, sizeof(jobs[0]),
+				burst, NULL);
+		head += n;
+		nb_enqueued += n;
+		if (n < burst)
+			break;
+	}
+	__atomic_store_n(&q->head, head, __ATOMIC_RELEASE);
+
+#ifdef RTE_BBDEV_OFFLOAD_COST
+	q_data->queue_stats.acc_offload_cycles = 0;
+#endif
+	q_data->queue_stats.enqueue_err_count += nb_ops - nb_enqueued;
+	q_data->queue_stats.enqueued_count += nb_enqueued;
+
+	return nb_enqueued;
+}
+
+/* Dequeue LDPC decode burst completed by the workers */
+static uint16_t
+dequeue_ldpc_dec_ops_workers(struct rte_bbdev_queue_data *q_data,
+		struct rte_bbdev_dec_op **ops, uint16_t nb_ops)
+{
+	struct turbo_sw_queue *q = q_data->queue_private;
+	uint32_t head = __atomic_load_n(&q->head, __ATOMIC_ACQUIRE);
+	uint32_t tail = q->tail;
+	uint32_t slot;
+	uint16_t nb_dequeued = 0;
+
+	/* The ops are returned in enqueue order, the first pending one stops
+	 * the burst even if the workers completed some of the next ones.
+	 */
+	while (nb_dequeued < nb_ops && tail != head) {
+		slot = tail & q->inflight_mask;
+		if (!__atomic_load_n(&q->done[slot], __ATOMIC_ACQUIRE))
+			break;
+		q->done[slot] = 0;
+		ops[nb_dequeued++] = q->inflight[slot];
+		tail++;
+	}
+	__atomic_store_n(&q->tail, tail, __ATOMIC_RELEASE);
+	q_data->queue_stats.dequeued_count += nb_dequeued;
+
+	return nb_dequeued;
+}
+
+/* Start device */
+static int
+turbo_sw_start(struct rte_bbdev *dev)
+{
+	struct bbdev_private *priv = dev->data->dev_private;
+	uint16_t i;
+
+	for (i = 0; i < priv->nb_workers; i++) {
+		rte_service_component_runstate_set(
+				priv->workers[i].service_id, 1);
+		if (rte_service_runstate_get(priv->workers[i].service_id) != 1)
+			rte_bbdev_log(WARNING,
+				"No service core runs worker %u of device %u",
+				i, dev->data->dev_id);
+	}
+
+	return 0;
+}
+
+/* Stop device */
+static void
+turbo_sw_stop(struct rte_bbdev *dev)
+{
+	struct bbdev_private *priv = dev->data->dev_private;
+	struct turbo_sw_job job;
+	uint16_t i;
+
+	if (priv->nb_workers == 0)
+		return;
+
+	for (i = 0; i < priv->nb_workers; i++)
+		rte_service_component_runstate_set(
+				priv->workers[i].service_id, 0);
+	for (i = 0; i < priv->nb_workers; i++)
+		while (rte_service_may_be_active(
+				priv->workers[i].service_id) == 1)
+			rte_pause();
+
+	/* Decode the ops left by the workers, the queues may be released
+	 * once the device is stopped.
+	 */
+	while (rte_ring_dequeue_elem(priv->jobs, &job, sizeof(job)) == 0)
+		turbo_sw_job_process(&priv->workers[0], &job);
+}
+
+static const struct rte_bbdev_ops pmd_ops = {
+	.start = turbo_sw_start,
+	.stop = turbo_sw_stop,
+	.info_get = info_get,
+	.queue_setup = q_setup,
+	.queue_release = q_release
+};
+
 /* Parse 16bit integer from string argument */
 static inline int
 parse_u16_arg(const char *key, const char *value, void *extra_args)
@@ -1898,6 +2107,19 @@ parse_turbo_sw_params(struct turbo_sw_params *params, const char *input_args)
 					RTE_MAX_NUMA_NODES);
 			goto exit;
 		}
+
+		ret = rte_kvargs_process(kvlist, turbo_sw_valid_params[2],
+					&parse_u16_arg, &params->nb_workers);
+		if (ret < 0)
+			goto exit;
+
+		if (params->nb_workers > TURBO_SW_MAX_WORKERS) {
+			rte_bbdev_log(ERR, "Invalid workers, must be <= %u",
+					TURBO_SW_MAX_WORKERS);
+			params->nb_workers = 0;
+			ret = -EINVAL;
+			goto exit;
+		}
 	}
 
 exit:
@@ -1906,6 +2128,111 @@ parse_turbo_sw_params(struct turbo_sw_params *params, const char *input_args)
 	return ret;
 }
 
+/* Release the LDPC decode workers */
+static void
+turbo_sw_workers_free(struct bbdev_private *priv)
+{
+	struct turbo_sw_worker *w;
+	uint16_t i;
+
+	rte_ring_free(priv->jobs);
+	priv->jobs = NULL;
+	if (priv->workers == NULL)
+		return;
+
+	for (i = 0; i < priv->nb_workers; i++) {
+		w = &priv->workers[i];
+		if (w->registered)
+			rte_service_component_unregister(w->service_id);
+		rte_free(w->scratch.ag);
+		rte_free(w->scratch.enc_out);
+		rte_free(w->scratch.adapter_output);
+	}
+	rte_free(priv->workers);
+	priv->workers = NULL;
+	priv->nb_workers = 0;
+}
+
+/* Create the LDPC decode workers, each one is an EAL service which the
+ * application maps to its service cores.
+ */
+static int
+turbo_sw_workers_create(struct rte_bbdev *bbdev, const char *name,
+		uint16_t nb_workers, int socket_id)
+{
+	struct bbdev_private *priv = bbdev->data->dev_private;
+	struct rte_service_spec service;
+	char ring_name[RTE_RING_NAMESIZE];
+	struct turbo_sw_worker *w;
+	uint16_t i;
+	int ret;
+
+	ret = snprintf(ring_name, sizeof(ring_name),
+			RTE_STR(DRIVER_NAME)"_jobs%u", bbdev->data->dev_id);
+	if ((ret < 0) || (ret >= (int)sizeof(ring_name)))
+		return -ENAMETOOLONG;
+	priv->jobs = rte_ring_create_elem(ring_name, sizeof(struct turbo_sw_job),
+			RTE_BBDEV_QUEUE_SIZE_LIMIT, socket_id, 0);
+	if (priv->jobs == NULL) {
+		rte_bbdev_log(ERR, "Failed to create ring for %s", ring_name);
+		return -rte_errno;
+	}
+
+	priv->workers = rte_zmalloc_socket(name,
+			nb_workers * sizeof(*priv->workers),
+			RTE_CACHE_LINE_SIZE, socket_id);
+	if (priv->workers == NULL)
+		goto free_workers;
+	priv->nb_workers = nb_workers;
+
+	for (i = 0; i < nb_workers; i++) {
+		w = &priv->workers[i];
+		w->jobs = priv->jobs;
+		w->scratch.ag = rte_zmalloc_socket(NULL,
+				RTE_BBDEV_TURBO_MAX_CB_SIZE * 10 *
+				sizeof(*w->scratch.ag),
+				RTE_CACHE_LINE_SIZE, socket_id);
+		w->scratch.enc_out = rte_zmalloc_socket(NULL,
+				((RTE_BBDEV_TURBO_MAX_TB_SIZE >> 3) + 3) *
+				sizeof(*w->scratch.enc_out) * 3,
+				RTE_CACHE_LINE_SIZE, socket_id);
+		w->scratch.adapter_output = rte_zmalloc_socket(NULL,
+				ADAPTER_OUTPUT_BUF_SIZE *
+				sizeof(*w->scratch.adapter_output),
+				RTE_CACHE_LINE_SIZE, socket_id);
+		if (w->scratch.ag == NULL || w->scratch.enc_out == NULL ||
+				w->scratch.adapter_output == NULL)
+			goto free_workers;
+
+		memset(&service, 0, sizeof(service));
+		ret = snprintf(service.name, sizeof(service.name),
+				"%s_worker%u", name, i);
+		if ((ret < 0) || (ret >= (int)sizeof(service.name))) {
+			rte_bbdev_log(ERR, "Worker name too long for %s", name);
+			turbo_sw_workers_free(priv);
+			return -ENAMETOOLONG;
+		}
+		service.socket_id = socket_id;
+		service.callback = turbo_sw_worker_run;
+		service.callback_userdata = w;
+		ret = rte_service_component_register(&service, &w->service_id);
+		if (ret != 0) {
+			rte_bbdev_log(ERR, "Failed to register service %s",
+					service.name);
+			turbo_sw_workers_free(priv);
+			return ret;
+		}
+		w->registered = true;
+	}
+
+	return 0;
+
+free_workers:
+	rte_bbdev_log(ERR, "Failed to allocate workers memory for %s", name);
+	turbo_sw_workers_free(priv);
+	return -ENOMEM;
+}
+
 /* Create device */
 static int
 turbo_sw_bbdev_create(struct rte_vdev_device *vdev,
@@ -1913,6 +2240,7 @@ turbo_sw_bbdev_create(struct rte_vdev_device *vdev,
 {
 	struct rte_bbdev *bbdev;
 	const char *name = rte_vdev_device_name(vdev);
+	int ret;
 
 	bbdev = rte_bbdev_allocate(name);
 	if (bbdev == NULL)
@@ -1943,6 +2271,18 @@ turbo_sw_bbdev_create(struct rte_vdev_device *vdev,
 	((struct bbdev_private *) bbdev->data->dev_private)->max_nb_queues =
 			init_params->queues_num;
 
+	if (init_params->nb_workers > 0) {
+		ret = turbo_sw_workers_create(bbdev, name,
+				init_params->nb_workers, init_params->socket_id);
+		if (ret != 0) {
+			rte_free(bbdev->data->dev_private);
+			rte_bbdev_release(bbdev);
+			return ret;
+		}
+		bbdev->enqueue_ldpc_dec_ops = enqueue_ldpc_dec_ops_workers;
+		bbdev->dequeue_ldpc_dec_ops = dequeue_ldpc_dec_ops_workers;
+	}
+
 	return 0;
 }
 
@@ -1967,8 +2307,9 @@ turbo_sw_bbdev_probe(struct rte_vdev_device *vdev)
 	parse_turbo_sw_params(&init_params, input_args);
 
 	rte_bbdev_log_debug(
-			"Initialising %s on NUMA node %d with max queues: %d\n",
-			name, init_params.socket_id, init_params.queues_num);
+			"Initialising %s on NUMA node %d with max queues: %d, workers: %u\n",
+			name, init_params.socket_id, init_params.queues_num,
+			init_params.nb_workers);
 
 	return turbo_sw_bbdev_create(vdev, &init_params);
 }
@@ -1991,6 +2332,7 @@ turbo_sw_bbdev_remove(struct rte_vdev_device *vdev)
 	if (bbdev == NULL)
 		return -EINVAL;
 
+	turbo_sw_workers_free(bbdev->data->dev_private);
 	rte_free(bbdev->data->dev_private);
 
 	return rte_bbdev_release(bbdev);
@@ -2004,5 +2346,6 @@ static struct rte_vdev_driver bbdev_turbo_sw_pmd_drv = {
 RTE_PMD_REGISTER_VDEV(DRIVER_NAME, bbdev_turbo_sw_pmd_drv);
 RTE_PMD_REGISTER_PARAM_STRING(DRIVER_NAME,
 	TURBO_SW_MAX_NB_QUEUES_ARG"=<int> "
-	TURBO_SW_SOCKET_ID_ARG"=<int>");
+	TURBO_SW_SOCKET_ID_ARG"=<int> "
+	TURBO_SW_WORKERS_ARG"=<int>");
 RTE_PMD_REGISTER_ALIAS(DRIVER_NAME, turbo_sw);
@@ -4,6 +4,7 @@
 
 #include <string.h>
 #include <dirent.h>
+#include <pthread.h>
 
 #include <rte_log.h>
 #include <rte_bus.h>
@@ -30,6 +31,12 @@
 
 extern struct rte_pci_bus rte_pci_bus;
 
+/*
+ * The VFIO group and container setup and the lists of mapped resources are
+ * not thread safe, serialize the mappings done by a parallel probe.
+ */
+static pthread_mutex_t pci_map_lock = PTHREAD_MUTEX_INITIALIZER;
+
 static int
 pci_get_kernel_driver_by_path(const char *filename, char *dri_name,
 			      size_t len)
@@ -66,6 +73,7 @@ rte_pci_map_device(struct rte_pci_device *dev)
 {
 	int ret = -1;
 
+	pthread_mutex_lock(&pci_map_lock);
 	/* try mapping the NIC resources using VFIO if it exists */
 	switch (dev->kdrv) {
 	case RTE_PCI_KDRV_VFIO:
@@ -87,6 +95,7 @@ rte_pci_map_device(struct rte_pci_device *dev)
 		ret = 1;
 		break;
 	}
+	pthread_mutex_unlock(&pci_map_lock);
 
 	return ret;
 }
@@ -95,6 +104,7 @@ rte_pci_map_device(struct rte_pci_device *dev)
 void
 rte_pci_unmap_device(struct rte_pci_device *dev)
 {
+	pthread_mutex_lock(&pci_map_lock);
 	/* try unmapping the NIC resources using VFIO if it exists */
 	switch (dev->kdrv) {
 	case RTE_PCI_KDRV_VFIO:
@@ -113,6 +123,7 @@ rte_pci_unmap_device(struct rte_pci_device *dev)
 			"  Not managed by a supported kernel driver, skipped\n");
 		break;
 	}
+	pthread_mutex_unlock(&pci_map_lock);
 }
 
 static int
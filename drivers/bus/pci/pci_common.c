@@ -9,6 +9,7 @@
 #include <stdbool.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <pthread.h>
 #include <sys/queue.h>
 #include <rte_errno.h>
 #include <rte_interrupts.h>
@@ -22,7 +23,9 @@
 #include <rte_eal_paging.h>
 #include <rte_string_fns.h>
 #include <rte_common.h>
+#include <rte_cycles.h>
 #include <rte_devargs.h>
+#include <rte_lcore.h>
 #include <rte_vfio.h>
 
 #include "private.h"
@@ -327,6 +330,131 @@ pci_probe_all_drivers(struct rte_pci_device *dev)
 	return 1;
 }
 
+/* Account the result of the probe of a device, return 1 on failure. */
+static int
+pci_probe_result(const struct rte_pci_device *dev, int ret, int err)
+{
+	if (ret >= 0 || ret == -EEXIST)
+		return 0;
+
+	RTE_LOG(ERR, EAL, "Requested device " PCI_PRI_FMT " cannot be used\n",
+		dev->addr.domain, dev->addr.bus, dev->addr.devid,
+		dev->addr.function);
+	rte_errno = err;
+	return 1;
+}
+
+/*
+ * State shared by the threads of a parallel probe. The devices are split
+ * in groups of the functions of a same physical device, which are probed
+ * in order by a single thread, as they may depend on each other (shared
+ * firmware, representors, bonding of the ports of a NIC).
+ */
+struct pci_probe_ctx {
+	struct rte_pci_device **devs;
+	int *rets;
+	int *errs;
+	unsigned int *groups; /* first device of each group, and the end */
+	unsigned int nb_groups;
+	unsigned int next_group;
+	unsigned int running;
+};
+
+static void *
+pci_probe_worker(void *arg)
+{
+	struct pci_probe_ctx *ctx = arg;
+	unsigned int g, i;
+
+	while ((g = __atomic_fetch_add(&ctx->next_group, 1,
+			__ATOMIC_RELAXED)) < ctx->nb_groups) {
+		for (i = ctx->groups[g]; i < ctx->groups[g + 1]; i++) {
+			ctx->rets[i] = pci_probe_all_drivers(ctx->devs[i]);
+			ctx->errs[i] = errno;
+		}
+	}
+
+	__atomic_sub_fetch(&ctx->running, 1, __ATOMIC_RELEASE);
+	return NULL;
+}
+
+/*
+ * Probe the devices from nb_threads threads, the current one included.
+ * Return -ENOMEM if the probe could not be started.
+ */
+static int
+pci_probe_parallel(unsigned int nb_threads)
+{
+	struct pci_probe_ctx ctx;
+	struct rte_pci_device *dev, *prev = NULL;
+	pthread_t *threads;
+	size_t probed = 0, failed = 0;
+	char name[RTE_MAX_THREAD_NAME_LEN];
+	unsigned int i, nb_started = 0;
+	int ret = -ENOMEM;
+
+	memset(&ctx, 0, sizeof(ctx));
+	FOREACH_DEVICE_ON_PCIBUS(dev)
+		probed++;
+	if (probed == 0)
+		return 0;
+	ctx.devs = calloc(probed, sizeof(*ctx.devs));
+	ctx.rets = calloc(probed, sizeof(*ctx.rets));
+	ctx.errs = calloc(probed, sizeof(*ctx.errs));
+	ctx.groups = calloc(probed + 1, sizeof(*ctx.groups));
+	threads = calloc(nb_threads, sizeof(*threads));
+	if (ctx.devs == NULL || ctx.rets == NULL || ctx.errs == NULL ||
+	    ctx.groups == NULL || threads == NULL)
+		goto out;
+
+	/* The devices are sorted by address on the bus. */
+	i = 0;
+	FOREACH_DEVICE_ON_PCIBUS(dev) {
+		if (prev == NULL || dev->addr.domain != prev->addr.domain ||
+		    dev->addr.bus != prev->addr.bus ||
+		    dev->addr.devid != prev->addr.devid)
+			ctx.groups[ctx.nb_groups++] = i;
+		ctx.devs[i++] = dev;
+		prev = dev;
+	}
+	ctx.groups[ctx.nb_groups] = i;
+
+	nb_threads = RTE_MIN(nb_threads, ctx.nb_groups);
+	ctx.running = nb_threads;
+	for (i = 1; i < nb_threads; i++) {
+		snprintf(name, sizeof(name), "pci-probe-%u", i);
+		if (rte_ctrl_thread_create(&threads[i], name, NULL,
+				pci_probe_worker, &ctx) != 0) {
+			RTE_LOG(WARNING, EAL, "Cannot create PCI probe thread\n");
+			__atomic_sub_fetch(&ctx.running, nb_threads - i,
+					__ATOMIC_RELAXED);
+			break;
+		}
+		nb_started++;
+	}
+	RTE_LOG(DEBUG, EAL, "Probing %u PCI devices with %u threads\n",
+		ctx.nb_groups, nb_started + 1);
+
+	pci_probe_worker(&ctx);
+	while (__atomic_load_n(&ctx.running, __ATOMIC_ACQUIRE) != 0)
+		rte_delay_us_sleep(100);
+	for (i = 1; i <= nb_started; i++)
+		pthread_join(threads[i], NULL);
+
+	for (i = 0; i < probed; i++)
+		failed += pci_probe_result(ctx.devs[i], ctx.rets[i],
+				ctx.errs[i]);
+	ret = (probed && probed == failed) ? -1 : 0;
+
+out:
+	free(threads);
+	free(ctx.groups);
+	free(ctx.errs);
+	free(ctx.rets);
+	free(ctx.devs);
+	return ret;
+}
+
 /*
  * Scan the content of the PCI bus, and call the probe() function for
  * all registered drivers that have a matching entry in its id_table
@@ -337,23 +465,22 @@ pci_probe(void)
 {
 	struct rte_pci_device *dev = NULL;
 	size_t probed = 0, failed = 0;
-	int ret = 0;
+	unsigned int nb_threads;
+	int ret;
+
+	nb_threads = rte_eal_probe_threads();
+	if (nb_threads > 1) {
+		ret = pci_probe_parallel(nb_threads);
+		if (ret != -ENOMEM)
+			return ret;
+		RTE_LOG(WARNING, EAL, "Cannot probe PCI devices in parallel\n");
+	}
 
 	FOREACH_DEVICE_ON_PCIBUS(dev) {
 		probed++;
 
 		ret = pci_probe_all_drivers(dev);
-		if (ret < 0) {
-			if (ret != -EEXIST) {
-				RTE_LOG(ERR, EAL, "Requested device "
-					PCI_PRI_FMT " cannot be used\n",
-					dev->addr.domain, dev->addr.bus,
-					dev->addr.devid, dev->addr.function);
-				rte_errno = errno;
-				failed++;
-			}
-			ret = 0;
-		}
+		failed += pci_probe_result(dev, ret, errno);
 	}
 
 	return (probed && probed == failed) ? -1 : 0;
@@ -7,6 +7,7 @@
 #include <rte_common.h>
 #include <rte_malloc.h>
 #include <rte_mbuf.h>
+#include <rte_prefetch.h>
 #include <rte_compressdev_pmd.h>
 
 #include "isal_compress_pmd_private.h"
@@ -18,6 +19,11 @@
 #define RTE_COMP_ISAL_LEVEL_THREE 3 /* Optimised for AVX512 & AVX2 only */
 #define CHKSUM_SZ_CRC 8
 #define CHKSUM_SZ_ADLER 4
+/*
+ * Ops up to this size use the small level buffer of their level, whose
+ * smaller hash table is cheaper to reset on each stateless op.
+ */
+#define RTE_COMP_ISAL_SMALL_OP_SZ (8 * 1024)
 
 #define STRINGIFY(s) #s
 #define ISAL_TOSTRING(maj, min, patch) \
@@ -63,14 +69,18 @@ isal_comp_set_priv_xform_parameters(struct isal_priv_xform *priv_xform,
 		case(RTE_COMP_HUFFMAN_DEFAULT):
 			priv_xform->compress.deflate.huffman =
 					RTE_COMP_HUFFMAN_DEFAULT;
+			priv_xform->huffman_type = IGZIP_HUFFTABLE_DEFAULT;
 			break;
 		case(RTE_COMP_HUFFMAN_FIXED):
 			priv_xform->compress.deflate.huffman =
 					RTE_COMP_HUFFMAN_FIXED;
+			priv_xform->huffman_type = IGZIP_HUFFTABLE_STATIC;
 			break;
+		/* Dynamically change the huffman code to suit the input data */
 		case(RTE_COMP_HUFFMAN_DYNAMIC):
 			priv_xform->compress.deflate.huffman =
 					RTE_COMP_HUFFMAN_DYNAMIC;
+			priv_xform->huffman_type = IGZIP_HUFFTABLE_DEFAULT;
 			break;
 		default:
 			ISAL_PMD_LOG(ERR, "Huffman code not supported\n");
@@ -122,6 +132,8 @@ isal_comp_set_priv_xform_parameters(struct isal_priv_xform *priv_xform,
 			priv_xform->compress.level = RTE_COMP_ISAL_LEVEL_ZERO;
 			priv_xform->level_buffer_size =
 					ISAL_DEF_LVL0_DEFAULT;
+			priv_xform->level_buffer_size_small =
+					ISAL_DEF_LVL0_SMALL;
 		} else {
 			/* Mapping API levels to ISA-L levels 1,2 & 3 */
 			switch (xform->compress.level) {
@@ -131,18 +143,24 @@ isal_comp_set_priv_xform_parameters(struct isal_priv_xform *priv_xform,
 						RTE_COMP_ISAL_LEVEL_ONE;
 				priv_xform->level_buffer_size =
 						ISAL_DEF_LVL1_DEFAULT;
+				priv_xform->level_buffer_size_small =
+						ISAL_DEF_LVL1_SMALL;
 				break;
 			case RTE_COMP_LEVEL_MIN:
 				priv_xform->compress.level =
 						RTE_COMP_ISAL_LEVEL_ONE;
 				priv_xform->level_buffer_size =
 						ISAL_DEF_LVL1_DEFAULT;
+				priv_xform->level_buffer_size_small =
+						ISAL_DEF_LVL1_SMALL;
 				break;
 			case RTE_COMP_ISAL_LEVEL_TWO:
 				priv_xform->compress.level =
 						RTE_COMP_ISAL_LEVEL_TWO;
 				priv_xform->level_buffer_size =
 						ISAL_DEF_LVL2_DEFAULT;
+				priv_xform->level_buffer_size_small =
+						ISAL_DEF_LVL2_SMALL;
 				break;
 			/* Level 3 or higher requested */
 			default:
@@ -153,6 +171,8 @@ isal_comp_set_priv_xform_parameters(struct isal_priv_xform *priv_xform,
 						RTE_COMP_ISAL_LEVEL_THREE;
 					priv_xform->level_buffer_size =
 						ISAL_DEF_LVL3_DEFAULT;
+					priv_xform->level_buffer_size_small =
+						ISAL_DEF_LVL3_SMALL;
 				}
 				/* Check for AVX2, to use ISA-L level 3 */
 				else if (rte_cpu_get_flag_enabled(
@@ -161,6 +181,8 @@ isal_comp_set_priv_xform_parameters(struct isal_priv_xform *priv_xform,
 						RTE_COMP_ISAL_LEVEL_THREE;
 					priv_xform->level_buffer_size =
 						ISAL_DEF_LVL3_DEFAULT;
+					priv_xform->level_buffer_size_small =
+						ISAL_DEF_LVL3_SMALL;
 				} else {
 					ISAL_PMD_LOG(DEBUG, "Requested ISA-L level"
 						" 3 or above; Level 3 optimized"
@@ -170,6 +192,8 @@ isal_comp_set_priv_xform_parameters(struct isal_priv_xform *priv_xform,
 						RTE_COMP_ISAL_LEVEL_TWO;
 					priv_xform->level_buffer_size =
 						ISAL_DEF_LVL2_DEFAULT;
+					priv_xform->level_buffer_size_small =
+						ISAL_DEF_LVL2_SMALL;
 				}
 			}
 		}
@@ -430,21 +454,16 @@ process_isal_deflate(struct rte_comp_op *op, struct isal_comp_qp *qp,
 
 	/* set compression level & intermediate level buffer size */
 	qp->stream->level = priv_xform->compress.level;
-	qp->stream->level_buf_size = priv_xform->level_buffer_size;
-
-	/* Set op huffman code */
-	if (priv_xform->compress.deflate.huffman == RTE_COMP_HUFFMAN_FIXED)
-		isal_deflate_set_hufftables(qp->stream, NULL,
-				IGZIP_HUFFTABLE_STATIC);
-	else if (priv_xform->compress.deflate.huffman ==
-			RTE_COMP_HUFFMAN_DEFAULT)
+	if (op->src.length <= RTE_COMP_ISAL_SMALL_OP_SZ)
+		qp->stream->level_buf_size =
+				priv_xform->level_buffer_size_small;
+	else
+		qp->stream->level_buf_size = priv_xform->level_buffer_size;
+
+	/* Set op huffman code, the default one is set by the init */
+	if (priv_xform->huffman_type != IGZIP_HUFFTABLE_DEFAULT)
 		isal_deflate_set_hufftables(qp->stream, NULL,
-			IGZIP_HUFFTABLE_DEFAULT);
-	/* Dynamically change the huffman code to suit the input data */
-	else if (priv_xform->compress.deflate.huffman ==
-			RTE_COMP_HUFFMAN_DYNAMIC)
-		isal_deflate_set_hufftables(qp->stream, NULL,
-				IGZIP_HUFFTABLE_DEFAULT);
+				priv_xform->huffman_type);
 
 	if (op->m_src->pkt_len < (op->src.length + op->src.offset)) {
 		ISAL_PMD_LOG(ERR, "Input mbuf(s) not big enough.\n");
@@ -635,6 +654,12 @@ isal_comp_pmd_enqueue_burst(void *queue_pair, struct rte_comp_op **ops,
 	int16_t num_enq = RTE_MIN(qp->num_free_elements, nb_ops);
 
 	for (i = 0; i < num_enq; i++) {
+		/* Prefetch the next op while processing this one */
+		if (i + 1 < num_enq) {
+			rte_prefetch0(ops[i + 1]->private_xform);
+			rte_prefetch0(rte_pktmbuf_mtod_offset(ops[i + 1]->m_src,
+					void *, ops[i + 1]->src.offset));
+		}
 		if (unlikely(ops[i]->op_type != RTE_COMP_OP_STATELESS)) {
 			ops[i]->status = RTE_COMP_OP_STATUS_INVALID_ARGS;
 			ISAL_PMD_LOG(ERR, "Stateful operation not Supported\n");
@@ -44,6 +44,10 @@ struct isal_priv_xform {
 		struct rte_comp_decompress_xform decompress;
 	};
 	uint32_t level_buffer_size;
+	/* Level buffer size of the small ops, with a smaller hash table */
+	uint32_t level_buffer_size_small;
+	/* ISA-L Huffman table type, resolved once for all the ops */
+	int huffman_type;
 } __rte_cache_aligned;
 
 /** Set and validate NULL comp private xform parameters */
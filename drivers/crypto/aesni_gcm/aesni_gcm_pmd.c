@@ -497,6 +497,47 @@ aesni_gcm_sgl_op_finalize_decryption(const struct aesni_gcm_session *s,
 		EBADMSG;
 }
 
+/*
+ * Single segment buffers, the common case, are processed with the one-shot
+ * GCM function: its multi-block loop then runs over the whole buffer instead
+ * of being split into init/update/finalize calls.
+ */
+static inline int32_t
+aesni_gcm_sgl_op_oneshot_encryption(const struct aesni_gcm_session *s,
+	struct gcm_context_data *gdata_ctx, struct rte_crypto_vec *data,
+	void *iv, void *aad, uint8_t *digest)
+{
+	uint8_t tmpdigest[s->gen_digest_length];
+	uint8_t *tag = digest;
+
+	if (s->req_digest_length != s->gen_digest_length)
+		tag = tmpdigest;
+
+	s->ops.cipher(&s->gdata_key, gdata_ctx, data->base, data->base,
+		data->len, iv, aad, (uint64_t)s->aad_length, tag,
+		s->gen_digest_length);
+
+	if (tag != digest)
+		memcpy(digest, tmpdigest, s->req_digest_length);
+
+	return 0;
+}
+
+static inline int32_t
+aesni_gcm_sgl_op_oneshot_decryption(const struct aesni_gcm_session *s,
+	struct gcm_context_data *gdata_ctx, struct rte_crypto_vec *data,
+	void *iv, void *aad, uint8_t *digest)
+{
+	uint8_t tmpdigest[s->gen_digest_length];
+
+	s->ops.cipher(&s->gdata_key, gdata_ctx, data->base, data->base,
+		data->len, iv, aad, (uint64_t)s->aad_length, tmpdigest,
+		s->gen_digest_length);
+
+	return memcmp(digest, tmpdigest, s->req_digest_length) == 0 ? 0 :
+		EBADMSG;
+}
+
 static inline void
 aesni_gcm_process_gcm_sgl_op(const struct aesni_gcm_session *s,
 	struct gcm_context_data *gdata_ctx, struct rte_crypto_sgl *sgl,
@@ -534,6 +575,18 @@ aesni_gcm_sgl_encrypt(struct aesni_gcm_session *s,
 
 	processed = 0;
 	for (i = 0; i < vec->num; ++i) {
+		/* prefetch the next buffer while this one is processed */
+		if (i + 1 < vec->num)
+			rte_prefetch0(vec->sgl[i + 1].vec[0].base);
+
+		if (vec->sgl[i].num == 1) {
+			vec->status[i] = aesni_gcm_sgl_op_oneshot_encryption(s,
+				gdata_ctx, &vec->sgl[i].vec[0], vec->iv[i].va,
+				vec->aad[i].va, vec->digest[i].va);
+			processed += (vec->status[i] == 0);
+			continue;
+		}
+
 		aesni_gcm_process_gcm_sgl_op(s, gdata_ctx,
 			&vec->sgl[i], vec->iv[i].va,
 			vec->aad[i].va);
@@ -553,6 +606,18 @@ aesni_gcm_sgl_decrypt(struct aesni_gcm_session *s,
 
 	processed = 0;
 	for (i = 0; i < vec->num; ++i) {
+		/* prefetch the next buffer while this one is processed */
+		if (i + 1 < vec->num)
+			rte_prefetch0(vec->sgl[i + 1].vec[0].base);
+
+		if (vec->sgl[i].num == 1) {
+			vec->status[i] = aesni_gcm_sgl_op_oneshot_decryption(s,
+				gdata_ctx, &vec->sgl[i].vec[0], vec->iv[i].va,
+				vec->aad[i].va, vec->digest[i].va);
+			processed += (vec->status[i] == 0);
+			continue;
+		}
+
 		aesni_gcm_process_gcm_sgl_op(s, gdata_ctx,
 			&vec->sgl[i], vec->iv[i].va,
 			vec->aad[i].va);
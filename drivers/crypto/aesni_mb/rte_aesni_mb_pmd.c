@@ -1948,6 +1948,17 @@ generate_sync_dgst(struct rte_crypto_sym_vec *vec,
 	return k;
 }
 
+static inline uint32_t
+count_sync_status(const struct rte_crypto_sym_vec *vec)
+{
+	uint32_t i, k;
+
+	for (i = 0, k = 0; i != vec->num; i++)
+		k += (vec->status[i] == 0);
+
+	return k;
+}
+
 static inline uint32_t
 verify_sync_dgst(struct rte_crypto_sym_vec *vec,
 	const uint8_t dgst[][DIGEST_LENGTH_MAX], uint32_t len)
@@ -1973,11 +1984,12 @@ aesni_mb_cpu_crypto_process_bulk(struct rte_cryptodev *dev,
 {
 	int32_t ret;
 	uint32_t i, j, k, len;
-	void *buf;
+	void *buf, *dgst;
 	JOB_AES_HMAC *job;
 	MB_MGR *mb_mgr;
 	struct aesni_mb_private *priv;
 	struct aesni_mb_session *s;
+	uint8_t direct_dgst;
 	uint8_t tmp_dgst[vec->num][DIGEST_LENGTH_MAX];
 
 	s = get_sym_session_private_data(sess, dev->driver_id);
@@ -1986,6 +1998,13 @@ aesni_mb_cpu_crypto_process_bulk(struct rte_cryptodev *dev,
 		return 0;
 	}
 
+	/*
+	 * Untruncated digests are generated straight into the user buffers,
+	 * which saves copying them once the jobs are completed.
+	 */
+	direct_dgst = s->auth.operation != RTE_CRYPTO_AUTH_OP_VERIFY &&
+		s->auth.gen_digest_len == s->auth.req_digest_len;
+
 	/* get per-thread MB MGR, create one if needed */
 	mb_mgr = RTE_PER_LCORE(sync_mb_mgr);
 	if (mb_mgr == NULL) {
@@ -2011,6 +2030,10 @@ aesni_mb_cpu_crypto_process_bulk(struct rte_cryptodev *dev,
 		buf = vec->sgl[i].vec[0].base;
 		len = vec->sgl[i].vec[0].len;
 
+		/* prefetch the next buffer while the lanes are filled */
+		if (i + 1 != vec->num)
+			rte_prefetch0(vec->sgl[i + 1].vec[0].base);
+
 		job = IMB_GET_NEXT_JOB(mb_mgr);
 		if (job == NULL) {
 			k += flush_mb_sync_mgr(mb_mgr);
@@ -2018,9 +2041,11 @@ aesni_mb_cpu_crypto_process_bulk(struct rte_cryptodev *dev,
 			RTE_ASSERT(job != NULL);
 		}
 
+		dgst = direct_dgst ? vec->digest[i].va : tmp_dgst[i];
+
 		/* Submit job for processing */
 		set_cpu_mb_job_params(job, s, sofs, buf, len, &vec->iv[i],
-			&vec->aad[i], tmp_dgst[i], &vec->status[i]);
+			&vec->aad[i], dgst, &vec->status[i]);
 		job = submit_sync_job(mb_mgr);
 		j++;
 
@@ -2038,6 +2063,8 @@ aesni_mb_cpu_crypto_process_bulk(struct rte_cryptodev *dev,
 			k = verify_sync_dgst(vec,
 				(const uint8_t (*)[DIGEST_LENGTH_MAX])tmp_dgst,
 				s->auth.req_digest_len);
+		else if (direct_dgst)
+			k = count_sync_status(vec);
 		else
 			k = generate_sync_dgst(vec,
 				(const uint8_t (*)[DIGEST_LENGTH_MAX])tmp_dgst,
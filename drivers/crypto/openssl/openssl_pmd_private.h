@@ -11,6 +11,15 @@
 #include <openssl/rsa.h>
 #include <openssl/dh.h>
 #include <openssl/dsa.h>
+/* the ENGINE API is deprecated from OpenSSL 3.0 */
+#if (OPENSSL_VERSION_NUMBER < 0x30000000L) && !defined(OPENSSL_NO_ENGINE)
+#include <openssl/engine.h>
+#define OPENSSL_PMD_ENGINE
+#endif
+#if (OPENSSL_VERSION_NUMBER >= 0x10100000L)
+#include <openssl/async.h>
+#define OPENSSL_PMD_ASYNC_JOBS
+#endif
 
 #define CRYPTODEV_NAME_OPENSSL_PMD	crypto_openssl
 /**< Open SSL Crypto PMD device name */
@@ -48,11 +57,36 @@ enum openssl_auth_mode {
 	OPENSSL_AUTH_AS_HMAC,
 };
 
+/** Max length of the OpenSSL engine identifier */
+#define OPENSSL_ENGINE_ID_LEN 64
+
 /** private data structure for each OPENSSL crypto device */
 struct openssl_private {
 	unsigned int max_nb_qpairs;
 	/**< Max number of queue pairs */
+	unsigned int async_jobs;
+	/**< Max number of asymmetric operations in flight per queue pair,
+	 * as OpenSSL asynchronous jobs, 0 to process them in the enqueue
+	 */
+#ifdef OPENSSL_PMD_ENGINE
+	ENGINE *engine;
+	/**< Engine of the asymmetric operations, NULL for the default */
+#endif
+};
+
+#ifdef OPENSSL_PMD_ASYNC_JOBS
+/** Operation in flight on a queue pair using asynchronous jobs */
+struct openssl_async_job {
+	struct rte_crypto_op *op;
+	/**< Crypto operation */
+	ASYNC_JOB *job;
+	/**< Paused job of the operation, NULL once it is processed */
+	ASYNC_WAIT_CTX *wait_ctx;
+	/**< Wait context of the job */
+	int ret;
+	/**< Return value of the job */
 };
+#endif
 
 /** OPENSSL crypto queue pair */
 struct openssl_qp {
@@ -73,6 +107,16 @@ struct openssl_qp {
 	 * by the driver when verifying a digest provided
 	 * by the user (using authentication verify operation)
 	 */
+#ifdef OPENSSL_PMD_ASYNC_JOBS
+	struct openssl_async_job *jobs;
+	/**< FIFO of the operations in flight, in enqueue order */
+	uint16_t nb_jobs;
+	/**< Size of the FIFO, 0 when the jobs are not used */
+	uint16_t job_head;
+	/**< Index of the oldest operation in flight */
+	uint16_t job_count;
+	/**< Number of operations in flight */
+#endif
 } __rte_cache_aligned;
 
 /** OPENSSL crypto private session structure */
@@ -9,6 +9,7 @@
 #include <rte_bus_vdev.h>
 #include <rte_malloc.h>
 #include <rte_cpuflags.h>
+#include <rte_kvargs.h>
 
 #include <openssl/hmac.h>
 #include <openssl/evp.h>
@@ -1991,8 +1992,9 @@ process_openssl_rsa_op(struct rte_crypto_op *cop,
 	return 0;
 }
 
+/** Process asymmetric crypto operation, without completing it */
 static int
-process_asym_op(struct openssl_qp *qp, struct rte_crypto_op *op,
+process_asym_xform(struct rte_crypto_op *op,
 		struct openssl_asym_session *sess)
 {
 	int retval = 0;
@@ -2026,14 +2028,146 @@ process_asym_op(struct openssl_qp *qp, struct rte_crypto_op *op,
 		op->status = RTE_CRYPTO_OP_STATUS_INVALID_ARGS;
 		break;
 	}
-	if (!retval) {
-		/* op processed so push to completion queue as processed */
-		retval = rte_ring_enqueue(qp->processed_ops, (void *)op);
-		if (retval)
-			/* return error if failed to put in completion queue */
-			retval = -1;
+
+	return retval;
+}
+
+/** Push processed crypto operation to completion queue */
+static int
+complete_op(struct openssl_qp *qp, struct rte_crypto_op *op)
+{
+#ifdef OPENSSL_PMD_ASYNC_JOBS
+	/* keep enqueue order behind the operations in flight */
+	if (qp->job_count != 0) {
+		struct openssl_async_job *slot = &qp->jobs[
+			(qp->job_head + qp->job_count) % qp->nb_jobs];
+
+		slot->op = op;
+		slot->job = NULL;
+		slot->ret = 0;
+		qp->job_count++;
+		return 0;
+	}
+#endif
+	/* return error if failed to put in completion queue */
+	if (rte_ring_enqueue(qp->processed_ops, (void *)op))
+		return -1;
+
+	return 0;
+}
+
+#ifdef OPENSSL_PMD_ASYNC_JOBS
+/** Arguments of an asynchronous job, copied by OpenSSL */
+struct openssl_async_args {
+	struct rte_crypto_op *op;
+	struct openssl_asym_session *sess;
+};
+
+static int
+openssl_async_asym_job(void *arg)
+{
+	struct openssl_async_args *args = arg;
+
+	return process_asym_xform(args->op, args->sess);
+}
+
+/** Start asymmetric crypto operation as an asynchronous job */
+static int
+process_asym_op_async(struct openssl_qp *qp, struct rte_crypto_op *op,
+		struct openssl_asym_session *sess)
+{
+	struct openssl_async_job *slot = &qp->jobs[
+		(qp->job_head + qp->job_count) % qp->nb_jobs];
+	struct openssl_async_args args = { .op = op, .sess = sess };
+
+	slot->op = op;
+	slot->job = NULL;
+	slot->ret = 0;
+
+	switch (ASYNC_start_job(&slot->job, slot->wait_ctx, &slot->ret,
+			openssl_async_asym_job, &args, sizeof(args))) {
+	case ASYNC_PAUSE:
+		/* the engine resumes the job once the operation is done */
+		break;
+	case ASYNC_FINISH:
+		slot->job = NULL;
+		break;
+	case ASYNC_NO_JOBS:
+		/* job pool exhausted, process in place */
+		slot->job = NULL;
+		slot->ret = process_asym_xform(op, sess);
+		break;
+	default:
+		slot->job = NULL;
+		op->status = RTE_CRYPTO_OP_STATUS_ERROR;
+		break;
+	}
+	qp->job_count++;
+
+	return 0;
+}
+
+/** Resume paused jobs and complete the oldest processed operations */
+static void
+openssl_qp_poll_jobs(struct openssl_qp *qp)
+{
+	struct openssl_async_job *slot;
+	uint16_t i;
+
+	for (i = 0; i < qp->job_count; i++) {
+		slot = &qp->jobs[(qp->job_head + i) % qp->nb_jobs];
+		if (slot->job == NULL)
+			continue;
+
+		switch (ASYNC_start_job(&slot->job, slot->wait_ctx, &slot->ret,
+				openssl_async_asym_job, NULL, 0)) {
+		case ASYNC_PAUSE:
+			break;
+		case ASYNC_FINISH:
+			slot->job = NULL;
+			break;
+		default:
+			slot->job = NULL;
+			slot->op->status = RTE_CRYPTO_OP_STATUS_ERROR;
+			break;
+		}
 	}
 
+	while (qp->job_count != 0) {
+		slot = &qp->jobs[qp->job_head];
+		if (slot->job != NULL)
+			break;
+
+		/* a failed operation is returned, as it was accepted */
+		if (slot->ret != 0 &&
+				slot->op->status ==
+				RTE_CRYPTO_OP_STATUS_NOT_PROCESSED)
+			slot->op->status = RTE_CRYPTO_OP_STATUS_ERROR;
+		if (rte_ring_enqueue(qp->processed_ops, (void *)slot->op))
+			break;
+
+		slot->op = NULL;
+		qp->job_head = (qp->job_head + 1) % qp->nb_jobs;
+		qp->job_count--;
+	}
+}
+#endif
+
+static int
+process_asym_op(struct openssl_qp *qp, struct rte_crypto_op *op,
+		struct openssl_asym_session *sess)
+{
+	int retval;
+
+#ifdef OPENSSL_PMD_ASYNC_JOBS
+	if (qp->nb_jobs != 0)
+		return process_asym_op_async(qp, op, sess);
+#endif
+	retval = process_asym_xform(op, sess);
+	if (!retval)
+		/* op processed so push to completion queue as processed */
+		retval = complete_op(qp, op);
+
 	return retval;
 }
 
@@ -2115,7 +2249,7 @@ process_op(struct openssl_qp *qp, struct rte_crypto_op *op,
 		op->status = RTE_CRYPTO_OP_STATUS_SUCCESS;
 
 	if (op->status != RTE_CRYPTO_OP_STATUS_ERROR)
-		retval = rte_ring_enqueue(qp->processed_ops, (void *)op);
+		retval = complete_op(qp, op);
 	else
 		retval = -1;
 
@@ -2138,6 +2272,14 @@ openssl_pmd_enqueue_burst(void *queue_pair, struct rte_crypto_op **ops,
 	int i, retval;
 
 	for (i = 0; i < nb_ops; i++) {
+#ifdef OPENSSL_PMD_ASYNC_JOBS
+		/* stop on a full queue pair, without error */
+		if (qp->nb_jobs != 0 && qp->job_count == qp->nb_jobs) {
+			openssl_qp_poll_jobs(qp);
+			if (qp->job_count == qp->nb_jobs)
+				break;
+		}
+#endif
 		sess = get_session(qp, ops[i]);
 		if (unlikely(sess == NULL))
 			goto enqueue_err;
@@ -2169,6 +2311,10 @@ openssl_pmd_dequeue_burst(void *queue_pair, struct rte_crypto_op **ops,
 
 	unsigned int nb_dequeued = 0;
 
+#ifdef OPENSSL_PMD_ASYNC_JOBS
+	if (qp->job_count != 0)
+		openssl_qp_poll_jobs(qp);
+#endif
 	nb_dequeued = rte_ring_dequeue_burst(qp->processed_ops,
 			(void **)ops, nb_ops, NULL);
 	qp->stats.dequeued_count += nb_dequeued;
@@ -2176,12 +2322,160 @@ openssl_pmd_dequeue_burst(void *queue_pair, struct rte_crypto_op **ops,
 	return nb_dequeued;
 }
 
+struct openssl_pmd_init_params {
+	struct rte_cryptodev_pmd_init_params def_p;
+	char engine[OPENSSL_ENGINE_ID_LEN];
+	unsigned int async_jobs;
+};
+
+#define OPENSSL_PMD_PARAM_NAME		("name")
+#define OPENSSL_PMD_PARAM_SOCKET_ID	("socket_id")
+#define OPENSSL_PMD_PARAM_MAX_NB_QP	("max_nb_queue_pairs")
+#define OPENSSL_PMD_PARAM_ENGINE	("engine")
+#define OPENSSL_PMD_PARAM_ASYNC_JOBS	("async_jobs")
+
+static const char * const openssl_pmd_valid_params[] = {
+	OPENSSL_PMD_PARAM_NAME,
+	OPENSSL_PMD_PARAM_SOCKET_ID,
+	OPENSSL_PMD_PARAM_MAX_NB_QP,
+	OPENSSL_PMD_PARAM_ENGINE,
+	OPENSSL_PMD_PARAM_ASYNC_JOBS,
+	NULL
+};
+
+/** parse integer from integer argument */
+static int
+parse_integer_arg(const char *key __rte_unused,
+		const char *value, void *extra_args)
+{
+	int *i = extra_args;
+
+	*i = atoi(value);
+	if (*i < 0) {
+		OPENSSL_LOG(ERR, "Argument has to be positive.");
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+/** parse name argument */
+static int
+parse_name_arg(const char *key __rte_unused,
+		const char *value, void *extra_args)
+{
+	struct rte_cryptodev_pmd_init_params *params = extra_args;
+
+	if (strlen(value) >= RTE_CRYPTODEV_NAME_MAX_LEN - 1) {
+		OPENSSL_LOG(ERR, "Invalid name %s, should be less than "
+				"%u bytes.", value,
+				RTE_CRYPTODEV_NAME_MAX_LEN - 1);
+		return -EINVAL;
+	}
+
+	strlcpy(params->name, value, RTE_CRYPTODEV_NAME_MAX_LEN);
+
+	return 0;
+}
+
+/** parse engine identifier argument */
+static int
+parse_engine_arg(const char *key __rte_unused,
+		const char *value, void *extra_args)
+{
+	char *engine = extra_args;
+
+#ifdef OPENSSL_PMD_ENGINE
+	if (strlen(value) >= OPENSSL_ENGINE_ID_LEN) {
+		OPENSSL_LOG(ERR, "Invalid engine %s, should be less than "
+				"%u bytes.", value, OPENSSL_ENGINE_ID_LEN);
+		return -EINVAL;
+	}
+
+	strlcpy(engine, value, OPENSSL_ENGINE_ID_LEN);
+
+	return 0;
+#else
+	RTE_SET_USED(engine);
+	OPENSSL_LOG(ERR, "Invalid engine %s, the OpenSSL engine API is not "
+			"available.", value);
+	return -ENOTSUP;
+#endif
+}
+
+/** parse number of asynchronous jobs argument */
+static int
+parse_async_jobs_arg(const char *key __rte_unused,
+		const char *value, void *extra_args)
+{
+	unsigned int *async_jobs = extra_args;
+	int i = atoi(value);
+
+	if (i < 0 || i > UINT16_MAX) {
+		OPENSSL_LOG(ERR, "Invalid number of async jobs %s, should be "
+				"between 0 and %u.", value, UINT16_MAX);
+		return -EINVAL;
+	}
+#ifndef OPENSSL_PMD_ASYNC_JOBS
+	if (i != 0) {
+		OPENSSL_LOG(ERR, "Async jobs require OpenSSL 1.1.0 or later.");
+		return -ENOTSUP;
+	}
+#endif
+	*async_jobs = i;
+
+	return 0;
+}
+
+static int
+openssl_pmd_parse_input_args(struct openssl_pmd_init_params *params,
+		const char *input_args)
+{
+	struct rte_kvargs *kvlist;
+	int ret;
+
+	if (input_args == NULL)
+		return 0;
+
+	kvlist = rte_kvargs_parse(input_args, openssl_pmd_valid_params);
+	if (kvlist == NULL)
+		return -EINVAL;
+
+	ret = rte_kvargs_process(kvlist, OPENSSL_PMD_PARAM_MAX_NB_QP,
+			&parse_integer_arg, &params->def_p.max_nb_queue_pairs);
+	if (ret < 0)
+		goto free_kvlist;
+
+	ret = rte_kvargs_process(kvlist, OPENSSL_PMD_PARAM_SOCKET_ID,
+			&parse_integer_arg, &params->def_p.socket_id);
+	if (ret < 0)
+		goto free_kvlist;
+
+	ret = rte_kvargs_process(kvlist, OPENSSL_PMD_PARAM_NAME,
+			&parse_name_arg, &params->def_p);
+	if (ret < 0)
+		goto free_kvlist;
+
+	ret = rte_kvargs_process(kvlist, OPENSSL_PMD_PARAM_ENGINE,
+			&parse_engine_arg, params->engine);
+	if (ret < 0)
+		goto free_kvlist;
+
+	ret = rte_kvargs_process(kvlist, OPENSSL_PMD_PARAM_ASYNC_JOBS,
+			&parse_async_jobs_arg, &params->async_jobs);
+
+free_kvlist:
+	rte_kvargs_free(kvlist);
+	return ret;
+}
+
 /** Create OPENSSL crypto device */
 static int
 cryptodev_openssl_create(const char *name,
 			struct rte_vdev_device *vdev,
-			struct rte_cryptodev_pmd_init_params *init_params)
+			struct openssl_pmd_init_params *params)
 {
+	struct rte_cryptodev_pmd_init_params *init_params = &params->def_p;
 	struct rte_cryptodev *dev;
 	struct openssl_private *internals;
 
@@ -2212,6 +2506,28 @@ cryptodev_openssl_create(const char *name,
 	internals = dev->data->dev_private;
 
 	internals->max_nb_qpairs = init_params->max_nb_queue_pairs;
+	internals->async_jobs = params->async_jobs;
+
+#ifdef OPENSSL_PMD_ENGINE
+	if (params->engine[0] != '\0') {
+		ENGINE_load_builtin_engines();
+		internals->engine = ENGINE_by_id(params->engine);
+		if (internals->engine == NULL) {
+			OPENSSL_LOG(ERR, "failed to load engine %s",
+					params->engine);
+			goto init_error;
+		}
+		if (!ENGINE_init(internals->engine)) {
+			OPENSSL_LOG(ERR, "failed to init engine %s",
+					params->engine);
+			ENGINE_free(internals->engine);
+			internals->engine = NULL;
+			goto init_error;
+		}
+		OPENSSL_LOG(INFO, "using engine %s for asymmetric operations",
+				params->engine);
+	}
+#endif
 
 	return 0;
 
@@ -2227,21 +2543,31 @@ cryptodev_openssl_create(const char *name,
 static int
 cryptodev_openssl_probe(struct rte_vdev_device *vdev)
 {
-	struct rte_cryptodev_pmd_init_params init_params = {
-		"",
-		sizeof(struct openssl_private),
-		rte_socket_id(),
-		RTE_CRYPTODEV_PMD_DEFAULT_MAX_NB_QUEUE_PAIRS
+	struct openssl_pmd_init_params init_params = {
+		.def_p = {
+			"",
+			sizeof(struct openssl_private),
+			rte_socket_id(),
+			RTE_CRYPTODEV_PMD_DEFAULT_MAX_NB_QUEUE_PAIRS
+		},
+		.engine = "",
+		.async_jobs = 0,
 	};
 	const char *name;
 	const char *input_args;
+	int ret;
 
 	name = rte_vdev_device_name(vdev);
 	if (name == NULL)
 		return -EINVAL;
 	input_args = rte_vdev_device_args(vdev);
 
-	rte_cryptodev_pmd_parse_input_args(&init_params, input_args);
+	ret = openssl_pmd_parse_input_args(&init_params, input_args);
+	if (ret < 0) {
+		OPENSSL_LOG(ERR, "Failed to parse initialisation arguments[%s]",
+				input_args);
+		return ret;
+	}
 
 	return cryptodev_openssl_create(name, vdev, &init_params);
 }
@@ -2261,6 +2587,19 @@ cryptodev_openssl_remove(struct rte_vdev_device *vdev)
 	if (cryptodev == NULL)
 		return -ENODEV;
 
+#ifdef OPENSSL_PMD_ENGINE
+	if (rte_eal_process_type() == RTE_PROC_PRIMARY) {
+		struct openssl_private *internals =
+				cryptodev->data->dev_private;
+
+		if (internals->engine != NULL) {
+			ENGINE_finish(internals->engine);
+			ENGINE_free(internals->engine);
+			internals->engine = NULL;
+		}
+	}
+#endif
+
 	return rte_cryptodev_pmd_destroy(cryptodev);
 }
 
@@ -2275,7 +2614,9 @@ RTE_PMD_REGISTER_VDEV(CRYPTODEV_NAME_OPENSSL_PMD,
 	cryptodev_openssl_pmd_drv);
 RTE_PMD_REGISTER_PARAM_STRING(CRYPTODEV_NAME_OPENSSL_PMD,
 	"max_nb_queue_pairs=<int> "
-	"socket_id=<int>");
+	"socket_id=<int> "
+	"engine=<string> "
+	"async_jobs=<int>");
 RTE_PMD_REGISTER_CRYPTO_DRIVER(openssl_crypto_drv,
 		cryptodev_openssl_pmd_drv.driver, cryptodev_driver_id);
 RTE_LOG_REGISTER_DEFAULT(openssl_logtype_driver, INFO);
@@ -652,6 +652,60 @@ openssl_pmd_info_get(struct rte_cryptodev *dev,
 	}
 }
 
+#ifdef OPENSSL_PMD_ASYNC_JOBS
+/** Free the asynchronous jobs of a queue pair, once done */
+static void
+openssl_pmd_qp_free_jobs(struct openssl_qp *qp)
+{
+	struct openssl_async_job *slot;
+	uint16_t i;
+	int ret;
+
+	for (i = 0; i < qp->nb_jobs; i++) {
+		slot = &qp->jobs[i];
+		/* the engine still owns the paused operations */
+		while (slot->job != NULL) {
+			ret = ASYNC_start_job(&slot->job, slot->wait_ctx,
+					&slot->ret, NULL, NULL, 0);
+			if (ret != ASYNC_PAUSE)
+				slot->job = NULL;
+		}
+		if (slot->wait_ctx != NULL)
+			ASYNC_WAIT_CTX_free(slot->wait_ctx);
+	}
+
+	rte_free(qp->jobs);
+	qp->jobs = NULL;
+	qp->nb_jobs = 0;
+	qp->job_count = 0;
+}
+
+/** Allocate the asynchronous jobs of a queue pair */
+static int
+openssl_pmd_qp_alloc_jobs(struct openssl_qp *qp, unsigned int nb_jobs,
+		int socket_id)
+{
+	uint16_t i;
+
+	qp->jobs = rte_zmalloc_socket("OPENSSL PMD async jobs",
+			sizeof(*qp->jobs) * nb_jobs, RTE_CACHE_LINE_SIZE,
+			socket_id);
+	if (qp->jobs == NULL)
+		return -ENOMEM;
+	qp->nb_jobs = nb_jobs;
+
+	for (i = 0; i < qp->nb_jobs; i++) {
+		qp->jobs[i].wait_ctx = ASYNC_WAIT_CTX_new();
+		if (qp->jobs[i].wait_ctx == NULL) {
+			openssl_pmd_qp_free_jobs(qp);
+			return -ENOMEM;
+		}
+	}
+
+	return 0;
+}
+#endif
+
 /** Release queue pair */
 static int
 openssl_pmd_qp_release(struct rte_cryptodev *dev, uint16_t qp_id)
@@ -659,6 +713,10 @@ openssl_pmd_qp_release(struct rte_cryptodev *dev, uint16_t qp_id)
 	if (dev->data->queue_pairs[qp_id] != NULL) {
 		struct openssl_qp *qp = dev->data->queue_pairs[qp_id];
 
+#ifdef OPENSSL_PMD_ASYNC_JOBS
+		if (qp->jobs)
+			openssl_pmd_qp_free_jobs(qp);
+#endif
 		if (qp->processed_ops)
 			rte_ring_free(qp->processed_ops);
 
@@ -717,6 +775,7 @@ openssl_pmd_qp_setup(struct rte_cryptodev *dev, uint16_t qp_id,
 		const struct rte_cryptodev_qp_conf *qp_conf,
 		int socket_id)
 {
+	struct openssl_private *internals = dev->data->dev_private;
 	struct openssl_qp *qp = NULL;
 
 	/* Free memory prior to re-allocation if needed. */
@@ -743,13 +802,28 @@ openssl_pmd_qp_setup(struct rte_cryptodev *dev, uint16_t qp_id,
 	qp->sess_mp = qp_conf->mp_session;
 	qp->sess_mp_priv = qp_conf->mp_session_private;
 
+#ifdef OPENSSL_PMD_ASYNC_JOBS
+	if (internals->async_jobs != 0 &&
+			openssl_pmd_qp_alloc_jobs(qp, internals->async_jobs,
+				socket_id) != 0) {
+		OPENSSL_LOG(ERR, "failed to allocate async jobs");
+		goto qp_setup_cleanup;
+	}
+#else
+	RTE_SET_USED(internals);
+#endif
+
 	memset(&qp->stats, 0, sizeof(qp->stats));
 
 	return 0;
 
 qp_setup_cleanup:
-	if (qp)
+	if (qp) {
+		if (qp->processed_ops)
+			rte_ring_free(qp->processed_ops);
 		rte_free(qp);
+	}
+	dev->data->queue_pairs[qp_id] = NULL;
 
 	return -1;
 }
@@ -804,7 +878,17 @@ openssl_pmd_sym_session_configure(struct rte_cryptodev *dev __rte_unused,
 	return 0;
 }
 
+/* Allocate an asymmetric key of the device engine */
+#ifdef OPENSSL_PMD_ENGINE
+#define OPENSSL_ASYM_KEY_NEW(type, internals) \
+	type##_new_method((internals)->engine)
+#else
+#define OPENSSL_ASYM_KEY_NEW(type, internals) \
+	type##_new()
+#endif
+
 static int openssl_set_asym_session_parameters(
+		struct openssl_private *internals,
 		struct openssl_asym_session *asym_session,
 		struct rte_crypto_asym_xform *xform)
 {
@@ -835,7 +919,7 @@ static int openssl_set_asym_session_parameters(
 		if (!n || !e)
 			goto err_rsa;
 
-		RSA *rsa = RSA_new();
+		RSA *rsa = OPENSSL_ASYM_KEY_NEW(RSA, internals);
 		if (rsa == NULL)
 			goto err_rsa;
 
@@ -990,7 +1074,7 @@ static int openssl_set_asym_session_parameters(
 		if (!p || !g)
 			goto err_dh;
 
-		DH *dh = DH_new();
+		DH *dh = OPENSSL_ASYM_KEY_NEW(DH, internals);
 		if (dh == NULL) {
 			OPENSSL_LOG(ERR,
 				"failed to allocate resources\n");
@@ -1069,7 +1153,7 @@ static int openssl_set_asym_session_parameters(
 		if (priv_key == NULL)
 			goto err_dsa;
 
-		DSA *dsa = DSA_new();
+		DSA *dsa = OPENSSL_ASYM_KEY_NEW(DSA, internals);
 		if (dsa == NULL) {
 			OPENSSL_LOG(ERR,
 				" failed to allocate resources\n");
@@ -1117,7 +1201,7 @@ static int openssl_set_asym_session_parameters(
 
 /** Configure the session from a crypto xform chain */
 static int
-openssl_pmd_asym_session_configure(struct rte_cryptodev *dev __rte_unused,
+openssl_pmd_asym_session_configure(struct rte_cryptodev *dev,
 		struct rte_crypto_asym_xform *xform,
 		struct rte_cryptodev_asym_session *sess,
 		struct rte_mempool *mempool)
@@ -1136,8 +1220,8 @@ openssl_pmd_asym_session_configure(struct rte_cryptodev *dev __rte_unused,
 		return -ENOMEM;
 	}
 
-	ret = openssl_set_asym_session_parameters(asym_sess_private_data,
-			xform);
+	ret = openssl_set_asym_session_parameters(dev->data->dev_private,
+			asym_sess_private_data, xform);
 	if (ret != 0) {
 		OPENSSL_LOG(ERR, "failed configure session parameters");
 
@@ -123,6 +123,8 @@ static void
 update_scheduler_feature_flag(struct rte_cryptodev *dev)
 {
 	struct scheduler_ctx *sched_ctx = dev->data->dev_private;
+	/* features the scheduler only has when all the workers have them */
+	uint64_t all_workers_flags = RTE_CRYPTODEV_FF_SYM_RAW_DP;
 	uint32_t i;
 
 	dev->feature_flags = 0;
@@ -133,7 +135,12 @@ update_scheduler_feature_flag(struct rte_cryptodev *dev)
 		rte_cryptodev_info_get(sched_ctx->workers[i].dev_id, &dev_info);
 
 		dev->feature_flags |= dev_info.feature_flags;
+		all_workers_flags &= dev_info.feature_flags;
 	}
+
+	dev->feature_flags &= ~RTE_CRYPTODEV_FF_SYM_RAW_DP;
+	if (sched_ctx->nb_workers)
+		dev->feature_flags |= all_workers_flags;
 }
 
 static void
@@ -333,6 +340,13 @@ rte_cryptodev_scheduler_mode_set(uint8_t scheduler_id,
 			return -1;
 		}
 		break;
+	case CDEV_SCHED_MODE_LEAST_LOADED:
+		if (rte_cryptodev_scheduler_load_user_scheduler(scheduler_id,
+				crypto_scheduler_least_loaded) < 0) {
+			CR_SCHED_LOG(ERR, "Failed to load scheduler");
+			return -1;
+		}
+		break;
 	default:
 		CR_SCHED_LOG(ERR, "Not yet supported");
 		return -ENOTSUP;
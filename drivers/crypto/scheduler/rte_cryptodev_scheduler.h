@@ -13,8 +13,9 @@
  * The RTE Cryptodev Scheduler Device allows the aggregation of multiple worker
  * Cryptodevs into a single logical crypto device, and the scheduling the
  * crypto operations to the workers based on the mode of the specified mode of
- * operation specified and supported. This implementation supports 3 modes of
- * operation: round robin, packet-size based, and fail-over.
+ * operation specified and supported. This implementation supports 5 modes of
+ * operation: round robin, packet-size based, fail-over, multi-core and
+ * least-loaded.
  */
 
 #include <stdint.h>
@@ -40,6 +41,8 @@ extern "C" {
 #define SCHEDULER_MODE_NAME_FAIL_OVER		fail-over
 /** multi-core scheduling mode string */
 #define SCHEDULER_MODE_NAME_MULTI_CORE		multi-core
+/** Least-loaded scheduling mode string */
+#define SCHEDULER_MODE_NAME_LEAST_LOADED	least-loaded
 
 /**
  * Crypto scheduler PMD operation modes
@@ -56,6 +59,8 @@ enum rte_cryptodev_scheduler_mode {
 	CDEV_SCHED_MODE_FAILOVER,
 	/** multi-core mode */
 	CDEV_SCHED_MODE_MULTICORE,
+	/** Least-loaded mode */
+	CDEV_SCHED_MODE_LEAST_LOADED,
 
 	CDEV_SCHED_MODE_COUNT /**< number of modes */
 };
@@ -276,6 +281,8 @@ extern struct rte_cryptodev_scheduler *crypto_scheduler_pkt_size_based_distr;
 extern struct rte_cryptodev_scheduler *crypto_scheduler_failover;
 /** multi-core mode scheduler */
 extern struct rte_cryptodev_scheduler *crypto_scheduler_multicore;
+/** Least-loaded mode scheduler */
+extern struct rte_cryptodev_scheduler *crypto_scheduler_least_loaded;
 
 #ifdef __cplusplus
 }
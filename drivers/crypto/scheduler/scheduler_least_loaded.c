@@ -0,0 +1,240 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <rte_cryptodev.h>
+#include <rte_malloc.h>
+
+#include "rte_cryptodev_scheduler_operations.h"
+#include "scheduler_pmd_private.h"
+
+struct ll_scheduler_qp_ctx {
+	struct scheduler_worker workers[RTE_CRYPTODEV_SCHEDULER_MAX_NB_WORKERS];
+	uint32_t nb_workers;
+
+	uint32_t last_enq_worker_idx;
+	uint32_t last_deq_worker_idx;
+};
+
+/* Worker with the fewest inflight operations, the ties being served in
+ * turn so that idle workers share the load evenly.
+ */
+static __rte_always_inline uint32_t
+ll_least_loaded_worker(struct ll_scheduler_qp_ctx *ll_qp_ctx)
+{
+	uint32_t worker_idx = ll_qp_ctx->last_enq_worker_idx;
+	uint32_t min_idx = worker_idx;
+	uint32_t min_inflight = UINT32_MAX;
+	uint32_t i;
+
+	for (i = 0; i < ll_qp_ctx->nb_workers; i++) {
+		worker_idx += 1;
+		if (worker_idx >= ll_qp_ctx->nb_workers)
+			worker_idx = 0;
+
+		if (ll_qp_ctx->workers[worker_idx].nb_inflight_cops <
+				min_inflight) {
+			min_inflight =
+				ll_qp_ctx->workers[worker_idx].nb_inflight_cops;
+			min_idx = worker_idx;
+			if (min_inflight == 0)
+				break;
+		}
+	}
+
+	return min_idx;
+}
+
+static uint16_t
+schedule_enqueue(void *qp, struct rte_crypto_op **ops, uint16_t nb_ops)
+{
+	struct ll_scheduler_qp_ctx *ll_qp_ctx =
+			((struct scheduler_qp_ctx *)qp)->private_qp_ctx;
+	struct scheduler_worker *worker;
+	uint32_t worker_idx;
+	uint16_t i, processed_ops;
+
+	if (unlikely(nb_ops == 0))
+		return 0;
+
+	for (i = 0; i < nb_ops && i < 4; i++)
+		rte_prefetch0(ops[i]->sym->session);
+
+	worker_idx = ll_least_loaded_worker(ll_qp_ctx);
+	worker = &ll_qp_ctx->workers[worker_idx];
+
+	processed_ops = rte_cryptodev_enqueue_burst(worker->dev_id,
+			worker->qp_id, ops, nb_ops);
+
+	worker->nb_inflight_cops += processed_ops;
+
+	ll_qp_ctx->last_enq_worker_idx = worker_idx;
+
+	return processed_ops;
+}
+
+static uint16_t
+schedule_enqueue_ordering(void *qp, struct rte_crypto_op **ops,
+		uint16_t nb_ops)
+{
+	struct rte_ring *order_ring =
+			((struct scheduler_qp_ctx *)qp)->order_ring;
+	uint16_t nb_ops_to_enq = get_max_enqueue_order_count(order_ring,
+			nb_ops);
+	uint16_t nb_ops_enqd = schedule_enqueue(qp, ops,
+			nb_ops_to_enq);
+
+	scheduler_order_insert(order_ring, ops, nb_ops_enqd);
+
+	return nb_ops_enqd;
+}
+
+static uint16_t
+schedule_dequeue(void *qp, struct rte_crypto_op **ops, uint16_t nb_ops)
+{
+	struct ll_scheduler_qp_ctx *ll_qp_ctx =
+			((struct scheduler_qp_ctx *)qp)->private_qp_ctx;
+	uint32_t worker_idx = ll_qp_ctx->last_deq_worker_idx;
+	uint16_t nb_deq_ops = 0;
+	uint32_t i;
+
+	/* Drain the workers in turn, so that none of them fills up */
+	for (i = 0; i < ll_qp_ctx->nb_workers && nb_deq_ops < nb_ops; i++) {
+		struct scheduler_worker *worker =
+				&ll_qp_ctx->workers[worker_idx];
+		uint16_t nb;
+
+		worker_idx += 1;
+		if (worker_idx >= ll_qp_ctx->nb_workers)
+			worker_idx = 0;
+
+		if (worker->nb_inflight_cops == 0)
+			continue;
+
+		nb = rte_cryptodev_dequeue_burst(worker->dev_id,
+				worker->qp_id, ops + nb_deq_ops,
+				nb_ops - nb_deq_ops);
+		worker->nb_inflight_cops -= nb;
+		nb_deq_ops += nb;
+	}
+
+	ll_qp_ctx->last_deq_worker_idx = worker_idx;
+
+	return nb_deq_ops;
+}
+
+static uint16_t
+schedule_dequeue_ordering(void *qp, struct rte_crypto_op **ops,
+		uint16_t nb_ops)
+{
+	struct rte_ring *order_ring =
+			((struct scheduler_qp_ctx *)qp)->order_ring;
+
+	schedule_dequeue(qp, ops, nb_ops);
+
+	return scheduler_order_drain(order_ring, ops, nb_ops);
+}
+
+static int
+worker_attach(__rte_unused struct rte_cryptodev *dev,
+		__rte_unused uint8_t worker_id)
+{
+	return 0;
+}
+
+static int
+worker_detach(__rte_unused struct rte_cryptodev *dev,
+		__rte_unused uint8_t worker_id)
+{
+	return 0;
+}
+
+static int
+scheduler_start(struct rte_cryptodev *dev)
+{
+	struct scheduler_ctx *sched_ctx = dev->data->dev_private;
+	uint16_t i;
+
+	if (sched_ctx->reordering_enabled) {
+		dev->enqueue_burst = &schedule_enqueue_ordering;
+		dev->dequeue_burst = &schedule_dequeue_ordering;
+	} else {
+		dev->enqueue_burst = &schedule_enqueue;
+		dev->dequeue_burst = &schedule_dequeue;
+	}
+
+	for (i = 0; i < dev->data->nb_queue_pairs; i++) {
+		struct scheduler_qp_ctx *qp_ctx = dev->data->queue_pairs[i];
+		struct ll_scheduler_qp_ctx *ll_qp_ctx =
+				qp_ctx->private_qp_ctx;
+		uint32_t j;
+
+		memset(ll_qp_ctx->workers, 0,
+				RTE_CRYPTODEV_SCHEDULER_MAX_NB_WORKERS *
+				sizeof(struct scheduler_worker));
+		for (j = 0; j < sched_ctx->nb_workers; j++) {
+			ll_qp_ctx->workers[j].dev_id =
+					sched_ctx->workers[j].dev_id;
+			ll_qp_ctx->workers[j].qp_id = i;
+		}
+
+		ll_qp_ctx->nb_workers = sched_ctx->nb_workers;
+
+		ll_qp_ctx->last_enq_worker_idx = 0;
+		ll_qp_ctx->last_deq_worker_idx = 0;
+	}
+
+	return 0;
+}
+
+static int
+scheduler_stop(__rte_unused struct rte_cryptodev *dev)
+{
+	return 0;
+}
+
+static int
+scheduler_config_qp(struct rte_cryptodev *dev, uint16_t qp_id)
+{
+	struct scheduler_qp_ctx *qp_ctx = dev->data->queue_pairs[qp_id];
+	struct ll_scheduler_qp_ctx *ll_qp_ctx;
+
+	ll_qp_ctx = rte_zmalloc_socket(NULL, sizeof(*ll_qp_ctx), 0,
+			rte_socket_id());
+	if (!ll_qp_ctx) {
+		CR_SCHED_LOG(ERR, "failed allocate memory for private queue pair");
+		return -ENOMEM;
+	}
+
+	qp_ctx->private_qp_ctx = (void *)ll_qp_ctx;
+
+	return 0;
+}
+
+static int
+scheduler_create_private_ctx(__rte_unused struct rte_cryptodev *dev)
+{
+	return 0;
+}
+
+static struct rte_cryptodev_scheduler_ops scheduler_ll_ops = {
+	worker_attach,
+	worker_detach,
+	scheduler_start,
+	scheduler_stop,
+	scheduler_config_qp,
+	scheduler_create_private_ctx,
+	NULL,	/* option_set */
+	NULL	/* option_get */
+};
+
+static struct rte_cryptodev_scheduler scheduler = {
+		.name = "least-loaded-scheduler",
+		.description = "scheduler which will enqueue each burst to the "
+				"worker crypto device with the fewest inflight "
+				"operations",
+		.mode = CDEV_SCHED_MODE_LEAST_LOADED,
+		.ops = &scheduler_ll_ops
+};
+
+struct rte_cryptodev_scheduler *crypto_scheduler_least_loaded = &scheduler;
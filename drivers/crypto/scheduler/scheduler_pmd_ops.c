@@ -514,6 +514,299 @@ scheduler_pmd_sym_session_clear(struct rte_cryptodev *dev,
 	}
 }
 
+/** Raw data-path context of the scheduler: each worker gets its own raw
+ * data-path context, carved out of the one of the scheduler.
+ */
+struct scheduler_raw_dp_ctx {
+	struct rte_crypto_raw_dp_ctx *worker_ctx[
+			RTE_CRYPTODEV_SCHEDULER_MAX_NB_WORKERS];
+	uint32_t nb_inflight[RTE_CRYPTODEV_SCHEDULER_MAX_NB_WORKERS];
+	uint32_t nb_workers;
+
+	uint32_t last_enq_worker_idx;
+	uint32_t last_deq_worker_idx;
+
+	uint8_t worker_ctx_data[] __rte_aligned(8);
+};
+
+/* Worker with the fewest inflight operations, the ties being served in turn */
+static __rte_always_inline uint32_t
+scheduler_raw_dp_worker_get(struct scheduler_raw_dp_ctx *raw_ctx)
+{
+	uint32_t worker_idx = raw_ctx->last_enq_worker_idx;
+	uint32_t min_idx = worker_idx;
+	uint32_t min_inflight = UINT32_MAX;
+	uint32_t i;
+
+	for (i = 0; i < raw_ctx->nb_workers; i++) {
+		worker_idx += 1;
+		if (worker_idx >= raw_ctx->nb_workers)
+			worker_idx = 0;
+
+		if (raw_ctx->nb_inflight[worker_idx] < min_inflight) {
+			min_inflight = raw_ctx->nb_inflight[worker_idx];
+			min_idx = worker_idx;
+			if (min_inflight == 0)
+				break;
+		}
+	}
+
+	raw_ctx->last_enq_worker_idx = min_idx;
+
+	return min_idx;
+}
+
+/*
+ * The operations of a call all go to the same worker, which is kicked before
+ * returning: the scheduler never caches operations, so that every enqueue and
+ * dequeue status it reports is 1.
+ */
+static uint32_t
+scheduler_raw_dp_enqueue_burst(__rte_unused void *qp, uint8_t *drv_ctx,
+	struct rte_crypto_sym_vec *vec, union rte_crypto_sym_ofs ofs,
+	void *user_data[], int *enqueue_status)
+{
+	struct scheduler_raw_dp_ctx *raw_ctx = (void *)drv_ctx;
+	uint32_t worker_idx = scheduler_raw_dp_worker_get(raw_ctx);
+	struct rte_crypto_raw_dp_ctx *ctx = raw_ctx->worker_ctx[worker_idx];
+	uint32_t n;
+	int ret;
+
+	n = (*ctx->enqueue_burst)(ctx->qp_data, ctx->drv_ctx_data, vec, ofs,
+			user_data, enqueue_status);
+	if (*enqueue_status < 0)
+		return n;
+
+	if (*enqueue_status == 0 && n != 0) {
+		ret = (*ctx->enqueue_done)(ctx->qp_data, ctx->drv_ctx_data, n);
+		if (ret < 0) {
+			*enqueue_status = ret;
+			return 0;
+		}
+	}
+
+	raw_ctx->nb_inflight[worker_idx] += n;
+	*enqueue_status = 1;
+
+	return n;
+}
+
+static int
+scheduler_raw_dp_enqueue(__rte_unused void *qp, uint8_t *drv_ctx,
+	struct rte_crypto_vec *data_vec, uint16_t n_data_vecs,
+	union rte_crypto_sym_ofs ofs, struct rte_crypto_va_iova_ptr *iv,
+	struct rte_crypto_va_iova_ptr *digest,
+	struct rte_crypto_va_iova_ptr *aad_or_auth_iv, void *user_data)
+{
+	struct scheduler_raw_dp_ctx *raw_ctx = (void *)drv_ctx;
+	uint32_t worker_idx = scheduler_raw_dp_worker_get(raw_ctx);
+	struct rte_crypto_raw_dp_ctx *ctx = raw_ctx->worker_ctx[worker_idx];
+	int ret;
+
+	ret = (*ctx->enqueue)(ctx->qp_data, ctx->drv_ctx_data, data_vec,
+			n_data_vecs, ofs, iv, digest, aad_or_auth_iv,
+			user_data);
+	if (ret < 0)
+		return ret;
+
+	if (ret == 0) {
+		ret = (*ctx->enqueue_done)(ctx->qp_data, ctx->drv_ctx_data, 1);
+		if (ret < 0)
+			return ret;
+	}
+
+	raw_ctx->nb_inflight[worker_idx]++;
+
+	return 1;
+}
+
+static uint32_t
+scheduler_raw_dp_dequeue_burst(__rte_unused void *qp, uint8_t *drv_ctx,
+	rte_cryptodev_raw_get_dequeue_count_t get_dequeue_count,
+	uint32_t max_nb_to_dequeue,
+	rte_cryptodev_raw_post_dequeue_t post_dequeue,
+	void **out_user_data, uint8_t is_user_data_array,
+	uint32_t *n_success, int *dequeue_status)
+{
+	struct scheduler_raw_dp_ctx *raw_ctx = (void *)drv_ctx;
+	uint32_t worker_idx = raw_ctx->last_deq_worker_idx;
+	uint32_t i;
+
+	*n_success = 0;
+	*dequeue_status = 1;
+
+	for (i = 0; i < raw_ctx->nb_workers; i++) {
+		struct rte_crypto_raw_dp_ctx *ctx;
+		uint32_t n;
+		int ret;
+
+		if (++worker_idx >= raw_ctx->nb_workers)
+			worker_idx = 0;
+
+		if (raw_ctx->nb_inflight[worker_idx] == 0)
+			continue;
+
+		ctx = raw_ctx->worker_ctx[worker_idx];
+		n = (*ctx->dequeue_burst)(ctx->qp_data, ctx->drv_ctx_data,
+				get_dequeue_count, max_nb_to_dequeue,
+				post_dequeue, out_user_data,
+				is_user_data_array, n_success,
+				dequeue_status);
+		if (*dequeue_status < 0)
+			return n;
+		if (n == 0)
+			continue;
+
+		if (*dequeue_status == 0) {
+			ret = (*ctx->dequeue_done)(ctx->qp_data,
+					ctx->drv_ctx_data, n);
+			if (ret < 0) {
+				*dequeue_status = ret;
+				return 0;
+			}
+		}
+
+		raw_ctx->nb_inflight[worker_idx] -= n;
+		raw_ctx->last_deq_worker_idx = worker_idx;
+		*dequeue_status = 1;
+
+		return n;
+	}
+
+	return 0;
+}
+
+static void *
+scheduler_raw_dp_dequeue(__rte_unused void *qp, uint8_t *drv_ctx,
+	int *dequeue_status, enum rte_crypto_op_status *op_status)
+{
+	struct scheduler_raw_dp_ctx *raw_ctx = (void *)drv_ctx;
+	uint32_t worker_idx = raw_ctx->last_deq_worker_idx;
+	uint32_t i;
+
+	*dequeue_status = 1;
+
+	for (i = 0; i < raw_ctx->nb_workers; i++) {
+		struct rte_crypto_raw_dp_ctx *ctx;
+		void *user_data;
+		int ret;
+
+		if (++worker_idx >= raw_ctx->nb_workers)
+			worker_idx = 0;
+
+		if (raw_ctx->nb_inflight[worker_idx] == 0)
+			continue;
+
+		ctx = raw_ctx->worker_ctx[worker_idx];
+		user_data = (*ctx->dequeue)(ctx->qp_data, ctx->drv_ctx_data,
+				dequeue_status, op_status);
+		if (*dequeue_status < 0)
+			return NULL;
+		if (user_data == NULL)
+			continue;
+
+		if (*dequeue_status == 0) {
+			ret = (*ctx->dequeue_done)(ctx->qp_data,
+					ctx->drv_ctx_data, 1);
+			if (ret < 0) {
+				*dequeue_status = ret;
+				return NULL;
+			}
+		}
+
+		raw_ctx->nb_inflight[worker_idx]--;
+		raw_ctx->last_deq_worker_idx = worker_idx;
+		*dequeue_status = 1;
+
+		return user_data;
+	}
+
+	return NULL;
+}
+
+static int
+scheduler_raw_dp_op_done(__rte_unused void *qp, __rte_unused uint8_t *drv_ctx,
+	__rte_unused uint32_t n)
+{
+	/* The workers are kicked on each enqueue and dequeue already */
+	return 0;
+}
+
+static int
+scheduler_pmd_sym_get_raw_dp_ctx_size(struct rte_cryptodev *dev)
+{
+	struct scheduler_ctx *sched_ctx = dev->data->dev_private;
+	int size = sizeof(struct scheduler_raw_dp_ctx);
+	uint32_t i;
+
+	for (i = 0; i < sched_ctx->nb_workers; i++) {
+		int worker_size = rte_cryptodev_get_raw_dp_ctx_size(
+				sched_ctx->workers[i].dev_id);
+
+		if (worker_size < 0)
+			return -ENOTSUP;
+
+		size += worker_size;
+	}
+
+	return size;
+}
+
+static int
+scheduler_pmd_sym_configure_raw_dp_ctx(struct rte_cryptodev *dev,
+	uint16_t qp_id, struct rte_crypto_raw_dp_ctx *raw_dp_ctx,
+	enum rte_crypto_op_sess_type sess_type,
+	union rte_cryptodev_session_ctx session_ctx, uint8_t is_update)
+{
+	struct scheduler_ctx *sched_ctx = dev->data->dev_private;
+	struct scheduler_raw_dp_ctx *raw_ctx =
+			(void *)raw_dp_ctx->drv_ctx_data;
+	uint32_t i;
+	int ret;
+
+	if (!is_update) {
+		uint8_t *worker_ctx_data = raw_ctx->worker_ctx_data;
+
+		memset(raw_ctx, 0, sizeof(*raw_ctx));
+		raw_ctx->nb_workers = sched_ctx->nb_workers;
+
+		for (i = 0; i < sched_ctx->nb_workers; i++) {
+			int worker_size = rte_cryptodev_get_raw_dp_ctx_size(
+					sched_ctx->workers[i].dev_id);
+
+			if (worker_size < 0)
+				return -ENOTSUP;
+
+			raw_ctx->worker_ctx[i] =
+				(struct rte_crypto_raw_dp_ctx *)worker_ctx_data;
+			worker_ctx_data += worker_size;
+		}
+
+		raw_dp_ctx->qp_data = dev->data->queue_pairs[qp_id];
+		raw_dp_ctx->enqueue = scheduler_raw_dp_enqueue;
+		raw_dp_ctx->enqueue_burst = scheduler_raw_dp_enqueue_burst;
+		raw_dp_ctx->enqueue_done = scheduler_raw_dp_op_done;
+		raw_dp_ctx->dequeue = scheduler_raw_dp_dequeue;
+		raw_dp_ctx->dequeue_burst = scheduler_raw_dp_dequeue_burst;
+		raw_dp_ctx->dequeue_done = scheduler_raw_dp_op_done;
+	}
+
+	/* the sessions are initialized on all the workers */
+	for (i = 0; i < raw_ctx->nb_workers; i++) {
+		ret = rte_cryptodev_configure_raw_dp_ctx(
+				sched_ctx->workers[i].dev_id, qp_id,
+				raw_ctx->worker_ctx[i], sess_type,
+				session_ctx, is_update);
+		if (ret < 0) {
+			CR_SCHED_LOG(ERR, "unable to config raw dp ctx of "
+					"worker %u", sched_ctx->workers[i].dev_id);
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
 static struct rte_cryptodev_ops scheduler_pmd_ops = {
 		.dev_configure		= scheduler_pmd_config,
 		.dev_start		= scheduler_pmd_start,
@@ -531,6 +824,9 @@ static struct rte_cryptodev_ops scheduler_pmd_ops = {
 		.sym_session_get_size	= scheduler_pmd_sym_session_get_size,
 		.sym_session_configure	= scheduler_pmd_sym_session_configure,
 		.sym_session_clear	= scheduler_pmd_sym_session_clear,
+
+		.sym_get_raw_dp_ctx_size = scheduler_pmd_sym_get_raw_dp_ctx_size,
+		.sym_configure_raw_dp_ctx = scheduler_pmd_sym_configure_raw_dp_ctx,
 };
 
 struct rte_cryptodev_ops *rte_crypto_scheduler_pmd_ops = &scheduler_pmd_ops;
@@ -0,0 +1,411 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 HiSilicon Limited
+ */
+
+#include <inttypes.h>
+#include <string.h>
+
+#include <rte_bus_vdev.h>
+#include <rte_common.h>
+#include <rte_eal.h>
+#include <rte_lcore.h>
+#include <rte_log.h>
+#include <rte_malloc.h>
+#include <rte_memcpy.h>
+
+#include <rte_dmadev_pmd.h>
+
+#include "skeleton_dmadev.h"
+
+RTE_LOG_REGISTER_DEFAULT(skeldma_logtype, INFO);
+#define SKELDMA_LOG(level, fmt, args...) \
+	rte_log(RTE_LOG_ ## level, skeldma_logtype, "%s(): " fmt "\n", \
+		__func__, ##args)
+
+/* Count of instances, currently only 1 is supported. */
+static uint16_t skeldma_count;
+
+static int
+skeldma_info_get(const struct rte_dma_dev *dev, struct rte_dma_info *dev_info,
+		 uint32_t info_sz)
+{
+#define SKELDMA_MAX_VCHANS	1
+
+	RTE_SET_USED(dev);
+	RTE_SET_USED(info_sz);
+
+	dev_info->dev_capa = RTE_DMA_CAPA_MEM_TO_MEM |
+			     RTE_DMA_CAPA_SVA |
+			     RTE_DMA_CAPA_OPS_COPY |
+			     RTE_DMA_CAPA_OPS_FILL;
+	dev_info->max_vchans = SKELDMA_MAX_VCHANS;
+	dev_info->max_desc = SKELDMA_MAX_DESC;
+	dev_info->min_desc = SKELDMA_MIN_DESC;
+
+	return 0;
+}
+
+static int
+skeldma_configure(struct rte_dma_dev *dev, const struct rte_dma_conf *conf,
+		  uint32_t conf_sz)
+{
+	RTE_SET_USED(dev);
+	RTE_SET_USED(conf);
+	RTE_SET_USED(conf_sz);
+	return 0;
+}
+
+static void
+hw_reset(struct skeldma_hw *hw)
+{
+	hw->ring_idx = 0;
+	hw->submitted_idx = 0;
+	hw->completed_idx = 0;
+}
+
+static int
+skeldma_start(struct rte_dma_dev *dev)
+{
+	struct skeldma_hw *hw = dev->data->dev_private;
+
+	if (hw->desc_ring == NULL) {
+		SKELDMA_LOG(ERR, "Vchan was not setup, start fail!");
+		return -EINVAL;
+	}
+
+	hw_reset(hw);
+
+	return 0;
+}
+
+static int
+skeldma_stop(struct rte_dma_dev *dev)
+{
+	struct skeldma_hw *hw = dev->data->dev_private;
+
+	/* All work is done in the submit path, nothing can be in flight. */
+	hw_reset(hw);
+
+	return 0;
+}
+
+static void
+vchan_release(struct skeldma_hw *hw)
+{
+	rte_free(hw->desc_ring);
+	hw->desc_ring = NULL;
+}
+
+static int
+skeldma_close(struct rte_dma_dev *dev)
+{
+	/* The device already stopped */
+	vchan_release(dev->data->dev_private);
+	return 0;
+}
+
+static int
+skeldma_vchan_setup(struct rte_dma_dev *dev, uint16_t vchan,
+		    const struct rte_dma_vchan_conf *conf,
+		    uint32_t conf_sz)
+{
+	struct skeldma_hw *hw = dev->data->dev_private;
+	uint32_t ring_size;
+
+	RTE_SET_USED(vchan);
+	RTE_SET_USED(conf_sz);
+
+	ring_size = rte_align32pow2(conf->nb_desc);
+	if (ring_size > SKELDMA_MAX_DESC) {
+		SKELDMA_LOG(ERR, "Invalid number of descriptors %u!",
+			    conf->nb_desc);
+		return -EINVAL;
+	}
+
+	vchan_release(hw);
+
+	hw->desc_ring = rte_zmalloc_socket("dma_skeleton_desc",
+				ring_size * sizeof(struct skeldma_desc),
+				RTE_CACHE_LINE_SIZE, dev->data->numa_node);
+	if (hw->desc_ring == NULL) {
+		SKELDMA_LOG(ERR, "Malloc dma skeleton desc ring fail!");
+		return -ENOMEM;
+	}
+	hw->ring_size = ring_size;
+	hw->ring_mask = ring_size - 1;
+	hw_reset(hw);
+
+	return 0;
+}
+
+static int
+skeldma_stats_get(const struct rte_dma_dev *dev, uint16_t vchan,
+		  struct rte_dma_stats *stats, uint32_t stats_sz)
+{
+	struct skeldma_hw *hw = dev->data->dev_private;
+
+	RTE_SET_USED(vchan);
+	RTE_SET_USED(stats_sz);
+
+	stats->submitted = hw->submitted_count;
+	stats->completed = hw->completed_count;
+	stats->errors = 0;
+
+	return 0;
+}
+
+static int
+skeldma_stats_reset(struct rte_dma_dev *dev, uint16_t vchan)
+{
+	struct skeldma_hw *hw = dev->data->dev_private;
+
+	RTE_SET_USED(vchan);
+
+	hw->submitted_count = 0;
+	hw->completed_count = 0;
+
+	return 0;
+}
+
+static int
+skeldma_dump(const struct rte_dma_dev *dev, FILE *f)
+{
+	struct skeldma_hw *hw = dev->data->dev_private;
+
+	(void)fprintf(f,
+		"    ring_size: %u\n"
+		"    ring_idx: %u\n"
+		"    submitted_idx: %u\n"
+		"    completed_idx: %u\n"
+		"    submitted_count: %" PRIu64 "\n"
+		"    completed_count: %" PRIu64 "\n",
+		hw->ring_size, hw->ring_idx, hw->submitted_idx,
+		hw->completed_idx, hw->submitted_count, hw->completed_count);
+
+	return 0;
+}
+
+static inline uint16_t
+ring_space(const struct skeldma_hw *hw)
+{
+	return hw->ring_size - (uint16_t)(hw->ring_idx - hw->completed_idx);
+}
+
+static inline void
+submit(struct skeldma_hw *hw)
+{
+	struct skeldma_desc *desc;
+	uint64_t *dst;
+	uint32_t i;
+
+	/* The "hardware" is the calling lcore, so jobs are executed at
+	 * doorbell time and show up as completed straight away.
+	 */
+	while (hw->submitted_idx != hw->ring_idx) {
+		desc = &hw->desc_ring[hw->submitted_idx & hw->ring_mask];
+		if (desc->op == SKELDMA_OP_COPY) {
+			rte_memcpy(desc->dst, desc->src, desc->len);
+		} else {
+			dst = desc->dst;
+			for (i = 0; i < desc->len / sizeof(uint64_t); i++)
+				dst[i] = desc->pattern;
+			memcpy(&dst[i], &desc->pattern,
+			       desc->len % sizeof(uint64_t));
+		}
+		hw->submitted_idx++;
+		hw->submitted_count++;
+	}
+}
+
+static inline int
+enqueue(struct skeldma_hw *hw, enum skeldma_op op, void *src, void *dst,
+	uint64_t pattern, uint32_t length, uint64_t flags)
+{
+	struct skeldma_desc *desc;
+
+	if (ring_space(hw) == 0)
+		return -ENOSPC;
+
+	desc = &hw->desc_ring[hw->ring_idx & hw->ring_mask];
+	desc->op = op;
+	desc->src = src;
+	desc->dst = dst;
+	desc->pattern = pattern;
+	desc->len = length;
+	hw->ring_idx++;
+
+	if (flags & RTE_DMA_OP_FLAG_SUBMIT)
+		submit(hw);
+
+	return (uint16_t)(hw->ring_idx - 1);
+}
+
+static int
+skeldma_copy(void *dev_private, uint16_t vchan,
+	     rte_iova_t src, rte_iova_t dst,
+	     uint32_t length, uint64_t flags)
+{
+	RTE_SET_USED(vchan);
+	return enqueue(dev_private, SKELDMA_OP_COPY, (void *)(uintptr_t)src,
+		       (void *)(uintptr_t)dst, 0, length, flags);
+}
+
+static int
+skeldma_fill(void *dev_private, uint16_t vchan,
+	     uint64_t pattern, rte_iova_t dst,
+	     uint32_t length, uint64_t flags)
+{
+	RTE_SET_USED(vchan);
+	return enqueue(dev_private, SKELDMA_OP_FILL, NULL,
+		       (void *)(uintptr_t)dst, pattern, length, flags);
+}
+
+static int
+skeldma_submit(void *dev_private, uint16_t vchan)
+{
+	RTE_SET_USED(vchan);
+	submit(dev_private);
+	return 0;
+}
+
+static uint16_t
+skeldma_completed(void *dev_private,
+		  uint16_t vchan, const uint16_t nb_cpls,
+		  uint16_t *last_idx, bool *has_error)
+{
+	struct skeldma_hw *hw = dev_private;
+	uint16_t count;
+
+	RTE_SET_USED(vchan);
+	RTE_SET_USED(has_error);
+
+	count = RTE_MIN(nb_cpls,
+			(uint16_t)(hw->submitted_idx - hw->completed_idx));
+	hw->completed_idx += count;
+	hw->completed_count += count;
+	*last_idx = hw->completed_idx - 1;
+
+	return count;
+}
+
+static uint16_t
+skeldma_completed_status(void *dev_private,
+			 uint16_t vchan, const uint16_t nb_cpls,
+			 uint16_t *last_idx, enum rte_dma_status_code *status)
+{
+	uint16_t count, i;
+
+	count = skeldma_completed(dev_private, vchan, nb_cpls, last_idx, NULL);
+	for (i = 0; i < count; i++)
+		status[i] = RTE_DMA_STATUS_SUCCESSFUL;
+
+	return count;
+}
+
+static uint16_t
+skeldma_burst_capacity(const void *dev_private, uint16_t vchan)
+{
+	RTE_SET_USED(vchan);
+	return ring_space(dev_private);
+}
+
+static const struct rte_dma_dev_ops skeldma_ops = {
+	.dev_info_get     = skeldma_info_get,
+	.dev_configure    = skeldma_configure,
+	.dev_start        = skeldma_start,
+	.dev_stop         = skeldma_stop,
+	.dev_close        = skeldma_close,
+
+	.vchan_setup      = skeldma_vchan_setup,
+
+	.stats_get        = skeldma_stats_get,
+	.stats_reset      = skeldma_stats_reset,
+
+	.dev_dump         = skeldma_dump,
+};
+
+static int
+skeldma_create(const char *name, struct rte_vdev_device *vdev)
+{
+	struct rte_dma_dev *dev;
+
+	dev = rte_dma_pmd_allocate(name, rte_socket_id(),
+				   sizeof(struct skeldma_hw));
+	if (dev == NULL) {
+		SKELDMA_LOG(ERR, "Unable to allocate dmadev: %s", name);
+		return -EINVAL;
+	}
+
+	dev->device = &vdev->device;
+	dev->dev_ops = &skeldma_ops;
+	dev->fp_obj->dev_private = dev->data->dev_private;
+	dev->fp_obj->copy = skeldma_copy;
+	dev->fp_obj->fill = skeldma_fill;
+	dev->fp_obj->submit = skeldma_submit;
+	dev->fp_obj->completed = skeldma_completed;
+	dev->fp_obj->completed_status = skeldma_completed_status;
+	dev->fp_obj->burst_capacity = skeldma_burst_capacity;
+
+	dev->state = RTE_DMA_DEV_READY;
+
+	return dev->data->dev_id;
+}
+
+static int
+skeldma_probe(struct rte_vdev_device *vdev)
+{
+	const char *name;
+	int ret;
+
+	name = rte_vdev_device_name(vdev);
+	if (name == NULL)
+		return -EINVAL;
+
+	if (rte_eal_process_type() != RTE_PROC_PRIMARY) {
+		SKELDMA_LOG(ERR, "Multiple process not supported for %s", name);
+		return -EINVAL;
+	}
+
+	/* More than one instance is not supported */
+	if (skeldma_count > 0) {
+		SKELDMA_LOG(ERR, "Multiple instance not supported for %s",
+			    name);
+		return -EINVAL;
+	}
+
+	ret = skeldma_create(name, vdev);
+	if (ret >= 0) {
+		SKELDMA_LOG(INFO, "Create %s dmadev with lcore-id %d",
+			    name, rte_lcore_id());
+		skeldma_count = 1;
+	}
+
+	return ret < 0 ? ret : 0;
+}
+
+static int
+skeldma_remove(struct rte_vdev_device *vdev)
+{
+	const char *name;
+	int ret;
+
+	name = rte_vdev_device_name(vdev);
+	if (name == NULL)
+		return -1;
+
+	ret = rte_dma_pmd_release(name);
+	if (ret == 0)
+		skeldma_count = 0;
+
+	SKELDMA_LOG(INFO, "Remove %s dmadev", name);
+
+	return ret;
+}
+
+static struct rte_vdev_driver skeldma_pmd_drv = {
+	.probe = skeldma_probe,
+	.remove = skeldma_remove,
+	.drv_flags = RTE_VDEV_DRV_NEED_IOVA_AS_VA,
+};
+
+RTE_PMD_REGISTER_VDEV(dma_skeleton, skeldma_pmd_drv);
@@ -0,0 +1,45 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 HiSilicon Limited
+ */
+
+#ifndef SKELETON_DMADEV_H
+#define SKELETON_DMADEV_H
+
+#include <rte_dmadev.h>
+
+#define SKELDMA_MAX_DESC	8192
+#define SKELDMA_MIN_DESC	32
+
+enum skeldma_op {
+	SKELDMA_OP_COPY,
+	SKELDMA_OP_FILL,
+};
+
+struct skeldma_desc {
+	void *src;
+	void *dst;
+	uint64_t pattern;
+	uint32_t len;
+	uint8_t op;
+};
+
+struct skeldma_hw {
+	uint16_t ring_size;   /* Number of descriptors, power of two */
+	uint16_t ring_mask;
+	struct skeldma_desc *desc_ring;
+
+	/* Free-running indexes, only the low bits index the ring:
+	 *   [completed_idx, submitted_idx) are finished, not reported yet
+	 *   [submitted_idx, ring_idx)      are enqueued, doorbell not rung
+	 */
+	uint16_t ring_idx;
+	uint16_t submitted_idx;
+	uint16_t completed_idx;
+
+	/* Cache delimiter for dataplane API's operation data */
+	char cache1 __rte_cache_aligned;
+	uint64_t submitted_count;
+	uint64_t completed_count;
+};
+
+#endif /* SKELETON_DMADEV_H */
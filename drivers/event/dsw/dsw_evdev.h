@@ -172,6 +172,10 @@ struct dsw_port {
 	uint64_t emigration_start;
 	uint64_t emigrations;
 	uint64_t emigration_latency;
+	/* Emigrations to a port on another NUMA node. */
+	uint64_t remote_emigrations;
+	/* Emigrations given up for lack of a suitable target port. */
+	uint64_t aborted_emigrations;
 
 	uint8_t emigration_target_port_ids[DSW_MAX_FLOWS_PER_MIGRATION];
 	struct dsw_queue_flow
@@ -222,6 +226,8 @@ struct dsw_port {
 	int16_t load __rte_cache_aligned;
 	/* Estimate of flows currently migrating to this port. */
 	int32_t immigration_load __rte_cache_aligned;
+	/* NUMA node of the lcore last using this port. */
+	int32_t socket_id;
 } __rte_cache_aligned;
 
 struct dsw_queue {
@@ -179,6 +179,10 @@ dsw_port_consider_load_update(struct dsw_port *port, uint64_t now)
 	port->next_load_update = now + port->load_update_interval;
 
 	dsw_port_load_update(port, now);
+
+	/* The port may be moved to another lcore by the application. */
+	__atomic_store_n(&port->socket_id, (int32_t)rte_socket_id(),
+			 __ATOMIC_RELAXED);
 }
 
 static void
@@ -437,6 +441,21 @@ dsw_is_serving_port(struct dsw_evdev *dsw, uint8_t port_id, uint8_t queue_id)
 	return false;
 }
 
+static bool
+dsw_is_local_port(struct dsw_evdev *dsw, uint8_t source_port_id,
+		  uint8_t port_id)
+{
+	int32_t source_socket_id =
+		__atomic_load_n(&dsw->ports[source_port_id].socket_id,
+				__ATOMIC_RELAXED);
+	int32_t socket_id =
+		__atomic_load_n(&dsw->ports[port_id].socket_id,
+				__ATOMIC_RELAXED);
+
+	return source_socket_id == SOCKET_ID_ANY ||
+		socket_id == SOCKET_ID_ANY || source_socket_id == socket_id;
+}
+
 static bool
 dsw_select_emigration_target(struct dsw_evdev *dsw,
 			    struct dsw_queue_flow_burst *bursts,
@@ -451,6 +470,7 @@ dsw_select_emigration_target(struct dsw_evdev *dsw,
 	uint8_t candidate_port_id = 0;
 	int16_t candidate_weight = -1;
 	int16_t candidate_flow_load = -1;
+	bool candidate_local = false;
 	uint16_t i;
 
 	if (source_port_load < DSW_MIN_SOURCE_LOAD_FOR_MIGRATION)
@@ -470,6 +490,7 @@ dsw_select_emigration_target(struct dsw_evdev *dsw,
 
 		for (port_id = 0; port_id < num_ports; port_id++) {
 			int16_t weight;
+			bool local;
 
 			if (port_id == source_port_id)
 				continue;
@@ -480,12 +501,26 @@ dsw_select_emigration_target(struct dsw_evdev *dsw,
 			weight = dsw_evaluate_migration(source_port_load,
 							port_loads[port_id],
 							flow_load);
+			if (weight < 0)
+				continue;
+
+			/* Ports on the same NUMA node as the source port
+			 * are preferred, to keep the flow state in the
+			 * same LLC. A remote port is only selected if no
+			 * local port is a suitable target.
+			 */
+			local = dsw_is_local_port(dsw, source_port_id,
+						  port_id);
+			if (local < candidate_local)
+				continue;
 
-			if (weight > candidate_weight) {
+			if (local > candidate_local ||
+			    weight > candidate_weight) {
 				candidate_qf = qf;
 				candidate_port_id = port_id;
 				candidate_weight = weight;
 				candidate_flow_load = flow_load;
+				candidate_local = local;
 			}
 		}
 	}
@@ -756,6 +791,10 @@ dsw_port_end_emigration(struct dsw_evdev *dsw, struct dsw_port *port,
 				"queue_id %d flow_hash %d.\n", queue_id,
 				flow_hash);
 
+		if (!dsw_is_local_port(dsw, port->id,
+				       port->emigration_target_port_ids[i]))
+			port->remote_emigrations++;
+
 		if (queue_schedule_type == RTE_SCHED_TYPE_ATOMIC) {
 			dsw_port_remove_paused_flow(port, qf);
 			dsw_port_flush_paused_events(dsw, port, qf);
@@ -875,6 +914,7 @@ dsw_port_consider_emigration(struct dsw_evdev *dsw,
 		DSW_LOG_DP_PORT(DEBUG, source_port->id,
 				"Candidate target ports are all too highly "
 				"loaded.\n");
+		source_port->aborted_emigrations++;
 		return;
 	}
 
@@ -889,14 +929,17 @@ dsw_port_consider_emigration(struct dsw_evdev *dsw,
 				"queue_id %d flow_hash %d has been seen.\n",
 				bursts[0].queue_flow.queue_id,
 				bursts[0].queue_flow.flow_hash);
+		source_port->aborted_emigrations++;
 		return;
 	}
 
 	dsw_select_emigration_targets(dsw, source_port, bursts, num_bursts,
 				      port_loads);
 
-	if (source_port->emigration_targets_len == 0)
+	if (source_port->emigration_targets_len == 0) {
+		source_port->aborted_emigrations++;
 		return;
+	}
 
 	source_port->migration_state = DSW_MIGRATION_STATE_PAUSING;
 	source_port->emigration_start = rte_get_timer_cycles();
@@ -85,6 +85,8 @@ dsw_xstats_port_get_queue_dequeued(struct dsw_evdev *dsw, uint8_t port_id,
 }
 
 DSW_GEN_PORT_ACCESS_FN(emigrations)
+DSW_GEN_PORT_ACCESS_FN(remote_emigrations)
+DSW_GEN_PORT_ACCESS_FN(aborted_emigrations)
 DSW_GEN_PORT_ACCESS_FN(immigrations)
 
 static uint64_t
@@ -150,6 +152,10 @@ static struct dsw_xstats_port dsw_port_xstats[] = {
 	  false },
 	{ "port_%u_migration_latency", dsw_xstats_port_get_migration_latency,
 	  false },
+	{ "port_%u_remote_emigrations", dsw_xstats_port_get_remote_emigrations,
+	  false },
+	{ "port_%u_aborted_emigrations",
+	  dsw_xstats_port_get_aborted_emigrations, false },
 	{ "port_%u_immigrations", dsw_xstats_port_get_immigrations,
 	  false },
 	{ "port_%u_event_proc_latency", dsw_xstats_port_get_event_proc_latency,
@@ -23,6 +23,7 @@
 #define MIN_BURST_SIZE_ARG "min_burst"
 #define DEQ_BURST_SIZE_ARG "deq_burst"
 #define REFIL_ONCE_ARG "refill_once"
+#define MIGRATION_THRESHOLD_ARG "migration_threshold"
 
 static void
 sw_info_get(struct rte_eventdev *dev, struct rte_event_dev_info *info);
@@ -238,6 +239,8 @@ qid_init(struct sw_evdev *sw, unsigned int idx, int type,
 	const struct sw_fid_t fid = {.cq = -1, .pcount = 0};
 	for (i = 0; i < RTE_DIM(qid->fids); i++)
 		qid->fids[i] = fid;
+	qid->migrating_fid = -1;
+	qid->flow_migrations = 0;
 
 	qid->id = idx;
 	qid->type = type;
@@ -718,6 +721,10 @@ sw_dump(struct rte_eventdev *dev, FILE *f)
 		fprintf(f, "\trx   %"PRIu64"\tdrop %"PRIu64"\ttx   %"PRIu64"\n",
 			qid->stats.rx_pkts, qid->stats.rx_dropped,
 			qid->stats.tx_pkts);
+		if (qid->type == RTE_SCHED_TYPE_ATOMIC &&
+				sw->migration_threshold)
+			fprintf(f, "\tflow migrations %"PRIu64"\n",
+				qid->flow_migrations);
 		if (qid->type == RTE_SCHED_TYPE_ORDERED) {
 			struct rob_ring *rob_buf_free =
 				qid->reorder_buffer_freelist;
@@ -935,6 +942,17 @@ set_refill_once(const char *key __rte_unused, const char *value, void *opaque)
 	return 0;
 }
 
+static int
+set_migration_threshold(const char *key __rte_unused, const char *value,
+		void *opaque)
+{
+	int *threshold = opaque;
+	*threshold = atoi(value);
+	if (*threshold < 0 || *threshold >= SW_PORT_HIST_LIST)
+		return -1;
+	return 0;
+}
+
 static int32_t sw_sched_service_func(void *args)
 {
 	struct rte_eventdev *dev = args;
@@ -984,6 +1002,7 @@ sw_probe(struct rte_vdev_device *vdev)
 		MIN_BURST_SIZE_ARG,
 		DEQ_BURST_SIZE_ARG,
 		REFIL_ONCE_ARG,
+		MIGRATION_THRESHOLD_ARG,
 		NULL
 	};
 	const char *name;
@@ -996,6 +1015,7 @@ sw_probe(struct rte_vdev_device *vdev)
 	int min_burst_size = 1;
 	int deq_burst_size = SCHED_DEQUEUE_DEFAULT_BURST_SIZE;
 	int refill_once = 0;
+	int migration_threshold = 0;
 
 	name = rte_vdev_device_name(vdev);
 	params = rte_vdev_device_args(vdev);
@@ -1067,6 +1087,18 @@ sw_probe(struct rte_vdev_device *vdev)
 				return ret;
 			}
 
+			ret = rte_kvargs_process(kvlist,
+					MIGRATION_THRESHOLD_ARG,
+					set_migration_threshold,
+					&migration_threshold);
+			if (ret != 0) {
+				SW_LOG_ERR(
+					"%s: Error parsing migration threshold parameter",
+					name);
+				rte_kvargs_free(kvlist);
+				return ret;
+			}
+
 			rte_kvargs_free(kvlist);
 		}
 	}
@@ -1074,9 +1106,11 @@ sw_probe(struct rte_vdev_device *vdev)
 	SW_LOG_INFO(
 			"Creating eventdev sw device %s, numa_node=%d, "
 			"sched_quanta=%d, credit_quanta=%d "
-			"min_burst=%d, deq_burst=%d, refill_once=%d\n",
+			"min_burst=%d, deq_burst=%d, refill_once=%d, "
+			"migration_threshold=%d\n",
 			name, socket_id, sched_quanta, credit_quanta,
-			min_burst_size, deq_burst_size, refill_once);
+			min_burst_size, deq_burst_size, refill_once,
+			migration_threshold);
 
 	dev = rte_event_pmd_vdev_init(name,
 			sizeof(struct sw_evdev), socket_id);
@@ -1104,6 +1138,7 @@ sw_probe(struct rte_vdev_device *vdev)
 	sw->sched_min_burst_size = min_burst_size;
 	sw->sched_deq_burst_size = deq_burst_size;
 	sw->refill_once_per_iter = refill_once;
+	sw->migration_threshold = migration_threshold;
 
 	/* register service with EAL */
 	struct rte_service_spec service;
@@ -1150,5 +1185,5 @@ RTE_PMD_REGISTER_VDEV(EVENTDEV_NAME_SW_PMD, evdev_sw_pmd_drv);
 RTE_PMD_REGISTER_PARAM_STRING(event_sw, NUMA_NODE_ARG "=<int> "
 		SCHED_QUANTA_ARG "=<int>" CREDIT_QUANTA_ARG "=<int>"
 		MIN_BURST_SIZE_ARG "=<int>" DEQ_BURST_SIZE_ARG "=<int>"
-		REFIL_ONCE_ARG "=<int>");
+		REFIL_ONCE_ARG "=<int>" MIGRATION_THRESHOLD_ARG "=<int>");
 RTE_LOG_REGISTER_DEFAULT(eventdev_sw_log_level, NOTICE);
@@ -125,6 +125,9 @@ struct sw_qid {
 
 	/* Track flow ids for atomic load balancing */
 	struct sw_fid_t fids[SW_QID_NUM_FIDS];
+	/* atomic flow paused until drained to move to another CQ, or -1 */
+	int32_t migrating_fid;
+	uint64_t flow_migrations;
 
 	/* Track packet order for reordering when needed */
 	struct reorder_buffer_entry *reorder_buffer; /*< pkts await reorder */
@@ -226,6 +229,8 @@ struct sw_evdev {
 	uint32_t sched_deq_burst_size;
 	/* Refill pp buffers only once per scheduler call*/
 	uint32_t refill_once_per_iter;
+	/* CQ inflights imbalance migrating an atomic flow, 0 to disable */
+	uint32_t migration_threshold;
 	/* Current values */
 	uint32_t sched_flush_count;
 	uint32_t sched_min_burst;
@@ -35,11 +35,26 @@ sw_schedule_atomic_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
 	struct rte_event qes[MAX_PER_IQ_DEQUEUE]; /* count <= MAX */
 	struct rte_event blocked_qes[MAX_PER_IQ_DEQUEUE];
 	uint32_t nb_blocked = 0;
+	int least_cq = -1;
 	uint32_t i;
 
 	if (count > MAX_PER_IQ_DEQUEUE)
 		count = MAX_PER_IQ_DEQUEUE;
 
+	/* the least loaded CQ is the migration target of pinned flows */
+	if (sw->migration_threshold) {
+		uint32_t least_inflights = UINT32_MAX;
+
+		for (i = 0; i < qid->cq_num_mapped_cqs; i++) {
+			int test_cq = qid->cq_map[i];
+
+			if (sw->ports[test_cq].inflights < least_inflights) {
+				least_cq = test_cq;
+				least_inflights = sw->ports[test_cq].inflights;
+			}
+		}
+	}
+
 	/* This is the QID ID. The QID ID is static, hence it can be
 	 * used to identify the stage of processing in history lists etc
 	 */
@@ -73,6 +88,27 @@ sw_schedule_atomic_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
 			}
 
 			fid->cq = cq; /* this pins early */
+		} else if (unlikely((int32_t)flow_id == qid->migrating_fid)) {
+			/* paused until its inflight events are completed */
+			blocked_qes[nb_blocked++] = *qe;
+			continue;
+		} else if (least_cq >= 0 && qid->migrating_fid < 0 &&
+				sw->ports[cq].inflights >
+				sw->ports[least_cq].inflights +
+				sw->migration_threshold) {
+			/* Move the flow to the least loaded CQ. If some of
+			 * its events are inflight, the flow must first be
+			 * drained to keep the atomicity, it is then unpinned
+			 * and pinned again to the least loaded CQ.
+			 */
+			qid->flow_migrations++;
+			if (fid->pcount != 0) {
+				qid->migrating_fid = flow_id;
+				blocked_qes[nb_blocked++] = *qe;
+				continue;
+			}
+			cq = least_cq;
+			fid->cq = cq;
 		}
 
 		if (sw->cq_ring_space[cq] == 0 ||
@@ -393,8 +429,12 @@ __pull_port_lb(struct sw_evdev *sw, uint32_t port_id, int allow_reorder)
 			struct sw_fid_t *fid =
 				&sw->qids[hist_qid].fids[hist_fid];
 			fid->pcount -= eop;
-			if (fid->pcount == 0)
+			if (fid->pcount == 0) {
 				fid->cq = -1;
+				if ((int32_t)hist_fid ==
+						sw->qids[hist_qid].migrating_fid)
+					sw->qids[hist_qid].migrating_fid = -1;
+			}
 
 			if (allow_reorder) {
 				/* set reorder ready if an ordered QID */
@@ -24,8 +24,20 @@
  * Until the bucket is full, no objects from it are eligible for allocation.
  * If a request is made to dequeue a multiply of bucket size, it is
  * satisfied by returning the whole buckets, instead of separate objects.
+ *
+ * A bucket taken by an lcore is owned by it until it is full again: the
+ * objects freed on other lcores are returned in bulk to the adoption ring
+ * of the owner, and the buckets are moved between the shared ring and
+ * the per-lcore stacks in bursts, to limit the contention on the rings.
  */
 
+/* Maximum number of objects returned to another lcore at once */
+#define BUCKET_RETURN_BURST 32
+/* Maximum number of orphans adopted from the adoption ring at once */
+#define BUCKET_ADOPT_BURST 32
+/* Minimum number of buckets taken from the shared ring at once */
+#define BUCKET_REFILL_BURST 4
+
 
 struct bucket_header {
 	unsigned int lcore_id;
@@ -136,19 +148,60 @@ bucket_enqueue_single(struct bucket_data *bd, void *obj)
 	return rc;
 }
 
+static int
+bucket_return_orphans(struct bucket_data *bd, unsigned int lcore_id,
+		      void * const *obj_table, unsigned int n)
+{
+	unsigned int rc;
+
+	rc = rte_ring_enqueue_bulk(bd->adoption_buffer_rings[lcore_id],
+				   obj_table, n, NULL);
+	/* Ring is big enough to put all objects */
+	RTE_ASSERT(rc == n);
+	return rc == n ? 0 : -ENOBUFS;
+}
+
 static int
 bucket_enqueue(struct rte_mempool *mp, void * const *obj_table,
 	       unsigned int n)
 {
 	struct bucket_data *bd = mp->pool_data;
-	struct bucket_stack *local_stack = bd->buckets[rte_lcore_id()];
+	unsigned int lcore_id = rte_lcore_id();
+	struct bucket_stack *local_stack = bd->buckets[lcore_id];
+	void *orphans[BUCKET_RETURN_BURST];
+	unsigned int orphans_lcore_id = LCORE_ID_ANY;
+	unsigned int n_orphans = 0;
+	struct bucket_header *hdr;
 	unsigned int i;
 	int rc = 0;
 
 	for (i = 0; i < n; i++) {
-		rc = bucket_enqueue_single(bd, obj_table[i]);
-		RTE_ASSERT(rc == 0);
+		hdr = (struct bucket_header *)((uintptr_t)obj_table[i] &
+					       bd->bucket_page_mask);
+		if (hdr->lcore_id == lcore_id ||
+		    hdr->lcore_id == LCORE_ID_ANY) {
+			rc = bucket_enqueue_single(bd, obj_table[i]);
+			RTE_ASSERT(rc == 0);
+			continue;
+		}
+
+		/*
+		 * The owner cannot change until the bucket is full,
+		 * gather the objects going to the same one.
+		 */
+		if (n_orphans == BUCKET_RETURN_BURST ||
+		    (n_orphans > 0 && hdr->lcore_id != orphans_lcore_id)) {
+			rc = bucket_return_orphans(bd, orphans_lcore_id,
+						   orphans, n_orphans);
+			n_orphans = 0;
+		}
+		orphans_lcore_id = hdr->lcore_id;
+		orphans[n_orphans++] = obj_table[i];
 	}
+	if (n_orphans > 0)
+		rc = bucket_return_orphans(bd, orphans_lcore_id, orphans,
+					   n_orphans);
+
 	if (local_stack->top > bd->bucket_stack_thresh) {
 		rte_ring_enqueue_bulk(bd->shared_bucket_ring,
 				      &local_stack->objects
@@ -219,38 +272,53 @@ bucket_dequeue_orphans(struct bucket_data *bd, void **obj_table,
 	return 0;
 }
 
+/*
+ * Take at least n buckets from the shared ring to the local stack, in one
+ * burst. The stack is big enough to hold all the buckets, the extra ones
+ * are given back by bucket_enqueue() above bucket_stack_thresh.
+ */
+static unsigned int
+bucket_stack_refill(struct bucket_data *bd, struct bucket_stack *stack,
+		    unsigned int n)
+{
+	unsigned int lcore_id = rte_lcore_id();
+	struct bucket_header *hdr;
+	unsigned int i, n_refill;
+
+	n_refill = RTE_MIN(RTE_MAX(n, (unsigned int)BUCKET_REFILL_BURST),
+			   stack->limit - stack->top);
+	n_refill = rte_ring_dequeue_burst(bd->shared_bucket_ring,
+					  &stack->objects[stack->top],
+					  n_refill, NULL);
+	for (i = 0; i < n_refill; i++) {
+		hdr = stack->objects[stack->top + i];
+		hdr->lcore_id = lcore_id;
+	}
+	stack->top += n_refill;
+
+	return n_refill;
+}
+
 static int
 bucket_dequeue_buckets(struct bucket_data *bd, void **obj_table,
 		       unsigned int n_buckets)
 {
 	struct bucket_stack *cur_stack = bd->buckets[rte_lcore_id()];
-	unsigned int n_buckets_from_stack = RTE_MIN(n_buckets, cur_stack->top);
-	void **obj_table_base = obj_table;
-
-	n_buckets -= n_buckets_from_stack;
-	while (n_buckets_from_stack-- > 0) {
-		void *obj = bucket_stack_pop_unsafe(cur_stack);
+	unsigned int n_missing;
 
-		obj_table = bucket_fill_obj_table(bd, &obj, obj_table,
-						  bd->obj_per_bucket);
-	}
-	while (n_buckets-- > 0) {
-		struct bucket_header *hdr;
-
-		if (unlikely(rte_ring_dequeue(bd->shared_bucket_ring,
-					      (void **)&hdr) != 0)) {
-			/*
-			 * Return the already-dequeued buffers
-			 * back to the mempool
-			 */
-			bucket_enqueue(bd->pool, obj_table_base,
-				       obj_table - obj_table_base);
+	if (cur_stack->top < n_buckets) {
+		n_missing = n_buckets - cur_stack->top;
+		if (bucket_stack_refill(bd, cur_stack, n_missing) <
+		    n_missing) {
 			rte_errno = ENOBUFS;
 			return -rte_errno;
 		}
-		hdr->lcore_id = rte_lcore_id();
-		obj_table = bucket_fill_obj_table(bd, (void **)&hdr,
-						  obj_table,
+	}
+
+	while (n_buckets-- > 0) {
+		void *obj = bucket_stack_pop_unsafe(cur_stack);
+
+		obj_table = bucket_fill_obj_table(bd, &obj, obj_table,
 						  bd->obj_per_bucket);
 	}
 
@@ -265,11 +333,16 @@ bucket_adopt_orphans(struct bucket_data *bd)
 		bd->adoption_buffer_rings[rte_lcore_id()];
 
 	if (unlikely(!rte_ring_empty(adopt_ring))) {
-		void *orphan;
-
-		while (rte_ring_sc_dequeue(adopt_ring, &orphan) == 0) {
-			rc = bucket_enqueue_single(bd, orphan);
-			RTE_ASSERT(rc == 0);
+		void *orphans[BUCKET_ADOPT_BURST];
+		unsigned int i, n;
+
+		while ((n = rte_ring_sc_dequeue_burst(adopt_ring, orphans,
+						      BUCKET_ADOPT_BURST,
+						      NULL)) > 0) {
+			for (i = 0; i < n; i++) {
+				rc = bucket_enqueue_single(bd, orphans[i]);
+				RTE_ASSERT(rc == 0);
+			}
 		}
 	}
 	return rc;
@@ -313,34 +386,24 @@ bucket_dequeue_contig_blocks(struct rte_mempool *mp, void **first_obj_table,
 	struct bucket_data *bd = mp->pool_data;
 	const uint32_t header_size = bd->header_size;
 	struct bucket_stack *cur_stack = bd->buckets[rte_lcore_id()];
-	unsigned int n_buckets_from_stack = RTE_MIN(n, cur_stack->top);
 	struct bucket_header *hdr;
+	unsigned int n_missing;
 	void **first_objp = first_obj_table;
 
 	bucket_adopt_orphans(bd);
 
-	n -= n_buckets_from_stack;
-	while (n_buckets_from_stack-- > 0) {
-		hdr = bucket_stack_pop_unsafe(cur_stack);
-		*first_objp++ = (uint8_t *)hdr + header_size;
-	}
-	if (n > 0) {
-		if (unlikely(rte_ring_dequeue_bulk(bd->shared_bucket_ring,
-						   first_objp, n, NULL) != n)) {
-			/* Return the already dequeued buckets */
-			while (first_objp-- != first_obj_table) {
-				bucket_stack_push(cur_stack,
-						  (uint8_t *)*first_objp -
-						  header_size);
-			}
+	if (cur_stack->top < n) {
+		n_missing = n - cur_stack->top;
+		if (bucket_stack_refill(bd, cur_stack, n_missing) <
+		    n_missing) {
 			rte_errno = ENOBUFS;
 			return -rte_errno;
 		}
-		while (n-- > 0) {
-			hdr = (struct bucket_header *)*first_objp;
-			hdr->lcore_id = rte_lcore_id();
-			*first_objp++ = (uint8_t *)hdr + header_size;
-		}
+	}
+
+	while (n-- > 0) {
+		hdr = bucket_stack_pop_unsafe(cur_stack);
+		*first_objp++ = (uint8_t *)hdr + header_size;
 	}
 
 	return 0;
@@ -479,8 +542,12 @@ bucket_alloc(struct rte_mempool *mp)
 	RTE_BUILD_BUG_ON(sizeof(struct bucket_header) > RTE_CACHE_LINE_SIZE);
 	bd->header_size = mp->header_size + bucket_header_size;
 	bd->total_elt_size = mp->header_size + mp->elt_size + mp->trailer_size;
-	bd->bucket_mem_size = RTE_MIN(pg_sz,
-			(size_t)(RTE_DRIVER_MEMPOOL_BUCKET_SIZE_KB * 1024));
+	/*
+	 * Use a power of 2 dividing the page size, so that the buckets
+	 * tile the (huge)pages and never cross a page boundary.
+	 */
+	bd->bucket_mem_size = rte_align32prevpow2(RTE_MIN(pg_sz,
+			(size_t)(RTE_DRIVER_MEMPOOL_BUCKET_SIZE_KB * 1024)));
 	bd->obj_per_bucket = (bd->bucket_mem_size - bucket_header_size) /
 		bd->total_elt_size;
 	bd->bucket_page_mask = ~(rte_align64pow2(bd->bucket_mem_size) - 1);
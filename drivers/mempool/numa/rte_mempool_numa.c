@@ -0,0 +1,311 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <rte_errno.h>
+#include <rte_lcore.h>
+#include <rte_malloc.h>
+#include <rte_memory.h>
+#include <rte_mempool.h>
+#include <rte_ring.h>
+#include <rte_spinlock.h>
+
+/*
+ * The objects are split in one sub-pool per socket, according to the
+ * socket of their memory. The objects freed on their own socket go back
+ * to its sub-pool ring, the ones freed on another socket are returned
+ * in bulk to the return ring of their socket, so that the remote lcores
+ * never touch the sub-pool rings. The return ring has a single consumer
+ * at a time, an lcore of the socket running out of local objects.
+ */
+
+/* Sub-pool of a socket, both rings being allocated on this socket. */
+struct numa_subpool {
+	struct rte_ring *objs; /* objects freed on this socket */
+	struct rte_ring *ret; /* objects freed on other sockets */
+	rte_spinlock_t ret_lock; /* single consumer of the return ring */
+} __rte_cache_aligned;
+
+/* Memory chunk given to populate, with the socket of its memory. */
+struct numa_chunk {
+	uintptr_t start;
+	uintptr_t end;
+	int socket_id;
+};
+
+struct numa_pool {
+	struct numa_subpool sub[RTE_MAX_NUMA_NODES];
+	int def_socket; /* for the lcores and the memory without socket */
+	int single_socket; /* socket of all the chunks, -1 if several */
+	unsigned int nb_chunks;
+	struct numa_chunk *chunks;
+};
+
+static inline int
+numa_local_socket(const struct numa_pool *np)
+{
+	unsigned int socket_id = rte_socket_id();
+
+	if (socket_id >= RTE_MAX_NUMA_NODES ||
+			np->sub[socket_id].objs == NULL)
+		return np->def_socket;
+	return socket_id;
+}
+
+/* There are only a few chunks per memory zone of the mempool. */
+static inline int
+numa_obj_socket(const struct numa_pool *np, void *obj)
+{
+	uintptr_t addr = (uintptr_t)obj;
+	unsigned int i;
+
+	for (i = 0; i < np->nb_chunks; i++) {
+		if (addr >= np->chunks[i].start && addr < np->chunks[i].end)
+			return np->chunks[i].socket_id;
+	}
+	return np->def_socket;
+}
+
+static inline int
+numa_put(struct numa_pool *np, int local, int home,
+		void * const *obj_table, unsigned int n)
+{
+	struct rte_ring *r;
+
+	if (home == local)
+		r = np->sub[home].objs;
+	else
+		r = np->sub[home].ret;
+
+	/* the rings can hold all the objects, this cannot fail */
+	return rte_ring_mp_enqueue_bulk(r, obj_table, n, NULL) == 0 ?
+		-ENOBUFS : 0;
+}
+
+static int
+numa_enqueue(struct rte_mempool *mp, void * const *obj_table,
+		unsigned int n)
+{
+	struct numa_pool *np = mp->pool_data;
+	int local = numa_local_socket(np);
+	unsigned int i, first;
+	int home, socket_id;
+
+	if (n == 0)
+		return 0;
+	if (np->single_socket >= 0)
+		return numa_put(np, local, np->single_socket, obj_table, n);
+
+	/* bulk enqueue each run of objects of the same socket */
+	home = numa_obj_socket(np, obj_table[0]);
+	for (i = 1, first = 0; i < n; i++) {
+		socket_id = numa_obj_socket(np, obj_table[i]);
+		if (socket_id == home)
+			continue;
+		numa_put(np, local, home, &obj_table[first], i - first);
+		home = socket_id;
+		first = i;
+	}
+	return numa_put(np, local, home, &obj_table[first], n - first);
+}
+
+static unsigned int
+numa_subpool_dequeue(struct numa_subpool *sub, void **obj_table,
+		unsigned int n)
+{
+	unsigned int got;
+
+	got = rte_ring_mc_dequeue_burst(sub->objs, obj_table, n, NULL);
+	if (got < n && !rte_ring_empty(sub->ret)) {
+		rte_spinlock_lock(&sub->ret_lock);
+		got += rte_ring_sc_dequeue_burst(sub->ret, &obj_table[got],
+				n - got, NULL);
+		rte_spinlock_unlock(&sub->ret_lock);
+	}
+	return got;
+}
+
+static int
+numa_dequeue(struct rte_mempool *mp, void **obj_table, unsigned int n)
+{
+	struct numa_pool *np = mp->pool_data;
+	int local = numa_local_socket(np);
+	unsigned int got;
+	int socket_id;
+
+	if (likely(rte_ring_mc_dequeue_bulk(np->sub[local].objs, obj_table,
+			n, NULL) != 0))
+		return 0;
+
+	/*
+	 * Take the objects returned by the other sockets, then the objects
+	 * of the other sockets rather than failing.
+	 */
+	got = numa_subpool_dequeue(&np->sub[local], obj_table, n);
+	for (socket_id = 0; got < n && socket_id < RTE_MAX_NUMA_NODES;
+			socket_id++) {
+		if (socket_id == local || np->sub[socket_id].objs == NULL)
+			continue;
+		got += numa_subpool_dequeue(&np->sub[socket_id],
+				&obj_table[got], n - got);
+	}
+	if (got == n)
+		return 0;
+
+	numa_enqueue(mp, obj_table, got);
+	return -ENOBUFS;
+}
+
+static unsigned int
+numa_get_count(const struct rte_mempool *mp)
+{
+	const struct numa_pool *np = mp->pool_data;
+	unsigned int count = 0;
+	int socket_id;
+
+	for (socket_id = 0; socket_id < RTE_MAX_NUMA_NODES; socket_id++) {
+		if (np->sub[socket_id].objs == NULL)
+			continue;
+		count += rte_ring_count(np->sub[socket_id].objs);
+		count += rte_ring_count(np->sub[socket_id].ret);
+	}
+	return count;
+}
+
+static struct rte_ring *
+numa_ring_create(struct rte_mempool *mp, char type, int socket_id,
+		unsigned int flags)
+{
+	char rg_name[RTE_RING_NAMESIZE];
+	struct rte_ring *r;
+	int ret;
+
+	ret = snprintf(rg_name, sizeof(rg_name), RTE_MEMPOOL_MZ_FORMAT ".%c%d",
+		mp->name, type, socket_id);
+	if (ret < 0 || ret >= (int)sizeof(rg_name)) {
+		rte_errno = ENAMETOOLONG;
+		return NULL;
+	}
+
+	/* a socket may have no memory, the ring is then allocated anywhere */
+	r = rte_ring_create(rg_name, rte_align32pow2(mp->size + 1),
+		socket_id, flags);
+	if (r == NULL && rte_errno == ENOMEM)
+		r = rte_ring_create(rg_name, rte_align32pow2(mp->size + 1),
+			SOCKET_ID_ANY, flags);
+	return r;
+}
+
+static void
+numa_free(struct rte_mempool *mp)
+{
+	struct numa_pool *np = mp->pool_data;
+	int socket_id;
+
+	if (np == NULL)
+		return;
+
+	for (socket_id = 0; socket_id < RTE_MAX_NUMA_NODES; socket_id++) {
+		rte_ring_free(np->sub[socket_id].objs);
+		rte_ring_free(np->sub[socket_id].ret);
+	}
+	rte_free(np->chunks);
+	rte_free(np);
+	mp->pool_data = NULL;
+}
+
+static int
+numa_alloc(struct rte_mempool *mp)
+{
+	struct numa_subpool *sub;
+	struct numa_pool *np;
+	unsigned int i;
+	int socket_id;
+
+	np = rte_zmalloc_socket("numa_pool", sizeof(*np), RTE_CACHE_LINE_SIZE,
+		mp->socket_id);
+	if (np == NULL) {
+		rte_errno = ENOMEM;
+		return -rte_errno;
+	}
+	mp->pool_data = np;
+
+	for (i = 0; i < rte_socket_count(); i++) {
+		socket_id = rte_socket_id_by_idx(i);
+		if (socket_id < 0 || socket_id >= RTE_MAX_NUMA_NODES)
+			continue;
+		sub = &np->sub[socket_id];
+		sub->objs = numa_ring_create(mp, 'o', socket_id, 0);
+		if (sub->objs == NULL)
+			goto error;
+		sub->ret = numa_ring_create(mp, 'r', socket_id, RING_F_SC_DEQ);
+		if (sub->ret == NULL)
+			goto error;
+		rte_spinlock_init(&sub->ret_lock);
+	}
+
+	if (mp->socket_id >= 0 && mp->socket_id < RTE_MAX_NUMA_NODES &&
+			np->sub[mp->socket_id].objs != NULL)
+		np->def_socket = mp->socket_id;
+	else
+		np->def_socket = rte_socket_id_by_idx(0);
+	np->single_socket = np->def_socket;
+
+	return 0;
+
+error:
+	i = rte_errno;
+	numa_free(mp);
+	rte_errno = i;
+	return -rte_errno;
+}
+
+static int
+numa_populate(struct rte_mempool *mp, unsigned int max_objs,
+		void *vaddr, rte_iova_t iova, size_t len,
+		rte_mempool_populate_obj_cb_t *obj_cb, void *obj_cb_arg)
+{
+	struct numa_pool *np = mp->pool_data;
+	const struct rte_memseg *ms;
+	struct numa_chunk *chunks;
+	int socket_id;
+
+	/* anonymous or external memory goes to the default sub-pool */
+	ms = rte_mem_virt2memseg(vaddr, NULL);
+	socket_id = ms != NULL ? ms->socket_id : np->def_socket;
+	if (socket_id < 0 || socket_id >= RTE_MAX_NUMA_NODES ||
+			np->sub[socket_id].objs == NULL)
+		socket_id = np->def_socket;
+
+	chunks = rte_realloc(np->chunks,
+		(np->nb_chunks + 1) * sizeof(*chunks), 0);
+	if (chunks == NULL)
+		return -ENOMEM;
+	chunks[np->nb_chunks].start = (uintptr_t)vaddr;
+	chunks[np->nb_chunks].end = (uintptr_t)vaddr + len;
+	chunks[np->nb_chunks].socket_id = socket_id;
+	np->chunks = chunks;
+	if (np->nb_chunks == 0)
+		np->single_socket = socket_id;
+	else if (np->single_socket != socket_id)
+		np->single_socket = -1;
+	np->nb_chunks++;
+
+	return rte_mempool_op_populate_helper(mp, 0, max_objs, vaddr, iova,
+		len, obj_cb, obj_cb_arg);
+}
+
+static const struct rte_mempool_ops ops_numa = {
+	.name = "numa",
+	.alloc = numa_alloc,
+	.free = numa_free,
+	.enqueue = numa_enqueue,
+	.dequeue = numa_dequeue,
+	.get_count = numa_get_count,
+	.populate = numa_populate,
+};
+
+MEMPOOL_REGISTER_OPS(ops_numa);
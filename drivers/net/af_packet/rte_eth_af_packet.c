@@ -34,6 +34,10 @@
 #define ETH_AF_PACKET_FRAMESIZE_ARG	"framesz"
 #define ETH_AF_PACKET_FRAMECOUNT_ARG	"framecnt"
 #define ETH_AF_PACKET_QDISC_BYPASS_ARG	"qdisc_bypass"
+#define ETH_AF_PACKET_TPACKET_V3_ARG	"tpacket_v3"
+#define ETH_AF_PACKET_BLOCK_TIMEOUT_ARG	"block_timeout"
+#define ETH_AF_PACKET_RX_EXTBUF_ARG	"rx_extbuf"
+#define ETH_AF_PACKET_FANOUT_MODE_ARG	"fanout_mode"
 
 #define DFLT_FRAME_SIZE		(1 << 11)
 #define DFLT_FRAME_COUNT	(1 << 9)
@@ -43,14 +47,27 @@ struct pkt_rx_queue {
 
 	struct iovec *rd;
 	uint8_t *map;
+	size_t map_size;
 	unsigned int framecount;
 	unsigned int framenum;
 
+	/*
+	 * TPACKET_V3: the ring entries are blocks of frames. The frames of
+	 * a block are either copied, or attached to the mbufs, in which case
+	 * the block is returned to the kernel when all the mbufs are freed.
+	 */
+	uint64_t *block_seq; /* sequence number of the last block read */
+	struct rte_mbuf_ext_shared_info *shinfo; /* per block, NULL if copy */
+	uint8_t *frame; /* next frame of the block being read */
+	unsigned int frames_left; /* frames left in the block being read */
+	int rxhash;
+
 	struct rte_mempool *mb_pool;
 	uint16_t in_port;
 
 	volatile unsigned long rx_pkts;
 	volatile unsigned long rx_bytes;
+	volatile unsigned long err_pkts;
 };
 
 struct pkt_tx_queue {
@@ -59,6 +76,7 @@ struct pkt_tx_queue {
 
 	struct iovec *rd;
 	uint8_t *map;
+	size_t map_size; /* 0 when part of the Rx queue mapping */
 	unsigned int framecount;
 	unsigned int framenum;
 
@@ -75,6 +93,8 @@ struct pmd_internals {
 	struct rte_ether_addr eth_addr;
 
 	struct tpacket_req req;
+	unsigned int tpacket_v3;
+	unsigned int rx_extbuf;
 
 	struct pkt_rx_queue *rx_queue;
 	struct pkt_tx_queue *tx_queue;
@@ -87,6 +107,10 @@ static const char *valid_arguments[] = {
 	ETH_AF_PACKET_FRAMESIZE_ARG,
 	ETH_AF_PACKET_FRAMECOUNT_ARG,
 	ETH_AF_PACKET_QDISC_BYPASS_ARG,
+	ETH_AF_PACKET_TPACKET_V3_ARG,
+	ETH_AF_PACKET_BLOCK_TIMEOUT_ARG,
+	ETH_AF_PACKET_RX_EXTBUF_ARG,
+	ETH_AF_PACKET_FANOUT_MODE_ARG,
 	NULL
 };
 
@@ -167,6 +191,141 @@ eth_af_packet_rx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 	return num_rx;
 }
 
+/*
+ * Returns a TPACKET_V3 block to the kernel. Also the free callback of the
+ * frames attached to the mbufs, called when the last of them is freed.
+ */
+static void
+eth_af_packet_block_release(void *addr __rte_unused, void *opaque)
+{
+	struct tpacket_block_desc *pbd = opaque;
+
+	__atomic_store_n(&pbd->hdr.bh1.block_status, TP_STATUS_KERNEL,
+			 __ATOMIC_RELEASE);
+}
+
+/* Done reading the current block, move to the next one. */
+static inline void
+eth_af_packet_block_close(struct pkt_rx_queue *pkt_q,
+			  struct tpacket_block_desc *pbd)
+{
+	if (pkt_q->shinfo == NULL ||
+	    rte_mbuf_ext_refcnt_update(&pkt_q->shinfo[pkt_q->framenum],
+				       -1) == 0)
+		eth_af_packet_block_release(NULL, pbd);
+
+	if (++pkt_q->framenum >= pkt_q->framecount)
+		pkt_q->framenum = 0;
+}
+
+static uint16_t
+eth_af_packet_rx_v3(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
+{
+	struct tpacket_block_desc *pbd;
+	struct tpacket3_hdr *ppd;
+	struct rte_mbuf *mbuf;
+	uint8_t *pbuf;
+	struct pkt_rx_queue *pkt_q = queue;
+	uint16_t num_rx = 0;
+	unsigned long num_rx_bytes = 0;
+	unsigned long num_err = 0;
+
+	/*
+	 * Reads the frames of whole blocks retired by the kernel, either when
+	 * full or on timeout. A block is returned to the kernel at once when
+	 * all its frames are read, or when all the mbufs attached to them are
+	 * freed. The sequence number prevents reading again a block still
+	 * owned by such mbufs.
+	 */
+	while (num_rx < nb_pkts) {
+		pbd = pkt_q->rd[pkt_q->framenum].iov_base;
+
+		if (pkt_q->frames_left == 0) {
+			/* open the next block */
+			if ((__atomic_load_n(&pbd->hdr.bh1.block_status,
+					     __ATOMIC_ACQUIRE) &
+			     TP_STATUS_USER) == 0 ||
+			    pbd->hdr.bh1.seq_num ==
+			    pkt_q->block_seq[pkt_q->framenum])
+				break;
+
+			pkt_q->block_seq[pkt_q->framenum] =
+				pbd->hdr.bh1.seq_num;
+			pkt_q->frames_left = pbd->hdr.bh1.num_pkts;
+			pkt_q->frame = (uint8_t *)pbd +
+				pbd->hdr.bh1.offset_to_first_pkt;
+			if (pkt_q->shinfo != NULL)
+				rte_mbuf_ext_refcnt_set(
+					&pkt_q->shinfo[pkt_q->framenum], 1);
+
+			if (unlikely(pkt_q->frames_left == 0)) {
+				eth_af_packet_block_close(pkt_q, pbd);
+				continue;
+			}
+		}
+
+		/* allocate the next mbuf */
+		mbuf = rte_pktmbuf_alloc(pkt_q->mb_pool);
+		if (unlikely(mbuf == NULL))
+			break;
+
+		ppd = (struct tpacket3_hdr *)pkt_q->frame;
+		pbuf = (uint8_t *)ppd + ppd->tp_mac;
+
+		if (pkt_q->shinfo != NULL) {
+			/* the frame header is the mbuf headroom */
+			rte_mbuf_ext_refcnt_update(
+				&pkt_q->shinfo[pkt_q->framenum], 1);
+			rte_pktmbuf_attach_extbuf(mbuf, ppd, RTE_BAD_IOVA,
+				ppd->tp_mac + ppd->tp_snaplen,
+				&pkt_q->shinfo[pkt_q->framenum]);
+			mbuf->data_off = ppd->tp_mac;
+		} else if (likely(ppd->tp_snaplen <=
+				  rte_pktmbuf_tailroom(mbuf))) {
+			memcpy(rte_pktmbuf_mtod(mbuf, void *), pbuf,
+			       ppd->tp_snaplen);
+		} else {
+			/* packet will not fit in the mbuf, drop it */
+			rte_pktmbuf_free(mbuf);
+			mbuf = NULL;
+			num_err++;
+		}
+
+		if (mbuf != NULL) {
+			rte_pktmbuf_pkt_len(mbuf) = ppd->tp_snaplen;
+			rte_pktmbuf_data_len(mbuf) = ppd->tp_snaplen;
+
+			/* check for vlan info */
+			if (ppd->tp_status & TP_STATUS_VLAN_VALID) {
+				mbuf->vlan_tci = ppd->hv1.tp_vlan_tci;
+				mbuf->ol_flags |= (PKT_RX_VLAN |
+						   PKT_RX_VLAN_STRIPPED);
+			}
+
+			/* flow hash used by the fanout */
+			if (pkt_q->rxhash) {
+				mbuf->hash.rss = ppd->hv1.tp_rxhash;
+				mbuf->ol_flags |= PKT_RX_RSS_HASH;
+			}
+
+			mbuf->port = pkt_q->in_port;
+
+			/* account for the receive frame */
+			bufs[num_rx++] = mbuf;
+			num_rx_bytes += mbuf->pkt_len;
+		}
+
+		/* advance to the next frame, release the block when done */
+		pkt_q->frame += ppd->tp_next_offset;
+		if (--pkt_q->frames_left == 0)
+			eth_af_packet_block_close(pkt_q, pbd);
+	}
+	pkt_q->rx_pkts += num_rx;
+	pkt_q->rx_bytes += num_rx_bytes;
+	pkt_q->err_pkts += num_err;
+	return num_rx;
+}
+
 /*
  * Callback to handle sending packets through a real NIC.
  */
@@ -326,7 +485,8 @@ static int
 eth_stats_get(struct rte_eth_dev *dev, struct rte_eth_stats *igb_stats)
 {
 	unsigned i, imax;
-	unsigned long rx_total = 0, tx_total = 0, tx_err_total = 0;
+	unsigned long rx_total = 0, rx_err_total = 0;
+	unsigned long tx_total = 0, tx_err_total = 0;
 	unsigned long rx_bytes_total = 0, tx_bytes_total = 0;
 	const struct pmd_internals *internal = dev->data->dev_private;
 
@@ -336,6 +496,7 @@ eth_stats_get(struct rte_eth_dev *dev, struct rte_eth_stats *igb_stats)
 		igb_stats->q_ipackets[i] = internal->rx_queue[i].rx_pkts;
 		igb_stats->q_ibytes[i] = internal->rx_queue[i].rx_bytes;
 		rx_total += igb_stats->q_ipackets[i];
+		rx_err_total += internal->rx_queue[i].err_pkts;
 		rx_bytes_total += igb_stats->q_ibytes[i];
 	}
 
@@ -350,6 +511,7 @@ eth_stats_get(struct rte_eth_dev *dev, struct rte_eth_stats *igb_stats)
 	}
 
 	igb_stats->ipackets = rx_total;
+	igb_stats->ierrors = rx_err_total;
 	igb_stats->ibytes = rx_bytes_total;
 	igb_stats->opackets = tx_total;
 	igb_stats->oerrors = tx_err_total;
@@ -366,6 +528,7 @@ eth_stats_reset(struct rte_eth_dev *dev)
 	for (i = 0; i < internal->nb_queues; i++) {
 		internal->rx_queue[i].rx_pkts = 0;
 		internal->rx_queue[i].rx_bytes = 0;
+		internal->rx_queue[i].err_pkts = 0;
 	}
 
 	for (i = 0; i < internal->nb_queues; i++) {
@@ -381,7 +544,6 @@ static int
 eth_dev_close(struct rte_eth_dev *dev)
 {
 	struct pmd_internals *internals;
-	struct tpacket_req *req;
 	unsigned int q;
 
 	if (rte_eal_process_type() != RTE_PROC_PRIMARY)
@@ -391,11 +553,15 @@ eth_dev_close(struct rte_eth_dev *dev)
 		rte_socket_id());
 
 	internals = dev->data->dev_private;
-	req = &internals->req;
 	for (q = 0; q < internals->nb_queues; q++) {
 		munmap(internals->rx_queue[q].map,
-			2 * req->tp_block_size * req->tp_block_nr);
+			internals->rx_queue[q].map_size);
+		if (internals->tx_queue[q].map_size)
+			munmap(internals->tx_queue[q].map,
+				internals->tx_queue[q].map_size);
 		rte_free(internals->rx_queue[q].rd);
+		rte_free(internals->rx_queue[q].block_seq);
+		rte_free(internals->rx_queue[q].shinfo);
 		rte_free(internals->tx_queue[q].rd);
 	}
 	free(internals->if_name);
@@ -437,9 +603,11 @@ eth_rx_queue_setup(struct rte_eth_dev *dev,
 	buf_size = rte_pktmbuf_data_room_size(pkt_q->mb_pool) -
 		RTE_PKTMBUF_HEADROOM;
 	data_size = internals->req.tp_frame_size;
-	data_size -= TPACKET2_HDRLEN - sizeof(struct sockaddr_ll);
+	data_size -= (internals->tpacket_v3 ? TPACKET3_HDRLEN :
+		      TPACKET2_HDRLEN) - sizeof(struct sockaddr_ll);
 
-	if (data_size > buf_size) {
+	/* No copy when the frames are attached to the mbufs */
+	if (!internals->rx_extbuf && data_size > buf_size) {
 		PMD_LOG(ERR,
 			"%s: %d bytes will not fit in mbuf (%d bytes)",
 			dev->device->name, data_size, buf_size);
@@ -474,7 +642,8 @@ eth_dev_mtu_set(struct rte_eth_dev *dev, uint16_t mtu)
 	int ret;
 	int s;
 	unsigned int data_size = internals->req.tp_frame_size -
-				 TPACKET2_HDRLEN;
+				 (internals->tpacket_v3 ? TPACKET3_HDRLEN :
+				  TPACKET2_HDRLEN);
 
 	if (mtu > data_size)
 		return -EINVAL;
@@ -601,6 +770,171 @@ open_packet_iface(const char *key __rte_unused,
 	return 0;
 }
 
+/*
+ * Sets up the TPACKET_V3 Rx ring of a queue socket. The Tx ring is set up on
+ * a separate socket with TPACKET_V2, as the TPACKET_V3 Tx rings are not
+ * supported by all kernels. This socket is bound to no protocol, so it does
+ * not receive any packet.
+ */
+static int
+eth_af_packet_queue_init_v3(struct pmd_internals *internals,
+			    unsigned int q,
+			    int qsockfd,
+			    struct sockaddr_ll *sockaddr,
+			    struct tpacket_req3 *req3,
+			    unsigned int qdisc_bypass,
+			    unsigned int rx_extbuf,
+			    int rxhash,
+			    unsigned int numa_node,
+			    const char *name,
+			    const char *if_name)
+{
+	struct pkt_rx_queue *rx_queue = &internals->rx_queue[q];
+	struct pkt_tx_queue *tx_queue = &internals->tx_queue[q];
+	struct tpacket_req *req = &internals->req;
+	int rc, tpver, discard, txsockfd;
+	unsigned int i;
+
+	rc = setsockopt(qsockfd, SOL_PACKET, PACKET_RX_RING,
+			req3, sizeof(*req3));
+	if (rc == -1) {
+		PMD_LOG_ERRNO(ERR,
+			"%s: could not set PACKET_RX_RING on AF_PACKET socket for %s",
+			name, if_name);
+		return -1;
+	}
+
+	rx_queue->framecount = req3->tp_block_nr;
+	rx_queue->map_size = req3->tp_block_size * req3->tp_block_nr;
+	rx_queue->map = mmap(NULL, rx_queue->map_size,
+			    PROT_READ | PROT_WRITE, MAP_SHARED | MAP_LOCKED,
+			    qsockfd, 0);
+	if (rx_queue->map == MAP_FAILED) {
+		PMD_LOG_ERRNO(ERR,
+			"%s: call to mmap failed on AF_PACKET socket for %s",
+			name, if_name);
+		return -1;
+	}
+
+	/* one Rx ring entry per block */
+	rx_queue->rd = rte_zmalloc_socket(name,
+		req3->tp_block_nr * sizeof(*(rx_queue->rd)), 0, numa_node);
+	rx_queue->block_seq = rte_zmalloc_socket(name,
+		req3->tp_block_nr * sizeof(*(rx_queue->block_seq)), 0,
+		numa_node);
+	if (rx_queue->rd == NULL || rx_queue->block_seq == NULL)
+		return -1;
+	for (i = 0; i < req3->tp_block_nr; ++i) {
+		rx_queue->rd[i].iov_base = rx_queue->map +
+			(i * req3->tp_block_size);
+		rx_queue->rd[i].iov_len = req3->tp_block_size;
+	}
+
+	if (rx_extbuf) {
+		rx_queue->shinfo = rte_zmalloc_socket(name,
+			req3->tp_block_nr * sizeof(*(rx_queue->shinfo)), 0,
+			numa_node);
+		if (rx_queue->shinfo == NULL)
+			return -1;
+		for (i = 0; i < req3->tp_block_nr; ++i) {
+			rx_queue->shinfo[i].free_cb =
+				eth_af_packet_block_release;
+			rx_queue->shinfo[i].fcb_opaque =
+				rx_queue->rd[i].iov_base;
+		}
+	}
+	rx_queue->rxhash = rxhash;
+	rx_queue->sockfd = qsockfd;
+
+	/* Tx socket */
+	txsockfd = socket(AF_PACKET, SOCK_RAW, 0);
+	if (txsockfd == -1) {
+		PMD_LOG_ERRNO(ERR, "%s: could not open AF_PACKET socket",
+			name);
+		return -1;
+	}
+	tx_queue->sockfd = txsockfd;
+
+	tpver = TPACKET_V2;
+	rc = setsockopt(txsockfd, SOL_PACKET, PACKET_VERSION,
+			&tpver, sizeof(tpver));
+	if (rc == -1) {
+		PMD_LOG_ERRNO(ERR,
+			"%s: could not set PACKET_VERSION on AF_PACKET socket for %s",
+			name, if_name);
+		return -1;
+	}
+
+	discard = 1;
+	rc = setsockopt(txsockfd, SOL_PACKET, PACKET_LOSS,
+			&discard, sizeof(discard));
+	if (rc == -1) {
+		PMD_LOG_ERRNO(ERR,
+			"%s: could not set PACKET_LOSS on AF_PACKET socket for %s",
+			name, if_name);
+		return -1;
+	}
+
+#if defined(PACKET_QDISC_BYPASS)
+	rc = setsockopt(txsockfd, SOL_PACKET, PACKET_QDISC_BYPASS,
+			&qdisc_bypass, sizeof(qdisc_bypass));
+	if (rc == -1) {
+		PMD_LOG_ERRNO(ERR,
+			"%s: could not set PACKET_QDISC_BYPASS on AF_PACKET socket for %s",
+			name, if_name);
+		return -1;
+	}
+#else
+	RTE_SET_USED(qdisc_bypass);
+#endif
+
+	rc = setsockopt(txsockfd, SOL_PACKET, PACKET_TX_RING, req, sizeof(*req));
+	if (rc == -1) {
+		PMD_LOG_ERRNO(ERR,
+			"%s: could not set PACKET_TX_RING on AF_PACKET "
+			"socket for %s", name, if_name);
+		return -1;
+	}
+
+	tx_queue->framecount = req->tp_frame_nr;
+	tx_queue->frame_data_size = req->tp_frame_size;
+	tx_queue->frame_data_size -= TPACKET2_HDRLEN -
+		sizeof(struct sockaddr_ll);
+	tx_queue->map_size = req->tp_block_size * req->tp_block_nr;
+	tx_queue->map = mmap(NULL, tx_queue->map_size,
+			    PROT_READ | PROT_WRITE, MAP_SHARED | MAP_LOCKED,
+			    txsockfd, 0);
+	if (tx_queue->map == MAP_FAILED) {
+		PMD_LOG_ERRNO(ERR,
+			"%s: call to mmap failed on AF_PACKET socket for %s",
+			name, if_name);
+		return -1;
+	}
+
+	tx_queue->rd = rte_zmalloc_socket(name,
+		req->tp_frame_nr * sizeof(*(tx_queue->rd)), 0, numa_node);
+	if (tx_queue->rd == NULL)
+		return -1;
+	for (i = 0; i < req->tp_frame_nr; ++i) {
+		tx_queue->rd[i].iov_base = tx_queue->map +
+			(i * req->tp_frame_size);
+		tx_queue->rd[i].iov_len = req->tp_frame_size;
+	}
+
+	sockaddr->sll_protocol = 0;
+	rc = bind(txsockfd, (const struct sockaddr *)sockaddr,
+		  sizeof(*sockaddr));
+	sockaddr->sll_protocol = htons(ETH_P_ALL);
+	if (rc == -1) {
+		PMD_LOG_ERRNO(ERR,
+			"%s: could not bind AF_PACKET socket to %s",
+			name, if_name);
+		return -1;
+	}
+
+	return 0;
+}
+
 static int
 rte_pmd_init_internals(struct rte_vdev_device *dev,
                        const int sockfd,
@@ -610,6 +944,10 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
                        unsigned int framesize,
                        unsigned int framecnt,
 		       unsigned int qdisc_bypass,
+		       unsigned int tpacket_v3,
+		       unsigned int block_timeout,
+		       unsigned int rx_extbuf,
+		       int fanout_mode,
                        struct pmd_internals **internals,
                        struct rte_eth_dev **eth_dev,
                        struct rte_kvargs *kvlist)
@@ -625,6 +963,7 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 	struct tpacket_req *req;
 	struct pkt_rx_queue *rx_queue;
 	struct pkt_tx_queue *tx_queue;
+	struct tpacket_req3 req3;
 	int rc, tpver, discard;
 	int qsockfd = -1;
 	unsigned int i, q, rdsize;
@@ -680,6 +1019,18 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 	req->tp_frame_size = framesize;
 	req->tp_frame_nr = framecnt;
 
+	memset(&req3, 0, sizeof(req3));
+	req3.tp_block_size = blocksize;
+	req3.tp_block_nr = blockcnt;
+	req3.tp_frame_size = framesize;
+	req3.tp_frame_nr = framecnt;
+	req3.tp_retire_blk_tov = block_timeout;
+	if (fanout_mode == PACKET_FANOUT_HASH)
+		req3.tp_feature_req_word = TP_FT_REQ_FILL_RXHASH;
+
+	(*internals)->tpacket_v3 = tpacket_v3;
+	(*internals)->rx_extbuf = rx_extbuf;
+
 	ifnamelen = strlen(pair->value);
 	if (ifnamelen < sizeof(ifr.ifr_name)) {
 		memcpy(ifr.ifr_name, pair->value, ifnamelen);
@@ -712,7 +1063,9 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 
 #if defined(PACKET_FANOUT)
 	fanout_arg = (getpid() ^ (*internals)->if_index) & 0xffff;
-	fanout_arg |= (PACKET_FANOUT_HASH | PACKET_FANOUT_FLAG_DEFRAG) << 16;
+	fanout_arg |= fanout_mode << 16;
+	if (fanout_mode == PACKET_FANOUT_HASH)
+		fanout_arg |= PACKET_FANOUT_FLAG_DEFRAG << 16;
 #if defined(PACKET_FANOUT_FLAG_ROLLOVER)
 	fanout_arg |= PACKET_FANOUT_FLAG_ROLLOVER << 16;
 #endif
@@ -728,7 +1081,7 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 			goto error;
 		}
 
-		tpver = TPACKET_V2;
+		tpver = tpacket_v3 ? TPACKET_V3 : TPACKET_V2;
 		rc = setsockopt(qsockfd, SOL_PACKET, PACKET_VERSION,
 				&tpver, sizeof(tpver));
 		if (rc == -1) {
@@ -761,63 +1114,83 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 		RTE_SET_USED(qdisc_bypass);
 #endif
 
-		rc = setsockopt(qsockfd, SOL_PACKET, PACKET_RX_RING, req, sizeof(*req));
-		if (rc == -1) {
-			PMD_LOG_ERRNO(ERR,
-				"%s: could not set PACKET_RX_RING on AF_PACKET socket for %s",
-				name, pair->value);
-			goto error;
-		}
-
-		rc = setsockopt(qsockfd, SOL_PACKET, PACKET_TX_RING, req, sizeof(*req));
-		if (rc == -1) {
-			PMD_LOG_ERRNO(ERR,
-				"%s: could not set PACKET_TX_RING on AF_PACKET "
-				"socket for %s", name, pair->value);
-			goto error;
-		}
-
-		rx_queue = &((*internals)->rx_queue[q]);
-		rx_queue->framecount = req->tp_frame_nr;
-
-		rx_queue->map = mmap(NULL, 2 * req->tp_block_size * req->tp_block_nr,
-				    PROT_READ | PROT_WRITE, MAP_SHARED | MAP_LOCKED,
-				    qsockfd, 0);
-		if (rx_queue->map == MAP_FAILED) {
-			PMD_LOG_ERRNO(ERR,
-				"%s: call to mmap failed on AF_PACKET socket for %s",
-				name, pair->value);
-			goto error;
-		}
-
-		/* rdsize is same for both Tx and Rx */
-		rdsize = req->tp_frame_nr * sizeof(*(rx_queue->rd));
-
-		rx_queue->rd = rte_zmalloc_socket(name, rdsize, 0, numa_node);
-		if (rx_queue->rd == NULL)
-			goto error;
-		for (i = 0; i < req->tp_frame_nr; ++i) {
-			rx_queue->rd[i].iov_base = rx_queue->map + (i * framesize);
-			rx_queue->rd[i].iov_len = req->tp_frame_size;
-		}
-		rx_queue->sockfd = qsockfd;
+		if (tpacket_v3) {
+			rc = eth_af_packet_queue_init_v3(*internals, q,
+					qsockfd, &sockaddr, &req3,
+					qdisc_bypass, rx_extbuf,
+					fanout_mode == PACKET_FANOUT_HASH,
+					numa_node, name, pair->value);
+			if (rc < 0)
+				goto error;
+		} else {
+			rc = setsockopt(qsockfd, SOL_PACKET, PACKET_RX_RING,
+					req, sizeof(*req));
+			if (rc == -1) {
+				PMD_LOG_ERRNO(ERR,
+					"%s: could not set PACKET_RX_RING on AF_PACKET socket for %s",
+					name, pair->value);
+				goto error;
+			}
 
-		tx_queue = &((*internals)->tx_queue[q]);
-		tx_queue->framecount = req->tp_frame_nr;
-		tx_queue->frame_data_size = req->tp_frame_size;
-		tx_queue->frame_data_size -= TPACKET2_HDRLEN -
-			sizeof(struct sockaddr_ll);
+			rc = setsockopt(qsockfd, SOL_PACKET, PACKET_TX_RING,
+					req, sizeof(*req));
+			if (rc == -1) {
+				PMD_LOG_ERRNO(ERR,
+					"%s: could not set PACKET_TX_RING on AF_PACKET "
+					"socket for %s", name, pair->value);
+				goto error;
+			}
 
-		tx_queue->map = rx_queue->map + req->tp_block_size * req->tp_block_nr;
+			rx_queue = &((*internals)->rx_queue[q]);
+			rx_queue->framecount = req->tp_frame_nr;
+			rx_queue->map_size = 2 * req->tp_block_size *
+				req->tp_block_nr;
+
+			rx_queue->map = mmap(NULL, rx_queue->map_size,
+					    PROT_READ | PROT_WRITE,
+					    MAP_SHARED | MAP_LOCKED,
+					    qsockfd, 0);
+			if (rx_queue->map == MAP_FAILED) {
+				PMD_LOG_ERRNO(ERR,
+					"%s: call to mmap failed on AF_PACKET socket for %s",
+					name, pair->value);
+				goto error;
+			}
 
-		tx_queue->rd = rte_zmalloc_socket(name, rdsize, 0, numa_node);
-		if (tx_queue->rd == NULL)
-			goto error;
-		for (i = 0; i < req->tp_frame_nr; ++i) {
-			tx_queue->rd[i].iov_base = tx_queue->map + (i * framesize);
-			tx_queue->rd[i].iov_len = req->tp_frame_size;
+			/* rdsize is same for both Tx and Rx */
+			rdsize = req->tp_frame_nr * sizeof(*(rx_queue->rd));
+
+			rx_queue->rd = rte_zmalloc_socket(name, rdsize, 0,
+							  numa_node);
+			if (rx_queue->rd == NULL)
+				goto error;
+			for (i = 0; i < req->tp_frame_nr; ++i) {
+				rx_queue->rd[i].iov_base = rx_queue->map +
+					(i * framesize);
+				rx_queue->rd[i].iov_len = req->tp_frame_size;
+			}
+			rx_queue->sockfd = qsockfd;
+
+			tx_queue = &((*internals)->tx_queue[q]);
+			tx_queue->framecount = req->tp_frame_nr;
+			tx_queue->frame_data_size = req->tp_frame_size;
+			tx_queue->frame_data_size -= TPACKET2_HDRLEN -
+				sizeof(struct sockaddr_ll);
+
+			tx_queue->map = rx_queue->map +
+				req->tp_block_size * req->tp_block_nr;
+
+			tx_queue->rd = rte_zmalloc_socket(name, rdsize, 0,
+							  numa_node);
+			if (tx_queue->rd == NULL)
+				goto error;
+			for (i = 0; i < req->tp_frame_nr; ++i) {
+				tx_queue->rd[i].iov_base = tx_queue->map +
+					(i * framesize);
+				tx_queue->rd[i].iov_len = req->tp_frame_size;
+			}
+			tx_queue->sockfd = qsockfd;
 		}
-		tx_queue->sockfd = qsockfd;
 
 		rc = bind(qsockfd, (const struct sockaddr*)&sockaddr, sizeof(sockaddr));
 		if (rc == -1) {
@@ -872,13 +1245,25 @@ rte_pmd_init_internals(struct rte_vdev_device *dev,
 	for (q = 0; q < nb_queues; q++) {
 		if ((*internals)->rx_queue[q].map != MAP_FAILED)
 			munmap((*internals)->rx_queue[q].map,
-			       2 * req->tp_block_size * req->tp_block_nr);
+			       (*internals)->rx_queue[q].map_size);
+		if ((*internals)->tx_queue[q].map != MAP_FAILED &&
+		    (*internals)->tx_queue[q].map_size)
+			munmap((*internals)->tx_queue[q].map,
+			       (*internals)->tx_queue[q].map_size);
 
 		rte_free((*internals)->rx_queue[q].rd);
+		rte_free((*internals)->rx_queue[q].block_seq);
+		rte_free((*internals)->rx_queue[q].shinfo);
 		rte_free((*internals)->tx_queue[q].rd);
 		if (((*internals)->rx_queue[q].sockfd >= 0) &&
 			((*internals)->rx_queue[q].sockfd != qsockfd))
 			close((*internals)->rx_queue[q].sockfd);
+		/* separate Tx socket with TPACKET_V3 */
+		if (((*internals)->tx_queue[q].sockfd >= 0) &&
+			((*internals)->tx_queue[q].sockfd !=
+			 (*internals)->rx_queue[q].sockfd) &&
+			((*internals)->tx_queue[q].sockfd != qsockfd))
+			close((*internals)->tx_queue[q].sockfd);
 	}
 free_internals:
 	rte_free((*internals)->rx_queue);
@@ -904,6 +1289,10 @@ rte_eth_from_packet(struct rte_vdev_device *dev,
 	unsigned int framecount = DFLT_FRAME_COUNT;
 	unsigned int qpairs = 1;
 	unsigned int qdisc_bypass = 1;
+	unsigned int tpacket_v3 = 0;
+	unsigned int block_timeout = 0;
+	unsigned int rx_extbuf = 0;
+	int fanout_mode = PACKET_FANOUT_HASH;
 
 	/* do some parameter checking */
 	if (*sockfd < 0)
@@ -966,6 +1355,56 @@ rte_eth_from_packet(struct rte_vdev_device *dev,
 			}
 			continue;
 		}
+		if (strstr(pair->key, ETH_AF_PACKET_TPACKET_V3_ARG) != NULL) {
+			tpacket_v3 = atoi(pair->value);
+			if (tpacket_v3 > 1) {
+				PMD_LOG(ERR,
+					"%s: invalid tpacket_v3 value",
+					name);
+				return -1;
+			}
+			continue;
+		}
+		if (strstr(pair->key, ETH_AF_PACKET_BLOCK_TIMEOUT_ARG) != NULL) {
+			block_timeout = atoi(pair->value);
+			continue;
+		}
+		if (strstr(pair->key, ETH_AF_PACKET_RX_EXTBUF_ARG) != NULL) {
+			rx_extbuf = atoi(pair->value);
+			if (rx_extbuf > 1) {
+				PMD_LOG(ERR,
+					"%s: invalid rx_extbuf value",
+					name);
+				return -1;
+			}
+			continue;
+		}
+		if (strstr(pair->key, ETH_AF_PACKET_FANOUT_MODE_ARG) != NULL) {
+			if (strcmp(pair->value, "hash") == 0)
+				fanout_mode = PACKET_FANOUT_HASH;
+			else if (strcmp(pair->value, "lb") == 0)
+				fanout_mode = PACKET_FANOUT_LB;
+			else if (strcmp(pair->value, "cpu") == 0)
+				fanout_mode = PACKET_FANOUT_CPU;
+#if defined(PACKET_FANOUT_QM)
+			else if (strcmp(pair->value, "qm") == 0)
+				fanout_mode = PACKET_FANOUT_QM;
+#endif
+			else {
+				PMD_LOG(ERR,
+					"%s: invalid fanout_mode value",
+					name);
+				return -1;
+			}
+			continue;
+		}
+	}
+
+	if (rx_extbuf && !tpacket_v3) {
+		PMD_LOG(ERR,
+			"%s: rx_extbuf requires tpacket_v3",
+			name);
+		return -1;
 	}
 
 	if (framesize > blocksize) {
@@ -987,16 +1426,20 @@ rte_eth_from_packet(struct rte_vdev_device *dev,
 	PMD_LOG(INFO, "%s:\tblock count %d", name, blockcount);
 	PMD_LOG(INFO, "%s:\tframe size %d", name, framesize);
 	PMD_LOG(INFO, "%s:\tframe count %d", name, framecount);
+	PMD_LOG(INFO, "%s:\tTPACKET_V3 %u", name, tpacket_v3);
 
 	if (rte_pmd_init_internals(dev, *sockfd, qpairs,
 				   blocksize, blockcount,
 				   framesize, framecount,
 				   qdisc_bypass,
+				   tpacket_v3, block_timeout, rx_extbuf,
+				   fanout_mode,
 				   &internals, &eth_dev,
 				   kvlist) < 0)
 		return -1;
 
-	eth_dev->rx_pkt_burst = eth_af_packet_rx;
+	eth_dev->rx_pkt_burst = tpacket_v3 ? eth_af_packet_rx_v3 :
+		eth_af_packet_rx;
 	eth_dev->tx_pkt_burst = eth_af_packet_tx;
 
 	rte_eth_dev_probing_finish(eth_dev);
@@ -1088,4 +1531,8 @@ RTE_PMD_REGISTER_PARAM_STRING(net_af_packet,
 	"blocksz=<int> "
 	"framesz=<int> "
 	"framecnt=<int> "
-	"qdisc_bypass=<0|1>");
+	"qdisc_bypass=<0|1> "
+	"tpacket_v3=<0|1> "
+	"block_timeout=<int> "
+	"rx_extbuf=<0|1> "
+	"fanout_mode=<hash|lb|cpu|qm>");
@@ -11,6 +11,11 @@
 #define ETH_AF_XDP_SHARED_UMEM 1
 #endif
 
+#if defined(XDP_UMEM_UNALIGNED_CHUNK_FLAG) && defined(XDP_USE_SG) && \
+	defined(XDP_PKT_CONTD)
+#define ETH_AF_XDP_MULTI_BUFFER 1
+#endif
+
 #ifdef ETH_AF_XDP_SHARED_UMEM
 static __rte_always_inline int
 create_shared_socket(struct xsk_socket **xsk_ptr,
@@ -84,7 +84,7 @@ struct xsk_umem_info {
 	const struct rte_memzone *mz;
 	struct rte_mempool *mb_pool;
 	void *buffer;
-	uint8_t refcnt;
+	uint32_t refcnt;
 	uint32_t max_xsks;
 };
 
@@ -109,6 +109,7 @@ struct pkt_rx_queue {
 	struct pollfd fds[1];
 	int xsk_queue_idx;
 	int busy_budget;
+	bool sg;
 };
 
 struct tx_stats {
@@ -125,6 +126,8 @@ struct pkt_tx_queue {
 
 	struct pkt_rx_queue *pair;
 	int xsk_queue_idx;
+	bool sg;
+	bool fast_free; /* DEV_TX_OFFLOAD_MBUF_FAST_FREE */
 };
 
 struct pmd_internals {
@@ -257,6 +260,122 @@ reserve_fill_queue(struct xsk_umem_info *umem, uint16_t reserve_size,
 }
 
 #if defined(XDP_UMEM_UNALIGNED_CHUNK_FLAG)
+static inline void
+af_xdp_rx_zc_wakeup(struct pkt_rx_queue *rxq)
+{
+	/* we can assume a kernel >= 5.11 is in use if busy polling is
+	 * enabled and thus we can safely use the recvfrom() syscall
+	 * which is only supported for AF_XDP sockets in kernels >=
+	 * 5.11.
+	 */
+	if (rxq->busy_budget) {
+		(void)recvfrom(xsk_socket__fd(rxq->xsk), NULL, 0,
+			       MSG_DONTWAIT, NULL, NULL);
+	} else if (xsk_ring_prod__needs_wakeup(&rxq->fq)) {
+		(void)poll(&rxq->fds[0], 1, 1000);
+	}
+}
+
+static inline struct rte_mbuf *
+af_xdp_rx_zc_mbuf(struct xsk_umem_info *umem, const struct xdp_desc *desc)
+{
+	struct rte_mbuf *mbuf;
+	uint64_t addr, offset;
+
+	offset = xsk_umem__extract_offset(desc->addr);
+	addr = xsk_umem__extract_addr(desc->addr);
+
+	mbuf = (struct rte_mbuf *)xsk_umem__get_data(umem->buffer,
+			addr + umem->mb_pool->header_size);
+	mbuf->data_off = offset - sizeof(struct rte_mbuf) -
+		rte_pktmbuf_priv_size(umem->mb_pool) -
+		umem->mb_pool->header_size;
+	rte_pktmbuf_pkt_len(mbuf) = desc->len;
+	rte_pktmbuf_data_len(mbuf) = desc->len;
+
+	return mbuf;
+}
+
+#if defined(ETH_AF_XDP_MULTI_BUFFER)
+/* Receive the frames made of several UMEM buffers, whose descriptors but
+ * the last one are flagged with XDP_PKT_CONTD, as chained mbufs. The fill
+ * queue is refilled with as many buffers as descriptors consumed.
+ */
+static uint16_t
+af_xdp_rx_zc_sg(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
+{
+	struct pkt_rx_queue *rxq = queue;
+	struct xsk_ring_cons *rx = &rxq->rx;
+	struct xsk_ring_prod *fq = &rxq->fq;
+	struct xsk_umem_info *umem = rxq->umem;
+	struct rte_mbuf *fq_bufs[ETH_AF_XDP_RX_BATCH_SIZE];
+	struct rte_mbuf *head = NULL, *last = NULL, *mbuf;
+	const struct xdp_desc *desc;
+	uint32_t idx_rx = 0, nb_descs, nb_used = 0, i;
+	unsigned long rx_bytes = 0;
+	uint16_t nb_rx = 0;
+
+	nb_descs = xsk_ring_cons__peek(rx, ETH_AF_XDP_RX_BATCH_SIZE, &idx_rx);
+	if (nb_descs == 0) {
+		af_xdp_rx_zc_wakeup(rxq);
+		return 0;
+	}
+
+	/* Only consume the descriptors of the first nb_pkts complete frames,
+	 * the others are left for the next burst.
+	 */
+	for (i = 0; i < nb_descs && nb_rx < nb_pkts; i++) {
+		desc = xsk_ring_cons__rx_desc(rx, idx_rx + i);
+		if (!(desc->options & XDP_PKT_CONTD)) {
+			nb_used = i + 1;
+			nb_rx++;
+		}
+	}
+	rx->cached_cons -= nb_descs - nb_used;
+	if (nb_used == 0)
+		return 0;
+
+	/* allocate bufs for fill queue replenishment after rx */
+	if (rte_pktmbuf_alloc_bulk(umem->mb_pool, fq_bufs, nb_used)) {
+		AF_XDP_LOG(DEBUG,
+			"Failed to get enough buffers for fq.\n");
+		rx->cached_cons -= nb_used;
+		return 0;
+	}
+
+	nb_rx = 0;
+	for (i = 0; i < nb_used; i++) {
+		desc = xsk_ring_cons__rx_desc(rx, idx_rx++);
+		mbuf = af_xdp_rx_zc_mbuf(umem, desc);
+		rx_bytes += desc->len;
+
+		if (head == NULL) {
+			head = mbuf;
+		} else {
+			last->next = mbuf;
+			head->nb_segs++;
+			head->pkt_len += desc->len;
+		}
+		last = mbuf;
+
+		if (desc->options & XDP_PKT_CONTD)
+			continue;
+
+		bufs[nb_rx++] = head;
+		head = NULL;
+	}
+
+	xsk_ring_cons__release(rx, nb_used);
+	(void)reserve_fill_queue(umem, nb_used, fq_bufs, fq);
+
+	/* statistics */
+	rxq->stats.rx_pkts += nb_rx;
+	rxq->stats.rx_bytes += rx_bytes;
+
+	return nb_rx;
+}
+#endif
+
 static uint16_t
 af_xdp_rx_zc(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 {
@@ -272,18 +391,7 @@ af_xdp_rx_zc(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 	nb_pkts = xsk_ring_cons__peek(rx, nb_pkts, &idx_rx);
 
 	if (nb_pkts == 0) {
-		/* we can assume a kernel >= 5.11 is in use if busy polling is
-		 * enabled and thus we can safely use the recvfrom() syscall
-		 * which is only supported for AF_XDP sockets in kernels >=
-		 * 5.11.
-		 */
-		if (rxq->busy_budget) {
-			(void)recvfrom(xsk_socket__fd(rxq->xsk), NULL, 0,
-				       MSG_DONTWAIT, NULL, NULL);
-		} else if (xsk_ring_prod__needs_wakeup(fq)) {
-			(void)poll(&rxq->fds[0], 1, 1000);
-		}
-
+		af_xdp_rx_zc_wakeup(rxq);
 		return 0;
 	}
 
@@ -300,27 +408,10 @@ af_xdp_rx_zc(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 
 	for (i = 0; i < nb_pkts; i++) {
 		const struct xdp_desc *desc;
-		uint64_t addr;
-		uint32_t len;
-		uint64_t offset;
 
 		desc = xsk_ring_cons__rx_desc(rx, idx_rx++);
-		addr = desc->addr;
-		len = desc->len;
-
-		offset = xsk_umem__extract_offset(addr);
-		addr = xsk_umem__extract_addr(addr);
-
-		bufs[i] = (struct rte_mbuf *)
-				xsk_umem__get_data(umem->buffer, addr +
-					umem->mb_pool->header_size);
-		bufs[i]->data_off = offset - sizeof(struct rte_mbuf) -
-			rte_pktmbuf_priv_size(umem->mb_pool) -
-			umem->mb_pool->header_size;
-
-		rte_pktmbuf_pkt_len(bufs[i]) = len;
-		rte_pktmbuf_data_len(bufs[i]) = len;
-		rx_bytes += len;
+		bufs[i] = af_xdp_rx_zc_mbuf(umem, desc);
+		rx_bytes += desc->len;
 	}
 
 	xsk_ring_cons__release(rx, nb_pkts);
@@ -399,6 +490,12 @@ static uint16_t
 af_xdp_rx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 {
 #if defined(XDP_UMEM_UNALIGNED_CHUNK_FLAG)
+#if defined(ETH_AF_XDP_MULTI_BUFFER)
+	struct pkt_rx_queue *rxq = queue;
+
+	if (rxq->sg)
+		return af_xdp_rx_zc_sg(queue, bufs, nb_pkts);
+#endif
 	return af_xdp_rx_zc(queue, bufs, nb_pkts);
 #else
 	return af_xdp_rx_cp(queue, bufs, nb_pkts);
@@ -478,6 +575,90 @@ kick_tx(struct pkt_tx_queue *txq, struct xsk_ring_cons *cq)
 }
 
 #if defined(XDP_UMEM_UNALIGNED_CHUNK_FLAG)
+static inline void
+af_xdp_tx_zc_desc_fill(struct xsk_umem_info *umem, struct xdp_desc *desc,
+		       struct rte_mbuf *mbuf)
+{
+	uint64_t addr, offset;
+
+	addr = (uint64_t)mbuf - (uint64_t)umem->buffer -
+			umem->mb_pool->header_size;
+	offset = rte_pktmbuf_mtod(mbuf, uint64_t) - (uint64_t)mbuf +
+			umem->mb_pool->header_size;
+	offset = offset << XSK_UNALIGNED_BUF_OFFSET_SHIFT;
+	desc->addr = addr | offset;
+	desc->len = mbuf->data_len;
+}
+
+#if defined(ETH_AF_XDP_MULTI_BUFFER)
+/* Put each segment of a chained mbuf in a Tx descriptor, all but the last
+ * one flagged with XDP_PKT_CONTD. The segments are unchained since each one
+ * is freed on its own completion, those not from the UMEM are copied first.
+ */
+static int
+af_xdp_tx_zc_segs(struct pkt_tx_queue *txq, struct rte_mbuf *mbuf,
+		  struct xsk_ring_cons *cq)
+{
+	struct xsk_umem_info *umem = txq->umem;
+	uint16_t nb_segs = mbuf->nb_segs;
+	struct rte_mbuf *segs[nb_segs];
+	struct rte_mbuf *seg, *next;
+	struct xdp_desc *desc;
+	uint32_t idx_tx;
+	uint16_t i, j;
+
+	for (i = 0, seg = mbuf; i < nb_segs; i++, seg = seg->next) {
+		if (seg->pool == umem->mb_pool) {
+			segs[i] = seg;
+			continue;
+		}
+
+		segs[i] = rte_pktmbuf_alloc(umem->mb_pool);
+		if (segs[i] == NULL)
+			goto err;
+		if (rte_pktmbuf_tailroom(segs[i]) < seg->data_len) {
+			rte_pktmbuf_free(segs[i]);
+			goto err;
+		}
+		rte_memcpy(rte_pktmbuf_mtod(segs[i], void *),
+			   rte_pktmbuf_mtod(seg, void *), seg->data_len);
+		segs[i]->data_len = seg->data_len;
+	}
+
+	if (xsk_ring_prod__reserve(&txq->tx, nb_segs, &idx_tx) != nb_segs) {
+		kick_tx(txq, cq);
+		if (xsk_ring_prod__reserve(&txq->tx, nb_segs, &idx_tx) !=
+				nb_segs)
+			goto err;
+	}
+
+	for (i = 0, seg = mbuf; i < nb_segs; i++, seg = next) {
+		next = seg->next;
+
+		desc = xsk_ring_prod__tx_desc(&txq->tx, idx_tx++);
+		af_xdp_tx_zc_desc_fill(umem, desc, segs[i]);
+		desc->options = i + 1 < nb_segs ? XDP_PKT_CONTD : 0;
+
+		if (segs[i] != seg) {
+			rte_pktmbuf_free_seg(seg);
+		} else {
+			seg->next = NULL;
+			seg->nb_segs = 1;
+		}
+	}
+
+	return nb_segs;
+
+err:
+	/* Free the copies made so far, the packet is left untouched */
+	for (j = 0, seg = mbuf; j < i; j++, seg = seg->next)
+		if (segs[j] != seg)
+			rte_pktmbuf_free(segs[j]);
+
+	return -1;
+}
+#endif
+
 static uint16_t
 af_xdp_tx_zc(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 {
@@ -488,6 +669,7 @@ af_xdp_tx_zc(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 	int i;
 	uint32_t idx_tx;
 	uint16_t count = 0;
+	uint32_t nb_descs = 0;
 	struct xdp_desc *desc;
 	uint64_t addr, offset;
 	struct xsk_ring_cons *cq = &txq->pair->cq;
@@ -499,6 +681,21 @@ af_xdp_tx_zc(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 	for (i = 0; i < nb_pkts; i++) {
 		mbuf = bufs[i];
 
+#if defined(ETH_AF_XDP_MULTI_BUFFER)
+		if (mbuf->nb_segs > 1 && txq->sg) {
+			uint32_t pkt_len = mbuf->pkt_len;
+			int ret;
+
+			ret = af_xdp_tx_zc_segs(txq, mbuf, cq);
+			if (ret < 0)
+				goto out;
+			nb_descs += ret;
+			count++;
+			tx_bytes += pkt_len;
+			continue;
+		}
+#endif
+
 		if (mbuf->pool == umem->mb_pool) {
 			if (!xsk_ring_prod__reserve(&txq->tx, 1, &idx_tx)) {
 				kick_tx(txq, cq);
@@ -507,14 +704,10 @@ af_xdp_tx_zc(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 					goto out;
 			}
 			desc = xsk_ring_prod__tx_desc(&txq->tx, idx_tx);
+			af_xdp_tx_zc_desc_fill(umem, desc, mbuf);
 			desc->len = mbuf->pkt_len;
-			addr = (uint64_t)mbuf - (uint64_t)umem->buffer -
-					umem->mb_pool->header_size;
-			offset = rte_pktmbuf_mtod(mbuf, uint64_t) -
-					(uint64_t)mbuf +
-					umem->mb_pool->header_size;
-			offset = offset << XSK_UNALIGNED_BUF_OFFSET_SHIFT;
-			desc->addr = addr | offset;
+			desc->options = 0;
+			nb_descs++;
 			count++;
 		} else {
 			struct rte_mbuf *local_mbuf =
@@ -532,6 +725,7 @@ af_xdp_tx_zc(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 
 			desc = xsk_ring_prod__tx_desc(&txq->tx, idx_tx);
 			desc->len = mbuf->pkt_len;
+			desc->options = 0;
 
 			addr = (uint64_t)local_mbuf - (uint64_t)umem->buffer -
 					umem->mb_pool->header_size;
@@ -544,6 +738,7 @@ af_xdp_tx_zc(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 			rte_memcpy(pkt, rte_pktmbuf_mtod(mbuf, void *),
 					desc->len);
 			rte_pktmbuf_free(mbuf);
+			nb_descs++;
 			count++;
 		}
 
@@ -553,7 +748,7 @@ af_xdp_tx_zc(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 	kick_tx(txq, cq);
 
 out:
-	xsk_ring_prod__submit(&txq->tx, count);
+	xsk_ring_prod__submit(&txq->tx, nb_descs);
 
 	txq->stats.tx_pkts += count;
 	txq->stats.tx_bytes += tx_bytes;
@@ -600,9 +795,13 @@ af_xdp_tx_cp(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 					 desc->addr);
 		rte_memcpy(pkt, rte_pktmbuf_mtod(mbuf, void *), desc->len);
 		tx_bytes += mbuf->pkt_len;
-		rte_pktmbuf_free(mbuf);
+		if (!txq->fast_free)
+			rte_pktmbuf_free(mbuf);
 	}
 
+	if (txq->fast_free)
+		rte_pktmbuf_fast_free_bulk(bufs[0]->pool, bufs, nb_pkts);
+
 	xsk_ring_prod__submit(&txq->tx, nb_pkts);
 
 	kick_tx(txq, cq);
@@ -712,7 +911,28 @@ ctx_exists(struct pkt_rx_queue *rxq, const char *ifname,
 	return exists;
 }
 
-/* Get a pointer to an existing UMEM which overlays the rxq's mb_pool */
+/* Take a reference on the UMEM if it is still in use and can take one
+ * more socket.
+ */
+static inline bool
+umem_get_ref(struct xsk_umem_info *umem)
+{
+	uint32_t refcnt = __atomic_load_n(&umem->refcnt, __ATOMIC_ACQUIRE);
+
+	do {
+		if (refcnt == 0 || refcnt >= umem->max_xsks)
+			return false;
+	} while (!__atomic_compare_exchange_n(&umem->refcnt, &refcnt,
+			refcnt + 1, false, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE));
+
+	return true;
+}
+
+/* Get a reference to an existing UMEM which overlays the rxq's mb_pool,
+ * created by a queue of any netdev. The UMEMs which reached their maximum
+ * number of sockets are skipped, a new UMEM is then created on the same
+ * mb_pool, which keeps the mbufs usable without copy across all of them.
+ */
 static inline int
 get_shared_umem(struct pkt_rx_queue *rxq, const char *ifname,
 			struct xsk_umem_info **umem)
@@ -734,23 +954,24 @@ get_shared_umem(struct pkt_rx_queue *rxq, const char *ifname,
 						&internals->rx_queues[i];
 			if (rxq == list_rxq)
 				continue;
-			if (mb_pool == internals->rx_queues[i].mb_pool) {
+			if (mb_pool == list_rxq->mb_pool) {
 				if (ctx_exists(rxq, ifname, list_rxq,
 						internals->if_name)) {
 					ret = -1;
 					goto out;
 				}
-				if (__atomic_load_n(
-					&internals->rx_queues[i].umem->refcnt,
-							__ATOMIC_ACQUIRE)) {
-					*umem = internals->rx_queues[i].umem;
-					goto out;
-				}
+				if (*umem == NULL && list_rxq->umem != NULL &&
+						umem_get_ref(list_rxq->umem))
+					*umem = list_rxq->umem;
 			}
 		}
 	}
 
 out:
+	if (ret < 0 && *umem != NULL) {
+		__atomic_sub_fetch(&(*umem)->refcnt, 1, __ATOMIC_RELEASE);
+		*umem = NULL;
+	}
 	pthread_mutex_unlock(&internal_list_lock);
 
 	return ret;
@@ -788,6 +1009,19 @@ eth_dev_configure(struct rte_eth_dev *dev)
 	return 0;
 }
 
+/* Largest MTU of the frames fitting in a single UMEM buffer */
+static uint16_t
+eth_af_xdp_frame_mtu(void)
+{
+#if defined(XDP_UMEM_UNALIGNED_CHUNK_FLAG)
+	return getpagesize() - sizeof(struct rte_mempool_objhdr) -
+		sizeof(struct rte_mbuf) - RTE_PKTMBUF_HEADROOM -
+		XDP_PACKET_HEADROOM;
+#else
+	return ETH_AF_XDP_FRAME_SIZE - XDP_PACKET_HEADROOM;
+#endif
+}
+
 static int
 eth_dev_info(struct rte_eth_dev *dev, struct rte_eth_dev_info *dev_info)
 {
@@ -800,14 +1034,17 @@ eth_dev_info(struct rte_eth_dev *dev, struct rte_eth_dev_info *dev_info)
 	dev_info->max_tx_queues = internals->queue_cnt;
 
 	dev_info->min_mtu = RTE_ETHER_MIN_MTU;
-#if defined(XDP_UMEM_UNALIGNED_CHUNK_FLAG)
-	dev_info->max_mtu = getpagesize() -
-				sizeof(struct rte_mempool_objhdr) -
-				sizeof(struct rte_mbuf) -
-				RTE_PKTMBUF_HEADROOM - XDP_PACKET_HEADROOM;
+#if defined(ETH_AF_XDP_MULTI_BUFFER)
+	/* Frames larger than a UMEM buffer are received as chained mbufs */
+	dev_info->max_rx_pktlen = RTE_ETHER_MAX_JUMBO_FRAME_LEN;
+	dev_info->max_mtu = RTE_ETHER_MAX_JUMBO_FRAME_LEN - RTE_ETHER_HDR_LEN;
+	dev_info->rx_offload_capa = DEV_RX_OFFLOAD_SCATTER |
+				    DEV_RX_OFFLOAD_JUMBO_FRAME;
+	dev_info->tx_offload_capa = DEV_TX_OFFLOAD_MULTI_SEGS;
 #else
-	dev_info->max_mtu = ETH_AF_XDP_FRAME_SIZE - XDP_PACKET_HEADROOM;
+	dev_info->max_mtu = eth_af_xdp_frame_mtu();
 #endif
+	dev_info->tx_offload_capa |= DEV_TX_OFFLOAD_MBUF_FAST_FREE;
 
 	dev_info->default_rxportconf.burst_size = ETH_AF_XDP_DFLT_BUSY_BUDGET;
 	dev_info->default_txportconf.burst_size = ETH_AF_XDP_DFLT_BUSY_BUDGET;
@@ -1002,13 +1239,9 @@ xsk_umem_info *xdp_umem_configure(struct pmd_internals *internals,
 		if (get_shared_umem(rxq, internals->if_name, &umem) < 0)
 			return NULL;
 
-		if (umem != NULL &&
-			__atomic_load_n(&umem->refcnt, __ATOMIC_ACQUIRE) <
-					umem->max_xsks) {
+		if (umem != NULL)
 			AF_XDP_LOG(INFO, "%s,qid%i sharing UMEM\n",
 					internals->if_name, rxq->xsk_queue_idx);
-			__atomic_fetch_add(&umem->refcnt, 1, __ATOMIC_ACQUIRE);
-		}
 	}
 
 	if (umem == NULL) {
@@ -1021,7 +1254,7 @@ xsk_umem_info *xdp_umem_configure(struct pmd_internals *internals,
 						RTE_PKTMBUF_HEADROOM;
 
 		umem = rte_zmalloc_socket("umem", sizeof(*umem), 0,
-					  rte_socket_id());
+					  mb_pool->socket_id);
 		if (umem == NULL) {
 			AF_XDP_LOG(ERR, "Failed to allocate umem info");
 			return NULL;
@@ -1241,6 +1474,10 @@ xsk_configure(struct pmd_internals *internals, struct pkt_rx_queue *rxq,
 #if defined(XDP_USE_NEED_WAKEUP)
 	cfg.bind_flags |= XDP_USE_NEED_WAKEUP;
 #endif
+#if defined(ETH_AF_XDP_MULTI_BUFFER)
+	if (rxq->sg)
+		cfg.bind_flags |= XDP_USE_SG;
+#endif
 
 	if (strnlen(internals->prog_path, PATH_MAX) &&
 				!internals->custom_prog_configured) {
@@ -1334,6 +1571,14 @@ eth_rx_queue_setup(struct rte_eth_dev *dev,
 #endif
 
 	rxq->mb_pool = mb_pool;
+#if defined(ETH_AF_XDP_MULTI_BUFFER)
+	/* The socket is shared by the Rx and Tx queues of the pair */
+	rxq->sg = !!(dev->data->dev_conf.rxmode.offloads &
+			DEV_RX_OFFLOAD_SCATTER) ||
+		  !!(dev->data->dev_conf.txmode.offloads &
+			DEV_TX_OFFLOAD_MULTI_SEGS);
+	rxq->pair->sg = rxq->sg;
+#endif
 
 	if (xsk_configure(internals, rxq, nb_rx_desc)) {
 		AF_XDP_LOG(ERR, "Failed to configure xdp socket\n");
@@ -1365,6 +1610,8 @@ eth_tx_queue_setup(struct rte_eth_dev *dev,
 	struct pkt_tx_queue *txq;
 
 	txq = &internals->tx_queues[tx_queue_id];
+	txq->fast_free = !!(dev->data->dev_conf.txmode.offloads &
+			DEV_TX_OFFLOAD_MBUF_FAST_FREE);
 
 	dev->data->tx_queues[tx_queue_id] = txq;
 	return 0;
@@ -1378,6 +1625,12 @@ eth_dev_mtu_set(struct rte_eth_dev *dev, uint16_t mtu)
 	int ret;
 	int s;
 
+	if (mtu > eth_af_xdp_frame_mtu() &&
+	    !(dev->data->dev_conf.rxmode.offloads & DEV_RX_OFFLOAD_SCATTER)) {
+		AF_XDP_LOG(ERR, "MTU %u needs the Rx scatter offload\n", mtu);
+		return -EINVAL;
+	}
+
 	s = socket(PF_INET, SOCK_DGRAM, 0);
 	if (s < 0)
 		return -EINVAL;
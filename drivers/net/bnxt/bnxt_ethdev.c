@@ -1529,6 +1529,8 @@ static int bnxt_dev_start_op(struct rte_eth_dev *eth_dev)
 
 	eth_dev->rx_pkt_burst = bnxt_receive_function(eth_dev);
 	eth_dev->tx_pkt_burst = bnxt_transmit_function(eth_dev);
+	/* no-op unless restarting a running port after error recovery */
+	rte_eth_fp_ops_update(eth_dev);
 
 	bnxt_schedule_fw_health_check(bp);
 
@@ -1455,6 +1455,7 @@ bnxt_validate_and_parse_flow(struct rte_eth_dev *dev,
 			PMD_DRV_LOG(DEBUG,
 				    "Disabling vector processing for mark\n");
 			bp->eth_dev->rx_pkt_burst = bnxt_recv_pkts;
+			rte_eth_fp_ops_update(bp->eth_dev);
 			bp->flags &= ~BNXT_FLAG_RX_VECTOR_PKT_MODE;
 		}
 
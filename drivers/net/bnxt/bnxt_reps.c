@@ -57,6 +57,8 @@ bnxt_vfr_recv(uint16_t port_id, uint16_t queue_id, struct rte_mbuf *mbuf)
 	/* Put this mbuf on the RxQ of the Representor */
 	prod_rx_buf = &rep_rxr->rx_buf_ring[rep_rxr->rx_raw_prod & mask];
 	if (*prod_rx_buf == NULL) {
+		/* The Rx queue may be shared with other representors */
+		mbuf->port = port_id;
 		*prod_rx_buf = mbuf;
 		vfr_bp->rx_bytes[que] += mbuf->pkt_len;
 		vfr_bp->rx_pkts[que]++;
@@ -92,7 +94,6 @@ bnxt_rep_rx_burst(void *rx_queue,
 		if (*cons_rx_buf == NULL)
 			return nb_rx_pkts;
 		rx_pkts[nb_rx_pkts] = *cons_rx_buf;
-		rx_pkts[nb_rx_pkts]->port = rxq->port_id;
 		*cons_rx_buf = NULL;
 		nb_rx_pkts++;
 		rxr->rx_cons++;
@@ -392,6 +393,9 @@ static void bnxt_rep_free_rx_mbufs(struct bnxt_representor *rep_bp)
 
 	for (i = 0; i < rep_bp->rx_nr_rings; i++) {
 		rxq = rep_bp->rx_queues[i];
+		/* Still used by the other representors of its share group */
+		if (rxq && rxq->share_refcnt > 1)
+			continue;
 		bnxt_rx_queue_release_mbufs(rxq);
 	}
 }
@@ -539,6 +543,7 @@ int bnxt_rep_dev_info_get_op(struct rte_eth_dev *eth_dev,
 		dev_info->rx_offload_capa |= DEV_RX_OFFLOAD_TIMESTAMP;
 	dev_info->tx_offload_capa = BNXT_DEV_TX_OFFLOAD_SUPPORT;
 	dev_info->flow_type_rss_offloads = BNXT_ETH_RSS_SUPPORT;
+	dev_info->dev_capa = RTE_ETH_DEV_CAPA_RXQ_SHARE;
 
 	dev_info->switch_info.name = eth_dev->device->name;
 	dev_info->switch_info.domain_id = rep_bp->switch_domain_id;
@@ -585,11 +590,38 @@ static int bnxt_init_rep_rx_ring(struct bnxt_rx_queue *rxq,
 	return 0;
 }
 
+/*
+ * Find the Rx queue of the share group set up by another representor of the
+ * same parent.
+ */
+static struct bnxt_rx_queue *
+bnxt_rep_shared_rxq_find(struct bnxt *parent_bp, uint16_t share_group,
+			 uint16_t share_qid)
+{
+	struct rte_eth_dev *vfr_eth_dev;
+	struct bnxt_rx_queue *rxq;
+	unsigned int i, q;
+
+	for (i = 0; i < BNXT_MAX_VF_REPS; i++) {
+		vfr_eth_dev = parent_bp->rep_info[i].vfr_eth_dev;
+		if (!vfr_eth_dev || !vfr_eth_dev->data->rx_queues)
+			continue;
+		for (q = 0; q < vfr_eth_dev->data->nb_rx_queues; q++) {
+			rxq = vfr_eth_dev->data->rx_queues[q];
+			if (rxq && rxq->share_group == share_group &&
+			    rxq->share_qid == share_qid)
+				return rxq;
+		}
+	}
+
+	return NULL;
+}
+
 int bnxt_rep_rx_queue_setup_op(struct rte_eth_dev *eth_dev,
 			       uint16_t queue_idx,
 			       uint16_t nb_desc,
 			       unsigned int socket_id,
-			       __rte_unused const struct rte_eth_rxconf *rx_conf,
+			       const struct rte_eth_rxconf *rx_conf,
 			       __rte_unused struct rte_mempool *mp)
 {
 	struct bnxt_representor *rep_bp = eth_dev->data->dev_private;
@@ -630,7 +662,30 @@ int bnxt_rep_rx_queue_setup_op(struct rte_eth_dev *eth_dev,
 	if (eth_dev->data->rx_queues) {
 		rxq = eth_dev->data->rx_queues[queue_idx];
 		if (rxq)
-			bnxt_rx_queue_release_op(rxq);
+			bnxt_rep_rx_queue_release_op(rxq);
+	}
+
+	if (rx_conf->share_group > 0) {
+		rxq = bnxt_rep_shared_rxq_find(parent_bp, rx_conf->share_group,
+					       rx_conf->share_qid);
+		if (rxq) {
+			/*
+			 * The shared queue is filled from the parent Rx queue
+			 * of the same index, keep a single producer.
+			 */
+			if (rxq->queue_id != queue_idx ||
+			    rxq->nb_rx_desc != nb_desc) {
+				PMD_DRV_LOG(ERR,
+					    "Shared RxQ %d:%d set up with queue %d and %d desc\n",
+					    rx_conf->share_group,
+					    rx_conf->share_qid, rxq->queue_id,
+					    rxq->nb_rx_desc);
+				return -EINVAL;
+			}
+			rxq->share_refcnt++;
+			eth_dev->data->rx_queues[queue_idx] = rxq;
+			return 0;
+		}
 	}
 
 	rxq = rte_zmalloc_socket("bnxt_vfr_rx_queue",
@@ -660,6 +715,9 @@ int bnxt_rep_rx_queue_setup_op(struct rte_eth_dev *eth_dev,
 	rxq->rx_ring->rx_buf_ring = buf_ring;
 	rxq->queue_id = queue_idx;
 	rxq->port_id = eth_dev->data->port_id;
+	rxq->share_group = rx_conf->share_group;
+	rxq->share_qid = rx_conf->share_qid;
+	rxq->share_refcnt = 1;
 	eth_dev->data->rx_queues[queue_idx] = rxq;
 
 	return 0;
@@ -678,6 +736,11 @@ void bnxt_rep_rx_queue_release_op(void *rx_queue)
 	if (!rxq)
 		return;
 
+	if (rxq->share_refcnt > 1) {
+		rxq->share_refcnt--;
+		return;
+	}
+
 	bnxt_rx_queue_release_mbufs(rxq);
 
 	bnxt_free_ring(rxq->rx_ring->rx_ring_struct);
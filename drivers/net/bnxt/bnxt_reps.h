@@ -33,7 +33,7 @@ int bnxt_rep_rx_queue_setup_op(struct rte_eth_dev *eth_dev,
 				  __rte_unused uint16_t queue_idx,
 				  __rte_unused uint16_t nb_desc,
 				  __rte_unused unsigned int socket_id,
-				  __rte_unused const struct rte_eth_rxconf *
+				  const struct rte_eth_rxconf *
 				  rx_conf,
 				  __rte_unused struct rte_mempool *mp);
 int bnxt_rep_tx_queue_setup_op(struct rte_eth_dev *eth_dev,
@@ -41,6 +41,11 @@ struct bnxt_rx_queue {
 	struct rte_mbuf			fake_mbuf;
 	rte_atomic64_t		rx_mbuf_alloc_fail;
 	const struct rte_memzone *mz;
+
+	/* Representor Rx queue shared by the ports of a share group */
+	uint16_t		share_group;
+	uint16_t		share_qid;
+	uint32_t		share_refcnt;
 };
 
 void bnxt_free_rxq_stats(struct bnxt_rx_queue *rxq);
@@ -6,11 +6,15 @@
 #define _ETH_BOND_8023AD_PRIVATE_H_
 
 #include <stdint.h>
+#include <string.h>
 
 #include <rte_ether.h>
 #include <rte_byteorder.h>
 #include <rte_atomic.h>
+#include <rte_branch_prediction.h>
 #include <rte_flow.h>
+#include <rte_pause.h>
+#include <rte_spinlock.h>
 
 #include "rte_eth_bond_8023ad.h"
 
@@ -178,6 +182,17 @@ struct mode8023ad_private {
 		uint16_t tx_qid;
 	} dedicated_queues;
 	enum rte_bond_8023ad_agg_selection agg_selection;
+
+	/**
+	 * Active slaves in DISTRIBUTING state, read without lock by the Tx
+	 * path and updated by the state machines.
+	 */
+	struct {
+		uint32_t seq;	/**< Update sequence, odd while updating */
+		uint16_t count;	/**< Number of distributing slaves */
+		uint16_t slaves[RTE_MAX_ETHPORTS];
+		rte_spinlock_t lock;	/**< Serializes the updates */
+	} dist;
 };
 
 /**
@@ -251,6 +266,49 @@ bond_mode_8023ad_start(struct rte_eth_dev *dev);
 void
 bond_mode_8023ad_stop(struct rte_eth_dev *dev);
 
+/**
+ * @internal
+ *
+ * Update the snapshot of the distributing slaves read by the Tx path.
+ * Must be called after a change of the active slaves or of their
+ * DISTRIBUTING state.
+ *
+ * @param internals Bonded device private data.
+ */
+void
+bond_mode_8023ad_dist_update(struct bond_dev_private *internals);
+
+/**
+ * @internal
+ *
+ * Copy the distributing slaves without locking. The copy is retried if
+ * the snapshot is updated meanwhile, which only happens on state changes.
+ *
+ * @param mode4 Mode 4 private data.
+ * @param slaves Array of RTE_MAX_ETHPORTS entries receiving the slaves.
+ * @return
+ *   Number of distributing slaves.
+ */
+static inline uint16_t
+bond_mode_8023ad_dist_get(const struct mode8023ad_private *mode4,
+		uint16_t *slaves)
+{
+	uint32_t seq;
+	uint16_t count;
+
+	for (;;) {
+		seq = __atomic_load_n(&mode4->dist.seq, __ATOMIC_ACQUIRE);
+		count = __atomic_load_n(&mode4->dist.count, __ATOMIC_RELAXED);
+		memcpy(slaves, mode4->dist.slaves, count * sizeof(slaves[0]));
+		rte_atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if (likely((seq & 1) == 0 && seq ==
+				__atomic_load_n(&mode4->dist.seq,
+						__ATOMIC_RELAXED)))
+			return count;
+		rte_pause();
+	}
+}
+
 /**
  * @internal
  *
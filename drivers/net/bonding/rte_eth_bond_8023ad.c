@@ -946,10 +946,45 @@ bond_mode_8023ad_periodic_cb(void *arg)
 		show_warnings(slave_id);
 	}
 
+	bond_mode_8023ad_dist_update(internals);
+
 	rte_eal_alarm_set(internals->mode4.update_timeout_us,
 			bond_mode_8023ad_periodic_cb, arg);
 }
 
+void
+bond_mode_8023ad_dist_update(struct bond_dev_private *internals)
+{
+	struct mode8023ad_private *mode4 = &internals->mode4;
+	uint16_t slaves[RTE_MAX_ETHPORTS];
+	uint16_t count = 0;
+	uint16_t slave_id;
+	uint16_t i;
+
+	rte_spinlock_lock(&mode4->dist.lock);
+
+	for (i = 0; i < internals->active_slave_count; i++) {
+		slave_id = internals->active_slaves[i];
+		if (ACTOR_STATE(&bond_mode_8023ad_ports[slave_id],
+				DISTRIBUTING))
+			slaves[count++] = slave_id;
+	}
+
+	/* Leave the readers alone if nothing changed */
+	if (count != mode4->dist.count ||
+	    memcmp(slaves, mode4->dist.slaves, count * sizeof(slaves[0]))) {
+		__atomic_store_n(&mode4->dist.seq, mode4->dist.seq + 1,
+				__ATOMIC_RELAXED);
+		rte_atomic_thread_fence(__ATOMIC_RELEASE);
+		memcpy(mode4->dist.slaves, slaves, count * sizeof(slaves[0]));
+		__atomic_store_n(&mode4->dist.count, count, __ATOMIC_RELAXED);
+		__atomic_store_n(&mode4->dist.seq, mode4->dist.seq + 1,
+				__ATOMIC_RELEASE);
+	}
+
+	rte_spinlock_unlock(&mode4->dist.lock);
+}
+
 static int
 bond_mode_8023ad_register_lacp_mac(uint16_t slave_id)
 {
@@ -1275,6 +1310,7 @@ bond_mode_8023ad_enable(struct rte_eth_dev *bond_dev)
 	for (i = 0; i < internals->active_slave_count; i++)
 		bond_mode_8023ad_activate_slave(bond_dev,
 				internals->active_slaves[i]);
+	bond_mode_8023ad_dist_update(internals);
 
 	return 0;
 }
@@ -1597,6 +1633,9 @@ rte_eth_bond_8023ad_ext_distrib(uint16_t port_id, uint16_t slave_id,
 	else
 		ACTOR_STATE_CLR(port, DISTRIBUTING);
 
+	bond_mode_8023ad_dist_update(
+			rte_eth_devices[port_id].data->dev_private);
+
 	return 0;
 }
 
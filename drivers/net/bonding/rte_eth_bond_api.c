@@ -99,6 +99,8 @@ activate_slave(struct rte_eth_dev *eth_dev, uint16_t port_id)
 	internals->active_slaves[internals->active_slave_count] = port_id;
 	internals->active_slave_count++;
 
+	if (internals->mode == BONDING_MODE_8023AD)
+		bond_mode_8023ad_dist_update(internals);
 	if (internals->mode == BONDING_MODE_TLB)
 		bond_tlb_activate_slave(internals);
 	if (internals->mode == BONDING_MODE_ALB)
@@ -135,6 +137,9 @@ deactivate_slave(struct rte_eth_dev *eth_dev, uint16_t port_id)
 	RTE_ASSERT(active_count < RTE_DIM(internals->active_slaves));
 	internals->active_slave_count = active_count;
 
+	if (internals->mode == BONDING_MODE_8023AD)
+		bond_mode_8023ad_dist_update(internals);
+
 	if (eth_dev->data->dev_started) {
 		if (internals->mode == BONDING_MODE_8023AD) {
 			bond_mode_8023ad_start(eth_dev);
@@ -18,6 +18,8 @@
 #include <rte_bus_vdev.h>
 #include <rte_alarm.h>
 #include <rte_cycles.h>
+#include <rte_prefetch.h>
+#include <rte_reciprocal.h>
 #include <rte_string_fns.h>
 
 #include "rte_eth_bond.h"
@@ -676,22 +678,54 @@ ipv6_hash(struct rte_ipv6_hdr *ipv6_hdr)
 			(word_src_addr[3] ^ word_dst_addr[3]);
 }
 
+/* Number of packets whose headers are prefetched ahead of the hashing */
+#define BOND_HASH_PREFETCH_OFFSET 4
+
+static inline void
+hash_prefetch(struct rte_mbuf **buf, uint16_t nb_pkts, uint16_t i)
+{
+	if (i + BOND_HASH_PREFETCH_OFFSET < nb_pkts)
+		rte_prefetch0(rte_pktmbuf_mtod(buf[i + BOND_HASH_PREFETCH_OFFSET],
+				void *));
+}
+
+/*
+ * Map the packet hashes to slave indexes. The modulo is computed with the
+ * reciprocal of the slave count rather than a division per packet, and
+ * the loop does not touch the packets so that it can be vectorized.
+ */
+static inline void
+hash_to_slaves(const uint32_t *hash, uint16_t nb_pkts, uint16_t slave_count,
+		uint16_t *slaves)
+{
+	struct rte_reciprocal r = rte_reciprocal_value(slave_count);
+	uint16_t i;
+
+	for (i = 0; i < nb_pkts; i++)
+		slaves[i] = hash[i] -
+			rte_reciprocal_divide(hash[i], r) * slave_count;
+}
 
 void
 burst_xmit_l2_hash(struct rte_mbuf **buf, uint16_t nb_pkts,
 		uint16_t slave_count, uint16_t *slaves)
 {
 	struct rte_ether_hdr *eth_hdr;
-	uint32_t hash;
-	int i;
+	uint32_t hash[nb_pkts];
+	uint16_t i;
+
+	for (i = 0; i < RTE_MIN(nb_pkts, BOND_HASH_PREFETCH_OFFSET); i++)
+		rte_prefetch0(rte_pktmbuf_mtod(buf[i], void *));
 
 	for (i = 0; i < nb_pkts; i++) {
+		hash_prefetch(buf, nb_pkts, i);
 		eth_hdr = rte_pktmbuf_mtod(buf[i], struct rte_ether_hdr *);
 
-		hash = ether_hash(eth_hdr);
-
-		slaves[i] = (hash ^= hash >> 8) % slave_count;
+		hash[i] = ether_hash(eth_hdr);
+		hash[i] ^= hash[i] >> 8;
 	}
+
+	hash_to_slaves(hash, nb_pkts, slave_count, slaves);
 }
 
 void
@@ -703,8 +737,13 @@ burst_xmit_l23_hash(struct rte_mbuf **buf, uint16_t nb_pkts,
 	uint16_t proto;
 	size_t vlan_offset;
 	uint32_t hash, l3hash;
+	uint32_t hashes[nb_pkts];
+
+	for (i = 0; i < RTE_MIN(nb_pkts, BOND_HASH_PREFETCH_OFFSET); i++)
+		rte_prefetch0(rte_pktmbuf_mtod(buf[i], void *));
 
 	for (i = 0; i < nb_pkts; i++) {
+		hash_prefetch(buf, nb_pkts, i);
 		eth_hdr = rte_pktmbuf_mtod(buf[i], struct rte_ether_hdr *);
 		l3hash = 0;
 
@@ -728,8 +767,10 @@ burst_xmit_l23_hash(struct rte_mbuf **buf, uint16_t nb_pkts,
 		hash ^= hash >> 16;
 		hash ^= hash >> 8;
 
-		slaves[i] = hash % slave_count;
+		hashes[i] = hash;
 	}
+
+	hash_to_slaves(hashes, nb_pkts, slave_count, slaves);
 }
 
 void
@@ -739,13 +780,18 @@ burst_xmit_l34_hash(struct rte_mbuf **buf, uint16_t nb_pkts,
 	struct rte_ether_hdr *eth_hdr;
 	uint16_t proto;
 	size_t vlan_offset;
-	int i;
+	uint16_t i;
 
 	struct rte_udp_hdr *udp_hdr;
 	struct rte_tcp_hdr *tcp_hdr;
 	uint32_t hash, l3hash, l4hash;
+	uint32_t hashes[nb_pkts];
+
+	for (i = 0; i < RTE_MIN(nb_pkts, BOND_HASH_PREFETCH_OFFSET); i++)
+		rte_prefetch0(rte_pktmbuf_mtod(buf[i], void *));
 
 	for (i = 0; i < nb_pkts; i++) {
+		hash_prefetch(buf, nb_pkts, i);
 		eth_hdr = rte_pktmbuf_mtod(buf[i], struct rte_ether_hdr *);
 		size_t pkt_end = (size_t)eth_hdr + rte_pktmbuf_data_len(buf[i]);
 		proto = eth_hdr->ether_type;
@@ -802,8 +848,10 @@ burst_xmit_l34_hash(struct rte_mbuf **buf, uint16_t nb_pkts,
 		hash ^= hash >> 16;
 		hash ^= hash >> 8;
 
-		slaves[i] = hash % slave_count;
+		hashes[i] = hash;
 	}
+
+	hash_to_slaves(hashes, nb_pkts, slave_count, slaves);
 }
 
 struct bwg_slave {
@@ -1225,6 +1273,9 @@ tx_burst_8023ad(void *queue, struct rte_mbuf **bufs, uint16_t nb_bufs,
 
 	uint16_t i;
 
+	if (dedicated_txq)
+		goto skip_tx_ring;
+
 	/* Copy slave list to protect against slave up/down changes during tx
 	 * bursting */
 	slave_count = internals->active_slave_count;
@@ -1234,9 +1285,6 @@ tx_burst_8023ad(void *queue, struct rte_mbuf **bufs, uint16_t nb_bufs,
 	memcpy(slave_port_ids, internals->active_slaves,
 			sizeof(slave_port_ids[0]) * slave_count);
 
-	if (dedicated_txq)
-		goto skip_tx_ring;
-
 	/* Check for LACP control packets and send if available */
 	for (i = 0; i < slave_count; i++) {
 		struct port *port = &bond_mode_8023ad_ports[slave_port_ids[i]];
@@ -1262,15 +1310,9 @@ tx_burst_8023ad(void *queue, struct rte_mbuf **bufs, uint16_t nb_bufs,
 	if (unlikely(nb_bufs == 0))
 		return 0;
 
-	dist_slave_count = 0;
-	for (i = 0; i < slave_count; i++) {
-		struct port *port = &bond_mode_8023ad_ports[slave_port_ids[i]];
-
-		if (ACTOR_STATE(port, DISTRIBUTING))
-			dist_slave_port_ids[dist_slave_count++] =
-					slave_port_ids[i];
-	}
-
+	/* Snapshot of the distributing slaves, without reading their state */
+	dist_slave_count = bond_mode_8023ad_dist_get(&internals->mode4,
+			dist_slave_port_ids);
 	if (unlikely(dist_slave_count < 1))
 		return 0;
 
@@ -3247,6 +3289,7 @@ bond_alloc(struct rte_vdev_device *dev, uint8_t mode)
 
 	rte_spinlock_init(&internals->lock);
 	rte_spinlock_init(&internals->lsc_lock);
+	rte_spinlock_init(&internals->mode4.dist.lock);
 
 	internals->port_id = eth_dev->data->port_id;
 	internals->mode = BONDING_MODE_INVALID;
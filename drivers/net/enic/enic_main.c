@@ -1671,6 +1671,7 @@ int enic_set_mtu(struct enic *enic, uint16_t new_mtu)
 
 	/* replace Rx function with a no-op to avoid getting stale pkts */
 	eth_dev->rx_pkt_burst = enic_dummy_recv_pkts;
+	rte_eth_fp_ops_update(eth_dev);
 	rte_mb();
 
 	/* Allow time for threads to exit the real Rx function. */
@@ -1705,6 +1706,7 @@ int enic_set_mtu(struct enic *enic, uint16_t new_mtu)
 	/* put back the real receive function */
 	rte_mb();
 	enic_pick_rx_handler(eth_dev);
+	rte_eth_fp_ops_update(eth_dev);
 	rte_mb();
 
 	/* restart Rx traffic */
@@ -343,8 +343,12 @@ fs_dev_stats_save(struct sub_device *sdev)
 static inline int
 fs_rxtx_clean(struct sub_device *sdev)
 {
+	uint64_t grace = FAILSAFE_FAST_BURST_GRACE_MS * rte_get_tsc_hz() / 1000;
 	uint16_t i;
 
+	/* The fast bursts hold no reference, wait for them to return. */
+	if (rte_rdtsc() - PRIV(fs_dev(sdev))->fast_exit_tsc < grace)
+		return 0;
 	for (i = 0; i < ETH(sdev)->data->nb_rx_queues; i++)
 		if (FS_ATOMIC_RX(sdev, i))
 			return 0;
@@ -31,6 +31,12 @@
 	""
 
 #define FAILSAFE_HOTPLUG_DEFAULT_TIMEOUT_MS 2000
+/*
+ * The fast bursts take no reference on the sub-devices: once they are
+ * replaced by the safe ones, the bursts still running are given this
+ * time to return before a sub-device can be removed.
+ */
+#define FAILSAFE_FAST_BURST_GRACE_MS 10
 
 #define FAILSAFE_MAX_ETHPORTS 2
 #define FAILSAFE_MAX_ETHADDR 128
@@ -190,6 +196,8 @@ struct fs_priv {
 	/* Hot-plug mutex is locked by the alarm mechanism. */
 	volatile unsigned int alarm_lock:1;
 	unsigned int pending_alarm:1; /* An alarm is pending */
+	/* TSC when the fast bursts were last replaced by the safe ones */
+	uint64_t fast_exit_tsc;
 	/* flow isolation state */
 	int flow_isolated:1;
 };
@@ -4,6 +4,7 @@
  */
 
 #include <rte_atomic.h>
+#include <rte_cycles.h>
 #include <rte_debug.h>
 #include <rte_mbuf.h>
 #include <ethdev_driver.h>
@@ -35,6 +36,7 @@ failsafe_set_burst_fn(struct rte_eth_dev *dev, int force_safe)
 	uint8_t i;
 	int need_safe;
 	int safe_set;
+	int fast_exit = 0;
 
 	need_safe = force_safe;
 	FOREACH_SUBDEV(sdev, i, dev)
@@ -44,6 +46,7 @@ failsafe_set_burst_fn(struct rte_eth_dev *dev, int force_safe)
 		DEBUG("Using safe RX bursts%s",
 		      (force_safe ? " (forced)" : ""));
 		dev->rx_pkt_burst = &failsafe_rx_burst;
+		fast_exit = 1;
 	} else if (!need_safe && safe_set) {
 		DEBUG("Using fast RX bursts");
 		dev->rx_pkt_burst = &failsafe_rx_burst_fast;
@@ -54,11 +57,16 @@ failsafe_set_burst_fn(struct rte_eth_dev *dev, int force_safe)
 		DEBUG("Using safe TX bursts%s",
 		      (force_safe ? " (forced)" : ""));
 		dev->tx_pkt_burst = &failsafe_tx_burst;
+		fast_exit = 1;
 	} else if (!need_safe && safe_set) {
 		DEBUG("Using fast TX bursts");
 		dev->tx_pkt_burst = &failsafe_tx_burst_fast;
 	}
 	rte_wmb();
+	rte_eth_fp_ops_update(dev);
+	/* Start the grace period of the bursts still in the fast functions */
+	if (fast_exit)
+		PRIV(dev)->fast_exit_tsc = rte_rdtsc();
 }
 
 /*
@@ -108,6 +116,12 @@ failsafe_rx_burst(void *queue,
 	return nb_rx;
 }
 
+/*
+ * The fast bursts are only used while all the sub-devices are started and
+ * none is being removed. They take no reference on the sub-devices, whose
+ * removal waits for FAILSAFE_FAST_BURST_GRACE_MS after the switch to the
+ * safe bursts instead.
+ */
 uint16_t
 failsafe_rx_burst_fast(void *queue,
 			 struct rte_mbuf **rx_pkts,
@@ -123,10 +137,8 @@ failsafe_rx_burst_fast(void *queue,
 	do {
 		RTE_ASSERT(!fs_rx_unsafe(sdev));
 		sub_rxq = ETH(sdev)->data->rx_queues[rxq->qid];
-		FS_ATOMIC_P(rxq->refcnt[sdev->sid]);
 		nb_rx = ETH(sdev)->
 			rx_pkt_burst(sub_rxq, rx_pkts, nb_pkts);
-		FS_ATOMIC_V(rxq->refcnt[sdev->sid]);
 		sdev = sdev->next;
 	} while (nb_rx == 0 && sdev != rxq->sdev);
 	rxq->sdev = sdev;
@@ -163,16 +175,14 @@ failsafe_tx_burst_fast(void *queue,
 			 uint16_t nb_pkts)
 {
 	struct sub_device *sdev;
+	struct fs_priv *priv;
 	struct txq *txq;
 	void *sub_txq;
-	uint16_t nb_tx;
 
 	txq = queue;
-	sdev = TX_SUBDEV(&rte_eth_devices[txq->priv->data->port_id]);
+	priv = txq->priv;
+	sdev = &priv->subs[priv->subs_tx];
 	RTE_ASSERT(!fs_tx_unsafe(sdev));
 	sub_txq = ETH(sdev)->data->tx_queues[txq->qid];
-	FS_ATOMIC_P(txq->refcnt[sdev->sid]);
-	nb_tx = ETH(sdev)->tx_pkt_burst(sub_txq, tx_pkts, nb_pkts);
-	FS_ATOMIC_V(txq->refcnt[sdev->sid]);
-	return nb_tx;
+	return ETH(sdev)->tx_pkt_burst(sub_txq, tx_pkts, nb_pkts);
 }
@@ -4316,6 +4316,8 @@ void hns3_set_rxtx_function(struct rte_eth_dev *eth_dev)
 		eth_dev->tx_pkt_burst = hns3_dummy_rxtx_burst;
 		eth_dev->tx_pkt_prepare = hns3_dummy_rxtx_burst;
 	}
+
+	rte_eth_fp_ops_update(eth_dev);
 }
 
 void
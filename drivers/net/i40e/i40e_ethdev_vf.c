@@ -206,6 +206,7 @@ static const struct eth_dev_ops i40evf_eth_dev_ops = {
 	.tx_queue_release     = i40e_dev_tx_queue_release,
 	.rxq_info_get         = i40e_rxq_info_get,
 	.txq_info_get         = i40e_txq_info_get,
+	.recycle_rxq_info_get = i40e_recycle_rxq_info_get,
 	.mac_addr_add	      = i40evf_add_mac_addr,
 	.mac_addr_remove      = i40evf_del_mac_addr,
 	.set_mc_addr_list     = i40evf_set_mc_addr_list,
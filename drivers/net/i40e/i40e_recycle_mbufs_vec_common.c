@@ -0,0 +1,133 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <stdint.h>
+#include <ethdev_driver.h>
+
+#include "base/i40e_prototype.h"
+#include "base/i40e_type.h"
+#include "i40e_ethdev.h"
+#include "i40e_rxtx.h"
+
+#pragma GCC diagnostic ignored "-Wcast-qual"
+
+/*
+ * Refill the descriptors from rxrearm_start with the mbufs already put
+ * in the software ring by i40e_recycle_tx_mbufs_reuse_vec(), as
+ * i40e_rxq_rearm() does with the mbufs it allocates.
+ */
+void
+i40e_recycle_rx_descriptors_refill_vec(void *rx_queue, uint16_t nb_mbufs)
+{
+	struct i40e_rx_queue *rxq = rx_queue;
+	struct i40e_rx_entry *rxep;
+	volatile union i40e_rx_desc *rxdp;
+	uint16_t rx_id;
+	uint64_t dma_addr;
+	uint16_t i;
+
+	rxdp = rxq->rx_ring + rxq->rxrearm_start;
+	rxep = &rxq->sw_ring[rxq->rxrearm_start];
+
+	for (i = 0; i < nb_mbufs; i++) {
+		dma_addr = rte_cpu_to_le_64(rxep[i].mbuf->buf_iova +
+				RTE_PKTMBUF_HEADROOM);
+		/* flush desc with pa dma_addr */
+		rxdp[i].read.hdr_addr = 0;
+		rxdp[i].read.pkt_addr = dma_addr;
+	}
+
+	rxq->rxrearm_start += nb_mbufs;
+	if (rxq->rxrearm_start >= rxq->nb_rx_desc)
+		rxq->rxrearm_start = 0;
+
+	rxq->rxrearm_nb -= nb_mbufs;
+
+	rx_id = (uint16_t)((rxq->rxrearm_start == 0) ?
+			     (rxq->nb_rx_desc - 1) : (rxq->rxrearm_start - 1));
+
+	/* Update the tail pointer on the NIC */
+	I40E_PCI_REG_WC_WRITE(rxq->qrx_tail, rx_id);
+}
+
+/*
+ * Release the next tx_rs_thresh transmitted mbufs, as i40e_tx_free_bufs()
+ * does, but into the software ring of the Rx queue instead of the mempool.
+ */
+uint16_t
+i40e_recycle_tx_mbufs_reuse_vec(void *tx_queue,
+	struct rte_eth_recycle_rxq_info *recycle_rxq_info)
+{
+	struct i40e_tx_queue *txq = tx_queue;
+	uint16_t refill_head = *recycle_rxq_info->refill_head;
+	uint16_t receive_tail = *recycle_rxq_info->receive_tail;
+	uint16_t ring_size = recycle_rxq_info->mbuf_ring_size;
+	struct i40e_tx_entry *txep;
+	struct rte_mbuf **rxep;
+	uint16_t nb_recycle, avail;
+	uint16_t i, n;
+
+	n = txq->tx_rs_thresh;
+
+	/* number of Rx entries received and not refilled yet */
+	avail = receive_tail >= refill_head ? receive_tail - refill_head :
+			ring_size - refill_head + receive_tail;
+
+	if (txq->nb_tx_free > txq->tx_free_thresh || avail < n)
+		return 0;
+
+	/*
+	 * The refill must neither wrap around the Rx ring, nor leave it
+	 * misaligned for the Rx queue own rearm.
+	 */
+	if ((recycle_rxq_info->refill_requirement != 0 &&
+			recycle_rxq_info->refill_requirement != n) ||
+			refill_head + n > ring_size)
+		return 0;
+
+	/* check DD bits on threshold descriptor */
+	if ((txq->tx_ring[txq->tx_next_dd].cmd_type_offset_bsz &
+			rte_cpu_to_le_64(I40E_TXD_QW1_DTYPE_MASK)) !=
+			rte_cpu_to_le_64(I40E_TX_DESC_DTYPE_DESC_DONE))
+		return 0;
+
+	/* first buffer to free from S/W ring is at index
+	 * tx_next_dd - (tx_rs_thresh-1)
+	 */
+	txep = &txq->sw_ring[txq->tx_next_dd - (n - 1)];
+	rxep = &recycle_rxq_info->mbuf_ring[refill_head];
+	nb_recycle = n;
+
+	if (txq->offloads & DEV_TX_OFFLOAD_MBUF_FAST_FREE) {
+		/* all the mbufs come from the same mempool */
+		if (unlikely(txep[0].mbuf->pool != recycle_rxq_info->mp))
+			return 0;
+
+		for (i = 0; i < n; i++)
+			rxep[i] = txep[i].mbuf;
+	} else {
+		for (i = 0; i < n; i++) {
+			rxep[i] = rte_pktmbuf_prefree_seg(txep[i].mbuf);
+			if (unlikely(rxep[i] == NULL ||
+					rxep[i]->pool != recycle_rxq_info->mp))
+				nb_recycle = 0;
+		}
+
+		/* one of them cannot be recycled, free them all */
+		if (unlikely(nb_recycle == 0)) {
+			for (i = 0; i < n; i++) {
+				if (rxep[i] != NULL)
+					rte_mempool_put(rxep[i]->pool, rxep[i]);
+			}
+		}
+	}
+
+	/* buffers were released, update counters */
+	txq->nb_tx_free = (uint16_t)(txq->nb_tx_free + txq->tx_rs_thresh);
+	txq->tx_next_dd = (uint16_t)(txq->tx_next_dd + txq->tx_rs_thresh);
+	if (txq->tx_next_dd >= txq->nb_tx_desc)
+		txq->tx_next_dd = (uint16_t)(txq->tx_rs_thresh - 1);
+
+	return nb_recycle;
+}
@@ -412,7 +412,11 @@ check_rx_burst_bulk_alloc_preconditions(__rte_unused struct i40e_rx_queue *rxq)
 	int ret = 0;
 
 #ifdef RTE_LIBRTE_I40E_RX_ALLOW_BULK_ALLOC
-	if (!(rxq->rx_free_thresh >= RTE_PMD_I40E_RX_MAX_BURST)) {
+	if (rxq->hdr_mp != NULL) {
+		PMD_INIT_LOG(DEBUG, "Rx Burst Bulk Alloc Preconditions: "
+			     "buffer split is enabled");
+		ret = -EINVAL;
+	} else if (!(rxq->rx_free_thresh >= RTE_PMD_I40E_RX_MAX_BURST)) {
 		PMD_INIT_LOG(DEBUG, "Rx Burst Bulk Alloc Preconditions: "
 			     "rxq->rx_free_thresh=%d, "
 			     "RTE_PMD_I40E_RX_MAX_BURST=%d",
@@ -803,6 +807,170 @@ i40e_recv_pkts(void *rx_queue, struct rte_mbuf **rx_pkts, uint16_t nb_pkts)
 	return nb_rx;
 }
 
+/*
+ * Receive on a queue with the Rx buffer split. Each descriptor carries a
+ * header buffer and a payload buffer, the hardware places the protocol
+ * headers it recognizes in the first one and the rest of the packet in the
+ * second one. The packet is returned as a chain of the non-empty buffers,
+ * the empty one stays on the ring, and only the headers are prefetched.
+ */
+uint16_t
+i40e_recv_split_pkts(void *rx_queue, struct rte_mbuf **rx_pkts, uint16_t nb_pkts)
+{
+	struct i40e_rx_queue *rxq = rx_queue;
+	volatile union i40e_rx_desc *rx_ring = rxq->rx_ring;
+	volatile union i40e_rx_desc *rxdp;
+	union i40e_rx_desc rxd;
+	struct i40e_rx_entry *sw_ring = rxq->sw_ring;
+	struct i40e_rx_entry *sw_hdr_ring = rxq->sw_hdr_ring;
+	struct i40e_rx_entry *rxe, *hxe;
+	struct rte_eth_dev *dev;
+	struct rte_mbuf *rxm, *hdr, *pay;
+	struct rte_mbuf *nmb, *nhdr;
+	uint16_t nb_rx = 0, nb_hold = 0;
+	uint16_t rx_id = rxq->rx_tail;
+	uint16_t hdr_len, pay_len;
+	uint32_t rx_status;
+	uint64_t qword1;
+	uint64_t pkt_flags;
+	uint32_t *ptype_tbl = rxq->vsi->adapter->ptype_tbl;
+
+	/* The queues without split share the burst function of the port. */
+	if (sw_hdr_ring == NULL)
+		return i40e_recv_scattered_pkts(rx_queue, rx_pkts, nb_pkts);
+
+	while (nb_rx < nb_pkts) {
+		rxdp = &rx_ring[rx_id];
+		qword1 = rte_le_to_cpu_64(rxdp->wb.qword1.status_error_len);
+		rx_status = (qword1 & I40E_RXD_QW1_STATUS_MASK)
+				>> I40E_RXD_QW1_STATUS_SHIFT;
+
+		/* Check the DD bit first */
+		if (!(rx_status & (1 << I40E_RX_DESC_STATUS_DD_SHIFT)))
+			break;
+
+		/*
+		 * On a header buffer overflow, the header buffer is full and
+		 * the remaining headers are in the payload buffer.
+		 */
+		if (qword1 & (1ULL << (I40E_RXD_QW1_ERROR_SHIFT +
+				       I40E_RX_DESC_ERROR_HBO_SHIFT)))
+			hdr_len = rxq->rx_hdr_len;
+		else if (qword1 & I40E_RXD_QW1_LENGTH_SPH_MASK)
+			hdr_len = (qword1 & I40E_RXD_QW1_LENGTH_HBUF_MASK) >>
+				I40E_RXD_QW1_LENGTH_HBUF_SHIFT;
+		else
+			hdr_len = 0;
+		pay_len = (qword1 & I40E_RXD_QW1_LENGTH_PBUF_MASK) >>
+				I40E_RXD_QW1_LENGTH_PBUF_SHIFT;
+
+		/* Only the returned buffers are replaced. */
+		nhdr = NULL;
+		nmb = NULL;
+		if (hdr_len != 0) {
+			nhdr = rte_mbuf_raw_alloc(rxq->hdr_mp);
+			if (unlikely(nhdr == NULL))
+				goto alloc_failed;
+		}
+		if (pay_len != 0 || hdr_len == 0) {
+			nmb = rte_mbuf_raw_alloc(rxq->mp);
+			if (unlikely(nmb == NULL)) {
+				if (nhdr != NULL)
+					rte_mbuf_raw_free(nhdr);
+				goto alloc_failed;
+			}
+		}
+
+		rxd = *rxdp;
+		nb_hold++;
+		rxe = &sw_ring[rx_id];
+		hxe = &sw_hdr_ring[rx_id];
+		rx_id++;
+		if (unlikely(rx_id == rxq->nb_rx_desc))
+			rx_id = 0;
+
+		/* Prefetch next mbufs */
+		rte_prefetch0(sw_hdr_ring[rx_id].mbuf);
+		rte_prefetch0(sw_ring[rx_id].mbuf);
+
+		if ((rx_id & 0x3) == 0) {
+			rte_prefetch0(&rx_ring[rx_id]);
+			rte_prefetch0(&sw_ring[rx_id]);
+			rte_prefetch0(&sw_hdr_ring[rx_id]);
+		}
+		hdr = hxe->mbuf;
+		pay = rxe->mbuf;
+		if (nhdr != NULL)
+			hxe->mbuf = nhdr;
+		if (nmb != NULL)
+			rxe->mbuf = nmb;
+		/* The write-back overwrote both addresses. */
+		rxdp->read.hdr_addr = rte_cpu_to_le_64(
+			rte_mbuf_data_iova_default(hxe->mbuf));
+		rxdp->read.pkt_addr = rte_cpu_to_le_64(
+			rte_mbuf_data_iova_default(rxe->mbuf));
+
+		pay->data_off = RTE_PKTMBUF_HEADROOM;
+		pay->data_len = pay_len;
+		pay->next = NULL;
+		if (hdr_len != 0) {
+			rxm = hdr;
+			rxm->data_off = RTE_PKTMBUF_HEADROOM;
+			rxm->data_len = hdr_len;
+			if (pay_len != 0) {
+				rxm->next = pay;
+				rxm->nb_segs = 2;
+			} else {
+				rxm->next = NULL;
+				rxm->nb_segs = 1;
+			}
+		} else {
+			rxm = pay;
+			rxm->nb_segs = 1;
+		}
+		rte_prefetch0(RTE_PTR_ADD(rxm->buf_addr, RTE_PKTMBUF_HEADROOM));
+		rxm->pkt_len = hdr_len + pay_len;
+		rxm->port = rxq->port_id;
+		rxm->ol_flags = 0;
+		i40e_rxd_to_vlan_tci(rxm, &rxd);
+		pkt_flags = i40e_rxd_status_to_pkt_flags(qword1);
+		pkt_flags |= i40e_rxd_error_to_pkt_flags(qword1);
+		rxm->packet_type =
+			ptype_tbl[(uint8_t)((qword1 &
+			I40E_RXD_QW1_PTYPE_MASK) >> I40E_RXD_QW1_PTYPE_SHIFT)];
+		if (pkt_flags & PKT_RX_RSS_HASH)
+			rxm->hash.rss =
+				rte_le_to_cpu_32(rxd.wb.qword0.hi_dword.rss);
+		if (pkt_flags & PKT_RX_FDIR)
+			pkt_flags |= i40e_rxd_build_fdir(&rxd, rxm);
+
+#ifdef RTE_LIBRTE_IEEE1588
+		pkt_flags |= i40e_get_iee15888_flags(rxm, qword1);
+#endif
+		rxm->ol_flags |= pkt_flags;
+
+		rx_pkts[nb_rx++] = rxm;
+		continue;
+
+alloc_failed:
+		dev = I40E_VSI_TO_ETH_DEV(rxq->vsi);
+		dev->data->rx_mbuf_alloc_failed++;
+		break;
+	}
+	rxq->rx_tail = rx_id;
+
+	nb_hold = (uint16_t)(nb_hold + rxq->nb_rx_hold);
+	if (nb_hold > rxq->rx_free_thresh) {
+		rx_id = (uint16_t) ((rx_id == 0) ?
+			(rxq->nb_rx_desc - 1) : (rx_id - 1));
+		I40E_PCI_REG_WC_WRITE(rxq->qrx_tail, rx_id);
+		nb_hold = 0;
+	}
+	rxq->nb_rx_hold = nb_hold;
+
+	return nb_rx;
+}
+
 uint16_t
 i40e_recv_scattered_pkts(void *rx_queue,
 			 struct rte_mbuf **rx_pkts,
@@ -1488,6 +1656,20 @@ i40e_xmit_pkts_vec(void *tx_queue, struct rte_mbuf **tx_pkts,
 	return nb_tx;
 }
 
+uint16_t
+i40e_tx_doorbell_flush(void *tx_queue)
+{
+	struct i40e_tx_queue *txq = tx_queue;
+	uint16_t nb_desc = txq->tx_db_pending;
+
+	if (nb_desc != 0) {
+		txq->tx_db_pending = 0;
+		I40E_PCI_REG_WC_WRITE(txq->qtx_tail, txq->tx_tail);
+	}
+
+	return nb_desc;
+}
+
 /*********************************************************************
  *
  *  TX simple prep functions
@@ -1850,6 +2032,14 @@ i40e_dev_rx_queue_setup_runtime(struct rte_eth_dev *dev,
 	int use_scattered_rx =
 		(rxq->max_pkt_len > buf_size);
 
+	if (rxq->hdr_mp != NULL && dev->rx_pkt_burst != i40e_recv_split_pkts &&
+	    !i40e_dev_first_queue(rxq->queue_id, dev->data->rx_queues,
+				  dev->data->nb_rx_queues)) {
+		PMD_DRV_LOG(ERR, "Buffer split requires the port to be "
+			    "started with a split queue.");
+		return -EINVAL;
+	}
+
 	if (i40e_rx_queue_init(rxq) != I40E_SUCCESS) {
 		PMD_DRV_LOG(ERR,
 			    "Failed to do RX queue initialization");
@@ -1913,14 +2103,47 @@ i40e_dev_rx_queue_setup(struct rte_eth_dev *dev,
 	struct i40e_vf *vf = NULL;
 	struct i40e_rx_queue *rxq;
 	const struct rte_memzone *rz;
+	struct rte_mempool *hdr_mp = NULL;
 	uint32_t ring_size;
 	uint16_t len, i;
+	uint16_t hdr_len = 0;
 	uint16_t reg_idx, base, bsf, tc_mapping;
 	int q_offset, use_def_burst_func = 1;
 	uint64_t offloads;
 
 	offloads = rx_conf->offloads | dev->data->dev_conf.rxmode.offloads;
 
+	if (offloads & RTE_ETH_RX_OFFLOAD_BUFFER_SPLIT) {
+		const struct rte_eth_rxseg_split *rx_seg;
+
+		if (rx_conf->rx_nseg != I40E_RX_SPLIT_NSEG) {
+			PMD_DRV_LOG(ERR, "Buffer split requires %u segments",
+				    I40E_RX_SPLIT_NSEG);
+			return -EINVAL;
+		}
+		if (offloads & DEV_RX_OFFLOAD_KEEP_CRC) {
+			PMD_DRV_LOG(ERR, "Buffer split is not supported "
+				    "with CRC keeping");
+			return -EINVAL;
+		}
+		/* The headers go to the first segment, the payload to the second. */
+		rx_seg = &rx_conf->rx_seg[0].split;
+		hdr_mp = rx_seg[0].mp;
+		mp = rx_seg[1].mp;
+		hdr_len = rx_seg[0].length;
+		if (hdr_len == 0)
+			hdr_len = rte_pktmbuf_data_room_size(hdr_mp) -
+				RTE_PKTMBUF_HEADROOM;
+		hdr_len = RTE_ALIGN_FLOOR(RTE_MIN(hdr_len,
+				I40E_RX_MAX_HDR_BUF_SZ),
+				1 << I40E_RXQ_CTX_HBUFF_SHIFT);
+		if (hdr_len == 0) {
+			PMD_DRV_LOG(ERR, "Header segment shorter than %u bytes",
+				    1 << I40E_RXQ_CTX_HBUFF_SHIFT);
+			return -EINVAL;
+		}
+	}
+
 	if (hw->mac.type == I40E_MAC_VF || hw->mac.type == I40E_MAC_X722_VF) {
 		vf = I40EVF_DEV_PRIVATE_TO_VF(dev->data->dev_private);
 		vsi = &vf->vsi;
@@ -1963,6 +2186,8 @@ i40e_dev_rx_queue_setup(struct rte_eth_dev *dev,
 		return -ENOMEM;
 	}
 	rxq->mp = mp;
+	rxq->hdr_mp = hdr_mp;
+	rxq->rx_hdr_len = hdr_len;
 	rxq->nb_rx_desc = nb_desc;
 	rxq->rx_free_thresh = rx_conf->rx_free_thresh;
 	rxq->queue_id = queue_idx;
@@ -2017,6 +2242,20 @@ i40e_dev_rx_queue_setup(struct rte_eth_dev *dev,
 		return -ENOMEM;
 	}
 
+	if (hdr_mp != NULL) {
+		rxq->sw_hdr_ring =
+			rte_zmalloc_socket("i40e rx sw hdr ring",
+					   sizeof(struct i40e_rx_entry) * len,
+					   RTE_CACHE_LINE_SIZE,
+					   socket_id);
+		if (!rxq->sw_hdr_ring) {
+			i40e_dev_rx_queue_release(rxq);
+			PMD_DRV_LOG(ERR, "Failed to allocate memory for SW "
+				    "header ring");
+			return -ENOMEM;
+		}
+	}
+
 	i40e_reset_rx_queue(rxq);
 	rxq->q_set = TRUE;
 
@@ -2076,6 +2315,7 @@ i40e_dev_rx_queue_release(void *rxq)
 
 	i40e_rx_queue_release_mbufs(q);
 	rte_free(q->sw_ring);
+	rte_free(q->sw_hdr_ring);
 	rte_free(q);
 }
 
@@ -2408,6 +2648,10 @@ i40e_dev_tx_queue_setup(struct rte_eth_dev *dev,
 	txq->offloads = offloads;
 	txq->vsi = vsi;
 	txq->tx_deferred_start = tx_conf->tx_deferred_start;
+	txq->tx_db_thresh = tx_conf->tx_doorbell_thresh;
+	txq->tx_db_tmo_us = tx_conf->tx_doorbell_tmo_us;
+	txq->tx_db_tmo = (uint64_t)tx_conf->tx_doorbell_tmo_us *
+		rte_get_tsc_hz() / US_PER_S;
 
 	txq->tx_ring_phys_addr = tz->iova;
 	txq->tx_ring = (struct i40e_tx_desc *)tz->addr;
@@ -2508,6 +2752,14 @@ i40e_rx_queue_release_mbufs(struct i40e_rx_queue *rxq)
 			rxq->sw_ring[i].mbuf = NULL;
 		}
 	}
+	if (rxq->sw_hdr_ring) {
+		for (i = 0; i < rxq->nb_rx_desc; i++) {
+			if (rxq->sw_hdr_ring[i].mbuf) {
+				rte_pktmbuf_free_seg(rxq->sw_hdr_ring[i].mbuf);
+				rxq->sw_hdr_ring[i].mbuf = NULL;
+			}
+		}
+	}
 #ifdef RTE_LIBRTE_I40E_RX_ALLOW_BULK_ALLOC
 	if (rxq->rx_nb_avail == 0)
 		return;
@@ -2763,6 +3015,7 @@ i40e_reset_tx_queue(struct i40e_tx_queue *txq)
 
 	txq->last_desc_cleaned = (uint16_t)(txq->nb_tx_desc - 1);
 	txq->nb_tx_free = (uint16_t)(txq->nb_tx_desc - 1);
+	txq->tx_db_pending = 0;
 }
 
 /* Init the TX queue in hardware */
@@ -2841,6 +3094,23 @@ i40e_alloc_rx_queue_mbufs(struct i40e_rx_queue *rxq)
 		rxd = &rxq->rx_ring[i];
 		rxd->read.pkt_addr = dma_addr;
 		rxd->read.hdr_addr = 0;
+		if (rxq->hdr_mp != NULL) {
+			struct rte_mbuf *hdr = rte_mbuf_raw_alloc(rxq->hdr_mp);
+
+			if (unlikely(!hdr)) {
+				rte_pktmbuf_free_seg(mbuf);
+				PMD_DRV_LOG(ERR, "Failed to allocate header mbuf for RX");
+				return -ENOMEM;
+			}
+			rte_mbuf_refcnt_set(hdr, 1);
+			hdr->next = NULL;
+			hdr->data_off = RTE_PKTMBUF_HEADROOM;
+			hdr->nb_segs = 1;
+			hdr->port = rxq->port_id;
+			rxd->read.hdr_addr =
+				rte_cpu_to_le_64(rte_mbuf_data_iova_default(hdr));
+			rxq->sw_hdr_ring[i].mbuf = hdr;
+		}
 #ifndef RTE_LIBRTE_I40E_16BYTE_RX_DESC
 		rxd->read.rsvd1 = 0;
 		rxd->read.rsvd2 = 0;
@@ -2867,6 +3137,23 @@ i40e_rx_queue_config(struct i40e_rx_queue *rxq)
 	buf_size = (uint16_t)(rte_pktmbuf_data_room_size(rxq->mp) -
 		RTE_PKTMBUF_HEADROOM);
 
+	if (rxq->hdr_mp != NULL) {
+		/* The header length is set from the first Rx segment. */
+		rxq->rx_buf_len = RTE_ALIGN_FLOOR(buf_size,
+			(1 << I40E_RXQ_CTX_DBUFF_SHIFT));
+		rxq->hs_mode = i40e_header_split_enabled;
+		rxq->max_pkt_len = RTE_MIN((uint32_t)rxq->rx_buf_len,
+			data->dev_conf.rxmode.max_rx_pkt_len);
+		if (rxq->max_pkt_len < data->dev_conf.rxmode.max_rx_pkt_len) {
+			PMD_DRV_LOG(ERR, "Buffer split requires the payload "
+				    "segment to hold the maximum packet "
+				    "length %u",
+				    data->dev_conf.rxmode.max_rx_pkt_len);
+			return I40E_ERR_CONFIG;
+		}
+		return 0;
+	}
+
 	switch (pf->flags & (I40E_FLAG_HEADER_SPLIT_DISABLED |
 			I40E_FLAG_HEADER_SPLIT_ENABLED)) {
 	case I40E_FLAG_HEADER_SPLIT_ENABLED: /* Not supported */
@@ -3184,9 +3471,29 @@ i40e_txq_info_get(struct rte_eth_dev *dev, uint16_t queue_id,
 	qinfo->conf.tx_free_thresh = txq->tx_free_thresh;
 	qinfo->conf.tx_rs_thresh = txq->tx_rs_thresh;
 	qinfo->conf.tx_deferred_start = txq->tx_deferred_start;
+	qinfo->conf.tx_doorbell_thresh = txq->tx_db_thresh;
+	qinfo->conf.tx_doorbell_tmo_us = txq->tx_db_tmo_us;
 	qinfo->conf.offloads = txq->offloads;
 }
 
+void
+i40e_recycle_rxq_info_get(struct rte_eth_dev *dev, uint16_t queue_id,
+	struct rte_eth_recycle_rxq_info *recycle_rxq_info)
+{
+	struct i40e_rx_queue *rxq;
+
+	rxq = dev->data->rx_queues[queue_id];
+
+	recycle_rxq_info->mbuf_ring = (void *)rxq->sw_ring;
+	recycle_rxq_info->mp = rxq->mp;
+	recycle_rxq_info->mbuf_ring_size = rxq->nb_rx_desc;
+	recycle_rxq_info->receive_tail = &rxq->rx_tail;
+
+	/* the vector Rx rearms RTE_I40E_RXQ_REARM_THRESH descriptors at once */
+	recycle_rxq_info->refill_requirement = RTE_I40E_RXQ_REARM_THRESH;
+	recycle_rxq_info->refill_head = &rxq->rxrearm_start;
+}
+
 static inline bool
 get_avx_supported(bool request_avx512)
 {
@@ -3222,6 +3529,20 @@ get_avx_supported(bool request_avx512)
 }
 
 
+static bool
+i40e_rx_split_enabled(struct rte_eth_dev *dev)
+{
+	uint16_t i;
+
+	for (i = 0; i < dev->data->nb_rx_queues; i++) {
+		struct i40e_rx_queue *rxq = dev->data->rx_queues[i];
+
+		if (rxq && rxq->hdr_mp != NULL)
+			return true;
+	}
+	return false;
+}
+
 void __rte_cold
 i40e_set_rx_function(struct rte_eth_dev *dev)
 {
@@ -3299,6 +3620,10 @@ i40e_set_rx_function(struct rte_eth_dev *dev)
 					i40e_recv_pkts_vec;
 			}
 		}
+	} else if (i40e_rx_split_enabled(dev)) {
+		PMD_INIT_LOG(DEBUG, "Buffer split Rx path will be used on "
+			     "port=%d.", dev->data->port_id);
+		dev->rx_pkt_burst = i40e_recv_split_pkts;
 	} else if (!dev->data->scattered_rx && ad->rx_bulk_alloc_allowed) {
 		PMD_INIT_LOG(DEBUG, "Rx Burst Bulk Alloc Preconditions are "
 				    "satisfied. Rx Burst Bulk Alloc function "
@@ -3315,6 +3640,19 @@ i40e_set_rx_function(struct rte_eth_dev *dev)
 					i40e_recv_pkts;
 	}
 
+	/* Only the vector Rx functions can be refilled with recycled mbufs */
+	dev->recycle_rx_descriptors_refill = NULL;
+	if (dev->rx_pkt_burst == i40e_recv_scattered_pkts_vec ||
+			dev->rx_pkt_burst == i40e_recv_pkts_vec ||
+#ifdef CC_AVX512_SUPPORT
+			dev->rx_pkt_burst == i40e_recv_scattered_pkts_vec_avx512 ||
+			dev->rx_pkt_burst == i40e_recv_pkts_vec_avx512 ||
+#endif
+			dev->rx_pkt_burst == i40e_recv_scattered_pkts_vec_avx2 ||
+			dev->rx_pkt_burst == i40e_recv_pkts_vec_avx2)
+		dev->recycle_rx_descriptors_refill =
+			i40e_recycle_rx_descriptors_refill_vec;
+
 	/* Propagate information about RX function choice through all queues. */
 	if (rte_eal_process_type() == RTE_PROC_PRIMARY) {
 		rx_using_sse =
@@ -3343,6 +3681,7 @@ static const struct {
 	{ i40e_recv_scattered_pkts,          "Scalar Scattered" },
 	{ i40e_recv_pkts_bulk_alloc,         "Scalar Bulk Alloc" },
 	{ i40e_recv_pkts,                    "Scalar" },
+	{ i40e_recv_split_pkts,              "Scalar Buffer Split" },
 #ifdef RTE_ARCH_X86
 #ifdef CC_AVX512_SUPPORT
 	{ i40e_recv_scattered_pkts_vec_avx512, "Vector AVX512 Scattered" },
@@ -3435,6 +3774,9 @@ i40e_set_tx_function(struct rte_eth_dev *dev)
 		}
 	}
 
+	dev->recycle_tx_mbufs_reuse = NULL;
+	/* Only the vector Tx functions defer the tail writes */
+	dev->tx_doorbell_flush = NULL;
 	if (ad->tx_simple_allowed) {
 		if (ad->tx_vec_allowed &&
 				rte_vect_get_max_simd_bitwidth() >= RTE_VECT_SIMD_128) {
@@ -3443,6 +3785,7 @@ i40e_set_tx_function(struct rte_eth_dev *dev)
 				PMD_DRV_LOG(NOTICE, "Using AVX512 Vector Tx (port %d).",
 					    dev->data->port_id);
 				dev->tx_pkt_burst = i40e_xmit_pkts_vec_avx512;
+				dev->tx_doorbell_flush = i40e_tx_doorbell_flush;
 #endif
 			} else {
 				PMD_INIT_LOG(DEBUG, "Using %sVector Tx (port %d).",
@@ -3451,6 +3794,10 @@ i40e_set_tx_function(struct rte_eth_dev *dev)
 				dev->tx_pkt_burst = use_avx2 ?
 						    i40e_xmit_pkts_vec_avx2 :
 						    i40e_xmit_pkts_vec;
+				/* AVX512 Tx has its own software ring layout */
+				dev->recycle_tx_mbufs_reuse =
+					i40e_recycle_tx_mbufs_reuse_vec;
+				dev->tx_doorbell_flush = i40e_tx_doorbell_flush;
 			}
 		} else {
 			PMD_INIT_LOG(DEBUG, "Simple tx finally be used.");
@@ -17,6 +17,10 @@
 
 #define I40E_RXBUF_SZ_1024 1024
 #define I40E_RXBUF_SZ_2048 2048
+/* The header buffer size is given in 5 bits of 64 bytes units. */
+#define I40E_RX_MAX_HDR_BUF_SZ (31 << I40E_RXQ_CTX_HBUFF_SHIFT)
+/* Header and payload segments of the Rx buffer split. */
+#define I40E_RX_SPLIT_NSEG 2
 
 /* In none-PXE mode QLEN must be whole number of 32 descriptors. */
 #define	I40E_ALIGN_RING_DESC	32
@@ -104,6 +108,10 @@ struct i40e_rx_queue {
 	uint16_t rxrearm_start;	/**< the idx we start the re-arming from */
 	uint64_t mbuf_initializer; /**< value to init mbufs */
 
+	/**< mbuf pool of the header buffers, NULL without buffer split */
+	struct rte_mempool *hdr_mp;
+	struct i40e_rx_entry *sw_hdr_ring; /**< header buffers of the ring */
+
 	uint16_t port_id; /**< device port ID */
 	uint8_t crc_len; /**< 0 if CRC stripped, 4 otherwise */
 	uint8_t fdir_enabled; /**< 0 if FDIR disabled, 1 when enabled */
@@ -166,6 +174,12 @@ struct i40e_tx_queue {
 	bool tx_deferred_start; /**< don't start this queue in dev start */
 	uint8_t dcb_tc;         /**< Traffic class of tx queue */
 	uint64_t offloads; /**< Tx offload flags of DEV_RX_OFFLOAD_* */
+	/** Number of descriptors to queue before writing the tail register */
+	uint16_t tx_db_thresh;
+	uint16_t tx_db_pending; /**< descriptors pending a tail write */
+	uint32_t tx_db_tmo_us; /**< max delay of the pending descriptors */
+	uint64_t tx_db_tmo; /**< max delay in TSC cycles, 0 for no limit */
+	uint64_t tx_db_deadline; /**< TSC deadline of the pending descriptors */
 };
 
 /** Offload features */
@@ -184,6 +198,7 @@ union i40e_tx_offload {
 int i40e_dev_rx_queue_start(struct rte_eth_dev *dev, uint16_t rx_queue_id);
 int i40e_dev_rx_queue_stop(struct rte_eth_dev *dev, uint16_t rx_queue_id);
 int i40e_dev_tx_queue_start(struct rte_eth_dev *dev, uint16_t tx_queue_id);
+uint16_t i40e_tx_doorbell_flush(void *tx_queue);
 int i40e_dev_tx_queue_stop(struct rte_eth_dev *dev, uint16_t tx_queue_id);
 const uint32_t *i40e_dev_supported_ptypes_get(struct rte_eth_dev *dev);
 int i40e_dev_rx_queue_setup(struct rte_eth_dev *dev,
@@ -205,6 +220,9 @@ uint16_t i40e_recv_pkts(void *rx_queue,
 uint16_t i40e_recv_scattered_pkts(void *rx_queue,
 				  struct rte_mbuf **rx_pkts,
 				  uint16_t nb_pkts);
+uint16_t i40e_recv_split_pkts(void *rx_queue,
+			      struct rte_mbuf **rx_pkts,
+			      uint16_t nb_pkts);
 uint16_t i40e_xmit_pkts(void *tx_queue,
 			struct rte_mbuf **tx_pkts,
 			uint16_t nb_pkts);
@@ -240,6 +258,9 @@ int i40e_rx_vec_dev_conf_condition_check(struct rte_eth_dev *dev);
 int i40e_rxq_vec_setup(struct i40e_rx_queue *rxq);
 int i40e_txq_vec_setup(struct i40e_tx_queue *txq);
 void i40e_rx_queue_release_mbufs_vec(struct i40e_rx_queue *rxq);
+void i40e_recycle_rx_descriptors_refill_vec(void *rx_queue, uint16_t nb_mbufs);
+uint16_t i40e_recycle_tx_mbufs_reuse_vec(void *tx_queue,
+	struct rte_eth_recycle_rxq_info *recycle_rxq_info);
 uint16_t i40e_xmit_fixed_burst_vec(void *tx_queue, struct rte_mbuf **tx_pkts,
 				   uint16_t nb_pkts);
 void i40e_set_rx_function(struct rte_eth_dev *dev);
@@ -1066,8 +1066,11 @@ i40e_xmit_fixed_burst_vec_avx512(void *tx_queue, struct rte_mbuf **tx_pkts,
 		i40e_tx_free_bufs_avx512(txq);
 
 	nb_commit = nb_pkts = (uint16_t)RTE_MIN(txq->nb_tx_free, nb_pkts);
-	if (unlikely(nb_pkts == 0))
+	if (unlikely(nb_pkts == 0)) {
+		/* hand the pending descriptors over to free the ring */
+		i40e_tx_doorbell_flush(txq);
 		return 0;
+	}
 
 	tx_id = txq->tx_tail;
 	txdp = &txq->tx_ring[tx_id];
@@ -1111,7 +1114,8 @@ i40e_xmit_fixed_burst_vec_avx512(void *tx_queue, struct rte_mbuf **tx_pkts,
 
 	txq->tx_tail = tx_id;
 
-	I40E_PCI_REG_WC_WRITE(txq->qtx_tail, txq->tx_tail);
+	if (!i40e_tx_doorbell_defer(txq, nb_pkts))
+		I40E_PCI_REG_WC_WRITE(txq->qtx_tail, txq->tx_tail);
 
 	return nb_pkts;
 }
@@ -559,8 +559,11 @@ i40e_xmit_fixed_burst_vec(void *__rte_restrict tx_queue,
 		i40e_tx_free_bufs(txq);
 
 	nb_commit = nb_pkts = (uint16_t)RTE_MIN(txq->nb_tx_free, nb_pkts);
-	if (unlikely(nb_pkts == 0))
+	if (unlikely(nb_pkts == 0)) {
+		/* hand the pending descriptors over to free the ring */
+		i40e_tx_doorbell_flush(txq);
 		return 0;
+	}
 
 	tx_id = txq->tx_tail;
 	txdp = &txq->tx_ring[tx_id];
@@ -602,8 +605,10 @@ i40e_xmit_fixed_burst_vec(void *__rte_restrict tx_queue,
 
 	txq->tx_tail = tx_id;
 
-	rte_io_wmb();
-	I40E_PCI_REG_WRITE_RELAXED(txq->qtx_tail, tx_id);
+	if (!i40e_tx_doorbell_defer(txq, nb_pkts)) {
+		rte_io_wmb();
+		I40E_PCI_REG_WRITE_RELAXED(txq->qtx_tail, tx_id);
+	}
 
 	return nb_pkts;
 }
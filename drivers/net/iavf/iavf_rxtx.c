@@ -255,6 +255,7 @@ reset_tx_queue(struct iavf_tx_queue *txq)
 
 	txq->last_desc_cleaned = txq->nb_tx_desc - 1;
 	txq->nb_free = txq->nb_tx_desc - 1;
+	txq->tx_db_pending = 0;
 
 	txq->next_dd = txq->rs_thresh - 1;
 	txq->next_rs = txq->rs_thresh - 1;
@@ -744,6 +745,10 @@ iavf_dev_tx_queue_setup(struct rte_eth_dev *dev,
 	txq->port_id = dev->data->port_id;
 	txq->offloads = offloads;
 	txq->tx_deferred_start = tx_conf->tx_deferred_start;
+	txq->tx_db_thresh = tx_conf->tx_doorbell_thresh;
+	txq->tx_db_tmo_us = tx_conf->tx_doorbell_tmo_us;
+	txq->tx_db_tmo = (uint64_t)tx_conf->tx_doorbell_tmo_us *
+		rte_get_tsc_hz() / US_PER_S;
 
 	/* Allocate software ring */
 	txq->sw_ring =
@@ -2542,10 +2547,26 @@ iavf_set_rx_function(struct rte_eth_dev *dev)
 	}
 }
 
+uint16_t
+iavf_tx_doorbell_flush(void *tx_queue)
+{
+	struct iavf_tx_queue *txq = tx_queue;
+	uint16_t nb_desc = txq->tx_db_pending;
+
+	if (nb_desc != 0) {
+		txq->tx_db_pending = 0;
+		IAVF_PCI_REG_WRITE(txq->qtx_tail, txq->tx_tail);
+	}
+
+	return nb_desc;
+}
+
 /* choose tx function*/
 void
 iavf_set_tx_function(struct rte_eth_dev *dev)
 {
+	/* Only the vector Tx functions defer the tail writes */
+	dev->tx_doorbell_flush = NULL;
 #ifdef RTE_ARCH_X86
 	struct iavf_tx_queue *txq;
 	int i;
@@ -2613,6 +2634,7 @@ iavf_set_tx_function(struct rte_eth_dev *dev)
 			iavf_txq_vec_setup(txq);
 #endif
 		}
+		dev->tx_doorbell_flush = iavf_tx_doorbell_flush;
 
 		return;
 	}
@@ -2723,6 +2745,8 @@ iavf_dev_txq_info_get(struct rte_eth_dev *dev, uint16_t queue_id,
 	qinfo->conf.tx_rs_thresh = txq->rs_thresh;
 	qinfo->conf.offloads = txq->offloads;
 	qinfo->conf.tx_deferred_start = txq->tx_deferred_start;
+	qinfo->conf.tx_doorbell_thresh = txq->tx_db_thresh;
+	qinfo->conf.tx_doorbell_tmo_us = txq->tx_db_tmo_us;
 }
 
 /* Get the number of used descriptors of a rx queue */
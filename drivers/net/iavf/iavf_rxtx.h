@@ -252,6 +252,12 @@ struct iavf_tx_queue {
 #define IAVF_TX_FLAGS_VLAN_TAG_LOC_L2TAG1	BIT(0)
 #define IAVF_TX_FLAGS_VLAN_TAG_LOC_L2TAG2	BIT(1)
 	uint8_t vlan_flag;
+	/* Number of descriptors to queue before writing the tail register */
+	uint16_t tx_db_thresh;
+	uint16_t tx_db_pending;        /* descriptors pending a tail write */
+	uint32_t tx_db_tmo_us;         /* max delay of the pending descriptors */
+	uint64_t tx_db_tmo;            /* max delay in TSC cycles, 0 for no limit */
+	uint64_t tx_db_deadline;       /* TSC deadline of the pending descriptors */
 };
 
 /* Offload features */
@@ -428,6 +434,7 @@ int iavf_dev_tx_queue_setup(struct rte_eth_dev *dev,
 			   const struct rte_eth_txconf *tx_conf);
 int iavf_dev_tx_queue_start(struct rte_eth_dev *dev, uint16_t tx_queue_id);
 int iavf_dev_tx_queue_stop(struct rte_eth_dev *dev, uint16_t tx_queue_id);
+uint16_t iavf_tx_doorbell_flush(void *tx_queue);
 int iavf_dev_tx_done_cleanup(void *txq, uint32_t free_cnt);
 void iavf_dev_tx_queue_release(void *txq);
 void iavf_stop_queues(struct rte_eth_dev *dev);
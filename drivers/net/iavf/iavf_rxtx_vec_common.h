@@ -146,6 +146,36 @@ tx_backlog_entry(struct iavf_tx_entry *txep,
 		txep[i].mbuf = tx_pkts[i];
 }
 
+/*
+ * Queue nb_desc new descriptors for the doorbell coalescing of the queue.
+ * Return true when the tail register write is deferred, until enough
+ * descriptors are pending or the deadline of the first of them is reached.
+ */
+static __rte_always_inline bool
+iavf_tx_doorbell_defer(struct iavf_tx_queue *txq, uint16_t nb_desc)
+{
+	uint64_t now;
+
+	if (txq->tx_db_thresh == 0)
+		return false;
+
+	txq->tx_db_pending = (uint16_t)(txq->tx_db_pending + nb_desc);
+	if (txq->tx_db_pending < txq->tx_db_thresh) {
+		if (txq->tx_db_tmo == 0)
+			return true;
+		now = rte_get_tsc_cycles();
+		if (txq->tx_db_pending == nb_desc) {
+			txq->tx_db_deadline = now + txq->tx_db_tmo;
+			return true;
+		}
+		if (now < txq->tx_db_deadline)
+			return true;
+	}
+
+	txq->tx_db_pending = 0;
+	return false;
+}
+
 static inline void
 _iavf_rx_queue_release_mbufs_vec(struct iavf_rx_queue *rxq)
 {
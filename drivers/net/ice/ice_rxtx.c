@@ -940,6 +940,7 @@ ice_reset_tx_queue(struct ice_tx_queue *txq)
 
 	txq->last_desc_cleaned = (uint16_t)(txq->nb_tx_desc - 1);
 	txq->nb_tx_free = (uint16_t)(txq->nb_tx_desc - 1);
+	txq->tx_db_pending = 0;
 }
 
 int
@@ -1341,6 +1342,10 @@ ice_tx_queue_setup(struct rte_eth_dev *dev,
 	txq->offloads = offloads;
 	txq->vsi = vsi;
 	txq->tx_deferred_start = tx_conf->tx_deferred_start;
+	txq->tx_db_thresh = tx_conf->tx_doorbell_thresh;
+	txq->tx_db_tmo_us = tx_conf->tx_doorbell_tmo_us;
+	txq->tx_db_tmo = (uint64_t)tx_conf->tx_doorbell_tmo_us *
+		rte_get_tsc_hz() / US_PER_S;
 
 	txq->tx_ring_dma = tz->iova;
 	txq->tx_ring = tz->addr;
@@ -1416,6 +1421,8 @@ ice_txq_info_get(struct rte_eth_dev *dev, uint16_t queue_id,
 	qinfo->conf.tx_rs_thresh = txq->tx_rs_thresh;
 	qinfo->conf.offloads = txq->offloads;
 	qinfo->conf.tx_deferred_start = txq->tx_deferred_start;
+	qinfo->conf.tx_doorbell_thresh = txq->tx_db_thresh;
+	qinfo->conf.tx_doorbell_tmo_us = txq->tx_db_tmo_us;
 }
 
 uint32_t
@@ -3049,6 +3056,20 @@ ice_xmit_pkts_simple(void *tx_queue,
 	return nb_tx;
 }
 
+uint16_t
+ice_tx_doorbell_flush(void *tx_queue)
+{
+	struct ice_tx_queue *txq = tx_queue;
+	uint16_t nb_desc = txq->tx_db_pending;
+
+	if (nb_desc != 0) {
+		txq->tx_db_pending = 0;
+		ICE_PCI_REG_WC_WRITE(txq->qtx_tail, txq->tx_tail);
+	}
+
+	return nb_desc;
+}
+
 void __rte_cold
 ice_set_rx_function(struct rte_eth_dev *dev)
 {
@@ -3298,6 +3319,8 @@ ice_set_tx_function(struct rte_eth_dev *dev)
 	bool use_avx512 = false;
 	bool use_avx2 = false;
 
+	/* Only the vector Tx functions defer the tail writes */
+	dev->tx_doorbell_flush = NULL;
 	if (rte_eal_process_type() == RTE_PROC_PRIMARY) {
 		tx_check_ret = ice_tx_vec_dev_check(dev);
 		if (tx_check_ret >= 0 &&
@@ -3361,6 +3384,7 @@ ice_set_tx_function(struct rte_eth_dev *dev)
 					    ice_xmit_pkts_vec;
 		}
 		dev->tx_pkt_prepare = NULL;
+		dev->tx_doorbell_flush = ice_tx_doorbell_flush;
 
 		return;
 	}
@@ -133,6 +133,12 @@ struct ice_tx_queue {
 	bool tx_deferred_start; /* don't start this queue in dev start */
 	bool q_set; /* indicate if tx queue has been configured */
 	ice_tx_release_mbufs_t tx_rel_mbufs;
+	/* Number of descriptors to queue before writing the tail register */
+	uint16_t tx_db_thresh;
+	uint16_t tx_db_pending; /* descriptors pending a tail write */
+	uint32_t tx_db_tmo_us; /* max delay of the pending descriptors */
+	uint64_t tx_db_tmo; /* max delay in TSC cycles, 0 for no limit */
+	uint64_t tx_db_deadline; /* TSC deadline of the pending descriptors */
 };
 
 /* Offload features */
@@ -203,6 +209,7 @@ int ice_rx_queue_start(struct rte_eth_dev *dev, uint16_t rx_queue_id);
 int ice_rx_queue_stop(struct rte_eth_dev *dev, uint16_t rx_queue_id);
 int ice_tx_queue_start(struct rte_eth_dev *dev, uint16_t tx_queue_id);
 int ice_tx_queue_stop(struct rte_eth_dev *dev, uint16_t tx_queue_id);
+uint16_t ice_tx_doorbell_flush(void *tx_queue);
 int ice_fdir_rx_queue_start(struct rte_eth_dev *dev, uint16_t rx_queue_id);
 int ice_fdir_tx_queue_start(struct rte_eth_dev *dev, uint16_t tx_queue_id);
 int ice_fdir_rx_queue_stop(struct rte_eth_dev *dev, uint16_t rx_queue_id);
@@ -3953,6 +3953,11 @@ ixgbe_dev_supported_ptypes_get(struct rte_eth_dev *dev)
 	if (dev->rx_pkt_burst == ixgbe_recv_pkts_vec ||
 	    dev->rx_pkt_burst == ixgbe_recv_scattered_pkts_vec)
 		return ptypes;
+#endif
+#ifdef CC_AVX2_SUPPORT
+	if (dev->rx_pkt_burst == ixgbe_recv_pkts_vec_avx2 ||
+	    dev->rx_pkt_burst == ixgbe_recv_scattered_pkts_vec_avx2)
+		return ptypes;
 #endif
 	return NULL;
 }
@@ -341,6 +341,18 @@ ixgbe_xmit_pkts_simple(void *tx_queue, struct rte_mbuf **tx_pkts,
 	return nb_tx;
 }
 
+/* Whether the AVX2 vector Rx and Tx paths can be used. */
+static inline bool
+ixgbe_avx2_supported(void)
+{
+#ifdef CC_AVX2_SUPPORT
+	return rte_vect_get_max_simd_bitwidth() >= RTE_VECT_SIMD_256 &&
+		rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX2) == 1;
+#else
+	return false;
+#endif
+}
+
 static uint16_t
 ixgbe_xmit_pkts_vec(void *tx_queue, struct rte_mbuf **tx_pkts,
 		    uint16_t nb_pkts)
@@ -2550,6 +2562,13 @@ ixgbe_set_tx_function(struct rte_eth_dev *dev, struct ixgbe_tx_queue *txq)
 				rte_vect_get_max_simd_bitwidth() >= RTE_VECT_SIMD_128 &&
 				(rte_eal_process_type() != RTE_PROC_PRIMARY ||
 					ixgbe_txq_vec_setup(txq) == 0)) {
+#ifdef CC_AVX2_SUPPORT
+			if (ixgbe_avx2_supported()) {
+				PMD_INIT_LOG(DEBUG, "AVX2 vector tx enabled.");
+				dev->tx_pkt_burst = ixgbe_xmit_pkts_vec_avx2;
+				return;
+			}
+#endif
 			PMD_INIT_LOG(DEBUG, "Vector tx enabled.");
 			dev->tx_pkt_burst = ixgbe_xmit_pkts_vec;
 		} else
@@ -4790,6 +4809,7 @@ ixgbe_set_rx_function(struct rte_eth_dev *dev)
 {
 	uint16_t i, rx_using_sse;
 	struct ixgbe_adapter *adapter = dev->data->dev_private;
+	bool use_avx2 = false;
 
 	/*
 	 * In order to allow Vector Rx there are a few configuration
@@ -4804,6 +4824,8 @@ ixgbe_set_rx_function(struct rte_eth_dev *dev)
 
 		adapter->rx_vec_allowed = false;
 	}
+	if (adapter->rx_vec_allowed)
+		use_avx2 = ixgbe_avx2_supported();
 
 	/*
 	 * Initialize the appropriate LRO callback.
@@ -4828,11 +4850,17 @@ ixgbe_set_rx_function(struct rte_eth_dev *dev)
 		 * single allocation versions.
 		 */
 		if (adapter->rx_vec_allowed) {
-			PMD_INIT_LOG(DEBUG, "Using Vector Scattered Rx "
+			PMD_INIT_LOG(DEBUG, "Using %sVector Scattered Rx "
 					    "callback (port=%d).",
+				     use_avx2 ? "AVX2 " : "",
 				     dev->data->port_id);
 
 			dev->rx_pkt_burst = ixgbe_recv_scattered_pkts_vec;
+#ifdef CC_AVX2_SUPPORT
+			if (use_avx2)
+				dev->rx_pkt_burst =
+					ixgbe_recv_scattered_pkts_vec_avx2;
+#endif
 		} else if (adapter->rx_bulk_alloc_allowed) {
 			PMD_INIT_LOG(DEBUG, "Using a Scattered with bulk "
 					   "allocation callback (port=%d).",
@@ -4856,12 +4884,18 @@ ixgbe_set_rx_function(struct rte_eth_dev *dev)
 	 *    - Single buffer allocation (the simplest one)
 	 */
 	} else if (adapter->rx_vec_allowed) {
-		PMD_INIT_LOG(DEBUG, "Vector rx enabled, please make sure RX "
+		PMD_INIT_LOG(DEBUG, "%sVector rx enabled, please make sure RX "
 				    "burst size no less than %d (port=%d).",
-			     RTE_IXGBE_DESCS_PER_LOOP,
+			     use_avx2 ? "AVX2 " : "",
+			     use_avx2 ? RTE_IXGBE_DESCS_PER_LOOP_AVX :
+					RTE_IXGBE_DESCS_PER_LOOP,
 			     dev->data->port_id);
 
 		dev->rx_pkt_burst = ixgbe_recv_pkts_vec;
+#ifdef CC_AVX2_SUPPORT
+		if (use_avx2)
+			dev->rx_pkt_burst = ixgbe_recv_pkts_vec_avx2;
+#endif
 	} else if (adapter->rx_bulk_alloc_allowed) {
 		PMD_INIT_LOG(DEBUG, "Rx Burst Bulk Alloc Preconditions are "
 				    "satisfied. Rx Burst Bulk Alloc function "
@@ -4883,6 +4917,11 @@ ixgbe_set_rx_function(struct rte_eth_dev *dev)
 	rx_using_sse =
 		(dev->rx_pkt_burst == ixgbe_recv_scattered_pkts_vec ||
 		dev->rx_pkt_burst == ixgbe_recv_pkts_vec);
+#ifdef CC_AVX2_SUPPORT
+	rx_using_sse |=
+		(dev->rx_pkt_burst == ixgbe_recv_scattered_pkts_vec_avx2 ||
+		dev->rx_pkt_burst == ixgbe_recv_pkts_vec_avx2);
+#endif
 
 	for (i = 0; i < dev->data->nb_rx_queues; i++) {
 		struct ixgbe_rx_queue *rxq = dev->data->rx_queues[i];
@@ -0,0 +1,806 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <stdint.h>
+#include <ethdev_driver.h>
+#include <rte_malloc.h>
+
+#include "ixgbe_ethdev.h"
+#include "ixgbe_rxtx.h"
+#include "ixgbe_rxtx_vec_common.h"
+
+#include <rte_vect.h>
+
+#ifndef __INTEL_COMPILER
+#pragma GCC diagnostic ignored "-Wcast-qual"
+#endif
+
+static __rte_always_inline void
+ixgbe_rxq_rearm_avx2(struct ixgbe_rx_queue *rxq)
+{
+	int i;
+	uint16_t rx_id;
+	volatile union ixgbe_adv_rx_desc *rxdp;
+	struct ixgbe_rx_entry *rxep = &rxq->sw_ring[rxq->rxrearm_start];
+	const __m256i hdr_room = _mm256_set1_epi64x(RTE_PKTMBUF_HEADROOM);
+	const __m256i hba_msk = _mm256_set_epi64x(0, UINT64_MAX,
+			0, UINT64_MAX);
+
+	rxdp = rxq->rx_ring + rxq->rxrearm_start;
+
+	/* Pull 'n' more MBUFs into the software ring */
+	if (rte_mempool_get_bulk(rxq->mb_pool,
+				 (void *)rxep,
+				 RTE_IXGBE_RXQ_REARM_THRESH) < 0) {
+		if (rxq->rxrearm_nb + RTE_IXGBE_RXQ_REARM_THRESH >=
+		    rxq->nb_rx_desc) {
+			__m128i dma_addr0 = _mm_setzero_si128();
+
+			for (i = 0; i < RTE_IXGBE_DESCS_PER_LOOP; i++) {
+				rxep[i].mbuf = &rxq->fake_mbuf;
+				_mm_store_si128((__m128i *)&rxdp[i].read,
+						dma_addr0);
+			}
+		}
+		rte_eth_devices[rxq->port_id].data->rx_mbuf_alloc_failed +=
+			RTE_IXGBE_RXQ_REARM_THRESH;
+		return;
+	}
+
+	/*
+	 * Initialize the mbufs in vector, process 2 mbufs in one loop.
+	 * The rearm start is a multiple of RTE_IXGBE_RXQ_REARM_THRESH, so
+	 * each pair of descriptors is 32 bytes aligned.
+	 */
+	for (i = 0; i < RTE_IXGBE_RXQ_REARM_THRESH;
+			i += 2, rxep += 2, rxdp += 2) {
+		__m128i vaddr0, vaddr1;
+		__m256i vaddr0_1, dma_addr0_1;
+
+		/* load buf_addr(lo 64bit) and buf_iova(hi 64bit) */
+		RTE_BUILD_BUG_ON(offsetof(struct rte_mbuf, buf_iova) !=
+				offsetof(struct rte_mbuf, buf_addr) + 8);
+		vaddr0 = _mm_loadu_si128((__m128i *)&rxep[0].mbuf->buf_addr);
+		vaddr1 = _mm_loadu_si128((__m128i *)&rxep[1].mbuf->buf_addr);
+		vaddr0_1 = _mm256_inserti128_si256(
+				_mm256_castsi128_si256(vaddr0), vaddr1, 1);
+
+		/* convert pa to dma_addr hdr/data */
+		dma_addr0_1 = _mm256_unpackhi_epi64(vaddr0_1, vaddr0_1);
+
+		/* add headroom to pa values */
+		dma_addr0_1 = _mm256_add_epi64(dma_addr0_1, hdr_room);
+
+		/* set Header Buffer Address to zero */
+		dma_addr0_1 = _mm256_and_si256(dma_addr0_1, hba_msk);
+
+		/* flush desc with pa dma_addr */
+		_mm256_store_si256((__m256i *)&rxdp->read, dma_addr0_1);
+	}
+
+	rxq->rxrearm_start += RTE_IXGBE_RXQ_REARM_THRESH;
+	if (rxq->rxrearm_start >= rxq->nb_rx_desc)
+		rxq->rxrearm_start = 0;
+
+	rxq->rxrearm_nb -= RTE_IXGBE_RXQ_REARM_THRESH;
+
+	rx_id = (uint16_t) ((rxq->rxrearm_start == 0) ?
+			     (rxq->nb_rx_desc - 1) : (rxq->rxrearm_start - 1));
+
+	/* Update the tail pointer on the NIC */
+	IXGBE_PCI_REG_WC_WRITE(rxq->rdt_reg_addr, rx_id);
+}
+
+static inline uint32_t
+ixgbe_avx2_packet_type(uint32_t pkt_info, uint16_t pkt_type_mask)
+{
+	if (pkt_info & IXGBE_RXDADV_PKTTYPE_ETQF)
+		return RTE_PTYPE_UNKNOWN;
+
+	pkt_info = (pkt_info >> IXGBE_PACKET_TYPE_SHIFT) & pkt_type_mask;
+	if (pkt_info & IXGBE_PACKET_TYPE_TUNNEL_BIT)
+		return ptype_table_tn[pkt_info & IXGBE_PACKET_TYPE_MASK_TUNNEL];
+
+	return ptype_table[pkt_info & IXGBE_PACKET_TYPE_MASK_82599];
+}
+
+#ifdef RTE_LIB_SECURITY
+static inline void
+desc_to_olflags_ipsec_avx2(volatile union ixgbe_adv_rx_desc *rxdp,
+		struct rte_mbuf **rx_pkts)
+{
+	const uint32_t sterr_msk = IXGBE_RXDADV_IPSEC_STATUS_SECP |
+			IXGBE_RXDADV_IPSEC_ERROR_AUTH_FAILED;
+	uint32_t sterr;
+	int i;
+
+	for (i = 0; i < RTE_IXGBE_DESCS_PER_LOOP_AVX; i++) {
+		sterr = rte_le_to_cpu_32(rxdp[i].wb.upper.status_error) &
+				sterr_msk;
+		if (sterr == sterr_msk)
+			rx_pkts[i]->ol_flags |= PKT_RX_SEC_OFFLOAD_FAILED |
+					PKT_RX_SEC_OFFLOAD;
+		else if (sterr == IXGBE_RXDADV_IPSEC_STATUS_SECP)
+			rx_pkts[i]->ol_flags |= PKT_RX_SEC_OFFLOAD;
+	}
+}
+#endif
+
+/*
+ * Compute the flags of 8 packets, the same way as the SSE path. Each 128-bit
+ * lane is processed as the 4 descriptors of the SSE path: the low lane holds
+ * the packets 0, 2, 4 and 6, and the high lane the packets 1, 3, 5 and 7.
+ * The flags are returned in the low 64 bits of each lane, 16 bits per
+ * packet.
+ */
+static inline __m256i
+desc_to_olflags_avx2(__m256i desc0_1, __m256i desc2_3, __m256i desc4_5,
+		__m256i desc6_7, uint8_t vlan_flags, uint16_t udp_p_flag)
+{
+	__m256i ptype0, ptype1, vtag0, vtag1, csum, udp_csum_skip;
+
+	/* mask everything except rss type */
+	const __m256i rsstype_msk = _mm256_set_epi16(
+			0x0000, 0x0000, 0x0000, 0x0000,
+			0x000F, 0x000F, 0x000F, 0x000F,
+			0x0000, 0x0000, 0x0000, 0x0000,
+			0x000F, 0x000F, 0x000F, 0x000F);
+
+	/* mask the lower byte of ol_flags */
+	const __m256i ol_flags_msk = _mm256_set_epi16(
+			0x0000, 0x0000, 0x0000, 0x0000,
+			0x00FF, 0x00FF, 0x00FF, 0x00FF,
+			0x0000, 0x0000, 0x0000, 0x0000,
+			0x00FF, 0x00FF, 0x00FF, 0x00FF);
+
+	/* map rss type to rss hash flag */
+	const __m256i rss_flags = _mm256_set_epi8(PKT_RX_FDIR, 0, 0, 0,
+			0, 0, 0, PKT_RX_RSS_HASH,
+			PKT_RX_RSS_HASH, 0, PKT_RX_RSS_HASH, 0,
+			PKT_RX_RSS_HASH, PKT_RX_RSS_HASH, PKT_RX_RSS_HASH, 0,
+			PKT_RX_FDIR, 0, 0, 0,
+			0, 0, 0, PKT_RX_RSS_HASH,
+			PKT_RX_RSS_HASH, 0, PKT_RX_RSS_HASH, 0,
+			PKT_RX_RSS_HASH, PKT_RX_RSS_HASH, PKT_RX_RSS_HASH, 0);
+
+	/* mask everything except vlan present and l4/ip csum error */
+	const __m256i vlan_csum_msk = _mm256_set_epi16(
+		(IXGBE_RXDADV_ERR_TCPE | IXGBE_RXDADV_ERR_IPE) >> 16,
+		(IXGBE_RXDADV_ERR_TCPE | IXGBE_RXDADV_ERR_IPE) >> 16,
+		(IXGBE_RXDADV_ERR_TCPE | IXGBE_RXDADV_ERR_IPE) >> 16,
+		(IXGBE_RXDADV_ERR_TCPE | IXGBE_RXDADV_ERR_IPE) >> 16,
+		IXGBE_RXD_STAT_VP, IXGBE_RXD_STAT_VP,
+		IXGBE_RXD_STAT_VP, IXGBE_RXD_STAT_VP,
+		(IXGBE_RXDADV_ERR_TCPE | IXGBE_RXDADV_ERR_IPE) >> 16,
+		(IXGBE_RXDADV_ERR_TCPE | IXGBE_RXDADV_ERR_IPE) >> 16,
+		(IXGBE_RXDADV_ERR_TCPE | IXGBE_RXDADV_ERR_IPE) >> 16,
+		(IXGBE_RXDADV_ERR_TCPE | IXGBE_RXDADV_ERR_IPE) >> 16,
+		IXGBE_RXD_STAT_VP, IXGBE_RXD_STAT_VP,
+		IXGBE_RXD_STAT_VP, IXGBE_RXD_STAT_VP);
+
+	/* map vlan present (0x8), IPE (0x2), L4E (0x1) to ol_flags */
+	const __m256i vlan_csum_map_lo = _mm256_set_epi8(
+		0, 0, 0, 0,
+		vlan_flags | PKT_RX_IP_CKSUM_BAD | PKT_RX_L4_CKSUM_BAD,
+		vlan_flags | PKT_RX_IP_CKSUM_BAD,
+		vlan_flags | PKT_RX_IP_CKSUM_GOOD | PKT_RX_L4_CKSUM_BAD,
+		vlan_flags | PKT_RX_IP_CKSUM_GOOD,
+		0, 0, 0, 0,
+		PKT_RX_IP_CKSUM_BAD | PKT_RX_L4_CKSUM_BAD,
+		PKT_RX_IP_CKSUM_BAD,
+		PKT_RX_IP_CKSUM_GOOD | PKT_RX_L4_CKSUM_BAD,
+		PKT_RX_IP_CKSUM_GOOD,
+		0, 0, 0, 0,
+		vlan_flags | PKT_RX_IP_CKSUM_BAD | PKT_RX_L4_CKSUM_BAD,
+		vlan_flags | PKT_RX_IP_CKSUM_BAD,
+		vlan_flags | PKT_RX_IP_CKSUM_GOOD | PKT_RX_L4_CKSUM_BAD,
+		vlan_flags | PKT_RX_IP_CKSUM_GOOD,
+		0, 0, 0, 0,
+		PKT_RX_IP_CKSUM_BAD | PKT_RX_L4_CKSUM_BAD,
+		PKT_RX_IP_CKSUM_BAD,
+		PKT_RX_IP_CKSUM_GOOD | PKT_RX_L4_CKSUM_BAD,
+		PKT_RX_IP_CKSUM_GOOD);
+
+	const __m256i vlan_csum_map_hi = _mm256_set_epi8(
+		0, 0, 0, 0,
+		0, PKT_RX_L4_CKSUM_GOOD >> sizeof(uint8_t), 0,
+		PKT_RX_L4_CKSUM_GOOD >> sizeof(uint8_t),
+		0, 0, 0, 0,
+		0, PKT_RX_L4_CKSUM_GOOD >> sizeof(uint8_t), 0,
+		PKT_RX_L4_CKSUM_GOOD >> sizeof(uint8_t),
+		0, 0, 0, 0,
+		0, PKT_RX_L4_CKSUM_GOOD >> sizeof(uint8_t), 0,
+		PKT_RX_L4_CKSUM_GOOD >> sizeof(uint8_t),
+		0, 0, 0, 0,
+		0, PKT_RX_L4_CKSUM_GOOD >> sizeof(uint8_t), 0,
+		PKT_RX_L4_CKSUM_GOOD >> sizeof(uint8_t));
+
+	/* mask everything except UDP header present if specified */
+	const __m256i udp_hdr_p_msk = _mm256_set_epi16(
+		0, 0, 0, 0,
+		udp_p_flag, udp_p_flag, udp_p_flag, udp_p_flag,
+		0, 0, 0, 0,
+		udp_p_flag, udp_p_flag, udp_p_flag, udp_p_flag);
+
+	const __m256i udp_csum_bad_shuf = _mm256_set_epi8(
+		0, 0, 0, 0, 0, 0, 0, 0,
+		0, 0, 0, 0, 0, 0, ~(uint8_t)PKT_RX_L4_CKSUM_BAD, 0xFF,
+		0, 0, 0, 0, 0, 0, 0, 0,
+		0, 0, 0, 0, 0, 0, ~(uint8_t)PKT_RX_L4_CKSUM_BAD, 0xFF);
+
+	ptype0 = _mm256_unpacklo_epi16(desc0_1, desc2_3);
+	ptype1 = _mm256_unpacklo_epi16(desc4_5, desc6_7);
+	vtag0 = _mm256_unpackhi_epi16(desc0_1, desc2_3);
+	vtag1 = _mm256_unpackhi_epi16(desc4_5, desc6_7);
+
+	ptype0 = _mm256_unpacklo_epi32(ptype0, ptype1);
+	/* save the UDP header present information */
+	udp_csum_skip = _mm256_and_si256(ptype0, udp_hdr_p_msk);
+	ptype0 = _mm256_and_si256(ptype0, rsstype_msk);
+	ptype0 = _mm256_shuffle_epi8(rss_flags, ptype0);
+
+	vtag1 = _mm256_unpacklo_epi32(vtag0, vtag1);
+	vtag1 = _mm256_and_si256(vtag1, vlan_csum_msk);
+
+	/* csum bits are in the most significant, to use shuffle we need to
+	 * shift them. Change mask to 0xc000 to 0x0003.
+	 */
+	csum = _mm256_srli_epi16(vtag1, 14);
+
+	/* now or the most significant 64 bits of each lane, containing the
+	 * checksum flags, with the vlan present flags.
+	 */
+	csum = _mm256_srli_si256(csum, 8);
+	vtag1 = _mm256_or_si256(csum, vtag1);
+
+	/* convert VP, IPE, L4E to ol_flags */
+	vtag0 = _mm256_shuffle_epi8(vlan_csum_map_hi, vtag1);
+	vtag0 = _mm256_slli_epi16(vtag0, sizeof(uint8_t));
+
+	vtag1 = _mm256_shuffle_epi8(vlan_csum_map_lo, vtag1);
+	vtag1 = _mm256_and_si256(vtag1, ol_flags_msk);
+	vtag1 = _mm256_or_si256(vtag0, vtag1);
+
+	vtag1 = _mm256_or_si256(ptype0, vtag1);
+
+	/* mask out the bad checksum value of the UDP packets without
+	 * checksum, as in the SSE path.
+	 */
+	udp_csum_skip = _mm256_srli_epi16(udp_csum_skip, 9);
+	udp_csum_skip = _mm256_shuffle_epi8(udp_csum_bad_shuf, udp_csum_skip);
+	return _mm256_and_si256(vtag1, udp_csum_skip);
+}
+
+/*
+ * vPMD raw receive routine, only accept(nb_pkts >= RTE_IXGBE_DESCS_PER_LOOP_AVX)
+ *
+ * Notice:
+ * - nb_pkts < RTE_IXGBE_DESCS_PER_LOOP_AVX, just return no packet
+ * - floor align nb_pkts to a RTE_IXGBE_DESCS_PER_LOOP_AVX power-of-two
+ */
+static __rte_always_inline uint16_t
+_recv_raw_pkts_vec_avx2(struct ixgbe_rx_queue *rxq, struct rte_mbuf **rx_pkts,
+		uint16_t nb_pkts, uint8_t *split_packet)
+{
+	volatile union ixgbe_adv_rx_desc *rxdp;
+	struct ixgbe_rx_entry *sw_ring;
+	uint16_t i, received;
+#ifdef RTE_LIB_SECURITY
+	uint8_t use_ipsec = rxq->using_ipsec;
+#endif
+	const uint16_t pkt_type_mask = rxq->pkt_type_mask;
+	uint16_t udp_p_flag = 0; /* Rx Descriptor UDP header present */
+	uint8_t vlan_flags;
+
+	/* nb_pkts has to be floor-aligned to RTE_IXGBE_DESCS_PER_LOOP_AVX */
+	nb_pkts = RTE_ALIGN_FLOOR(nb_pkts, RTE_IXGBE_DESCS_PER_LOOP_AVX);
+
+	rxdp = rxq->rx_ring + rxq->rx_tail;
+
+	rte_prefetch0(rxdp);
+
+	/* See if we need to rearm the RX queue - gives the prefetch a bit
+	 * of time to act
+	 */
+	if (rxq->rxrearm_nb > RTE_IXGBE_RXQ_REARM_THRESH)
+		ixgbe_rxq_rearm_avx2(rxq);
+
+	/* Before we start moving massive data around, check to see if
+	 * there is actually a packet available
+	 */
+	if (!(rxdp->wb.upper.status_error &
+				rte_cpu_to_le_32(IXGBE_RXDADV_STAT_DD)))
+		return 0;
+
+	if (rxq->rx_udp_csum_zero_err)
+		udp_p_flag = IXGBE_RXDADV_PKTTYPE_UDP;
+
+	/* ensure these 2 flags are in the lower 8 bits */
+	RTE_BUILD_BUG_ON((PKT_RX_VLAN | PKT_RX_VLAN_STRIPPED) > UINT8_MAX);
+	vlan_flags = rxq->vlan_flags & UINT8_MAX;
+
+	const __m128i mbuf_init = _mm_set_epi64x(0, rxq->mbuf_initializer);
+
+	const __m256i crc_adjust = _mm256_set_epi16(
+			/* second descriptor */
+			0, 0, 0,       /* ignore non-length fields */
+			-rxq->crc_len, /* sub crc on data_len */
+			0,             /* ignore high-16bits of pkt_len */
+			-rxq->crc_len, /* sub crc on pkt_len */
+			0, 0,          /* ignore pkt_type field */
+			/* first descriptor */
+			0, 0, 0,       /* ignore non-length fields */
+			-rxq->crc_len, /* sub crc on data_len */
+			0,             /* ignore high-16bits of pkt_len */
+			-rxq->crc_len, /* sub crc on pkt_len */
+			0, 0           /* ignore pkt_type field */
+	);
+
+	/* 8 packets DD mask, LSB in each 32-bit value */
+	const __m256i dd_check = _mm256_set1_epi32(IXGBE_RXDADV_STAT_DD);
+
+	/* 8 packets EOP mask, second-LSB in each 32-bit value */
+	const __m256i eop_check = _mm256_set1_epi32(IXGBE_RXDADV_STAT_EOP);
+
+	/* mask to shuffle from desc. to mbuf (2 descriptors) */
+	const __m256i shuf_msk = _mm256_set_epi8(
+			/* second descriptor */
+			7, 6, 5, 4,  /* octet 4~7, 32bits rss */
+			15, 14,      /* octet 14~15, low 16 bits vlan_macip */
+			13, 12,      /* octet 12~13, 16 bits data_len */
+			0xFF, 0xFF,  /* skip high 16 bits pkt_len, zero out */
+			13, 12,      /* octet 12~13, low 16 bits pkt_len */
+			0xFF, 0xFF,  /* skip 32 bit pkt_type */
+			0xFF, 0xFF,
+			/* first descriptor */
+			7, 6, 5, 4,  /* octet 4~7, 32bits rss */
+			15, 14,      /* octet 14~15, low 16 bits vlan_macip */
+			13, 12,      /* octet 12~13, 16 bits data_len */
+			0xFF, 0xFF,  /* skip high 16 bits pkt_len, zero out */
+			13, 12,      /* octet 12~13, low 16 bits pkt_len */
+			0xFF, 0xFF,  /* skip 32 bit pkt_type */
+			0xFF, 0xFF
+	);
+	/*
+	 * compile-time check the above crc and shuffle layout is correct.
+	 * NOTE: the first field (lowest address) is given last in set_epi
+	 * calls above.
+	 */
+	RTE_BUILD_BUG_ON(offsetof(struct rte_mbuf, pkt_len) !=
+			offsetof(struct rte_mbuf, rx_descriptor_fields1) + 4);
+	RTE_BUILD_BUG_ON(offsetof(struct rte_mbuf, data_len) !=
+			offsetof(struct rte_mbuf, rx_descriptor_fields1) + 8);
+	RTE_BUILD_BUG_ON(offsetof(struct rte_mbuf, vlan_tci) !=
+			offsetof(struct rte_mbuf, rx_descriptor_fields1) + 10);
+	RTE_BUILD_BUG_ON(offsetof(struct rte_mbuf, hash) !=
+			offsetof(struct rte_mbuf, rx_descriptor_fields1) + 12);
+	/* the rearm data and the descriptor fields are written at once */
+	RTE_BUILD_BUG_ON(offsetof(struct rte_mbuf, ol_flags) !=
+			offsetof(struct rte_mbuf, rearm_data) + 8);
+	RTE_BUILD_BUG_ON(offsetof(struct rte_mbuf, rx_descriptor_fields1) !=
+			offsetof(struct rte_mbuf, rearm_data) + 16);
+
+	/* the status of the 8 packets are shuffled back in order */
+	const __m256i eop_shuf_msk = _mm256_set_epi8(
+			0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+			0xFF, 0xFF, 0xFF, 0xFF, 12, 8, 4, 0,
+			0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+			0xFF, 0xFF, 0xFF, 0xFF, 12, 8, 4, 0);
+
+	sw_ring = &rxq->sw_ring[rxq->rx_tail];
+
+	/* A. load 8 packet in one loop
+	 * B. copy 8 mbuf point from swring to rx_pkts
+	 * C. calc the number of DD bits among the 8 packets
+	 * [C*. extract the end-of-packet bit, if requested]
+	 * D. fill info. from desc to mbuf
+	 */
+	for (i = 0, received = 0; i < nb_pkts;
+			i += RTE_IXGBE_DESCS_PER_LOOP_AVX,
+			rxdp += RTE_IXGBE_DESCS_PER_LOOP_AVX) {
+		__m256i desc0_1, desc2_3, desc4_5, desc6_7;
+		__m256i mb0_1, mb2_3, mb4_5, mb6_7;
+		__m256i staterr, flags;
+		__m128i flags_even, flags_odd;
+		int dd;
+
+		/* B. copy 4 64 bit or 8 32 bit mbuf points into rx_pkts */
+		_mm256_storeu_si256((void *)&rx_pkts[i],
+				_mm256_loadu_si256((void *)&sw_ring[i]));
+#ifdef RTE_ARCH_X86_64
+		_mm256_storeu_si256((void *)&rx_pkts[i + 4],
+				_mm256_loadu_si256((void *)&sw_ring[i + 4]));
+#endif
+
+		/*
+		 * A. load the descriptors one by one, backwards to avoid a
+		 * race condition. A 16 bytes aligned load is atomic, a
+		 * 32 bytes one is not.
+		 */
+		do {
+			const __m128i raw_desc7 = _mm_load_si128((void *)(rxdp + 7));
+			rte_compiler_barrier();
+			const __m128i raw_desc6 = _mm_load_si128((void *)(rxdp + 6));
+			rte_compiler_barrier();
+			const __m128i raw_desc5 = _mm_load_si128((void *)(rxdp + 5));
+			rte_compiler_barrier();
+			const __m128i raw_desc4 = _mm_load_si128((void *)(rxdp + 4));
+			rte_compiler_barrier();
+			const __m128i raw_desc3 = _mm_load_si128((void *)(rxdp + 3));
+			rte_compiler_barrier();
+			const __m128i raw_desc2 = _mm_load_si128((void *)(rxdp + 2));
+			rte_compiler_barrier();
+			const __m128i raw_desc1 = _mm_load_si128((void *)(rxdp + 1));
+			rte_compiler_barrier();
+			const __m128i raw_desc0 = _mm_load_si128((void *)(rxdp + 0));
+
+			desc6_7 = _mm256_inserti128_si256(
+					_mm256_castsi128_si256(raw_desc6), raw_desc7, 1);
+			desc4_5 = _mm256_inserti128_si256(
+					_mm256_castsi128_si256(raw_desc4), raw_desc5, 1);
+			desc2_3 = _mm256_inserti128_si256(
+					_mm256_castsi128_si256(raw_desc2), raw_desc3, 1);
+			desc0_1 = _mm256_inserti128_si256(
+					_mm256_castsi128_si256(raw_desc0), raw_desc1, 1);
+		} while (0);
+
+		if (split_packet) {
+			int j;
+
+			for (j = 0; j < RTE_IXGBE_DESCS_PER_LOOP_AVX; j++)
+				rte_mbuf_prefetch_part2(rx_pkts[i + j]);
+		}
+
+		/* D.1 convert format from desc to pktmbuf, and remove crc */
+		mb6_7 = _mm256_shuffle_epi8(desc6_7, shuf_msk);
+		mb4_5 = _mm256_shuffle_epi8(desc4_5, shuf_msk);
+		mb2_3 = _mm256_shuffle_epi8(desc2_3, shuf_msk);
+		mb0_1 = _mm256_shuffle_epi8(desc0_1, shuf_msk);
+		mb6_7 = _mm256_add_epi16(mb6_7, crc_adjust);
+		mb4_5 = _mm256_add_epi16(mb4_5, crc_adjust);
+		mb2_3 = _mm256_add_epi16(mb2_3, crc_adjust);
+		mb0_1 = _mm256_add_epi16(mb0_1, crc_adjust);
+
+		/* D.2 set the packet types, from the first dword of the desc */
+		mb6_7 = _mm256_insert_epi32(mb6_7, ixgbe_avx2_packet_type(
+				_mm256_extract_epi32(desc6_7, 4),
+				pkt_type_mask), 4);
+		mb6_7 = _mm256_insert_epi32(mb6_7, ixgbe_avx2_packet_type(
+				_mm256_extract_epi32(desc6_7, 0),
+				pkt_type_mask), 0);
+		mb4_5 = _mm256_insert_epi32(mb4_5, ixgbe_avx2_packet_type(
+				_mm256_extract_epi32(desc4_5, 4),
+				pkt_type_mask), 4);
+		mb4_5 = _mm256_insert_epi32(mb4_5, ixgbe_avx2_packet_type(
+				_mm256_extract_epi32(desc4_5, 0),
+				pkt_type_mask), 0);
+		mb2_3 = _mm256_insert_epi32(mb2_3, ixgbe_avx2_packet_type(
+				_mm256_extract_epi32(desc2_3, 4),
+				pkt_type_mask), 4);
+		mb2_3 = _mm256_insert_epi32(mb2_3, ixgbe_avx2_packet_type(
+				_mm256_extract_epi32(desc2_3, 0),
+				pkt_type_mask), 0);
+		mb0_1 = _mm256_insert_epi32(mb0_1, ixgbe_avx2_packet_type(
+				_mm256_extract_epi32(desc0_1, 4),
+				pkt_type_mask), 4);
+		mb0_1 = _mm256_insert_epi32(mb0_1, ixgbe_avx2_packet_type(
+				_mm256_extract_epi32(desc0_1, 0),
+				pkt_type_mask), 0);
+
+		/*
+		 * C.1 merge the status of the 8 packets into one register,
+		 * in the order (hi->lo): [7, 5, 3, 1, 6, 4, 2, 0]
+		 */
+		staterr = _mm256_unpacklo_epi64(
+				_mm256_unpackhi_epi32(desc0_1, desc2_3),
+				_mm256_unpackhi_epi32(desc4_5, desc6_7));
+
+		/* D.3 compute the flags, 16 bits per packet */
+		flags = desc_to_olflags_avx2(desc0_1, desc2_3, desc4_5,
+				desc6_7, vlan_flags, udp_p_flag);
+		flags_even = _mm256_castsi256_si128(flags);
+		flags_odd = _mm256_extracti128_si256(flags, 1);
+
+		/*
+		 * D.4 merge the flags with the mbuf init data, and add the
+		 * descriptor fields, to write each mbuf with a single 32
+		 * bytes store.
+		 */
+		_mm256_storeu_si256((__m256i *)&rx_pkts[i + 6]->rearm_data,
+				_mm256_permute2x128_si256(_mm256_castsi128_si256(
+					_mm_blend_epi16(mbuf_init,
+					_mm_slli_si128(flags_even, 2), 0x10)),
+					mb6_7, 0x20));
+		_mm256_storeu_si256((__m256i *)&rx_pkts[i + 4]->rearm_data,
+				_mm256_permute2x128_si256(_mm256_castsi128_si256(
+					_mm_blend_epi16(mbuf_init,
+					_mm_slli_si128(flags_even, 4), 0x10)),
+					mb4_5, 0x20));
+		_mm256_storeu_si256((__m256i *)&rx_pkts[i + 2]->rearm_data,
+				_mm256_permute2x128_si256(_mm256_castsi128_si256(
+					_mm_blend_epi16(mbuf_init,
+					_mm_slli_si128(flags_even, 6), 0x10)),
+					mb2_3, 0x20));
+		_mm256_storeu_si256((__m256i *)&rx_pkts[i + 0]->rearm_data,
+				_mm256_permute2x128_si256(_mm256_castsi128_si256(
+					_mm_blend_epi16(mbuf_init,
+					_mm_slli_si128(flags_even, 8), 0x10)),
+					mb0_1, 0x20));
+		/* the odd mbufs are already in the high 128 bits */
+		_mm256_storeu_si256((__m256i *)&rx_pkts[i + 7]->rearm_data,
+				_mm256_blend_epi32(_mm256_castsi128_si256(
+					_mm_blend_epi16(mbuf_init,
+					_mm_slli_si128(flags_odd, 2), 0x10)),
+					mb6_7, 0xF0));
+		_mm256_storeu_si256((__m256i *)&rx_pkts[i + 5]->rearm_data,
+				_mm256_blend_epi32(_mm256_castsi128_si256(
+					_mm_blend_epi16(mbuf_init,
+					_mm_slli_si128(flags_odd, 4), 0x10)),
+					mb4_5, 0xF0));
+		_mm256_storeu_si256((__m256i *)&rx_pkts[i + 3]->rearm_data,
+				_mm256_blend_epi32(_mm256_castsi128_si256(
+					_mm_blend_epi16(mbuf_init,
+					_mm_slli_si128(flags_odd, 6), 0x10)),
+					mb2_3, 0xF0));
+		_mm256_storeu_si256((__m256i *)&rx_pkts[i + 1]->rearm_data,
+				_mm256_blend_epi32(_mm256_castsi128_si256(
+					_mm_blend_epi16(mbuf_init,
+					_mm_slli_si128(flags_odd, 8), 0x10)),
+					mb0_1, 0xF0));
+
+#ifdef RTE_LIB_SECURITY
+		if (unlikely(use_ipsec))
+			desc_to_olflags_ipsec_avx2(rxdp, &rx_pkts[i]);
+#endif
+
+		/* C* extract and record EOP bit */
+		if (split_packet) {
+			/* and with mask to extract bits, flipping 1-0 */
+			__m256i eop_bits = _mm256_andnot_si256(staterr,
+					eop_check);
+			__m128i split_bits;
+
+			/*
+			 * compress the 32-bit values to 8-bit, and interleave
+			 * the even and odd packets to get them in order
+			 */
+			eop_bits = _mm256_shuffle_epi8(eop_bits, eop_shuf_msk);
+			split_bits = _mm_unpacklo_epi8(
+					_mm256_castsi256_si128(eop_bits),
+					_mm256_extracti128_si256(eop_bits, 1));
+			*(uint64_t *)split_packet =
+				_mm_cvtsi128_si64(split_bits);
+			split_packet += RTE_IXGBE_DESCS_PER_LOOP_AVX;
+		}
+
+		/* C.2 calc available number of desc */
+		staterr = _mm256_and_si256(staterr, dd_check);
+		dd = _mm256_movemask_ps(_mm256_castsi256_ps(
+				_mm256_slli_epi32(staterr, 31)));
+		dd = __builtin_popcount(dd);
+		received += dd;
+		if (likely(dd != RTE_IXGBE_DESCS_PER_LOOP_AVX))
+			break;
+	}
+
+	/* Update our internal tail pointer */
+	rxq->rx_tail = (uint16_t)(rxq->rx_tail + received);
+	rxq->rx_tail = (uint16_t)(rxq->rx_tail & (rxq->nb_rx_desc - 1));
+	rxq->rxrearm_nb = (uint16_t)(rxq->rxrearm_nb + received);
+
+	return received;
+}
+
+/*
+ * vPMD receive routine, only accept(nb_pkts >= RTE_IXGBE_DESCS_PER_LOOP_AVX)
+ *
+ * Notice:
+ * - nb_pkts < RTE_IXGBE_DESCS_PER_LOOP_AVX, just return no packet
+ */
+uint16_t
+ixgbe_recv_pkts_vec_avx2(void *rx_queue, struct rte_mbuf **rx_pkts,
+		uint16_t nb_pkts)
+{
+	return _recv_raw_pkts_vec_avx2(rx_queue, rx_pkts, nb_pkts, NULL);
+}
+
+/*
+ * vPMD receive routine that reassembles single burst of 32 scattered packets
+ *
+ * Notice:
+ * - nb_pkts < RTE_IXGBE_DESCS_PER_LOOP_AVX, just return no packet
+ */
+static uint16_t
+ixgbe_recv_scattered_burst_vec_avx2(void *rx_queue, struct rte_mbuf **rx_pkts,
+		uint16_t nb_pkts)
+{
+	struct ixgbe_rx_queue *rxq = rx_queue;
+	uint8_t split_flags[RTE_IXGBE_MAX_RX_BURST] = {0};
+
+	/* get some new buffers */
+	uint16_t nb_bufs = _recv_raw_pkts_vec_avx2(rxq, rx_pkts, nb_pkts,
+			split_flags);
+	if (nb_bufs == 0)
+		return 0;
+
+	/* happy day case, full burst + no packets to be joined */
+	const uint64_t *split_fl64 = (uint64_t *)split_flags;
+	if (rxq->pkt_first_seg == NULL &&
+			split_fl64[0] == 0 && split_fl64[1] == 0 &&
+			split_fl64[2] == 0 && split_fl64[3] == 0)
+		return nb_bufs;
+
+	/* reassemble any packets that need reassembly*/
+	unsigned int i = 0;
+
+	if (rxq->pkt_first_seg == NULL) {
+		/* find the first split flag, and only reassemble then*/
+		while (i < nb_bufs && !split_flags[i])
+			i++;
+		if (i == nb_bufs)
+			return nb_bufs;
+		rxq->pkt_first_seg = rx_pkts[i];
+	}
+	return i + reassemble_packets(rxq, &rx_pkts[i], nb_bufs - i,
+		&split_flags[i]);
+}
+
+/*
+ * vPMD receive routine that reassembles scattered packets.
+ */
+uint16_t
+ixgbe_recv_scattered_pkts_vec_avx2(void *rx_queue, struct rte_mbuf **rx_pkts,
+		uint16_t nb_pkts)
+{
+	uint16_t retval = 0;
+
+	while (nb_pkts > RTE_IXGBE_MAX_RX_BURST) {
+		uint16_t burst;
+
+		burst = ixgbe_recv_scattered_burst_vec_avx2(rx_queue,
+				rx_pkts + retval, RTE_IXGBE_MAX_RX_BURST);
+		retval += burst;
+		nb_pkts -= burst;
+		if (burst < RTE_IXGBE_MAX_RX_BURST)
+			return retval;
+	}
+
+	return retval + ixgbe_recv_scattered_burst_vec_avx2(rx_queue,
+			rx_pkts + retval, nb_pkts);
+}
+
+static inline void
+vtx1(volatile union ixgbe_adv_tx_desc *txdp,
+		struct rte_mbuf *pkt, uint64_t flags)
+{
+	__m128i descriptor = _mm_set_epi64x((uint64_t)pkt->pkt_len << 46 |
+			flags | pkt->data_len,
+			pkt->buf_iova + pkt->data_off);
+	_mm_store_si128((__m128i *)&txdp->read, descriptor);
+}
+
+static inline void
+vtx(volatile union ixgbe_adv_tx_desc *txdp,
+		struct rte_mbuf **pkt, uint16_t nb_pkts, uint64_t flags)
+{
+	/* if unaligned on 32-bit boundary, do one to align */
+	if (((uintptr_t)txdp & 0x1F) != 0 && nb_pkts != 0) {
+		vtx1(txdp, *pkt, flags);
+		nb_pkts--, txdp++, pkt++;
+	}
+
+	/* do four at a time while possible, two per store */
+	for (; nb_pkts > 3; txdp += 4, pkt += 4, nb_pkts -= 4) {
+		__m256i desc2_3 = _mm256_set_epi64x(
+				(uint64_t)pkt[3]->pkt_len << 46 | flags |
+				pkt[3]->data_len,
+				pkt[3]->buf_iova + pkt[3]->data_off,
+				(uint64_t)pkt[2]->pkt_len << 46 | flags |
+				pkt[2]->data_len,
+				pkt[2]->buf_iova + pkt[2]->data_off);
+		__m256i desc0_1 = _mm256_set_epi64x(
+				(uint64_t)pkt[1]->pkt_len << 46 | flags |
+				pkt[1]->data_len,
+				pkt[1]->buf_iova + pkt[1]->data_off,
+				(uint64_t)pkt[0]->pkt_len << 46 | flags |
+				pkt[0]->data_len,
+				pkt[0]->buf_iova + pkt[0]->data_off);
+		_mm256_store_si256((void *)(txdp + 2), desc2_3);
+		_mm256_store_si256((void *)txdp, desc0_1);
+	}
+
+	/* do any last ones */
+	while (nb_pkts) {
+		vtx1(txdp, *pkt, flags);
+		txdp++, pkt++, nb_pkts--;
+	}
+}
+
+static inline uint16_t
+ixgbe_xmit_fixed_burst_vec_avx2(void *tx_queue, struct rte_mbuf **tx_pkts,
+		uint16_t nb_pkts)
+{
+	struct ixgbe_tx_queue *txq = (struct ixgbe_tx_queue *)tx_queue;
+	volatile union ixgbe_adv_tx_desc *txdp;
+	struct ixgbe_tx_entry_v *txep;
+	uint16_t n, nb_commit, tx_id;
+	uint64_t flags = DCMD_DTYP_FLAGS;
+	uint64_t rs = IXGBE_ADVTXD_DCMD_RS|DCMD_DTYP_FLAGS;
+
+	/* cross rx_thresh boundary is not allowed */
+	nb_pkts = RTE_MIN(nb_pkts, txq->tx_rs_thresh);
+
+	if (txq->nb_tx_free < txq->tx_free_thresh)
+		ixgbe_tx_free_bufs(txq);
+
+	nb_commit = nb_pkts = (uint16_t)RTE_MIN(txq->nb_tx_free, nb_pkts);
+	if (unlikely(nb_pkts == 0))
+		return 0;
+
+	tx_id = txq->tx_tail;
+	txdp = &txq->tx_ring[tx_id];
+	txep = &txq->sw_ring_v[tx_id];
+
+	txq->nb_tx_free = (uint16_t)(txq->nb_tx_free - nb_pkts);
+
+	n = (uint16_t)(txq->nb_tx_desc - tx_id);
+	if (nb_commit >= n) {
+		tx_backlog_entry(txep, tx_pkts, n);
+
+		vtx(txdp, tx_pkts, n - 1, flags);
+		tx_pkts += (n - 1);
+		txdp += (n - 1);
+
+		vtx1(txdp, *tx_pkts++, rs);
+
+		nb_commit = (uint16_t)(nb_commit - n);
+
+		tx_id = 0;
+		txq->tx_next_rs = (uint16_t)(txq->tx_rs_thresh - 1);
+
+		/* avoid reach the end of ring */
+		txdp = &txq->tx_ring[tx_id];
+		txep = &txq->sw_ring_v[tx_id];
+	}
+
+	tx_backlog_entry(txep, tx_pkts, nb_commit);
+
+	vtx(txdp, tx_pkts, nb_commit, flags);
+
+	tx_id = (uint16_t)(tx_id + nb_commit);
+	if (tx_id > txq->tx_next_rs) {
+		txq->tx_ring[txq->tx_next_rs].read.cmd_type_len |=
+			rte_cpu_to_le_32(IXGBE_ADVTXD_DCMD_RS);
+		txq->tx_next_rs = (uint16_t)(txq->tx_next_rs +
+			txq->tx_rs_thresh);
+	}
+
+	txq->tx_tail = tx_id;
+
+	IXGBE_PCI_REG_WC_WRITE(txq->tdt_reg_addr, txq->tx_tail);
+
+	return nb_pkts;
+}
+
+uint16_t
+ixgbe_xmit_pkts_vec_avx2(void *tx_queue, struct rte_mbuf **tx_pkts,
+		uint16_t nb_pkts)
+{
+	struct ixgbe_tx_queue *txq = (struct ixgbe_tx_queue *)tx_queue;
+	uint16_t nb_tx = 0;
+
+	while (nb_pkts) {
+		uint16_t ret, num;
+
+		num = (uint16_t)RTE_MIN(nb_pkts, txq->tx_rs_thresh);
+		ret = ixgbe_xmit_fixed_burst_vec_avx2(tx_queue,
+				&tx_pkts[nb_tx], num);
+		nb_tx += ret;
+		nb_pkts -= ret;
+		if (ret < num)
+			break;
+	}
+
+	return nb_tx;
+}
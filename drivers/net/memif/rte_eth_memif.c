@@ -199,6 +199,7 @@ memif_dev_info(struct rte_eth_dev *dev __rte_unused, struct rte_eth_dev_info *de
 	dev_info->max_rx_queues = ETH_MEMIF_MAX_NUM_Q_PAIRS;
 	dev_info->max_tx_queues = ETH_MEMIF_MAX_NUM_Q_PAIRS;
 	dev_info->min_rx_bufsize = 0;
+	dev_info->tx_offload_capa = DEV_TX_OFFLOAD_MBUF_FAST_FREE;
 
 	return 0;
 }
@@ -432,6 +433,186 @@ eth_memif_rx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 	return n_rx_pkts;
 }
 
+/* Free callback of the external buffers attached to the mbufs received by
+ * the server in zero-copy mode. The slot is returned to the client by the
+ * next Rx burst, once the slots before it are also returned.
+ */
+static void
+memif_extbuf_free_cb(void *addr __rte_unused, void *opaque)
+{
+	struct memif_extbuf *eb = opaque;
+
+	__atomic_store_n(&eb->in_use, 0, __ATOMIC_RELEASE);
+}
+
+static void
+memif_extbufs_free(struct memif_queue *mq)
+{
+	uint16_t i;
+
+	if (mq->extbufs == NULL)
+		return;
+
+	for (i = 0; i < mq->nb_extbufs; i++) {
+		if (__atomic_load_n(&mq->extbufs[i].in_use,
+				    __ATOMIC_ACQUIRE)) {
+			/* The free callback of the mbuf will still use it */
+			MIF_LOG(WARNING, "Received mbufs are still in use.");
+			mq->extbufs = NULL;
+			return;
+		}
+	}
+
+	rte_free(mq->extbufs);
+	mq->extbufs = NULL;
+	mq->nb_extbufs = 0;
+}
+
+static int
+memif_extbufs_init(struct memif_queue *mq)
+{
+	uint16_t ring_size = 1 << mq->log2_ring_size;
+	struct memif_extbuf *eb;
+	uint16_t i;
+
+	memif_extbufs_free(mq);
+
+	mq->extbufs = rte_zmalloc("extbufs", sizeof(*mq->extbufs) * ring_size,
+				  RTE_CACHE_LINE_SIZE);
+	if (mq->extbufs == NULL)
+		return -ENOMEM;
+	mq->nb_extbufs = ring_size;
+
+	for (i = 0; i < ring_size; i++) {
+		eb = &mq->extbufs[i];
+		eb->shinfo.free_cb = memif_extbuf_free_cb;
+		eb->shinfo.fcb_opaque = eb;
+	}
+
+	return 0;
+}
+
+/* Server zero-copy rx: the buffers of the client are attached to the mbufs
+ * as external buffers instead of being copied. The slots are returned in
+ * order, so an mbuf kept by the application holds the slots after it.
+ */
+static uint16_t
+eth_memif_rx_extbuf(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
+{
+	struct memif_queue *mq = queue;
+	struct pmd_internals *pmd = rte_eth_devices[mq->in_port].data->dev_private;
+	struct pmd_process_private *proc_private =
+		rte_eth_devices[mq->in_port].process_private;
+	memif_ring_t *ring = memif_get_ring_from_queue(proc_private, mq);
+	uint16_t cur_slot, last_slot, n_slots, mask, s0, tail, pkt_slot;
+	uint16_t n_rx_pkts = 0;
+	memif_desc_t *d0;
+	struct memif_extbuf *eb;
+	struct rte_mbuf *mbuf, *mbuf_head, *mbuf_tail = NULL;
+	int ret;
+	struct rte_eth_link link;
+
+	if (unlikely((pmd->flags & ETH_MEMIF_FLAG_CONNECTED) == 0))
+		return 0;
+	if (unlikely(ring == NULL)) {
+		/* Secondary process will attempt to request regions. */
+		ret = rte_eth_link_get(mq->in_port, &link);
+		if (ret < 0)
+			MIF_LOG(ERR, "Failed to get port %u link info: %s",
+				mq->in_port, rte_strerror(-ret));
+		return 0;
+	}
+
+	/* consume interrupt */
+	if ((ring->flags & MEMIF_RING_FLAG_MASK_INT) == 0) {
+		uint64_t b;
+		ssize_t size __rte_unused;
+		size = read(mq->intr_handle.fd, &b, sizeof(b));
+	}
+
+	mask = (1 << mq->log2_ring_size) - 1;
+
+	/* Return the slots whose mbufs were freed to the client, the tail is
+	 * only updated by the receiver and this function is called in the
+	 * context of the receiver thread.
+	 */
+	tail = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+	while (tail != mq->last_head &&
+	       !__atomic_load_n(&mq->extbufs[tail & mask].in_use,
+				__ATOMIC_ACQUIRE))
+		tail++;
+	/* The ring->tail acts as a guard variable between Tx and Rx
+	 * threads, so using store-release pairs with load-acquire
+	 * in function eth_memif_tx.
+	 */
+	__atomic_store_n(&ring->tail, tail, __ATOMIC_RELEASE);
+
+	cur_slot = mq->last_head;
+	last_slot = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+	n_slots = last_slot - cur_slot;
+
+	while (n_slots && n_rx_pkts < nb_pkts) {
+		pkt_slot = cur_slot;
+		mbuf_head = NULL;
+
+		for (;;) {
+			mbuf = rte_pktmbuf_alloc(mq->mempool);
+			if (unlikely(mbuf == NULL))
+				goto no_free_bufs;
+
+			s0 = cur_slot & mask;
+			d0 = &ring->desc[s0];
+			eb = &mq->extbufs[s0];
+
+			__atomic_store_n(&eb->in_use, 1, __ATOMIC_RELAXED);
+			rte_mbuf_ext_refcnt_set(&eb->shinfo, 1);
+			rte_pktmbuf_attach_extbuf(mbuf,
+				memif_get_buffer(proc_private, d0),
+				RTE_BAD_IOVA, d0->length, &eb->shinfo);
+			mbuf->data_off = 0;
+			mbuf->port = mq->in_port;
+			rte_pktmbuf_data_len(mbuf) = d0->length;
+			rte_pktmbuf_pkt_len(mbuf) = d0->length;
+
+			if (mbuf_head == NULL) {
+				mbuf_head = mbuf;
+			} else if (unlikely(memif_pktmbuf_chain(mbuf_head,
+						mbuf_tail, mbuf) < 0)) {
+				MIF_LOG(ERR, "number-of-segments-overflow");
+				rte_pktmbuf_free(mbuf);
+				goto no_free_bufs;
+			}
+			mbuf_tail = mbuf;
+
+			cur_slot++;
+			n_slots--;
+
+			if (!(d0->flags & MEMIF_DESC_FLAG_NEXT))
+				break;
+			if (unlikely(n_slots == 0))
+				goto no_free_bufs;
+		}
+
+		mq->n_bytes += rte_pktmbuf_pkt_len(mbuf_head);
+		*bufs++ = mbuf_head;
+		n_rx_pkts++;
+	}
+
+	mq->last_head = cur_slot;
+	mq->n_pkts += n_rx_pkts;
+
+	return n_rx_pkts;
+
+no_free_bufs:
+	/* Leave the slots of the incomplete packet to the next burst */
+	if (mbuf_head != NULL)
+		rte_pktmbuf_free(mbuf_head);
+	mq->last_head = pkt_slot;
+	mq->n_pkts += n_rx_pkts;
+
+	return n_rx_pkts;
+}
+
 static uint16_t
 eth_memif_rx_zc(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 {
@@ -571,6 +752,7 @@ eth_memif_tx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 	memif_desc_t *d0;
 	struct rte_mbuf *mbuf;
 	struct rte_mbuf *mbuf_head;
+	struct rte_mbuf **sent = bufs;
 	uint64_t a;
 	ssize_t size;
 	struct rte_eth_link link;
@@ -665,10 +847,15 @@ eth_memif_tx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 		n_tx_pkts++;
 		slot++;
 		n_free--;
-		rte_pktmbuf_free(mbuf_head);
+		if (!mq->fast_free)
+			rte_pktmbuf_free(mbuf_head);
 	}
 
 no_free_slots:
+	/* the copied packets are freed at once */
+	if (mq->fast_free && n_tx_pkts != 0)
+		rte_pktmbuf_fast_free_bulk(sent[0]->pool, sent, n_tx_pkts);
+
 	if (type == MEMIF_RING_C2S)
 		__atomic_store_n(&ring->head, slot, __ATOMIC_RELEASE);
 	else
@@ -1153,7 +1340,7 @@ memif_connect(struct rte_eth_dev *dev)
 	struct memif_region *mr;
 	struct memif_queue *mq;
 	memif_ring_t *ring;
-	int i;
+	int i, ret;
 
 	for (i = 0; i < proc_private->regions_num; i++) {
 		mr = proc_private->regions[i];
@@ -1194,6 +1381,11 @@ memif_connect(struct rte_eth_dev *dev)
 			/* enable polling mode */
 			if (pmd->role == MEMIF_ROLE_SERVER)
 				ring->flags = MEMIF_RING_FLAG_MASK_INT;
+			if (pmd->flags & ETH_MEMIF_FLAG_RX_EXTBUF) {
+				ret = memif_extbufs_init(mq);
+				if (ret < 0)
+					return ret;
+			}
 		}
 		for (i = 0; i < pmd->run.num_s2c_rings; i++) {
 			mq = (pmd->role == MEMIF_ROLE_CLIENT) ?
@@ -1312,6 +1504,8 @@ memif_tx_queue_setup(struct rte_eth_dev *dev,
 	mq->intr_handle.fd = -1;
 	mq->intr_handle.type = RTE_INTR_HANDLE_EXT;
 	mq->in_port = dev->data->port_id;
+	mq->fast_free = !!(dev->data->dev_conf.txmode.offloads &
+			DEV_TX_OFFLOAD_MBUF_FAST_FREE);
 	dev->data->tx_queues[qid] = mq;
 
 	return 0;
@@ -1354,6 +1548,7 @@ memif_queue_release(void *queue)
 	if (!mq)
 		return;
 
+	memif_extbufs_free(mq);
 	rte_free(mq);
 }
 
@@ -1514,9 +1709,14 @@ memif_create(struct rte_vdev_device *vdev, enum memif_role_t role,
 	pmd->flags = flags;
 	pmd->flags |= ETH_MEMIF_FLAG_DISABLED;
 	pmd->role = role;
-	/* Zero-copy flag irelevant to server. */
-	if (pmd->role == MEMIF_ROLE_SERVER)
+	/* Zero-copy server attaches the client buffers to the received mbufs,
+	 * its tx and its shared memory are the same as with zero-copy disabled.
+	 */
+	if (pmd->role == MEMIF_ROLE_SERVER &&
+	    (pmd->flags & ETH_MEMIF_FLAG_ZERO_COPY)) {
 		pmd->flags &= ~ETH_MEMIF_FLAG_ZERO_COPY;
+		pmd->flags |= ETH_MEMIF_FLAG_RX_EXTBUF;
+	}
 
 	ret = memif_socket_init(eth_dev, socket_filename);
 	if (ret < 0)
@@ -1547,6 +1747,9 @@ memif_create(struct rte_vdev_device *vdev, enum memif_role_t role,
 	if (pmd->flags & ETH_MEMIF_FLAG_ZERO_COPY) {
 		eth_dev->rx_pkt_burst = eth_memif_rx_zc;
 		eth_dev->tx_pkt_burst = eth_memif_tx_zc;
+	} else if (pmd->flags & ETH_MEMIF_FLAG_RX_EXTBUF) {
+		eth_dev->rx_pkt_burst = eth_memif_rx_extbuf;
+		eth_dev->tx_pkt_burst = eth_memif_tx;
 	} else {
 		eth_dev->rx_pkt_burst = eth_memif_rx;
 		eth_dev->tx_pkt_burst = eth_memif_tx;
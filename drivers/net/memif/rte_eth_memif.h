@@ -10,6 +10,7 @@
 #include <ethdev_driver.h>
 #include <rte_ether.h>
 #include <rte_interrupts.h>
+#include <rte_mbuf.h>
 
 #include "memif.h"
 
@@ -44,6 +45,11 @@ struct memif_region {
 	/**< offset from 'addr' to first packet buffer */
 };
 
+struct memif_extbuf {
+	struct rte_mbuf_ext_shared_info shinfo;	/**< mbuf external buffer info */
+	uint8_t in_use;				/**< slot attached to an mbuf */
+};
+
 struct memif_queue {
 	struct rte_mempool *mempool;		/**< mempool for RX packets */
 	struct pmd_internals *pmd;		/**< device internals */
@@ -64,6 +70,12 @@ struct memif_queue {
 	 * mbufs to free them once server has received them.
 	 */
 
+	struct memif_extbuf *extbufs;
+	/**< External buffers of the ring slots. Used in zero-copy server rx.
+	 * The slots are returned to the client once their mbufs are freed.
+	 */
+	uint16_t nb_extbufs;			/**< number of external buffers */
+
 	/* rx/tx info */
 	uint64_t n_pkts;			/**< number of rx/tx packets */
 	uint64_t n_bytes;			/**< number of rx/tx bytes */
@@ -71,6 +83,9 @@ struct memif_queue {
 	struct rte_intr_handle intr_handle;	/**< interrupt handle */
 
 	memif_log2_ring_size_t log2_ring_size;	/**< log2 of ring size */
+
+	uint8_t fast_free;
+	/**< DEV_TX_OFFLOAD_MBUF_FAST_FREE, used in copy tx */
 };
 
 struct pmd_internals {
@@ -87,6 +102,8 @@ struct pmd_internals {
 /**< device has not been configured and can not accept connection requests */
 #define ETH_MEMIF_FLAG_SOCKET_ABSTRACT	(1 << 4)
 /**< use abstract socket address */
+#define ETH_MEMIF_FLAG_RX_EXTBUF		(1 << 5)
+/**< server receives into mbufs attached to the shared memory buffers */
 
 	char *socket_filename;			/**< pointer to socket filename */
 	char secret[ETH_MEMIF_SECRET_SIZE]; /**< secret (optional security parameter) */
@@ -148,6 +148,7 @@ struct rte_mp_msg mp_res;
 				return -rte_errno;
 			}
 		}
+		rte_eth_fp_ops_update(dev);
 		rte_mb();
 		mp_init_msg(&priv->mp_id, &mp_res, param->type);
 		res->result = 0;
@@ -157,6 +158,7 @@ struct rte_mp_msg mp_res;
 		DRV_LOG(INFO, "port %u stopping datapath", dev->data->port_id);
 		dev->rx_pkt_burst = removed_rx_burst;
 		dev->tx_pkt_burst = removed_tx_burst;
+		rte_eth_fp_ops_update(dev);
 		rte_mb();
 		mp_init_msg(&priv->mp_id, &mp_res, param->type);
 		res->result = 0;
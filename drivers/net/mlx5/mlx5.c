@@ -1528,6 +1528,7 @@ mlx5_dev_close(struct rte_eth_dev *dev)
 	 * If all the flows are already flushed in the device stop stage,
 	 * then this will return directly without any action.
 	 */
+	mlx5_flow_template_release(dev);
 	mlx5_flow_list_flush(dev, &priv->flows, true);
 	mlx5_action_handle_flush(dev);
 	mlx5_flow_meter_flush(dev, NULL);
@@ -580,6 +580,7 @@ struct mlx5_age_info {
 	uint8_t flags; /* Indicate if is new event or need to be triggered. */
 	struct mlx5_counters aged_counters; /* Aged counter list. */
 	struct aso_age_list aged_aso; /* Aged ASO actions list. */
+	uint32_t nb_aged; /* Number of aged counters and ASO actions. */
 	rte_spinlock_t aged_sl; /* Aged flow list lock. */
 };
 
@@ -1347,6 +1348,12 @@ struct mlx5_priv {
 	uint32_t flows; /* RTE Flow rules. */
 	uint32_t ctrl_flows; /* Control flow rules. */
 	rte_spinlock_t flow_list_lock;
+	struct mlx5_flow_queue *flow_queues; /* Asynchronous flow queues. */
+	uint16_t nb_flow_queues; /* Number of asynchronous flow queues. */
+	/* Flow templates and template tables. */
+	LIST_HEAD(flow_its, rte_flow_pattern_template) flow_its;
+	LIST_HEAD(flow_ats, rte_flow_actions_template) flow_ats;
+	LIST_HEAD(flow_tables, rte_flow_template_table) flow_tables;
 	struct mlx5_obj_ops obj_ops; /* HW objects operations. */
 	LIST_HEAD(rxq, mlx5_rxq_ctrl) rxqsctrl; /* DPDK Rx queues. */
 	LIST_HEAD(rxqobj, mlx5_rxq_obj) rxqsobj; /* Verbs/DevX Rx queues. */
@@ -1594,6 +1601,11 @@ struct rte_flow *mlx5_flow_create(struct rte_eth_dev *dev,
 				  const struct rte_flow_item items[],
 				  const struct rte_flow_action actions[],
 				  struct rte_flow_error *error);
+struct rte_flow *mlx5_flow_create_validated(struct rte_eth_dev *dev,
+					    const struct rte_flow_attr *attr,
+					    const struct rte_flow_item items[],
+					    const struct rte_flow_action actions[],
+					    struct rte_flow_error *error);
 int mlx5_flow_destroy(struct rte_eth_dev *dev, struct rte_flow *flow,
 		      struct rte_flow_error *error);
 void mlx5_flow_list_flush(struct rte_eth_dev *dev, uint32_t *list, bool active);
@@ -1629,6 +1641,10 @@ int mlx5_counter_query(struct rte_eth_dev *dev, uint32_t cnt,
 int mlx5_flow_dev_dump(struct rte_eth_dev *dev, struct rte_flow *flow,
 			FILE *file, struct rte_flow_error *error);
 void mlx5_flow_rxq_dynf_metadata_set(struct rte_eth_dev *dev);
+int mlx5_flow_query_count_bulk(struct rte_eth_dev *dev,
+			       struct rte_flow *flows[],
+			       struct rte_flow_query_count counts[],
+			       uint32_t nb_flows, struct rte_flow_error *error);
 int mlx5_flow_get_aged_flows(struct rte_eth_dev *dev, void **contexts,
 			uint32_t nb_contexts, struct rte_flow_error *error);
 int mlx5_validate_action_ct(struct rte_eth_dev *dev,
@@ -1636,6 +1652,67 @@ int mlx5_validate_action_ct(struct rte_eth_dev *dev,
 			    struct rte_flow_error *error);
 
 
+/* mlx5_flow_template.c */
+
+int mlx5_flow_info_get(struct rte_eth_dev *dev,
+		       struct rte_flow_port_info *port_info,
+		       struct rte_flow_queue_info *queue_info,
+		       struct rte_flow_error *error);
+int mlx5_flow_port_configure(struct rte_eth_dev *dev,
+			     const struct rte_flow_port_attr *port_attr,
+			     uint16_t nb_queue,
+			     const struct rte_flow_queue_attr *queue_attr[],
+			     struct rte_flow_error *error);
+struct rte_flow_pattern_template *mlx5_flow_pattern_template_create
+		(struct rte_eth_dev *dev,
+		 const struct rte_flow_pattern_template_attr *attr,
+		 const struct rte_flow_item pattern[],
+		 struct rte_flow_error *error);
+int mlx5_flow_pattern_template_destroy(struct rte_eth_dev *dev,
+				       struct rte_flow_pattern_template *it,
+				       struct rte_flow_error *error);
+struct rte_flow_actions_template *mlx5_flow_actions_template_create
+		(struct rte_eth_dev *dev,
+		 const struct rte_flow_actions_template_attr *attr,
+		 const struct rte_flow_action actions[],
+		 const struct rte_flow_action masks[],
+		 struct rte_flow_error *error);
+int mlx5_flow_actions_template_destroy(struct rte_eth_dev *dev,
+				       struct rte_flow_actions_template *at,
+				       struct rte_flow_error *error);
+struct rte_flow_template_table *mlx5_flow_template_table_create
+		(struct rte_eth_dev *dev,
+		 const struct rte_flow_template_table_attr *attr,
+		 struct rte_flow_pattern_template *its[],
+		 uint8_t nb_its,
+		 struct rte_flow_actions_template *ats[],
+		 uint8_t nb_ats,
+		 struct rte_flow_error *error);
+int mlx5_flow_template_table_destroy(struct rte_eth_dev *dev,
+				     struct rte_flow_template_table *table,
+				     struct rte_flow_error *error);
+struct rte_flow *mlx5_flow_async_create(struct rte_eth_dev *dev,
+					uint32_t queue,
+					const struct rte_flow_op_attr *attr,
+					struct rte_flow_template_table *table,
+					const struct rte_flow_item items[],
+					uint8_t it_idx,
+					const struct rte_flow_action actions[],
+					uint8_t at_idx,
+					void *user_data,
+					struct rte_flow_error *error);
+int mlx5_flow_async_destroy(struct rte_eth_dev *dev, uint32_t queue,
+			    const struct rte_flow_op_attr *attr,
+			    struct rte_flow *flow, void *user_data,
+			    struct rte_flow_error *error);
+int mlx5_flow_push(struct rte_eth_dev *dev, uint32_t queue,
+		   struct rte_flow_error *error);
+int mlx5_flow_pull(struct rte_eth_dev *dev, uint32_t queue,
+		   struct rte_flow_op_result res[], uint16_t n_res,
+		   struct rte_flow_error *error);
+void mlx5_flow_template_tables_flush(struct rte_eth_dev *dev);
+void mlx5_flow_template_release(struct rte_eth_dev *dev);
+
 /* mlx5_mp_os.c */
 
 int mlx5_mp_os_primary_handle(const struct rte_mp_msg *mp_msg,
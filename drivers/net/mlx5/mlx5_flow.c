@@ -649,6 +649,19 @@ static const struct rte_flow_ops mlx5_flow_ops = {
 	.tunnel_action_decap_release = mlx5_flow_tunnel_action_release,
 	.tunnel_item_release = mlx5_flow_tunnel_item_release,
 	.get_restore_info = mlx5_flow_tunnel_get_restore_info,
+	.info_get = mlx5_flow_info_get,
+	.configure = mlx5_flow_port_configure,
+	.pattern_template_create = mlx5_flow_pattern_template_create,
+	.pattern_template_destroy = mlx5_flow_pattern_template_destroy,
+	.actions_template_create = mlx5_flow_actions_template_create,
+	.actions_template_destroy = mlx5_flow_actions_template_destroy,
+	.template_table_create = mlx5_flow_template_table_create,
+	.template_table_destroy = mlx5_flow_template_table_destroy,
+	.async_create = mlx5_flow_async_create,
+	.async_destroy = mlx5_flow_async_destroy,
+	.push = mlx5_flow_push,
+	.pull = mlx5_flow_pull,
+	.query_count_bulk = mlx5_flow_query_count_bulk,
 };
 
 /* Tunnel information. */
@@ -6055,6 +6068,9 @@ flow_rss_workspace_adjust(struct mlx5_flow_workspace *wks,
  *   Associated actions (list terminated by the END action).
  * @param[in] external
  *   This flow rule is created by request external to PMD.
+ * @param[in] validated
+ *   The pattern and actions were already validated, as for the rules
+ *   created with templates.
  * @param[out] error
  *   Perform verbose error reporting if not NULL.
  *
@@ -6062,11 +6078,12 @@ flow_rss_workspace_adjust(struct mlx5_flow_workspace *wks,
  *   A flow index on success, 0 otherwise and rte_errno is set.
  */
 static uint32_t
-flow_list_create(struct rte_eth_dev *dev, uint32_t *list,
-		 const struct rte_flow_attr *attr,
-		 const struct rte_flow_item items[],
-		 const struct rte_flow_action original_actions[],
-		 bool external, struct rte_flow_error *error)
+flow_list_create_common(struct rte_eth_dev *dev, uint32_t *list,
+			const struct rte_flow_attr *attr,
+			const struct rte_flow_item items[],
+			const struct rte_flow_action original_actions[],
+			bool external, bool validated,
+			struct rte_flow_error *error)
 {
 	struct mlx5_priv *priv = dev->data->dev_private;
 	struct rte_flow *flow = NULL;
@@ -6126,10 +6143,12 @@ flow_list_create(struct rte_eth_dev *dev, uint32_t *list,
 	actions = translated_actions ? translated_actions : original_actions;
 	p_actions_rx = actions;
 	hairpin_flow = flow_check_hairpin_split(dev, attr, actions);
-	ret = flow_drv_validate(dev, attr, items, p_actions_rx,
-				external, hairpin_flow, error);
-	if (ret < 0)
-		goto error_before_hairpin_split;
+	if (!validated) {
+		ret = flow_drv_validate(dev, attr, items, p_actions_rx,
+					external, hairpin_flow, error);
+		if (ret < 0)
+			goto error_before_hairpin_split;
+	}
 	flow = mlx5_ipool_zmalloc(priv->sh->ipool[MLX5_IPOOL_RTE_FLOW], &idx);
 	if (!flow) {
 		rte_errno = ENOMEM;
@@ -6293,6 +6312,23 @@ flow_list_create(struct rte_eth_dev *dev, uint32_t *list,
 	return 0;
 }
 
+/**
+ * Create a flow and add it to @p list, after validating it.
+ *
+ * @see flow_list_create_common()
+ */
+static uint32_t
+flow_list_create(struct rte_eth_dev *dev, uint32_t *list,
+		 const struct rte_flow_attr *attr,
+		 const struct rte_flow_item items[],
+		 const struct rte_flow_action original_actions[],
+		 bool external, struct rte_flow_error *error)
+{
+	return flow_list_create_common(dev, list, attr, items,
+				       original_actions, external, false,
+				       error);
+}
+
 /**
  * Create a dedicated flow rule on e-switch table 0 (root table), to direct all
  * incoming packets to table 1.
@@ -6411,6 +6447,37 @@ mlx5_flow_create(struct rte_eth_dev *dev,
 				  attr, items, actions, true, error);
 }
 
+/**
+ * Create a flow whose pattern and actions were validated by a template
+ * table, without validating them again.
+ *
+ * @param dev
+ *   Pointer to Ethernet device.
+ * @param[in] attr
+ *   Flow rule attributes.
+ * @param[in] items
+ *   Pattern specification (list terminated by the END pattern item).
+ * @param[in] actions
+ *   Associated actions (list terminated by the END action).
+ * @param[out] error
+ *   Perform verbose error reporting if not NULL.
+ *
+ * @return
+ *   A flow on success, NULL otherwise and rte_errno is set.
+ */
+struct rte_flow *
+mlx5_flow_create_validated(struct rte_eth_dev *dev,
+			   const struct rte_flow_attr *attr,
+			   const struct rte_flow_item items[],
+			   const struct rte_flow_action actions[],
+			   struct rte_flow_error *error)
+{
+	struct mlx5_priv *priv = dev->data->dev_private;
+
+	return (void *)(uintptr_t)flow_list_create_common(dev, &priv->flows,
+				attr, items, actions, true, true, error);
+}
+
 /**
  * Destroy a flow in a list.
  *
@@ -6914,6 +6981,7 @@ mlx5_flow_flush(struct rte_eth_dev *dev,
 {
 	struct mlx5_priv *priv = dev->data->dev_private;
 
+	mlx5_flow_template_tables_flush(dev);
 	mlx5_flow_list_flush(dev, &priv->flows, false);
 	return 0;
 }
@@ -7625,6 +7693,7 @@ mlx5_flow_aging_check(struct mlx5_dev_ctx_shared *sh,
 						__ATOMIC_RELAXED,
 						__ATOMIC_RELAXED)) {
 			TAILQ_INSERT_TAIL(&age_info->aged_counters, cnt, next);
+			age_info->nb_aged++;
 			MLX5_AGE_SET(age_info, MLX5_AGE_EVENT_NEW);
 		}
 		rte_spinlock_unlock(&age_info->aged_sl);
@@ -7942,6 +8011,40 @@ mlx5_flow_get_aged_flows(struct rte_eth_dev *dev, void **contexts,
 	return -ENOTSUP;
 }
 
+/**
+ * Query the counters of a burst of flows.
+ *
+ * @see rte_flow_query_count_bulk()
+ * @see rte_flow_ops
+ */
+int
+mlx5_flow_query_count_bulk(struct rte_eth_dev *dev, struct rte_flow *flows[],
+			   struct rte_flow_query_count counts[],
+			   uint32_t nb_flows, struct rte_flow_error *error)
+{
+	static const struct rte_flow_action count[] = {
+		{ .type = RTE_FLOW_ACTION_TYPE_COUNT },
+		{ .type = RTE_FLOW_ACTION_TYPE_END },
+	};
+	const struct mlx5_flow_driver_ops *fops;
+	struct rte_flow_attr attr = { .transfer = 0 };
+	uint32_t i;
+	int ret;
+
+	if (flow_get_drv_type(dev, &attr) == MLX5_FLOW_TYPE_DV) {
+		fops = flow_get_drv_ops(MLX5_FLOW_TYPE_DV);
+		return fops->query_count_bulk(dev, flows, counts, nb_flows,
+					      error);
+	}
+	for (i = 0; i != nb_flows; ++i) {
+		ret = flow_drv_query(dev, (uintptr_t)(void *)flows[i], count,
+				     &counts[i], error);
+		if (ret < 0)
+			return ret;
+	}
+	return 0;
+}
+
 /* Wrapper for driver action_validate op callback */
 static int
 flow_drv_action_validate(struct rte_eth_dev *dev,
@@ -1176,6 +1176,12 @@ typedef int (*mlx5_flow_get_aged_flows_t)
 					 void **context,
 					 uint32_t nb_contexts,
 					 struct rte_flow_error *error);
+typedef int (*mlx5_flow_query_count_bulk_t)
+					(struct rte_eth_dev *dev,
+					 struct rte_flow *flows[],
+					 struct rte_flow_query_count counts[],
+					 uint32_t nb_flows,
+					 struct rte_flow_error *error);
 typedef int (*mlx5_flow_action_validate_t)
 				(struct rte_eth_dev *dev,
 				 const struct rte_flow_indir_action_conf *conf,
@@ -1257,6 +1263,7 @@ struct mlx5_flow_driver_ops {
 	mlx5_flow_counter_free_t counter_free;
 	mlx5_flow_counter_query_t counter_query;
 	mlx5_flow_get_aged_flows_t get_aged_flows;
+	mlx5_flow_query_count_bulk_t query_count_bulk;
 	mlx5_flow_action_validate_t action_validate;
 	mlx5_flow_action_create_t action_create;
 	mlx5_flow_action_destroy_t action_destroy;
@@ -1695,4 +1702,64 @@ mlx5_get_tof(const struct rte_flow_item *items,
 	     enum mlx5_tof_rule_type *rule_type);
 
 
+/* Maximum number of items and actions of the flow templates. */
+#define MLX5_FLOW_TEMPLATE_MAX_ITEMS 32
+#define MLX5_FLOW_TEMPLATE_MAX_ACTIONS 32
+
+/* Maximum number of operations of an asynchronous flow queue. */
+#define MLX5_FLOW_QUEUE_MAX_SIZE (1u << 24)
+
+/* Pattern template. */
+struct rte_flow_pattern_template {
+	LIST_ENTRY(rte_flow_pattern_template) next;
+	struct rte_flow_pattern_template_attr attr;
+	struct rte_flow_item *items; /* Copy of the pattern. */
+	uint32_t nb_items; /* Number of items, END excluded. */
+	uint32_t refcnt; /* Number of tables using the template. */
+};
+
+/* Actions template. */
+struct rte_flow_actions_template {
+	LIST_ENTRY(rte_flow_actions_template) next;
+	struct rte_flow_actions_template_attr attr;
+	struct rte_flow_action *actions; /* Copy of the actions. */
+	struct rte_flow_action *masks; /* Copy of the masks. */
+	uint32_t nb_actions; /* Number of actions, END excluded. */
+	uint32_t refcnt; /* Number of tables using the template. */
+};
+
+/* Rule created in a template table. */
+struct mlx5_flow_template_rule {
+	struct rte_flow_template_table *table;
+	struct rte_flow *flow; /* Flow of the rule, NULL if free. */
+};
+
+/* Template table. */
+struct rte_flow_template_table {
+	LIST_ENTRY(rte_flow_template_table) next;
+	struct rte_flow_template_table_attr attr;
+	struct rte_flow_pattern_template **its; /* Pattern templates. */
+	struct rte_flow_actions_template **ats; /* Actions templates. */
+	uint8_t nb_its; /* Number of pattern templates. */
+	uint8_t nb_ats; /* Number of actions templates. */
+	rte_spinlock_t lock; /* Protects the stack of free rules. */
+	uint32_t nb_free; /* Number of free rules. */
+	uint32_t *free; /* Stack of the free rules indexes. */
+	struct mlx5_flow_template_rule *rules; /* attr.nb_flows rules. */
+};
+
+/* Completed asynchronous operation, waiting to be pulled. */
+struct mlx5_flow_queue_op {
+	struct rte_flow_op_result res;
+	struct mlx5_flow_template_rule *release; /* Rule freed on pull. */
+};
+
+/* Asynchronous flow queue, used by a single thread. */
+struct mlx5_flow_queue {
+	uint32_t size; /* Number of operations, power of 2. */
+	uint32_t prod; /* Number of operations completed. */
+	uint32_t cons; /* Number of operations pulled. */
+	struct mlx5_flow_queue_op *ops; /* Operations ring. */
+} __rte_cache_aligned;
+
 #endif /* RTE_PMD_MLX5_FLOW_H_ */
@@ -553,6 +553,7 @@ mlx5_aso_age_action_update(struct mlx5_dev_ctx_shared *sh, uint16_t n)
 							    __ATOMIC_RELAXED)) {
 					LIST_INSERT_HEAD(&age_info->aged_aso,
 							 act, next);
+					age_info->nb_aged++;
 					MLX5_AGE_SET(age_info,
 						     MLX5_AGE_EVENT_NEW);
 				}
@@ -6083,6 +6083,7 @@ flow_dv_counter_remove_from_age(struct rte_eth_dev *dev,
 		 */
 		rte_spinlock_lock(&age_info->aged_sl);
 		TAILQ_REMOVE(&age_info->aged_counters, cnt, next);
+		age_info->nb_aged--;
 		rte_spinlock_unlock(&age_info->aged_sl);
 		__atomic_store_n(&age_param->state, AGE_FREE, __ATOMIC_RELAXED);
 	}
@@ -11299,6 +11300,7 @@ flow_dv_aso_age_remove_from_age(struct rte_eth_dev *dev,
 		 */
 		rte_spinlock_lock(&age_info->aged_sl);
 		LIST_REMOVE(age, next);
+		age_info->nb_aged--;
 		rte_spinlock_unlock(&age_info->aged_sl);
 		__atomic_store_n(&age_param->state, AGE_FREE, __ATOMIC_RELAXED);
 	}
@@ -16241,6 +16243,104 @@ flow_dv_counter_query(struct rte_eth_dev *dev, uint32_t counter, bool clear,
 	return 0;
 }
 
+/**
+ * Query the counters of a burst of flows.
+ * The counters of a pool are read from the raw data of its last
+ * asynchronous query, the pool lock being taken once for the
+ * consecutive counters of the same pool.
+ *
+ * @param[in] dev
+ *   Pointer to the Ethernet device structure.
+ * @param[in] flows
+ *   Array of the flow indexes.
+ * @param[in, out] counts
+ *   Array of the counters of the flows.
+ * @param[in] nb_flows
+ *   Number of flows.
+ * @param[out] error
+ *   Perform verbose error reporting if not NULL.
+ *
+ * @return
+ *   0 on success, a negative errno value otherwise and rte_errno is set.
+ */
+static int
+flow_dv_query_count_bulk(struct rte_eth_dev *dev, struct rte_flow *flows[],
+			 struct rte_flow_query_count counts[],
+			 uint32_t nb_flows, struct rte_flow_error *error)
+{
+	struct mlx5_priv *priv = dev->data->dev_private;
+	struct mlx5_flow_counter_pool *locked = NULL;
+	struct mlx5_flow_counter_pool *pool;
+	struct mlx5_flow_counter *cnt;
+	struct rte_flow_query_count *qc;
+	struct rte_flow *flow;
+	uint64_t pkts, bytes;
+	uint32_t i;
+	int offset;
+
+	if (!priv->config.devx)
+		return rte_flow_error_set(error, ENOTSUP,
+					  RTE_FLOW_ERROR_TYPE_UNSPECIFIED,
+					  NULL,
+					  "counters are not supported");
+	for (i = 0; i != nb_flows; ++i) {
+		qc = &counts[i];
+		flow = mlx5_ipool_get(priv->sh->ipool[MLX5_IPOOL_RTE_FLOW],
+				      (uintptr_t)(void *)flows[i]);
+		if (!flow) {
+			if (locked)
+				rte_spinlock_unlock(&locked->sl);
+			return rte_flow_error_set(error, ENOENT,
+					RTE_FLOW_ERROR_TYPE_HANDLE,
+					NULL, "invalid flow handle");
+		}
+		if (!flow->counter) {
+			qc->hits_set = 0;
+			qc->bytes_set = 0;
+			continue;
+		}
+		if (priv->sh->cmng.counter_fallback) {
+			if (_flow_dv_query_count(dev, flow->counter, &pkts,
+						 &bytes))
+				return rte_flow_error_set(error, EIO,
+					RTE_FLOW_ERROR_TYPE_UNSPECIFIED,
+					NULL, "cannot read counters");
+			cnt = flow_dv_counter_get_by_idx(dev, flow->counter,
+							 NULL);
+		} else {
+			cnt = flow_dv_counter_get_by_idx(dev, flow->counter,
+							 &pool);
+			if (pool != locked) {
+				if (locked)
+					rte_spinlock_unlock(&locked->sl);
+				rte_spinlock_lock(&pool->sl);
+				locked = pool;
+			}
+			if (!pool->raw) {
+				pkts = 0;
+				bytes = 0;
+			} else {
+				offset = MLX5_CNT_ARRAY_IDX(pool, cnt);
+				pkts = rte_be_to_cpu_64
+					(pool->raw->data[offset].hits);
+				bytes = rte_be_to_cpu_64
+					(pool->raw->data[offset].bytes);
+			}
+		}
+		qc->hits_set = 1;
+		qc->bytes_set = 1;
+		qc->hits = pkts - cnt->hits;
+		qc->bytes = bytes - cnt->bytes;
+		if (qc->reset) {
+			cnt->hits = pkts;
+			cnt->bytes = bytes;
+		}
+	}
+	if (locked)
+		rte_spinlock_unlock(&locked->sl);
+	return 0;
+}
+
 /**
  * Get aged-out flows.
  *
@@ -16280,24 +16380,23 @@ flow_get_aged_flows(struct rte_eth_dev *dev,
 					  NULL, "empty context");
 	age_info = GET_PORT_AGE_INFO(priv);
 	rte_spinlock_lock(&age_info->aged_sl);
+	if (!nb_contexts) {
+		/* Counted without walking the aged lists. */
+		nb_flows = age_info->nb_aged;
+		goto unlock;
+	}
 	LIST_FOREACH(act, &age_info->aged_aso, next) {
-		nb_flows++;
-		if (nb_contexts) {
-			context[nb_flows - 1] =
-						act->age_params.context;
-			if (!(--nb_contexts))
-				break;
-		}
+		if ((uint32_t)nb_flows == nb_contexts)
+			goto unlock;
+		context[nb_flows++] = act->age_params.context;
 	}
 	TAILQ_FOREACH(counter, &age_info->aged_counters, next) {
-		nb_flows++;
-		if (nb_contexts) {
-			age_param = MLX5_CNT_TO_AGE(counter);
-			context[nb_flows - 1] = age_param->context;
-			if (!(--nb_contexts))
-				break;
-		}
+		if ((uint32_t)nb_flows == nb_contexts)
+			break;
+		age_param = MLX5_CNT_TO_AGE(counter);
+		context[nb_flows++] = age_param->context;
 	}
+unlock:
 	rte_spinlock_unlock(&age_info->aged_sl);
 	MLX5_AGE_SET(age_info, MLX5_AGE_TRIGGER);
 	return nb_flows;
@@ -16727,6 +16826,7 @@ const struct mlx5_flow_driver_ops mlx5_flow_dv_drv_ops = {
 	.counter_free = flow_dv_counter_free,
 	.counter_query = flow_dv_counter_query,
 	.get_aged_flows = flow_get_aged_flows,
+	.query_count_bulk = flow_dv_query_count_bulk,
 	.action_validate = flow_dv_action_validate,
 	.action_create = flow_dv_action_create,
 	.action_destroy = flow_dv_action_destroy,
@@ -0,0 +1,662 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright 2021 Mellanox Technologies, Ltd
+ */
+#include <rte_flow.h>
+#include <rte_flow_driver.h>
+#include <rte_malloc.h>
+
+#include <mlx5_malloc.h>
+
+#include "mlx5.h"
+#include "mlx5_flow.h"
+
+/*
+ * Flow templates and asynchronous flow queues.
+ *
+ * The combinations of the pattern and actions templates of a table are
+ * validated once, at the table creation, so that the rules created in
+ * the table are not validated again. The rules are inserted when they
+ * are enqueued, and the queues only hold the results of the completed
+ * operations until they are pulled.
+ */
+
+/**
+ * Get information about the flow engine resources.
+ *
+ * @see rte_flow_info_get()
+ * @see rte_flow_ops
+ */
+int
+mlx5_flow_info_get(struct rte_eth_dev *dev __rte_unused,
+		   struct rte_flow_port_info *port_info,
+		   struct rte_flow_queue_info *queue_info,
+		   struct rte_flow_error *error __rte_unused)
+{
+	memset(port_info, 0, sizeof(*port_info));
+	memset(queue_info, 0, sizeof(*queue_info));
+	port_info->max_nb_queues = UINT16_MAX;
+	queue_info->max_size = MLX5_FLOW_QUEUE_MAX_SIZE;
+	return 0;
+}
+
+/**
+ * Configure the asynchronous flow queues.
+ * The resources hints of the port attributes are not used, the counters,
+ * aging and meter objects being allocated on demand.
+ *
+ * @see rte_flow_configure()
+ * @see rte_flow_ops
+ */
+int
+mlx5_flow_port_configure(struct rte_eth_dev *dev,
+			 const struct rte_flow_port_attr *port_attr __rte_unused,
+			 uint16_t nb_queue,
+			 const struct rte_flow_queue_attr *queue_attr[],
+			 struct rte_flow_error *error)
+{
+	struct mlx5_priv *priv = dev->data->dev_private;
+	struct mlx5_flow_queue *queues = NULL;
+	uint16_t i;
+
+	if (!LIST_EMPTY(&priv->flow_its) || !LIST_EMPTY(&priv->flow_ats) ||
+	    !LIST_EMPTY(&priv->flow_tables))
+		return rte_flow_error_set(error, EBUSY,
+					  RTE_FLOW_ERROR_TYPE_UNSPECIFIED, NULL,
+					  "flow templates still in use");
+	for (i = 0; i < nb_queue; i++)
+		if (queue_attr[i]->size > MLX5_FLOW_QUEUE_MAX_SIZE)
+			return rte_flow_error_set(error, EINVAL,
+					RTE_FLOW_ERROR_TYPE_UNSPECIFIED, NULL,
+					"flow queue size too large");
+	if (nb_queue) {
+		queues = mlx5_malloc(MLX5_MEM_ZERO, sizeof(*queues) * nb_queue,
+				     RTE_CACHE_LINE_SIZE, SOCKET_ID_ANY);
+		if (!queues)
+			goto error;
+	}
+	for (i = 0; i < nb_queue; i++) {
+		queues[i].size = rte_align32pow2(queue_attr[i]->size);
+		queues[i].ops = mlx5_malloc(MLX5_MEM_ZERO,
+					    sizeof(*queues[i].ops) *
+					    queues[i].size,
+					    RTE_CACHE_LINE_SIZE, SOCKET_ID_ANY);
+		if (!queues[i].ops)
+			goto error;
+	}
+	mlx5_flow_template_release(dev);
+	priv->flow_queues = queues;
+	priv->nb_flow_queues = nb_queue;
+	return 0;
+error:
+	if (queues) {
+		for (i = 0; i < nb_queue; i++)
+			mlx5_free(queues[i].ops);
+		mlx5_free(queues);
+	}
+	return rte_flow_error_set(error, ENOMEM,
+				  RTE_FLOW_ERROR_TYPE_UNSPECIFIED, NULL,
+				  "cannot allocate flow queues");
+}
+
+/**
+ * Create a pattern template, keeping a copy of the pattern.
+ *
+ * @see rte_flow_pattern_template_create()
+ * @see rte_flow_ops
+ */
+struct rte_flow_pattern_template *
+mlx5_flow_pattern_template_create(struct rte_eth_dev *dev,
+			const struct rte_flow_pattern_template_attr *attr,
+			const struct rte_flow_item pattern[],
+			struct rte_flow_error *error)
+{
+	struct mlx5_priv *priv = dev->data->dev_private;
+	struct rte_flow_pattern_template *it;
+	uint32_t nb_items = 0;
+	int size;
+
+	while (pattern[nb_items].type != RTE_FLOW_ITEM_TYPE_END)
+		nb_items++;
+	if (nb_items > MLX5_FLOW_TEMPLATE_MAX_ITEMS) {
+		rte_flow_error_set(error, ENOTSUP, RTE_FLOW_ERROR_TYPE_ITEM_NUM,
+				   NULL, "too many items in pattern template");
+		return NULL;
+	}
+	size = rte_flow_conv(RTE_FLOW_CONV_OP_PATTERN, NULL, 0, pattern,
+			     error);
+	if (size < 0)
+		return NULL;
+	it = mlx5_malloc(MLX5_MEM_ZERO, sizeof(*it) + size, 0, SOCKET_ID_ANY);
+	if (!it) {
+		rte_flow_error_set(error, ENOMEM,
+				   RTE_FLOW_ERROR_TYPE_UNSPECIFIED, NULL,
+				   "cannot allocate pattern template");
+		return NULL;
+	}
+	it->items = (struct rte_flow_item *)(it + 1);
+	size = rte_flow_conv(RTE_FLOW_CONV_OP_PATTERN, it->items, size,
+			     pattern, error);
+	if (size < 0) {
+		mlx5_free(it);
+		return NULL;
+	}
+	it->attr = *attr;
+	it->nb_items = nb_items;
+	LIST_INSERT_HEAD(&priv->flow_its, it, next);
+	return it;
+}
+
+/**
+ * Destroy a pattern template.
+ *
+ * @see rte_flow_pattern_template_destroy()
+ * @see rte_flow_ops
+ */
+int
+mlx5_flow_pattern_template_destroy(struct rte_eth_dev *dev __rte_unused,
+				   struct rte_flow_pattern_template *it,
+				   struct rte_flow_error *error)
+{
+	if (it->refcnt)
+		return rte_flow_error_set(error, EBUSY,
+					  RTE_FLOW_ERROR_TYPE_UNSPECIFIED, NULL,
+					  "pattern template in use");
+	LIST_REMOVE(it, next);
+	mlx5_free(it);
+	return 0;
+}
+
+/**
+ * Create an actions template, keeping a copy of the actions and masks.
+ *
+ * @see rte_flow_actions_template_create()
+ * @see rte_flow_ops
+ */
+struct rte_flow_actions_template *
+mlx5_flow_actions_template_create(struct rte_eth_dev *dev,
+			const struct rte_flow_actions_template_attr *attr,
+			const struct rte_flow_action actions[],
+			const struct rte_flow_action masks[],
+			struct rte_flow_error *error)
+{
+	struct mlx5_priv *priv = dev->data->dev_private;
+	struct rte_flow_actions_template *at;
+	uint32_t nb_actions = 0;
+	int act_size;
+	int mask_size;
+
+	while (actions[nb_actions].type != RTE_FLOW_ACTION_TYPE_END) {
+		if (masks[nb_actions].type != actions[nb_actions].type) {
+			rte_flow_error_set(error, EINVAL,
+					   RTE_FLOW_ERROR_TYPE_ACTION,
+					   &masks[nb_actions],
+					   "mask type differs from action");
+			return NULL;
+		}
+		nb_actions++;
+	}
+	if (masks[nb_actions].type != RTE_FLOW_ACTION_TYPE_END) {
+		rte_flow_error_set(error, EINVAL, RTE_FLOW_ERROR_TYPE_ACTION,
+				   &masks[nb_actions],
+				   "masks longer than actions");
+		return NULL;
+	}
+	if (nb_actions > MLX5_FLOW_TEMPLATE_MAX_ACTIONS) {
+		rte_flow_error_set(error, ENOTSUP,
+				   RTE_FLOW_ERROR_TYPE_ACTION_NUM, NULL,
+				   "too many actions in actions template");
+		return NULL;
+	}
+	act_size = rte_flow_conv(RTE_FLOW_CONV_OP_ACTIONS, NULL, 0, actions,
+				 error);
+	if (act_size < 0)
+		return NULL;
+	act_size = RTE_ALIGN(act_size, sizeof(double));
+	mask_size = rte_flow_conv(RTE_FLOW_CONV_OP_ACTIONS, NULL, 0, masks,
+				  error);
+	if (mask_size < 0)
+		return NULL;
+	at = mlx5_malloc(MLX5_MEM_ZERO, sizeof(*at) + act_size + mask_size,
+			 0, SOCKET_ID_ANY);
+	if (!at) {
+		rte_flow_error_set(error, ENOMEM,
+				   RTE_FLOW_ERROR_TYPE_UNSPECIFIED, NULL,
+				   "cannot allocate actions template");
+		return NULL;
+	}
+	at->actions = (struct rte_flow_action *)(at + 1);
+	at->masks = (struct rte_flow_action *)
+		    ((uint8_t *)at->actions + act_size);
+	if (rte_flow_conv(RTE_FLOW_CONV_OP_ACTIONS, at->actions, act_size,
+			  actions, error) < 0 ||
+	    rte_flow_conv(RTE_FLOW_CONV_OP_ACTIONS, at->masks, mask_size,
+			  masks, error) < 0) {
+		mlx5_free(at);
+		return NULL;
+	}
+	at->attr = *attr;
+	at->nb_actions = nb_actions;
+	LIST_INSERT_HEAD(&priv->flow_ats, at, next);
+	return at;
+}
+
+/**
+ * Destroy an actions template.
+ *
+ * @see rte_flow_actions_template_destroy()
+ * @see rte_flow_ops
+ */
+int
+mlx5_flow_actions_template_destroy(struct rte_eth_dev *dev __rte_unused,
+				   struct rte_flow_actions_template *at,
+				   struct rte_flow_error *error)
+{
+	if (at->refcnt)
+		return rte_flow_error_set(error, EBUSY,
+					  RTE_FLOW_ERROR_TYPE_UNSPECIFIED, NULL,
+					  "actions template in use");
+	LIST_REMOVE(at, next);
+	mlx5_free(at);
+	return 0;
+}
+
+/**
+ * Check the direction of a template matches the flow attributes
+ * of a table.
+ */
+static bool
+flow_template_attr_match(const struct rte_flow_attr *attr,
+			 uint32_t ingress, uint32_t egress, uint32_t transfer)
+{
+	return (!attr->ingress || ingress) && (!attr->egress || egress) &&
+	       (!attr->transfer || transfer);
+}
+
+/**
+ * Create a template table, validating all the combinations of its
+ * pattern and actions templates.
+ *
+ * @see rte_flow_template_table_create()
+ * @see rte_flow_ops
+ */
+struct rte_flow_template_table *
+mlx5_flow_template_table_create(struct rte_eth_dev *dev,
+				const struct rte_flow_template_table_attr *attr,
+				struct rte_flow_pattern_template *its[],
+				uint8_t nb_its,
+				struct rte_flow_actions_template *ats[],
+				uint8_t nb_ats,
+				struct rte_flow_error *error)
+{
+	struct mlx5_priv *priv = dev->data->dev_private;
+	const struct rte_flow_attr *flow_attr = &attr->flow_attr;
+	struct rte_flow_template_table *table;
+	size_t size;
+	uint32_t i;
+	uint32_t j;
+
+	if (!attr->nb_flows) {
+		rte_flow_error_set(error, EINVAL,
+				   RTE_FLOW_ERROR_TYPE_UNSPECIFIED, NULL,
+				   "template table without rules");
+		return NULL;
+	}
+	for (i = 0; i < nb_its; i++) {
+		if (!flow_template_attr_match(flow_attr, its[i]->attr.ingress,
+					      its[i]->attr.egress,
+					      its[i]->attr.transfer)) {
+			rte_flow_error_set(error, EINVAL,
+					   RTE_FLOW_ERROR_TYPE_ATTR, NULL,
+					   "pattern template direction differs"
+					   " from table");
+			return NULL;
+		}
+	}
+	for (j = 0; j < nb_ats; j++) {
+		if (!flow_template_attr_match(flow_attr, ats[j]->attr.ingress,
+					      ats[j]->attr.egress,
+					      ats[j]->attr.transfer)) {
+			rte_flow_error_set(error, EINVAL,
+					   RTE_FLOW_ERROR_TYPE_ATTR, NULL,
+					   "actions template direction differs"
+					   " from table");
+			return NULL;
+		}
+	}
+	for (i = 0; i < nb_its; i++)
+		for (j = 0; j < nb_ats; j++)
+			if (mlx5_flow_validate(dev, flow_attr, its[i]->items,
+					       ats[j]->actions, error))
+				return NULL;
+	size = sizeof(*table) +
+	       sizeof(*table->its) * nb_its +
+	       sizeof(*table->ats) * nb_ats +
+	       sizeof(*table->free) * attr->nb_flows;
+	size = RTE_ALIGN(size, sizeof(void *)) +
+	       sizeof(*table->rules) * attr->nb_flows;
+	table = mlx5_malloc(MLX5_MEM_ZERO, size, RTE_CACHE_LINE_SIZE,
+			    SOCKET_ID_ANY);
+	if (!table) {
+		rte_flow_error_set(error, ENOMEM,
+				   RTE_FLOW_ERROR_TYPE_UNSPECIFIED, NULL,
+				   "cannot allocate template table");
+		return NULL;
+	}
+	table->attr = *attr;
+	table->its = (struct rte_flow_pattern_template **)(table + 1);
+	table->ats = (struct rte_flow_actions_template **)
+		     (table->its + nb_its);
+	table->free = (uint32_t *)(table->ats + nb_ats);
+	table->rules = (struct mlx5_flow_template_rule *)
+		       RTE_PTR_ALIGN_CEIL(table->free + attr->nb_flows,
+					  sizeof(void *));
+	table->nb_its = nb_its;
+	table->nb_ats = nb_ats;
+	for (i = 0; i < nb_its; i++) {
+		table->its[i] = its[i];
+		its[i]->refcnt++;
+	}
+	for (j = 0; j < nb_ats; j++) {
+		table->ats[j] = ats[j];
+		ats[j]->refcnt++;
+	}
+	rte_spinlock_init(&table->lock);
+	for (i = 0; i < attr->nb_flows; i++) {
+		table->rules[i].table = table;
+		table->free[i] = attr->nb_flows - i - 1;
+	}
+	table->nb_free = attr->nb_flows;
+	LIST_INSERT_HEAD(&priv->flow_tables, table, next);
+	return table;
+}
+
+/**
+ * Destroy a template table.
+ *
+ * @see rte_flow_template_table_destroy()
+ * @see rte_flow_ops
+ */
+int
+mlx5_flow_template_table_destroy(struct rte_eth_dev *dev __rte_unused,
+				 struct rte_flow_template_table *table,
+				 struct rte_flow_error *error)
+{
+	uint32_t i;
+
+	if (table->nb_free != table->attr.nb_flows)
+		return rte_flow_error_set(error, EBUSY,
+					  RTE_FLOW_ERROR_TYPE_UNSPECIFIED, NULL,
+					  "template table has rules");
+	for (i = 0; i < table->nb_its; i++)
+		table->its[i]->refcnt--;
+	for (i = 0; i < table->nb_ats; i++)
+		table->ats[i]->refcnt--;
+	LIST_REMOVE(table, next);
+	mlx5_free(table);
+	return 0;
+}
+
+/**
+ * Get a flow queue with room for one more operation.
+ *
+ * @return
+ *   The queue on success, NULL otherwise and rte_errno is set.
+ */
+static struct mlx5_flow_queue *
+flow_queue_get(struct rte_eth_dev *dev, uint32_t queue,
+	       struct rte_flow_error *error)
+{
+	struct mlx5_priv *priv = dev->data->dev_private;
+	struct mlx5_flow_queue *q;
+
+	if (queue >= priv->nb_flow_queues) {
+		rte_flow_error_set(error, EINVAL,
+				   RTE_FLOW_ERROR_TYPE_UNSPECIFIED, NULL,
+				   "invalid flow queue");
+		return NULL;
+	}
+	q = &priv->flow_queues[queue];
+	if (q->prod - q->cons == q->size) {
+		rte_flow_error_set(error, EAGAIN,
+				   RTE_FLOW_ERROR_TYPE_UNSPECIFIED, NULL,
+				   "flow queue full");
+		return NULL;
+	}
+	return q;
+}
+
+/**
+ * Store the result of a completed operation in a flow queue.
+ */
+static void
+flow_queue_complete(struct mlx5_flow_queue *q, bool success, void *user_data,
+		    struct mlx5_flow_template_rule *release)
+{
+	struct mlx5_flow_queue_op *op = &q->ops[q->prod & (q->size - 1)];
+
+	op->res.status = success ? RTE_FLOW_OP_SUCCESS : RTE_FLOW_OP_ERROR;
+	op->res.user_data = user_data;
+	op->release = release;
+	q->prod++;
+}
+
+/**
+ * Enqueue the creation of a rule in a template table.
+ * The rule is inserted right away, from the items and actions of the
+ * templates completed by the rule specs and configurations.
+ *
+ * @see rte_flow_async_create()
+ * @see rte_flow_ops
+ */
+struct rte_flow *
+mlx5_flow_async_create(struct rte_eth_dev *dev,
+		       uint32_t queue,
+		       const struct rte_flow_op_attr *attr __rte_unused,
+		       struct rte_flow_template_table *table,
+		       const struct rte_flow_item items[],
+		       uint8_t it_idx,
+		       const struct rte_flow_action actions[],
+		       uint8_t at_idx,
+		       void *user_data,
+		       struct rte_flow_error *error)
+{
+	struct rte_flow_item rule_items[MLX5_FLOW_TEMPLATE_MAX_ITEMS + 1];
+	struct rte_flow_action rule_actions[MLX5_FLOW_TEMPLATE_MAX_ACTIONS + 1];
+	struct rte_flow_pattern_template *it;
+	struct rte_flow_actions_template *at;
+	struct mlx5_flow_template_rule *rule;
+	struct mlx5_flow_queue *q;
+	uint32_t i;
+
+	if (it_idx >= table->nb_its || at_idx >= table->nb_ats) {
+		rte_flow_error_set(error, EINVAL,
+				   RTE_FLOW_ERROR_TYPE_UNSPECIFIED, NULL,
+				   "invalid template index");
+		return NULL;
+	}
+	q = flow_queue_get(dev, queue, error);
+	if (!q)
+		return NULL;
+	rte_spinlock_lock(&table->lock);
+	if (!table->nb_free) {
+		rte_spinlock_unlock(&table->lock);
+		rte_flow_error_set(error, ENOSPC,
+				   RTE_FLOW_ERROR_TYPE_UNSPECIFIED, NULL,
+				   "template table full");
+		return NULL;
+	}
+	rule = &table->rules[table->free[--table->nb_free]];
+	rte_spinlock_unlock(&table->lock);
+	it = table->its[it_idx];
+	for (i = 0; i < it->nb_items; i++) {
+		rule_items[i].type = it->items[i].type;
+		rule_items[i].spec = items[i].spec;
+		rule_items[i].last = NULL;
+		rule_items[i].mask = it->items[i].mask;
+	}
+	rule_items[i] = (struct rte_flow_item){
+		.type = RTE_FLOW_ITEM_TYPE_END,
+	};
+	at = table->ats[at_idx];
+	for (i = 0; i < at->nb_actions; i++) {
+		rule_actions[i].type = at->actions[i].type;
+		rule_actions[i].conf = at->masks[i].conf ?
+				       at->actions[i].conf : actions[i].conf;
+	}
+	rule_actions[i] = (struct rte_flow_action){
+		.type = RTE_FLOW_ACTION_TYPE_END,
+	};
+	rule->flow = mlx5_flow_create_validated(dev, &table->attr.flow_attr,
+						rule_items, rule_actions,
+						NULL);
+	/* A failed rule is released once its result is pulled. */
+	flow_queue_complete(q, !!rule->flow, user_data,
+			    rule->flow ? NULL : rule);
+	return (struct rte_flow *)(uintptr_t)rule;
+}
+
+/**
+ * Enqueue the destruction of a rule created in a template table.
+ *
+ * @see rte_flow_async_destroy()
+ * @see rte_flow_ops
+ */
+int
+mlx5_flow_async_destroy(struct rte_eth_dev *dev, uint32_t queue,
+			const struct rte_flow_op_attr *attr __rte_unused,
+			struct rte_flow *flow, void *user_data,
+			struct rte_flow_error *error)
+{
+	uintptr_t handle = (uintptr_t)(void *)flow;
+	struct mlx5_flow_template_rule *rule = (void *)handle;
+	struct mlx5_flow_queue *q = flow_queue_get(dev, queue, error);
+
+	if (!q)
+		return -rte_errno;
+	if (rule->flow) {
+		mlx5_flow_destroy(dev, rule->flow, NULL);
+		rule->flow = NULL;
+	}
+	/* The handle is not reused before the result is pulled. */
+	flow_queue_complete(q, true, user_data, rule);
+	return 0;
+}
+
+/**
+ * Push the postponed operations of a flow queue, which are all
+ * completed already.
+ *
+ * @see rte_flow_push()
+ * @see rte_flow_ops
+ */
+int
+mlx5_flow_push(struct rte_eth_dev *dev, uint32_t queue,
+	       struct rte_flow_error *error)
+{
+	struct mlx5_priv *priv = dev->data->dev_private;
+
+	if (queue >= priv->nb_flow_queues)
+		return rte_flow_error_set(error, EINVAL,
+					  RTE_FLOW_ERROR_TYPE_UNSPECIFIED, NULL,
+					  "invalid flow queue");
+	return 0;
+}
+
+/**
+ * Pull the results of the completed operations of a flow queue,
+ * releasing the rules destroyed or failed.
+ *
+ * @see rte_flow_pull()
+ * @see rte_flow_ops
+ */
+int
+mlx5_flow_pull(struct rte_eth_dev *dev, uint32_t queue,
+	       struct rte_flow_op_result res[], uint16_t n_res,
+	       struct rte_flow_error *error)
+{
+	struct mlx5_priv *priv = dev->data->dev_private;
+	struct mlx5_flow_template_rule *rule;
+	struct rte_flow_template_table *table;
+	struct mlx5_flow_queue_op *op;
+	struct mlx5_flow_queue *q;
+	uint32_t n;
+	uint32_t i;
+
+	if (queue >= priv->nb_flow_queues)
+		return rte_flow_error_set(error, EINVAL,
+					  RTE_FLOW_ERROR_TYPE_UNSPECIFIED, NULL,
+					  "invalid flow queue");
+	q = &priv->flow_queues[queue];
+	n = RTE_MIN((uint32_t)n_res, q->prod - q->cons);
+	for (i = 0; i < n; i++) {
+		op = &q->ops[(q->cons + i) & (q->size - 1)];
+		res[i] = op->res;
+		rule = op->release;
+		if (!rule)
+			continue;
+		table = rule->table;
+		rte_spinlock_lock(&table->lock);
+		table->free[table->nb_free++] = rule - table->rules;
+		rte_spinlock_unlock(&table->lock);
+	}
+	q->cons += n;
+	return n;
+}
+
+/**
+ * Destroy the rules of all the template tables, discarding the results
+ * not pulled from the flow queues.
+ *
+ * @param dev
+ *   Pointer to Ethernet device.
+ */
+void
+mlx5_flow_template_tables_flush(struct rte_eth_dev *dev)
+{
+	struct mlx5_priv *priv = dev->data->dev_private;
+	struct rte_flow_template_table *table;
+	uint32_t i;
+
+	LIST_FOREACH(table, &priv->flow_tables, next) {
+		for (i = 0; i < table->attr.nb_flows; i++) {
+			if (table->rules[i].flow) {
+				mlx5_flow_destroy(dev, table->rules[i].flow,
+						  NULL);
+				table->rules[i].flow = NULL;
+			}
+			table->free[i] = table->attr.nb_flows - i - 1;
+		}
+		table->nb_free = table->attr.nb_flows;
+	}
+	for (i = 0; i < priv->nb_flow_queues; i++)
+		priv->flow_queues[i].cons = priv->flow_queues[i].prod;
+}
+
+/**
+ * Release the template tables, the templates and the flow queues.
+ *
+ * @param dev
+ *   Pointer to Ethernet device.
+ */
+void
+mlx5_flow_template_release(struct rte_eth_dev *dev)
+{
+	struct mlx5_priv *priv = dev->data->dev_private;
+	struct rte_flow_template_table *table;
+	struct rte_flow_pattern_template *it;
+	struct rte_flow_actions_template *at;
+	uint16_t i;
+
+	mlx5_flow_template_tables_flush(dev);
+	while ((table = LIST_FIRST(&priv->flow_tables)) != NULL)
+		mlx5_flow_template_table_destroy(dev, table, NULL);
+	while ((it = LIST_FIRST(&priv->flow_its)) != NULL)
+		mlx5_flow_pattern_template_destroy(dev, it, NULL);
+	while ((at = LIST_FIRST(&priv->flow_ats)) != NULL)
+		mlx5_flow_actions_template_destroy(dev, at, NULL);
+	for (i = 0; i < priv->nb_flow_queues; i++)
+		mlx5_free(priv->flow_queues[i].ops);
+	mlx5_free(priv->flow_queues);
+	priv->flow_queues = NULL;
+	priv->nb_flow_queues = 0;
+}
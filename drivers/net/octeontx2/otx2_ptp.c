@@ -193,6 +193,7 @@ otx2_eth_dev_ptp_info_update(struct otx2_dev *dev, bool ptp_en)
 		 * sent(VF->PF)
 		 */
 		eth_dev->rx_pkt_burst = nix_eth_ptp_vf_burst;
+		rte_eth_fp_ops_update(eth_dev);
 		rte_mb();
 	}
 
@@ -426,5 +426,6 @@ NIX_RX_FASTPATH_MODES
 	if (rte_eal_process_type() == RTE_PROC_PRIMARY)
 		dev->rx_pkt_burst_no_offload =
 			nix_eth_rx_burst_mseg[0][0][0][0][0][0][0];
+	rte_eth_fp_ops_update(eth_dev);
 	rte_mb();
 }
@@ -1069,5 +1069,6 @@ NIX_TX_FASTPATH_MODES
 	if (dev->tx_offloads & DEV_TX_OFFLOAD_MULTI_SEGS)
 		pick_tx_func(eth_dev, nix_eth_tx_burst_mseg);
 
+	rte_eth_fp_ops_update(eth_dev);
 	rte_mb();
 }
@@ -33,6 +33,8 @@
 #define ETH_PCAP_IFACE_ARG    "iface"
 #define ETH_PCAP_PHY_MAC_ARG  "phy_mac"
 #define ETH_PCAP_INFINITE_RX_ARG  "infinite_rx"
+#define ETH_PCAP_REPLAY_ARG  "replay"
+#define ETH_PCAP_REPLAY_TIMING_ARG  "replay_timing"
 
 #define ETH_PCAP_ARG_MAXLEN	64
 
@@ -62,6 +64,24 @@ struct queue_missed_stat {
 	unsigned long reset;
 };
 
+/* Packets of a PCAP file loaded once, replayed by reference */
+struct pcap_replay {
+	uint32_t nb_pkts;
+	/* next packet to replay */
+	uint32_t next;
+	/* replay with the capture inter-packet gaps */
+	unsigned int timing;
+	/* TSC of the first packet of the current lap, 0 before the first */
+	uint64_t lap_start;
+	/* TSC cycles between two laps */
+	uint64_t lap_cycles;
+	struct {
+		struct rte_mbuf *mbuf;
+		/* TSC cycles between the first packet and this one */
+		uint64_t tsc_offset;
+	} pkts[];
+};
+
 struct pcap_rx_queue {
 	uint16_t port_id;
 	uint16_t queue_id;
@@ -73,6 +93,8 @@ struct pcap_rx_queue {
 
 	/* Contains pre-generated packets to be looped through */
 	struct rte_ring *pkts;
+	/* Pre-loaded packets attached to the received mbufs */
+	struct pcap_replay *replay;
 };
 
 struct pcap_tx_queue {
@@ -92,6 +114,8 @@ struct pmd_internals {
 	int single_iface;
 	int phy_mac;
 	unsigned int infinite_rx;
+	unsigned int replay;
+	unsigned int replay_timing;
 };
 
 struct pmd_process_private {
@@ -120,6 +144,8 @@ struct pmd_devargs_all {
 	unsigned int is_rx_pcap;
 	unsigned int is_rx_iface;
 	unsigned int infinite_rx;
+	unsigned int replay;
+	unsigned int replay_timing;
 };
 
 static const char *valid_arguments[] = {
@@ -131,6 +157,8 @@ static const char *valid_arguments[] = {
 	ETH_PCAP_IFACE_ARG,
 	ETH_PCAP_PHY_MAC_ARG,
 	ETH_PCAP_INFINITE_RX_ARG,
+	ETH_PCAP_REPLAY_ARG,
+	ETH_PCAP_REPLAY_TIMING_ARG,
 	NULL
 };
 
@@ -268,6 +296,78 @@ eth_pcap_rx_infinite(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 	return i;
 }
 
+/* Move to the next packet to replay, looping at the end of the capture. */
+static inline void
+eth_pcap_replay_next(const struct pcap_replay *replay, uint32_t *next,
+		uint64_t *lap_start)
+{
+	if (++*next == replay->nb_pkts) {
+		*next = 0;
+		*lap_start += replay->lap_cycles;
+	}
+}
+
+/*
+ * Replay the pre-loaded packets without copy: each received mbuf is
+ * attached to the mbuf holding the packet in the capture.
+ */
+static uint16_t
+eth_pcap_rx_replay(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
+{
+	struct pcap_rx_queue *pcap_q = queue;
+	struct pcap_replay *replay = pcap_q->replay;
+	struct rte_mbuf *pcap_buf;
+	uint32_t rx_bytes = 0;
+	uint64_t lap_start;
+	uint32_t next;
+	uint64_t now;
+	uint16_t i;
+
+	if (unlikely(nb_pkts == 0))
+		return 0;
+
+	if (replay->timing) {
+		/* Only take the packets whose capture time has come. */
+		now = rte_rdtsc();
+		if (unlikely(replay->lap_start == 0))
+			replay->lap_start = now;
+		next = replay->next;
+		lap_start = replay->lap_start;
+		for (i = 0; i < nb_pkts; i++) {
+			if (lap_start + replay->pkts[next].tsc_offset > now)
+				break;
+			eth_pcap_replay_next(replay, &next, &lap_start);
+		}
+		nb_pkts = i;
+		if (nb_pkts == 0)
+			return 0;
+	}
+
+	if (rte_pktmbuf_alloc_bulk(pcap_q->mb_pool, bufs, nb_pkts) != 0)
+		return 0;
+
+	next = replay->next;
+	lap_start = replay->lap_start;
+	for (i = 0; i < nb_pkts; i++) {
+		pcap_buf = replay->pkts[next].mbuf;
+		/* Too many packets in flight for the reference counter */
+		if (unlikely(rte_mbuf_refcnt_read(pcap_buf) == UINT16_MAX)) {
+			rte_pktmbuf_free_bulk(&bufs[i], nb_pkts - i);
+			break;
+		}
+		rte_pktmbuf_attach(bufs[i], pcap_buf);
+		rx_bytes += pcap_buf->data_len;
+		eth_pcap_replay_next(replay, &next, &lap_start);
+	}
+	replay->next = next;
+	replay->lap_start = lap_start;
+
+	pcap_q->rx_stat.pkts += i;
+	pcap_q->rx_stat.bytes += rx_bytes;
+
+	return i;
+}
+
 static uint16_t
 eth_pcap_rx(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 {
@@ -649,8 +749,14 @@ eth_dev_start(struct rte_eth_dev *dev)
 	}
 
 status_up:
-	for (i = 0; i < dev->data->nb_rx_queues; i++)
+	for (i = 0; i < dev->data->nb_rx_queues; i++) {
+		rx = &internals->rx_queue[i];
+
+		/* The replay timing restarts with the port. */
+		if (rx->replay != NULL)
+			rx->replay->lap_start = 0;
 		dev->data->rx_queue_state[i] = RTE_ETH_QUEUE_STATE_STARTED;
+	}
 
 	for (i = 0; i < dev->data->nb_tx_queues; i++)
 		dev->data->tx_queue_state[i] = RTE_ETH_QUEUE_STATE_STARTED;
@@ -807,6 +913,23 @@ infinite_rx_ring_free(struct rte_ring *pkts)
 	rte_ring_free(pkts);
 }
 
+/*
+ * Release the references to the pre-loaded packets. The packets still
+ * attached to received mbufs return to their pool when these are freed.
+ */
+static void
+eth_pcap_replay_free(struct pcap_replay *replay)
+{
+	uint32_t i;
+
+	if (replay == NULL)
+		return;
+
+	for (i = 0; i < replay->nb_pkts; i++)
+		rte_pktmbuf_free(replay->pkts[i].mbuf);
+	rte_free(replay);
+}
+
 static int
 eth_dev_close(struct rte_eth_dev *dev)
 {
@@ -839,6 +962,11 @@ eth_dev_close(struct rte_eth_dev *dev)
 		}
 	}
 
+	for (i = 0; i < dev->data->nb_rx_queues; i++) {
+		eth_pcap_replay_free(internals->rx_queue[i].replay);
+		internals->rx_queue[i].replay = NULL;
+	}
+
 	if (internals->phy_mac == 0)
 		/* not dynamically allocated, must not be freed */
 		dev->data->mac_addrs = NULL;
@@ -858,11 +986,98 @@ eth_link_update(struct rte_eth_dev *dev __rte_unused,
 	return 0;
 }
 
+/*
+ * Load all the packets of the queue PCAP file in mbufs, and the TSC
+ * offsets of their capture timestamps for a timed replay.
+ */
+static int
+eth_pcap_replay_load(struct pcap_rx_queue *pcap_q, unsigned int socket_id,
+		unsigned int timing)
+{
+	struct pmd_process_private *pp;
+	struct pcap_replay *replay;
+	uint64_t hz = rte_get_tsc_hz();
+	uint64_t pcap_pkt_count;
+	uint64_t first_ts = 0;
+	uint64_t offset = 0;
+	uint64_t ts;
+	struct rte_mbuf *mbuf;
+	uint32_t n = 0;
+	pcap_t **pcap;
+
+	pp = rte_eth_devices[pcap_q->port_id].process_private;
+	pcap = &pp->rx_pcap[pcap_q->queue_id];
+
+	if (unlikely(*pcap == NULL))
+		return -ENOENT;
+
+	pcap_pkt_count = count_packets_in_pcap(pcap, pcap_q);
+	if (pcap_pkt_count == 0 || pcap_pkt_count > UINT32_MAX) {
+		PMD_LOG(ERR, "Cannot replay %" PRIu64 " packets from %s",
+			pcap_pkt_count, pcap_q->name);
+		return -EINVAL;
+	}
+
+	replay = rte_zmalloc_socket("pcap_replay", sizeof(*replay) +
+			pcap_pkt_count * sizeof(replay->pkts[0]),
+			RTE_CACHE_LINE_SIZE, socket_id);
+	if (replay == NULL)
+		return -ENOMEM;
+
+	while (n < pcap_pkt_count && eth_pcap_rx(pcap_q, &mbuf, 1)) {
+		replay->pkts[n].mbuf = mbuf;
+		replay->nb_pkts = ++n;
+
+		if (mbuf->nb_segs != 1) {
+			eth_pcap_replay_free(replay);
+			PMD_LOG(ERR,
+				"Multiseg mbufs are not supported in replay mode.");
+			return -EINVAL;
+		}
+
+		/* The capture timestamps are in microseconds. */
+		ts = *RTE_MBUF_DYNFIELD(mbuf, timestamp_dynfield_offset,
+				rte_mbuf_timestamp_t *);
+		if (n == 1)
+			first_ts = ts;
+		/* Keep the offsets ordered if the capture is not. */
+		if (ts > first_ts)
+			offset = RTE_MAX(offset,
+				(ts - first_ts) / US_PER_S * hz +
+				(ts - first_ts) % US_PER_S * hz / US_PER_S);
+		replay->pkts[n - 1].tsc_offset = offset;
+	}
+
+	if (n < pcap_pkt_count) {
+		eth_pcap_replay_free(replay);
+		PMD_LOG(ERR,
+			"Not enough mbufs to accommodate packets in pcap file. "
+			"At least %" PRIu64 " mbufs per queue is required.",
+			pcap_pkt_count);
+		return -EINVAL;
+	}
+
+	/* Loop with the average inter-packet gap after the last packet. */
+	if (n > 1)
+		replay->lap_cycles = offset + offset / (n - 1);
+	replay->timing = timing;
+	pcap_q->replay = replay;
+
+	/*
+	 * Reset the stats for this queue since eth_pcap_rx calls above
+	 * didn't result in the application receiving packets.
+	 */
+	pcap_q->rx_stat.pkts = 0;
+	pcap_q->rx_stat.bytes = 0;
+
+	return 0;
+}
+
 static int
 eth_rx_queue_setup(struct rte_eth_dev *dev,
 		uint16_t rx_queue_id,
 		uint16_t nb_rx_desc __rte_unused,
-		unsigned int socket_id __rte_unused,
+		unsigned int socket_id,
 		const struct rte_eth_rxconf *rx_conf __rte_unused,
 		struct rte_mempool *mb_pool)
 {
@@ -874,6 +1089,13 @@ eth_rx_queue_setup(struct rte_eth_dev *dev,
 	pcap_q->queue_id = rx_queue_id;
 	dev->data->rx_queues[rx_queue_id] = pcap_q;
 
+	if (internals->replay) {
+		eth_pcap_replay_free(pcap_q->replay);
+		pcap_q->replay = NULL;
+		return eth_pcap_replay_load(pcap_q, socket_id,
+				internals->replay_timing);
+	}
+
 	if (internals->infinite_rx) {
 		struct pmd_process_private *pp;
 		char ring_name[RTE_RING_NAMESIZE];
@@ -1182,6 +1404,20 @@ get_infinite_rx_arg(const char *key __rte_unused,
 	return 0;
 }
 
+static int
+get_replay_arg(const char *key __rte_unused,
+		const char *value, void *extra_args)
+{
+	if (extra_args) {
+		const int replay = atoi(value);
+		unsigned int *enable_replay = extra_args;
+
+		if (replay > 0)
+			*enable_replay = 1;
+	}
+	return 0;
+}
+
 static int
 pmd_init_internals(struct rte_vdev_device *vdev,
 		const unsigned int nb_rx_queues,
@@ -1341,8 +1577,12 @@ eth_from_pcaps(struct rte_vdev_device *vdev,
 	}
 
 	internals->infinite_rx = infinite_rx;
+	internals->replay = devargs_all->replay;
+	internals->replay_timing = devargs_all->replay_timing;
 	/* Assign rx ops. */
-	if (infinite_rx)
+	if (devargs_all->replay)
+		eth_dev->rx_pkt_burst = eth_pcap_rx_replay;
+	else if (infinite_rx)
 		eth_dev->rx_pkt_burst = eth_pcap_rx_infinite;
 	else if (devargs_all->is_rx_pcap || devargs_all->is_rx_iface ||
 			single_iface)
@@ -1481,6 +1721,37 @@ pmd_pcap_probe(struct rte_vdev_device *dev)
 					"for %s", name);
 		}
 
+		/*
+		 * We check whether we want to replay the pcap file from
+		 * memory, optionally with its timing.
+		 */
+		if (rte_kvargs_count(kvlist, ETH_PCAP_REPLAY_ARG) == 1) {
+			ret = rte_kvargs_process(kvlist, ETH_PCAP_REPLAY_ARG,
+					&get_replay_arg, &devargs_all.replay);
+			if (ret < 0)
+				goto free_kvlist;
+		}
+		if (rte_kvargs_count(kvlist, ETH_PCAP_REPLAY_TIMING_ARG) == 1) {
+			ret = rte_kvargs_process(kvlist,
+					ETH_PCAP_REPLAY_TIMING_ARG,
+					&get_replay_arg,
+					&devargs_all.replay_timing);
+			if (ret < 0)
+				goto free_kvlist;
+		}
+		if (devargs_all.replay_timing && !devargs_all.replay)
+			PMD_LOG(WARNING, "replay_timing is ignored without replay for %s",
+					name);
+		if (devargs_all.replay) {
+			if (devargs_all.infinite_rx)
+				PMD_LOG(WARNING, "infinite_rx is ignored in replay mode for %s",
+						name);
+			devargs_all.infinite_rx = 0;
+			PMD_LOG(INFO, "replay has been enabled%s for %s",
+					devargs_all.replay_timing ?
+					" with timing" : "", name);
+		}
+
 		ret = rte_kvargs_process(kvlist, ETH_PCAP_RX_PCAP_ARG,
 				&open_rx_pcap, &pcaps);
 	} else if (devargs_all.is_rx_iface) {
@@ -1618,4 +1889,6 @@ RTE_PMD_REGISTER_PARAM_STRING(net_pcap,
 	ETH_PCAP_TX_IFACE_ARG "=<ifc> "
 	ETH_PCAP_IFACE_ARG "=<ifc> "
 	ETH_PCAP_PHY_MAC_ARG "=<int>"
-	ETH_PCAP_INFINITE_RX_ARG "=<0|1>");
+	ETH_PCAP_INFINITE_RX_ARG "=<0|1> "
+	ETH_PCAP_REPLAY_ARG "=<0|1> "
+	ETH_PCAP_REPLAY_TIMING_ARG "=<0|1>");
@@ -17,10 +17,18 @@
 #define ETH_RING_ACTION_ATTACH		"ATTACH"
 #define ETH_RING_INTERNAL_ARG		"internal"
 #define ETH_RING_INTERNAL_ARG_MAX_LEN	19 /* "0x..16chars..\0" */
+#define ETH_RING_SYNC_ARG		"sync"
+#define ETH_RING_SYNC_SPSC		"SPSC"
+#define ETH_RING_SYNC_MPMC		"MPMC"
+#define ETH_RING_SYNC_HTS		"HTS"
+#define ETH_RING_SYNC_RTS		"RTS"
+#define ETH_RING_BURST_ARG		"burst"
 
 static const char *valid_arguments[] = {
 	ETH_RING_NUMA_NODE_ACTION_ARG,
 	ETH_RING_INTERNAL_ARG,
+	ETH_RING_SYNC_ARG,
+	ETH_RING_BURST_ARG,
 	NULL
 };
 
@@ -53,6 +61,7 @@ struct pmd_internals {
 
 	struct rte_ether_addr address;
 	enum dev_action action;
+	bool burst_mode; /* bursts are kept whole on the rings */
 };
 
 static struct rte_eth_link pmd_link = {
@@ -96,6 +105,110 @@ eth_ring_tx(void *q, struct rte_mbuf **bufs, uint16_t nb_bufs)
 	return nb_tx;
 }
 
+/*
+ * In burst mode, each burst is put on the ring as a header object holding
+ * the number of mbufs of the burst, followed by the mbufs. The header and
+ * the mbufs are reserved and published at once with the zero-copy ring API,
+ * and a receive returns the mbufs of at most one burst, so the grouping of
+ * the packets done by the transmitter, e.g. per flow, is kept as is.
+ * When a burst is only partly received, the number of mbufs left is written
+ * as a new header in the slot of the last mbuf received, which is still
+ * owned by the consumer until the dequeue is finished.
+ */
+static inline void **
+eth_ring_zc_slot(const struct rte_ring_zc_data *zcd, uint32_t idx)
+{
+	if (idx < zcd->n1)
+		return (void **)zcd->ptr1 + idx;
+	return (void **)zcd->ptr2 + (idx - zcd->n1);
+}
+
+static uint16_t
+eth_ring_rx_burst_mode(void *q, struct rte_mbuf **bufs, uint16_t nb_bufs)
+{
+	struct ring_queue *r = q;
+	struct rte_ring_zc_data zcd;
+	uint32_t nb_burst, n, i;
+	uint16_t nb_rx;
+
+	if (unlikely(nb_bufs == 0))
+		return 0;
+
+	n = rte_ring_dequeue_zc_burst_start(r->rng, (uint32_t)nb_bufs + 1,
+			&zcd, NULL);
+	if (n == 0)
+		return 0;
+
+	/* the header and its mbufs were published together */
+	nb_burst = (uint32_t)(uintptr_t)*eth_ring_zc_slot(&zcd, 0);
+	nb_rx = (uint16_t)RTE_MIN(nb_burst, (uint32_t)nb_bufs);
+	RTE_ASSERT(nb_rx != 0 && nb_rx < n);
+
+	for (i = 0; i < nb_rx; i++)
+		bufs[i] = *eth_ring_zc_slot(&zcd, i + 1);
+
+	if (nb_rx == nb_burst) {
+		rte_ring_dequeue_zc_finish(r->rng, nb_rx + 1);
+	} else {
+		*eth_ring_zc_slot(&zcd, nb_rx) =
+			(void *)(uintptr_t)(nb_burst - nb_rx);
+		rte_ring_dequeue_zc_finish(r->rng, nb_rx);
+	}
+
+	if (r->rng->flags & RING_F_SC_DEQ)
+		r->rx_pkts.cnt += nb_rx;
+	else
+		rte_atomic64_add(&(r->rx_pkts), nb_rx);
+	return nb_rx;
+}
+
+static uint16_t
+eth_ring_tx_burst_mode(void *q, struct rte_mbuf **bufs, uint16_t nb_bufs)
+{
+	struct ring_queue *r = q;
+	struct rte_ring_zc_data zcd;
+	uint16_t nb_tx, i;
+	uint32_t n;
+
+	if (unlikely(nb_bufs == 0))
+		return 0;
+
+	n = rte_ring_enqueue_zc_burst_start(r->rng, (uint32_t)nb_bufs + 1,
+			&zcd, NULL);
+	if (n == 0)
+		return 0;
+
+	/* a single free slot cannot hold a burst and its header */
+	nb_tx = (uint16_t)(n - 1);
+	if (nb_tx == 0) {
+		rte_ring_enqueue_zc_finish(r->rng, 0);
+		return 0;
+	}
+
+	*eth_ring_zc_slot(&zcd, 0) = (void *)(uintptr_t)nb_tx;
+	for (i = 0; i < nb_tx; i++)
+		*eth_ring_zc_slot(&zcd, i + 1) = bufs[i];
+	rte_ring_enqueue_zc_finish(r->rng, n);
+
+	if (r->rng->flags & RING_F_SP_ENQ)
+		r->tx_pkts.cnt += nb_tx;
+	else
+		rte_atomic64_add(&(r->tx_pkts), nb_tx);
+	return nb_tx;
+}
+
+/* The zero-copy API needs a ring where a single thread at a time is between
+ * the start and the finish of an operation, on both ends.
+ */
+static bool
+eth_ring_burst_mode_supported(const struct rte_ring *r)
+{
+	return (r->prod.sync_type == RTE_RING_SYNC_ST ||
+		r->prod.sync_type == RTE_RING_SYNC_MT_HTS) &&
+	       (r->cons.sync_type == RTE_RING_SYNC_ST ||
+		r->cons.sync_type == RTE_RING_SYNC_MT_HTS);
+}
+
 static int
 eth_dev_configure(struct rte_eth_dev *dev __rte_unused) { return 0; }
 
@@ -289,7 +402,7 @@ do_eth_dev_ring_create(const char *name,
 		struct rte_ring *const tx_queues[],
 		const unsigned int nb_tx_queues,
 		const unsigned int numa_node, enum dev_action action,
-		struct rte_eth_dev **eth_dev_p)
+		bool burst_mode, struct rte_eth_dev **eth_dev_p)
 {
 	struct rte_eth_dev_data *data = NULL;
 	struct pmd_internals *internals = NULL;
@@ -301,6 +414,15 @@ do_eth_dev_ring_create(const char *name,
 	PMD_LOG(INFO, "Creating rings-backed ethdev on numa socket %u",
 			numa_node);
 
+	if (burst_mode) {
+		for (i = 0; i < nb_rx_queues; i++)
+			if (!eth_ring_burst_mode_supported(rx_queues[i]))
+				goto unsupported;
+		for (i = 0; i < nb_tx_queues; i++)
+			if (!eth_ring_burst_mode_supported(tx_queues[i]))
+				goto unsupported;
+	}
+
 	rx_queues_local = rte_calloc_socket(name, nb_rx_queues,
 					    sizeof(void *), 0, numa_node);
 	if (rx_queues_local == NULL) {
@@ -343,6 +465,7 @@ do_eth_dev_ring_create(const char *name,
 	data->tx_queues = tx_queues_local;
 
 	internals->action = action;
+	internals->burst_mode = burst_mode;
 	internals->max_rx_queues = nb_rx_queues;
 	internals->max_tx_queues = nb_tx_queues;
 	for (i = 0; i < nb_rx_queues; i++) {
@@ -367,14 +490,24 @@ do_eth_dev_ring_create(const char *name,
 	data->numa_node = numa_node;
 
 	/* finally assign rx and tx ops */
-	eth_dev->rx_pkt_burst = eth_ring_rx;
-	eth_dev->tx_pkt_burst = eth_ring_tx;
+	if (burst_mode) {
+		eth_dev->rx_pkt_burst = eth_ring_rx_burst_mode;
+		eth_dev->tx_pkt_burst = eth_ring_tx_burst_mode;
+	} else {
+		eth_dev->rx_pkt_burst = eth_ring_rx;
+		eth_dev->tx_pkt_burst = eth_ring_tx;
+	}
 
 	rte_eth_dev_probing_finish(eth_dev);
 	*eth_dev_p = eth_dev;
 
 	return data->port_id;
 
+unsupported:
+	PMD_LOG(ERR, "Burst mode needs rings with SP/SC or HTS sync mode");
+	rte_errno = ENOTSUP;
+	return -1;
+
 error:
 	rte_free(rx_queues_local);
 	rte_free(tx_queues_local);
@@ -452,7 +585,8 @@ static int
 eth_dev_ring_create(const char *name,
 		struct rte_vdev_device *vdev,
 		const unsigned int numa_node,
-		enum dev_action action, struct rte_eth_dev **eth_dev)
+		enum dev_action action, unsigned int ring_flags,
+		bool burst_mode, struct rte_eth_dev **eth_dev)
 {
 	/* rx and tx are so-called from point of view of first port.
 	 * They are inverted from the point of view of second port
@@ -475,14 +609,14 @@ eth_dev_ring_create(const char *name,
 
 		rxtx[i] = (action == DEV_CREATE) ?
 				rte_ring_create(rng_name, 1024, numa_node,
-						RING_F_SP_ENQ|RING_F_SC_DEQ) :
+						ring_flags) :
 				rte_ring_lookup(rng_name);
 		if (rxtx[i] == NULL)
 			return -1;
 	}
 
 	if (do_eth_dev_ring_create(name, vdev, rxtx, num_rings, rxtx, num_rings,
-		numa_node, action, eth_dev) < 0)
+		numa_node, action, burst_mode, eth_dev) < 0)
 		return -1;
 
 	return 0;
@@ -600,6 +734,44 @@ parse_internal_args(const char *key __rte_unused, const char *value,
 	return 0;
 }
 
+static int
+parse_sync_arg(const char *key __rte_unused, const char *value, void *data)
+{
+	unsigned int *ring_flags = data;
+
+	if (strcmp(value, ETH_RING_SYNC_SPSC) == 0)
+		*ring_flags = RING_F_SP_ENQ | RING_F_SC_DEQ;
+	else if (strcmp(value, ETH_RING_SYNC_MPMC) == 0)
+		*ring_flags = 0;
+	else if (strcmp(value, ETH_RING_SYNC_HTS) == 0)
+		*ring_flags = RING_F_MP_HTS_ENQ | RING_F_MC_HTS_DEQ;
+	else if (strcmp(value, ETH_RING_SYNC_RTS) == 0)
+		*ring_flags = RING_F_MP_RTS_ENQ | RING_F_MC_RTS_DEQ;
+	else {
+		PMD_LOG(ERR, "Invalid ring sync mode %s", value);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int
+parse_burst_arg(const char *key __rte_unused, const char *value, void *data)
+{
+	bool *burst_mode = data;
+
+	if (strcmp(value, "0") == 0)
+		*burst_mode = false;
+	else if (strcmp(value, "1") == 0)
+		*burst_mode = true;
+	else {
+		PMD_LOG(ERR, "Invalid burst mode %s, expected 0 or 1", value);
+		return -1;
+	}
+
+	return 0;
+}
+
 static int
 rte_pmd_ring_probe(struct rte_vdev_device *dev)
 {
@@ -609,6 +781,9 @@ rte_pmd_ring_probe(struct rte_vdev_device *dev)
 	struct node_action_list *info = NULL;
 	struct rte_eth_dev *eth_dev = NULL;
 	struct ring_internal_args *internal_args;
+	unsigned int ring_flags = RING_F_SP_ENQ | RING_F_SC_DEQ;
+	struct pmd_internals *internals;
+	bool burst_mode = false;
 
 	name = rte_vdev_device_name(dev);
 	params = rte_vdev_device_args(dev);
@@ -624,8 +799,14 @@ rte_pmd_ring_probe(struct rte_vdev_device *dev)
 		eth_dev->dev_ops = &ops;
 		eth_dev->device = &dev->device;
 
-		eth_dev->rx_pkt_burst = eth_ring_rx;
-		eth_dev->tx_pkt_burst = eth_ring_tx;
+		internals = eth_dev->data->dev_private;
+		if (internals->burst_mode) {
+			eth_dev->rx_pkt_burst = eth_ring_rx_burst_mode;
+			eth_dev->tx_pkt_burst = eth_ring_tx_burst_mode;
+		} else {
+			eth_dev->rx_pkt_burst = eth_ring_rx;
+			eth_dev->tx_pkt_burst = eth_ring_tx;
+		}
 
 		rte_eth_dev_probing_finish(eth_dev);
 
@@ -634,12 +815,13 @@ rte_pmd_ring_probe(struct rte_vdev_device *dev)
 
 	if (params == NULL || params[0] == '\0') {
 		ret = eth_dev_ring_create(name, dev, rte_socket_id(), DEV_CREATE,
-				&eth_dev);
+				ring_flags, burst_mode, &eth_dev);
 		if (ret == -1) {
 			PMD_LOG(INFO,
 				"Attach to pmd_ring for %s", name);
 			ret = eth_dev_ring_create(name, dev, rte_socket_id(),
-						  DEV_ATTACH, &eth_dev);
+						  DEV_ATTACH, ring_flags,
+						  burst_mode, &eth_dev);
 		}
 	} else {
 		kvlist = rte_kvargs_parse(params, valid_arguments);
@@ -648,18 +830,30 @@ rte_pmd_ring_probe(struct rte_vdev_device *dev)
 			PMD_LOG(INFO,
 				"Ignoring unsupported parameters when creating rings-backed ethernet device");
 			ret = eth_dev_ring_create(name, dev, rte_socket_id(),
-						  DEV_CREATE, &eth_dev);
+						  DEV_CREATE, ring_flags,
+						  burst_mode, &eth_dev);
 			if (ret == -1) {
 				PMD_LOG(INFO,
 					"Attach to pmd_ring for %s",
 					name);
 				ret = eth_dev_ring_create(name, dev, rte_socket_id(),
-							  DEV_ATTACH, &eth_dev);
+							  DEV_ATTACH, ring_flags,
+							  burst_mode, &eth_dev);
 			}
 
 			return ret;
 		}
 
+		ret = rte_kvargs_process(kvlist, ETH_RING_SYNC_ARG,
+					 parse_sync_arg, &ring_flags);
+		if (ret < 0)
+			goto out_free;
+
+		ret = rte_kvargs_process(kvlist, ETH_RING_BURST_ARG,
+					 parse_burst_arg, &burst_mode);
+		if (ret < 0)
+			goto out_free;
+
 		if (rte_kvargs_count(kvlist, ETH_RING_INTERNAL_ARG) == 1) {
 			ret = rte_kvargs_process(kvlist, ETH_RING_INTERNAL_ARG,
 						 parse_internal_args,
@@ -674,9 +868,23 @@ rte_pmd_ring_probe(struct rte_vdev_device *dev)
 				internal_args->nb_tx_queues,
 				internal_args->numa_node,
 				DEV_ATTACH,
+				false,
 				&eth_dev);
 			if (ret >= 0)
 				ret = 0;
+		} else if (rte_kvargs_count(kvlist,
+				ETH_RING_NUMA_NODE_ACTION_ARG) == 0) {
+			ret = eth_dev_ring_create(name, dev, rte_socket_id(),
+						  DEV_CREATE, ring_flags,
+						  burst_mode, &eth_dev);
+			if (ret == -1) {
+				PMD_LOG(INFO,
+					"Attach to pmd_ring for %s", name);
+				ret = eth_dev_ring_create(name, dev,
+							  rte_socket_id(),
+							  DEV_ATTACH, ring_flags,
+							  burst_mode, &eth_dev);
+			}
 		} else {
 			ret = rte_kvargs_count(kvlist, ETH_RING_NUMA_NODE_ACTION_ARG);
 			info = rte_zmalloc("struct node_action_list",
@@ -700,6 +908,7 @@ rte_pmd_ring_probe(struct rte_vdev_device *dev)
 							  dev,
 							  info->list[info->count].node,
 							  info->list[info->count].action,
+							  ring_flags, burst_mode,
 							  &eth_dev);
 				if ((ret == -1) &&
 				    (info->list[info->count].action == DEV_CREATE)) {
@@ -708,8 +917,8 @@ rte_pmd_ring_probe(struct rte_vdev_device *dev)
 						name);
 					ret = eth_dev_ring_create(name, dev,
 							info->list[info->count].node,
-							DEV_ATTACH,
-							&eth_dev);
+							DEV_ATTACH, ring_flags,
+							burst_mode, &eth_dev);
 				}
 			}
 		}
@@ -750,4 +959,6 @@ static struct rte_vdev_driver pmd_ring_drv = {
 RTE_PMD_REGISTER_VDEV(net_ring, pmd_ring_drv);
 RTE_PMD_REGISTER_ALIAS(net_ring, eth_ring);
 RTE_PMD_REGISTER_PARAM_STRING(net_ring,
-	ETH_RING_NUMA_NODE_ACTION_ARG "=name:node:action(ATTACH|CREATE)");
+	ETH_RING_NUMA_NODE_ACTION_ARG "=name:node:action(ATTACH|CREATE) "
+	ETH_RING_SYNC_ARG "=SPSC|MPMC|HTS|RTS "
+	ETH_RING_BURST_ARG "=0|1");
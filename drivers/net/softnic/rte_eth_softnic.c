@@ -2,6 +2,7 @@
  * Copyright(c) 2017 Intel Corporation
  */
 
+#include <ctype.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
@@ -15,6 +16,7 @@
 #include <rte_ring.h>
 #include <rte_tm_driver.h>
 #include <rte_mtr_driver.h>
+#include <rte_telemetry.h>
 
 #include "rte_eth_softnic.h"
 #include "rte_eth_softnic_internals.h"
@@ -23,6 +25,7 @@
 #define PMD_PARAM_CONN_PORT                                "conn_port"
 #define PMD_PARAM_CPU_ID                                   "cpu_id"
 #define PMD_PARAM_SC                                       "sc"
+#define PMD_PARAM_REBALANCE_PERIOD                         "rebalance_period"
 #define PMD_PARAM_TM_N_QUEUES                              "tm_n_queues"
 #define PMD_PARAM_TM_QSIZE0                                "tm_qsize0"
 #define PMD_PARAM_TM_QSIZE1                                "tm_qsize1"
@@ -44,6 +47,7 @@ static const char * const pmd_valid_args[] = {
 	PMD_PARAM_CONN_PORT,
 	PMD_PARAM_CPU_ID,
 	PMD_PARAM_SC,
+	PMD_PARAM_REBALANCE_PERIOD,
 	PMD_PARAM_TM_N_QUEUES,
 	PMD_PARAM_TM_QSIZE0,
 	PMD_PARAM_TM_QSIZE1,
@@ -497,6 +501,14 @@ pmd_parse_args(struct pmd_params *p, const char *params)
 			goto out_free;
 	}
 
+	/* Pipeline rebalancing period (optional) */
+	if (rte_kvargs_count(kvlist, PMD_PARAM_REBALANCE_PERIOD) == 1) {
+		ret = rte_kvargs_process(kvlist, PMD_PARAM_REBALANCE_PERIOD,
+			&get_uint32, &p->rebalance_period_ms);
+		if (ret < 0)
+			goto out_free;
+	}
+
 	/* TM number of queues (optional) */
 	if (rte_kvargs_count(kvlist, PMD_PARAM_TM_N_QUEUES) == 1) {
 		ret = rte_kvargs_process(kvlist, PMD_PARAM_TM_N_QUEUES,
@@ -671,6 +683,7 @@ RTE_PMD_REGISTER_PARAM_STRING(net_softnic,
 	PMD_PARAM_FIRMWARE "=<string> "
 	PMD_PARAM_CONN_PORT "=<uint16> "
 	PMD_PARAM_CPU_ID "=<uint32> "
+	PMD_PARAM_REBALANCE_PERIOD "=<uint32> "
 	PMD_PARAM_TM_N_QUEUES "=<uint32> "
 	PMD_PARAM_TM_QSIZE0 "=<uint32> "
 	PMD_PARAM_TM_QSIZE1 "=<uint32> "
@@ -703,5 +716,135 @@ rte_pmd_softnic_manage(uint16_t port_id)
 
 	softnic_conn_poll_for_msg(softnic->conn);
 
+	/* Pipeline load measurement and rebalancing */
+	{
+		uint64_t time = rte_get_tsc_cycles();
+		uint32_t period_ms = softnic->params.rebalance_period_ms;
+
+		if (time >= softnic->load_time_next) {
+			if (period_ms)
+				softnic_thread_rebalance(softnic);
+			else
+				softnic_thread_load_update(softnic);
+
+			if (period_ms == 0)
+				period_ms = THREAD_LOAD_PERIOD_MS;
+			softnic->load_time_next = time +
+				(rte_get_tsc_hz() * period_ms) / 1000;
+		}
+	}
+
+	return 0;
+}
+
+static struct pmd_internals *
+pmd_telemetry_softnic_get(const char *params)
+{
+	struct rte_eth_dev *dev;
+	int port_id;
+
+	if (params == NULL || strlen(params) == 0 || !isdigit(*params))
+		return NULL;
+
+	port_id = atoi(params);
+	if (!rte_eth_dev_is_valid_port(port_id))
+		return NULL;
+
+	dev = &rte_eth_devices[port_id];
+	if (dev->dev_ops != &pmd_ops)
+		return NULL;
+
+	return dev->data->dev_private;
+}
+
+/* Load of the last measurement window, in percent. */
+static uint64_t
+pmd_telemetry_load(struct pmd_internals *softnic, uint64_t load_cycles)
+{
+	if (softnic->load_time == 0)
+		return 0;
+
+	return (load_cycles * 100) / softnic->load_time;
+}
+
+static int
+pmd_telemetry_threads(const char *cmd __rte_unused,
+	const char *params,
+	struct rte_tel_data *d)
+{
+	struct pmd_internals *softnic = pmd_telemetry_softnic_get(params);
+	uint32_t i;
+
+	if (softnic == NULL)
+		return -1;
+
+	rte_tel_data_start_dict(d);
+
+	RTE_LCORE_FOREACH_WORKER(i) {
+		struct softnic_thread_data *td = &softnic->thread_data[i];
+		struct rte_tel_data *t;
+		char name[16];
+
+		if (td->iter == 0 && td->n_pipelines == 0)
+			continue;
+
+		t = rte_tel_data_alloc();
+		if (t == NULL)
+			return -1;
+
+		rte_tel_data_start_dict(t);
+		rte_tel_data_add_dict_u64(t, "pipelines",
+			softnic_pipeline_thread_count(softnic, i));
+		rte_tel_data_add_dict_u64(t, "busy_cycles", td->cycles_busy);
+		rte_tel_data_add_dict_u64(t, "load",
+			pmd_telemetry_load(softnic,
+				softnic->thread[i].load_cycles));
+
+		snprintf(name, sizeof(name), "%u", i);
+		rte_tel_data_add_dict_container(d, name, t, 0);
+	}
+
+	return 0;
+}
+
+static int
+pmd_telemetry_pipelines(const char *cmd __rte_unused,
+	const char *params,
+	struct rte_tel_data *d)
+{
+	struct pmd_internals *softnic = pmd_telemetry_softnic_get(params);
+	struct pipeline *p;
+
+	if (softnic == NULL)
+		return -1;
+
+	rte_tel_data_start_dict(d);
+
+	TAILQ_FOREACH(p, &softnic->pipeline_list, node) {
+		struct rte_tel_data *t;
+
+		if (p->enabled == 0)
+			continue;
+
+		t = rte_tel_data_alloc();
+		if (t == NULL)
+			return -1;
+
+		rte_tel_data_start_dict(t);
+		rte_tel_data_add_dict_u64(t, "thread", p->thread_id);
+		rte_tel_data_add_dict_u64(t, "load",
+			pmd_telemetry_load(softnic, p->load_cycles));
+
+		rte_tel_data_add_dict_container(d, p->name, t, 0);
+	}
+
 	return 0;
 }
+
+RTE_INIT(pmd_softnic_init_telemetry)
+{
+	rte_telemetry_register_cmd("/softnic/threads", pmd_telemetry_threads,
+		"Returns the load of the data plane threads of a Soft NIC port, in percent of the last measurement window. Parameters: int port_id");
+	rte_telemetry_register_cmd("/softnic/pipelines", pmd_telemetry_pipelines,
+		"Returns the thread and the load of the enabled pipelines of a Soft NIC port. Parameters: int port_id");
+}
@@ -5979,6 +5979,30 @@ cmd_softnic_thread_pipeline_enable(struct pmd_internals *softnic,
 	}
 }
 
+/**
+ * thread rebalance
+ */
+static void
+cmd_softnic_thread_rebalance(struct pmd_internals *softnic,
+	char **tokens,
+	uint32_t n_tokens,
+	char *out,
+	size_t out_size)
+{
+	int status;
+
+	if (n_tokens != 2) {
+		snprintf(out, out_size, MSG_ARG_MISMATCH, tokens[0]);
+		return;
+	}
+
+	status = softnic_thread_rebalance(softnic);
+	if (status) {
+		snprintf(out, out_size, MSG_CMD_FAIL, "thread rebalance");
+		return;
+	}
+}
+
 /**
  * thread <thread_id> pipeline <pipeline_name> disable
  */
@@ -6380,6 +6404,13 @@ softnic_cli_process(char *in, char *out, size_t out_size, void *arg)
 	}
 
 	if (strcmp(tokens[0], "thread") == 0) {
+		if (n_tokens >= 2 &&
+			(strcmp(tokens[1], "rebalance") == 0)) {
+			cmd_softnic_thread_rebalance(softnic, tokens, n_tokens,
+				out, out_size);
+			return;
+		}
+
 		if (n_tokens >= 5 &&
 			(strcmp(tokens[4], "enable") == 0)) {
 			cmd_softnic_thread_pipeline_enable(softnic, tokens, n_tokens,
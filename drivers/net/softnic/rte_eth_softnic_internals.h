@@ -39,6 +39,7 @@ struct pmd_params {
 	uint16_t conn_port;
 	uint32_t cpu_id;
 	int sc; /**< Service cores. */
+	uint32_t rebalance_period_ms; /**< Pipeline rebalancing, 0: disabled. */
 
 	/** Traffic Management (TM) */
 	struct {
@@ -545,6 +546,10 @@ struct pipeline {
 	int enabled;
 	uint32_t thread_id;
 	uint32_t cpu_id;
+
+	/* Load: busy cycles of the last measurement window (main thread). */
+	uint64_t cycles_busy_prev;
+	uint64_t load_cycles;
 };
 
 TAILQ_HEAD(pipeline_list, pipeline);
@@ -564,6 +569,16 @@ TAILQ_HEAD(pipeline_list, pipeline);
 #define THREAD_TIMER_PERIOD_MS                             100
 #endif
 
+/** Load measurement period when the rebalancing is disabled. */
+#ifndef THREAD_LOAD_PERIOD_MS
+#define THREAD_LOAD_PERIOD_MS                              1000
+#endif
+
+/** Minimum load difference between threads to move a pipeline (percent). */
+#ifndef THREAD_REBALANCE_THRESHOLD
+#define THREAD_REBALANCE_THRESHOLD                         10
+#endif
+
 /**
  * Main thread: data plane thread context
  */
@@ -572,6 +587,10 @@ struct softnic_thread {
 	struct rte_ring *msgq_rsp;
 
 	uint32_t service_id;
+
+	/* Load: busy cycles of the last measurement window. */
+	uint64_t cycles_busy_prev;
+	uint64_t load_cycles;
 };
 
 /**
@@ -587,6 +606,7 @@ struct softnic_table_data {
 
 struct pipeline_data {
 	struct rte_pipeline *p;
+	uint64_t cycles_busy; /* Cycles of the runs with input packets. */
 	struct softnic_table_data table_data[RTE_PIPELINE_TABLE_MAX];
 	uint32_t n_tables;
 
@@ -609,6 +629,7 @@ struct softnic_thread_data {
 	uint64_t time_next;
 	uint64_t time_next_min;
 	uint64_t iter;
+	uint64_t cycles_busy;
 } __rte_cache_aligned;
 
 /**
@@ -637,6 +658,11 @@ struct pmd_internals {
 	struct pipeline_list pipeline_list;
 	struct softnic_thread thread[RTE_MAX_LCORE];
 	struct softnic_thread_data thread_data[RTE_MAX_LCORE];
+
+	/* Load measurement window, in CPU cycles. */
+	uint64_t load_time_prev;
+	uint64_t load_time;
+	uint64_t load_time_next;
 };
 
 static inline struct rte_eth_dev *
@@ -1128,6 +1154,12 @@ softnic_thread_pipeline_disable(struct pmd_internals *p,
 	uint32_t thread_id,
 	const char *pipeline_name);
 
+void
+softnic_thread_load_update(struct pmd_internals *p);
+
+int
+softnic_thread_rebalance(struct pmd_internals *p);
+
 /**
  * CLI
  */
@@ -93,6 +93,8 @@ softnic_thread_init(struct pmd_internals *softnic)
 		t_data->time_next_min = t_data->time_next;
 	}
 
+	softnic->load_time_prev = rte_get_tsc_cycles();
+
 	return 0;
 }
 
@@ -322,6 +324,7 @@ softnic_thread_pipeline_enable(struct pmd_internals *softnic,
 		td->p[td->n_pipelines] = p->p;
 
 		tdp->p = p->p;
+		tdp->cycles_busy = 0;
 		for (i = 0; i < p->n_tables; i++)
 			tdp->table_data[i].a =
 				p->table[i].a;
@@ -337,6 +340,8 @@ softnic_thread_pipeline_enable(struct pmd_internals *softnic,
 		/* Pipeline */
 		p->thread_id = thread_id;
 		p->enabled = 1;
+		p->cycles_busy_prev = 0;
+		p->load_cycles = 0;
 
 		return 0;
 	}
@@ -372,6 +377,8 @@ softnic_thread_pipeline_enable(struct pmd_internals *softnic,
 
 	p->thread_id = thread_id;
 	p->enabled = 1;
+	p->cycles_busy_prev = 0;
+	p->load_cycles = 0;
 
 	return 0;
 }
@@ -462,6 +469,147 @@ softnic_thread_pipeline_disable(struct pmd_internals *softnic,
 	return 0;
 }
 
+/**
+ * Main thread: pipeline load balancing
+ *
+ * The data plane threads count the cycles of the pipeline runs that received
+ * packets. The counters have a single writer, so the main thread reads them
+ * directly, as the pipeline to thread mapping is only changed by itself.
+ */
+static struct pipeline_data *
+thread_pipeline_data_find(struct pmd_internals *softnic, struct pipeline *p)
+{
+	struct softnic_thread_data *td = &softnic->thread_data[p->thread_id];
+	uint32_t i;
+
+	for (i = 0; i < td->n_pipelines; i++)
+		if (td->pipeline_data[i].p == p->p)
+			return &td->pipeline_data[i];
+
+	return NULL;
+}
+
+void
+softnic_thread_load_update(struct pmd_internals *softnic)
+{
+	struct pipeline *p;
+	uint64_t time = rte_get_tsc_cycles();
+	uint32_t i;
+
+	softnic->load_time = time - softnic->load_time_prev;
+	softnic->load_time_prev = time;
+
+	RTE_LCORE_FOREACH_WORKER(i) {
+		struct softnic_thread *t = &softnic->thread[i];
+		uint64_t cycles_busy = softnic->thread_data[i].cycles_busy;
+
+		t->load_cycles = cycles_busy - t->cycles_busy_prev;
+		t->cycles_busy_prev = cycles_busy;
+	}
+
+	TAILQ_FOREACH(p, &softnic->pipeline_list, node) {
+		struct pipeline_data *tdp;
+		uint64_t cycles_busy;
+
+		p->load_cycles = 0;
+		if (p->enabled == 0)
+			continue;
+
+		tdp = thread_pipeline_data_find(softnic, p);
+		if (tdp == NULL)
+			continue;
+
+		cycles_busy = tdp->cycles_busy;
+		p->load_cycles = cycles_busy - p->cycles_busy_prev;
+		p->cycles_busy_prev = cycles_busy;
+	}
+}
+
+/**
+ * Pipelines are only moved between the threads known to run the data plane of
+ * this device: the service cores, or the threads that called
+ * rte_pmd_softnic_run() for it.
+ */
+static inline int
+thread_is_rebalance_candidate(struct pmd_internals *softnic, uint32_t thread_id)
+{
+	if (!thread_is_valid(softnic, thread_id))
+		return 0; /* FALSE */
+
+	if (softnic->params.sc)
+		return 1; /* TRUE */
+
+	return (softnic->thread_data[thread_id].iter != 0) ? 1 : 0;
+}
+
+int
+softnic_thread_rebalance(struct pmd_internals *softnic)
+{
+	struct pipeline *p, *p_move = NULL;
+	uint64_t load_src = 0, load_dst = UINT64_MAX, threshold;
+	uint32_t src = RTE_MAX_LCORE, dst = RTE_MAX_LCORE, i;
+	int status;
+
+	softnic_thread_load_update(softnic);
+
+	/* Busiest thread running several pipelines, least loaded thread */
+	RTE_LCORE_FOREACH_WORKER(i) {
+		uint64_t load = softnic->thread[i].load_cycles;
+		uint32_t n_pipelines;
+
+		if (!thread_is_rebalance_candidate(softnic, i))
+			continue;
+
+		n_pipelines = softnic_pipeline_thread_count(softnic, i);
+
+		if ((n_pipelines >= 2) && (load >= load_src)) {
+			src = i;
+			load_src = load;
+		}
+
+		if ((n_pipelines < THREAD_PIPELINES_MAX) && (load < load_dst)) {
+			dst = i;
+			load_dst = load;
+		}
+	}
+
+	if ((src == RTE_MAX_LCORE) || (dst == RTE_MAX_LCORE) || (src == dst))
+		return 0;
+
+	threshold = (softnic->load_time * THREAD_REBALANCE_THRESHOLD) / 100;
+	if (load_src <= load_dst + threshold)
+		return 0;
+
+	/* Hottest pipeline of the busiest thread that does not turn the least
+	 * loaded thread into the new busiest one.
+	 */
+	TAILQ_FOREACH(p, &softnic->pipeline_list, node) {
+		if ((p->enabled == 0) ||
+			(p->thread_id != src) ||
+			(p->load_cycles == 0) ||
+			(p->load_cycles >= load_src - load_dst))
+			continue;
+
+		if ((p_move == NULL) || (p->load_cycles > p_move->load_cycles))
+			p_move = p;
+	}
+
+	if (p_move == NULL)
+		return 0;
+
+	status = softnic_thread_pipeline_disable(softnic, src, p_move->name);
+	if (status)
+		return status;
+
+	status = softnic_thread_pipeline_enable(softnic, dst, p_move->name);
+	if (status) {
+		softnic_thread_pipeline_enable(softnic, src, p_move->name);
+		return status;
+	}
+
+	return 0;
+}
+
 /**
  * Data plane threads: message handling
  */
@@ -501,6 +649,7 @@ thread_msg_handle_pipeline_enable(struct softnic_thread_data *t,
 	t->p[t->n_pipelines] = req->pipeline_enable.p;
 
 	p->p = req->pipeline_enable.p;
+	p->cycles_busy = 0;
 	for (i = 0; i < req->pipeline_enable.n_tables; i++)
 		p->table_data[i].a =
 			req->pipeline_enable.table[i].a;
@@ -2994,6 +3143,7 @@ rte_pmd_softnic_run_internal(void *arg)
 	struct rte_eth_dev *dev = arg;
 	struct pmd_internals *softnic;
 	struct softnic_thread_data *t;
+	uint64_t tsc;
 	uint32_t thread_id, j;
 
 	softnic = dev->data->dev_private;
@@ -3002,8 +3152,22 @@ rte_pmd_softnic_run_internal(void *arg)
 	t->iter++;
 
 	/* Data Plane */
-	for (j = 0; j < t->n_pipelines; j++)
-		rte_pipeline_run(t->p[j]);
+	tsc = rte_rdtsc();
+	for (j = 0; j < t->n_pipelines; j++) {
+		uint64_t tsc_end;
+		int n_pkts;
+
+		n_pkts = rte_pipeline_run(t->p[j]);
+		tsc_end = rte_rdtsc();
+
+		/* Busy cycles, for the pipeline load balancing */
+		if (n_pkts) {
+			t->pipeline_data[j].cycles_busy += tsc_end - tsc;
+			t->cycles_busy += tsc_end - tsc;
+		}
+
+		tsc = tsc_end;
+	}
 
 	/* Control Plane */
 	if ((t->iter & 0xFLLU) == 0) {
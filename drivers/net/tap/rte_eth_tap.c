@@ -292,7 +292,7 @@ tun_alloc(struct pmd_internals *pmd, int is_keepalive)
 	return -1;
 }
 
-static void
+void
 tap_verify_csum(struct rte_mbuf *mbuf)
 {
 	uint32_t l2 = mbuf->packet_type & RTE_PTYPE_L2_MASK;
@@ -416,7 +416,7 @@ pmd_rx_burst(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 {
 	struct rx_queue *rxq = queue;
 	struct pmd_process_private *process_private;
-	uint16_t num_rx;
+	uint16_t num_rx, i;
 	unsigned long num_rx_bytes = 0;
 	uint32_t trigger = tap_trigger;
 
@@ -424,6 +424,11 @@ pmd_rx_burst(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 		return 0;
 
 	process_private = rte_eth_devices[rxq->in_port].process_private;
+	if (process_private->rxq_uring[rxq->queue_id] != NULL)
+		return tap_uring_rx_burst(rxq,
+				process_private->rxq_uring[rxq->queue_id],
+				bufs, nb_pkts, trigger);
+
 	for (num_rx = 0; num_rx < nb_pkts; ) {
 		struct rte_mbuf *mbuf = rxq->pool;
 		struct rte_mbuf *seg = NULL;
@@ -487,16 +492,17 @@ pmd_rx_burst(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 			data_off = 0;
 		}
 		seg->next = NULL;
-		mbuf->packet_type = rte_net_get_ptype(mbuf, NULL,
-						      RTE_PTYPE_ALL_MASK);
-		if (rxq->rxmode->offloads & DEV_RX_OFFLOAD_CHECKSUM)
-			tap_verify_csum(mbuf);
 
 		/* account for the receive frame */
 		bufs[num_rx++] = mbuf;
 		num_rx_bytes += mbuf->pkt_len;
 	}
 end:
+	rte_net_get_ptype_bulk(bufs, num_rx, RTE_PTYPE_ALL_MASK);
+	if (rxq->rxmode->offloads & DEV_RX_OFFLOAD_CHECKSUM)
+		for (i = 0; i < num_rx; i++)
+			tap_verify_csum(bufs[i]);
+
 	rxq->stats.ipackets += num_rx;
 	rxq->stats.ibytes += num_rx_bytes;
 
@@ -607,7 +613,6 @@ tap_write_mbufs(struct tx_queue *txq, uint16_t num_mbufs,
 		struct tun_pi pi = { .flags = 0, .proto = 0x00 };
 		struct rte_mbuf *seg = mbuf;
 		char m_copy[mbuf->data_len];
-		int proto;
 		int n;
 		int j;
 		int k; /* current index in iovecs for copying segments */
@@ -619,25 +624,8 @@ tap_write_mbufs(struct tx_queue *txq, uint16_t num_mbufs,
 		uint16_t is_cksum = 0; /* in case cksum should be offloaded */
 
 		l4_cksum = NULL;
-		if (txq->type == ETH_TUNTAP_TYPE_TUN) {
-			/*
-			 * TUN and TAP are created with IFF_NO_PI disabled.
-			 * For TUN PMD this mandatory as fields are used by
-			 * Kernel tun.c to determine whether its IP or non IP
-			 * packets.
-			 *
-			 * The logic fetches the first byte of data from mbuf
-			 * then compares whether its v4 or v6. If first byte
-			 * is 4 or 6, then protocol field is updated.
-			 */
-			char *buff_data = rte_pktmbuf_mtod(seg, void *);
-			proto = (*buff_data & 0xf0);
-			pi.proto = (proto == 0x40) ?
-				rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4) :
-				((proto == 0x60) ?
-					rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV6) :
-					0x00);
-		}
+		if (txq->type == ETH_TUNTAP_TYPE_TUN)
+			pi.proto = tap_tun_pi_proto(seg);
 
 		k = 0;
 		iovecs[k].iov_base = &pi;
@@ -717,6 +705,7 @@ static uint16_t
 pmd_tx_burst(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 {
 	struct tx_queue *txq = queue;
+	struct pmd_process_private *process_private;
 	uint16_t num_tx = 0;
 	uint16_t num_packets = 0;
 	unsigned long num_tx_bytes = 0;
@@ -726,6 +715,12 @@ pmd_tx_burst(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 	if (unlikely(nb_pkts == 0))
 		return 0;
 
+	process_private = rte_eth_devices[txq->out_port].process_private;
+	if (process_private->txq_uring[txq->queue_id] != NULL)
+		return tap_uring_tx_burst(txq,
+				process_private->txq_uring[txq->queue_id],
+				bufs, nb_pkts);
+
 	struct rte_mbuf *gso_mbufs[MAX_GSO_MBUFS];
 	max_size = *txq->mtu + (RTE_ETHER_HDR_LEN + RTE_ETHER_CRC_LEN + 4);
 	for (i = 0; i < nb_pkts; i++) {
@@ -1116,6 +1111,10 @@ tap_dev_close(struct rte_eth_dev *dev)
 	}
 
 	for (i = 0; i < RTE_PMD_TAP_MAX_QUEUES; i++) {
+		tap_uring_free(process_private->rxq_uring[i]);
+		process_private->rxq_uring[i] = NULL;
+		tap_uring_free(process_private->txq_uring[i]);
+		process_private->txq_uring[i] = NULL;
 		if (process_private->rxq_fds[i] != -1) {
 			rxq = &internals->rxq[i];
 			close(process_private->rxq_fds[i]);
@@ -1180,6 +1179,8 @@ tap_rx_queue_release(void *queue)
 	if (!rxq)
 		return;
 	process_private = rte_eth_devices[rxq->in_port].process_private;
+	tap_uring_free(process_private->rxq_uring[rxq->queue_id]);
+	process_private->rxq_uring[rxq->queue_id] = NULL;
 	if (process_private->rxq_fds[rxq->queue_id] != -1) {
 		close(process_private->rxq_fds[rxq->queue_id]);
 		process_private->rxq_fds[rxq->queue_id] = -1;
@@ -1199,6 +1200,8 @@ tap_tx_queue_release(void *queue)
 	if (!txq)
 		return;
 	process_private = rte_eth_devices[txq->out_port].process_private;
+	tap_uring_free(process_private->txq_uring[txq->queue_id]);
+	process_private->txq_uring[txq->queue_id] = NULL;
 
 	if (process_private->txq_fds[txq->queue_id] != -1) {
 		close(process_private->txq_fds[txq->queue_id]);
@@ -1591,9 +1594,16 @@ tap_rx_queue_setup(struct rte_eth_dev *dev,
 		tmp = &(*tmp)->next;
 	}
 
-	TAP_LOG(DEBUG, "  RX TUNTAP device name %s, qid %d on fd %d",
+	/* Scattered packets are read with readv() only */
+	if (!(rxq->rxmode->offloads & DEV_RX_OFFLOAD_SCATTER))
+		process_private->rxq_uring[rx_queue_id] =
+			tap_uring_rx_create(rxq, fd, nb_rx_desc, socket_id);
+
+	TAP_LOG(DEBUG, "  RX TUNTAP device name %s, qid %d on fd %d%s",
 		internals->name, rx_queue_id,
-		process_private->rxq_fds[rx_queue_id]);
+		process_private->rxq_fds[rx_queue_id],
+		process_private->rxq_uring[rx_queue_id] != NULL ?
+			" with io_uring" : "");
 
 	return 0;
 
@@ -1608,8 +1618,8 @@ tap_rx_queue_setup(struct rte_eth_dev *dev,
 static int
 tap_tx_queue_setup(struct rte_eth_dev *dev,
 		   uint16_t tx_queue_id,
-		   uint16_t nb_tx_desc __rte_unused,
-		   unsigned int socket_id __rte_unused,
+		   uint16_t nb_tx_desc,
+		   unsigned int socket_id,
 		   const struct rte_eth_txconf *tx_conf)
 {
 	struct pmd_internals *internals = dev->data->dev_private;
@@ -1634,11 +1644,19 @@ tap_tx_queue_setup(struct rte_eth_dev *dev,
 	ret = tap_setup_queue(dev, internals, tx_queue_id, 0);
 	if (ret == -1)
 		return -1;
+
+	/* The checksum and segmentation offloads are done with writev() */
+	if (!txq->csum && !(offloads & DEV_TX_OFFLOAD_TCP_TSO))
+		process_private->txq_uring[tx_queue_id] =
+			tap_uring_tx_create(txq, ret, nb_tx_desc, socket_id);
+
 	TAP_LOG(DEBUG,
-		"  TX TUNTAP device name %s, qid %d on fd %d csum %s",
+		"  TX TUNTAP device name %s, qid %d on fd %d csum %s%s",
 		internals->name, tx_queue_id,
 		process_private->txq_fds[tx_queue_id],
-		txq->csum ? "on" : "off");
+		txq->csum ? "on" : "off",
+		process_private->txq_uring[tx_queue_id] != NULL ?
+			" with io_uring" : "");
 
 	return 0;
 }
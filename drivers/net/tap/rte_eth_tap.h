@@ -94,13 +94,95 @@ struct pmd_internals {
 	struct rte_mempool *gso_ctx_mp;     /* Mempool for GSO packets */
 };
 
+struct tap_uring;
+
 struct pmd_process_private {
 	int rxq_fds[RTE_PMD_TAP_MAX_QUEUES];
 	int txq_fds[RTE_PMD_TAP_MAX_QUEUES];
+	/* io_uring of the queues, NULL to use readv() and writev() */
+	struct tap_uring *rxq_uring[RTE_PMD_TAP_MAX_QUEUES];
+	struct tap_uring *txq_uring[RTE_PMD_TAP_MAX_QUEUES];
 };
 
+/*
+ * TUN and TAP are created with IFF_NO_PI disabled. For TUN PMD the protocol
+ * of the packet info is mandatory as it is used by Kernel tun.c to determine
+ * whether its IP or non IP packets: it is set from the IP version in the
+ * first byte of data of the mbuf.
+ */
+static inline uint16_t
+tap_tun_pi_proto(const struct rte_mbuf *mbuf)
+{
+	const uint8_t *data = rte_pktmbuf_mtod(mbuf, const uint8_t *);
+
+	switch (*data & 0xf0) {
+	case 0x40:
+		return rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4);
+	case 0x60:
+		return rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV6);
+	default:
+		return 0;
+	}
+}
+
+/* rte_eth_tap.c */
+
+void tap_verify_csum(struct rte_mbuf *mbuf);
+
 /* tap_intr.c */
 
 int tap_rx_intr_vec_set(struct rte_eth_dev *dev, int set);
 
+/* tap_uring.c */
+
+#ifdef RTE_NET_TAP_IO_URING
+struct tap_uring *tap_uring_rx_create(struct rx_queue *rxq, int fd,
+				      uint16_t nb_desc, int socket_id);
+struct tap_uring *tap_uring_tx_create(struct tx_queue *txq, int fd,
+				      uint16_t nb_desc, int socket_id);
+void tap_uring_free(struct tap_uring *u);
+uint16_t tap_uring_rx_burst(struct rx_queue *rxq, struct tap_uring *u,
+			    struct rte_mbuf **bufs, uint16_t nb_pkts,
+			    uint32_t trigger);
+uint16_t tap_uring_tx_burst(struct tx_queue *txq, struct tap_uring *u,
+			    struct rte_mbuf **bufs, uint16_t nb_pkts);
+#else
+static inline struct tap_uring *
+tap_uring_rx_create(struct rx_queue *rxq __rte_unused, int fd __rte_unused,
+		    uint16_t nb_desc __rte_unused, int socket_id __rte_unused)
+{
+	return NULL;
+}
+
+static inline struct tap_uring *
+tap_uring_tx_create(struct tx_queue *txq __rte_unused, int fd __rte_unused,
+		    uint16_t nb_desc __rte_unused, int socket_id __rte_unused)
+{
+	return NULL;
+}
+
+static inline void
+tap_uring_free(struct tap_uring *u __rte_unused)
+{
+}
+
+static inline uint16_t
+tap_uring_rx_burst(struct rx_queue *rxq __rte_unused,
+		   struct tap_uring *u __rte_unused,
+		   struct rte_mbuf **bufs __rte_unused,
+		   uint16_t nb_pkts __rte_unused, uint32_t trigger __rte_unused)
+{
+	return 0;
+}
+
+static inline uint16_t
+tap_uring_tx_burst(struct tx_queue *txq __rte_unused,
+		   struct tap_uring *u __rte_unused,
+		   struct rte_mbuf **bufs __rte_unused,
+		   uint16_t nb_pkts __rte_unused)
+{
+	return 0;
+}
+#endif
+
 #endif /* _RTE_ETH_TAP_H_ */
@@ -0,0 +1,441 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright 2021 6WIND S.A.
+ */
+
+/**
+ * @file
+ * io_uring backend of the TAP queues.
+ *
+ * The packets of a burst are read or written with a single io_uring_enter()
+ * system call instead of a readv() or writev() per packet.
+ *
+ * Each Rx slot holds an mbuf with a read posted on the queue file
+ * descriptor. The packet info header is read in the tail of the mbuf
+ * headroom, followed by the packet data, and the memory chunks of the
+ * mempool are registered as fixed buffers when possible, so the kernel does
+ * not have to map the pages on each read. As the file descriptors are
+ * non-blocking, the reads complete as soon as they are submitted, with
+ * -EAGAIN if there is no packet: the slots are then submitted again on the
+ * next burst after an Rx trigger.
+ *
+ * Each Tx slot holds an mbuf and the iovecs of its write until its
+ * completion is reaped, when the mbuf is freed.
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/uio.h>
+
+#include <liburing.h>
+
+#include <rte_common.h>
+#include <rte_malloc.h>
+#include <rte_mbuf.h>
+#include <rte_mempool.h>
+#include <rte_net.h>
+
+#include <rte_eth_tap.h>
+
+#define TAP_URING_MAX_DEPTH	256
+#define TAP_URING_MAX_REGIONS	64
+/* io_uring refuses fixed buffers larger than 1GB */
+#define TAP_URING_REGION_MAX_LEN (UINT64_C(1) << 30)
+#define TAP_URING_TX_MAX_SEGS	32
+
+struct tap_uring_tx_slot {
+	struct rte_mbuf *mbuf;          /* Mbuf being written */
+	struct tun_pi pi;               /* Packet info of the mbuf */
+	struct iovec iovecs[TAP_URING_TX_MAX_SEGS + 1]; /* pi and segments */
+};
+
+struct tap_uring {
+	struct io_uring ring;
+	int fd;                         /* Queue file descriptor */
+	uint32_t depth;                 /* Number of slots */
+	uint32_t inflight;              /* Submitted but not reaped */
+	uint32_t nb_free;               /* Tx: number of free slots */
+	uint32_t *free_slots;           /* Tx: stack of free slots */
+	struct tap_uring_tx_slot *tx_slots; /* Tx: slots */
+	struct rte_mbuf **rx_mbufs;     /* Rx: mbuf of each slot */
+	unsigned int nb_regions;        /* Rx: number of fixed buffers */
+	struct iovec regions[TAP_URING_MAX_REGIONS]; /* Rx: fixed buffers */
+};
+
+static struct tap_uring *
+tap_uring_create(int fd, uint16_t nb_desc, int socket_id)
+{
+	struct io_uring_probe *probe;
+	struct tap_uring *u;
+	bool supported;
+	int ret;
+
+	u = rte_zmalloc_socket("tap_uring", sizeof(*u), 0, socket_id);
+	if (u == NULL)
+		return NULL;
+
+	u->fd = fd;
+	u->depth = RTE_MIN(rte_align32pow2(RTE_MAX(nb_desc, 1)),
+			   (uint32_t)TAP_URING_MAX_DEPTH);
+	ret = io_uring_queue_init(u->depth, &u->ring, 0);
+	if (ret < 0) {
+		TAP_LOG(INFO, "io_uring unavailable: %s", strerror(-ret));
+		rte_free(u);
+		return NULL;
+	}
+
+	probe = io_uring_get_probe_ring(&u->ring);
+	supported = probe != NULL &&
+		io_uring_opcode_supported(probe, IORING_OP_READ) &&
+		io_uring_opcode_supported(probe, IORING_OP_READ_FIXED) &&
+		io_uring_opcode_supported(probe, IORING_OP_WRITEV);
+	if (probe != NULL)
+		io_uring_free_probe(probe);
+	if (!supported) {
+		TAP_LOG(INFO, "io_uring read and write not supported");
+		io_uring_queue_exit(&u->ring);
+		rte_free(u);
+		return NULL;
+	}
+
+	return u;
+}
+
+/* Reap the completions left, no new operation being submitted */
+static void
+tap_uring_drain(struct tap_uring *u)
+{
+	struct io_uring_cqe *cqe;
+
+	while (u->inflight > 0 && io_uring_wait_cqe(&u->ring, &cqe) == 0) {
+		io_uring_cqe_seen(&u->ring, cqe);
+		u->inflight--;
+	}
+}
+
+void
+tap_uring_free(struct tap_uring *u)
+{
+	uint32_t i;
+
+	if (u == NULL)
+		return;
+
+	tap_uring_drain(u);
+	io_uring_queue_exit(&u->ring);
+
+	if (u->rx_mbufs != NULL) {
+		for (i = 0; i < u->depth; i++)
+			rte_pktmbuf_free(u->rx_mbufs[i]);
+		rte_free(u->rx_mbufs);
+	}
+
+	if (u->tx_slots != NULL) {
+		for (i = 0; i < u->depth; i++)
+			rte_pktmbuf_free(u->tx_slots[i].mbuf);
+		rte_free(u->tx_slots);
+	}
+
+	rte_free(u->free_slots);
+	rte_free(u);
+}
+
+static int
+tap_uring_submit(struct tap_uring *u)
+{
+	int ret;
+
+	ret = io_uring_submit(&u->ring);
+	if (ret > 0)
+		u->inflight += ret;
+
+	return ret;
+}
+
+static void
+tap_uring_region_add(struct rte_mempool *mp __rte_unused, void *opaque,
+		     struct rte_mempool_memhdr *memhdr,
+		     unsigned int mem_idx __rte_unused)
+{
+	struct tap_uring *u = opaque;
+
+	/* The buffers of the other chunks are read without registration */
+	if (u->nb_regions == TAP_URING_MAX_REGIONS ||
+	    memhdr->len > TAP_URING_REGION_MAX_LEN)
+		return;
+
+	u->regions[u->nb_regions].iov_base = memhdr->addr;
+	u->regions[u->nb_regions].iov_len = memhdr->len;
+	u->nb_regions++;
+}
+
+/* Index of the fixed buffer holding [buf, buf + len[, or -1 */
+static inline int
+tap_uring_region_find(const struct tap_uring *u, const char *buf,
+		      unsigned int len)
+{
+	const char *base;
+	unsigned int i;
+
+	for (i = 0; i < u->nb_regions; i++) {
+		base = u->regions[i].iov_base;
+		if (buf >= base && buf + len <= base + u->regions[i].iov_len)
+			return i;
+	}
+
+	return -1;
+}
+
+static inline void
+tap_uring_rx_post(struct tap_uring *u, uint32_t slot)
+{
+	struct rte_mbuf *mbuf = u->rx_mbufs[slot];
+	struct io_uring_sqe *sqe;
+	unsigned int len;
+	char *buf;
+	int idx;
+
+	/* The packet info ends where the packet data starts */
+	buf = (char *)mbuf->buf_addr + RTE_PKTMBUF_HEADROOM -
+		sizeof(struct tun_pi);
+	len = mbuf->buf_len - RTE_PKTMBUF_HEADROOM + sizeof(struct tun_pi);
+
+	/* A slot has at most one operation, the ring never runs out */
+	sqe = io_uring_get_sqe(&u->ring);
+	idx = tap_uring_region_find(u, buf, len);
+	if (idx >= 0)
+		io_uring_prep_read_fixed(sqe, u->fd, buf, len, 0, idx);
+	else
+		io_uring_prep_read(sqe, u->fd, buf, len, 0);
+	io_uring_sqe_set_data(sqe, (void *)(uintptr_t)slot);
+}
+
+struct tap_uring *
+tap_uring_rx_create(struct rx_queue *rxq, int fd, uint16_t nb_desc,
+		    int socket_id)
+{
+	struct tap_uring *u;
+	uint32_t i;
+	int ret;
+
+	RTE_BUILD_BUG_ON(RTE_PKTMBUF_HEADROOM < sizeof(struct tun_pi));
+
+	u = tap_uring_create(fd, nb_desc, socket_id);
+	if (u == NULL)
+		return NULL;
+
+	u->rx_mbufs = rte_zmalloc_socket("tap_uring_rx",
+			u->depth * sizeof(u->rx_mbufs[0]), 0, socket_id);
+	if (u->rx_mbufs == NULL)
+		goto error;
+
+	if (rte_pktmbuf_alloc_bulk(rxq->mp, u->rx_mbufs, u->depth) != 0) {
+		memset(u->rx_mbufs, 0, u->depth * sizeof(u->rx_mbufs[0]));
+		goto error;
+	}
+
+	rte_mempool_mem_iter(rxq->mp, tap_uring_region_add, u);
+	ret = u->nb_regions == 0 ? -ENOENT :
+		io_uring_register_buffers(&u->ring, u->regions, u->nb_regions);
+	if (ret < 0) {
+		/* e.g. RLIMIT_MEMLOCK is too low to pin the buffers */
+		TAP_LOG(INFO, "Cannot register Rx buffers: %s",
+			strerror(-ret));
+		u->nb_regions = 0;
+	}
+
+	/* The reads are submitted on the first burst */
+	for (i = 0; i < u->depth; i++)
+		tap_uring_rx_post(u, i);
+
+	TAP_LOG(DEBUG, "io_uring Rx queue %u, %u slots, %u fixed buffers",
+		rxq->queue_id, u->depth, u->nb_regions);
+
+	return u;
+
+error:
+	tap_uring_free(u);
+	return NULL;
+}
+
+uint16_t
+tap_uring_rx_burst(struct rx_queue *rxq, struct tap_uring *u,
+		   struct rte_mbuf **bufs, uint16_t nb_pkts, uint32_t trigger)
+{
+	struct io_uring_cqe *cqes[TAP_URING_MAX_DEPTH];
+	unsigned long num_rx_bytes = 0;
+	struct rte_mbuf *mbuf, *nmb;
+	bool drained = false;
+	uint16_t num_rx = 0;
+	uint32_t slot;
+	unsigned int i, n;
+	int len;
+
+	/* Run the reads posted since the last submission */
+	if (io_uring_sq_ready(&u->ring) > 0)
+		tap_uring_submit(u);
+
+	n = io_uring_peek_batch_cqe(&u->ring, cqes,
+			RTE_MIN(nb_pkts, (uint16_t)TAP_URING_MAX_DEPTH));
+	for (i = 0; i < n; i++) {
+		slot = (uint32_t)(uintptr_t)io_uring_cqe_get_data(cqes[i]);
+		len = cqes[i]->res;
+		mbuf = u->rx_mbufs[slot];
+
+		if (len == -EAGAIN) {
+			drained = true;
+			goto repost;
+		}
+
+		/* Packet truncated if it could not fit in the mbuf */
+		if (unlikely(len < (int)sizeof(struct tun_pi) ||
+			     (rte_pktmbuf_mtod_offset(mbuf, struct tun_pi *,
+					-(int)sizeof(struct tun_pi))->flags &
+			      TUN_PKT_STRIP))) {
+			rxq->stats.ierrors++;
+			goto repost;
+		}
+
+		nmb = rte_pktmbuf_alloc(rxq->mp);
+		if (unlikely(nmb == NULL)) {
+			/* The packet is dropped to keep the slot going */
+			rxq->stats.rx_nombuf++;
+			goto repost;
+		}
+		u->rx_mbufs[slot] = nmb;
+
+		len -= sizeof(struct tun_pi);
+		mbuf->data_len = len;
+		mbuf->pkt_len = len;
+		mbuf->port = rxq->in_port;
+		bufs[num_rx++] = mbuf;
+		num_rx_bytes += len;
+repost:
+		tap_uring_rx_post(u, slot);
+	}
+	io_uring_cq_advance(&u->ring, n);
+	u->inflight -= n;
+
+	rte_net_get_ptype_bulk(bufs, num_rx, RTE_PTYPE_ALL_MASK);
+	if (rxq->rxmode->offloads & DEV_RX_OFFLOAD_CHECKSUM)
+		for (i = 0; i < num_rx; i++)
+			tap_verify_csum(bufs[i]);
+
+	rxq->stats.ipackets += num_rx;
+	rxq->stats.ibytes += num_rx_bytes;
+
+	/* The queue is empty once a read found no packet */
+	if (trigger && drained)
+		rxq->trigger_seen = trigger;
+
+	return num_rx;
+}
+
+struct tap_uring *
+tap_uring_tx_create(struct tx_queue *txq, int fd, uint16_t nb_desc,
+		    int socket_id)
+{
+	struct tap_uring *u;
+	uint32_t i;
+
+	u = tap_uring_create(fd, nb_desc, socket_id);
+	if (u == NULL)
+		return NULL;
+
+	u->tx_slots = rte_zmalloc_socket("tap_uring_tx",
+			u->depth * sizeof(u->tx_slots[0]), 0, socket_id);
+	u->free_slots = rte_zmalloc_socket("tap_uring_tx",
+			u->depth * sizeof(u->free_slots[0]), 0, socket_id);
+	if (u->tx_slots == NULL || u->free_slots == NULL) {
+		tap_uring_free(u);
+		return NULL;
+	}
+
+	for (i = 0; i < u->depth; i++)
+		u->free_slots[i] = i;
+	u->nb_free = u->depth;
+
+	TAP_LOG(DEBUG, "io_uring Tx queue %u, %u slots",
+		txq->queue_id, u->depth);
+
+	return u;
+}
+
+static void
+tap_uring_tx_complete(struct tx_queue *txq, struct tap_uring *u)
+{
+	struct io_uring_cqe *cqes[TAP_URING_MAX_DEPTH];
+	struct tap_uring_tx_slot *slot;
+	unsigned int i, n;
+	uint32_t idx;
+
+	n = io_uring_peek_batch_cqe(&u->ring, cqes, TAP_URING_MAX_DEPTH);
+	for (i = 0; i < n; i++) {
+		idx = (uint32_t)(uintptr_t)io_uring_cqe_get_data(cqes[i]);
+		slot = &u->tx_slots[idx];
+
+		if (likely(cqes[i]->res > 0)) {
+			txq->stats.opackets++;
+			txq->stats.obytes += rte_pktmbuf_pkt_len(slot->mbuf);
+		} else {
+			txq->stats.errs++;
+		}
+
+		rte_pktmbuf_free(slot->mbuf);
+		slot->mbuf = NULL;
+		u->free_slots[u->nb_free++] = idx;
+	}
+	io_uring_cq_advance(&u->ring, n);
+	u->inflight -= n;
+}
+
+uint16_t
+tap_uring_tx_burst(struct tx_queue *txq, struct tap_uring *u,
+		   struct rte_mbuf **bufs, uint16_t nb_pkts)
+{
+	struct tap_uring_tx_slot *slot;
+	struct io_uring_sqe *sqe;
+	struct rte_mbuf *mbuf, *seg;
+	uint16_t num_tx, j;
+	uint32_t max_size;
+	uint32_t idx;
+
+	tap_uring_tx_complete(txq, u);
+
+	max_size = *txq->mtu + (RTE_ETHER_HDR_LEN + RTE_ETHER_CRC_LEN + 4);
+	for (num_tx = 0; num_tx < nb_pkts && u->nb_free > 0; num_tx++) {
+		mbuf = bufs[num_tx];
+		if (rte_pktmbuf_pkt_len(mbuf) > max_size ||
+		    mbuf->nb_segs > TAP_URING_TX_MAX_SEGS)
+			break;
+
+		idx = u->free_slots[--u->nb_free];
+		slot = &u->tx_slots[idx];
+		slot->mbuf = mbuf;
+
+		slot->pi.flags = 0;
+		slot->pi.proto = txq->type == ETH_TUNTAP_TYPE_TUN ?
+			tap_tun_pi_proto(mbuf) : 0;
+		slot->iovecs[0].iov_base = &slot->pi;
+		slot->iovecs[0].iov_len = sizeof(slot->pi);
+		for (seg = mbuf, j = 1; seg != NULL; seg = seg->next, j++) {
+			slot->iovecs[j].iov_base = rte_pktmbuf_mtod(seg, void *);
+			slot->iovecs[j].iov_len = rte_pktmbuf_data_len(seg);
+		}
+
+		sqe = io_uring_get_sqe(&u->ring);
+		io_uring_prep_writev(sqe, u->fd, slot->iovecs, j, 0);
+		io_uring_sqe_set_data(sqe, (void *)(uintptr_t)idx);
+	}
+
+	if (num_tx > 0) {
+		tap_uring_submit(u);
+		/* The writes complete on submission, free their mbufs now */
+		tap_uring_tx_complete(txq, u);
+	}
+
+	txq->stats.errs += nb_pkts - num_tx;
+
+	return num_tx;
+}
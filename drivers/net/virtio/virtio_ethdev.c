@@ -1502,9 +1502,12 @@ set_rxtx_funcs(struct rte_eth_dev *eth_dev)
 	if (virtio_with_packed_queue(hw)) {
 		PMD_INIT_LOG(INFO,
 			"virtio: using packed ring %s Tx path on port %u",
-			hw->use_vec_tx ? "vectorized" : "standard",
+			!hw->use_vec_tx ? "standard" :
+			hw->use_vec_avx2 ? "AVX2 vectorized" : "vectorized",
 			eth_dev->data->port_id);
-		if (hw->use_vec_tx)
+		if (hw->use_vec_tx && hw->use_vec_avx2)
+			eth_dev->tx_pkt_burst = virtio_xmit_pkts_packed_vec_avx2;
+		else if (hw->use_vec_tx)
 			eth_dev->tx_pkt_burst = virtio_xmit_pkts_packed_vec;
 		else
 			eth_dev->tx_pkt_burst = virtio_xmit_pkts_packed;
@@ -1521,11 +1524,22 @@ set_rxtx_funcs(struct rte_eth_dev *eth_dev)
 	}
 
 	if (virtio_with_packed_queue(hw)) {
-		if (hw->use_vec_rx) {
+		if (hw->use_vec_rx &&
+		    virtio_with_feature(hw, VIRTIO_NET_F_MRG_RXBUF)) {
 			PMD_INIT_LOG(INFO,
-				"virtio: using packed ring vectorized Rx path on port %u",
+				"virtio: using packed ring %s mergeable buffer Rx path on port %u",
+				hw->use_vec_avx2 ? "AVX2 vectorized" : "vectorized",
 				eth_dev->data->port_id);
-			eth_dev->rx_pkt_burst =
+			eth_dev->rx_pkt_burst = hw->use_vec_avx2 ?
+				&virtio_recv_mergeable_pkts_packed_vec_avx2 :
+				&virtio_recv_mergeable_pkts_packed_vec;
+		} else if (hw->use_vec_rx) {
+			PMD_INIT_LOG(INFO,
+				"virtio: using packed ring %s Rx path on port %u",
+				hw->use_vec_avx2 ? "AVX2 vectorized" : "vectorized",
+				eth_dev->data->port_id);
+			eth_dev->rx_pkt_burst = hw->use_vec_avx2 ?
+				&virtio_recv_pkts_packed_vec_avx2 :
 				&virtio_recv_pkts_packed_vec;
 		} else if (virtio_with_feature(hw, VIRTIO_NET_F_MRG_RXBUF)) {
 			PMD_INIT_LOG(INFO,
@@ -1864,7 +1878,8 @@ eth_virtio_dev_init(struct rte_eth_dev *eth_dev)
 		if (!virtio_with_packed_queue(hw)) {
 			hw->use_vec_rx = 1;
 		} else {
-#if defined(CC_AVX512_SUPPORT) || defined(RTE_ARCH_ARM)
+#if defined(CC_AVX512_SUPPORT) || defined(CC_AVX2_SUPPORT) || \
+	defined(RTE_ARCH_ARM)
 			hw->use_vec_rx = 1;
 			hw->use_vec_tx = 1;
 #else
@@ -2109,12 +2124,24 @@ virtio_dev_configure(struct rte_eth_dev *dev)
 		}
 
 	if (virtio_with_packed_queue(hw)) {
-#if defined(RTE_ARCH_X86_64) && defined(CC_AVX512_SUPPORT)
+#if defined(RTE_ARCH_X86_64) && \
+	(defined(CC_AVX512_SUPPORT) || defined(CC_AVX2_SUPPORT))
+		bool avx512 = false, avx2 = false;
+
+#ifdef CC_AVX512_SUPPORT
+		avx512 = rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F) &&
+			rte_vect_get_max_simd_bitwidth() >= RTE_VECT_SIMD_512;
+#endif
+#ifdef CC_AVX2_SUPPORT
+		avx2 = rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX2) &&
+			rte_vect_get_max_simd_bitwidth() >= RTE_VECT_SIMD_256;
+#endif
+		/* AVX512 is preferred, AVX2 is the fallback */
+		hw->use_vec_avx2 = !avx512;
 		if ((hw->use_vec_rx || hw->use_vec_tx) &&
-		    (!rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F) ||
+		    ((!avx512 && !avx2) ||
 		     !virtio_with_feature(hw, VIRTIO_F_IN_ORDER) ||
-		     !virtio_with_feature(hw, VIRTIO_F_VERSION_1) ||
-		     rte_vect_get_max_simd_bitwidth() < RTE_VECT_SIMD_512)) {
+		     !virtio_with_feature(hw, VIRTIO_F_VERSION_1))) {
 			PMD_DRV_LOG(INFO,
 				"disabled packed ring vectorized path for requirements not met");
 			hw->use_vec_rx = 0;
@@ -2137,12 +2164,6 @@ virtio_dev_configure(struct rte_eth_dev *dev)
 #endif
 
 		if (hw->use_vec_rx) {
-			if (virtio_with_feature(hw, VIRTIO_NET_F_MRG_RXBUF)) {
-				PMD_DRV_LOG(INFO,
-					"disabled packed ring vectorized rx for mrg_rxbuf enabled");
-				hw->use_vec_rx = 0;
-			}
-
 			if (rx_offloads & DEV_RX_OFFLOAD_TCP_LRO) {
 				PMD_DRV_LOG(INFO,
 					"disabled packed ring vectorized rx for TCP_LRO enabled");
@@ -21,6 +21,7 @@
 #include <rte_errno.h>
 #include <rte_byteorder.h>
 #include <rte_net.h>
+#include <rte_net_cksum.h>
 #include <rte_ip.h>
 #include <rte_udp.h>
 #include <rte_tcp.h>
@@ -902,7 +903,7 @@ virtio_rx_offload(struct rte_mbuf *m, struct virtio_net_hdr *hdr)
 			 */
 			uint16_t csum = 0, off;
 
-			if (rte_raw_cksum_mbuf(m, hdr->csum_start,
+			if (rte_net_raw_cksum_mbuf(m, hdr->csum_start,
 				rte_pktmbuf_pkt_len(m) - hdr->csum_start,
 				&csum) < 0)
 				return -EINVAL;
@@ -2025,6 +2026,14 @@ virtio_recv_pkts_packed_vec(void *rx_queue __rte_unused,
 	return 0;
 }
 
+__rte_weak uint16_t
+virtio_recv_mergeable_pkts_packed_vec(void *rx_queue __rte_unused,
+				      struct rte_mbuf **rx_pkts __rte_unused,
+				      uint16_t nb_pkts __rte_unused)
+{
+	return 0;
+}
+
 __rte_weak uint16_t
 virtio_xmit_pkts_packed_vec(void *tx_queue __rte_unused,
 			    struct rte_mbuf **tx_pkts __rte_unused,
@@ -2032,3 +2041,27 @@ virtio_xmit_pkts_packed_vec(void *tx_queue __rte_unused,
 {
 	return 0;
 }
+
+__rte_weak uint16_t
+virtio_recv_pkts_packed_vec_avx2(void *rx_queue __rte_unused,
+				 struct rte_mbuf **rx_pkts __rte_unused,
+				 uint16_t nb_pkts __rte_unused)
+{
+	return 0;
+}
+
+__rte_weak uint16_t
+virtio_recv_mergeable_pkts_packed_vec_avx2(void *rx_queue __rte_unused,
+					   struct rte_mbuf **rx_pkts __rte_unused,
+					   uint16_t nb_pkts __rte_unused)
+{
+	return 0;
+}
+
+__rte_weak uint16_t
+virtio_xmit_pkts_packed_vec_avx2(void *tx_queue __rte_unused,
+				 struct rte_mbuf **tx_pkts __rte_unused,
+				 uint16_t nb_pkts __rte_unused)
+{
+	return 0;
+}
@@ -10,13 +10,23 @@
 
 #include <rte_net.h>
 
+#ifdef VIRTIO_RXTX_PACKED_AVX2
+/* Same burst functions built a second time for the AVX2 fallback */
+#define virtio_xmit_pkts_packed_vec virtio_xmit_pkts_packed_vec_avx2
+#define virtio_recv_pkts_packed_vec virtio_recv_pkts_packed_vec_avx2
+#define virtio_recv_mergeable_pkts_packed_vec \
+	virtio_recv_mergeable_pkts_packed_vec_avx2
+#endif
+
 #include "virtio_logs.h"
 #include "virtio_ethdev.h"
 #include "virtio_pci.h"
 #include "virtio_rxtx_packed.h"
 #include "virtqueue.h"
 
-#ifdef CC_AVX512_SUPPORT
+#ifdef VIRTIO_RXTX_PACKED_AVX2
+#include "virtio_rxtx_packed_avx2.h"
+#elif defined(CC_AVX512_SUPPORT)
 #include "virtio_rxtx_packed_avx.h"
 #elif defined(RTE_ARCH_ARM)
 #include "virtio_rxtx_packed_neon.h"
@@ -96,7 +106,7 @@ virtio_recv_pkts_packed_vec(void *rx_queue,
 
 	while (num) {
 		if (!virtqueue_dequeue_batch_packed_vec(rxvq,
-					&rx_pkts[nb_rx])) {
+					&rx_pkts[nb_rx], false)) {
 			nb_rx += PACKED_BATCH_SIZE;
 			num -= PACKED_BATCH_SIZE;
 			continue;
@@ -137,3 +147,67 @@ virtio_recv_pkts_packed_vec(void *rx_queue,
 
 	return nb_rx;
 }
+
+uint16_t
+virtio_recv_mergeable_pkts_packed_vec(void *rx_queue,
+				      struct rte_mbuf **rx_pkts,
+				      uint16_t nb_pkts)
+{
+	struct virtnet_rx *rxvq = rx_queue;
+	struct virtqueue *vq = virtnet_rxq_to_vq(rxvq);
+	struct virtio_hw *hw = vq->hw;
+	uint16_t num, nb_rx = 0;
+	uint32_t nb_enqueued = 0;
+
+	if (unlikely(hw->started == 0))
+		return nb_rx;
+
+	num = RTE_MIN(VIRTIO_MBUF_BURST_SZ, nb_pkts);
+	if (likely(num > PACKED_BATCH_SIZE))
+		num = num - ((vq->vq_used_cons_idx + num) % PACKED_BATCH_SIZE);
+
+	while (num) {
+		if (!virtqueue_dequeue_batch_packed_vec(rxvq,
+					&rx_pkts[nb_rx], true)) {
+			nb_rx += PACKED_BATCH_SIZE;
+			num -= PACKED_BATCH_SIZE;
+			continue;
+		}
+		if (!virtqueue_dequeue_single_mrg_packed_vec(rxvq,
+					&rx_pkts[nb_rx])) {
+			nb_rx++;
+			num--;
+			continue;
+		}
+		break;
+	};
+
+	PMD_RX_LOG(DEBUG, "dequeue:%d", num);
+
+	rxvq->stats.packets += nb_rx;
+
+	if (likely(vq->vq_free_cnt >= vq->vq_free_thresh)) {
+		/* free_cnt may include mrg descs */
+		uint16_t free_cnt = vq->vq_free_cnt;
+		struct rte_mbuf *new_pkts[free_cnt];
+		if (likely(rte_pktmbuf_alloc_bulk(rxvq->mpool, new_pkts,
+						free_cnt) == 0)) {
+			virtio_recv_refill_packed_vec(rxvq, new_pkts,
+					free_cnt);
+			nb_enqueued += free_cnt;
+		} else {
+			struct rte_eth_dev *dev =
+				&rte_eth_devices[rxvq->port_id];
+			dev->data->rx_mbuf_alloc_failed += free_cnt;
+		}
+	}
+
+	if (likely(nb_enqueued)) {
+		if (unlikely(virtqueue_kick_prepare_packed(vq))) {
+			virtqueue_notify(vq);
+			PMD_RX_LOG(DEBUG, "Notified");
+		}
+	}
+
+	return nb_rx;
+}
@@ -20,7 +20,7 @@
 
 #define BYTE_SIZE 8
 
-#ifdef CC_AVX512_SUPPORT
+#ifdef RTE_ARCH_X86
 /* flag bits offset in packed ring desc higher 64bits */
 #define FLAGS_BITS_OFFSET ((offsetof(struct vring_packed_desc, flags) - \
 	offsetof(struct vring_packed_desc, len)) * BYTE_SIZE)
@@ -39,7 +39,7 @@
 #define REFCNT_BITS_OFFSET ((offsetof(struct rte_mbuf, refcnt) - \
 	offsetof(struct rte_mbuf, rearm_data)) * BYTE_SIZE)
 
-#ifdef CC_AVX512_SUPPORT
+#ifdef RTE_ARCH_X86
 /* segment number offset in mbuf rearm data */
 #define SEG_NUM_BITS_OFFSET ((offsetof(struct rte_mbuf, nb_segs) - \
 	offsetof(struct rte_mbuf, rearm_data)) * BYTE_SIZE)
@@ -259,6 +259,123 @@ virtqueue_dequeue_single_packed_vec(struct virtnet_rx *rxvq,
 	return 0;
 }
 
+/* Check that none of the packets of a batch spans several buffers, the
+ * batch dequeue can only be used for mergeable Rx buffers when it is true.
+ */
+static inline int
+virtqueue_batch_single_buffers_packed(struct virtqueue *vq, uint16_t id)
+{
+	struct virtio_hw *hw = vq->hw;
+	uint16_t hdr_size = hw->vtnet_hdr_size;
+	struct virtio_net_hdr_mrg_rxbuf *hdr;
+	struct rte_mbuf *cookie;
+	uint16_t i;
+
+	/* read the headers only after the descs were seen as used */
+	virtio_rmb(hw->weak_barriers);
+
+	virtio_for_each_try_unroll(i, 0, PACKED_BATCH_SIZE) {
+		cookie = (struct rte_mbuf *)vq->vq_descx[id + i].cookie;
+		hdr = (struct virtio_net_hdr_mrg_rxbuf *)
+			((char *)cookie->buf_addr + RTE_PKTMBUF_HEADROOM -
+			 hdr_size);
+		if (hdr->num_buffers > 1)
+			return -1;
+	}
+
+	return 0;
+}
+
+static inline uint16_t
+virtqueue_dequeue_single_mrg_packed_vec(struct virtnet_rx *rxvq,
+					struct rte_mbuf **rx_pkts)
+{
+	struct virtqueue *vq = virtnet_rxq_to_vq(rxvq);
+	struct virtio_hw *hw = vq->hw;
+	uint32_t hdr_size = hw->vtnet_hdr_size;
+	struct vring_packed_desc *desc = vq->vq_packed.ring.desc;
+	struct virtio_net_hdr_mrg_rxbuf *hdr;
+	struct rte_mbuf *head, *prev, *cookie;
+	uint16_t used_idx, idx, seg_num, i, flags;
+	uint16_t wrap_counter;
+	uint32_t len;
+
+	used_idx = vq->vq_used_cons_idx;
+	if (!desc_is_used(&desc[used_idx], vq))
+		return -1;
+
+	head = (struct rte_mbuf *)vq->vq_descx[desc[used_idx].id].cookie;
+	if (unlikely(head == NULL)) {
+		PMD_DRV_LOG(ERR, "vring descriptor with no mbuf cookie at %u",
+				used_idx);
+		return -1;
+	}
+
+	hdr = (struct virtio_net_hdr_mrg_rxbuf *)((char *)head->buf_addr +
+					RTE_PKTMBUF_HEADROOM - hdr_size);
+	seg_num = hdr->num_buffers;
+	if (seg_num == 0)
+		seg_num = 1;
+	if (unlikely(seg_num > vq->vq_nentries - vq->vq_free_cnt))
+		return -1;
+
+	/* Only consume the packet once all its buffers are used */
+	idx = used_idx;
+	wrap_counter = vq->vq_packed.used_wrap_counter;
+	for (i = 1; i < seg_num; i++) {
+		if (++idx >= vq->vq_nentries) {
+			idx -= vq->vq_nentries;
+			wrap_counter ^= 1;
+		}
+		flags = virtqueue_fetch_flags_packed(&desc[idx],
+						hw->weak_barriers);
+		if (!!(flags & VRING_PACKED_DESC_F_AVAIL) !=
+		    !!(flags & VRING_PACKED_DESC_F_USED) ||
+		    !!(flags & VRING_PACKED_DESC_F_USED) != wrap_counter)
+			return -1;
+	}
+
+	len = desc[used_idx].len;
+	head->data_off = RTE_PKTMBUF_HEADROOM;
+	head->ol_flags = 0;
+	head->nb_segs = seg_num;
+	head->pkt_len = len - hdr_size;
+	head->data_len = len - hdr_size;
+
+	prev = head;
+	idx = used_idx;
+	for (i = 1; i < seg_num; i++) {
+		if (++idx >= vq->vq_nentries)
+			idx -= vq->vq_nentries;
+
+		len = desc[idx].len;
+		cookie = (struct rte_mbuf *)vq->vq_descx[desc[idx].id].cookie;
+		cookie->data_off = RTE_PKTMBUF_HEADROOM - hdr_size;
+		cookie->data_len = len;
+		cookie->pkt_len = len;
+		head->pkt_len += len;
+
+		prev->next = cookie;
+		prev = cookie;
+	}
+
+	if (hw->has_rx_offload)
+		virtio_vec_rx_offload(head, &hdr->hdr);
+
+	*rx_pkts = head;
+
+	rxvq->stats.bytes += head->pkt_len;
+
+	vq->vq_free_cnt += seg_num;
+	vq->vq_used_cons_idx += seg_num;
+	if (vq->vq_used_cons_idx >= vq->vq_nentries) {
+		vq->vq_used_cons_idx -= vq->vq_nentries;
+		vq->vq_packed.used_wrap_counter ^= 1;
+	}
+
+	return 0;
+}
+
 static inline void
 virtio_recv_refill_packed_vec(struct virtnet_rx *rxvq,
 			      struct rte_mbuf **cookie,
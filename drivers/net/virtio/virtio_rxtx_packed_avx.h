@@ -140,7 +140,8 @@ virtqueue_enqueue_batch_packed_vec(struct virtnet_tx *txvq,
 
 static inline uint16_t
 virtqueue_dequeue_batch_packed_vec(struct virtnet_rx *rxvq,
-				   struct rte_mbuf **rx_pkts)
+				   struct rte_mbuf **rx_pkts,
+				   bool mrg_rxbuf)
 {
 	struct virtqueue *vq = virtnet_rxq_to_vq(rxvq);
 	struct virtio_hw *hw = vq->hw;
@@ -183,6 +184,9 @@ virtqueue_dequeue_batch_packed_vec(struct virtnet_rx *rxvq,
 	if (desc_stats)
 		return -1;
 
+	if (mrg_rxbuf && virtqueue_batch_single_buffers_packed(vq, id))
+		return -1;
+
 	virtio_for_each_try_unroll(i, 0, PACKED_BATCH_SIZE) {
 		rx_pkts[i] = (struct rte_mbuf *)vq->vq_descx[id + i].cookie;
 		rte_packet_prefetch(rte_pktmbuf_mtod(rx_pkts[i], void *));
@@ -0,0 +1,229 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include <rte_net.h>
+#include <rte_vect.h>
+
+#include "virtio_logs.h"
+#include "virtio_ethdev.h"
+#include "virtio.h"
+#include "virtio_rxtx_packed.h"
+#include "virtqueue.h"
+
+/* only care refcnt and nb_segs in mbuf rearm data */
+#define REARM_REFCNT_SEGS_MASK (0xFFFFULL << REFCNT_BITS_OFFSET | \
+	0xFFFFULL << SEG_NUM_BITS_OFFSET)
+
+/* data_off bytes of the four rearm data in a 256bits register */
+#define REARM_DATA_OFF_BYTES 0x03030303
+
+static inline int
+virtqueue_enqueue_batch_packed_vec(struct virtnet_tx *txvq,
+				   struct rte_mbuf **tx_pkts)
+{
+	struct virtqueue *vq = virtnet_txq_to_vq(txvq);
+	uint16_t head_size = vq->hw->vtnet_hdr_size;
+	uint16_t idx = vq->vq_avail_idx;
+	struct virtio_net_hdr *hdr;
+	struct vq_desc_extra *dxp;
+	uint64_t flags_temp;
+	uint16_t i;
+
+	if (vq->vq_avail_idx & PACKED_BATCH_MASK)
+		return -1;
+
+	if (unlikely((idx + PACKED_BATCH_SIZE) > vq->vq_nentries))
+		return -1;
+
+	/* Load four mbufs rearm data */
+	RTE_BUILD_BUG_ON(REFCNT_BITS_OFFSET >= 64);
+	RTE_BUILD_BUG_ON(SEG_NUM_BITS_OFFSET >= 64);
+	__m256i mbufs = _mm256_set_epi64x(*tx_pkts[3]->rearm_data,
+					  *tx_pkts[2]->rearm_data,
+					  *tx_pkts[1]->rearm_data,
+					  *tx_pkts[0]->rearm_data);
+
+	/* refcnt=1 and nb_segs=1 */
+	__m256i mbuf_ref = _mm256_set1_epi64x(DEFAULT_REARM_DATA);
+	__m256i mbuf_mask = _mm256_set1_epi64x(REARM_REFCNT_SEGS_MASK);
+	__m256i head_rooms = _mm256_set1_epi16(head_size);
+
+	/* Check refcnt and nb_segs */
+	__m256i v_cmp = _mm256_cmpeq_epi64(_mm256_and_si256(mbufs, mbuf_mask),
+					   mbuf_ref);
+	if (unlikely(_mm256_movemask_epi8(v_cmp) != -1))
+		return -1;
+
+	/* Check headroom is enough */
+	RTE_BUILD_BUG_ON(offsetof(struct rte_mbuf, data_off) !=
+		offsetof(struct rte_mbuf, rearm_data));
+	v_cmp = _mm256_cmpeq_epi16(_mm256_max_epu16(mbufs, head_rooms), mbufs);
+	if (unlikely((_mm256_movemask_epi8(v_cmp) & REARM_DATA_OFF_BYTES) !=
+		     REARM_DATA_OFF_BYTES))
+		return -1;
+
+	virtio_for_each_try_unroll(i, 0, PACKED_BATCH_SIZE) {
+		dxp = &vq->vq_descx[idx + i];
+		dxp->ndescs = 1;
+		dxp->cookie = tx_pkts[i];
+	}
+
+	virtio_for_each_try_unroll(i, 0, PACKED_BATCH_SIZE) {
+		tx_pkts[i]->data_off -= head_size;
+		tx_pkts[i]->data_len += head_size;
+	}
+
+	/* desc higher 64bits: len, id and flags */
+	flags_temp = (uint64_t)vq->vq_packed.cached_flags << FLAGS_BITS_OFFSET;
+	__m256i v_desc0 = _mm256_set_epi64x(tx_pkts[1]->data_len |
+			(uint64_t)(idx + 1) << ID_BITS_OFFSET | flags_temp,
+			tx_pkts[1]->buf_iova + tx_pkts[1]->data_off,
+			tx_pkts[0]->data_len |
+			(uint64_t)idx << ID_BITS_OFFSET | flags_temp,
+			tx_pkts[0]->buf_iova + tx_pkts[0]->data_off);
+	__m256i v_desc1 = _mm256_set_epi64x(tx_pkts[3]->data_len |
+			(uint64_t)(idx + 3) << ID_BITS_OFFSET | flags_temp,
+			tx_pkts[3]->buf_iova + tx_pkts[3]->data_off,
+			tx_pkts[2]->data_len |
+			(uint64_t)(idx + 2) << ID_BITS_OFFSET | flags_temp,
+			tx_pkts[2]->buf_iova + tx_pkts[2]->data_off);
+
+	if (!vq->hw->has_tx_offload) {
+		/* the short net header is the first 12 bytes */
+		__m128i hdr_mask = _mm_set_epi32(0, -1, -1, -1);
+		virtio_for_each_try_unroll(i, 0, PACKED_BATCH_SIZE) {
+			hdr = rte_pktmbuf_mtod_offset(tx_pkts[i],
+					struct virtio_net_hdr *, -head_size);
+			__m128i v_hdr = _mm_loadu_si128((void *)hdr);
+			if (unlikely(!_mm_testz_si128(v_hdr, hdr_mask))) {
+				__m128i all_zero = _mm_setzero_si128();
+				_mm_maskstore_epi32((void *)hdr, hdr_mask,
+						all_zero);
+			}
+		}
+	} else {
+		virtio_for_each_try_unroll(i, 0, PACKED_BATCH_SIZE) {
+			hdr = rte_pktmbuf_mtod_offset(tx_pkts[i],
+					struct virtio_net_hdr *, -head_size);
+			virtqueue_xmit_offload(hdr, tx_pkts[i]);
+		}
+	}
+
+	/* Enqueue Packet buffers */
+	_mm256_storeu_si256((void *)&vq->vq_packed.ring.desc[idx], v_desc0);
+	_mm256_storeu_si256((void *)&vq->vq_packed.ring.desc[idx + 2],
+			    v_desc1);
+
+	virtio_update_batch_stats(&txvq->stats, tx_pkts[0]->pkt_len,
+			tx_pkts[1]->pkt_len, tx_pkts[2]->pkt_len,
+			tx_pkts[3]->pkt_len);
+
+	vq->vq_avail_idx += PACKED_BATCH_SIZE;
+	vq->vq_free_cnt -= PACKED_BATCH_SIZE;
+
+	if (vq->vq_avail_idx >= vq->vq_nentries) {
+		vq->vq_avail_idx -= vq->vq_nentries;
+		vq->vq_packed.cached_flags ^=
+			VRING_PACKED_DESC_F_AVAIL_USED;
+	}
+
+	return 0;
+}
+
+static inline uint16_t
+virtqueue_dequeue_batch_packed_vec(struct virtnet_rx *rxvq,
+				   struct rte_mbuf **rx_pkts,
+				   bool mrg_rxbuf)
+{
+	struct virtqueue *vq = virtnet_rxq_to_vq(rxvq);
+	struct virtio_hw *hw = vq->hw;
+	uint16_t hdr_size = hw->vtnet_hdr_size;
+	uint32_t lens[PACKED_BATCH_SIZE];
+	uint16_t id = vq->vq_used_cons_idx;
+	struct vring_packed_desc *desc_addr;
+	uint16_t i;
+
+	if (id & PACKED_BATCH_MASK)
+		return -1;
+
+	if (unlikely((id + PACKED_BATCH_SIZE) > vq->vq_nentries))
+		return -1;
+
+	/* only care avail/used bits */
+	__m256i v_mask = _mm256_set_epi64x(PACKED_FLAGS_MASK, 0x0,
+					   PACKED_FLAGS_MASK, 0x0);
+	desc_addr = &vq->vq_packed.ring.desc[id];
+
+	__m256i v_desc0 = _mm256_loadu_si256((void *)desc_addr);
+	__m256i v_desc1 = _mm256_loadu_si256((void *)(desc_addr + 2));
+	__m256i v_flag0 = _mm256_and_si256(v_desc0, v_mask);
+	__m256i v_flag1 = _mm256_and_si256(v_desc1, v_mask);
+
+	__m256i v_used_flag = _mm256_setzero_si256();
+	if (vq->vq_packed.used_wrap_counter)
+		v_used_flag = v_mask;
+
+	/* Check all descs are used */
+	__m256i v_cmp = _mm256_and_si256(
+			_mm256_cmpeq_epi64(v_flag0, v_used_flag),
+			_mm256_cmpeq_epi64(v_flag1, v_used_flag));
+	if (_mm256_movemask_epi8(v_cmp) != -1)
+		return -1;
+
+	if (mrg_rxbuf && virtqueue_batch_single_buffers_packed(vq, id))
+		return -1;
+
+	/* len is the third 32bits of each desc */
+	lens[0] = _mm256_extract_epi32(v_desc0, 2);
+	lens[1] = _mm256_extract_epi32(v_desc0, 6);
+	lens[2] = _mm256_extract_epi32(v_desc1, 2);
+	lens[3] = _mm256_extract_epi32(v_desc1, 6);
+
+	/* assert offset of data_len */
+	RTE_BUILD_BUG_ON(offsetof(struct rte_mbuf, data_len) !=
+		offsetof(struct rte_mbuf, rx_descriptor_fields1) + 8);
+
+	virtio_for_each_try_unroll(i, 0, PACKED_BATCH_SIZE) {
+		rx_pkts[i] = (struct rte_mbuf *)vq->vq_descx[id + i].cookie;
+		rte_packet_prefetch(rte_pktmbuf_mtod(rx_pkts[i], void *));
+
+		/*
+		 * store len into mbuf pkt_len and data_len, len limited by
+		 * 16bit buf_len, packet type, vlan and hash are cleared
+		 */
+		__m128i v_value = _mm_set_epi32(0, lens[i] - hdr_size,
+						lens[i] - hdr_size, 0);
+		_mm_storeu_si128((void *)rx_pkts[i]->rx_descriptor_fields1,
+				 v_value);
+	}
+
+	if (hw->has_rx_offload) {
+		virtio_for_each_try_unroll(i, 0, PACKED_BATCH_SIZE) {
+			char *addr = (char *)rx_pkts[i]->buf_addr +
+				RTE_PKTMBUF_HEADROOM - hdr_size;
+			virtio_vec_rx_offload(rx_pkts[i],
+					(struct virtio_net_hdr *)addr);
+		}
+	}
+
+	virtio_update_batch_stats(&rxvq->stats, rx_pkts[0]->pkt_len,
+			rx_pkts[1]->pkt_len, rx_pkts[2]->pkt_len,
+			rx_pkts[3]->pkt_len);
+
+	vq->vq_free_cnt += PACKED_BATCH_SIZE;
+
+	vq->vq_used_cons_idx += PACKED_BATCH_SIZE;
+	if (vq->vq_used_cons_idx >= vq->vq_nentries) {
+		vq->vq_used_cons_idx -= vq->vq_nentries;
+		vq->vq_packed.used_wrap_counter ^= 1;
+	}
+
+	return 0;
+}
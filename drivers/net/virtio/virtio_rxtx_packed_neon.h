@@ -161,7 +161,8 @@ virtqueue_enqueue_batch_packed_vec(struct virtnet_tx *txvq,
 
 static inline int
 virtqueue_dequeue_batch_packed_vec(struct virtnet_rx *rxvq,
-				   struct rte_mbuf **rx_pkts)
+				   struct rte_mbuf **rx_pkts,
+				   bool mrg_rxbuf)
 {
 	struct virtqueue *vq = virtnet_rxq_to_vq(rxvq);
 	struct virtio_hw *hw = vq->hw;
@@ -231,6 +232,9 @@ virtqueue_dequeue_batch_packed_vec(struct virtnet_rx *rxvq,
 	if (unlikely(vgetq_lane_u64(desc_stats, 0) || vgetq_lane_u64(desc_stats, 1)))
 		return -1;
 
+	if (mrg_rxbuf && virtqueue_batch_single_buffers_packed(vq, id))
+		return -1;
+
 	/* Load 2 mbuf pointers per time. */
 	mbp[0] = vld2q_u64((uint64_t *)&vq->vq_descx[id]);
 	vst1q_u64((uint64_t *)&rx_pkts[0], mbp[0].val[0]);
@@ -193,6 +193,11 @@ uint16_t vmxnet3_xmit_pkts(void *tx_queue, struct rte_mbuf **tx_pkts,
 			   uint16_t nb_pkts);
 uint16_t vmxnet3_prep_pkts(void *tx_queue, struct rte_mbuf **tx_pkts,
 			uint16_t nb_pkts);
+uint16_t vmxnet3_recv_pkts_simple(void *rx_queue, struct rte_mbuf **rx_pkts,
+				  uint16_t nb_pkts);
+uint16_t vmxnet3_xmit_pkts_simple(void *tx_queue, struct rte_mbuf **tx_pkts,
+				  uint16_t nb_pkts);
+void vmxnet3_set_rxtx_functions(struct rte_eth_dev *dev);
 
 #define VMXNET3_SEGS_DYNFIELD_NAME "rte_net_vmxnet3_dynfield_segs"
 typedef uint8_t vmxnet3_segs_dynfield_t;
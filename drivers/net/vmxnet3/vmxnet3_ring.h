@@ -146,6 +146,8 @@ typedef struct vmxnet3_rx_queue {
 	Vmxnet3_RxQueueDesc         *shared;
 	struct rte_mbuf             *start_seg;
 	struct rte_mbuf             *last_seg;
+	/* value of the mbuf rearm data for the simple Rx path */
+	uint64_t                    mbuf_initializer;
 	struct vmxnet3_rxq_stats    stats;
 	const struct rte_memzone    *mz;
 	bool                        stopped;
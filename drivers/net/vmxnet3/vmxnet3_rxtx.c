@@ -58,6 +58,31 @@
 #define	VMXNET3_TX_OFFLOAD_NOTSUP_MASK	\
 	(PKT_TX_OFFLOAD_MASK ^ VMXNET3_TX_OFFLOAD_MASK)
 
+/* Port offloads not handled by the simple Rx and Tx paths */
+#define VMXNET3_RX_SIMPLE_NOTSUP_OFFLOADS \
+	(DEV_RX_OFFLOAD_TCP_LRO | DEV_RX_OFFLOAD_SCATTER)
+#define VMXNET3_TX_SIMPLE_NOTSUP_OFFLOADS \
+	(DEV_TX_OFFLOAD_VLAN_INSERT | DEV_TX_OFFLOAD_TCP_CKSUM | \
+	 DEV_TX_OFFLOAD_UDP_CKSUM | DEV_TX_OFFLOAD_TCP_TSO | \
+	 DEV_TX_OFFLOAD_MULTI_SEGS)
+
+/* Max number of packets processed at once by the simple Rx path */
+#define VMXNET3_RX_SIMPLE_BURST	32
+/* Max number of mbufs freed at once by the simple Tx path */
+#define VMXNET3_TX_FREE_BULK	64
+
+/* Rx offload flags and packet type, indexed by the completion bits */
+struct vmxnet3_rx_ol {
+	uint64_t ol_flags;
+	uint32_t packet_type;
+};
+
+#define VMXNET3_RX_OL_IDX(rcd) \
+	((rcd)->tuc | (rcd)->udp << 1 | (rcd)->tcp << 2 | (rcd)->ipc << 3 | \
+	 (rcd)->v6 << 4 | (rcd)->v4 << 5 | (rcd)->cnc << 6)
+
+static struct vmxnet3_rx_ol vmxnet3_rx_ol_tbl[1 << 7];
+
 static const uint32_t rxprod_reg[2] = {VMXNET3_REG_RXPROD, VMXNET3_REG_RXPROD2};
 
 static int vmxnet3_post_rx_bufs(vmxnet3_rx_queue_t*, uint8_t);
@@ -582,6 +607,140 @@ vmxnet3_xmit_pkts(void *tx_queue, struct rte_mbuf **tx_pkts,
 	return nb_tx;
 }
 
+/*
+ * Free the mbufs of all the descriptors up to the ones completed by the
+ * device. The simple Tx path requests a completion for the last packet of
+ * a burst only, so a completion covers several packets.
+ */
+static void
+vmxnet3_tq_tx_complete_simple(vmxnet3_tx_queue_t *txq)
+{
+	struct rte_mbuf *free[VMXNET3_TX_FREE_BULK];
+	vmxnet3_cmd_ring_t *ring = &txq->cmd_ring;
+	vmxnet3_comp_ring_t *comp_ring = &txq->comp_ring;
+	struct Vmxnet3_TxCompDesc *tcd = (struct Vmxnet3_TxCompDesc *)
+		(comp_ring->base + comp_ring->next2proc);
+	unsigned int nb_free = 0;
+	uint32_t eop_idx, idx;
+
+	while (tcd->gen == comp_ring->gen) {
+		eop_idx = tcd->txdIdx;
+		do {
+			idx = ring->next2comp;
+			if (ring->buf_info[idx].m != NULL) {
+				free[nb_free++] = ring->buf_info[idx].m;
+				ring->buf_info[idx].m = NULL;
+				if (nb_free == RTE_DIM(free)) {
+					rte_pktmbuf_free_bulk(free, nb_free);
+					nb_free = 0;
+				}
+			}
+			vmxnet3_cmd_ring_adv_next2comp(ring);
+		} while (idx != eop_idx);
+
+		vmxnet3_comp_ring_adv_next2proc(comp_ring);
+		tcd = (struct Vmxnet3_TxCompDesc *)(comp_ring->base +
+						    comp_ring->next2proc);
+	}
+
+	if (nb_free != 0)
+		rte_pktmbuf_free_bulk(free, nb_free);
+}
+
+/*
+ * Transmit path for single segment packets without offloads.
+ * The descriptors of the whole burst are written before ownership of the
+ * first one is given to the device, a single completion is requested for
+ * the burst and the deferred packet count is updated once.
+ */
+uint16_t
+vmxnet3_xmit_pkts_simple(void *tx_queue, struct rte_mbuf **tx_pkts,
+			 uint16_t nb_pkts)
+{
+	vmxnet3_tx_queue_t *txq = tx_queue;
+	struct vmxnet3_hw *hw = txq->hw;
+	vmxnet3_cmd_ring_t *ring = &txq->cmd_ring;
+	Vmxnet3_TxQueueCtrl *txq_ctrl = &txq->shared->ctrl;
+	uint32_t deferred = rte_le_to_cpu_32(txq_ctrl->txNumDeferred);
+	Vmxnet3_GenericDesc *gdesc, *first = NULL, *last = NULL;
+	uint16_t nb_tx, nb_avail;
+	uint32_t dw2, len, nb_desc = 0;
+
+	if (unlikely(txq->stopped)) {
+		PMD_TX_LOG(DEBUG, "Tx queue is stopped.");
+		return 0;
+	}
+
+	vmxnet3_tq_tx_complete_simple(txq);
+
+	nb_avail = RTE_MIN(vmxnet3_cmd_ring_desc_avail(ring),
+			   (uint32_t)nb_pkts);
+	if (unlikely(nb_avail < nb_pkts)) {
+		PMD_TX_LOG(DEBUG, "No free ring descriptors");
+		txq->stats.tx_ring_full++;
+		txq->stats.drop_total += nb_pkts - nb_avail;
+	}
+
+	/* use the previous gen bit for the first desc */
+	dw2 = (ring->gen ^ 0x1) << VMXNET3_TXD_GEN_SHIFT;
+	for (nb_tx = 0; nb_tx < nb_avail; nb_tx++) {
+		struct rte_mbuf *txm = tx_pkts[nb_tx];
+
+		len = rte_pktmbuf_data_len(txm);
+		/* Skip empty packets, a zero length means 16K to the device */
+		if (unlikely(len == 0)) {
+			txq->stats.drop_total++;
+			rte_pktmbuf_free_seg(txm);
+			continue;
+		}
+
+		gdesc = ring->base + ring->next2fill;
+		if (len <= txq->txdata_desc_size) {
+			uint64_t offset = (uint64_t)ring->next2fill *
+				txq->txdata_desc_size;
+
+			rte_memcpy((uint8_t *)txq->data_ring.base + offset,
+				   rte_pktmbuf_mtod(txm, char *), len);
+			gdesc->txd.addr =
+				rte_cpu_to_le_64(txq->data_ring.basePA + offset);
+		} else {
+			gdesc->txd.addr = rte_mbuf_data_iova(txm);
+		}
+		gdesc->dword[2] = dw2 | len;
+		gdesc->dword[3] = VMXNET3_TXD_EOP;
+		ring->buf_info[ring->next2fill].m = txm;
+
+		if (first == NULL)
+			first = gdesc;
+		last = gdesc;
+		nb_desc++;
+		vmxnet3_cmd_ring_adv_next2fill(ring);
+		/* use the right gen for the next desc */
+		dw2 = ring->gen << VMXNET3_TXD_GEN_SHIFT;
+	}
+
+	if (unlikely(first == NULL))
+		return nb_tx;
+
+	last->dword[3] |= VMXNET3_TXD_CQ;
+	deferred += nb_desc;
+
+	/* flip the GEN bit on the first desc to hand the burst over */
+	rte_compiler_barrier();
+	first->dword[2] ^= VMXNET3_TXD_GEN;
+
+	if (deferred >= rte_le_to_cpu_32(txq_ctrl->txThreshold)) {
+		txq_ctrl->txNumDeferred = 0;
+		/* Notify vSwitch that packets are available. */
+		VMXNET3_WRITE_BAR0_REG(hw, (VMXNET3_REG_TXPROD + txq->queue_id * VMXNET3_REG_ALIGN),
+				       ring->next2fill);
+	} else {
+		txq_ctrl->txNumDeferred = rte_cpu_to_le_32(deferred);
+	}
+
+	return nb_tx;
+}
+
 static inline void
 vmxnet3_renew_desc(vmxnet3_rx_queue_t *rxq, uint8_t ring_id,
 		   struct rte_mbuf *mbuf)
@@ -814,6 +973,36 @@ vmxnet3_rx_offload(struct vmxnet3_hw *hw, const Vmxnet3_RxCompDesc *rcd,
 	rxm->packet_type = packet_type;
 }
 
+/*
+ * Fill the offload table of the simple Rx path with the result of the
+ * regular path for every combination of the completion bits.
+ */
+RTE_INIT(vmxnet3_rx_ol_tbl_init)
+{
+	Vmxnet3_GenericDesc gdesc;
+	struct rte_mbuf m;
+	unsigned int i;
+
+	for (i = 0; i < RTE_DIM(vmxnet3_rx_ol_tbl); i++) {
+		memset(&gdesc, 0, sizeof(gdesc));
+		gdesc.rcd.tuc = !!(i & (1 << 0));
+		gdesc.rcd.udp = !!(i & (1 << 1));
+		gdesc.rcd.tcp = !!(i & (1 << 2));
+		gdesc.rcd.ipc = !!(i & (1 << 3));
+		gdesc.rcd.v6 = !!(i & (1 << 4));
+		gdesc.rcd.v4 = !!(i & (1 << 5));
+		gdesc.rcd.cnc = !!(i & (1 << 6));
+		RTE_ASSERT(VMXNET3_RX_OL_IDX(&gdesc.rcd) == i);
+
+		m.ol_flags = 0;
+		m.packet_type = RTE_PTYPE_L2_ETHER;
+		/* hw is only used for LRO, which is never set here */
+		vmxnet3_rx_offload(NULL, &gdesc.rcd, &m, 0);
+		vmxnet3_rx_ol_tbl[i].ol_flags = m.ol_flags;
+		vmxnet3_rx_ol_tbl[i].packet_type = m.packet_type;
+	}
+}
+
 /*
  * Process the Rx Completion Ring of given vmxnet3_rx_queue
  * for nb_pkts burst and return the number of packets received
@@ -1017,6 +1206,133 @@ vmxnet3_recv_pkts(void *rx_queue, struct rte_mbuf **rx_pkts, uint16_t nb_pkts)
 	return nb_rx;
 }
 
+/* Whether a completion is a whole packet in a single ring 0 buffer. */
+static inline bool
+vmxnet3_rcd_simple(struct vmxnet3_hw *hw, const Vmxnet3_RxCompDesc *rcd)
+{
+	return rcd->sop && rcd->eop && !rcd->err && rcd->len != 0 &&
+		rcd->type == VMXNET3_CDTYPE_RXCOMP &&
+		vmxnet3_get_ring_idx(hw, rcd->rqID) == 0;
+}
+
+/*
+ * Receive path for packets fitting in a single buffer, LRO disabled.
+ * The ready completions are gathered first, their replacement buffers are
+ * allocated in bulk, the offloads are looked up in a table and the producer
+ * index is written once per burst. Any other kind of completion is left to
+ * vmxnet3_recv_pkts().
+ */
+uint16_t
+vmxnet3_recv_pkts_simple(void *rx_queue, struct rte_mbuf **rx_pkts,
+			 uint16_t nb_pkts)
+{
+	vmxnet3_rx_queue_t *rxq = rx_queue;
+	struct vmxnet3_hw *hw = rxq->hw;
+	vmxnet3_comp_ring_t *comp_ring = &rxq->comp_ring;
+	struct vmxnet3_cmd_ring *ring = &rxq->cmd_ring[0];
+	Vmxnet3_RxCompDesc *rcds[VMXNET3_RX_SIMPLE_BURST];
+	struct rte_mbuf *newm[VMXNET3_RX_SIMPLE_BURST];
+	uint16_t nb_rx = 0;
+	uint16_t n, i;
+
+	if (unlikely(rxq->stopped)) {
+		PMD_RX_LOG(DEBUG, "Rx queue is stopped.");
+		return 0;
+	}
+
+	while (nb_rx < nb_pkts) {
+		uint32_t next2proc = comp_ring->next2proc;
+		uint8_t gen = comp_ring->gen;
+		uint16_t burst = RTE_MIN(nb_pkts - nb_rx,
+					 VMXNET3_RX_SIMPLE_BURST);
+
+		for (n = 0; n < burst; n++) {
+			Vmxnet3_RxCompDesc *rcd =
+				&comp_ring->base[next2proc].rcd;
+
+			if (rcd->gen != gen || !vmxnet3_rcd_simple(hw, rcd))
+				break;
+			rcds[n] = rcd;
+			if (unlikely(++next2proc == comp_ring->size)) {
+				next2proc = 0;
+				gen ^= 1;
+			}
+		}
+		if (n == 0)
+			break;
+
+		if (unlikely(rte_mempool_get_bulk(rxq->mp, (void **)newm,
+						  n) != 0)) {
+			PMD_RX_LOG(ERR, "Error allocating mbuf");
+			rxq->stats.rx_buf_alloc_failure++;
+			break;
+		}
+
+		for (i = 0; i < n; i++) {
+			const Vmxnet3_RxCompDesc *rcd = rcds[i];
+			const struct vmxnet3_rx_ol *ol =
+				&vmxnet3_rx_ol_tbl[VMXNET3_RX_OL_IDX(rcd)];
+			uint32_t idx = rcd->rxdIdx;
+			vmxnet3_buf_info_t *rbi = ring->buf_info + idx;
+			struct rte_mbuf *rxm = rbi->m;
+			uint64_t ol_flags = ol->ol_flags;
+
+			RTE_ASSERT(rxm != NULL);
+			rbi->m = NULL;
+			rbi->bufPA = 0;
+
+			*(uint64_t *)&rxm->rearm_data = rxq->mbuf_initializer;
+			rxm->pkt_len = rcd->len;
+			rxm->data_len = rcd->len;
+			rxm->packet_type = ol->packet_type;
+			rxm->vlan_tci = 0;
+			if (rcd->rssType != VMXNET3_RCD_RSS_TYPE_NONE) {
+				ol_flags |= PKT_RX_RSS_HASH;
+				rxm->hash.rss = rcd->rssHash;
+			}
+			if (rcd->ts) {
+				ol_flags |= PKT_RX_VLAN | PKT_RX_VLAN_STRIPPED;
+				rxm->vlan_tci =
+					rte_le_to_cpu_16((uint16_t)rcd->tci);
+			}
+			rxm->ol_flags = ol_flags;
+
+			if (vmxnet3_rx_data_ring(hw, rcd->rqID)) {
+				RTE_ASSERT(VMXNET3_VERSION_GE_3(hw));
+				rte_memcpy(rte_pktmbuf_mtod(rxm, char *),
+					   rxq->data_ring.base +
+					   idx * rxq->data_desc_size,
+					   rcd->len);
+			}
+			rx_pkts[nb_rx++] = rxm;
+
+			ring->next2comp = idx;
+			VMXNET3_INC_RING_IDX_ONLY(ring->next2comp, ring->size);
+			vmxnet3_renew_desc(rxq, 0, newm[i]);
+		}
+
+		comp_ring->next2proc = next2proc;
+		comp_ring->gen = gen;
+
+		if (unlikely(rxq->shared->ctrl.updateRxProd)) {
+			VMXNET3_WRITE_BAR0_REG(hw, rxprod_reg[0] + (rxq->queue_id * VMXNET3_REG_ALIGN),
+					       ring->next2fill);
+		}
+
+		if (n < burst)
+			break;
+	}
+
+	/*
+	 * Other completions, and the refill of the rings when nothing was
+	 * received, go through the regular path.
+	 */
+	if (nb_rx == 0)
+		return vmxnet3_recv_pkts(rx_queue, rx_pkts, nb_pkts);
+
+	return nb_rx;
+}
+
 int
 vmxnet3_dev_tx_queue_setup(struct rte_eth_dev *dev,
 			   uint16_t queue_idx,
@@ -1116,6 +1432,19 @@ vmxnet3_dev_tx_queue_setup(struct rte_eth_dev *dev,
 	return 0;
 }
 
+static uint64_t
+vmxnet3_rxq_mbuf_initializer(const vmxnet3_rx_queue_t *rxq)
+{
+	struct rte_mbuf mb_def = { .buf_addr = 0 }; /* zeroed mbuf */
+
+	mb_def.nb_segs = 1;
+	mb_def.data_off = RTE_PKTMBUF_HEADROOM;
+	mb_def.port = rxq->port_id;
+	rte_mbuf_refcnt_set(&mb_def, 1);
+
+	return *(uint64_t *)&mb_def.rearm_data;
+}
+
 int
 vmxnet3_dev_rx_queue_setup(struct rte_eth_dev *dev,
 			   uint16_t queue_idx,
@@ -1153,6 +1482,7 @@ vmxnet3_dev_rx_queue_setup(struct rte_eth_dev *dev,
 	rxq->data_ring_qid = queue_idx + 2 * hw->num_rx_queues;
 	rxq->data_desc_size = hw->rxdata_desc_size;
 	rxq->stopped = TRUE;
+	rxq->mbuf_initializer = vmxnet3_rxq_mbuf_initializer(rxq);
 
 	ring0 = &rxq->cmd_ring[0];
 	ring1 = &rxq->cmd_ring[1];
@@ -1290,6 +1620,31 @@ vmxnet3_dev_rxtx_init(struct rte_eth_dev *dev)
 	return 0;
 }
 
+/*
+ * Select the simple Rx and Tx paths when the configured offloads allow it.
+ */
+void
+vmxnet3_set_rxtx_functions(struct rte_eth_dev *dev)
+{
+	const struct rte_eth_conf *conf = &dev->data->dev_conf;
+
+	if (conf->rxmode.offloads & VMXNET3_RX_SIMPLE_NOTSUP_OFFLOADS) {
+		dev->rx_pkt_burst = vmxnet3_recv_pkts;
+	} else {
+		PMD_INIT_LOG(DEBUG, "Using simple Rx path, port %u",
+			     dev->data->port_id);
+		dev->rx_pkt_burst = vmxnet3_recv_pkts_simple;
+	}
+
+	if (conf->txmode.offloads & VMXNET3_TX_SIMPLE_NOTSUP_OFFLOADS) {
+		dev->tx_pkt_burst = vmxnet3_xmit_pkts;
+	} else {
+		PMD_INIT_LOG(DEBUG, "Using simple Tx path, port %u",
+			     dev->data->port_id);
+		dev->tx_pkt_burst = vmxnet3_xmit_pkts_simple;
+	}
+}
+
 static uint8_t rss_intel_key[40] = {
 	0x6D, 0x5A, 0x56, 0xDA, 0x25, 0x5B, 0x0E, 0xC2,
 	0x41, 0x67, 0x25, 0x3D, 0x43, 0xA3, 0x8F, 0xB0,
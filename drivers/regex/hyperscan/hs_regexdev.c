@@ -0,0 +1,627 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <ctype.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include <rte_bitops.h>
+#include <rte_common.h>
+#include <rte_malloc.h>
+#include <rte_bus_vdev.h>
+#include <rte_regexdev.h>
+#include <rte_regexdev_core.h>
+#include <rte_regexdev_driver.h>
+
+#include "hs_regexdev.h"
+
+/*
+ * Rule database exported by the PMD: the header, then for each group the
+ * length of its serialized Hyperscan database, 0 if none, and its content.
+ */
+#define HS_REGEX_DB_MAGIC 0x48534442 /* "HSDB" */
+
+struct hs_regex_db_hdr {
+	uint32_t magic;
+	uint32_t cfg_flags;
+	uint16_t nb_groups;
+	uint16_t reserved;
+};
+
+#define HS_REGEX_RULE_FLAGS (RTE_REGEX_PCRE_RULE_ALLOW_EMPTY_F | \
+		RTE_REGEX_PCRE_RULE_ANCHORED_F | \
+		RTE_REGEX_PCRE_RULE_CASELESS_F | \
+		RTE_REGEX_PCRE_RULE_DOTALL_F | \
+		RTE_REGEX_PCRE_RULE_MULTILINE_F | \
+		RTE_REGEX_PCRE_RULE_UCP_F | \
+		RTE_REGEX_PCRE_RULE_UTF_F)
+
+static int
+hs_regex_info_get(struct rte_regexdev *dev, struct rte_regexdev_info *info)
+{
+	info->driver_name = RTE_STR(HS_REGEX_PMD_NAME);
+	info->dev = dev->device;
+	info->max_matches = HS_REGEX_MAX_MATCHES;
+	info->max_queue_pairs = HS_REGEX_MAX_QPS;
+	info->max_payload_size = HS_REGEX_MAX_PAYLOAD;
+	info->max_rules_per_group = HS_REGEX_MAX_RULES_PER_GROUP;
+	info->max_groups = HS_REGEX_MAX_GROUPS;
+	info->regexdev_capa = RTE_REGEXDEV_CAPA_RUNTIME_COMPILATION_F |
+			RTE_REGEXDEV_CAPA_SUPP_PCRE_START_ANCHOR_F |
+			RTE_REGEXDEV_SUPP_PCRE_GREEDY_F |
+			RTE_REGEXDEV_SUPP_PCRE_UTF_8_F |
+			RTE_REGEXDEV_SUPP_PCRE_WORD_BOUNDARY_F |
+			RTE_REGEXDEV_SUPP_MATCH_AS_END_F |
+			RTE_REGEXDEV_SUPP_MATCH_ALL_F;
+	info->rule_flags = HS_REGEX_RULE_FLAGS;
+
+	return 0;
+}
+
+static void
+hs_regex_dbs_free(hs_database_t **dbs, uint16_t nb_groups)
+{
+	uint16_t i;
+
+	if (dbs == NULL)
+		return;
+	for (i = 0; i < nb_groups; i++)
+		hs_free_database(dbs[i]);
+	rte_free(dbs);
+}
+
+static void
+hs_regex_rules_free(struct hs_regex_priv *priv)
+{
+	uint32_t i;
+
+	for (i = 0; i < priv->nb_rules; i++)
+		rte_free(priv->rules[i].expr);
+	rte_free(priv->rules);
+	priv->rules = NULL;
+	priv->nb_rules = 0;
+}
+
+static void
+hs_regex_qps_free(struct hs_regex_priv *priv)
+{
+	uint16_t i;
+
+	if (priv->qps == NULL)
+		return;
+	for (i = 0; i < priv->nb_qps; i++) {
+		rte_ring_free(priv->qps[i].done);
+		hs_free_scratch(priv->qps[i].scratch);
+	}
+	rte_free(priv->qps);
+	priv->qps = NULL;
+	priv->nb_qps = 0;
+}
+
+/*
+ * Replace the active databases, whose groups are the configured ones.
+ * The device must be stopped.
+ */
+static void
+hs_regex_dbs_set(struct hs_regex_priv *priv, hs_database_t **dbs)
+{
+	hs_regex_dbs_free(priv->dbs, priv->nb_groups);
+	priv->dbs = dbs;
+}
+
+/* Compile the rules of each group, in vectored mode for the mbuf chains. */
+static int
+hs_regex_compile(struct hs_regex_priv *priv)
+{
+	const char **exprs = NULL;
+	unsigned int *flags = NULL;
+	unsigned int *ids = NULL;
+	hs_compile_error_t *err;
+	hs_database_t **dbs;
+	unsigned int nb;
+	uint32_t i;
+	uint16_t g;
+	int ret = 0;
+
+	dbs = rte_zmalloc(NULL, priv->nb_groups * sizeof(*dbs), 0);
+	if (priv->nb_rules != 0) {
+		exprs = malloc(priv->nb_rules * sizeof(*exprs));
+		flags = malloc(priv->nb_rules * sizeof(*flags));
+		ids = malloc(priv->nb_rules * sizeof(*ids));
+	}
+	if (dbs == NULL || (priv->nb_rules != 0 &&
+			(exprs == NULL || flags == NULL || ids == NULL))) {
+		ret = -ENOMEM;
+		goto out;
+	}
+
+	for (g = 0; g < priv->nb_groups; g++) {
+		nb = 0;
+		for (i = 0; i < priv->nb_rules; i++) {
+			if (priv->rules[i].group_id != g)
+				continue;
+			exprs[nb] = priv->rules[i].expr;
+			flags[nb] = priv->rules[i].hs_flags;
+			/* The start of match is only tracked when reported. */
+			if (!(priv->cfg_flags & RTE_REGEXDEV_CFG_MATCH_AS_END_F))
+				flags[nb] |= HS_FLAG_SOM_LEFTMOST;
+			ids[nb++] = priv->rules[i].rule_id;
+		}
+		if (nb == 0)
+			continue;
+		if (hs_compile_multi(exprs, flags, ids, nb, HS_MODE_VECTORED,
+				NULL, &dbs[g], &err) != HS_SUCCESS) {
+			HS_REGEX_LOG(ERR, "group %u rule %u: %s", g,
+				err->expression >= 0 ?
+				ids[err->expression] : 0, err->message);
+			hs_free_compile_error(err);
+			ret = -EINVAL;
+			goto out;
+		}
+	}
+
+out:
+	free(exprs);
+	free(flags);
+	free(ids);
+	if (ret != 0) {
+		hs_regex_dbs_free(dbs, priv->nb_groups);
+		return ret;
+	}
+	hs_regex_dbs_set(priv, dbs);
+	return 0;
+}
+
+/* Convert the rule flags, return -1 if some are not supported. */
+static int
+hs_regex_rule_flags(uint64_t rule_flags, unsigned int *hs_flags)
+{
+	if (rule_flags & ~HS_REGEX_RULE_FLAGS)
+		return -1;
+
+	*hs_flags = 0;
+	if (rule_flags & RTE_REGEX_PCRE_RULE_ALLOW_EMPTY_F)
+		*hs_flags |= HS_FLAG_ALLOWEMPTY;
+	if (rule_flags & RTE_REGEX_PCRE_RULE_CASELESS_F)
+		*hs_flags |= HS_FLAG_CASELESS;
+	if (rule_flags & RTE_REGEX_PCRE_RULE_DOTALL_F)
+		*hs_flags |= HS_FLAG_DOTALL;
+	if (rule_flags & RTE_REGEX_PCRE_RULE_MULTILINE_F)
+		*hs_flags |= HS_FLAG_MULTILINE;
+	if (rule_flags & RTE_REGEX_PCRE_RULE_UCP_F)
+		*hs_flags |= HS_FLAG_UCP;
+	if (rule_flags & RTE_REGEX_PCRE_RULE_UTF_F)
+		*hs_flags |= HS_FLAG_UTF8;
+	return 0;
+}
+
+static int
+hs_regex_rule_add(struct hs_regex_priv *priv,
+		const struct rte_regexdev_rule *rule)
+{
+	struct hs_regex_rule *r;
+	unsigned int hs_flags;
+	bool anchored;
+	size_t len;
+	char *expr;
+
+	if (hs_regex_rule_flags(rule->rule_flags, &hs_flags) != 0)
+		return -ENOTSUP;
+	/* Hyperscan has no anchored flag, the pattern is anchored instead. */
+	anchored = rule->rule_flags & RTE_REGEX_PCRE_RULE_ANCHORED_F;
+	len = rule->pcre_rule_len + (anchored ? sizeof("^(?:)") : 1);
+	expr = rte_malloc(NULL, len, 0);
+	if (expr == NULL)
+		return -ENOMEM;
+	snprintf(expr, len, anchored ? "^(?:%.*s)" : "%.*s",
+		 (int)rule->pcre_rule_len, rule->pcre_rule);
+
+	r = rte_realloc(priv->rules, (priv->nb_rules + 1) * sizeof(*r), 0);
+	if (r == NULL) {
+		rte_free(expr);
+		return -ENOMEM;
+	}
+	priv->rules = r;
+	r = &priv->rules[priv->nb_rules++];
+	r->rule_id = rule->rule_id;
+	r->group_id = rule->group_id;
+	r->hs_flags = hs_flags;
+	r->expr = expr;
+	return 0;
+}
+
+static void
+hs_regex_rule_remove(struct hs_regex_priv *priv,
+		const struct rte_regexdev_rule *rule)
+{
+	uint32_t i = 0;
+
+	while (i < priv->nb_rules) {
+		if (priv->rules[i].rule_id != rule->rule_id ||
+		    priv->rules[i].group_id != rule->group_id) {
+			i++;
+			continue;
+		}
+		rte_free(priv->rules[i].expr);
+		priv->rules[i] = priv->rules[--priv->nb_rules];
+	}
+}
+
+static int
+hs_regex_rule_db_update(struct rte_regexdev *dev,
+		const struct rte_regexdev_rule *rules, uint16_t nb_rules)
+{
+	struct hs_regex_priv *priv = dev->data->dev_private;
+	uint16_t i;
+
+	for (i = 0; i < nb_rules; i++) {
+		if (rules[i].group_id >= priv->nb_groups ||
+		    rules[i].rule_id >= RTE_BIT32(20))
+			break;
+		if (rules[i].op == RTE_REGEX_RULE_OP_REMOVE) {
+			hs_regex_rule_remove(priv, &rules[i]);
+			continue;
+		}
+		if (rules[i].pcre_rule == NULL ||
+		    hs_regex_rule_add(priv, &rules[i]) != 0)
+			break;
+	}
+	return i;
+}
+
+static int
+hs_regex_rule_db_compile_activate(struct rte_regexdev *dev)
+{
+	if (dev->data->dev_started)
+		return -EBUSY;
+	return hs_regex_compile(dev->data->dev_private);
+}
+
+/*
+ * Parse rules as text, one per line as "<rule_id>,<group_id>,<pcre>",
+ * ignoring the empty and comment lines, which replace the current rules.
+ */
+static int
+hs_regex_rules_parse(struct hs_regex_priv *priv, const char *db,
+		uint32_t len)
+{
+	struct rte_regexdev_rule rule;
+	const char *line, *eol, *end = db + len;
+	unsigned long rule_id, group_id;
+	char *next;
+	int ret;
+
+	hs_regex_rules_free(priv);
+	for (line = db; line < end && *line != '\0'; line = eol + 1) {
+		eol = memchr(line, '\n', end - line);
+		if (eol == NULL)
+			eol = end;
+		while (line < eol && isspace(*line))
+			line++;
+		if (line == eol || *line == '#')
+			continue;
+
+		rule_id = strtoul(line, &next, 0);
+		if (*next != ',')
+			goto invalid;
+		group_id = strtoul(next + 1, &next, 0);
+		if (*next != ',' || next + 1 >= eol)
+			goto invalid;
+		line = next + 1;
+		while (eol > line && isspace(eol[-1]))
+			eol--;
+
+		memset(&rule, 0, sizeof(rule));
+		rule.op = RTE_REGEX_RULE_OP_ADD;
+		rule.rule_id = rule_id;
+		rule.group_id = group_id;
+		rule.pcre_rule = line;
+		rule.pcre_rule_len = eol - line;
+		if (rule_id >= RTE_BIT32(20) || group_id >= priv->nb_groups)
+			goto invalid;
+		ret = hs_regex_rule_add(priv, &rule);
+		if (ret != 0)
+			return ret;
+		eol = memchr(eol, '\n', end - eol);
+		if (eol == NULL)
+			break;
+	}
+	return 0;
+
+invalid:
+	HS_REGEX_LOG(ERR, "invalid rule \"%.*s\"", (int)(eol - line), line);
+	return -EINVAL;
+}
+
+static int
+hs_regex_db_deserialize(struct hs_regex_priv *priv, const char *db,
+		uint32_t len)
+{
+	const struct hs_regex_db_hdr *hdr = (const void *)db;
+	hs_database_t **dbs;
+	uint32_t off = sizeof(*hdr);
+	uint32_t size;
+	uint16_t g;
+
+	if (hdr->nb_groups > priv->nb_groups ||
+	    (hdr->cfg_flags ^ priv->cfg_flags) &
+			RTE_REGEXDEV_CFG_MATCH_AS_END_F) {
+		HS_REGEX_LOG(ERR, "rule database of another configuration");
+		return -EINVAL;
+	}
+	dbs = rte_zmalloc(NULL, priv->nb_groups * sizeof(*dbs), 0);
+	if (dbs == NULL)
+		return -ENOMEM;
+	for (g = 0; g < hdr->nb_groups; g++) {
+		if (len - off < sizeof(size))
+			goto invalid;
+		memcpy(&size, db + off, sizeof(size));
+		off += sizeof(size);
+		if (size == 0)
+			continue;
+		if (len - off < size ||
+		    hs_deserialize_database(db + off, size, &dbs[g]) !=
+				HS_SUCCESS)
+			goto invalid;
+		off += size;
+	}
+	hs_regex_dbs_set(priv, dbs);
+	return 0;
+
+invalid:
+	HS_REGEX_LOG(ERR, "invalid rule database");
+	hs_regex_dbs_free(dbs, priv->nb_groups);
+	return -EINVAL;
+}
+
+/*
+ * Import either a database exported by the PMD, or rules as text which
+ * are compiled.
+ */
+static int
+hs_regex_rule_db_import(struct rte_regexdev *dev, const char *rule_db,
+		uint32_t rule_db_len)
+{
+	struct hs_regex_priv *priv = dev->data->dev_private;
+	const struct hs_regex_db_hdr *hdr = (const void *)rule_db;
+	int ret;
+
+	if (dev->data->dev_started)
+		return -EBUSY;
+	if (rule_db_len >= sizeof(*hdr) && hdr->magic == HS_REGEX_DB_MAGIC)
+		return hs_regex_db_deserialize(priv, rule_db, rule_db_len);
+
+	ret = hs_regex_rules_parse(priv, rule_db, rule_db_len);
+	if (ret == 0)
+		ret = hs_regex_compile(priv);
+	return ret;
+}
+
+static int
+hs_regex_rule_db_export(struct rte_regexdev *dev, char *rule_db)
+{
+	struct hs_regex_priv *priv = dev->data->dev_private;
+	struct hs_regex_db_hdr hdr;
+	uint32_t off = sizeof(hdr);
+	uint32_t size;
+	size_t len;
+	char *bytes;
+	uint16_t g;
+
+	if (priv->dbs == NULL)
+		return -EINVAL;
+	for (g = 0; g < priv->nb_groups; g++) {
+		size = 0;
+		bytes = NULL;
+		if (priv->dbs[g] != NULL) {
+			if (hs_serialize_database(priv->dbs[g], &bytes,
+					&len) != HS_SUCCESS)
+				return -ENOMEM;
+			size = len;
+		}
+		if (rule_db != NULL) {
+			memcpy(rule_db + off, &size, sizeof(size));
+			memcpy(rule_db + off + sizeof(size), bytes, size);
+		}
+		off += sizeof(size) + size;
+		free(bytes);
+	}
+	if (rule_db == NULL)
+		return off;
+
+	memset(&hdr, 0, sizeof(hdr));
+	hdr.magic = HS_REGEX_DB_MAGIC;
+	hdr.cfg_flags = priv->cfg_flags;
+	hdr.nb_groups = priv->nb_groups;
+	memcpy(rule_db, &hdr, sizeof(hdr));
+	return 0;
+}
+
+static int
+hs_regex_configure(struct rte_regexdev *dev,
+		const struct rte_regexdev_config *cfg)
+{
+	struct hs_regex_priv *priv = dev->data->dev_private;
+
+	hs_regex_qps_free(priv);
+	hs_regex_dbs_set(priv, NULL);
+	hs_regex_rules_free(priv);
+
+	priv->qps = rte_zmalloc_socket(NULL,
+			cfg->nb_queue_pairs * sizeof(*priv->qps),
+			RTE_CACHE_LINE_SIZE, rte_socket_id());
+	if (priv->qps == NULL)
+		return -ENOMEM;
+	priv->nb_qps = cfg->nb_queue_pairs;
+	priv->nb_groups = cfg->nb_groups;
+	priv->nb_max_matches = cfg->nb_max_matches;
+	priv->cfg_flags = cfg->dev_cfg_flags;
+
+	if (cfg->rule_db != NULL)
+		return hs_regex_rule_db_import(dev, cfg->rule_db,
+				cfg->rule_db_len);
+	return 0;
+}
+
+static int
+hs_regex_qp_setup(struct rte_regexdev *dev, uint16_t qp_id,
+		const struct rte_regexdev_qp_conf *qp_conf)
+{
+	struct hs_regex_priv *priv = dev->data->dev_private;
+	struct hs_regex_qp *qp = &priv->qps[qp_id];
+	char name[RTE_RING_NAMESIZE];
+	uint16_t nb_desc = HS_REGEX_DEFAULT_NB_DESC;
+
+	if (qp_conf != NULL && qp_conf->nb_desc != 0)
+		nb_desc = qp_conf->nb_desc;
+
+	rte_ring_free(qp->done);
+	snprintf(name, sizeof(name), "hs_regex_%u_%u", dev->data->dev_id,
+		 qp_id);
+	qp->done = rte_ring_create(name, nb_desc, rte_socket_id(),
+			RING_F_SP_ENQ | RING_F_SC_DEQ | RING_F_EXACT_SZ);
+	if (qp->done == NULL) {
+		HS_REGEX_LOG(ERR, "cannot create ring of queue pair %u",
+			     qp_id);
+		return -ENOMEM;
+	}
+	qp->cb = qp_conf != NULL ? qp_conf->cb : NULL;
+	return 0;
+}
+
+static int
+hs_regex_start(struct rte_regexdev *dev)
+{
+	struct hs_regex_priv *priv = dev->data->dev_private;
+	uint16_t i, g;
+
+	/* The scratch space of each queue pair must fit all databases. */
+	for (i = 0; i < priv->nb_qps; i++) {
+		if (priv->qps[i].done == NULL) {
+			HS_REGEX_LOG(ERR, "queue pair %u is not set up", i);
+			return -EINVAL;
+		}
+		for (g = 0; priv->dbs != NULL && g < priv->nb_groups; g++) {
+			if (priv->dbs[g] == NULL)
+				continue;
+			if (hs_alloc_scratch(priv->dbs[g],
+					&priv->qps[i].scratch) != HS_SUCCESS)
+				return -ENOMEM;
+		}
+	}
+	return 0;
+}
+
+static int
+hs_regex_stop(struct rte_regexdev *dev)
+{
+	struct hs_regex_priv *priv = dev->data->dev_private;
+	struct rte_regex_ops *op;
+	uint16_t i;
+
+	for (i = 0; i < priv->nb_qps; i++) {
+		if (priv->qps[i].done == NULL)
+			continue;
+		while (rte_ring_dequeue(priv->qps[i].done,
+				(void **)&op) == 0) {
+			if (priv->qps[i].cb != NULL)
+				priv->qps[i].cb(dev->data->dev_id, i, op);
+		}
+	}
+	return 0;
+}
+
+static int
+hs_regex_close(struct rte_regexdev *dev)
+{
+	struct hs_regex_priv *priv = dev->data->dev_private;
+
+	hs_regex_qps_free(priv);
+	hs_regex_dbs_set(priv, NULL);
+	hs_regex_rules_free(priv);
+	return 0;
+}
+
+static const struct rte_regexdev_ops hs_regex_ops = {
+	.dev_info_get = hs_regex_info_get,
+	.dev_configure = hs_regex_configure,
+	.dev_qp_setup = hs_regex_qp_setup,
+	.dev_start = hs_regex_start,
+	.dev_stop = hs_regex_stop,
+	.dev_close = hs_regex_close,
+	.dev_rule_db_update = hs_regex_rule_db_update,
+	.dev_rule_db_compile_activate = hs_regex_rule_db_compile_activate,
+	.dev_db_import = hs_regex_rule_db_import,
+	.dev_db_export = hs_regex_rule_db_export,
+};
+
+static int
+hs_regex_probe(struct rte_vdev_device *vdev)
+{
+	struct hs_regex_priv *priv;
+	struct rte_regexdev *dev;
+	const char *name;
+
+	name = rte_vdev_device_name(vdev);
+	if (name == NULL)
+		return -EINVAL;
+
+	if (hs_valid_platform() != HS_SUCCESS) {
+		HS_REGEX_LOG(ERR, "CPU not supported by Hyperscan");
+		return -ENOTSUP;
+	}
+
+	priv = rte_zmalloc_socket("hs regex device private", sizeof(*priv),
+			RTE_CACHE_LINE_SIZE, rte_socket_id());
+	if (priv == NULL)
+		return -ENOMEM;
+
+	dev = rte_regexdev_register(name);
+	if (dev == NULL) {
+		HS_REGEX_LOG(ERR, "failed to register RegEx device %s", name);
+		rte_free(priv);
+		return -ENODEV;
+	}
+	priv->regexdev = dev;
+	dev->dev_ops = &hs_regex_ops;
+	dev->enqueue = hs_regexdev_enqueue;
+	dev->dequeue = hs_regexdev_dequeue;
+	dev->device = &vdev->device;
+	dev->data->dev_private = priv;
+	dev->state = RTE_REGEXDEV_READY;
+
+	return 0;
+}
+
+static int
+hs_regex_remove(struct rte_vdev_device *vdev)
+{
+	struct rte_regexdev *dev;
+	const char *name;
+
+	name = rte_vdev_device_name(vdev);
+	if (name == NULL)
+		return -EINVAL;
+
+	dev = rte_regexdev_get_device_by_name(name);
+	if (dev == NULL)
+		return -ENODEV;
+
+	hs_regex_close(dev);
+	rte_free(dev->data->dev_private);
+	dev->data->dev_private = NULL;
+	rte_regexdev_unregister(dev);
+	return 0;
+}
+
+static struct rte_vdev_driver hs_regex_pmd_drv = {
+	.probe = hs_regex_probe,
+	.remove = hs_regex_remove,
+};
+
+RTE_PMD_REGISTER_VDEV(HS_REGEX_PMD_NAME, hs_regex_pmd_drv);
+RTE_LOG_REGISTER_DEFAULT(hs_regex_logtype, NOTICE);
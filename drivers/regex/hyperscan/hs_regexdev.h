@@ -0,0 +1,74 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#ifndef _HS_REGEXDEV_H_
+#define _HS_REGEXDEV_H_
+
+#include <hs.h>
+
+#include <rte_log.h>
+#include <rte_ring.h>
+#include <rte_regexdev.h>
+#include <rte_regexdev_core.h>
+
+#define HS_REGEX_PMD_NAME regex_hyperscan
+
+#define HS_REGEX_MAX_QPS 64
+#define HS_REGEX_MAX_GROUPS 64
+#define HS_REGEX_MAX_RULES_PER_GROUP (1 << 16)
+#define HS_REGEX_MAX_MATCHES 255
+#define HS_REGEX_MAX_PAYLOAD UINT16_MAX
+/* Maximum number of segments of a scanned mbuf. */
+#define HS_REGEX_MAX_SEGS 256
+#define HS_REGEX_DEFAULT_NB_DESC 1024
+
+extern int hs_regex_logtype;
+
+#define HS_REGEX_LOG(level, fmt, args...) \
+	rte_log(RTE_LOG_ ## level, hs_regex_logtype, "%s(): " fmt "\n", \
+		__func__, ##args)
+
+/* Rule of the database, as given to the Hyperscan compiler. */
+struct hs_regex_rule {
+	uint32_t rule_id;
+	uint16_t group_id;
+	unsigned int hs_flags;
+	char *expr;
+};
+
+/*
+ * Queue pair, the ops are scanned at enqueue time and kept in a ring
+ * until dequeued. The scratch space of Hyperscan is per queue pair, since
+ * it cannot be shared by concurrent scans.
+ */
+struct hs_regex_qp {
+	struct rte_ring *done;
+	hs_scratch_t *scratch;
+	regexdev_stop_flush_t cb;
+	/* Segments of the mbuf being scanned. */
+	const char *seg_data[HS_REGEX_MAX_SEGS];
+	unsigned int seg_len[HS_REGEX_MAX_SEGS];
+} __rte_cache_aligned;
+
+struct hs_regex_priv {
+	struct rte_regexdev *regexdev;
+	/* Compiled database of each group, NULL if the group has no rule. */
+	hs_database_t **dbs;
+	uint16_t nb_groups;
+	uint16_t nb_max_matches;
+	uint32_t cfg_flags;
+	/* Rules updated since the last compilation. */
+	struct hs_regex_rule *rules;
+	uint32_t nb_rules;
+	struct hs_regex_qp *qps;
+	uint16_t nb_qps;
+};
+
+/* hs_regexdev_fastpath.c */
+uint16_t hs_regexdev_enqueue(struct rte_regexdev *dev, uint16_t qp_id,
+		struct rte_regex_ops **ops, uint16_t nb_ops);
+uint16_t hs_regexdev_dequeue(struct rte_regexdev *dev, uint16_t qp_id,
+		struct rte_regex_ops **ops, uint16_t nb_ops);
+
+#endif /* _HS_REGEXDEV_H_ */
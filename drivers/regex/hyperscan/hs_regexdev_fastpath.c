@@ -0,0 +1,186 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <stdbool.h>
+
+#include <rte_branch_prediction.h>
+#include <rte_mbuf.h>
+#include <rte_prefetch.h>
+
+#include "hs_regexdev.h"
+
+struct hs_regex_scan_ctx {
+	struct rte_regex_ops *op;
+	uint16_t group_id;
+	uint16_t nb_max_matches;
+	bool match_as_end;
+	bool high_priority;
+	bool stopped;
+};
+
+/* Whether match a has a higher priority than match b. */
+static inline bool
+hs_regex_match_prior(const struct rte_regexdev_match *a,
+		const struct rte_regexdev_match *b)
+{
+	if (a->rule_id != b->rule_id)
+		return a->rule_id < b->rule_id;
+	if (a->start_offset != b->start_offset)
+		return a->start_offset < b->start_offset;
+	return a->len < b->len;
+}
+
+/* Hyperscan match callback, a non zero return stops the scan. */
+static int
+hs_regex_on_match(unsigned int id, unsigned long long from,
+		unsigned long long to, unsigned int flags __rte_unused,
+		void *context)
+{
+	struct hs_regex_scan_ctx *ctx = context;
+	struct rte_regex_ops *op = ctx->op;
+	struct rte_regexdev_match match;
+
+	match.u64 = 0;
+	match.rule_id = id;
+	match.group_id = ctx->group_id;
+	if (ctx->match_as_end) {
+		match.end_offset = to;
+	} else {
+		match.start_offset = from;
+		match.len = to - from;
+	}
+	op->nb_actual_matches++;
+
+	if (ctx->high_priority) {
+		if (op->nb_matches == 0 ||
+		    hs_regex_match_prior(&match, &op->matches[0]))
+			op->matches[0] = match;
+		op->nb_matches = 1;
+	} else if (op->nb_matches < ctx->nb_max_matches) {
+		op->matches[op->nb_matches++] = match;
+	} else {
+		/* Do not scan for matches which cannot be returned. */
+		op->rsp_flags |= RTE_REGEX_OPS_RSP_MAX_MATCH_F;
+		ctx->stopped = true;
+		return 1;
+	}
+
+	if (op->req_flags & RTE_REGEX_OPS_REQ_STOP_ON_MATCH_F) {
+		ctx->stopped = true;
+		return 1;
+	}
+	return 0;
+}
+
+static const uint16_t hs_regex_group_valid[] = {
+	RTE_REGEX_OPS_REQ_GROUP_ID0_VALID_F,
+	RTE_REGEX_OPS_REQ_GROUP_ID1_VALID_F,
+	RTE_REGEX_OPS_REQ_GROUP_ID2_VALID_F,
+	RTE_REGEX_OPS_REQ_GROUP_ID3_VALID_F,
+};
+
+#define HS_REGEX_GROUP_VALID_MASK (RTE_REGEX_OPS_REQ_GROUP_ID0_VALID_F | \
+		RTE_REGEX_OPS_REQ_GROUP_ID1_VALID_F | \
+		RTE_REGEX_OPS_REQ_GROUP_ID2_VALID_F | \
+		RTE_REGEX_OPS_REQ_GROUP_ID3_VALID_F)
+
+/*
+ * Scan the payload of an op against the databases of its groups. The mbuf
+ * segments are given at once to the vectored mode of Hyperscan, so the
+ * matches spanning segments are found.
+ */
+static void
+hs_regex_scan(const struct hs_regex_priv *priv, struct hs_regex_qp *qp,
+		struct rte_regex_ops *op)
+{
+	struct hs_regex_scan_ctx ctx;
+	const struct rte_mbuf *m;
+	uint16_t group_ids[RTE_DIM(hs_regex_group_valid)];
+	unsigned int nb_segs = 0;
+	unsigned int i;
+	uint16_t valid;
+	hs_error_t ret;
+
+	op->rsp_flags = 0;
+	op->nb_actual_matches = 0;
+	op->nb_matches = 0;
+
+	if (unlikely(op->mbuf->pkt_len > HS_REGEX_MAX_PAYLOAD)) {
+		op->rsp_flags |= RTE_REGEX_OPS_RSP_RESOURCE_LIMIT_REACHED_F;
+		return;
+	}
+	for (m = op->mbuf; m != NULL; m = m->next) {
+		if (m->data_len == 0)
+			continue;
+		if (unlikely(nb_segs == HS_REGEX_MAX_SEGS)) {
+			op->rsp_flags |=
+				RTE_REGEX_OPS_RSP_RESOURCE_LIMIT_REACHED_F;
+			return;
+		}
+		qp->seg_data[nb_segs] = rte_pktmbuf_mtod(m, const char *);
+		qp->seg_len[nb_segs++] = m->data_len;
+	}
+
+	ctx.op = op;
+	ctx.nb_max_matches = priv->nb_max_matches;
+	ctx.match_as_end = priv->cfg_flags & RTE_REGEXDEV_CFG_MATCH_AS_END_F;
+	ctx.high_priority = op->req_flags &
+			RTE_REGEX_OPS_REQ_MATCH_HIGH_PRIORITY_F;
+	ctx.stopped = false;
+
+	group_ids[0] = op->group_id0;
+	group_ids[1] = op->group_id1;
+	group_ids[2] = op->group_id2;
+	group_ids[3] = op->group_id3;
+	/* The first group is used when none is valid. */
+	valid = op->req_flags & HS_REGEX_GROUP_VALID_MASK;
+	if (valid == 0)
+		valid = RTE_REGEX_OPS_REQ_GROUP_ID0_VALID_F;
+	for (i = 0; i < RTE_DIM(hs_regex_group_valid) && !ctx.stopped; i++) {
+		if (!(valid & hs_regex_group_valid[i]))
+			continue;
+		if (unlikely(group_ids[i] >= priv->nb_groups) ||
+		    priv->dbs[group_ids[i]] == NULL)
+			continue;
+		ctx.group_id = group_ids[i];
+		ret = hs_scan_vector(priv->dbs[group_ids[i]], qp->seg_data,
+				qp->seg_len, nb_segs, 0, qp->scratch,
+				hs_regex_on_match, &ctx);
+		if (unlikely(ret != HS_SUCCESS && ret != HS_SCAN_TERMINATED)) {
+			HS_REGEX_LOG(DEBUG, "scan failed: %d", ret);
+			op->rsp_flags |=
+				RTE_REGEX_OPS_RSP_RESOURCE_LIMIT_REACHED_F;
+			return;
+		}
+	}
+}
+
+uint16_t
+hs_regexdev_enqueue(struct rte_regexdev *dev, uint16_t qp_id,
+		struct rte_regex_ops **ops, uint16_t nb_ops)
+{
+	struct hs_regex_priv *priv = dev->data->dev_private;
+	struct hs_regex_qp *qp = &priv->qps[qp_id];
+	uint16_t i;
+
+	nb_ops = RTE_MIN(nb_ops, rte_ring_free_count(qp->done));
+	for (i = 0; i < nb_ops; i++) {
+		if (i + 1 < nb_ops)
+			rte_prefetch0(rte_pktmbuf_mtod(ops[i + 1]->mbuf,
+						       void *));
+		hs_regex_scan(priv, qp, ops[i]);
+	}
+
+	return rte_ring_enqueue_burst(qp->done, (void **)ops, nb_ops, NULL);
+}
+
+uint16_t
+hs_regexdev_dequeue(struct rte_regexdev *dev, uint16_t qp_id,
+		struct rte_regex_ops **ops, uint16_t nb_ops)
+{
+	struct hs_regex_priv *priv = dev->data->dev_private;
+
+	return rte_ring_dequeue_burst(priv->qps[qp_id].done, (void **)ops,
+			nb_ops, NULL);
+}
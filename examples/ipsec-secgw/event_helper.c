@@ -2,8 +2,10 @@
  * Copyright (C) 2020 Marvell International Ltd.
  */
 #include <rte_bitmap.h>
+#include <rte_cryptodev.h>
 #include <rte_ethdev.h>
 #include <rte_eventdev.h>
+#include <rte_event_crypto_adapter.h>
 #include <rte_event_eth_rx_adapter.h>
 #include <rte_event_eth_tx_adapter.h>
 #include <rte_malloc.h>
@@ -202,6 +204,16 @@ eh_set_default_conf_eventdev(struct eventmode_conf *em_conf)
 		eventdev_config->nb_eventqueue = nb_eth_dev + 1;
 	}
 
+	/* One more queue is reserved for the crypto stage */
+	if (em_conf->ext_params.enable_event_crypto_adapter) {
+		if (dev_info.max_event_queues < 3) {
+			EH_LOG_ERR("Not enough event queues available");
+			return -EINVAL;
+		}
+		if (eventdev_config->nb_eventqueue < dev_info.max_event_queues)
+			eventdev_config->nb_eventqueue++;
+	}
+
 	/* Check if there are more ports than required */
 	if (eventdev_config->nb_eventport > lcore_count) {
 		/* One port per lcore is enough */
@@ -364,6 +376,10 @@ eh_set_default_conf_rx_adapter(struct eventmode_conf *em_conf)
 			eventdev_config->nb_eventqueue :
 			eventdev_config->nb_eventqueue - 1;
 
+	/* The crypto stage queue is not used for Rx */
+	if (em_conf->ext_params.enable_event_crypto_adapter)
+		nb_eventqueue--;
+
 	/*
 	 * Map all queues of eth device (port) to an event queue. If there
 	 * are more event queues than eth ports then create 1:1 mapping.
@@ -525,6 +541,55 @@ eh_set_default_conf_tx_adapter(struct eventmode_conf *em_conf)
 	return 0;
 }
 
+static int
+eh_set_default_conf_crypto_adapter(struct eventmode_conf *em_conf)
+{
+	struct eventdev_params *eventdev_config;
+	uint8_t cdev_id;
+
+	/* Create one adapter per crypto device having queue pairs */
+
+	/* Use the first event dev */
+	eventdev_config = &(em_conf->eventdev_config[0]);
+
+	/*
+	 * The crypto stage queue is the last one before the Tx queue,
+	 * if any is reserved.
+	 */
+	eventdev_config->ev_cpt_queue_id = eventdev_config->all_internal_ports ?
+			eventdev_config->nb_eventqueue - 1 :
+			eventdev_config->nb_eventqueue - 2;
+
+	for (cdev_id = 0; cdev_id < rte_cryptodev_count(); cdev_id++) {
+		if (rte_cryptodev_queue_pair_count(cdev_id) == 0)
+			continue;
+
+		if (em_conf->nb_crypto_adapter ==
+				EVENT_MODE_MAX_CRYPTO_ADAPTERS) {
+			EH_LOG_ERR("Exceeded the max allowed crypto adapters");
+			return -EINVAL;
+		}
+		em_conf->crypto_adapter_cdev[em_conf->nb_crypto_adapter++] =
+				cdev_id;
+	}
+
+	if (em_conf->nb_crypto_adapter == 0) {
+		EH_LOG_ERR("No crypto devs configured");
+		return -EINVAL;
+	}
+
+	/*
+	 * The crypto adapters without internal port are run by an eth core,
+	 * else the service needs to be mapped to a service core.
+	 */
+	if (eh_get_enabled_cores(em_conf->eth_core_mask) != 0)
+		em_conf->crypto_core_id = eh_get_next_eth_core(em_conf);
+	else
+		em_conf->crypto_core_id = -1;
+
+	return 0;
+}
+
 static int
 eh_validate_conf(struct eventmode_conf *em_conf)
 {
@@ -573,6 +638,17 @@ eh_validate_conf(struct eventmode_conf *em_conf)
 			return ret;
 	}
 
+	/*
+	 * Generate the crypto adapters config, if the crypto stage is
+	 * requested by the application.
+	 */
+	if (em_conf->ext_params.enable_event_crypto_adapter &&
+	    em_conf->nb_crypto_adapter == 0) {
+		ret = eh_set_default_conf_crypto_adapter(em_conf);
+		if (ret != 0)
+			return ret;
+	}
+
 	return 0;
 }
 
@@ -655,6 +731,14 @@ eh_initialize_eventdev(struct eventmode_conf *em_conf)
 			    j == nb_eventqueue-1) {
 				eventq_conf.schedule_type =
 					RTE_SCHED_TYPE_ATOMIC;
+			} else if (em_conf->ext_params.enable_event_crypto_adapter &&
+				   j == eventdev_config->ev_cpt_queue_id) {
+				/*
+				 * The crypto stage is atomic, so that the
+				 * packets of an SA are submitted in order.
+				 */
+				eventq_conf.schedule_type =
+					RTE_SCHED_TYPE_ATOMIC;
 			} else {
 				eventq_conf.schedule_type =
 					em_conf->ext_params.sched_type;
@@ -829,7 +913,8 @@ eh_initialize_rx_adapter(struct eventmode_conf *em_conf)
 static int32_t
 eh_start_worker_eth_core(struct eventmode_conf *conf, uint32_t lcore_id)
 {
-	uint32_t service_id[EVENT_MODE_MAX_ADAPTERS_PER_RX_CORE];
+	uint32_t service_id[EVENT_MODE_MAX_ADAPTERS_PER_RX_CORE +
+			    EVENT_MODE_MAX_CRYPTO_ADAPTERS];
 	struct rx_adapter_conf *rx_adapter;
 	struct tx_adapter_conf *tx_adapter;
 	int service_count = 0;
@@ -905,6 +990,30 @@ eh_start_worker_eth_core(struct eventmode_conf *conf, uint32_t lcore_id)
 		service_count++;
 	}
 
+	/*
+	 * Check if the crypto adapters without internal port need to be
+	 * handled by this core.
+	 */
+	for (i = 0; i < conf->nb_crypto_adapter &&
+			conf->crypto_core_id == lcore_id; i++) {
+		/* Get the service ID for the adapters */
+		ret = rte_event_crypto_adapter_service_id_get(i,
+				&(service_id[service_count]));
+
+		/* Internal port, no service to run */
+		if (ret == -ESRCH)
+			continue;
+
+		if (ret < 0) {
+			EH_LOG_ERR(
+			      "Failed to get service id used by crypto adapter");
+			return ret;
+		}
+
+		/* Update service count */
+		service_count++;
+	}
+
 	eth_core_running = true;
 
 	while (eth_core_running) {
@@ -1223,6 +1332,119 @@ eh_initialize_tx_adapter(struct eventmode_conf *em_conf)
 	return 0;
 }
 
+static int
+eh_crypto_adapter_configure(struct eventmode_conf *em_conf, uint8_t adapter_id)
+{
+	struct rte_event_dev_info evdev_default_conf = {0};
+	struct rte_event_port_conf port_conf = {0};
+	struct eventdev_params *eventdev_config;
+	struct rte_event event = {0};
+	uint8_t eventdev_id;
+	uint32_t service_id;
+	uint32_t caps = 0;
+	uint8_t cdev_id;
+	int ret;
+
+	/* Use the first event dev */
+	eventdev_config = &(em_conf->eventdev_config[0]);
+
+	/* Get event dev ID */
+	eventdev_id = eventdev_config->eventdev_id;
+
+	/* Get crypto dev ID */
+	cdev_id = em_conf->crypto_adapter_cdev[adapter_id];
+
+	ret = rte_event_crypto_adapter_caps_get(eventdev_id, cdev_id, &caps);
+	if (ret < 0) {
+		EH_LOG_ERR("Failed to get event device %d crypto adapter"
+			   " capabilities for cryptodev %d", eventdev_id,
+			   cdev_id);
+		return ret;
+	}
+
+	/* Get default configuration of event dev */
+	ret = rte_event_dev_info_get(eventdev_id, &evdev_default_conf);
+	if (ret < 0) {
+		EH_LOG_ERR("Failed to get event dev info %d", ret);
+		return ret;
+	}
+
+	/* Setup port conf */
+	port_conf.new_event_threshold =
+			evdev_default_conf.max_num_events;
+	port_conf.dequeue_depth =
+			evdev_default_conf.max_event_port_dequeue_depth;
+	port_conf.enqueue_depth =
+			evdev_default_conf.max_event_port_enqueue_depth;
+
+	/*
+	 * The application submits the crypto operations to the crypto
+	 * device, and the adapter enqueues the completions as new events.
+	 */
+	ret = rte_event_crypto_adapter_create(adapter_id, eventdev_id,
+			&port_conf, RTE_EVENT_CRYPTO_ADAPTER_OP_NEW);
+	if (ret < 0) {
+		EH_LOG_ERR("Failed to create crypto adapter %d", ret);
+		return ret;
+	}
+
+	/*
+	 * The completions are scheduled in the crypto stage queue, with the
+	 * flow set in the response information of the crypto sessions.
+	 */
+	event.queue_id = eventdev_config->ev_cpt_queue_id;
+	event.sched_type = RTE_SCHED_TYPE_ATOMIC;
+	event.event_type = RTE_EVENT_TYPE_CRYPTODEV;
+
+	/* Add all queue pairs of the crypto device to the adapter */
+	ret = rte_event_crypto_adapter_queue_pair_add(adapter_id, cdev_id, -1,
+			(caps & RTE_EVENT_CRYPTO_ADAPTER_CAP_INTERNAL_PORT_QP_EV_BIND) ?
+			&event : NULL);
+	if (ret < 0) {
+		EH_LOG_ERR("Failed to add queue pairs to crypto adapter %d",
+			   ret);
+		return ret;
+	}
+
+	/* Get the service ID used by crypto adapter */
+	ret = rte_event_crypto_adapter_service_id_get(adapter_id, &service_id);
+	if (ret != -ESRCH && ret < 0) {
+		EH_LOG_ERR("Failed to get service id used by crypto adapter %d",
+			   ret);
+		return ret;
+	}
+
+	if (ret == 0 && em_conf->crypto_core_id != (uint32_t)-1)
+		rte_service_set_runstate_mapped_check(service_id, 0);
+
+	/* Start adapter */
+	ret = rte_event_crypto_adapter_start(adapter_id);
+	if (ret < 0) {
+		EH_LOG_ERR("Failed to start crypto adapter %d", ret);
+		return ret;
+	}
+
+	return 0;
+}
+
+static int
+eh_initialize_crypto_adapter(struct eventmode_conf *em_conf)
+{
+	uint8_t i;
+	int ret;
+
+	/* Configure crypto adapters */
+	for (i = 0; i < em_conf->nb_crypto_adapter; i++) {
+		ret = eh_crypto_adapter_configure(em_conf, i);
+		if (ret < 0) {
+			EH_LOG_ERR("Failed to configure crypto adapter %d",
+				   ret);
+			return ret;
+		}
+	}
+	return 0;
+}
+
 static void
 eh_display_operating_mode(struct eventmode_conf *em_conf)
 {
@@ -1368,6 +1590,38 @@ eh_display_tx_adapter_conf(struct eventmode_conf *em_conf)
 	EH_LOG_INFO("");
 }
 
+static void
+eh_display_crypto_adapter_conf(struct eventmode_conf *em_conf)
+{
+	struct eventdev_params *eventdev_config;
+	char print_buf[256] = { 0 };
+	int i;
+
+	if (!em_conf->ext_params.enable_event_crypto_adapter)
+		return;
+
+	eventdev_config = &(em_conf->eventdev_config[0]);
+
+	EH_LOG_INFO("Crypto adapters configured: %d",
+		    em_conf->nb_crypto_adapter);
+
+	for (i = 0; i < em_conf->nb_crypto_adapter; i++) {
+		sprintf(print_buf,
+			"\tCrypto adapter ID: %-2d\tCryptodev ID: %-2d"
+			"\tEvent queue: %-2d",
+			i, em_conf->crypto_adapter_cdev[i],
+			eventdev_config->ev_cpt_queue_id);
+		if (em_conf->crypto_core_id == (uint32_t)-1)
+			sprintf(print_buf + strlen(print_buf),
+				"\tCrypto core: %-2s", "[NONE]");
+		else
+			sprintf(print_buf + strlen(print_buf),
+				"\tCrypto core: %-2d", em_conf->crypto_core_id);
+		EH_LOG_INFO("%s", print_buf);
+	}
+	EH_LOG_INFO("");
+}
+
 static void
 eh_display_link_conf(struct eventmode_conf *em_conf)
 {
@@ -1536,6 +1790,9 @@ eh_display_conf(struct eh_conf *conf)
 	/* Display Tx adapter conf */
 	eh_display_tx_adapter_conf(em_conf);
 
+	/* Display crypto adapter conf */
+	eh_display_crypto_adapter_conf(em_conf);
+
 	/* Display event-lcore link */
 	eh_display_link_conf(em_conf);
 }
@@ -1566,6 +1823,10 @@ eh_devs_init(struct eh_conf *conf)
 	/* Eventmode conf would need eth portmask */
 	em_conf->eth_portmask = conf->eth_portmask;
 
+	/* Reserve the crypto stage if requested by the application */
+	em_conf->ext_params.enable_event_crypto_adapter =
+			conf->enable_event_crypto_adapter;
+
 	/* Validate the requested config */
 	ret = eh_validate_conf(em_conf);
 	if (ret < 0) {
@@ -1612,6 +1873,13 @@ eh_devs_init(struct eh_conf *conf)
 		return ret;
 	}
 
+	/* Setup crypto adapters */
+	ret = eh_initialize_crypto_adapter(em_conf);
+	if (ret < 0) {
+		EH_LOG_ERR("Failed to initialize crypto adapter %d", ret);
+		return ret;
+	}
+
 	/* Start eth devices after setting up adapter */
 	RTE_ETH_FOREACH_DEV(port_id) {
 
@@ -1682,6 +1950,30 @@ eh_devs_uninit(struct eh_conf *conf)
 		}
 	}
 
+	/* Stop and release crypto adapters */
+	for (i = 0; i < em_conf->nb_crypto_adapter; i++) {
+
+		ret = rte_event_crypto_adapter_stop(i);
+		if (ret < 0) {
+			EH_LOG_ERR("Failed to stop crypto adapter %d", ret);
+			return ret;
+		}
+
+		ret = rte_event_crypto_adapter_queue_pair_del(i,
+				em_conf->crypto_adapter_cdev[i], -1);
+		if (ret < 0) {
+			EH_LOG_ERR("Failed to remove crypto adapter queue "
+				   "pairs %d", ret);
+			return ret;
+		}
+
+		ret = rte_event_crypto_adapter_free(i);
+		if (ret < 0) {
+			EH_LOG_ERR("Failed to free crypto adapter %d", ret);
+			return ret;
+		}
+	}
+
 	/* Stop and release event devices */
 	for (i = 0; i < em_conf->nb_eventdev; i++) {
 
@@ -1833,3 +2125,33 @@ eh_get_tx_queue(struct eh_conf *conf, uint8_t eventdev_id)
 	 */
 	return eventdev_config->nb_eventqueue - 1;
 }
+
+uint8_t
+eh_get_crypto_queue(struct eh_conf *conf, uint8_t eventdev_id)
+{
+	struct eventdev_params *eventdev_config;
+	struct eventmode_conf *em_conf;
+
+	if (conf == NULL) {
+		EH_LOG_ERR("Invalid event helper configuration");
+		return -EINVAL;
+	}
+
+	if (conf->mode_params == NULL) {
+		EH_LOG_ERR("Invalid event mode parameters");
+		return -EINVAL;
+	}
+
+	/* Get eventmode conf */
+	em_conf = conf->mode_params;
+
+	/* Get event device conf */
+	eventdev_config = eh_get_eventdev_params(em_conf, eventdev_id);
+
+	if (eventdev_config == NULL) {
+		EH_LOG_ERR("Failed to read eventdev config");
+		return -EINVAL;
+	}
+
+	return eventdev_config->ev_cpt_queue_id;
+}
@@ -33,6 +33,9 @@
 /* Max Tx adapter connections */
 #define EVENT_MODE_MAX_CONNECTIONS_PER_TX_ADAPTER 16
 
+/* Max crypto adapters supported */
+#define EVENT_MODE_MAX_CRYPTO_ADAPTERS 16
+
 /* Max event queues supported per event device */
 #define EVENT_MODE_MAX_EVENT_QUEUES_PER_DEV RTE_EVENT_MAX_QUEUES_PER_DEV
 
@@ -88,6 +91,7 @@ struct eventdev_params {
 	uint8_t nb_eventport;
 	uint8_t ev_queue_mode;
 	uint8_t all_internal_ports;
+	uint8_t ev_cpt_queue_id;
 };
 
 /**
@@ -152,6 +156,12 @@ struct eventmode_conf {
 		/**< No of Tx adapters */
 	struct tx_adapter_conf tx_adapter[EVENT_MODE_MAX_TX_ADAPTERS];
 		/** Tx adapter conf */
+	uint8_t nb_crypto_adapter;
+		/**< No of crypto adapters, one per crypto device */
+	uint8_t crypto_adapter_cdev[EVENT_MODE_MAX_CRYPTO_ADAPTERS];
+		/**< Crypto device of each crypto adapter */
+	uint32_t crypto_core_id;
+		/**< Core running the crypto adapters without internal port */
 	uint8_t nb_link;
 		/**< No of links */
 	struct eh_event_link_info
@@ -170,6 +180,11 @@ struct eventmode_conf {
 		/**<
 		 * When enabled, all event queues need to be mapped to
 		 * each event port
+		 */
+			uint64_t enable_event_crypto_adapter	: 1;
+		/**<
+		 * When enabled, one atomic event queue is reserved for the
+		 * lookaside crypto stage, fed back by the crypto adapters
 		 */
 		};
 		uint64_t u64;
@@ -194,6 +209,8 @@ struct eh_conf {
 		/** Application specific params */
 	enum eh_ipsec_mode_types ipsec_mode;
 		/**< Mode of ipsec run */
+	uint8_t enable_event_crypto_adapter;
+		/**< Use the event crypto adapter for lookaside sessions */
 };
 
 /* Workers registered by the application */
@@ -294,6 +311,25 @@ eh_devs_uninit(struct eh_conf *conf);
 uint8_t
 eh_get_tx_queue(struct eh_conf *conf, uint8_t eventdev_id);
 
+/**
+ * Get eventdev crypto queue
+ *
+ * If the event crypto adapter is enabled, the lookaside crypto operations
+ * are processed in an atomic event queue reserved by the eventmode helper
+ * subsystem, where the crypto adapters enqueue the completed operations.
+ * The application needs its queue ID to forward the packets to the crypto
+ * stage, and to set the response information of the crypto sessions.
+ *
+ * @param conf
+ *   Event helper configuration
+ * @param eventdev_id
+ *   Event device ID
+ * @return
+ *   Crypto queue ID
+ */
+uint8_t
+eh_get_crypto_queue(struct eh_conf *conf, uint8_t eventdev_id);
+
 /**
  * Display event mode configuration
  *
@@ -45,6 +45,7 @@
 #include <rte_cryptodev.h>
 #include <rte_security.h>
 #include <rte_eventdev.h>
+#include <rte_event_crypto_adapter.h>
 #include <rte_ip.h>
 #include <rte_ip_frag.h>
 #include <rte_alarm.h>
@@ -1187,6 +1188,20 @@ drain_outbound_crypto_queues(const struct lcore_conf *qconf,
 		route6_pkts(qconf->rt6_ctx, trf.ip6.pkts, trf.ip6.num);
 }
 
+void
+ipsec_lcore_cdev_ctx_init(uint32_t lcore_id, struct ipsec_ctx *inbound,
+		struct ipsec_ctx *outbound)
+{
+	struct lcore_conf *qconf = &lcore_conf[lcore_id];
+
+	inbound->cdev_map = cdev_map_in;
+	inbound->nb_qps = qconf->inbound.nb_qps;
+	memcpy(inbound->tbl, qconf->inbound.tbl, sizeof(inbound->tbl));
+	outbound->cdev_map = cdev_map_out;
+	outbound->nb_qps = qconf->outbound.nb_qps;
+	memcpy(outbound->tbl, qconf->outbound.tbl, sizeof(outbound->tbl));
+}
+
 /* main processing loop */
 void
 ipsec_poll_mode_worker(void)
@@ -2379,7 +2394,8 @@ max_session_size(void)
 }
 
 static void
-session_pool_init(struct socket_ctx *ctx, int32_t socket_id, size_t sess_sz)
+session_pool_init(struct socket_ctx *ctx, int32_t socket_id, size_t sess_sz,
+	uint16_t user_data_sz)
 {
 	char mp_name[RTE_MEMPOOL_NAMESIZE];
 	struct rte_mempool *sess_mp;
@@ -2392,8 +2408,8 @@ session_pool_init(struct socket_ctx *ctx, int32_t socket_id, size_t sess_sz)
 	nb_sess = RTE_MAX(nb_sess, CDEV_MP_CACHE_SZ *
 			CDEV_MP_CACHE_MULTIPLIER);
 	sess_mp = rte_cryptodev_sym_session_pool_create(
-			mp_name, nb_sess, sess_sz, CDEV_MP_CACHE_SZ, 0,
-			socket_id);
+			mp_name, nb_sess, sess_sz, CDEV_MP_CACHE_SZ,
+			user_data_sz, socket_id);
 	ctx->session_pool = sess_mp;
 
 	if (ctx->session_pool == NULL)
@@ -2705,22 +2721,35 @@ signal_handler(int signum)
 	}
 }
 
-static void
-ev_mode_sess_verify(struct ipsec_sa *sa, int nb_sa)
+/* Return the number of lookaside sessions */
+static uint32_t
+ev_mode_sess_verify(struct ipsec_sa *sa, int nb_sa, struct eh_conf *eh_conf)
 {
 	struct rte_ipsec_session *ips;
+	uint32_t nb_lksd = 0;
 	int32_t i;
 
 	if (!sa || !nb_sa)
-		return;
+		return 0;
 
 	for (i = 0; i < nb_sa; i++) {
 		ips = ipsec_get_primary_session(&sa[i]);
-		if (ips->type != RTE_SECURITY_ACTION_TYPE_INLINE_PROTOCOL)
+		if (ips->type == RTE_SECURITY_ACTION_TYPE_NONE) {
+			if (app_sa_prm.enable == 0 ||
+			    eh_conf->ipsec_mode != EH_IPSEC_MODE_TYPE_APP)
+				rte_exit(EXIT_FAILURE, "Event mode supports "
+					 "lookaside sessions only with "
+					 "librte_ipsec in app mode\n");
+			nb_lksd++;
+		} else if (ips->type !=
+			   RTE_SECURITY_ACTION_TYPE_INLINE_PROTOCOL) {
 			rte_exit(EXIT_FAILURE, "Event mode supports only "
-				 "inline protocol sessions\n");
+				 "inline protocol and lookaside none "
+				 "sessions\n");
+		}
 	}
 
+	return nb_lksd;
 }
 
 static int32_t
@@ -2728,6 +2757,7 @@ check_event_mode_params(struct eh_conf *eh_conf)
 {
 	struct eventmode_conf *em_conf = NULL;
 	struct lcore_params *params;
+	uint32_t lcore_id, nb_lksd;
 	uint16_t portid;
 
 	if (!eh_conf || !eh_conf->mode_params)
@@ -2751,12 +2781,14 @@ check_event_mode_params(struct eh_conf *eh_conf)
 		em_conf->ext_params.sched_type = RTE_SCHED_TYPE_ORDERED;
 
 	/*
-	 * Event mode currently supports only inline protocol sessions.
-	 * If there are other types of sessions configured then exit with
-	 * error.
+	 * Event mode supports inline protocol sessions, and lookaside
+	 * sessions processed by librte_ipsec through the event crypto
+	 * adapter. If there are other types of sessions configured then
+	 * exit with error.
 	 */
-	ev_mode_sess_verify(sa_in, nb_sa_in);
-	ev_mode_sess_verify(sa_out, nb_sa_out);
+	nb_lksd = ev_mode_sess_verify(sa_in, nb_sa_in, eh_conf);
+	nb_lksd += ev_mode_sess_verify(sa_out, nb_sa_out, eh_conf);
+	eh_conf->enable_event_crypto_adapter = (nb_lksd != 0);
 
 
 	/* Option --config does not apply to event mode */
@@ -2767,17 +2799,35 @@ check_event_mode_params(struct eh_conf *eh_conf)
 
 	/*
 	 * In order to use the same port_init routine for both poll and event
-	 * modes initialize lcore_params with one queue for each eth port
+	 * modes initialize lcore_params with one queue for each eth port.
+	 * With lookaside sessions, the queue is repeated for all lcores so
+	 * that each of them gets its own cryptodev queue pairs, as any
+	 * worker may run the crypto stage.
 	 */
 	lcore_params = lcore_params_array;
 	RTE_ETH_FOREACH_DEV(portid) {
 		if ((enabled_port_mask & (1 << portid)) == 0)
 			continue;
 
-		params = &lcore_params[nb_lcore_params++];
-		params->port_id = portid;
-		params->queue_id = 0;
-		params->lcore_id = rte_get_next_lcore(0, 0, 1);
+		if (nb_lksd == 0) {
+			params = &lcore_params[nb_lcore_params++];
+			params->port_id = portid;
+			params->queue_id = 0;
+			params->lcore_id = rte_get_next_lcore(0, 0, 1);
+			continue;
+		}
+
+		RTE_LCORE_FOREACH(lcore_id) {
+			if (nb_lcore_params >= MAX_LCORE_PARAMS) {
+				printf("exceeded max number of lcore params: "
+				       "%hu\n", nb_lcore_params);
+				return -EINVAL;
+			}
+			params = &lcore_params[nb_lcore_params++];
+			params->port_id = portid;
+			params->queue_id = 0;
+			params->lcore_id = lcore_id;
+		}
 	}
 
 	return 0;
@@ -2935,7 +2985,9 @@ main(int32_t argc, char **argv)
 			continue;
 
 		pool_init(&socket_ctx[socket_id], socket_id, nb_bufs_in_pool);
-		session_pool_init(&socket_ctx[socket_id], socket_id, sess_sz);
+		session_pool_init(&socket_ctx[socket_id], socket_id, sess_sz,
+			eh_conf->enable_event_crypto_adapter ?
+			sizeof(union rte_event_crypto_metadata) : 0);
 		session_priv_pool_init(&socket_ctx[socket_id], socket_id,
 			sess_sz);
 	}
@@ -3,6 +3,8 @@
  * Copyright (C) 2020 Marvell International Ltd.
  */
 #include <rte_acl.h>
+#include <rte_cryptodev.h>
+#include <rte_event_crypto_adapter.h>
 #include <rte_event_eth_tx_adapter.h>
 #include <rte_lpm.h>
 #include <rte_lpm6.h>
@@ -11,6 +13,10 @@
 #include "ipsec.h"
 #include "ipsec-secgw.h"
 #include "ipsec_worker.h"
+#include "sad.h"
+
+/* Event queue of the lookaside crypto stage of the lcore, -1 if disabled */
+static RTE_DEFINE_PER_LCORE(int16_t, ev_cpt_queue_id);
 
 static inline enum pkt_type
 process_ipsec_get_pkt_type(struct rte_mbuf *pkt, uint8_t **nlp)
@@ -101,16 +107,24 @@ prepare_out_sessions_tbl(struct sa_ctx *sa_out,
 	}
 }
 
+/*
+ * Check the SP of a packet. The result of a classification done for the
+ * whole burst is given in sp_res, else the packet is classified here.
+ */
 static inline int
-check_sp(struct sp_ctx *sp, const uint8_t *nlp, uint32_t *sa_idx)
+check_sp(struct sp_ctx *sp, const uint8_t *nlp, const uint32_t *sp_res,
+		uint32_t *sa_idx)
 {
 	uint32_t res;
 
 	if (unlikely(sp == NULL))
 		return 0;
 
-	rte_acl_classify((struct rte_acl_ctx *)sp, &nlp, &res, 1,
-			DEFAULT_MAX_CATEGORIES);
+	if (sp_res != NULL)
+		res = *sp_res;
+	else
+		rte_acl_classify((struct rte_acl_ctx *)sp, &nlp, &res, 1,
+				DEFAULT_MAX_CATEGORIES);
 
 	if (unlikely(res == DISCARD))
 		return 0;
@@ -182,10 +196,105 @@ get_route(struct rte_mbuf *pkt, struct route_table *rt, enum pkt_type type)
 	return RTE_MAX_ETHPORTS;
 }
 
+/*
+ * Strip the Ethernet header of a packet and set its L3 length, as expected
+ * by librte_ipsec.
+ */
 static inline int
-process_ipsec_ev_inbound(struct ipsec_ctx *ctx, struct route_table *rt,
-		struct rte_event *ev)
+ev_pkt_l2_strip(struct rte_mbuf *pkt, enum pkt_type type)
+{
+	struct rte_ipv6_hdr *ip6;
+	size_t l3len, ext_len;
+	int next_proto;
+	uint8_t *p;
+
+	p = (uint8_t *)rte_pktmbuf_adj(pkt, RTE_ETHER_HDR_LEN);
+	pkt->l2_len = 0;
+	pkt->packet_type &= ~RTE_PTYPE_L3_MASK;
+
+	if (type == PKT_TYPE_PLAIN_IPV4 || type == PKT_TYPE_IPSEC_IPV4) {
+		pkt->l3_len = sizeof(struct ip);
+		pkt->packet_type |= RTE_PTYPE_L3_IPV4;
+		return 0;
+	}
+
+	/* determine l3 header size up to ESP extension */
+	ip6 = (struct rte_ipv6_hdr *)p;
+	next_proto = ip6->proto;
+	l3len = sizeof(*ip6);
+	while (next_proto != IPPROTO_ESP && l3len < pkt->data_len &&
+		(next_proto = rte_ipv6_get_next_ext(p + l3len,
+					next_proto, &ext_len)) >= 0)
+		l3len += ext_len;
+
+	/* drop packet when IPv6 header exceeds first segment length */
+	if (unlikely(l3len > pkt->data_len))
+		return -1;
+
+	pkt->l3_len = l3len;
+	pkt->packet_type |= RTE_PTYPE_L3_IPV6;
+	return 0;
+}
+
+/*
+ * Forward a packet of a lookaside SA to the crypto stage. The crypto stage
+ * is atomic on the flow of the SA, and the eventdev restores the ingress
+ * order of the packets forwarded from an ordered queue, so the packets of
+ * an SA get their sequence numbers, and reach the cryptodev, in order.
+ */
+static inline int
+ev_fwd_crypto_stage(struct lcore_conf_ev_tx_int_port_wrkr *lconf,
+		struct rte_event *ev, struct sa_ctx *sa_ctx, struct ipsec_sa *sa)
+{
+	get_priv(ev->mbuf)->sa = sa;
+
+	ev->queue_id = lconf->cpt_queue_id;
+	ev->sched_type = RTE_SCHED_TYPE_ATOMIC;
+	ev->flow_id = sa - sa_ctx->sa;
+	ev->op = RTE_EVENT_OP_FORWARD;
+	return PKT_NEXT_STAGE;
+}
+
+/* Look up the SA of an ESP packet, to be decrypted in the crypto stage */
+static inline int
+process_ipsec_ev_inbound_lksd(struct lcore_conf_ev_tx_int_port_wrkr *lconf,
+		struct rte_event *ev, enum pkt_type type)
+{
+	struct ipsec_ctx *ctx = &lconf->inbound;
+	struct rte_ipsec_session *ips;
+	struct rte_mbuf *pkt;
+	struct ipsec_sa *sa;
+	void *sa_ptr;
+
+	pkt = ev->mbuf;
+	if (ev_pkt_l2_strip(pkt, type) != 0)
+		goto drop_pkt_and_exit;
+
+	inbound_sa_lookup(ctx->sa_ctx, &pkt, &sa_ptr, 1);
+	sa = ipsec_mask_saptr(sa_ptr);
+	if (sa == NULL)
+		goto drop_pkt_and_exit;
+
+	/* Only the lookaside none SAs are processed by the crypto stage */
+	ips = ipsec_get_primary_session(sa);
+	if (ips->type != RTE_SECURITY_ACTION_TYPE_NONE)
+		goto drop_pkt_and_exit;
+
+	return ev_fwd_crypto_stage(lconf, ev, ctx->sa_ctx, sa);
+
+drop_pkt_and_exit:
+	RTE_LOG(ERR, IPSEC, "Inbound packet dropped\n");
+	rte_pktmbuf_free(pkt);
+	ev->mbuf = NULL;
+	return PKT_DROPPED;
+}
+
+static inline int
+process_ipsec_ev_inbound(struct lcore_conf_ev_tx_int_port_wrkr *lconf,
+		struct rte_event *ev, const uint32_t *sp_res)
 {
+	struct ipsec_ctx *ctx = &lconf->inbound;
+	struct route_table *rt = &lconf->rt;
 	struct ipsec_sa *sa = NULL;
 	struct rte_mbuf *pkt;
 	uint16_t port_id = 0;
@@ -199,6 +308,11 @@ process_ipsec_ev_inbound(struct ipsec_ctx *ctx, struct route_table *rt,
 	/* Check the packet type */
 	type = process_ipsec_get_pkt_type(pkt, &nlp);
 
+	/* ESP packets of lookaside SAs are decrypted by the crypto stage */
+	if ((type == PKT_TYPE_IPSEC_IPV4 || type == PKT_TYPE_IPSEC_IPV6) &&
+	    lconf->cpt_queue_id >= 0)
+		return process_ipsec_ev_inbound_lksd(lconf, ev, type);
+
 	switch (type) {
 	case PKT_TYPE_PLAIN_IPV4:
 		if (pkt->ol_flags & PKT_RX_SEC_OFFLOAD) {
@@ -212,7 +326,7 @@ process_ipsec_ev_inbound(struct ipsec_ctx *ctx, struct route_table *rt,
 		}
 
 		/* Check if we have a match */
-		if (check_sp(ctx->sp4_ctx, nlp, &sa_idx) == 0) {
+		if (check_sp(ctx->sp4_ctx, nlp, sp_res, &sa_idx) == 0) {
 			/* No valid match */
 			goto drop_pkt_and_exit;
 		}
@@ -230,7 +344,7 @@ process_ipsec_ev_inbound(struct ipsec_ctx *ctx, struct route_table *rt,
 		}
 
 		/* Check if we have a match */
-		if (check_sp(ctx->sp6_ctx, nlp, &sa_idx) == 0) {
+		if (check_sp(ctx->sp6_ctx, nlp, sp_res, &sa_idx) == 0) {
 			/* No valid match */
 			goto drop_pkt_and_exit;
 		}
@@ -282,9 +396,11 @@ process_ipsec_ev_inbound(struct ipsec_ctx *ctx, struct route_table *rt,
 }
 
 static inline int
-process_ipsec_ev_outbound(struct ipsec_ctx *ctx, struct route_table *rt,
-		struct rte_event *ev)
+process_ipsec_ev_outbound(struct lcore_conf_ev_tx_int_port_wrkr *lconf,
+		struct rte_event *ev, const uint32_t *sp_res)
 {
+	struct ipsec_ctx *ctx = &lconf->outbound;
+	struct route_table *rt = &lconf->rt;
 	struct rte_ipsec_session *sess;
 	struct sa_ctx *sa_ctx;
 	struct rte_mbuf *pkt;
@@ -303,14 +419,14 @@ process_ipsec_ev_outbound(struct ipsec_ctx *ctx, struct route_table *rt,
 	switch (type) {
 	case PKT_TYPE_PLAIN_IPV4:
 		/* Check if we have a match */
-		if (check_sp(ctx->sp4_ctx, nlp, &sa_idx) == 0) {
+		if (check_sp(ctx->sp4_ctx, nlp, sp_res, &sa_idx) == 0) {
 			/* No valid match */
 			goto drop_pkt_and_exit;
 		}
 		break;
 	case PKT_TYPE_PLAIN_IPV6:
 		/* Check if we have a match */
-		if (check_sp(ctx->sp6_ctx, nlp, &sa_idx) == 0) {
+		if (check_sp(ctx->sp6_ctx, nlp, sp_res, &sa_idx) == 0) {
 			/* No valid match */
 			goto drop_pkt_and_exit;
 		}
@@ -350,6 +466,14 @@ process_ipsec_ev_outbound(struct ipsec_ctx *ctx, struct route_table *rt,
 	/* Get IPsec session */
 	sess = ipsec_get_primary_session(sa);
 
+	/* Lookaside SAs are processed by the crypto stage */
+	if (sess->type == RTE_SECURITY_ACTION_TYPE_NONE &&
+	    lconf->cpt_queue_id >= 0) {
+		if (ev_pkt_l2_strip(pkt, type) != 0)
+			goto drop_pkt_and_exit;
+		return ev_fwd_crypto_stage(lconf, ev, sa_ctx, sa);
+	}
+
 	/* Allow only inline protocol for now */
 	if (sess->type != RTE_SECURITY_ACTION_TYPE_INLINE_PROTOCOL) {
 		RTE_LOG(ERR, IPSEC, "SA type not supported\n");
@@ -381,6 +505,234 @@ process_ipsec_ev_outbound(struct ipsec_ctx *ctx, struct route_table *rt,
 	return PKT_DROPPED;
 }
 
+/*
+ * Create the crypto session of a lookaside SA, with the event the crypto
+ * adapter sends back on the completion of its operations.
+ */
+static int
+ev_crypto_session_init(struct ipsec_ctx *ctx, struct ipsec_sa *sa,
+		struct rte_ipsec_session *ips, const struct rte_event *ev)
+{
+	union rte_event_crypto_metadata m_data;
+	int rc;
+
+	rc = create_lookaside_session(ctx, sa, ips);
+	if (rc != 0)
+		return rc;
+
+	memset(&m_data, 0, sizeof(m_data));
+	m_data.response_info.queue_id = ev->queue_id;
+	m_data.response_info.sched_type = RTE_SCHED_TYPE_ATOMIC;
+	m_data.response_info.flow_id = ev->flow_id;
+	m_data.response_info.op = RTE_EVENT_OP_NEW;
+
+	rc = rte_cryptodev_sym_session_set_user_data(ips->crypto.ses,
+			&m_data, sizeof(m_data));
+	if (rc == 0)
+		rc = rte_ipsec_session_prepare(ips);
+	if (rc != 0) {
+		rte_cryptodev_sym_session_clear(
+				ctx->tbl[sa->cdev_id_qp].id, ips->crypto.ses);
+		rte_cryptodev_sym_session_free(ips->crypto.ses);
+		ips->crypto.ses = NULL;
+	}
+	return rc;
+}
+
+/*
+ * Crypto stage: prepare the crypto operation of a packet, stored in its
+ * private area, and submit it to the cryptodev. The completed operation
+ * comes back as a crypto event, on the same queue.
+ */
+static inline int
+process_ipsec_ev_crypto_stage(struct lcore_conf_ev_tx_int_port_wrkr *lconf,
+		struct rte_event *ev)
+{
+	struct ipsec_mbuf_metadata *priv;
+	struct rte_ipsec_session *ips;
+	struct rte_crypto_op *cop;
+	struct ipsec_ctx *ctx;
+	struct rte_mbuf *pkt;
+	struct cdev_qp *cqp;
+	struct ipsec_sa *sa;
+
+	pkt = ev->mbuf;
+	priv = get_priv(pkt);
+	sa = priv->sa;
+	cop = &priv->cop;
+
+	if (is_unprotected_port(pkt->port))
+		ctx = &lconf->inbound;
+	else
+		ctx = &lconf->outbound;
+
+	/*
+	 * The stage is atomic on the flow of the SA, so a single lcore
+	 * creates its session.
+	 */
+	ips = ipsec_get_primary_session(sa);
+	if (unlikely(ips->crypto.ses == NULL) &&
+	    ev_crypto_session_init(ctx, sa, ips, ev) != 0) {
+		RTE_LOG(ERR, IPSEC, "Cannot create crypto session\n");
+		goto drop_pkt_and_exit;
+	}
+
+	if (rte_ipsec_pkt_crypto_prepare(ips, &pkt, &cop, 1) != 1)
+		goto drop_pkt_and_exit;
+
+	cqp = &ctx->tbl[sa->cdev_id_qp];
+	if (rte_cryptodev_enqueue_burst(cqp->id, cqp->qp, &cop, 1) != 1)
+		goto drop_pkt_and_exit;
+
+	return PKT_POSTED;
+
+drop_pkt_and_exit:
+	RTE_LOG(ERR, IPSEC, "Crypto stage packet dropped\n");
+	rte_pktmbuf_free(pkt);
+	ev->mbuf = NULL;
+	return PKT_DROPPED;
+}
+
+/*
+ * Complete the IPsec processing of a packet from its crypto event, restore
+ * its Ethernet header and route it.
+ */
+static inline int
+process_ipsec_ev_crypto_done(struct lcore_conf_ev_tx_int_port_wrkr *lconf,
+		struct rte_event *ev)
+{
+	struct rte_ipsec_session *ips;
+	struct rte_ether_hdr *ethhdr;
+	struct rte_crypto_op *cop;
+	struct rte_mbuf *pkt;
+	struct ipsec_sa *sa;
+	struct sp_ctx *sp;
+	enum pkt_type type;
+	uint16_t port_id;
+	uint32_t sa_idx;
+	uint8_t *nlp;
+
+	cop = ev->event_ptr;
+	pkt = cop->sym->m_src;
+	ev->mbuf = pkt;
+
+	if (unlikely(cop->status != RTE_CRYPTO_OP_STATUS_SUCCESS))
+		goto drop_pkt_and_exit;
+
+	sa = get_priv(pkt)->sa;
+	ips = ipsec_get_primary_session(sa);
+	if (rte_ipsec_pkt_process(ips, &pkt, 1) != 1)
+		goto drop_pkt_and_exit;
+
+	ethhdr = (struct rte_ether_hdr *)rte_pktmbuf_prepend(pkt,
+			RTE_ETHER_HDR_LEN);
+	if (unlikely(ethhdr == NULL))
+		goto drop_pkt_and_exit;
+	pkt->l2_len = RTE_ETHER_HDR_LEN;
+
+	if ((*rte_pktmbuf_mtod_offset(pkt, uint8_t *, RTE_ETHER_HDR_LEN) >>
+			4) == IPVERSION)
+		ethhdr->ether_type = rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4);
+	else
+		ethhdr->ether_type = rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV6);
+
+	type = process_ipsec_get_pkt_type(pkt, &nlp);
+
+	/* Check the inbound policy of the decrypted packet */
+	if (is_unprotected_port(pkt->port)) {
+		if (type == PKT_TYPE_PLAIN_IPV4)
+			sp = lconf->inbound.sp4_ctx;
+		else if (type == PKT_TYPE_PLAIN_IPV6)
+			sp = lconf->inbound.sp6_ctx;
+		else
+			goto drop_pkt_and_exit;
+
+		if (check_sp(sp, nlp, NULL, &sa_idx) == 0)
+			goto drop_pkt_and_exit;
+
+		if (sa_idx != BYPASS &&
+		    (sa_idx >= lconf->inbound.sa_ctx->nb_sa ||
+		     sa->spi != lconf->inbound.sa_ctx->sa[sa_idx].spi))
+			goto drop_pkt_and_exit;
+	}
+
+	port_id = get_route(pkt, &lconf->rt, type);
+	if (unlikely(port_id == RTE_MAX_ETHPORTS))
+		goto drop_pkt_and_exit;
+
+	/* Update mac addresses */
+	update_mac_addrs(pkt, port_id);
+
+	/* Update the event with the dest port */
+	ipsec_event_pre_forward(pkt, port_id);
+	return PKT_FORWARDED;
+
+drop_pkt_and_exit:
+	RTE_LOG(ERR, IPSEC, "Crypto completed packet dropped\n");
+	rte_pktmbuf_free(pkt);
+	ev->mbuf = NULL;
+	return PKT_DROPPED;
+}
+
+/* Process an event of the app mode workers */
+static inline int
+process_ipsec_ev(struct lcore_conf_ev_tx_int_port_wrkr *lconf,
+		struct rte_event *ev, const uint32_t *sp_res)
+{
+	if (ev->event_type == RTE_EVENT_TYPE_CRYPTODEV)
+		return process_ipsec_ev_crypto_done(lconf, ev);
+
+	if (unlikely(ev->event_type != RTE_EVENT_TYPE_ETHDEV)) {
+		RTE_LOG(ERR, IPSEC, "Invalid event type %u", ev->event_type);
+		return PKT_DROPPED;
+	}
+
+	if (ev->queue_id == lconf->cpt_queue_id)
+		return process_ipsec_ev_crypto_stage(lconf, ev);
+
+	if (is_unprotected_port(ev->mbuf->port))
+		return process_ipsec_ev_inbound(lconf, ev, sp_res);
+
+	return process_ipsec_ev_outbound(lconf, ev, sp_res);
+}
+
+/* Set up the lcore configuration of the app mode workers */
+static void
+ev_app_lconf_init(struct lcore_conf_ev_tx_int_port_wrkr *lconf,
+		uint32_t lcore_id)
+{
+	int32_t socket_id;
+
+	/* Get socket ID */
+	socket_id = rte_lcore_to_socket_id(lcore_id);
+
+	/* Save routing table */
+	lconf->rt.rt4_ctx = socket_ctx[socket_id].rt_ip4;
+	lconf->rt.rt6_ctx = socket_ctx[socket_id].rt_ip6;
+	lconf->inbound.sp4_ctx = socket_ctx[socket_id].sp_ip4_in;
+	lconf->inbound.sp6_ctx = socket_ctx[socket_id].sp_ip6_in;
+	lconf->inbound.sa_ctx = socket_ctx[socket_id].sa_in;
+	lconf->inbound.session_pool = socket_ctx[socket_id].session_pool;
+	lconf->inbound.session_priv_pool =
+			socket_ctx[socket_id].session_priv_pool;
+	lconf->outbound.sp4_ctx = socket_ctx[socket_id].sp_ip4_out;
+	lconf->outbound.sp6_ctx = socket_ctx[socket_id].sp_ip6_out;
+	lconf->outbound.sa_ctx = socket_ctx[socket_id].sa_out;
+	lconf->outbound.session_pool = socket_ctx[socket_id].session_pool;
+	lconf->outbound.session_priv_pool =
+			socket_ctx[socket_id].session_priv_pool;
+
+	/* Save the crypto devices of the lookaside SAs */
+	lconf->cpt_queue_id = RTE_PER_LCORE(ev_cpt_queue_id);
+	if (lconf->cpt_queue_id >= 0) {
+		ipsec_lcore_cdev_ctx_init(lcore_id, &lconf->inbound,
+				&lconf->outbound);
+		if (ipsec_sad_lcore_cache_init(app_sa_prm.cache_sz) != 0)
+			rte_exit(EXIT_FAILURE, "SAD cache init on lcore %u, "
+				"failed\n", lcore_id);
+	}
+}
+
 /*
  * Event mode exposes various operating modes depending on the
  * capabilities of the event device and the operating mode
@@ -388,7 +740,77 @@ process_ipsec_ev_outbound(struct ipsec_ctx *ctx, struct route_table *rt,
  */
 
 /* Workers registered */
-#define IPSEC_EVENTMODE_WORKERS		2
+#define IPSEC_EVENTMODE_WORKERS		3
+
+/* Max events dequeued at once by the burst workers */
+#define IPSEC_EV_BURST_SIZE		32
+
+/* SPD groups of a burst, by direction and address family */
+enum {
+	SP_GRP_IN4,
+	SP_GRP_IN6,
+	SP_GRP_OUT4,
+	SP_GRP_OUT6,
+	SP_GRP_MAX
+};
+
+/*
+ * Classify the plain packets of a burst against their SPD, with a single
+ * ACL call per SPD for all the packets of the burst. The result of each
+ * packet is stored in sp_res, in the order of the events.
+ */
+static inline void
+classify_ev_burst(struct lcore_conf_ev_tx_int_port_wrkr *lconf,
+		struct rte_event ev[], uint16_t nb_ev, uint32_t sp_res[])
+{
+	struct sp_ctx *sp[SP_GRP_MAX] = {
+		[SP_GRP_IN4] = lconf->inbound.sp4_ctx,
+		[SP_GRP_IN6] = lconf->inbound.sp6_ctx,
+		[SP_GRP_OUT4] = lconf->outbound.sp4_ctx,
+		[SP_GRP_OUT6] = lconf->outbound.sp6_ctx,
+	};
+	const uint8_t *nlp[SP_GRP_MAX][IPSEC_EV_BURST_SIZE];
+	uint32_t res[SP_GRP_MAX][IPSEC_EV_BURST_SIZE];
+	uint16_t idx[SP_GRP_MAX][IPSEC_EV_BURST_SIZE];
+	uint16_t nb[SP_GRP_MAX] = { 0 };
+	struct rte_mbuf *pkt;
+	enum pkt_type type;
+	uint8_t *p;
+	uint16_t i, j;
+	int grp;
+
+	for (i = 0; i < nb_ev; i++) {
+		sp_res[i] = DISCARD;
+		if (unlikely(ev[i].event_type != RTE_EVENT_TYPE_ETHDEV) ||
+		    ev[i].queue_id == lconf->cpt_queue_id)
+			continue;
+
+		pkt = ev[i].mbuf;
+		type = process_ipsec_get_pkt_type(pkt, &p);
+		if (type == PKT_TYPE_PLAIN_IPV4)
+			grp = SP_GRP_IN4;
+		else if (type == PKT_TYPE_PLAIN_IPV6)
+			grp = SP_GRP_IN6;
+		else
+			continue;
+		if (!is_unprotected_port(pkt->port))
+			grp += SP_GRP_OUT4;
+		if (sp[grp] == NULL)
+			continue;
+
+		nlp[grp][nb[grp]] = p;
+		idx[grp][nb[grp]++] = i;
+	}
+
+	for (grp = 0; grp < SP_GRP_MAX; grp++) {
+		if (nb[grp] == 0)
+			continue;
+		rte_acl_classify((struct rte_acl_ctx *)sp[grp], nlp[grp],
+				res[grp], nb[grp], DEFAULT_MAX_CATEGORIES);
+		for (j = 0; j < nb[grp]; j++)
+			sp_res[idx[grp][j]] = res[grp][j];
+	}
+}
 
 /*
  * Event mode worker
@@ -500,7 +922,6 @@ ipsec_wrkr_non_burst_int_port_app_mode(struct eh_event_link_info *links,
 	unsigned int nb_rx = 0;
 	struct rte_event ev;
 	uint32_t lcore_id;
-	int32_t socket_id;
 	int ret;
 
 	/* Check if we have links registered for this lcore */
@@ -514,24 +935,8 @@ ipsec_wrkr_non_burst_int_port_app_mode(struct eh_event_link_info *links,
 	/* Get core ID */
 	lcore_id = rte_lcore_id();
 
-	/* Get socket ID */
-	socket_id = rte_lcore_to_socket_id(lcore_id);
-
-	/* Save routing table */
-	lconf.rt.rt4_ctx = socket_ctx[socket_id].rt_ip4;
-	lconf.rt.rt6_ctx = socket_ctx[socket_id].rt_ip6;
-	lconf.inbound.sp4_ctx = socket_ctx[socket_id].sp_ip4_in;
-	lconf.inbound.sp6_ctx = socket_ctx[socket_id].sp_ip6_in;
-	lconf.inbound.sa_ctx = socket_ctx[socket_id].sa_in;
-	lconf.inbound.session_pool = socket_ctx[socket_id].session_pool;
-	lconf.inbound.session_priv_pool =
-			socket_ctx[socket_id].session_priv_pool;
-	lconf.outbound.sp4_ctx = socket_ctx[socket_id].sp_ip4_out;
-	lconf.outbound.sp6_ctx = socket_ctx[socket_id].sp_ip6_out;
-	lconf.outbound.sa_ctx = socket_ctx[socket_id].sa_out;
-	lconf.outbound.session_pool = socket_ctx[socket_id].session_pool;
-	lconf.outbound.session_priv_pool =
-			socket_ctx[socket_id].session_priv_pool;
+	/* Set up the lcore configuration */
+	ev_app_lconf_init(&lconf, lcore_id);
 
 	RTE_LOG(INFO, IPSEC,
 		"Launching event mode worker (non-burst - Tx internal port - "
@@ -557,21 +962,20 @@ ipsec_wrkr_non_burst_int_port_app_mode(struct eh_event_link_info *links,
 		if (nb_rx == 0)
 			continue;
 
-		if (unlikely(ev.event_type != RTE_EVENT_TYPE_ETHDEV)) {
-			RTE_LOG(ERR, IPSEC, "Invalid event type %u",
-				ev.event_type);
-
+		ret = process_ipsec_ev(&lconf, &ev, NULL);
+		if (ret == PKT_NEXT_STAGE) {
+			/* Forward the pkt to the crypto stage */
+			while (rte_event_enqueue_burst(links[0].eventdev_id,
+					links[0].event_port_id, &ev, 1) != 1) {
+				if (force_quit) {
+					rte_pktmbuf_free(ev.mbuf);
+					break;
+				}
+			}
 			continue;
 		}
-
-		if (is_unprotected_port(ev.mbuf->port))
-			ret = process_ipsec_ev_inbound(&lconf.inbound,
-							&lconf.rt, &ev);
-		else
-			ret = process_ipsec_ev_outbound(&lconf.outbound,
-							&lconf.rt, &ev);
-		if (ret != 1)
-			/* The pkt has been dropped */
+		if (ret != PKT_FORWARDED)
+			/* The pkt has been dropped or posted */
 			continue;
 
 		/*
@@ -587,6 +991,101 @@ ipsec_wrkr_non_burst_int_port_app_mode(struct eh_event_link_info *links,
 	}
 }
 
+/*
+ * Event mode worker
+ * Operating parameters : burst - Tx internal port - app mode
+ */
+static void
+ipsec_wrkr_burst_int_port_app_mode(struct eh_event_link_info *links,
+		uint8_t nb_links)
+{
+	struct lcore_conf_ev_tx_int_port_wrkr lconf;
+	struct rte_event ev_next[IPSEC_EV_BURST_SIZE];
+	struct rte_event ev[IPSEC_EV_BURST_SIZE];
+	uint32_t sp_res[IPSEC_EV_BURST_SIZE];
+	uint16_t nb_rx, nb_tx, nb_next, nb_enq, i;
+	uint32_t lcore_id;
+	int ret;
+
+	/* Check if we have links registered for this lcore */
+	if (nb_links == 0) {
+		/* No links registered - exit */
+		return;
+	}
+
+	/* We have valid links */
+
+	/* Get core ID */
+	lcore_id = rte_lcore_id();
+
+	/* Set up the lcore configuration */
+	ev_app_lconf_init(&lconf, lcore_id);
+
+	RTE_LOG(INFO, IPSEC,
+		"Launching event mode worker (burst - Tx internal port - "
+		"app mode) on lcore %d\n", lcore_id);
+
+	/* Check if it's single link */
+	if (nb_links != 1) {
+		RTE_LOG(INFO, IPSEC,
+			"Multiple links not supported. Using first link\n");
+	}
+
+	RTE_LOG(INFO, IPSEC, " -- lcoreid=%u event_port_id=%u\n", lcore_id,
+		links[0].event_port_id);
+
+	while (!force_quit) {
+		/* Read packets from event queues */
+		nb_rx = rte_event_dequeue_burst(links[0].eventdev_id,
+				links[0].event_port_id,
+				ev,			/* events */
+				IPSEC_EV_BURST_SIZE,	/* nb_events */
+				0			/* timeout_ticks */);
+
+		if (nb_rx == 0)
+			continue;
+
+		/* Look up the SPD of all the packets at once */
+		classify_ev_burst(&lconf, ev, nb_rx, sp_res);
+
+		nb_tx = 0;
+		nb_next = 0;
+		for (i = 0; i < nb_rx; i++) {
+			ret = process_ipsec_ev(&lconf, &ev[i], &sp_res[i]);
+			if (ret == PKT_FORWARDED)
+				ev[nb_tx++] = ev[i];
+			else if (ret == PKT_NEXT_STAGE)
+				ev_next[nb_next++] = ev[i];
+			/* Else the pkt has been dropped or posted */
+		}
+
+		/* Forward the pkts of lookaside SAs to the crypto stage */
+		nb_enq = 0;
+		while (nb_enq < nb_next && !force_quit)
+			nb_enq += rte_event_enqueue_burst(links[0].eventdev_id,
+					links[0].event_port_id,
+					&ev_next[nb_enq], nb_next - nb_enq);
+		for (i = nb_enq; i < nb_next; i++)
+			rte_pktmbuf_free(ev_next[i].mbuf);
+
+		/*
+		 * Since tx internal port is available, events can be
+		 * directly enqueued to the adapter and it would be
+		 * internally submitted to the eth device.
+		 */
+		nb_enq = 0;
+		while (nb_enq < nb_tx && !force_quit)
+			nb_enq += rte_event_eth_tx_adapter_enqueue(
+					links[0].eventdev_id,
+					links[0].event_port_id,
+					&ev[nb_enq],	/* events */
+					nb_tx - nb_enq,	/* nb_events */
+					0		/* flags */);
+		for (i = nb_enq; i < nb_tx; i++)
+			rte_pktmbuf_free(ev[i].mbuf);
+	}
+}
+
 static uint8_t
 ipsec_eventmode_populate_wrkr_params(struct eh_app_worker_params *wrkrs)
 {
@@ -609,6 +1108,14 @@ ipsec_eventmode_populate_wrkr_params(struct eh_app_worker_params *wrkrs)
 	wrkr->cap.tx_internal_port = EH_TX_TYPE_INTERNAL_PORT;
 	wrkr->cap.ipsec_mode = EH_IPSEC_MODE_TYPE_APP;
 	wrkr->worker_thread = ipsec_wrkr_non_burst_int_port_app_mode;
+	wrkr++;
+	nb_wrkr_param++;
+
+	/* Burst - Tx internal port - app mode */
+	wrkr->cap.burst = EH_RX_TYPE_BURST;
+	wrkr->cap.tx_internal_port = EH_TX_TYPE_INTERNAL_PORT;
+	wrkr->cap.ipsec_mode = EH_IPSEC_MODE_TYPE_APP;
+	wrkr->worker_thread = ipsec_wrkr_burst_int_port_app_mode;
 	nb_wrkr_param++;
 
 	return nb_wrkr_param;
@@ -624,6 +1131,12 @@ ipsec_eventmode_worker(struct eh_conf *conf)
 	/* Populate l2fwd_wrkr params */
 	nb_wrkr_param = ipsec_eventmode_populate_wrkr_params(ipsec_wrkr);
 
+	/* Save the queue of the crypto stage */
+	if (conf->enable_event_crypto_adapter)
+		RTE_PER_LCORE(ev_cpt_queue_id) = eh_get_crypto_queue(conf, 0);
+	else
+		RTE_PER_LCORE(ev_cpt_queue_id) = -1;
+
 	/*
 	 * Launch correct worker after checking
 	 * the event device's capabilities.
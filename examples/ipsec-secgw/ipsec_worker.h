@@ -17,7 +17,8 @@ enum pkt_type {
 enum {
 	PKT_DROPPED = 0,
 	PKT_FORWARDED,
-	PKT_POSTED	/* for lookaside case */
+	PKT_POSTED,	/* for lookaside case */
+	PKT_NEXT_STAGE	/* forwarded to the next event queue */
 };
 
 struct route_table {
@@ -32,10 +33,19 @@ struct lcore_conf_ev_tx_int_port_wrkr {
 	struct ipsec_ctx inbound;
 	struct ipsec_ctx outbound;
 	struct route_table rt;
+	int16_t cpt_queue_id;
+	/**< Event queue of the crypto stage, -1 without lookaside SA */
 } __rte_cache_aligned;
 
 void ipsec_poll_mode_worker(void);
 
+/*
+ * Set the cryptodev queue pairs mapped to an lcore in the inbound and
+ * outbound contexts of an event mode worker.
+ */
+void ipsec_lcore_cdev_ctx_init(uint32_t lcore_id, struct ipsec_ctx *inbound,
+		struct ipsec_ctx *outbound);
+
 int ipsec_launch_one_lcore(void *args);
 
 #endif /* _IPSEC_WORKER_H_ */
@@ -86,7 +86,7 @@ ipsec_sad_lcore_cache_init(uint32_t nb_cache_ent)
 	cache = &RTE_PER_LCORE(sad_cache);
 
 	cache_elem = rte_align32pow2(nb_cache_ent);
-	cache_mem_sz = sizeof(struct ipsec_sa *) * cache_elem;
+	cache_mem_sz = sizeof(struct ipsec_sad_cache_ent) * cache_elem;
 
 	if (cache_mem_sz != 0) {
 		cache->v4 = rte_zmalloc_socket(NULL, cache_mem_sz,
@@ -10,9 +10,18 @@
 #define SA_CACHE_SZ	128
 #define SPI2IDX(spi, mask)	((spi) & (mask))
 
+/*
+ * SAD cache entry, tagged with the SPI of the SA so that a miss is
+ * detected without touching the SA itself.
+ */
+struct ipsec_sad_cache_ent {
+	uint32_t spi;
+	struct ipsec_sa *sa;
+};
+
 struct ipsec_sad_cache {
-	struct ipsec_sa **v4;
-	struct ipsec_sa **v6;
+	struct ipsec_sad_cache_ent *v4;
+	struct ipsec_sad_cache_ent *v6;
 	uint32_t mask;
 };
 
@@ -45,7 +54,8 @@ cmp_sa_key(struct ipsec_sa *sa, int is_v4, struct rte_ipv4_hdr *ipv4,
 }
 
 static inline void
-sa_cache_update(struct ipsec_sa **sa_cache, struct ipsec_sa *sa, uint32_t mask)
+sa_cache_update(struct ipsec_sad_cache_ent *sa_cache, struct ipsec_sa *sa,
+	uint32_t mask)
 {
 	uint32_t cache_idx;
 
@@ -54,7 +64,23 @@ sa_cache_update(struct ipsec_sa **sa_cache, struct ipsec_sa *sa, uint32_t mask)
 		return;
 
 	cache_idx = SPI2IDX(sa->spi, mask);
-	sa_cache[cache_idx] = sa;
+	sa_cache[cache_idx].spi = sa->spi;
+	sa_cache[cache_idx].sa = sa;
+}
+
+/* Return the cached SA of the SPI, NULL on a miss. */
+static inline struct ipsec_sa *
+sa_cache_lookup(const struct ipsec_sad_cache_ent *sa_cache, uint32_t spi,
+	uint32_t mask)
+{
+	const struct ipsec_sad_cache_ent *ent;
+
+	/* SAD cache is disabled */
+	if (mask == 0)
+		return NULL;
+
+	ent = &sa_cache[SPI2IDX(spi, mask)];
+	return (ent->spi == spi) ? ent->sa : NULL;
 }
 
 static inline void
@@ -74,7 +100,7 @@ sad_lookup(struct ipsec_sad *sad, struct rte_mbuf *pkts[],
 	const union rte_ipsec_sad_key	*keys_v6[nb_pkts];
 	void *v4_res[nb_pkts];
 	void *v6_res[nb_pkts];
-	uint32_t spi, cache_idx;
+	uint32_t spi;
 	struct ipsec_sad_cache *cache;
 	struct ipsec_sa *cached_sa;
 	uint16_t udp_hdr_len = 0;
@@ -95,18 +121,16 @@ sad_lookup(struct ipsec_sad *sad, struct rte_mbuf *pkts[],
 
 		is_ipv4 = pkts[i]->packet_type & RTE_PTYPE_L3_IPV4;
 		spi = rte_be_to_cpu_32(esp->spi);
-		cache_idx = SPI2IDX(spi, cache->mask);
 
 		if (is_ipv4) {
-			cached_sa = (cache->mask != 0) ?
-				cache->v4[cache_idx] : NULL;
+			cached_sa = sa_cache_lookup(cache->v4, spi,
+				cache->mask);
 			/* check SAD cache entry */
-			if ((cached_sa != NULL) && (cached_sa->spi == spi)) {
-				if (cmp_sa_key(cached_sa, 1, ipv4, ipv6)) {
-					/* cache hit */
-					sa[i] = cached_sa;
-					continue;
-				}
+			if ((cached_sa != NULL) &&
+					cmp_sa_key(cached_sa, 1, ipv4, ipv6)) {
+				/* cache hit */
+				sa[i] = cached_sa;
+				continue;
 			}
 			/*
 			 * cache miss
@@ -119,13 +143,12 @@ sad_lookup(struct ipsec_sad *sad, struct rte_mbuf *pkts[],
 						&v4[nb_v4];
 			v4_idxes[nb_v4++] = i;
 		} else {
-			cached_sa = (cache->mask != 0) ?
-				cache->v6[cache_idx] : NULL;
-			if ((cached_sa != NULL) && (cached_sa->spi == spi)) {
-				if (cmp_sa_key(cached_sa, 0, ipv4, ipv6)) {
-					sa[i] = cached_sa;
-					continue;
-				}
+			cached_sa = sa_cache_lookup(cache->v6, spi,
+				cache->mask);
+			if ((cached_sa != NULL) &&
+					cmp_sa_key(cached_sa, 0, ipv4, ipv6)) {
+				sa[i] = cached_sa;
+				continue;
 			}
 			v6[nb_v6].spi = esp->spi;
 			memcpy(v6[nb_v6].dip, ipv6->dst_addr,
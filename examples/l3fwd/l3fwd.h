@@ -90,6 +90,13 @@ extern uint32_t enabled_port_mask;
 extern int ipv6; /**< ipv6 is false by default. */
 extern uint32_t hash_entry_number;
 
+/* Used only in FIB multi-table mode. */
+#define L3FWD_MAX_VRF 16
+extern uint16_t nb_vrf; /**< Number of VRF tables, 0 for a single table. */
+extern uint8_t port_vrf[RTE_MAX_ETHPORTS]; /**< VRF of the ingress ports. */
+extern int vrf_vlan; /**< VRF selected by the VLAN ID of tagged packets. */
+extern int ecmp_on; /**< IPv4 routes balanced on two ports by RSS hash. */
+
 extern xmm_t val_eth[RTE_MAX_ETHPORTS];
 
 extern struct lcore_conf lcore_conf[RTE_MAX_LCORE];
@@ -221,6 +228,10 @@ int
 lpm_event_main_loop_tx_q(__rte_unused void *dummy);
 int
 lpm_event_main_loop_tx_q_burst(__rte_unused void *dummy);
+int
+lpm_event_main_loop_tx_d_vector(__rte_unused void *dummy);
+int
+lpm_event_main_loop_tx_q_vector(__rte_unused void *dummy);
 
 int
 em_event_main_loop_tx_d(__rte_unused void *dummy);
@@ -239,6 +250,10 @@ int
 fib_event_main_loop_tx_q(__rte_unused void *dummy);
 int
 fib_event_main_loop_tx_q_burst(__rte_unused void *dummy);
+int
+fib_event_main_loop_tx_d_vector(__rte_unused void *dummy);
+int
+fib_event_main_loop_tx_q_vector(__rte_unused void *dummy);
 
 
 /* Return ipv4/ipv6 fwd lookup struct for LPM, EM or FIB. */
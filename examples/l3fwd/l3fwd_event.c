@@ -4,6 +4,7 @@
 
 #include <stdbool.h>
 #include <getopt.h>
+#include <inttypes.h>
 
 #include <rte_malloc.h>
 
@@ -30,6 +31,8 @@ l3fwd_get_eventdev_rsrc(void)
 	if (rsrc != NULL) {
 		rsrc->sched_type = RTE_SCHED_TYPE_ATOMIC;
 		rsrc->eth_rx_queues = 1;
+		rsrc->vector_size = L3FWD_EVENT_VECTOR_SIZE_DEFAULT;
+		rsrc->vector_tmo_ns = L3FWD_EVENT_VECTOR_TMO_NS_DEFAULT;
 		return rsrc;
 	}
 
@@ -192,6 +195,69 @@ l3fwd_event_capability_setup(void)
 		l3fwd_event_set_internal_port_ops(&evt_rsrc->ops);
 }
 
+static void
+l3fwd_event_vector_pool_setup(void)
+{
+	struct l3fwd_event_resources *evt_rsrc = l3fwd_get_eventdev_rsrc();
+	uint16_t nb_ports = rte_eth_dev_count_avail();
+	unsigned int nb_lcores = rte_lcore_count();
+	unsigned int nb_vec;
+
+	/*
+	 * The Rx adapter may flush vectors of a single packet on timeout,
+	 * so there are as many vectors as packets in flight at most.
+	 */
+	nb_vec = RTE_MAX(nb_ports * evt_rsrc->eth_rx_queues *
+			 RTE_TEST_RX_DESC_DEFAULT +
+			 nb_lcores * MEMPOOL_CACHE_SIZE, 8192u);
+	evt_rsrc->vector_pool = rte_event_vector_pool_create("vector_pool",
+			nb_vec, MEMPOOL_CACHE_SIZE, evt_rsrc->vector_size,
+			rte_socket_id());
+	if (evt_rsrc->vector_pool == NULL)
+		rte_exit(EXIT_FAILURE, "Unable to create the event vector pool\n");
+}
+
+/* Configure the vectorization of the Rx queues of a port in an Rx adapter. */
+void
+l3fwd_event_vector_setup(uint8_t rx_adptr_id, uint16_t port_id)
+{
+	struct l3fwd_event_resources *evt_rsrc = l3fwd_get_eventdev_rsrc();
+	struct rte_event_eth_rx_adapter_event_vector_config vec_conf;
+	struct rte_event_eth_rx_adapter_vector_limits limits;
+	int ret;
+
+	ret = rte_event_eth_rx_adapter_vector_limits_get(evt_rsrc->event_d_id,
+			port_id, &limits);
+	if (ret)
+		rte_panic("Failed to get vector limits of port %d\n", port_id);
+
+	if (evt_rsrc->vector_size < limits.min_sz ||
+	    evt_rsrc->vector_size > limits.max_sz ||
+	    (limits.log2_sz && !rte_is_power_of_2(evt_rsrc->vector_size)))
+		rte_exit(EXIT_FAILURE,
+			 "Event vector size %u not supported by port %d, "
+			 "min %u, max %u%s\n", evt_rsrc->vector_size, port_id,
+			 limits.min_sz, limits.max_sz,
+			 limits.log2_sz ? ", power of 2" : "");
+	if (evt_rsrc->vector_tmo_ns < limits.min_timeout_ns ||
+	    evt_rsrc->vector_tmo_ns > limits.max_timeout_ns)
+		rte_exit(EXIT_FAILURE,
+			 "Event vector timeout %"PRIu64" ns not supported by "
+			 "port %d, min %"PRIu64", max %"PRIu64"\n",
+			 evt_rsrc->vector_tmo_ns, port_id,
+			 limits.min_timeout_ns, limits.max_timeout_ns);
+
+	memset(&vec_conf, 0, sizeof(vec_conf));
+	vec_conf.vector_sz = evt_rsrc->vector_size;
+	vec_conf.vector_timeout_ns = evt_rsrc->vector_tmo_ns;
+	vec_conf.vector_mp = evt_rsrc->vector_pool;
+	ret = rte_event_eth_rx_adapter_queue_event_vector_config(rx_adptr_id,
+			port_id, -1, &vec_conf);
+	if (ret)
+		rte_panic("Failed to configure event vectors of port %d\n",
+			  port_id);
+}
+
 int
 l3fwd_get_free_event_port(struct l3fwd_event_resources *evt_rsrc)
 {
@@ -215,11 +281,15 @@ void
 l3fwd_event_resource_setup(struct rte_eth_conf *port_conf)
 {
 	struct l3fwd_event_resources *evt_rsrc = l3fwd_get_eventdev_rsrc();
-	const event_loop_cb lpm_event_loop[2][2] = {
-		[0][0] = lpm_event_main_loop_tx_d,
-		[0][1] = lpm_event_main_loop_tx_d_burst,
-		[1][0] = lpm_event_main_loop_tx_q,
-		[1][1] = lpm_event_main_loop_tx_q_burst,
+	const event_loop_cb lpm_event_loop[2][2][2] = {
+		[0][0][0] = lpm_event_main_loop_tx_d,
+		[0][0][1] = lpm_event_main_loop_tx_d_burst,
+		[0][1][0] = lpm_event_main_loop_tx_q,
+		[0][1][1] = lpm_event_main_loop_tx_q_burst,
+		[1][0][0] = lpm_event_main_loop_tx_d_vector,
+		[1][0][1] = lpm_event_main_loop_tx_d_vector,
+		[1][1][0] = lpm_event_main_loop_tx_q_vector,
+		[1][1][1] = lpm_event_main_loop_tx_q_vector,
 	};
 	const event_loop_cb em_event_loop[2][2] = {
 		[0][0] = em_event_main_loop_tx_d,
@@ -227,11 +297,15 @@ l3fwd_event_resource_setup(struct rte_eth_conf *port_conf)
 		[1][0] = em_event_main_loop_tx_q,
 		[1][1] = em_event_main_loop_tx_q_burst,
 	};
-	const event_loop_cb fib_event_loop[2][2] = {
-		[0][0] = fib_event_main_loop_tx_d,
-		[0][1] = fib_event_main_loop_tx_d_burst,
-		[1][0] = fib_event_main_loop_tx_q,
-		[1][1] = fib_event_main_loop_tx_q_burst,
+	const event_loop_cb fib_event_loop[2][2][2] = {
+		[0][0][0] = fib_event_main_loop_tx_d,
+		[0][0][1] = fib_event_main_loop_tx_d_burst,
+		[0][1][0] = fib_event_main_loop_tx_q,
+		[0][1][1] = fib_event_main_loop_tx_q_burst,
+		[1][0][0] = fib_event_main_loop_tx_d_vector,
+		[1][0][1] = fib_event_main_loop_tx_d_vector,
+		[1][1][0] = fib_event_main_loop_tx_q_vector,
+		[1][1][1] = fib_event_main_loop_tx_q_vector,
 	};
 	uint32_t event_queue_cfg;
 	int ret;
@@ -248,6 +322,10 @@ l3fwd_event_resource_setup(struct rte_eth_conf *port_conf)
 	/* Ethernet device configuration */
 	l3fwd_eth_dev_port_setup(port_conf);
 
+	/* Event vector pool, for the Rx adapters */
+	if (evt_rsrc->vector_enabled)
+		l3fwd_event_vector_pool_setup();
+
 	/* Event device configuration */
 	event_queue_cfg = evt_rsrc->ops.event_device_setup();
 
@@ -265,12 +343,14 @@ l3fwd_event_resource_setup(struct rte_eth_conf *port_conf)
 	if (ret < 0)
 		rte_exit(EXIT_FAILURE, "Error in starting eventdev");
 
-	evt_rsrc->ops.lpm_event_loop = lpm_event_loop[evt_rsrc->tx_mode_q]
-						       [evt_rsrc->has_burst];
+	evt_rsrc->ops.lpm_event_loop =
+		lpm_event_loop[evt_rsrc->vector_enabled][evt_rsrc->tx_mode_q]
+			      [evt_rsrc->has_burst];
 
 	evt_rsrc->ops.em_event_loop = em_event_loop[evt_rsrc->tx_mode_q]
 						       [evt_rsrc->has_burst];
 
-	evt_rsrc->ops.fib_event_loop = fib_event_loop[evt_rsrc->tx_mode_q]
-						       [evt_rsrc->has_burst];
+	evt_rsrc->ops.fib_event_loop =
+		fib_event_loop[evt_rsrc->vector_enabled][evt_rsrc->tx_mode_q]
+			      [evt_rsrc->has_burst];
 }
@@ -18,6 +18,10 @@
 #define L3FWD_EVENT_BURST      0x2
 #define L3FWD_EVENT_TX_DIRECT  0x4
 #define L3FWD_EVENT_TX_ENQ     0x8
+#define L3FWD_EVENT_VECTOR     0x10
+
+#define L3FWD_EVENT_VECTOR_SIZE_DEFAULT 256
+#define L3FWD_EVENT_VECTOR_TMO_NS_DEFAULT 100000
 
 typedef uint32_t (*event_device_setup_cb)(void);
 typedef void (*event_queue_setup_cb)(uint32_t event_queue_cfg);
@@ -76,6 +80,10 @@ struct l3fwd_event_resources {
 	uint8_t has_burst;
 	uint8_t enabled;
 	uint8_t eth_rx_queues;
+	uint8_t vector_enabled;
+	uint16_t vector_size;
+	uint64_t vector_tmo_ns;
+	struct rte_mempool *vector_pool;
 };
 
 struct l3fwd_event_resources *l3fwd_get_eventdev_rsrc(void);
@@ -83,5 +91,47 @@ void l3fwd_event_resource_setup(struct rte_eth_conf *port_conf);
 int l3fwd_get_free_event_port(struct l3fwd_event_resources *eventdev_rsrc);
 void l3fwd_event_set_generic_ops(struct l3fwd_event_setup_ops *ops);
 void l3fwd_event_set_internal_port_ops(struct l3fwd_event_setup_ops *ops);
+void l3fwd_event_vector_setup(uint8_t rx_adptr_id, uint16_t port_id);
+
+/*
+ * Prepare an event vector for Tx once its packets have their destination
+ * port in mbuf->port: drop the packets without one, set the vector port if
+ * all the packets go to the same port, or else the Tx queue of each packet.
+ * Return the number of packets left, the vector is freed if none.
+ */
+static inline uint16_t
+l3fwd_event_vector_tx_prepare(struct rte_event_vector *vec, uint16_t txq)
+{
+	struct rte_mbuf **mbufs = vec->mbufs;
+	uint16_t i, nb = 0;
+	uint16_t port;
+
+	for (i = 0; i < vec->nb_elem; i++) {
+		if (unlikely(mbufs[i]->port == BAD_PORT)) {
+			rte_pktmbuf_free(mbufs[i]);
+			continue;
+		}
+		mbufs[nb++] = mbufs[i];
+	}
+	vec->nb_elem = nb;
+	if (unlikely(nb == 0)) {
+		rte_mempool_put(rte_mempool_from_obj(vec), vec);
+		return 0;
+	}
+
+	port = mbufs[0]->port;
+	for (i = 1; i < nb && mbufs[i]->port == port; i++)
+		;
+	if (i == nb) {
+		vec->attr_valid = 1;
+		vec->port = port;
+		vec->queue = txq;
+	} else {
+		vec->attr_valid = 0;
+		for (i = 0; i < nb; i++)
+			rte_event_eth_tx_adapter_txq_set(mbufs[i], txq);
+	}
+	return nb;
+}
 
 #endif /* __L3FWD_EVENTDEV_H__ */
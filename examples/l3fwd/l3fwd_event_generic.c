@@ -223,6 +223,9 @@ l3fwd_rx_tx_adapter_setup_generic(void)
 
 	/* Configure user requested sched type */
 	eth_q_conf.ev.sched_type = evt_rsrc->sched_type;
+	if (evt_rsrc->vector_enabled)
+		eth_q_conf.rx_queue_flags |=
+			RTE_EVENT_ETH_RX_ADAPTER_QUEUE_EVENT_VECTOR;
 	RTE_ETH_FOREACH_DEV(port_id) {
 		if ((evt_rsrc->port_mask & (1 << port_id)) == 0)
 			continue;
@@ -231,6 +234,8 @@ l3fwd_rx_tx_adapter_setup_generic(void)
 							 -1, &eth_q_conf);
 		if (ret)
 			rte_panic("Failed to add queues to Rx adapter\n");
+		if (evt_rsrc->vector_enabled)
+			l3fwd_event_vector_setup(rx_adptr_id, port_id);
 		if (i < evt_rsrc->evq.nb_queues)
 			i++;
 	}
@@ -199,6 +199,9 @@ l3fwd_rx_tx_adapter_setup_internal_port(void)
 
 	memset(&eth_q_conf, 0, sizeof(eth_q_conf));
 	eth_q_conf.ev.priority = RTE_EVENT_DEV_PRIORITY_NORMAL;
+	if (evt_rsrc->vector_enabled)
+		eth_q_conf.rx_queue_flags |=
+			RTE_EVENT_ETH_RX_ADAPTER_QUEUE_EVENT_VECTOR;
 
 	RTE_ETH_FOREACH_DEV(port_id) {
 		if ((evt_rsrc->port_mask & (1 << port_id)) == 0)
@@ -232,6 +235,8 @@ l3fwd_rx_tx_adapter_setup_internal_port(void)
 							 -1, &eth_q_conf);
 		if (ret)
 			rte_panic("Failed to add queues to Rx adapter\n");
+		if (evt_rsrc->vector_enabled)
+			l3fwd_event_vector_setup(adapter_id, port_id);
 
 		ret = rte_event_eth_rx_adapter_start(adapter_id);
 		if (ret)
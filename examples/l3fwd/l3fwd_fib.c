@@ -40,6 +40,20 @@
 static struct rte_fib *ipv4_l3fwd_fib_lookup_struct[NB_SOCKETS];
 static struct rte_fib6 *ipv6_l3fwd_fib_lookup_struct[NB_SOCKETS];
 
+/*
+ * Tables of the multi-table mode, one pair per VRF. The lookup structs
+ * of the lcores then point to the tables of their socket.
+ */
+struct fib_vrf_tables {
+	struct rte_fib *ipv4[L3FWD_MAX_VRF];
+	struct rte_fib6 *ipv6[L3FWD_MAX_VRF];
+};
+
+static struct fib_vrf_tables fib_vrf_lookup_struct[NB_SOCKETS];
+
+/* Number of hash buckets of the ECMP next hop groups. */
+#define FIB_ECMP_BUCKETS 16
+
 /* Parse packet type and ip address. */
 static inline void
 fib_parse_packet(struct rte_mbuf *mbuf,
@@ -69,6 +83,114 @@ fib_parse_packet(struct rte_mbuf *mbuf,
 	}
 }
 
+/* VRF of a packet, from its stripped VLAN ID or else its ingress port. */
+static inline uint16_t
+fib_pkt_vrf(const struct rte_mbuf *mbuf)
+{
+	if (vrf_vlan && (mbuf->ol_flags & PKT_RX_VLAN_STRIPPED))
+		return (mbuf->vlan_tci & 0xfff) % nb_vrf;
+	return port_vrf[mbuf->port];
+}
+
+/*
+ * Remove the packets of the VRF of the first packet left in the todo mask,
+ * store their indexes in idx and their number in n, and return the VRF.
+ */
+static inline uint16_t
+fib_vrf_group(const uint16_t *vrf_arr, uint32_t cnt, uint64_t *todo,
+		uint16_t *idx, uint32_t *n)
+{
+	uint32_t i = rte_bsf64(*todo);
+	uint16_t vrf = vrf_arr[i];
+
+	*n = 0;
+	for (; i < cnt; i++) {
+		if ((*todo & (UINT64_C(1) << i)) && vrf_arr[i] == vrf) {
+			idx[(*n)++] = i;
+			*todo &= ~(UINT64_C(1) << i);
+		}
+	}
+	return vrf;
+}
+
+/* Lookup IPv4 hops, the ECMP paths being selected by the RSS hash. */
+static inline void
+fib_vrf_lookup_ipv4(struct rte_fib *fib, uint32_t *ips,
+		const uint32_t *hashes, uint64_t *hops, uint32_t n)
+{
+	if (ecmp_on)
+		rte_fib_lookup_bulk_hash(fib, ips, hashes, hops, n);
+	else
+		rte_fib_lookup_bulk(fib, ips, hops, n);
+}
+
+/*
+ * Lookup the parsed packets in the tables of their VRF. The packets of a
+ * VRF are looked up in bulk together, which is the whole burst when the
+ * VRF is selected by the ingress port.
+ */
+static inline void
+fib_vrf_lookup(const struct fib_vrf_tables *tables,
+		struct rte_mbuf **mbufs, const uint8_t *type_arr, int nb,
+		uint32_t *ipv4_arr, uint32_t ipv4_cnt,
+		uint8_t ipv6_arr[][RTE_FIB6_IPV6_ADDR_SIZE], uint32_t ipv6_cnt,
+		uint64_t *hopsv4, uint64_t *hopsv6)
+{
+	uint16_t vrfv4[nb], vrfv6[nb];
+	uint32_t hashv4[nb];
+	uint32_t ips[nb], hashes[nb];
+	uint8_t ips6[nb][RTE_FIB6_IPV6_ADDR_SIZE];
+	uint64_t hops[nb];
+	uint16_t idx[nb];
+	uint32_t cntv4 = 0, cntv6 = 0;
+	uint32_t j, n;
+	uint64_t todo;
+	uint16_t vrf;
+	int i;
+
+	/* The hash is 0 if the port does not deliver it. */
+	for (i = 0; i < nb; i++) {
+		if (type_arr[i]) {
+			vrfv4[cntv4] = fib_pkt_vrf(mbufs[i]);
+			hashv4[cntv4++] = mbufs[i]->hash.rss;
+		} else {
+			vrfv6[cntv6++] = fib_pkt_vrf(mbufs[i]);
+		}
+	}
+
+	todo = (UINT64_C(1) << ipv4_cnt) - 1;
+	while (todo != 0) {
+		vrf = fib_vrf_group(vrfv4, ipv4_cnt, &todo, idx, &n);
+		if (n == ipv4_cnt) {
+			fib_vrf_lookup_ipv4(tables->ipv4[vrf], ipv4_arr,
+					hashv4, hopsv4, n);
+			break;
+		}
+		for (j = 0; j < n; j++) {
+			ips[j] = ipv4_arr[idx[j]];
+			hashes[j] = hashv4[idx[j]];
+		}
+		fib_vrf_lookup_ipv4(tables->ipv4[vrf], ips, hashes, hops, n);
+		for (j = 0; j < n; j++)
+			hopsv4[idx[j]] = hops[j];
+	}
+
+	todo = (UINT64_C(1) << ipv6_cnt) - 1;
+	while (todo != 0) {
+		vrf = fib_vrf_group(vrfv6, ipv6_cnt, &todo, idx, &n);
+		if (n == ipv6_cnt) {
+			rte_fib6_lookup_bulk(tables->ipv6[vrf], ipv6_arr,
+					hopsv6, n);
+			break;
+		}
+		for (j = 0; j < n; j++)
+			rte_mov16(ips6[j], ipv6_arr[idx[j]]);
+		rte_fib6_lookup_bulk(tables->ipv6[vrf], ips6, hops, n);
+		for (j = 0; j < n; j++)
+			hopsv6[idx[j]] = hops[j];
+	}
+}
+
 /*
  * If the machine does not have SSE, NEON or PPC 64 then the packets
  * are sent one at a time using send_single_packet()
@@ -139,15 +261,22 @@ fib_send_packets(int nb_rx, struct rte_mbuf **pkts_burst,
 				ipv6_arr[ipv6_cnt], &ipv6_cnt,
 				&type_arr[i]);
 
-	/* Lookup IPv4 hops if IPv4 packets are present. */
-	if (likely(ipv4_cnt > 0))
-		rte_fib_lookup_bulk(qconf->ipv4_lookup_struct,
-				ipv4_arr, hopsv4, ipv4_cnt);
+	if (nb_vrf != 0) {
+		/* Lookup hops in the tables of the packet VRFs. */
+		fib_vrf_lookup(qconf->ipv4_lookup_struct, pkts_burst,
+				type_arr, nb_rx, ipv4_arr, ipv4_cnt,
+				ipv6_arr, ipv6_cnt, hopsv4, hopsv6);
+	} else {
+		/* Lookup IPv4 hops if IPv4 packets are present. */
+		if (likely(ipv4_cnt > 0))
+			rte_fib_lookup_bulk(qconf->ipv4_lookup_struct,
+					ipv4_arr, hopsv4, ipv4_cnt);
 
-	/* Lookup IPv6 hops if IPv6 packets are present. */
-	if (ipv6_cnt > 0)
-		rte_fib6_lookup_bulk(qconf->ipv6_lookup_struct,
-				ipv6_arr, hopsv6, ipv6_cnt);
+		/* Lookup IPv6 hops if IPv6 packets are present. */
+		if (ipv6_cnt > 0)
+			rte_fib6_lookup_bulk(qconf->ipv6_lookup_struct,
+					ipv6_arr, hopsv6, ipv6_cnt);
+	}
 
 	/* Add IPv4 and IPv6 hops to one array depending on type. */
 	for (i = 0; i < nb_rx; i++) {
@@ -250,6 +379,7 @@ fib_event_loop(struct l3fwd_event_resources *evt_rsrc,
 	const uint8_t event_d_id = evt_rsrc->event_d_id;
 	const uint16_t deq_len = evt_rsrc->deq_depth;
 	struct rte_event events[MAX_PKT_BURST];
+	struct rte_mbuf *mbufs[MAX_PKT_BURST];
 	struct lcore_conf *lconf;
 	unsigned int lcore_id;
 	int nb_enq, nb_deq, i;
@@ -329,15 +459,24 @@ fib_event_loop(struct l3fwd_event_resources *evt_rsrc,
 					&type_arr[i]);
 		}
 
-		/* Lookup IPv4 hops if IPv4 packets are present. */
-		if (likely(ipv4_cnt > 0))
-			rte_fib_lookup_bulk(lconf->ipv4_lookup_struct,
-					ipv4_arr, hopsv4, ipv4_cnt);
-
-		/* Lookup IPv6 hops if IPv6 packets are present. */
-		if (ipv6_cnt > 0)
-			rte_fib6_lookup_bulk(lconf->ipv6_lookup_struct,
-					ipv6_arr, hopsv6, ipv6_cnt);
+		if (nb_vrf != 0) {
+			/* Lookup hops in the tables of the packet VRFs. */
+			for (i = 0; i < nb_deq; i++)
+				mbufs[i] = events[i].mbuf;
+			fib_vrf_lookup(lconf->ipv4_lookup_struct, mbufs,
+					type_arr, nb_deq, ipv4_arr, ipv4_cnt,
+					ipv6_arr, ipv6_cnt, hopsv4, hopsv6);
+		} else {
+			/* Lookup IPv4 hops if IPv4 packets are present. */
+			if (likely(ipv4_cnt > 0))
+				rte_fib_lookup_bulk(lconf->ipv4_lookup_struct,
+						ipv4_arr, hopsv4, ipv4_cnt);
+
+			/* Lookup IPv6 hops if IPv6 packets are present. */
+			if (ipv6_cnt > 0)
+				rte_fib6_lookup_bulk(lconf->ipv6_lookup_struct,
+						ipv6_arr, hopsv6, ipv6_cnt);
+		}
 
 		/* Assign ports looked up in fib depending on IPv4 or IPv6 */
 		for (i = 0; i < nb_deq; i++) {
@@ -370,6 +509,140 @@ fib_event_loop(struct l3fwd_event_resources *evt_rsrc,
 	}
 }
 
+/* Lookup the destination ports of up to MAX_PKT_BURST packets of a vector. */
+static __rte_always_inline void
+fib_process_event_mbufs(struct lcore_conf *lconf, struct rte_mbuf **mbufs,
+		int nb)
+{
+	uint32_t ipv4_arr[MAX_PKT_BURST];
+	uint8_t ipv6_arr[MAX_PKT_BURST][RTE_FIB6_IPV6_ADDR_SIZE];
+	uint64_t hopsv4[MAX_PKT_BURST], hopsv6[MAX_PKT_BURST];
+	uint8_t type_arr[MAX_PKT_BURST];
+	uint32_t ipv4_cnt = 0, ipv6_cnt = 0;
+	uint32_t ipv4_arr_assem = 0, ipv6_arr_assem = 0;
+	uint16_t nh;
+	int i;
+
+	/* Prefetch first packets. */
+	for (i = 0; i < FIB_PREFETCH_OFFSET && i < nb; i++)
+		rte_prefetch0(rte_pktmbuf_mtod(mbufs[i], void *));
+
+	/* Parse packet info and prefetch. */
+	for (i = 0; i < (nb - FIB_PREFETCH_OFFSET); i++) {
+		rte_prefetch0(rte_pktmbuf_mtod(mbufs[i + FIB_PREFETCH_OFFSET],
+				void *));
+		fib_parse_packet(mbufs[i],
+				&ipv4_arr[ipv4_cnt], &ipv4_cnt,
+				ipv6_arr[ipv6_cnt], &ipv6_cnt,
+				&type_arr[i]);
+	}
+
+	/* Parse remaining packet info. */
+	for (; i < nb; i++)
+		fib_parse_packet(mbufs[i],
+				&ipv4_arr[ipv4_cnt], &ipv4_cnt,
+				ipv6_arr[ipv6_cnt], &ipv6_cnt,
+				&type_arr[i]);
+
+	if (nb_vrf != 0) {
+		/* Lookup hops in the tables of the packet VRFs. */
+		fib_vrf_lookup(lconf->ipv4_lookup_struct, mbufs, type_arr, nb,
+				ipv4_arr, ipv4_cnt, ipv6_arr, ipv6_cnt,
+				hopsv4, hopsv6);
+	} else {
+		/* Lookup IPv4 hops if IPv4 packets are present. */
+		if (likely(ipv4_cnt > 0))
+			rte_fib_lookup_bulk(lconf->ipv4_lookup_struct,
+					ipv4_arr, hopsv4, ipv4_cnt);
+
+		/* Lookup IPv6 hops if IPv6 packets are present. */
+		if (ipv6_cnt > 0)
+			rte_fib6_lookup_bulk(lconf->ipv6_lookup_struct,
+					ipv6_arr, hopsv6, ipv6_cnt);
+	}
+
+	/* Assign ports looked up in fib depending on IPv4 or IPv6 */
+	for (i = 0; i < nb; i++) {
+		if (type_arr[i])
+			nh = (uint16_t)hopsv4[ipv4_arr_assem++];
+		else
+			nh = (uint16_t)hopsv6[ipv6_arr_assem++];
+		if (nh != FIB_DEFAULT_HOP)
+			mbufs[i]->port = nh;
+	}
+}
+
+/* Eventdev loop for event vectors using fib. */
+static __rte_always_inline void
+fib_event_loop_vector(struct l3fwd_event_resources *evt_rsrc,
+		const uint8_t flags)
+{
+	const int event_p_id = l3fwd_get_free_event_port(evt_rsrc);
+	const uint8_t tx_q_id = evt_rsrc->evq.event_q_id[
+			evt_rsrc->evq.nb_queues - 1];
+	const uint8_t event_d_id = evt_rsrc->event_d_id;
+	const uint16_t deq_len = evt_rsrc->deq_depth;
+	struct rte_event events[MAX_PKT_BURST];
+	struct rte_event_vector *vec;
+	struct lcore_conf *lconf;
+	unsigned int lcore_id;
+	int nb_enq, nb_deq, nb_ev, i, j;
+
+	if (event_p_id < 0)
+		return;
+
+	lcore_id = rte_lcore_id();
+
+	lconf = &lcore_conf[lcore_id];
+
+	RTE_LOG(INFO, L3FWD, "entering %s on lcore %u\n", __func__, lcore_id);
+
+	while (!force_quit) {
+		/* Read event vectors from RX queues. */
+		nb_deq = rte_event_dequeue_burst(event_d_id, event_p_id,
+				events, deq_len, 0);
+		if (nb_deq == 0) {
+			rte_pause();
+			continue;
+		}
+
+		nb_ev = 0;
+		for (i = 0; i < nb_deq; i++) {
+			if (flags & L3FWD_EVENT_TX_ENQ) {
+				events[i].queue_id = tx_q_id;
+				events[i].op = RTE_EVENT_OP_FORWARD;
+			}
+
+			vec = events[i].vec;
+			for (j = 0; j < vec->nb_elem; j += MAX_PKT_BURST)
+				fib_process_event_mbufs(lconf, &vec->mbufs[j],
+						RTE_MIN(vec->nb_elem - j,
+							MAX_PKT_BURST));
+			if (l3fwd_event_vector_tx_prepare(vec, 0))
+				events[nb_ev++] = events[i];
+		}
+
+		if (flags & L3FWD_EVENT_TX_ENQ) {
+			nb_enq = rte_event_enqueue_burst(event_d_id, event_p_id,
+					events, nb_ev);
+			while (nb_enq < nb_ev && !force_quit)
+				nb_enq += rte_event_enqueue_burst(event_d_id,
+						event_p_id, events + nb_enq,
+						nb_ev - nb_enq);
+		}
+
+		if (flags & L3FWD_EVENT_TX_DIRECT) {
+			nb_enq = rte_event_eth_tx_adapter_enqueue(event_d_id,
+					event_p_id, events, nb_ev, 0);
+			while (nb_enq < nb_ev && !force_quit)
+				nb_enq += rte_event_eth_tx_adapter_enqueue(
+						event_d_id, event_p_id,
+						events + nb_enq,
+						nb_ev - nb_enq, 0);
+		}
+	}
+}
+
 int __rte_noinline
 fib_event_main_loop_tx_d(__rte_unused void *dummy)
 {
@@ -410,15 +683,57 @@ fib_event_main_loop_tx_q_burst(__rte_unused void *dummy)
 	return 0;
 }
 
-/* Function to setup fib. */
-void
-setup_fib(const int socketid)
+int __rte_noinline
+fib_event_main_loop_tx_d_vector(__rte_unused void *dummy)
 {
-	struct rte_fib6_conf config;
+	struct l3fwd_event_resources *evt_rsrc =
+			l3fwd_get_eventdev_rsrc();
+
+	fib_event_loop_vector(evt_rsrc, L3FWD_EVENT_TX_DIRECT);
+	return 0;
+}
+
+int __rte_noinline
+fib_event_main_loop_tx_q_vector(__rte_unused void *dummy)
+{
+	struct l3fwd_event_resources *evt_rsrc =
+			l3fwd_get_eventdev_rsrc();
+
+	fib_event_loop_vector(evt_rsrc, L3FWD_EVENT_TX_ENQ);
+	return 0;
+}
+
+/*
+ * Output port of a sample route in a VRF, on one of its ECMP paths. The
+ * routes of each VRF and path are shifted over the enabled ports, so the
+ * tables differ; VRF 0 and path 0 keep the port of the route.
+ */
+static uint16_t
+fib_route_port(uint8_t if_out, unsigned int vrf, unsigned int path)
+{
+	uint32_t nb_ports = __builtin_popcount(enabled_port_mask);
+	uint32_t k;
+	uint16_t portid;
+
+	k = __builtin_popcount(enabled_port_mask & ((1u << if_out) - 1));
+	k = (k + vrf + path) % nb_ports;
+	for (portid = 0; ; portid++) {
+		if ((enabled_port_mask & (1u << portid)) && k-- == 0)
+			return portid;
+	}
+}
+
+/* Create and populate the IPv4 table of a VRF. */
+static struct rte_fib *
+setup_fib_ipv4(const int socketid, unsigned int vrf, const char *name)
+{
+	struct rte_fib_nh_group_conf group_conf;
 	struct rte_fib_conf config_ipv4;
+	struct rte_fib *fib;
+	uint64_t paths[2];
+	uint64_t nh;
 	unsigned int i;
 	int ret;
-	char s[64];
 	char abuf[INET6_ADDRSTRLEN];
 
 	/* Create the fib IPv4 table. */
@@ -427,14 +742,23 @@ setup_fib(const int socketid)
 	config_ipv4.default_nh = FIB_DEFAULT_HOP;
 	config_ipv4.dir24_8.nh_sz = RTE_FIB_DIR24_8_4B;
 	config_ipv4.dir24_8.num_tbl8 = (1 << 15);
-	snprintf(s, sizeof(s), "IPV4_L3FWD_FIB_%d", socketid);
-	ipv4_l3fwd_fib_lookup_struct[socketid] =
-			rte_fib_create(s, socketid, &config_ipv4);
-	if (ipv4_l3fwd_fib_lookup_struct[socketid] == NULL)
+	fib = rte_fib_create(name, socketid, &config_ipv4);
+	if (fib == NULL)
 		rte_exit(EXIT_FAILURE,
 			"Unable to create the l3fwd FIB table on socket %d\n",
 			socketid);
 
+	/* One ECMP next hop group per route. */
+	if (ecmp_on) {
+		group_conf.num_groups = RTE_DIM(ipv4_l3fwd_route_array);
+		group_conf.num_buckets = FIB_ECMP_BUCKETS;
+		ret = rte_fib_nh_group_create(fib, &group_conf);
+		if (ret < 0)
+			rte_exit(EXIT_FAILURE,
+				"Unable to create the l3fwd FIB ECMP groups on socket %d\n",
+				socketid);
+	}
+
 	/* Populate the fib ipv4 table. */
 	for (i = 0; i < RTE_DIM(ipv4_l3fwd_route_array); i++) {
 		struct in_addr in;
@@ -444,10 +768,25 @@ setup_fib(const int socketid)
 				enabled_port_mask) == 0)
 			continue;
 
-		ret = rte_fib_add(ipv4_l3fwd_fib_lookup_struct[socketid],
+		paths[0] = fib_route_port(ipv4_l3fwd_route_array[i].if_out,
+				vrf, 0);
+		paths[1] = fib_route_port(ipv4_l3fwd_route_array[i].if_out,
+				vrf, 1);
+		nh = paths[0];
+		if (ecmp_on) {
+			ret = rte_fib_nh_group_set(fib, i, paths, NULL,
+					RTE_DIM(paths));
+			if (ret < 0)
+				rte_exit(EXIT_FAILURE,
+					"Unable to set ECMP group %u of the l3fwd FIB table on socket %d\n",
+					i, socketid);
+			nh = RTE_FIB_DIR24_8_NH_GROUP(RTE_FIB_DIR24_8_4B, i);
+		}
+
+		ret = rte_fib_add(fib,
 			ipv4_l3fwd_route_array[i].ip,
 			ipv4_l3fwd_route_array[i].depth,
-			ipv4_l3fwd_route_array[i].if_out);
+			nh);
 
 		if (ret < 0) {
 			rte_exit(EXIT_FAILURE,
@@ -456,28 +795,44 @@ setup_fib(const int socketid)
 		}
 
 		in.s_addr = htonl(ipv4_l3fwd_route_array[i].ip);
-		if (inet_ntop(AF_INET, &in, abuf, sizeof(abuf)) != NULL) {
-			printf("FIB: Adding route %s / %d (%d)\n",
+		if (inet_ntop(AF_INET, &in, abuf, sizeof(abuf)) == NULL) {
+			printf("FIB: IPv4 route added to port %d\n",
+				(int)paths[0]);
+		} else if (ecmp_on) {
+			printf("FIB: Adding route %s / %d (%d,%d)\n",
 				abuf,
 				ipv4_l3fwd_route_array[i].depth,
-				ipv4_l3fwd_route_array[i].if_out);
+				(int)paths[0], (int)paths[1]);
 		} else {
-			printf("FIB: IPv4 route added to port %d\n",
-				ipv4_l3fwd_route_array[i].if_out);
+			printf("FIB: Adding route %s / %d (%d)\n",
+				abuf,
+				ipv4_l3fwd_route_array[i].depth,
+				(int)paths[0]);
 		}
 	}
 
-	/* Create the fib IPv6 table. */
-	snprintf(s, sizeof(s), "IPV6_L3FWD_FIB_%d", socketid);
+	return fib;
+}
 
+/* Create and populate the IPv6 table of a VRF. */
+static struct rte_fib6 *
+setup_fib_ipv6(const int socketid, unsigned int vrf, const char *name)
+{
+	struct rte_fib6_conf config;
+	struct rte_fib6 *fib;
+	uint16_t portid;
+	unsigned int i;
+	int ret;
+	char abuf[INET6_ADDRSTRLEN];
+
+	/* Create the fib IPv6 table. */
 	config.type = RTE_FIB6_TRIE;
 	config.max_routes = (1 << 16) - 1;
 	config.default_nh = FIB_DEFAULT_HOP;
 	config.trie.nh_sz = RTE_FIB6_TRIE_4B;
 	config.trie.num_tbl8 = (1 << 15);
-	ipv6_l3fwd_fib_lookup_struct[socketid] = rte_fib6_create(s, socketid,
-			&config);
-	if (ipv6_l3fwd_fib_lookup_struct[socketid] == NULL)
+	fib = rte_fib6_create(name, socketid, &config);
+	if (fib == NULL)
 		rte_exit(EXIT_FAILURE,
 				"Unable to create the l3fwd FIB table on socket %d\n",
 				socketid);
@@ -490,10 +845,12 @@ setup_fib(const int socketid)
 				enabled_port_mask) == 0)
 			continue;
 
-		ret = rte_fib6_add(ipv6_l3fwd_fib_lookup_struct[socketid],
+		portid = fib_route_port(ipv6_l3fwd_route_array[i].if_out,
+				vrf, 0);
+		ret = rte_fib6_add(fib,
 			ipv6_l3fwd_route_array[i].ip,
 			ipv6_l3fwd_route_array[i].depth,
-			ipv6_l3fwd_route_array[i].if_out);
+			portid);
 
 		if (ret < 0) {
 			rte_exit(EXIT_FAILURE,
@@ -506,24 +863,58 @@ setup_fib(const int socketid)
 			printf("FIB: Adding route %s / %d (%d)\n",
 				abuf,
 				ipv6_l3fwd_route_array[i].depth,
-				ipv6_l3fwd_route_array[i].if_out);
+				portid);
 		} else {
-			printf("FIB: IPv6 route added to port %d\n",
-				ipv6_l3fwd_route_array[i].if_out);
+			printf("FIB: IPv6 route added to port %d\n", portid);
 		}
 	}
+
+	return fib;
+}
+
+/* Function to setup fib. */
+void
+setup_fib(const int socketid)
+{
+	unsigned int vrf;
+	char s[64];
+
+	if (nb_vrf == 0) {
+		snprintf(s, sizeof(s), "IPV4_L3FWD_FIB_%d", socketid);
+		ipv4_l3fwd_fib_lookup_struct[socketid] =
+				setup_fib_ipv4(socketid, 0, s);
+		snprintf(s, sizeof(s), "IPV6_L3FWD_FIB_%d", socketid);
+		ipv6_l3fwd_fib_lookup_struct[socketid] =
+				setup_fib_ipv6(socketid, 0, s);
+		return;
+	}
+
+	/* Multi-table mode. */
+	for (vrf = 0; vrf < nb_vrf; vrf++) {
+		printf("FIB: Setting up VRF %u on socket %d\n", vrf, socketid);
+		snprintf(s, sizeof(s), "IPV4_L3FWD_FIB_%d_%u", socketid, vrf);
+		fib_vrf_lookup_struct[socketid].ipv4[vrf] =
+				setup_fib_ipv4(socketid, vrf, s);
+		snprintf(s, sizeof(s), "IPV6_L3FWD_FIB_%d_%u", socketid, vrf);
+		fib_vrf_lookup_struct[socketid].ipv6[vrf] =
+				setup_fib_ipv6(socketid, vrf, s);
+	}
 }
 
-/* Return ipv4 fib lookup struct. */
+/* Return ipv4 fib lookup struct, the VRF tables in multi-table mode. */
 void *
 fib_get_ipv4_l3fwd_lookup_struct(const int socketid)
 {
+	if (nb_vrf != 0)
+		return &fib_vrf_lookup_struct[socketid];
 	return ipv4_l3fwd_fib_lookup_struct[socketid];
 }
 
-/* Return ipv6 fib lookup struct. */
+/* Return ipv6 fib lookup struct, the VRF tables in multi-table mode. */
 void *
 fib_get_ipv6_l3fwd_lookup_struct(const int socketid)
 {
+	if (nb_vrf != 0)
+		return &fib_vrf_lookup_struct[socketid];
 	return ipv6_l3fwd_fib_lookup_struct[socketid];
 }
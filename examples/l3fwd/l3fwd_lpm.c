@@ -221,11 +221,10 @@ lpm_main_loop(__rte_unused void *dummy)
 	return 0;
 }
 
+/* Rewrite a packet for its destination port in mbuf->port. */
 static __rte_always_inline uint16_t
-lpm_process_event_pkt(const struct lcore_conf *lconf, struct rte_mbuf *mbuf)
+lpm_event_pkt_rewrite(struct rte_mbuf *mbuf)
 {
-	mbuf->port = lpm_get_dst_port(lconf, mbuf, mbuf->port);
-
 #if defined RTE_ARCH_X86 || defined __ARM_NEON \
 	|| defined RTE_ARCH_PPC_64
 	process_packet(mbuf, &mbuf->port);
@@ -244,7 +243,7 @@ lpm_process_event_pkt(const struct lcore_conf *lconf, struct rte_mbuf *mbuf)
 		if (is_valid_ipv4_pkt(ipv4_hdr, mbuf->pkt_len)
 				< 0) {
 			mbuf->port = BAD_PORT;
-			continue;
+			return mbuf->port;
 		}
 		/* Update time to live and header checksum */
 		--(ipv4_hdr->time_to_live);
@@ -261,6 +260,59 @@ lpm_process_event_pkt(const struct lcore_conf *lconf, struct rte_mbuf *mbuf)
 	return mbuf->port;
 }
 
+static __rte_always_inline uint16_t
+lpm_process_event_pkt(const struct lcore_conf *lconf, struct rte_mbuf *mbuf)
+{
+	mbuf->port = lpm_get_dst_port(lconf, mbuf, mbuf->port);
+
+	return lpm_event_pkt_rewrite(mbuf);
+}
+
+/*
+ * Lookup the destination ports of the packets of a vector, the IPv4
+ * addresses in bulk, and rewrite the packets.
+ */
+static __rte_always_inline void
+lpm_process_event_vector(const struct lcore_conf *lconf,
+		struct rte_event_vector *vec)
+{
+	struct rte_mbuf **mbufs = vec->mbufs;
+	uint32_t ips[MAX_PKT_BURST], next_hops[MAX_PKT_BURST];
+	uint16_t idx[MAX_PKT_BURST];
+	struct rte_ipv4_hdr *ipv4_hdr;
+	struct rte_mbuf *mbuf;
+	uint16_t i, j, n, nb_ipv4;
+
+	for (i = 0; i < vec->nb_elem; i += n) {
+		n = RTE_MIN(vec->nb_elem - i, MAX_PKT_BURST);
+		nb_ipv4 = 0;
+		for (j = 0; j < n; j++) {
+			mbuf = mbufs[i + j];
+			if (RTE_ETH_IS_IPV4_HDR(mbuf->packet_type)) {
+				ipv4_hdr = rte_pktmbuf_mtod_offset(mbuf,
+						struct rte_ipv4_hdr *,
+						sizeof(struct rte_ether_hdr));
+				ips[nb_ipv4] =
+					rte_be_to_cpu_32(ipv4_hdr->dst_addr);
+				idx[nb_ipv4++] = i + j;
+			} else {
+				mbuf->port = lpm_get_dst_port(lconf, mbuf,
+						mbuf->port);
+			}
+		}
+
+		rte_lpm_lookup_bulk(lconf->ipv4_lookup_struct, ips,
+				next_hops, nb_ipv4);
+		for (j = 0; j < nb_ipv4; j++) {
+			if (next_hops[j] & RTE_LPM_LOOKUP_SUCCESS)
+				mbufs[idx[j]]->port = next_hops[j];
+		}
+
+		for (j = 0; j < n; j++)
+			lpm_event_pkt_rewrite(mbufs[i + j]);
+	}
+}
+
 static __rte_always_inline void
 lpm_event_loop_single(struct l3fwd_event_resources *evt_rsrc,
 		const uint8_t flags)
@@ -373,6 +425,71 @@ lpm_event_loop_burst(struct l3fwd_event_resources *evt_rsrc,
 	}
 }
 
+static __rte_always_inline void
+lpm_event_loop_vector(struct l3fwd_event_resources *evt_rsrc,
+		const uint8_t flags)
+{
+	const int event_p_id = l3fwd_get_free_event_port(evt_rsrc);
+	const uint8_t tx_q_id = evt_rsrc->evq.event_q_id[
+		evt_rsrc->evq.nb_queues - 1];
+	const uint8_t event_d_id = evt_rsrc->event_d_id;
+	const uint16_t deq_len = evt_rsrc->deq_depth;
+	struct rte_event events[MAX_PKT_BURST];
+	struct lcore_conf *lconf;
+	unsigned int lcore_id;
+	int i, nb_enq, nb_deq, nb_ev;
+
+	if (event_p_id < 0)
+		return;
+
+	lcore_id = rte_lcore_id();
+
+	lconf = &lcore_conf[lcore_id];
+
+	RTE_LOG(INFO, L3FWD, "entering %s on lcore %u\n", __func__, lcore_id);
+
+	while (!force_quit) {
+		/* Read event vectors from RX queues */
+		nb_deq = rte_event_dequeue_burst(event_d_id, event_p_id,
+				events, deq_len, 0);
+		if (nb_deq == 0) {
+			rte_pause();
+			continue;
+		}
+
+		nb_ev = 0;
+		for (i = 0; i < nb_deq; i++) {
+			if (flags & L3FWD_EVENT_TX_ENQ) {
+				events[i].queue_id = tx_q_id;
+				events[i].op = RTE_EVENT_OP_FORWARD;
+			}
+
+			lpm_process_event_vector(lconf, events[i].vec);
+			if (l3fwd_event_vector_tx_prepare(events[i].vec, 0))
+				events[nb_ev++] = events[i];
+		}
+
+		if (flags & L3FWD_EVENT_TX_ENQ) {
+			nb_enq = rte_event_enqueue_burst(event_d_id, event_p_id,
+					events, nb_ev);
+			while (nb_enq < nb_ev && !force_quit)
+				nb_enq += rte_event_enqueue_burst(event_d_id,
+						event_p_id, events + nb_enq,
+						nb_ev - nb_enq);
+		}
+
+		if (flags & L3FWD_EVENT_TX_DIRECT) {
+			nb_enq = rte_event_eth_tx_adapter_enqueue(event_d_id,
+					event_p_id, events, nb_ev, 0);
+			while (nb_enq < nb_ev && !force_quit)
+				nb_enq += rte_event_eth_tx_adapter_enqueue(
+						event_d_id, event_p_id,
+						events + nb_enq,
+						nb_ev - nb_enq, 0);
+		}
+	}
+}
+
 static __rte_always_inline void
 lpm_event_loop(struct l3fwd_event_resources *evt_rsrc,
 		 const uint8_t flags)
@@ -381,6 +498,8 @@ lpm_event_loop(struct l3fwd_event_resources *evt_rsrc,
 		lpm_event_loop_single(evt_rsrc, flags);
 	if (flags & L3FWD_EVENT_BURST)
 		lpm_event_loop_burst(evt_rsrc, flags);
+	if (flags & L3FWD_EVENT_VECTOR)
+		lpm_event_loop_vector(evt_rsrc, flags);
 }
 
 int __rte_noinline
@@ -423,6 +542,26 @@ lpm_event_main_loop_tx_q_burst(__rte_unused void *dummy)
 	return 0;
 }
 
+int __rte_noinline
+lpm_event_main_loop_tx_d_vector(__rte_unused void *dummy)
+{
+	struct l3fwd_event_resources *evt_rsrc =
+					l3fwd_get_eventdev_rsrc();
+
+	lpm_event_loop(evt_rsrc, L3FWD_EVENT_TX_DIRECT | L3FWD_EVENT_VECTOR);
+	return 0;
+}
+
+int __rte_noinline
+lpm_event_main_loop_tx_q_vector(__rte_unused void *dummy)
+{
+	struct l3fwd_event_resources *evt_rsrc =
+					l3fwd_get_eventdev_rsrc();
+
+	lpm_event_loop(evt_rsrc, L3FWD_EVENT_TX_ENQ | L3FWD_EVENT_VECTOR);
+	return 0;
+}
+
 void
 setup_lpm(const int socketid)
 {
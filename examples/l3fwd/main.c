@@ -93,6 +93,13 @@ uint32_t enabled_port_mask;
 int ipv6; /**< ipv6 is false by default. */
 uint32_t hash_entry_number = HASH_ENTRY_NUMBER_DEFAULT;
 
+/* Used only in FIB multi-table mode. */
+uint16_t nb_vrf; /**< Multi-table mode is disabled by default. */
+uint8_t port_vrf[RTE_MAX_ETHPORTS];
+int vrf_vlan; /**< VRF selected by the ingress port only by default. */
+int ecmp_on; /**< ECMP is disabled by default. */
+static bool port_vrf_set[RTE_MAX_ETHPORTS]; /**< VRF set by --vrf-port. */
+
 struct lcore_conf lcore_conf[RTE_MAX_LCORE];
 
 struct lcore_params {
@@ -334,6 +341,10 @@ print_usage(const char *prgname)
 		" [--per-port-pool]"
 		" [--mode]"
 		" [--eventq-sched]"
+		" [--event-vector [--event-vector-size SIZE]"
+		" [--event-vector-tmo NS]]"
+		" [--vrf NUM [--vrf-port (port,vrf)[,(port,vrf)]] [--vrf-vlan]]"
+		" [--ecmp]"
 		" [-E]"
 		" [-L]\n\n"
 
@@ -361,9 +372,22 @@ print_usage(const char *prgname)
 		"  --event-eth-rxqs: Number of ethernet RX queues per device.\n"
 		"                    Default: 1\n"
 		"                    Valid only if --mode=eventdev\n"
+		"  --event-vector: Enable event vectorization\n"
+		"                  Valid only if --mode=eventdev\n"
+		"  --event-vector-size: Max vector size, default %d\n"
+		"  --event-vector-tmo: Max timeout to form a vector in ns, default %d\n"
+		"  --vrf NUM: Number of routing tables (VRF), up to %d\n"
+		"             Valid only if --lookup=fib\n"
+		"  --vrf-port (port,vrf): VRF of the packets received on a port\n"
+		"                         Default: port modulo the number of VRF\n"
+		"  --vrf-vlan: Select the VRF of VLAN tagged packets by VLAN ID\n"
+		"              modulo the number of VRF\n"
+		"  --ecmp: Balance the IPv4 routes on two ports by RSS hash\n"
+		"          Valid only if --lookup=fib\n"
 		"  -E : Enable exact match, legacy flag please use --lookup=em instead\n"
 		"  -L : Enable longest prefix match, legacy flag please use --lookup=lpm instead\n\n",
-		prgname);
+		prgname, L3FWD_EVENT_VECTOR_SIZE_DEFAULT,
+		L3FWD_EVENT_VECTOR_TMO_NS_DEFAULT, L3FWD_MAX_VRF);
 }
 
 static int
@@ -467,6 +491,50 @@ parse_config(const char *q_arg)
 	return 0;
 }
 
+static int
+parse_vrf_port(const char *q_arg)
+{
+	char s[256];
+	const char *p, *p0 = q_arg;
+	char *end;
+	enum fieldnames {
+		FLD_PORT = 0,
+		FLD_VRF,
+		_NUM_FLD
+	};
+	unsigned long int_fld[_NUM_FLD];
+	char *str_fld[_NUM_FLD];
+	int i;
+	unsigned size;
+
+	while ((p = strchr(p0, '(')) != NULL) {
+		++p;
+		p0 = strchr(p, ')');
+		if (p0 == NULL)
+			return -1;
+
+		size = p0 - p;
+		if (size >= sizeof(s))
+			return -1;
+
+		snprintf(s, sizeof(s), "%.*s", size, p);
+		if (rte_strsplit(s, sizeof(s), str_fld, _NUM_FLD, ',') != _NUM_FLD)
+			return -1;
+		for (i = 0; i < _NUM_FLD; i++) {
+			errno = 0;
+			int_fld[i] = strtoul(str_fld[i], &end, 0);
+			if (errno != 0 || end == str_fld[i])
+				return -1;
+		}
+		if (int_fld[FLD_PORT] >= RTE_MAX_ETHPORTS ||
+				int_fld[FLD_VRF] >= L3FWD_MAX_VRF)
+			return -1;
+		port_vrf[int_fld[FLD_PORT]] = int_fld[FLD_VRF];
+		port_vrf_set[int_fld[FLD_PORT]] = true;
+	}
+	return 0;
+}
+
 static void
 parse_eth_dest(const char *optarg)
 {
@@ -574,6 +642,13 @@ static const char short_options[] =
 #define CMD_LINE_OPT_EVENTQ_SYNC "eventq-sched"
 #define CMD_LINE_OPT_EVENT_ETH_RX_QUEUES "event-eth-rxqs"
 #define CMD_LINE_OPT_LOOKUP "lookup"
+#define CMD_LINE_OPT_EVENT_VECTOR "event-vector"
+#define CMD_LINE_OPT_EVENT_VECTOR_SIZE "event-vector-size"
+#define CMD_LINE_OPT_EVENT_VECTOR_TMO_NS "event-vector-tmo"
+#define CMD_LINE_OPT_VRF "vrf"
+#define CMD_LINE_OPT_VRF_PORT "vrf-port"
+#define CMD_LINE_OPT_VRF_VLAN "vrf-vlan"
+#define CMD_LINE_OPT_ECMP "ecmp"
 enum {
 	/* long options mapped to a short option */
 
@@ -592,6 +667,13 @@ enum {
 	CMD_LINE_OPT_EVENTQ_SYNC_NUM,
 	CMD_LINE_OPT_EVENT_ETH_RX_QUEUES_NUM,
 	CMD_LINE_OPT_LOOKUP_NUM,
+	CMD_LINE_OPT_EVENT_VECTOR_NUM,
+	CMD_LINE_OPT_EVENT_VECTOR_SIZE_NUM,
+	CMD_LINE_OPT_EVENT_VECTOR_TMO_NS_NUM,
+	CMD_LINE_OPT_VRF_NUM,
+	CMD_LINE_OPT_VRF_PORT_NUM,
+	CMD_LINE_OPT_VRF_VLAN_NUM,
+	CMD_LINE_OPT_ECMP_NUM,
 };
 
 static const struct option lgopts[] = {
@@ -608,6 +690,15 @@ static const struct option lgopts[] = {
 	{CMD_LINE_OPT_EVENT_ETH_RX_QUEUES, 1, 0,
 					CMD_LINE_OPT_EVENT_ETH_RX_QUEUES_NUM},
 	{CMD_LINE_OPT_LOOKUP, 1, 0, CMD_LINE_OPT_LOOKUP_NUM},
+	{CMD_LINE_OPT_EVENT_VECTOR, 0, 0, CMD_LINE_OPT_EVENT_VECTOR_NUM},
+	{CMD_LINE_OPT_EVENT_VECTOR_SIZE, 1, 0,
+					CMD_LINE_OPT_EVENT_VECTOR_SIZE_NUM},
+	{CMD_LINE_OPT_EVENT_VECTOR_TMO_NS, 1, 0,
+					CMD_LINE_OPT_EVENT_VECTOR_TMO_NS_NUM},
+	{CMD_LINE_OPT_VRF, 1, 0, CMD_LINE_OPT_VRF_NUM},
+	{CMD_LINE_OPT_VRF_PORT, 1, 0, CMD_LINE_OPT_VRF_PORT_NUM},
+	{CMD_LINE_OPT_VRF_VLAN, 0, 0, CMD_LINE_OPT_VRF_VLAN_NUM},
+	{CMD_LINE_OPT_ECMP, 0, 0, CMD_LINE_OPT_ECMP_NUM},
 	{NULL, 0, 0, 0}
 };
 
@@ -637,6 +728,11 @@ parse_args(int argc, char **argv)
 	uint8_t eventq_sched = 0;
 	uint8_t eth_rx_q = 0;
 	struct l3fwd_event_resources *evt_rsrc = l3fwd_get_eventdev_rsrc();
+	uint8_t vrf_port = 0;
+	uint8_t vector_opt = 0;
+	unsigned long val;
+	uint16_t portid;
+	char *end;
 
 	argvopt = argv;
 
@@ -774,6 +870,63 @@ parse_args(int argc, char **argv)
 				return -1;
 			break;
 
+		case CMD_LINE_OPT_EVENT_VECTOR_NUM:
+			evt_rsrc->vector_enabled = 1;
+			break;
+
+		case CMD_LINE_OPT_EVENT_VECTOR_SIZE_NUM:
+			errno = 0;
+			val = strtoul(optarg, &end, 10);
+			if (errno != 0 || end == optarg || *end != '\0' ||
+					val == 0 || val > UINT16_MAX) {
+				fprintf(stderr, "Invalid event vector size\n");
+				print_usage(prgname);
+				return -1;
+			}
+			evt_rsrc->vector_size = val;
+			vector_opt = 1;
+			break;
+
+		case CMD_LINE_OPT_EVENT_VECTOR_TMO_NS_NUM:
+			errno = 0;
+			evt_rsrc->vector_tmo_ns = strtoull(optarg, &end, 10);
+			if (errno != 0 || end == optarg || *end != '\0') {
+				fprintf(stderr, "Invalid event vector timeout\n");
+				print_usage(prgname);
+				return -1;
+			}
+			vector_opt = 1;
+			break;
+
+		case CMD_LINE_OPT_VRF_NUM:
+			errno = 0;
+			nb_vrf = strtoul(optarg, &end, 10);
+			if (errno != 0 || end == optarg || *end != '\0' ||
+					nb_vrf == 0 || nb_vrf > L3FWD_MAX_VRF) {
+				fprintf(stderr, "Invalid number of VRF\n");
+				print_usage(prgname);
+				return -1;
+			}
+			break;
+
+		case CMD_LINE_OPT_VRF_PORT_NUM:
+			ret = parse_vrf_port(optarg);
+			if (ret) {
+				fprintf(stderr, "Invalid VRF port config\n");
+				print_usage(prgname);
+				return -1;
+			}
+			vrf_port = 1;
+			break;
+
+		case CMD_LINE_OPT_VRF_VLAN_NUM:
+			vrf_vlan = 1;
+			break;
+
+		case CMD_LINE_OPT_ECMP_NUM:
+			ecmp_on = 1;
+			break;
+
 		default:
 			print_usage(prgname);
 			return -1;
@@ -804,6 +957,52 @@ parse_args(int argc, char **argv)
 		lookup_mode = L3FWD_LOOKUP_LPM;
 	}
 
+	if (!evt_rsrc->enabled && evt_rsrc->vector_enabled) {
+		fprintf(stderr, "event-vector is valid only when event mode is selected\n");
+		return -1;
+	}
+
+	if (!evt_rsrc->vector_enabled && vector_opt) {
+		fprintf(stderr, "event-vector-size and event-vector-tmo are valid only with event-vector\n");
+		return -1;
+	}
+
+	if (evt_rsrc->vector_enabled && lookup_mode == L3FWD_LOOKUP_EM) {
+		fprintf(stderr, "event-vector is valid only with lpm or fib lookup\n");
+		return -1;
+	}
+
+	if ((nb_vrf != 0 || ecmp_on) && lookup_mode != L3FWD_LOOKUP_FIB) {
+		fprintf(stderr, "vrf and ecmp are valid only when fib lookup is selected\n");
+		return -1;
+	}
+
+	if (nb_vrf == 0 && (vrf_port || vrf_vlan)) {
+		fprintf(stderr, "vrf-port and vrf-vlan are valid only with vrf\n");
+		return -1;
+	}
+
+	/*
+	 * ECMP uses the multi-table mode, with a single table by default.
+	 * The unmapped ports are spread over the VRF.
+	 */
+	if (ecmp_on) {
+		if (nb_vrf == 0)
+			nb_vrf = 1;
+		port_conf.rxmode.offloads |= DEV_RX_OFFLOAD_RSS_HASH;
+	}
+	for (portid = 0; portid < RTE_MAX_ETHPORTS && nb_vrf != 0; portid++) {
+		if (!port_vrf_set[portid])
+			port_vrf[portid] = portid % nb_vrf;
+		else if (port_vrf[portid] >= nb_vrf) {
+			fprintf(stderr, "VRF %u of port %u is out of range\n",
+				port_vrf[portid], portid);
+			return -1;
+		}
+	}
+	if (vrf_vlan)
+		port_conf.rxmode.offloads |= DEV_RX_OFFLOAD_VLAN_STRIP;
+
 	/*
 	 * ipv6 and hash flags are valid only for
 	 * exact match, reset them to default for
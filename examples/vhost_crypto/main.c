@@ -69,6 +69,8 @@ enum {
 	OPT_SOCKET_FILE_NUM,
 #define OPT_ZERO_COPY       "zero-copy"
 	OPT_ZERO_COPY_NUM,
+#define OPT_NO_ZERO_COPY    "no-zero-copy"
+	OPT_NO_ZERO_COPY_NUM,
 #define OPT_POLLING         "guest-polling"
 	OPT_POLLING_NUM,
 };
@@ -202,10 +204,11 @@ vhost_crypto_usage(const char *prgname)
 	printf("%s [EAL options] --\n"
 		"  --%s <lcore>,SOCKET-FILE-PATH\n"
 		"  --%s (lcore,cdev_id,queue_id)[,(lcore,cdev_id,queue_id)]\n"
-		"  --%s: zero copy\n"
+		"  --%s: zero copy (default)\n"
+		"  --%s: disable zero copy\n"
 		"  --%s: guest polling\n",
 		prgname, OPT_SOCKET_FILE, OPT_CONFIG,
-		OPT_ZERO_COPY, OPT_POLLING);
+		OPT_ZERO_COPY, OPT_NO_ZERO_COPY, OPT_POLLING);
 }
 
 static int
@@ -222,12 +225,15 @@ vhost_crypto_parse_args(int argc, char **argv)
 				NULL, OPT_CONFIG_NUM},
 		{OPT_ZERO_COPY, no_argument,
 				NULL, OPT_ZERO_COPY_NUM},
+		{OPT_NO_ZERO_COPY, no_argument,
+				NULL, OPT_NO_ZERO_COPY_NUM},
 		{OPT_POLLING, no_argument,
 				NULL, OPT_POLLING_NUM},
 		{NULL, 0, 0, 0}
 	};
 
 	argvopt = argv;
+	options.zero_copy = RTE_VHOST_CRYPTO_ZERO_COPY_ENABLE;
 
 	while ((opt = getopt_long(argc, argvopt, "",
 				  lgopts, &option_index)) != EOF) {
@@ -259,6 +265,11 @@ vhost_crypto_parse_args(int argc, char **argv)
 				RTE_VHOST_CRYPTO_ZERO_COPY_ENABLE;
 			break;
 
+		case OPT_NO_ZERO_COPY_NUM:
+			options.zero_copy =
+				RTE_VHOST_CRYPTO_ZERO_COPY_DISABLE;
+			break;
+
 		case OPT_POLLING_NUM:
 			options.guest_polling = 1;
 			break;
@@ -518,10 +529,10 @@ main(int argc, char *argv[])
 				RTE_STR(VHOST_CRYPTO_CDEV_NAME_AESNI_MB_PMD)) ||
 				strstr(dev_info.driver_name,
 				RTE_STR(VHOST_CRYPTO_CDEV_NAME_AESNI_GCM_PMD))) {
-				RTE_LOG(ERR, USER1, "Cannot enable zero-copy in %s\n",
+				RTE_LOG(NOTICE, USER1, "Disabling zero-copy in %s\n",
 					dev_info.driver_name);
-				ret = -EPERM;
-				goto error_exit;
+				options.zero_copy =
+					RTE_VHOST_CRYPTO_ZERO_COPY_DISABLE;
 			}
 		}
 
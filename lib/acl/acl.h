@@ -71,7 +71,9 @@ struct rte_acl_bitset {
  * groups, by 64 transitions per group:
  * group64[i] contains transitions[i * 64, .. i * 64 + 63].
  * Upper 32 bits are interpreted as 4 unsigned character values one per group,
- * which contain index to the start of the given group within the node.
+ * which contain the distance between the nominal start of the given group
+ * (node_addr + i * 64) and its actual start, so that groups can be shared
+ * within the node or with the nodes stored just before it.
  * So to calculate transition index within the node for given input byte value:
  * input_byte - ((uint8_t *)&transition)[4 + input_byte / 64].
  */
@@ -174,6 +176,10 @@ struct rte_acl_ctx {
 	uint32_t            max_rules;
 	uint32_t            rule_sz;
 	uint32_t            num_rules;
+	struct rte_rcu_qsbr *v;
+	/** RCU QSBR variable, set when built in the background. */
+	struct rte_acl_ctx *rt;
+	/** Context holding the published run-time structures. */
 	uint32_t            num_categories;
 	uint32_t            num_tries;
 	uint32_t            match_index;
@@ -187,6 +193,19 @@ struct rte_acl_ctx {
 	struct rte_acl_config config; /* copy of build config. */
 };
 
+/*
+ * Once a context is built in the background, classify runs on the
+ * run-time structures published in ctx->rt rather than on ctx itself.
+ */
+static inline const struct rte_acl_ctx *
+acl_rt_ctx(const struct rte_acl_ctx *ctx)
+{
+	const struct rte_acl_ctx *rt;
+
+	rt = __atomic_load_n(&ctx->rt, __ATOMIC_ACQUIRE);
+	return (rt != NULL) ? rt : ctx;
+}
+
 int rte_acl_gen(struct rte_acl_ctx *ctx, struct rte_acl_trie *trie,
 	struct rte_acl_bld_trie *node_bld_trie, uint32_t num_tries,
 	uint32_t num_categories, uint32_t data_index_sz, size_t max_size);
@@ -3,6 +3,8 @@
  */
 
 #include <rte_acl.h>
+#include <rte_launch.h>
+#include <rte_lcore.h>
 #include "tb_mem.h"
 #include "acl.h"
 
@@ -62,6 +64,8 @@ struct rte_acl_build_rule {
 	uint32_t                    *wildness;
 };
 
+struct acl_build_job;
+
 /* Context for build phase */
 struct acl_build_context {
 	const struct rte_acl_ctx *acx;
@@ -85,6 +89,21 @@ struct acl_build_context {
 	/* memory free lists for nodes and blocks used for node ptrs */
 	struct acl_mem_block      blocks[MEM_BLOCK_NUM];
 	struct rte_acl_node       *node_free_list;
+
+	/* worker lcores to build the tries on, see acl_build_trie_job() */
+	const unsigned int        *lcores;
+	uint32_t                  num_lcores;
+	struct acl_build_job      *jobs;
+};
+
+/* Build of one trie offloaded to a worker lcore, with its own context. */
+struct acl_build_job {
+	struct acl_build_context  bcx;
+	struct rte_acl_build_rule **rule_sets;
+	uint32_t                  n;
+	uint32_t                  lcore;
+	int32_t                   used;
+	int32_t                   rc;
 };
 
 static int acl_merge_trie(struct acl_build_context *context,
@@ -1335,6 +1354,134 @@ build_one_trie(struct acl_build_context *context,
 	return last;
 }
 
+static int
+acl_build_trie_job_run(void *arg)
+{
+	struct acl_build_job *job;
+	struct rte_acl_build_rule *last;
+	int32_t rc;
+
+	job = arg;
+
+	rc = sigsetjmp(job->bcx.pool.fail, 0);
+
+	/* build of the trie runs out of memory. */
+	if (rc != 0) {
+		job->rc = rc;
+		return rc;
+	}
+
+	last = build_one_trie(&job->bcx, job->rule_sets, job->n, INT32_MAX);
+	if (job->bcx.bld_tries[job->n].trie == NULL || last != NULL)
+		job->rc = -ENOMEM;
+	else
+		job->rc = 0;
+	return job->rc;
+}
+
+/*
+ * Build the trie of the n-th rule set, without splitting it any further.
+ * When worker lcores are given, the build is launched on one of them and
+ * runs with a private context and memory pool, while the caller goes on
+ * splitting the remaining rules. acl_build_wait_jobs() collects the result.
+ */
+static int
+acl_build_trie_job(struct acl_build_context *context,
+	struct rte_acl_build_rule *rule_sets[RTE_ACL_MAX_TRIES], uint32_t n)
+{
+	struct acl_build_job *job;
+	struct rte_acl_build_rule *last;
+
+	if (context->jobs == NULL) {
+		last = build_one_trie(context, rule_sets, n, INT32_MAX);
+		if (context->bld_tries[n].trie == NULL || last != NULL)
+			return -ENOMEM;
+		return 0;
+	}
+
+	job = &context->jobs[n];
+	memset(job, 0, sizeof(*job));
+	job->bcx.acx = context->acx;
+	/* the rest of cfg may be updated by the build of the first trie. */
+	job->bcx.cfg.num_categories = context->cfg.num_categories;
+	job->bcx.category_mask = context->category_mask;
+	job->bcx.node_max = context->node_max;
+	job->bcx.pool.alignment = context->pool.alignment;
+	job->bcx.pool.min_alloc = context->pool.min_alloc;
+	job->rule_sets = rule_sets;
+	job->n = n;
+	job->lcore = context->lcores[n % context->num_lcores];
+	job->used = 1;
+
+	/* wait for the previous trie given to that lcore. */
+	rte_eal_wait_lcore(job->lcore);
+	if (rte_eal_remote_launch(acl_build_trie_job_run, job,
+			job->lcore) != 0) {
+		/* lcore not available, do it here. */
+		job->lcore = LCORE_ID_ANY;
+		acl_build_trie_job_run(job);
+	}
+
+	return 0;
+}
+
+/*
+ * Wait for the tries built on worker lcores and merge them into the
+ * context. Their memory pools are kept until acl_build_free_jobs().
+ */
+static int
+acl_build_wait_jobs(struct acl_build_context *context)
+{
+	uint32_t n;
+	int32_t rc;
+	struct acl_build_job *job;
+
+	if (context->jobs == NULL)
+		return 0;
+
+	rc = 0;
+	for (n = 0; n != RTE_DIM(context->tries); n++) {
+		job = &context->jobs[n];
+		if (job->used == 0)
+			continue;
+
+		if (job->lcore != LCORE_ID_ANY) {
+			rte_eal_wait_lcore(job->lcore);
+			job->lcore = LCORE_ID_ANY;
+		}
+
+		if (job->rc != 0) {
+			RTE_LOG(ERR, ACL, "Build of %u-th trie failed\n", n);
+			rc = job->rc;
+			continue;
+		}
+
+		context->tries[n] = job->bcx.tries[n];
+		memcpy(context->data_indexes[n], job->bcx.data_indexes[n],
+			sizeof(context->data_indexes[n]));
+		context->tries[n].data_index = context->data_indexes[n];
+		context->bld_tries[n] = job->bcx.bld_tries[n];
+		context->num_nodes += job->bcx.num_nodes;
+	}
+
+	return rc;
+}
+
+static void
+acl_build_free_jobs(struct acl_build_context *context)
+{
+	uint32_t n;
+
+	if (context->jobs == NULL)
+		return;
+
+	for (n = 0; n != RTE_DIM(context->tries); n++) {
+		if (context->jobs[n].used != 0)
+			tb_free_pool(&context->jobs[n].bcx.pool);
+	}
+	context->jobs = NULL;
+}
+
 static int
 acl_build_tries(struct acl_build_context *context,
 	struct rte_acl_build_rule *head)
@@ -1356,6 +1503,10 @@ acl_build_tries(struct acl_build_context *context,
 
 	context->tries[0].type = RTE_ACL_FULL_TRIE;
 
+	if (context->num_lcores != 0)
+		context->jobs = acl_build_alloc(context,
+			RTE_DIM(context->tries), sizeof(context->jobs[0]));
+
 	/* calc wildness of each field of each rule */
 	acl_calc_wildness(head, config);
 
@@ -1398,8 +1549,7 @@ acl_build_tries(struct acl_build_context *context,
 		 * Rebuild the trie for the reduced rule-set.
 		 * Don't try to split it any further.
 		 */
-		last = build_one_trie(context, rule_sets, n, INT32_MAX);
-		if (context->bld_tries[n].trie == NULL || last != NULL) {
+		if (acl_build_trie_job(context, rule_sets, n) != 0) {
 			RTE_LOG(ERR, ACL, "Build of %u-th trie failed\n", n);
 			return -ENOMEM;
 		}
@@ -1499,7 +1649,8 @@ acl_set_data_indexes(struct rte_acl_ctx *ctx)
  */
 static int
 acl_bld(struct acl_build_context *bcx, struct rte_acl_ctx *ctx,
-	const struct rte_acl_config *cfg, uint32_t node_max)
+	const struct rte_acl_config *cfg, uint32_t node_max,
+	const unsigned int *lcores, uint32_t num_lcores)
 {
 	int32_t rc;
 
@@ -1512,11 +1663,14 @@ acl_bld(struct acl_build_context *bcx, struct rte_acl_ctx *ctx,
 	bcx->category_mask = RTE_LEN2MASK(bcx->cfg.num_categories,
 		typeof(bcx->category_mask));
 	bcx->node_max = node_max;
+	bcx->lcores = lcores;
+	bcx->num_lcores = num_lcores;
 
 	rc = sigsetjmp(bcx->pool.fail, 0);
 
 	/* build phase runs out of memory. */
 	if (rc != 0) {
+		acl_build_wait_jobs(bcx);
 		RTE_LOG(ERR, ACL,
 			"ACL context: %s, %s() failed with error code: %d\n",
 			bcx->acx->name, __func__, rc);
@@ -1534,6 +1688,8 @@ acl_bld(struct acl_build_context *bcx, struct rte_acl_ctx *ctx,
 	} else {
 		/* build internal trie representation. */
 		rc = acl_build_tries(bcx, bcx->build_rules);
+		if (acl_build_wait_jobs(bcx) != 0 && rc == 0)
+			rc = -ENOMEM;
 	}
 	return rc;
 }
@@ -1612,18 +1768,15 @@ get_first_load_size(const struct rte_acl_config *cfg)
 	return (ofs < max_ofs) ? sizeof(uint32_t) : sizeof(uint8_t);
 }
 
-int
-rte_acl_build(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg)
+static int
+acl_build_rt(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg,
+	const unsigned int *lcores, uint32_t num_lcores)
 {
 	int32_t rc;
 	uint32_t n;
 	size_t max_size;
 	struct acl_build_context bcx;
 
-	rc = acl_check_bld_param(ctx, cfg);
-	if (rc != 0)
-		return rc;
-
 	acl_build_reset(ctx);
 
 	if (cfg->max_size == 0) {
@@ -1637,7 +1790,7 @@ rte_acl_build(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg)
 	for (rc = -ERANGE; n >= NODE_MIN && rc == -ERANGE; n /= 2) {
 
 		/* perform build phase. */
-		rc = acl_bld(&bcx, ctx, cfg, n);
+		rc = acl_bld(&bcx, ctx, cfg, n, lcores, num_lcores);
 
 		if (rc == 0) {
 			/* allocate and fill run-time  structures. */
@@ -1660,8 +1813,103 @@ rte_acl_build(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg)
 		acl_build_log(&bcx);
 
 		/* cleanup after build. */
+		acl_build_free_jobs(&bcx);
 		tb_free_pool(&bcx.pool);
 	}
 
 	return rc;
 }
+
+/*
+ * Build the run-time structures into a shadow context, then publish it,
+ * so that classify never runs on partially built structures.
+ */
+static int
+acl_build_shadow(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg,
+	const unsigned int *lcores, uint32_t num_lcores)
+{
+	int32_t rc;
+	struct rte_acl_ctx *rt, *old;
+
+	rt = rte_zmalloc_socket(ctx->name, sizeof(*rt), RTE_CACHE_LINE_SIZE,
+		ctx->socket_id);
+	if (rt == NULL) {
+		RTE_LOG(ERR, ACL,
+			"allocation of %zu bytes on socket %d for %s failed\n",
+			sizeof(*rt), ctx->socket_id, ctx->name);
+		return -ENOMEM;
+	}
+
+	/* the shadow shares the rules and parameters of the context. */
+	memcpy(rt, ctx, offsetof(struct rte_acl_ctx, num_categories));
+	rt->v = NULL;
+	rt->rt = NULL;
+
+	rc = acl_build_rt(rt, cfg, lcores, num_lcores);
+	if (rc != 0) {
+		rte_free(rt->mem);
+		rte_free(rt);
+		return rc;
+	}
+
+	old = ctx->rt;
+	__atomic_store_n(&ctx->rt, rt, __ATOMIC_RELEASE);
+
+	/* wait for the lookups still running on the previous structures. */
+	rte_rcu_qsbr_synchronize(ctx->v, RTE_QSBR_THRID_INVALID);
+
+	if (old != NULL) {
+		rte_free(old->mem);
+		rte_free(old);
+	} else {
+		/* structures built before RCU was associated. */
+		acl_build_reset(ctx);
+	}
+
+	ctx->config = rt->config;
+	return 0;
+}
+
+static int
+acl_build(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg,
+	const unsigned int *lcores, uint32_t num_lcores)
+{
+	int32_t rc;
+
+	rc = acl_check_bld_param(ctx, cfg);
+	if (rc != 0)
+		return rc;
+
+	if (ctx->v != NULL)
+		return acl_build_shadow(ctx, cfg, lcores, num_lcores);
+
+	return acl_build_rt(ctx, cfg, lcores, num_lcores);
+}
+
+int
+rte_acl_build(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg)
+{
+	return acl_build(ctx, cfg, NULL, 0);
+}
+
+int
+rte_acl_build_parallel(struct rte_acl_ctx *ctx,
+	const struct rte_acl_config *cfg, const unsigned int lcores[],
+	uint32_t num_lcores)
+{
+	uint32_t i;
+
+	if (lcores == NULL && num_lcores != 0)
+		return -EINVAL;
+
+	/* tries can only be launched on idle worker lcores. */
+	for (i = 0; i != num_lcores; i++) {
+		if (lcores[i] >= RTE_MAX_LCORE ||
+				!rte_lcore_is_enabled(lcores[i]) ||
+				lcores[i] == rte_get_main_lcore() ||
+				lcores[i] == rte_lcore_id())
+			return -EINVAL;
+	}
+
+	return acl_build(ctx, cfg, lcores, num_lcores);
+}
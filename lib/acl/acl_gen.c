@@ -23,6 +23,7 @@ struct acl_node_counters {
 };
 
 struct rte_acl_indices {
+	int32_t dfa_start;
 	int32_t dfa_index;
 	int32_t quad_index;
 	int32_t single_index;
@@ -40,52 +41,24 @@ acl_gen_log_stats(const struct rte_acl_ctx *ctx,
 		"runtime memory footprint on socket %d:\n"
 		"single nodes/bytes used: %d/%zu\n"
 		"quad nodes/vectors/bytes used: %d/%d/%zu\n"
-		"DFA nodes/group64/bytes used: %d/%d/%zu\n"
+		"DFA nodes/group64/bytes used: %d/%d/%zu "
+		"(%zu without shared transitions)\n"
 		"match nodes/bytes used: %d/%zu\n"
 		"total: %zu bytes\n"
 		"max limit: %zu bytes\n",
 		ctx->name, ctx->socket_id,
 		counts->single, counts->single * sizeof(uint64_t),
 		counts->quad, counts->quad_vectors,
-		(indices->quad_index - indices->dfa_index) * sizeof(uint64_t),
+		counts->quad_vectors * sizeof(uint64_t),
 		counts->dfa, counts->dfa_gr64,
-		indices->dfa_index * sizeof(uint64_t),
+		(indices->dfa_index - indices->dfa_start) * sizeof(uint64_t),
+		counts->dfa_gr64 * RTE_ACL_DFA_GR64_SIZE * sizeof(uint64_t),
 		counts->match,
 		counts->match * sizeof(struct rte_acl_match_results),
 		ctx->mem_sz,
 		max_size);
 }
 
-static uint64_t
-acl_dfa_gen_idx(const struct rte_acl_node *node, uint32_t index)
-{
-	uint64_t idx;
-	uint32_t i;
-
-	idx = 0;
-	for (i = 0; i != RTE_DIM(node->dfa_gr64); i++) {
-		RTE_ACL_VERIFY(node->dfa_gr64[i] < RTE_ACL_DFA_GR64_NUM);
-		RTE_ACL_VERIFY(node->dfa_gr64[i] < node->fanout);
-		idx |= (i - node->dfa_gr64[i]) <<
-			(6 + RTE_ACL_DFA_GR64_BIT * i);
-	}
-
-	return idx << (CHAR_BIT * sizeof(index)) | index | node->node_type;
-}
-
-static void
-acl_dfa_fill_gr64(const struct rte_acl_node *node,
-	const uint64_t src[RTE_ACL_DFA_SIZE], uint64_t dst[RTE_ACL_DFA_SIZE])
-{
-	uint32_t i;
-
-	for (i = 0; i != RTE_DIM(node->dfa_gr64); i++) {
-		memcpy(dst + node->dfa_gr64[i] * RTE_ACL_DFA_GR64_SIZE,
-			src + i * RTE_ACL_DFA_GR64_SIZE,
-			RTE_ACL_DFA_GR64_SIZE * sizeof(dst[0]));
-	}
-}
-
 static uint32_t
 acl_dfa_count_gr64(const uint64_t array_ptr[RTE_ACL_DFA_SIZE],
 	uint8_t gr64[RTE_ACL_DFA_GR64_NUM])
@@ -317,21 +290,113 @@ acl_add_ptrs(struct rte_acl_node *node, uint64_t *node_array, uint64_t no_match,
 
 		RTE_ACL_VERIFY(m <= RTE_ACL_QUAD_SIZE);
 
-	} else if (node->node_type == RTE_ACL_NODE_DFA && resolved) {
-		acl_dfa_fill_gr64(node, dfa, node_array);
 	}
 }
 
+/*
+ * Find the lowest position within [lo, end] at which the given transitions
+ * can be stored, so that they reuse transitions already stored there.
+ */
+static uint32_t
+acl_dfa_find_pos(const uint64_t node_array[], uint32_t lo, uint32_t end,
+	const uint64_t src[], uint32_t num)
+{
+	uint32_t k, n, pos;
+
+	for (pos = lo; pos != end; pos++) {
+		n = RTE_MIN(end - pos, num);
+		for (k = 0; k != n && node_array[pos + k] == src[k]; k++)
+			;
+		if (k == n)
+			break;
+	}
+
+	return pos;
+}
+
+/*
+ * Place the groups of a resolved DFA node at the end of the DFA region.
+ * The per-group offset stored in the node's transition lets a group start
+ * up to UINT8_MAX entries before its nominal position, so each group is
+ * placed at the lowest position where it matches the transitions already
+ * generated: it can be shared with an identical group (of this node or of
+ * the previous ones), or overlap the tail of the previous group.
+ * Root nodes are indexed by the input byte directly and always take
+ * RTE_ACL_DFA_SIZE consecutive transitions.
+ */
+static void
+acl_dfa_gen_node(struct rte_acl_node *node, uint64_t *node_array,
+	uint64_t no_match, struct rte_acl_indices *index, int root)
+{
+	uint32_t i, end, lo, pos[RTE_ACL_DFA_GR64_NUM];
+	uint64_t idx, dfa[RTE_ACL_DFA_SIZE];
+
+	acl_node_fill_dfa(node, dfa, no_match, 1);
+
+	end = index->dfa_index;
+
+	if (root != 0) {
+		lo = end - RTE_MIN(end - index->dfa_start,
+			(uint32_t)RTE_ACL_DFA_SIZE - 1);
+		pos[0] = acl_dfa_find_pos(node_array, lo, end, dfa,
+			RTE_ACL_DFA_SIZE);
+		for (i = 1; i != RTE_DIM(pos); i++)
+			pos[i] = pos[0] + i * RTE_ACL_DFA_GR64_SIZE;
+		memcpy(node_array + pos[0], dfa, sizeof(dfa));
+		end = RTE_MAX(end, pos[0] + RTE_ACL_DFA_SIZE);
+	} else {
+		for (i = 0; i != RTE_DIM(pos); i++) {
+			/*
+			 * first group can't be fully contained in the
+			 * previous ones, so that the positions of the next
+			 * groups are never above their nominal position.
+			 */
+			if (i == 0)
+				lo = end - RTE_MIN(end - index->dfa_start,
+					(uint32_t)RTE_ACL_DFA_GR64_SIZE - 1);
+			else {
+				lo = pos[0] + i * RTE_ACL_DFA_GR64_SIZE;
+				lo -= RTE_MIN(lo - index->dfa_start,
+					(uint32_t)UINT8_MAX);
+			}
+
+			pos[i] = acl_dfa_find_pos(node_array, lo, end,
+				dfa + i * RTE_ACL_DFA_GR64_SIZE,
+				RTE_ACL_DFA_GR64_SIZE);
+			memcpy(node_array + pos[i],
+				dfa + i * RTE_ACL_DFA_GR64_SIZE,
+				RTE_ACL_DFA_GR64_SIZE * sizeof(dfa[0]));
+			end = RTE_MAX(end, pos[i] + RTE_ACL_DFA_GR64_SIZE);
+		}
+	}
+
+	idx = 0;
+	for (i = 0; i != RTE_DIM(pos); i++) {
+		RTE_ACL_VERIFY(pos[0] + i * RTE_ACL_DFA_GR64_SIZE >= pos[i]);
+		RTE_ACL_VERIFY(pos[0] + i * RTE_ACL_DFA_GR64_SIZE - pos[i] <=
+			UINT8_MAX);
+		idx |= (uint64_t)(pos[0] + i * RTE_ACL_DFA_GR64_SIZE - pos[i]) <<
+			(RTE_ACL_DFA_GR64_BIT * i);
+	}
+
+	node->node_index = idx << (CHAR_BIT * sizeof(pos[0])) | pos[0] |
+		node->node_type;
+	index->dfa_index = end;
+}
+
 /*
  * Routine that allocates space for this node and recursively calls
  * to allocate space for each child. Once all the children are allocated,
  * then resolve all transitions for this node.
+ * DFA nodes are allocated only once their transitions are resolved,
+ * see acl_dfa_gen_node().
  */
 static void
 acl_gen_node(struct rte_acl_node *node, uint64_t *node_array,
-	uint64_t no_match, struct rte_acl_indices *index, int num_categories)
+	uint64_t no_match, struct rte_acl_indices *index, int num_categories,
+	int root)
 {
-	uint32_t n, sz, *qtrp;
+	uint32_t n, *qtrp;
 	uint64_t *array_ptr;
 	struct rte_acl_match_results *match;
 
@@ -342,12 +407,6 @@ acl_gen_node(struct rte_acl_node *node, uint64_t *node_array,
 
 	switch (node->node_type) {
 	case RTE_ACL_NODE_DFA:
-		array_ptr = &node_array[index->dfa_index];
-		node->node_index = acl_dfa_gen_idx(node, index->dfa_index);
-		sz = node->fanout * RTE_ACL_DFA_GR64_SIZE;
-		index->dfa_index += sz;
-		for (n = 0; n < sz; n++)
-			array_ptr[n] = no_match;
 		break;
 	case RTE_ACL_NODE_SINGLE:
 		node->node_index = RTE_ACL_QUAD_SINGLE | index->single_index |
@@ -388,13 +447,14 @@ acl_gen_node(struct rte_acl_node *node, uint64_t *node_array,
 				node_array,
 				no_match,
 				index,
-				num_categories);
+				num_categories,
+				0);
 	}
 
 	/* All children are resolved, resolve this node's pointers */
 	switch (node->node_type) {
 	case RTE_ACL_NODE_DFA:
-		acl_add_ptrs(node, array_ptr, no_match, 1);
+		acl_dfa_gen_node(node, node_array, no_match, index, root);
 		break;
 	case RTE_ACL_NODE_SINGLE:
 		for (n = 0; n < node->num_ptrs; n++) {
@@ -431,14 +491,30 @@ acl_calc_counts_indices(struct acl_node_counters *counts,
 			no_match, 1);
 	}
 
-	indices->dfa_index = RTE_ACL_DFA_SIZE + 1;
-	indices->quad_index = indices->dfa_index +
-		counts->dfa_gr64 * RTE_ACL_DFA_GR64_SIZE;
+	/*
+	 * DFA nodes are placed last, as the space they take is known
+	 * only once they are generated.
+	 */
+	indices->quad_index = RTE_ACL_DFA_SIZE + 1;
 	indices->single_index = indices->quad_index + counts->quad_vectors;
 	indices->match_start = indices->single_index + counts->single + 1;
 	indices->match_start = RTE_ALIGN(indices->match_start,
 		(XMM_SIZE / sizeof(uint64_t)));
 	indices->match_index = 1;
+	indices->dfa_start = indices->match_start + (counts->match + 1) *
+		sizeof(struct rte_acl_match_results) / sizeof(uint64_t);
+	indices->dfa_index = indices->dfa_start;
+}
+
+static int
+acl_gen_max_size_err(const struct rte_acl_ctx *ctx, size_t size,
+	size_t max_size)
+{
+	RTE_LOG(DEBUG, ACL,
+		"Gen phase for ACL ctx \"%s\" exceeds max_size limit, "
+		"bytes required: %zu, allowed: %zu\n",
+		ctx->name, size, max_size);
+	return -ERANGE;
 }
 
 /*
@@ -449,8 +525,8 @@ rte_acl_gen(struct rte_acl_ctx *ctx, struct rte_acl_trie *trie,
 	struct rte_acl_bld_trie *node_bld_trie, uint32_t num_tries,
 	uint32_t num_categories, uint32_t data_index_sz, size_t max_size)
 {
-	void *mem;
-	size_t total_size;
+	void *mem, *gen_mem;
+	size_t data_sz, gen_size, total_size;
 	uint64_t *node_array, no_match;
 	uint32_t n, match_index;
 	struct rte_acl_match_results *match;
@@ -463,23 +539,25 @@ rte_acl_gen(struct rte_acl_ctx *ctx, struct rte_acl_trie *trie,
 	acl_calc_counts_indices(&counts, &indices,
 		node_bld_trie, num_tries, no_match);
 
-	/* Allocate runtime memory (align to cache boundary) */
-	total_size = RTE_ALIGN(data_index_sz, RTE_CACHE_LINE_SIZE) +
-		indices.match_start * sizeof(uint64_t) +
-		(counts.match + 1) * sizeof(struct rte_acl_match_results) +
+	/*
+	 * Allocate runtime memory (align to cache boundary), for the worst
+	 * case of DFA nodes not sharing any of their transitions.
+	 */
+	data_sz = RTE_ALIGN(data_index_sz, RTE_CACHE_LINE_SIZE);
+	total_size = data_sz + (indices.dfa_start +
+		counts.dfa_gr64 * RTE_ACL_DFA_GR64_SIZE) * sizeof(uint64_t) +
 		XMM_SIZE;
 
-	if (total_size > max_size) {
-		RTE_LOG(DEBUG, ACL,
-			"Gen phase for ACL ctx \"%s\" exceeds max_size limit, "
-			"bytes required: %zu, allowed: %zu\n",
-			ctx->name, total_size, max_size);
-		return -ERANGE;
-	}
+	gen_size = data_sz + indices.dfa_start * sizeof(uint64_t) + XMM_SIZE;
+	if (gen_size > max_size)
+		return acl_gen_max_size_err(ctx, gen_size, max_size);
 
 	mem = rte_zmalloc_socket(ctx->name, total_size, RTE_CACHE_LINE_SIZE,
 			ctx->socket_id);
 	if (mem == NULL) {
+		/* it might still have fit within the limit, let caller retry */
+		if (total_size > max_size)
+			return acl_gen_max_size_err(ctx, total_size, max_size);
 		RTE_LOG(ERR, ACL,
 			"allocation of %zu bytes on socket %d for %s failed\n",
 			total_size, ctx->socket_id, ctx->name);
@@ -488,8 +566,7 @@ rte_acl_gen(struct rte_acl_ctx *ctx, struct rte_acl_trie *trie,
 
 	/* Fill the runtime structure */
 	match_index = indices.match_start;
-	node_array = (uint64_t *)((uintptr_t)mem +
-		RTE_ALIGN(data_index_sz, RTE_CACHE_LINE_SIZE));
+	node_array = (uint64_t *)((uintptr_t)mem + data_sz);
 
 	/*
 	 * Setup the NOMATCH node (a SINGLE at the
@@ -508,7 +585,7 @@ rte_acl_gen(struct rte_acl_ctx *ctx, struct rte_acl_trie *trie,
 	for (n = 0; n < num_tries; n++) {
 
 		acl_gen_node(node_bld_trie[n].trie, node_array, no_match,
-			&indices, num_categories);
+			&indices, num_categories, 1);
 
 		if (node_bld_trie[n].trie->node_index == no_match)
 			trie[n].root_index = 0;
@@ -516,6 +593,26 @@ rte_acl_gen(struct rte_acl_ctx *ctx, struct rte_acl_trie *trie,
 			trie[n].root_index = node_bld_trie[n].trie->node_index;
 	}
 
+	/* Shrink runtime memory to the space DFA nodes actually take */
+	gen_size = data_sz + indices.dfa_index * sizeof(uint64_t) + XMM_SIZE;
+
+	if (gen_size > max_size) {
+		rte_free(mem);
+		return acl_gen_max_size_err(ctx, gen_size, max_size);
+	}
+
+	if (gen_size != total_size) {
+		gen_mem = rte_zmalloc_socket(ctx->name, gen_size,
+			RTE_CACHE_LINE_SIZE, ctx->socket_id);
+		if (gen_mem != NULL) {
+			memcpy(gen_mem, mem, gen_size - XMM_SIZE);
+			rte_free(mem);
+			mem = gen_mem;
+			total_size = gen_size;
+			node_array = (uint64_t *)((uintptr_t)mem + data_sz);
+		}
+	}
+
 	ctx->mem = mem;
 	ctx->mem_sz = total_size;
 	ctx->data_indexes = mem;
@@ -3,6 +3,7 @@
  */
 
 #include <rte_eal_memconfig.h>
+#include <rte_lcore.h>
 #include <rte_string_fns.h>
 #include <rte_acl.h>
 #include <rte_tailq.h>
@@ -17,6 +18,15 @@ static struct rte_tailq_elem rte_acl_tailq = {
 };
 EAL_REGISTER_TAILQ(rte_acl_tailq)
 
+struct rte_acl_numa {
+	/* Replica used by the lcores of each socket. */
+	struct rte_acl_ctx *local[RTE_MAX_NUMA_NODES];
+	/* Replica used by the threads with no socket. */
+	struct rte_acl_ctx *def;
+	uint32_t n_replicas;
+	struct rte_acl_ctx *replicas[RTE_MAX_NUMA_NODES];
+};
+
 #ifndef CC_AVX512_SUPPORT
 /*
  * If the compiler doesn't support AVX512 instructions,
@@ -296,7 +306,8 @@ rte_acl_classify_alg(const struct rte_acl_ctx *ctx, const uint8_t **data,
 			((RTE_ACL_RESULTS_MULTIPLIER - 1) & categories) != 0)
 		return -EINVAL;
 
-	return classify_fns[alg](ctx, data, results, num, categories);
+	return classify_fns[alg](acl_rt_ctx(ctx), data, results, num,
+		categories);
 }
 
 int
@@ -358,6 +369,10 @@ rte_acl_free(struct rte_acl_ctx *ctx)
 
 	rte_mcfg_tailq_write_unlock();
 
+	if (ctx->rt != NULL) {
+		rte_free(ctx->rt->mem);
+		rte_free(ctx->rt);
+	}
 	rte_free(ctx->mem);
 	rte_free(ctx);
 	rte_free(te);
@@ -484,6 +499,49 @@ rte_acl_add_rules(struct rte_acl_ctx *ctx, const struct rte_acl_rule *rules,
 	return acl_add_rules(ctx, rules, num);
 }
 
+int
+rte_acl_del_rules(struct rte_acl_ctx *ctx, const uint32_t userdata[],
+	uint32_t num)
+{
+	const struct rte_acl_rule *rv;
+	uint8_t *pos;
+	uint32_t i, j, n, num_del;
+
+	if (ctx == NULL || userdata == NULL)
+		return -EINVAL;
+
+	/* compact the remaining rules, keeping their order */
+	pos = ctx->rules;
+	for (i = 0, n = 0; i != ctx->num_rules; i++) {
+		rv = (const struct rte_acl_rule *)
+			((uintptr_t)ctx->rules + i * ctx->rule_sz);
+		for (j = 0; j != num && rv->data.userdata != userdata[j]; j++)
+			;
+		if (j != num)
+			continue;
+		if (n != i)
+			memcpy(pos + n * ctx->rule_sz, rv, ctx->rule_sz);
+		n++;
+	}
+
+	num_del = ctx->num_rules - n;
+	ctx->num_rules = n;
+	return num_del;
+}
+
+int
+rte_acl_rcu_qsbr_add(struct rte_acl_ctx *ctx, struct rte_rcu_qsbr *v)
+{
+	if (ctx == NULL || v == NULL)
+		return -EINVAL;
+
+	if (ctx->v != NULL)
+		return -EEXIST;
+
+	ctx->v = v;
+	return 0;
+}
+
 /*
  * Reset all rules.
  * Note that RT structures are not affected.
@@ -501,8 +559,20 @@ rte_acl_reset_rules(struct rte_acl_ctx *ctx)
 void
 rte_acl_reset(struct rte_acl_ctx *ctx)
 {
+	struct rte_acl_ctx *rt;
+
 	if (ctx != NULL) {
 		rte_acl_reset_rules(ctx);
+
+		/* withdraw the structures published by a background build. */
+		rt = ctx->rt;
+		if (rt != NULL) {
+			__atomic_store_n(&ctx->rt, NULL, __ATOMIC_RELEASE);
+			rte_rcu_qsbr_synchronize(ctx->v, RTE_QSBR_THRID_INVALID);
+			rte_free(rt->mem);
+			rte_free(rt);
+		}
+
 		rte_acl_build(ctx, &ctx->config);
 	}
 }
@@ -513,17 +583,20 @@ rte_acl_reset(struct rte_acl_ctx *ctx)
 void
 rte_acl_dump(const struct rte_acl_ctx *ctx)
 {
+	const struct rte_acl_ctx *rt;
+
 	if (!ctx)
 		return;
+	rt = acl_rt_ctx(ctx);
 	printf("acl context <%s>@%p\n", ctx->name, ctx);
 	printf("  socket_id=%"PRId32"\n", ctx->socket_id);
 	printf("  alg=%"PRId32"\n", ctx->alg);
-	printf("  first_load_sz=%"PRIu32"\n", ctx->first_load_sz);
+	printf("  first_load_sz=%"PRIu32"\n", rt->first_load_sz);
 	printf("  max_rules=%"PRIu32"\n", ctx->max_rules);
 	printf("  rule_size=%"PRIu32"\n", ctx->rule_sz);
 	printf("  num_rules=%"PRIu32"\n", ctx->num_rules);
-	printf("  num_categories=%"PRIu32"\n", ctx->num_categories);
-	printf("  num_tries=%"PRIu32"\n", ctx->num_tries);
+	printf("  num_categories=%"PRIu32"\n", rt->num_categories);
+	printf("  num_tries=%"PRIu32"\n", rt->num_tries);
 }
 
 /*
@@ -545,3 +618,203 @@ rte_acl_list_dump(void)
 	}
 	rte_mcfg_tailq_read_unlock();
 }
+
+static inline struct rte_acl_ctx *
+acl_numa_local(const struct rte_acl_numa *an)
+{
+	uint32_t socket_id = rte_socket_id();
+
+	if (unlikely(socket_id >= RTE_MAX_NUMA_NODES))
+		return an->def;
+	return an->local[socket_id];
+}
+
+struct rte_acl_numa *
+rte_acl_numa_create(const struct rte_acl_param *param)
+{
+	char name[RTE_ACL_NAMESIZE];
+	struct rte_acl_param prm;
+	struct rte_acl_numa *an;
+	struct rte_acl_ctx *ctx;
+	uint32_t i, lcore_id, socket_id;
+
+	if (param == NULL || param->name == NULL) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	an = rte_zmalloc("ACL_NUMA", sizeof(*an), RTE_CACHE_LINE_SIZE);
+	if (an == NULL) {
+		rte_errno = ENOMEM;
+		return NULL;
+	}
+
+	prm = *param;
+	prm.name = name;
+
+	RTE_LCORE_FOREACH(lcore_id) {
+		socket_id = rte_lcore_to_socket_id(lcore_id);
+		if (socket_id >= RTE_MAX_NUMA_NODES ||
+				an->local[socket_id] != NULL)
+			continue;
+
+		if (snprintf(name, sizeof(name), "%s_%u", param->name,
+				socket_id) >= (int)sizeof(name)) {
+			rte_errno = ENAMETOOLONG;
+			goto error;
+		}
+		prm.socket_id = socket_id;
+		ctx = rte_acl_create(&prm);
+		if (ctx == NULL)
+			goto error;
+
+		an->local[socket_id] = ctx;
+		an->replicas[an->n_replicas++] = ctx;
+	}
+
+	if (an->n_replicas == 0) {
+		rte_errno = ENODEV;
+		goto error;
+	}
+
+	socket_id = rte_lcore_to_socket_id(rte_get_main_lcore());
+	an->def = (socket_id < RTE_MAX_NUMA_NODES) ?
+		an->local[socket_id] : NULL;
+	if (an->def == NULL)
+		an->def = an->replicas[0];
+
+	/* the sockets with no lcore share the default replica. */
+	for (socket_id = 0; socket_id != RTE_MAX_NUMA_NODES; socket_id++)
+		if (an->local[socket_id] == NULL)
+			an->local[socket_id] = an->def;
+
+	return an;
+
+error:
+	for (i = 0; i != an->n_replicas; i++)
+		rte_acl_free(an->replicas[i]);
+	rte_free(an);
+	return NULL;
+}
+
+void
+rte_acl_numa_free(struct rte_acl_numa *an)
+{
+	uint32_t i;
+
+	if (an == NULL)
+		return;
+
+	for (i = 0; i != an->n_replicas; i++)
+		rte_acl_free(an->replicas[i]);
+	rte_free(an);
+}
+
+/*
+ * The replicas get the same rules and have the same capacity,
+ * so that only the first one can refuse them.
+ */
+int
+rte_acl_numa_add_rules(struct rte_acl_numa *an,
+	const struct rte_acl_rule *rules, uint32_t num)
+{
+	uint32_t i;
+	int32_t rc;
+
+	if (an == NULL)
+		return -EINVAL;
+
+	for (i = 0; i != an->n_replicas; i++) {
+		rc = rte_acl_add_rules(an->replicas[i], rules, num);
+		if (rc != 0)
+			return rc;
+	}
+	return 0;
+}
+
+int
+rte_acl_numa_del_rules(struct rte_acl_numa *an, const uint32_t userdata[],
+	uint32_t num)
+{
+	uint32_t i;
+	int32_t rc = 0;
+
+	if (an == NULL)
+		return -EINVAL;
+
+	for (i = 0; i != an->n_replicas; i++) {
+		rc = rte_acl_del_rules(an->replicas[i], userdata, num);
+		if (rc < 0)
+			return rc;
+	}
+	return rc;
+}
+
+void
+rte_acl_numa_reset_rules(struct rte_acl_numa *an)
+{
+	uint32_t i;
+
+	if (an == NULL)
+		return;
+
+	for (i = 0; i != an->n_replicas; i++)
+		rte_acl_reset_rules(an->replicas[i]);
+}
+
+int
+rte_acl_numa_build(struct rte_acl_numa *an, const struct rte_acl_config *cfg)
+{
+	uint32_t i;
+	int32_t rc;
+
+	if (an == NULL)
+		return -EINVAL;
+
+	for (i = 0; i != an->n_replicas; i++) {
+		rc = rte_acl_build(an->replicas[i], cfg);
+		if (rc != 0)
+			return rc;
+	}
+	return 0;
+}
+
+int
+rte_acl_numa_rcu_qsbr_add(struct rte_acl_numa *an, struct rte_rcu_qsbr *v)
+{
+	uint32_t i;
+	int32_t rc;
+
+	if (an == NULL)
+		return -EINVAL;
+
+	for (i = 0; i != an->n_replicas; i++) {
+		rc = rte_acl_rcu_qsbr_add(an->replicas[i], v);
+		if (rc != 0)
+			return rc;
+	}
+	return 0;
+}
+
+int
+rte_acl_numa_classify(const struct rte_acl_numa *an, const uint8_t **data,
+	uint32_t *results, uint32_t num, uint32_t categories)
+{
+	if (an == NULL)
+		return -EINVAL;
+
+	return rte_acl_classify(acl_numa_local(an), data, results, num,
+		categories);
+}
+
+struct rte_acl_ctx *
+rte_acl_numa_get(struct rte_acl_numa *an, int socket_id)
+{
+	if (an == NULL)
+		return NULL;
+	if (socket_id == SOCKET_ID_ANY)
+		return acl_numa_local(an);
+	if (socket_id < 0 || socket_id >= RTE_MAX_NUMA_NODES)
+		return NULL;
+	return an->local[socket_id];
+}
@@ -12,6 +12,7 @@
  */
 
 #include <rte_acl_osdep.h>
+#include <rte_rcu_qsbr.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -192,6 +193,58 @@ int
 rte_acl_add_rules(struct rte_acl_ctx *ctx, const struct rte_acl_rule *rules,
 	uint32_t num);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Delete rules from an existing ACL context.
+ * All the rules whose userdata matches one of the given values are removed,
+ * the order of the remaining rules is preserved.
+ * This function is not multi-thread safe.
+ * Note that internal run-time structures are not affected,
+ * rte_acl_build() has to be called for the change to take effect.
+ *
+ * @param ctx
+ *   ACL context to delete rules from.
+ * @param userdata
+ *   Array of userdata values identifying the rules to delete.
+ * @param num
+ *   Number of elements in the userdata array.
+ * @return
+ *   - -EINVAL if the parameters are invalid.
+ *   - Number of rules deleted otherwise.
+ */
+__rte_experimental
+int
+rte_acl_del_rules(struct rte_acl_ctx *ctx, const uint32_t userdata[],
+	uint32_t num);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Associate RCU QSBR variable with an ACL context.
+ *
+ * Once associated, rte_acl_build() generates the new run-time structures
+ * aside while the lcores keep classifying with the previous ones,
+ * then publishes them atomically. The previous run-time structures are
+ * freed once all the readers registered on the QSBR variable have reported
+ * a quiescent state, writer side blocking until then.
+ * If the build fails, the previous run-time structures stay in use.
+ *
+ * @param ctx
+ *   ACL context to add RCU QSBR to.
+ * @param v
+ *   RCU QSBR variable the classifying lcores report quiescent state on.
+ * @return
+ *   - -EINVAL if the parameters are invalid.
+ *   - -EEXIST if a QSBR variable is already associated.
+ *   - Zero if operation completed successfully.
+ */
+__rte_experimental
+int
+rte_acl_rcu_qsbr_add(struct rte_acl_ctx *ctx, struct rte_rcu_qsbr *v);
+
 /**
  * Delete all rules from the ACL context.
  * This function is not multi-thread safe.
@@ -220,6 +273,42 @@ rte_acl_reset_rules(struct rte_acl_ctx *ctx);
 int
 rte_acl_build(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Analyze set of rules and build required internal run-time structures,
+ * spreading the work over a set of worker lcores.
+ * The rules are split into tries by the calling thread, as with
+ * rte_acl_build(); each time a trie is split off, its final build is
+ * launched on one of the given lcores while the calling thread goes on
+ * with the remaining rules. The resulting run-time structures are the same
+ * as the ones built by rte_acl_build().
+ * This function is not multi-thread safe.
+ *
+ * @param ctx
+ *   ACL context to build.
+ * @param cfg
+ *   Pointer to struct rte_acl_config - defines build parameters.
+ * @param lcores
+ *   Array of worker lcores to build the tries on. They must be idle,
+ *   tries are run on them with rte_eal_remote_launch().
+ *   Neither the main lcore nor the calling lcore can be part of it.
+ * @param num_lcores
+ *   Number of elements in the lcores array. With zero,
+ *   the function behaves as rte_acl_build().
+ * @return
+ *   - -ENOMEM if couldn't allocate enough memory.
+ *   - -EINVAL if the parameters are invalid.
+ *   - Negative error code if operation failed.
+ *   - Zero if operation completed successfully.
+ */
+__rte_experimental
+int
+rte_acl_build_parallel(struct rte_acl_ctx *ctx,
+	const struct rte_acl_config *cfg, const unsigned int lcores[],
+	uint32_t num_lcores);
+
 /**
  * Delete all rules from the ACL context and
  * destroy all internal run-time structures.
@@ -339,6 +428,194 @@ extern int
 rte_acl_set_ctx_classify(struct rte_acl_ctx *ctx,
 	enum rte_acl_classify_alg alg);
 
+/** ACL context replicated on each NUMA socket. */
+struct rte_acl_numa;
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Create an ACL context replicated on each NUMA socket having enabled lcores.
+ * Each replica is an ACL context allocated on its socket, named after the
+ * given name and the socket ID, so that the classification of an lcore only
+ * reads the memory of its own socket. The threads with no socket use the
+ * replica of the main lcore socket.
+ *
+ * The rules have to be updated and built through the rte_acl_numa_*()
+ * functions, which apply them to all the replicas one after the other.
+ *
+ * @param param
+ *   Parameters used to create and initialise the ACL contexts,
+ *   the socket ID is ignored.
+ * @return
+ *   Pointer to the replicated ACL context on success, NULL otherwise with
+ *   rte_errno set, see rte_acl_create().
+ */
+__rte_experimental
+struct rte_acl_numa *
+rte_acl_numa_create(const struct rte_acl_param *param);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Free a replicated ACL context and all its replicas.
+ *
+ * @param an
+ *   Replicated ACL context to free, can be NULL.
+ */
+__rte_experimental
+void
+rte_acl_numa_free(struct rte_acl_numa *an);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Add rules to all the replicas of a replicated ACL context,
+ * see rte_acl_add_rules().
+ *
+ * @param an
+ *   Replicated ACL context to add rules to.
+ * @param rules
+ *   Array of rules to add to the ACL context.
+ * @param num
+ *   Number of elements in the input array of rules.
+ * @return
+ *   - -ENOMEM if there is no space in the ACL context for these rules.
+ *   - -EINVAL if the parameters are invalid.
+ *   - Zero if operation completed successfully.
+ */
+__rte_experimental
+int
+rte_acl_numa_add_rules(struct rte_acl_numa *an,
+	const struct rte_acl_rule *rules, uint32_t num);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Delete rules from all the replicas of a replicated ACL context,
+ * see rte_acl_del_rules().
+ *
+ * @param an
+ *   Replicated ACL context to delete rules from.
+ * @param userdata
+ *   Array of userdata values identifying the rules to delete.
+ * @param num
+ *   Number of elements in the userdata array.
+ * @return
+ *   - -EINVAL if the parameters are invalid.
+ *   - Number of rules deleted from each replica otherwise.
+ */
+__rte_experimental
+int
+rte_acl_numa_del_rules(struct rte_acl_numa *an, const uint32_t userdata[],
+	uint32_t num);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Delete all rules from all the replicas of a replicated ACL context.
+ *
+ * @param an
+ *   Replicated ACL context to delete rules from.
+ */
+__rte_experimental
+void
+rte_acl_numa_reset_rules(struct rte_acl_numa *an);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Build the run-time structures of all the replicas of a replicated ACL
+ * context, each one on its socket, see rte_acl_build().
+ * If a replica fails to build, the replicas already built classify with
+ * the new rules, and the others with the rules of their previous build,
+ * until the next successful build.
+ *
+ * @param an
+ *   Replicated ACL context to build.
+ * @param cfg
+ *   Pointer to struct rte_acl_config - configuration parameters.
+ * @return
+ *   - -ENOMEM if couldn't allocate enough memory.
+ *   - -EINVAL if the parameters are invalid.
+ *   - Negative error code if operation failed.
+ *   - Zero if operation completed successfully.
+ */
+__rte_experimental
+int
+rte_acl_numa_build(struct rte_acl_numa *an, const struct rte_acl_config *cfg);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Associate RCU QSBR variable with all the replicas of a replicated ACL
+ * context, see rte_acl_rcu_qsbr_add().
+ *
+ * @param an
+ *   Replicated ACL context to add RCU QSBR to.
+ * @param v
+ *   RCU QSBR variable the classifying lcores report quiescent state on.
+ * @return
+ *   - -EINVAL if the parameters are invalid.
+ *   - -EEXIST if a QSBR variable is already associated, the replicas
+ *     before the failing one keep the QSBR variable.
+ *   - Zero if operation completed successfully.
+ */
+__rte_experimental
+int
+rte_acl_numa_rcu_qsbr_add(struct rte_acl_numa *an, struct rte_rcu_qsbr *v);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Classify input data buffers with the replica of the socket of the calling
+ * lcore, see rte_acl_classify().
+ *
+ * @param an
+ *   Replicated ACL context to search with.
+ * @param data
+ *   Array of pointers to input data buffers to perform search.
+ * @param results
+ *   Array of search results, *categories* results per each input data buffer.
+ * @param num
+ *   Number of elements in the input data buffers array.
+ * @param categories
+ *   Number of maximum possible matches for each input buffer, one possible
+ *   match per category.
+ * @return
+ *   zero on successful completion.
+ *   -EINVAL for incorrect arguments.
+ */
+__rte_experimental
+int
+rte_acl_numa_classify(const struct rte_acl_numa *an, const uint8_t **data,
+	uint32_t *results, uint32_t num, uint32_t categories);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Get the replica used by the lcores of a socket, e.g. to select its
+ * classify method. Its rules must not be updated directly.
+ *
+ * @param an
+ *   Replicated ACL context.
+ * @param socket_id
+ *   Socket ID, SOCKET_ID_ANY for the socket of the calling lcore.
+ * @return
+ *   ACL context, NULL if the parameters are invalid.
+ */
+__rte_experimental
+struct rte_acl_ctx *
+rte_acl_numa_get(struct rte_acl_numa *an, int socket_id);
+
 /**
  * Dump an ACL context structure to the console.
  *
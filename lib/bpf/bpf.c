@@ -20,6 +20,8 @@ rte_bpf_destroy(struct rte_bpf *bpf)
 	if (bpf != NULL) {
 		if (bpf->jit.func != NULL)
 			munmap(bpf->jit.func, bpf->jit.sz);
+		if (bpf->jit_burst.func != NULL)
+			munmap(bpf->jit_burst.func, bpf->jit_burst.sz);
 		munmap(bpf, bpf->sz);
 	}
 }
@@ -34,6 +36,16 @@ rte_bpf_get_jit(const struct rte_bpf *bpf, struct rte_bpf_jit *jit)
 	return 0;
 }
 
+int
+rte_bpf_get_jit_burst(const struct rte_bpf *bpf, struct rte_bpf_jit_burst *jit)
+{
+	if (bpf == NULL || jit == NULL)
+		return -EINVAL;
+
+	jit[0] = bpf->jit_burst;
+	return 0;
+}
+
 int
 bpf_jit(struct rte_bpf *bpf)
 {
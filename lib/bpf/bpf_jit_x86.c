@@ -95,6 +95,17 @@ enum {
 	LDMB_OFS_NUM
 };
 
+/*
+ * burst entry parameters, kept in slots on top of the BPF stack.
+ */
+enum {
+	BURST_CTX_SLOT,  /* next input context */
+	BURST_RC_SLOT,   /* next return value */
+	BURST_LEFT_SLOT, /* number of inputs left */
+	BURST_NUM_SLOT,  /* total number of inputs */
+	BURST_SLOT_NUM
+};
+
 /*
  * callee saved registers list.
  * keep RBP as the last one.
@@ -111,6 +122,11 @@ struct bpf_jit_state {
 	struct {
 		uint32_t stack_ofs;
 	} ldmb;
+	struct {
+		uint32_t on;
+		int32_t loop_off;
+		int32_t done_off;
+	} burst;
 	uint32_t reguse;
 	int32_t *off;
 	uint8_t *ins;
@@ -1280,6 +1296,127 @@ emit_epilog(struct bpf_jit_state *st)
 	emit_ret(st);
 }
 
+/*
+ * The burst entry iterates over the input contexts in native code:
+ * the prolog is executed once, then each input is loaded into R1 before
+ * running the program, whose exit stores R0 and loops to the next input.
+ * uint32_t func(void *ctx[], uint64_t rc[], uint32_t num);
+ */
+static void
+emit_burst_prolog(struct bpf_jit_state *st, int32_t stack_size)
+{
+	uint32_t i;
+	int32_t spil, ofs;
+
+	spil = 0;
+	for (i = 0; i != RTE_DIM(save_regs); i++)
+		spil += INUSE(st->reguse, save_regs[i]);
+
+	emit_alu_imm(st, EBPF_ALU64 | BPF_SUB | BPF_K, RSP,
+		(spil + BURST_SLOT_NUM) * sizeof(uint64_t));
+
+	ofs = BURST_SLOT_NUM * sizeof(uint64_t);
+	for (i = 0; i != RTE_DIM(save_regs); i++) {
+		if (INUSE(st->reguse, save_regs[i]) != 0) {
+			emit_st_reg(st, BPF_STX | BPF_MEM | EBPF_DW,
+				save_regs[i], RSP, ofs);
+			ofs += sizeof(uint64_t);
+		}
+	}
+
+	emit_mov_reg(st, EBPF_ALU64 | EBPF_MOV | BPF_X, RSP, RBP);
+	emit_alu_imm(st, EBPF_ALU64 | BPF_SUB | BPF_K, RSP, stack_size);
+
+	/* save parameters, num is 32-bit */
+	emit_mov_reg(st, BPF_ALU | EBPF_MOV | BPF_X, RDX, RDX);
+	emit_st_reg(st, BPF_STX | BPF_MEM | EBPF_DW, RDI, RBP,
+		BURST_CTX_SLOT * sizeof(uint64_t));
+	emit_st_reg(st, BPF_STX | BPF_MEM | EBPF_DW, RSI, RBP,
+		BURST_RC_SLOT * sizeof(uint64_t));
+	emit_st_reg(st, BPF_STX | BPF_MEM | EBPF_DW, RDX, RBP,
+		BURST_LEFT_SLOT * sizeof(uint64_t));
+	emit_st_reg(st, BPF_STX | BPF_MEM | EBPF_DW, RDX, RBP,
+		BURST_NUM_SLOT * sizeof(uint64_t));
+
+	emit_tst_reg(st, EBPF_ALU64, RDX, RDX);
+	emit_abs_jcc(st, BPF_JMP | BPF_JEQ | BPF_K, st->burst.done_off);
+
+	/* loop head: R1 = *ctx */
+	st->burst.loop_off = st->sz;
+	emit_ld_reg(st, BPF_LDX | BPF_MEM | EBPF_DW, RBP, REG_TMP0,
+		BURST_CTX_SLOT * sizeof(uint64_t));
+	emit_ld_reg(st, BPF_LDX | BPF_MEM | EBPF_DW, REG_TMP0,
+		ebpf2x86[EBPF_REG_1], 0);
+}
+
+/*
+ * helper function, used by emit_burst_epilog():
+ * add imm to the value kept in the given slot.
+ */
+static void
+emit_burst_next(struct bpf_jit_state *st, uint32_t slot, uint32_t imm)
+{
+	emit_ld_reg(st, BPF_LDX | BPF_MEM | EBPF_DW, RBP, REG_TMP0,
+		slot * sizeof(uint64_t));
+	emit_alu_imm(st, EBPF_ALU64 | BPF_ADD | BPF_K, REG_TMP0, imm);
+	emit_st_reg(st, BPF_STX | BPF_MEM | EBPF_DW, REG_TMP0, RBP,
+		slot * sizeof(uint64_t));
+}
+
+static void
+emit_burst_epilog(struct bpf_jit_state *st)
+{
+	uint32_t i;
+	int32_t spil, ofs;
+
+	/* if we allready have an epilog generate a jump to it */
+	if (st->exit.num++ != 0) {
+		emit_abs_jmp(st, st->exit.off);
+		return;
+	}
+
+	/* store offset of epilog block */
+	st->exit.off = st->sz;
+
+	/* *rc = R0 */
+	emit_ld_reg(st, BPF_LDX | BPF_MEM | EBPF_DW, RBP, REG_TMP0,
+		BURST_RC_SLOT * sizeof(uint64_t));
+	emit_st_reg(st, BPF_STX | BPF_MEM | EBPF_DW, ebpf2x86[EBPF_REG_0],
+		REG_TMP0, 0);
+
+	emit_burst_next(st, BURST_RC_SLOT, sizeof(uint64_t));
+	emit_burst_next(st, BURST_CTX_SLOT, sizeof(uint64_t));
+	emit_burst_next(st, BURST_LEFT_SLOT, -1);
+
+	/* flags are still set by the decrement of inputs left */
+	emit_abs_jcc(st, BPF_JMP | EBPF_JNE | BPF_K, st->burst.loop_off);
+
+	st->burst.done_off = st->sz;
+
+	emit_ld_reg(st, BPF_LDX | BPF_MEM | EBPF_DW, RBP, RAX,
+		BURST_NUM_SLOT * sizeof(uint64_t));
+
+	spil = 0;
+	for (i = 0; i != RTE_DIM(save_regs); i++)
+		spil += INUSE(st->reguse, save_regs[i]);
+
+	emit_mov_reg(st, EBPF_ALU64 | EBPF_MOV | BPF_X, RBP, RSP);
+
+	ofs = BURST_SLOT_NUM * sizeof(uint64_t);
+	for (i = 0; i != RTE_DIM(save_regs); i++) {
+		if (INUSE(st->reguse, save_regs[i]) != 0) {
+			emit_ld_reg(st, BPF_LDX | BPF_MEM | EBPF_DW,
+				RSP, save_regs[i], ofs);
+			ofs += sizeof(uint64_t);
+		}
+	}
+
+	emit_alu_imm(st, EBPF_ALU64 | BPF_ADD | BPF_K, RSP,
+		(spil + BURST_SLOT_NUM) * sizeof(uint64_t));
+
+	emit_ret(st);
+}
+
 /*
  * walk through bpf code and translate them x86_64 one.
  */
@@ -1294,7 +1431,12 @@ emit(struct bpf_jit_state *st, const struct rte_bpf *bpf)
 	st->exit.num = 0;
 	st->ldmb.stack_ofs = bpf->stack_sz;
 
-	emit_prolog(st, bpf->stack_sz);
+	if (st->burst.on != 0) {
+		/* burst parameters are kept relative to RBP */
+		USED(st->reguse, RBP);
+		emit_burst_prolog(st, bpf->stack_sz);
+	} else
+		emit_prolog(st, bpf->stack_sz);
 
 	for (i = 0; i != bpf->prm.nb_ins; i++) {
 
@@ -1478,7 +1620,10 @@ emit(struct bpf_jit_state *st, const struct rte_bpf *bpf)
 			break;
 		/* return instruction */
 		case (BPF_JMP | EBPF_EXIT):
-			emit_epilog(st);
+			if (st->burst.on != 0)
+				emit_burst_epilog(st);
+			else
+				emit_epilog(st);
 			break;
 		default:
 			RTE_BPF_LOG(ERR,
@@ -1492,58 +1637,87 @@ emit(struct bpf_jit_state *st, const struct rte_bpf *bpf)
 }
 
 /*
- * produce a native ISA version of the given BPF code.
+ * produce a native ISA version of the given BPF code,
+ * either the single context entry or the burst one.
  */
-int
-bpf_jit_x86(struct rte_bpf *bpf)
+static int
+emit_code(struct bpf_jit_state *st, const struct rte_bpf *bpf, uint32_t burst,
+	void **code, size_t *code_sz)
 {
 	int32_t rc;
 	uint32_t i;
 	size_t sz;
-	struct bpf_jit_state st;
 
 	/* init state */
-	memset(&st, 0, sizeof(st));
-	st.off = malloc(bpf->prm.nb_ins * sizeof(st.off[0]));
-	if (st.off == NULL)
+	memset(st, 0, sizeof(*st));
+	st->burst.on = burst;
+	st->off = malloc(bpf->prm.nb_ins * sizeof(st->off[0]));
+	if (st->off == NULL)
 		return -ENOMEM;
 
 	/* fill with fake offsets */
-	st.exit.off = INT32_MAX;
+	st->exit.off = INT32_MAX;
+	st->burst.done_off = INT32_MAX;
 	for (i = 0; i != bpf->prm.nb_ins; i++)
-		st.off[i] = INT32_MAX;
+		st->off[i] = INT32_MAX;
 
 	/*
 	 * dry runs, used to calculate total code size and valid jump offsets.
 	 * stop when we get minimal possible size
 	 */
 	do {
-		sz = st.sz;
-		rc = emit(&st, bpf);
-	} while (rc == 0 && sz != st.sz);
+		sz = st->sz;
+		rc = emit(st, bpf);
+	} while (rc == 0 && sz != st->sz);
 
 	if (rc == 0) {
 
 		/* allocate memory needed */
-		st.ins = mmap(NULL, st.sz, PROT_READ | PROT_WRITE,
+		st->ins = mmap(NULL, st->sz, PROT_READ | PROT_WRITE,
 			MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
-		if (st.ins == MAP_FAILED)
+		if (st->ins == MAP_FAILED) {
+			st->ins = NULL;
 			rc = -ENOMEM;
-		else
+		} else
 			/* generate code */
-			rc = emit(&st, bpf);
+			rc = emit(st, bpf);
 	}
 
-	if (rc == 0 && mprotect(st.ins, st.sz, PROT_READ | PROT_EXEC) != 0)
+	if (rc == 0 && mprotect(st->ins, st->sz, PROT_READ | PROT_EXEC) != 0)
 		rc = -ENOMEM;
 
-	if (rc != 0)
-		munmap(st.ins, st.sz);
-	else {
-		bpf->jit.func = (void *)st.ins;
-		bpf->jit.sz = st.sz;
+	if (rc != 0) {
+		if (st->ins != NULL)
+			munmap(st->ins, st->sz);
+	} else {
+		*code = st->ins;
+		*code_sz = st->sz;
 	}
 
-	free(st.off);
+	free(st->off);
 	return rc;
 }
+
+int
+bpf_jit_x86(struct rte_bpf *bpf)
+{
+	int32_t rc;
+	void *code;
+	size_t sz;
+	struct bpf_jit_state st;
+
+	rc = emit_code(&st, bpf, 0, &code, &sz);
+	if (rc != 0)
+		return rc;
+
+	bpf->jit.func = code;
+	bpf->jit.sz = sz;
+
+	/* the burst entry is optional, rte_bpf_exec_burst() can be used */
+	if (emit_code(&st, bpf, 1, &code, &sz) == 0) {
+		bpf->jit_burst.func = code;
+		bpf->jit_burst.sz = sz;
+	}
+
+	return 0;
+}
@@ -54,6 +54,17 @@ enum {
 
 #define	MAX_EDGES	2
 
+/* all the edges of a node can be taken */
+#define	ALL_EDGES	RTE_LEN2MASK(MAX_EDGES, uint8_t)
+
+/*
+ * Limits for the evaluation of programs with loops: each iteration is
+ * evaluated, so loops have to terminate within these limits.
+ */
+#define	MAX_LOOP_EVAL_INS	(1 << 20)
+#define	MAX_LOOP_EVAL_PATH	(1 << 16)
+#define	MAX_LOOP_EVAL_STATES	64
+
 struct inst_node {
 	uint8_t colour;
 	uint8_t nb_edge:4;
@@ -61,7 +72,14 @@ struct inst_node {
 	uint8_t edge_type[MAX_EDGES];
 	uint32_t edge_dest[MAX_EDGES];
 	uint32_t prev_node;
-	struct bpf_eval_state *evst;
+};
+
+/* instruction on the path being evaluated */
+struct eval_frame {
+	struct inst_node *node;
+	struct bpf_eval_state *evst; /* saved state for the last edge */
+	uint8_t cur_edge;
+	uint8_t edge_mask; /* edges which can be taken */
 };
 
 struct bpf_verifier {
@@ -74,12 +92,19 @@ struct bpf_verifier {
 	uint32_t node_colour[MAX_NODE_COLOUR];
 	uint32_t edge_type[MAX_EDGE_TYPE];
 	struct bpf_eval_state *evst;
-	struct inst_node *evin;
+	struct eval_frame *evin;
+	uint8_t edge_mask;
+	uint32_t nb_eval_ins;
 	struct {
 		uint32_t num;
 		uint32_t cur;
 		struct bpf_eval_state *ent;
 	} evst_pool;
+	struct {
+		uint32_t num;
+		uint32_t cur;
+		struct eval_frame *ent;
+	} path;
 };
 
 struct bpf_ins_check {
@@ -1040,7 +1065,7 @@ static void
 eval_jgt_jle(struct bpf_reg_val *trd, struct bpf_reg_val *trs,
 	struct bpf_reg_val *frd, struct bpf_reg_val *frs)
 {
-	frd->u.max = RTE_MIN(frd->u.max, frs->u.min);
+	frd->u.max = RTE_MIN(frd->u.max, frs->u.max);
 	trd->u.min = RTE_MAX(trd->u.min, trs->u.min + 1);
 }
 
@@ -1056,7 +1081,7 @@ static void
 eval_jsgt_jsle(struct bpf_reg_val *trd, struct bpf_reg_val *trs,
 	struct bpf_reg_val *frd, struct bpf_reg_val *frs)
 {
-	frd->s.max = RTE_MIN(frd->s.max, frs->s.min);
+	frd->s.max = RTE_MIN(frd->s.max, frs->s.max);
 	trd->s.min = RTE_MAX(trd->s.min, trs->s.min + 1);
 }
 
@@ -1068,6 +1093,80 @@ eval_jslt_jsge(struct bpf_reg_val *trd, struct bpf_reg_val *trs,
 	trd->s.max = RTE_MIN(trd->s.max, trs->s.max - 1);
 }
 
+/*
+ * helper function, check that the register holds a known scalar value.
+ */
+static int
+eval_is_const(const struct bpf_reg_val *rv)
+{
+	return (rv->v.type == RTE_BPF_ARG_RAW &&
+		rv->u.min == rv->u.max && rv->s.min == rv->s.max &&
+		rv->u.min == (uint64_t)rv->s.min);
+}
+
+/*
+ * Determine which edges of a conditional jump can be taken:
+ * bit 0 for the jump (condition is true), bit 1 for the fall through.
+ * The outcome is only known when both operands are constants,
+ * which is what a loop counter compared with a limit looks like.
+ */
+static uint8_t
+eval_jcc_edges(uint32_t op, const struct bpf_reg_val *rd,
+	const struct bpf_reg_val *rs)
+{
+	int32_t t;
+	uint64_t ud, us;
+	int64_t sd, ss;
+
+	if (eval_is_const(rd) == 0 || eval_is_const(rs) == 0)
+		return ALL_EDGES;
+
+	ud = rd->u.min;
+	us = rs->u.min;
+	sd = rd->s.min;
+	ss = rs->s.min;
+
+	switch (op) {
+	case BPF_JEQ:
+		t = (ud == us);
+		break;
+	case EBPF_JNE:
+		t = (ud != us);
+		break;
+	case BPF_JGT:
+		t = (ud > us);
+		break;
+	case BPF_JGE:
+		t = (ud >= us);
+		break;
+	case EBPF_JLT:
+		t = (ud < us);
+		break;
+	case EBPF_JLE:
+		t = (ud <= us);
+		break;
+	case EBPF_JSGT:
+		t = (sd > ss);
+		break;
+	case EBPF_JSGE:
+		t = (sd >= ss);
+		break;
+	case EBPF_JSLT:
+		t = (sd < ss);
+		break;
+	case EBPF_JSLE:
+		t = (sd <= ss);
+		break;
+	case BPF_JSET:
+		t = ((ud & us) != 0);
+		break;
+	default:
+		return ALL_EDGES;
+	}
+
+	return t ? (1 << 0) : (1 << 1);
+}
+
 static const char *
 eval_jcc(struct bpf_verifier *bvf, const struct ebpf_insn *ins)
 {
@@ -1098,6 +1197,7 @@ eval_jcc(struct bpf_verifier *bvf, const struct ebpf_insn *ins)
 		return err;
 
 	op = BPF_OP(ins->code);
+	bvf->edge_mask = eval_jcc_edges(op, trd, trs);
 
 	if (op == BPF_JEQ)
 		eval_jeq_jne(trd, trs);
@@ -1930,7 +2030,7 @@ log_unreachable(const struct bpf_verifier *bvf)
  * report loops detected.
  */
 static void
-log_loop(const struct bpf_verifier *bvf)
+log_loop(const struct bpf_verifier *bvf, uint32_t loglvl)
 {
 	uint32_t i, j;
 	struct inst_node *node;
@@ -1943,7 +2043,7 @@ log_loop(const struct bpf_verifier *bvf)
 
 		for (j = 0; j != node->nb_edge; j++) {
 			if (node->edge_type[j] == BACK_EDGE)
-				RTE_BPF_LOG(ERR,
+				rte_log(loglvl, rte_bpf_logtype,
 					"loop at pc:%u --> pc:%u;\n",
 					i, node->edge_dest[j]);
 		}
@@ -1955,7 +2055,8 @@ log_loop(const struct bpf_verifier *bvf)
  * instruction is a valid one (correct syntax, valid field values, etc.)
  * and constructs control flow graph (CFG).
  * Then deapth-first search is performed over the constructed graph.
- * Programs with unreachable instructions and/or loops will be rejected.
+ * Programs with unreachable instructions will be rejected.
+ * Loops are allowed, the evaluation has to prove they are bounded.
  */
 static int
 validate(struct bpf_verifier *bvf)
@@ -2071,10 +2172,9 @@ validate(struct bpf_verifier *bvf)
 	}
 
 	if (bvf->edge_type[BACK_EDGE] != 0) {
-		RTE_BPF_LOG(ERR, "%s(%p) loops detected;\n",
+		RTE_BPF_LOG(DEBUG, "%s(%p) loops detected;\n",
 			__func__, bvf);
-		log_loop(bvf);
-		return -EINVAL;
+		log_loop(bvf, RTE_LOG_DEBUG);
 	}
 
 	return 0;
@@ -2108,6 +2208,8 @@ evst_pool_fini(struct bpf_verifier *bvf)
 	bvf->evst = NULL;
 	free(bvf->evst_pool.ent);
 	memset(&bvf->evst_pool, 0, sizeof(bvf->evst_pool));
+	free(bvf->path.ent);
+	memset(&bvf->path, 0, sizeof(bvf->path));
 }
 
 static int
@@ -2115,7 +2217,13 @@ evst_pool_init(struct bpf_verifier *bvf)
 {
 	uint32_t n;
 
+	/*
+	 * Without loops, each jcc node appears at most once on the path,
+	 * each iteration of a loop can add its undecided jcc nodes again.
+	 */
 	n = bvf->nb_jcc_nodes + 1;
+	if (bvf->edge_type[BACK_EDGE] != 0)
+		n += MAX_LOOP_EVAL_STATES;
 
 	bvf->evst_pool.ent = calloc(n, sizeof(bvf->evst_pool.ent[0]));
 	if (bvf->evst_pool.ent == NULL)
@@ -2124,6 +2232,19 @@ evst_pool_init(struct bpf_verifier *bvf)
 	bvf->evst_pool.num = n;
 	bvf->evst_pool.cur = 0;
 
+	n = bvf->nb_nodes;
+	if (bvf->edge_type[BACK_EDGE] != 0)
+		n = RTE_MAX(n, (uint32_t)MAX_LOOP_EVAL_PATH);
+
+	bvf->path.ent = calloc(n, sizeof(bvf->path.ent[0]));
+	if (bvf->path.ent == NULL) {
+		evst_pool_fini(bvf);
+		return -ENOMEM;
+	}
+
+	bvf->path.num = n;
+	bvf->path.cur = 0;
+
 	bvf->evst = pull_eval_state(bvf);
 	return 0;
 }
@@ -2132,16 +2253,23 @@ evst_pool_init(struct bpf_verifier *bvf)
  * Save current eval state.
  */
 static int
-save_eval_state(struct bpf_verifier *bvf, struct inst_node *node)
+save_eval_state(struct bpf_verifier *bvf, struct eval_frame *fr)
 {
 	struct bpf_eval_state *st;
 
 	/* get new eval_state for this node */
 	st = pull_eval_state(bvf);
 	if (st == NULL) {
+		if (bvf->edge_type[BACK_EDGE] != 0) {
+			RTE_BPF_LOG(ERR,
+				"%s: too many states at pc: %u, "
+				"loop is not bounded\n",
+				__func__, get_node_idx(bvf, fr->node));
+			return -E2BIG;
+		}
 		RTE_BPF_LOG(ERR,
 			"%s: internal error (out of space) at pc: %u\n",
-			__func__, get_node_idx(bvf, node));
+			__func__, get_node_idx(bvf, fr->node));
 		return -ENOMEM;
 	}
 
@@ -2149,11 +2277,12 @@ save_eval_state(struct bpf_verifier *bvf, struct inst_node *node)
 	memcpy(st, bvf->evst, sizeof(*st));
 
 	/* swap current state with new one */
-	node->evst = bvf->evst;
+	fr->evst = bvf->evst;
 	bvf->evst = st;
 
 	RTE_BPF_LOG(DEBUG, "%s(bvf=%p,node=%u) old/new states: %p/%p;\n",
-		__func__, bvf, get_node_idx(bvf, node), node->evst, bvf->evst);
+		__func__, bvf, get_node_idx(bvf, fr->node), fr->evst,
+		bvf->evst);
 
 	return 0;
 }
@@ -2162,16 +2291,29 @@ save_eval_state(struct bpf_verifier *bvf, struct inst_node *node)
  * Restore previous eval state and mark current eval state as free.
  */
 static void
-restore_eval_state(struct bpf_verifier *bvf, struct inst_node *node)
+restore_eval_state(struct bpf_verifier *bvf, struct eval_frame *fr)
 {
 	RTE_BPF_LOG(DEBUG, "%s(bvf=%p,node=%u) old/new states: %p/%p;\n",
-		__func__, bvf, get_node_idx(bvf, node), bvf->evst, node->evst);
+		__func__, bvf, get_node_idx(bvf, fr->node), bvf->evst,
+		fr->evst);
 
-	bvf->evst = node->evst;
-	node->evst = NULL;
+	bvf->evst = fr->evst;
+	fr->evst = NULL;
 	push_eval_state(bvf);
 }
 
+/*
+ * When only one edge of a jcc node can be taken, its state is kept
+ * as the current one and the other state is freed.
+ */
+static void
+drop_eval_state(struct bpf_verifier *bvf, struct eval_frame *fr)
+{
+	if (fr->edge_mask == (1 << 0))
+		memcpy(fr->evst, bvf->evst, sizeof(*fr->evst));
+	restore_eval_state(bvf, fr);
+}
+
 static void
 log_eval_state(const struct bpf_verifier *bvf, const struct ebpf_insn *ins,
 	uint32_t pc, int32_t loglvl)
@@ -2198,9 +2340,93 @@ log_eval_state(const struct bpf_verifier *bvf, const struct ebpf_insn *ins,
 		rv->s.min, rv->s.max);
 }
 
+/*
+ * Evaluate the instruction of a node just added to the path.
+ */
+static int
+eval_node(struct bpf_verifier *bvf, struct inst_node *node)
+{
+	int32_t rc;
+	uint32_t idx, op;
+	const char *err;
+	const struct ebpf_insn *ins;
+	struct eval_frame *fr;
+
+	idx = get_node_idx(bvf, node);
+
+	if (bvf->path.cur == bvf->path.num) {
+		RTE_BPF_LOG(ERR, "%s: path is too long at pc: %u%s\n",
+			__func__, idx, bvf->edge_type[BACK_EDGE] != 0 ?
+			", loop is not bounded" : "");
+		return -E2BIG;
+	}
+
+	if (bvf->edge_type[BACK_EDGE] != 0 &&
+			++bvf->nb_eval_ins > MAX_LOOP_EVAL_INS) {
+		RTE_BPF_LOG(ERR, "%s: too many instructions to evaluate "
+			"at pc: %u, loop is not bounded\n", __func__, idx);
+		return -E2BIG;
+	}
+
+	fr = bvf->path.ent + bvf->path.cur++;
+	fr->node = node;
+	fr->evst = NULL;
+	fr->cur_edge = 0;
+
+	ins = bvf->prm->ins + idx;
+	op = ins->code;
+	rc = 0;
+
+	bvf->evin = fr;
+	bvf->edge_mask = ALL_EDGES;
+
+	/* for jcc node make a copy of evaluatoion state */
+	if (node->nb_edge > 1)
+		rc = save_eval_state(bvf, fr);
+
+	if (ins_chk[op].eval != NULL && rc == 0) {
+		err = ins_chk[op].eval(bvf, ins);
+		if (err != NULL) {
+			RTE_BPF_LOG(ERR, "%s: %s at pc: %u\n",
+				__func__, err, idx);
+			rc = -EINVAL;
+		}
+	}
+
+	fr->edge_mask = bvf->edge_mask;
+	if (rc == 0 && fr->evst != NULL && fr->edge_mask != ALL_EDGES)
+		drop_eval_state(bvf, fr);
+
+	log_eval_state(bvf, ins, idx, RTE_LOG_DEBUG);
+	bvf->evin = NULL;
+	return rc;
+}
+
+/*
+ * helper function, return next node to evaluate from the given one,
+ * skipping the jcc edges which can't be taken.
+ */
+static struct inst_node *
+get_next_eval_node(struct bpf_verifier *bvf, struct eval_frame *fr)
+{
+	uint32_t ce;
+
+	while (fr->cur_edge != fr->node->nb_edge) {
+		ce = fr->cur_edge++;
+		if ((fr->edge_mask & (1 << ce)) != 0)
+			return bvf->in + fr->node->edge_dest[ce];
+	}
+
+	return NULL;
+}
+
 /*
  * Do second pass through CFG and try to evaluate instructions
  * via each possible path.
+ * The path is kept as a stack of nodes, so the same node can appear
+ * on it many times, once per iteration of the loops it belongs to.
+ * The conditional jumps whose outcome is known don't fork the path,
+ * so that loops with bounded number of iterations terminate.
  * Right now evaluation functionality is quite limited.
  * Still need to add extra checks for:
  * - use/return uninitialized registers.
@@ -2211,10 +2437,8 @@ static int
 evaluate(struct bpf_verifier *bvf)
 {
 	int32_t rc;
-	uint32_t idx, op;
-	const char *err;
-	const struct ebpf_insn *ins;
-	struct inst_node *next, *node;
+	struct eval_frame *fr;
+	struct inst_node *next;
 
 	/* initial state of frame pointer */
 	static const struct bpf_reg_val rvfp = {
@@ -2234,62 +2458,30 @@ evaluate(struct bpf_verifier *bvf)
 
 	bvf->evst->rv[EBPF_REG_10] = rvfp;
 
-	ins = bvf->prm->ins;
-	node = bvf->in;
-	next = node;
-	rc = 0;
+	rc = eval_node(bvf, bvf->in);
 
-	while (node != NULL && rc == 0) {
+	while (bvf->path.cur != 0 && rc == 0) {
 
-		/*
-		 * current node evaluation, make sure we evaluate
-		 * each node only once.
-		 */
-		if (next != NULL) {
-
-			bvf->evin = node;
-			idx = get_node_idx(bvf, node);
-			op = ins[idx].code;
-
-			/* for jcc node make a copy of evaluatoion state */
-			if (node->nb_edge > 1)
-				rc |= save_eval_state(bvf, node);
-
-			if (ins_chk[op].eval != NULL && rc == 0) {
-				err = ins_chk[op].eval(bvf, ins + idx);
-				if (err != NULL) {
-					RTE_BPF_LOG(ERR, "%s: %s at pc: %u\n",
-						__func__, err, idx);
-					rc = -EINVAL;
-				}
-			}
-
-			log_eval_state(bvf, ins + idx, idx, RTE_LOG_DEBUG);
-			bvf->evin = NULL;
-		}
+		fr = bvf->path.ent + bvf->path.cur - 1;
 
 		/* proceed through CFG */
-		next = get_next_node(bvf, node);
+		next = get_next_eval_node(bvf, fr);
 		if (next != NULL) {
 
 			/* proceed with next child */
-			if (node->cur_edge == node->nb_edge &&
-					node->evst != NULL)
-				restore_eval_state(bvf, node);
+			if (fr->cur_edge == fr->node->nb_edge &&
+					fr->evst != NULL)
+				restore_eval_state(bvf, fr);
 
-			next->prev_node = get_node_idx(bvf, node);
-			node = next;
+			rc = eval_node(bvf, next);
 		} else {
 			/*
 			 * finished with current node and all it's kids,
 			 * proceed with parent
 			 */
-			node->cur_edge = 0;
-			node = get_prev_node(bvf, node);
-
-			/* finished */
-			if (node == bvf->in)
-				node = NULL;
+			if (fr->evst != NULL)
+				restore_eval_state(bvf, fr);
+			bvf->path.cur--;
 		}
 	}
 
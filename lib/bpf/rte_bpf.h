@@ -17,6 +17,7 @@
  */
 
 #include <rte_common.h>
+#include <rte_compat.h>
 #include <rte_mbuf.h>
 #include <bpf_def.h>
 
@@ -104,6 +105,17 @@ struct rte_bpf_jit {
 	size_t sz;                /**< size of JIT-ed code */
 };
 
+/**
+ * Information about compiled into native ISA eBPF code processing a set of
+ * input contexts, the iteration over the inputs being part of the native
+ * code. Its parameters and return value are the ones of rte_bpf_exec_burst().
+ */
+struct rte_bpf_jit_burst {
+	uint32_t (*func)(void *ctx[], uint64_t rc[], uint32_t num);
+	/**< JIT-ed native code */
+	size_t sz; /**< size of JIT-ed code */
+};
+
 struct rte_bpf;
 
 /**
@@ -198,6 +210,29 @@ rte_bpf_exec_burst(const struct rte_bpf *bpf, void *ctx[], uint64_t rc[],
 int
 rte_bpf_get_jit(const struct rte_bpf *bpf, struct rte_bpf_jit *jit);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Provide information about natively compiled code processing a set of
+ * input contexts for given BPF handle.
+ * The func field is NULL when no such code is available for the current
+ * platform, rte_bpf_get_jit() code has then to be called per input.
+ *
+ * @param bpf
+ *   handle for the BPF code.
+ * @param jit
+ *   pointer to the rte_bpf_jit_burst structure to be filled with related
+ *   data.
+ * @return
+ *   - -EINVAL if the parameters are invalid.
+ *   - Zero if operation completed successfully.
+ */
+__rte_experimental
+int
+rte_bpf_get_jit_burst(const struct rte_bpf *bpf,
+	struct rte_bpf_jit_burst *jit);
+
 #ifdef __cplusplus
 }
 #endif
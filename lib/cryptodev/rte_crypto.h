@@ -17,7 +17,9 @@ extern "C" {
 #endif
 
 
+#include <rte_compat.h>
 #include <rte_mbuf.h>
+#include <rte_memcpy.h>
 #include <rte_memory.h>
 #include <rte_mempool.h>
 #include <rte_common.h>
@@ -420,6 +422,118 @@ rte_crypto_op_attach_sym_session(struct rte_crypto_op *op,
 	return __rte_crypto_sym_op_attach_sym_session(op->sym, sess);
 }
 
+/** Maximum length of the IV of a crypto operation template */
+#define RTE_CRYPTO_OP_TMPL_IV_MAX_LEN	16
+
+/**
+ * Symmetric crypto operation template: the constant part of the crypto
+ * operations of a session (session, offsets, lengths, constant IV bytes),
+ * built once so that each operation is then initialized with a fixed size
+ * copy instead of field by field.
+ */
+struct rte_crypto_op_tmpl {
+	uint64_t raw;
+	/**< type, status and session type of the operations */
+	uint16_t iv_offset;
+	/**< Offset of the IV from the start of the operations */
+	uint16_t iv_len;
+	/**< Length of the IV template, 0 when there is none */
+	uint8_t iv[RTE_CRYPTO_OP_TMPL_IV_MAX_LEN];
+	/**< IV template, copied at iv_offset in the operations */
+	struct rte_crypto_sym_op sym;
+	/**< Symmetric operation template */
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Initialize a symmetric crypto operation template for a session, with a
+ * zeroed symmetric operation and no IV template. The offsets, lengths and IV
+ * template are then set directly in the template.
+ *
+ * @param	tmpl	crypto operation template
+ * @param	sess	cryptodev session
+ */
+__rte_experimental
+static inline void
+rte_crypto_op_tmpl_init(struct rte_crypto_op_tmpl *tmpl,
+		struct rte_cryptodev_sym_session *sess)
+{
+	struct rte_crypto_op op;
+
+	memset(tmpl, 0, sizeof(*tmpl));
+
+	op.raw = 0;
+	op.type = RTE_CRYPTO_OP_TYPE_SYMMETRIC;
+	op.status = RTE_CRYPTO_OP_STATUS_NOT_PROCESSED;
+	op.sess_type = RTE_CRYPTO_OP_WITH_SESSION;
+	tmpl->raw = op.raw;
+
+	__rte_crypto_sym_op_attach_sym_session(&tmpl->sym, sess);
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Initialize a symmetric crypto operation from a template, the mempool,
+ * physical address and private data of the operation being untouched.
+ *
+ * @param	op	crypto operation
+ * @param	tmpl	crypto operation template
+ * @param	m_src	source mbuf of the operation
+ */
+__rte_experimental
+static __rte_always_inline void
+rte_crypto_op_tmpl_apply(struct rte_crypto_op *op,
+		const struct rte_crypto_op_tmpl *tmpl, struct rte_mbuf *m_src)
+{
+	op->raw = tmpl->raw;
+	op->sym[0] = tmpl->sym;
+	op->sym->m_src = m_src;
+
+	if (tmpl->iv_len != 0)
+		rte_memcpy((uint8_t *)op + tmpl->iv_offset, tmpl->iv,
+			tmpl->iv_len);
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Bulk allocate symmetric crypto operations from a mempool and initialize
+ * them from a template, without resetting them first. The source mbufs of
+ * the operations are left to the caller.
+ *
+ * @param	mempool	crypto operation mempool
+ * @param	tmpl	crypto operation template
+ * @param	ops	Array to place allocated crypto operations
+ * @param	nb_ops	Number of crypto operations to allocate
+ *
+ * @returns
+ * - nb_ops if the number of operations requested were allocated.
+ * - 0 if the requested number of ops are not available.
+ *   None are allocated in this case.
+ */
+__rte_experimental
+static inline unsigned
+rte_crypto_op_bulk_alloc_tmpl(struct rte_mempool *mempool,
+		const struct rte_crypto_op_tmpl *tmpl,
+		struct rte_crypto_op **ops, uint16_t nb_ops)
+{
+	int i;
+
+	if (unlikely(__rte_crypto_op_raw_bulk_alloc(mempool,
+			RTE_CRYPTO_OP_TYPE_SYMMETRIC, ops, nb_ops) != nb_ops))
+		return 0;
+
+	for (i = 0; i < nb_ops; i++)
+		rte_crypto_op_tmpl_apply(ops[i], tmpl, NULL);
+
+	return nb_ops;
+}
+
 /**
  * Attach a asymmetric session to a crypto operation
  *
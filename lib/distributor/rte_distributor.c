@@ -7,6 +7,7 @@
 #include <string.h>
 #include <rte_mbuf.h>
 #include <rte_memory.h>
+#include <rte_cpuflags.h>
 #include <rte_cycles.h>
 #include <rte_memzone.h>
 #include <rte_errno.h>
@@ -508,6 +509,12 @@ rte_distributor_process(struct rte_distributor *d,
 					find_match_vec(d, &flows[0],
 						&matches[0]);
 					break;
+#ifdef CC_DISTRIBUTOR_AVX512_SUPPORT
+				case RTE_DIST_MATCH_VECTOR_AVX512:
+					find_match_avx512(d, &flows[0],
+						&matches[0]);
+					break;
+#endif
 				default:
 					find_match_scalar(d, &flows[0],
 						&matches[0]);
@@ -766,6 +773,14 @@ rte_distributor_create(const char *name,
 	if (rte_vect_get_max_simd_bitwidth() >= RTE_VECT_SIMD_128)
 		d->dist_match_fn = RTE_DIST_MATCH_VECTOR;
 #endif
+#ifdef CC_DISTRIBUTOR_AVX512_SUPPORT
+	/* the SSE version is as good with a few workers */
+	if (num_workers > RTE_DIST_BURST_SIZE &&
+			rte_vect_get_max_simd_bitwidth() >= RTE_VECT_SIMD_512 &&
+			rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F) > 0 &&
+			rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512BW) > 0)
+		d->dist_match_fn = RTE_DIST_MATCH_VECTOR_AVX512;
+#endif
 
 	/*
 	 * Set up the backlog tags so they're pointing at the second cache
@@ -0,0 +1,54 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <rte_mbuf.h>
+#include <rte_vect.h>
+#include "rte_distributor.h"
+#include "distributor_private.h"
+
+/*
+ * The inflight and backlog tags of a worker are 16 contiguous 16-bit values,
+ * so that a zmm register holds the tags of two workers, and each incoming
+ * flow is compared with both of them at once. This halves the number of
+ * comparisons of the SSE version, which matters with many workers.
+ */
+void
+find_match_avx512(struct rte_distributor *d,
+			uint16_t *data_ptr,
+			uint16_t *output_ptr)
+{
+	__m512i incoming_fids[RTE_DIST_BURST_SIZE];
+	__m512i tags;
+	__mmask32 load_mask;
+	__mmask32 match;
+	unsigned int i, j;
+
+	for (j = 0; j < RTE_DIST_BURST_SIZE; j++) {
+		incoming_fids[j] = _mm512_set1_epi16(data_ptr[j]);
+		output_ptr[j] = 0;
+	}
+
+	for (i = 0; i < d->num_workers; i += 2) {
+		/* do not look at the tags after the last worker */
+		load_mask = (i + 1 < d->num_workers) ?
+			UINT32_MAX : UINT16_MAX;
+		tags = _mm512_maskz_loadu_epi16(load_mask,
+			&d->in_flight_tags[i][0]);
+
+		for (j = 0; j < RTE_DIST_BURST_SIZE; j++) {
+			match = _mm512_cmpeq_epi16_mask(tags, incoming_fids[j]);
+			/* the last matching worker wins, as in other versions */
+			if (match >> (RTE_DIST_BURST_SIZE * 2))
+				output_ptr[j] = i + 2;
+			else if (match)
+				output_ptr[j] = i + 1;
+		}
+	}
+
+	/*
+	 * At this stage, the output contains 8 16-bit values, with
+	 * each non-zero value containing the worker ID on which the
+	 * corresponding flow is pinned to.
+	 */
+}
@@ -87,3 +87,9 @@ rte_eal_has_pci(void)
 {
 	return !internal_config.no_pci;
 }
+
+unsigned int
+rte_eal_probe_threads(void)
+{
+	return internal_config.probe_threads;
+}
@@ -4,8 +4,16 @@
  */
 
 #include <inttypes.h>
+#include <stdbool.h>
+#include <stdlib.h>
 #include <string.h>
+#ifndef RTE_EXEC_ENV_WINDOWS
+#include <pthread.h>
+#include <time.h>
+#endif
 
+#include <rte_cycles.h>
+#include <rte_lcore.h>
 #include <rte_log.h>
 #include <rte_string_fns.h>
 
@@ -223,12 +231,195 @@ limits_callback(int socket_id, size_t cur_limit, size_t new_len)
 	return -1;
 }
 
+static int
+dynmem_alloc_socket_pages(struct hugepage_info *used_hp, int n_sizes,
+		int socket_id)
+{
+	int hp_sz_idx;
+
+	for (hp_sz_idx = 0; hp_sz_idx < n_sizes; hp_sz_idx++) {
+		struct rte_memseg **pages;
+		struct hugepage_info *hpi = &used_hp[hp_sz_idx];
+		unsigned int num_pages = hpi->num_pages[socket_id];
+		unsigned int num_pages_alloc;
+
+		if (num_pages == 0)
+			continue;
+
+		RTE_LOG(DEBUG, EAL,
+			"Allocating %u pages of size %" PRIu64 "M "
+			"on socket %i\n",
+			num_pages, hpi->hugepage_sz >> 20, socket_id);
+
+		/* we may not be able to allocate all pages in one go,
+		 * because we break up our memory map into multiple
+		 * memseg lists. therefore, try allocating multiple
+		 * times and see if we can get the desired number of
+		 * pages from multiple allocations.
+		 */
+
+		num_pages_alloc = 0;
+		do {
+			int i, cur_pages, needed;
+
+			needed = num_pages - num_pages_alloc;
+
+			pages = malloc(sizeof(*pages) * needed);
+
+			/* do not request exact number of pages */
+			cur_pages = eal_memalloc_alloc_seg_bulk(pages,
+					needed, hpi->hugepage_sz,
+					socket_id, false);
+			if (cur_pages <= 0) {
+				free(pages);
+				return -1;
+			}
+
+			/* mark preallocated pages as unfreeable */
+			for (i = 0; i < cur_pages; i++) {
+				struct rte_memseg *ms = pages[i];
+				ms->flags |= RTE_MEMSEG_FLAG_DO_NOT_FREE;
+			}
+			free(pages);
+
+			num_pages_alloc += cur_pages;
+		} while (num_pages_alloc != num_pages);
+	}
+
+	return 0;
+}
+
+static bool
+dynmem_socket_has_pages(const struct hugepage_info *used_hp, int n_sizes,
+		int socket_id)
+{
+	int hp_sz_idx;
+
+	for (hp_sz_idx = 0; hp_sz_idx < n_sizes; hp_sz_idx++)
+		if (used_hp[hp_sz_idx].num_pages[socket_id] != 0)
+			return true;
+
+	return false;
+}
+
+#ifndef RTE_EXEC_ENV_WINDOWS
+struct dynmem_alloc_param {
+	struct hugepage_info *used_hp;
+	int n_sizes;
+	int socket_id;
+	int ret;
+};
+
+static uint64_t
+dynmem_clock_ms(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * MS_PER_S + ts.tv_nsec / (NS_PER_S / MS_PER_S);
+}
+
+static void *
+dynmem_alloc_socket_thread(void *arg)
+{
+	struct dynmem_alloc_param *param = arg;
+	unsigned int lcore_id;
+	rte_cpuset_t cpuset;
+	uint64_t start;
+
+	/* run on the socket, so that the kernel zeroes its pages locally */
+	CPU_ZERO(&cpuset);
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++)
+		if (eal_cpu_detected(lcore_id) &&
+				lcore_config[lcore_id].socket_id ==
+				(unsigned int)param->socket_id)
+			CPU_SET(lcore_id, &cpuset);
+	if (CPU_COUNT(&cpuset) != 0 && pthread_setaffinity_np(pthread_self(),
+			sizeof(cpuset), &cpuset) != 0)
+		RTE_LOG(DEBUG, EAL, "Cannot pin allocation thread to socket %d\n",
+			param->socket_id);
+
+	start = dynmem_clock_ms();
+	param->ret = dynmem_alloc_socket_pages(param->used_hp, param->n_sizes,
+			param->socket_id);
+	RTE_LOG(DEBUG, EAL, "Allocated pages on socket %d in %" PRIu64 " ms\n",
+		param->socket_id, dynmem_clock_ms() - start);
+
+	return NULL;
+}
+
+/*
+ * Allocate the pages of each socket from its own thread. Most of the time is
+ * spent by the kernel zeroing the new pages, which then runs in parallel.
+ */
+static int
+dynmem_alloc_pages_parallel(struct hugepage_info *used_hp, int n_sizes)
+{
+	struct dynmem_alloc_param params[RTE_MAX_NUMA_NODES];
+	pthread_t threads[RTE_MAX_NUMA_NODES];
+	bool started[RTE_MAX_NUMA_NODES];
+	int socket_id, ret = 0;
+
+	for (socket_id = 0; socket_id < RTE_MAX_NUMA_NODES; socket_id++) {
+		started[socket_id] = false;
+		if (!dynmem_socket_has_pages(used_hp, n_sizes, socket_id))
+			continue;
+
+		params[socket_id].used_hp = used_hp;
+		params[socket_id].n_sizes = n_sizes;
+		params[socket_id].socket_id = socket_id;
+		params[socket_id].ret = 0;
+		if (pthread_create(&threads[socket_id], NULL,
+				dynmem_alloc_socket_thread,
+				&params[socket_id]) == 0) {
+			started[socket_id] = true;
+			continue;
+		}
+
+		/* fall back to allocating from the current thread */
+		if (dynmem_alloc_socket_pages(used_hp, n_sizes, socket_id) < 0)
+			ret = -1;
+	}
+
+	for (socket_id = 0; socket_id < RTE_MAX_NUMA_NODES; socket_id++) {
+		if (!started[socket_id])
+			continue;
+		pthread_join(threads[socket_id], NULL);
+		if (params[socket_id].ret < 0)
+			ret = -1;
+	}
+
+	return ret;
+}
+#endif
+
+static int
+dynmem_alloc_pages(struct hugepage_info *used_hp, int n_sizes)
+{
+	int socket_id, n_sockets = 0;
+
+	for (socket_id = 0; socket_id < RTE_MAX_NUMA_NODES; socket_id++)
+		if (dynmem_socket_has_pages(used_hp, n_sizes, socket_id))
+			n_sockets++;
+
+#ifndef RTE_EXEC_ENV_WINDOWS
+	if (n_sockets > 1)
+		return dynmem_alloc_pages_parallel(used_hp, n_sizes);
+#endif
+
+	for (socket_id = 0; socket_id < RTE_MAX_NUMA_NODES; socket_id++)
+		if (dynmem_alloc_socket_pages(used_hp, n_sizes, socket_id) < 0)
+			return -1;
+
+	return 0;
+}
+
 int
 eal_dynmem_hugepage_init(void)
 {
 	struct hugepage_info used_hp[MAX_HUGEPAGE_SIZES];
 	uint64_t memory[RTE_MAX_NUMA_NODES];
-	int hp_sz_idx, socket_id;
+	int hp_sz_idx;
 	struct internal_config *internal_conf =
 		eal_get_internal_configuration();
 
@@ -272,60 +463,9 @@ eal_dynmem_hugepage_init(void)
 			internal_conf->num_hugepage_sizes) < 0)
 		return -1;
 
-	for (hp_sz_idx = 0;
-			hp_sz_idx < (int)internal_conf->num_hugepage_sizes;
-			hp_sz_idx++) {
-		for (socket_id = 0; socket_id < RTE_MAX_NUMA_NODES;
-				socket_id++) {
-			struct rte_memseg **pages;
-			struct hugepage_info *hpi = &used_hp[hp_sz_idx];
-			unsigned int num_pages = hpi->num_pages[socket_id];
-			unsigned int num_pages_alloc;
-
-			if (num_pages == 0)
-				continue;
-
-			RTE_LOG(DEBUG, EAL,
-				"Allocating %u pages of size %" PRIu64 "M "
-				"on socket %i\n",
-				num_pages, hpi->hugepage_sz >> 20, socket_id);
-
-			/* we may not be able to allocate all pages in one go,
-			 * because we break up our memory map into multiple
-			 * memseg lists. therefore, try allocating multiple
-			 * times and see if we can get the desired number of
-			 * pages from multiple allocations.
-			 */
-
-			num_pages_alloc = 0;
-			do {
-				int i, cur_pages, needed;
-
-				needed = num_pages - num_pages_alloc;
-
-				pages = malloc(sizeof(*pages) * needed);
-
-				/* do not request exact number of pages */
-				cur_pages = eal_memalloc_alloc_seg_bulk(pages,
-						needed, hpi->hugepage_sz,
-						socket_id, false);
-				if (cur_pages <= 0) {
-					free(pages);
-					return -1;
-				}
-
-				/* mark preallocated pages as unfreeable */
-				for (i = 0; i < cur_pages; i++) {
-					struct rte_memseg *ms = pages[i];
-					ms->flags |=
-						RTE_MEMSEG_FLAG_DO_NOT_FREE;
-				}
-				free(pages);
-
-				num_pages_alloc += cur_pages;
-			} while (num_pages_alloc != num_pages);
-		}
-	}
+	if (dynmem_alloc_pages(used_hp,
+			(int)internal_conf->num_hugepage_sizes) < 0)
+		return -1;
 
 	/* if socket limits were specified, set them */
 	if (internal_conf->force_socket_limits) {
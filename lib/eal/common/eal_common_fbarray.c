@@ -48,6 +48,10 @@ static rte_spinlock_t mem_area_lock = RTE_SPINLOCK_INITIALIZER;
 /*
  * This is a mask that is always stored at the end of array, to provide fast
  * way of finding free/used spots without looping through each element.
+ *
+ * The masks are followed by two summaries, with one bit per mask: the first
+ * one tells which masks have used entries, the second one which masks have
+ * free entries, so that the searches skip the masks which cannot match.
  */
 
 struct used_mask {
@@ -55,15 +59,101 @@ struct used_mask {
 	uint64_t data[];
 };
 
+#define SUMMARY_LEN(n_masks) MASK_LEN_TO_IDX(RTE_ALIGN_CEIL(n_masks, MASK_ALIGN))
+
 static size_t
 calc_mask_size(unsigned int len)
 {
+	unsigned int n_masks;
+
 	/* mask must be multiple of MASK_ALIGN, even though length of array
 	 * itself may not be aligned on that boundary.
 	 */
 	len = RTE_ALIGN_CEIL(len, MASK_ALIGN);
+	n_masks = MASK_LEN_TO_IDX(len);
 	return sizeof(struct used_mask) +
-			sizeof(uint64_t) * MASK_LEN_TO_IDX(len);
+			sizeof(uint64_t) * n_masks +
+			sizeof(uint64_t) * SUMMARY_LEN(n_masks) * 2;
+}
+
+static uint64_t *
+get_summary(const struct used_mask *msk, bool used)
+{
+	unsigned int offset = msk->n_masks;
+
+	if (!used)
+		offset += SUMMARY_LEN(msk->n_masks);
+	return RTE_PTR_ADD(msk->data, sizeof(uint64_t) * offset);
+}
+
+static void
+update_summary(struct used_mask *msk, unsigned int msk_idx)
+{
+	uint64_t *used_sum = get_summary(msk, true);
+	uint64_t *free_sum = get_summary(msk, false);
+	unsigned int sum_idx = MASK_LEN_TO_IDX(msk_idx);
+	uint64_t sum_bit = 1ULL << MASK_LEN_TO_MOD(msk_idx);
+
+	if (msk->data[msk_idx] != 0)
+		used_sum[sum_idx] |= sum_bit;
+	else
+		used_sum[sum_idx] &= ~sum_bit;
+	if (msk->data[msk_idx] != UINT64_MAX)
+		free_sum[sum_idx] |= sum_bit;
+	else
+		free_sum[sum_idx] &= ~sum_bit;
+}
+
+/* Check if a mask has no used (or free) entries. */
+static inline bool
+mask_lacks(const struct used_mask *msk, unsigned int msk_idx, bool used)
+{
+	return msk->data[msk_idx] == (used ? 0 : UINT64_MAX);
+}
+
+/*
+ * Find the first mask from msk_idx which has used (or free) entries, n_masks
+ * if there is none.
+ */
+static unsigned int
+find_next_mask(const struct used_mask *msk, unsigned int msk_idx, bool used)
+{
+	const uint64_t *sum = get_summary(msk, used);
+	unsigned int sum_idx, sum_len = SUMMARY_LEN(msk->n_masks);
+	uint64_t cur;
+
+	if (msk_idx >= msk->n_masks)
+		return msk->n_masks;
+
+	sum_idx = MASK_LEN_TO_IDX(msk_idx);
+	cur = sum[sum_idx] & ~((1ULL << MASK_LEN_TO_MOD(msk_idx)) - 1);
+	while (cur == 0) {
+		if (++sum_idx == sum_len)
+			return msk->n_masks;
+		cur = sum[sum_idx];
+	}
+	return RTE_MIN((unsigned int)MASK_GET_IDX(sum_idx,
+			__builtin_ctzll(cur)), msk->n_masks);
+}
+
+/*
+ * Keep the bits starting a run of n set bits, going up (or down). The run
+ * length doubles at each step, so it takes log2(n) shift-ands.
+ */
+static uint64_t
+find_runs(uint64_t msk, unsigned int n, bool up)
+{
+	unsigned int len = 1, shift;
+
+	while (len < n) {
+		shift = RTE_MIN(len, n - len);
+		if (up)
+			msk &= msk >> shift;
+		else
+			msk &= msk << shift;
+		len += shift;
+	}
+	return msk;
 }
 
 static size_t
@@ -144,6 +234,7 @@ find_next_n(const struct rte_fbarray *arr, unsigned int start, unsigned int n,
 		uint64_t cur_msk, lookahead_msk;
 		unsigned int run_start, clz, left;
 		bool found = false;
+
 		/*
 		 * The process of getting n consecutive bits for arbitrary n is
 		 * a bit involved, but here it is in a nutshell:
@@ -174,6 +265,19 @@ find_next_n(const struct rte_fbarray *arr, unsigned int start, unsigned int n,
 		if (!used)
 			cur_msk = ~cur_msk;
 
+		/* a run can neither start nor go through masks without any
+		 * entry we're looking for, so skip them all at once.
+		 */
+		if (cur_msk == 0) {
+			/* use the summary for a stretch of masks only */
+			if (msk_idx + 1 < msk->n_masks &&
+					mask_lacks(msk, msk_idx + 1, used))
+				msk_idx = find_next_mask(msk, msk_idx + 2,
+						used) - 1;
+			ignore_msk = 0;
+			continue;
+		}
+
 		/* combine current ignore mask with last index ignore mask */
 		if (msk_idx == last)
 			ignore_msk |= last_msk;
@@ -186,10 +290,7 @@ find_next_n(const struct rte_fbarray *arr, unsigned int start, unsigned int n,
 
 		/* if n can fit in within a single mask, do a search */
 		if (n <= MASK_ALIGN) {
-			uint64_t tmp_msk = cur_msk;
-			unsigned int s_idx;
-			for (s_idx = 0; s_idx < n - 1; s_idx++)
-				tmp_msk &= tmp_msk >> 1ULL;
+			uint64_t tmp_msk = find_runs(cur_msk, n, true);
 			/* we found what we were looking for */
 			if (tmp_msk != 0) {
 				run_start = __builtin_ctzll(tmp_msk);
@@ -218,18 +319,34 @@ find_next_n(const struct rte_fbarray *arr, unsigned int start, unsigned int n,
 
 		for (lookahead_idx = msk_idx + 1; lookahead_idx < msk->n_masks;
 				lookahead_idx++) {
-			unsigned int s_idx, need;
+			unsigned int need, skip;
 			lookahead_msk = msk->data[lookahead_idx];
 
 			/* if we're looking for free space, invert the mask */
 			if (!used)
 				lookahead_msk = ~lookahead_msk;
 
+			/* the masks without any entry of the other kind are
+			 * fully within the run, so skip them at once, but
+			 * check the one where the run may end as usual.
+			 */
+			if (lookahead_msk == UINT64_MAX && left > MASK_ALIGN) {
+				skip = find_next_mask(msk, lookahead_idx, !used) -
+						lookahead_idx;
+				skip = RTE_MIN(skip, (left - 1) / MASK_ALIGN);
+				left -= skip * MASK_ALIGN;
+				lookahead_idx += skip;
+				if (lookahead_idx == msk->n_masks)
+					break;
+				lookahead_msk = msk->data[lookahead_idx];
+				if (!used)
+					lookahead_msk = ~lookahead_msk;
+			}
+
 			/* figure out how many consecutive bits we need here */
 			need = RTE_MIN(left, MASK_ALIGN);
 
-			for (s_idx = 0; s_idx < need - 1; s_idx++)
-				lookahead_msk &= lookahead_msk >> 1ULL;
+			lookahead_msk = find_runs(lookahead_msk, need, true);
 
 			/* if first bit is not set, we've lost the run */
 			if ((lookahead_msk & 1) == 0) {
@@ -303,9 +420,15 @@ find_next(const struct rte_fbarray *arr, unsigned int start, bool used)
 		if (idx == first)
 			cur &= ignore_msk;
 
-		/* check if we have any entries */
-		if (cur == 0)
+		/* check if we have any entries, skip the next masks without
+		 * any entries at once.
+		 */
+		if (cur == 0) {
+			if (idx + 1 < msk->n_masks &&
+					mask_lacks(msk, idx + 1, used))
+				idx = find_next_mask(msk, idx + 2, used) - 1;
 			continue;
+		}
 
 		/*
 		 * find first set bit - that will correspond to whatever it is
@@ -445,10 +568,7 @@ find_prev_n(const struct rte_fbarray *arr, unsigned int start, unsigned int n,
 
 		/* if n can fit in within a single mask, do a search */
 		if (n <= MASK_ALIGN) {
-			uint64_t tmp_msk = cur_msk;
-			unsigned int s_idx;
-			for (s_idx = 0; s_idx < n - 1; s_idx++)
-				tmp_msk &= tmp_msk << 1ULL;
+			uint64_t tmp_msk = find_runs(cur_msk, n, false);
 			/* we found what we were looking for */
 			if (tmp_msk != 0) {
 				/* clz will give us offset from end of mask, and
@@ -492,7 +612,7 @@ find_prev_n(const struct rte_fbarray *arr, unsigned int start, unsigned int n,
 
 		do {
 			const uint64_t last_bit = 1ULL << (MASK_ALIGN - 1);
-			unsigned int s_idx, need;
+			unsigned int need;
 
 			lookbehind_msk = msk->data[lookbehind_idx];
 
@@ -503,8 +623,7 @@ find_prev_n(const struct rte_fbarray *arr, unsigned int start, unsigned int n,
 			/* figure out how many consecutive bits we need here */
 			need = RTE_MIN(left, MASK_ALIGN);
 
-			for (s_idx = 0; s_idx < need - 1; s_idx++)
-				lookbehind_msk &= lookbehind_msk << 1ULL;
+			lookbehind_msk = find_runs(lookbehind_msk, need, false);
 
 			/* if last bit is not set, we've lost the run */
 			if ((lookbehind_msk & last_bit) == 0) {
@@ -683,6 +802,7 @@ set_used(struct rte_fbarray *arr, unsigned int idx, bool used)
 		msk->data[msk_idx] &= ~msk_bit;
 		arr->count--;
 	}
+	update_summary(msk, msk_idx);
 out:
 	rte_rwlock_write_unlock(&arr->rwlock);
 
@@ -713,6 +833,7 @@ rte_fbarray_init(struct rte_fbarray *arr, const char *name, unsigned int len,
 	struct used_mask *msk;
 	struct mem_area *ma = NULL;
 	void *data = NULL;
+	unsigned int i;
 	int fd = -1;
 	const struct internal_config *internal_conf =
 		eal_get_internal_configuration();
@@ -813,6 +934,8 @@ rte_fbarray_init(struct rte_fbarray *arr, const char *name, unsigned int len,
 
 	msk = get_used_mask(data, elt_sz, len);
 	msk->n_masks = MASK_LEN_TO_IDX(RTE_ALIGN_CEIL(len, MASK_ALIGN));
+	for (i = 0; i < msk->n_masks; i++)
+		update_summary(msk, i);
 
 	rte_rwlock_init(&arr->rwlock);
 
@@ -2,22 +2,32 @@
  * Copyright(c) 2010-2014 Intel Corporation
  */
 
+#include <ctype.h>
 #include <unistd.h>
 #include <limits.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include <rte_common.h>
+#include <rte_cycles.h>
 #include <rte_debug.h>
 #include <rte_eal.h>
 #include <rte_errno.h>
 #include <rte_lcore.h>
+#include <rte_lcore_var.h>
 #include <rte_log.h>
 #include <rte_rwlock.h>
+#ifndef RTE_EXEC_ENV_WINDOWS
+#include <rte_telemetry.h>
+#endif
 
 #include "eal_memcfg.h"
 #include "eal_private.h"
 #include "eal_thread.h"
 
+/* Topology domain ids of the cpus, filled at init. */
+static int cpu_domain_ids[CPU_SETSIZE][RTE_LCORE_DOMAIN_MAX];
+
 unsigned int rte_get_main_lcore(void)
 {
 	return rte_eal_get_configuration()->main_lcore;
@@ -118,6 +128,51 @@ rte_lcore_to_socket_id(unsigned int lcore_id)
 	return lcore_config[lcore_id].socket_id;
 }
 
+int
+rte_lcore_domain_id(unsigned int lcore_id, enum rte_lcore_domain domain)
+{
+	const rte_cpuset_t *cpuset;
+	unsigned int cpu;
+	int id = -1;
+
+	if (lcore_id >= RTE_MAX_LCORE ||
+			(unsigned int)domain >= RTE_LCORE_DOMAIN_MAX) {
+		rte_errno = EINVAL;
+		return -1;
+	}
+
+	/* All the cpus of the lcore must be in the same domain. */
+	cpuset = &lcore_config[lcore_id].cpuset;
+	for (cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+		if (!CPU_ISSET(cpu, cpuset))
+			continue;
+		if (cpu_domain_ids[cpu][domain] < 0 ||
+				(id >= 0 && id != cpu_domain_ids[cpu][domain])) {
+			id = -1;
+			break;
+		}
+		id = cpu_domain_ids[cpu][domain];
+	}
+
+	if (id < 0)
+		rte_errno = ENOENT;
+	return id;
+}
+
+enum rte_lcore_domain
+rte_lcore_shared_domain(unsigned int lcore_a, unsigned int lcore_b)
+{
+	enum rte_lcore_domain domain;
+	int id;
+
+	for (domain = 0; domain < RTE_LCORE_DOMAIN_MAX; domain++) {
+		id = rte_lcore_domain_id(lcore_a, domain);
+		if (id >= 0 && id == rte_lcore_domain_id(lcore_b, domain))
+			break;
+	}
+	return domain;
+}
+
 static int
 socket_id_cmp(const void *a, const void *b)
 {
@@ -145,6 +200,8 @@ rte_eal_cpu_init(void)
 	unsigned count = 0;
 	unsigned int socket_id, prev_socket_id;
 	int lcore_to_socket_id[RTE_MAX_LCORE];
+	enum rte_lcore_domain domain;
+	unsigned int cpu;
 
 	/*
 	 * Parse the maximum set of logical cores, detect the subset of running
@@ -188,6 +245,15 @@ rte_eal_cpu_init(void)
 			eal_cpu_socket_id(lcore_id));
 	}
 
+	/* The lcores may be moved to any cpu, get the topology of all. */
+	for (cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+		int detected = eal_cpu_detected(cpu);
+
+		for (domain = 0; domain < RTE_LCORE_DOMAIN_MAX; domain++)
+			cpu_domain_ids[cpu][domain] = detected ?
+				eal_cpu_domain_id(cpu, domain) : -1;
+	}
+
 	/* Set the count of enabled logical cores of the EAL configuration */
 	config->lcore_count = count;
 	RTE_LOG(DEBUG, EAL,
@@ -423,35 +489,40 @@ rte_lcore_iterate(rte_lcore_iterate_cb cb, void *arg)
 	return ret;
 }
 
+static const char *
+lcore_role_str(enum rte_lcore_role_t role)
+{
+	switch (role) {
+	case ROLE_RTE:
+		return "RTE";
+	case ROLE_SERVICE:
+		return "SERVICE";
+	case ROLE_NON_EAL:
+		return "NON_EAL";
+	default:
+		return "UNKNOWN";
+	}
+}
+
 static int
 lcore_dump_cb(unsigned int lcore_id, void *arg)
 {
 	struct rte_config *cfg = rte_eal_get_configuration();
 	char cpuset[RTE_CPU_AFFINITY_STR_LEN];
-	const char *role;
+	const char *role = lcore_role_str(cfg->lcore_role[lcore_id]);
 	FILE *f = arg;
 	int ret;
 
-	switch (cfg->lcore_role[lcore_id]) {
-	case ROLE_RTE:
-		role = "RTE";
-		break;
-	case ROLE_SERVICE:
-		role = "SERVICE";
-		break;
-	case ROLE_NON_EAL:
-		role = "NON_EAL";
-		break;
-	default:
-		role = "UNKNOWN";
-		break;
-	}
-
 	ret = eal_thread_dump_affinity(&lcore_config[lcore_id].cpuset, cpuset,
 		sizeof(cpuset));
-	fprintf(f, "lcore %u, socket %u, role %s, cpuset %s%s\n", lcore_id,
+	fprintf(f, "lcore %u, socket %u, role %s, cpuset %s%s, "
+		"core %d, L2 %d, cluster %d, L3 %d\n", lcore_id,
 		rte_lcore_to_socket_id(lcore_id), role, cpuset,
-		ret == 0 ? "" : "...");
+		ret == 0 ? "" : "...",
+		rte_lcore_domain_id(lcore_id, RTE_LCORE_DOMAIN_CORE),
+		rte_lcore_domain_id(lcore_id, RTE_LCORE_DOMAIN_L2),
+		rte_lcore_domain_id(lcore_id, RTE_LCORE_DOMAIN_CLUSTER),
+		rte_lcore_domain_id(lcore_id, RTE_LCORE_DOMAIN_L3));
 	return 0;
 }
 
@@ -460,3 +531,207 @@ rte_lcore_dump(FILE *f)
 {
 	rte_lcore_iterate(lcore_dump_cb, f);
 }
+
+/* Usage accounted by rte_lcore_usage_poll(), written by its lcore only. */
+struct lcore_usage_state {
+	uint64_t last_tsc;
+	uint64_t total_cycles;
+	uint64_t busy_cycles;
+	int busy;
+};
+
+static RTE_LCORE_VAR_HANDLE(struct lcore_usage_state, lcore_usage_states);
+
+static rte_lcore_usage_cb lcore_usage_cb;
+
+void
+rte_lcore_register_usage_cb(rte_lcore_usage_cb cb)
+{
+	__atomic_store_n(&lcore_usage_cb, cb, __ATOMIC_RELAXED);
+}
+
+void
+rte_lcore_usage_poll(unsigned int nb_work)
+{
+	unsigned int lcore_id = rte_lcore_id();
+	struct lcore_usage_state *state;
+	uint64_t now, cycles;
+
+	if (unlikely(lcore_id >= RTE_MAX_LCORE))
+		return;
+
+	state = RTE_LCORE_VAR_LCORE(lcore_id, lcore_usage_states);
+	now = rte_rdtsc();
+	if (likely(state->last_tsc != 0)) {
+		cycles = now - state->last_tsc;
+		/* Single writer, the stores only need to be atomic */
+		__atomic_store_n(&state->total_cycles,
+				state->total_cycles + cycles, __ATOMIC_RELAXED);
+		if (state->busy)
+			__atomic_store_n(&state->busy_cycles,
+					state->busy_cycles + cycles,
+					__ATOMIC_RELAXED);
+	}
+	state->last_tsc = now;
+	state->busy = nb_work != 0;
+}
+
+int
+rte_lcore_usage_get(unsigned int lcore_id, struct rte_lcore_usage *usage)
+{
+	struct rte_config *cfg = rte_eal_get_configuration();
+	struct lcore_usage_state *state;
+	rte_lcore_usage_cb cb;
+
+	if (lcore_id >= RTE_MAX_LCORE || usage == NULL ||
+			cfg->lcore_role[lcore_id] == ROLE_OFF)
+		return -EINVAL;
+
+	cb = __atomic_load_n(&lcore_usage_cb, __ATOMIC_RELAXED);
+	if (cb != NULL)
+		return cb(lcore_id, usage) == 0 ? 0 : -ENOTSUP;
+
+	state = RTE_LCORE_VAR_LCORE(lcore_id, lcore_usage_states);
+	usage->total_cycles = __atomic_load_n(&state->total_cycles,
+			__ATOMIC_RELAXED);
+	usage->busy_cycles = __atomic_load_n(&state->busy_cycles,
+			__ATOMIC_RELAXED);
+	if (usage->total_cycles == 0)
+		return -ENOTSUP;
+
+	return 0;
+}
+
+#ifndef RTE_EXEC_ENV_WINDOWS
+static int
+lcore_telemetry_list_cb(unsigned int lcore_id, void *arg)
+{
+	struct rte_tel_data *d = arg;
+
+	return rte_tel_data_add_array_int(d, lcore_id);
+}
+
+static int
+handle_lcore_list(const char *cmd __rte_unused,
+		const char *params __rte_unused,
+		struct rte_tel_data *d)
+{
+	rte_tel_data_start_array(d, RTE_TEL_INT_VAL);
+	return rte_lcore_iterate(lcore_telemetry_list_cb, d);
+}
+
+static int
+handle_lcore_info(const char *cmd __rte_unused,
+		const char *params,
+		struct rte_tel_data *d)
+{
+	struct rte_config *cfg = rte_eal_get_configuration();
+	struct rte_lcore_usage usage;
+	struct rte_tel_data *cpus;
+	unsigned long lcore_id;
+	char *end_param;
+	unsigned int cpu;
+
+	if (params == NULL || strlen(params) == 0 || !isdigit(*params))
+		return -EINVAL;
+
+	lcore_id = strtoul(params, &end_param, 0);
+	if (*end_param != '\0')
+		RTE_LOG(NOTICE, EAL,
+			"Extra parameters passed to lcore telemetry command, ignoring\n");
+	if (lcore_id >= RTE_MAX_LCORE ||
+			cfg->lcore_role[lcore_id] == ROLE_OFF)
+		return -EINVAL;
+
+	cpus = rte_tel_data_alloc();
+	if (cpus == NULL)
+		return -ENOMEM;
+	rte_tel_data_start_array(cpus, RTE_TEL_INT_VAL);
+	for (cpu = 0; cpu < CPU_SETSIZE; cpu++)
+		if (CPU_ISSET(cpu, &lcore_config[lcore_id].cpuset))
+			rte_tel_data_add_array_int(cpus, cpu);
+
+	rte_tel_data_start_dict(d);
+	rte_tel_data_add_dict_int(d, "lcore_id", lcore_id);
+	rte_tel_data_add_dict_int(d, "socket", rte_lcore_to_socket_id(lcore_id));
+	rte_tel_data_add_dict_string(d, "role",
+			lcore_role_str(cfg->lcore_role[lcore_id]));
+	rte_tel_data_add_dict_container(d, "cpuset", cpus, 0);
+	if (rte_lcore_usage_get(lcore_id, &usage) == 0) {
+		rte_tel_data_add_dict_u64(d, "total_cycles",
+				usage.total_cycles);
+		rte_tel_data_add_dict_u64(d, "busy_cycles",
+				usage.busy_cycles);
+	}
+
+	return 0;
+}
+
+struct lcore_telemetry_usage {
+	struct rte_tel_data *lcore_ids;
+	struct rte_tel_data *total_cycles;
+	struct rte_tel_data *busy_cycles;
+};
+
+static int
+lcore_telemetry_usage_cb(unsigned int lcore_id, void *arg)
+{
+	struct lcore_telemetry_usage *u = arg;
+	struct rte_lcore_usage usage;
+
+	/* Only the lcores reporting their usage are listed */
+	if (rte_lcore_usage_get(lcore_id, &usage) != 0)
+		return 0;
+
+	rte_tel_data_add_array_int(u->lcore_ids, lcore_id);
+	rte_tel_data_add_array_u64(u->total_cycles, usage.total_cycles);
+	rte_tel_data_add_array_u64(u->busy_cycles, usage.busy_cycles);
+
+	return 0;
+}
+
+static int
+handle_lcore_usage(const char *cmd __rte_unused,
+		const char *params __rte_unused,
+		struct rte_tel_data *d)
+{
+	struct lcore_telemetry_usage u;
+
+	u.lcore_ids = rte_tel_data_alloc();
+	u.total_cycles = rte_tel_data_alloc();
+	u.busy_cycles = rte_tel_data_alloc();
+	if (u.lcore_ids == NULL || u.total_cycles == NULL ||
+			u.busy_cycles == NULL) {
+		rte_tel_data_free(u.lcore_ids);
+		rte_tel_data_free(u.total_cycles);
+		rte_tel_data_free(u.busy_cycles);
+		return -ENOMEM;
+	}
+	rte_tel_data_start_array(u.lcore_ids, RTE_TEL_INT_VAL);
+	rte_tel_data_start_array(u.total_cycles, RTE_TEL_U64_VAL);
+	rte_tel_data_start_array(u.busy_cycles, RTE_TEL_U64_VAL);
+
+	rte_lcore_iterate(lcore_telemetry_usage_cb, &u);
+
+	rte_tel_data_start_dict(d);
+	rte_tel_data_add_dict_container(d, "lcore_ids", u.lcore_ids, 0);
+	rte_tel_data_add_dict_container(d, "total_cycles", u.total_cycles, 0);
+	rte_tel_data_add_dict_container(d, "busy_cycles", u.busy_cycles, 0);
+
+	return 0;
+}
+#endif
+
+RTE_INIT(lcore_usage_init)
+{
+	RTE_LCORE_VAR_ALLOC(lcore_usage_states);
+
+#ifndef RTE_EXEC_ENV_WINDOWS
+	rte_telemetry_register_cmd("/eal/lcore/list", handle_lcore_list,
+			"List of lcore ids. Takes no parameters");
+	rte_telemetry_register_cmd("/eal/lcore/info", handle_lcore_info,
+			"Returns lcore info and usage. Parameters: int lcore_id");
+	rte_telemetry_register_cmd("/eal/lcore/usage", handle_lcore_usage,
+			"Returns the TSC cycles of the lcores reporting their usage, in total and busy. Takes no parameters");
+#endif
+}
@@ -0,0 +1,83 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef RTE_EXEC_ENV_WINDOWS
+#include <malloc.h>
+#endif
+
+#include <rte_common.h>
+#include <rte_debug.h>
+#include <rte_log.h>
+
+#include <rte_lcore_var.h>
+
+#include "eal_private.h"
+
+#define LCORE_BUFFER_SIZE (RTE_MAX_LCORE_VAR * RTE_MAX_LCORE)
+
+/* the buffer the next lcore variables are carved out of */
+static void *lcore_buffer;
+/* the offset of the first free byte in each per-lcore id region */
+static size_t offset = RTE_MAX_LCORE_VAR;
+
+static void *
+lcore_var_alloc(size_t size, size_t align)
+{
+	void *handle;
+	unsigned int lcore_id;
+	void *value;
+
+	offset = RTE_ALIGN_CEIL(offset, align);
+
+	if (offset + size > RTE_MAX_LCORE_VAR) {
+		/* the previous buffer, if any, is still in use: leak it */
+#ifdef RTE_EXEC_ENV_WINDOWS
+		lcore_buffer = _aligned_malloc(LCORE_BUFFER_SIZE,
+				RTE_CACHE_LINE_SIZE);
+#else
+		lcore_buffer = aligned_alloc(RTE_CACHE_LINE_SIZE,
+				LCORE_BUFFER_SIZE);
+#endif
+		if (lcore_buffer == NULL)
+			rte_panic("Unable to allocate lcore variable buffer\n");
+
+		offset = 0;
+	}
+
+	handle = RTE_PTR_ADD(lcore_buffer, offset);
+
+	offset += size;
+
+	RTE_LCORE_VAR_FOREACH(lcore_id, value, handle)
+		memset(value, 0, size);
+
+	RTE_LOG(DEBUG, EAL, "Allocated %zu bytes of per-lcore data with a "
+		"%zu-byte alignment\n", size, align);
+
+	return handle;
+}
+
+void *
+rte_lcore_var_alloc(size_t size, size_t align)
+{
+	/* The buffer is cache line aligned, and so is the distance between
+	 * two per-lcore regions, so an aligned offset gives aligned
+	 * pointers for all the lcore ids.
+	 */
+	RTE_BUILD_BUG_ON(RTE_MAX_LCORE_VAR % RTE_CACHE_LINE_SIZE != 0);
+	RTE_VERIFY(size > 0 && size <= RTE_MAX_LCORE_VAR);
+	RTE_VERIFY(align <= RTE_CACHE_LINE_SIZE);
+
+	/* '0' means asking for worst-case alignment requirements */
+	if (align == 0)
+		align = __alignof__(max_align_t);
+
+	RTE_VERIFY(rte_is_power_of_2(align));
+
+	return lcore_var_alloc(size, align);
+}
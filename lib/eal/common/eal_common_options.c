@@ -107,6 +107,8 @@ eal_long_options[] = {
 	{OPT_TELEMETRY,         0, NULL, OPT_TELEMETRY_NUM        },
 	{OPT_NO_TELEMETRY,      0, NULL, OPT_NO_TELEMETRY_NUM     },
 	{OPT_FORCE_MAX_SIMD_BITWIDTH, 1, NULL, OPT_FORCE_MAX_SIMD_BITWIDTH_NUM},
+	{OPT_MALLOC_LCORE_CACHE, 0, NULL, OPT_MALLOC_LCORE_CACHE_NUM},
+	{OPT_PROBE_THREADS,     1, NULL, OPT_PROBE_THREADS_NUM    },
 
 	/* legacy options that will be removed in future */
 	{OPT_PCI_BLACKLIST,     1, NULL, OPT_PCI_BLACKLIST_NUM    },
@@ -355,6 +357,7 @@ eal_reset_internal_config(struct internal_config *internal_cfg)
 	internal_cfg->init_complete = 0;
 	internal_cfg->max_simd_bitwidth.bitwidth = RTE_VECT_DEFAULT_SIMD_BITWIDTH;
 	internal_cfg->max_simd_bitwidth.forced = 0;
+	internal_cfg->probe_threads = 1;
 }
 
 static int
@@ -1384,6 +1387,29 @@ eal_parse_iova_mode(const char *name)
 	return 0;
 }
 
+static int
+eal_parse_probe_threads(const char *arg)
+{
+	char *end;
+	unsigned long threads;
+	struct internal_config *internal_conf =
+		eal_get_internal_configuration();
+
+	if (arg == NULL || arg[0] == '\0')
+		return -1;
+
+	errno = 0;
+	threads = strtoul(arg, &end, 0);
+
+	/* check for errors */
+	if (errno != 0 || end == NULL || *end != '\0' || threads == 0 ||
+			threads > RTE_MAX_LCORE)
+		return -1;
+
+	internal_conf->probe_threads = threads;
+	return 0;
+}
+
 static int
 eal_parse_simd_bitwidth(const char *arg)
 {
@@ -1825,6 +1851,16 @@ eal_parse_common_option(int opt, const char *optarg,
 			return -1;
 		}
 		break;
+	case OPT_MALLOC_LCORE_CACHE_NUM:
+		conf->malloc_lcore_cache = 1;
+		break;
+	case OPT_PROBE_THREADS_NUM:
+		if (eal_parse_probe_threads(optarg) < 0) {
+			RTE_LOG(ERR, EAL, "invalid parameter for --"
+					OPT_PROBE_THREADS "\n");
+			return -1;
+		}
+		break;
 
 	/* don't know what to do, leave this to caller */
 	default:
@@ -2128,6 +2164,8 @@ eal_common_usage(void)
 	       "  --"OPT_TELEMETRY"   Enable telemetry support (on by default)\n"
 	       "  --"OPT_NO_TELEMETRY"   Disable telemetry support\n"
 	       "  --"OPT_FORCE_MAX_SIMD_BITWIDTH" Force the max SIMD bitwidth\n"
+	       "  --"OPT_MALLOC_LCORE_CACHE" Cache small allocations per lcore\n"
+	       "  --"OPT_PROBE_THREADS" Number of threads probing the devices at init\n"
 	       "\nEAL options for DEBUG use only:\n"
 	       "  --"OPT_HUGE_UNLINK"       Unlink hugepage files after init\n"
 	       "  --"OPT_NO_HUGE"           Use malloc instead of hugetlbfs\n"
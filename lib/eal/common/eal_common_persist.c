@@ -0,0 +1,299 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/statvfs.h>
+
+#include <rte_common.h>
+#include <rte_errno.h>
+#include <rte_log.h>
+#include <rte_persist.h>
+#include <rte_spinlock.h>
+#include <rte_string_fns.h>
+
+#include "eal_private.h"
+
+#define PERSIST_MAGIC 0x5254455045525354ULL /* "RTEPERST" */
+#define PERSIST_VERSION 1
+
+/*
+ * Header at the start of a persistent memory file. The zones are allocated
+ * after it, in order, and are described in the zones array. A zone is only
+ * counted in nb_zones once its descriptor is written, so that a process
+ * killed while reserving a zone leaves a consistent file behind.
+ */
+struct persist_header {
+	uint64_t magic;
+	uint32_t version;
+	uint32_t nb_zones;
+	void *base_va;   /* address the file is always mapped at */
+	size_t len;      /* length of the file */
+	size_t used;     /* offset of the first free byte */
+	struct rte_persist_zone zones[RTE_PERSIST_MAX_ZONES];
+};
+
+static struct {
+	rte_spinlock_t lock;
+	int fd;
+	struct persist_header *hdr;
+} persist = {
+	.lock = RTE_SPINLOCK_INITIALIZER,
+	.fd = -1,
+};
+
+/* map the whole file at the exact address it was created at */
+static void *
+persist_map(int fd, void *addr, size_t len, size_t page_sz)
+{
+	void *va;
+
+	va = eal_get_virtual_area(addr, &len, page_sz, 0, 0);
+	if (va == NULL) {
+		RTE_LOG(ERR, EAL, "Cannot reserve %zu bytes at %p for persistent memory\n",
+			len, addr);
+		return NULL;
+	}
+
+	if (mmap(va, len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED,
+			fd, 0) == MAP_FAILED) {
+		RTE_LOG(ERR, EAL, "Cannot map persistent memory: %s\n",
+			strerror(errno));
+		eal_mem_free(va, len);
+		return NULL;
+	}
+
+	return va;
+}
+
+static int
+persist_attach(int fd, size_t page_sz)
+{
+	struct persist_header *hdr;
+	void *base_va;
+	size_t len;
+
+	hdr = mmap(NULL, page_sz, PROT_READ, MAP_SHARED, fd, 0);
+	if (hdr == MAP_FAILED)
+		return -errno;
+
+	if (hdr->magic != PERSIST_MAGIC || hdr->version != PERSIST_VERSION) {
+		RTE_LOG(ERR, EAL, "Invalid persistent memory file\n");
+		munmap(hdr, page_sz);
+		return -EINVAL;
+	}
+	base_va = hdr->base_va;
+	len = hdr->len;
+	munmap(hdr, page_sz);
+
+	hdr = persist_map(fd, base_va, len, page_sz);
+	if (hdr == NULL)
+		return -ENOMEM;
+
+	persist.hdr = hdr;
+	RTE_LOG(INFO, EAL, "Attached %u persistent zones at %p\n",
+		hdr->nb_zones, base_va);
+	return 1;
+}
+
+static int
+persist_create(int fd, void *addr, size_t len, size_t page_sz)
+{
+	struct persist_header *hdr;
+
+	len = RTE_ALIGN_CEIL(RTE_MAX(len, sizeof(*hdr) + page_sz), page_sz);
+	if (ftruncate(fd, len) < 0)
+		return -errno;
+
+	hdr = persist_map(fd, addr, len, page_sz);
+	if (hdr == NULL) {
+		/* leave an empty file to be created again */
+		if (ftruncate(fd, 0) < 0)
+			RTE_LOG(ERR, EAL, "Cannot truncate persistent memory file\n");
+		return -ENOMEM;
+	}
+
+	hdr->version = PERSIST_VERSION;
+	hdr->nb_zones = 0;
+	hdr->base_va = hdr;
+	hdr->len = len;
+	hdr->used = RTE_ALIGN_CEIL(sizeof(*hdr), RTE_CACHE_LINE_SIZE);
+	/* the file is only valid once fully initialized */
+	rte_wmb();
+	hdr->magic = PERSIST_MAGIC;
+
+	persist.hdr = hdr;
+	RTE_LOG(INFO, EAL, "Created %zu bytes of persistent memory at %p\n",
+		len, (void *)hdr);
+	return 0;
+}
+
+int
+rte_persist_open(const char *path, void *addr, size_t len)
+{
+	struct statvfs vfs;
+	struct stat st;
+	int fd, ret;
+
+	if (path == NULL || (addr == NULL && len == 0))
+		return -EINVAL;
+
+	rte_spinlock_lock(&persist.lock);
+	if (persist.hdr != NULL) {
+		ret = -EBUSY;
+		goto unlock;
+	}
+
+	fd = open(path, O_RDWR | O_CREAT, 0600);
+	if (fd < 0) {
+		ret = -errno;
+		RTE_LOG(ERR, EAL, "Cannot open persistent memory file %s: %s\n",
+			path, strerror(errno));
+		goto unlock;
+	}
+	if (flock(fd, LOCK_EX | LOCK_NB) < 0 || fstat(fd, &st) < 0 ||
+			fstatvfs(fd, &vfs) < 0) {
+		ret = -errno;
+		RTE_LOG(ERR, EAL, "Cannot use persistent memory file %s: %s\n",
+			path, strerror(errno));
+		close(fd);
+		goto unlock;
+	}
+
+	/* on hugetlbfs, the block size is the hugepage size */
+	if (st.st_size == 0)
+		ret = persist_create(fd, addr, len, vfs.f_bsize);
+	else
+		ret = persist_attach(fd, vfs.f_bsize);
+	if (ret < 0) {
+		close(fd);
+		goto unlock;
+	}
+	persist.fd = fd;
+
+unlock:
+	rte_spinlock_unlock(&persist.lock);
+	return ret;
+}
+
+int
+rte_persist_close(void)
+{
+	int ret = 0;
+
+	rte_spinlock_lock(&persist.lock);
+	if (persist.hdr == NULL) {
+		ret = -ENOENT;
+		goto unlock;
+	}
+
+	munmap(persist.hdr, persist.hdr->len);
+	close(persist.fd);
+	persist.hdr = NULL;
+	persist.fd = -1;
+
+unlock:
+	rte_spinlock_unlock(&persist.lock);
+	return ret;
+}
+
+static const struct rte_persist_zone *
+persist_lookup_thread_unsafe(const char *name)
+{
+	struct persist_header *hdr = persist.hdr;
+	uint32_t i;
+
+	for (i = 0; i < hdr->nb_zones; i++) {
+		if (strncmp(hdr->zones[i].name, name,
+				RTE_PERSIST_NAMESIZE) == 0)
+			return &hdr->zones[i];
+	}
+
+	return NULL;
+}
+
+const struct rte_persist_zone *
+rte_persist_zone_reserve(const char *name, size_t len, unsigned int align)
+{
+	const struct rte_persist_zone *zone = NULL;
+	struct persist_header *hdr;
+	struct rte_persist_zone *z;
+	size_t offset;
+
+	if (name == NULL || len == 0 ||
+			(align != 0 && !rte_is_power_of_2(align))) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+	if (strnlen(name, RTE_PERSIST_NAMESIZE) == RTE_PERSIST_NAMESIZE) {
+		rte_errno = ENAMETOOLONG;
+		return NULL;
+	}
+	if (align < RTE_CACHE_LINE_SIZE)
+		align = RTE_CACHE_LINE_SIZE;
+
+	rte_spinlock_lock(&persist.lock);
+	hdr = persist.hdr;
+	if (hdr == NULL) {
+		rte_errno = EINVAL;
+		goto unlock;
+	}
+	if (persist_lookup_thread_unsafe(name) != NULL) {
+		rte_errno = EEXIST;
+		goto unlock;
+	}
+
+	offset = RTE_ALIGN_CEIL(hdr->used, align);
+	if (hdr->nb_zones == RTE_PERSIST_MAX_ZONES || offset > hdr->len ||
+			len > hdr->len - offset) {
+		rte_errno = ENOSPC;
+		goto unlock;
+	}
+
+	z = &hdr->zones[hdr->nb_zones];
+	strlcpy(z->name, name, sizeof(z->name));
+	z->addr = RTE_PTR_ADD(hdr, offset);
+	z->len = len;
+	memset(z->addr, 0, len);
+	hdr->used = offset + len;
+
+	/* publish the zone once it is complete */
+	rte_wmb();
+	hdr->nb_zones++;
+	zone = z;
+
+unlock:
+	rte_spinlock_unlock(&persist.lock);
+	return zone;
+}
+
+const struct rte_persist_zone *
+rte_persist_zone_lookup(const char *name)
+{
+	const struct rte_persist_zone *zone = NULL;
+
+	if (name == NULL) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	rte_spinlock_lock(&persist.lock);
+	if (persist.hdr == NULL) {
+		rte_errno = EINVAL;
+		goto unlock;
+	}
+	zone = persist_lookup_thread_unsafe(name);
+	if (zone == NULL)
+		rte_errno = ENOENT;
+
+unlock:
+	rte_spinlock_unlock(&persist.lock);
+	return zone;
+}
@@ -9,6 +9,7 @@
 #include <inttypes.h>
 #include <libgen.h>
 #include <limits.h>
+#include <poll.h>
 #include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -27,6 +28,7 @@
 #include <rte_errno.h>
 #include <rte_lcore.h>
 #include <rte_log.h>
+#include <rte_memzone.h>
 #include <rte_tailq.h>
 
 #include "eal_memcfg.h"
@@ -103,6 +105,66 @@ static struct {
 	/**< used in async requests only */
 };
 
+/*
+ * Shared memory fast path for the synchronous requests of a secondary process
+ * to the primary process, enabled per action. Each attached secondary process
+ * owns a channel, in a memzone, holding a single request slot handed over
+ * between both processes through its state. The peer is woken up through a
+ * pipe: the doorbell of the primary process, or the reply pipe of the
+ * secondary process, whose write ends are exchanged over the socket when the
+ * channel is attached.
+ */
+#define MP_SHM_ATTACH_ACTION "eal_mp_shm_attach"
+#define MP_SHM_ATTACH_TIMEOUT 5 /* seconds */
+
+enum mp_shm_state {
+	MP_SHM_FREE,     /* owned by the secondary process */
+	MP_SHM_REQ,      /* request posted by the secondary process */
+	MP_SHM_BUSY,     /* request taken by the primary process */
+	MP_SHM_REP,      /* reply posted by the primary process */
+	MP_SHM_CLOSED,   /* channel detached by the secondary process */
+	MP_SHM_DETACHED, /* channel no longer used by the primary process */
+};
+
+struct mp_shm_channel {
+	uint32_t state;
+	int32_t type; /* MP_REP or MP_IGN */
+	int32_t err;  /* errno value if the reply could not be posted */
+	struct rte_mp_msg req;
+	struct rte_mp_msg rep;
+};
+
+/* channel of a secondary process, in the primary process */
+struct mp_shm_peer {
+	TAILQ_ENTRY(mp_shm_peer) next;
+	const struct rte_memzone *mz;
+	struct mp_shm_channel *ch;
+	int rep_fd;          /* write end of the reply pipe */
+	char path[PATH_MAX]; /* socket path of the secondary process */
+};
+
+TAILQ_HEAD(mp_shm_peer_list, mp_shm_peer);
+
+static struct {
+	pthread_mutex_t lock;
+	/* primary process */
+	struct mp_shm_peer_list peers;
+	int doorbell[2];
+	/* secondary process */
+	const struct rte_memzone *mz;
+	struct mp_shm_channel *ch;
+	int doorbell_fd; /* write end of the doorbell */
+	int rep_fd;      /* read end of the reply pipe */
+	struct action_entry_list actions;
+} mp_shm = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+	.peers = TAILQ_HEAD_INITIALIZER(mp_shm.peers),
+	.doorbell = { -1, -1 },
+	.doorbell_fd = -1,
+	.rep_fd = -1,
+	.actions = TAILQ_HEAD_INITIALIZER(mp_shm.actions),
+};
+
 /* forward declarations */
 static int
 mp_send(struct rte_mp_msg *msg, const char *peer, int type);
@@ -377,14 +439,262 @@ process_msg(struct mp_msg_internal *m, struct sockaddr_un *s)
 	}
 }
 
+static int
+mp_shm_pipe(int fds[2])
+{
+	if (pipe(fds) < 0)
+		return -1;
+
+	/* a full pipe already holds a wake up */
+	if (fcntl(fds[0], F_SETFL, O_NONBLOCK) < 0 ||
+			fcntl(fds[1], F_SETFL, O_NONBLOCK) < 0) {
+		close(fds[0]);
+		close(fds[1]);
+		return -1;
+	}
+	return 0;
+}
+
+static void
+mp_shm_wake(int fd)
+{
+	char c = 0;
+
+	if (write(fd, &c, 1) < 0 && errno != EAGAIN)
+		RTE_LOG(ERR, EAL, "Cannot wake up mp peer: %s\n",
+			strerror(errno));
+}
+
+static void
+mp_shm_drain(int fd)
+{
+	char buf[64];
+
+	while (read(fd, buf, sizeof(buf)) > 0)
+		;
+}
+
+/*
+ * Post a reply in the channel of a peer, if it holds a request of the same
+ * name taken by the primary process.
+ * Return 1 if the reply must be sent over the socket instead.
+ */
+static int
+mp_shm_reply(const struct rte_mp_msg *msg, const char *peer, int type)
+{
+	uint32_t busy = MP_SHM_BUSY;
+	struct mp_shm_peer *p;
+	int ret = 1;
+
+	pthread_mutex_lock(&mp_shm.lock);
+	TAILQ_FOREACH(p, &mp_shm.peers, next) {
+		if (strcmp(p->path, peer) != 0 ||
+				__atomic_load_n(&p->ch->state,
+					__ATOMIC_ACQUIRE) != MP_SHM_BUSY ||
+				strcmp(p->ch->req.name, msg->name) != 0)
+			continue;
+
+		ret = 0;
+		p->ch->type = type;
+		p->ch->err = 0;
+		if (msg->num_fds != 0) {
+			RTE_LOG(ERR, EAL, "Cannot pass fd's in shared memory reply: %s\n",
+				msg->name);
+			p->ch->err = ENOTSUP;
+			rte_errno = ENOTSUP;
+			ret = -1;
+		} else {
+			memcpy(&p->ch->rep, msg, sizeof(*msg));
+		}
+		/* the secondary process may have detached meanwhile */
+		if (__atomic_compare_exchange_n(&p->ch->state, &busy,
+				MP_SHM_REP, false, __ATOMIC_RELEASE,
+				__ATOMIC_RELAXED))
+			mp_shm_wake(p->rep_fd);
+		break;
+	}
+	pthread_mutex_unlock(&mp_shm.lock);
+
+	return ret;
+}
+
+static void
+mp_shm_process_request(struct mp_shm_peer *p, const struct rte_mp_msg *msg)
+{
+	struct action_entry *entry;
+	rte_mp_t action = NULL;
+	const struct internal_config *internal_conf =
+		eal_get_internal_configuration();
+
+	RTE_LOG(DEBUG, EAL, "shm request: %s\n", msg->name);
+
+	pthread_mutex_lock(&mp_mutex_action);
+	entry = find_action_entry_by_name(msg->name);
+	if (entry != NULL)
+		action = entry->action;
+	pthread_mutex_unlock(&mp_mutex_action);
+
+	if (action == NULL) {
+		uint32_t busy = MP_SHM_BUSY;
+
+		if (!internal_conf->init_complete) {
+			struct rte_mp_msg dummy;
+
+			memset(&dummy, 0, sizeof(dummy));
+			strlcpy(dummy.name, msg->name, sizeof(dummy.name));
+			mp_shm_reply(&dummy, p->path, MP_IGN);
+			return;
+		}
+		RTE_LOG(ERR, EAL, "Cannot find action: %s\n", msg->name);
+		/* as over the socket, the requester times out */
+		__atomic_compare_exchange_n(&p->ch->state, &busy, MP_SHM_FREE,
+			false, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+	} else if (action(msg, p->path) < 0) {
+		RTE_LOG(ERR, EAL, "Fail to handle message: %s\n", msg->name);
+	}
+}
+
+/*
+ * Serve the requests posted in the channels and drop the detached channels.
+ * The list of peers is only modified from the mp thread, so that it can be
+ * walked without holding its lock while calling the actions.
+ */
+static void
+mp_shm_process(void)
+{
+	struct mp_shm_peer *p, *tmp;
+	struct rte_mp_msg msg;
+	uint32_t state;
+
+	mp_shm_drain(mp_shm.doorbell[0]);
+
+	TAILQ_FOREACH_SAFE(p, &mp_shm.peers, next, tmp) {
+		state = __atomic_load_n(&p->ch->state, __ATOMIC_ACQUIRE);
+		if (state == MP_SHM_CLOSED) {
+			pthread_mutex_lock(&mp_shm.lock);
+			TAILQ_REMOVE(&mp_shm.peers, p, next);
+			pthread_mutex_unlock(&mp_shm.lock);
+			/* the secondary process frees the memzone */
+			__atomic_store_n(&p->ch->state, MP_SHM_DETACHED,
+				__ATOMIC_RELEASE);
+			mp_shm_wake(p->rep_fd);
+			close(p->rep_fd);
+			free(p);
+			continue;
+		}
+
+		/* the secondary process may take back a timed out request */
+		if (state != MP_SHM_REQ ||
+				!__atomic_compare_exchange_n(&p->ch->state,
+					&state, MP_SHM_BUSY, false,
+					__ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+			continue;
+
+		memcpy(&msg, &p->ch->req, sizeof(msg));
+		mp_shm_process_request(p, &msg);
+	}
+}
+
+static int
+mp_shm_attach_handle(const struct rte_mp_msg *msg, const void *peer)
+{
+	const struct rte_memzone *mz = NULL;
+	struct rte_mp_msg reply;
+	struct mp_shm_peer *p;
+	int ret = -EINVAL;
+
+	memset(&reply, 0, sizeof(reply));
+	strlcpy(reply.name, msg->name, sizeof(reply.name));
+	reply.len_param = sizeof(ret);
+
+	if (msg->num_fds != 1)
+		goto reply;
+
+	if (msg->len_param > 0 &&
+			memchr(msg->param, '\0', msg->len_param) != NULL)
+		mz = rte_memzone_lookup((const char *)msg->param);
+	if (mz == NULL || mz->len < sizeof(struct mp_shm_channel)) {
+		RTE_LOG(ERR, EAL, "Invalid mp channel of %s\n",
+			(const char *)peer);
+		goto close_fd;
+	}
+
+	pthread_mutex_lock(&mp_shm.lock);
+	TAILQ_FOREACH(p, &mp_shm.peers, next) {
+		if (p->mz == mz)
+			break;
+	}
+	if (p != NULL) {
+		/* left by a killed process, whose pid is reused */
+		close(p->rep_fd);
+	} else {
+		p = calloc(1, sizeof(*p));
+		if (p == NULL) {
+			pthread_mutex_unlock(&mp_shm.lock);
+			ret = -ENOMEM;
+			goto close_fd;
+		}
+		p->mz = mz;
+		p->ch = mz->addr;
+		TAILQ_INSERT_TAIL(&mp_shm.peers, p, next);
+	}
+	p->rep_fd = msg->fds[0];
+	strlcpy(p->path, peer, sizeof(p->path));
+	pthread_mutex_unlock(&mp_shm.lock);
+
+	RTE_LOG(DEBUG, EAL, "Attached mp channel %s of %s\n", mz->name,
+		(const char *)peer);
+	reply.num_fds = 1;
+	reply.fds[0] = mp_shm.doorbell[1];
+	ret = 0;
+	goto reply;
+
+close_fd:
+	close(msg->fds[0]);
+reply:
+	memcpy(reply.param, &ret, sizeof(ret));
+	return rte_mp_reply(&reply, peer);
+}
+
+static int
+mp_shm_init(void)
+{
+	if (mp_shm_pipe(mp_shm.doorbell) < 0) {
+		RTE_LOG(ERR, EAL, "failed to create mp doorbell: %s\n",
+			strerror(errno));
+		return -1;
+	}
+
+	if (rte_mp_action_register(MP_SHM_ATTACH_ACTION,
+			mp_shm_attach_handle) < 0) {
+		RTE_LOG(ERR, EAL, "failed to register mp channel action\n");
+		close(mp_shm.doorbell[0]);
+		close(mp_shm.doorbell[1]);
+		mp_shm.doorbell[0] = mp_shm.doorbell[1] = -1;
+		return -1;
+	}
+
+	return 0;
+}
+
 static void *
 mp_handle(void *arg __rte_unused)
 {
 	struct mp_msg_internal msg;
 	struct sockaddr_un sa;
+	struct pollfd fds[2] = {
+		{ .fd = mp_fd, .events = POLLIN },
+		{ .fd = mp_shm.doorbell[0], .events = POLLIN },
+	};
+	/* only the primary process has a doorbell */
+	nfds_t nfds = mp_shm.doorbell[0] < 0 ? 1 : 2;
 
 	while (1) {
-		if (read_msg(&msg, &sa) == 0)
+		if (poll(fds, nfds, -1) < 0)
+			continue;
+		if (fds[1].revents & POLLIN)
+			mp_shm_process();
+		if ((fds[0].revents & POLLIN) && read_msg(&msg, &sa) == 0)
 			process_msg(&msg, &sa);
 	}
 
@@ -579,6 +889,278 @@ close_socket_fd(void)
 	unlink(path);
 }
 
+/* wait for the primary process to set a state of the channel */
+static int
+mp_shm_wait(uint32_t state, const struct timespec *end)
+{
+	struct pollfd pfd = { .fd = mp_shm.rep_fd, .events = POLLIN };
+	struct timespec now;
+	int64_t ms;
+
+	while (__atomic_load_n(&mp_shm.ch->state, __ATOMIC_ACQUIRE) != state) {
+		if (clock_gettime(CLOCK_MONOTONIC, &now) < 0 ||
+				timespec_cmp(end, &now) <= 0)
+			return -1;
+
+		ms = (int64_t)(end->tv_sec - now.tv_sec) * 1000 +
+			(end->tv_nsec - now.tv_nsec) / 1000000 + 1;
+		if (poll(&pfd, 1, RTE_MIN(ms, (int64_t)INT_MAX)) > 0) {
+			/* the primary process is gone */
+			if (pfd.revents & (POLLHUP | POLLERR))
+				return __atomic_load_n(&mp_shm.ch->state,
+					__ATOMIC_ACQUIRE) == state ? 0 : -1;
+			mp_shm_drain(mp_shm.rep_fd);
+		}
+	}
+
+	return 0;
+}
+
+static bool
+mp_shm_action_enabled(const char *name)
+{
+	struct action_entry *entry;
+
+	TAILQ_FOREACH(entry, &mp_shm.actions, next) {
+		if (strncmp(entry->action_name, name, RTE_MP_MAX_NAME_LEN) == 0)
+			return true;
+	}
+
+	return false;
+}
+
+/*
+ * Send a request of a secondary process over its channel, if enabled for
+ * its action and not in use by another thread.
+ * Return 1 if the request must be sent over the socket instead.
+ */
+static int
+mp_shm_request_sync(struct rte_mp_msg *req, struct rte_mp_reply *reply,
+		const struct timespec *end)
+{
+	struct mp_shm_channel *ch;
+	uint32_t state;
+	int ret = 1;
+
+	if (req->num_fds != 0 || pthread_mutex_trylock(&mp_shm.lock) != 0)
+		return 1;
+
+	ch = mp_shm.ch;
+	if (ch == NULL || !mp_shm_action_enabled(req->name))
+		goto unlock;
+
+	state = __atomic_load_n(&ch->state, __ATOMIC_ACQUIRE);
+	/* late reply to a timed out request */
+	if (state == MP_SHM_REP)
+		state = MP_SHM_FREE;
+	/* the primary process still handles a timed out request */
+	if (state != MP_SHM_FREE)
+		goto unlock;
+
+	memcpy(&ch->req, req, sizeof(*req));
+	__atomic_store_n(&ch->state, MP_SHM_REQ, __ATOMIC_RELEASE);
+	mp_shm_wake(mp_shm.doorbell_fd);
+	reply->nb_sent++;
+
+	ret = -1;
+	if (mp_shm_wait(MP_SHM_REP, end) < 0) {
+		state = MP_SHM_REQ;
+		/* take the request back, unless the primary process got it */
+		__atomic_compare_exchange_n(&ch->state, &state, MP_SHM_FREE,
+			false, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+		RTE_LOG(ERR, EAL, "Fail to recv reply for request %s\n",
+			req->name);
+		rte_errno = ETIMEDOUT;
+		goto unlock;
+	}
+
+	if (ch->err != 0) {
+		rte_errno = ch->err;
+	} else if (ch->type == MP_IGN) {
+		RTE_LOG(DEBUG, EAL, "Asked to ignore response\n");
+		reply->nb_sent--;
+		ret = 0;
+	} else {
+		reply->msgs = malloc(sizeof(*reply->msgs));
+		if (reply->msgs == NULL) {
+			RTE_LOG(ERR, EAL, "Fail to alloc reply for request %s\n",
+				req->name);
+			rte_errno = ENOMEM;
+		} else {
+			memcpy(reply->msgs, &ch->rep, sizeof(*reply->msgs));
+			reply->nb_received++;
+			ret = 0;
+		}
+	}
+	__atomic_store_n(&ch->state, MP_SHM_FREE, __ATOMIC_RELAXED);
+
+unlock:
+	pthread_mutex_unlock(&mp_shm.lock);
+	return ret;
+}
+
+/* attach the channel of the secondary process, with its lock held */
+static int
+mp_shm_attach(void)
+{
+	const struct timespec ts = { .tv_sec = MP_SHM_ATTACH_TIMEOUT };
+	char name[RTE_MEMZONE_NAMESIZE];
+	const struct rte_memzone *mz;
+	struct mp_shm_channel *ch;
+	struct rte_mp_reply reply;
+	struct rte_mp_msg msg;
+	const struct rte_mp_msg *r;
+	int rep_fds[2], ret;
+
+	snprintf(name, sizeof(name), "mp_shm_%d", getpid());
+	mz = rte_memzone_reserve(name, sizeof(*ch), SOCKET_ID_ANY, 0);
+	/* left by a killed process, whose pid is reused */
+	if (mz == NULL && rte_errno == EEXIST)
+		mz = rte_memzone_lookup(name);
+	if (mz == NULL) {
+		RTE_LOG(ERR, EAL, "Cannot reserve mp channel\n");
+		return -1;
+	}
+	ch = mz->addr;
+	__atomic_store_n(&ch->state, MP_SHM_FREE, __ATOMIC_RELAXED);
+
+	if (mp_shm_pipe(rep_fds) < 0) {
+		RTE_LOG(ERR, EAL, "Cannot create mp reply pipe: %s\n",
+			strerror(errno));
+		rte_errno = errno;
+		goto free_mz;
+	}
+
+	memset(&msg, 0, sizeof(msg));
+	strlcpy(msg.name, MP_SHM_ATTACH_ACTION, sizeof(msg.name));
+	msg.len_param = strlen(name) + 1;
+	memcpy(msg.param, name, msg.len_param);
+	msg.num_fds = 1;
+	msg.fds[0] = rep_fds[1];
+
+	/* goes over the socket, as the channel lock is held */
+	ret = rte_mp_request_sync(&msg, &reply, &ts);
+	close(rep_fds[1]);
+	if (ret < 0)
+		goto close_pipe;
+	if (reply.nb_received != 1) {
+		rte_errno = ENOTSUP;
+		goto free_reply;
+	}
+
+	r = &reply.msgs[0];
+	if (r->len_param != sizeof(ret) || r->num_fds != 1) {
+		RTE_LOG(ERR, EAL, "Invalid mp channel reply\n");
+		rte_errno = EPROTO;
+		if (r->num_fds == 1)
+			close(r->fds[0]);
+		goto free_reply;
+	}
+	memcpy(&ret, r->param, sizeof(ret));
+	if (ret < 0) {
+		rte_errno = -ret;
+		close(r->fds[0]);
+		goto free_reply;
+	}
+
+	mp_shm.doorbell_fd = r->fds[0];
+	mp_shm.rep_fd = rep_fds[0];
+	mp_shm.mz = mz;
+	mp_shm.ch = ch;
+	free(reply.msgs);
+	RTE_LOG(DEBUG, EAL, "Attached mp channel %s\n", name);
+	return 0;
+
+free_reply:
+	free(reply.msgs);
+close_pipe:
+	close(rep_fds[0]);
+free_mz:
+	rte_memzone_free(mz);
+	return -1;
+}
+
+static void
+mp_shm_detach(void)
+{
+	struct action_entry *entry;
+	struct timespec end;
+
+	pthread_mutex_lock(&mp_shm.lock);
+	while ((entry = TAILQ_FIRST(&mp_shm.actions)) != NULL) {
+		TAILQ_REMOVE(&mp_shm.actions, entry, next);
+		free(entry);
+	}
+	if (mp_shm.ch == NULL)
+		goto unlock;
+
+	__atomic_store_n(&mp_shm.ch->state, MP_SHM_CLOSED, __ATOMIC_RELEASE);
+	mp_shm_wake(mp_shm.doorbell_fd);
+
+	/* the memzone is leaked if the primary process may still use it */
+	if (clock_gettime(CLOCK_MONOTONIC, &end) == 0) {
+		end.tv_sec += MP_SHM_ATTACH_TIMEOUT;
+		if (mp_shm_wait(MP_SHM_DETACHED, &end) == 0)
+			rte_memzone_free(mp_shm.mz);
+	}
+
+	close(mp_shm.doorbell_fd);
+	close(mp_shm.rep_fd);
+	mp_shm.doorbell_fd = -1;
+	mp_shm.rep_fd = -1;
+	mp_shm.mz = NULL;
+	mp_shm.ch = NULL;
+
+unlock:
+	pthread_mutex_unlock(&mp_shm.lock);
+}
+
+int
+rte_mp_shm_request_enable(const char *name)
+{
+	struct action_entry *entry;
+	const struct internal_config *internal_conf =
+		eal_get_internal_configuration();
+	int ret = -1;
+
+	if (validate_action_name(name) != 0)
+		return -1;
+
+	if (internal_conf->no_shconf) {
+		RTE_LOG(DEBUG, EAL, "No shared files mode enabled, IPC is disabled\n");
+		rte_errno = ENOTSUP;
+		return -1;
+	}
+
+	if (rte_eal_process_type() != RTE_PROC_SECONDARY) {
+		rte_errno = EINVAL;
+		return -1;
+	}
+
+	pthread_mutex_lock(&mp_shm.lock);
+	if (mp_shm_action_enabled(name)) {
+		ret = 0;
+		goto unlock;
+	}
+
+	if (mp_shm.ch == NULL && mp_shm_attach() < 0)
+		goto unlock;
+
+	entry = malloc(sizeof(*entry));
+	if (entry == NULL) {
+		rte_errno = ENOMEM;
+		goto unlock;
+	}
+	strlcpy(entry->action_name, name, sizeof(entry->action_name));
+	entry->action = NULL;
+	TAILQ_INSERT_TAIL(&mp_shm.actions, entry, next);
+	ret = 0;
+
+unlock:
+	pthread_mutex_unlock(&mp_shm.lock);
+	return ret;
+}
+
 int
 rte_mp_channel_init(void)
 {
@@ -625,6 +1207,13 @@ rte_mp_channel_init(void)
 		return -1;
 	}
 
+	if (rte_eal_process_type() == RTE_PROC_PRIMARY && mp_shm_init() < 0) {
+		close(mp_fd);
+		close(dir_fd);
+		mp_fd = -1;
+		return -1;
+	}
+
 	if (rte_ctrl_thread_create(&mp_handle_tid, "rte_mp_handle",
 			NULL, mp_handle, NULL) < 0) {
 		RTE_LOG(ERR, EAL, "failed to create mp thread: %s\n",
@@ -645,6 +1234,8 @@ rte_mp_channel_init(void)
 void
 rte_mp_channel_cleanup(void)
 {
+	if (rte_eal_process_type() == RTE_PROC_SECONDARY)
+		mp_shm_detach();
 	close_socket_fd();
 }
 
@@ -998,6 +1589,10 @@ rte_mp_request_sync(struct rte_mp_msg *req, struct rte_mp_reply *reply,
 
 	/* for secondary process, send request to the primary process only */
 	if (rte_eal_process_type() == RTE_PROC_SECONDARY) {
+		ret = mp_shm_request_sync(req, reply, &end);
+		if (ret != 1)
+			goto end;
+
 		pthread_mutex_lock(&pending_requests.lock);
 		ret = mp_request_sync(eal_mp_socket_path(), req, reply, &end);
 		pthread_mutex_unlock(&pending_requests.lock);
@@ -1230,6 +1825,13 @@ rte_mp_reply(struct rte_mp_msg *msg, const char *peer)
 		return 0;
 	}
 
+	if (rte_eal_process_type() == RTE_PROC_PRIMARY) {
+		int ret = mp_shm_reply(msg, peer, MP_REP);
+
+		if (ret != 1)
+			return ret;
+	}
+
 	return mp_send(msg, peer, MP_REP);
 }
 
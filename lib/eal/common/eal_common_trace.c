@@ -11,7 +11,9 @@
 #include <rte_errno.h>
 #include <rte_lcore.h>
 #include <rte_per_lcore.h>
+#include <rte_random.h>
 #include <rte_string_fns.h>
+#include <rte_telemetry.h>
 
 #include "eal_trace.h"
 
@@ -182,6 +184,40 @@ rte_trace_point_disable(rte_trace_point_t *trace)
 	return 0;
 }
 
+int
+rte_trace_point_sampling_set(rte_trace_point_t *trace, uint32_t period)
+{
+	uint64_t val, shift;
+
+	if (trace_point_is_invalid(trace))
+		return -ERANGE;
+
+	if (!rte_is_power_of_2(period))
+		return -EINVAL;
+	shift = rte_bsf32(period);
+
+	val = __atomic_load_n(trace, __ATOMIC_RELAXED);
+	while (!__atomic_compare_exchange_n(trace, &val,
+			(val & ~__RTE_TRACE_FIELD_SAMPLING_MASK) |
+			(shift << __RTE_TRACE_FIELD_SAMPLING_SHIFT),
+			false, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+		;
+	return 0;
+}
+
+uint32_t
+rte_trace_point_sampling_get(rte_trace_point_t *trace)
+{
+	uint64_t val;
+
+	if (trace_point_is_invalid(trace))
+		return 0;
+
+	val = __atomic_load_n(trace, __ATOMIC_ACQUIRE);
+	return UINT32_C(1) << ((val & __RTE_TRACE_FIELD_SAMPLING_MASK) >>
+		__RTE_TRACE_FIELD_SAMPLING_SHIFT);
+}
+
 int
 rte_trace_pattern(const char *pattern, bool enable)
 {
@@ -249,10 +285,11 @@ trace_point_dump(FILE *f, struct trace_point *tp)
 {
 	rte_trace_point_t *handle = tp->handle;
 
-	fprintf(f, "\tid %d, %s, size is %d, %s\n",
+	fprintf(f, "\tid %d, %s, size is %d, %s, sampling 1/%u\n",
 		trace_id_get(handle), tp->name,
 		(uint16_t)(*handle & __RTE_TRACE_FIELD_SIZE_MASK),
-		rte_trace_point_is_enabled(handle) ? "enabled" : "disabled");
+		rte_trace_point_is_enabled(handle) ? "enabled" : "disabled",
+		rte_trace_point_sampling_get(handle));
 }
 
 static void
@@ -352,6 +389,8 @@ __rte_trace_mem_per_thread_alloc(void)
 found:
 	header->offset = 0;
 	header->len = trace->buff_len;
+	/* xorshift state must not be zero */
+	header->sampling_state = rte_rand() | 1;
 	header->stream_header.magic = TRACE_CTF_MAGIC;
 	rte_uuid_copy(header->stream_header.uuid, trace->uuid);
 	header->stream_header.lcore_id = rte_lcore_id();
@@ -531,3 +570,70 @@ __rte_trace_point_register(rte_trace_point_t *handle, const char *name,
 
 	return -rte_errno;
 }
+
+static int
+trace_telemetry_info(const char *cmd __rte_unused,
+		const char *params __rte_unused, struct rte_tel_data *d)
+{
+	rte_tel_data_start_dict(d);
+	rte_tel_data_add_dict_int(d, "enabled", rte_trace_is_enabled());
+	rte_tel_data_add_dict_string(d, "mode",
+		trace_mode_to_string(rte_trace_mode_get()));
+	rte_tel_data_add_dict_string(d, "dir", trace.dir);
+	rte_tel_data_add_dict_u64(d, "buffer_len", trace.buff_len);
+	rte_tel_data_add_dict_u64(d, "nb_trace_points", trace.nb_trace_points);
+	rte_tel_data_add_dict_u64(d, "nb_threads", trace.nb_trace_mem_list);
+	return 0;
+}
+
+/* sampling period of the trace points matching an optional pattern,
+ * 0 for the disabled ones
+ */
+static int
+trace_telemetry_list(const char *cmd __rte_unused, const char *params,
+		struct rte_tel_data *d)
+{
+	struct trace_point *tp;
+
+	rte_tel_data_start_dict(d);
+	STAILQ_FOREACH(tp, &tp_list, next) {
+		if (params != NULL && *params != '\0' &&
+				fnmatch(params, tp->name, 0) != 0)
+			continue;
+		if (rte_tel_data_add_dict_u64(d, tp->name,
+				rte_trace_point_is_enabled(tp->handle) ?
+				rte_trace_point_sampling_get(tp->handle) : 0) < 0)
+			break;
+	}
+	return 0;
+}
+
+/* snapshot of the trace buffers, saved in the trace directory */
+static int
+trace_telemetry_save(const char *cmd __rte_unused,
+		const char *params __rte_unused, struct rte_tel_data *d)
+{
+	int rc;
+
+	if (!rte_trace_is_enabled())
+		return -ENOTSUP;
+
+	rc = rte_trace_save();
+	if (rc < 0)
+		return rc;
+
+	rte_tel_data_start_dict(d);
+	rte_tel_data_add_dict_string(d, "dir", trace.dir);
+	rte_tel_data_add_dict_u64(d, "nb_threads", trace.nb_trace_mem_list);
+	return 0;
+}
+
+RTE_INIT(trace_telemetry_init)
+{
+	rte_telemetry_register_cmd("/trace/info", trace_telemetry_info,
+		"Returns the trace configuration. Takes no parameters");
+	rte_telemetry_register_cmd("/trace/list", trace_telemetry_list,
+		"Returns the sampling period of the trace points, 0 if disabled. Parameters: optional glob pattern");
+	rte_telemetry_register_cmd("/trace/save", trace_telemetry_save,
+		"Saves the trace buffers in the trace directory. Takes no parameters");
+}
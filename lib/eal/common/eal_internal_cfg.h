@@ -72,6 +72,10 @@ struct internal_config {
 	 */
 	volatile unsigned match_allocations;
 	/**< true to free hugepages exactly as allocated */
+	volatile unsigned malloc_lcore_cache;
+	/**< true to cache small malloc elements per lcore */
+	unsigned int probe_threads;
+	/**< number of threads probing the devices at init */
 	volatile unsigned single_file_segments;
 	/**< true if storing all pages within single files (per-page-size,
 	 * per-node) non-legacy mode only.
@@ -93,6 +93,10 @@ enum {
 	OPT_NO_TELEMETRY_NUM,
 #define OPT_FORCE_MAX_SIMD_BITWIDTH  "force-max-simd-bitwidth"
 	OPT_FORCE_MAX_SIMD_BITWIDTH_NUM,
+#define OPT_MALLOC_LCORE_CACHE "malloc-lcore-cache"
+	OPT_MALLOC_LCORE_CACHE_NUM,
+#define OPT_PROBE_THREADS     "probe-threads"
+	OPT_PROBE_THREADS_NUM,
 
 	/* legacy option that will be removed in future */
 #define OPT_PCI_BLACKLIST     "pci-blacklist"
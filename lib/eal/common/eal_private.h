@@ -342,6 +342,13 @@ unsigned eal_cpu_core_id(unsigned lcore_id);
  */
 int eal_cpu_detected(unsigned lcore_id);
 
+/**
+ * Get the topology domain id of a cpu, -1 if unknown.
+ *
+ * This function is private to the EAL.
+ */
+int eal_cpu_domain_id(unsigned int cpu, enum rte_lcore_domain domain);
+
 /**
  * Set TSC frequency from precise value or estimation
  *
@@ -23,6 +23,7 @@
 #include <rte_memzone.h>
 #include <rte_atomic.h>
 #include <rte_fbarray.h>
+#include <rte_lcore_var.h>
 
 #include "eal_internal_cfg.h"
 #include "eal_memalloc.h"
@@ -36,6 +37,31 @@
 #define CONST_MAX(a, b) (a > b ? a : b) /* RTE_MAX is not a constant */
 #define EXTERNAL_HEAP_MIN_SOCKET_ID (CONST_MAX((1 << 8), RTE_MAX_NUMA_NODES))
 
+/*
+ * Per-lcore caches of small elements, enabled with --malloc-lcore-cache, so
+ * that the hot path allocations of an lcore do not take the heap lock. The
+ * cached elements remain busy in the heap. They are not used with malloc
+ * debug, which poisons freed memory.
+ */
+#if RTE_MALLOC_LCORE_CACHE_SIZE > 0 && !defined(RTE_MALLOC_DEBUG)
+#define MALLOC_LCORE_CACHE
+
+/* size classes are powers of two, from 64 bytes to 2 kB */
+#define MALLOC_CACHE_MIN_SHIFT 6
+#define MALLOC_CACHE_NB_CLASSES 6
+#define MALLOC_CACHE_MAX_SIZE \
+	(1UL << (MALLOC_CACHE_MIN_SHIFT + MALLOC_CACHE_NB_CLASSES - 1))
+
+struct malloc_lcore_cache {
+	unsigned int len[MALLOC_CACHE_NB_CLASSES];
+	struct malloc_elem *objs[MALLOC_CACHE_NB_CLASSES]
+			[RTE_MALLOC_LCORE_CACHE_SIZE];
+};
+
+static RTE_LCORE_VAR_HANDLE(struct malloc_lcore_cache, malloc_lcore_caches);
+RTE_LCORE_VAR_INIT(malloc_lcore_caches);
+#endif
+
 static unsigned
 check_hugepage_sz(unsigned flags, uint64_t hugepage_sz)
 {
@@ -738,6 +764,62 @@ malloc_heap_alloc(const char *type, size_t size, int socket_arg,
 	return NULL;
 }
 
+#ifdef MALLOC_LCORE_CACHE
+/* smallest class holding a block of a given size */
+static inline unsigned int
+malloc_cache_alloc_class(size_t size)
+{
+	return RTE_MAX(rte_log2_u64(size), (uint32_t)MALLOC_CACHE_MIN_SHIFT) -
+		MALLOC_CACHE_MIN_SHIFT;
+}
+
+/* biggest class whose blocks fit in a given size, may be out of range */
+static inline unsigned int
+malloc_cache_free_class(size_t size)
+{
+	return rte_fls_u64(size) - 1 - MALLOC_CACHE_MIN_SHIFT;
+}
+
+void *
+malloc_heap_alloc_cached(const char *type, size_t size, int socket_arg,
+		size_t align)
+{
+	const struct internal_config *internal_conf =
+		eal_get_internal_configuration();
+	struct malloc_lcore_cache *cache;
+	struct malloc_elem *elem;
+	unsigned int cls;
+
+	/* only the allocations on the local socket can use the cache */
+	if (!internal_conf->malloc_lcore_cache ||
+			rte_lcore_id() == LCORE_ID_ANY || size == 0 ||
+			size > MALLOC_CACHE_MAX_SIZE ||
+			align > RTE_CACHE_LINE_SIZE ||
+			(socket_arg != SOCKET_ID_ANY &&
+			 socket_arg != (int)rte_socket_id()))
+		return malloc_heap_alloc(type, size, socket_arg, 0, align, 0,
+				false);
+
+	cls = malloc_cache_alloc_class(size);
+	cache = RTE_LCORE_VAR(malloc_lcore_caches);
+	if (cache->len[cls] > 0) {
+		elem = cache->objs[cls][--cache->len[cls]];
+		return RTE_PTR_ADD(elem, MALLOC_ELEM_HEADER_LEN);
+	}
+
+	/* allocate the whole class size, so that the block can be cached */
+	return malloc_heap_alloc(type, 1UL << (cls + MALLOC_CACHE_MIN_SHIFT),
+			socket_arg, 0, align, 0, false);
+}
+#else
+void *
+malloc_heap_alloc_cached(const char *type, size_t size, int socket_arg,
+		size_t align)
+{
+	return malloc_heap_alloc(type, size, socket_arg, 0, align, 0, false);
+}
+#endif
+
 static void *
 heap_alloc_biggest_on_heap_id(const char *type, unsigned int heap_id,
 		unsigned int flags, size_t align, bool contig)
@@ -1005,6 +1087,75 @@ malloc_heap_free(struct malloc_elem *elem)
 	return ret;
 }
 
+#ifdef MALLOC_LCORE_CACHE
+static void
+malloc_cache_flush(struct malloc_lcore_cache *cache, unsigned int cls,
+		unsigned int len)
+{
+	while (cache->len[cls] > len)
+		malloc_heap_free(cache->objs[cls][--cache->len[cls]]);
+}
+
+int
+malloc_heap_free_cached(struct malloc_elem *elem)
+{
+	const struct internal_config *internal_conf =
+		eal_get_internal_configuration();
+	struct malloc_lcore_cache *cache;
+	unsigned int cls;
+	size_t data_len;
+
+	if (!internal_conf->malloc_lcore_cache ||
+			rte_lcore_id() == LCORE_ID_ANY ||
+			!malloc_elem_cookies_ok(elem) ||
+			elem->state != ELEM_BUSY || elem->pad != 0 ||
+			elem->msl->external > 0 ||
+			(elem->heap->socket_id != rte_socket_id() &&
+			 rte_eal_has_hugepages()))
+		return malloc_heap_free(elem);
+
+	data_len = elem->size - MALLOC_ELEM_OVERHEAD;
+	if (data_len < (1UL << MALLOC_CACHE_MIN_SHIFT))
+		return malloc_heap_free(elem);
+	cls = malloc_cache_free_class(data_len);
+	if (cls >= MALLOC_CACHE_NB_CLASSES)
+		return malloc_heap_free(elem);
+
+	cache = RTE_LCORE_VAR(malloc_lcore_caches);
+	/* give half of a full cache back to the heap */
+	if (cache->len[cls] == RTE_MALLOC_LCORE_CACHE_SIZE)
+		malloc_cache_flush(cache, cls, RTE_MALLOC_LCORE_CACHE_SIZE / 2);
+
+	/* freed memory is zeroed, as expected by zmalloc */
+	memset(RTE_PTR_ADD(elem, MALLOC_ELEM_HEADER_LEN), 0, data_len);
+	cache->objs[cls][cache->len[cls]++] = elem;
+
+	return 0;
+}
+
+void
+malloc_heap_cache_flush_all(void)
+{
+	struct malloc_lcore_cache *cache;
+	unsigned int lcore_id, cls;
+
+	RTE_LCORE_VAR_FOREACH(lcore_id, cache, malloc_lcore_caches)
+		for (cls = 0; cls < MALLOC_CACHE_NB_CLASSES; cls++)
+			malloc_cache_flush(cache, cls, 0);
+}
+#else
+int
+malloc_heap_free_cached(struct malloc_elem *elem)
+{
+	return malloc_heap_free(elem);
+}
+
+void
+malloc_heap_cache_flush_all(void)
+{
+}
+#endif
+
 int
 malloc_heap_resize(struct malloc_elem *elem, size_t size)
 {
@@ -81,9 +81,30 @@ int
 malloc_heap_remove_external_memory(struct malloc_heap *heap, void *va_addr,
 		size_t len);
 
+/*
+ * Allocate a block without size hint, alignment bound nor contiguity,
+ * from the cache of the calling lcore when possible.
+ */
+void *
+malloc_heap_alloc_cached(const char *type, size_t size, int socket_arg,
+		size_t align);
+
 int
 malloc_heap_free(struct malloc_elem *elem);
 
+/*
+ * Free a block to the cache of the calling lcore when possible.
+ */
+int
+malloc_heap_free_cached(struct malloc_elem *elem);
+
+/*
+ * Give all the blocks kept in the lcore caches back to their heaps.
+ * The lcores must not allocate nor free memory in the meantime.
+ */
+void
+malloc_heap_cache_flush_all(void);
+
 int
 malloc_heap_resize(struct malloc_elem *elem, size_t size);
 
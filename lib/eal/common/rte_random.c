@@ -6,6 +6,7 @@
 #include <x86intrin.h>
 #endif
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 
 #include <rte_branch_prediction.h>
@@ -15,12 +16,17 @@
 #include <rte_memory.h>
 #include <rte_random.h>
 
+/* Number of xoshiro256++ generators run in parallel for the bulk API */
+#define RAND_LANES 4
+
 struct rte_rand_state {
 	uint64_t z1;
 	uint64_t z2;
 	uint64_t z3;
 	uint64_t z4;
 	uint64_t z5;
+	/* xoshiro256++ states, word-major so that the lanes are vectorized */
+	uint64_t x[4][RAND_LANES] __rte_cache_aligned;
 } __rte_cache_aligned;
 
 static struct rte_rand_state rand_states[RTE_MAX_LCORE];
@@ -76,14 +82,39 @@ __rte_srand_lfsr258(uint64_t seed, struct rte_rand_state *state)
 	state->z5 = __rte_rand_lfsr258_gen_seed(&lcg_seed, 8388608UL);
 }
 
+/* SplitMix64, recommended to seed the xoshiro generators */
+static uint64_t
+__rte_rand_splitmix64(uint64_t *seed)
+{
+	uint64_t z = (*seed += 0x9e3779b97f4a7c15ULL);
+
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+	return z ^ (z >> 31);
+}
+
+static void
+__rte_srand_xoshiro(uint64_t seed, struct rte_rand_state *state)
+{
+	unsigned int i, lane;
+
+	/* the state is never all zeros, as SplitMix64 is a bijection */
+	for (lane = 0; lane < RAND_LANES; lane++)
+		for (i = 0; i < 4; i++)
+			state->x[i][lane] = __rte_rand_splitmix64(&seed);
+}
+
 void
 rte_srand(uint64_t seed)
 {
 	unsigned int lcore_id;
 
 	/* add lcore_id to seed to avoid having the same sequence */
-	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++)
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
 		__rte_srand_lfsr258(seed + lcore_id, &rand_states[lcore_id]);
+		__rte_srand_xoshiro(seed ^ ((uint64_t)lcore_id << 32),
+				&rand_states[lcore_id]);
+	}
 }
 
 static __rte_always_inline uint64_t
@@ -176,6 +207,92 @@ rte_rand_max(uint64_t upper_bound)
 	return res;
 }
 
+static __rte_always_inline uint64_t
+__rte_rand_rotl(uint64_t x, unsigned int k)
+{
+	return (x << k) | (x >> (64 - k));
+}
+
+/* Based on Blackman, D. and Vigna, S.: Scrambled linear pseudorandom
+ * number generators. One xoshiro256++ step of every lane, the loops over
+ * the lanes have no dependency and are turned into SIMD instructions.
+ */
+static __rte_always_inline void
+__rte_rand_xoshiro_lanes(struct rte_rand_state *state, uint64_t *values)
+{
+	uint64_t (*x)[RAND_LANES] = state->x;
+	uint64_t t[RAND_LANES];
+	unsigned int lane;
+
+	for (lane = 0; lane < RAND_LANES; lane++)
+		values[lane] = __rte_rand_rotl(x[0][lane] + x[3][lane], 23) +
+			x[0][lane];
+	for (lane = 0; lane < RAND_LANES; lane++) {
+		t[lane] = x[1][lane] << 17;
+		x[2][lane] ^= x[0][lane];
+		x[3][lane] ^= x[1][lane];
+		x[1][lane] ^= x[2][lane];
+		x[0][lane] ^= x[3][lane];
+		x[2][lane] ^= t[lane];
+		x[3][lane] = __rte_rand_rotl(x[3][lane], 45);
+	}
+}
+
+void
+rte_rand_bulk(uint64_t *values, unsigned int n)
+{
+	struct rte_rand_state *state;
+	uint64_t last[RAND_LANES];
+	unsigned int i;
+
+	state = __rte_rand_get_state();
+
+	for (i = 0; i + RAND_LANES <= n; i += RAND_LANES)
+		__rte_rand_xoshiro_lanes(state, &values[i]);
+	if (i < n) {
+		__rte_rand_xoshiro_lanes(state, last);
+		memcpy(&values[i], last, (n - i) * sizeof(values[0]));
+	}
+}
+
+void
+rte_rand_max_bulk(uint64_t upper_bound, uint64_t *values, unsigned int n)
+{
+	struct rte_rand_state *state;
+	uint64_t lanes[RAND_LANES];
+	uint64_t mask;
+	unsigned int i, lane;
+
+	if (unlikely(upper_bound < 2)) {
+		memset(values, 0, n * sizeof(values[0]));
+		return;
+	}
+
+	/* Same approach as rte_rand_max(), a value beyond the bound is
+	 * discarded, but there is no branch to do it in the vectorized
+	 * generator.
+	 */
+	mask = ~((uint64_t)0) >> __builtin_clzll(upper_bound - 1);
+
+	if ((upper_bound & (upper_bound - 1)) == 0) {
+		rte_rand_bulk(values, n);
+		for (i = 0; i < n; i++)
+			values[i] &= mask;
+		return;
+	}
+
+	state = __rte_rand_get_state();
+
+	i = 0;
+	while (i < n) {
+		__rte_rand_xoshiro_lanes(state, lanes);
+		for (lane = 0; lane < RAND_LANES && i < n; lane++) {
+			values[i] = lanes[lane] & mask;
+			i += values[i] < upper_bound;
+		}
+	}
+}
+
 static uint64_t
 __rte_random_initial_seed(void)
 {
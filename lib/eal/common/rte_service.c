@@ -21,6 +21,7 @@
 #include <rte_memory.h>
 #include <rte_malloc.h>
 #include <rte_spinlock.h>
+#include <rte_lcore_var.h>
 
 #include "eal_private.h"
 
@@ -58,6 +59,13 @@ struct rte_service_spec_impl {
 	uint32_t num_mapped_cores;
 	uint64_t calls;
 	uint64_t cycles_spent;
+	uint64_t idle_calls;
+	uint64_t cycles_max;
+	uint64_t cycles_hist[RTE_SERVICE_CYCLES_HIST_SIZE];
+
+	/* scheduling on service cores */
+	uint32_t weight; /* max calls in a row in a service core loop */
+	uint32_t idle_skip; /* loops to skip after an idle call */
 } __rte_cache_aligned;
 
 /* the internal values of a service core */
@@ -70,16 +78,21 @@ struct core_state {
 	uint8_t service_active_on_lcore[RTE_SERVICE_NUM_MAX];
 	uint64_t loops;
 	uint64_t calls_per_service[RTE_SERVICE_NUM_MAX];
-} __rte_cache_aligned;
+	/* loops left to skip each service, after it reported no work */
+	uint32_t skip_loops[RTE_SERVICE_NUM_MAX];
+};
 
 static uint32_t rte_service_count;
 static struct rte_service_spec_impl *rte_services;
-static struct core_state *lcore_states;
+static RTE_LCORE_VAR_HANDLE(struct core_state, lcore_states);
 static uint32_t rte_service_library_initialized;
 
 int32_t
 rte_service_init(void)
 {
+	unsigned int lcore_id;
+	struct core_state *cs;
+
 	if (rte_service_library_initialized) {
 		RTE_LOG(NOTICE, EAL,
 			"service library init() called, init flag %d\n",
@@ -95,12 +108,12 @@ rte_service_init(void)
 		goto fail_mem;
 	}
 
-	lcore_states = rte_calloc("rte_service_core_states", RTE_MAX_LCORE,
-			sizeof(struct core_state), RTE_CACHE_LINE_SIZE);
-	if (!lcore_states) {
-		RTE_LOG(ERR, EAL, "error allocating core states array\n");
-		goto fail_mem;
-	}
+	/* lcore variables are never freed, reuse them on re-init */
+	if (lcore_states == NULL)
+		RTE_LCORE_VAR_ALLOC(lcore_states);
+	else
+		RTE_LCORE_VAR_FOREACH(lcore_id, cs, lcore_states)
+			memset(cs, 0, sizeof(*cs));
 
 	int i;
 	int count = 0;
@@ -118,7 +131,6 @@ rte_service_init(void)
 	return 0;
 fail_mem:
 	rte_free(rte_services);
-	rte_free(lcore_states);
 	return -ENOMEM;
 }
 
@@ -132,7 +144,6 @@ rte_service_finalize(void)
 	rte_eal_mp_wait_lcore();
 
 	rte_free(rte_services);
-	rte_free(lcore_states);
 
 	rte_service_library_initialized = 0;
 }
@@ -202,6 +213,31 @@ rte_service_set_runstate_mapped_check(uint32_t id, int32_t enabled)
 	return 0;
 }
 
+int32_t
+rte_service_set_weight(uint32_t id, uint32_t weight)
+{
+	struct rte_service_spec_impl *s;
+	SERVICE_VALID_GET_OR_ERR_RET(id, s, -EINVAL);
+
+	if (weight == 0)
+		return -EINVAL;
+
+	__atomic_store_n(&s->weight, weight, __ATOMIC_RELAXED);
+
+	return 0;
+}
+
+int32_t
+rte_service_set_idle_skip(uint32_t id, uint32_t loops)
+{
+	struct rte_service_spec_impl *s;
+	SERVICE_VALID_GET_OR_ERR_RET(id, s, -EINVAL);
+
+	__atomic_store_n(&s->idle_skip, loops, __ATOMIC_RELAXED);
+
+	return 0;
+}
+
 uint32_t
 rte_service_get_count(void)
 {
@@ -265,6 +301,7 @@ rte_service_component_register(const struct rte_service_spec *spec,
 	struct rte_service_spec_impl *s = &rte_services[free_slot];
 	s->spec = *spec;
 	s->internal_flags |= SERVICE_F_REGISTERED | SERVICE_F_START_CHECK;
+	s->weight = 1;
 
 	rte_service_count++;
 
@@ -277,8 +314,9 @@ rte_service_component_register(const struct rte_service_spec *spec,
 int32_t
 rte_service_component_unregister(uint32_t id)
 {
-	uint32_t i;
+	unsigned int lcore_id;
 	struct rte_service_spec_impl *s;
+	struct core_state *cs;
 	SERVICE_VALID_GET_OR_ERR_RET(id, s, -EINVAL);
 
 	rte_service_count--;
@@ -286,8 +324,8 @@ rte_service_component_unregister(uint32_t id)
 	s->internal_flags &= ~(SERVICE_F_REGISTERED);
 
 	/* clear the run-bit in all cores */
-	for (i = 0; i < RTE_MAX_LCORE; i++)
-		lcore_states[i].service_mask &= ~(UINT64_C(1) << id);
+	RTE_LCORE_VAR_FOREACH(lcore_id, cs, lcore_states)
+		cs->service_mask &= ~(UINT64_C(1) << id);
 
 	memset(&rte_services[id], 0, sizeof(struct rte_service_spec_impl));
 
@@ -359,28 +397,67 @@ rte_service_runstate_get(uint32_t id)
 
 }
 
-static inline void
+/* histogram bucket of a call, by power of two of its cycles */
+static inline uint32_t
+service_cycles_bucket(uint64_t cycles)
+{
+	uint32_t msb = rte_fls_u64(cycles);
+
+	if (msb <= RTE_SERVICE_CYCLES_HIST_SHIFT)
+		return 0;
+	return RTE_MIN(msb - RTE_SERVICE_CYCLES_HIST_SHIFT,
+			(uint32_t)RTE_SERVICE_CYCLES_HIST_SIZE - 1);
+}
+
+static inline int32_t
 service_runner_do_callback(struct rte_service_spec_impl *s,
 			   struct core_state *cs, uint32_t service_idx)
 {
 	void *userdata = s->spec.callback_userdata;
+	int32_t ret;
 
 	if (service_stats_enabled(s)) {
 		uint64_t start = rte_rdtsc();
-		s->spec.callback(userdata);
-		uint64_t end = rte_rdtsc();
-		s->cycles_spent += end - start;
+		ret = s->spec.callback(userdata);
+		uint64_t cycles = rte_rdtsc() - start;
+		s->cycles_spent += cycles;
+		if (cycles > s->cycles_max)
+			s->cycles_max = cycles;
+		s->cycles_hist[service_cycles_bucket(cycles)]++;
+		if (ret == -EAGAIN)
+			s->idle_calls++;
 		cs->calls_per_service[service_idx]++;
 		s->calls++;
 	} else
-		s->spec.callback(userdata);
+		ret = s->spec.callback(userdata);
+
+	return ret;
+}
+
+/* Call a service up to weight times, stopping once it reports no work. */
+static inline void
+service_runner_do_callbacks(struct rte_service_spec_impl *s,
+			    struct core_state *cs, uint32_t service_idx,
+			    uint32_t weight)
+{
+	uint32_t n;
+
+	for (n = 0; n < weight; n++) {
+		if (service_runner_do_callback(s, cs, service_idx) ==
+				-EAGAIN) {
+			cs->skip_loops[service_idx] = __atomic_load_n(
+					&s->idle_skip, __ATOMIC_RELAXED);
+			break;
+		}
+	}
 }
 
 
 /* Expects the service 's' is valid. */
 static int32_t
 service_run(uint32_t i, struct core_state *cs, uint64_t service_mask,
-	    struct rte_service_spec_impl *s, uint32_t serialize_mt_unsafe)
+	    struct rte_service_spec_impl *s, uint32_t serialize_mt_unsafe,
+	    uint32_t weight)
 {
 	if (!s)
 		return -EINVAL;
@@ -404,10 +481,10 @@ service_run(uint32_t i, struct core_state *cs, uint64_t service_mask,
 		if (!rte_spinlock_trylock(&s->execute_lock))
 			return -EBUSY;
 
-		service_runner_do_callback(s, cs, i);
+		service_runner_do_callbacks(s, cs, i, weight);
 		rte_spinlock_unlock(&s->execute_lock);
 	} else
-		service_runner_do_callback(s, cs, i);
+		service_runner_do_callbacks(s, cs, i, weight);
 
 	return 0;
 }
@@ -423,7 +500,10 @@ rte_service_may_be_active(uint32_t id)
 		return -EINVAL;
 
 	for (i = 0; i < lcore_count; i++) {
-		if (lcore_states[ids[i]].service_active_on_lcore[id])
+		struct core_state *cs =
+			RTE_LCORE_VAR_LCORE(ids[i], lcore_states);
+
+		if (cs->service_active_on_lcore[id])
 			return 1;
 	}
 
@@ -433,7 +513,7 @@ rte_service_may_be_active(uint32_t id)
 int32_t
 rte_service_run_iter_on_app_lcore(uint32_t id, uint32_t serialize_mt_unsafe)
 {
-	struct core_state *cs = &lcore_states[rte_lcore_id()];
+	struct core_state *cs = RTE_LCORE_VAR(lcore_states);
 	struct rte_service_spec_impl *s;
 
 	SERVICE_VALID_GET_OR_ERR_RET(id, s, -EINVAL);
@@ -443,7 +523,7 @@ rte_service_run_iter_on_app_lcore(uint32_t id, uint32_t serialize_mt_unsafe)
 	 */
 	__atomic_add_fetch(&s->num_mapped_cores, 1, __ATOMIC_RELAXED);
 
-	int ret = service_run(id, cs, UINT64_MAX, s, serialize_mt_unsafe);
+	int ret = service_run(id, cs, UINT64_MAX, s, serialize_mt_unsafe, 1);
 
 	__atomic_sub_fetch(&s->num_mapped_cores, 1, __ATOMIC_RELAXED);
 
@@ -456,7 +536,7 @@ service_runner_func(void *arg)
 	RTE_SET_USED(arg);
 	uint32_t i;
 	const int lcore = rte_lcore_id();
-	struct core_state *cs = &lcore_states[lcore];
+	struct core_state *cs = RTE_LCORE_VAR_LCORE(lcore, lcore_states);
 
 	__atomic_store_n(&cs->thread_active, 1, __ATOMIC_SEQ_CST);
 
@@ -469,10 +549,18 @@ service_runner_func(void *arg)
 		const uint64_t service_mask = cs->service_mask;
 
 		for (i = 0; i < RTE_SERVICE_NUM_MAX; i++) {
+			struct rte_service_spec_impl *s;
+
 			if (!service_valid(i))
 				continue;
+			if (cs->skip_loops[i] != 0) {
+				cs->skip_loops[i]--;
+				continue;
+			}
+			s = service_get(i);
 			/* return value ignored as no change to code flow */
-			service_run(i, cs, service_mask, service_get(i), 1);
+			service_run(i, cs, service_mask, s, 1,
+				__atomic_load_n(&s->weight, __ATOMIC_RELAXED));
 		}
 
 		cs->loops++;
@@ -489,13 +577,19 @@ service_runner_func(void *arg)
 int32_t
 rte_service_lcore_may_be_active(uint32_t lcore)
 {
-	if (lcore >= RTE_MAX_LCORE || !lcore_states[lcore].is_service_core)
+	struct core_state *cs;
+
+	if (lcore >= RTE_MAX_LCORE)
+		return -EINVAL;
+
+	cs = RTE_LCORE_VAR_LCORE(lcore, lcore_states);
+	if (!cs->is_service_core)
 		return -EINVAL;
 
 	/* Load thread_active using ACQUIRE to avoid instructions dependent on
 	 * the result being re-ordered before this load completes.
 	 */
-	return __atomic_load_n(&lcore_states[lcore].thread_active,
+	return __atomic_load_n(&cs->thread_active,
 			       __ATOMIC_ACQUIRE);
 }
 
@@ -503,9 +597,10 @@ int32_t
 rte_service_lcore_count(void)
 {
 	int32_t count = 0;
-	uint32_t i;
-	for (i = 0; i < RTE_MAX_LCORE; i++)
-		count += lcore_states[i].is_service_core;
+	unsigned int lcore_id;
+	struct core_state *cs;
+	RTE_LCORE_VAR_FOREACH(lcore_id, cs, lcore_states)
+		count += cs->is_service_core;
 	return count;
 }
 
@@ -522,7 +617,7 @@ rte_service_lcore_list(uint32_t array[], uint32_t n)
 	uint32_t i;
 	uint32_t idx = 0;
 	for (i = 0; i < RTE_MAX_LCORE; i++) {
-		struct core_state *cs = &lcore_states[i];
+		struct core_state *cs = RTE_LCORE_VAR_LCORE(i, lcore_states);
 		if (cs->is_service_core) {
 			array[idx] = i;
 			idx++;
@@ -538,7 +633,7 @@ rte_service_lcore_count_services(uint32_t lcore)
 	if (lcore >= RTE_MAX_LCORE)
 		return -EINVAL;
 
-	struct core_state *cs = &lcore_states[lcore];
+	struct core_state *cs = RTE_LCORE_VAR_LCORE(lcore, lcore_states);
 	if (!cs->is_service_core)
 		return -ENOTSUP;
 
@@ -590,30 +685,35 @@ rte_service_start_with_defaults(void)
 static int32_t
 service_update(uint32_t sid, uint32_t lcore, uint32_t *set, uint32_t *enabled)
 {
+	struct core_state *cs;
+
 	/* validate ID, or return error value */
 	if (sid >= RTE_SERVICE_NUM_MAX || !service_valid(sid) ||
-	    lcore >= RTE_MAX_LCORE || !lcore_states[lcore].is_service_core)
+	    lcore >= RTE_MAX_LCORE)
+		return -EINVAL;
+
+	cs = RTE_LCORE_VAR_LCORE(lcore, lcore_states);
+	if (!cs->is_service_core)
 		return -EINVAL;
 
 	uint64_t sid_mask = UINT64_C(1) << sid;
 	if (set) {
-		uint64_t lcore_mapped = lcore_states[lcore].service_mask &
-			sid_mask;
+		uint64_t lcore_mapped = cs->service_mask & sid_mask;
 
 		if (*set && !lcore_mapped) {
-			lcore_states[lcore].service_mask |= sid_mask;
+			cs->service_mask |= sid_mask;
 			__atomic_add_fetch(&rte_services[sid].num_mapped_cores,
 				1, __ATOMIC_RELAXED);
 		}
 		if (!*set && lcore_mapped) {
-			lcore_states[lcore].service_mask &= ~(sid_mask);
+			cs->service_mask &= ~(sid_mask);
 			__atomic_sub_fetch(&rte_services[sid].num_mapped_cores,
 				1, __ATOMIC_RELAXED);
 		}
 	}
 
 	if (enabled)
-		*enabled = !!(lcore_states[lcore].service_mask & (sid_mask));
+		*enabled = !!(cs->service_mask & (sid_mask));
 
 	return 0;
 }
@@ -638,6 +738,8 @@ rte_service_map_lcore_get(uint32_t id, uint32_t lcore)
 static void
 set_lcore_state(uint32_t lcore, int32_t state)
 {
+	struct core_state *cs = RTE_LCORE_VAR_LCORE(lcore, lcore_states);
+
 	/* mark core state in hugepage backed config */
 	struct rte_config *cfg = rte_eal_get_configuration();
 	cfg->lcore_role[lcore] = state;
@@ -646,24 +748,26 @@ set_lcore_state(uint32_t lcore, int32_t state)
 	lcore_config[lcore].core_role = state;
 
 	/* update per-lcore optimized state tracking */
-	lcore_states[lcore].is_service_core = (state == ROLE_SERVICE);
+	cs->is_service_core = (state == ROLE_SERVICE);
 }
 
 int32_t
 rte_service_lcore_reset_all(void)
 {
 	/* loop over cores, reset all to mask 0 */
+	unsigned int lcore_id;
+	struct core_state *cs;
 	uint32_t i;
-	for (i = 0; i < RTE_MAX_LCORE; i++) {
-		if (lcore_states[i].is_service_core) {
-			lcore_states[i].service_mask = 0;
-			set_lcore_state(i, ROLE_RTE);
+	RTE_LCORE_VAR_FOREACH(lcore_id, cs, lcore_states) {
+		if (cs->is_service_core) {
+			cs->service_mask = 0;
+			set_lcore_state(lcore_id, ROLE_RTE);
 			/* runstate act as guard variable Use
 			 * store-release memory order here to synchronize
 			 * with load-acquire in runstate read functions.
 			 */
-			__atomic_store_n(&lcore_states[i].runstate,
-				RUNSTATE_STOPPED, __ATOMIC_RELEASE);
+			__atomic_store_n(&cs->runstate, RUNSTATE_STOPPED,
+				__ATOMIC_RELEASE);
 		}
 	}
 	for (i = 0; i < RTE_SERVICE_NUM_MAX; i++)
@@ -676,20 +780,23 @@ rte_service_lcore_reset_all(void)
 int32_t
 rte_service_lcore_add(uint32_t lcore)
 {
+	struct core_state *cs;
+
 	if (lcore >= RTE_MAX_LCORE)
 		return -EINVAL;
-	if (lcore_states[lcore].is_service_core)
+
+	cs = RTE_LCORE_VAR_LCORE(lcore, lcore_states);
+	if (cs->is_service_core)
 		return -EALREADY;
 
 	set_lcore_state(lcore, ROLE_SERVICE);
 
 	/* ensure that after adding a core the mask and state are defaults */
-	lcore_states[lcore].service_mask = 0;
+	cs->service_mask = 0;
 	/* Use store-release memory order here to synchronize with
 	 * load-acquire in runstate read functions.
 	 */
-	__atomic_store_n(&lcore_states[lcore].runstate, RUNSTATE_STOPPED,
-		__ATOMIC_RELEASE);
+	__atomic_store_n(&cs->runstate, RUNSTATE_STOPPED, __ATOMIC_RELEASE);
 
 	return rte_eal_wait_lcore(lcore);
 }
@@ -700,7 +807,7 @@ rte_service_lcore_del(uint32_t lcore)
 	if (lcore >= RTE_MAX_LCORE)
 		return -EINVAL;
 
-	struct core_state *cs = &lcore_states[lcore];
+	struct core_state *cs = RTE_LCORE_VAR_LCORE(lcore, lcore_states);
 	if (!cs->is_service_core)
 		return -EINVAL;
 
@@ -724,7 +831,7 @@ rte_service_lcore_start(uint32_t lcore)
 	if (lcore >= RTE_MAX_LCORE)
 		return -EINVAL;
 
-	struct core_state *cs = &lcore_states[lcore];
+	struct core_state *cs = RTE_LCORE_VAR_LCORE(lcore, lcore_states);
 	if (!cs->is_service_core)
 		return -EINVAL;
 
@@ -752,19 +859,23 @@ rte_service_lcore_start(uint32_t lcore)
 int32_t
 rte_service_lcore_stop(uint32_t lcore)
 {
+	struct core_state *cs;
+
 	if (lcore >= RTE_MAX_LCORE)
 		return -EINVAL;
 
+	cs = RTE_LCORE_VAR_LCORE(lcore, lcore_states);
+
 	/* runstate act as the guard variable. Use load-acquire
 	 * memory order here to synchronize with store-release
 	 * in runstate update functions.
 	 */
-	if (__atomic_load_n(&lcore_states[lcore].runstate, __ATOMIC_ACQUIRE) ==
+	if (__atomic_load_n(&cs->runstate, __ATOMIC_ACQUIRE) ==
 			RUNSTATE_STOPPED)
 		return -EALREADY;
 
 	uint32_t i;
-	uint64_t service_mask = lcore_states[lcore].service_mask;
+	uint64_t service_mask = cs->service_mask;
 	for (i = 0; i < RTE_SERVICE_NUM_MAX; i++) {
 		int32_t enabled = service_mask & (UINT64_C(1) << i);
 		int32_t service_running = rte_service_runstate_get(i);
@@ -783,8 +894,7 @@ rte_service_lcore_stop(uint32_t lcore)
 	/* Use store-release memory order here to synchronize with
 	 * load-acquire in runstate read functions.
 	 */
-	__atomic_store_n(&lcore_states[lcore].runstate, RUNSTATE_STOPPED,
-		__ATOMIC_RELEASE);
+	__atomic_store_n(&cs->runstate, RUNSTATE_STOPPED, __ATOMIC_RELEASE);
 
 	return 0;
 }
@@ -805,7 +915,20 @@ rte_service_attr_get(uint32_t id, uint32_t attr_id, uint64_t *attr_value)
 	case RTE_SERVICE_ATTR_CALL_COUNT:
 		*attr_value = s->calls;
 		return 0;
+	case RTE_SERVICE_ATTR_IDLE_CALL_COUNT:
+		*attr_value = s->idle_calls;
+		return 0;
+	case RTE_SERVICE_ATTR_CYCLES_MAX:
+		*attr_value = s->cycles_max;
+		return 0;
 	default:
+		if (attr_id >= RTE_SERVICE_ATTR_CYCLES_HIST(0) &&
+				attr_id < RTE_SERVICE_ATTR_CYCLES_HIST(
+					RTE_SERVICE_CYCLES_HIST_SIZE)) {
+			*attr_value = s->cycles_hist[attr_id -
+				RTE_SERVICE_ATTR_CYCLES_HIST(0)];
+			return 0;
+		}
 		return -EINVAL;
 	}
 }
@@ -819,7 +942,7 @@ rte_service_lcore_attr_get(uint32_t lcore, uint32_t attr_id,
 	if (lcore >= RTE_MAX_LCORE || !attr_value)
 		return -EINVAL;
 
-	cs = &lcore_states[lcore];
+	cs = RTE_LCORE_VAR_LCORE(lcore, lcore_states);
 	if (!cs->is_service_core)
 		return -ENOTSUP;
 
@@ -840,6 +963,9 @@ rte_service_attr_reset_all(uint32_t id)
 
 	s->cycles_spent = 0;
 	s->calls = 0;
+	s->idle_calls = 0;
+	s->cycles_max = 0;
+	memset(s->cycles_hist, 0, sizeof(s->cycles_hist));
 	return 0;
 }
 
@@ -851,7 +977,7 @@ rte_service_lcore_attr_reset_all(uint32_t lcore)
 	if (lcore >= RTE_MAX_LCORE)
 		return -EINVAL;
 
-	cs = &lcore_states[lcore];
+	cs = RTE_LCORE_VAR_LCORE(lcore, lcore_states);
 	if (!cs->is_service_core)
 		return -ENOTSUP;
 
@@ -868,17 +994,19 @@ service_dump_one(FILE *f, struct rte_service_spec_impl *s)
 
 	if (s->calls != 0)
 		calls = s->calls;
-	fprintf(f, "  %s: stats %d\tcalls %"PRIu64"\tcycles %"
-			PRIu64"\tavg: %"PRIu64"\n",
+	fprintf(f, "  %s: stats %d\tcalls %"PRIu64"\tidle %"PRIu64
+			"\tcycles %"PRIu64"\tavg: %"PRIu64"\tmax: %"PRIu64
+			"\tweight %u\n",
 			s->spec.name, service_stats_enabled(s), s->calls,
-			s->cycles_spent, s->cycles_spent / calls);
+			s->idle_calls, s->cycles_spent, s->cycles_spent / calls,
+			s->cycles_max, s->weight);
 }
 
 static void
 service_dump_calls_per_lcore(FILE *f, uint32_t lcore)
 {
 	uint32_t i;
-	struct core_state *cs = &lcore_states[lcore];
+	struct core_state *cs = RTE_LCORE_VAR_LCORE(lcore, lcore_states);
 
 	fprintf(f, "%02d\t", lcore);
 	for (i = 0; i < RTE_SERVICE_NUM_MAX; i++) {
@@ -50,3 +50,11 @@ eal_cpu_detected(unsigned lcore_id)
 	const unsigned ncpus = eal_get_ncpus();
 	return lcore_id < ncpus;
 }
+
+int
+eal_cpu_domain_id(unsigned int cpu, enum rte_lcore_domain domain)
+{
+	if (domain == RTE_LCORE_DOMAIN_NUMA)
+		return eal_cpu_socket_id(cpu);
+	return -1;
+}
@@ -11,6 +11,8 @@
  * Functions for vectorised implementation of memcpy().
  */
 
+#include <rte_compat.h>
+
 /**
  * Copy 16 bytes from one location to another using optimised
  * instructions. The locations should not overlap.
@@ -113,4 +115,31 @@ rte_memcpy(void *dst, const void *src, size_t n);
 
 #endif /* __DOXYGEN__ */
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Copy bytes from one location to another, bypassing the cache for the
+ * destination of large copies, so that they do not evict the working set
+ * of the caller from the last level cache. It is meant for large copies
+ * whose destination is not read soon by the caller, e.g. packet payloads
+ * copied to another process or to a guest.
+ *
+ * Small copies, and copies on architectures without non-temporal stores,
+ * are done with rte_memcpy().
+ * The locations must not overlap.
+ *
+ * @param dst
+ *   Pointer to the destination of the data.
+ * @param src
+ *   Pointer to the source data.
+ * @param n
+ *   Number of bytes to copy.
+ * @return
+ *   Pointer to the destination data.
+ */
+__rte_experimental
+void *
+rte_memcpy_nt(void *dst, const void *src, size_t n);
+
 #endif /* _RTE_MEMCPY_H_ */
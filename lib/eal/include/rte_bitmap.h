@@ -24,6 +24,11 @@ extern "C" {
  * bits, otherwise the bit in array1 is cleared. The read and write operations
  * for array1 and array2 are always done in slabs of 64 bits.
  *
+ * A third summary level (array0) keeps one bit per array1 slab, set only when
+ * the array1 slab is not empty, so that a sparse bitmap of millions of bits is
+ * searched without reading all the array1 slabs. The array2 cache lines are
+ * read with SIMD instructions when the CPU target supports AVX2 or AVX-512.
+ *
  * This bitmap is not thread safe. For lock free operation on a specific bitmap
  * instance, a single writer thread performing bit set/clear operations is
  * allowed, only the writer thread can do bitmap scan operations, while there
@@ -42,6 +47,9 @@ extern "C" {
 #include <rte_memory.h>
 #include <rte_branch_prediction.h>
 #include <rte_prefetch.h>
+#if defined(RTE_ARCH_X86) && defined(__AVX2__)
+#include <rte_vect.h>
+#endif
 
 /* Slab */
 #define RTE_BITMAP_SLAB_BIT_SIZE                 64
@@ -57,11 +65,16 @@ extern "C" {
 #define RTE_BITMAP_CL_SLAB_SIZE_LOG2             (RTE_BITMAP_CL_BIT_SIZE_LOG2 - RTE_BITMAP_SLAB_BIT_SIZE_LOG2)
 #define RTE_BITMAP_CL_SLAB_MASK                  (RTE_BITMAP_CL_SLAB_SIZE - 1)
 
+/* Bulk set/clear: number of positions prefetched ahead */
+#define RTE_BITMAP_BULK_PREFETCH                 4
+
 /** Bitmap data structure */
 struct rte_bitmap {
-	/* Context for array1 and array2 */
+	/* Context for array0, array1 and array2 */
+	uint64_t *array0;                        /**< Bitmap array0, summary of array1 */
 	uint64_t *array1;                        /**< Bitmap array1 */
 	uint64_t *array2;                        /**< Bitmap array2 */
+	uint32_t array0_size;                    /**< Number of 64-bit slabs in array0 */
 	uint32_t array1_size;                    /**< Number of 64-bit slabs in array1 that are actually used */
 	uint32_t array2_size;                    /**< Number of 64-bit slabs in array2 */
 
@@ -93,22 +106,44 @@ __rte_bitmap_index2_set(struct rte_bitmap *bmp)
 	bmp->index2 = (((bmp->index1 << RTE_BITMAP_SLAB_BIT_SIZE_LOG2) + bmp->offset1) << RTE_BITMAP_CL_SLAB_SIZE_LOG2);
 }
 
+static inline void
+__rte_bitmap_summary_set(struct rte_bitmap *bmp, uint32_t index1)
+{
+	bmp->array0[index1 >> RTE_BITMAP_SLAB_BIT_SIZE_LOG2] |=
+		1llu << (index1 & RTE_BITMAP_SLAB_BIT_MASK);
+}
+
+static inline void
+__rte_bitmap_summary_clear(struct rte_bitmap *bmp, uint32_t index1)
+{
+	bmp->array0[index1 >> RTE_BITMAP_SLAB_BIT_SIZE_LOG2] &=
+		~(1llu << (index1 & RTE_BITMAP_SLAB_BIT_MASK));
+}
+
 static inline uint32_t
 __rte_bitmap_get_memory_footprint(uint32_t n_bits,
+	uint32_t *array0_byte_offset, uint32_t *array0_slabs,
 	uint32_t *array1_byte_offset, uint32_t *array1_slabs,
 	uint32_t *array2_byte_offset, uint32_t *array2_slabs)
 {
-	uint32_t n_slabs_context, n_slabs_array1, n_cache_lines_context_and_array1;
+	uint32_t n_slabs_context, n_slabs_array0, n_slabs_array1, n_cache_lines_context_and_array1;
 	uint32_t n_cache_lines_array2;
 	uint32_t n_bytes_total;
 
 	n_cache_lines_array2 = (n_bits + RTE_BITMAP_CL_BIT_SIZE - 1) / RTE_BITMAP_CL_BIT_SIZE;
 	n_slabs_array1 = (n_cache_lines_array2 + RTE_BITMAP_SLAB_BIT_SIZE - 1) / RTE_BITMAP_SLAB_BIT_SIZE;
 	n_slabs_array1 = rte_align32pow2(n_slabs_array1);
+	n_slabs_array0 = (n_slabs_array1 + RTE_BITMAP_SLAB_BIT_SIZE - 1) / RTE_BITMAP_SLAB_BIT_SIZE;
 	n_slabs_context = (sizeof(struct rte_bitmap) + (RTE_BITMAP_SLAB_BIT_SIZE / 8) - 1) / (RTE_BITMAP_SLAB_BIT_SIZE / 8);
-	n_cache_lines_context_and_array1 = (n_slabs_context + n_slabs_array1 + RTE_BITMAP_CL_SLAB_SIZE - 1) / RTE_BITMAP_CL_SLAB_SIZE;
+	n_cache_lines_context_and_array1 = (n_slabs_context + n_slabs_array1 + n_slabs_array0 + RTE_BITMAP_CL_SLAB_SIZE - 1) / RTE_BITMAP_CL_SLAB_SIZE;
 	n_bytes_total = (n_cache_lines_context_and_array1 + n_cache_lines_array2) * RTE_CACHE_LINE_SIZE;
 
+	if (array0_byte_offset) {
+		*array0_byte_offset = (n_slabs_context + n_slabs_array1) * (RTE_BITMAP_SLAB_BIT_SIZE / 8);
+	}
+	if (array0_slabs) {
+		*array0_slabs = n_slabs_array0;
+	}
 	if (array1_byte_offset) {
 		*array1_byte_offset = n_slabs_context * (RTE_BITMAP_SLAB_BIT_SIZE / 8);
 	}
@@ -151,7 +186,8 @@ rte_bitmap_get_memory_footprint(uint32_t n_bits) {
 		return 0;
 	}
 
-	return __rte_bitmap_get_memory_footprint(n_bits, NULL, NULL, NULL, NULL);
+	return __rte_bitmap_get_memory_footprint(n_bits, NULL, NULL, NULL, NULL,
+		NULL, NULL);
 }
 
 /**
@@ -170,6 +206,7 @@ static inline struct rte_bitmap *
 rte_bitmap_init(uint32_t n_bits, uint8_t *mem, uint32_t mem_size)
 {
 	struct rte_bitmap *bmp;
+	uint32_t array0_byte_offset, array0_slabs;
 	uint32_t array1_byte_offset, array1_slabs, array2_byte_offset, array2_slabs;
 	uint32_t size;
 
@@ -183,6 +220,7 @@ rte_bitmap_init(uint32_t n_bits, uint8_t *mem, uint32_t mem_size)
 	}
 
 	size = __rte_bitmap_get_memory_footprint(n_bits,
+		&array0_byte_offset, &array0_slabs,
 		&array1_byte_offset, &array1_slabs,
 		&array2_byte_offset, &array2_slabs);
 	if (size < mem_size) {
@@ -193,6 +231,8 @@ rte_bitmap_init(uint32_t n_bits, uint8_t *mem, uint32_t mem_size)
 	memset(mem, 0, size);
 	bmp = (struct rte_bitmap *) mem;
 
+	bmp->array0 = (uint64_t *) &mem[array0_byte_offset];
+	bmp->array0_size = array0_slabs;
 	bmp->array1 = (uint64_t *) &mem[array1_byte_offset];
 	bmp->array1_size = array1_slabs;
 	bmp->array2 = (uint64_t *) &mem[array2_byte_offset];
@@ -255,15 +295,17 @@ static inline struct rte_bitmap *
 rte_bitmap_init_with_all_set(uint32_t n_bits, uint8_t *mem, uint32_t mem_size)
 {
 	struct rte_bitmap *bmp;
+	uint32_t array0_byte_offset, array0_slabs;
 	uint32_t array1_byte_offset, array1_slabs;
 	uint32_t array2_byte_offset, array2_slabs;
-	uint32_t size;
+	uint32_t size, i;
 
 	/* Check input arguments */
 	if (!n_bits || !mem || (((uintptr_t) mem) & RTE_CACHE_LINE_MASK))
 		return NULL;
 
 	size = __rte_bitmap_get_memory_footprint(n_bits,
+		&array0_byte_offset, &array0_slabs,
 		&array1_byte_offset, &array1_slabs,
 		&array2_byte_offset, &array2_slabs);
 	if (size < mem_size)
@@ -271,6 +313,8 @@ rte_bitmap_init_with_all_set(uint32_t n_bits, uint8_t *mem, uint32_t mem_size)
 
 	/* Setup bitmap */
 	bmp = (struct rte_bitmap *) mem;
+	bmp->array0 = (uint64_t *) &mem[array0_byte_offset];
+	bmp->array0_size = array0_slabs;
 	bmp->array1 = (uint64_t *) &mem[array1_byte_offset];
 	bmp->array1_size = array1_slabs;
 	bmp->array2 = (uint64_t *) &mem[array2_byte_offset];
@@ -285,6 +329,10 @@ rte_bitmap_init_with_all_set(uint32_t n_bits, uint8_t *mem, uint32_t mem_size)
 			bmp->array2_size >> RTE_BITMAP_CL_SLAB_SIZE_LOG2);
 	__rte_bitmap_clear_slab_overhead_bits(bmp->array2, bmp->array2_size,
 			n_bits);
+	memset(bmp->array0, 0, bmp->array0_size * sizeof(bmp->array0[0]));
+	for (i = 0; i < bmp->array1_size; i++)
+		if (bmp->array1[i])
+			__rte_bitmap_summary_set(bmp, i);
 	return bmp;
 }
 
@@ -316,6 +364,7 @@ rte_bitmap_free(struct rte_bitmap *bmp)
 static inline void
 rte_bitmap_reset(struct rte_bitmap *bmp)
 {
+	memset(bmp->array0, 0, bmp->array0_size * sizeof(uint64_t));
 	memset(bmp->array1, 0, bmp->array1_size * sizeof(uint64_t));
 	memset(bmp->array2, 0, bmp->array2_size * sizeof(uint64_t));
 	__rte_bitmap_scan_init(bmp);
@@ -388,6 +437,7 @@ rte_bitmap_set(struct rte_bitmap *bmp, uint32_t pos)
 
 	*slab2 |= 1llu << offset2;
 	*slab1 |= 1llu << offset1;
+	__rte_bitmap_summary_set(bmp, index1);
 }
 
 /**
@@ -415,6 +465,7 @@ rte_bitmap_set_slab(struct rte_bitmap *bmp, uint32_t pos, uint64_t slab)
 
 	*slab2 |= slab;
 	*slab1 |= 1llu << offset1;
+	__rte_bitmap_summary_set(bmp, index1);
 }
 
 #if RTE_BITMAP_CL_SLAB_SIZE == 8
@@ -457,6 +508,48 @@ __rte_bitmap_line_not_empty(uint64_t *slab2)
 
 #endif /* RTE_BITMAP_CL_SLAB_SIZE */
 
+/* Mask of the non-empty slabs of an array2 cache line */
+#if defined(RTE_ARCH_X86) && defined(__AVX512F__) && RTE_BITMAP_CL_SLAB_SIZE == 8
+static inline uint32_t
+__rte_bitmap_line_mask(uint64_t *slab2)
+{
+	__m512i v = _mm512_load_si512((const void *)slab2);
+
+	return _mm512_test_epi64_mask(v, v);
+}
+
+#elif defined(RTE_ARCH_X86) && defined(__AVX2__) && RTE_BITMAP_CL_SLAB_SIZE == 8
+static inline uint32_t
+__rte_bitmap_line_mask(uint64_t *slab2)
+{
+	__m256i zero = _mm256_setzero_si256();
+	__m256i lo = _mm256_load_si256((const __m256i *)slab2);
+	__m256i hi = _mm256_load_si256((const __m256i *)(slab2 + 4));
+	uint32_t empty;
+
+	empty = _mm256_movemask_pd(_mm256_castsi256_pd(
+			_mm256_cmpeq_epi64(lo, zero)));
+	empty |= _mm256_movemask_pd(_mm256_castsi256_pd(
+			_mm256_cmpeq_epi64(hi, zero))) << 4;
+
+	return ~empty & 0xff;
+}
+
+#else
+static inline uint32_t
+__rte_bitmap_line_mask(uint64_t *slab2)
+{
+	uint32_t mask = 0;
+	uint32_t i;
+
+	for (i = 0; i < RTE_BITMAP_CL_SLAB_SIZE; i++)
+		mask |= (uint32_t)(slab2[i] != 0) << i;
+
+	return mask;
+}
+
+#endif
+
 /**
  * Bitmap bit clear
  *
@@ -494,15 +587,83 @@ rte_bitmap_clear(struct rte_bitmap *bmp, uint32_t pos)
 	offset1 = (pos >> RTE_BITMAP_CL_BIT_SIZE_LOG2) & RTE_BITMAP_SLAB_BIT_MASK;
 	slab1 = bmp->array1 + index1;
 	*slab1 &= ~(1llu << offset1);
+	if (*slab1 == 0)
+		__rte_bitmap_summary_clear(bmp, index1);
 
 	return;
 }
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Bitmap bulk bit set
+ *
+ * The bitmap locations of the next positions are prefetched while the
+ * current ones are set, which hides the cache misses of a large bitmap.
+ *
+ * @param bmp
+ *   Handle to bitmap instance
+ * @param pos
+ *   Array of bit positions
+ * @param n
+ *   Number of bit positions in the array
+ */
+__rte_experimental
+static inline void
+rte_bitmap_set_bulk(struct rte_bitmap *bmp, const uint32_t *pos, uint32_t n)
+{
+	uint32_t i;
+
+	for (i = 0; i < RTE_MIN(n, (uint32_t)RTE_BITMAP_BULK_PREFETCH); i++)
+		rte_bitmap_prefetch0(bmp, pos[i]);
+
+	for (i = 0; i < n; i++) {
+		if (i + RTE_BITMAP_BULK_PREFETCH < n)
+			rte_bitmap_prefetch0(bmp,
+				pos[i + RTE_BITMAP_BULK_PREFETCH]);
+		rte_bitmap_set(bmp, pos[i]);
+	}
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Bitmap bulk bit clear
+ *
+ * The bitmap locations of the next positions are prefetched while the
+ * current ones are cleared, which hides the cache misses of a large bitmap.
+ *
+ * @param bmp
+ *   Handle to bitmap instance
+ * @param pos
+ *   Array of bit positions
+ * @param n
+ *   Number of bit positions in the array
+ */
+__rte_experimental
+static inline void
+rte_bitmap_clear_bulk(struct rte_bitmap *bmp, const uint32_t *pos, uint32_t n)
+{
+	uint32_t i;
+
+	for (i = 0; i < RTE_MIN(n, (uint32_t)RTE_BITMAP_BULK_PREFETCH); i++)
+		rte_bitmap_prefetch0(bmp, pos[i]);
+
+	for (i = 0; i < n; i++) {
+		if (i + RTE_BITMAP_BULK_PREFETCH < n)
+			rte_bitmap_prefetch0(bmp,
+				pos[i + RTE_BITMAP_BULK_PREFETCH]);
+		rte_bitmap_clear(bmp, pos[i]);
+	}
+}
+
 static inline int
 __rte_bitmap_scan_search(struct rte_bitmap *bmp)
 {
-	uint64_t value1;
-	uint32_t i;
+	uint64_t value0, value1;
+	uint32_t index0, i;
 
 	/* Check current array1 slab */
 	value1 = bmp->array1[bmp->index1];
@@ -514,12 +675,21 @@ __rte_bitmap_scan_search(struct rte_bitmap *bmp)
 	__rte_bitmap_index1_inc(bmp);
 	bmp->offset1 = 0;
 
-	/* Look for another array1 slab */
-	for (i = 0; i < bmp->array1_size; i ++, __rte_bitmap_index1_inc(bmp)) {
-		value1 = bmp->array1[bmp->index1];
-
-		if (rte_bsf64_safe(value1, &bmp->offset1))
-			return 1;
+	/* Look for another array1 slab in array0, the array0 slab of the
+	 * current array1 slab is read again at the end of the wrap-around.
+	 */
+	index0 = bmp->index1 >> RTE_BITMAP_SLAB_BIT_SIZE_LOG2;
+	value0 = bmp->array0[index0] &
+		(~0llu << (bmp->index1 & RTE_BITMAP_SLAB_BIT_MASK));
+	for (i = 0; i <= bmp->array0_size; i++) {
+		if (value0) {
+			bmp->index1 = (index0 << RTE_BITMAP_SLAB_BIT_SIZE_LOG2) +
+				rte_bsf64(value0);
+			value1 = bmp->array1[bmp->index1];
+			return rte_bsf64_safe(value1, &bmp->offset1);
+		}
+		index0 = (index0 + 1) & (bmp->array0_size - 1);
+		value0 = bmp->array0[index0];
 	}
 
 	return 0;
@@ -536,22 +706,28 @@ __rte_bitmap_scan_read_init(struct rte_bitmap *bmp)
 static inline int
 __rte_bitmap_scan_read(struct rte_bitmap *bmp, uint32_t *pos, uint64_t *slab)
 {
-	uint64_t *slab2;
+	uint32_t offset2, mask;
 
-	slab2 = bmp->array2 + bmp->index2;
-	for ( ; bmp->go2 ; bmp->index2 ++, slab2 ++, bmp->go2 = bmp->index2 & RTE_BITMAP_CL_SLAB_MASK) {
-		if (*slab2) {
-			*pos = bmp->index2 << RTE_BITMAP_SLAB_BIT_SIZE_LOG2;
-			*slab = *slab2;
+	if (!bmp->go2)
+		return 0;
 
-			bmp->index2 ++;
-			slab2 ++;
-			bmp->go2 = bmp->index2 & RTE_BITMAP_CL_SLAB_MASK;
-			return 1;
-		}
+	/* Non-empty slabs left in the current array2 line */
+	offset2 = bmp->index2 & RTE_BITMAP_CL_SLAB_MASK;
+	mask = __rte_bitmap_line_mask(bmp->array2 + bmp->index2 - offset2) >>
+		offset2;
+	if (mask == 0) {
+		bmp->index2 += RTE_BITMAP_CL_SLAB_SIZE - offset2;
+		bmp->go2 = 0;
+		return 0;
 	}
 
-	return 0;
+	bmp->index2 += rte_bsf32(mask);
+	*pos = bmp->index2 << RTE_BITMAP_SLAB_BIT_SIZE_LOG2;
+	*slab = bmp->array2[bmp->index2];
+
+	bmp->index2 ++;
+	bmp->go2 = bmp->index2 & RTE_BITMAP_CL_SLAB_MASK;
+	return 1;
 }
 
 /**
@@ -593,6 +769,45 @@ rte_bitmap_scan(struct rte_bitmap *bmp, uint32_t *pos, uint64_t *slab)
 	return 0;
 }
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Bitmap bulk scan (with automatic wrap-around)
+ *
+ * Return the next non-empty slabs of the bitmap, as successive calls to
+ * rte_bitmap_scan() would do, but a slab is returned only once per call:
+ * the scan stops early when it wraps around to the first slab returned.
+ *
+ * @param bmp
+ *   Handle to bitmap instance
+ * @param pos
+ *   Array of at least n elements, filled with the position of the first bit
+ *   of the returned slabs
+ * @param slabs
+ *   Array of at least n elements, filled with the value of the returned slabs
+ * @param n
+ *   Max number of slabs to return
+ * @return
+ *   Number of slabs returned, 0 if there is no bit set in the bitmap
+ */
+__rte_experimental
+static inline uint32_t
+rte_bitmap_scan_bulk(struct rte_bitmap *bmp, uint32_t *pos, uint64_t *slabs,
+	uint32_t n)
+{
+	uint32_t i;
+
+	for (i = 0; i < n; i++) {
+		if (!rte_bitmap_scan(bmp, &pos[i], &slabs[i]))
+			break;
+		if (i > 0 && pos[i] == pos[0])
+			break;
+	}
+
+	return i;
+}
+
 #ifdef __cplusplus
 }
 #endif
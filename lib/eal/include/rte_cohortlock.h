@@ -0,0 +1,458 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#ifndef _RTE_COHORTLOCK_H_
+#define _RTE_COHORTLOCK_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file
+ * RTE NUMA-aware cohort locks
+ *
+ * A cohort lock (proposed by Dave Dice, Virendra J. Marathe and Nir Shavit)
+ * is made of a global ticket lock and of one MCS lock per NUMA node.
+ * A thread first takes the MCS lock of its node, then the global lock.
+ * On release, the lock is passed with the global lock still held to the
+ * next waiter of the same node, if any, so that the lock and the data it
+ * protects stay in the caches of one node for a batch of critical sections,
+ * instead of bouncing between the nodes on each of them. The batch is
+ * bounded by RTE_COHORTLOCK_BATCH_MAX to keep the lock fair between nodes.
+ *
+ * The NUMA-aware reader-writer lock serializes the writers with a cohort
+ * lock, and counts the readers per NUMA node, so that the readers of a node
+ * only write to a cache line of that node. The writers have priority: while
+ * a writer waits for the readers to release the lock, no reader can take it.
+ * A read lock must be released by the thread which took it.
+ *
+ * As with the MCS lock, the threads taking a cohort lock, or the write side
+ * of a NUMA-aware reader-writer lock, pass their own node, which must stay
+ * valid until the lock is released. These locks are meant for the locks of
+ * a process under heavy contention from several NUMA nodes. Each of them
+ * takes a few kilobytes, and their uncontended path is a little slower
+ * than the one of rte_spinlock_t.
+ *
+ * The non-EAL threads are accounted to the first NUMA node.
+ *
+ * @see rte_mcslock.h
+ * @see rte_ticketlock.h
+ */
+
+#include <stdint.h>
+
+#include <rte_atomic.h>
+#include <rte_branch_prediction.h>
+#include <rte_common.h>
+#include <rte_compat.h>
+#include <rte_lcore.h>
+#include <rte_mcslock.h>
+#include <rte_pause.h>
+#include <rte_ticketlock.h>
+
+/**
+ * Maximum number of consecutive critical sections of a NUMA node while
+ * other nodes wait for the lock.
+ */
+#define RTE_COHORTLOCK_BATCH_MAX 64
+
+/**
+ * Node of a thread taking a cohort lock.
+ */
+typedef struct rte_cohortlock_node {
+	rte_mcslock_t mcs; /**< Node of the MCS lock of the NUMA node. */
+	unsigned int socket_id; /**< NUMA node of the lock owner. */
+} rte_cohortlock_node_t;
+
+/**
+ * @internal MCS lock of a NUMA node.
+ */
+struct rte_cohortlock_local {
+	rte_mcslock_t *msl; /**< MCS lock of the NUMA node. */
+	uint32_t global_held; /**< Global lock passed with the local one. */
+	uint32_t batch; /**< Consecutive local handoffs. */
+} __rte_cache_aligned;
+
+/**
+ * The rte_cohortlock_t type.
+ */
+typedef struct {
+	rte_ticketlock_t global; /**< Lock taken by one NUMA node at a time. */
+	struct rte_cohortlock_local local[RTE_MAX_NUMA_NODES];
+} rte_cohortlock_t;
+
+/**
+ * A static cohort lock initializer.
+ */
+#define RTE_COHORTLOCK_INITIALIZER { .global = RTE_TICKETLOCK_INITIALIZER }
+
+/**
+ * @internal NUMA node of the calling thread.
+ */
+static inline unsigned int
+__rte_cohortlock_socket_id(void)
+{
+	unsigned int socket_id = rte_socket_id();
+
+	return socket_id < RTE_MAX_NUMA_NODES ? socket_id : 0;
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Initialize the cohort lock to an unlocked state.
+ *
+ * @param cl
+ *   A pointer to the cohort lock.
+ */
+__rte_experimental
+static inline void
+rte_cohortlock_init(rte_cohortlock_t *cl)
+{
+	unsigned int i;
+
+	rte_ticketlock_init(&cl->global);
+	for (i = 0; i < RTE_MAX_NUMA_NODES; i++) {
+		cl->local[i].msl = NULL;
+		cl->local[i].global_held = 0;
+		cl->local[i].batch = 0;
+	}
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Take the cohort lock.
+ *
+ * @param cl
+ *   A pointer to the cohort lock.
+ * @param me
+ *   A pointer to the node of the calling thread, which must stay valid
+ *   until the lock is released.
+ */
+__rte_experimental
+static inline void
+rte_cohortlock_lock(rte_cohortlock_t *cl, rte_cohortlock_node_t *me)
+{
+	struct rte_cohortlock_local *local;
+
+	me->socket_id = __rte_cohortlock_socket_id();
+	local = &cl->local[me->socket_id];
+
+	rte_mcslock_lock(&local->msl, &me->mcs);
+
+	/* The local fields are only accessed with the local lock held. */
+	if (local->global_held)
+		return;
+
+	rte_ticketlock_lock(&cl->global);
+	local->batch = 0;
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Try to take the cohort lock.
+ *
+ * @param cl
+ *   A pointer to the cohort lock.
+ * @param me
+ *   A pointer to the node of the calling thread, which must stay valid
+ *   until the lock is released.
+ * @return
+ *   1 if the lock is successfully taken; 0 otherwise.
+ */
+__rte_experimental
+static inline int
+rte_cohortlock_trylock(rte_cohortlock_t *cl, rte_cohortlock_node_t *me)
+{
+	struct rte_cohortlock_local *local;
+
+	me->socket_id = __rte_cohortlock_socket_id();
+	local = &cl->local[me->socket_id];
+
+	/* With no local waiter, the global lock is never passed along. */
+	if (rte_mcslock_trylock(&local->msl, &me->mcs) == 0)
+		return 0;
+
+	if (rte_ticketlock_trylock(&cl->global) == 0) {
+		rte_mcslock_unlock(&local->msl, &me->mcs);
+		return 0;
+	}
+	local->batch = 0;
+
+	return 1;
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Release the cohort lock.
+ *
+ * The lock is passed to the next waiter of the NUMA node of the calling
+ * thread, unless none is waiting or the batch of the node is over.
+ *
+ * @param cl
+ *   A pointer to the cohort lock.
+ * @param me
+ *   A pointer to the node passed to rte_cohortlock_lock().
+ */
+__rte_experimental
+static inline void
+rte_cohortlock_unlock(rte_cohortlock_t *cl, rte_cohortlock_node_t *me)
+{
+	struct rte_cohortlock_local *local = &cl->local[me->socket_id];
+
+	/* A queued waiter always gets the MCS lock, and the global one
+	 * with it, the release of the MCS lock orders the global_held store.
+	 */
+	if (__atomic_load_n(&me->mcs.next, __ATOMIC_RELAXED) != NULL &&
+			local->batch < RTE_COHORTLOCK_BATCH_MAX) {
+		local->batch++;
+		local->global_held = 1;
+		rte_mcslock_unlock(&local->msl, &me->mcs);
+		return;
+	}
+
+	local->global_held = 0;
+	rte_ticketlock_unlock(&cl->global);
+	rte_mcslock_unlock(&local->msl, &me->mcs);
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Test if the cohort lock is taken.
+ *
+ * @param cl
+ *   A pointer to the cohort lock.
+ * @return
+ *   1 if the lock is currently taken; 0 otherwise.
+ */
+__rte_experimental
+static inline int
+rte_cohortlock_is_locked(rte_cohortlock_t *cl)
+{
+	return rte_ticketlock_is_locked(&cl->global);
+}
+
+/**
+ * @internal Readers of a NUMA node.
+ */
+struct rte_cohort_rwlock_readers {
+	uint32_t count; /**< Readers holding or trying to take the lock. */
+} __rte_cache_aligned;
+
+/**
+ * The rte_cohort_rwlock_t type.
+ */
+typedef struct {
+	rte_cohortlock_t wlock; /**< Lock serializing the writers. */
+	/** Set while a writer holds or waits for the lock. */
+	uint32_t writer __rte_cache_aligned;
+	struct rte_cohort_rwlock_readers readers[RTE_MAX_NUMA_NODES];
+} rte_cohort_rwlock_t;
+
+/**
+ * A static NUMA-aware reader-writer lock initializer.
+ */
+#define RTE_COHORT_RWLOCK_INITIALIZER { .wlock = RTE_COHORTLOCK_INITIALIZER }
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Initialize the NUMA-aware reader-writer lock to an unlocked state.
+ *
+ * @param rwl
+ *   A pointer to the reader-writer lock.
+ */
+__rte_experimental
+static inline void
+rte_cohort_rwlock_init(rte_cohort_rwlock_t *rwl)
+{
+	unsigned int i;
+
+	rte_cohortlock_init(&rwl->wlock);
+	rwl->writer = 0;
+	for (i = 0; i < RTE_MAX_NUMA_NODES; i++)
+		rwl->readers[i].count = 0;
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Try to take a read lock.
+ *
+ * @param rwl
+ *   A pointer to the reader-writer lock.
+ * @return
+ *   1 if the lock is successfully taken; 0 if a writer holds or waits
+ *   for the lock.
+ */
+__rte_experimental
+static inline int
+rte_cohort_rwlock_read_trylock(rte_cohort_rwlock_t *rwl)
+{
+	uint32_t *count =
+		&rwl->readers[__rte_cohortlock_socket_id()].count;
+
+	if (__atomic_load_n(&rwl->writer, __ATOMIC_RELAXED) != 0)
+		return 0;
+
+	/* The writers set their flag before checking the readers count,
+	 * the readers increment their count before checking the flag.
+	 */
+	__atomic_fetch_add(count, 1, __ATOMIC_RELAXED);
+	rte_atomic_thread_fence(__ATOMIC_SEQ_CST);
+	if (likely(__atomic_load_n(&rwl->writer, __ATOMIC_ACQUIRE) == 0))
+		return 1;
+
+	__atomic_fetch_sub(count, 1, __ATOMIC_RELAXED);
+	return 0;
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Take a read lock. Loop until the lock is held.
+ *
+ * @param rwl
+ *   A pointer to the reader-writer lock.
+ */
+__rte_experimental
+static inline void
+rte_cohort_rwlock_read_lock(rte_cohort_rwlock_t *rwl)
+{
+	while (rte_cohort_rwlock_read_trylock(rwl) == 0) {
+		while (__atomic_load_n(&rwl->writer, __ATOMIC_RELAXED) != 0)
+			rte_pause();
+	}
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Release a read lock.
+ *
+ * @param rwl
+ *   A pointer to the reader-writer lock.
+ */
+__rte_experimental
+static inline void
+rte_cohort_rwlock_read_unlock(rte_cohort_rwlock_t *rwl)
+{
+	__atomic_fetch_sub(&rwl->readers[__rte_cohortlock_socket_id()].count,
+		1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @internal Check that no reader holds the lock, while the writer flag
+ * is set.
+ */
+static inline int
+__rte_cohort_rwlock_no_reader(rte_cohort_rwlock_t *rwl)
+{
+	unsigned int i;
+
+	for (i = 0; i < RTE_MAX_NUMA_NODES; i++) {
+		if (__atomic_load_n(&rwl->readers[i].count,
+				__ATOMIC_ACQUIRE) != 0)
+			return 0;
+	}
+
+	return 1;
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Take a write lock. Loop until the lock is held.
+ *
+ * @param rwl
+ *   A pointer to the reader-writer lock.
+ * @param me
+ *   A pointer to the node of the calling thread, which must stay valid
+ *   until the lock is released.
+ */
+__rte_experimental
+static inline void
+rte_cohort_rwlock_write_lock(rte_cohort_rwlock_t *rwl,
+	rte_cohortlock_node_t *me)
+{
+	rte_cohortlock_lock(&rwl->wlock, me);
+
+	__atomic_store_n(&rwl->writer, 1, __ATOMIC_RELAXED);
+	rte_atomic_thread_fence(__ATOMIC_SEQ_CST);
+	while (__rte_cohort_rwlock_no_reader(rwl) == 0)
+		rte_pause();
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Try to take a write lock.
+ *
+ * @param rwl
+ *   A pointer to the reader-writer lock.
+ * @param me
+ *   A pointer to the node of the calling thread, which must stay valid
+ *   until the lock is released.
+ * @return
+ *   1 if the lock is successfully taken; 0 otherwise.
+ */
+__rte_experimental
+static inline int
+rte_cohort_rwlock_write_trylock(rte_cohort_rwlock_t *rwl,
+	rte_cohortlock_node_t *me)
+{
+	if (rte_cohortlock_trylock(&rwl->wlock, me) == 0)
+		return 0;
+
+	__atomic_store_n(&rwl->writer, 1, __ATOMIC_RELAXED);
+	rte_atomic_thread_fence(__ATOMIC_SEQ_CST);
+	if (likely(__rte_cohort_rwlock_no_reader(rwl)))
+		return 1;
+
+	__atomic_store_n(&rwl->writer, 0, __ATOMIC_RELAXED);
+	rte_cohortlock_unlock(&rwl->wlock, me);
+	return 0;
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Release a write lock.
+ *
+ * @param rwl
+ *   A pointer to the reader-writer lock.
+ * @param me
+ *   A pointer to the node passed to rte_cohort_rwlock_write_lock().
+ */
+__rte_experimental
+static inline void
+rte_cohort_rwlock_write_unlock(rte_cohort_rwlock_t *rwl,
+	rte_cohortlock_node_t *me)
+{
+	__atomic_store_n(&rwl->writer, 0, __ATOMIC_RELEASE);
+	rte_cohortlock_unlock(&rwl->wlock, me);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_COHORTLOCK_H_ */
@@ -370,6 +370,37 @@ __rte_experimental
 int
 rte_mp_reply(struct rte_mp_msg *msg, const char *peer);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Send the synchronous requests of an action to the primary process over
+ * shared memory rather than over the socket.
+ *
+ * The first call attaches a shared memory channel to the primary process.
+ * Requests of the enabled actions are then posted in the channel, and the
+ * requesting thread is woken up directly by the primary process, without
+ * going through the IPC thread of the secondary process. It is meant for
+ * frequent small requests, such as statistics queries.
+ *
+ * The channel holds a single request: requests sent while it is in use by
+ * another thread, and requests passing file descriptors, still go over the
+ * socket. The primary process cannot pass file descriptors in the replies:
+ * such a request fails with ENOTSUP.
+ *
+ * @note This function may only be called in a secondary process.
+ *
+ * @param name
+ *   The name of the action, as registered in the primary process.
+ *
+ * @return
+ *  - On success, return 0.
+ *  - On failure, return -1, and the reason will be stored in rte_errno.
+ */
+__rte_experimental
+int
+rte_mp_shm_request_enable(const char *name);
+
 /**
  * Usage function typedef used by the application usage function.
  *
@@ -420,6 +451,17 @@ int rte_eal_has_hugepages(void);
  */
 int rte_eal_has_pci(void);
 
+/**
+ * @internal
+ * Number of threads a bus may use to probe its devices at init.
+ * Set by --probe-threads option.
+ *
+ * @return
+ *   The number of threads, 1 when the devices are probed sequentially.
+ */
+__rte_internal
+unsigned int rte_eal_probe_threads(void);
+
 /**
  * Whether the EAL was asked to create UIO device.
  *
@@ -204,6 +204,63 @@ rte_lcore_cpuset(unsigned int lcore_id);
 
 #endif /* RTE_HAS_CPUSET */
 
+/**
+ * Topology domains, grouping the CPUs which share a hardware resource.
+ * They are ordered from the usually smallest to the largest one, though
+ * the actual nesting depends on the processor.
+ */
+enum rte_lcore_domain {
+	RTE_LCORE_DOMAIN_CORE,    /**< Physical core, shared by SMT threads. */
+	RTE_LCORE_DOMAIN_L2,      /**< Level 2 cache. */
+	RTE_LCORE_DOMAIN_CLUSTER, /**< Cluster of cores, as on Arm. */
+	RTE_LCORE_DOMAIN_L3,      /**< Level 3 cache, as an AMD CCX. */
+	RTE_LCORE_DOMAIN_NUMA,    /**< NUMA node. */
+	RTE_LCORE_DOMAIN_MAX      /**< Number of domains. */
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Get the topology domain of an lcore.
+ *
+ * The lcores running on CPUs of the same domain share its resource, for
+ * instance the lcores with a same L3 domain id share a L3 cache. The ids
+ * are comparable within a domain type only.
+ *
+ * @param lcore_id
+ *   The targeted lcore, which MUST be between 0 and RTE_MAX_LCORE-1.
+ * @param domain
+ *   The domain type.
+ * @return
+ *   The domain id, or -1 with rte_errno set:
+ *   - EINVAL: invalid parameter.
+ *   - ENOENT: the domain is unknown, or the CPU set of the lcore spans
+ *     several domains.
+ */
+__rte_experimental
+int
+rte_lcore_domain_id(unsigned int lcore_id, enum rte_lcore_domain domain);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Get the smallest topology domain shared by two lcores, for instance to
+ * place a producer and its consumer close to each other.
+ *
+ * @param lcore_a
+ *   An lcore, which MUST be between 0 and RTE_MAX_LCORE-1.
+ * @param lcore_b
+ *   Another lcore, which MUST be between 0 and RTE_MAX_LCORE-1.
+ * @return
+ *   The first domain type in the enum order in which the two lcores have
+ *   the same id, or RTE_LCORE_DOMAIN_MAX if none is known.
+ */
+__rte_experimental
+enum rte_lcore_domain
+rte_lcore_shared_domain(unsigned int lcore_a, unsigned int lcore_b);
+
 /**
  * Test if an lcore is enabled.
  *
@@ -362,6 +419,91 @@ __rte_experimental
 void
 rte_lcore_dump(FILE *f);
 
+/**
+ * Usage of an lcore, in TSC cycles.
+ */
+struct rte_lcore_usage {
+	uint64_t total_cycles;
+	/**< Cycles accounted since the lcore started reporting its usage. */
+	uint64_t busy_cycles;
+	/**< Part of total_cycles spent doing useful work. */
+};
+
+/**
+ * Callback to get the usage of an lcore, for applications accounting it
+ * on their own.
+ *
+ * @param lcore_id
+ *   The lcore to consider.
+ * @param usage
+ *   Usage to fill, the counters must only increase.
+ * @return
+ *   - 0 if the usage of the lcore was filled.
+ *   - <0 if the usage of the lcore is not known.
+ */
+typedef int (*rte_lcore_usage_cb)(unsigned int lcore_id,
+	struct rte_lcore_usage *usage);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Register a callback reporting the usage of the lcores, which replaces
+ * the usage accounted with rte_lcore_usage_poll().
+ *
+ * @param cb
+ *   Callback, or NULL to use the usage accounted by EAL again.
+ */
+__rte_experimental
+void
+rte_lcore_register_usage_cb(rte_lcore_usage_cb cb);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Account the usage of the calling lcore, from a polling loop.
+ *
+ * Each call closes the interval since the previous call of the lcore, which
+ * is accounted as busy if the previous poll found some work, and as idle
+ * otherwise: so the work found by a poll is expected to be processed before
+ * the next poll. The first call of an lcore only starts the accounting.
+ *
+ * The cost of a call is about one TSC read. Calls from unregistered non-EAL
+ * threads are ignored.
+ *
+ * @param nb_work
+ *   Amount of work found by the poll, e.g. the number of packets received,
+ *   0 when the poll was idle.
+ */
+__rte_experimental
+void
+rte_lcore_usage_poll(unsigned int nb_work);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Get the usage of an lcore, from the callback registered with
+ * rte_lcore_register_usage_cb() if any, or as accounted by
+ * rte_lcore_usage_poll().
+ *
+ * The usage is also available from the "/eal/lcore/usage" and
+ * "/eal/lcore/info" telemetry commands.
+ *
+ * @param lcore_id
+ *   The lcore to consider.
+ * @param usage
+ *   Usage to fill.
+ * @return
+ *   - 0 on success.
+ *   - -EINVAL if the lcore is not active.
+ *   - -ENOTSUP if the usage of the lcore is not known.
+ */
+__rte_experimental
+int
+rte_lcore_usage_get(unsigned int lcore_id, struct rte_lcore_usage *usage);
+
 /**
  * Set thread names.
  *
@@ -0,0 +1,266 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#ifndef _RTE_LCORE_VAR_H_
+#define _RTE_LCORE_VAR_H_
+
+/**
+ * @file
+ *
+ * Lcore variables
+ *
+ * This API provides a mechanism to create and access per-lcore id
+ * variables in a space- and cycle-efficient manner.
+ *
+ * An lcore variable is a set of RTE_MAX_LCORE values of the same type,
+ * one per lcore id. All the lcore variables of the process share a
+ * number of buffers, and each buffer is divided in RTE_MAX_LCORE
+ * regions of RTE_MAX_LCORE_VAR bytes, one per lcore id. So the values
+ * of unrelated modules which belong to the same lcore id are packed
+ * together, instead of each module keeping an RTE_MAX_LCORE sized
+ * array of cache aligned structures of its own. This saves memory and
+ * cache lines, and keeps the TLB footprint of the data used by one
+ * lcore small.
+ *
+ * An lcore variable is declared through a handle, which is a pointer
+ * to the variable's type, and allocated with RTE_LCORE_VAR_ALLOC() or
+ * one of its siblings. The handle points to the value of lcore id 0;
+ * the value of a given lcore id is found at a constant offset from it,
+ * so accessing it takes no more than an addition.
+ *
+ * @code{.c}
+ * struct foo_lcore_state {
+ *         int a;
+ *         long b;
+ * };
+ *
+ * static RTE_LCORE_VAR_HANDLE(struct foo_lcore_state, lcore_states);
+ *
+ * long foo_get_a_plus_b(void)
+ * {
+ *         const struct foo_lcore_state *state = RTE_LCORE_VAR(lcore_states);
+ *
+ *         return state->a + state->b;
+ * }
+ *
+ * RTE_INIT(rte_foo_init)
+ * {
+ *         RTE_LCORE_VAR_ALLOC(lcore_states);
+ *
+ *         unsigned int lcore_id;
+ *         struct foo_lcore_state *state;
+ *         RTE_LCORE_VAR_FOREACH(lcore_id, state, lcore_states) {
+ *                 (initialize 'state')
+ *         }
+ *
+ *         (other initialization)
+ * }
+ * @endcode
+ *
+ * An lcore variable is zeroed when allocated, and is never freed.
+ * It may be allocated from a constructor, i.e. before the EAL is
+ * initialized. The allocation is not multi-thread safe.
+ *
+ * Values of different lcore ids are not cache line aligned relative to
+ * each other by default, only their placement in different per-lcore
+ * regions keeps them apart. Since each lcore id only accesses its own
+ * region on the fast path, there is no false sharing between lcores,
+ * and the structures kept in lcore variables do not need any padding.
+ *
+ * The value of a variable may also be accessed by other lcores than
+ * its owner, e.g. in the control path, as long as the application
+ * takes care of the synchronization.
+ */
+
+#include <stddef.h>
+
+#include <rte_common.h>
+#include <rte_config.h>
+#include <rte_lcore.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Given the lcore variable type, produces the type of the lcore
+ * variable handle.
+ */
+#define RTE_LCORE_VAR_HANDLE_TYPE(type) \
+	type *
+
+/**
+ * Define an lcore variable handle.
+ *
+ * This macro defines a variable which is used as a handle to access
+ * the various instances of a per-lcore id variable.
+ *
+ * This macro clarifies that the declaration is an lcore handle, not a
+ * regular pointer.
+ *
+ * Add @b static as a prefix in case the lcore variable is only to be
+ * accessed from a particular translation unit.
+ */
+#define RTE_LCORE_VAR_HANDLE(type, name) \
+	RTE_LCORE_VAR_HANDLE_TYPE(type) name
+
+/**
+ * Allocate space for an lcore variable, and initialize its handle.
+ *
+ * The values of the lcore variable are initialized to zero.
+ */
+#define RTE_LCORE_VAR_ALLOC_SIZE_ALIGN(handle, size, align) \
+	handle = rte_lcore_var_alloc(size, align)
+
+/**
+ * Allocate space for an lcore variable, and initialize its handle,
+ * with values aligned for any type of object.
+ *
+ * The values of the lcore variable are initialized to zero.
+ */
+#define RTE_LCORE_VAR_ALLOC_SIZE(handle, size) \
+	RTE_LCORE_VAR_ALLOC_SIZE_ALIGN(handle, size, 0)
+
+/**
+ * Allocate space for an lcore variable of the size and alignment
+ * requirements suggested by the handle pointer type, and initialize
+ * its handle.
+ *
+ * The values of the lcore variable are initialized to zero.
+ */
+#define RTE_LCORE_VAR_ALLOC(handle) \
+	RTE_LCORE_VAR_ALLOC_SIZE_ALIGN(handle, sizeof(*(handle)), \
+				       __alignof__(*(handle)))
+
+/**
+ * Allocate an explicitly-sized, explicitly-aligned lcore variable
+ * by means of a RTE_INIT constructor.
+ *
+ * The values of the lcore variable are initialized to zero.
+ */
+#define RTE_LCORE_VAR_INIT_SIZE_ALIGN(name, size, align) \
+	RTE_INIT(rte_lcore_var_init_ ## name) \
+	{ \
+		RTE_LCORE_VAR_ALLOC_SIZE_ALIGN(name, size, align); \
+	}
+
+/**
+ * Allocate an explicitly-sized lcore variable by means of a RTE_INIT
+ * constructor.
+ *
+ * The values of the lcore variable are initialized to zero.
+ */
+#define RTE_LCORE_VAR_INIT_SIZE(name, size) \
+	RTE_LCORE_VAR_INIT_SIZE_ALIGN(name, size, 0)
+
+/**
+ * Allocate an lcore variable by means of a RTE_INIT constructor.
+ *
+ * The values of the lcore variable are initialized to zero.
+ */
+#define RTE_LCORE_VAR_INIT(name) \
+	RTE_INIT(rte_lcore_var_init_ ## name) \
+	{ \
+		RTE_LCORE_VAR_ALLOC(name); \
+	}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Get void pointer to lcore variable instance with the specified
+ * lcore id.
+ *
+ * @param lcore_id
+ *   The lcore id specifying which of the @c RTE_MAX_LCORE value
+ *   instances should be accessed. The lcore id need not be valid
+ *   (e.g., may be ::LCORE_ID_ANY), but in such a case, the pointer is
+ *   also not valid (and thus should not be dereferenced).
+ * @param handle
+ *   The lcore variable handle.
+ */
+__rte_experimental
+static inline void *
+rte_lcore_var_lcore(unsigned int lcore_id, void *handle)
+{
+	return RTE_PTR_ADD(handle, lcore_id * RTE_MAX_LCORE_VAR);
+}
+
+/**
+ * Get pointer to lcore variable instance with the specified lcore id.
+ *
+ * If the lcore id is not valid (e.g., is ::LCORE_ID_ANY), then the
+ * returned pointer is also not valid (and thus should not be
+ * dereferenced).
+ */
+#define RTE_LCORE_VAR_LCORE(lcore_id, handle) \
+	((__typeof__(handle))rte_lcore_var_lcore(lcore_id, handle))
+
+/**
+ * Get pointer to lcore variable instance of the current thread.
+ *
+ * May only be used by EAL threads and registered non-EAL threads.
+ */
+#define RTE_LCORE_VAR(handle) \
+	RTE_LCORE_VAR_LCORE(rte_lcore_id(), handle)
+
+/**
+ * Iterate over each lcore id's value for an lcore variable.
+ *
+ * @param lcore_id
+ *   An <code>unsigned int</code> variable successively set to the
+ *   lcore id of every value in the lcore variable.
+ * @param value
+ *   A pointer variable successively set to point to lcore variable
+ *   value instance of the current lcore id being processed.
+ * @param handle
+ *   The lcore variable handle.
+ */
+#define RTE_LCORE_VAR_FOREACH(lcore_id, value, handle) \
+	for ((lcore_id) = \
+		     (((value) = RTE_LCORE_VAR_LCORE(0, handle)), 0); \
+	     (lcore_id) < RTE_MAX_LCORE; \
+	     (lcore_id)++, (value) = RTE_LCORE_VAR_LCORE(lcore_id, \
+							 handle))
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Allocate space in the per-lcore id buffers for an lcore variable.
+ *
+ * The pointer returned is only an opaque identifier of the variable.
+ * To get an actual pointer to a particular instance of the variable,
+ * use RTE_LCORE_VAR() or RTE_LCORE_VAR_LCORE().
+ *
+ * The lcore variable values' memory is set to zero.
+ *
+ * The allocation is always successful, barring a fatal exhaustion of
+ * the process's memory, in which case it panics.
+ *
+ * The lcore variable values are never freed. This function is not
+ * multi-thread safe.
+ *
+ * @param size
+ *   The size (in bytes) of the variable's per-lcore id value. Must be
+ *   greater than 0 and not greater than RTE_MAX_LCORE_VAR.
+ * @param align
+ *   If 0, the values will be suitably aligned for any kind of type
+ *   (i.e., alignof(max_align_t)). Otherwise, the value will be aligned
+ *   on a multiple of @p align, which must be a power of 2 and equal or
+ *   less than @c RTE_CACHE_LINE_SIZE.
+ * @return
+ *   The variable's handle, stored in a void pointer value. The value
+ *   is always non-NULL.
+ */
+__rte_experimental
+void *
+rte_lcore_var_alloc(size_t size, size_t align)
+	__rte_alloc_size(1);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_LCORE_VAR_H_ */
@@ -0,0 +1,129 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#ifndef _RTE_PERSIST_H_
+#define _RTE_PERSIST_H_
+
+/**
+ * @file
+ * RTE Persistent Memory
+ *
+ * Named zones carved out of a memory file which outlives the process, such
+ * as a hugetlbfs file. The file is always mapped at the virtual address it
+ * was created at, so that the zones, and the pointers they hold to each
+ * other, are valid again when the file is opened by a restarted process.
+ *
+ * The zones are never freed, the whole file is discarded by removing it.
+ * Only the process which opened the file may use its zones.
+ */
+
+#include <stddef.h>
+
+#include <rte_compat.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Maximum length of a persistent zone name. */
+#define RTE_PERSIST_NAMESIZE 32
+
+/** Maximum number of persistent zones in a file. */
+#define RTE_PERSIST_MAX_ZONES 256
+
+/**
+ * A persistent zone, identified by a name.
+ */
+struct rte_persist_zone {
+	char name[RTE_PERSIST_NAMESIZE]; /**< Name of the zone. */
+	void *addr;                      /**< Start virtual address. */
+	size_t len;                      /**< Length of the zone. */
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Open the persistent memory file of the process, locking it.
+ *
+ * If the file holds persistent zones, it is mapped at the address it was
+ * created at, and its zones can be looked up. Otherwise, it is created with
+ * the requested size and address.
+ *
+ * It should be called right after rte_eal_init(), before the address space
+ * of the process gets more crowded.
+ *
+ * @param path
+ *   Path of the file, on a hugetlbfs mount for hugepage backed zones.
+ * @param addr
+ *   Virtual address of a created file, NULL to get one from the EAL.
+ * @param len
+ *   Size of a created file, rounded up to the page size.
+ * @return
+ *   1 if existing zones were attached, 0 if the file was created,
+ *   negative errno value on failure.
+ */
+__rte_experimental
+int
+rte_persist_open(const char *path, void *addr, size_t len);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Unmap the persistent memory file. Its zones are kept in the file, but
+ * their addresses are no longer valid in the process.
+ *
+ * @return
+ *   0 on success, negative errno value if no file is open.
+ */
+__rte_experimental
+int
+rte_persist_close(void);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Reserve a zeroed persistent zone in the open file.
+ *
+ * @param name
+ *   Name of the zone.
+ * @param len
+ *   Length of the zone.
+ * @param align
+ *   Alignment of the zone, a power of two, 0 for a cache line.
+ * @return
+ *   Pointer to the zone, NULL on error with rte_errno set:
+ *    - EINVAL - invalid parameters, or no file is open
+ *    - ENAMETOOLONG - name is too long
+ *    - EEXIST - a zone with the same name exists
+ *    - ENOSPC - no space or zone slot left in the file
+ */
+__rte_experimental
+const struct rte_persist_zone *
+rte_persist_zone_reserve(const char *name, size_t len, unsigned int align);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Look up a persistent zone in the open file.
+ *
+ * @param name
+ *   Name of the zone.
+ * @return
+ *   Pointer to the zone, NULL on error with rte_errno set:
+ *    - EINVAL - invalid parameters, or no file is open
+ *    - ENOENT - no zone with this name
+ */
+__rte_experimental
+const struct rte_persist_zone *
+rte_persist_zone_lookup(const char *name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_PERSIST_H_ */
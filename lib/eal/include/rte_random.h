@@ -66,6 +66,54 @@ __rte_experimental
 uint64_t
 rte_rand_max(uint64_t upper_bound);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Get pseudo-random values in bulk.
+ *
+ * The values are generated with several generators run in parallel, which
+ * is cheaper per value than rte_rand() for more than a few values. The
+ * sequence is different from the one of rte_rand(), and is also seeded by
+ * rte_srand().
+ *
+ * The generator is not cryptographically secure.
+ *
+ * If called from lcore threads, this function is thread-safe.
+ *
+ * @param values
+ *   Array of at least n elements, filled with pseudo-random values between
+ *   0 and (1<<64)-1.
+ * @param n
+ *   Number of values to generate.
+ */
+__rte_experimental
+void
+rte_rand_bulk(uint64_t *values, unsigned int n);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Get pseudo-random values with an upper bound in bulk.
+ *
+ * This function returns uniformly distributed (unbiased) random numbers
+ * less than a user-specified maximum value, generated as in rte_rand_bulk().
+ *
+ * If called from lcore threads, this function is thread-safe.
+ *
+ * @param upper_bound
+ *   The upper bound of the generated numbers.
+ * @param values
+ *   Array of at least n elements, filled with pseudo-random values between
+ *   0 and (upper_bound-1).
+ * @param n
+ *   Number of values to generate.
+ */
+__rte_experimental
+void
+rte_rand_max_bulk(uint64_t upper_bound, uint64_t *values, unsigned int n);
+
 #ifdef __cplusplus
 }
 #endif
@@ -31,6 +31,7 @@ extern "C" {
 #include <stdint.h>
 #include <sys/queue.h>
 
+#include <rte_compat.h>
 #include <rte_config.h>
 #include <rte_lcore.h>
 
@@ -340,6 +341,44 @@ int32_t rte_service_lcore_reset_all(void);
  */
 int32_t rte_service_set_stats_enable(uint32_t id, int32_t enable);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Set the weight of a service, the maximum number of times it is called in
+ * a row by each service core loop, before the next service is run.
+ * A service reporting no work with -EAGAIN is not called again until the
+ * next loop. The default weight is 1.
+ *
+ * A higher weight than the other services of the same core gives more time
+ * to a light service sharing the core with a heavy one.
+ *
+ * @param id The service to set the weight of.
+ * @param weight The number of calls per loop, must not be zero.
+ * @retval 0 Success
+ * @retval -EINVAL Invalid service id or weight
+ */
+__rte_experimental
+int32_t rte_service_set_weight(uint32_t id, uint32_t weight);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Set the number of service core loops skipping a service, after it
+ * reported no work by returning -EAGAIN from its callback. The skip is
+ * tracked per service core, so that idle services leave the core to the
+ * busy ones. It adds up to this number of loops of latency when the
+ * service gets work again. The default is 0, never skipping the service.
+ *
+ * @param id The service to set the idle skip of.
+ * @param loops The number of loops to skip after an idle call.
+ * @retval 0 Success
+ * @retval -EINVAL Invalid service id
+ */
+__rte_experimental
+int32_t rte_service_set_idle_skip(uint32_t id, uint32_t loops);
+
 /**
  * Retrieve the list of currently enabled service cores.
  *
@@ -387,9 +426,40 @@ int32_t rte_service_dump(FILE *f, uint32_t id);
  */
 #define RTE_SERVICE_ATTR_CALL_COUNT 1
 
+/**
+ * Returns the count of invocations of this service function which reported
+ * no work, by returning -EAGAIN
+ */
+#define RTE_SERVICE_ATTR_IDLE_CALL_COUNT 2
+
+/**
+ * Returns the highest number of cycles taken by a single invocation of this
+ * service function
+ */
+#define RTE_SERVICE_ATTR_CYCLES_MAX 3
+
+/** Number of buckets of the cycles per call histogram of a service. */
+#define RTE_SERVICE_CYCLES_HIST_SIZE 16
+
+/** Bucket 0 counts the calls taking less than 2^RTE_SERVICE_CYCLES_HIST_SHIFT
+ * cycles.
+ */
+#define RTE_SERVICE_CYCLES_HIST_SHIFT 7
+
+/**
+ * Returns the count of invocations of this service function in a bucket of
+ * the cycles per call histogram. Bucket 0 counts the calls taking less than
+ * 128 cycles, each bucket b above counts the calls taking from 2^(b + 6)
+ * to 2^(b + 7) - 1 cycles, and the last one the calls taking more.
+ */
+#define RTE_SERVICE_ATTR_CYCLES_HIST(bucket) (16 + (bucket))
+
 /**
  * Get an attribute from a service.
  *
+ * The statistics are only collected when enabled with
+ * rte_service_set_stats_enable().
+ *
  * @retval 0 Success, the attribute value has been written to *attr_value*.
  *         -EINVAL Invalid id, attr_id or attr_value was NULL.
  */
@@ -19,6 +19,10 @@ extern "C" {
 
 /**
  * Signature of callback function to run a service.
+ *
+ * The callback returns -EAGAIN when it found no work to do,
+ * which is accounted in the idle calls of the service and lets service
+ * cores skip it, see rte_service_set_idle_skip(). Other values are ignored.
  */
 typedef int32_t (*rte_service_func)(void *args);
 
@@ -187,6 +187,38 @@ int rte_trace_point_disable(rte_trace_point_t *tp);
 __rte_experimental
 bool rte_trace_point_is_enabled(rte_trace_point_t *tp);
 
+/**
+ * Record only a sample of the events of the given tracepoint.
+ *
+ * Each event is recorded with a probability of one in the sampling period,
+ * drawn per thread, so that a fast path tracepoint can be left enabled at a
+ * low cost.
+ *
+ * @param tp
+ *   The tracepoint object.
+ * @param period
+ *   The sampling period, a power of two up to 2^31, 1 to record all the
+ *   events.
+ * @return
+ *   - 0: Success.
+ *   - (-ERANGE): Trace object is not registered.
+ *   - (-EINVAL): Invalid sampling period.
+ */
+__rte_experimental
+int rte_trace_point_sampling_set(rte_trace_point_t *tp, uint32_t period);
+
+/**
+ * Get the sampling period of the given tracepoint.
+ *
+ * @param tp
+ *   The tracepoint object.
+ * @return
+ *   The sampling period, 1 if all the events are recorded, 0 if the
+ *   tracepoint is not registered.
+ */
+__rte_experimental
+uint32_t rte_trace_point_sampling_get(rte_trace_point_t *tp);
+
 /**
  * Lookup a tracepoint object from its name.
  *
@@ -276,6 +308,9 @@ int __rte_trace_point_register(rte_trace_point_t *trace, const char *name,
 #define __RTE_TRACE_FIELD_SIZE_MASK (0xffffULL << __RTE_TRACE_FIELD_SIZE_SHIFT)
 #define __RTE_TRACE_FIELD_ID_SHIFT (16)
 #define __RTE_TRACE_FIELD_ID_MASK (0xffffULL << __RTE_TRACE_FIELD_ID_SHIFT)
+#define __RTE_TRACE_FIELD_SAMPLING_SHIFT (32)
+#define __RTE_TRACE_FIELD_SAMPLING_MASK \
+	(0x1fULL << __RTE_TRACE_FIELD_SAMPLING_SHIFT)
 #define __RTE_TRACE_FIELD_ENABLE_MASK (1ULL << 63)
 #define __RTE_TRACE_FIELD_ENABLE_DISCARD (1ULL << 62)
 
@@ -289,6 +324,7 @@ struct __rte_trace_stream_header {
 struct __rte_trace_header {
 	uint32_t offset;
 	uint32_t len;
+	uint64_t sampling_state;
 	struct __rte_trace_stream_header stream_header;
 	uint8_t mem[];
 };
@@ -309,6 +345,20 @@ __rte_trace_mem_get(uint64_t in)
 		if (unlikely(trace == NULL))
 			return NULL;
 	}
+	/* Record one in 2^n events of a sampled trace point */
+	if (unlikely(in & __RTE_TRACE_FIELD_SAMPLING_MASK)) {
+		const uint64_t n = (in & __RTE_TRACE_FIELD_SAMPLING_MASK) >>
+			__RTE_TRACE_FIELD_SAMPLING_SHIFT;
+		uint64_t x = trace->sampling_state;
+
+		/* xorshift64 */
+		x ^= x << 13;
+		x ^= x >> 7;
+		x ^= x << 17;
+		trace->sampling_state = x;
+		if ((x & ((UINT64_C(1) << n) - 1)) != 0)
+			return NULL;
+	}
 	/* Check the wrap around case */
 	uint32_t offset = trace->offset;
 	if (unlikely((offset + sz) >= trace->len)) {
@@ -6,6 +6,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <inttypes.h>
 #include <string.h>
 #include <stdarg.h>
 #include <unistd.h>
@@ -958,6 +959,16 @@ is_iommu_enabled(void)
 	return n > 2;
 }
 
+/* monotonic time in ms, the TSC is not calibrated during memory init */
+static uint64_t
+eal_clock_ms(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * MS_PER_S + ts.tv_nsec / (NS_PER_S / MS_PER_S);
+}
+
 /* Launch threads, called at application init(). */
 int
 rte_eal_init(int argc, char **argv)
@@ -971,6 +982,7 @@ rte_eal_init(int argc, char **argv)
 	char cpuset[RTE_CPU_AFFINITY_STR_LEN];
 	char thread_name[RTE_MAX_THREAD_NAME_LEN];
 	bool phys_addrs;
+	uint64_t start_ms;
 	const struct rte_config *config = rte_eal_get_configuration();
 	struct internal_config *internal_conf =
 		eal_get_internal_configuration();
@@ -1190,20 +1202,26 @@ rte_eal_init(int argc, char **argv)
 		return -1;
 	}
 
+	start_ms = eal_clock_ms();
 	if (rte_eal_memory_init() < 0) {
 		rte_eal_init_alert("Cannot init memory");
 		rte_errno = ENOMEM;
 		return -1;
 	}
+	RTE_LOG(DEBUG, EAL, "Memory init took %" PRIu64 " ms\n",
+		eal_clock_ms() - start_ms);
 
 	/* the directories are locked during eal_hugepage_info_init */
 	eal_hugedirs_unlock();
 
+	start_ms = eal_clock_ms();
 	if (rte_eal_malloc_heap_init() < 0) {
 		rte_eal_init_alert("Cannot init malloc heap");
 		rte_errno = ENODEV;
 		return -1;
 	}
+	RTE_LOG(DEBUG, EAL, "Malloc heap init took %" PRIu64 " ms\n",
+		eal_clock_ms() - start_ms);
 
 	if (rte_eal_tailqs_init() < 0) {
 		rte_eal_init_alert("Cannot init tail queues for objects");
@@ -1364,6 +1382,7 @@ rte_eal_cleanup(void)
 		rte_memseg_walk(mark_freeable, NULL);
 	rte_service_finalize();
 	rte_mp_channel_cleanup();
+	malloc_heap_cache_flush_all();
 	/* after this point, any DPDK pointers will become dangling */
 	rte_eal_memory_detach();
 	rte_trace_save();
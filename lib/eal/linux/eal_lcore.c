@@ -4,6 +4,8 @@
 
 #include <unistd.h>
 #include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <dirent.h>
 
@@ -20,6 +22,9 @@
 
 #define SYS_CPU_DIR "/sys/devices/system/cpu/cpu%u"
 #define CORE_ID_FILE "topology/core_id"
+#define SIBLINGS_FILE "topology/thread_siblings_list"
+#define CLUSTER_FILE "topology/cluster_cpus_list"
+#define CACHE_DIR "cache/index%u"
 #define NUMA_NODE_PATH "/sys/devices/system/node"
 
 /* Check if a cpu is present by the presence of the cpu information for it */
@@ -79,3 +84,95 @@ eal_cpu_core_id(unsigned lcore_id)
 			"for lcore %u - assuming core 0\n", SYS_CPU_DIR, lcore_id);
 	return 0;
 }
+
+/*
+ * Read the first cpu of a sysfs cpu list, which is the lowest one as the
+ * lists are sorted. It identifies the group of cpus.
+ */
+static int
+eal_cpu_list_first(const char *path)
+{
+	char buf[BUFSIZ];
+	unsigned long cpu;
+	char *end;
+	FILE *f;
+
+	f = fopen(path, "r");
+	if (f == NULL)
+		return -1;
+	if (fgets(buf, sizeof(buf), f) == NULL) {
+		fclose(f);
+		return -1;
+	}
+	fclose(f);
+
+	cpu = strtoul(buf, &end, 10);
+	if (end == buf || cpu >= CPU_SETSIZE)
+		return -1;
+	return cpu;
+}
+
+/* Get the group of cpus sharing the unified or data cache of a level. */
+static int
+eal_cpu_cache_id(unsigned int cpu, unsigned long level)
+{
+	char path[PATH_MAX];
+	char type[16];
+	unsigned long val;
+	unsigned int idx;
+	FILE *f;
+
+	for (idx = 0; ; idx++) {
+		snprintf(path, sizeof(path), SYS_CPU_DIR "/" CACHE_DIR "/level",
+			cpu, idx);
+		if (eal_parse_sysfs_value(path, &val) != 0)
+			return -1;
+		if (val != level)
+			continue;
+
+		snprintf(path, sizeof(path), SYS_CPU_DIR "/" CACHE_DIR "/type",
+			cpu, idx);
+		f = fopen(path, "r");
+		if (f == NULL)
+			continue;
+		if (fgets(type, sizeof(type), f) == NULL ||
+				strncmp(type, "Instruction", 11) == 0) {
+			fclose(f);
+			continue;
+		}
+		fclose(f);
+
+		snprintf(path, sizeof(path), SYS_CPU_DIR "/" CACHE_DIR
+			"/shared_cpu_list", cpu, idx);
+		return eal_cpu_list_first(path);
+	}
+}
+
+/*
+ * Get the topology domain of a cpu from sysfs. The domains are identified
+ * by their first cpu, except the NUMA nodes.
+ */
+int
+eal_cpu_domain_id(unsigned int cpu, enum rte_lcore_domain domain)
+{
+	char path[PATH_MAX];
+
+	switch (domain) {
+	case RTE_LCORE_DOMAIN_CORE:
+		snprintf(path, sizeof(path), SYS_CPU_DIR "/" SIBLINGS_FILE,
+			cpu);
+		return eal_cpu_list_first(path);
+	case RTE_LCORE_DOMAIN_L2:
+		return eal_cpu_cache_id(cpu, 2);
+	case RTE_LCORE_DOMAIN_CLUSTER:
+		snprintf(path, sizeof(path), SYS_CPU_DIR "/" CLUSTER_FILE,
+			cpu);
+		return eal_cpu_list_first(path);
+	case RTE_LCORE_DOMAIN_L3:
+		return eal_cpu_cache_id(cpu, 3);
+	case RTE_LCORE_DOMAIN_NUMA:
+		return eal_cpu_socket_id(cpu);
+	default:
+		return -1;
+	}
+}
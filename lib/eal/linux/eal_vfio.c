@@ -523,6 +523,51 @@ vfio_group_device_count(int vfio_group_fd)
 	return vfio_cfg->vfio_groups[i].devices;
 }
 
+/*
+ * Map or unmap a range of segments of an external memory area, with one call
+ * per run of segments contiguous in IOVA rather than one per segment, as the
+ * pages of external memory may be small. External memory is always added and
+ * removed as a whole, so that the same runs are found when unmapping it.
+ */
+static int
+vfio_dma_mem_map_segs(vfio_dma_user_func_t dma_map, int vfio_container_fd,
+		const struct rte_memseg *ms, size_t len, int do_map)
+{
+	uint64_t vaddr = 0, iova = 0, run_len = 0;
+	size_t cur_len;
+	int ret = 0;
+
+	for (cur_len = 0; cur_len < len; cur_len += ms->len, ms++) {
+		if (run_len != 0 && ms->iova != RTE_BAD_IOVA &&
+				ms->iova == iova + run_len) {
+			run_len += ms->len;
+			continue;
+		}
+
+		if (run_len != 0 && dma_map(vfio_container_fd, vaddr, iova,
+				run_len, do_map) < 0)
+			ret = -1;
+		run_len = 0;
+
+		/* some memory segments may have invalid IOVA */
+		if (ms->iova == RTE_BAD_IOVA) {
+			RTE_LOG(DEBUG, EAL,
+				"Memory segment at %p has bad IOVA, skipping\n",
+				ms->addr);
+			continue;
+		}
+		vaddr = ms->addr_64;
+		iova = ms->iova;
+		run_len = ms->len;
+	}
+
+	if (run_len != 0 && dma_map(vfio_container_fd, vaddr, iova, run_len,
+			do_map) < 0)
+		ret = -1;
+
+	return ret;
+}
+
 static void
 vfio_mem_event_callback(enum rte_mem_event type, const void *addr, size_t len,
 		void *arg __rte_unused)
@@ -533,8 +578,17 @@ vfio_mem_event_callback(enum rte_mem_event type, const void *addr, size_t len,
 
 	msl = rte_mem_virt2memseg_list(addr);
 
+	if (msl->external) {
+		ms = rte_mem_virt2memseg(addr, msl);
+		vfio_dma_mem_map_segs(
+			default_vfio_cfg->vfio_iommu_type->dma_user_map_func,
+			default_vfio_cfg->vfio_container_fd, ms, len,
+			type == RTE_MEM_EVENT_ALLOC);
+		return;
+	}
+
 	/* for IOVA as VA mode, no need to care for IOVA addresses */
-	if (rte_eal_iova_mode() == RTE_IOVA_VA && msl->external == 0) {
+	if (rte_eal_iova_mode() == RTE_IOVA_VA) {
 		uint64_t vfio_va = (uint64_t)(uintptr_t)addr;
 		uint64_t page_sz = msl->page_sz;
 
@@ -1309,22 +1363,32 @@ type1_map(const struct rte_memseg_list *msl, const struct rte_memseg *ms,
 {
 	int *vfio_container_fd = arg;
 
-	/* skip external memory that isn't a heap */
-	if (msl->external && !msl->heap)
+	/* external memory is mapped by type1_map_ext */
+	if (msl->external)
 		return 0;
 
 	/* skip any segments with invalid IOVA addresses */
 	if (ms->iova == RTE_BAD_IOVA)
 		return 0;
 
-	/* if IOVA mode is VA, we've already mapped the internal segments */
-	if (!msl->external && rte_eal_iova_mode() == RTE_IOVA_VA)
-		return 0;
-
 	return vfio_type1_dma_mem_map(*vfio_container_fd, ms->addr_64, ms->iova,
 			ms->len, 1);
 }
 
+static int
+type1_map_ext(const struct rte_memseg_list *msl, void *arg)
+{
+	int *vfio_container_fd = arg;
+
+	/* skip external memory that isn't a heap */
+	if (!msl->external || !msl->heap || msl->memseg_arr.count == 0)
+		return 0;
+
+	return vfio_dma_mem_map_segs(vfio_type1_dma_mem_map,
+			*vfio_container_fd, rte_fbarray_get(&msl->memseg_arr, 0),
+			msl->len, 1);
+}
+
 static int
 vfio_type1_dma_mem_map(int vfio_container_fd, uint64_t vaddr, uint64_t iova,
 		uint64_t len, int do_map)
@@ -1393,11 +1457,11 @@ vfio_type1_dma_map(int vfio_container_fd)
 				&vfio_container_fd);
 		if (ret)
 			return ret;
-		/* we have to continue the walk because we've skipped the
-		 * external segments during the config walk.
-		 */
+	} else if (rte_memseg_walk(type1_map, &vfio_container_fd) < 0) {
+		return -1;
 	}
-	return rte_memseg_walk(type1_map, &vfio_container_fd);
+
+	return rte_memseg_list_walk(type1_map_ext, &vfio_container_fd);
 }
 
 /* Track the size of the statically allocated DMA window for SPAPR */
@@ -159,6 +159,15 @@ eal_cpu_core_id(unsigned int lcore_id)
 	return cpu_map.lcores[lcore_id].core_id;
 }
 
+int
+eal_cpu_domain_id(unsigned int cpu, enum rte_lcore_domain domain)
+{
+	/* Only the NUMA topology is enumerated. */
+	if (domain == RTE_LCORE_DOMAIN_NUMA)
+		return eal_cpu_socket_id(cpu);
+	return -1;
+}
+
 unsigned int
 eal_socket_numa_node(unsigned int socket_id)
 {
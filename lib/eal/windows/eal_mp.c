@@ -79,6 +79,14 @@ rte_mp_reply(struct rte_mp_msg *msg, const char *peer)
 	return -1;
 }
 
+int
+rte_mp_shm_request_enable(const char *name)
+{
+	RTE_SET_USED(name);
+	EAL_LOG_NOT_IMPLEMENTED();
+	return -1;
+}
+
 int
 register_mp_requests(void)
 {
@@ -0,0 +1,127 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <stdint.h>
+
+#include <rte_branch_prediction.h>
+#include <rte_common.h>
+#include <rte_cpuflags.h>
+#include <rte_memcpy.h>
+#include <rte_vect.h>
+
+/*
+ * The copy functions below move 64 bytes blocks to a 64 bytes aligned
+ * destination, with non-temporal stores. The vector instructions of each
+ * one are enabled per function, so that they are all available whatever
+ * the build target, and the best one is chosen at runtime.
+ */
+typedef void (*memcpy_nt_block_t)(uint8_t *dst, const uint8_t *src,
+		size_t n);
+
+static void
+memcpy_nt_block_sse2(uint8_t *dst, const uint8_t *src, size_t n)
+{
+	__m128i xmm0, xmm1, xmm2, xmm3;
+
+	for (; n >= 64; n -= 64, dst += 64, src += 64) {
+		xmm0 = _mm_loadu_si128((const __m128i *)(src + 0 * 16));
+		xmm1 = _mm_loadu_si128((const __m128i *)(src + 1 * 16));
+		xmm2 = _mm_loadu_si128((const __m128i *)(src + 2 * 16));
+		xmm3 = _mm_loadu_si128((const __m128i *)(src + 3 * 16));
+		_mm_stream_si128((__m128i *)(dst + 0 * 16), xmm0);
+		_mm_stream_si128((__m128i *)(dst + 1 * 16), xmm1);
+		_mm_stream_si128((__m128i *)(dst + 2 * 16), xmm2);
+		_mm_stream_si128((__m128i *)(dst + 3 * 16), xmm3);
+	}
+}
+
+static __attribute__((target("avx2"))) void
+memcpy_nt_block_avx2(uint8_t *dst, const uint8_t *src, size_t n)
+{
+	__m256i ymm0, ymm1;
+
+	for (; n >= 64; n -= 64, dst += 64, src += 64) {
+		ymm0 = _mm256_loadu_si256((const __m256i *)(src + 0 * 32));
+		ymm1 = _mm256_loadu_si256((const __m256i *)(src + 1 * 32));
+		_mm256_stream_si256((__m256i *)(dst + 0 * 32), ymm0);
+		_mm256_stream_si256((__m256i *)(dst + 1 * 32), ymm1);
+	}
+}
+
+static __attribute__((target("avx512f"))) void
+memcpy_nt_block_avx512(uint8_t *dst, const uint8_t *src, size_t n)
+{
+	__m512i zmm0;
+
+	for (; n >= 64; n -= 64, dst += 64, src += 64) {
+		zmm0 = _mm512_loadu_si512((const void *)src);
+		_mm512_stream_si512((void *)dst, zmm0);
+	}
+}
+
+/* smaller copies are not worth bypassing the cache */
+#define MEMCPY_NT_THRESHOLD 2048
+
+static memcpy_nt_block_t memcpy_nt_block;
+
+/*
+ * Chosen on first use rather than in a constructor,
+ * to honour the max SIMD bitwidth set by the application or EAL options.
+ */
+static memcpy_nt_block_t
+memcpy_nt_block_select(void)
+{
+	uint16_t max_simd = rte_vect_get_max_simd_bitwidth();
+	memcpy_nt_block_t fn = memcpy_nt_block_sse2;
+
+	if (max_simd >= RTE_VECT_SIMD_512 &&
+			rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F) == 1)
+		fn = memcpy_nt_block_avx512;
+	else if (max_simd >= RTE_VECT_SIMD_256 &&
+			rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX2) == 1)
+		fn = memcpy_nt_block_avx2;
+
+	__atomic_store_n(&memcpy_nt_block, fn, __ATOMIC_RELAXED);
+	return fn;
+}
+
+void *
+rte_memcpy_nt(void *dst, const void *src, size_t n)
+{
+	memcpy_nt_block_t fn;
+	size_t head, len;
+	uint8_t *d = dst;
+	const uint8_t *s = src;
+
+	if (n < MEMCPY_NT_THRESHOLD)
+		return rte_memcpy(dst, src, n);
+
+	fn = __atomic_load_n(&memcpy_nt_block, __ATOMIC_RELAXED);
+	if (unlikely(fn == NULL))
+		fn = memcpy_nt_block_select();
+
+	/* align the destination on a cache line */
+	head = RTE_PTR_DIFF(RTE_PTR_ALIGN_CEIL(d, 64), d);
+	if (head != 0) {
+		rte_memcpy(d, s, head);
+		d += head;
+		s += head;
+		n -= head;
+	}
+
+	len = RTE_ALIGN_FLOOR(n, 64);
+	if (len != 0) {
+		fn(d, s, len);
+		/* order the weakly ordered stores with the following ones */
+		_mm_sfence();
+		d += len;
+		s += len;
+		n -= len;
+	}
+
+	if (n != 0)
+		rte_memcpy(d, s, n);
+
+	return dst;
+}
@@ -3,7 +3,9 @@
  */
 
 #include <rte_common.h>
+#include <rte_cycles.h>
 #include <rte_lcore.h>
+#include <rte_rtm.h>
 #include <rte_spinlock.h>
 
 #include "rte_power_intrinsics.h"
@@ -14,6 +16,7 @@
 static struct power_wait_status {
 	rte_spinlock_t lock;
 	volatile void *monitor_addr; /**< NULL if not currently sleeping */
+	volatile bool wakeup; /**< wakeup requested, for multi monitoring */
 } __rte_cache_aligned wait_status[RTE_MAX_LCORE];
 
 static inline void
@@ -28,6 +31,7 @@ __umwait_wakeup(volatile void *addr)
 }
 
 static bool wait_supported;
+static bool wait_multi_rtm;
 
 static inline uint64_t
 __get_umwait_val(const volatile void *p, const uint8_t sz)
@@ -63,6 +67,17 @@ __check_val_size(const uint8_t sz)
 	}
 }
 
+/* check if the masked value at the monitored address is already matching */
+static inline bool
+__cond_is_met(const struct rte_power_monitor_cond *pmc)
+{
+	if (!pmc->mask)
+		return false;
+
+	return (__get_umwait_val(pmc->addr, pmc->size) & pmc->mask) ==
+			pmc->val;
+}
+
 /**
  * This function uses UMONITOR/UMWAIT instructions and will enter C0.2 state.
  * For more information about usage of these instructions, please refer to
@@ -111,15 +126,8 @@ rte_power_monitor(const struct rte_power_monitor_cond *pmc,
 	rte_spinlock_unlock(&s->lock);
 
 	/* if we have a comparison mask, we might not need to sleep at all */
-	if (pmc->mask) {
-		const uint64_t cur_value = __get_umwait_val(
-				pmc->addr, pmc->size);
-		const uint64_t masked = cur_value & pmc->mask;
-
-		/* if the masked value is already matching, abort */
-		if (masked == pmc->val)
-			goto end;
-	}
+	if (__cond_is_met(pmc))
+		goto end;
 
 	/* execute UMWAIT */
 	asm volatile(".byte 0xf2, 0x0f, 0xae, 0xf7;"
@@ -167,6 +175,8 @@ RTE_INIT(rte_power_intrinsics_init) {
 
 	if (i.power_monitor && i.power_pause)
 		wait_supported = 1;
+	if (wait_supported && rte_cpu_get_flag_enabled(RTE_CPUFLAG_RTM))
+		wait_multi_rtm = 1;
 }
 
 int
@@ -209,7 +219,116 @@ rte_power_monitor_wakeup(const unsigned int lcore_id)
 	rte_spinlock_lock(&s->lock);
 	if (s->monitor_addr != NULL)
 		__umwait_wakeup(s->monitor_addr);
+	s->wakeup = true;
 	rte_spinlock_unlock(&s->lock);
 
 	return 0;
 }
+
+/*
+ * All the monitored addresses are added to the read set of a RTM transaction,
+ * so that a write to any of them aborts the transaction and thus the TPAUSE
+ * executed inside of it.
+ */
+static int
+__monitor_multi_rtm(struct power_wait_status *s,
+		const struct rte_power_monitor_cond pmc[], const uint32_t num,
+		const uint64_t tsc_timestamp)
+{
+	uint32_t i;
+
+	/* we are already inside a transaction region, return */
+	if (rte_xtest() != 0)
+		return 0;
+
+	/* transaction aborted, possibly by a write to one of the addresses */
+	if (rte_xbegin() != RTE_XBEGIN_STARTED)
+		return 0;
+
+	/*
+	 * reading the lock adds it to the read set, so that the locking done
+	 * by rte_power_monitor_wakeup() aborts the transaction as well.
+	 */
+	rte_spinlock_is_locked(&s->lock);
+
+	for (i = 0; i < num; i++) {
+		if (__cond_is_met(&pmc[i]))
+			break;
+	}
+
+	/* none of the conditions are met, sleep until timeout */
+	if (i == num)
+		rte_power_pause(tsc_timestamp);
+
+	rte_xend();
+
+	return 0;
+}
+
+/*
+ * Without RTM, the conditions are checked in between short TPAUSE sleeps, so
+ * a write is noticed at most a microsecond late.
+ */
+static int
+__monitor_multi_pause(struct power_wait_status *s,
+		const struct rte_power_monitor_cond pmc[], const uint32_t num,
+		const uint64_t tsc_timestamp)
+{
+	const uint64_t tsc_per_us = rte_get_tsc_hz() / US_PER_S;
+	uint64_t cur;
+	uint32_t i;
+
+	rte_spinlock_lock(&s->lock);
+	s->wakeup = false;
+	rte_spinlock_unlock(&s->lock);
+
+	do {
+		for (i = 0; i < num; i++) {
+			if (__cond_is_met(&pmc[i]))
+				return 0;
+		}
+
+		cur = rte_rdtsc();
+		if (cur >= tsc_timestamp)
+			break;
+
+		rte_power_pause(RTE_MIN(cur + tsc_per_us, tsc_timestamp));
+	} while (!s->wakeup);
+
+	return 0;
+}
+
+/**
+ * This function uses either RTM and TPAUSE instructions, or TPAUSE alone, and
+ * will enter C0.2 state.
+ */
+int
+rte_power_monitor_multi(const struct rte_power_monitor_cond pmc[],
+		const uint32_t num, const uint64_t tsc_timestamp)
+{
+	const unsigned int lcore_id = rte_lcore_id();
+	uint32_t i;
+
+	/* prevent user from running this instruction if it's not supported */
+	if (!wait_supported)
+		return -ENOTSUP;
+
+	/* prevent non-EAL thread from using this API */
+	if (lcore_id >= RTE_MAX_LCORE)
+		return -EINVAL;
+
+	if (pmc == NULL || num == 0)
+		return -EINVAL;
+
+	for (i = 0; i < num; i++) {
+		if (__check_val_size(pmc[i].size) < 0)
+			return -EINVAL;
+	}
+
+	if (wait_multi_rtm)
+		return __monitor_multi_rtm(&wait_status[lcore_id], pmc, num,
+				tsc_timestamp);
+
+	return __monitor_multi_pause(&wait_status[lcore_id], pmc, num,
+			tsc_timestamp);
+}
@@ -198,6 +198,9 @@ struct efd_offline_chunk_rules {
 
 	struct efd_offline_group_rules group_rules[EFD_CHUNK_NUM_GROUPS];
 	/**< Array of all groups in the chunk. */
+
+	struct rte_efd_group_stats group_stats[EFD_CHUNK_NUM_GROUPS];
+	/**< Perfect hash search statistics of all groups in the chunk. */
 };
 
 /*************************************************************************
@@ -371,7 +374,8 @@ efd_compute_ids(const struct rte_efd_table * const table,
 static inline int
 efd_search_hash(struct rte_efd_table * const table,
 		const struct efd_offline_group_rules * const off_group,
-		struct efd_online_group_entry * const on_group)
+		struct efd_online_group_entry * const on_group,
+		struct rte_efd_group_stats * const stats)
 {
 	efd_hashfunc_t hash_idx;
 	efd_hashfunc_t start_hash_idx[RTE_EFD_VALUE_NUM_BITS];
@@ -384,6 +388,7 @@ efd_search_hash(struct rte_efd_table * const table,
 
 
 	rte_prefetch0(off_group->value);
+	stats->num_searches++;
 
 	/*
 	 * Prepopulate the hash_val tables by running the two hash functions
@@ -473,6 +478,7 @@ efd_search_hash(struct rte_efd_table * const table,
 				break;
 			}
 			hash_idx++;
+			stats->num_retries++;
 
 		} while (hash_idx != start_hash_idx[i]);
 
@@ -486,6 +492,7 @@ efd_search_hash(struct rte_efd_table * const table,
 				on_group->hash_idx[j] = start_hash_idx[j];
 				on_group->lookup_table[j] = start_lookup_table[j];
 			}
+			stats->num_failures++;
 			return 1;
 		}
 	}
@@ -774,32 +781,14 @@ rte_efd_free(struct rte_efd_table *table)
 	rte_free(table);
 }
 
-/**
- * Applies a previously computed table entry to the specified table for all
- * socket-local copies of the online table.
- * Intended to apply an update for only a single change
- * to a key/value pair at a time
- *
- * @param table
- *   EFD table to reference
- * @param socket_id
- *   Socket ID to use to lookup existing values (ideally caller's socket id)
- * @param chunk_id
- *   Chunk index to update
- * @param group_id
- *   Group index to update
- * @param bin_id
- *   Bin within the group that this update affects
- * @param new_bin_choice
- *   Newly chosen permutation which this bin should use - only lower 2 bits
- * @param new_group_entry
- *   Previously computed updated chunk/group entry
+/*
+ * Set the permutation choice of a bin in all socket-local copies
+ * of the online table
  */
 static inline void
-efd_apply_update(struct rte_efd_table * const table, const unsigned int socket_id,
-		const uint32_t chunk_id, const uint32_t group_id,
-		const uint32_t bin_id, const uint8_t new_bin_choice,
-		const struct efd_online_group_entry * const new_group_entry)
+efd_apply_bin_choice(struct rte_efd_table * const table,
+		const unsigned int socket_id, const uint32_t chunk_id,
+		const uint32_t bin_id, const uint8_t new_bin_choice)
 {
 	int i;
 	struct efd_online_chunk *chunk = &table->chunks[socket_id][chunk_id];
@@ -822,16 +811,63 @@ efd_apply_update(struct rte_efd_table * const table, const unsigned int socket_i
 
 	/* Update the online table with the new data across all sockets */
 	for (i = 0; i < RTE_MAX_NUMA_NODES; i++) {
-		if (table->chunks[i] != NULL) {
+		if (table->chunks[i] != NULL)
+			table->chunks[i][chunk_id].bin_choice_list[bin_index] =
+					choice_chunk;
+	}
+}
+
+/*
+ * Copy a group entry to all socket-local copies of the online table
+ */
+static inline void
+efd_apply_group_entry(struct rte_efd_table * const table,
+		const uint32_t chunk_id, const uint32_t group_id,
+		const struct efd_online_group_entry * const new_group_entry)
+{
+	int i;
+
+	/* Update the online table with the new data across all sockets */
+	for (i = 0; i < RTE_MAX_NUMA_NODES; i++) {
+		if (table->chunks[i] != NULL)
 			memcpy(&(table->chunks[i][chunk_id].groups[group_id]),
 					new_group_entry,
 					sizeof(struct efd_online_group_entry));
-			table->chunks[i][chunk_id].bin_choice_list[bin_index] =
-					choice_chunk;
-		}
 	}
 }
 
+/**
+ * Applies a previously computed table entry to the specified table for all
+ * socket-local copies of the online table.
+ * Intended to apply an update for only a single change
+ * to a key/value pair at a time
+ *
+ * @param table
+ *   EFD table to reference
+ * @param socket_id
+ *   Socket ID to use to lookup existing values (ideally caller's socket id)
+ * @param chunk_id
+ *   Chunk index to update
+ * @param group_id
+ *   Group index to update
+ * @param bin_id
+ *   Bin within the group that this update affects
+ * @param new_bin_choice
+ *   Newly chosen permutation which this bin should use - only lower 2 bits
+ * @param new_group_entry
+ *   Previously computed updated chunk/group entry
+ */
+static inline void
+efd_apply_update(struct rte_efd_table * const table, const unsigned int socket_id,
+		const uint32_t chunk_id, const uint32_t group_id,
+		const uint32_t bin_id, const uint8_t new_bin_choice,
+		const struct efd_online_group_entry * const new_group_entry)
+{
+	efd_apply_group_entry(table, chunk_id, group_id, new_group_entry);
+	efd_apply_bin_choice(table, socket_id, chunk_id, bin_id,
+			new_bin_choice);
+}
+
 /*
  * Move the bin from prev group to the new group
  */
@@ -1129,7 +1165,8 @@ efd_compute_update(struct rte_efd_table * const table,
 		 * Recompute the hash function for the modified group,
 		 * and return it to the caller
 		 */
-		ret = efd_search_hash(table, new_group, entry);
+		ret = efd_search_hash(table, new_group, entry,
+				&chunk->group_stats[*group_id]);
 
 		if (!ret)
 			return status;
@@ -1182,6 +1219,324 @@ rte_efd_update(struct rte_efd_table * const table, const unsigned int socket_id,
 	return status;
 }
 
+/**
+ * State of a batch of updates, whose offline changes are applied first
+ * and whose modified groups are searched for a perfect hash only once.
+ */
+struct efd_update_batch {
+	uint32_t num_rules;
+	/**< Number of rules of the table before the batch. */
+
+	uint32_t num_saved;
+	/**< Number of groups saved before their first change. */
+	uint32_t saved_ids[2 * RTE_EFD_BURST_MAX];
+	struct efd_offline_group_rules saved[2 * RTE_EFD_BURST_MAX];
+
+	uint32_t num_dirty;
+	/**< Number of groups to search a perfect hash for. */
+	uint32_t dirty_ids[RTE_EFD_BURST_MAX];
+	struct efd_online_group_entry entries[RTE_EFD_BURST_MAX];
+
+	uint32_t num_choices;
+	/**< Number of bins whose permutation choice changed. */
+	uint32_t choice_chunk_ids[RTE_EFD_BURST_MAX];
+	uint32_t choice_bin_ids[RTE_EFD_BURST_MAX];
+	uint8_t choices[RTE_EFD_BURST_MAX];
+
+	uint32_t num_slots;
+	/**< Number of key slots taken by the batch. */
+	uint32_t slots[RTE_EFD_BURST_MAX];
+};
+
+/* Global index of a group, in [0, num_chunks * EFD_CHUNK_NUM_GROUPS) */
+#define EFD_GROUP_IDX(chunk_id, group_id) \
+	((chunk_id) * EFD_CHUNK_NUM_GROUPS + (group_id))
+
+static inline struct efd_offline_group_rules *
+efd_batch_group(struct rte_efd_table * const table, const uint32_t idx)
+{
+	return &table->offline_chunks[idx / EFD_CHUNK_NUM_GROUPS]
+			.group_rules[idx % EFD_CHUNK_NUM_GROUPS];
+}
+
+/* Save a group before its first change in the batch */
+static inline void
+efd_batch_save(struct rte_efd_table * const table,
+		struct efd_update_batch * const batch, const uint32_t idx)
+{
+	uint32_t i;
+
+	for (i = 0; i < batch->num_saved; i++)
+		if (batch->saved_ids[i] == idx)
+			return;
+
+	batch->saved_ids[batch->num_saved] = idx;
+	batch->saved[batch->num_saved++] = *efd_batch_group(table, idx);
+}
+
+static inline void
+efd_batch_mark_dirty(struct efd_update_batch * const batch,
+		const uint32_t idx)
+{
+	uint32_t i;
+
+	for (i = 0; i < batch->num_dirty; i++)
+		if (batch->dirty_ids[i] == idx)
+			return;
+
+	batch->dirty_ids[batch->num_dirty++] = idx;
+}
+
+/* Current choice of a bin, taking the changes of the batch into account */
+static inline uint8_t
+efd_batch_get_choice(const struct rte_efd_table * const table,
+		const struct efd_update_batch * const batch,
+		const unsigned int socket_id, const uint32_t chunk_id,
+		const uint32_t bin_id)
+{
+	uint32_t i;
+
+	for (i = 0; i < batch->num_choices; i++)
+		if (batch->choice_chunk_ids[i] == chunk_id &&
+				batch->choice_bin_ids[i] == bin_id)
+			return batch->choices[i];
+
+	return efd_get_choice(table, socket_id, chunk_id, bin_id);
+}
+
+static inline void
+efd_batch_set_choice(struct efd_update_batch * const batch,
+		const uint32_t chunk_id, const uint32_t bin_id,
+		const uint8_t choice)
+{
+	uint32_t i;
+
+	for (i = 0; i < batch->num_choices; i++)
+		if (batch->choice_chunk_ids[i] == chunk_id &&
+				batch->choice_bin_ids[i] == bin_id)
+			break;
+
+	batch->choice_chunk_ids[i] = chunk_id;
+	batch->choice_bin_ids[i] = bin_id;
+	batch->choices[i] = choice;
+	if (i == batch->num_choices)
+		batch->num_choices++;
+}
+
+/* Undo the offline changes of the batch */
+static inline void
+efd_batch_revert(struct rte_efd_table * const table,
+		const struct efd_update_batch * const batch)
+{
+	uint32_t i;
+
+	for (i = 0; i < batch->num_saved; i++)
+		*efd_batch_group(table, batch->saved_ids[i]) = batch->saved[i];
+
+	for (i = 0; i < batch->num_slots; i++)
+		rte_ring_sp_enqueue(table->free_slots,
+				(void *)((uintptr_t)batch->slots[i]));
+
+	table->num_rules = batch->num_rules;
+}
+
+/**
+ * Apply to the offline table the insertion or value change of a key,
+ * including the rebalancing of its bin, as efd_compute_update() does,
+ * but without searching a new perfect hash for the modified group.
+ *
+ * @return
+ *   0 if the change was added to the batch,
+ *   RTE_EFD_UPDATE_FAILED if it must go through the single update path.
+ */
+static inline int
+efd_batch_add(struct rte_efd_table * const table,
+		struct efd_update_batch * const batch,
+		const unsigned int socket_id, const void *key,
+		const efd_value_t value)
+{
+	uint32_t chunk_id, bin_id;
+	unsigned int i, key_pos = 0;
+	uint8_t bin_size = 0;
+	unsigned int found = 0;
+	void *slot_id = NULL;
+	uint32_t new_idx;
+
+	efd_compute_ids(table, key, &chunk_id, &bin_id);
+
+	struct efd_offline_chunk_rules * const chunk =
+			&table->offline_chunks[chunk_id];
+	uint8_t current_choice = efd_batch_get_choice(table, batch,
+			socket_id, chunk_id, bin_id);
+	uint32_t current_group_id = efd_bin_to_group[current_choice][bin_id];
+	struct efd_offline_group_rules * const current_group =
+			&chunk->group_rules[current_group_id];
+
+	for (i = 0; i < current_group->num_rules; i++) {
+		if (current_group->bin_id[i] != bin_id)
+			continue;
+		bin_size++;
+
+		if (found == 0 && memcmp(EFD_KEY(current_group->key_idx[i],
+				table), key, table->key_len) == 0) {
+			if (current_group->value[i] == value)
+				return 0;
+			key_pos = i;
+			found = 1;
+		}
+	}
+
+	if (found == 0) {
+		if (unlikely(current_group->num_rules >=
+				EFD_MAX_GROUP_NUM_RULES - 1))
+			return RTE_EFD_UPDATE_FAILED;
+
+		if (rte_ring_sc_dequeue(table->free_slots, &slot_id) != 0)
+			return RTE_EFD_UPDATE_FAILED;
+		new_idx = (uint32_t)((uintptr_t)slot_id);
+		batch->slots[batch->num_slots++] = new_idx;
+	}
+
+	efd_batch_save(table, batch,
+			EFD_GROUP_IDX(chunk_id, current_group_id));
+
+	if (found) {
+		current_group->value[key_pos] = value;
+	} else {
+		rte_memcpy(EFD_KEY(new_idx, table), key, table->key_len);
+		current_group->key_idx[current_group->num_rules] = new_idx;
+		current_group->value[current_group->num_rules] = value;
+		current_group->bin_id[current_group->num_rules] = bin_id;
+		current_group->num_rules++;
+		table->num_rules++;
+		bin_size++;
+	}
+
+	/* Rebalance the bin as the single update path does */
+	if (current_group->num_rules > EFD_MIN_BALANCED_NUM_RULES) {
+		uint8_t smallest_choice = current_choice;
+		uint32_t smallest_size = current_group->num_rules - bin_size;
+		uint32_t smallest_group_id = current_group_id;
+		unsigned char choice;
+
+		for (choice = 0; choice < EFD_CHUNK_NUM_BIN_TO_GROUP_SETS;
+				choice++) {
+			uint32_t test_group_id =
+					efd_bin_to_group[choice][bin_id];
+			uint32_t num_rules =
+					chunk->group_rules[test_group_id].num_rules;
+			if (num_rules < smallest_size) {
+				smallest_choice = choice;
+				smallest_size = num_rules;
+				smallest_group_id = test_group_id;
+			}
+		}
+
+		if (smallest_group_id != current_group_id &&
+				smallest_size + bin_size <=
+					EFD_MAX_GROUP_NUM_RULES) {
+			efd_batch_save(table, batch, EFD_GROUP_IDX(chunk_id,
+					smallest_group_id));
+			move_groups(bin_id, bin_size,
+					&chunk->group_rules[smallest_group_id],
+					current_group);
+			efd_batch_set_choice(batch, chunk_id, bin_id,
+					smallest_choice);
+			current_group_id = smallest_group_id;
+		}
+	}
+
+	efd_batch_mark_dirty(batch, EFD_GROUP_IDX(chunk_id, current_group_id));
+	return 0;
+}
+
+/*
+ * Search a perfect hash once for each group modified by the batch and
+ * apply them. If one search fails, the batch is reverted.
+ */
+static inline int
+efd_batch_commit(struct rte_efd_table * const table,
+		struct efd_update_batch * const batch,
+		const unsigned int socket_id)
+{
+	uint32_t i, chunk_id, group_id;
+
+	for (i = 0; i < batch->num_dirty; i++) {
+		chunk_id = batch->dirty_ids[i] / EFD_CHUNK_NUM_GROUPS;
+		group_id = batch->dirty_ids[i] % EFD_CHUNK_NUM_GROUPS;
+
+		batch->entries[i] =
+			table->chunks[socket_id][chunk_id].groups[group_id];
+		if (efd_search_hash(table,
+				efd_batch_group(table, batch->dirty_ids[i]),
+				&batch->entries[i],
+				&table->offline_chunks[chunk_id].group_stats[group_id])
+				!= 0) {
+			efd_batch_revert(table, batch);
+			return RTE_EFD_UPDATE_FAILED;
+		}
+	}
+
+	/* Publish the groups before the bins which moved into them */
+	for (i = 0; i < batch->num_dirty; i++)
+		efd_apply_group_entry(table,
+				batch->dirty_ids[i] / EFD_CHUNK_NUM_GROUPS,
+				batch->dirty_ids[i] % EFD_CHUNK_NUM_GROUPS,
+				&batch->entries[i]);
+	for (i = 0; i < batch->num_choices; i++)
+		efd_apply_bin_choice(table, socket_id,
+				batch->choice_chunk_ids[i],
+				batch->choice_bin_ids[i], batch->choices[i]);
+
+	return 0;
+}
+
+int
+rte_efd_update_bulk(struct rte_efd_table * const table,
+		const unsigned int socket_id, int num_keys,
+		const void **key_list, const efd_value_t *value_list,
+		int *status_list)
+{
+	struct efd_update_batch batch;
+	int i, j, n, num_failed = 0;
+	int status;
+
+	for (i = 0; i < num_keys; i += n) {
+		n = RTE_MIN(num_keys - i, RTE_EFD_BURST_MAX);
+
+		batch.num_rules = table->num_rules;
+		batch.num_saved = 0;
+		batch.num_dirty = 0;
+		batch.num_choices = 0;
+		batch.num_slots = 0;
+
+		status = 0;
+		for (j = 0; j < n && status == 0; j++)
+			status = efd_batch_add(table, &batch, socket_id,
+					key_list[i + j], value_list[i + j]);
+
+		if (status != 0)
+			efd_batch_revert(table, &batch);
+		else
+			status = efd_batch_commit(table, &batch, socket_id);
+
+		for (j = 0; j < n; j++) {
+			/* Fall back to the single update path */
+			if (status != 0)
+				status_list[i + j] = rte_efd_update(table,
+						socket_id, key_list[i + j],
+						value_list[i + j]);
+			else
+				status_list[i + j] = 0;
+
+			if (status_list[i + j] == RTE_EFD_UPDATE_FAILED)
+				num_failed++;
+		}
+	}
+
+	return num_failed;
+}
+
 int
 rte_efd_delete(struct rte_efd_table * const table, const unsigned int socket_id,
 		const void *key, efd_value_t * const prev_value)
@@ -1355,3 +1710,32 @@ void rte_efd_lookup_bulk(const struct rte_efd_table * const table,
 				table->lookup_fn);
 	}
 }
+
+uint32_t
+rte_efd_get_num_groups(const struct rte_efd_table * const table)
+{
+	return table->num_chunks * EFD_CHUNK_NUM_GROUPS;
+}
+
+int
+rte_efd_group_stats_get(const struct rte_efd_table * const table,
+		uint32_t group_idx, struct rte_efd_group_stats *stats)
+{
+	if (table == NULL || stats == NULL ||
+			group_idx >= rte_efd_get_num_groups(table))
+		return -EINVAL;
+
+	*stats = table->offline_chunks[group_idx / EFD_CHUNK_NUM_GROUPS]
+			.group_stats[group_idx % EFD_CHUNK_NUM_GROUPS];
+	return 0;
+}
+
+void
+rte_efd_group_stats_reset(struct rte_efd_table * const table)
+{
+	uint32_t i;
+
+	for (i = 0; i < table->num_chunks; i++)
+		memset(table->offline_chunks[i].group_stats, 0,
+			sizeof(table->offline_chunks[i].group_stats));
+}
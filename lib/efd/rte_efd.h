@@ -13,6 +13,8 @@
 
 #include <stdint.h>
 
+#include <rte_compat.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -200,6 +202,43 @@ int
 rte_efd_update(struct rte_efd_table *table, unsigned int socket_id,
 	const void *key, efd_value_t value);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Computes and applies updated table entries for several key/value pairs.
+ * The keys are processed by bursts of RTE_EFD_BURST_MAX: the offline table
+ * is first updated for all the keys of a burst, then a perfect hash is
+ * searched only once for each group modified by the burst.
+ * If the burst cannot be applied at once, for instance because a search
+ * fails or a group gets full, its keys are updated one at a time as with
+ * rte_efd_update().
+ * This operation is not multi-thread safe
+ * and should only be called from one thread.
+ *
+ * @param table
+ *   EFD table to reference
+ * @param socket_id
+ *   Socket ID to use to lookup existing value (ideally caller's socket id)
+ * @param num_keys
+ *   Number of keys in the key_list array
+ * @param key_list
+ *   Array of num_keys pointers which point to keys to modify
+ * @param value_list
+ *   Array of num_keys values to associate with the keys
+ * @param status_list
+ *   Array of num_keys where the status of each update, as returned by
+ *   rte_efd_update(), will be stored
+ *
+ * @return
+ *   Number of keys whose update returned RTE_EFD_UPDATE_FAILED
+ */
+__rte_experimental
+int
+rte_efd_update_bulk(struct rte_efd_table *table, unsigned int socket_id,
+		int num_keys, const void **key_list,
+		const efd_value_t *value_list, int *status_list);
+
 /**
  * Removes any value currently associated with the specified key from the table
  * This operation is not multi-thread safe
@@ -272,6 +311,71 @@ rte_efd_lookup_bulk(const struct rte_efd_table *table, unsigned int socket_id,
 		int num_keys, const void **key_list,
 		efd_value_t *value_list);
 
+/**
+ * Statistics of the perfect hash searches of an EFD group,
+ * done each time keys of the group are inserted or modified.
+ */
+struct rte_efd_group_stats {
+	uint64_t num_searches;
+	/**< Number of searches of a new perfect hash for the group. */
+	uint64_t num_retries;
+	/**< Number of hash functions tried and rejected by the searches. */
+	uint64_t num_failures;
+	/**< Number of searches which found no perfect hash. */
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Get the number of groups of the table, the groups being indexed
+ * from 0 to this number minus one by rte_efd_group_stats_get()
+ *
+ * @param table
+ *   EFD table to reference
+ *
+ * @return
+ *   Number of groups of the table
+ */
+__rte_experimental
+uint32_t
+rte_efd_get_num_groups(const struct rte_efd_table *table);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Get the perfect hash search statistics of a group. A high number of
+ * retries per search shows a group getting full, whose updates take long.
+ *
+ * @param table
+ *   EFD table to reference
+ * @param group_idx
+ *   Index of the group, lower than rte_efd_get_num_groups()
+ * @param stats
+ *   Pointer where the statistics of the group will be stored
+ *
+ * @return
+ *   0 on success, -EINVAL if a parameter is invalid
+ */
+__rte_experimental
+int
+rte_efd_group_stats_get(const struct rte_efd_table *table,
+		uint32_t group_idx, struct rte_efd_group_stats *stats);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Reset the perfect hash search statistics of all groups of the table
+ *
+ * @param table
+ *   EFD table to reference
+ */
+__rte_experimental
+void
+rte_efd_group_stats_reset(struct rte_efd_table *table);
+
 #ifdef __cplusplus
 }
 #endif
@@ -301,6 +301,11 @@ typedef void (*eth_txq_info_get_t)(struct rte_eth_dev *dev,
 typedef int (*eth_burst_mode_get_t)(struct rte_eth_dev *dev,
 	uint16_t queue_id, struct rte_eth_burst_mode *mode);
 
+typedef void (*eth_recycle_rxq_info_get_t)(struct rte_eth_dev *dev,
+	uint16_t rx_queue_id,
+	struct rte_eth_recycle_rxq_info *recycle_rxq_info);
+/**< @internal Get the mbuf ring of a Rx queue, to recycle Tx mbufs into. */
+
 typedef int (*mtu_set_t)(struct rte_eth_dev *dev, uint16_t mtu);
 /**< @internal Set MTU. */
 
@@ -828,6 +833,8 @@ struct eth_dev_ops {
 	eth_txq_info_get_t         txq_info_get; /**< retrieve TX queue information. */
 	eth_burst_mode_get_t       rx_burst_mode_get; /**< Get RX burst mode */
 	eth_burst_mode_get_t       tx_burst_mode_get; /**< Get TX burst mode */
+	eth_recycle_rxq_info_get_t recycle_rxq_info_get;
+	/**< Get Rx queue mbuf ring information, for mbufs recycling. */
 	eth_fw_version_get_t       fw_version_get; /**< Get firmware version. */
 	eth_dev_supported_ptypes_get_t dev_supported_ptypes_get;
 	/**< Get packet types supported and identified by device. */
@@ -1088,6 +1095,22 @@ int rte_eth_dev_callback_process(struct rte_eth_dev *dev,
 __rte_internal
 void rte_eth_dev_probing_finish(struct rte_eth_dev *dev);
 
+/**
+ * @internal
+ * Refresh the fast-path operations of a port from the burst functions
+ * currently set in its *rte_eth_dev* structure.
+ *
+ * The fast-path operations are fetched by rte_eth_dev_start() (or at the end
+ * of probing in a secondary process). A PMD replacing its burst functions
+ * afterwards, while the port is running, must call this function for
+ * the change to be seen by rte_eth_rx_burst() and rte_eth_tx_burst().
+ *
+ * @param dev
+ *  Pointer to struct rte_eth_dev.
+ */
+__rte_internal
+void rte_eth_fp_ops_update(struct rte_eth_dev *dev);
+
 /**
  * Create memzone for HW rings.
  * malloc can't be used as the physical address is needed.
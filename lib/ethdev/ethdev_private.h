@@ -30,6 +30,22 @@ eth_find_device(const struct rte_eth_dev *_start, rte_eth_cmp_t cmp,
 /* Parse devargs value for representor parameter. */
 int rte_eth_devargs_parse_representor_ports(char *str, void *data);
 
+/* Burst stats of the queues of a port. */
+struct eth_dev_burst_stats {
+	struct rte_eth_burst_stats *rxq; /* Rx queues stats, or NULL */
+	struct rte_eth_burst_stats *txq; /* Tx queues stats, or NULL */
+	bool enabled; /* Stats update enabled */
+};
+
+extern struct eth_dev_burst_stats eth_dev_burst_stats[RTE_MAX_ETHPORTS];
+
+/* Reset eth fast-path API to dummy values. */
+void eth_dev_fp_ops_reset(struct rte_eth_fp_ops *fpo);
+
+/* Setup eth fast-path API to ethdev values. */
+void eth_dev_fp_ops_setup(struct rte_eth_fp_ops *fpo,
+		const struct rte_eth_dev *dev);
+
 #ifdef __cplusplus
 }
 #endif
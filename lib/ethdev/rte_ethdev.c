@@ -44,6 +44,9 @@
 static const char *MZ_RTE_ETH_DEV_DATA = "rte_eth_dev_data";
 struct rte_eth_dev rte_eth_devices[RTE_MAX_ETHPORTS];
 
+/* public fast-path API */
+struct rte_eth_fp_ops rte_eth_fp_ops[RTE_MAX_ETHPORTS];
+
 /* spinlock for eth device callbacks */
 static rte_spinlock_t eth_dev_cb_lock = RTE_SPINLOCK_INITIALIZER;
 
@@ -527,6 +530,7 @@ rte_eth_dev_allocate(const char *name)
 	eth_dev->data->port_id = port_id;
 	eth_dev->data->mtu = RTE_ETHER_MTU;
 	pthread_mutex_init(&eth_dev->data->flow_ops_mutex, NULL);
+	eth_dev_fp_ops_reset(rte_eth_fp_ops + port_id);
 
 unlock:
 	rte_spinlock_unlock(&eth_dev_shared_data->ownership_lock);
@@ -581,6 +585,12 @@ rte_eth_dev_release_port(struct rte_eth_dev *eth_dev)
 
 	rte_spinlock_lock(&eth_dev_shared_data->ownership_lock);
 
+	eth_dev_fp_ops_reset(rte_eth_fp_ops + eth_dev->data->port_id);
+
+	rte_free(eth_dev_burst_stats[eth_dev->data->port_id].rxq);
+	memset(&eth_dev_burst_stats[eth_dev->data->port_id], 0,
+	       sizeof(eth_dev_burst_stats[0]));
+
 	eth_dev->state = RTE_ETH_DEV_UNUSED;
 	eth_dev->device = NULL;
 	eth_dev->process_private = NULL;
@@ -1792,6 +1802,9 @@ rte_eth_dev_start(uint16_t port_id)
 		(*dev->dev_ops->link_update)(dev, 0);
 	}
 
+	/* expose selection of PMD fast-path functions */
+	eth_dev_fp_ops_setup(rte_eth_fp_ops + port_id, dev);
+
 	rte_ethdev_trace_start(port_id);
 	return 0;
 }
@@ -1814,6 +1827,9 @@ rte_eth_dev_stop(uint16_t port_id)
 		return 0;
 	}
 
+	/* point fast-path functions to dummy ones */
+	eth_dev_fp_ops_reset(rte_eth_fp_ops + port_id);
+
 	dev->data->dev_started = 0;
 	ret = (*dev->dev_ops->dev_stop)(dev);
 	rte_ethdev_trace_stop(port_id, ret);
@@ -2096,6 +2112,14 @@ rte_eth_rx_queue_setup(uint16_t port_id, uint16_t rx_queue_id,
 			RTE_ETH_QUEUE_STATE_STOPPED))
 		return -EBUSY;
 
+	if (rx_conf != NULL && rx_conf->share_group > 0 &&
+		!(dev_info.dev_capa & RTE_ETH_DEV_CAPA_RXQ_SHARE)) {
+		RTE_ETHDEV_LOG(ERR,
+			"Ethdev port_id=%d rx_queue_id=%d, Rx queue sharing not supported\n",
+			port_id, rx_queue_id);
+		return -EINVAL;
+	}
+
 	rxq = dev->data->rx_queues;
 	if (rxq[rx_queue_id]) {
 		RTE_FUNC_PTR_OR_ERR_RET(*dev->dev_ops->rx_queue_release,
@@ -2300,6 +2324,23 @@ rte_eth_tx_queue_setup(uint16_t port_id, uint16_t tx_queue_id,
 			RTE_ETH_QUEUE_STATE_STOPPED))
 		return -EBUSY;
 
+	if (tx_conf != NULL && tx_conf->tx_doorbell_thresh > 0) {
+		if (!(dev_info.dev_capa &
+				RTE_ETH_DEV_CAPA_TX_DOORBELL_COALESCE)) {
+			RTE_ETHDEV_LOG(ERR,
+				"Ethdev port_id=%d tx_queue_id=%d, Tx doorbell coalescing not supported\n",
+				port_id, tx_queue_id);
+			return -EINVAL;
+		}
+		if (tx_conf->tx_doorbell_thresh >= nb_tx_desc) {
+			RTE_ETHDEV_LOG(ERR,
+				"Ethdev port_id=%d tx_queue_id=%d, Tx doorbell threshold %u must be lower than the number of descriptors %u\n",
+				port_id, tx_queue_id,
+				tx_conf->tx_doorbell_thresh, nb_tx_desc);
+			return -EINVAL;
+		}
+	}
+
 	txq = dev->data->tx_queues;
 	if (txq[tx_queue_id]) {
 		RTE_FUNC_PTR_OR_ERR_RET(*dev->dev_ops->tx_queue_release,
@@ -2826,6 +2867,20 @@ rte_eth_stats_reset(uint16_t port_id)
 	return 0;
 }
 
+/* Number of burst stats xstats, of the queues of a port */
+static unsigned int
+eth_dev_burst_stats_count(struct rte_eth_dev *dev)
+{
+	const struct eth_dev_burst_stats *bs =
+		&eth_dev_burst_stats[dev->data->port_id];
+
+	if (bs->rxq == NULL)
+		return 0;
+
+	return (dev->data->nb_rx_queues + dev->data->nb_tx_queues) *
+		(1 + RTE_ETH_BURST_STATS_NB_BUCKETS);
+}
+
 static inline int
 eth_dev_get_xstats_basic_count(struct rte_eth_dev *dev)
 {
@@ -2840,6 +2895,7 @@ eth_dev_get_xstats_basic_count(struct rte_eth_dev *dev)
 		count += nb_rxqs * RTE_NB_RXQ_STATS;
 		count += nb_txqs * RTE_NB_TXQ_STATS;
 	}
+	count += eth_dev_burst_stats_count(dev);
 
 	return count;
 }
@@ -2919,6 +2975,45 @@ rte_eth_xstats_get_id_by_name(uint16_t port_id, const char *xstat_name,
 	return -EINVAL;
 }
 
+/* retrieve burst stats names of the queues of one direction */
+static int
+eth_burst_stats_get_names(struct rte_eth_xstat_name *xstats_names,
+	const char *dir, uint16_t num_q)
+{
+	int cnt_used_entries = 0;
+	uint32_t idx, id_queue;
+	unsigned int min, max;
+
+	for (id_queue = 0; id_queue < num_q; id_queue++) {
+		snprintf(xstats_names[cnt_used_entries++].name,
+			sizeof(xstats_names[0].name),
+			"%s_q%u_empty_polls", dir, id_queue);
+
+		for (idx = 0; idx < RTE_ETH_BURST_STATS_NB_BUCKETS; idx++) {
+			min = 1u << idx;
+			max = (min << 1) - 1;
+			if (idx == RTE_ETH_BURST_STATS_NB_BUCKETS - 1)
+				snprintf(xstats_names[cnt_used_entries].name,
+					sizeof(xstats_names[0].name),
+					"%s_q%u_bursts_%u_plus",
+					dir, id_queue, min);
+			else if (min == max)
+				snprintf(xstats_names[cnt_used_entries].name,
+					sizeof(xstats_names[0].name),
+					"%s_q%u_bursts_%u",
+					dir, id_queue, min);
+			else
+				snprintf(xstats_names[cnt_used_entries].name,
+					sizeof(xstats_names[0].name),
+					"%s_q%u_bursts_%u_%u",
+					dir, id_queue, min, max);
+			cnt_used_entries++;
+		}
+	}
+
+	return cnt_used_entries;
+}
+
 /* retrieve basic stats names */
 static int
 eth_basic_stats_get_names(struct rte_eth_dev *dev,
@@ -2935,6 +3030,15 @@ eth_basic_stats_get_names(struct rte_eth_dev *dev,
 		cnt_used_entries++;
 	}
 
+	if (eth_dev_burst_stats_count(dev) != 0) {
+		cnt_used_entries += eth_burst_stats_get_names(
+			xstats_names + cnt_used_entries, "rx",
+			dev->data->nb_rx_queues);
+		cnt_used_entries += eth_burst_stats_get_names(
+			xstats_names + cnt_used_entries, "tx",
+			dev->data->nb_tx_queues);
+	}
+
 	if ((dev->data->dev_flags & RTE_ETH_DEV_AUTOFILL_QUEUE_XSTATS) == 0)
 		return cnt_used_entries;
 
@@ -3107,6 +3211,21 @@ rte_eth_xstats_get_names(uint16_t port_id,
 	return cnt_used_entries;
 }
 
+/* retrieve burst stats of the queues of one direction */
+static unsigned int
+eth_burst_stats_get(struct rte_eth_xstat *xstats,
+	const struct rte_eth_burst_stats *bs, uint16_t num_q)
+{
+	unsigned int count = 0, i, q;
+
+	for (q = 0; q < num_q; q++) {
+		xstats[count++].value = bs[q].empty;
+		for (i = 0; i < RTE_ETH_BURST_STATS_NB_BUCKETS; i++)
+			xstats[count++].value = bs[q].hist[i];
+	}
+
+	return count;
+}
 
 static int
 eth_basic_stats_get(uint16_t port_id, struct rte_eth_xstat *xstats)
@@ -3135,6 +3254,16 @@ eth_basic_stats_get(uint16_t port_id, struct rte_eth_xstat *xstats)
 		xstats[count++].value = val;
 	}
 
+	/* per-queue burst stats */
+	if (eth_dev_burst_stats_count(dev) != 0) {
+		count += eth_burst_stats_get(xstats + count,
+				eth_dev_burst_stats[port_id].rxq,
+				dev->data->nb_rx_queues);
+		count += eth_burst_stats_get(xstats + count,
+				eth_dev_burst_stats[port_id].txq,
+				dev->data->nb_tx_queues);
+	}
+
 	if ((dev->data->dev_flags & RTE_ETH_DEV_AUTOFILL_QUEUE_XSTATS) == 0)
 		return count;
 
@@ -3263,19 +3392,13 @@ rte_eth_xstats_get(uint16_t port_id, struct rte_eth_xstat *xstats,
 	struct rte_eth_dev *dev;
 	unsigned int count = 0, i;
 	signed int xcount = 0;
-	uint16_t nb_rxqs, nb_txqs;
 	int ret;
 
 	RTE_ETH_VALID_PORTID_OR_ERR_RET(port_id, -ENODEV);
 	dev = &rte_eth_devices[port_id];
 
-	nb_rxqs = RTE_MIN(dev->data->nb_rx_queues, RTE_ETHDEV_QUEUE_STAT_CNTRS);
-	nb_txqs = RTE_MIN(dev->data->nb_tx_queues, RTE_ETHDEV_QUEUE_STAT_CNTRS);
-
 	/* Return generic statistics */
-	count = RTE_NB_STATS;
-	if (dev->data->dev_flags & RTE_ETH_DEV_AUTOFILL_QUEUE_XSTATS)
-		count += (nb_rxqs * RTE_NB_RXQ_STATS) + (nb_txqs * RTE_NB_TXQ_STATS);
+	count = eth_dev_get_xstats_basic_count(dev);
 
 	/* implemented by the driver */
 	if (dev->dev_ops->xstats_get != NULL) {
@@ -3308,6 +3431,16 @@ rte_eth_xstats_get(uint16_t port_id, struct rte_eth_xstat *xstats,
 	return count + xcount;
 }
 
+static void
+eth_dev_burst_stats_reset(uint16_t port_id)
+{
+	struct eth_dev_burst_stats *bs = &eth_dev_burst_stats[port_id];
+
+	if (bs->rxq != NULL)
+		memset(bs->rxq, 0, 2 * RTE_MAX_QUEUES_PER_PORT *
+		       sizeof(bs->rxq[0]));
+}
+
 /* reset ethdev extended statistics */
 int
 rte_eth_xstats_reset(uint16_t port_id)
@@ -3317,6 +3450,8 @@ rte_eth_xstats_reset(uint16_t port_id)
 	RTE_ETH_VALID_PORTID_OR_ERR_RET(port_id, -ENODEV);
 	dev = &rte_eth_devices[port_id];
 
+	eth_dev_burst_stats_reset(port_id);
+
 	/* implemented by the driver */
 	if (dev->dev_ops->xstats_reset != NULL)
 		return eth_err(port_id, (*dev->dev_ops->xstats_reset)(dev));
@@ -3325,6 +3460,47 @@ rte_eth_xstats_reset(uint16_t port_id)
 	return rte_eth_stats_reset(port_id);
 }
 
+int
+rte_eth_burst_stats_enable(uint16_t port_id)
+{
+	struct eth_dev_burst_stats *bs;
+	struct rte_eth_dev *dev;
+
+	RTE_ETH_VALID_PORTID_OR_ERR_RET(port_id, -ENODEV);
+	dev = &rte_eth_devices[port_id];
+	bs = &eth_dev_burst_stats[port_id];
+
+	if (bs->enabled)
+		return 0;
+
+	/* Allocated for all the queues, not to depend on the configuration */
+	if (bs->rxq == NULL) {
+		bs->rxq = rte_zmalloc_socket("ethdev_burst_stats",
+				2 * RTE_MAX_QUEUES_PER_PORT * sizeof(bs->rxq[0]),
+				RTE_CACHE_LINE_SIZE, dev->data->numa_node);
+		if (bs->rxq == NULL)
+			return -ENOMEM;
+		bs->txq = bs->rxq + RTE_MAX_QUEUES_PER_PORT;
+	}
+
+	bs->enabled = true;
+	rte_eth_fp_ops_update(dev);
+
+	return 0;
+}
+
+int
+rte_eth_burst_stats_disable(uint16_t port_id)
+{
+	RTE_ETH_VALID_PORTID_OR_ERR_RET(port_id, -ENODEV);
+
+	eth_dev_burst_stats[port_id].enabled = false;
+	rte_eth_fp_ops[port_id].rx_burst_stats = NULL;
+	rte_eth_fp_ops[port_id].tx_burst_stats = NULL;
+
+	return 0;
+}
+
 static int
 eth_dev_set_queue_stats_mapping(uint16_t port_id, uint16_t queue_id,
 		uint8_t stat_idx, uint8_t is_rx)
@@ -4740,11 +4916,33 @@ rte_eth_dev_probing_finish(struct rte_eth_dev *dev)
 	if (dev == NULL)
 		return;
 
+	/*
+	 * for secondary process, at that point we expect device
+	 * to be already 'usable', so shared data and all function pointers
+	 * for fast-path devops have to be setup properly inside rte_eth_dev.
+	 */
+	if (rte_eal_process_type() == RTE_PROC_SECONDARY)
+		eth_dev_fp_ops_setup(rte_eth_fp_ops + dev->data->port_id, dev);
+
 	rte_eth_dev_callback_process(dev, RTE_ETH_EVENT_NEW, NULL);
 
 	dev->state = RTE_ETH_DEV_ATTACHED;
 }
 
+void
+rte_eth_fp_ops_update(struct rte_eth_dev *dev)
+{
+	if (dev == NULL)
+		return;
+
+	/* a stopped port keeps the dummy functions in the primary process */
+	if (rte_eal_process_type() == RTE_PROC_PRIMARY &&
+	    dev->data->dev_started == 0)
+		return;
+
+	eth_dev_fp_ops_setup(rte_eth_fp_ops + dev->data->port_id, dev);
+}
+
 int
 rte_eth_dev_rx_intr_ctl(uint16_t port_id, int epfd, int op, void *data)
 {
@@ -5043,6 +5241,100 @@ rte_eth_dev_rx_intr_disable(uint16_t port_id,
 	return eth_err(port_id, (*dev->dev_ops->rx_queue_intr_disable)(dev, queue_id));
 }
 
+/* The event data of a queue is its identifier, offset to be non NULL. */
+static inline void *
+eth_rxq_id_to_data(const struct rte_eth_rxq_id *q)
+{
+	return (void *)(((uintptr_t)q->port_id << 16 | q->queue_id) + 1);
+}
+
+static inline void
+eth_rxq_id_from_data(struct rte_eth_rxq_id *q, void *data)
+{
+	uintptr_t id = (uintptr_t)data - 1;
+
+	q->port_id = id >> 16;
+	q->queue_id = id & UINT16_MAX;
+}
+
+uint16_t
+rte_eth_dev_rx_intr_ctl_q_bulk(const struct rte_eth_rxq_id *queues,
+		uint16_t nb_queues, int epfd, int op)
+{
+	uint16_t i;
+
+	for (i = 0; i < nb_queues; i++) {
+		if (rte_eth_dev_rx_intr_ctl_q(queues[i].port_id,
+				queues[i].queue_id, epfd, op,
+				eth_rxq_id_to_data(&queues[i])) != 0)
+			break;
+	}
+	return i;
+}
+
+#define ETH_RX_INTR_WAIT_BURST 32
+
+int
+rte_eth_dev_rx_intr_wait(int epfd, struct rte_eth_rxq_id *queues,
+		uint16_t nb_queues, int timeout)
+{
+	struct rte_epoll_event events[ETH_RX_INTR_WAIT_BURST];
+	int nb_ready = 0;
+	int i, n;
+
+	if (queues == NULL || nb_queues == 0) {
+		rte_errno = EINVAL;
+		return -1;
+	}
+
+	/*
+	 * Only the first wait may block, the next ones collect the other
+	 * ready queues.
+	 */
+	do {
+		n = rte_epoll_wait(epfd, events,
+				RTE_MIN(nb_queues - nb_ready,
+					ETH_RX_INTR_WAIT_BURST),
+				nb_ready == 0 ? timeout : 0);
+		if (n < 0)
+			return nb_ready > 0 ? nb_ready : -1;
+		for (i = 0; i < n; i++)
+			eth_rxq_id_from_data(&queues[nb_ready + i],
+					events[i].epdata.data);
+		nb_ready += n;
+	} while (n == ETH_RX_INTR_WAIT_BURST && nb_ready < nb_queues);
+
+	return nb_ready;
+}
+
+uint16_t
+rte_eth_dev_rx_intr_enable_bulk(const struct rte_eth_rxq_id *queues,
+		uint16_t nb_queues)
+{
+	uint16_t i;
+
+	for (i = 0; i < nb_queues; i++) {
+		if (rte_eth_dev_rx_intr_enable(queues[i].port_id,
+				queues[i].queue_id) != 0)
+			break;
+	}
+	return i;
+}
+
+uint16_t
+rte_eth_dev_rx_intr_disable_bulk(const struct rte_eth_rxq_id *queues,
+		uint16_t nb_queues)
+{
+	uint16_t i;
+
+	for (i = 0; i < nb_queues; i++) {
+		if (rte_eth_dev_rx_intr_disable(queues[i].port_id,
+				queues[i].queue_id) != 0)
+			break;
+	}
+	return i;
+}
+
 
 const struct rte_eth_rxtx_callback *
 rte_eth_add_rx_callback(uint16_t port_id, uint16_t queue_id,
@@ -5233,6 +5525,67 @@ rte_eth_remove_rx_callback(uint16_t port_id, uint16_t queue_id,
 	return ret;
 }
 
+static uint16_t
+eth_lcore_usage_rx_cb(uint16_t port_id __rte_unused,
+		uint16_t queue_id __rte_unused,
+		struct rte_mbuf **pkts __rte_unused, uint16_t nb_rx,
+		uint16_t max_pkts __rte_unused, void *arg __rte_unused)
+{
+	rte_lcore_usage_poll(nb_rx);
+	return nb_rx;
+}
+
+/* Lcore usage callback of a Rx queue, NULL if none. */
+static struct rte_eth_rxtx_callback *
+eth_lcore_usage_rx_cb_find(uint16_t port_id, uint16_t queue_id)
+{
+	struct rte_eth_rxtx_callback *cb;
+
+	rte_spinlock_lock(&eth_dev_rx_cb_lock);
+	for (cb = rte_eth_devices[port_id].post_rx_burst_cbs[queue_id];
+			cb != NULL; cb = cb->next)
+		if (cb->fn.rx == eth_lcore_usage_rx_cb)
+			break;
+	rte_spinlock_unlock(&eth_dev_rx_cb_lock);
+
+	return cb;
+}
+
+int
+rte_eth_rx_lcore_usage_enable(uint16_t port_id, uint16_t queue_id)
+{
+#ifndef RTE_ETHDEV_RXTX_CALLBACKS
+	return -ENOTSUP;
+#endif
+	RTE_ETH_VALID_PORTID_OR_ERR_RET(port_id, -ENODEV);
+	if (queue_id >= rte_eth_devices[port_id].data->nb_rx_queues)
+		return -EINVAL;
+
+	if (eth_lcore_usage_rx_cb_find(port_id, queue_id) != NULL)
+		return -EEXIST;
+
+	if (rte_eth_add_rx_callback(port_id, queue_id, eth_lcore_usage_rx_cb,
+			NULL) == NULL)
+		return -rte_errno;
+
+	return 0;
+}
+
+int
+rte_eth_rx_lcore_usage_disable(uint16_t port_id, uint16_t queue_id)
+{
+#ifndef RTE_ETHDEV_RXTX_CALLBACKS
+	return -ENOTSUP;
+#endif
+	RTE_ETH_VALID_PORTID_OR_ERR_RET(port_id, -ENODEV);
+	if (queue_id >= rte_eth_devices[port_id].data->nb_rx_queues)
+		return -EINVAL;
+
+	/* The callback may still be in use, it is not freed */
+	return rte_eth_remove_rx_callback(port_id, queue_id,
+			eth_lcore_usage_rx_cb_find(port_id, queue_id));
+}
+
 int
 rte_eth_remove_tx_callback(uint16_t port_id, uint16_t queue_id,
 		const struct rte_eth_rxtx_callback *user_cb)
@@ -5357,6 +5710,54 @@ rte_eth_tx_queue_info_get(uint16_t port_id, uint16_t queue_id,
 	return 0;
 }
 
+int
+rte_eth_recycle_rx_queue_info_get(uint16_t port_id, uint16_t queue_id,
+	struct rte_eth_recycle_rxq_info *recycle_rxq_info)
+{
+	struct rte_eth_dev *dev;
+
+	RTE_ETH_VALID_PORTID_OR_ERR_RET(port_id, -ENODEV);
+	dev = &rte_eth_devices[port_id];
+
+	if (queue_id >= dev->data->nb_rx_queues) {
+		RTE_ETHDEV_LOG(ERR, "Invalid RX queue_id=%u\n", queue_id);
+		return -EINVAL;
+	}
+
+	if (recycle_rxq_info == NULL) {
+		RTE_ETHDEV_LOG(ERR,
+			"Cannot get ethdev port %u Rx queue %u recycle info to NULL\n",
+			port_id, queue_id);
+		return -EINVAL;
+	}
+
+	if (dev->data->rx_queues == NULL ||
+			dev->data->rx_queues[queue_id] == NULL) {
+		RTE_ETHDEV_LOG(ERR,
+			       "Rx queue %"PRIu16" of device with port_id=%"
+			       PRIu16" has not been setup\n",
+			       queue_id, port_id);
+		return -EINVAL;
+	}
+
+	if (rte_eth_dev_is_rx_hairpin_queue(dev, queue_id)) {
+		RTE_ETHDEV_LOG(INFO,
+			"Can't recycle mbufs to hairpin Rx queue %"PRIu16" of device with port_id=%"PRIu16"\n",
+			queue_id, port_id);
+		return -EINVAL;
+	}
+
+	/* the support depends on the Rx function selected at start */
+	RTE_FUNC_PTR_OR_ERR_RET(*dev->dev_ops->recycle_rxq_info_get, -ENOTSUP);
+	if (dev->recycle_rx_descriptors_refill == NULL)
+		return -ENOTSUP;
+
+	memset(recycle_rxq_info, 0, sizeof(*recycle_rxq_info));
+	dev->dev_ops->recycle_rxq_info_get(dev, queue_id, recycle_rxq_info);
+
+	return 0;
+}
+
 int
 rte_eth_rx_burst_mode_get(uint16_t port_id, uint16_t queue_id,
 			  struct rte_eth_burst_mode *mode)
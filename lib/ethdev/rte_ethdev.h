@@ -1047,6 +1047,16 @@ struct rte_eth_rxconf {
 	uint8_t rx_drop_en; /**< Drop packets if no descriptors are available. */
 	uint8_t rx_deferred_start; /**< Do not start queue with rte_eth_dev_start(). */
 	uint16_t rx_nseg; /**< Number of descriptions in rx_seg array. */
+	/**
+	 * Share group of the queue, 0 to not share it. The queues set up with
+	 * the same non-zero share group and share_qid on ports of the same
+	 * switch domain are a single shared Rx queue: polling it on any of
+	 * these ports returns the packets of all of them, with mbuf->port set
+	 * to the port the packet was received on.
+	 * Requires the RTE_ETH_DEV_CAPA_RXQ_SHARE capability.
+	 */
+	uint16_t share_group;
+	uint16_t share_qid; /**< Shared Rx queue ID in the share group. */
 	/**
 	 * Per-queue Rx offloads to be set using DEV_RX_OFFLOAD_* flags.
 	 * Only offloads set on rx_queue_offload_capa or rx_offload_capa
@@ -1076,6 +1086,17 @@ struct rte_eth_txconf {
 				      less free descriptors than this value. */
 
 	uint8_t tx_deferred_start; /**< Do not start queue with rte_eth_dev_start(). */
+	/**
+	 * Number of descriptors to queue before writing the Tx tail register,
+	 * 0 to write it on each burst. The pending descriptors are also
+	 * handed to the device once tx_doorbell_tmo_us elapsed since the
+	 * first of them, checked on the next burst, or explicitly with
+	 * rte_eth_tx_doorbell_flush().
+	 * Requires the RTE_ETH_DEV_CAPA_TX_DOORBELL_COALESCE capability.
+	 */
+	uint16_t tx_doorbell_thresh;
+	/** Max delay of the pending descriptors in us, 0 for no limit. */
+	uint32_t tx_doorbell_tmo_us;
 	/**
 	 * Per-queue Tx offloads to be set  using DEV_TX_OFFLOAD_* flags.
 	 * Only offloads set on tx_queue_offload_capa or tx_offload_capa
@@ -1448,6 +1469,16 @@ struct rte_eth_conf {
 #define RTE_ETH_DEV_CAPA_RUNTIME_RX_QUEUE_SETUP 0x00000001
 /** Device supports Tx queue setup after device started. */
 #define RTE_ETH_DEV_CAPA_RUNTIME_TX_QUEUE_SETUP 0x00000002
+/**
+ * Device supports Rx queues shared by the ports of a switch domain,
+ * see rte_eth_rxconf.share_group.
+ */
+#define RTE_ETH_DEV_CAPA_RXQ_SHARE 0x00000004
+/**
+ * Device supports deferring the Tx tail register writes,
+ * see rte_eth_txconf.tx_doorbell_thresh.
+ */
+#define RTE_ETH_DEV_CAPA_TX_DOORBELL_COALESCE 0x00000008
 /**@}*/
 
 /*
@@ -1617,6 +1648,27 @@ struct rte_eth_txq_info {
 	uint8_t queue_state;        /**< one of RTE_ETH_QUEUE_STATE_*. */
 } __rte_cache_min_aligned;
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this structure may change without prior notice.
+ *
+ * Ethernet device Rx queue information used to recycle mbufs,
+ * retrieved by rte_eth_recycle_rx_queue_info_get() and given to
+ * rte_eth_recycle_mbufs().
+ */
+struct rte_eth_recycle_rxq_info {
+	struct rte_mbuf **mbuf_ring; /**< mbuf ring of the Rx queue. */
+	struct rte_mempool *mp;     /**< mempool of the Rx queue. */
+	uint16_t *refill_head;      /**< Next mbuf ring entry to refill. */
+	uint16_t *receive_tail;     /**< Next mbuf ring entry to receive. */
+	uint16_t mbuf_ring_size;    /**< Number of entries of the mbuf ring. */
+	/**
+	 * Number of mbufs the Rx queue must be refilled with at once,
+	 * 0 if any number is accepted.
+	 */
+	uint16_t refill_requirement;
+} __rte_cache_min_aligned;
+
 /* Generic Burst mode flag definition, values can be ORed. */
 
 /**
@@ -2955,6 +3007,47 @@ int rte_eth_xstats_get_id_by_name(uint16_t port_id, const char *xstat_name,
  */
 int rte_eth_xstats_reset(uint16_t port_id);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change, or be removed, without prior notice
+ *
+ * Enable the burst stats of the queues of an Ethernet device.
+ *
+ * rte_eth_rx_burst() and rte_eth_tx_burst() then count the bursts of each
+ * queue without any packet, and the other bursts in a histogram of their
+ * size, in buckets of powers of two. They are reported by the extended
+ * statistics as ``rx_q<n>_empty_polls`` and ``rx_q<n>_bursts_<min>_<max>``
+ * for the Rx queues and likewise for the Tx queues, and reset by
+ * rte_eth_xstats_reset(). The burst stats are local to the process.
+ *
+ * @param port_id
+ *   The port identifier of the Ethernet device.
+ * @return
+ *   - (0) on success.
+ *   - (-ENODEV) if *port_id* invalid.
+ *   - (-ENOMEM) if the stats cannot be allocated.
+ */
+__rte_experimental
+int rte_eth_burst_stats_enable(uint16_t port_id);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change, or be removed, without prior notice
+ *
+ * Disable the burst stats of the queues of an Ethernet device.
+ *
+ * The burst stats already gathered are still reported by the extended
+ * statistics.
+ *
+ * @param port_id
+ *   The port identifier of the Ethernet device.
+ * @return
+ *   - (0) on success.
+ *   - (-ENODEV) if *port_id* invalid.
+ */
+__rte_experimental
+int rte_eth_burst_stats_disable(uint16_t port_id);
+
 /**
  *  Set a mapping for the specified transmit queue to the specified per-queue
  *  statistics counter.
@@ -3667,6 +3760,110 @@ __rte_experimental
 int
 rte_eth_dev_rx_intr_ctl_q_get_fd(uint16_t port_id, uint16_t queue_id);
 
+/**
+ * An Rx queue of a port, as handled by the bulk Rx interrupt functions.
+ */
+struct rte_eth_rxq_id {
+	uint16_t port_id;  /**< Port identifier. */
+	uint16_t queue_id; /**< Rx queue index. */
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Add or delete the interrupts of many Rx queues to an epoll instance,
+ * to wait for them with rte_eth_dev_rx_intr_wait().
+ *
+ * The epoll instance must be used for the queues added with this function
+ * only, as their event data identifies them.
+ *
+ * @param queues
+ *   The Rx queues.
+ * @param nb_queues
+ *   The number of Rx queues.
+ * @param epfd
+ *   Epoll instance fd, or RTE_EPOLL_PER_THREAD for the per thread instance.
+ * @param op
+ *   RTE_INTR_EVENT_ADD or RTE_INTR_EVENT_DEL.
+ * @return
+ *   The number of queues processed. If less than nb_queues, the operation
+ *   failed for the next queue.
+ */
+__rte_experimental
+uint16_t
+rte_eth_dev_rx_intr_ctl_q_bulk(const struct rte_eth_rxq_id *queues,
+		uint16_t nb_queues, int epfd, int op);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Wait for the interrupts of the Rx queues added to an epoll instance with
+ * rte_eth_dev_rx_intr_ctl_q_bulk(), and return the ready queues at once.
+ *
+ * The interrupts of the ready queues are still enabled, they are
+ * usually disabled with rte_eth_dev_rx_intr_disable_bulk() before polling.
+ *
+ * @param epfd
+ *   Epoll instance fd, or RTE_EPOLL_PER_THREAD for the per thread instance.
+ * @param queues
+ *   Array of at least nb_queues elements, filled with the ready queues.
+ * @param nb_queues
+ *   The maximum number of ready queues to return.
+ * @param timeout
+ *   The maximum time to wait in milliseconds, -1 to wait indefinitely.
+ * @return
+ *   - (>=0) the number of ready queues, 0 on timeout.
+ *   - (-1) on error.
+ */
+__rte_experimental
+int
+rte_eth_dev_rx_intr_wait(int epfd, struct rte_eth_rxq_id *queues,
+		uint16_t nb_queues, int timeout);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Enable the interrupts of many Rx queues, before waiting for them.
+ *
+ * A packet received after the last poll of a queue and before its
+ * interrupt is enabled may not raise an interrupt, so the queues are
+ * usually polled once more after this call.
+ *
+ * @param queues
+ *   The Rx queues.
+ * @param nb_queues
+ *   The number of Rx queues.
+ * @return
+ *   The number of queues processed. If less than nb_queues, the operation
+ *   failed for the next queue.
+ */
+__rte_experimental
+uint16_t
+rte_eth_dev_rx_intr_enable_bulk(const struct rte_eth_rxq_id *queues,
+		uint16_t nb_queues);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Disable the interrupts of many Rx queues, to poll them.
+ *
+ * @param queues
+ *   The Rx queues.
+ * @param nb_queues
+ *   The number of Rx queues.
+ * @return
+ *   The number of queues processed. If less than nb_queues, the operation
+ *   failed for the next queue.
+ */
+__rte_experimental
+uint16_t
+rte_eth_dev_rx_intr_disable_bulk(const struct rte_eth_rxq_id *queues,
+		uint16_t nb_queues);
+
 /**
  * Turn on the LED on the Ethernet device.
  * This function turns on the LED on the Ethernet device.
@@ -4299,6 +4496,50 @@ int rte_eth_remove_rx_callback(uint16_t port_id, uint16_t queue_id,
 int rte_eth_remove_tx_callback(uint16_t port_id, uint16_t queue_id,
 		const struct rte_eth_rxtx_callback *user_cb);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change, or be removed, without prior notice
+ *
+ * Account the usage of the lcores polling a Rx queue: each Rx burst of the
+ * queue reports an idle poll, or a busy poll when it returns packets, with
+ * rte_lcore_usage_poll(). This adds a Rx callback to the queue.
+ *
+ * @param port_id
+ *   The port identifier of the Ethernet device.
+ * @param queue_id
+ *   The Rx queue.
+ * @return
+ *   - 0: Success.
+ *   - -ENODEV:  If *port_id* is invalid.
+ *   - -ENOTSUP: Callback support is not available.
+ *   - -EINVAL:  The queue_id is out of range.
+ *   - -EEXIST:  The usage is already accounted for the queue.
+ *   - -ENOMEM:  The callback cannot be allocated.
+ */
+__rte_experimental
+int rte_eth_rx_lcore_usage_enable(uint16_t port_id, uint16_t queue_id);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change, or be removed, without prior notice
+ *
+ * Stop accounting the usage of the lcores polling a Rx queue. As for
+ * rte_eth_remove_rx_callback(), the memory of the Rx callback is not freed.
+ *
+ * @param port_id
+ *   The port identifier of the Ethernet device.
+ * @param queue_id
+ *   The Rx queue.
+ * @return
+ *   - 0: Success.
+ *   - -ENODEV:  If *port_id* is invalid.
+ *   - -ENOTSUP: Callback support is not available.
+ *   - -EINVAL:  The queue_id is out of range, or the usage is not accounted
+ *               for the queue.
+ */
+__rte_experimental
+int rte_eth_rx_lcore_usage_disable(uint16_t port_id, uint16_t queue_id);
+
 /**
  * Retrieve information about given port's RX queue.
  *
@@ -4343,6 +4584,34 @@ int rte_eth_rx_queue_info_get(uint16_t port_id, uint16_t queue_id,
 int rte_eth_tx_queue_info_get(uint16_t port_id, uint16_t queue_id,
 	struct rte_eth_txq_info *qinfo);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Retrieve information about given port's Rx queue, to recycle the mbufs
+ * freed by a Tx queue into it with rte_eth_recycle_mbufs().
+ * The port must be started, as the support depends on the selected
+ * Rx function.
+ *
+ * @param port_id
+ *   The port identifier of the Ethernet device.
+ * @param queue_id
+ *   The Rx queue on the Ethernet device for which information
+ *   will be retrieved.
+ * @param recycle_rxq_info
+ *   A pointer to a structure of type *rte_eth_recycle_rxq_info* to be filled.
+ *
+ * @return
+ *   - 0: Success
+ *   - -ENODEV:  If *port_id* is invalid.
+ *   - -ENOTSUP: routine is not supported by the device PMD, or by its
+ *               selected Rx function.
+ *   - -EINVAL:  The queue_id is out of range.
+ */
+__rte_experimental
+int rte_eth_recycle_rx_queue_info_get(uint16_t port_id, uint16_t queue_id,
+	struct rte_eth_recycle_rxq_info *recycle_rxq_info);
+
 /**
  * Retrieve information about the Rx packet burst mode.
  *
@@ -4883,6 +5152,25 @@ int rte_eth_representor_info_get(uint16_t port_id,
 
 #include <rte_ethdev_core.h>
 
+/**
+ * @internal
+ * Account a burst in the burst stats of a queue.
+ *
+ * @param bs
+ *  Burst stats of the queue.
+ * @param nb_pkts
+ *  Number of packets of the burst.
+ */
+static __rte_always_inline void
+__rte_eth_burst_stats_update(struct rte_eth_burst_stats *bs, uint16_t nb_pkts)
+{
+	if (nb_pkts == 0)
+		bs->empty++;
+	else
+		bs->hist[RTE_MIN(rte_fls_u32(nb_pkts) - 1,
+				 RTE_ETH_BURST_STATS_NB_BUCKETS - 1)]++;
+}
+
 /**
  *
  * Retrieve a burst of input packets from a receive queue of an Ethernet
@@ -4974,20 +5262,23 @@ static inline uint16_t
 rte_eth_rx_burst(uint16_t port_id, uint16_t queue_id,
 		 struct rte_mbuf **rx_pkts, const uint16_t nb_pkts)
 {
-	struct rte_eth_dev *dev = &rte_eth_devices[port_id];
+	const struct rte_eth_fp_ops *p = &rte_eth_fp_ops[port_id];
 	uint16_t nb_rx;
 
 #ifdef RTE_ETHDEV_DEBUG_RX
 	RTE_ETH_VALID_PORTID_OR_ERR_RET(port_id, 0);
-	RTE_FUNC_PTR_OR_ERR_RET(*dev->rx_pkt_burst, 0);
+	RTE_FUNC_PTR_OR_ERR_RET(*p->rx_pkt_burst, 0);
 
-	if (queue_id >= dev->data->nb_rx_queues) {
+	if (queue_id >= rte_eth_devices[port_id].data->nb_rx_queues) {
 		RTE_ETHDEV_LOG(ERR, "Invalid RX queue_id=%u\n", queue_id);
 		return 0;
 	}
 #endif
-	nb_rx = (*dev->rx_pkt_burst)(dev->data->rx_queues[queue_id],
-				     rx_pkts, nb_pkts);
+	nb_rx = (*p->rx_pkt_burst)(p->rxq.data[queue_id], rx_pkts, nb_pkts);
+
+	if (unlikely(p->rx_burst_stats != NULL))
+		__rte_eth_burst_stats_update(&p->rx_burst_stats[queue_id],
+					     nb_rx);
 
 #ifdef RTE_ETHDEV_RXTX_CALLBACKS
 	struct rte_eth_rxtx_callback *cb;
@@ -4998,8 +5289,8 @@ rte_eth_rx_burst(uint16_t port_id, uint16_t queue_id,
 	 * cb and cb->fn/cb->next, __ATOMIC_ACQUIRE memory order is
 	 * not required.
 	 */
-	cb = __atomic_load_n(&dev->post_rx_burst_cbs[queue_id],
-				__ATOMIC_RELAXED);
+	cb = __atomic_load_n((struct rte_eth_rxtx_callback **)
+				&p->rxq.clbk[queue_id], __ATOMIC_RELAXED);
 
 	if (unlikely(cb != NULL)) {
 		do {
@@ -5108,21 +5399,19 @@ static inline int
 rte_eth_rx_descriptor_status(uint16_t port_id, uint16_t queue_id,
 	uint16_t offset)
 {
-	struct rte_eth_dev *dev;
+	const struct rte_eth_fp_ops *p;
 	void *rxq;
 
 #ifdef RTE_ETHDEV_DEBUG_RX
 	RTE_ETH_VALID_PORTID_OR_ERR_RET(port_id, -ENODEV);
-#endif
-	dev = &rte_eth_devices[port_id];
-#ifdef RTE_ETHDEV_DEBUG_RX
-	if (queue_id >= dev->data->nb_rx_queues)
+	if (queue_id >= rte_eth_devices[port_id].data->nb_rx_queues)
 		return -ENODEV;
 #endif
-	RTE_FUNC_PTR_OR_ERR_RET(*dev->rx_descriptor_status, -ENOTSUP);
-	rxq = dev->data->rx_queues[queue_id];
+	p = &rte_eth_fp_ops[port_id];
+	RTE_FUNC_PTR_OR_ERR_RET(*p->rx_descriptor_status, -ENOTSUP);
+	rxq = p->rxq.data[queue_id];
 
-	return (*dev->rx_descriptor_status)(rxq, offset);
+	return (*p->rx_descriptor_status)(rxq, offset);
 }
 
 #define RTE_ETH_TX_DESC_FULL    0 /**< Desc filled for hw, waiting xmit. */
@@ -5165,21 +5454,19 @@ rte_eth_rx_descriptor_status(uint16_t port_id, uint16_t queue_id,
 static inline int rte_eth_tx_descriptor_status(uint16_t port_id,
 	uint16_t queue_id, uint16_t offset)
 {
-	struct rte_eth_dev *dev;
+	const struct rte_eth_fp_ops *p;
 	void *txq;
 
 #ifdef RTE_ETHDEV_DEBUG_TX
 	RTE_ETH_VALID_PORTID_OR_ERR_RET(port_id, -ENODEV);
-#endif
-	dev = &rte_eth_devices[port_id];
-#ifdef RTE_ETHDEV_DEBUG_TX
-	if (queue_id >= dev->data->nb_tx_queues)
+	if (queue_id >= rte_eth_devices[port_id].data->nb_tx_queues)
 		return -ENODEV;
 #endif
-	RTE_FUNC_PTR_OR_ERR_RET(*dev->tx_descriptor_status, -ENOTSUP);
-	txq = dev->data->tx_queues[queue_id];
+	p = &rte_eth_fp_ops[port_id];
+	RTE_FUNC_PTR_OR_ERR_RET(*p->tx_descriptor_status, -ENOTSUP);
+	txq = p->txq.data[queue_id];
 
-	return (*dev->tx_descriptor_status)(txq, offset);
+	return (*p->tx_descriptor_status)(txq, offset);
 }
 
 /**
@@ -5252,13 +5539,13 @@ static inline uint16_t
 rte_eth_tx_burst(uint16_t port_id, uint16_t queue_id,
 		 struct rte_mbuf **tx_pkts, uint16_t nb_pkts)
 {
-	struct rte_eth_dev *dev = &rte_eth_devices[port_id];
+	const struct rte_eth_fp_ops *p = &rte_eth_fp_ops[port_id];
 
 #ifdef RTE_ETHDEV_DEBUG_TX
 	RTE_ETH_VALID_PORTID_OR_ERR_RET(port_id, 0);
-	RTE_FUNC_PTR_OR_ERR_RET(*dev->tx_pkt_burst, 0);
+	RTE_FUNC_PTR_OR_ERR_RET(*p->tx_pkt_burst, 0);
 
-	if (queue_id >= dev->data->nb_tx_queues) {
+	if (queue_id >= rte_eth_devices[port_id].data->nb_tx_queues) {
 		RTE_ETHDEV_LOG(ERR, "Invalid TX queue_id=%u\n", queue_id);
 		return 0;
 	}
@@ -5273,8 +5560,8 @@ rte_eth_tx_burst(uint16_t port_id, uint16_t queue_id,
 	 * cb and cb->fn/cb->next, __ATOMIC_ACQUIRE memory order is
 	 * not required.
 	 */
-	cb = __atomic_load_n(&dev->pre_tx_burst_cbs[queue_id],
-				__ATOMIC_RELAXED);
+	cb = __atomic_load_n((struct rte_eth_rxtx_callback **)
+				&p->txq.clbk[queue_id], __ATOMIC_RELAXED);
 
 	if (unlikely(cb != NULL)) {
 		do {
@@ -5285,9 +5572,13 @@ rte_eth_tx_burst(uint16_t port_id, uint16_t queue_id,
 	}
 #endif
 
+	if (unlikely(p->tx_burst_stats != NULL))
+		__rte_eth_burst_stats_update(&p->tx_burst_stats[queue_id],
+					     nb_pkts);
+
 	rte_ethdev_trace_tx_burst(port_id, queue_id, (void **)tx_pkts,
 		nb_pkts);
-	return (*dev->tx_pkt_burst)(dev->data->tx_queues[queue_id], tx_pkts, nb_pkts);
+	return (*p->tx_pkt_burst)(p->txq.data[queue_id], tx_pkts, nb_pkts);
 }
 
 /**
@@ -5350,7 +5641,7 @@ static inline uint16_t
 rte_eth_tx_prepare(uint16_t port_id, uint16_t queue_id,
 		struct rte_mbuf **tx_pkts, uint16_t nb_pkts)
 {
-	struct rte_eth_dev *dev;
+	const struct rte_eth_fp_ops *p;
 
 #ifdef RTE_ETHDEV_DEBUG_TX
 	if (!rte_eth_dev_is_valid_port(port_id)) {
@@ -5358,23 +5649,20 @@ rte_eth_tx_prepare(uint16_t port_id, uint16_t queue_id,
 		rte_errno = ENODEV;
 		return 0;
 	}
-#endif
-
-	dev = &rte_eth_devices[port_id];
 
-#ifdef RTE_ETHDEV_DEBUG_TX
-	if (queue_id >= dev->data->nb_tx_queues) {
+	if (queue_id >= rte_eth_devices[port_id].data->nb_tx_queues) {
 		RTE_ETHDEV_LOG(ERR, "Invalid TX queue_id=%u\n", queue_id);
 		rte_errno = EINVAL;
 		return 0;
 	}
 #endif
 
-	if (!dev->tx_pkt_prepare)
+	p = &rte_eth_fp_ops[port_id];
+
+	if (!p->tx_pkt_prepare)
 		return nb_pkts;
 
-	return (*dev->tx_pkt_prepare)(dev->data->tx_queues[queue_id],
-			tx_pkts, nb_pkts);
+	return (*p->tx_pkt_prepare)(p->txq.data[queue_id], tx_pkts, nb_pkts);
 }
 
 #else
@@ -5398,6 +5686,126 @@ rte_eth_tx_prepare(__rte_unused uint16_t port_id,
 
 #endif
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Recycle the mbufs freed by a Tx queue into a Rx queue.
+ *
+ * The mbufs whose transmission is complete are moved from the Tx queue
+ * to the mbuf ring of the Rx queue, and its descriptors are refilled with
+ * them, without going through the mempool. It replaces the free of
+ * the Tx queue and the refill of the Rx queue when both are polled by
+ * the same lcore, typically in a forwarding loop before rte_eth_rx_burst().
+ *
+ * The Tx queue releases its mbufs by chunks: nothing is done until enough
+ * transmissions complete and the Rx queue has room for a chunk.
+ * The mbufs are recycled only if they all come from the mempool of
+ * the Rx queue and are not referenced elsewhere (always true with
+ * the DEV_TX_OFFLOAD_MBUF_FAST_FREE offload and the same mempool),
+ * otherwise they are freed as usual.
+ *
+ * @param rx_port_id
+ *   The port identifier of the Ethernet device receiving the mbufs.
+ * @param rx_queue_id
+ *   The index of the receive queue.
+ * @param tx_port_id
+ *   The port identifier of the Ethernet device whose mbufs are recycled.
+ * @param tx_queue_id
+ *   The index of the transmit queue.
+ * @param recycle_rxq_info
+ *   The information about the Rx queue, retrieved once with
+ *   rte_eth_recycle_rx_queue_info_get().
+ * @return
+ *   The number of mbufs recycled, 0 if none or if the PMDs or their
+ *   selected burst functions do not support it.
+ */
+__rte_experimental
+static inline uint16_t
+rte_eth_recycle_mbufs(uint16_t rx_port_id, uint16_t rx_queue_id,
+		uint16_t tx_port_id, uint16_t tx_queue_id,
+		struct rte_eth_recycle_rxq_info *recycle_rxq_info)
+{
+	const struct rte_eth_fp_ops *rxp, *txp;
+	uint16_t nb_mbufs;
+
+#ifdef RTE_ETHDEV_DEBUG_TX
+	RTE_ETH_VALID_PORTID_OR_ERR_RET(tx_port_id, 0);
+	if (tx_queue_id >= rte_eth_devices[tx_port_id].data->nb_tx_queues) {
+		RTE_ETHDEV_LOG(ERR, "Invalid TX queue_id=%u\n", tx_queue_id);
+		return 0;
+	}
+#endif
+#ifdef RTE_ETHDEV_DEBUG_RX
+	RTE_ETH_VALID_PORTID_OR_ERR_RET(rx_port_id, 0);
+	if (rx_queue_id >= rte_eth_devices[rx_port_id].data->nb_rx_queues) {
+		RTE_ETHDEV_LOG(ERR, "Invalid RX queue_id=%u\n", rx_queue_id);
+		return 0;
+	}
+#endif
+
+	rxp = &rte_eth_fp_ops[rx_port_id];
+	txp = &rte_eth_fp_ops[tx_port_id];
+	if (unlikely(txp->recycle_tx_mbufs_reuse == NULL ||
+			rxp->recycle_rx_descriptors_refill == NULL))
+		return 0;
+
+	/* Move the freed Tx mbufs to the Rx mbuf ring */
+	nb_mbufs = txp->recycle_tx_mbufs_reuse(txp->txq.data[tx_queue_id],
+			recycle_rxq_info);
+	if (nb_mbufs == 0)
+		return 0;
+
+	/* Refill the Rx descriptors with them */
+	rxp->recycle_rx_descriptors_refill(rxp->rxq.data[rx_queue_id],
+			nb_mbufs);
+
+	return nb_mbufs;
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change, or be removed, without prior notice
+ *
+ * Hand the descriptors queued by rte_eth_tx_burst() and still pending
+ * to the device, when the Tx queue defers the tail register writes
+ * (see rte_eth_txconf.tx_doorbell_thresh).
+ *
+ * The deadline of the pending descriptors is only checked by the next
+ * rte_eth_tx_burst(), so an application which may stop sending on the queue
+ * for a while should call it, typically when its Rx queues are idle.
+ * Like rte_eth_tx_burst(), it must not be called concurrently on the same
+ * Tx queue.
+ *
+ * @param port_id
+ *   The port identifier of the Ethernet device.
+ * @param queue_id
+ *   The index of the transmit queue.
+ * @return
+ *   The number of descriptors handed to the device, 0 if none was pending
+ *   or if the selected Tx function does not defer the tail writes.
+ */
+__rte_experimental
+static inline uint16_t
+rte_eth_tx_doorbell_flush(uint16_t port_id, uint16_t queue_id)
+{
+	const struct rte_eth_fp_ops *p;
+
+#ifdef RTE_ETHDEV_DEBUG_TX
+	RTE_ETH_VALID_PORTID_OR_ERR_RET(port_id, 0);
+	if (queue_id >= rte_eth_devices[port_id].data->nb_tx_queues) {
+		RTE_ETHDEV_LOG(ERR, "Invalid TX queue_id=%u\n", queue_id);
+		return 0;
+	}
+#endif
+
+	p = &rte_eth_fp_ops[port_id];
+	if (p->tx_doorbell_flush == NULL)
+		return 0;
+
+	return p->tx_doorbell_flush(p->txq.data[queue_id]);
+}
+
 /**
  * Send any packets queued up for transmission on a port and HW queue
  *
@@ -54,6 +54,17 @@ typedef int (*eth_rx_descriptor_status_t)(void *rxq, uint16_t offset);
 typedef int (*eth_tx_descriptor_status_t)(void *txq, uint16_t offset);
 /**< @internal Check the status of a Tx descriptor */
 
+typedef uint16_t (*eth_recycle_tx_mbufs_reuse_t)(void *txq,
+		struct rte_eth_recycle_rxq_info *recycle_rxq_info);
+/**< @internal Move the freed mbufs of a Tx queue to the ring of a Rx queue */
+
+typedef void (*eth_recycle_rx_descriptors_refill_t)(void *rxq,
+		uint16_t nb_mbufs);
+/**< @internal Refill the Rx descriptors with the recycled mbufs */
+
+typedef uint16_t (*eth_tx_doorbell_flush_t)(void *txq);
+/**< @internal Write the Tx tail register for the pending descriptors */
+
 
 /**
  * @internal
@@ -114,8 +125,15 @@ struct rte_eth_dev {
 	enum rte_eth_dev_state state; /**< Flag indicating the port state */
 	void *security_ctx; /**< Context for security ops */
 
+	/** Move the freed mbufs of a Tx queue to a Rx queue. */
+	eth_recycle_tx_mbufs_reuse_t recycle_tx_mbufs_reuse;
+	/** Refill the Rx descriptors with the recycled mbufs. */
+	eth_recycle_rx_descriptors_refill_t recycle_rx_descriptors_refill;
+	/** Write the Tx tail register for the pending descriptors. */
+	eth_tx_doorbell_flush_t tx_doorbell_flush;
+
 	uint64_t reserved_64s[4]; /**< Reserved for future fields */
-	void *reserved_ptrs[4];   /**< Reserved for future fields */
+	void *reserved_ptrs[1];   /**< Reserved for future fields */
 } __rte_cache_aligned;
 
 struct rte_eth_dev_sriov;
@@ -187,6 +205,93 @@ struct rte_eth_dev_data {
 	void *reserved_ptrs[4];   /**< Reserved for future fields */
 } __rte_cache_aligned;
 
+/**
+ * @internal
+ * Structure used to hold opaque pointers to internal ethdev Rx/Tx
+ * queues data.
+ * The main purpose to expose these pointers at all - allow compiler
+ * to fetch this data for fast-path ethdev inline functions in advance.
+ */
+struct rte_ethdev_qdata {
+	void **data;
+	/**< points to array of internal queue data pointers */
+	void **clbk;
+	/**< points to array of queue callback data pointers */
+};
+
+/** Number of burst size buckets of the burst stats of a queue. */
+#define RTE_ETH_BURST_STATS_NB_BUCKETS 8
+
+/**
+ * @internal
+ * Burst stats of a queue, maintained by rte_eth_rx_burst() and
+ * rte_eth_tx_burst() when enabled with rte_eth_burst_stats_enable().
+ */
+struct rte_eth_burst_stats {
+	uint64_t empty;
+	/**< Number of bursts without any packet. */
+	uint64_t hist[RTE_ETH_BURST_STATS_NB_BUCKETS];
+	/**< Number of bursts of 2^i to 2^(i+1) - 1 packets in bucket i, the
+	 * last bucket counting all the larger bursts.
+	 */
+} __rte_cache_aligned;
+
+/**
+ * @internal
+ * Fast-path ethdev functions and related data are hold in a flat array.
+ * One entry per ethdev.
+ * On 64-bit systems contents of this structure occupy exactly two 64B lines.
+ * On 32-bit systems contents of this structure fits into one 64B line.
+ *
+ * The entry of a port is filled by rte_eth_dev_start() and reset to dummy
+ * values by rte_eth_dev_stop(), so polling cores never have to dereference
+ * struct rte_eth_dev, whose contents are updated by the control path.
+ */
+struct rte_eth_fp_ops {
+
+	/**
+	 * Rx fast-path functions and related data.
+	 * 64-bit systems: occupies first 64B line
+	 */
+	eth_rx_burst_t rx_pkt_burst;
+	/**< PMD receive function. */
+	eth_rx_descriptor_status_t rx_descriptor_status;
+	/**< Check the status of a Rx descriptor. */
+	struct rte_ethdev_qdata rxq;
+	/**< Rx queues data. */
+	struct rte_eth_burst_stats *rx_burst_stats;
+	/**< Rx queues burst stats, NULL when disabled. */
+	eth_recycle_rx_descriptors_refill_t recycle_rx_descriptors_refill;
+	/**< Refill Rx descriptors with the recycled mbufs. */
+	uintptr_t reserved1[2];
+
+	/**
+	 * Tx fast-path functions and related data.
+	 * 64-bit systems: occupies second 64B line
+	 */
+	eth_tx_burst_t tx_pkt_burst;
+	/**< PMD transmit function. */
+	eth_tx_prep_t tx_pkt_prepare;
+	/**< PMD transmit prepare function. */
+	eth_tx_descriptor_status_t tx_descriptor_status;
+	/**< Check the status of a Tx descriptor. */
+	struct rte_ethdev_qdata txq;
+	/**< Tx queues data. */
+	struct rte_eth_burst_stats *tx_burst_stats;
+	/**< Tx queues burst stats, NULL when disabled. */
+	eth_recycle_tx_mbufs_reuse_t recycle_tx_mbufs_reuse;
+	/**< Move the freed Tx mbufs to a Rx queue. */
+	eth_tx_doorbell_flush_t tx_doorbell_flush;
+	/**< Write the Tx tail register for the pending descriptors. */
+
+} __rte_cache_aligned;
+
+/**
+ * @internal
+ * The array of fast-path ethdev operations, one entry per port.
+ */
+extern struct rte_eth_fp_ops rte_eth_fp_ops[RTE_MAX_ETHPORTS];
+
 /**
  * @internal
  * The pool of *rte_eth_dev* structures. The size of the pool
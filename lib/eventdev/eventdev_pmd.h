@@ -75,7 +75,8 @@ extern "C" {
 	 (RTE_EVENT_ETH_RX_ADAPTER_CAP_EVENT_VECTOR))
 
 #define RTE_EVENT_CRYPTO_ADAPTER_SW_CAP \
-		RTE_EVENT_CRYPTO_ADAPTER_CAP_SESSION_PRIVATE_DATA
+		((RTE_EVENT_CRYPTO_ADAPTER_CAP_SESSION_PRIVATE_DATA) | \
+		 (RTE_EVENT_CRYPTO_ADAPTER_CAP_EVENT_VECTOR))
 
 /**< Ethernet Rx adapter cap to return If the packet transfers from
  * the ethdev to eventdev use a SW service function
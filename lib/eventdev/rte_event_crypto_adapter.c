@@ -12,7 +12,9 @@
 #include <rte_cryptodev_pmd.h>
 #include <rte_log.h>
 #include <rte_malloc.h>
+#include <rte_mempool.h>
 #include <rte_service_component.h>
+#include <rte_tailq.h>
 
 #include "rte_eventdev.h"
 #include "eventdev_pmd.h"
@@ -24,12 +26,33 @@
 #define CRYPTO_ADAPTER_NAME_LEN 32
 #define CRYPTO_ADAPTER_MEM_NAME_LEN 32
 #define CRYPTO_ADAPTER_MAX_EV_ENQ_RETRIES 100
+#define MAX_VECTOR_SIZE 1024
+#define MIN_VECTOR_SIZE 4
+#define MAX_VECTOR_NS 1E9
+#define MIN_VECTOR_NS 1E5
+#define NSEC2TICK(__ns, __freq) (((__ns) * (__freq)) / 1E9)
 
 /* Flush an instance's enqueue buffers every CRYPTO_ENQ_FLUSH_THRESHOLD
  * iterations of eca_crypto_adapter_enq_run()
  */
 #define CRYPTO_ENQ_FLUSH_THRESHOLD 1024
 
+/* Event vector being filled with the completions of a queue pair */
+struct crypto_vector_data {
+	TAILQ_ENTRY(crypto_vector_data) next;
+	/* Max number of crypto ops per vector */
+	uint16_t max_vector_count;
+	/* Response event of the crypto ops in the vector */
+	uint64_t event;
+	/* Timestamp of the first crypto op added to the vector */
+	uint64_t ts;
+	uint64_t vector_timeout_ticks;
+	struct rte_mempool *vector_pool;
+	struct rte_event_vector *vector_ev;
+} __rte_cache_aligned;
+
+TAILQ_HEAD(crypto_vector_data_list, crypto_vector_data);
+
 struct rte_event_crypto_adapter {
 	/* Event device identifier */
 	uint8_t eventdev_id;
@@ -67,6 +90,14 @@ struct rte_event_crypto_adapter {
 	uint16_t nb_qps;
 	/* Adapter mode */
 	enum rte_event_crypto_adapter_mode mode;
+	/* Vector enable flag */
+	uint8_t ena_vector;
+	/* Timestamp of previous vector expiry list traversal */
+	uint64_t prev_expiry_ts;
+	/* Minimum ticks to wait before traversing expiry list */
+	uint64_t vector_tmo_ticks;
+	/* Vectors being filled */
+	struct crypto_vector_data_list vector_list;
 } __rte_cache_aligned;
 
 /* Per crypto device information */
@@ -97,6 +128,12 @@ struct crypto_queue_pair_info {
 	struct rte_crypto_op **op_buffer;
 	/* No of crypto ops accumulated */
 	uint8_t len;
+	/* Serialize the enqueues of the service and of the workers */
+	rte_spinlock_t enq_lock;
+	/* Set to indicate completions are vectorized */
+	bool ena_vector;
+	/* Event vector of the completions */
+	struct crypto_vector_data vector_data;
 } __rte_cache_aligned;
 
 static struct rte_event_crypto_adapter **event_crypto_adapter;
@@ -264,6 +301,7 @@ rte_event_crypto_adapter_create_ext(uint8_t id, uint8_t dev_id,
 	}
 
 	rte_spinlock_init(&adapter->lock);
+	TAILQ_INIT(&adapter->vector_list);
 	for (i = 0; i < rte_cryptodev_count(); i++)
 		adapter->cdevs[i].dev = rte_cryptodev_pmd_get_dev(i);
 
@@ -393,10 +431,12 @@ eca_enq_to_cryptodev(struct rte_event_crypto_adapter *adapter,
 
 		if (len == BATCH_SIZE) {
 			struct rte_crypto_op **op_buffer = qp_info->op_buffer;
+			rte_spinlock_lock(&qp_info->enq_lock);
 			ret = rte_cryptodev_enqueue_burst(cdev_id,
 							  qp_id,
 							  op_buffer,
 							  BATCH_SIZE);
+			rte_spinlock_unlock(&qp_info->enq_lock);
 
 			stats->crypto_enq_count += ret;
 
@@ -445,10 +485,12 @@ eca_crypto_enq_flush(struct rte_event_crypto_adapter *adapter)
 				continue;
 
 			op_buffer = curr_queue->op_buffer;
+			rte_spinlock_lock(&curr_queue->enq_lock);
 			ret = rte_cryptodev_enqueue_burst(cdev_id,
 							  qp,
 							  op_buffer,
 							  curr_queue->len);
+			rte_spinlock_unlock(&curr_queue->enq_lock);
 			stats->crypto_enq_count += ret;
 
 			while (ret < curr_queue->len) {
@@ -465,6 +507,88 @@ eca_crypto_enq_flush(struct rte_event_crypto_adapter *adapter)
 	return ret;
 }
 
+/* Request and response information of a crypto op, NULL if it has none */
+static inline union rte_event_crypto_metadata *
+eca_op_metadata(struct rte_crypto_op *crypto_op)
+{
+	if (crypto_op->sess_type == RTE_CRYPTO_OP_WITH_SESSION)
+		return rte_cryptodev_sym_session_get_user_data(
+				crypto_op->sym->session);
+
+	if (crypto_op->sess_type == RTE_CRYPTO_OP_SESSIONLESS &&
+	    crypto_op->private_data_offset)
+		return (union rte_event_crypto_metadata *)
+			((uint8_t *)crypto_op +
+			 crypto_op->private_data_offset);
+
+	return NULL;
+}
+
+uint16_t
+rte_event_crypto_adapter_op_enqueue(uint8_t id, struct rte_crypto_op **ops,
+				    uint16_t nb_ops)
+{
+	struct rte_event_crypto_adapter *adapter;
+	union rte_event_crypto_metadata *m_data;
+	struct crypto_queue_pair_info *qp_info;
+	struct crypto_device_info *dev_info;
+	uint16_t i, n, nb_run, qp_id;
+	uint8_t cdev_id;
+
+	if (!eca_valid_id(id)) {
+		rte_errno = EINVAL;
+		return 0;
+	}
+
+	adapter = eca_id_to_adapter(id);
+	if (adapter == NULL || !adapter->service_inited) {
+		rte_errno = EINVAL;
+		return 0;
+	}
+
+	for (i = 0; i < nb_ops; i += n) {
+		m_data = eca_op_metadata(ops[i]);
+		if (m_data == NULL)
+			break;
+
+		cdev_id = m_data->request_info.cdev_id;
+		qp_id = m_data->request_info.queue_pair_id;
+		if (cdev_id >= rte_cryptodev_count())
+			break;
+		dev_info = &adapter->cdevs[cdev_id];
+		if (dev_info->qpairs == NULL ||
+		    qp_id >= dev_info->dev->data->nb_queue_pairs)
+			break;
+		qp_info = &dev_info->qpairs[qp_id];
+		if (!qp_info->qp_enabled)
+			break;
+
+		/* Enqueue the run of ops going to the same queue pair */
+		for (nb_run = 1; i + nb_run < nb_ops; nb_run++) {
+			m_data = eca_op_metadata(ops[i + nb_run]);
+			if (m_data == NULL ||
+			    m_data->request_info.cdev_id != cdev_id ||
+			    m_data->request_info.queue_pair_id != qp_id)
+				break;
+		}
+
+		rte_spinlock_lock(&qp_info->enq_lock);
+		n = rte_cryptodev_enqueue_burst(cdev_id, qp_id, &ops[i],
+						nb_run);
+		rte_spinlock_unlock(&qp_info->enq_lock);
+
+		if (n < nb_run) {
+			rte_errno = ENOSPC;
+			return i + n;
+		}
+	}
+
+	if (i < nb_ops)
+		rte_errno = EINVAL;
+
+	return i;
+}
+
 static int
 eca_crypto_adapter_enq_run(struct rte_event_crypto_adapter *adapter,
 			unsigned int max_enq)
@@ -499,25 +623,128 @@ eca_crypto_adapter_enq_run(struct rte_event_crypto_adapter *adapter,
 	return nb_enqueued;
 }
 
+static void
+eca_event_free(const struct rte_event *ev)
+{
+	struct rte_crypto_op *op;
+	uint16_t i;
+
+	if (ev->event_type & RTE_EVENT_TYPE_VECTOR) {
+		for (i = 0; i < ev->vec->nb_elem; i++) {
+			op = ev->vec->ptrs[i];
+			rte_pktmbuf_free(op->sym->m_src);
+			rte_crypto_op_free(op);
+		}
+		rte_mempool_put(rte_mempool_from_obj(ev->vec), ev->vec);
+	} else {
+		op = ev->event_ptr;
+		rte_pktmbuf_free(op->sym->m_src);
+		rte_crypto_op_free(op);
+	}
+}
+
+static void
+eca_events_enqueue(struct rte_event_crypto_adapter *adapter,
+		   struct rte_event *events, uint16_t nb_ev)
+{
+	struct rte_event_crypto_adapter_stats *stats = &adapter->crypto_stats;
+	uint8_t event_dev_id = adapter->eventdev_id;
+	uint8_t event_port_id = adapter->event_port_id;
+	uint16_t nb_enqueued;
+	uint8_t retry;
+	uint16_t i;
+
+	retry = 0;
+	nb_enqueued = 0;
+
+	do {
+		nb_enqueued += rte_event_enqueue_burst(event_dev_id,
+						  event_port_id,
+						  &events[nb_enqueued],
+						  nb_ev - nb_enqueued);
+	} while (retry++ < CRYPTO_ADAPTER_MAX_EV_ENQ_RETRIES &&
+		 nb_enqueued < nb_ev);
+
+	/* Free mbufs and rte_crypto_ops for failed events */
+	for (i = nb_enqueued; i < nb_ev; i++)
+		eca_event_free(&events[i]);
+
+	stats->event_enq_fail_count += nb_ev - nb_enqueued;
+	stats->event_enq_count += nb_enqueued;
+	stats->event_enq_retry_count += retry - 1;
+}
+
+/* Turn the vector being filled into an event */
+static inline void
+eca_vector_event(struct rte_event_crypto_adapter *adapter,
+		 struct crypto_vector_data *vec, struct rte_event *ev)
+{
+	ev->event = vec->event;
+	ev->vec = vec->vector_ev;
+	vec->vector_ev = NULL;
+	TAILQ_REMOVE(&adapter->vector_list, vec, next);
+}
+
+/*
+ * Add a crypto op to the vector of its queue pair, closing the vector if it
+ * is full or if it was filled with ops of another response event.
+ * Returns the number of events filled, at most one, or -1 if no vector is
+ * available: a full vector is closed as soon as the op completing it is
+ * added, so a new vector is never full when the previous one is closed.
+ */
+static inline int
+eca_vector_add(struct rte_event_crypto_adapter *adapter,
+	       struct crypto_vector_data *vec, struct rte_crypto_op *op,
+	       uint64_t event, struct rte_event *ev)
+{
+	struct rte_event_vector *vector;
+	int nb_ev = 0;
+
+	if (vec->vector_ev == NULL || vec->event != event) {
+		if (rte_mempool_get(vec->vector_pool, (void **)&vector) < 0)
+			return -1;
+
+		if (vec->vector_ev != NULL)
+			eca_vector_event(adapter, vec, &ev[nb_ev++]);
+
+		vector->nb_elem = 0;
+		vector->attr_valid = 0;
+		vec->vector_ev = vector;
+		vec->event = event;
+		vec->ts = rte_rdtsc();
+		TAILQ_INSERT_TAIL(&adapter->vector_list, vec, next);
+	}
+
+	vector = vec->vector_ev;
+	vector->ptrs[vector->nb_elem++] = op;
+	if (vector->nb_elem == vec->max_vector_count)
+		eca_vector_event(adapter, vec, &ev[nb_ev++]);
+
+	return nb_ev;
+}
+
 static inline void
 eca_ops_enqueue_burst(struct rte_event_crypto_adapter *adapter,
+		  struct crypto_queue_pair_info *qp_info,
 		  struct rte_crypto_op **ops, uint16_t num)
 {
-	struct rte_event_crypto_adapter_stats *stats = &adapter->crypto_stats;
 	union rte_event_crypto_metadata *m_data = NULL;
-	uint8_t event_dev_id = adapter->eventdev_id;
-	uint8_t event_port_id = adapter->event_port_id;
 	struct rte_event events[BATCH_SIZE];
-	uint16_t nb_enqueued, nb_ev;
-	uint8_t retry;
+	struct rte_event rsp;
+	uint16_t nb_ev;
+	uint8_t op_type;
 	uint8_t i;
+	int n;
 
 	nb_ev = 0;
-	retry = 0;
-	nb_enqueued = 0;
 	num = RTE_MIN(num, BATCH_SIZE);
+	if (adapter->implicit_release_disabled)
+		op_type = RTE_EVENT_OP_FORWARD;
+	else
+		op_type = RTE_EVENT_OP_NEW;
+
 	for (i = 0; i < num; i++) {
-		struct rte_event *ev = &events[nb_ev++];
+		struct rte_event *ev = &events[nb_ev];
 		if (ops[i]->sess_type == RTE_CRYPTO_OP_WITH_SESSION) {
 			m_data = rte_cryptodev_sym_session_get_user_data(
 					ops[i]->sym->session);
@@ -534,33 +761,69 @@ eca_ops_enqueue_burst(struct rte_event_crypto_adapter *adapter,
 			continue;
 		}
 
+		if (qp_info->ena_vector) {
+			/* the op fills at most one event, so the events
+			 * of the burst still fit in the array
+			 */
+			rte_memcpy(&rsp, &m_data->response_info, sizeof(rsp));
+			rsp.event_type = RTE_EVENT_TYPE_CRYPTODEV_VECTOR;
+			rsp.op = op_type;
+			n = eca_vector_add(adapter, &qp_info->vector_data,
+					   ops[i], rsp.event, ev);
+			if (n >= 0) {
+				nb_ev += n;
+				continue;
+			}
+			/* no vector available, use a regular event */
+		}
+
 		rte_memcpy(ev, &m_data->response_info, sizeof(*ev));
 		ev->event_ptr = ops[i];
 		ev->event_type = RTE_EVENT_TYPE_CRYPTODEV;
-		if (adapter->implicit_release_disabled)
-			ev->op = RTE_EVENT_OP_FORWARD;
-		else
-			ev->op = RTE_EVENT_OP_NEW;
+		ev->op = op_type;
+		nb_ev++;
 	}
 
-	do {
-		nb_enqueued += rte_event_enqueue_burst(event_dev_id,
-						  event_port_id,
-						  &events[nb_enqueued],
-						  nb_ev - nb_enqueued);
-	} while (retry++ < CRYPTO_ADAPTER_MAX_EV_ENQ_RETRIES &&
-		 nb_enqueued < nb_ev);
+	if (nb_ev)
+		eca_events_enqueue(adapter, events, nb_ev);
+}
 
-	/* Free mbufs and rte_crypto_ops for failed events */
-	for (i = nb_enqueued; i < nb_ev; i++) {
-		struct rte_crypto_op *op = events[i].event_ptr;
-		rte_pktmbuf_free(op->sym->m_src);
-		rte_crypto_op_free(op);
+/* Enqueue the vectors that have been filled for too long */
+static void
+eca_vector_expire(struct rte_event_crypto_adapter *adapter)
+{
+	struct crypto_vector_data *vec, *tvec;
+	struct rte_event events[BATCH_SIZE];
+	uint64_t now = rte_rdtsc();
+	uint16_t nb_ev = 0;
+
+	TAILQ_FOREACH_SAFE(vec, &adapter->vector_list, next, tvec) {
+		if (now - vec->ts < vec->vector_timeout_ticks)
+			continue;
+		eca_vector_event(adapter, vec, &events[nb_ev++]);
+		if (nb_ev == BATCH_SIZE) {
+			eca_events_enqueue(adapter, events, nb_ev);
+			nb_ev = 0;
+		}
 	}
 
-	stats->event_enq_fail_count += nb_ev - nb_enqueued;
-	stats->event_enq_count += nb_enqueued;
-	stats->event_enq_retry_count += retry - 1;
+	if (nb_ev)
+		eca_events_enqueue(adapter, events, nb_ev);
+	adapter->prev_expiry_ts = now;
+}
+
+/* Enqueue the vector being filled by a queue pair, if any */
+static void
+eca_vector_flush(struct rte_event_crypto_adapter *adapter,
+		 struct crypto_vector_data *vec)
+{
+	struct rte_event ev;
+
+	if (vec->vector_ev == NULL)
+		return;
+
+	eca_vector_event(adapter, vec, &ev);
+	eca_events_enqueue(adapter, &ev, 1);
 }
 
 static inline unsigned int
@@ -606,7 +869,8 @@ eca_crypto_adapter_deq_run(struct rte_event_crypto_adapter *adapter,
 
 				done = false;
 				stats->crypto_deq_count += n;
-				eca_ops_enqueue_burst(adapter, ops, n);
+				eca_ops_enqueue_burst(adapter, curr_queue,
+						      ops, n);
 				nb_deq += n;
 
 				if (nb_deq > max_deq) {
@@ -652,6 +916,9 @@ eca_service_func(void *args)
 
 	if (rte_spinlock_trylock(&adapter->lock) == 0)
 		return 0;
+	if (adapter->ena_vector &&
+	    rte_rdtsc() - adapter->prev_expiry_ts >= adapter->vector_tmo_ticks)
+		eca_vector_expire(adapter);
 	eca_crypto_adapter_run(adapter, adapter->max_nb);
 	rte_spinlock_unlock(&adapter->lock);
 
@@ -723,6 +990,11 @@ eca_update_qp_info(struct rte_event_crypto_adapter *adapter,
 		} else {
 			adapter->nb_qps -= enabled;
 			dev_info->num_qpairs -= enabled;
+			/* Push the partial event vector to event device. */
+			if (qp_info->ena_vector)
+				eca_vector_flush(adapter,
+						 &qp_info->vector_data);
+			qp_info->ena_vector = 0;
 		}
 		qp_info->qp_enabled = !!add;
 	}
@@ -747,6 +1019,8 @@ eca_add_queue_pair(struct rte_event_crypto_adapter *adapter,
 			return -ENOMEM;
 
 		qpairs = dev_info->qpairs;
+		for (i = 0; i < dev_info->dev->data->nb_queue_pairs; i++)
+			rte_spinlock_init(&qpairs[i].enq_lock);
 		qpairs->op_buffer = rte_zmalloc_socket(adapter->mem_name,
 					BATCH_SIZE *
 					sizeof(struct rte_crypto_op *),
@@ -972,6 +1246,133 @@ rte_event_crypto_adapter_queue_pair_del(uint8_t id, uint8_t cdev_id,
 	return ret;
 }
 
+int
+rte_event_crypto_adapter_vector_limits_get(uint8_t dev_id, uint8_t cdev_id,
+		struct rte_event_crypto_adapter_vector_limits *limits)
+{
+	uint32_t cap;
+	int ret;
+
+	RTE_EVENTDEV_VALID_DEVID_OR_ERR_RET(dev_id, -EINVAL);
+
+	if (!rte_cryptodev_pmd_is_valid_dev(cdev_id)) {
+		RTE_EDEV_LOG_ERR("Invalid dev_id=%" PRIu8, cdev_id);
+		return -EINVAL;
+	}
+
+	if (limits == NULL)
+		return -EINVAL;
+
+	ret = rte_event_crypto_adapter_caps_get(dev_id, cdev_id, &cap);
+	if (ret) {
+		RTE_EDEV_LOG_ERR("Failed to get adapter caps edev %" PRIu8
+				 " cdev %" PRIu8, dev_id, cdev_id);
+		return ret;
+	}
+
+	if (!(cap & RTE_EVENT_CRYPTO_ADAPTER_CAP_EVENT_VECTOR))
+		return -ENOTSUP;
+
+	limits->log2_sz = false;
+	limits->min_sz = MIN_VECTOR_SIZE;
+	limits->max_sz = MAX_VECTOR_SIZE;
+	limits->min_timeout_ns = MIN_VECTOR_NS;
+	limits->max_timeout_ns = MAX_VECTOR_NS;
+
+	return 0;
+}
+
+int
+rte_event_crypto_adapter_queue_pair_event_vector_config(uint8_t id,
+		uint8_t cdev_id, int32_t queue_pair_id,
+		const struct rte_event_crypto_adapter_event_vector_config *config)
+{
+	struct rte_event_crypto_adapter_vector_limits limits;
+	struct rte_event_crypto_adapter *adapter;
+	struct crypto_queue_pair_info *qp_info;
+	struct crypto_device_info *dev_info;
+	struct crypto_vector_data *vec;
+	uint64_t timeout_ticks;
+	uint16_t i, nb_qps;
+	int ret;
+
+	EVENT_CRYPTO_ADAPTER_ID_VALID_OR_ERR_RET(id, -EINVAL);
+
+	adapter = eca_id_to_adapter(id);
+	if (adapter == NULL || config == NULL)
+		return -EINVAL;
+
+	ret = rte_event_crypto_adapter_vector_limits_get(adapter->eventdev_id,
+							 cdev_id, &limits);
+	if (ret)
+		return ret;
+
+	dev_info = &adapter->cdevs[cdev_id];
+	if (dev_info->qpairs == NULL)
+		return -EINVAL;
+
+	nb_qps = dev_info->dev->data->nb_queue_pairs;
+	if (queue_pair_id != -1 && (uint16_t)queue_pair_id >= nb_qps) {
+		RTE_EDEV_LOG_ERR("Invalid queue_pair_id %" PRIu16,
+				 (uint16_t)queue_pair_id);
+		return -EINVAL;
+	}
+
+	if (config->vector_sz < limits.min_sz ||
+	    config->vector_sz > limits.max_sz ||
+	    config->vector_timeout_ns < limits.min_timeout_ns ||
+	    config->vector_timeout_ns > limits.max_timeout_ns ||
+	    config->vector_mp == NULL) {
+		RTE_EDEV_LOG_ERR("Invalid event vector configuration");
+		return -EINVAL;
+	}
+
+	if (config->vector_mp->elt_size <
+	    (sizeof(struct rte_event_vector) +
+	     (sizeof(uintptr_t) * config->vector_sz))) {
+		RTE_EDEV_LOG_ERR("Vector mempool element size too small");
+		return -EINVAL;
+	}
+
+	timeout_ticks = NSEC2TICK(config->vector_timeout_ns,
+				  rte_get_timer_hz());
+
+	rte_spinlock_lock(&adapter->lock);
+	for (i = 0; i < nb_qps; i++) {
+		if (queue_pair_id != -1 && i != queue_pair_id)
+			continue;
+
+		qp_info = &dev_info->qpairs[i];
+		if (!qp_info->qp_enabled) {
+			if (queue_pair_id == -1)
+				continue;
+			rte_spinlock_unlock(&adapter->lock);
+			RTE_EDEV_LOG_ERR("Queue pair %" PRIu16 " not added",
+					 i);
+			return -EINVAL;
+		}
+
+		vec = &qp_info->vector_data;
+		/* Push the ops vectorized with the previous settings */
+		eca_vector_flush(adapter, vec);
+		vec->max_vector_count = config->vector_sz;
+		vec->vector_timeout_ticks = timeout_ticks;
+		vec->vector_pool = config->vector_mp;
+		qp_info->ena_vector = 1;
+	}
+
+	/* Traverse the expiry list twice per timeout period */
+	if (!adapter->ena_vector ||
+	    timeout_ticks / 2 < adapter->vector_tmo_ticks)
+		adapter->vector_tmo_ticks = timeout_ticks / 2;
+	if (!adapter->ena_vector)
+		adapter->prev_expiry_ts = rte_rdtsc();
+	adapter->ena_vector = 1;
+	rte_spinlock_unlock(&adapter->lock);
+
+	return 0;
+}
+
 static int
 eca_adapter_ctrl(uint8_t id, int start)
 {
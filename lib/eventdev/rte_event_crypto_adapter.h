@@ -138,6 +138,8 @@
  *  - rte_event_crypto_adapter_stop()
  *  - rte_event_crypto_adapter_stats_get()
  *  - rte_event_crypto_adapter_stats_reset()
+ *  - rte_event_crypto_adapter_vector_limits_get()
+ *  - rte_event_crypto_adapter_queue_pair_event_vector_config()
 
  * The application creates an instance using rte_event_crypto_adapter_create()
  * or rte_event_crypto_adapter_create_ext().
@@ -162,6 +164,12 @@
  * The rte_crypto_op::private_data_offset provides an offset to locate the
  * request/response information in the rte_crypto_op. This offset is counted
  * from the start of the rte_crypto_op including initialization vector (IV).
+ *
+ * If the RTE_EVENT_CRYPTO_ADAPTER_CAP_EVENT_VECTOR capability is set, the
+ * crypto completions of a queue pair can be aggregated into event vectors
+ * using rte_event_crypto_adapter_queue_pair_event_vector_config(), so that
+ * a single event of type RTE_EVENT_TYPE_CRYPTODEV_VECTOR is scheduled for up
+ * to rte_event_crypto_adapter_event_vector_config::vector_sz operations.
  */
 
 #ifdef __cplusplus
@@ -173,6 +181,8 @@ extern "C" {
 #include "rte_eventdev.h"
 #include "eventdev_pmd.h"
 
+struct rte_crypto_op;
+
 /**
  * Crypto event adapter mode
  */
@@ -302,6 +312,59 @@ struct rte_event_crypto_adapter_stats {
 	/**< Event enqueue fail count */
 };
 
+/**
+ * Crypto adapter event vector configuration structure.
+ */
+struct rte_event_crypto_adapter_event_vector_config {
+	uint16_t vector_sz;
+	/**<
+	 * Indicates the maximum number of crypto operations to combine and
+	 * form a vector. Should be within
+	 * @see rte_event_crypto_adapter_vector_limits::min_sz
+	 * @see rte_event_crypto_adapter_vector_limits::max_sz
+	 */
+	uint64_t vector_timeout_ns;
+	/**<
+	 * Indicates the maximum number of nanoseconds to wait for aggregating
+	 * crypto operations. Should be within vectorization limits of the
+	 * adapter
+	 * @see rte_event_crypto_adapter_vector_limits::min_timeout_ns
+	 * @see rte_event_crypto_adapter_vector_limits::max_timeout_ns
+	 */
+	struct rte_mempool *vector_mp;
+	/**<
+	 * Indicates the mempool that should be used for allocating
+	 * rte_event_vector container.
+	 * Should be created by using `rte_event_vector_pool_create`.
+	 */
+};
+
+/**
+ * A structure used to retrieve event crypto adapter vector limits.
+ */
+struct rte_event_crypto_adapter_vector_limits {
+	uint16_t min_sz;
+	/**< Minimum vector limit configurable.
+	 * @see rte_event_crypto_adapter_event_vector_config::vector_sz
+	 */
+	uint16_t max_sz;
+	/**< Maximum vector limit configurable.
+	 * @see rte_event_crypto_adapter_event_vector_config::vector_sz
+	 */
+	uint8_t log2_sz;
+	/**< True if the size configured should be in log2.
+	 * @see rte_event_crypto_adapter_event_vector_config::vector_sz
+	 */
+	uint64_t min_timeout_ns;
+	/**< Minimum vector timeout configurable.
+	 * @see rte_event_crypto_adapter_event_vector_config::vector_timeout_ns
+	 */
+	uint64_t max_timeout_ns;
+	/**< Maximum vector timeout configurable.
+	 * @see rte_event_crypto_adapter_event_vector_config::vector_timeout_ns
+	 */
+};
+
 /**
  * Create a new event crypto adapter with the specified identifier.
  *
@@ -523,6 +586,110 @@ rte_event_crypto_adapter_service_id_get(uint8_t id, uint32_t *service_id);
 int
 rte_event_crypto_adapter_event_port_get(uint8_t id, uint8_t *event_port_id);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Retrieve vector limits for a given event dev and crypto dev pair.
+ * @see rte_event_crypto_adapter_vector_limits
+ *
+ * @param dev_id
+ *  Event device identifier.
+ * @param cdev_id
+ *  Crypto device identifier.
+ * @param [out] limits
+ *  A pointer to rte_event_crypto_adapter_vector_limits structure that has to
+ *  be filled.
+ *
+ * @return
+ *  - 0: Success.
+ *  - <0: Error code on failure.
+ */
+__rte_experimental
+int
+rte_event_crypto_adapter_vector_limits_get(uint8_t dev_id, uint8_t cdev_id,
+		struct rte_event_crypto_adapter_vector_limits *limits);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Configure event vectorization for a given crypto device queue pair, that
+ * has been added to an event crypto adapter.
+ *
+ * The completed crypto operations of the queue pair are aggregated into
+ * a vector while their response event information (queue, scheduling type,
+ * priority, flow) is the same. The vector is enqueued as a single event of
+ * type RTE_EVENT_TYPE_CRYPTODEV_VECTOR, which carries the response event
+ * information of its operations, once it is full, when an operation with
+ * different response event information completes, or once
+ * rte_event_crypto_adapter_event_vector_config::vector_timeout_ns have
+ * elapsed since the first operation was added to it.
+ *
+ * @param id
+ *  Adapter identifier.
+ * @param cdev_id
+ *  Cryptodev identifier.
+ * @param queue_pair_id
+ *  Cryptodev queue pair identifier. If queue_pair_id is set -1,
+ *  the configuration applies to all the queue pairs of the cryptodev
+ *  added to the adapter.
+ * @param config
+ *  Event vector configuration structure.
+ *  @see rte_event_crypto_adapter_event_vector_config
+ *
+ * @return
+ *  - 0: Success, event vectorization configured for the queue pair(s).
+ *  - -ENOTSUP: event vectorization is not supported for the cryptodev.
+ *  - <0: Error code on failure.
+ */
+__rte_experimental
+int
+rte_event_crypto_adapter_queue_pair_event_vector_config(uint8_t id,
+	uint8_t cdev_id, int32_t queue_pair_id,
+	const struct rte_event_crypto_adapter_event_vector_config *config);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Enqueue a burst of crypto operations from a worker directly to the crypto
+ * device queue pairs given in their request information, instead of
+ * forwarding them to an adapter using a service, which saves the hop through
+ * the event device and the service core. The queue pairs must have been added
+ * to the adapter, whose service dequeues the completions and enqueues them to
+ * the event device as described by the response information of the crypto
+ * operations, in event vectors if configured. In the
+ * RTE_EVENT_CRYPTO_ADAPTER_OP_NEW mode, the service is then only polling the
+ * completions.
+ *
+ * This function is multi-thread safe, the enqueues to a queue pair are
+ * serialized with the ones of the adapter service. The crypto operations are
+ * not accounted in the adapter enqueue statistics.
+ *
+ * @param id
+ *  Adapter identifier.
+ * @param ops
+ *  Points to an array of *nb_ops* crypto operations, with request and
+ *  response information in their session user data or private data.
+ * @param nb_ops
+ *  The number of crypto operations to enqueue.
+ *
+ * @return
+ *   The number of crypto operations actually enqueued. If the return value is
+ *   less than *nb_ops*, the remaining crypto operations, at the end of ops[],
+ *   are not consumed and the caller has to take care of them, and rte_errno is
+ *   set accordingly. Possible errno values include:
+ *   - EINVAL   The adapter ID is invalid, the adapter does not use a service,
+ *              or a crypto operation has no request information, or targets
+ *              a queue pair not added to the adapter.
+ *   - ENOSPC   The crypto device queue pair is full.
+ */
+__rte_experimental
+uint16_t
+rte_event_crypto_adapter_op_enqueue(uint8_t id, struct rte_crypto_op **ops,
+				    uint16_t nb_ops);
+
 /**
  * Enqueue a burst of crypto operations as event objects supplied in *rte_event*
  * structure on an event crypto adapter designated by its event *dev_id* through
@@ -14,6 +14,7 @@
 #include <rte_ethdev.h>
 #include <rte_log.h>
 #include <rte_malloc.h>
+#include <rte_mbuf_dyn.h>
 #include <rte_service_component.h>
 #include <rte_thash.h>
 #include <rte_interrupts.h>
@@ -77,17 +78,23 @@ struct eth_rx_vector_data {
 
 TAILQ_HEAD(eth_rx_vector_data_list, eth_rx_vector_data);
 
-/* Instance per adapter */
+/* Instance per adapter, or per Rx queue */
 struct rte_eth_event_enqueue_buffer {
 	/* Count of events in this buffer */
 	uint16_t count;
+	/* Size of the events array */
+	uint16_t events_size;
 	/* Array of events in this buffer */
-	struct rte_event events[ETH_EVENT_BUFFER_SIZE];
+	struct rte_event *events;
 };
 
 struct rte_event_eth_rx_adapter {
 	/* RSS key */
 	uint8_t rss_key_be[RSS_KEY_SIZE];
+	/* RSS key matrices for the GFNI Toeplitz hash */
+	uint64_t rss_key_mtrx[RSS_KEY_SIZE];
+	/* Burst soft RSS flag, set if the GFNI Toeplitz hash is supported */
+	uint8_t softrss_bulk;
 	/* Event device identifier */
 	uint8_t eventdev_id;
 	/* Per ethernet device structure */
@@ -108,8 +115,12 @@ struct rte_event_eth_rx_adapter {
 	uint32_t wrr_len;
 	/* Next entry in wrr[] to begin polling */
 	uint32_t wrr_pos;
-	/* Event burst buffer */
+	/* Event burst buffer, unused with per Rx queue buffers */
 	struct rte_eth_event_enqueue_buffer event_enqueue_buffer;
+	/* Size of each event buffer */
+	uint16_t event_buf_size;
+	/* Per Rx queue event buffers flag */
+	uint8_t use_queue_event_buf;
 	/* Vector enable flag */
 	uint8_t ena_vector;
 	/* Timestamp of previous vector expiry list traversal */
@@ -225,14 +236,21 @@ struct eth_rx_queue_info {
 	int queue_enabled;	/* True if added */
 	int intr_enabled;
 	uint8_t ena_vector;
+	uint8_t ena_seqn;	/* Set reorder sequence number of mbufs */
 	uint16_t wt;		/* Polling weight */
+	uint32_t seqn;		/* Next reorder sequence number */
 	uint32_t flow_id_mask;	/* Set to ~0 if app provides flow id else 0 */
 	uint64_t event;
 	struct eth_rx_vector_data vector_data;
+	/* Event burst buffer, with per Rx queue buffers */
+	struct rte_eth_event_enqueue_buffer event_buf;
 };
 
 static struct rte_event_eth_rx_adapter **event_eth_rx_adapter;
 
+/* Offset of the reorder sequence number in mbufs */
+static int rxa_seqn_dynfield_offset = -1;
+
 static inline int
 rxa_validate_id(uint8_t id)
 {
@@ -704,6 +722,55 @@ rxa_do_softrss(struct rte_mbuf *m, const uint8_t *rss_key_be)
 	return rte_softrss_be(tuple, input_len, rss_key_be);
 }
 
+/*
+ * Compute the soft RSS hash of a burst of mbufs with the GFNI Toeplitz hash.
+ * The address pairs are contiguous and in network order in the headers, so
+ * they are hashed in place, the IPv4 and IPv6 ones in separate bulks.
+ */
+static inline void
+rxa_do_softrss_bulk(struct rte_event_eth_rx_adapter *rx_adapter,
+		struct rte_mbuf **mbufs, uint16_t num, uint32_t *rss)
+{
+	uint8_t *v4_tuple[BATCH_SIZE];
+	uint8_t *v6_tuple[BATCH_SIZE];
+	uint32_t v4_rss[BATCH_SIZE];
+	uint32_t v6_rss[BATCH_SIZE];
+	uint16_t v4_idx[BATCH_SIZE];
+	uint16_t v6_idx[BATCH_SIZE];
+	uint16_t nb_v4 = 0;
+	uint16_t nb_v6 = 0;
+	struct rte_ipv4_hdr *ipv4_hdr;
+	struct rte_ipv6_hdr *ipv6_hdr;
+	uint16_t i;
+
+	for (i = 0; i < num; i++) {
+		rxa_mtoip(mbufs[i], &ipv4_hdr, &ipv6_hdr);
+		rss[i] = 0;
+		if (ipv4_hdr) {
+			v4_idx[nb_v4] = i;
+			v4_tuple[nb_v4++] = (uint8_t *)&ipv4_hdr->src_addr;
+		} else if (ipv6_hdr) {
+			v6_idx[nb_v6] = i;
+			v6_tuple[nb_v6++] = ipv6_hdr->src_addr;
+		}
+	}
+
+	if (nb_v4) {
+		rte_thash_gfni_bulk(rx_adapter->rss_key_mtrx,
+				RTE_THASH_V4_L3_LEN * sizeof(uint32_t),
+				v4_tuple, v4_rss, nb_v4);
+		for (i = 0; i < nb_v4; i++)
+			rss[v4_idx[i]] = v4_rss[i];
+	}
+	if (nb_v6) {
+		rte_thash_gfni_bulk(rx_adapter->rss_key_mtrx,
+				RTE_THASH_V6_L3_LEN * sizeof(uint32_t),
+				v6_tuple, v6_rss, nb_v6);
+		for (i = 0; i < nb_v6; i++)
+			rss[v6_idx[i]] = v6_rss[i];
+	}
+}
+
 static inline int
 rxa_enq_blocked(struct rte_event_eth_rx_adapter *rx_adapter)
 {
@@ -742,12 +809,21 @@ rxa_enq_block_end_ts(struct rte_event_eth_rx_adapter *rx_adapter,
 	}
 }
 
+static inline struct rte_eth_event_enqueue_buffer *
+rxa_event_buf_get(struct rte_event_eth_rx_adapter *rx_adapter,
+		uint16_t eth_dev_id, uint16_t rx_queue_id)
+{
+	if (rx_adapter->use_queue_event_buf)
+		return &rx_adapter->eth_devices[eth_dev_id]
+				.rx_queue[rx_queue_id].event_buf;
+	return &rx_adapter->event_enqueue_buffer;
+}
+
 /* Enqueue buffered events to event device */
 static inline uint16_t
-rxa_flush_event_buffer(struct rte_event_eth_rx_adapter *rx_adapter)
+rxa_flush_event_buffer(struct rte_event_eth_rx_adapter *rx_adapter,
+		struct rte_eth_event_enqueue_buffer *buf)
 {
-	struct rte_eth_event_enqueue_buffer *buf =
-	    &rx_adapter->event_enqueue_buffer;
 	struct rte_event_eth_rx_adapter_stats *stats = &rx_adapter->stats;
 
 	if (!buf->count)
@@ -849,34 +925,51 @@ rxa_buffer_mbufs(struct rte_event_eth_rx_adapter *rx_adapter,
 		uint16_t eth_dev_id,
 		uint16_t rx_queue_id,
 		struct rte_mbuf **mbufs,
-		uint16_t num)
+		uint16_t num,
+		struct rte_eth_event_enqueue_buffer *buf)
 {
 	uint32_t i;
 	struct eth_device_info *dev_info =
 					&rx_adapter->eth_devices[eth_dev_id];
 	struct eth_rx_queue_info *eth_rx_queue_info =
 					&dev_info->rx_queue[rx_queue_id];
-	struct rte_eth_event_enqueue_buffer *buf =
-					&rx_adapter->event_enqueue_buffer;
 	struct rte_event *ev = &buf->events[buf->count];
 	uint64_t event = eth_rx_queue_info->event;
 	uint32_t flow_id_mask = eth_rx_queue_info->flow_id_mask;
 	struct rte_mbuf *m = mbufs[0];
+	uint32_t rss_bulk[BATCH_SIZE];
 	uint32_t rss_mask;
 	uint32_t rss;
 	int do_rss;
+	int do_rss_bulk;
 	uint16_t nb_cb;
 	uint16_t dropped;
 
+	if (eth_rx_queue_info->ena_seqn) {
+		uint32_t seqn = eth_rx_queue_info->seqn;
+
+		for (i = 0; i < num; i++)
+			*RTE_MBUF_DYNFIELD(mbufs[i], rxa_seqn_dynfield_offset,
+				uint32_t *) = seqn++;
+		eth_rx_queue_info->seqn = seqn;
+	}
+
 	if (!eth_rx_queue_info->ena_vector) {
 		/* 0xffff ffff if PKT_RX_RSS_HASH is set, otherwise 0 */
 		rss_mask = ~(((m->ol_flags & PKT_RX_RSS_HASH) != 0) - 1);
 		do_rss = !rss_mask && !eth_rx_queue_info->flow_id_mask;
+		do_rss_bulk = do_rss && rx_adapter->softrss_bulk;
+		if (do_rss_bulk)
+			rxa_do_softrss_bulk(rx_adapter, mbufs, num, rss_bulk);
 		for (i = 0; i < num; i++) {
 			m = mbufs[i];
 
-			rss = do_rss ? rxa_do_softrss(m, rx_adapter->rss_key_be)
-				     : m->hash.rss;
+			if (do_rss_bulk)
+				rss = rss_bulk[i];
+			else
+				rss = do_rss ?
+				      rxa_do_softrss(m, rx_adapter->rss_key_be) :
+				      m->hash.rss;
 			ev->event = event;
 			ev->flow_id = (rss & ~flow_id_mask) |
 				      (ev->flow_id & flow_id_mask);
@@ -892,7 +985,7 @@ rxa_buffer_mbufs(struct rte_event_eth_rx_adapter *rx_adapter,
 
 		dropped = 0;
 		nb_cb = dev_info->cb_fn(eth_dev_id, rx_queue_id,
-					ETH_EVENT_BUFFER_SIZE, buf->count,
+					buf->events_size, buf->count,
 					&buf->events[buf->count], num,
 					dev_info->cb_arg, &dropped);
 		if (unlikely(nb_cb > num))
@@ -914,11 +1007,10 @@ rxa_eth_rx(struct rte_event_eth_rx_adapter *rx_adapter,
 	uint16_t queue_id,
 	uint32_t rx_count,
 	uint32_t max_rx,
-	int *rxq_empty)
+	int *rxq_empty,
+	struct rte_eth_event_enqueue_buffer *buf)
 {
 	struct rte_mbuf *mbufs[BATCH_SIZE];
-	struct rte_eth_event_enqueue_buffer *buf =
-					&rx_adapter->event_enqueue_buffer;
 	struct rte_event_eth_rx_adapter_stats *stats =
 					&rx_adapter->stats;
 	uint16_t n;
@@ -929,9 +1021,9 @@ rxa_eth_rx(struct rte_event_eth_rx_adapter *rx_adapter,
 	/* Don't do a batch dequeue from the rx queue if there isn't
 	 * enough space in the enqueue buffer.
 	 */
-	while (BATCH_SIZE <= (RTE_DIM(buf->events) - buf->count)) {
+	while (BATCH_SIZE <= (buf->events_size - buf->count)) {
 		if (buf->count >= BATCH_SIZE)
-			rxa_flush_event_buffer(rx_adapter);
+			rxa_flush_event_buffer(rx_adapter, buf);
 
 		stats->rx_poll_count++;
 		n = rte_eth_rx_burst(port_id, queue_id, mbufs, BATCH_SIZE);
@@ -940,14 +1032,14 @@ rxa_eth_rx(struct rte_event_eth_rx_adapter *rx_adapter,
 				*rxq_empty = 1;
 			break;
 		}
-		rxa_buffer_mbufs(rx_adapter, port_id, queue_id, mbufs, n);
+		rxa_buffer_mbufs(rx_adapter, port_id, queue_id, mbufs, n, buf);
 		nb_rx += n;
 		if (rx_count + nb_rx > max_rx)
 			break;
 	}
 
 	if (buf->count > 0)
-		rxa_flush_event_buffer(rx_adapter);
+		rxa_flush_event_buffer(rx_adapter, buf);
 
 	return nb_rx;
 }
@@ -1088,9 +1180,11 @@ rxa_intr_ring_dequeue(struct rte_event_eth_rx_adapter *rx_adapter)
 	ring_lock = &rx_adapter->intr_ring_lock;
 
 	if (buf->count >= BATCH_SIZE)
-		rxa_flush_event_buffer(rx_adapter);
+		rxa_flush_event_buffer(rx_adapter, buf);
 
-	while (BATCH_SIZE <= (RTE_DIM(buf->events) - buf->count)) {
+	/* with per Rx queue buffers, the space is checked by rxa_eth_rx() */
+	while (rx_adapter->use_queue_event_buf ||
+	       BATCH_SIZE <= (buf->events_size - buf->count)) {
 		struct eth_device_info *dev_info;
 		uint16_t port;
 		uint16_t queue;
@@ -1140,7 +1234,8 @@ rxa_intr_ring_dequeue(struct rte_event_eth_rx_adapter *rx_adapter)
 					continue;
 				n = rxa_eth_rx(rx_adapter, port, i, nb_rx,
 					rx_adapter->max_nb_rx,
-					&rxq_empty);
+					&rxq_empty,
+					rxa_event_buf_get(rx_adapter, port, i));
 				nb_rx += n;
 
 				enq_buffer_full = !rxq_empty && n == 0;
@@ -1161,10 +1256,13 @@ rxa_intr_ring_dequeue(struct rte_event_eth_rx_adapter *rx_adapter)
 		} else {
 			n = rxa_eth_rx(rx_adapter, port, queue, nb_rx,
 				rx_adapter->max_nb_rx,
-				&rxq_empty);
+				&rxq_empty,
+				rxa_event_buf_get(rx_adapter, port, queue));
 			rx_adapter->qd_valid = !rxq_empty;
 			nb_rx += n;
-			if (nb_rx > rx_adapter->max_nb_rx)
+			/* stop on a full event buffer too */
+			if (nb_rx > rx_adapter->max_nb_rx ||
+			    (n == 0 && !rxq_empty))
 				break;
 		}
 	}
@@ -1206,24 +1304,31 @@ rxa_poll(struct rte_event_eth_rx_adapter *rx_adapter)
 		uint16_t qid = rx_adapter->eth_rx_poll[poll_idx].eth_rx_qid;
 		uint16_t d = rx_adapter->eth_rx_poll[poll_idx].eth_dev_id;
 
+		if (rx_adapter->use_queue_event_buf)
+			buf = rxa_event_buf_get(rx_adapter, d, qid);
+
 		/* Don't do a batch dequeue from the rx queue if there isn't
-		 * enough space in the enqueue buffer.
+		 * enough space in the enqueue buffer. With a buffer per
+		 * queue, only this queue is skipped.
 		 */
 		if (buf->count >= BATCH_SIZE)
-			rxa_flush_event_buffer(rx_adapter);
-		if (BATCH_SIZE > (ETH_EVENT_BUFFER_SIZE - buf->count)) {
+			rxa_flush_event_buffer(rx_adapter, buf);
+		if (BATCH_SIZE > (buf->events_size - buf->count)) {
+			if (rx_adapter->use_queue_event_buf)
+				goto poll_next_entry;
 			rx_adapter->wrr_pos = wrr_pos;
 			return nb_rx;
 		}
 
 		nb_rx += rxa_eth_rx(rx_adapter, d, qid, nb_rx, max_nb_rx,
-				NULL);
+				NULL, buf);
 		if (nb_rx > max_nb_rx) {
 			rx_adapter->wrr_pos =
 				    (wrr_pos + 1) % rx_adapter->wrr_len;
 			break;
 		}
 
+poll_next_entry:
 		if (++wrr_pos == rx_adapter->wrr_len)
 			wrr_pos = 0;
 	}
@@ -1234,12 +1339,12 @@ static void
 rxa_vector_expire(struct eth_rx_vector_data *vec, void *arg)
 {
 	struct rte_event_eth_rx_adapter *rx_adapter = arg;
-	struct rte_eth_event_enqueue_buffer *buf =
-		&rx_adapter->event_enqueue_buffer;
+	struct rte_eth_event_enqueue_buffer *buf;
 	struct rte_event *ev;
 
+	buf = rxa_event_buf_get(rx_adapter, vec->port, vec->queue);
 	if (buf->count)
-		rxa_flush_event_buffer(rx_adapter);
+		rxa_flush_event_buffer(rx_adapter, buf);
 
 	if (vec->vector_ev->nb_elem == 0)
 		return;
@@ -1259,6 +1364,7 @@ rxa_service_func(void *args)
 {
 	struct rte_event_eth_rx_adapter *rx_adapter = args;
 	struct rte_event_eth_rx_adapter_stats *stats;
+	uint32_t nb_rx;
 
 	if (rte_spinlock_trylock(&rx_adapter->rx_lock) == 0)
 		return 0;
@@ -1286,10 +1392,11 @@ rxa_service_func(void *args)
 	}
 
 	stats = &rx_adapter->stats;
-	stats->rx_packets += rxa_intr_ring_dequeue(rx_adapter);
-	stats->rx_packets += rxa_poll(rx_adapter);
+	nb_rx = rxa_intr_ring_dequeue(rx_adapter);
+	nb_rx += rxa_poll(rx_adapter);
+	stats->rx_packets += nb_rx;
 	rte_spinlock_unlock(&rx_adapter->rx_lock);
-	return 0;
+	return nb_rx == 0 ? -EAGAIN : 0;
 }
 
 static int
@@ -1810,6 +1917,66 @@ rxa_set_vector_data(struct eth_rx_queue_info *queue_info, uint16_t vector_count,
 	vector_data->event = (queue_info->event & ~0xFFFFF) | flow_id;
 }
 
+static int
+rxa_event_buf_alloc(struct rte_event_eth_rx_adapter *rx_adapter,
+		struct rte_eth_event_enqueue_buffer *buf)
+{
+	buf->events = rte_zmalloc_socket(rx_adapter->mem_name,
+				rx_adapter->event_buf_size *
+				sizeof(struct rte_event), 0,
+				rx_adapter->socket_id);
+	if (buf->events == NULL)
+		return -ENOMEM;
+	buf->events_size = rx_adapter->event_buf_size;
+	buf->count = 0;
+	return 0;
+}
+
+static int
+rxa_queue_event_buf_alloc(struct rte_event_eth_rx_adapter *rx_adapter,
+		struct eth_device_info *dev_info,
+		int32_t rx_queue_id)
+{
+	struct rte_eth_event_enqueue_buffer *buf;
+	uint16_t i;
+	int ret;
+
+	if (rx_queue_id == -1) {
+		for (i = 0; i < dev_info->dev->data->nb_rx_queues; i++) {
+			ret = rxa_queue_event_buf_alloc(rx_adapter, dev_info,
+							i);
+			if (ret)
+				return ret;
+		}
+		return 0;
+	}
+
+	buf = &dev_info->rx_queue[rx_queue_id].event_buf;
+	if (buf->events != NULL)
+		return 0;
+	return rxa_event_buf_alloc(rx_adapter, buf);
+}
+
+static void
+rxa_queue_event_buf_free(struct eth_device_info *dev_info,
+		int32_t rx_queue_id)
+{
+	struct rte_eth_event_enqueue_buffer *buf;
+	uint16_t i;
+
+	if (rx_queue_id == -1) {
+		for (i = 0; i < dev_info->dev->data->nb_rx_queues; i++)
+			rxa_queue_event_buf_free(dev_info, i);
+		return;
+	}
+
+	buf = &dev_info->rx_queue[rx_queue_id].event_buf;
+	rte_free(buf->events);
+	buf->events = NULL;
+	buf->events_size = 0;
+	buf->count = 0;
+}
+
 static void
 rxa_sw_del(struct rte_event_eth_rx_adapter *rx_adapter,
 	struct eth_device_info *dev_info,
@@ -1842,6 +2009,19 @@ rxa_sw_del(struct rte_event_eth_rx_adapter *rx_adapter,
 		TAILQ_REMOVE(&rx_adapter->vector_list, vec, next);
 	}
 
+	if (rx_adapter->use_queue_event_buf) {
+		struct rte_eth_event_enqueue_buffer *buf =
+			&dev_info->rx_queue[rx_queue_id].event_buf;
+
+		/* Push the buffered events before freeing the buffer. */
+		rxa_flush_event_buffer(rx_adapter, buf);
+		if (buf->count)
+			RTE_EDEV_LOG_ERR("%" PRIu16 " events of Rx queue %"
+				PRId32 " could not be enqueued", buf->count,
+				rx_queue_id);
+		rxa_queue_event_buf_free(dev_info, rx_queue_id);
+	}
+
 	pollq = rxa_polled_queue(dev_info, rx_queue_id);
 	intrq = rxa_intr_queue(dev_info, rx_queue_id);
 	sintrq = rxa_shared_intr(dev_info, rx_queue_id);
@@ -1895,6 +2075,10 @@ rxa_add_queue(struct rte_event_eth_rx_adapter *rx_adapter,
 	} else
 		qi_ev->flow_id = 0;
 
+	queue_info->ena_seqn = !!(conf->rx_queue_flags &
+			RTE_EVENT_ETH_RX_ADAPTER_QUEUE_REORDER_SEQN);
+	queue_info->seqn = 0;
+
 	rxa_update_queue(rx_adapter, dev_info, rx_queue_id, 1);
 	if (rxa_polled_queue(dev_info, rx_queue_id)) {
 		rx_adapter->num_rx_polled += !pollq;
@@ -2000,6 +2184,13 @@ static int rxa_sw_add(struct rte_event_eth_rx_adapter *rx_adapter,
 	rx_wrr = NULL;
 	rx_poll = NULL;
 
+	if (rx_adapter->use_queue_event_buf) {
+		ret = rxa_queue_event_buf_alloc(rx_adapter, dev_info,
+						rx_queue_id);
+		if (ret)
+			goto err_free_rxqueue;
+	}
+
 	rxa_calc_nb_post_add(rx_adapter, dev_info, rx_queue_id,
 			queue_conf->servicing_weight,
 			&nb_rx_poll, &nb_rx_intr, &nb_wrr);
@@ -2075,6 +2266,7 @@ static int rxa_sw_add(struct rte_event_eth_rx_adapter *rx_adapter,
 
 err_free_rxqueue:
 	if (rx_queue == NULL) {
+		rxa_queue_event_buf_free(dev_info, -1);
 		rte_free(dev_info->rx_queue);
 		dev_info->rx_queue = NULL;
 	}
@@ -2130,10 +2322,11 @@ rxa_ctrl(uint8_t id, int start)
 	return 0;
 }
 
-int
-rte_event_eth_rx_adapter_create_ext(uint8_t id, uint8_t dev_id,
-				rte_event_eth_rx_adapter_conf_cb conf_cb,
-				void *conf_arg)
+static int
+rxa_create(uint8_t id, uint8_t dev_id,
+	   struct rte_event_eth_rx_adapter_params *rxa_params,
+	   rte_event_eth_rx_adapter_conf_cb conf_cb,
+	   void *conf_arg)
 {
 	struct rte_event_eth_rx_adapter *rx_adapter;
 	int ret;
@@ -2182,6 +2375,8 @@ rte_event_eth_rx_adapter_create_ext(uint8_t id, uint8_t dev_id,
 	rx_adapter->conf_cb = conf_cb;
 	rx_adapter->conf_arg = conf_arg;
 	rx_adapter->id = id;
+	rx_adapter->event_buf_size = rxa_params->event_buf_size;
+	rx_adapter->use_queue_event_buf = rxa_params->use_queue_event_buf;
 	TAILQ_INIT(&rx_adapter->vector_list);
 	strcpy(rx_adapter->mem_name, mem_name);
 	rx_adapter->eth_devices = rte_zmalloc_socket(rx_adapter->mem_name,
@@ -2191,12 +2386,25 @@ rte_event_eth_rx_adapter_create_ext(uint8_t id, uint8_t dev_id,
 	rte_convert_rss_key((const uint32_t *)default_rss_key,
 			(uint32_t *)rx_adapter->rss_key_be,
 			    RTE_DIM(default_rss_key));
+	rx_adapter->softrss_bulk = rte_thash_gfni_supported();
+	if (rx_adapter->softrss_bulk)
+		rte_thash_complete_matrix(rx_adapter->rss_key_mtrx,
+				default_rss_key, RTE_DIM(default_rss_key));
 
 	if (rx_adapter->eth_devices == NULL) {
 		RTE_EDEV_LOG_ERR("failed to get mem for eth devices\n");
 		rte_free(rx_adapter);
 		return -ENOMEM;
 	}
+
+	if (!rx_adapter->use_queue_event_buf &&
+	    rxa_event_buf_alloc(rx_adapter,
+				&rx_adapter->event_enqueue_buffer)) {
+		RTE_EDEV_LOG_ERR("failed to get mem for event buffer\n");
+		rte_free(rx_adapter->eth_devices);
+		rte_free(rx_adapter);
+		return -ENOMEM;
+	}
 	rte_spinlock_init(&rx_adapter->rx_lock);
 	for (i = 0; i < RTE_MAX_ETHPORTS; i++)
 		rx_adapter->eth_devices[i].dev = &rte_eth_devices[i];
@@ -2210,9 +2418,25 @@ rte_event_eth_rx_adapter_create_ext(uint8_t id, uint8_t dev_id,
 }
 
 int
-rte_event_eth_rx_adapter_create(uint8_t id, uint8_t dev_id,
-		struct rte_event_port_conf *port_config)
+rte_event_eth_rx_adapter_create_ext(uint8_t id, uint8_t dev_id,
+				rte_event_eth_rx_adapter_conf_cb conf_cb,
+				void *conf_arg)
 {
+	struct rte_event_eth_rx_adapter_params rxa_params = {
+		.event_buf_size = ETH_EVENT_BUFFER_SIZE,
+	};
+
+	return rxa_create(id, dev_id, &rxa_params, conf_cb, conf_arg);
+}
+
+int
+rte_event_eth_rx_adapter_create_with_params(uint8_t id, uint8_t dev_id,
+			struct rte_event_port_conf *port_config,
+			struct rte_event_eth_rx_adapter_params *rxa_params)
+{
+	struct rte_event_eth_rx_adapter_params temp_params = {
+		.event_buf_size = ETH_EVENT_BUFFER_SIZE,
+	};
 	struct rte_event_port_conf *pc;
 	int ret;
 
@@ -2220,18 +2444,38 @@ rte_event_eth_rx_adapter_create(uint8_t id, uint8_t dev_id,
 		return -EINVAL;
 	RTE_EVENT_ETH_RX_ADAPTER_ID_VALID_OR_ERR_RET(id, -EINVAL);
 
+	if (rxa_params != NULL) {
+		if (rxa_params->event_buf_size == 0 ||
+		    rxa_params->event_buf_size >
+				UINT16_MAX - BATCH_SIZE + 1) {
+			RTE_EDEV_LOG_ERR("Invalid event buffer size %" PRIu16,
+				rxa_params->event_buf_size);
+			return -EINVAL;
+		}
+		temp_params = *rxa_params;
+		/* a buffer holds whole bursts */
+		temp_params.event_buf_size =
+			RTE_ALIGN(temp_params.event_buf_size, BATCH_SIZE);
+	}
+
 	pc = rte_malloc(NULL, sizeof(*pc), 0);
 	if (pc == NULL)
 		return -ENOMEM;
 	*pc = *port_config;
-	ret = rte_event_eth_rx_adapter_create_ext(id, dev_id,
-					rxa_default_conf_cb,
-					pc);
+	ret = rxa_create(id, dev_id, &temp_params, rxa_default_conf_cb, pc);
 	if (ret)
 		rte_free(pc);
 	return ret;
 }
 
+int
+rte_event_eth_rx_adapter_create(uint8_t id, uint8_t dev_id,
+		struct rte_event_port_conf *port_config)
+{
+	return rte_event_eth_rx_adapter_create_with_params(id, dev_id,
+					port_config, NULL);
+}
+
 int
 rte_event_eth_rx_adapter_free(uint8_t id)
 {
@@ -2251,6 +2495,7 @@ rte_event_eth_rx_adapter_free(uint8_t id)
 
 	if (rx_adapter->default_cb_arg)
 		rte_free(rx_adapter->conf_arg);
+	rte_free(rx_adapter->event_enqueue_buffer.events);
 	rte_free(rx_adapter->eth_devices);
 	rte_free(rx_adapter);
 	event_eth_rx_adapter[id] = NULL;
@@ -2259,6 +2504,30 @@ rte_event_eth_rx_adapter_free(uint8_t id)
 	return 0;
 }
 
+static int
+rxa_seqn_dynfield_register(void)
+{
+	static const struct rte_mbuf_dynfield rxa_seqn_dynfield_desc = {
+		.name = RTE_MBUF_DYNFIELD_REORDER_SEQN_NAME,
+		.size = sizeof(uint32_t),
+		.align = __alignof__(uint32_t),
+		.flags = RTE_MBUF_DYNFIELD_F_HOT,
+	};
+
+	if (rxa_seqn_dynfield_offset >= 0)
+		return 0;
+
+	rxa_seqn_dynfield_offset =
+		rte_mbuf_dynfield_register(&rxa_seqn_dynfield_desc);
+	if (rxa_seqn_dynfield_offset < 0) {
+		RTE_EDEV_LOG_ERR("Failed to register mbuf field for reorder"
+				" sequence number");
+		return -rte_errno;
+	}
+
+	return 0;
+}
+
 int
 rte_event_eth_rx_adapter_queue_add(uint8_t id,
 		uint16_t eth_dev_id,
@@ -2306,6 +2575,20 @@ rte_event_eth_rx_adapter_queue_add(uint8_t id,
 		return -EINVAL;
 	}
 
+	if (queue_conf->rx_queue_flags &
+			RTE_EVENT_ETH_RX_ADAPTER_QUEUE_REORDER_SEQN) {
+		if (cap & RTE_EVENT_ETH_RX_ADAPTER_CAP_INTERNAL_PORT) {
+			RTE_EDEV_LOG_ERR("Reorder sequence number is not"
+					" supported, eth port: %" PRIu16
+					" adapter id: %" PRIu8,
+					eth_dev_id, id);
+			return -ENOTSUP;
+		}
+		ret = rxa_seqn_dynfield_register();
+		if (ret)
+			return ret;
+	}
+
 	if ((cap & RTE_EVENT_ETH_RX_ADAPTER_CAP_MULTI_EVENTQ) == 0 &&
 		(rx_queue_id != -1)) {
 		RTE_EDEV_LOG_ERR("Rx queues can only be connected to single "
@@ -2479,6 +2762,7 @@ rte_event_eth_rx_adapter_queue_del(uint8_t id, uint16_t eth_dev_id,
 		rx_adapter->num_intr_vec += num_intr_vec;
 
 		if (dev_info->nb_dev_queues == 0) {
+			rxa_queue_event_buf_free(dev_info, -1);
 			rte_free(dev_info->rx_queue);
 			dev_info->rx_queue = NULL;
 		}
@@ -26,6 +26,7 @@
  * The ethernet Rx event adapter's functions are:
  *  - rte_event_eth_rx_adapter_create_ext()
  *  - rte_event_eth_rx_adapter_create()
+ *  - rte_event_eth_rx_adapter_create_with_params()
  *  - rte_event_eth_rx_adapter_free()
  *  - rte_event_eth_rx_adapter_queue_add()
  *  - rte_event_eth_rx_adapter_queue_del()
@@ -35,8 +36,8 @@
  *  - rte_event_eth_rx_adapter_stats_reset()
  *
  * The application creates an ethernet to event adapter using
- * rte_event_eth_rx_adapter_create_ext() or rte_event_eth_rx_adapter_create()
- * functions.
+ * rte_event_eth_rx_adapter_create_ext(), rte_event_eth_rx_adapter_create()
+ * or rte_event_eth_rx_adapter_create_with_params() functions.
  * The adapter needs to know which ethernet rx queues to poll for mbufs as well
  * as event device parameters such as the event queue identifier, event
  * priority and scheduling type that the adapter should use when constructing
@@ -73,12 +74,19 @@
  * allows the application to register a callback that selects which packets are
  * enqueued to the event device by the SW adapter. The callback interface is
  * event based so the callback can also modify the event data if it needs to.
+ *
+ * By default, the event buffer is shared by all the Rx queues of the adapter,
+ * so that the events of a queue which cannot reach the event device hold back
+ * the other queues. The rte_event_eth_rx_adapter_create_with_params()
+ * function allows the application to give each Rx queue its own event buffer,
+ * and to set the size of the event buffers.
  */
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include <rte_service.h>
@@ -96,6 +104,15 @@ extern "C" {
 /**< This flag indicates that mbufs arriving on the queue need to be vectorized
  * @see rte_event_eth_rx_adapter_queue_conf::rx_queue_flags
  */
+#define RTE_EVENT_ETH_RX_ADAPTER_QUEUE_REORDER_SEQN	0x4
+/**< This flag indicates that the adapter sets the reorder sequence number
+ * of the mbufs arriving on the queue, counting from 0 when the queue is
+ * added. The mbufs can then be reordered with the reorder library after
+ * being processed on parallel event queues.
+ * It is not supported with an internal event port.
+ * @see rte_event_eth_rx_adapter_queue_conf::rx_queue_flags
+ * @see RTE_MBUF_DYNFIELD_REORDER_SEQN_NAME
+ */
 
 /**
  * Adapter configuration structure that the adapter configuration callback
@@ -259,6 +276,23 @@ struct rte_event_eth_rx_adapter_vector_limits {
 	 */
 };
 
+/**
+ * A structure used to create an Rx adapter with parameters.
+ * @see rte_event_eth_rx_adapter_create_with_params()
+ */
+struct rte_event_eth_rx_adapter_params {
+	uint16_t event_buf_size;
+	/**< Size of the event buffer of the adapter, or of each Rx queue
+	 * when use_queue_event_buf is set. It is rounded up to a multiple of
+	 * the burst size of the service function, which is 32 events.
+	 */
+	bool use_queue_event_buf;
+	/**< If set, each Rx queue has its own event buffer, so that the
+	 * back pressure of the event device on a queue does not stop the
+	 * polling of the other queues.
+	 */
+};
+
 /**
  *
  * Callback function invoked by the SW adapter before it continues
@@ -359,6 +393,37 @@ int rte_event_eth_rx_adapter_create_ext(uint8_t id, uint8_t dev_id,
 int rte_event_eth_rx_adapter_create(uint8_t id, uint8_t dev_id,
 				struct rte_event_port_conf *port_config);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Create a new ethernet Rx event adapter with the specified identifier,
+ * like rte_event_eth_rx_adapter_create(), with the event buffers of the
+ * adapter set up according to rxa_params.
+ *
+ * @param id
+ *  The identifier of the ethernet Rx event adapter.
+ *
+ * @param dev_id
+ *  The identifier of the device to configure.
+ *
+ * @param port_config
+ *  Argument of type *rte_event_port_conf* that is passed to the conf_cb
+ *  function.
+ *
+ * @param rxa_params
+ *  Pointer to the adapter parameters, NULL to use the default ones of
+ *  rte_event_eth_rx_adapter_create().
+ *
+ * @return
+ *   - 0: Success
+ *   - <0: Error code on failure
+ */
+__rte_experimental
+int rte_event_eth_rx_adapter_create_with_params(uint8_t id, uint8_t dev_id,
+			struct rte_event_port_conf *port_config,
+			struct rte_event_eth_rx_adapter_params *rxa_params);
+
 /**
  * Free an event adapter
  *
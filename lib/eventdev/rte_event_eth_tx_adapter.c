@@ -92,6 +92,8 @@ struct txa_service_queue_info {
 	struct txa_retry txa_retry;
 	/* Tx buffer */
 	struct rte_eth_dev_tx_buffer *tx_buf;
+	/* Serialize the service and direct transmits to the queue */
+	rte_spinlock_t tx_lock;
 };
 
 /* PMD private structure */
@@ -510,14 +512,74 @@ txa_service_buffer_retry(struct rte_mbuf **pkts, uint16_t unsent,
 	stats->tx_dropped += unsent - sent;
 }
 
+/* Transmit a run of mbufs to a Tx queue. The service buffers them, the
+ * direct transmits send them right away, and free those which could not be
+ * sent after some retries.
+ */
+static inline uint16_t
+txa_queue_tx(struct txa_service_queue_info *tqi, uint16_t port,
+	     uint16_t queue, struct rte_mbuf **mbufs, uint16_t n, bool direct)
+{
+	unsigned int retry = 0;
+	uint16_t i, nb_tx = 0;
+
+	rte_spinlock_lock(&tqi->tx_lock);
+	if (direct) {
+		do {
+			nb_tx += rte_eth_tx_burst(port, queue, &mbufs[nb_tx],
+						  n - nb_tx);
+		} while (nb_tx != n && retry++ < TXA_RETRY_CNT);
+	} else {
+		for (i = 0; i < n; i++)
+			nb_tx += rte_eth_tx_buffer(port, queue, tqi->tx_buf,
+						   mbufs[i]);
+	}
+	rte_spinlock_unlock(&tqi->tx_lock);
+
+	if (direct && nb_tx != n)
+		rte_pktmbuf_free_bulk(&mbufs[nb_tx], n - nb_tx);
+
+	return nb_tx;
+}
+
+/* Transmit mbufs, each run of mbufs to the same Tx queue at once */
+static uint16_t
+txa_mbufs_tx(struct txa_service_data *txa, struct rte_mbuf **mbufs,
+	     uint16_t n, bool direct)
+{
+	struct txa_service_queue_info *tqi;
+	uint16_t i, nb_run, port, queue;
+	uint16_t nb_tx = 0;
+
+	for (i = 0; i < n; i += nb_run) {
+		port = mbufs[i]->port;
+		queue = rte_event_eth_tx_adapter_txq_get(mbufs[i]);
+		for (nb_run = 1; i + nb_run < n; nb_run++) {
+			if (mbufs[i + nb_run]->port != port ||
+			    rte_event_eth_tx_adapter_txq_get(
+					mbufs[i + nb_run]) != queue)
+				break;
+		}
+
+		tqi = txa_service_queue(txa, port, queue);
+		if (unlikely(tqi == NULL || !tqi->added)) {
+			rte_pktmbuf_free_bulk(&mbufs[i], nb_run);
+			continue;
+		}
+		nb_tx += txa_queue_tx(tqi, port, queue, &mbufs[i], nb_run,
+				      direct);
+	}
+
+	return nb_tx;
+}
+
 static uint16_t
 txa_process_event_vector(struct txa_service_data *txa,
-			 struct rte_event_vector *vec)
+			 struct rte_event_vector *vec, bool direct)
 {
 	struct txa_service_queue_info *tqi;
 	uint16_t port, queue, nb_tx = 0;
 	struct rte_mbuf **mbufs;
-	int i;
 
 	mbufs = (struct rte_mbuf **)vec->mbufs;
 	if (vec->attr_valid) {
@@ -529,64 +591,70 @@ txa_process_event_vector(struct txa_service_data *txa,
 			rte_mempool_put(rte_mempool_from_obj(vec), vec);
 			return 0;
 		}
-		for (i = 0; i < vec->nb_elem; i++) {
-			nb_tx += rte_eth_tx_buffer(port, queue, tqi->tx_buf,
-						   mbufs[i]);
-		}
+		nb_tx = txa_queue_tx(tqi, port, queue, mbufs, vec->nb_elem,
+				     direct);
 	} else {
-		for (i = 0; i < vec->nb_elem; i++) {
-			port = mbufs[i]->port;
-			queue = rte_event_eth_tx_adapter_txq_get(mbufs[i]);
-			tqi = txa_service_queue(txa, port, queue);
-			if (unlikely(tqi == NULL || !tqi->added)) {
-				rte_pktmbuf_free(mbufs[i]);
-				continue;
-			}
-			nb_tx += rte_eth_tx_buffer(port, queue, tqi->tx_buf,
-						   mbufs[i]);
-		}
+		nb_tx = txa_mbufs_tx(txa, mbufs, vec->nb_elem, direct);
 	}
 	rte_mempool_put(rte_mempool_from_obj(vec), vec);
 
 	return nb_tx;
 }
 
-static void
-txa_service_tx(struct txa_service_data *txa, struct rte_event *ev,
-	uint32_t n)
+static uint16_t
+txa_events_tx(struct txa_service_data *txa, struct rte_event *ev,
+	      uint32_t n, bool direct)
 {
+	struct rte_mbuf *mbufs[TXA_BATCH_SIZE];
+	uint16_t nb_mbufs, nb_tx;
 	uint32_t i;
-	uint16_t nb_tx;
-	struct rte_event_eth_tx_adapter_stats *stats;
-
-	stats = &txa->stats;
 
 	nb_tx = 0;
+	nb_mbufs = 0;
 	for (i = 0; i < n; i++) {
-		uint16_t port;
-		uint16_t queue;
-		struct txa_service_queue_info *tqi;
-
 		if (!(ev[i].event_type & RTE_EVENT_TYPE_VECTOR)) {
-			struct rte_mbuf *m;
+			mbufs[nb_mbufs++] = ev[i].mbuf;
+			if (nb_mbufs < RTE_DIM(mbufs))
+				continue;
+		}
 
-			m = ev[i].mbuf;
-			port = m->port;
-			queue = rte_event_eth_tx_adapter_txq_get(m);
+		/* the mbufs gathered so far go first to keep their order */
+		nb_tx += txa_mbufs_tx(txa, mbufs, nb_mbufs, direct);
+		nb_mbufs = 0;
+		if (ev[i].event_type & RTE_EVENT_TYPE_VECTOR)
+			nb_tx += txa_process_event_vector(txa, ev[i].vec,
+							  direct);
+	}
+	nb_tx += txa_mbufs_tx(txa, mbufs, nb_mbufs, direct);
 
-			tqi = txa_service_queue(txa, port, queue);
-			if (unlikely(tqi == NULL || !tqi->added)) {
-				rte_pktmbuf_free(m);
-				continue;
-			}
+	return nb_tx;
+}
 
-			nb_tx += rte_eth_tx_buffer(port, queue, tqi->tx_buf, m);
-		} else {
-			nb_tx += txa_process_event_vector(txa, ev[i].vec);
-		}
+static void
+txa_service_tx(struct txa_service_data *txa, struct rte_event *ev,
+	uint32_t n)
+{
+	txa->stats.tx_packets += txa_events_tx(txa, ev, n, false);
+}
+
+uint16_t
+rte_event_eth_tx_adapter_direct_tx(uint8_t id, struct rte_event ev[],
+				   uint16_t nb_events)
+{
+	struct txa_service_data *txa;
+
+	if (!txa_valid_id(id) || txa_service_data_array == NULL) {
+		rte_errno = EINVAL;
+		return 0;
+	}
+
+	txa = txa_service_id_to_data(id);
+	if (txa == NULL || txa->nb_queues == 0) {
+		rte_errno = EINVAL;
+		return 0;
 	}
 
-	stats->tx_packets += nb_tx;
+	return txa_events_tx(txa, ev, nb_events, true);
 }
 
 static int32_t
@@ -642,8 +710,10 @@ txa_service_func(void *args)
 				if (unlikely(tqi == NULL || !tqi->added))
 					continue;
 
+				rte_spinlock_lock(&tqi->tx_lock);
 				nb_tx += rte_eth_tx_buffer_flush(i, q,
 							tqi->tx_buf);
+				rte_spinlock_unlock(&tqi->tx_lock);
 			}
 		}
 
@@ -832,6 +902,7 @@ txa_service_queue_add(uint8_t id,
 	rte_eth_tx_buffer_set_err_callback(tb,
 		txa_service_buffer_retry, txa_retry);
 
+	rte_spinlock_init(&tqi->tx_lock);
 	tqi->tx_buf = tb;
 	tqi->added = 1;
 	tdi->nb_queues++;
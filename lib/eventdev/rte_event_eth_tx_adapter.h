@@ -379,6 +379,41 @@ rte_event_eth_tx_adapter_enqueue(uint8_t dev_id,
 					nb_events);
 }
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Transmit the packets of a burst of events from a worker, instead of
+ * enqueuing them to an adapter using a service, which saves the hop through
+ * the event device and the service core. The mbufs, or the mbufs of the
+ * event vectors, going to the same Ethernet port and Tx queue one after the
+ * other are transmitted in a single burst, to the Tx queues added to the
+ * adapter. The queues must not be deleted meanwhile.
+ *
+ * This function is multi-thread safe, the transmits to a Tx queue are
+ * serialized with the ones of the adapter service. All the events are
+ * consumed: the packets which cannot be transmitted after some retries, or
+ * whose Tx queue was not added to the adapter, are freed. The packets are not
+ * accounted in the adapter statistics.
+ *
+ * @param id
+ *  Adapter identifier.
+ * @param ev
+ *  Points to an array of *nb_events* events, of packets or of event vectors
+ *  of packets.
+ * @param nb_events
+ *  The number of events to transmit.
+ *
+ * @return
+ *   The number of packets transmitted. On error, 0 with rte_errno set:
+ *   - EINVAL   The adapter ID is invalid, or no Tx queue was added to the
+ *              adapter service.
+ */
+__rte_experimental
+uint16_t
+rte_event_eth_tx_adapter_direct_tx(uint8_t id, struct rte_event ev[],
+				   uint16_t nb_events);
+
 /**
  * Retrieve statistics for an adapter
  *
@@ -211,8 +211,10 @@ rte_event_timer_adapter_create_ext(
 	/* If eventdev PMD did not provide ops, use default software
 	 * implementation.
 	 */
-	if (adapter->ops == NULL)
+	if (adapter->ops == NULL) {
 		adapter->ops = &swtim_ops;
+		adapter->data->caps |= RTE_EVENT_TIMER_ADAPTER_CAP_EVENT_VECTOR;
+	}
 
 	/* Allow driver to do some setup */
 	FUNC_PTR_OR_NULL_RET_WITH_ERRNO(adapter->ops->init, ENOTSUP);
@@ -342,8 +344,10 @@ rte_event_timer_adapter_lookup(uint16_t adapter_id)
 	/* If eventdev PMD did not provide ops, use default software
 	 * implementation.
 	 */
-	if (adapter->ops == NULL)
+	if (adapter->ops == NULL) {
 		adapter->ops = &swtim_ops;
+		adapter->data->caps |= RTE_EVENT_TIMER_ADAPTER_CAP_EVENT_VECTOR;
+	}
 
 	/* Set fast-path function pointers */
 	adapter->arm_burst = adapter->ops->arm_burst;
@@ -418,6 +422,44 @@ rte_event_timer_adapter_stats_reset(struct rte_event_timer_adapter *adapter)
 	return adapter->ops->stats_reset(adapter);
 }
 
+int
+rte_event_timer_adapter_vector_limits_get(
+		const struct rte_event_timer_adapter *adapter,
+		struct rte_event_timer_adapter_vector_limits *limits)
+{
+	ADAPTER_VALID_OR_ERR_RET(adapter, -EINVAL);
+	if (limits == NULL)
+		return -EINVAL;
+
+	if (!(adapter->data->caps & RTE_EVENT_TIMER_ADAPTER_CAP_EVENT_VECTOR))
+		return -ENOTSUP;
+	FUNC_PTR_OR_ERR_RET(adapter->ops->vector_limits_get, -ENOTSUP);
+
+	return adapter->ops->vector_limits_get(adapter, limits);
+}
+
+int
+rte_event_timer_adapter_event_vector_config(
+		struct rte_event_timer_adapter *adapter,
+		const struct rte_event_timer_adapter_event_vector_config *config)
+{
+	ADAPTER_VALID_OR_ERR_RET(adapter, -EINVAL);
+	if (config == NULL)
+		return -EINVAL;
+
+	if (!(adapter->data->caps & RTE_EVENT_TIMER_ADAPTER_CAP_EVENT_VECTOR))
+		return -ENOTSUP;
+	FUNC_PTR_OR_ERR_RET(adapter->ops->event_vector_config, -ENOTSUP);
+
+	if (adapter->data->started) {
+		EVTIM_LOG_ERR("event timer adapter %"PRIu8" is started",
+			      adapter->data->id);
+		return -EBUSY;
+	}
+
+	return adapter->ops->event_vector_config(adapter, config);
+}
+
 /*
  * Software event timer adapter buffer helper functions
  */
@@ -433,6 +475,11 @@ rte_event_timer_adapter_stats_reset(struct rte_event_timer_adapter *adapter)
 
 #define EXP_TIM_BUF_SZ 128
 
+#define MIN_VECTOR_SIZE 4
+#define MAX_VECTOR_SIZE 1024
+#define MIN_VECTOR_NS 1E5
+#define MAX_VECTOR_NS 1E9
+
 struct event_buffer {
 	size_t head;
 	size_t tail;
@@ -564,6 +611,25 @@ struct swtim {
 	struct rte_timer *expired_timers[EXP_TIM_BUF_SZ];
 	/* The number of timers that can be returned to a mempool */
 	size_t n_expired_timers;
+	/* Set when the expiry events are aggregated into vectors */
+	bool ena_vector;
+	/* Maximum number of expiry events per vector */
+	uint16_t vector_sz;
+	/* Cycles after which a partially filled vector is enqueued */
+	uint64_t vector_timeout_cycles;
+	/* Mempool of event vectors */
+	struct rte_mempool *vector_pool;
+	/* Vector being filled, and the attributes of its expiry events */
+	struct rte_event_vector *vector;
+	uint64_t vector_event;
+	/* The cycle count at which the first event was added to the vector */
+	uint64_t vector_ts;
+	/* Set when the timers are tracked by a timer wheel */
+	bool use_wheel;
+	/* Lcore running the service, whose timer wheel holds all the timers */
+	unsigned int service_lcore;
+	/* Canceled timers which the timer wheel has not released yet */
+	struct rte_ring *canceled_tims;
 };
 
 static inline struct swtim *
@@ -572,6 +638,67 @@ swtim_pmd_priv(const struct rte_event_timer_adapter *adapter)
 	return adapter->data->adapter_priv;
 }
 
+/* Move the vector being filled to the event buffer */
+static int
+swtim_vector_flush(struct swtim *sw)
+{
+	struct rte_event ev;
+
+	if (sw->vector == NULL)
+		return 0;
+
+	ev.event = sw->vector_event;
+	ev.vec = sw->vector;
+	if (event_buffer_add(&sw->buffer, &ev) < 0)
+		return -1;
+
+	sw->vector = NULL;
+	return 0;
+}
+
+/* Add the expiry event of an event timer to the event buffer, aggregating it
+ * into a vector if vectorization is enabled.
+ */
+static int
+swtim_event_add(struct swtim *sw, struct rte_event_timer *evtim)
+{
+	struct rte_event_vector *vec;
+	struct rte_event ev;
+
+	if (!sw->ena_vector)
+		return event_buffer_add(&sw->buffer, &evtim->ev);
+
+	ev.event = evtim->ev.event;
+	ev.event_type = RTE_EVENT_TYPE_TIMER_VECTOR;
+
+	vec = sw->vector;
+	if (vec != NULL && (vec->nb_elem == sw->vector_sz ||
+			    sw->vector_event != ev.event)) {
+		if (swtim_vector_flush(sw) < 0)
+			return -1;
+		vec = NULL;
+	}
+
+	if (vec == NULL) {
+		/* fall back to a single event when out of vectors */
+		if (rte_mempool_get(sw->vector_pool, (void **)&vec) < 0)
+			return event_buffer_add(&sw->buffer, &evtim->ev);
+
+		vec->nb_elem = 0;
+		vec->attr_valid = 0;
+		sw->vector = vec;
+		sw->vector_event = ev.event;
+		sw->vector_ts = rte_get_timer_cycles();
+	}
+
+	vec->ptrs[vec->nb_elem++] = evtim->ev.event_ptr;
+	/* a full vector left behind by a full buffer is flushed on next add */
+	if (vec->nb_elem == sw->vector_sz)
+		swtim_vector_flush(sw);
+
+	return 0;
+}
+
 static void
 swtim_callback(struct rte_timer *tim)
 {
@@ -589,7 +716,7 @@ swtim_callback(struct rte_timer *tim)
 	adapter = (struct rte_event_timer_adapter *)(uintptr_t)opaque;
 	sw = swtim_pmd_priv(adapter);
 
-	ret = event_buffer_add(&sw->buffer, &evtim->ev);
+	ret = swtim_event_add(sw, evtim);
 	if (ret < 0) {
 		/* If event buffer is full, put timer back in list with
 		 * immediate expiry value, so that we process it again on the
@@ -724,6 +851,44 @@ check_destination_event_queue(struct rte_event_timer *evtim,
 	return -1;
 }
 
+/* Return the canceled timers released by the timer wheel to the mempool.
+ * The wheel is drained by the service lcore itself, so most of them are
+ * released by the time this runs, the others are kept for the next tick.
+ */
+static void
+swtim_canceled_free(struct swtim *sw)
+{
+	struct rte_timer *tims[EXP_TIM_BUF_SZ];
+	union rte_timer_status status;
+	unsigned int count, i, n, nb_held;
+
+	count = rte_ring_count(sw->canceled_tims);
+	while (count > 0) {
+		n = rte_ring_sc_dequeue_burst(sw->canceled_tims, (void **)tims,
+					      RTE_MIN(count,
+						(unsigned int)EXP_TIM_BUF_SZ),
+					      NULL);
+		if (n == 0)
+			break;
+		count -= n;
+
+		nb_held = 0;
+		for (i = 0; i < n; i++) {
+			status.u32 = __atomic_load_n(&tims[i]->status.u32,
+						     __ATOMIC_ACQUIRE);
+			if (status.owner == RTE_TIMER_NO_OWNER)
+				rte_mempool_put(sw->tim_pool, tims[i]);
+			else
+				tims[nb_held++] = tims[i];
+		}
+
+		/* the ring can hold all the timers of the mempool */
+		if (nb_held > 0)
+			rte_ring_enqueue_bulk(sw->canceled_tims, (void **)tims,
+					      nb_held, NULL);
+	}
+}
+
 static int
 swtim_service_func(void *arg)
 {
@@ -731,18 +896,31 @@ swtim_service_func(void *arg)
 	struct swtim *sw = swtim_pmd_priv(adapter);
 	uint16_t nb_evs_flushed = 0;
 	uint16_t nb_evs_invalid = 0;
+	bool flush = false;
+
+	if (sw->vector != NULL && rte_get_timer_cycles() - sw->vector_ts >=
+				  sw->vector_timeout_cycles)
+		flush = swtim_vector_flush(sw) == 0;
 
 	if (swtim_did_tick(sw)) {
-		rte_timer_alt_manage(sw->timer_data_id,
-				     sw->poll_lcores,
-				     sw->n_poll_lcores,
-				     swtim_callback);
+		/* The timer wheel of this lcore holds all the timers */
+		if (sw->use_wheel)
+			rte_timer_alt_manage(sw->timer_data_id, NULL, 0,
+					     swtim_callback);
+		else
+			rte_timer_alt_manage(sw->timer_data_id,
+					     sw->poll_lcores,
+					     sw->n_poll_lcores,
+					     swtim_callback);
 
 		/* Return expired timer objects back to mempool */
 		rte_mempool_put_bulk(sw->tim_pool, (void **)sw->expired_timers,
 				     sw->n_expired_timers);
 		sw->n_expired_timers = 0;
 
+		if (sw->use_wheel)
+			swtim_canceled_free(sw);
+
 		event_buffer_flush(&sw->buffer,
 				   adapter->data->event_dev_id,
 				   adapter->data->event_port_id,
@@ -752,6 +930,15 @@ swtim_service_func(void *arg)
 		sw->stats.ev_enq_count += nb_evs_flushed;
 		sw->stats.ev_inv_count += nb_evs_invalid;
 		sw->stats.adapter_tick_count++;
+	} else if (flush) {
+		event_buffer_flush(&sw->buffer,
+				   adapter->data->event_dev_id,
+				   adapter->data->event_port_id,
+				   &nb_evs_flushed,
+				   &nb_evs_invalid);
+
+		sw->stats.ev_enq_count += nb_evs_flushed;
+		sw->stats.ev_inv_count += nb_evs_invalid;
 	}
 
 	return 0;
@@ -787,6 +974,18 @@ compute_msg_mempool_cache_size(uint64_t nb_requested, uint64_t nb_actual)
 	return cache_size;
 }
 
+/* The timer wheel expects a timer which no lcore holds */
+static void
+swtim_tim_init(struct rte_mempool *mp, void *opaque, void *obj,
+	       unsigned int obj_idx)
+{
+	RTE_SET_USED(mp);
+	RTE_SET_USED(opaque);
+	RTE_SET_USED(obj_idx);
+
+	memset(obj, 0, sizeof(struct rte_timer));
+}
+
 static int
 swtim_init(struct rte_event_timer_adapter *adapter)
 {
@@ -794,6 +993,7 @@ swtim_init(struct rte_event_timer_adapter *adapter)
 	struct swtim *sw;
 	unsigned int flags;
 	struct rte_service_spec service;
+	struct rte_timer_data_conf tim_conf;
 
 	/* Allocate storage for private data area */
 #define SWTIM_NAMESIZE 32
@@ -814,6 +1014,9 @@ swtim_init(struct rte_event_timer_adapter *adapter)
 
 	sw->timer_tick_ns = adapter->data->conf.timer_tick_ns;
 	sw->max_tmo_ns = adapter->data->conf.max_tmo_ns;
+	sw->use_wheel = !!(adapter->data->conf.flags &
+			   RTE_EVENT_TIMER_ADAPTER_F_TIMER_WHEEL);
+	sw->service_lcore = RTE_MAX_LCORE;
 
 	/* Create a timer pool */
 	char pool_name[SWTIM_NAMESIZE];
@@ -827,13 +1030,28 @@ swtim_init(struct rte_event_timer_adapter *adapter)
 	flags = 0; /* pool is multi-producer, multi-consumer */
 	sw->tim_pool = rte_mempool_create(pool_name, pool_size,
 			sizeof(struct rte_timer), cache_size, 0, NULL, NULL,
-			NULL, NULL, adapter->data->socket_id, flags);
+			swtim_tim_init, NULL, adapter->data->socket_id, flags);
 	if (sw->tim_pool == NULL) {
 		EVTIM_LOG_ERR("failed to create timer object mempool");
 		rte_errno = ENOMEM;
 		goto free_alloc;
 	}
 
+	if (sw->use_wheel) {
+		char ring_name[SWTIM_NAMESIZE];
+
+		/* Large enough for all the timers of the mempool */
+		snprintf(ring_name, SWTIM_NAMESIZE, "swtim_cancel_%"PRIu8,
+			 adapter->data->id);
+		sw->canceled_tims = rte_ring_create(ring_name, nb_timers,
+				adapter->data->socket_id, RING_F_SC_DEQ);
+		if (sw->canceled_tims == NULL) {
+			EVTIM_LOG_ERR("failed to create canceled timer ring");
+			rte_errno = ENOMEM;
+			goto free_mempool;
+		}
+	}
+
 	/* Initialize the variables that track in-use timer lists */
 	for (i = 0; i < RTE_MAX_LCORE; i++)
 		sw->in_use[i].v = 0;
@@ -848,7 +1066,15 @@ swtim_init(struct rte_event_timer_adapter *adapter)
 		}
 	}
 
-	ret = rte_timer_data_alloc(&sw->timer_data_id);
+	memset(&tim_conf, 0, sizeof(tim_conf));
+	if (sw->use_wheel) {
+		/* A coarser wheel than the adapter ticks delays expiries */
+		tim_conf.backend = RTE_TIMER_BACKEND_WHEEL;
+		tim_conf.wheel_tick_ns = RTE_MIN(sw->timer_tick_ns,
+						 (uint64_t)NSECPERSEC);
+	}
+
+	ret = rte_timer_data_alloc_conf(&sw->timer_data_id, &tim_conf);
 	if (ret < 0) {
 		EVTIM_LOG_ERR("failed to allocate timer data instance");
 		rte_errno = -ret;
@@ -875,7 +1101,7 @@ swtim_init(struct rte_event_timer_adapter *adapter)
 			      ret);
 
 		rte_errno = ENOSPC;
-		goto free_mempool;
+		goto free_timer_data;
 	}
 
 	EVTIM_LOG_DBG("registered service %s with id %"PRIu32, service.name,
@@ -885,7 +1111,10 @@ swtim_init(struct rte_event_timer_adapter *adapter)
 	adapter->data->service_inited = 1;
 
 	return 0;
+free_timer_data:
+	rte_timer_data_dealloc(sw->timer_data_id);
 free_mempool:
+	rte_ring_free(sw->canceled_tims);
 	rte_mempool_free(sw->tim_pool);
 free_alloc:
 	rte_free(sw);
@@ -922,6 +1151,10 @@ swtim_uninit(struct rte_event_timer_adapter *adapter)
 		return ret;
 	}
 
+	if (sw->vector != NULL)
+		rte_mempool_put(sw->vector_pool, sw->vector);
+	rte_timer_data_dealloc(sw->timer_data_id);
+	rte_ring_free(sw->canceled_tims);
 	rte_mempool_free(sw->tim_pool);
 	rte_free(sw);
 	adapter->data->adapter_priv = NULL;
@@ -930,7 +1163,7 @@ swtim_uninit(struct rte_event_timer_adapter *adapter)
 }
 
 static inline int32_t
-get_mapped_count_for_service(uint32_t service_id)
+get_mapped_count_for_service(uint32_t service_id, unsigned int *lcore)
 {
 	int32_t core_count, i, mapped_count = 0;
 	uint32_t lcore_arr[RTE_MAX_LCORE];
@@ -938,8 +1171,10 @@ get_mapped_count_for_service(uint32_t service_id)
 	core_count = rte_service_lcore_list(lcore_arr, RTE_MAX_LCORE);
 
 	for (i = 0; i < core_count; i++)
-		if (rte_service_map_lcore_get(service_id, lcore_arr[i]) == 1)
+		if (rte_service_map_lcore_get(service_id, lcore_arr[i]) == 1) {
+			*lcore = lcore_arr[i];
 			mapped_count++;
+		}
 
 	return mapped_count;
 }
@@ -948,6 +1183,7 @@ static int
 swtim_start(const struct rte_event_timer_adapter *adapter)
 {
 	int mapped_count;
+	unsigned int lcore = RTE_MAX_LCORE;
 	struct swtim *sw = swtim_pmd_priv(adapter);
 
 	/* Mapping the service to more than one service core can introduce
@@ -957,11 +1193,23 @@ swtim_start(const struct rte_event_timer_adapter *adapter)
 	 * Note: the service could be modified such that it spreads cores to
 	 * poll over multiple service instances.
 	 */
-	mapped_count = get_mapped_count_for_service(sw->service_id);
+	mapped_count = get_mapped_count_for_service(sw->service_id, &lcore);
 
 	if (mapped_count != 1)
 		return mapped_count < 1 ? -ENOENT : -ENOTSUP;
 
+	/* The timers armed so far are in the timer wheel of this lcore */
+	if (sw->use_wheel) {
+		if (sw->service_lcore != RTE_MAX_LCORE &&
+		    sw->service_lcore != lcore) {
+			EVTIM_LOG_ERR("timer wheel service can't move from "
+				      "lcore %u to %u", sw->service_lcore,
+				      lcore);
+			return -ENOTSUP;
+		}
+		__atomic_store_n(&sw->service_lcore, lcore, __ATOMIC_RELEASE);
+	}
+
 	return rte_service_component_runstate_set(sw->service_id, 1);
 }
 
@@ -1008,6 +1256,57 @@ swtim_stats_reset(const struct rte_event_timer_adapter *adapter)
 	return 0;
 }
 
+static int
+swtim_vector_limits_get(const struct rte_event_timer_adapter *adapter,
+			struct rte_event_timer_adapter_vector_limits *limits)
+{
+	RTE_SET_USED(adapter);
+
+	limits->log2_sz = false;
+	limits->min_sz = MIN_VECTOR_SIZE;
+	limits->max_sz = MAX_VECTOR_SIZE;
+	limits->min_timeout_ns = MIN_VECTOR_NS;
+	limits->max_timeout_ns = MAX_VECTOR_NS;
+
+	return 0;
+}
+
+static int
+swtim_event_vector_config(const struct rte_event_timer_adapter *adapter,
+	const struct rte_event_timer_adapter_event_vector_config *config)
+{
+	struct swtim *sw = swtim_pmd_priv(adapter);
+
+	if (config->vector_sz < MIN_VECTOR_SIZE ||
+	    config->vector_sz > MAX_VECTOR_SIZE ||
+	    config->vector_timeout_ns < MIN_VECTOR_NS ||
+	    config->vector_timeout_ns > MAX_VECTOR_NS ||
+	    config->vector_mp == NULL) {
+		EVTIM_LOG_ERR("invalid event vector configuration");
+		return -EINVAL;
+	}
+
+	if (config->vector_mp->elt_size < sizeof(struct rte_event_vector) +
+	    sizeof(uintptr_t) * config->vector_sz) {
+		EVTIM_LOG_ERR("event vector mempool element size too small");
+		return -EINVAL;
+	}
+
+	/* Vectors filled with the previous settings go out as they are */
+	if (swtim_vector_flush(sw) < 0) {
+		rte_mempool_put(sw->vector_pool, sw->vector);
+		sw->vector = NULL;
+	}
+
+	sw->vector_sz = config->vector_sz;
+	sw->vector_timeout_cycles = config->vector_timeout_ns *
+				    rte_get_timer_hz() / NSECPERSEC;
+	sw->vector_pool = config->vector_mp;
+	sw->ena_vector = true;
+
+	return 0;
+}
+
 static uint16_t
 __swtim_arm_burst(const struct rte_event_timer_adapter *adapter,
 		struct rte_event_timer **evtims,
@@ -1031,10 +1330,19 @@ __swtim_arm_burst(const struct rte_event_timer_adapter *adapter,
 	}
 #endif
 
-	/* Adjust lcore_id if non-EAL thread. Arbitrarily pick the timer list of
-	 * the highest lcore to insert such timers into
+	/* With a timer wheel, all the timers are handed over to the service
+	 * lcore. Otherwise, adjust lcore_id if non-EAL thread. Arbitrarily pick
+	 * the timer list of the highest lcore to insert such timers into
 	 */
-	if (lcore_id == LCORE_ID_ANY)
+	if (sw->use_wheel) {
+		lcore_id = __atomic_load_n(&sw->service_lcore,
+					   __ATOMIC_ACQUIRE);
+		if (unlikely(lcore_id == RTE_MAX_LCORE)) {
+			/* the adapter was never started */
+			rte_errno = EINVAL;
+			return 0;
+		}
+	} else if (lcore_id == LCORE_ID_ANY)
 		lcore_id = RTE_MAX_LCORE - 1;
 
 	/* If this is the first time we're arming an event timer on this lcore,
@@ -1146,6 +1454,7 @@ swtim_cancel_burst(const struct rte_event_timer_adapter *adapter,
 	uint64_t opaque;
 	struct swtim *sw = swtim_pmd_priv(adapter);
 	enum rte_event_timer_state n_state;
+	union rte_timer_status status;
 
 #ifdef RTE_LIBRTE_EVENTDEV_DEBUG
 	/* Check that the service is running. */
@@ -1180,7 +1489,15 @@ swtim_cancel_burst(const struct rte_event_timer_adapter *adapter,
 			break;
 		}
 
-		rte_mempool_put(sw->tim_pool, (void **)timp);
+		/* A timer stopped from another lcore than the one holding it
+		 * in its timer wheel is only released by that lcore.
+		 */
+		status.u32 = __atomic_load_n(&timp->status.u32,
+					     __ATOMIC_ACQUIRE);
+		if (sw->use_wheel && status.owner != RTE_TIMER_NO_OWNER)
+			rte_ring_enqueue(sw->canceled_tims, timp);
+		else
+			rte_mempool_put(sw->tim_pool, (void **)timp);
 
 		/* The RELEASE ordering here pairs with atomic ordering
 		 * to make sure the state update data observed between
@@ -1218,4 +1535,6 @@ static const struct rte_event_timer_adapter_ops swtim_ops = {
 	.arm_burst		= swtim_arm_burst,
 	.arm_tmo_tick_burst	= swtim_arm_tmo_tick_burst,
 	.cancel_burst		= swtim_cancel_burst,
+	.vector_limits_get	= swtim_vector_limits_get,
+	.event_vector_config	= swtim_event_vector_config,
 };
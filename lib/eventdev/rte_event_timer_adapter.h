@@ -105,6 +105,13 @@
  * Generic SW Timeout, Wireless MAC Scheduling, 3G Frame Protocols,
  * Packet Scheduling, Protocol Retransmission Timers, Supervision Timers.
  * All these use cases require high resolution and low time drift.
+ *
+ * If the adapter has the RTE_EVENT_TIMER_ADAPTER_CAP_EVENT_VECTOR capability,
+ * the expiry events can be aggregated into event vectors, configured with
+ * ``rte_event_timer_adapter_event_vector_config()`` before the adapter is
+ * started. A vector of type RTE_EVENT_TYPE_TIMER_VECTOR then holds the
+ * *rte_event::event_ptr* of up to *vector_sz* expired event timers that share
+ * the same expiry event attributes.
  */
 
 #ifdef __cplusplus
@@ -159,6 +166,17 @@ enum rte_event_timer_adapter_clk_src {
  * @see struct rte_event_timer_adapter_conf::flags
  */
 
+#define RTE_EVENT_TIMER_ADAPTER_F_TIMER_WHEEL	(1ULL << 3)
+/**< Track the event timers of a software adapter with a hierarchical timer
+ * wheel instead of ordered lists: arming and canceling an event timer is
+ * O(1) and lock-free, and the expired event timers are collected a whole
+ * wheel slot at a time. All the event timers are held by the lcore running
+ * the adapter service, which must not change once the adapter was started.
+ * Ignored by adapters which do not use a service.
+ *
+ * @see struct rte_event_timer_adapter_conf::flags
+ */
+
 /**
  * Timer adapter configuration structure
  */
@@ -197,6 +215,43 @@ struct rte_event_timer_adapter_stats {
 	/**< Tick count for the adapter, at its resolution */
 };
 
+/**
+ * Event timer adapter event vector configuration structure.
+ */
+struct rte_event_timer_adapter_event_vector_config {
+	uint16_t vector_sz;
+	/**< Maximum number of expired event timers to combine in a vector.
+	 * Should be within the vectorization limits of the adapter.
+	 * @see rte_event_timer_adapter_vector_limits
+	 */
+	uint64_t vector_timeout_ns;
+	/**< Maximum number of nanoseconds to wait for aggregating expired
+	 * event timers, counted from the first one added to the vector.
+	 * Should be within the vectorization limits of the adapter.
+	 * @see rte_event_timer_adapter_vector_limits
+	 */
+	struct rte_mempool *vector_mp;
+	/**< Mempool used to allocate the rte_event_vector containers.
+	 * Should be created by using ``rte_event_vector_pool_create()``.
+	 */
+};
+
+/**
+ * Event timer adapter event vector limits structure.
+ */
+struct rte_event_timer_adapter_vector_limits {
+	uint16_t min_sz;
+	/**< Minimum vector size configurable. */
+	uint16_t max_sz;
+	/**< Maximum vector size configurable. */
+	uint8_t log2_sz;
+	/**< True if the vector size configured should be a power of 2. */
+	uint64_t min_timeout_ns;
+	/**< Minimum vector timeout configurable. */
+	uint64_t max_timeout_ns;
+	/**< Maximum vector timeout configurable. */
+};
+
 struct rte_event_timer_adapter;
 
 /**
@@ -436,6 +491,63 @@ rte_event_timer_adapter_stats_get(struct rte_event_timer_adapter *adapter,
 int
 rte_event_timer_adapter_stats_reset(struct rte_event_timer_adapter *adapter);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Retrieve the event vectorization limits of an event timer adapter
+ * instance.
+ *
+ * @param adapter
+ *   A pointer to an event timer adapter structure.
+ * @param[out] limits
+ *   A pointer to a structure to fill with the vector limits.
+ *
+ * @return
+ *   - 0: Success.
+ *   - -ENOTSUP: the adapter does not support event vectorization.
+ *   - <0: Error code on failure.
+ */
+__rte_experimental
+int
+rte_event_timer_adapter_vector_limits_get(
+		const struct rte_event_timer_adapter *adapter,
+		struct rte_event_timer_adapter_vector_limits *limits);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Enable the aggregation of expiry events into event vectors.
+ *
+ * Expired event timers are added to a vector while their expiry events have
+ * the same attributes (queue, scheduling type, priority, flow, sub event
+ * type). The vector is enqueued as an event of type
+ * RTE_EVENT_TYPE_TIMER_VECTOR, carrying those attributes, once it is full,
+ * once an event timer with other attributes expires or when
+ * *vector_timeout_ns* have elapsed since its first event timer was added.
+ * The elements of the vector are the *rte_event::event_ptr* of the event
+ * timers.
+ *
+ * This function must be called before the adapter is started.
+ *
+ * @param adapter
+ *   A pointer to an event timer adapter structure.
+ * @param config
+ *   A pointer to the event vector configuration.
+ *
+ * @return
+ *   - 0: Success.
+ *   - -ENOTSUP: the adapter does not support event vectorization.
+ *   - -EBUSY: the adapter is started.
+ *   - -EINVAL: invalid configuration.
+ */
+__rte_experimental
+int
+rte_event_timer_adapter_event_vector_config(
+		struct rte_event_timer_adapter *adapter,
+		const struct rte_event_timer_adapter_event_vector_config *config);
+
 /**
  * Event timer state.
  */
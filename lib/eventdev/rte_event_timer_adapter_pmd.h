@@ -52,6 +52,14 @@ typedef int (*rte_event_timer_adapter_stats_get_t)(
 typedef int (*rte_event_timer_adapter_stats_reset_t)(
 		const struct rte_event_timer_adapter *adapter);
 /**< @internal Reset statistics for event timer adapter */
+typedef int (*rte_event_timer_adapter_vector_limits_get_t)(
+		const struct rte_event_timer_adapter *adapter,
+		struct rte_event_timer_adapter_vector_limits *limits);
+/**< @internal Get event vector limits for event timer adapter */
+typedef int (*rte_event_timer_adapter_event_vector_config_t)(
+		const struct rte_event_timer_adapter *adapter,
+		const struct rte_event_timer_adapter_event_vector_config *config);
+/**< @internal Configure event vectorization for event timer adapter */
 
 /**
  * @internal Structure containing the functions exported by an event timer
@@ -74,6 +82,10 @@ struct rte_event_timer_adapter_ops {
 	/**< Arm event timers with same expiration time */
 	rte_event_timer_cancel_burst_t		cancel_burst;
 	/**< Cancel one or more event timers */
+	rte_event_timer_adapter_vector_limits_get_t vector_limits_get;
+	/**< Get event vector limits */
+	rte_event_timer_adapter_event_vector_config_t event_vector_config;
+	/**< Configure event vectorization */
 };
 
 /**
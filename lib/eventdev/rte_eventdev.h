@@ -1053,6 +1053,12 @@ struct rte_event_vector {
 #define RTE_EVENT_TYPE_ETH_RX_ADAPTER_VECTOR                                   \
 	(RTE_EVENT_TYPE_VECTOR | RTE_EVENT_TYPE_ETH_RX_ADAPTER)
 /**< The event vector generated from eth Rx adapter. */
+#define RTE_EVENT_TYPE_CRYPTODEV_VECTOR                                        \
+	(RTE_EVENT_TYPE_VECTOR | RTE_EVENT_TYPE_CRYPTODEV)
+/**< The event vector generated from cryptodev adapter. */
+#define RTE_EVENT_TYPE_TIMER_VECTOR                                            \
+	(RTE_EVENT_TYPE_VECTOR | RTE_EVENT_TYPE_TIMER)
+/**< The event vector generated from event timer adapter. */
 
 #define RTE_EVENT_TYPE_MAX              0x10
 /**< Maximum number of event types */
@@ -1229,6 +1235,11 @@ rte_event_eth_rx_adapter_caps_get(uint8_t dev_id, uint16_t eth_port_id,
 #define RTE_EVENT_TIMER_ADAPTER_CAP_PERIODIC      (1ULL << 1)
 /**< This flag is set if periodic mode is supported. */
 
+#define RTE_EVENT_TIMER_ADAPTER_CAP_EVENT_VECTOR  (1ULL << 2)
+/**< This flag is set if timer expiry events can be vectorized.
+ * @see rte_event_timer_adapter_event_vector_config()
+ */
+
 /**
  * Retrieve the event device's timer adapter capabilities.
  *
@@ -1270,6 +1281,12 @@ rte_event_timer_adapter_caps_get(uint8_t dev_id, uint32_t *caps);
  * the private data information along with the crypto session.
  */
 
+#define RTE_EVENT_CRYPTO_ADAPTER_CAP_EVENT_VECTOR   0x10
+/**< Flag indicates HW/SW supports vectorization of the crypto completion
+ * events.
+ * @see rte_event_crypto_adapter_queue_pair_event_vector_config()
+ */
+
 /**
  * Retrieve the event device's crypto adapter capabilities for the
  * specified cryptodev device
@@ -0,0 +1,326 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/queue.h>
+
+#include <rte_common.h>
+#include <rte_dev.h>
+#include <rte_errno.h>
+#include <rte_ethdev.h>
+#include <rte_log.h>
+#include <rte_malloc.h>
+#include <rte_mbuf.h>
+#include <rte_spinlock.h>
+#include <rte_string_fns.h>
+
+#include "rte_expath.h"
+
+RTE_LOG_REGISTER_DEFAULT(expath_logtype, INFO);
+
+#define EXPATH_LOG(level, fmt, args...) \
+	rte_log(RTE_LOG_ ## level, expath_logtype, \
+		"%s(): " fmt "\n", __func__, ## args)
+
+#define EXPATH_VHOST_NET "/dev/vhost-net"
+#define EXPATH_DEFAULT_QUEUE_SIZE 256
+
+struct expath_txq {
+	uint16_t len;
+	uint64_t dropped;
+	struct rte_mbuf *pkts[RTE_EXPATH_TX_BATCH_MAX];
+} __rte_cache_aligned;
+
+struct rte_expath {
+	TAILQ_ENTRY(rte_expath) next;
+	char name[RTE_EXPATH_NAMESIZE];
+	char dev_name[RTE_DEV_NAME_MAX_LEN];
+	uint16_t port_id;
+	uint16_t nb_queues;
+	uint16_t tx_batch;
+	struct expath_txq txq[];
+};
+
+TAILQ_HEAD(expath_list, rte_expath);
+
+/* Exception paths are process local, as their ports. */
+static struct expath_list expath_list = TAILQ_HEAD_INITIALIZER(expath_list);
+static rte_spinlock_t expath_lock = RTE_SPINLOCK_INITIALIZER;
+
+static struct rte_expath *
+expath_lookup(const char *name)
+{
+	struct rte_expath *ep;
+
+	TAILQ_FOREACH(ep, &expath_list, next)
+		if (strncmp(ep->name, name, RTE_EXPATH_NAMESIZE) == 0)
+			return ep;
+	return NULL;
+}
+
+/* Configure and start the port with the requested offloads. */
+static int
+expath_port_start(uint16_t port_id, const struct rte_expath_conf *conf,
+		uint16_t nb_queues, uint16_t queue_size,
+		struct rte_mempool *mp)
+{
+	struct rte_eth_conf port_conf;
+	struct rte_eth_dev_info dev_info;
+	uint64_t rx_offloads = 0;
+	uint64_t tx_offloads = 0;
+	uint16_t q;
+	int ret;
+
+	ret = rte_eth_dev_info_get(port_id, &dev_info);
+	if (ret != 0)
+		return ret;
+
+	if (conf->offloads & RTE_EXPATH_OFFLOAD_CKSUM) {
+		rx_offloads |= DEV_RX_OFFLOAD_TCP_CKSUM |
+			DEV_RX_OFFLOAD_UDP_CKSUM;
+		tx_offloads |= DEV_TX_OFFLOAD_TCP_CKSUM |
+			DEV_TX_OFFLOAD_UDP_CKSUM;
+	}
+	if (conf->offloads & RTE_EXPATH_OFFLOAD_TSO) {
+		rx_offloads |= DEV_RX_OFFLOAD_TCP_LRO;
+		tx_offloads |= DEV_TX_OFFLOAD_TCP_TSO;
+	}
+	if ((rx_offloads & ~dev_info.rx_offload_capa) != 0 ||
+	    (tx_offloads & ~dev_info.tx_offload_capa) != 0) {
+		EXPATH_LOG(ERR, "offloads 0x%" PRIx64 " not supported",
+			conf->offloads);
+		return -ENOTSUP;
+	}
+
+	memset(&port_conf, 0, sizeof(port_conf));
+	port_conf.rxmode.offloads = rx_offloads;
+	port_conf.txmode.offloads = tx_offloads;
+	ret = rte_eth_dev_configure(port_id, nb_queues, nb_queues, &port_conf);
+	if (ret != 0)
+		return ret;
+
+	for (q = 0; q < nb_queues; q++) {
+		ret = rte_eth_rx_queue_setup(port_id, q, queue_size,
+				conf->socket_id, NULL, mp);
+		if (ret != 0)
+			return ret;
+		ret = rte_eth_tx_queue_setup(port_id, q, queue_size,
+				conf->socket_id, NULL);
+		if (ret != 0)
+			return ret;
+	}
+
+	return rte_eth_dev_start(port_id);
+}
+
+struct rte_expath *
+rte_expath_create(const struct rte_expath_conf *conf,
+		struct rte_mempool *mp)
+{
+	char args[RTE_DEV_NAME_MAX_LEN + 128];
+	char dev_name[RTE_DEV_NAME_MAX_LEN];
+	char mac[RTE_ETHER_ADDR_FMT_SIZE];
+	struct rte_expath *ep;
+	uint16_t nb_queues, queue_size;
+	uint16_t port_id;
+	int ret;
+
+	if (conf == NULL || mp == NULL || conf->name[0] == '\0' ||
+	    strnlen(conf->name, RTE_EXPATH_NAMESIZE) == RTE_EXPATH_NAMESIZE ||
+	    conf->tx_batch > RTE_EXPATH_TX_BATCH_MAX) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+	nb_queues = conf->nb_queues != 0 ? conf->nb_queues : 1;
+	queue_size = conf->queue_size != 0 ? conf->queue_size :
+		EXPATH_DEFAULT_QUEUE_SIZE;
+
+	rte_spinlock_lock(&expath_lock);
+	if (expath_lookup(conf->name) != NULL) {
+		rte_spinlock_unlock(&expath_lock);
+		rte_errno = EEXIST;
+		return NULL;
+	}
+
+	ep = rte_zmalloc_socket("expath", sizeof(*ep) +
+			nb_queues * sizeof(ep->txq[0]), RTE_CACHE_LINE_SIZE,
+			conf->socket_id);
+	if (ep == NULL) {
+		rte_spinlock_unlock(&expath_lock);
+		rte_errno = ENOMEM;
+		return NULL;
+	}
+
+	/* The virtio-user driver is matched on the device name prefix. */
+	snprintf(dev_name, sizeof(dev_name), "net_virtio_user_%s", conf->name);
+	ret = snprintf(args, sizeof(args),
+		"path=%s,iface=%s,queues=%u,queue_size=%u",
+		EXPATH_VHOST_NET, conf->name, nb_queues, queue_size);
+	if (!rte_is_zero_ether_addr(&conf->mac_addr)) {
+		rte_ether_format_addr(mac, sizeof(mac), &conf->mac_addr);
+		snprintf(args + ret, sizeof(args) - ret, ",mac=%s", mac);
+	}
+
+	ret = rte_eal_hotplug_add("vdev", dev_name, args);
+	if (ret != 0) {
+		EXPATH_LOG(ERR, "cannot create %s with %s: %d",
+			dev_name, args, ret);
+		goto free;
+	}
+	ret = rte_eth_dev_get_port_by_name(dev_name, &port_id);
+	if (ret != 0)
+		goto remove;
+
+	ret = expath_port_start(port_id, conf, nb_queues, queue_size, mp);
+	if (ret != 0) {
+		EXPATH_LOG(ERR, "cannot start port %u: %d", port_id, ret);
+		rte_eth_dev_close(port_id);
+		goto remove;
+	}
+
+	strlcpy(ep->name, conf->name, sizeof(ep->name));
+	strlcpy(ep->dev_name, dev_name, sizeof(ep->dev_name));
+	ep->port_id = port_id;
+	ep->nb_queues = nb_queues;
+	ep->tx_batch = RTE_MAX(conf->tx_batch, (uint16_t)1);
+	TAILQ_INSERT_TAIL(&expath_list, ep, next);
+	rte_spinlock_unlock(&expath_lock);
+
+	return ep;
+
+remove:
+	rte_eal_hotplug_remove("vdev", dev_name);
+free:
+	rte_spinlock_unlock(&expath_lock);
+	rte_free(ep);
+	rte_errno = -ret;
+	return NULL;
+}
+
+int
+rte_expath_free(struct rte_expath *ep)
+{
+	uint16_t q;
+	int ret;
+
+	if (ep == NULL)
+		return 0;
+
+	rte_spinlock_lock(&expath_lock);
+	TAILQ_REMOVE(&expath_list, ep, next);
+	rte_spinlock_unlock(&expath_lock);
+
+	for (q = 0; q < ep->nb_queues; q++)
+		rte_pktmbuf_free_bulk(ep->txq[q].pkts, ep->txq[q].len);
+
+	ret = rte_eth_dev_stop(ep->port_id);
+	if (ret != 0)
+		EXPATH_LOG(WARNING, "cannot stop port %u: %d",
+			ep->port_id, ret);
+	rte_eth_dev_close(ep->port_id);
+	ret = rte_eal_hotplug_remove("vdev", ep->dev_name);
+	rte_free(ep);
+
+	return ret;
+}
+
+struct rte_expath *
+rte_expath_get(const char *name)
+{
+	struct rte_expath *ep;
+
+	if (name == NULL)
+		return NULL;
+
+	rte_spinlock_lock(&expath_lock);
+	ep = expath_lookup(name);
+	rte_spinlock_unlock(&expath_lock);
+
+	return ep;
+}
+
+const char *
+rte_expath_get_name(const struct rte_expath *ep)
+{
+	return ep->name;
+}
+
+uint16_t
+rte_expath_port_id(const struct rte_expath *ep)
+{
+	return ep->port_id;
+}
+
+uint16_t
+rte_expath_rx_burst(struct rte_expath *ep, uint16_t queue_id,
+		struct rte_mbuf **pkts, uint16_t nb_pkts)
+{
+	return rte_eth_rx_burst(ep->port_id, queue_id, pkts, nb_pkts);
+}
+
+uint16_t
+rte_expath_tx_burst(struct rte_expath *ep, uint16_t queue_id,
+		struct rte_mbuf **pkts, uint16_t nb_pkts)
+{
+	return rte_eth_tx_burst(ep->port_id, queue_id, pkts, nb_pkts);
+}
+
+uint16_t
+rte_expath_tx_flush(struct rte_expath *ep, uint16_t queue_id)
+{
+	struct expath_txq *txq = &ep->txq[queue_id];
+	uint16_t sent;
+
+	if (txq->len == 0)
+		return 0;
+
+	sent = rte_eth_tx_burst(ep->port_id, queue_id, txq->pkts, txq->len);
+	if (unlikely(sent < txq->len)) {
+		rte_pktmbuf_free_bulk(&txq->pkts[sent], txq->len - sent);
+		txq->dropped += txq->len - sent;
+	}
+	txq->len = 0;
+
+	return sent;
+}
+
+uint16_t
+rte_expath_tx_buffer(struct rte_expath *ep, uint16_t queue_id,
+		struct rte_mbuf **pkts, uint16_t nb_pkts)
+{
+	struct expath_txq *txq = &ep->txq[queue_id];
+	uint16_t sent = 0;
+	uint16_t n;
+
+	while (nb_pkts != 0) {
+		n = RTE_MIN(nb_pkts, (uint16_t)(ep->tx_batch - txq->len));
+		memcpy(&txq->pkts[txq->len], pkts, n * sizeof(*pkts));
+		txq->len += n;
+		pkts += n;
+		nb_pkts -= n;
+		/* A single kick for the whole batch. */
+		if (txq->len == ep->tx_batch)
+			sent += rte_expath_tx_flush(ep, queue_id);
+	}
+
+	return sent;
+}
+
+int
+rte_expath_stats_get(const struct rte_expath *ep,
+		struct rte_expath_stats *stats)
+{
+	uint16_t q;
+
+	if (ep == NULL || stats == NULL)
+		return -EINVAL;
+
+	memset(stats, 0, sizeof(*stats));
+	for (q = 0; q < ep->nb_queues; q++)
+		stats->tx_dropped += ep->txq[q].dropped;
+
+	return 0;
+}
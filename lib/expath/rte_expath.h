@@ -0,0 +1,254 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#ifndef _RTE_EXPATH_H_
+#define _RTE_EXPATH_H_
+
+/**
+ * @file
+ * RTE Exception Path
+ *
+ * Exchange packets with the kernel network stack through a virtio-user
+ * port backed by vhost-net, as a replacement of KNI which needs no out of
+ * tree kernel module. Each exception path is a kernel TAP interface, whose
+ * packets are moved by the vhost-net kernel threads, one per queue pair.
+ *
+ * Compared to KNI, the interface can have several queues, the kernel can
+ * offload the checksums and TCP segmentation to the application, and the
+ * kernel notifications can be batched over several bursts.
+ *
+ * The API mirrors the KNI one. The port is a regular ethdev port, whose
+ * ID can be used for statistics or further configuration. The kernel
+ * interface is managed with the usual kernel tools: its link state and MTU
+ * are not reported to the application.
+ *
+ * The functions of an exception path queue are not thread safe, each queue
+ * must be used by a single thread.
+ *
+ * @warning
+ * @b EXPERIMENTAL:
+ * All functions in this file may be changed or removed without prior notice.
+ */
+
+#include <stdint.h>
+
+#include <rte_compat.h>
+#include <rte_ether.h>
+#include <rte_mbuf.h>
+#include <rte_mempool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Maximum size of an exception path name, as a kernel interface name. */
+#define RTE_EXPATH_NAMESIZE 16
+
+/** Maximum number of packets buffered per queue before a notification. */
+#define RTE_EXPATH_TX_BATCH_MAX 256
+
+/** Let the kernel offload the IPv4, TCP and UDP checksums. */
+#define RTE_EXPATH_OFFLOAD_CKSUM (1ULL << 0)
+/** Let the kernel offload the TCP segmentation. */
+#define RTE_EXPATH_OFFLOAD_TSO (1ULL << 1)
+
+struct rte_expath;
+
+/**
+ * Exception path configuration parameters.
+ */
+struct rte_expath_conf {
+	/** Kernel interface name. */
+	char name[RTE_EXPATH_NAMESIZE];
+	/** MAC address of the port, random if all zeros. */
+	struct rte_ether_addr mac_addr;
+	/** Number of Rx and Tx queue pairs, 1 if 0. */
+	uint16_t nb_queues;
+	/** Number of descriptors of each queue, 256 if 0. */
+	uint16_t queue_size;
+	/**
+	 * Number of packets buffered by rte_expath_tx_buffer() before
+	 * they are handed to the kernel with one notification, no more
+	 * than RTE_EXPATH_TX_BATCH_MAX. 0 or 1 disables the buffering.
+	 */
+	uint16_t tx_batch;
+	/** RTE_EXPATH_OFFLOAD_* flags. */
+	uint64_t offloads;
+	/** NUMA socket of the queues. */
+	int socket_id;
+};
+
+/**
+ * Exception path statistics.
+ */
+struct rte_expath_stats {
+	uint64_t tx_dropped; /**< Buffered packets the kernel did not take. */
+};
+
+/**
+ * Create an exception path and start its port.
+ *
+ * @param conf
+ *   Configuration parameters.
+ * @param mp
+ *   Mempool the received packets are allocated from.
+ * @return
+ *   The exception path, or NULL on error with rte_errno set:
+ *   - EINVAL: invalid parameters
+ *   - EEXIST: an exception path has the same name
+ *   - ENOTSUP: offloads not supported by the port
+ *   - ENOMEM: no memory
+ *   - other values: the port could not be created, for instance
+ *     because vhost-net is not available
+ */
+__rte_experimental
+struct rte_expath *
+rte_expath_create(const struct rte_expath_conf *conf,
+		struct rte_mempool *mp);
+
+/**
+ * Stop and remove an exception path. The buffered packets are dropped.
+ *
+ * @param ep
+ *   Exception path, may be NULL.
+ * @return
+ *   0 on success, a negative errno value otherwise.
+ */
+__rte_experimental
+int
+rte_expath_free(struct rte_expath *ep);
+
+/**
+ * Get an exception path by name.
+ *
+ * @param name
+ *   Name of the exception path.
+ * @return
+ *   The exception path, NULL if none has this name.
+ */
+__rte_experimental
+struct rte_expath *
+rte_expath_get(const char *name);
+
+/**
+ * Get the name of an exception path.
+ *
+ * @param ep
+ *   Exception path.
+ * @return
+ *   Kernel interface name.
+ */
+__rte_experimental
+const char *
+rte_expath_get_name(const struct rte_expath *ep);
+
+/**
+ * Get the ethdev port ID of an exception path.
+ *
+ * @param ep
+ *   Exception path.
+ * @return
+ *   Port ID.
+ */
+__rte_experimental
+uint16_t
+rte_expath_port_id(const struct rte_expath *ep);
+
+/**
+ * Receive the packets sent by the kernel on a queue.
+ *
+ * @param ep
+ *   Exception path.
+ * @param queue_id
+ *   Queue index.
+ * @param pkts
+ *   Array to store the received packets.
+ * @param nb_pkts
+ *   Size of the array.
+ * @return
+ *   Number of packets received.
+ */
+__rte_experimental
+uint16_t
+rte_expath_rx_burst(struct rte_expath *ep, uint16_t queue_id,
+		struct rte_mbuf **pkts, uint16_t nb_pkts);
+
+/**
+ * Send packets to the kernel on a queue, notifying it once for the burst.
+ * The packets not sent are left to the caller.
+ *
+ * @param ep
+ *   Exception path.
+ * @param queue_id
+ *   Queue index.
+ * @param pkts
+ *   Packets to send.
+ * @param nb_pkts
+ *   Number of packets.
+ * @return
+ *   Number of packets sent.
+ */
+__rte_experimental
+uint16_t
+rte_expath_tx_burst(struct rte_expath *ep, uint16_t queue_id,
+		struct rte_mbuf **pkts, uint16_t nb_pkts);
+
+/**
+ * Buffer packets to send to the kernel on a queue. They are sent with a
+ * single notification once tx_batch packets are buffered, or on
+ * rte_expath_tx_flush(), which must be called periodically to bound the
+ * latency. The packets the kernel does not take are freed and counted as
+ * dropped.
+ *
+ * @param ep
+ *   Exception path.
+ * @param queue_id
+ *   Queue index.
+ * @param pkts
+ *   Packets to send, all taken by the call.
+ * @param nb_pkts
+ *   Number of packets.
+ * @return
+ *   Number of packets sent to the kernel by the call.
+ */
+__rte_experimental
+uint16_t
+rte_expath_tx_buffer(struct rte_expath *ep, uint16_t queue_id,
+		struct rte_mbuf **pkts, uint16_t nb_pkts);
+
+/**
+ * Send the packets buffered on a queue.
+ *
+ * @param ep
+ *   Exception path.
+ * @param queue_id
+ *   Queue index.
+ * @return
+ *   Number of packets sent.
+ */
+__rte_experimental
+uint16_t
+rte_expath_tx_flush(struct rte_expath *ep, uint16_t queue_id);
+
+/**
+ * Read the statistics of an exception path. The port statistics are read
+ * with the ethdev API.
+ *
+ * @param ep
+ *   Exception path.
+ * @param stats
+ *   Statistics, summed over the queues.
+ * @return
+ *   0 on success, -EINVAL on invalid parameters.
+ */
+__rte_experimental
+int
+rte_expath_stats_get(const struct rte_expath *ep,
+		struct rte_expath_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_EXPATH_H_ */
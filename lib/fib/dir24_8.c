@@ -120,6 +120,89 @@ dir24_8_get_lookup_fn(void *p, enum rte_fib_lookup_type type)
 	return NULL;
 }
 
+static inline rte_fib_lookup_hash_fn_t
+get_scalar_hash_fn(enum rte_fib_dir24_8_nh_sz nh_sz)
+{
+	switch (nh_sz) {
+	case RTE_FIB_DIR24_8_1B:
+		return dir24_8_lookup_bulk_hash_1b;
+	case RTE_FIB_DIR24_8_2B:
+		return dir24_8_lookup_bulk_hash_2b;
+	case RTE_FIB_DIR24_8_4B:
+		return dir24_8_lookup_bulk_hash_4b;
+	case RTE_FIB_DIR24_8_8B:
+		return dir24_8_lookup_bulk_hash_8b;
+	default:
+		return NULL;
+	}
+}
+
+static inline rte_fib_lookup_hash_fn_t
+get_vector_hash_fn(enum rte_fib_dir24_8_nh_sz nh_sz)
+{
+#ifdef CC_DIR24_8_AVX512_SUPPORT
+	if ((rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F) <= 0) ||
+			(rte_vect_get_max_simd_bitwidth() < RTE_VECT_SIMD_512))
+		return NULL;
+
+	switch (nh_sz) {
+	case RTE_FIB_DIR24_8_1B:
+		return rte_dir24_8_vec_lookup_bulk_hash_1b;
+	case RTE_FIB_DIR24_8_2B:
+		return rte_dir24_8_vec_lookup_bulk_hash_2b;
+	case RTE_FIB_DIR24_8_4B:
+		return rte_dir24_8_vec_lookup_bulk_hash_4b;
+	case RTE_FIB_DIR24_8_8B:
+		return rte_dir24_8_vec_lookup_bulk_hash_8b;
+	default:
+		return NULL;
+	}
+#else
+	RTE_SET_USED(nh_sz);
+#endif
+	return NULL;
+}
+
+rte_fib_lookup_hash_fn_t
+dir24_8_get_lookup_hash_fn(void *p, enum rte_fib_lookup_type type)
+{
+	enum rte_fib_dir24_8_nh_sz nh_sz;
+	rte_fib_lookup_hash_fn_t ret_fn;
+	struct dir24_8_tbl *dp = p;
+
+	if (dp == NULL)
+		return NULL;
+
+	nh_sz = dp->nh_sz;
+
+	/* The group resolution of all the scalar lookups is the same */
+	switch (type) {
+	case RTE_FIB_LOOKUP_DIR24_8_SCALAR_MACRO:
+	case RTE_FIB_LOOKUP_DIR24_8_SCALAR_INLINE:
+	case RTE_FIB_LOOKUP_DIR24_8_SCALAR_UNI:
+		return get_scalar_hash_fn(nh_sz);
+	case RTE_FIB_LOOKUP_DIR24_8_VECTOR_AVX512:
+		return get_vector_hash_fn(nh_sz);
+	case RTE_FIB_LOOKUP_DEFAULT:
+		ret_fn = get_vector_hash_fn(nh_sz);
+		return (ret_fn != NULL) ? ret_fn : get_scalar_hash_fn(nh_sz);
+	default:
+		return NULL;
+	}
+
+	return NULL;
+}
+
+static inline int
+is_valid_nh(struct dir24_8_tbl *dp, uint64_t nh)
+{
+	if (nh > get_max_nh(dp->nh_sz))
+		return 0;
+	/* group next hop values must refer to an existing group */
+	return ((nh & dp->nh_grp_flag) == 0) ||
+		((nh ^ dp->nh_grp_flag) < dp->nh_grp_num);
+}
+
 static void
 write_to_fib(void *ptr, uint64_t val, enum rte_fib_dir24_8_nh_sz size, int n)
 {
@@ -150,7 +233,7 @@ write_to_fib(void *ptr, uint64_t val, enum rte_fib_dir24_8_nh_sz size, int n)
 }
 
 static int
-tbl8_get_idx(struct dir24_8_tbl *dp)
+__tbl8_get_idx(struct dir24_8_tbl *dp)
 {
 	uint32_t i;
 	int bit_idx;
@@ -166,6 +249,21 @@ tbl8_get_idx(struct dir24_8_tbl *dp)
 	return -ENOSPC;
 }
 
+static int
+tbl8_get_idx(struct dir24_8_tbl *dp)
+{
+	int tbl8_idx;
+
+	tbl8_idx = __tbl8_get_idx(dp);
+	if (tbl8_idx == -ENOSPC && dp->dq != NULL) {
+		/* If there are no tbl8 groups try to reclaim one. */
+		if (rte_rcu_qsbr_dq_reclaim(dp->dq, 1, NULL, NULL, NULL) == 0)
+			tbl8_idx = __tbl8_get_idx(dp);
+	}
+
+	return tbl8_idx;
+}
+
 static inline void
 tbl8_free_idx(struct dir24_8_tbl *dp, int idx)
 {
@@ -190,9 +288,51 @@ tbl8_alloc(struct dir24_8_tbl *dp, uint64_t nh)
 		DIR24_8_EXT_ENT, dp->nh_sz,
 		DIR24_8_TBL8_GRP_NUM_ENT);
 	dp->cur_tbl8s++;
+	/* make the group visible before the tbl24 entry pointing to it */
+	__atomic_thread_fence(__ATOMIC_RELEASE);
 	return tbl8_idx;
 }
 
+static void
+tbl8_cleanup_and_free(struct dir24_8_tbl *dp, uint64_t tbl8_idx)
+{
+	uint8_t *ptr = (uint8_t *)dp->tbl8 +
+		((tbl8_idx * DIR24_8_TBL8_GRP_NUM_ENT) << dp->nh_sz);
+
+	memset(ptr, 0, DIR24_8_TBL8_GRP_NUM_ENT << dp->nh_sz);
+	tbl8_free_idx(dp, tbl8_idx);
+	dp->cur_tbl8s--;
+}
+
+static void
+__rcu_qsbr_free_resource(void *p, void *data, unsigned int n)
+{
+	struct dir24_8_tbl *dp = p;
+	uint64_t tbl8_idx = *(uint64_t *)data;
+
+	RTE_SET_USED(n);
+	tbl8_cleanup_and_free(dp, tbl8_idx);
+}
+
+static void
+tbl8_free(struct dir24_8_tbl *dp, uint64_t tbl8_idx)
+{
+	if (dp->v == NULL) {
+		tbl8_cleanup_and_free(dp, tbl8_idx);
+	} else if (dp->rcu_mode == RTE_FIB_QSBR_MODE_DQ &&
+			rte_rcu_qsbr_dq_enqueue(dp->dq,
+			(void *)&tbl8_idx) == 0) {
+		/* Freed once the readers are done with it. */
+	} else {
+		/*
+		 * Blocking mode, or defer queue full:
+		 * wait for quiescent state change.
+		 */
+		rte_rcu_qsbr_synchronize(dp->v, RTE_QSBR_THRID_INVALID);
+		tbl8_cleanup_and_free(dp, tbl8_idx);
+	}
+}
+
 static void
 tbl8_recycle(struct dir24_8_tbl *dp, uint32_t ip, uint64_t tbl8_idx)
 {
@@ -214,8 +354,6 @@ tbl8_recycle(struct dir24_8_tbl *dp, uint32_t ip, uint64_t tbl8_idx)
 		}
 		((uint8_t *)dp->tbl24)[ip >> 8] =
 			nh & ~DIR24_8_EXT_ENT;
-		for (i = 0; i < DIR24_8_TBL8_GRP_NUM_ENT; i++)
-			ptr8[i] = 0;
 		break;
 	case RTE_FIB_DIR24_8_2B:
 		ptr16 = &((uint16_t *)dp->tbl8)[tbl8_idx *
@@ -227,8 +365,6 @@ tbl8_recycle(struct dir24_8_tbl *dp, uint32_t ip, uint64_t tbl8_idx)
 		}
 		((uint16_t *)dp->tbl24)[ip >> 8] =
 			nh & ~DIR24_8_EXT_ENT;
-		for (i = 0; i < DIR24_8_TBL8_GRP_NUM_ENT; i++)
-			ptr16[i] = 0;
 		break;
 	case RTE_FIB_DIR24_8_4B:
 		ptr32 = &((uint32_t *)dp->tbl8)[tbl8_idx *
@@ -240,8 +376,6 @@ tbl8_recycle(struct dir24_8_tbl *dp, uint32_t ip, uint64_t tbl8_idx)
 		}
 		((uint32_t *)dp->tbl24)[ip >> 8] =
 			nh & ~DIR24_8_EXT_ENT;
-		for (i = 0; i < DIR24_8_TBL8_GRP_NUM_ENT; i++)
-			ptr32[i] = 0;
 		break;
 	case RTE_FIB_DIR24_8_8B:
 		ptr64 = &((uint64_t *)dp->tbl8)[tbl8_idx *
@@ -253,12 +387,9 @@ tbl8_recycle(struct dir24_8_tbl *dp, uint32_t ip, uint64_t tbl8_idx)
 		}
 		((uint64_t *)dp->tbl24)[ip >> 8] =
 			nh & ~DIR24_8_EXT_ENT;
-		for (i = 0; i < DIR24_8_TBL8_GRP_NUM_ENT; i++)
-			ptr64[i] = 0;
 		break;
 	}
-	tbl8_free_idx(dp, tbl8_idx);
-	dp->cur_tbl8s--;
+	tbl8_free(dp, tbl8_idx);
 }
 
 static int
@@ -425,7 +556,7 @@ dir24_8_modify(struct rte_fib *fib, uint32_t ip, uint8_t depth,
 	rib = rte_fib_get_rib(fib);
 	RTE_ASSERT((dp != NULL) && (rib != NULL));
 
-	if (next_hop > get_max_nh(dp->nh_sz))
+	if (!is_valid_nh(dp, next_hop))
 		return -EINVAL;
 
 	ip &= rte_rib_depth_to_mask(depth);
@@ -496,6 +627,217 @@ dir24_8_modify(struct rte_fib *fib, uint32_t ip, uint8_t depth,
 	return -EINVAL;
 }
 
+/* bulk route states */
+#define BULK_ROUTE_NEW		1 /* inserted in the RIB */
+#define BULK_ROUTE_RSVD		2 /* reserved a tbl8 */
+#define BULK_ROUTE_INSTALLED	4 /* written to the dataplane */
+
+struct bulk_route {
+	struct rte_rib_node	*node;
+	uint64_t		old_nh;	/* next hop of an updated route */
+	uint32_t		idx;	/* position in the input arrays */
+	uint32_t		ip;
+	uint8_t			depth;
+	uint8_t			flags;
+};
+
+/* most specific routes first, the same prefixes next to each other */
+static int
+bulk_route_cmp_depth(const void *a, const void *b)
+{
+	const struct bulk_route *ra = a;
+	const struct bulk_route *rb = b;
+
+	if (ra->depth != rb->depth)
+		return (int)rb->depth - (int)ra->depth;
+	if (ra->ip != rb->ip)
+		return (ra->ip < rb->ip) ? -1 : 1;
+	return (ra->idx < rb->idx) ? -1 : 1;
+}
+
+/* last added routes first */
+static int
+bulk_route_cmp_idx(const void *a, const void *b)
+{
+	const struct bulk_route *ra = a;
+	const struct bulk_route *rb = b;
+
+	return (ra->idx < rb->idx) ? 1 : -1;
+}
+
+/*
+ * Undo the RIB changes of the routes not written to the dataplane,
+ * last added first, so that repeated prefixes get their original
+ * next hop back.
+ */
+static void
+bulk_rollback(struct dir24_8_tbl *dp, struct rte_rib *rib,
+	struct bulk_route *r, uint32_t n)
+{
+	struct rte_rib_node *tmp;
+	uint32_t i;
+
+	qsort(r, n, sizeof(*r), bulk_route_cmp_idx);
+
+	for (i = 0; i != n; i++) {
+		if (r[i].flags & BULK_ROUTE_INSTALLED)
+			continue;
+		if (r[i].flags & BULK_ROUTE_NEW)
+			rte_rib_remove(rib, r[i].ip, r[i].depth);
+		else
+			rte_rib_set_nh(r[i].node, r[i].old_nh);
+	}
+
+	/* release the tbl8s reserved for /24s left without longer routes */
+	for (i = 0; i != n; i++) {
+		if ((r[i].flags & (BULK_ROUTE_RSVD | BULK_ROUTE_INSTALLED)) !=
+				BULK_ROUTE_RSVD)
+			continue;
+		tmp = rte_rib_get_nxt(rib, r[i].ip, 24, NULL,
+			RTE_RIB_GET_NXT_COVER);
+		if (tmp == NULL)
+			dp->rsvd_tbl8s--;
+	}
+}
+
+/* next hop of the most specific route equal to or covering a prefix */
+static uint64_t
+bulk_covering_nh(struct dir24_8_tbl *dp, struct rte_rib *rib, uint32_t ip,
+	uint8_t depth)
+{
+	struct rte_rib_node *node;
+	uint64_t nh;
+	int d;
+
+	for (d = depth; d >= 0; d--) {
+		node = rte_rib_lookup_exact(rib, ip & rte_rib_depth_to_mask(d),
+			d);
+		if (node != NULL) {
+			rte_rib_get_nh(node, &nh);
+			return nh;
+		}
+	}
+
+	return dp->def_nh;
+}
+
+int
+dir24_8_add_bulk(struct rte_fib *fib, const uint32_t *ips,
+	const uint8_t *depths, const uint64_t *next_hops, unsigned int n)
+{
+	struct dir24_8_tbl *dp;
+	struct rte_rib *rib;
+	struct rte_rib_node *node, *tmp;
+	struct bulk_route *r;
+	uint32_t i, ip, k;
+	uint64_t nh;
+	uint8_t depth;
+	int ret = 0;
+
+	if ((fib == NULL) || (ips == NULL) || (depths == NULL) ||
+			(next_hops == NULL))
+		return -EINVAL;
+
+	dp = rte_fib_get_dp(fib);
+	rib = rte_fib_get_rib(fib);
+	RTE_ASSERT((dp != NULL) && (rib != NULL));
+
+	if (n == 0)
+		return 0;
+
+	r = rte_malloc(NULL, n * sizeof(*r), 0);
+	if (r == NULL)
+		return -ENOMEM;
+
+	/*
+	 * First put all the routes in the RIB, so that each of them is then
+	 * written only to the ranges it is the most specific route for.
+	 */
+	for (i = 0, k = 0; i != n; i++) {
+		if ((depths[i] > RTE_FIB_MAXDEPTH) ||
+				!is_valid_nh(dp, next_hops[i])) {
+			ret = -EINVAL;
+			break;
+		}
+
+		r[k].idx = i;
+		r[k].depth = depths[i];
+		r[k].ip = ips[i] & rte_rib_depth_to_mask(depths[i]);
+		r[k].flags = 0;
+
+		node = rte_rib_lookup_exact(rib, r[k].ip, r[k].depth);
+		if (node != NULL) {
+			rte_rib_get_nh(node, &nh);
+			if (nh == next_hops[i])
+				continue;
+			r[k].old_nh = nh;
+		} else {
+			if (r[k].depth > 24) {
+				tmp = rte_rib_get_nxt(rib, r[k].ip, 24, NULL,
+					RTE_RIB_GET_NXT_COVER);
+				if (tmp == NULL) {
+					if (dp->rsvd_tbl8s >=
+							dp->number_tbl8s) {
+						ret = -ENOSPC;
+						break;
+					}
+					dp->rsvd_tbl8s++;
+					r[k].flags |= BULK_ROUTE_RSVD;
+				}
+			}
+			node = rte_rib_insert(rib, r[k].ip, r[k].depth);
+			if (node == NULL) {
+				ret = -rte_errno;
+				if (r[k].flags & BULK_ROUTE_RSVD)
+					dp->rsvd_tbl8s--;
+				break;
+			}
+			r[k].flags |= BULK_ROUTE_NEW;
+		}
+		rte_rib_set_nh(node, next_hops[i]);
+		r[k++].node = node;
+	}
+
+	if (ret != 0) {
+		bulk_rollback(dp, rib, r, k);
+		rte_free(r);
+		return ret;
+	}
+
+	/*
+	 * Then update the dataplane, most specific routes first:
+	 * should it fail, the routes already written do not depend
+	 * on the ones left, which can be removed from the RIB.
+	 */
+	qsort(r, k, sizeof(*r), bulk_route_cmp_depth);
+
+	for (i = 0; i != k; i++) {
+		/* the same prefix twice, already written */
+		if (i != 0 && r[i].node == r[i - 1].node) {
+			r[i].flags |= r[i - 1].flags & BULK_ROUTE_INSTALLED;
+			continue;
+		}
+
+		rte_rib_get_nh(r[i].node, &nh);
+		ret = modify_fib(dp, rib, r[i].ip, r[i].depth, nh);
+		if (ret != 0)
+			break;
+		r[i].flags |= BULK_ROUTE_INSTALLED;
+	}
+
+	if (ret != 0) {
+		ip = r[i].ip;
+		depth = r[i].depth;
+		bulk_rollback(dp, rib, r, k);
+		/* restore the part of the range written before the failure */
+		modify_fib(dp, rib, ip, depth, bulk_covering_nh(dp, rib, ip,
+			depth));
+	}
+
+	rte_free(r);
+	return ret;
+}
+
 void *
 dir24_8_create(const char *name, int socket_id, struct rte_fib_conf *fib_conf)
 {
@@ -567,7 +909,189 @@ dir24_8_free(void *p)
 {
 	struct dir24_8_tbl *dp = (struct dir24_8_tbl *)p;
 
+	if (dp->dq != NULL)
+		rte_rcu_qsbr_dq_delete(dp->dq);
+	rte_free(dp->nh_grp);
 	rte_free(dp->tbl8_idxes);
 	rte_free(dp->tbl8);
 	rte_free(dp);
 }
+
+int
+dir24_8_rcu_qsbr_add(struct dir24_8_tbl *dp, struct rte_fib_rcu_config *cfg,
+	const char *name)
+{
+	struct rte_rcu_qsbr_dq_parameters params = {0};
+	char rcu_dq_name[RTE_RCU_QSBR_DQ_NAMESIZE];
+
+	if (dp == NULL || cfg == NULL || cfg->v == NULL)
+		return -EINVAL;
+
+	if (dp->v != NULL)
+		return -EEXIST;
+
+	if (cfg->mode == RTE_FIB_QSBR_MODE_SYNC) {
+		/* No other things to do. */
+	} else if (cfg->mode == RTE_FIB_QSBR_MODE_DQ) {
+		/* Init QSBR defer queue. */
+		snprintf(rcu_dq_name, sizeof(rcu_dq_name),
+				"FIB_RCU_%s", name);
+		params.name = rcu_dq_name;
+		params.size = cfg->dq_size;
+		if (params.size == 0)
+			params.size = dp->number_tbl8s;
+		params.trigger_reclaim_limit = cfg->reclaim_thd;
+		params.max_reclaim_size = cfg->reclaim_max;
+		if (params.max_reclaim_size == 0)
+			params.max_reclaim_size = RTE_FIB_RCU_DQ_RECLAIM_MAX;
+		params.esize = sizeof(uint64_t);	/* tbl8 group index */
+		params.free_fn = __rcu_qsbr_free_resource;
+		params.p = dp;
+		params.v = cfg->v;
+		dp->dq = rte_rcu_qsbr_dq_create(&params);
+		if (dp->dq == NULL) {
+			RTE_LOG(ERR, LPM, "FIB defer queue creation failed\n");
+			return -rte_errno;
+		}
+	} else {
+		return -EINVAL;
+	}
+	dp->rcu_mode = cfg->mode;
+	dp->v = cfg->v;
+
+	return 0;
+}
+
+static inline uint64_t
+get_nh_grp_flag(uint8_t nh_sz)
+{
+	return 1ULL << (bits_in_nh(nh_sz) - 2);
+}
+
+int
+dir24_8_nh_group_create(struct rte_fib *fib,
+	const struct rte_fib_nh_group_conf *conf)
+{
+	char mem_name[DIR24_8_NAMESIZE];
+	struct dir24_8_tbl *dp;
+	struct rte_rib *rib;
+	struct rte_rib_node *node = NULL;
+	uint64_t flag, nh;
+
+	if ((fib == NULL) || (conf == NULL) || (conf->num_groups == 0) ||
+			!rte_is_power_of_2(conf->num_buckets))
+		return -EINVAL;
+
+	dp = rte_fib_get_dp(fib);
+	rib = rte_fib_get_rib(fib);
+	RTE_ASSERT((dp != NULL) && (rib != NULL));
+
+	if (dp->nh_grp != NULL)
+		return -EEXIST;
+
+	flag = get_nh_grp_flag(dp->nh_sz);
+	if ((conf->num_groups > flag) || ((uint64_t)conf->num_groups *
+			conf->num_buckets > DIR24_8_NH_GRP_MAX_BUCKETS))
+		return -EINVAL;
+
+	/*
+	 * The next hop values with the group flag, that were plain
+	 * next hops up to now, must refer to the new groups.
+	 */
+	if ((dp->def_nh & flag) && ((dp->def_nh ^ flag) >= conf->num_groups))
+		return -EINVAL;
+	node = rte_rib_lookup_exact(rib, 0, 0);
+	do {
+		if (node != NULL) {
+			rte_rib_get_nh(node, &nh);
+			if ((nh & flag) && ((nh ^ flag) >= conf->num_groups))
+				return -EINVAL;
+		}
+		node = rte_rib_get_nxt(rib, 0, 0, node,
+			RTE_RIB_GET_NXT_ALL);
+	} while (node != NULL);
+
+	/* padded for the 4 byte vector gathers of the last bucket */
+	snprintf(mem_name, sizeof(mem_name), "NH_GRP_%p", dp);
+	dp->nh_grp = rte_zmalloc_socket(mem_name,
+		((size_t)conf->num_groups * conf->num_buckets << dp->nh_sz) +
+		sizeof(uint64_t), RTE_CACHE_LINE_SIZE, SOCKET_ID_ANY);
+	if (dp->nh_grp == NULL)
+		return -ENOMEM;
+
+	/* Groups lead to the default next hop until they are set */
+	write_to_fib(dp->nh_grp, dp->def_nh, dp->nh_sz,
+		conf->num_groups * conf->num_buckets);
+	dp->nh_grp_num = conf->num_groups;
+	dp->nh_grp_sz_log2 = rte_log2_u32(conf->num_buckets);
+	/* make the buckets visible before the lookups resolve the groups */
+	__atomic_store_n(&dp->nh_grp_flag, flag, __ATOMIC_RELEASE);
+
+	return 0;
+}
+
+static inline void
+write_nh_grp_bucket(struct dir24_8_tbl *dp, uint32_t idx, uint64_t nh)
+{
+	switch (dp->nh_sz) {
+	case RTE_FIB_DIR24_8_1B:
+		__atomic_store_n(&((uint8_t *)dp->nh_grp)[idx], (uint8_t)nh,
+			__ATOMIC_RELAXED);
+		break;
+	case RTE_FIB_DIR24_8_2B:
+		__atomic_store_n(&((uint16_t *)dp->nh_grp)[idx],
+			(uint16_t)nh, __ATOMIC_RELAXED);
+		break;
+	case RTE_FIB_DIR24_8_4B:
+		__atomic_store_n(&((uint32_t *)dp->nh_grp)[idx],
+			(uint32_t)nh, __ATOMIC_RELAXED);
+		break;
+	case RTE_FIB_DIR24_8_8B:
+		__atomic_store_n(&((uint64_t *)dp->nh_grp)[idx], nh,
+			__ATOMIC_RELAXED);
+		break;
+	}
+}
+
+int
+dir24_8_nh_group_set(struct dir24_8_tbl *dp, uint32_t grp,
+	const uint64_t *next_hops, const uint32_t *weights, unsigned int n)
+{
+	uint64_t total = 0, cur = 0;
+	uint32_t num_buckets, base, b = 0, end;
+	unsigned int i;
+
+	if ((dp == NULL) || (next_hops == NULL) || (n == 0))
+		return -EINVAL;
+
+	if (dp->nh_grp == NULL)
+		return -ENOTSUP;
+
+	num_buckets = 1U << dp->nh_grp_sz_log2;
+	if ((grp >= dp->nh_grp_num) || (n > num_buckets))
+		return -EINVAL;
+
+	for (i = 0; i < n; i++) {
+		if ((next_hops[i] > get_max_nh(dp->nh_sz)) ||
+				(next_hops[i] & dp->nh_grp_flag))
+			return -EINVAL;
+		total += (weights != NULL) ? weights[i] : 1;
+	}
+	if ((total == 0) || (total > UINT32_MAX))
+		return -EINVAL;
+
+	/*
+	 * Each next hop gets a run of buckets ending at its rounded down
+	 * cumulative share, so that it is at most one bucket away from
+	 * its exact share.
+	 */
+	base = grp << dp->nh_grp_sz_log2;
+	for (i = 0; i < n; i++) {
+		cur += (weights != NULL) ? weights[i] : 1;
+		end = cur * num_buckets / total;
+		for (; b < end; b++)
+			write_nh_grp_bucket(dp, base + b, next_hops[i]);
+	}
+
+	return 0;
+}
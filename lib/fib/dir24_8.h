@@ -27,6 +27,9 @@ extern "C" {
 #define BITMAP_SLAB_BIT_SIZE		(1 << BITMAP_SLAB_BIT_SIZE_LOG2)
 #define BITMAP_SLAB_BITMASK		(BITMAP_SLAB_BIT_SIZE - 1)
 
+/* Maximum total number of next hop group buckets */
+#define DIR24_8_NH_GRP_MAX_BUCKETS	(1 << 24)
+
 struct dir24_8_tbl {
 	uint32_t	number_tbl8s;	/**< Total number of tbl8s */
 	uint32_t	rsvd_tbl8s;	/**< Number of reserved tbl8s */
@@ -35,6 +38,13 @@ struct dir24_8_tbl {
 	uint64_t	def_nh;		/**< Default next hop */
 	uint64_t	*tbl8;		/**< tbl8 table. */
 	uint64_t	*tbl8_idxes;	/**< bitmap containing free tbl8 idxes*/
+	struct rte_rcu_qsbr	*v;	/**< RCU QSBR variable */
+	enum rte_fib_qsbr_mode	rcu_mode;/**< Blocking, defer queue */
+	struct rte_rcu_qsbr_dq	*dq;	/**< RCU QSBR defer queue */
+	void		*nh_grp;	/**< Next hop group buckets */
+	uint64_t	nh_grp_flag;	/**< Group flag of next hop values */
+	uint32_t	nh_grp_num;	/**< Number of next hop groups */
+	uint32_t	nh_grp_sz_log2;	/**< Log2 of buckets per group */
 	/* tbl24 table. */
 	__extension__ uint64_t	tbl24[0] __rte_cache_aligned;
 };
@@ -145,6 +155,35 @@ LOOKUP_FUNC(2b, uint16_t, 6, 1)
 LOOKUP_FUNC(4b, uint32_t, 15, 2)
 LOOKUP_FUNC(8b, uint64_t, 12, 3)
 
+/* Replace the group next hop values by the next hop of the hash bucket */
+#define LOOKUP_HASH_FUNC(suffix, type)					\
+static inline void dir24_8_lookup_bulk_hash_##suffix(void *p,		\
+	const uint32_t *ips, const uint32_t *hashes,			\
+	uint64_t *next_hops, const unsigned int n)			\
+{									\
+	struct dir24_8_tbl *dp = (struct dir24_8_tbl *)p;		\
+	uint64_t flag = __atomic_load_n(&dp->nh_grp_flag,		\
+		__ATOMIC_ACQUIRE);					\
+	uint32_t log2 = dp->nh_grp_sz_log2;				\
+	uint32_t msk = (1U << log2) - 1;				\
+	uint32_t i;							\
+									\
+	dir24_8_lookup_bulk_##suffix(p, ips, next_hops, n);		\
+	if (flag == 0)							\
+		return;							\
+	for (i = 0; i < n; i++) {					\
+		if (unlikely(next_hops[i] & flag))			\
+			next_hops[i] = ((type *)dp->nh_grp)[		\
+				((next_hops[i] ^ flag) << log2) +	\
+				(hashes[i] & msk)];			\
+	}								\
+}									\
+
+LOOKUP_HASH_FUNC(1b, uint8_t)
+LOOKUP_HASH_FUNC(2b, uint16_t)
+LOOKUP_HASH_FUNC(4b, uint32_t)
+LOOKUP_HASH_FUNC(8b, uint64_t)
+
 static inline void
 dir24_8_lookup_bulk(struct dir24_8_tbl *dp, const uint32_t *ips,
 	uint64_t *next_hops, const unsigned int n, uint8_t nh_sz)
@@ -248,10 +287,29 @@ dir24_8_free(void *p);
 rte_fib_lookup_fn_t
 dir24_8_get_lookup_fn(void *p, enum rte_fib_lookup_type type);
 
+rte_fib_lookup_hash_fn_t
+dir24_8_get_lookup_hash_fn(void *p, enum rte_fib_lookup_type type);
+
 int
 dir24_8_modify(struct rte_fib *fib, uint32_t ip, uint8_t depth,
 	uint64_t next_hop, int op);
 
+int
+dir24_8_add_bulk(struct rte_fib *fib, const uint32_t *ips,
+	const uint8_t *depths, const uint64_t *next_hops, unsigned int n);
+
+int
+dir24_8_rcu_qsbr_add(struct dir24_8_tbl *dp, struct rte_fib_rcu_config *cfg,
+	const char *name);
+
+int
+dir24_8_nh_group_create(struct rte_fib *fib,
+	const struct rte_fib_nh_group_conf *conf);
+
+int
+dir24_8_nh_group_set(struct dir24_8_tbl *dp, uint32_t grp,
+	const uint64_t *next_hops, const uint32_t *weights, unsigned int n);
+
 #ifdef __cplusplus
 }
 #endif
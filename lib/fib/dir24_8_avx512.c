@@ -10,7 +10,7 @@
 
 static __rte_always_inline void
 dir24_8_vec_lookup_x16(void *p, const uint32_t *ips,
-	uint64_t *next_hops, int size)
+	const uint32_t *hashes, uint64_t *next_hops, int size)
 {
 	struct dir24_8_tbl *dp = (struct dir24_8_tbl *)p;
 	__mmask16 msk_ext;
@@ -68,6 +68,40 @@ dir24_8_vec_lookup_x16(void *p, const uint32_t *ips,
 	}
 
 	res = _mm512_srli_epi32(res, 1);
+
+	/* select the next hop of the groups by hash */
+	if (hashes != NULL) {
+		const __m512i grp_flag = _mm512_set1_epi32(
+			(uint32_t)__atomic_load_n(&dp->nh_grp_flag,
+			__ATOMIC_ACQUIRE));
+		__mmask16 msk_grp = _mm512_test_epi32_mask(res, grp_flag);
+
+		if (msk_grp != 0) {
+			bytes = _mm512_and_epi32(_mm512_loadu_si512(hashes),
+				_mm512_set1_epi32((1U << dp->nh_grp_sz_log2) - 1));
+			idxes = _mm512_andnot_epi32(grp_flag, res);
+			idxes = _mm512_sll_epi32(idxes,
+				_mm_cvtsi32_si128(dp->nh_grp_sz_log2));
+			idxes = _mm512_maskz_add_epi32(msk_grp, idxes, bytes);
+			if (size == sizeof(uint8_t)) {
+				idxes = _mm512_mask_i32gather_epi32(zero,
+					msk_grp, idxes,
+					(const int *)dp->nh_grp, 1);
+				idxes = _mm512_and_epi32(idxes, res_msk);
+			} else if (size == sizeof(uint16_t)) {
+				idxes = _mm512_mask_i32gather_epi32(zero,
+					msk_grp, idxes,
+					(const int *)dp->nh_grp, 2);
+				idxes = _mm512_and_epi32(idxes, res_msk);
+			} else
+				idxes = _mm512_mask_i32gather_epi32(zero,
+					msk_grp, idxes,
+					(const int *)dp->nh_grp, 4);
+
+			res = _mm512_mask_blend_epi32(msk_grp, res, idxes);
+		}
+	}
+
 	tmp1 = _mm512_maskz_expand_epi32(exp_msk, res);
 	tmp256 = _mm512_extracti32x8_epi32(res, 1);
 	tmp2 = _mm512_maskz_expand_epi32(exp_msk,
@@ -78,7 +112,7 @@ dir24_8_vec_lookup_x16(void *p, const uint32_t *ips,
 
 static __rte_always_inline void
 dir24_8_vec_lookup_x8_8b(void *p, const uint32_t *ips,
-	uint64_t *next_hops)
+	const uint32_t *hashes, uint64_t *next_hops)
 {
 	struct dir24_8_tbl *dp = (struct dir24_8_tbl *)p;
 	const __m512i zero = _mm512_set1_epi32(0);
@@ -111,6 +145,29 @@ dir24_8_vec_lookup_x8_8b(void *p, const uint32_t *ips,
 	}
 
 	res = _mm512_srli_epi64(res, 1);
+
+	/* select the next hop of the groups by hash */
+	if (hashes != NULL) {
+		const __m512i grp_flag = _mm512_set1_epi64(
+			__atomic_load_n(&dp->nh_grp_flag, __ATOMIC_ACQUIRE));
+		__mmask8 msk_grp = _mm512_test_epi64_mask(res, grp_flag);
+
+		if (msk_grp != 0) {
+			bytes = _mm512_cvtepu32_epi64(
+				_mm256_loadu_si256((const void *)hashes));
+			bytes = _mm512_and_epi64(bytes, _mm512_set1_epi64(
+				(1ULL << dp->nh_grp_sz_log2) - 1));
+			idxes = _mm512_andnot_epi64(grp_flag, res);
+			idxes = _mm512_sll_epi64(idxes,
+				_mm_cvtsi32_si128(dp->nh_grp_sz_log2));
+			idxes = _mm512_maskz_add_epi64(msk_grp, idxes, bytes);
+			idxes = _mm512_mask_i64gather_epi64(zero, msk_grp,
+				idxes, (const void *)dp->nh_grp, 8);
+
+			res = _mm512_mask_blend_epi64(msk_grp, res, idxes);
+		}
+	}
+
 	_mm512_storeu_si512(next_hops, res);
 }
 
@@ -120,8 +177,8 @@ rte_dir24_8_vec_lookup_bulk_1b(void *p, const uint32_t *ips,
 {
 	uint32_t i;
 	for (i = 0; i < (n / 16); i++)
-		dir24_8_vec_lookup_x16(p, ips + i * 16, next_hops + i * 16,
-			sizeof(uint8_t));
+		dir24_8_vec_lookup_x16(p, ips + i * 16, NULL,
+			next_hops + i * 16, sizeof(uint8_t));
 
 	dir24_8_lookup_bulk_1b(p, ips + i * 16, next_hops + i * 16,
 		n - i * 16);
@@ -133,8 +190,8 @@ rte_dir24_8_vec_lookup_bulk_2b(void *p, const uint32_t *ips,
 {
 	uint32_t i;
 	for (i = 0; i < (n / 16); i++)
-		dir24_8_vec_lookup_x16(p, ips + i * 16, next_hops + i * 16,
-			sizeof(uint16_t));
+		dir24_8_vec_lookup_x16(p, ips + i * 16, NULL,
+			next_hops + i * 16, sizeof(uint16_t));
 
 	dir24_8_lookup_bulk_2b(p, ips + i * 16, next_hops + i * 16,
 		n - i * 16);
@@ -146,8 +203,8 @@ rte_dir24_8_vec_lookup_bulk_4b(void *p, const uint32_t *ips,
 {
 	uint32_t i;
 	for (i = 0; i < (n / 16); i++)
-		dir24_8_vec_lookup_x16(p, ips + i * 16, next_hops + i * 16,
-			sizeof(uint32_t));
+		dir24_8_vec_lookup_x16(p, ips + i * 16, NULL,
+			next_hops + i * 16, sizeof(uint32_t));
 
 	dir24_8_lookup_bulk_4b(p, ips + i * 16, next_hops + i * 16,
 		n - i * 16);
@@ -159,7 +216,60 @@ rte_dir24_8_vec_lookup_bulk_8b(void *p, const uint32_t *ips,
 {
 	uint32_t i;
 	for (i = 0; i < (n / 8); i++)
-		dir24_8_vec_lookup_x8_8b(p, ips + i * 8, next_hops + i * 8);
+		dir24_8_vec_lookup_x8_8b(p, ips + i * 8, NULL,
+			next_hops + i * 8);
 
 	dir24_8_lookup_bulk_8b(p, ips + i * 8, next_hops + i * 8, n - i * 8);
 }
+
+void
+rte_dir24_8_vec_lookup_bulk_hash_1b(void *p, const uint32_t *ips,
+	const uint32_t *hashes, uint64_t *next_hops, const unsigned int n)
+{
+	uint32_t i;
+	for (i = 0; i < (n / 16); i++)
+		dir24_8_vec_lookup_x16(p, ips + i * 16, hashes + i * 16,
+			next_hops + i * 16, sizeof(uint8_t));
+
+	dir24_8_lookup_bulk_hash_1b(p, ips + i * 16, hashes + i * 16,
+		next_hops + i * 16, n - i * 16);
+}
+
+void
+rte_dir24_8_vec_lookup_bulk_hash_2b(void *p, const uint32_t *ips,
+	const uint32_t *hashes, uint64_t *next_hops, const unsigned int n)
+{
+	uint32_t i;
+	for (i = 0; i < (n / 16); i++)
+		dir24_8_vec_lookup_x16(p, ips + i * 16, hashes + i * 16,
+			next_hops + i * 16, sizeof(uint16_t));
+
+	dir24_8_lookup_bulk_hash_2b(p, ips + i * 16, hashes + i * 16,
+		next_hops + i * 16, n - i * 16);
+}
+
+void
+rte_dir24_8_vec_lookup_bulk_hash_4b(void *p, const uint32_t *ips,
+	const uint32_t *hashes, uint64_t *next_hops, const unsigned int n)
+{
+	uint32_t i;
+	for (i = 0; i < (n / 16); i++)
+		dir24_8_vec_lookup_x16(p, ips + i * 16, hashes + i * 16,
+			next_hops + i * 16, sizeof(uint32_t));
+
+	dir24_8_lookup_bulk_hash_4b(p, ips + i * 16, hashes + i * 16,
+		next_hops + i * 16, n - i * 16);
+}
+
+void
+rte_dir24_8_vec_lookup_bulk_hash_8b(void *p, const uint32_t *ips,
+	const uint32_t *hashes, uint64_t *next_hops, const unsigned int n)
+{
+	uint32_t i;
+	for (i = 0; i < (n / 8); i++)
+		dir24_8_vec_lookup_x8_8b(p, ips + i * 8, hashes + i * 8,
+			next_hops + i * 8);
+
+	dir24_8_lookup_bulk_hash_8b(p, ips + i * 8, hashes + i * 8,
+		next_hops + i * 8, n - i * 8);
+}
@@ -21,4 +21,20 @@ void
 rte_dir24_8_vec_lookup_bulk_8b(void *p, const uint32_t *ips,
 	uint64_t *next_hops, const unsigned int n);
 
+void
+rte_dir24_8_vec_lookup_bulk_hash_1b(void *p, const uint32_t *ips,
+	const uint32_t *hashes, uint64_t *next_hops, const unsigned int n);
+
+void
+rte_dir24_8_vec_lookup_bulk_hash_2b(void *p, const uint32_t *ips,
+	const uint32_t *hashes, uint64_t *next_hops, const unsigned int n);
+
+void
+rte_dir24_8_vec_lookup_bulk_hash_4b(void *p, const uint32_t *ips,
+	const uint32_t *hashes, uint64_t *next_hops, const unsigned int n);
+
+void
+rte_dir24_8_vec_lookup_bulk_hash_8b(void *p, const uint32_t *ips,
+	const uint32_t *hashes, uint64_t *next_hops, const unsigned int n);
+
 #endif /* _DIR248_AVX512_H_ */
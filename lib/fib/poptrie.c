@@ -0,0 +1,849 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <rte_debug.h>
+#include <rte_malloc.h>
+#include <rte_errno.h>
+#include <rte_memory.h>
+#include <rte_vect.h>
+
+#include <rte_rib6.h>
+#include <rte_fib6.h>
+#include "poptrie.h"
+
+#ifdef CC_POPTRIE_AVX512_SUPPORT
+
+#include "poptrie_avx512.h"
+
+#endif /* CC_POPTRIE_AVX512_SUPPORT */
+
+#define POPTRIE_NAMESIZE	64
+
+static inline rte_fib6_lookup_fn_t
+get_scalar_fn(enum rte_fib_trie_nh_sz nh_sz)
+{
+	switch (nh_sz) {
+	case RTE_FIB6_TRIE_2B:
+		return rte_poptrie_lookup_bulk_2b;
+	case RTE_FIB6_TRIE_4B:
+		return rte_poptrie_lookup_bulk_4b;
+	case RTE_FIB6_TRIE_8B:
+		return rte_poptrie_lookup_bulk_8b;
+	default:
+		return NULL;
+	}
+}
+
+static inline rte_fib6_lookup_fn_t
+get_vector_fn(enum rte_fib_trie_nh_sz nh_sz)
+{
+#ifdef CC_POPTRIE_AVX512_SUPPORT
+	if ((rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F) <= 0) ||
+			(rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512BW) <= 0) ||
+			(rte_vect_get_max_simd_bitwidth() < RTE_VECT_SIMD_512))
+		return NULL;
+	switch (nh_sz) {
+	case RTE_FIB6_TRIE_2B:
+		return rte_poptrie_vec_lookup_bulk_2b;
+	case RTE_FIB6_TRIE_4B:
+		return rte_poptrie_vec_lookup_bulk_4b;
+	case RTE_FIB6_TRIE_8B:
+		return rte_poptrie_vec_lookup_bulk_8b;
+	default:
+		return NULL;
+	}
+#else
+	RTE_SET_USED(nh_sz);
+#endif
+	return NULL;
+}
+
+rte_fib6_lookup_fn_t
+poptrie_get_lookup_fn(void *p, enum rte_fib6_lookup_type type)
+{
+	enum rte_fib_trie_nh_sz nh_sz;
+	rte_fib6_lookup_fn_t ret_fn;
+	struct rte_poptrie_tbl *dp = p;
+
+	if (dp == NULL)
+		return NULL;
+
+	nh_sz = dp->nh_sz;
+
+	switch (type) {
+	case RTE_FIB6_LOOKUP_POPTRIE_SCALAR:
+		return get_scalar_fn(nh_sz);
+	case RTE_FIB6_LOOKUP_POPTRIE_VECTOR_AVX512:
+		return get_vector_fn(nh_sz);
+	case RTE_FIB6_LOOKUP_DEFAULT:
+		ret_fn = get_vector_fn(nh_sz);
+		return (ret_fn != NULL) ? ret_fn : get_scalar_fn(nh_sz);
+	default:
+		return NULL;
+	}
+	return NULL;
+}
+
+static inline uint64_t
+get_max_nh(uint8_t nh_sz)
+{
+	return (1ULL << (8 * (1 << nh_sz) - 1)) - 1;
+}
+
+/*
+ * Size class of a block, blocks are rounded up to a power of 2 entries
+ */
+static inline uint32_t
+pool_class(uint32_t n)
+{
+	return rte_log2_u32(n);
+}
+
+static inline uint32_t
+pool_nb_slabs(const struct poptrie_pool *pool, uint32_t k)
+{
+	return RTE_ALIGN_CEIL(pool->size >> k, 64) / 64;
+}
+
+static inline void
+pool_set(struct poptrie_pool *pool, uint32_t k, uint32_t idx)
+{
+	uint32_t blk = idx >> k;
+
+	pool->bmp[k][blk / 64] |= 1ULL << (blk % 64);
+	pool->hint[k] = RTE_MIN(pool->hint[k], blk / 64);
+	pool->nb_free[k]++;
+}
+
+/* clear the free block bit, return non zero if it was set */
+static inline int
+pool_test_clear(struct poptrie_pool *pool, uint32_t k, uint32_t idx)
+{
+	uint32_t blk = idx >> k;
+	uint64_t bit = 1ULL << (blk % 64);
+
+	if (!(pool->bmp[k][blk / 64] & bit))
+		return 0;
+	pool->bmp[k][blk / 64] &= ~bit;
+	pool->nb_free[k]--;
+	return 1;
+}
+
+/* take the lowest free block of a size class */
+static int64_t
+pool_take(struct poptrie_pool *pool, uint32_t k)
+{
+	uint32_t i, nb = pool_nb_slabs(pool, k);
+	uint64_t slab;
+
+	if (pool->nb_free[k] == 0)
+		return -ENOSPC;
+
+	for (i = pool->hint[k]; i < nb; i++) {
+		slab = pool->bmp[k][i];
+		if (slab != 0) {
+			pool->bmp[k][i] = slab & (slab - 1);
+			pool->hint[k] = i;
+			pool->nb_free[k]--;
+			return (uint64_t)(i * 64 + __builtin_ctzll(slab)) << k;
+		}
+	}
+	return -ENOSPC;
+}
+
+static int
+pool_init(struct poptrie_pool *pool, const char *name, uint32_t size,
+	int socket_id)
+{
+	uint64_t *bmp;
+	uint32_t k, nb = 0;
+
+	pool->size = RTE_ALIGN_CEIL(size, POPTRIE_NODE_NUM_ENT);
+	for (k = 0; k < POPTRIE_NUM_CLASSES; k++)
+		nb += pool_nb_slabs(pool, k);
+
+	bmp = rte_zmalloc_socket(name, sizeof(uint64_t) * nb,
+		RTE_CACHE_LINE_SIZE, socket_id);
+	if (bmp == NULL)
+		return -ENOMEM;
+
+	for (k = 0; k < POPTRIE_NUM_CLASSES; k++) {
+		pool->bmp[k] = bmp;
+		pool->nb_free[k] = 0;
+		pool->hint[k] = 0;
+		bmp += pool_nb_slabs(pool, k);
+	}
+
+	/* the pool starts as free blocks of the largest size */
+	for (k = 0; k < pool->size; k += POPTRIE_NODE_NUM_ENT)
+		pool_set(pool, POPTRIE_NUM_CLASSES - 1, k);
+	return 0;
+}
+
+/*
+ * Allocate a block of n contiguous entries,
+ * splitting the lowest free block that is large enough
+ */
+static int64_t
+pool_alloc(struct poptrie_pool *pool, uint32_t n)
+{
+	uint32_t j, k;
+	int64_t idx = -ENOSPC;
+
+	if (n == 0)
+		return 0;
+
+	k = pool_class(n);
+	for (j = k; j < POPTRIE_NUM_CLASSES; j++) {
+		idx = pool_take(pool, j);
+		if (idx >= 0)
+			break;
+	}
+	if (idx < 0)
+		return idx;
+
+	while (j-- > k)
+		pool_set(pool, j, idx + (1 << j));
+	return idx;
+}
+
+/*
+ * Free a block of n contiguous entries, merging it with its free buddies
+ */
+static void
+pool_free(struct poptrie_pool *pool, uint32_t idx, uint32_t n)
+{
+	uint32_t k;
+
+	if (n == 0)
+		return;
+
+	for (k = pool_class(n); k < POPTRIE_NUM_CLASSES - 1; k++) {
+		if (!pool_test_clear(pool, k, idx ^ (1 << k)))
+			break;
+		idx &= ~(1 << k);
+	}
+	pool_set(pool, k, idx);
+}
+
+static void
+write_leaf(struct rte_poptrie_tbl *dp, uint32_t idx, uint64_t val)
+{
+	switch (dp->nh_sz) {
+	case RTE_FIB6_TRIE_2B:
+		((uint16_t *)dp->leaves)[idx] = (uint16_t)val;
+		break;
+	case RTE_FIB6_TRIE_4B:
+		((uint32_t *)dp->leaves)[idx] = (uint32_t)val;
+		break;
+	case RTE_FIB6_TRIE_8B:
+		((uint64_t *)dp->leaves)[idx] = val;
+		break;
+	}
+}
+
+static uint64_t
+read_leaf(struct rte_poptrie_tbl *dp, uint32_t idx)
+{
+	switch (dp->nh_sz) {
+	case RTE_FIB6_TRIE_2B:
+		return ((uint16_t *)dp->leaves)[idx];
+	case RTE_FIB6_TRIE_4B:
+		return ((uint32_t *)dp->leaves)[idx];
+	case RTE_FIB6_TRIE_8B:
+		return ((uint64_t *)dp->leaves)[idx];
+	}
+	return 0;
+}
+
+/*
+ * Set the 6 bits of an address starting at bit off,
+ * the bits past the end of the address are dropped
+ */
+static void
+set_bits(uint8_t *ip, uint32_t off, uint32_t val)
+{
+	uint32_t i, pos;
+
+	for (i = 0; i < POPTRIE_STRIDE; i++) {
+		pos = off + i;
+		if (pos >= RTE_FIB6_MAXDEPTH)
+			break;
+		if (val & (1 << (POPTRIE_STRIDE - 1 - i)))
+			ip[pos >> 3] |= 1 << (7 - (pos & 7));
+	}
+}
+
+/*
+ * Set the first bits of an address to a direct table index
+ */
+static void
+set_direct_idx(uint8_t *ip, uint32_t idx)
+{
+	ip[0] = idx >> 10;
+	ip[1] = (idx >> 2) & UINT8_MAX;
+	ip[2] = (idx & 3) << 6;
+}
+
+/*
+ * Get the next hop of the most specific route covering the whole
+ * ip/depth region
+ */
+static uint64_t
+get_cover_nh(struct rte_poptrie_tbl *dp, struct rte_rib6 *rib,
+	const uint8_t *ip, int depth)
+{
+	struct rte_rib6_node *tmp;
+	uint8_t tmp_depth;
+	uint64_t nh;
+
+	tmp = rte_rib6_lookup(rib, ip);
+	while (tmp != NULL) {
+		rte_rib6_get_depth(tmp, &tmp_depth);
+		if (tmp_depth <= depth)
+			break;
+		tmp = rte_rib6_lookup_parent(tmp);
+	}
+	if (tmp == NULL)
+		return dp->def_nh;
+
+	rte_rib6_get_nh(tmp, &nh);
+	return nh;
+}
+
+static inline int
+has_more_specifics(struct rte_rib6 *rib, const uint8_t *ip, int depth)
+{
+	return rte_rib6_get_nxt(rib, ip, depth, NULL,
+		RTE_RIB6_GET_NXT_COVER) != NULL;
+}
+
+/*
+ * Free the children and the leaves of a replaced node,
+ * but the subtrees of the children kept by its replacement
+ */
+static void
+free_node(struct rte_poptrie_tbl *dp, const struct poptrie_node *node,
+	uint64_t keep)
+{
+	uint32_t c, i = 0, nb_child;
+
+	nb_child = __builtin_popcountll(node->vector);
+	for (c = 0; c < POPTRIE_NODE_NUM_ENT; c++) {
+		if (!(node->vector & (1ULL << c)))
+			continue;
+		if (!(keep & (1ULL << c)))
+			free_node(dp, &dp->nodes[node->base1 + i], 0);
+		i++;
+	}
+
+	pool_free(&dp->node_pool, node->base1, nb_child);
+	pool_free(&dp->leaf_pool, node->base0,
+		__builtin_popcountll(node->leafvec));
+}
+
+static int
+build_node(struct rte_poptrie_tbl *dp, struct rte_rib6 *rib,
+	struct poptrie_node *node, const uint8_t *ip, int depth, uint64_t nh);
+
+/*
+ * Fill a node from the next hops of its leaf children and the bitmap
+ * of its internal node children. The children in keep are copied from
+ * the old node, the other internal node children are built from the RIB.
+ */
+static int
+install_node(struct rte_poptrie_tbl *dp, struct rte_rib6 *rib,
+	struct poptrie_node *node, const uint8_t *ip, int depth,
+	const uint64_t *val, uint64_t vector,
+	const struct poptrie_node *old, uint64_t keep)
+{
+	uint8_t child_ip[RTE_FIB6_IPV6_ADDR_SIZE];
+	uint64_t leafvec = 0, nh = 0;
+	uint32_t c, i, nb_leaves = 0, nb_child;
+	int64_t base0, base1 = 0;
+	int ret;
+
+	/* compress the runs of identical leaves */
+	for (c = 0; c < POPTRIE_NODE_NUM_ENT; c++) {
+		if (vector & (1ULL << c))
+			continue;
+		if ((nb_leaves == 0) || (val[c] != nh)) {
+			leafvec |= 1ULL << c;
+			nh = val[c];
+			nb_leaves++;
+		}
+	}
+
+	base0 = pool_alloc(&dp->leaf_pool, nb_leaves);
+	if (base0 < 0)
+		return base0;
+	for (c = 0, i = 0; c < POPTRIE_NODE_NUM_ENT; c++) {
+		if (leafvec & (1ULL << c))
+			write_leaf(dp, base0 + i++, val[c]);
+	}
+
+	nb_child = __builtin_popcountll(vector);
+	if (nb_child != 0) {
+		base1 = pool_alloc(&dp->node_pool, nb_child);
+		if (base1 < 0) {
+			pool_free(&dp->leaf_pool, base0, nb_leaves);
+			return base1;
+		}
+	}
+	for (c = 0, i = 0; c < POPTRIE_NODE_NUM_ENT; c++) {
+		if (!(vector & (1ULL << c)))
+			continue;
+		if (keep & (1ULL << c)) {
+			dp->nodes[base1 + i++] = dp->nodes[old->base1 +
+				__builtin_popcountll(old->vector &
+				((1ULL << c) - 1))];
+			continue;
+		}
+		rte_rib6_copy_addr(child_ip, ip);
+		set_bits(child_ip, depth, c);
+		ret = build_node(dp, rib, &dp->nodes[base1 + i], child_ip,
+			depth + POPTRIE_STRIDE, val[c]);
+		if (ret < 0) {
+			/* free the subtrees built so far */
+			while (c-- > 0) {
+				if ((vector & ~keep) & (1ULL << c))
+					free_node(dp, &dp->nodes[base1 +
+						__builtin_popcountll(vector &
+						((1ULL << c) - 1))], 0);
+			}
+			pool_free(&dp->node_pool, base1, nb_child);
+			pool_free(&dp->leaf_pool, base0, nb_leaves);
+			return ret;
+		}
+		i++;
+	}
+
+	node->vector = vector;
+	node->leafvec = leafvec;
+	node->base0 = base0;
+	node->base1 = base1;
+	return 0;
+}
+
+/*
+ * Build from the RIB the node of the ip/depth region,
+ * nh being the next hop of the region
+ */
+static int
+build_node(struct rte_poptrie_tbl *dp, struct rte_rib6 *rib,
+	struct poptrie_node *node, const uint8_t *ip, int depth, uint64_t nh)
+{
+	/* routes ending in the node: up to 2 + 4 + ... + 64 */
+	struct rte_rib6_node *routes[2 * POPTRIE_NODE_NUM_ENT];
+	uint8_t route_depth[2 * POPTRIE_NODE_NUM_ENT];
+	uint64_t val[POPTRIE_NODE_NUM_ENT];
+	uint8_t tmp_ip[RTE_FIB6_IPV6_ADDR_SIZE];
+	struct rte_rib6_node *tmp = NULL;
+	uint64_t vector = 0;
+	uint32_t i, j, c, nb, n = 0;
+	uint8_t tmp_depth;
+
+	/* sort the routes ending in the node by depth */
+	while ((tmp = rte_rib6_get_nxt(rib, ip, depth, tmp,
+			RTE_RIB6_GET_NXT_ALL)) != NULL) {
+		rte_rib6_get_depth(tmp, &tmp_depth);
+		if (tmp_depth > depth + POPTRIE_STRIDE) {
+			rte_rib6_get_ip(tmp, tmp_ip);
+			vector |= 1ULL << poptrie_get_bits(tmp_ip, depth);
+			continue;
+		}
+		for (j = n++; (j > 0) && (route_depth[j - 1] > tmp_depth); j--) {
+			routes[j] = routes[j - 1];
+			route_depth[j] = route_depth[j - 1];
+		}
+		routes[j] = tmp;
+		route_depth[j] = tmp_depth;
+	}
+
+	/* expand them to the children, more specifics last */
+	for (c = 0; c < POPTRIE_NODE_NUM_ENT; c++)
+		val[c] = nh;
+	for (i = 0; i < n; i++) {
+		rte_rib6_get_ip(routes[i], tmp_ip);
+		rte_rib6_get_nh(routes[i], &nh);
+		c = poptrie_get_bits(tmp_ip, depth);
+		nb = 1 << (depth + POPTRIE_STRIDE - route_depth[i]);
+		for (j = 0; j < nb; j++)
+			val[c + j] = nh;
+	}
+
+	return install_node(dp, rib, node, ip, depth, val, vector, NULL, 0);
+}
+
+/*
+ * Rebuild the node of the ip/depth region after a change of
+ * the rt_ip/rt_depth route. Only the children the route overlaps are
+ * looked up in the RIB, the others are taken from the old node and
+ * the subtrees of its internal node children are kept.
+ */
+static int
+rebuild_node(struct rte_poptrie_tbl *dp, struct rte_rib6 *rib,
+	struct poptrie_node *node, const struct poptrie_node *old,
+	const uint8_t *ip, int depth, const uint8_t *rt_ip, int rt_depth,
+	uint64_t *keep)
+{
+	uint8_t child_ip[RTE_FIB6_IPV6_ADDR_SIZE];
+	uint64_t val[POPTRIE_NODE_NUM_ENT];
+	uint64_t vector = 0, bit;
+	uint32_t c, first, last;
+
+	first = poptrie_get_bits(rt_ip, depth);
+	last = first;
+	if (rt_depth <= depth + POPTRIE_STRIDE)
+		last += (1 << (depth + POPTRIE_STRIDE - rt_depth)) - 1;
+
+	*keep = 0;
+	for (c = 0; c < POPTRIE_NODE_NUM_ENT; c++) {
+		bit = 1ULL << c;
+		if ((c >= first) && (c <= last)) {
+			rte_rib6_copy_addr(child_ip, ip);
+			set_bits(child_ip, depth, c);
+			val[c] = get_cover_nh(dp, rib, child_ip,
+				depth + POPTRIE_STRIDE);
+			if (has_more_specifics(rib, child_ip,
+					depth + POPTRIE_STRIDE))
+				vector |= bit;
+		} else if (old->vector & bit) {
+			vector |= bit;
+			*keep |= bit;
+		} else
+			val[c] = read_leaf(dp, old->base0 +
+				__builtin_popcountll(old->leafvec &
+				((bit << 1) - 1)) - 1);
+	}
+
+	return install_node(dp, rib, node, ip, depth, val, vector, old, *keep);
+}
+
+/*
+ * Update the subtree of the node nidx for the ip/depth region after
+ * a change of the rt_ip/rt_depth route.
+ * The lowest node whose children change is rebuilt into new memory and
+ * the changed children blocks of its ancestors are copied, so that the
+ * subtree is either fully updated or left untouched.
+ * Return the index of the node of the region, the caller frees
+ * the old node with free_node() if it changed.
+ */
+static int64_t
+update_subtree(struct rte_poptrie_tbl *dp, struct rte_rib6 *rib,
+	uint32_t nidx, const uint8_t *ip, int depth,
+	const uint8_t *rt_ip, int rt_depth, uint64_t *keep)
+{
+	struct poptrie_node *node = &dp->nodes[nidx];
+	uint8_t child_ip[RTE_FIB6_IPV6_ADDR_SIZE];
+	uint32_t c, rank, nb_child, old;
+	uint64_t child_keep;
+	int64_t idx, ret;
+
+	if (rt_depth > depth + POPTRIE_STRIDE) {
+		c = poptrie_get_bits(rt_ip, depth);
+		rte_rib6_copy_addr(child_ip, ip);
+		set_bits(child_ip, depth, c);
+		if ((node->vector & (1ULL << c)) && has_more_specifics(rib,
+				child_ip, depth + POPTRIE_STRIDE)) {
+			rank = __builtin_popcountll(node->vector &
+				((1ULL << c) - 1));
+			ret = update_subtree(dp, rib, node->base1 + rank,
+				child_ip, depth + POPTRIE_STRIDE,
+				rt_ip, rt_depth, &child_keep);
+			if (ret < 0)
+				return ret;
+			if (ret == node->base1 + rank)
+				return nidx;
+
+			nb_child = __builtin_popcountll(node->vector);
+			idx = pool_alloc(&dp->node_pool, nb_child);
+			if (idx < 0) {
+				free_node(dp, &dp->nodes[ret],
+					child_keep);
+				pool_free(&dp->node_pool, ret, 1);
+				return idx;
+			}
+			memcpy(&dp->nodes[idx], &dp->nodes[node->base1],
+				sizeof(struct poptrie_node) * nb_child);
+			dp->nodes[idx + rank] = dp->nodes[ret];
+			pool_free(&dp->node_pool, ret, 1);
+
+			old = node->base1;
+			__atomic_store_n(&node->base1, idx, __ATOMIC_RELEASE);
+			free_node(dp, &dp->nodes[old + rank], child_keep);
+			pool_free(&dp->node_pool, old, nb_child);
+			return nidx;
+		}
+	}
+
+	idx = pool_alloc(&dp->node_pool, 1);
+	if (idx < 0)
+		return idx;
+	ret = rebuild_node(dp, rib, &dp->nodes[idx], node, ip, depth,
+		rt_ip, rt_depth, keep);
+	if (ret < 0) {
+		pool_free(&dp->node_pool, idx, 1);
+		return ret;
+	}
+	return idx;
+}
+
+/*
+ * Update the direct table entry e after a change of
+ * the rt_ip/rt_depth route
+ */
+static int
+update_direct(struct rte_poptrie_tbl *dp, struct rte_rib6 *rib, uint32_t e,
+	const uint8_t *rt_ip, int rt_depth)
+{
+	uint8_t ip[RTE_FIB6_IPV6_ADDR_SIZE] = {0};
+	uint64_t old = dp->direct[e];
+	uint64_t ent, keep = 0;
+	int64_t idx;
+	int ret;
+
+	set_direct_idx(ip, e);
+
+	if (!has_more_specifics(rib, ip, POPTRIE_DIRECT_BITS)) {
+		ent = get_cover_nh(dp, rib, ip, POPTRIE_DIRECT_BITS) << 1;
+	} else if ((old & POPTRIE_EXT_ENT) &&
+			(rt_depth > POPTRIE_DIRECT_BITS)) {
+		idx = update_subtree(dp, rib, old >> 1, ip,
+			POPTRIE_DIRECT_BITS, rt_ip, rt_depth, &keep);
+		if (idx < 0)
+			return idx;
+		if ((uint64_t)idx == old >> 1)
+			return 0;
+		ent = (idx << 1) | POPTRIE_EXT_ENT;
+	} else {
+		idx = pool_alloc(&dp->node_pool, 1);
+		if (idx < 0)
+			return idx;
+		ret = build_node(dp, rib, &dp->nodes[idx], ip,
+			POPTRIE_DIRECT_BITS,
+			get_cover_nh(dp, rib, ip, POPTRIE_DIRECT_BITS));
+		if (ret < 0) {
+			pool_free(&dp->node_pool, idx, 1);
+			return ret;
+		}
+		ent = (idx << 1) | POPTRIE_EXT_ENT;
+	}
+
+	__atomic_store_n(&dp->direct[e], ent, __ATOMIC_RELEASE);
+	if (old & POPTRIE_EXT_ENT) {
+		free_node(dp, &dp->nodes[old >> 1], keep);
+		pool_free(&dp->node_pool, old >> 1, 1);
+	}
+	return 0;
+}
+
+static int
+update_dp(struct rte_poptrie_tbl *dp, struct rte_rib6 *rib,
+	const uint8_t ip[RTE_FIB6_IPV6_ADDR_SIZE], uint8_t depth)
+{
+	uint8_t ent_ip[RTE_FIB6_IPV6_ADDR_SIZE] = {0};
+	struct rte_rib6_node *tmp;
+	uint32_t e, first, last;
+	uint8_t tmp_depth = 0;
+	int ret;
+
+	first = poptrie_direct_idx(ip);
+	if (depth > POPTRIE_DIRECT_BITS)
+		return update_direct(dp, rib, first, ip, depth);
+
+	last = first + (1 << (POPTRIE_DIRECT_BITS - depth));
+	for (e = first; e < last; e++) {
+		/* skip the entries of the more specifics of the route */
+		set_direct_idx(ent_ip, e);
+		tmp = rte_rib6_lookup(rib, ent_ip);
+		while (tmp != NULL) {
+			rte_rib6_get_depth(tmp, &tmp_depth);
+			if (tmp_depth <= POPTRIE_DIRECT_BITS)
+				break;
+			tmp = rte_rib6_lookup_parent(tmp);
+		}
+		if ((tmp != NULL) && (tmp_depth > depth))
+			continue;
+
+		ret = update_direct(dp, rib, e, ip, depth);
+		if (ret < 0)
+			return ret;
+	}
+	return 0;
+}
+
+int
+poptrie_modify(struct rte_fib6 *fib, const uint8_t ip[RTE_FIB6_IPV6_ADDR_SIZE],
+	uint8_t depth, uint64_t next_hop, int op)
+{
+	struct rte_poptrie_tbl *dp;
+	struct rte_rib6 *rib;
+	struct rte_rib6_node *node;
+	uint8_t	ip_masked[RTE_FIB6_IPV6_ADDR_SIZE];
+	uint64_t node_nh;
+	int i, ret;
+
+	if ((fib == NULL) || (ip == NULL) || (depth > RTE_FIB6_MAXDEPTH))
+		return -EINVAL;
+
+	dp = rte_fib6_get_dp(fib);
+	RTE_ASSERT(dp);
+	rib = rte_fib6_get_rib(fib);
+	RTE_ASSERT(rib);
+
+	for (i = 0; i < RTE_FIB6_IPV6_ADDR_SIZE; i++)
+		ip_masked[i] = ip[i] & get_msk_part(depth, i);
+
+	/*
+	 * The RIB is changed first and the data plane rebuilt from it,
+	 * on failure the RIB is restored and the changed entries with it.
+	 */
+	node = rte_rib6_lookup_exact(rib, ip_masked, depth);
+	switch (op) {
+	case RTE_FIB6_ADD:
+		if (next_hop > get_max_nh(dp->nh_sz))
+			return -EINVAL;
+
+		if (node != NULL) {
+			rte_rib6_get_nh(node, &node_nh);
+			if (node_nh == next_hop)
+				return 0;
+			rte_rib6_set_nh(node, next_hop);
+			ret = update_dp(dp, rib, ip_masked, depth);
+			if (ret != 0) {
+				rte_rib6_set_nh(node, node_nh);
+				update_dp(dp, rib, ip_masked, depth);
+			}
+			return ret;
+		}
+
+		node = rte_rib6_insert(rib, ip_masked, depth);
+		if (node == NULL)
+			return -rte_errno;
+		rte_rib6_set_nh(node, next_hop);
+		ret = update_dp(dp, rib, ip_masked, depth);
+		if (ret != 0) {
+			rte_rib6_remove(rib, ip_masked, depth);
+			update_dp(dp, rib, ip_masked, depth);
+		}
+		return ret;
+	case RTE_FIB6_DEL:
+		if (node == NULL)
+			return -ENOENT;
+
+		rte_rib6_get_nh(node, &node_nh);
+		rte_rib6_remove(rib, ip_masked, depth);
+		ret = update_dp(dp, rib, ip_masked, depth);
+		if (ret != 0) {
+			node = rte_rib6_insert(rib, ip_masked, depth);
+			if (node != NULL) {
+				rte_rib6_set_nh(node, node_nh);
+				update_dp(dp, rib, ip_masked, depth);
+			}
+		}
+		return ret;
+	default:
+		break;
+	}
+	return -EINVAL;
+}
+
+void *
+poptrie_create(const char *name, int socket_id, struct rte_fib6_conf *conf)
+{
+	char mem_name[POPTRIE_NAMESIZE];
+	struct rte_poptrie_tbl *dp = NULL;
+	uint64_t	def_nh;
+	uint32_t	num_nodes, num_leaves, i;
+	enum rte_fib_trie_nh_sz	nh_sz;
+
+	if ((name == NULL) || (conf == NULL) ||
+			(conf->poptrie.nh_sz < RTE_FIB6_TRIE_2B) ||
+			(conf->poptrie.nh_sz > RTE_FIB6_TRIE_8B) ||
+			(conf->poptrie.num_nodes == 0) ||
+			(conf->poptrie.num_nodes > INT32_MAX) ||
+			(conf->poptrie.num_leaves == 0) ||
+			(conf->poptrie.num_leaves > INT32_MAX) ||
+			(conf->default_nh >
+			get_max_nh(conf->poptrie.nh_sz))) {
+
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	def_nh = conf->default_nh;
+	nh_sz = conf->poptrie.nh_sz;
+	num_nodes = conf->poptrie.num_nodes;
+	num_leaves = conf->poptrie.num_leaves;
+
+	snprintf(mem_name, sizeof(mem_name), "DP_%s", name);
+	dp = rte_zmalloc_socket(name, sizeof(struct rte_poptrie_tbl) +
+		POPTRIE_DIRECT_NUM_ENT * sizeof(uint64_t), RTE_CACHE_LINE_SIZE,
+		socket_id);
+	if (dp == NULL) {
+		rte_errno = ENOMEM;
+		return dp;
+	}
+
+	for (i = 0; i < POPTRIE_DIRECT_NUM_ENT; i++)
+		dp->direct[i] = def_nh << 1;
+	dp->def_nh = def_nh;
+	dp->nh_sz = nh_sz;
+
+	num_nodes = RTE_ALIGN_CEIL(num_nodes, POPTRIE_NODE_NUM_ENT);
+	num_leaves = RTE_ALIGN_CEIL(num_leaves, POPTRIE_NODE_NUM_ENT);
+
+	snprintf(mem_name, sizeof(mem_name), "NODES_%p", dp);
+	dp->nodes = rte_zmalloc_socket(mem_name,
+		sizeof(struct poptrie_node) * num_nodes,
+		RTE_CACHE_LINE_SIZE, socket_id);
+	if (dp->nodes == NULL)
+		goto free_dp;
+
+	/* vector lookup reads 8 bytes whatever the next hop size */
+	snprintf(mem_name, sizeof(mem_name), "LEAVES_%p", dp);
+	dp->leaves = rte_zmalloc_socket(mem_name,
+		((uint64_t)num_leaves << nh_sz) + sizeof(uint64_t),
+		RTE_CACHE_LINE_SIZE, socket_id);
+	if (dp->leaves == NULL)
+		goto free_nodes;
+
+	snprintf(mem_name, sizeof(mem_name), "NODES_idxes_%p", dp);
+	if (pool_init(&dp->node_pool, mem_name, num_nodes, socket_id) != 0)
+		goto free_leaves;
+
+	snprintf(mem_name, sizeof(mem_name), "LEAVES_idxes_%p", dp);
+	if (pool_init(&dp->leaf_pool, mem_name, num_leaves, socket_id) != 0)
+		goto free_node_pool;
+
+	return dp;
+
+free_node_pool:
+	rte_free(dp->node_pool.bmp[0]);
+free_leaves:
+	rte_free(dp->leaves);
+free_nodes:
+	rte_free(dp->nodes);
+free_dp:
+	rte_free(dp);
+	rte_errno = ENOMEM;
+	return NULL;
+}
+
+void
+poptrie_free(void *p)
+{
+	struct rte_poptrie_tbl *dp = (struct rte_poptrie_tbl *)p;
+
+	rte_free(dp->leaf_pool.bmp[0]);
+	rte_free(dp->node_pool.bmp[0]);
+	rte_free(dp->leaves);
+	rte_free(dp->nodes);
+	rte_free(dp);
+}
@@ -0,0 +1,141 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#ifndef _POPTRIE_H_
+#define _POPTRIE_H_
+
+/**
+ * @file
+ * RTE IPv6 Longest Prefix Match (LPM) using a poptrie
+ *
+ * The first 18 bits of an address index a direct table, the next bits
+ * are consumed 6 at a time by the internal nodes. Each node holds a
+ * bitmap of its internal node children and a bitmap of the runs of
+ * identical leaves, the children and the leaves being packed in
+ * arrays indexed by popcount.
+ */
+#include <rte_prefetch.h>
+#include <rte_branch_prediction.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* @internal Number of address bits indexing the direct table. */
+#define POPTRIE_DIRECT_BITS	18
+/* @internal Total number of direct table entries. */
+#define POPTRIE_DIRECT_NUM_ENT	(1 << POPTRIE_DIRECT_BITS)
+/* @internal Number of address bits consumed by an internal node. */
+#define POPTRIE_STRIDE		6
+/* @internal Number of children of an internal node. */
+#define POPTRIE_NODE_NUM_ENT	(1 << POPTRIE_STRIDE)
+/* @internal Direct table entry pointing to an internal node. */
+#define POPTRIE_EXT_ENT		1
+/* @internal Number of block size classes, 1 to 64 entries. */
+#define POPTRIE_NUM_CLASSES	(POPTRIE_STRIDE + 1)
+
+struct poptrie_node {
+	uint64_t	vector;	 /**< Bitmap of the internal node children */
+	uint64_t	leafvec; /**< Bitmap of the first leaf of each run */
+	uint32_t	base0;	 /**< Index of the first leaf */
+	uint32_t	base1;	 /**< Index of the first internal node child */
+};
+
+/* Buddy allocator of contiguous blocks of nodes or leaves */
+struct poptrie_pool {
+	uint32_t	size;	/**< Total number of entries, multiple of 64 */
+	/** Number of free blocks of each size class */
+	uint32_t	nb_free[POPTRIE_NUM_CLASSES];
+	/** First slab of each size class that may have a free block */
+	uint32_t	hint[POPTRIE_NUM_CLASSES];
+	/** Bitmaps of the free blocks of each size class */
+	uint64_t	*bmp[POPTRIE_NUM_CLASSES];
+};
+
+struct rte_poptrie_tbl {
+	uint64_t	def_nh;		/**< Default next hop */
+	enum rte_fib_trie_nh_sz	nh_sz;	/**< Size of nexthop entry */
+	struct poptrie_node	*nodes;	/**< Internal nodes */
+	void		*leaves;	/**< Next hops */
+	struct poptrie_pool	node_pool;
+	struct poptrie_pool	leaf_pool;
+	/* direct table, indexed by the first 18 bits of the address. */
+	__extension__ uint64_t	direct[0] __rte_cache_aligned;
+};
+
+static inline uint32_t
+poptrie_direct_idx(const uint8_t *ip)
+{
+	return ip[0] << 10 | ip[1] << 2 | ip[2] >> 6;
+}
+
+/*
+ * Get the 6 bits of an address starting at bit off,
+ * the bits past the end of the address read as zero
+ */
+static inline uint32_t
+poptrie_get_bits(const uint8_t *ip, uint32_t off)
+{
+	uint32_t byte = off >> 3;
+	uint32_t val = ip[byte] << 8;
+
+	if (byte + 1 < RTE_FIB6_IPV6_ADDR_SIZE)
+		val |= ip[byte + 1];
+	return (val >> (16 - POPTRIE_STRIDE - (off & 7))) &
+		(POPTRIE_NODE_NUM_ENT - 1);
+}
+
+#define POPTRIE_LOOKUP_FUNC(suffix, type)				\
+static inline void rte_poptrie_lookup_bulk_##suffix(void *p,		\
+	uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE],				\
+	uint64_t *next_hops, const unsigned int n)			\
+{									\
+	struct rte_poptrie_tbl *dp = (struct rte_poptrie_tbl *)p;	\
+	const struct poptrie_node *node;				\
+	uint64_t ent, msk;						\
+	uint32_t i, c, off;						\
+									\
+	for (i = 0; i < n; i++) {					\
+		ent = dp->direct[poptrie_direct_idx(ips[i])];		\
+		if (!(ent & POPTRIE_EXT_ENT)) {				\
+			next_hops[i] = ent >> 1;			\
+			continue;					\
+		}							\
+		node = &dp->nodes[ent >> 1];				\
+		off = POPTRIE_DIRECT_BITS;				\
+		for (;;) {						\
+			c = poptrie_get_bits(ips[i], off);		\
+			msk = (2ULL << c) - 1;				\
+			if (!(node->vector & (1ULL << c)))		\
+				break;					\
+			node = &dp->nodes[node->base1 +			\
+				__builtin_popcountll(node->vector & msk) - 1]; \
+			off += POPTRIE_STRIDE;				\
+		}							\
+		next_hops[i] = ((type *)dp->leaves)[node->base0 +	\
+			__builtin_popcountll(node->leafvec & msk) - 1];	\
+	}								\
+}
+POPTRIE_LOOKUP_FUNC(2b, uint16_t)
+POPTRIE_LOOKUP_FUNC(4b, uint32_t)
+POPTRIE_LOOKUP_FUNC(8b, uint64_t)
+
+void *
+poptrie_create(const char *name, int socket_id, struct rte_fib6_conf *conf);
+
+void
+poptrie_free(void *p);
+
+rte_fib6_lookup_fn_t
+poptrie_get_lookup_fn(void *p, enum rte_fib6_lookup_type type);
+
+int
+poptrie_modify(struct rte_fib6 *fib, const uint8_t ip[RTE_FIB6_IPV6_ADDR_SIZE],
+	uint8_t depth, uint64_t next_hop, int op);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _POPTRIE_H_ */
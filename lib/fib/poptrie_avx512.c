@@ -0,0 +1,183 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <rte_vect.h>
+#include <rte_fib6.h>
+
+#include "poptrie.h"
+#include "poptrie_avx512.h"
+
+static __rte_always_inline void
+transpose_x8(uint8_t ips[8][RTE_FIB6_IPV6_ADDR_SIZE],
+	__m512i *first, __m512i *second)
+{
+	__m512i tmp1, tmp2, tmp3, tmp4;
+	const __rte_x86_zmm_t perm_idxes = {
+		.u64 = { 0, 2, 4, 6, 1, 3, 5, 7
+		},
+	};
+
+	tmp1 = _mm512_loadu_si512(&ips[0][0]);
+	tmp2 = _mm512_loadu_si512(&ips[4][0]);
+
+	tmp3 = _mm512_unpacklo_epi64(tmp1, tmp2);
+	*first = _mm512_permutexvar_epi64(perm_idxes.z, tmp3);
+	tmp4 = _mm512_unpackhi_epi64(tmp1, tmp2);
+	*second = _mm512_permutexvar_epi64(perm_idxes.z, tmp4);
+}
+
+/* population count of each quad word, using AVX512BW only */
+static __rte_always_inline __m512i
+popcnt_x8(__m512i val)
+{
+	const __rte_x86_zmm_t lut = {
+		.u8 = { 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+			0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+			0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+			0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4
+		},
+	};
+	const __m512i nibble = _mm512_set1_epi32(0x0f0f0f0f);
+	__m512i lo, hi;
+
+	lo = _mm512_and_si512(val, nibble);
+	hi = _mm512_and_si512(_mm512_srli_epi64(val, 4), nibble);
+	lo = _mm512_add_epi8(_mm512_shuffle_epi8(lut.z, lo),
+		_mm512_shuffle_epi8(lut.z, hi));
+	return _mm512_sad_epu8(lo, _mm512_setzero_si512());
+}
+
+static __rte_always_inline void
+poptrie_vec_lookup_x8(void *p, uint8_t ips[8][RTE_FIB6_IPV6_ADDR_SIZE],
+	uint64_t *next_hops, int size)
+{
+	struct rte_poptrie_tbl *dp = (struct rte_poptrie_tbl *)p;
+	const uint64_t *nodes = (const uint64_t *)dp->nodes;
+	const __m512i zero = _mm512_set1_epi32(0);
+	const __m512i lsb = _mm512_set1_epi64(1);
+	const __m512i stride_msk = _mm512_set1_epi64(POPTRIE_NODE_NUM_ENT - 1);
+	const __m512i base0_msk = _mm512_set1_epi64(UINT32_MAX);
+	const __m512i res_msk = _mm512_set1_epi64(UINT64_MAX >>
+		(64 - size * 8));
+	const __rte_x86_zmm_t bswap = {
+		.u8 = { 7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+			7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+			7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+			7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8
+		},
+	};
+	/* IPv6 eight byte chunks, in host order */
+	__m512i first, second;
+	__m512i idxes, res, node, bits, bit, msk;
+	__m512i vector, leafvec, base, leaf;
+	__mmask8 msk_ext, msk_node, msk_leaf;
+	uint32_t off;
+
+	transpose_x8(ips, &first, &second);
+	first = _mm512_shuffle_epi8(first, bswap.z);
+	second = _mm512_shuffle_epi8(second, bswap.z);
+
+	/* lookup in the direct table */
+	idxes = _mm512_srli_epi64(first, 64 - POPTRIE_DIRECT_BITS);
+	res = _mm512_i64gather_epi64(idxes, (const void *)dp->direct, 8);
+	msk_ext = _mm512_test_epi64_mask(res, lsb);
+	res = _mm512_srli_epi64(res, 1);
+	node = res;
+
+	/* traverse down the internal nodes */
+	for (off = POPTRIE_DIRECT_BITS; msk_ext != 0; off += POPTRIE_STRIDE) {
+		if (off + POPTRIE_STRIDE <= 64)
+			bits = _mm512_srl_epi64(first,
+				_mm_cvtsi32_si128(64 - POPTRIE_STRIDE - off));
+		else if (off < 64)
+			bits = _mm512_or_si512(_mm512_sll_epi64(first,
+				_mm_cvtsi32_si128(off + POPTRIE_STRIDE - 64)),
+				_mm512_srl_epi64(second, _mm_cvtsi32_si128(
+				RTE_FIB6_MAXDEPTH - POPTRIE_STRIDE - off)));
+		else if (off + POPTRIE_STRIDE <= RTE_FIB6_MAXDEPTH)
+			bits = _mm512_srl_epi64(second, _mm_cvtsi32_si128(
+				RTE_FIB6_MAXDEPTH - POPTRIE_STRIDE - off));
+		else
+			bits = _mm512_sll_epi64(second, _mm_cvtsi32_si128(
+				off + POPTRIE_STRIDE - RTE_FIB6_MAXDEPTH));
+		bits = _mm512_and_si512(bits, stride_msk);
+		bit = _mm512_sllv_epi64(lsb, bits);
+		msk = _mm512_sub_epi64(_mm512_slli_epi64(bit, 1), lsb);
+
+		/* a node is three quad words */
+		idxes = _mm512_add_epi64(_mm512_slli_epi64(node, 1), node);
+		vector = _mm512_mask_i64gather_epi64(zero, msk_ext, idxes,
+			(const void *)nodes, 8);
+		base = _mm512_mask_i64gather_epi64(zero, msk_ext, idxes,
+			(const void *)(nodes + 2), 8);
+		msk_node = _mm512_mask_test_epi64_mask(msk_ext, vector, bit);
+		msk_leaf = msk_ext & ~msk_node;
+
+		if (msk_leaf != 0) {
+			leafvec = _mm512_mask_i64gather_epi64(zero, msk_leaf,
+				idxes, (const void *)(nodes + 1), 8);
+			idxes = popcnt_x8(_mm512_and_si512(leafvec, msk));
+			idxes = _mm512_add_epi64(idxes,
+				_mm512_and_si512(base, base0_msk));
+			idxes = _mm512_sub_epi64(idxes, lsb);
+			if (size == sizeof(uint16_t))
+				leaf = _mm512_mask_i64gather_epi64(zero,
+					msk_leaf, idxes, dp->leaves, 2);
+			else if (size == sizeof(uint32_t))
+				leaf = _mm512_mask_i64gather_epi64(zero,
+					msk_leaf, idxes, dp->leaves, 4);
+			else
+				leaf = _mm512_mask_i64gather_epi64(zero,
+					msk_leaf, idxes, dp->leaves, 8);
+			res = _mm512_mask_and_epi64(res, msk_leaf, leaf,
+				res_msk);
+		}
+
+		node = popcnt_x8(_mm512_and_si512(vector, msk));
+		node = _mm512_add_epi64(node, _mm512_srli_epi64(base, 32));
+		node = _mm512_sub_epi64(node, lsb);
+		msk_ext = msk_node;
+	}
+
+	_mm512_storeu_si512(next_hops, res);
+}
+
+void
+rte_poptrie_vec_lookup_bulk_2b(void *p, uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE],
+	uint64_t *next_hops, const unsigned int n)
+{
+	uint32_t i;
+	for (i = 0; i < (n / 8); i++) {
+		poptrie_vec_lookup_x8(p, (uint8_t (*)[16])&ips[i * 8][0],
+				next_hops + i * 8, sizeof(uint16_t));
+	}
+	rte_poptrie_lookup_bulk_2b(p, (uint8_t (*)[16])&ips[i * 8][0],
+			next_hops + i * 8, n - i * 8);
+}
+
+void
+rte_poptrie_vec_lookup_bulk_4b(void *p, uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE],
+	uint64_t *next_hops, const unsigned int n)
+{
+	uint32_t i;
+	for (i = 0; i < (n / 8); i++) {
+		poptrie_vec_lookup_x8(p, (uint8_t (*)[16])&ips[i * 8][0],
+				next_hops + i * 8, sizeof(uint32_t));
+	}
+	rte_poptrie_lookup_bulk_4b(p, (uint8_t (*)[16])&ips[i * 8][0],
+			next_hops + i * 8, n - i * 8);
+}
+
+void
+rte_poptrie_vec_lookup_bulk_8b(void *p, uint8_t ips[][RTE_FIB6_IPV6_ADDR_SIZE],
+	uint64_t *next_hops, const unsigned int n)
+{
+	uint32_t i;
+	for (i = 0; i < (n / 8); i++) {
+		poptrie_vec_lookup_x8(p, (uint8_t (*)[16])&ips[i * 8][0],
+				next_hops + i * 8, sizeof(uint64_t));
+	}
+	rte_poptrie_lookup_bulk_8b(p, (uint8_t (*)[16])&ips[i * 8][0],
+			next_hops + i * 8, n - i * 8);
+}
@@ -9,6 +9,7 @@
 #include <rte_eal.h>
 #include <rte_eal_memconfig.h>
 #include <rte_errno.h>
+#include <rte_lcore.h>
 #include <rte_malloc.h>
 #include <rte_rwlock.h>
 #include <rte_string_fns.h>
@@ -43,10 +44,21 @@ struct rte_fib {
 	struct rte_rib		*rib;	/**< RIB helper datastruct */
 	void			*dp;	/**< pointer to the dataplane struct*/
 	rte_fib_lookup_fn_t	lookup;	/**< fib lookup function */
+	/** fib lookup function resolving next hop groups */
+	rte_fib_lookup_hash_fn_t	lookup_hash;
 	rte_fib_modify_fn_t	modify; /**< modify fib datastruct */
 	uint64_t		def_nh;
 };
 
+struct rte_fib_numa {
+	/** Replica looked up by the lcores of each socket */
+	struct rte_fib		*local[RTE_MAX_NUMA_NODES];
+	/** Replica looked up by the threads with no socket */
+	struct rte_fib		*def;
+	uint32_t		n_replicas;
+	struct rte_fib		*replicas[RTE_MAX_NUMA_NODES];
+};
+
 static void
 dummy_lookup(void *fib_p, const uint32_t *ips, uint64_t *next_hops,
 	const unsigned int n)
@@ -109,6 +121,8 @@ init_dataplane(struct rte_fib *fib, __rte_unused int socket_id,
 			return -rte_errno;
 		fib->lookup = dir24_8_get_lookup_fn(fib->dp,
 			RTE_FIB_LOOKUP_DEFAULT);
+		fib->lookup_hash = dir24_8_get_lookup_hash_fn(fib->dp,
+			RTE_FIB_LOOKUP_DEFAULT);
 		fib->modify = dir24_8_modify;
 		return 0;
 	default:
@@ -126,6 +140,31 @@ rte_fib_add(struct rte_fib *fib, uint32_t ip, uint8_t depth, uint64_t next_hop)
 	return fib->modify(fib, ip, depth, next_hop, RTE_FIB_ADD);
 }
 
+int
+rte_fib_add_bulk(struct rte_fib *fib, const uint32_t *ips,
+	const uint8_t *depths, const uint64_t *next_hops, unsigned int n)
+{
+	unsigned int i;
+	int ret;
+
+	if ((fib == NULL) || (fib->modify == NULL) || (ips == NULL) ||
+			(depths == NULL) || (next_hops == NULL))
+		return -EINVAL;
+
+	if (fib->type == RTE_FIB_DIR24_8)
+		return dir24_8_add_bulk(fib, ips, depths, next_hops, n);
+
+	for (i = 0; i != n; i++) {
+		if (depths[i] > RTE_FIB_MAXDEPTH)
+			return -EINVAL;
+		ret = fib->modify(fib, ips[i], depths[i], next_hops[i],
+			RTE_FIB_ADD);
+		if (ret != 0)
+			return ret;
+	}
+	return 0;
+}
+
 int
 rte_fib_delete(struct rte_fib *fib, uint32_t ip, uint8_t depth)
 {
@@ -146,6 +185,22 @@ rte_fib_lookup_bulk(struct rte_fib *fib, uint32_t *ips,
 	return 0;
 }
 
+int
+rte_fib_lookup_bulk_hash(struct rte_fib *fib, uint32_t *ips,
+	const uint32_t *hashes, uint64_t *next_hops, int n)
+{
+	FIB_RETURN_IF_TRUE(((fib == NULL) || (ips == NULL) ||
+		(hashes == NULL) || (next_hops == NULL) ||
+		(fib->lookup == NULL)), -EINVAL);
+
+	/* No next hop groups without a dataplane resolving them */
+	if (fib->lookup_hash == NULL)
+		fib->lookup(fib->dp, ips, next_hops, n);
+	else
+		fib->lookup_hash(fib->dp, ips, hashes, next_hops, n);
+	return 0;
+}
+
 struct rte_fib *
 rte_fib_create(const char *name, int socket_id, struct rte_fib_conf *conf)
 {
@@ -319,20 +374,265 @@ rte_fib_get_rib(struct rte_fib *fib)
 	return (fib == NULL) ? NULL : fib->rib;
 }
 
+int
+rte_fib_rcu_qsbr_add(struct rte_fib *fib, struct rte_fib_rcu_config *cfg)
+{
+	if (fib == NULL || cfg == NULL)
+		return -EINVAL;
+
+	switch (fib->type) {
+	case RTE_FIB_DIR24_8:
+		return dir24_8_rcu_qsbr_add(fib->dp, cfg, fib->name);
+	default:
+		return -ENOTSUP;
+	}
+}
+
+int
+rte_fib_nh_group_create(struct rte_fib *fib,
+	const struct rte_fib_nh_group_conf *conf)
+{
+	if (fib == NULL || conf == NULL)
+		return -EINVAL;
+
+	switch (fib->type) {
+	case RTE_FIB_DIR24_8:
+		return dir24_8_nh_group_create(fib, conf);
+	default:
+		return -ENOTSUP;
+	}
+}
+
+int
+rte_fib_nh_group_set(struct rte_fib *fib, uint32_t grp,
+	const uint64_t *next_hops, const uint32_t *weights, unsigned int n)
+{
+	if (fib == NULL)
+		return -EINVAL;
+
+	switch (fib->type) {
+	case RTE_FIB_DIR24_8:
+		return dir24_8_nh_group_set(fib->dp, grp, next_hops,
+			weights, n);
+	default:
+		return -ENOTSUP;
+	}
+}
+
 int
 rte_fib_select_lookup(struct rte_fib *fib,
 	enum rte_fib_lookup_type type)
 {
 	rte_fib_lookup_fn_t fn;
+	rte_fib_lookup_hash_fn_t hash_fn;
 
 	switch (fib->type) {
 	case RTE_FIB_DIR24_8:
 		fn = dir24_8_get_lookup_fn(fib->dp, type);
-		if (fn == NULL)
+		hash_fn = dir24_8_get_lookup_hash_fn(fib->dp, type);
+		if ((fn == NULL) || (hash_fn == NULL))
 			return -EINVAL;
 		fib->lookup = fn;
+		fib->lookup_hash = hash_fn;
 		return 0;
 	default:
 		return -EINVAL;
 	}
 }
+
+static inline struct rte_fib *
+fib_numa_local(const struct rte_fib_numa *fn)
+{
+	unsigned int socket_id = rte_socket_id();
+
+	if (unlikely(socket_id >= RTE_MAX_NUMA_NODES))
+		return fn->def;
+	return fn->local[socket_id];
+}
+
+struct rte_fib_numa *
+rte_fib_numa_create(const char *name, struct rte_fib_conf *conf)
+{
+	char replica_name[RTE_FIB_NAMESIZE];
+	struct rte_fib_numa *fn;
+	struct rte_fib *fib;
+	unsigned int lcore_id, socket_id;
+	uint32_t i;
+
+	if ((name == NULL) || (conf == NULL)) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	fn = rte_zmalloc("FIB_NUMA", sizeof(*fn), RTE_CACHE_LINE_SIZE);
+	if (fn == NULL) {
+		rte_errno = ENOMEM;
+		return NULL;
+	}
+
+	RTE_LCORE_FOREACH(lcore_id) {
+		socket_id = rte_lcore_to_socket_id(lcore_id);
+		if ((socket_id >= RTE_MAX_NUMA_NODES) ||
+				(fn->local[socket_id] != NULL))
+			continue;
+
+		if (snprintf(replica_name, sizeof(replica_name), "%s_%u",
+				name, socket_id) >= (int)sizeof(replica_name)) {
+			rte_errno = ENAMETOOLONG;
+			goto error;
+		}
+		fib = rte_fib_create(replica_name, socket_id, conf);
+		if (fib == NULL)
+			goto error;
+
+		fn->local[socket_id] = fib;
+		fn->replicas[fn->n_replicas++] = fib;
+	}
+
+	if (fn->n_replicas == 0) {
+		rte_errno = ENODEV;
+		goto error;
+	}
+
+	socket_id = rte_lcore_to_socket_id(rte_get_main_lcore());
+	fn->def = (socket_id < RTE_MAX_NUMA_NODES) ?
+		fn->local[socket_id] : NULL;
+	if (fn->def == NULL)
+		fn->def = fn->replicas[0];
+
+	/* The sockets with no lcore share the default replica */
+	for (socket_id = 0; socket_id != RTE_MAX_NUMA_NODES; socket_id++)
+		if (fn->local[socket_id] == NULL)
+			fn->local[socket_id] = fn->def;
+
+	return fn;
+
+error:
+	for (i = 0; i != fn->n_replicas; i++)
+		rte_fib_free(fn->replicas[i]);
+	rte_free(fn);
+	return NULL;
+}
+
+void
+rte_fib_numa_free(struct rte_fib_numa *fn)
+{
+	uint32_t i;
+
+	if (fn == NULL)
+		return;
+
+	for (i = 0; i != fn->n_replicas; i++)
+		rte_fib_free(fn->replicas[i]);
+	rte_free(fn);
+}
+
+/*
+ * Apply a route update to all the replicas. On failure, the route state
+ * before the update, read from the first replica, is restored in the
+ * replicas already updated.
+ */
+static int
+fib_numa_modify(struct rte_fib_numa *fn, uint32_t ip, uint8_t depth,
+	uint64_t next_hop, enum rte_fib_op op)
+{
+	struct rte_rib_node *node;
+	uint64_t prev_nh = 0;
+	uint32_t i, j;
+	int ret;
+
+	if ((fn == NULL) || (depth > RTE_FIB_MAXDEPTH))
+		return -EINVAL;
+
+	node = rte_rib_lookup_exact(fn->replicas[0]->rib, ip, depth);
+	if (node != NULL)
+		rte_rib_get_nh(node, &prev_nh);
+
+	for (i = 0; i != fn->n_replicas; i++) {
+		ret = (op == RTE_FIB_ADD) ?
+			rte_fib_add(fn->replicas[i], ip, depth, next_hop) :
+			rte_fib_delete(fn->replicas[i], ip, depth);
+		if (ret == 0)
+			continue;
+
+		for (j = 0; j != i; j++) {
+			if (node != NULL)
+				rte_fib_add(fn->replicas[j], ip, depth,
+					prev_nh);
+			else
+				rte_fib_delete(fn->replicas[j], ip, depth);
+		}
+		return ret;
+	}
+	return 0;
+}
+
+int
+rte_fib_numa_add(struct rte_fib_numa *fn, uint32_t ip, uint8_t depth,
+	uint64_t next_hop)
+{
+	return fib_numa_modify(fn, ip, depth, next_hop, RTE_FIB_ADD);
+}
+
+int
+rte_fib_numa_delete(struct rte_fib_numa *fn, uint32_t ip, uint8_t depth)
+{
+	return fib_numa_modify(fn, ip, depth, 0, RTE_FIB_DEL);
+}
+
+int
+rte_fib_numa_lookup_bulk(struct rte_fib_numa *fn, uint32_t *ips,
+	uint64_t *next_hops, int n)
+{
+	FIB_RETURN_IF_TRUE(fn == NULL, -EINVAL);
+
+	return rte_fib_lookup_bulk(fib_numa_local(fn), ips, next_hops, n);
+}
+
+struct rte_fib *
+rte_fib_numa_get(struct rte_fib_numa *fn, int socket_id)
+{
+	if (fn == NULL)
+		return NULL;
+	if (socket_id == SOCKET_ID_ANY)
+		return fib_numa_local(fn);
+	if ((socket_id < 0) || (socket_id >= RTE_MAX_NUMA_NODES))
+		return NULL;
+	return fn->local[socket_id];
+}
+
+int
+rte_fib_numa_select_lookup(struct rte_fib_numa *fn,
+	enum rte_fib_lookup_type type)
+{
+	uint32_t i;
+	int ret;
+
+	if (fn == NULL)
+		return -EINVAL;
+
+	for (i = 0; i != fn->n_replicas; i++) {
+		ret = rte_fib_select_lookup(fn->replicas[i], type);
+		if (ret != 0)
+			return ret;
+	}
+	return 0;
+}
+
+int
+rte_fib_numa_rcu_qsbr_add(struct rte_fib_numa *fn,
+	struct rte_fib_rcu_config *cfg)
+{
+	uint32_t i;
+	int ret;
+
+	if (fn == NULL)
+		return -EINVAL;
+
+	for (i = 0; i != fn->n_replicas; i++) {
+		ret = rte_fib_rcu_qsbr_add(fn->replicas[i], cfg);
+		if (ret != 0)
+			return ret;
+	}
+	return 0;
+}
@@ -22,17 +22,22 @@
 #include <stdint.h>
 
 #include <rte_compat.h>
+#include <rte_rcu_qsbr.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 struct rte_fib;
+struct rte_fib_numa;
 struct rte_rib;
 
 /** Maximum depth value possible for IPv4 FIB. */
 #define RTE_FIB_MAXDEPTH	32
 
+/** @internal Default RCU defer queue entries to reclaim in one go. */
+#define RTE_FIB_RCU_DQ_RECLAIM_MAX	16
+
 /** Type of FIB struct */
 enum rte_fib_type {
 	RTE_FIB_DUMMY,		/**< RIB tree based FIB */
@@ -45,6 +50,9 @@ typedef int (*rte_fib_modify_fn_t)(struct rte_fib *fib, uint32_t ip,
 /** FIB bulk lookup function */
 typedef void (*rte_fib_lookup_fn_t)(void *fib, const uint32_t *ips,
 	uint64_t *next_hops, const unsigned int n);
+/** FIB bulk lookup function selecting the next hops of groups by hash */
+typedef void (*rte_fib_lookup_hash_fn_t)(void *fib, const uint32_t *ips,
+	const uint32_t *hashes, uint64_t *next_hops, const unsigned int n);
 
 enum rte_fib_op {
 	RTE_FIB_ADD,
@@ -59,6 +67,14 @@ enum rte_fib_dir24_8_nh_sz {
 	RTE_FIB_DIR24_8_8B
 };
 
+/**
+ * Next hop of the routes using the next hop group grp,
+ * in a DIR24_8 based FIB with next hops of size nh_sz:
+ * the highest bit of the next hop values is the group flag.
+ */
+#define RTE_FIB_DIR24_8_NH_GROUP(nh_sz, grp)	\
+	((1ULL << ((8 << (nh_sz)) - 2)) | (grp))
+
 /** Type of lookup function implementation */
 enum rte_fib_lookup_type {
 	RTE_FIB_LOOKUP_DEFAULT,
@@ -78,6 +94,14 @@ enum rte_fib_lookup_type {
 	/**< Vector implementation using AVX512 */
 };
 
+/** RCU reclamation modes */
+enum rte_fib_qsbr_mode {
+	/** Create defer queue for reclaim. */
+	RTE_FIB_QSBR_MODE_DQ = 0,
+	/** Use blocking mode reclaim. No defer queue created. */
+	RTE_FIB_QSBR_MODE_SYNC
+};
+
 /** FIB configuration structure */
 struct rte_fib_conf {
 	enum rte_fib_type type; /**< Type of FIB struct */
@@ -92,6 +116,33 @@ struct rte_fib_conf {
 	};
 };
 
+/** FIB next hop groups configuration structure. */
+struct rte_fib_nh_group_conf {
+	uint32_t num_groups;	/**< Number of next hop groups */
+	/**
+	 * Number of hash buckets of each group, power of 2, no less
+	 * than its number of next hops. The larger, the closer the share
+	 * of each next hop is to its weight.
+	 */
+	uint32_t num_buckets;
+};
+
+/** FIB RCU QSBR configuration structure. */
+struct rte_fib_rcu_config {
+	struct rte_rcu_qsbr *v;	/* RCU QSBR variable. */
+	/* Mode of RCU QSBR. RTE_FIB_QSBR_MODE_xxx
+	 * '0' for default: create defer queue for reclaim.
+	 */
+	enum rte_fib_qsbr_mode mode;
+	uint32_t dq_size;	/* RCU defer queue size.
+				 * default: number of tbl8s.
+				 */
+	uint32_t reclaim_thd;	/* Threshold to trigger auto reclaim. */
+	uint32_t reclaim_max;	/* Max entries to reclaim in one go.
+				 * default: RTE_FIB_RCU_DQ_RECLAIM_MAX.
+				 */
+};
+
 /**
  * Create FIB
  *
@@ -153,6 +204,36 @@ __rte_experimental
 int
 rte_fib_add(struct rte_fib *fib, uint32_t ip, uint8_t depth, uint64_t next_hop);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Add a set of routes to the FIB.
+ * The routes are first inserted in the RIB, so that the dataplane is then
+ * written once per route for the ranges it is the most specific route of,
+ * instead of being rewritten by each more specific route on the way.
+ * This is much faster than adding the routes one by one when loading
+ * a full table.
+ *
+ * @param fib
+ *   FIB object handle
+ * @param ips
+ *   Array of *n* IPv4 prefix addresses to be added to the FIB
+ * @param depths
+ *   Array of *n* prefix lengths
+ * @param next_hops
+ *   Array of *n* next hops to be added to the FIB
+ * @param n
+ *   Number of routes
+ * @return
+ *   0 on success, negative value otherwise.
+ *   On error, a DIR24_8 based FIB is left as it was before the call.
+ */
+__rte_experimental
+int
+rte_fib_add_bulk(struct rte_fib *fib, const uint32_t *ips,
+	const uint8_t *depths, const uint64_t *next_hops, unsigned int n);
+
 /**
  * Delete a rule from the FIB.
  *
@@ -190,6 +271,37 @@ __rte_experimental
 int
 rte_fib_lookup_bulk(struct rte_fib *fib, uint32_t *ips,
 		uint64_t *next_hops, int n);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Lookup multiple IP addresses in the FIB, selecting the next hops of the
+ * routes using next hop groups with a hash of the packets, usually
+ * their RSS hash. The packets of a flow thus keep the same next hop.
+ * rte_fib_lookup_bulk() returns the group next hop value of such routes.
+ *
+ * @param fib
+ *   FIB object handle
+ * @param ips
+ *   Array of IPs to be looked up in the FIB
+ * @param hashes
+ *   Array of the hashes of the packets
+ * @param next_hops
+ *   Next hop of the most specific rule found for IP, or the next hop
+ *   of its group selected by the hash.
+ *   This is an array of eight byte values.
+ *   If the lookup for the given IP failed, then corresponding element would
+ *   contain default nexthop value configured for a FIB.
+ * @param n
+ *   Number of elements in ips (and hashes, next_hops) array to lookup.
+ *  @return
+ *   -EINVAL for incorrect arguments, otherwise 0
+ */
+__rte_experimental
+int
+rte_fib_lookup_bulk_hash(struct rte_fib *fib, uint32_t *ips,
+		const uint32_t *hashes, uint64_t *next_hops, int n);
 /**
  * Get pointer to the dataplane specific struct
  *
@@ -232,6 +344,255 @@ __rte_experimental
 int
 rte_fib_select_lookup(struct rte_fib *fib, enum rte_fib_lookup_type type);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Associate RCU QSBR variable with a FIB object, so that the tbl8 groups
+ * freed by the route updates are reused only once the readers registered
+ * on the QSBR variable are done with them.
+ * Only DIR24_8 based FIBs support it.
+ *
+ * @param fib
+ *   FIB object handle
+ * @param cfg
+ *   RCU QSBR configuration
+ * @return
+ *   0 on success
+ *   -EINVAL on invalid parameters
+ *   -EEXIST if a QSBR variable is already associated
+ *   -ENOTSUP if the FIB type does not support it
+ *   other negative values on defer queue creation failure
+ */
+__rte_experimental
+int
+rte_fib_rcu_qsbr_add(struct rte_fib *fib, struct rte_fib_rcu_config *cfg);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Create the next hop groups of a FIB, for ECMP or weighted multipath
+ * routes. A route uses group grp with the next hop value
+ * RTE_FIB_DIR24_8_NH_GROUP(nh_sz, grp), and rte_fib_lookup_bulk_hash()
+ * then selects one of the next hops of the group by hash.
+ * Only DIR24_8 based FIBs support it.
+ *
+ * @param fib
+ *   FIB object handle
+ * @param conf
+ *   Next hop groups configuration
+ * @return
+ *   0 on success
+ *   -EINVAL on invalid parameters, or if routes already use group next
+ *    hop values out of the groups
+ *   -EEXIST if the groups are already created
+ *   -ENOTSUP if the FIB type does not support it
+ *   -ENOMEM if there is not enough memory
+ */
+__rte_experimental
+int
+rte_fib_nh_group_create(struct rte_fib *fib,
+	const struct rte_fib_nh_group_conf *conf);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Set the next hops of a next hop group. Each next hop gets a share of
+ * the hash buckets of the group proportional to its weight.
+ * The buckets are updated in place: a concurrent lookup gets either
+ * the old or the new next hop of the bucket of a packet.
+ *
+ * @param fib
+ *   FIB object handle
+ * @param grp
+ *   Next hop group
+ * @param next_hops
+ *   Next hops of the group, not group next hop values
+ * @param weights
+ *   Weights of the next hops, or NULL for equal cost multipath.
+ *   Their sum must fit in 32 bits.
+ * @param n
+ *   Number of next hops, up to the number of buckets of a group
+ * @return
+ *   0 on success
+ *   -EINVAL on invalid parameters
+ *   -ENOTSUP if the FIB has no next hop groups
+ */
+__rte_experimental
+int
+rte_fib_nh_group_set(struct rte_fib *fib, uint32_t grp,
+	const uint64_t *next_hops, const uint32_t *weights, unsigned int n);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Create a FIB replicated on each NUMA socket having enabled lcores.
+ * Each replica is a FIB allocated on its socket, named after *name* and
+ * the socket ID, so that the lookups of an lcore only read the memory of
+ * its own socket. The threads with no socket use the replica of the main
+ * lcore socket.
+ *
+ * The routes have to be updated through the rte_fib_numa_*() functions,
+ * which apply the update to all the replicas one after the other: for the
+ * time of an update, lcores of different sockets may get different next hops.
+ *
+ * @param name
+ *   FIB name prefix
+ * @param conf
+ *   Structure containing the configuration of each replica
+ * @return
+ *   Handle to the replicated FIB on success
+ *   NULL otherwise with rte_errno set to an appropriate value.
+ */
+__rte_experimental
+struct rte_fib_numa *
+rte_fib_numa_create(const char *name, struct rte_fib_conf *conf);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Free a replicated FIB and all its replicas.
+ *
+ * @param fn
+ *   Replicated FIB handle, can be NULL
+ */
+__rte_experimental
+void
+rte_fib_numa_free(struct rte_fib_numa *fn);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Add a route to all the replicas of a replicated FIB.
+ * If a replica fails to add it, the replicas already updated get back
+ * their previous route.
+ *
+ * @param fn
+ *   Replicated FIB handle
+ * @param ip
+ *   Prefix address
+ * @param depth
+ *   Prefix length
+ * @param next_hop
+ *   Next hop
+ * @return
+ *   0 on success, negative value otherwise
+ */
+__rte_experimental
+int
+rte_fib_numa_add(struct rte_fib_numa *fn, uint32_t ip, uint8_t depth,
+	uint64_t next_hop);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Delete a route from all the replicas of a replicated FIB.
+ * If a replica fails to delete it, the route is restored in the replicas
+ * already updated.
+ *
+ * @param fn
+ *   Replicated FIB handle
+ * @param ip
+ *   Prefix address
+ * @param depth
+ *   Prefix length
+ * @return
+ *   0 on success, negative value otherwise
+ */
+__rte_experimental
+int
+rte_fib_numa_delete(struct rte_fib_numa *fn, uint32_t ip, uint8_t depth);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Lookup multiple IP addresses in the replica of the socket of the calling
+ * lcore.
+ *
+ * @param fn
+ *   Replicated FIB handle
+ * @param ips
+ *   Array of IPs to be looked up in the FIB
+ * @param next_hops
+ *   Next hop of the most specific rule found for IP.
+ *   This is an array of eight byte values.
+ *   If the lookup for the given IP failed, then corresponding element would
+ *   contain default nexthop value configured for a FIB.
+ * @param n
+ *   Number of elements in ips (and next_hops) array to lookup.
+ *  @return
+ *   -EINVAL for incorrect arguments, otherwise 0
+ */
+__rte_experimental
+int
+rte_fib_numa_lookup_bulk(struct rte_fib_numa *fn, uint32_t *ips,
+	uint64_t *next_hops, int n);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Get the replica looked up by the lcores of a socket, e.g. to read its
+ * RIB. Its routes must not be updated directly.
+ *
+ * @param fn
+ *   Replicated FIB handle
+ * @param socket_id
+ *   Socket ID, SOCKET_ID_ANY for the socket of the calling lcore
+ * @return
+ *   FIB handle, NULL on invalid parameters
+ */
+__rte_experimental
+struct rte_fib *
+rte_fib_numa_get(struct rte_fib_numa *fn, int socket_id);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Set the lookup function of all the replicas of a replicated FIB.
+ *
+ * @param fn
+ *   Replicated FIB handle
+ * @param type
+ *   Type of lookup function
+ * @return
+ *   0 on success
+ *   -EINVAL on failure
+ */
+__rte_experimental
+int
+rte_fib_numa_select_lookup(struct rte_fib_numa *fn,
+	enum rte_fib_lookup_type type);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Associate RCU QSBR variable with all the replicas of a replicated FIB,
+ * see rte_fib_rcu_qsbr_add(). Each replica gets its own defer queue.
+ *
+ * @param fn
+ *   Replicated FIB handle
+ * @param cfg
+ *   RCU QSBR configuration
+ * @return
+ *   0 on success
+ *   negative value on failure, as returned by rte_fib_rcu_qsbr_add(),
+ *   the replicas before the failing one keep the QSBR variable
+ */
+__rte_experimental
+int
+rte_fib_numa_rcu_qsbr_add(struct rte_fib_numa *fn,
+	struct rte_fib_rcu_config *cfg);
+
 #ifdef __cplusplus
 }
 #endif
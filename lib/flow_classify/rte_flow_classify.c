@@ -50,6 +50,7 @@ struct rte_flow_classifier {
 	uint32_t num_tables;
 
 	uint16_t nb_pkts;
+	uint64_t lookup_hit_mask;
 	struct rte_flow_classify_table_entry
 		*entries[RTE_PORT_IN_BURST_SIZE_MAX];
 } __rte_cache_aligned;
@@ -68,10 +69,39 @@ struct acl_keys {
 	struct rte_table_acl_rule_delete_params	key_del; /* delete key */
 };
 
+/* IPv4 5-tuple hash key, laid out as the packet from the TTL field */
+struct hash_ipv4_5tuple_key {
+	uint8_t time_to_live; /* masked */
+	uint8_t proto;
+	rte_be16_t hdr_checksum; /* masked */
+	rte_be32_t src_ip;
+	rte_be32_t dst_ip;
+	rte_be16_t src_port;
+	rte_be16_t dst_port;
+} __rte_packed;
+
+/* IPv6 5-tuple hash key, laid out as the packet from the proto field */
+struct hash_ipv6_5tuple_key {
+	uint8_t proto;
+	uint8_t hop_limits; /* masked */
+	uint8_t src_ip[16];
+	uint8_t dst_ip[16];
+	rte_be16_t src_port;
+	rte_be16_t dst_port;
+	uint8_t pad[26]; /* masked */
+} __rte_packed;
+
+union hash_keys {
+	struct hash_ipv4_5tuple_key ipv4;
+	struct hash_ipv6_5tuple_key ipv6;
+	uint64_t align;
+};
+
 struct classify_rules {
 	enum rte_flow_classify_rule_type type;
 	union {
 		struct rte_flow_classify_ipv4_5tuple ipv4_5tuple;
+		struct rte_flow_classify_ipv6_5tuple ipv6_5tuple;
 	} u;
 };
 
@@ -81,6 +111,7 @@ struct rte_flow_classify_rule {
 	struct classify_rules rules; /* union of rules */
 	union {
 		struct acl_keys key;
+		union hash_keys hash; /* add and delete key */
 	} u;
 	int key_found;   /* rule key found in table */
 	struct rte_flow_classify_table_entry entry;  /* rule meta data */
@@ -370,11 +401,66 @@ rte_table_check_params(struct rte_flow_classifier *cls,
 	return 0;
 }
 
+static inline bool
+classify_table_is_hash(enum rte_flow_classify_table_type type)
+{
+	return type == RTE_FLOW_CLASSIFY_TABLE_HASH_IP4_5TUPLE ||
+		type == RTE_FLOW_CLASSIFY_TABLE_HASH_IP6_5TUPLE;
+}
+
+/* Set the key of the exact match table from the application parameters */
+static int
+classify_hash_params_init(struct rte_table_hash_params *hash_params,
+		union hash_keys *key_mask,
+		const struct rte_flow_classify_table_params *params)
+{
+	if (params->arg_create == NULL) {
+		RTE_FLOW_CLASSIFY_LOG(ERR, "%s: params->arg_create is NULL\n",
+			__func__);
+		return -EINVAL;
+	}
+
+	*hash_params = *(struct rte_table_hash_params *)params->arg_create;
+	memset(key_mask, 0, sizeof(*key_mask));
+	hash_params->key_mask = (uint8_t *)key_mask;
+
+	if (params->type == RTE_FLOW_CLASSIFY_TABLE_HASH_IP4_5TUPLE) {
+		key_mask->ipv4.proto = UINT8_MAX;
+		key_mask->ipv4.src_ip = UINT32_MAX;
+		key_mask->ipv4.dst_ip = UINT32_MAX;
+		key_mask->ipv4.src_port = UINT16_MAX;
+		key_mask->ipv4.dst_port = UINT16_MAX;
+		hash_params->key_size =
+			RTE_FLOW_CLASSIFY_HASH_IP4_5TUPLE_KEY_SIZE;
+		if (hash_params->key_offset == 0)
+			hash_params->key_offset =
+				RTE_FLOW_CLASSIFY_HASH_IP4_5TUPLE_KEY_OFFSET;
+	} else {
+		key_mask->ipv6.proto = UINT8_MAX;
+		memset(key_mask->ipv6.src_ip, UINT8_MAX,
+			sizeof(key_mask->ipv6.src_ip));
+		memset(key_mask->ipv6.dst_ip, UINT8_MAX,
+			sizeof(key_mask->ipv6.dst_ip));
+		key_mask->ipv6.src_port = UINT16_MAX;
+		key_mask->ipv6.dst_port = UINT16_MAX;
+		hash_params->key_size =
+			RTE_FLOW_CLASSIFY_HASH_IP6_5TUPLE_KEY_SIZE;
+		if (hash_params->key_offset == 0)
+			hash_params->key_offset =
+				RTE_FLOW_CLASSIFY_HASH_IP6_5TUPLE_KEY_OFFSET;
+	}
+
+	return 0;
+}
+
 int
 rte_flow_classify_table_create(struct rte_flow_classifier *cls,
 	struct rte_flow_classify_table_params *params)
 {
+	struct rte_table_hash_params hash_params;
+	union hash_keys key_mask;
 	struct rte_cls_table *table;
+	void *arg_create;
 	void *h_table;
 	uint32_t entry_size;
 	int ret;
@@ -387,8 +473,18 @@ rte_flow_classify_table_create(struct rte_flow_classifier *cls,
 	/* calculate table entry size */
 	entry_size = sizeof(struct rte_flow_classify_table_entry);
 
+	/* the library builds the exact match keys, so it defines them */
+	arg_create = params->arg_create;
+	if (classify_table_is_hash(params->type)) {
+		ret = classify_hash_params_init(&hash_params, &key_mask,
+				params);
+		if (ret != 0)
+			return ret;
+		arg_create = &hash_params;
+	}
+
 	/* Create the table */
-	h_table = params->ops->f_create(params->arg_create, cls->socket_id,
+	h_table = params->ops->f_create(arg_create, cls->socket_id,
 		entry_size);
 	if (h_table == NULL) {
 		RTE_FLOW_CLASSIFY_LOG(ERR, "%s: Table creation failed\n",
@@ -477,6 +573,112 @@ allocate_acl_ipv4_5tuple_rule(struct rte_flow_classifier *cls)
 	return rule;
 }
 
+static struct rte_flow_classify_rule *
+allocate_hash_ipv4_5tuple_rule(struct rte_flow_classifier *cls)
+{
+	struct rte_eth_ntuple_filter *filter = &cls->ntuple_filter;
+	struct rte_flow_classify_ipv4_5tuple *tuple;
+	struct hash_ipv4_5tuple_key *key;
+	struct rte_flow_classify_rule *rule;
+
+	rule = calloc(1, sizeof(struct rte_flow_classify_rule));
+	if (!rule)
+		return rule;
+
+	rule->id = unique_id++;
+	rule->rules.type = RTE_FLOW_CLASSIFY_RULE_TYPE_IPV4_5TUPLE;
+
+	tuple = &rule->rules.u.ipv4_5tuple;
+	tuple->proto = filter->proto;
+	tuple->proto_mask = filter->proto_mask;
+	tuple->src_ip = filter->src_ip;
+	tuple->src_ip_mask = filter->src_ip_mask;
+	tuple->dst_ip = filter->dst_ip;
+	tuple->dst_ip_mask = filter->dst_ip_mask;
+	tuple->src_port = filter->src_port;
+	tuple->src_port_mask = filter->src_port_mask;
+	tuple->dst_port = filter->dst_port;
+	tuple->dst_port_mask = filter->dst_port_mask;
+
+	/* key add and delete values */
+	key = &rule->u.hash.ipv4;
+	key->proto = filter->proto;
+	key->src_ip = filter->src_ip;
+	key->dst_ip = filter->dst_ip;
+	key->src_port = filter->src_port;
+	key->dst_port = filter->dst_port;
+
+	return rule;
+}
+
+static struct rte_flow_classify_rule *
+allocate_hash_ipv6_5tuple_rule(void)
+{
+	struct rte_flow_classify_ipv6_5tuple *tuple =
+		classify_get_ipv6_5tuple();
+	struct hash_ipv6_5tuple_key *key;
+	struct rte_flow_classify_rule *rule;
+
+	rule = calloc(1, sizeof(struct rte_flow_classify_rule));
+	if (!rule)
+		return rule;
+
+	rule->id = unique_id++;
+	rule->rules.type = RTE_FLOW_CLASSIFY_RULE_TYPE_IPV6_5TUPLE;
+	rule->rules.u.ipv6_5tuple = *tuple;
+
+	/* key add and delete values */
+	key = &rule->u.hash.ipv6;
+	key->proto = tuple->proto;
+	memcpy(key->src_ip, tuple->src_ip, sizeof(key->src_ip));
+	memcpy(key->dst_ip, tuple->dst_ip, sizeof(key->dst_ip));
+	key->src_port = tuple->src_port;
+	key->dst_port = tuple->dst_port;
+
+	return rule;
+}
+
+/* Check the n-tuple filter has no wildcard */
+static bool
+ntuple_filter_is_exact(const struct rte_eth_ntuple_filter *filter)
+{
+	return filter->proto_mask == UINT8_MAX &&
+		filter->src_ip_mask == UINT32_MAX &&
+		filter->dst_ip_mask == UINT32_MAX &&
+		filter->src_port_mask == UINT16_MAX &&
+		filter->dst_port_mask == UINT16_MAX &&
+		!(filter->flags & RTE_NTUPLE_FLAGS_TCP_FLAG);
+}
+
+static struct rte_cls_table *
+classify_table_find(struct rte_flow_classifier *cls,
+		enum rte_flow_classify_table_type type)
+{
+	uint32_t i;
+
+	for (i = 0; i < cls->num_tables; i++)
+		if (cls->tables[i].type == type)
+			return &cls->tables[i];
+
+	return NULL;
+}
+
+static inline void *
+classify_rule_key_add(struct rte_flow_classify_rule *rule)
+{
+	if (classify_table_is_hash(rule->tbl_type))
+		return &rule->u.hash;
+	return &rule->u.key.key_add;
+}
+
+static inline void *
+classify_rule_key_del(struct rte_flow_classify_rule *rule)
+{
+	if (classify_table_is_hash(rule->tbl_type))
+		return &rule->u.hash;
+	return &rule->u.key.key_del;
+}
+
 struct rte_flow_classify_rule *
 rte_flow_classify_table_entry_add(struct rte_flow_classifier *cls,
 		const struct rte_flow_attr *attr,
@@ -487,6 +689,7 @@ rte_flow_classify_table_entry_add(struct rte_flow_classifier *cls,
 {
 	struct rte_flow_classify_rule *rule;
 	struct rte_flow_classify_table_entry *table_entry;
+	enum rte_flow_classify_table_type tbl_type;
 	struct classify_action *action;
 	uint32_t i;
 	int ret;
@@ -508,15 +711,28 @@ rte_flow_classify_table_entry_add(struct rte_flow_classifier *cls,
 
 	switch (table_type) {
 	case RTE_FLOW_CLASSIFY_TABLE_ACL_IP4_5TUPLE:
-		rule = allocate_acl_ipv4_5tuple_rule(cls);
-		if (!rule)
-			return NULL;
-		rule->tbl_type = table_type;
-		cls->table_mask |= table_type;
+		/* wildcard-free rules go to the exact match table if any */
+		if (ntuple_filter_is_exact(&cls->ntuple_filter) &&
+		    classify_table_find(cls,
+				RTE_FLOW_CLASSIFY_TABLE_HASH_IP4_5TUPLE)) {
+			rule = allocate_hash_ipv4_5tuple_rule(cls);
+			tbl_type = RTE_FLOW_CLASSIFY_TABLE_HASH_IP4_5TUPLE;
+		} else {
+			rule = allocate_acl_ipv4_5tuple_rule(cls);
+			tbl_type = table_type;
+		}
+		break;
+	case RTE_FLOW_CLASSIFY_TABLE_HASH_IP6_5TUPLE:
+		rule = allocate_hash_ipv6_5tuple_rule();
+		tbl_type = table_type;
 		break;
 	default:
 		return NULL;
 	}
+	if (!rule)
+		return NULL;
+	rule->tbl_type = tbl_type;
+	cls->table_mask |= tbl_type;
 
 	action = classify_get_flow_action();
 	table_entry = &rule->entry;
@@ -536,11 +752,11 @@ rte_flow_classify_table_entry_add(struct rte_flow_classifier *cls,
 	for (i = 0; i < cls->num_tables; i++) {
 		struct rte_cls_table *table = &cls->tables[i];
 
-		if (table->type == table_type) {
+		if (table->type == tbl_type) {
 			if (table->ops.f_add != NULL) {
 				ret = table->ops.f_add(
 					table->h_table,
-					&rule->u.key.key_add,
+					classify_rule_key_add(rule),
 					&rule->entry,
 					&rule->key_found,
 					&rule->entry_ptr);
@@ -576,7 +792,7 @@ rte_flow_classify_table_entry_delete(struct rte_flow_classifier *cls,
 		if (table->type == tbl_type) {
 			if (table->ops.f_delete != NULL) {
 				ret = table->ops.f_delete(table->h_table,
-						&rule->u.key.key_del,
+						classify_rule_key_del(rule),
 						&rule->key_found,
 						&rule->entry);
 
@@ -603,10 +819,13 @@ flow_classifier_lookup(struct rte_flow_classifier *cls,
 		pkts, pkts_mask, &lookup_hit_mask,
 		(void **)cls->entries);
 
-	if (!ret && lookup_hit_mask)
+	if (!ret && lookup_hit_mask) {
 		cls->nb_pkts = nb_pkts;
-	else
+		cls->lookup_hit_mask = lookup_hit_mask;
+	} else {
 		cls->nb_pkts = 0;
+		cls->lookup_hit_mask = 0;
+	}
 
 	return ret;
 }
@@ -617,6 +836,7 @@ action_apply(struct rte_flow_classifier *cls,
 		struct rte_flow_classify_stats *stats)
 {
 	struct rte_flow_classify_ipv4_5tuple_stats *ntuple_stats;
+	struct rte_flow_classify_ipv6_5tuple_stats *ipv6_stats;
 	struct rte_flow_classify_table_entry *entry = &rule->entry;
 	uint64_t count = 0;
 	uint32_t action_mask = entry->action.action_mask;
@@ -624,14 +844,25 @@ action_apply(struct rte_flow_classifier *cls,
 
 	if (action_mask & (1LLU << RTE_FLOW_ACTION_TYPE_COUNT)) {
 		for (i = 0; i < cls->nb_pkts; i++) {
-			if (rule->id == cls->entries[i]->rule_id)
+			/* the entries of the missed packets are not set */
+			if ((cls->lookup_hit_mask & (1LLU << i)) &&
+			    rule->id == cls->entries[i]->rule_id)
 				count++;
 		}
 		if (count) {
 			ret = 0;
-			ntuple_stats = stats->stats;
-			ntuple_stats->counter1 = count;
-			ntuple_stats->ipv4_5tuple = rule->rules.u.ipv4_5tuple;
+			if (rule->rules.type ==
+					RTE_FLOW_CLASSIFY_RULE_TYPE_IPV6_5TUPLE) {
+				ipv6_stats = stats->stats;
+				ipv6_stats->counter1 = count;
+				ipv6_stats->ipv6_5tuple =
+					rule->rules.u.ipv6_5tuple;
+			} else {
+				ntuple_stats = stats->stats;
+				ntuple_stats->counter1 = count;
+				ntuple_stats->ipv4_5tuple =
+					rule->rules.u.ipv4_5tuple;
+			}
 		}
 	}
 	return ret;
@@ -18,6 +18,9 @@
  *
  * Application should define the flow and measurement criteria (action) for it.
  *
+ * The rules are matched by ACL tables, or by exact match hash tables when
+ * they have no wildcard, which only cost one hash lookup per packet.
+ *
  * The Library doesn't maintain any flow records itself, instead flow
  * information is returned to upper layer only for given packets.
  *
@@ -48,8 +51,11 @@
 #include <rte_ethdev.h>
 #include <rte_ether.h>
 #include <rte_flow.h>
+#include <rte_ip.h>
+#include <rte_mbuf.h>
 #include <rte_acl.h>
 #include <rte_table_acl.h>
+#include <rte_table_hash.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -80,6 +86,8 @@ enum rte_flow_classify_rule_type {
 	RTE_FLOW_CLASSIFY_RULE_TYPE_NONE,
 	/** IPv4 5tuple type */
 	RTE_FLOW_CLASSIFY_RULE_TYPE_IPV4_5TUPLE,
+	/** IPv6 5tuple type */
+	RTE_FLOW_CLASSIFY_RULE_TYPE_IPV6_5TUPLE,
 };
 
 /** Flow classify table type */
@@ -92,9 +100,50 @@ enum rte_flow_classify_table_type {
 	RTE_FLOW_CLASSIFY_TABLE_ACL_VLAN_IP4_5TUPLE = 1 << 2,
 	/** ACL QinQ IP4 5TUPLE */
 	RTE_FLOW_CLASSIFY_TABLE_ACL_QINQ_IP4_5TUPLE = 1 << 3,
-
+	/** Exact match hash IP4 5TUPLE */
+	RTE_FLOW_CLASSIFY_TABLE_HASH_IP4_5TUPLE = 1 << 4,
+	/** Exact match hash IP6 5TUPLE */
+	RTE_FLOW_CLASSIFY_TABLE_HASH_IP6_5TUPLE = 1 << 5,
 };
 
+/**
+ * Key size of the exact match IPv4 5-tuple table.
+ *
+ * The key is read in the packet from the IPv4 TTL field to the L4 ports,
+ * the TTL and checksum being masked, so the IPv4 header must not have
+ * options.
+ */
+#define RTE_FLOW_CLASSIFY_HASH_IP4_5TUPLE_KEY_SIZE	16
+
+/**
+ * Key size of the exact match IPv6 5-tuple table.
+ *
+ * The key is read in the packet from the IPv6 next header field to the
+ * L4 ports, the hop limit being masked, so the IPv6 header must not be
+ * followed by extension headers.
+ */
+#define RTE_FLOW_CLASSIFY_HASH_IP6_5TUPLE_KEY_SIZE	64
+
+/**
+ * Default offset of the key of the exact match IPv4 5-tuple table in the
+ * packet meta-data, for untagged Ethernet packets at the default headroom
+ * of mbufs without private area.
+ */
+#define RTE_FLOW_CLASSIFY_HASH_IP4_5TUPLE_KEY_OFFSET \
+	(sizeof(struct rte_mbuf) + RTE_PKTMBUF_HEADROOM + \
+	 sizeof(struct rte_ether_hdr) + \
+	 offsetof(struct rte_ipv4_hdr, time_to_live))
+
+/**
+ * Default offset of the key of the exact match IPv6 5-tuple table in the
+ * packet meta-data, for untagged Ethernet packets at the default headroom
+ * of mbufs without private area.
+ */
+#define RTE_FLOW_CLASSIFY_HASH_IP6_5TUPLE_KEY_OFFSET \
+	(sizeof(struct rte_mbuf) + RTE_PKTMBUF_HEADROOM + \
+	 sizeof(struct rte_ether_hdr) + \
+	 offsetof(struct rte_ipv6_hdr, proto))
+
 /** Parameters for flow classifier creation */
 struct rte_flow_classifier_params {
 	/** flow classifier name */
@@ -110,7 +159,17 @@ struct rte_flow_classify_table_params {
 	/** Table operations (specific to each table type) */
 	struct rte_table_ops *ops;
 
-	/** Opaque param to be passed to the table create operation */
+	/**
+	 * Opaque param to be passed to the table create operation.
+	 *
+	 * For the exact match hash tables, it is a struct
+	 * rte_table_hash_params, whose key size and key mask are set by
+	 * the library, and whose key offset defaults to
+	 * RTE_FLOW_CLASSIFY_HASH_IP4_5TUPLE_KEY_OFFSET or
+	 * RTE_FLOW_CLASSIFY_HASH_IP6_5TUPLE_KEY_OFFSET when 0.
+	 * The table operations must apply the key mask,
+	 * like the rte_table_hash_key16, ext and lru ones.
+	 */
 	void *arg_create;
 
 	/** Classifier table type */
@@ -131,6 +190,15 @@ struct rte_flow_classify_ipv4_5tuple {
 	uint8_t proto_mask;      /**< Mask of L4 protocol. */
 };
 
+/** IPv6 5-tuple data, matched exactly */
+struct rte_flow_classify_ipv6_5tuple {
+	uint8_t dst_ip[16];      /**< Destination IP address in big endian. */
+	uint8_t src_ip[16];      /**< Source IP address in big endian. */
+	uint16_t dst_port;       /**< Destination port in big endian. */
+	uint16_t src_port;       /**< Source Port in big endian. */
+	uint8_t proto;           /**< L4 protocol. */
+};
+
 /**
  * Flow stats
  *
@@ -149,6 +217,13 @@ struct rte_flow_classify_ipv4_5tuple_stats {
 	struct rte_flow_classify_ipv4_5tuple ipv4_5tuple;
 };
 
+struct rte_flow_classify_ipv6_5tuple_stats {
+	/** count of packets that match IPv6 5tuple pattern */
+	uint64_t counter1;
+	/** IPv6 5tuple data */
+	struct rte_flow_classify_ipv6_5tuple ipv6_5tuple;
+};
+
 /**
  * Flow classifier create
  *
@@ -268,7 +343,9 @@ rte_flow_classify_table_entry_delete(struct rte_flow_classifier *cls,
  * @param[in] rule
  *   Flow classify rule
  * @param[in] stats
- *   Flow classify stats
+ *   Flow classify stats, pointing to a struct
+ *   rte_flow_classify_ipv6_5tuple_stats for the IPv6 rules and to a struct
+ *   rte_flow_classify_ipv4_5tuple_stats otherwise
  *
  * @return
  *   0 on success, error code otherwise.
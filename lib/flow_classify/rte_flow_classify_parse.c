@@ -13,6 +13,8 @@ struct classify_valid_pattern {
 
 static struct classify_action action;
 
+static struct rte_flow_classify_ipv6_5tuple ipv6_5tuple;
+
 /* Pattern for IPv4 5-tuple UDP filter */
 static enum rte_flow_item_type pattern_ntuple_1[] = {
 	RTE_FLOW_ITEM_TYPE_ETH,
@@ -37,6 +39,30 @@ static enum rte_flow_item_type pattern_ntuple_3[] = {
 	RTE_FLOW_ITEM_TYPE_END,
 };
 
+/* Pattern for IPv6 5-tuple UDP filter */
+static enum rte_flow_item_type pattern_ipv6_5tuple_1[] = {
+	RTE_FLOW_ITEM_TYPE_ETH,
+	RTE_FLOW_ITEM_TYPE_IPV6,
+	RTE_FLOW_ITEM_TYPE_UDP,
+	RTE_FLOW_ITEM_TYPE_END,
+};
+
+/* Pattern for IPv6 5-tuple TCP filter */
+static enum rte_flow_item_type pattern_ipv6_5tuple_2[] = {
+	RTE_FLOW_ITEM_TYPE_ETH,
+	RTE_FLOW_ITEM_TYPE_IPV6,
+	RTE_FLOW_ITEM_TYPE_TCP,
+	RTE_FLOW_ITEM_TYPE_END,
+};
+
+/* Pattern for IPv6 5-tuple SCTP filter */
+static enum rte_flow_item_type pattern_ipv6_5tuple_3[] = {
+	RTE_FLOW_ITEM_TYPE_ETH,
+	RTE_FLOW_ITEM_TYPE_IPV6,
+	RTE_FLOW_ITEM_TYPE_SCTP,
+	RTE_FLOW_ITEM_TYPE_END,
+};
+
 static int
 classify_parse_ntuple_filter(const struct rte_flow_attr *attr,
 			 const struct rte_flow_item pattern[],
@@ -44,11 +70,22 @@ classify_parse_ntuple_filter(const struct rte_flow_attr *attr,
 			 struct rte_eth_ntuple_filter *filter,
 			 struct rte_flow_error *error);
 
+static int
+classify_parse_ipv6_5tuple_filter(const struct rte_flow_attr *attr,
+			 const struct rte_flow_item pattern[],
+			 const struct rte_flow_action actions[],
+			 struct rte_eth_ntuple_filter *filter,
+			 struct rte_flow_error *error);
+
 static struct classify_valid_pattern classify_supported_patterns[] = {
 	/* ntuple */
 	{ pattern_ntuple_1, classify_parse_ntuple_filter },
 	{ pattern_ntuple_2, classify_parse_ntuple_filter },
 	{ pattern_ntuple_3, classify_parse_ntuple_filter },
+	/* IPv6 5-tuple */
+	{ pattern_ipv6_5tuple_1, classify_parse_ipv6_5tuple_filter },
+	{ pattern_ipv6_5tuple_2, classify_parse_ipv6_5tuple_filter },
+	{ pattern_ipv6_5tuple_3, classify_parse_ipv6_5tuple_filter },
 };
 
 struct classify_action *
@@ -57,6 +94,12 @@ classify_get_flow_action(void)
 	return &action;
 }
 
+struct rte_flow_classify_ipv6_5tuple *
+classify_get_ipv6_5tuple(void)
+{
+	return &ipv6_5tuple;
+}
+
 /* Find the first VOID or non-VOID item pointer */
 const struct rte_flow_item *
 classify_find_first_item(const struct rte_flow_item *item, bool is_void)
@@ -165,6 +208,108 @@ classify_find_parse_filter_func(struct rte_flow_item *pattern)
 		} \
 	} while (0)
 
+/* Parse the attributes and the COUNT and MARK actions of a rule */
+static int
+classify_parse_attr_action(const struct rte_flow_attr *attr,
+			 const struct rte_flow_action actions[],
+			 uint16_t *priority,
+			 struct rte_flow_error *error)
+{
+	const struct rte_flow_action *act;
+	const struct rte_flow_action_count *count;
+	const struct rte_flow_action_mark *mark_spec;
+	uint32_t index;
+
+	/* parse attr */
+	/* must be input direction */
+	if (!attr->ingress) {
+		rte_flow_error_set(error, EINVAL,
+				   RTE_FLOW_ERROR_TYPE_ATTR_INGRESS,
+				   attr, "Only support ingress.");
+		return -EINVAL;
+	}
+
+	/* not supported */
+	if (attr->egress) {
+		rte_flow_error_set(error, EINVAL,
+				   RTE_FLOW_ERROR_TYPE_ATTR_EGRESS,
+				   attr, "Not support egress.");
+		return -EINVAL;
+	}
+
+	if (attr->priority > 0xFFFF) {
+		rte_flow_error_set(error, EINVAL,
+				   RTE_FLOW_ERROR_TYPE_ATTR_PRIORITY,
+				   attr, "Error priority.");
+		return -EINVAL;
+	}
+	*priority = (uint16_t)attr->priority;
+	if (attr->priority >  FLOW_RULE_MIN_PRIORITY)
+		*priority = FLOW_RULE_MAX_PRIORITY;
+
+	/* parse action */
+	index = 0;
+
+	/**
+	 * n-tuple only supports count and Mark,
+	 * check if the first not void action is COUNT or MARK.
+	 */
+	memset(&action, 0, sizeof(action));
+	NEXT_ITEM_OF_ACTION(act, actions, index);
+	switch (act->type) {
+	case RTE_FLOW_ACTION_TYPE_COUNT:
+		action.action_mask |= 1LLU << RTE_FLOW_ACTION_TYPE_COUNT;
+		count = act->conf;
+		memcpy(&action.act.counter, count, sizeof(action.act.counter));
+		break;
+	case RTE_FLOW_ACTION_TYPE_MARK:
+		action.action_mask |= 1LLU << RTE_FLOW_ACTION_TYPE_MARK;
+		mark_spec = act->conf;
+		memcpy(&action.act.mark, mark_spec, sizeof(action.act.mark));
+		break;
+	default:
+		rte_flow_error_set(error, EINVAL,
+		   RTE_FLOW_ERROR_TYPE_ACTION, act,
+		   "Invalid action.");
+		return -EINVAL;
+	}
+
+	/* check if the next not void item is MARK or COUNT or END */
+	index++;
+	NEXT_ITEM_OF_ACTION(act, actions, index);
+	switch (act->type) {
+	case RTE_FLOW_ACTION_TYPE_COUNT:
+		action.action_mask |= 1LLU << RTE_FLOW_ACTION_TYPE_COUNT;
+		count = act->conf;
+		memcpy(&action.act.counter, count, sizeof(action.act.counter));
+		break;
+	case RTE_FLOW_ACTION_TYPE_MARK:
+		action.action_mask |= 1LLU << RTE_FLOW_ACTION_TYPE_MARK;
+		mark_spec = act->conf;
+		memcpy(&action.act.mark, mark_spec, sizeof(action.act.mark));
+		break;
+	case RTE_FLOW_ACTION_TYPE_END:
+		return 0;
+	default:
+		rte_flow_error_set(error, EINVAL,
+		   RTE_FLOW_ERROR_TYPE_ACTION, act,
+		   "Invalid action.");
+		return -EINVAL;
+	}
+
+	/* check if the next not void item is END */
+	index++;
+	NEXT_ITEM_OF_ACTION(act, actions, index);
+	if (act->type != RTE_FLOW_ACTION_TYPE_END) {
+		rte_flow_error_set(error, EINVAL,
+		   RTE_FLOW_ERROR_TYPE_ACTION, act,
+		   "Invalid action.");
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
 /**
  * Please aware there's an assumption for all the parsers.
  * rte_flow_item is using big endian, rte_flow_attr and
@@ -182,8 +327,8 @@ classify_find_parse_filter_func(struct rte_flow_item *pattern)
  * The third not void item must be UDP or TCP.
  * The next not void item must be END.
  * action:
- * The first not void action should be QUEUE.
- * The next not void action should be END.
+ * The first not void action should be COUNT or MARK.
+ * The next not void action should be COUNT, MARK or END.
  * pattern example:
  * ITEM		Spec			Mask
  * ETH		NULL			NULL
@@ -204,7 +349,6 @@ classify_parse_ntuple_filter(const struct rte_flow_attr *attr,
 			 struct rte_flow_error *error)
 {
 	const struct rte_flow_item *item;
-	const struct rte_flow_action *act;
 	const struct rte_flow_item_ipv4 *ipv4_spec;
 	const struct rte_flow_item_ipv4 *ipv4_mask;
 	const struct rte_flow_item_tcp *tcp_spec;
@@ -213,9 +357,8 @@ classify_parse_ntuple_filter(const struct rte_flow_attr *attr,
 	const struct rte_flow_item_udp *udp_mask;
 	const struct rte_flow_item_sctp *sctp_spec;
 	const struct rte_flow_item_sctp *sctp_mask;
-	const struct rte_flow_action_count *count;
-	const struct rte_flow_action_mark *mark_spec;
 	uint32_t index;
+	int ret;
 
 	/* parse pattern */
 	index = 0;
@@ -436,98 +579,172 @@ classify_parse_ntuple_filter(const struct rte_flow_attr *attr,
 
 	table_type = RTE_FLOW_CLASSIFY_TABLE_ACL_IP4_5TUPLE;
 
-	/* parse attr */
-	/* must be input direction */
-	if (!attr->ingress) {
+	ret = classify_parse_attr_action(attr, actions, &filter->priority,
+			error);
+	if (ret)
 		memset(filter, 0, sizeof(struct rte_eth_ntuple_filter));
+
+	return ret;
+}
+
+/* Check the L4 item mask selects the ports fully and nothing else */
+static bool
+classify_l4_mask_is_ports(const void *mask, size_t size)
+{
+	const uint8_t *m = mask;
+	size_t i;
+
+	/* the TCP, UDP and SCTP headers start with the ports */
+	for (i = 0; i < size; i++)
+		if (m[i] != (i < 2 * sizeof(rte_be16_t) ? UINT8_MAX : 0))
+			return false;
+
+	return true;
+}
+
+/**
+ * Parse the rule to see if it is an IPv6 5-tuple rule,
+ * matched by the exact match table.
+ * pattern:
+ * The first not void item can be ETH or IPV6.
+ * The second not void item must be IPV6 if the first one is ETH.
+ * The third not void item must be UDP, TCP or SCTP.
+ * The next not void item must be END.
+ * action:
+ * Same as the n-tuple rule.
+ * pattern example:
+ * ITEM		Spec			Mask
+ * ETH		NULL			NULL
+ * IPV6		src_addr 2001:db8::1	ffff:...:ffff
+ *		dst_addr 2001:db8::2	ffff:...:ffff
+ *		proto	17		0xFF
+ * UDP/TCP/	src_port	80	0xFFFF
+ * SCTP		dst_port	80	0xFFFF
+ * END
+ * other members in mask and spec should set to 0x00.
+ * item->last should be NULL.
+ */
+static int
+classify_parse_ipv6_5tuple_filter(const struct rte_flow_attr *attr,
+			 const struct rte_flow_item pattern[],
+			 const struct rte_flow_action actions[],
+			 struct rte_eth_ntuple_filter *filter,
+			 struct rte_flow_error *error)
+{
+	const struct rte_flow_item *item;
+	const struct rte_flow_item_ipv6 *ipv6_spec;
+	const struct rte_flow_item_ipv6 *ipv6_mask;
+	const rte_be16_t *ports;
+	struct rte_flow_item_ipv6 exact_mask;
+	size_t l4_size;
+	uint32_t index;
+	int ret;
+
+	memset(&ipv6_5tuple, 0, sizeof(ipv6_5tuple));
+
+	/* parse pattern */
+	index = 0;
+
+	/* the first not void item can be MAC or IPv6 */
+	NEXT_ITEM_OF_PATTERN(item, pattern, index);
+
+	if (item->type == RTE_FLOW_ITEM_TYPE_ETH) {
+		/* if the first item is MAC, the content should be NULL */
+		if (item->spec || item->mask || item->last) {
+			rte_flow_error_set(error, EINVAL,
+					RTE_FLOW_ERROR_TYPE_ITEM,
+					item,
+					"Not supported by IPv6 5-tuple filter");
+			return -EINVAL;
+		}
+		index++;
+		NEXT_ITEM_OF_PATTERN(item, pattern, index);
+	}
+	if (item->type != RTE_FLOW_ITEM_TYPE_IPV6) {
 		rte_flow_error_set(error, EINVAL,
-				   RTE_FLOW_ERROR_TYPE_ATTR_INGRESS,
-				   attr, "Only support ingress.");
+			RTE_FLOW_ERROR_TYPE_ITEM,
+			item, "Not supported by IPv6 5-tuple filter");
 		return -EINVAL;
 	}
 
-	/* not supported */
-	if (attr->egress) {
-		memset(filter, 0, sizeof(struct rte_eth_ntuple_filter));
+	/* get the IPv6 info, only exact addresses and protocol */
+	if (!item->spec || !item->mask || item->last) {
 		rte_flow_error_set(error, EINVAL,
-				   RTE_FLOW_ERROR_TYPE_ATTR_EGRESS,
-				   attr, "Not support egress.");
+			RTE_FLOW_ERROR_TYPE_ITEM,
+			item, "Invalid IPv6 5-tuple mask");
 		return -EINVAL;
 	}
 
-	if (attr->priority > 0xFFFF) {
-		memset(filter, 0, sizeof(struct rte_eth_ntuple_filter));
+	memset(&exact_mask, 0, sizeof(exact_mask));
+	exact_mask.hdr.proto = UINT8_MAX;
+	memset(exact_mask.hdr.src_addr, UINT8_MAX,
+		sizeof(exact_mask.hdr.src_addr));
+	memset(exact_mask.hdr.dst_addr, UINT8_MAX,
+		sizeof(exact_mask.hdr.dst_addr));
+	ipv6_mask = item->mask;
+	if (memcmp(ipv6_mask, &exact_mask, sizeof(exact_mask))) {
 		rte_flow_error_set(error, EINVAL,
-				   RTE_FLOW_ERROR_TYPE_ATTR_PRIORITY,
-				   attr, "Error priority.");
+			RTE_FLOW_ERROR_TYPE_ITEM,
+			item, "Invalid IPv6 5-tuple mask");
 		return -EINVAL;
 	}
-	filter->priority = (uint16_t)attr->priority;
-	if (attr->priority >  FLOW_RULE_MIN_PRIORITY)
-		filter->priority = FLOW_RULE_MAX_PRIORITY;
 
-	/* parse action */
-	index = 0;
+	ipv6_spec = item->spec;
+	memcpy(ipv6_5tuple.src_ip, ipv6_spec->hdr.src_addr,
+		sizeof(ipv6_5tuple.src_ip));
+	memcpy(ipv6_5tuple.dst_ip, ipv6_spec->hdr.dst_addr,
+		sizeof(ipv6_5tuple.dst_ip));
+	ipv6_5tuple.proto = ipv6_spec->hdr.proto;
 
-	/**
-	 * n-tuple only supports count and Mark,
-	 * check if the first not void action is COUNT or MARK.
-	 */
-	memset(&action, 0, sizeof(action));
-	NEXT_ITEM_OF_ACTION(act, actions, index);
-	switch (act->type) {
-	case RTE_FLOW_ACTION_TYPE_COUNT:
-		action.action_mask |= 1LLU << RTE_FLOW_ACTION_TYPE_COUNT;
-		count = act->conf;
-		memcpy(&action.act.counter, count, sizeof(action.act.counter));
+	/* check if the next not void item is TCP or UDP or SCTP */
+	index++;
+	NEXT_ITEM_OF_PATTERN(item, pattern, index);
+	switch (item->type) {
+	case RTE_FLOW_ITEM_TYPE_TCP:
+		l4_size = sizeof(struct rte_flow_item_tcp);
 		break;
-	case RTE_FLOW_ACTION_TYPE_MARK:
-		action.action_mask |= 1LLU << RTE_FLOW_ACTION_TYPE_MARK;
-		mark_spec = act->conf;
-		memcpy(&action.act.mark, mark_spec, sizeof(action.act.mark));
+	case RTE_FLOW_ITEM_TYPE_UDP:
+		l4_size = sizeof(struct rte_flow_item_udp);
+		break;
+	case RTE_FLOW_ITEM_TYPE_SCTP:
+		l4_size = sizeof(struct rte_flow_item_sctp);
 		break;
 	default:
-		memset(filter, 0, sizeof(struct rte_eth_ntuple_filter));
 		rte_flow_error_set(error, EINVAL,
-		   RTE_FLOW_ERROR_TYPE_ACTION, act,
-		   "Invalid action.");
+			RTE_FLOW_ERROR_TYPE_ITEM,
+			item, "Not supported by IPv6 5-tuple filter");
 		return -EINVAL;
 	}
 
-	/* check if the next not void item is MARK or COUNT or END */
-	index++;
-	NEXT_ITEM_OF_ACTION(act, actions, index);
-	switch (act->type) {
-	case RTE_FLOW_ACTION_TYPE_COUNT:
-		action.action_mask |= 1LLU << RTE_FLOW_ACTION_TYPE_COUNT;
-		count = act->conf;
-		memcpy(&action.act.counter, count, sizeof(action.act.counter));
-		break;
-	case RTE_FLOW_ACTION_TYPE_MARK:
-		action.action_mask |= 1LLU << RTE_FLOW_ACTION_TYPE_MARK;
-		mark_spec = act->conf;
-		memcpy(&action.act.mark, mark_spec, sizeof(action.act.mark));
-		break;
-	case RTE_FLOW_ACTION_TYPE_END:
-		return 0;
-	default:
-		memset(filter, 0, sizeof(struct rte_eth_ntuple_filter));
+	/* get the exact ports */
+	if (!item->spec || !item->mask || item->last ||
+	    !classify_l4_mask_is_ports(item->mask, l4_size)) {
 		rte_flow_error_set(error, EINVAL,
-		   RTE_FLOW_ERROR_TYPE_ACTION, act,
-		   "Invalid action.");
+			RTE_FLOW_ERROR_TYPE_ITEM,
+			item, "Invalid IPv6 5-tuple mask");
 		return -EINVAL;
 	}
 
+	ports = item->spec;
+	ipv6_5tuple.src_port = ports[0];
+	ipv6_5tuple.dst_port = ports[1];
+
 	/* check if the next not void item is END */
 	index++;
-	NEXT_ITEM_OF_ACTION(act, actions, index);
-	if (act->type != RTE_FLOW_ACTION_TYPE_END) {
-		memset(filter, 0, sizeof(struct rte_eth_ntuple_filter));
+	NEXT_ITEM_OF_PATTERN(item, pattern, index);
+	if (item->type != RTE_FLOW_ITEM_TYPE_END) {
 		rte_flow_error_set(error, EINVAL,
-		   RTE_FLOW_ERROR_TYPE_ACTION, act,
-		   "Invalid action.");
+			RTE_FLOW_ERROR_TYPE_ITEM,
+			item, "Not supported by IPv6 5-tuple filter");
 		return -EINVAL;
 	}
 
-	return 0;
+	table_type = RTE_FLOW_CLASSIFY_TABLE_HASH_IP6_5TUPLE;
+
+	ret = classify_parse_attr_action(attr, actions, &filter->priority,
+			error);
+	if (ret)
+		memset(&ipv6_5tuple, 0, sizeof(ipv6_5tuple));
+
+	return ret;
 }
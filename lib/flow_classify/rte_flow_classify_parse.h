@@ -52,6 +52,10 @@ classify_find_parse_filter_func(struct rte_flow_item *pattern);
 struct classify_action *
 classify_get_flow_action(void);
 
+/* get IPv6 5-tuple data */
+struct rte_flow_classify_ipv6_5tuple *
+classify_get_ipv6_5tuple(void);
+
 #ifdef __cplusplus
 }
 #endif
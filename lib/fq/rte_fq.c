@@ -0,0 +1,252 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include <rte_bitmap.h>
+#include <rte_branch_prediction.h>
+#include <rte_common.h>
+#include <rte_errno.h>
+#include <rte_malloc.h>
+#include <rte_mbuf.h>
+#include <rte_prefetch.h>
+
+#include "rte_fq.h"
+
+/* 2^32 / golden ratio, spreads the hash over the high bits */
+#define FQ_HASH_MULT 0x9e3779b1u
+
+struct fq_queue {
+	uint32_t qr;
+	uint32_t qw;
+	uint32_t deficit;
+};
+
+struct rte_fq {
+	uint32_t n_queues;
+	uint32_t qsize;
+	uint32_t quantum;
+	uint32_t hash_shift;
+	uint32_t n_pkts_held;
+
+	/* DRR round position: the active queues of the slab being served */
+	uint64_t slab;
+	uint32_t slab_pos;
+	uint32_t in_turn;  /* lowest queue of the slab was given its quantum */
+
+	struct rte_fq_stats stats;
+
+	struct rte_bitmap *bmp;
+	struct fq_queue *queues;
+	struct rte_mbuf **queue_array;
+	uint8_t memory[0] __rte_cache_aligned;
+};
+
+static inline uint32_t
+fq_qindex(const struct rte_fq *fq, const struct rte_mbuf *pkt)
+{
+	uint32_t h = pkt->hash.rss * FQ_HASH_MULT;
+
+	return (uint32_t)((uint64_t)h >> fq->hash_shift);
+}
+
+static inline struct rte_mbuf **
+fq_qbase(const struct rte_fq *fq, uint32_t qindex)
+{
+	return fq->queue_array + (size_t)qindex * fq->qsize;
+}
+
+struct rte_fq *
+rte_fq_create(const struct rte_fq_params *params)
+{
+	struct rte_fq *fq;
+	size_t size_queues, size_queue_array;
+	uint32_t size_bmp;
+
+	if (params == NULL || params->quantum == 0 ||
+			params->n_queues == 0 ||
+			params->n_queues > RTE_FQ_MAX_QUEUES ||
+			!rte_is_power_of_2(params->n_queues) ||
+			params->qsize == 0 || params->qsize > RTE_FQ_MAX_QSIZE ||
+			!rte_is_power_of_2(params->qsize)) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	size_queues = RTE_CACHE_LINE_ROUNDUP(params->n_queues *
+		sizeof(struct fq_queue));
+	size_queue_array = RTE_CACHE_LINE_ROUNDUP((size_t)params->n_queues *
+		params->qsize * sizeof(struct rte_mbuf *));
+	size_bmp = rte_bitmap_get_memory_footprint(params->n_queues);
+
+	fq = rte_zmalloc_socket("rte_fq", sizeof(*fq) + size_queues +
+		size_queue_array + size_bmp, RTE_CACHE_LINE_SIZE,
+		params->socket_id);
+	if (fq == NULL) {
+		rte_errno = ENOMEM;
+		return NULL;
+	}
+
+	fq->n_queues = params->n_queues;
+	fq->qsize = params->qsize;
+	fq->quantum = params->quantum;
+	fq->hash_shift = 32 - rte_log2_u32(params->n_queues);
+
+	fq->queues = (struct fq_queue *)fq->memory;
+	fq->queue_array = (struct rte_mbuf **)(fq->memory + size_queues);
+	fq->bmp = rte_bitmap_init(params->n_queues,
+		fq->memory + size_queues + size_queue_array, size_bmp);
+	if (fq->bmp == NULL) {
+		rte_free(fq);
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	return fq;
+}
+
+void
+rte_fq_free(struct rte_fq *fq)
+{
+	uint32_t qindex;
+
+	if (fq == NULL)
+		return;
+
+	for (qindex = 0; qindex < fq->n_queues; qindex++) {
+		struct fq_queue *q = &fq->queues[qindex];
+		struct rte_mbuf **qbase = fq_qbase(fq, qindex);
+
+		for (; q->qr != q->qw; q->qr++)
+			rte_pktmbuf_free(qbase[q->qr & (fq->qsize - 1)]);
+	}
+
+	rte_free(fq);
+}
+
+uint32_t
+rte_fq_enqueue(struct rte_fq *fq, struct rte_mbuf **pkts, uint32_t n_pkts)
+{
+	uint32_t qsize = fq->qsize;
+	uint32_t i, n = 0;
+	uint64_t n_bytes = 0;
+
+	if (n_pkts != 0)
+		rte_prefetch0(&fq->queues[fq_qindex(fq, pkts[0])]);
+
+	for (i = 0; i < n_pkts; i++) {
+		struct rte_mbuf *pkt = pkts[i];
+		uint32_t qindex = fq_qindex(fq, pkt);
+		struct fq_queue *q = &fq->queues[qindex];
+
+		/* Hide the latency of the next queue */
+		if (i + 1 < n_pkts)
+			rte_prefetch0(&fq->queues[fq_qindex(fq, pkts[i + 1])]);
+
+		if (unlikely(q->qw - q->qr >= qsize)) {
+			fq->stats.n_pkts_dropped++;
+			fq->stats.n_bytes_dropped += pkt->pkt_len;
+			rte_pktmbuf_free(pkt);
+			continue;
+		}
+
+		/* Activate the queue */
+		if (q->qw == q->qr)
+			rte_bitmap_set(fq->bmp, qindex);
+
+		fq_qbase(fq, qindex)[q->qw & (qsize - 1)] = pkt;
+		q->qw++;
+		n_bytes += pkt->pkt_len;
+		n++;
+	}
+
+	fq->n_pkts_held += n;
+	fq->stats.n_pkts += n;
+	fq->stats.n_bytes += n_bytes;
+
+	return n;
+}
+
+uint32_t
+rte_fq_dequeue(struct rte_fq *fq, struct rte_mbuf **pkts, uint32_t n_pkts)
+{
+	uint32_t qsize = fq->qsize;
+	uint32_t n = 0;
+
+	while (n < n_pkts) {
+		struct rte_mbuf **qbase;
+		struct fq_queue *q;
+		uint32_t qindex;
+
+		/* Next slab of active queues, wrapping around */
+		if (fq->slab == 0) {
+			if (rte_bitmap_scan(fq->bmp, &fq->slab_pos,
+					&fq->slab) == 0)
+				break;
+			fq->in_turn = 0;
+		}
+
+		qindex = fq->slab_pos + rte_bsf64(fq->slab);
+		q = &fq->queues[qindex];
+		qbase = fq_qbase(fq, qindex);
+
+		if (!fq->in_turn) {
+			q->deficit += fq->quantum;
+			fq->in_turn = 1;
+		}
+
+		for ( ; ; ) {
+			struct rte_mbuf *pkt;
+
+			/* Empty queue: out of the round, without credit */
+			if (q->qr == q->qw) {
+				q->deficit = 0;
+				rte_bitmap_clear(fq->bmp, qindex);
+				break;
+			}
+
+			/* Carry on with this queue on the next dequeue */
+			if (n == n_pkts)
+				goto out;
+
+			pkt = qbase[q->qr & (qsize - 1)];
+			if (pkt->pkt_len > q->deficit)
+				break;
+
+			q->deficit -= pkt->pkt_len;
+			q->qr++;
+			pkts[n++] = pkt;
+		}
+
+		/* Next active queue of the slab */
+		fq->slab &= fq->slab - 1;
+		fq->in_turn = 0;
+	}
+
+out:
+	fq->n_pkts_held -= n;
+	return n;
+}
+
+uint32_t
+rte_fq_count(const struct rte_fq *fq)
+{
+	return fq->n_pkts_held;
+}
+
+int
+rte_fq_stats_read(struct rte_fq *fq, struct rte_fq_stats *stats, int clear)
+{
+	if (fq == NULL)
+		return -EINVAL;
+
+	if (stats != NULL)
+		*stats = fq->stats;
+
+	if (clear)
+		memset(&fq->stats, 0, sizeof(fq->stats));
+
+	return 0;
+}
@@ -0,0 +1,174 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#ifndef _RTE_FQ_H_
+#define _RTE_FQ_H_
+
+/**
+ * @file
+ * RTE Flow Queue Scheduler
+ *
+ * Per flow fair queuing: the packets are spread over a large number of flow
+ * queues by hashing their flow, and the active flow queues are served with
+ * Deficit Round Robin (DRR), so that each flow gets a fair share of the
+ * output bytes whatever its packet sizes. The active flow queues are
+ * tracked with a bitmap, so that the idle ones cost nothing on dequeue.
+ *
+ * The flow of a packet is its mbuf hash.rss field, which the application
+ * sets when the packets do not come from a NIC with RSS enabled. As with
+ * stochastic fair queuing, flows whose hashes collide share a flow queue.
+ *
+ * A flow queue scheduler is not thread safe: its enqueue and dequeue
+ * operations must run on the same thread.
+ */
+
+#include <stdint.h>
+
+#include <rte_compat.h>
+#include <rte_mbuf.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Maximum number of flow queues. */
+#define RTE_FQ_MAX_QUEUES (1 << 20)
+
+/** Maximum size of a flow queue, in packets. */
+#define RTE_FQ_MAX_QSIZE (1 << 15)
+
+/**
+ * Flow queue scheduler configuration parameters.
+ */
+struct rte_fq_params {
+	/** NUMA socket of the scheduler memory. */
+	int socket_id;
+	/** Number of flow queues, power of 2. */
+	uint32_t n_queues;
+	/** Size of each flow queue, in packets, power of 2. */
+	uint32_t qsize;
+	/** Bytes a flow queue may send on each round, no less than the MTU. */
+	uint32_t quantum;
+};
+
+/**
+ * Flow queue scheduler statistics.
+ */
+struct rte_fq_stats {
+	uint64_t n_pkts;         /**< Packets enqueued. */
+	uint64_t n_pkts_dropped; /**< Packets dropped on a full flow queue. */
+	uint64_t n_bytes;        /**< Bytes enqueued. */
+	uint64_t n_bytes_dropped; /**< Bytes dropped on a full flow queue. */
+};
+
+struct rte_fq;
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Create a flow queue scheduler.
+ *
+ * @param params
+ *   Configuration parameters.
+ * @return
+ *   Flow queue scheduler, NULL on error with rte_errno set:
+ *    - EINVAL - invalid parameters
+ *    - ENOMEM - not enough memory
+ */
+__rte_experimental
+struct rte_fq *
+rte_fq_create(const struct rte_fq_params *params);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Free a flow queue scheduler, with the packets it holds.
+ *
+ * @param fq
+ *   Flow queue scheduler, may be NULL.
+ */
+__rte_experimental
+void
+rte_fq_free(struct rte_fq *fq);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Enqueue packets to their flow queues. The packets of full flow queues
+ * are dropped, i.e. freed.
+ *
+ * @param fq
+ *   Flow queue scheduler.
+ * @param pkts
+ *   Packets to enqueue.
+ * @param n_pkts
+ *   Number of packets.
+ * @return
+ *   Number of packets enqueued, the others are dropped.
+ */
+__rte_experimental
+uint32_t
+rte_fq_enqueue(struct rte_fq *fq, struct rte_mbuf **pkts, uint32_t n_pkts);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Dequeue packets from the active flow queues, in DRR order.
+ *
+ * @param fq
+ *   Flow queue scheduler.
+ * @param pkts
+ *   Array filled with the dequeued packets.
+ * @param n_pkts
+ *   Maximum number of packets to dequeue.
+ * @return
+ *   Number of packets dequeued.
+ */
+__rte_experimental
+uint32_t
+rte_fq_dequeue(struct rte_fq *fq, struct rte_mbuf **pkts, uint32_t n_pkts);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Get the number of packets held by a flow queue scheduler.
+ *
+ * @param fq
+ *   Flow queue scheduler.
+ * @return
+ *   Number of packets held.
+ */
+__rte_experimental
+uint32_t
+rte_fq_count(const struct rte_fq *fq);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Read the statistics of a flow queue scheduler.
+ *
+ * @param fq
+ *   Flow queue scheduler.
+ * @param stats
+ *   Filled with the statistics, may be NULL to only clear them.
+ * @param clear
+ *   Clear the statistics once read when non-zero.
+ * @return
+ *   0 on success, -EINVAL on invalid parameters.
+ */
+__rte_experimental
+int
+rte_fq_stats_read(struct rte_fq *fq, struct rte_fq_stats *stats, int clear);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_FQ_H_ */
@@ -354,6 +354,103 @@ rte_graph_create(const char *name, struct rte_graph_param *prm)
 	return RTE_GRAPH_ID_INVALID;
 }
 
+rte_graph_t
+rte_graph_clone(rte_graph_t id, const char *name, int socket_id)
+{
+	char clone_name[RTE_GRAPH_NAMESIZE];
+	struct graph_node *graph_node;
+	struct graph *parent, *graph;
+	int rc;
+
+	graph_spinlock_lock();
+
+	/* Check arguments sanity */
+	if (name == NULL)
+		SET_ERR_JMP(EINVAL, fail, "Graph name should not be NULL");
+
+	STAILQ_FOREACH(parent, &graph_list, next)
+		if (parent->id == id)
+			break;
+	if (parent == NULL)
+		SET_ERR_JMP(EINVAL, fail, "Graph %u not found", id);
+
+	rc = snprintf(clone_name, sizeof(clone_name), "%s-%s", parent->name,
+		      name);
+	if (rc < 0 || rc >= (int)sizeof(clone_name))
+		SET_ERR_JMP(E2BIG, fail, "Too big name=%s-%s", parent->name,
+			    name);
+
+	/* Check for existence of duplicate graph */
+	STAILQ_FOREACH(graph, &graph_list, next)
+		if (strncmp(clone_name, graph->name, RTE_GRAPH_NAMESIZE) == 0)
+			SET_ERR_JMP(EEXIST, fail, "Found duplicate graph %s",
+				    clone_name);
+
+	/* Create graph object */
+	graph = calloc(1, sizeof(*graph));
+	if (graph == NULL)
+		SET_ERR_JMP(ENOMEM, fail, "Failed to calloc graph object");
+
+	/* Initialize the graph object */
+	STAILQ_INIT(&graph->node_list);
+	rte_strscpy(graph->name, clone_name, RTE_GRAPH_NAMESIZE);
+
+	/*
+	 * Add the nodes in the order of the parent graph, so that the nodes
+	 * have the same offset in the reel of both graphs, which the dispatch
+	 * model relies on to hand over the streams between them.
+	 */
+	STAILQ_FOREACH(graph_node, &parent->node_list, next)
+		if (graph_node_add(graph, graph_node->node))
+			goto graph_cleanup;
+
+	/* Update adjacency list of all nodes in the graph */
+	if (graph_adjacency_list_update(graph))
+		goto graph_cleanup;
+
+	/* Initialize graph object */
+	graph->socket = socket_id;
+	graph->src_node_count = parent->src_node_count;
+	graph->node_count = parent->node_count;
+	graph->id = graph_id;
+
+	/* Allocate the Graph fast path memory and populate the data */
+	if (graph_fp_mem_create(graph))
+		goto graph_cleanup;
+
+	if (graph->nodes_start != parent->nodes_start ||
+	    graph->mem_sz != parent->mem_sz)
+		SET_ERR_JMP(EINVAL, graph_mem_destroy,
+			    "Graph %s layout differs from parent graph %s",
+			    graph->name, parent->name);
+
+	/* Share the dispatch model group of the parent graph */
+	if (graph_dispatch_group_join(graph, parent))
+		goto graph_mem_destroy;
+
+	/* Call init() of the all the nodes in the graph */
+	if (graph_node_init(graph))
+		goto graph_dispatch_fini;
+
+	/* All good, Lets add the graph to the list */
+	graph_id++;
+	STAILQ_INSERT_TAIL(&graph_list, graph, next);
+
+	graph_spinlock_unlock();
+	return graph->id;
+
+graph_dispatch_fini:
+	graph_dispatch_fini(graph);
+graph_mem_destroy:
+	graph_fp_mem_destroy(graph);
+graph_cleanup:
+	graph_cleanup(graph);
+	free(graph);
+fail:
+	graph_spinlock_unlock();
+	return RTE_GRAPH_ID_INVALID;
+}
+
 int
 rte_graph_destroy(rte_graph_t id)
 {
@@ -368,6 +465,8 @@ rte_graph_destroy(rte_graph_t id)
 		if (graph->id == id) {
 			/* Call fini() of the all the nodes in the graph */
 			graph_node_fini(graph);
+			/* Release the dispatch model resources */
+			graph_dispatch_fini(graph);
 			/* Destroy graph fast path memory */
 			rc = graph_fp_mem_destroy(graph);
 			if (rc)
@@ -58,6 +58,7 @@ rte_graph_obj_dump(FILE *f, struct rte_graph *g, bool all)
 	fprintf(f, "  cir_mask=0x%" PRIx32 "\n", g->cir_mask);
 	fprintf(f, "  nb_nodes=%" PRId32 "\n", g->nb_nodes);
 	fprintf(f, "  socket=%d\n", g->socket);
+	fprintf(f, "  lcore_id=%u\n", g->lcore_id);
 	fprintf(f, "  fence=0x%" PRIx64 "\n", g->fence);
 	fprintf(f, "  nodes_start=0x%" PRIx32 "\n", g->nodes_start);
 	fprintf(f, "  cir_start=%p\n", g->cir_start);
@@ -73,6 +74,7 @@ rte_graph_obj_dump(FILE *f, struct rte_graph *g, bool all)
 		fprintf(f, "       offset=0x%" PRIx32 "\n", n->off);
 		fprintf(f, "       nb_edges=%" PRId32 "\n", n->nb_edges);
 		fprintf(f, "       realloc_count=%d\n", n->realloc_count);
+		fprintf(f, "       lcore_id=%u\n", n->lcore_id);
 		fprintf(f, "       size=%d\n", n->size);
 		fprintf(f, "       idx=%d\n", n->idx);
 		fprintf(f, "       total_objs=%" PRId64 "\n", n->total_objs);
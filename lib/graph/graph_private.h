@@ -55,6 +55,7 @@ struct node {
 	rte_node_t id;		      /**< Allocated identifier for the node. */
 	rte_node_t parent_id;	      /**< Parent node identifier. */
 	rte_edge_t nb_edges;	      /**< Number of edges from this node. */
+	unsigned int lcore_id;	      /**< Dispatch model lcore affinity. */
 	char next_nodes[][RTE_NODE_NAMESIZE]; /**< Names of next nodes. */
 };
 
@@ -102,8 +103,42 @@ struct graph {
 	/**< Socket identifier where memory is allocated. */
 	STAILQ_HEAD(gnode_list, graph_node) node_list;
 	/**< Nodes in a graph. */
+	struct graph_dispatch_group *group;
+	/**< Dispatch model group shared with the clones of the graph. */
 };
 
+/* Dispatch model */
+#define GRAPH_DISPATCH_WQ_SIZE 1024
+#define GRAPH_DISPATCH_WQ_BURST 32
+
+/**
+ * @internal
+ *
+ * Structure that holds the graphs of a dispatch model group, i.e. a graph and
+ * all its clones, indexed by the lcore they are bound to.
+ */
+struct graph_dispatch_group {
+	struct rte_graph *graphs[RTE_MAX_LCORE];
+	/**< Graphs bound to each lcore. */
+	uint32_t refcnt;
+	/**< Number of graphs in the group. */
+};
+
+/**
+ * @internal
+ *
+ * Stream of objects handed over by the dispatch model to the work queue of
+ * the graph that runs the node.
+ */
+struct graph_wq_node {
+	rte_graph_off_t node_off;
+	/**< Offset of the node in the graph reel. */
+	uint16_t nb_objs;
+	/**< Number of objects in the stream. */
+	void *objs[RTE_GRAPH_BURST_SIZE];
+	/**< Objects of the stream. */
+} __rte_cache_aligned;
+
 /* Node functions */
 STAILQ_HEAD(node_head, node);
 
@@ -320,6 +355,32 @@ struct rte_node *graph_node_name_to_ptr(const struct rte_graph *graph,
 					const char *node_name);
 
 /* Debug functions */
+/**
+ * @internal
+ *
+ * Add a graph to the dispatch model group of its parent graph, creating the
+ * group when needed.
+ *
+ * @param graph
+ *   Pointer to the internal graph object.
+ * @param parent
+ *   Pointer to the internal parent graph object, which can be *graph* itself.
+ *
+ * @return
+ *   0 on success, -ENOMEM otherwise.
+ */
+int graph_dispatch_group_join(struct graph *graph, struct graph *parent);
+
+/**
+ * @internal
+ *
+ * Release the dispatch model resources of a graph.
+ *
+ * @param graph
+ *   Pointer to the internal graph object.
+ */
+void graph_dispatch_fini(struct graph *graph);
+
 /**
  * @internal
  *
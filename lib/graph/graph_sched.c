@@ -0,0 +1,236 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2021 Marvell International Ltd.
+ */
+
+#include <stdbool.h>
+
+#include <rte_common.h>
+#include <rte_errno.h>
+#include <rte_lcore.h>
+#include <rte_malloc.h>
+#include <rte_mempool.h>
+#include <rte_pause.h>
+#include <rte_ring.h>
+
+#include "graph_private.h"
+#include "rte_graph_model_dispatch.h"
+
+#define GRAPH_DISPATCH_WQ_CACHE_SIZE 32
+
+int
+graph_dispatch_group_join(struct graph *graph, struct graph *parent)
+{
+	struct graph_dispatch_group *group = parent->group;
+
+	if (group == NULL) {
+		group = rte_zmalloc_socket(NULL, sizeof(*group),
+					   RTE_CACHE_LINE_SIZE, parent->socket);
+		if (group == NULL)
+			SET_ERR_JMP(ENOMEM, fail,
+				    "Failed to alloc dispatch group of %s",
+				    parent->name);
+
+		group->refcnt = 1;
+		parent->group = group;
+		parent->graph->lcore_graphs = group->graphs;
+	}
+
+	if (graph != parent) {
+		group->refcnt++;
+		graph->group = group;
+		graph->graph->lcore_graphs = group->graphs;
+	}
+
+	return 0;
+fail:
+	return -rte_errno;
+}
+
+void
+graph_dispatch_fini(struct graph *graph)
+{
+	struct graph_dispatch_group *group = graph->group;
+	struct rte_graph *g = graph->graph;
+
+	if (group == NULL)
+		return;
+
+	if (g->lcore_id != RTE_MAX_LCORE && group->graphs[g->lcore_id] == g)
+		group->graphs[g->lcore_id] = NULL;
+
+	rte_ring_free(g->wq);
+	rte_mempool_free(g->wq_mp);
+	g->wq = NULL;
+	g->wq_mp = NULL;
+	g->lcore_graphs = NULL;
+	g->lcore_id = RTE_MAX_LCORE;
+
+	graph->group = NULL;
+	if (--group->refcnt == 0)
+		rte_free(group);
+}
+
+static int
+graph_dispatch_wq_create(struct graph *graph)
+{
+	struct rte_graph *g = graph->graph;
+	char name[RTE_RING_NAMESIZE];
+
+	if (g->wq != NULL)
+		return 0;
+
+	snprintf(name, sizeof(name), "graph_wq_%u", graph->id);
+	g->wq = rte_ring_create(name, GRAPH_DISPATCH_WQ_SIZE, graph->socket,
+				RING_F_SC_DEQ);
+	if (g->wq == NULL)
+		SET_ERR_JMP(rte_errno, fail, "Failed to create ring %s", name);
+
+	snprintf(name, sizeof(name), "graph_wq_mp_%u", graph->id);
+	g->wq_mp = rte_mempool_create(name, GRAPH_DISPATCH_WQ_SIZE - 1,
+				      sizeof(struct graph_wq_node),
+				      GRAPH_DISPATCH_WQ_CACHE_SIZE, 0, NULL,
+				      NULL, NULL, NULL, graph->socket, 0);
+	if (g->wq_mp == NULL)
+		SET_ERR_JMP(rte_errno, free_wq, "Failed to create mempool %s",
+			    name);
+
+	return 0;
+free_wq:
+	rte_ring_free(g->wq);
+	g->wq = NULL;
+fail:
+	return -rte_errno;
+}
+
+int
+rte_graph_model_dispatch_core_bind(rte_graph_t id, unsigned int lcore_id)
+{
+	struct graph_dispatch_group *group;
+	struct graph *graph;
+	struct rte_graph *g;
+
+	graph_spinlock_lock();
+
+	if (lcore_id >= RTE_MAX_LCORE || !rte_lcore_is_enabled(lcore_id))
+		SET_ERR_JMP(EINVAL, fail, "Invalid lcore %u", lcore_id);
+
+	STAILQ_FOREACH(graph, graph_list_head_get(), next)
+		if (graph->id == id)
+			break;
+	if (graph == NULL)
+		SET_ERR_JMP(EINVAL, fail, "Graph %u not found", id);
+
+	if (graph->group == NULL && graph_dispatch_group_join(graph, graph))
+		goto fail;
+
+	group = graph->group;
+	g = graph->graph;
+	if (group->graphs[lcore_id] != NULL && group->graphs[lcore_id] != g)
+		SET_ERR_JMP(EEXIST, fail, "Lcore %u already bound to graph %s",
+			    lcore_id, group->graphs[lcore_id]->name);
+
+	if (graph_dispatch_wq_create(graph))
+		goto fail;
+
+	if (g->lcore_id != RTE_MAX_LCORE)
+		group->graphs[g->lcore_id] = NULL;
+	g->lcore_id = lcore_id;
+	group->graphs[lcore_id] = g;
+
+	graph_spinlock_unlock();
+	return 0;
+fail:
+	graph_spinlock_unlock();
+	return -rte_errno;
+}
+
+int
+rte_graph_model_dispatch_lcore_affinity_set(const char *name,
+					    unsigned int lcore_id)
+{
+	struct node *node;
+
+	if (name == NULL || lcore_id > RTE_MAX_LCORE)
+		return -EINVAL;
+
+	graph_spinlock_lock();
+	node = node_from_name(name);
+	if (node != NULL)
+		node->lcore_id = lcore_id;
+	graph_spinlock_unlock();
+
+	return node != NULL ? 0 : -EINVAL;
+}
+
+bool __rte_noinline
+__rte_graph_model_dispatch_node_enqueue(struct rte_graph *graph,
+					struct rte_node *node)
+{
+	struct graph_wq_node *wq_node;
+	struct rte_graph *dst = NULL;
+	uint16_t off = 0, n;
+
+	if (graph->lcore_graphs != NULL && node->lcore_id < RTE_MAX_LCORE)
+		dst = graph->lcore_graphs[node->lcore_id];
+	if (dst == NULL || dst->wq == NULL)
+		return false;
+
+	while (off < node->idx) {
+		if (rte_mempool_get(dst->wq_mp, (void **)&wq_node) < 0)
+			goto fallback;
+
+		n = RTE_MIN((uint16_t)(node->idx - off),
+			    (uint16_t)RTE_GRAPH_BURST_SIZE);
+		wq_node->node_off = node->off;
+		wq_node->nb_objs = n;
+		rte_memcpy(wq_node->objs, &node->objs[off], n * sizeof(void *));
+
+		/* The ring holds as many entries as the pool has objects */
+		while (rte_ring_mp_enqueue(dst->wq, wq_node) != 0)
+			rte_pause();
+
+		off += n;
+	}
+
+	node->idx = 0;
+	return true;
+
+fallback:
+	/* Keep the objects not handed over for local processing */
+	if (off) {
+		memmove(node->objs, &node->objs[off],
+			(node->idx - off) * sizeof(void *));
+		node->idx -= off;
+	}
+	return false;
+}
+
+void __rte_noinline
+__rte_graph_model_dispatch_wq_process(struct rte_graph *graph)
+{
+	struct graph_wq_node *wq_nodes[GRAPH_DISPATCH_WQ_BURST];
+	struct graph_wq_node *wq_node;
+	struct rte_node *node;
+	unsigned int i, n;
+	uint16_t idx;
+
+	n = rte_ring_sc_dequeue_burst(graph->wq, (void **)wq_nodes,
+				      RTE_DIM(wq_nodes), NULL);
+	if (n == 0)
+		return;
+
+	for (i = 0; i < n; i++) {
+		wq_node = wq_nodes[i];
+		node = RTE_PTR_ADD(graph, wq_node->node_off);
+		RTE_ASSERT(node->fence == RTE_GRAPH_FENCE);
+		idx = node->idx;
+
+		__rte_node_enqueue_prologue(graph, node, idx, wq_node->nb_objs);
+
+		rte_memcpy(&node->objs[idx], wq_node->objs,
+			   wq_node->nb_objs * sizeof(void *));
+		node->idx = idx + wq_node->nb_objs;
+	}
+
+	rte_mempool_put_bulk(graph->wq_mp, (void **)wq_nodes, n);
+}
@@ -8,6 +8,7 @@
 #include <rte_common.h>
 #include <rte_errno.h>
 #include <rte_malloc.h>
+#include <rte_telemetry.h>
 
 #include "graph_private.h"
 
@@ -328,6 +329,23 @@ rte_graph_cluster_stats_destroy(struct rte_graph_cluster_stats *stat)
 	return rte_free(stat);
 }
 
+static inline void
+node_stats_hist_add(struct rte_graph_cluster_node_stats *stat,
+		    const struct rte_node *node)
+{
+#ifdef RTE_LIBRTE_GRAPH_STATS_HIST
+	unsigned int i;
+
+	for (i = 0; i < RTE_GRAPH_STATS_HIST_NB_BUCKETS; i++) {
+		stat->hist_objs[i] += node->hist_objs[i];
+		stat->hist_cycles[i] += node->hist_cycles[i];
+	}
+#else
+	RTE_SET_USED(stat);
+	RTE_SET_USED(node);
+#endif
+}
+
 static inline void
 cluster_node_arregate_stats(struct cluster_node *cluster)
 {
@@ -336,6 +354,11 @@ cluster_node_arregate_stats(struct cluster_node *cluster)
 	struct rte_node *node;
 	rte_node_t count;
 
+	if (rte_graph_has_stats_hist_feature()) {
+		memset(stat->hist_objs, 0, sizeof(stat->hist_objs));
+		memset(stat->hist_cycles, 0, sizeof(stat->hist_cycles));
+	}
+
 	for (count = 0; count < cluster->nb_nodes; count++) {
 		node = cluster->nodes[count];
 
@@ -343,6 +366,7 @@ cluster_node_arregate_stats(struct cluster_node *cluster)
 		objs += node->total_objs;
 		cycles += node->total_cycles;
 		realloc_count += node->realloc_count;
+		node_stats_hist_add(stat, node);
 	}
 
 	stat->calls = calls;
@@ -404,6 +428,105 @@ rte_graph_cluster_stats_reset(struct rte_graph_cluster_stats *stat)
 		node->prev_objs = 0;
 		node->prev_cycles = 0;
 		node->realloc_count = 0;
+		memset(node->hist_objs, 0, sizeof(node->hist_objs));
+		memset(node->hist_cycles, 0, sizeof(node->hist_cycles));
 		cluster = RTE_PTR_ADD(cluster, stat->cluster_node_size);
 	}
 }
+
+static int
+graph_handle_list(const char *cmd __rte_unused, const char *params __rte_unused,
+		  struct rte_tel_data *d)
+{
+	struct graph *graph;
+
+	rte_tel_data_start_array(d, RTE_TEL_STRING_VAL);
+	graph_spinlock_lock();
+	STAILQ_FOREACH(graph, graph_list_head_get(), next)
+		rte_tel_data_add_array_string(d, graph->name);
+	graph_spinlock_unlock();
+
+	return 0;
+}
+
+static struct rte_tel_data *
+graph_tel_hist_alloc(const uint64_t *hist)
+{
+	struct rte_tel_data *h;
+	unsigned int i;
+
+	h = rte_tel_data_alloc();
+	if (h == NULL)
+		return NULL;
+
+	rte_tel_data_start_array(h, RTE_TEL_U64_VAL);
+	for (i = 0; i < RTE_GRAPH_STATS_HIST_NB_BUCKETS; i++)
+		rte_tel_data_add_array_u64(h, hist[i]);
+
+	return h;
+}
+
+static int
+graph_handle_node_stats(const char *cmd __rte_unused, const char *params,
+			struct rte_tel_data *d)
+{
+	struct rte_graph_cluster_node_stats stat;
+	struct rte_tel_data *hist_objs = NULL;
+	struct rte_tel_data *hist_cycles = NULL;
+	struct rte_node *node;
+	struct graph *graph;
+	bool found = false;
+
+	if (params == NULL || strlen(params) == 0 ||
+	    !rte_graph_has_stats_feature())
+		return -1;
+
+	/* Aggregate the stats of the node across all the graphs */
+	memset(&stat, 0, sizeof(stat));
+	graph_spinlock_lock();
+	STAILQ_FOREACH(graph, graph_list_head_get(), next) {
+		node = graph_node_name_to_ptr(graph->graph, params);
+		if (node == NULL)
+			continue;
+
+		stat.calls += node->total_calls;
+		stat.objs += node->total_objs;
+		stat.cycles += node->total_cycles;
+		stat.realloc_count += node->realloc_count;
+		node_stats_hist_add(&stat, node);
+		found = true;
+	}
+	graph_spinlock_unlock();
+
+	if (!found)
+		return -1;
+
+	rte_tel_data_start_dict(d);
+	rte_tel_data_add_dict_string(d, "name", params);
+	rte_tel_data_add_dict_u64(d, "calls", stat.calls);
+	rte_tel_data_add_dict_u64(d, "objs", stat.objs);
+	rte_tel_data_add_dict_u64(d, "cycles", stat.cycles);
+	rte_tel_data_add_dict_u64(d, "realloc_count", stat.realloc_count);
+	if (!rte_graph_has_stats_hist_feature())
+		return 0;
+
+	hist_objs = graph_tel_hist_alloc(stat.hist_objs);
+	hist_cycles = graph_tel_hist_alloc(stat.hist_cycles);
+	if (hist_objs == NULL || hist_cycles == NULL) {
+		rte_tel_data_free(hist_objs);
+		rte_tel_data_free(hist_cycles);
+		return -1;
+	}
+	rte_tel_data_add_dict_container(d, "hist_objs", hist_objs, 0);
+	rte_tel_data_add_dict_container(d, "hist_cycles", hist_cycles, 0);
+
+	return 0;
+}
+
+RTE_INIT(graph_init_telemetry)
+{
+	rte_telemetry_register_cmd("/graph/list", graph_handle_list,
+		"Returns list of available graphs. Takes no parameters");
+	rte_telemetry_register_cmd("/graph/node_stats", graph_handle_node_stats,
+		"Returns the stats of a node aggregated across all graphs, with the objs and cycles per call log2 histograms when enabled. Parameters: string node name");
+}
@@ -40,6 +40,7 @@ extern "C" {
 #define RTE_EDGE_ID_INVALID UINT16_MAX   /**< Invalid edge id. */
 #define RTE_GRAPH_ID_INVALID UINT16_MAX  /**< Invalid graph id. */
 #define RTE_GRAPH_FENCE 0xdeadbeef12345678ULL /**< Graph fence data. */
+#define RTE_GRAPH_STATS_HIST_NB_BUCKETS 24 /**< Stats histogram buckets. */
 
 typedef uint32_t rte_graph_off_t;  /**< Graph offset type. */
 typedef uint32_t rte_node_t;       /**< Node id type. */
@@ -206,6 +207,19 @@ struct rte_graph_cluster_node_stats {
 
 	uint64_t realloc_count; /**< Realloc count. */
 
+	/** Histogram of the number of objs processed per call: bucket 0 counts
+	 * the calls processing no object and bucket i > 0 the calls processing
+	 * [2^(i-1), 2^i - 1] objs. The last bucket also counts all the bigger
+	 * values. Only gathered when the stats histogram feature is enabled.
+	 *
+	 * @see rte_graph_has_stats_hist_feature()
+	 */
+	uint64_t hist_objs[RTE_GRAPH_STATS_HIST_NB_BUCKETS];
+	/** Histogram of the number of cycles spent per call, with the same
+	 * log2 buckets as *hist_objs*.
+	 */
+	uint64_t hist_cycles[RTE_GRAPH_STATS_HIST_NB_BUCKETS];
+
 	rte_node_t id;	/**< Node identifier of stats. */
 	uint64_t hz;	/**< Cycles per seconds. */
 	char name[RTE_NODE_NAMESIZE];	/**< Name of the node. */
@@ -228,6 +242,29 @@ struct rte_graph_cluster_node_stats {
 __rte_experimental
 rte_graph_t rte_graph_create(const char *name, struct rte_graph_param *prm);
 
+/**
+ * Clone Graph.
+ *
+ * Create a new graph with the same nodes and edges as an existing graph, e.g.
+ * to run one graph definition on several lcores with the dispatch model. The
+ * node init() functions are invoked for the new graph.
+ *
+ * @param id
+ *   Id of the graph to clone.
+ * @param name
+ *   Name of the clone, appended to the name of the parent graph as
+ *   "parent_name-name", which must be unique.
+ * @param socket_id
+ *   Socket id where the memory of the clone is allocated, or SOCKET_ID_ANY.
+ *
+ * @return
+ *   Unique graph id on success, RTE_GRAPH_ID_INVALID otherwise.
+ *
+ * @see rte_graph_model_dispatch_core_bind()
+ */
+__rte_experimental
+rte_graph_t rte_graph_clone(rte_graph_t id, const char *name, int socket_id);
+
 /**
  * Destroy Graph.
  *
@@ -662,6 +699,22 @@ rte_graph_has_stats_feature(void)
 #endif
 }
 
+/**
+ * Test stats histogram feature support.
+ *
+ * @return
+ *   1 if stats histograms enabled, 0 otherwise.
+ */
+static __rte_always_inline int
+rte_graph_has_stats_hist_feature(void)
+{
+#ifdef RTE_LIBRTE_GRAPH_STATS_HIST
+	return rte_graph_has_stats_feature();
+#else
+	return 0;
+#endif
+}
+
 #ifdef __cplusplus
 }
 #endif
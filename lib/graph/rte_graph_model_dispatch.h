@@ -0,0 +1,148 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2021 Marvell International Ltd.
+ */
+
+#ifndef _RTE_GRAPH_MODEL_DISPATCH_H_
+#define _RTE_GRAPH_MODEL_DISPATCH_H_
+
+/**
+ * @file rte_graph_model_dispatch.h
+ *
+ * @warning
+ * @b EXPERIMENTAL:
+ * All functions in this file may be changed or removed without prior notice.
+ *
+ * This API allows to run one graph definition across several lcores as a
+ * pipeline. The graph is cloned once per lcore with rte_graph_clone() and
+ * each graph of the group is bound to its lcore. Nodes may be given an lcore
+ * affinity, in which case their streams are handed over to the graph bound
+ * to that lcore through its lock-free work queue, in bursts of up to
+ * RTE_GRAPH_BURST_SIZE objects. Nodes without an affinity run on whichever
+ * lcore has work for them, as with rte_graph_walk().
+ */
+
+#include <stdbool.h>
+
+#include "rte_graph_worker.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @internal
+ *
+ * Hand over the pending stream of a node to the graph bound to the lcore of
+ * the node affinity.
+ *
+ * @param graph
+ *   Pointer to the graph object.
+ * @param node
+ *   Pointer to the node object.
+ *
+ * @return
+ *   True when the whole stream was handed over, false when there is no graph
+ *   bound to the lcore or its work queue is exhausted, in which case the
+ *   remaining objects are still pending in the stream of the node.
+ */
+__rte_experimental
+bool __rte_graph_model_dispatch_node_enqueue(struct rte_graph *graph,
+					     struct rte_node *node);
+
+/**
+ * @internal
+ *
+ * Move the streams received on the work queue of a graph to the pending
+ * streams of their nodes.
+ *
+ * @param graph
+ *   Pointer to the graph object.
+ */
+__rte_experimental
+void __rte_graph_model_dispatch_wq_process(struct rte_graph *graph);
+
+/**
+ * Bind a graph to an lcore for the dispatch model.
+ *
+ * The graph joins the dispatch group of the graph it was cloned from, and
+ * gets the work queue the other graphs of the group use to hand over the
+ * streams of the nodes affine to *lcore_id*. It must then be walked on that
+ * lcore with rte_graph_model_dispatch_walk().
+ *
+ * @param id
+ *   Graph id to bind.
+ * @param lcore_id
+ *   Id of an enabled lcore, not bound to another graph of the group.
+ *
+ * @return
+ *   0 on success, error otherwise.
+ */
+__rte_experimental
+int rte_graph_model_dispatch_core_bind(rte_graph_t id, unsigned int lcore_id);
+
+/**
+ * Set the lcore affinity of a node for the dispatch model.
+ *
+ * Only the graphs created or cloned after this call are affected.
+ *
+ * @param name
+ *   Name of the node.
+ * @param lcore_id
+ *   Id of the lcore that runs the node, or RTE_MAX_LCORE to let the node run
+ *   on any lcore.
+ *
+ * @return
+ *   0 on success, error otherwise.
+ */
+__rte_experimental
+int rte_graph_model_dispatch_lcore_affinity_set(const char *name,
+						unsigned int lcore_id);
+
+/**
+ * Perform graph walk on the circular buffer with the dispatch model.
+ *
+ * Same as rte_graph_walk(), except that the streams of the nodes which are
+ * affine to another lcore are handed over to the graph bound to that lcore,
+ * and the streams received from the other graphs of the group are processed
+ * first. The source nodes only run on the lcore they are affine to, if any.
+ *
+ * @param graph
+ *   Graph pointer returned from rte_graph_lookup function, bound to the
+ *   calling lcore.
+ *
+ * @see rte_graph_model_dispatch_core_bind()
+ */
+__rte_experimental
+static inline void
+rte_graph_model_dispatch_walk(struct rte_graph *graph)
+{
+	const rte_graph_off_t *cir_start = graph->cir_start;
+	const rte_node_t mask = graph->cir_mask;
+	const unsigned int lcore_id = graph->lcore_id;
+	uint32_t head = graph->head;
+	struct rte_node *node;
+
+	if (graph->wq != NULL)
+		__rte_graph_model_dispatch_wq_process(graph);
+
+	while (likely(head != graph->tail)) {
+		node = RTE_PTR_ADD(graph, cir_start[(int32_t)head++]);
+		RTE_ASSERT(node->fence == RTE_GRAPH_FENCE);
+
+		if (node->lcore_id == RTE_MAX_LCORE ||
+		    node->lcore_id == lcore_id)
+			__rte_node_process(graph, node);
+		else if ((int32_t)head > 0 && /* Not a source node */
+			 !__rte_graph_model_dispatch_node_enqueue(graph, node))
+			__rte_node_process(graph, node);
+
+		head = likely((int32_t)head > 0) ? head & mask : head;
+	}
+	graph->tail = 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_GRAPH_MODEL_DISPATCH_H_ */
@@ -28,6 +28,9 @@
 extern "C" {
 #endif
 
+struct rte_mempool;
+struct rte_ring;
+
 /**
  * @internal
  *
@@ -42,6 +45,10 @@ struct rte_graph {
 	rte_graph_off_t nodes_start; /**< Offset at which node memory starts. */
 	rte_graph_t id;	/**< Graph identifier. */
 	int socket;	/**< Socket ID where memory is allocated. */
+	unsigned int lcore_id;	/**< Lcore bound by the dispatch model. */
+	struct rte_ring *wq;	/**< Dispatch model work queue. */
+	struct rte_mempool *wq_mp; /**< Dispatch model work queue pool. */
+	struct rte_graph **lcore_graphs; /**< Dispatch model graphs by lcore. */
 	char name[RTE_GRAPH_NAMESIZE];	/**< Name of the graph. */
 	uint64_t fence;			/**< Fence. */
 } __rte_cache_aligned;
@@ -59,9 +66,16 @@ struct rte_node {
 	rte_node_t parent_id;	/**< Parent Node identifier. */
 	rte_edge_t nb_edges;	/**< Number of edges from this node. */
 	uint32_t realloc_count;	/**< Number of times realloced. */
+	unsigned int lcore_id;	/**< Lcore affinity of the dispatch model. */
 
 	char parent[RTE_NODE_NAMESIZE];	/**< Parent node name. */
 	char name[RTE_NODE_NAMESIZE];	/**< Name of the node. */
+#ifdef RTE_LIBRTE_GRAPH_STATS_HIST
+	/** Histogram of objs processed per call. */
+	uint64_t hist_objs[RTE_GRAPH_STATS_HIST_NB_BUCKETS];
+	/** Histogram of cycles spent per call. */
+	uint64_t hist_cycles[RTE_GRAPH_STATS_HIST_NB_BUCKETS];
+#endif
 
 	/* Fast path area  */
 #define RTE_NODE_CTX_SZ 16
@@ -118,6 +132,68 @@ __rte_experimental
 void __rte_node_stream_alloc_size(struct rte_graph *graph,
 				  struct rte_node *node, uint16_t req_size);
 
+/**
+ * @internal
+ *
+ * Update the stats histograms of a node, when enabled.
+ *
+ * @param node
+ *   Pointer to the node object.
+ * @param objs
+ *   Number of objects processed by the call.
+ * @param cycles
+ *   Number of cycles spent by the call.
+ */
+static __rte_always_inline void
+__rte_node_stats_hist_update(struct rte_node *node, uint16_t objs,
+			     uint64_t cycles)
+{
+#ifdef RTE_LIBRTE_GRAPH_STATS_HIST
+	const int last = RTE_GRAPH_STATS_HIST_NB_BUCKETS - 1;
+
+	node->hist_objs[RTE_MIN(rte_fls_u32(objs), last)]++;
+	node->hist_cycles[RTE_MIN(rte_fls_u64(cycles), last)]++;
+#else
+	RTE_SET_USED(node);
+	RTE_SET_USED(objs);
+	RTE_SET_USED(cycles);
+#endif
+}
+
+/**
+ * @internal
+ *
+ * Invoke the process function of a node on its pending stream, collect the
+ * stats and reset the stream.
+ *
+ * @param graph
+ *   Pointer to the graph object.
+ * @param node
+ *   Pointer to the node object.
+ */
+static __rte_always_inline void
+__rte_node_process(struct rte_graph *graph, struct rte_node *node)
+{
+	void **objs = node->objs;
+	uint64_t start, cycles;
+	uint16_t rc;
+
+	rte_prefetch0(objs);
+
+	if (rte_graph_has_stats_feature()) {
+		start = rte_rdtsc();
+		rc = node->process(graph, node, objs, node->idx);
+		cycles = rte_rdtsc() - start;
+		node->total_cycles += cycles;
+		node->total_calls++;
+		node->total_objs += rc;
+		__rte_node_stats_hist_update(node, rc, cycles);
+	} else {
+		node->process(graph, node, objs, node->idx);
+	}
+	node->idx = 0;
+}
+
 /**
  * Perform graph walk on the circular buffer and invoke the process function
  * of the nodes and collect the stats.
@@ -135,9 +211,6 @@ rte_graph_walk(struct rte_graph *graph)
 	const rte_node_t mask = graph->cir_mask;
 	uint32_t head = graph->head;
 	struct rte_node *node;
-	uint64_t start;
-	uint16_t rc;
-	void **objs;
 
 	/*
 	 * Walk on the source node(s) ((cir_start - head) -> cir_start) and then
@@ -157,19 +230,7 @@ rte_graph_walk(struct rte_graph *graph)
 	while (likely(head != graph->tail)) {
 		node = RTE_PTR_ADD(graph, cir_start[(int32_t)head++]);
 		RTE_ASSERT(node->fence == RTE_GRAPH_FENCE);
-		objs = node->objs;
-		rte_prefetch0(objs);
-
-		if (rte_graph_has_stats_feature()) {
-			start = rte_rdtsc();
-			rc = node->process(graph, node, objs, node->idx);
-			node->total_cycles += rte_rdtsc() - start;
-			node->total_calls++;
-			node->total_objs += rc;
-		} else {
-			node->process(graph, node, objs, node->idx);
-		}
-		node->idx = 0;
+		__rte_node_process(graph, node);
 		head = likely((int32_t)head > 0) ? head & mask : head;
 	}
 	graph->tail = 0;
@@ -0,0 +1,248 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2017 Intel Corporation
+ */
+
+#ifndef _GRO_TCP_H_
+#define _GRO_TCP_H_
+
+#include <rte_ip.h>
+#include <rte_jhash.h>
+#include <rte_tcp.h>
+#include <rte_vxlan.h>
+
+#define INVALID_ARRAY_INDEX 0xffffffffUL
+
+/*
+ * The max length of a IPv4 packet, which includes the length of the L3
+ * header, the L4 header and the data payload. It is also used to bound
+ * the payload of merged IPv6 packets.
+ */
+#define MAX_IPV4_PKT_LENGTH UINT16_MAX
+
+/* The maximum TCP header length */
+#define MAX_TCP_HLEN 60
+#define INVALID_TCP_HDRLEN(len) \
+	(((len) < sizeof(struct rte_tcp_hdr)) || ((len) > MAX_TCP_HLEN))
+
+/*
+ * Slot of the open addressing hash used to find the flow of a packet
+ * without scanning the whole flow array. The hash is kept in the slot,
+ * so that most of the probes don't need to touch the flow keys.
+ */
+struct gro_tcp_flow_slot {
+	uint32_t hash;
+	/* INVALID_ARRAY_INDEX indicates an empty slot */
+	uint32_t flow_idx;
+};
+
+/*
+ * Number of hash slots for a table of max_flow_num flows. Keeping the
+ * hash at most half full bounds the length of the probe sequences.
+ */
+#define GRO_TCP_FLOW_SLOT_NUM(max_flow_num) \
+	rte_align32pow2(RTE_MAX((max_flow_num) * 2, 2U))
+
+struct gro_tcp_item {
+	/*
+	 * The first MBUF segment of the packet. If the value
+	 * is NULL, it means the item is empty.
+	 */
+	struct rte_mbuf *firstseg;
+	/* The last MBUF segment of the packet */
+	struct rte_mbuf *lastseg;
+	/*
+	 * The time when the first packet is inserted into the table.
+	 * This value won't be updated, even if the packet is merged
+	 * with other packets.
+	 */
+	uint64_t start_time;
+	/*
+	 * next_pkt_idx is used to chain the packets that
+	 * are in the same flow but can't be merged together
+	 * (e.g. caused by packet reordering).
+	 */
+	uint32_t next_pkt_idx;
+	/* TCP sequence number of the packet */
+	uint32_t sent_seq;
+	/* IPv4 ID of the packet */
+	uint16_t ip_id;
+	/* the number of merged packets */
+	uint16_t nb_merged;
+	/* Indicate if IPv4 ID can be ignored, always set for IPv6 */
+	uint8_t is_atomic;
+};
+
+static inline void
+gro_tcp_flow_slots_init(struct gro_tcp_flow_slot *slots, uint32_t slot_num)
+{
+	uint32_t i;
+
+	for (i = 0; i < slot_num; i++)
+		slots[i].flow_idx = INVALID_ARRAY_INDEX;
+}
+
+/*
+ * Use the RSS hash computed by the NIC when there is one, so that
+ * only packets without it pay for a software hash of the addresses
+ * and ports.
+ */
+static inline uint32_t
+gro_tcp_flow_hash(const struct rte_mbuf *pkt, const void *addrs,
+		uint32_t addrs_len, uint16_t src_port, uint16_t dst_port)
+{
+	if (pkt->ol_flags & PKT_RX_RSS_HASH)
+		return pkt->hash.rss;
+
+	return rte_jhash(addrs, addrs_len,
+			((uint32_t)src_port << 16) | dst_port);
+}
+
+static inline void
+gro_tcp_flow_slot_add(struct gro_tcp_flow_slot *slots, uint32_t mask,
+		uint32_t hash, uint32_t flow_idx)
+{
+	uint32_t i = hash & mask;
+
+	while (slots[i].flow_idx != INVALID_ARRAY_INDEX)
+		i = (i + 1) & mask;
+
+	slots[i].hash = hash;
+	slots[i].flow_idx = flow_idx;
+}
+
+/*
+ * Remove a flow from the hash. The following slots of the probe
+ * sequence are moved back, rather than leaving a tombstone, so that
+ * lookups never get slower as flows come and go.
+ */
+static inline void
+gro_tcp_flow_slot_del(struct gro_tcp_flow_slot *slots, uint32_t mask,
+		uint32_t hash, uint32_t flow_idx)
+{
+	uint32_t i, j, home;
+
+	for (i = hash & mask; slots[i].flow_idx != flow_idx;
+			i = (i + 1) & mask)
+		if (slots[i].flow_idx == INVALID_ARRAY_INDEX)
+			return;
+
+	for (j = (i + 1) & mask; slots[j].flow_idx != INVALID_ARRAY_INDEX;
+			j = (j + 1) & mask) {
+		home = slots[j].hash & mask;
+		/* skip the entry if its home slot is cyclically in (i, j] */
+		if (((j - home) & mask) < ((j - i) & mask))
+			continue;
+		slots[i] = slots[j];
+		i = j;
+	}
+	slots[i].flow_idx = INVALID_ARRAY_INDEX;
+}
+
+/*
+ * Merge two TCP packets without updating checksums.
+ * If cmp is larger than 0, append the new packet to the
+ * original packet. Otherwise, pre-pend the new packet to
+ * the original packet.
+ */
+static inline int
+merge_two_tcp_packets(struct gro_tcp_item *item,
+		struct rte_mbuf *pkt,
+		int cmp,
+		uint32_t sent_seq,
+		uint16_t ip_id,
+		uint16_t l2_offset)
+{
+	struct rte_mbuf *pkt_head, *pkt_tail, *lastseg;
+	uint16_t hdr_len, l2_len;
+
+	if (cmp > 0) {
+		pkt_head = item->firstseg;
+		pkt_tail = pkt;
+	} else {
+		pkt_head = pkt;
+		pkt_tail = item->firstseg;
+	}
+
+	/* check if the IPv4 packet length is greater than the max value */
+	hdr_len = l2_offset + pkt_head->l2_len + pkt_head->l3_len +
+		pkt_head->l4_len;
+	l2_len = l2_offset > 0 ? pkt_head->outer_l2_len : pkt_head->l2_len;
+	if (unlikely(pkt_head->pkt_len - l2_len + pkt_tail->pkt_len -
+				hdr_len > MAX_IPV4_PKT_LENGTH))
+		return 0;
+
+	/* remove the packet header for the tail packet */
+	rte_pktmbuf_adj(pkt_tail, hdr_len);
+
+	/* chain two packets together */
+	if (cmp > 0) {
+		item->lastseg->next = pkt;
+		item->lastseg = rte_pktmbuf_lastseg(pkt);
+		/* update IP ID to the larger value */
+		item->ip_id = ip_id;
+	} else {
+		lastseg = rte_pktmbuf_lastseg(pkt);
+		lastseg->next = item->firstseg;
+		item->firstseg = pkt;
+		/* update sent_seq to the smaller value */
+		item->sent_seq = sent_seq;
+		item->ip_id = ip_id;
+	}
+	item->nb_merged++;
+
+	/* update MBUF metadata for the merged packet */
+	pkt_head->nb_segs += pkt_tail->nb_segs;
+	pkt_head->pkt_len += pkt_tail->pkt_len;
+
+	return 1;
+}
+
+/*
+ * Check if two TCP packets are neighbors.
+ */
+static inline int
+check_seq_option(struct gro_tcp_item *item,
+		struct rte_tcp_hdr *tcph,
+		uint32_t sent_seq,
+		uint16_t ip_id,
+		uint16_t tcp_hl,
+		uint16_t tcp_dl,
+		uint16_t l2_offset,
+		uint8_t is_atomic)
+{
+	struct rte_mbuf *pkt_orig = item->firstseg;
+	char *iph_orig;
+	struct rte_tcp_hdr *tcph_orig;
+	uint16_t len, tcp_hl_orig;
+
+	iph_orig = rte_pktmbuf_mtod(pkt_orig, char *) +
+			l2_offset + pkt_orig->l2_len;
+	tcph_orig = (struct rte_tcp_hdr *)(iph_orig + pkt_orig->l3_len);
+	tcp_hl_orig = pkt_orig->l4_len;
+
+	/* Check if TCP option fields equal */
+	len = RTE_MAX(tcp_hl, tcp_hl_orig) - sizeof(struct rte_tcp_hdr);
+	if ((tcp_hl != tcp_hl_orig) || ((len > 0) &&
+				(memcmp(tcph + 1, tcph_orig + 1,
+					len) != 0)))
+		return 0;
+
+	/* Don't merge packets whose DF bits are different */
+	if (unlikely(item->is_atomic ^ is_atomic))
+		return 0;
+
+	/* check if the two packets are neighbors */
+	len = pkt_orig->pkt_len - l2_offset - pkt_orig->l2_len -
+		pkt_orig->l3_len - tcp_hl_orig;
+	if ((sent_seq == item->sent_seq + len) && (is_atomic ||
+				(ip_id == item->ip_id + 1)))
+		/* append the new packet */
+		return 1;
+	else if ((sent_seq + tcp_dl == item->sent_seq) && (is_atomic ||
+				(ip_id + item->nb_merged == item->ip_id)))
+		/* pre-pend the new packet */
+		return -1;
+
+	return 0;
+}
+#endif
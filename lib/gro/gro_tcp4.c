@@ -31,7 +31,7 @@ gro_tcp4_tbl_create(uint16_t socket_id,
 	if (tbl == NULL)
 		return NULL;
 
-	size = sizeof(struct gro_tcp4_item) * entries_num;
+	size = sizeof(struct gro_tcp_item) * entries_num;
 	tbl->items = rte_zmalloc_socket(__func__,
 			size,
 			RTE_CACHE_LINE_SIZE,
@@ -57,6 +57,22 @@ gro_tcp4_tbl_create(uint16_t socket_id,
 		tbl->flows[i].start_index = INVALID_ARRAY_INDEX;
 	tbl->max_flow_num = entries_num;
 
+	size = sizeof(struct gro_tcp_flow_slot) *
+		GRO_TCP_FLOW_SLOT_NUM(entries_num);
+	tbl->flow_slots = rte_malloc_socket(__func__,
+			size,
+			RTE_CACHE_LINE_SIZE,
+			socket_id);
+	if (tbl->flow_slots == NULL) {
+		rte_free(tbl->flows);
+		rte_free(tbl->items);
+		rte_free(tbl);
+		return NULL;
+	}
+	gro_tcp_flow_slots_init(tbl->flow_slots,
+			GRO_TCP_FLOW_SLOT_NUM(entries_num));
+	tbl->flow_slot_mask = GRO_TCP_FLOW_SLOT_NUM(entries_num) - 1;
+
 	return tbl;
 }
 
@@ -68,6 +84,7 @@ gro_tcp4_tbl_destroy(void *tbl)
 	if (tcp_tbl) {
 		rte_free(tcp_tbl->items);
 		rte_free(tcp_tbl->flows);
+		rte_free(tcp_tbl->flow_slots);
 	}
 	rte_free(tcp_tbl);
 }
@@ -149,6 +166,7 @@ delete_item(struct gro_tcp4_tbl *tbl, uint32_t item_idx,
 static inline uint32_t
 insert_new_flow(struct gro_tcp4_tbl *tbl,
 		struct tcp4_flow_key *src,
+		uint32_t hash,
 		uint32_t item_idx)
 {
 	struct tcp4_flow_key *dst;
@@ -168,8 +186,11 @@ insert_new_flow(struct gro_tcp4_tbl *tbl,
 	dst->src_port = src->src_port;
 	dst->dst_port = src->dst_port;
 
+	tbl->flows[flow_idx].hash = hash;
 	tbl->flows[flow_idx].start_index = item_idx;
 	tbl->flow_num++;
+	gro_tcp_flow_slot_add(tbl->flow_slots, tbl->flow_slot_mask, hash,
+			flow_idx);
 
 	return flow_idx;
 }
@@ -178,7 +199,7 @@ insert_new_flow(struct gro_tcp4_tbl *tbl,
  * update the packet length for the flushed packet.
  */
 static inline void
-update_header(struct gro_tcp4_item *item)
+update_header(struct gro_tcp_item *item)
 {
 	struct rte_ipv4_hdr *ipv4_hdr;
 	struct rte_mbuf *pkt = item->firstseg;
@@ -204,7 +225,7 @@ gro_tcp4_reassemble(struct rte_mbuf *pkt,
 
 	struct tcp4_flow_key key;
 	uint32_t cur_idx, prev_idx, item_idx;
-	uint32_t i, max_flow_num, remaining_flow_num;
+	uint32_t i, slot, hash;
 	int cmp;
 	uint8_t find;
 
@@ -252,16 +273,18 @@ gro_tcp4_reassemble(struct rte_mbuf *pkt,
 	key.recv_ack = tcp_hdr->recv_ack;
 
 	/* Search for a matched flow. */
-	max_flow_num = tbl->max_flow_num;
-	remaining_flow_num = tbl->flow_num;
+	hash = gro_tcp_flow_hash(pkt, &key.ip_src_addr,
+			sizeof(key.ip_src_addr) + sizeof(key.ip_dst_addr),
+			key.src_port, key.dst_port);
 	find = 0;
-	for (i = 0; i < max_flow_num && remaining_flow_num; i++) {
-		if (tbl->flows[i].start_index != INVALID_ARRAY_INDEX) {
-			if (is_same_tcp4_flow(tbl->flows[i].key, key)) {
-				find = 1;
-				break;
-			}
-			remaining_flow_num--;
+	for (slot = hash & tbl->flow_slot_mask;
+			tbl->flow_slots[slot].flow_idx != INVALID_ARRAY_INDEX;
+			slot = (slot + 1) & tbl->flow_slot_mask) {
+		i = tbl->flow_slots[slot].flow_idx;
+		if (tbl->flow_slots[slot].hash == hash &&
+				is_same_tcp4_flow(tbl->flows[i].key, key)) {
+			find = 1;
+			break;
 		}
 	}
 
@@ -275,7 +298,7 @@ gro_tcp4_reassemble(struct rte_mbuf *pkt,
 				is_atomic);
 		if (item_idx == INVALID_ARRAY_INDEX)
 			return -1;
-		if (insert_new_flow(tbl, &key, item_idx) ==
+		if (insert_new_flow(tbl, &key, hash, item_idx) ==
 				INVALID_ARRAY_INDEX) {
 			/*
 			 * Fail to insert a new flow, so delete the
@@ -298,7 +321,7 @@ gro_tcp4_reassemble(struct rte_mbuf *pkt,
 				sent_seq, ip_id, pkt->l4_len, tcp_dl, 0,
 				is_atomic);
 		if (cmp) {
-			if (merge_two_tcp4_packets(&(tbl->items[cur_idx]),
+			if (merge_two_tcp_packets(&(tbl->items[cur_idx]),
 						pkt, cmp, sent_seq, ip_id, 0))
 				return 1;
 			/*
@@ -350,8 +373,12 @@ gro_tcp4_tbl_timeout_flush(struct gro_tcp4_tbl *tbl,
 				 */
 				j = delete_item(tbl, j, INVALID_ARRAY_INDEX);
 				tbl->flows[i].start_index = j;
-				if (j == INVALID_ARRAY_INDEX)
+				if (j == INVALID_ARRAY_INDEX) {
 					tbl->flow_num--;
+					gro_tcp_flow_slot_del(tbl->flow_slots,
+						tbl->flow_slot_mask,
+						tbl->flows[i].hash, i);
+				}
 
 				if (unlikely(k == nb_out))
 					return k;
@@ -38,6 +38,51 @@ free_gso_segment(struct rte_mbuf **pkts, uint16_t nb_pkts)
 		rte_pktmbuf_free(pkts[i]);
 }
 
+/*
+ * Walk the input packet the same way gso_do_segment() does and count the
+ * output segments, i.e. the direct mbufs, and the payload pieces, i.e. the
+ * indirect mbufs, it is going to be divided into.
+ */
+static inline uint16_t
+gso_count_segments(struct rte_mbuf *pkt, uint16_t pkt_hdr_offset,
+		uint16_t pyld_unit_size, uint16_t nb_pkts_out,
+		uint32_t *nb_pylds)
+{
+	struct rte_mbuf *pkt_in = pkt;
+	uint16_t pkt_in_data_pos = pkt_hdr_offset;
+	uint16_t segment_bytes_remaining, pyld_len;
+	uint16_t nb_segs = 0;
+	uint32_t nb_pieces = 0;
+
+	while (pkt_in != NULL) {
+		/* Not enough room in pkts_out, no need to go any further */
+		if (unlikely(nb_segs >= nb_pkts_out)) {
+			*nb_pylds = 0;
+			return UINT16_MAX;
+		}
+
+		segment_bytes_remaining = pyld_unit_size;
+		while (segment_bytes_remaining != 0 && pkt_in != NULL) {
+			pyld_len = segment_bytes_remaining;
+			if (pyld_len + pkt_in_data_pos > pkt_in->data_len)
+				pyld_len = pkt_in->data_len - pkt_in_data_pos;
+
+			pkt_in_data_pos += pyld_len;
+			segment_bytes_remaining -= pyld_len;
+			nb_pieces++;
+
+			if (pkt_in_data_pos == pkt_in->data_len) {
+				pkt_in = pkt_in->next;
+				pkt_in_data_pos = 0;
+			}
+		}
+		nb_segs++;
+	}
+
+	*nb_pylds = nb_pieces;
+	return nb_segs;
+}
+
 int
 gso_do_segment(struct rte_mbuf *pkt,
 		uint16_t pkt_hdr_offset,
@@ -47,29 +92,36 @@ gso_do_segment(struct rte_mbuf *pkt,
 		struct rte_mbuf **pkts_out,
 		uint16_t nb_pkts_out)
 {
+	struct rte_mbuf *pylds[GSO_PYLD_BULK_NUM];
 	struct rte_mbuf *pkt_in;
 	struct rte_mbuf *hdr_segment, *pyld_segment, *prev_segment;
 	uint16_t pkt_in_data_pos, segment_bytes_remaining;
-	uint16_t pyld_len, nb_segs;
+	uint16_t pyld_len, nb_segs, nb_hdrs;
+	uint32_t nb_pylds, pyld_idx, pyld_num;
 	bool more_in_pkt, more_out_segs;
 
+	if (unlikely(pyld_unit_size == 0))
+		return -EINVAL;
+
+	nb_hdrs = gso_count_segments(pkt, pkt_hdr_offset, pyld_unit_size,
+			nb_pkts_out, &nb_pylds);
+	if (unlikely(nb_hdrs > nb_pkts_out))
+		return -EINVAL;
+
+	/* Allocate all the direct MBUFs at once */
+	if (unlikely(rte_pktmbuf_alloc_bulk(direct_pool, pkts_out,
+			nb_hdrs) != 0))
+		return -ENOMEM;
+
 	pkt_in = pkt;
 	nb_segs = 0;
+	pyld_idx = 0;
+	pyld_num = 0;
 	more_in_pkt = 1;
 	pkt_in_data_pos = pkt_hdr_offset;
 
 	while (more_in_pkt) {
-		if (unlikely(nb_segs >= nb_pkts_out)) {
-			free_gso_segment(pkts_out, nb_segs);
-			return -EINVAL;
-		}
-
-		/* Allocate a direct MBUF */
-		hdr_segment = rte_pktmbuf_alloc(direct_pool);
-		if (unlikely(hdr_segment == NULL)) {
-			free_gso_segment(pkts_out, nb_segs);
-			return -ENOMEM;
-		}
+		hdr_segment = pkts_out[nb_segs];
 		/* Fill the packet header */
 		hdr_segment_init(hdr_segment, pkt, pkt_hdr_offset);
 
@@ -78,13 +130,20 @@ gso_do_segment(struct rte_mbuf *pkt,
 		more_out_segs = 1;
 
 		while (more_out_segs && more_in_pkt) {
-			/* Allocate an indirect MBUF */
-			pyld_segment = rte_pktmbuf_alloc(indirect_pool);
-			if (unlikely(pyld_segment == NULL)) {
-				rte_pktmbuf_free(hdr_segment);
-				free_gso_segment(pkts_out, nb_segs);
-				return -ENOMEM;
+			/* Allocate the next indirect MBUFs in bulk */
+			if (pyld_idx == pyld_num) {
+				pyld_num = RTE_MIN(nb_pylds,
+						(uint32_t)GSO_PYLD_BULK_NUM);
+				if (unlikely(rte_pktmbuf_alloc_bulk(indirect_pool,
+						pylds, pyld_num) != 0)) {
+					/* also releases the attached ones */
+					free_gso_segment(pkts_out, nb_hdrs);
+					return -ENOMEM;
+				}
+				nb_pylds -= pyld_num;
+				pyld_idx = 0;
 			}
+			pyld_segment = pylds[pyld_idx++];
 			/* Attach to current MBUF segment of pkt */
 			rte_pktmbuf_attach(pyld_segment, pkt_in);
 
@@ -118,7 +177,7 @@ gso_do_segment(struct rte_mbuf *pkt,
 			if (segment_bytes_remaining == 0)
 				more_out_segs = 0;
 		}
-		pkts_out[nb_segs++] = hdr_segment;
+		nb_segs++;
 	}
 	return nb_segs;
 }
@@ -0,0 +1,105 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <rte_random.h>
+
+#include "gso_common.h"
+#include "gso_udp6.h"
+
+static inline void
+update_ipv6_udp_headers(struct rte_mbuf *pkt, struct rte_mbuf **segs,
+		uint16_t nb_segs)
+{
+	struct rte_ipv6_hdr *ipv6_hdr;
+	struct rte_ipv6_fragment_ext *frag_hdr;
+	uint16_t frag_offset = 0, is_mf;
+	uint16_t l2_hdrlen = pkt->l2_len, l3_hdrlen = pkt->l3_len;
+	uint16_t tail_idx = nb_segs - 1, length, i;
+	uint8_t proto;
+	uint32_t id;
+
+	ipv6_hdr = rte_pktmbuf_mtod_offset(pkt, struct rte_ipv6_hdr *,
+			l2_hdrlen);
+	proto = ipv6_hdr->proto;
+	/* All the fragments of one datagram share the same ID */
+	id = rte_cpu_to_be_32((uint32_t)rte_rand());
+
+	/*
+	 * Insert a fragment header right after the copied IPv6 header of
+	 * each output segment, and update the payload length.
+	 */
+	for (i = 0; i < nb_segs; i++) {
+		frag_hdr = rte_pktmbuf_mtod_offset(segs[i],
+			struct rte_ipv6_fragment_ext *, segs[i]->data_len);
+		segs[i]->data_len += RTE_IPV6_FRAG_HDR_SIZE;
+		segs[i]->pkt_len += RTE_IPV6_FRAG_HDR_SIZE;
+		segs[i]->l3_len = l3_hdrlen + RTE_IPV6_FRAG_HDR_SIZE;
+
+		ipv6_hdr = rte_pktmbuf_mtod_offset(segs[i],
+			struct rte_ipv6_hdr *, l2_hdrlen);
+		length = segs[i]->pkt_len - l2_hdrlen - l3_hdrlen;
+		ipv6_hdr->payload_len = rte_cpu_to_be_16(length);
+		ipv6_hdr->proto = IPPROTO_FRAGMENT;
+
+		is_mf = i < tail_idx ? 1 : 0;
+		frag_hdr->next_header = proto;
+		frag_hdr->reserved = 0;
+		frag_hdr->frag_data = rte_cpu_to_be_16(
+			RTE_IPV6_SET_FRAG_DATA(frag_offset, is_mf));
+		frag_hdr->id = id;
+		frag_offset += length - RTE_IPV6_FRAG_HDR_SIZE;
+	}
+}
+
+int
+gso_udp6_segment(struct rte_mbuf *pkt,
+		uint16_t gso_size,
+		struct rte_mempool *direct_pool,
+		struct rte_mempool *indirect_pool,
+		struct rte_mbuf **pkts_out,
+		uint16_t nb_pkts_out)
+{
+	uint16_t pyld_unit_size, hdr_offset;
+	int ret;
+
+	/*
+	 * Don't process the packet with extension headers, which includes
+	 * the already fragmented one.
+	 */
+	if (unlikely(pkt->l3_len != sizeof(struct rte_ipv6_hdr)))
+		return 0;
+
+	/*
+	 * UDP fragmentation is the same as IP fragmentation.
+	 * Except the first one, other output packets just have l2
+	 * and l3 headers.
+	 */
+	hdr_offset = pkt->l2_len + pkt->l3_len;
+
+	/* Don't process the packet without data. */
+	if (unlikely(hdr_offset + pkt->l4_len >= pkt->pkt_len))
+		return 0;
+
+	/* The header segments need room for the fragment header */
+	if (unlikely(gso_size < hdr_offset + RTE_IPV6_FRAG_HDR_SIZE +
+			RTE_IPV6_EHDR_FO_ALIGN ||
+			rte_pktmbuf_data_room_size(direct_pool) <
+			RTE_PKTMBUF_HEADROOM + hdr_offset +
+			RTE_IPV6_FRAG_HDR_SIZE))
+		return -EINVAL;
+
+	/* pyld_unit_size must be a multiple of 8 because the fragment
+	 * offset uses 8 bytes as unit.
+	 */
+	pyld_unit_size = (gso_size - hdr_offset - RTE_IPV6_FRAG_HDR_SIZE) &
+		~(RTE_IPV6_EHDR_FO_ALIGN - 1);
+
+	/* Segment the payload */
+	ret = gso_do_segment(pkt, hdr_offset, pyld_unit_size, direct_pool,
+			indirect_pool, pkts_out, nb_pkts_out);
+	if (ret > 1)
+		update_ipv6_udp_headers(pkt, pkts_out, ret);
+
+	return ret;
+}
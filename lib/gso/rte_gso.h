@@ -78,13 +78,16 @@ struct rte_gso_ctx {
  * Before calling rte_gso_segment(), applications must set proper ol_flags
  * for the packet. The GSO library uses the same macros as that of TSO.
  * For example, set PKT_TX_TCP_SEG and PKT_TX_IPV4 in ol_flags to segment
- * a TCP/IPv4 packet. If rte_gso_segment() succeeds, the PKT_TX_TCP_SEG
+ * a TCP/IPv4 packet, or PKT_TX_TCP_SEG and PKT_TX_IPV6 for a TCP/IPv6
+ * one. If rte_gso_segment() succeeds, the PKT_TX_TCP_SEG
  * flag is removed for all GSO segments and the input packet.
  *
  * Each of the newly-created GSO segments is organized as a two-segment
  * MBUF, where the first segment is a standard MBUF, which stores a copy
  * of packet header, and the second is an indirect MBUF which points to
- * a section of data in the input packet. Since each GSO segment has
+ * a section of data in the input packet. The direct and the indirect
+ * MBUFs of all the GSO segments are allocated with one bulk request to
+ * each MBUF pool. Since each GSO segment has
  * multiple MBUFs (i.e. typically 2 MBUFs), the driver of the interface which
  * the GSO segments are sent to should support transmission of multi-segment
  * packets.
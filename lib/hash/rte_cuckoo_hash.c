@@ -38,7 +38,9 @@
 				   RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY | \
 				   RTE_HASH_EXTRA_FLAGS_EXT_TABLE |	\
 				   RTE_HASH_EXTRA_FLAGS_NO_FREE_ON_DEL | \
-				   RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF)
+				   RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF | \
+				   RTE_HASH_EXTRA_FLAGS_RESIZABLE | \
+				   RTE_HASH_EXTRA_FLAGS_KEY_SLOT_ALIGN)
 
 #define FOR_EACH_BUCKET(CURRENT_BKT, START_BUCKET)                            \
 	for (CURRENT_BKT = START_BUCKET;                                      \
@@ -93,6 +95,7 @@ void rte_hash_set_cmp_func(struct rte_hash *h, rte_hash_cmp_eq_t func)
 {
 	h->cmp_jump_table_idx = KEY_CUSTOM;
 	h->rte_hash_custom_cmp_eq = func;
+	h->spec_key_len = 0;
 }
 
 static inline int
@@ -104,6 +107,78 @@ rte_hash_cmp_eq(const void *key1, const void *key2, const struct rte_hash *h)
 		return cmp_jump_table[h->cmp_jump_table_idx](key1, key2, h->key_len);
 }
 
+/*
+ * Compare keys whose length is known at compile time, without going
+ * through the compare function table. A key_len of 0 uses the table.
+ */
+static __rte_always_inline int
+rte_hash_cmp_eq_spec(const void *key1, const void *key2,
+		const struct rte_hash *h, const uint32_t key_len)
+{
+	switch (key_len) {
+	case 0:
+		return rte_hash_cmp_eq(key1, key2, h);
+	case 8:
+		return *(const unaligned_uint64_t *)key1 !=
+			*(const unaligned_uint64_t *)key2;
+#if defined(RTE_ARCH_X86) || defined(RTE_ARCH_ARM64)
+	case 16:
+		return rte_hash_k16_cmp_eq(key1, key2, key_len);
+	case 32:
+		return rte_hash_k32_cmp_eq(key1, key2, key_len);
+	case 40:
+		return rte_hash_k32_cmp_eq(key1, key2, 32) ||
+			*(const unaligned_uint64_t *)
+				((const char *)key1 + 32) !=
+			*(const unaligned_uint64_t *)
+				((const char *)key2 + 32);
+	case 64:
+		return rte_hash_k64_cmp_eq(key1, key2, key_len);
+#endif
+	default:
+		return memcmp(key1, key2, key_len);
+	}
+}
+
+/*
+ * Hash a key whose length is known at compile time, inlining the CRC32
+ * hash if it is the hash function of the table.
+ */
+static __rte_always_inline hash_sig_t
+rte_hash_hash_spec(const struct rte_hash *h, const void *key,
+		const uint32_t key_len)
+{
+	if (key_len != 0 && h->hash_crc)
+		return rte_hash_crc(key, key_len, h->hash_func_init_val);
+	return h->hash_func(key, h->key_len, h->hash_func_init_val);
+}
+
+/*
+ * Call a bulk lookup body specialized for the key length of the table,
+ * given as last argument.
+ */
+#define HASH_BULK_LOOKUP_SPEC(h, fn, ...) do {		\
+	switch ((h)->spec_key_len) {			\
+	case 8:						\
+		fn(__VA_ARGS__, 8);			\
+		break;					\
+	case 16:					\
+		fn(__VA_ARGS__, 16);			\
+		break;					\
+	case 32:					\
+		fn(__VA_ARGS__, 32);			\
+		break;					\
+	case 40:					\
+		fn(__VA_ARGS__, 40);			\
+		break;					\
+	case 64:					\
+		fn(__VA_ARGS__, 64);			\
+		break;					\
+	default:					\
+		fn(__VA_ARGS__, 0);			\
+	}						\
+} while (0)
+
 /*
  * We use higher 16 bits of hash as the signature value stored in table.
  * We use the lower bits for the primary bucket
@@ -158,6 +233,7 @@ rte_hash_create(const struct rte_hash_parameters *params)
 	uint32_t *tbl_chng_cnt = NULL;
 	struct lcore_cache *local_free_slots = NULL;
 	unsigned int readwrite_concur_lf_support = 0;
+	unsigned int resizable = 0;
 	uint32_t i;
 
 	rte_hash_function default_hash_func = (rte_hash_function)rte_jhash;
@@ -193,6 +269,15 @@ rte_hash_create(const struct rte_hash_parameters *params)
 		return NULL;
 	}
 
+	if ((params->extra_flag & RTE_HASH_EXTRA_FLAGS_RESIZABLE) &&
+	    (params->extra_flag & (RTE_HASH_EXTRA_FLAGS_EXT_TABLE |
+				   RTE_HASH_EXTRA_FLAGS_MULTI_WRITER_ADD))) {
+		rte_errno = EINVAL;
+		RTE_LOG(ERR, HASH, "rte_hash_create: resizable table does not "
+			"support ext table or multi writer\n");
+		return NULL;
+	}
+
 	/* Check extra flags field to check extra options. */
 	if (params->extra_flag & RTE_HASH_EXTRA_FLAGS_TRANS_MEM_SUPPORT)
 		hw_trans_mem_support = 1;
@@ -222,6 +307,9 @@ rte_hash_create(const struct rte_hash_parameters *params)
 		no_free_on_del = 1;
 	}
 
+	if (params->extra_flag & RTE_HASH_EXTRA_FLAGS_RESIZABLE)
+		resizable = 1;
+
 	/* Store all keys and leave the first entry as a dummy entry for lookup_bulk */
 	if (use_local_cache)
 		/*
@@ -243,8 +331,13 @@ rte_hash_create(const struct rte_hash_parameters *params)
 		goto err;
 	}
 
-	const uint32_t num_buckets = rte_align32pow2(params->entries) /
+	const uint32_t max_buckets = rte_align32pow2(params->entries) /
 						RTE_HASH_BUCKET_ENTRIES;
+	/* A resizable table starts small and grows up to max_buckets */
+	const uint32_t num_buckets = resizable ?
+			RTE_MIN(max_buckets,
+				(uint32_t)RTE_HASH_RESIZE_MIN_BUCKETS) :
+			max_buckets;
 
 	/* Create ring for extendable buckets. */
 	if (ext_table_support) {
@@ -331,9 +424,17 @@ rte_hash_create(const struct rte_hash_parameters *params)
 		}
 	}
 
-	const uint32_t key_entry_size =
+	uint32_t key_entry_size =
 		RTE_ALIGN(sizeof(struct rte_hash_key) + params->key_len,
 			  KEY_ALIGNMENT);
+	/* Key store is cache line aligned, keep each slot in one line */
+	if (params->extra_flag & RTE_HASH_EXTRA_FLAGS_KEY_SLOT_ALIGN) {
+		if (key_entry_size <= RTE_CACHE_LINE_SIZE)
+			key_entry_size = rte_align32pow2(key_entry_size);
+		else
+			key_entry_size = RTE_ALIGN(key_entry_size,
+						   RTE_CACHE_LINE_SIZE);
+	}
 	const uint64_t key_tbl_size = (uint64_t) key_entry_size * num_key_slots;
 
 	k = rte_zmalloc_socket(NULL, key_tbl_size,
@@ -435,6 +536,21 @@ rte_hash_create(const struct rte_hash_parameters *params)
 	h->writer_takes_lock = writer_takes_lock;
 	h->no_free_on_del = no_free_on_del;
 	h->readwrite_concur_lf_support = readwrite_concur_lf_support;
+	h->resizable = resizable;
+	h->max_buckets = max_buckets;
+	h->hash_crc = h->hash_func == (rte_hash_function)rte_hash_crc;
+	switch (params->key_len) {
+	case 8:
+	case 16:
+	case 32:
+	case 40:
+	case 64:
+		h->spec_key_len = params->key_len;
+		break;
+	default:
+		h->spec_key_len = 0;
+	}
+	h->socket_id = params->socket_id;
 
 #if defined(RTE_ARCH_X86)
 	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_SSE2))
@@ -525,6 +641,7 @@ rte_hash_free(struct rte_hash *h)
 	rte_free(h->key_store);
 	rte_free(h->buckets);
 	rte_free(h->buckets_ext);
+	rte_free(h->buckets_old);
 	rte_free(h->tbl_chng_cnt);
 	rte_free(h->ext_bkt_to_free);
 	rte_free(h);
@@ -632,6 +749,10 @@ rte_hash_reset(struct rte_hash *h)
 			RTE_LOG(ERR, HASH, "RCU reclaim all resources failed\n");
 	}
 
+	/* Drop an ongoing resize, the table is emptied anyway */
+	rte_free(h->buckets_old);
+	h->buckets_old = NULL;
+
 	memset(h->buckets, 0, h->num_buckets * sizeof(struct rte_hash_bucket));
 	memset(h->key_store, 0, h->key_entry_size * (h->entries + 1));
 	*h->tbl_chng_cnt = 0;
@@ -1004,6 +1125,320 @@ alloc_slot(const struct rte_hash *h, struct lcore_cache *cached_free_slots)
 	return slot_id;
 }
 
+static int
+free_slot(const struct rte_hash *h, uint32_t slot_id)
+{
+	unsigned lcore_id, n_slots;
+	struct lcore_cache *cached_free_slots = NULL;
+
+	/* Return key indexes to free slot ring */
+	if (h->use_local_cache) {
+		lcore_id = rte_lcore_id();
+		cached_free_slots = &h->local_free_slots[lcore_id];
+		/* Cache full, need to free it. */
+		if (cached_free_slots->len == LCORE_CACHE_SIZE) {
+			/* Need to enqueue the free slots in global ring. */
+			n_slots = rte_ring_mp_enqueue_burst_elem(h->free_slots,
+						cached_free_slots->objs,
+						sizeof(uint32_t),
+						LCORE_CACHE_SIZE, NULL);
+			RETURN_IF_TRUE((n_slots == 0), -EFAULT);
+			cached_free_slots->len -= n_slots;
+		}
+	}
+
+	enqueue_slot_back(h, cached_free_slots, slot_id);
+	return 0;
+}
+
+/*
+ * Resizable bucket array (RTE_HASH_EXTRA_FLAGS_RESIZABLE).
+ *
+ * Growing doubles the bucket array. Old bucket b splits into new buckets
+ * b and b + num_buckets_old: an entry lands in the new bucket matching its
+ * role (primary or secondary), so a split never overflows as long as no
+ * other entry is pushed into a new bucket whose old bucket has not been
+ * migrated yet. Writers migrate the old buckets of the key they touch plus
+ * a few more in order; cuckoo displacement is not used until the migration
+ * is complete. Readers search the new array, then the old one.
+ *
+ * Shrinking halves the bucket array at once, see rte_hash_resize().
+ *
+ * All of this needs a single writer, serialized by the writer lock if
+ * readers take the read lock. Lock-free readers are waited for with the
+ * RCU QSBR variable of the table before a bucket array or mask they may
+ * still use is replaced or freed.
+ */
+
+/* h is const in the public API, resizing updates it */
+static inline struct rte_hash *
+rsz_hash(const struct rte_hash *h)
+{
+	return (struct rte_hash *)((uintptr_t)h);
+}
+
+static inline void
+rsz_sync_readers(const struct rte_hash *h)
+{
+	if (h->readwrite_concur_lf_support)
+		rte_rcu_qsbr_synchronize(h->hash_rcu_cfg->v,
+					 RTE_QSBR_THRID_INVALID);
+}
+
+/* Inform lock-free readers that entries moved between bucket arrays */
+static inline void
+rsz_table_changed(const struct rte_hash *h)
+{
+	if (h->readwrite_concur_lf_support) {
+		/* Since there is one writer, load acquires on
+		 * tbl_chng_cnt are not required.
+		 */
+		__atomic_store_n(h->tbl_chng_cnt,
+				 *h->tbl_chng_cnt + 1,
+				 __ATOMIC_RELEASE);
+		/* The following stores should not move above the store
+		 * to tbl_chng_cnt.
+		 */
+		__atomic_thread_fence(__ATOMIC_RELEASE);
+	}
+}
+
+/* Full hash of the key stored at key_idx */
+static inline hash_sig_t
+rsz_key_hash(const struct rte_hash *h, uint32_t key_idx)
+{
+	const struct rte_hash_key *k = (const struct rte_hash_key *)
+		((const char *)h->key_store + key_idx * h->key_entry_size);
+
+	return rte_hash_hash(h, k->key);
+}
+
+/* Put an entry in the first empty slot of a bucket, no cuckoo move */
+static inline int
+rsz_bucket_insert(struct rte_hash_bucket *bkt, uint16_t sig,
+		  uint32_t key_idx)
+{
+	unsigned int i;
+
+	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
+		if (bkt->key_idx[i] == EMPTY_SLOT) {
+			bkt->sig_current[i] = sig;
+			/* Release the new bucket entry */
+			__atomic_store_n(&bkt->key_idx[i], key_idx,
+					 __ATOMIC_RELEASE);
+			return 0;
+		}
+	}
+	return -1;
+}
+
+/* Split one old bucket into the new bucket array */
+static void
+rsz_migrate_bucket(struct rte_hash *h, uint32_t bkt_idx)
+{
+	struct rte_hash_bucket *old_bkt = &h->buckets_old[bkt_idx];
+	uint32_t prim_idx, dst_idx;
+	hash_sig_t hash;
+	unsigned int i;
+	int moved = 0;
+
+	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
+		if (old_bkt->key_idx[i] == EMPTY_SLOT)
+			continue;
+
+		hash = rsz_key_hash(h, old_bkt->key_idx[i]);
+		prim_idx = get_prim_bucket_index(h, hash);
+		if ((hash & h->bucket_bitmask_old) == bkt_idx)
+			dst_idx = prim_idx;
+		else
+			dst_idx = get_alt_bucket_index(h, prim_idx,
+						old_bkt->sig_current[i]);
+		/* Only entries of this old bucket go to dst_idx */
+		rsz_bucket_insert(&h->buckets[dst_idx],
+				  old_bkt->sig_current[i],
+				  old_bkt->key_idx[i]);
+		moved = 1;
+	}
+
+	if (!moved)
+		return;
+
+	/* The entries are now present in both arrays */
+	rsz_table_changed(h);
+
+	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
+		old_bkt->sig_current[i] = NULL_SIGNATURE;
+		__atomic_store_n(&old_bkt->key_idx[i], EMPTY_SLOT,
+				 __ATOMIC_RELEASE);
+	}
+}
+
+/*
+ * Migrate up to nb_buckets old buckets in order and release the old array
+ * once done. Returns the number of old buckets left to migrate.
+ */
+static uint32_t
+rsz_migrate(struct rte_hash *h, uint32_t nb_buckets)
+{
+	struct rte_hash_bucket *old = h->buckets_old;
+
+	if (old == NULL)
+		return 0;
+
+	while (nb_buckets-- > 0 && h->resize_next < h->num_buckets_old)
+		rsz_migrate_bucket(h, h->resize_next++);
+
+	if (h->resize_next < h->num_buckets_old)
+		return h->num_buckets_old - h->resize_next;
+
+	/* Readers that saw the old array must be done with it */
+	__atomic_store_n(&h->buckets_old, NULL, __ATOMIC_RELEASE);
+	rsz_sync_readers(h);
+	rte_free(old);
+
+	return 0;
+}
+
+/*
+ * Called by writers before looking at the buckets of a key: move the old
+ * buckets the key may live in, so that the key is in the new array, then
+ * advance the migration cursor.
+ */
+static inline void
+rsz_migrate_key(const struct rte_hash *h, hash_sig_t sig)
+{
+	struct rte_hash *hm = rsz_hash(h);
+	uint32_t prim_idx, sec_idx;
+
+	if (h->buckets_old == NULL)
+		return;
+
+	prim_idx = sig & h->bucket_bitmask_old;
+	sec_idx = (prim_idx ^ get_short_sig(sig)) & h->bucket_bitmask_old;
+	rsz_migrate_bucket(hm, prim_idx);
+	rsz_migrate_bucket(hm, sec_idx);
+	rsz_migrate(hm, RTE_HASH_RESIZE_STEP_BUCKETS);
+}
+
+static inline int
+rsz_allowed(const struct rte_hash *h)
+{
+	/* Lock-free readers can only be waited for through RCU */
+	return !h->readwrite_concur_lf_support || h->hash_rcu_cfg != NULL;
+}
+
+/* Publish a bucket array twice as large and start migrating to it */
+static int
+rsz_grow_start(struct rte_hash *h)
+{
+	uint32_t num_buckets = h->num_buckets << 1;
+	struct rte_hash_bucket *buckets;
+
+	if (h->buckets_old != NULL || num_buckets > h->max_buckets ||
+			!rsz_allowed(h))
+		return -ENOSPC;
+
+	buckets = rte_zmalloc_socket(NULL,
+				num_buckets * sizeof(struct rte_hash_bucket),
+				RTE_CACHE_LINE_SIZE, h->socket_id);
+	if (buckets == NULL)
+		return -ENOMEM;
+
+	h->num_buckets_old = h->num_buckets;
+	h->bucket_bitmask_old = h->bucket_bitmask;
+	h->resize_next = 0;
+	__atomic_store_n(&h->buckets_old, h->buckets, __ATOMIC_RELEASE);
+	/* Indexes computed with the old mask stay within the new array */
+	__atomic_store_n(&h->buckets, buckets, __ATOMIC_RELEASE);
+	rsz_sync_readers(h);
+
+	h->num_buckets = num_buckets;
+	__atomic_store_n(&h->bucket_bitmask, num_buckets - 1,
+			 __ATOMIC_RELEASE);
+	/* No reader may look at the new array with the old mask anymore
+	 * once entries start moving.
+	 */
+	rsz_sync_readers(h);
+
+	return 0;
+}
+
+static int
+rsz_grow(const struct rte_hash *h)
+{
+	int ret;
+
+	__hash_rw_writer_lock(h);
+	ret = rsz_grow_start(rsz_hash(h));
+	__hash_rw_writer_unlock(h);
+
+	return ret;
+}
+
+/* Replace the bucket array by one of num_buckets, smaller, buckets */
+static int
+rsz_shrink(struct rte_hash *h, uint32_t num_buckets)
+{
+	struct rte_hash_bucket *buckets, *old = h->buckets;
+	uint32_t mask = num_buckets - 1;
+	uint32_t b, first, second, key_idx;
+	hash_sig_t hash;
+	uint16_t sig;
+	unsigned int i;
+
+	buckets = rte_zmalloc_socket(NULL,
+				num_buckets * sizeof(struct rte_hash_bucket),
+				RTE_CACHE_LINE_SIZE, h->socket_id);
+	if (buckets == NULL)
+		return -ENOMEM;
+
+	/* Fill the new array privately, each entry in the bucket matching
+	 * its current role if possible, its alternative bucket otherwise.
+	 */
+	for (b = 0; b < h->num_buckets; b++) {
+		for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
+			key_idx = old[b].key_idx[i];
+			if (key_idx == EMPTY_SLOT)
+				continue;
+
+			sig = old[b].sig_current[i];
+			hash = rsz_key_hash(h, key_idx);
+			first = hash & mask;
+			second = (first ^ sig) & mask;
+			if ((hash & h->bucket_bitmask) != b) {
+				/* Currently in its secondary bucket */
+				second = first;
+				first = (first ^ sig) & mask;
+			}
+
+			if (rsz_bucket_insert(&buckets[first], sig,
+					      key_idx) != 0 &&
+			    rsz_bucket_insert(&buckets[second], sig,
+					      key_idx) != 0) {
+				rte_free(buckets);
+				return -ENOSPC;
+			}
+		}
+	}
+
+	h->num_buckets_old = h->num_buckets;
+	h->bucket_bitmask_old = h->bucket_bitmask;
+	__atomic_store_n(&h->buckets_old, old, __ATOMIC_RELEASE);
+	/* Indexes computed with the new mask stay within the old array */
+	__atomic_store_n(&h->bucket_bitmask, mask, __ATOMIC_RELEASE);
+	rsz_sync_readers(h);
+
+	h->num_buckets = num_buckets;
+	__atomic_store_n(&h->buckets, buckets, __ATOMIC_RELEASE);
+	/* Readers that found neither array current must retry */
+	rsz_table_changed(h);
+	__atomic_store_n(&h->buckets_old, NULL, __ATOMIC_RELEASE);
+	rsz_sync_readers(h);
+	rte_free(old);
+
+	return 0;
+}
+
 static inline int32_t
 __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 						hash_sig_t sig, void *data)
@@ -1022,6 +1457,12 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 	struct rte_hash_bucket *last;
 
 	short_sig = get_short_sig(sig);
+restart:
+	if (unlikely(h->resizable)) {
+		__hash_rw_writer_lock(h);
+		rsz_migrate_key(h, sig);
+		__hash_rw_writer_unlock(h);
+	}
 	prim_bucket_idx = get_prim_bucket_index(h, sig);
 	sec_bucket_idx = get_alt_bucket_index(h, prim_bucket_idx, short_sig);
 	prim_bkt = &h->buckets[prim_bucket_idx];
@@ -1089,6 +1530,20 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 		return ret_val;
 	}
 
+	/* Cuckoo moves are not possible while the table grows, they could
+	 * fill buckets that old entries still have to be migrated to.
+	 * Try the secondary bucket, otherwise complete the migration first.
+	 */
+	if (unlikely(h->resizable && h->buckets_old != NULL)) {
+		__hash_rw_writer_lock(h);
+		ret = rsz_bucket_insert(sec_bkt, short_sig, slot_id);
+		if (ret != 0)
+			rsz_migrate(rsz_hash(h), UINT32_MAX);
+		__hash_rw_writer_unlock(h);
+		if (ret == 0)
+			return slot_id - 1;
+	}
+
 	/* Primary bucket full, need to make space for new entry */
 	ret = rte_hash_cuckoo_make_space_mw(h, prim_bkt, sec_bkt, key, data,
 				short_sig, prim_bucket_idx, slot_id, &ret_val);
@@ -1113,6 +1568,9 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 	/* if ext table not enabled, we failed the insertion */
 	if (!h->ext_table_support) {
 		enqueue_slot_back(h, cached_free_slots, slot_id);
+		/* Double the number of buckets and try again */
+		if (h->resizable && rsz_grow(h) == 0)
+			goto restart;
 		return ret;
 	}
 
@@ -1240,6 +1698,165 @@ rte_hash_add_key_data(const struct rte_hash *h, const void *key, void *data)
 		return ret;
 }
 
+/* Insert the key in a free entry of its primary or secondary bucket,
+ * without moving other keys. Writer is expected to hold the lock.
+ */
+static inline int
+insert_free_entry(struct rte_hash_bucket *prim_bkt,
+		  struct rte_hash_bucket *sec_bkt, uint16_t sig,
+		  uint32_t slot_id)
+{
+	struct rte_hash_bucket *bkt[2] = {prim_bkt, sec_bkt};
+	unsigned int b, i;
+
+	for (b = 0; b < RTE_DIM(bkt); b++) {
+		for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
+			if (bkt[b]->key_idx[i] != EMPTY_SLOT)
+				continue;
+			bkt[b]->sig_current[i] = sig;
+			/* Store to signature and key should not leak
+			 * after the store to key_idx. i.e. key_idx is
+			 * the guard variable for signature and key.
+			 */
+			__atomic_store_n(&bkt[b]->key_idx[i], slot_id,
+					 __ATOMIC_RELEASE);
+			return 0;
+		}
+	}
+
+	return -1;
+}
+
+static inline void
+__rte_hash_add_bulk(const struct rte_hash *h, const void **keys,
+		    hash_sig_t *sig, uint32_t num_keys, void **data,
+		    int32_t *positions)
+{
+	uint32_t prim_bucket_idx, sec_bucket_idx;
+	struct rte_hash_bucket *prim_bkt, *sec_bkt, *cur_bkt;
+	struct rte_hash_key *new_k;
+	struct lcore_cache *cached_free_slots = NULL;
+	uint32_t slot_id[RTE_HASH_LOOKUP_BULK_MAX];
+	uint16_t short_sig[RTE_HASH_LOOKUP_BULK_MAX];
+	uint64_t slow_mask = 0, free_mask = 0;
+	void *pdata;
+	uint32_t i;
+	int32_t ret;
+
+	/* Prefetch the buckets of the whole burst */
+	for (i = 0; i < num_keys; i++) {
+		short_sig[i] = get_short_sig(sig[i]);
+		prim_bucket_idx = get_prim_bucket_index(h, sig[i]);
+		sec_bucket_idx = get_alt_bucket_index(h, prim_bucket_idx,
+						      short_sig[i]);
+		rte_prefetch0(&h->buckets[prim_bucket_idx]);
+		rte_prefetch0(&h->buckets[sec_bucket_idx]);
+	}
+
+	/* Get the slots and copy the keys before taking the lock */
+	if (h->use_local_cache)
+		cached_free_slots = &h->local_free_slots[rte_lcore_id()];
+	for (i = 0; i < num_keys; i++) {
+		slot_id[i] = alloc_slot(h, cached_free_slots);
+		if (slot_id[i] == EMPTY_SLOT) {
+			/* Reclaiming is left to the single key path */
+			slow_mask |= 1ULL << i;
+			continue;
+		}
+		new_k = RTE_PTR_ADD(h->key_store,
+				    slot_id[i] * h->key_entry_size);
+		pdata = data != NULL ? data[i] : NULL;
+		/* The store to application data at *data should not leak
+		 * after the store of pdata in the key store.
+		 */
+		__atomic_store_n(&new_k->pdata, pdata, __ATOMIC_RELEASE);
+		memcpy(new_k->key, keys[i], h->key_len);
+	}
+
+	__hash_rw_writer_lock(h);
+	for (i = 0; i < num_keys; i++) {
+		if (slow_mask & (1ULL << i))
+			continue;
+
+		if (unlikely(h->resizable))
+			rsz_migrate_key(h, sig[i]);
+		prim_bucket_idx = get_prim_bucket_index(h, sig[i]);
+		sec_bucket_idx = get_alt_bucket_index(h, prim_bucket_idx,
+						      short_sig[i]);
+		prim_bkt = &h->buckets[prim_bucket_idx];
+		sec_bkt = &h->buckets[sec_bucket_idx];
+		pdata = data != NULL ? data[i] : NULL;
+
+		/* A key already inserted, possibly earlier in the burst,
+		 * only gets its data updated.
+		 */
+		ret = search_and_update(h, pdata, keys[i], prim_bkt,
+					short_sig[i]);
+		if (ret == -1) {
+			FOR_EACH_BUCKET(cur_bkt, sec_bkt) {
+				ret = search_and_update(h, pdata, keys[i],
+							cur_bkt, short_sig[i]);
+				if (ret != -1)
+					break;
+			}
+		}
+		if (ret != -1) {
+			positions[i] = ret;
+			free_mask |= 1ULL << i;
+			continue;
+		}
+
+		if (insert_free_entry(prim_bkt, sec_bkt, short_sig[i],
+				      slot_id[i]) == 0) {
+			positions[i] = slot_id[i] - 1;
+			continue;
+		}
+
+		/* Cuckoo moves, extendable buckets or growing the table */
+		free_mask |= 1ULL << i;
+		slow_mask |= 1ULL << i;
+	}
+	__hash_rw_writer_unlock(h);
+
+	/* The burst may have taken more slots than the cache can hold */
+	while (free_mask) {
+		i = __builtin_ctzll(free_mask);
+		free_slot(h, slot_id[i]);
+		free_mask &= ~(1ULL << i);
+	}
+
+	while (slow_mask) {
+		i = __builtin_ctzll(slow_mask);
+		positions[i] = __rte_hash_add_key_with_hash(h, keys[i], sig[i],
+				data != NULL ? data[i] : NULL);
+		slow_mask &= ~(1ULL << i);
+	}
+}
+
+int
+rte_hash_add_bulk(const struct rte_hash *h, const void **keys,
+		  uint32_t num_keys, void **data, int32_t *positions)
+{
+	hash_sig_t sig[RTE_HASH_LOOKUP_BULK_MAX];
+	uint32_t i;
+	int added = 0;
+
+	RETURN_IF_TRUE(((h == NULL) || (keys == NULL) || (num_keys == 0) ||
+			(num_keys > RTE_HASH_LOOKUP_BULK_MAX) ||
+			(positions == NULL)), -EINVAL);
+
+	for (i = 0; i < num_keys; i++)
+		sig[i] = rte_hash_hash(h, keys[i]);
+
+	__rte_hash_add_bulk(h, keys, sig, num_keys, data, positions);
+
+	for (i = 0; i < num_keys; i++)
+		if (positions[i] >= 0)
+			added++;
+
+	return added;
+}
+
 /* Search one bucket to find the match key - uses rw lock */
 static inline int32_t
 search_one_bucket_l(const struct rte_hash *h, const void *key,
@@ -1409,11 +2026,81 @@ __rte_hash_lookup_with_hash_lf(const struct rte_hash *h, const void *key,
 	return -ENOENT;
 }
 
+/* Search a key in one bucket array of a resizable table */
+static inline int32_t
+search_buckets_rsz(const struct rte_hash *h, const void *key, hash_sig_t sig,
+		void **data, const struct rte_hash_bucket *bkts,
+		uint32_t bitmask)
+{
+	uint16_t short_sig = get_short_sig(sig);
+	uint32_t prim_bucket_idx = sig & bitmask;
+	uint32_t sec_bucket_idx = (prim_bucket_idx ^ short_sig) & bitmask;
+	int32_t ret;
+
+	if (h->readwrite_concur_lf_support) {
+		ret = search_one_bucket_lf(h, key, short_sig, data,
+					&bkts[prim_bucket_idx]);
+		if (ret == -1)
+			ret = search_one_bucket_lf(h, key, short_sig, data,
+						&bkts[sec_bucket_idx]);
+	} else {
+		ret = search_one_bucket_l(h, key, short_sig, data,
+					&bkts[prim_bucket_idx]);
+		if (ret == -1)
+			ret = search_one_bucket_l(h, key, short_sig, data,
+						&bkts[sec_bucket_idx]);
+	}
+	return ret;
+}
+
+static inline int32_t
+__rte_hash_lookup_with_hash_rsz(const struct rte_hash *h, const void *key,
+				hash_sig_t sig, void **data)
+{
+	const struct rte_hash_bucket *bkts;
+	uint32_t cnt_b, cnt_a, bitmask;
+	int32_t ret;
+
+	__hash_rw_reader_lock(h);
+	do {
+		cnt_b = __atomic_load_n(h->tbl_chng_cnt, __ATOMIC_ACQUIRE);
+
+		/* The bucket array is loaded before its mask, a reader
+		 * never sees a mask larger than the array it searches.
+		 */
+		bkts = __atomic_load_n(&h->buckets, __ATOMIC_ACQUIRE);
+		bitmask = __atomic_load_n(&h->bucket_bitmask, __ATOMIC_ACQUIRE);
+		ret = search_buckets_rsz(h, key, sig, data, bkts, bitmask);
+		if (ret != -1)
+			break;
+
+		/* Keys not migrated yet are still in the old array */
+		bkts = __atomic_load_n(&h->buckets_old, __ATOMIC_ACQUIRE);
+		if (bkts != NULL) {
+			ret = search_buckets_rsz(h, key, sig, data, bkts,
+						 h->bucket_bitmask_old);
+			if (ret != -1)
+				break;
+		}
+
+		/* The loads of sig_current in search_one_bucket
+		 * should not move below the load from tbl_chng_cnt.
+		 */
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		cnt_a = __atomic_load_n(h->tbl_chng_cnt, __ATOMIC_ACQUIRE);
+	} while (cnt_b != cnt_a);
+	__hash_rw_reader_unlock(h);
+
+	return ret != -1 ? ret : -ENOENT;
+}
+
 static inline int32_t
 __rte_hash_lookup_with_hash(const struct rte_hash *h, const void *key,
 					hash_sig_t sig, void **data)
 {
-	if (h->readwrite_concur_lf_support)
+	if (unlikely(h->resizable))
+		return __rte_hash_lookup_with_hash_rsz(h, key, sig, data);
+	else if (h->readwrite_concur_lf_support)
 		return __rte_hash_lookup_with_hash_lf(h, key, sig, data);
 	else
 		return __rte_hash_lookup_with_hash_l(h, key, sig, data);
@@ -1449,32 +2136,6 @@ rte_hash_lookup_data(const struct rte_hash *h, const void *key, void **data)
 	return __rte_hash_lookup_with_hash(h, key, rte_hash_hash(h, key), data);
 }
 
-static int
-free_slot(const struct rte_hash *h, uint32_t slot_id)
-{
-	unsigned lcore_id, n_slots;
-	struct lcore_cache *cached_free_slots = NULL;
-
-	/* Return key indexes to free slot ring */
-	if (h->use_local_cache) {
-		lcore_id = rte_lcore_id();
-		cached_free_slots = &h->local_free_slots[lcore_id];
-		/* Cache full, need to free it. */
-		if (cached_free_slots->len == LCORE_CACHE_SIZE) {
-			/* Need to enqueue the free slots in global ring. */
-			n_slots = rte_ring_mp_enqueue_burst_elem(h->free_slots,
-						cached_free_slots->objs,
-						sizeof(uint32_t),
-						LCORE_CACHE_SIZE, NULL);
-			RETURN_IF_TRUE((n_slots == 0), -EFAULT);
-			cached_free_slots->len -= n_slots;
-		}
-	}
-
-	enqueue_slot_back(h, cached_free_slots, slot_id);
-	return 0;
-}
-
 static void
 __hash_rcu_qsbr_free_resource(void *p, void *e, unsigned int n)
 {
@@ -1578,6 +2239,61 @@ rte_hash_rcu_qsbr_add(struct rte_hash *h, struct rte_hash_rcu_config *cfg)
 	return 0;
 }
 
+int
+rte_hash_resize(struct rte_hash *h, uint32_t entries)
+{
+	uint32_t num_buckets;
+	int ret = 0;
+
+	RETURN_IF_TRUE((h == NULL), -EINVAL);
+	if (!h->resizable)
+		return -ENOTSUP;
+	if (!rsz_allowed(h))
+		return -EINVAL;
+
+	num_buckets = rte_align32pow2(RTE_MAX(entries,
+				(uint32_t)RTE_HASH_BUCKET_ENTRIES)) /
+			RTE_HASH_BUCKET_ENTRIES;
+	num_buckets = RTE_MAX(num_buckets, RTE_MIN(h->max_buckets,
+				(uint32_t)RTE_HASH_RESIZE_MIN_BUCKETS));
+	num_buckets = RTE_MIN(num_buckets, h->max_buckets);
+
+	__hash_rw_writer_lock(h);
+	rsz_migrate(h, UINT32_MAX);
+	while (ret == 0 && h->num_buckets < num_buckets) {
+		ret = rsz_grow_start(h);
+		rsz_migrate(h, UINT32_MAX);
+	}
+	if (ret == 0 && h->num_buckets > num_buckets)
+		ret = rsz_shrink(h, num_buckets);
+	__hash_rw_writer_unlock(h);
+
+	return ret;
+}
+
+int32_t
+rte_hash_resize_step(struct rte_hash *h, uint32_t nb_buckets)
+{
+	int32_t ret;
+
+	RETURN_IF_TRUE((h == NULL), -EINVAL);
+	if (!h->resizable)
+		return -ENOTSUP;
+
+	__hash_rw_writer_lock(h);
+	ret = rsz_migrate(h, nb_buckets);
+	__hash_rw_writer_unlock(h);
+
+	return ret;
+}
+
+int32_t
+rte_hash_bucket_count(const struct rte_hash *h)
+{
+	RETURN_IF_TRUE((h == NULL), -EINVAL);
+	return h->num_buckets;
+}
+
 static inline void
 remove_entry(const struct rte_hash *h, struct rte_hash_bucket *bkt,
 		unsigned int i)
@@ -1676,9 +2392,10 @@ search_and_remove(const struct rte_hash *h, const void *key,
 	return -1;
 }
 
+/* Writer is expected to hold the lock while calling this function. */
 static inline int32_t
-__rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
-						hash_sig_t sig)
+__rte_hash_del_key_locked(const struct rte_hash *h, const void *key,
+			  hash_sig_t sig)
 {
 	uint32_t prim_bucket_idx, sec_bucket_idx;
 	struct rte_hash_bucket *prim_bkt, *sec_bkt, *prev_bkt, *last_bkt;
@@ -1690,11 +2407,13 @@ __rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
 	struct __rte_hash_rcu_dq_entry rcu_dq_entry;
 
 	short_sig = get_short_sig(sig);
+
+	if (unlikely(h->resizable))
+		rsz_migrate_key(h, sig);
 	prim_bucket_idx = get_prim_bucket_index(h, sig);
 	sec_bucket_idx = get_alt_bucket_index(h, prim_bucket_idx, short_sig);
 	prim_bkt = &h->buckets[prim_bucket_idx];
 
-	__hash_rw_writer_lock(h);
 	/* look for key in primary bucket */
 	ret = search_and_remove(h, key, prim_bkt, short_sig, &pos);
 	if (ret != -1) {
@@ -1717,7 +2436,6 @@ __rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
 		}
 	}
 
-	__hash_rw_writer_unlock(h);
 	return -ENOENT;
 
 /* Search last bucket to see if empty to be recycled */
@@ -1777,7 +2495,19 @@ __rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
 			if (rte_rcu_qsbr_dq_enqueue(h->dq, &rcu_dq_entry) != 0)
 				RTE_LOG(ERR, HASH, "Failed to push QSBR FIFO\n");
 	}
+	return ret;
+}
+
+static inline int32_t
+__rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
+						hash_sig_t sig)
+{
+	int32_t ret;
+
+	__hash_rw_writer_lock(h);
+	ret = __rte_hash_del_key_locked(h, key, sig);
 	__hash_rw_writer_unlock(h);
+
 	return ret;
 }
 
@@ -1796,6 +2526,39 @@ rte_hash_del_key(const struct rte_hash *h, const void *key)
 	return __rte_hash_del_key_with_hash(h, key, rte_hash_hash(h, key));
 }
 
+int
+rte_hash_del_bulk(const struct rte_hash *h, const void **keys,
+		  uint32_t num_keys, int32_t *positions)
+{
+	hash_sig_t sig[RTE_HASH_LOOKUP_BULK_MAX];
+	uint32_t prim_bucket_idx, sec_bucket_idx, i;
+	int deleted = 0;
+
+	RETURN_IF_TRUE(((h == NULL) || (keys == NULL) || (num_keys == 0) ||
+			(num_keys > RTE_HASH_LOOKUP_BULK_MAX) ||
+			(positions == NULL)), -EINVAL);
+
+	/* Prefetch the buckets of the whole burst */
+	for (i = 0; i < num_keys; i++) {
+		sig[i] = rte_hash_hash(h, keys[i]);
+		prim_bucket_idx = get_prim_bucket_index(h, sig[i]);
+		sec_bucket_idx = get_alt_bucket_index(h, prim_bucket_idx,
+						      get_short_sig(sig[i]));
+		rte_prefetch0(&h->buckets[prim_bucket_idx]);
+		rte_prefetch0(&h->buckets[sec_bucket_idx]);
+	}
+
+	__hash_rw_writer_lock(h);
+	for (i = 0; i < num_keys; i++) {
+		positions[i] = __rte_hash_del_key_locked(h, keys[i], sig[i]);
+		if (positions[i] >= 0)
+			deleted++;
+	}
+	__hash_rw_writer_unlock(h);
+
+	return deleted;
+}
+
 int
 rte_hash_get_key_with_position(const struct rte_hash *h, const int32_t position,
 			       void **key)
@@ -1900,12 +2663,12 @@ compare_signatures(uint32_t *prim_hash_matches, uint32_t *sec_hash_matches,
 	}
 }
 
-static inline void
+static __rte_always_inline void
 __bulk_lookup_l(const struct rte_hash *h, const void **keys,
 		const struct rte_hash_bucket **primary_bkt,
 		const struct rte_hash_bucket **secondary_bkt,
 		uint16_t *sig, int32_t num_keys, int32_t *positions,
-		uint64_t *hit_mask, void *data[])
+		uint64_t *hit_mask, void *data[], const uint32_t key_len)
 {
 	uint64_t hits = 0;
 	int32_t i;
@@ -1969,8 +2732,9 @@ __bulk_lookup_l(const struct rte_hash *h, const void **keys,
 			 * as it is checking the dummy slot
 			 */
 			if (!!key_idx &
-				!rte_hash_cmp_eq(
-					key_slot->key, keys[i], h)) {
+				!rte_hash_cmp_eq_spec(
+					key_slot->key, keys[i], h,
+					key_len)) {
 				if (data != NULL)
 					data[i] = key_slot->pdata;
 
@@ -1998,8 +2762,9 @@ __bulk_lookup_l(const struct rte_hash *h, const void **keys,
 			 */
 
 			if (!!key_idx &
-				!rte_hash_cmp_eq(
-					key_slot->key, keys[i], h)) {
+				!rte_hash_cmp_eq_spec(
+					key_slot->key, keys[i], h,
+					key_len)) {
 				if (data != NULL)
 					data[i] = key_slot->pdata;
 
@@ -2047,12 +2812,12 @@ __bulk_lookup_l(const struct rte_hash *h, const void **keys,
 		*hit_mask = hits;
 }
 
-static inline void
+static __rte_always_inline void
 __bulk_lookup_lf(const struct rte_hash *h, const void **keys,
 		const struct rte_hash_bucket **primary_bkt,
 		const struct rte_hash_bucket **secondary_bkt,
 		uint16_t *sig, int32_t num_keys, int32_t *positions,
-		uint64_t *hit_mask, void *data[])
+		uint64_t *hit_mask, void *data[], const uint32_t key_len)
 {
 	uint64_t hits = 0;
 	int32_t i;
@@ -2127,8 +2892,9 @@ __bulk_lookup_lf(const struct rte_hash *h, const void **keys,
 				 * as it is checking the dummy slot
 				 */
 				if (!!key_idx &
-					!rte_hash_cmp_eq(
-						key_slot->key, keys[i], h)) {
+					!rte_hash_cmp_eq_spec(
+						key_slot->key, keys[i], h,
+						key_len)) {
 					if (data != NULL)
 						data[i] = __atomic_load_n(
 							&key_slot->pdata,
@@ -2160,8 +2926,9 @@ __bulk_lookup_lf(const struct rte_hash *h, const void **keys,
 				 */
 
 				if (!!key_idx &
-					!rte_hash_cmp_eq(
-						key_slot->key, keys[i], h)) {
+					!rte_hash_cmp_eq_spec(
+						key_slot->key, keys[i], h,
+						key_len)) {
 					if (data != NULL)
 						data[i] = __atomic_load_n(
 							&key_slot->pdata,
@@ -2227,12 +2994,13 @@ __bulk_lookup_lf(const struct rte_hash *h, const void **keys,
 }
 
 #define PREFETCH_OFFSET 4
-static inline void
+static __rte_always_inline void
 __bulk_lookup_prefetching_loop(const struct rte_hash *h,
 	const void **keys, int32_t num_keys,
 	uint16_t *sig,
 	const struct rte_hash_bucket **primary_bkt,
-	const struct rte_hash_bucket **secondary_bkt)
+	const struct rte_hash_bucket **secondary_bkt,
+	const uint32_t key_len)
 {
 	int32_t i;
 	uint32_t prim_hash[RTE_HASH_LOOKUP_BULK_MAX];
@@ -2250,7 +3018,7 @@ __bulk_lookup_prefetching_loop(const struct rte_hash *h,
 	for (i = 0; i < (num_keys - PREFETCH_OFFSET); i++) {
 		rte_prefetch0(keys[i + PREFETCH_OFFSET]);
 
-		prim_hash[i] = rte_hash_hash(h, keys[i]);
+		prim_hash[i] = rte_hash_hash_spec(h, keys[i], key_len);
 
 		sig[i] = get_short_sig(prim_hash[i]);
 		prim_index[i] = get_prim_bucket_index(h, prim_hash[i]);
@@ -2265,7 +3033,7 @@ __bulk_lookup_prefetching_loop(const struct rte_hash *h,
 
 	/* Calculate and prefetch rest of the buckets */
 	for (; i < num_keys; i++) {
-		prim_hash[i] = rte_hash_hash(h, keys[i]);
+		prim_hash[i] = rte_hash_hash_spec(h, keys[i], key_len);
 
 		sig[i] = get_short_sig(prim_hash[i]);
 		prim_index[i] = get_prim_bucket_index(h, prim_hash[i]);
@@ -2280,36 +3048,79 @@ __bulk_lookup_prefetching_loop(const struct rte_hash *h,
 }
 
 
-static inline void
-__rte_hash_lookup_bulk_l(const struct rte_hash *h, const void **keys,
+static __rte_always_inline void
+__rte_hash_lookup_bulk_l_spec(const struct rte_hash *h, const void **keys,
 			int32_t num_keys, int32_t *positions,
-			uint64_t *hit_mask, void *data[])
+			uint64_t *hit_mask, void *data[], const uint32_t key_len)
 {
 	uint16_t sig[RTE_HASH_LOOKUP_BULK_MAX];
 	const struct rte_hash_bucket *primary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
 	const struct rte_hash_bucket *secondary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
 
 	__bulk_lookup_prefetching_loop(h, keys, num_keys, sig,
-		primary_bkt, secondary_bkt);
+		primary_bkt, secondary_bkt, key_len);
 
 	__bulk_lookup_l(h, keys, primary_bkt, secondary_bkt, sig, num_keys,
-		positions, hit_mask, data);
+		positions, hit_mask, data, key_len);
 }
 
 static inline void
-__rte_hash_lookup_bulk_lf(const struct rte_hash *h, const void **keys,
+__rte_hash_lookup_bulk_l(const struct rte_hash *h, const void **keys,
 			int32_t num_keys, int32_t *positions,
 			uint64_t *hit_mask, void *data[])
+{
+	HASH_BULK_LOOKUP_SPEC(h, __rte_hash_lookup_bulk_l_spec, h, keys,
+		num_keys, positions, hit_mask, data);
+}
+
+static __rte_always_inline void
+__rte_hash_lookup_bulk_lf_spec(const struct rte_hash *h, const void **keys,
+			int32_t num_keys, int32_t *positions,
+			uint64_t *hit_mask, void *data[], const uint32_t key_len)
 {
 	uint16_t sig[RTE_HASH_LOOKUP_BULK_MAX];
 	const struct rte_hash_bucket *primary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
 	const struct rte_hash_bucket *secondary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
 
 	__bulk_lookup_prefetching_loop(h, keys, num_keys, sig,
-		primary_bkt, secondary_bkt);
+		primary_bkt, secondary_bkt, key_len);
 
 	__bulk_lookup_lf(h, keys, primary_bkt, secondary_bkt, sig, num_keys,
-		positions, hit_mask, data);
+		positions, hit_mask, data, key_len);
+}
+
+static inline void
+__rte_hash_lookup_bulk_lf(const struct rte_hash *h, const void **keys,
+			int32_t num_keys, int32_t *positions,
+			uint64_t *hit_mask, void *data[])
+{
+	HASH_BULK_LOOKUP_SPEC(h, __rte_hash_lookup_bulk_lf_spec, h, keys,
+		num_keys, positions, hit_mask, data);
+}
+
+/* Bulk lookups on a resizable table are done one key at a time, the
+ * bucket array may change under the lookup.
+ */
+static inline void
+__rte_hash_lookup_bulk_rsz(const struct rte_hash *h, const void **keys,
+			const hash_sig_t *prim_hash, int32_t num_keys,
+			int32_t *positions, uint64_t *hit_mask, void *data[])
+{
+	uint64_t hits = 0;
+	hash_sig_t sig;
+	int32_t i;
+
+	for (i = 0; i < num_keys; i++) {
+		sig = prim_hash != NULL ? prim_hash[i] :
+				rte_hash_hash(h, keys[i]);
+		positions[i] = __rte_hash_lookup_with_hash_rsz(h, keys[i],
+				sig, data != NULL ? &data[i] : NULL);
+		if (positions[i] >= 0)
+			hits |= 1ULL << i;
+	}
+
+	if (hit_mask != NULL)
+		*hit_mask = hits;
 }
 
 static inline void
@@ -2317,7 +3128,10 @@ __rte_hash_lookup_bulk(const struct rte_hash *h, const void **keys,
 			int32_t num_keys, int32_t *positions,
 			uint64_t *hit_mask, void *data[])
 {
-	if (h->readwrite_concur_lf_support)
+	if (unlikely(h->resizable))
+		__rte_hash_lookup_bulk_rsz(h, keys, NULL, num_keys, positions,
+					   hit_mask, data);
+	else if (h->readwrite_concur_lf_support)
 		__rte_hash_lookup_bulk_lf(h, keys, num_keys, positions,
 					  hit_mask, data);
 	else
@@ -2354,11 +3168,11 @@ rte_hash_lookup_bulk_data(const struct rte_hash *h, const void **keys,
 }
 
 
-static inline void
-__rte_hash_lookup_with_hash_bulk_l(const struct rte_hash *h,
+static __rte_always_inline void
+__rte_hash_lookup_with_hash_bulk_l_spec(const struct rte_hash *h,
 			const void **keys, hash_sig_t *prim_hash,
 			int32_t num_keys, int32_t *positions,
-			uint64_t *hit_mask, void *data[])
+			uint64_t *hit_mask, void *data[], const uint32_t key_len)
 {
 	int32_t i;
 	uint32_t prim_index[RTE_HASH_LOOKUP_BULK_MAX];
@@ -2386,14 +3200,24 @@ __rte_hash_lookup_with_hash_bulk_l(const struct rte_hash *h,
 	}
 
 	__bulk_lookup_l(h, keys, primary_bkt, secondary_bkt, sig, num_keys,
-		positions, hit_mask, data);
+		positions, hit_mask, data, key_len);
 }
 
 static inline void
-__rte_hash_lookup_with_hash_bulk_lf(const struct rte_hash *h,
+__rte_hash_lookup_with_hash_bulk_l(const struct rte_hash *h,
 			const void **keys, hash_sig_t *prim_hash,
 			int32_t num_keys, int32_t *positions,
 			uint64_t *hit_mask, void *data[])
+{
+	HASH_BULK_LOOKUP_SPEC(h, __rte_hash_lookup_with_hash_bulk_l_spec, h,
+		keys, prim_hash, num_keys, positions, hit_mask, data);
+}
+
+static __rte_always_inline void
+__rte_hash_lookup_with_hash_bulk_lf_spec(const struct rte_hash *h,
+			const void **keys, hash_sig_t *prim_hash,
+			int32_t num_keys, int32_t *positions,
+			uint64_t *hit_mask, void *data[], const uint32_t key_len)
 {
 	int32_t i;
 	uint32_t prim_index[RTE_HASH_LOOKUP_BULK_MAX];
@@ -2421,7 +3245,17 @@ __rte_hash_lookup_with_hash_bulk_lf(const struct rte_hash *h,
 	}
 
 	__bulk_lookup_lf(h, keys, primary_bkt, secondary_bkt, sig, num_keys,
-		positions, hit_mask, data);
+		positions, hit_mask, data, key_len);
+}
+
+static inline void
+__rte_hash_lookup_with_hash_bulk_lf(const struct rte_hash *h,
+			const void **keys, hash_sig_t *prim_hash,
+			int32_t num_keys, int32_t *positions,
+			uint64_t *hit_mask, void *data[])
+{
+	HASH_BULK_LOOKUP_SPEC(h, __rte_hash_lookup_with_hash_bulk_lf_spec, h,
+		keys, prim_hash, num_keys, positions, hit_mask, data);
 }
 
 static inline void
@@ -2429,7 +3263,10 @@ __rte_hash_lookup_with_hash_bulk(const struct rte_hash *h, const void **keys,
 			hash_sig_t *prim_hash, int32_t num_keys,
 			int32_t *positions, uint64_t *hit_mask, void *data[])
 {
-	if (h->readwrite_concur_lf_support)
+	if (unlikely(h->resizable))
+		__rte_hash_lookup_bulk_rsz(h, keys, prim_hash, num_keys,
+					   positions, hit_mask, data);
+	else if (h->readwrite_concur_lf_support)
 		__rte_hash_lookup_with_hash_bulk_lf(h, keys, prim_hash,
 				num_keys, positions, hit_mask, data);
 	else
@@ -2475,12 +3312,13 @@ rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32
 {
 	uint32_t bucket_idx, idx, position;
 	struct rte_hash_key *next_key;
+	const struct rte_hash_bucket *buckets_ext;
+	uint32_t total_entries;
 
 	RETURN_IF_TRUE(((h == NULL) || (next == NULL)), -EINVAL);
 
 	const uint32_t total_entries_main = h->num_buckets *
 							RTE_HASH_BUCKET_ENTRIES;
-	const uint32_t total_entries = total_entries_main << 1;
 
 	/* Out of bounds of all buckets (both main table and ext table) */
 	if (*next >= total_entries_main)
@@ -2517,14 +3355,26 @@ rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32
 
 /* Begin to iterate extendable buckets */
 extend_table:
+	/* Keys of a growing table not migrated yet are iterated after the
+	 * main table, the same way as the extendable buckets.
+	 */
+	if (h->resizable) {
+		buckets_ext = h->buckets_old;
+		total_entries = total_entries_main +
+			h->num_buckets_old * RTE_HASH_BUCKET_ENTRIES;
+	} else {
+		buckets_ext = h->buckets_ext;
+		total_entries = total_entries_main << 1;
+	}
+
 	/* Out of total bound or if ext bucket feature is not enabled */
-	if (*next >= total_entries || !h->ext_table_support)
+	if (*next >= total_entries || buckets_ext == NULL)
 		return -ENOENT;
 
 	bucket_idx = (*next - total_entries_main) / RTE_HASH_BUCKET_ENTRIES;
 	idx = (*next - total_entries_main) % RTE_HASH_BUCKET_ENTRIES;
 
-	while ((position = h->buckets_ext[bucket_idx].key_idx[idx]) == EMPTY_SLOT) {
+	while ((position = buckets_ext[bucket_idx].key_idx[idx]) == EMPTY_SLOT) {
 		(*next)++;
 		if (*next == total_entries)
 			return -ENOENT;
@@ -2545,3 +3395,130 @@ rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32
 	(*next)++;
 	return position - 1;
 }
+
+/*
+ * Bucket *bkt_idx* of the iteration space: the buckets of the table, then
+ * the extendable buckets, or the buckets of a growing table not migrated
+ * yet. NULL past the last bucket.
+ */
+static inline const struct rte_hash_bucket *
+iter_bucket(const struct rte_hash *h, uint32_t bkt_idx)
+{
+	const struct rte_hash_bucket *bkts;
+	uint32_t num_buckets;
+
+	if (h->resizable) {
+		/* The bucket array is loaded before its mask, as lookups do */
+		bkts = __atomic_load_n(&h->buckets, __ATOMIC_ACQUIRE);
+		num_buckets = __atomic_load_n(&h->bucket_bitmask,
+					      __ATOMIC_ACQUIRE) + 1;
+		if (bkt_idx < num_buckets)
+			return &bkts[bkt_idx];
+
+		bkt_idx -= num_buckets;
+		bkts = __atomic_load_n(&h->buckets_old, __ATOMIC_ACQUIRE);
+		if (bkts == NULL || bkt_idx >= h->num_buckets_old)
+			return NULL;
+		return &bkts[bkt_idx];
+	}
+
+	if (bkt_idx < h->num_buckets)
+		return &h->buckets[bkt_idx];
+
+	bkt_idx -= h->num_buckets;
+	if (h->buckets_ext == NULL || bkt_idx >= h->num_buckets)
+		return NULL;
+	return &h->buckets_ext[bkt_idx];
+}
+
+int32_t
+rte_hash_iterate_bucket_count(const struct rte_hash *h)
+{
+	const struct rte_hash_bucket *bkts;
+	uint32_t num_buckets;
+
+	RETURN_IF_TRUE((h == NULL), -EINVAL);
+
+	if (h->resizable) {
+		bkts = __atomic_load_n(&h->buckets_old, __ATOMIC_ACQUIRE);
+		num_buckets = __atomic_load_n(&h->bucket_bitmask,
+					      __ATOMIC_ACQUIRE) + 1;
+		return num_buckets + (bkts != NULL ? h->num_buckets_old : 0);
+	}
+
+	return h->num_buckets + (h->buckets_ext != NULL ? h->num_buckets : 0);
+}
+
+int
+rte_hash_iterate_range_bulk(const struct rte_hash *h, uint32_t bkt_start,
+	uint32_t bkt_end, const void *keys[], void *data[],
+	int32_t positions[], uint32_t num, uint32_t *next)
+{
+	const struct rte_hash_bucket *bkt;
+	struct rte_hash_key *k;
+	uint32_t idx, end, slot, position, i, n = 0;
+
+	RETURN_IF_TRUE(((h == NULL) || (keys == NULL) || (data == NULL) ||
+			(next == NULL) || (bkt_start > bkt_end)), -EINVAL);
+
+	idx = bkt_start * RTE_HASH_BUCKET_ENTRIES + *next;
+	end = bkt_end * RTE_HASH_BUCKET_ENTRIES;
+
+	__hash_rw_reader_lock(h);
+
+	/* Gather the key entries of the occupied slots, prefetching them */
+	while (n < num && idx < end) {
+		bkt = iter_bucket(h, idx / RTE_HASH_BUCKET_ENTRIES);
+		if (bkt == NULL) {
+			idx = end;
+			break;
+		}
+
+		for (slot = idx % RTE_HASH_BUCKET_ENTRIES;
+				slot < RTE_HASH_BUCKET_ENTRIES && n < num;
+				slot++, idx++) {
+			position = __atomic_load_n(&bkt->key_idx[slot],
+						   __ATOMIC_ACQUIRE);
+			if (position == EMPTY_SLOT)
+				continue;
+
+			k = (struct rte_hash_key *)((char *)h->key_store +
+					position * h->key_entry_size);
+			rte_prefetch0(k);
+			keys[n] = k;
+			if (positions != NULL)
+				positions[n] = position - 1;
+			n++;
+		}
+	}
+
+	/* Return keys and data */
+	for (i = 0; i < n; i++) {
+		k = (struct rte_hash_key *)(uintptr_t)keys[i];
+		data[i] = k->pdata;
+		keys[i] = k->key;
+	}
+
+	__hash_rw_reader_unlock(h);
+
+	*next = idx - bkt_start * RTE_HASH_BUCKET_ENTRIES;
+
+	return n;
+}
+
+int32_t
+rte_hash_iterate_range(const struct rte_hash *h, uint32_t bkt_start,
+	uint32_t bkt_end, const void **key, void **data, uint32_t *next)
+{
+	int32_t position;
+	int ret;
+
+	RETURN_IF_TRUE(((key == NULL) || (data == NULL)), -EINVAL);
+
+	ret = rte_hash_iterate_range_bulk(h, bkt_start, bkt_end, key, data,
+					  &position, 1, next);
+	if (ret < 0)
+		return ret;
+
+	return ret == 1 ? position : -ENOENT;
+}
@@ -122,6 +122,12 @@ const rte_hash_cmp_eq_t cmp_jump_table[NUM_KEY_CMP_CASES] = {
 
 #define RTE_HASH_TSX_MAX_RETRY  10
 
+/* Number of buckets a resizable table starts with */
+#define RTE_HASH_RESIZE_MIN_BUCKETS	16
+
+/* Number of old buckets migrated by each write while a table grows */
+#define RTE_HASH_RESIZE_STEP_BUCKETS	4
+
 struct lcore_cache {
 	unsigned len; /**< Cache len */
 	uint32_t objs[LCORE_CACHE_SIZE]; /**< Cache objects */
@@ -196,12 +202,18 @@ struct rte_hash {
 	/**< If read-write concurrency lock free support is enabled */
 	uint8_t writer_takes_lock;
 	/**< Indicates if the writer threads need to take lock */
+	uint8_t resizable;
+	/**< If the bucket array is resized online */
+	uint8_t hash_crc;
+	/**< If hash_func is the CRC32 hash, inlined by the bulk lookups */
 	rte_hash_function hash_func;    /**< Function used to calculate hash. */
 	uint32_t hash_func_init_val;    /**< Init value used by hash_func. */
 	rte_hash_cmp_eq_t rte_hash_custom_cmp_eq;
 	/**< Custom function used to compare keys. */
 	enum cmp_jump_table_case cmp_jump_table_idx;
 	/**< Indicates which compare function to use. */
+	uint32_t spec_key_len;
+	/**< Key length of the specialized bulk lookups, 0 if none. */
 	enum rte_hash_sig_compare_function sig_cmp_fn;
 	/**< Indicates which signature compare function to use. */
 	uint32_t bucket_bitmask;
@@ -225,6 +237,15 @@ struct rte_hash {
 	uint32_t *ext_bkt_to_free;
 	uint32_t *tbl_chng_cnt;
 	/**< Indicates if the hash table changed from last read. */
+
+	/* Resizable bucket array */
+	int socket_id;                 /**< Socket the buckets are allocated on */
+	uint32_t max_buckets;          /**< Largest number of buckets */
+	struct rte_hash_bucket *buckets_old;
+	/**< Buckets still being migrated while the table grows, or NULL */
+	uint32_t num_buckets_old;      /**< Number of buckets in buckets_old */
+	uint32_t bucket_bitmask_old;   /**< Bitmask of buckets_old */
+	uint32_t resize_next;          /**< Next bucket of buckets_old to migrate */
 } __rte_cache_aligned;
 
 struct queue_node {
@@ -97,7 +97,9 @@ rte_fbk_hash_create(const struct rte_fbk_hash_params *params)
 			(params->entries_per_bucket == 0) ||
 			(params->entries_per_bucket > params->entries) ||
 			(params->entries > RTE_FBK_HASH_ENTRIES_MAX) ||
-			(params->entries_per_bucket > RTE_FBK_HASH_ENTRIES_PER_BUCKET_MAX)){
+			(params->entries_per_bucket > RTE_FBK_HASH_ENTRIES_PER_BUCKET_MAX) ||
+			(params->extra_flag &
+				~RTE_FBK_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF)) {
 		rte_errno = EINVAL;
 		return NULL;
 	}
@@ -152,6 +154,8 @@ rte_fbk_hash_create(const struct rte_fbk_hash_params *params)
 	    ht->bucket_shift++, i <<= 1)
 		; /* empty loop body */
 
+	ht->extra_flag = params->extra_flag;
+
 	if (params->hash_func != NULL) {
 		ht->hash_func = params->hash_func;
 		ht->init_val = params->init_val;
@@ -159,6 +163,8 @@ rte_fbk_hash_create(const struct rte_fbk_hash_params *params)
 	else {
 		ht->hash_func = default_hash_func;
 		ht->init_val = RTE_FBK_HASH_INIT_VAL_DEFAULT;
+		ht->hash_crc = default_hash_func !=
+				(rte_fbk_hash_fn)rte_jhash_1word;
 	}
 
 	te->data = (void *) ht;
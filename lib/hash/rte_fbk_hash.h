@@ -13,6 +13,13 @@
  * Note that the return value of the add function should always be checked as,
  * if a bucket is full, the key is not added even if there is space in other
  * buckets. This keeps the lookup function very simple and therefore fast.
+ *
+ * With the RTE_FBK_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF flag, the keys never
+ * move within their bucket, and entries are read and written with single
+ * atomic accesses, so that lookups can run concurrently with the (single)
+ * writer without any lock. A deleted value may still be returned by lookups
+ * which started before the delete: the application can use the RCU library
+ * to know when the resources referenced by the value can be reused.
  */
 
 #include <stdint.h>
@@ -26,8 +33,14 @@ extern "C" {
 #include <string.h>
 
 #include <rte_config.h>
+#include <rte_common.h>
+#include <rte_compat.h>
+#include <rte_prefetch.h>
 #include <rte_hash_crc.h>
 #include <rte_jhash.h>
+#if defined(RTE_ARCH_X86)
+#include <rte_vect.h>
+#endif
 
 #ifndef RTE_FBK_HASH_INIT_VAL_DEFAULT
 /** Initialising value used when calculating hash. */
@@ -43,6 +56,12 @@ extern "C" {
 /** Maximum size of string for naming the hash. */
 #define RTE_FBK_HASH_NAMESIZE			32
 
+/** Flag to support lock free reader writer concurrency. */
+#define RTE_FBK_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF	0x01
+
+/** Number of keys hashed ahead by rte_fbk_hash_lookup_bulk(). */
+#define RTE_FBK_HASH_LOOKUP_BULK_STRIDE		8
+
 /** Type of function that can be used for calculating the hash value. */
 typedef uint32_t (*rte_fbk_hash_fn)(uint32_t key, uint32_t init_val);
 
@@ -54,6 +73,7 @@ struct rte_fbk_hash_params {
 	int socket_id;			/**< Socket to allocate memory on. */
 	rte_fbk_hash_fn hash_func;	/**< The hash function. */
 	uint32_t init_val;		/**< For initialising hash function. */
+	uint32_t extra_flag;		/**< Indicate if additional parameters are present. */
 };
 
 /** Individual entry in the four-byte key hash table. */
@@ -77,9 +97,11 @@ struct rte_fbk_hash_table {
 	uint32_t bucket_shift;		/**< Convert bucket to table offset. */
 	rte_fbk_hash_fn hash_func;	/**< The hash function. */
 	uint32_t init_val;		/**< For initialising hash function. */
+	uint32_t extra_flag;		/**< Extra flags given at creation. */
+	uint32_t hash_crc;		/**< Non-zero if hashing with the default CRC hash. */
 
 	/** A flat table of all buckets. */
-	union rte_fbk_hash_entry t[];
+	union rte_fbk_hash_entry t[] __rte_cache_aligned;
 };
 
 /**
@@ -99,6 +121,16 @@ rte_fbk_hash_get_bucket(const struct rte_fbk_hash_table *ht, uint32_t key)
 			ht->bucket_shift;
 }
 
+/**
+ * @internal
+ * Whether readers can run concurrently with the writer without lock.
+ */
+static inline int
+__rte_fbk_hash_lf(const struct rte_fbk_hash_table *ht)
+{
+	return (ht->extra_flag & RTE_FBK_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF) != 0;
+}
+
 /**
  * Add a key to an existing hash table with bucket id.
  * This operation is not multi-thread safe
@@ -128,7 +160,34 @@ rte_fbk_hash_add_key_with_bucket(struct rte_fbk_hash_table *ht,
 	const uint64_t new_entry = ((uint64_t)(key) << 32) |
 			((uint64_t)(value) << 16) |
 			1;  /* 1 = is_entry bit. */
-	uint32_t i;
+	uint32_t i, free_slot;
+
+	if (__rte_fbk_hash_lf(ht)) {
+		/*
+		 * Keys may follow a free slot, look for the key in the whole
+		 * bucket before taking the first free slot.
+		 */
+		free_slot = ht->entries_per_bucket;
+		for (i = 0; i < ht->entries_per_bucket; i++) {
+			if (!ht->t[bucket + i].entry.is_entry) {
+				if (free_slot == ht->entries_per_bucket)
+					free_slot = i;
+				continue;
+			}
+			if (ht->t[bucket + i].entry.key == key) {
+				__atomic_store_n(&ht->t[bucket + i].whole_entry,
+						new_entry, __ATOMIC_RELEASE);
+				return 0;
+			}
+		}
+		if (free_slot == ht->entries_per_bucket)
+			return -ENOSPC; /* No space in bucket. */
+
+		__atomic_store_n(&ht->t[bucket + free_slot].whole_entry,
+				new_entry, __ATOMIC_RELEASE);
+		ht->used_entries++;
+		return 0;
+	}
 
 	for (i = 0; i < ht->entries_per_bucket; i++) {
 		/* Set entry if unused. */
@@ -189,6 +248,20 @@ rte_fbk_hash_delete_key_with_bucket(struct rte_fbk_hash_table *ht,
 	uint32_t last_entry = ht->entries_per_bucket - 1;
 	uint32_t i, j;
 
+	if (__rte_fbk_hash_lf(ht)) {
+		/* Free the slot in place, other keys never move. */
+		for (i = 0; i < ht->entries_per_bucket; i++) {
+			if (ht->t[bucket + i].entry.is_entry &&
+					ht->t[bucket + i].entry.key == key) {
+				__atomic_store_n(&ht->t[bucket + i].whole_entry,
+						0, __ATOMIC_RELEASE);
+				ht->used_entries--;
+				return 0;
+			}
+		}
+		return -ENOENT; /* Key didn't exist. */
+	}
+
 	for (i = 0; i < ht->entries_per_bucket; i++) {
 		if (ht->t[bucket + i].entry.key == key) {
 			/* Find last key in bucket. */
@@ -252,6 +325,18 @@ rte_fbk_hash_lookup_with_bucket(const struct rte_fbk_hash_table *ht,
 	union rte_fbk_hash_entry current_entry;
 	uint32_t i;
 
+	if (__rte_fbk_hash_lf(ht)) {
+		for (i = 0; i < ht->entries_per_bucket; i++) {
+			current_entry.whole_entry = __atomic_load_n(
+					&ht->t[bucket + i].whole_entry,
+					__ATOMIC_ACQUIRE);
+			if (current_entry.entry.is_entry &&
+					current_entry.entry.key == key)
+				return current_entry.entry.value;
+		}
+		return -ENOENT; /* Key didn't exist. */
+	}
+
 	for (i = 0; i < ht->entries_per_bucket; i++) {
 		/* Single read of entry, which should be atomic. */
 		current_entry.whole_entry = ht->t[bucket + i].whole_entry;
@@ -282,6 +367,120 @@ rte_fbk_hash_lookup(const struct rte_fbk_hash_table *ht, uint32_t key)
 				key, rte_fbk_hash_get_bucket(ht, key));
 }
 
+#if defined(RTE_ARCH_X86)
+/**
+ * @internal
+ * Find a key in a bucket of at least two entries, comparing four entries at
+ * a time. Each 8-byte entry of the vectors is read atomically, as the bucket
+ * is 16-byte aligned.
+ */
+static inline int
+__rte_fbk_hash_lookup_bucket_sse(const struct rte_fbk_hash_table *ht,
+				uint32_t key, uint32_t bucket)
+{
+	/* Key in the upper half of each entry, is_entry in the lower half */
+	const __m128i k = _mm_set_epi32(key, 0, key, 0);
+	const __m128i is_entry_mask = _mm_set_epi32(0, UINT16_MAX,
+						    0, UINT16_MAX);
+	const __m128i zero = _mm_setzero_si128();
+	const int lf = __rte_fbk_hash_lf(ht);
+	union rte_fbk_hash_entry e[4] __rte_aligned(16);
+	__m128i v0, v1;
+	uint32_t i, key_eq, empty, hit;
+
+	for (i = 0; i < ht->entries_per_bucket; i += 4) {
+		v0 = _mm_load_si128((const __m128i *)&ht->t[bucket + i]);
+		/* An empty pair when the bucket has only two entries */
+		v1 = ht->entries_per_bucket > 2 ?
+			_mm_load_si128((const __m128i *)&ht->t[bucket + i + 2]) :
+			zero;
+		_mm_store_si128((__m128i *)&e[0], v0);
+		_mm_store_si128((__m128i *)&e[2], v1);
+
+		key_eq = _mm_movemask_ps(_mm_castsi128_ps(
+				_mm_cmpeq_epi32(v0, k))) |
+			_mm_movemask_ps(_mm_castsi128_ps(
+				_mm_cmpeq_epi32(v1, k))) << 4;
+		empty = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(
+				_mm_and_si128(v0, is_entry_mask), zero))) |
+			_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(
+				_mm_and_si128(v1, is_entry_mask), zero))) << 4;
+
+		/* Odd bits for the keys, even bits for is_entry */
+		hit = key_eq & ~(empty << 1) & 0xaa;
+		if (likely(hit != 0))
+			return e[rte_bsf32(hit) >> 1].entry.value;
+
+		/* Keys are packed at the start of the bucket without LF */
+		if (!lf && (empty & 0x55))
+			return -ENOENT;
+	}
+
+	return -ENOENT; /* Key didn't exist. */
+}
+#endif
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Find multiple keys in the hash table. The hashes of a group of keys are
+ * computed and their buckets prefetched before the buckets are searched,
+ * whole buckets being compared to the key with vector instructions where
+ * available. This operation is multi-thread safe.
+ *
+ * @param ht
+ *   Hash table to look in.
+ * @param keys
+ *   Keys to find.
+ * @param values
+ *   Output values, the value associated with each key or -ENOENT.
+ * @param n
+ *   Number of keys.
+ * @return
+ *   Number of keys found.
+ */
+__rte_experimental
+static inline uint32_t
+rte_fbk_hash_lookup_bulk(const struct rte_fbk_hash_table *ht,
+			const uint32_t *keys, int *values, uint32_t n)
+{
+	uint32_t buckets[RTE_FBK_HASH_LOOKUP_BULK_STRIDE];
+	uint32_t i, j, m, hits = 0;
+
+	for (i = 0; i < n; i += m) {
+		m = RTE_MIN(n - i, (uint32_t)RTE_FBK_HASH_LOOKUP_BULK_STRIDE);
+
+		/* The default CRC hash is inlined rather than called */
+		for (j = 0; j < m; j++) {
+			if (ht->hash_crc)
+				buckets[j] = (rte_hash_crc_4byte(keys[i + j],
+						ht->init_val) &
+						ht->bucket_mask) <<
+						ht->bucket_shift;
+			else
+				buckets[j] = rte_fbk_hash_get_bucket(ht,
+						keys[i + j]);
+			rte_prefetch0(&ht->t[buckets[j]]);
+		}
+
+		for (j = 0; j < m; j++) {
+#if defined(RTE_ARCH_X86)
+			if (ht->entries_per_bucket > 1)
+				values[i + j] =
+					__rte_fbk_hash_lookup_bucket_sse(ht,
+						keys[i + j], buckets[j]);
+			else
+#endif
+				values[i + j] = rte_fbk_hash_lookup_with_bucket(
+						ht, keys[i + j], buckets[j]);
+			hits += values[i + j] >= 0;
+		}
+	}
+
+	return hits;
+}
+
 /**
  * Delete all entries in a hash table. This operation is not multi-thread
  * safe and should only be called from one thread.
@@ -292,7 +491,15 @@ rte_fbk_hash_lookup(const struct rte_fbk_hash_table *ht, uint32_t key)
 static inline void
 rte_fbk_hash_clear_all(struct rte_fbk_hash_table *ht)
 {
-	memset(ht->t, 0, sizeof(ht->t[0]) * ht->entries);
+	uint32_t i;
+
+	if (__rte_fbk_hash_lf(ht)) {
+		for (i = 0; i < ht->entries; i++)
+			__atomic_store_n(&ht->t[i].whole_entry, 0,
+					__ATOMIC_RELEASE);
+	} else {
+		memset(ht->t, 0, sizeof(ht->t[0]) * ht->entries);
+	}
 	ht->used_entries = 0;
 }
 
@@ -56,6 +56,29 @@ extern "C" {
  */
 #define RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF 0x20
 
+/** Flag to let the bucket array grow and shrink online. The table starts
+ * small and doubles its number of buckets when a key does not fit, moving
+ * the keys incrementally on subsequent writes. The entries parameter is the
+ * largest number of keys the table can hold.
+ * Keys are rehashed with the hash function of the table when they move, so
+ * the *_with_hash APIs must be given signatures computed by rte_hash_hash().
+ * Not supported together with RTE_HASH_EXTRA_FLAGS_EXT_TABLE or
+ * RTE_HASH_EXTRA_FLAGS_MULTI_WRITER_ADD. With
+ * RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF, resizing requires an RCU QSBR
+ * variable attached with rte_hash_rcu_qsbr_add().
+ */
+#define RTE_HASH_EXTRA_FLAGS_RESIZABLE 0x40
+
+/** Flag to size the key slots so that none spans two cache lines.
+ * A key slot holds the key and the pointer-sized data associated to it,
+ * so a lookup hit reads the bucket and one key slot cache line, the data
+ * being returned from the slot. Values up to the size of a pointer can be
+ * stored as the data itself to avoid reading a third cache line.
+ * Slots up to a cache line are rounded up to a power of 2, larger ones to
+ * a multiple of the cache line size, trading memory for fewer misses.
+ */
+#define RTE_HASH_EXTRA_FLAGS_KEY_SLOT_ALIGN 0x80
+
 /**
  * The type of hash value of a key.
  * It should be a value of at least 32bit with fully random pattern.
@@ -322,6 +345,40 @@ rte_hash_add_key(const struct rte_hash *h, const void *key);
 int32_t
 rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key, hash_sig_t sig);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Add multiple keys to an existing hash table.
+ * This operation is not multi-thread safe
+ * and should only be called from one thread by default.
+ * Thread safety can be enabled by setting flag during
+ * table creation.
+ * The writer lock is taken once for the whole burst, keys that cannot be
+ * stored without moving other keys are then added one by one.
+ * Adding a key that is already in the table updates its data.
+ *
+ * @param h
+ *   Hash table to add the keys to.
+ * @param keys
+ *   A pointer to a list of keys to add.
+ * @param num_keys
+ *   How many keys are in the keys list (less than RTE_HASH_LOOKUP_BULK_MAX).
+ * @param data
+ *   Optional list of data to add with the keys, NULL to add no data.
+ * @param positions
+ *   Output containing a list of values, corresponding to the list of keys,
+ *   that are the same values returned by rte_hash_add_key() for each key,
+ *   or a negative error code (-ENOSPC) if a key could not be added.
+ * @return
+ *   -EINVAL if the parameters are invalid, otherwise the number of keys
+ *   successfully added.
+ */
+__rte_experimental
+int
+rte_hash_add_bulk(const struct rte_hash *h, const void **keys,
+		  uint32_t num_keys, void **data, int32_t *positions);
+
 /**
  * Remove a key from an existing hash table.
  * This operation is not multi-thread safe
@@ -384,6 +441,37 @@ rte_hash_del_key(const struct rte_hash *h, const void *key);
 int32_t
 rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key, hash_sig_t sig);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Remove multiple keys from an existing hash table.
+ * This operation is not multi-thread safe
+ * and should only be called from one thread by default.
+ * Thread safety can be enabled by setting flag during
+ * table creation.
+ * The writer lock is taken once for the whole burst. Key indexes are
+ * freed as by rte_hash_del_key().
+ *
+ * @param h
+ *   Hash table to remove the keys from.
+ * @param keys
+ *   A pointer to a list of keys to remove.
+ * @param num_keys
+ *   How many keys are in the keys list (less than RTE_HASH_LOOKUP_BULK_MAX).
+ * @param positions
+ *   Output containing a list of values, corresponding to the list of keys,
+ *   that are the same values returned by rte_hash_del_key() for each key,
+ *   or -ENOENT if a key was not found.
+ * @return
+ *   -EINVAL if the parameters are invalid, otherwise the number of keys
+ *   successfully removed.
+ */
+__rte_experimental
+int
+rte_hash_del_bulk(const struct rte_hash *h, const void **keys,
+		  uint32_t num_keys, int32_t *positions);
+
 /**
  * Find a key in the hash table given the position.
  * This operation is multi-thread safe with regarding to other lookup threads.
@@ -694,6 +782,171 @@ rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32
 __rte_experimental
 int rte_hash_rcu_qsbr_add(struct rte_hash *h, struct rte_hash_rcu_config *cfg);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Resize the bucket array of a table created with
+ * RTE_HASH_EXTRA_FLAGS_RESIZABLE to fit the given number of keys.
+ * The resize, including any migration still in progress, is completed
+ * before returning. The number of buckets is kept between the initial and
+ * the maximum size of the table.
+ * This is a write operation: it is not multi-thread safe with other writers
+ * and, with lock-free readers, waits for them through the RCU QSBR variable
+ * of the table.
+ *
+ * @param h
+ *   Hash table to resize.
+ * @param entries
+ *   Number of keys the bucket array should be sized for.
+ * @return
+ *   - 0 if resized
+ *   - -EINVAL if the parameters are invalid or if lock-free readers are
+ *     enabled without RCU QSBR variable
+ *   - -ENOTSUP if the table is not resizable
+ *   - -ENOMEM if the new bucket array cannot be allocated
+ *   - -ENOSPC if the keys do not fit in a smaller bucket array
+ */
+__rte_experimental
+int
+rte_hash_resize(struct rte_hash *h, uint32_t entries);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Move keys of a growing resizable table to its new bucket array.
+ * Each add and delete already migrates a few buckets, this lets the
+ * application finish the migration from an idle period instead.
+ * This is a write operation, with the same thread safety as rte_hash_resize().
+ *
+ * @param h
+ *   Hash table to migrate.
+ * @param nb_buckets
+ *   Maximum number of old buckets to migrate.
+ * @return
+ *   - Number of old buckets still to migrate, 0 if no resize is in progress
+ *   - -EINVAL if the parameters are invalid
+ *   - -ENOTSUP if the table is not resizable
+ */
+__rte_experimental
+int32_t
+rte_hash_resize_step(struct rte_hash *h, uint32_t nb_buckets);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Return the current number of buckets of a hash table.
+ *
+ * @param h
+ *   Hash table to query from
+ * @return
+ *   - -EINVAL if parameters are invalid
+ *   - Number of buckets in the table
+ */
+__rte_experimental
+int32_t
+rte_hash_bucket_count(const struct rte_hash *h);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Return the number of buckets walked by the iteration of a hash table,
+ * to split it into bucket ranges given to rte_hash_iterate_range() or
+ * rte_hash_iterate_range_bulk(). They are the buckets of the table, then
+ * its extendable buckets, or the buckets of a growing resizable table which
+ * are not migrated yet.
+ *
+ * @param h
+ *   Hash table to query from
+ * @return
+ *   - -EINVAL if parameters are invalid
+ *   - Number of buckets to iterate
+ */
+__rte_experimental
+int32_t
+rte_hash_iterate_bucket_count(const struct rte_hash *h);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Iterate through a range of buckets of the hash table, returning key-value
+ * pairs. The iteration of a table can thus be split between several threads,
+ * or done a few buckets at a time.
+ *
+ * With lock-free read-write concurrency, the keys may be added or deleted
+ * while iterating: a key added or deleted meanwhile may or may not be
+ * returned. The key and data returned stay valid until the calling thread
+ * reports a quiescent state on the RCU QSBR variable of the table, if the
+ * thread is registered on it. If a resizable table grows or shrinks while
+ * iterating, keys may be missed or returned twice.
+ *
+ * @param h
+ *   Hash table to iterate
+ * @param bkt_start
+ *   First bucket of the range
+ * @param bkt_end
+ *   Bucket following the last bucket of the range,
+ *   see rte_hash_iterate_bucket_count()
+ * @param key
+ *   Output containing the key where current iterator
+ *   was pointing at
+ * @param data
+ *   Output containing the data associated with key.
+ *   Returns NULL if data was not stored.
+ * @param next
+ *   Pointer to iterator. Should be 0 to start iterating the range.
+ *   Iterator is incremented after each call of this function.
+ * @return
+ *   Position where key was stored, if successful.
+ *   - -EINVAL if the parameters are invalid.
+ *   - -ENOENT if end of the range.
+ */
+__rte_experimental
+int32_t
+rte_hash_iterate_range(const struct rte_hash *h, uint32_t bkt_start,
+	uint32_t bkt_end, const void **key, void **data, uint32_t *next);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Iterate through a range of buckets of the hash table, returning up to
+ * *num* key-value pairs at a time, see rte_hash_iterate_range().
+ * The key entries are prefetched before their data is read, and a reader
+ * lock, if any, is taken once per call.
+ *
+ * @param h
+ *   Hash table to iterate
+ * @param bkt_start
+ *   First bucket of the range
+ * @param bkt_end
+ *   Bucket following the last bucket of the range,
+ *   see rte_hash_iterate_bucket_count()
+ * @param keys
+ *   Output containing the keys
+ * @param data
+ *   Output containing the data associated with the keys.
+ * @param positions
+ *   Output containing the positions where the keys were stored, can be NULL.
+ * @param num
+ *   Maximum number of key-value pairs to return.
+ * @param next
+ *   Pointer to iterator. Should be 0 to start iterating the range.
+ *   Iterator is moved forward by each call of this function.
+ * @return
+ *   - -EINVAL if the parameters are invalid.
+ *   - Number of key-value pairs returned, 0 at the end of the range.
+ */
+__rte_experimental
+int
+rte_hash_iterate_range_bulk(const struct rte_hash *h, uint32_t bkt_start,
+	uint32_t bkt_end, const void *keys[], void *data[],
+	int32_t positions[], uint32_t num, uint32_t *next);
+
 #ifdef __cplusplus
 }
 #endif
@@ -11,6 +11,12 @@
 #include <rte_eal_memconfig.h>
 #include <rte_log.h>
 #include <rte_malloc.h>
+#include <rte_cpuflags.h>
+#include <rte_vect.h>
+
+#ifdef CC_THASH_GFNI_SUPPORT
+#include "rte_thash_x86_gfni.h"
+#endif
 
 #define THASH_NAME_LEN		64
 #define TOEPLITZ_HASH_LEN	32
@@ -85,6 +91,8 @@ struct rte_thash_ctx {
 	uint32_t	reta_sz_log;	/** < size of the RSS ReTa in bits */
 	uint32_t	subtuples_nb;	/** < number of subtuples */
 	uint32_t	flags;
+	uint64_t	*matrices;
+	/**< matrices used with rte_thash_gfni implementation */
 	uint8_t		hash_key[0];
 };
 
@@ -235,12 +243,23 @@ rte_thash_init_ctx(const char *name, uint32_t key_len, uint32_t reta_sz,
 			ctx->hash_key[i] = rte_rand();
 	}
 
+	ctx->matrices = rte_zmalloc(NULL, key_len * sizeof(uint64_t),
+		RTE_CACHE_LINE_SIZE);
+	if (ctx->matrices == NULL) {
+		RTE_LOG(ERR, HASH, "Cannot allocate matrices\n");
+		rte_errno = ENOMEM;
+		goto free_ctx;
+	}
+	rte_thash_complete_matrix(ctx->matrices, ctx->hash_key, key_len);
+
 	te->data = (void *)ctx;
 	TAILQ_INSERT_TAIL(thash_list, te, next);
 
 	rte_mcfg_tailq_write_unlock();
 
 	return ctx;
+free_ctx:
+	rte_free(ctx);
 free_te:
 	rte_free(te);
 exit:
@@ -304,6 +323,7 @@ rte_thash_free_ctx(struct rte_thash_ctx *ctx)
 		rte_free(tmp);
 	}
 
+	rte_free(ctx->matrices);
 	rte_free(ctx);
 	rte_free(te);
 }
@@ -354,6 +374,9 @@ generate_subkey(struct rte_thash_ctx *ctx, struct thash_lfsr *lfsr,
 			set_bit(ctx->hash_key, get_rev_bit_lfsr(lfsr), i);
 	}
 
+	/* keep the GFNI matrices in sync with the key */
+	rte_thash_complete_matrix(ctx->matrices, ctx->hash_key, ctx->key_len);
+
 	return 0;
 }
 
@@ -610,6 +633,132 @@ rte_thash_get_key(struct rte_thash_ctx *ctx)
 	return ctx->hash_key;
 }
 
+const uint64_t *
+rte_thash_get_gfni_matrices(struct rte_thash_ctx *ctx)
+{
+	return ctx->matrices;
+}
+
+void
+rte_thash_complete_matrix(uint64_t *matrixes, const uint8_t *rss_key,
+	int size)
+{
+	int i, j;
+	uint16_t window;
+	uint64_t matrix;
+
+	/*
+	 * Matrix for key byte i: row j (stored in byte j of the qword,
+	 * as GF2P8AFFINEQB expects for output bit 7 - j) is the key
+	 * bit window starting (8 - j) bits past the MSB of key byte i.
+	 */
+	for (i = 0; i < size; i++) {
+		window = (uint16_t)rss_key[i] << CHAR_BIT;
+		if (i + 1 < size)
+			window |= rss_key[i + 1];
+
+		matrix = 0;
+		for (j = 0; j < CHAR_BIT; j++)
+			matrix |= (uint64_t)(uint8_t)(window >>
+				(CHAR_BIT - j)) << (j * CHAR_BIT);
+		matrixes[i] = matrix;
+	}
+}
+
+/* GF2P8AFFINEQB on a single byte */
+static inline uint8_t
+thash_affine_byte(uint64_t matrix, uint8_t x)
+{
+	uint8_t ret = 0;
+	int i;
+
+	for (i = 0; i < CHAR_BIT; i++)
+		ret |= (__builtin_parity((matrix >>
+			((CHAR_BIT - 1 - i) * CHAR_BIT)) & x) << i);
+
+	return ret;
+}
+
+static uint32_t
+thash_gfni_scalar(const uint64_t *mtrx, const uint8_t *tuple, int len)
+{
+	uint8_t out[sizeof(uint32_t)] = {0};
+	int j, m;
+
+	for (j = 0; j < len; j++)
+		for (m = 0; m < (int)sizeof(uint32_t); m++)
+			out[m] ^= thash_affine_byte(mtrx[j + m], tuple[j]);
+
+	return ((uint32_t)out[0] << 24) | ((uint32_t)out[1] << 16) |
+		((uint32_t)out[2] << 8) | out[3];
+}
+
+static void
+thash_gfni_bulk_scalar(const uint64_t *mtrx, int len, uint8_t *tuple[],
+	uint32_t val[], uint32_t num)
+{
+	uint32_t i;
+
+	for (i = 0; i < num; i++)
+		val[i] = thash_gfni_scalar(mtrx, tuple[i], len);
+}
+
+typedef void (*thash_gfni_bulk_t)(const uint64_t *mtrx, int len,
+	uint8_t *tuple[], uint32_t val[], uint32_t num);
+
+/* selected on first use, once EAL has set the max SIMD bitwidth */
+static thash_gfni_bulk_t thash_gfni_bulk_fn;
+
+int
+rte_thash_gfni_supported(void)
+{
+#ifdef CC_THASH_GFNI_SUPPORT
+	if ((rte_cpu_get_flag_enabled(RTE_CPUFLAG_GFNI) > 0) &&
+			(rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F) > 0) &&
+			(rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512BW) > 0) &&
+			(rte_vect_get_max_simd_bitwidth() >= RTE_VECT_SIMD_512))
+		return 1;
+#endif
+
+	return 0;
+}
+
+static inline thash_gfni_bulk_t
+thash_gfni_get_bulk_fn(void)
+{
+	thash_gfni_bulk_t fn = thash_gfni_bulk_fn;
+
+	if (likely(fn != NULL))
+		return fn;
+
+	fn = thash_gfni_bulk_scalar;
+#ifdef CC_THASH_GFNI_SUPPORT
+	if (rte_thash_gfni_supported())
+		fn = thash_gfni_bulk_avx512;
+#endif
+	thash_gfni_bulk_fn = fn;
+
+	return fn;
+}
+
+uint32_t
+rte_thash_gfni(const uint64_t *mtrx, const uint8_t *tuple, int len)
+{
+	uint32_t val;
+
+	thash_gfni_get_bulk_fn()(mtrx, len, (uint8_t **)(uintptr_t)&tuple,
+		&val, 1);
+
+	return val;
+}
+
+void
+rte_thash_gfni_bulk(const uint64_t *mtrx, int len, uint8_t *tuple[],
+	uint32_t val[], uint32_t num)
+{
+	thash_gfni_get_bulk_fn()(mtrx, len, tuple, val, num);
+}
+
 static inline uint8_t
 read_unaligned_byte(uint8_t *ptr, unsigned int len, unsigned int offset)
 {
@@ -387,6 +387,109 @@ __rte_experimental
 const uint8_t *
 rte_thash_get_key(struct rte_thash_ctx *ctx);
 
+/**
+ * Check if GFNI accelerated Toeplitz hash calculation is available
+ * on the running CPU.
+ *
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * @return
+ *  1 if rte_thash_gfni() and rte_thash_gfni_bulk() use the vector path
+ *  0 otherwise
+ */
+__rte_experimental
+int
+rte_thash_gfni_supported(void);
+
+/**
+ * Converts Toeplitz hash key (RSS key) into matrixes required
+ * for GFNI implementation
+ *
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * @param matrixes
+ *  pointer to the memory where matrices will be written.
+ *  Note: the size of this memory must be equal to size * 8
+ * @param rss_key
+ *  pointer to the Toeplitz hash key
+ * @param size
+ *  Size of the rss_key in bytes.
+ */
+__rte_experimental
+void
+rte_thash_complete_matrix(uint64_t *matrixes, const uint8_t *rss_key,
+	int size);
+
+/**
+ * Get a pointer to the toeplitz hash matrices contained in the context.
+ * These matrices could be used with fast toeplitz hash implementation if
+ * CPU supports GFNI.
+ * Matrices changes after rte_thash_add_helper() calls.
+ *
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * @param ctx
+ *  Thash context
+ * @return
+ *  A pointer to the toeplitz hash key matrices
+ */
+__rte_experimental
+const uint64_t *
+rte_thash_get_gfni_matrices(struct rte_thash_ctx *ctx);
+
+/**
+ * Calculate Toeplitz hash using the key matrices.
+ *
+ * The tuple is a byte stream in network byte order, so the result matches
+ * rte_softrss() of the same tuple converted into host order 32-bit words.
+ * The key the matrices were built from must be at least len + 4 bytes long.
+ * Uses GF2P8AFFINEQB on CPUs supporting GFNI and AVX512,
+ * a scalar implementation otherwise.
+ *
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * @param mtrx
+ *  Pointer to the matrices generated from the corresponding
+ *  RSS hash key using rte_thash_complete_matrix().
+ * @param tuple
+ *  Pointer to the data to be hashed.
+ * @param len
+ *  Length of the data to be hashed in bytes.
+ * @return
+ *  Calculated Toeplitz hash value.
+ */
+__rte_experimental
+uint32_t
+rte_thash_gfni(const uint64_t *mtrx, const uint8_t *tuple, int len);
+
+/**
+ * Bulk implementation for Toeplitz hash.
+ * Tuples are hashed two at a time on the vector path.
+ *
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * @param mtrx
+ *  Pointer to the matrices generated from the corresponding
+ *  Toeplitz hash key using rte_thash_complete_matrix().
+ * @param len
+ *  Length of the largest data buffer to be hashed.
+ * @param tuple
+ *  Array of the pointers on data to be hashed.
+ * @param val
+ *  Array of uint32_t where to put calculated Toeplitz hash values
+ * @param num
+ *  Number of tuples to hash.
+ */
+__rte_experimental
+void
+rte_thash_gfni_bulk(const uint64_t *mtrx, int len, uint8_t *tuple[],
+	uint32_t val[], uint32_t num);
+
 /**
  * Function prototype for the rte_thash_adjust_tuple
  * to check if adjusted tuple could be used.
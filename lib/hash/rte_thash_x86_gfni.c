@@ -0,0 +1,117 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <rte_common.h>
+#include <rte_byteorder.h>
+#include <rte_vect.h>
+
+#include "rte_thash_x86_gfni.h"
+
+/*
+ * Every 64-bit lane of the accumulator holds one 8x8 bit matrix taken from
+ * the key (see rte_thash_complete_matrix()) and applies it to eight input
+ * bytes with a single GF2P8AFFINEQB. The matrix for key position p
+ * produces hash byte m out of tuple byte (p - m), so lane l of a chunk
+ * starting at p0 has to hold tuple bytes p0 + l - [0..3] in its low half
+ * (first tuple) and its high half (second tuple).
+ *
+ * The tuple window is loaded from p0 - 8 and broadcast to all 128-bit
+ * lanes, so lane l needs bytes 8 + l - m of the window.
+ */
+#define THASH_IDX(l, m)		(8 + (l) - (m))
+#define THASH_LANE_A(l)		THASH_IDX(l, 0), THASH_IDX(l, 1), \
+				THASH_IDX(l, 2), THASH_IDX(l, 3), \
+				0x80, 0x80, 0x80, 0x80
+#define THASH_LANE_B(l)		0x80, 0x80, 0x80, 0x80, \
+				THASH_IDX(l, 0), THASH_IDX(l, 1), \
+				THASH_IDX(l, 2), THASH_IDX(l, 3)
+
+static const uint8_t thash_shuf_a[64] __rte_aligned(64) = {
+	THASH_LANE_A(0), THASH_LANE_A(1), THASH_LANE_A(2), THASH_LANE_A(3),
+	THASH_LANE_A(4), THASH_LANE_A(5), THASH_LANE_A(6), THASH_LANE_A(7),
+};
+
+static const uint8_t thash_shuf_b[64] __rte_aligned(64) = {
+	THASH_LANE_B(0), THASH_LANE_B(1), THASH_LANE_B(2), THASH_LANE_B(3),
+	THASH_LANE_B(4), THASH_LANE_B(5), THASH_LANE_B(6), THASH_LANE_B(7),
+};
+
+/* load the 16-byte window [p0 - 8, p0 + 8) of the tuple */
+static __rte_always_inline __m512i
+thash_load_window(const uint8_t *tuple, int len, int p0)
+{
+	__m512i w;
+	int n;
+
+	if (p0 == 0) {
+		n = RTE_MIN(len, 8);
+		w = _mm512_maskz_loadu_epi8((1ULL << n) - 1, tuple);
+		w = _mm512_castsi128_si512(
+			_mm_slli_si128(_mm512_castsi512_si128(w), 8));
+	} else {
+		n = RTE_MIN(len - p0 + 8, 16);
+		if (n <= 0)
+			return _mm512_setzero_si512();
+		w = _mm512_maskz_loadu_epi8((1ULL << n) - 1, tuple + p0 - 8);
+	}
+
+	return _mm512_broadcast_i32x4(_mm512_castsi512_si128(w));
+}
+
+uint64_t
+thash_gfni_x2_avx512(const uint64_t *mtrx, int len,
+	const uint8_t *tuple_a, const uint8_t *tuple_b)
+{
+	const __m512i shuf_a = _mm512_load_si512(thash_shuf_a);
+	const __m512i shuf_b = _mm512_load_si512(thash_shuf_b);
+	__m512i acc = _mm512_setzero_si512();
+	__m512i m, in;
+	__m256i r256;
+	__m128i r128;
+	int p0, rest;
+
+	/* hash byte 3 of the last tuple byte uses matrix len + 2 */
+	for (p0 = 0; p0 < len + 3; p0 += 8) {
+		rest = len + 3 - p0;
+		m = _mm512_maskz_loadu_epi64(rest >= 8 ? 0xff :
+			(1 << rest) - 1, mtrx + p0);
+
+		in = _mm512_shuffle_epi8(
+			thash_load_window(tuple_a, len, p0), shuf_a);
+		if (tuple_b != NULL)
+			in = _mm512_or_si512(in, _mm512_shuffle_epi8(
+				thash_load_window(tuple_b, len, p0), shuf_b));
+
+		acc = _mm512_xor_si512(acc,
+			_mm512_gf2p8affine_epi64_epi8(in, m, 0));
+	}
+
+	/* XOR all the lanes together */
+	r256 = _mm256_xor_si256(_mm512_castsi512_si256(acc),
+		_mm512_extracti64x4_epi64(acc, 1));
+	r128 = _mm_xor_si128(_mm256_castsi256_si128(r256),
+		_mm256_extracti128_si256(r256, 1));
+	r128 = _mm_xor_si128(r128, _mm_unpackhi_epi64(r128, r128));
+
+	return (uint64_t)_mm_cvtsi128_si64(r128);
+}
+
+void
+thash_gfni_bulk_avx512(const uint64_t *mtrx, int len, uint8_t *tuple[],
+	uint32_t val[], uint32_t num)
+{
+	uint64_t r;
+	uint32_t i;
+
+	for (i = 0; i + 1 < num; i += 2) {
+		r = thash_gfni_x2_avx512(mtrx, len, tuple[i], tuple[i + 1]);
+		val[i] = rte_be_to_cpu_32((uint32_t)r);
+		val[i + 1] = rte_be_to_cpu_32((uint32_t)(r >> 32));
+	}
+
+	if (i < num) {
+		r = thash_gfni_x2_avx512(mtrx, len, tuple[i], NULL);
+		val[i] = rte_be_to_cpu_32((uint32_t)r);
+	}
+}
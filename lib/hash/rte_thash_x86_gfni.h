@@ -0,0 +1,25 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#ifndef _RTE_THASH_X86_GFNI_H_
+#define _RTE_THASH_X86_GFNI_H_
+
+/**
+ * @file
+ *
+ * Internal definitions for the AVX512/GFNI Toeplitz hash implementation.
+ * Not to be included by applications.
+ */
+
+#include <stdint.h>
+
+uint64_t
+thash_gfni_x2_avx512(const uint64_t *mtrx, int len,
+	const uint8_t *tuple_a, const uint8_t *tuple_b);
+
+void
+thash_gfni_bulk_avx512(const uint64_t *mtrx, int len, uint8_t *tuple[],
+	uint32_t val[], uint32_t num);
+
+#endif /* _RTE_THASH_X86_GFNI_H_ */
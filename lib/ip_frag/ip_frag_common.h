@@ -17,6 +17,9 @@
 #define IPV4_KEYLEN 1
 #define IPV6_KEYLEN 4
 
+/* number of indirect buffers taken at once by the bulk fragmentation */
+#define IP_FRAG_IND_BULK 32
+
 /* helper macros */
 #define	IP_FRAG_MBUF2DR(dr, mb)	((dr)->row[(dr)->cnt++] = (mb))
 
@@ -44,6 +47,34 @@ struct ip_frag_pkt * ip_frag_lookup(struct rte_ip_frag_tbl *tbl,
 	const struct ip_frag_key *key, uint64_t tms,
 	struct ip_frag_pkt **free, struct ip_frag_pkt **stale);
 
+struct ip_frag_pkt * ip_frag_find_sig(struct rte_ip_frag_tbl *tbl,
+		struct rte_ip_frag_death_row *dr,
+		const struct ip_frag_key *key, uint64_t tms,
+		uint32_t sig1, uint32_t sig2);
+
+void ip_frag_key_hash(const struct ip_frag_key *key, uint32_t *sig1,
+		uint32_t *sig2);
+
+void ip_frag_bucket_prefetch(const struct rte_ip_frag_tbl *tbl,
+		uint32_t sig1, uint32_t sig2);
+
+/* fragment of a burst, parsed and hashed ahead of its reassembly */
+struct ip_frag_bulk_ent {
+	struct ip_frag_key key;
+	struct rte_mbuf *mb;   /* NULL if already handled */
+	uint32_t sig1;
+	uint32_t sig2;
+	int32_t trim;
+	uint16_t ofs;
+	uint16_t len;
+	uint16_t more_frags;
+};
+
+uint16_t ip_frag_bulk_process(struct rte_ip_frag_tbl *tbl,
+		struct rte_ip_frag_death_row *dr,
+		struct ip_frag_bulk_ent *ent, uint32_t num, uint64_t tms,
+		struct rte_mbuf **out);
+
 /* these functions need to be declared here as ip_frag_process relies on them */
 struct rte_mbuf *ipv4_frag_reassemble(struct ip_frag_pkt *fp);
 struct rte_mbuf *ipv6_frag_reassemble(struct ip_frag_pkt *fp);
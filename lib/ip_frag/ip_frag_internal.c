@@ -6,6 +6,7 @@
 
 #include <rte_jhash.h>
 #include <rte_hash_crc.h>
+#include <rte_prefetch.h>
 
 #include "ip_frag_common.h"
 
@@ -214,28 +215,20 @@ ip_frag_process(struct ip_frag_pkt *fp, struct rte_ip_frag_death_row *dr,
 
 
 /*
- * Find an entry in the table for the corresponding fragment.
- * If such entry is not present, then allocate a new one.
- * If the entry is stale, then free and reuse it.
+ * Complete the find of an entry: if the lookup found no entry, then
+ * allocate a new one. If the entry is stale, then free and reuse it.
  */
-struct ip_frag_pkt *
-ip_frag_find(struct rte_ip_frag_tbl *tbl, struct rte_ip_frag_death_row *dr,
-	const struct ip_frag_key *key, uint64_t tms)
+static inline struct ip_frag_pkt *
+ip_frag_find_tail(struct rte_ip_frag_tbl *tbl, struct rte_ip_frag_death_row *dr,
+	const struct ip_frag_key *key, uint64_t tms, struct ip_frag_pkt *pkt,
+	struct ip_frag_pkt *free, struct ip_frag_pkt *stale)
 {
-	struct ip_frag_pkt *pkt, *free, *stale, *lru;
+	struct ip_frag_pkt *lru;
 	uint64_t max_cycles;
 
-	/*
-	 * Actually the two line below are totally redundant.
-	 * they are here, just to make gcc 4.6 happy.
-	 */
-	free = NULL;
-	stale = NULL;
 	max_cycles = tbl->max_cycles;
 
-	IP_FRAG_TBL_STAT_UPDATE(&tbl->stat, find_num, 1);
-
-	if ((pkt = ip_frag_lookup(tbl, key, tms, &free, &stale)) == NULL) {
+	if (pkt == NULL) {
 
 		/*timed-out entry, free and invalidate it*/
 		if (stale != NULL) {
@@ -280,15 +273,39 @@ ip_frag_find(struct rte_ip_frag_tbl *tbl, struct rte_ip_frag_death_row *dr,
 	return pkt;
 }
 
+/*
+ * Find an entry in the table for the corresponding fragment.
+ * If such entry is not present, then allocate a new one.
+ * If the entry is stale, then free and reuse it.
+ */
 struct ip_frag_pkt *
-ip_frag_lookup(struct rte_ip_frag_tbl *tbl,
-	const struct ip_frag_key *key, uint64_t tms,
-	struct ip_frag_pkt **free, struct ip_frag_pkt **stale)
+ip_frag_find(struct rte_ip_frag_tbl *tbl, struct rte_ip_frag_death_row *dr,
+	const struct ip_frag_key *key, uint64_t tms)
+{
+	struct ip_frag_pkt *pkt, *free, *stale;
+
+	/*
+	 * Actually the two line below are totally redundant.
+	 * they are here, just to make gcc 4.6 happy.
+	 */
+	free = NULL;
+	stale = NULL;
+
+	IP_FRAG_TBL_STAT_UPDATE(&tbl->stat, find_num, 1);
+
+	pkt = ip_frag_lookup(tbl, key, tms, &free, &stale);
+	return ip_frag_find_tail(tbl, dr, key, tms, pkt, free, stale);
+}
+
+static struct ip_frag_pkt *
+ip_frag_bucket_lookup(struct rte_ip_frag_tbl *tbl,
+	const struct ip_frag_key *key, uint64_t tms, uint32_t sig1,
+	uint32_t sig2, struct ip_frag_pkt **free, struct ip_frag_pkt **stale)
 {
 	struct ip_frag_pkt *p1, *p2;
 	struct ip_frag_pkt *empty, *old;
 	uint64_t max_cycles;
-	uint32_t i, assoc, sig1, sig2;
+	uint32_t i, assoc;
 
 	empty = NULL;
 	old = NULL;
@@ -296,15 +313,6 @@ ip_frag_lookup(struct rte_ip_frag_tbl *tbl,
 	max_cycles = tbl->max_cycles;
 	assoc = tbl->bucket_entries;
 
-	if (tbl->last != NULL && ip_frag_key_cmp(key, &tbl->last->key) == 0)
-		return tbl->last;
-
-	/* different hashing methods for IPv4 and IPv6 */
-	if (key->key_len == IPV4_KEYLEN)
-		ipv4_frag_hash(key, &sig1, &sig2);
-	else
-		ipv6_frag_hash(key, &sig1, &sig2);
-
 	p1 = IP_FRAG_TBL_POS(tbl, sig1);
 	p2 = IP_FRAG_TBL_POS(tbl, sig2);
 
@@ -366,3 +374,104 @@ ip_frag_lookup(struct rte_ip_frag_tbl *tbl,
 	*stale = old;
 	return NULL;
 }
+
+struct ip_frag_pkt *
+ip_frag_lookup(struct rte_ip_frag_tbl *tbl,
+	const struct ip_frag_key *key, uint64_t tms,
+	struct ip_frag_pkt **free, struct ip_frag_pkt **stale)
+{
+	uint32_t sig1, sig2;
+
+	if (tbl->last != NULL && ip_frag_key_cmp(key, &tbl->last->key) == 0)
+		return tbl->last;
+
+	ip_frag_key_hash(key, &sig1, &sig2);
+
+	return ip_frag_bucket_lookup(tbl, key, tms, sig1, sig2, free, stale);
+}
+
+/*
+ * Same as ip_frag_find(), with the signatures of the key already computed
+ * by ip_frag_key_hash().
+ */
+struct ip_frag_pkt *
+ip_frag_find_sig(struct rte_ip_frag_tbl *tbl, struct rte_ip_frag_death_row *dr,
+	const struct ip_frag_key *key, uint64_t tms, uint32_t sig1,
+	uint32_t sig2)
+{
+	struct ip_frag_pkt *pkt, *free, *stale;
+
+	free = NULL;
+	stale = NULL;
+
+	IP_FRAG_TBL_STAT_UPDATE(&tbl->stat, find_num, 1);
+
+	if (tbl->last != NULL && ip_frag_key_cmp(key, &tbl->last->key) == 0)
+		pkt = tbl->last;
+	else
+		pkt = ip_frag_bucket_lookup(tbl, key, tms, sig1, sig2,
+				&free, &stale);
+	return ip_frag_find_tail(tbl, dr, key, tms, pkt, free, stale);
+}
+
+void
+ip_frag_key_hash(const struct ip_frag_key *key, uint32_t *sig1,
+	uint32_t *sig2)
+{
+	/* different hashing methods for IPv4 and IPv6 */
+	if (key->key_len == IPV4_KEYLEN)
+		ipv4_frag_hash(key, sig1, sig2);
+	else
+		ipv6_frag_hash(key, sig1, sig2);
+}
+
+void
+ip_frag_bucket_prefetch(const struct rte_ip_frag_tbl *tbl, uint32_t sig1,
+	uint32_t sig2)
+{
+	rte_prefetch0(IP_FRAG_TBL_POS(tbl, sig1));
+	rte_prefetch0(IP_FRAG_TBL_POS(tbl, sig2));
+}
+
+/*
+ * Second stage of the bulk reassembly: the fragments are parsed, and their
+ * buckets are being prefetched. Process them one by one, as done by
+ * rte_ipv4_frag_reassemble_packet() and rte_ipv6_frag_reassemble_packet().
+ */
+uint16_t
+ip_frag_bulk_process(struct rte_ip_frag_tbl *tbl,
+	struct rte_ip_frag_death_row *dr, struct ip_frag_bulk_ent *ent,
+	uint32_t num, uint64_t tms, struct rte_mbuf **out)
+{
+	struct ip_frag_pkt *fp;
+	struct rte_mbuf *mb;
+	uint32_t i;
+	uint16_t nb_out = 0;
+
+	for (i = 0; i != num; i++) {
+		mb = ent[i].mb;
+		if (mb == NULL)
+			continue;
+
+		if (unlikely(ent[i].trim > 0))
+			rte_pktmbuf_trim(mb, ent[i].trim);
+
+		/* try to find/add entry into the fragment's table. */
+		fp = ip_frag_find_sig(tbl, dr, &ent[i].key, tms,
+				ent[i].sig1, ent[i].sig2);
+		if (fp == NULL) {
+			IP_FRAG_MBUF2DR(dr, mb);
+			continue;
+		}
+
+		/* process the fragmented packet. */
+		mb = ip_frag_process(fp, dr, mb, ent[i].ofs, ent[i].len,
+				ent[i].more_frags);
+		ip_frag_inuse(tbl, fp);
+
+		if (mb != NULL)
+			out[nb_out++] = mb;
+	}
+
+	return nb_out;
+}
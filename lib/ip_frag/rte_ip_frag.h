@@ -174,6 +174,47 @@ rte_ipv6_fragment_packet(struct rte_mbuf *pkt_in,
 		struct rte_mempool *pool_direct,
 		struct rte_mempool *pool_indirect);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * IPv6 fragmentation with bulk allocation of the output buffers.
+ *
+ * This function produces the same fragments as
+ * rte_ipv6_fragment_packet(), but knowing the number of fragments
+ * upfront, it takes all their direct buffers from pool_direct with a single
+ * bulk get and the indirect buffers by bulks. The fragment header is built
+ * once and copied to each fragment.
+ * Since the direct buffers are all allocated at once, it fails with -ENOMEM
+ * as soon as pool_direct does not hold enough of them for all the fragments.
+ *
+ * @param pkt_in
+ *   The input packet.
+ * @param pkts_out
+ *   Array storing the output fragments.
+ * @param nb_pkts_out
+ *   Number of fragments.
+ * @param mtu_size
+ *   Size in bytes of the Maximum Transfer Unit (MTU) for the outgoing IPv6
+ *   datagrams. This value includes the size of the IPv6 header.
+ * @param pool_direct
+ *   MBUF pool used for allocating direct buffers for the output fragments.
+ * @param pool_indirect
+ *   MBUF pool used for allocating indirect buffers for the output fragments.
+ * @return
+ *   Upon successful completion - number of output fragments placed
+ *   in the pkts_out array.
+ *   Otherwise - (-1) * errno.
+ */
+__rte_experimental
+int32_t
+rte_ipv6_fragment_packet_bulk_alloc(struct rte_mbuf *pkt_in,
+		struct rte_mbuf **pkts_out,
+		uint16_t nb_pkts_out,
+		uint16_t mtu_size,
+		struct rte_mempool *pool_direct,
+		struct rte_mempool *pool_indirect);
+
 /**
  * This function implements reassembly of fragmented IPv6 packets.
  * Incoming mbuf should have its l2_len/l3_len fields setup correctly.
@@ -200,6 +241,41 @@ struct rte_mbuf *rte_ipv6_frag_reassemble_packet(struct rte_ip_frag_tbl *tbl,
 		struct rte_mbuf *mb, uint64_t tms, struct rte_ipv6_hdr *ip_hdr,
 		struct ipv6_extension_fragment *frag_hdr);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * This function implements reassembly of a burst of IPv6 packets.
+ * The keys of all the fragments of the burst are computed and their hash
+ * table buckets prefetched before the fragments are processed, as by
+ * rte_ipv6_frag_reassemble_packet().
+ * Incoming mbufs should have their l2_len/l3_len fields setup correctly.
+ * Packets which are not fragments are returned unchanged in the out array.
+ *
+ * @param tbl
+ *   Table where to lookup/add the fragmented packets.
+ * @param dr
+ *   Death row to free buffers to.
+ * @param mbs
+ *   Array of incoming mbufs with IPv6 packets.
+ * @param nb_pkts
+ *   Number of mbufs in the mbs array. To make sure the death row does not
+ *   overflow, it should not exceed IP_FRAG_DEATH_ROW_LEN and the death row
+ *   should be freed between calls.
+ * @param tms
+ *   Packets arrival timestamp.
+ * @param out
+ *   Array where the reassembled packets and the unfragmented packets are
+ *   stored. It should have room for nb_pkts mbufs.
+ * @return
+ *   Number of packets stored in the out array.
+ */
+__rte_experimental
+uint16_t
+rte_ipv6_frag_reassemble_bulk(struct rte_ip_frag_tbl *tbl,
+		struct rte_ip_frag_death_row *dr, struct rte_mbuf **mbs,
+		uint16_t nb_pkts, uint64_t tms, struct rte_mbuf **out);
+
 /**
  * Return a pointer to the packet's fragment header, if found.
  * It only looks at the extension header that's right after the fixed IPv6
@@ -250,6 +326,47 @@ int32_t rte_ipv4_fragment_packet(struct rte_mbuf *pkt_in,
 			struct rte_mempool *pool_direct,
 			struct rte_mempool *pool_indirect);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * IPv4 fragmentation with bulk allocation of the output buffers.
+ *
+ * This function produces the same fragments as
+ * rte_ipv4_fragment_packet(), but knowing the number of fragments
+ * upfront, it takes all their direct buffers from pool_direct with a single
+ * bulk get and the indirect buffers by bulks. The fragment header is built
+ * once and copied to each fragment.
+ * Since the direct buffers are all allocated at once, it fails with -ENOMEM
+ * as soon as pool_direct does not hold enough of them for all the fragments.
+ *
+ * @param pkt_in
+ *   The input packet.
+ * @param pkts_out
+ *   Array storing the output fragments.
+ * @param nb_pkts_out
+ *   Number of fragments.
+ * @param mtu_size
+ *   Size in bytes of the Maximum Transfer Unit (MTU) for the outgoing IPv4
+ *   datagrams. This value includes the size of the IPv4 header.
+ * @param pool_direct
+ *   MBUF pool used for allocating direct buffers for the output fragments.
+ * @param pool_indirect
+ *   MBUF pool used for allocating indirect buffers for the output fragments.
+ * @return
+ *   Upon successful completion - number of output fragments placed
+ *   in the pkts_out array.
+ *   Otherwise - (-1) * errno.
+ */
+__rte_experimental
+int32_t
+rte_ipv4_fragment_packet_bulk_alloc(struct rte_mbuf *pkt_in,
+		struct rte_mbuf **pkts_out,
+		uint16_t nb_pkts_out,
+		uint16_t mtu_size,
+		struct rte_mempool *pool_direct,
+		struct rte_mempool *pool_indirect);
+
 /**
  * This function implements reassembly of fragmented IPv4 packets.
  * Incoming mbufs should have its l2_len/l3_len fields setup correctly.
@@ -273,6 +390,41 @@ struct rte_mbuf * rte_ipv4_frag_reassemble_packet(struct rte_ip_frag_tbl *tbl,
 		struct rte_ip_frag_death_row *dr,
 		struct rte_mbuf *mb, uint64_t tms, struct rte_ipv4_hdr *ip_hdr);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * This function implements reassembly of a burst of IPv4 packets.
+ * The keys of all the fragments of the burst are computed and their hash
+ * table buckets prefetched before the fragments are processed, as by
+ * rte_ipv4_frag_reassemble_packet().
+ * Incoming mbufs should have their l2_len/l3_len fields setup correctly.
+ * Packets which are not fragments are returned unchanged in the out array.
+ *
+ * @param tbl
+ *   Table where to lookup/add the fragmented packets.
+ * @param dr
+ *   Death row to free buffers to.
+ * @param mbs
+ *   Array of incoming mbufs with IPv4 packets.
+ * @param nb_pkts
+ *   Number of mbufs in the mbs array. To make sure the death row does not
+ *   overflow, it should not exceed IP_FRAG_DEATH_ROW_LEN and the death row
+ *   should be freed between calls.
+ * @param tms
+ *   Packets arrival timestamp.
+ * @param out
+ *   Array where the reassembled packets and the unfragmented packets are
+ *   stored. It should have room for nb_pkts mbufs.
+ * @return
+ *   Number of packets stored in the out array.
+ */
+__rte_experimental
+uint16_t
+rte_ipv4_frag_reassemble_bulk(struct rte_ip_frag_tbl *tbl,
+		struct rte_ip_frag_death_row *dr, struct rte_mbuf **mbs,
+		uint16_t nb_pkts, uint64_t tms, struct rte_mbuf **out);
+
 /**
  * Check if the IPv4 packet is fragmented
  *
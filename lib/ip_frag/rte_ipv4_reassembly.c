@@ -171,3 +171,68 @@ rte_ipv4_frag_reassemble_packet(struct rte_ip_frag_tbl *tbl,
 
 	return mb;
 }
+
+uint16_t
+rte_ipv4_frag_reassemble_bulk(struct rte_ip_frag_tbl *tbl,
+	struct rte_ip_frag_death_row *dr, struct rte_mbuf **mbs,
+	uint16_t nb_pkts, uint64_t tms, struct rte_mbuf **out)
+{
+	struct ip_frag_bulk_ent ent[IP_FRAG_DEATH_ROW_LEN];
+	struct rte_ipv4_hdr *ip_hdr;
+	struct rte_mbuf *mb;
+	const unaligned_uint64_t *psd;
+	uint16_t flag_offset;
+	uint32_t i, n;
+	int32_t ip_len;
+	uint16_t nb_out = 0;
+
+	for (; nb_pkts != 0; mbs += n, nb_pkts -= n) {
+		n = RTE_MIN(nb_pkts, IP_FRAG_DEATH_ROW_LEN);
+
+		/* compute the keys and prefetch their buckets */
+		for (i = 0; i != n; i++) {
+			mb = mbs[i];
+			ip_hdr = rte_pktmbuf_mtod_offset(mb,
+					struct rte_ipv4_hdr *, mb->l2_len);
+			ent[i].mb = NULL;
+
+			if (!rte_ipv4_frag_pkt_is_fragmented(ip_hdr)) {
+				out[nb_out++] = mb;
+				continue;
+			}
+
+			ip_len = rte_be_to_cpu_16(ip_hdr->total_length) -
+					mb->l3_len;
+			/* check that fragment length is greater then zero. */
+			if (ip_len <= 0) {
+				IP_FRAG_MBUF2DR(dr, mb);
+				continue;
+			}
+
+			flag_offset = rte_be_to_cpu_16(ip_hdr->fragment_offset);
+			psd = (unaligned_uint64_t *)&ip_hdr->src_addr;
+			/* use first 8 bytes only */
+			ent[i].key.src_dst[0] = psd[0];
+			ent[i].key.id = ip_hdr->packet_id;
+			ent[i].key.key_len = IPV4_KEYLEN;
+			ent[i].ofs = (uint16_t)(flag_offset &
+					RTE_IPV4_HDR_OFFSET_MASK) *
+					RTE_IPV4_HDR_OFFSET_UNITS;
+			ent[i].len = ip_len;
+			ent[i].more_frags = (uint16_t)(flag_offset &
+					RTE_IPV4_HDR_MF_FLAG);
+			ent[i].trim = mb->pkt_len -
+					(ip_len + mb->l3_len + mb->l2_len);
+			ent[i].mb = mb;
+
+			ip_frag_key_hash(&ent[i].key, &ent[i].sig1,
+					&ent[i].sig2);
+			ip_frag_bucket_prefetch(tbl, ent[i].sig1, ent[i].sig2);
+		}
+
+		nb_out += ip_frag_bulk_process(tbl, dr, ent, n, tms,
+				&out[nb_out]);
+	}
+
+	return nb_out;
+}
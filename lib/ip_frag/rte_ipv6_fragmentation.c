@@ -193,3 +193,141 @@ rte_ipv6_fragment_packet(struct rte_mbuf *pkt_in,
 
 	return out_pkt_pos;
 }
+
+/*
+ * Same as rte_ipv6_fragment_packet(), the buffers being taken from the pools
+ * with bulk gets: all the direct buffers at once, the indirect buffers by
+ * bulks of IP_FRAG_IND_BULK. The IPv6 and fragment headers are built once
+ * into a template which is then copied to each fragment, only the payload
+ * length and the fragment offset being patched.
+ */
+int32_t
+rte_ipv6_fragment_packet_bulk_alloc(struct rte_mbuf *pkt_in,
+	struct rte_mbuf **pkts_out,
+	uint16_t nb_pkts_out,
+	uint16_t mtu_size,
+	struct rte_mempool *pool_direct,
+	struct rte_mempool *pool_indirect)
+{
+	struct rte_mbuf *ind[IP_FRAG_IND_BULK];
+	struct {
+		struct rte_ipv6_hdr hdr;
+		struct ipv6_extension_fragment fh;
+	} __rte_packed tmpl;
+	const uint32_t header_len = sizeof(tmpl);
+	struct rte_ipv6_hdr *in_hdr;
+	struct rte_mbuf *in_seg;
+	uint32_t out_pkt_pos, in_seg_data_pos, nb_frags;
+	uint32_t ind_pos, ind_num, ind_left;
+	uint32_t payload_len;
+	uint16_t fragment_offset, frag_size;
+	uint64_t frag_bytes_remaining;
+
+	/*
+	 * Formal parameter checking.
+	 */
+	if (unlikely(pkt_in == NULL) || unlikely(pkts_out == NULL) ||
+	    unlikely(nb_pkts_out == 0) ||
+	    unlikely(pool_direct == NULL) || unlikely(pool_indirect == NULL) ||
+	    unlikely(mtu_size < RTE_IPV6_MIN_MTU))
+		return -EINVAL;
+
+	frag_size = mtu_size - header_len;
+	frag_size = RTE_ALIGN_FLOOR(frag_size, RTE_IPV6_EHDR_FO_ALIGN);
+
+	/* Check that pkts_out is big enough to hold all fragments */
+	payload_len = (uint16_t)(pkt_in->pkt_len - sizeof(struct rte_ipv6_hdr));
+	nb_frags = RTE_MAX((payload_len + frag_size - 1) / frag_size, 1U);
+	if (unlikely(nb_frags > nb_pkts_out))
+		return -EINVAL;
+
+	if (unlikely(rte_pktmbuf_alloc_bulk(pool_direct, pkts_out,
+			nb_frags) != 0))
+		return -ENOMEM;
+
+	in_hdr = rte_pktmbuf_mtod(pkt_in, struct rte_ipv6_hdr *);
+	__fill_ipv6hdr_frag(&tmpl.hdr, in_hdr, 0, 0, 0);
+
+	/* Each output segment ends a fragment or an input segment */
+	ind_left = nb_frags + pkt_in->nb_segs - 1;
+	ind_pos = 0;
+	ind_num = 0;
+
+	in_seg = pkt_in;
+	in_seg_data_pos = sizeof(struct rte_ipv6_hdr);
+	fragment_offset = 0;
+
+	for (out_pkt_pos = 0; out_pkt_pos != nb_frags; out_pkt_pos++) {
+		struct rte_mbuf *out_pkt, *out_seg_prev;
+		struct rte_ipv6_hdr *out_hdr;
+		struct ipv6_extension_fragment *fh;
+		uint32_t mf;
+
+		out_pkt = pkts_out[out_pkt_pos];
+
+		/* Reserve space for the IP header that will be built later */
+		out_pkt->data_len = header_len;
+		out_pkt->pkt_len = header_len;
+		frag_bytes_remaining = frag_size;
+
+		out_seg_prev = out_pkt;
+		while (likely(frag_bytes_remaining != 0 && in_seg != NULL)) {
+			struct rte_mbuf *out_seg;
+			uint32_t len;
+
+			/* Refill the indirect buffers */
+			if (unlikely(ind_pos == ind_num)) {
+				ind_num = RTE_MIN(ind_left,
+					(uint32_t)IP_FRAG_IND_BULK);
+				if (unlikely(rte_pktmbuf_alloc_bulk(
+						pool_indirect, ind,
+						ind_num) != 0)) {
+					__free_fragments(pkts_out, nb_frags);
+					return -ENOMEM;
+				}
+				ind_left -= ind_num;
+				ind_pos = 0;
+			}
+			out_seg = ind[ind_pos++];
+			out_seg_prev->next = out_seg;
+			out_seg_prev = out_seg;
+
+			/* Prepare indirect buffer */
+			rte_pktmbuf_attach(out_seg, in_seg);
+			len = RTE_MIN(frag_bytes_remaining,
+				(uint64_t)(in_seg->data_len - in_seg_data_pos));
+			out_seg->data_off = in_seg->data_off + in_seg_data_pos;
+			out_seg->data_len = (uint16_t)len;
+			out_pkt->pkt_len += len;
+			out_pkt->nb_segs += 1;
+			in_seg_data_pos += len;
+			frag_bytes_remaining -= len;
+
+			/* Current input segment done ? */
+			if (unlikely(in_seg_data_pos == in_seg->data_len)) {
+				in_seg = in_seg->next;
+				in_seg_data_pos = 0;
+			}
+		}
+
+		/* Build the IP header from the template */
+		out_hdr = rte_pktmbuf_mtod(out_pkt, struct rte_ipv6_hdr *);
+		rte_memcpy(out_hdr, &tmpl, sizeof(tmpl));
+
+		mf = (out_pkt_pos + 1 != nb_frags);
+		out_hdr->payload_len = rte_cpu_to_be_16(out_pkt->pkt_len -
+		    sizeof(struct rte_ipv6_hdr));
+		fh = (struct ipv6_extension_fragment *)(out_hdr + 1);
+		fh->frag_data = rte_cpu_to_be_16(
+		    RTE_IPV6_SET_FRAG_DATA(fragment_offset, mf));
+
+		fragment_offset = (uint16_t)(fragment_offset +
+		    out_pkt->pkt_len - header_len);
+	}
+
+	/* Give back the indirect buffers left unused */
+	if (ind_pos != ind_num)
+		rte_pktmbuf_free_bulk(&ind[ind_pos], ind_num - ind_pos);
+
+	return nb_frags;
+}
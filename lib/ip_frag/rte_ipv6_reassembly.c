@@ -216,3 +216,70 @@ rte_ipv6_frag_reassemble_packet(struct rte_ip_frag_tbl *tbl,
 
 	return mb;
 }
+
+uint16_t
+rte_ipv6_frag_reassemble_bulk(struct rte_ip_frag_tbl *tbl,
+	struct rte_ip_frag_death_row *dr, struct rte_mbuf **mbs,
+	uint16_t nb_pkts, uint64_t tms, struct rte_mbuf **out)
+{
+	struct ip_frag_bulk_ent ent[IP_FRAG_DEATH_ROW_LEN];
+	struct ipv6_extension_fragment *frag_hdr;
+	struct rte_ipv6_hdr *ip_hdr;
+	struct rte_mbuf *mb;
+	uint32_t i, n;
+	int32_t ip_len;
+	uint16_t nb_out = 0;
+
+	for (; nb_pkts != 0; mbs += n, nb_pkts -= n) {
+		n = RTE_MIN(nb_pkts, IP_FRAG_DEATH_ROW_LEN);
+
+		/* compute the keys and prefetch their buckets */
+		for (i = 0; i != n; i++) {
+			mb = mbs[i];
+			ip_hdr = rte_pktmbuf_mtod_offset(mb,
+					struct rte_ipv6_hdr *, mb->l2_len);
+			ent[i].mb = NULL;
+
+			frag_hdr = rte_ipv6_frag_get_ipv6_fragment_header(
+					ip_hdr);
+			if (frag_hdr == NULL) {
+				out[nb_out++] = mb;
+				continue;
+			}
+
+			/*
+			 * as per RFC2460, payload length contains all
+			 * extension headers as well.
+			 */
+			ip_len = rte_be_to_cpu_16(ip_hdr->payload_len) -
+					sizeof(*frag_hdr);
+			/* check that fragment length is greater then zero. */
+			if (ip_len <= 0) {
+				IP_FRAG_MBUF2DR(dr, mb);
+				continue;
+			}
+
+			rte_memcpy(&ent[i].key.src_dst[0], ip_hdr->src_addr,
+					16);
+			rte_memcpy(&ent[i].key.src_dst[2], ip_hdr->dst_addr,
+					16);
+			ent[i].key.id = frag_hdr->id;
+			ent[i].key.key_len = IPV6_KEYLEN;
+			ent[i].ofs = FRAG_OFFSET(frag_hdr->frag_data) * 8;
+			ent[i].len = ip_len;
+			ent[i].more_frags = MORE_FRAGS(frag_hdr->frag_data);
+			ent[i].trim = mb->pkt_len -
+					(ip_len + mb->l3_len + mb->l2_len);
+			ent[i].mb = mb;
+
+			ip_frag_key_hash(&ent[i].key, &ent[i].sig1,
+					&ent[i].sig2);
+			ip_frag_bucket_prefetch(tbl, ent[i].sig1, ent[i].sig2);
+		}
+
+		nb_out += ip_frag_bulk_process(tbl, dr, ent, n, tms,
+				&out[nb_out]);
+	}
+
+	return nb_out;
+}
@@ -164,19 +164,14 @@ remove_sqh(void *picv, uint32_t icv_len)
 
 /*
  * setup crypto ops for LOOKASIDE_NONE (pure crypto) type of devices.
+ * The session dependent part of the op comes from a template built once
+ * per burst, the packet dependent part is then filled by the caller.
  */
 static inline void
 lksd_none_cop_prepare(struct rte_crypto_op *cop,
-	struct rte_cryptodev_sym_session *cs, struct rte_mbuf *mb)
+	const struct rte_crypto_op_tmpl *tmpl, struct rte_mbuf *mb)
 {
-	struct rte_crypto_sym_op *sop;
-
-	sop = cop->sym;
-	cop->type = RTE_CRYPTO_OP_TYPE_SYMMETRIC;
-	cop->status = RTE_CRYPTO_OP_STATUS_NOT_PROCESSED;
-	cop->sess_type = RTE_CRYPTO_OP_WITH_SESSION;
-	sop->m_src = mb;
-	__rte_crypto_sym_op_attach_sym_session(sop, cs);
+	rte_crypto_op_tmpl_apply(cop, tmpl, mb);
 }
 
 #endif /* _CRYPTO_H_ */
@@ -308,13 +308,13 @@ esp_inb_pkt_prepare(const struct rte_ipsec_session *ss, struct rte_mbuf *mb[],
 	int32_t rc;
 	uint32_t i, k, hl;
 	struct rte_ipsec_sa *sa;
-	struct rte_cryptodev_sym_session *cs;
+	struct rte_crypto_op_tmpl tmpl;
 	struct replay_sqn *rsn;
 	union sym_op_data icv;
 	uint32_t dr[num];
 
 	sa = ss->sa;
-	cs = ss->crypto.ses;
+	rte_crypto_op_tmpl_init(&tmpl, ss->crypto.ses);
 	rsn = rsn_acquire(sa);
 
 	k = 0;
@@ -323,7 +323,7 @@ esp_inb_pkt_prepare(const struct rte_ipsec_session *ss, struct rte_mbuf *mb[],
 		hl = mb[i]->l2_len + mb[i]->l3_len;
 		rc = inb_pkt_prepare(sa, rsn, mb[i], hl, &icv);
 		if (rc >= 0) {
-			lksd_none_cop_prepare(cop[k], cs, mb[i]);
+			lksd_none_cop_prepare(cop[k], &tmpl, mb[i]);
 			inb_cop_prepare(cop[k], sa, mb[i], &icv, hl, rc);
 			k++;
 		} else {
@@ -621,6 +621,90 @@ trs_process(const struct rte_ipsec_sa *sa, struct rte_mbuf *mb[],
 	return k;
 }
 
+/*
+ * for group of ESP inbound packets perform SQN check and lock-free update.
+ * The bits of consecutive packets of the same window block are merged, so
+ * that an in-order burst is set with one compare and swap per block.
+ */
+static inline uint16_t
+esp_inb_rsn_update_lf(struct rte_ipsec_sa *sa, const uint32_t sqn[],
+	uint32_t dr[], uint16_t num)
+{
+	uint32_t i, j, k, n;
+	uint64_t blk, bit, dup, mask, top, wtop;
+	struct replay_sqn *rsn;
+	uint64_t sqc[num];
+	uint8_t ok[num];
+
+	rsn = sa->sqn.inb.rsn[0];
+	wtop = __atomic_load_n(&rsn->sqn, __ATOMIC_RELAXED);
+	top = 0;
+
+	/* reconstruct the sqns, drop the ones before the window */
+	for (i = 0; i != num; i++) {
+		sqc[i] = rte_be_to_cpu_32(sqn[i]);
+		if (IS_ESN(sa))
+			sqc[i] = reconstruct_esn(wtop, sqc[i],
+				sa->replay.win_sz);
+		ok[i] = (sqc[i] != 0 && sqc[i] + sa->replay.win_sz >= wtop);
+		if (ok[i] != 0)
+			top = RTE_MAX(top, sqc[i]);
+	}
+
+	/* as if updated one by one, the burst moves the window forward */
+	for (i = 0; i != num; i++)
+		ok[i] = ok[i] && sqc[i] + sa->replay.win_sz >= top;
+	top = 0;
+
+	/* set the window bits, one block at a time */
+	for (i = 0; i != num; i = j) {
+		if (ok[i] == 0) {
+			j = i + 1;
+			continue;
+		}
+
+		blk = sqc[i] >> WINDOW_BUCKET_BITS;
+		mask = 0;
+		for (j = i; j != num; j++) {
+			if (ok[j] == 0)
+				continue;
+			if (sqc[j] >> WINDOW_BUCKET_BITS != blk)
+				break;
+
+			/* duplicate within the burst */
+			bit = (uint64_t)1 << (sqc[j] & WINDOW_BIT_LOC_MASK);
+			if (mask & bit)
+				ok[j] = 0;
+			mask |= bit;
+		}
+
+		dup = rsn_lf_bucket_update(rsn_lf_bucket(rsn, sa, blk), blk,
+			mask);
+
+		for (n = i; n != j; n++) {
+			if (ok[n] == 0)
+				continue;
+			bit = (uint64_t)1 << (sqc[n] & WINDOW_BIT_LOC_MASK);
+			if (dup & bit)
+				ok[n] = 0;
+			else
+				top = RTE_MAX(top, sqc[n]);
+		}
+	}
+
+	rsn_lf_update_top(rsn, top);
+
+	k = 0;
+	for (i = 0; i != num; i++) {
+		if (ok[i] != 0)
+			k++;
+		else
+			dr[i - k] = i;
+	}
+
+	return k;
+}
+
 /*
  * for group of ESP inbound packets perform SQN check and update.
  */
@@ -635,6 +719,9 @@ esp_inb_rsn_update(struct rte_ipsec_sa *sa, const uint32_t sqn[],
 	if (sa->replay.win_sz == 0)
 		return num;
 
+	if (SQN_LOCK_FREE(sa))
+		return esp_inb_rsn_update_lf(sa, sqn, dr, num);
+
 	rsn = rsn_update_start(sa);
 
 	k = 0;
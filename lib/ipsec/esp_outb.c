@@ -226,13 +226,13 @@ esp_outb_tun_prepare(const struct rte_ipsec_session *ss, struct rte_mbuf *mb[],
 	uint64_t sqn;
 	rte_be64_t sqc;
 	struct rte_ipsec_sa *sa;
-	struct rte_cryptodev_sym_session *cs;
+	struct rte_crypto_op_tmpl tmpl;
 	union sym_op_data icv;
 	uint64_t iv[IPSEC_MAX_IV_QWORD];
 	uint32_t dr[num];
 
 	sa = ss->sa;
-	cs = ss->crypto.ses;
+	rte_crypto_op_tmpl_init(&tmpl, ss->crypto.ses);
 
 	n = num;
 	sqn = esn_outb_update_sqn(sa, &n);
@@ -251,7 +251,7 @@ esp_outb_tun_prepare(const struct rte_ipsec_session *ss, struct rte_mbuf *mb[],
 		/* success, setup crypto op */
 		if (rc >= 0) {
 			outb_pkt_xprepare(sa, sqc, &icv);
-			lksd_none_cop_prepare(cop[k], cs, mb[i]);
+			lksd_none_cop_prepare(cop[k], &tmpl, mb[i]);
 			outb_cop_prepare(cop[k], sa, iv, &icv, 0, rc);
 			k++;
 		/* failure, put packet into the death-row */
@@ -366,13 +366,13 @@ esp_outb_trs_prepare(const struct rte_ipsec_session *ss, struct rte_mbuf *mb[],
 	uint64_t sqn;
 	rte_be64_t sqc;
 	struct rte_ipsec_sa *sa;
-	struct rte_cryptodev_sym_session *cs;
+	struct rte_crypto_op_tmpl tmpl;
 	union sym_op_data icv;
 	uint64_t iv[IPSEC_MAX_IV_QWORD];
 	uint32_t dr[num];
 
 	sa = ss->sa;
-	cs = ss->crypto.ses;
+	rte_crypto_op_tmpl_init(&tmpl, ss->crypto.ses);
 
 	n = num;
 	sqn = esn_outb_update_sqn(sa, &n);
@@ -394,7 +394,7 @@ esp_outb_trs_prepare(const struct rte_ipsec_session *ss, struct rte_mbuf *mb[],
 		/* success, setup crypto op */
 		if (rc >= 0) {
 			outb_pkt_xprepare(sa, sqc, &icv);
-			lksd_none_cop_prepare(cop[k], cs, mb[i]);
+			lksd_none_cop_prepare(cop[k], &tmpl, mb[i]);
 			outb_cop_prepare(cop[k], sa, iv, &icv, l2 + l3, rc);
 			k++;
 		/* failure, put packet into the death-row */
@@ -4,6 +4,7 @@
 
 #include <string.h>
 
+#include <rte_bitops.h>
 #include <rte_eal_memconfig.h>
 #include <rte_errno.h>
 #include <rte_hash.h>
@@ -451,8 +452,11 @@ rte_ipsec_sad_destroy(struct rte_ipsec_sad *sad)
  * If there is an entry for the corresponding SPI check its value.
  * Two least significant bits of the value indicate
  * the presence of more specific rule in other tables.
- * Perform additional lookup in corresponding hash tables
- * and update the value if lookup succeeded.
+ * Perform additional lookup in SPI_DIP_SIP table first, then in SPI_DIP
+ * table only for the keys not matched yet, and update the value
+ * if lookup succeeded.
+ * The key fields are contiguous and the hash is a CRC, so the signature
+ * of a more specific key continues the one of the shorter key.
  */
 static int
 __ipsec_sad_lookup(const struct rte_ipsec_sad *sad,
@@ -465,10 +469,11 @@ __ipsec_sad_lookup(const struct rte_ipsec_sad *sad,
 	uint32_t idx_2[RTE_HASH_LOOKUP_BULK_MAX];
 	uint32_t idx_3[RTE_HASH_LOOKUP_BULK_MAX];
 	uint64_t mask_1, mask_2, mask_3;
-	uint64_t map, map_spec;
+	uint64_t map, map_spec, hit_3;
 	uint32_t n_2 = 0;
 	uint32_t n_3 = 0;
-	uint32_t i;
+	uint32_t i, j, len_2, len_3;
+	uintptr_t bits;
 	int found = 0;
 	hash_sig_t hash_sig[RTE_HASH_LOOKUP_BULK_MAX];
 	hash_sig_t hash_sig_2[RTE_HASH_LOOKUP_BULK_MAX];
@@ -485,24 +490,36 @@ __ipsec_sad_lookup(const struct rte_ipsec_sad *sad,
 	 */
 	rte_hash_lookup_with_hash_bulk_data(sad->hash[RTE_IPSEC_SAD_SPI_ONLY],
 		(const void **)keys, hash_sig, n, &mask_1, sa);
+
+	len_2 = sad->keysize[RTE_IPSEC_SAD_SPI_DIP] -
+		sad->keysize[RTE_IPSEC_SAD_SPI_ONLY];
+	len_3 = sad->keysize[RTE_IPSEC_SAD_SPI_DIP_SIP] -
+		sad->keysize[RTE_IPSEC_SAD_SPI_DIP];
+	hit_3 = 0;
+
 	for (map = mask_1; map; map &= (map - 1)) {
 		i = rte_bsf64(map);
+		bits = (uintptr_t)GET_BIT(sa[i], RTE_IPSEC_SAD_KEY_TYPE_MASK);
+		if (bits == 0)
+			continue;
+
 		/*
 		 * if returned value indicates presence of a rule in other
 		 * tables save a key for further lookup.
 		 */
-		if ((uintptr_t)sa[i] & RTE_IPSEC_SAD_SPI_DIP_SIP) {
+		hash_sig_2[n_2] = rte_hash_crc((const uint8_t *)keys[i] +
+			sad->keysize[RTE_IPSEC_SAD_SPI_ONLY], len_2,
+			hash_sig[i]);
+		if (bits & RTE_IPSEC_SAD_SPI_DIP_SIP) {
 			idx_3[n_3] = i;
-			hash_sig_3[n_3] = rte_hash_crc(keys[i],
-				sad->keysize[RTE_IPSEC_SAD_SPI_DIP_SIP],
-				sad->init_val);
+			hash_sig_3[n_3] = rte_hash_crc(
+				(const uint8_t *)keys[i] +
+				sad->keysize[RTE_IPSEC_SAD_SPI_DIP], len_3,
+				hash_sig_2[n_2]);
 			keys_3[n_3++] = keys[i];
 		}
-		if ((uintptr_t)sa[i] & RTE_IPSEC_SAD_SPI_DIP) {
+		if (bits & RTE_IPSEC_SAD_SPI_DIP) {
 			idx_2[n_2] = i;
-			hash_sig_2[n_2] = rte_hash_crc(keys[i],
-				sad->keysize[RTE_IPSEC_SAD_SPI_DIP],
-				sad->init_val);
 			keys_2[n_2++] = keys[i];
 		}
 		/* clear 2 LSB's which indicate the presence
@@ -511,16 +528,6 @@ __ipsec_sad_lookup(const struct rte_ipsec_sad *sad,
 		sa[i] = CLEAR_BIT(sa[i], RTE_IPSEC_SAD_KEY_TYPE_MASK);
 	}
 
-	/* Lookup for more specific rules in SPI_DIP table */
-	if (n_2 != 0) {
-		rte_hash_lookup_with_hash_bulk_data(
-			sad->hash[RTE_IPSEC_SAD_SPI_DIP],
-			keys_2, hash_sig_2, n_2, &mask_2, vals_2);
-		for (map_spec = mask_2; map_spec; map_spec &= (map_spec - 1)) {
-			i = rte_bsf64(map_spec);
-			sa[idx_2[i]] = vals_2[i];
-		}
-	}
 	/* Lookup for more specific rules in SPI_DIP_SIP table */
 	if (n_3 != 0) {
 		rte_hash_lookup_with_hash_bulk_data(
@@ -529,6 +536,30 @@ __ipsec_sad_lookup(const struct rte_ipsec_sad *sad,
 		for (map_spec = mask_3; map_spec; map_spec &= (map_spec - 1)) {
 			i = rte_bsf64(map_spec);
 			sa[idx_3[i]] = vals_3[i];
+			hit_3 |= RTE_BIT64(idx_3[i]);
+		}
+	}
+
+	/*
+	 * Lookup for more specific rules in SPI_DIP table,
+	 * only for the keys without SPI_DIP_SIP match.
+	 */
+	for (i = 0, j = 0; i != n_2; i++) {
+		if ((hit_3 & RTE_BIT64(idx_2[i])) == 0) {
+			idx_2[j] = idx_2[i];
+			hash_sig_2[j] = hash_sig_2[i];
+			keys_2[j++] = keys_2[i];
+		}
+	}
+	n_2 = j;
+
+	if (n_2 != 0) {
+		rte_hash_lookup_with_hash_bulk_data(
+			sad->hash[RTE_IPSEC_SAD_SPI_DIP],
+			keys_2, hash_sig_2, n_2, &mask_2, vals_2);
+		for (map_spec = mask_2; map_spec; map_spec &= (map_spec - 1)) {
+			i = rte_bsf64(map_spec);
+			sa[idx_2[i]] = vals_2[i];
 		}
 	}
 
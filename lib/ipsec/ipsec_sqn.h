@@ -17,6 +17,17 @@
 
 #define	SQN_ATOMIC(sa)	((sa)->type & RTE_IPSEC_SATP_SQN_ATOM)
 
+/*
+ * With 128-bit compare and swap, the replay window of a SA shared by
+ * multiple threads is updated lock-free (see below), instead of through
+ * the two RSN copies.
+ */
+#if defined(RTE_ARCH_X86_64) || defined(RTE_ARCH_ARM64)
+#define	SQN_LOCK_FREE(sa)	SQN_ATOMIC(sa)
+#else
+#define	SQN_LOCK_FREE(sa)	0
+#endif
+
 /*
  * gets SQN.hi32 bits, SQN supposed to be in network byte order.
  */
@@ -80,6 +91,106 @@ reconstruct_esn(uint64_t t, uint32_t sqn, uint32_t w)
 	return (uint64_t)th << 32 | sqn;
 }
 
+/**
+ * Lock-free replay window.
+ *
+ * Each bucket is a pair of 64-bit words, updated together with a 128-bit
+ * compare and swap: the block number of the bucket (sqn >> WINDOW_BUCKET_BITS)
+ * and the bitmap of the sqns of that block already received. A bucket is
+ * taken over by a newer block on its first sqn, which implicitly clears the
+ * bits of the previous block: the window never has to be cleared when it
+ * slides, and as the block of a bucket only grows, a sqn is accepted once at
+ * most. The window top (rsn->sqn) is an atomic maximum. The buckets of the
+ * window take twice the memory of the regular ones, which fits in the two RSN
+ * copies allocated for the SA, not used in lock-free mode.
+ */
+static inline rte_int128_t *
+rsn_lf_bucket(const struct replay_sqn *rsn, const struct rte_ipsec_sa *sa,
+	uint64_t blk)
+{
+	return (rte_int128_t *)(uintptr_t)rsn->window +
+		(blk & sa->replay.bucket_index_mask);
+}
+
+/*
+ * Consistent read of the bitmap of a bucket for a block: the block number of
+ * a bucket only grows, so the bitmap read between two identical block numbers
+ * belongs to that block.
+ */
+static inline int32_t
+rsn_lf_check(const struct replay_sqn *rsn, const struct rte_ipsec_sa *sa,
+	uint64_t sqn)
+{
+	const rte_int128_t *b;
+	uint64_t blk, cur, bits;
+
+	blk = sqn >> WINDOW_BUCKET_BITS;
+	b = rsn_lf_bucket(rsn, sa, blk);
+
+	do {
+		cur = __atomic_load_n(&b->val[0], __ATOMIC_ACQUIRE);
+		bits = __atomic_load_n(&b->val[1], __ATOMIC_ACQUIRE);
+	} while (cur != __atomic_load_n(&b->val[0], __ATOMIC_ACQUIRE));
+
+	/* bucket taken over by a newer block: seq is outside window */
+	if (cur > blk)
+		return -EINVAL;
+
+	/* already seen packet */
+	if (cur == blk && (bits & ((uint64_t)1 << (sqn & WINDOW_BIT_LOC_MASK))))
+		return -EINVAL;
+
+	return 0;
+}
+
+/*
+ * Set the bits of *mask* in the bucket of block *blk*, returns the bits of
+ * the mask that were already set: all of them when the bucket was taken
+ * over by a newer block.
+ */
+static inline uint64_t
+rsn_lf_bucket_update(rte_int128_t *b, uint64_t blk, uint64_t mask)
+{
+	rte_int128_t exp, des;
+	uint64_t dup;
+
+	exp.val[0] = __atomic_load_n(&b->val[0], __ATOMIC_RELAXED);
+	exp.val[1] = __atomic_load_n(&b->val[1], __ATOMIC_RELAXED);
+
+	do {
+		if (exp.val[0] > blk)
+			return mask;
+
+		if (exp.val[0] == blk) {
+			dup = exp.val[1] & mask;
+			if (dup == mask)
+				return dup;
+			des.val[1] = exp.val[1] | mask;
+		} else {
+			dup = 0;
+			des.val[1] = mask;
+		}
+		des.val[0] = blk;
+	} while (rte_atomic128_cmp_exchange(b, &exp, &des, 0,
+			__ATOMIC_ACQ_REL, __ATOMIC_RELAXED) == 0);
+
+	return dup;
+}
+
+/*
+ * Raise the window top to *sqn*, unless another thread raised it further.
+ */
+static inline void
+rsn_lf_update_top(struct replay_sqn *rsn, uint64_t sqn)
+{
+	uint64_t cur;
+
+	cur = __atomic_load_n(&rsn->sqn, __ATOMIC_RELAXED);
+	while (sqn > cur && __atomic_compare_exchange_n(&rsn->sqn, &cur, sqn,
+			0, __ATOMIC_RELEASE, __ATOMIC_RELAXED) == 0)
+		;
+}
+
 /**
  * Perform the replay checking.
  *
@@ -107,6 +218,9 @@ esn_inb_check_sqn(const struct replay_sqn *rsn, const struct rte_ipsec_sa *sa,
 	if (sqn == 0 || sqn + sa->replay.win_sz < rsn->sqn)
 		return -EINVAL;
 
+	if (SQN_LOCK_FREE(sa))
+		return rsn_lf_check(rsn, sa, sqn);
+
 	/* seq is inside the window */
 	bit = sqn & WINDOW_BIT_LOC_MASK;
 	bucket = (sqn >> WINDOW_BUCKET_BITS) & sa->replay.bucket_index_mask;
@@ -235,7 +349,7 @@ rsn_acquire(struct rte_ipsec_sa *sa)
 	n = sa->sqn.inb.rdidx;
 	rsn = sa->sqn.inb.rsn[n];
 
-	if (!SQN_ATOMIC(sa))
+	if (!SQN_ATOMIC(sa) || SQN_LOCK_FREE(sa))
 		return rsn;
 
 	/* check there are no writers */
@@ -255,7 +369,7 @@ rsn_acquire(struct rte_ipsec_sa *sa)
 static inline void
 rsn_release(struct rte_ipsec_sa *sa, struct replay_sqn *rsn)
 {
-	if (SQN_ATOMIC(sa))
+	if (SQN_ATOMIC(sa) && !SQN_LOCK_FREE(sa))
 		rte_rwlock_read_unlock(&rsn->rwl);
 }
 
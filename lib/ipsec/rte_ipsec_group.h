@@ -143,6 +143,91 @@ rte_ipsec_pkt_crypto_group(const struct rte_crypto_op *cop[],
 	return n;
 }
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Group a burst of packets by the rte_ipsec_session they belong to,
+ * as found by a SAD lookup. The packets of a group keep their order
+ * in the burst, and the groups are ordered by their first packet.
+ * Note that mbufs with undetermined session (NULL) are placed
+ * beyond mbufs for the last group.
+ * It is a user responsibility to handle them further.
+ * @param ss
+ *   The address of an array of *num* pointers to the sessions
+ *   of the packets, NULL for a packet without session.
+ * @param mb
+ *   The address of an array of *num* pointers to *rte_mbuf* structures,
+ *   reordered by the function.
+ * @param grp
+ *   The address of an array of *num* to output *rte_ipsec_group* structures.
+ * @param num
+ *   The maximum number of packets to process.
+ * @return
+ *   Number of filled elements in *grp* array.
+ */
+__rte_experimental
+uint16_t
+rte_ipsec_pkt_ses_group(struct rte_ipsec_session *ss[], struct rte_mbuf *mb[],
+	struct rte_ipsec_group grp[], uint16_t num);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Group a burst of packets with mixed sessions (see
+ * *rte_ipsec_pkt_ses_group*) and prepare crypto ops for each group
+ * (see *rte_ipsec_pkt_crypto_prepare*).
+ * The crypto ops of a group start at the same index in *cop*
+ * as its mbufs in *mb*, i.e. at cop + (grp[i].m - mb).
+ * On return, grp[i].cnt is the number of prepared crypto ops of the group
+ * and grp[i].rc is zero, or a negative error code when some of its mbufs
+ * failed: these are not freed, but are placed right after the *cnt* valid
+ * ones, up to the start of the next group.
+ * @param ss
+ *   The address of an array of *num* pointers to the sessions
+ *   of the packets, NULL for a packet without session.
+ * @param mb
+ *   The address of an array of *num* pointers to *rte_mbuf* structures,
+ *   reordered by the function.
+ * @param cop
+ *   The address of an array of *num* pointers to the output *rte_crypto_op*
+ *   structures.
+ * @param grp
+ *   The address of an array of *num* to output *rte_ipsec_group* structures.
+ * @param num
+ *   The maximum number of packets to process.
+ * @return
+ *   Number of filled elements in *grp* array.
+ */
+__rte_experimental
+uint16_t
+rte_ipsec_pkt_crypto_prepare_bulk(struct rte_ipsec_session *ss[],
+	struct rte_mbuf *mb[], struct rte_crypto_op *cop[],
+	struct rte_ipsec_group grp[], uint16_t num);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Process the packets of each group, as filled by
+ * *rte_ipsec_pkt_crypto_group* or *rte_ipsec_pkt_ses_group*
+ * (see *rte_ipsec_pkt_process*).
+ * On return, grp[i].cnt is the number of successfully processed packets
+ * of the group and grp[i].rc is zero, or a negative error code when some
+ * of its mbufs failed: these are not freed, but are placed right after
+ * the *cnt* valid ones.
+ * @param grp
+ *   The address of an array of *num* *rte_ipsec_group* structures.
+ * @param num
+ *   The number of groups to process.
+ * @return
+ *   Number of successfully processed packets, in all the groups.
+ */
+__rte_experimental
+uint16_t
+rte_ipsec_pkt_process_bulk(struct rte_ipsec_group grp[], uint16_t num);
+
 #ifdef __cplusplus
 }
 #endif
@@ -2,6 +2,7 @@
  * Copyright(c) 2018-2020 Intel Corporation
  */
 
+#include <rte_errno.h>
 #include <rte_ipsec.h>
 #include "sa.h"
 
@@ -51,3 +52,103 @@ rte_ipsec_session_prepare(struct rte_ipsec_session *ss)
 
 	return 0;
 }
+
+uint16_t
+rte_ipsec_pkt_ses_group(struct rte_ipsec_session *ss[], struct rte_mbuf *mb[],
+	struct rte_ipsec_group grp[], uint16_t num)
+{
+	uint32_t i, j, k, n;
+	struct rte_ipsec_session *ps;
+	struct rte_mbuf *m[num];
+	uint16_t gi[num];
+
+	/*
+	 * first pass: give each packet the index of its session group,
+	 * consecutive packets of the same session skip the lookup.
+	 */
+	j = 0;
+	k = 0;
+	n = 0;
+	ps = NULL;
+
+	for (i = 0; i != num; i++) {
+
+		m[i] = mb[i];
+
+		/* no valid session found */
+		if (ss[i] == NULL) {
+			gi[i] = UINT16_MAX;
+			k++;
+			continue;
+		}
+
+		if (ss[i] != ps) {
+			ps = ss[i];
+			for (j = 0; j != n && grp[j].id.ptr != ps; j++)
+				;
+
+			/* open a new group */
+			if (j == n) {
+				grp[n].id.ptr = ps;
+				grp[n].cnt = 0;
+				grp[n].rc = 0;
+				n++;
+			}
+		}
+
+		gi[i] = j;
+		grp[j].cnt++;
+	}
+
+	/* group start positions, unknown sessions go beyond the last group */
+	for (i = 0, j = 0; i != n; i++) {
+		grp[i].m = mb + j;
+		j += grp[i].cnt;
+		grp[i].cnt = 0;
+	}
+
+	/* second pass: scatter the packets, keeping their order in a group */
+	for (i = 0; i != num; i++) {
+		if (gi[i] == UINT16_MAX)
+			mb[j++] = m[i];
+		else
+			grp[gi[i]].m[grp[gi[i]].cnt++] = m[i];
+	}
+
+	return n;
+}
+
+uint16_t
+rte_ipsec_pkt_crypto_prepare_bulk(struct rte_ipsec_session *ss[],
+	struct rte_mbuf *mb[], struct rte_crypto_op *cop[],
+	struct rte_ipsec_group grp[], uint16_t num)
+{
+	uint32_t i, k, n;
+
+	n = rte_ipsec_pkt_ses_group(ss, mb, grp, num);
+
+	for (i = 0; i != n; i++) {
+		k = rte_ipsec_pkt_crypto_prepare(grp[i].id.ptr, grp[i].m,
+			cop + (grp[i].m - mb), grp[i].cnt);
+		grp[i].rc = (k == grp[i].cnt) ? 0 : -rte_errno;
+		grp[i].cnt = k;
+	}
+
+	return n;
+}
+
+uint16_t
+rte_ipsec_pkt_process_bulk(struct rte_ipsec_group grp[], uint16_t num)
+{
+	uint32_t i, k, n;
+
+	n = 0;
+	for (i = 0; i != num; i++) {
+		k = rte_ipsec_pkt_process(grp[i].id.ptr, grp[i].m, grp[i].cnt);
+		grp[i].rc = (k == grp[i].cnt) ? 0 : -rte_errno;
+		grp[i].cnt = k;
+		n += k;
+	}
+
+	return n;
+}
@@ -0,0 +1,267 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <string.h>
+#include <errno.h>
+
+#include <rte_common.h>
+#include <rte_cycles.h>
+#include <rte_errno.h>
+#include <rte_malloc.h>
+#include <rte_pause.h>
+#include <rte_string_fns.h>
+
+#include "rte_jobstats_sched.h"
+
+struct sched_job {
+	struct rte_jobstats job;
+	rte_jobstats_sched_job_cb_t cb;
+	void *arg;
+	uint32_t priority;
+	uint64_t deadline;
+	uint64_t time_due;
+	struct rte_jobstats_sched_job_stats stats;
+} __rte_cache_aligned;
+
+struct rte_jobstats_sched {
+	struct rte_jobstats_context ctx;
+	char name[RTE_JOBSTATS_NAMESIZE];
+	uint32_t n_jobs;
+	int stop;
+
+	/* Job IDs sorted by priority. */
+	uint8_t order[RTE_JOBSTATS_SCHED_JOBS_MAX];
+	struct sched_job jobs[RTE_JOBSTATS_SCHED_JOBS_MAX];
+};
+
+static inline uint64_t
+job_deadline_time(const struct sched_job *j)
+{
+	return j->time_due + (j->deadline ? j->deadline : j->job.period);
+}
+
+/* Average execution time, used as the cost estimate of the next run. */
+static inline uint64_t
+job_cost(const struct sched_job *j)
+{
+	if (j->job.exec_cnt == 0)
+		return 0;
+
+	return j->job.exec_time / j->job.exec_cnt;
+}
+
+struct rte_jobstats_sched *
+rte_jobstats_sched_create(const char *name, int socket_id)
+{
+	struct rte_jobstats_sched *sched;
+
+	if (name == NULL) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	sched = rte_zmalloc_socket(name, sizeof(*sched), RTE_CACHE_LINE_SIZE,
+			socket_id);
+	if (sched == NULL) {
+		rte_errno = ENOMEM;
+		return NULL;
+	}
+
+	strlcpy(sched->name, name, sizeof(sched->name));
+	rte_jobstats_context_init(&sched->ctx);
+
+	return sched;
+}
+
+void
+rte_jobstats_sched_free(struct rte_jobstats_sched *sched)
+{
+	rte_free(sched);
+}
+
+int
+rte_jobstats_sched_job_add(struct rte_jobstats_sched *sched,
+		const struct rte_jobstats_sched_job_params *params)
+{
+	struct sched_job *j;
+	uint32_t job_id, pos;
+
+	if (sched == NULL || params == NULL || params->job_cb == NULL ||
+			params->min_period > params->max_period)
+		return -EINVAL;
+
+	if (sched->n_jobs == RTE_JOBSTATS_SCHED_JOBS_MAX)
+		return -ENOSPC;
+
+	job_id = sched->n_jobs;
+	j = &sched->jobs[job_id];
+	rte_jobstats_init(&j->job, params->name, params->min_period,
+			params->max_period, params->initial_period,
+			params->target);
+	rte_jobstats_set_period(&j->job, params->initial_period, 1);
+	j->cb = params->job_cb;
+	j->arg = params->job_arg;
+	j->priority = params->priority;
+	j->deadline = params->deadline;
+	j->time_due = rte_get_timer_cycles();
+	memset(&j->stats, 0, sizeof(j->stats));
+
+	/* Keep the jobs of the same priority in the order they were added. */
+	for (pos = job_id; pos > 0; pos--) {
+		if (sched->jobs[sched->order[pos - 1]].priority <= j->priority)
+			break;
+		sched->order[pos] = sched->order[pos - 1];
+	}
+	sched->order[pos] = job_id;
+
+	sched->n_jobs++;
+
+	return job_id;
+}
+
+struct rte_jobstats *
+rte_jobstats_sched_job_get(struct rte_jobstats_sched *sched, uint32_t job_id)
+{
+	if (sched == NULL || job_id >= sched->n_jobs)
+		return NULL;
+
+	return &sched->jobs[job_id].job;
+}
+
+int
+rte_jobstats_sched_job_stats_read(struct rte_jobstats_sched *sched,
+		uint32_t job_id, struct rte_jobstats_sched_job_stats *stats)
+{
+	if (sched == NULL || job_id >= sched->n_jobs || stats == NULL)
+		return -EINVAL;
+
+	memcpy(stats, &sched->jobs[job_id].stats, sizeof(*stats));
+
+	return 0;
+}
+
+struct rte_jobstats_context *
+rte_jobstats_sched_context_get(struct rte_jobstats_sched *sched)
+{
+	return &sched->ctx;
+}
+
+/*
+ * Whether running a job costing *cost* cycles from *now* makes a job of a
+ * priority higher than *priority* miss its deadline.
+ */
+static int
+sched_hp_deadline_at_risk(struct rte_jobstats_sched *sched, uint32_t priority,
+		uint64_t now, uint64_t cost)
+{
+	uint32_t i;
+
+	for (i = 0; i < sched->n_jobs; i++) {
+		struct sched_job *j = &sched->jobs[sched->order[i]];
+
+		if (j->priority >= priority)
+			break;
+
+		if (job_deadline_time(j) < now + cost)
+			return 1;
+	}
+
+	return 0;
+}
+
+/* Next job to run in this loop turn, NULL when none. */
+static struct sched_job *
+sched_job_next(struct rte_jobstats_sched *sched, uint64_t now,
+		uint64_t *done_mask)
+{
+	for ( ; ; ) {
+		struct sched_job *next = NULL;
+		uint32_t next_id = 0, i;
+
+		for (i = 0; i < sched->n_jobs; i++) {
+			uint32_t job_id = sched->order[i];
+			struct sched_job *j = &sched->jobs[job_id];
+
+			if (next != NULL && j->priority != next->priority)
+				break;
+
+			if ((*done_mask & (1LLU << job_id)) || j->time_due > now)
+				continue;
+
+			if (next == NULL ||
+					job_deadline_time(j) < job_deadline_time(next)) {
+				next = j;
+				next_id = job_id;
+			}
+		}
+
+		if (next == NULL)
+			return NULL;
+
+		*done_mask |= 1LLU << next_id;
+
+		if (job_deadline_time(next) >= now &&
+				sched_hp_deadline_at_risk(sched, next->priority,
+					now, job_cost(next))) {
+			next->stats.n_deferrals++;
+			continue;
+		}
+
+		return next;
+	}
+}
+
+uint32_t
+rte_jobstats_sched_run_once(struct rte_jobstats_sched *sched)
+{
+	uint64_t done_mask = 0;
+	uint64_t now = rte_get_timer_cycles();
+	uint32_t n_jobs = 0;
+
+	rte_jobstats_context_start(&sched->ctx);
+
+	for ( ; ; ) {
+		struct sched_job *j;
+		int64_t value;
+
+		j = sched_job_next(sched, now, &done_mask);
+		if (j == NULL)
+			break;
+
+		if (now > job_deadline_time(j))
+			j->stats.n_deadline_misses++;
+
+		rte_jobstats_start(&sched->ctx, &j->job);
+		value = j->cb(j->arg);
+		rte_jobstats_finish(&j->job, value);
+
+		j->time_due = now + j->job.period;
+		now = rte_get_timer_cycles();
+		n_jobs++;
+	}
+
+	rte_jobstats_context_finish(&sched->ctx);
+
+	return n_jobs;
+}
+
+int
+rte_jobstats_sched_run(void *arg)
+{
+	struct rte_jobstats_sched *sched = arg;
+
+	while (!__atomic_load_n(&sched->stop, __ATOMIC_RELAXED))
+		if (rte_jobstats_sched_run_once(sched) == 0)
+			rte_pause();
+
+	__atomic_store_n(&sched->stop, 0, __ATOMIC_RELAXED);
+
+	return 0;
+}
+
+void
+rte_jobstats_sched_stop(struct rte_jobstats_sched *sched)
+{
+	__atomic_store_n(&sched->stop, 1, __ATOMIC_RELAXED);
+}
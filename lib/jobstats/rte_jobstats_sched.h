@@ -0,0 +1,247 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#ifndef JOBSTATS_SCHED_H_
+#define JOBSTATS_SCHED_H_
+
+/**
+ * @file
+ * Job scheduler
+ *
+ * Cooperative scheduler of the jobs of a single lcore (Rx, Tx flush, timers,
+ * housekeeping, ...) built on top of the job statistics. Each job is run when
+ * its period expires, the period being adjusted from the value returned by
+ * the job, as done by rte_jobstats_finish().
+ *
+ * Among the jobs which are due, the job with the highest priority is run
+ * first, and the job with the earliest deadline among the jobs of the same
+ * priority. A due job is deferred when its average execution time would make
+ * a job of higher priority miss its deadline, unless the job already missed
+ * its own deadline.
+ *
+ * The scheduler is not thread safe, except for rte_jobstats_sched_stop().
+ */
+
+#include <stdint.h>
+
+#include <rte_compat.h>
+
+#include "rte_jobstats.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Maximum number of jobs per scheduler. */
+#define RTE_JOBSTATS_SCHED_JOBS_MAX 64
+
+/** Job scheduler. */
+struct rte_jobstats_sched;
+
+/**
+ * Job callback.
+ *
+ * @param arg
+ *  Opaque argument of the job.
+ * @return
+ *  Job value given to rte_jobstats_finish() to adjust the job period, for
+ *  example the number of packets received by a Rx job.
+ */
+typedef int64_t (*rte_jobstats_sched_job_cb_t)(void *arg);
+
+/** Job parameters. All the times are in timer cycles. */
+struct rte_jobstats_sched_job_params {
+	const char *name;
+	/**< Optional job name. */
+
+	rte_jobstats_sched_job_cb_t job_cb;
+	/**< Job callback. */
+
+	void *job_arg;
+	/**< Opaque argument of the job callback. */
+
+	uint32_t priority;
+	/**< Job priority, 0 being the highest. */
+
+	uint64_t min_period;
+	/**< Minimum period. */
+
+	uint64_t max_period;
+	/**< Maximum period. */
+
+	uint64_t initial_period;
+	/**< Initial period. */
+
+	uint64_t deadline;
+	/**< Maximum delay between the job being due and the job start.
+	 * Zero for the current period of the job.
+	 */
+
+	int64_t target;
+	/**< Job value targeted by the period adjustment. */
+};
+
+/** Job scheduling statistics. */
+struct rte_jobstats_sched_job_stats {
+	uint64_t n_deadline_misses;
+	/**< Number of job runs started after the job deadline. */
+
+	uint64_t n_deferrals;
+	/**< Number of times the job was deferred for a higher priority job. */
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Create a job scheduler.
+ *
+ * @param name
+ *  Scheduler name.
+ * @param socket_id
+ *  Socket to allocate the scheduler memory on.
+ * @return
+ *  Scheduler on success, NULL otherwise with rte_errno set.
+ */
+__rte_experimental
+struct rte_jobstats_sched *
+rte_jobstats_sched_create(const char *name, int socket_id);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Free a job scheduler. The scheduler must not be running.
+ *
+ * @param sched
+ *  Scheduler, can be NULL.
+ */
+__rte_experimental
+void
+rte_jobstats_sched_free(struct rte_jobstats_sched *sched);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Add a job to a scheduler. The job is due as soon as it is added.
+ *
+ * @param sched
+ *  Scheduler.
+ * @param params
+ *  Job parameters.
+ * @return
+ *  Job ID on success,
+ *  -EINVAL if the parameters are invalid,
+ *  -ENOSPC if the scheduler already has RTE_JOBSTATS_SCHED_JOBS_MAX jobs.
+ */
+__rte_experimental
+int
+rte_jobstats_sched_job_add(struct rte_jobstats_sched *sched,
+		const struct rte_jobstats_sched_job_params *params);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Get the job statistics object of a job, to read its statistics or to tune
+ * it with the rte_jobstats_set_*() functions.
+ *
+ * @param sched
+ *  Scheduler.
+ * @param job_id
+ *  Job ID.
+ * @return
+ *  Job statistics object, NULL if the job does not exist.
+ */
+__rte_experimental
+struct rte_jobstats *
+rte_jobstats_sched_job_get(struct rte_jobstats_sched *sched, uint32_t job_id);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Read the scheduling statistics of a job.
+ *
+ * @param sched
+ *  Scheduler.
+ * @param job_id
+ *  Job ID.
+ * @param stats
+ *  Statistics to fill.
+ * @return
+ *  0 on success, -EINVAL otherwise.
+ */
+__rte_experimental
+int
+rte_jobstats_sched_job_stats_read(struct rte_jobstats_sched *sched,
+		uint32_t job_id, struct rte_jobstats_sched_job_stats *stats);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Get the job statistics context of a scheduler, holding the statistics of
+ * its loop.
+ *
+ * @param sched
+ *  Scheduler.
+ * @return
+ *  Job statistics context.
+ */
+__rte_experimental
+struct rte_jobstats_context *
+rte_jobstats_sched_context_get(struct rte_jobstats_sched *sched);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Run one turn of the scheduler loop: run once each job which is due, unless
+ * it is deferred.
+ *
+ * @param sched
+ *  Scheduler.
+ * @return
+ *  Number of jobs run.
+ */
+__rte_experimental
+uint32_t
+rte_jobstats_sched_run_once(struct rte_jobstats_sched *sched);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Run the scheduler loop until rte_jobstats_sched_stop() is called. Can be
+ * given to rte_eal_remote_launch().
+ *
+ * @param sched
+ *  Scheduler.
+ * @return
+ *  0.
+ */
+__rte_experimental
+int
+rte_jobstats_sched_run(void *sched);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Request a running scheduler loop to return. Can be called from any thread.
+ *
+ * @param sched
+ *  Scheduler.
+ */
+__rte_experimental
+void
+rte_jobstats_sched_stop(struct rte_jobstats_sched *sched);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* JOBSTATS_SCHED_H_ */
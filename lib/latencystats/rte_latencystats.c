@@ -16,12 +16,17 @@
 #include <rte_metrics.h>
 #include <rte_memzone.h>
 #include <rte_lcore.h>
+#include <rte_bitops.h>
+#include <rte_common.h>
 
 #include "rte_latencystats.h"
 
 /** Nano seconds per second */
 #define NS_PER_SEC 1E9
 
+/** Duration of the device clock frequency measurement */
+#define LATENCY_CLOCK_CALIB_MS 10
+
 /** Clock cycles per nano second */
 static uint64_t
 latencystat_cycles_per_ns(void)
@@ -35,6 +40,23 @@ latencystat_cycles_per_ns(void)
 static uint64_t timestamp_dynflag;
 static int timestamp_dynfield_offset = -1;
 
+/* Rx time stamp, in TSC cycles, used for the latency calculation. It is
+ * the mbuf Rx timestamp field, or a private field when the hardware Rx
+ * timestamps are used, not to overwrite them.
+ */
+static uint64_t lat_ts_dynflag;
+static int lat_ts_dynfield_offset = -1;
+
+static const struct rte_mbuf_dynfield lat_ts_dynfield_desc = {
+	.name = "rte_latencystats_dynfield_rx_tsc",
+	.size = sizeof(uint64_t),
+	.align = __alignof__(uint64_t),
+};
+
+static const struct rte_mbuf_dynflag lat_ts_dynflag_desc = {
+	.name = "rte_latencystats_dynflag_rx_tsc",
+};
+
 static inline rte_mbuf_timestamp_t *
 timestamp_dynfield(struct rte_mbuf *mbuf)
 {
@@ -42,24 +64,77 @@ timestamp_dynfield(struct rte_mbuf *mbuf)
 			timestamp_dynfield_offset, rte_mbuf_timestamp_t *);
 }
 
+static inline uint64_t *
+lat_ts_dynfield(struct rte_mbuf *mbuf)
+{
+	return RTE_MBUF_DYNFIELD(mbuf, lat_ts_dynfield_offset, uint64_t *);
+}
+
 static const char *MZ_RTE_LATENCY_STATS = "rte_latencystats";
 static int latency_stats_index;
 static uint64_t samp_intvl;
-static uint64_t timer_tsc;
-static uint64_t prev_tsc;
 
 struct rte_latency_stats {
 	float min_latency; /**< Minimum latency in nano seconds */
 	float avg_latency; /**< Average latency in nano seconds */
 	float max_latency; /**< Maximum latency in nano seconds */
 	float jitter; /** Latency variation */
-	rte_spinlock_t lock; /** Latency calculation lock */
+	float p50_latency; /**< 50th percentile latency in nano seconds */
+	float p99_latency; /**< 99th percentile latency in nano seconds */
+	float p999_latency; /**< 99.9th percentile latency in nano seconds */
+};
+
+/*
+ * The histograms have LATENCY_HIST_SUB_BUCKETS linear buckets per power of
+ * two of the latency in cycles, which bounds the relative error of the
+ * percentiles to 1/LATENCY_HIST_SUB_BUCKETS, as HDR histograms do. The
+ * latencies above 2^LATENCY_HIST_MAX_BITS cycles are counted in the last
+ * bucket.
+ */
+#define LATENCY_HIST_SUB_BITS 4
+#define LATENCY_HIST_SUB_BUCKETS (1 << LATENCY_HIST_SUB_BITS)
+#define LATENCY_HIST_MAX_BITS 37
+#define LATENCY_HIST_NB_BUCKETS (LATENCY_HIST_SUB_BUCKETS + \
+	(LATENCY_HIST_MAX_BITS - LATENCY_HIST_SUB_BITS) * \
+	LATENCY_HIST_SUB_BUCKETS)
+
+/*
+ * Latency stats of a Tx queue, in cycles, only written by the lcore
+ * transmitting on the queue, so without any lock. They are merged on read.
+ */
+struct latency_stats_queue {
+	uint64_t samples; /**< Number of latency samples */
+	float min_latency; /**< Minimum latency */
+	float avg_latency; /**< Average latency */
+	float max_latency; /**< Maximum latency */
+	float jitter; /**< Latency variation */
+	float prev_latency; /**< Latency of the previous sample */
+	uint32_t hist_idx; /**< Index of the histogram of the queue */
+} __rte_cache_aligned;
+
+/* Shared memory of the latency stats, for multi-process support. */
+struct latency_stats_shared {
+	uint32_t flags; /**< RTE_LATENCYSTATS_F_* flags */
+	uint32_t nb_queues; /**< Number of Tx queues */
+	uint64_t hist_off; /**< Offset of the histograms */
+	struct latency_stats_queue queues[]; /**< Tx queue stats */
 };
 
-static struct rte_latency_stats *glob_stats;
+static struct latency_stats_shared *glob_stats;
+
+static inline uint64_t *
+latency_stats_hist(struct latency_stats_queue *q)
+{
+	return RTE_PTR_ADD(glob_stats, glob_stats->hist_off +
+		(size_t)q->hist_idx * LATENCY_HIST_NB_BUCKETS *
+		sizeof(uint64_t));
+}
 
 struct rxtx_cbs {
 	const struct rte_eth_rxtx_callback *cb;
+	uint64_t timer_tsc; /**< Cycles since the last Rx sample */
+	uint64_t prev_tsc; /**< Time of the previous Rx packet */
+	double tsc_per_clock; /**< TSC cycles per device clock, 0 for SW */
 };
 
 static struct rxtx_cbs rx_cbs[RTE_MAX_ETHPORTS][RTE_MAX_QUEUES_PER_PORT];
@@ -75,29 +150,178 @@ static const struct latency_stats_nameoff lat_stats_strings[] = {
 	{"avg_latency_ns", offsetof(struct rte_latency_stats, avg_latency)},
 	{"max_latency_ns", offsetof(struct rte_latency_stats, max_latency)},
 	{"jitter_ns", offsetof(struct rte_latency_stats, jitter)},
+	/* Only with RTE_LATENCYSTATS_F_HIST */
+	{"p50_latency_ns", offsetof(struct rte_latency_stats, p50_latency)},
+	{"p99_latency_ns", offsetof(struct rte_latency_stats, p99_latency)},
+	{"p999_latency_ns", offsetof(struct rte_latency_stats, p999_latency)},
 };
 
 #define NUM_LATENCY_STATS (sizeof(lat_stats_strings) / \
 				sizeof(lat_stats_strings[0]))
+#define NUM_LATENCY_STATS_NO_HIST 4
 
-int32_t
-rte_latencystats_update(void)
+static int
+latencystats_shared_get(void)
+{
+	const struct rte_memzone *mz;
+
+	if (glob_stats != NULL && rte_eal_process_type() == RTE_PROC_PRIMARY)
+		return 0;
+
+	mz = rte_memzone_lookup(MZ_RTE_LATENCY_STATS);
+	if (mz == NULL) {
+		RTE_LOG(ERR, LATENCY_STATS, "Latency stats memzone not found\n");
+		return -ENOMEM;
+	}
+	glob_stats = mz->addr;
+
+	return 0;
+}
+
+static unsigned int
+latencystats_count(void)
+{
+	if (glob_stats == NULL || !(glob_stats->flags & RTE_LATENCYSTATS_F_HIST))
+		return NUM_LATENCY_STATS_NO_HIST;
+
+	return NUM_LATENCY_STATS;
+}
+
+static inline uint32_t
+latency_hist_bucket(uint64_t latency)
+{
+	uint32_t msb, shift;
+
+	if (latency < LATENCY_HIST_SUB_BUCKETS)
+		return latency;
+
+	msb = rte_fls_u64(latency) - 1;
+	if (msb >= LATENCY_HIST_MAX_BITS)
+		return LATENCY_HIST_NB_BUCKETS - 1;
+
+	shift = msb - LATENCY_HIST_SUB_BITS;
+	return LATENCY_HIST_SUB_BUCKETS + shift * LATENCY_HIST_SUB_BUCKETS +
+		((latency >> shift) & (LATENCY_HIST_SUB_BUCKETS - 1));
+}
+
+/* Highest latency counted in a bucket */
+static uint64_t
+latency_hist_bucket_max(uint32_t idx)
+{
+	uint32_t shift, sub;
+
+	if (idx < LATENCY_HIST_SUB_BUCKETS)
+		return idx;
+
+	shift = (idx - LATENCY_HIST_SUB_BUCKETS) / LATENCY_HIST_SUB_BUCKETS;
+	sub = (idx - LATENCY_HIST_SUB_BUCKETS) % LATENCY_HIST_SUB_BUCKETS;
+	return ((uint64_t)(LATENCY_HIST_SUB_BUCKETS + sub + 1) << shift) - 1;
+}
+
+static float
+latency_hist_percentile(const uint64_t *hist, uint64_t total, double pct)
+{
+	uint64_t rank, count = 0;
+	uint32_t i;
+
+	if (total == 0)
+		return 0;
+
+	rank = (uint64_t)ceil(total * pct / 100);
+	for (i = 0; i < LATENCY_HIST_NB_BUCKETS; i++) {
+		count += hist[i];
+		if (count >= rank)
+			break;
+	}
+
+	return latency_hist_bucket_max(RTE_MIN(i,
+		(uint32_t)LATENCY_HIST_NB_BUCKETS - 1));
+}
+
+/* Merge the stats of the Tx queues, in cycles */
+static void
+latencystats_collect(struct rte_latency_stats *stats)
+{
+	uint64_t hist[LATENCY_HIST_NB_BUCKETS];
+	struct latency_stats_queue *q;
+	const uint64_t *q_hist;
+	uint64_t samples, total = 0;
+	double avg = 0, jitter = 0;
+	uint32_t i, j;
+
+	memset(stats, 0, sizeof(*stats));
+	if (glob_stats->flags & RTE_LATENCYSTATS_F_HIST)
+		memset(hist, 0, sizeof(hist));
+
+	for (i = 0; i < glob_stats->nb_queues; i++) {
+		q = &glob_stats->queues[i];
+		samples = q->samples;
+		if (samples == 0)
+			continue;
+
+		if (total == 0 || q->min_latency < stats->min_latency)
+			stats->min_latency = q->min_latency;
+		if (q->max_latency > stats->max_latency)
+			stats->max_latency = q->max_latency;
+		avg += (double)q->avg_latency * samples;
+		jitter += (double)q->jitter * samples;
+		total += samples;
+
+		if (glob_stats->flags & RTE_LATENCYSTATS_F_HIST) {
+			q_hist = latency_stats_hist(q);
+			for (j = 0; j < LATENCY_HIST_NB_BUCKETS; j++)
+				hist[j] += q_hist[j];
+		}
+	}
+
+	if (total == 0)
+		return;
+
+	stats->avg_latency = avg / total;
+	stats->jitter = jitter / total;
+
+	if (glob_stats->flags & RTE_LATENCYSTATS_F_HIST) {
+		/* The histograms may be updated while summed up */
+		total = 0;
+		for (j = 0; j < LATENCY_HIST_NB_BUCKETS; j++)
+			total += hist[j];
+		stats->p50_latency = latency_hist_percentile(hist, total, 50);
+		stats->p99_latency = latency_hist_percentile(hist, total, 99);
+		stats->p999_latency = latency_hist_percentile(hist, total, 99.9);
+	}
+}
+
+static void
+latencystats_values_get(uint64_t *values)
 {
+	struct rte_latency_stats stats;
 	unsigned int i;
 	float *stats_ptr = NULL;
-	uint64_t values[NUM_LATENCY_STATS] = {0};
-	int ret;
 
-	for (i = 0; i < NUM_LATENCY_STATS; i++) {
-		stats_ptr = RTE_PTR_ADD(glob_stats,
+	latencystats_collect(&stats);
+
+	for (i = 0; i < latencystats_count(); i++) {
+		stats_ptr = RTE_PTR_ADD(&stats,
 				lat_stats_strings[i].offset);
 		values[i] = (uint64_t)floor((*stats_ptr)/
 				latencystat_cycles_per_ns());
 	}
+}
+
+int32_t
+rte_latencystats_update(void)
+{
+	uint64_t values[NUM_LATENCY_STATS] = {0};
+	int ret;
+
+	if (glob_stats == NULL)
+		return -ENOMEM;
+
+	latencystats_values_get(values);
 
 	ret = rte_metrics_update_values(RTE_METRICS_GLOBAL,
 					latency_stats_index,
-					values, NUM_LATENCY_STATS);
+					values, latencystats_count());
 	if (ret < 0)
 		RTE_LOG(INFO, LATENCY_STATS, "Failed to push the stats\n");
 
@@ -107,26 +331,49 @@ rte_latencystats_update(void)
 static void
 rte_latencystats_fill_values(struct rte_metric_value *values)
 {
+	uint64_t stats[NUM_LATENCY_STATS] = {0};
 	unsigned int i;
-	float *stats_ptr = NULL;
 
-	for (i = 0; i < NUM_LATENCY_STATS; i++) {
-		stats_ptr = RTE_PTR_ADD(glob_stats,
-				lat_stats_strings[i].offset);
+	latencystats_values_get(stats);
+
+	for (i = 0; i < latencystats_count(); i++) {
 		values[i].key = i;
-		values[i].value = (uint64_t)floor((*stats_ptr)/
-						latencystat_cycles_per_ns());
+		values[i].value = stats[i];
 	}
 }
 
+/* Mark the Rx time stamp of a sampled packet, in TSC cycles */
+static inline bool
+latencystats_rx_stamp(uint16_t pid, const struct rxtx_cbs *cbs,
+		struct rte_mbuf *pkt, uint64_t now)
+{
+	uint64_t clock;
+
+	if (cbs->tsc_per_clock == 0) {
+		*lat_ts_dynfield(pkt) = now;
+	} else {
+		/* Hardware Rx timestamp, in device clocks, to TSC */
+		if ((pkt->ol_flags & timestamp_dynflag) == 0 ||
+				rte_eth_read_clock(pid, &clock) != 0)
+			return false;
+		*lat_ts_dynfield(pkt) = rte_rdtsc() -
+			(uint64_t)((clock - *timestamp_dynfield(pkt)) *
+				   cbs->tsc_per_clock);
+	}
+	pkt->ol_flags |= lat_ts_dynflag;
+
+	return true;
+}
+
 static uint16_t
-add_time_stamps(uint16_t pid __rte_unused,
+add_time_stamps(uint16_t pid,
 		uint16_t qid __rte_unused,
 		struct rte_mbuf **pkts,
 		uint16_t nb_pkts,
 		uint16_t max_pkts __rte_unused,
-		void *user_cb __rte_unused)
+		void *user_cb)
 {
+	struct rxtx_cbs *cbs = user_cb;
 	unsigned int i;
 	uint64_t diff_tsc, now;
 
@@ -136,16 +383,14 @@ add_time_stamps(uint16_t pid __rte_unused,
 	 */
 	now = rte_rdtsc();
 	for (i = 0; i < nb_pkts; i++) {
-		diff_tsc = now - prev_tsc;
-		timer_tsc += diff_tsc;
-
-		if ((pkts[i]->ol_flags & timestamp_dynflag) == 0
-				&& (timer_tsc >= samp_intvl)) {
-			*timestamp_dynfield(pkts[i]) = now;
-			pkts[i]->ol_flags |= timestamp_dynflag;
-			timer_tsc = 0;
-		}
-		prev_tsc = now;
+		diff_tsc = now - cbs->prev_tsc;
+		cbs->timer_tsc += diff_tsc;
+
+		if ((pkts[i]->ol_flags & lat_ts_dynflag) == 0
+				&& (cbs->timer_tsc >= samp_intvl)
+				&& latencystats_rx_stamp(pid, cbs, pkts[i], now))
+			cbs->timer_tsc = 0;
+		cbs->prev_tsc = now;
 		now = rte_rdtsc();
 	}
 
@@ -157,12 +402,13 @@ calc_latency(uint16_t pid __rte_unused,
 		uint16_t qid __rte_unused,
 		struct rte_mbuf **pkts,
 		uint16_t nb_pkts,
-		void *_ __rte_unused)
+		void *user_cb)
 {
+	struct latency_stats_queue *q = user_cb;
+	uint64_t *hist = NULL;
 	unsigned int i, cnt = 0;
 	uint64_t now;
 	float latency[nb_pkts];
-	static float prev_latency;
 	/*
 	 * Alpha represents degree of weighting decrease in EWMA,
 	 * a constant smoothing factor between 0 and 1. The value
@@ -172,11 +418,16 @@ calc_latency(uint16_t pid __rte_unused,
 
 	now = rte_rdtsc();
 	for (i = 0; i < nb_pkts; i++) {
-		if (pkts[i]->ol_flags & timestamp_dynflag)
-			latency[cnt++] = now - *timestamp_dynfield(pkts[i]);
+		if (pkts[i]->ol_flags & lat_ts_dynflag)
+			latency[cnt++] = now - *lat_ts_dynfield(pkts[i]);
 	}
 
-	rte_spinlock_lock(&glob_stats->lock);
+	if (cnt == 0)
+		return nb_pkts;
+
+	if (glob_stats->flags & RTE_LATENCYSTATS_F_HIST)
+		hist = latency_stats_hist(q);
+
 	for (i = 0; i < cnt; i++) {
 		/*
 		 * The jitter is calculated as statistical mean of interpacket
@@ -189,46 +440,105 @@ calc_latency(uint16_t pid __rte_unused,
 		 * Reference: Calculated as per RFC 5481, sec 4.1,
 		 * RFC 3393 sec 4.5, RFC 1889 sec.
 		 */
-		glob_stats->jitter +=  (fabsf(prev_latency - latency[i])
-					- glob_stats->jitter)/16;
-		if (glob_stats->min_latency == 0)
-			glob_stats->min_latency = latency[i];
-		else if (latency[i] < glob_stats->min_latency)
-			glob_stats->min_latency = latency[i];
-		else if (latency[i] > glob_stats->max_latency)
-			glob_stats->max_latency = latency[i];
-		/*
-		 * The average latency is measured using exponential moving
-		 * average, i.e. using EWMA
-		 * https://en.wikipedia.org/wiki/Moving_average
-		 */
-		glob_stats->avg_latency +=
-			alpha * (latency[i] - glob_stats->avg_latency);
-		prev_latency = latency[i];
+		if (q->samples == 0) {
+			q->min_latency = latency[i];
+			q->max_latency = latency[i];
+			q->avg_latency = latency[i];
+		} else {
+			q->jitter += (fabsf(q->prev_latency - latency[i])
+				      - q->jitter)/16;
+			if (latency[i] < q->min_latency)
+				q->min_latency = latency[i];
+			else if (latency[i] > q->max_latency)
+				q->max_latency = latency[i];
+			/*
+			 * The average latency is measured using exponential
+			 * moving average, i.e. using EWMA
+			 * https://en.wikipedia.org/wiki/Moving_average
+			 */
+			q->avg_latency +=
+				alpha * (latency[i] - q->avg_latency);
+		}
+		q->prev_latency = latency[i];
+		q->samples++;
+
+		if (hist != NULL)
+			hist[latency_hist_bucket(latency[i])]++;
 	}
-	rte_spinlock_unlock(&glob_stats->lock);
 
 	return nb_pkts;
 }
 
+/* TSC cycles per device clock of the hardware Rx timestamps of a port */
+static double
+latencystats_tsc_per_clock(uint16_t pid)
+{
+	uint64_t start, end, tsc_start, tsc_end;
+
+	if (rte_eth_read_clock(pid, &start) != 0)
+		return 0;
+	tsc_start = rte_rdtsc();
+	rte_delay_ms(LATENCY_CLOCK_CALIB_MS);
+	if (rte_eth_read_clock(pid, &end) != 0 || end <= start)
+		return 0;
+	tsc_end = rte_rdtsc();
+
+	return (double)(tsc_end - tsc_start) / (end - start);
+}
+
 int
 rte_latencystats_init(uint64_t app_samp_intvl,
 		rte_latency_stats_flow_type_fn user_cb)
+{
+	struct rte_latencystats_conf conf = {
+		.samp_intvl = app_samp_intvl,
+		.flags = 0,
+	};
+
+	RTE_SET_USED(user_cb);
+
+	return rte_latencystats_init_conf(&conf);
+}
+
+int
+rte_latencystats_init_conf(const struct rte_latencystats_conf *conf)
 {
 	unsigned int i;
 	uint16_t pid;
 	uint16_t qid;
+	uint32_t nb_queues = 0;
+	size_t size, hist_off;
 	struct rxtx_cbs *cbs = NULL;
+	struct latency_stats_queue *q;
 	const char *ptr_strings[NUM_LATENCY_STATS] = {0};
 	const struct rte_memzone *mz = NULL;
 	const unsigned int flags = 0;
 	int ret;
 
+	if (conf == NULL ||
+			(conf->flags & ~(RTE_LATENCYSTATS_F_HIST |
+					 RTE_LATENCYSTATS_F_HW_TIMESTAMP)) != 0)
+		return -EINVAL;
+
 	if (rte_memzone_lookup(MZ_RTE_LATENCY_STATS))
 		return -EEXIST;
 
+	/* One stats structure per Tx queue */
+	RTE_ETH_FOREACH_DEV(pid) {
+		struct rte_eth_dev_info dev_info;
+
+		if (rte_eth_dev_info_get(pid, &dev_info) == 0)
+			nb_queues += dev_info.nb_tx_queues;
+	}
+
+	size = sizeof(*glob_stats) + nb_queues * sizeof(glob_stats->queues[0]);
+	hist_off = size;
+	if (conf->flags & RTE_LATENCYSTATS_F_HIST)
+		size += (size_t)nb_queues * LATENCY_HIST_NB_BUCKETS *
+			sizeof(uint64_t);
+
 	/** Allocate stats in shared memory fo multi process support */
-	mz = rte_memzone_reserve(MZ_RTE_LATENCY_STATS, sizeof(*glob_stats),
+	mz = rte_memzone_reserve(MZ_RTE_LATENCY_STATS, size,
 					rte_socket_id(), flags);
 	if (mz == NULL) {
 		RTE_LOG(ERR, LATENCY_STATS, "Cannot reserve memory: %s:%d\n",
@@ -237,15 +547,17 @@ rte_latencystats_init(uint64_t app_samp_intvl,
 	}
 
 	glob_stats = mz->addr;
-	rte_spinlock_init(&glob_stats->lock);
-	samp_intvl = app_samp_intvl * latencystat_cycles_per_ns();
+	memset(glob_stats, 0, size);
+	glob_stats->flags = conf->flags;
+	glob_stats->hist_off = hist_off;
+	samp_intvl = conf->samp_intvl * latencystat_cycles_per_ns();
 
 	/** Register latency stats with stats library */
-	for (i = 0; i < NUM_LATENCY_STATS; i++)
+	for (i = 0; i < latencystats_count(); i++)
 		ptr_strings[i] = lat_stats_strings[i].name;
 
 	latency_stats_index = rte_metrics_reg_names(ptr_strings,
-							NUM_LATENCY_STATS);
+							latencystats_count());
 	if (latency_stats_index < 0) {
 		RTE_LOG(DEBUG, LATENCY_STATS,
 			"Failed to register latency stats names\n");
@@ -261,9 +573,26 @@ rte_latencystats_init(uint64_t app_samp_intvl,
 		return -rte_errno;
 	}
 
+	if (conf->flags & RTE_LATENCYSTATS_F_HW_TIMESTAMP) {
+		/* Keep the hardware timestamps, use a private field */
+		lat_ts_dynfield_offset =
+			rte_mbuf_dynfield_register(&lat_ts_dynfield_desc);
+		ret = rte_mbuf_dynflag_register(&lat_ts_dynflag_desc);
+		if (lat_ts_dynfield_offset < 0 || ret < 0) {
+			RTE_LOG(ERR, LATENCY_STATS,
+				"Cannot register mbuf field/flag for latency\n");
+			return -rte_errno;
+		}
+		lat_ts_dynflag = RTE_BIT64(ret);
+	} else {
+		lat_ts_dynfield_offset = timestamp_dynfield_offset;
+		lat_ts_dynflag = timestamp_dynflag;
+	}
+
 	/** Register Rx/Tx callbacks */
 	RTE_ETH_FOREACH_DEV(pid) {
 		struct rte_eth_dev_info dev_info;
+		double tsc_per_clock = 0;
 
 		ret = rte_eth_dev_info_get(pid, &dev_info);
 		if (ret != 0) {
@@ -274,19 +603,33 @@ rte_latencystats_init(uint64_t app_samp_intvl,
 			continue;
 		}
 
+		if (conf->flags & RTE_LATENCYSTATS_F_HW_TIMESTAMP) {
+			tsc_per_clock = latencystats_tsc_per_clock(pid);
+			if (tsc_per_clock == 0)
+				RTE_LOG(INFO, LATENCY_STATS, "No device clock "
+					"for pid=%d, using software Rx "
+					"timestamps\n", pid);
+		}
+
 		for (qid = 0; qid < dev_info.nb_rx_queues; qid++) {
 			cbs = &rx_cbs[pid][qid];
+			cbs->timer_tsc = 0;
+			cbs->prev_tsc = rte_rdtsc();
+			cbs->tsc_per_clock = tsc_per_clock;
 			cbs->cb = rte_eth_add_first_rx_callback(pid, qid,
-					add_time_stamps, user_cb);
+					add_time_stamps, cbs);
 			if (!cbs->cb)
 				RTE_LOG(INFO, LATENCY_STATS, "Failed to "
 					"register Rx callback for pid=%d, "
 					"qid=%d\n", pid, qid);
 		}
-		for (qid = 0; qid < dev_info.nb_tx_queues; qid++) {
+		for (qid = 0; qid < dev_info.nb_tx_queues &&
+				glob_stats->nb_queues < nb_queues; qid++) {
+			q = &glob_stats->queues[glob_stats->nb_queues];
+			q->hist_idx = glob_stats->nb_queues++;
 			cbs = &tx_cbs[pid][qid];
 			cbs->cb =  rte_eth_add_tx_callback(pid, qid,
-					calc_latency, user_cb);
+					calc_latency, q);
 			if (!cbs->cb)
 				RTE_LOG(INFO, LATENCY_STATS, "Failed to "
 					"register Tx callback for pid=%d, "
@@ -340,6 +683,7 @@ rte_latencystats_uninit(void)
 	mz = rte_memzone_lookup(MZ_RTE_LATENCY_STATS);
 	if (mz)
 		rte_memzone_free(mz);
+	glob_stats = NULL;
 
 	return 0;
 }
@@ -349,14 +693,17 @@ rte_latencystats_get_names(struct rte_metric_name *names, uint16_t size)
 {
 	unsigned int i;
 
-	if (names == NULL || size < NUM_LATENCY_STATS)
-		return NUM_LATENCY_STATS;
+	if (rte_eal_process_type() == RTE_PROC_SECONDARY)
+		latencystats_shared_get();
+
+	if (names == NULL || size < latencystats_count())
+		return latencystats_count();
 
-	for (i = 0; i < NUM_LATENCY_STATS; i++)
+	for (i = 0; i < latencystats_count(); i++)
 		strlcpy(names[i].name, lat_stats_strings[i].name,
 			sizeof(names[i].name));
 
-	return NUM_LATENCY_STATS;
+	return latencystats_count();
 }
 
 int
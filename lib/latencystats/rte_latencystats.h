@@ -13,6 +13,8 @@
  */
 
 #include <stdint.h>
+#include <rte_bitops.h>
+#include <rte_compat.h>
 #include <rte_metrics.h>
 #include <rte_mbuf.h>
 
@@ -62,6 +64,52 @@ typedef uint16_t (*rte_latency_stats_flow_type_fn)(struct rte_mbuf *pkt,
 int rte_latencystats_init(uint64_t samp_intvl,
 			rte_latency_stats_flow_type_fn user_cb);
 
+/**
+ * Gather the histograms of the latencies, reported as the ``p50_latency_ns``,
+ * ``p99_latency_ns`` and ``p999_latency_ns`` percentiles.
+ */
+#define RTE_LATENCYSTATS_F_HIST RTE_BIT32(0)
+
+/**
+ * Use the hardware Rx timestamps of the mbuf dynamic timestamp field, which
+ * are converted from the device clock read by rte_eth_read_clock(). The
+ * software Rx timestamps are used on the ports without a device clock.
+ */
+#define RTE_LATENCYSTATS_F_HW_TIMESTAMP RTE_BIT32(1)
+
+/**
+ * Latency stats configuration.
+ */
+struct rte_latencystats_conf {
+	uint64_t samp_intvl;
+	/**< Sampling time period in nano seconds, at which packet should be
+	 * marked with time stamp.
+	 */
+	uint32_t flags; /**< RTE_LATENCYSTATS_F_* flags. */
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Registers Rx/Tx callbacks for each active port, queue, with a
+ * configuration.
+ *
+ * The latency stats are gathered per Tx queue without any lock and merged
+ * on read by rte_latencystats_update() and rte_latencystats_get().
+ *
+ * @param conf
+ *  Latency stats configuration.
+ * @return
+ *   -EINVAL: On invalid configuration
+ *   -EEXIST: If already initialized
+ *   -ENOMEM: On error
+ *   -1     : On error
+ *    0     : On success
+ */
+__rte_experimental
+int rte_latencystats_init_conf(const struct rte_latencystats_conf *conf);
+
 /**
  * Calculates the latency and jitter values internally, exposing the updated
  * values via *rte_latencystats_get* or the rte_metrics API.
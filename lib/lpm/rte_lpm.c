@@ -17,7 +17,9 @@
 #include <rte_malloc.h>
 #include <rte_eal.h>
 #include <rte_eal_memconfig.h>
+#include <rte_lcore.h>
 #include <rte_per_lcore.h>
+#include <rte_persist.h>
 #include <rte_string_fns.h>
 #include <rte_errno.h>
 #include <rte_rwlock.h>
@@ -61,6 +63,9 @@ struct __rte_lpm {
 	char name[RTE_LPM_NAMESIZE];        /**< Name of the lpm. */
 	uint32_t max_rules; /**< Max. balanced rules per lpm. */
 	uint32_t number_tbl8s; /**< Number of tbl8s. */
+	int flags; /**< Configuration flags, RTE_LPM_F_*. */
+	int socket_id; /**< NUMA socket of the tables. */
+	uint32_t compact_next; /**< Next tbl24 entry to compact. */
 	/**< Rule info table. */
 	struct rte_lpm_rule_info rule_info[RTE_LPM_MAX_DEPTH];
 	struct rte_lpm_rule *rules_tbl; /**< LPM rules. */
@@ -69,6 +74,8 @@ struct __rte_lpm {
 	struct rte_rcu_qsbr *v;		/* RCU QSBR variable. */
 	enum rte_lpm_qsbr_mode rcu_mode;/* Blocking, defer queue. */
 	struct rte_rcu_qsbr_dq *dq;	/* RCU QSBR defer queue. */
+
+	bool persistent; /* Allocated in a persistent zone, never freed. */
 };
 
 /* Macro to enable/disable run-time checks. */
@@ -239,6 +246,8 @@ rte_lpm_create(const char *name, int socket_id,
 	/* Save user arguments. */
 	i_lpm->max_rules = config->max_rules;
 	i_lpm->number_tbl8s = config->number_tbl8s;
+	i_lpm->flags = config->flags;
+	i_lpm->socket_id = socket_id;
 	strlcpy(i_lpm->name, name, sizeof(i_lpm->name));
 
 	te->data = i_lpm;
@@ -252,6 +261,107 @@ rte_lpm_create(const char *name, int socket_id,
 	return lpm;
 }
 
+/*
+ * Creates an LPM object in a persistent zone, or attaches the one left by a
+ * previous process
+ */
+struct rte_lpm *
+rte_lpm_create_persist(const char *name, const struct rte_lpm_config *config)
+{
+	char mem_name[RTE_PERSIST_NAMESIZE];
+	const struct rte_persist_zone *zone;
+	struct __rte_lpm *i_lpm;
+	struct rte_lpm *lpm = NULL;
+	struct rte_tailq_entry *te;
+	size_t mem_size, rules_size, tbl8s_size;
+	struct rte_lpm_list *lpm_list;
+
+	lpm_list = RTE_TAILQ_CAST(rte_lpm_tailq.head, rte_lpm_list);
+
+	/* Check user arguments. */
+	if ((name == NULL) || (config == NULL) || (config->max_rules == 0)
+			|| config->number_tbl8s > RTE_LPM_MAX_TBL8_NUM_GROUPS
+			|| (config->flags & RTE_LPM_F_TBL8_GROW)) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	snprintf(mem_name, sizeof(mem_name), "LPM_%s", name);
+
+	/* The rules and tbl8s follow the LPM structure in the zone. */
+	mem_size = RTE_ALIGN_CEIL(sizeof(*i_lpm), RTE_CACHE_LINE_SIZE);
+	rules_size = RTE_ALIGN_CEIL(sizeof(struct rte_lpm_rule) *
+			(size_t)config->max_rules, RTE_CACHE_LINE_SIZE);
+	tbl8s_size = sizeof(struct rte_lpm_tbl_entry) *
+			RTE_LPM_TBL8_GROUP_NUM_ENTRIES * config->number_tbl8s;
+
+	rte_mcfg_tailq_write_lock();
+
+	/* guarantee there's no existing */
+	TAILQ_FOREACH(te, lpm_list, next) {
+		i_lpm = te->data;
+		if (strncmp(name, i_lpm->name, RTE_LPM_NAMESIZE) == 0)
+			break;
+	}
+
+	if (te != NULL) {
+		rte_errno = EEXIST;
+		goto exit;
+	}
+
+	zone = rte_persist_zone_lookup(mem_name);
+	if (zone == NULL && rte_errno == ENOENT)
+		zone = rte_persist_zone_reserve(mem_name,
+				mem_size + rules_size + tbl8s_size, 0);
+	if (zone == NULL) {
+		RTE_LOG(ERR, LPM, "LPM persistent zone %s not available\n",
+			mem_name);
+		goto exit;
+	}
+	if (zone->len != mem_size + rules_size + tbl8s_size) {
+		RTE_LOG(ERR, LPM, "LPM persistent zone %s has another config\n",
+			mem_name);
+		rte_errno = EINVAL;
+		goto exit;
+	}
+
+	/* allocate tailq entry */
+	te = rte_zmalloc("LPM_TAILQ_ENTRY", sizeof(*te), 0);
+	if (te == NULL) {
+		RTE_LOG(ERR, LPM, "Failed to allocate tailq entry\n");
+		rte_errno = ENOMEM;
+		goto exit;
+	}
+
+	i_lpm = zone->addr;
+	if (i_lpm->max_rules == 0) {
+		/* New zone, already zeroed. */
+		i_lpm->rules_tbl = RTE_PTR_ADD(i_lpm, mem_size);
+		i_lpm->lpm.tbl8 = RTE_PTR_ADD(i_lpm, mem_size + rules_size);
+		i_lpm->number_tbl8s = config->number_tbl8s;
+		i_lpm->socket_id = SOCKET_ID_ANY;
+		strlcpy(i_lpm->name, name, sizeof(i_lpm->name));
+		i_lpm->persistent = true;
+		i_lpm->max_rules = config->max_rules;
+	} else {
+		/* The RCU state belonged to the previous process. */
+		i_lpm->v = NULL;
+		i_lpm->dq = NULL;
+		RTE_LOG(INFO, LPM, "LPM %s attached from persistent zone\n",
+			name);
+	}
+
+	te->data = i_lpm;
+	lpm = &i_lpm->lpm;
+
+	TAILQ_INSERT_TAIL(lpm_list, te, next);
+
+exit:
+	rte_mcfg_tailq_write_unlock();
+
+	return lpm;
+}
+
 /*
  * Deallocates memory for given LPM table.
  */
@@ -283,10 +393,16 @@ rte_lpm_free(struct rte_lpm *lpm)
 
 	if (i_lpm->dq != NULL)
 		rte_rcu_qsbr_dq_delete(i_lpm->dq);
+	rte_free(te);
+	/* the tables are kept for the next process to attach them */
+	if (i_lpm->persistent) {
+		i_lpm->dq = NULL;
+		i_lpm->v = NULL;
+		return;
+	}
 	rte_free(i_lpm->lpm.tbl8);
 	rte_free(i_lpm->rules_tbl);
 	rte_free(i_lpm);
-	rte_free(te);
 }
 
 static void
@@ -531,6 +647,48 @@ _tbl8_alloc(struct __rte_lpm *i_lpm)
 	return -ENOSPC;
 }
 
+/*
+ * Doubles the tbl8 groups. The readers may still use the old table, it is
+ * freed once they are all quiescent, so RCU is required.
+ */
+static int32_t
+tbl8_grow(struct __rte_lpm *i_lpm)
+{
+	struct rte_lpm_tbl_entry *tbl8, *old_tbl8;
+	uint32_t number_tbl8s;
+	size_t tbl8s_size;
+
+	if (!(i_lpm->flags & RTE_LPM_F_TBL8_GROW) || i_lpm->v == NULL ||
+			i_lpm->number_tbl8s >= RTE_LPM_MAX_TBL8_NUM_GROUPS)
+		return -ENOSPC;
+
+	number_tbl8s = RTE_MIN(i_lpm->number_tbl8s * 2,
+			(uint32_t)RTE_LPM_MAX_TBL8_NUM_GROUPS);
+	tbl8s_size = sizeof(struct rte_lpm_tbl_entry) *
+			RTE_LPM_TBL8_GROUP_NUM_ENTRIES;
+
+	tbl8 = rte_zmalloc_socket(NULL, tbl8s_size * number_tbl8s,
+			RTE_CACHE_LINE_SIZE, i_lpm->socket_id);
+	if (tbl8 == NULL) {
+		RTE_LOG(ERR, LPM, "LPM tbl8 memory allocation failed\n");
+		return -ENOSPC;
+	}
+
+	/* The groups in use, and the ones waiting in the defer queue, are
+	 * copied, so the readers get the same result from both tables.
+	 */
+	old_tbl8 = i_lpm->lpm.tbl8;
+	memcpy(tbl8, old_tbl8, tbl8s_size * i_lpm->number_tbl8s);
+	__atomic_store_n(&i_lpm->lpm.tbl8, tbl8, __ATOMIC_RELEASE);
+	i_lpm->number_tbl8s = number_tbl8s;
+
+	/* Wait for the readers of the old table before freeing it. */
+	rte_rcu_qsbr_synchronize(i_lpm->v, RTE_QSBR_THRID_INVALID);
+	rte_free(old_tbl8);
+
+	return 0;
+}
+
 static int32_t
 tbl8_alloc(struct __rte_lpm *i_lpm)
 {
@@ -543,6 +701,9 @@ tbl8_alloc(struct __rte_lpm *i_lpm)
 				NULL, NULL, NULL) == 0)
 			group_idx = _tbl8_alloc(i_lpm);
 	}
+	/* Still no tbl8 group, try to get more. */
+	if (group_idx == -ENOSPC && tbl8_grow(i_lpm) == 0)
+		group_idx = _tbl8_alloc(i_lpm);
 
 	return group_idx;
 }
@@ -1057,6 +1218,63 @@ tbl8_recycle_check(struct rte_lpm_tbl_entry *tbl8,
 	return -EINVAL;
 }
 
+/*
+ * Merges the tbl8 group of an extended tbl24 entry back into it and frees the
+ * group, if the group is empty or all its entries are the same.
+ * If the group cannot be freed, e.g. when the RCU defer queue is full, the
+ * tbl24 entry is restored and the group is left to rte_lpm_tbl8_compact().
+ *
+ * Returns 1 if the group is freed, 0 if it is in use, a negative value if it
+ * cannot be freed.
+ */
+static int32_t
+tbl8_recycle(struct __rte_lpm *i_lpm, uint32_t tbl24_index)
+{
+#define group_idx next_hop
+	struct rte_lpm_tbl_entry tbl24_entry = i_lpm->lpm.tbl24[tbl24_index];
+	uint32_t tbl8_group_start;
+	int32_t tbl8_recycle_index, status;
+
+	tbl8_group_start = tbl24_entry.group_idx *
+			RTE_LPM_TBL8_GROUP_NUM_ENTRIES;
+	tbl8_recycle_index = tbl8_recycle_check(i_lpm->lpm.tbl8,
+			tbl8_group_start);
+
+	if (tbl8_recycle_index == -EINVAL) {
+		/* Set tbl24 before freeing tbl8 to avoid race condition.
+		 * Prevent the free of the tbl8 group from hoisting.
+		 */
+		i_lpm->lpm.tbl24[tbl24_index].valid = 0;
+		__atomic_thread_fence(__ATOMIC_RELEASE);
+	} else if (tbl8_recycle_index > -1) {
+		/* Update tbl24 entry. */
+		struct rte_lpm_tbl_entry new_tbl24_entry = {
+			.next_hop = i_lpm->lpm.tbl8[tbl8_recycle_index].next_hop,
+			.valid = VALID,
+			.valid_group = 0,
+			.depth = i_lpm->lpm.tbl8[tbl8_recycle_index].depth,
+		};
+
+		/* Set tbl24 before freeing tbl8 to avoid race condition.
+		 * Prevent the free of the tbl8 group from hoisting.
+		 */
+		__atomic_store(&i_lpm->lpm.tbl24[tbl24_index], &new_tbl24_entry,
+				__ATOMIC_RELAXED);
+		__atomic_thread_fence(__ATOMIC_RELEASE);
+	} else
+		return 0;
+
+	status = tbl8_free(i_lpm, tbl8_group_start);
+	if (status < 0) {
+		/* The group is untouched, give it back to the tbl24 entry. */
+		__atomic_store(&i_lpm->lpm.tbl24[tbl24_index], &tbl24_entry,
+				__ATOMIC_RELEASE);
+		return status;
+	}
+#undef group_idx
+	return 1;
+}
+
 static int32_t
 delete_depth_big(struct __rte_lpm *i_lpm, uint32_t ip_masked,
 	uint8_t depth, int32_t sub_rule_index, uint8_t sub_rule_depth)
@@ -1064,7 +1282,6 @@ delete_depth_big(struct __rte_lpm *i_lpm, uint32_t ip_masked,
 #define group_idx next_hop
 	uint32_t tbl24_index, tbl8_group_index, tbl8_group_start, tbl8_index,
 			tbl8_range, i;
-	int32_t tbl8_recycle_index, status = 0;
 
 	/*
 	 * Calculate the index into tbl24 and range. Note: All depths larger
@@ -1110,37 +1327,12 @@ delete_depth_big(struct __rte_lpm *i_lpm, uint32_t ip_masked,
 	/*
 	 * Check if there are any valid entries in this tbl8 group. If all
 	 * tbl8 entries are invalid we can free the tbl8 and invalidate the
-	 * associated tbl24 entry.
+	 * associated tbl24 entry. A group which cannot be freed yet is kept
+	 * with the same content, so the deletion is done anyway.
 	 */
-
-	tbl8_recycle_index = tbl8_recycle_check(i_lpm->lpm.tbl8, tbl8_group_start);
-
-	if (tbl8_recycle_index == -EINVAL) {
-		/* Set tbl24 before freeing tbl8 to avoid race condition.
-		 * Prevent the free of the tbl8 group from hoisting.
-		 */
-		i_lpm->lpm.tbl24[tbl24_index].valid = 0;
-		__atomic_thread_fence(__ATOMIC_RELEASE);
-		status = tbl8_free(i_lpm, tbl8_group_start);
-	} else if (tbl8_recycle_index > -1) {
-		/* Update tbl24 entry. */
-		struct rte_lpm_tbl_entry new_tbl24_entry = {
-			.next_hop = i_lpm->lpm.tbl8[tbl8_recycle_index].next_hop,
-			.valid = VALID,
-			.valid_group = 0,
-			.depth = i_lpm->lpm.tbl8[tbl8_recycle_index].depth,
-		};
-
-		/* Set tbl24 before freeing tbl8 to avoid race condition.
-		 * Prevent the free of the tbl8 group from hoisting.
-		 */
-		__atomic_store(&i_lpm->lpm.tbl24[tbl24_index], &new_tbl24_entry,
-				__ATOMIC_RELAXED);
-		__atomic_thread_fence(__ATOMIC_RELEASE);
-		status = tbl8_free(i_lpm, tbl8_group_start);
-	}
+	tbl8_recycle(i_lpm, tbl24_index);
 #undef group_idx
-	return status;
+	return 0;
 }
 
 /*
@@ -1223,3 +1415,215 @@ rte_lpm_delete_all(struct rte_lpm *lpm)
 	/* Delete all rules form the rules table. */
 	memset(i_lpm->rules_tbl, 0, sizeof(i_lpm->rules_tbl[0]) * i_lpm->max_rules);
 }
+
+/*
+ * Merge the uniform tbl8 groups of the next n tbl24 entries.
+ */
+int
+rte_lpm_tbl8_compact(struct rte_lpm *lpm, uint32_t n)
+{
+	struct __rte_lpm *i_lpm;
+	uint32_t i, tbl24_index;
+	int nb_freed = 0;
+	int32_t status;
+
+	if (lpm == NULL)
+		return -EINVAL;
+
+	i_lpm = container_of(lpm, struct __rte_lpm, lpm);
+	if (n == 0 || n > RTE_LPM_TBL24_NUM_ENTRIES)
+		n = RTE_LPM_TBL24_NUM_ENTRIES;
+
+	/* Make room in the defer queue for the groups freed below. */
+	if (i_lpm->dq != NULL)
+		rte_rcu_qsbr_dq_reclaim(i_lpm->dq, i_lpm->number_tbl8s,
+				NULL, NULL, NULL);
+
+	tbl24_index = i_lpm->compact_next;
+	for (i = 0; i < n; i++) {
+		if (lpm->tbl24[tbl24_index].valid &&
+				lpm->tbl24[tbl24_index].valid_group) {
+			status = tbl8_recycle(i_lpm, tbl24_index);
+			if (status < 0)
+				break;
+			nb_freed += status;
+		}
+		tbl24_index = (tbl24_index + 1) &
+				(RTE_LPM_TBL24_NUM_ENTRIES - 1);
+	}
+	i_lpm->compact_next = tbl24_index;
+
+	return nb_freed;
+}
+
+struct rte_lpm_numa *
+rte_lpm_numa_create(const char *name, const struct rte_lpm_config *config)
+{
+	char replica_name[RTE_LPM_NAMESIZE];
+	struct rte_lpm_numa *ln;
+	struct rte_lpm *lpm;
+	unsigned int lcore_id, socket_id;
+	uint32_t i;
+
+	if ((name == NULL) || (config == NULL)) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	ln = rte_zmalloc("LPM_NUMA", sizeof(*ln), RTE_CACHE_LINE_SIZE);
+	if (ln == NULL) {
+		rte_errno = ENOMEM;
+		return NULL;
+	}
+
+	RTE_LCORE_FOREACH(lcore_id) {
+		socket_id = rte_lcore_to_socket_id(lcore_id);
+		if (socket_id >= RTE_MAX_NUMA_NODES ||
+				ln->local[socket_id] != NULL)
+			continue;
+
+		if (snprintf(replica_name, sizeof(replica_name), "%s_%u",
+				name, socket_id) >= (int)sizeof(replica_name)) {
+			rte_errno = ENAMETOOLONG;
+			goto error;
+		}
+		lpm = rte_lpm_create(replica_name, socket_id, config);
+		if (lpm == NULL)
+			goto error;
+
+		ln->local[socket_id] = lpm;
+		ln->replicas[ln->n_replicas++] = lpm;
+	}
+
+	if (ln->n_replicas == 0) {
+		rte_errno = ENODEV;
+		goto error;
+	}
+
+	socket_id = rte_lcore_to_socket_id(rte_get_main_lcore());
+	ln->def = (socket_id < RTE_MAX_NUMA_NODES) ?
+		ln->local[socket_id] : NULL;
+	if (ln->def == NULL)
+		ln->def = ln->replicas[0];
+
+	/* The sockets with no lcore share the default replica. */
+	for (socket_id = 0; socket_id != RTE_MAX_NUMA_NODES; socket_id++)
+		if (ln->local[socket_id] == NULL)
+			ln->local[socket_id] = ln->def;
+
+	return ln;
+
+error:
+	for (i = 0; i != ln->n_replicas; i++)
+		rte_lpm_free(ln->replicas[i]);
+	rte_free(ln);
+	return NULL;
+}
+
+void
+rte_lpm_numa_free(struct rte_lpm_numa *ln)
+{
+	uint32_t i;
+
+	if (ln == NULL)
+		return;
+
+	for (i = 0; i != ln->n_replicas; i++)
+		rte_lpm_free(ln->replicas[i]);
+	rte_free(ln);
+}
+
+int
+rte_lpm_numa_rcu_qsbr_add(struct rte_lpm_numa *ln,
+		struct rte_lpm_rcu_config *cfg)
+{
+	uint32_t i;
+
+	if (ln == NULL) {
+		rte_errno = EINVAL;
+		return 1;
+	}
+
+	for (i = 0; i != ln->n_replicas; i++)
+		if (rte_lpm_rcu_qsbr_add(ln->replicas[i], cfg) != 0)
+			return 1;
+
+	return 0;
+}
+
+/*
+ * Apply a rule update to all the replicas. On failure, the rule state
+ * before the update, read from the first replica, is restored in the
+ * replicas already updated.
+ */
+static int
+lpm_numa_modify(struct rte_lpm_numa *ln, uint32_t ip, uint8_t depth,
+		uint32_t next_hop, int add)
+{
+	uint32_t prev_nh = 0;
+	uint32_t i, j;
+	int present, ret;
+
+	if (ln == NULL)
+		return -EINVAL;
+
+	present = rte_lpm_is_rule_present(ln->replicas[0], ip, depth,
+			&prev_nh);
+	if (present < 0)
+		return present;
+
+	for (i = 0; i != ln->n_replicas; i++) {
+		ret = add ? rte_lpm_add(ln->replicas[i], ip, depth, next_hop) :
+			rte_lpm_delete(ln->replicas[i], ip, depth);
+		if (ret == 0)
+			continue;
+
+		for (j = 0; j != i; j++) {
+			if (present)
+				rte_lpm_add(ln->replicas[j], ip, depth,
+						prev_nh);
+			else
+				rte_lpm_delete(ln->replicas[j], ip, depth);
+		}
+		return ret;
+	}
+
+	return 0;
+}
+
+int
+rte_lpm_numa_add(struct rte_lpm_numa *ln, uint32_t ip, uint8_t depth,
+		uint32_t next_hop)
+{
+	return lpm_numa_modify(ln, ip, depth, next_hop, 1);
+}
+
+int
+rte_lpm_numa_delete(struct rte_lpm_numa *ln, uint32_t ip, uint8_t depth)
+{
+	return lpm_numa_modify(ln, ip, depth, 0, 0);
+}
+
+void
+rte_lpm_numa_delete_all(struct rte_lpm_numa *ln)
+{
+	uint32_t i;
+
+	if (ln == NULL)
+		return;
+
+	for (i = 0; i != ln->n_replicas; i++)
+		rte_lpm_delete_all(ln->replicas[i]);
+}
+
+struct rte_lpm *
+rte_lpm_numa_get(struct rte_lpm_numa *ln, int socket_id)
+{
+	if (ln == NULL)
+		return NULL;
+	if (socket_id == SOCKET_ID_ANY)
+		return rte_lpm_numa_local(ln);
+	if (socket_id < 0 || socket_id >= RTE_MAX_NUMA_NODES)
+		return NULL;
+	return ln->local[socket_id];
+}
@@ -20,6 +20,7 @@
 #include <rte_config.h>
 #include <rte_memory.h>
 #include <rte_common.h>
+#include <rte_lcore.h>
 #include <rte_vect.h>
 #include <rte_rcu_qsbr.h>
 
@@ -67,6 +68,12 @@ extern "C" {
 /** @internal Default RCU defer queue entries to reclaim in one go. */
 #define RTE_LPM_RCU_DQ_RECLAIM_MAX	16
 
+/**
+ * Configuration flag doubling the tbl8 groups when they are all used,
+ * up to RTE_LPM_MAX_TBL8_NUM_GROUPS. It requires RCU, see rte_lpm_create().
+ */
+#define RTE_LPM_F_TBL8_GROW		0x1
+
 /** RCU reclamation modes */
 enum rte_lpm_qsbr_mode {
 	/** Create defer queue for reclaim. */
@@ -115,7 +122,7 @@ struct rte_lpm_tbl_entry {
 struct rte_lpm_config {
 	uint32_t max_rules;      /**< Max number of rules. */
 	uint32_t number_tbl8s;   /**< Number of tbl8s to allocate. */
-	int flags;               /**< This field is currently unused. */
+	int flags;               /**< Configuration flags, RTE_LPM_F_*. */
 };
 
 /** @internal LPM structure. */
@@ -126,6 +133,18 @@ struct rte_lpm {
 	struct rte_lpm_tbl_entry *tbl8; /**< LPM tbl8 table. */
 };
 
+/**
+ * @internal LPM replicated on each NUMA socket, see rte_lpm_numa_create().
+ */
+struct rte_lpm_numa {
+	/** Replica looked up by the lcores of each socket. */
+	struct rte_lpm *local[RTE_MAX_NUMA_NODES];
+	/** Replica looked up by the threads with no socket. */
+	struct rte_lpm *def;
+	uint32_t n_replicas;	/**< Number of replicas. */
+	struct rte_lpm *replicas[RTE_MAX_NUMA_NODES]; /**< Replicas. */
+};
+
 /** LPM RCU QSBR configuration structure. */
 struct rte_lpm_rcu_config {
 	struct rte_rcu_qsbr *v;	/* RCU QSBR variable. */
@@ -149,6 +168,13 @@ struct rte_lpm_rcu_config {
  *   LPM object name
  * @param socket_id
  *   NUMA socket ID for LPM table memory allocation
+ * With the RTE_LPM_F_TBL8_GROW flag, the tbl8 groups are doubled when a rule
+ * needs one and they are all used. The new table is published to the readers
+ * with a release store, and the old table is freed after waiting for all the
+ * readers to be quiescent, so the growth is done only once RCU is configured
+ * with rte_lpm_rcu_qsbr_add(). The defer queue size should then be configured
+ * for the maximum number of tbl8 groups.
+ *
  * @param config
  *   Structure containing the configuration
  * @return
@@ -165,6 +191,39 @@ struct rte_lpm *
 rte_lpm_create(const char *name, int socket_id,
 		const struct rte_lpm_config *config);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Create an LPM object in a persistent memory zone, see rte_persist.h.
+ *
+ * If the zone was left by a previous process, e.g. before a restart, the LPM
+ * object is attached with all its rules instead of being created empty.
+ * RCU must be configured again with rte_lpm_rcu_qsbr_add().
+ * Table updates are not atomic, a process killed in the middle of one
+ * leaves an inconsistent table behind.
+ *
+ * The tbl8 groups are allocated in the zone and cannot grow.
+ * The persistent memory file must be open. rte_lpm_free() detaches the
+ * object from the process, its zone is kept.
+ *
+ * @param name
+ *   LPM object name, also naming its persistent zone
+ * @param config
+ *   Structure containing the configuration, the same as the attached object
+ * @return
+ *   Handle to LPM object on success, NULL otherwise with rte_errno set
+ *   to an appropriate values. Possible rte_errno values include:
+ *    - EINVAL - invalid parameter passed to function, the attached
+ *      object has another configuration, or RTE_LPM_F_TBL8_GROW is set
+ *    - EEXIST - an LPM object with the same name already exists
+ *    - ENOSPC - no space left in the persistent memory file
+ *    - ENOMEM - no memory for the LPM object list entry
+ */
+__rte_experimental
+struct rte_lpm *
+rte_lpm_create_persist(const char *name, const struct rte_lpm_config *config);
+
 /**
  * Find an existing LPM object and return a pointer to it.
  *
@@ -261,6 +320,34 @@ uint32_t *next_hop);
 int
 rte_lpm_delete(struct rte_lpm *lpm, uint32_t ip, uint8_t depth);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Compact the tbl8 groups of an LPM table.
+ *
+ * The tbl8 group of each extended tbl24 entry is merged back into the entry
+ * and freed, if the group has no valid entry or all its entries come from
+ * the same rule of depth 24 or less. The deletions already do it for the
+ * group of the deleted rule, but leave the group in place when it cannot be
+ * freed, e.g. when the RCU defer queue is full.
+ * The groups waiting in the defer queue are also reclaimed, when possible.
+ *
+ * The function scans n tbl24 entries, from where its previous call stopped,
+ * so that it can be called regularly from a background thread, between the
+ * other updates of the table.
+ *
+ * @param lpm
+ *   LPM object handle
+ * @param n
+ *   Number of tbl24 entries to scan, 0 for the whole tbl24
+ * @return
+ *   Number of tbl8 groups freed on success, -EINVAL if lpm is NULL
+ */
+__rte_experimental
+int
+rte_lpm_tbl8_compact(struct rte_lpm *lpm, uint32_t n);
+
 /**
  * Delete all rules from the LPM table.
  *
@@ -375,6 +462,166 @@ rte_lpm_lookup_bulk_func(const struct rte_lpm *lpm, const uint32_t *ips,
 	return 0;
 }
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Create an LPM object replicated on each NUMA socket having enabled lcores.
+ * Each replica is an LPM object allocated on its socket, named after *name*
+ * and the socket ID, so that the lookups of an lcore only read the memory
+ * of its own socket. The threads with no socket use the replica of the main
+ * lcore socket.
+ *
+ * The rules have to be updated through the rte_lpm_numa_*() functions,
+ * which apply the update to all the replicas one after the other: for the
+ * time of an update, lcores of different sockets may get different next hops.
+ *
+ * @param name
+ *   LPM object name prefix
+ * @param config
+ *   Structure containing the configuration of each replica
+ * @return
+ *   Handle to the replicated LPM object on success, NULL otherwise with
+ *   rte_errno set to an appropriate value, see rte_lpm_create().
+ */
+__rte_experimental
+struct rte_lpm_numa *
+rte_lpm_numa_create(const char *name, const struct rte_lpm_config *config);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Free a replicated LPM object and all its replicas.
+ *
+ * @param ln
+ *   Replicated LPM object handle, can be NULL
+ */
+__rte_experimental
+void
+rte_lpm_numa_free(struct rte_lpm_numa *ln);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Associate RCU QSBR variable with all the replicas of a replicated LPM
+ * object, see rte_lpm_rcu_qsbr_add(). Each replica gets its own defer queue.
+ *
+ * @param ln
+ *   Replicated LPM object handle
+ * @param cfg
+ *   RCU QSBR configuration
+ * @return
+ *   On success - 0
+ *   On error - 1 with error code set in rte_errno, the replicas before
+ *   the failing one keep the QSBR variable.
+ */
+__rte_experimental
+int
+rte_lpm_numa_rcu_qsbr_add(struct rte_lpm_numa *ln,
+		struct rte_lpm_rcu_config *cfg);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Add a rule to all the replicas of a replicated LPM object.
+ * If a replica fails to add it, the replicas already updated get back
+ * their previous rule.
+ *
+ * @param ln
+ *   Replicated LPM object handle
+ * @param ip
+ *   IP of the rule to be added
+ * @param depth
+ *   Depth of the rule to be added
+ * @param next_hop
+ *   Next hop of the rule to be added
+ * @return
+ *   0 on success, negative value otherwise
+ */
+__rte_experimental
+int
+rte_lpm_numa_add(struct rte_lpm_numa *ln, uint32_t ip, uint8_t depth,
+		uint32_t next_hop);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Delete a rule from all the replicas of a replicated LPM object.
+ * If a replica fails to delete it, the rule is restored in the replicas
+ * already updated.
+ *
+ * @param ln
+ *   Replicated LPM object handle
+ * @param ip
+ *   IP of the rule to be deleted
+ * @param depth
+ *   Depth of the rule to be deleted
+ * @return
+ *   0 on success, negative value otherwise
+ */
+__rte_experimental
+int
+rte_lpm_numa_delete(struct rte_lpm_numa *ln, uint32_t ip, uint8_t depth);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Delete all rules from all the replicas of a replicated LPM object.
+ *
+ * @param ln
+ *   Replicated LPM object handle
+ */
+__rte_experimental
+void
+rte_lpm_numa_delete_all(struct rte_lpm_numa *ln);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Get the replica looked up by the lcores of a socket. Its rules must not
+ * be updated directly.
+ *
+ * @param ln
+ *   Replicated LPM object handle
+ * @param socket_id
+ *   Socket ID, SOCKET_ID_ANY for the socket of the calling lcore
+ * @return
+ *   LPM object handle, NULL on invalid parameters
+ */
+__rte_experimental
+struct rte_lpm *
+rte_lpm_numa_get(struct rte_lpm_numa *ln, int socket_id);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Get the replica of the socket of the calling lcore, to be given to the
+ * lookup functions, e.g.:
+ * rte_lpm_lookup_bulk(rte_lpm_numa_local(ln), ips, next_hops, n).
+ *
+ * @param ln
+ *   Replicated LPM object handle
+ * @return
+ *   LPM object handle
+ */
+__rte_experimental
+static inline struct rte_lpm *
+rte_lpm_numa_local(const struct rte_lpm_numa *ln)
+{
+	unsigned int socket_id = rte_socket_id();
+
+	if (unlikely(socket_id >= RTE_MAX_NUMA_NODES))
+		return ln->def;
+	return ln->local[socket_id];
+}
+
 /* Mask four results. */
 #define	 RTE_LPM_MASKX4_RES	UINT64_C(0x00ffffff00ffffff)
 
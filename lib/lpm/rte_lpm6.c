@@ -25,6 +25,7 @@
 #include <assert.h>
 #include <rte_jhash.h>
 #include <rte_tailq.h>
+#include <rte_prefetch.h>
 
 #include "rte_lpm6.h"
 
@@ -44,6 +45,9 @@
 #define RULE_HASH_TABLE_EXTRA_SPACE              64
 #define TBL24_IND                        UINT32_MAX
 
+/* Number of addresses walked together by the bulk lookup */
+#define LOOKUP_BULK_BATCH                        32
+
 #define lpm6_tbl8_gindex next_hop
 
 /** Flags for setting an entry as valid/invalid. */
@@ -112,6 +116,11 @@ struct rte_lpm6 {
 
 	struct rte_lpm_tbl8_hdr *tbl8_hdrs; /* array of tbl8 headers */
 
+	/* RCU config. */
+	struct rte_rcu_qsbr *v;		/* RCU QSBR variable. */
+	enum rte_lpm6_qsbr_mode rcu_mode;/* Blocking, defer queue. */
+	struct rte_rcu_qsbr_dq *dq;	/* RCU QSBR defer queue. */
+
 	struct rte_lpm6_tbl_entry tbl8[0]
 			__rte_cache_aligned; /**< LPM tbl8 table. */
 };
@@ -213,6 +222,40 @@ tbl8_available(struct rte_lpm6 *lpm)
 	return lpm->number_tbl8s - lpm->tbl8_pool_pos;
 }
 
+/*
+ * Release a tbl8 unlinked from the tree. With RCU, the tbl8 only goes back
+ * to the pool once the readers can no longer be walking it.
+ */
+static void
+tbl8_free(struct rte_lpm6 *lpm, uint32_t tbl8_ind)
+{
+	if (lpm->v == NULL) {
+		tbl8_put(lpm, tbl8_ind);
+	} else if (lpm->rcu_mode == RTE_LPM6_QSBR_MODE_SYNC) {
+		/* Wait for quiescent state change. */
+		rte_rcu_qsbr_synchronize(lpm->v, RTE_QSBR_THRID_INVALID);
+		tbl8_put(lpm, tbl8_ind);
+	} else if (lpm->rcu_mode == RTE_LPM6_QSBR_MODE_DQ) {
+		/* Push into QSBR defer queue. */
+		if (rte_rcu_qsbr_dq_enqueue(lpm->dq, (void *)&tbl8_ind) != 0)
+			RTE_LOG(ERR, LPM, "Failed to push QSBR FIFO\n");
+	}
+}
+
+/*
+ * Wait for the readers and return all the tbl8s still sitting in the
+ * defer queue to the pool, before the pool gets reinitialized.
+ */
+static void
+tbl8_flush(struct rte_lpm6 *lpm)
+{
+	if (lpm->dq == NULL)
+		return;
+
+	rte_rcu_qsbr_synchronize(lpm->v, RTE_QSBR_THRID_INVALID);
+	rte_rcu_qsbr_dq_reclaim(lpm->dq, lpm->number_tbl8s, NULL, NULL, NULL);
+}
+
 /*
  * Init a rule key.
  *	  note that ip must be already masked
@@ -434,6 +477,8 @@ rte_lpm6_free(struct rte_lpm6 *lpm)
 
 	rte_mcfg_tailq_write_unlock();
 
+	if (lpm->dq != NULL)
+		rte_rcu_qsbr_dq_delete(lpm->dq);
 	rte_free(lpm->tbl8_hdrs);
 	rte_free(lpm->tbl8_pool);
 	rte_hash_free(lpm->rules_tbl);
@@ -441,6 +486,64 @@ rte_lpm6_free(struct rte_lpm6 *lpm)
 	rte_free(te);
 }
 
+static void
+__lpm6_rcu_qsbr_free_resource(void *p, void *data, unsigned int n)
+{
+	RTE_SET_USED(n);
+	tbl8_put(p, *(uint32_t *)data);
+}
+
+/* Associate QSBR variable with an LPM6 object.
+ */
+int
+rte_lpm6_rcu_qsbr_add(struct rte_lpm6 *lpm, struct rte_lpm6_rcu_config *cfg)
+{
+	struct rte_rcu_qsbr_dq_parameters params = {0};
+	char rcu_dq_name[RTE_RCU_QSBR_DQ_NAMESIZE];
+
+	if (lpm == NULL || cfg == NULL) {
+		rte_errno = EINVAL;
+		return 1;
+	}
+
+	if (lpm->v != NULL) {
+		rte_errno = EEXIST;
+		return 1;
+	}
+
+	if (cfg->mode == RTE_LPM6_QSBR_MODE_SYNC) {
+		/* No other things to do. */
+	} else if (cfg->mode == RTE_LPM6_QSBR_MODE_DQ) {
+		/* Init QSBR defer queue. */
+		snprintf(rcu_dq_name, sizeof(rcu_dq_name),
+				"LPM6_RCU_%s", lpm->name);
+		params.name = rcu_dq_name;
+		params.size = cfg->dq_size;
+		if (params.size == 0)
+			params.size = lpm->number_tbl8s;
+		params.trigger_reclaim_limit = cfg->reclaim_thd;
+		params.max_reclaim_size = cfg->reclaim_max;
+		if (params.max_reclaim_size == 0)
+			params.max_reclaim_size = RTE_LPM6_RCU_DQ_RECLAIM_MAX;
+		params.esize = sizeof(uint32_t);	/* tbl8 index */
+		params.free_fn = __lpm6_rcu_qsbr_free_resource;
+		params.p = lpm;
+		params.v = cfg->v;
+		lpm->dq = rte_rcu_qsbr_dq_create(&params);
+		if (lpm->dq == NULL) {
+			RTE_LOG(ERR, LPM, "LPM6 defer queue creation failed\n");
+			return 1;
+		}
+	} else {
+		rte_errno = EINVAL;
+		return 1;
+	}
+	lpm->rcu_mode = cfg->mode;
+	lpm->v = cfg->v;
+
+	return 0;
+}
+
 /* Find a rule */
 static inline int
 rule_find_with_key(struct rte_lpm6 *lpm,
@@ -843,6 +946,12 @@ simulate_add(struct rte_lpm6 *lpm, const uint8_t *masked_ip, uint8_t depth)
 		total_need_tbl_nb += need_tbl_nb;
 	}
 
+	/* If there are not enough tbl8s try to reclaim the missing ones. */
+	if (tbl8_available(lpm) < total_need_tbl_nb && lpm->dq != NULL)
+		rte_rcu_qsbr_dq_reclaim(lpm->dq,
+			total_need_tbl_nb - tbl8_available(lpm),
+			NULL, NULL, NULL);
+
 	if (tbl8_available(lpm) < total_need_tbl_nb)
 		/* not enough tbl8 to add a rule */
 		return -ENOSPC;
@@ -971,6 +1080,57 @@ rte_lpm6_lookup(const struct rte_lpm6 *lpm, const uint8_t *ip,
 	return status;
 }
 
+/*
+ * Looks up a batch of at most LOOKUP_BULK_BATCH IP addresses.
+ * Each pass inspects one level for all the addresses still being walked,
+ * prefetching the entries of the next level, so that the cache misses of
+ * the different addresses are served in parallel.
+ */
+static inline void
+lookup_bulk_batch(const struct rte_lpm6 *lpm,
+		uint8_t ips[][RTE_LPM6_IPV6_ADDR_SIZE],
+		int32_t *next_hops, unsigned int n)
+{
+	const struct rte_lpm6_tbl_entry *tbl[LOOKUP_BULK_BATCH];
+	uint8_t active[LOOKUP_BULK_BATCH];
+	uint32_t tbl24_index, tbl8_index, tbl_entry;
+	unsigned int i, j, k, nb_active;
+	uint8_t first_byte;
+
+	for (i = 0; i < n; i++) {
+		tbl24_index = (ips[i][0] << BYTES2_SIZE) |
+				(ips[i][1] << BYTE_SIZE) | ips[i][2];
+		tbl[i] = &lpm->tbl24[tbl24_index];
+		rte_prefetch0(tbl[i]);
+		active[i] = i;
+	}
+
+	first_byte = LOOKUP_FIRST_BYTE;
+	for (nb_active = n; nb_active != 0; nb_active = j) {
+		for (i = 0, j = 0; i < nb_active; i++) {
+			k = active[i];
+			tbl_entry = *(const uint32_t *)tbl[k];
+
+			if ((tbl_entry & RTE_LPM6_VALID_EXT_ENTRY_BITMASK) ==
+					RTE_LPM6_VALID_EXT_ENTRY_BITMASK) {
+				/* Extended entry, continue in the next tbl8 */
+				tbl8_index = ips[k][first_byte - 1] +
+					((tbl_entry & RTE_LPM6_TBL8_BITMASK) *
+					RTE_LPM6_TBL8_GROUP_NUM_ENTRIES);
+				tbl[k] = &lpm->tbl8[tbl8_index];
+				rte_prefetch0(tbl[k]);
+				active[j++] = k;
+			} else if (tbl_entry & RTE_LPM6_LOOKUP_SUCCESS) {
+				next_hops[k] = (int32_t)(tbl_entry &
+					RTE_LPM6_TBL8_BITMASK);
+			} else {
+				next_hops[k] = -1;
+			}
+		}
+		first_byte++;
+	}
+}
+
 /*
  * Looks up a group of IP addresses
  */
@@ -980,38 +1140,14 @@ rte_lpm6_lookup_bulk_func(const struct rte_lpm6 *lpm,
 		int32_t *next_hops, unsigned int n)
 {
 	unsigned int i;
-	const struct rte_lpm6_tbl_entry *tbl;
-	const struct rte_lpm6_tbl_entry *tbl_next = NULL;
-	uint32_t tbl24_index, next_hop;
-	uint8_t first_byte;
-	int status;
 
 	/* DEBUG: Check user input arguments. */
 	if ((lpm == NULL) || (ips == NULL) || (next_hops == NULL))
 		return -EINVAL;
 
-	for (i = 0; i < n; i++) {
-		first_byte = LOOKUP_FIRST_BYTE;
-		tbl24_index = (ips[i][0] << BYTES2_SIZE) |
-				(ips[i][1] << BYTE_SIZE) | ips[i][2];
-
-		/* Calculate pointer to the first entry to be inspected */
-		tbl = &lpm->tbl24[tbl24_index];
-
-		do {
-			/* Continue inspecting following levels
-			 * until success or failure
-			 */
-			status = lookup_step(lpm, tbl, &tbl_next, ips[i],
-					first_byte++, &next_hop);
-			tbl = tbl_next;
-		} while (status == 1);
-
-		if (status < 0)
-			next_hops[i] = -1;
-		else
-			next_hops[i] = (int32_t)next_hop;
-	}
+	for (i = 0; i < n; i += LOOKUP_BULK_BATCH)
+		lookup_bulk_batch(lpm, &ips[i], &next_hops[i],
+				RTE_MIN(n - i, (unsigned int)LOOKUP_BULK_BATCH));
 
 	return 0;
 }
@@ -1093,6 +1229,7 @@ rte_lpm6_delete_bulk_func(struct rte_lpm6 *lpm,
 	memset(lpm->tbl24, 0, sizeof(lpm->tbl24));
 	memset(lpm->tbl8, 0, sizeof(lpm->tbl8[0])
 			* RTE_LPM6_TBL8_GROUP_NUM_ENTRIES * lpm->number_tbl8s);
+	tbl8_flush(lpm);
 	tbl8_pool_init(lpm);
 
 	/*
@@ -1121,6 +1258,7 @@ rte_lpm6_delete_all(struct rte_lpm6 *lpm)
 			RTE_LPM6_TBL8_GROUP_NUM_ENTRIES * lpm->number_tbl8s);
 
 	/* init pool of free tbl8 indexes */
+	tbl8_flush(lpm);
 	tbl8_pool_init(lpm);
 
 	/* Delete all rules form the rules table. */
@@ -1284,7 +1422,7 @@ remove_tbl(struct rte_lpm6 *lpm, struct rte_lpm_tbl8_hdr *tbl_hdr,
 	}
 
 	/* return the table to the pool */
-	tbl8_put(lpm, tbl_ind);
+	tbl8_free(lpm, tbl_ind);
 }
 
 /*
@@ -0,0 +1,75 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2015 Intel Corporation.
+ * Copyright(c) Cavium, Inc. 2017.
+ * Copyright 2012 Hasan Alayli <halayli@gmail.com>
+ */
+
+#include "lthread_ctx.h"
+
+#if defined(RTE_ARCH_X86_64)
+__asm__ (
+".text\n"
+".p2align 4,,15\n"
+".globl lthread_ctx_switch\n"
+".type lthread_ctx_switch, @function\n"
+"lthread_ctx_switch:\n"
+"	movq %rsp, 0(%rsi)	# save stack_pointer\n"
+"	movq %rbp, 8(%rsi)	# save frame_pointer\n"
+"	movq (%rsp), %rax	# save insn_pointer\n"
+"	movq %rax, 16(%rsi)\n"
+"	movq %rbx, 24(%rsi)	# save rbx,r12-r15\n"
+"	movq 24(%rdi), %rbx\n"
+"	movq %r15, 56(%rsi)\n"
+"	movq %r14, 48(%rsi)\n"
+"	movq 48(%rdi), %r14\n"
+"	movq 56(%rdi), %r15\n"
+"	movq %r13, 40(%rsi)\n"
+"	movq %r12, 32(%rsi)\n"
+"	movq 32(%rdi), %r12\n"
+"	movq 40(%rdi), %r13\n"
+"	movq 0(%rdi), %rsp	# restore stack_pointer\n"
+"	movq 16(%rdi), %rax	# restore insn_pointer\n"
+"	movq 8(%rdi), %rbp	# restore frame_pointer\n"
+"	movq %rax, (%rsp)\n"
+"	ret\n"
+".size lthread_ctx_switch, .-lthread_ctx_switch\n"
+);
+#elif defined(RTE_ARCH_ARM64)
+__asm__ (
+".text\n"
+".p2align 4\n"
+".globl lthread_ctx_switch\n"
+".type lthread_ctx_switch, %function\n"
+"lthread_ctx_switch:\n"
+	/* Save SP, FP and LR */
+"	mov x3, sp\n"
+"	str x3, [x1, #0]\n"
+"	stp x29, x30, [x1, #8]\n"
+	/* Save callee saved registers x19 - x28 */
+"	stp x19, x20, [x1, #24]\n"
+"	stp x21, x22, [x1, #40]\n"
+"	stp x23, x24, [x1, #56]\n"
+"	stp x25, x26, [x1, #72]\n"
+"	stp x27, x28, [x1, #88]\n"
+	/* Save bottom 64 bits of callee saved SIMD registers v8 - v15 */
+"	stp d8, d9, [x1, #104]\n"
+"	stp d10, d11, [x1, #120]\n"
+"	stp d12, d13, [x1, #136]\n"
+"	stp d14, d15, [x1, #152]\n"
+	/* Restore the same from the new context */
+"	ldr x3, [x0, #0]\n"
+"	mov sp, x3\n"
+"	ldp x29, x30, [x0, #8]\n"
+"	ldp x19, x20, [x0, #24]\n"
+"	ldp x21, x22, [x0, #40]\n"
+"	ldp x23, x24, [x0, #56]\n"
+"	ldp x25, x26, [x0, #72]\n"
+"	ldp x27, x28, [x0, #88]\n"
+"	ldp d8, d9, [x0, #104]\n"
+"	ldp d10, d11, [x0, #120]\n"
+"	ldp d12, d13, [x0, #136]\n"
+"	ldp d14, d15, [x0, #152]\n"
+"	ret\n"
+".size lthread_ctx_switch, .-lthread_ctx_switch\n"
+);
+#endif
@@ -0,0 +1,73 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2015 Intel Corporation.
+ * Copyright(c) Cavium, Inc. 2017.
+ * Copyright 2012 Hasan Alayli <halayli@gmail.com>
+ */
+
+#ifndef _LTHREAD_CTX_H_
+#define _LTHREAD_CTX_H_
+
+#include <rte_common.h>
+
+/*
+ * CPU context of an lthread: the stack pointer and the callee-saved
+ * registers, saved and restored by lthread_ctx_switch().
+ */
+#if defined(RTE_ARCH_X86_64)
+struct lthread_ctx {
+	void *rsp;	/* 0  */
+	void *rbp;	/* 8  */
+	void *rip;	/* 16 */
+	void *rbx;	/* 24 */
+	void *r12;	/* 32 */
+	void *r13;	/* 40 */
+	void *r14;	/* 48 */
+	void *r15;	/* 56 */
+};
+#elif defined(RTE_ARCH_ARM64)
+struct lthread_ctx {
+	void *sp;	/* 0 */
+	void *fp;	/* 8 */
+	void *lr;	/* 16 */
+	void *x[10];	/* 24, x19 - x28 */
+	double d[8];	/* 104, d8 - d15 */
+};
+#else
+#error "lthread context switch not supported on this architecture"
+#endif
+
+/* Save the current context in *cur* and resume the context *next*. */
+void
+lthread_ctx_switch(struct lthread_ctx *next, struct lthread_ctx *cur);
+
+/*
+ * Set up a context starting *entry* on a stack ending at *stack_top*,
+ * 16 bytes aligned. The argument of *entry* is the context, as the first
+ * argument of lthread_ctx_switch() is left in place. *entry* must not
+ * return.
+ */
+static inline void
+lthread_ctx_init(struct lthread_ctx *ctx, void *stack_top,
+		void (*entry)(struct lthread_ctx *))
+{
+	void **s = stack_top;
+
+#if defined(RTE_ARCH_X86_64)
+	/* Return address of entry, the return address slot of the switch
+	 * being just below.
+	 */
+	s[-3] = NULL;
+	ctx->rsp = &s[-4];
+	ctx->rbp = &s[-3];
+	ctx->rip = (void *)entry;
+#elif defined(RTE_ARCH_ARM64)
+	/* Last frame record */
+	s[-2] = NULL;
+	s[-1] = NULL;
+	ctx->sp = &s[-2];
+	ctx->fp = &s[-2];
+	ctx->lr = (void *)entry;
+#endif
+}
+
+#endif /* _LTHREAD_CTX_H_ */
@@ -0,0 +1,498 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <stdio.h>
+#include <errno.h>
+#include <sys/queue.h>
+
+#include <rte_common.h>
+#include <rte_cycles.h>
+#include <rte_eventdev.h>
+#include <rte_lcore.h>
+#include <rte_malloc.h>
+#include <rte_pause.h>
+#include <rte_per_lcore.h>
+#include <rte_ring.h>
+#include <rte_timer.h>
+
+#include "rte_lthread.h"
+#include "lthread_ctx.h"
+
+/* Number of free lthreads kept by each scheduler for reuse */
+#define LTHREAD_CACHE_SIZE 64
+
+/* Maximum number of lthreads run from a ready queue in a loop */
+#define LTHREAD_RUN_BURST 32
+
+/* State in which an lthread switches back to its scheduler */
+enum lthread_state {
+	LT_READY,
+	LT_SUSPENDED,
+	LT_EXITED,
+};
+
+struct lthread_sched;
+
+struct rte_lthread {
+	struct lthread_ctx ctx; /* first, see lthread_ctx_init() */
+	struct lthread_sched *sched; /* scheduler running it last */
+	enum lthread_state state;
+	unsigned int flags;
+	rte_lthread_func_t func;
+	void *arg;
+
+	/* Suspend and wakeup handshake, see lthread_unblock() */
+	uint32_t blocked;
+	uint32_t wake;
+
+	struct rte_timer tim; /* sleep timer */
+	void *stack;
+	size_t stack_size;
+	SLIST_ENTRY(rte_lthread) next; /* in the free list */
+} __rte_cache_aligned;
+
+struct lthread_sched {
+	struct lthread_ctx ctx; /* context of the scheduler loop */
+	struct rte_lthread *current;
+	unsigned int lcore_id;
+	size_t stack_size;
+	int steal;
+	int stop;
+
+	/* Ready lthreads bound to the scheduler, single consumer */
+	struct rte_ring *pinned;
+	/* Ready stealable lthreads, multi consumer */
+	struct rte_ring *shared;
+
+	SLIST_HEAD(, rte_lthread) free_list;
+	unsigned int nb_free;
+
+	struct rte_lthread_sched_stats stats;
+} __rte_cache_aligned;
+
+static struct lthread_sched *lthread_scheds[RTE_MAX_LCORE];
+
+/* Scheduler running on the lcore */
+static RTE_DEFINE_PER_LCORE(struct lthread_sched *, lthread_sched);
+
+/* Number of lthreads, bounded by RTE_LTHREAD_MAX to size the queues */
+static uint32_t lthread_count;
+
+int
+rte_lthread_sched_create(unsigned int lcore_id,
+		const struct rte_lthread_sched_params *params)
+{
+	char name[RTE_RING_NAMESIZE];
+	struct lthread_sched *sched;
+	size_t stack_size;
+	int socket_id;
+
+	if (lcore_id >= RTE_MAX_LCORE)
+		return -EINVAL;
+	if (lthread_scheds[lcore_id] != NULL)
+		return -EEXIST;
+
+	stack_size = params != NULL ? params->stack_size : 0;
+	if (stack_size == 0)
+		stack_size = RTE_LTHREAD_STACK_SIZE_DEFAULT;
+	if (stack_size < RTE_CACHE_LINE_SIZE)
+		return -EINVAL;
+
+	socket_id = rte_lcore_to_socket_id(lcore_id);
+	sched = rte_zmalloc_socket("lthread_sched", sizeof(*sched),
+			RTE_CACHE_LINE_SIZE, socket_id);
+	if (sched == NULL)
+		return -ENOMEM;
+
+	sched->lcore_id = lcore_id;
+	/* Keep the stack top 16 bytes aligned */
+	sched->stack_size = RTE_ALIGN_CEIL(stack_size, 16);
+	sched->steal = params != NULL && params->steal;
+	SLIST_INIT(&sched->free_list);
+
+	snprintf(name, sizeof(name), "lthread_p%u", lcore_id);
+	sched->pinned = rte_ring_create(name, RTE_LTHREAD_MAX, socket_id,
+			RING_F_SC_DEQ | RING_F_EXACT_SZ);
+	snprintf(name, sizeof(name), "lthread_s%u", lcore_id);
+	sched->shared = rte_ring_create(name, RTE_LTHREAD_MAX, socket_id,
+			RING_F_EXACT_SZ);
+	if (sched->pinned == NULL || sched->shared == NULL) {
+		rte_ring_free(sched->pinned);
+		rte_ring_free(sched->shared);
+		rte_free(sched);
+		return -ENOMEM;
+	}
+
+	__atomic_store_n(&lthread_scheds[lcore_id], sched, __ATOMIC_RELEASE);
+
+	return 0;
+}
+
+static void
+lthread_free(struct lthread_sched *sched, struct rte_lthread *lt)
+{
+	__atomic_sub_fetch(&lthread_count, 1, __ATOMIC_RELAXED);
+
+	if (lt->stack_size == sched->stack_size &&
+			sched->nb_free < LTHREAD_CACHE_SIZE) {
+		SLIST_INSERT_HEAD(&sched->free_list, lt, next);
+		sched->nb_free++;
+		return;
+	}
+
+	rte_free(lt);
+}
+
+void
+rte_lthread_sched_free(unsigned int lcore_id)
+{
+	struct lthread_sched *sched;
+	struct rte_lthread *lt;
+	void *obj;
+
+	if (lcore_id >= RTE_MAX_LCORE || lthread_scheds[lcore_id] == NULL)
+		return;
+
+	sched = lthread_scheds[lcore_id];
+	lthread_scheds[lcore_id] = NULL;
+
+	while (rte_ring_dequeue(sched->pinned, &obj) == 0)
+		lthread_free(sched, obj);
+	while (rte_ring_dequeue(sched->shared, &obj) == 0)
+		lthread_free(sched, obj);
+	while ((lt = SLIST_FIRST(&sched->free_list)) != NULL) {
+		SLIST_REMOVE_HEAD(&sched->free_list, next);
+		rte_free(lt);
+	}
+
+	rte_ring_free(sched->pinned);
+	rte_ring_free(sched->shared);
+	rte_free(sched);
+}
+
+/* Queue a ready lthread, the room is ensured by RTE_LTHREAD_MAX. */
+static void
+lthread_enqueue(struct lthread_sched *sched, struct rte_lthread *lt)
+{
+	struct rte_ring *r;
+
+	r = (lt->flags & RTE_LTHREAD_F_STEALABLE) ? sched->shared :
+		sched->pinned;
+	RTE_VERIFY(rte_ring_enqueue(r, lt) == 0);
+}
+
+/*
+ * A suspended lthread is only queued again once blocked is set by its
+ * scheduler, after switching out of it. The waker sets wake before
+ * checking blocked, and the scheduler sets blocked before checking wake,
+ * so that either sees the other and queues the lthread once.
+ */
+static void
+lthread_unblock(struct rte_lthread *lt)
+{
+	uint32_t blocked = 1;
+
+	if (__atomic_compare_exchange_n(&lt->blocked, &blocked, 0, 0,
+			__ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+		__atomic_store_n(&lt->wake, 0, __ATOMIC_RELAXED);
+		lthread_enqueue(lt->sched, lt);
+	}
+}
+
+static void
+lthread_run(struct lthread_sched *sched, struct rte_lthread *lt)
+{
+	sched->current = lt;
+	lt->sched = sched;
+	lthread_ctx_switch(&lt->ctx, &sched->ctx);
+	sched->current = NULL;
+	sched->stats.runs++;
+
+	switch (lt->state) {
+	case LT_READY:
+		lthread_enqueue(sched, lt);
+		break;
+	case LT_SUSPENDED:
+		__atomic_store_n(&lt->blocked, 1, __ATOMIC_SEQ_CST);
+		if (__atomic_load_n(&lt->wake, __ATOMIC_SEQ_CST))
+			lthread_unblock(lt);
+		break;
+	case LT_EXITED:
+		lthread_free(sched, lt);
+		break;
+	}
+}
+
+static unsigned int
+lthread_run_queue(struct lthread_sched *sched, struct rte_ring *r)
+{
+	void *lts[LTHREAD_RUN_BURST];
+	unsigned int i, n;
+
+	n = rte_ring_dequeue_burst(r, lts, LTHREAD_RUN_BURST, NULL);
+	for (i = 0; i < n; i++)
+		lthread_run(sched, lts[i]);
+
+	return n;
+}
+
+/* Steal a ready lthread from the next scheduler having some. */
+static unsigned int
+lthread_steal(struct lthread_sched *sched)
+{
+	struct lthread_sched *victim;
+	unsigned int i, lcore_id;
+	void *lt;
+
+	for (i = 1; i < RTE_MAX_LCORE; i++) {
+		lcore_id = (sched->lcore_id + i) % RTE_MAX_LCORE;
+		victim = __atomic_load_n(&lthread_scheds[lcore_id],
+				__ATOMIC_ACQUIRE);
+		if (victim == NULL || rte_ring_empty(victim->shared))
+			continue;
+		if (rte_ring_dequeue(victim->shared, &lt) == 0) {
+			sched->stats.steals++;
+			lthread_run(sched, lt);
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+int
+rte_lthread_sched_run(void *arg __rte_unused)
+{
+	unsigned int lcore_id = rte_lcore_id();
+	struct lthread_sched *sched;
+	unsigned int n;
+
+	if (lcore_id >= RTE_MAX_LCORE || lthread_scheds[lcore_id] == NULL)
+		return -EINVAL;
+
+	sched = lthread_scheds[lcore_id];
+	RTE_PER_LCORE(lthread_sched) = sched;
+
+	while (!__atomic_load_n(&sched->stop, __ATOMIC_RELAXED)) {
+		rte_timer_manage();
+
+		n = lthread_run_queue(sched, sched->pinned);
+		n += lthread_run_queue(sched, sched->shared);
+		if (n == 0 && sched->steal)
+			n = lthread_steal(sched);
+		if (n == 0) {
+			sched->stats.idle++;
+			rte_pause();
+		}
+	}
+
+	__atomic_store_n(&sched->stop, 0, __ATOMIC_RELAXED);
+	RTE_PER_LCORE(lthread_sched) = NULL;
+
+	return 0;
+}
+
+void
+rte_lthread_sched_stop(unsigned int lcore_id)
+{
+	if (lcore_id < RTE_MAX_LCORE && lthread_scheds[lcore_id] != NULL)
+		__atomic_store_n(&lthread_scheds[lcore_id]->stop, 1,
+				__ATOMIC_RELAXED);
+}
+
+int
+rte_lthread_sched_stats_get(unsigned int lcore_id,
+		struct rte_lthread_sched_stats *stats)
+{
+	if (lcore_id >= RTE_MAX_LCORE || lthread_scheds[lcore_id] == NULL ||
+			stats == NULL)
+		return -EINVAL;
+
+	*stats = lthread_scheds[lcore_id]->stats;
+
+	return 0;
+}
+
+static void
+lthread_entry(struct lthread_ctx *ctx)
+{
+	struct rte_lthread *lt = container_of(ctx, struct rte_lthread, ctx);
+
+	lt->func(lt->arg);
+	rte_lthread_exit();
+}
+
+/* Get a free lthread, from the cache of the calling scheduler if any. */
+static struct rte_lthread *
+lthread_alloc(struct lthread_sched *sched)
+{
+	struct lthread_sched *cur = RTE_PER_LCORE(lthread_sched);
+	struct rte_lthread *lt;
+
+	if (cur != NULL && cur->stack_size == sched->stack_size &&
+			!SLIST_EMPTY(&cur->free_list)) {
+		lt = SLIST_FIRST(&cur->free_list);
+		SLIST_REMOVE_HEAD(&cur->free_list, next);
+		cur->nb_free--;
+		return lt;
+	}
+
+	lt = rte_malloc_socket("lthread", sizeof(*lt) + sched->stack_size,
+			RTE_CACHE_LINE_SIZE,
+			rte_lcore_to_socket_id(sched->lcore_id));
+	if (lt == NULL)
+		return NULL;
+
+	lt->stack = lt + 1;
+	lt->stack_size = sched->stack_size;
+
+	return lt;
+}
+
+int
+rte_lthread_create(struct rte_lthread **ltp, unsigned int lcore_id,
+		rte_lthread_func_t func, void *arg, unsigned int flags)
+{
+	struct lthread_sched *sched;
+	struct rte_lthread *lt;
+
+	if (lcore_id >= RTE_MAX_LCORE || func == NULL ||
+			(flags & ~RTE_LTHREAD_F_STEALABLE) != 0)
+		return -EINVAL;
+
+	sched = __atomic_load_n(&lthread_scheds[lcore_id], __ATOMIC_ACQUIRE);
+	if (sched == NULL)
+		return -EINVAL;
+
+	if (__atomic_add_fetch(&lthread_count, 1, __ATOMIC_RELAXED) >
+			RTE_LTHREAD_MAX) {
+		__atomic_sub_fetch(&lthread_count, 1, __ATOMIC_RELAXED);
+		return -ENOSPC;
+	}
+
+	lt = lthread_alloc(sched);
+	if (lt == NULL) {
+		__atomic_sub_fetch(&lthread_count, 1, __ATOMIC_RELAXED);
+		return -ENOMEM;
+	}
+
+	lt->sched = sched;
+	lt->state = LT_READY;
+	lt->flags = flags;
+	lt->func = func;
+	lt->arg = arg;
+	lt->blocked = 0;
+	lt->wake = 0;
+	rte_timer_init(&lt->tim);
+	lthread_ctx_init(&lt->ctx, RTE_PTR_ADD(lt->stack, lt->stack_size),
+			lthread_entry);
+
+	if (ltp != NULL)
+		*ltp = lt;
+
+	lthread_enqueue(sched, lt);
+
+	return 0;
+}
+
+struct rte_lthread *
+rte_lthread_self(void)
+{
+	struct lthread_sched *sched = RTE_PER_LCORE(lthread_sched);
+
+	return sched != NULL ? sched->current : NULL;
+}
+
+/*
+ * Switch back to the scheduler. The lthread may resume on another lcore,
+ * the per-lcore data must not be used after the switch in the same
+ * function.
+ */
+static void
+lthread_switch_out(struct rte_lthread *lt, enum lthread_state state)
+{
+	lt->state = state;
+	lthread_ctx_switch(&lt->sched->ctx, &lt->ctx);
+}
+
+void
+rte_lthread_yield(void)
+{
+	lthread_switch_out(rte_lthread_self(), LT_READY);
+}
+
+void
+rte_lthread_suspend(void)
+{
+	struct rte_lthread *lt = rte_lthread_self();
+
+	if (__atomic_exchange_n(&lt->wake, 0, __ATOMIC_ACQUIRE))
+		return;
+
+	lthread_switch_out(lt, LT_SUSPENDED);
+}
+
+void
+rte_lthread_wakeup(struct rte_lthread *lt)
+{
+	__atomic_store_n(&lt->wake, 1, __ATOMIC_SEQ_CST);
+	lthread_unblock(lt);
+}
+
+static void
+lthread_timer_cb(struct rte_timer *tim __rte_unused, void *arg)
+{
+	rte_lthread_wakeup(arg);
+}
+
+void
+rte_lthread_sleep(uint64_t ns)
+{
+	struct rte_lthread *lt = rte_lthread_self();
+	uint64_t hz = rte_get_timer_hz();
+	uint64_t ticks, end;
+
+	ticks = ns / NS_PER_S * hz + ns % NS_PER_S * hz / NS_PER_S;
+	end = rte_get_timer_cycles() + ticks;
+	if (ticks == 0 || rte_timer_reset(&lt->tim, ticks, SINGLE,
+			rte_lcore_id(), lthread_timer_cb, lt) != 0) {
+		/* No timer, poll the time */
+		do {
+			rte_lthread_yield();
+		} while (rte_get_timer_cycles() < end);
+		return;
+	}
+
+	do {
+		rte_lthread_suspend();
+	} while (rte_get_timer_cycles() < end);
+
+	/* Woken up by someone else when the time was up */
+	rte_timer_stop_sync(&lt->tim);
+}
+
+void
+rte_lthread_exit(void)
+{
+	lthread_switch_out(rte_lthread_self(), LT_EXITED);
+	rte_panic("exited lthread resumed\n");
+}
+
+uint16_t
+rte_lthread_event_dequeue(uint8_t dev_id, uint8_t port_id,
+		struct rte_event *ev, uint16_t nb_events, uint64_t timeout_ns)
+{
+	uint64_t hz = rte_get_timer_hz();
+	uint64_t end;
+	uint16_t n;
+
+	end = rte_get_timer_cycles() + timeout_ns / NS_PER_S * hz +
+		timeout_ns % NS_PER_S * hz / NS_PER_S;
+	for (;;) {
+		n = rte_event_dequeue_burst(dev_id, port_id, ev, nb_events, 0);
+		if (n != 0 || rte_get_timer_cycles() >= end)
+			return n;
+		rte_lthread_yield();
+	}
+}
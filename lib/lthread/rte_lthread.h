@@ -0,0 +1,296 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#ifndef _RTE_LTHREAD_H_
+#define _RTE_LTHREAD_H_
+
+/**
+ * @file
+ * RTE lthread
+ *
+ * Cooperative user space threads (lthreads) run by a scheduler on each
+ * lcore. An lthread runs until it yields, suspends, sleeps or returns,
+ * making it possible to write blocking style code, like protocol stacks,
+ * on top of the polling lcores. The switch between two lthreads only saves
+ * and restores the callee-saved registers.
+ *
+ * Each scheduler has two queues of ready lthreads: the lthreads bound to
+ * the scheduler, and the stealable lthreads (RTE_LTHREAD_F_STEALABLE),
+ * which an idle scheduler may steal and run on its own lcore.
+ * A stealable lthread may then resume on another lcore after any yield,
+ * suspend or sleep, so it must not keep per-lcore data, like rte_lcore_id()
+ * or non thread safe device queues, across them.
+ *
+ * The schedulers call rte_timer_manage(), so the lthreads can use the
+ * timers, which must be initialized with rte_timer_subsystem_init().
+ */
+
+#include <stdint.h>
+
+#include <rte_common.h>
+#include <rte_compat.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Maximum number of lthreads. */
+#define RTE_LTHREAD_MAX 4096
+
+/** Default size of the lthread stacks. */
+#define RTE_LTHREAD_STACK_SIZE_DEFAULT (64 * 1024)
+
+/** The lthread can be stolen by the other schedulers. */
+#define RTE_LTHREAD_F_STEALABLE (1U << 0)
+
+/** Lthread handle. */
+struct rte_lthread;
+
+struct rte_event;
+
+/**
+ * Lthread function. Returning from it ends the lthread.
+ *
+ * @param arg
+ *  Opaque argument given to rte_lthread_create().
+ */
+typedef void (*rte_lthread_func_t)(void *arg);
+
+/** Scheduler parameters. */
+struct rte_lthread_sched_params {
+	size_t stack_size;
+	/**< Stack size of the lthreads created on the scheduler,
+	 * 0 for RTE_LTHREAD_STACK_SIZE_DEFAULT.
+	 */
+
+	int steal;
+	/**< Steal the stealable lthreads of the other schedulers when idle. */
+};
+
+/** Scheduler statistics. */
+struct rte_lthread_sched_stats {
+	uint64_t runs;   /**< Number of lthread runs. */
+	uint64_t steals; /**< Number of lthreads stolen from other schedulers. */
+	uint64_t idle;   /**< Number of scheduler loops without lthread to run. */
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Create the lthread scheduler of an lcore. It is run by calling
+ * rte_lthread_sched_run() on the lcore.
+ *
+ * @param lcore_id
+ *  Lcore of the scheduler.
+ * @param params
+ *  Scheduler parameters, NULL for the defaults.
+ * @return
+ *  0 on success,
+ *  -EINVAL if the lcore or the parameters are invalid,
+ *  -EEXIST if the lcore already has a scheduler,
+ *  -ENOMEM if the allocation failed.
+ */
+__rte_experimental
+int
+rte_lthread_sched_create(unsigned int lcore_id,
+		const struct rte_lthread_sched_params *params);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Free the scheduler of an lcore, with its ready lthreads. No scheduler
+ * must be running.
+ *
+ * @param lcore_id
+ *  Lcore of the scheduler.
+ */
+__rte_experimental
+void
+rte_lthread_sched_free(unsigned int lcore_id);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Run the scheduler of the calling lcore until rte_lthread_sched_stop() is
+ * called. Can be given to rte_eal_remote_launch(). The lthreads still
+ * queued on return are run when the scheduler is run again.
+ *
+ * @param arg
+ *  Unused.
+ * @return
+ *  0 on success, -EINVAL if the lcore has no scheduler.
+ */
+__rte_experimental
+int
+rte_lthread_sched_run(void *arg);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Request the scheduler of an lcore to return. Can be called from any
+ * thread, including an lthread.
+ *
+ * @param lcore_id
+ *  Lcore of the scheduler.
+ */
+__rte_experimental
+void
+rte_lthread_sched_stop(unsigned int lcore_id);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Read the statistics of a scheduler.
+ *
+ * @param lcore_id
+ *  Lcore of the scheduler.
+ * @param stats
+ *  Statistics to fill.
+ * @return
+ *  0 on success, -EINVAL otherwise.
+ */
+__rte_experimental
+int
+rte_lthread_sched_stats_get(unsigned int lcore_id,
+		struct rte_lthread_sched_stats *stats);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Create an lthread, ready to run on the scheduler of an lcore.
+ * Can be called from any thread.
+ *
+ * @param lt
+ *  Where to store the lthread handle, can be NULL. The handle is valid
+ *  until the lthread returns.
+ * @param lcore_id
+ *  Lcore of the scheduler.
+ * @param func
+ *  Lthread function.
+ * @param arg
+ *  Argument of the lthread function.
+ * @param flags
+ *  RTE_LTHREAD_F_* flags.
+ * @return
+ *  0 on success,
+ *  -EINVAL if the lcore has no scheduler or the parameters are invalid,
+ *  -ENOSPC if RTE_LTHREAD_MAX lthreads already exist,
+ *  -ENOMEM if the allocation failed.
+ */
+__rte_experimental
+int
+rte_lthread_create(struct rte_lthread **lt, unsigned int lcore_id,
+		rte_lthread_func_t func, void *arg, unsigned int flags);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Get the calling lthread.
+ *
+ * @return
+ *  The calling lthread, NULL when not called from an lthread.
+ */
+__rte_experimental
+struct rte_lthread *
+rte_lthread_self(void);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Let the other ready lthreads run before resuming the calling lthread.
+ */
+__rte_experimental
+void
+rte_lthread_yield(void);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Suspend the calling lthread until it is woken up by
+ * rte_lthread_wakeup(). A wakeup of the lthread while it is not suspended
+ * makes the next suspend return immediately. The wakeups are not counted,
+ * and a suspend may return spuriously: the caller must check the condition
+ * it waits for again.
+ */
+__rte_experimental
+void
+rte_lthread_suspend(void);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Wake up a suspended lthread. Can be called from any thread, including
+ * an lthread or a timer callback.
+ *
+ * @param lt
+ *  Lthread to wake up.
+ */
+__rte_experimental
+void
+rte_lthread_wakeup(struct rte_lthread *lt);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Suspend the calling lthread for a given time, with an rte_timer.
+ *
+ * @param ns
+ *  Time to sleep, in nanoseconds. The lthread only yields for 0.
+ */
+__rte_experimental
+void
+rte_lthread_sleep(uint64_t ns);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * End the calling lthread, like returning from its function.
+ */
+__rte_experimental
+__rte_noreturn void
+rte_lthread_exit(void);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Dequeue events from an event port, yielding until some are received
+ * or the timeout expires. The other lthreads run meanwhile. As event ports
+ * are not thread safe, the calling lthread must not be stealable.
+ *
+ * @param dev_id
+ *  Event device.
+ * @param port_id
+ *  Event port.
+ * @param ev
+ *  Where to store the dequeued events.
+ * @param nb_events
+ *  Maximum number of events to dequeue.
+ * @param timeout_ns
+ *  Maximum time to wait, in nanoseconds.
+ * @return
+ *  Number of events dequeued, 0 on timeout.
+ */
+__rte_experimental
+uint16_t
+rte_lthread_event_dequeue(uint8_t dev_id, uint8_t port_id,
+		struct rte_event *ev, uint16_t nb_events, uint64_t timeout_ns);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_LTHREAD_H_ */
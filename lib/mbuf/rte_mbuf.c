@@ -518,6 +518,74 @@ void rte_pktmbuf_free_bulk(struct rte_mbuf **mbufs, unsigned int count)
 		rte_mempool_put_bulk(pending[0]->pool, (void **)pending, nb_pending);
 }
 
+/*
+ * Check that a mbuf can be put back to the mempool as is: its refcnt and
+ * nb_segs are both 1, which also implies next is NULL, it is neither
+ * indirect nor has an external buffer, and it belongs to the mempool.
+ * Only the first cache line of the mbuf is read.
+ */
+static __rte_always_inline int
+mbuf_fast_free_ok(const struct rte_mbuf *m, const struct rte_mempool *mp,
+	uint32_t refcnt_segs)
+{
+	uint32_t v;
+
+	/* refcnt and nb_segs are adjacent, compare them at once */
+	memcpy(&v, &m->refcnt, sizeof(v));
+	return (v == refcnt_segs) &
+		((m->ol_flags & (IND_ATTACHED_MBUF | EXT_ATTACHED_MBUF)) == 0) &
+		(m->pool == mp);
+}
+
+/* Free a bulk of single-segment direct packet mbufs into a mempool. */
+void rte_pktmbuf_fast_free_bulk(struct rte_mempool *mp,
+	struct rte_mbuf **mbufs, unsigned int count)
+{
+	const uint16_t one[2] = { 1, 1 };
+	unsigned int idx, start;
+	uint32_t refcnt_segs;
+
+	RTE_BUILD_BUG_ON(offsetof(struct rte_mbuf, nb_segs) !=
+		offsetof(struct rte_mbuf, refcnt) + sizeof(uint16_t));
+	memcpy(&refcnt_segs, one, sizeof(refcnt_segs));
+
+	/*
+	 * The mbufs are checked by groups of four, with a single branch
+	 * per group. The runs of valid mbufs are put from the array itself.
+	 */
+	start = 0;
+	idx = 0;
+	while (idx != count) {
+		if (likely(count - idx >= 4 &&
+				(mbuf_fast_free_ok(mbufs[idx], mp, refcnt_segs) &
+				mbuf_fast_free_ok(mbufs[idx + 1], mp, refcnt_segs) &
+				mbuf_fast_free_ok(mbufs[idx + 2], mp, refcnt_segs) &
+				mbuf_fast_free_ok(mbufs[idx + 3], mp, refcnt_segs)))) {
+			__rte_mbuf_sanity_check(mbufs[idx], 1);
+			__rte_mbuf_sanity_check(mbufs[idx + 1], 1);
+			__rte_mbuf_sanity_check(mbufs[idx + 2], 1);
+			__rte_mbuf_sanity_check(mbufs[idx + 3], 1);
+			idx += 4;
+			continue;
+		}
+		if (mbuf_fast_free_ok(mbufs[idx], mp, refcnt_segs)) {
+			__rte_mbuf_sanity_check(mbufs[idx], 1);
+			idx++;
+			continue;
+		}
+
+		/* exception: flush the current run and free it the slow way */
+		if (idx != start)
+			rte_mempool_put_bulk(mp, (void **)&mbufs[start],
+					idx - start);
+		rte_pktmbuf_free(mbufs[idx]);
+		start = ++idx;
+	}
+
+	if (idx != start)
+		rte_mempool_put_bulk(mp, (void **)&mbufs[start], idx - start);
+}
+
 /* Creates a shallow copy of mbuf */
 struct rte_mbuf *
 rte_pktmbuf_clone(struct rte_mbuf *md, struct rte_mempool *mp)
@@ -653,11 +721,11 @@ rte_pktmbuf_copy(const struct rte_mbuf *m, struct rte_mempool *mp,
 		if (copy_len > rte_pktmbuf_tailroom(m_last))
 			copy_len = rte_pktmbuf_tailroom(m_last);
 
-		/* append from seg to m_last */
-		rte_memcpy(rte_pktmbuf_mtod_offset(m_last, char *,
-						   m_last->data_len),
-			   rte_pktmbuf_mtod_offset(seg, char *, off),
-			   copy_len);
+		/* append from seg to m_last, sparing the cache if large */
+		rte_memcpy_nt(rte_pktmbuf_mtod_offset(m_last, char *,
+						      m_last->data_len),
+			      rte_pktmbuf_mtod_offset(seg, char *, off),
+			      copy_len);
 
 		/* update offsets and lengths */
 		m_last->data_len += copy_len;
@@ -959,6 +959,76 @@ static inline int rte_pktmbuf_alloc_bulk(struct rte_mempool *pool,
 	return 0;
 }
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: This API may change without prior notice.
+ *
+ * Allocate a bulk of direct mbufs, and reset their fields to default values.
+ *
+ * The result is the same as with rte_pktmbuf_alloc_bulk(), but the fields
+ * are reset with a few wide stores per mbuf instead of one store per field,
+ * using a template of the rearm_data word computed once for the pool.
+ * The mempool must be a pool of direct packet mbufs, e.g. created with
+ * rte_pktmbuf_pool_create(), not with rte_pktmbuf_pool_create_extbuf().
+ *
+ *  @param pool
+ *    The mempool of direct mbufs from which mbufs are allocated.
+ *  @param mbufs
+ *    Array of pointers to mbufs
+ *  @param count
+ *    Array size
+ *  @return
+ *   - 0: Success
+ *   - -ENOENT: Not enough entries in the mempool; no mbufs are retrieved.
+ */
+__rte_experimental
+static inline int
+rte_pktmbuf_fast_alloc_bulk(struct rte_mempool *pool,
+	struct rte_mbuf **mbufs, unsigned int count)
+{
+	/* same layout as the fields covered by rearm_data */
+	struct {
+		uint16_t data_off;
+		uint16_t refcnt;
+		uint16_t nb_segs;
+		uint16_t port;
+	} rearm_def;
+	struct rte_mbuf *m;
+	uint64_t rearm;
+	unsigned int idx;
+	int rc;
+
+	RTE_BUILD_BUG_ON(offsetof(struct rte_mbuf, port) -
+		offsetof(struct rte_mbuf, rearm_data) + sizeof(uint16_t) !=
+		sizeof(rearm));
+
+	rc = rte_mempool_get_bulk(pool, (void **)mbufs, count);
+	if (unlikely(rc))
+		return rc;
+
+	rearm_def.data_off = (uint16_t)RTE_MIN((uint16_t)RTE_PKTMBUF_HEADROOM,
+			rte_pktmbuf_data_room_size(pool));
+	rearm_def.refcnt = 1;
+	rearm_def.nb_segs = 1;
+	rearm_def.port = RTE_MBUF_PORT_INVALID;
+	memcpy(&rearm, &rearm_def, sizeof(rearm));
+
+	/* next is already NULL, as for all the mbufs in the pool */
+	for (idx = 0; idx != count; idx++) {
+		m = mbufs[idx];
+		__rte_mbuf_raw_sanity_check(m);
+		/* data_off, refcnt, nb_segs and port */
+		memcpy(&m->rearm_data, &rearm, sizeof(rearm));
+		m->ol_flags = 0;
+		/* packet_type, pkt_len, data_len and vlan_tci */
+		memset(&m->rx_descriptor_fields1, 0, sizeof(uint32_t) * 3);
+		m->vlan_tci_outer = 0;
+		m->tx_offload = 0;
+		__rte_mbuf_sanity_check(m, 1);
+	}
+	return 0;
+}
+
 /**
  * Initialize shared data at the end of an external buffer before attaching
  * to a mbuf by ``rte_pktmbuf_attach_extbuf()``. This is not a mandatory
@@ -1429,6 +1499,32 @@ static inline void rte_pktmbuf_free(struct rte_mbuf *m)
 __rte_experimental
 void rte_pktmbuf_free_bulk(struct rte_mbuf **mbufs, unsigned int count);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: This API may change without prior notice.
+ *
+ * Free a bulk of packet mbufs expected to be single-segment direct mbufs
+ * from a given mempool, and not referenced elsewhere.
+ *
+ * This is the fast path of Tx completion with the
+ * DEV_TX_OFFLOAD_MBUF_FAST_FREE offload: the mbufs meeting these conditions
+ * are checked without writing to them nor touching their second cache line,
+ * and returned to the mempool in bulk, straight from the array.
+ * The other mbufs are freed as with rte_pktmbuf_free(), so that
+ * the result is always correct.
+ *
+ *  @param mp
+ *    The mempool most of the mbufs belong to.
+ *  @param mbufs
+ *    Array of pointers to packet mbufs.
+ *    The array must not contain NULL pointers.
+ *  @param count
+ *    Array size.
+ */
+__rte_experimental
+void rte_pktmbuf_fast_free_bulk(struct rte_mempool *mp,
+	struct rte_mbuf **mbufs, unsigned int count);
+
 /**
  * Create a "clone" of the given packet mbuf.
  *
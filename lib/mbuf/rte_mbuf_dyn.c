@@ -16,9 +16,13 @@
 #include <rte_bitops.h>
 #include <rte_mbuf.h>
 #include <rte_mbuf_dyn.h>
+#include <rte_telemetry.h>
 
 #define RTE_MBUF_DYN_MZNAME "rte_mbuf_dyn"
 
+#define MBUF_DYNFIELD_F_HINTS (RTE_MBUF_DYNFIELD_F_HOT | \
+			       RTE_MBUF_DYNFIELD_F_COLD)
+
 struct mbuf_dynfield_elt {
 	struct rte_mbuf_dynfield params;
 	size_t offset;
@@ -213,11 +217,35 @@ static int mbuf_dynfield_cmp(const struct rte_mbuf_dynfield *params1,
 		return -1;
 	if (params1->align != params2->align)
 		return -1;
-	if (params1->flags != params2->flags)
+	if ((params1->flags & ~MBUF_DYNFIELD_F_HINTS) !=
+			(params2->flags & ~MBUF_DYNFIELD_F_HINTS))
 		return -1;
 	return 0;
 }
 
+/* Placement score of a field at a free offset, the lowest is the best.
+ * Hot fields go in the lowest cache line and cold fields out of the
+ * first one. Then the zones with the lowest shm->free_space[offset] are
+ * preferred: the zones containing room for larger fields are kept for
+ * later. Assume tailq is locked.
+ */
+static unsigned int
+placement_score(const struct rte_mbuf_dynfield *params, size_t offset)
+{
+	unsigned int score = shm->free_space[offset];
+	size_t line;
+
+	if (params->flags & RTE_MBUF_DYNFIELD_F_HOT) {
+		line = (offset + params->size - 1) / RTE_CACHE_LINE_SIZE;
+		score += line << CHAR_BIT;
+	} else if ((params->flags & RTE_MBUF_DYNFIELD_F_COLD) &&
+			offset < RTE_CACHE_LINE_SIZE) {
+		score += 1 << CHAR_BIT;
+	}
+
+	return score;
+}
+
 /* assume tailq is locked */
 static int
 __rte_mbuf_dynfield_register_offset(const struct rte_mbuf_dynfield *params,
@@ -226,7 +254,7 @@ __rte_mbuf_dynfield_register_offset(const struct rte_mbuf_dynfield *params,
 	struct mbuf_dynfield_list *mbuf_dynfield_list;
 	struct mbuf_dynfield_elt *mbuf_dynfield = NULL;
 	struct rte_tailq_entry *te = NULL;
-	unsigned int best_zone = UINT_MAX;
+	unsigned int best_score = UINT_MAX, score;
 	size_t i, offset;
 	int ret;
 
@@ -253,16 +281,17 @@ __rte_mbuf_dynfield_register_offset(const struct rte_mbuf_dynfield *params,
 
 	if (req == SIZE_MAX) {
 		/* Find the best place to put this field: we search the
-		 * lowest value of shm->free_space[offset]: the zones
-		 * containing room for larger fields are kept for later.
+		 * lowest placement score.
 		 */
 		for (offset = 0;
 		     offset < sizeof(struct rte_mbuf);
 		     offset++) {
 			if (check_offset(offset, params->size,
-						params->align) == 0 &&
-					shm->free_space[offset] < best_zone) {
-				best_zone = shm->free_space[offset];
+						params->align) != 0)
+				continue;
+			score = placement_score(params, offset);
+			if (score < best_score) {
+				best_score = score;
 				req = offset;
 			}
 		}
@@ -333,7 +362,9 @@ rte_mbuf_dynfield_register_offset(const struct rte_mbuf_dynfield *params,
 		rte_errno = EINVAL;
 		return -1;
 	}
-	if (params->flags != 0) {
+	if ((params->flags & ~MBUF_DYNFIELD_F_HINTS) != 0 ||
+			(params->flags & MBUF_DYNFIELD_F_HINTS) ==
+			MBUF_DYNFIELD_F_HINTS) {
 		rte_errno = EINVAL;
 		return -1;
 	}
@@ -577,6 +608,7 @@ rte_mbuf_dyn_timestamp_register(int *field_offset, uint64_t *flag,
 		.name = RTE_MBUF_DYNFIELD_TIMESTAMP_NAME,
 		.size = sizeof(rte_mbuf_timestamp_t),
 		.align = __alignof__(rte_mbuf_timestamp_t),
+		.flags = RTE_MBUF_DYNFIELD_F_HOT,
 	};
 	struct rte_mbuf_dynflag flag_desc = {};
 	int offset;
@@ -617,3 +649,153 @@ rte_mbuf_dyn_tx_timestamp_register(int *field_offset, uint64_t *tx_flag)
 	return rte_mbuf_dyn_timestamp_register(field_offset, tx_flag,
 			"Tx", RTE_MBUF_DYNFLAG_TX_TIMESTAMP_NAME);
 }
+
+static const char *
+dynfield_hint_str(unsigned int flags)
+{
+	if (flags & RTE_MBUF_DYNFIELD_F_HOT)
+		return "hot";
+	if (flags & RTE_MBUF_DYNFIELD_F_COLD)
+		return "cold";
+	return "none";
+}
+
+/* Field attributes returned by /mbuf/dynfield, one array each */
+enum {
+	DYNFIELD_TEL_NAME,
+	DYNFIELD_TEL_OFFSET,
+	DYNFIELD_TEL_SIZE,
+	DYNFIELD_TEL_ALIGN,
+	DYNFIELD_TEL_CACHE_LINE,
+	DYNFIELD_TEL_HINT,
+	DYNFIELD_TEL_MAX
+};
+
+static const char * const dynfield_tel_names[DYNFIELD_TEL_MAX] = {
+	"name", "offset", "size", "align", "cache_line", "hint",
+};
+
+static int
+mbuf_dyn_handle_fields(const char *cmd __rte_unused,
+		const char *params __rte_unused, struct rte_tel_data *d)
+{
+	struct rte_tel_data *attr[DYNFIELD_TEL_MAX] = { NULL };
+	struct mbuf_dynfield_list *mbuf_dynfield_list;
+	struct mbuf_dynfield_elt *dynfield;
+	struct rte_tailq_entry *te;
+	int ret = -1;
+	size_t i;
+
+	for (i = 0; i < DYNFIELD_TEL_MAX; i++) {
+		attr[i] = rte_tel_data_alloc();
+		if (attr[i] == NULL)
+			goto out;
+		rte_tel_data_start_array(attr[i],
+			i == DYNFIELD_TEL_NAME || i == DYNFIELD_TEL_HINT ?
+			RTE_TEL_STRING_VAL : RTE_TEL_U64_VAL);
+	}
+
+	rte_mcfg_tailq_read_lock();
+	if (shm == NULL && init_shared_mem() < 0) {
+		rte_mcfg_tailq_read_unlock();
+		goto out;
+	}
+
+	mbuf_dynfield_list = RTE_TAILQ_CAST(
+		mbuf_dynfield_tailq.head, mbuf_dynfield_list);
+	TAILQ_FOREACH(te, mbuf_dynfield_list, next) {
+		dynfield = (struct mbuf_dynfield_elt *)te->data;
+		rte_tel_data_add_array_string(attr[DYNFIELD_TEL_NAME],
+				dynfield->params.name);
+		rte_tel_data_add_array_u64(attr[DYNFIELD_TEL_OFFSET],
+				dynfield->offset);
+		rte_tel_data_add_array_u64(attr[DYNFIELD_TEL_SIZE],
+				dynfield->params.size);
+		rte_tel_data_add_array_u64(attr[DYNFIELD_TEL_ALIGN],
+				dynfield->params.align);
+		rte_tel_data_add_array_u64(attr[DYNFIELD_TEL_CACHE_LINE],
+				dynfield->offset / RTE_CACHE_LINE_SIZE);
+		rte_tel_data_add_array_string(attr[DYNFIELD_TEL_HINT],
+				dynfield_hint_str(dynfield->params.flags));
+	}
+	rte_mcfg_tailq_read_unlock();
+
+	rte_tel_data_start_dict(d);
+	for (i = 0; i < DYNFIELD_TEL_MAX; i++) {
+		rte_tel_data_add_dict_container(d, dynfield_tel_names[i],
+				attr[i], 0);
+		attr[i] = NULL;
+	}
+	ret = 0;
+out:
+	for (i = 0; i < DYNFIELD_TEL_MAX; i++)
+		rte_tel_data_free(attr[i]);
+	return ret;
+}
+
+static int
+mbuf_dyn_handle_flags(const char *cmd __rte_unused,
+		const char *params __rte_unused, struct rte_tel_data *d)
+{
+	struct mbuf_dynflag_list *mbuf_dynflag_list;
+	struct mbuf_dynflag_elt *dynflag;
+	struct rte_tailq_entry *te;
+
+	rte_mcfg_tailq_read_lock();
+	if (shm == NULL && init_shared_mem() < 0) {
+		rte_mcfg_tailq_read_unlock();
+		return -1;
+	}
+
+	rte_tel_data_start_dict(d);
+	mbuf_dynflag_list = RTE_TAILQ_CAST(
+		mbuf_dynflag_tailq.head, mbuf_dynflag_list);
+	TAILQ_FOREACH(te, mbuf_dynflag_list, next) {
+		dynflag = (struct mbuf_dynflag_elt *)te->data;
+		rte_tel_data_add_dict_u64(d, dynflag->params.name,
+				dynflag->bitnum);
+	}
+	rte_mcfg_tailq_read_unlock();
+
+	return 0;
+}
+
+/* Number of free bytes in each cache line of the mbuf */
+static int
+mbuf_dyn_handle_free(const char *cmd __rte_unused,
+		const char *params __rte_unused, struct rte_tel_data *d)
+{
+	uint64_t free_bytes;
+	size_t i;
+
+	rte_mcfg_tailq_read_lock();
+	if (shm == NULL && init_shared_mem() < 0) {
+		rte_mcfg_tailq_read_unlock();
+		return -1;
+	}
+
+	rte_tel_data_start_array(d, RTE_TEL_U64_VAL);
+	free_bytes = 0;
+	for (i = 0; i < sizeof(struct rte_mbuf); i++) {
+		if (shm->free_space[i])
+			free_bytes++;
+		if ((i + 1) % RTE_CACHE_LINE_SIZE == 0 ||
+				i + 1 == sizeof(struct rte_mbuf)) {
+			rte_tel_data_add_array_u64(d, free_bytes);
+			free_bytes = 0;
+		}
+	}
+	rte_mcfg_tailq_read_unlock();
+
+	return 0;
+}
+
+RTE_INIT(mbuf_dyn_init_telemetry)
+{
+	rte_telemetry_register_cmd("/mbuf/dynfield", mbuf_dyn_handle_fields,
+			"Returns the mbuf dynamic fields. Takes no parameters");
+	rte_telemetry_register_cmd("/mbuf/dynflag", mbuf_dyn_handle_flags,
+			"Returns the mbuf dynamic flags. Takes no parameters");
+	rte_telemetry_register_cmd("/mbuf/dynfield_free", mbuf_dyn_handle_free,
+			"Returns the free bytes in each mbuf cache line. Takes no parameters");
+}
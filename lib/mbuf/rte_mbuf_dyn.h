@@ -27,6 +27,13 @@
  * selected in priority. Else, a specific field offset or flag bit
  * number can be requested through the API.
  *
+ * The automatic placement of a field can be guided by a hint: a field
+ * accessed on each packet (RTE_MBUF_DYNFIELD_F_HOT) is placed in the
+ * lowest mbuf cache line with enough room, ideally the first one, and a
+ * rarely accessed field (RTE_MBUF_DYNFIELD_F_COLD) is kept out of the
+ * first cache line, leaving its room to the hot fields. The dynamic flags
+ * are all stored in ol_flags, in the first cache line.
+ *
  * The typical use case is when a specific offload feature requires to
  * register a dedicated offload field in the mbuf structure, and adding
  * a static field or flag is not justified.
@@ -88,9 +95,21 @@ struct rte_mbuf_dynfield {
 	char name[RTE_MBUF_DYN_NAMESIZE]; /**< Name of the field. */
 	size_t size;        /**< The number of bytes to reserve. */
 	size_t align;       /**< The alignment constraint (power of 2). */
-	unsigned int flags; /**< Reserved for future use, must be 0. */
+	unsigned int flags; /**< RTE_MBUF_DYNFIELD_F_* placement hints. */
 };
 
+/**
+ * Placement hint of a dynamic field accessed on each packet: place it in
+ * the lowest mbuf cache line with enough room.
+ */
+#define RTE_MBUF_DYNFIELD_F_HOT (1U << 0)
+
+/**
+ * Placement hint of a rarely accessed dynamic field: keep it out of the
+ * first mbuf cache line when possible.
+ */
+#define RTE_MBUF_DYNFIELD_F_COLD (1U << 1)
+
 /**
  * Structure describing the parameters of a mbuf dynamic flag.
  */
@@ -103,7 +122,7 @@ struct rte_mbuf_dynflag {
  * Register space for a dynamic field in the mbuf structure.
  *
  * If the field is already registered (same name and parameters), its
- * offset is returned.
+ * offset is returned. The placement hints are not compared.
  *
  * @param params
  *   A structure containing the requested parameters (name, size,
@@ -276,6 +295,13 @@ typedef uint64_t rte_mbuf_timestamp_t;
  */
 #define RTE_MBUF_DYNFLAG_RX_TIMESTAMP_NAME "rte_dynflag_rx_timestamp"
 
+/**
+ * The reorder sequence number dynamic field is a 32-bit counter, used by
+ * the reorder library to restore the order of packets. It may also be set
+ * on receive, e.g. by the event Ethernet Rx adapter.
+ */
+#define RTE_MBUF_DYNFIELD_REORDER_SEQN_NAME "rte_reorder_seqn_dynfield"
+
 /**
  * @warning
  * @b EXPERIMENTAL: this API may change without prior notice.
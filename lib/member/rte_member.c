@@ -15,6 +15,8 @@
 #include "rte_member.h"
 #include "rte_member_ht.h"
 #include "rte_member_vbf.h"
+#include "rte_member_cf.h"
+#include "rte_member_sketch.h"
 
 TAILQ_HEAD(rte_member_list, rte_tailq_entry);
 static struct rte_tailq_elem rte_member_tailq = {
@@ -74,6 +76,12 @@ rte_member_free(struct rte_member_setsum *setsum)
 	case RTE_MEMBER_TYPE_VBF:
 		rte_member_free_vbf(setsum);
 		break;
+	case RTE_MEMBER_TYPE_CF:
+		rte_member_free_cf(setsum);
+		break;
+	case RTE_MEMBER_TYPE_SKETCH:
+		rte_member_free_sketch(setsum);
+		break;
 	default:
 		break;
 	}
@@ -147,6 +155,12 @@ rte_member_create(const struct rte_member_parameters *params)
 	case RTE_MEMBER_TYPE_VBF:
 		ret = rte_member_create_vbf(setsum, params);
 		break;
+	case RTE_MEMBER_TYPE_CF:
+		ret = rte_member_create_cf(setsum, params);
+		break;
+	case RTE_MEMBER_TYPE_SKETCH:
+		ret = rte_member_create_sketch(setsum, params);
+		break;
 	default:
 		goto error_unlock_exit;
 	}
@@ -180,6 +194,10 @@ rte_member_add(const struct rte_member_setsum *setsum, const void *key,
 		return rte_member_add_ht(setsum, key, set_id);
 	case RTE_MEMBER_TYPE_VBF:
 		return rte_member_add_vbf(setsum, key, set_id);
+	case RTE_MEMBER_TYPE_CF:
+		return rte_member_add_cf(setsum, key, set_id);
+	case RTE_MEMBER_TYPE_SKETCH:
+		return rte_member_add_sketch(setsum, key, 1);
 	default:
 		return -EINVAL;
 	}
@@ -197,6 +215,8 @@ rte_member_lookup(const struct rte_member_setsum *setsum, const void *key,
 		return rte_member_lookup_ht(setsum, key, set_id);
 	case RTE_MEMBER_TYPE_VBF:
 		return rte_member_lookup_vbf(setsum, key, set_id);
+	case RTE_MEMBER_TYPE_CF:
+		return rte_member_lookup_cf(setsum, key, set_id);
 	default:
 		return -EINVAL;
 	}
@@ -217,6 +237,9 @@ rte_member_lookup_bulk(const struct rte_member_setsum *setsum,
 	case RTE_MEMBER_TYPE_VBF:
 		return rte_member_lookup_bulk_vbf(setsum, keys, num_keys,
 				set_ids);
+	case RTE_MEMBER_TYPE_CF:
+		return rte_member_lookup_bulk_cf(setsum, keys, num_keys,
+				set_ids);
 	default:
 		return -EINVAL;
 	}
@@ -236,6 +259,9 @@ rte_member_lookup_multi(const struct rte_member_setsum *setsum, const void *key,
 	case RTE_MEMBER_TYPE_VBF:
 		return rte_member_lookup_multi_vbf(setsum, key, match_per_key,
 				set_id);
+	case RTE_MEMBER_TYPE_CF:
+		return rte_member_lookup_multi_cf(setsum, key, match_per_key,
+				set_id);
 	default:
 		return -EINVAL;
 	}
@@ -258,6 +284,9 @@ rte_member_lookup_multi_bulk(const struct rte_member_setsum *setsum,
 	case RTE_MEMBER_TYPE_VBF:
 		return rte_member_lookup_multi_bulk_vbf(setsum, keys, num_keys,
 				max_match_per_key, match_count, set_ids);
+	case RTE_MEMBER_TYPE_CF:
+		return rte_member_lookup_multi_bulk_cf(setsum, keys, num_keys,
+				max_match_per_key, match_count, set_ids);
 	default:
 		return -EINVAL;
 	}
@@ -273,7 +302,12 @@ rte_member_delete(const struct rte_member_setsum *setsum, const void *key,
 	switch (setsum->type) {
 	case RTE_MEMBER_TYPE_HT:
 		return rte_member_delete_ht(setsum, key, set_id);
-	/* current vBF implementation does not support delete function */
+	case RTE_MEMBER_TYPE_CF:
+		return rte_member_delete_cf(setsum, key, set_id);
+	/*
+	 * current vBF implementation does not support delete function,
+	 * nor does the sketch
+	 */
 	case RTE_MEMBER_TYPE_VBF:
 	default:
 		return -EINVAL;
@@ -292,9 +326,103 @@ rte_member_reset(const struct rte_member_setsum *setsum)
 	case RTE_MEMBER_TYPE_VBF:
 		rte_member_reset_vbf(setsum);
 		return;
+	case RTE_MEMBER_TYPE_CF:
+		rte_member_reset_cf(setsum);
+		return;
+	case RTE_MEMBER_TYPE_SKETCH:
+		rte_member_reset_sketch(setsum);
+		return;
 	default:
 		return;
 	}
 }
 
+int
+rte_member_add_byte_count(const struct rte_member_setsum *setsum,
+			const void *key, uint32_t count)
+{
+	if (setsum == NULL || key == NULL ||
+			setsum->type != RTE_MEMBER_TYPE_SKETCH)
+		return -EINVAL;
+
+	return rte_member_add_sketch(setsum, key, count);
+}
+
+int
+rte_member_add_byte_count_bulk(const struct rte_member_setsum *setsum,
+			const void **keys, const uint32_t *counts,
+			uint32_t num_keys)
+{
+	if (setsum == NULL || keys == NULL || counts == NULL ||
+			setsum->type != RTE_MEMBER_TYPE_SKETCH)
+		return -EINVAL;
+
+	return rte_member_add_bulk_sketch(setsum, keys, counts, num_keys);
+}
+
+int
+rte_member_query_count(const struct rte_member_setsum *setsum,
+			const void *key, uint64_t *count)
+{
+	if (setsum == NULL || key == NULL || count == NULL ||
+			setsum->type != RTE_MEMBER_TYPE_SKETCH)
+		return -EINVAL;
+
+	return rte_member_query_sketch(setsum, key, count);
+}
+
+static int
+check_merged_sketches(const struct rte_member_setsum **setsums,
+			uint32_t num_setsums)
+{
+	uint32_t i;
+
+	if (setsums == NULL || num_setsums == 0)
+		return -EINVAL;
+
+	for (i = 0; i < num_setsums; i++) {
+		if (setsums[i] == NULL ||
+				setsums[i]->type != RTE_MEMBER_TYPE_SKETCH ||
+				setsums[i]->key_len != setsums[0]->key_len)
+			return -EINVAL;
+	}
+
+	return 0;
+}
+
+int
+rte_member_query_count_merged(const struct rte_member_setsum **setsums,
+			uint32_t num_setsums, const void *key, uint64_t *count)
+{
+	if (key == NULL || count == NULL ||
+			check_merged_sketches(setsums, num_setsums) != 0)
+		return -EINVAL;
+
+	return rte_member_query_merged_sketch(setsums, num_setsums, key,
+			count);
+}
+
+int
+rte_member_report_heavyhitter(const struct rte_member_setsum *setsum,
+			void *keys, uint64_t *counts)
+{
+	if (setsum == NULL || keys == NULL || counts == NULL ||
+			setsum->type != RTE_MEMBER_TYPE_SKETCH)
+		return -EINVAL;
+
+	return rte_member_report_heavyhitter_sketch(setsum, keys, counts);
+}
+
+int
+rte_member_report_heavyhitter_merged(const struct rte_member_setsum **setsums,
+			uint32_t num_setsums, void *keys, uint64_t *counts)
+{
+	if (keys == NULL || counts == NULL ||
+			check_merged_sketches(setsums, num_setsums) != 0)
+		return -EINVAL;
+
+	return rte_member_report_heavyhitter_merged_sketch(setsums,
+			num_setsums, keys, counts);
+}
+
 RTE_LOG_REGISTER_DEFAULT(librte_member_logtype, DEBUG);
@@ -10,11 +10,13 @@
  * The Membership Library is an extension and generalization of a traditional
  * filter (for example Bloom Filter and cuckoo filter) structure that has
  * multiple usages in a variety of workloads and applications. The library is
- * used to test if a key belongs to certain sets. Two types of such
- * "set-summary" structures are implemented: hash-table based (HT) and vector
- * bloom filter (vBF). For HT setsummary, two subtypes or modes are available,
- * cache and non-cache modes. The table below summarize some properties of
- * the different implementations.
+ * used to test if a key belongs to certain sets. Three types of such
+ * "set-summary" structures are implemented: hash-table based (HT), vector
+ * bloom filter (vBF) and cuckoo filter (CF). For HT setsummary, two subtypes
+ * or modes are available, cache and non-cache modes. The table below
+ * summarize some properties of the different implementations.
+ * A fourth type, the sketch, does not summarize sets but estimates the
+ * number of occurrences of keys, and reports the most frequent ones.
  *
  * @warning
  * @b EXPERIMENTAL: this API may change without prior notice
@@ -39,6 +41,17 @@
  * |          |                     | not overwrite  |                         |
  * |          |                     | existing key.  |                         |
  * +----------+---------------------+----------------+-------------------------+
+ * +==========+===============================================================+
+ * |   type   |      CF                                                       |
+ * +==========+===============================================================+
+ * |structure |  cuckoo filter, 2-byte entries of fingerprint and set id      |
+ * +----------+---------------------------------------------------------------+
+ * |set id    |  [1, num_set], num_set up to 255                              |
+ * +----------+---------------------------------------------------------------+
+ * |usages &  |  can delete, half the memory of non-cache HT, false positive  |
+ * |properties|  rate depends on the number of fingerprint bits left by the   |
+ * |          |  set ids, no false negative.                                  |
+ * +----------+---------------------------------------------------------------+
  * -->
  */
 
@@ -52,6 +65,7 @@ extern "C" {
 #include <stdint.h>
 
 #include <rte_common.h>
+#include <rte_compat.h>
 #include <rte_config.h>
 
 /** The set ID type that stored internally in hash table based set summary. */
@@ -66,6 +80,8 @@ typedef uint16_t member_set_t;
 #define RTE_MEMBER_BUCKET_ENTRIES 16
 /** Maximum number of characters in setsum name. */
 #define RTE_MEMBER_NAMESIZE 32
+/** Maximum number of heavy hitters reported by a sketch setsum. */
+#define RTE_MEMBER_SKETCH_MAX_TOPK 1024
 
 /** @internal Hash function used by membership library. */
 #if defined(RTE_ARCH_X86) || defined(__ARM_FEATURE_CRC32)
@@ -105,6 +121,8 @@ struct rte_member_parameters;
 enum rte_member_setsum_type {
 	RTE_MEMBER_TYPE_HT = 0,  /**< Hash table based set summary. */
 	RTE_MEMBER_TYPE_VBF,     /**< Vector of bloom filters. */
+	RTE_MEMBER_TYPE_CF,      /**< Cuckoo filter. */
+	RTE_MEMBER_TYPE_SKETCH,  /**< Count-min sketch. */
 	RTE_MEMBER_NUM_TYPE
 };
 
@@ -138,6 +156,15 @@ struct rte_member_setsum {
 	uint32_t mul_shift;  /* vbf internal variable used during bit test. */
 	uint32_t div_shift;  /* vbf internal variable used during bit test. */
 
+	/* Cuckoo filter, also using the hash table based fields. */
+	uint32_t set_bits;	/* Number of bits of set id in entries. */
+
+	/* Count-min sketch. */
+	uint32_t num_row;	/* Number of rows (hash functions). */
+	uint32_t num_col;	/* Number of counters of each row. */
+	uint32_t col_mask;	/* Bit mask to get counter location in row. */
+	uint32_t top_k;		/* Number of heavy hitters tracked. */
+
 	void *table;	/* This is the handler of hash table or vBF array. */
 
 
@@ -167,6 +194,12 @@ struct rte_member_parameters {
 	 *
 	 * vBF setsummary is a vector of bloom filters. It is used when number
 	 * of sets is not big (less than 32 for current implementation).
+	 *
+	 * CF setsummary is a cuckoo filter. It is like the non-cache HT
+	 * setsummary with half the memory, for up to 255 sets.
+	 *
+	 * Sketch setsummary is a count-min sketch. It estimates the count
+	 * of each key added, and keeps track of the heaviest keys.
 	 */
 	enum rte_member_setsum_type type;
 
@@ -200,6 +233,10 @@ struct rte_member_parameters {
 	 * likely to become full before the number of inserted keys equal to the
 	 * total number of entries.
 	 *
+	 * For CF, num_keys is the number of entries of the table too. Keys
+	 * are moved to their alternative buckets like cuckoo hash, so the
+	 * table gets full when nearly all the entries are used.
+	 *
 	 * For vBF, num_keys equal to the expected number of keys that will
 	 * be inserted into the vBF. The implementation assumes the keys are
 	 * evenly distributed to each BF in vBF. This is used to calculate the
@@ -216,7 +253,11 @@ struct rte_member_parameters {
 	uint32_t key_len;
 
 	/**
-	 * num_set is only used for vBF, but not used for HT setsummary.
+	 * num_set is only used for vBF and CF, but not used for HT setsummary.
+	 *
+	 * For CF, num_set is the highest set id. The set id and the
+	 * fingerprint of the key share the 16 bits of an entry, so the
+	 * fewer sets, the lower the false positive rate.
 	 *
 	 * num_set is equal to the number of BFs in vBF. For current
 	 * implementation, it only supports 1,2,4,8,16,32 BFs in one vBF set
@@ -244,6 +285,13 @@ struct rte_member_parameters {
 	 * to number of entries (num_keys) divided by entry count per bucket
 	 * (RTE_MEMBER_BUCKET_ENTRIES). Thus, the false_positive_rate is not
 	 * directly set by users for HT mode.
+	 * For CF, it is in the order of 2 * RTE_MEMBER_CF_BUCKET_ENTRIES / 2^f,
+	 * where f is the number of fingerprint bits, 16 minus the number of
+	 * bits of num_set.
+	 *
+	 * For sketch, it is the probability that the estimated count of a key
+	 * exceeds its actual count by more than error_rate times the total
+	 * count. It sets the number of rows of the sketch.
 	 */
 	float false_positive_rate;
 
@@ -263,6 +311,24 @@ struct rte_member_parameters {
 	uint32_t sec_hash_seed;
 
 	int socket_id;			/**< NUMA Socket ID for memory. */
+
+	/**
+	 * error_rate is only used for sketch.
+	 *
+	 * The estimated count of a key exceeds its actual count by at most
+	 * error_rate times the total count of all the keys added, with
+	 * probability 1 - false_positive_rate. It sets the number of
+	 * counters of each row of the sketch.
+	 */
+	float error_rate;
+
+	/**
+	 * top_k is only used for sketch.
+	 *
+	 * Number of heaviest keys tracked for heavy hitter reporting, up to
+	 * RTE_MEMBER_SKETCH_MAX_TOPK. Zero disables the tracking.
+	 */
+	uint32_t top_k;
 };
 
 /**
@@ -418,8 +484,10 @@ rte_member_lookup_multi_bulk(const struct rte_member_setsum *setsum,
  *   supports different set_id ranges. 0 cannot be used as set_id since
  *   RTE_MEMBER_NO_MATCH by default is set as 0.
  *   For HT mode, the set_id has range as [1, 0x7FFF], MSB is reserved.
- *   For vBF mode the set id is limited by the num_set parameter when create
- *   the set-summary.
+ *   For vBF and CF modes the set id is limited by the num_set parameter when
+ *   create the set-summary.
+ *   For sketch mode, the set_id is ignored and the count of the key is
+ *   incremented.
  * @return
  *   HT (cache mode) and vBF should never fail unless the set_id is not in the
  *   valid range. In such case -EINVAL is returned.
@@ -428,9 +496,9 @@ rte_member_lookup_multi_bulk(const struct rte_member_setsum *setsum,
  *   For success it returns different values for different modes to provide
  *   extra information for users.
  *   Return 0 for HT (cache mode) if the add does not cause
- *   eviction, return 1 otherwise. Return 0 for non-cache mode if success,
- *   -ENOSPC for full, and 1 if cuckoo eviction happens.
- *   Always returns 0 for vBF mode.
+ *   eviction, return 1 otherwise. Return 0 for non-cache mode and CF if
+ *   success, -ENOSPC for full, and 1 if cuckoo eviction happens.
+ *   Always returns 0 for vBF and sketch modes.
  */
 int
 rte_member_add(const struct rte_member_setsum *setsum, const void *key,
@@ -473,7 +541,7 @@ rte_member_reset(const struct rte_member_setsum *setsum);
  * @param key
  *   Pointer of the key to be deleted.
  * @param set_id
- *   For HT mode, we need both key and its corresponding set_id to
+ *   For HT and CF modes, we need both key and its corresponding set_id to
  *   properly delete the key. Without set_id, we may delete other keys with the
  *   same signature.
  * @return
@@ -483,6 +551,153 @@ int
 rte_member_delete(const struct rte_member_setsum *setsum, const void *key,
 			member_set_t set_id);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Add a count to a key of a sketch set-summary, for instance the number of
+ * bytes of a packet of a flow. rte_member_add() adds a count of 1.
+ *
+ * @param setsum
+ *   Pointer of a sketch set-summary.
+ * @param key
+ *   Pointer of the key to be counted.
+ * @param count
+ *   Count added to the key.
+ * @return
+ *   0 on success, -EINVAL if the set-summary is not a sketch.
+ */
+__rte_experimental
+int
+rte_member_add_byte_count(const struct rte_member_setsum *setsum,
+		const void *key, uint32_t count);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Add counts to a burst of keys of a sketch set-summary. This is the
+ * equivalent of calling rte_member_add_byte_count() for each key, but the
+ * hashes of the keys are computed and the counters prefetched ahead of the
+ * updates.
+ *
+ * A sketch set-summary is not thread safe. For multiple writers, one
+ * sketch may be created per lcore, with the same key_len, and the sketches
+ * read together with rte_member_query_count_merged() and
+ * rte_member_report_heavyhitter_merged().
+ *
+ * @param setsum
+ *   Pointer of a sketch set-summary.
+ * @param keys
+ *   Pointer of the bulk of keys to be counted.
+ * @param counts
+ *   Count added to each key.
+ * @param num_keys
+ *   Number of keys.
+ * @return
+ *   0 on success, -EINVAL if the set-summary is not a sketch.
+ */
+__rte_experimental
+int
+rte_member_add_byte_count_bulk(const struct rte_member_setsum *setsum,
+		const void **keys, const uint32_t *counts, uint32_t num_keys);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Estimate the count of a key of a sketch set-summary. The estimate is never
+ * below the actual count.
+ *
+ * @param setsum
+ *   Pointer of a sketch set-summary.
+ * @param key
+ *   Pointer of the key to be looked up.
+ * @param count
+ *   Output the estimated count of the key.
+ * @return
+ *   0 on success, -EINVAL if the set-summary is not a sketch.
+ */
+__rte_experimental
+int
+rte_member_query_count(const struct rte_member_setsum *setsum,
+		const void *key, uint64_t *count);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Estimate the total count of a key over several sketch set-summaries,
+ * for instance the per lcore sketches of a same traffic. The estimate is
+ * never below the actual total count.
+ *
+ * @param setsums
+ *   Array of pointers of sketch set-summaries, all with the same key_len.
+ * @param num_setsums
+ *   Number of set-summaries.
+ * @param key
+ *   Pointer of the key to be looked up.
+ * @param count
+ *   Output the estimated total count of the key.
+ * @return
+ *   0 on success, -EINVAL if the set-summaries are not compatible sketches.
+ */
+__rte_experimental
+int
+rte_member_query_count_merged(const struct rte_member_setsum **setsums,
+		uint32_t num_setsums, const void *key, uint64_t *count);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Report the heavy hitters of a sketch set-summary: the top_k keys with the
+ * highest estimated counts, by decreasing count.
+ *
+ * @param setsum
+ *   Pointer of a sketch set-summary.
+ * @param keys
+ *   Output the keys one after the other. User should preallocate
+ *   top_k * key_len bytes.
+ * @param counts
+ *   Output the estimated count of each key. User should preallocate
+ *   an array of top_k counts.
+ * @return
+ *   The number of keys reported, -EINVAL if the set-summary is not a sketch.
+ */
+__rte_experimental
+int
+rte_member_report_heavyhitter(const struct rte_member_setsum *setsum,
+		void *keys, uint64_t *counts);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Report the heavy hitters over several sketch set-summaries: the top_k
+ * keys, among the heavy hitters of each set-summary, with the highest
+ * estimated total counts, by decreasing count. top_k is the one of the
+ * first set-summary.
+ *
+ * @param setsums
+ *   Array of pointers of sketch set-summaries, all with the same key_len.
+ * @param num_setsums
+ *   Number of set-summaries.
+ * @param keys
+ *   Output the keys one after the other. User should preallocate
+ *   top_k * key_len bytes.
+ * @param counts
+ *   Output the estimated total count of each key. User should preallocate
+ *   an array of top_k counts.
+ * @return
+ *   The number of keys reported, -EINVAL if the set-summaries are not
+ *   compatible sketches.
+ */
+__rte_experimental
+int
+rte_member_report_heavyhitter_merged(const struct rte_member_setsum **setsums,
+		uint32_t num_setsums, void *keys, uint64_t *counts);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,401 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <string.h>
+
+#include <rte_errno.h>
+#include <rte_malloc.h>
+#include <rte_prefetch.h>
+#include <rte_random.h>
+#include <rte_log.h>
+#include <rte_vect.h>
+
+#include "rte_member.h"
+#include "rte_member_cf.h"
+
+#if defined(RTE_ARCH_X86)
+#include "rte_member_cf_x86.h"
+#endif
+
+/* Multiplier spreading the fingerprint bits over the bucket index bits */
+#define MEMBER_CF_ALT_MULT 0x5bd1e995
+
+/*
+ * The cuckoo filter is like the non-cache HT setsummary, with entries half
+ * the size: the fingerprint and the set id share a 2-byte entry. The fewer
+ * sets, the more fingerprint bits. Buckets are 16 bytes, so that the
+ * primary and secondary buckets of a key are compared with one 256-bit
+ * compare.
+ */
+int
+rte_member_create_cf(struct rte_member_setsum *ss,
+		const struct rte_member_parameters *params)
+{
+	uint32_t num_entries = rte_align32pow2(params->num_keys);
+	struct member_cf_bucket *buckets;
+	uint32_t num_buckets;
+
+	if ((num_entries > RTE_MEMBER_ENTRIES_MAX) ||
+			num_entries < RTE_MEMBER_CF_BUCKET_ENTRIES ||
+			params->num_set == 0 ||
+			params->num_set > RTE_MEMBER_CF_MAX_SET) {
+		rte_errno = EINVAL;
+		RTE_MEMBER_LOG(ERR,
+			"Membership CF create with invalid parameters\n");
+		return -EINVAL;
+	}
+
+	num_buckets = num_entries / RTE_MEMBER_CF_BUCKET_ENTRIES;
+
+	buckets = rte_zmalloc_socket(NULL,
+			num_buckets * sizeof(struct member_cf_bucket),
+			RTE_CACHE_LINE_SIZE, ss->socket_id);
+	if (buckets == NULL) {
+		RTE_MEMBER_LOG(ERR, "memory allocation failed for CF "
+						"setsummary\n");
+		return -ENOMEM;
+	}
+
+	ss->table = buckets;
+	ss->bucket_cnt = num_buckets;
+	ss->bucket_mask = num_buckets - 1;
+	ss->set_bits = rte_fls_u32(params->num_set);
+
+#if defined(RTE_ARCH_X86)
+	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX2) &&
+			rte_vect_get_max_simd_bitwidth() >= RTE_VECT_SIMD_256)
+		ss->sig_cmp_fn = RTE_MEMBER_COMPARE_AVX2;
+	else
+#endif
+		ss->sig_cmp_fn = RTE_MEMBER_COMPARE_SCALAR;
+
+	RTE_MEMBER_LOG(DEBUG, "Cuckoo filter created, "
+			"the table has %u entries, %u buckets, "
+			"%u bit fingerprints\n",
+			num_entries, num_buckets,
+			(uint32_t)(sizeof(member_cf_ent_t) * 8 - ss->set_bits));
+	return 0;
+}
+
+static inline member_cf_ent_t
+get_fp_mask(const struct rte_member_setsum *ss)
+{
+	return (member_cf_ent_t)(UINT16_MAX << ss->set_bits);
+}
+
+static inline member_set_t
+get_ent_set(const struct rte_member_setsum *ss, member_cf_ent_t ent)
+{
+	return ent & ((1U << ss->set_bits) - 1);
+}
+
+/*
+ * The alternative bucket is derived from the current bucket and the
+ * fingerprint only, as in the partial-key cuckoo hashing of the non-cache
+ * HT setsummary, so that entries are moved without the key.
+ */
+static inline uint32_t
+get_alt_bucket(const struct rte_member_setsum *ss, uint32_t bkt_idx,
+		member_cf_ent_t ent)
+{
+	uint32_t fp = ent >> ss->set_bits;
+
+	return (bkt_idx ^ (fp * MEMBER_CF_ALT_MULT)) & ss->bucket_mask;
+}
+
+static inline void
+get_buckets_index(const struct rte_member_setsum *ss, const void *key,
+		uint32_t *prim_bkt, uint32_t *sec_bkt, member_cf_ent_t *fp_ent)
+{
+	uint32_t first_hash = MEMBER_HASH_FUNC(key, ss->key_len,
+						ss->prim_hash_seed);
+	uint32_t sec_hash = MEMBER_HASH_FUNC(&first_hash, sizeof(uint32_t),
+						ss->sec_hash_seed);
+
+	*fp_ent = (member_cf_ent_t)(first_hash << ss->set_bits);
+	*prim_bkt = sec_hash & ss->bucket_mask;
+	*sec_bkt = get_alt_bucket(ss, *prim_bkt, *fp_ent);
+}
+
+/*
+ * Search both buckets for entries with the fingerprint.
+ * Return a mask with bits 2 * i and 2 * i + 1 set if entry i matches,
+ * the entries of the secondary bucket following those of the primary one.
+ */
+static inline uint32_t
+search_buckets(const struct rte_member_setsum *ss,
+		const struct member_cf_bucket *prim,
+		const struct member_cf_bucket *sec, member_cf_ent_t fp_ent)
+{
+	member_cf_ent_t fp_mask = get_fp_mask(ss);
+	uint32_t hitmask = 0;
+	uint32_t i;
+
+	switch (ss->sig_cmp_fn) {
+#if defined(RTE_ARCH_X86) && defined(__AVX2__)
+	case RTE_MEMBER_COMPARE_AVX2:
+		return search_buckets_avx(prim, sec, fp_ent, fp_mask);
+#endif
+	default:
+		for (i = 0; i < RTE_MEMBER_CF_BUCKET_ENTRIES; i++) {
+			if (prim->ents[i] != 0 &&
+					(prim->ents[i] & fp_mask) == fp_ent)
+				hitmask |= 3U << (i << 1);
+			if (sec->ents[i] != 0 &&
+					(sec->ents[i] & fp_mask) == fp_ent)
+				hitmask |= 3U << ((i +
+					RTE_MEMBER_CF_BUCKET_ENTRIES) << 1);
+		}
+		return hitmask;
+	}
+}
+
+static inline member_cf_ent_t *
+get_hit_ent(struct member_cf_bucket *prim, struct member_cf_bucket *sec,
+		uint32_t hitmask)
+{
+	uint32_t hit_idx = __builtin_ctz(hitmask) >> 1;
+
+	if (hit_idx < RTE_MEMBER_CF_BUCKET_ENTRIES)
+		return &prim->ents[hit_idx];
+	return &sec->ents[hit_idx - RTE_MEMBER_CF_BUCKET_ENTRIES];
+}
+
+static inline int
+search_single(const struct rte_member_setsum *ss, uint32_t prim_bkt,
+		uint32_t sec_bkt, member_cf_ent_t fp_ent, member_set_t *set_id)
+{
+	struct member_cf_bucket *buckets = ss->table;
+	uint32_t hitmask = search_buckets(ss, &buckets[prim_bkt],
+			&buckets[sec_bkt], fp_ent);
+
+	if (hitmask) {
+		*set_id = get_ent_set(ss, *get_hit_ent(&buckets[prim_bkt],
+			&buckets[sec_bkt], hitmask));
+		return 1;
+	}
+	*set_id = RTE_MEMBER_NO_MATCH;
+	return 0;
+}
+
+static inline uint32_t
+search_multi(const struct rte_member_setsum *ss, uint32_t prim_bkt,
+		uint32_t sec_bkt, member_cf_ent_t fp_ent,
+		uint32_t match_per_key, member_set_t *set_id)
+{
+	struct member_cf_bucket *buckets = ss->table;
+	uint32_t hitmask = search_buckets(ss, &buckets[prim_bkt],
+			&buckets[sec_bkt], fp_ent);
+	uint32_t counter = 0;
+
+	while (hitmask && counter < match_per_key) {
+		set_id[counter++] = get_ent_set(ss,
+			*get_hit_ent(&buckets[prim_bkt], &buckets[sec_bkt],
+			hitmask));
+		hitmask &= hitmask - 1;
+		hitmask &= hitmask - 1;
+	}
+	return counter;
+}
+
+int
+rte_member_lookup_cf(const struct rte_member_setsum *ss,
+		const void *key, member_set_t *set_id)
+{
+	uint32_t prim_bucket, sec_bucket;
+	member_cf_ent_t fp_ent;
+
+	get_buckets_index(ss, key, &prim_bucket, &sec_bucket, &fp_ent);
+
+	return search_single(ss, prim_bucket, sec_bucket, fp_ent, set_id);
+}
+
+uint32_t
+rte_member_lookup_bulk_cf(const struct rte_member_setsum *ss,
+		const void **keys, uint32_t num_keys, member_set_t *set_ids)
+{
+	uint32_t i;
+	uint32_t num_matches = 0;
+	struct member_cf_bucket *buckets = ss->table;
+	member_cf_ent_t fp_ents[RTE_MEMBER_LOOKUP_BULK_MAX];
+	uint32_t prim_buckets[RTE_MEMBER_LOOKUP_BULK_MAX];
+	uint32_t sec_buckets[RTE_MEMBER_LOOKUP_BULK_MAX];
+
+	for (i = 0; i < num_keys; i++) {
+		get_buckets_index(ss, keys[i], &prim_buckets[i],
+				&sec_buckets[i], &fp_ents[i]);
+		rte_prefetch0(&buckets[prim_buckets[i]]);
+		rte_prefetch0(&buckets[sec_buckets[i]]);
+	}
+
+	for (i = 0; i < num_keys; i++)
+		num_matches += search_single(ss, prim_buckets[i],
+				sec_buckets[i], fp_ents[i], &set_ids[i]);
+
+	return num_matches;
+}
+
+uint32_t
+rte_member_lookup_multi_cf(const struct rte_member_setsum *ss,
+		const void *key, uint32_t match_per_key,
+		member_set_t *set_id)
+{
+	uint32_t prim_bucket, sec_bucket;
+	member_cf_ent_t fp_ent;
+
+	get_buckets_index(ss, key, &prim_bucket, &sec_bucket, &fp_ent);
+
+	return search_multi(ss, prim_bucket, sec_bucket, fp_ent,
+			match_per_key, set_id);
+}
+
+uint32_t
+rte_member_lookup_multi_bulk_cf(const struct rte_member_setsum *ss,
+		const void **keys, uint32_t num_keys, uint32_t match_per_key,
+		uint32_t *match_count,
+		member_set_t *set_ids)
+{
+	uint32_t i;
+	uint32_t num_matches = 0;
+	struct member_cf_bucket *buckets = ss->table;
+	member_cf_ent_t fp_ents[RTE_MEMBER_LOOKUP_BULK_MAX];
+	uint32_t prim_buckets[RTE_MEMBER_LOOKUP_BULK_MAX];
+	uint32_t sec_buckets[RTE_MEMBER_LOOKUP_BULK_MAX];
+
+	for (i = 0; i < num_keys; i++) {
+		get_buckets_index(ss, keys[i], &prim_buckets[i],
+				&sec_buckets[i], &fp_ents[i]);
+		rte_prefetch0(&buckets[prim_buckets[i]]);
+		rte_prefetch0(&buckets[sec_buckets[i]]);
+	}
+
+	for (i = 0; i < num_keys; i++) {
+		match_count[i] = search_multi(ss, prim_buckets[i],
+				sec_buckets[i], fp_ents[i], match_per_key,
+				&set_ids[i * match_per_key]);
+		if (match_count[i] != 0)
+			num_matches++;
+	}
+	return num_matches;
+}
+
+static inline int
+try_insert(struct member_cf_bucket *bkt, member_cf_ent_t ent)
+{
+	uint32_t i;
+
+	for (i = 0; i < RTE_MEMBER_CF_BUCKET_ENTRIES; i++) {
+		if (bkt->ents[i] == 0) {
+			bkt->ents[i] = ent;
+			return 0;
+		}
+	}
+	return -1;
+}
+
+/*
+ * Random walk kicking entries to their alternative bucket, until one of them
+ * finds an empty slot. The path is recorded so that the entries are moved
+ * back if the walk fails, leaving the filter unchanged.
+ */
+static inline int
+kick_and_insert(const struct rte_member_setsum *ss, uint32_t bkt_idx,
+		member_cf_ent_t ent)
+{
+	struct member_cf_bucket *buckets = ss->table;
+	uint32_t path_bkt[RTE_MEMBER_CF_MAX_KICKS];
+	uint8_t path_slot[RTE_MEMBER_CF_MAX_KICKS];
+	member_cf_ent_t victim;
+	uint32_t slot;
+	int i;
+
+	for (i = 0; i < RTE_MEMBER_CF_MAX_KICKS; i++) {
+		slot = rte_rand() & (RTE_MEMBER_CF_BUCKET_ENTRIES - 1);
+		victim = buckets[bkt_idx].ents[slot];
+		buckets[bkt_idx].ents[slot] = ent;
+		path_bkt[i] = bkt_idx;
+		path_slot[i] = slot;
+
+		ent = victim;
+		bkt_idx = get_alt_bucket(ss, bkt_idx, ent);
+		if (try_insert(&buckets[bkt_idx], ent) == 0)
+			return 1;
+	}
+
+	/* Undo the kicks, the last victim goes back first */
+	while (--i >= 0) {
+		victim = buckets[path_bkt[i]].ents[path_slot[i]];
+		buckets[path_bkt[i]].ents[path_slot[i]] = ent;
+		ent = victim;
+	}
+	return -ENOSPC;
+}
+
+int
+rte_member_add_cf(const struct rte_member_setsum *ss,
+		const void *key, member_set_t set_id)
+{
+	uint32_t prim_bucket, sec_bucket;
+	member_cf_ent_t fp_ent, ent;
+	struct member_cf_bucket *buckets = ss->table;
+
+	if (set_id == RTE_MEMBER_NO_MATCH || set_id > ss->num_set)
+		return -EINVAL;
+
+	get_buckets_index(ss, key, &prim_bucket, &sec_bucket, &fp_ent);
+	ent = fp_ent | set_id;
+
+	/*
+	 * Like the non-cache HT setsummary, entries with the same fingerprint
+	 * are not updated: two keys with the same fingerprint and buckets
+	 * would otherwise share one entry, and deleting one of them would
+	 * give false negatives for the other.
+	 */
+	if (try_insert(&buckets[prim_bucket], ent) == 0 ||
+			try_insert(&buckets[sec_bucket], ent) == 0)
+		return 0;
+
+	/* Random pick prim or sec for the cuckoo path */
+	return kick_and_insert(ss, (rte_rand() & 1) ? prim_bucket : sec_bucket,
+			ent);
+}
+
+void
+rte_member_free_cf(struct rte_member_setsum *ss)
+{
+	rte_free(ss->table);
+}
+
+int
+rte_member_delete_cf(const struct rte_member_setsum *ss, const void *key,
+		member_set_t set_id)
+{
+	uint32_t prim_bucket, sec_bucket;
+	member_cf_ent_t fp_ent;
+	member_cf_ent_t *ent;
+	struct member_cf_bucket *buckets = ss->table;
+	uint32_t hitmask;
+
+	get_buckets_index(ss, key, &prim_bucket, &sec_bucket, &fp_ent);
+	hitmask = search_buckets(ss, &buckets[prim_bucket],
+			&buckets[sec_bucket], fp_ent);
+
+	while (hitmask) {
+		ent = get_hit_ent(&buckets[prim_bucket], &buckets[sec_bucket],
+				hitmask);
+		if (get_ent_set(ss, *ent) == set_id) {
+			*ent = 0;
+			return 0;
+		}
+		hitmask &= hitmask - 1;
+		hitmask &= hitmask - 1;
+	}
+	return -ENOENT;
+}
+
+void
+rte_member_reset_cf(const struct rte_member_setsum *ss)
+{
+	memset(ss->table, 0, ss->bucket_cnt * sizeof(struct member_cf_bucket));
+}
@@ -0,0 +1,73 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#ifndef _RTE_MEMBER_CF_H_
+#define _RTE_MEMBER_CF_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Entry count per bucket in cuckoo filter mode. */
+#define RTE_MEMBER_CF_BUCKET_ENTRIES 8
+/* Maximum number of sets in cuckoo filter mode. */
+#define RTE_MEMBER_CF_MAX_SET 255
+/* Maximum number of kicks for cuckoo path in cuckoo filter mode. */
+#define RTE_MEMBER_CF_MAX_KICKS 128
+
+/*
+ * A cuckoo filter entry is a 2-byte value holding the fingerprint of the
+ * key in its high bits and the set id in its low bits.
+ * A null entry is empty, since set ids are never null.
+ */
+typedef uint16_t member_cf_ent_t;
+
+/* The bucket struct for cuckoo filter setsum */
+struct member_cf_bucket {
+	member_cf_ent_t ents[RTE_MEMBER_CF_BUCKET_ENTRIES];
+} __rte_aligned(16);
+
+int
+rte_member_create_cf(struct rte_member_setsum *ss,
+		const struct rte_member_parameters *params);
+
+int
+rte_member_lookup_cf(const struct rte_member_setsum *setsum,
+		const void *key, member_set_t *set_id);
+
+uint32_t
+rte_member_lookup_bulk_cf(const struct rte_member_setsum *setsum,
+		const void **keys, uint32_t num_keys,
+		member_set_t *set_ids);
+
+uint32_t
+rte_member_lookup_multi_cf(const struct rte_member_setsum *setsum,
+		const void *key, uint32_t match_per_key,
+		member_set_t *set_id);
+
+uint32_t
+rte_member_lookup_multi_bulk_cf(const struct rte_member_setsum *setsum,
+		const void **keys, uint32_t num_keys, uint32_t match_per_key,
+		uint32_t *match_count,
+		member_set_t *set_ids);
+
+int
+rte_member_add_cf(const struct rte_member_setsum *setsum,
+		const void *key, member_set_t set_id);
+
+void
+rte_member_free_cf(struct rte_member_setsum *setsum);
+
+int
+rte_member_delete_cf(const struct rte_member_setsum *ss, const void *key,
+		member_set_t set_id);
+
+void
+rte_member_reset_cf(const struct rte_member_setsum *setsum);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_MEMBER_CF_H_ */
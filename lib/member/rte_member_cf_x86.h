@@ -0,0 +1,42 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#ifndef _RTE_MEMBER_CF_X86_H_
+#define _RTE_MEMBER_CF_X86_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <x86intrin.h>
+
+#if defined(__AVX2__)
+
+/*
+ * Compare the fingerprint with the entries of both buckets at once:
+ * the primary bucket fills the low lane, the secondary bucket the high lane.
+ * Return a mask with 2 bits set per matching entry.
+ */
+static inline uint32_t
+search_buckets_avx(const struct member_cf_bucket *prim,
+		const struct member_cf_bucket *sec,
+		member_cf_ent_t fp_ent, member_cf_ent_t fp_mask)
+{
+	__m256i ents = _mm256_inserti128_si256(_mm256_castsi128_si256(
+		_mm_load_si128((__m128i const *)prim->ents)),
+		_mm_load_si128((__m128i const *)sec->ents), 1);
+	__m256i hit = _mm256_cmpeq_epi16(
+		_mm256_and_si256(ents, _mm256_set1_epi16(fp_mask)),
+		_mm256_set1_epi16(fp_ent));
+	__m256i empty = _mm256_cmpeq_epi16(ents, _mm256_setzero_si256());
+
+	return _mm256_movemask_epi8(_mm256_andnot_si256(empty, hit));
+}
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_MEMBER_CF_X86_H_ */
@@ -0,0 +1,356 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include <rte_errno.h>
+#include <rte_malloc.h>
+#include <rte_memory.h>
+#include <rte_log.h>
+#include <rte_prefetch.h>
+
+#include "rte_member.h"
+#include "rte_member_sketch.h"
+
+/*
+ * The sketch setsummary is a count-min sketch: each key increments one
+ * counter per row, the column being given by a different hash function for
+ * each row. The estimated count of a key is the lowest of its counters,
+ * which may only exceed the actual count because of the other keys.
+ * With num_col = e / error_rate columns and num_row = ln(1 / probability)
+ * rows, the estimate exceeds the actual count by more than error_rate times
+ * the total count with the given probability.
+ *
+ * The top_k heaviest keys seen are kept aside with their estimated counts,
+ * for heavy hitter detection.
+ */
+int
+rte_member_create_sketch(struct rte_member_setsum *ss,
+		const struct rte_member_parameters *params)
+{
+	struct member_sketch *sketch;
+	size_t size_counters, size_topk;
+	uint32_t num_col, num_row;
+
+	if (params->error_rate <= 0 || params->error_rate >= 1 ||
+			params->false_positive_rate <= 0 ||
+			params->false_positive_rate >= 1 ||
+			params->top_k > RTE_MEMBER_SKETCH_MAX_TOPK) {
+		rte_errno = EINVAL;
+		RTE_MEMBER_LOG(ERR,
+			"Membership sketch create with invalid parameters\n");
+		return -EINVAL;
+	}
+
+	/* We round to power of 2 for performance during update */
+	num_col = ceil(M_E / params->error_rate);
+	if (num_col > RTE_MEMBER_SKETCH_MAX_COL) {
+		rte_errno = EINVAL;
+		RTE_MEMBER_LOG(ERR, "Membership sketch error rate is too small\n");
+		return -EINVAL;
+	}
+	num_col = rte_align32pow2(num_col);
+
+	num_row = ceil(log(1.0 / params->false_positive_rate));
+	num_row = RTE_MIN(RTE_MAX(num_row, 1U),
+			(uint32_t)RTE_MEMBER_SKETCH_MAX_ROW);
+
+	size_counters = (size_t)num_row * num_col * sizeof(uint64_t);
+	size_topk = (size_t)params->top_k * (sizeof(uint32_t) +
+			sizeof(uint64_t) + params->key_len);
+
+	sketch = rte_zmalloc_socket(NULL, RTE_CACHE_LINE_ROUNDUP(
+			sizeof(*sketch)) + size_counters + size_topk,
+			RTE_CACHE_LINE_SIZE, ss->socket_id);
+	if (sketch == NULL) {
+		RTE_MEMBER_LOG(ERR, "memory allocation failed for sketch "
+						"setsummary\n");
+		return -ENOMEM;
+	}
+
+	sketch->counters = (uint64_t *)((uint8_t *)sketch +
+			RTE_CACHE_LINE_ROUNDUP(sizeof(*sketch)));
+	sketch->topk.counts = sketch->counters + (size_t)num_row * num_col;
+	sketch->topk.hashes = (uint32_t *)(sketch->topk.counts +
+			params->top_k);
+	sketch->topk.keys = (uint8_t *)(sketch->topk.hashes + params->top_k);
+
+	ss->table = sketch;
+	ss->num_row = num_row;
+	ss->num_col = num_col;
+	ss->col_mask = num_col - 1;
+	ss->top_k = params->top_k;
+
+	RTE_MEMBER_LOG(DEBUG, "Count-min sketch created, "
+			"with %u rows of %u counters, tracking %u heavy "
+			"hitters\n", num_row, num_col, ss->top_k);
+	return 0;
+}
+
+static void
+topk_update_min(struct member_sketch_topk *topk)
+{
+	uint32_t i;
+
+	topk->min_idx = 0;
+	for (i = 1; i < topk->num; i++) {
+		if (topk->counts[i] < topk->counts[topk->min_idx])
+			topk->min_idx = i;
+	}
+}
+
+/* Track the key if it is one of the top_k heaviest so far */
+static void
+topk_update(const struct rte_member_setsum *ss,
+		struct member_sketch_topk *topk, const void *key,
+		uint32_t hash, uint64_t count)
+{
+	uint32_t i;
+
+	for (i = 0; i < topk->num; i++) {
+		if (topk->hashes[i] == hash && memcmp(key,
+				&topk->keys[i * ss->key_len],
+				ss->key_len) == 0) {
+			topk->counts[i] = count;
+			if (i == topk->min_idx)
+				topk_update_min(topk);
+			return;
+		}
+	}
+
+	if (topk->num < ss->top_k) {
+		i = topk->num++;
+		if (count < topk->counts[topk->min_idx])
+			topk->min_idx = i;
+	} else if (count > topk->counts[topk->min_idx]) {
+		i = topk->min_idx;
+	} else {
+		return;
+	}
+
+	topk->hashes[i] = hash;
+	topk->counts[i] = count;
+	memcpy(&topk->keys[i * ss->key_len], key, ss->key_len);
+	if (i == topk->min_idx)
+		topk_update_min(topk);
+}
+
+static inline void
+sketch_hash(const struct rte_member_setsum *ss, const void *key,
+		uint32_t *h1, uint32_t *h2)
+{
+	*h1 = MEMBER_HASH_FUNC(key, ss->key_len, ss->prim_hash_seed);
+	*h2 = MEMBER_HASH_FUNC(h1, sizeof(uint32_t), ss->sec_hash_seed);
+}
+
+static inline void
+sketch_update(const struct rte_member_setsum *ss, const void *key,
+		uint32_t h1, uint32_t h2, uint32_t count)
+{
+	struct member_sketch *sketch = ss->table;
+	uint64_t *counter = sketch->counters;
+	uint64_t est = UINT64_MAX;
+	uint32_t i;
+
+	for (i = 0; i < ss->num_row; i++, counter += ss->num_col) {
+		uint64_t *c = &counter[(h1 + i * h2) & ss->col_mask];
+
+		*c += count;
+		est = RTE_MIN(est, *c);
+	}
+
+	if (ss->top_k != 0)
+		topk_update(ss, &sketch->topk, key, h1, est);
+}
+
+int
+rte_member_add_sketch(const struct rte_member_setsum *ss,
+		const void *key, uint32_t count)
+{
+	uint32_t h1, h2;
+
+	sketch_hash(ss, key, &h1, &h2);
+	sketch_update(ss, key, h1, h2, count);
+
+	return 0;
+}
+
+/*
+ * Keys are processed by chunks: the hashes of the whole chunk are computed
+ * first, so that the independent CRC computations overlap, then the
+ * counters of all rows are prefetched before being updated.
+ */
+int
+rte_member_add_bulk_sketch(const struct rte_member_setsum *ss,
+		const void **keys, const uint32_t *counts, uint32_t num_keys)
+{
+	const uint64_t *counters = ((struct member_sketch *)ss->table)->counters;
+	uint32_t h1[RTE_MEMBER_LOOKUP_BULK_MAX];
+	uint32_t h2[RTE_MEMBER_LOOKUP_BULK_MAX];
+	uint32_t i, j, n;
+
+	while (num_keys != 0) {
+		n = RTE_MIN(num_keys, (uint32_t)RTE_MEMBER_LOOKUP_BULK_MAX);
+
+		for (i = 0; i < n; i++)
+			sketch_hash(ss, keys[i], &h1[i], &h2[i]);
+
+		for (i = 0; i < n; i++)
+			for (j = 0; j < ss->num_row; j++)
+				rte_prefetch0(&counters[(size_t)j * ss->num_col +
+					((h1[i] + j * h2[i]) & ss->col_mask)]);
+
+		for (i = 0; i < n; i++)
+			sketch_update(ss, keys[i], h1[i], h2[i], counts[i]);
+
+		keys += n;
+		counts += n;
+		num_keys -= n;
+	}
+
+	return 0;
+}
+
+int
+rte_member_query_sketch(const struct rte_member_setsum *ss,
+		const void *key, uint64_t *count)
+{
+	struct member_sketch *sketch = ss->table;
+	const uint64_t *counter = sketch->counters;
+	uint64_t est = UINT64_MAX;
+	uint32_t h1, h2, i;
+
+	sketch_hash(ss, key, &h1, &h2);
+	for (i = 0; i < ss->num_row; i++, counter += ss->num_col)
+		est = RTE_MIN(est, counter[(h1 + i * h2) & ss->col_mask]);
+
+	*count = est;
+	return 0;
+}
+
+/*
+ * The sum of the estimates of the sketches is an upper bound of the
+ * total count, never looser than the estimate of the summed counters.
+ * The sketches do not need to share their sizes nor their seeds.
+ */
+int
+rte_member_query_merged_sketch(const struct rte_member_setsum **setsums,
+		uint32_t num_setsums, const void *key, uint64_t *count)
+{
+	uint64_t est, total = 0;
+	uint32_t i;
+
+	for (i = 0; i < num_setsums; i++) {
+		rte_member_query_sketch(setsums[i], key, &est);
+		total += est;
+	}
+
+	*count = total;
+	return 0;
+}
+
+int
+rte_member_report_heavyhitter_sketch(const struct rte_member_setsum *ss,
+		void *keys, uint64_t *counts)
+{
+	struct member_sketch_topk *topk =
+		&((struct member_sketch *)ss->table)->topk;
+	uint8_t *out = keys;
+	uint32_t i, j;
+
+	/* Insertion sort by decreasing count */
+	for (i = 0; i < topk->num; i++) {
+		for (j = i; j > 0 && counts[j - 1] < topk->counts[i]; j--) {
+			counts[j] = counts[j - 1];
+			memcpy(&out[j * ss->key_len],
+				&out[(j - 1) * ss->key_len], ss->key_len);
+		}
+		counts[j] = topk->counts[i];
+		memcpy(&out[j * ss->key_len], &topk->keys[i * ss->key_len],
+			ss->key_len);
+	}
+
+	return topk->num;
+}
+
+/*
+ * The heavy hitters of the merged sketches are among the union of their
+ * heavy hitters. Each candidate is estimated over all the sketches and
+ * inserted in the sorted output if it is heavy enough.
+ */
+int
+rte_member_report_heavyhitter_merged_sketch(
+		const struct rte_member_setsum **setsums, uint32_t num_setsums,
+		void *keys, uint64_t *counts)
+{
+	uint32_t hashes[RTE_MEMBER_SKETCH_MAX_TOPK];
+	uint32_t key_len = setsums[0]->key_len;
+	uint32_t top_k = setsums[0]->top_k;
+	uint8_t *out = keys;
+	uint32_t num = 0;
+	uint32_t i, j, k;
+
+	if (top_k == 0)
+		return 0;
+
+	for (i = 0; i < num_setsums; i++) {
+		const struct member_sketch_topk *topk =
+			&((struct member_sketch *)setsums[i]->table)->topk;
+
+		for (j = 0; j < topk->num; j++) {
+			const uint8_t *key = &topk->keys[j * key_len];
+			uint32_t hash = MEMBER_HASH_FUNC(key, key_len,
+					setsums[0]->prim_hash_seed);
+			uint64_t count;
+
+			for (k = 0; k < num; k++) {
+				if (hashes[k] == hash && memcmp(key,
+						&out[k * key_len],
+						key_len) == 0)
+					break;
+			}
+			if (k != num)
+				continue;
+
+			rte_member_query_merged_sketch(setsums, num_setsums,
+					key, &count);
+			if (num == top_k) {
+				if (count <= counts[num - 1])
+					continue;
+				num--;
+			}
+
+			for (k = num; k > 0 && counts[k - 1] < count; k--) {
+				hashes[k] = hashes[k - 1];
+				counts[k] = counts[k - 1];
+				memcpy(&out[k * key_len],
+					&out[(k - 1) * key_len], key_len);
+			}
+			hashes[k] = hash;
+			counts[k] = count;
+			memcpy(&out[k * key_len], key, key_len);
+			num++;
+		}
+	}
+
+	return num;
+}
+
+void
+rte_member_free_sketch(struct rte_member_setsum *ss)
+{
+	rte_free(ss->table);
+}
+
+void
+rte_member_reset_sketch(const struct rte_member_setsum *ss)
+{
+	struct member_sketch *sketch = ss->table;
+
+	memset(sketch->counters, 0,
+		(size_t)ss->num_row * ss->num_col * sizeof(uint64_t));
+	sketch->topk.num = 0;
+	sketch->topk.min_idx = 0;
+}
@@ -0,0 +1,71 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#ifndef _RTE_MEMBER_SKETCH_H_
+#define _RTE_MEMBER_SKETCH_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Maximum number of rows (hash functions) of the count-min sketch. */
+#define RTE_MEMBER_SKETCH_MAX_ROW 16
+/* Maximum number of columns of the count-min sketch. */
+#define RTE_MEMBER_SKETCH_MAX_COL (1 << 24)
+
+/* The heavy hitters of a sketch setsum, the keys with the highest counts */
+struct member_sketch_topk {
+	uint32_t num;		/* Current number of heavy hitters. */
+	uint32_t min_idx;	/* Heavy hitter with the lowest count. */
+	uint32_t *hashes;	/* Primary hash of each heavy hitter key. */
+	uint64_t *counts;	/* Estimated count of each heavy hitter. */
+	uint8_t *keys;		/* Copy of each heavy hitter key. */
+};
+
+/* The count-min sketch, num_row rows of num_col counters */
+struct member_sketch {
+	struct member_sketch_topk topk;
+	uint64_t *counters;
+};
+
+int
+rte_member_create_sketch(struct rte_member_setsum *ss,
+		const struct rte_member_parameters *params);
+
+int
+rte_member_add_sketch(const struct rte_member_setsum *setsum,
+		const void *key, uint32_t count);
+
+int
+rte_member_add_bulk_sketch(const struct rte_member_setsum *setsum,
+		const void **keys, const uint32_t *counts, uint32_t num_keys);
+
+int
+rte_member_query_sketch(const struct rte_member_setsum *setsum,
+		const void *key, uint64_t *count);
+
+int
+rte_member_query_merged_sketch(const struct rte_member_setsum **setsums,
+		uint32_t num_setsums, const void *key, uint64_t *count);
+
+int
+rte_member_report_heavyhitter_sketch(const struct rte_member_setsum *setsum,
+		void *keys, uint64_t *counts);
+
+int
+rte_member_report_heavyhitter_merged_sketch(
+		const struct rte_member_setsum **setsums, uint32_t num_setsums,
+		void *keys, uint64_t *counts);
+
+void
+rte_member_free_sketch(struct rte_member_setsum *setsum);
+
+void
+rte_member_reset_sketch(const struct rte_member_setsum *setsum);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_MEMBER_SKETCH_H_ */
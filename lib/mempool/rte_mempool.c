@@ -31,6 +31,7 @@
 #include <rte_spinlock.h>
 #include <rte_tailq.h>
 #include <rte_eal_paging.h>
+#include <rte_telemetry.h>
 
 #include "rte_mempool.h"
 #include "rte_mempool_trace.h"
@@ -777,6 +778,126 @@ rte_mempool_cache_free(struct rte_mempool_cache *cache)
 	rte_free(cache);
 }
 
+/*
+ * Sizing state of an adaptive default cache. The state of all the lcores
+ * follows the private data of the mempool, out of the cache structure
+ * used by the get and put functions.
+ */
+struct mempool_cache_adapt {
+	uint32_t min_size;    /* Lowest size, 0 if the size is fixed */
+	uint32_t max_size;    /* Highest size, 0 if the size is fixed */
+	uint32_t period_left; /* Calls left in the current period */
+	uint32_t period_slow; /* Common pool accesses in the current period */
+	uint32_t low_water;   /* Lowest cache count in the current period */
+} __rte_cache_aligned;
+
+static struct mempool_cache_adapt *
+mempool_cache_adapt_get(const struct rte_mempool *mp, unsigned int lcore_id)
+{
+	struct mempool_cache_adapt *adapt;
+
+	adapt = RTE_PTR_ADD(mp, MEMPOOL_HEADER_SIZE(mp, mp->cache_size) +
+			    mp->private_data_size);
+	return &adapt[lcore_id];
+}
+
+/* Close the sizing period of an adaptive cache and resize it. */
+static void
+mempool_cache_adapt(struct rte_mempool *mp, struct rte_mempool_cache *cache,
+		    struct mempool_cache_adapt *adapt)
+{
+	uint32_t size = cache->size, excess;
+
+	if (adapt->period_slow * RTE_MEMPOOL_CACHE_GROW_RATIO >
+			RTE_MEMPOOL_CACHE_PERIOD) {
+		size = RTE_MIN(size * 2, adapt->max_size);
+		if (size != cache->size)
+			__MEMPOOL_CACHE_STAT_ADD(cache, grows, 1);
+	} else if (adapt->low_water > 1 && size > adapt->min_size) {
+		/*
+		 * The objects at the bottom of the cache were not used
+		 * during the whole period, give half of them back.
+		 */
+		excess = RTE_MIN(RTE_MIN(adapt->low_water, cache->len) / 2,
+				 size - adapt->min_size);
+		if (excess != 0) {
+			rte_mempool_ops_enqueue_bulk(mp, cache->objs, excess);
+			cache->len -= excess;
+			memmove(cache->objs, &cache->objs[excess],
+				sizeof(void *) * cache->len);
+			size -= excess;
+			__MEMPOOL_CACHE_STAT_ADD(cache, shrinks, 1);
+		}
+	}
+	cache->size = size;
+	cache->flushthresh = CALC_CACHE_FLUSHTHRESH(size);
+
+	adapt->period_left = RTE_MEMPOOL_CACHE_PERIOD;
+	adapt->period_slow = 0;
+	adapt->low_water = cache->len;
+}
+
+void
+rte_mempool_cache_account(struct rte_mempool *mp,
+			  struct rte_mempool_cache *cache, uint32_t slow)
+{
+	struct mempool_cache_adapt *adapt;
+	uintptr_t lcore_id;
+
+	/* User-owned caches keep their size */
+	lcore_id = ((uintptr_t)cache - (uintptr_t)mp->local_cache) /
+		sizeof(*cache);
+	if (lcore_id >= RTE_MAX_LCORE)
+		return;
+
+	adapt = mempool_cache_adapt_get(mp, lcore_id);
+	adapt->period_slow += slow;
+	if (cache->len < adapt->low_water)
+		adapt->low_water = cache->len;
+	if (--adapt->period_left == 0)
+		mempool_cache_adapt(mp, cache, adapt);
+}
+
+int
+rte_mempool_cache_adaptive_set(struct rte_mempool *mp, uint32_t min_size,
+			       uint32_t max_size)
+{
+	struct mempool_cache_adapt *adapt;
+	struct rte_mempool_cache *cache;
+	unsigned int lcore_id;
+
+	if (mp == NULL || mp->cache_size == 0)
+		return -EINVAL;
+
+	if ((max_size == 0) != (min_size == 0))
+		return -EINVAL;
+	if (max_size != 0 &&
+	    (min_size > mp->cache_size || max_size < mp->cache_size ||
+	     max_size > RTE_MEMPOOL_CACHE_MAX_SIZE ||
+	     CALC_CACHE_FLUSHTHRESH(max_size) > mp->size))
+		return -EINVAL;
+
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		cache = &mp->local_cache[lcore_id];
+		adapt = mempool_cache_adapt_get(mp, lcore_id);
+		adapt->min_size = min_size;
+		adapt->max_size = max_size;
+		adapt->period_left = RTE_MEMPOOL_CACHE_PERIOD;
+		adapt->period_slow = 0;
+		adapt->low_water = cache->len;
+		/* Objects above the threshold are flushed by the next put */
+		cache->size = mp->cache_size;
+		cache->flushthresh = CALC_CACHE_FLUSHTHRESH(mp->cache_size);
+	}
+
+	if (max_size != 0)
+		mp->flags |= MEMPOOL_F_CACHE_ADAPTIVE;
+	else
+		mp->flags &= ~MEMPOOL_F_CACHE_ADAPTIVE;
+
+	return 0;
+}
+
 /* create an empty mempool */
 struct rte_mempool *
 rte_mempool_create_empty(const char *name, unsigned n, unsigned elt_size,
@@ -850,6 +971,9 @@ rte_mempool_create_empty(const char *name, unsigned n, unsigned elt_size,
 
 	mempool_size = MEMPOOL_HEADER_SIZE(mp, cache_size);
 	mempool_size += private_data_size;
+	if (cache_size != 0)
+		mempool_size += sizeof(struct mempool_cache_adapt) *
+			RTE_MAX_LCORE;
 	mempool_size = RTE_ALIGN_CEIL(mempool_size, RTE_MEMPOOL_ALIGN);
 
 	ret = snprintf(mz_name, sizeof(mz_name), RTE_MEMPOOL_MZ_FORMAT, name);
@@ -895,6 +1019,8 @@ rte_mempool_create_empty(const char *name, unsigned n, unsigned elt_size,
 		for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++)
 			mempool_cache_init(&mp->local_cache[lcore_id],
 					   cache_size);
+		memset(mempool_cache_adapt_get(mp, 0), 0,
+		       sizeof(struct mempool_cache_adapt) * RTE_MAX_LCORE);
 	}
 
 	te->data = mp;
@@ -1013,10 +1139,18 @@ rte_mempool_dump_cache(FILE *f, const struct rte_mempool *mp)
 	if (mp->cache_size == 0)
 		return count;
 
+	if (mp->flags & MEMPOOL_F_CACHE_ADAPTIVE)
+		fprintf(f, "    adaptive cache_size=%"PRIu32"-%"PRIu32"\n",
+			mempool_cache_adapt_get(mp, 0)->min_size,
+			mempool_cache_adapt_get(mp, 0)->max_size);
+
 	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
 		cache_count = mp->local_cache[lcore_id].len;
 		fprintf(f, "    cache_count[%u]=%"PRIu32"\n",
 			lcore_id, cache_count);
+		if (mp->flags & MEMPOOL_F_CACHE_ADAPTIVE)
+			fprintf(f, "    cache_size[%u]=%"PRIu32"\n",
+				lcore_id, mp->local_cache[lcore_id].size);
 		count += cache_count;
 	}
 	fprintf(f, "    total_cache_count=%u\n", count);
@@ -1343,3 +1477,120 @@ void rte_mempool_walk(void (*func)(struct rte_mempool *, void *),
 
 	rte_mcfg_mempool_read_unlock();
 }
+
+static void
+mempool_list_cb(struct rte_mempool *mp, void *arg)
+{
+	struct rte_tel_data *d = (struct rte_tel_data *)arg;
+
+	rte_tel_data_add_array_string(d, mp->name);
+}
+
+static int
+mempool_handle_list(const char *cmd __rte_unused,
+		    const char *params __rte_unused, struct rte_tel_data *d)
+{
+	rte_tel_data_start_array(d, RTE_TEL_STRING_VAL);
+	rte_mempool_walk(mempool_list_cb, d);
+	return 0;
+}
+
+/* Per-lcore statistics, of the lcores which used the cache */
+#define MEMPOOL_CACHE_STAT(name, field) \
+	{ name, offsetof(struct rte_mempool_cache, field), \
+	  sizeof(((struct rte_mempool_cache *)0)->field) }
+
+static const struct {
+	const char *name;
+	size_t offset;
+	size_t size;
+} mempool_cache_stats[] = {
+	MEMPOOL_CACHE_STAT("size", size),
+	MEMPOOL_CACHE_STAT("len", len),
+#ifdef RTE_LIBRTE_MEMPOOL_STATS
+	MEMPOOL_CACHE_STAT("calls", stats.calls),
+	MEMPOOL_CACHE_STAT("misses", stats.misses),
+	MEMPOOL_CACHE_STAT("flushes", stats.flushes),
+	MEMPOOL_CACHE_STAT("grows", stats.grows),
+	MEMPOOL_CACHE_STAT("shrinks", stats.shrinks),
+#endif
+};
+
+static bool
+mempool_cache_used(const struct rte_mempool *mp,
+		   const struct rte_mempool_cache *cache)
+{
+#ifdef RTE_LIBRTE_MEMPOOL_STATS
+	if (cache->stats.calls != 0)
+		return true;
+#endif
+	return cache->len != 0 || cache->size != mp->cache_size;
+}
+
+static int
+mempool_handle_caches(const char *cmd __rte_unused, const char *params,
+		      struct rte_tel_data *d)
+{
+	const struct rte_mempool_cache *cache;
+	struct rte_tel_data *stat;
+	struct rte_mempool *mp;
+	unsigned int lcore_id, i;
+	const void *field;
+	uint64_t val;
+
+	if (params == NULL || strlen(params) == 0)
+		return -1;
+
+	mp = rte_mempool_lookup(params);
+	if (mp == NULL)
+		return -1;
+
+	rte_tel_data_start_dict(d);
+	rte_tel_data_add_dict_string(d, "name", mp->name);
+	rte_tel_data_add_dict_u64(d, "cache_size", mp->cache_size);
+	if (mp->cache_size == 0)
+		return 0;
+	rte_tel_data_add_dict_u64(d, "min_size",
+				  mempool_cache_adapt_get(mp, 0)->min_size);
+	rte_tel_data_add_dict_u64(d, "max_size",
+				  mempool_cache_adapt_get(mp, 0)->max_size);
+
+	stat = rte_tel_data_alloc();
+	if (stat == NULL)
+		return -1;
+	rte_tel_data_start_array(stat, RTE_TEL_INT_VAL);
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++)
+		if (mempool_cache_used(mp, &mp->local_cache[lcore_id]))
+			rte_tel_data_add_array_int(stat, lcore_id);
+	rte_tel_data_add_dict_container(d, "lcore", stat, 0);
+
+	for (i = 0; i < RTE_DIM(mempool_cache_stats); i++) {
+		stat = rte_tel_data_alloc();
+		if (stat == NULL)
+			return -1;
+		rte_tel_data_start_array(stat, RTE_TEL_U64_VAL);
+		for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+			cache = &mp->local_cache[lcore_id];
+			if (!mempool_cache_used(mp, cache))
+				continue;
+			field = RTE_PTR_ADD(cache, mempool_cache_stats[i].offset);
+			if (mempool_cache_stats[i].size == sizeof(uint64_t))
+				val = *(const uint64_t *)field;
+			else
+				val = *(const uint32_t *)field;
+			rte_tel_data_add_array_u64(stat, val);
+		}
+		rte_tel_data_add_dict_container(d, mempool_cache_stats[i].name,
+						stat, 0);
+	}
+
+	return 0;
+}
+
+RTE_INIT(mempool_init_telemetry)
+{
+	rte_telemetry_register_cmd("/mempool/list", mempool_handle_list,
+		"Returns list of available mempools. Takes no parameters");
+	rte_telemetry_register_cmd("/mempool/caches", mempool_handle_caches,
+		"Returns the per-lcore cache statistics of a mempool. Parameters: string mempool name");
+}
@@ -84,6 +84,31 @@ struct rte_mempool_debug_stats {
 } __rte_cache_aligned;
 #endif
 
+/** Number of get and put calls between two evaluations of a cache size. */
+#define RTE_MEMPOOL_CACHE_PERIOD 1024
+
+/**
+ * An adaptive cache grows when more than one call in this many had to
+ * access the common pool during a period.
+ */
+#define RTE_MEMPOOL_CACHE_GROW_RATIO 16
+
+#ifdef RTE_LIBRTE_MEMPOOL_STATS
+/**
+ * @warning
+ * @b EXPERIMENTAL: this structure may change without prior notice
+ *
+ * A structure that stores the statistics of an object cache.
+ */
+struct rte_mempool_cache_stats {
+	uint64_t calls;   /**< Get and put calls using the cache. */
+	uint64_t misses;  /**< Gets not satisfied by the cache alone. */
+	uint64_t flushes; /**< Puts flushing the cache to the common pool. */
+	uint64_t grows;   /**< Size increases of an adaptive cache. */
+	uint64_t shrinks; /**< Size decreases of an adaptive cache. */
+};
+#endif
+
 /**
  * A structure that stores a per-core object cache.
  */
@@ -91,6 +116,9 @@ struct rte_mempool_cache {
 	uint32_t size;	      /**< Size of the cache */
 	uint32_t flushthresh; /**< Threshold before we flush excess elements */
 	uint32_t len;	      /**< Current cache count */
+#ifdef RTE_LIBRTE_MEMPOOL_STATS
+	struct rte_mempool_cache_stats stats; /**< Cache statistics */
+#endif
 	/*
 	 * Cache is allocated to this size to allow it to overflow in certain
 	 * cases to avoid needless emptying of cache.
@@ -263,6 +291,7 @@ struct rte_mempool {
 #define MEMPOOL_F_SC_GET         0x0008 /**< Default get is "single-consumer".*/
 #define MEMPOOL_F_POOL_CREATED   0x0010 /**< Internal: pool is created. */
 #define MEMPOOL_F_NO_IOVA_CONTIG 0x0020 /**< Don't need IOVA contiguous objs. */
+#define MEMPOOL_F_CACHE_ADAPTIVE 0x0040 /**< Internal: caches adapt their size. */
 
 /**
  * @internal When debug is enabled, store some statistics.
@@ -285,6 +314,23 @@ struct rte_mempool {
 #define __MEMPOOL_STAT_ADD(mp, name, n) do {} while(0)
 #endif
 
+/**
+ * @internal Macro to increment a statistic of a mempool cache.
+ * @param cache
+ *   Pointer to the mempool cache.
+ * @param name
+ *   Name of the statistics field to increment in the cache.
+ * @param n
+ *   Number to add to the statistics.
+ */
+#ifdef RTE_LIBRTE_MEMPOOL_STATS
+#define __MEMPOOL_CACHE_STAT_ADD(cache, name, n) do {		\
+		(cache)->stats.name += (n);			\
+	} while (0)
+#else
+#define __MEMPOOL_CACHE_STAT_ADD(cache, name, n) do {} while (0)
+#endif
+
 /**
  * Calculate the size of the mempool header.
  *
@@ -1227,6 +1273,39 @@ rte_mempool_cache_create(uint32_t size, int socket_id);
 void
 rte_mempool_cache_free(struct rte_mempool_cache *cache);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Let the per-lcore default caches of a mempool adapt their size.
+ *
+ * Every RTE_MEMPOOL_CACHE_PERIOD get and put calls, a cache doubles its
+ * size if the common pool was accessed on more than one call in
+ * RTE_MEMPOOL_CACHE_GROW_RATIO. Otherwise, if some objects stayed in the
+ * cache during the whole period, half of them are returned to the common
+ * pool and the size shrinks by as much. The size always stays within
+ * the given bounds.
+ *
+ * This function must not be called while the pool is used by other lcores.
+ *
+ * @param mp
+ *   A pointer to the mempool structure, created with a cache.
+ * @param min_size
+ *   The lowest size of the caches, at most the cache_size given at
+ *   creation time.
+ * @param max_size
+ *   The highest size of the caches, at least the cache_size given at
+ *   creation time. The same limits as for the cache_size apply.
+ *   0 (with min_size 0) restores caches of a fixed cache_size.
+ * @return
+ *   - 0: Success.
+ *   - -EINVAL: The mempool has no cache or the bounds are invalid.
+ */
+__rte_experimental
+int
+rte_mempool_cache_adaptive_set(struct rte_mempool *mp, uint32_t min_size,
+			       uint32_t max_size);
+
 /**
  * Get a pointer to the per-lcore default mempool cache.
  *
@@ -1273,6 +1352,23 @@ rte_mempool_cache_flush(struct rte_mempool_cache *cache,
 	cache->len = 0;
 }
 
+/**
+ * @internal Account a get or put call to a default cache of a mempool
+ * whose caches adapt their size.
+ * Called from the inline get and put functions, so it is part of the
+ * stable ABI.
+ *
+ * @param mp
+ *   A pointer to the mempool structure.
+ * @param cache
+ *   A pointer to the mempool cache structure used by the call.
+ * @param slow
+ *   1 if the call accessed the common pool, 0 otherwise.
+ */
+void
+rte_mempool_cache_account(struct rte_mempool *mp,
+			  struct rte_mempool_cache *cache, uint32_t slow);
+
 /**
  * @internal Put several objects back in the mempool; used internally.
  * @param mp
@@ -1290,6 +1386,7 @@ __mempool_generic_put(struct rte_mempool *mp, void * const *obj_table,
 		      unsigned int n, struct rte_mempool_cache *cache)
 {
 	void **cache_objs;
+	uint32_t slow = 0;
 
 	/* increment stat now, adding in mempool always success */
 	__MEMPOOL_STAT_ADD(mp, put_bulk, 1);
@@ -1314,11 +1411,17 @@ __mempool_generic_put(struct rte_mempool *mp, void * const *obj_table,
 	cache->len += n;
 
 	if (cache->len >= cache->flushthresh) {
+		__MEMPOOL_CACHE_STAT_ADD(cache, flushes, 1);
 		rte_mempool_ops_enqueue_bulk(mp, &cache->objs[cache->size],
 				cache->len - cache->size);
 		cache->len = cache->size;
+		slow = 1;
 	}
 
+	__MEMPOOL_CACHE_STAT_ADD(cache, calls, 1);
+	if (unlikely(mp->flags & MEMPOOL_F_CACHE_ADAPTIVE))
+		rte_mempool_cache_account(mp, cache, slow);
+
 	return;
 
 ring_enqueue:
@@ -1416,6 +1519,7 @@ __mempool_generic_get(struct rte_mempool *mp, void **obj_table,
 {
 	int ret;
 	uint32_t index, len;
+	uint32_t slow = 0;
 	void **cache_objs;
 
 	/* No cache provided or cannot be satisfied from cache */
@@ -1443,6 +1547,8 @@ __mempool_generic_get(struct rte_mempool *mp, void **obj_table,
 		}
 
 		cache->len += req;
+		__MEMPOOL_CACHE_STAT_ADD(cache, misses, 1);
+		slow = 1;
 	}
 
 	/* Now fill in the response ... */
@@ -1451,6 +1557,10 @@ __mempool_generic_get(struct rte_mempool *mp, void **obj_table,
 
 	cache->len -= n;
 
+	__MEMPOOL_CACHE_STAT_ADD(cache, calls, 1);
+	if (unlikely(mp->flags & MEMPOOL_F_CACHE_ADAPTIVE))
+		rte_mempool_cache_account(mp, cache, slow);
+
 	__MEMPOOL_STAT_ADD(mp, get_success_bulk, 1);
 	__MEMPOOL_STAT_ADD(mp, get_success_objs, n);
 
@@ -1458,6 +1568,14 @@ __mempool_generic_get(struct rte_mempool *mp, void **obj_table,
 
 ring_dequeue:
 
+	/* the cache was bypassed, or could not be refilled */
+	if (cache != NULL) {
+		__MEMPOOL_CACHE_STAT_ADD(cache, calls, 1);
+		__MEMPOOL_CACHE_STAT_ADD(cache, misses, 1);
+		if (unlikely(mp->flags & MEMPOOL_F_CACHE_ADAPTIVE))
+			rte_mempool_cache_account(mp, cache, 1);
+	}
+
 	/* get remaining objects from ring */
 	ret = rte_mempool_ops_dequeue_bulk(mp, obj_table, n);
 
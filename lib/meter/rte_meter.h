@@ -24,6 +24,7 @@ extern "C" {
 #include <stdint.h>
 
 #include "rte_compat.h"
+#include "rte_prefetch.h"
 
 /*
  * Application Programmer's Interface (API)
@@ -327,11 +328,248 @@ rte_meter_trtcm_rfc4115_color_aware_check(
 	uint32_t pkt_len,
 	enum rte_color pkt_color);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * srTCM color blind traffic metering of a burst of packets
+ *
+ * Same as rte_meter_srtcm_color_blind_check() applied in order to each
+ * packet of the burst, the run-time context and profile of the meters of the
+ * next packets being prefetched while the current packets are metered. The
+ * same meter may be used by several packets of the burst.
+ *
+ * @param m
+ *    Array of *n_pkts* handles to the srTCM instance of each packet
+ * @param p
+ *    Array of *n_pkts* profiles, each specified at the creation time of
+ *    the srTCM object of the same index
+ * @param time
+ *    Current CPU time stamp (measured in CPU cycles), shared by the burst
+ * @param pkt_len
+ *    Array of *n_pkts* lengths of the IP packets (measured in bytes)
+ * @param colors
+ *    Array of *n_pkts* colors assigned to the packets
+ * @param n_pkts
+ *    Number of packets of the burst
+ */
+__rte_experimental
+static inline void
+rte_meter_srtcm_color_blind_check_bulk(struct rte_meter_srtcm **m,
+	struct rte_meter_srtcm_profile **p,
+	uint64_t time,
+	const uint32_t *pkt_len,
+	enum rte_color *colors,
+	uint32_t n_pkts);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * srTCM color aware traffic metering of a burst of packets
+ *
+ * Same as rte_meter_srtcm_color_aware_check() applied in order to each
+ * packet of the burst, the run-time context and profile of the meters of the
+ * next packets being prefetched while the current packets are metered. The
+ * same meter may be used by several packets of the burst.
+ *
+ * @param m
+ *    Array of *n_pkts* handles to the srTCM instance of each packet
+ * @param p
+ *    Array of *n_pkts* profiles, each specified at the creation time of
+ *    the srTCM object of the same index
+ * @param time
+ *    Current CPU time stamp (measured in CPU cycles), shared by the burst
+ * @param pkt_len
+ *    Array of *n_pkts* lengths of the IP packets (measured in bytes)
+ * @param pkt_color
+ *    Array of *n_pkts* input colors of the IP packets
+ * @param colors
+ *    Array of *n_pkts* colors assigned to the packets, may be the same array
+ *    as *pkt_color*
+ * @param n_pkts
+ *    Number of packets of the burst
+ */
+__rte_experimental
+static inline void
+rte_meter_srtcm_color_aware_check_bulk(struct rte_meter_srtcm **m,
+	struct rte_meter_srtcm_profile **p,
+	uint64_t time,
+	const uint32_t *pkt_len,
+	const enum rte_color *pkt_color,
+	enum rte_color *colors,
+	uint32_t n_pkts);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * trTCM color blind traffic metering of a burst of packets
+ *
+ * Same as rte_meter_trtcm_color_blind_check() applied in order to each
+ * packet of the burst, the run-time context and profile of the meters of the
+ * next packets being prefetched while the current packets are metered. The
+ * same meter may be used by several packets of the burst.
+ *
+ * @param m
+ *    Array of *n_pkts* handles to the trTCM instance of each packet
+ * @param p
+ *    Array of *n_pkts* profiles, each specified at the creation time of
+ *    the trTCM object of the same index
+ * @param time
+ *    Current CPU time stamp (measured in CPU cycles), shared by the burst
+ * @param pkt_len
+ *    Array of *n_pkts* lengths of the IP packets (measured in bytes)
+ * @param colors
+ *    Array of *n_pkts* colors assigned to the packets
+ * @param n_pkts
+ *    Number of packets of the burst
+ */
+__rte_experimental
+static inline void
+rte_meter_trtcm_color_blind_check_bulk(struct rte_meter_trtcm **m,
+	struct rte_meter_trtcm_profile **p,
+	uint64_t time,
+	const uint32_t *pkt_len,
+	enum rte_color *colors,
+	uint32_t n_pkts);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * trTCM color aware traffic metering of a burst of packets
+ *
+ * Same as rte_meter_trtcm_color_aware_check() applied in order to each
+ * packet of the burst, the run-time context and profile of the meters of the
+ * next packets being prefetched while the current packets are metered. The
+ * same meter may be used by several packets of the burst.
+ *
+ * @param m
+ *    Array of *n_pkts* handles to the trTCM instance of each packet
+ * @param p
+ *    Array of *n_pkts* profiles, each specified at the creation time of
+ *    the trTCM object of the same index
+ * @param time
+ *    Current CPU time stamp (measured in CPU cycles), shared by the burst
+ * @param pkt_len
+ *    Array of *n_pkts* lengths of the IP packets (measured in bytes)
+ * @param pkt_color
+ *    Array of *n_pkts* input colors of the IP packets
+ * @param colors
+ *    Array of *n_pkts* colors assigned to the packets, may be the same array
+ *    as *pkt_color*
+ * @param n_pkts
+ *    Number of packets of the burst
+ */
+__rte_experimental
+static inline void
+rte_meter_trtcm_color_aware_check_bulk(struct rte_meter_trtcm **m,
+	struct rte_meter_trtcm_profile **p,
+	uint64_t time,
+	const uint32_t *pkt_len,
+	const enum rte_color *pkt_color,
+	enum rte_color *colors,
+	uint32_t n_pkts);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * trTCM RFC4115 color blind traffic metering of a burst of packets
+ *
+ * Same as rte_meter_trtcm_rfc4115_color_blind_check() applied in order to each
+ * packet of the burst, the run-time context and profile of the meters of the
+ * next packets being prefetched while the current packets are metered. The
+ * same meter may be used by several packets of the burst.
+ *
+ * @param m
+ *    Array of *n_pkts* handles to the trTCM RFC4115 instance of each packet
+ * @param p
+ *    Array of *n_pkts* profiles, each specified at the creation time of
+ *    the trTCM RFC4115 object of the same index
+ * @param time
+ *    Current CPU time stamp (measured in CPU cycles), shared by the burst
+ * @param pkt_len
+ *    Array of *n_pkts* lengths of the IP packets (measured in bytes)
+ * @param colors
+ *    Array of *n_pkts* colors assigned to the packets
+ * @param n_pkts
+ *    Number of packets of the burst
+ */
+__rte_experimental
+static inline void
+rte_meter_trtcm_rfc4115_color_blind_check_bulk(
+	struct rte_meter_trtcm_rfc4115 **m,
+	struct rte_meter_trtcm_rfc4115_profile **p,
+	uint64_t time,
+	const uint32_t *pkt_len,
+	enum rte_color *colors,
+	uint32_t n_pkts);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * trTCM RFC4115 color aware traffic metering of a burst of packets
+ *
+ * Same as rte_meter_trtcm_rfc4115_color_aware_check() applied in order to each
+ * packet of the burst, the run-time context and profile of the meters of the
+ * next packets being prefetched while the current packets are metered. The
+ * same meter may be used by several packets of the burst.
+ *
+ * @param m
+ *    Array of *n_pkts* handles to the trTCM RFC4115 instance of each packet
+ * @param p
+ *    Array of *n_pkts* profiles, each specified at the creation time of
+ *    the trTCM RFC4115 object of the same index
+ * @param time
+ *    Current CPU time stamp (measured in CPU cycles), shared by the burst
+ * @param pkt_len
+ *    Array of *n_pkts* lengths of the IP packets (measured in bytes)
+ * @param pkt_color
+ *    Array of *n_pkts* input colors of the IP packets
+ * @param colors
+ *    Array of *n_pkts* colors assigned to the packets, may be the same array
+ *    as *pkt_color*
+ * @param n_pkts
+ *    Number of packets of the burst
+ */
+__rte_experimental
+static inline void
+rte_meter_trtcm_rfc4115_color_aware_check_bulk(
+	struct rte_meter_trtcm_rfc4115 **m,
+	struct rte_meter_trtcm_rfc4115_profile **p,
+	uint64_t time,
+	const uint32_t *pkt_len,
+	const enum rte_color *pkt_color,
+	enum rte_color *colors,
+	uint32_t n_pkts);
+
 /*
  * Inline implementation of run-time methods
  *
  ***/
 
+/**
+ * Number of packets ahead of the current one whose meter run-time context and
+ * profile are prefetched by the bulk metering functions.
+ */
+#define RTE_METER_BULK_PREFETCH_OFFSET 4
+
+/* Number of bucket update periods elapsed, which saves the 64-bit division
+ * when the bucket was already updated during the current period, as is
+ * usual for the meters that see several packets of a burst.
+ */
+static inline uint64_t
+__rte_meter_n_periods(uint64_t time_diff, uint64_t period)
+{
+	if (time_diff < period)
+		return 0;
+
+	return time_diff / period;
+}
+
 struct rte_meter_srtcm_profile {
 	uint64_t cbs;
 	/**< Upper limit for C token bucket */
@@ -420,7 +658,7 @@ rte_meter_srtcm_color_blind_check(struct rte_meter_srtcm *m,
 
 	/* Bucket update */
 	time_diff = time - m->time;
-	n_periods = time_diff / p->cir_period;
+	n_periods = __rte_meter_n_periods(time_diff, p->cir_period);
 	m->time += n_periods * p->cir_period;
 
 	/* Put the tokens overflowing from tc into te bucket */
@@ -462,7 +700,7 @@ rte_meter_srtcm_color_aware_check(struct rte_meter_srtcm *m,
 
 	/* Bucket update */
 	time_diff = time - m->time;
-	n_periods = time_diff / p->cir_period;
+	n_periods = __rte_meter_n_periods(time_diff, p->cir_period);
 	m->time += n_periods * p->cir_period;
 
 	/* Put the tokens overflowing from tc into te bucket */
@@ -504,8 +742,8 @@ rte_meter_trtcm_color_blind_check(struct rte_meter_trtcm *m,
 	/* Bucket update */
 	time_diff_tc = time - m->time_tc;
 	time_diff_tp = time - m->time_tp;
-	n_periods_tc = time_diff_tc / p->cir_period;
-	n_periods_tp = time_diff_tp / p->pir_period;
+	n_periods_tc = __rte_meter_n_periods(time_diff_tc, p->cir_period);
+	n_periods_tp = __rte_meter_n_periods(time_diff_tp, p->pir_period);
 	m->time_tc += n_periods_tc * p->cir_period;
 	m->time_tp += n_periods_tp * p->pir_period;
 
@@ -547,8 +785,8 @@ rte_meter_trtcm_color_aware_check(struct rte_meter_trtcm *m,
 	/* Bucket update */
 	time_diff_tc = time - m->time_tc;
 	time_diff_tp = time - m->time_tp;
-	n_periods_tc = time_diff_tc / p->cir_period;
-	n_periods_tp = time_diff_tp / p->pir_period;
+	n_periods_tc = __rte_meter_n_periods(time_diff_tc, p->cir_period);
+	n_periods_tp = __rte_meter_n_periods(time_diff_tp, p->pir_period);
 	m->time_tc += n_periods_tc * p->cir_period;
 	m->time_tp += n_periods_tp * p->pir_period;
 
@@ -590,8 +828,8 @@ rte_meter_trtcm_rfc4115_color_blind_check(
 	/* Bucket update */
 	time_diff_tc = time - m->time_tc;
 	time_diff_te = time - m->time_te;
-	n_periods_tc = time_diff_tc / p->cir_period;
-	n_periods_te = time_diff_te / p->eir_period;
+	n_periods_tc = __rte_meter_n_periods(time_diff_tc, p->cir_period);
+	n_periods_te = __rte_meter_n_periods(time_diff_te, p->eir_period);
 	m->time_tc += n_periods_tc * p->cir_period;
 	m->time_te += n_periods_te * p->eir_period;
 
@@ -634,8 +872,8 @@ rte_meter_trtcm_rfc4115_color_aware_check(
 	/* Bucket update */
 	time_diff_tc = time - m->time_tc;
 	time_diff_te = time - m->time_te;
-	n_periods_tc = time_diff_tc / p->cir_period;
-	n_periods_te = time_diff_te / p->eir_period;
+	n_periods_tc = __rte_meter_n_periods(time_diff_tc, p->cir_period);
+	n_periods_te = __rte_meter_n_periods(time_diff_te, p->eir_period);
 	m->time_tc += n_periods_tc * p->cir_period;
 	m->time_te += n_periods_te * p->eir_period;
 
@@ -666,6 +904,172 @@ rte_meter_trtcm_rfc4115_color_aware_check(
 	return RTE_COLOR_RED;
 }
 
+__rte_experimental
+static inline void
+rte_meter_srtcm_color_blind_check_bulk(struct rte_meter_srtcm **m,
+	struct rte_meter_srtcm_profile **p,
+	uint64_t time,
+	const uint32_t *pkt_len,
+	enum rte_color *colors,
+	uint32_t n_pkts)
+{
+	uint32_t i;
+
+	for (i = 0; i < RTE_METER_BULK_PREFETCH_OFFSET && i < n_pkts; i++) {
+		rte_prefetch0(m[i]);
+		rte_prefetch0(p[i]);
+	}
+
+	for (i = 0; i < n_pkts; i++) {
+		if (i + RTE_METER_BULK_PREFETCH_OFFSET < n_pkts) {
+			rte_prefetch0(m[i + RTE_METER_BULK_PREFETCH_OFFSET]);
+			rte_prefetch0(p[i + RTE_METER_BULK_PREFETCH_OFFSET]);
+		}
+
+		colors[i] = rte_meter_srtcm_color_blind_check(
+			m[i], p[i], time, pkt_len[i]);
+	}
+}
+
+__rte_experimental
+static inline void
+rte_meter_srtcm_color_aware_check_bulk(struct rte_meter_srtcm **m,
+	struct rte_meter_srtcm_profile **p,
+	uint64_t time,
+	const uint32_t *pkt_len,
+	const enum rte_color *pkt_color,
+	enum rte_color *colors,
+	uint32_t n_pkts)
+{
+	uint32_t i;
+
+	for (i = 0; i < RTE_METER_BULK_PREFETCH_OFFSET && i < n_pkts; i++) {
+		rte_prefetch0(m[i]);
+		rte_prefetch0(p[i]);
+	}
+
+	for (i = 0; i < n_pkts; i++) {
+		if (i + RTE_METER_BULK_PREFETCH_OFFSET < n_pkts) {
+			rte_prefetch0(m[i + RTE_METER_BULK_PREFETCH_OFFSET]);
+			rte_prefetch0(p[i + RTE_METER_BULK_PREFETCH_OFFSET]);
+		}
+
+		colors[i] = rte_meter_srtcm_color_aware_check(
+			m[i], p[i], time, pkt_len[i], pkt_color[i]);
+	}
+}
+
+__rte_experimental
+static inline void
+rte_meter_trtcm_color_blind_check_bulk(struct rte_meter_trtcm **m,
+	struct rte_meter_trtcm_profile **p,
+	uint64_t time,
+	const uint32_t *pkt_len,
+	enum rte_color *colors,
+	uint32_t n_pkts)
+{
+	uint32_t i;
+
+	for (i = 0; i < RTE_METER_BULK_PREFETCH_OFFSET && i < n_pkts; i++) {
+		rte_prefetch0(m[i]);
+		rte_prefetch0(p[i]);
+	}
+
+	for (i = 0; i < n_pkts; i++) {
+		if (i + RTE_METER_BULK_PREFETCH_OFFSET < n_pkts) {
+			rte_prefetch0(m[i + RTE_METER_BULK_PREFETCH_OFFSET]);
+			rte_prefetch0(p[i + RTE_METER_BULK_PREFETCH_OFFSET]);
+		}
+
+		colors[i] = rte_meter_trtcm_color_blind_check(
+			m[i], p[i], time, pkt_len[i]);
+	}
+}
+
+__rte_experimental
+static inline void
+rte_meter_trtcm_color_aware_check_bulk(struct rte_meter_trtcm **m,
+	struct rte_meter_trtcm_profile **p,
+	uint64_t time,
+	const uint32_t *pkt_len,
+	const enum rte_color *pkt_color,
+	enum rte_color *colors,
+	uint32_t n_pkts)
+{
+	uint32_t i;
+
+	for (i = 0; i < RTE_METER_BULK_PREFETCH_OFFSET && i < n_pkts; i++) {
+		rte_prefetch0(m[i]);
+		rte_prefetch0(p[i]);
+	}
+
+	for (i = 0; i < n_pkts; i++) {
+		if (i + RTE_METER_BULK_PREFETCH_OFFSET < n_pkts) {
+			rte_prefetch0(m[i + RTE_METER_BULK_PREFETCH_OFFSET]);
+			rte_prefetch0(p[i + RTE_METER_BULK_PREFETCH_OFFSET]);
+		}
+
+		colors[i] = rte_meter_trtcm_color_aware_check(
+			m[i], p[i], time, pkt_len[i], pkt_color[i]);
+	}
+}
+
+__rte_experimental
+static inline void
+rte_meter_trtcm_rfc4115_color_blind_check_bulk(
+	struct rte_meter_trtcm_rfc4115 **m,
+	struct rte_meter_trtcm_rfc4115_profile **p,
+	uint64_t time,
+	const uint32_t *pkt_len,
+	enum rte_color *colors,
+	uint32_t n_pkts)
+{
+	uint32_t i;
+
+	for (i = 0; i < RTE_METER_BULK_PREFETCH_OFFSET && i < n_pkts; i++) {
+		rte_prefetch0(m[i]);
+		rte_prefetch0(p[i]);
+	}
+
+	for (i = 0; i < n_pkts; i++) {
+		if (i + RTE_METER_BULK_PREFETCH_OFFSET < n_pkts) {
+			rte_prefetch0(m[i + RTE_METER_BULK_PREFETCH_OFFSET]);
+			rte_prefetch0(p[i + RTE_METER_BULK_PREFETCH_OFFSET]);
+		}
+
+		colors[i] = rte_meter_trtcm_rfc4115_color_blind_check(
+			m[i], p[i], time, pkt_len[i]);
+	}
+}
+
+__rte_experimental
+static inline void
+rte_meter_trtcm_rfc4115_color_aware_check_bulk(
+	struct rte_meter_trtcm_rfc4115 **m,
+	struct rte_meter_trtcm_rfc4115_profile **p,
+	uint64_t time,
+	const uint32_t *pkt_len,
+	const enum rte_color *pkt_color,
+	enum rte_color *colors,
+	uint32_t n_pkts)
+{
+	uint32_t i;
+
+	for (i = 0; i < RTE_METER_BULK_PREFETCH_OFFSET && i < n_pkts; i++) {
+		rte_prefetch0(m[i]);
+		rte_prefetch0(p[i]);
+	}
+
+	for (i = 0; i < n_pkts; i++) {
+		if (i + RTE_METER_BULK_PREFETCH_OFFSET < n_pkts) {
+			rte_prefetch0(m[i + RTE_METER_BULK_PREFETCH_OFFSET]);
+			rte_prefetch0(p[i + RTE_METER_BULK_PREFETCH_OFFSET]);
+		}
+
+		colors[i] = rte_meter_trtcm_rfc4115_color_aware_check(
+			m[i], p[i], time, pkt_len[i], pkt_color[i]);
+	}
+}
 
 #ifdef __cplusplus
 }
@@ -11,12 +11,16 @@
 #include <rte_metrics.h>
 #include <rte_lcore.h>
 #include <rte_memzone.h>
+#include <rte_seqlock.h>
 #include <rte_spinlock.h>
 
 int metrics_initialized;
 
 #define RTE_METRICS_MEMZONE_NAME "RTE_METRICS"
 
+/* Index of the global metric values, after the per port ones */
+#define RTE_METRICS_GLOBAL_IDX RTE_MAX_ETHPORTS
+
 /**
  * Internal stats metadata and value entry.
  *
@@ -25,16 +29,28 @@ int metrics_initialized;
 struct rte_metrics_meta_s {
 	/** Name of metric */
 	char name[RTE_METRICS_MAX_NAME_LEN];
-	/** Current value for metric */
-	uint64_t value[RTE_MAX_ETHPORTS];
-	/** Used for global metrics */
-	uint64_t global_value;
 	/** Index of next root element (zero for none) */
 	uint16_t idx_next_set;
 	/** Index of next metric in set (zero for none) */
 	uint16_t idx_next_stat;
+	/** Number of metrics from this one to the end of its set */
+	uint16_t cnt_left_in_set;
 };
 
+/**
+ * Internal metric values of a port, or the global ones.
+ *
+ * @internal
+ * Each port has its own lock, so that updates of different ports
+ * never contend, and the readers never store to it.
+ */
+struct rte_metrics_values_s {
+	/** Serializes the writers and lets the readers detect them */
+	rte_seqlock_t lock;
+	/** Current value for each metric */
+	uint64_t value[RTE_METRICS_MAX_METRICS];
+} __rte_cache_aligned;
+
 /**
  * Internal stats info structure.
  *
@@ -48,19 +64,51 @@ struct rte_metrics_data_s {
 	 * This value is not valid if cnt_stats is zero.
 	 */
 	uint16_t idx_last_set;
-	/**   Number of metrics. */
+	/**   Number of metrics.
+	 * Stored with release semantics once the new metrics are set up,
+	 * metrics below this count are never modified until deinit.
+	 */
 	uint16_t cnt_stats;
 	/** Metric data memory block. */
 	struct rte_metrics_meta_s metadata[RTE_METRICS_MAX_METRICS];
-	/** Metric data access lock */
+	/** Metric registration lock */
 	rte_spinlock_t lock;
+	/** Metric values of each port, then the global ones. */
+	struct rte_metrics_values_s values[RTE_MAX_ETHPORTS + 1];
 };
 
+/* Metrics memzone data, once found by this process */
+static struct rte_metrics_data_s *metrics_data;
+
+/*
+ * The memzone lookup walks the memzones under the memory config lock,
+ * so avoid doing it on each update.
+ */
+static struct rte_metrics_data_s *
+metrics_get_data(void)
+{
+	const struct rte_memzone *memzone;
+	struct rte_metrics_data_s *stats;
+
+	stats = __atomic_load_n(&metrics_data, __ATOMIC_ACQUIRE);
+	if (stats != NULL)
+		return stats;
+
+	memzone = rte_memzone_lookup(RTE_METRICS_MEMZONE_NAME);
+	if (memzone == NULL)
+		return NULL;
+
+	stats = memzone->addr;
+	__atomic_store_n(&metrics_data, stats, __ATOMIC_RELEASE);
+	return stats;
+}
+
 void
 rte_metrics_init(int socket_id)
 {
 	struct rte_metrics_data_s *stats;
 	const struct rte_memzone *memzone;
+	uint32_t idx;
 
 	if (metrics_initialized)
 		return;
@@ -77,6 +125,8 @@ rte_metrics_init(int socket_id)
 	stats = memzone->addr;
 	memset(stats, 0, sizeof(struct rte_metrics_data_s));
 	rte_spinlock_init(&stats->lock);
+	for (idx = 0; idx != RTE_DIM(stats->values); idx++)
+		rte_seqlock_init(&stats->values[idx].lock);
 	metrics_initialized = 1;
 }
 
@@ -96,6 +146,7 @@ rte_metrics_deinit(void)
 
 	stats = memzone->addr;
 	memset(stats, 0, sizeof(struct rte_metrics_data_s));
+	__atomic_store_n(&metrics_data, NULL, __ATOMIC_RELEASE);
 
 	ret = rte_memzone_free(memzone);
 	if (ret == 0)
@@ -116,9 +167,9 @@ rte_metrics_reg_names(const char * const *names, uint16_t cnt_names)
 {
 	struct rte_metrics_meta_s *entry = NULL;
 	struct rte_metrics_data_s *stats;
-	const struct rte_memzone *memzone;
 	uint16_t idx_name;
 	uint16_t idx_base;
+	uint32_t idx_port;
 
 	/* Some sanity checks */
 	if (cnt_names < 1 || names == NULL)
@@ -127,10 +178,9 @@ rte_metrics_reg_names(const char * const *names, uint16_t cnt_names)
 		if (names[idx_name] == NULL)
 			return -EINVAL;
 
-	memzone = rte_memzone_lookup(RTE_METRICS_MEMZONE_NAME);
-	if (memzone == NULL)
+	stats = metrics_get_data();
+	if (stats == NULL)
 		return -EIO;
-	stats = memzone->addr;
 
 	if (stats->cnt_stats + cnt_names >= RTE_METRICS_MAX_METRICS)
 		return -ENOMEM;
@@ -145,12 +195,19 @@ rte_metrics_reg_names(const char * const *names, uint16_t cnt_names)
 	for (idx_name = 0; idx_name < cnt_names; idx_name++) {
 		entry = &stats->metadata[idx_name + stats->cnt_stats];
 		strlcpy(entry->name, names[idx_name], RTE_METRICS_MAX_NAME_LEN);
-		memset(entry->value, 0, sizeof(entry->value));
 		entry->idx_next_stat = idx_name + stats->cnt_stats + 1;
+		entry->cnt_left_in_set = cnt_names - idx_name;
+		for (idx_port = 0; idx_port != RTE_DIM(stats->values);
+				idx_port++)
+			stats->values[idx_port].value[idx_name +
+				stats->cnt_stats] = 0;
 	}
 	entry->idx_next_stat = 0;
 	entry->idx_next_set = 0;
-	stats->cnt_stats += cnt_names;
+
+	/* publish the new metrics to the lock-less updates and reads */
+	__atomic_store_n(&stats->cnt_stats, stats->cnt_stats + cnt_names,
+		__ATOMIC_RELEASE);
 
 	rte_spinlock_unlock(&stats->lock);
 
@@ -163,18 +220,20 @@ rte_metrics_update_value(int port_id, uint16_t key, const uint64_t value)
 	return rte_metrics_update_values(port_id, key, &value, 1);
 }
 
+/*
+ * The update only takes the lock of the port, concurrent readers
+ * retry instead of blocking the writer.
+ */
 int
 rte_metrics_update_values(int port_id,
 	uint16_t key,
 	const uint64_t *values,
 	uint32_t count)
 {
-	struct rte_metrics_meta_s *entry;
+	struct rte_metrics_values_s *port_values;
 	struct rte_metrics_data_s *stats;
-	const struct rte_memzone *memzone;
-	uint16_t idx_metric;
 	uint16_t idx_value;
-	uint16_t cnt_setsize;
+	uint16_t cnt_stats;
 
 	if (port_id != RTE_METRICS_GLOBAL &&
 			(port_id < 0 || port_id >= RTE_MAX_ETHPORTS))
@@ -183,45 +242,28 @@ rte_metrics_update_values(int port_id,
 	if (values == NULL)
 		return -EINVAL;
 
-	memzone = rte_memzone_lookup(RTE_METRICS_MEMZONE_NAME);
-	if (memzone == NULL)
+	stats = metrics_get_data();
+	if (stats == NULL)
 		return -EIO;
-	stats = memzone->addr;
-
-	rte_spinlock_lock(&stats->lock);
 
-	if (key >= stats->cnt_stats) {
-		rte_spinlock_unlock(&stats->lock);
+	cnt_stats = __atomic_load_n(&stats->cnt_stats, __ATOMIC_ACQUIRE);
+	if (key >= cnt_stats)
 		return -EINVAL;
-	}
-	idx_metric = key;
-	cnt_setsize = 1;
-	while (idx_metric < stats->cnt_stats) {
-		entry = &stats->metadata[idx_metric];
-		if (entry->idx_next_stat == 0)
-			break;
-		cnt_setsize++;
-		idx_metric++;
-	}
+
 	/* Check update does not cross set border */
-	if (count > cnt_setsize) {
-		rte_spinlock_unlock(&stats->lock);
+	if (count > stats->metadata[key].cnt_left_in_set)
 		return -ERANGE;
-	}
 
 	if (port_id == RTE_METRICS_GLOBAL)
-		for (idx_value = 0; idx_value < count; idx_value++) {
-			idx_metric = key + idx_value;
-			stats->metadata[idx_metric].global_value =
-				values[idx_value];
-		}
+		port_values = &stats->values[RTE_METRICS_GLOBAL_IDX];
 	else
-		for (idx_value = 0; idx_value < count; idx_value++) {
-			idx_metric = key + idx_value;
-			stats->metadata[idx_metric].value[port_id] =
-				values[idx_value];
-		}
-	rte_spinlock_unlock(&stats->lock);
+		port_values = &stats->values[port_id];
+
+	rte_seqlock_write_lock(&port_values->lock);
+	for (idx_value = 0; idx_value < count; idx_value++)
+		port_values->value[key + idx_value] = values[idx_value];
+	rte_seqlock_write_unlock(&port_values->lock);
+
 	return 0;
 }
 
@@ -230,15 +272,13 @@ rte_metrics_get_names(struct rte_metric_name *names,
 	uint16_t capacity)
 {
 	struct rte_metrics_data_s *stats;
-	const struct rte_memzone *memzone;
 	uint16_t idx_name;
 	int return_value;
 
-	memzone = rte_memzone_lookup(RTE_METRICS_MEMZONE_NAME);
-	if (memzone == NULL)
+	stats = metrics_get_data();
+	if (stats == NULL)
 		return -EIO;
 
-	stats = memzone->addr;
 	rte_spinlock_lock(&stats->lock);
 	if (names != NULL) {
 		if (capacity < stats->cnt_stats) {
@@ -256,52 +296,45 @@ rte_metrics_get_names(struct rte_metric_name *names,
 	return return_value;
 }
 
+/*
+ * The values of the port are copied without taking any lock,
+ * the copy is done again if it raced with an update.
+ */
 int
 rte_metrics_get_values(int port_id,
 	struct rte_metric_value *values,
 	uint16_t capacity)
 {
-	struct rte_metrics_meta_s *entry;
+	const struct rte_metrics_values_s *port_values;
 	struct rte_metrics_data_s *stats;
-	const struct rte_memzone *memzone;
 	uint16_t idx_name;
-	int return_value;
+	uint16_t cnt_stats;
+	uint32_t sn;
 
 	if (port_id != RTE_METRICS_GLOBAL &&
 			(port_id < 0 || port_id >= RTE_MAX_ETHPORTS))
 		return -EINVAL;
 
-	memzone = rte_memzone_lookup(RTE_METRICS_MEMZONE_NAME);
-	if (memzone == NULL)
+	stats = metrics_get_data();
+	if (stats == NULL)
 		return -EIO;
 
-	stats = memzone->addr;
-	rte_spinlock_lock(&stats->lock);
+	cnt_stats = __atomic_load_n(&stats->cnt_stats, __ATOMIC_ACQUIRE);
+	if (values == NULL || capacity < cnt_stats)
+		return cnt_stats;
 
-	if (values != NULL) {
-		if (capacity < stats->cnt_stats) {
-			return_value = stats->cnt_stats;
-			rte_spinlock_unlock(&stats->lock);
-			return return_value;
+	if (port_id == RTE_METRICS_GLOBAL)
+		port_values = &stats->values[RTE_METRICS_GLOBAL_IDX];
+	else
+		port_values = &stats->values[port_id];
+
+	do {
+		sn = rte_seqlock_read_begin(&port_values->lock);
+		for (idx_name = 0; idx_name < cnt_stats; idx_name++) {
+			values[idx_name].key = idx_name;
+			values[idx_name].value = port_values->value[idx_name];
 		}
-		if (port_id == RTE_METRICS_GLOBAL)
-			for (idx_name = 0;
-					idx_name < stats->cnt_stats;
-					idx_name++) {
-				entry = &stats->metadata[idx_name];
-				values[idx_name].key = idx_name;
-				values[idx_name].value = entry->global_value;
-			}
-		else
-			for (idx_name = 0;
-					idx_name < stats->cnt_stats;
-					idx_name++) {
-				entry = &stats->metadata[idx_name];
-				values[idx_name].key = idx_name;
-				values[idx_name].value = entry->value[port_id];
-			}
-	}
-	return_value = stats->cnt_stats;
-	rte_spinlock_unlock(&stats->lock);
-	return return_value;
+	} while (rte_seqlock_read_retry(&port_values->lock, sn));
+
+	return cnt_stats;
 }
@@ -214,6 +214,10 @@ int rte_metrics_update_value(
  * Updates a metric set. Note that it is an error to try to
  * update across a set boundary.
  *
+ * The values are updated at once: rte_metrics_get_values() never returns
+ * part of them. Updates of different ports do not contend with each other
+ * and are never blocked by the readers.
+ *
  * @param port_id
  *   Port to update metrics for
  * @param key
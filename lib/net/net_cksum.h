@@ -0,0 +1,43 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#ifndef _NET_CKSUM_H_
+#define _NET_CKSUM_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Different implementations of the Internet checksum. They add the words
+ * of a buffer to a sum, and return a sum which can be reduced with
+ * __rte_raw_cksum_reduce(), as __rte_raw_cksum().
+ */
+
+/* Fold a sum of 32-bit words to a 16-bit one's complement sum. */
+static inline uint32_t
+net_cksum_fold64(uint64_t sum)
+{
+	sum = (sum & UINT32_MAX) + (sum >> 32);
+	sum = (sum & UINT32_MAX) + (sum >> 32);
+	sum = (sum & UINT16_MAX) + (sum >> 16);
+	sum = (sum & UINT16_MAX) + (sum >> 16);
+	return sum;
+}
+
+/* AVX2 */
+
+uint32_t
+rte_net_cksum_avx2(const void *buf, size_t len, uint32_t sum);
+
+/* AVX512 */
+
+uint32_t
+rte_net_cksum_avx512(const void *buf, size_t len, uint32_t sum);
+
+/* NEON */
+
+uint32_t
+rte_net_cksum_neon(const void *buf, size_t len, uint32_t sum);
+
+#endif /* _NET_CKSUM_H_ */
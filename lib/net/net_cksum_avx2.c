@@ -0,0 +1,51 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <rte_common.h>
+#include <rte_ip.h>
+
+#include "net_cksum.h"
+
+#include <x86intrin.h>
+
+/*
+ * The buffer is summed as 32-bit words in 64-bit lanes, which cannot
+ * overflow. As 2^16 is 1 modulo 0xffff, folding the sum of the 32-bit
+ * words gives the sum of the 16-bit words.
+ */
+uint32_t
+rte_net_cksum_avx2(const void *buf, size_t len, uint32_t sum)
+{
+	const __m256i mask = _mm256_set1_epi64x(UINT32_MAX);
+	const uint8_t *p = buf;
+	__m256i acc0 = _mm256_setzero_si256();
+	__m256i acc1 = _mm256_setzero_si256();
+	__m256i v0, v1;
+	uint64_t lanes[4];
+	uint64_t s;
+
+	for (; len >= 2 * sizeof(__m256i); len -= 2 * sizeof(__m256i)) {
+		v0 = _mm256_loadu_si256((const __m256i *)p);
+		v1 = _mm256_loadu_si256((const __m256i *)(p + sizeof(__m256i)));
+		acc0 = _mm256_add_epi64(acc0, _mm256_and_si256(v0, mask));
+		acc1 = _mm256_add_epi64(acc1, _mm256_srli_epi64(v0, 32));
+		acc0 = _mm256_add_epi64(acc0, _mm256_and_si256(v1, mask));
+		acc1 = _mm256_add_epi64(acc1, _mm256_srli_epi64(v1, 32));
+		p += 2 * sizeof(__m256i);
+	}
+	if (len >= sizeof(__m256i)) {
+		v0 = _mm256_loadu_si256((const __m256i *)p);
+		acc0 = _mm256_add_epi64(acc0, _mm256_and_si256(v0, mask));
+		acc1 = _mm256_add_epi64(acc1, _mm256_srli_epi64(v0, 32));
+		p += sizeof(__m256i);
+		len -= sizeof(__m256i);
+	}
+
+	_mm256_storeu_si256((__m256i *)lanes, _mm256_add_epi64(acc0, acc1));
+	s = (uint64_t)sum + net_cksum_fold64(lanes[0]) +
+		net_cksum_fold64(lanes[1]) + net_cksum_fold64(lanes[2]) +
+		net_cksum_fold64(lanes[3]);
+
+	return __rte_raw_cksum(p, len, net_cksum_fold64(s));
+}
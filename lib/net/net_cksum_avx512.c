@@ -0,0 +1,48 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <rte_common.h>
+#include <rte_ip.h>
+
+#include "net_cksum.h"
+
+#include <x86intrin.h>
+
+/* Same as the AVX2 implementation, with 512-bit vectors. */
+uint32_t
+rte_net_cksum_avx512(const void *buf, size_t len, uint32_t sum)
+{
+	const __m512i mask = _mm512_set1_epi64(UINT32_MAX);
+	const uint8_t *p = buf;
+	__m512i acc0 = _mm512_setzero_si512();
+	__m512i acc1 = _mm512_setzero_si512();
+	__m512i v0, v1;
+	uint64_t lanes[8];
+	uint64_t s;
+	unsigned int i;
+
+	for (; len >= 2 * sizeof(__m512i); len -= 2 * sizeof(__m512i)) {
+		v0 = _mm512_loadu_si512(p);
+		v1 = _mm512_loadu_si512(p + sizeof(__m512i));
+		acc0 = _mm512_add_epi64(acc0, _mm512_and_si512(v0, mask));
+		acc1 = _mm512_add_epi64(acc1, _mm512_srli_epi64(v0, 32));
+		acc0 = _mm512_add_epi64(acc0, _mm512_and_si512(v1, mask));
+		acc1 = _mm512_add_epi64(acc1, _mm512_srli_epi64(v1, 32));
+		p += 2 * sizeof(__m512i);
+	}
+	if (len >= sizeof(__m512i)) {
+		v0 = _mm512_loadu_si512(p);
+		acc0 = _mm512_add_epi64(acc0, _mm512_and_si512(v0, mask));
+		acc1 = _mm512_add_epi64(acc1, _mm512_srli_epi64(v0, 32));
+		p += sizeof(__m512i);
+		len -= sizeof(__m512i);
+	}
+
+	_mm512_storeu_si512(lanes, _mm512_add_epi64(acc0, acc1));
+	s = sum;
+	for (i = 0; i < RTE_DIM(lanes); i++)
+		s += net_cksum_fold64(lanes[i]);
+
+	return __rte_raw_cksum(p, len, net_cksum_fold64(s));
+}
@@ -0,0 +1,40 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <rte_common.h>
+#include <rte_ip.h>
+#include <rte_vect.h>
+
+#include "net_cksum.h"
+
+/*
+ * The buffer is summed as 32-bit words in 64-bit lanes, with the pairwise
+ * add and accumulate long instruction.
+ */
+uint32_t
+rte_net_cksum_neon(const void *buf, size_t len, uint32_t sum)
+{
+	const uint8_t *p = buf;
+	uint64x2_t acc0 = vdupq_n_u64(0);
+	uint64x2_t acc1 = vdupq_n_u64(0);
+	uint64_t s;
+
+	for (; len >= 4 * sizeof(uint32x4_t); len -= 4 * sizeof(uint32x4_t)) {
+		acc0 = vpadalq_u32(acc0, vreinterpretq_u32_u8(vld1q_u8(p)));
+		acc1 = vpadalq_u32(acc1, vreinterpretq_u32_u8(vld1q_u8(p + 16)));
+		acc0 = vpadalq_u32(acc0, vreinterpretq_u32_u8(vld1q_u8(p + 32)));
+		acc1 = vpadalq_u32(acc1, vreinterpretq_u32_u8(vld1q_u8(p + 48)));
+		p += 4 * sizeof(uint32x4_t);
+	}
+	for (; len >= sizeof(uint32x4_t); len -= sizeof(uint32x4_t)) {
+		acc0 = vpadalq_u32(acc0, vreinterpretq_u32_u8(vld1q_u8(p)));
+		p += sizeof(uint32x4_t);
+	}
+
+	acc0 = vaddq_u64(acc0, acc1);
+	s = (uint64_t)sum + net_cksum_fold64(vgetq_lane_u64(acc0, 0)) +
+		net_cksum_fold64(vgetq_lane_u64(acc0, 1));
+
+	return __rte_raw_cksum(p, len, net_cksum_fold64(s));
+}
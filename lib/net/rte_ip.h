@@ -264,7 +264,7 @@ rte_raw_cksum_mbuf(const struct rte_mbuf *m, uint32_t off, uint32_t len,
 	for (;;) {
 		tmp = __rte_raw_cksum(buf, seglen, 0);
 		if (done & 1)
-			tmp = rte_bswap16((uint16_t)tmp);
+			tmp = rte_bswap16(__rte_raw_cksum_reduce(tmp));
 		sum += tmp;
 		done += seglen;
 		if (done == len)
@@ -280,6 +280,86 @@ rte_raw_cksum_mbuf(const struct rte_mbuf *m, uint32_t off, uint32_t len,
 	return 0;
 }
 
+/**
+ * Update a checksum after the change of a 16-bit word of the checksummed
+ * data, for instance a port rewritten by NAT, as described in RFC 1624.
+ *
+ * The old and new values are taken in the byte order of the packet, as the
+ * checksum.
+ *
+ * @param cksum
+ *   The complemented checksum, as in the header.
+ * @param old_val
+ *   The old value of the word.
+ * @param new_val
+ *   The new value of the word.
+ * @return
+ *   The updated complemented checksum.
+ */
+static inline uint16_t
+rte_cksum_update16(uint16_t cksum, uint16_t old_val, uint16_t new_val)
+{
+	uint32_t sum;
+
+	sum = (uint16_t)~cksum;
+	sum += (uint16_t)~old_val;
+	sum += new_val;
+	return (uint16_t)~__rte_raw_cksum_reduce(sum);
+}
+
+/**
+ * Update a checksum after the change of a 32-bit word of the checksummed
+ * data, for instance an IPv4 address rewritten by NAT.
+ *
+ * @param cksum
+ *   The complemented checksum, as in the header.
+ * @param old_val
+ *   The old value of the word, in the byte order of the packet.
+ * @param new_val
+ *   The new value of the word, in the byte order of the packet.
+ * @return
+ *   The updated complemented checksum.
+ */
+static inline uint16_t
+rte_cksum_update32(uint16_t cksum, uint32_t old_val, uint32_t new_val)
+{
+	uint32_t sum;
+
+	old_val = ~old_val;
+	sum = (uint16_t)~cksum;
+	sum += (old_val >> 16) + (old_val & 0xffff);
+	sum += (new_val >> 16) + (new_val & 0xffff);
+	return (uint16_t)~__rte_raw_cksum_reduce(sum);
+}
+
+/**
+ * Update a checksum after the change of a buffer in the checksummed data,
+ * for instance an IPv6 address rewritten by NAT.
+ *
+ * @param cksum
+ *   The complemented checksum, as in the header.
+ * @param old_buf
+ *   The old content of the buffer.
+ * @param new_buf
+ *   The new content of the buffer.
+ * @param len
+ *   The length of the buffer, which must be even, as its offset in the
+ *   checksummed data.
+ * @return
+ *   The updated complemented checksum.
+ */
+static inline uint16_t
+rte_cksum_update(uint16_t cksum, const void *old_buf, const void *new_buf,
+	size_t len)
+{
+	uint32_t sum;
+
+	sum = (uint16_t)~cksum;
+	sum += (uint16_t)~rte_raw_cksum(old_buf, len);
+	sum += rte_raw_cksum(new_buf, len);
+	return (uint16_t)~__rte_raw_cksum_reduce(sum);
+}
+
 /**
  * Process the IPv4 checksum of an IPv4 header.
  *
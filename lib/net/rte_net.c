@@ -2,11 +2,14 @@
  * Copyright 2016 6WIND S.A.
  */
 
+#include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 
 #include <rte_mbuf.h>
 #include <rte_mbuf_ptype.h>
 #include <rte_byteorder.h>
+#include <rte_prefetch.h>
 #include <rte_ether.h>
 #include <rte_ip.h>
 #include <rte_tcp.h>
@@ -507,3 +510,145 @@ uint32_t rte_net_get_ptype(const struct rte_mbuf *m,
 
 	return pkt_type;
 }
+
+/*
+ * Parse the most common headers, Ethernet with an optional VLAN, IPv4 or
+ * IPv6 without extension, and TCP, UDP or SCTP, when they are in the first
+ * segment. The results are the same as rte_net_get_ptype().
+ * Return false if the packet is not handled.
+ */
+static __rte_always_inline bool
+ptype_parse_fast(struct rte_mbuf *m)
+{
+	const struct rte_ether_hdr *eh;
+	const struct rte_vlan_hdr *vh;
+	const struct rte_ipv4_hdr *ip4h;
+	const struct rte_ipv6_hdr *ip6h;
+	const struct rte_tcp_hdr *th;
+	uint32_t data_len = rte_pktmbuf_data_len(m);
+	uint32_t pkt_type = RTE_PTYPE_L2_ETHER;
+	uint32_t l2_len = sizeof(*eh);
+	uint32_t l3_len, l4_len, l3_type;
+	uint16_t proto;
+	uint8_t l4_proto;
+
+	if (unlikely(data_len < sizeof(*eh) + sizeof(*vh)))
+		return false;
+
+	eh = rte_pktmbuf_mtod(m, const struct rte_ether_hdr *);
+	proto = eh->ether_type;
+	if (proto == rte_cpu_to_be_16(RTE_ETHER_TYPE_VLAN)) {
+		vh = (const struct rte_vlan_hdr *)(eh + 1);
+		pkt_type = RTE_PTYPE_L2_ETHER_VLAN;
+		l2_len += sizeof(*vh);
+		proto = vh->eth_proto;
+	}
+
+	if (proto == rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4)) {
+		if (unlikely(data_len < l2_len + sizeof(*ip4h)))
+			return false;
+		ip4h = rte_pktmbuf_mtod_offset(m, const struct rte_ipv4_hdr *,
+			l2_len);
+		l3_type = ptype_l3_ip(ip4h->version_ihl);
+		if (unlikely(l3_type == 0))
+			return false;
+		pkt_type |= l3_type;
+		l3_len = rte_ipv4_hdr_len(ip4h);
+		if (ip4h->fragment_offset & rte_cpu_to_be_16(
+				RTE_IPV4_HDR_OFFSET_MASK | RTE_IPV4_HDR_MF_FLAG)) {
+			pkt_type |= RTE_PTYPE_L4_FRAG;
+			l4_len = 0;
+			goto done;
+		}
+		l4_proto = ip4h->next_proto_id;
+	} else if (proto == rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV6)) {
+		if (unlikely(data_len < l2_len + sizeof(*ip6h)))
+			return false;
+		ip6h = rte_pktmbuf_mtod_offset(m, const struct rte_ipv6_hdr *,
+			l2_len);
+		l4_proto = ip6h->proto;
+		if (unlikely(ptype_l3_ip6(l4_proto) != RTE_PTYPE_L3_IPV6))
+			return false;
+		pkt_type |= RTE_PTYPE_L3_IPV6;
+		l3_len = sizeof(*ip6h);
+	} else {
+		return false;
+	}
+
+	switch (l4_proto) {
+	case IPPROTO_UDP:
+		pkt_type |= RTE_PTYPE_L4_UDP;
+		l4_len = sizeof(struct rte_udp_hdr);
+		break;
+	case IPPROTO_TCP:
+		if (unlikely(data_len < l2_len + l3_len + sizeof(*th)))
+			return false;
+		th = rte_pktmbuf_mtod_offset(m, const struct rte_tcp_hdr *,
+			l2_len + l3_len);
+		pkt_type |= RTE_PTYPE_L4_TCP;
+		l4_len = (th->data_off & 0xf0) >> 2;
+		break;
+	case IPPROTO_SCTP:
+		pkt_type |= RTE_PTYPE_L4_SCTP;
+		l4_len = sizeof(struct rte_sctp_hdr);
+		break;
+	default:
+		/* tunnels */
+		return false;
+	}
+
+done:
+	m->packet_type = pkt_type;
+	m->l2_len = l2_len;
+	m->l3_len = l3_len;
+	m->l4_len = l4_len;
+	m->outer_l2_len = 0;
+	m->outer_l3_len = 0;
+	return true;
+}
+
+/* Parse any packet, and set its header lengths as for the Tx offloads. */
+static void
+ptype_parse_slow(struct rte_mbuf *m, uint32_t layers)
+{
+	struct rte_net_hdr_lens hdr_lens;
+
+	memset(&hdr_lens, 0, sizeof(hdr_lens));
+	m->packet_type = rte_net_get_ptype(m, &hdr_lens, layers);
+	if (m->packet_type & RTE_PTYPE_TUNNEL_MASK) {
+		m->outer_l2_len = hdr_lens.l2_len;
+		m->outer_l3_len = hdr_lens.l3_len;
+		m->l2_len = hdr_lens.tunnel_len + hdr_lens.inner_l2_len;
+		m->l3_len = hdr_lens.inner_l3_len;
+		m->l4_len = hdr_lens.inner_l4_len;
+	} else {
+		m->outer_l2_len = 0;
+		m->outer_l3_len = 0;
+		m->l2_len = hdr_lens.l2_len;
+		m->l3_len = hdr_lens.l3_len;
+		m->l4_len = hdr_lens.l4_len;
+	}
+}
+
+#define PTYPE_PREFETCH_OFFSET 4
+
+void
+rte_net_get_ptype_bulk(struct rte_mbuf **pkts, uint16_t nb_pkts,
+	uint32_t layers)
+{
+	const uint32_t fast_layers = RTE_PTYPE_L2_MASK | RTE_PTYPE_L3_MASK |
+		RTE_PTYPE_L4_MASK;
+	bool fast = (layers & fast_layers) == fast_layers;
+	uint16_t i;
+
+	for (i = 0; i < RTE_MIN(nb_pkts, PTYPE_PREFETCH_OFFSET); i++)
+		rte_prefetch0(rte_pktmbuf_mtod(pkts[i], void *));
+
+	for (i = 0; i < nb_pkts; i++) {
+		if (i + PTYPE_PREFETCH_OFFSET < nb_pkts)
+			rte_prefetch0(rte_pktmbuf_mtod(
+				pkts[i + PTYPE_PREFETCH_OFFSET], void *));
+		if (!fast || !ptype_parse_fast(pkts[i]))
+			ptype_parse_slow(pkts[i], layers);
+	}
+}
@@ -90,6 +90,35 @@ rte_net_skip_ip6_ext(uint16_t proto, const struct rte_mbuf *m, uint32_t *off,
 uint32_t rte_net_get_ptype(const struct rte_mbuf *m,
 	struct rte_net_hdr_lens *hdr_lens, uint32_t layers);
 
+/**
+ * Parse a burst of Ethernet packets to get their packet types.
+ *
+ * This function gives the same packet types as rte_net_get_ptype(), and
+ * stores them in the packet_type field of the mbufs. It also sets the
+ * l2_len, l3_len, l4_len, outer_l2_len and outer_l3_len fields, as expected
+ * by the Tx offloads: for a tunnel packet, the outer lengths are the ones
+ * of the outer headers, and l2_len includes the tunnel header. A length is
+ * 0 if the associated packet type is not set.
+ *
+ * The common headers, Ethernet with an optional VLAN, IPv4 or IPv6 and TCP,
+ * UDP or SCTP, are parsed in a single pass while the next packets are
+ * prefetched, which is faster than calling rte_net_get_ptype() on each
+ * packet.
+ *
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * @param pkts
+ *   The packet mbufs to be parsed.
+ * @param nb_pkts
+ *   The number of mbufs in pkts.
+ * @param layers
+ *   List of layers to parse, as for rte_net_get_ptype().
+ */
+__rte_experimental
+void rte_net_get_ptype_bulk(struct rte_mbuf **pkts, uint16_t nb_pkts,
+	uint32_t layers);
+
 /**
  * Prepare pseudo header checksum
  *
@@ -0,0 +1,283 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <rte_common.h>
+#include <rte_cpuflags.h>
+#include <rte_log.h>
+#include <rte_net_cksum.h>
+#include <rte_vect.h>
+
+#include "net_cksum.h"
+
+typedef uint32_t
+(*rte_net_cksum_handler)(const void *buf, size_t len, uint32_t sum);
+
+static uint32_t
+rte_net_cksum_default_handler(const void *buf, size_t len, uint32_t sum);
+
+static rte_net_cksum_handler handler = rte_net_cksum_default_handler;
+
+static uint16_t max_simd_bitwidth;
+
+#define NET_LOG(level, fmt, args...)					\
+	rte_log(RTE_LOG_ ## level, libnet_cksum_logtype, "%s(): " fmt "\n", \
+		__func__, ## args)
+
+RTE_LOG_REGISTER_SUFFIX(libnet_cksum_logtype, cksum, INFO);
+
+/* Scalar handling */
+
+/*
+ * Sum the buffer as 32-bit words in a 64-bit sum, which does not
+ * overflow, unlike the 32-bit sum of __rte_raw_cksum() for large buffers.
+ */
+static uint32_t
+rte_net_cksum_scalar(const void *buf, size_t len, uint32_t sum)
+{
+	const uint8_t *p = buf;
+	uint64_t s0 = sum, s1 = 0;
+	uint32_t w0, w1;
+
+	for (; len >= 2 * sizeof(w0); len -= 2 * sizeof(w0)) {
+		memcpy(&w0, p, sizeof(w0));
+		memcpy(&w1, p + sizeof(w0), sizeof(w1));
+		s0 += w0;
+		s1 += w1;
+		p += 2 * sizeof(w0);
+	}
+
+	return __rte_raw_cksum(p, len, net_cksum_fold64(s0 + s1));
+}
+
+/* AVX512 handling */
+
+#define AVX512_CPU_SUPPORTED \
+	rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F)
+
+static rte_net_cksum_handler
+avx512_get_handler(void)
+{
+#ifdef CC_X86_64_AVX512_CKSUM_SUPPORT
+	if (AVX512_CPU_SUPPORTED &&
+			max_simd_bitwidth >= RTE_VECT_SIMD_512)
+		return rte_net_cksum_avx512;
+#endif
+	NET_LOG(INFO, "Requirements not met, can't use AVX512");
+	return NULL;
+}
+
+/* AVX2 handling */
+
+#define AVX2_CPU_SUPPORTED \
+	rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX2)
+
+static rte_net_cksum_handler
+avx2_get_handler(void)
+{
+#ifdef CC_X86_64_AVX2_CKSUM_SUPPORT
+	if (AVX2_CPU_SUPPORTED &&
+			max_simd_bitwidth >= RTE_VECT_SIMD_256)
+		return rte_net_cksum_avx2;
+#endif
+	NET_LOG(INFO, "Requirements not met, can't use AVX2");
+	return NULL;
+}
+
+/* NEON handling */
+
+#define NEON_CPU_SUPPORTED \
+	rte_cpu_get_flag_enabled(RTE_CPUFLAG_NEON)
+
+static rte_net_cksum_handler
+neon_get_handler(void)
+{
+#ifdef CC_ARM64_NEON_CKSUM_SUPPORT
+	if (NEON_CPU_SUPPORTED &&
+			max_simd_bitwidth >= RTE_VECT_SIMD_128)
+		return rte_net_cksum_neon;
+#endif
+	NET_LOG(INFO, "Requirements not met, can't use NEON");
+	return NULL;
+}
+
+/* Default handling */
+
+/*
+ * Select the best algorithm on the first call, as the max SIMD bitwidth
+ * is not known before the EAL initialization.
+ */
+static uint32_t
+rte_net_cksum_default_handler(const void *buf, size_t len, uint32_t sum)
+{
+	rte_net_cksum_handler h;
+
+	if (max_simd_bitwidth == 0)
+		max_simd_bitwidth = rte_vect_get_max_simd_bitwidth();
+
+	h = avx512_get_handler();
+	if (h == NULL)
+		h = avx2_get_handler();
+	if (h == NULL)
+		h = neon_get_handler();
+	if (h == NULL)
+		h = rte_net_cksum_scalar;
+	handler = h;
+	return h(buf, len, sum);
+}
+
+/* Public API */
+
+void
+rte_net_cksum_set_alg(enum rte_net_cksum_alg alg)
+{
+	rte_net_cksum_handler h = NULL;
+
+	if (max_simd_bitwidth == 0)
+		max_simd_bitwidth = rte_vect_get_max_simd_bitwidth();
+
+	switch (alg) {
+	case RTE_NET_CKSUM_AVX512:
+		h = avx512_get_handler();
+		if (h != NULL)
+			break;
+		/* fall-through */
+	case RTE_NET_CKSUM_AVX2:
+		h = avx2_get_handler();
+		break; /* for x86, always break here */
+	case RTE_NET_CKSUM_NEON:
+		h = neon_get_handler();
+		/* fall-through */
+	case RTE_NET_CKSUM_SCALAR:
+		/* fall-through */
+	default:
+		break;
+	}
+
+	if (h == NULL)
+		h = rte_net_cksum_scalar;
+	handler = h;
+}
+
+uint16_t
+rte_net_raw_cksum(const void *buf, size_t len)
+{
+	return __rte_raw_cksum_reduce(handler(buf, len, 0));
+}
+
+int
+rte_net_raw_cksum_mbuf(const struct rte_mbuf *m, uint32_t off, uint32_t len,
+	uint16_t *cksum)
+{
+	const struct rte_mbuf *seg;
+	const char *buf;
+	uint32_t sum, tmp;
+	uint32_t seglen, done;
+
+	if (unlikely(off + len > rte_pktmbuf_pkt_len(m)))
+		return -1;
+
+	/* browse the segments to find offset */
+	seglen = 0;
+	for (seg = m; seg != NULL; seg = seg->next) {
+		seglen = rte_pktmbuf_data_len(seg);
+		if (off < seglen)
+			break;
+		off -= seglen;
+	}
+	if (seg == NULL) {
+		/* only an empty range may start at the end of the packet */
+		*cksum = 0;
+		return len == 0 ? 0 : -1;
+	}
+	seglen -= off;
+	buf = rte_pktmbuf_mtod_offset(seg, const char *, off);
+	if (seglen >= len) {
+		*cksum = rte_net_raw_cksum(buf, len);
+		return 0;
+	}
+
+	/*
+	 * The segment checksums are reduced before being added, so that a
+	 * segment starting at an odd offset is byte swapped entirely.
+	 */
+	sum = 0;
+	done = 0;
+	for (;;) {
+		tmp = __rte_raw_cksum_reduce(handler(buf, seglen, 0));
+		if (done & 1)
+			tmp = rte_bswap16((uint16_t)tmp);
+		sum += tmp;
+		done += seglen;
+		if (done == len)
+			break;
+		seg = seg->next;
+		buf = rte_pktmbuf_mtod(seg, const char *);
+		seglen = rte_pktmbuf_data_len(seg);
+		if (seglen > len - done)
+			seglen = len - done;
+	}
+
+	*cksum = __rte_raw_cksum_reduce(sum);
+	return 0;
+}
+
+uint16_t
+rte_net_ipv4_udptcp_cksum(const struct rte_ipv4_hdr *ipv4_hdr,
+	const void *l4_hdr)
+{
+	uint32_t cksum;
+	uint32_t l3_len, l4_len;
+	uint8_t ip_hdr_len;
+
+	ip_hdr_len = rte_ipv4_hdr_len(ipv4_hdr);
+	l3_len = rte_be_to_cpu_16(ipv4_hdr->total_length);
+	if (l3_len < ip_hdr_len)
+		return 0;
+
+	l4_len = l3_len - ip_hdr_len;
+
+	cksum = rte_net_raw_cksum(l4_hdr, l4_len);
+	cksum += rte_ipv4_phdr_cksum(ipv4_hdr, 0);
+
+	cksum = ((cksum & 0xffff0000) >> 16) + (cksum & 0xffff);
+	cksum = (~cksum) & 0xffff;
+	/*
+	 * Per RFC 768:If the computed checksum is zero for UDP,
+	 * it is transmitted as all ones
+	 * (the equivalent in one's complement arithmetic).
+	 */
+	if (cksum == 0 && ipv4_hdr->next_proto_id == IPPROTO_UDP)
+		cksum = 0xffff;
+
+	return (uint16_t)cksum;
+}
+
+uint16_t
+rte_net_ipv6_udptcp_cksum(const struct rte_ipv6_hdr *ipv6_hdr,
+	const void *l4_hdr)
+{
+	uint32_t cksum;
+	uint32_t l4_len;
+
+	l4_len = rte_be_to_cpu_16(ipv6_hdr->payload_len);
+
+	cksum = rte_net_raw_cksum(l4_hdr, l4_len);
+	cksum += rte_ipv6_phdr_cksum(ipv6_hdr, 0);
+
+	cksum = ((cksum & 0xffff0000) >> 16) + (cksum & 0xffff);
+	cksum = (~cksum) & 0xffff;
+	/*
+	 * Per RFC 768: If the computed checksum is zero for UDP,
+	 * it is transmitted as all ones
+	 * (the equivalent in one's complement arithmetic).
+	 */
+	if (cksum == 0 && ipv6_hdr->proto == IPPROTO_UDP)
+		cksum = 0xffff;
+
+	return (uint16_t)cksum;
+}
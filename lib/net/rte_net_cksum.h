@@ -0,0 +1,132 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#ifndef _RTE_NET_CKSUM_H_
+#define _RTE_NET_CKSUM_H_
+
+/**
+ * @file
+ *
+ * Internet checksum of large buffers, with SIMD implementations selected
+ * at runtime.
+ *
+ * The results are the same as the ones of the inline functions of
+ * rte_ip.h, which are faster for the small buffers like the headers.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <rte_compat.h>
+#include <rte_ip.h>
+#include <rte_mbuf.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Checksum compute algorithm */
+enum rte_net_cksum_alg {
+	RTE_NET_CKSUM_SCALAR = 0,
+	RTE_NET_CKSUM_AVX2,
+	RTE_NET_CKSUM_AVX512,
+	RTE_NET_CKSUM_NEON,
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Set the checksum algorithm. By default, the best one supported by the
+ * CPU and allowed by the max SIMD bitwidth is used. The scalar one is set
+ * if the requested one is not supported.
+ *
+ * @param alg
+ *   The checksum algorithm.
+ */
+__rte_experimental
+void
+rte_net_cksum_set_alg(enum rte_net_cksum_alg alg);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Process the non-complemented checksum of a buffer, as rte_raw_cksum().
+ *
+ * @param buf
+ *   Pointer to the buffer.
+ * @param len
+ *   Length of the buffer.
+ * @return
+ *   The non-complemented checksum.
+ */
+__rte_experimental
+uint16_t
+rte_net_raw_cksum(const void *buf, size_t len);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Compute the raw (non complemented) checksum of a packet, which may be
+ * segmented, as rte_raw_cksum_mbuf().
+ *
+ * @param m
+ *   The pointer to the mbuf.
+ * @param off
+ *   The offset in bytes to start the checksum.
+ * @param len
+ *   The length in bytes of the data to checksum.
+ * @param cksum
+ *   A pointer to the checksum, filled on success.
+ * @return
+ *   0 on success, -1 on error (bad length or offset).
+ */
+__rte_experimental
+int
+rte_net_raw_cksum_mbuf(const struct rte_mbuf *m, uint32_t off, uint32_t len,
+	uint16_t *cksum);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Process the IPv4 UDP or TCP checksum, as rte_ipv4_udptcp_cksum().
+ *
+ * @param ipv4_hdr
+ *   The pointer to the contiguous IPv4 header.
+ * @param l4_hdr
+ *   The pointer to the beginning of the L4 header.
+ * @return
+ *   The complemented checksum to set in the L4 header.
+ */
+__rte_experimental
+uint16_t
+rte_net_ipv4_udptcp_cksum(const struct rte_ipv4_hdr *ipv4_hdr,
+	const void *l4_hdr);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Process the IPv6 UDP or TCP checksum, as rte_ipv6_udptcp_cksum().
+ *
+ * @param ipv6_hdr
+ *   The pointer to the contiguous IPv6 header.
+ * @param l4_hdr
+ *   The pointer to the beginning of the L4 header.
+ * @return
+ *   The complemented checksum to set in the L4 header.
+ */
+__rte_experimental
+uint16_t
+rte_net_ipv6_udptcp_cksum(const struct rte_ipv6_hdr *ipv6_hdr,
+	const void *l4_hdr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_NET_CKSUM_H_ */
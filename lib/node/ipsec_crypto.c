@@ -0,0 +1,276 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2021 Marvell International Ltd.
+ */
+
+#include <rte_cryptodev.h>
+#include <rte_debug.h>
+#include <rte_errno.h>
+#include <rte_ether.h>
+#include <rte_graph.h>
+#include <rte_graph_worker.h>
+#include <rte_ip.h>
+#include <rte_ipsec.h>
+#include <rte_mbuf.h>
+#include <rte_mempool.h>
+
+#include "rte_node_ipsec_api.h"
+
+#include "ipsec_priv.h"
+#include "node_private.h"
+
+#define IPSEC_CRYPTO_NODE_CTX(ctx) ((struct ipsec_crypto_node_ctx *)ctx)
+
+static uint16_t
+ipsec_crypto_enqueue_node_process(struct rte_graph *graph,
+				  struct rte_node *node, void **objs,
+				  uint16_t nb_objs)
+{
+	struct rte_crypto_op *cops[RTE_GRAPH_BURST_SIZE];
+	struct rte_crypto_op *ops[RTE_GRAPH_BURST_SIZE];
+	struct rte_crypto_op *free_cops[RTE_GRAPH_BURST_SIZE];
+	struct rte_mbuf *drops[RTE_GRAPH_BURST_SIZE];
+	struct ipsec_crypto_node_ctx *ctx = IPSEC_CRYPTO_NODE_CTX(node->ctx);
+	struct rte_mbuf **pkts = (struct rte_mbuf **)objs;
+	uint16_t n_left_from = nb_objs, n, i, j, start, cnt, k, sent;
+	uint16_t nb_ops, nb_drops, nb_free;
+	const int dyn = ctx->mbuf_priv1_off;
+	struct rte_ipsec_session *ss;
+
+	while (n_left_from > 0) {
+		n = RTE_MIN(n_left_from, (uint16_t)RTE_GRAPH_BURST_SIZE);
+
+		if (unlikely(rte_crypto_op_bulk_alloc(ctx->cop_pool,
+						      RTE_CRYPTO_OP_TYPE_SYMMETRIC,
+						      cops, n) == 0)) {
+			rte_node_enqueue(graph, node,
+					 IPSEC_CRYPTO_ENQUEUE_NEXT_PKT_DROP,
+					 (void **)pkts, n);
+			goto next;
+		}
+
+		nb_ops = 0;
+		nb_drops = 0;
+		nb_free = 0;
+
+		/* Prepare the packets per run of the same session, the
+		 * packets which failed are moved by lib ipsec to the end of
+		 * the run, their crypto operations are left unused.
+		 */
+		for (start = 0; start < n; start += cnt) {
+			ss = node_mbuf_priv1(pkts[start], dyn)->ss;
+			for (cnt = 1; start + cnt < n; cnt++)
+				if (node_mbuf_priv1(pkts[start + cnt], dyn)->ss !=
+				    ss)
+					break;
+
+			k = rte_ipsec_pkt_crypto_prepare(ss, &pkts[start],
+							 &cops[start], cnt);
+			for (j = 0; j < k; j++)
+				ops[nb_ops++] = cops[start + j];
+			for (; j < cnt; j++) {
+				drops[nb_drops++] = pkts[start + j];
+				free_cops[nb_free++] = cops[start + j];
+			}
+		}
+
+		sent = rte_cryptodev_enqueue_burst(ctx->dev_id, ctx->qp_id,
+						   ops, nb_ops);
+
+		/* Drop the packets of the operations that were not enqueued */
+		for (i = sent; i < nb_ops; i++) {
+			drops[nb_drops++] = ops[i]->sym->m_src;
+			free_cops[nb_free++] = ops[i];
+		}
+
+		if (nb_free)
+			rte_mempool_put_bulk(ctx->cop_pool, (void **)free_cops,
+					     nb_free);
+		if (nb_drops)
+			rte_node_enqueue(graph, node,
+					 IPSEC_CRYPTO_ENQUEUE_NEXT_PKT_DROP,
+					 (void **)drops, nb_drops);
+next:
+		pkts += n;
+		n_left_from -= n;
+	}
+
+	return nb_objs;
+}
+
+/* Next edge of a packet finalized by lib ipsec, from the version of the IP
+ * header it now starts with after its L2 header. The inbound tunnel packets
+ * are stripped of their outer headers, L2 included, so an L2 header is
+ * prepended for the lookup nodes.
+ */
+static __rte_always_inline uint16_t
+ipsec_crypto_dequeue_next_get(struct rte_mbuf *mbuf, bool tun_inb)
+{
+	struct rte_ether_hdr *eth_hdr;
+	const uint8_t *ip_hdr;
+	uint16_t next;
+
+	if (tun_inb) {
+		eth_hdr = (struct rte_ether_hdr *)rte_pktmbuf_prepend(mbuf,
+				sizeof(struct rte_ether_hdr));
+		if (unlikely(eth_hdr == NULL))
+			return IPSEC_CRYPTO_DEQUEUE_NEXT_PKT_DROP;
+		memset(eth_hdr, 0, sizeof(*eth_hdr));
+	} else {
+		eth_hdr = rte_pktmbuf_mtod(mbuf, struct rte_ether_hdr *);
+	}
+
+	ip_hdr = (const uint8_t *)(eth_hdr + 1);
+	if ((ip_hdr[0] >> 4) == IPVERSION) {
+		eth_hdr->ether_type = rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4);
+		mbuf->packet_type = RTE_PTYPE_L3_IPV4;
+		next = IPSEC_CRYPTO_DEQUEUE_NEXT_IP4_LOOKUP;
+	} else {
+		eth_hdr->ether_type = rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV6);
+		mbuf->packet_type = RTE_PTYPE_L3_IPV6;
+		next = IPSEC_CRYPTO_DEQUEUE_NEXT_IP6_LOOKUP;
+	}
+	mbuf->l2_len = sizeof(struct rte_ether_hdr);
+
+	return next;
+}
+
+static uint16_t
+ipsec_crypto_dequeue_node_process(struct rte_graph *graph,
+				  struct rte_node *node, void **objs,
+				  uint16_t nb_objs)
+{
+	struct rte_crypto_op *cops[RTE_GRAPH_BURST_SIZE];
+	struct rte_ipsec_group grp[RTE_GRAPH_BURST_SIZE];
+	struct rte_mbuf *pkts[RTE_GRAPH_BURST_SIZE];
+	uint16_t nexts[RTE_GRAPH_BURST_SIZE];
+	struct ipsec_crypto_node_ctx *ctx = IPSEC_CRYPTO_NODE_CTX(node->ctx);
+	uint16_t n, ng, i, j, k, total = 0;
+	struct rte_ipsec_session *ss;
+	uint64_t sa_type;
+	bool tun_inb;
+
+	RTE_SET_USED(objs);
+	RTE_SET_USED(nb_objs);
+
+	n = rte_cryptodev_dequeue_burst(ctx->dev_id, ctx->qp_id, cops,
+					RTE_GRAPH_BURST_SIZE);
+	if (n == 0)
+		return 0;
+
+	/* Group the packets per session in the order they were enqueued,
+	 * which keeps the bursts of the same SA together.
+	 */
+	ng = rte_ipsec_pkt_crypto_group(
+		(const struct rte_crypto_op **)(uintptr_t)cops,
+		pkts, grp, n);
+	rte_mempool_put_bulk(ctx->cop_pool, (void **)cops, n);
+
+	for (i = 0; i < ng; i++) {
+		ss = grp[i].id.ptr;
+		k = rte_ipsec_pkt_process(ss, grp[i].m, grp[i].cnt);
+		sa_type = rte_ipsec_sa_type(ss->sa);
+		tun_inb = (sa_type & RTE_IPSEC_SATP_DIR_MASK) ==
+				RTE_IPSEC_SATP_DIR_IB &&
+			  (sa_type & RTE_IPSEC_SATP_MODE_MASK) !=
+				RTE_IPSEC_SATP_MODE_TRANS;
+
+		for (j = 0; j < k; j++)
+			nexts[total + j] =
+				ipsec_crypto_dequeue_next_get(grp[i].m[j],
+							      tun_inb);
+		for (; j < grp[i].cnt; j++)
+			nexts[total + j] = IPSEC_CRYPTO_DEQUEUE_NEXT_PKT_DROP;
+
+		total += grp[i].cnt;
+	}
+
+	/* Packets without a session are placed after the last group */
+	for (; total < n; total++)
+		nexts[total] = IPSEC_CRYPTO_DEQUEUE_NEXT_PKT_DROP;
+
+	ipsec_node_enqueue_runs(graph, node, (void **)pkts, nexts, n);
+
+	return n;
+}
+
+static int
+ipsec_crypto_node_init(const struct rte_graph *graph, struct rte_node *node)
+{
+	struct ipsec_crypto_node_ctx *ctx = IPSEC_CRYPTO_NODE_CTX(node->ctx);
+	struct ipsec_node_main *nm = ipsec_node_data_get();
+	struct ipsec_crypto_dev *dev = NULL;
+	uint16_t i;
+
+	RTE_BUILD_BUG_ON(sizeof(struct ipsec_crypto_node_ctx) >
+			 RTE_NODE_CTX_SZ);
+
+	/* Find our crypto device */
+	for (i = 0; i < RTE_CRYPTO_MAX_DEVS; i++) {
+		if (nm->devs[i].enabled &&
+		    (nm->devs[i].enqueue_node == node->id ||
+		     nm->devs[i].dequeue_node == node->id)) {
+			dev = &nm->devs[i];
+			break;
+		}
+	}
+	if (dev == NULL || graph->id >= dev->num_qps)
+		return -EINVAL;
+
+	node_mbuf_priv1_dynfield_offset = rte_mbuf_dynfield_register(
+			&node_mbuf_priv1_dynfield_desc);
+	if (node_mbuf_priv1_dynfield_offset < 0)
+		return -rte_errno;
+
+	ctx->cop_pool = dev->cop_pool;
+	ctx->mbuf_priv1_off = node_mbuf_priv1_dynfield_offset;
+	ctx->qp_id = graph->id;
+	ctx->dev_id = i;
+
+	node_dbg("ipsec", "Crypto node %s, dev=%u qp=%u", node->name,
+		 ctx->dev_id, ctx->qp_id);
+
+	return 0;
+}
+
+static struct rte_node_register ipsec_crypto_enqueue_node_base = {
+	.process = ipsec_crypto_enqueue_node_process,
+	.name = "ipsec_crypto_enqueue",
+
+	.init = ipsec_crypto_node_init,
+
+	.nb_edges = IPSEC_CRYPTO_ENQUEUE_NEXT_MAX,
+	.next_nodes = {
+		[IPSEC_CRYPTO_ENQUEUE_NEXT_PKT_DROP] = "pkt_drop",
+	},
+};
+
+struct rte_node_register *
+ipsec_crypto_enqueue_node_get(void)
+{
+	return &ipsec_crypto_enqueue_node_base;
+}
+
+RTE_NODE_REGISTER(ipsec_crypto_enqueue_node_base);
+
+static struct rte_node_register ipsec_crypto_dequeue_node_base = {
+	.process = ipsec_crypto_dequeue_node_process,
+	.flags = RTE_NODE_SOURCE_F,
+	.name = "ipsec_crypto_dequeue",
+
+	.init = ipsec_crypto_node_init,
+
+	.nb_edges = IPSEC_CRYPTO_DEQUEUE_NEXT_MAX,
+	.next_nodes = {
+		[IPSEC_CRYPTO_DEQUEUE_NEXT_IP4_LOOKUP] = "ip4_lookup",
+		[IPSEC_CRYPTO_DEQUEUE_NEXT_IP6_LOOKUP] = "ip6_lookup",
+		[IPSEC_CRYPTO_DEQUEUE_NEXT_PKT_DROP] = "pkt_drop",
+	},
+};
+
+struct rte_node_register *
+ipsec_crypto_dequeue_node_get(void)
+{
+	return &ipsec_crypto_dequeue_node_base;
+}
+
+RTE_NODE_REGISTER(ipsec_crypto_dequeue_node_base);
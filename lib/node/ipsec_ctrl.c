@@ -0,0 +1,127 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2021 Marvell International Ltd.
+ */
+
+#include <rte_cryptodev.h>
+#include <rte_debug.h>
+#include <rte_graph.h>
+#include <rte_ipsec.h>
+#include <rte_ipsec_sad.h>
+#include <rte_malloc.h>
+
+#include "rte_node_ipsec_api.h"
+
+#include "ipsec_priv.h"
+#include "node_private.h"
+
+#define IPSEC_OUTB_SA_MAX_NH (UINT16_MAX + 1)
+
+static struct ipsec_node_main ipsec_nm;
+
+struct ipsec_node_main *
+ipsec_node_data_get(void)
+{
+	return &ipsec_nm;
+}
+
+int
+rte_node_ipsec_crypto_config(struct rte_node_ipsec_crypto_config *conf,
+			     uint16_t nb_confs, uint16_t nb_graphs)
+{
+	struct rte_node_register *inb_node, *outb_node;
+	struct rte_node_register *enq_node, *deq_node;
+	char name[RTE_NODE_NAMESIZE];
+	const char *next_nodes = name;
+	struct ipsec_crypto_dev *dev;
+	uint8_t dev_id;
+	uint32_t id;
+	int i;
+
+	inb_node = ipsec_inb_sa_lookup_node_get();
+	outb_node = ipsec_outb_sa_node_get();
+	enq_node = ipsec_crypto_enqueue_node_get();
+	deq_node = ipsec_crypto_dequeue_node_get();
+	for (i = 0; i < nb_confs; i++) {
+		dev_id = conf[i].dev_id;
+
+		if (dev_id >= RTE_CRYPTO_MAX_DEVS ||
+		    rte_cryptodev_socket_id(dev_id) < 0 ||
+		    conf[i].cop_pool == NULL)
+			return -EINVAL;
+
+		dev = &ipsec_nm.devs[dev_id];
+		if (dev->enabled)
+			return -EEXIST;
+
+		/* Check if we have a queue pair for each worker */
+		if (conf[i].num_qps < nb_graphs)
+			return -EINVAL;
+
+		/* Create a per device enqueue and dequeue node from base node */
+		snprintf(name, sizeof(name), "%u", dev_id);
+		id = rte_node_clone(enq_node->id, name);
+		if (id == RTE_NODE_ID_INVALID)
+			return -EIO;
+		dev->enqueue_node = id;
+
+		id = rte_node_clone(deq_node->id, name);
+		if (id == RTE_NODE_ID_INVALID)
+			return -EIO;
+		dev->dequeue_node = id;
+
+		node_dbg("ipsec", "Crypto enqueue and dequeue nodes of dev %u",
+			 dev_id);
+
+		/* Prepare the actual name of the cloned enqueue node */
+		snprintf(name, sizeof(name), "ipsec_crypto_enqueue-%u", dev_id);
+
+		/* Add this enqueue node as next to both SA nodes */
+		rte_node_edge_update(inb_node->id, RTE_EDGE_ID_INVALID,
+				     &next_nodes, 1);
+		/* Assuming edge id is the last one alloc'ed */
+		dev->inb_next = rte_node_edge_count(inb_node->id) - 1;
+
+		rte_node_edge_update(outb_node->id, RTE_EDGE_ID_INVALID,
+				     &next_nodes, 1);
+		dev->outb_next = rte_node_edge_count(outb_node->id) - 1;
+
+		dev->cop_pool = conf[i].cop_pool;
+		dev->num_qps = conf[i].num_qps;
+		dev->enabled = true;
+	}
+
+	return 0;
+}
+
+int
+rte_node_ipsec_inb_sad_set(struct rte_ipsec_sad *sad_v4,
+			   struct rte_ipsec_sad *sad_v6)
+{
+	ipsec_nm.sad_v4 = sad_v4;
+	ipsec_nm.sad_v6 = sad_v6;
+
+	return 0;
+}
+
+int
+rte_node_ipsec_outb_sa_add(uint16_t next_hop, struct rte_ipsec_session *ss)
+{
+	if (ss != NULL &&
+	    (ss->type != RTE_SECURITY_ACTION_TYPE_NONE ||
+	     (rte_ipsec_sa_type(ss->sa) & RTE_IPSEC_SATP_DIR_MASK) !=
+		     RTE_IPSEC_SATP_DIR_OB))
+		return -ENOTSUP;
+
+	if (ipsec_nm.outb_sa == NULL) {
+		ipsec_nm.outb_sa = rte_zmalloc("ipsec_outb_sa",
+					       IPSEC_OUTB_SA_MAX_NH *
+						       sizeof(ipsec_nm.outb_sa[0]),
+					       RTE_CACHE_LINE_SIZE);
+		if (ipsec_nm.outb_sa == NULL)
+			return -ENOMEM;
+	}
+
+	ipsec_nm.outb_sa[next_hop] = ss;
+
+	return 0;
+}
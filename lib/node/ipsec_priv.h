@@ -0,0 +1,167 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2021 Marvell International Ltd.
+ */
+#ifndef __INCLUDE_IPSEC_PRIV_H__
+#define __INCLUDE_IPSEC_PRIV_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+
+#include <rte_common.h>
+#include <rte_graph_worker.h>
+#include <rte_mempool.h>
+
+enum ipsec_sa_next_nodes {
+	IPSEC_SA_NEXT_PKT_DROP,
+	IPSEC_SA_NEXT_MAX,
+};
+
+enum ipsec_crypto_enqueue_next_nodes {
+	IPSEC_CRYPTO_ENQUEUE_NEXT_PKT_DROP,
+	IPSEC_CRYPTO_ENQUEUE_NEXT_MAX,
+};
+
+enum ipsec_crypto_dequeue_next_nodes {
+	IPSEC_CRYPTO_DEQUEUE_NEXT_IP4_LOOKUP,
+	IPSEC_CRYPTO_DEQUEUE_NEXT_IP6_LOOKUP,
+	IPSEC_CRYPTO_DEQUEUE_NEXT_PKT_DROP,
+	IPSEC_CRYPTO_DEQUEUE_NEXT_MAX,
+};
+
+/**
+ * @internal
+ *
+ * IPsec crypto node context structure.
+ */
+struct ipsec_crypto_node_ctx {
+	struct rte_mempool *cop_pool; /**< Pool of crypto operations. */
+	int mbuf_priv1_off;	      /**< Dynamic offset to mbuf priv1. */
+	uint16_t qp_id;		      /**< Queue pair of the device. */
+	uint8_t dev_id;		      /**< Crypto device identifier. */
+};
+
+/**
+ * @internal
+ *
+ * IPsec crypto device data structure.
+ */
+struct ipsec_crypto_dev {
+	struct rte_mempool *cop_pool; /**< Pool of crypto operations. */
+	uint32_t enqueue_node;	 /**< Crypto enqueue node identifier. */
+	uint32_t dequeue_node;	 /**< Crypto dequeue node identifier. */
+	uint16_t num_qps;	 /**< Number of queue pairs. */
+	uint16_t inb_next;	 /**< Inbound SA node edge to enqueue node. */
+	uint16_t outb_next;	 /**< Outbound SA node edge to enqueue node. */
+	bool enabled;		 /**< Device configured flag. */
+};
+
+/**
+ * @internal
+ *
+ * IPsec node main data structure.
+ */
+struct ipsec_node_main {
+	struct ipsec_crypto_dev devs[RTE_CRYPTO_MAX_DEVS];
+	/**< Configured crypto devices. */
+	struct rte_ipsec_sad *sad_v4;
+	/**< SAD of the inbound IPv4 ESP packets. */
+	struct rte_ipsec_sad *sad_v6;
+	/**< SAD of the inbound IPv6 ESP packets. */
+	struct rte_ipsec_session **outb_sa;
+	/**< Outbound sessions indexed by next hop. */
+};
+
+/**
+ * @internal
+ *
+ * Get the IPsec node data.
+ *
+ * @return
+ *   Pointer to IPsec node data.
+ */
+struct ipsec_node_main *ipsec_node_data_get(void);
+
+/**
+ * @internal
+ *
+ * Get the IPsec inbound SA lookup node.
+ *
+ * @return
+ *   Pointer to the IPsec inbound SA lookup node.
+ */
+struct rte_node_register *ipsec_inb_sa_lookup_node_get(void);
+
+/**
+ * @internal
+ *
+ * Get the IPsec outbound SA node.
+ *
+ * @return
+ *   Pointer to the IPsec outbound SA node.
+ */
+struct rte_node_register *ipsec_outb_sa_node_get(void);
+
+/**
+ * @internal
+ *
+ * Get the IPsec crypto enqueue node.
+ *
+ * @return
+ *   Pointer to the IPsec crypto enqueue node.
+ */
+struct rte_node_register *ipsec_crypto_enqueue_node_get(void);
+
+/**
+ * @internal
+ *
+ * Get the IPsec crypto dequeue node.
+ *
+ * @return
+ *   Pointer to the IPsec crypto dequeue node.
+ */
+struct rte_node_register *ipsec_crypto_dequeue_node_get(void);
+
+/**
+ * @internal
+ *
+ * Enqueue the objects to their next nodes, as runs of consecutive objects
+ * with the same next node, which keeps the bursts of a flow together.
+ *
+ * @param graph
+ *   Pointer to the graph object.
+ * @param node
+ *   Pointer to the node object.
+ * @param objs
+ *   Objects to enqueue.
+ * @param nexts
+ *   Next node edge of each object.
+ * @param nb_objs
+ *   Number of objects, which must be non-zero.
+ */
+static __rte_always_inline void
+ipsec_node_enqueue_runs(struct rte_graph *graph, struct rte_node *node,
+			void **objs, const uint16_t *nexts, uint16_t nb_objs)
+{
+	uint16_t i, start = 0;
+
+	for (i = 1; i < nb_objs; i++) {
+		if (nexts[i] == nexts[start])
+			continue;
+
+		rte_node_enqueue(graph, node, nexts[start], &objs[start],
+				 i - start);
+		start = i;
+	}
+
+	rte_node_enqueue(graph, node, nexts[start], &objs[start],
+			 nb_objs - start);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_IPSEC_PRIV_H__ */
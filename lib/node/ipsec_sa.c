@@ -0,0 +1,253 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2021 Marvell International Ltd.
+ */
+
+#include <rte_byteorder.h>
+#include <rte_debug.h>
+#include <rte_errno.h>
+#include <rte_esp.h>
+#include <rte_ether.h>
+#include <rte_graph.h>
+#include <rte_graph_worker.h>
+#include <rte_ip.h>
+#include <rte_ipsec.h>
+#include <rte_ipsec_sad.h>
+#include <rte_mbuf.h>
+
+#include "rte_node_ipsec_api.h"
+
+#include "ipsec_priv.h"
+#include "node_private.h"
+
+struct ipsec_sa_node_ctx {
+	/* Dynamic offset to mbuf priv1 */
+	int mbuf_priv1_off;
+};
+
+#define IPSEC_SA_NODE_PRIV1_OFF(ctx) \
+	(((struct ipsec_sa_node_ctx *)ctx)->mbuf_priv1_off)
+
+/* Next edge of a packet of session *ss* to the crypto enqueue node of the
+ * device of the session, or to the drop node.
+ */
+static __rte_always_inline uint16_t
+ipsec_sa_next_get(const struct ipsec_node_main *nm,
+		  const struct rte_ipsec_session *ss, bool inb)
+{
+	const struct ipsec_crypto_dev *dev;
+
+	if (unlikely(ss == NULL || ss->type != RTE_SECURITY_ACTION_TYPE_NONE))
+		return IPSEC_SA_NEXT_PKT_DROP;
+
+	dev = &nm->devs[ss->crypto.dev_id];
+	if (unlikely(!dev->enabled))
+		return IPSEC_SA_NEXT_PKT_DROP;
+
+	return inb ? dev->inb_next : dev->outb_next;
+}
+
+/* The SAD keys of up to a burst of packets are gathered first, per IP
+ * version, and then looked up with a single SAD bulk lookup per version.
+ */
+static uint16_t
+ipsec_inb_sa_lookup_node_process(struct rte_graph *graph,
+				 struct rte_node *node, void **objs,
+				 uint16_t nb_objs)
+{
+	const union rte_ipsec_sad_key *keys_v4[RTE_GRAPH_BURST_SIZE];
+	const union rte_ipsec_sad_key *keys_v6[RTE_GRAPH_BURST_SIZE];
+	union rte_ipsec_sad_key keys[RTE_GRAPH_BURST_SIZE];
+	uint16_t idx_v4[RTE_GRAPH_BURST_SIZE];
+	uint16_t idx_v6[RTE_GRAPH_BURST_SIZE];
+	uint16_t nexts[RTE_GRAPH_BURST_SIZE];
+	void *sa_v4[RTE_GRAPH_BURST_SIZE];
+	void *sa_v6[RTE_GRAPH_BURST_SIZE];
+	void *ss[RTE_GRAPH_BURST_SIZE];
+	const int dyn = IPSEC_SA_NODE_PRIV1_OFF(node->ctx);
+	const struct ipsec_node_main *nm = ipsec_node_data_get();
+	struct rte_mbuf **pkts = (struct rte_mbuf **)objs;
+	uint16_t n_left_from = nb_objs, n, i, nb_v4, nb_v6;
+	const struct rte_ether_hdr *eth_hdr;
+	const struct rte_ipv4_hdr *ipv4_hdr;
+	const struct rte_ipv6_hdr *ipv6_hdr;
+	const struct rte_esp_hdr *esp_hdr;
+	struct rte_mbuf *mbuf;
+
+	while (n_left_from > 0) {
+		n = RTE_MIN(n_left_from, (uint16_t)RTE_GRAPH_BURST_SIZE);
+		nb_v4 = 0;
+		nb_v6 = 0;
+
+		for (i = 0; i < n; i++) {
+			if (likely(i + 1 < n))
+				rte_prefetch0(rte_pktmbuf_mtod(pkts[i + 1],
+							       void *));
+
+			mbuf = pkts[i];
+			ss[i] = NULL;
+			eth_hdr = rte_pktmbuf_mtod(mbuf,
+						   const struct rte_ether_hdr *);
+			mbuf->l2_len = sizeof(struct rte_ether_hdr);
+
+			if (eth_hdr->ether_type ==
+			    rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4)) {
+				ipv4_hdr = (const struct rte_ipv4_hdr *)
+					(eth_hdr + 1);
+				if (ipv4_hdr->next_proto_id != IPPROTO_ESP)
+					continue;
+
+				mbuf->l3_len = rte_ipv4_hdr_len(ipv4_hdr);
+				esp_hdr = RTE_PTR_ADD(ipv4_hdr, mbuf->l3_len);
+				keys[i].v4.spi = esp_hdr->spi;
+				keys[i].v4.dip = ipv4_hdr->dst_addr;
+				keys[i].v4.sip = ipv4_hdr->src_addr;
+				keys_v4[nb_v4] = &keys[i];
+				idx_v4[nb_v4++] = i;
+			} else if (eth_hdr->ether_type ==
+				   rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV6)) {
+				ipv6_hdr = (const struct rte_ipv6_hdr *)
+					(eth_hdr + 1);
+				/* IPv6 extension headers are not supported */
+				if (ipv6_hdr->proto != IPPROTO_ESP)
+					continue;
+
+				mbuf->l3_len = sizeof(struct rte_ipv6_hdr);
+				esp_hdr = (const struct rte_esp_hdr *)
+					(ipv6_hdr + 1);
+				keys[i].v6.spi = esp_hdr->spi;
+				rte_memcpy(keys[i].v6.dip, ipv6_hdr->dst_addr,
+					   sizeof(keys[i].v6.dip));
+				rte_memcpy(keys[i].v6.sip, ipv6_hdr->src_addr,
+					   sizeof(keys[i].v6.sip));
+				keys_v6[nb_v6] = &keys[i];
+				idx_v6[nb_v6++] = i;
+			}
+		}
+
+		if (nb_v4 && nm->sad_v4 != NULL) {
+			rte_ipsec_sad_lookup(nm->sad_v4, keys_v4, sa_v4, nb_v4);
+			for (i = 0; i < nb_v4; i++)
+				ss[idx_v4[i]] = sa_v4[i];
+		}
+
+		if (nb_v6 && nm->sad_v6 != NULL) {
+			rte_ipsec_sad_lookup(nm->sad_v6, keys_v6, sa_v6, nb_v6);
+			for (i = 0; i < nb_v6; i++)
+				ss[idx_v6[i]] = sa_v6[i];
+		}
+
+		for (i = 0; i < n; i++) {
+			node_mbuf_priv1(pkts[i], dyn)->ss = ss[i];
+			nexts[i] = ipsec_sa_next_get(nm, ss[i], true);
+		}
+
+		ipsec_node_enqueue_runs(graph, node, (void **)pkts, nexts, n);
+
+		pkts += n;
+		n_left_from -= n;
+	}
+
+	return nb_objs;
+}
+
+static uint16_t
+ipsec_outb_sa_node_process(struct rte_graph *graph, struct rte_node *node,
+			   void **objs, uint16_t nb_objs)
+{
+	uint16_t nexts[RTE_GRAPH_BURST_SIZE];
+	const int dyn = IPSEC_SA_NODE_PRIV1_OFF(node->ctx);
+	const struct ipsec_node_main *nm = ipsec_node_data_get();
+	struct rte_mbuf **pkts = (struct rte_mbuf **)objs;
+	struct rte_ipsec_session *const *outb_sa = nm->outb_sa;
+	uint16_t n_left_from = nb_objs, n, i;
+	struct node_mbuf_priv1 *priv1;
+	const uint8_t *ip_hdr;
+	struct rte_ipsec_session *ss;
+	struct rte_mbuf *mbuf;
+
+	while (n_left_from > 0) {
+		n = RTE_MIN(n_left_from, (uint16_t)RTE_GRAPH_BURST_SIZE);
+
+		for (i = 0; i < n; i++) {
+			mbuf = pkts[i];
+			priv1 = node_mbuf_priv1(mbuf, dyn);
+			ss = outb_sa != NULL ? outb_sa[priv1->nh] : NULL;
+			priv1->ss = ss;
+			nexts[i] = ipsec_sa_next_get(nm, ss, false);
+
+			ip_hdr = rte_pktmbuf_mtod_offset(mbuf, const uint8_t *,
+					sizeof(struct rte_ether_hdr));
+			mbuf->l2_len = sizeof(struct rte_ether_hdr);
+			if ((ip_hdr[0] >> 4) == IPVERSION)
+				mbuf->l3_len = rte_ipv4_hdr_len(
+					(const struct rte_ipv4_hdr *)ip_hdr);
+			else
+				mbuf->l3_len = sizeof(struct rte_ipv6_hdr);
+		}
+
+		ipsec_node_enqueue_runs(graph, node, (void **)pkts, nexts, n);
+
+		pkts += n;
+		n_left_from -= n;
+	}
+
+	return nb_objs;
+}
+
+static int
+ipsec_sa_node_init(const struct rte_graph *graph, struct rte_node *node)
+{
+	RTE_SET_USED(graph);
+	RTE_BUILD_BUG_ON(sizeof(struct ipsec_sa_node_ctx) > RTE_NODE_CTX_SZ);
+
+	node_mbuf_priv1_dynfield_offset = rte_mbuf_dynfield_register(
+			&node_mbuf_priv1_dynfield_desc);
+	if (node_mbuf_priv1_dynfield_offset < 0)
+		return -rte_errno;
+
+	IPSEC_SA_NODE_PRIV1_OFF(node->ctx) = node_mbuf_priv1_dynfield_offset;
+
+	node_dbg("ipsec", "Initialized %s node", node->name);
+
+	return 0;
+}
+
+static struct rte_node_register ipsec_inb_sa_lookup_node = {
+	.process = ipsec_inb_sa_lookup_node_process,
+	.name = "ipsec_inb_sa_lookup",
+
+	.init = ipsec_sa_node_init,
+
+	.nb_edges = IPSEC_SA_NEXT_MAX,
+	.next_nodes = {
+		[IPSEC_SA_NEXT_PKT_DROP] = "pkt_drop",
+	},
+};
+
+struct rte_node_register *
+ipsec_inb_sa_lookup_node_get(void)
+{
+	return &ipsec_inb_sa_lookup_node;
+}
+
+RTE_NODE_REGISTER(ipsec_inb_sa_lookup_node);
+
+static struct rte_node_register ipsec_outb_sa_node = {
+	.process = ipsec_outb_sa_node_process,
+	.name = "ipsec_outb_sa",
+
+	.init = ipsec_sa_node_init,
+
+	.nb_edges = IPSEC_SA_NEXT_MAX,
+	.next_nodes = {
+		[IPSEC_SA_NEXT_PKT_DROP] = "pkt_drop",
+	},
+};
+
+struct rte_node_register *
+ipsec_outb_sa_node_get(void)
+{
+	return &ipsec_outb_sa_node;
+}
+
+RTE_NODE_REGISTER(ipsec_outb_sa_node);
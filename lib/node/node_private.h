@@ -10,6 +10,8 @@
 #include <rte_mbuf.h>
 #include <rte_mbuf_dyn.h>
 
+struct rte_ipsec_session;
+
 extern int rte_node_logtype;
 #define NODE_LOG(level, node_name, ...)                                        \
 	rte_log(RTE_LOG_##level, rte_node_logtype,                             \
@@ -22,17 +24,21 @@ extern int rte_node_logtype;
 #define node_dbg(node_name, ...) NODE_LOG(DEBUG, node_name, __VA_ARGS__)
 
 /**
- * Node mbuf private data to store next hop, ttl and checksum.
+ * Node mbuf private data to store next hop, ttl and checksum, or IPsec
+ * session.
  */
 struct node_mbuf_priv1 {
 	union {
-		/* IP4 rewrite */
+		/* IP4/IP6 rewrite, ttl is the hop limit for IP6 */
 		struct {
 			uint16_t nh;
 			uint16_t ttl;
 			uint32_t cksum;
 		};
 
+		/* IPsec session of the packet, set by the IPsec SA nodes */
+		struct rte_ipsec_session *ss;
+
 		uint64_t u;
 	};
 };
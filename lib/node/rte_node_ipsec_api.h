@@ -0,0 +1,117 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(C) 2021 Marvell International Ltd.
+ */
+
+#ifndef __INCLUDE_RTE_NODE_IPSEC_API_H__
+#define __INCLUDE_RTE_NODE_IPSEC_API_H__
+
+/**
+ * @file rte_node_ipsec_api.h
+ *
+ * @warning
+ * @b EXPERIMENTAL:
+ * All functions in this file may be changed or removed without prior notice.
+ *
+ * This API allows to do control path functions of IPsec graph nodes.
+ *
+ * The ``ipsec_inb_sa_lookup`` node looks up the SA of the inbound ESP packets
+ * in a SAD and the ``ipsec_outb_sa`` node gets the SA of the outbound packets
+ * from the next hop set by the ``ip4_lookup`` or ``ip6_lookup`` node. Both
+ * forward the packets to the ``ipsec_crypto_enqueue-<dev_id>`` node of the
+ * crypto device of the session, which prepares the crypto operations with
+ * rte_ipsec_pkt_crypto_prepare() and enqueues them to the device. The
+ * ``ipsec_crypto_dequeue-<dev_id>`` source node dequeues the completed crypto
+ * operations, finalizes the packets with rte_ipsec_pkt_process() per group
+ * of packets of the same session and forwards them to the ``ip4_lookup`` or
+ * ``ip6_lookup`` node.
+ *
+ * Only the sessions of the RTE_SECURITY_ACTION_TYPE_NONE type are supported,
+ * the packets of the other sessions are dropped.
+ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <rte_common.h>
+#include <rte_compat.h>
+#include <rte_mempool.h>
+
+struct rte_ipsec_sad;
+struct rte_ipsec_session;
+
+/**
+ * Crypto device config for ipsec_crypto_enqueue and ipsec_crypto_dequeue
+ * nodes.
+ */
+struct rte_node_ipsec_crypto_config {
+	uint8_t dev_id;
+	/**< Crypto device identifier. */
+	uint16_t num_qps;
+	/**< Number of queue pairs, one is used by each graph. */
+	struct rte_mempool *cop_pool;
+	/**< Pool of symmetric crypto operations. */
+};
+
+/**
+ * Initializes IPsec crypto nodes.
+ *
+ * @param cfg
+ *   Array of crypto device config that identifies which device's
+ *   ipsec_crypto_enqueue and ipsec_crypto_dequeue nodes need to be created.
+ * @param cnt
+ *   Size of cfg array.
+ * @param nb_graphs
+ *   Number of graphs that will be used. The queue pair of each device used
+ *   by a graph is the graph identifier.
+ *
+ * @return
+ *   0 on successful initialization, negative otherwise.
+ */
+__rte_experimental
+int rte_node_ipsec_crypto_config(struct rte_node_ipsec_crypto_config *cfg,
+				 uint16_t cnt, uint16_t nb_graphs);
+
+/**
+ * Set the SADs used by the ipsec_inb_sa_lookup node.
+ *
+ * The SA associated with each SAD key must be the *struct rte_ipsec_session*
+ * of the inbound SA. The keys are in network byte order.
+ *
+ * @param sad_v4
+ *   SAD of the IPv4 ESP packets, NULL to drop them.
+ * @param sad_v6
+ *   SAD of the IPv6 ESP packets, created with RTE_IPSEC_SAD_FLAG_IPV6, NULL
+ *   to drop them.
+ *
+ * @return
+ *   0 on success, negative otherwise.
+ */
+__rte_experimental
+int rte_node_ipsec_inb_sad_set(struct rte_ipsec_sad *sad_v4,
+			       struct rte_ipsec_sad *sad_v6);
+
+/**
+ * Add the outbound SA session of a next hop to the ipsec_outb_sa node.
+ *
+ * The packets are forwarded to the ipsec_outb_sa node with a route added by
+ * rte_node_ip4_route_add() or rte_node_ip6_route_add(), with *next_hop* and,
+ * as next node, the edge from the lookup node to the ipsec_outb_sa node
+ * added by rte_node_edge_update().
+ *
+ * @param next_hop
+ *   Next hop identifier.
+ * @param ss
+ *   Outbound session, or NULL to remove the session of *next_hop*.
+ *
+ * @return
+ *   0 on success, negative otherwise.
+ */
+__rte_experimental
+int rte_node_ipsec_outb_sa_add(uint16_t next_hop,
+			       struct rte_ipsec_session *ss);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_RTE_NODE_IPSEC_API_H__ */
@@ -0,0 +1,648 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Microsoft Corporation
+ */
+
+#include <errno.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/uio.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <rte_common.h>
+#include <rte_cycles.h>
+#include <rte_errno.h>
+#include <rte_ethdev.h>
+#include <rte_ether.h>
+#include <rte_mbuf.h>
+#include <rte_time.h>
+
+#include "rte_pcapng.h"
+#include "pcapng_proto.h"
+
+/* conversion from DPDK speed to PCAPNG */
+#define PCAPNG_MBPS_SPEED 1000000ull
+
+/* Link type written in the interface blocks (LINKTYPE_ETHERNET) */
+#define PCAPNG_LINKTYPE_ETHERNET 1
+
+/* Timestamp resolution of the interfaces: 10^-9 seconds */
+#define PCAPNG_TSRESOL_NS 9
+
+/* Port not yet described by an interface block */
+#define PCAPNG_NO_INTERFACE UINT32_MAX
+
+/* Format of the capture file handle */
+struct rte_pcapng {
+	int  outfd;		/* output file */
+	uint32_t nb_interfaces;	/* interface blocks written so far */
+	/* DPDK port id to interface index in file */
+	uint32_t port_index[RTE_MAX_ETHPORTS];
+
+	/* Reference point used to turn TSC cycles into wall clock time */
+	uint64_t tsc_base;
+	uint64_t ns_base;
+	uint64_t tsc_hz;
+};
+
+static void
+pcapng_init_clock(rte_pcapng_t *self)
+{
+	struct timespec ts;
+
+	self->tsc_hz = rte_get_tsc_hz();
+	clock_gettime(CLOCK_REALTIME, &ts);
+	self->tsc_base = rte_get_tsc_cycles();
+	self->ns_base = rte_timespec_to_ns(&ts);
+}
+
+/* Split the conversion so that the multiplication cannot overflow. */
+static uint64_t
+pcapng_cycles_to_ns(const rte_pcapng_t *self, uint64_t cycles)
+{
+	return (cycles / self->tsc_hz) * NSEC_PER_SEC +
+		(cycles % self->tsc_hz) * NSEC_PER_SEC / self->tsc_hz;
+}
+
+/* For converting TSC cycles to PCAPNG ns format */
+static uint64_t
+pcapng_tsc_to_ns(const rte_pcapng_t *self, uint64_t cycles)
+{
+	if (unlikely(cycles < self->tsc_base))
+		return self->ns_base -
+			pcapng_cycles_to_ns(self, self->tsc_base - cycles);
+
+	return self->ns_base + pcapng_cycles_to_ns(self, cycles - self->tsc_base);
+}
+
+static uint16_t
+pcapng_strlen(const char *str)
+{
+	return RTE_MIN(strlen(str), (size_t)UINT16_MAX);
+}
+
+static inline uint32_t
+pcapng_optlen(uint16_t len)
+{
+	return sizeof(struct pcapng_option) + RTE_ALIGN(len, sizeof(uint32_t));
+}
+
+/* Options are padded to 32 bits, the padding must already be zeroed. */
+static struct pcapng_option *
+pcapng_add_option(struct pcapng_option *popt, uint16_t code,
+		  const void *data, uint16_t len)
+{
+	popt->code = code;
+	popt->length = len;
+	if (len > 0)
+		memcpy(popt->data, data, len);
+
+	return (struct pcapng_option *)((uint8_t *)popt + pcapng_optlen(len));
+}
+
+/* Options with a timestamp use the same layout as packet blocks. */
+static struct pcapng_option *
+pcapng_add_time_option(struct pcapng_option *popt, uint16_t code, uint64_t ns)
+{
+	uint32_t ts[2] = { ns >> 32, (uint32_t)ns };
+
+	return pcapng_add_option(popt, code, ts, sizeof(ts));
+}
+
+/* Write a block built by the caller, the trailer is filled in here. */
+static int
+pcapng_write_block(rte_pcapng_t *self, void *buf, uint32_t len)
+{
+	ssize_t cc;
+
+	/* clone block_length after options */
+	memcpy((uint8_t *)buf + len - sizeof(uint32_t),
+	       (uint8_t *)buf + sizeof(uint32_t), sizeof(uint32_t));
+
+	cc = write(self->outfd, buf, len);
+	if (cc != (ssize_t)len) {
+		rte_errno = cc < 0 ? errno : EIO;
+		return -1;
+	}
+
+	return 0;
+}
+
+static int
+pcapng_section_block(rte_pcapng_t *self,
+		     const char *os, const char *hw,
+		     const char *app, const char *comment)
+{
+	struct pcapng_section_header *hdr;
+	struct pcapng_option *opt;
+	uint32_t len;
+	int ret;
+
+	len = sizeof(*hdr);
+	if (hw)
+		len += pcapng_optlen(pcapng_strlen(hw));
+	if (os)
+		len += pcapng_optlen(pcapng_strlen(os));
+	if (app)
+		len += pcapng_optlen(pcapng_strlen(app));
+	if (comment)
+		len += pcapng_optlen(pcapng_strlen(comment));
+
+	/* reserve space for OPT_END and block length trailer */
+	len += pcapng_optlen(0) + sizeof(uint32_t);
+
+	hdr = calloc(1, len);
+	if (hdr == NULL) {
+		rte_errno = ENOMEM;
+		return -1;
+	}
+
+	*hdr = (struct pcapng_section_header) {
+		.block_type = PCAPNG_SECTION_BLOCK,
+		.block_length = len,
+		.byte_order_magic = PCAPNG_BYTE_ORDER_MAGIC,
+		.major_version = PCAPNG_MAJOR_VERS,
+		.minor_version = PCAPNG_MINOR_VERS,
+		.section_length = UINT64_MAX,
+	};
+
+	/* After the section header insert variable length options. */
+	opt = (struct pcapng_option *)(hdr + 1);
+	if (comment)
+		opt = pcapng_add_option(opt, PCAPNG_OPT_COMMENT,
+					comment, pcapng_strlen(comment));
+	if (hw)
+		opt = pcapng_add_option(opt, PCAPNG_SHB_HARDWARE,
+					hw, pcapng_strlen(hw));
+	if (os)
+		opt = pcapng_add_option(opt, PCAPNG_SHB_OS,
+					os, pcapng_strlen(os));
+	if (app)
+		opt = pcapng_add_option(opt, PCAPNG_SHB_USERAPPL,
+					app, pcapng_strlen(app));
+	pcapng_add_option(opt, PCAPNG_OPT_END, NULL, 0);
+
+	ret = pcapng_write_block(self, hdr, len);
+	free(hdr);
+	return ret;
+}
+
+/* Write an interface block for a DPDK port */
+static int
+pcapng_add_interface(rte_pcapng_t *self, uint16_t port)
+{
+	struct pcapng_interface_block *hdr;
+	struct rte_eth_dev_info dev_info;
+	struct rte_ether_addr *ea, macaddr;
+	struct rte_eth_link link;
+	struct pcapng_option *opt;
+	const uint8_t tsresol = PCAPNG_TSRESOL_NS;
+	char ifname[RTE_ETH_NAME_MAX_LEN];
+	const char *ifdescr = NULL;
+	uint64_t speed = 0;
+	uint32_t len;
+	int ret;
+
+	if (rte_eth_dev_get_name_by_port(port, ifname) < 0)
+		snprintf(ifname, sizeof(ifname), "port%u", port);
+
+	if (rte_eth_dev_info_get(port, &dev_info) == 0)
+		ifdescr = dev_info.driver_name;
+
+	if (rte_eth_macaddr_get(port, &macaddr) < 0)
+		ea = NULL;
+	else
+		ea = &macaddr;
+
+	/* DPDK reports in units of Mbps */
+	if (rte_eth_link_get_nowait(port, &link) == 0 &&
+	    link.link_status == ETH_LINK_UP &&
+	    link.link_speed != ETH_SPEED_NUM_UNKNOWN)
+		speed = link.link_speed * PCAPNG_MBPS_SPEED;
+
+	/* Compute length of interface block options */
+	len = sizeof(*hdr);
+	len += pcapng_optlen(sizeof(tsresol));	/* timestamp */
+	len += pcapng_optlen(pcapng_strlen(ifname));	/* ifname */
+	if (ifdescr)
+		len += pcapng_optlen(pcapng_strlen(ifdescr));
+	if (ea)
+		len += pcapng_optlen(RTE_ETHER_ADDR_LEN); /* macaddr */
+	if (speed != 0)
+		len += pcapng_optlen(sizeof(uint64_t));
+
+	len += pcapng_optlen(0) + sizeof(uint32_t);
+
+	hdr = calloc(1, len);
+	if (hdr == NULL) {
+		rte_errno = ENOMEM;
+		return -1;
+	}
+
+	*hdr = (struct pcapng_interface_block) {
+		.block_type = PCAPNG_INTERFACE_BLOCK,
+		.link_type = PCAPNG_LINKTYPE_ETHERNET,
+		.block_length = len,
+		.snap_len = 0,	/* no limit */
+	};
+
+	opt = (struct pcapng_option *)(hdr + 1);
+	opt = pcapng_add_option(opt, PCAPNG_IFB_TSRESOL,
+				&tsresol, sizeof(tsresol));
+	opt = pcapng_add_option(opt, PCAPNG_IFB_NAME,
+				ifname, pcapng_strlen(ifname));
+	if (ifdescr)
+		opt = pcapng_add_option(opt, PCAPNG_IFB_DESCRIPTION,
+					ifdescr, pcapng_strlen(ifdescr));
+	if (ea)
+		opt = pcapng_add_option(opt, PCAPNG_IFB_MACADDR,
+					ea, RTE_ETHER_ADDR_LEN);
+	if (speed != 0)
+		opt = pcapng_add_option(opt, PCAPNG_IFB_SPEED,
+					&speed, sizeof(uint64_t));
+	pcapng_add_option(opt, PCAPNG_OPT_END, NULL, 0);
+
+	ret = pcapng_write_block(self, hdr, len);
+	free(hdr);
+	if (ret < 0)
+		return -1;
+
+	self->port_index[port] = self->nb_interfaces++;
+	return 0;
+}
+
+/* Ports attached after the file was opened are described on first use. */
+static int
+pcapng_port_index(rte_pcapng_t *self, uint16_t port, uint32_t *index)
+{
+	if (unlikely(port >= RTE_MAX_ETHPORTS)) {
+		rte_errno = EINVAL;
+		return -1;
+	}
+
+	if (unlikely(self->port_index[port] == PCAPNG_NO_INTERFACE) &&
+	    pcapng_add_interface(self, port) < 0)
+		return -1;
+
+	*index = self->port_index[port];
+	return 0;
+}
+
+/*
+ * Write the list of possible interfaces at the start
+ * of the file.
+ */
+static int
+pcapng_interfaces(rte_pcapng_t *self)
+{
+	uint16_t port_id;
+
+	RTE_ETH_FOREACH_DEV(port_id) {
+		if (pcapng_add_interface(self, port_id) < 0)
+			return -1;
+	}
+	return 0;
+}
+
+/*
+ * Write an Interface statistics block at the end of capture.
+ */
+ssize_t
+rte_pcapng_write_stats(rte_pcapng_t *self, uint16_t port_id,
+		       const char *comment,
+		       uint64_t start_time, uint64_t end_time,
+		       uint64_t ifrecv, uint64_t ifdrop)
+{
+	struct pcapng_statistics *hdr;
+	struct pcapng_option *opt;
+	uint32_t optlen, len, index;
+	uint64_t ns;
+	int ret;
+
+	if (pcapng_port_index(self, port_id, &index) < 0)
+		return -1;
+
+	optlen = 0;
+
+	if (ifrecv != UINT64_MAX)
+		optlen += pcapng_optlen(sizeof(ifrecv));
+	if (ifdrop != UINT64_MAX)
+		optlen += pcapng_optlen(sizeof(ifdrop));
+	if (start_time != 0)
+		optlen += pcapng_optlen(sizeof(start_time));
+	if (end_time != 0)
+		optlen += pcapng_optlen(sizeof(end_time));
+	if (comment)
+		optlen += pcapng_optlen(pcapng_strlen(comment));
+	if (optlen != 0)
+		optlen += pcapng_optlen(0);
+
+	len = sizeof(*hdr) + optlen + sizeof(uint32_t);
+	hdr = calloc(1, len);
+	if (hdr == NULL) {
+		rte_errno = ENOMEM;
+		return -1;
+	}
+
+	ns = pcapng_tsc_to_ns(self, rte_get_tsc_cycles());
+
+	*hdr = (struct pcapng_statistics) {
+		.block_type = PCAPNG_INTERFACE_STATS_BLOCK,
+		.block_length = len,
+		.interface_id = index,
+		.timestamp_hi = ns >> 32,
+		.timestamp_lo = (uint32_t)ns,
+	};
+
+	opt = (struct pcapng_option *)(hdr + 1);
+	if (comment)
+		opt = pcapng_add_option(opt, PCAPNG_OPT_COMMENT,
+					comment, pcapng_strlen(comment));
+	if (start_time != 0)
+		opt = pcapng_add_time_option(opt, PCAPNG_ISB_STARTTIME,
+					     start_time);
+	if (end_time != 0)
+		opt = pcapng_add_time_option(opt, PCAPNG_ISB_ENDTIME,
+					     end_time);
+	if (ifrecv != UINT64_MAX)
+		opt = pcapng_add_option(opt, PCAPNG_ISB_IFRECV,
+					&ifrecv, sizeof(ifrecv));
+	if (ifdrop != UINT64_MAX)
+		opt = pcapng_add_option(opt, PCAPNG_ISB_IFDROP,
+					&ifdrop, sizeof(ifdrop));
+	if (optlen != 0)
+		pcapng_add_option(opt, PCAPNG_OPT_END, NULL, 0);
+
+	ret = pcapng_write_block(self, hdr, len);
+	free(hdr);
+
+	return ret < 0 ? -1 : (ssize_t)len;
+}
+
+/* Space needed after the packet data: options and block trailer */
+static uint32_t
+pcapng_epb_trailer_len(const struct rte_mbuf *md)
+{
+	uint32_t len;
+
+	len = pcapng_optlen(sizeof(uint32_t));		/* flags */
+	len += pcapng_optlen(sizeof(uint32_t));		/* queue */
+	if (md->ol_flags & PKT_RX_RSS_HASH)
+		len += pcapng_optlen(1 + sizeof(uint32_t)); /* hash */
+	len += pcapng_optlen(0);			/* end */
+
+	return len + sizeof(uint32_t);			/* length */
+}
+
+uint32_t
+rte_pcapng_mbuf_size(uint32_t length)
+{
+	uint64_t size;
+
+	/* The flags, queue and hash information are added at the end. */
+	size = (uint64_t)RTE_PKTMBUF_HEADROOM
+		+ RTE_ALIGN_CEIL((uint64_t)length, sizeof(uint32_t))
+		+ pcapng_optlen(sizeof(uint32_t))	/* flag option */
+		+ pcapng_optlen(sizeof(uint32_t))	/* queue option */
+		+ pcapng_optlen(1 + sizeof(uint32_t))	/* hash option */
+		+ pcapng_optlen(0)			/* end option */
+		+ sizeof(uint32_t);			/* length */
+
+	return RTE_MIN(size, (uint64_t)UINT16_MAX);
+}
+
+/* Make a copy of original mbuf with pcapng header and options */
+struct rte_mbuf *
+rte_pcapng_copy(uint16_t port_id, uint32_t queue,
+		const struct rte_mbuf *md,
+		struct rte_mempool *mp,
+		uint32_t length, uint64_t cycles,
+		enum rte_pcapng_direction direction)
+{
+	struct pcapng_enhance_packet_block *epb;
+	uint32_t orig_len, data_len, padding, flags;
+	struct pcapng_option *opt;
+	struct rte_mbuf *mc;
+
+	/* The VLAN tag and the packet block header go in the headroom. */
+	RTE_BUILD_BUG_ON(sizeof(struct pcapng_enhance_packet_block) +
+			 sizeof(struct rte_vlan_hdr) > RTE_PKTMBUF_HEADROOM);
+
+#ifdef RTE_LIBRTE_ETHDEV_DEBUG
+	RTE_ETH_VALID_PORTID_OR_ERR_RET(port_id, NULL);
+#endif
+	orig_len = rte_pktmbuf_pkt_len(md);
+
+	/* Take snapshot of the data */
+	mc = rte_pktmbuf_copy(md, mp, 0, length);
+	if (unlikely(mc == NULL))
+		return NULL;
+
+	/* Expand any offloaded VLAN information */
+	if ((direction == RTE_PCAPNG_DIRECTION_IN &&
+	     (md->ol_flags & PKT_RX_VLAN_STRIPPED)) ||
+	    (direction == RTE_PCAPNG_DIRECTION_OUT &&
+	     (md->ol_flags & PKT_TX_VLAN))) {
+		if (rte_vlan_insert(&mc) != 0)
+			goto fail;
+		orig_len += sizeof(struct rte_vlan_hdr);
+	}
+
+	/* pad the packet to 32 bit boundary */
+	data_len = rte_pktmbuf_pkt_len(mc);
+	padding = RTE_ALIGN(data_len, sizeof(uint32_t)) - data_len;
+	if (padding > 0) {
+		void *tail = rte_pktmbuf_append(mc, padding);
+
+		if (tail == NULL)
+			goto fail;
+		memset(tail, 0, padding);
+	}
+
+	/* reserve trailing options and block length */
+	opt = (struct pcapng_option *)
+		rte_pktmbuf_append(mc, pcapng_epb_trailer_len(md));
+	if (unlikely(opt == NULL))
+		goto fail;
+
+	switch (direction) {
+	case RTE_PCAPNG_DIRECTION_IN:
+		flags = PCAPNG_IFB_INBOUND;
+		break;
+	case RTE_PCAPNG_DIRECTION_OUT:
+		flags = PCAPNG_IFB_OUTBOUND;
+		break;
+	default:
+		flags = 0;
+	}
+
+	opt = pcapng_add_option(opt, PCAPNG_EPB_FLAGS,
+				&flags, sizeof(flags));
+
+	opt = pcapng_add_option(opt, PCAPNG_EPB_QUEUE,
+				&queue, sizeof(queue));
+
+	if (md->ol_flags & PKT_RX_RSS_HASH) {
+		uint8_t hash_opt[RTE_ALIGN(1 + sizeof(uint32_t),
+					   sizeof(uint32_t))] = { 0 };
+
+		hash_opt[0] = PCAPNG_HASH_TOEPLITZ;
+		memcpy(&hash_opt[1], &md->hash.rss, sizeof(uint32_t));
+		opt = pcapng_add_option(opt, PCAPNG_EPB_HASH,
+					hash_opt, 1 + sizeof(uint32_t));
+	}
+
+	opt = pcapng_add_option(opt, PCAPNG_OPT_END, NULL, 0);
+
+	/* Add PCAPNG packet header */
+	epb = (struct pcapng_enhance_packet_block *)
+		rte_pktmbuf_prepend(mc, sizeof(*epb));
+	if (unlikely(epb == NULL))
+		goto fail;
+
+	epb->block_type = PCAPNG_ENHANCED_PACKET_BLOCK;
+	epb->block_length = rte_pktmbuf_pkt_len(mc);
+
+	/* Interface index is filled in later during write */
+	mc->port = port_id;
+
+	/* Timestamp is converted from TSC cycles during write */
+	epb->timestamp_hi = cycles >> 32;
+	epb->timestamp_lo = (uint32_t)cycles;
+	epb->capture_length = data_len;
+	epb->original_length = orig_len;
+
+	/* set trailer of block length */
+	*(uint32_t *)opt = epb->block_length;
+
+	return mc;
+
+fail:
+	rte_pktmbuf_free(mc);
+	return NULL;
+}
+
+/* Flush the pending I/O vector, may be called with nothing pending. */
+static int
+pcapng_writev(rte_pcapng_t *self, struct iovec *iov, int cnt, ssize_t *total)
+{
+	ssize_t ret;
+
+	if (cnt == 0)
+		return 0;
+
+	ret = writev(self->outfd, iov, cnt);
+	if (unlikely(ret < 0)) {
+		rte_errno = errno;
+		return -1;
+	}
+
+	*total += ret;
+	return 0;
+}
+
+/* Write pre-formatted packets to file. */
+ssize_t
+rte_pcapng_write_packets(rte_pcapng_t *self,
+			 struct rte_mbuf *pkts[], uint16_t nb_pkts)
+{
+	struct iovec iov[IOV_MAX];
+	ssize_t total = 0;
+	uint16_t i;
+	int cnt = 0;
+
+	for (i = 0; i < nb_pkts; i++) {
+		struct rte_mbuf *m = pkts[i];
+		struct pcapng_enhance_packet_block *epb;
+		uint32_t index;
+		uint64_t ns;
+
+		/* sanity check that is really a pcapng mbuf */
+		epb = rte_pktmbuf_mtod(m, struct pcapng_enhance_packet_block *);
+		if (unlikely(epb->block_type != PCAPNG_ENHANCED_PACKET_BLOCK ||
+			     epb->block_length != rte_pktmbuf_pkt_len(m) ||
+			     m->nb_segs > IOV_MAX)) {
+			rte_errno = EINVAL;
+			return -1;
+		}
+
+		/*
+		 * The DPDK port is recorded during pcapng_copy.
+		 * Map that to PCAPNG interface in file.
+		 */
+		if (pcapng_port_index(self, m->port, &index) < 0)
+			return -1;
+		epb->interface_id = index;
+
+		ns = pcapng_tsc_to_ns(self,
+				      ((uint64_t)epb->timestamp_hi << 32) |
+				      epb->timestamp_lo);
+		epb->timestamp_hi = ns >> 32;
+		epb->timestamp_lo = (uint32_t)ns;
+
+		if (cnt + m->nb_segs > IOV_MAX) {
+			if (pcapng_writev(self, iov, cnt, &total) < 0)
+				return -1;
+			cnt = 0;
+		}
+
+		/* The block is emitted straight from the mbuf segments. */
+		do {
+			iov[cnt].iov_base = rte_pktmbuf_mtod(m, void *);
+			iov[cnt].iov_len = rte_pktmbuf_data_len(m);
+			++cnt;
+		} while ((m = m->next) != NULL);
+	}
+
+	if (pcapng_writev(self, iov, cnt, &total) < 0)
+		return -1;
+
+	return total;
+}
+
+/* Create new pcapng writer handle */
+rte_pcapng_t *
+rte_pcapng_fdopen(int fd,
+		  const char *osname, const char *hardware,
+		  const char *appname, const char *comment)
+{
+	rte_pcapng_t *self;
+	unsigned int i;
+
+	self = malloc(sizeof(*self));
+	if (self == NULL) {
+		rte_errno = ENOMEM;
+		return NULL;
+	}
+
+	self->outfd = fd;
+	self->nb_interfaces = 0;
+	for (i = 0; i < RTE_DIM(self->port_index); i++)
+		self->port_index[i] = PCAPNG_NO_INTERFACE;
+
+	pcapng_init_clock(self);
+
+	if (pcapng_section_block(self, osname, hardware, appname, comment) < 0)
+		goto fail;
+
+	if (pcapng_interfaces(self) < 0)
+		goto fail;
+
+	return self;
+fail:
+	free(self);
+	return NULL;
+}
+
+void
+rte_pcapng_close(rte_pcapng_t *self)
+{
+	if (self == NULL)
+		return;
+
+	close(self->outfd);
+	free(self);
+}
@@ -6,7 +6,12 @@
 #include <stdio.h>
 #include <errno.h>
 #include <inttypes.h>
+#include <ctype.h>
+#include <limits.h>
+#include <unistd.h>
+#include <dlfcn.h>
 #include <sys/queue.h>
+#include <sys/wait.h>
 #include <arpa/inet.h>
 
 #include <rte_common.h>
@@ -15,8 +20,7 @@
 #include <rte_cycles.h>
 #include <rte_meter.h>
 
-#include "rte_swx_pipeline.h"
-#include "rte_swx_ctl.h"
+#include "rte_swx_pipeline_internal.h"
 
 #define CHECK(condition, err_code)                                             \
 do {                                                                           \
@@ -37,21 +41,9 @@ do {                                                                           \
 	       RTE_SWX_INSTRUCTION_SIZE),                                      \
 	      err_code)
 
-#ifndef TRACE_LEVEL
-#define TRACE_LEVEL 0
-#endif
-
-#if TRACE_LEVEL
-#define TRACE(...) printf(__VA_ARGS__)
-#else
-#define TRACE(...)
-#endif
-
 /*
  * Environment.
  */
-#define ntoh64(x) rte_be_to_cpu_64(x)
-#define hton64(x) rte_cpu_to_be_64(x)
 
 #ifndef RTE_SWX_PIPELINE_HUGE_PAGES_DISABLE
 
@@ -103,1982 +95,1153 @@ env_free(void *start, size_t size)
 /*
  * Struct.
  */
-struct field {
-	char name[RTE_SWX_NAME_SIZE];
-	uint32_t n_bits;
-	uint32_t offset;
-};
-
-struct struct_type {
-	TAILQ_ENTRY(struct_type) node;
-	char name[RTE_SWX_NAME_SIZE];
-	struct field *fields;
-	uint32_t n_fields;
-	uint32_t n_bits;
-};
+static struct struct_type *
+struct_type_find(struct rte_swx_pipeline *p, const char *name)
+{
+	struct struct_type *elem;
 
-TAILQ_HEAD(struct_type_tailq, struct_type);
+	TAILQ_FOREACH(elem, &p->struct_types, node)
+		if (strcmp(elem->name, name) == 0)
+			return elem;
 
-/*
- * Input port.
- */
-struct port_in_type {
-	TAILQ_ENTRY(port_in_type) node;
-	char name[RTE_SWX_NAME_SIZE];
-	struct rte_swx_port_in_ops ops;
-};
+	return NULL;
+}
 
-TAILQ_HEAD(port_in_type_tailq, port_in_type);
+static struct field *
+struct_type_field_find(struct struct_type *st, const char *name)
+{
+	uint32_t i;
 
-struct port_in {
-	TAILQ_ENTRY(port_in) node;
-	struct port_in_type *type;
-	void *obj;
-	uint32_t id;
-};
+	for (i = 0; i < st->n_fields; i++) {
+		struct field *f = &st->fields[i];
 
-TAILQ_HEAD(port_in_tailq, port_in);
+		if (strcmp(f->name, name) == 0)
+			return f;
+	}
 
-struct port_in_runtime {
-	rte_swx_port_in_pkt_rx_t pkt_rx;
-	void *obj;
-};
+	return NULL;
+}
 
-/*
- * Output port.
- */
-struct port_out_type {
-	TAILQ_ENTRY(port_out_type) node;
-	char name[RTE_SWX_NAME_SIZE];
-	struct rte_swx_port_out_ops ops;
-};
+int
+rte_swx_pipeline_struct_type_register(struct rte_swx_pipeline *p,
+				      const char *name,
+				      struct rte_swx_field_params *fields,
+				      uint32_t n_fields)
+{
+	struct struct_type *st;
+	uint32_t i;
 
-TAILQ_HEAD(port_out_type_tailq, port_out_type);
+	CHECK(p, EINVAL);
+	CHECK_NAME(name, EINVAL);
+	CHECK(fields, EINVAL);
+	CHECK(n_fields, EINVAL);
 
-struct port_out {
-	TAILQ_ENTRY(port_out) node;
-	struct port_out_type *type;
-	void *obj;
-	uint32_t id;
-};
+	for (i = 0; i < n_fields; i++) {
+		struct rte_swx_field_params *f = &fields[i];
+		uint32_t j;
 
-TAILQ_HEAD(port_out_tailq, port_out);
+		CHECK_NAME(f->name, EINVAL);
+		CHECK(f->n_bits, EINVAL);
+		CHECK(f->n_bits <= 64, EINVAL);
+		CHECK((f->n_bits & 7) == 0, EINVAL);
 
-struct port_out_runtime {
-	rte_swx_port_out_pkt_tx_t pkt_tx;
-	rte_swx_port_out_flush_t flush;
-	void *obj;
-};
+		for (j = 0; j < i; j++) {
+			struct rte_swx_field_params *f_prev = &fields[j];
 
-/*
- * Extern object.
- */
-struct extern_type_member_func {
-	TAILQ_ENTRY(extern_type_member_func) node;
-	char name[RTE_SWX_NAME_SIZE];
-	rte_swx_extern_type_member_func_t func;
-	uint32_t id;
-};
+			CHECK(strcmp(f->name, f_prev->name), EINVAL);
+		}
+	}
 
-TAILQ_HEAD(extern_type_member_func_tailq, extern_type_member_func);
+	CHECK(!struct_type_find(p, name), EEXIST);
 
-struct extern_type {
-	TAILQ_ENTRY(extern_type) node;
-	char name[RTE_SWX_NAME_SIZE];
-	struct struct_type *mailbox_struct_type;
-	rte_swx_extern_type_constructor_t constructor;
-	rte_swx_extern_type_destructor_t destructor;
-	struct extern_type_member_func_tailq funcs;
-	uint32_t n_funcs;
-};
+	/* Node allocation. */
+	st = calloc(1, sizeof(struct struct_type));
+	CHECK(st, ENOMEM);
 
-TAILQ_HEAD(extern_type_tailq, extern_type);
+	st->fields = calloc(n_fields, sizeof(struct field));
+	if (!st->fields) {
+		free(st);
+		CHECK(0, ENOMEM);
+	}
 
-struct extern_obj {
-	TAILQ_ENTRY(extern_obj) node;
-	char name[RTE_SWX_NAME_SIZE];
-	struct extern_type *type;
-	void *obj;
-	uint32_t struct_id;
-	uint32_t id;
-};
+	/* Node initialization. */
+	strcpy(st->name, name);
+	for (i = 0; i < n_fields; i++) {
+		struct field *dst = &st->fields[i];
+		struct rte_swx_field_params *src = &fields[i];
 
-TAILQ_HEAD(extern_obj_tailq, extern_obj);
+		strcpy(dst->name, src->name);
+		dst->n_bits = src->n_bits;
+		dst->offset = st->n_bits;
 
-#ifndef RTE_SWX_EXTERN_TYPE_MEMBER_FUNCS_MAX
-#define RTE_SWX_EXTERN_TYPE_MEMBER_FUNCS_MAX 8
-#endif
+		st->n_bits += src->n_bits;
+	}
+	st->n_fields = n_fields;
 
-struct extern_obj_runtime {
-	void *obj;
-	uint8_t *mailbox;
-	rte_swx_extern_type_member_func_t funcs[RTE_SWX_EXTERN_TYPE_MEMBER_FUNCS_MAX];
-};
+	/* Node add to tailq. */
+	TAILQ_INSERT_TAIL(&p->struct_types, st, node);
 
-/*
- * Extern function.
- */
-struct extern_func {
-	TAILQ_ENTRY(extern_func) node;
-	char name[RTE_SWX_NAME_SIZE];
-	struct struct_type *mailbox_struct_type;
-	rte_swx_extern_func_t func;
-	uint32_t struct_id;
-	uint32_t id;
-};
+	return 0;
+}
 
-TAILQ_HEAD(extern_func_tailq, extern_func);
+static int
+struct_build(struct rte_swx_pipeline *p)
+{
+	uint32_t i;
 
-struct extern_func_runtime {
-	uint8_t *mailbox;
-	rte_swx_extern_func_t func;
-};
+	for (i = 0; i < RTE_SWX_PIPELINE_THREADS_MAX; i++) {
+		struct thread *t = &p->threads[i];
 
-/*
- * Header.
- */
-struct header {
-	TAILQ_ENTRY(header) node;
-	char name[RTE_SWX_NAME_SIZE];
-	struct struct_type *st;
-	uint32_t struct_id;
-	uint32_t id;
-};
+		t->structs = calloc(p->n_structs, sizeof(uint8_t *));
+		CHECK(t->structs, ENOMEM);
+	}
 
-TAILQ_HEAD(header_tailq, header);
+	return 0;
+}
 
-struct header_runtime {
-	uint8_t *ptr0;
-};
+static void
+struct_build_free(struct rte_swx_pipeline *p)
+{
+	uint32_t i;
 
-struct header_out_runtime {
-	uint8_t *ptr0;
-	uint8_t *ptr;
-	uint32_t n_bytes;
-};
+	for (i = 0; i < RTE_SWX_PIPELINE_THREADS_MAX; i++) {
+		struct thread *t = &p->threads[i];
 
-/*
- * Instruction.
- */
+		free(t->structs);
+		t->structs = NULL;
+	}
+}
 
-/* Packet headers are always in Network Byte Order (NBO), i.e. big endian.
- * Packet meta-data fields are always assumed to be in Host Byte Order (HBO).
- * Table entry fields can be in either NBO or HBO; they are assumed to be in HBO
- * when transferred to packet meta-data and in NBO when transferred to packet
- * headers.
- */
+static void
+struct_free(struct rte_swx_pipeline *p)
+{
+	struct_build_free(p);
 
-/* Notation conventions:
- *    -Header field: H = h.header.field (dst/src)
- *    -Meta-data field: M = m.field (dst/src)
- *    -Extern object mailbox field: E = e.field (dst/src)
- *    -Extern function mailbox field: F = f.field (dst/src)
- *    -Table action data field: T = t.field (src only)
- *    -Immediate value: I = 32-bit unsigned value (src only)
- */
+	/* Struct types. */
+	for ( ; ; ) {
+		struct struct_type *elem;
 
-enum instruction_type {
-	/* rx m.port_in */
-	INSTR_RX,
+		elem = TAILQ_FIRST(&p->struct_types);
+		if (!elem)
+			break;
 
-	/* tx port_out
-	 * port_out = MI
-	 */
-	INSTR_TX,   /* port_out = M */
-	INSTR_TX_I, /* port_out = I */
-
-	/* extract h.header */
-	INSTR_HDR_EXTRACT,
-	INSTR_HDR_EXTRACT2,
-	INSTR_HDR_EXTRACT3,
-	INSTR_HDR_EXTRACT4,
-	INSTR_HDR_EXTRACT5,
-	INSTR_HDR_EXTRACT6,
-	INSTR_HDR_EXTRACT7,
-	INSTR_HDR_EXTRACT8,
-
-	/* emit h.header */
-	INSTR_HDR_EMIT,
-	INSTR_HDR_EMIT_TX,
-	INSTR_HDR_EMIT2_TX,
-	INSTR_HDR_EMIT3_TX,
-	INSTR_HDR_EMIT4_TX,
-	INSTR_HDR_EMIT5_TX,
-	INSTR_HDR_EMIT6_TX,
-	INSTR_HDR_EMIT7_TX,
-	INSTR_HDR_EMIT8_TX,
-
-	/* validate h.header */
-	INSTR_HDR_VALIDATE,
-
-	/* invalidate h.header */
-	INSTR_HDR_INVALIDATE,
-
-	/* mov dst src
-	 * dst = src
-	 * dst = HMEF, src = HMEFTI
-	 */
-	INSTR_MOV,    /* dst = MEF, src = MEFT */
-	INSTR_MOV_MH, /* dst = MEF, src = H */
-	INSTR_MOV_HM, /* dst = H, src = MEFT */
-	INSTR_MOV_HH, /* dst = H, src = H */
-	INSTR_MOV_I,  /* dst = HMEF, src = I */
-
-	/* dma h.header t.field
-	 * memcpy(h.header, t.field, sizeof(h.header))
-	 */
-	INSTR_DMA_HT,
-	INSTR_DMA_HT2,
-	INSTR_DMA_HT3,
-	INSTR_DMA_HT4,
-	INSTR_DMA_HT5,
-	INSTR_DMA_HT6,
-	INSTR_DMA_HT7,
-	INSTR_DMA_HT8,
-
-	/* add dst src
-	 * dst += src
-	 * dst = HMEF, src = HMEFTI
-	 */
-	INSTR_ALU_ADD,    /* dst = MEF, src = MEF */
-	INSTR_ALU_ADD_MH, /* dst = MEF, src = H */
-	INSTR_ALU_ADD_HM, /* dst = H, src = MEF */
-	INSTR_ALU_ADD_HH, /* dst = H, src = H */
-	INSTR_ALU_ADD_MI, /* dst = MEF, src = I */
-	INSTR_ALU_ADD_HI, /* dst = H, src = I */
-
-	/* sub dst src
-	 * dst -= src
-	 * dst = HMEF, src = HMEFTI
-	 */
-	INSTR_ALU_SUB,    /* dst = MEF, src = MEF */
-	INSTR_ALU_SUB_MH, /* dst = MEF, src = H */
-	INSTR_ALU_SUB_HM, /* dst = H, src = MEF */
-	INSTR_ALU_SUB_HH, /* dst = H, src = H */
-	INSTR_ALU_SUB_MI, /* dst = MEF, src = I */
-	INSTR_ALU_SUB_HI, /* dst = H, src = I */
-
-	/* ckadd dst src
-	 * dst = dst '+ src[0:1] '+ src[2:3] + ...
-	 * dst = H, src = {H, h.header}
-	 */
-	INSTR_ALU_CKADD_FIELD,    /* src = H */
-	INSTR_ALU_CKADD_STRUCT20, /* src = h.header, with sizeof(header) = 20 */
-	INSTR_ALU_CKADD_STRUCT,   /* src = h.hdeader, with any sizeof(header) */
+		TAILQ_REMOVE(&p->struct_types, elem, node);
+		free(elem->fields);
+		free(elem);
+	}
+}
 
-	/* cksub dst src
-	 * dst = dst '- src
-	 * dst = H, src = H
-	 */
-	INSTR_ALU_CKSUB_FIELD,
+/*
+ * Input port.
+ */
+static struct port_in_type *
+port_in_type_find(struct rte_swx_pipeline *p, const char *name)
+{
+	struct port_in_type *elem;
 
-	/* and dst src
-	 * dst &= src
-	 * dst = HMEF, src = HMEFTI
-	 */
-	INSTR_ALU_AND,    /* dst = MEF, src = MEFT */
-	INSTR_ALU_AND_MH, /* dst = MEF, src = H */
-	INSTR_ALU_AND_HM, /* dst = H, src = MEFT */
-	INSTR_ALU_AND_HH, /* dst = H, src = H */
-	INSTR_ALU_AND_I,  /* dst = HMEF, src = I */
-
-	/* or dst src
-	 * dst |= src
-	 * dst = HMEF, src = HMEFTI
-	 */
-	INSTR_ALU_OR,    /* dst = MEF, src = MEFT */
-	INSTR_ALU_OR_MH, /* dst = MEF, src = H */
-	INSTR_ALU_OR_HM, /* dst = H, src = MEFT */
-	INSTR_ALU_OR_HH, /* dst = H, src = H */
-	INSTR_ALU_OR_I,  /* dst = HMEF, src = I */
-
-	/* xor dst src
-	 * dst ^= src
-	 * dst = HMEF, src = HMEFTI
-	 */
-	INSTR_ALU_XOR,    /* dst = MEF, src = MEFT */
-	INSTR_ALU_XOR_MH, /* dst = MEF, src = H */
-	INSTR_ALU_XOR_HM, /* dst = H, src = MEFT */
-	INSTR_ALU_XOR_HH, /* dst = H, src = H */
-	INSTR_ALU_XOR_I,  /* dst = HMEF, src = I */
-
-	/* shl dst src
-	 * dst <<= src
-	 * dst = HMEF, src = HMEFTI
-	 */
-	INSTR_ALU_SHL,    /* dst = MEF, src = MEF */
-	INSTR_ALU_SHL_MH, /* dst = MEF, src = H */
-	INSTR_ALU_SHL_HM, /* dst = H, src = MEF */
-	INSTR_ALU_SHL_HH, /* dst = H, src = H */
-	INSTR_ALU_SHL_MI, /* dst = MEF, src = I */
-	INSTR_ALU_SHL_HI, /* dst = H, src = I */
-
-	/* shr dst src
-	 * dst >>= src
-	 * dst = HMEF, src = HMEFTI
-	 */
-	INSTR_ALU_SHR,    /* dst = MEF, src = MEF */
-	INSTR_ALU_SHR_MH, /* dst = MEF, src = H */
-	INSTR_ALU_SHR_HM, /* dst = H, src = MEF */
-	INSTR_ALU_SHR_HH, /* dst = H, src = H */
-	INSTR_ALU_SHR_MI, /* dst = MEF, src = I */
-	INSTR_ALU_SHR_HI, /* dst = H, src = I */
-
-	/* regprefetch REGARRAY index
-	 * prefetch REGARRAY[index]
-	 * index = HMEFTI
-	 */
-	INSTR_REGPREFETCH_RH, /* index = H */
-	INSTR_REGPREFETCH_RM, /* index = MEFT */
-	INSTR_REGPREFETCH_RI, /* index = I */
+	if (!name)
+		return NULL;
 
-	/* regrd dst REGARRAY index
-	 * dst = REGARRAY[index]
-	 * dst = HMEF, index = HMEFTI
-	 */
-	INSTR_REGRD_HRH, /* dst = H, index = H */
-	INSTR_REGRD_HRM, /* dst = H, index = MEFT */
-	INSTR_REGRD_HRI, /* dst = H, index = I */
-	INSTR_REGRD_MRH, /* dst = MEF, index = H */
-	INSTR_REGRD_MRM, /* dst = MEF, index = MEFT */
-	INSTR_REGRD_MRI, /* dst = MEF, index = I */
-
-	/* regwr REGARRAY index src
-	 * REGARRAY[index] = src
-	 * index = HMEFTI, src = HMEFTI
-	 */
-	INSTR_REGWR_RHH, /* index = H, src = H */
-	INSTR_REGWR_RHM, /* index = H, src = MEFT */
-	INSTR_REGWR_RHI, /* index = H, src = I */
-	INSTR_REGWR_RMH, /* index = MEFT, src = H */
-	INSTR_REGWR_RMM, /* index = MEFT, src = MEFT */
-	INSTR_REGWR_RMI, /* index = MEFT, src = I */
-	INSTR_REGWR_RIH, /* index = I, src = H */
-	INSTR_REGWR_RIM, /* index = I, src = MEFT */
-	INSTR_REGWR_RII, /* index = I, src = I */
-
-	/* regadd REGARRAY index src
-	 * REGARRAY[index] += src
-	 * index = HMEFTI, src = HMEFTI
-	 */
-	INSTR_REGADD_RHH, /* index = H, src = H */
-	INSTR_REGADD_RHM, /* index = H, src = MEFT */
-	INSTR_REGADD_RHI, /* index = H, src = I */
-	INSTR_REGADD_RMH, /* index = MEFT, src = H */
-	INSTR_REGADD_RMM, /* index = MEFT, src = MEFT */
-	INSTR_REGADD_RMI, /* index = MEFT, src = I */
-	INSTR_REGADD_RIH, /* index = I, src = H */
-	INSTR_REGADD_RIM, /* index = I, src = MEFT */
-	INSTR_REGADD_RII, /* index = I, src = I */
-
-	/* metprefetch METARRAY index
-	 * prefetch METARRAY[index]
-	 * index = HMEFTI
-	 */
-	INSTR_METPREFETCH_H, /* index = H */
-	INSTR_METPREFETCH_M, /* index = MEFT */
-	INSTR_METPREFETCH_I, /* index = I */
+	TAILQ_FOREACH(elem, &p->port_in_types, node)
+		if (strcmp(elem->name, name) == 0)
+			return elem;
 
-	/* meter METARRAY index length color_in color_out
-	 * color_out = meter(METARRAY[index], length, color_in)
-	 * index = HMEFTI, length = HMEFT, color_in = MEFTI, color_out = MEF
-	 */
-	INSTR_METER_HHM, /* index = H, length = H, color_in = MEFT */
-	INSTR_METER_HHI, /* index = H, length = H, color_in = I */
-	INSTR_METER_HMM, /* index = H, length = MEFT, color_in = MEFT */
-	INSTR_METER_HMI, /* index = H, length = MEFT, color_in = I */
-	INSTR_METER_MHM, /* index = MEFT, length = H, color_in = MEFT */
-	INSTR_METER_MHI, /* index = MEFT, length = H, color_in = I */
-	INSTR_METER_MMM, /* index = MEFT, length = MEFT, color_in = MEFT */
-	INSTR_METER_MMI, /* index = MEFT, length = MEFT, color_in = I */
-	INSTR_METER_IHM, /* index = I, length = H, color_in = MEFT */
-	INSTR_METER_IHI, /* index = I, length = H, color_in = I */
-	INSTR_METER_IMM, /* index = I, length = MEFT, color_in = MEFT */
-	INSTR_METER_IMI, /* index = I, length = MEFT, color_in = I */
-
-	/* table TABLE */
-	INSTR_TABLE,
-
-	/* extern e.obj.func */
-	INSTR_EXTERN_OBJ,
-
-	/* extern f.func */
-	INSTR_EXTERN_FUNC,
-
-	/* jmp LABEL
-	 * Unconditional jump
-	 */
-	INSTR_JMP,
+	return NULL;
+}
 
-	/* jmpv LABEL h.header
-	 * Jump if header is valid
-	 */
-	INSTR_JMP_VALID,
+int
+rte_swx_pipeline_port_in_type_register(struct rte_swx_pipeline *p,
+				       const char *name,
+				       struct rte_swx_port_in_ops *ops)
+{
+	struct port_in_type *elem;
 
-	/* jmpnv LABEL h.header
-	 * Jump if header is invalid
-	 */
-	INSTR_JMP_INVALID,
+	CHECK(p, EINVAL);
+	CHECK_NAME(name, EINVAL);
+	CHECK(ops, EINVAL);
+	CHECK(ops->create, EINVAL);
+	CHECK(ops->free, EINVAL);
+	CHECK(ops->pkt_rx, EINVAL);
+	CHECK(ops->stats_read, EINVAL);
 
-	/* jmph LABEL
-	 * Jump if table lookup hit
-	 */
-	INSTR_JMP_HIT,
+	CHECK(!port_in_type_find(p, name), EEXIST);
 
-	/* jmpnh LABEL
-	 * Jump if table lookup miss
-	 */
-	INSTR_JMP_MISS,
+	/* Node allocation. */
+	elem = calloc(1, sizeof(struct port_in_type));
+	CHECK(elem, ENOMEM);
 
-	/* jmpa LABEL ACTION
-	 * Jump if action run
-	 */
-	INSTR_JMP_ACTION_HIT,
+	/* Node initialization. */
+	strcpy(elem->name, name);
+	memcpy(&elem->ops, ops, sizeof(*ops));
 
-	/* jmpna LABEL ACTION
-	 * Jump if action not run
-	 */
-	INSTR_JMP_ACTION_MISS,
+	/* Node add to tailq. */
+	TAILQ_INSERT_TAIL(&p->port_in_types, elem, node);
 
-	/* jmpeq LABEL a b
-	 * Jump if a is equal to b
-	 * a = HMEFT, b = HMEFTI
-	 */
-	INSTR_JMP_EQ,    /* a = MEFT, b = MEFT */
-	INSTR_JMP_EQ_MH, /* a = MEFT, b = H */
-	INSTR_JMP_EQ_HM, /* a = H, b = MEFT */
-	INSTR_JMP_EQ_HH, /* a = H, b = H */
-	INSTR_JMP_EQ_I,  /* (a, b) = (MEFT, I) or (a, b) = (H, I) */
-
-	/* jmpneq LABEL a b
-	 * Jump if a is not equal to b
-	 * a = HMEFT, b = HMEFTI
-	 */
-	INSTR_JMP_NEQ,    /* a = MEFT, b = MEFT */
-	INSTR_JMP_NEQ_MH, /* a = MEFT, b = H */
-	INSTR_JMP_NEQ_HM, /* a = H, b = MEFT */
-	INSTR_JMP_NEQ_HH, /* a = H, b = H */
-	INSTR_JMP_NEQ_I,  /* (a, b) = (MEFT, I) or (a, b) = (H, I) */
-
-	/* jmplt LABEL a b
-	 * Jump if a is less than b
-	 * a = HMEFT, b = HMEFTI
-	 */
-	INSTR_JMP_LT,    /* a = MEFT, b = MEFT */
-	INSTR_JMP_LT_MH, /* a = MEFT, b = H */
-	INSTR_JMP_LT_HM, /* a = H, b = MEFT */
-	INSTR_JMP_LT_HH, /* a = H, b = H */
-	INSTR_JMP_LT_MI, /* a = MEFT, b = I */
-	INSTR_JMP_LT_HI, /* a = H, b = I */
-
-	/* jmpgt LABEL a b
-	 * Jump if a is greater than b
-	 * a = HMEFT, b = HMEFTI
-	 */
-	INSTR_JMP_GT,    /* a = MEFT, b = MEFT */
-	INSTR_JMP_GT_MH, /* a = MEFT, b = H */
-	INSTR_JMP_GT_HM, /* a = H, b = MEFT */
-	INSTR_JMP_GT_HH, /* a = H, b = H */
-	INSTR_JMP_GT_MI, /* a = MEFT, b = I */
-	INSTR_JMP_GT_HI, /* a = H, b = I */
-
-	/* return
-	 * Return from action
-	 */
-	INSTR_RETURN,
-};
+	return 0;
+}
 
-struct instr_operand {
-	uint8_t struct_id;
-	uint8_t n_bits;
-	uint8_t offset;
-	uint8_t pad;
-};
+static struct port_in *
+port_in_find(struct rte_swx_pipeline *p, uint32_t port_id)
+{
+	struct port_in *port;
 
-struct instr_io {
-	struct {
-		union {
-			struct {
-				uint8_t offset;
-				uint8_t n_bits;
-				uint8_t pad[2];
-			};
-
-			uint32_t val;
-		};
-	} io;
-
-	struct {
-		uint8_t header_id[8];
-		uint8_t struct_id[8];
-		uint8_t n_bytes[8];
-	} hdr;
-};
+	TAILQ_FOREACH(port, &p->ports_in, node)
+		if (port->id == port_id)
+			return port;
 
-struct instr_hdr_validity {
-	uint8_t header_id;
-};
+	return NULL;
+}
 
-struct instr_table {
-	uint8_t table_id;
-};
+int
+rte_swx_pipeline_port_in_config(struct rte_swx_pipeline *p,
+				uint32_t port_id,
+				const char *port_type_name,
+				void *args)
+{
+	struct port_in_type *type = NULL;
+	struct port_in *port = NULL;
+	void *obj = NULL;
 
-struct instr_extern_obj {
-	uint8_t ext_obj_id;
-	uint8_t func_id;
-};
+	CHECK(p, EINVAL);
 
-struct instr_extern_func {
-	uint8_t ext_func_id;
-};
+	CHECK(!port_in_find(p, port_id), EINVAL);
 
-struct instr_dst_src {
-	struct instr_operand dst;
-	union {
-		struct instr_operand src;
-		uint64_t src_val;
-	};
-};
+	CHECK_NAME(port_type_name, EINVAL);
+	type = port_in_type_find(p, port_type_name);
+	CHECK(type, EINVAL);
 
-struct instr_regarray {
-	uint8_t regarray_id;
-	uint8_t pad[3];
+	obj = type->ops.create(args);
+	CHECK(obj, ENODEV);
 
-	union {
-		struct instr_operand idx;
-		uint32_t idx_val;
-	};
+	/* Node allocation. */
+	port = calloc(1, sizeof(struct port_in));
+	CHECK(port, ENOMEM);
 
-	union {
-		struct instr_operand dstsrc;
-		uint64_t dstsrc_val;
-	};
-};
+	/* Node initialization. */
+	port->type = type;
+	port->obj = obj;
+	port->id = port_id;
 
-struct instr_meter {
-	uint8_t metarray_id;
-	uint8_t pad[3];
+	/* Node add to tailq. */
+	TAILQ_INSERT_TAIL(&p->ports_in, port, node);
+	if (p->n_ports_in < port_id + 1)
+		p->n_ports_in = port_id + 1;
 
-	union {
-		struct instr_operand idx;
-		uint32_t idx_val;
-	};
+	return 0;
+}
 
-	struct instr_operand length;
+static int
+port_in_build(struct rte_swx_pipeline *p)
+{
+	struct port_in *port;
+	uint32_t i;
 
-	union {
-		struct instr_operand color_in;
-		uint32_t color_in_val;
-	};
+	CHECK(p->n_ports_in, EINVAL);
+	CHECK(rte_is_power_of_2(p->n_ports_in), EINVAL);
 
-	struct instr_operand color_out;
-};
+	for (i = 0; i < p->n_ports_in; i++)
+		CHECK(port_in_find(p, i), EINVAL);
 
-struct instr_dma {
-	struct {
-		uint8_t header_id[8];
-		uint8_t struct_id[8];
-	} dst;
+	p->in = calloc(p->n_ports_in, sizeof(struct port_in_runtime));
+	CHECK(p->in, ENOMEM);
 
-	struct {
-		uint8_t offset[8];
-	} src;
+	TAILQ_FOREACH(port, &p->ports_in, node) {
+		struct port_in_runtime *in = &p->in[port->id];
 
-	uint16_t n_bytes[8];
-};
+		in->pkt_rx = port->type->ops.pkt_rx;
+		in->obj = port->obj;
+	}
 
-struct instr_jmp {
-	struct instruction *ip;
+	return 0;
+}
 
-	union {
-		struct instr_operand a;
-		uint8_t header_id;
-		uint8_t action_id;
-	};
+static void
+port_in_build_free(struct rte_swx_pipeline *p)
+{
+	free(p->in);
+	p->in = NULL;
+}
 
-	union {
-		struct instr_operand b;
-		uint64_t b_val;
-	};
-};
+static void
+port_in_free(struct rte_swx_pipeline *p)
+{
+	port_in_build_free(p);
 
-struct instruction {
-	enum instruction_type type;
-	union {
-		struct instr_io io;
-		struct instr_hdr_validity valid;
-		struct instr_dst_src mov;
-		struct instr_regarray regarray;
-		struct instr_meter meter;
-		struct instr_dma dma;
-		struct instr_dst_src alu;
-		struct instr_table table;
-		struct instr_extern_obj ext_obj;
-		struct instr_extern_func ext_func;
-		struct instr_jmp jmp;
-	};
-};
+	/* Input ports. */
+	for ( ; ; ) {
+		struct port_in *port;
 
-struct instruction_data {
-	char label[RTE_SWX_NAME_SIZE];
-	char jmp_label[RTE_SWX_NAME_SIZE];
-	uint32_t n_users; /* user = jmp instruction to this instruction. */
-	int invalid;
-};
+		port = TAILQ_FIRST(&p->ports_in);
+		if (!port)
+			break;
 
-/*
- * Action.
- */
-struct action {
-	TAILQ_ENTRY(action) node;
-	char name[RTE_SWX_NAME_SIZE];
-	struct struct_type *st;
-	int *args_endianness; /* 0 = Host Byte Order (HBO). */
-	struct instruction *instructions;
-	uint32_t n_instructions;
-	uint32_t id;
-};
+		TAILQ_REMOVE(&p->ports_in, port, node);
+		port->type->ops.free(port->obj);
+		free(port);
+	}
+
+	/* Input port types. */
+	for ( ; ; ) {
+		struct port_in_type *elem;
+
+		elem = TAILQ_FIRST(&p->port_in_types);
+		if (!elem)
+			break;
 
-TAILQ_HEAD(action_tailq, action);
+		TAILQ_REMOVE(&p->port_in_types, elem, node);
+		free(elem);
+	}
+}
 
 /*
- * Table.
+ * Output port.
  */
-struct table_type {
-	TAILQ_ENTRY(table_type) node;
-	char name[RTE_SWX_NAME_SIZE];
-	enum rte_swx_table_match_type match_type;
-	struct rte_swx_table_ops ops;
-};
+static struct port_out_type *
+port_out_type_find(struct rte_swx_pipeline *p, const char *name)
+{
+	struct port_out_type *elem;
 
-TAILQ_HEAD(table_type_tailq, table_type);
+	if (!name)
+		return NULL;
 
-struct match_field {
-	enum rte_swx_table_match_type match_type;
-	struct field *field;
-};
+	TAILQ_FOREACH(elem, &p->port_out_types, node)
+		if (!strcmp(elem->name, name))
+			return elem;
 
-struct table {
-	TAILQ_ENTRY(table) node;
-	char name[RTE_SWX_NAME_SIZE];
-	char args[RTE_SWX_NAME_SIZE];
-	struct table_type *type; /* NULL when n_fields == 0. */
+	return NULL;
+}
 
-	/* Match. */
-	struct match_field *fields;
-	uint32_t n_fields;
-	struct header *header; /* Only valid when n_fields > 0. */
+int
+rte_swx_pipeline_port_out_type_register(struct rte_swx_pipeline *p,
+					const char *name,
+					struct rte_swx_port_out_ops *ops)
+{
+	struct port_out_type *elem;
 
-	/* Action. */
-	struct action **actions;
-	struct action *default_action;
-	uint8_t *default_action_data;
-	uint32_t n_actions;
-	int default_action_is_const;
-	uint32_t action_data_size_max;
+	CHECK(p, EINVAL);
+	CHECK_NAME(name, EINVAL);
+	CHECK(ops, EINVAL);
+	CHECK(ops->create, EINVAL);
+	CHECK(ops->free, EINVAL);
+	CHECK(ops->pkt_tx, EINVAL);
+	CHECK(ops->stats_read, EINVAL);
 
-	uint32_t size;
-	uint32_t id;
-};
+	CHECK(!port_out_type_find(p, name), EEXIST);
 
-TAILQ_HEAD(table_tailq, table);
+	/* Node allocation. */
+	elem = calloc(1, sizeof(struct port_out_type));
+	CHECK(elem, ENOMEM);
 
-struct table_runtime {
-	rte_swx_table_lookup_t func;
-	void *mailbox;
-	uint8_t **key;
-};
+	/* Node initialization. */
+	strcpy(elem->name, name);
+	memcpy(&elem->ops, ops, sizeof(*ops));
 
-struct table_statistics {
-	uint64_t n_pkts_hit[2]; /* 0 = Miss, 1 = Hit. */
-	uint64_t *n_pkts_action;
-};
+	/* Node add to tailq. */
+	TAILQ_INSERT_TAIL(&p->port_out_types, elem, node);
 
-/*
- * Register array.
- */
-struct regarray {
-	TAILQ_ENTRY(regarray) node;
-	char name[RTE_SWX_NAME_SIZE];
-	uint64_t init_val;
-	uint32_t size;
-	uint32_t id;
-};
+	return 0;
+}
 
-TAILQ_HEAD(regarray_tailq, regarray);
+static struct port_out *
+port_out_find(struct rte_swx_pipeline *p, uint32_t port_id)
+{
+	struct port_out *port;
 
-struct regarray_runtime {
-	uint64_t *regarray;
-	uint32_t size_mask;
-};
+	TAILQ_FOREACH(port, &p->ports_out, node)
+		if (port->id == port_id)
+			return port;
 
-/*
- * Meter array.
- */
-struct meter_profile {
-	TAILQ_ENTRY(meter_profile) node;
-	char name[RTE_SWX_NAME_SIZE];
-	struct rte_meter_trtcm_params params;
-	struct rte_meter_trtcm_profile profile;
-	uint32_t n_users;
-};
+	return NULL;
+}
 
-TAILQ_HEAD(meter_profile_tailq, meter_profile);
+int
+rte_swx_pipeline_port_out_config(struct rte_swx_pipeline *p,
+				 uint32_t port_id,
+				 const char *port_type_name,
+				 void *args)
+{
+	struct port_out_type *type = NULL;
+	struct port_out *port = NULL;
+	void *obj = NULL;
 
-struct metarray {
-	TAILQ_ENTRY(metarray) node;
-	char name[RTE_SWX_NAME_SIZE];
-	uint32_t size;
-	uint32_t id;
-};
+	CHECK(p, EINVAL);
 
-TAILQ_HEAD(metarray_tailq, metarray);
+	CHECK(!port_out_find(p, port_id), EINVAL);
 
-struct meter {
-	struct rte_meter_trtcm m;
-	struct meter_profile *profile;
-	enum rte_color color_mask;
-	uint8_t pad[20];
+	CHECK_NAME(port_type_name, EINVAL);
+	type = port_out_type_find(p, port_type_name);
+	CHECK(type, EINVAL);
 
-	uint64_t n_pkts[RTE_COLORS];
-	uint64_t n_bytes[RTE_COLORS];
-};
+	obj = type->ops.create(args);
+	CHECK(obj, ENODEV);
 
-struct metarray_runtime {
-	struct meter *metarray;
-	uint32_t size_mask;
-};
+	/* Node allocation. */
+	port = calloc(1, sizeof(struct port_out));
+	CHECK(port, ENOMEM);
 
-/*
- * Pipeline.
- */
-struct thread {
-	/* Packet. */
-	struct rte_swx_pkt pkt;
-	uint8_t *ptr;
+	/* Node initialization. */
+	port->type = type;
+	port->obj = obj;
+	port->id = port_id;
 
-	/* Structures. */
-	uint8_t **structs;
+	/* Node add to tailq. */
+	TAILQ_INSERT_TAIL(&p->ports_out, port, node);
+	if (p->n_ports_out < port_id + 1)
+		p->n_ports_out = port_id + 1;
 
-	/* Packet headers. */
-	struct header_runtime *headers; /* Extracted or generated headers. */
-	struct header_out_runtime *headers_out; /* Emitted headers. */
-	uint8_t *header_storage;
-	uint8_t *header_out_storage;
-	uint64_t valid_headers;
-	uint32_t n_headers_out;
+	return 0;
+}
 
-	/* Packet meta-data. */
-	uint8_t *metadata;
+static int
+port_out_build(struct rte_swx_pipeline *p)
+{
+	struct port_out *port;
+	uint32_t i;
 
-	/* Tables. */
-	struct table_runtime *tables;
-	struct rte_swx_table_state *table_state;
-	uint64_t action_id;
-	int hit; /* 0 = Miss, 1 = Hit. */
-
-	/* Extern objects and functions. */
-	struct extern_obj_runtime *extern_objs;
-	struct extern_func_runtime *extern_funcs;
-
-	/* Instructions. */
-	struct instruction *ip;
-	struct instruction *ret;
-};
+	CHECK(p->n_ports_out, EINVAL);
 
-#define MASK64_BIT_GET(mask, pos) ((mask) & (1LLU << (pos)))
-#define MASK64_BIT_SET(mask, pos) ((mask) | (1LLU << (pos)))
-#define MASK64_BIT_CLR(mask, pos) ((mask) & ~(1LLU << (pos)))
-
-#define HEADER_VALID(thread, header_id) \
-	MASK64_BIT_GET((thread)->valid_headers, header_id)
-
-#define ALU(thread, ip, operator)  \
-{                                                                              \
-	uint8_t *dst_struct = (thread)->structs[(ip)->alu.dst.struct_id];      \
-	uint64_t *dst64_ptr = (uint64_t *)&dst_struct[(ip)->alu.dst.offset];   \
-	uint64_t dst64 = *dst64_ptr;                                           \
-	uint64_t dst64_mask = UINT64_MAX >> (64 - (ip)->alu.dst.n_bits);       \
-	uint64_t dst = dst64 & dst64_mask;                                     \
-									       \
-	uint8_t *src_struct = (thread)->structs[(ip)->alu.src.struct_id];      \
-	uint64_t *src64_ptr = (uint64_t *)&src_struct[(ip)->alu.src.offset];   \
-	uint64_t src64 = *src64_ptr;                                           \
-	uint64_t src64_mask = UINT64_MAX >> (64 - (ip)->alu.src.n_bits);       \
-	uint64_t src = src64 & src64_mask;                                     \
-									       \
-	uint64_t result = dst operator src;                                    \
-									       \
-	*dst64_ptr = (dst64 & ~dst64_mask) | (result & dst64_mask);            \
-}
-
-#if RTE_BYTE_ORDER == RTE_LITTLE_ENDIAN
-
-#define ALU_MH(thread, ip, operator)  \
-{                                                                              \
-	uint8_t *dst_struct = (thread)->structs[(ip)->alu.dst.struct_id];      \
-	uint64_t *dst64_ptr = (uint64_t *)&dst_struct[(ip)->alu.dst.offset];   \
-	uint64_t dst64 = *dst64_ptr;                                           \
-	uint64_t dst64_mask = UINT64_MAX >> (64 - (ip)->alu.dst.n_bits);       \
-	uint64_t dst = dst64 & dst64_mask;                                     \
-									       \
-	uint8_t *src_struct = (thread)->structs[(ip)->alu.src.struct_id];      \
-	uint64_t *src64_ptr = (uint64_t *)&src_struct[(ip)->alu.src.offset];   \
-	uint64_t src64 = *src64_ptr;                                           \
-	uint64_t src = ntoh64(src64) >> (64 - (ip)->alu.src.n_bits);           \
-									       \
-	uint64_t result = dst operator src;                                    \
-									       \
-	*dst64_ptr = (dst64 & ~dst64_mask) | (result & dst64_mask);            \
-}
-
-#define ALU_HM(thread, ip, operator)  \
-{                                                                              \
-	uint8_t *dst_struct = (thread)->structs[(ip)->alu.dst.struct_id];      \
-	uint64_t *dst64_ptr = (uint64_t *)&dst_struct[(ip)->alu.dst.offset];   \
-	uint64_t dst64 = *dst64_ptr;                                           \
-	uint64_t dst64_mask = UINT64_MAX >> (64 - (ip)->alu.dst.n_bits);       \
-	uint64_t dst = ntoh64(dst64) >> (64 - (ip)->alu.dst.n_bits);           \
-									       \
-	uint8_t *src_struct = (thread)->structs[(ip)->alu.src.struct_id];      \
-	uint64_t *src64_ptr = (uint64_t *)&src_struct[(ip)->alu.src.offset];   \
-	uint64_t src64 = *src64_ptr;                                           \
-	uint64_t src64_mask = UINT64_MAX >> (64 - (ip)->alu.src.n_bits);       \
-	uint64_t src = src64 & src64_mask;                                     \
-									       \
-	uint64_t result = dst operator src;                                    \
-	result = hton64(result << (64 - (ip)->alu.dst.n_bits));                \
-									       \
-	*dst64_ptr = (dst64 & ~dst64_mask) | result;                           \
-}
-
-#define ALU_HM_FAST(thread, ip, operator)  \
-{                                                                                 \
-	uint8_t *dst_struct = (thread)->structs[(ip)->alu.dst.struct_id];         \
-	uint64_t *dst64_ptr = (uint64_t *)&dst_struct[(ip)->alu.dst.offset];      \
-	uint64_t dst64 = *dst64_ptr;                                              \
-	uint64_t dst64_mask = UINT64_MAX >> (64 - (ip)->alu.dst.n_bits);          \
-	uint64_t dst = dst64 & dst64_mask;                                        \
-										  \
-	uint8_t *src_struct = (thread)->structs[(ip)->alu.src.struct_id];         \
-	uint64_t *src64_ptr = (uint64_t *)&src_struct[(ip)->alu.src.offset];      \
-	uint64_t src64 = *src64_ptr;                                              \
-	uint64_t src64_mask = UINT64_MAX >> (64 - (ip)->alu.src.n_bits);          \
-	uint64_t src = hton64(src64 & src64_mask) >> (64 - (ip)->alu.dst.n_bits); \
-										  \
-	uint64_t result = dst operator src;                                       \
-										  \
-	*dst64_ptr = (dst64 & ~dst64_mask) | result;                              \
-}
-
-#define ALU_HH(thread, ip, operator)  \
-{                                                                              \
-	uint8_t *dst_struct = (thread)->structs[(ip)->alu.dst.struct_id];      \
-	uint64_t *dst64_ptr = (uint64_t *)&dst_struct[(ip)->alu.dst.offset];   \
-	uint64_t dst64 = *dst64_ptr;                                           \
-	uint64_t dst64_mask = UINT64_MAX >> (64 - (ip)->alu.dst.n_bits);       \
-	uint64_t dst = ntoh64(dst64) >> (64 - (ip)->alu.dst.n_bits);           \
-									       \
-	uint8_t *src_struct = (thread)->structs[(ip)->alu.src.struct_id];      \
-	uint64_t *src64_ptr = (uint64_t *)&src_struct[(ip)->alu.src.offset];   \
-	uint64_t src64 = *src64_ptr;                                           \
-	uint64_t src = ntoh64(src64) >> (64 - (ip)->alu.src.n_bits);           \
-									       \
-	uint64_t result = dst operator src;                                    \
-	result = hton64(result << (64 - (ip)->alu.dst.n_bits));                \
-									       \
-	*dst64_ptr = (dst64 & ~dst64_mask) | result;                           \
-}
-
-#define ALU_HH_FAST(thread, ip, operator)  \
-{                                                                                             \
-	uint8_t *dst_struct = (thread)->structs[(ip)->alu.dst.struct_id];                     \
-	uint64_t *dst64_ptr = (uint64_t *)&dst_struct[(ip)->alu.dst.offset];                  \
-	uint64_t dst64 = *dst64_ptr;                                                          \
-	uint64_t dst64_mask = UINT64_MAX >> (64 - (ip)->alu.dst.n_bits);                      \
-	uint64_t dst = dst64 & dst64_mask;                                                    \
-											      \
-	uint8_t *src_struct = (thread)->structs[(ip)->alu.src.struct_id];                     \
-	uint64_t *src64_ptr = (uint64_t *)&src_struct[(ip)->alu.src.offset];                  \
-	uint64_t src64 = *src64_ptr;                                                          \
-	uint64_t src = (src64 << (64 - (ip)->alu.src.n_bits)) >> (64 - (ip)->alu.dst.n_bits); \
-											      \
-	uint64_t result = dst operator src;                                                   \
-											      \
-	*dst64_ptr = (dst64 & ~dst64_mask) | result;                                          \
-}
+	for (i = 0; i < p->n_ports_out; i++)
+		CHECK(port_out_find(p, i), EINVAL);
 
-#else
+	p->out = calloc(p->n_ports_out, sizeof(struct port_out_runtime));
+	CHECK(p->out, ENOMEM);
 
-#define ALU_MH ALU
-#define ALU_HM ALU
-#define ALU_HM_FAST ALU
-#define ALU_HH ALU
-#define ALU_HH_FAST ALU
+	TAILQ_FOREACH(port, &p->ports_out, node) {
+		struct port_out_runtime *out = &p->out[port->id];
 
-#endif
+		out->pkt_tx = port->type->ops.pkt_tx;
+		out->flush = port->type->ops.flush;
+		out->obj = port->obj;
+	}
 
-#define ALU_I(thread, ip, operator)  \
-{                                                                              \
-	uint8_t *dst_struct = (thread)->structs[(ip)->alu.dst.struct_id];      \
-	uint64_t *dst64_ptr = (uint64_t *)&dst_struct[(ip)->alu.dst.offset];   \
-	uint64_t dst64 = *dst64_ptr;                                           \
-	uint64_t dst64_mask = UINT64_MAX >> (64 - (ip)->alu.dst.n_bits);       \
-	uint64_t dst = dst64 & dst64_mask;                                     \
-									       \
-	uint64_t src = (ip)->alu.src_val;                                      \
-									       \
-	uint64_t result = dst operator src;                                    \
-									       \
-	*dst64_ptr = (dst64 & ~dst64_mask) | (result & dst64_mask);            \
-}
-
-#define ALU_MI ALU_I
-
-#if RTE_BYTE_ORDER == RTE_LITTLE_ENDIAN
-
-#define ALU_HI(thread, ip, operator)  \
-{                                                                              \
-	uint8_t *dst_struct = (thread)->structs[(ip)->alu.dst.struct_id];      \
-	uint64_t *dst64_ptr = (uint64_t *)&dst_struct[(ip)->alu.dst.offset];   \
-	uint64_t dst64 = *dst64_ptr;                                           \
-	uint64_t dst64_mask = UINT64_MAX >> (64 - (ip)->alu.dst.n_bits);       \
-	uint64_t dst = ntoh64(dst64) >> (64 - (ip)->alu.dst.n_bits);           \
-									       \
-	uint64_t src = (ip)->alu.src_val;                                      \
-									       \
-	uint64_t result = dst operator src;                                    \
-	result = hton64(result << (64 - (ip)->alu.dst.n_bits));                \
-									       \
-	*dst64_ptr = (dst64 & ~dst64_mask) | result;                           \
+	return 0;
 }
 
-#else
+static void
+port_out_build_free(struct rte_swx_pipeline *p)
+{
+	free(p->out);
+	p->out = NULL;
+}
 
-#define ALU_HI ALU_I
+static void
+port_out_free(struct rte_swx_pipeline *p)
+{
+	port_out_build_free(p);
 
-#endif
+	/* Output ports. */
+	for ( ; ; ) {
+		struct port_out *port;
 
-#define MOV(thread, ip)  \
-{                                                                              \
-	uint8_t *dst_struct = (thread)->structs[(ip)->mov.dst.struct_id];      \
-	uint64_t *dst64_ptr = (uint64_t *)&dst_struct[(ip)->mov.dst.offset];   \
-	uint64_t dst64 = *dst64_ptr;                                           \
-	uint64_t dst64_mask = UINT64_MAX >> (64 - (ip)->mov.dst.n_bits);       \
-									       \
-	uint8_t *src_struct = (thread)->structs[(ip)->mov.src.struct_id];      \
-	uint64_t *src64_ptr = (uint64_t *)&src_struct[(ip)->mov.src.offset];   \
-	uint64_t src64 = *src64_ptr;                                           \
-	uint64_t src64_mask = UINT64_MAX >> (64 - (ip)->mov.src.n_bits);       \
-	uint64_t src = src64 & src64_mask;                                     \
-									       \
-	*dst64_ptr = (dst64 & ~dst64_mask) | (src & dst64_mask);               \
-}
-
-#if RTE_BYTE_ORDER == RTE_LITTLE_ENDIAN
-
-#define MOV_MH(thread, ip)  \
-{                                                                              \
-	uint8_t *dst_struct = (thread)->structs[(ip)->mov.dst.struct_id];      \
-	uint64_t *dst64_ptr = (uint64_t *)&dst_struct[(ip)->mov.dst.offset];   \
-	uint64_t dst64 = *dst64_ptr;                                           \
-	uint64_t dst64_mask = UINT64_MAX >> (64 - (ip)->mov.dst.n_bits);       \
-									       \
-	uint8_t *src_struct = (thread)->structs[(ip)->mov.src.struct_id];      \
-	uint64_t *src64_ptr = (uint64_t *)&src_struct[(ip)->mov.src.offset];   \
-	uint64_t src64 = *src64_ptr;                                           \
-	uint64_t src = ntoh64(src64) >> (64 - (ip)->mov.src.n_bits);           \
-									       \
-	*dst64_ptr = (dst64 & ~dst64_mask) | (src & dst64_mask);               \
-}
-
-#define MOV_HM(thread, ip)  \
-{                                                                              \
-	uint8_t *dst_struct = (thread)->structs[(ip)->mov.dst.struct_id];      \
-	uint64_t *dst64_ptr = (uint64_t *)&dst_struct[(ip)->mov.dst.offset];   \
-	uint64_t dst64 = *dst64_ptr;                                           \
-	uint64_t dst64_mask = UINT64_MAX >> (64 - (ip)->mov.dst.n_bits);       \
-									       \
-	uint8_t *src_struct = (thread)->structs[(ip)->mov.src.struct_id];      \
-	uint64_t *src64_ptr = (uint64_t *)&src_struct[(ip)->mov.src.offset];   \
-	uint64_t src64 = *src64_ptr;                                           \
-	uint64_t src64_mask = UINT64_MAX >> (64 - (ip)->mov.src.n_bits);       \
-	uint64_t src = src64 & src64_mask;                                     \
-									       \
-	src = hton64(src) >> (64 - (ip)->mov.dst.n_bits);                      \
-	*dst64_ptr = (dst64 & ~dst64_mask) | src;                              \
-}
-
-#define MOV_HH(thread, ip)  \
-{                                                                              \
-	uint8_t *dst_struct = (thread)->structs[(ip)->mov.dst.struct_id];      \
-	uint64_t *dst64_ptr = (uint64_t *)&dst_struct[(ip)->mov.dst.offset];   \
-	uint64_t dst64 = *dst64_ptr;                                           \
-	uint64_t dst64_mask = UINT64_MAX >> (64 - (ip)->mov.dst.n_bits);       \
-									       \
-	uint8_t *src_struct = (thread)->structs[(ip)->mov.src.struct_id];      \
-	uint64_t *src64_ptr = (uint64_t *)&src_struct[(ip)->mov.src.offset];   \
-	uint64_t src64 = *src64_ptr;                                           \
-									       \
-	uint64_t src = src64 << (64 - (ip)->mov.src.n_bits);                   \
-	src = src >> (64 - (ip)->mov.dst.n_bits);                              \
-	*dst64_ptr = (dst64 & ~dst64_mask) | src;                              \
-}
+		port = TAILQ_FIRST(&p->ports_out);
+		if (!port)
+			break;
 
-#else
+		TAILQ_REMOVE(&p->ports_out, port, node);
+		port->type->ops.free(port->obj);
+		free(port);
+	}
 
-#define MOV_MH MOV
-#define MOV_HM MOV
-#define MOV_HH MOV
+	/* Output port types. */
+	for ( ; ; ) {
+		struct port_out_type *elem;
 
-#endif
+		elem = TAILQ_FIRST(&p->port_out_types);
+		if (!elem)
+			break;
 
-#define MOV_I(thread, ip)  \
-{                                                                              \
-	uint8_t *dst_struct = (thread)->structs[(ip)->mov.dst.struct_id];      \
-	uint64_t *dst64_ptr = (uint64_t *)&dst_struct[(ip)->mov.dst.offset];   \
-	uint64_t dst64 = *dst64_ptr;                                           \
-	uint64_t dst64_mask = UINT64_MAX >> (64 - (ip)->mov.dst.n_bits);       \
-									       \
-	uint64_t src = (ip)->mov.src_val;                                      \
-									       \
-	*dst64_ptr = (dst64 & ~dst64_mask) | (src & dst64_mask);               \
-}
-
-#define JMP_CMP(thread, ip, operator)  \
-{                                                                              \
-	uint8_t *a_struct = (thread)->structs[(ip)->jmp.a.struct_id];          \
-	uint64_t *a64_ptr = (uint64_t *)&a_struct[(ip)->jmp.a.offset];         \
-	uint64_t a64 = *a64_ptr;                                               \
-	uint64_t a64_mask = UINT64_MAX >> (64 - (ip)->jmp.a.n_bits);           \
-	uint64_t a = a64 & a64_mask;                                           \
-									       \
-	uint8_t *b_struct = (thread)->structs[(ip)->jmp.b.struct_id];          \
-	uint64_t *b64_ptr = (uint64_t *)&b_struct[(ip)->jmp.b.offset];         \
-	uint64_t b64 = *b64_ptr;                                               \
-	uint64_t b64_mask = UINT64_MAX >> (64 - (ip)->jmp.b.n_bits);           \
-	uint64_t b = b64 & b64_mask;                                           \
-									       \
-	(thread)->ip = (a operator b) ? (ip)->jmp.ip : ((thread)->ip + 1);     \
-}
-
-#if RTE_BYTE_ORDER == RTE_LITTLE_ENDIAN
-
-#define JMP_CMP_MH(thread, ip, operator)  \
-{                                                                              \
-	uint8_t *a_struct = (thread)->structs[(ip)->jmp.a.struct_id];          \
-	uint64_t *a64_ptr = (uint64_t *)&a_struct[(ip)->jmp.a.offset];         \
-	uint64_t a64 = *a64_ptr;                                               \
-	uint64_t a64_mask = UINT64_MAX >> (64 - (ip)->jmp.a.n_bits);           \
-	uint64_t a = a64 & a64_mask;                                           \
-									       \
-	uint8_t *b_struct = (thread)->structs[(ip)->jmp.b.struct_id];          \
-	uint64_t *b64_ptr = (uint64_t *)&b_struct[(ip)->jmp.b.offset];         \
-	uint64_t b64 = *b64_ptr;                                               \
-	uint64_t b = ntoh64(b64) >> (64 - (ip)->jmp.b.n_bits);                 \
-									       \
-	(thread)->ip = (a operator b) ? (ip)->jmp.ip : ((thread)->ip + 1);     \
-}
-
-#define JMP_CMP_HM(thread, ip, operator)  \
-{                                                                              \
-	uint8_t *a_struct = (thread)->structs[(ip)->jmp.a.struct_id];          \
-	uint64_t *a64_ptr = (uint64_t *)&a_struct[(ip)->jmp.a.offset];         \
-	uint64_t a64 = *a64_ptr;                                               \
-	uint64_t a = ntoh64(a64) >> (64 - (ip)->jmp.a.n_bits);                 \
-									       \
-	uint8_t *b_struct = (thread)->structs[(ip)->jmp.b.struct_id];          \
-	uint64_t *b64_ptr = (uint64_t *)&b_struct[(ip)->jmp.b.offset];         \
-	uint64_t b64 = *b64_ptr;                                               \
-	uint64_t b64_mask = UINT64_MAX >> (64 - (ip)->jmp.b.n_bits);           \
-	uint64_t b = b64 & b64_mask;                                           \
-									       \
-	(thread)->ip = (a operator b) ? (ip)->jmp.ip : ((thread)->ip + 1);     \
-}
-
-#define JMP_CMP_HH(thread, ip, operator)  \
-{                                                                              \
-	uint8_t *a_struct = (thread)->structs[(ip)->jmp.a.struct_id];          \
-	uint64_t *a64_ptr = (uint64_t *)&a_struct[(ip)->jmp.a.offset];         \
-	uint64_t a64 = *a64_ptr;                                               \
-	uint64_t a = ntoh64(a64) >> (64 - (ip)->jmp.a.n_bits);                 \
-									       \
-	uint8_t *b_struct = (thread)->structs[(ip)->jmp.b.struct_id];          \
-	uint64_t *b64_ptr = (uint64_t *)&b_struct[(ip)->jmp.b.offset];         \
-	uint64_t b64 = *b64_ptr;                                               \
-	uint64_t b = ntoh64(b64) >> (64 - (ip)->jmp.b.n_bits);                 \
-									       \
-	(thread)->ip = (a operator b) ? (ip)->jmp.ip : ((thread)->ip + 1);     \
-}
-
-#define JMP_CMP_HH_FAST(thread, ip, operator)  \
-{                                                                              \
-	uint8_t *a_struct = (thread)->structs[(ip)->jmp.a.struct_id];          \
-	uint64_t *a64_ptr = (uint64_t *)&a_struct[(ip)->jmp.a.offset];         \
-	uint64_t a64 = *a64_ptr;                                               \
-	uint64_t a = a64 << (64 - (ip)->jmp.a.n_bits);                         \
-									       \
-	uint8_t *b_struct = (thread)->structs[(ip)->jmp.b.struct_id];          \
-	uint64_t *b64_ptr = (uint64_t *)&b_struct[(ip)->jmp.b.offset];         \
-	uint64_t b64 = *b64_ptr;                                               \
-	uint64_t b = b64 << (64 - (ip)->jmp.b.n_bits);                         \
-									       \
-	(thread)->ip = (a operator b) ? (ip)->jmp.ip : ((thread)->ip + 1);     \
+		TAILQ_REMOVE(&p->port_out_types, elem, node);
+		free(elem);
+	}
 }
 
-#else
-
-#define JMP_CMP_MH JMP_CMP
-#define JMP_CMP_HM JMP_CMP
-#define JMP_CMP_HH JMP_CMP
-#define JMP_CMP_HH_FAST JMP_CMP
+/*
+ * Extern object.
+ */
+static struct extern_type *
+extern_type_find(struct rte_swx_pipeline *p, const char *name)
+{
+	struct extern_type *elem;
 
-#endif
+	TAILQ_FOREACH(elem, &p->extern_types, node)
+		if (strcmp(elem->name, name) == 0)
+			return elem;
 
-#define JMP_CMP_I(thread, ip, operator)  \
-{                                                                              \
-	uint8_t *a_struct = (thread)->structs[(ip)->jmp.a.struct_id];          \
-	uint64_t *a64_ptr = (uint64_t *)&a_struct[(ip)->jmp.a.offset];         \
-	uint64_t a64 = *a64_ptr;                                               \
-	uint64_t a64_mask = UINT64_MAX >> (64 - (ip)->jmp.a.n_bits);           \
-	uint64_t a = a64 & a64_mask;                                           \
-									       \
-	uint64_t b = (ip)->jmp.b_val;                                          \
-									       \
-	(thread)->ip = (a operator b) ? (ip)->jmp.ip : ((thread)->ip + 1);     \
+	return NULL;
 }
 
-#define JMP_CMP_MI JMP_CMP_I
-
-#if RTE_BYTE_ORDER == RTE_LITTLE_ENDIAN
-
-#define JMP_CMP_HI(thread, ip, operator)  \
-{                                                                              \
-	uint8_t *a_struct = (thread)->structs[(ip)->jmp.a.struct_id];          \
-	uint64_t *a64_ptr = (uint64_t *)&a_struct[(ip)->jmp.a.offset];         \
-	uint64_t a64 = *a64_ptr;                                               \
-	uint64_t a = ntoh64(a64) >> (64 - (ip)->jmp.a.n_bits);                 \
-									       \
-	uint64_t b = (ip)->jmp.b_val;                                          \
-									       \
-	(thread)->ip = (a operator b) ? (ip)->jmp.ip : ((thread)->ip + 1);     \
-}
-
-#else
-
-#define JMP_CMP_HI JMP_CMP_I
-
-#endif
-
-#define METADATA_READ(thread, offset, n_bits)                                  \
-({                                                                             \
-	uint64_t *m64_ptr = (uint64_t *)&(thread)->metadata[offset];           \
-	uint64_t m64 = *m64_ptr;                                               \
-	uint64_t m64_mask = UINT64_MAX >> (64 - (n_bits));                     \
-	(m64 & m64_mask);                                                      \
-})
-
-#define METADATA_WRITE(thread, offset, n_bits, value)                          \
-{                                                                              \
-	uint64_t *m64_ptr = (uint64_t *)&(thread)->metadata[offset];           \
-	uint64_t m64 = *m64_ptr;                                               \
-	uint64_t m64_mask = UINT64_MAX >> (64 - (n_bits));                     \
-									       \
-	uint64_t m_new = value;                                                \
-									       \
-	*m64_ptr = (m64 & ~m64_mask) | (m_new & m64_mask);                     \
-}
-
-#ifndef RTE_SWX_PIPELINE_THREADS_MAX
-#define RTE_SWX_PIPELINE_THREADS_MAX 16
-#endif
-
-struct rte_swx_pipeline {
-	struct struct_type_tailq struct_types;
-	struct port_in_type_tailq port_in_types;
-	struct port_in_tailq ports_in;
-	struct port_out_type_tailq port_out_types;
-	struct port_out_tailq ports_out;
-	struct extern_type_tailq extern_types;
-	struct extern_obj_tailq extern_objs;
-	struct extern_func_tailq extern_funcs;
-	struct header_tailq headers;
-	struct struct_type *metadata_st;
-	uint32_t metadata_struct_id;
-	struct action_tailq actions;
-	struct table_type_tailq table_types;
-	struct table_tailq tables;
-	struct regarray_tailq regarrays;
-	struct meter_profile_tailq meter_profiles;
-	struct metarray_tailq metarrays;
-
-	struct port_in_runtime *in;
-	struct port_out_runtime *out;
-	struct instruction **action_instructions;
-	struct rte_swx_table_state *table_state;
-	struct table_statistics *table_stats;
-	struct regarray_runtime *regarray_runtime;
-	struct metarray_runtime *metarray_runtime;
-	struct instruction *instructions;
-	struct thread threads[RTE_SWX_PIPELINE_THREADS_MAX];
-
-	uint32_t n_structs;
-	uint32_t n_ports_in;
-	uint32_t n_ports_out;
-	uint32_t n_extern_objs;
-	uint32_t n_extern_funcs;
-	uint32_t n_actions;
-	uint32_t n_tables;
-	uint32_t n_regarrays;
-	uint32_t n_metarrays;
-	uint32_t n_headers;
-	uint32_t thread_id;
-	uint32_t port_id;
-	uint32_t n_instructions;
-	int build_done;
-	int numa_node;
-};
-
-/*
- * Struct.
- */
-static struct struct_type *
-struct_type_find(struct rte_swx_pipeline *p, const char *name)
+static struct extern_type_member_func *
+extern_type_member_func_find(struct extern_type *type, const char *name)
 {
-	struct struct_type *elem;
+	struct extern_type_member_func *elem;
 
-	TAILQ_FOREACH(elem, &p->struct_types, node)
+	TAILQ_FOREACH(elem, &type->funcs, node)
 		if (strcmp(elem->name, name) == 0)
 			return elem;
 
 	return NULL;
 }
 
-static struct field *
-struct_type_field_find(struct struct_type *st, const char *name)
+static struct extern_obj *
+extern_obj_find(struct rte_swx_pipeline *p, const char *name)
 {
-	uint32_t i;
-
-	for (i = 0; i < st->n_fields; i++) {
-		struct field *f = &st->fields[i];
+	struct extern_obj *elem;
 
-		if (strcmp(f->name, name) == 0)
-			return f;
-	}
+	TAILQ_FOREACH(elem, &p->extern_objs, node)
+		if (strcmp(elem->name, name) == 0)
+			return elem;
 
 	return NULL;
 }
 
-int
-rte_swx_pipeline_struct_type_register(struct rte_swx_pipeline *p,
-				      const char *name,
-				      struct rte_swx_field_params *fields,
-				      uint32_t n_fields)
+static struct extern_type_member_func *
+extern_obj_member_func_parse(struct rte_swx_pipeline *p,
+			     const char *name,
+			     struct extern_obj **obj)
 {
-	struct struct_type *st;
-	uint32_t i;
-
-	CHECK(p, EINVAL);
-	CHECK_NAME(name, EINVAL);
-	CHECK(fields, EINVAL);
-	CHECK(n_fields, EINVAL);
-
-	for (i = 0; i < n_fields; i++) {
-		struct rte_swx_field_params *f = &fields[i];
-		uint32_t j;
+	struct extern_obj *object;
+	struct extern_type_member_func *func;
+	char *object_name, *func_name;
 
-		CHECK_NAME(f->name, EINVAL);
-		CHECK(f->n_bits, EINVAL);
-		CHECK(f->n_bits <= 64, EINVAL);
-		CHECK((f->n_bits & 7) == 0, EINVAL);
+	if (name[0] != 'e' || name[1] != '.')
+		return NULL;
 
-		for (j = 0; j < i; j++) {
-			struct rte_swx_field_params *f_prev = &fields[j];
+	object_name = strdup(&name[2]);
+	if (!object_name)
+		return NULL;
 
-			CHECK(strcmp(f->name, f_prev->name), EINVAL);
-		}
+	func_name = strchr(object_name, '.');
+	if (!func_name) {
+		free(object_name);
+		return NULL;
 	}
 
-	CHECK(!struct_type_find(p, name), EEXIST);
-
-	/* Node allocation. */
-	st = calloc(1, sizeof(struct struct_type));
-	CHECK(st, ENOMEM);
+	*func_name = 0;
+	func_name++;
 
-	st->fields = calloc(n_fields, sizeof(struct field));
-	if (!st->fields) {
-		free(st);
-		CHECK(0, ENOMEM);
+	object = extern_obj_find(p, object_name);
+	if (!object) {
+		free(object_name);
+		return NULL;
 	}
 
-	/* Node initialization. */
-	strcpy(st->name, name);
-	for (i = 0; i < n_fields; i++) {
-		struct field *dst = &st->fields[i];
-		struct rte_swx_field_params *src = &fields[i];
-
-		strcpy(dst->name, src->name);
-		dst->n_bits = src->n_bits;
-		dst->offset = st->n_bits;
-
-		st->n_bits += src->n_bits;
+	func = extern_type_member_func_find(object->type, func_name);
+	if (!func) {
+		free(object_name);
+		return NULL;
 	}
-	st->n_fields = n_fields;
 
-	/* Node add to tailq. */
-	TAILQ_INSERT_TAIL(&p->struct_types, st, node);
+	if (obj)
+		*obj = object;
 
-	return 0;
+	free(object_name);
+	return func;
 }
 
-static int
-struct_build(struct rte_swx_pipeline *p)
+static struct field *
+extern_obj_mailbox_field_parse(struct rte_swx_pipeline *p,
+			       const char *name,
+			       struct extern_obj **object)
 {
-	uint32_t i;
-
-	for (i = 0; i < RTE_SWX_PIPELINE_THREADS_MAX; i++) {
-		struct thread *t = &p->threads[i];
-
-		t->structs = calloc(p->n_structs, sizeof(uint8_t *));
-		CHECK(t->structs, ENOMEM);
-	}
-
-	return 0;
-}
+	struct extern_obj *obj;
+	struct field *f;
+	char *obj_name, *field_name;
 
-static void
-struct_build_free(struct rte_swx_pipeline *p)
-{
-	uint32_t i;
+	if ((name[0] != 'e') || (name[1] != '.'))
+		return NULL;
 
-	for (i = 0; i < RTE_SWX_PIPELINE_THREADS_MAX; i++) {
-		struct thread *t = &p->threads[i];
+	obj_name = strdup(&name[2]);
+	if (!obj_name)
+		return NULL;
 
-		free(t->structs);
-		t->structs = NULL;
+	field_name = strchr(obj_name, '.');
+	if (!field_name) {
+		free(obj_name);
+		return NULL;
 	}
-}
-
-static void
-struct_free(struct rte_swx_pipeline *p)
-{
-	struct_build_free(p);
-
-	/* Struct types. */
-	for ( ; ; ) {
-		struct struct_type *elem;
 
-		elem = TAILQ_FIRST(&p->struct_types);
-		if (!elem)
-			break;
+	*field_name = 0;
+	field_name++;
 
-		TAILQ_REMOVE(&p->struct_types, elem, node);
-		free(elem->fields);
-		free(elem);
+	obj = extern_obj_find(p, obj_name);
+	if (!obj) {
+		free(obj_name);
+		return NULL;
 	}
-}
-
-/*
- * Input port.
- */
-static struct port_in_type *
-port_in_type_find(struct rte_swx_pipeline *p, const char *name)
-{
-	struct port_in_type *elem;
 
-	if (!name)
+	f = struct_type_field_find(obj->type->mailbox_struct_type, field_name);
+	if (!f) {
+		free(obj_name);
 		return NULL;
+	}
 
-	TAILQ_FOREACH(elem, &p->port_in_types, node)
-		if (strcmp(elem->name, name) == 0)
-			return elem;
+	if (object)
+		*object = obj;
 
-	return NULL;
+	free(obj_name);
+	return f;
 }
 
 int
-rte_swx_pipeline_port_in_type_register(struct rte_swx_pipeline *p,
-				       const char *name,
-				       struct rte_swx_port_in_ops *ops)
+rte_swx_pipeline_extern_type_register(struct rte_swx_pipeline *p,
+	const char *name,
+	const char *mailbox_struct_type_name,
+	rte_swx_extern_type_constructor_t constructor,
+	rte_swx_extern_type_destructor_t destructor)
 {
-	struct port_in_type *elem;
+	struct extern_type *elem;
+	struct struct_type *mailbox_struct_type;
 
 	CHECK(p, EINVAL);
+
 	CHECK_NAME(name, EINVAL);
-	CHECK(ops, EINVAL);
-	CHECK(ops->create, EINVAL);
-	CHECK(ops->free, EINVAL);
-	CHECK(ops->pkt_rx, EINVAL);
-	CHECK(ops->stats_read, EINVAL);
+	CHECK(!extern_type_find(p, name), EEXIST);
 
-	CHECK(!port_in_type_find(p, name), EEXIST);
+	CHECK_NAME(mailbox_struct_type_name, EINVAL);
+	mailbox_struct_type = struct_type_find(p, mailbox_struct_type_name);
+	CHECK(mailbox_struct_type, EINVAL);
+
+	CHECK(constructor, EINVAL);
+	CHECK(destructor, EINVAL);
 
 	/* Node allocation. */
-	elem = calloc(1, sizeof(struct port_in_type));
+	elem = calloc(1, sizeof(struct extern_type));
 	CHECK(elem, ENOMEM);
 
 	/* Node initialization. */
 	strcpy(elem->name, name);
-	memcpy(&elem->ops, ops, sizeof(*ops));
+	elem->mailbox_struct_type = mailbox_struct_type;
+	elem->constructor = constructor;
+	elem->destructor = destructor;
+	TAILQ_INIT(&elem->funcs);
 
 	/* Node add to tailq. */
-	TAILQ_INSERT_TAIL(&p->port_in_types, elem, node);
+	TAILQ_INSERT_TAIL(&p->extern_types, elem, node);
 
 	return 0;
 }
 
-static struct port_in *
-port_in_find(struct rte_swx_pipeline *p, uint32_t port_id)
+int
+rte_swx_pipeline_extern_type_member_func_register(struct rte_swx_pipeline *p,
+	const char *extern_type_name,
+	const char *name,
+	rte_swx_extern_type_member_func_t member_func)
 {
-	struct port_in *port;
+	struct extern_type *type;
+	struct extern_type_member_func *type_member;
 
-	TAILQ_FOREACH(port, &p->ports_in, node)
-		if (port->id == port_id)
-			return port;
+	CHECK(p, EINVAL);
 
-	return NULL;
-}
+	CHECK_NAME(extern_type_name, EINVAL);
+	type = extern_type_find(p, extern_type_name);
+	CHECK(type, EINVAL);
+	CHECK(type->n_funcs < RTE_SWX_EXTERN_TYPE_MEMBER_FUNCS_MAX, ENOSPC);
 
-int
-rte_swx_pipeline_port_in_config(struct rte_swx_pipeline *p,
-				uint32_t port_id,
-				const char *port_type_name,
-				void *args)
+	CHECK_NAME(name, EINVAL);
+	CHECK(!extern_type_member_func_find(type, name), EEXIST);
+
+	CHECK(member_func, EINVAL);
+
+	/* Node allocation. */
+	type_member = calloc(1, sizeof(struct extern_type_member_func));
+	CHECK(type_member, ENOMEM);
+
+	/* Node initialization. */
+	strcpy(type_member->name, name);
+	type_member->func = member_func;
+	type_member->id = type->n_funcs;
+
+	/* Node add to tailq. */
+	TAILQ_INSERT_TAIL(&type->funcs, type_member, node);
+	type->n_funcs++;
+
+	return 0;
+}
+
+int
+rte_swx_pipeline_extern_object_config(struct rte_swx_pipeline *p,
+				      const char *extern_type_name,
+				      const char *name,
+				      const char *args)
 {
-	struct port_in_type *type = NULL;
-	struct port_in *port = NULL;
-	void *obj = NULL;
+	struct extern_type *type;
+	struct extern_obj *obj;
+	void *obj_handle;
 
 	CHECK(p, EINVAL);
 
-	CHECK(!port_in_find(p, port_id), EINVAL);
-
-	CHECK_NAME(port_type_name, EINVAL);
-	type = port_in_type_find(p, port_type_name);
+	CHECK_NAME(extern_type_name, EINVAL);
+	type = extern_type_find(p, extern_type_name);
 	CHECK(type, EINVAL);
 
-	obj = type->ops.create(args);
-	CHECK(obj, ENODEV);
+	CHECK_NAME(name, EINVAL);
+	CHECK(!extern_obj_find(p, name), EEXIST);
 
 	/* Node allocation. */
-	port = calloc(1, sizeof(struct port_in));
-	CHECK(port, ENOMEM);
+	obj = calloc(1, sizeof(struct extern_obj));
+	CHECK(obj, ENOMEM);
+
+	/* Object construction. */
+	obj_handle = type->constructor(args);
+	if (!obj_handle) {
+		free(obj);
+		CHECK(0, ENODEV);
+	}
 
 	/* Node initialization. */
-	port->type = type;
-	port->obj = obj;
-	port->id = port_id;
+	strcpy(obj->name, name);
+	obj->type = type;
+	obj->obj = obj_handle;
+	obj->struct_id = p->n_structs;
+	obj->id = p->n_extern_objs;
 
 	/* Node add to tailq. */
-	TAILQ_INSERT_TAIL(&p->ports_in, port, node);
-	if (p->n_ports_in < port_id + 1)
-		p->n_ports_in = port_id + 1;
+	TAILQ_INSERT_TAIL(&p->extern_objs, obj, node);
+	p->n_extern_objs++;
+	p->n_structs++;
 
 	return 0;
 }
 
 static int
-port_in_build(struct rte_swx_pipeline *p)
+extern_obj_build(struct rte_swx_pipeline *p)
 {
-	struct port_in *port;
 	uint32_t i;
 
-	CHECK(p->n_ports_in, EINVAL);
-	CHECK(rte_is_power_of_2(p->n_ports_in), EINVAL);
+	for (i = 0; i < RTE_SWX_PIPELINE_THREADS_MAX; i++) {
+		struct thread *t = &p->threads[i];
+		struct extern_obj *obj;
 
-	for (i = 0; i < p->n_ports_in; i++)
-		CHECK(port_in_find(p, i), EINVAL);
+		t->extern_objs = calloc(p->n_extern_objs,
+					sizeof(struct extern_obj_runtime));
+		CHECK(t->extern_objs, ENOMEM);
 
-	p->in = calloc(p->n_ports_in, sizeof(struct port_in_runtime));
-	CHECK(p->in, ENOMEM);
+		TAILQ_FOREACH(obj, &p->extern_objs, node) {
+			struct extern_obj_runtime *r =
+				&t->extern_objs[obj->id];
+			struct extern_type_member_func *func;
+			uint32_t mailbox_size =
+				obj->type->mailbox_struct_type->n_bits / 8;
 
-	TAILQ_FOREACH(port, &p->ports_in, node) {
-		struct port_in_runtime *in = &p->in[port->id];
+			r->obj = obj->obj;
 
-		in->pkt_rx = port->type->ops.pkt_rx;
-		in->obj = port->obj;
+			r->mailbox = calloc(1, mailbox_size);
+			CHECK(r->mailbox, ENOMEM);
+
+			TAILQ_FOREACH(func, &obj->type->funcs, node)
+				r->funcs[func->id] = func->func;
+
+			t->structs[obj->struct_id] = r->mailbox;
+		}
 	}
 
 	return 0;
 }
 
 static void
-port_in_build_free(struct rte_swx_pipeline *p)
+extern_obj_build_free(struct rte_swx_pipeline *p)
 {
-	free(p->in);
-	p->in = NULL;
+	uint32_t i;
+
+	for (i = 0; i < RTE_SWX_PIPELINE_THREADS_MAX; i++) {
+		struct thread *t = &p->threads[i];
+		uint32_t j;
+
+		if (!t->extern_objs)
+			continue;
+
+		for (j = 0; j < p->n_extern_objs; j++) {
+			struct extern_obj_runtime *r = &t->extern_objs[j];
+
+			free(r->mailbox);
+		}
+
+		free(t->extern_objs);
+		t->extern_objs = NULL;
+	}
 }
 
 static void
-port_in_free(struct rte_swx_pipeline *p)
+extern_obj_free(struct rte_swx_pipeline *p)
 {
-	port_in_build_free(p);
+	extern_obj_build_free(p);
 
-	/* Input ports. */
+	/* Extern objects. */
 	for ( ; ; ) {
-		struct port_in *port;
+		struct extern_obj *elem;
 
-		port = TAILQ_FIRST(&p->ports_in);
-		if (!port)
+		elem = TAILQ_FIRST(&p->extern_objs);
+		if (!elem)
 			break;
 
-		TAILQ_REMOVE(&p->ports_in, port, node);
-		port->type->ops.free(port->obj);
-		free(port);
+		TAILQ_REMOVE(&p->extern_objs, elem, node);
+		if (elem->obj)
+			elem->type->destructor(elem->obj);
+		free(elem);
 	}
 
-	/* Input port types. */
+	/* Extern types. */
 	for ( ; ; ) {
-		struct port_in_type *elem;
+		struct extern_type *elem;
 
-		elem = TAILQ_FIRST(&p->port_in_types);
+		elem = TAILQ_FIRST(&p->extern_types);
 		if (!elem)
 			break;
 
-		TAILQ_REMOVE(&p->port_in_types, elem, node);
+		TAILQ_REMOVE(&p->extern_types, elem, node);
+
+		for ( ; ; ) {
+			struct extern_type_member_func *func;
+
+			func = TAILQ_FIRST(&elem->funcs);
+			if (!func)
+				break;
+
+			TAILQ_REMOVE(&elem->funcs, func, node);
+			free(func);
+		}
+
 		free(elem);
 	}
 }
 
 /*
- * Output port.
+ * Extern function.
  */
-static struct port_out_type *
-port_out_type_find(struct rte_swx_pipeline *p, const char *name)
+static struct extern_func *
+extern_func_find(struct rte_swx_pipeline *p, const char *name)
 {
-	struct port_out_type *elem;
-
-	if (!name)
-		return NULL;
+	struct extern_func *elem;
 
-	TAILQ_FOREACH(elem, &p->port_out_types, node)
-		if (!strcmp(elem->name, name))
+	TAILQ_FOREACH(elem, &p->extern_funcs, node)
+		if (strcmp(elem->name, name) == 0)
 			return elem;
 
 	return NULL;
 }
 
-int
-rte_swx_pipeline_port_out_type_register(struct rte_swx_pipeline *p,
-					const char *name,
-					struct rte_swx_port_out_ops *ops)
+static struct extern_func *
+extern_func_parse(struct rte_swx_pipeline *p,
+		  const char *name)
 {
-	struct port_out_type *elem;
+	if (name[0] != 'f' || name[1] != '.')
+		return NULL;
 
-	CHECK(p, EINVAL);
-	CHECK_NAME(name, EINVAL);
-	CHECK(ops, EINVAL);
-	CHECK(ops->create, EINVAL);
-	CHECK(ops->free, EINVAL);
-	CHECK(ops->pkt_tx, EINVAL);
-	CHECK(ops->stats_read, EINVAL);
+	return extern_func_find(p, &name[2]);
+}
 
-	CHECK(!port_out_type_find(p, name), EEXIST);
+static struct field *
+extern_func_mailbox_field_parse(struct rte_swx_pipeline *p,
+				const char *name,
+				struct extern_func **function)
+{
+	struct extern_func *func;
+	struct field *f;
+	char *func_name, *field_name;
 
-	/* Node allocation. */
-	elem = calloc(1, sizeof(struct port_out_type));
-	CHECK(elem, ENOMEM);
+	if ((name[0] != 'f') || (name[1] != '.'))
+		return NULL;
 
-	/* Node initialization. */
-	strcpy(elem->name, name);
-	memcpy(&elem->ops, ops, sizeof(*ops));
+	func_name = strdup(&name[2]);
+	if (!func_name)
+		return NULL;
 
-	/* Node add to tailq. */
-	TAILQ_INSERT_TAIL(&p->port_out_types, elem, node);
+	field_name = strchr(func_name, '.');
+	if (!field_name) {
+		free(func_name);
+		return NULL;
+	}
 
-	return 0;
-}
+	*field_name = 0;
+	field_name++;
 
-static struct port_out *
-port_out_find(struct rte_swx_pipeline *p, uint32_t port_id)
-{
-	struct port_out *port;
+	func = extern_func_find(p, func_name);
+	if (!func) {
+		free(func_name);
+		return NULL;
+	}
 
-	TAILQ_FOREACH(port, &p->ports_out, node)
-		if (port->id == port_id)
-			return port;
+	f = struct_type_field_find(func->mailbox_struct_type, field_name);
+	if (!f) {
+		free(func_name);
+		return NULL;
+	}
 
-	return NULL;
+	if (function)
+		*function = func;
+
+	free(func_name);
+	return f;
 }
 
 int
-rte_swx_pipeline_port_out_config(struct rte_swx_pipeline *p,
-				 uint32_t port_id,
-				 const char *port_type_name,
-				 void *args)
+rte_swx_pipeline_extern_func_register(struct rte_swx_pipeline *p,
+				      const char *name,
+				      const char *mailbox_struct_type_name,
+				      rte_swx_extern_func_t func)
 {
-	struct port_out_type *type = NULL;
-	struct port_out *port = NULL;
-	void *obj = NULL;
+	struct extern_func *f;
+	struct struct_type *mailbox_struct_type;
 
 	CHECK(p, EINVAL);
 
-	CHECK(!port_out_find(p, port_id), EINVAL);
+	CHECK_NAME(name, EINVAL);
+	CHECK(!extern_func_find(p, name), EEXIST);
 
-	CHECK_NAME(port_type_name, EINVAL);
-	type = port_out_type_find(p, port_type_name);
-	CHECK(type, EINVAL);
+	CHECK_NAME(mailbox_struct_type_name, EINVAL);
+	mailbox_struct_type = struct_type_find(p, mailbox_struct_type_name);
+	CHECK(mailbox_struct_type, EINVAL);
 
-	obj = type->ops.create(args);
-	CHECK(obj, ENODEV);
+	CHECK(func, EINVAL);
 
 	/* Node allocation. */
-	port = calloc(1, sizeof(struct port_out));
-	CHECK(port, ENOMEM);
+	f = calloc(1, sizeof(struct extern_func));
+	CHECK(func, ENOMEM);
 
 	/* Node initialization. */
-	port->type = type;
-	port->obj = obj;
-	port->id = port_id;
+	strcpy(f->name, name);
+	f->mailbox_struct_type = mailbox_struct_type;
+	f->func = func;
+	f->struct_id = p->n_structs;
+	f->id = p->n_extern_funcs;
 
 	/* Node add to tailq. */
-	TAILQ_INSERT_TAIL(&p->ports_out, port, node);
-	if (p->n_ports_out < port_id + 1)
-		p->n_ports_out = port_id + 1;
+	TAILQ_INSERT_TAIL(&p->extern_funcs, f, node);
+	p->n_extern_funcs++;
+	p->n_structs++;
 
 	return 0;
 }
 
 static int
-port_out_build(struct rte_swx_pipeline *p)
+extern_func_build(struct rte_swx_pipeline *p)
 {
-	struct port_out *port;
 	uint32_t i;
 
-	CHECK(p->n_ports_out, EINVAL);
+	for (i = 0; i < RTE_SWX_PIPELINE_THREADS_MAX; i++) {
+		struct thread *t = &p->threads[i];
+		struct extern_func *func;
 
-	for (i = 0; i < p->n_ports_out; i++)
-		CHECK(port_out_find(p, i), EINVAL);
+		/* Memory allocation. */
+		t->extern_funcs = calloc(p->n_extern_funcs,
+					 sizeof(struct extern_func_runtime));
+		CHECK(t->extern_funcs, ENOMEM);
 
-	p->out = calloc(p->n_ports_out, sizeof(struct port_out_runtime));
-	CHECK(p->out, ENOMEM);
+		/* Extern function. */
+		TAILQ_FOREACH(func, &p->extern_funcs, node) {
+			struct extern_func_runtime *r =
+				&t->extern_funcs[func->id];
+			uint32_t mailbox_size =
+				func->mailbox_struct_type->n_bits / 8;
 
-	TAILQ_FOREACH(port, &p->ports_out, node) {
-		struct port_out_runtime *out = &p->out[port->id];
+			r->func = func->func;
 
-		out->pkt_tx = port->type->ops.pkt_tx;
-		out->flush = port->type->ops.flush;
-		out->obj = port->obj;
+			r->mailbox = calloc(1, mailbox_size);
+			CHECK(r->mailbox, ENOMEM);
+
+			t->structs[func->struct_id] = r->mailbox;
+		}
 	}
 
 	return 0;
 }
 
 static void
-port_out_build_free(struct rte_swx_pipeline *p)
+extern_func_build_free(struct rte_swx_pipeline *p)
 {
-	free(p->out);
-	p->out = NULL;
-}
+	uint32_t i;
 
-static void
-port_out_free(struct rte_swx_pipeline *p)
-{
-	port_out_build_free(p);
+	for (i = 0; i < RTE_SWX_PIPELINE_THREADS_MAX; i++) {
+		struct thread *t = &p->threads[i];
+		uint32_t j;
 
-	/* Output ports. */
-	for ( ; ; ) {
-		struct port_out *port;
+		if (!t->extern_funcs)
+			continue;
 
-		port = TAILQ_FIRST(&p->ports_out);
-		if (!port)
-			break;
+		for (j = 0; j < p->n_extern_funcs; j++) {
+			struct extern_func_runtime *r = &t->extern_funcs[j];
 
-		TAILQ_REMOVE(&p->ports_out, port, node);
-		port->type->ops.free(port->obj);
-		free(port);
+			free(r->mailbox);
+		}
+
+		free(t->extern_funcs);
+		t->extern_funcs = NULL;
 	}
+}
+
+static void
+extern_func_free(struct rte_swx_pipeline *p)
+{
+	extern_func_build_free(p);
 
-	/* Output port types. */
 	for ( ; ; ) {
-		struct port_out_type *elem;
+		struct extern_func *elem;
 
-		elem = TAILQ_FIRST(&p->port_out_types);
+		elem = TAILQ_FIRST(&p->extern_funcs);
 		if (!elem)
 			break;
 
-		TAILQ_REMOVE(&p->port_out_types, elem, node);
+		TAILQ_REMOVE(&p->extern_funcs, elem, node);
 		free(elem);
 	}
 }
 
 /*
- * Extern object.
+ * Header.
  */
-static struct extern_type *
-extern_type_find(struct rte_swx_pipeline *p, const char *name)
-{
-	struct extern_type *elem;
-
-	TAILQ_FOREACH(elem, &p->extern_types, node)
-		if (strcmp(elem->name, name) == 0)
-			return elem;
-
-	return NULL;
-}
-
-static struct extern_type_member_func *
-extern_type_member_func_find(struct extern_type *type, const char *name)
+static struct header *
+header_find(struct rte_swx_pipeline *p, const char *name)
 {
-	struct extern_type_member_func *elem;
+	struct header *elem;
 
-	TAILQ_FOREACH(elem, &type->funcs, node)
+	TAILQ_FOREACH(elem, &p->headers, node)
 		if (strcmp(elem->name, name) == 0)
 			return elem;
 
 	return NULL;
 }
 
-static struct extern_obj *
-extern_obj_find(struct rte_swx_pipeline *p, const char *name)
+static struct header *
+header_find_by_struct_id(struct rte_swx_pipeline *p, uint32_t struct_id)
 {
-	struct extern_obj *elem;
+	struct header *elem;
 
-	TAILQ_FOREACH(elem, &p->extern_objs, node)
-		if (strcmp(elem->name, name) == 0)
+	TAILQ_FOREACH(elem, &p->headers, node)
+		if (elem->struct_id == struct_id)
 			return elem;
 
 	return NULL;
 }
 
-static struct extern_type_member_func *
-extern_obj_member_func_parse(struct rte_swx_pipeline *p,
-			     const char *name,
-			     struct extern_obj **obj)
+static struct header *
+header_parse(struct rte_swx_pipeline *p,
+	     const char *name)
 {
-	struct extern_obj *object;
-	struct extern_type_member_func *func;
-	char *object_name, *func_name;
-
-	if (name[0] != 'e' || name[1] != '.')
-		return NULL;
-
-	object_name = strdup(&name[2]);
-	if (!object_name)
-		return NULL;
-
-	func_name = strchr(object_name, '.');
-	if (!func_name) {
-		free(object_name);
-		return NULL;
-	}
-
-	*func_name = 0;
-	func_name++;
-
-	object = extern_obj_find(p, object_name);
-	if (!object) {
-		free(object_name);
-		return NULL;
-	}
-
-	func = extern_type_member_func_find(object->type, func_name);
-	if (!func) {
-		free(object_name);
+	if (name[0] != 'h' || name[1] != '.')
 		return NULL;
-	}
-
-	if (obj)
-		*obj = object;
 
-	free(object_name);
-	return func;
+	return header_find(p, &name[2]);
 }
 
 static struct field *
-extern_obj_mailbox_field_parse(struct rte_swx_pipeline *p,
-			       const char *name,
-			       struct extern_obj **object)
+header_field_parse(struct rte_swx_pipeline *p,
+		   const char *name,
+		   struct header **header)
 {
-	struct extern_obj *obj;
+	struct header *h;
 	struct field *f;
-	char *obj_name, *field_name;
+	char *header_name, *field_name;
 
-	if ((name[0] != 'e') || (name[1] != '.'))
+	if ((name[0] != 'h') || (name[1] != '.'))
 		return NULL;
 
-	obj_name = strdup(&name[2]);
-	if (!obj_name)
+	header_name = strdup(&name[2]);
+	if (!header_name)
 		return NULL;
 
-	field_name = strchr(obj_name, '.');
+	field_name = strchr(header_name, '.');
 	if (!field_name) {
-		free(obj_name);
+		free(header_name);
 		return NULL;
 	}
 
 	*field_name = 0;
 	field_name++;
 
-	obj = extern_obj_find(p, obj_name);
-	if (!obj) {
-		free(obj_name);
+	h = header_find(p, header_name);
+	if (!h) {
+		free(header_name);
 		return NULL;
 	}
 
-	f = struct_type_field_find(obj->type->mailbox_struct_type, field_name);
+	f = struct_type_field_find(h->st, field_name);
 	if (!f) {
-		free(obj_name);
+		free(header_name);
 		return NULL;
 	}
 
-	if (object)
-		*object = obj;
+	if (header)
+		*header = h;
 
-	free(obj_name);
+	free(header_name);
 	return f;
 }
 
 int
-rte_swx_pipeline_extern_type_register(struct rte_swx_pipeline *p,
-	const char *name,
-	const char *mailbox_struct_type_name,
-	rte_swx_extern_type_constructor_t constructor,
-	rte_swx_extern_type_destructor_t destructor)
+rte_swx_pipeline_packet_header_register(struct rte_swx_pipeline *p,
+					const char *name,
+					const char *struct_type_name)
 {
-	struct extern_type *elem;
-	struct struct_type *mailbox_struct_type;
+	struct struct_type *st;
+	struct header *h;
+	size_t n_headers_max;
 
 	CHECK(p, EINVAL);
-
 	CHECK_NAME(name, EINVAL);
-	CHECK(!extern_type_find(p, name), EEXIST);
+	CHECK_NAME(struct_type_name, EINVAL);
 
-	CHECK_NAME(mailbox_struct_type_name, EINVAL);
-	mailbox_struct_type = struct_type_find(p, mailbox_struct_type_name);
-	CHECK(mailbox_struct_type, EINVAL);
+	CHECK(!header_find(p, name), EEXIST);
 
-	CHECK(constructor, EINVAL);
-	CHECK(destructor, EINVAL);
+	st = struct_type_find(p, struct_type_name);
+	CHECK(st, EINVAL);
 
-	/* Node allocation. */
-	elem = calloc(1, sizeof(struct extern_type));
-	CHECK(elem, ENOMEM);
-
-	/* Node initialization. */
-	strcpy(elem->name, name);
-	elem->mailbox_struct_type = mailbox_struct_type;
-	elem->constructor = constructor;
-	elem->destructor = destructor;
-	TAILQ_INIT(&elem->funcs);
-
-	/* Node add to tailq. */
-	TAILQ_INSERT_TAIL(&p->extern_types, elem, node);
-
-	return 0;
-}
-
-int
-rte_swx_pipeline_extern_type_member_func_register(struct rte_swx_pipeline *p,
-	const char *extern_type_name,
-	const char *name,
-	rte_swx_extern_type_member_func_t member_func)
-{
-	struct extern_type *type;
-	struct extern_type_member_func *type_member;
-
-	CHECK(p, EINVAL);
-
-	CHECK_NAME(extern_type_name, EINVAL);
-	type = extern_type_find(p, extern_type_name);
-	CHECK(type, EINVAL);
-	CHECK(type->n_funcs < RTE_SWX_EXTERN_TYPE_MEMBER_FUNCS_MAX, ENOSPC);
-
-	CHECK_NAME(name, EINVAL);
-	CHECK(!extern_type_member_func_find(type, name), EEXIST);
-
-	CHECK(member_func, EINVAL);
-
-	/* Node allocation. */
-	type_member = calloc(1, sizeof(struct extern_type_member_func));
-	CHECK(type_member, ENOMEM);
-
-	/* Node initialization. */
-	strcpy(type_member->name, name);
-	type_member->func = member_func;
-	type_member->id = type->n_funcs;
-
-	/* Node add to tailq. */
-	TAILQ_INSERT_TAIL(&type->funcs, type_member, node);
-	type->n_funcs++;
-
-	return 0;
-}
-
-int
-rte_swx_pipeline_extern_object_config(struct rte_swx_pipeline *p,
-				      const char *extern_type_name,
-				      const char *name,
-				      const char *args)
-{
-	struct extern_type *type;
-	struct extern_obj *obj;
-	void *obj_handle;
-
-	CHECK(p, EINVAL);
-
-	CHECK_NAME(extern_type_name, EINVAL);
-	type = extern_type_find(p, extern_type_name);
-	CHECK(type, EINVAL);
-
-	CHECK_NAME(name, EINVAL);
-	CHECK(!extern_obj_find(p, name), EEXIST);
+	n_headers_max = RTE_SIZEOF_FIELD(struct thread, valid_headers) * 8;
+	CHECK(p->n_headers < n_headers_max, ENOSPC);
 
 	/* Node allocation. */
-	obj = calloc(1, sizeof(struct extern_obj));
-	CHECK(obj, ENOMEM);
-
-	/* Object construction. */
-	obj_handle = type->constructor(args);
-	if (!obj_handle) {
-		free(obj);
-		CHECK(0, ENODEV);
-	}
+	h = calloc(1, sizeof(struct header));
+	CHECK(h, ENOMEM);
 
 	/* Node initialization. */
-	strcpy(obj->name, name);
-	obj->type = type;
-	obj->obj = obj_handle;
-	obj->struct_id = p->n_structs;
-	obj->id = p->n_extern_objs;
+	strcpy(h->name, name);
+	h->st = st;
+	h->struct_id = p->n_structs;
+	h->id = p->n_headers;
 
 	/* Node add to tailq. */
-	TAILQ_INSERT_TAIL(&p->extern_objs, obj, node);
-	p->n_extern_objs++;
+	TAILQ_INSERT_TAIL(&p->headers, h, node);
+	p->n_headers++;
 	p->n_structs++;
 
 	return 0;
 }
 
 static int
-extern_obj_build(struct rte_swx_pipeline *p)
+header_build(struct rte_swx_pipeline *p)
 {
-	uint32_t i;
+	struct header *h;
+	uint32_t n_bytes = 0, i;
+
+	TAILQ_FOREACH(h, &p->headers, node) {
+		n_bytes += h->st->n_bits / 8;
+	}
 
 	for (i = 0; i < RTE_SWX_PIPELINE_THREADS_MAX; i++) {
 		struct thread *t = &p->threads[i];
-		struct extern_obj *obj;
+		uint32_t offset = 0;
 
-		t->extern_objs = calloc(p->n_extern_objs,
-					sizeof(struct extern_obj_runtime));
-		CHECK(t->extern_objs, ENOMEM);
+		t->headers = calloc(p->n_headers,
+				    sizeof(struct header_runtime));
+		CHECK(t->headers, ENOMEM);
 
-		TAILQ_FOREACH(obj, &p->extern_objs, node) {
-			struct extern_obj_runtime *r =
-				&t->extern_objs[obj->id];
-			struct extern_type_member_func *func;
-			uint32_t mailbox_size =
-				obj->type->mailbox_struct_type->n_bits / 8;
+		t->headers_out = calloc(p->n_headers,
+					sizeof(struct header_out_runtime));
+		CHECK(t->headers_out, ENOMEM);
 
-			r->obj = obj->obj;
+		t->header_storage = calloc(1, n_bytes);
+		CHECK(t->header_storage, ENOMEM);
 
-			r->mailbox = calloc(1, mailbox_size);
-			CHECK(r->mailbox, ENOMEM);
+		t->header_out_storage = calloc(1, n_bytes);
+		CHECK(t->header_out_storage, ENOMEM);
 
-			TAILQ_FOREACH(func, &obj->type->funcs, node)
-				r->funcs[func->id] = func->func;
+		TAILQ_FOREACH(h, &p->headers, node) {
+			uint8_t *header_storage;
 
-			t->structs[obj->struct_id] = r->mailbox;
+			header_storage = &t->header_storage[offset];
+			offset += h->st->n_bits / 8;
+
+			t->headers[h->id].ptr0 = header_storage;
+			t->structs[h->struct_id] = header_storage;
 		}
 	}
 
@@ -2086,1442 +1249,1119 @@ extern_obj_build(struct rte_swx_pipeline *p)
 }
 
 static void
-extern_obj_build_free(struct rte_swx_pipeline *p)
+header_build_free(struct rte_swx_pipeline *p)
 {
 	uint32_t i;
 
 	for (i = 0; i < RTE_SWX_PIPELINE_THREADS_MAX; i++) {
 		struct thread *t = &p->threads[i];
-		uint32_t j;
 
-		if (!t->extern_objs)
-			continue;
+		free(t->headers_out);
+		t->headers_out = NULL;
 
-		for (j = 0; j < p->n_extern_objs; j++) {
-			struct extern_obj_runtime *r = &t->extern_objs[j];
+		free(t->headers);
+		t->headers = NULL;
 
-			free(r->mailbox);
-		}
+		free(t->header_out_storage);
+		t->header_out_storage = NULL;
 
-		free(t->extern_objs);
-		t->extern_objs = NULL;
+		free(t->header_storage);
+		t->header_storage = NULL;
 	}
 }
 
 static void
-extern_obj_free(struct rte_swx_pipeline *p)
+header_free(struct rte_swx_pipeline *p)
 {
-	extern_obj_build_free(p);
+	header_build_free(p);
 
-	/* Extern objects. */
 	for ( ; ; ) {
-		struct extern_obj *elem;
+		struct header *elem;
 
-		elem = TAILQ_FIRST(&p->extern_objs);
+		elem = TAILQ_FIRST(&p->headers);
 		if (!elem)
 			break;
 
-		TAILQ_REMOVE(&p->extern_objs, elem, node);
-		if (elem->obj)
-			elem->type->destructor(elem->obj);
+		TAILQ_REMOVE(&p->headers, elem, node);
 		free(elem);
 	}
+}
 
-	/* Extern types. */
-	for ( ; ; ) {
-		struct extern_type *elem;
+/*
+ * Meta-data.
+ */
+static struct field *
+metadata_field_parse(struct rte_swx_pipeline *p, const char *name)
+{
+	if (!p->metadata_st)
+		return NULL;
 
-		elem = TAILQ_FIRST(&p->extern_types);
-		if (!elem)
-			break;
+	if (name[0] != 'm' || name[1] != '.')
+		return NULL;
 
-		TAILQ_REMOVE(&p->extern_types, elem, node);
+	return struct_type_field_find(p->metadata_st, &name[2]);
+}
 
-		for ( ; ; ) {
-			struct extern_type_member_func *func;
+int
+rte_swx_pipeline_packet_metadata_register(struct rte_swx_pipeline *p,
+					  const char *struct_type_name)
+{
+	struct struct_type *st = NULL;
 
-			func = TAILQ_FIRST(&elem->funcs);
-			if (!func)
-				break;
+	CHECK(p, EINVAL);
 
-			TAILQ_REMOVE(&elem->funcs, func, node);
-			free(func);
-		}
+	CHECK_NAME(struct_type_name, EINVAL);
+	st  = struct_type_find(p, struct_type_name);
+	CHECK(st, EINVAL);
+	CHECK(!p->metadata_st, EINVAL);
 
-		free(elem);
-	}
+	p->metadata_st = st;
+	p->metadata_struct_id = p->n_structs;
+
+	p->n_structs++;
+
+	return 0;
 }
 
-/*
- * Extern function.
- */
-static struct extern_func *
-extern_func_find(struct rte_swx_pipeline *p, const char *name)
+static int
+metadata_build(struct rte_swx_pipeline *p)
 {
-	struct extern_func *elem;
+	uint32_t n_bytes = p->metadata_st->n_bits / 8;
+	uint32_t i;
 
-	TAILQ_FOREACH(elem, &p->extern_funcs, node)
-		if (strcmp(elem->name, name) == 0)
-			return elem;
+	/* Thread-level initialization. */
+	for (i = 0; i < RTE_SWX_PIPELINE_THREADS_MAX; i++) {
+		struct thread *t = &p->threads[i];
+		uint8_t *metadata;
 
-	return NULL;
-}
+		metadata = calloc(1, n_bytes);
+		CHECK(metadata, ENOMEM);
 
-static struct extern_func *
-extern_func_parse(struct rte_swx_pipeline *p,
-		  const char *name)
-{
-	if (name[0] != 'f' || name[1] != '.')
-		return NULL;
+		t->metadata = metadata;
+		t->structs[p->metadata_struct_id] = metadata;
+	}
 
-	return extern_func_find(p, &name[2]);
+	return 0;
 }
 
-static struct field *
-extern_func_mailbox_field_parse(struct rte_swx_pipeline *p,
-				const char *name,
-				struct extern_func **function)
+static void
+metadata_build_free(struct rte_swx_pipeline *p)
 {
-	struct extern_func *func;
-	struct field *f;
-	char *func_name, *field_name;
+	uint32_t i;
 
-	if ((name[0] != 'f') || (name[1] != '.'))
-		return NULL;
-
-	func_name = strdup(&name[2]);
-	if (!func_name)
-		return NULL;
-
-	field_name = strchr(func_name, '.');
-	if (!field_name) {
-		free(func_name);
-		return NULL;
-	}
-
-	*field_name = 0;
-	field_name++;
-
-	func = extern_func_find(p, func_name);
-	if (!func) {
-		free(func_name);
-		return NULL;
-	}
+	for (i = 0; i < RTE_SWX_PIPELINE_THREADS_MAX; i++) {
+		struct thread *t = &p->threads[i];
 
-	f = struct_type_field_find(func->mailbox_struct_type, field_name);
-	if (!f) {
-		free(func_name);
-		return NULL;
+		free(t->metadata);
+		t->metadata = NULL;
 	}
-
-	if (function)
-		*function = func;
-
-	free(func_name);
-	return f;
 }
 
-int
-rte_swx_pipeline_extern_func_register(struct rte_swx_pipeline *p,
-				      const char *name,
-				      const char *mailbox_struct_type_name,
-				      rte_swx_extern_func_t func)
+static void
+metadata_free(struct rte_swx_pipeline *p)
 {
-	struct extern_func *f;
-	struct struct_type *mailbox_struct_type;
-
-	CHECK(p, EINVAL);
-
-	CHECK_NAME(name, EINVAL);
-	CHECK(!extern_func_find(p, name), EEXIST);
-
-	CHECK_NAME(mailbox_struct_type_name, EINVAL);
-	mailbox_struct_type = struct_type_find(p, mailbox_struct_type_name);
-	CHECK(mailbox_struct_type, EINVAL);
-
-	CHECK(func, EINVAL);
-
-	/* Node allocation. */
-	f = calloc(1, sizeof(struct extern_func));
-	CHECK(func, ENOMEM);
-
-	/* Node initialization. */
-	strcpy(f->name, name);
-	f->mailbox_struct_type = mailbox_struct_type;
-	f->func = func;
-	f->struct_id = p->n_structs;
-	f->id = p->n_extern_funcs;
+	metadata_build_free(p);
+}
 
-	/* Node add to tailq. */
-	TAILQ_INSERT_TAIL(&p->extern_funcs, f, node);
-	p->n_extern_funcs++;
-	p->n_structs++;
+/*
+ * Instruction.
+ */
+static int
+instruction_is_tx(enum instruction_type type)
+{
+	switch (type) {
+	case INSTR_TX:
+	case INSTR_TX_I:
+		return 1;
 
-	return 0;
+	default:
+		return 0;
+	}
 }
 
 static int
-extern_func_build(struct rte_swx_pipeline *p)
+instruction_is_jmp(struct instruction *instr)
 {
-	uint32_t i;
+	switch (instr->type) {
+	case INSTR_JMP:
+	case INSTR_JMP_VALID:
+	case INSTR_JMP_INVALID:
+	case INSTR_JMP_HIT:
+	case INSTR_JMP_MISS:
+	case INSTR_JMP_ACTION_HIT:
+	case INSTR_JMP_ACTION_MISS:
+	case INSTR_JMP_EQ:
+	case INSTR_JMP_EQ_MH:
+	case INSTR_JMP_EQ_HM:
+	case INSTR_JMP_EQ_HH:
+	case INSTR_JMP_EQ_I:
+	case INSTR_JMP_NEQ:
+	case INSTR_JMP_NEQ_MH:
+	case INSTR_JMP_NEQ_HM:
+	case INSTR_JMP_NEQ_HH:
+	case INSTR_JMP_NEQ_I:
+	case INSTR_JMP_LT:
+	case INSTR_JMP_LT_MH:
+	case INSTR_JMP_LT_HM:
+	case INSTR_JMP_LT_HH:
+	case INSTR_JMP_LT_MI:
+	case INSTR_JMP_LT_HI:
+	case INSTR_JMP_GT:
+	case INSTR_JMP_GT_MH:
+	case INSTR_JMP_GT_HM:
+	case INSTR_JMP_GT_HH:
+	case INSTR_JMP_GT_MI:
+	case INSTR_JMP_GT_HI:
+		return 1;
 
-	for (i = 0; i < RTE_SWX_PIPELINE_THREADS_MAX; i++) {
-		struct thread *t = &p->threads[i];
-		struct extern_func *func;
+	default:
+		return 0;
+	}
+}
 
-		/* Memory allocation. */
-		t->extern_funcs = calloc(p->n_extern_funcs,
-					 sizeof(struct extern_func_runtime));
-		CHECK(t->extern_funcs, ENOMEM);
+static struct field *
+action_field_parse(struct action *action, const char *name);
 
-		/* Extern function. */
-		TAILQ_FOREACH(func, &p->extern_funcs, node) {
-			struct extern_func_runtime *r =
-				&t->extern_funcs[func->id];
-			uint32_t mailbox_size =
-				func->mailbox_struct_type->n_bits / 8;
+static struct field *
+struct_field_parse(struct rte_swx_pipeline *p,
+		   struct action *action,
+		   const char *name,
+		   uint32_t *struct_id)
+{
+	struct field *f;
 
-			r->func = func->func;
+	switch (name[0]) {
+	case 'h':
+	{
+		struct header *header;
 
-			r->mailbox = calloc(1, mailbox_size);
-			CHECK(r->mailbox, ENOMEM);
+		f = header_field_parse(p, name, &header);
+		if (!f)
+			return NULL;
 
-			t->structs[func->struct_id] = r->mailbox;
-		}
+		*struct_id = header->struct_id;
+		return f;
 	}
 
-	return 0;
-}
+	case 'm':
+	{
+		f = metadata_field_parse(p, name);
+		if (!f)
+			return NULL;
 
-static void
-extern_func_build_free(struct rte_swx_pipeline *p)
-{
-	uint32_t i;
+		*struct_id = p->metadata_struct_id;
+		return f;
+	}
 
-	for (i = 0; i < RTE_SWX_PIPELINE_THREADS_MAX; i++) {
-		struct thread *t = &p->threads[i];
-		uint32_t j;
+	case 't':
+	{
+		if (!action)
+			return NULL;
 
-		if (!t->extern_funcs)
-			continue;
+		f = action_field_parse(action, name);
+		if (!f)
+			return NULL;
 
-		for (j = 0; j < p->n_extern_funcs; j++) {
-			struct extern_func_runtime *r = &t->extern_funcs[j];
+		*struct_id = 0;
+		return f;
+	}
 
-			free(r->mailbox);
-		}
+	case 'e':
+	{
+		struct extern_obj *obj;
 
-		free(t->extern_funcs);
-		t->extern_funcs = NULL;
+		f = extern_obj_mailbox_field_parse(p, name, &obj);
+		if (!f)
+			return NULL;
+
+		*struct_id = obj->struct_id;
+		return f;
 	}
-}
 
-static void
-extern_func_free(struct rte_swx_pipeline *p)
-{
-	extern_func_build_free(p);
+	case 'f':
+	{
+		struct extern_func *func;
 
-	for ( ; ; ) {
-		struct extern_func *elem;
+		f = extern_func_mailbox_field_parse(p, name, &func);
+		if (!f)
+			return NULL;
 
-		elem = TAILQ_FIRST(&p->extern_funcs);
-		if (!elem)
-			break;
+		*struct_id = func->struct_id;
+		return f;
+	}
 
-		TAILQ_REMOVE(&p->extern_funcs, elem, node);
-		free(elem);
+	default:
+		return NULL;
 	}
 }
 
 /*
- * Header.
+ * rx.
  */
-static struct header *
-header_find(struct rte_swx_pipeline *p, const char *name)
+static int
+instr_rx_translate(struct rte_swx_pipeline *p,
+		   struct action *action,
+		   char **tokens,
+		   int n_tokens,
+		   struct instruction *instr,
+		   struct instruction_data *data __rte_unused)
 {
-	struct header *elem;
+	struct field *f;
 
-	TAILQ_FOREACH(elem, &p->headers, node)
-		if (strcmp(elem->name, name) == 0)
-			return elem;
+	CHECK(!action, EINVAL);
+	CHECK(n_tokens == 2, EINVAL);
 
-	return NULL;
+	f = metadata_field_parse(p, tokens[1]);
+	CHECK(f, EINVAL);
+
+	instr->type = INSTR_RX;
+	instr->io.io.offset = f->offset / 8;
+	instr->io.io.n_bits = f->n_bits;
+	return 0;
 }
 
-static struct header *
-header_find_by_struct_id(struct rte_swx_pipeline *p, uint32_t struct_id)
-{
-	struct header *elem;
-
-	TAILQ_FOREACH(elem, &p->headers, node)
-		if (elem->struct_id == struct_id)
-			return elem;
-
-	return NULL;
-}
-
-static struct header *
-header_parse(struct rte_swx_pipeline *p,
-	     const char *name)
-{
-	if (name[0] != 'h' || name[1] != '.')
-		return NULL;
-
-	return header_find(p, &name[2]);
-}
+static inline void
+instr_rx_exec(struct rte_swx_pipeline *p);
 
-static struct field *
-header_field_parse(struct rte_swx_pipeline *p,
-		   const char *name,
-		   struct header **header)
+static inline void
+instr_rx_exec(struct rte_swx_pipeline *p)
 {
-	struct header *h;
-	struct field *f;
-	char *header_name, *field_name;
-
-	if ((name[0] != 'h') || (name[1] != '.'))
-		return NULL;
-
-	header_name = strdup(&name[2]);
-	if (!header_name)
-		return NULL;
+	struct thread *t = &p->threads[p->thread_id];
+	struct instruction *ip = t->ip;
+	struct port_in_runtime *port = &p->in[p->port_id];
+	struct rte_swx_pkt *pkt = &t->pkt;
+	int pkt_received;
 
-	field_name = strchr(header_name, '.');
-	if (!field_name) {
-		free(header_name);
-		return NULL;
-	}
+	/* Packet. */
+	pkt_received = port->pkt_rx(port->obj, pkt);
+	t->ptr = &pkt->pkt[pkt->offset];
+	rte_prefetch0(t->ptr);
 
-	*field_name = 0;
-	field_name++;
+	TRACE("[Thread %2u] rx %s from port %u\n",
+	      p->thread_id,
+	      pkt_received ? "1 pkt" : "0 pkts",
+	      p->port_id);
 
-	h = header_find(p, header_name);
-	if (!h) {
-		free(header_name);
-		return NULL;
-	}
+	/* Headers. */
+	t->valid_headers = 0;
+	t->n_headers_out = 0;
 
-	f = struct_type_field_find(h->st, field_name);
-	if (!f) {
-		free(header_name);
-		return NULL;
-	}
+	/* Meta-data. */
+	METADATA_WRITE(t, ip->io.io.offset, ip->io.io.n_bits, p->port_id);
 
-	if (header)
-		*header = h;
+	/* Tables. */
+	t->table_state = p->table_state;
 
-	free(header_name);
-	return f;
+	/* Thread. */
+	pipeline_port_inc(p);
+	thread_ip_inc_cond(t, pkt_received);
+	thread_yield(p);
 }
 
-int
-rte_swx_pipeline_packet_header_register(struct rte_swx_pipeline *p,
-					const char *name,
-					const char *struct_type_name)
+/*
+ * tx.
+ */
+static int
+instr_tx_translate(struct rte_swx_pipeline *p,
+		   struct action *action __rte_unused,
+		   char **tokens,
+		   int n_tokens,
+		   struct instruction *instr,
+		   struct instruction_data *data __rte_unused)
 {
-	struct struct_type *st;
-	struct header *h;
-	size_t n_headers_max;
-
-	CHECK(p, EINVAL);
-	CHECK_NAME(name, EINVAL);
-	CHECK_NAME(struct_type_name, EINVAL);
-
-	CHECK(!header_find(p, name), EEXIST);
-
-	st = struct_type_find(p, struct_type_name);
-	CHECK(st, EINVAL);
-
-	n_headers_max = RTE_SIZEOF_FIELD(struct thread, valid_headers) * 8;
-	CHECK(p->n_headers < n_headers_max, ENOSPC);
+	char *port = tokens[1];
+	struct field *f;
+	uint32_t port_val;
 
-	/* Node allocation. */
-	h = calloc(1, sizeof(struct header));
-	CHECK(h, ENOMEM);
+	CHECK(n_tokens == 2, EINVAL);
 
-	/* Node initialization. */
-	strcpy(h->name, name);
-	h->st = st;
-	h->struct_id = p->n_structs;
-	h->id = p->n_headers;
+	f = metadata_field_parse(p, port);
+	if (f) {
+		instr->type = INSTR_TX;
+		instr->io.io.offset = f->offset / 8;
+		instr->io.io.n_bits = f->n_bits;
+		return 0;
+	}
 
-	/* Node add to tailq. */
-	TAILQ_INSERT_TAIL(&p->headers, h, node);
-	p->n_headers++;
-	p->n_structs++;
+	/* TX_I. */
+	port_val = strtoul(port, &port, 0);
+	CHECK(!port[0], EINVAL);
 
+	instr->type = INSTR_TX_I;
+	instr->io.io.val = port_val;
 	return 0;
 }
 
 static int
-header_build(struct rte_swx_pipeline *p)
+instr_drop_translate(struct rte_swx_pipeline *p,
+		     struct action *action __rte_unused,
+		     char **tokens __rte_unused,
+		     int n_tokens,
+		     struct instruction *instr,
+		     struct instruction_data *data __rte_unused)
 {
-	struct header *h;
-	uint32_t n_bytes = 0, i;
+	CHECK(n_tokens == 1, EINVAL);
 
-	TAILQ_FOREACH(h, &p->headers, node) {
-		n_bytes += h->st->n_bits / 8;
-	}
+	/* TX_I. */
+	instr->type = INSTR_TX_I;
+	instr->io.io.val = p->n_ports_out - 1;
+	return 0;
+}
 
-	for (i = 0; i < RTE_SWX_PIPELINE_THREADS_MAX; i++) {
-		struct thread *t = &p->threads[i];
-		uint32_t offset = 0;
+static inline void
+emit_handler(struct thread *t)
+{
+	struct header_out_runtime *h0 = &t->headers_out[0];
+	struct header_out_runtime *h1 = &t->headers_out[1];
+	uint32_t offset = 0, i;
 
-		t->headers = calloc(p->n_headers,
-				    sizeof(struct header_runtime));
-		CHECK(t->headers, ENOMEM);
+	/* No header change or header decapsulation. */
+	if ((t->n_headers_out == 1) &&
+	    (h0->ptr + h0->n_bytes == t->ptr)) {
+		TRACE("Emit handler: no header change or header decap.\n");
 
-		t->headers_out = calloc(p->n_headers,
-					sizeof(struct header_out_runtime));
-		CHECK(t->headers_out, ENOMEM);
+		t->pkt.offset -= h0->n_bytes;
+		t->pkt.length += h0->n_bytes;
 
-		t->header_storage = calloc(1, n_bytes);
-		CHECK(t->header_storage, ENOMEM);
+		return;
+	}
 
-		t->header_out_storage = calloc(1, n_bytes);
-		CHECK(t->header_out_storage, ENOMEM);
+	/* Header encapsulation (optionally, with prior header decasulation). */
+	if ((t->n_headers_out == 2) &&
+	    (h1->ptr + h1->n_bytes == t->ptr) &&
+	    (h0->ptr == h0->ptr0)) {
+		uint32_t offset;
 
-		TAILQ_FOREACH(h, &p->headers, node) {
-			uint8_t *header_storage;
+		TRACE("Emit handler: header encapsulation.\n");
 
-			header_storage = &t->header_storage[offset];
-			offset += h->st->n_bits / 8;
+		offset = h0->n_bytes + h1->n_bytes;
+		memcpy(t->ptr - offset, h0->ptr, h0->n_bytes);
+		t->pkt.offset -= offset;
+		t->pkt.length += offset;
 
-			t->headers[h->id].ptr0 = header_storage;
-			t->structs[h->struct_id] = header_storage;
-		}
+		return;
 	}
 
-	return 0;
-}
-
-static void
-header_build_free(struct rte_swx_pipeline *p)
-{
-	uint32_t i;
+	/* Header insertion. */
+	/* TBD */
 
-	for (i = 0; i < RTE_SWX_PIPELINE_THREADS_MAX; i++) {
-		struct thread *t = &p->threads[i];
+	/* Header extraction. */
+	/* TBD */
 
-		free(t->headers_out);
-		t->headers_out = NULL;
+	/* For any other case. */
+	TRACE("Emit handler: complex case.\n");
 
-		free(t->headers);
-		t->headers = NULL;
+	for (i = 0; i < t->n_headers_out; i++) {
+		struct header_out_runtime *h = &t->headers_out[i];
 
-		free(t->header_out_storage);
-		t->header_out_storage = NULL;
+		memcpy(&t->header_out_storage[offset], h->ptr, h->n_bytes);
+		offset += h->n_bytes;
+	}
 
-		free(t->header_storage);
-		t->header_storage = NULL;
+	if (offset) {
+		memcpy(t->ptr - offset, t->header_out_storage, offset);
+		t->pkt.offset -= offset;
+		t->pkt.length += offset;
 	}
 }
 
-static void
-header_free(struct rte_swx_pipeline *p)
+static inline void
+instr_tx_exec(struct rte_swx_pipeline *p);
+
+static inline void
+instr_tx_exec(struct rte_swx_pipeline *p)
 {
-	header_build_free(p);
+	struct thread *t = &p->threads[p->thread_id];
+	struct instruction *ip = t->ip;
+	uint64_t port_id = METADATA_READ(t, ip->io.io.offset, ip->io.io.n_bits);
+	struct port_out_runtime *port = &p->out[port_id];
+	struct rte_swx_pkt *pkt = &t->pkt;
 
-	for ( ; ; ) {
-		struct header *elem;
+	TRACE("[Thread %2u]: tx 1 pkt to port %u\n",
+	      p->thread_id,
+	      (uint32_t)port_id);
 
-		elem = TAILQ_FIRST(&p->headers);
-		if (!elem)
-			break;
+	/* Headers. */
+	emit_handler(t);
 
-		TAILQ_REMOVE(&p->headers, elem, node);
-		free(elem);
-	}
-}
-
-/*
- * Meta-data.
- */
-static struct field *
-metadata_field_parse(struct rte_swx_pipeline *p, const char *name)
-{
-	if (!p->metadata_st)
-		return NULL;
-
-	if (name[0] != 'm' || name[1] != '.')
-		return NULL;
+	/* Packet. */
+	port->pkt_tx(port->obj, pkt);
 
-	return struct_type_field_find(p->metadata_st, &name[2]);
+	/* Thread. */
+	thread_ip_reset(p, t);
+	instr_rx_exec(p);
 }
 
-int
-rte_swx_pipeline_packet_metadata_register(struct rte_swx_pipeline *p,
-					  const char *struct_type_name)
+static inline void
+instr_tx_i_exec(struct rte_swx_pipeline *p)
 {
-	struct struct_type *st = NULL;
-
-	CHECK(p, EINVAL);
+	struct thread *t = &p->threads[p->thread_id];
+	struct instruction *ip = t->ip;
+	uint64_t port_id = ip->io.io.val;
+	struct port_out_runtime *port = &p->out[port_id];
+	struct rte_swx_pkt *pkt = &t->pkt;
 
-	CHECK_NAME(struct_type_name, EINVAL);
-	st  = struct_type_find(p, struct_type_name);
-	CHECK(st, EINVAL);
-	CHECK(!p->metadata_st, EINVAL);
+	TRACE("[Thread %2u]: tx (i) 1 pkt to port %u\n",
+	      p->thread_id,
+	      (uint32_t)port_id);
 
-	p->metadata_st = st;
-	p->metadata_struct_id = p->n_structs;
+	/* Headers. */
+	emit_handler(t);
 
-	p->n_structs++;
+	/* Packet. */
+	port->pkt_tx(port->obj, pkt);
 
-	return 0;
+	/* Thread. */
+	thread_ip_reset(p, t);
+	instr_rx_exec(p);
 }
 
+/*
+ * extract.
+ */
 static int
-metadata_build(struct rte_swx_pipeline *p)
+instr_hdr_extract_translate(struct rte_swx_pipeline *p,
+			    struct action *action,
+			    char **tokens,
+			    int n_tokens,
+			    struct instruction *instr,
+			    struct instruction_data *data __rte_unused)
 {
-	uint32_t n_bytes = p->metadata_st->n_bits / 8;
-	uint32_t i;
-
-	/* Thread-level initialization. */
-	for (i = 0; i < RTE_SWX_PIPELINE_THREADS_MAX; i++) {
-		struct thread *t = &p->threads[i];
-		uint8_t *metadata;
+	struct header *h;
 
-		metadata = calloc(1, n_bytes);
-		CHECK(metadata, ENOMEM);
+	CHECK(!action, EINVAL);
+	CHECK(n_tokens == 2, EINVAL);
 
-		t->metadata = metadata;
-		t->structs[p->metadata_struct_id] = metadata;
-	}
+	h = header_parse(p, tokens[1]);
+	CHECK(h, EINVAL);
 
+	instr->type = INSTR_HDR_EXTRACT;
+	instr->io.hdr.header_id[0] = h->id;
+	instr->io.hdr.struct_id[0] = h->struct_id;
+	instr->io.hdr.n_bytes[0] = h->st->n_bits / 8;
 	return 0;
 }
 
-static void
-metadata_build_free(struct rte_swx_pipeline *p)
+static inline void
+instr_hdr_extract_exec(struct rte_swx_pipeline *p)
 {
-	uint32_t i;
+	struct thread *t = &p->threads[p->thread_id];
+	struct instruction *ip = t->ip;
 
-	for (i = 0; i < RTE_SWX_PIPELINE_THREADS_MAX; i++) {
-		struct thread *t = &p->threads[i];
+	__instr_hdr_extract_exec(p, t, ip);
 
-		free(t->metadata);
-		t->metadata = NULL;
-	}
+	/* Thread. */
+	thread_ip_inc(p);
 }
 
-static void
-metadata_free(struct rte_swx_pipeline *p)
+static inline void
+instr_hdr_extract2_exec(struct rte_swx_pipeline *p)
 {
-	metadata_build_free(p);
-}
+	struct thread *t = &p->threads[p->thread_id];
+	struct instruction *ip = t->ip;
 
-/*
- * Instruction.
- */
-static int
-instruction_is_tx(enum instruction_type type)
-{
-	switch (type) {
-	case INSTR_TX:
-	case INSTR_TX_I:
-		return 1;
+	__instr_hdr_extract2_exec(p, t, ip);
 
-	default:
-		return 0;
-	}
+	/* Thread. */
+	thread_ip_inc(p);
 }
 
-static int
-instruction_is_jmp(struct instruction *instr)
+static inline void
+instr_hdr_extract3_exec(struct rte_swx_pipeline *p)
 {
-	switch (instr->type) {
-	case INSTR_JMP:
-	case INSTR_JMP_VALID:
-	case INSTR_JMP_INVALID:
-	case INSTR_JMP_HIT:
-	case INSTR_JMP_MISS:
-	case INSTR_JMP_ACTION_HIT:
-	case INSTR_JMP_ACTION_MISS:
-	case INSTR_JMP_EQ:
-	case INSTR_JMP_EQ_MH:
-	case INSTR_JMP_EQ_HM:
-	case INSTR_JMP_EQ_HH:
-	case INSTR_JMP_EQ_I:
-	case INSTR_JMP_NEQ:
-	case INSTR_JMP_NEQ_MH:
-	case INSTR_JMP_NEQ_HM:
-	case INSTR_JMP_NEQ_HH:
-	case INSTR_JMP_NEQ_I:
-	case INSTR_JMP_LT:
-	case INSTR_JMP_LT_MH:
-	case INSTR_JMP_LT_HM:
-	case INSTR_JMP_LT_HH:
-	case INSTR_JMP_LT_MI:
-	case INSTR_JMP_LT_HI:
-	case INSTR_JMP_GT:
-	case INSTR_JMP_GT_MH:
-	case INSTR_JMP_GT_HM:
-	case INSTR_JMP_GT_HH:
-	case INSTR_JMP_GT_MI:
-	case INSTR_JMP_GT_HI:
-		return 1;
+	struct thread *t = &p->threads[p->thread_id];
+	struct instruction *ip = t->ip;
 
-	default:
-		return 0;
-	}
-}
+	__instr_hdr_extract3_exec(p, t, ip);
 
-static struct field *
-action_field_parse(struct action *action, const char *name);
+	/* Thread. */
+	thread_ip_inc(p);
+}
 
-static struct field *
-struct_field_parse(struct rte_swx_pipeline *p,
-		   struct action *action,
-		   const char *name,
-		   uint32_t *struct_id)
+static inline void
+instr_hdr_extract4_exec(struct rte_swx_pipeline *p)
 {
-	struct field *f;
-
-	switch (name[0]) {
-	case 'h':
-	{
-		struct header *header;
-
-		f = header_field_parse(p, name, &header);
-		if (!f)
-			return NULL;
-
-		*struct_id = header->struct_id;
-		return f;
-	}
-
-	case 'm':
-	{
-		f = metadata_field_parse(p, name);
-		if (!f)
-			return NULL;
-
-		*struct_id = p->metadata_struct_id;
-		return f;
-	}
-
-	case 't':
-	{
-		if (!action)
-			return NULL;
-
-		f = action_field_parse(action, name);
-		if (!f)
-			return NULL;
-
-		*struct_id = 0;
-		return f;
-	}
-
-	case 'e':
-	{
-		struct extern_obj *obj;
-
-		f = extern_obj_mailbox_field_parse(p, name, &obj);
-		if (!f)
-			return NULL;
-
-		*struct_id = obj->struct_id;
-		return f;
-	}
-
-	case 'f':
-	{
-		struct extern_func *func;
-
-		f = extern_func_mailbox_field_parse(p, name, &func);
-		if (!f)
-			return NULL;
+	struct thread *t = &p->threads[p->thread_id];
+	struct instruction *ip = t->ip;
 
-		*struct_id = func->struct_id;
-		return f;
-	}
+	__instr_hdr_extract4_exec(p, t, ip);
 
-	default:
-		return NULL;
-	}
+	/* Thread. */
+	thread_ip_inc(p);
 }
 
 static inline void
-pipeline_port_inc(struct rte_swx_pipeline *p)
+instr_hdr_extract5_exec(struct rte_swx_pipeline *p)
 {
-	p->port_id = (p->port_id + 1) & (p->n_ports_in - 1);
+	struct thread *t = &p->threads[p->thread_id];
+	struct instruction *ip = t->ip;
+
+	__instr_hdr_extract5_exec(p, t, ip);
+
+	/* Thread. */
+	thread_ip_inc(p);
 }
 
 static inline void
-thread_ip_reset(struct rte_swx_pipeline *p, struct thread *t)
+instr_hdr_extract6_exec(struct rte_swx_pipeline *p)
 {
-	t->ip = p->instructions;
+	struct thread *t = &p->threads[p->thread_id];
+	struct instruction *ip = t->ip;
+
+	__instr_hdr_extract6_exec(p, t, ip);
+
+	/* Thread. */
+	thread_ip_inc(p);
 }
 
 static inline void
-thread_ip_set(struct thread *t, struct instruction *ip)
-{
-	t->ip = ip;
-}
-
-static inline void
-thread_ip_action_call(struct rte_swx_pipeline *p,
-		      struct thread *t,
-		      uint32_t action_id)
-{
-	t->ret = t->ip + 1;
-	t->ip = p->action_instructions[action_id];
-}
-
-static inline void
-thread_ip_inc(struct rte_swx_pipeline *p);
-
-static inline void
-thread_ip_inc(struct rte_swx_pipeline *p)
+instr_hdr_extract7_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
+	struct instruction *ip = t->ip;
 
-	t->ip++;
-}
+	__instr_hdr_extract7_exec(p, t, ip);
 
-static inline void
-thread_ip_inc_cond(struct thread *t, int cond)
-{
-	t->ip += cond;
+	/* Thread. */
+	thread_ip_inc(p);
 }
 
 static inline void
-thread_yield(struct rte_swx_pipeline *p)
+instr_hdr_extract8_exec(struct rte_swx_pipeline *p)
 {
-	p->thread_id = (p->thread_id + 1) & (RTE_SWX_PIPELINE_THREADS_MAX - 1);
-}
+	struct thread *t = &p->threads[p->thread_id];
+	struct instruction *ip = t->ip;
 
-static inline void
-thread_yield_cond(struct rte_swx_pipeline *p, int cond)
-{
-	p->thread_id = (p->thread_id + cond) & (RTE_SWX_PIPELINE_THREADS_MAX - 1);
+	__instr_hdr_extract8_exec(p, t, ip);
+
+	/* Thread. */
+	thread_ip_inc(p);
 }
 
 /*
- * rx.
+ * emit.
  */
 static int
-instr_rx_translate(struct rte_swx_pipeline *p,
-		   struct action *action,
-		   char **tokens,
-		   int n_tokens,
-		   struct instruction *instr,
-		   struct instruction_data *data __rte_unused)
+instr_hdr_emit_translate(struct rte_swx_pipeline *p,
+			 struct action *action __rte_unused,
+			 char **tokens,
+			 int n_tokens,
+			 struct instruction *instr,
+			 struct instruction_data *data __rte_unused)
 {
-	struct field *f;
+	struct header *h;
 
-	CHECK(!action, EINVAL);
 	CHECK(n_tokens == 2, EINVAL);
 
-	f = metadata_field_parse(p, tokens[1]);
-	CHECK(f, EINVAL);
+	h = header_parse(p, tokens[1]);
+	CHECK(h, EINVAL);
 
-	instr->type = INSTR_RX;
-	instr->io.io.offset = f->offset / 8;
-	instr->io.io.n_bits = f->n_bits;
+	instr->type = INSTR_HDR_EMIT;
+	instr->io.hdr.header_id[0] = h->id;
+	instr->io.hdr.struct_id[0] = h->struct_id;
+	instr->io.hdr.n_bytes[0] = h->st->n_bits / 8;
 	return 0;
 }
 
 static inline void
-instr_rx_exec(struct rte_swx_pipeline *p);
-
-static inline void
-instr_rx_exec(struct rte_swx_pipeline *p)
+instr_hdr_emit_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	struct port_in_runtime *port = &p->in[p->port_id];
-	struct rte_swx_pkt *pkt = &t->pkt;
-	int pkt_received;
-
-	/* Packet. */
-	pkt_received = port->pkt_rx(port->obj, pkt);
-	t->ptr = &pkt->pkt[pkt->offset];
-	rte_prefetch0(t->ptr);
-
-	TRACE("[Thread %2u] rx %s from port %u\n",
-	      p->thread_id,
-	      pkt_received ? "1 pkt" : "0 pkts",
-	      p->port_id);
-
-	/* Headers. */
-	t->valid_headers = 0;
-	t->n_headers_out = 0;
-
-	/* Meta-data. */
-	METADATA_WRITE(t, ip->io.io.offset, ip->io.io.n_bits, p->port_id);
 
-	/* Tables. */
-	t->table_state = p->table_state;
+	__instr_hdr_emit_exec(p, t, ip);
 
 	/* Thread. */
-	pipeline_port_inc(p);
-	thread_ip_inc_cond(t, pkt_received);
-	thread_yield(p);
+	thread_ip_inc(p);
 }
 
-/*
- * tx.
- */
-static int
-instr_tx_translate(struct rte_swx_pipeline *p,
-		   struct action *action __rte_unused,
-		   char **tokens,
-		   int n_tokens,
-		   struct instruction *instr,
-		   struct instruction_data *data __rte_unused)
+static inline void
+instr_hdr_emit_tx_exec(struct rte_swx_pipeline *p)
 {
-	char *port = tokens[1];
-	struct field *f;
-	uint32_t port_val;
-
-	CHECK(n_tokens == 2, EINVAL);
-
-	f = metadata_field_parse(p, port);
-	if (f) {
-		instr->type = INSTR_TX;
-		instr->io.io.offset = f->offset / 8;
-		instr->io.io.n_bits = f->n_bits;
-		return 0;
-	}
+	struct thread *t = &p->threads[p->thread_id];
+	struct instruction *ip = t->ip;
 
-	/* TX_I. */
-	port_val = strtoul(port, &port, 0);
-	CHECK(!port[0], EINVAL);
+	TRACE("[Thread %2u] *** The next 2 instructions are fused. ***\n",
+	      p->thread_id);
 
-	instr->type = INSTR_TX_I;
-	instr->io.io.val = port_val;
-	return 0;
+	__instr_hdr_emit_many_exec(p, t, ip, 1);
+	instr_tx_exec(p);
 }
 
-static int
-instr_drop_translate(struct rte_swx_pipeline *p,
-		     struct action *action __rte_unused,
-		     char **tokens __rte_unused,
-		     int n_tokens,
-		     struct instruction *instr,
-		     struct instruction_data *data __rte_unused)
+static inline void
+instr_hdr_emit2_tx_exec(struct rte_swx_pipeline *p)
 {
-	CHECK(n_tokens == 1, EINVAL);
+	struct thread *t = &p->threads[p->thread_id];
+	struct instruction *ip = t->ip;
 
-	/* TX_I. */
-	instr->type = INSTR_TX_I;
-	instr->io.io.val = p->n_ports_out - 1;
-	return 0;
+	TRACE("[Thread %2u] *** The next 3 instructions are fused. ***\n",
+	      p->thread_id);
+
+	__instr_hdr_emit_many_exec(p, t, ip, 2);
+	instr_tx_exec(p);
 }
 
 static inline void
-emit_handler(struct thread *t)
+instr_hdr_emit3_tx_exec(struct rte_swx_pipeline *p)
 {
-	struct header_out_runtime *h0 = &t->headers_out[0];
-	struct header_out_runtime *h1 = &t->headers_out[1];
-	uint32_t offset = 0, i;
-
-	/* No header change or header decapsulation. */
-	if ((t->n_headers_out == 1) &&
-	    (h0->ptr + h0->n_bytes == t->ptr)) {
-		TRACE("Emit handler: no header change or header decap.\n");
-
-		t->pkt.offset -= h0->n_bytes;
-		t->pkt.length += h0->n_bytes;
+	struct thread *t = &p->threads[p->thread_id];
+	struct instruction *ip = t->ip;
 
-		return;
-	}
+	TRACE("[Thread %2u] *** The next 4 instructions are fused. ***\n",
+	      p->thread_id);
 
-	/* Header encapsulation (optionally, with prior header decasulation). */
-	if ((t->n_headers_out == 2) &&
-	    (h1->ptr + h1->n_bytes == t->ptr) &&
-	    (h0->ptr == h0->ptr0)) {
-		uint32_t offset;
+	__instr_hdr_emit_many_exec(p, t, ip, 3);
+	instr_tx_exec(p);
+}
 
-		TRACE("Emit handler: header encapsulation.\n");
+static inline void
+instr_hdr_emit4_tx_exec(struct rte_swx_pipeline *p)
+{
+	struct thread *t = &p->threads[p->thread_id];
+	struct instruction *ip = t->ip;
 
-		offset = h0->n_bytes + h1->n_bytes;
-		memcpy(t->ptr - offset, h0->ptr, h0->n_bytes);
-		t->pkt.offset -= offset;
-		t->pkt.length += offset;
+	TRACE("[Thread %2u] *** The next 5 instructions are fused. ***\n",
+	      p->thread_id);
 
-		return;
-	}
+	__instr_hdr_emit_many_exec(p, t, ip, 4);
+	instr_tx_exec(p);
+}
 
-	/* Header insertion. */
-	/* TBD */
+static inline void
+instr_hdr_emit5_tx_exec(struct rte_swx_pipeline *p)
+{
+	struct thread *t = &p->threads[p->thread_id];
+	struct instruction *ip = t->ip;
 
-	/* Header extraction. */
-	/* TBD */
+	TRACE("[Thread %2u] *** The next 6 instructions are fused. ***\n",
+	      p->thread_id);
 
-	/* For any other case. */
-	TRACE("Emit handler: complex case.\n");
+	__instr_hdr_emit_many_exec(p, t, ip, 5);
+	instr_tx_exec(p);
+}
 
-	for (i = 0; i < t->n_headers_out; i++) {
-		struct header_out_runtime *h = &t->headers_out[i];
+static inline void
+instr_hdr_emit6_tx_exec(struct rte_swx_pipeline *p)
+{
+	struct thread *t = &p->threads[p->thread_id];
+	struct instruction *ip = t->ip;
 
-		memcpy(&t->header_out_storage[offset], h->ptr, h->n_bytes);
-		offset += h->n_bytes;
-	}
+	TRACE("[Thread %2u] *** The next 7 instructions are fused. ***\n",
+	      p->thread_id);
 
-	if (offset) {
-		memcpy(t->ptr - offset, t->header_out_storage, offset);
-		t->pkt.offset -= offset;
-		t->pkt.length += offset;
-	}
+	__instr_hdr_emit_many_exec(p, t, ip, 6);
+	instr_tx_exec(p);
 }
 
 static inline void
-instr_tx_exec(struct rte_swx_pipeline *p);
-
-static inline void
-instr_tx_exec(struct rte_swx_pipeline *p)
+instr_hdr_emit7_tx_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t port_id = METADATA_READ(t, ip->io.io.offset, ip->io.io.n_bits);
-	struct port_out_runtime *port = &p->out[port_id];
-	struct rte_swx_pkt *pkt = &t->pkt;
-
-	TRACE("[Thread %2u]: tx 1 pkt to port %u\n",
-	      p->thread_id,
-	      (uint32_t)port_id);
-
-	/* Headers. */
-	emit_handler(t);
 
-	/* Packet. */
-	port->pkt_tx(port->obj, pkt);
+	TRACE("[Thread %2u] *** The next 8 instructions are fused. ***\n",
+	      p->thread_id);
 
-	/* Thread. */
-	thread_ip_reset(p, t);
-	instr_rx_exec(p);
+	__instr_hdr_emit_many_exec(p, t, ip, 7);
+	instr_tx_exec(p);
 }
 
 static inline void
-instr_tx_i_exec(struct rte_swx_pipeline *p)
+instr_hdr_emit8_tx_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t port_id = ip->io.io.val;
-	struct port_out_runtime *port = &p->out[port_id];
-	struct rte_swx_pkt *pkt = &t->pkt;
-
-	TRACE("[Thread %2u]: tx (i) 1 pkt to port %u\n",
-	      p->thread_id,
-	      (uint32_t)port_id);
 
-	/* Headers. */
-	emit_handler(t);
+	TRACE("[Thread %2u] *** The next 9 instructions are fused. ***\n",
+	      p->thread_id);
 
-	/* Packet. */
-	port->pkt_tx(port->obj, pkt);
-
-	/* Thread. */
-	thread_ip_reset(p, t);
-	instr_rx_exec(p);
-}
+	__instr_hdr_emit_many_exec(p, t, ip, 8);
+	instr_tx_exec(p);
+}
 
 /*
- * extract.
+ * validate.
  */
 static int
-instr_hdr_extract_translate(struct rte_swx_pipeline *p,
-			    struct action *action,
-			    char **tokens,
-			    int n_tokens,
-			    struct instruction *instr,
-			    struct instruction_data *data __rte_unused)
+instr_hdr_validate_translate(struct rte_swx_pipeline *p,
+			     struct action *action __rte_unused,
+			     char **tokens,
+			     int n_tokens,
+			     struct instruction *instr,
+			     struct instruction_data *data __rte_unused)
 {
 	struct header *h;
 
-	CHECK(!action, EINVAL);
 	CHECK(n_tokens == 2, EINVAL);
 
 	h = header_parse(p, tokens[1]);
 	CHECK(h, EINVAL);
 
-	instr->type = INSTR_HDR_EXTRACT;
-	instr->io.hdr.header_id[0] = h->id;
-	instr->io.hdr.struct_id[0] = h->struct_id;
-	instr->io.hdr.n_bytes[0] = h->st->n_bits / 8;
+	instr->type = INSTR_HDR_VALIDATE;
+	instr->valid.header_id = h->id;
 	return 0;
 }
 
 static inline void
-__instr_hdr_extract_exec(struct rte_swx_pipeline *p, uint32_t n_extract);
-
-static inline void
-__instr_hdr_extract_exec(struct rte_swx_pipeline *p, uint32_t n_extract)
+instr_hdr_validate_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t valid_headers = t->valid_headers;
-	uint8_t *ptr = t->ptr;
-	uint32_t offset = t->pkt.offset;
-	uint32_t length = t->pkt.length;
-	uint32_t i;
-
-	for (i = 0; i < n_extract; i++) {
-		uint32_t header_id = ip->io.hdr.header_id[i];
-		uint32_t struct_id = ip->io.hdr.struct_id[i];
-		uint32_t n_bytes = ip->io.hdr.n_bytes[i];
-
-		TRACE("[Thread %2u]: extract header %u (%u bytes)\n",
-		      p->thread_id,
-		      header_id,
-		      n_bytes);
 
-		/* Headers. */
-		t->structs[struct_id] = ptr;
-		valid_headers = MASK64_BIT_SET(valid_headers, header_id);
-
-		/* Packet. */
-		offset += n_bytes;
-		length -= n_bytes;
-		ptr += n_bytes;
-	}
-
-	/* Headers. */
-	t->valid_headers = valid_headers;
-
-	/* Packet. */
-	t->pkt.offset = offset;
-	t->pkt.length = length;
-	t->ptr = ptr;
-}
-
-static inline void
-instr_hdr_extract_exec(struct rte_swx_pipeline *p)
-{
-	__instr_hdr_extract_exec(p, 1);
+	__instr_hdr_validate_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
 }
 
-static inline void
-instr_hdr_extract2_exec(struct rte_swx_pipeline *p)
+/*
+ * invalidate.
+ */
+static int
+instr_hdr_invalidate_translate(struct rte_swx_pipeline *p,
+			       struct action *action __rte_unused,
+			       char **tokens,
+			       int n_tokens,
+			       struct instruction *instr,
+			       struct instruction_data *data __rte_unused)
 {
-	TRACE("[Thread %2u] *** The next 2 instructions are fused. ***\n",
-	      p->thread_id);
+	struct header *h;
 
-	__instr_hdr_extract_exec(p, 2);
+	CHECK(n_tokens == 2, EINVAL);
 
-	/* Thread. */
-	thread_ip_inc(p);
+	h = header_parse(p, tokens[1]);
+	CHECK(h, EINVAL);
+
+	instr->type = INSTR_HDR_INVALIDATE;
+	instr->valid.header_id = h->id;
+	return 0;
 }
 
 static inline void
-instr_hdr_extract3_exec(struct rte_swx_pipeline *p)
+instr_hdr_invalidate_exec(struct rte_swx_pipeline *p)
 {
-	TRACE("[Thread %2u] *** The next 3 instructions are fused. ***\n",
-	      p->thread_id);
+	struct thread *t = &p->threads[p->thread_id];
+	struct instruction *ip = t->ip;
 
-	__instr_hdr_extract_exec(p, 3);
+	__instr_hdr_invalidate_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
 }
 
-static inline void
-instr_hdr_extract4_exec(struct rte_swx_pipeline *p)
-{
-	TRACE("[Thread %2u] *** The next 4 instructions are fused. ***\n",
-	      p->thread_id);
-
-	__instr_hdr_extract_exec(p, 4);
+/*
+ * table.
+ */
+static struct table *
+table_find(struct rte_swx_pipeline *p, const char *name);
 
-	/* Thread. */
-	thread_ip_inc(p);
-}
+static struct learner *
+learner_find(struct rte_swx_pipeline *p, const char *name);
 
-static inline void
-instr_hdr_extract5_exec(struct rte_swx_pipeline *p)
+static int
+instr_table_translate(struct rte_swx_pipeline *p,
+		      struct action *action,
+		      char **tokens,
+		      int n_tokens,
+		      struct instruction *instr,
+		      struct instruction_data *data __rte_unused)
 {
-	TRACE("[Thread %2u] *** The next 5 instructions are fused. ***\n",
-	      p->thread_id);
+	struct table *t;
+	struct learner *l;
 
-	__instr_hdr_extract_exec(p, 5);
+	CHECK(!action, EINVAL);
+	CHECK(n_tokens == 2, EINVAL);
 
-	/* Thread. */
-	thread_ip_inc(p);
+	t = table_find(p, tokens[1]);
+	if (t) {
+		instr->type = INSTR_TABLE;
+		instr->table.table_id = t->id;
+		return 0;
+	}
+
+	l = learner_find(p, tokens[1]);
+	if (l) {
+		instr->type = INSTR_LEARNER;
+		instr->table.table_id = l->id;
+		return 0;
+	}
+
+	CHECK(0, EINVAL);
 }
 
-static inline void
-instr_hdr_extract6_exec(struct rte_swx_pipeline *p)
+static void
+table_burst_flush(struct rte_swx_pipeline *p, struct table_burst *b)
 {
-	TRACE("[Thread %2u] *** The next 6 instructions are fused. ***\n",
-	      p->thread_id);
+	uint32_t i;
 
-	__instr_hdr_extract_exec(p, 6);
+	b->func(b->obj, b->keys, b->action_id, b->action_data, b->hit,
+		b->n_keys);
 
-	/* Thread. */
-	thread_ip_inc(p);
+	for (i = 0; i < b->n_keys; i++) {
+		struct thread *t = &p->threads[b->thread_id[i]];
+
+		t->burst_action_id = b->action_id[i];
+		t->burst_action_data = b->action_data[i];
+		t->burst_hit = b->hit[i];
+		t->burst_state = 2;
+	}
+
+	b->n_keys = 0;
 }
 
-static inline void
-instr_hdr_extract7_exec(struct rte_swx_pipeline *p)
+static inline int
+table_burst_lookup(struct rte_swx_pipeline *p,
+		   struct thread *t,
+		   struct table_burst *b,
+		   void *obj,
+		   uint8_t *key,
+		   uint64_t *action_id,
+		   uint8_t **action_data,
+		   int *hit)
 {
-	TRACE("[Thread %2u] *** The next 7 instructions are fused. ***\n",
-	      p->thread_id);
+	/* New lookup: put it on hold, unless the burst is now complete. The
+	 * lookups on hold from older table objects are completed first, as the
+	 * threads can see different table objects during a table update.
+	 */
+	if (!t->burst_state) {
+		if (b->n_keys && (b->obj != obj))
+			table_burst_flush(p, b);
 
-	__instr_hdr_extract_exec(p, 7);
+		b->obj = obj;
+		b->keys[b->n_keys] = key;
+		b->thread_id[b->n_keys] = p->thread_id;
+		b->n_keys++;
+		t->burst_state = 1;
 
-	/* Thread. */
-	thread_ip_inc(p);
+		if (b->n_keys < p->burst_size)
+			return 0;
+	}
+
+	/* Lookup on hold: the thread is back, so no more lookups into this
+	 * table are likely to join the burst before this thread can continue.
+	 */
+	if (t->burst_state == 1)
+		table_burst_flush(p, b);
+
+	*action_id = t->burst_action_id;
+	*action_data = t->burst_action_data;
+	*hit = t->burst_hit;
+	t->burst_state = 0;
+	return 1;
 }
 
 static inline void
-instr_hdr_extract8_exec(struct rte_swx_pipeline *p)
+instr_table_exec(struct rte_swx_pipeline *p)
 {
-	TRACE("[Thread %2u] *** The next 8 instructions are fused. ***\n",
-	      p->thread_id);
+	struct thread *t = &p->threads[p->thread_id];
+	struct instruction *ip = t->ip;
+	uint32_t table_id = ip->table.table_id;
+	struct rte_swx_table_state *ts = &t->table_state[table_id];
+	struct table_runtime *table = &t->tables[table_id];
+	struct table_statistics *stats = &p->table_stats[table_id];
+	uint64_t action_id, n_pkts_hit, n_pkts_action;
+	uint8_t *action_data;
+	int done, hit;
 
-	__instr_hdr_extract_exec(p, 8);
+	/* Table. */
+	if (p->table_bursts && p->table_bursts[table_id].func)
+		done = table_burst_lookup(p,
+					  t,
+					  &p->table_bursts[table_id],
+					  ts->obj,
+					  *table->key,
+					  &action_id,
+					  &action_data,
+					  &hit);
+	else
+		done = table->func(ts->obj,
+				   table->mailbox,
+				   table->key,
+				   &action_id,
+				   &action_data,
+				   &hit);
+	if (!done) {
+		/* Thread. */
+		TRACE("[Thread %2u] table %u (not finalized)\n",
+		      p->thread_id,
+		      table_id);
 
-	/* Thread. */
-	thread_ip_inc(p);
-}
+		thread_yield(p);
+		return;
+	}
 
-/*
- * emit.
- */
-static int
-instr_hdr_emit_translate(struct rte_swx_pipeline *p,
-			 struct action *action __rte_unused,
-			 char **tokens,
-			 int n_tokens,
-			 struct instruction *instr,
-			 struct instruction_data *data __rte_unused)
-{
-	struct header *h;
+	action_id = hit ? action_id : ts->default_action_id;
+	action_data = hit ? action_data : ts->default_action_data;
+	n_pkts_hit = stats->n_pkts_hit[hit];
+	n_pkts_action = stats->n_pkts_action[action_id];
 
-	CHECK(n_tokens == 2, EINVAL);
+	TRACE("[Thread %2u] table %u (%s, action %u)\n",
+	      p->thread_id,
+	      table_id,
+	      hit ? "hit" : "miss",
+	      (uint32_t)action_id);
 
-	h = header_parse(p, tokens[1]);
-	CHECK(h, EINVAL);
+	t->action_id = action_id;
+	t->structs[0] = action_data;
+	t->hit = hit;
+	stats->n_pkts_hit[hit] = n_pkts_hit + 1;
+	stats->n_pkts_action[action_id] = n_pkts_action + 1;
 
-	instr->type = INSTR_HDR_EMIT;
-	instr->io.hdr.header_id[0] = h->id;
-	instr->io.hdr.struct_id[0] = h->struct_id;
-	instr->io.hdr.n_bytes[0] = h->st->n_bits / 8;
-	return 0;
-}
+	/* Thread. */
+	if (p->action_funcs[action_id]) {
+		p->action_funcs[action_id](p);
+		thread_ip_inc(p);
+		return;
+	}
 
-static inline void
-__instr_hdr_emit_exec(struct rte_swx_pipeline *p, uint32_t n_emit);
+	thread_ip_action_call(p, t, action_id);
+}
 
 static inline void
-__instr_hdr_emit_exec(struct rte_swx_pipeline *p, uint32_t n_emit)
+instr_learner_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t valid_headers = t->valid_headers;
-	uint32_t n_headers_out = t->n_headers_out;
-	struct header_out_runtime *ho = &t->headers_out[n_headers_out - 1];
-	uint8_t *ho_ptr = NULL;
-	uint32_t ho_nbytes = 0, first = 1, i;
+	uint32_t learner_id = ip->table.table_id;
+	struct rte_swx_table_state *ts = &p->learner_state[learner_id];
+	struct learner_runtime *l = &t->learners[learner_id];
+	struct learner_statistics *stats = &p->learner_stats[learner_id];
+	uint64_t action_id, n_pkts_hit, n_pkts_action, time;
+	uint8_t *action_data;
+	int done, hit;
+
+	/* Table. */
+	time = rte_get_tsc_cycles();
+
+	done = rte_swx_table_learner_lookup(ts->obj,
+					    l->mailbox,
+					    time,
+					    l->key,
+					    &action_id,
+					    &action_data,
+					    &hit);
+	if (!done) {
+		/* Thread. */
+		TRACE("[Thread %2u] learner %u (not finalized)\n",
+		      p->thread_id,
+		      learner_id);
 
-	for (i = 0; i < n_emit; i++) {
-		uint32_t header_id = ip->io.hdr.header_id[i];
-		uint32_t struct_id = ip->io.hdr.struct_id[i];
-		uint32_t n_bytes = ip->io.hdr.n_bytes[i];
+		thread_yield(p);
+		return;
+	}
 
-		struct header_runtime *hi = &t->headers[header_id];
-		uint8_t *hi_ptr = t->structs[struct_id];
+	action_id = hit ? action_id : ts->default_action_id;
+	action_data = hit ? action_data : ts->default_action_data;
+	n_pkts_hit = stats->n_pkts_hit[hit];
+	n_pkts_action = stats->n_pkts_action[action_id];
 
-		if (!MASK64_BIT_GET(valid_headers, header_id))
-			continue;
+	TRACE("[Thread %2u] learner %u (%s, action %u)\n",
+	      p->thread_id,
+	      learner_id,
+	      hit ? "hit" : "miss",
+	      (uint32_t)action_id);
 
-		TRACE("[Thread %2u]: emit header %u\n",
-		      p->thread_id,
-		      header_id);
+	t->action_id = action_id;
+	t->structs[0] = action_data;
+	t->hit = hit;
+	t->learner_id = learner_id;
+	t->time = time;
+	stats->n_pkts_hit[hit] = n_pkts_hit + 1;
+	stats->n_pkts_action[action_id] = n_pkts_action + 1;
 
-		/* Headers. */
-		if (first) {
-			first = 0;
+	/* Thread. */
+	if (p->action_funcs[action_id]) {
+		p->action_funcs[action_id](p);
+		thread_ip_inc(p);
+		return;
+	}
 
-			if (!t->n_headers_out) {
-				ho = &t->headers_out[0];
+	thread_ip_action_call(p, t, action_id);
+}
 
-				ho->ptr0 = hi->ptr0;
-				ho->ptr = hi_ptr;
+/*
+ * learner.
+ */
+static struct action *
+action_find(struct rte_swx_pipeline *p, const char *name);
 
-				ho_ptr = hi_ptr;
-				ho_nbytes = n_bytes;
+static int
+instr_learn_translate(struct rte_swx_pipeline *p,
+		      struct action *action,
+		      char **tokens,
+		      int n_tokens,
+		      struct instruction *instr,
+		      struct instruction_data *data __rte_unused)
+{
+	struct action *a;
+	uint32_t mf_offset = 0;
 
-				n_headers_out = 1;
+	CHECK(action, EINVAL);
+	CHECK((n_tokens == 2) || (n_tokens == 3), EINVAL);
 
-				continue;
-			} else {
-				ho_ptr = ho->ptr;
-				ho_nbytes = ho->n_bytes;
-			}
-		}
+	/* The action being translated is not registered yet. */
+	a = strcmp(tokens[1], action->name) ?
+		action_find(p, tokens[1]) : action;
+	CHECK(a, EINVAL);
 
-		if (ho_ptr + ho_nbytes == hi_ptr) {
-			ho_nbytes += n_bytes;
-		} else {
-			ho->n_bytes = ho_nbytes;
+	if (n_tokens == 3) {
+		struct field *mf;
 
-			ho++;
-			ho->ptr0 = hi->ptr0;
-			ho->ptr = hi_ptr;
+		CHECK(a->st, EINVAL);
 
-			ho_ptr = hi_ptr;
-			ho_nbytes = n_bytes;
+		mf = metadata_field_parse(p, tokens[2]);
+		CHECK(mf, EINVAL);
 
-			n_headers_out++;
-		}
+		mf_offset = mf->offset / 8;
+	} else {
+		CHECK(!a->st, EINVAL);
 	}
 
-	ho->n_bytes = ho_nbytes;
-	t->n_headers_out = n_headers_out;
+	instr->type = INSTR_LEARNER_LEARN;
+	instr->learn.action_id = a->id;
+	instr->learn.mf_offset = mf_offset;
+	return 0;
 }
 
 static inline void
-instr_hdr_emit_exec(struct rte_swx_pipeline *p)
+instr_learn_exec(struct rte_swx_pipeline *p)
 {
-	__instr_hdr_emit_exec(p, 1);
+	struct thread *t = &p->threads[p->thread_id];
+	struct instruction *ip = t->ip;
 
-	/* Thread. */
-	thread_ip_inc(p);
-}
-
-static inline void
-instr_hdr_emit_tx_exec(struct rte_swx_pipeline *p)
-{
-	TRACE("[Thread %2u] *** The next 2 instructions are fused. ***\n",
-	      p->thread_id);
-
-	__instr_hdr_emit_exec(p, 1);
-	instr_tx_exec(p);
-}
-
-static inline void
-instr_hdr_emit2_tx_exec(struct rte_swx_pipeline *p)
-{
-	TRACE("[Thread %2u] *** The next 3 instructions are fused. ***\n",
-	      p->thread_id);
-
-	__instr_hdr_emit_exec(p, 2);
-	instr_tx_exec(p);
-}
-
-static inline void
-instr_hdr_emit3_tx_exec(struct rte_swx_pipeline *p)
-{
-	TRACE("[Thread %2u] *** The next 4 instructions are fused. ***\n",
-	      p->thread_id);
-
-	__instr_hdr_emit_exec(p, 3);
-	instr_tx_exec(p);
-}
-
-static inline void
-instr_hdr_emit4_tx_exec(struct rte_swx_pipeline *p)
-{
-	TRACE("[Thread %2u] *** The next 5 instructions are fused. ***\n",
-	      p->thread_id);
-
-	__instr_hdr_emit_exec(p, 4);
-	instr_tx_exec(p);
-}
-
-static inline void
-instr_hdr_emit5_tx_exec(struct rte_swx_pipeline *p)
-{
-	TRACE("[Thread %2u] *** The next 6 instructions are fused. ***\n",
-	      p->thread_id);
-
-	__instr_hdr_emit_exec(p, 5);
-	instr_tx_exec(p);
-}
-
-static inline void
-instr_hdr_emit6_tx_exec(struct rte_swx_pipeline *p)
-{
-	TRACE("[Thread %2u] *** The next 7 instructions are fused. ***\n",
-	      p->thread_id);
-
-	__instr_hdr_emit_exec(p, 6);
-	instr_tx_exec(p);
-}
-
-static inline void
-instr_hdr_emit7_tx_exec(struct rte_swx_pipeline *p)
-{
-	TRACE("[Thread %2u] *** The next 8 instructions are fused. ***\n",
-	      p->thread_id);
-
-	__instr_hdr_emit_exec(p, 7);
-	instr_tx_exec(p);
-}
-
-static inline void
-instr_hdr_emit8_tx_exec(struct rte_swx_pipeline *p)
-{
-	TRACE("[Thread %2u] *** The next 9 instructions are fused. ***\n",
-	      p->thread_id);
-
-	__instr_hdr_emit_exec(p, 8);
-	instr_tx_exec(p);
-}
-
-/*
- * validate.
- */
-static int
-instr_hdr_validate_translate(struct rte_swx_pipeline *p,
-			     struct action *action __rte_unused,
-			     char **tokens,
-			     int n_tokens,
-			     struct instruction *instr,
-			     struct instruction_data *data __rte_unused)
-{
-	struct header *h;
-
-	CHECK(n_tokens == 2, EINVAL);
-
-	h = header_parse(p, tokens[1]);
-	CHECK(h, EINVAL);
-
-	instr->type = INSTR_HDR_VALIDATE;
-	instr->valid.header_id = h->id;
-	return 0;
-}
-
-static inline void
-instr_hdr_validate_exec(struct rte_swx_pipeline *p)
-{
-	struct thread *t = &p->threads[p->thread_id];
-	struct instruction *ip = t->ip;
-	uint32_t header_id = ip->valid.header_id;
-
-	TRACE("[Thread %2u] validate header %u\n", p->thread_id, header_id);
-
-	/* Headers. */
-	t->valid_headers = MASK64_BIT_SET(t->valid_headers, header_id);
+	__instr_learner_learn_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
 }
 
-/*
- * invalidate.
- */
 static int
-instr_hdr_invalidate_translate(struct rte_swx_pipeline *p,
-			       struct action *action __rte_unused,
-			       char **tokens,
-			       int n_tokens,
-			       struct instruction *instr,
-			       struct instruction_data *data __rte_unused)
+instr_forget_translate(struct rte_swx_pipeline *p __rte_unused,
+		       struct action *action,
+		       char **tokens __rte_unused,
+		       int n_tokens,
+		       struct instruction *instr,
+		       struct instruction_data *data __rte_unused)
 {
-	struct header *h;
-
-	CHECK(n_tokens == 2, EINVAL);
-
-	h = header_parse(p, tokens[1]);
-	CHECK(h, EINVAL);
+	CHECK(action, EINVAL);
+	CHECK(n_tokens == 1, EINVAL);
 
-	instr->type = INSTR_HDR_INVALIDATE;
-	instr->valid.header_id = h->id;
+	instr->type = INSTR_LEARNER_FORGET;
 	return 0;
 }
 
 static inline void
-instr_hdr_invalidate_exec(struct rte_swx_pipeline *p)
+instr_forget_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint32_t header_id = ip->valid.header_id;
 
-	TRACE("[Thread %2u] invalidate header %u\n", p->thread_id, header_id);
-
-	/* Headers. */
-	t->valid_headers = MASK64_BIT_CLR(t->valid_headers, header_id);
+	__instr_learner_forget_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
 }
 
-/*
- * table.
- */
-static struct table *
-table_find(struct rte_swx_pipeline *p, const char *name);
-
-static int
-instr_table_translate(struct rte_swx_pipeline *p,
-		      struct action *action,
-		      char **tokens,
-		      int n_tokens,
-		      struct instruction *instr,
-		      struct instruction_data *data __rte_unused)
-{
-	struct table *t;
-
-	CHECK(!action, EINVAL);
-	CHECK(n_tokens == 2, EINVAL);
-
-	t = table_find(p, tokens[1]);
-	CHECK(t, EINVAL);
-
-	instr->type = INSTR_TABLE;
-	instr->table.table_id = t->id;
-	return 0;
-}
-
-static inline void
-instr_table_exec(struct rte_swx_pipeline *p)
-{
-	struct thread *t = &p->threads[p->thread_id];
-	struct instruction *ip = t->ip;
-	uint32_t table_id = ip->table.table_id;
-	struct rte_swx_table_state *ts = &t->table_state[table_id];
-	struct table_runtime *table = &t->tables[table_id];
-	struct table_statistics *stats = &p->table_stats[table_id];
-	uint64_t action_id, n_pkts_hit, n_pkts_action;
-	uint8_t *action_data;
-	int done, hit;
-
-	/* Table. */
-	done = table->func(ts->obj,
-			   table->mailbox,
-			   table->key,
-			   &action_id,
-			   &action_data,
-			   &hit);
-	if (!done) {
-		/* Thread. */
-		TRACE("[Thread %2u] table %u (not finalized)\n",
-		      p->thread_id,
-		      table_id);
-
-		thread_yield(p);
-		return;
-	}
-
-	action_id = hit ? action_id : ts->default_action_id;
-	action_data = hit ? action_data : ts->default_action_data;
-	n_pkts_hit = stats->n_pkts_hit[hit];
-	n_pkts_action = stats->n_pkts_action[action_id];
-
-	TRACE("[Thread %2u] table %u (%s, action %u)\n",
-	      p->thread_id,
-	      table_id,
-	      hit ? "hit" : "miss",
-	      (uint32_t)action_id);
-
-	t->action_id = action_id;
-	t->structs[0] = action_data;
-	t->hit = hit;
-	stats->n_pkts_hit[hit] = n_pkts_hit + 1;
-	stats->n_pkts_action[action_id] = n_pkts_action + 1;
-
-	/* Thread. */
-	thread_ip_action_call(p, t, action_id);
-}
-
 /*
  * extern.
  */
@@ -3571,18 +2411,10 @@ instr_extern_obj_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint32_t obj_id = ip->ext_obj.ext_obj_id;
-	uint32_t func_id = ip->ext_obj.func_id;
-	struct extern_obj_runtime *obj = &t->extern_objs[obj_id];
-	rte_swx_extern_type_member_func_t func = obj->funcs[func_id];
-
-	TRACE("[Thread %2u] extern obj %u member func %u\n",
-	      p->thread_id,
-	      obj_id,
-	      func_id);
+	uint32_t done;
 
 	/* Extern object member function execute. */
-	uint32_t done = func(obj->obj, obj->mailbox);
+	done = __instr_extern_obj_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc_cond(t, done);
@@ -3594,16 +2426,10 @@ instr_extern_func_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint32_t ext_func_id = ip->ext_func.ext_func_id;
-	struct extern_func_runtime *ext_func = &t->extern_funcs[ext_func_id];
-	rte_swx_extern_func_t func = ext_func->func;
-
-	TRACE("[Thread %2u] extern func %u\n",
-	      p->thread_id,
-	      ext_func_id);
+	uint32_t done;
 
 	/* Extern function execute. */
-	uint32_t done = func(ext_func->mailbox);
+	done = __instr_extern_func_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc_cond(t, done);
@@ -3672,10 +2498,7 @@ instr_mov_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] mov\n",
-	      p->thread_id);
-
-	MOV(t, ip);
+	__instr_mov_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -3687,10 +2510,7 @@ instr_mov_mh_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] mov (mh)\n",
-	      p->thread_id);
-
-	MOV_MH(t, ip);
+	__instr_mov_mh_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -3702,10 +2522,7 @@ instr_mov_hm_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] mov (hm)\n",
-	      p->thread_id);
-
-	MOV_HM(t, ip);
+	__instr_mov_hm_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -3717,10 +2534,7 @@ instr_mov_hh_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] mov (hh)\n",
-	      p->thread_id);
-
-	MOV_HH(t, ip);
+	__instr_mov_hh_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -3732,11 +2546,7 @@ instr_mov_i_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] mov m.f %" PRIx64 "\n",
-	      p->thread_id,
-	      ip->mov.src_val);
-
-	MOV_I(t, ip);
+	__instr_mov_i_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -3745,47 +2555,14 @@ instr_mov_i_exec(struct rte_swx_pipeline *p)
 /*
  * dma.
  */
-static inline void
-__instr_dma_ht_exec(struct rte_swx_pipeline *p, uint32_t n_dma);
 
 static inline void
-__instr_dma_ht_exec(struct rte_swx_pipeline *p, uint32_t n_dma)
+instr_dma_ht_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint8_t *action_data = t->structs[0];
-	uint64_t valid_headers = t->valid_headers;
-	uint32_t i;
-
-	for (i = 0; i < n_dma; i++) {
-		uint32_t header_id = ip->dma.dst.header_id[i];
-		uint32_t struct_id = ip->dma.dst.struct_id[i];
-		uint32_t offset = ip->dma.src.offset[i];
-		uint32_t n_bytes = ip->dma.n_bytes[i];
-
-		struct header_runtime *h = &t->headers[header_id];
-		uint8_t *h_ptr0 = h->ptr0;
-		uint8_t *h_ptr = t->structs[struct_id];
-
-		void *dst = MASK64_BIT_GET(valid_headers, header_id) ?
-			h_ptr : h_ptr0;
-		void *src = &action_data[offset];
-
-		TRACE("[Thread %2u] dma h.s t.f\n", p->thread_id);
 
-		/* Headers. */
-		memcpy(dst, src, n_bytes);
-		t->structs[struct_id] = dst;
-		valid_headers = MASK64_BIT_SET(valid_headers, header_id);
-	}
-
-	t->valid_headers = valid_headers;
-}
-
-static inline void
-instr_dma_ht_exec(struct rte_swx_pipeline *p)
-{
-	__instr_dma_ht_exec(p, 1);
+	__instr_dma_ht_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -3794,10 +2571,10 @@ instr_dma_ht_exec(struct rte_swx_pipeline *p)
 static inline void
 instr_dma_ht2_exec(struct rte_swx_pipeline *p)
 {
-	TRACE("[Thread %2u] *** The next 2 instructions are fused. ***\n",
-	      p->thread_id);
+	struct thread *t = &p->threads[p->thread_id];
+	struct instruction *ip = t->ip;
 
-	__instr_dma_ht_exec(p, 2);
+	__instr_dma_ht2_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -3806,10 +2583,10 @@ instr_dma_ht2_exec(struct rte_swx_pipeline *p)
 static inline void
 instr_dma_ht3_exec(struct rte_swx_pipeline *p)
 {
-	TRACE("[Thread %2u] *** The next 3 instructions are fused. ***\n",
-	      p->thread_id);
+	struct thread *t = &p->threads[p->thread_id];
+	struct instruction *ip = t->ip;
 
-	__instr_dma_ht_exec(p, 3);
+	__instr_dma_ht3_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -3818,10 +2595,10 @@ instr_dma_ht3_exec(struct rte_swx_pipeline *p)
 static inline void
 instr_dma_ht4_exec(struct rte_swx_pipeline *p)
 {
-	TRACE("[Thread %2u] *** The next 4 instructions are fused. ***\n",
-	      p->thread_id);
+	struct thread *t = &p->threads[p->thread_id];
+	struct instruction *ip = t->ip;
 
-	__instr_dma_ht_exec(p, 4);
+	__instr_dma_ht4_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -3830,10 +2607,10 @@ instr_dma_ht4_exec(struct rte_swx_pipeline *p)
 static inline void
 instr_dma_ht5_exec(struct rte_swx_pipeline *p)
 {
-	TRACE("[Thread %2u] *** The next 5 instructions are fused. ***\n",
-	      p->thread_id);
+	struct thread *t = &p->threads[p->thread_id];
+	struct instruction *ip = t->ip;
 
-	__instr_dma_ht_exec(p, 5);
+	__instr_dma_ht5_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -3842,10 +2619,10 @@ instr_dma_ht5_exec(struct rte_swx_pipeline *p)
 static inline void
 instr_dma_ht6_exec(struct rte_swx_pipeline *p)
 {
-	TRACE("[Thread %2u] *** The next 6 instructions are fused. ***\n",
-	      p->thread_id);
+	struct thread *t = &p->threads[p->thread_id];
+	struct instruction *ip = t->ip;
 
-	__instr_dma_ht_exec(p, 6);
+	__instr_dma_ht6_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -3854,10 +2631,10 @@ instr_dma_ht6_exec(struct rte_swx_pipeline *p)
 static inline void
 instr_dma_ht7_exec(struct rte_swx_pipeline *p)
 {
-	TRACE("[Thread %2u] *** The next 7 instructions are fused. ***\n",
-	      p->thread_id);
+	struct thread *t = &p->threads[p->thread_id];
+	struct instruction *ip = t->ip;
 
-	__instr_dma_ht_exec(p, 7);
+	__instr_dma_ht7_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -3866,10 +2643,10 @@ instr_dma_ht7_exec(struct rte_swx_pipeline *p)
 static inline void
 instr_dma_ht8_exec(struct rte_swx_pipeline *p)
 {
-	TRACE("[Thread %2u] *** The next 8 instructions are fused. ***\n",
-	      p->thread_id);
+	struct thread *t = &p->threads[p->thread_id];
+	struct instruction *ip = t->ip;
 
-	__instr_dma_ht_exec(p, 8);
+	__instr_dma_ht8_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4332,10 +3109,7 @@ instr_alu_add_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] add\n", p->thread_id);
-
-	/* Structs. */
-	ALU(t, ip, +);
+	__instr_alu_add_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4347,10 +3121,7 @@ instr_alu_add_mh_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] add (mh)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_MH(t, ip, +);
+	__instr_alu_add_mh_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4362,10 +3133,7 @@ instr_alu_add_hm_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] add (hm)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_HM(t, ip, +);
+	__instr_alu_add_hm_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4377,10 +3145,7 @@ instr_alu_add_hh_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] add (hh)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_HH(t, ip, +);
+	__instr_alu_add_hh_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4392,10 +3157,7 @@ instr_alu_add_mi_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] add (mi)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_MI(t, ip, +);
+	__instr_alu_add_mi_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4407,10 +3169,7 @@ instr_alu_add_hi_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] add (hi)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_HI(t, ip, +);
+	__instr_alu_add_hi_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4422,10 +3181,7 @@ instr_alu_sub_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] sub\n", p->thread_id);
-
-	/* Structs. */
-	ALU(t, ip, -);
+	__instr_alu_sub_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4437,10 +3193,7 @@ instr_alu_sub_mh_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] sub (mh)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_MH(t, ip, -);
+	__instr_alu_sub_mh_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4452,10 +3205,7 @@ instr_alu_sub_hm_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] sub (hm)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_HM(t, ip, -);
+	__instr_alu_sub_hm_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4467,10 +3217,7 @@ instr_alu_sub_hh_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] sub (hh)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_HH(t, ip, -);
+	__instr_alu_sub_hh_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4482,10 +3229,7 @@ instr_alu_sub_mi_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] sub (mi)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_MI(t, ip, -);
+	__instr_alu_sub_mi_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4497,10 +3241,7 @@ instr_alu_sub_hi_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] sub (hi)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_HI(t, ip, -);
+	__instr_alu_sub_hi_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4512,10 +3253,7 @@ instr_alu_shl_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] shl\n", p->thread_id);
-
-	/* Structs. */
-	ALU(t, ip, <<);
+	__instr_alu_shl_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4527,10 +3265,7 @@ instr_alu_shl_mh_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] shl (mh)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_MH(t, ip, <<);
+	__instr_alu_shl_mh_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4542,10 +3277,7 @@ instr_alu_shl_hm_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] shl (hm)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_HM(t, ip, <<);
+	__instr_alu_shl_hm_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4557,10 +3289,7 @@ instr_alu_shl_hh_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] shl (hh)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_HH(t, ip, <<);
+	__instr_alu_shl_hh_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4572,10 +3301,7 @@ instr_alu_shl_mi_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] shl (mi)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_MI(t, ip, <<);
+	__instr_alu_shl_mi_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4587,10 +3313,7 @@ instr_alu_shl_hi_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] shl (hi)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_HI(t, ip, <<);
+	__instr_alu_shl_hi_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4602,10 +3325,7 @@ instr_alu_shr_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] shr\n", p->thread_id);
-
-	/* Structs. */
-	ALU(t, ip, >>);
+	__instr_alu_shr_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4617,10 +3337,7 @@ instr_alu_shr_mh_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] shr (mh)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_MH(t, ip, >>);
+	__instr_alu_shr_mh_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4632,10 +3349,7 @@ instr_alu_shr_hm_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] shr (hm)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_HM(t, ip, >>);
+	__instr_alu_shr_hm_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4647,10 +3361,7 @@ instr_alu_shr_hh_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] shr (hh)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_HH(t, ip, >>);
+	__instr_alu_shr_hh_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4662,10 +3373,7 @@ instr_alu_shr_mi_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] shr (mi)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_MI(t, ip, >>);
+	__instr_alu_shr_mi_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4677,10 +3385,7 @@ instr_alu_shr_hi_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] shr (hi)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_HI(t, ip, >>);
+	__instr_alu_shr_hi_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4692,10 +3397,7 @@ instr_alu_and_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] and\n", p->thread_id);
-
-	/* Structs. */
-	ALU(t, ip, &);
+	__instr_alu_and_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4707,10 +3409,7 @@ instr_alu_and_mh_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] and (mh)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_MH(t, ip, &);
+	__instr_alu_and_mh_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4722,10 +3421,7 @@ instr_alu_and_hm_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] and (hm)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_HM_FAST(t, ip, &);
+	__instr_alu_and_hm_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4737,10 +3433,7 @@ instr_alu_and_hh_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] and (hh)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_HH_FAST(t, ip, &);
+	__instr_alu_and_hh_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4752,10 +3445,7 @@ instr_alu_and_i_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] and (i)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_I(t, ip, &);
+	__instr_alu_and_i_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4767,10 +3457,7 @@ instr_alu_or_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] or\n", p->thread_id);
-
-	/* Structs. */
-	ALU(t, ip, |);
+	__instr_alu_or_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4782,10 +3469,7 @@ instr_alu_or_mh_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] or (mh)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_MH(t, ip, |);
+	__instr_alu_or_mh_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4797,10 +3481,7 @@ instr_alu_or_hm_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] or (hm)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_HM_FAST(t, ip, |);
+	__instr_alu_or_hm_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4812,10 +3493,7 @@ instr_alu_or_hh_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] or (hh)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_HH_FAST(t, ip, |);
+	__instr_alu_or_hh_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4827,10 +3505,7 @@ instr_alu_or_i_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] or (i)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_I(t, ip, |);
+	__instr_alu_or_i_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4842,10 +3517,7 @@ instr_alu_xor_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] xor\n", p->thread_id);
-
-	/* Structs. */
-	ALU(t, ip, ^);
+	__instr_alu_xor_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4857,10 +3529,7 @@ instr_alu_xor_mh_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] xor (mh)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_MH(t, ip, ^);
+	__instr_alu_xor_mh_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4872,10 +3541,7 @@ instr_alu_xor_hm_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] xor (hm)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_HM_FAST(t, ip, ^);
+	__instr_alu_xor_hm_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4887,10 +3553,7 @@ instr_alu_xor_hh_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] xor (hh)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_HH_FAST(t, ip, ^);
+	__instr_alu_xor_hh_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4902,10 +3565,7 @@ instr_alu_xor_i_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] xor (i)\n", p->thread_id);
-
-	/* Structs. */
-	ALU_I(t, ip, ^);
+	__instr_alu_xor_i_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4916,55 +3576,8 @@ instr_alu_ckadd_field_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint8_t *dst_struct, *src_struct;
-	uint16_t *dst16_ptr, dst;
-	uint64_t *src64_ptr, src64, src64_mask, src;
-	uint64_t r;
-
-	TRACE("[Thread %2u] ckadd (field)\n", p->thread_id);
-
-	/* Structs. */
-	dst_struct = t->structs[ip->alu.dst.struct_id];
-	dst16_ptr = (uint16_t *)&dst_struct[ip->alu.dst.offset];
-	dst = *dst16_ptr;
-
-	src_struct = t->structs[ip->alu.src.struct_id];
-	src64_ptr = (uint64_t *)&src_struct[ip->alu.src.offset];
-	src64 = *src64_ptr;
-	src64_mask = UINT64_MAX >> (64 - ip->alu.src.n_bits);
-	src = src64 & src64_mask;
-
-	r = dst;
-	r = ~r & 0xFFFF;
-
-	/* The first input (r) is a 16-bit number. The second and the third
-	 * inputs are 32-bit numbers. In the worst case scenario, the sum of the
-	 * three numbers (output r) is a 34-bit number.
-	 */
-	r += (src >> 32) + (src & 0xFFFFFFFF);
 
-	/* The first input is a 16-bit number. The second input is an 18-bit
-	 * number. In the worst case scenario, the sum of the two numbers is a
-	 * 19-bit number.
-	 */
-	r = (r & 0xFFFF) + (r >> 16);
-
-	/* The first input is a 16-bit number (0 .. 0xFFFF). The second input is
-	 * a 3-bit number (0 .. 7). Their sum is a 17-bit number (0 .. 0x10006).
-	 */
-	r = (r & 0xFFFF) + (r >> 16);
-
-	/* When the input r is (0 .. 0xFFFF), the output r is equal to the input
-	 * r, so the output is (0 .. 0xFFFF). When the input r is (0x10000 ..
-	 * 0x10006), the output r is (0 .. 7). So no carry bit can be generated,
-	 * therefore the output r is always a 16-bit number.
-	 */
-	r = (r & 0xFFFF) + (r >> 16);
-
-	r = ~r & 0xFFFF;
-	r = r ? r : 0xFFFF;
-
-	*dst16_ptr = (uint16_t)r;
+	__instr_alu_ckadd_field_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -4975,67 +3588,8 @@ instr_alu_cksub_field_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint8_t *dst_struct, *src_struct;
-	uint16_t *dst16_ptr, dst;
-	uint64_t *src64_ptr, src64, src64_mask, src;
-	uint64_t r;
-
-	TRACE("[Thread %2u] cksub (field)\n", p->thread_id);
-
-	/* Structs. */
-	dst_struct = t->structs[ip->alu.dst.struct_id];
-	dst16_ptr = (uint16_t *)&dst_struct[ip->alu.dst.offset];
-	dst = *dst16_ptr;
-
-	src_struct = t->structs[ip->alu.src.struct_id];
-	src64_ptr = (uint64_t *)&src_struct[ip->alu.src.offset];
-	src64 = *src64_ptr;
-	src64_mask = UINT64_MAX >> (64 - ip->alu.src.n_bits);
-	src = src64 & src64_mask;
-
-	r = dst;
-	r = ~r & 0xFFFF;
-
-	/* Subtraction in 1's complement arithmetic (i.e. a '- b) is the same as
-	 * the following sequence of operations in 2's complement arithmetic:
-	 *    a '- b = (a - b) % 0xFFFF.
-	 *
-	 * In order to prevent an underflow for the below subtraction, in which
-	 * a 33-bit number (the subtrahend) is taken out of a 16-bit number (the
-	 * minuend), we first add a multiple of the 0xFFFF modulus to the
-	 * minuend. The number we add to the minuend needs to be a 34-bit number
-	 * or higher, so for readability reasons we picked the 36-bit multiple.
-	 * We are effectively turning the 16-bit minuend into a 36-bit number:
-	 *    (a - b) % 0xFFFF = (a + 0xFFFF00000 - b) % 0xFFFF.
-	 */
-	r += 0xFFFF00000ULL; /* The output r is a 36-bit number. */
-
-	/* A 33-bit number is subtracted from a 36-bit number (the input r). The
-	 * result (the output r) is a 36-bit number.
-	 */
-	r -= (src >> 32) + (src & 0xFFFFFFFF);
-
-	/* The first input is a 16-bit number. The second input is a 20-bit
-	 * number. Their sum is a 21-bit number.
-	 */
-	r = (r & 0xFFFF) + (r >> 16);
-
-	/* The first input is a 16-bit number (0 .. 0xFFFF). The second input is
-	 * a 5-bit number (0 .. 31). The sum is a 17-bit number (0 .. 0x1001E).
-	 */
-	r = (r & 0xFFFF) + (r >> 16);
-
-	/* When the input r is (0 .. 0xFFFF), the output r is equal to the input
-	 * r, so the output is (0 .. 0xFFFF). When the input r is (0x10000 ..
-	 * 0x1001E), the output r is (0 .. 31). So no carry bit can be
-	 * generated, therefore the output r is always a 16-bit number.
-	 */
-	r = (r & 0xFFFF) + (r >> 16);
-
-	r = ~r & 0xFFFF;
-	r = r ? r : 0xFFFF;
 
-	*dst16_ptr = (uint16_t)r;
+	__instr_alu_cksub_field_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -5046,47 +3600,8 @@ instr_alu_ckadd_struct20_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint8_t *dst_struct, *src_struct;
-	uint16_t *dst16_ptr;
-	uint32_t *src32_ptr;
-	uint64_t r0, r1;
-
-	TRACE("[Thread %2u] ckadd (struct of 20 bytes)\n", p->thread_id);
-
-	/* Structs. */
-	dst_struct = t->structs[ip->alu.dst.struct_id];
-	dst16_ptr = (uint16_t *)&dst_struct[ip->alu.dst.offset];
-
-	src_struct = t->structs[ip->alu.src.struct_id];
-	src32_ptr = (uint32_t *)&src_struct[0];
-
-	r0 = src32_ptr[0]; /* r0 is a 32-bit number. */
-	r1 = src32_ptr[1]; /* r1 is a 32-bit number. */
-	r0 += src32_ptr[2]; /* The output r0 is a 33-bit number. */
-	r1 += src32_ptr[3]; /* The output r1 is a 33-bit number. */
-	r0 += r1 + src32_ptr[4]; /* The output r0 is a 35-bit number. */
-
-	/* The first input is a 16-bit number. The second input is a 19-bit
-	 * number. Their sum is a 20-bit number.
-	 */
-	r0 = (r0 & 0xFFFF) + (r0 >> 16);
-
-	/* The first input is a 16-bit number (0 .. 0xFFFF). The second input is
-	 * a 4-bit number (0 .. 15). The sum is a 17-bit number (0 .. 0x1000E).
-	 */
-	r0 = (r0 & 0xFFFF) + (r0 >> 16);
-
-	/* When the input r is (0 .. 0xFFFF), the output r is equal to the input
-	 * r, so the output is (0 .. 0xFFFF). When the input r is (0x10000 ..
-	 * 0x1000E), the output r is (0 .. 15). So no carry bit can be
-	 * generated, therefore the output r is always a 16-bit number.
-	 */
-	r0 = (r0 & 0xFFFF) + (r0 >> 16);
 
-	r0 = ~r0 & 0xFFFF;
-	r0 = r0 ? r0 : 0xFFFF;
-
-	*dst16_ptr = (uint16_t)r0;
+	__instr_alu_ckadd_struct20_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -5097,49 +3612,8 @@ instr_alu_ckadd_struct_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint8_t *dst_struct, *src_struct;
-	uint16_t *dst16_ptr;
-	uint32_t *src32_ptr;
-	uint64_t r = 0;
-	uint32_t i;
-
-	TRACE("[Thread %2u] ckadd (struct)\n", p->thread_id);
-
-	/* Structs. */
-	dst_struct = t->structs[ip->alu.dst.struct_id];
-	dst16_ptr = (uint16_t *)&dst_struct[ip->alu.dst.offset];
-
-	src_struct = t->structs[ip->alu.src.struct_id];
-	src32_ptr = (uint32_t *)&src_struct[0];
-
-	/* The max number of 32-bit words in a 256-byte header is 8 = 2^3.
-	 * Therefore, in the worst case scenario, a 35-bit number is added to a
-	 * 16-bit number (the input r), so the output r is 36-bit number.
-	 */
-	for (i = 0; i < ip->alu.src.n_bits / 32; i++, src32_ptr++)
-		r += *src32_ptr;
-
-	/* The first input is a 16-bit number. The second input is a 20-bit
-	 * number. Their sum is a 21-bit number.
-	 */
-	r = (r & 0xFFFF) + (r >> 16);
-
-	/* The first input is a 16-bit number (0 .. 0xFFFF). The second input is
-	 * a 5-bit number (0 .. 31). The sum is a 17-bit number (0 .. 0x1000E).
-	 */
-	r = (r & 0xFFFF) + (r >> 16);
-
-	/* When the input r is (0 .. 0xFFFF), the output r is equal to the input
-	 * r, so the output is (0 .. 0xFFFF). When the input r is (0x10000 ..
-	 * 0x1001E), the output r is (0 .. 31). So no carry bit can be
-	 * generated, therefore the output r is always a 16-bit number.
-	 */
-	r = (r & 0xFFFF) + (r >> 16);
-
-	r = ~r & 0xFFFF;
-	r = r ? r : 0xFFFF;
 
-	*dst16_ptr = (uint16_t)r;
+	__instr_alu_ckadd_struct_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -5430,134 +3904,13 @@ instr_regadd_translate(struct rte_swx_pipeline *p,
 	return 0;
 }
 
-static inline uint64_t *
-instr_regarray_regarray(struct rte_swx_pipeline *p, struct instruction *ip)
-{
-	struct regarray_runtime *r = &p->regarray_runtime[ip->regarray.regarray_id];
-	return r->regarray;
-}
-
-static inline uint64_t
-instr_regarray_idx_hbo(struct rte_swx_pipeline *p, struct thread *t, struct instruction *ip)
-{
-	struct regarray_runtime *r = &p->regarray_runtime[ip->regarray.regarray_id];
-
-	uint8_t *idx_struct = t->structs[ip->regarray.idx.struct_id];
-	uint64_t *idx64_ptr = (uint64_t *)&idx_struct[ip->regarray.idx.offset];
-	uint64_t idx64 = *idx64_ptr;
-	uint64_t idx64_mask = UINT64_MAX >> (64 - ip->regarray.idx.n_bits);
-	uint64_t idx = idx64 & idx64_mask & r->size_mask;
-
-	return idx;
-}
-
-#if RTE_BYTE_ORDER == RTE_LITTLE_ENDIAN
-
-static inline uint64_t
-instr_regarray_idx_nbo(struct rte_swx_pipeline *p, struct thread *t, struct instruction *ip)
-{
-	struct regarray_runtime *r = &p->regarray_runtime[ip->regarray.regarray_id];
-
-	uint8_t *idx_struct = t->structs[ip->regarray.idx.struct_id];
-	uint64_t *idx64_ptr = (uint64_t *)&idx_struct[ip->regarray.idx.offset];
-	uint64_t idx64 = *idx64_ptr;
-	uint64_t idx = (ntoh64(idx64) >> (64 - ip->regarray.idx.n_bits)) & r->size_mask;
-
-	return idx;
-}
-
-#else
-
-#define instr_regarray_idx_nbo instr_regarray_idx_hbo
-
-#endif
-
-static inline uint64_t
-instr_regarray_idx_imm(struct rte_swx_pipeline *p, struct instruction *ip)
-{
-	struct regarray_runtime *r = &p->regarray_runtime[ip->regarray.regarray_id];
-
-	uint64_t idx = ip->regarray.idx_val & r->size_mask;
-
-	return idx;
-}
-
-static inline uint64_t
-instr_regarray_src_hbo(struct thread *t, struct instruction *ip)
-{
-	uint8_t *src_struct = t->structs[ip->regarray.dstsrc.struct_id];
-	uint64_t *src64_ptr = (uint64_t *)&src_struct[ip->regarray.dstsrc.offset];
-	uint64_t src64 = *src64_ptr;
-	uint64_t src64_mask = UINT64_MAX >> (64 - ip->regarray.dstsrc.n_bits);
-	uint64_t src = src64 & src64_mask;
-
-	return src;
-}
-
-#if RTE_BYTE_ORDER == RTE_LITTLE_ENDIAN
-
-static inline uint64_t
-instr_regarray_src_nbo(struct thread *t, struct instruction *ip)
-{
-	uint8_t *src_struct = t->structs[ip->regarray.dstsrc.struct_id];
-	uint64_t *src64_ptr = (uint64_t *)&src_struct[ip->regarray.dstsrc.offset];
-	uint64_t src64 = *src64_ptr;
-	uint64_t src = ntoh64(src64) >> (64 - ip->regarray.dstsrc.n_bits);
-
-	return src;
-}
-
-#else
-
-#define instr_regarray_src_nbo instr_regarray_src_hbo
-
-#endif
-
-static inline void
-instr_regarray_dst_hbo_src_hbo_set(struct thread *t, struct instruction *ip, uint64_t src)
-{
-	uint8_t *dst_struct = t->structs[ip->regarray.dstsrc.struct_id];
-	uint64_t *dst64_ptr = (uint64_t *)&dst_struct[ip->regarray.dstsrc.offset];
-	uint64_t dst64 = *dst64_ptr;
-	uint64_t dst64_mask = UINT64_MAX >> (64 - ip->regarray.dstsrc.n_bits);
-
-	*dst64_ptr = (dst64 & ~dst64_mask) | (src & dst64_mask);
-
-}
-
-#if RTE_BYTE_ORDER == RTE_LITTLE_ENDIAN
-
-static inline void
-instr_regarray_dst_nbo_src_hbo_set(struct thread *t, struct instruction *ip, uint64_t src)
-{
-	uint8_t *dst_struct = t->structs[ip->regarray.dstsrc.struct_id];
-	uint64_t *dst64_ptr = (uint64_t *)&dst_struct[ip->regarray.dstsrc.offset];
-	uint64_t dst64 = *dst64_ptr;
-	uint64_t dst64_mask = UINT64_MAX >> (64 - ip->regarray.dstsrc.n_bits);
-
-	src = hton64(src) >> (64 - ip->regarray.dstsrc.n_bits);
-	*dst64_ptr = (dst64 & ~dst64_mask) | (src & dst64_mask);
-}
-
-#else
-
-#define instr_regarray_dst_nbo_src_hbo_set instr_regarray_dst_hbo_src_hbo_set
-
-#endif
-
 static inline void
 instr_regprefetch_rh_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t *regarray, idx;
-
-	TRACE("[Thread %2u] regprefetch (r[h])\n", p->thread_id);
 
-	/* Structs. */
-	regarray = instr_regarray_regarray(p, ip);
-	idx = instr_regarray_idx_nbo(p, t, ip);
-	rte_prefetch0(&regarray[idx]);
+	__instr_regprefetch_rh_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -5568,14 +3921,8 @@ instr_regprefetch_rm_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t *regarray, idx;
 
-	TRACE("[Thread %2u] regprefetch (r[m])\n", p->thread_id);
-
-	/* Structs. */
-	regarray = instr_regarray_regarray(p, ip);
-	idx = instr_regarray_idx_hbo(p, t, ip);
-	rte_prefetch0(&regarray[idx]);
+	__instr_regprefetch_rm_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -5586,14 +3933,8 @@ instr_regprefetch_ri_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t *regarray, idx;
-
-	TRACE("[Thread %2u] regprefetch (r[i])\n", p->thread_id);
 
-	/* Structs. */
-	regarray = instr_regarray_regarray(p, ip);
-	idx = instr_regarray_idx_imm(p, ip);
-	rte_prefetch0(&regarray[idx]);
+	__instr_regprefetch_ri_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -5604,14 +3945,8 @@ instr_regrd_hrh_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t *regarray, idx;
 
-	TRACE("[Thread %2u] regrd (h = r[h])\n", p->thread_id);
-
-	/* Structs. */
-	regarray = instr_regarray_regarray(p, ip);
-	idx = instr_regarray_idx_nbo(p, t, ip);
-	instr_regarray_dst_nbo_src_hbo_set(t, ip, regarray[idx]);
+	__instr_regrd_hrh_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -5622,14 +3957,8 @@ instr_regrd_hrm_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t *regarray, idx;
-
-	TRACE("[Thread %2u] regrd (h = r[m])\n", p->thread_id);
 
-	/* Structs. */
-	regarray = instr_regarray_regarray(p, ip);
-	idx = instr_regarray_idx_hbo(p, t, ip);
-	instr_regarray_dst_nbo_src_hbo_set(t, ip, regarray[idx]);
+	__instr_regrd_hrm_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -5640,14 +3969,8 @@ instr_regrd_mrh_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t *regarray, idx;
 
-	TRACE("[Thread %2u] regrd (m = r[h])\n", p->thread_id);
-
-	/* Structs. */
-	regarray = instr_regarray_regarray(p, ip);
-	idx = instr_regarray_idx_nbo(p, t, ip);
-	instr_regarray_dst_hbo_src_hbo_set(t, ip, regarray[idx]);
+	__instr_regrd_mrh_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -5658,12 +3981,8 @@ instr_regrd_mrm_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t *regarray, idx;
 
-	/* Structs. */
-	regarray = instr_regarray_regarray(p, ip);
-	idx = instr_regarray_idx_hbo(p, t, ip);
-	instr_regarray_dst_hbo_src_hbo_set(t, ip, regarray[idx]);
+	__instr_regrd_mrm_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -5674,14 +3993,8 @@ instr_regrd_hri_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t *regarray, idx;
-
-	TRACE("[Thread %2u] regrd (h = r[i])\n", p->thread_id);
 
-	/* Structs. */
-	regarray = instr_regarray_regarray(p, ip);
-	idx = instr_regarray_idx_imm(p, ip);
-	instr_regarray_dst_nbo_src_hbo_set(t, ip, regarray[idx]);
+	__instr_regrd_hri_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -5692,14 +4005,8 @@ instr_regrd_mri_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t *regarray, idx;
 
-	TRACE("[Thread %2u] regrd (m = r[i])\n", p->thread_id);
-
-	/* Structs. */
-	regarray = instr_regarray_regarray(p, ip);
-	idx = instr_regarray_idx_imm(p, ip);
-	instr_regarray_dst_hbo_src_hbo_set(t, ip, regarray[idx]);
+	__instr_regrd_mri_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -5710,15 +4017,8 @@ instr_regwr_rhh_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t *regarray, idx, src;
-
-	TRACE("[Thread %2u] regwr (r[h] = h)\n", p->thread_id);
 
-	/* Structs. */
-	regarray = instr_regarray_regarray(p, ip);
-	idx = instr_regarray_idx_nbo(p, t, ip);
-	src = instr_regarray_src_nbo(t, ip);
-	regarray[idx] = src;
+	__instr_regwr_rhh_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -5729,15 +4029,8 @@ instr_regwr_rhm_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t *regarray, idx, src;
 
-	TRACE("[Thread %2u] regwr (r[h] = m)\n", p->thread_id);
-
-	/* Structs. */
-	regarray = instr_regarray_regarray(p, ip);
-	idx = instr_regarray_idx_nbo(p, t, ip);
-	src = instr_regarray_src_hbo(t, ip);
-	regarray[idx] = src;
+	__instr_regwr_rhm_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -5748,15 +4041,8 @@ instr_regwr_rmh_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t *regarray, idx, src;
-
-	TRACE("[Thread %2u] regwr (r[m] = h)\n", p->thread_id);
 
-	/* Structs. */
-	regarray = instr_regarray_regarray(p, ip);
-	idx = instr_regarray_idx_hbo(p, t, ip);
-	src = instr_regarray_src_nbo(t, ip);
-	regarray[idx] = src;
+	__instr_regwr_rmh_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -5767,15 +4053,8 @@ instr_regwr_rmm_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t *regarray, idx, src;
 
-	TRACE("[Thread %2u] regwr (r[m] = m)\n", p->thread_id);
-
-	/* Structs. */
-	regarray = instr_regarray_regarray(p, ip);
-	idx = instr_regarray_idx_hbo(p, t, ip);
-	src = instr_regarray_src_hbo(t, ip);
-	regarray[idx] = src;
+	__instr_regwr_rmm_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -5786,15 +4065,8 @@ instr_regwr_rhi_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t *regarray, idx, src;
-
-	TRACE("[Thread %2u] regwr (r[h] = i)\n", p->thread_id);
 
-	/* Structs. */
-	regarray = instr_regarray_regarray(p, ip);
-	idx = instr_regarray_idx_nbo(p, t, ip);
-	src = ip->regarray.dstsrc_val;
-	regarray[idx] = src;
+	__instr_regwr_rhi_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -5805,15 +4077,8 @@ instr_regwr_rmi_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t *regarray, idx, src;
 
-	TRACE("[Thread %2u] regwr (r[m] = i)\n", p->thread_id);
-
-	/* Structs. */
-	regarray = instr_regarray_regarray(p, ip);
-	idx = instr_regarray_idx_hbo(p, t, ip);
-	src = ip->regarray.dstsrc_val;
-	regarray[idx] = src;
+	__instr_regwr_rmi_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -5824,15 +4089,8 @@ instr_regwr_rih_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t *regarray, idx, src;
-
-	TRACE("[Thread %2u] regwr (r[i] = h)\n", p->thread_id);
 
-	/* Structs. */
-	regarray = instr_regarray_regarray(p, ip);
-	idx = instr_regarray_idx_imm(p, ip);
-	src = instr_regarray_src_nbo(t, ip);
-	regarray[idx] = src;
+	__instr_regwr_rih_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -5843,15 +4101,8 @@ instr_regwr_rim_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t *regarray, idx, src;
 
-	TRACE("[Thread %2u] regwr (r[i] = m)\n", p->thread_id);
-
-	/* Structs. */
-	regarray = instr_regarray_regarray(p, ip);
-	idx = instr_regarray_idx_imm(p, ip);
-	src = instr_regarray_src_hbo(t, ip);
-	regarray[idx] = src;
+	__instr_regwr_rim_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -5862,15 +4113,8 @@ instr_regwr_rii_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t *regarray, idx, src;
-
-	TRACE("[Thread %2u] regwr (r[i] = i)\n", p->thread_id);
 
-	/* Structs. */
-	regarray = instr_regarray_regarray(p, ip);
-	idx = instr_regarray_idx_imm(p, ip);
-	src = ip->regarray.dstsrc_val;
-	regarray[idx] = src;
+	__instr_regwr_rii_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -5881,15 +4125,8 @@ instr_regadd_rhh_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t *regarray, idx, src;
 
-	TRACE("[Thread %2u] regadd (r[h] += h)\n", p->thread_id);
-
-	/* Structs. */
-	regarray = instr_regarray_regarray(p, ip);
-	idx = instr_regarray_idx_nbo(p, t, ip);
-	src = instr_regarray_src_nbo(t, ip);
-	regarray[idx] += src;
+	__instr_regadd_rhh_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -5900,15 +4137,8 @@ instr_regadd_rhm_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t *regarray, idx, src;
-
-	TRACE("[Thread %2u] regadd (r[h] += m)\n", p->thread_id);
 
-	/* Structs. */
-	regarray = instr_regarray_regarray(p, ip);
-	idx = instr_regarray_idx_nbo(p, t, ip);
-	src = instr_regarray_src_hbo(t, ip);
-	regarray[idx] += src;
+	__instr_regadd_rhm_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -5919,15 +4149,8 @@ instr_regadd_rmh_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t *regarray, idx, src;
 
-	TRACE("[Thread %2u] regadd (r[m] += h)\n", p->thread_id);
-
-	/* Structs. */
-	regarray = instr_regarray_regarray(p, ip);
-	idx = instr_regarray_idx_hbo(p, t, ip);
-	src = instr_regarray_src_nbo(t, ip);
-	regarray[idx] += src;
+	__instr_regadd_rmh_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -5938,15 +4161,8 @@ instr_regadd_rmm_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t *regarray, idx, src;
-
-	TRACE("[Thread %2u] regadd (r[m] += m)\n", p->thread_id);
 
-	/* Structs. */
-	regarray = instr_regarray_regarray(p, ip);
-	idx = instr_regarray_idx_hbo(p, t, ip);
-	src = instr_regarray_src_hbo(t, ip);
-	regarray[idx] += src;
+	__instr_regadd_rmm_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -5957,15 +4173,8 @@ instr_regadd_rhi_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t *regarray, idx, src;
 
-	TRACE("[Thread %2u] regadd (r[h] += i)\n", p->thread_id);
-
-	/* Structs. */
-	regarray = instr_regarray_regarray(p, ip);
-	idx = instr_regarray_idx_nbo(p, t, ip);
-	src = ip->regarray.dstsrc_val;
-	regarray[idx] += src;
+	__instr_regadd_rhi_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -5976,15 +4185,8 @@ instr_regadd_rmi_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t *regarray, idx, src;
-
-	TRACE("[Thread %2u] regadd (r[m] += i)\n", p->thread_id);
 
-	/* Structs. */
-	regarray = instr_regarray_regarray(p, ip);
-	idx = instr_regarray_idx_hbo(p, t, ip);
-	src = ip->regarray.dstsrc_val;
-	regarray[idx] += src;
+	__instr_regadd_rmi_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -5995,15 +4197,8 @@ instr_regadd_rih_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t *regarray, idx, src;
 
-	TRACE("[Thread %2u] regadd (r[i] += h)\n", p->thread_id);
-
-	/* Structs. */
-	regarray = instr_regarray_regarray(p, ip);
-	idx = instr_regarray_idx_imm(p, ip);
-	src = instr_regarray_src_nbo(t, ip);
-	regarray[idx] += src;
+	__instr_regadd_rih_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -6014,15 +4209,8 @@ instr_regadd_rim_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t *regarray, idx, src;
-
-	TRACE("[Thread %2u] regadd (r[i] += m)\n", p->thread_id);
 
-	/* Structs. */
-	regarray = instr_regarray_regarray(p, ip);
-	idx = instr_regarray_idx_imm(p, ip);
-	src = instr_regarray_src_hbo(t, ip);
-	regarray[idx] += src;
+	__instr_regadd_rim_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -6033,15 +4221,8 @@ instr_regadd_rii_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint64_t *regarray, idx, src;
 
-	TRACE("[Thread %2u] regadd (r[i] += i)\n", p->thread_id);
-
-	/* Structs. */
-	regarray = instr_regarray_regarray(p, ip);
-	idx = instr_regarray_idx_imm(p, ip);
-	src = ip->regarray.dstsrc_val;
-	regarray[idx] += src;
+	__instr_regadd_rii_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -6252,425 +4433,120 @@ instr_meter_translate(struct rte_swx_pipeline *p,
 	CHECK(0, EINVAL);
 }
 
-static inline struct meter *
-instr_meter_idx_hbo(struct rte_swx_pipeline *p, struct thread *t, struct instruction *ip)
+static inline void
+instr_metprefetch_h_exec(struct rte_swx_pipeline *p)
 {
-	struct metarray_runtime *r = &p->metarray_runtime[ip->meter.metarray_id];
+	struct thread *t = &p->threads[p->thread_id];
+	struct instruction *ip = t->ip;
 
-	uint8_t *idx_struct = t->structs[ip->meter.idx.struct_id];
-	uint64_t *idx64_ptr = (uint64_t *)&idx_struct[ip->meter.idx.offset];
-	uint64_t idx64 = *idx64_ptr;
-	uint64_t idx64_mask = UINT64_MAX >> (64 - (ip)->meter.idx.n_bits);
-	uint64_t idx = idx64 & idx64_mask & r->size_mask;
+	__instr_metprefetch_h_exec(p, t, ip);
 
-	return &r->metarray[idx];
+	/* Thread. */
+	thread_ip_inc(p);
 }
 
-#if RTE_BYTE_ORDER == RTE_LITTLE_ENDIAN
-
-static inline struct meter *
-instr_meter_idx_nbo(struct rte_swx_pipeline *p, struct thread *t, struct instruction *ip)
+static inline void
+instr_metprefetch_m_exec(struct rte_swx_pipeline *p)
 {
-	struct metarray_runtime *r = &p->metarray_runtime[ip->meter.metarray_id];
+	struct thread *t = &p->threads[p->thread_id];
+	struct instruction *ip = t->ip;
 
-	uint8_t *idx_struct = t->structs[ip->meter.idx.struct_id];
-	uint64_t *idx64_ptr = (uint64_t *)&idx_struct[ip->meter.idx.offset];
-	uint64_t idx64 = *idx64_ptr;
-	uint64_t idx = (ntoh64(idx64) >> (64 - ip->meter.idx.n_bits)) & r->size_mask;
+	__instr_metprefetch_m_exec(p, t, ip);
 
-	return &r->metarray[idx];
+	/* Thread. */
+	thread_ip_inc(p);
 }
 
-#else
-
-#define instr_meter_idx_nbo instr_meter_idx_hbo
-
-#endif
-
-static inline struct meter *
-instr_meter_idx_imm(struct rte_swx_pipeline *p, struct instruction *ip)
+static inline void
+instr_metprefetch_i_exec(struct rte_swx_pipeline *p)
 {
-	struct metarray_runtime *r = &p->metarray_runtime[ip->meter.metarray_id];
-
-	uint64_t idx =  ip->meter.idx_val & r->size_mask;
-
-	return &r->metarray[idx];
-}
+	struct thread *t = &p->threads[p->thread_id];
+	struct instruction *ip = t->ip;
 
-static inline uint32_t
-instr_meter_length_hbo(struct thread *t, struct instruction *ip)
-{
-	uint8_t *src_struct = t->structs[ip->meter.length.struct_id];
-	uint64_t *src64_ptr = (uint64_t *)&src_struct[ip->meter.length.offset];
-	uint64_t src64 = *src64_ptr;
-	uint64_t src64_mask = UINT64_MAX >> (64 - (ip)->meter.length.n_bits);
-	uint64_t src = src64 & src64_mask;
+	__instr_metprefetch_i_exec(p, t, ip);
 
-	return (uint32_t)src;
+	/* Thread. */
+	thread_ip_inc(p);
 }
 
-#if RTE_BYTE_ORDER == RTE_LITTLE_ENDIAN
-
-static inline uint32_t
-instr_meter_length_nbo(struct thread *t, struct instruction *ip)
+static inline void
+instr_meter_hhm_exec(struct rte_swx_pipeline *p)
 {
-	uint8_t *src_struct = t->structs[ip->meter.length.struct_id];
-	uint64_t *src64_ptr = (uint64_t *)&src_struct[ip->meter.length.offset];
-	uint64_t src64 = *src64_ptr;
-	uint64_t src = ntoh64(src64) >> (64 - ip->meter.length.n_bits);
-
-	return (uint32_t)src;
-}
-
-#else
-
-#define instr_meter_length_nbo instr_meter_length_hbo
-
-#endif
+	struct thread *t = &p->threads[p->thread_id];
+	struct instruction *ip = t->ip;
 
-static inline enum rte_color
-instr_meter_color_in_hbo(struct thread *t, struct instruction *ip)
-{
-	uint8_t *src_struct = t->structs[ip->meter.color_in.struct_id];
-	uint64_t *src64_ptr = (uint64_t *)&src_struct[ip->meter.color_in.offset];
-	uint64_t src64 = *src64_ptr;
-	uint64_t src64_mask = UINT64_MAX >> (64 - ip->meter.color_in.n_bits);
-	uint64_t src = src64 & src64_mask;
+	__instr_meter_hhm_exec(p, t, ip);
 
-	return (enum rte_color)src;
+	/* Thread. */
+	thread_ip_inc(p);
 }
 
 static inline void
-instr_meter_color_out_hbo_set(struct thread *t, struct instruction *ip, enum rte_color color_out)
+instr_meter_hhi_exec(struct rte_swx_pipeline *p)
 {
-	uint8_t *dst_struct = t->structs[ip->meter.color_out.struct_id];
-	uint64_t *dst64_ptr = (uint64_t *)&dst_struct[ip->meter.color_out.offset];
-	uint64_t dst64 = *dst64_ptr;
-	uint64_t dst64_mask = UINT64_MAX >> (64 - ip->meter.color_out.n_bits);
+	struct thread *t = &p->threads[p->thread_id];
+	struct instruction *ip = t->ip;
 
-	uint64_t src = (uint64_t)color_out;
+	__instr_meter_hhi_exec(p, t, ip);
 
-	*dst64_ptr = (dst64 & ~dst64_mask) | (src & dst64_mask);
+	/* Thread. */
+	thread_ip_inc(p);
 }
 
 static inline void
-instr_metprefetch_h_exec(struct rte_swx_pipeline *p)
+instr_meter_hmm_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	struct meter *m;
 
-	TRACE("[Thread %2u] metprefetch (h)\n", p->thread_id);
-
-	/* Structs. */
-	m = instr_meter_idx_nbo(p, t, ip);
-	rte_prefetch0(m);
+	__instr_meter_hmm_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
 }
-
 static inline void
-instr_metprefetch_m_exec(struct rte_swx_pipeline *p)
+instr_meter_hmi_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	struct meter *m;
-
-	TRACE("[Thread %2u] metprefetch (m)\n", p->thread_id);
 
-	/* Structs. */
-	m = instr_meter_idx_hbo(p, t, ip);
-	rte_prefetch0(m);
+	__instr_meter_hmi_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
 }
 
 static inline void
-instr_metprefetch_i_exec(struct rte_swx_pipeline *p)
+instr_meter_mhm_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	struct meter *m;
-
-	TRACE("[Thread %2u] metprefetch (i)\n", p->thread_id);
 
-	/* Structs. */
-	m = instr_meter_idx_imm(p, ip);
-	rte_prefetch0(m);
+	__instr_meter_mhm_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
 }
 
 static inline void
-instr_meter_hhm_exec(struct rte_swx_pipeline *p)
+instr_meter_mhi_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	struct meter *m;
-	uint64_t time, n_pkts, n_bytes;
-	uint32_t length;
-	enum rte_color color_in, color_out;
-
-	TRACE("[Thread %2u] meter (hhm)\n", p->thread_id);
 
-	/* Structs. */
-	m = instr_meter_idx_nbo(p, t, ip);
-	rte_prefetch0(m->n_pkts);
-	time = rte_get_tsc_cycles();
-	length = instr_meter_length_nbo(t, ip);
-	color_in = instr_meter_color_in_hbo(t, ip);
-
-	color_out = rte_meter_trtcm_color_aware_check(&m->m,
-		&m->profile->profile,
-		time,
-		length,
-		color_in);
-
-	color_out &= m->color_mask;
-
-	n_pkts = m->n_pkts[color_out];
-	n_bytes = m->n_bytes[color_out];
-
-	instr_meter_color_out_hbo_set(t, ip, color_out);
-
-	m->n_pkts[color_out] = n_pkts + 1;
-	m->n_bytes[color_out] = n_bytes + length;
+	__instr_meter_mhi_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
 }
 
 static inline void
-instr_meter_hhi_exec(struct rte_swx_pipeline *p)
+instr_meter_mmm_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	struct meter *m;
-	uint64_t time, n_pkts, n_bytes;
-	uint32_t length;
-	enum rte_color color_in, color_out;
-
-	TRACE("[Thread %2u] meter (hhi)\n", p->thread_id);
-
-	/* Structs. */
-	m = instr_meter_idx_nbo(p, t, ip);
-	rte_prefetch0(m->n_pkts);
-	time = rte_get_tsc_cycles();
-	length = instr_meter_length_nbo(t, ip);
-	color_in = (enum rte_color)ip->meter.color_in_val;
-
-	color_out = rte_meter_trtcm_color_aware_check(&m->m,
-		&m->profile->profile,
-		time,
-		length,
-		color_in);
-
-	color_out &= m->color_mask;
-
-	n_pkts = m->n_pkts[color_out];
-	n_bytes = m->n_bytes[color_out];
-
-	instr_meter_color_out_hbo_set(t, ip, color_out);
 
-	m->n_pkts[color_out] = n_pkts + 1;
-	m->n_bytes[color_out] = n_bytes + length;
-
-	/* Thread. */
-	thread_ip_inc(p);
-}
-
-static inline void
-instr_meter_hmm_exec(struct rte_swx_pipeline *p)
-{
-	struct thread *t = &p->threads[p->thread_id];
-	struct instruction *ip = t->ip;
-	struct meter *m;
-	uint64_t time, n_pkts, n_bytes;
-	uint32_t length;
-	enum rte_color color_in, color_out;
-
-	TRACE("[Thread %2u] meter (hmm)\n", p->thread_id);
-
-	/* Structs. */
-	m = instr_meter_idx_nbo(p, t, ip);
-	rte_prefetch0(m->n_pkts);
-	time = rte_get_tsc_cycles();
-	length = instr_meter_length_hbo(t, ip);
-	color_in = instr_meter_color_in_hbo(t, ip);
-
-	color_out = rte_meter_trtcm_color_aware_check(&m->m,
-		&m->profile->profile,
-		time,
-		length,
-		color_in);
-
-	color_out &= m->color_mask;
-
-	n_pkts = m->n_pkts[color_out];
-	n_bytes = m->n_bytes[color_out];
-
-	instr_meter_color_out_hbo_set(t, ip, color_out);
-
-	m->n_pkts[color_out] = n_pkts + 1;
-	m->n_bytes[color_out] = n_bytes + length;
-
-	/* Thread. */
-	thread_ip_inc(p);
-}
-static inline void
-instr_meter_hmi_exec(struct rte_swx_pipeline *p)
-{
-	struct thread *t = &p->threads[p->thread_id];
-	struct instruction *ip = t->ip;
-	struct meter *m;
-	uint64_t time, n_pkts, n_bytes;
-	uint32_t length;
-	enum rte_color color_in, color_out;
-
-	TRACE("[Thread %2u] meter (hmi)\n", p->thread_id);
-
-	/* Structs. */
-	m = instr_meter_idx_nbo(p, t, ip);
-	rte_prefetch0(m->n_pkts);
-	time = rte_get_tsc_cycles();
-	length = instr_meter_length_hbo(t, ip);
-	color_in = (enum rte_color)ip->meter.color_in_val;
-
-	color_out = rte_meter_trtcm_color_aware_check(&m->m,
-		&m->profile->profile,
-		time,
-		length,
-		color_in);
-
-	color_out &= m->color_mask;
-
-	n_pkts = m->n_pkts[color_out];
-	n_bytes = m->n_bytes[color_out];
-
-	instr_meter_color_out_hbo_set(t, ip, color_out);
-
-	m->n_pkts[color_out] = n_pkts + 1;
-	m->n_bytes[color_out] = n_bytes + length;
-
-	/* Thread. */
-	thread_ip_inc(p);
-}
-
-static inline void
-instr_meter_mhm_exec(struct rte_swx_pipeline *p)
-{
-	struct thread *t = &p->threads[p->thread_id];
-	struct instruction *ip = t->ip;
-	struct meter *m;
-	uint64_t time, n_pkts, n_bytes;
-	uint32_t length;
-	enum rte_color color_in, color_out;
-
-	TRACE("[Thread %2u] meter (mhm)\n", p->thread_id);
-
-	/* Structs. */
-	m = instr_meter_idx_hbo(p, t, ip);
-	rte_prefetch0(m->n_pkts);
-	time = rte_get_tsc_cycles();
-	length = instr_meter_length_nbo(t, ip);
-	color_in = instr_meter_color_in_hbo(t, ip);
-
-	color_out = rte_meter_trtcm_color_aware_check(&m->m,
-		&m->profile->profile,
-		time,
-		length,
-		color_in);
-
-	color_out &= m->color_mask;
-
-	n_pkts = m->n_pkts[color_out];
-	n_bytes = m->n_bytes[color_out];
-
-	instr_meter_color_out_hbo_set(t, ip, color_out);
-
-	m->n_pkts[color_out] = n_pkts + 1;
-	m->n_bytes[color_out] = n_bytes + length;
-
-	/* Thread. */
-	thread_ip_inc(p);
-}
-
-static inline void
-instr_meter_mhi_exec(struct rte_swx_pipeline *p)
-{
-	struct thread *t = &p->threads[p->thread_id];
-	struct instruction *ip = t->ip;
-	struct meter *m;
-	uint64_t time, n_pkts, n_bytes;
-	uint32_t length;
-	enum rte_color color_in, color_out;
-
-	TRACE("[Thread %2u] meter (mhi)\n", p->thread_id);
-
-	/* Structs. */
-	m = instr_meter_idx_hbo(p, t, ip);
-	rte_prefetch0(m->n_pkts);
-	time = rte_get_tsc_cycles();
-	length = instr_meter_length_nbo(t, ip);
-	color_in = (enum rte_color)ip->meter.color_in_val;
-
-	color_out = rte_meter_trtcm_color_aware_check(&m->m,
-		&m->profile->profile,
-		time,
-		length,
-		color_in);
-
-	color_out &= m->color_mask;
-
-	n_pkts = m->n_pkts[color_out];
-	n_bytes = m->n_bytes[color_out];
-
-	instr_meter_color_out_hbo_set(t, ip, color_out);
-
-	m->n_pkts[color_out] = n_pkts + 1;
-	m->n_bytes[color_out] = n_bytes + length;
-
-	/* Thread. */
-	thread_ip_inc(p);
-}
-
-static inline void
-instr_meter_mmm_exec(struct rte_swx_pipeline *p)
-{
-	struct thread *t = &p->threads[p->thread_id];
-	struct instruction *ip = t->ip;
-	struct meter *m;
-	uint64_t time, n_pkts, n_bytes;
-	uint32_t length;
-	enum rte_color color_in, color_out;
-
-	TRACE("[Thread %2u] meter (mmm)\n", p->thread_id);
-
-	/* Structs. */
-	m = instr_meter_idx_hbo(p, t, ip);
-	rte_prefetch0(m->n_pkts);
-	time = rte_get_tsc_cycles();
-	length = instr_meter_length_hbo(t, ip);
-	color_in = instr_meter_color_in_hbo(t, ip);
-
-	color_out = rte_meter_trtcm_color_aware_check(&m->m,
-		&m->profile->profile,
-		time,
-		length,
-		color_in);
-
-	color_out &= m->color_mask;
-
-	n_pkts = m->n_pkts[color_out];
-	n_bytes = m->n_bytes[color_out];
-
-	instr_meter_color_out_hbo_set(t, ip, color_out);
-
-	m->n_pkts[color_out] = n_pkts + 1;
-	m->n_bytes[color_out] = n_bytes + length;
+	__instr_meter_mmm_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -6681,35 +4557,8 @@ instr_meter_mmi_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	struct meter *m;
-	uint64_t time, n_pkts, n_bytes;
-	uint32_t length;
-	enum rte_color color_in, color_out;
-
-	TRACE("[Thread %2u] meter (mmi)\n", p->thread_id);
 
-	/* Structs. */
-	m = instr_meter_idx_hbo(p, t, ip);
-	rte_prefetch0(m->n_pkts);
-	time = rte_get_tsc_cycles();
-	length = instr_meter_length_hbo(t, ip);
-	color_in = (enum rte_color)ip->meter.color_in_val;
-
-	color_out = rte_meter_trtcm_color_aware_check(&m->m,
-		&m->profile->profile,
-		time,
-		length,
-		color_in);
-
-	color_out &= m->color_mask;
-
-	n_pkts = m->n_pkts[color_out];
-	n_bytes = m->n_bytes[color_out];
-
-	instr_meter_color_out_hbo_set(t, ip, color_out);
-
-	m->n_pkts[color_out] = n_pkts + 1;
-	m->n_bytes[color_out] = n_bytes + length;
+	__instr_meter_mmi_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -6720,35 +4569,8 @@ instr_meter_ihm_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	struct meter *m;
-	uint64_t time, n_pkts, n_bytes;
-	uint32_t length;
-	enum rte_color color_in, color_out;
-
-	TRACE("[Thread %2u] meter (ihm)\n", p->thread_id);
 
-	/* Structs. */
-	m = instr_meter_idx_imm(p, ip);
-	rte_prefetch0(m->n_pkts);
-	time = rte_get_tsc_cycles();
-	length = instr_meter_length_nbo(t, ip);
-	color_in = instr_meter_color_in_hbo(t, ip);
-
-	color_out = rte_meter_trtcm_color_aware_check(&m->m,
-		&m->profile->profile,
-		time,
-		length,
-		color_in);
-
-	color_out &= m->color_mask;
-
-	n_pkts = m->n_pkts[color_out];
-	n_bytes = m->n_bytes[color_out];
-
-	instr_meter_color_out_hbo_set(t, ip, color_out);
-
-	m->n_pkts[color_out] = n_pkts + 1;
-	m->n_bytes[color_out] = n_bytes + length;
+	__instr_meter_ihm_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -6759,35 +4581,8 @@ instr_meter_ihi_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	struct meter *m;
-	uint64_t time, n_pkts, n_bytes;
-	uint32_t length;
-	enum rte_color color_in, color_out;
-
-	TRACE("[Thread %2u] meter (ihi)\n", p->thread_id);
 
-	/* Structs. */
-	m = instr_meter_idx_imm(p, ip);
-	rte_prefetch0(m->n_pkts);
-	time = rte_get_tsc_cycles();
-	length = instr_meter_length_nbo(t, ip);
-	color_in = (enum rte_color)ip->meter.color_in_val;
-
-	color_out = rte_meter_trtcm_color_aware_check(&m->m,
-		&m->profile->profile,
-		time,
-		length,
-		color_in);
-
-	color_out &= m->color_mask;
-
-	n_pkts = m->n_pkts[color_out];
-	n_bytes = m->n_bytes[color_out];
-
-	instr_meter_color_out_hbo_set(t, ip, color_out);
-
-	m->n_pkts[color_out] = n_pkts + 1;
-	m->n_bytes[color_out] = n_bytes + length;
+	__instr_meter_ihi_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -6798,35 +4593,8 @@ instr_meter_imm_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	struct meter *m;
-	uint64_t time, n_pkts, n_bytes;
-	uint32_t length;
-	enum rte_color color_in, color_out;
-
-	TRACE("[Thread %2u] meter (imm)\n", p->thread_id);
 
-	/* Structs. */
-	m = instr_meter_idx_imm(p, ip);
-	rte_prefetch0(m->n_pkts);
-	time = rte_get_tsc_cycles();
-	length = instr_meter_length_hbo(t, ip);
-	color_in = instr_meter_color_in_hbo(t, ip);
-
-	color_out = rte_meter_trtcm_color_aware_check(&m->m,
-		&m->profile->profile,
-		time,
-		length,
-		color_in);
-
-	color_out &= m->color_mask;
-
-	n_pkts = m->n_pkts[color_out];
-	n_bytes = m->n_bytes[color_out];
-
-	instr_meter_color_out_hbo_set(t, ip, color_out);
-
-	m->n_pkts[color_out] = n_pkts + 1;
-	m->n_bytes[color_out] = n_bytes + length;
+	__instr_meter_imm_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -6836,35 +4604,8 @@ instr_meter_imi_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	struct meter *m;
-	uint64_t time, n_pkts, n_bytes;
-	uint32_t length;
-	enum rte_color color_in, color_out;
-
-	TRACE("[Thread %2u] meter (imi)\n", p->thread_id);
 
-	/* Structs. */
-	m = instr_meter_idx_imm(p, ip);
-	rte_prefetch0(m->n_pkts);
-	time = rte_get_tsc_cycles();
-	length = instr_meter_length_hbo(t, ip);
-	color_in = (enum rte_color)ip->meter.color_in_val;
-
-	color_out = rte_meter_trtcm_color_aware_check(&m->m,
-		&m->profile->profile,
-		time,
-		length,
-		color_in);
-
-	color_out &= m->color_mask;
-
-	n_pkts = m->n_pkts[color_out];
-	n_bytes = m->n_bytes[color_out];
-
-	instr_meter_color_out_hbo_set(t, ip, color_out);
-
-	m->n_pkts[color_out] = n_pkts + 1;
-	m->n_bytes[color_out] = n_bytes + length;
+	__instr_meter_imi_exec(p, t, ip);
 
 	/* Thread. */
 	thread_ip_inc(p);
@@ -7267,11 +5008,9 @@ instr_jmp_valid_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint32_t header_id = ip->jmp.header_id;
 
-	TRACE("[Thread %2u] jmpv\n", p->thread_id);
-
-	t->ip = HEADER_VALID(t, header_id) ? ip->jmp.ip : (t->ip + 1);
+	/* Thread. */
+	t->ip = __instr_jmp_valid_exec(p, t, ip) ? ip->jmp.ip : (t->ip + 1);
 }
 
 static inline void
@@ -7279,11 +5018,9 @@ instr_jmp_invalid_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	uint32_t header_id = ip->jmp.header_id;
 
-	TRACE("[Thread %2u] jmpnv\n", p->thread_id);
-
-	t->ip = HEADER_VALID(t, header_id) ? (t->ip + 1) : ip->jmp.ip;
+	/* Thread. */
+	t->ip = __instr_jmp_invalid_exec(p, t, ip) ? ip->jmp.ip : (t->ip + 1);
 }
 
 static inline void
@@ -7291,11 +5028,9 @@ instr_jmp_hit_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	struct instruction *ip_next[] = {t->ip + 1, ip->jmp.ip};
 
-	TRACE("[Thread %2u] jmph\n", p->thread_id);
-
-	t->ip = ip_next[t->hit];
+	/* Thread. */
+	t->ip = __instr_jmp_hit_exec(p, t, ip) ? ip->jmp.ip : (t->ip + 1);
 }
 
 static inline void
@@ -7303,11 +5038,9 @@ instr_jmp_miss_exec(struct rte_swx_pipeline *p)
 {
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
-	struct instruction *ip_next[] = {ip->jmp.ip, t->ip + 1};
 
-	TRACE("[Thread %2u] jmpnh\n", p->thread_id);
-
-	t->ip = ip_next[t->hit];
+	/* Thread. */
+	t->ip = __instr_jmp_miss_exec(p, t, ip) ? ip->jmp.ip : (t->ip + 1);
 }
 
 static inline void
@@ -7316,9 +5049,8 @@ instr_jmp_action_hit_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] jmpa\n", p->thread_id);
-
-	t->ip = (ip->jmp.action_id == t->action_id) ? ip->jmp.ip : (t->ip + 1);
+	/* Thread. */
+	t->ip = __instr_jmp_action_hit_exec(p, t, ip) ? ip->jmp.ip : (t->ip + 1);
 }
 
 static inline void
@@ -7327,9 +5059,8 @@ instr_jmp_action_miss_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] jmpna\n", p->thread_id);
-
-	t->ip = (ip->jmp.action_id == t->action_id) ? (t->ip + 1) : ip->jmp.ip;
+	/* Thread. */
+	t->ip = __instr_jmp_action_miss_exec(p, t, ip) ? ip->jmp.ip : (t->ip + 1);
 }
 
 static inline void
@@ -7338,9 +5069,8 @@ instr_jmp_eq_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] jmpeq\n", p->thread_id);
-
-	JMP_CMP(t, ip, ==);
+	/* Thread. */
+	t->ip = __instr_jmp_eq_exec(p, t, ip) ? ip->jmp.ip : (t->ip + 1);
 }
 
 static inline void
@@ -7349,9 +5079,8 @@ instr_jmp_eq_mh_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] jmpeq (mh)\n", p->thread_id);
-
-	JMP_CMP_MH(t, ip, ==);
+	/* Thread. */
+	t->ip = __instr_jmp_eq_mh_exec(p, t, ip) ? ip->jmp.ip : (t->ip + 1);
 }
 
 static inline void
@@ -7360,9 +5089,8 @@ instr_jmp_eq_hm_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] jmpeq (hm)\n", p->thread_id);
-
-	JMP_CMP_HM(t, ip, ==);
+	/* Thread. */
+	t->ip = __instr_jmp_eq_hm_exec(p, t, ip) ? ip->jmp.ip : (t->ip + 1);
 }
 
 static inline void
@@ -7371,9 +5099,8 @@ instr_jmp_eq_hh_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] jmpeq (hh)\n", p->thread_id);
-
-	JMP_CMP_HH_FAST(t, ip, ==);
+	/* Thread. */
+	t->ip = __instr_jmp_eq_hh_exec(p, t, ip) ? ip->jmp.ip : (t->ip + 1);
 }
 
 static inline void
@@ -7382,9 +5109,8 @@ instr_jmp_eq_i_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] jmpeq (i)\n", p->thread_id);
-
-	JMP_CMP_I(t, ip, ==);
+	/* Thread. */
+	t->ip = __instr_jmp_eq_i_exec(p, t, ip) ? ip->jmp.ip : (t->ip + 1);
 }
 
 static inline void
@@ -7393,9 +5119,8 @@ instr_jmp_neq_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] jmpneq\n", p->thread_id);
-
-	JMP_CMP(t, ip, !=);
+	/* Thread. */
+	t->ip = __instr_jmp_neq_exec(p, t, ip) ? ip->jmp.ip : (t->ip + 1);
 }
 
 static inline void
@@ -7404,9 +5129,8 @@ instr_jmp_neq_mh_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] jmpneq (mh)\n", p->thread_id);
-
-	JMP_CMP_MH(t, ip, !=);
+	/* Thread. */
+	t->ip = __instr_jmp_neq_mh_exec(p, t, ip) ? ip->jmp.ip : (t->ip + 1);
 }
 
 static inline void
@@ -7415,9 +5139,8 @@ instr_jmp_neq_hm_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] jmpneq (hm)\n", p->thread_id);
-
-	JMP_CMP_HM(t, ip, !=);
+	/* Thread. */
+	t->ip = __instr_jmp_neq_hm_exec(p, t, ip) ? ip->jmp.ip : (t->ip + 1);
 }
 
 static inline void
@@ -7426,9 +5149,8 @@ instr_jmp_neq_hh_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] jmpneq (hh)\n", p->thread_id);
-
-	JMP_CMP_HH_FAST(t, ip, !=);
+	/* Thread. */
+	t->ip = __instr_jmp_neq_hh_exec(p, t, ip) ? ip->jmp.ip : (t->ip + 1);
 }
 
 static inline void
@@ -7437,9 +5159,8 @@ instr_jmp_neq_i_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] jmpneq (i)\n", p->thread_id);
-
-	JMP_CMP_I(t, ip, !=);
+	/* Thread. */
+	t->ip = __instr_jmp_neq_i_exec(p, t, ip) ? ip->jmp.ip : (t->ip + 1);
 }
 
 static inline void
@@ -7448,9 +5169,8 @@ instr_jmp_lt_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] jmplt\n", p->thread_id);
-
-	JMP_CMP(t, ip, <);
+	/* Thread. */
+	t->ip = __instr_jmp_lt_exec(p, t, ip) ? ip->jmp.ip : (t->ip + 1);
 }
 
 static inline void
@@ -7459,9 +5179,8 @@ instr_jmp_lt_mh_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] jmplt (mh)\n", p->thread_id);
-
-	JMP_CMP_MH(t, ip, <);
+	/* Thread. */
+	t->ip = __instr_jmp_lt_mh_exec(p, t, ip) ? ip->jmp.ip : (t->ip + 1);
 }
 
 static inline void
@@ -7470,9 +5189,8 @@ instr_jmp_lt_hm_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] jmplt (hm)\n", p->thread_id);
-
-	JMP_CMP_HM(t, ip, <);
+	/* Thread. */
+	t->ip = __instr_jmp_lt_hm_exec(p, t, ip) ? ip->jmp.ip : (t->ip + 1);
 }
 
 static inline void
@@ -7481,9 +5199,8 @@ instr_jmp_lt_hh_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] jmplt (hh)\n", p->thread_id);
-
-	JMP_CMP_HH(t, ip, <);
+	/* Thread. */
+	t->ip = __instr_jmp_lt_hh_exec(p, t, ip) ? ip->jmp.ip : (t->ip + 1);
 }
 
 static inline void
@@ -7492,9 +5209,8 @@ instr_jmp_lt_mi_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] jmplt (mi)\n", p->thread_id);
-
-	JMP_CMP_MI(t, ip, <);
+	/* Thread. */
+	t->ip = __instr_jmp_lt_mi_exec(p, t, ip) ? ip->jmp.ip : (t->ip + 1);
 }
 
 static inline void
@@ -7503,9 +5219,8 @@ instr_jmp_lt_hi_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] jmplt (hi)\n", p->thread_id);
-
-	JMP_CMP_HI(t, ip, <);
+	/* Thread. */
+	t->ip = __instr_jmp_lt_hi_exec(p, t, ip) ? ip->jmp.ip : (t->ip + 1);
 }
 
 static inline void
@@ -7514,9 +5229,8 @@ instr_jmp_gt_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] jmpgt\n", p->thread_id);
-
-	JMP_CMP(t, ip, >);
+	/* Thread. */
+	t->ip = __instr_jmp_gt_exec(p, t, ip) ? ip->jmp.ip : (t->ip + 1);
 }
 
 static inline void
@@ -7525,9 +5239,8 @@ instr_jmp_gt_mh_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] jmpgt (mh)\n", p->thread_id);
-
-	JMP_CMP_MH(t, ip, >);
+	/* Thread. */
+	t->ip = __instr_jmp_gt_mh_exec(p, t, ip) ? ip->jmp.ip : (t->ip + 1);
 }
 
 static inline void
@@ -7536,9 +5249,8 @@ instr_jmp_gt_hm_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] jmpgt (hm)\n", p->thread_id);
-
-	JMP_CMP_HM(t, ip, >);
+	/* Thread. */
+	t->ip = __instr_jmp_gt_hm_exec(p, t, ip) ? ip->jmp.ip : (t->ip + 1);
 }
 
 static inline void
@@ -7547,9 +5259,8 @@ instr_jmp_gt_hh_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] jmpgt (hh)\n", p->thread_id);
-
-	JMP_CMP_HH(t, ip, >);
+	/* Thread. */
+	t->ip = __instr_jmp_gt_hh_exec(p, t, ip) ? ip->jmp.ip : (t->ip + 1);
 }
 
 static inline void
@@ -7558,9 +5269,8 @@ instr_jmp_gt_mi_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] jmpgt (mi)\n", p->thread_id);
-
-	JMP_CMP_MI(t, ip, >);
+	/* Thread. */
+	t->ip = __instr_jmp_gt_mi_exec(p, t, ip) ? ip->jmp.ip : (t->ip + 1);
 }
 
 static inline void
@@ -7569,9 +5279,8 @@ instr_jmp_gt_hi_exec(struct rte_swx_pipeline *p)
 	struct thread *t = &p->threads[p->thread_id];
 	struct instruction *ip = t->ip;
 
-	TRACE("[Thread %2u] jmpgt (hi)\n", p->thread_id);
-
-	JMP_CMP_HI(t, ip, >);
+	/* Thread. */
+	t->ip = __instr_jmp_gt_hi_exec(p, t, ip) ? ip->jmp.ip : (t->ip + 1);
 }
 
 /*
@@ -7602,6 +5311,21 @@ instr_return_exec(struct rte_swx_pipeline *p)
 	t->ip = t->ret;
 }
 
+/*
+ * block.
+ */
+static inline void
+instr_block_exec(struct rte_swx_pipeline *p)
+{
+	struct thread *t = &p->threads[p->thread_id];
+	struct instruction *ip = t->ip;
+
+	TRACE("[Thread %2u] block\n", p->thread_id);
+
+	/* The generated function also updates the thread instruction pointer. */
+	ip->block.func(p);
+}
+
 static int
 instr_translate(struct rte_swx_pipeline *p,
 		struct action *action,
@@ -7926,6 +5650,22 @@ instr_translate(struct rte_swx_pipeline *p,
 					      instr,
 					      data);
 
+	if (!strcmp(tokens[tpos], "learn"))
+		return instr_learn_translate(p,
+					     action,
+					     &tokens[tpos],
+					     n_tokens - tpos,
+					     instr,
+					     data);
+
+	if (!strcmp(tokens[tpos], "forget"))
+		return instr_forget_translate(p,
+					      action,
+					      &tokens[tpos],
+					      n_tokens - tpos,
+					      instr,
+					      data);
+
 	if (!strcmp(tokens[tpos], "return"))
 		return instr_return_translate(p,
 					      action,
@@ -7980,7 +5720,7 @@ instr_label_check(struct instruction_data *instruction_data,
 			continue;
 
 		for (j = i + 1; j < n_instructions; j++)
-			CHECK(strcmp(label, data[j].label), EINVAL);
+			CHECK(strcmp(label, instruction_data[j].label), EINVAL);
 	}
 
 	/* Get users for each instruction label. */
@@ -8382,1582 +6122,3057 @@ instr_pattern_mov_all_validate_replace(struct rte_swx_pipeline *p,
 	if (!h)
 		return;
 
-	for (src_field_id = 0; src_field_id < a->st->n_fields; src_field_id++)
-		if (instr[0].mov.src.offset == a->st->fields[src_field_id].offset / 8)
-			break;
+	for (src_field_id = 0; src_field_id < a->st->n_fields; src_field_id++)
+		if (instr[0].mov.src.offset == a->st->fields[src_field_id].offset / 8)
+			break;
+
+	if (src_field_id == a->st->n_fields)
+		return;
+
+	src_offset = instr[0].mov.src.offset;
+
+	/* Modify the instructions. */
+	instr[0].type = INSTR_DMA_HT;
+	instr[0].dma.dst.header_id[0] = h->id;
+	instr[0].dma.dst.struct_id[0] = h->struct_id;
+	instr[0].dma.src.offset[0] = (uint8_t)src_offset;
+	instr[0].dma.n_bytes[0] = h->st->n_bits / 8;
+
+	for (i = 1; i < n_instr; i++)
+		data[i].invalid = 1;
+
+	/* Update the endianness of the action arguments to header endianness. */
+	for (i = 0; i < h->st->n_fields; i++)
+		a->args_endianness[src_field_id + i] = 1;
+}
+
+static uint32_t
+instr_pattern_mov_all_validate_optimize(struct rte_swx_pipeline *p,
+					struct action *a,
+					struct instruction *instructions,
+					struct instruction_data *instruction_data,
+					uint32_t n_instructions)
+{
+	uint32_t i;
+
+	if (!a || !a->st)
+		return n_instructions;
+
+	for (i = 0; i < n_instructions; ) {
+		struct instruction *instr = &instructions[i];
+		struct instruction_data *data = &instruction_data[i];
+		uint32_t n_instr = 0;
+		int detected;
+
+		/* Mov all + validate. */
+		detected = instr_pattern_mov_all_validate_search(p,
+								 a,
+								 instr,
+								 data,
+								 n_instructions - i,
+								 instructions,
+								 instruction_data,
+								 n_instructions,
+								 &n_instr);
+		if (detected) {
+			instr_pattern_mov_all_validate_replace(p, a, instr, data, n_instr);
+			i += n_instr;
+			continue;
+		}
+
+		/* No pattern starting at the current instruction. */
+		i++;
+	}
+
+	/* Eliminate the invalid instructions that have been optimized out. */
+	n_instructions = instr_compact(instructions,
+				       instruction_data,
+				       n_instructions);
+
+	return n_instructions;
+}
+
+static int
+instr_pattern_dma_many_search(struct instruction *instr,
+			      struct instruction_data *data,
+			      uint32_t n_instr,
+			      uint32_t *n_pattern_instr)
+{
+	uint32_t i;
+
+	for (i = 0; i < n_instr; i++) {
+		if (data[i].invalid)
+			break;
+
+		if (instr[i].type != INSTR_DMA_HT)
+			break;
+
+		if (i == RTE_DIM(instr->dma.dst.header_id))
+			break;
+
+		if (i && data[i].n_users)
+			break;
+	}
+
+	if (i < 2)
+		return 0;
+
+	*n_pattern_instr = i;
+	return 1;
+}
+
+static void
+instr_pattern_dma_many_replace(struct instruction *instr,
+			       struct instruction_data *data,
+			       uint32_t n_instr)
+{
+	uint32_t i;
+
+	for (i = 1; i < n_instr; i++) {
+		instr[0].type++;
+		instr[0].dma.dst.header_id[i] = instr[i].dma.dst.header_id[0];
+		instr[0].dma.dst.struct_id[i] = instr[i].dma.dst.struct_id[0];
+		instr[0].dma.src.offset[i] = instr[i].dma.src.offset[0];
+		instr[0].dma.n_bytes[i] = instr[i].dma.n_bytes[0];
+
+		data[i].invalid = 1;
+	}
+}
+
+static uint32_t
+instr_pattern_dma_many_optimize(struct instruction *instructions,
+	       struct instruction_data *instruction_data,
+	       uint32_t n_instructions)
+{
+	uint32_t i;
+
+	for (i = 0; i < n_instructions; ) {
+		struct instruction *instr = &instructions[i];
+		struct instruction_data *data = &instruction_data[i];
+		uint32_t n_instr = 0;
+		int detected;
+
+		/* DMA many. */
+		detected = instr_pattern_dma_many_search(instr,
+							 data,
+							 n_instructions - i,
+							 &n_instr);
+		if (detected) {
+			instr_pattern_dma_many_replace(instr, data, n_instr);
+			i += n_instr;
+			continue;
+		}
+
+		/* No pattern starting at the current instruction. */
+		i++;
+	}
+
+	/* Eliminate the invalid instructions that have been optimized out. */
+	n_instructions = instr_compact(instructions,
+				       instruction_data,
+				       n_instructions);
+
+	return n_instructions;
+}
+
+static uint32_t
+instr_optimize(struct rte_swx_pipeline *p,
+	       struct action *a,
+	       struct instruction *instructions,
+	       struct instruction_data *instruction_data,
+	       uint32_t n_instructions)
+{
+	/* Extract many. */
+	n_instructions = instr_pattern_extract_many_optimize(instructions,
+							     instruction_data,
+							     n_instructions);
+
+	/* Emit many + TX. */
+	n_instructions = instr_pattern_emit_many_tx_optimize(instructions,
+							     instruction_data,
+							     n_instructions);
+
+	/* Mov all + validate. */
+	n_instructions = instr_pattern_mov_all_validate_optimize(p,
+								 a,
+								 instructions,
+								 instruction_data,
+								 n_instructions);
+
+	/* DMA many. */
+	n_instructions = instr_pattern_dma_many_optimize(instructions,
+							 instruction_data,
+							 n_instructions);
+
+	return n_instructions;
+}
+
+static int
+instruction_config(struct rte_swx_pipeline *p,
+		   struct action *a,
+		   const char **instructions,
+		   uint32_t n_instructions)
+{
+	struct instruction *instr = NULL;
+	struct instruction_data *data = NULL;
+	int err = 0;
+	uint32_t i;
+
+	CHECK(n_instructions, EINVAL);
+	CHECK(instructions, EINVAL);
+	for (i = 0; i < n_instructions; i++)
+		CHECK_INSTRUCTION(instructions[i], EINVAL);
+
+	/* Memory allocation. */
+	instr = calloc(n_instructions, sizeof(struct instruction));
+	if (!instr) {
+		err = -ENOMEM;
+		goto error;
+	}
+
+	data = calloc(n_instructions, sizeof(struct instruction_data));
+	if (!data) {
+		err = -ENOMEM;
+		goto error;
+	}
+
+	for (i = 0; i < n_instructions; i++) {
+		char *string = strdup(instructions[i]);
+		if (!string) {
+			err = -ENOMEM;
+			goto error;
+		}
+
+		err = instr_translate(p, a, string, &instr[i], &data[i]);
+		if (err) {
+			free(string);
+			goto error;
+		}
+
+		free(string);
+	}
+
+	err = instr_label_check(data, n_instructions);
+	if (err)
+		goto error;
+
+	err = instr_verify(p, a, instr, data, n_instructions);
+	if (err)
+		goto error;
+
+	n_instructions = instr_optimize(p, a, instr, data, n_instructions);
+
+	err = instr_jmp_resolve(instr, data, n_instructions);
+	if (err)
+		goto error;
+
+	if (a) {
+		a->instructions = instr;
+		a->n_instructions = n_instructions;
+	} else {
+		p->instructions = instr;
+		p->n_instructions = n_instructions;
+	}
+
+	free(data);
+	return 0;
+
+error:
+	free(data);
+	free(instr);
+	return err;
+}
+
+static instr_exec_t instruction_table[] = {
+	[INSTR_RX] = instr_rx_exec,
+	[INSTR_TX] = instr_tx_exec,
+	[INSTR_TX_I] = instr_tx_i_exec,
+
+	[INSTR_HDR_EXTRACT] = instr_hdr_extract_exec,
+	[INSTR_HDR_EXTRACT2] = instr_hdr_extract2_exec,
+	[INSTR_HDR_EXTRACT3] = instr_hdr_extract3_exec,
+	[INSTR_HDR_EXTRACT4] = instr_hdr_extract4_exec,
+	[INSTR_HDR_EXTRACT5] = instr_hdr_extract5_exec,
+	[INSTR_HDR_EXTRACT6] = instr_hdr_extract6_exec,
+	[INSTR_HDR_EXTRACT7] = instr_hdr_extract7_exec,
+	[INSTR_HDR_EXTRACT8] = instr_hdr_extract8_exec,
+
+	[INSTR_HDR_EMIT] = instr_hdr_emit_exec,
+	[INSTR_HDR_EMIT_TX] = instr_hdr_emit_tx_exec,
+	[INSTR_HDR_EMIT2_TX] = instr_hdr_emit2_tx_exec,
+	[INSTR_HDR_EMIT3_TX] = instr_hdr_emit3_tx_exec,
+	[INSTR_HDR_EMIT4_TX] = instr_hdr_emit4_tx_exec,
+	[INSTR_HDR_EMIT5_TX] = instr_hdr_emit5_tx_exec,
+	[INSTR_HDR_EMIT6_TX] = instr_hdr_emit6_tx_exec,
+	[INSTR_HDR_EMIT7_TX] = instr_hdr_emit7_tx_exec,
+	[INSTR_HDR_EMIT8_TX] = instr_hdr_emit8_tx_exec,
+
+	[INSTR_HDR_VALIDATE] = instr_hdr_validate_exec,
+	[INSTR_HDR_INVALIDATE] = instr_hdr_invalidate_exec,
+
+	[INSTR_MOV] = instr_mov_exec,
+	[INSTR_MOV_MH] = instr_mov_mh_exec,
+	[INSTR_MOV_HM] = instr_mov_hm_exec,
+	[INSTR_MOV_HH] = instr_mov_hh_exec,
+	[INSTR_MOV_I] = instr_mov_i_exec,
+
+	[INSTR_DMA_HT] = instr_dma_ht_exec,
+	[INSTR_DMA_HT2] = instr_dma_ht2_exec,
+	[INSTR_DMA_HT3] = instr_dma_ht3_exec,
+	[INSTR_DMA_HT4] = instr_dma_ht4_exec,
+	[INSTR_DMA_HT5] = instr_dma_ht5_exec,
+	[INSTR_DMA_HT6] = instr_dma_ht6_exec,
+	[INSTR_DMA_HT7] = instr_dma_ht7_exec,
+	[INSTR_DMA_HT8] = instr_dma_ht8_exec,
+
+	[INSTR_ALU_ADD] = instr_alu_add_exec,
+	[INSTR_ALU_ADD_MH] = instr_alu_add_mh_exec,
+	[INSTR_ALU_ADD_HM] = instr_alu_add_hm_exec,
+	[INSTR_ALU_ADD_HH] = instr_alu_add_hh_exec,
+	[INSTR_ALU_ADD_MI] = instr_alu_add_mi_exec,
+	[INSTR_ALU_ADD_HI] = instr_alu_add_hi_exec,
+
+	[INSTR_ALU_SUB] = instr_alu_sub_exec,
+	[INSTR_ALU_SUB_MH] = instr_alu_sub_mh_exec,
+	[INSTR_ALU_SUB_HM] = instr_alu_sub_hm_exec,
+	[INSTR_ALU_SUB_HH] = instr_alu_sub_hh_exec,
+	[INSTR_ALU_SUB_MI] = instr_alu_sub_mi_exec,
+	[INSTR_ALU_SUB_HI] = instr_alu_sub_hi_exec,
+
+	[INSTR_ALU_CKADD_FIELD] = instr_alu_ckadd_field_exec,
+	[INSTR_ALU_CKADD_STRUCT] = instr_alu_ckadd_struct_exec,
+	[INSTR_ALU_CKADD_STRUCT20] = instr_alu_ckadd_struct20_exec,
+	[INSTR_ALU_CKSUB_FIELD] = instr_alu_cksub_field_exec,
+
+	[INSTR_ALU_AND] = instr_alu_and_exec,
+	[INSTR_ALU_AND_MH] = instr_alu_and_mh_exec,
+	[INSTR_ALU_AND_HM] = instr_alu_and_hm_exec,
+	[INSTR_ALU_AND_HH] = instr_alu_and_hh_exec,
+	[INSTR_ALU_AND_I] = instr_alu_and_i_exec,
+
+	[INSTR_ALU_OR] = instr_alu_or_exec,
+	[INSTR_ALU_OR_MH] = instr_alu_or_mh_exec,
+	[INSTR_ALU_OR_HM] = instr_alu_or_hm_exec,
+	[INSTR_ALU_OR_HH] = instr_alu_or_hh_exec,
+	[INSTR_ALU_OR_I] = instr_alu_or_i_exec,
+
+	[INSTR_ALU_XOR] = instr_alu_xor_exec,
+	[INSTR_ALU_XOR_MH] = instr_alu_xor_mh_exec,
+	[INSTR_ALU_XOR_HM] = instr_alu_xor_hm_exec,
+	[INSTR_ALU_XOR_HH] = instr_alu_xor_hh_exec,
+	[INSTR_ALU_XOR_I] = instr_alu_xor_i_exec,
+
+	[INSTR_ALU_SHL] = instr_alu_shl_exec,
+	[INSTR_ALU_SHL_MH] = instr_alu_shl_mh_exec,
+	[INSTR_ALU_SHL_HM] = instr_alu_shl_hm_exec,
+	[INSTR_ALU_SHL_HH] = instr_alu_shl_hh_exec,
+	[INSTR_ALU_SHL_MI] = instr_alu_shl_mi_exec,
+	[INSTR_ALU_SHL_HI] = instr_alu_shl_hi_exec,
+
+	[INSTR_ALU_SHR] = instr_alu_shr_exec,
+	[INSTR_ALU_SHR_MH] = instr_alu_shr_mh_exec,
+	[INSTR_ALU_SHR_HM] = instr_alu_shr_hm_exec,
+	[INSTR_ALU_SHR_HH] = instr_alu_shr_hh_exec,
+	[INSTR_ALU_SHR_MI] = instr_alu_shr_mi_exec,
+	[INSTR_ALU_SHR_HI] = instr_alu_shr_hi_exec,
+
+	[INSTR_REGPREFETCH_RH] = instr_regprefetch_rh_exec,
+	[INSTR_REGPREFETCH_RM] = instr_regprefetch_rm_exec,
+	[INSTR_REGPREFETCH_RI] = instr_regprefetch_ri_exec,
+
+	[INSTR_REGRD_HRH] = instr_regrd_hrh_exec,
+	[INSTR_REGRD_HRM] = instr_regrd_hrm_exec,
+	[INSTR_REGRD_MRH] = instr_regrd_mrh_exec,
+	[INSTR_REGRD_MRM] = instr_regrd_mrm_exec,
+	[INSTR_REGRD_HRI] = instr_regrd_hri_exec,
+	[INSTR_REGRD_MRI] = instr_regrd_mri_exec,
+
+	[INSTR_REGWR_RHH] = instr_regwr_rhh_exec,
+	[INSTR_REGWR_RHM] = instr_regwr_rhm_exec,
+	[INSTR_REGWR_RMH] = instr_regwr_rmh_exec,
+	[INSTR_REGWR_RMM] = instr_regwr_rmm_exec,
+	[INSTR_REGWR_RHI] = instr_regwr_rhi_exec,
+	[INSTR_REGWR_RMI] = instr_regwr_rmi_exec,
+	[INSTR_REGWR_RIH] = instr_regwr_rih_exec,
+	[INSTR_REGWR_RIM] = instr_regwr_rim_exec,
+	[INSTR_REGWR_RII] = instr_regwr_rii_exec,
+
+	[INSTR_REGADD_RHH] = instr_regadd_rhh_exec,
+	[INSTR_REGADD_RHM] = instr_regadd_rhm_exec,
+	[INSTR_REGADD_RMH] = instr_regadd_rmh_exec,
+	[INSTR_REGADD_RMM] = instr_regadd_rmm_exec,
+	[INSTR_REGADD_RHI] = instr_regadd_rhi_exec,
+	[INSTR_REGADD_RMI] = instr_regadd_rmi_exec,
+	[INSTR_REGADD_RIH] = instr_regadd_rih_exec,
+	[INSTR_REGADD_RIM] = instr_regadd_rim_exec,
+	[INSTR_REGADD_RII] = instr_regadd_rii_exec,
+
+	[INSTR_METPREFETCH_H] = instr_metprefetch_h_exec,
+	[INSTR_METPREFETCH_M] = instr_metprefetch_m_exec,
+	[INSTR_METPREFETCH_I] = instr_metprefetch_i_exec,
+
+	[INSTR_METER_HHM] = instr_meter_hhm_exec,
+	[INSTR_METER_HHI] = instr_meter_hhi_exec,
+	[INSTR_METER_HMM] = instr_meter_hmm_exec,
+	[INSTR_METER_HMI] = instr_meter_hmi_exec,
+	[INSTR_METER_MHM] = instr_meter_mhm_exec,
+	[INSTR_METER_MHI] = instr_meter_mhi_exec,
+	[INSTR_METER_MMM] = instr_meter_mmm_exec,
+	[INSTR_METER_MMI] = instr_meter_mmi_exec,
+	[INSTR_METER_IHM] = instr_meter_ihm_exec,
+	[INSTR_METER_IHI] = instr_meter_ihi_exec,
+	[INSTR_METER_IMM] = instr_meter_imm_exec,
+	[INSTR_METER_IMI] = instr_meter_imi_exec,
+
+	[INSTR_TABLE] = instr_table_exec,
+	[INSTR_LEARNER] = instr_learner_exec,
+	[INSTR_LEARNER_LEARN] = instr_learn_exec,
+	[INSTR_LEARNER_FORGET] = instr_forget_exec,
+	[INSTR_EXTERN_OBJ] = instr_extern_obj_exec,
+	[INSTR_EXTERN_FUNC] = instr_extern_func_exec,
+
+	[INSTR_JMP] = instr_jmp_exec,
+	[INSTR_JMP_VALID] = instr_jmp_valid_exec,
+	[INSTR_JMP_INVALID] = instr_jmp_invalid_exec,
+	[INSTR_JMP_HIT] = instr_jmp_hit_exec,
+	[INSTR_JMP_MISS] = instr_jmp_miss_exec,
+	[INSTR_JMP_ACTION_HIT] = instr_jmp_action_hit_exec,
+	[INSTR_JMP_ACTION_MISS] = instr_jmp_action_miss_exec,
+
+	[INSTR_JMP_EQ] = instr_jmp_eq_exec,
+	[INSTR_JMP_EQ_MH] = instr_jmp_eq_mh_exec,
+	[INSTR_JMP_EQ_HM] = instr_jmp_eq_hm_exec,
+	[INSTR_JMP_EQ_HH] = instr_jmp_eq_hh_exec,
+	[INSTR_JMP_EQ_I] = instr_jmp_eq_i_exec,
+
+	[INSTR_JMP_NEQ] = instr_jmp_neq_exec,
+	[INSTR_JMP_NEQ_MH] = instr_jmp_neq_mh_exec,
+	[INSTR_JMP_NEQ_HM] = instr_jmp_neq_hm_exec,
+	[INSTR_JMP_NEQ_HH] = instr_jmp_neq_hh_exec,
+	[INSTR_JMP_NEQ_I] = instr_jmp_neq_i_exec,
+
+	[INSTR_JMP_LT] = instr_jmp_lt_exec,
+	[INSTR_JMP_LT_MH] = instr_jmp_lt_mh_exec,
+	[INSTR_JMP_LT_HM] = instr_jmp_lt_hm_exec,
+	[INSTR_JMP_LT_HH] = instr_jmp_lt_hh_exec,
+	[INSTR_JMP_LT_MI] = instr_jmp_lt_mi_exec,
+	[INSTR_JMP_LT_HI] = instr_jmp_lt_hi_exec,
+
+	[INSTR_JMP_GT] = instr_jmp_gt_exec,
+	[INSTR_JMP_GT_MH] = instr_jmp_gt_mh_exec,
+	[INSTR_JMP_GT_HM] = instr_jmp_gt_hm_exec,
+	[INSTR_JMP_GT_HH] = instr_jmp_gt_hh_exec,
+	[INSTR_JMP_GT_MI] = instr_jmp_gt_mi_exec,
+	[INSTR_JMP_GT_HI] = instr_jmp_gt_hi_exec,
+
+	[INSTR_RETURN] = instr_return_exec,
+	[INSTR_BLOCK] = instr_block_exec,
+};
+
+static inline void
+instr_exec(struct rte_swx_pipeline *p)
+{
+	struct thread *t = &p->threads[p->thread_id];
+	struct instruction *ip = t->ip;
+	instr_exec_t instr = instruction_table[ip->type];
+
+	instr(p);
+}
+
+/*
+ * Action.
+ */
+static struct action *
+action_find(struct rte_swx_pipeline *p, const char *name)
+{
+	struct action *elem;
+
+	if (!name)
+		return NULL;
+
+	TAILQ_FOREACH(elem, &p->actions, node)
+		if (strcmp(elem->name, name) == 0)
+			return elem;
+
+	return NULL;
+}
+
+static struct action *
+action_find_by_id(struct rte_swx_pipeline *p, uint32_t id)
+{
+	struct action *action = NULL;
+
+	TAILQ_FOREACH(action, &p->actions, node)
+		if (action->id == id)
+			return action;
+
+	return NULL;
+}
+
+static struct field *
+action_field_find(struct action *a, const char *name)
+{
+	return a->st ? struct_type_field_find(a->st, name) : NULL;
+}
+
+static struct field *
+action_field_parse(struct action *action, const char *name)
+{
+	if (name[0] != 't' || name[1] != '.')
+		return NULL;
+
+	return action_field_find(action, &name[2]);
+}
+
+int
+rte_swx_pipeline_action_config(struct rte_swx_pipeline *p,
+			       const char *name,
+			       const char *args_struct_type_name,
+			       const char **instructions,
+			       uint32_t n_instructions)
+{
+	struct struct_type *args_struct_type;
+	struct action *a;
+	int err;
+
+	CHECK(p, EINVAL);
+
+	CHECK_NAME(name, EINVAL);
+	CHECK(!action_find(p, name), EEXIST);
+
+	if (args_struct_type_name) {
+		CHECK_NAME(args_struct_type_name, EINVAL);
+		args_struct_type = struct_type_find(p, args_struct_type_name);
+		CHECK(args_struct_type, EINVAL);
+	} else {
+		args_struct_type = NULL;
+	}
+
+	/* Node allocation. */
+	a = calloc(1, sizeof(struct action));
+	CHECK(a, ENOMEM);
+	if (args_struct_type) {
+		a->args_endianness = calloc(args_struct_type->n_fields, sizeof(int));
+		if (!a->args_endianness) {
+			free(a);
+			CHECK(0, ENOMEM);
+		}
+	}
+
+	/* Node initialization. */
+	strcpy(a->name, name);
+	a->st = args_struct_type;
+	a->id = p->n_actions;
+
+	/* Instruction translation. */
+	err = instruction_config(p, a, instructions, n_instructions);
+	if (err) {
+		free(a->args_endianness);
+		free(a);
+		return err;
+	}
+
+	/* Node add to tailq. */
+	TAILQ_INSERT_TAIL(&p->actions, a, node);
+	p->n_actions++;
+
+	return 0;
+}
+
+static int
+action_build(struct rte_swx_pipeline *p)
+{
+	struct action *action;
+
+	p->action_instructions = calloc(p->n_actions,
+					sizeof(struct instruction *));
+	CHECK(p->action_instructions, ENOMEM);
+
+	TAILQ_FOREACH(action, &p->actions, node)
+		p->action_instructions[action->id] = action->instructions;
+
+	/* Filled in by the code generator, if enabled. */
+	p->action_funcs = calloc(p->n_actions, sizeof(instr_exec_t));
+	CHECK(p->action_funcs, ENOMEM);
+
+	return 0;
+}
+
+static void
+action_build_free(struct rte_swx_pipeline *p)
+{
+	free(p->action_funcs);
+	p->action_funcs = NULL;
+
+	free(p->action_instructions);
+	p->action_instructions = NULL;
+}
+
+static void
+action_free(struct rte_swx_pipeline *p)
+{
+	action_build_free(p);
+
+	for ( ; ; ) {
+		struct action *action;
+
+		action = TAILQ_FIRST(&p->actions);
+		if (!action)
+			break;
+
+		TAILQ_REMOVE(&p->actions, action, node);
+		free(action->instructions);
+		free(action);
+	}
+}
+
+static uint32_t
+action_arg_src_mov_count(struct action *a,
+			 uint32_t arg_id,
+			 struct instruction *instructions,
+			 struct instruction_data *instruction_data,
+			 uint32_t n_instructions)
+{
+	uint32_t offset, n_users = 0, i;
+
+	if (!a->st ||
+	    (arg_id >= a->st->n_fields) ||
+	    !instructions ||
+	    !instruction_data ||
+	    !n_instructions)
+		return 0;
+
+	offset = a->st->fields[arg_id].offset / 8;
+
+	for (i = 0; i < n_instructions; i++) {
+		struct instruction *instr = &instructions[i];
+		struct instruction_data *data = &instruction_data[i];
+
+		if (data->invalid ||
+		    ((instr->type != INSTR_MOV) && (instr->type != INSTR_MOV_HM)) ||
+		    instr->mov.src.struct_id ||
+		    (instr->mov.src.offset != offset))
+			continue;
+
+		n_users++;
+	}
+
+	return n_users;
+}
+
+/*
+ * Table.
+ */
+static struct table_type *
+table_type_find(struct rte_swx_pipeline *p, const char *name)
+{
+	struct table_type *elem;
+
+	TAILQ_FOREACH(elem, &p->table_types, node)
+		if (strcmp(elem->name, name) == 0)
+			return elem;
+
+	return NULL;
+}
+
+static struct table_type *
+table_type_resolve(struct rte_swx_pipeline *p,
+		   const char *recommended_type_name,
+		   enum rte_swx_table_match_type match_type)
+{
+	struct table_type *elem;
+
+	/* Only consider the recommended type if the match type is correct. */
+	if (recommended_type_name)
+		TAILQ_FOREACH(elem, &p->table_types, node)
+			if (!strcmp(elem->name, recommended_type_name) &&
+			    (elem->match_type == match_type))
+				return elem;
+
+	/* Ignore the recommended type and get the first element with this match
+	 * type.
+	 */
+	TAILQ_FOREACH(elem, &p->table_types, node)
+		if (elem->match_type == match_type)
+			return elem;
+
+	return NULL;
+}
+
+static struct table *
+table_find(struct rte_swx_pipeline *p, const char *name)
+{
+	struct table *elem;
+
+	TAILQ_FOREACH(elem, &p->tables, node)
+		if (strcmp(elem->name, name) == 0)
+			return elem;
+
+	return NULL;
+}
+
+static struct table *
+table_find_by_id(struct rte_swx_pipeline *p, uint32_t id)
+{
+	struct table *table = NULL;
+
+	TAILQ_FOREACH(table, &p->tables, node)
+		if (table->id == id)
+			return table;
+
+	return NULL;
+}
+
+int
+rte_swx_pipeline_table_type_register(struct rte_swx_pipeline *p,
+				     const char *name,
+				     enum rte_swx_table_match_type match_type,
+				     struct rte_swx_table_ops *ops)
+{
+	struct table_type *elem;
+
+	CHECK(p, EINVAL);
+
+	CHECK_NAME(name, EINVAL);
+	CHECK(!table_type_find(p, name), EEXIST);
+
+	CHECK(ops, EINVAL);
+	CHECK(ops->create, EINVAL);
+	CHECK(ops->lkp, EINVAL);
+	CHECK(ops->free, EINVAL);
+
+	/* Node allocation. */
+	elem = calloc(1, sizeof(struct table_type));
+	CHECK(elem, ENOMEM);
+
+	/* Node initialization. */
+	strcpy(elem->name, name);
+	elem->match_type = match_type;
+	memcpy(&elem->ops, ops, sizeof(*ops));
+
+	/* Node add to tailq. */
+	TAILQ_INSERT_TAIL(&p->table_types, elem, node);
+
+	return 0;
+}
+
+static enum rte_swx_table_match_type
+table_match_type_resolve(struct rte_swx_match_field_params *fields,
+			 uint32_t n_fields,
+			 uint32_t max_offset_field_id)
+{
+	uint32_t n_fields_em = 0, i;
+
+	for (i = 0; i < n_fields; i++)
+		if (fields[i].match_type == RTE_SWX_TABLE_MATCH_EXACT)
+			n_fields_em++;
+
+	if (n_fields_em == n_fields)
+		return RTE_SWX_TABLE_MATCH_EXACT;
+
+	if ((n_fields_em == n_fields - 1) &&
+	    (fields[max_offset_field_id].match_type == RTE_SWX_TABLE_MATCH_LPM))
+		return RTE_SWX_TABLE_MATCH_LPM;
+
+	return RTE_SWX_TABLE_MATCH_WILDCARD;
+}
+
+static int
+table_match_fields_check(struct rte_swx_pipeline *p,
+			 struct rte_swx_pipeline_table_params *params,
+			 struct header **header,
+			 uint32_t *min_offset_field_id,
+			 uint32_t *max_offset_field_id)
+{
+	struct header *h0 = NULL;
+	struct field *hf, *mf;
+	uint32_t *offset = NULL, min_offset, max_offset, min_offset_pos, max_offset_pos, i;
+	int status = 0;
+
+	/* Return if no match fields. */
+	if (!params->n_fields) {
+		if (params->fields) {
+			status = -EINVAL;
+			goto end;
+		}
+
+		return 0;
+	}
+
+	/* Memory allocation. */
+	offset = calloc(params->n_fields, sizeof(uint32_t));
+	if (!offset) {
+		status = -ENOMEM;
+		goto end;
+	}
+
+	/* Check that all the match fields belong to either the same header or
+	 * to the meta-data.
+	 */
+	hf = header_field_parse(p, params->fields[0].name, &h0);
+	mf = metadata_field_parse(p, params->fields[0].name);
+	if (!hf && !mf) {
+		status = -EINVAL;
+		goto end;
+	}
+
+	offset[0] = h0 ? hf->offset : mf->offset;
+
+	for (i = 1; i < params->n_fields; i++)
+		if (h0) {
+			struct header *h;
+
+			hf = header_field_parse(p, params->fields[i].name, &h);
+			if (!hf || (h->id != h0->id)) {
+				status = -EINVAL;
+				goto end;
+			}
+
+			offset[i] = hf->offset;
+		} else {
+			mf = metadata_field_parse(p, params->fields[i].name);
+			if (!mf) {
+				status = -EINVAL;
+				goto end;
+			}
+
+			offset[i] = mf->offset;
+		}
+
+	/* Check that there are no duplicated match fields. */
+	for (i = 0; i < params->n_fields; i++) {
+		uint32_t j;
+
+		for (j = 0; j < i; j++)
+			if (offset[j] == offset[i]) {
+				status = -EINVAL;
+				goto end;
+			}
+	}
+
+	/* Find the min and max offset fields. */
+	min_offset = offset[0];
+	max_offset = offset[0];
+	min_offset_pos = 0;
+	max_offset_pos = 0;
+
+	for (i = 1; i < params->n_fields; i++) {
+		if (offset[i] < min_offset) {
+			min_offset = offset[i];
+			min_offset_pos = i;
+		}
+
+		if (offset[i] > max_offset) {
+			max_offset = offset[i];
+			max_offset_pos = i;
+		}
+	}
+
+	/* Return. */
+	if (header)
+		*header = h0;
+
+	if (min_offset_field_id)
+		*min_offset_field_id = min_offset_pos;
+
+	if (max_offset_field_id)
+		*max_offset_field_id = max_offset_pos;
+
+end:
+	free(offset);
+	return status;
+}
+
+int
+rte_swx_pipeline_table_config(struct rte_swx_pipeline *p,
+			      const char *name,
+			      struct rte_swx_pipeline_table_params *params,
+			      const char *recommended_table_type_name,
+			      const char *args,
+			      uint32_t size)
+{
+	struct table_type *type;
+	struct table *t;
+	struct action *default_action;
+	struct header *header = NULL;
+	uint32_t action_data_size_max = 0, min_offset_field_id = 0, max_offset_field_id = 0, i;
+	int status = 0;
+
+	CHECK(p, EINVAL);
+
+	CHECK_NAME(name, EINVAL);
+	CHECK(!table_find(p, name), EEXIST);
+
+	CHECK(params, EINVAL);
+
+	/* Match checks. */
+	status = table_match_fields_check(p,
+					  params,
+					  &header,
+					  &min_offset_field_id,
+					  &max_offset_field_id);
+	if (status)
+		return status;
+
+	/* Action checks. */
+	CHECK(params->n_actions, EINVAL);
+	CHECK(params->action_names, EINVAL);
+	for (i = 0; i < params->n_actions; i++) {
+		const char *action_name = params->action_names[i];
+		struct action *a;
+		uint32_t action_data_size;
+
+		CHECK_NAME(action_name, EINVAL);
+
+		a = action_find(p, action_name);
+		CHECK(a, EINVAL);
+
+		action_data_size = a->st ? a->st->n_bits / 8 : 0;
+		if (action_data_size > action_data_size_max)
+			action_data_size_max = action_data_size;
+	}
+
+	CHECK_NAME(params->default_action_name, EINVAL);
+	for (i = 0; i < p->n_actions; i++)
+		if (!strcmp(params->action_names[i],
+			    params->default_action_name))
+			break;
+	CHECK(i < params->n_actions, EINVAL);
+	default_action = action_find(p, params->default_action_name);
+	CHECK((default_action->st && params->default_action_data) ||
+	      !params->default_action_data, EINVAL);
+
+	/* Table type checks. */
+	if (recommended_table_type_name)
+		CHECK_NAME(recommended_table_type_name, EINVAL);
+
+	if (params->n_fields) {
+		enum rte_swx_table_match_type match_type;
+
+		match_type = table_match_type_resolve(params->fields,
+						      params->n_fields,
+						      max_offset_field_id);
+		type = table_type_resolve(p,
+					  recommended_table_type_name,
+					  match_type);
+		CHECK(type, EINVAL);
+	} else {
+		type = NULL;
+	}
+
+	/* Memory allocation. */
+	t = calloc(1, sizeof(struct table));
+	CHECK(t, ENOMEM);
+
+	t->fields = calloc(params->n_fields, sizeof(struct match_field));
+	if (!t->fields) {
+		free(t);
+		CHECK(0, ENOMEM);
+	}
+
+	t->actions = calloc(params->n_actions, sizeof(struct action *));
+	if (!t->actions) {
+		free(t->fields);
+		free(t);
+		CHECK(0, ENOMEM);
+	}
+
+	if (action_data_size_max) {
+		t->default_action_data = calloc(1, action_data_size_max);
+		if (!t->default_action_data) {
+			free(t->actions);
+			free(t->fields);
+			free(t);
+			CHECK(0, ENOMEM);
+		}
+	}
+
+	/* Node initialization. */
+	strcpy(t->name, name);
+	if (args && args[0])
+		strcpy(t->args, args);
+	t->type = type;
+
+	for (i = 0; i < params->n_fields; i++) {
+		struct rte_swx_match_field_params *field = &params->fields[i];
+		struct match_field *f = &t->fields[i];
+
+		f->match_type = field->match_type;
+		f->field = header ?
+			header_field_parse(p, field->name, NULL) :
+			metadata_field_parse(p, field->name);
+	}
+	t->n_fields = params->n_fields;
+	t->header = header;
+
+	for (i = 0; i < params->n_actions; i++)
+		t->actions[i] = action_find(p, params->action_names[i]);
+	t->default_action = default_action;
+	if (default_action->st)
+		memcpy(t->default_action_data,
+		       params->default_action_data,
+		       default_action->st->n_bits / 8);
+	t->n_actions = params->n_actions;
+	t->default_action_is_const = params->default_action_is_const;
+	t->action_data_size_max = action_data_size_max;
+
+	t->size = size;
+	t->id = p->n_tables;
+
+	/* Node add to tailq. */
+	TAILQ_INSERT_TAIL(&p->tables, t, node);
+	p->n_tables++;
+
+	return 0;
+}
+
+static struct rte_swx_table_params *
+table_params_get(struct table *table)
+{
+	struct rte_swx_table_params *params;
+	struct field *first, *last;
+	uint8_t *key_mask;
+	uint32_t key_size, key_offset, action_data_size, i;
+
+	/* Memory allocation. */
+	params = calloc(1, sizeof(struct rte_swx_table_params));
+	if (!params)
+		return NULL;
+
+	/* Find first (smallest offset) and last (biggest offset) match fields. */
+	first = table->fields[0].field;
+	last = table->fields[0].field;
+
+	for (i = 0; i < table->n_fields; i++) {
+		struct field *f = table->fields[i].field;
+
+		if (f->offset < first->offset)
+			first = f;
+
+		if (f->offset > last->offset)
+			last = f;
+	}
+
+	/* Key offset and size. */
+	key_offset = first->offset / 8;
+	key_size = (last->offset + last->n_bits - first->offset) / 8;
+
+	/* Memory allocation. */
+	key_mask = calloc(1, key_size);
+	if (!key_mask) {
+		free(params);
+		return NULL;
+	}
+
+	/* Key mask. */
+	for (i = 0; i < table->n_fields; i++) {
+		struct field *f = table->fields[i].field;
+		uint32_t start = (f->offset - first->offset) / 8;
+		size_t size = f->n_bits / 8;
+
+		memset(&key_mask[start], 0xFF, size);
+	}
+
+	/* Action data size. */
+	action_data_size = 0;
+	for (i = 0; i < table->n_actions; i++) {
+		struct action *action = table->actions[i];
+		uint32_t ads = action->st ? action->st->n_bits / 8 : 0;
+
+		if (ads > action_data_size)
+			action_data_size = ads;
+	}
+
+	/* Fill in. */
+	params->match_type = table->type->match_type;
+	params->key_size = key_size;
+	params->key_offset = key_offset;
+	params->key_mask0 = key_mask;
+	params->action_data_size = action_data_size;
+	params->n_keys_max = table->size;
+
+	return params;
+}
+
+static void
+table_params_free(struct rte_swx_table_params *params)
+{
+	if (!params)
+		return;
+
+	free(params->key_mask0);
+	free(params);
+}
+
+static int
+table_state_build(struct rte_swx_pipeline *p)
+{
+	struct table *table;
+
+	p->table_state = calloc(p->n_tables,
+				sizeof(struct rte_swx_table_state));
+	CHECK(p->table_state, ENOMEM);
+
+	TAILQ_FOREACH(table, &p->tables, node) {
+		struct rte_swx_table_state *ts = &p->table_state[table->id];
+
+		if (table->type) {
+			struct rte_swx_table_params *params;
+
+			/* ts->obj. */
+			params = table_params_get(table);
+			CHECK(params, ENOMEM);
+
+			ts->obj = table->type->ops.create(params,
+				NULL,
+				table->args,
+				p->numa_node);
+
+			table_params_free(params);
+			CHECK(ts->obj, ENODEV);
+		}
+
+		/* ts->default_action_data. */
+		if (table->action_data_size_max) {
+			ts->default_action_data =
+				malloc(table->action_data_size_max);
+			CHECK(ts->default_action_data, ENOMEM);
+
+			memcpy(ts->default_action_data,
+			       table->default_action_data,
+			       table->action_data_size_max);
+		}
+
+		/* ts->default_action_id. */
+		ts->default_action_id = table->default_action->id;
+	}
+
+	return 0;
+}
+
+static void
+table_state_build_free(struct rte_swx_pipeline *p)
+{
+	uint32_t i;
+
+	if (!p->table_state)
+		return;
+
+	for (i = 0; i < p->n_tables; i++) {
+		struct rte_swx_table_state *ts = &p->table_state[i];
+		struct table *table = table_find_by_id(p, i);
+
+		/* ts->obj. */
+		if (table->type && ts->obj)
+			table->type->ops.free(ts->obj);
+
+		/* ts->default_action_data. */
+		free(ts->default_action_data);
+	}
+
+	free(p->table_state);
+	p->table_state = NULL;
+}
+
+static void
+table_state_free(struct rte_swx_pipeline *p)
+{
+	table_state_build_free(p);
+}
+
+static int
+table_stub_lkp(void *table __rte_unused,
+	       void *mailbox __rte_unused,
+	       uint8_t **key __rte_unused,
+	       uint64_t *action_id __rte_unused,
+	       uint8_t **action_data __rte_unused,
+	       int *hit)
+{
+	*hit = 0;
+	return 1; /* DONE. */
+}
+
+static int
+table_build(struct rte_swx_pipeline *p)
+{
+	uint32_t i;
+
+	/* Per pipeline: table statistics. */
+	p->table_stats = calloc(p->n_tables, sizeof(struct table_statistics));
+	CHECK(p->table_stats, ENOMEM);
+
+	for (i = 0; i < p->n_tables; i++) {
+		p->table_stats[i].n_pkts_action = calloc(p->n_actions, sizeof(uint64_t));
+		CHECK(p->table_stats[i].n_pkts_action, ENOMEM);
+	}
+
+	/* Per thread: table runt-time. */
+	for (i = 0; i < RTE_SWX_PIPELINE_THREADS_MAX; i++) {
+		struct thread *t = &p->threads[i];
+		struct table *table;
+
+		t->tables = calloc(p->n_tables, sizeof(struct table_runtime));
+		CHECK(t->tables, ENOMEM);
+
+		TAILQ_FOREACH(table, &p->tables, node) {
+			struct table_runtime *r = &t->tables[table->id];
+
+			if (table->type) {
+				uint64_t size;
+
+				size = table->type->ops.mailbox_size_get();
+
+				/* r->func. */
+				r->func = table->type->ops.lkp;
+
+				/* r->mailbox. */
+				if (size) {
+					r->mailbox = calloc(1, size);
+					CHECK(r->mailbox, ENOMEM);
+				}
 
-	if (src_field_id == a->st->n_fields)
-		return;
+				/* r->key. */
+				r->key = table->header ?
+					&t->structs[table->header->struct_id] :
+					&t->structs[p->metadata_struct_id];
+			} else {
+				r->func = table_stub_lkp;
+			}
+		}
+	}
 
-	src_offset = instr[0].mov.src.offset;
+	/* Per pipeline: table bulk lookup. */
+	if (p->burst_size > 1) {
+		struct table *table;
 
-	/* Modify the instructions. */
-	instr[0].type = INSTR_DMA_HT;
-	instr[0].dma.dst.header_id[0] = h->id;
-	instr[0].dma.dst.struct_id[0] = h->struct_id;
-	instr[0].dma.src.offset[0] = (uint8_t)src_offset;
-	instr[0].dma.n_bytes[0] = h->st->n_bits / 8;
+		p->table_bursts = calloc(p->n_tables,
+					 sizeof(struct table_burst));
+		CHECK(p->table_bursts, ENOMEM);
 
-	for (i = 1; i < n_instr; i++)
-		data[i].invalid = 1;
+		TAILQ_FOREACH(table, &p->tables, node)
+			if (table->type)
+				p->table_bursts[table->id].func =
+					table->type->ops.lkp_bulk;
+	}
 
-	/* Update the endianness of the action arguments to header endianness. */
-	for (i = 0; i < h->st->n_fields; i++)
-		a->args_endianness[src_field_id + i] = 1;
+	return 0;
 }
 
-static uint32_t
-instr_pattern_mov_all_validate_optimize(struct rte_swx_pipeline *p,
-					struct action *a,
-					struct instruction *instructions,
-					struct instruction_data *instruction_data,
-					uint32_t n_instructions)
+static void
+table_build_free(struct rte_swx_pipeline *p)
 {
 	uint32_t i;
 
-	if (!a || !a->st)
-		return n_instructions;
-
-	for (i = 0; i < n_instructions; ) {
-		struct instruction *instr = &instructions[i];
-		struct instruction_data *data = &instruction_data[i];
-		uint32_t n_instr = 0;
-		int detected;
+	for (i = 0; i < RTE_SWX_PIPELINE_THREADS_MAX; i++) {
+		struct thread *t = &p->threads[i];
+		uint32_t j;
 
-		/* Mov all + validate. */
-		detected = instr_pattern_mov_all_validate_search(p,
-								 a,
-								 instr,
-								 data,
-								 n_instructions - i,
-								 instructions,
-								 instruction_data,
-								 n_instructions,
-								 &n_instr);
-		if (detected) {
-			instr_pattern_mov_all_validate_replace(p, a, instr, data, n_instr);
-			i += n_instr;
+		if (!t->tables)
 			continue;
+
+		for (j = 0; j < p->n_tables; j++) {
+			struct table_runtime *r = &t->tables[j];
+
+			free(r->mailbox);
 		}
 
-		/* No pattern starting at the current instruction. */
-		i++;
+		free(t->tables);
+		t->tables = NULL;
 	}
 
-	/* Eliminate the invalid instructions that have been optimized out. */
-	n_instructions = instr_compact(instructions,
-				       instruction_data,
-				       n_instructions);
+	if (p->table_stats) {
+		for (i = 0; i < p->n_tables; i++)
+			free(p->table_stats[i].n_pkts_action);
 
-	return n_instructions;
+		free(p->table_stats);
+	}
+
+	free(p->table_bursts);
+	p->table_bursts = NULL;
 }
 
-static int
-instr_pattern_dma_many_search(struct instruction *instr,
-			      struct instruction_data *data,
-			      uint32_t n_instr,
-			      uint32_t *n_pattern_instr)
+static void
+table_free(struct rte_swx_pipeline *p)
 {
-	uint32_t i;
+	table_build_free(p);
 
-	for (i = 0; i < n_instr; i++) {
-		if (data[i].invalid)
-			break;
+	/* Tables. */
+	for ( ; ; ) {
+		struct table *elem;
 
-		if (instr[i].type != INSTR_DMA_HT)
+		elem = TAILQ_FIRST(&p->tables);
+		if (!elem)
 			break;
 
-		if (i == RTE_DIM(instr->dma.dst.header_id))
-			break;
+		TAILQ_REMOVE(&p->tables, elem, node);
+		free(elem->fields);
+		free(elem->actions);
+		free(elem->default_action_data);
+		free(elem);
+	}
 
-		if (i && data[i].n_users)
+	/* Table types. */
+	for ( ; ; ) {
+		struct table_type *elem;
+
+		elem = TAILQ_FIRST(&p->table_types);
+		if (!elem)
 			break;
+
+		TAILQ_REMOVE(&p->table_types, elem, node);
+		free(elem);
 	}
+}
 
-	if (i < 2)
-		return 0;
+/*
+ * Learner table.
+ */
+static struct learner *
+learner_find(struct rte_swx_pipeline *p, const char *name)
+{
+	struct learner *l;
 
-	*n_pattern_instr = i;
-	return 1;
+	TAILQ_FOREACH(l, &p->learners, node)
+		if (!strcmp(l->name, name))
+			return l;
+
+	return NULL;
 }
 
-static void
-instr_pattern_dma_many_replace(struct instruction *instr,
-			       struct instruction_data *data,
-			       uint32_t n_instr)
+static struct learner *
+learner_find_by_id(struct rte_swx_pipeline *p, uint32_t id)
 {
-	uint32_t i;
+	struct learner *l = NULL;
 
-	for (i = 1; i < n_instr; i++) {
-		instr[0].type++;
-		instr[0].dma.dst.header_id[i] = instr[i].dma.dst.header_id[0];
-		instr[0].dma.dst.struct_id[i] = instr[i].dma.dst.struct_id[0];
-		instr[0].dma.src.offset[i] = instr[i].dma.src.offset[0];
-		instr[0].dma.n_bytes[i] = instr[i].dma.n_bytes[0];
+	TAILQ_FOREACH(l, &p->learners, node)
+		if (l->id == id)
+			return l;
 
-		data[i].invalid = 1;
-	}
+	return NULL;
 }
 
-static uint32_t
-instr_pattern_dma_many_optimize(struct instruction *instructions,
-	       struct instruction_data *instruction_data,
-	       uint32_t n_instructions)
+static int
+learner_match_fields_check(struct rte_swx_pipeline *p,
+			   struct rte_swx_pipeline_learner_params *params,
+			   struct header **header)
 {
+	struct header *h0 = NULL;
+	struct field *hf, *mf;
 	uint32_t i;
 
-	for (i = 0; i < n_instructions; ) {
-		struct instruction *instr = &instructions[i];
-		struct instruction_data *data = &instruction_data[i];
-		uint32_t n_instr = 0;
-		int detected;
+	/* Return if no match fields. */
+	if (!params->n_fields || !params->field_names)
+		return -EINVAL;
 
-		/* DMA many. */
-		detected = instr_pattern_dma_many_search(instr,
-							 data,
-							 n_instructions - i,
-							 &n_instr);
-		if (detected) {
-			instr_pattern_dma_many_replace(instr, data, n_instr);
-			i += n_instr;
-			continue;
+	/* Check that all the match fields either belong to the same header
+	 * or are all meta-data fields.
+	 */
+	hf = header_field_parse(p, params->field_names[0], &h0);
+	mf = metadata_field_parse(p, params->field_names[0]);
+	if (!hf && !mf)
+		return -EINVAL;
+
+	for (i = 1; i < params->n_fields; i++)
+		if (h0) {
+			struct header *h;
+
+			hf = header_field_parse(p, params->field_names[i], &h);
+			if (!hf || (h->id != h0->id))
+				return -EINVAL;
+		} else {
+			mf = metadata_field_parse(p, params->field_names[i]);
+			if (!mf)
+				return -EINVAL;
 		}
 
-		/* No pattern starting at the current instruction. */
-		i++;
+	/* Check that there are no duplicated match fields. */
+	for (i = 0; i < params->n_fields; i++) {
+		const char *field_name = params->field_names[i];
+		uint32_t j;
+
+		for (j = i + 1; j < params->n_fields; j++)
+			if (!strcmp(params->field_names[j], field_name))
+				return -EINVAL;
 	}
 
-	/* Eliminate the invalid instructions that have been optimized out. */
-	n_instructions = instr_compact(instructions,
-				       instruction_data,
-				       n_instructions);
+	/* Return. */
+	if (header)
+		*header = h0;
 
-	return n_instructions;
+	return 0;
 }
 
-static uint32_t
-instr_optimize(struct rte_swx_pipeline *p,
-	       struct action *a,
-	       struct instruction *instructions,
-	       struct instruction_data *instruction_data,
-	       uint32_t n_instructions)
+int
+rte_swx_pipeline_learner_config(struct rte_swx_pipeline *p,
+			      const char *name,
+			      struct rte_swx_pipeline_learner_params *params,
+			      uint32_t size,
+			      uint32_t timeout)
 {
-	/* Extract many. */
-	n_instructions = instr_pattern_extract_many_optimize(instructions,
-							     instruction_data,
-							     n_instructions);
-
-	/* Emit many + TX. */
-	n_instructions = instr_pattern_emit_many_tx_optimize(instructions,
-							     instruction_data,
-							     n_instructions);
-
-	/* Mov all + validate. */
-	n_instructions = instr_pattern_mov_all_validate_optimize(p,
-								 a,
-								 instructions,
-								 instruction_data,
-								 n_instructions);
-
-	/* DMA many. */
-	n_instructions = instr_pattern_dma_many_optimize(instructions,
-							 instruction_data,
-							 n_instructions);
+	struct learner *l = NULL;
+	struct action *default_action;
+	struct header *header = NULL;
+	uint32_t action_data_size_max = 0, i;
+	int status = 0;
 
-	return n_instructions;
-}
+	CHECK(p, EINVAL);
 
-static int
-instruction_config(struct rte_swx_pipeline *p,
-		   struct action *a,
-		   const char **instructions,
-		   uint32_t n_instructions)
-{
-	struct instruction *instr = NULL;
-	struct instruction_data *data = NULL;
-	int err = 0;
-	uint32_t i;
+	CHECK_NAME(name, EINVAL);
+	CHECK(!table_find(p, name), EEXIST);
+	CHECK(!learner_find(p, name), EEXIST);
 
-	CHECK(n_instructions, EINVAL);
-	CHECK(instructions, EINVAL);
-	for (i = 0; i < n_instructions; i++)
-		CHECK_INSTRUCTION(instructions[i], EINVAL);
+	CHECK(params, EINVAL);
 
-	/* Memory allocation. */
-	instr = calloc(n_instructions, sizeof(struct instruction));
-	if (!instr) {
-		err = -ENOMEM;
-		goto error;
-	}
+	/* Match checks. */
+	status = learner_match_fields_check(p, params, &header);
+	if (status)
+		return status;
 
-	data = calloc(n_instructions, sizeof(struct instruction_data));
-	if (!data) {
-		err = -ENOMEM;
-		goto error;
-	}
+	/* Action checks. */
+	CHECK(params->n_actions, EINVAL);
+	CHECK(params->action_names, EINVAL);
+	for (i = 0; i < params->n_actions; i++) {
+		const char *action_name = params->action_names[i];
+		struct action *a;
+		uint32_t action_data_size;
 
-	for (i = 0; i < n_instructions; i++) {
-		char *string = strdup(instructions[i]);
-		if (!string) {
-			err = -ENOMEM;
-			goto error;
-		}
+		CHECK_NAME(action_name, EINVAL);
 
-		err = instr_translate(p, a, string, &instr[i], &data[i]);
-		if (err) {
-			free(string);
-			goto error;
-		}
+		a = action_find(p, action_name);
+		CHECK(a, EINVAL);
 
-		free(string);
+		action_data_size = a->st ? a->st->n_bits / 8 : 0;
+		if (action_data_size > action_data_size_max)
+			action_data_size_max = action_data_size;
 	}
 
-	err = instr_label_check(data, n_instructions);
-	if (err)
-		goto error;
+	CHECK_NAME(params->default_action_name, EINVAL);
+	for (i = 0; i < params->n_actions; i++)
+		if (!strcmp(params->action_names[i],
+			    params->default_action_name))
+			break;
+	CHECK(i < params->n_actions, EINVAL);
 
-	err = instr_verify(p, a, instr, data, n_instructions);
-	if (err)
-		goto error;
+	default_action = action_find(p, params->default_action_name);
+	CHECK((default_action->st && params->default_action_data) ||
+	      !params->default_action_data, EINVAL);
 
-	n_instructions = instr_optimize(p, a, instr, data, n_instructions);
+	/* Any other checks. */
+	CHECK(size, EINVAL);
+	CHECK(timeout, EINVAL);
 
-	err = instr_jmp_resolve(instr, data, n_instructions);
-	if (err)
-		goto error;
+	/* Memory allocation. */
+	l = calloc(1, sizeof(struct learner));
+	if (!l)
+		goto nomem;
 
-	if (a) {
-		a->instructions = instr;
-		a->n_instructions = n_instructions;
-	} else {
-		p->instructions = instr;
-		p->n_instructions = n_instructions;
-	}
+	l->fields = calloc(params->n_fields, sizeof(struct field *));
+	if (!l->fields)
+		goto nomem;
 
-	free(data);
-	return 0;
+	l->actions = calloc(params->n_actions, sizeof(struct action *));
+	if (!l->actions)
+		goto nomem;
 
-error:
-	free(data);
-	free(instr);
-	return err;
-}
+	if (action_data_size_max) {
+		l->default_action_data = calloc(1, action_data_size_max);
+		if (!l->default_action_data)
+			goto nomem;
+	}
 
-typedef void (*instr_exec_t)(struct rte_swx_pipeline *);
+	/* Node initialization. */
+	strcpy(l->name, name);
 
-static instr_exec_t instruction_table[] = {
-	[INSTR_RX] = instr_rx_exec,
-	[INSTR_TX] = instr_tx_exec,
-	[INSTR_TX_I] = instr_tx_i_exec,
+	for (i = 0; i < params->n_fields; i++) {
+		const char *field_name = params->field_names[i];
 
-	[INSTR_HDR_EXTRACT] = instr_hdr_extract_exec,
-	[INSTR_HDR_EXTRACT2] = instr_hdr_extract2_exec,
-	[INSTR_HDR_EXTRACT3] = instr_hdr_extract3_exec,
-	[INSTR_HDR_EXTRACT4] = instr_hdr_extract4_exec,
-	[INSTR_HDR_EXTRACT5] = instr_hdr_extract5_exec,
-	[INSTR_HDR_EXTRACT6] = instr_hdr_extract6_exec,
-	[INSTR_HDR_EXTRACT7] = instr_hdr_extract7_exec,
-	[INSTR_HDR_EXTRACT8] = instr_hdr_extract8_exec,
+		l->fields[i] = header ?
+			header_field_parse(p, field_name, NULL) :
+			metadata_field_parse(p, field_name);
+	}
 
-	[INSTR_HDR_EMIT] = instr_hdr_emit_exec,
-	[INSTR_HDR_EMIT_TX] = instr_hdr_emit_tx_exec,
-	[INSTR_HDR_EMIT2_TX] = instr_hdr_emit2_tx_exec,
-	[INSTR_HDR_EMIT3_TX] = instr_hdr_emit3_tx_exec,
-	[INSTR_HDR_EMIT4_TX] = instr_hdr_emit4_tx_exec,
-	[INSTR_HDR_EMIT5_TX] = instr_hdr_emit5_tx_exec,
-	[INSTR_HDR_EMIT6_TX] = instr_hdr_emit6_tx_exec,
-	[INSTR_HDR_EMIT7_TX] = instr_hdr_emit7_tx_exec,
-	[INSTR_HDR_EMIT8_TX] = instr_hdr_emit8_tx_exec,
+	l->n_fields = params->n_fields;
 
-	[INSTR_HDR_VALIDATE] = instr_hdr_validate_exec,
-	[INSTR_HDR_INVALIDATE] = instr_hdr_invalidate_exec,
+	l->header = header;
 
-	[INSTR_MOV] = instr_mov_exec,
-	[INSTR_MOV_MH] = instr_mov_mh_exec,
-	[INSTR_MOV_HM] = instr_mov_hm_exec,
-	[INSTR_MOV_HH] = instr_mov_hh_exec,
-	[INSTR_MOV_I] = instr_mov_i_exec,
+	for (i = 0; i < params->n_actions; i++)
+		l->actions[i] = action_find(p, params->action_names[i]);
 
-	[INSTR_DMA_HT] = instr_dma_ht_exec,
-	[INSTR_DMA_HT2] = instr_dma_ht2_exec,
-	[INSTR_DMA_HT3] = instr_dma_ht3_exec,
-	[INSTR_DMA_HT4] = instr_dma_ht4_exec,
-	[INSTR_DMA_HT5] = instr_dma_ht5_exec,
-	[INSTR_DMA_HT6] = instr_dma_ht6_exec,
-	[INSTR_DMA_HT7] = instr_dma_ht7_exec,
-	[INSTR_DMA_HT8] = instr_dma_ht8_exec,
+	l->default_action = default_action;
 
-	[INSTR_ALU_ADD] = instr_alu_add_exec,
-	[INSTR_ALU_ADD_MH] = instr_alu_add_mh_exec,
-	[INSTR_ALU_ADD_HM] = instr_alu_add_hm_exec,
-	[INSTR_ALU_ADD_HH] = instr_alu_add_hh_exec,
-	[INSTR_ALU_ADD_MI] = instr_alu_add_mi_exec,
-	[INSTR_ALU_ADD_HI] = instr_alu_add_hi_exec,
+	if (default_action->st && params->default_action_data)
+		memcpy(l->default_action_data,
+		       params->default_action_data,
+		       default_action->st->n_bits / 8);
 
-	[INSTR_ALU_SUB] = instr_alu_sub_exec,
-	[INSTR_ALU_SUB_MH] = instr_alu_sub_mh_exec,
-	[INSTR_ALU_SUB_HM] = instr_alu_sub_hm_exec,
-	[INSTR_ALU_SUB_HH] = instr_alu_sub_hh_exec,
-	[INSTR_ALU_SUB_MI] = instr_alu_sub_mi_exec,
-	[INSTR_ALU_SUB_HI] = instr_alu_sub_hi_exec,
+	l->n_actions = params->n_actions;
 
-	[INSTR_ALU_CKADD_FIELD] = instr_alu_ckadd_field_exec,
-	[INSTR_ALU_CKADD_STRUCT] = instr_alu_ckadd_struct_exec,
-	[INSTR_ALU_CKADD_STRUCT20] = instr_alu_ckadd_struct20_exec,
-	[INSTR_ALU_CKSUB_FIELD] = instr_alu_cksub_field_exec,
+	l->action_data_size_max = action_data_size_max;
 
-	[INSTR_ALU_AND] = instr_alu_and_exec,
-	[INSTR_ALU_AND_MH] = instr_alu_and_mh_exec,
-	[INSTR_ALU_AND_HM] = instr_alu_and_hm_exec,
-	[INSTR_ALU_AND_HH] = instr_alu_and_hh_exec,
-	[INSTR_ALU_AND_I] = instr_alu_and_i_exec,
+	l->size = size;
 
-	[INSTR_ALU_OR] = instr_alu_or_exec,
-	[INSTR_ALU_OR_MH] = instr_alu_or_mh_exec,
-	[INSTR_ALU_OR_HM] = instr_alu_or_hm_exec,
-	[INSTR_ALU_OR_HH] = instr_alu_or_hh_exec,
-	[INSTR_ALU_OR_I] = instr_alu_or_i_exec,
+	l->timeout = timeout;
 
-	[INSTR_ALU_XOR] = instr_alu_xor_exec,
-	[INSTR_ALU_XOR_MH] = instr_alu_xor_mh_exec,
-	[INSTR_ALU_XOR_HM] = instr_alu_xor_hm_exec,
-	[INSTR_ALU_XOR_HH] = instr_alu_xor_hh_exec,
-	[INSTR_ALU_XOR_I] = instr_alu_xor_i_exec,
+	l->id = p->n_learners;
 
-	[INSTR_ALU_SHL] = instr_alu_shl_exec,
-	[INSTR_ALU_SHL_MH] = instr_alu_shl_mh_exec,
-	[INSTR_ALU_SHL_HM] = instr_alu_shl_hm_exec,
-	[INSTR_ALU_SHL_HH] = instr_alu_shl_hh_exec,
-	[INSTR_ALU_SHL_MI] = instr_alu_shl_mi_exec,
-	[INSTR_ALU_SHL_HI] = instr_alu_shl_hi_exec,
+	/* Node add to tailq. */
+	TAILQ_INSERT_TAIL(&p->learners, l, node);
+	p->n_learners++;
 
-	[INSTR_ALU_SHR] = instr_alu_shr_exec,
-	[INSTR_ALU_SHR_MH] = instr_alu_shr_mh_exec,
-	[INSTR_ALU_SHR_HM] = instr_alu_shr_hm_exec,
-	[INSTR_ALU_SHR_HH] = instr_alu_shr_hh_exec,
-	[INSTR_ALU_SHR_MI] = instr_alu_shr_mi_exec,
-	[INSTR_ALU_SHR_HI] = instr_alu_shr_hi_exec,
+	return 0;
 
-	[INSTR_REGPREFETCH_RH] = instr_regprefetch_rh_exec,
-	[INSTR_REGPREFETCH_RM] = instr_regprefetch_rm_exec,
-	[INSTR_REGPREFETCH_RI] = instr_regprefetch_ri_exec,
+nomem:
+	if (l) {
+		free(l->actions);
+		free(l->fields);
+	}
+	free(l);
 
-	[INSTR_REGRD_HRH] = instr_regrd_hrh_exec,
-	[INSTR_REGRD_HRM] = instr_regrd_hrm_exec,
-	[INSTR_REGRD_MRH] = instr_regrd_mrh_exec,
-	[INSTR_REGRD_MRM] = instr_regrd_mrm_exec,
-	[INSTR_REGRD_HRI] = instr_regrd_hri_exec,
-	[INSTR_REGRD_MRI] = instr_regrd_mri_exec,
+	return -ENOMEM;
+}
 
-	[INSTR_REGWR_RHH] = instr_regwr_rhh_exec,
-	[INSTR_REGWR_RHM] = instr_regwr_rhm_exec,
-	[INSTR_REGWR_RMH] = instr_regwr_rmh_exec,
-	[INSTR_REGWR_RMM] = instr_regwr_rmm_exec,
-	[INSTR_REGWR_RHI] = instr_regwr_rhi_exec,
-	[INSTR_REGWR_RMI] = instr_regwr_rmi_exec,
-	[INSTR_REGWR_RIH] = instr_regwr_rih_exec,
-	[INSTR_REGWR_RIM] = instr_regwr_rim_exec,
-	[INSTR_REGWR_RII] = instr_regwr_rii_exec,
+static void
+learner_params_free(struct rte_swx_table_learner_params *params)
+{
+	if (!params)
+		return;
 
-	[INSTR_REGADD_RHH] = instr_regadd_rhh_exec,
-	[INSTR_REGADD_RHM] = instr_regadd_rhm_exec,
-	[INSTR_REGADD_RMH] = instr_regadd_rmh_exec,
-	[INSTR_REGADD_RMM] = instr_regadd_rmm_exec,
-	[INSTR_REGADD_RHI] = instr_regadd_rhi_exec,
-	[INSTR_REGADD_RMI] = instr_regadd_rmi_exec,
-	[INSTR_REGADD_RIH] = instr_regadd_rih_exec,
-	[INSTR_REGADD_RIM] = instr_regadd_rim_exec,
-	[INSTR_REGADD_RII] = instr_regadd_rii_exec,
+	free(params->key_mask0);
 
-	[INSTR_METPREFETCH_H] = instr_metprefetch_h_exec,
-	[INSTR_METPREFETCH_M] = instr_metprefetch_m_exec,
-	[INSTR_METPREFETCH_I] = instr_metprefetch_i_exec,
+	free(params);
+}
 
-	[INSTR_METER_HHM] = instr_meter_hhm_exec,
-	[INSTR_METER_HHI] = instr_meter_hhi_exec,
-	[INSTR_METER_HMM] = instr_meter_hmm_exec,
-	[INSTR_METER_HMI] = instr_meter_hmi_exec,
-	[INSTR_METER_MHM] = instr_meter_mhm_exec,
-	[INSTR_METER_MHI] = instr_meter_mhi_exec,
-	[INSTR_METER_MMM] = instr_meter_mmm_exec,
-	[INSTR_METER_MMI] = instr_meter_mmi_exec,
-	[INSTR_METER_IHM] = instr_meter_ihm_exec,
-	[INSTR_METER_IHI] = instr_meter_ihi_exec,
-	[INSTR_METER_IMM] = instr_meter_imm_exec,
-	[INSTR_METER_IMI] = instr_meter_imi_exec,
+static struct rte_swx_table_learner_params *
+learner_params_get(struct learner *l)
+{
+	struct rte_swx_table_learner_params *params = NULL;
+	struct field *first, *last;
+	uint32_t i;
 
-	[INSTR_TABLE] = instr_table_exec,
-	[INSTR_EXTERN_OBJ] = instr_extern_obj_exec,
-	[INSTR_EXTERN_FUNC] = instr_extern_func_exec,
+	/* Memory allocation. */
+	params = calloc(1, sizeof(struct rte_swx_table_learner_params));
+	if (!params)
+		goto error;
 
-	[INSTR_JMP] = instr_jmp_exec,
-	[INSTR_JMP_VALID] = instr_jmp_valid_exec,
-	[INSTR_JMP_INVALID] = instr_jmp_invalid_exec,
-	[INSTR_JMP_HIT] = instr_jmp_hit_exec,
-	[INSTR_JMP_MISS] = instr_jmp_miss_exec,
-	[INSTR_JMP_ACTION_HIT] = instr_jmp_action_hit_exec,
-	[INSTR_JMP_ACTION_MISS] = instr_jmp_action_miss_exec,
+	/* Find first (smallest offset) and last (biggest offset) match fields. */
+	first = l->fields[0];
+	last = l->fields[0];
 
-	[INSTR_JMP_EQ] = instr_jmp_eq_exec,
-	[INSTR_JMP_EQ_MH] = instr_jmp_eq_mh_exec,
-	[INSTR_JMP_EQ_HM] = instr_jmp_eq_hm_exec,
-	[INSTR_JMP_EQ_HH] = instr_jmp_eq_hh_exec,
-	[INSTR_JMP_EQ_I] = instr_jmp_eq_i_exec,
+	for (i = 0; i < l->n_fields; i++) {
+		struct field *f = l->fields[i];
 
-	[INSTR_JMP_NEQ] = instr_jmp_neq_exec,
-	[INSTR_JMP_NEQ_MH] = instr_jmp_neq_mh_exec,
-	[INSTR_JMP_NEQ_HM] = instr_jmp_neq_hm_exec,
-	[INSTR_JMP_NEQ_HH] = instr_jmp_neq_hh_exec,
-	[INSTR_JMP_NEQ_I] = instr_jmp_neq_i_exec,
+		if (f->offset < first->offset)
+			first = f;
 
-	[INSTR_JMP_LT] = instr_jmp_lt_exec,
-	[INSTR_JMP_LT_MH] = instr_jmp_lt_mh_exec,
-	[INSTR_JMP_LT_HM] = instr_jmp_lt_hm_exec,
-	[INSTR_JMP_LT_HH] = instr_jmp_lt_hh_exec,
-	[INSTR_JMP_LT_MI] = instr_jmp_lt_mi_exec,
-	[INSTR_JMP_LT_HI] = instr_jmp_lt_hi_exec,
+		if (f->offset > last->offset)
+			last = f;
+	}
 
-	[INSTR_JMP_GT] = instr_jmp_gt_exec,
-	[INSTR_JMP_GT_MH] = instr_jmp_gt_mh_exec,
-	[INSTR_JMP_GT_HM] = instr_jmp_gt_hm_exec,
-	[INSTR_JMP_GT_HH] = instr_jmp_gt_hh_exec,
-	[INSTR_JMP_GT_MI] = instr_jmp_gt_mi_exec,
-	[INSTR_JMP_GT_HI] = instr_jmp_gt_hi_exec,
+	/* Key offset and size. */
+	params->key_offset = first->offset / 8;
+	params->key_size = (last->offset + last->n_bits - first->offset) / 8;
 
-	[INSTR_RETURN] = instr_return_exec,
-};
+	/* Memory allocation. */
+	params->key_mask0 = calloc(1, params->key_size);
+	if (!params->key_mask0)
+		goto error;
+
+	/* Key mask. */
+	for (i = 0; i < l->n_fields; i++) {
+		struct field *f = l->fields[i];
+		uint32_t start = (f->offset - first->offset) / 8;
+		size_t size = f->n_bits / 8;
 
-static inline void
-instr_exec(struct rte_swx_pipeline *p)
-{
-	struct thread *t = &p->threads[p->thread_id];
-	struct instruction *ip = t->ip;
-	instr_exec_t instr = instruction_table[ip->type];
+		memset(&params->key_mask0[start], 0xFF, size);
+	}
 
-	instr(p);
-}
+	/* Action data size. */
+	params->action_data_size = l->action_data_size_max;
 
-/*
- * Action.
- */
-static struct action *
-action_find(struct rte_swx_pipeline *p, const char *name)
-{
-	struct action *elem;
+	/* Maximum number of keys. */
+	params->n_keys_max = l->size;
 
-	if (!name)
-		return NULL;
+	/* Timeout. */
+	params->key_timeout = l->timeout;
 
-	TAILQ_FOREACH(elem, &p->actions, node)
-		if (strcmp(elem->name, name) == 0)
-			return elem;
+	return params;
 
+error:
+	learner_params_free(params);
 	return NULL;
 }
 
-static struct action *
-action_find_by_id(struct rte_swx_pipeline *p, uint32_t id)
+static int
+learner_action_find(struct learner *l, uint32_t action_id)
 {
-	struct action *action = NULL;
+	uint32_t i;
 
-	TAILQ_FOREACH(action, &p->actions, node)
-		if (action->id == id)
-			return action;
+	for (i = 0; i < l->n_actions; i++)
+		if (l->actions[i]->id == action_id)
+			return 1;
 
-	return NULL;
+	return 0;
 }
 
-static struct field *
-action_field_find(struct action *a, const char *name)
+static uint32_t
+action_does_learning(struct action *a)
 {
-	return a->st ? struct_type_field_find(a->st, name) : NULL;
-}
+	uint32_t i;
 
-static struct field *
-action_field_parse(struct action *action, const char *name)
-{
-	if (name[0] != 't' || name[1] != '.')
-		return NULL;
+	for (i = 0; i < a->n_instructions; i++)
+		switch (a->instructions[i].type) {
+		case INSTR_LEARNER_LEARN:
+			return 1;
 
-	return action_field_find(action, &name[2]);
+		case INSTR_LEARNER_FORGET:
+			return 1;
+
+		default:
+			continue;
+		}
+
+	return 0;
 }
 
-int
-rte_swx_pipeline_action_config(struct rte_swx_pipeline *p,
-			       const char *name,
-			       const char *args_struct_type_name,
-			       const char **instructions,
-			       uint32_t n_instructions)
+/* The learn and forget instructions work on the latest learner table lookup,
+ * so they can only be used by the actions of the learner tables. Any learned
+ * action has to be one of the actions of the learner table, with its arguments
+ * read from within the meta-data.
+ */
+static int
+learner_action_check(struct rte_swx_pipeline *p)
 {
-	struct struct_type *args_struct_type;
-	struct action *a;
-	int err;
-
-	CHECK(p, EINVAL);
+	uint32_t n_bytes = p->metadata_st->n_bits / 8;
+	struct table *table;
+	struct learner *l;
 
-	CHECK_NAME(name, EINVAL);
-	CHECK(!action_find(p, name), EEXIST);
+	TAILQ_FOREACH(table, &p->tables, node) {
+		uint32_t i;
 
-	if (args_struct_type_name) {
-		CHECK_NAME(args_struct_type_name, EINVAL);
-		args_struct_type = struct_type_find(p, args_struct_type_name);
-		CHECK(args_struct_type, EINVAL);
-	} else {
-		args_struct_type = NULL;
+		for (i = 0; i < table->n_actions; i++)
+			CHECK(!action_does_learning(table->actions[i]), EINVAL);
 	}
 
-	/* Node allocation. */
-	a = calloc(1, sizeof(struct action));
-	CHECK(a, ENOMEM);
-	if (args_struct_type) {
-		a->args_endianness = calloc(args_struct_type->n_fields, sizeof(int));
-		if (!a->args_endianness) {
-			free(a);
-			CHECK(0, ENOMEM);
-		}
-	}
+	TAILQ_FOREACH(l, &p->learners, node) {
+		uint32_t i;
 
-	/* Node initialization. */
-	strcpy(a->name, name);
-	a->st = args_struct_type;
-	a->id = p->n_actions;
+		for (i = 0; i < l->n_actions; i++) {
+			struct action *a = l->actions[i];
+			uint32_t j;
 
-	/* Instruction translation. */
-	err = instruction_config(p, a, instructions, n_instructions);
-	if (err) {
-		free(a->args_endianness);
-		free(a);
-		return err;
-	}
+			for (j = 0; j < a->n_instructions; j++) {
+				struct instruction *instr = &a->instructions[j];
 
-	/* Node add to tailq. */
-	TAILQ_INSERT_TAIL(&p->actions, a, node);
-	p->n_actions++;
+				if (instr->type != INSTR_LEARNER_LEARN)
+					continue;
+
+				CHECK(learner_action_find(l,
+					instr->learn.action_id), EINVAL);
+				CHECK(instr->learn.mf_offset +
+				      l->action_data_size_max <= n_bytes,
+				      EINVAL);
+			}
+		}
+	}
 
 	return 0;
 }
 
-static int
-action_build(struct rte_swx_pipeline *p)
+static void
+learner_build_free(struct rte_swx_pipeline *p)
 {
-	struct action *action;
+	uint32_t i;
 
-	p->action_instructions = calloc(p->n_actions,
-					sizeof(struct instruction *));
-	CHECK(p->action_instructions, ENOMEM);
+	for (i = 0; i < RTE_SWX_PIPELINE_THREADS_MAX; i++) {
+		struct thread *t = &p->threads[i];
+		uint32_t j;
 
-	TAILQ_FOREACH(action, &p->actions, node)
-		p->action_instructions[action->id] = action->instructions;
+		if (!t->learners)
+			continue;
 
-	return 0;
-}
+		for (j = 0; j < p->n_learners; j++) {
+			struct learner_runtime *r = &t->learners[j];
 
-static void
-action_build_free(struct rte_swx_pipeline *p)
-{
-	free(p->action_instructions);
-	p->action_instructions = NULL;
-}
+			free(r->mailbox);
+		}
 
-static void
-action_free(struct rte_swx_pipeline *p)
-{
-	action_build_free(p);
+		free(t->learners);
+		t->learners = NULL;
+	}
 
-	for ( ; ; ) {
-		struct action *action;
+	if (p->learner_state) {
+		for (i = 0; i < p->n_learners; i++) {
+			struct rte_swx_table_state *ts = &p->learner_state[i];
 
-		action = TAILQ_FIRST(&p->actions);
-		if (!action)
-			break;
+			rte_swx_table_learner_free(ts->obj);
+			free(ts->default_action_data);
+		}
 
-		TAILQ_REMOVE(&p->actions, action, node);
-		free(action->instructions);
-		free(action);
+		free(p->learner_state);
+		p->learner_state = NULL;
+	}
+
+	if (p->learner_stats) {
+		for (i = 0; i < p->n_learners; i++)
+			free(p->learner_stats[i].n_pkts_action);
+
+		free(p->learner_stats);
+		p->learner_stats = NULL;
 	}
 }
 
-static uint32_t
-action_arg_src_mov_count(struct action *a,
-			 uint32_t arg_id,
-			 struct instruction *instructions,
-			 struct instruction_data *instruction_data,
-			 uint32_t n_instructions)
+static int
+learner_build(struct rte_swx_pipeline *p)
 {
-	uint32_t offset, n_users = 0, i;
+	struct learner *l;
+	uint32_t i;
+	int status = 0;
 
-	if (!a->st ||
-	    (arg_id >= a->st->n_fields) ||
-	    !instructions ||
-	    !instruction_data ||
-	    !n_instructions)
+	if (!p->n_learners)
 		return 0;
 
-	offset = a->st->fields[arg_id].offset / 8;
+	status = learner_action_check(p);
+	if (status)
+		return status;
 
-	for (i = 0; i < n_instructions; i++) {
-		struct instruction *instr = &instructions[i];
-		struct instruction_data *data = &instruction_data[i];
+	/* Per pipeline: learner tables. */
+	p->learner_state = calloc(p->n_learners,
+				  sizeof(struct rte_swx_table_state));
+	CHECK(p->learner_state, ENOMEM);
 
-		if (data->invalid ||
-		    ((instr->type != INSTR_MOV) && (instr->type != INSTR_MOV_HM)) ||
-		    instr->mov.src.struct_id ||
-		    (instr->mov.src.offset != offset))
-			continue;
+	p->learner_stats = calloc(p->n_learners,
+				  sizeof(struct learner_statistics));
+	CHECK(p->learner_stats, ENOMEM);
 
-		n_users++;
+	TAILQ_FOREACH(l, &p->learners, node) {
+		struct rte_swx_table_state *ts = &p->learner_state[l->id];
+		struct rte_swx_table_learner_params *params;
+
+		/* ts->obj. */
+		params = learner_params_get(l);
+		CHECK(params, ENOMEM);
+
+		ts->obj = rte_swx_table_learner_create(params, p->numa_node);
+		learner_params_free(params);
+		CHECK(ts->obj, ENODEV);
+
+		/* ts->default_action_data. */
+		if (l->action_data_size_max) {
+			ts->default_action_data =
+				malloc(l->action_data_size_max);
+			CHECK(ts->default_action_data, ENOMEM);
+
+			memcpy(ts->default_action_data,
+			       l->default_action_data,
+			       l->action_data_size_max);
+		}
+
+		/* ts->default_action_id. */
+		ts->default_action_id = l->default_action->id;
+
+		/* Statistics. */
+		p->learner_stats[l->id].n_pkts_action =
+			calloc(p->n_actions, sizeof(uint64_t));
+		CHECK(p->learner_stats[l->id].n_pkts_action, ENOMEM);
 	}
 
-	return n_users;
-}
+	/* Per thread: learner table run-time. */
+	for (i = 0; i < RTE_SWX_PIPELINE_THREADS_MAX; i++) {
+		struct thread *t = &p->threads[i];
 
-/*
- * Table.
- */
-static struct table_type *
-table_type_find(struct rte_swx_pipeline *p, const char *name)
-{
-	struct table_type *elem;
+		t->learners = calloc(p->n_learners,
+				     sizeof(struct learner_runtime));
+		CHECK(t->learners, ENOMEM);
 
-	TAILQ_FOREACH(elem, &p->table_types, node)
-		if (strcmp(elem->name, name) == 0)
-			return elem;
+		TAILQ_FOREACH(l, &p->learners, node) {
+			struct learner_runtime *r = &t->learners[l->id];
+			uint64_t size;
 
-	return NULL;
+			/* r->mailbox. */
+			size = rte_swx_table_learner_mailbox_size_get();
+			if (size) {
+				r->mailbox = calloc(1, size);
+				CHECK(r->mailbox, ENOMEM);
+			}
+
+			/* r->key. */
+			r->key = l->header ?
+				&t->structs[l->header->struct_id] :
+				&t->structs[p->metadata_struct_id];
+		}
+	}
+
+	return 0;
 }
 
-static struct table_type *
-table_type_resolve(struct rte_swx_pipeline *p,
-		   const char *recommended_type_name,
-		   enum rte_swx_table_match_type match_type)
+static void
+learner_free(struct rte_swx_pipeline *p)
 {
-	struct table_type *elem;
+	learner_build_free(p);
 
-	/* Only consider the recommended type if the match type is correct. */
-	if (recommended_type_name)
-		TAILQ_FOREACH(elem, &p->table_types, node)
-			if (!strcmp(elem->name, recommended_type_name) &&
-			    (elem->match_type == match_type))
-				return elem;
+	/* Learner tables. */
+	for ( ; ; ) {
+		struct learner *l;
 
-	/* Ignore the recommended type and get the first element with this match
-	 * type.
-	 */
-	TAILQ_FOREACH(elem, &p->table_types, node)
-		if (elem->match_type == match_type)
-			return elem;
+		l = TAILQ_FIRST(&p->learners);
+		if (!l)
+			break;
 
-	return NULL;
+		TAILQ_REMOVE(&p->learners, l, node);
+		free(l->fields);
+		free(l->actions);
+		free(l->default_action_data);
+		free(l);
+	}
 }
 
-static struct table *
-table_find(struct rte_swx_pipeline *p, const char *name)
+/*
+ * Register array.
+ */
+static struct regarray *
+regarray_find(struct rte_swx_pipeline *p, const char *name)
 {
-	struct table *elem;
+	struct regarray *elem;
 
-	TAILQ_FOREACH(elem, &p->tables, node)
-		if (strcmp(elem->name, name) == 0)
+	TAILQ_FOREACH(elem, &p->regarrays, node)
+		if (!strcmp(elem->name, name))
 			return elem;
 
 	return NULL;
 }
 
-static struct table *
-table_find_by_id(struct rte_swx_pipeline *p, uint32_t id)
+static struct regarray *
+regarray_find_by_id(struct rte_swx_pipeline *p, uint32_t id)
 {
-	struct table *table = NULL;
+	struct regarray *elem = NULL;
 
-	TAILQ_FOREACH(table, &p->tables, node)
-		if (table->id == id)
-			return table;
+	TAILQ_FOREACH(elem, &p->regarrays, node)
+		if (elem->id == id)
+			return elem;
 
 	return NULL;
 }
 
 int
-rte_swx_pipeline_table_type_register(struct rte_swx_pipeline *p,
-				     const char *name,
-				     enum rte_swx_table_match_type match_type,
-				     struct rte_swx_table_ops *ops)
+rte_swx_pipeline_regarray_config(struct rte_swx_pipeline *p,
+			      const char *name,
+			      uint32_t size,
+			      uint64_t init_val)
 {
-	struct table_type *elem;
+	struct regarray *r;
 
 	CHECK(p, EINVAL);
 
 	CHECK_NAME(name, EINVAL);
-	CHECK(!table_type_find(p, name), EEXIST);
+	CHECK(!regarray_find(p, name), EEXIST);
 
-	CHECK(ops, EINVAL);
-	CHECK(ops->create, EINVAL);
-	CHECK(ops->lkp, EINVAL);
-	CHECK(ops->free, EINVAL);
+	CHECK(size, EINVAL);
+	size = rte_align32pow2(size);
 
-	/* Node allocation. */
-	elem = calloc(1, sizeof(struct table_type));
-	CHECK(elem, ENOMEM);
+	/* Memory allocation. */
+	r = calloc(1, sizeof(struct regarray));
+	CHECK(r, ENOMEM);
 
 	/* Node initialization. */
-	strcpy(elem->name, name);
-	elem->match_type = match_type;
-	memcpy(&elem->ops, ops, sizeof(*ops));
+	strcpy(r->name, name);
+	r->init_val = init_val;
+	r->size = size;
+	r->id = p->n_regarrays;
 
 	/* Node add to tailq. */
-	TAILQ_INSERT_TAIL(&p->table_types, elem, node);
+	TAILQ_INSERT_TAIL(&p->regarrays, r, node);
+	p->n_regarrays++;
 
 	return 0;
 }
 
-static enum rte_swx_table_match_type
-table_match_type_resolve(struct rte_swx_match_field_params *fields,
-			 uint32_t n_fields,
-			 uint32_t max_offset_field_id)
-{
-	uint32_t n_fields_em = 0, i;
-
-	for (i = 0; i < n_fields; i++)
-		if (fields[i].match_type == RTE_SWX_TABLE_MATCH_EXACT)
-			n_fields_em++;
-
-	if (n_fields_em == n_fields)
-		return RTE_SWX_TABLE_MATCH_EXACT;
-
-	if ((n_fields_em == n_fields - 1) &&
-	    (fields[max_offset_field_id].match_type == RTE_SWX_TABLE_MATCH_LPM))
-		return RTE_SWX_TABLE_MATCH_LPM;
-
-	return RTE_SWX_TABLE_MATCH_WILDCARD;
-}
-
 static int
-table_match_fields_check(struct rte_swx_pipeline *p,
-			 struct rte_swx_pipeline_table_params *params,
-			 struct header **header,
-			 uint32_t *min_offset_field_id,
-			 uint32_t *max_offset_field_id)
+regarray_build(struct rte_swx_pipeline *p)
 {
-	struct header *h0 = NULL;
-	struct field *hf, *mf;
-	uint32_t *offset = NULL, min_offset, max_offset, min_offset_pos, max_offset_pos, i;
-	int status = 0;
-
-	/* Return if no match fields. */
-	if (!params->n_fields) {
-		if (params->fields) {
-			status = -EINVAL;
-			goto end;
-		}
+	struct regarray *regarray;
 
+	if (!p->n_regarrays)
 		return 0;
-	}
-
-	/* Memory allocation. */
-	offset = calloc(params->n_fields, sizeof(uint32_t));
-	if (!offset) {
-		status = -ENOMEM;
-		goto end;
-	}
-
-	/* Check that all the match fields belong to either the same header or
-	 * to the meta-data.
-	 */
-	hf = header_field_parse(p, params->fields[0].name, &h0);
-	mf = metadata_field_parse(p, params->fields[0].name);
-	if (!hf && !mf) {
-		status = -EINVAL;
-		goto end;
-	}
-
-	offset[0] = h0 ? hf->offset : mf->offset;
-
-	for (i = 1; i < params->n_fields; i++)
-		if (h0) {
-			struct header *h;
 
-			hf = header_field_parse(p, params->fields[i].name, &h);
-			if (!hf || (h->id != h0->id)) {
-				status = -EINVAL;
-				goto end;
-			}
+	p->regarray_runtime = calloc(p->n_regarrays, sizeof(struct regarray_runtime));
+	CHECK(p->regarray_runtime, ENOMEM);
 
-			offset[i] = hf->offset;
-		} else {
-			mf = metadata_field_parse(p, params->fields[i].name);
-			if (!mf) {
-				status = -EINVAL;
-				goto end;
-			}
+	TAILQ_FOREACH(regarray, &p->regarrays, node) {
+		struct regarray_runtime *r = &p->regarray_runtime[regarray->id];
+		uint32_t i;
 
-			offset[i] = mf->offset;
-		}
+		r->regarray = env_malloc(regarray->size * sizeof(uint64_t),
+					 RTE_CACHE_LINE_SIZE,
+					 p->numa_node);
+		CHECK(r->regarray, ENOMEM);
 
-	/* Check that there are no duplicated match fields. */
-	for (i = 0; i < params->n_fields; i++) {
-		uint32_t j;
+		if (regarray->init_val)
+			for (i = 0; i < regarray->size; i++)
+				r->regarray[i] = regarray->init_val;
 
-		for (j = 0; j < i; j++)
-			if (offset[j] == offset[i]) {
-				status = -EINVAL;
-				goto end;
-			}
+		r->size_mask = regarray->size - 1;
 	}
 
-	/* Find the min and max offset fields. */
-	min_offset = offset[0];
-	max_offset = offset[0];
-	min_offset_pos = 0;
-	max_offset_pos = 0;
-
-	for (i = 1; i < params->n_fields; i++) {
-		if (offset[i] < min_offset) {
-			min_offset = offset[i];
-			min_offset_pos = i;
-		}
+	return 0;
+}
 
-		if (offset[i] > max_offset) {
-			max_offset = offset[i];
-			max_offset_pos = i;
-		}
-	}
+static void
+regarray_build_free(struct rte_swx_pipeline *p)
+{
+	uint32_t i;
 
-	/* Return. */
-	if (header)
-		*header = h0;
+	if (!p->regarray_runtime)
+		return;
 
-	if (min_offset_field_id)
-		*min_offset_field_id = min_offset_pos;
+	for (i = 0; i < p->n_regarrays; i++) {
+		struct regarray *regarray = regarray_find_by_id(p, i);
+		struct regarray_runtime *r = &p->regarray_runtime[i];
 
-	if (max_offset_field_id)
-		*max_offset_field_id = max_offset_pos;
+		env_free(r->regarray, regarray->size * sizeof(uint64_t));
+	}
 
-end:
-	free(offset);
-	return status;
+	free(p->regarray_runtime);
+	p->regarray_runtime = NULL;
 }
 
-int
-rte_swx_pipeline_table_config(struct rte_swx_pipeline *p,
-			      const char *name,
-			      struct rte_swx_pipeline_table_params *params,
-			      const char *recommended_table_type_name,
-			      const char *args,
-			      uint32_t size)
+static void
+regarray_free(struct rte_swx_pipeline *p)
 {
-	struct table_type *type;
-	struct table *t;
-	struct action *default_action;
-	struct header *header = NULL;
-	uint32_t action_data_size_max = 0, min_offset_field_id = 0, max_offset_field_id = 0, i;
-	int status = 0;
-
-	CHECK(p, EINVAL);
-
-	CHECK_NAME(name, EINVAL);
-	CHECK(!table_find(p, name), EEXIST);
-
-	CHECK(params, EINVAL);
+	regarray_build_free(p);
 
-	/* Match checks. */
-	status = table_match_fields_check(p,
-					  params,
-					  &header,
-					  &min_offset_field_id,
-					  &max_offset_field_id);
-	if (status)
-		return status;
+	for ( ; ; ) {
+		struct regarray *elem;
 
-	/* Action checks. */
-	CHECK(params->n_actions, EINVAL);
-	CHECK(params->action_names, EINVAL);
-	for (i = 0; i < params->n_actions; i++) {
-		const char *action_name = params->action_names[i];
-		struct action *a;
-		uint32_t action_data_size;
+		elem = TAILQ_FIRST(&p->regarrays);
+		if (!elem)
+			break;
 
-		CHECK_NAME(action_name, EINVAL);
+		TAILQ_REMOVE(&p->regarrays, elem, node);
+		free(elem);
+	}
+}
 
-		a = action_find(p, action_name);
-		CHECK(a, EINVAL);
+/*
+ * Meter array.
+ */
+static struct meter_profile *
+meter_profile_find(struct rte_swx_pipeline *p, const char *name)
+{
+	struct meter_profile *elem;
 
-		action_data_size = a->st ? a->st->n_bits / 8 : 0;
-		if (action_data_size > action_data_size_max)
-			action_data_size_max = action_data_size;
-	}
+	TAILQ_FOREACH(elem, &p->meter_profiles, node)
+		if (!strcmp(elem->name, name))
+			return elem;
 
-	CHECK_NAME(params->default_action_name, EINVAL);
-	for (i = 0; i < p->n_actions; i++)
-		if (!strcmp(params->action_names[i],
-			    params->default_action_name))
-			break;
-	CHECK(i < params->n_actions, EINVAL);
-	default_action = action_find(p, params->default_action_name);
-	CHECK((default_action->st && params->default_action_data) ||
-	      !params->default_action_data, EINVAL);
+	return NULL;
+}
 
-	/* Table type checks. */
-	if (recommended_table_type_name)
-		CHECK_NAME(recommended_table_type_name, EINVAL);
+static struct metarray *
+metarray_find(struct rte_swx_pipeline *p, const char *name)
+{
+	struct metarray *elem;
 
-	if (params->n_fields) {
-		enum rte_swx_table_match_type match_type;
+	TAILQ_FOREACH(elem, &p->metarrays, node)
+		if (!strcmp(elem->name, name))
+			return elem;
 
-		match_type = table_match_type_resolve(params->fields,
-						      params->n_fields,
-						      max_offset_field_id);
-		type = table_type_resolve(p,
-					  recommended_table_type_name,
-					  match_type);
-		CHECK(type, EINVAL);
-	} else {
-		type = NULL;
-	}
+	return NULL;
+}
 
-	/* Memory allocation. */
-	t = calloc(1, sizeof(struct table));
-	CHECK(t, ENOMEM);
+static struct metarray *
+metarray_find_by_id(struct rte_swx_pipeline *p, uint32_t id)
+{
+	struct metarray *elem = NULL;
 
-	t->fields = calloc(params->n_fields, sizeof(struct match_field));
-	if (!t->fields) {
-		free(t);
-		CHECK(0, ENOMEM);
-	}
+	TAILQ_FOREACH(elem, &p->metarrays, node)
+		if (elem->id == id)
+			return elem;
 
-	t->actions = calloc(params->n_actions, sizeof(struct action *));
-	if (!t->actions) {
-		free(t->fields);
-		free(t);
-		CHECK(0, ENOMEM);
-	}
+	return NULL;
+}
 
-	if (action_data_size_max) {
-		t->default_action_data = calloc(1, action_data_size_max);
-		if (!t->default_action_data) {
-			free(t->actions);
-			free(t->fields);
-			free(t);
-			CHECK(0, ENOMEM);
-		}
-	}
+int
+rte_swx_pipeline_metarray_config(struct rte_swx_pipeline *p,
+				 const char *name,
+				 uint32_t size)
+{
+	struct metarray *m;
 
-	/* Node initialization. */
-	strcpy(t->name, name);
-	if (args && args[0])
-		strcpy(t->args, args);
-	t->type = type;
+	CHECK(p, EINVAL);
 
-	for (i = 0; i < params->n_fields; i++) {
-		struct rte_swx_match_field_params *field = &params->fields[i];
-		struct match_field *f = &t->fields[i];
+	CHECK_NAME(name, EINVAL);
+	CHECK(!metarray_find(p, name), EEXIST);
 
-		f->match_type = field->match_type;
-		f->field = header ?
-			header_field_parse(p, field->name, NULL) :
-			metadata_field_parse(p, field->name);
-	}
-	t->n_fields = params->n_fields;
-	t->header = header;
+	CHECK(size, EINVAL);
+	size = rte_align32pow2(size);
 
-	for (i = 0; i < params->n_actions; i++)
-		t->actions[i] = action_find(p, params->action_names[i]);
-	t->default_action = default_action;
-	if (default_action->st)
-		memcpy(t->default_action_data,
-		       params->default_action_data,
-		       default_action->st->n_bits / 8);
-	t->n_actions = params->n_actions;
-	t->default_action_is_const = params->default_action_is_const;
-	t->action_data_size_max = action_data_size_max;
+	/* Memory allocation. */
+	m = calloc(1, sizeof(struct metarray));
+	CHECK(m, ENOMEM);
 
-	t->size = size;
-	t->id = p->n_tables;
+	/* Node initialization. */
+	strcpy(m->name, name);
+	m->size = size;
+	m->id = p->n_metarrays;
 
 	/* Node add to tailq. */
-	TAILQ_INSERT_TAIL(&p->tables, t, node);
-	p->n_tables++;
+	TAILQ_INSERT_TAIL(&p->metarrays, m, node);
+	p->n_metarrays++;
 
 	return 0;
 }
 
-static struct rte_swx_table_params *
-table_params_get(struct table *table)
-{
-	struct rte_swx_table_params *params;
-	struct field *first, *last;
-	uint8_t *key_mask;
-	uint32_t key_size, key_offset, action_data_size, i;
+struct meter_profile meter_profile_default = {
+	.node = {0},
+	.name = "",
+	.params = {0},
 
-	/* Memory allocation. */
-	params = calloc(1, sizeof(struct rte_swx_table_params));
-	if (!params)
-		return NULL;
+	.profile = {
+		.cbs = 10000,
+		.pbs = 10000,
+		.cir_period = 1,
+		.cir_bytes_per_period = 1,
+		.pir_period = 1,
+		.pir_bytes_per_period = 1,
+	},
 
-	/* Find first (smallest offset) and last (biggest offset) match fields. */
-	first = table->fields[0].field;
-	last = table->fields[0].field;
+	.n_users = 0,
+};
 
-	for (i = 0; i < table->n_fields; i++) {
-		struct field *f = table->fields[i].field;
+static void
+meter_init(struct meter *m)
+{
+	memset(m, 0, sizeof(struct meter));
+	rte_meter_trtcm_config(&m->m, &meter_profile_default.profile);
+	m->profile = &meter_profile_default;
+	m->color_mask = RTE_COLOR_GREEN;
 
-		if (f->offset < first->offset)
-			first = f;
+	meter_profile_default.n_users++;
+}
 
-		if (f->offset > last->offset)
-			last = f;
-	}
+static int
+metarray_build(struct rte_swx_pipeline *p)
+{
+	struct metarray *m;
 
-	/* Key offset and size. */
-	key_offset = first->offset / 8;
-	key_size = (last->offset + last->n_bits - first->offset) / 8;
+	if (!p->n_metarrays)
+		return 0;
 
-	/* Memory allocation. */
-	key_mask = calloc(1, key_size);
-	if (!key_mask) {
-		free(params);
-		return NULL;
-	}
+	p->metarray_runtime = calloc(p->n_metarrays, sizeof(struct metarray_runtime));
+	CHECK(p->metarray_runtime, ENOMEM);
 
-	/* Key mask. */
-	for (i = 0; i < table->n_fields; i++) {
-		struct field *f = table->fields[i].field;
-		uint32_t start = (f->offset - first->offset) / 8;
-		size_t size = f->n_bits / 8;
+	TAILQ_FOREACH(m, &p->metarrays, node) {
+		struct metarray_runtime *r = &p->metarray_runtime[m->id];
+		uint32_t i;
 
-		memset(&key_mask[start], 0xFF, size);
-	}
+		r->metarray = env_malloc(m->size * sizeof(struct meter),
+					 RTE_CACHE_LINE_SIZE,
+					 p->numa_node);
+		CHECK(r->metarray, ENOMEM);
 
-	/* Action data size. */
-	action_data_size = 0;
-	for (i = 0; i < table->n_actions; i++) {
-		struct action *action = table->actions[i];
-		uint32_t ads = action->st ? action->st->n_bits / 8 : 0;
+		for (i = 0; i < m->size; i++)
+			meter_init(&r->metarray[i]);
 
-		if (ads > action_data_size)
-			action_data_size = ads;
+		r->size_mask = m->size - 1;
 	}
 
-	/* Fill in. */
-	params->match_type = table->type->match_type;
-	params->key_size = key_size;
-	params->key_offset = key_offset;
-	params->key_mask0 = key_mask;
-	params->action_data_size = action_data_size;
-	params->n_keys_max = table->size;
-
-	return params;
+	return 0;
 }
 
 static void
-table_params_free(struct rte_swx_table_params *params)
+metarray_build_free(struct rte_swx_pipeline *p)
 {
-	if (!params)
+	uint32_t i;
+
+	if (!p->metarray_runtime)
 		return;
 
-	free(params->key_mask0);
-	free(params);
+	for (i = 0; i < p->n_metarrays; i++) {
+		struct metarray *m = metarray_find_by_id(p, i);
+		struct metarray_runtime *r = &p->metarray_runtime[i];
+
+		env_free(r->metarray, m->size * sizeof(struct meter));
+	}
+
+	free(p->metarray_runtime);
+	p->metarray_runtime = NULL;
 }
 
-static int
-table_state_build(struct rte_swx_pipeline *p)
+static void
+metarray_free(struct rte_swx_pipeline *p)
 {
-	struct table *table;
+	metarray_build_free(p);
 
-	p->table_state = calloc(p->n_tables,
-				sizeof(struct rte_swx_table_state));
-	CHECK(p->table_state, ENOMEM);
+	/* Meter arrays. */
+	for ( ; ; ) {
+		struct metarray *elem;
 
-	TAILQ_FOREACH(table, &p->tables, node) {
-		struct rte_swx_table_state *ts = &p->table_state[table->id];
+		elem = TAILQ_FIRST(&p->metarrays);
+		if (!elem)
+			break;
 
-		if (table->type) {
-			struct rte_swx_table_params *params;
+		TAILQ_REMOVE(&p->metarrays, elem, node);
+		free(elem);
+	}
 
-			/* ts->obj. */
-			params = table_params_get(table);
-			CHECK(params, ENOMEM);
+	/* Meter profiles. */
+	for ( ; ; ) {
+		struct meter_profile *elem;
 
-			ts->obj = table->type->ops.create(params,
-				NULL,
-				table->args,
-				p->numa_node);
+		elem = TAILQ_FIRST(&p->meter_profiles);
+		if (!elem)
+			break;
+
+		TAILQ_REMOVE(&p->meter_profiles, elem, node);
+		free(elem);
+	}
+}
+
+/*
+ * Code generation.
+ */
+#ifndef RTE_SWX_PIPELINE_CODEGEN_MACHINE_ARGS
+#define RTE_SWX_PIPELINE_CODEGEN_MACHINE_ARGS ""
+#endif
+
+#ifndef RTE_SWX_PIPELINE_CODEGEN_CC
+#define RTE_SWX_PIPELINE_CODEGEN_CC \
+	"cc -O3 " RTE_SWX_PIPELINE_CODEGEN_MACHINE_ARGS \
+	" -fPIC -shared $(pkg-config --cflags libdpdk)"
+#endif
 
-			table_params_free(params);
-			CHECK(ts->obj, ENODEV);
-		}
+enum codegen_kind {
+	CODEGEN_NONE = 0, /* Interpreted only. */
+	CODEGEN_EXEC, /* void __instr_<type>_exec(p, t, ip). */
+	CODEGEN_EXTERN, /* uint32_t __instr_<type>_exec(p, t, ip), 1 = done. */
+	CODEGEN_JMP, /* uint32_t __instr_<type>_exec(p, t, ip), 1 = taken. */
+	CODEGEN_RETURN,
+};
 
-		/* ts->default_action_data. */
-		if (table->action_data_size_max) {
-			ts->default_action_data =
-				malloc(table->action_data_size_max);
-			CHECK(ts->default_action_data, ENOMEM);
+/* Operands that hold an immediate value instead of a struct field. */
+#define CODEGEN_IMM_SRC (1 << 0)
+#define CODEGEN_IMM_IDX (1 << 1)
+#define CODEGEN_IMM_COLOR_IN (1 << 2)
 
-			memcpy(ts->default_action_data,
-			       table->default_action_data,
-			       table->action_data_size_max);
-		}
+typedef void
+(*codegen_print_t)(FILE *f, struct instruction *instr, uint32_t imm);
 
-		/* ts->default_action_id. */
-		ts->default_action_id = table->default_action->id;
-	}
+struct codegen_info {
+	const char *name;
+	codegen_print_t print;
+	enum codegen_kind kind;
+	uint32_t imm;
+};
 
-	return 0;
+static void
+codegen_operand_print(FILE *f, const char *name, struct instr_operand *op)
+{
+	fprintf(f,
+		"\t\t\t.%s = {.struct_id = %u, .n_bits = %u, .offset = %u},\n",
+		name,
+		(uint32_t)op->struct_id,
+		(uint32_t)op->n_bits,
+		(uint32_t)op->offset);
 }
 
 static void
-table_state_build_free(struct rte_swx_pipeline *p)
+codegen_array_print(FILE *f, const char *indent, const char *name, uint8_t *a)
 {
 	uint32_t i;
 
-	if (!p->table_state)
-		return;
-
-	for (i = 0; i < p->n_tables; i++) {
-		struct rte_swx_table_state *ts = &p->table_state[i];
-		struct table *table = table_find_by_id(p, i);
+	fprintf(f, "%s.%s = {", indent, name);
+	for (i = 0; i < 8; i++)
+		fprintf(f, "%s%u", i ? ", " : "", (uint32_t)a[i]);
+	fprintf(f, "},\n");
+}
 
-		/* ts->obj. */
-		if (table->type && ts->obj)
-			table->type->ops.free(ts->obj);
+static void
+codegen_io_print(FILE *f, struct instruction *instr, uint32_t imm __rte_unused)
+{
+	fprintf(f, "\t\t.io = {\n");
+	fprintf(f, "\t\t\t.io = {.val = %u},\n", instr->io.io.val);
+	fprintf(f, "\t\t\t.hdr = {\n");
+	codegen_array_print(f, "\t\t\t\t", "header_id", instr->io.hdr.header_id);
+	codegen_array_print(f, "\t\t\t\t", "struct_id", instr->io.hdr.struct_id);
+	codegen_array_print(f, "\t\t\t\t", "n_bytes", instr->io.hdr.n_bytes);
+	fprintf(f, "\t\t\t},\n");
+	fprintf(f, "\t\t},\n");
+}
 
-		/* ts->default_action_data. */
-		free(ts->default_action_data);
-	}
+static void
+codegen_valid_print(FILE *f,
+		    struct instruction *instr,
+		    uint32_t imm __rte_unused)
+{
+	fprintf(f, "\t\t.valid = {.header_id = %u},\n",
+		(uint32_t)instr->valid.header_id);
+}
 
-	free(p->table_state);
-	p->table_state = NULL;
+static void
+codegen_dst_src_print(FILE *f,
+		      const char *name,
+		      struct instr_dst_src *op,
+		      uint32_t imm)
+{
+	fprintf(f, "\t\t.%s = {\n", name);
+	codegen_operand_print(f, "dst", &op->dst);
+	if (imm & CODEGEN_IMM_SRC)
+		fprintf(f, "\t\t\t.src_val = 0x%" PRIx64 ",\n", op->src_val);
+	else
+		codegen_operand_print(f, "src", &op->src);
+	fprintf(f, "\t\t},\n");
 }
 
 static void
-table_state_free(struct rte_swx_pipeline *p)
+codegen_mov_print(FILE *f, struct instruction *instr, uint32_t imm)
 {
-	table_state_build_free(p);
+	codegen_dst_src_print(f, "mov", &instr->mov, imm);
 }
 
-static int
-table_stub_lkp(void *table __rte_unused,
-	       void *mailbox __rte_unused,
-	       uint8_t **key __rte_unused,
-	       uint64_t *action_id __rte_unused,
-	       uint8_t **action_data __rte_unused,
-	       int *hit)
+static void
+codegen_alu_print(FILE *f, struct instruction *instr, uint32_t imm)
 {
-	*hit = 0;
-	return 1; /* DONE. */
+	codegen_dst_src_print(f, "alu", &instr->alu, imm);
 }
 
-static int
-table_build(struct rte_swx_pipeline *p)
+static void
+codegen_dma_print(FILE *f, struct instruction *instr, uint32_t imm __rte_unused)
 {
 	uint32_t i;
 
-	/* Per pipeline: table statistics. */
-	p->table_stats = calloc(p->n_tables, sizeof(struct table_statistics));
-	CHECK(p->table_stats, ENOMEM);
-
-	for (i = 0; i < p->n_tables; i++) {
-		p->table_stats[i].n_pkts_action = calloc(p->n_actions, sizeof(uint64_t));
-		CHECK(p->table_stats[i].n_pkts_action, ENOMEM);
-	}
-
-	/* Per thread: table runt-time. */
-	for (i = 0; i < RTE_SWX_PIPELINE_THREADS_MAX; i++) {
-		struct thread *t = &p->threads[i];
-		struct table *table;
-
-		t->tables = calloc(p->n_tables, sizeof(struct table_runtime));
-		CHECK(t->tables, ENOMEM);
-
-		TAILQ_FOREACH(table, &p->tables, node) {
-			struct table_runtime *r = &t->tables[table->id];
-
-			if (table->type) {
-				uint64_t size;
+	fprintf(f, "\t\t.dma = {\n");
+	codegen_array_print(f, "\t\t\t", "dst.header_id", instr->dma.dst.header_id);
+	codegen_array_print(f, "\t\t\t", "dst.struct_id", instr->dma.dst.struct_id);
+	codegen_array_print(f, "\t\t\t", "src.offset", instr->dma.src.offset);
+	fprintf(f, "\t\t\t.n_bytes = {");
+	for (i = 0; i < 8; i++)
+		fprintf(f, "%s%u", i ? ", " : "", (uint32_t)instr->dma.n_bytes[i]);
+	fprintf(f, "},\n");
+	fprintf(f, "\t\t},\n");
+}
 
-				size = table->type->ops.mailbox_size_get();
+static void
+codegen_regarray_print(FILE *f, struct instruction *instr, uint32_t imm)
+{
+	fprintf(f, "\t\t.regarray = {\n");
+	fprintf(f, "\t\t\t.regarray_id = %u,\n",
+		(uint32_t)instr->regarray.regarray_id);
+	if (imm & CODEGEN_IMM_IDX)
+		fprintf(f, "\t\t\t.idx_val = %u,\n", instr->regarray.idx_val);
+	else
+		codegen_operand_print(f, "idx", &instr->regarray.idx);
+	if (imm & CODEGEN_IMM_SRC)
+		fprintf(f, "\t\t\t.dstsrc_val = 0x%" PRIx64 ",\n",
+			instr->regarray.dstsrc_val);
+	else
+		codegen_operand_print(f, "dstsrc", &instr->regarray.dstsrc);
+	fprintf(f, "\t\t},\n");
+}
 
-				/* r->func. */
-				r->func = table->type->ops.lkp;
+static void
+codegen_meter_print(FILE *f, struct instruction *instr, uint32_t imm)
+{
+	fprintf(f, "\t\t.meter = {\n");
+	fprintf(f, "\t\t\t.metarray_id = %u,\n",
+		(uint32_t)instr->meter.metarray_id);
+	if (imm & CODEGEN_IMM_IDX)
+		fprintf(f, "\t\t\t.idx_val = %u,\n", instr->meter.idx_val);
+	else
+		codegen_operand_print(f, "idx", &instr->meter.idx);
+	codegen_operand_print(f, "length", &instr->meter.length);
+	if (imm & CODEGEN_IMM_COLOR_IN)
+		fprintf(f, "\t\t\t.color_in_val = %u,\n",
+			instr->meter.color_in_val);
+	else
+		codegen_operand_print(f, "color_in", &instr->meter.color_in);
+	codegen_operand_print(f, "color_out", &instr->meter.color_out);
+	fprintf(f, "\t\t},\n");
+}
 
-				/* r->mailbox. */
-				if (size) {
-					r->mailbox = calloc(1, size);
-					CHECK(r->mailbox, ENOMEM);
-				}
+static void
+codegen_table_print(FILE *f,
+		    struct instruction *instr,
+		    uint32_t imm __rte_unused)
+{
+	fprintf(f, "\t\t.table = {.table_id = %u},\n",
+		(uint32_t)instr->table.table_id);
+}
 
-				/* r->key. */
-				r->key = table->header ?
-					&t->structs[table->header->struct_id] :
-					&t->structs[p->metadata_struct_id];
-			} else {
-				r->func = table_stub_lkp;
-			}
-		}
-	}
+static void
+codegen_learn_print(FILE *f,
+		    struct instruction *instr,
+		    uint32_t imm __rte_unused)
+{
+	fprintf(f, "\t\t.learn = {.action_id = %u, .mf_offset = %u},\n",
+		(uint32_t)instr->learn.action_id,
+		instr->learn.mf_offset);
+}
 
-	return 0;
+static void
+codegen_ext_obj_print(FILE *f,
+		      struct instruction *instr,
+		      uint32_t imm __rte_unused)
+{
+	fprintf(f, "\t\t.ext_obj = {.ext_obj_id = %u, .func_id = %u},\n",
+		(uint32_t)instr->ext_obj.ext_obj_id,
+		(uint32_t)instr->ext_obj.func_id);
 }
 
 static void
-table_build_free(struct rte_swx_pipeline *p)
+codegen_ext_func_print(FILE *f,
+		       struct instruction *instr,
+		       uint32_t imm __rte_unused)
 {
-	uint32_t i;
+	fprintf(f, "\t\t.ext_func = {.ext_func_id = %u},\n",
+		(uint32_t)instr->ext_func.ext_func_id);
+}
 
-	for (i = 0; i < RTE_SWX_PIPELINE_THREADS_MAX; i++) {
-		struct thread *t = &p->threads[i];
-		uint32_t j;
+static void
+codegen_jmp_print(FILE *f, struct instruction *instr, uint32_t imm)
+{
+	/* The jump target is resolved by the generated code itself. */
+	fprintf(f, "\t\t.jmp = {\n");
 
-		if (!t->tables)
-			continue;
+	switch (instr->type) {
+	case INSTR_JMP:
+	case INSTR_JMP_HIT:
+	case INSTR_JMP_MISS:
+		break;
 
-		for (j = 0; j < p->n_tables; j++) {
-			struct table_runtime *r = &t->tables[j];
+	case INSTR_JMP_VALID:
+	case INSTR_JMP_INVALID:
+		fprintf(f, "\t\t\t.header_id = %u,\n",
+			(uint32_t)instr->jmp.header_id);
+		break;
 
-			free(r->mailbox);
-		}
+	case INSTR_JMP_ACTION_HIT:
+	case INSTR_JMP_ACTION_MISS:
+		fprintf(f, "\t\t\t.action_id = %u,\n",
+			(uint32_t)instr->jmp.action_id);
+		break;
 
-		free(t->tables);
-		t->tables = NULL;
-	}
+	default:
+		codegen_operand_print(f, "a", &instr->jmp.a);
+		if (imm & CODEGEN_IMM_SRC)
+			fprintf(f, "\t\t\t.b_val = 0x%" PRIx64 ",\n",
+				instr->jmp.b_val);
+		else
+			codegen_operand_print(f, "b", &instr->jmp.b);
+	}
+
+	fprintf(f, "\t\t},\n");
+}
+
+#define CODEGEN_INSTR(type, print, kind, imm) [type] = {#type, print, kind, imm}
+
+static const struct codegen_info codegen_info[] = {
+	CODEGEN_INSTR(INSTR_RX, codegen_io_print, CODEGEN_NONE, 0),
+	CODEGEN_INSTR(INSTR_TX, codegen_io_print, CODEGEN_NONE, 0),
+	CODEGEN_INSTR(INSTR_TX_I, codegen_io_print, CODEGEN_NONE, 0),
+
+	CODEGEN_INSTR(INSTR_HDR_EXTRACT, codegen_io_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_HDR_EXTRACT2, codegen_io_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_HDR_EXTRACT3, codegen_io_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_HDR_EXTRACT4, codegen_io_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_HDR_EXTRACT5, codegen_io_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_HDR_EXTRACT6, codegen_io_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_HDR_EXTRACT7, codegen_io_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_HDR_EXTRACT8, codegen_io_print, CODEGEN_EXEC, 0),
+
+	CODEGEN_INSTR(INSTR_HDR_EMIT, codegen_io_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_HDR_EMIT_TX, codegen_io_print, CODEGEN_NONE, 0),
+	CODEGEN_INSTR(INSTR_HDR_EMIT2_TX, codegen_io_print, CODEGEN_NONE, 0),
+	CODEGEN_INSTR(INSTR_HDR_EMIT3_TX, codegen_io_print, CODEGEN_NONE, 0),
+	CODEGEN_INSTR(INSTR_HDR_EMIT4_TX, codegen_io_print, CODEGEN_NONE, 0),
+	CODEGEN_INSTR(INSTR_HDR_EMIT5_TX, codegen_io_print, CODEGEN_NONE, 0),
+	CODEGEN_INSTR(INSTR_HDR_EMIT6_TX, codegen_io_print, CODEGEN_NONE, 0),
+	CODEGEN_INSTR(INSTR_HDR_EMIT7_TX, codegen_io_print, CODEGEN_NONE, 0),
+	CODEGEN_INSTR(INSTR_HDR_EMIT8_TX, codegen_io_print, CODEGEN_NONE, 0),
+
+	CODEGEN_INSTR(INSTR_HDR_VALIDATE, codegen_valid_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_HDR_INVALIDATE, codegen_valid_print, CODEGEN_EXEC, 0),
+
+	CODEGEN_INSTR(INSTR_MOV, codegen_mov_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_MOV_MH, codegen_mov_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_MOV_HM, codegen_mov_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_MOV_HH, codegen_mov_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_MOV_I, codegen_mov_print, CODEGEN_EXEC, CODEGEN_IMM_SRC),
+
+	CODEGEN_INSTR(INSTR_DMA_HT, codegen_dma_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_DMA_HT2, codegen_dma_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_DMA_HT3, codegen_dma_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_DMA_HT4, codegen_dma_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_DMA_HT5, codegen_dma_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_DMA_HT6, codegen_dma_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_DMA_HT7, codegen_dma_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_DMA_HT8, codegen_dma_print, CODEGEN_EXEC, 0),
+
+	CODEGEN_INSTR(INSTR_ALU_ADD, codegen_alu_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_ALU_ADD_MH, codegen_alu_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_ALU_ADD_HM, codegen_alu_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_ALU_ADD_HH, codegen_alu_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_ALU_ADD_MI, codegen_alu_print, CODEGEN_EXEC, CODEGEN_IMM_SRC),
+	CODEGEN_INSTR(INSTR_ALU_ADD_HI, codegen_alu_print, CODEGEN_EXEC, CODEGEN_IMM_SRC),
+
+	CODEGEN_INSTR(INSTR_ALU_SUB, codegen_alu_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_ALU_SUB_MH, codegen_alu_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_ALU_SUB_HM, codegen_alu_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_ALU_SUB_HH, codegen_alu_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_ALU_SUB_MI, codegen_alu_print, CODEGEN_EXEC, CODEGEN_IMM_SRC),
+	CODEGEN_INSTR(INSTR_ALU_SUB_HI, codegen_alu_print, CODEGEN_EXEC, CODEGEN_IMM_SRC),
+
+	CODEGEN_INSTR(INSTR_ALU_CKADD_FIELD, codegen_alu_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_ALU_CKADD_STRUCT, codegen_alu_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_ALU_CKADD_STRUCT20, codegen_alu_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_ALU_CKSUB_FIELD, codegen_alu_print, CODEGEN_EXEC, 0),
+
+	CODEGEN_INSTR(INSTR_ALU_AND, codegen_alu_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_ALU_AND_MH, codegen_alu_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_ALU_AND_HM, codegen_alu_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_ALU_AND_HH, codegen_alu_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_ALU_AND_I, codegen_alu_print, CODEGEN_EXEC, CODEGEN_IMM_SRC),
+
+	CODEGEN_INSTR(INSTR_ALU_OR, codegen_alu_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_ALU_OR_MH, codegen_alu_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_ALU_OR_HM, codegen_alu_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_ALU_OR_HH, codegen_alu_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_ALU_OR_I, codegen_alu_print, CODEGEN_EXEC, CODEGEN_IMM_SRC),
+
+	CODEGEN_INSTR(INSTR_ALU_XOR, codegen_alu_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_ALU_XOR_MH, codegen_alu_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_ALU_XOR_HM, codegen_alu_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_ALU_XOR_HH, codegen_alu_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_ALU_XOR_I, codegen_alu_print, CODEGEN_EXEC, CODEGEN_IMM_SRC),
+
+	CODEGEN_INSTR(INSTR_ALU_SHL, codegen_alu_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_ALU_SHL_MH, codegen_alu_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_ALU_SHL_HM, codegen_alu_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_ALU_SHL_HH, codegen_alu_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_ALU_SHL_MI, codegen_alu_print, CODEGEN_EXEC, CODEGEN_IMM_SRC),
+	CODEGEN_INSTR(INSTR_ALU_SHL_HI, codegen_alu_print, CODEGEN_EXEC, CODEGEN_IMM_SRC),
+
+	CODEGEN_INSTR(INSTR_ALU_SHR, codegen_alu_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_ALU_SHR_MH, codegen_alu_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_ALU_SHR_HM, codegen_alu_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_ALU_SHR_HH, codegen_alu_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_ALU_SHR_MI, codegen_alu_print, CODEGEN_EXEC, CODEGEN_IMM_SRC),
+	CODEGEN_INSTR(INSTR_ALU_SHR_HI, codegen_alu_print, CODEGEN_EXEC, CODEGEN_IMM_SRC),
+
+	CODEGEN_INSTR(INSTR_REGPREFETCH_RH, codegen_regarray_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_REGPREFETCH_RM, codegen_regarray_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_REGPREFETCH_RI, codegen_regarray_print, CODEGEN_EXEC, CODEGEN_IMM_IDX),
+
+	CODEGEN_INSTR(INSTR_REGRD_HRH, codegen_regarray_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_REGRD_HRM, codegen_regarray_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_REGRD_MRH, codegen_regarray_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_REGRD_MRM, codegen_regarray_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_REGRD_HRI, codegen_regarray_print, CODEGEN_EXEC, CODEGEN_IMM_IDX),
+	CODEGEN_INSTR(INSTR_REGRD_MRI, codegen_regarray_print, CODEGEN_EXEC, CODEGEN_IMM_IDX),
+
+	CODEGEN_INSTR(INSTR_REGWR_RHH, codegen_regarray_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_REGWR_RHM, codegen_regarray_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_REGWR_RMH, codegen_regarray_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_REGWR_RMM, codegen_regarray_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_REGWR_RHI, codegen_regarray_print, CODEGEN_EXEC, CODEGEN_IMM_SRC),
+	CODEGEN_INSTR(INSTR_REGWR_RMI, codegen_regarray_print, CODEGEN_EXEC, CODEGEN_IMM_SRC),
+	CODEGEN_INSTR(INSTR_REGWR_RIH, codegen_regarray_print, CODEGEN_EXEC, CODEGEN_IMM_IDX),
+	CODEGEN_INSTR(INSTR_REGWR_RIM, codegen_regarray_print, CODEGEN_EXEC, CODEGEN_IMM_IDX),
+	CODEGEN_INSTR(INSTR_REGWR_RII, codegen_regarray_print, CODEGEN_EXEC,
+		      CODEGEN_IMM_IDX | CODEGEN_IMM_SRC),
+
+	CODEGEN_INSTR(INSTR_REGADD_RHH, codegen_regarray_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_REGADD_RHM, codegen_regarray_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_REGADD_RMH, codegen_regarray_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_REGADD_RMM, codegen_regarray_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_REGADD_RHI, codegen_regarray_print, CODEGEN_EXEC, CODEGEN_IMM_SRC),
+	CODEGEN_INSTR(INSTR_REGADD_RMI, codegen_regarray_print, CODEGEN_EXEC, CODEGEN_IMM_SRC),
+	CODEGEN_INSTR(INSTR_REGADD_RIH, codegen_regarray_print, CODEGEN_EXEC, CODEGEN_IMM_IDX),
+	CODEGEN_INSTR(INSTR_REGADD_RIM, codegen_regarray_print, CODEGEN_EXEC, CODEGEN_IMM_IDX),
+	CODEGEN_INSTR(INSTR_REGADD_RII, codegen_regarray_print, CODEGEN_EXEC,
+		      CODEGEN_IMM_IDX | CODEGEN_IMM_SRC),
+
+	CODEGEN_INSTR(INSTR_METPREFETCH_H, codegen_meter_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_METPREFETCH_M, codegen_meter_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_METPREFETCH_I, codegen_meter_print, CODEGEN_EXEC, CODEGEN_IMM_IDX),
+
+	CODEGEN_INSTR(INSTR_METER_HHM, codegen_meter_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_METER_HHI, codegen_meter_print, CODEGEN_EXEC, CODEGEN_IMM_COLOR_IN),
+	CODEGEN_INSTR(INSTR_METER_HMM, codegen_meter_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_METER_HMI, codegen_meter_print, CODEGEN_EXEC, CODEGEN_IMM_COLOR_IN),
+	CODEGEN_INSTR(INSTR_METER_MHM, codegen_meter_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_METER_MHI, codegen_meter_print, CODEGEN_EXEC, CODEGEN_IMM_COLOR_IN),
+	CODEGEN_INSTR(INSTR_METER_MMM, codegen_meter_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_METER_MMI, codegen_meter_print, CODEGEN_EXEC, CODEGEN_IMM_COLOR_IN),
+	CODEGEN_INSTR(INSTR_METER_IHM, codegen_meter_print, CODEGEN_EXEC, CODEGEN_IMM_IDX),
+	CODEGEN_INSTR(INSTR_METER_IHI, codegen_meter_print, CODEGEN_EXEC,
+		      CODEGEN_IMM_IDX | CODEGEN_IMM_COLOR_IN),
+	CODEGEN_INSTR(INSTR_METER_IMM, codegen_meter_print, CODEGEN_EXEC, CODEGEN_IMM_IDX),
+	CODEGEN_INSTR(INSTR_METER_IMI, codegen_meter_print, CODEGEN_EXEC,
+		      CODEGEN_IMM_IDX | CODEGEN_IMM_COLOR_IN),
+
+	CODEGEN_INSTR(INSTR_TABLE, codegen_table_print, CODEGEN_NONE, 0),
+	CODEGEN_INSTR(INSTR_LEARNER, codegen_table_print, CODEGEN_NONE, 0),
+	CODEGEN_INSTR(INSTR_LEARNER_LEARN, codegen_learn_print, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_LEARNER_FORGET, NULL, CODEGEN_EXEC, 0),
+	CODEGEN_INSTR(INSTR_EXTERN_OBJ, codegen_ext_obj_print, CODEGEN_EXTERN, 0),
+	CODEGEN_INSTR(INSTR_EXTERN_FUNC, codegen_ext_func_print, CODEGEN_EXTERN, 0),
+
+	CODEGEN_INSTR(INSTR_JMP, codegen_jmp_print, CODEGEN_JMP, 0),
+	CODEGEN_INSTR(INSTR_JMP_VALID, codegen_jmp_print, CODEGEN_JMP, 0),
+	CODEGEN_INSTR(INSTR_JMP_INVALID, codegen_jmp_print, CODEGEN_JMP, 0),
+	CODEGEN_INSTR(INSTR_JMP_HIT, codegen_jmp_print, CODEGEN_JMP, 0),
+	CODEGEN_INSTR(INSTR_JMP_MISS, codegen_jmp_print, CODEGEN_JMP, 0),
+	CODEGEN_INSTR(INSTR_JMP_ACTION_HIT, codegen_jmp_print, CODEGEN_JMP, 0),
+	CODEGEN_INSTR(INSTR_JMP_ACTION_MISS, codegen_jmp_print, CODEGEN_JMP, 0),
+
+	CODEGEN_INSTR(INSTR_JMP_EQ, codegen_jmp_print, CODEGEN_JMP, 0),
+	CODEGEN_INSTR(INSTR_JMP_EQ_MH, codegen_jmp_print, CODEGEN_JMP, 0),
+	CODEGEN_INSTR(INSTR_JMP_EQ_HM, codegen_jmp_print, CODEGEN_JMP, 0),
+	CODEGEN_INSTR(INSTR_JMP_EQ_HH, codegen_jmp_print, CODEGEN_JMP, 0),
+	CODEGEN_INSTR(INSTR_JMP_EQ_I, codegen_jmp_print, CODEGEN_JMP, CODEGEN_IMM_SRC),
+
+	CODEGEN_INSTR(INSTR_JMP_NEQ, codegen_jmp_print, CODEGEN_JMP, 0),
+	CODEGEN_INSTR(INSTR_JMP_NEQ_MH, codegen_jmp_print, CODEGEN_JMP, 0),
+	CODEGEN_INSTR(INSTR_JMP_NEQ_HM, codegen_jmp_print, CODEGEN_JMP, 0),
+	CODEGEN_INSTR(INSTR_JMP_NEQ_HH, codegen_jmp_print, CODEGEN_JMP, 0),
+	CODEGEN_INSTR(INSTR_JMP_NEQ_I, codegen_jmp_print, CODEGEN_JMP, CODEGEN_IMM_SRC),
+
+	CODEGEN_INSTR(INSTR_JMP_LT, codegen_jmp_print, CODEGEN_JMP, 0),
+	CODEGEN_INSTR(INSTR_JMP_LT_MH, codegen_jmp_print, CODEGEN_JMP, 0),
+	CODEGEN_INSTR(INSTR_JMP_LT_HM, codegen_jmp_print, CODEGEN_JMP, 0),
+	CODEGEN_INSTR(INSTR_JMP_LT_HH, codegen_jmp_print, CODEGEN_JMP, 0),
+	CODEGEN_INSTR(INSTR_JMP_LT_MI, codegen_jmp_print, CODEGEN_JMP, CODEGEN_IMM_SRC),
+	CODEGEN_INSTR(INSTR_JMP_LT_HI, codegen_jmp_print, CODEGEN_JMP, CODEGEN_IMM_SRC),
+
+	CODEGEN_INSTR(INSTR_JMP_GT, codegen_jmp_print, CODEGEN_JMP, 0),
+	CODEGEN_INSTR(INSTR_JMP_GT_MH, codegen_jmp_print, CODEGEN_JMP, 0),
+	CODEGEN_INSTR(INSTR_JMP_GT_HM, codegen_jmp_print, CODEGEN_JMP, 0),
+	CODEGEN_INSTR(INSTR_JMP_GT_HH, codegen_jmp_print, CODEGEN_JMP, 0),
+	CODEGEN_INSTR(INSTR_JMP_GT_MI, codegen_jmp_print, CODEGEN_JMP, CODEGEN_IMM_SRC),
+	CODEGEN_INSTR(INSTR_JMP_GT_HI, codegen_jmp_print, CODEGEN_JMP, CODEGEN_IMM_SRC),
+
+	CODEGEN_INSTR(INSTR_RETURN, NULL, CODEGEN_RETURN, 0),
+	CODEGEN_INSTR(INSTR_BLOCK, NULL, CODEGEN_NONE, 0),
+};
 
-	if (p->table_stats) {
-		for (i = 0; i < p->n_tables; i++)
-			free(p->table_stats[i].n_pkts_action);
+#undef CODEGEN_INSTR
 
-		free(p->table_stats);
-	}
+static enum codegen_kind
+codegen_kind(struct instruction *instr)
+{
+	return codegen_info[instr->type].kind;
 }
 
 static void
-table_free(struct rte_swx_pipeline *p)
+codegen_func_print(FILE *f, struct instruction *instr)
 {
-	table_build_free(p);
+	const char *name = codegen_info[instr->type].name + strlen("INSTR_");
 
-	/* Tables. */
-	for ( ; ; ) {
-		struct table *elem;
-
-		elem = TAILQ_FIRST(&p->tables);
-		if (!elem)
-			break;
+	fprintf(f, "__instr_");
+	for ( ; *name; name++)
+		fputc(tolower(*name), f);
+	fprintf(f, "_exec");
+}
 
-		TAILQ_REMOVE(&p->tables, elem, node);
-		free(elem->fields);
-		free(elem->actions);
-		free(elem->default_action_data);
-		free(elem);
-	}
+static void
+codegen_instructions_print(FILE *f,
+			   const char *name,
+			   struct instruction *instructions,
+			   uint32_t n_instructions)
+{
+	uint32_t i;
 
-	/* Table types. */
-	for ( ; ; ) {
-		struct table_type *elem;
+	fprintf(f, "static const struct instruction %s[] = {\n", name);
 
-		elem = TAILQ_FIRST(&p->table_types);
-		if (!elem)
-			break;
+	for (i = 0; i < n_instructions; i++) {
+		struct instruction *instr = &instructions[i];
+		const struct codegen_info *info = &codegen_info[instr->type];
 
-		TAILQ_REMOVE(&p->table_types, elem, node);
-		free(elem);
+		fprintf(f, "\t[%u] = {\n", i);
+		fprintf(f, "\t\t.type = %s,\n", info->name);
+		if (info->print)
+			info->print(f, instr, info->imm);
+		fprintf(f, "\t},\n");
 	}
+
+	fprintf(f, "};\n\n");
 }
 
-/*
- * Register array.
- */
-static struct regarray *
-regarray_find(struct rte_swx_pipeline *p, const char *name)
+/* Only CODEGEN_EXEC and CODEGEN_EXTERN instructions. */
+static void
+codegen_instr_call_print(FILE *f,
+			 const char *name,
+			 struct instruction *instructions,
+			 uint32_t pos)
 {
-	struct regarray *elem;
+	struct instruction *instr = &instructions[pos];
 
-	TAILQ_FOREACH(elem, &p->regarrays, node)
-		if (!strcmp(elem->name, name))
-			return elem;
+	if (codegen_kind(instr) == CODEGEN_EXTERN) {
+		fprintf(f, "\twhile (!");
+		codegen_func_print(f, instr);
+		fprintf(f, "(p, t, &%s[%u]))\n\t\t;\n", name, pos);
+		return;
+	}
 
-	return NULL;
+	fprintf(f, "\t");
+	codegen_func_print(f, instr);
+	fprintf(f, "(p, t, &%s[%u]);\n", name, pos);
 }
 
-static struct regarray *
-regarray_find_by_id(struct rte_swx_pipeline *p, uint32_t id)
+static int
+codegen_action_supported(struct action *a)
 {
-	struct regarray *elem = NULL;
+	uint32_t i;
 
-	TAILQ_FOREACH(elem, &p->regarrays, node)
-		if (elem->id == id)
-			return elem;
+	for (i = 0; i < a->n_instructions; i++)
+		if (codegen_kind(&a->instructions[i]) == CODEGEN_NONE)
+			return 0;
 
-	return NULL;
+	return 1;
 }
 
-int
-rte_swx_pipeline_regarray_config(struct rte_swx_pipeline *p,
-			      const char *name,
-			      uint32_t size,
-			      uint64_t init_val)
+/* Actions run to completion: jumps become gotos, extern calls are retried
+ * in place until done and return gives control back to the table instruction.
+ */
+static void
+codegen_action_print(FILE *f, struct action *a)
 {
-	struct regarray *r;
-
-	CHECK(p, EINVAL);
+	char name[RTE_SWX_NAME_SIZE];
+	uint8_t *targets;
+	uint32_t i;
 
-	CHECK_NAME(name, EINVAL);
-	CHECK(!regarray_find(p, name), EEXIST);
+	targets = calloc(a->n_instructions, sizeof(uint8_t));
+	if (!targets)
+		return;
 
-	CHECK(size, EINVAL);
-	size = rte_align32pow2(size);
+	for (i = 0; i < a->n_instructions; i++) {
+		struct instruction *instr = &a->instructions[i];
 
-	/* Memory allocation. */
-	r = calloc(1, sizeof(struct regarray));
-	CHECK(r, ENOMEM);
+		if (instruction_is_jmp(instr))
+			targets[instr->jmp.ip - a->instructions] = 1;
+	}
 
-	/* Node initialization. */
-	strcpy(r->name, name);
-	r->init_val = init_val;
-	r->size = size;
-	r->id = p->n_regarrays;
+	fprintf(f, "void\naction_%u_run(struct rte_swx_pipeline *p);\n\n",
+		a->id);
 
-	/* Node add to tailq. */
-	TAILQ_INSERT_TAIL(&p->regarrays, r, node);
-	p->n_regarrays++;
+	/* Action with no instructions other than return. */
+	if (codegen_kind(&a->instructions[0]) == CODEGEN_RETURN) {
+		fprintf(f, "void\naction_%u_run(struct rte_swx_pipeline *p)\n",
+			a->id);
+		fprintf(f, "{\n\tRTE_SET_USED(p);\n}\n\n");
+		free(targets);
+		return;
+	}
 
-	return 0;
-}
+	snprintf(name, sizeof(name), "action_%u_instructions", a->id);
+	codegen_instructions_print(f, name, a->instructions,
+				   a->n_instructions);
 
-static int
-regarray_build(struct rte_swx_pipeline *p)
-{
-	struct regarray *regarray;
+	fprintf(f, "void\naction_%u_run(struct rte_swx_pipeline *p)\n{\n",
+		a->id);
+	fprintf(f, "\tstruct thread *t = &p->threads[p->thread_id];\n\n");
 
-	if (!p->n_regarrays)
-		return 0;
+	for (i = 0; i < a->n_instructions; i++) {
+		struct instruction *instr = &a->instructions[i];
 
-	p->regarray_runtime = calloc(p->n_regarrays, sizeof(struct regarray_runtime));
-	CHECK(p->regarray_runtime, ENOMEM);
+		if (targets[i])
+			fprintf(f, "instr_%u:\n", i);
 
-	TAILQ_FOREACH(regarray, &p->regarrays, node) {
-		struct regarray_runtime *r = &p->regarray_runtime[regarray->id];
-		uint32_t i;
+		switch (codegen_kind(instr)) {
+		case CODEGEN_JMP:
+			if (instr->type == INSTR_JMP) {
+				fprintf(f, "\tgoto instr_%u;\n",
+					(uint32_t)(instr->jmp.ip - a->instructions));
+				break;
+			}
 
-		r->regarray = env_malloc(regarray->size * sizeof(uint64_t),
-					 RTE_CACHE_LINE_SIZE,
-					 p->numa_node);
-		CHECK(r->regarray, ENOMEM);
+			fprintf(f, "\tif (");
+			codegen_func_print(f, instr);
+			fprintf(f, "(p, t, &%s[%u]))\n\t\tgoto instr_%u;\n",
+				name,
+				i,
+				(uint32_t)(instr->jmp.ip - a->instructions));
+			break;
 
-		if (regarray->init_val)
-			for (i = 0; i < regarray->size; i++)
-				r->regarray[i] = regarray->init_val;
+		case CODEGEN_RETURN:
+			fprintf(f, "\treturn;\n");
+			break;
 
-		r->size_mask = regarray->size - 1;
+		default:
+			codegen_instr_call_print(f, name, a->instructions, i);
+		}
 	}
 
-	return 0;
+	fprintf(f, "}\n\n");
+	free(targets);
 }
 
+/* The main instruction sequence is split into blocks of instructions that
+ * neither yield nor send the packet out. A block can only be entered through
+ * its first instruction and it ends after its first jump, if any. Each block
+ * is turned into a function that sets the thread instruction pointer to where
+ * the interpreter has to continue from.
+ */
 static void
-regarray_build_free(struct rte_swx_pipeline *p)
+codegen_blocks_find(struct rte_swx_pipeline *p,
+		    uint8_t *targets,
+		    uint32_t *block_end)
 {
 	uint32_t i;
 
-	if (!p->regarray_runtime)
-		return;
-
-	for (i = 0; i < p->n_regarrays; i++) {
-		struct regarray *regarray = regarray_find_by_id(p, i);
-		struct regarray_runtime *r = &p->regarray_runtime[i];
+	for (i = 0; i < p->n_instructions; i++) {
+		struct instruction *instr = &p->instructions[i];
 
-		env_free(r->regarray, regarray->size * sizeof(uint64_t));
+		if (instruction_is_jmp(instr))
+			targets[instr->jmp.ip - p->instructions] = 1;
 	}
 
-	free(p->regarray_runtime);
-	p->regarray_runtime = NULL;
-}
+	for (i = 0; i < p->n_instructions; ) {
+		uint32_t j;
 
-static void
-regarray_free(struct rte_swx_pipeline *p)
-{
-	regarray_build_free(p);
+		for (j = i; j < p->n_instructions; j++) {
+			struct instruction *instr = &p->instructions[j];
+			enum codegen_kind kind = codegen_kind(instr);
 
-	for ( ; ; ) {
-		struct regarray *elem;
+			if ((kind != CODEGEN_EXEC) && (kind != CODEGEN_JMP))
+				break;
 
-		elem = TAILQ_FIRST(&p->regarrays);
-		if (!elem)
-			break;
+			if ((j > i) && targets[j])
+				break;
 
-		TAILQ_REMOVE(&p->regarrays, elem, node);
-		free(elem);
+			if (kind == CODEGEN_JMP) {
+				j++;
+				break;
+			}
+		}
+
+		/* Fusing a single instruction brings nothing. */
+		if (j - i > 1)
+			block_end[i] = j;
+
+		i = (j > i) ? j : i + 1;
 	}
 }
 
-/*
- * Meter array.
- */
-static struct meter_profile *
-meter_profile_find(struct rte_swx_pipeline *p, const char *name)
+static void
+codegen_block_print(FILE *f,
+		    struct rte_swx_pipeline *p,
+		    uint32_t start,
+		    uint32_t end)
 {
-	struct meter_profile *elem;
+	struct instruction *last = &p->instructions[end - 1];
+	uint32_t i;
 
-	TAILQ_FOREACH(elem, &p->meter_profiles, node)
-		if (!strcmp(elem->name, name))
-			return elem;
+	fprintf(f, "void\npipeline_block_%u_run(struct rte_swx_pipeline *p);\n\n",
+		start);
+	fprintf(f, "void\npipeline_block_%u_run(struct rte_swx_pipeline *p)\n{\n",
+		start);
+	fprintf(f, "\tstruct thread *t = &p->threads[p->thread_id];\n\n");
+
+	for (i = start; i < end - 1; i++)
+		codegen_instr_call_print(f, "pipeline_instructions",
+					 p->instructions, i);
+
+	if (codegen_kind(last) != CODEGEN_JMP) {
+		codegen_instr_call_print(f, "pipeline_instructions",
+					 p->instructions, end - 1);
+		fprintf(f, "\n\tthread_ip_set(t, &p->instructions[%u]);\n}\n\n",
+			end);
+		return;
+	}
 
-	return NULL;
+	if (last->type == INSTR_JMP) {
+		fprintf(f, "\n\tthread_ip_set(t, &p->instructions[%u]);\n}\n\n",
+			(uint32_t)(last->jmp.ip - p->instructions));
+		return;
+	}
+
+	fprintf(f, "\n\tif (");
+	codegen_func_print(f, last);
+	fprintf(f, "(p, t, &pipeline_instructions[%u])) {\n", end - 1);
+	fprintf(f, "\t\tthread_ip_set(t, &p->instructions[%u]);\n",
+		(uint32_t)(last->jmp.ip - p->instructions));
+	fprintf(f, "\t\treturn;\n\t}\n\n");
+	fprintf(f, "\tthread_ip_set(t, &p->instructions[%u]);\n}\n\n", end);
 }
 
-static struct metarray *
-metarray_find(struct rte_swx_pipeline *p, const char *name)
+static int
+codegen_source_write(struct rte_swx_pipeline *p,
+		     int fd,
+		     uint32_t *block_end)
 {
-	struct metarray *elem;
+	struct action *a;
+	FILE *f;
+	uint32_t i;
 
-	TAILQ_FOREACH(elem, &p->metarrays, node)
-		if (!strcmp(elem->name, name))
-			return elem;
+	f = fdopen(fd, "w");
+	if (!f) {
+		close(fd);
+		return -EIO;
+	}
 
-	return NULL;
-}
+	fprintf(f, "/* Generated by rte_swx_pipeline_build(), do not edit. */\n");
+	fprintf(f, "#include <rte_swx_pipeline_internal.h>\n\n");
 
-static struct metarray *
-metarray_find_by_id(struct rte_swx_pipeline *p, uint32_t id)
-{
-	struct metarray *elem = NULL;
+	TAILQ_FOREACH(a, &p->actions, node)
+		if (codegen_action_supported(a))
+			codegen_action_print(f, a);
 
-	TAILQ_FOREACH(elem, &p->metarrays, node)
-		if (elem->id == id)
-			return elem;
+	codegen_instructions_print(f, "pipeline_instructions",
+				   p->instructions, p->n_instructions);
 
-	return NULL;
+	for (i = 0; i < p->n_instructions; i++)
+		if (block_end[i])
+			codegen_block_print(f, p, i, block_end[i]);
+
+	if (ferror(f)) {
+		fclose(f);
+		return -EIO;
+	}
+
+	fclose(f);
+	return 0;
 }
 
-int
-rte_swx_pipeline_metarray_config(struct rte_swx_pipeline *p,
-				 const char *name,
-				 uint32_t size)
+/*
+ * Run "<cc> -o <obj_path> <src_path>". The compiler command is run by the
+ * shell, while the paths are passed as positional parameters, so that they
+ * are never expanded.
+ */
+static int
+codegen_compile(const char *cc, const char *obj_path, const char *src_path)
 {
-	struct metarray *m;
+	char *cmd;
+	size_t len;
+	pid_t pid;
+	int wstatus, ret;
 
-	CHECK(p, EINVAL);
-
-	CHECK_NAME(name, EINVAL);
-	CHECK(!metarray_find(p, name), EEXIST);
+	len = strlen(cc) + sizeof(" -o \"$1\" \"$2\"");
+	cmd = malloc(len);
+	if (!cmd)
+		return -ENOMEM;
 
-	CHECK(size, EINVAL);
-	size = rte_align32pow2(size);
+	ret = snprintf(cmd, len, "%s -o \"$1\" \"$2\"", cc);
+	if (ret < 0 || (size_t)ret >= len) {
+		free(cmd);
+		return -ENAMETOOLONG;
+	}
 
-	/* Memory allocation. */
-	m = calloc(1, sizeof(struct metarray));
-	CHECK(m, ENOMEM);
+	pid = fork();
+	if (pid == 0) {
+		execl("/bin/sh", "sh", "-c", cmd, "sh", obj_path, src_path,
+		      (char *)NULL);
+		_exit(127);
+	}
+	free(cmd);
+	if (pid < 0)
+		return -errno;
 
-	/* Node initialization. */
-	strcpy(m->name, name);
-	m->size = size;
-	m->id = p->n_metarrays;
+	while (waitpid(pid, &wstatus, 0) < 0)
+		if (errno != EINTR)
+			return -ECHILD;
 
-	/* Node add to tailq. */
-	TAILQ_INSERT_TAIL(&p->metarrays, m, node);
-	p->n_metarrays++;
+	if (!WIFEXITED(wstatus) || WEXITSTATUS(wstatus))
+		return -ENOEXEC;
 
 	return 0;
 }
 
-struct meter_profile meter_profile_default = {
-	.node = {0},
-	.name = "",
-	.params = {0},
+static int
+codegen_build(struct rte_swx_pipeline *p)
+{
+	char src_path[PATH_MAX], obj_path[PATH_MAX], sym[RTE_SWX_NAME_SIZE];
+	instr_exec_t *action_funcs = NULL, *block_funcs = NULL;
+	uint32_t *block_end = NULL;
+	uint8_t *targets = NULL;
+	struct action *a;
+	void *lib = NULL;
+	uint32_t i;
+	int src_fd = -1, obj_fd = -1;
+	int status = 0, ret;
 
-	.profile = {
-		.cbs = 10000,
-		.pbs = 10000,
-		.cir_period = 1,
-		.cir_bytes_per_period = 1,
-		.pir_period = 1,
-		.pir_bytes_per_period = 1,
-	},
+	if (!p->codegen_dir)
+		return 0;
 
-	.n_users = 0,
-};
+	/* Temporary files, with unique names. */
+	ret = snprintf(src_path, sizeof(src_path),
+		       "%s/rte_swx_pipeline_XXXXXX.c", p->codegen_dir);
+	if (ret < 0 || (size_t)ret >= sizeof(src_path))
+		return -ENAMETOOLONG;
 
-static void
-meter_init(struct meter *m)
-{
-	memset(m, 0, sizeof(struct meter));
-	rte_meter_trtcm_config(&m->m, &meter_profile_default.profile);
-	m->profile = &meter_profile_default;
-	m->color_mask = RTE_COLOR_GREEN;
+	ret = snprintf(obj_path, sizeof(obj_path),
+		       "%s/rte_swx_pipeline_XXXXXX.so", p->codegen_dir);
+	if (ret < 0 || (size_t)ret >= sizeof(obj_path))
+		return -ENAMETOOLONG;
 
-	meter_profile_default.n_users++;
-}
+	src_fd = mkstemps(src_path, strlen(".c"));
+	if (src_fd < 0) {
+		src_path[0] = '\0';
+		status = -errno;
+		goto free;
+	}
 
-static int
-metarray_build(struct rte_swx_pipeline *p)
-{
-	struct metarray *m;
+	obj_fd = mkstemps(obj_path, strlen(".so"));
+	if (obj_fd < 0) {
+		obj_path[0] = '\0';
+		status = -errno;
+		goto free;
+	}
+	close(obj_fd);
 
-	if (!p->n_metarrays)
-		return 0;
+	/* Memory allocation. */
+	targets = calloc(p->n_instructions, sizeof(uint8_t));
+	block_end = calloc(p->n_instructions, sizeof(uint32_t));
+	block_funcs = calloc(p->n_instructions, sizeof(instr_exec_t));
+	action_funcs = calloc(p->n_actions, sizeof(instr_exec_t));
+	if (!targets || !block_end || !block_funcs || !action_funcs) {
+		status = -ENOMEM;
+		goto free;
+	}
 
-	p->metarray_runtime = calloc(p->n_metarrays, sizeof(struct metarray_runtime));
-	CHECK(p->metarray_runtime, ENOMEM);
+	/* Code generation. */
+	codegen_blocks_find(p, targets, block_end);
 
-	TAILQ_FOREACH(m, &p->metarrays, node) {
-		struct metarray_runtime *r = &p->metarray_runtime[m->id];
-		uint32_t i;
+	status = codegen_source_write(p, src_fd, block_end);
+	src_fd = -1;
+	if (status)
+		goto free;
 
-		r->metarray = env_malloc(m->size * sizeof(struct meter),
-					 RTE_CACHE_LINE_SIZE,
-					 p->numa_node);
-		CHECK(r->metarray, ENOMEM);
+	/* Compilation. */
+	status = codegen_compile(p->codegen_cc, obj_path, src_path);
+	if (status)
+		goto free;
 
-		for (i = 0; i < m->size; i++)
-			meter_init(&r->metarray[i]);
+	/* Loading. */
+	lib = dlopen(obj_path, RTLD_NOW | RTLD_LOCAL);
+	if (!lib) {
+		status = -ENOEXEC;
+		goto free;
+	}
 
-		r->size_mask = m->size - 1;
+	TAILQ_FOREACH(a, &p->actions, node) {
+		if (!codegen_action_supported(a))
+			continue;
+
+		snprintf(sym, sizeof(sym), "action_%u_run", a->id);
+		action_funcs[a->id] = (instr_exec_t)dlsym(lib, sym);
+		if (!action_funcs[a->id]) {
+			status = -ENOEXEC;
+			goto free;
+		}
 	}
 
-	return 0;
+	for (i = 0; i < p->n_instructions; i++) {
+		if (!block_end[i])
+			continue;
+
+		snprintf(sym, sizeof(sym), "pipeline_block_%u_run", i);
+		block_funcs[i] = (instr_exec_t)dlsym(lib, sym);
+		if (!block_funcs[i]) {
+			status = -ENOEXEC;
+			goto free;
+		}
+	}
+
+	/* Switch to the generated code. */
+	for (i = 0; i < p->n_actions; i++)
+		p->action_funcs[i] = action_funcs[i];
+
+	for (i = 0; i < p->n_instructions; i++) {
+		struct instruction *instr = &p->instructions[i];
+
+		if (!block_funcs[i])
+			continue;
+
+		instr->type = INSTR_BLOCK;
+		instr->block.func = block_funcs[i];
+	}
+
+	p->codegen_lib = lib;
+	lib = NULL;
+
+free:
+	if (lib)
+		dlclose(lib);
+	if (src_fd >= 0)
+		close(src_fd);
+	if (obj_path[0])
+		remove(obj_path);
+	if (src_path[0])
+		remove(src_path);
+	free(action_funcs);
+	free(block_funcs);
+	free(block_end);
+	free(targets);
+	return status;
 }
 
 static void
-metarray_build_free(struct rte_swx_pipeline *p)
+codegen_build_free(struct rte_swx_pipeline *p)
 {
 	uint32_t i;
 
-	if (!p->metarray_runtime)
+	if (!p->codegen_lib)
 		return;
 
-	for (i = 0; i < p->n_metarrays; i++) {
-		struct metarray *m = metarray_find_by_id(p, i);
-		struct metarray_runtime *r = &p->metarray_runtime[i];
-
-		env_free(r->metarray, m->size * sizeof(struct meter));
-	}
+	for (i = 0; i < p->n_actions; i++)
+		p->action_funcs[i] = NULL;
 
-	free(p->metarray_runtime);
-	p->metarray_runtime = NULL;
+	dlclose(p->codegen_lib);
+	p->codegen_lib = NULL;
 }
 
 static void
-metarray_free(struct rte_swx_pipeline *p)
+codegen_free(struct rte_swx_pipeline *p)
 {
-	metarray_build_free(p);
+	codegen_build_free(p);
 
-	/* Meter arrays. */
-	for ( ; ; ) {
-		struct metarray *elem;
+	free(p->codegen_cc);
+	p->codegen_cc = NULL;
 
-		elem = TAILQ_FIRST(&p->metarrays);
-		if (!elem)
-			break;
+	free(p->codegen_dir);
+	p->codegen_dir = NULL;
+}
 
-		TAILQ_REMOVE(&p->metarrays, elem, node);
-		free(elem);
+int
+rte_swx_pipeline_codegen_config(struct rte_swx_pipeline *p,
+				struct rte_swx_pipeline_codegen_params *params)
+{
+	char *dir, *cc;
+
+	CHECK(p, EINVAL);
+	CHECK(p->build_done == 0, EEXIST);
+	CHECK(params, EINVAL);
+	CHECK(params->dir && params->dir[0], EINVAL);
+
+	dir = strdup(params->dir);
+	cc = strdup(params->cc ? params->cc : RTE_SWX_PIPELINE_CODEGEN_CC);
+	if (!dir || !cc) {
+		free(dir);
+		free(cc);
+		return -ENOMEM;
 	}
 
-	/* Meter profiles. */
-	for ( ; ; ) {
-		struct meter_profile *elem;
+	codegen_free(p);
+	p->codegen_dir = dir;
+	p->codegen_cc = cc;
 
-		elem = TAILQ_FIRST(&p->meter_profiles);
-		if (!elem)
-			break;
+	return 0;
+}
 
-		TAILQ_REMOVE(&p->meter_profiles, elem, node);
-		free(elem);
-	}
+/*
+ * Burst.
+ */
+int
+rte_swx_pipeline_burst_config(struct rte_swx_pipeline *p, uint32_t burst_size)
+{
+	CHECK(p, EINVAL);
+	CHECK(p->build_done == 0, EEXIST);
+	CHECK(burst_size <= RTE_SWX_PIPELINE_THREADS_MAX, EINVAL);
+
+	p->burst_size = burst_size;
+
+	return 0;
 }
 
 /*
@@ -9988,6 +9203,7 @@ rte_swx_pipeline_config(struct rte_swx_pipeline **p, int numa_node)
 	TAILQ_INIT(&pipeline->actions);
 	TAILQ_INIT(&pipeline->table_types);
 	TAILQ_INIT(&pipeline->tables);
+	TAILQ_INIT(&pipeline->learners);
 	TAILQ_INIT(&pipeline->regarrays);
 	TAILQ_INIT(&pipeline->meter_profiles);
 	TAILQ_INIT(&pipeline->metarrays);
@@ -10005,10 +9221,12 @@ rte_swx_pipeline_free(struct rte_swx_pipeline *p)
 	if (!p)
 		return;
 
+	codegen_free(p);
 	free(p->instructions);
 
 	metarray_free(p);
 	regarray_free(p);
+	learner_free(p);
 	table_state_free(p);
 	table_free(p);
 	action_free(p);
@@ -10093,6 +9311,10 @@ rte_swx_pipeline_build(struct rte_swx_pipeline *p)
 	if (status)
 		goto error;
 
+	status = learner_build(p);
+	if (status)
+		goto error;
+
 	status = regarray_build(p);
 	if (status)
 		goto error;
@@ -10101,12 +9323,18 @@ rte_swx_pipeline_build(struct rte_swx_pipeline *p)
 	if (status)
 		goto error;
 
+	status = codegen_build(p);
+	if (status)
+		goto error;
+
 	p->build_done = 1;
 	return 0;
 
 error:
+	codegen_build_free(p);
 	metarray_build_free(p);
 	regarray_build_free(p);
+	learner_build_free(p);
 	table_state_build_free(p);
 	table_build_free(p);
 	action_build_free(p);
@@ -10167,6 +9395,7 @@ rte_swx_ctl_pipeline_info_get(struct rte_swx_pipeline *p,
 	pipeline->n_ports_out = p->n_ports_out;
 	pipeline->n_actions = n_actions;
 	pipeline->n_tables = n_tables;
+	pipeline->n_learners = p->n_learners;
 	pipeline->n_regarrays = p->n_regarrays;
 	pipeline->n_metarrays = p->n_metarrays;
 
@@ -10405,6 +9634,60 @@ rte_swx_ctl_pipeline_table_stats_read(struct rte_swx_pipeline *p,
 	return 0;
 }
 
+int
+rte_swx_ctl_learner_info_get(struct rte_swx_pipeline *p,
+			     uint32_t learner_id,
+			     struct rte_swx_ctl_learner_info *learner)
+{
+	struct learner *l;
+
+	if (!p || !learner)
+		return -EINVAL;
+
+	l = learner_find_by_id(p, learner_id);
+	if (!l)
+		return -EINVAL;
+
+	strcpy(learner->name, l->name);
+	learner->n_match_fields = l->n_fields;
+	learner->n_actions = l->n_actions;
+	learner->size = l->size;
+	learner->timeout = l->timeout;
+	return 0;
+}
+
+int
+rte_swx_ctl_pipeline_learner_stats_read(struct rte_swx_pipeline *p,
+				      const char *learner_name,
+				      struct rte_swx_learner_stats *stats)
+{
+	struct learner *l;
+	struct learner_statistics *learner_stats;
+
+	if (!p || !learner_name || !learner_name[0] || !stats || !stats->n_pkts_action)
+		return -EINVAL;
+
+	l = learner_find(p, learner_name);
+	if (!l)
+		return -EINVAL;
+
+	learner_stats = &p->learner_stats[l->id];
+
+	memcpy(stats->n_pkts_action,
+	       learner_stats->n_pkts_action,
+	       p->n_actions * sizeof(uint64_t));
+
+	stats->n_pkts_hit = learner_stats->n_pkts_hit[1];
+	stats->n_pkts_miss = learner_stats->n_pkts_hit[0];
+
+	stats->n_pkts_learn_ok = learner_stats->n_pkts_learn[0];
+	stats->n_pkts_learn_err = learner_stats->n_pkts_learn[1];
+
+	stats->n_pkts_forget = learner_stats->n_pkts_forget;
+
+	return 0;
+}
+
 int
 rte_swx_ctl_regarray_info_get(struct rte_swx_pipeline *p,
 			      uint32_t regarray_id,
@@ -612,6 +612,80 @@ rte_swx_pipeline_table_config(struct rte_swx_pipeline *p,
 			      const char *args,
 			      uint32_t size);
 
+/** Pipeline learner table parameters. */
+struct rte_swx_pipeline_learner_params {
+	/** The set of match fields for the current learner table.
+	 * Restriction: All the match fields of the current learner table need
+	 * to be part of the same struct, i.e. either all the match fields are
+	 * part of the same header or all the match fields are part of the
+	 * meta-data. The match type is always exact match.
+	 */
+	const char **field_names;
+
+	/** The number of match fields for the current learner table. Must be
+	 * at least one.
+	 */
+	uint32_t n_fields;
+
+	/** The set of actions for the current learner table. */
+	const char **action_names;
+
+	/** The number of actions for the current learner table. Must be at
+	 * least one.
+	 */
+	uint32_t n_actions;
+
+	/** The default learner table action that gets executed on lookup miss.
+	 * Must be one of the learner table actions included in the
+	 * *action_names*.
+	 */
+	const char *default_action_name;
+
+	/** Default action data. The size of this array is the action data size
+	 * of the default action. Must be NULL if the default action data size
+	 * is zero.
+	 */
+	uint8_t *default_action_data;
+};
+
+/**
+ * Pipeline learner table configure
+ *
+ * The entries of a learner table are added by the data path through the
+ * *learn* instruction and deleted either by the data path through the *forget*
+ * instruction or automatically once they are not hit by any packet for
+ * *timeout* seconds. These instructions can only be used by the actions of the
+ * learner tables, where they apply to the key that was looked up in the learner
+ * table that triggered the action. The "learn ACTION [m.field]" instruction
+ * adds this key with one of the learner table actions, whose arguments are read
+ * from the meta-data starting at *m.field*, while the "forget" instruction
+ * deletes this key.
+ *
+ * @param[out] p
+ *   Pipeline handle.
+ * @param[in] name
+ *   Learner table name.
+ * @param[in] params
+ *   Learner table parameters.
+ * @param[in] size
+ *   The maximum number of learner table entries. Must be non-zero.
+ * @param[in] timeout
+ *   Learner table entry timeout in seconds. Must be non-zero.
+ * @return
+ *   0 on success or the following error codes otherwise:
+ *   -EINVAL: Invalid argument;
+ *   -ENOMEM: Not enough space/cannot allocate memory;
+ *   -EEXIST: Learner table or regular table with this name already exists;
+ *   -ENODEV: Learner table creation error.
+ */
+__rte_experimental
+int
+rte_swx_pipeline_learner_config(struct rte_swx_pipeline *p,
+			      const char *name,
+			      struct rte_swx_pipeline_learner_params *params,
+			      uint32_t size,
+			      uint32_t timeout);
+
 /**
  * Pipeline register array configure
  *
@@ -678,6 +752,81 @@ rte_swx_pipeline_instructions_config(struct rte_swx_pipeline *p,
 				     const char **instructions,
 				     uint32_t n_instructions);
 
+/** Pipeline code generation parameters. */
+struct rte_swx_pipeline_codegen_params {
+	/** Directory where the C source file and the shared object are
+	 * temporarily created. Mandatory.
+	 */
+	const char *dir;
+
+	/** Command used to compile the C source file into a shared object, which
+	 * is invoked as "<cc> -o <shared object> <C source file>". It has to use
+	 * the same DPDK headers and configuration as the pipeline library. The
+	 * command is run by the shell, the paths are passed quoted. When NULL,
+	 * the default "cc -O3 <machine flags> -fPIC -shared
+	 * $(pkg-config --cflags libdpdk)" is used, with the machine flags DPDK
+	 * was built with.
+	 */
+	const char *cc;
+};
+
+/**
+ * Pipeline code generation configure
+ *
+ * Once enabled, the pipeline build operation translates the actions and the
+ * pipeline instructions to C code, compiles it into a shared object and loads
+ * it, so that the pipeline runs native code instead of interpreting the
+ * instructions one by one:
+ *   - Each action is turned into a function, unless it sends the packet out.
+ *     Extern calls within actions are retried in place until done;
+ *   - Each block of consecutive pipeline instructions that does not contain any
+ *     rx, tx, table lookup or extern call is turned into a function, with at
+ *     most one jump at its end.
+ * The operands of every instruction (header, field and struct IDs, offsets,
+ * sizes, immediate values) become compile time constants.
+ *
+ * @param[in] p
+ *   Pipeline handle.
+ * @param[in] params
+ *   Code generation parameters.
+ * @return
+ *   0 on success or the following error codes otherwise:
+ *   -EINVAL: Invalid argument;
+ *   -ENOMEM: Not enough space/cannot allocate memory;
+ *   -EEXIST: Pipeline was already built successfully.
+ */
+__rte_experimental
+int
+rte_swx_pipeline_codegen_config(struct rte_swx_pipeline *p,
+				struct rte_swx_pipeline_codegen_params *params);
+
+/**
+ * Pipeline burst configure
+ *
+ * The packets in flight within the pipeline are processed by different threads.
+ * Once enabled, the table lookups that different threads issue into the same
+ * table are not executed one by one, but put on hold until either *burst_size*
+ * of them are collected or the first thread of the burst is scheduled again,
+ * at which point they are completed with a single bulk lookup operation. This
+ * amortizes the lookup overhead and overlaps the memory accesses of the
+ * different lookups of the burst. Only the tables whose table type provides
+ * the bulk lookup operation are affected.
+ *
+ * @param[in] p
+ *   Pipeline handle.
+ * @param[in] burst_size
+ *   Maximum number of table lookups per burst. Must not exceed the number of
+ *   pipeline threads, which is 16 by default. The value of 0 or 1 disables the
+ *   bulk lookups, which is the default.
+ * @return
+ *   0 on success or the following error codes otherwise:
+ *   -EINVAL: Invalid argument;
+ *   -EEXIST: Pipeline was already built successfully.
+ */
+__rte_experimental
+int
+rte_swx_pipeline_burst_config(struct rte_swx_pipeline *p, uint32_t burst_size);
+
 /**
  * Pipeline build
  *
@@ -691,7 +840,10 @@ rte_swx_pipeline_instructions_config(struct rte_swx_pipeline *p,
  *   0 on success or the following error codes otherwise:
  *   -EINVAL: Invalid argument;
  *   -ENOMEM: Not enough space/cannot allocate memory;
- *   -EEXIST: Pipeline was already built successfully.
+ *   -EEXIST: Pipeline was already built successfully;
+ *   -EIO: Cannot write the generated C code (code generation enabled only);
+ *   -ENOEXEC: Cannot compile or load the generated code (code generation
+ *   enabled only).
  */
 __rte_experimental
 int
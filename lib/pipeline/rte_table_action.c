@@ -2372,9 +2372,13 @@ action_data_offset_set(struct ap_data *ap_data,
 	ap_data->total_size = offset;
 }
 
+static rte_pipeline_table_action_handler_hit
+ah_selector(struct ap_config *cfg);
+
 struct rte_table_action_profile {
 	struct ap_config cfg;
 	struct ap_data data;
+	rte_pipeline_table_action_handler_hit ah;
 	int frozen;
 };
 
@@ -2470,6 +2474,7 @@ rte_table_action_profile_freeze(struct rte_table_action_profile *profile)
 
 	profile->cfg.action_mask |= 1LLU << RTE_TABLE_ACTION_FWD;
 	action_data_offset_set(&profile->data, &profile->cfg);
+	profile->ah = ah_selector(&profile->cfg);
 	profile->frozen = 1;
 
 	return 0;
@@ -2493,6 +2498,7 @@ rte_table_action_profile_free(struct rte_table_action_profile *profile)
 struct rte_table_action {
 	struct ap_config cfg;
 	struct ap_data data;
+	rte_pipeline_table_action_handler_hit ah;
 	struct dscp_table_data dscp_table;
 	struct meter_profile_data mp[METER_PROFILES_MAX];
 };
@@ -2519,6 +2525,7 @@ rte_table_action_create(struct rte_table_action_profile *profile,
 	/* Initialization */
 	memcpy(&action->cfg, &profile->cfg, sizeof(profile->cfg));
 	memcpy(&action->data, &profile->data, sizeof(profile->data));
+	action->ah = profile->ah;
 
 	return action;
 }
@@ -2882,7 +2889,9 @@ pkt_work(struct rte_mbuf *mbuf,
 	struct rte_pipeline_table_entry *table_entry,
 	uint64_t time,
 	struct rte_table_action *action,
-	struct ap_config *cfg)
+	struct ap_config *cfg,
+	uint64_t action_mask,
+	int ip_version)
 {
 	uint64_t drop_mask = 0;
 
@@ -2892,7 +2901,7 @@ pkt_work(struct rte_mbuf *mbuf,
 	uint32_t dscp;
 	uint16_t total_length;
 
-	if (cfg->common.ip_version) {
+	if (ip_version) {
 		struct rte_ipv4_hdr *hdr = ip;
 
 		dscp = hdr->type_of_service >> 2;
@@ -2905,7 +2914,7 @@ pkt_work(struct rte_mbuf *mbuf,
 			sizeof(struct rte_ipv6_hdr);
 	}
 
-	if (cfg->action_mask & (1LLU << RTE_TABLE_ACTION_LB)) {
+	if (action_mask & (1LLU << RTE_TABLE_ACTION_LB)) {
 		void *data =
 			action_data_get(table_entry, action, RTE_TABLE_ACTION_LB);
 
@@ -2913,7 +2922,7 @@ pkt_work(struct rte_mbuf *mbuf,
 			data,
 			&cfg->lb);
 	}
-	if (cfg->action_mask & (1LLU << RTE_TABLE_ACTION_MTR)) {
+	if (action_mask & (1LLU << RTE_TABLE_ACTION_MTR)) {
 		void *data =
 			action_data_get(table_entry, action, RTE_TABLE_ACTION_MTR);
 
@@ -2926,7 +2935,7 @@ pkt_work(struct rte_mbuf *mbuf,
 			total_length);
 	}
 
-	if (cfg->action_mask & (1LLU << RTE_TABLE_ACTION_TM)) {
+	if (action_mask & (1LLU << RTE_TABLE_ACTION_TM)) {
 		void *data =
 			action_data_get(table_entry, action, RTE_TABLE_ACTION_TM);
 
@@ -2936,7 +2945,7 @@ pkt_work(struct rte_mbuf *mbuf,
 			dscp);
 	}
 
-	if (cfg->action_mask & (1LLU << RTE_TABLE_ACTION_DECAP)) {
+	if (action_mask & (1LLU << RTE_TABLE_ACTION_DECAP)) {
 		void *data = action_data_get(table_entry,
 			action,
 			RTE_TABLE_ACTION_DECAP);
@@ -2944,7 +2953,7 @@ pkt_work(struct rte_mbuf *mbuf,
 		pkt_work_decap(mbuf, data);
 	}
 
-	if (cfg->action_mask & (1LLU << RTE_TABLE_ACTION_ENCAP)) {
+	if (action_mask & (1LLU << RTE_TABLE_ACTION_ENCAP)) {
 		void *data =
 			action_data_get(table_entry, action, RTE_TABLE_ACTION_ENCAP);
 
@@ -2956,41 +2965,41 @@ pkt_work(struct rte_mbuf *mbuf,
 			ip_offset);
 	}
 
-	if (cfg->action_mask & (1LLU << RTE_TABLE_ACTION_NAT)) {
+	if (action_mask & (1LLU << RTE_TABLE_ACTION_NAT)) {
 		void *data =
 			action_data_get(table_entry, action, RTE_TABLE_ACTION_NAT);
 
-		if (cfg->common.ip_version)
+		if (ip_version)
 			pkt_ipv4_work_nat(ip, data, &cfg->nat);
 		else
 			pkt_ipv6_work_nat(ip, data, &cfg->nat);
 	}
 
-	if (cfg->action_mask & (1LLU << RTE_TABLE_ACTION_TTL)) {
+	if (action_mask & (1LLU << RTE_TABLE_ACTION_TTL)) {
 		void *data =
 			action_data_get(table_entry, action, RTE_TABLE_ACTION_TTL);
 
-		if (cfg->common.ip_version)
+		if (ip_version)
 			drop_mask |= pkt_ipv4_work_ttl(ip, data);
 		else
 			drop_mask |= pkt_ipv6_work_ttl(ip, data);
 	}
 
-	if (cfg->action_mask & (1LLU << RTE_TABLE_ACTION_STATS)) {
+	if (action_mask & (1LLU << RTE_TABLE_ACTION_STATS)) {
 		void *data =
 			action_data_get(table_entry, action, RTE_TABLE_ACTION_STATS);
 
 		pkt_work_stats(data, total_length);
 	}
 
-	if (cfg->action_mask & (1LLU << RTE_TABLE_ACTION_TIME)) {
+	if (action_mask & (1LLU << RTE_TABLE_ACTION_TIME)) {
 		void *data =
 			action_data_get(table_entry, action, RTE_TABLE_ACTION_TIME);
 
 		pkt_work_time(data, time);
 	}
 
-	if (cfg->action_mask & (1LLU << RTE_TABLE_ACTION_SYM_CRYPTO)) {
+	if (action_mask & (1LLU << RTE_TABLE_ACTION_SYM_CRYPTO)) {
 		void *data = action_data_get(table_entry, action,
 				RTE_TABLE_ACTION_SYM_CRYPTO);
 
@@ -2998,7 +3007,7 @@ pkt_work(struct rte_mbuf *mbuf,
 				ip_offset);
 	}
 
-	if (cfg->action_mask & (1LLU << RTE_TABLE_ACTION_TAG)) {
+	if (action_mask & (1LLU << RTE_TABLE_ACTION_TAG)) {
 		void *data = action_data_get(table_entry,
 			action,
 			RTE_TABLE_ACTION_TAG);
@@ -3014,7 +3023,9 @@ pkt4_work(struct rte_mbuf **mbufs,
 	struct rte_pipeline_table_entry **table_entries,
 	uint64_t time,
 	struct rte_table_action *action,
-	struct ap_config *cfg)
+	struct ap_config *cfg,
+	uint64_t action_mask,
+	int ip_version)
 {
 	uint64_t drop_mask0 = 0;
 	uint64_t drop_mask1 = 0;
@@ -3040,7 +3051,7 @@ pkt4_work(struct rte_mbuf **mbufs,
 	uint32_t dscp0, dscp1, dscp2, dscp3;
 	uint16_t total_length0, total_length1, total_length2, total_length3;
 
-	if (cfg->common.ip_version) {
+	if (ip_version) {
 		struct rte_ipv4_hdr *hdr0 = ip0;
 		struct rte_ipv4_hdr *hdr1 = ip1;
 		struct rte_ipv4_hdr *hdr2 = ip2;
@@ -3076,7 +3087,7 @@ pkt4_work(struct rte_mbuf **mbufs,
 			sizeof(struct rte_ipv6_hdr);
 	}
 
-	if (cfg->action_mask & (1LLU << RTE_TABLE_ACTION_LB)) {
+	if (action_mask & (1LLU << RTE_TABLE_ACTION_LB)) {
 		void *data0 =
 			action_data_get(table_entry0, action, RTE_TABLE_ACTION_LB);
 		void *data1 =
@@ -3103,7 +3114,7 @@ pkt4_work(struct rte_mbuf **mbufs,
 			&cfg->lb);
 	}
 
-	if (cfg->action_mask & (1LLU << RTE_TABLE_ACTION_MTR)) {
+	if (action_mask & (1LLU << RTE_TABLE_ACTION_MTR)) {
 		void *data0 =
 			action_data_get(table_entry0, action, RTE_TABLE_ACTION_MTR);
 		void *data1 =
@@ -3146,7 +3157,7 @@ pkt4_work(struct rte_mbuf **mbufs,
 			total_length3);
 	}
 
-	if (cfg->action_mask & (1LLU << RTE_TABLE_ACTION_TM)) {
+	if (action_mask & (1LLU << RTE_TABLE_ACTION_TM)) {
 		void *data0 =
 			action_data_get(table_entry0, action, RTE_TABLE_ACTION_TM);
 		void *data1 =
@@ -3177,7 +3188,7 @@ pkt4_work(struct rte_mbuf **mbufs,
 			dscp3);
 	}
 
-	if (cfg->action_mask & (1LLU << RTE_TABLE_ACTION_DECAP)) {
+	if (action_mask & (1LLU << RTE_TABLE_ACTION_DECAP)) {
 		void *data0 = action_data_get(table_entry0,
 			action,
 			RTE_TABLE_ACTION_DECAP);
@@ -3195,7 +3206,7 @@ pkt4_work(struct rte_mbuf **mbufs,
 			data0, data1, data2, data3);
 	}
 
-	if (cfg->action_mask & (1LLU << RTE_TABLE_ACTION_ENCAP)) {
+	if (action_mask & (1LLU << RTE_TABLE_ACTION_ENCAP)) {
 		void *data0 =
 			action_data_get(table_entry0, action, RTE_TABLE_ACTION_ENCAP);
 		void *data1 =
@@ -3234,7 +3245,7 @@ pkt4_work(struct rte_mbuf **mbufs,
 			ip_offset);
 	}
 
-	if (cfg->action_mask & (1LLU << RTE_TABLE_ACTION_NAT)) {
+	if (action_mask & (1LLU << RTE_TABLE_ACTION_NAT)) {
 		void *data0 =
 			action_data_get(table_entry0, action, RTE_TABLE_ACTION_NAT);
 		void *data1 =
@@ -3244,7 +3255,7 @@ pkt4_work(struct rte_mbuf **mbufs,
 		void *data3 =
 			action_data_get(table_entry3, action, RTE_TABLE_ACTION_NAT);
 
-		if (cfg->common.ip_version) {
+		if (ip_version) {
 			pkt_ipv4_work_nat(ip0, data0, &cfg->nat);
 			pkt_ipv4_work_nat(ip1, data1, &cfg->nat);
 			pkt_ipv4_work_nat(ip2, data2, &cfg->nat);
@@ -3257,7 +3268,7 @@ pkt4_work(struct rte_mbuf **mbufs,
 		}
 	}
 
-	if (cfg->action_mask & (1LLU << RTE_TABLE_ACTION_TTL)) {
+	if (action_mask & (1LLU << RTE_TABLE_ACTION_TTL)) {
 		void *data0 =
 			action_data_get(table_entry0, action, RTE_TABLE_ACTION_TTL);
 		void *data1 =
@@ -3267,7 +3278,7 @@ pkt4_work(struct rte_mbuf **mbufs,
 		void *data3 =
 			action_data_get(table_entry3, action, RTE_TABLE_ACTION_TTL);
 
-		if (cfg->common.ip_version) {
+		if (ip_version) {
 			drop_mask0 |= pkt_ipv4_work_ttl(ip0, data0);
 			drop_mask1 |= pkt_ipv4_work_ttl(ip1, data1);
 			drop_mask2 |= pkt_ipv4_work_ttl(ip2, data2);
@@ -3280,7 +3291,7 @@ pkt4_work(struct rte_mbuf **mbufs,
 		}
 	}
 
-	if (cfg->action_mask & (1LLU << RTE_TABLE_ACTION_STATS)) {
+	if (action_mask & (1LLU << RTE_TABLE_ACTION_STATS)) {
 		void *data0 =
 			action_data_get(table_entry0, action, RTE_TABLE_ACTION_STATS);
 		void *data1 =
@@ -3296,7 +3307,7 @@ pkt4_work(struct rte_mbuf **mbufs,
 		pkt_work_stats(data3, total_length3);
 	}
 
-	if (cfg->action_mask & (1LLU << RTE_TABLE_ACTION_TIME)) {
+	if (action_mask & (1LLU << RTE_TABLE_ACTION_TIME)) {
 		void *data0 =
 			action_data_get(table_entry0, action, RTE_TABLE_ACTION_TIME);
 		void *data1 =
@@ -3312,7 +3323,7 @@ pkt4_work(struct rte_mbuf **mbufs,
 		pkt_work_time(data3, time);
 	}
 
-	if (cfg->action_mask & (1LLU << RTE_TABLE_ACTION_SYM_CRYPTO)) {
+	if (action_mask & (1LLU << RTE_TABLE_ACTION_SYM_CRYPTO)) {
 		void *data0 = action_data_get(table_entry0, action,
 				RTE_TABLE_ACTION_SYM_CRYPTO);
 		void *data1 = action_data_get(table_entry1, action,
@@ -3332,7 +3343,7 @@ pkt4_work(struct rte_mbuf **mbufs,
 				ip_offset);
 	}
 
-	if (cfg->action_mask & (1LLU << RTE_TABLE_ACTION_TAG)) {
+	if (action_mask & (1LLU << RTE_TABLE_ACTION_TAG)) {
 		void *data0 = action_data_get(table_entry0,
 			action,
 			RTE_TABLE_ACTION_TAG);
@@ -3362,12 +3373,14 @@ ah(struct rte_pipeline *p,
 	uint64_t pkts_mask,
 	struct rte_pipeline_table_entry **entries,
 	struct rte_table_action *action,
-	struct ap_config *cfg)
+	struct ap_config *cfg,
+	uint64_t action_mask,
+	int ip_version)
 {
 	uint64_t pkts_drop_mask = 0;
 	uint64_t time = 0;
 
-	if (cfg->action_mask & ((1LLU << RTE_TABLE_ACTION_MTR) |
+	if (action_mask & ((1LLU << RTE_TABLE_ACTION_MTR) |
 		(1LLU << RTE_TABLE_ACTION_TIME)))
 		time = rte_rdtsc();
 
@@ -3382,7 +3395,9 @@ ah(struct rte_pipeline *p,
 				&entries[i],
 				time,
 				action,
-				cfg);
+				cfg,
+				action_mask,
+				ip_version);
 
 			pkts_drop_mask |= drop_mask << i;
 		}
@@ -3394,7 +3409,9 @@ ah(struct rte_pipeline *p,
 				entries[i],
 				time,
 				action,
-				cfg);
+				cfg,
+				action_mask,
+				ip_version);
 
 			pkts_drop_mask |= drop_mask << i;
 		}
@@ -3408,7 +3425,9 @@ ah(struct rte_pipeline *p,
 				entries[pos],
 				time,
 				action,
-				cfg);
+				cfg,
+				action_mask,
+				ip_version);
 
 			pkts_mask &= ~pkt_mask;
 			pkts_drop_mask |= drop_mask << pos;
@@ -3433,15 +3452,84 @@ ah_default(struct rte_pipeline *p,
 		pkts_mask,
 		entries,
 		action,
-		&action->cfg);
+		&action->cfg,
+		action->cfg.action_mask,
+		action->cfg.common.ip_version);
 }
 
+/*
+ * Specialized action handlers: with the action mask and the IP version known
+ * at build time, the checks of the disabled actions are compiled out. The
+ * action profiles which are not listed below use the default handler. The
+ * encap profiles are not listed, as the encap work dominates their cost while
+ * its inlining makes each handler large.
+ */
+#define AH_MASK(type) (1LLU << RTE_TABLE_ACTION_ ## type)
+
+#define AH_SPECIALIZED_LIST(f)						\
+	f(fwd_lb, AH_MASK(FWD) | AH_MASK(LB))				\
+	f(fwd_stats, AH_MASK(FWD) | AH_MASK(STATS))			\
+	f(fwd_ttl_stats, AH_MASK(FWD) | AH_MASK(TTL) | AH_MASK(STATS))	\
+	f(fwd_mtr_tm_stats,						\
+	  AH_MASK(FWD) | AH_MASK(MTR) | AH_MASK(TM) | AH_MASK(STATS))	\
+	f(fwd_nat_ttl_stats,						\
+	  AH_MASK(FWD) | AH_MASK(NAT) | AH_MASK(TTL) | AH_MASK(STATS))	\
+	f(fwd_decap_stats, AH_MASK(FWD) | AH_MASK(DECAP) | AH_MASK(STATS))
+
+#define AH_SPECIALIZED_DEFINE(name, mask, ipv)				\
+static int								\
+ah_ ## name ## _ ## ipv(struct rte_pipeline *p,				\
+	struct rte_mbuf **pkts,						\
+	uint64_t pkts_mask,						\
+	struct rte_pipeline_table_entry **entries,			\
+	void *arg)							\
+{									\
+	struct rte_table_action *action = arg;				\
+									\
+	return ah(p,							\
+		pkts,							\
+		pkts_mask,						\
+		entries,						\
+		action,							\
+		&action->cfg,						\
+		mask,							\
+		AH_IP_VERSION_ ## ipv);					\
+}
+
+#define AH_IP_VERSION_ipv4 1
+#define AH_IP_VERSION_ipv6 0
+
+#define AH_SPECIALIZED_DEFINE_ALL(name, mask)				\
+	AH_SPECIALIZED_DEFINE(name, mask, ipv4)				\
+	AH_SPECIALIZED_DEFINE(name, mask, ipv6)
+
+AH_SPECIALIZED_LIST(AH_SPECIALIZED_DEFINE_ALL)
+
+#define AH_SPECIALIZED_ENTRY(name, mask)				\
+	{ mask, ah_ ## name ## _ipv4, ah_ ## name ## _ipv6 },
+
+static const struct {
+	uint64_t action_mask;
+	rte_pipeline_table_action_handler_hit ah_ipv4;
+	rte_pipeline_table_action_handler_hit ah_ipv6;
+} ah_specialized[] = {
+	AH_SPECIALIZED_LIST(AH_SPECIALIZED_ENTRY)
+};
+
 static rte_pipeline_table_action_handler_hit
-ah_selector(struct rte_table_action *action)
+ah_selector(struct ap_config *cfg)
 {
-	if (action->cfg.action_mask == (1LLU << RTE_TABLE_ACTION_FWD))
+	uint32_t i;
+
+	if (cfg->action_mask == (1LLU << RTE_TABLE_ACTION_FWD))
 		return NULL;
 
+	for (i = 0; i < RTE_DIM(ah_specialized); i++)
+		if (cfg->action_mask == ah_specialized[i].action_mask)
+			return cfg->common.ip_version ?
+				ah_specialized[i].ah_ipv4 :
+				ah_specialized[i].ah_ipv6;
+
 	return ah_default;
 }
 
@@ -3457,7 +3545,7 @@ rte_table_action_table_params_get(struct rte_table_action *action,
 		(params == NULL))
 		return -EINVAL;
 
-	f_action_hit = ah_selector(action);
+	f_action_hit = action->ah;
 	total_size = rte_align32pow2(action->data.total_size);
 
 	/* Fill in params */
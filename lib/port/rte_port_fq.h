@@ -0,0 +1,53 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#ifndef __INCLUDE_RTE_PORT_FQ_H__
+#define __INCLUDE_RTE_PORT_FQ_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file
+ * RTE Port Flow Queue Scheduler
+ *
+ * fq_reader: input port built on top of pre-initialized rte_fq
+ * fq_writer: output port built on top of pre-initialized rte_fq
+ *
+ ***/
+
+#include <stdint.h>
+
+#include <rte_fq.h>
+
+#include "rte_port.h"
+
+/** fq_reader port parameters */
+struct rte_port_fq_reader_params {
+	/** Underlying pre-initialized rte_fq */
+	struct rte_fq *fq;
+};
+
+/** fq_reader port operations */
+extern struct rte_port_in_ops rte_port_fq_reader_ops;
+
+/** fq_writer port parameters */
+struct rte_port_fq_writer_params {
+	/** Underlying pre-initialized rte_fq */
+	struct rte_fq *fq;
+
+	/** Recommended burst size. The actual burst size can be bigger or
+	smaller than this value. */
+	uint32_t tx_burst_sz;
+};
+
+/** fq_writer port operations */
+extern struct rte_port_out_ops rte_port_fq_writer_ops;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
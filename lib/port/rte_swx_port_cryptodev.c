@@ -0,0 +1,326 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+
+#include <rte_mbuf.h>
+#include <rte_cryptodev.h>
+#include <rte_hexdump.h>
+
+#include "rte_swx_port_cryptodev.h"
+
+#define CHECK(condition)                                                       \
+do {                                                                           \
+	if (!(condition))                                                      \
+		return NULL;                                                   \
+} while (0)
+
+#ifndef TRACE_LEVEL
+#define TRACE_LEVEL 0
+#endif
+
+#if TRACE_LEVEL
+#define TRACE(...) printf(__VA_ARGS__)
+#else
+#define TRACE(...)
+#endif
+
+/*
+ * Port CRYPTODEV Reader
+ */
+struct reader {
+	struct {
+		uint8_t dev_id;
+		uint16_t queue_id;
+		uint32_t burst_size;
+	} params;
+	struct rte_swx_port_in_stats stats;
+	struct rte_crypto_op **ops;
+	int n_ops;
+	int pos;
+};
+
+static void *
+reader_create(void *args)
+{
+	struct rte_swx_port_cryptodev_reader_params *params = args;
+	struct reader *p;
+	int dev_id;
+
+	/* Check input parameters. */
+	CHECK(params);
+
+	CHECK(params->dev_name);
+	dev_id = rte_cryptodev_get_dev_id(params->dev_name);
+	CHECK(dev_id >= 0);
+
+	CHECK(params->queue_id <
+	      rte_cryptodev_queue_pair_count((uint8_t)dev_id));
+
+	CHECK(params->burst_size);
+
+	/* Memory allocation. */
+	p = calloc(1, sizeof(struct reader));
+	CHECK(p);
+
+	p->ops = calloc(params->burst_size, sizeof(struct rte_crypto_op *));
+	if (!p->ops) {
+		free(p);
+		CHECK(0);
+	}
+
+	/* Initialization. */
+	p->params.dev_id = (uint8_t)dev_id;
+	p->params.queue_id = params->queue_id;
+	p->params.burst_size = params->burst_size;
+
+	return p;
+}
+
+static int
+reader_pkt_rx(void *port, struct rte_swx_pkt *pkt)
+{
+	struct reader *p = port;
+	struct rte_crypto_op *op;
+	struct rte_mbuf *m;
+
+	for ( ; ; ) {
+		if (p->pos == p->n_ops) {
+			int n_ops;
+
+			n_ops = rte_cryptodev_dequeue_burst(p->params.dev_id,
+							    p->params.queue_id,
+							    p->ops,
+							    p->params.burst_size);
+			if (!n_ops) {
+				p->stats.n_empty++;
+				return 0;
+			}
+
+			TRACE("[Cryptodev %u queue %u] %d packets in\n",
+			      (uint32_t)p->params.dev_id,
+			      (uint32_t)p->params.queue_id,
+			      n_ops);
+
+			p->n_ops = n_ops;
+			p->pos = 0;
+		}
+
+		op = p->ops[p->pos++];
+		m = op->sym->m_src;
+		if (likely(op->status == RTE_CRYPTO_OP_STATUS_SUCCESS))
+			break;
+
+		/* Drop the packets whose crypto operation failed. */
+		rte_pktmbuf_free(m);
+	}
+
+	pkt->handle = m;
+	pkt->pkt = m->buf_addr;
+	pkt->offset = m->data_off;
+	pkt->length = m->pkt_len;
+
+	TRACE("[Cryptodev %u queue %u] Pkt %d (%u bytes at offset %u)\n",
+	      (uint32_t)p->params.dev_id,
+	      (uint32_t)p->params.queue_id,
+	      p->pos - 1,
+	      pkt->length,
+	      pkt->offset);
+	if (TRACE_LEVEL)
+		rte_hexdump(stdout,
+			    NULL,
+			    &((uint8_t *)m->buf_addr)[m->data_off],
+			    m->data_len);
+
+	p->stats.n_pkts++;
+	p->stats.n_bytes += pkt->length;
+
+	return 1;
+}
+
+static void
+reader_free(void *port)
+{
+	struct reader *p = port;
+	int i;
+
+	if (!p)
+		return;
+
+	for (i = p->pos; i < p->n_ops; i++)
+		rte_pktmbuf_free(p->ops[i]->sym->m_src);
+
+	free(p->ops);
+	free(p);
+}
+
+static void
+reader_stats_read(void *port, struct rte_swx_port_in_stats *stats)
+{
+	struct reader *p = port;
+
+	if (!stats)
+		return;
+
+	memcpy(stats, &p->stats, sizeof(p->stats));
+}
+
+/*
+ * Port CRYPTODEV Writer
+ */
+struct writer {
+	struct {
+		uint8_t dev_id;
+		uint16_t queue_id;
+		uint16_t crypto_op_offset;
+		uint32_t burst_size;
+	} params;
+	struct rte_swx_port_out_stats stats;
+
+	struct rte_crypto_op **ops;
+	int n_ops;
+};
+
+static void *
+writer_create(void *args)
+{
+	struct rte_swx_port_cryptodev_writer_params *params = args;
+	struct writer *p;
+	int dev_id;
+
+	/* Check input parameters. */
+	CHECK(params);
+
+	CHECK(params->dev_name);
+	dev_id = rte_cryptodev_get_dev_id(params->dev_name);
+	CHECK(dev_id >= 0);
+
+	CHECK(params->queue_id <
+	      rte_cryptodev_queue_pair_count((uint8_t)dev_id));
+
+	CHECK(params->crypto_op_offset >= sizeof(struct rte_mbuf));
+
+	CHECK(params->burst_size);
+
+	/* Memory allocation. */
+	p = calloc(1, sizeof(struct writer));
+	CHECK(p);
+
+	p->ops = calloc(params->burst_size, sizeof(struct rte_crypto_op *));
+	if (!p->ops) {
+		free(p);
+		CHECK(0);
+	}
+
+	/* Initialization. */
+	p->params.dev_id = (uint8_t)dev_id;
+	p->params.queue_id = params->queue_id;
+	p->params.crypto_op_offset = params->crypto_op_offset;
+	p->params.burst_size = params->burst_size;
+
+	return p;
+}
+
+static void
+__writer_flush(struct writer *p)
+{
+	int n_ops;
+
+	for (n_ops = 0; ; ) {
+		n_ops += rte_cryptodev_enqueue_burst(p->params.dev_id,
+						     p->params.queue_id,
+						     p->ops + n_ops,
+						     p->n_ops - n_ops);
+
+		TRACE("[Cryptodev %u queue %u] %d packets out\n",
+		      (uint32_t)p->params.dev_id,
+		      (uint32_t)p->params.queue_id,
+		      n_ops);
+
+		if (n_ops == p->n_ops)
+			break;
+	}
+
+	p->n_ops = 0;
+}
+
+static void
+writer_pkt_tx(void *port, struct rte_swx_pkt *pkt)
+{
+	struct writer *p = port;
+	struct rte_mbuf *m = pkt->handle;
+
+	TRACE("[Cryptodev %u queue %u] Pkt %d (%u bytes at offset %u)\n",
+	      (uint32_t)p->params.dev_id,
+	      (uint32_t)p->params.queue_id,
+	      p->n_ops - 1,
+	      pkt->length,
+	      pkt->offset);
+	if (TRACE_LEVEL)
+		rte_hexdump(stdout, NULL, &pkt->pkt[pkt->offset], pkt->length);
+
+	m->pkt_len = pkt->length;
+	m->data_len = (uint16_t)pkt->length;
+	m->data_off = (uint16_t)pkt->offset;
+
+	p->stats.n_pkts++;
+	p->stats.n_bytes += pkt->length;
+
+	p->ops[p->n_ops++] = RTE_PTR_ADD(m, p->params.crypto_op_offset);
+	if (p->n_ops == (int)p->params.burst_size)
+		__writer_flush(p);
+}
+
+static void
+writer_flush(void *port)
+{
+	struct writer *p = port;
+
+	if (p->n_ops)
+		__writer_flush(p);
+}
+
+static void
+writer_free(void *port)
+{
+	struct writer *p = port;
+
+	if (!p)
+		return;
+
+	writer_flush(p);
+	free(p->ops);
+	free(port);
+}
+
+static void
+writer_stats_read(void *port, struct rte_swx_port_out_stats *stats)
+{
+	struct writer *p = port;
+
+	if (!stats)
+		return;
+
+	memcpy(stats, &p->stats, sizeof(p->stats));
+}
+
+/*
+ * Summary of port operations
+ */
+struct rte_swx_port_in_ops rte_swx_port_cryptodev_reader_ops = {
+	.create = reader_create,
+	.free = reader_free,
+	.pkt_rx = reader_pkt_rx,
+	.stats_read = reader_stats_read,
+};
+
+struct rte_swx_port_out_ops rte_swx_port_cryptodev_writer_ops = {
+	.create = writer_create,
+	.free = writer_free,
+	.pkt_tx = writer_pkt_tx,
+	.flush = writer_flush,
+	.stats_read = writer_stats_read,
+};
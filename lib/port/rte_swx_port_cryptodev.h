@@ -0,0 +1,68 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+#ifndef __INCLUDE_RTE_SWX_PORT_CRYPTODEV_H__
+#define __INCLUDE_RTE_SWX_PORT_CRYPTODEV_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file
+ * RTE SWX Crypto Device Input and Output Ports
+ *
+ * The writer enqueues the packets to a crypto device queue pair and the
+ * reader dequeues the processed packets from the same queue pair. The crypto
+ * operation of each packet is prepared by the application in the private
+ * area of its mbuf, with the packet as its source mbuf. A queue pair
+ * completes the operations in their enqueue order, so the packets are read
+ * in the order they were written.
+ ***/
+
+#include <stdint.h>
+
+#include "rte_swx_port.h"
+
+/** Crypto device input port (reader) creation parameters. */
+struct rte_swx_port_cryptodev_reader_params {
+	/** Name of a valid and fully configured crypto device. */
+	const char *dev_name;
+
+	/** Crypto device queue pair ID. */
+	uint16_t queue_id;
+
+	/** Crypto device dequeue burst size. */
+	uint32_t burst_size;
+};
+
+/**
+ * Crypto device reader operations.
+ *
+ * The packets of the failed crypto operations are dropped.
+ */
+extern struct rte_swx_port_in_ops rte_swx_port_cryptodev_reader_ops;
+
+/** Crypto device output port (writer) creation parameters. */
+struct rte_swx_port_cryptodev_writer_params {
+	/** Name of a valid and fully configured crypto device. */
+	const char *dev_name;
+
+	/** Crypto device queue pair ID. */
+	uint16_t queue_id;
+
+	/** Offset of the crypto operation from the start of the mbuf. */
+	uint16_t crypto_op_offset;
+
+	/** Crypto device enqueue burst size. */
+	uint32_t burst_size;
+};
+
+/** Crypto device writer operations. */
+extern struct rte_swx_port_out_ops rte_swx_port_cryptodev_writer_ops;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
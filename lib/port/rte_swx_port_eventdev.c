@@ -0,0 +1,442 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+
+#include <rte_errno.h>
+#include <rte_mbuf.h>
+#include <rte_mempool.h>
+#include <rte_eventdev.h>
+#include <rte_hexdump.h>
+
+#include "rte_swx_port_eventdev.h"
+
+#define CHECK(condition)                                                       \
+do {                                                                           \
+	if (!(condition))                                                      \
+		return NULL;                                                   \
+} while (0)
+
+#ifndef TRACE_LEVEL
+#define TRACE_LEVEL 0
+#endif
+
+#if TRACE_LEVEL
+#define TRACE(...) printf(__VA_ARGS__)
+#else
+#define TRACE(...)
+#endif
+
+/*
+ * Port EVENTDEV Reader
+ */
+struct reader {
+	struct {
+		uint8_t dev_id;
+		uint8_t port_id;
+		uint32_t burst_size;
+	} params;
+	struct rte_swx_port_in_stats stats;
+	struct rte_event *events;
+	int n_events;
+	int pos;
+
+	/* Event vector being read. */
+	struct rte_event_vector *vec;
+	uint16_t vec_pos;
+};
+
+static void *
+reader_create(void *args)
+{
+	struct rte_swx_port_eventdev_reader_params *params = args;
+	struct reader *p;
+	int dev_id;
+
+	/* Check input parameters. */
+	CHECK(params);
+
+	CHECK(params->dev_name);
+	dev_id = rte_event_dev_get_dev_id(params->dev_name);
+	CHECK(dev_id >= 0);
+
+	CHECK(params->burst_size);
+
+	/* Memory allocation. */
+	p = calloc(1, sizeof(struct reader));
+	CHECK(p);
+
+	p->events = calloc(params->burst_size, sizeof(struct rte_event));
+	if (!p->events) {
+		free(p);
+		CHECK(0);
+	}
+
+	/* Initialization. */
+	p->params.dev_id = (uint8_t)dev_id;
+	p->params.port_id = params->port_id;
+	p->params.burst_size = params->burst_size;
+
+	return p;
+}
+
+static inline void
+vector_free(struct rte_event_vector *vec)
+{
+	rte_mempool_put(rte_mempool_from_obj(vec), vec);
+}
+
+/* Next mbuf of the dequeued events, NULL when all of them are read. */
+static inline struct rte_mbuf *
+reader_next_mbuf(struct reader *p)
+{
+	for ( ; ; ) {
+		struct rte_event *ev;
+
+		if (p->vec) {
+			if (p->vec_pos < p->vec->nb_elem)
+				return p->vec->mbufs[p->vec_pos++];
+
+			vector_free(p->vec);
+			p->vec = NULL;
+		}
+
+		if (p->pos == p->n_events)
+			return NULL;
+
+		ev = &p->events[p->pos++];
+		if (!(ev->event_type & RTE_EVENT_TYPE_VECTOR))
+			return ev->mbuf;
+
+		p->vec = ev->vec;
+		p->vec_pos = 0;
+	}
+}
+
+static int
+reader_pkt_rx(void *port, struct rte_swx_pkt *pkt)
+{
+	struct reader *p = port;
+	struct rte_mbuf *m;
+
+	m = reader_next_mbuf(p);
+	if (!m) {
+		int n_events;
+
+		n_events = rte_event_dequeue_burst(p->params.dev_id,
+						   p->params.port_id,
+						   p->events,
+						   p->params.burst_size,
+						   0);
+		p->n_events = n_events;
+		p->pos = 0;
+
+		m = reader_next_mbuf(p);
+		if (!m) {
+			p->stats.n_empty++;
+			return 0;
+		}
+
+		TRACE("[Eventdev %u port %u] %d events in\n",
+		      (uint32_t)p->params.dev_id,
+		      (uint32_t)p->params.port_id,
+		      n_events);
+	}
+
+	pkt->handle = m;
+	pkt->pkt = m->buf_addr;
+	pkt->offset = m->data_off;
+	pkt->length = m->pkt_len;
+
+	TRACE("[Eventdev %u port %u] Pkt (%u bytes at offset %u)\n",
+	      (uint32_t)p->params.dev_id,
+	      (uint32_t)p->params.port_id,
+	      pkt->length,
+	      pkt->offset);
+	if (TRACE_LEVEL)
+		rte_hexdump(stdout,
+			    NULL,
+			    &((uint8_t *)m->buf_addr)[m->data_off],
+			    m->data_len);
+
+	p->stats.n_pkts++;
+	p->stats.n_bytes += pkt->length;
+
+	return 1;
+}
+
+static void
+reader_free(void *port)
+{
+	struct reader *p = port;
+	struct rte_mbuf *m;
+
+	if (!p)
+		return;
+
+	while ((m = reader_next_mbuf(p)) != NULL)
+		rte_pktmbuf_free(m);
+
+	free(p->events);
+	free(p);
+}
+
+static void
+reader_stats_read(void *port, struct rte_swx_port_in_stats *stats)
+{
+	struct reader *p = port;
+
+	if (!stats)
+		return;
+
+	memcpy(stats, &p->stats, sizeof(p->stats));
+}
+
+/*
+ * Port EVENTDEV Writer
+ */
+struct writer {
+	struct {
+		uint8_t dev_id;
+		uint8_t port_id;
+		uint8_t queue_id;
+		uint8_t sched_type;
+		uint8_t evt_op;
+		uint32_t burst_size;
+		struct rte_mempool *vector_pool;
+		uint16_t vector_size;
+	} params;
+	struct rte_swx_port_out_stats stats;
+
+	struct rte_mbuf **pkts;
+	struct rte_event *events;
+	int n_pkts;
+};
+
+static void *
+writer_create(void *args)
+{
+	struct rte_swx_port_eventdev_writer_params *params = args;
+	struct rte_mempool *vector_pool = NULL;
+	struct writer *p;
+	int dev_id;
+
+	/* Check input parameters. */
+	CHECK(params);
+
+	CHECK(params->dev_name);
+	dev_id = rte_event_dev_get_dev_id(params->dev_name);
+	CHECK(dev_id >= 0);
+
+	CHECK(params->evt_op == RTE_EVENT_OP_NEW ||
+	      params->evt_op == RTE_EVENT_OP_FORWARD);
+
+	CHECK(params->burst_size);
+
+	if (params->vector_pool_name) {
+		vector_pool = rte_mempool_lookup(params->vector_pool_name);
+		CHECK(vector_pool);
+
+		CHECK(params->vector_size);
+		CHECK(vector_pool->elt_size >= sizeof(struct rte_event_vector) +
+		      params->vector_size * sizeof(uintptr_t));
+	}
+
+	/* Memory allocation. */
+	p = calloc(1, sizeof(struct writer));
+	CHECK(p);
+
+	p->pkts = calloc(params->burst_size, sizeof(struct rte_mbuf *));
+	p->events = calloc(params->burst_size, sizeof(struct rte_event));
+	if (!p->pkts || !p->events) {
+		free(p->events);
+		free(p->pkts);
+		free(p);
+		CHECK(0);
+	}
+
+	/* Initialization. */
+	p->params.dev_id = (uint8_t)dev_id;
+	p->params.port_id = params->port_id;
+	p->params.queue_id = params->queue_id;
+	p->params.sched_type = params->sched_type;
+	p->params.evt_op = params->evt_op;
+	p->params.burst_size = params->burst_size;
+	p->params.vector_pool = vector_pool;
+	p->params.vector_size = params->vector_size;
+
+	return p;
+}
+
+/* The flow of the event is the RSS hash of its first packet, when valid. */
+static inline void
+writer_event_init(struct writer *p, struct rte_event *ev, struct rte_mbuf *m)
+{
+	ev->event = 0;
+	ev->flow_id = (m->ol_flags & PKT_RX_RSS_HASH) ? m->hash.rss : 0;
+	ev->op = p->params.evt_op;
+	ev->sched_type = p->params.sched_type;
+	ev->queue_id = p->params.queue_id;
+	ev->priority = RTE_EVENT_DEV_PRIORITY_NORMAL;
+}
+
+/*
+ * Pack the buffered packets into events. A packet is sent alone when no event
+ * vector can be allocated, so the vectors never cause a drop.
+ */
+static int
+writer_events_build(struct writer *p)
+{
+	int n_events = 0;
+	int i;
+
+	for (i = 0; i < p->n_pkts; ) {
+		struct rte_event *ev = &p->events[n_events++];
+		struct rte_event_vector *vec;
+		int n;
+
+		if (!p->params.vector_pool ||
+		    rte_mempool_get(p->params.vector_pool, (void **)&vec)) {
+			writer_event_init(p, ev, p->pkts[i]);
+			ev->event_type = RTE_EVENT_TYPE_CPU;
+			ev->mbuf = p->pkts[i++];
+			continue;
+		}
+
+		n = RTE_MIN(p->n_pkts - i, (int)p->params.vector_size);
+		vec->nb_elem = n;
+		vec->attr_valid = 0;
+		memcpy(vec->mbufs, &p->pkts[i], n * sizeof(struct rte_mbuf *));
+		writer_event_init(p, ev, p->pkts[i]);
+		ev->event_type = RTE_EVENT_TYPE_CPU_VECTOR;
+		ev->vec = vec;
+		i += n;
+	}
+
+	return n_events;
+}
+
+static void
+__writer_flush(struct writer *p)
+{
+	int n_events_total, n_events;
+
+	n_events_total = writer_events_build(p);
+
+	for (n_events = 0; ; ) {
+		rte_errno = 0;
+		n_events += rte_event_enqueue_burst(p->params.dev_id,
+						    p->params.port_id,
+						    p->events + n_events,
+						    n_events_total - n_events);
+
+		TRACE("[Eventdev %u port %u] %d events out\n",
+		      (uint32_t)p->params.dev_id,
+		      (uint32_t)p->params.port_id,
+		      n_events);
+
+		if (n_events == n_events_total)
+			break;
+
+		/* Retry unless the events are invalid. */
+		if (rte_errno == EINVAL)
+			break;
+	}
+
+	/* Drop the events refused by the event device. */
+	for ( ; n_events < n_events_total; n_events++) {
+		struct rte_event *ev = &p->events[n_events];
+
+		if (ev->event_type & RTE_EVENT_TYPE_VECTOR) {
+			rte_pktmbuf_free_bulk(ev->vec->mbufs,
+					      ev->vec->nb_elem);
+			vector_free(ev->vec);
+		} else {
+			rte_pktmbuf_free(ev->mbuf);
+		}
+	}
+
+	p->n_pkts = 0;
+}
+
+static void
+writer_pkt_tx(void *port, struct rte_swx_pkt *pkt)
+{
+	struct writer *p = port;
+	struct rte_mbuf *m = pkt->handle;
+
+	TRACE("[Eventdev %u port %u] Pkt %d (%u bytes at offset %u)\n",
+	      (uint32_t)p->params.dev_id,
+	      (uint32_t)p->params.port_id,
+	      p->n_pkts - 1,
+	      pkt->length,
+	      pkt->offset);
+	if (TRACE_LEVEL)
+		rte_hexdump(stdout, NULL, &pkt->pkt[pkt->offset], pkt->length);
+
+	m->pkt_len = pkt->length;
+	m->data_len = (uint16_t)pkt->length;
+	m->data_off = (uint16_t)pkt->offset;
+
+	p->stats.n_pkts++;
+	p->stats.n_bytes += pkt->length;
+
+	p->pkts[p->n_pkts++] = m;
+	if (p->n_pkts == (int)p->params.burst_size)
+		__writer_flush(p);
+}
+
+static void
+writer_flush(void *port)
+{
+	struct writer *p = port;
+
+	if (p->n_pkts)
+		__writer_flush(p);
+}
+
+static void
+writer_free(void *port)
+{
+	struct writer *p = port;
+
+	if (!p)
+		return;
+
+	writer_flush(p);
+	free(p->events);
+	free(p->pkts);
+	free(port);
+}
+
+static void
+writer_stats_read(void *port, struct rte_swx_port_out_stats *stats)
+{
+	struct writer *p = port;
+
+	if (!stats)
+		return;
+
+	memcpy(stats, &p->stats, sizeof(p->stats));
+}
+
+/*
+ * Summary of port operations
+ */
+struct rte_swx_port_in_ops rte_swx_port_eventdev_reader_ops = {
+	.create = reader_create,
+	.free = reader_free,
+	.pkt_rx = reader_pkt_rx,
+	.stats_read = reader_stats_read,
+};
+
+struct rte_swx_port_out_ops rte_swx_port_eventdev_writer_ops = {
+	.create = writer_create,
+	.free = writer_free,
+	.pkt_tx = writer_pkt_tx,
+	.flush = writer_flush,
+	.stats_read = writer_stats_read,
+};
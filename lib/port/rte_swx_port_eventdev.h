@@ -0,0 +1,79 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+#ifndef __INCLUDE_RTE_SWX_PORT_EVENTDEV_H__
+#define __INCLUDE_RTE_SWX_PORT_EVENTDEV_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file
+ * RTE SWX Event Device Input and Output Ports
+ ***/
+
+#include <stdint.h>
+
+#include "rte_swx_port.h"
+
+/** Event device input port (reader) creation parameters. */
+struct rte_swx_port_eventdev_reader_params {
+	/** Name of a valid and fully configured event device. */
+	const char *dev_name;
+
+	/** Event port ID. */
+	uint8_t port_id;
+
+	/** Event dequeue burst size. */
+	uint32_t burst_size;
+};
+
+/**
+ * Event device reader operations.
+ *
+ * The events carry either one mbuf or an event vector of mbufs, the mbufs of
+ * a vector being read one by one and the vector being returned to its mempool
+ * once read.
+ */
+extern struct rte_swx_port_in_ops rte_swx_port_eventdev_reader_ops;
+
+/** Event device output port (writer) creation parameters. */
+struct rte_swx_port_eventdev_writer_params {
+	/** Name of a valid and fully configured event device. */
+	const char *dev_name;
+
+	/** Event port ID. */
+	uint8_t port_id;
+
+	/** Event queue ID. */
+	uint8_t queue_id;
+
+	/** Scheduler synchronization type (RTE_SCHED_TYPE_*). */
+	uint8_t sched_type;
+
+	/** Event enqueue operation (RTE_EVENT_OP_NEW or RTE_EVENT_OP_FORWARD). */
+	uint8_t evt_op;
+
+	/** Event enqueue burst size, in packets. */
+	uint32_t burst_size;
+
+	/**
+	 * Name of a valid event vector mempool. When NULL, each packet is
+	 * sent as one event, otherwise the packets are sent in event vectors
+	 * of up to *vector_size* packets.
+	 */
+	const char *vector_pool_name;
+
+	/** Maximum number of packets per event vector. */
+	uint16_t vector_size;
+};
+
+/** Event device writer operations. */
+extern struct rte_swx_port_out_ops rte_swx_port_eventdev_writer_ops;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,68 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+#ifndef __INCLUDE_RTE_SWX_PORT_VHOST_H__
+#define __INCLUDE_RTE_SWX_PORT_VHOST_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file
+ * RTE SWX Vhost Input and Output Ports
+ *
+ * The ports are created once the vhost device is ready, i.e. from or after
+ * its new_device() callback, and must be freed before its destroy_device()
+ * callback returns.
+ ***/
+
+#include <stdint.h>
+
+#include <rte_mempool.h>
+
+#include "rte_swx_port.h"
+
+/** Vhost input port (reader) creation parameters. */
+struct rte_swx_port_vhost_reader_params {
+	/** Vhost device ID. */
+	int vid;
+
+	/** Virtio queue index, the guest transmit queues having odd indexes. */
+	uint16_t queue_id;
+
+	/** Buffer pool of the received packets. Must be valid. */
+	struct rte_mempool *pool;
+
+	/** Vhost dequeue burst size. */
+	uint32_t burst_size;
+};
+
+/** Vhost reader operations. */
+extern struct rte_swx_port_in_ops rte_swx_port_vhost_reader_ops;
+
+/** Vhost output port (writer) creation parameters. */
+struct rte_swx_port_vhost_writer_params {
+	/** Vhost device ID. */
+	int vid;
+
+	/** Virtio queue index, the guest receive queues having even indexes. */
+	uint16_t queue_id;
+
+	/** Vhost enqueue burst size. */
+	uint32_t burst_size;
+};
+
+/**
+ * Vhost writer operations.
+ *
+ * The packets are copied to the guest buffers and freed, the packets which
+ * do not fit in the guest receive queue are dropped.
+ */
+extern struct rte_swx_port_out_ops rte_swx_port_vhost_writer_ops;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
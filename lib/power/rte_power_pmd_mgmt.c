@@ -2,6 +2,8 @@
  * Copyright(c) 2020 Intel Corporation
  */
 
+#include <sys/queue.h>
+
 #include <rte_lcore.h>
 #include <rte_cycles.h>
 #include <rte_cpuflags.h>
@@ -33,20 +35,188 @@ enum pmd_mgmt_state {
 	PMD_MGMT_ENABLED
 };
 
-struct pmd_queue_cfg {
+union queue {
+	uint32_t val;
+	struct {
+		uint16_t portid;
+		uint16_t qid;
+	};
+};
+
+struct pmd_core_cfg;
+
+struct queue_list_entry {
+	TAILQ_ENTRY(queue_list_entry) next;
+	union queue queue;
+	/**< Port and queue identifiers */
+	struct pmd_core_cfg *lcore_cfg;
+	/**< Configuration of the lcore polling this queue */
+	uint64_t n_empty_polls;
+	/**< Number of consecutive empty polls */
+	uint64_t n_sleeps;
+	/**< Sleep iteration this queue was last ready for */
+	const struct rte_eth_rxtx_callback *cb;
+	/**< Callback instance */
+};
+
+struct pmd_core_cfg {
+	TAILQ_HEAD(queue_list_head, queue_list_entry) head;
+	/**< List of queues polled by this lcore */
+	size_t n_queues;
+	/**< How many queues are in the list? */
 	volatile enum pmd_mgmt_state pwr_mgmt_state;
-	/**< State of power management for this queue */
+	/**< State of power management for this lcore */
 	enum rte_power_pmd_mgmt_type cb_mode;
-	/**< Callback mode for this queue */
-	const struct rte_eth_rxtx_callback *cur_cb;
-	/**< Callback instance */
-	volatile bool umwait_in_progress;
-	/**< are we currently sleeping? */
-	uint64_t empty_poll_stats;
-	/**< Number of empty polls */
+	/**< Callback mode for this lcore */
+	uint64_t n_queues_ready_to_sleep;
+	/**< Number of queues ready to enter power optimized state */
+	uint64_t sleep_target;
+	/**< Current sleep iteration, a queue is ready when it matches it */
 } __rte_cache_aligned;
 
-static struct pmd_queue_cfg port_cfg[RTE_MAX_ETHPORTS][RTE_MAX_QUEUES_PER_PORT];
+static struct pmd_core_cfg lcore_cfgs[RTE_MAX_LCORE];
+
+static inline bool
+queue_equal(const union queue *l, const union queue *r)
+{
+	return l->val == r->val;
+}
+
+static struct queue_list_entry *
+queue_list_find(const struct pmd_core_cfg *cfg, const union queue *q)
+{
+	struct queue_list_entry *cur;
+
+	TAILQ_FOREACH(cur, &cfg->head, next) {
+		if (queue_equal(&cur->queue, q))
+			return cur;
+	}
+	return NULL;
+}
+
+static struct queue_list_entry *
+queue_list_add(struct pmd_core_cfg *cfg, const union queue *q)
+{
+	struct queue_list_entry *qle;
+
+	qle = rte_zmalloc("pmd_mgmt_queue", sizeof(*qle), 0);
+	if (qle == NULL)
+		return NULL;
+
+	qle->queue.val = q->val;
+	qle->lcore_cfg = cfg;
+	TAILQ_INSERT_TAIL(&cfg->head, qle, next);
+	cfg->n_queues++;
+
+	return qle;
+}
+
+static void
+queue_list_remove(struct pmd_core_cfg *cfg, struct queue_list_entry *qle)
+{
+	TAILQ_REMOVE(&cfg->head, qle, next);
+	cfg->n_queues--;
+	rte_free(qle);
+}
+
+/* find the lcore polling a queue, if any */
+static struct pmd_core_cfg *
+queue_lcore_find(const union queue *q)
+{
+	unsigned int i;
+
+	for (i = 0; i < RTE_DIM(lcore_cfgs); i++) {
+		if (lcore_cfgs[i].n_queues != 0 &&
+				queue_list_find(&lcore_cfgs[i], q) != NULL)
+			return &lcore_cfgs[i];
+	}
+	return NULL;
+}
+
+static int
+queue_stopped(const uint16_t port_id, const uint16_t queue_id)
+{
+	struct rte_eth_rxq_info qinfo;
+
+	/* no queue of a stopped port is polled */
+	if (!rte_eth_devices[port_id].data->dev_started)
+		return 1;
+
+	if (rte_eth_rx_queue_info_get(port_id, queue_id, &qinfo) < 0)
+		return -1;
+
+	return qinfo.queue_state == RTE_ETH_QUEUE_STATE_STOPPED;
+}
+
+static inline int
+get_monitor_addresses(struct pmd_core_cfg *cfg,
+		struct rte_power_monitor_cond *pmc, size_t len)
+{
+	const struct queue_list_entry *qle;
+	size_t i = 0;
+	int ret;
+
+	TAILQ_FOREACH(qle, &cfg->head, next) {
+		/* attempted out of bounds access */
+		if (i >= len)
+			return -1;
+
+		ret = rte_eth_get_monitor_addr(qle->queue.portid,
+				qle->queue.qid, &pmc[i++]);
+		if (ret < 0)
+			return ret;
+	}
+	return 0;
+}
+
+static inline void
+queue_reset(struct pmd_core_cfg *cfg, struct queue_list_entry *qcfg)
+{
+	/* remove the queue from the queues ready to sleep */
+	if (qcfg->n_sleeps == cfg->sleep_target)
+		cfg->n_queues_ready_to_sleep--;
+
+	qcfg->n_empty_polls = 0;
+	/* sleep target is never zero, so this queue is not ready anymore */
+	qcfg->n_sleeps = 0;
+}
+
+static inline bool
+queue_can_sleep(struct pmd_core_cfg *cfg, struct queue_list_entry *qcfg)
+{
+	/* this function is called on an empty poll */
+	qcfg->n_empty_polls++;
+
+	/* if we haven't reached threshold for empty polls, we can't sleep */
+	if (qcfg->n_empty_polls <= EMPTYPOLL_MAX)
+		return false;
+
+	/* mark this queue as ready for this sleep if it is not yet */
+	if (qcfg->n_sleeps != cfg->sleep_target) {
+		qcfg->n_sleeps = cfg->sleep_target;
+		cfg->n_queues_ready_to_sleep++;
+	}
+
+	return true;
+}
+
+static inline bool
+lcore_can_sleep(struct pmd_core_cfg *cfg)
+{
+	/* are all queues ready to sleep? */
+	if (cfg->n_queues_ready_to_sleep != cfg->n_queues)
+		return false;
+
+	/*
+	 * move on to the next sleep, which makes all queues not ready anymore.
+	 * the empty poll counters are kept, so that we keep sleeping on every
+	 * poll of all queues until we actually get traffic.
+	 */
+	cfg->n_queues_ready_to_sleep = 0;
+	cfg->sleep_target++;
+
+	return true;
+}
 
 static void
 calc_tsc(void)
@@ -77,289 +247,308 @@ calc_tsc(void)
 }
 
 static uint16_t
-clb_umwait(uint16_t port_id, uint16_t qidx, struct rte_mbuf **pkts __rte_unused,
-		uint16_t nb_rx, uint16_t max_pkts __rte_unused,
-		void *addr __rte_unused)
+clb_multiwait(uint16_t port_id __rte_unused, uint16_t qidx __rte_unused,
+		struct rte_mbuf **pkts __rte_unused, uint16_t nb_rx,
+		uint16_t max_pkts __rte_unused, void *arg)
 {
+	struct queue_list_entry *queue_conf = arg;
+	struct pmd_core_cfg *lcore_conf = queue_conf->lcore_cfg;
 
-	struct pmd_queue_cfg *q_conf;
-
-	q_conf = &port_cfg[port_id][qidx];
-
-	if (unlikely(nb_rx == 0)) {
-		q_conf->empty_poll_stats++;
-		if (unlikely(q_conf->empty_poll_stats > EMPTYPOLL_MAX)) {
-			struct rte_power_monitor_cond pmc;
-			uint16_t ret;
-
-			/*
-			 * we might get a cancellation request while being
-			 * inside the callback, in which case the wakeup
-			 * wouldn't work because it would've arrived too early.
-			 *
-			 * to get around this, we notify the other thread that
-			 * we're sleeping, so that it can spin until we're done.
-			 * unsolicited wakeups are perfectly safe.
-			 */
-			q_conf->umwait_in_progress = true;
-
-			rte_atomic_thread_fence(__ATOMIC_SEQ_CST);
-
-			/* check if we need to cancel sleep */
-			if (q_conf->pwr_mgmt_state == PMD_MGMT_ENABLED) {
-				/* use monitoring condition to sleep */
-				ret = rte_eth_get_monitor_addr(port_id, qidx,
-						&pmc);
-				if (ret == 0)
-					rte_power_monitor(&pmc, UINT64_MAX);
-			}
-			q_conf->umwait_in_progress = false;
-
-			rte_atomic_thread_fence(__ATOMIC_SEQ_CST);
-		}
-	} else
-		q_conf->empty_poll_stats = 0;
+	if (likely(nb_rx != 0)) {
+		queue_reset(lcore_conf, queue_conf);
+		return nb_rx;
+	}
+
+	/* sleep only once all queues of this lcore have been idle */
+	if (queue_can_sleep(lcore_conf, queue_conf) &&
+			lcore_can_sleep(lcore_conf)) {
+		const size_t n_queues = lcore_conf->n_queues;
+		struct rte_power_monitor_cond pmc[n_queues];
+
+		/* check if we need to cancel sleep */
+		if (lcore_conf->pwr_mgmt_state != PMD_MGMT_ENABLED)
+			return nb_rx;
+
+		/* use monitoring conditions of all queues to sleep */
+		if (get_monitor_addresses(lcore_conf, pmc, n_queues) < 0)
+			return nb_rx;
+
+		if (n_queues == 1)
+			rte_power_monitor(pmc, UINT64_MAX);
+		else
+			rte_power_monitor_multi(pmc, n_queues, UINT64_MAX);
+	}
 
 	return nb_rx;
 }
 
 static uint16_t
-clb_pause(uint16_t port_id, uint16_t qidx, struct rte_mbuf **pkts __rte_unused,
-		uint16_t nb_rx, uint16_t max_pkts __rte_unused,
-		void *addr __rte_unused)
+clb_pause(uint16_t port_id __rte_unused, uint16_t qidx __rte_unused,
+		struct rte_mbuf **pkts __rte_unused, uint16_t nb_rx,
+		uint16_t max_pkts __rte_unused, void *arg)
 {
-	struct pmd_queue_cfg *q_conf;
-
-	q_conf = &port_cfg[port_id][qidx];
-
-	if (unlikely(nb_rx == 0)) {
-		q_conf->empty_poll_stats++;
-		/* sleep for 1 microsecond */
-		if (unlikely(q_conf->empty_poll_stats > EMPTYPOLL_MAX)) {
-			/* use tpause if we have it */
-			if (global_data.intrinsics_support.power_pause) {
-				const uint64_t cur = rte_rdtsc();
-				const uint64_t wait_tsc =
-						cur + global_data.tsc_per_us;
-				rte_power_pause(wait_tsc);
-			} else {
-				uint64_t i;
-				for (i = 0; i < global_data.pause_per_us; i++)
-					rte_pause();
-			}
+	struct queue_list_entry *queue_conf = arg;
+	struct pmd_core_cfg *lcore_conf = queue_conf->lcore_cfg;
+
+	if (likely(nb_rx != 0)) {
+		queue_reset(lcore_conf, queue_conf);
+		return nb_rx;
+	}
+
+	/* sleep for 1 microsecond once all queues have been idle */
+	if (queue_can_sleep(lcore_conf, queue_conf) &&
+			lcore_can_sleep(lcore_conf)) {
+		/* use tpause if we have it */
+		if (global_data.intrinsics_support.power_pause) {
+			const uint64_t cur = rte_rdtsc();
+			const uint64_t wait_tsc =
+					cur + global_data.tsc_per_us;
+			rte_power_pause(wait_tsc);
+		} else {
+			uint64_t i;
+			for (i = 0; i < global_data.pause_per_us; i++)
+				rte_pause();
 		}
-	} else
-		q_conf->empty_poll_stats = 0;
+	}
 
 	return nb_rx;
 }
 
 static uint16_t
-clb_scale_freq(uint16_t port_id, uint16_t qidx,
+clb_scale_freq(uint16_t port_id __rte_unused, uint16_t qidx __rte_unused,
 		struct rte_mbuf **pkts __rte_unused, uint16_t nb_rx,
-		uint16_t max_pkts __rte_unused, void *_  __rte_unused)
+		uint16_t max_pkts __rte_unused, void *arg)
 {
-	struct pmd_queue_cfg *q_conf;
+	struct queue_list_entry *queue_conf = arg;
+	struct pmd_core_cfg *lcore_conf = queue_conf->lcore_cfg;
 
-	q_conf = &port_cfg[port_id][qidx];
-
-	if (unlikely(nb_rx == 0)) {
-		q_conf->empty_poll_stats++;
-		if (unlikely(q_conf->empty_poll_stats > EMPTYPOLL_MAX))
-			/* scale down freq */
-			rte_power_freq_min(rte_lcore_id());
-	} else {
-		q_conf->empty_poll_stats = 0;
+	if (likely(nb_rx != 0)) {
+		queue_reset(lcore_conf, queue_conf);
 		/* scale up freq */
 		rte_power_freq_max(rte_lcore_id());
+		return nb_rx;
 	}
 
+	/* scale down freq once all queues have been idle */
+	if (queue_can_sleep(lcore_conf, queue_conf) &&
+			lcore_can_sleep(lcore_conf))
+		rte_power_freq_min(rte_lcore_id());
+
 	return nb_rx;
 }
 
+static int
+check_monitor(struct pmd_core_cfg *cfg, const union queue *qdata)
+{
+	struct rte_power_monitor_cond dummy;
+
+	/* check if rte_power_monitor is supported */
+	if (!global_data.intrinsics_support.power_monitor) {
+		RTE_LOG(DEBUG, POWER, "Monitoring intrinsics are not supported\n");
+		return -ENOTSUP;
+	}
+
+	/* a second queue requires rte_power_monitor_multi */
+	if (cfg->n_queues > 0 &&
+			!global_data.intrinsics_support.power_monitor_multi) {
+		RTE_LOG(DEBUG, POWER, "Monitoring multiple queues is not supported\n");
+		return -ENOTSUP;
+	}
+
+	/* check if the device supports the necessary PMD API */
+	if (rte_eth_get_monitor_addr(qdata->portid, qdata->qid,
+			&dummy) == -ENOTSUP) {
+		RTE_LOG(DEBUG, POWER, "The device does not support rte_eth_get_monitor_addr\n");
+		return -ENOTSUP;
+	}
+
+	return 0;
+}
+
+static int
+check_scale(unsigned int lcore_id)
+{
+	enum power_management_env env;
+
+	/* only PSTATE and ACPI modes are supported */
+	if (!rte_power_check_env_supported(PM_ENV_ACPI_CPUFREQ) &&
+			!rte_power_check_env_supported(PM_ENV_PSTATE_CPUFREQ)) {
+		RTE_LOG(DEBUG, POWER, "Neither ACPI nor PSTATE modes are supported\n");
+		return -ENOTSUP;
+	}
+	/* ensure we could initialize the power library */
+	if (rte_power_init(lcore_id))
+		return -EINVAL;
+
+	/* ensure we initialized the correct env */
+	env = rte_power_get_env();
+	if (env != PM_ENV_ACPI_CPUFREQ && env != PM_ENV_PSTATE_CPUFREQ) {
+		RTE_LOG(DEBUG, POWER, "Neither ACPI nor PSTATE modes were initialized\n");
+		rte_power_exit(lcore_id);
+		return -ENOTSUP;
+	}
+
+	return 0;
+}
+
 int
 rte_power_ethdev_pmgmt_queue_enable(unsigned int lcore_id, uint16_t port_id,
 		uint16_t queue_id, enum rte_power_pmd_mgmt_type mode)
 {
-	struct pmd_queue_cfg *queue_cfg;
+	const union queue qdata = {.portid = port_id, .qid = queue_id};
+	struct queue_list_entry *queue_cfg;
+	struct pmd_core_cfg *lcore_cfg;
 	struct rte_eth_dev_info info;
+	rte_rx_callback_fn clb;
 	int ret;
 
 	RTE_ETH_VALID_PORTID_OR_ERR_RET(port_id, -EINVAL);
 
-	if (queue_id >= RTE_MAX_QUEUES_PER_PORT || lcore_id >= RTE_MAX_LCORE) {
-		ret = -EINVAL;
-		goto end;
-	}
+	if (queue_id >= RTE_MAX_QUEUES_PER_PORT || lcore_id >= RTE_MAX_LCORE)
+		return -EINVAL;
 
-	if (rte_eth_dev_info_get(port_id, &info) < 0) {
-		ret = -EINVAL;
-		goto end;
-	}
+	if (rte_eth_dev_info_get(port_id, &info) < 0)
+		return -EINVAL;
 
 	/* check if queue id is valid */
-	if (queue_id >= info.nb_rx_queues) {
-		ret = -EINVAL;
-		goto end;
+	if (queue_id >= info.nb_rx_queues)
+		return -EINVAL;
+
+	/* callbacks can only be changed while the queue is not polled */
+	ret = queue_stopped(port_id, queue_id);
+	if (ret != 1) {
+		/* error means invalid queue, 0 means queue wasn't stopped */
+		return ret < 0 ? -EINVAL : -EBUSY;
 	}
 
-	queue_cfg = &port_cfg[port_id][queue_id];
+	/* a queue can only be managed by a single lcore */
+	if (queue_lcore_find(&qdata) != NULL)
+		return -EINVAL;
 
-	if (queue_cfg->pwr_mgmt_state != PMD_MGMT_DISABLED) {
-		ret = -EINVAL;
-		goto end;
-	}
+	lcore_cfg = &lcore_cfgs[lcore_id];
+
+	/* all queues of an lcore must use the same mode */
+	if (lcore_cfg->n_queues > 0 && lcore_cfg->cb_mode != mode)
+		return -EINVAL;
 
 	/* we need this in various places */
 	rte_cpu_get_intrinsics_support(&global_data.intrinsics_support);
 
 	switch (mode) {
 	case RTE_POWER_MGMT_TYPE_MONITOR:
-	{
-		struct rte_power_monitor_cond dummy;
-
-		/* check if rte_power_monitor is supported */
-		if (!global_data.intrinsics_support.power_monitor) {
-			RTE_LOG(DEBUG, POWER, "Monitoring intrinsics are not supported\n");
-			ret = -ENOTSUP;
-			goto end;
-		}
-
-		/* check if the device supports the necessary PMD API */
-		if (rte_eth_get_monitor_addr(port_id, queue_id,
-				&dummy) == -ENOTSUP) {
-			RTE_LOG(DEBUG, POWER, "The device does not support rte_eth_get_monitor_addr\n");
-			ret = -ENOTSUP;
-			goto end;
-		}
-		/* initialize data before enabling the callback */
-		queue_cfg->empty_poll_stats = 0;
-		queue_cfg->cb_mode = mode;
-		queue_cfg->umwait_in_progress = false;
-		queue_cfg->pwr_mgmt_state = PMD_MGMT_ENABLED;
+		ret = check_monitor(lcore_cfg, &qdata);
+		if (ret < 0)
+			return ret;
 
-		/* ensure we update our state before callback starts */
-		rte_atomic_thread_fence(__ATOMIC_SEQ_CST);
-
-		queue_cfg->cur_cb = rte_eth_add_rx_callback(port_id, queue_id,
-				clb_umwait, NULL);
+		clb = clb_multiwait;
 		break;
-	}
 	case RTE_POWER_MGMT_TYPE_SCALE:
-	{
-		enum power_management_env env;
-		/* only PSTATE and ACPI modes are supported */
-		if (!rte_power_check_env_supported(PM_ENV_ACPI_CPUFREQ) &&
-				!rte_power_check_env_supported(
-					PM_ENV_PSTATE_CPUFREQ)) {
-			RTE_LOG(DEBUG, POWER, "Neither ACPI nor PSTATE modes are supported\n");
-			ret = -ENOTSUP;
-			goto end;
-		}
-		/* ensure we could initialize the power library */
-		if (rte_power_init(lcore_id)) {
-			ret = -EINVAL;
-			goto end;
+		/* the power library is initialized once per lcore */
+		if (lcore_cfg->n_queues == 0) {
+			ret = check_scale(lcore_id);
+			if (ret < 0)
+				return ret;
 		}
-		/* ensure we initialized the correct env */
-		env = rte_power_get_env();
-		if (env != PM_ENV_ACPI_CPUFREQ &&
-				env != PM_ENV_PSTATE_CPUFREQ) {
-			RTE_LOG(DEBUG, POWER, "Neither ACPI nor PSTATE modes were initialized\n");
-			ret = -ENOTSUP;
-			goto end;
-		}
-		/* initialize data before enabling the callback */
-		queue_cfg->empty_poll_stats = 0;
-		queue_cfg->cb_mode = mode;
-		queue_cfg->pwr_mgmt_state = PMD_MGMT_ENABLED;
-
-		/* this is not necessary here, but do it anyway */
-		rte_atomic_thread_fence(__ATOMIC_SEQ_CST);
 
-		queue_cfg->cur_cb = rte_eth_add_rx_callback(port_id,
-				queue_id, clb_scale_freq, NULL);
+		clb = clb_scale_freq;
 		break;
-	}
 	case RTE_POWER_MGMT_TYPE_PAUSE:
 		/* figure out various time-to-tsc conversions */
 		if (global_data.tsc_per_us == 0)
 			calc_tsc();
 
-		/* initialize data before enabling the callback */
-		queue_cfg->empty_poll_stats = 0;
-		queue_cfg->cb_mode = mode;
-		queue_cfg->pwr_mgmt_state = PMD_MGMT_ENABLED;
+		clb = clb_pause;
+		break;
+	default:
+		RTE_LOG(DEBUG, POWER, "Invalid power management type\n");
+		return -EINVAL;
+	}
 
-		/* this is not necessary here, but do it anyway */
-		rte_atomic_thread_fence(__ATOMIC_SEQ_CST);
+	/* initialize data before enabling the first callback of the lcore */
+	if (lcore_cfg->n_queues == 0) {
+		TAILQ_INIT(&lcore_cfg->head);
+		lcore_cfg->cb_mode = mode;
+		lcore_cfg->n_queues_ready_to_sleep = 0;
+		/* a zero sleep target would match a reset queue */
+		lcore_cfg->sleep_target = 1;
+	}
 
-		queue_cfg->cur_cb = rte_eth_add_rx_callback(port_id, queue_id,
-				clb_pause, NULL);
-		break;
+	queue_cfg = queue_list_add(lcore_cfg, &qdata);
+	if (queue_cfg == NULL) {
+		if (lcore_cfg->n_queues == 0 &&
+				mode == RTE_POWER_MGMT_TYPE_SCALE)
+			rte_power_exit(lcore_id);
+		return -ENOMEM;
 	}
-	ret = 0;
-end:
-	return ret;
+
+	lcore_cfg->pwr_mgmt_state = PMD_MGMT_ENABLED;
+
+	/* ensure we update our state before callback starts */
+	rte_atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+	queue_cfg->cb = rte_eth_add_rx_callback(port_id, queue_id, clb,
+			queue_cfg);
+
+	return 0;
 }
 
 int
 rte_power_ethdev_pmgmt_queue_disable(unsigned int lcore_id,
 		uint16_t port_id, uint16_t queue_id)
 {
-	struct pmd_queue_cfg *queue_cfg;
+	const union queue qdata = {.portid = port_id, .qid = queue_id};
+	struct queue_list_entry *queue_cfg;
+	struct pmd_core_cfg *lcore_cfg;
+	int ret;
 
 	RTE_ETH_VALID_PORTID_OR_ERR_RET(port_id, -EINVAL);
 
 	if (lcore_id >= RTE_MAX_LCORE || queue_id >= RTE_MAX_QUEUES_PER_PORT)
 		return -EINVAL;
 
-	/* no need to check queue id as wrong queue id would not be enabled */
-	queue_cfg = &port_cfg[port_id][queue_id];
+	/* callbacks can only be changed while the queue is not polled */
+	ret = queue_stopped(port_id, queue_id);
+	if (ret != 1) {
+		/* error means invalid queue, 0 means queue wasn't stopped */
+		return ret < 0 ? -EINVAL : -EBUSY;
+	}
 
-	if (queue_cfg->pwr_mgmt_state != PMD_MGMT_ENABLED)
+	/* no need to check queue id as wrong queue id would not be enabled */
+	lcore_cfg = &lcore_cfgs[lcore_id];
+	if (lcore_cfg->pwr_mgmt_state != PMD_MGMT_ENABLED)
 		return -EINVAL;
 
-	/* stop any callbacks from progressing */
-	queue_cfg->pwr_mgmt_state = PMD_MGMT_DISABLED;
+	queue_cfg = queue_list_find(lcore_cfg, &qdata);
+	if (queue_cfg == NULL)
+		return -ENOENT;
+
+	/* stop any callbacks from progressing once the last queue is gone */
+	if (lcore_cfg->n_queues == 1)
+		lcore_cfg->pwr_mgmt_state = PMD_MGMT_DISABLED;
 
 	/* ensure we update our state before continuing */
 	rte_atomic_thread_fence(__ATOMIC_SEQ_CST);
 
-	switch (queue_cfg->cb_mode) {
-	case RTE_POWER_MGMT_TYPE_MONITOR:
-	{
-		bool exit = false;
-		do {
-			/*
-			 * we may request cancellation while the other thread
-			 * has just entered the callback but hasn't started
-			 * sleeping yet, so keep waking it up until we know it's
-			 * done sleeping.
-			 */
-			if (queue_cfg->umwait_in_progress)
-				rte_power_monitor_wakeup(lcore_id);
-			else
-				exit = true;
-		} while (!exit);
-	}
-	/* fall-through */
-	case RTE_POWER_MGMT_TYPE_PAUSE:
-		rte_eth_remove_rx_callback(port_id, queue_id,
-				queue_cfg->cur_cb);
-		break;
-	case RTE_POWER_MGMT_TYPE_SCALE:
-		rte_power_freq_max(lcore_id);
-		rte_eth_remove_rx_callback(port_id, queue_id,
-				queue_cfg->cur_cb);
-		rte_power_exit(lcore_id);
-		break;
-	}
 	/*
 	 * we don't free the RX callback here because it is unsafe to do so
 	 * unless we know for a fact that all data plane threads have stopped.
 	 */
-	queue_cfg->cur_cb = NULL;
+	rte_eth_remove_rx_callback(port_id, queue_id, queue_cfg->cb);
+
+	/* the lcore may be sleeping on the address of this queue */
+	if (lcore_cfg->cb_mode == RTE_POWER_MGMT_TYPE_MONITOR)
+		rte_power_monitor_wakeup(lcore_id);
+
+	/* the removed queue may have been counted as ready to sleep */
+	if (queue_cfg->n_sleeps == lcore_cfg->sleep_target)
+		lcore_cfg->n_queues_ready_to_sleep--;
+	queue_list_remove(lcore_cfg, queue_cfg);
+
+	if (lcore_cfg->n_queues == 0 &&
+			lcore_cfg->cb_mode == RTE_POWER_MGMT_TYPE_SCALE) {
+		rte_power_freq_max(lcore_id);
+		rte_power_exit(lcore_id);
+	}
 
 	return 0;
 }
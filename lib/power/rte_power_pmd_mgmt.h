@@ -41,8 +41,15 @@ enum rte_power_pmd_mgmt_type {
  *
  * Enable power management on a specified Ethernet device Rx queue and lcore.
  *
+ * Multiple queues can be managed on the same lcore, as long as they all use
+ * the same power management scheme. The lcore only enters power optimized
+ * state once all of its queues have been idle.
+ *
  * @note This function is not thread-safe.
  *
+ * @warning This function must be called when the queue is stopped, or the
+ *   port is not started.
+ *
  * @param lcore_id
  *   The lcore the Rx queue will be polled from.
  * @param port_id
@@ -69,6 +76,9 @@ rte_power_ethdev_pmgmt_queue_enable(unsigned int lcore_id,
  *
  * @note This function is not thread-safe.
  *
+ * @warning This function must be called when the queue is stopped, or the
+ *   port is not started.
+ *
  * @param lcore_id
  *   The lcore the Rx queue is polled from.
  * @param port_id
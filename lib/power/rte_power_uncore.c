@@ -0,0 +1,627 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <dirent.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <rte_common.h>
+#include <rte_ethdev.h>
+#include <rte_log.h>
+#include <rte_mempool.h>
+#include <rte_ring.h>
+#include <rte_telemetry.h>
+
+#include "rte_power_uncore.h"
+
+#define UNCORE_MAX_DIES 8
+#define UNCORE_BUS_FREQ 100000
+
+#define UNCORE_SYSFS_DIR "/sys/devices/system/cpu/intel_uncore_frequency"
+#define UNCORE_DIE_NAME "package_%02u_die_%02u"
+#define UNCORE_SYSFILE_MAX_FREQ "max_freq_khz"
+#define UNCORE_SYSFILE_MIN_FREQ "min_freq_khz"
+#define UNCORE_SYSFILE_BASE_MAX_FREQ "initial_max_freq_khz"
+#define UNCORE_SYSFILE_BASE_MIN_FREQ "initial_min_freq_khz"
+
+struct uncore_load_src {
+	struct rte_power_uncore_load_src src;
+	uint16_t nb_desc; /**< Rx queue size */
+};
+
+struct uncore_power_info {
+	bool init;                  /**< Die is initialized */
+	FILE *f_cur_min;            /**< Minimum frequency sysfs file */
+	FILE *f_cur_max;            /**< Maximum frequency sysfs file */
+	uint32_t org_min_freq;      /**< Original minimum frequency */
+	uint32_t org_max_freq;      /**< Original maximum frequency */
+	uint32_t freqs[RTE_POWER_UNCORE_MAX_FREQS]; /**< Frequencies, in kHz */
+	uint32_t nb_freqs;          /**< Number of frequencies */
+	uint32_t curr_idx;          /**< Current frequency index */
+
+	struct rte_power_uncore_policy policy; /**< Scaling policy */
+	struct uncore_load_src srcs[RTE_POWER_UNCORE_MAX_LOAD_SRCS];
+	uint32_t nb_srcs;           /**< Number of load sources */
+	uint32_t n_low_updates;     /**< Consecutive low load updates */
+	uint32_t last_load;         /**< Load of the last update */
+	uint64_t n_ups;             /**< Number of frequency raises */
+	uint64_t n_downs;           /**< Number of frequency drops */
+} __rte_cache_aligned;
+
+static struct uncore_power_info uncore_info[RTE_MAX_NUMA_NODES][UNCORE_MAX_DIES];
+
+static const struct rte_power_uncore_policy default_policy = {
+	.high_watermark = 75,
+	.low_watermark = 25,
+	.down_delay = 10,
+};
+
+static struct uncore_power_info *
+uncore_info_get(unsigned int pkg, unsigned int die)
+{
+	if (pkg >= RTE_MAX_NUMA_NODES || die >= UNCORE_MAX_DIES)
+		return NULL;
+
+	return &uncore_info[pkg][die];
+}
+
+static struct uncore_power_info *
+uncore_info_get_init(unsigned int pkg, unsigned int die)
+{
+	struct uncore_power_info *ui = uncore_info_get(pkg, die);
+
+	if (ui == NULL || !ui->init)
+		return NULL;
+
+	return ui;
+}
+
+static void
+sysfs_path(char *path, size_t len, const char *file, unsigned int pkg,
+		unsigned int die)
+{
+	snprintf(path, len, UNCORE_SYSFS_DIR "/" UNCORE_DIE_NAME "/%s",
+			pkg, die, file);
+}
+
+static int
+read_sysfs_freq(const char *file, unsigned int pkg, unsigned int die,
+		uint32_t *freq)
+{
+	char path[PATH_MAX];
+	FILE *f;
+	int ret;
+
+	sysfs_path(path, sizeof(path), file, pkg, die);
+	f = fopen(path, "r");
+	if (f == NULL) {
+		RTE_LOG(DEBUG, POWER, "Failed to open %s\n", path);
+		return -1;
+	}
+	ret = fscanf(f, "%" SCNu32, freq);
+	fclose(f);
+
+	return ret == 1 ? 0 : -1;
+}
+
+static FILE *
+open_sysfs_freq(const char *file, unsigned int pkg, unsigned int die)
+{
+	char path[PATH_MAX];
+	FILE *f;
+
+	sysfs_path(path, sizeof(path), file, pkg, die);
+	f = fopen(path, "r+");
+	if (f == NULL)
+		RTE_LOG(ERR, POWER, "Failed to open %s\n", path);
+
+	return f;
+}
+
+static int
+write_sysfs_freq(FILE *f, uint32_t freq)
+{
+	if (fseek(f, 0, SEEK_SET) < 0 ||
+			fprintf(f, "%" PRIu32, freq) < 0 ||
+			fflush(f) < 0)
+		return -1;
+
+	return 0;
+}
+
+/*
+ * The minimum frequency must never exceed the maximum one, so the maximum is
+ * written first when raising the frequency, and last when lowering it.
+ */
+static int
+set_uncore_min_max(struct uncore_power_info *ui, uint32_t min_freq,
+		uint32_t max_freq, bool raise)
+{
+	int ret;
+
+	if (raise) {
+		ret = write_sysfs_freq(ui->f_cur_max, max_freq);
+		if (ret == 0)
+			ret = write_sysfs_freq(ui->f_cur_min, min_freq);
+	} else {
+		ret = write_sysfs_freq(ui->f_cur_min, min_freq);
+		if (ret == 0)
+			ret = write_sysfs_freq(ui->f_cur_max, max_freq);
+	}
+	if (ret < 0)
+		RTE_LOG(ERR, POWER, "Failed to write uncore frequency %u\n",
+				max_freq);
+
+	return ret;
+}
+
+static int
+set_uncore_freq_internal(struct uncore_power_info *ui, uint32_t idx)
+{
+	const uint32_t freq = ui->freqs[idx];
+
+	if (idx == ui->curr_idx)
+		return 0;
+
+	/* frequencies are sorted from the highest one */
+	if (set_uncore_min_max(ui, freq, freq, idx < ui->curr_idx) < 0)
+		return -EIO;
+
+	if (idx < ui->curr_idx)
+		ui->n_ups++;
+	else
+		ui->n_downs++;
+	ui->curr_idx = idx;
+
+	return 1;
+}
+
+int
+rte_power_uncore_init(unsigned int pkg, unsigned int die)
+{
+	struct uncore_power_info *ui = uncore_info_get(pkg, die);
+	uint32_t base_min, base_max, freq;
+	int ret;
+
+	if (ui == NULL)
+		return -EINVAL;
+
+	if (ui->init) {
+		RTE_LOG(INFO, POWER, "Uncore of package %u die %u is already initialized\n",
+				pkg, die);
+		return -EBUSY;
+	}
+
+	if (read_sysfs_freq(UNCORE_SYSFILE_BASE_MAX_FREQ, pkg, die,
+				&base_max) < 0 ||
+			read_sysfs_freq(UNCORE_SYSFILE_BASE_MIN_FREQ, pkg, die,
+				&base_min) < 0 ||
+			read_sysfs_freq(UNCORE_SYSFILE_MAX_FREQ, pkg, die,
+				&ui->org_max_freq) < 0 ||
+			read_sysfs_freq(UNCORE_SYSFILE_MIN_FREQ, pkg, die,
+				&ui->org_min_freq) < 0) {
+		RTE_LOG(ERR, POWER, "Uncore frequency control of package %u die %u is not available\n",
+				pkg, die);
+		return -ENOTSUP;
+	}
+
+	if (base_min > base_max)
+		return -EINVAL;
+
+	ui->f_cur_max = open_sysfs_freq(UNCORE_SYSFILE_MAX_FREQ, pkg, die);
+	ui->f_cur_min = open_sysfs_freq(UNCORE_SYSFILE_MIN_FREQ, pkg, die);
+	if (ui->f_cur_max == NULL || ui->f_cur_min == NULL) {
+		ret = -EIO;
+		goto err;
+	}
+
+	/* the frequencies are steps of the bus frequency */
+	ui->nb_freqs = 0;
+	for (freq = base_max; freq >= base_min &&
+			ui->nb_freqs < RTE_POWER_UNCORE_MAX_FREQS;
+			freq -= UNCORE_BUS_FREQ) {
+		ui->freqs[ui->nb_freqs++] = freq;
+		if (freq < base_min + UNCORE_BUS_FREQ)
+			break;
+	}
+
+	/* start at the highest frequency, a policy lowers it at low load */
+	if (set_uncore_min_max(ui, ui->freqs[0], ui->freqs[0], true) < 0) {
+		ret = -EIO;
+		goto err;
+	}
+	ui->curr_idx = 0;
+
+	ui->policy = default_policy;
+	ui->nb_srcs = 0;
+	ui->n_low_updates = 0;
+	ui->last_load = 0;
+	ui->n_ups = 0;
+	ui->n_downs = 0;
+	ui->init = true;
+
+	RTE_LOG(INFO, POWER, "Initialized uncore of package %u die %u, %u frequencies\n",
+			pkg, die, ui->nb_freqs);
+
+	return 0;
+
+err:
+	if (ui->f_cur_max != NULL)
+		fclose(ui->f_cur_max);
+	if (ui->f_cur_min != NULL)
+		fclose(ui->f_cur_min);
+	ui->f_cur_max = NULL;
+	ui->f_cur_min = NULL;
+	return ret;
+}
+
+int
+rte_power_uncore_exit(unsigned int pkg, unsigned int die)
+{
+	struct uncore_power_info *ui = uncore_info_get_init(pkg, die);
+	int ret;
+
+	if (ui == NULL)
+		return -EINVAL;
+
+	/* restore the original frequencies, raising the max first if needed */
+	ret = set_uncore_min_max(ui, ui->org_min_freq, ui->org_max_freq,
+			ui->org_max_freq >= ui->freqs[ui->curr_idx]);
+
+	fclose(ui->f_cur_max);
+	fclose(ui->f_cur_min);
+	ui->f_cur_max = NULL;
+	ui->f_cur_min = NULL;
+	ui->init = false;
+
+	return ret < 0 ? -EIO : 0;
+}
+
+int
+rte_power_uncore_freqs(unsigned int pkg, unsigned int die, uint32_t *freqs,
+		uint32_t num)
+{
+	struct uncore_power_info *ui = uncore_info_get_init(pkg, die);
+
+	if (ui == NULL)
+		return -EINVAL;
+
+	if (freqs != NULL)
+		memcpy(freqs, ui->freqs,
+				RTE_MIN(num, ui->nb_freqs) * sizeof(freqs[0]));
+
+	return ui->nb_freqs;
+}
+
+int
+rte_power_get_uncore_freq(unsigned int pkg, unsigned int die)
+{
+	struct uncore_power_info *ui = uncore_info_get_init(pkg, die);
+
+	if (ui == NULL)
+		return -EINVAL;
+
+	return ui->curr_idx;
+}
+
+int
+rte_power_set_uncore_freq(unsigned int pkg, unsigned int die, uint32_t index)
+{
+	struct uncore_power_info *ui = uncore_info_get_init(pkg, die);
+
+	if (ui == NULL || index >= ui->nb_freqs)
+		return -EINVAL;
+
+	return set_uncore_freq_internal(ui, index);
+}
+
+int
+rte_power_uncore_freq_max(unsigned int pkg, unsigned int die)
+{
+	return rte_power_set_uncore_freq(pkg, die, 0);
+}
+
+int
+rte_power_uncore_freq_min(unsigned int pkg, unsigned int die)
+{
+	struct uncore_power_info *ui = uncore_info_get_init(pkg, die);
+
+	if (ui == NULL)
+		return -EINVAL;
+
+	return set_uncore_freq_internal(ui, ui->nb_freqs - 1);
+}
+
+/* count the packages, or the dies of a package, found in sysfs */
+static unsigned int
+uncore_dies_scan(unsigned int pkg, bool count_dies)
+{
+	unsigned int n = 0, p, d;
+	struct dirent *dent;
+	DIR *dir;
+
+	dir = opendir(UNCORE_SYSFS_DIR);
+	if (dir == NULL)
+		return 0;
+
+	while ((dent = readdir(dir)) != NULL) {
+		if (sscanf(dent->d_name, UNCORE_DIE_NAME, &p, &d) != 2)
+			continue;
+		if (count_dies) {
+			if (p == pkg)
+				n++;
+		} else {
+			n = RTE_MAX(n, p + 1);
+		}
+	}
+	closedir(dir);
+
+	return n;
+}
+
+unsigned int
+rte_power_uncore_get_num_pkgs(void)
+{
+	return uncore_dies_scan(0, false);
+}
+
+unsigned int
+rte_power_uncore_get_num_dies(unsigned int pkg)
+{
+	return uncore_dies_scan(pkg, true);
+}
+
+int
+rte_power_uncore_policy_set(unsigned int pkg, unsigned int die,
+		const struct rte_power_uncore_policy *policy)
+{
+	struct uncore_power_info *ui = uncore_info_get_init(pkg, die);
+
+	if (ui == NULL || policy == NULL ||
+			policy->high_watermark > 100 ||
+			policy->low_watermark >= policy->high_watermark)
+		return -EINVAL;
+
+	ui->policy = *policy;
+	ui->n_low_updates = 0;
+
+	return 0;
+}
+
+static bool
+load_src_equal(const struct rte_power_uncore_load_src *l,
+		const struct rte_power_uncore_load_src *r)
+{
+	if (l->type != r->type)
+		return false;
+
+	switch (l->type) {
+	case RTE_POWER_UNCORE_LOAD_RXQ:
+		return l->rxq.port_id == r->rxq.port_id &&
+			l->rxq.queue_id == r->rxq.queue_id;
+	case RTE_POWER_UNCORE_LOAD_RING:
+		return l->ring == r->ring;
+	case RTE_POWER_UNCORE_LOAD_MEMPOOL:
+		return l->mp == r->mp;
+	}
+
+	return false;
+}
+
+static int
+load_src_find(const struct uncore_power_info *ui,
+		const struct rte_power_uncore_load_src *src)
+{
+	uint32_t i;
+
+	for (i = 0; i < ui->nb_srcs; i++) {
+		if (load_src_equal(&ui->srcs[i].src, src))
+			return i;
+	}
+
+	return -1;
+}
+
+int
+rte_power_uncore_load_src_add(unsigned int pkg, unsigned int die,
+		const struct rte_power_uncore_load_src *src)
+{
+	struct uncore_power_info *ui = uncore_info_get_init(pkg, die);
+	struct rte_eth_rxq_info qinfo;
+	struct uncore_load_src *s;
+	int ret;
+
+	if (ui == NULL || src == NULL)
+		return -EINVAL;
+
+	if (load_src_find(ui, src) >= 0)
+		return -EEXIST;
+
+	if (ui->nb_srcs == RTE_POWER_UNCORE_MAX_LOAD_SRCS)
+		return -ENOSPC;
+
+	s = &ui->srcs[ui->nb_srcs];
+	memset(s, 0, sizeof(*s));
+
+	switch (src->type) {
+	case RTE_POWER_UNCORE_LOAD_RXQ:
+		ret = rte_eth_rx_queue_info_get(src->rxq.port_id,
+				src->rxq.queue_id, &qinfo);
+		if (ret < 0)
+			return ret;
+		if (qinfo.nb_desc == 0)
+			return -EINVAL;
+
+		ret = rte_eth_rx_queue_count(src->rxq.port_id,
+				src->rxq.queue_id);
+		if (ret < 0)
+			return ret;
+
+		s->nb_desc = qinfo.nb_desc;
+		break;
+	case RTE_POWER_UNCORE_LOAD_RING:
+		if (src->ring == NULL)
+			return -EINVAL;
+		break;
+	case RTE_POWER_UNCORE_LOAD_MEMPOOL:
+		if (src->mp == NULL || src->mp->size == 0)
+			return -EINVAL;
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	s->src = *src;
+	ui->nb_srcs++;
+
+	return 0;
+}
+
+int
+rte_power_uncore_load_src_remove(unsigned int pkg, unsigned int die,
+		const struct rte_power_uncore_load_src *src)
+{
+	struct uncore_power_info *ui = uncore_info_get_init(pkg, die);
+	int i;
+
+	if (ui == NULL || src == NULL)
+		return -EINVAL;
+
+	i = load_src_find(ui, src);
+	if (i < 0)
+		return -ENOENT;
+
+	/* the order of the sources does not matter */
+	ui->srcs[i] = ui->srcs[--ui->nb_srcs];
+
+	return 0;
+}
+
+/* occupancy of a load source, in percent of its capacity */
+static uint32_t
+load_src_get(const struct uncore_load_src *s)
+{
+	const struct rte_power_uncore_load_src *src = &s->src;
+	unsigned int used, capacity;
+	int ret;
+
+	switch (src->type) {
+	case RTE_POWER_UNCORE_LOAD_RXQ:
+		ret = rte_eth_rx_queue_count(src->rxq.port_id,
+				src->rxq.queue_id);
+		if (ret < 0)
+			return 0;
+		used = ret;
+		capacity = s->nb_desc;
+		break;
+	case RTE_POWER_UNCORE_LOAD_RING:
+		used = rte_ring_count(src->ring);
+		capacity = rte_ring_get_capacity(src->ring);
+		break;
+	case RTE_POWER_UNCORE_LOAD_MEMPOOL:
+		used = rte_mempool_in_use_count(src->mp);
+		capacity = src->mp->size;
+		break;
+	default:
+		return 0;
+	}
+
+	if (capacity == 0)
+		return 0;
+
+	return RTE_MIN(100U, used * 100U / capacity);
+}
+
+int
+rte_power_uncore_policy_update(unsigned int pkg, unsigned int die)
+{
+	struct uncore_power_info *ui = uncore_info_get_init(pkg, die);
+	uint32_t load = 0, i;
+	int ret;
+
+	if (ui == NULL)
+		return -EINVAL;
+
+	for (i = 0; i < ui->nb_srcs; i++)
+		load = RTE_MAX(load, load_src_get(&ui->srcs[i]));
+	ui->last_load = load;
+
+	if (load >= ui->policy.high_watermark) {
+		/* go to the highest frequency at once to absorb bursts */
+		ui->n_low_updates = 0;
+		ret = set_uncore_freq_internal(ui, 0);
+	} else if (load < ui->policy.low_watermark) {
+		/* step down slowly, only after a sustained low load */
+		ret = 0;
+		if (++ui->n_low_updates >= ui->policy.down_delay) {
+			ui->n_low_updates = 0;
+			if (ui->curr_idx + 1 < ui->nb_freqs)
+				ret = set_uncore_freq_internal(ui,
+						ui->curr_idx + 1);
+		}
+	} else {
+		ui->n_low_updates = 0;
+		ret = 0;
+	}
+
+	return ret < 0 ? ret : (int)ui->curr_idx;
+}
+
+static int
+uncore_handle_info(const char *cmd __rte_unused, const char *params,
+		struct rte_tel_data *d)
+{
+	const struct uncore_power_info *ui;
+	unsigned int pkg, die;
+	char name[32];
+
+	/* without parameters, list the initialized dies */
+	if (params == NULL || strlen(params) == 0) {
+		rte_tel_data_start_array(d, RTE_TEL_STRING_VAL);
+		for (pkg = 0; pkg < RTE_MAX_NUMA_NODES; pkg++) {
+			for (die = 0; die < UNCORE_MAX_DIES; die++) {
+				if (!uncore_info[pkg][die].init)
+					continue;
+				snprintf(name, sizeof(name), "%u,%u", pkg, die);
+				rte_tel_data_add_array_string(d, name);
+			}
+		}
+		return 0;
+	}
+
+	if (sscanf(params, "%u,%u", &pkg, &die) != 2)
+		return -EINVAL;
+
+	ui = uncore_info_get_init(pkg, die);
+	if (ui == NULL)
+		return -EINVAL;
+
+	rte_tel_data_start_dict(d);
+	rte_tel_data_add_dict_u64(d, "freq_khz", ui->freqs[ui->curr_idx]);
+	rte_tel_data_add_dict_u64(d, "freq_index", ui->curr_idx);
+	rte_tel_data_add_dict_u64(d, "max_freq_khz", ui->freqs[0]);
+	rte_tel_data_add_dict_u64(d, "min_freq_khz",
+			ui->freqs[ui->nb_freqs - 1]);
+	rte_tel_data_add_dict_u64(d, "load", ui->last_load);
+	rte_tel_data_add_dict_u64(d, "high_watermark",
+			ui->policy.high_watermark);
+	rte_tel_data_add_dict_u64(d, "low_watermark",
+			ui->policy.low_watermark);
+	rte_tel_data_add_dict_u64(d, "down_delay", ui->policy.down_delay);
+	rte_tel_data_add_dict_u64(d, "load_sources", ui->nb_srcs);
+	rte_tel_data_add_dict_u64(d, "freq_ups", ui->n_ups);
+	rte_tel_data_add_dict_u64(d, "freq_downs", ui->n_downs);
+
+	return 0;
+}
+
+RTE_INIT(power_uncore_init_telemetry)
+{
+	rte_telemetry_register_cmd("/power/uncore", uncore_handle_info,
+			"Returns the uncore frequency state of a die, or the list of managed dies. Parameters: int pkg, int die");
+}
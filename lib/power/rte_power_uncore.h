@@ -0,0 +1,325 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#ifndef _RTE_POWER_UNCORE_H
+#define _RTE_POWER_UNCORE_H
+
+/**
+ * @file
+ * RTE Uncore Frequency Management
+ *
+ * The uncore frequency of each die of each package is controlled through the
+ * Linux intel_uncore_frequency driver. On top of it, a policy scales the
+ * uncore frequency of a die according to the occupancy of a set of load
+ * sources: Ethernet device Rx queues, rings and mempools.
+ */
+
+#include <stdint.h>
+
+#include <rte_compat.h>
+#include <rte_mempool.h>
+#include <rte_ring.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Maximum number of uncore frequencies of a die. */
+#define RTE_POWER_UNCORE_MAX_FREQS 32
+
+/** Maximum number of load sources of a die. */
+#define RTE_POWER_UNCORE_MAX_LOAD_SRCS 64
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change, or be removed, without prior notice.
+ *
+ * Initialize uncore frequency management of a die. The original minimum and
+ * maximum uncore frequencies are saved, and the die is set to its highest
+ * uncore frequency.
+ *
+ * @param pkg
+ *   Package number.
+ * @param die
+ *   Die number, within the package.
+ * @return
+ *   0 on success, negative errno value on failure.
+ */
+__rte_experimental
+int
+rte_power_uncore_init(unsigned int pkg, unsigned int die);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change, or be removed, without prior notice.
+ *
+ * Exit uncore frequency management of a die, restoring its original minimum
+ * and maximum uncore frequencies. Its policy and load sources are removed.
+ *
+ * @param pkg
+ *   Package number.
+ * @param die
+ *   Die number, within the package.
+ * @return
+ *   0 on success, negative errno value on failure.
+ */
+__rte_experimental
+int
+rte_power_uncore_exit(unsigned int pkg, unsigned int die);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change, or be removed, without prior notice.
+ *
+ * Get the uncore frequencies of a die, in kHz, from the highest to the
+ * lowest one.
+ *
+ * @param pkg
+ *   Package number.
+ * @param die
+ *   Die number, within the package.
+ * @param freqs
+ *   Array filled with the frequencies, may be NULL to only get their number.
+ * @param num
+ *   Length of the freqs array.
+ * @return
+ *   Number of uncore frequencies of the die, which may be greater than num,
+ *   negative errno value on failure.
+ */
+__rte_experimental
+int
+rte_power_uncore_freqs(unsigned int pkg, unsigned int die, uint32_t *freqs,
+		uint32_t num);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change, or be removed, without prior notice.
+ *
+ * Get the index of the current uncore frequency of a die.
+ *
+ * @param pkg
+ *   Package number.
+ * @param die
+ *   Die number, within the package.
+ * @return
+ *   Frequency index, in the array given by rte_power_uncore_freqs(),
+ *   negative errno value on failure.
+ */
+__rte_experimental
+int
+rte_power_get_uncore_freq(unsigned int pkg, unsigned int die);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change, or be removed, without prior notice.
+ *
+ * Set the uncore frequency of a die.
+ *
+ * @param pkg
+ *   Package number.
+ * @param die
+ *   Die number, within the package.
+ * @param index
+ *   Frequency index, in the array given by rte_power_uncore_freqs().
+ * @return
+ *   1 if the frequency was changed, 0 if it was already set,
+ *   negative errno value on failure.
+ */
+__rte_experimental
+int
+rte_power_set_uncore_freq(unsigned int pkg, unsigned int die, uint32_t index);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change, or be removed, without prior notice.
+ *
+ * Set the uncore frequency of a die to its highest value.
+ *
+ * @param pkg
+ *   Package number.
+ * @param die
+ *   Die number, within the package.
+ * @return
+ *   1 if the frequency was changed, 0 if it was already set,
+ *   negative errno value on failure.
+ */
+__rte_experimental
+int
+rte_power_uncore_freq_max(unsigned int pkg, unsigned int die);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change, or be removed, without prior notice.
+ *
+ * Set the uncore frequency of a die to its lowest value.
+ *
+ * @param pkg
+ *   Package number.
+ * @param die
+ *   Die number, within the package.
+ * @return
+ *   1 if the frequency was changed, 0 if it was already set,
+ *   negative errno value on failure.
+ */
+__rte_experimental
+int
+rte_power_uncore_freq_min(unsigned int pkg, unsigned int die);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change, or be removed, without prior notice.
+ *
+ * Get the number of packages with uncore frequency control.
+ *
+ * @return
+ *   Number of packages, 0 if uncore frequency control is not available.
+ */
+__rte_experimental
+unsigned int
+rte_power_uncore_get_num_pkgs(void);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change, or be removed, without prior notice.
+ *
+ * Get the number of dies of a package with uncore frequency control.
+ *
+ * @param pkg
+ *   Package number.
+ * @return
+ *   Number of dies, 0 if uncore frequency control is not available.
+ */
+__rte_experimental
+unsigned int
+rte_power_uncore_get_num_dies(unsigned int pkg);
+
+/**
+ * Uncore load source type.
+ */
+enum rte_power_uncore_load_type {
+	/** Descriptors used in an Ethernet device Rx queue */
+	RTE_POWER_UNCORE_LOAD_RXQ,
+	/** Objects enqueued in a ring */
+	RTE_POWER_UNCORE_LOAD_RING,
+	/** Objects in use from a mempool */
+	RTE_POWER_UNCORE_LOAD_MEMPOOL,
+};
+
+/**
+ * Uncore load source, whose occupancy is a percentage of its capacity.
+ */
+struct rte_power_uncore_load_src {
+	enum rte_power_uncore_load_type type; /**< Load source type */
+	RTE_STD_C11
+	union {
+		struct {
+			uint16_t port_id;  /**< Ethernet device port id */
+			uint16_t queue_id; /**< Rx queue id */
+		} rxq; /**< RTE_POWER_UNCORE_LOAD_RXQ source */
+		const struct rte_ring *ring; /**< RTE_POWER_UNCORE_LOAD_RING */
+		const struct rte_mempool *mp; /**< RTE_POWER_UNCORE_LOAD_MEMPOOL */
+	};
+};
+
+/**
+ * Uncore frequency scaling policy.
+ *
+ * The load of a die is the occupancy of its most loaded source, so that a
+ * burst on a single source is not averaged away. At or above the high
+ * watermark, the highest uncore frequency is set at once. Below the low
+ * watermark for down_delay consecutive updates, the uncore frequency is
+ * lowered by one step.
+ */
+struct rte_power_uncore_policy {
+	uint8_t high_watermark; /**< Load percentage setting the max freq */
+	uint8_t low_watermark;  /**< Load percentage lowering the freq */
+	uint32_t down_delay;    /**< Low load updates before lowering freq */
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change, or be removed, without prior notice.
+ *
+ * Set the uncore frequency scaling policy of a die.
+ *
+ * @param pkg
+ *   Package number.
+ * @param die
+ *   Die number, within the package.
+ * @param policy
+ *   Scaling policy, the low watermark must be lower than the high one, which
+ *   must not exceed 100.
+ * @return
+ *   0 on success, negative errno value on failure.
+ */
+__rte_experimental
+int
+rte_power_uncore_policy_set(unsigned int pkg, unsigned int die,
+		const struct rte_power_uncore_policy *policy);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change, or be removed, without prior notice.
+ *
+ * Add a load source to the uncore frequency scaling policy of a die.
+ *
+ * @param pkg
+ *   Package number.
+ * @param die
+ *   Die number, within the package.
+ * @param src
+ *   Load source. An Rx queue must be set up, and its device must support
+ *   rte_eth_rx_queue_count().
+ * @return
+ *   0 on success, negative errno value on failure.
+ */
+__rte_experimental
+int
+rte_power_uncore_load_src_add(unsigned int pkg, unsigned int die,
+		const struct rte_power_uncore_load_src *src);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change, or be removed, without prior notice.
+ *
+ * Remove a load source from the uncore frequency scaling policy of a die.
+ *
+ * @param pkg
+ *   Package number.
+ * @param die
+ *   Die number, within the package.
+ * @param src
+ *   Load source.
+ * @return
+ *   0 on success, negative errno value on failure.
+ */
+__rte_experimental
+int
+rte_power_uncore_load_src_remove(unsigned int pkg, unsigned int die,
+		const struct rte_power_uncore_load_src *src);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change, or be removed, without prior notice.
+ *
+ * Sample the load sources of a die and scale its uncore frequency according
+ * to its policy. It is meant to be called periodically, e.g. from a timer or
+ * a service, on a single thread.
+ *
+ * @param pkg
+ *   Package number.
+ * @param die
+ *   Die number, within the package.
+ * @return
+ *   Index of the uncore frequency set, negative errno value on failure.
+ */
+__rte_experimental
+int
+rte_power_uncore_policy_update(unsigned int pkg, unsigned int die);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_POWER_UNCORE_H */
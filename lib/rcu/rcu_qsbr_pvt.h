@@ -27,6 +27,12 @@ extern "C" {
 struct rte_rcu_qsbr_dq {
 	struct rte_rcu_qsbr *v; /**< RCU QSBR variable used by this queue.*/
 	struct rte_ring *r;     /**< RCU QSBR defer queue. */
+	struct rte_ring *lcore_r[RTE_MAX_LCORE];
+	/**< Per lcore defer queues, NULL if the lcore uses 'r'. */
+	uint32_t flags;
+	/**< Flags given at creation. */
+	uint32_t service_id;
+	/**< Reclamation service, if RTE_RCU_QSBR_DQ_RECLAIM_SERVICE. */
 	uint32_t size;
 	/**< Number of elements in the defer queue */
 	uint32_t esize;
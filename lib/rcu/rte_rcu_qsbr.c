@@ -19,6 +19,8 @@
 #include <rte_lcore.h>
 #include <rte_errno.h>
 #include <rte_ring_elem.h>
+#include <rte_service.h>
+#include <rte_service_component.h>
 
 #include "rte_rcu_qsbr.h"
 #include "rcu_qsbr_pvt.h"
@@ -272,15 +274,157 @@ rte_rcu_qsbr_dump(FILE *f, struct rte_rcu_qsbr *v)
 	return 0;
 }
 
+/* Maximum number of resources checked and reclaimed at once. */
+#define RCU_QSBR_DQ_RECLAIM_BURST 32U
+/* Bound of the stack buffer holding a burst of resources. */
+#define RCU_QSBR_DQ_RECLAIM_BUF_SIZE 4096U
+
+/* Get the defer queue of the calling thread. */
+static inline struct rte_ring *
+dq_ring_get(const struct rte_rcu_qsbr_dq *dq)
+{
+	unsigned int lcore_id = rte_lcore_id();
+
+	if (lcore_id < RTE_MAX_LCORE && dq->lcore_r[lcore_id] != NULL)
+		return dq->lcore_r[lcore_id];
+	return dq->r;
+}
+
+/* Reclaim at the max n resources from one ring of the defer queue.
+ * The resources are dequeued in bursts and the newest token of a burst
+ * is checked first, so that a single scan of the reader threads allows
+ * to reclaim the whole burst.
+ */
+static uint32_t
+dq_reclaim_ring(struct rte_rcu_qsbr_dq *dq, struct rte_ring *r, uint32_t n)
+{
+	__rte_rcu_qsbr_dq_elem_t *dq_elem;
+	uint32_t burst, cnt, nb, ok, i;
+	uint64_t max_token;
+
+	burst = RTE_MIN(RCU_QSBR_DQ_RECLAIM_BURST,
+		RTE_MAX(1u, RCU_QSBR_DQ_RECLAIM_BUF_SIZE / dq->esize));
+	char data[dq->esize * burst];
+
+	cnt = 0;
+	while (cnt < n) {
+		nb = rte_ring_dequeue_burst_elem_start(r, &data, dq->esize,
+				RTE_MIN(burst, n - cnt), NULL);
+		if (nb == 0)
+			break;
+
+		max_token = 0;
+		for (i = 0; i < nb; i++) {
+			dq_elem = (__rte_rcu_qsbr_dq_elem_t *)
+				(data + i * dq->esize);
+			max_token = RTE_MAX(max_token, dq_elem->token);
+		}
+		/* Check reader threads quiescent state. The tokens might be
+		 * out of order if several writers share the ring, fall back
+		 * to check them one by one.
+		 */
+		if (rte_rcu_qsbr_check(dq->v, max_token, false) == 1) {
+			ok = nb;
+		} else {
+			for (ok = 0; ok < nb; ok++) {
+				dq_elem = (__rte_rcu_qsbr_dq_elem_t *)
+					(data + ok * dq->esize);
+				if (rte_rcu_qsbr_check(dq->v, dq_elem->token,
+						false) != 1)
+					break;
+			}
+		}
+		rte_ring_dequeue_elem_finish(r, ok);
+
+		/* Reclaim the resources */
+		for (i = 0; i < ok; i++) {
+			dq_elem = (__rte_rcu_qsbr_dq_elem_t *)
+				(data + i * dq->esize);
+			rte_log(RTE_LOG_INFO, rte_rcu_log_type,
+				"%s(): Reclaimed token = %" PRIu64 "\n",
+				__func__, dq_elem->token);
+			dq->free_fn(dq->p, dq_elem->elem, 1);
+		}
+		cnt += ok;
+
+		if (ok < nb)
+			break;
+	}
+
+	return cnt;
+}
+
+/* Reclaim at the max n resources from all the rings of the defer queue,
+ * starting with the ring of the calling thread.
+ */
+static uint32_t
+dq_reclaim_all(struct rte_rcu_qsbr_dq *dq, uint32_t n)
+{
+	struct rte_ring *own = dq_ring_get(dq);
+	uint32_t cnt;
+	unsigned int i;
+
+	cnt = dq_reclaim_ring(dq, own, n);
+	for (i = 0; i < RTE_MAX_LCORE && cnt < n; i++)
+		if (dq->lcore_r[i] != NULL && dq->lcore_r[i] != own)
+			cnt += dq_reclaim_ring(dq, dq->lcore_r[i], n - cnt);
+	if (dq->r != own && cnt < n)
+		cnt += dq_reclaim_ring(dq, dq->r, n - cnt);
+
+	return cnt;
+}
+
+/* Count the resources waiting on all the rings of the defer queue. */
+static uint32_t
+dq_pending(const struct rte_rcu_qsbr_dq *dq)
+{
+	uint32_t pending;
+	unsigned int i;
+
+	pending = rte_ring_count(dq->r);
+	for (i = 0; i < RTE_MAX_LCORE; i++)
+		if (dq->lcore_r[i] != NULL)
+			pending += rte_ring_count(dq->lcore_r[i]);
+
+	return pending;
+}
+
+/* Background reclamation service. */
+static int32_t
+dq_reclaim_service(void *args)
+{
+	struct rte_rcu_qsbr_dq *dq = args;
+	uint32_t n = dq->max_reclaim_size;
+
+	if (n == 0)
+		n = UINT32_MAX;
+
+	return dq_reclaim_all(dq, n) != 0 ? 0 : -EAGAIN;
+}
+
+static void
+dq_rings_free(struct rte_rcu_qsbr_dq *dq)
+{
+	unsigned int i;
+
+	for (i = 0; i < RTE_MAX_LCORE; i++)
+		rte_free(dq->lcore_r[i]);
+	rte_ring_free(dq->r);
+}
+
 /* Create a queue used to store the data structure elements that can
  * be freed later. This queue is referred to as 'defer queue'.
  */
 struct rte_rcu_qsbr_dq *
 rte_rcu_qsbr_dq_create(const struct rte_rcu_qsbr_dq_parameters *params)
 {
+	struct rte_service_spec service;
 	struct rte_rcu_qsbr_dq *dq;
 	uint32_t qs_fifo_size;
 	unsigned int flags;
+	unsigned int lcore_id;
+	ssize_t ring_size;
+	int ret;
 
 	if (params == NULL || params->free_fn == NULL ||
 		params->v == NULL || params->name == NULL ||
@@ -305,6 +449,16 @@ rte_rcu_qsbr_dq_create(const struct rte_rcu_qsbr_dq_parameters *params)
 
 		return NULL;
 	}
+	/* The service reclaims concurrently with the writers. */
+	if ((params->flags & RTE_RCU_QSBR_DQ_RECLAIM_SERVICE) &&
+	    (params->flags & RTE_RCU_QSBR_DQ_MT_UNSAFE)) {
+		rte_log(RTE_LOG_ERR, rte_rcu_log_type,
+			"%s(): Reclamation service requires multi-thread safety\n",
+			__func__);
+		rte_errno = EINVAL;
+
+		return NULL;
+	}
 
 	dq = rte_zmalloc(NULL, sizeof(struct rte_rcu_qsbr_dq),
 			 RTE_CACHE_LINE_SIZE);
@@ -338,6 +492,31 @@ rte_rcu_qsbr_dq_create(const struct rte_rcu_qsbr_dq_parameters *params)
 		return NULL;
 	}
 
+	/* Each per lcore ring is enqueued by its lcore only, and is not
+	 * looked up by name.
+	 */
+	if (params->flags & RTE_RCU_QSBR_DQ_PER_LCORE) {
+		ring_size = rte_ring_get_memsize_elem(
+				__RTE_QSBR_TOKEN_SIZE + params->esize,
+				qs_fifo_size);
+		RTE_LCORE_FOREACH(lcore_id) {
+			dq->lcore_r[lcore_id] = rte_zmalloc_socket(NULL,
+					ring_size, RTE_CACHE_LINE_SIZE,
+					rte_lcore_to_socket_id(lcore_id));
+			if (dq->lcore_r[lcore_id] == NULL) {
+				rte_errno = ENOMEM;
+				goto error;
+			}
+			ret = rte_ring_init(dq->lcore_r[lcore_id],
+					params->name, qs_fifo_size,
+					RING_F_SP_ENQ | RING_F_MC_HTS_DEQ);
+			if (ret != 0) {
+				rte_errno = -ret;
+				goto error;
+			}
+		}
+	}
+
 	dq->v = params->v;
 	dq->size = params->size;
 	dq->esize = __RTE_QSBR_TOKEN_SIZE + params->esize;
@@ -345,8 +524,33 @@ rte_rcu_qsbr_dq_create(const struct rte_rcu_qsbr_dq_parameters *params)
 	dq->max_reclaim_size = params->max_reclaim_size;
 	dq->free_fn = params->free_fn;
 	dq->p = params->p;
+	dq->flags = params->flags;
+
+	if (params->flags & RTE_RCU_QSBR_DQ_RECLAIM_SERVICE) {
+		memset(&service, 0, sizeof(service));
+		snprintf(service.name, sizeof(service.name), "rcu_dq_%s",
+			params->name);
+		service.callback = dq_reclaim_service;
+		service.callback_userdata = dq;
+		service.capabilities = RTE_SERVICE_CAP_MT_SAFE;
+		service.socket_id = SOCKET_ID_ANY;
+		ret = rte_service_component_register(&service,
+				&dq->service_id);
+		if (ret != 0) {
+			rte_errno = -ret;
+			goto error;
+		}
+		rte_service_component_runstate_set(dq->service_id, 1);
+	}
 
 	return dq;
+
+error:
+	rte_log(RTE_LOG_ERR, rte_rcu_log_type,
+		"%s(): defer queue create failed\n", __func__);
+	dq_rings_free(dq);
+	rte_free(dq);
+	return NULL;
 }
 
 /* Enqueue one resource to the defer queue to free after the grace
@@ -355,6 +559,7 @@ rte_rcu_qsbr_dq_create(const struct rte_rcu_qsbr_dq_parameters *params)
 int rte_rcu_qsbr_dq_enqueue(struct rte_rcu_qsbr_dq *dq, void *e)
 {
 	__rte_rcu_qsbr_dq_elem_t *dq_elem;
+	struct rte_ring *r;
 	uint32_t cur_size;
 
 	if (dq == NULL || e == NULL) {
@@ -365,6 +570,7 @@ int rte_rcu_qsbr_dq_enqueue(struct rte_rcu_qsbr_dq *dq, void *e)
 		return 1;
 	}
 
+	r = dq_ring_get(dq);
 	char data[dq->esize];
 	dq_elem = (__rte_rcu_qsbr_dq_elem_t *)data;
 	/* Start the grace period */
@@ -373,13 +579,16 @@ int rte_rcu_qsbr_dq_enqueue(struct rte_rcu_qsbr_dq *dq, void *e)
 	/* Reclaim resources if the queue size has hit the reclaim
 	 * limit. This helps the queue from growing too large and
 	 * allows time for reader threads to report their quiescent state.
+	 * The reclamation service, if any, is left doing it until the
+	 * queue is full.
 	 */
-	cur_size = rte_ring_count(dq->r);
-	if (cur_size > dq->trigger_reclaim_limit) {
+	cur_size = rte_ring_count(r);
+	if (cur_size > dq->trigger_reclaim_limit &&
+	    (!(dq->flags & RTE_RCU_QSBR_DQ_RECLAIM_SERVICE) ||
+	     cur_size >= dq->size)) {
 		rte_log(RTE_LOG_INFO, rte_rcu_log_type,
 			"%s(): Triggering reclamation\n", __func__);
-		rte_rcu_qsbr_dq_reclaim(dq, dq->max_reclaim_size,
-						NULL, NULL, NULL);
+		dq_reclaim_ring(dq, r, dq->max_reclaim_size);
 	}
 
 	/* Enqueue the token and resource. Generating the token and
@@ -394,7 +603,7 @@ int rte_rcu_qsbr_dq_enqueue(struct rte_rcu_qsbr_dq *dq, void *e)
 	 * might have used up the freed space.
 	 * Enqueue uses the configured flags when the DQ was created.
 	 */
-	if (rte_ring_enqueue_elem(dq->r, data, dq->esize) != 0) {
+	if (rte_ring_enqueue_elem(r, data, dq->esize) != 0) {
 		rte_log(RTE_LOG_ERR, rte_rcu_log_type,
 			"%s(): Enqueue failed\n", __func__);
 		/* Note that the token generated above is not used.
@@ -423,7 +632,6 @@ rte_rcu_qsbr_dq_reclaim(struct rte_rcu_qsbr_dq *dq, unsigned int n,
 			unsigned int *available)
 {
 	uint32_t cnt;
-	__rte_rcu_qsbr_dq_elem_t *dq_elem;
 
 	if (dq == NULL || n == 0) {
 		rte_log(RTE_LOG_ERR, rte_rcu_log_type,
@@ -433,30 +641,7 @@ rte_rcu_qsbr_dq_reclaim(struct rte_rcu_qsbr_dq *dq, unsigned int n,
 		return 1;
 	}
 
-	cnt = 0;
-
-	char data[dq->esize];
-	/* Check reader threads quiescent state and reclaim resources */
-	while (cnt < n &&
-		rte_ring_dequeue_bulk_elem_start(dq->r, &data,
-					dq->esize, 1, available) != 0) {
-		dq_elem = (__rte_rcu_qsbr_dq_elem_t *)data;
-
-		/* Reclaim the resource */
-		if (rte_rcu_qsbr_check(dq->v, dq_elem->token, false) != 1) {
-			rte_ring_dequeue_elem_finish(dq->r, 0);
-			break;
-		}
-		rte_ring_dequeue_elem_finish(dq->r, 1);
-
-		rte_log(RTE_LOG_INFO, rte_rcu_log_type,
-			"%s(): Reclaimed token = %" PRIu64 "\n",
-			__func__, dq_elem->token);
-
-		dq->free_fn(dq->p, dq_elem->elem, 1);
-
-		cnt++;
-	}
+	cnt = dq_reclaim_all(dq, n);
 
 	rte_log(RTE_LOG_INFO, rte_rcu_log_type,
 		"%s(): Reclaimed %u resources\n", __func__, cnt);
@@ -464,7 +649,9 @@ rte_rcu_qsbr_dq_reclaim(struct rte_rcu_qsbr_dq *dq, unsigned int n,
 	if (freed != NULL)
 		*freed = cnt;
 	if (pending != NULL)
-		*pending = rte_ring_count(dq->r);
+		*pending = dq_pending(dq);
+	if (available != NULL)
+		*available = rte_ring_free_count(dq_ring_get(dq));
 
 	return 0;
 }
@@ -490,10 +677,41 @@ rte_rcu_qsbr_dq_delete(struct rte_rcu_qsbr_dq *dq)
 		return 1;
 	}
 
-	rte_ring_free(dq->r);
+	if (dq->flags & RTE_RCU_QSBR_DQ_RECLAIM_SERVICE) {
+		rte_service_component_runstate_set(dq->service_id, 0);
+		while (rte_service_may_be_active(dq->service_id) == 1)
+			rte_pause();
+		rte_service_component_unregister(dq->service_id);
+	}
+
+	dq_rings_free(dq);
 	rte_free(dq);
 
 	return 0;
 }
 
+/* Get the ID of the reclamation service of a defer queue. */
+int
+rte_rcu_qsbr_dq_service_id_get(const struct rte_rcu_qsbr_dq *dq,
+	uint32_t *service_id)
+{
+	if (dq == NULL || service_id == NULL) {
+		rte_log(RTE_LOG_ERR, rte_rcu_log_type,
+			"%s(): Invalid input parameter\n", __func__);
+		rte_errno = EINVAL;
+
+		return 1;
+	}
+
+	if (!(dq->flags & RTE_RCU_QSBR_DQ_RECLAIM_SERVICE)) {
+		rte_errno = ENOTSUP;
+
+		return 1;
+	}
+
+	*service_id = dq->service_id;
+
+	return 0;
+}
+
 RTE_LOG_REGISTER_DEFAULT(rte_rcu_log_type, ERR);
@@ -147,6 +147,19 @@ typedef void (*rte_rcu_qsbr_free_resource_t)(void *p, void *e, unsigned int n);
  *   Set this flag if multi-thread safety is not required.
  */
 #define RTE_RCU_QSBR_DQ_MT_UNSAFE 1
+/**< Give each lcore its own defer queue of 'size' entries, so that
+ *   the writers running on different lcores do not contend on the
+ *   enqueue, and reclaim their own resources first. The threads that
+ *   are not EAL lcores share the default defer queue.
+ */
+#define RTE_RCU_QSBR_DQ_PER_LCORE 2
+/**< Register a service reclaiming the resources in the background.
+ *   The automatic reclamation is then skipped by the enqueue, unless
+ *   the defer queue is full. The service must be mapped to a service
+ *   core by the application, see rte_rcu_qsbr_dq_service_id_get.
+ *   Not supported along with RTE_RCU_QSBR_DQ_MT_UNSAFE.
+ */
+#define RTE_RCU_QSBR_DQ_RECLAIM_SERVICE 4
 
 /**
  * Parameters used when creating the defer queue.
@@ -162,6 +175,8 @@ struct rte_rcu_qsbr_dq_parameters {
 	 *   lock free data structure.
 	 *   Data structures with unbounded number of entries is not
 	 *   supported currently.
+	 *   With RTE_RCU_QSBR_DQ_PER_LCORE, this is the size of each
+	 *   per lcore queue.
 	 */
 	uint32_t esize;
 	/**< Size (in bytes) of each element in the defer queue.
@@ -182,6 +197,8 @@ struct rte_rcu_qsbr_dq_parameters {
 	 *   these many resources. This should contain a valid value, if
 	 *   auto reclamation is on. Setting this to 'size' or greater will
 	 *   reclaim all possible resources currently on the defer queue.
+	 *   It also bounds each run of the reclamation service, 0 meaning
+	 *   no bound.
 	 */
 	rte_rcu_qsbr_free_resource_t free_fn;
 	/**< Function to call to free the resource. */
@@ -792,6 +809,9 @@ rte_rcu_qsbr_dq_enqueue(struct rte_rcu_qsbr_dq *dq, void *e);
  *
  * This API is multi-thread safe.
  *
+ * With RTE_RCU_QSBR_DQ_PER_LCORE, the queue of the calling lcore is
+ * reclaimed first, then the queues of the other lcores.
+ *
  * @param dq
  *   Defer queue to free an entry from.
  * @param n
@@ -804,6 +824,8 @@ rte_rcu_qsbr_dq_enqueue(struct rte_rcu_qsbr_dq *dq, void *e);
  * @param available
  *   Number of resources that can be added to the defer queue.
  *   This number might not be accurate if multi-thread safety is configured.
+ *   With RTE_RCU_QSBR_DQ_PER_LCORE, this is the room left in the queue
+ *   of the calling lcore.
  * @return
  *   On successful reclamation of at least 1 resource - 0
  *   On error - 1 with rte_errno set to
@@ -839,6 +861,30 @@ __rte_experimental
 int
 rte_rcu_qsbr_dq_delete(struct rte_rcu_qsbr_dq *dq);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Get the ID of the service reclaiming the resources of a defer queue
+ * created with RTE_RCU_QSBR_DQ_RECLAIM_SERVICE. The application maps
+ * it to a service core and starts it with the rte_service API.
+ * The service is unregistered when the defer queue is deleted.
+ *
+ * @param dq
+ *   Defer queue.
+ * @param service_id
+ *   Location to store the service ID.
+ * @return
+ *   On success - 0
+ *   On error - 1 with rte_errno set to
+ *   - EINVAL - NULL parameters are passed
+ *   - ENOTSUP - The defer queue has no reclamation service
+ */
+__rte_experimental
+int
+rte_rcu_qsbr_dq_service_id_get(const struct rte_rcu_qsbr_dq *dq,
+	uint32_t *service_id);
+
 #ifdef __cplusplus
 }
 #endif
@@ -30,7 +30,6 @@ EAL_REGISTER_TAILQ(rte_reorder_tailq)
 /* Macros for printing using RTE_LOG */
 #define RTE_LOGTYPE_REORDER	RTE_LOGTYPE_USER1
 
-#define RTE_REORDER_SEQN_DYNFIELD_NAME "rte_reorder_seqn_dynfield"
 int rte_reorder_seqn_dynfield_offset = -1;
 
 /* A generic circular buffer */
@@ -50,6 +49,9 @@ struct rte_reorder_buffer {
 	struct cir_buffer ready_buf; /**< temp buffer for dequeued entries */
 	struct cir_buffer order_buf; /**< buffer used to reorder entries */
 	int is_initialized;
+	unsigned int flags; /**< RTE_REORDER_F_* flags */
+	/** Highest seq. number which did not fit in the window, MP insert */
+	uint32_t overflow_seqn __rte_cache_aligned;
 } __rte_cache_aligned;
 
 static void
@@ -99,8 +101,9 @@ rte_reorder_init(struct rte_reorder_buffer *b, unsigned int bufsize,
 	return b;
 }
 
-struct rte_reorder_buffer*
-rte_reorder_create(const char *name, unsigned socket_id, unsigned int size)
+struct rte_reorder_buffer *
+rte_reorder_create_with_flags(const char *name, unsigned int socket_id,
+		unsigned int size, unsigned int flags)
 {
 	struct rte_reorder_buffer *b = NULL;
 	struct rte_tailq_entry *te;
@@ -108,9 +111,10 @@ rte_reorder_create(const char *name, unsigned socket_id, unsigned int size)
 	const unsigned int bufsize = sizeof(struct rte_reorder_buffer) +
 					(2 * size * sizeof(struct rte_mbuf *));
 	static const struct rte_mbuf_dynfield reorder_seqn_dynfield_desc = {
-		.name = RTE_REORDER_SEQN_DYNFIELD_NAME,
+		.name = RTE_MBUF_DYNFIELD_REORDER_SEQN_NAME,
 		.size = sizeof(rte_reorder_seqn_t),
 		.align = __alignof__(rte_reorder_seqn_t),
+		.flags = RTE_MBUF_DYNFIELD_F_HOT,
 	};
 
 	reorder_list = RTE_TAILQ_CAST(rte_reorder_tailq.head, rte_reorder_list);
@@ -128,6 +132,12 @@ rte_reorder_create(const char *name, unsigned socket_id, unsigned int size)
 		rte_errno = EINVAL;
 		return NULL;
 	}
+	if (flags & ~RTE_REORDER_F_MP_INSERT) {
+		RTE_LOG(ERR, REORDER, "Invalid reorder buffer flags: 0x%x\n",
+			flags);
+		rte_errno = EINVAL;
+		return NULL;
+	}
 
 	rte_reorder_seqn_dynfield_offset =
 		rte_mbuf_dynfield_register(&reorder_seqn_dynfield_desc);
@@ -165,6 +175,7 @@ rte_reorder_create(const char *name, unsigned socket_id, unsigned int size)
 		rte_free(te);
 	} else {
 		rte_reorder_init(b, bufsize, name, size);
+		b->flags = flags;
 		te->data = (void *)b;
 		TAILQ_INSERT_TAIL(reorder_list, te, next);
 	}
@@ -174,15 +185,50 @@ rte_reorder_create(const char *name, unsigned socket_id, unsigned int size)
 	return b;
 }
 
+struct rte_reorder_buffer*
+rte_reorder_create(const char *name, unsigned socket_id, unsigned int size)
+{
+	return rte_reorder_create_with_flags(name, socket_id, size, 0);
+}
+
 void
 rte_reorder_reset(struct rte_reorder_buffer *b)
 {
 	char name[RTE_REORDER_NAMESIZE];
+	unsigned int flags = b->flags;
 
 	rte_reorder_free_mbufs(b);
 	strlcpy(name, b->name, sizeof(name));
 	/* No error checking as current values should be valid */
 	rte_reorder_init(b, b->memsize, name, b->order_buf.size);
+	b->flags = flags;
+}
+
+int
+rte_reorder_min_seqn_set(struct rte_reorder_buffer *b,
+		rte_reorder_seqn_t min_seqn)
+{
+	unsigned int i;
+
+	if (b == NULL)
+		return -EINVAL;
+
+	if (b->ready_buf.head != b->ready_buf.tail)
+		return -ENOTEMPTY;
+	for (i = 0; i < b->order_buf.size; i++)
+		if (b->order_buf.entries[i] != NULL)
+			return -ENOTEMPTY;
+
+	/*
+	 * Keep the slot of each sequence number fixed, so that MP inserts
+	 * do not depend on the order buffer head.
+	 */
+	b->order_buf.head = min_seqn & b->order_buf.mask;
+	b->overflow_seqn = min_seqn;
+	b->min_seqn = min_seqn;
+	b->is_initialized = 1;
+
+	return 0;
 }
 
 static void
@@ -314,6 +360,58 @@ rte_reorder_fill_overflow(struct rte_reorder_buffer *b, unsigned n)
 	return order_head_adv;
 }
 
+/*
+ * Insert from several threads, while a single one drains.
+ *
+ * The window of sequence numbers is only moved by the drain, a mbuf which
+ * does not fit in it is left to the caller, and the drain is asked to skip
+ * the missing mbufs holding back the window. The slot of a sequence number
+ * is fixed, and is claimed with an atomic, as the same slot may be claimed
+ * by a late mbuf which was skipped meanwhile.
+ */
+static int
+rte_reorder_insert_mp(struct rte_reorder_buffer *b, struct rte_mbuf *mbuf)
+{
+	struct rte_mbuf **entry, *expected = NULL;
+	uint32_t seqn, min_seqn, overflow_seqn, offset;
+
+	if (unlikely(!b->is_initialized)) {
+		rte_errno = EINVAL;
+		return -1;
+	}
+
+	seqn = *rte_reorder_seqn(mbuf);
+	/* sync with the drain releasing the slots of older mbufs */
+	min_seqn = __atomic_load_n(&b->min_seqn, __ATOMIC_ACQUIRE);
+	offset = seqn - min_seqn;
+
+	if (unlikely(offset >= b->order_buf.size)) {
+		if (offset >= 2 * b->order_buf.size) {
+			rte_errno = ERANGE;
+			return -1;
+		}
+		overflow_seqn = __atomic_load_n(&b->overflow_seqn,
+			__ATOMIC_RELAXED);
+		while ((int32_t)(seqn - overflow_seqn) > 0 &&
+				!__atomic_compare_exchange_n(&b->overflow_seqn,
+					&overflow_seqn, seqn, 0,
+					__ATOMIC_RELAXED, __ATOMIC_RELAXED))
+			;
+		rte_errno = ENOSPC;
+		return -1;
+	}
+
+	entry = &b->order_buf.entries[seqn & b->order_buf.mask];
+	/* sync with the drain on the mbuf and its sequence number */
+	if (!__atomic_compare_exchange_n(entry, &expected, mbuf, 0,
+			__ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+		rte_errno = ENOSPC;
+		return -1;
+	}
+
+	return 0;
+}
+
 int
 rte_reorder_insert(struct rte_reorder_buffer *b, struct rte_mbuf *mbuf)
 {
@@ -325,6 +423,9 @@ rte_reorder_insert(struct rte_reorder_buffer *b, struct rte_mbuf *mbuf)
 		return -1;
 	}
 
+	if (b->flags & RTE_REORDER_F_MP_INSERT)
+		return rte_reorder_insert_mp(b, mbuf);
+
 	order_buf = &b->order_buf;
 	if (!b->is_initialized) {
 		b->min_seqn = *rte_reorder_seqn(mbuf);
@@ -380,6 +481,57 @@ rte_reorder_insert(struct rte_reorder_buffer *b, struct rte_mbuf *mbuf)
 	return 0;
 }
 
+unsigned int
+rte_reorder_insert_bulk(struct rte_reorder_buffer *b, struct rte_mbuf **mbufs,
+		unsigned int nb_mbufs)
+{
+	unsigned int i;
+
+	for (i = 0; i < nb_mbufs; i++)
+		if (rte_reorder_insert(b, mbufs[i]) < 0)
+			break;
+
+	return i;
+}
+
+static unsigned int
+rte_reorder_drain_mp(struct rte_reorder_buffer *b, struct rte_mbuf **mbufs,
+		unsigned int max_mbufs)
+{
+	struct cir_buffer *order_buf = &b->order_buf;
+	uint32_t min_seqn = b->min_seqn;
+	unsigned int drain_cnt = 0;
+	struct rte_mbuf *mbuf;
+	uint32_t overflow_seqn;
+
+	overflow_seqn = __atomic_load_n(&b->overflow_seqn, __ATOMIC_RELAXED);
+
+	while (drain_cnt < max_mbufs) {
+		mbuf = __atomic_load_n(&order_buf->entries[order_buf->head],
+			__ATOMIC_ACQUIRE);
+		if (mbuf == NULL) {
+			/* skip a gap only if a mbuf is waiting outside */
+			if ((int32_t)(overflow_seqn - min_seqn) <
+					(int32_t)order_buf->size)
+				break;
+		} else {
+			mbufs[drain_cnt++] = mbuf;
+			__atomic_store_n(&order_buf->entries[order_buf->head],
+				NULL, __ATOMIC_RELAXED);
+			/* a late mbuf which was skipped is returned as is */
+			if (*rte_reorder_seqn(mbuf) != min_seqn)
+				continue;
+		}
+
+		order_buf->head = (order_buf->head + 1) & order_buf->mask;
+		min_seqn++;
+		/* release the slot to the inserts of the next window */
+		__atomic_store_n(&b->min_seqn, min_seqn, __ATOMIC_RELEASE);
+	}
+
+	return drain_cnt;
+}
+
 unsigned int
 rte_reorder_drain(struct rte_reorder_buffer *b, struct rte_mbuf **mbufs,
 		unsigned max_mbufs)
@@ -389,6 +541,9 @@ rte_reorder_drain(struct rte_reorder_buffer *b, struct rte_mbuf **mbufs,
 	struct cir_buffer *order_buf = &b->order_buf,
 			*ready_buf = &b->ready_buf;
 
+	if (b->flags & RTE_REORDER_F_MP_INSERT)
+		return rte_reorder_drain_mp(b, mbufs, max_mbufs);
+
 	/* Try to fetch requested number of mbufs from ready buffer */
 	while ((drain_cnt < max_mbufs) && (ready_buf->tail != ready_buf->head)) {
 		mbufs[drain_cnt++] = ready_buf->entries[ready_buf->tail];
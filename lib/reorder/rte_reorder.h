@@ -27,6 +27,12 @@ struct rte_reorder_buffer;
 typedef uint32_t rte_reorder_seqn_t;
 extern int rte_reorder_seqn_dynfield_offset;
 
+/**
+ * Reorder buffer flag: rte_reorder_insert() may be called from several
+ * threads at once, while rte_reorder_drain() is called from a single one.
+ */
+#define RTE_REORDER_F_MP_INSERT 0x1
+
 /**
  * @warning
  * @b EXPERIMENTAL: this API may change without prior notice
@@ -66,6 +72,40 @@ rte_reorder_seqn(struct rte_mbuf *mbuf)
 struct rte_reorder_buffer *
 rte_reorder_create(const char *name, unsigned socket_id, unsigned int size);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Create a new reorder buffer instance with flags.
+ *
+ * With RTE_REORDER_F_MP_INSERT, the window of sequence numbers is only moved
+ * by rte_reorder_drain(), so that mbufs too early for the window are not
+ * inserted, with rte_errno set to ENOSPC, and must be inserted again after
+ * a drain. The drain skips the missing mbufs which hold back such early ones.
+ * A late mbuf which was skipped may still be inserted, and then be drained
+ * out of order. The first sequence number must be set with
+ * rte_reorder_min_seqn_set() before any insert.
+ *
+ * @param name
+ *   The name to be given to the reorder buffer instance.
+ * @param socket_id
+ *   The NUMA node on which the memory for the reorder buffer
+ *   instance is to be reserved.
+ * @param size
+ *   Max number of elements that can be stored in the reorder buffer
+ * @param flags
+ *   RTE_REORDER_F_* flags.
+ * @return
+ *   The initialized reorder buffer instance, or NULL on error
+ *   On error case, rte_errno will be set appropriately:
+ *    - ENOMEM - no appropriate memory area found in which to create memzone
+ *    - EINVAL - invalid parameters
+ */
+__rte_experimental
+struct rte_reorder_buffer *
+rte_reorder_create_with_flags(const char *name, unsigned int socket_id,
+		unsigned int size, unsigned int flags);
+
 /**
  * Initializes given reorder buffer instance
  *
@@ -110,6 +150,28 @@ rte_reorder_find_existing(const char *name);
 void
 rte_reorder_reset(struct rte_reorder_buffer *b);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Set the lowest sequence number accepted by an empty reorder buffer,
+ * instead of taking the sequence number of the first inserted mbuf.
+ * It is required before inserting in a buffer with RTE_REORDER_F_MP_INSERT,
+ * also after a reset.
+ *
+ * @param b
+ *   Reorder buffer instance.
+ * @param min_seqn
+ *   Sequence number of the next mbuf to drain.
+ * @return
+ *   0 on success, -EINVAL for invalid parameters,
+ *   -ENOTEMPTY if the buffer holds mbufs.
+ */
+__rte_experimental
+int
+rte_reorder_min_seqn_set(struct rte_reorder_buffer *b,
+		rte_reorder_seqn_t min_seqn);
+
 /**
  * Free reorder buffer instance.
  *
@@ -128,7 +190,8 @@ rte_reorder_free(struct rte_reorder_buffer *b);
  * The mbuf must contain a sequence number which is then used to place
  * the buffer in the correct position in the reorder buffer. Reordered
  * packets can later be taken from the buffer using the rte_reorder_drain()
- * API.
+ * API. It may be called from several threads at once for a reorder buffer
+ * created with RTE_REORDER_F_MP_INSERT.
  *
  * @param b
  *   Reorder buffer where the mbuf has to be inserted.
@@ -146,6 +209,28 @@ rte_reorder_free(struct rte_reorder_buffer *b);
 int
 rte_reorder_insert(struct rte_reorder_buffer *b, struct rte_mbuf *mbuf);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Insert a burst of mbufs in reorder buffer, stopping at the first one
+ * which cannot be inserted, as done by rte_reorder_insert().
+ *
+ * @param b
+ *   Reorder buffer where the mbufs have to be inserted.
+ * @param mbufs
+ *   Array of mbufs of packets that need to be inserted in reorder buffer.
+ * @param nb_mbufs
+ *   Number of mbufs in the array.
+ * @return
+ *   Number of mbufs inserted. If lower than nb_mbufs, rte_errno is set
+ *   as by rte_reorder_insert() for the first mbuf left.
+ */
+__rte_experimental
+unsigned int
+rte_reorder_insert_bulk(struct rte_reorder_buffer *b, struct rte_mbuf **mbufs,
+		unsigned int nb_mbufs);
+
 /**
  * Fetch reordered buffers
  *
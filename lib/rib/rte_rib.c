@@ -11,6 +11,7 @@
 #include <rte_errno.h>
 #include <rte_malloc.h>
 #include <rte_mempool.h>
+#include <rte_rcu_qsbr.h>
 #include <rte_rwlock.h>
 #include <rte_string_fns.h>
 #include <rte_tailq.h>
@@ -28,6 +29,8 @@ EAL_REGISTER_TAILQ(rte_rib_tailq)
 #define RIB_MAXDEPTH		32
 /* Maximum length of a RIB name. */
 #define RTE_RIB_NAMESIZE	64
+/* Number of nodes taken from the mempool at once by bulk inserts. */
+#define RIB_BULK_ALLOC		32
 
 struct rte_rib_node {
 	struct rte_rib_node	*left;
@@ -47,6 +50,16 @@ struct rte_rib {
 	uint32_t		cur_nodes;
 	uint32_t		cur_routes;
 	uint32_t		max_nodes;
+	/* RCU config. */
+	struct rte_rcu_qsbr	*v;		/* RCU QSBR variable. */
+	enum rte_rib_qsbr_mode	rcu_mode;	/* Blocking, defer queue. */
+	struct rte_rcu_qsbr_dq	*dq;		/* RCU QSBR defer queue. */
+};
+
+/* Nodes taken from the mempool in bulk, not yet used */
+struct node_cache {
+	unsigned int	nb;
+	void		*objs[RIB_BULK_ALLOC];
 };
 
 static inline bool
@@ -55,10 +68,38 @@ is_valid_node(struct rte_rib_node *node)
 	return (node->flag & RTE_RIB_VALID_NODE) == RTE_RIB_VALID_NODE;
 }
 
+static inline struct rte_rib_node *
+get_left(struct rte_rib_node *node)
+{
+	return __atomic_load_n(&node->left, __ATOMIC_ACQUIRE);
+}
+
+static inline struct rte_rib_node *
+get_right(struct rte_rib_node *node)
+{
+	return __atomic_load_n(&node->right, __ATOMIC_ACQUIRE);
+}
+
+static inline struct rte_rib_node *
+get_parent(struct rte_rib_node *node)
+{
+	return __atomic_load_n(&node->parent, __ATOMIC_ACQUIRE);
+}
+
+/*
+ * Link a node into the tree, after it has been filled
+ * for the RCU readers walking the tree
+ */
+static inline void
+set_link(struct rte_rib_node **link, struct rte_rib_node *node)
+{
+	__atomic_store_n(link, node, __ATOMIC_RELEASE);
+}
+
 static inline bool
 is_right_node(struct rte_rib_node *node)
 {
-	return node->parent->right == node;
+	return get_right(get_parent(node)) == node;
 }
 
 /*
@@ -73,7 +114,8 @@ is_covered(uint32_t ip1, uint32_t ip2, uint8_t depth)
 static inline struct rte_rib_node *
 get_nxt_node(struct rte_rib_node *node, uint32_t ip)
 {
-	return (ip & (1 << (31 - node->depth))) ? node->right : node->left;
+	return (ip & (1 << (31 - node->depth))) ? get_right(node) :
+		get_left(node);
 }
 
 static struct rte_rib_node *
@@ -83,19 +125,73 @@ node_alloc(struct rte_rib *rib)
 	int ret;
 
 	ret = rte_mempool_get(rib->node_pool, (void *)&ent);
+	if (unlikely(ret != 0) && rib->dq != NULL) {
+		/* If there are no free nodes try to reclaim some. */
+		if (rte_rcu_qsbr_dq_reclaim(rib->dq, RTE_RIB_RCU_DQ_RECLAIM_MAX,
+				NULL, NULL, NULL) == 0)
+			ret = rte_mempool_get(rib->node_pool, (void *)&ent);
+	}
 	if (unlikely(ret != 0))
 		return NULL;
 	++rib->cur_nodes;
 	return ent;
 }
 
+static struct rte_rib_node *
+node_cache_alloc(struct rte_rib *rib, struct node_cache *cache)
+{
+	if ((cache->nb == 0) && (rte_mempool_get_bulk(rib->node_pool,
+			cache->objs, RIB_BULK_ALLOC) == 0))
+		cache->nb = RIB_BULK_ALLOC;
+	if (cache->nb == 0)
+		return node_alloc(rib);
+	++rib->cur_nodes;
+	return cache->objs[--cache->nb];
+}
+
+/*
+ * Give back a node no reader can see, i.e. one that was never linked
+ * into the tree
+ */
 static void
-node_free(struct rte_rib *rib, struct rte_rib_node *ent)
+node_put(struct rte_rib *rib, struct rte_rib_node *ent)
 {
 	--rib->cur_nodes;
 	rte_mempool_put(rib->node_pool, ent);
 }
 
+static void
+__rcu_qsbr_free_resource(void *p, void *data, unsigned int n)
+{
+	struct rte_rib *rib = p;
+
+	RTE_SET_USED(n);
+	rte_mempool_put(rib->node_pool, *(void **)data);
+}
+
+/*
+ * Free a node unlinked from the tree,
+ * once the RCU readers are done with it
+ */
+static void
+node_free(struct rte_rib *rib, struct rte_rib_node *ent)
+{
+	--rib->cur_nodes;
+	if (rib->v == NULL) {
+		rte_mempool_put(rib->node_pool, ent);
+	} else if (rib->rcu_mode == RTE_RIB_QSBR_MODE_DQ &&
+			rte_rcu_qsbr_dq_enqueue(rib->dq, (void *)&ent) == 0) {
+		/* Freed once the readers are done with it. */
+	} else {
+		/*
+		 * Blocking mode, or defer queue full:
+		 * wait for quiescent state change.
+		 */
+		rte_rcu_qsbr_synchronize(rib->v, RTE_QSBR_THRID_INVALID);
+		rte_mempool_put(rib->node_pool, ent);
+	}
+}
+
 struct rte_rib_node *
 rte_rib_lookup(struct rte_rib *rib, uint32_t ip)
 {
@@ -106,7 +202,7 @@ rte_rib_lookup(struct rte_rib *rib, uint32_t ip)
 		return NULL;
 	}
 
-	cur = rib->tree;
+	cur = __atomic_load_n(&rib->tree, __ATOMIC_ACQUIRE);
 	while ((cur != NULL) && is_covered(ip, cur->ip, cur->depth)) {
 		if (is_valid_node(cur))
 			prev = cur;
@@ -122,9 +218,9 @@ rte_rib_lookup_parent(struct rte_rib_node *ent)
 
 	if (ent == NULL)
 		return NULL;
-	tmp = ent->parent;
+	tmp = get_parent(ent);
 	while ((tmp != NULL) &&	!is_valid_node(tmp))
-		tmp = tmp->parent;
+		tmp = get_parent(tmp);
 	return tmp;
 }
 
@@ -133,7 +229,7 @@ __rib_lookup_exact(struct rte_rib *rib, uint32_t ip, uint8_t depth)
 {
 	struct rte_rib_node *cur;
 
-	cur = rib->tree;
+	cur = __atomic_load_n(&rib->tree, __ATOMIC_ACQUIRE);
 	while (cur != NULL) {
 		if ((cur->ip == ip) && (cur->depth == depth) &&
 				is_valid_node(cur))
@@ -175,20 +271,20 @@ rte_rib_get_nxt(struct rte_rib *rib, uint32_t ip,
 	}
 
 	if (last == NULL) {
-		tmp = rib->tree;
+		tmp = __atomic_load_n(&rib->tree, __ATOMIC_ACQUIRE);
 		while ((tmp) && (tmp->depth < depth))
 			tmp = get_nxt_node(tmp, ip);
 	} else {
 		tmp = last;
-		while ((tmp->parent != NULL) && (is_right_node(tmp) ||
-				(tmp->parent->right == NULL))) {
-			tmp = tmp->parent;
+		while ((get_parent(tmp) != NULL) && (is_right_node(tmp) ||
+				(get_right(get_parent(tmp)) == NULL))) {
+			tmp = get_parent(tmp);
 			if (is_valid_node(tmp) &&
 					(is_covered(tmp->ip, ip, depth) &&
 					(tmp->depth > depth)))
 				return tmp;
 		}
-		tmp = (tmp->parent) ? tmp->parent->right : NULL;
+		tmp = (get_parent(tmp)) ? get_right(get_parent(tmp)) : NULL;
 	}
 	while (tmp) {
 		if (is_valid_node(tmp) &&
@@ -198,7 +294,7 @@ rte_rib_get_nxt(struct rte_rib *rib, uint32_t ip,
 			if (flag == RTE_RIB_GET_NXT_COVER)
 				return prev;
 		}
-		tmp = (tmp->left) ? tmp->left : tmp->right;
+		tmp = (get_left(tmp)) ? get_left(tmp) : get_right(tmp);
 	}
 	return prev;
 }
@@ -219,16 +315,16 @@ rte_rib_remove(struct rte_rib *rib, uint32_t ip, uint8_t depth)
 			return;
 		child = (cur->left == NULL) ? cur->right : cur->left;
 		if (child != NULL)
-			child->parent = cur->parent;
+			set_link(&child->parent, cur->parent);
 		if (cur->parent == NULL) {
-			rib->tree = child;
+			set_link(&rib->tree, child);
 			node_free(rib, cur);
 			return;
 		}
 		if (cur->parent->left == cur)
-			cur->parent->left = child;
+			set_link(&cur->parent->left, child);
 		else
-			cur->parent->right = child;
+			set_link(&cur->parent->right, child);
 		prev = cur;
 		cur = cur->parent;
 		node_free(rib, prev);
@@ -270,15 +366,16 @@ rte_rib_insert(struct rte_rib *rib, uint32_t ip, uint8_t depth)
 	new_node->ip = ip;
 	new_node->depth = depth;
 	new_node->flag = RTE_RIB_VALID_NODE;
+	new_node->nh = 0;
 
 	/* traverse down the tree to find matching node or closest matching */
 	while (1) {
 		/* insert as the last node in the branch */
 		if (*tmp == NULL) {
-			*tmp = new_node;
 			new_node->parent = prev;
+			set_link(tmp, new_node);
 			++rib->cur_routes;
-			return *tmp;
+			return new_node;
 		}
 		/*
 		 * Intermediate node found.
@@ -287,7 +384,8 @@ rte_rib_insert(struct rte_rib *rib, uint32_t ip, uint8_t depth)
 		 * Validate intermediate node and return.
 		 */
 		if ((ip == (*tmp)->ip) && (depth == (*tmp)->depth)) {
-			node_free(rib, new_node);
+			node_put(rib, new_node);
+			(*tmp)->nh = 0;
 			(*tmp)->flag |= RTE_RIB_VALID_NODE;
 			++rib->cur_routes;
 			return *tmp;
@@ -305,6 +403,10 @@ rte_rib_insert(struct rte_rib *rib, uint32_t ip, uint8_t depth)
 
 	common_depth = RTE_MIN(d, common_depth);
 	common_prefix = ip & rte_rib_depth_to_mask(common_depth);
+	/*
+	 * The new nodes are filled before they are linked into the tree,
+	 * so that the RCU readers only ever see complete nodes.
+	 */
 	if ((common_prefix == ip) && (common_depth == depth)) {
 		/* insert as a parent */
 		if ((*tmp)->ip & (1 << (31 - depth)))
@@ -312,13 +414,13 @@ rte_rib_insert(struct rte_rib *rib, uint32_t ip, uint8_t depth)
 		else
 			new_node->left = *tmp;
 		new_node->parent = (*tmp)->parent;
-		(*tmp)->parent = new_node;
-		*tmp = new_node;
+		set_link(&(*tmp)->parent, new_node);
+		set_link(tmp, new_node);
 	} else {
 		/* create intermediate node */
 		common_node = node_alloc(rib);
 		if (common_node == NULL) {
-			node_free(rib, new_node);
+			node_put(rib, new_node);
 			rte_errno = ENOMEM;
 			return NULL;
 		}
@@ -327,7 +429,6 @@ rte_rib_insert(struct rte_rib *rib, uint32_t ip, uint8_t depth)
 		common_node->flag = 0;
 		common_node->parent = (*tmp)->parent;
 		new_node->parent = common_node;
-		(*tmp)->parent = common_node;
 		if ((new_node->ip & (1 << (31 - common_depth))) == 0) {
 			common_node->left = new_node;
 			common_node->right = *tmp;
@@ -335,12 +436,161 @@ rte_rib_insert(struct rte_rib *rib, uint32_t ip, uint8_t depth)
 			common_node->left = *tmp;
 			common_node->right = new_node;
 		}
-		*tmp = common_node;
+		set_link(&(*tmp)->parent, common_node);
+		set_link(tmp, common_node);
 	}
 	++rib->cur_routes;
 	return new_node;
 }
 
+/*
+ * Build the tree of a sorted list of routes bottom-up, out of the RIB.
+ * A route never covers the routes before it, it goes either under the
+ * deepest node covering it, or next to the node it is the right
+ * neighbour of, under a new intermediate node.
+ */
+static struct rte_rib_node *
+build_tree(struct rte_rib *rib, const uint32_t *ips, const uint8_t *depths,
+	const uint64_t *next_hops, unsigned int n)
+{
+	struct rte_rib_node *root = NULL, *last = NULL, *up;
+	struct rte_rib_node *node, *common_node, **link;
+	struct node_cache cache = { .nb = 0 };
+	unsigned int i;
+	uint32_t ip;
+	int d;
+
+	for (i = 0; i < n; i++) {
+		ip = ips[i] & rte_rib_depth_to_mask(depths[i]);
+		node = node_cache_alloc(rib, &cache);
+		if (node == NULL)
+			goto free_tree;
+		node->left = NULL;
+		node->right = NULL;
+		node->ip = ip;
+		node->depth = depths[i];
+		node->flag = RTE_RIB_VALID_NODE;
+		node->nh = (next_hops != NULL) ? next_hops[i] : 0;
+
+		/* deepest node covering the route */
+		for (up = last; (up != NULL) && ((up->depth >= depths[i]) ||
+				!is_covered(ip, up->ip, up->depth));
+				up = up->parent)
+			;
+		if (up == NULL)
+			link = &root;
+		else
+			link = (ip & (1 << (31 - up->depth))) ? &up->right :
+				&up->left;
+		node->parent = up;
+
+		if (*link != NULL) {
+			common_node = node_cache_alloc(rib, &cache);
+			if (common_node == NULL) {
+				node_put(rib, node);
+				goto free_tree;
+			}
+			d = __builtin_clz(ip ^ (*link)->ip);
+			common_node->ip = ip & rte_rib_depth_to_mask(d);
+			common_node->depth = d;
+			common_node->flag = 0;
+			common_node->parent = up;
+			common_node->left = *link;
+			common_node->right = node;
+			(*link)->parent = common_node;
+			node->parent = common_node;
+			*link = common_node;
+		} else
+			*link = node;
+		last = node;
+	}
+	rte_mempool_put_bulk(rib->node_pool, cache.objs, cache.nb);
+	return root;
+
+free_tree:
+	rte_mempool_put_bulk(rib->node_pool, cache.objs, cache.nb);
+	for (node = root; node != NULL; ) {
+		if (node->left != NULL)
+			node = node->left;
+		else if (node->right != NULL)
+			node = node->right;
+		else {
+			up = node->parent;
+			if (up != NULL) {
+				if (up->left == node)
+					up->left = NULL;
+				else
+					up->right = NULL;
+			}
+			node_put(rib, node);
+			node = up;
+		}
+	}
+	rte_errno = ENOMEM;
+	return NULL;
+}
+
+int
+rte_rib_insert_bulk(struct rte_rib *rib, const uint32_t *ips,
+	const uint8_t *depths, const uint64_t *next_hops, unsigned int n)
+{
+	struct rte_rib_node *node;
+	uint32_t ip, prev_ip = 0;
+	unsigned int i;
+	int ret;
+
+	if ((rib == NULL) || (ips == NULL) || (depths == NULL))
+		return -EINVAL;
+
+	/* the routes must be sorted by prefix then depth, without duplicate */
+	for (i = 0; i < n; i++) {
+		if (depths[i] > RIB_MAXDEPTH)
+			return -EINVAL;
+		ip = ips[i] & rte_rib_depth_to_mask(depths[i]);
+		if ((i != 0) && ((ip < prev_ip) || ((ip == prev_ip) &&
+				(depths[i] <= depths[i - 1]))))
+			return -EINVAL;
+		prev_ip = ip;
+	}
+	if (n == 0)
+		return 0;
+
+	if (rib->tree == NULL) {
+		node = build_tree(rib, ips, depths, next_hops, n);
+		if (node == NULL)
+			return -rte_errno;
+		rib->cur_routes += n;
+		set_link(&rib->tree, node);
+		return 0;
+	}
+
+	for (i = 0; i < n; i++) {
+		node = rte_rib_insert(rib, ips[i], depths[i]);
+		if (node == NULL) {
+			ret = -rte_errno;
+			while (i-- > 0)
+				rte_rib_remove(rib, ips[i], depths[i]);
+			return ret;
+		}
+		if (next_hops != NULL)
+			node->nh = next_hops[i];
+	}
+	return 0;
+}
+
+void
+rte_rib_remove_bulk(struct rte_rib *rib, const uint32_t *ips,
+	const uint8_t *depths, unsigned int n)
+{
+	unsigned int i;
+
+	if ((rib == NULL) || (ips == NULL) || (depths == NULL))
+		return;
+
+	for (i = 0; i < n; i++)
+		rte_rib_remove(rib, ips[i], depths[i]);
+}
+
 int
 rte_rib_get_ip(const struct rte_rib_node *node, uint32_t *ip)
 {
@@ -391,6 +641,50 @@ rte_rib_set_nh(struct rte_rib_node *node, uint64_t nh)
 	return 0;
 }
 
+int
+rte_rib_rcu_qsbr_add(struct rte_rib *rib, struct rte_rib_rcu_config *cfg)
+{
+	struct rte_rcu_qsbr_dq_parameters params = {0};
+	char rcu_dq_name[RTE_RCU_QSBR_DQ_NAMESIZE];
+
+	if ((rib == NULL) || (cfg == NULL) || (cfg->v == NULL))
+		return -EINVAL;
+
+	if (rib->v != NULL)
+		return -EEXIST;
+
+	if (cfg->mode == RTE_RIB_QSBR_MODE_SYNC) {
+		/* No other things to do. */
+	} else if (cfg->mode == RTE_RIB_QSBR_MODE_DQ) {
+		/* Init QSBR defer queue. */
+		snprintf(rcu_dq_name, sizeof(rcu_dq_name),
+				"RIB_RCU_%s", rib->name);
+		params.name = rcu_dq_name;
+		params.size = cfg->dq_size;
+		if (params.size == 0)
+			params.size = rib->max_nodes;
+		params.trigger_reclaim_limit = cfg->reclaim_thd;
+		params.max_reclaim_size = cfg->reclaim_max;
+		if (params.max_reclaim_size == 0)
+			params.max_reclaim_size = RTE_RIB_RCU_DQ_RECLAIM_MAX;
+		params.esize = sizeof(void *);	/* node pointer */
+		params.free_fn = __rcu_qsbr_free_resource;
+		params.p = rib;
+		params.v = cfg->v;
+		rib->dq = rte_rcu_qsbr_dq_create(&params);
+		if (rib->dq == NULL) {
+			RTE_LOG(ERR, LPM, "RIB defer queue creation failed\n");
+			return -rte_errno;
+		}
+	} else {
+		return -EINVAL;
+	}
+	rib->rcu_mode = cfg->mode;
+	rib->v = cfg->v;
+
+	return 0;
+}
+
 struct rte_rib *
 rte_rib_create(const char *name, int socket_id, const struct rte_rib_conf *conf)
 {
@@ -521,9 +815,13 @@ rte_rib_free(struct rte_rib *rib)
 
 	rte_mcfg_tailq_write_unlock();
 
+	/* no reader left, free the nodes at once */
+	rib->v = NULL;
 	while ((tmp = rte_rib_get_nxt(rib, 0, 0, tmp,
 			RTE_RIB_GET_NXT_ALL)) != NULL)
 		rte_rib_remove(rib, tmp->ip, tmp->depth);
+	if (rib->dq != NULL)
+		rte_rcu_qsbr_dq_delete(rib->dq);
 
 	rte_mempool_free(rib->node_pool);
 	rte_free(rib);
@@ -16,12 +16,19 @@
  * All functions in this file may be changed or removed without prior notice.
  *
  * Level compressed tree implementation for IPv4 Longest Prefix Match
+ *
+ * The RIB is not thread safe for writers. Once a QSBR variable is
+ * associated with the RIB, see rte_rib_rcu_qsbr_add(), readers registered
+ * on it may look up and walk the RIB concurrently with a writer: the nodes
+ * they get stay valid until they report a quiescent state, and a walk sees
+ * each route that is not changed during the walk.
  */
 
 #include <stdlib.h>
 #include <stdint.h>
 
 #include <rte_compat.h>
+#include <rte_rcu_qsbr.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -37,6 +44,17 @@ enum {
 	RTE_RIB_GET_NXT_COVER
 };
 
+/** @internal Default RCU defer queue entries to reclaim in one go. */
+#define RTE_RIB_RCU_DQ_RECLAIM_MAX	16
+
+/** RCU reclamation modes */
+enum rte_rib_qsbr_mode {
+	/** Create defer queue for reclaim. */
+	RTE_RIB_QSBR_MODE_DQ = 0,
+	/** Use blocking mode reclaim. No defer queue created. */
+	RTE_RIB_QSBR_MODE_SYNC
+};
+
 struct rte_rib;
 struct rte_rib_node;
 
@@ -52,6 +70,22 @@ struct rte_rib_conf {
 	int	max_nodes;
 };
 
+/** RIB RCU QSBR configuration structure. */
+struct rte_rib_rcu_config {
+	struct rte_rcu_qsbr *v;	/* RCU QSBR variable. */
+	/* Mode of RCU QSBR. RTE_RIB_QSBR_MODE_xxx
+	 * '0' for default: create defer queue for reclaim.
+	 */
+	enum rte_rib_qsbr_mode mode;
+	uint32_t dq_size;	/* RCU defer queue size.
+				 * default: max_nodes.
+				 */
+	uint32_t reclaim_thd;	/* Threshold to trigger auto reclaim. */
+	uint32_t reclaim_max;	/* Max entries to reclaim in one go.
+				 * default: RTE_RIB_RCU_DQ_RECLAIM_MAX.
+				 */
+};
+
 /**
  * Get an IPv4 mask from prefix length
  * It is caller responsibility to make sure depth is not bigger than 32
@@ -172,6 +206,58 @@ __rte_experimental
 struct rte_rib_node *
 rte_rib_insert(struct rte_rib *rib, uint32_t ip, uint8_t depth);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Insert a list of prefixes into the RIB, sorted by ascending masked
+ * address then ascending depth, without duplicate.
+ * Into an empty RIB the tree is built bottom-up, out of the RIB, and
+ * then made visible at once. Otherwise the prefixes are inserted
+ * one by one.
+ *
+ * @param rib
+ *  RIB object handle
+ * @param ips
+ *  nets to be inserted to the RIB
+ * @param depths
+ *  prefix lengths
+ * @param next_hops
+ *  next hops to set to the new nodes, or NULL to leave them to 0
+ * @param n
+ *  number of prefixes
+ * @return
+ *  0 on success, all the prefixes are inserted
+ *  -EINVAL on invalid parameters or unsorted prefixes
+ *  -EEXIST if a prefix is already in the RIB
+ *  -ENOMEM if there are not enough nodes left
+ *  on failure the RIB is left unchanged
+ */
+__rte_experimental
+int
+rte_rib_insert_bulk(struct rte_rib *rib, const uint32_t *ips,
+	const uint8_t *depths, const uint64_t *next_hops, unsigned int n);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Remove a list of prefixes from the RIB
+ *
+ * @param rib
+ *  RIB object handle
+ * @param ips
+ *  nets to be removed from the RIB
+ * @param depths
+ *  prefix lengths
+ * @param n
+ *  number of prefixes
+ */
+__rte_experimental
+void
+rte_rib_remove_bulk(struct rte_rib *rib, const uint32_t *ips,
+	const uint8_t *depths, unsigned int n);
+
 /**
  * Get an ip from rte_rib_node
  *
@@ -289,6 +375,28 @@ __rte_experimental
 void
 rte_rib_free(struct rte_rib *rib);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Associate RCU QSBR variable with a RIB object, so that the nodes
+ * removed from the tree are reused only once the readers registered
+ * on the QSBR variable are done with them.
+ *
+ * @param rib
+ *   RIB object handle
+ * @param cfg
+ *   RCU QSBR configuration
+ * @return
+ *   0 on success
+ *   -EINVAL on invalid parameters
+ *   -EEXIST if a QSBR variable is already associated
+ *   other negative values on defer queue creation failure
+ */
+__rte_experimental
+int
+rte_rib_rcu_qsbr_add(struct rte_rib *rib, struct rte_rib_rcu_config *cfg);
+
 #ifdef __cplusplus
 }
 #endif
@@ -5,12 +5,14 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 
 #include <rte_eal.h>
 #include <rte_eal_memconfig.h>
 #include <rte_errno.h>
 #include <rte_malloc.h>
 #include <rte_mempool.h>
+#include <rte_rcu_qsbr.h>
 #include <rte_rwlock.h>
 #include <rte_string_fns.h>
 #include <rte_tailq.h>
@@ -21,6 +23,8 @@
 #define RIB6_MAXDEPTH		128
 /* Maximum length of a RIB6 name. */
 #define RTE_RIB6_NAMESIZE	64
+/* Number of nodes taken from the mempool at once by bulk inserts. */
+#define RIB6_BULK_ALLOC		32
 
 TAILQ_HEAD(rte_rib6_list, rte_tailq_entry);
 static struct rte_tailq_elem rte_rib6_tailq = {
@@ -46,6 +50,16 @@ struct rte_rib6 {
 	uint32_t		cur_nodes;
 	uint32_t		cur_routes;
 	int			max_nodes;
+	/* RCU config. */
+	struct rte_rcu_qsbr	*v;		/* RCU QSBR variable. */
+	enum rte_rib6_qsbr_mode	rcu_mode;	/* Blocking, defer queue. */
+	struct rte_rcu_qsbr_dq	*dq;		/* RCU QSBR defer queue. */
+};
+
+/* Nodes taken from the mempool in bulk, not yet used */
+struct node_cache {
+	unsigned int	nb;
+	void		*objs[RIB6_BULK_ALLOC];
 };
 
 static inline bool
@@ -54,10 +68,38 @@ is_valid_node(struct rte_rib6_node *node)
 	return (node->flag & RTE_RIB_VALID_NODE) == RTE_RIB_VALID_NODE;
 }
 
+static inline struct rte_rib6_node *
+get_left(struct rte_rib6_node *node)
+{
+	return __atomic_load_n(&node->left, __ATOMIC_ACQUIRE);
+}
+
+static inline struct rte_rib6_node *
+get_right(struct rte_rib6_node *node)
+{
+	return __atomic_load_n(&node->right, __ATOMIC_ACQUIRE);
+}
+
+static inline struct rte_rib6_node *
+get_parent(struct rte_rib6_node *node)
+{
+	return __atomic_load_n(&node->parent, __ATOMIC_ACQUIRE);
+}
+
+/*
+ * Link a node into the tree, after it has been filled
+ * for the RCU readers walking the tree
+ */
+static inline void
+set_link(struct rte_rib6_node **link, struct rte_rib6_node *node)
+{
+	__atomic_store_n(link, node, __ATOMIC_RELEASE);
+}
+
 static inline bool
 is_right_node(struct rte_rib6_node *node)
 {
-	return node->parent->right == node;
+	return get_right(get_parent(node)) == node;
 }
 
 /*
@@ -93,7 +135,26 @@ static inline struct rte_rib6_node *
 get_nxt_node(struct rte_rib6_node *node,
 	const uint8_t ip[RTE_RIB6_IPV6_ADDR_SIZE])
 {
-	return (get_dir(ip, node->depth)) ? node->right : node->left;
+	return (get_dir(ip, node->depth)) ? get_right(node) : get_left(node);
+}
+
+/*
+ * Length of the common prefix of two addresses
+ */
+static inline int
+get_common_depth(const uint8_t ip1[RTE_RIB6_IPV6_ADDR_SIZE],
+	const uint8_t ip2[RTE_RIB6_IPV6_ADDR_SIZE])
+{
+	uint8_t ip_xor;
+	int i, d;
+
+	for (i = 0, d = 0; i < RTE_RIB6_IPV6_ADDR_SIZE; i++) {
+		ip_xor = ip1[i] ^ ip2[i];
+		if (ip_xor != 0)
+			return d + __builtin_clz(ip_xor << 24);
+		d += 8;
+	}
+	return d;
 }
 
 static struct rte_rib6_node *
@@ -103,19 +164,74 @@ node_alloc(struct rte_rib6 *rib)
 	int ret;
 
 	ret = rte_mempool_get(rib->node_pool, (void *)&ent);
+	if (unlikely(ret != 0) && rib->dq != NULL) {
+		/* If there are no free nodes try to reclaim some. */
+		if (rte_rcu_qsbr_dq_reclaim(rib->dq,
+				RTE_RIB6_RCU_DQ_RECLAIM_MAX,
+				NULL, NULL, NULL) == 0)
+			ret = rte_mempool_get(rib->node_pool, (void *)&ent);
+	}
 	if (unlikely(ret != 0))
 		return NULL;
 	++rib->cur_nodes;
 	return ent;
 }
 
+static struct rte_rib6_node *
+node_cache_alloc(struct rte_rib6 *rib, struct node_cache *cache)
+{
+	if ((cache->nb == 0) && (rte_mempool_get_bulk(rib->node_pool,
+			cache->objs, RIB6_BULK_ALLOC) == 0))
+		cache->nb = RIB6_BULK_ALLOC;
+	if (cache->nb == 0)
+		return node_alloc(rib);
+	++rib->cur_nodes;
+	return cache->objs[--cache->nb];
+}
+
+/*
+ * Give back a node no reader can see, i.e. one that was never linked
+ * into the tree
+ */
 static void
-node_free(struct rte_rib6 *rib, struct rte_rib6_node *ent)
+node_put(struct rte_rib6 *rib, struct rte_rib6_node *ent)
 {
 	--rib->cur_nodes;
 	rte_mempool_put(rib->node_pool, ent);
 }
 
+static void
+__rcu_qsbr_free_resource(void *p, void *data, unsigned int n)
+{
+	struct rte_rib6 *rib = p;
+
+	RTE_SET_USED(n);
+	rte_mempool_put(rib->node_pool, *(void **)data);
+}
+
+/*
+ * Free a node unlinked from the tree,
+ * once the RCU readers are done with it
+ */
+static void
+node_free(struct rte_rib6 *rib, struct rte_rib6_node *ent)
+{
+	--rib->cur_nodes;
+	if (rib->v == NULL) {
+		rte_mempool_put(rib->node_pool, ent);
+	} else if (rib->rcu_mode == RTE_RIB6_QSBR_MODE_DQ &&
+			rte_rcu_qsbr_dq_enqueue(rib->dq, (void *)&ent) == 0) {
+		/* Freed once the readers are done with it. */
+	} else {
+		/*
+		 * Blocking mode, or defer queue full:
+		 * wait for quiescent state change.
+		 */
+		rte_rcu_qsbr_synchronize(rib->v, RTE_QSBR_THRID_INVALID);
+		rte_mempool_put(rib->node_pool, ent);
+	}
+}
+
 struct rte_rib6_node *
 rte_rib6_lookup(struct rte_rib6 *rib,
 	const uint8_t ip[RTE_RIB6_IPV6_ADDR_SIZE])
@@ -127,7 +243,7 @@ rte_rib6_lookup(struct rte_rib6 *rib,
 		rte_errno = EINVAL;
 		return NULL;
 	}
-	cur = rib->tree;
+	cur = __atomic_load_n(&rib->tree, __ATOMIC_ACQUIRE);
 
 	while ((cur != NULL) && is_covered(ip, cur->ip, cur->depth)) {
 		if (is_valid_node(cur))
@@ -145,9 +261,9 @@ rte_rib6_lookup_parent(struct rte_rib6_node *ent)
 	if (ent == NULL)
 		return NULL;
 
-	tmp = ent->parent;
+	tmp = get_parent(ent);
 	while ((tmp != NULL) && (!is_valid_node(tmp)))
-		tmp = tmp->parent;
+		tmp = get_parent(tmp);
 
 	return tmp;
 }
@@ -164,7 +280,7 @@ rte_rib6_lookup_exact(struct rte_rib6 *rib,
 		rte_errno = EINVAL;
 		return NULL;
 	}
-	cur = rib->tree;
+	cur = __atomic_load_n(&rib->tree, __ATOMIC_ACQUIRE);
 
 	for (i = 0; i < RTE_RIB6_IPV6_ADDR_SIZE; i++)
 		tmp_ip[i] = ip[i] & get_msk_part(depth, i);
@@ -208,20 +324,21 @@ rte_rib6_get_nxt(struct rte_rib6 *rib,
 		tmp_ip[i] = ip[i] & get_msk_part(depth, i);
 
 	if (last == NULL) {
-		tmp = rib->tree;
+		tmp = __atomic_load_n(&rib->tree, __ATOMIC_ACQUIRE);
 		while ((tmp) && (tmp->depth < depth))
 			tmp = get_nxt_node(tmp, tmp_ip);
 	} else {
 		tmp = last;
-		while ((tmp->parent != NULL) && (is_right_node(tmp) ||
-				(tmp->parent->right == NULL))) {
-			tmp = tmp->parent;
+		while ((get_parent(tmp) != NULL) && (is_right_node(tmp) ||
+				(get_right(get_parent(tmp)) == NULL))) {
+			tmp = get_parent(tmp);
 			if (is_valid_node(tmp) &&
 					(is_covered(tmp->ip, tmp_ip, depth) &&
 					(tmp->depth > depth)))
 				return tmp;
 		}
-		tmp = (tmp->parent != NULL) ? tmp->parent->right : NULL;
+		tmp = (get_parent(tmp) != NULL) ?
+			get_right(get_parent(tmp)) : NULL;
 	}
 	while (tmp) {
 		if (is_valid_node(tmp) &&
@@ -231,7 +348,8 @@ rte_rib6_get_nxt(struct rte_rib6 *rib,
 			if (flag == RTE_RIB6_GET_NXT_COVER)
 				return prev;
 		}
-		tmp = (tmp->left != NULL) ? tmp->left : tmp->right;
+		tmp = (get_left(tmp) != NULL) ? get_left(tmp) :
+			get_right(tmp);
 	}
 	return prev;
 }
@@ -253,16 +371,16 @@ rte_rib6_remove(struct rte_rib6 *rib,
 			return;
 		child = (cur->left == NULL) ? cur->right : cur->left;
 		if (child != NULL)
-			child->parent = cur->parent;
+			set_link(&child->parent, cur->parent);
 		if (cur->parent == NULL) {
-			rib->tree = child;
+			set_link(&rib->tree, child);
 			node_free(rib, cur);
 			return;
 		}
 		if (cur->parent->left == cur)
-			cur->parent->left = child;
+			set_link(&cur->parent->left, child);
 		else
-			cur->parent->right = child;
+			set_link(&cur->parent->right, child);
 		prev = cur;
 		cur = cur->parent;
 		node_free(rib, prev);
@@ -310,15 +428,16 @@ rte_rib6_insert(struct rte_rib6 *rib,
 	rte_rib6_copy_addr(new_node->ip, tmp_ip);
 	new_node->depth = depth;
 	new_node->flag = RTE_RIB_VALID_NODE;
+	new_node->nh = 0;
 
 	/* traverse down the tree to find matching node or closest matching */
 	while (1) {
 		/* insert as the last node in the branch */
 		if (*tmp == NULL) {
-			*tmp = new_node;
 			new_node->parent = prev;
+			set_link(tmp, new_node);
 			++rib->cur_routes;
-			return *tmp;
+			return new_node;
 		}
 		/*
 		 * Intermediate node found.
@@ -328,7 +447,8 @@ rte_rib6_insert(struct rte_rib6 *rib,
 		 */
 		if (rte_rib6_is_equal(tmp_ip, (*tmp)->ip) &&
 				(depth == (*tmp)->depth)) {
-			node_free(rib, new_node);
+			node_put(rib, new_node);
+			(*tmp)->nh = 0;
 			(*tmp)->flag |= RTE_RIB_VALID_NODE;
 			++rib->cur_routes;
 			return *tmp;
@@ -361,6 +481,10 @@ rte_rib6_insert(struct rte_rib6 *rib,
 	for (i = 0; i < RTE_RIB6_IPV6_ADDR_SIZE; i++)
 		common_prefix[i] = tmp_ip[i] & get_msk_part(common_depth, i);
 
+	/*
+	 * The new nodes are filled before they are linked into the tree,
+	 * so that the RCU readers only ever see complete nodes.
+	 */
 	if (rte_rib6_is_equal(common_prefix, tmp_ip) &&
 			(common_depth == depth)) {
 		/* insert as a parent */
@@ -369,13 +493,13 @@ rte_rib6_insert(struct rte_rib6 *rib,
 		else
 			new_node->left = *tmp;
 		new_node->parent = (*tmp)->parent;
-		(*tmp)->parent = new_node;
-		*tmp = new_node;
+		set_link(&(*tmp)->parent, new_node);
+		set_link(tmp, new_node);
 	} else {
 		/* create intermediate node */
 		common_node = node_alloc(rib);
 		if (common_node == NULL) {
-			node_free(rib, new_node);
+			node_put(rib, new_node);
 			rte_errno = ENOMEM;
 			return NULL;
 		}
@@ -384,7 +508,6 @@ rte_rib6_insert(struct rte_rib6 *rib,
 		common_node->flag = 0;
 		common_node->parent = (*tmp)->parent;
 		new_node->parent = common_node;
-		(*tmp)->parent = common_node;
 		if (get_dir((*tmp)->ip, common_depth) == 1) {
 			common_node->left = new_node;
 			common_node->right = *tmp;
@@ -392,12 +515,168 @@ rte_rib6_insert(struct rte_rib6 *rib,
 			common_node->left = *tmp;
 			common_node->right = new_node;
 		}
-		*tmp = common_node;
+		set_link(&(*tmp)->parent, common_node);
+		set_link(tmp, common_node);
 	}
 	++rib->cur_routes;
 	return new_node;
 }
 
+/*
+ * Build the tree of a sorted list of routes bottom-up, out of the RIB.
+ * A route never covers the routes before it, it goes either under the
+ * deepest node covering it, or next to the node it is the right
+ * neighbour of, under a new intermediate node.
+ */
+static struct rte_rib6_node *
+build_tree(struct rte_rib6 *rib, const uint8_t ips[][RTE_RIB6_IPV6_ADDR_SIZE],
+	const uint8_t *depths, const uint64_t *next_hops, unsigned int n)
+{
+	struct rte_rib6_node *root = NULL, *last = NULL, *up;
+	struct rte_rib6_node *node, *common_node, **link;
+	struct node_cache cache = { .nb = 0 };
+	unsigned int i;
+	int d, j;
+
+	for (i = 0; i < n; i++) {
+		node = node_cache_alloc(rib, &cache);
+		if (node == NULL)
+			goto free_tree;
+		node->left = NULL;
+		node->right = NULL;
+		for (j = 0; j < RTE_RIB6_IPV6_ADDR_SIZE; j++)
+			node->ip[j] = ips[i][j] & get_msk_part(depths[i], j);
+		node->depth = depths[i];
+		node->flag = RTE_RIB_VALID_NODE;
+		node->nh = (next_hops != NULL) ? next_hops[i] : 0;
+
+		/* deepest node covering the route */
+		for (up = last; (up != NULL) && ((up->depth >= depths[i]) ||
+				!is_covered(node->ip, up->ip, up->depth));
+				up = up->parent)
+			;
+		if (up == NULL)
+			link = &root;
+		else
+			link = get_dir(node->ip, up->depth) ? &up->right :
+				&up->left;
+		node->parent = up;
+
+		if (*link != NULL) {
+			common_node = node_cache_alloc(rib, &cache);
+			if (common_node == NULL) {
+				node_put(rib, node);
+				goto free_tree;
+			}
+			d = get_common_depth(node->ip, (*link)->ip);
+			for (j = 0; j < RTE_RIB6_IPV6_ADDR_SIZE; j++)
+				common_node->ip[j] = node->ip[j] &
+					get_msk_part(d, j);
+			common_node->depth = d;
+			common_node->flag = 0;
+			common_node->parent = up;
+			common_node->left = *link;
+			common_node->right = node;
+			(*link)->parent = common_node;
+			node->parent = common_node;
+			*link = common_node;
+		} else
+			*link = node;
+		last = node;
+	}
+	rte_mempool_put_bulk(rib->node_pool, cache.objs, cache.nb);
+	return root;
+
+free_tree:
+	rte_mempool_put_bulk(rib->node_pool, cache.objs, cache.nb);
+	for (node = root; node != NULL; ) {
+		if (node->left != NULL)
+			node = node->left;
+		else if (node->right != NULL)
+			node = node->right;
+		else {
+			up = node->parent;
+			if (up != NULL) {
+				if (up->left == node)
+					up->left = NULL;
+				else
+					up->right = NULL;
+			}
+			node_put(rib, node);
+			node = up;
+		}
+	}
+	rte_errno = ENOMEM;
+	return NULL;
+}
+
+int
+rte_rib6_insert_bulk(struct rte_rib6 *rib,
+	const uint8_t ips[][RTE_RIB6_IPV6_ADDR_SIZE], const uint8_t *depths,
+	const uint64_t *next_hops, unsigned int n)
+{
+	uint8_t ip[RTE_RIB6_IPV6_ADDR_SIZE], prev_ip[RTE_RIB6_IPV6_ADDR_SIZE];
+	struct rte_rib6_node *node;
+	unsigned int i;
+	int j, ret;
+
+	if ((rib == NULL) || (ips == NULL) || (depths == NULL))
+		return -EINVAL;
+
+	/* the routes must be sorted by prefix then depth, without duplicate */
+	for (i = 0; i < n; i++) {
+		if (depths[i] > RIB6_MAXDEPTH)
+			return -EINVAL;
+		for (j = 0; j < RTE_RIB6_IPV6_ADDR_SIZE; j++)
+			ip[j] = ips[i][j] & get_msk_part(depths[i], j);
+		if (i != 0) {
+			ret = memcmp(ip, prev_ip, RTE_RIB6_IPV6_ADDR_SIZE);
+			if ((ret < 0) || ((ret == 0) &&
+					(depths[i] <= depths[i - 1])))
+				return -EINVAL;
+		}
+		rte_rib6_copy_addr(prev_ip, ip);
+	}
+	if (n == 0)
+		return 0;
+
+	if (rib->tree == NULL) {
+		node = build_tree(rib, ips, depths, next_hops, n);
+		if (node == NULL)
+			return -rte_errno;
+		rib->cur_routes += n;
+		set_link(&rib->tree, node);
+		return 0;
+	}
+
+	for (i = 0; i < n; i++) {
+		node = rte_rib6_insert(rib, ips[i], depths[i]);
+		if (node == NULL) {
+			ret = -rte_errno;
+			while (i-- > 0)
+				rte_rib6_remove(rib, ips[i], depths[i]);
+			return ret;
+		}
+		if (next_hops != NULL)
+			node->nh = next_hops[i];
+	}
+	return 0;
+}
+
+void
+rte_rib6_remove_bulk(struct rte_rib6 *rib,
+	const uint8_t ips[][RTE_RIB6_IPV6_ADDR_SIZE], const uint8_t *depths,
+	unsigned int n)
+{
+	unsigned int i;
+
+	if ((rib == NULL) || (ips == NULL) || (depths == NULL))
+		return;
+
+	for (i = 0; i < n; i++)
+		rte_rib6_remove(rib, ips[i], depths[i]);
+}
+
 int
 rte_rib6_get_ip(const struct rte_rib6_node *node,
 		uint8_t ip[RTE_RIB6_IPV6_ADDR_SIZE])
@@ -449,6 +728,50 @@ rte_rib6_set_nh(struct rte_rib6_node *node, uint64_t nh)
 	return 0;
 }
 
+int
+rte_rib6_rcu_qsbr_add(struct rte_rib6 *rib, struct rte_rib6_rcu_config *cfg)
+{
+	struct rte_rcu_qsbr_dq_parameters params = {0};
+	char rcu_dq_name[RTE_RCU_QSBR_DQ_NAMESIZE];
+
+	if ((rib == NULL) || (cfg == NULL) || (cfg->v == NULL))
+		return -EINVAL;
+
+	if (rib->v != NULL)
+		return -EEXIST;
+
+	if (cfg->mode == RTE_RIB6_QSBR_MODE_SYNC) {
+		/* No other things to do. */
+	} else if (cfg->mode == RTE_RIB6_QSBR_MODE_DQ) {
+		/* Init QSBR defer queue. */
+		snprintf(rcu_dq_name, sizeof(rcu_dq_name),
+				"RIB6_RCU_%s", rib->name);
+		params.name = rcu_dq_name;
+		params.size = cfg->dq_size;
+		if (params.size == 0)
+			params.size = rib->max_nodes;
+		params.trigger_reclaim_limit = cfg->reclaim_thd;
+		params.max_reclaim_size = cfg->reclaim_max;
+		if (params.max_reclaim_size == 0)
+			params.max_reclaim_size = RTE_RIB6_RCU_DQ_RECLAIM_MAX;
+		params.esize = sizeof(void *);	/* node pointer */
+		params.free_fn = __rcu_qsbr_free_resource;
+		params.p = rib;
+		params.v = cfg->v;
+		rib->dq = rte_rcu_qsbr_dq_create(&params);
+		if (rib->dq == NULL) {
+			RTE_LOG(ERR, LPM, "RIB6 defer queue creation failed\n");
+			return -rte_errno;
+		}
+	} else {
+		return -EINVAL;
+	}
+	rib->rcu_mode = cfg->mode;
+	rib->v = cfg->v;
+
+	return 0;
+}
+
 struct rte_rib6 *
 rte_rib6_create(const char *name, int socket_id,
 		const struct rte_rib6_conf *conf)
@@ -588,9 +911,13 @@ rte_rib6_free(struct rte_rib6 *rib)
 
 	rte_mcfg_tailq_write_unlock();
 
+	/* no reader left, free the nodes at once */
+	rib->v = NULL;
 	while ((tmp = rte_rib6_get_nxt(rib, 0, 0, tmp,
 			RTE_RIB6_GET_NXT_ALL)) != NULL)
 		rte_rib6_remove(rib, tmp->ip, tmp->depth);
+	if (rib->dq != NULL)
+		rte_rcu_qsbr_dq_delete(rib->dq);
 
 	rte_mempool_free(rib->node_pool);
 
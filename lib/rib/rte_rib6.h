@@ -16,11 +16,18 @@
  * All functions in this file may be changed or removed without prior notice.
  *
  * Level compressed tree implementation for IPv6 Longest Prefix Match
+ *
+ * The RIB is not thread safe for writers. Once a QSBR variable is
+ * associated with the RIB, see rte_rib6_rcu_qsbr_add(), readers registered
+ * on it may look up and walk the RIB concurrently with a writer: the nodes
+ * they get stay valid until they report a quiescent state, and a walk sees
+ * each route that is not changed during the walk.
  */
 
 #include <rte_memcpy.h>
 #include <rte_compat.h>
 #include <rte_common.h>
+#include <rte_rcu_qsbr.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -38,6 +45,17 @@ enum {
 	RTE_RIB6_GET_NXT_COVER
 };
 
+/** @internal Default RCU defer queue entries to reclaim in one go. */
+#define RTE_RIB6_RCU_DQ_RECLAIM_MAX	16
+
+/** RCU reclamation modes */
+enum rte_rib6_qsbr_mode {
+	/** Create defer queue for reclaim. */
+	RTE_RIB6_QSBR_MODE_DQ = 0,
+	/** Use blocking mode reclaim. No defer queue created. */
+	RTE_RIB6_QSBR_MODE_SYNC
+};
+
 struct rte_rib6;
 struct rte_rib6_node;
 
@@ -53,6 +71,22 @@ struct rte_rib6_conf {
 	int	max_nodes;
 };
 
+/** RIB6 RCU QSBR configuration structure. */
+struct rte_rib6_rcu_config {
+	struct rte_rcu_qsbr *v;	/* RCU QSBR variable. */
+	/* Mode of RCU QSBR. RTE_RIB6_QSBR_MODE_xxx
+	 * '0' for default: create defer queue for reclaim.
+	 */
+	enum rte_rib6_qsbr_mode mode;
+	uint32_t dq_size;	/* RCU defer queue size.
+				 * default: max_nodes.
+				 */
+	uint32_t reclaim_thd;	/* Threshold to trigger auto reclaim. */
+	uint32_t reclaim_max;	/* Max entries to reclaim in one go.
+				 * default: RTE_RIB6_RCU_DQ_RECLAIM_MAX.
+				 */
+};
+
 /**
  * Copy IPv6 address from one location to another
  *
@@ -226,6 +260,60 @@ struct rte_rib6_node *
 rte_rib6_insert(struct rte_rib6 *rib,
 	const uint8_t ip[RTE_RIB6_IPV6_ADDR_SIZE], uint8_t depth);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Insert a list of prefixes into the RIB, sorted by ascending masked
+ * address then ascending depth, without duplicate.
+ * Into an empty RIB the tree is built bottom-up, out of the RIB, and
+ * then made visible at once. Otherwise the prefixes are inserted
+ * one by one.
+ *
+ * @param rib
+ *  RIB object handle
+ * @param ips
+ *  nets to be inserted to the RIB
+ * @param depths
+ *  prefix lengths
+ * @param next_hops
+ *  next hops to set to the new nodes, or NULL to leave them to 0
+ * @param n
+ *  number of prefixes
+ * @return
+ *  0 on success, all the prefixes are inserted
+ *  -EINVAL on invalid parameters or unsorted prefixes
+ *  -EEXIST if a prefix is already in the RIB
+ *  -ENOMEM if there are not enough nodes left
+ *  on failure the RIB is left unchanged
+ */
+__rte_experimental
+int
+rte_rib6_insert_bulk(struct rte_rib6 *rib,
+	const uint8_t ips[][RTE_RIB6_IPV6_ADDR_SIZE], const uint8_t *depths,
+	const uint64_t *next_hops, unsigned int n);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Remove a list of prefixes from the RIB
+ *
+ * @param rib
+ *  RIB object handle
+ * @param ips
+ *  nets to be removed from the RIB
+ * @param depths
+ *  prefix lengths
+ * @param n
+ *  number of prefixes
+ */
+__rte_experimental
+void
+rte_rib6_remove_bulk(struct rte_rib6 *rib,
+	const uint8_t ips[][RTE_RIB6_IPV6_ADDR_SIZE], const uint8_t *depths,
+	unsigned int n);
+
 /**
  * Get an ip from rte_rib6_node
  *
@@ -344,6 +432,28 @@ __rte_experimental
 void
 rte_rib6_free(struct rte_rib6 *rib);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Associate RCU QSBR variable with a RIB object, so that the nodes
+ * removed from the tree are reused only once the readers registered
+ * on the QSBR variable are done with them.
+ *
+ * @param rib
+ *   RIB object handle
+ * @param cfg
+ *   RCU QSBR configuration
+ * @return
+ *   0 on success
+ *   -EINVAL on invalid parameters
+ *   -EEXIST if a QSBR variable is already associated
+ *   other negative values on defer queue creation failure
+ */
+__rte_experimental
+int
+rte_rib6_rcu_qsbr_add(struct rte_rib6 *rib, struct rte_rib6_rcu_config *cfg);
+
 #ifdef __cplusplus
 }
 #endif
@@ -14,8 +14,15 @@
 #include <inttypes.h>
 #include <errno.h>
 #include <sys/queue.h>
+#ifdef RTE_EXEC_ENV_LINUX
+#include <poll.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#endif
 
 #include <rte_common.h>
+#include <rte_cpuflags.h>
+#include <rte_cycles.h>
 #include <rte_log.h>
 #include <rte_memory.h>
 #include <rte_memzone.h>
@@ -28,6 +35,7 @@
 #include <rte_lcore.h>
 #include <rte_branch_prediction.h>
 #include <rte_errno.h>
+#include <rte_power_intrinsics.h>
 #include <rte_string_fns.h>
 #include <rte_spinlock.h>
 #include <rte_tailq.h>
@@ -45,7 +53,7 @@ EAL_REGISTER_TAILQ(rte_ring_tailq)
 /* mask of all valid flag values to ring_create() */
 #define RING_F_MASK (RING_F_SP_ENQ | RING_F_SC_DEQ | RING_F_EXACT_SZ | \
 		     RING_F_MP_RTS_ENQ | RING_F_MC_RTS_DEQ |	       \
-		     RING_F_MP_HTS_ENQ | RING_F_MC_HTS_DEQ)
+		     RING_F_MP_HTS_ENQ | RING_F_MC_HTS_DEQ | RING_F_NOTIFY)
 
 /* true if x is a power of 2 */
 #define POWEROF2(x) ((((x)-1) & (x)) == 0)
@@ -178,6 +186,123 @@ get_sync_type(uint32_t flags, enum rte_ring_sync_type *prod_st,
 	return 0;
 }
 
+#ifdef RTE_EXEC_ENV_LINUX
+/* pid of this process, once it created a ring eventfd */
+static int ring_notify_pid;
+#endif
+
+/* without the power monitor, the consumer waits on an eventfd */
+static int
+ring_notify_init(struct rte_ring *r)
+{
+	struct rte_cpu_intrinsics intrinsics;
+
+	rte_cpu_get_intrinsics_support(&intrinsics);
+	if (intrinsics.power_monitor)
+		return 0;
+
+#ifdef RTE_EXEC_ENV_LINUX
+	r->notify.fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (r->notify.fd < 0) {
+		RTE_LOG(ERR, RING, "Cannot create ring eventfd: %s\n",
+			strerror(errno));
+		return -errno;
+	}
+	if (ring_notify_pid == 0)
+		ring_notify_pid = getpid();
+	r->notify.pid = ring_notify_pid;
+#endif
+
+	return 0;
+}
+
+static void
+ring_notify_fini(struct rte_ring *r)
+{
+#ifdef RTE_EXEC_ENV_LINUX
+	if ((r->flags & RING_F_NOTIFY) && r->notify.fd >= 0 &&
+			r->notify.pid == ring_notify_pid) {
+		close(r->notify.fd);
+		r->notify.fd = -1;
+	}
+#else
+	RTE_SET_USED(r);
+#endif
+}
+
+/* sleep until the armed flag is cleared by a producer, or the deadline */
+static void
+ring_notify_sleep(struct rte_ring *r, uint64_t deadline)
+{
+	struct rte_power_monitor_cond pmc;
+
+#ifdef RTE_EXEC_ENV_LINUX
+	if (r->notify.fd >= 0 && r->notify.pid == ring_notify_pid) {
+		uint64_t now = rte_get_tsc_cycles();
+		struct pollfd pfd = {
+			.fd = r->notify.fd,
+			.events = POLLIN,
+		};
+		eventfd_t value;
+
+		if (now < deadline &&
+				poll(&pfd, 1, (int)RTE_MIN((deadline - now) *
+					MS_PER_S / rte_get_tsc_hz() + 1,
+					(uint64_t)INT32_MAX)) > 0)
+			eventfd_read(r->notify.fd, &value);
+		return;
+	}
+#endif
+
+	/* the sleep is aborted if the flag is already cleared */
+	pmc.addr = &r->notify.armed;
+	pmc.val = 0;
+	pmc.mask = UINT32_MAX;
+	pmc.size = sizeof(r->notify.armed);
+	if (rte_power_monitor(&pmc, deadline) != 0)
+		rte_pause();
+}
+
+void
+rte_ring_notify_wake(struct rte_ring *r)
+{
+	/* the eventfd is only valid in the process which created it */
+#ifdef RTE_EXEC_ENV_LINUX
+	if (r->notify.fd >= 0 && r->notify.pid == ring_notify_pid)
+		eventfd_write(r->notify.fd, 1);
+#else
+	RTE_SET_USED(r);
+#endif
+}
+
+int
+rte_ring_notify_wait(struct rte_ring *r, uint64_t timeout_us)
+{
+	uint64_t deadline;
+
+	if (r == NULL || (r->flags & RING_F_NOTIFY) == 0)
+		return -EINVAL;
+
+	deadline = rte_get_tsc_cycles() +
+		timeout_us * rte_get_tsc_hz() / US_PER_S;
+
+	while (rte_ring_empty(r)) {
+		if (rte_get_tsc_cycles() >= deadline)
+			return -ETIMEDOUT;
+
+		/* Set the flag before checking the ring is still empty,
+		 * the producers read it after updating their tail.
+		 */
+		__atomic_store_n(&r->notify.armed, 1, __ATOMIC_RELAXED);
+		rte_atomic_thread_fence(__ATOMIC_SEQ_CST);
+		if (rte_ring_empty(r))
+			ring_notify_sleep(r, deadline);
+		__atomic_store_n(&r->notify.armed, 0, __ATOMIC_RELAXED);
+	}
+
+	return 0;
+}
+
 int
 rte_ring_init(struct rte_ring *r, const char *name, unsigned int count,
 	unsigned int flags)
@@ -241,6 +366,10 @@ rte_ring_init(struct rte_ring *r, const char *name, unsigned int count,
 	if (flags & RING_F_MC_RTS_DEQ)
 		rte_ring_set_cons_htd_max(r, r->capacity / HTD_MAX_DEF);
 
+	r->notify.fd = -1;
+	if (flags & RING_F_NOTIFY)
+		return ring_notify_init(r);
+
 	return 0;
 }
 
@@ -294,14 +423,20 @@ rte_ring_create_elem(const char *name, unsigned int esize, unsigned int count,
 					 mz_flags, __alignof__(*r));
 	if (mz != NULL) {
 		r = mz->addr;
-		/* no need to check return value here, we already checked the
-		 * arguments above */
-		rte_ring_init(r, name, requested_count, flags);
-
-		te->data = (void *) r;
-		r->memzone = mz;
-
-		TAILQ_INSERT_TAIL(ring_list, te, next);
+		/* the arguments were checked above, but the eventfd of a
+		 * RING_F_NOTIFY ring may fail to be created */
+		ret = rte_ring_init(r, name, requested_count, flags);
+		if (ret < 0) {
+			rte_memzone_free(mz);
+			rte_free(te);
+			rte_errno = -ret;
+			r = NULL;
+		} else {
+			te->data = (void *) r;
+			r->memzone = mz;
+
+			TAILQ_INSERT_TAIL(ring_list, te, next);
+		}
 	} else {
 		r = NULL;
 		RTE_LOG(ERR, RING, "Cannot reserve memory\n");
@@ -341,6 +476,8 @@ rte_ring_free(struct rte_ring *r)
 		return;
 	}
 
+	ring_notify_fini(r);
+
 	if (rte_memzone_free(r->memzone) != 0) {
 		RTE_LOG(ERR, RING, "Cannot free memory\n");
 		return;
@@ -107,6 +107,8 @@ ssize_t rte_ring_get_memsize(unsigned int count);
  *        is "multi-consumer HTS mode".
  *     If none of these flags is set, then default "multi-consumer"
  *     behavior is selected.
+ *   - RING_F_NOTIFY: If this flag is set, the consumer can wait for
+ *     objects with rte_ring_notify_wait().
  * @return
  *   0 on success, or a negative value on error.
  */
@@ -160,6 +162,8 @@ int rte_ring_init(struct rte_ring *r, const char *name, unsigned int count,
  *        is "multi-consumer HTS mode".
  *     If none of these flags is set, then default "multi-consumer"
  *     behavior is selected.
+ *   - RING_F_NOTIFY: If this flag is set, the consumer can wait for
+ *     objects with rte_ring_notify_wait().
  * @return
  *   On success, the pointer to the new allocated ring. NULL on error with
  *    rte_errno set appropriately. Possible errno values include:
@@ -477,6 +481,36 @@ rte_ring_dequeue(struct rte_ring *r, void **obj_p)
 void
 rte_ring_reset(struct rte_ring *r);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Wait until the ring is not empty, or the timeout expires.
+ *
+ * The ring must be created with the RING_F_NOTIFY flag. Instead of polling
+ * the ring, the calling lcore enters an optimized power state with
+ * rte_power_monitor() when the CPU supports it, or else waits on an eventfd,
+ * until a producer wakes it up. The producers check whether a consumer is
+ * waiting on each enqueue, and only wake it up once.
+ *
+ * The eventfd is only available on Linux, to the process creating the ring:
+ * the enqueues of the other processes do not wake up the consumer, which
+ * then waits for the timeout.
+ * The enqueues of the peek API do not wake up the consumer either.
+ *
+ * @param r
+ *   A pointer to the ring structure.
+ * @param timeout_us
+ *   Maximum time to wait, in microseconds.
+ * @return
+ *   - 0: The ring is not empty.
+ *   - -ETIMEDOUT: The ring is still empty after the timeout.
+ *   - -EINVAL: The ring was not created with RING_F_NOTIFY.
+ */
+__rte_experimental
+int
+rte_ring_notify_wait(struct rte_ring *r, uint64_t timeout_us);
+
 /**
  * Return the number of entries in a ring.
  *
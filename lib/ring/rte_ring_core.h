@@ -110,6 +110,19 @@ struct rte_ring_hts_headtail {
 	enum rte_ring_sync_type sync_type;  /**< sync type of prod/cons */
 };
 
+/**
+ * @internal Consumer wait state of a ring created with RING_F_NOTIFY,
+ * see rte_ring_notify_wait().
+ */
+struct rte_ring_notify {
+	/** Set by a waiting consumer, cleared by the producer waking it up. */
+	volatile uint32_t armed;
+	/** Eventfd the consumer waits on, -1 with rte_power_monitor(). */
+	int fd;
+	/** Process owning the eventfd. */
+	int pid;
+};
+
 /**
  * An RTE ring structure.
  *
@@ -135,7 +148,8 @@ struct rte_ring {
 	uint32_t mask;           /**< Mask (size-1) of ring. */
 	uint32_t capacity;       /**< Usable size of ring */
 
-	char pad0 __rte_cache_aligned; /**< empty cache line */
+	/** Consumer wait state, in the cache line before the producer. */
+	struct rte_ring_notify notify __rte_cache_aligned;
 
 	/** Ring producer status. */
 	RTE_STD_C11
@@ -177,6 +191,23 @@ struct rte_ring {
 #define RING_F_MP_HTS_ENQ 0x0020 /**< The default enqueue is "MP HTS". */
 #define RING_F_MC_HTS_DEQ 0x0040 /**< The default dequeue is "MC HTS". */
 
+/**
+ * The consumer can wait for objects with rte_ring_notify_wait(), the
+ * producers waking it up.
+ */
+#define RING_F_NOTIFY 0x0080
+
+/**
+ * @internal Wake up the consumer of a ring created with RING_F_NOTIFY
+ * waiting on its eventfd, after its armed flag was cleared.
+ * Called from the inline enqueue functions, so it is part of the stable ABI.
+ *
+ * @param r
+ *   A pointer to the ring structure.
+ */
+void
+rte_ring_notify_wake(struct rte_ring *r);
+
 #ifdef __cplusplus
 }
 #endif
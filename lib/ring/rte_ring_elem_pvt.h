@@ -287,6 +287,33 @@ __rte_ring_dequeue_elems(struct rte_ring *r, uint32_t cons_head,
 #include "rte_ring_generic_pvt.h"
 #endif
 
+/**
+ * @internal Wake up the consumer waiting in rte_ring_notify_wait(), if any,
+ * after an enqueue to a ring created with RING_F_NOTIFY.
+ *
+ * @param r
+ *   A pointer to the ring structure.
+ */
+static __rte_always_inline void
+__rte_ring_notify(struct rte_ring *r)
+{
+	if (likely((r->flags & RING_F_NOTIFY) == 0))
+		return;
+
+	/* Order the tail update before reading the armed flag, the consumer
+	 * orders setting the flag before checking the ring is empty.
+	 */
+	rte_atomic_thread_fence(__ATOMIC_SEQ_CST);
+	if (r->notify.armed == 0 ||
+			__atomic_exchange_n(&r->notify.armed, 0,
+				__ATOMIC_RELAXED) == 0)
+		return;
+
+	/* Clearing the flag wakes up rte_power_monitor(). */
+	if (r->notify.fd >= 0)
+		rte_ring_notify_wake(r);
+}
+
 /**
  * @internal Enqueue several objects on the ring
  *
@@ -328,6 +355,7 @@ __rte_ring_do_enqueue_elem(struct rte_ring *r, const void *obj_table,
 	__rte_ring_enqueue_elems(r, prod_head, obj_table, esize, n);
 
 	__rte_ring_update_tail(&r->prod, prod_head, prod_next, is_sp, 1);
+	__rte_ring_notify(r);
 end:
 	if (free_space != NULL)
 		*free_space = free_entries - n;
@@ -195,6 +195,7 @@ __rte_ring_do_hts_enqueue_elem(struct rte_ring *r, const void *obj_table,
 	if (n != 0) {
 		__rte_ring_enqueue_elems(r, head, obj_table, esize, n);
 		__rte_ring_hts_update_tail(&r->hts_prod, head, n, 1);
+		__rte_ring_notify(r);
 	}
 
 	if (free_space != NULL)
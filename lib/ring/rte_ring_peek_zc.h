@@ -26,9 +26,10 @@
  * to avoid copying of the data to temporary area (for ex: array of mbufs
  * on the stack).
  *
- * Note that currently these APIs are available only for two sync modes:
+ * Note that currently these APIs are available only for three sync modes:
  * 1) Single Producer/Single Consumer (RTE_RING_SYNC_ST)
  * 2) Serialized Producer/Serialized Consumer (RTE_RING_SYNC_MT_HTS).
+ * 3) Relaxed Tail Sync Producer/Consumer (RTE_RING_SYNC_MT_RTS).
  * It is user's responsibility to create/init ring with appropriate sync
  * modes selected.
  *
@@ -66,6 +67,12 @@
  *
  * Note that between _start_ and _finish_ none other thread can proceed
  * with enqueue/dequeue operation till _finish_ completes.
+ *
+ * With RTS sync mode, several threads can be between _start_ and _finish_
+ * at the same time, each one working on its own part of the ring. Objects
+ * become visible to the other side once all the operations started before
+ * them have finished. As the reservation cannot be shrunk, _finish_ has to
+ * be called with the number returned by _start_, unless it returned 0.
  */
 
 #ifdef __cplusplus
@@ -136,8 +143,10 @@ __rte_ring_do_enqueue_zc_elem_start(struct rte_ring *r, unsigned int esize,
 	case RTE_RING_SYNC_MT_HTS:
 		n = __rte_ring_hts_move_prod_head(r, n, behavior, &head, &free);
 		break;
-	case RTE_RING_SYNC_MT:
 	case RTE_RING_SYNC_MT_RTS:
+		n = __rte_ring_rts_move_prod_head(r, n, behavior, &head, &free);
+		break;
+	case RTE_RING_SYNC_MT:
 	default:
 		/* unsupported mode, shouldn't be here */
 		RTE_ASSERT(0);
@@ -284,6 +293,7 @@ rte_ring_enqueue_zc_burst_start(struct rte_ring *r, unsigned int n,
  * Complete enqueuing several objects on the ring.
  * Note that number of objects to enqueue should not exceed previous
  * enqueue_start return value.
+ * For RTS sync mode it has to be equal to that value.
  *
  * @param r
  *   A pointer to the ring structure.
@@ -305,8 +315,12 @@ rte_ring_enqueue_zc_elem_finish(struct rte_ring *r, unsigned int n)
 		n = __rte_ring_hts_get_tail(&r->hts_prod, &tail, n);
 		__rte_ring_hts_set_head_tail(&r->hts_prod, tail, n, 1);
 		break;
-	case RTE_RING_SYNC_MT:
 	case RTE_RING_SYNC_MT_RTS:
+		/* Nothing was reserved if start returned 0 */
+		if (n != 0)
+			__rte_ring_rts_update_tail(&r->rts_prod);
+		break;
+	case RTE_RING_SYNC_MT:
 	default:
 		/* unsupported mode, shouldn't be here */
 		RTE_ASSERT(0);
@@ -317,6 +331,7 @@ rte_ring_enqueue_zc_elem_finish(struct rte_ring *r, unsigned int n)
  * Complete enqueuing several pointers to objects on the ring.
  * Note that number of objects to enqueue should not exceed previous
  * enqueue_start return value.
+ * For RTS sync mode it has to be equal to that value.
  *
  * @param r
  *   A pointer to the ring structure.
@@ -350,8 +365,11 @@ __rte_ring_do_dequeue_zc_elem_start(struct rte_ring *r,
 		n = __rte_ring_hts_move_cons_head(r, n, behavior,
 			&head, &avail);
 		break;
-	case RTE_RING_SYNC_MT:
 	case RTE_RING_SYNC_MT_RTS:
+		n = __rte_ring_rts_move_cons_head(r, n, behavior,
+			&head, &avail);
+		break;
+	case RTE_RING_SYNC_MT:
 	default:
 		/* unsupported mode, shouldn't be here */
 		RTE_ASSERT(0);
@@ -496,6 +514,7 @@ rte_ring_dequeue_zc_burst_start(struct rte_ring *r, unsigned int n,
  * Complete dequeuing several objects from the ring.
  * Note that number of objects to dequeued should not exceed previous
  * dequeue_start return value.
+ * For RTS sync mode it has to be equal to that value.
  *
  * @param r
  *   A pointer to the ring structure.
@@ -517,8 +536,12 @@ rte_ring_dequeue_zc_elem_finish(struct rte_ring *r, unsigned int n)
 		n = __rte_ring_hts_get_tail(&r->hts_cons, &tail, n);
 		__rte_ring_hts_set_head_tail(&r->hts_cons, tail, n, 0);
 		break;
-	case RTE_RING_SYNC_MT:
 	case RTE_RING_SYNC_MT_RTS:
+		/* Nothing was reserved if start returned 0 */
+		if (n != 0)
+			__rte_ring_rts_update_tail(&r->rts_cons);
+		break;
+	case RTE_RING_SYNC_MT:
 	default:
 		/* unsupported mode, shouldn't be here */
 		RTE_ASSERT(0);
@@ -529,6 +552,7 @@ rte_ring_dequeue_zc_elem_finish(struct rte_ring *r, unsigned int n)
  * Complete dequeuing several objects from the ring.
  * Note that number of objects to dequeued should not exceed previous
  * dequeue_start return value.
+ * For RTS sync mode it has to be equal to that value.
  *
  * @param r
  *   A pointer to the ring structure.
@@ -539,7 +563,7 @@ __rte_experimental
 static __rte_always_inline void
 rte_ring_dequeue_zc_finish(struct rte_ring *r, unsigned int n)
 {
-	rte_ring_dequeue_elem_finish(r, n);
+	rte_ring_dequeue_zc_elem_finish(r, n);
 }
 
 #ifdef __cplusplus
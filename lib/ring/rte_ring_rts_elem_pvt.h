@@ -210,6 +210,7 @@ __rte_ring_do_rts_enqueue_elem(struct rte_ring *r, const void *obj_table,
 	if (n != 0) {
 		__rte_ring_enqueue_elems(r, head, obj_table, esize, n);
 		__rte_ring_rts_update_tail(&r->rts_prod);
+		__rte_ring_notify(r);
 	}
 
 	if (free_space != NULL)
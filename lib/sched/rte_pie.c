@@ -0,0 +1,46 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <string.h>
+
+#include "rte_pie.h"
+
+/* RFC 8033 controller weights, per second of queueing delay */
+#define PIE_ALPHA 0.125
+#define PIE_BETA  1.25
+
+#define MSEC_PER_SEC 1000
+
+int
+rte_pie_rt_data_init(struct rte_pie *pie)
+{
+	if (pie == NULL)
+		return -1;
+
+	memset(pie, 0, sizeof(*pie));
+	return 0;
+}
+
+int
+rte_pie_config_init(struct rte_pie_config *pie_cfg,
+	const struct rte_pie_params *params,
+	uint64_t time_hz)
+{
+	if (pie_cfg == NULL || params == NULL || time_hz == 0)
+		return -1;
+
+	if (params->qdelay_ref == 0 || params->dp_update_interval == 0 ||
+			params->max_burst == 0 || params->tailq_th == 0)
+		return -2;
+
+	pie_cfg->qdelay_ref = params->qdelay_ref * time_hz / MSEC_PER_SEC;
+	pie_cfg->dp_update_interval =
+		params->dp_update_interval * time_hz / MSEC_PER_SEC;
+	pie_cfg->max_burst = params->max_burst * time_hz / MSEC_PER_SEC;
+	pie_cfg->alpha = PIE_ALPHA / (double)time_hz;
+	pie_cfg->beta = PIE_BETA / (double)time_hz;
+	pie_cfg->tailq_th = params->tailq_th;
+
+	return 0;
+}
@@ -0,0 +1,284 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#ifndef __RTE_PIE_H_INCLUDED__
+#define __RTE_PIE_H_INCLUDED__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file
+ * RTE Proportional Integral controller Enhanced (PIE)
+ *
+ * Active queue management controlling the queueing delay, as described in
+ * RFC 8033. The queueing delay is estimated from the queue length and the
+ * departure rate of the queue. The drop probability is only updated once
+ * per update interval, so that the per packet enqueue cost is a comparison
+ * against a random number.
+ *
+ * The time stamps given to the run-time functions can be of any unit, as
+ * long as its frequency is given to rte_pie_config_init().
+ */
+
+#include <stdint.h>
+
+#include <rte_branch_prediction.h>
+#include <rte_common.h>
+#include <rte_compat.h>
+#include <rte_debug.h>
+#include <rte_random.h>
+
+#define RTE_PIE_DQ_THRESHOLD   16384 /**< Bytes dequeued to measure the departure rate */
+#define RTE_PIE_MEAN_PKTSIZE   1500  /**< Mean packet size in bytes */
+
+/**
+ * PIE configuration parameters passed by user
+ */
+struct rte_pie_params {
+	uint16_t qdelay_ref;         /**< Latency target (milliseconds) */
+	uint16_t dp_update_interval; /**< Drop probability update interval (milliseconds) */
+	uint16_t max_burst;          /**< Max burst allowance (milliseconds) */
+	uint16_t tailq_th;           /**< Tail drop threshold (packets) */
+};
+
+/**
+ * PIE configuration parameters
+ */
+struct rte_pie_config {
+	uint64_t qdelay_ref;         /**< Latency target, in time units */
+	uint64_t dp_update_interval; /**< Drop probability update interval, in time units */
+	uint64_t max_burst;          /**< Max burst allowance, in time units */
+	double alpha;                /**< Delay error weight, per time unit */
+	double beta;                 /**< Delay trend weight, per time unit */
+	uint16_t tailq_th;           /**< Tail drop threshold (packets) */
+};
+
+/**
+ * PIE run-time data
+ */
+struct rte_pie {
+	uint32_t qlen_bytes;      /**< Queue length (bytes) */
+	uint32_t dq_bytes;        /**< Bytes dequeued in the current measurement */
+	uint32_t in_measurement;  /**< Departure rate measurement in progress */
+	uint64_t dq_start;        /**< Start time of the current measurement */
+	uint64_t avg_dq_time;     /**< Average time to dequeue RTE_PIE_DQ_THRESHOLD bytes */
+	uint64_t burst_allowance; /**< Time left before packets may be dropped */
+	uint64_t last_update;     /**< Time of the last drop probability update */
+	uint64_t qdelay_old;      /**< Queueing delay at the last update */
+	double drop_prob;         /**< Drop probability */
+	uint64_t drop_th;         /**< Random number threshold for drop_prob */
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * @brief Initialises run-time data
+ *
+ * @param pie [in,out] data pointer to PIE runtime data
+ *
+ * @return Operation status
+ * @retval 0 success
+ * @retval !0 error
+ */
+__rte_experimental
+int
+rte_pie_rt_data_init(struct rte_pie *pie);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * @brief Configures a single PIE configuration parameter structure.
+ *
+ * @param pie_cfg [in,out] config pointer to a PIE configuration parameter structure
+ * @param params [in] PIE parameters, all non-zero
+ * @param time_hz [in] frequency of the time stamps given to the run-time
+ *   functions, e.g. rte_get_tsc_hz() for TSC time stamps
+ *
+ * @return Operation status
+ * @retval 0 success
+ * @retval !0 error
+ */
+__rte_experimental
+int
+rte_pie_config_init(struct rte_pie_config *pie_cfg,
+	const struct rte_pie_params *params,
+	uint64_t time_hz);
+
+/**
+ * @brief Updates the drop probability from the estimated queueing delay
+ *
+ * @param pie_cfg [in] config pointer to a PIE configuration parameter structure
+ * @param pie [in,out] data pointer to PIE runtime data
+ * @param time [in] current time stamp
+ */
+static inline void
+__rte_pie_calc_drop_prob(const struct rte_pie_config *pie_cfg,
+	struct rte_pie *pie, uint64_t time)
+{
+	uint64_t qdelay = 0;
+	double p;
+
+	/* Little's law, with the departure rate of the last measurements */
+	if (pie->avg_dq_time != 0)
+		qdelay = (uint64_t)pie->qlen_bytes * pie->avg_dq_time /
+			RTE_PIE_DQ_THRESHOLD;
+
+	p = pie_cfg->alpha * ((double)qdelay - (double)pie_cfg->qdelay_ref) +
+		pie_cfg->beta * ((double)qdelay - (double)pie->qdelay_old);
+
+	/* Smaller steps while the drop probability is low */
+	if (pie->drop_prob < 0.000001)
+		p /= 2048;
+	else if (pie->drop_prob < 0.00001)
+		p /= 512;
+	else if (pie->drop_prob < 0.0001)
+		p /= 128;
+	else if (pie->drop_prob < 0.001)
+		p /= 32;
+	else if (pie->drop_prob < 0.01)
+		p /= 8;
+	else if (pie->drop_prob < 0.1)
+		p /= 2;
+
+	pie->drop_prob += p;
+
+	/* Decay when the queue stays empty */
+	if (qdelay == 0 && pie->qdelay_old == 0)
+		pie->drop_prob *= 0.98;
+
+	if (pie->drop_prob < 0)
+		pie->drop_prob = 0;
+	if (pie->drop_prob > 1)
+		pie->drop_prob = 1;
+	pie->drop_th = pie->drop_prob >= 1 ? UINT64_MAX :
+		(uint64_t)(pie->drop_prob * (double)UINT64_MAX);
+
+	if (pie->burst_allowance > pie_cfg->dp_update_interval)
+		pie->burst_allowance -= pie_cfg->dp_update_interval;
+	else
+		pie->burst_allowance = 0;
+
+	/* Allow bursts again once the queue is back under control */
+	if (pie->drop_prob == 0 && qdelay < pie_cfg->qdelay_ref / 2 &&
+			pie->qdelay_old < pie_cfg->qdelay_ref / 2)
+		pie->burst_allowance = pie_cfg->max_burst;
+
+	pie->qdelay_old = qdelay;
+	pie->last_update = time;
+}
+
+/**
+ * @brief make a decision to drop or enqueue a packet based on the drop
+ *        probability
+ *
+ * @param pie_cfg [in] config pointer to a PIE configuration parameter structure
+ * @param pie [in] data pointer to PIE runtime data
+ *
+ * @return operation status
+ * @retval 0 enqueue the packet
+ * @retval 1 drop the packet
+ */
+static inline int
+__rte_pie_drop(const struct rte_pie_config *pie_cfg, struct rte_pie *pie)
+{
+	if (pie->burst_allowance != 0)
+		return 0;
+
+	if (pie->qdelay_old < pie_cfg->qdelay_ref / 2 && pie->drop_prob < 0.2)
+		return 0;
+
+	if (pie->qlen_bytes <= 2 * RTE_PIE_MEAN_PKTSIZE)
+		return 0;
+
+	return rte_rand() < pie->drop_th;
+}
+
+/**
+ * @brief Decides if new packet should be enqeued or dropped
+ * Updates the drop probability once per update interval. When the packet
+ * is enqueued, its length is added to the queue length.
+ *
+ * @param pie_cfg [in] config pointer to a PIE configuration parameter structure
+ * @param pie [in,out] data pointer to PIE runtime data
+ * @param qlen [in] queue length in packets, before the packet is enqueued
+ * @param pkt_len [in] packet length in bytes
+ * @param time [in] current time stamp
+ *
+ * @return Operation status
+ * @retval 0 enqueue the packet
+ * @retval 1 drop the packet based on the tail drop threshold
+ * @retval 2 drop the packet based on the drop probability
+ */
+static inline int
+rte_pie_enqueue(const struct rte_pie_config *pie_cfg,
+	struct rte_pie *pie,
+	const unsigned int qlen,
+	uint32_t pkt_len,
+	const uint64_t time)
+{
+	RTE_ASSERT(pie_cfg != NULL);
+	RTE_ASSERT(pie != NULL);
+
+	if (qlen >= pie_cfg->tailq_th)
+		return 1;
+
+	if (unlikely(time - pie->last_update >= pie_cfg->dp_update_interval))
+		__rte_pie_calc_drop_prob(pie_cfg, pie, time);
+
+	if (__rte_pie_drop(pie_cfg, pie))
+		return 2;
+
+	pie->qlen_bytes += pkt_len;
+	return 0;
+}
+
+/**
+ * @brief Accounts for a dequeued packet, and measures the departure rate
+ *
+ * @param pie [in,out] data pointer to PIE runtime data
+ * @param pkt_len [in] packet length in bytes, as given to rte_pie_enqueue()
+ * @param time [in] current time stamp
+ */
+static inline void
+rte_pie_dequeue(struct rte_pie *pie,
+	uint32_t pkt_len,
+	const uint64_t time)
+{
+	RTE_ASSERT(pie != NULL);
+
+	pie->qlen_bytes -= pkt_len;
+
+	if (pie->in_measurement) {
+		pie->dq_bytes += pkt_len;
+
+		if (pie->dq_bytes >= RTE_PIE_DQ_THRESHOLD) {
+			uint64_t dq_time = time - pie->dq_start;
+
+			/* avg = 3/4 * avg + 1/4 * dq_time */
+			if (pie->avg_dq_time == 0)
+				pie->avg_dq_time = dq_time;
+			else
+				pie->avg_dq_time =
+					(3 * pie->avg_dq_time + dq_time) >> 2;
+			pie->in_measurement = 0;
+		}
+	}
+
+	/* Only measure with enough backlog to keep the queue busy */
+	if (!pie->in_measurement && pie->qlen_bytes >= RTE_PIE_DQ_THRESHOLD) {
+		pie->in_measurement = 1;
+		pie->dq_start = time;
+		pie->dq_bytes = 0;
+	}
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __RTE_PIE_H_INCLUDED__ */
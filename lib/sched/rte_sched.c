@@ -2,7 +2,9 @@
  * Copyright(c) 2010-2014 Intel Corporation
  */
 
+#include <ctype.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include <rte_common.h>
@@ -10,11 +12,16 @@
 #include <rte_memory.h>
 #include <rte_malloc.h>
 #include <rte_cycles.h>
+#include <rte_errno.h>
 #include <rte_prefetch.h>
 #include <rte_branch_prediction.h>
 #include <rte_mbuf.h>
+#include <rte_mbuf_dyn.h>
+#include <rte_mempool.h>
 #include <rte_bitmap.h>
 #include <rte_reciprocal.h>
+#include <rte_spinlock.h>
+#include <rte_telemetry.h>
 
 #include "rte_sched.h"
 #include "rte_sched_common.h"
@@ -47,6 +54,9 @@
  */
 #define RTE_SCHED_TIME_SHIFT		      8
 
+/* Max number of ports with queueing delay statistics in telemetry */
+#define RTE_SCHED_DELAY_PORTS_MAX             64
+
 struct rte_sched_pipe_profile {
 	/* Token bucket (TB) */
 	uint64_t tb_period;
@@ -80,6 +90,9 @@ struct rte_sched_pipe {
 	/* TC oversubscription */
 	uint64_t tc_ov_credits;
 	uint8_t tc_ov_period_id;
+
+	/* Queue storage of a sparse subport pipe, NULL while inactive */
+	struct rte_mbuf **queue_array;
 } __rte_cache_aligned;
 
 struct rte_sched_queue {
@@ -90,7 +103,11 @@ struct rte_sched_queue {
 struct rte_sched_queue_extra {
 	struct rte_sched_queue_stats stats;
 #ifdef RTE_SCHED_RED
-	struct rte_red red;
+	RTE_STD_C11
+	union {
+		struct rte_red red;
+		struct rte_pie pie;
+	};
 #endif
 };
 
@@ -169,6 +186,7 @@ struct rte_sched_subport {
 
 	/* Statistics */
 	struct rte_sched_subport_stats stats __rte_cache_aligned;
+	struct rte_sched_subport_delay_stats delay_stats __rte_cache_aligned;
 
 	/* subport profile */
 	uint32_t profile;
@@ -184,7 +202,9 @@ struct rte_sched_subport {
 	uint16_t qsize[RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE];
 
 #ifdef RTE_SCHED_RED
+	enum rte_sched_cman_mode cman_mode[RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE];
 	struct rte_red_config red_config[RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE][RTE_COLORS];
+	struct rte_pie_config pie_config[RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE];
 #endif
 
 	/* Scheduling loop detection */
@@ -209,6 +229,7 @@ struct rte_sched_subport {
 	struct rte_sched_pipe_profile *pipe_profiles;
 	uint8_t *bmp_array;
 	struct rte_mbuf **queue_array;
+	struct rte_mempool *queue_array_pool; /* sparse subport only */
 	uint8_t memory[0] __rte_cache_aligned;
 } __rte_cache_aligned;
 
@@ -233,17 +254,35 @@ struct rte_sched_port {
 	uint64_t time;                /* Current NIC TX time measured in bytes */
 	struct rte_reciprocal inv_cycles_per_byte; /* CPU cycles per byte */
 	uint64_t cycles_per_byte;
+	uint64_t *shared_time;        /* NIC TX time shared by several ports */
+	uint64_t time_start;          /* NIC TX time at the start of dequeue */
+	uint64_t time_tsc;            /* TSC at the start of dequeue */
+
+	/* Queueing delay statistics */
+	int delay_stats;
+	uint64_t delay_ns_mult;       /* Nanoseconds per cycle << 32 */
+	uint64_t delay_cycles_max;    /* Max delay not overflowing in ns */
 
 	/* Grinders */
 	struct rte_mbuf **pkts_out;
 	uint32_t n_pkts_out;
 	uint32_t subport_id;
 
+	/* NIC TX time of the ports sharing the time of this one */
+	uint64_t time_shared __rte_cache_aligned;
+
 	/* Large data structures */
 	struct rte_sched_subport_profile *subport_profiles;
 	struct rte_sched_subport *subports[0] __rte_cache_aligned;
 } __rte_cache_aligned;
 
+/* Enqueue TSC of the packets, when the delay statistics are enabled */
+static int rte_sched_delay_offset = -1;
+
+/* Ports with delay statistics, indexed by telemetry */
+static struct rte_sched_port *rte_sched_delay_ports[RTE_SCHED_DELAY_PORTS_MAX];
+static rte_spinlock_t rte_sched_delay_lock = RTE_SPINLOCK_INITIALIZER;
+
 enum rte_sched_subport_array {
 	e_RTE_SCHED_SUBPORT_ARRAY_PIPE = 0,
 	e_RTE_SCHED_SUBPORT_ARRAY_QUEUE,
@@ -266,6 +305,10 @@ rte_sched_subport_pipe_qbase(struct rte_sched_subport *subport, uint32_t qindex)
 	uint32_t pindex = qindex >> 4;
 	uint32_t qpos = qindex & (RTE_SCHED_QUEUES_PER_PIPE - 1);
 
+	if (subport->queue_array_pool != NULL)
+		return (subport->pipe[pindex].queue_array +
+			subport->qsize_add[qpos]);
+
 	return (subport->queue_array + pindex *
 		subport->qsize_sum + subport->qsize_add[qpos]);
 }
@@ -513,7 +556,7 @@ rte_sched_port_check_params(struct rte_sched_port_params *params)
 
 static uint32_t
 rte_sched_subport_get_array_base(struct rte_sched_subport_params *params,
-	enum rte_sched_subport_array array)
+	uint32_t n_active_pipes, enum rte_sched_subport_array array)
 {
 	uint32_t n_pipes_per_subport = params->n_pipes_per_subport_enabled;
 	uint32_t n_subport_pipe_queues =
@@ -541,7 +584,9 @@ rte_sched_subport_get_array_base(struct rte_sched_subport_params *params,
 			size_per_pipe_queue_array += RTE_SCHED_MAX_QUEUES_PER_TC *
 				params->qsize[i] * sizeof(struct rte_mbuf *);
 	}
-	size_queue_array = n_pipes_per_subport * size_per_pipe_queue_array;
+	/* The queues of a sparse subport are allocated per active pipe */
+	size_queue_array = n_active_pipes ? 0 :
+		n_pipes_per_subport * size_per_pipe_queue_array;
 
 	base = 0;
 
@@ -920,7 +965,7 @@ rte_sched_port_get_memory_footprint(struct rte_sched_port_params *port_params,
 	for (i = 0; i < port_params->n_subports_per_port; i++) {
 		struct rte_sched_subport_params *sp = subport_params[i];
 
-		size1 += rte_sched_subport_get_array_base(sp,
+		size1 += rte_sched_subport_get_array_base(sp, 0,
 					e_RTE_SCHED_SUBPORT_ARRAY_TOTAL);
 	}
 
@@ -1044,6 +1089,7 @@ rte_sched_subport_free(struct rte_sched_port *port,
 		}
 	}
 
+	rte_mempool_free(subport->queue_array_pool);
 	rte_free(subport);
 }
 
@@ -1056,6 +1102,14 @@ rte_sched_port_free(struct rte_sched_port *port)
 	if (port == NULL)
 		return;
 
+	if (port->delay_stats) {
+		rte_spinlock_lock(&rte_sched_delay_lock);
+		for (i = 0; i < RTE_SCHED_DELAY_PORTS_MAX; i++)
+			if (rte_sched_delay_ports[i] == port)
+				rte_sched_delay_ports[i] = NULL;
+		rte_spinlock_unlock(&rte_sched_delay_lock);
+	}
+
 	for (i = 0; i < port->n_subports_per_port; i++)
 		rte_sched_subport_free(port, port->subports[i]);
 
@@ -1078,11 +1132,12 @@ rte_sched_free_memory(struct rte_sched_port *port, uint32_t n_subports)
 	rte_free(port);
 }
 
-int
-rte_sched_subport_config(struct rte_sched_port *port,
+static int
+rte_sched_subport_config_common(struct rte_sched_port *port,
 	uint32_t subport_id,
 	struct rte_sched_subport_params *params,
-	uint32_t subport_profile_id)
+	uint32_t subport_profile_id,
+	uint32_t n_active_pipes)
 {
 	struct rte_sched_subport *s = NULL;
 	uint32_t n_subports = subport_id;
@@ -1132,9 +1187,19 @@ rte_sched_subport_config(struct rte_sched_port *port,
 			return -EINVAL;
 		}
 
+		if (n_active_pipes > params->n_pipes_per_subport_enabled) {
+			RTE_LOG(ERR, SCHED,
+				"%s: Incorrect value for active pipes number\n",
+				__func__);
+
+			rte_sched_free_memory(port, n_subports);
+			return -EINVAL;
+		}
+
 		/* Determine the amount of memory to allocate */
 		size0 = sizeof(struct rte_sched_subport);
 		size1 = rte_sched_subport_get_array_base(params,
+					n_active_pipes,
 					e_RTE_SCHED_SUBPORT_ARRAY_TOTAL);
 
 		/* Allocate memory to store the data structures */
@@ -1173,6 +1238,31 @@ rte_sched_subport_config(struct rte_sched_port *port,
 		for (i = 0; i < RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE; i++) {
 			uint32_t j;
 
+			s->cman_mode[i] = params->cman_mode[i];
+
+			if (params->cman_mode[i] == RTE_SCHED_CMAN_PIE) {
+				/* PIE time stamps are in bytes at port rate */
+				if (rte_pie_config_init(&s->pie_config[i],
+				    &params->pie_params[i], port->rate) != 0) {
+					rte_sched_free_memory(port, n_subports);
+
+					RTE_LOG(NOTICE, SCHED,
+					"%s: PIE configuration init fails\n",
+					__func__);
+					return -EINVAL;
+				}
+				continue;
+			}
+
+			if (params->cman_mode[i] != RTE_SCHED_CMAN_RED) {
+				rte_sched_free_memory(port, n_subports);
+
+				RTE_LOG(NOTICE, SCHED,
+				"%s: Incorrect congestion management mode\n",
+				__func__);
+				return -EINVAL;
+			}
+
 			for (j = 0; j < RTE_COLORS; j++) {
 			/* if min/max are both zero, then RED is disabled */
 				if ((params->red_params[i][j].min_th |
@@ -1206,24 +1296,45 @@ rte_sched_subport_config(struct rte_sched_port *port,
 		/* Queue base calculation */
 		rte_sched_subport_config_qsize(s);
 
+		/* Queue storage of the active pipes of a sparse subport */
+		if (n_active_pipes) {
+			char name[RTE_MEMPOOL_NAMESIZE];
+
+			snprintf(name, sizeof(name), "sched_sq_%p", s);
+			s->queue_array_pool = rte_mempool_create(name,
+				n_active_pipes,
+				s->qsize_sum * sizeof(struct rte_mbuf *),
+				0, 0, NULL, NULL, NULL, NULL, port->socket,
+				MEMPOOL_F_SP_PUT | MEMPOOL_F_SC_GET);
+			if (s->queue_array_pool == NULL) {
+				RTE_LOG(ERR, SCHED,
+					"%s: Queue storage pool creation fails\n",
+					__func__);
+
+				rte_sched_free_memory(port, n_subports);
+				return -ENOMEM;
+			}
+		}
+
 		/* Large data structures */
 		s->pipe = (struct rte_sched_pipe *)
 			(s->memory + rte_sched_subport_get_array_base(params,
-			e_RTE_SCHED_SUBPORT_ARRAY_PIPE));
+			n_active_pipes, e_RTE_SCHED_SUBPORT_ARRAY_PIPE));
 		s->queue = (struct rte_sched_queue *)
 			(s->memory + rte_sched_subport_get_array_base(params,
-			e_RTE_SCHED_SUBPORT_ARRAY_QUEUE));
+			n_active_pipes, e_RTE_SCHED_SUBPORT_ARRAY_QUEUE));
 		s->queue_extra = (struct rte_sched_queue_extra *)
 			(s->memory + rte_sched_subport_get_array_base(params,
-			e_RTE_SCHED_SUBPORT_ARRAY_QUEUE_EXTRA));
+			n_active_pipes, e_RTE_SCHED_SUBPORT_ARRAY_QUEUE_EXTRA));
 		s->pipe_profiles = (struct rte_sched_pipe_profile *)
 			(s->memory + rte_sched_subport_get_array_base(params,
-			e_RTE_SCHED_SUBPORT_ARRAY_PIPE_PROFILES));
+			n_active_pipes, e_RTE_SCHED_SUBPORT_ARRAY_PIPE_PROFILES));
 		s->bmp_array =  s->memory + rte_sched_subport_get_array_base(
-				params, e_RTE_SCHED_SUBPORT_ARRAY_BMP_ARRAY);
+				params, n_active_pipes,
+				e_RTE_SCHED_SUBPORT_ARRAY_BMP_ARRAY);
 		s->queue_array = (struct rte_mbuf **)
 			(s->memory + rte_sched_subport_get_array_base(params,
-			e_RTE_SCHED_SUBPORT_ARRAY_QUEUE_ARRAY));
+			n_active_pipes, e_RTE_SCHED_SUBPORT_ARRAY_QUEUE_ARRAY));
 
 		/* Pipe profile table */
 		rte_sched_subport_config_pipe_profile_table(s, params,
@@ -1287,6 +1398,34 @@ rte_sched_subport_config(struct rte_sched_port *port,
 	return 0;
 }
 
+int
+rte_sched_subport_config(struct rte_sched_port *port,
+	uint32_t subport_id,
+	struct rte_sched_subport_params *params,
+	uint32_t subport_profile_id)
+{
+	return rte_sched_subport_config_common(port, subport_id, params,
+		subport_profile_id, 0);
+}
+
+int
+rte_sched_subport_config_sparse(struct rte_sched_port *port,
+	uint32_t subport_id,
+	struct rte_sched_subport_params *params,
+	uint32_t subport_profile_id,
+	uint32_t n_active_pipes)
+{
+	if (n_active_pipes == 0) {
+		RTE_LOG(ERR, SCHED,
+			"%s: Incorrect value for active pipes number\n",
+			__func__);
+		return -EINVAL;
+	}
+
+	return rte_sched_subport_config_common(port, subport_id, params,
+		subport_profile_id, n_active_pipes);
+}
+
 int
 rte_sched_pipe_config(struct rte_sched_port *port,
 	uint32_t subport_id,
@@ -1297,6 +1436,7 @@ rte_sched_pipe_config(struct rte_sched_port *port,
 	struct rte_sched_subport_profile *sp;
 	struct rte_sched_pipe *p;
 	struct rte_sched_pipe_profile *params;
+	struct rte_mbuf **queue_array;
 	uint32_t n_subports = subport_id + 1;
 	uint32_t deactivate, profile, i;
 
@@ -1360,8 +1500,10 @@ rte_sched_pipe_config(struct rte_sched_port *port,
 				subport_id, subport_tc_be_rate, s->tc_ov_rate);
 		}
 
-		/* Reset the pipe */
+		/* Reset the pipe, keeping the packets of its queues */
+		queue_array = p->queue_array;
 		memset(p, 0, sizeof(struct rte_sched_pipe));
+		p->queue_array = queue_array;
 	}
 
 	if (deactivate)
@@ -1539,6 +1681,45 @@ rte_sched_port_subport_profile_add(struct rte_sched_port *port,
 	return 0;
 }
 
+int
+rte_sched_port_time_share(struct rte_sched_port *port,
+	struct rte_sched_port *ref_port)
+{
+	/* Check user parameters */
+	if (port == NULL || ref_port == NULL || port == ref_port) {
+		RTE_LOG(ERR, SCHED,
+			"%s: Incorrect value for parameter port\n", __func__);
+		return -EINVAL;
+	}
+
+	if (port->rate != ref_port->rate ||
+		port->frame_overhead != ref_port->frame_overhead) {
+		RTE_LOG(ERR, SCHED,
+			"%s: Ports have a different rate or frame overhead\n",
+			__func__);
+		return -EINVAL;
+	}
+
+	if (port->shared_time != NULL) {
+		RTE_LOG(ERR, SCHED,
+			"%s: Port already shares its time\n", __func__);
+		return -EBUSY;
+	}
+
+	if (ref_port->shared_time == NULL) {
+		ref_port->time_shared = ref_port->time;
+		ref_port->shared_time = &ref_port->time_shared;
+	}
+
+	/* Count the time of both ports from the same CPU time */
+	port->time_cpu_cycles = ref_port->time_cpu_cycles;
+	port->time_cpu_bytes = ref_port->time_cpu_bytes;
+	port->time = ref_port->time;
+	port->shared_time = ref_port->shared_time;
+
+	return 0;
+}
+
 static inline uint32_t
 rte_sched_port_qindex(struct rte_sched_port *port,
 	uint32_t subport,
@@ -1686,6 +1867,234 @@ rte_sched_queue_read_stats(struct rte_sched_port *port,
 	return 0;
 }
 
+int
+rte_sched_port_delay_stats_enable(struct rte_sched_port *port)
+{
+	static const struct rte_mbuf_dynfield delay_dynfield_desc = {
+		.name = "rte_sched_dynfield_enqueue_tsc",
+		.size = sizeof(uint64_t),
+		.align = __alignof__(uint64_t),
+	};
+	uint64_t hz = rte_get_tsc_hz();
+	uint32_t i;
+	int offset;
+
+	/* Check user parameters */
+	if (port == NULL) {
+		RTE_LOG(ERR, SCHED,
+			"%s: Incorrect value for parameter port\n", __func__);
+		return -EINVAL;
+	}
+
+	if (port->delay_stats)
+		return 0;
+
+	if (hz == 0) {
+		RTE_LOG(ERR, SCHED, "%s: Unknown TSC frequency\n", __func__);
+		return -ENOTSUP;
+	}
+
+	offset = rte_mbuf_dynfield_register(&delay_dynfield_desc);
+	if (offset < 0) {
+		RTE_LOG(ERR, SCHED,
+			"%s: Cannot register mbuf dynamic field\n", __func__);
+		return -rte_errno;
+	}
+	rte_sched_delay_offset = offset;
+
+	rte_spinlock_lock(&rte_sched_delay_lock);
+	for (i = 0; i < RTE_SCHED_DELAY_PORTS_MAX; i++)
+		if (rte_sched_delay_ports[i] == NULL) {
+			rte_sched_delay_ports[i] = port;
+			break;
+		}
+	rte_spinlock_unlock(&rte_sched_delay_lock);
+	if (i == RTE_SCHED_DELAY_PORTS_MAX)
+		RTE_LOG(INFO, SCHED,
+			"%s: Port delay statistics not in telemetry\n",
+			__func__);
+
+	port->delay_ns_mult = ((uint64_t)NS_PER_S << 32) / hz;
+	port->delay_cycles_max = UINT64_MAX / port->delay_ns_mult;
+	port->delay_stats = 1;
+
+	return 0;
+}
+
+int
+rte_sched_subport_read_delay_stats(struct rte_sched_port *port,
+	uint32_t subport_id,
+	struct rte_sched_subport_delay_stats *stats)
+{
+	struct rte_sched_subport *s;
+
+	/* Check user parameters */
+	if (port == NULL) {
+		RTE_LOG(ERR, SCHED,
+			"%s: Incorrect value for parameter port\n", __func__);
+		return -EINVAL;
+	}
+
+	if (subport_id >= port->n_subports_per_port) {
+		RTE_LOG(ERR, SCHED,
+			"%s: Incorrect value for subport id\n", __func__);
+		return -EINVAL;
+	}
+
+	if (stats == NULL) {
+		RTE_LOG(ERR, SCHED,
+			"%s: Incorrect value for parameter stats\n", __func__);
+		return -EINVAL;
+	}
+
+	if (!port->delay_stats) {
+		RTE_LOG(ERR, SCHED,
+			"%s: Delay statistics not enabled\n", __func__);
+		return -ENOTSUP;
+	}
+
+	s = port->subports[subport_id];
+
+	/* Copy subport delay stats and clear */
+	memcpy(stats, &s->delay_stats, sizeof(*stats));
+	memset(&s->delay_stats, 0, sizeof(s->delay_stats));
+
+	return 0;
+}
+
+static inline void
+rte_sched_port_delay_stamp(struct rte_mbuf **pkts, uint32_t n_pkts)
+{
+	uint64_t tsc = rte_get_tsc_cycles();
+	uint32_t i;
+
+	for (i = 0; i < n_pkts; i++)
+		*RTE_MBUF_DYNFIELD(pkts[i], rte_sched_delay_offset,
+			uint64_t *) = tsc;
+}
+
+static inline void
+rte_sched_port_delay_sample(struct rte_sched_port *port,
+	struct rte_sched_subport *subport,
+	uint32_t tc_index,
+	struct rte_mbuf *pkt)
+{
+	struct rte_sched_subport_delay_stats *stats = &subport->delay_stats;
+	uint64_t tsc = *RTE_MBUF_DYNFIELD(pkt, rte_sched_delay_offset,
+		uint64_t *);
+	uint64_t delay = 0;
+	uint32_t bucket;
+
+	if (port->time_tsc > tsc)
+		delay = RTE_MIN(port->time_tsc - tsc, port->delay_cycles_max);
+	delay = (delay * port->delay_ns_mult) >> 32;
+
+	bucket = RTE_MIN(rte_fls_u64(delay >> RTE_SCHED_DELAY_HIST_SHIFT),
+		RTE_SCHED_DELAY_HIST_SIZE - 1);
+
+	stats->n_pkts_tc[tc_index] += 1;
+	stats->sum_ns_tc[tc_index] += delay;
+	if (stats->max_ns_tc[tc_index] < delay)
+		stats->max_ns_tc[tc_index] = delay;
+	stats->hist_tc[tc_index][bucket] += 1;
+}
+
+static int
+rte_sched_telemetry_delay_ports(const char *cmd __rte_unused,
+	const char *params __rte_unused,
+	struct rte_tel_data *d)
+{
+	uint32_t i;
+
+	rte_tel_data_start_array(d, RTE_TEL_INT_VAL);
+	rte_spinlock_lock(&rte_sched_delay_lock);
+	for (i = 0; i < RTE_SCHED_DELAY_PORTS_MAX; i++)
+		if (rte_sched_delay_ports[i] != NULL)
+			rte_tel_data_add_array_int(d, i);
+	rte_spinlock_unlock(&rte_sched_delay_lock);
+
+	return 0;
+}
+
+static void
+rte_sched_telemetry_add_tc_stats(struct rte_tel_data *d, const char *name,
+	const uint64_t *values)
+{
+	struct rte_tel_data *tc_data = rte_tel_data_alloc();
+	uint32_t i;
+
+	if (tc_data == NULL)
+		return;
+
+	rte_tel_data_start_array(tc_data, RTE_TEL_U64_VAL);
+	for (i = 0; i < RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE; i++)
+		rte_tel_data_add_array_u64(tc_data, values[i]);
+	rte_tel_data_add_dict_container(d, name, tc_data, 0);
+}
+
+/* Parameters: "port_index,subport_id". The statistics are not cleared. */
+static int
+rte_sched_telemetry_delay_stats(const char *cmd __rte_unused,
+	const char *params,
+	struct rte_tel_data *d)
+{
+	struct rte_sched_subport_delay_stats stats;
+	struct rte_sched_port *port;
+	unsigned long port_index, subport_id;
+	char name[RTE_TEL_MAX_STRING_LEN];
+	char *end_param;
+	uint32_t i, j;
+
+	if (params == NULL || !isdigit(*params))
+		return -EINVAL;
+
+	port_index = strtoul(params, &end_param, 0);
+	if (*end_param != ',' || !isdigit(*(end_param + 1)))
+		return -EINVAL;
+	subport_id = strtoul(end_param + 1, &end_param, 0);
+	if (*end_param != '\0' || port_index >= RTE_SCHED_DELAY_PORTS_MAX)
+		return -EINVAL;
+
+	rte_spinlock_lock(&rte_sched_delay_lock);
+	port = rte_sched_delay_ports[port_index];
+	if (port == NULL || subport_id >= port->n_subports_per_port) {
+		rte_spinlock_unlock(&rte_sched_delay_lock);
+		return -EINVAL;
+	}
+	memcpy(&stats, &port->subports[subport_id]->delay_stats,
+		sizeof(stats));
+	rte_spinlock_unlock(&rte_sched_delay_lock);
+
+	rte_tel_data_start_dict(d);
+	rte_sched_telemetry_add_tc_stats(d, "n_pkts", stats.n_pkts_tc);
+	rte_sched_telemetry_add_tc_stats(d, "sum_ns", stats.sum_ns_tc);
+	rte_sched_telemetry_add_tc_stats(d, "max_ns", stats.max_ns_tc);
+	for (i = 0; i < RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE; i++) {
+		struct rte_tel_data *hist = rte_tel_data_alloc();
+
+		if (hist == NULL)
+			break;
+
+		rte_tel_data_start_array(hist, RTE_TEL_U64_VAL);
+		for (j = 0; j < RTE_SCHED_DELAY_HIST_SIZE; j++)
+			rte_tel_data_add_array_u64(hist, stats.hist_tc[i][j]);
+		snprintf(name, sizeof(name), "hist_tc%u", i);
+		rte_tel_data_add_dict_container(d, name, hist, 0);
+	}
+
+	return 0;
+}
+
+RTE_INIT(rte_sched_init_telemetry)
+{
+	rte_telemetry_register_cmd("/sched/delay_ports",
+		rte_sched_telemetry_delay_ports,
+		"Returns list of scheduler port indexes with delay statistics. Takes no parameters");
+	rte_telemetry_register_cmd("/sched/delay_stats",
+		rte_sched_telemetry_delay_stats,
+		"Returns the queueing delay statistics of a subport. Parameters: int port_index, int subport_id");
+}
+
 #ifdef RTE_SCHED_DEBUG
 
 static inline int
@@ -1794,13 +2203,23 @@ rte_sched_port_red_drop(struct rte_sched_port *port,
 	enum rte_color color;
 
 	tc_index = rte_sched_port_pipe_tc(port, qindex);
+	qe = subport->queue_extra + qindex;
+
+	if (subport->cman_mode[tc_index] == RTE_SCHED_CMAN_PIE) {
+		/* Full queue: leave the tail drop to the caller */
+		if (qlen >= rte_sched_subport_pipe_qsize(port, subport, qindex))
+			return 0;
+
+		return rte_pie_enqueue(&subport->pie_config[tc_index], &qe->pie,
+			qlen, pkt->pkt_len, port->time);
+	}
+
 	color = rte_sched_port_pkt_read_color(pkt);
 	red_cfg = &subport->red_config[tc_index][color];
 
 	if ((red_cfg->min_th | red_cfg->max_th) == 0)
 		return 0;
 
-	qe = subport->queue_extra + qindex;
 	red = &qe->red;
 
 	return rte_red_enqueue(red_cfg, red, qlen, port->time);
@@ -1812,8 +2231,24 @@ rte_sched_port_set_queue_empty_timestamp(struct rte_sched_port *port,
 {
 	struct rte_sched_queue_extra *qe = subport->queue_extra + qindex;
 	struct rte_red *red = &qe->red;
+	uint32_t tc_index = rte_sched_port_pipe_tc(port, qindex);
 
-	rte_red_mark_queue_empty(red, port->time);
+	if (subport->cman_mode[tc_index] == RTE_SCHED_CMAN_RED)
+		rte_red_mark_queue_empty(red, port->time);
+}
+
+static inline void
+rte_sched_port_pie_dequeue(struct rte_sched_port *port,
+	struct rte_sched_subport *subport, uint32_t qindex,
+	uint32_t tc_index, struct rte_mbuf *pkt)
+{
+	struct rte_sched_queue_extra *qe;
+
+	if (subport->cman_mode[tc_index] != RTE_SCHED_CMAN_PIE)
+		return;
+
+	qe = subport->queue_extra + qindex;
+	rte_pie_dequeue(&qe->pie, pkt->pkt_len, port->time);
 }
 
 #else
@@ -1829,6 +2264,8 @@ static inline int rte_sched_port_red_drop(struct rte_sched_port *port __rte_unus
 
 #define rte_sched_port_set_queue_empty_timestamp(port, subport, qindex)
 
+#define rte_sched_port_pie_dequeue(port, subport, qindex, tc_index, pkt)
+
 #endif /* RTE_SCHED_RED */
 
 #ifdef RTE_SCHED_DEBUG
@@ -1924,6 +2361,32 @@ rte_sched_port_enqueue_qwa(struct rte_sched_port *port,
 	qsize = rte_sched_subport_pipe_qsize(port, subport, qindex);
 	qlen = q->qw - q->qr;
 
+	/* Activate the queue storage of a sparse subport pipe. The packet
+	 * is never dropped below when its pipe queues are all empty, so it
+	 * is taken before the congestion management update.
+	 */
+	if (subport->queue_array_pool != NULL && qsize != 0) {
+		struct rte_sched_pipe *pipe = subport->pipe + (qindex >> 4);
+
+		if (unlikely(pipe->queue_array == NULL)) {
+			void *queue_array;
+
+			if (unlikely(rte_mempool_get(subport->queue_array_pool,
+					&queue_array) < 0)) {
+				rte_pktmbuf_free(pkt);
+#ifdef RTE_SCHED_COLLECT_STATS
+				rte_sched_port_update_subport_stats_on_drop(port,
+					subport, qindex, pkt, 0);
+				rte_sched_port_update_queue_stats_on_drop(subport,
+					qindex, pkt, 0);
+#endif
+				return 0;
+			}
+			pipe->queue_array = queue_array;
+		}
+		qbase = rte_sched_subport_pipe_qbase(subport, qindex);
+	}
+
 	/* Drop the packet (and update drop stats) when queue is full */
 	if (unlikely(rte_sched_port_red_drop(port, subport, pkt, qindex, qlen) ||
 		     (qlen >= qsize))) {
@@ -1985,6 +2448,9 @@ rte_sched_port_enqueue(struct rte_sched_port *port, struct rte_mbuf **pkts,
 	result = 0;
 	subport_qmask = (1 << (port->n_pipes_per_subport_log2 + 4)) - 1;
 
+	if (unlikely(port->delay_stats))
+		rte_sched_port_delay_stamp(pkts, n_pkts);
+
 	/*
 	 * Less then 6 input packets available, which is not enough to
 	 * feed the pipeline
@@ -2392,6 +2858,24 @@ grinder_credits_check(struct rte_sched_port *port,
 #endif /* RTE_SCHED_SUBPORT_TC_OV */
 
 
+/* Give the queue storage of an idle sparse subport pipe back */
+static inline void
+grinder_pipe_queue_array_release(struct rte_sched_subport *subport,
+	uint32_t qindex)
+{
+	uint32_t pindex = qindex >> 4;
+	struct rte_sched_queue *queue = subport->queue + (pindex << 4);
+	struct rte_sched_pipe *pipe = subport->pipe + pindex;
+	uint32_t i;
+
+	for (i = 0; i < RTE_SCHED_QUEUES_PER_PIPE; i++)
+		if (queue[i].qr != queue[i].qw)
+			return;
+
+	rte_mempool_put(subport->queue_array_pool, pipe->queue_array);
+	pipe->queue_array = NULL;
+}
+
 static inline int
 grinder_schedule(struct rte_sched_port *port,
 	struct rte_sched_subport *subport, uint32_t pos)
@@ -2411,6 +2895,11 @@ grinder_schedule(struct rte_sched_port *port,
 	/* Send packet */
 	port->pkts_out[port->n_pkts_out++] = pkt;
 	queue->qr++;
+	if (unlikely(port->delay_stats))
+		rte_sched_port_delay_sample(port, subport, grinder->tc_index,
+			pkt);
+	rte_sched_port_pie_dequeue(port, subport, grinder->qindex[grinder->qpos],
+		grinder->tc_index, pkt);
 
 	be_tc_active = (grinder->tc_index == RTE_SCHED_TRAFFIC_CLASS_BE) ? ~0x0 : 0x0;
 	grinder->wrr_tokens[grinder->qpos] +=
@@ -2424,6 +2913,8 @@ grinder_schedule(struct rte_sched_port *port,
 		if (be_tc_active)
 			grinder->wrr_mask[grinder->qpos] = 0;
 		rte_sched_port_set_queue_empty_timestamp(port, subport, qindex);
+		if (subport->queue_array_pool != NULL)
+			grinder_pipe_queue_array_release(subport, qindex);
 	}
 
 	/* Reset pipe loop detection */
@@ -2889,6 +3380,7 @@ rte_sched_port_time_resync(struct rte_sched_port *port)
 	uint64_t bytes_diff;
 	uint32_t i;
 
+	port->time_tsc = cycles;
 	if (cycles < port->time_cpu_cycles)
 		port->time_cpu_cycles = 0;
 
@@ -2909,6 +3401,38 @@ rte_sched_port_time_resync(struct rte_sched_port *port)
 		port->subports[i]->pipe_loop = RTE_SCHED_PIPE_INVALID;
 }
 
+/*
+ * With a shared time, the time of the port is advanced by the packets sent
+ * from the other ports before a dequeue. The time advanced by the dequeue is
+ * then added to the shared time, in a single atomic update, so that the
+ * ports do not contend on each packet.
+ */
+static inline void
+rte_sched_port_time_load(struct rte_sched_port *port)
+{
+	uint64_t time = __atomic_load_n(port->shared_time, __ATOMIC_RELAXED);
+
+	if (port->time < time)
+		port->time = time;
+	port->time_start = port->time;
+}
+
+static inline void
+rte_sched_port_time_store(struct rte_sched_port *port)
+{
+	uint64_t bytes = port->time - port->time_start;
+	uint64_t time, new_time;
+
+	if (bytes == 0)
+		return;
+
+	time = __atomic_load_n(port->shared_time, __ATOMIC_RELAXED);
+	do {
+		new_time = RTE_MAX(time, port->time_cpu_bytes) + bytes;
+	} while (!__atomic_compare_exchange_n(port->shared_time, &time,
+			new_time, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+}
+
 static inline int
 rte_sched_port_exceptions(struct rte_sched_subport *subport, int second_pass)
 {
@@ -2935,6 +3459,8 @@ rte_sched_port_dequeue(struct rte_sched_port *port, struct rte_mbuf **pkts, uint
 	port->n_pkts_out = 0;
 
 	rte_sched_port_time_resync(port);
+	if (port->shared_time != NULL)
+		rte_sched_port_time_load(port);
 
 	/* Take each queue in the grinder one step further */
 	for (i = 0, count = 0; ; i++)  {
@@ -2968,5 +3494,8 @@ rte_sched_port_dequeue(struct rte_sched_port *port, struct rte_mbuf **pkts, uint
 		}
 	}
 
+	if (port->shared_time != NULL)
+		rte_sched_port_time_store(port);
+
 	return count;
 }
@@ -61,9 +61,12 @@ extern "C" {
 #include <rte_mbuf.h>
 #include <rte_meter.h>
 
-/** Random Early Detection (RED) */
+/** Congestion management: Random Early Detection (RED) and
+ * Proportional Integral controller Enhanced (PIE)
+ */
 #ifdef RTE_SCHED_RED
 #include "rte_red.h"
+#include "rte_pie.h"
 #endif
 
 /** Maximum number of queues per pipe.
@@ -139,6 +142,14 @@ struct rte_sched_pipe_params {
 	uint8_t wrr_weights[RTE_SCHED_BE_QUEUES_PER_PIPE];
 };
 
+/**
+ * Congestion management mode of a traffic class
+ */
+enum rte_sched_cman_mode {
+	RTE_SCHED_CMAN_RED, /**< Random Early Detection (RED) */
+	RTE_SCHED_CMAN_PIE, /**< Proportional Integral controller Enhanced (PIE) */
+};
+
 /*
  * Subport configuration parameters. The period and credits_per_period
  * parameters are measured in bytes, with one byte meaning the time
@@ -177,6 +188,12 @@ struct rte_sched_subport_params {
 #ifdef RTE_SCHED_RED
 	/** RED parameters */
 	struct rte_red_params red_params[RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE][RTE_COLORS];
+
+	/** Congestion management mode of each traffic class, RED by default */
+	enum rte_sched_cman_mode cman_mode[RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE];
+
+	/** PIE parameters of the traffic classes in PIE mode */
+	struct rte_pie_params pie_params[RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE];
 #endif
 };
 
@@ -209,7 +226,7 @@ struct rte_sched_subport_stats {
 	uint64_t n_bytes_tc_dropped[RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE];
 
 #ifdef RTE_SCHED_RED
-	/** Number of packets dropped by red */
+	/** Number of packets dropped by red or pie */
 	uint64_t n_pkts_red_dropped[RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE];
 #endif
 };
@@ -223,7 +240,7 @@ struct rte_sched_queue_stats {
 	uint64_t n_pkts_dropped;
 
 #ifdef RTE_SCHED_RED
-	/** Packets dropped by RED */
+	/** Packets dropped by RED or PIE */
 	uint64_t n_pkts_red_dropped;
 #endif
 
@@ -234,6 +251,40 @@ struct rte_sched_queue_stats {
 	uint64_t n_bytes_dropped;
 };
 
+/** Number of buckets of the queueing delay histograms */
+#define RTE_SCHED_DELAY_HIST_SIZE 16
+
+/**
+ * Log2 of the upper bound of the first bucket of the queueing delay
+ * histograms, in nanoseconds
+ */
+#define RTE_SCHED_DELAY_HIST_SHIFT 10
+
+/**
+ * Subport queueing delay statistics, see rte_sched_port_delay_stats_enable().
+ *
+ * The queueing delay, or sojourn time, of a packet is the time from its
+ * enqueue to its dequeue. Bucket 0 of the histograms counts the delays below
+ * 1 << RTE_SCHED_DELAY_HIST_SHIFT nanoseconds, bucket i the delays from
+ * 1 << (RTE_SCHED_DELAY_HIST_SHIFT + i - 1) to
+ * 1 << (RTE_SCHED_DELAY_HIST_SHIFT + i) nanoseconds, and the last bucket
+ * all the longer delays.
+ */
+struct rte_sched_subport_delay_stats {
+	/** Number of packets dequeued for each traffic class */
+	uint64_t n_pkts_tc[RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE];
+
+	/** Sum of the delays for each traffic class, in nanoseconds */
+	uint64_t sum_ns_tc[RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE];
+
+	/** Max delay for each traffic class, in nanoseconds */
+	uint64_t max_ns_tc[RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE];
+
+	/** Delay histogram for each traffic class */
+	uint64_t hist_tc[RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE]
+		[RTE_SCHED_DELAY_HIST_SIZE];
+};
+
 /** Port configuration parameters. */
 struct rte_sched_port_params {
 	/** Name of the port to be associated */
@@ -347,6 +398,34 @@ rte_sched_port_subport_profile_add(struct rte_sched_port *port,
 	struct rte_sched_subport_profile_params *profile,
 	uint32_t *subport_profile_id);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Hierarchical scheduler port time share
+ *
+ * Share the NIC TX time of a port with a reference port, for the subports
+ * of a single NIC TX port to be split across several port scheduler
+ * instances, each one enqueued to and dequeued from its own lcore. The
+ * packets dequeued from any of the ports then consume the time of all of
+ * them, so that their subports are scheduled as within a single port.
+ * Several ports may share the time of the same reference port.
+ *
+ * It must be called before the first dequeue from either port.
+ *
+ * @param port
+ *   Handle to port scheduler instance
+ * @param ref_port
+ *   Handle to the reference port scheduler instance, configured with the
+ *   same rate and frame overhead
+ * @return
+ *   0 upon success, error code otherwise
+ */
+__rte_experimental
+int
+rte_sched_port_time_share(struct rte_sched_port *port,
+	struct rte_sched_port *ref_port);
+
 /**
  * Hierarchical scheduler subport configuration
  * Note that this function is safe to use at runtime
@@ -371,6 +450,45 @@ rte_sched_subport_config(struct rte_sched_port *port,
 	struct rte_sched_subport_params *params,
 	uint32_t subport_profile_id);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Hierarchical scheduler sparse subport configuration
+ *
+ * Same as rte_sched_subport_config(), except that the queue storage of the
+ * subport is not allocated for all of its pipes up front. The storage of a
+ * pipe is taken from a pool of n_active_pipes entries when a packet is
+ * enqueued to one of its empty queues, and given back once all its queues
+ * are empty again. This suits hierarchies where few of the configured pipes
+ * hold packets at any time. A packet enqueued to a pipe without storage
+ * while the pool is exhausted is dropped.
+ *
+ * @param port
+ *   Handle to port scheduler instance
+ * @param subport_id
+ *   Subport ID
+ * @param params
+ *   Subport configuration parameters. Must be non-NULL
+ *   for first invocation (i.e initialization) for a given
+ *   subport. Ignored (recommended value is NULL) for all
+ *   subsequent invocation on the same subport.
+ * @param subport_profile_id
+ *   ID of subport bandwidth profile
+ * @param n_active_pipes
+ *   Maximum number of pipes with packets at the same time, non-zero and
+ *   not greater than the number of enabled pipes of the subport
+ * @return
+ *   0 upon success, error code otherwise
+ */
+__rte_experimental
+int
+rte_sched_subport_config_sparse(struct rte_sched_port *port,
+	uint32_t subport_id,
+	struct rte_sched_subport_params *params,
+	uint32_t subport_profile_id,
+	uint32_t n_active_pipes);
+
 /**
  * Hierarchical scheduler pipe configuration
  *
@@ -454,6 +572,52 @@ rte_sched_queue_read_stats(struct rte_sched_port *port,
 	struct rte_sched_queue_stats *stats,
 	uint16_t *qlen);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Hierarchical scheduler port queueing delay statistics enable
+ *
+ * The packets are stamped with the TSC in an mbuf dynamic field on enqueue,
+ * and their queueing delay is accounted to the traffic class of their
+ * subport on dequeue. The statistics are read with
+ * rte_sched_subport_read_delay_stats(), and through the /sched/delay_stats
+ * telemetry command, taking the port index in the /sched/delay_ports list
+ * and the subport ID as parameters.
+ *
+ * It must be called before the first enqueue to the port.
+ *
+ * @param port
+ *   Handle to port scheduler instance
+ * @return
+ *   0 upon success, error code otherwise
+ */
+__rte_experimental
+int
+rte_sched_port_delay_stats_enable(struct rte_sched_port *port);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Hierarchical scheduler subport queueing delay statistics read
+ *
+ * @param port
+ *   Handle to port scheduler instance
+ * @param subport_id
+ *   Subport ID
+ * @param stats
+ *   Pointer to pre-allocated subport queueing delay statistics structure
+ *   where the statistics counters should be stored
+ * @return
+ *   0 upon success, error code otherwise
+ */
+__rte_experimental
+int
+rte_sched_subport_read_delay_stats(struct rte_sched_port *port,
+	uint32_t subport_id,
+	struct rte_sched_subport_delay_stats *stats);
+
 /**
  * Scheduler hierarchy path write to packet descriptor. Typically
  * called by the packet classification stage.
@@ -33,6 +33,7 @@ rte_security_dynfield_register(void)
 		.name = RTE_SECURITY_DYNFIELD_NAME,
 		.size = sizeof(rte_security_dynfield_t),
 		.align = __alignof__(rte_security_dynfield_t),
+		.flags = RTE_MBUF_DYNFIELD_F_HOT,
 	};
 	rte_security_dynfield_offset =
 		rte_mbuf_dynfield_register(&dynfield_desc);
@@ -30,7 +30,9 @@ rte_stack_init(struct rte_stack *s, unsigned int count, uint32_t flags)
 {
 	memset(s, 0, sizeof(*s));
 
-	if (flags & RTE_STACK_F_LF)
+	if (flags & RTE_STACK_F_LF_MAG)
+		rte_stack_lf_mag_init(s, count);
+	else if (flags & RTE_STACK_F_LF)
 		rte_stack_lf_init(s, count);
 	else
 		rte_stack_std_init(s);
@@ -39,7 +41,9 @@ rte_stack_init(struct rte_stack *s, unsigned int count, uint32_t flags)
 static ssize_t
 rte_stack_get_memsize(unsigned int count, uint32_t flags)
 {
-	if (flags & RTE_STACK_F_LF)
+	if (flags & RTE_STACK_F_LF_MAG)
+		return rte_stack_lf_mag_get_memsize(count);
+	else if (flags & RTE_STACK_F_LF)
 		return rte_stack_lf_get_memsize(count);
 	else
 		return rte_stack_std_get_memsize(count);
@@ -57,10 +61,12 @@ rte_stack_create(const char *name, unsigned int count, int socket_id,
 	unsigned int sz;
 	int ret;
 
-	if (flags & ~(RTE_STACK_F_LF)) {
+	if (flags & ~(RTE_STACK_F_LF | RTE_STACK_F_LF_MAG)) {
 		STACK_LOG_ERR("Unsupported stack flags %#x\n", flags);
 		return NULL;
 	}
+	if (flags & RTE_STACK_F_LF_MAG)
+		flags |= RTE_STACK_F_LF;
 
 #ifdef RTE_ARCH_64
 	RTE_BUILD_BUG_ON(sizeof(struct rte_stack_lf_head) != 16);
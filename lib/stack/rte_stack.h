@@ -61,6 +61,33 @@ struct rte_stack_lf {
 	struct rte_stack_lf_elem elems[] __rte_cache_aligned;
 };
 
+/** Number of objects in a magazine of a RTE_STACK_F_LF_MAG stack. */
+#define RTE_STACK_MAG_SIZE 32
+
+/* Magazine loaded by an lcore, only accessed by this lcore. */
+struct rte_stack_mag_cache {
+	struct rte_stack_lf_elem *mag; /**< Loaded magazine, or NULL */
+	uint32_t len; /**< Number of objects in the loaded magazine */
+} __rte_cache_aligned;
+
+/* Structure containing two lock-free LIFO lists of magazines, the data
+ * pointer of each element pointing to an array of RTE_STACK_MAG_SIZE objects.
+ */
+struct rte_stack_lf_mag {
+	/** LIFO list of full magazines */
+	struct rte_stack_lf_list full __rte_cache_aligned;
+	/** Number of objects, including the ones in the loaded magazines */
+	uint64_t len;
+	/** Loaded magazines, one per lcore plus one for the other threads */
+	struct rte_stack_mag_cache *caches;
+	/** LIFO list of empty magazines */
+	struct rte_stack_lf_list empty __rte_cache_aligned;
+	/** Lock of the loaded magazine of the non-EAL threads */
+	rte_spinlock_t lock;
+	/** Magazine elements */
+	struct rte_stack_lf_elem elems[] __rte_cache_aligned;
+};
+
 /* Structure containing the LIFO, its current length, and a lock for mutual
  * exclusion.
  */
@@ -84,6 +111,8 @@ struct rte_stack {
 	union {
 		struct rte_stack_lf stack_lf; /**< Lock-free LIFO structure. */
 		struct rte_stack_std stack_std;	/**< LIFO structure. */
+		/** Lock-free LIFO of magazines. */
+		struct rte_stack_lf_mag stack_lf_mag;
 	};
 } __rte_cache_aligned;
 
@@ -92,9 +121,16 @@ struct rte_stack {
  * supported on x86_64 or arm64 platforms, currently.
  */
 #define RTE_STACK_F_LF 0x0001
+/**
+ * The stack uses lock-free push and pop functions on magazines of
+ * RTE_STACK_MAG_SIZE objects, each lcore filling and emptying its own
+ * magazine. It implies RTE_STACK_F_LF.
+ */
+#define RTE_STACK_F_LF_MAG 0x0002
 
 #include "rte_stack_std.h"
 #include "rte_stack_lf.h"
+#include "rte_stack_lf_mag.h"
 
 /**
  * Push several objects on the stack (MT-safe).
@@ -114,7 +150,9 @@ rte_stack_push(struct rte_stack *s, void * const *obj_table, unsigned int n)
 	RTE_ASSERT(s != NULL);
 	RTE_ASSERT(obj_table != NULL);
 
-	if (s->flags & RTE_STACK_F_LF)
+	if (s->flags & RTE_STACK_F_LF_MAG)
+		return __rte_stack_lf_mag_push(s, obj_table, n);
+	else if (s->flags & RTE_STACK_F_LF)
 		return __rte_stack_lf_push(s, obj_table, n);
 	else
 		return __rte_stack_std_push(s, obj_table, n);
@@ -138,7 +176,9 @@ rte_stack_pop(struct rte_stack *s, void **obj_table, unsigned int n)
 	RTE_ASSERT(s != NULL);
 	RTE_ASSERT(obj_table != NULL);
 
-	if (s->flags & RTE_STACK_F_LF)
+	if (s->flags & RTE_STACK_F_LF_MAG)
+		return __rte_stack_lf_mag_pop(s, obj_table, n);
+	else if (s->flags & RTE_STACK_F_LF)
 		return __rte_stack_lf_pop(s, obj_table, n);
 	else
 		return __rte_stack_std_pop(s, obj_table, n);
@@ -157,7 +197,9 @@ rte_stack_count(struct rte_stack *s)
 {
 	RTE_ASSERT(s != NULL);
 
-	if (s->flags & RTE_STACK_F_LF)
+	if (s->flags & RTE_STACK_F_LF_MAG)
+		return __rte_stack_lf_mag_count(s);
+	else if (s->flags & RTE_STACK_F_LF)
 		return __rte_stack_lf_count(s);
 	else
 		return __rte_stack_std_count(s);
@@ -198,6 +240,11 @@ rte_stack_free_count(struct rte_stack *s)
  *    - RTE_STACK_F_LF: If this flag is set, the stack uses lock-free
  *      variants of the push and pop functions. Otherwise, it achieves
  *      thread-safety using a lock.
+ *    - RTE_STACK_F_LF_MAG: If this flag is set, the stack is lock-free and
+ *      moves the objects in magazines between the lcores and the lists
+ *      (experimental). An lcore only pops the objects of its own magazine
+ *      and of the full magazines: up to RTE_STACK_MAG_SIZE objects may be
+ *      counted in the stack but only available to the lcore holding them.
  * @return
  *   On success, the pointer to the new allocated stack. NULL on error with
  *    rte_errno set appropriately. Possible errno values include:
@@ -0,0 +1,60 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include "rte_stack.h"
+
+/*
+ * Each lcore loads at most one partially filled magazine, so that all
+ * the other magazines holding objects are full.
+ */
+static unsigned int
+stack_lf_mag_count(unsigned int count)
+{
+	return RTE_ALIGN_CEIL(count, RTE_STACK_MAG_SIZE) / RTE_STACK_MAG_SIZE +
+		RTE_MAX_LCORE + 1;
+}
+
+void
+rte_stack_lf_mag_init(struct rte_stack *s, unsigned int count)
+{
+	struct rte_stack_lf_elem *elems = s->stack_lf_mag.elems;
+	unsigned int i, nb_mags = stack_lf_mag_count(count);
+	void **objs;
+
+	s->stack_lf_mag.caches = RTE_PTR_ADD(elems,
+		RTE_CACHE_LINE_ROUNDUP(nb_mags * sizeof(*elems)));
+	objs = (void **)&s->stack_lf_mag.caches[RTE_MAX_LCORE + 1];
+
+	for (i = 0; i < RTE_MAX_LCORE + 1; i++) {
+		s->stack_lf_mag.caches[i].mag = NULL;
+		s->stack_lf_mag.caches[i].len = 0;
+	}
+	rte_spinlock_init(&s->stack_lf_mag.lock);
+
+	for (i = 0; i < nb_mags; i++) {
+		elems[i].data = &objs[i * RTE_STACK_MAG_SIZE];
+		__rte_stack_lf_push_elems(&s->stack_lf_mag.empty,
+					  &elems[i], &elems[i], 1);
+	}
+}
+
+ssize_t
+rte_stack_lf_mag_get_memsize(unsigned int count)
+{
+	unsigned int nb_mags = stack_lf_mag_count(count);
+	ssize_t sz = sizeof(struct rte_stack);
+
+	sz += RTE_CACHE_LINE_ROUNDUP(nb_mags *
+				     sizeof(struct rte_stack_lf_elem));
+	sz += (RTE_MAX_LCORE + 1) * sizeof(struct rte_stack_mag_cache);
+	sz += RTE_CACHE_LINE_ROUNDUP(nb_mags * RTE_STACK_MAG_SIZE *
+				     sizeof(void *));
+
+	/* Add padding to avoid false sharing conflicts caused by
+	 * next-line hardware prefetchers.
+	 */
+	sz += 2 * RTE_CACHE_LINE_SIZE;
+
+	return sz;
+}
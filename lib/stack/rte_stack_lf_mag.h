@@ -0,0 +1,253 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#ifndef _RTE_STACK_LF_MAG_H_
+#define _RTE_STACK_LF_MAG_H_
+
+#include <rte_branch_prediction.h>
+#include <rte_common.h>
+#include <rte_lcore.h>
+
+/*
+ * The objects are pushed to and popped from the magazine loaded by the lcore.
+ * Only the full magazines are pushed to the lock-free list, and taken back by
+ * the lcores running out of objects, so that the lists are walked by
+ * magazines instead of by objects.
+ */
+
+static __rte_always_inline struct rte_stack_mag_cache *
+__rte_stack_lf_mag_cache_get(struct rte_stack *s)
+{
+	unsigned int lcore_id = rte_lcore_id();
+
+	if (likely(lcore_id < RTE_MAX_LCORE))
+		return &s->stack_lf_mag.caches[lcore_id];
+
+	/* the threads without lcore share the last one */
+	rte_spinlock_lock(&s->stack_lf_mag.lock);
+	return &s->stack_lf_mag.caches[RTE_MAX_LCORE];
+}
+
+static __rte_always_inline void
+__rte_stack_lf_mag_cache_put(struct rte_stack *s,
+			     struct rte_stack_mag_cache *cache)
+{
+	if (unlikely(cache == &s->stack_lf_mag.caches[RTE_MAX_LCORE]))
+		rte_spinlock_unlock(&s->stack_lf_mag.lock);
+}
+
+/**
+ * @internal Return the number of objects in the magazine stack, including
+ * the ones in the magazines loaded by the lcores.
+ */
+static __rte_always_inline unsigned int
+__rte_stack_lf_mag_count(struct rte_stack *s)
+{
+	return (unsigned int)__atomic_load_n(&s->stack_lf_mag.len,
+					     __ATOMIC_RELAXED);
+}
+
+/**
+ * @internal Push several objects on the magazine stack (MT-safe).
+ *
+ * @param s
+ *   A pointer to the stack structure.
+ * @param obj_table
+ *   A pointer to a table of void * pointers (objects).
+ * @param n
+ *   The number of objects to push on the stack from the obj_table.
+ * @return
+ *   Actual number of objects pushed (either 0 or *n*).
+ */
+static __rte_always_inline unsigned int
+__rte_stack_lf_mag_push(struct rte_stack *s, void * const *obj_table,
+			unsigned int n)
+{
+	struct rte_stack_lf_mag *stack = &s->stack_lf_mag;
+	struct rte_stack_lf_elem *full_first = NULL, *full_last = NULL;
+	struct rte_stack_lf_elem *first = NULL, *last = NULL;
+	struct rte_stack_mag_cache *cache;
+	struct rte_stack_lf_elem *mag;
+	unsigned int len, nb_mags, nb_full, i;
+	uint64_t old_len;
+	void **objs;
+
+	if (unlikely(n == 0))
+		return 0;
+
+	/* Reserve room for n objects, if available */
+	old_len = __atomic_load_n(&stack->len, __ATOMIC_RELAXED);
+	do {
+		if (unlikely(old_len + n > s->capacity))
+			return 0;
+	} while (!__atomic_compare_exchange_n(&stack->len, &old_len,
+					      old_len + n, 1,
+					      __ATOMIC_RELAXED,
+					      __ATOMIC_RELAXED));
+
+	cache = __rte_stack_lf_mag_cache_get(s);
+	mag = cache->mag;
+	len = cache->len;
+
+	/* Take all the empty magazines needed at once */
+	nb_mags = (len + n + RTE_STACK_MAG_SIZE - 1) / RTE_STACK_MAG_SIZE -
+		(mag != NULL);
+	if (nb_mags > 0) {
+		first = __rte_stack_lf_pop_elems(&stack->empty, nb_mags,
+						 NULL, &last);
+		if (unlikely(first == NULL)) {
+			__rte_stack_lf_mag_cache_put(s, cache);
+			__atomic_fetch_sub(&stack->len, n, __ATOMIC_RELAXED);
+			return 0;
+		}
+	}
+
+	nb_full = 0;
+	for (i = 0; i < n; ) {
+		if (mag == NULL) {
+			mag = first;
+			first = first->next;
+			len = 0;
+		}
+
+		objs = mag->data;
+		while (len < RTE_STACK_MAG_SIZE && i < n)
+			objs[len++] = obj_table[i++];
+
+		/* The last filled magazine goes on top */
+		if (len == RTE_STACK_MAG_SIZE) {
+			mag->next = full_first;
+			full_first = mag;
+			if (full_last == NULL)
+				full_last = mag;
+			nb_full++;
+			mag = NULL;
+			len = 0;
+		}
+	}
+
+	cache->mag = mag;
+	cache->len = len;
+	__rte_stack_lf_mag_cache_put(s, cache);
+
+	if (full_first != NULL)
+		__rte_stack_lf_push_elems(&stack->full, full_first, full_last,
+					  nb_full);
+
+	return n;
+}
+
+/**
+ * @internal Pop several objects from the magazine stack (MT-safe).
+ *
+ * @param s
+ *   A pointer to the stack structure.
+ * @param obj_table
+ *   A pointer to a table of void * pointers (objects).
+ * @param n
+ *   The number of objects to pull from the stack.
+ * @return
+ *   Actual number of objects popped (either 0 or *n*).
+ */
+static __rte_always_inline unsigned int
+__rte_stack_lf_mag_pop(struct rte_stack *s, void **obj_table, unsigned int n)
+{
+	struct rte_stack_lf_mag *stack = &s->stack_lf_mag;
+	struct rte_stack_lf_elem *empty_first, *empty_last;
+	struct rte_stack_lf_elem *first, *last = NULL;
+	struct rte_stack_lf_elem *mag, *next;
+	struct rte_stack_mag_cache *cache;
+	unsigned int len, nb_mags, nb_empty, i, j;
+	void **objs;
+
+	if (unlikely(n == 0))
+		return 0;
+
+	cache = __rte_stack_lf_mag_cache_get(s);
+	mag = cache->mag;
+	len = cache->len;
+
+	if (len >= n) {
+		objs = mag->data;
+		for (i = 0; i < n; i++)
+			obj_table[i] = objs[--len];
+		cache->len = len;
+		__rte_stack_lf_mag_cache_put(s, cache);
+		__atomic_fetch_sub(&stack->len, n, __ATOMIC_RELAXED);
+		return n;
+	}
+
+	/* Take the full magazines holding the missing objects */
+	nb_mags = (n - len + RTE_STACK_MAG_SIZE - 1) / RTE_STACK_MAG_SIZE;
+	first = __rte_stack_lf_pop_elems(&stack->full, nb_mags, NULL, &last);
+	if (unlikely(first == NULL)) {
+		__rte_stack_lf_mag_cache_put(s, cache);
+		return 0;
+	}
+
+	i = 0;
+	nb_empty = 0;
+	empty_first = NULL;
+	empty_last = NULL;
+	if (mag != NULL) {
+		objs = mag->data;
+		while (len > 0)
+			obj_table[i++] = objs[--len];
+		empty_first = mag;
+		empty_last = mag;
+		nb_empty++;
+	}
+
+	/* All the magazines are emptied, except the last one */
+	for (j = 0; j < nb_mags; j++, first = next) {
+		next = first->next;
+		objs = first->data;
+		len = RTE_STACK_MAG_SIZE;
+		while (len > 0 && i < n)
+			obj_table[i++] = objs[--len];
+
+		if (j == nb_mags - 1)
+			break;
+		first->next = empty_first;
+		empty_first = first;
+		if (empty_last == NULL)
+			empty_last = first;
+		nb_empty++;
+	}
+
+	cache->mag = first;
+	cache->len = len;
+	__rte_stack_lf_mag_cache_put(s, cache);
+
+	if (nb_empty > 0)
+		__rte_stack_lf_push_elems(&stack->empty, empty_first,
+					  empty_last, nb_empty);
+	__atomic_fetch_sub(&stack->len, n, __ATOMIC_RELAXED);
+
+	return n;
+}
+
+/**
+ * @internal Initialize a lock-free magazine stack.
+ *
+ * @param s
+ *   A pointer to the stack structure.
+ * @param count
+ *   The size of the stack.
+ */
+void
+rte_stack_lf_mag_init(struct rte_stack *s, unsigned int count);
+
+/**
+ * @internal Return the memory required for a lock-free magazine stack.
+ *
+ * @param count
+ *   The size of the stack.
+ * @return
+ *   The bytes to allocate for a lock-free magazine stack.
+ */
+ssize_t
+rte_stack_lf_mag_get_memsize(unsigned int count);
+
+#endif /* _RTE_STACK_LF_MAG_H_ */
@@ -253,6 +253,42 @@ typedef int
 			  uint8_t **action_data,
 			  int *hit);
 
+/**
+ * Table bulk lookup
+ *
+ * The table bulk lookup operation searches a burst of keys in the table and
+ * completes all of them before returning. It is equivalent to running the
+ * table lookup operation for each key, but it is able to spread the memory
+ * read operations of the different keys across the processing stages of the
+ * burst, so that the prefetch latency of each key is hidden behind the work
+ * done for the other keys.
+ *
+ * @param[in] table
+ *   Table handle.
+ * @param[in] keys
+ *   Array of *n_keys* lookup keys. The size of each key must be equal to the
+ *   table *key_size*.
+ * @param[out] action_id
+ *   Array of *n_keys* action IDs. The action ID of each key is only valid when
+ *   the respective *hit* is set to true.
+ * @param[out] action_data
+ *   Array of *n_keys* action data pointers. The action data of each key is only
+ *   valid when the respective *hit* is set to true.
+ * @param[out] hit
+ *   Array of *n_keys* lookup results. Each element is set to non-zero (true) on
+ *   table lookup hit and to zero (false) on table lookup miss for the
+ *   respective key.
+ * @param[in] n_keys
+ *   Number of keys to look up.
+ */
+typedef void
+(*rte_swx_table_lookup_bulk_t)(void *table,
+			       uint8_t **keys,
+			       uint64_t *action_id,
+			       uint8_t **action_data,
+			       int *hit,
+			       uint32_t n_keys);
+
 /**
  * Table free
  *
@@ -290,6 +326,11 @@ struct rte_swx_table_ops {
 
 	/** Table free. Must be non-NULL. */
 	rte_swx_table_free_t free;
+
+	/** Table bulk lookup. Set to NULL when not supported, in which case
+	 * the table lookup operation is used for each key.
+	 */
+	rte_swx_table_lookup_bulk_t lkp_bulk;
 };
 
 #ifdef __cplusplus
@@ -781,6 +781,48 @@ table_lookup(void *table,
 	}
 }
 
+#ifndef RTE_SWX_TABLE_EM_LOOKUP_BULK_MAX
+#define RTE_SWX_TABLE_EM_LOOKUP_BULK_MAX 16
+#endif
+
+static void
+table_lookup_bulk(void *table,
+		  uint8_t **keys,
+		  uint64_t *action_id,
+		  uint8_t **action_data,
+		  int *hit,
+		  uint32_t n_keys)
+{
+	struct mailbox m[RTE_SWX_TABLE_EM_LOOKUP_BULK_MAX];
+	uint32_t pos, n, i;
+
+	for (pos = 0; pos < n_keys; pos += n) {
+		n = RTE_MIN(n_keys - pos,
+			    (uint32_t)RTE_SWX_TABLE_EM_LOOKUP_BULK_MAX);
+
+		/* Run each lookup stage for all the keys before moving to the
+		 * next stage, so that the bucket and the key prefetches issued
+		 * for each key complete while the other keys are processed.
+		 */
+		for (i = 0; i < n; i++) {
+			m[i].state = 0;
+			table_lookup(table, &m[i], &keys[pos + i],
+				     &action_id[pos + i], &action_data[pos + i],
+				     &hit[pos + i]);
+		}
+
+		for (i = 0; i < n; i++)
+			table_lookup(table, &m[i], &keys[pos + i],
+				     &action_id[pos + i], &action_data[pos + i],
+				     &hit[pos + i]);
+
+		for (i = 0; i < n; i++)
+			table_lookup(table, &m[i], &keys[pos + i],
+				     &action_id[pos + i], &action_data[pos + i],
+				     &hit[pos + i]);
+	}
+}
+
 static void *
 table_create(struct rte_swx_table_params *params,
 	     struct rte_swx_table_entry_list *entries,
@@ -846,4 +888,5 @@ struct rte_swx_table_ops rte_swx_table_exact_match_ops = {
 	.del = table_del,
 	.lkp = table_lookup,
 	.free = table_free,
+	.lkp_bulk = table_lookup_bulk,
 };
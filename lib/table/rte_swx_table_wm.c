@@ -458,6 +458,45 @@ table_lookup(void *table,
 	return 1;
 }
 
+#ifndef RTE_SWX_TABLE_WM_LOOKUP_BULK_MAX
+#define RTE_SWX_TABLE_WM_LOOKUP_BULK_MAX 16
+#endif
+
+static void
+table_lookup_bulk(void *table,
+		  const uint8_t **keys,
+		  uint64_t *action_id,
+		  uint8_t **action_data,
+		  int *hit,
+		  uint32_t n_keys)
+{
+	struct table *t = table;
+	uint32_t user_data[RTE_SWX_TABLE_WM_LOOKUP_BULK_MAX];
+	uint32_t pos, n, i;
+
+	for (pos = 0; pos < n_keys; pos += n) {
+		n = RTE_MIN(n_keys - pos,
+			    (uint32_t)RTE_SWX_TABLE_WM_LOOKUP_BULK_MAX);
+
+		/* The ACL classifier processes multiple keys in parallel. */
+		rte_acl_classify(t->acl_ctx, &keys[pos], user_data, n, 1);
+
+		for (i = 0; i < n; i++) {
+			uint8_t *data;
+
+			if (!user_data[i]) {
+				hit[pos + i] = 0;
+				continue;
+			}
+
+			data = &t->data[(user_data[i] - 1) * t->entry_data_size];
+			action_id[pos + i] = ((uint64_t *)data)[0];
+			action_data[pos + i] = &data[8];
+			hit[pos + i] = 1;
+		}
+	}
+}
+
 struct rte_swx_table_ops rte_swx_table_wildcard_match_ops = {
 	.footprint_get = NULL,
 	.mailbox_size_get = table_mailbox_size_get,
@@ -466,4 +505,5 @@ struct rte_swx_table_ops rte_swx_table_wildcard_match_ops = {
 	.del = NULL,
 	.lkp = (rte_swx_table_lookup_t)table_lookup,
 	.free = table_free,
+	.lkp_bulk = (rte_swx_table_lookup_bulk_t)table_lookup_bulk,
 };
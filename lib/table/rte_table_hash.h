@@ -43,8 +43,16 @@ extern "C" {
  *        4 keys, potentially until all keys in this bucket are examined. The
  *        extendable bucket logic requires maintaining specific data structures
  *        per table and per each bucket. Use-cases: flow table, etc.
+ *     c. Fail (sig): The key add operation fails with -ENOSPC. The buckets
+ *        only hold the 16-bit signatures of 16 keys, which fit in 32 bytes
+ *        and are all matched at once with vector instructions, the keys and
+ *        the data being stored at a position given by the bucket and its
+ *        lane. The lookup operation hashes the keys, matches the signatures
+ *        and compares the keys of the whole burst in separate stages, to
+ *        hide the memory latency. Use-cases: flow table with a known
+ *        maximum number of keys, etc.
  * 2. Key size:
- *     a. Configurable key size
+ *     a. Configurable key size (up to 64-byte key size for the sig table)
  *     b. Single key size (8-byte, 16-byte or 32-byte key size)
  *
  ***/
@@ -99,6 +107,9 @@ extern struct rte_table_ops rte_table_hash_key8_lru_ops;
 extern struct rte_table_ops rte_table_hash_key16_lru_ops;
 extern struct rte_table_ops rte_table_hash_key32_lru_ops;
 
+/** Signature match hash table operations */
+extern struct rte_table_ops rte_table_hash_sig_ops;
+
 #ifdef __cplusplus
 }
 #endif
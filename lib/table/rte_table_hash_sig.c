@@ -0,0 +1,528 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <string.h>
+#include <stdio.h>
+
+#include <rte_common.h>
+#include <rte_mbuf.h>
+#include <rte_memory.h>
+#include <rte_malloc.h>
+#include <rte_log.h>
+#include <rte_prefetch.h>
+#include <rte_vect.h>
+
+#include "rte_table_hash.h"
+
+/*
+ * Each bucket only holds the 16-bit signatures of its keys, so that all of
+ * them are matched at once. The key and the data of the entry stored in
+ * the lane i of the bucket b are found at the index (b * KEYS_PER_BUCKET + i)
+ * of the key and data arrays, without any indirection.
+ */
+#define KEYS_PER_BUCKET	16
+
+#define KEY_SIZE_MAX	64
+
+struct bucket {
+	uint16_t sig[KEYS_PER_BUCKET];
+} __rte_aligned(KEYS_PER_BUCKET * sizeof(uint16_t));
+
+#ifdef RTE_TABLE_STATS_COLLECT
+
+#define RTE_TABLE_HASH_SIG_STATS_PKTS_IN_ADD(table, val) \
+	table->stats.n_pkts_in += val
+#define RTE_TABLE_HASH_SIG_STATS_PKTS_LOOKUP_MISS(table, val) \
+	table->stats.n_pkts_lookup_miss += val
+
+#else
+
+#define RTE_TABLE_HASH_SIG_STATS_PKTS_IN_ADD(table, val)
+#define RTE_TABLE_HASH_SIG_STATS_PKTS_LOOKUP_MISS(table, val)
+
+#endif
+
+struct grinder {
+	struct bucket *bkt;
+	uint32_t match;
+	uint32_t bkt_index;
+	uint16_t sig;
+};
+
+struct rte_table_hash {
+	struct rte_table_stats stats;
+
+	/* Input parameters */
+	uint32_t key_size;
+	uint32_t entry_size;
+	uint32_t n_keys;
+	uint32_t n_buckets;
+	rte_table_hash_op_hash f_hash;
+	uint64_t seed;
+	uint32_t key_offset;
+
+	/* Internal */
+	uint64_t bucket_mask;
+	uint32_t key_size_shl;
+	uint32_t data_size_shl;
+	uint32_t n_keys_used;
+
+	/* Grinder */
+	struct grinder grinders[RTE_PORT_IN_BURST_SIZE_MAX];
+
+	/* Tables */
+	uint64_t *key_mask;
+	struct bucket *buckets;
+	uint8_t *key_mem;
+	uint8_t *data_mem;
+
+	/* Table memory */
+	uint8_t memory[0] __rte_cache_aligned;
+};
+
+/*
+ * Match a signature against all the signatures of a bucket. Each lane of
+ * the bucket is represented by 2 bits of the returned mask, both set when
+ * the lane signature is equal to sig.
+ */
+static __rte_always_inline uint32_t
+bucket_match(const struct bucket *bkt, uint16_t sig)
+{
+#if defined(__AVX2__)
+	__m256i x = _mm256_load_si256((const __m256i *)bkt->sig);
+
+	return (uint32_t)_mm256_movemask_epi8(
+		_mm256_cmpeq_epi16(x, _mm256_set1_epi16(sig)));
+#elif defined(RTE_ARCH_X86)
+	__m128i s = _mm_set1_epi16(sig);
+	__m128i x0 = _mm_load_si128((const __m128i *)&bkt->sig[0]);
+	__m128i x1 = _mm_load_si128((const __m128i *)&bkt->sig[8]);
+
+	return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi16(x0, s)) |
+		((uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi16(x1, s)) << 16);
+#else
+	uint32_t match = 0, i;
+
+	for (i = 0; i < KEYS_PER_BUCKET; i++)
+		if (bkt->sig[i] == sig)
+			match |= 3U << (i * 2);
+	return match;
+#endif
+}
+
+/* Extract the lane of the first match, and clear it from the mask. */
+static __rte_always_inline uint32_t
+match_next(uint32_t *match)
+{
+	uint32_t pos = __builtin_ctz(*match);
+
+	*match &= ~(3U << pos);
+	return pos >> 1;
+}
+
+static __rte_always_inline int
+keycmp_n(const uint64_t *a, const uint64_t *b, const uint64_t *b_mask,
+	uint32_t n_words)
+{
+	uint64_t xor = 0;
+	uint32_t i;
+
+	for (i = 0; i < n_words; i++)
+		xor |= a[i] ^ (b[i] & b_mask[i]);
+
+	return xor != 0;
+}
+
+/* Compare a stored key with a key to be masked, the size being unrolled. */
+static inline int
+keycmp(void *a, void *b, void *b_mask, uint32_t n_bytes)
+{
+	switch (n_bytes) {
+	case 8:
+		return keycmp_n(a, b, b_mask, 1);
+	case 16:
+		return keycmp_n(a, b, b_mask, 2);
+	case 32:
+		return keycmp_n(a, b, b_mask, 4);
+	default:
+		return keycmp_n(a, b, b_mask, 8);
+	}
+}
+
+static void
+keycpy(void *dst, void *src, void *src_mask, uint32_t n_bytes)
+{
+	uint64_t *dst64 = dst, *src64 = src, *src_mask64 = src_mask;
+	uint32_t i;
+
+	for (i = 0; i < n_bytes / sizeof(uint64_t); i++)
+		dst64[i] = src64[i] & src_mask64[i];
+}
+
+static int
+check_params_create(struct rte_table_hash_params *params)
+{
+	/* name */
+	if (params->name == NULL) {
+		RTE_LOG(ERR, TABLE, "%s: name invalid value\n", __func__);
+		return -EINVAL;
+	}
+
+	/* key_size */
+	if ((params->key_size < sizeof(uint64_t)) ||
+		(params->key_size > KEY_SIZE_MAX) ||
+		(!rte_is_power_of_2(params->key_size))) {
+		RTE_LOG(ERR, TABLE, "%s: key_size invalid value\n", __func__);
+		return -EINVAL;
+	}
+
+	/* n_keys */
+	if (params->n_keys == 0) {
+		RTE_LOG(ERR, TABLE, "%s: n_keys invalid value\n", __func__);
+		return -EINVAL;
+	}
+
+	/* n_buckets */
+	if ((params->n_buckets == 0) ||
+		(!rte_is_power_of_2(params->n_buckets)) ||
+		(params->n_buckets > UINT32_MAX / KEYS_PER_BUCKET)) {
+		RTE_LOG(ERR, TABLE, "%s: n_buckets invalid value\n", __func__);
+		return -EINVAL;
+	}
+
+	/* f_hash */
+	if (params->f_hash == NULL) {
+		RTE_LOG(ERR, TABLE, "%s: f_hash invalid value\n", __func__);
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+static void *
+rte_table_hash_sig_create(void *params, int socket_id, uint32_t entry_size)
+{
+	struct rte_table_hash_params *p = params;
+	struct rte_table_hash *t;
+	uint64_t table_meta_sz, key_mask_sz, bucket_sz, key_sz, data_sz;
+	uint64_t total_size, n_slots;
+	uint64_t key_mask_offset, bucket_offset, key_offset, data_offset;
+
+	/* Check input parameters */
+	if ((check_params_create(p) != 0) ||
+		(!rte_is_power_of_2(entry_size)) ||
+		((sizeof(struct rte_table_hash) % RTE_CACHE_LINE_SIZE) != 0))
+		return NULL;
+
+	/*
+	 * Table dimensioning
+	 *
+	 * There is no bucket extension: a key slot is reserved for each lane
+	 * of each bucket, and the key add operation fails when its bucket is
+	 * full. With 16 keys per bucket, this is unlikely below a load factor
+	 * of 50%, so n_buckets should be at least n_keys / 8.
+	 */
+	n_slots = (uint64_t)p->n_buckets * KEYS_PER_BUCKET;
+
+	/* Memory allocation */
+	table_meta_sz = RTE_CACHE_LINE_ROUNDUP(sizeof(struct rte_table_hash));
+	key_mask_sz = RTE_CACHE_LINE_ROUNDUP(p->key_size);
+	bucket_sz = RTE_CACHE_LINE_ROUNDUP(p->n_buckets * sizeof(struct bucket));
+	key_sz = RTE_CACHE_LINE_ROUNDUP(n_slots * p->key_size);
+	data_sz = RTE_CACHE_LINE_ROUNDUP(n_slots * entry_size);
+	total_size = table_meta_sz + key_mask_sz + bucket_sz + key_sz + data_sz;
+
+	if (total_size > SIZE_MAX) {
+		RTE_LOG(ERR, TABLE, "%s: Cannot allocate %" PRIu64 " bytes"
+			" for hash table %s\n",
+			__func__, total_size, p->name);
+		return NULL;
+	}
+
+	t = rte_zmalloc_socket(p->name,
+		(size_t)total_size,
+		RTE_CACHE_LINE_SIZE,
+		socket_id);
+	if (t == NULL) {
+		RTE_LOG(ERR, TABLE, "%s: Cannot allocate %" PRIu64 " bytes"
+			" for hash table %s\n",
+			__func__, total_size, p->name);
+		return NULL;
+	}
+	RTE_LOG(INFO, TABLE, "%s (%u-byte key): Hash table %s memory "
+		"footprint is %" PRIu64 " bytes\n",
+		__func__, p->key_size, p->name, total_size);
+
+	/* Memory initialization */
+	t->key_size = p->key_size;
+	t->entry_size = entry_size;
+	t->n_keys = p->n_keys;
+	t->n_buckets = p->n_buckets;
+	t->f_hash = p->f_hash;
+	t->seed = p->seed;
+	t->key_offset = p->key_offset;
+
+	/* Internal */
+	t->bucket_mask = t->n_buckets - 1;
+	t->key_size_shl = __builtin_ctzl(p->key_size);
+	t->data_size_shl = __builtin_ctzl(entry_size);
+
+	/* Tables */
+	key_mask_offset = 0;
+	bucket_offset = key_mask_offset + key_mask_sz;
+	key_offset = bucket_offset + bucket_sz;
+	data_offset = key_offset + key_sz;
+
+	t->key_mask = (uint64_t *) &t->memory[key_mask_offset];
+	t->buckets = (struct bucket *) &t->memory[bucket_offset];
+	t->key_mem = &t->memory[key_offset];
+	t->data_mem = &t->memory[data_offset];
+
+	/* Key mask */
+	if (p->key_mask == NULL)
+		memset(t->key_mask, 0xFF, p->key_size);
+	else
+		memcpy(t->key_mask, p->key_mask, p->key_size);
+
+	return t;
+}
+
+static int
+rte_table_hash_sig_free(void *table)
+{
+	struct rte_table_hash *t = table;
+
+	/* Check input parameters */
+	if (t == NULL)
+		return -EINVAL;
+
+	rte_free(t);
+	return 0;
+}
+
+static inline struct bucket *
+bucket_get(struct rte_table_hash *t, void *key, uint32_t *bkt_index,
+	uint16_t *sig)
+{
+	uint64_t hash;
+
+	hash = t->f_hash(key, t->key_mask, t->key_size, t->seed);
+	*bkt_index = hash & t->bucket_mask;
+	*sig = (uint16_t)((hash >> 16) | 1LLU);
+
+	return &t->buckets[*bkt_index];
+}
+
+/* Return the key slot of the key in the bucket, or -1 if not present. */
+static inline int64_t
+bucket_key_find(struct rte_table_hash *t, struct bucket *bkt,
+	uint32_t bkt_index, uint16_t sig, void *key)
+{
+	uint32_t match = bucket_match(bkt, sig);
+
+	while (match != 0) {
+		uint32_t slot = bkt_index * KEYS_PER_BUCKET + match_next(&match);
+		uint8_t *bkt_key = &t->key_mem[slot << t->key_size_shl];
+
+		if (keycmp(bkt_key, key, t->key_mask, t->key_size) == 0)
+			return slot;
+	}
+
+	return -1;
+}
+
+static int
+rte_table_hash_sig_entry_add(void *table, void *key, void *entry,
+	int *key_found, void **entry_ptr)
+{
+	struct rte_table_hash *t = table;
+	struct bucket *bkt;
+	uint32_t bkt_index, match, lane, slot;
+	uint8_t *data;
+	int64_t pos;
+	uint16_t sig;
+
+	bkt = bucket_get(t, key, &bkt_index, &sig);
+
+	/* Key is present in the bucket */
+	pos = bucket_key_find(t, bkt, bkt_index, sig, key);
+	if (pos >= 0) {
+		data = &t->data_mem[pos << t->data_size_shl];
+		memcpy(data, entry, t->entry_size);
+		*key_found = 1;
+		*entry_ptr = (void *) data;
+		return 0;
+	}
+
+	/* Key is not present in the bucket: the empty lanes have a null sig */
+	match = bucket_match(bkt, 0);
+	if ((match == 0) || (t->n_keys_used == t->n_keys))
+		return -ENOSPC;
+
+	lane = match_next(&match);
+	slot = bkt_index * KEYS_PER_BUCKET + lane;
+	data = &t->data_mem[slot << t->data_size_shl];
+
+	keycpy(&t->key_mem[slot << t->key_size_shl], key, t->key_mask,
+		t->key_size);
+	memcpy(data, entry, t->entry_size);
+	bkt->sig[lane] = sig;
+	t->n_keys_used++;
+
+	*key_found = 0;
+	*entry_ptr = (void *) data;
+	return 0;
+}
+
+static int
+rte_table_hash_sig_entry_delete(void *table, void *key, int *key_found,
+	void *entry)
+{
+	struct rte_table_hash *t = table;
+	struct bucket *bkt;
+	uint32_t bkt_index;
+	int64_t pos;
+	uint16_t sig;
+
+	bkt = bucket_get(t, key, &bkt_index, &sig);
+
+	pos = bucket_key_find(t, bkt, bkt_index, sig, key);
+	if (pos < 0) {
+		/* Key is not present in the bucket */
+		*key_found = 0;
+		return 0;
+	}
+
+	/* Uninstall key from bucket */
+	bkt->sig[pos % KEYS_PER_BUCKET] = 0;
+	t->n_keys_used--;
+	*key_found = 1;
+	if (entry)
+		memcpy(entry, &t->data_mem[pos << t->data_size_shl],
+			t->entry_size);
+
+	return 0;
+}
+
+/***
+ * The lookup function processes the whole burst in three stages, each
+ * stage prefetching the data needed by the next one for all the packets,
+ * so that the latency of each prefetch is hidden by the processing of the
+ * other packets:
+ *
+ *  1. Hash the key of each packet and prefetch its bucket.
+ *  2. Match the signature against all the signatures of the bucket and
+ *     prefetch the key of the first matching lane.
+ *  3. Compare the keys of the matching lanes, and prefetch the data of
+ *     the matching entry.
+ *
+ ***/
+static int
+rte_table_hash_sig_lookup(
+	void *table,
+	struct rte_mbuf **pkts,
+	uint64_t pkts_mask,
+	uint64_t *lookup_hit_mask,
+	void **entries)
+{
+	struct rte_table_hash *t = table;
+	struct grinder *g = t->grinders;
+	struct bucket *buckets = t->buckets;
+	uint8_t *key_mem = t->key_mem;
+	uint8_t *data_mem = t->data_mem;
+	uint32_t key_size_shl = t->key_size_shl;
+	uint32_t data_size_shl = t->data_size_shl;
+	uint32_t key_offset = t->key_offset;
+	uint64_t pkts_mask_out = 0, mask;
+
+	__rte_unused uint32_t n_pkts_in = __builtin_popcountll(pkts_mask);
+	RTE_TABLE_HASH_SIG_STATS_PKTS_IN_ADD(t, n_pkts_in);
+
+	/* Stage 1: hash and bucket prefetch */
+	for (mask = pkts_mask; mask; mask &= mask - 1) {
+		uint32_t pkt_index = __builtin_ctzll(mask);
+		uint8_t *key;
+		uint64_t hash;
+
+		key = RTE_MBUF_METADATA_UINT8_PTR(pkts[pkt_index], key_offset);
+		hash = t->f_hash(key, t->key_mask, t->key_size, t->seed);
+
+		g[pkt_index].bkt_index = hash & t->bucket_mask;
+		g[pkt_index].bkt = &buckets[g[pkt_index].bkt_index];
+		g[pkt_index].sig = (uint16_t)((hash >> 16) | 1LLU);
+		rte_prefetch0(g[pkt_index].bkt);
+	}
+
+	/* Stage 2: signature match and key prefetch */
+	for (mask = pkts_mask; mask; mask &= mask - 1) {
+		uint32_t pkt_index = __builtin_ctzll(mask);
+		uint32_t match, slot;
+
+		match = bucket_match(g[pkt_index].bkt, g[pkt_index].sig);
+		g[pkt_index].match = match;
+		if (match == 0)
+			continue;
+
+		slot = g[pkt_index].bkt_index * KEYS_PER_BUCKET +
+			(__builtin_ctz(match) >> 1);
+		rte_prefetch0(&key_mem[slot << key_size_shl]);
+	}
+
+	/* Stage 3: key compare and data prefetch */
+	for (mask = pkts_mask; mask; mask &= mask - 1) {
+		uint32_t pkt_index = __builtin_ctzll(mask);
+		uint32_t match = g[pkt_index].match;
+		uint8_t *key;
+
+		if (match == 0)
+			continue;
+
+		key = RTE_MBUF_METADATA_UINT8_PTR(pkts[pkt_index], key_offset);
+		do {
+			uint32_t slot = g[pkt_index].bkt_index *
+				KEYS_PER_BUCKET + match_next(&match);
+
+			if (keycmp(&key_mem[slot << key_size_shl], key,
+				t->key_mask, t->key_size) == 0) {
+				uint8_t *data = &data_mem[slot << data_size_shl];
+
+				rte_prefetch0(data);
+				entries[pkt_index] = (void *) data;
+				pkts_mask_out |= 1LLU << pkt_index;
+				break;
+			}
+		} while (match != 0);
+	}
+
+	*lookup_hit_mask = pkts_mask_out;
+	RTE_TABLE_HASH_SIG_STATS_PKTS_LOOKUP_MISS(t, n_pkts_in -
+		__builtin_popcountll(pkts_mask_out));
+	return 0;
+}
+
+static int
+rte_table_hash_sig_stats_read(void *table, struct rte_table_stats *stats,
+	int clear)
+{
+	struct rte_table_hash *t = table;
+
+	if (stats != NULL)
+		memcpy(stats, &t->stats, sizeof(t->stats));
+
+	if (clear)
+		memset(&t->stats, 0, sizeof(t->stats));
+
+	return 0;
+}
+
+struct rte_table_ops rte_table_hash_sig_ops = {
+	.f_create = rte_table_hash_sig_create,
+	.f_free = rte_table_hash_sig_free,
+	.f_add = rte_table_hash_sig_entry_add,
+	.f_delete = rte_table_hash_sig_entry_delete,
+	.f_add_bulk = NULL,
+	.f_delete_bulk = NULL,
+	.f_lookup = rte_table_hash_sig_lookup,
+	.f_stats = rte_table_hash_sig_stats_read,
+};
@@ -0,0 +1,134 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#ifndef _RTE_TELEMETRY_COUNTERS_H_
+#define _RTE_TELEMETRY_COUNTERS_H_
+
+/**
+ * @file
+ *
+ * RTE Telemetry shared memory counters.
+ *
+ * @warning
+ * @b EXPERIMENTAL:
+ * All functions in this file may be changed or removed without prior notice.
+ *
+ * Libraries and applications can register blocks of 64-bit counters,
+ * which are allocated in a shared memory region: the datapath updates them
+ * in place, as it would update private counters, and the collectors read
+ * them by mapping the region, without any request to the process.
+ *
+ * The region is the file dpdk_counters.<pid> in the runtime directory,
+ * created on the first registration and removed at exit. It starts with
+ * a struct rte_tel_counters_hdr, followed by the table of block descriptors
+ * and the data area holding the names and values of the counters.
+ * All offsets are relative to the start of the region.
+ *
+ * The values can be read at any time, each counter being a naturally
+ * aligned 64-bit integer. The descriptors only change when blocks are
+ * registered or unregistered, within a write-side critical section
+ * of the seqcount of the header: a collector reads them between
+ * rte_seqcount_read_begin() and rte_seqcount_read_retry(), and it has to
+ * read them again when the seqcount changed.
+ */
+
+#include <stdint.h>
+
+#include <rte_compat.h>
+#include <rte_seqcount.h>
+
+#include "rte_telemetry.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Magic number of the counters region, "DTCN" in little endian. */
+#define RTE_TEL_COUNTERS_MAGIC 0x4e435444
+/** Version of the layout of the counters region. */
+#define RTE_TEL_COUNTERS_VERSION 1
+/** Maximum number of counter blocks in the region. */
+#define RTE_TEL_COUNTERS_MAX_BLOCKS 1024
+/** Size of the counters region. */
+#define RTE_TEL_COUNTERS_REGION_SIZE (16 << 20)
+
+/** The block is registered, its counters are valid. */
+#define RTE_TEL_COUNTERS_F_ACTIVE 0x1
+
+/** Descriptor of a block of counters. */
+struct rte_tel_counters_block {
+	char name[RTE_TEL_MAX_STRING_LEN]; /**< Name of the block. */
+	uint32_t flags; /**< RTE_TEL_COUNTERS_F_* */
+	uint32_t num; /**< Number of counters. */
+	/** Offset of the counter names, num * RTE_TEL_MAX_STRING_LEN bytes. */
+	uint64_t names_ofs;
+	/** Offset of the counter values, num uint64_t, cache aligned. */
+	uint64_t values_ofs;
+};
+
+/** Header of the counters region. */
+struct rte_tel_counters_hdr {
+	uint32_t magic; /**< RTE_TEL_COUNTERS_MAGIC */
+	uint16_t version; /**< RTE_TEL_COUNTERS_VERSION */
+	uint16_t hdr_size; /**< Size of this header. */
+	uint64_t size; /**< Size of the region. */
+	uint32_t pid; /**< Process owning the region. */
+	uint32_t max_blocks; /**< Size of the descriptor table. */
+	uint64_t blocks_ofs; /**< Offset of the descriptor table. */
+	/** Protects the descriptors and the number of blocks. */
+	rte_seqcount_t seqcount;
+	uint32_t num_blocks; /**< Number of descriptors in use. */
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Register a block of counters in the shared memory region.
+ *
+ * The counters are zeroed, their storage is cache aligned and remains
+ * valid until the block is unregistered. It is owned by the caller,
+ * which updates the counters like private ones.
+ *
+ * @param name
+ *   Name of the block, e.g. the object the counters belong to.
+ * @param names
+ *   Names of the counters.
+ * @param num
+ *   Number of counters.
+ * @param values
+ *   Set to the storage of the counters.
+ * @return
+ *   - The id of the block, to unregister it, on success.
+ *   - -EINVAL for invalid parameters.
+ *   - -ENOTSUP if telemetry is not initialized.
+ *   - -ENOSPC if the region is full.
+ *   - Other negative errno if the region could not be created.
+ */
+__rte_experimental
+int
+rte_telemetry_counters_register(const char *name, const char * const *names,
+		uint32_t num, uint64_t **values);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Unregister a block of counters. Its storage is not reused, so that
+ * the counters can still be updated by the datapath while it stops.
+ *
+ * @param id
+ *   Id of the block, returned by rte_telemetry_counters_register().
+ * @return
+ *   0 on success, -EINVAL if the block is not registered.
+ */
+__rte_experimental
+int
+rte_telemetry_counters_unregister(int id);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_TELEMETRY_COUNTERS_H_ */
@@ -4,8 +4,11 @@
 
 #ifndef RTE_EXEC_ENV_WINDOWS
 #include <unistd.h>
+#include <poll.h>
 #include <pthread.h>
+#include <time.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <sys/un.h>
 #include <dlfcn.h>
 #endif /* !RTE_EXEC_ENV_WINDOWS */
@@ -19,13 +22,18 @@
 
 #include "rte_telemetry.h"
 #include "telemetry_json.h"
+#include "telemetry_bin.h"
 #include "telemetry_data.h"
 #include "telemetry_internal.h"
 
 #define MAX_CMD_LEN 56
 #define MAX_HELP_LEN 64
 #define MAX_OUTPUT_LEN (1024 * 16)
+#define MAX_OUTPUT_LEN_LIMIT (1024 * 128)
 #define MAX_CONNECTIONS 10
+#define MAX_PARAM_LEN 256
+#define MAX_SUBSCRIPTIONS 16
+#define MIN_SUBSCRIPTION_INTERVAL 1 /* ms */
 
 #ifndef RTE_EXEC_ENV_WINDOWS
 static void *
@@ -47,6 +55,30 @@ struct socket {
 };
 static struct socket v2_socket; /* socket for v2 telemetry */
 static struct socket v1_socket; /* socket for v1 telemetry */
+
+enum output_format {
+	OUTPUT_JSON,
+	OUTPUT_BINARY,
+};
+
+/* command pushed to the client at a fixed interval */
+struct subscription {
+	telemetry_cb fn;
+	char cmd[MAX_CMD_LEN];
+	char param[MAX_PARAM_LEN];
+	int has_param;
+	uint64_t interval; /* ms */
+	uint64_t next; /* ms, on the monotonic clock */
+};
+
+/* state of a v2 client connection */
+struct client {
+	int s;
+	enum output_format format;
+	size_t max_output_len;
+	unsigned int num_subs;
+	struct subscription subs[MAX_SUBSCRIPTIONS];
+};
 #endif /* !RTE_EXEC_ENV_WINDOWS */
 
 static const char *telemetry_version; /* save rte_version */
@@ -180,31 +212,43 @@ container_to_json(const struct rte_tel_data *d, char *out_buf, size_t buf_len)
 }
 
 static void
-output_json(const char *cmd, const struct rte_tel_data *d, int s)
+output_json(const char *cmd, const struct rte_tel_data *d, int s,
+		size_t max_output_len)
 {
-	char out_buf[MAX_OUTPUT_LEN];
+	char *out_buf, *temp;
 
 	char *cb_data_buf;
 	size_t buf_len, prefix_used, used = 0;
 	unsigned int i;
 
-	RTE_BUILD_BUG_ON(sizeof(out_buf) < MAX_CMD_LEN +
+	RTE_BUILD_BUG_ON(MAX_OUTPUT_LEN < MAX_CMD_LEN +
 			RTE_TEL_MAX_SINGLE_STRING_LEN + 10);
+
+	/* the containers are formatted in temp before being added */
+	out_buf = malloc(max_output_len);
+	temp = malloc(max_output_len);
+	if (out_buf == NULL || temp == NULL) {
+		TMTY_LOG(ERR, "Error allocating output buffers\n");
+		free(out_buf);
+		free(temp);
+		return;
+	}
+
 	switch (d->type) {
 	case RTE_TEL_NULL:
-		used = snprintf(out_buf, sizeof(out_buf), "{\"%.*s\":null}",
+		used = snprintf(out_buf, max_output_len, "{\"%.*s\":null}",
 				MAX_CMD_LEN, cmd ? cmd : "none");
 		break;
 	case RTE_TEL_STRING:
-		used = snprintf(out_buf, sizeof(out_buf), "{\"%.*s\":\"%.*s\"}",
+		used = snprintf(out_buf, max_output_len, "{\"%.*s\":\"%.*s\"}",
 				MAX_CMD_LEN, cmd,
 				RTE_TEL_MAX_SINGLE_STRING_LEN, d->data.str);
 		break;
 	case RTE_TEL_DICT:
-		prefix_used = snprintf(out_buf, sizeof(out_buf), "{\"%.*s\":",
+		prefix_used = snprintf(out_buf, max_output_len, "{\"%.*s\":",
 				MAX_CMD_LEN, cmd);
 		cb_data_buf = &out_buf[prefix_used];
-		buf_len = sizeof(out_buf) - prefix_used - 1; /* space for '}' */
+		buf_len = max_output_len - prefix_used - 1; /* space for '}' */
 
 		used = rte_tel_json_empty_obj(cb_data_buf, buf_len, 0);
 		for (i = 0; i < d->data_len; i++) {
@@ -227,7 +271,6 @@ output_json(const char *cmd, const struct rte_tel_data *d, int s)
 				break;
 			case RTE_TEL_CONTAINER:
 			{
-				char temp[buf_len];
 				const struct container *cont =
 						&v->value.container;
 				if (container_to_json(cont->data,
@@ -242,16 +285,16 @@ output_json(const char *cmd, const struct rte_tel_data *d, int s)
 			}
 		}
 		used += prefix_used;
-		used += strlcat(out_buf + used, "}", sizeof(out_buf) - used);
+		used += strlcat(out_buf + used, "}", max_output_len - used);
 		break;
 	case RTE_TEL_ARRAY_STRING:
 	case RTE_TEL_ARRAY_INT:
 	case RTE_TEL_ARRAY_U64:
 	case RTE_TEL_ARRAY_CONTAINER:
-		prefix_used = snprintf(out_buf, sizeof(out_buf), "{\"%.*s\":",
+		prefix_used = snprintf(out_buf, max_output_len, "{\"%.*s\":",
 				MAX_CMD_LEN, cmd);
 		cb_data_buf = &out_buf[prefix_used];
-		buf_len = sizeof(out_buf) - prefix_used - 1; /* space for '}' */
+		buf_len = max_output_len - prefix_used - 1; /* space for '}' */
 
 		used = rte_tel_json_empty_array(cb_data_buf, buf_len, 0);
 		for (i = 0; i < d->data_len; i++)
@@ -269,7 +312,6 @@ output_json(const char *cmd, const struct rte_tel_data *d, int s)
 						buf_len, used,
 						d->data.array[i].u64val);
 			else if (d->type == RTE_TEL_ARRAY_CONTAINER) {
-				char temp[buf_len];
 				const struct container *rec_data =
 						&d->data.array[i].container;
 				if (container_to_json(rec_data->data,
@@ -281,28 +323,177 @@ output_json(const char *cmd, const struct rte_tel_data *d, int s)
 					rte_tel_data_free(rec_data->data);
 			}
 		used += prefix_used;
-		used += strlcat(out_buf + used, "}", sizeof(out_buf) - used);
+		used += strlcat(out_buf + used, "}", max_output_len - used);
 		break;
 	}
 	if (write(s, out_buf, used) < 0)
 		perror("Error writing to socket");
+
+	free(temp);
+	free(out_buf);
 }
 
+/* Encodes an array, the elements of containers are not containers. */
 static void
-perform_command(telemetry_cb fn, const char *cmd, const char *param, int s)
+array_to_bin(struct tel_bin_buf *b, const struct rte_tel_data *d)
 {
-	struct rte_tel_data data;
+	unsigned int i;
 
-	int ret = fn(cmd, param, &data);
-	if (ret < 0) {
-		char out_buf[MAX_CMD_LEN + 10];
-		int used = snprintf(out_buf, sizeof(out_buf), "{\"%.*s\":null}",
-				MAX_CMD_LEN, cmd ? cmd : "none");
-		if (write(s, out_buf, used) < 0)
-			perror("Error writing to socket");
+	switch (d->type) {
+	case RTE_TEL_ARRAY_STRING:
+		rte_tel_bin_type(b, TEL_BIN_ARRAY);
+		rte_tel_bin_type(b, TEL_BIN_STRING);
+		rte_tel_bin_count(b, d->data_len);
+		for (i = 0; i < d->data_len; i++)
+			rte_tel_bin_str(b, d->data.array[i].sval,
+					RTE_TEL_MAX_STRING_LEN);
+		break;
+	case RTE_TEL_ARRAY_INT:
+		rte_tel_bin_type(b, TEL_BIN_ARRAY);
+		rte_tel_bin_type(b, TEL_BIN_INT);
+		rte_tel_bin_count(b, d->data_len);
+		for (i = 0; i < d->data_len; i++)
+			rte_tel_bin_int(b, d->data.array[i].ival);
+		break;
+	case RTE_TEL_ARRAY_U64:
+		rte_tel_bin_type(b, TEL_BIN_ARRAY);
+		rte_tel_bin_type(b, TEL_BIN_U64);
+		rte_tel_bin_count(b, d->data_len);
+		for (i = 0; i < d->data_len; i++)
+			rte_tel_bin_u64(b, d->data.array[i].u64val);
+		break;
+	default:
+		rte_tel_bin_type(b, TEL_BIN_NULL);
+		break;
+	}
+}
+
+static void
+data_to_bin(struct tel_bin_buf *b, const struct rte_tel_data *d)
+{
+	unsigned int i;
+
+	switch (d->type) {
+	case RTE_TEL_NULL:
+		rte_tel_bin_type(b, TEL_BIN_NULL);
+		break;
+	case RTE_TEL_STRING:
+		rte_tel_bin_type(b, TEL_BIN_STRING);
+		rte_tel_bin_str(b, d->data.str, RTE_TEL_MAX_SINGLE_STRING_LEN);
+		break;
+	case RTE_TEL_DICT:
+		rte_tel_bin_type(b, TEL_BIN_DICT);
+		rte_tel_bin_count(b, d->data_len);
+		for (i = 0; i < d->data_len; i++) {
+			const struct tel_dict_entry *v = &d->data.dict[i];
+
+			rte_tel_bin_name(b, v->name, RTE_TEL_MAX_STRING_LEN);
+			switch (v->type) {
+			case RTE_TEL_STRING_VAL:
+				rte_tel_bin_type(b, TEL_BIN_STRING);
+				rte_tel_bin_str(b, v->value.sval,
+						RTE_TEL_MAX_STRING_LEN);
+				break;
+			case RTE_TEL_INT_VAL:
+				rte_tel_bin_type(b, TEL_BIN_INT);
+				rte_tel_bin_int(b, v->value.ival);
+				break;
+			case RTE_TEL_U64_VAL:
+				rte_tel_bin_type(b, TEL_BIN_U64);
+				rte_tel_bin_u64(b, v->value.u64val);
+				break;
+			case RTE_TEL_CONTAINER:
+				array_to_bin(b, v->value.container.data);
+				if (!v->value.container.keep)
+					rte_tel_data_free(
+						v->value.container.data);
+				break;
+			default:
+				rte_tel_bin_type(b, TEL_BIN_NULL);
+				break;
+			}
+		}
+		break;
+	case RTE_TEL_ARRAY_CONTAINER:
+		rte_tel_bin_type(b, TEL_BIN_ARRAY);
+		rte_tel_bin_type(b, TEL_BIN_ARRAY);
+		rte_tel_bin_count(b, d->data_len);
+		for (i = 0; i < d->data_len; i++) {
+			const struct container *rec_data =
+					&d->data.array[i].container;
+
+			array_to_bin(b, rec_data->data);
+			if (!rec_data->keep)
+				rte_tel_data_free(rec_data->data);
+		}
+		break;
+	default:
+		array_to_bin(b, d);
+		break;
+	}
+}
+
+/*
+ * Sends the binary encoding of the response, split in as many messages
+ * as needed to stay within the output length of the client.
+ */
+static void
+output_bin(const char *cmd, const struct rte_tel_data *d, int s,
+		size_t max_output_len)
+{
+	struct tel_bin_buf b = {0};
+	struct tel_bin_hdr hdr;
+	struct iovec iov[2];
+	size_t chunk, ofs;
+
+	rte_tel_bin_str(&b, cmd ? cmd : "none", MAX_CMD_LEN);
+	data_to_bin(&b, d);
+	if (b.error != 0) {
+		TMTY_LOG(ERR, "Error allocating binary output buffer\n");
+		free(b.data);
 		return;
 	}
-	output_json(cmd, &data, s);
+
+	hdr.magic = TEL_BIN_MAGIC;
+	hdr.reserved = 0;
+	iov[0].iov_base = &hdr;
+	iov[0].iov_len = sizeof(hdr);
+
+	for (ofs = 0; ofs != b.len; ofs += chunk) {
+		chunk = RTE_MIN(b.len - ofs, max_output_len - sizeof(hdr));
+		hdr.flags = (ofs + chunk != b.len) ? TEL_BIN_F_MORE : 0;
+		hdr.len = chunk;
+		iov[1].iov_base = b.data + ofs;
+		iov[1].iov_len = chunk;
+		if (writev(s, iov, RTE_DIM(iov)) < 0) {
+			perror("Error writing to socket");
+			break;
+		}
+	}
+
+	free(b.data);
+}
+
+static void
+output_data(const struct client *c, const char *cmd,
+		const struct rte_tel_data *d)
+{
+	if (c->format == OUTPUT_BINARY)
+		output_bin(cmd, d, c->s, c->max_output_len);
+	else
+		output_json(cmd, d, c->s, c->max_output_len);
+}
+
+static void
+perform_command(telemetry_cb fn, const char *cmd, const char *param,
+		const struct client *c)
+{
+	struct rte_tel_data data;
+
+	int ret = fn(cmd, param, &data);
+	if (ret < 0)
+		data.type = RTE_TEL_NULL;
+	output_data(c, cmd, &data);
 }
 
 static int
@@ -312,42 +503,263 @@ unknown_command(const char *cmd __rte_unused, const char *params __rte_unused,
 	return d->type = RTE_TEL_NULL;
 }
 
+/*
+ * The connection commands are handled by the client handler itself,
+ * they are only registered to be listed with their help.
+ */
+static int
+connection_command(const char *cmd __rte_unused,
+		const char *params __rte_unused,
+		struct rte_tel_data *d __rte_unused)
+{
+	return -1;
+}
+
+static telemetry_cb
+find_command(const char *cmd)
+{
+	telemetry_cb fn = unknown_command;
+	int i;
+
+	if (cmd && strlen(cmd) < MAX_CMD_LEN) {
+		rte_spinlock_lock(&callback_sl);
+		for (i = 0; i < num_callbacks; i++)
+			if (strcmp(cmd, callbacks[i].cmd) == 0) {
+				fn = callbacks[i].fn;
+				break;
+			}
+		rte_spinlock_unlock(&callback_sl);
+	}
+	return fn;
+}
+
+static uint64_t
+get_time_ms(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/* Parameters: json|binary[,max_output_len] */
+static int
+set_output(struct client *c, const char *params, struct rte_tel_data *d)
+{
+	enum output_format format;
+	unsigned long len;
+	int sndbuf;
+	char *end;
+
+	if (params == NULL)
+		return -1;
+
+	if (strncmp(params, "json", 4) == 0) {
+		format = OUTPUT_JSON;
+		params += 4;
+	} else if (strncmp(params, "binary", 6) == 0) {
+		format = OUTPUT_BINARY;
+		params += 6;
+	} else
+		return -1;
+
+	len = c->max_output_len;
+	if (*params == ',') {
+		errno = 0;
+		len = strtoul(params + 1, &end, 0);
+		if (errno != 0 || *end != '\0' || len < MAX_OUTPUT_LEN ||
+				len > MAX_OUTPUT_LEN_LIMIT)
+			return -1;
+	} else if (*params != '\0')
+		return -1;
+
+	/* a message must fit in the socket buffer */
+	sndbuf = 2 * len;
+	if (len > c->max_output_len && setsockopt(c->s, SOL_SOCKET,
+			SO_SNDBUF, &sndbuf, sizeof(sndbuf)) < 0)
+		return -1;
+
+	c->format = format;
+	c->max_output_len = len;
+
+	rte_tel_data_start_dict(d);
+	rte_tel_data_add_dict_string(d, "format",
+			format == OUTPUT_BINARY ? "binary" : "json");
+	rte_tel_data_add_dict_int(d, "max_output_len", len);
+	return 0;
+}
+
+/* Parameters: interval_ms,command[,command parameters] */
+static int
+subscribe(struct client *c, const char *params, struct rte_tel_data *d)
+{
+	struct subscription *sub;
+	unsigned long interval;
+	const char *cmd, *param;
+	size_t cmd_len;
+	char *end;
+
+	if (params == NULL || c->num_subs == MAX_SUBSCRIPTIONS)
+		return -1;
+
+	errno = 0;
+	interval = strtoul(params, &end, 0);
+	if (errno != 0 || *end != ',' || interval < MIN_SUBSCRIPTION_INTERVAL ||
+			interval > INT32_MAX)
+		return -1;
+
+	cmd = end + 1;
+	param = strchr(cmd, ',');
+	cmd_len = (param != NULL) ? (size_t)(param - cmd) : strlen(cmd);
+	if (cmd_len == 0 || cmd_len >= MAX_CMD_LEN ||
+			(param != NULL && strlen(param + 1) >= MAX_PARAM_LEN))
+		return -1;
+
+	sub = &c->subs[c->num_subs];
+	memcpy(sub->cmd, cmd, cmd_len);
+	sub->cmd[cmd_len] = '\0';
+	sub->has_param = (param != NULL);
+	if (param != NULL)
+		strlcpy(sub->param, param + 1, sizeof(sub->param));
+
+	sub->fn = find_command(sub->cmd);
+	if (sub->fn == unknown_command || sub->fn == connection_command)
+		return -1;
+
+	sub->interval = interval;
+	sub->next = get_time_ms() + interval;
+	c->num_subs++;
+
+	rte_tel_data_start_dict(d);
+	rte_tel_data_add_dict_string(d, "cmd", sub->cmd);
+	rte_tel_data_add_dict_u64(d, "interval_ms", interval);
+	rte_tel_data_add_dict_int(d, "subscriptions", c->num_subs);
+	return 0;
+}
+
+/* Parameters: none to remove all subscriptions, or a command */
+static int
+unsubscribe(struct client *c, const char *params, struct rte_tel_data *d)
+{
+	unsigned int i, n;
+
+	n = 0;
+	for (i = 0; i != c->num_subs; i++) {
+		if (params != NULL && strcmp(params, c->subs[i].cmd) != 0)
+			c->subs[n++] = c->subs[i];
+	}
+	c->num_subs = n;
+
+	rte_tel_data_start_dict(d);
+	rte_tel_data_add_dict_int(d, "subscriptions", c->num_subs);
+	return 0;
+}
+
+static void
+handle_connection_command(struct client *c, const char *cmd,
+		const char *param)
+{
+	struct rte_tel_data data;
+	int ret;
+
+	if (strcmp(cmd, "/output") == 0)
+		ret = set_output(c, param, &data);
+	else if (strcmp(cmd, "/subscribe") == 0)
+		ret = subscribe(c, param, &data);
+	else
+		ret = unsubscribe(c, param, &data);
+
+	if (ret < 0)
+		data.type = RTE_TEL_NULL;
+	output_data(c, cmd, &data);
+}
+
+/*
+ * Push the subscribed commands which are due,
+ * return the time to wait for the next one (-1 for none).
+ */
+static int
+run_subscriptions(struct client *c)
+{
+	struct subscription *sub;
+	uint64_t now, next;
+	unsigned int i;
+
+	if (c->num_subs == 0)
+		return -1;
+
+	now = get_time_ms();
+	next = UINT64_MAX;
+	for (i = 0; i != c->num_subs; i++) {
+		sub = &c->subs[i];
+		if (sub->next <= now) {
+			perform_command(sub->fn, sub->cmd,
+					sub->has_param ? sub->param : NULL, c);
+			sub->next += sub->interval;
+			/* don't try to catch up when late */
+			if (sub->next <= now)
+				sub->next = now + sub->interval;
+		}
+		next = RTE_MIN(next, sub->next);
+	}
+
+	return next - now;
+}
+
 static void *
 client_handler(void *sock_id)
 {
+	struct client *c;
+	struct pollfd pfd;
 	int s = (int)(uintptr_t)sock_id;
+	int timeout, rc;
 	char buffer[1024];
 	char info_str[1024];
 	snprintf(info_str, sizeof(info_str),
 			"{\"version\":\"%s\",\"pid\":%d,\"max_output_len\":%d}",
 			telemetry_version, getpid(), MAX_OUTPUT_LEN);
-	if (write(s, info_str, strlen(info_str)) < 0) {
-		close(s);
-		return NULL;
-	}
+	if (write(s, info_str, strlen(info_str)) < 0)
+		goto exit;
+
+	c = calloc(1, sizeof(*c));
+	if (c == NULL)
+		goto exit;
+	c->s = s;
+	c->format = OUTPUT_JSON;
+	c->max_output_len = MAX_OUTPUT_LEN;
+
+	pfd.fd = s;
+	pfd.events = POLLIN;
+	timeout = -1;
+
+	while (1) {
+		rc = poll(&pfd, 1, timeout);
+		if (rc < 0 && errno != EINTR)
+			break;
+
+		if (rc > 0) {
+			/* receive data is not null terminated */
+			int bytes = read(s, buffer, sizeof(buffer) - 1);
+			if (bytes <= 0)
+				break;
 
-	/* receive data is not null terminated */
-	int bytes = read(s, buffer, sizeof(buffer) - 1);
-	while (bytes > 0) {
-		buffer[bytes] = 0;
-		const char *cmd = strtok(buffer, ",");
-		const char *param = strtok(NULL, "\0");
-		telemetry_cb fn = unknown_command;
-		int i;
-
-		if (cmd && strlen(cmd) < MAX_CMD_LEN) {
-			rte_spinlock_lock(&callback_sl);
-			for (i = 0; i < num_callbacks; i++)
-				if (strcmp(cmd, callbacks[i].cmd) == 0) {
-					fn = callbacks[i].fn;
-					break;
-				}
-			rte_spinlock_unlock(&callback_sl);
+			buffer[bytes] = 0;
+			const char *cmd = strtok(buffer, ",");
+			const char *param = strtok(NULL, "\0");
+
+			if (cmd != NULL && (strcmp(cmd, "/output") == 0 ||
+					strcmp(cmd, "/subscribe") == 0 ||
+					strcmp(cmd, "/unsubscribe") == 0))
+				handle_connection_command(c, cmd, param);
+			else
+				perform_command(find_command(cmd), cmd, param,
+						c);
 		}
-		perform_command(fn, cmd, param, s);
 
-		bytes = read(s, buffer, sizeof(buffer) - 1);
+		timeout = run_subscriptions(c);
 	}
+	free(c);
+exit:
 	close(s);
 	__atomic_sub_fetch(&v2_clients, 1, __ATOMIC_RELAXED);
 	return NULL;
@@ -501,6 +913,12 @@ telemetry_v2_init(void)
 			"Returns DPDK Telemetry information. Takes no parameters");
 	rte_telemetry_register_cmd("/help", command_help,
 			"Returns help text for a command. Parameters: string command");
+	rte_telemetry_register_cmd("/output", connection_command,
+			"Sets the output. Parameters: json|binary[,int len]");
+	rte_telemetry_register_cmd("/subscribe", connection_command,
+			"Pushes a command. Parameters: int ms,command[,params]");
+	rte_telemetry_register_cmd("/unsubscribe", connection_command,
+			"Stops pushing commands. Parameters: [command]");
 	v2_socket.fn = client_handler;
 	if (strlcpy(v2_socket.path, get_socket_path(socket_dir, 2),
 			sizeof(v2_socket.path)) >= sizeof(v2_socket.path)) {
@@ -539,6 +957,7 @@ rte_telemetry_init(const char *runtime_dir, const char *rte_version, rte_cpuset_
 	thread_cpuset = cpuset;
 	rte_log_ptr = log_fn;
 	logtype = registered_logtype;
+	telemetry_counters_init(runtime_dir);
 
 #ifndef RTE_EXEC_ENV_WINDOWS
 	if (telemetry_v2_init() != 0)
@@ -0,0 +1,152 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#ifndef _RTE_TELEMETRY_BIN_H_
+#define _RTE_TELEMETRY_BIN_H_
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <rte_common.h>
+
+/**
+ * @file
+ * Internal Telemetry binary encoding functions
+ *
+ * This file contains small inline functions to build up the compact binary
+ * encoding of telemetry responses, which avoids formatting the numbers as
+ * text. Since the socket is local, all values are in host byte order.
+ *
+ * A response is sent as one or more messages, each starting with a
+ * struct tel_bin_hdr. The payloads of the messages, up to the one without
+ * the TEL_BIN_F_MORE flag, are concatenated into:
+ * - the length of the command, on 16 bits, followed by the command,
+ * - the value returned by the command.
+ *
+ * A value is a one byte type, followed by:
+ * - TEL_BIN_NULL: nothing.
+ * - TEL_BIN_STRING: the length on 16 bits, followed by the characters.
+ * - TEL_BIN_INT: a signed 32-bit integer.
+ * - TEL_BIN_U64: an unsigned 64-bit integer.
+ * - TEL_BIN_ARRAY: the type of the elements on one byte and their number on
+ *   32 bits, followed by the elements without their type byte, except for
+ *   arrays of TEL_BIN_ARRAY elements, which are values of their own
+ *   (null for an invalid container).
+ * - TEL_BIN_DICT: the number of entries on 32 bits, each entry being
+ *   the length of its name on one byte, the name and a value.
+ *
+ ***/
+
+#define TEL_BIN_MAGIC 0x4c455444 /* "DTEL" in little endian */
+#define TEL_BIN_F_MORE 0x1 /* more messages follow for this response */
+
+/** Header of each binary message. */
+struct tel_bin_hdr {
+	uint32_t magic; /* TEL_BIN_MAGIC */
+	uint16_t flags; /* TEL_BIN_F_* */
+	uint16_t reserved;
+	uint32_t len; /* payload bytes following the header */
+};
+
+/** Types of the binary encoded values. */
+enum tel_bin_type {
+	TEL_BIN_NULL,
+	TEL_BIN_STRING,
+	TEL_BIN_INT,
+	TEL_BIN_U64,
+	TEL_BIN_ARRAY,
+	TEL_BIN_DICT,
+};
+
+/** Buffer holding a binary encoded response, growing as needed. */
+struct tel_bin_buf {
+	uint8_t *data;
+	size_t len;
+	size_t size;
+	int error; /* set when the buffer could not grow */
+};
+
+/**
+ * @internal
+ * Appends bytes to the buffer, growing it if needed.
+ * Nothing is written once the buffer failed to grow.
+ */
+static inline void
+__bin_put(struct tel_bin_buf *b, const void *p, size_t n)
+{
+	uint8_t *data;
+	size_t size;
+
+	if (b->error != 0)
+		return;
+
+	if (b->len + n > b->size) {
+		size = RTE_MAX(b->size * 2, b->len + n);
+		size = RTE_MAX(size, (size_t)1024);
+		data = realloc(b->data, size);
+		if (data == NULL) {
+			b->error = 1;
+			return;
+		}
+		b->data = data;
+		b->size = size;
+	}
+
+	memcpy(b->data + b->len, p, n);
+	b->len += n;
+}
+
+/* Appends a type byte. */
+static inline void
+rte_tel_bin_type(struct tel_bin_buf *b, enum tel_bin_type type)
+{
+	uint8_t v = type;
+
+	__bin_put(b, &v, sizeof(v));
+}
+
+/* Appends a 32-bit count of array elements or dict entries. */
+static inline void
+rte_tel_bin_count(struct tel_bin_buf *b, uint32_t count)
+{
+	__bin_put(b, &count, sizeof(count));
+}
+
+/* Appends a string, without its type byte. */
+static inline void
+rte_tel_bin_str(struct tel_bin_buf *b, const char *str, size_t max_len)
+{
+	uint16_t len = strnlen(str, RTE_MIN(max_len, (size_t)UINT16_MAX));
+
+	__bin_put(b, &len, sizeof(len));
+	__bin_put(b, str, len);
+}
+
+/* Appends an integer, without its type byte. */
+static inline void
+rte_tel_bin_int(struct tel_bin_buf *b, int val)
+{
+	int32_t v = val;
+
+	__bin_put(b, &v, sizeof(v));
+}
+
+/* Appends a uint64_t, without its type byte. */
+static inline void
+rte_tel_bin_u64(struct tel_bin_buf *b, uint64_t val)
+{
+	__bin_put(b, &val, sizeof(val));
+}
+
+/* Appends the name of a dict entry. */
+static inline void
+rte_tel_bin_name(struct tel_bin_buf *b, const char *name, size_t max_len)
+{
+	uint8_t len = strnlen(name, RTE_MIN(max_len, (size_t)UINT8_MAX));
+
+	__bin_put(b, &len, sizeof(len));
+	__bin_put(b, name, len);
+}
+
+#endif /*_RTE_TELEMETRY_BIN_H_*/
@@ -0,0 +1,229 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2021 Intel Corporation
+ */
+
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifndef RTE_EXEC_ENV_WINDOWS
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif /* !RTE_EXEC_ENV_WINDOWS */
+
+/* we won't link against libbsd, so just always use DPDKs-specific strlcpy */
+#undef RTE_USE_LIBBSD
+#include <rte_string_fns.h>
+#include <rte_common.h>
+#include <rte_spinlock.h>
+
+#include "rte_telemetry_counters.h"
+#include "telemetry_internal.h"
+
+static const char *counters_dir; /* runtime directory */
+static struct rte_tel_counters_hdr *counters_hdr;
+static uint64_t counters_used; /* offset of the free part of the data area */
+/* Used when registering or unregistering blocks */
+static rte_spinlock_t counters_sl = RTE_SPINLOCK_INITIALIZER;
+
+void
+telemetry_counters_init(const char *runtime_dir)
+{
+	counters_dir = runtime_dir;
+}
+
+#ifndef RTE_EXEC_ENV_WINDOWS
+
+static char counters_path[PATH_MAX];
+
+static void
+unlink_counters(void)
+{
+	if (counters_path[0])
+		unlink(counters_path);
+}
+
+static int
+create_region(void)
+{
+	struct rte_tel_counters_hdr *hdr;
+	int fd, rc;
+
+	if ((size_t)snprintf(counters_path, sizeof(counters_path),
+			"%s/dpdk_counters.%d",
+			strlen(counters_dir) ? counters_dir : "/tmp",
+			getpid()) >= sizeof(counters_path)) {
+		counters_path[0] = '\0';
+		return -ENAMETOOLONG;
+	}
+
+	/* collectors only get read access */
+	fd = open(counters_path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0) {
+		rc = -errno;
+		counters_path[0] = '\0';
+		return rc;
+	}
+
+	/* the region is sparse, only the used pages get allocated */
+	if (ftruncate(fd, RTE_TEL_COUNTERS_REGION_SIZE) < 0)
+		hdr = MAP_FAILED;
+	else
+		hdr = mmap(NULL, RTE_TEL_COUNTERS_REGION_SIZE,
+			PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (hdr == MAP_FAILED) {
+		rc = -errno;
+		close(fd);
+		unlink_counters();
+		counters_path[0] = '\0';
+		return rc;
+	}
+	close(fd);
+
+	hdr->version = RTE_TEL_COUNTERS_VERSION;
+	hdr->hdr_size = sizeof(*hdr);
+	hdr->size = RTE_TEL_COUNTERS_REGION_SIZE;
+	hdr->pid = getpid();
+	hdr->max_blocks = RTE_TEL_COUNTERS_MAX_BLOCKS;
+	hdr->blocks_ofs = RTE_ALIGN_CEIL(sizeof(*hdr), RTE_CACHE_LINE_SIZE);
+	hdr->num_blocks = 0;
+	rte_seqcount_init(&hdr->seqcount);
+
+	/* the magic is set last, once the header is valid */
+	__atomic_store_n(&hdr->magic, RTE_TEL_COUNTERS_MAGIC,
+			__ATOMIC_RELEASE);
+
+	counters_used = RTE_ALIGN_CEIL(hdr->blocks_ofs + hdr->max_blocks *
+			sizeof(struct rte_tel_counters_block),
+			RTE_CACHE_LINE_SIZE);
+	counters_hdr = hdr;
+	atexit(unlink_counters);
+
+	return 0;
+}
+
+static struct rte_tel_counters_block *
+get_block(const struct rte_tel_counters_hdr *hdr, uint32_t idx)
+{
+	return (struct rte_tel_counters_block *)((uintptr_t)hdr +
+			hdr->blocks_ofs) + idx;
+}
+
+int
+rte_telemetry_counters_register(const char *name, const char * const *names,
+		uint32_t num, uint64_t **values)
+{
+	struct rte_tel_counters_block *blk;
+	struct rte_tel_counters_hdr *hdr;
+	uint64_t names_ofs, values_ofs, end;
+	uint32_t i;
+	char *p;
+	int id;
+
+	if (name == NULL || strlen(name) >= RTE_TEL_MAX_STRING_LEN ||
+			names == NULL || num == 0 || values == NULL)
+		return -EINVAL;
+	for (i = 0; i != num; i++)
+		if (names[i] == NULL ||
+				strlen(names[i]) >= RTE_TEL_MAX_STRING_LEN)
+			return -EINVAL;
+
+	if (counters_dir == NULL)
+		return -ENOTSUP;
+
+	rte_spinlock_lock(&counters_sl);
+
+	if (counters_hdr == NULL) {
+		id = create_region();
+		if (id < 0) {
+			rte_spinlock_unlock(&counters_sl);
+			return id;
+		}
+	}
+	hdr = counters_hdr;
+
+	/* the values of each block get their own cache lines */
+	names_ofs = counters_used;
+	values_ofs = RTE_ALIGN_CEIL(names_ofs +
+			(uint64_t)num * RTE_TEL_MAX_STRING_LEN,
+			RTE_CACHE_LINE_SIZE);
+	end = RTE_ALIGN_CEIL(values_ofs + (uint64_t)num * sizeof(uint64_t),
+			RTE_CACHE_LINE_SIZE);
+	if (hdr->num_blocks == hdr->max_blocks || end > hdr->size) {
+		rte_spinlock_unlock(&counters_sl);
+		return -ENOSPC;
+	}
+
+	/* names are set before the block is published, never modified after */
+	p = (char *)hdr + names_ofs;
+	for (i = 0; i != num; i++)
+		strlcpy(p + (size_t)i * RTE_TEL_MAX_STRING_LEN, names[i],
+				RTE_TEL_MAX_STRING_LEN);
+	memset((char *)hdr + values_ofs, 0, num * sizeof(uint64_t));
+
+	id = hdr->num_blocks;
+	blk = get_block(hdr, id);
+
+	rte_seqcount_write_begin(&hdr->seqcount);
+	strlcpy(blk->name, name, sizeof(blk->name));
+	blk->num = num;
+	blk->names_ofs = names_ofs;
+	blk->values_ofs = values_ofs;
+	blk->flags = RTE_TEL_COUNTERS_F_ACTIVE;
+	hdr->num_blocks = id + 1;
+	rte_seqcount_write_end(&hdr->seqcount);
+
+	counters_used = end;
+	*values = (uint64_t *)((char *)hdr + values_ofs);
+
+	rte_spinlock_unlock(&counters_sl);
+	return id;
+}
+
+int
+rte_telemetry_counters_unregister(int id)
+{
+	struct rte_tel_counters_block *blk;
+	struct rte_tel_counters_hdr *hdr;
+
+	rte_spinlock_lock(&counters_sl);
+
+	hdr = counters_hdr;
+	if (hdr == NULL || id < 0 || (uint32_t)id >= hdr->num_blocks ||
+			(get_block(hdr, id)->flags &
+			RTE_TEL_COUNTERS_F_ACTIVE) == 0) {
+		rte_spinlock_unlock(&counters_sl);
+		return -EINVAL;
+	}
+
+	blk = get_block(hdr, id);
+	rte_seqcount_write_begin(&hdr->seqcount);
+	blk->flags &= ~RTE_TEL_COUNTERS_F_ACTIVE;
+	rte_seqcount_write_end(&hdr->seqcount);
+
+	rte_spinlock_unlock(&counters_sl);
+	return 0;
+}
+
+#else /* RTE_EXEC_ENV_WINDOWS */
+
+int
+rte_telemetry_counters_register(const char *name __rte_unused,
+		const char * const *names __rte_unused,
+		uint32_t num __rte_unused, uint64_t **values __rte_unused)
+{
+	RTE_SET_USED(counters_hdr);
+	RTE_SET_USED(counters_used);
+	RTE_SET_USED(counters_sl);
+	return -ENOTSUP;
+}
+
+int
+rte_telemetry_counters_unregister(int id __rte_unused)
+{
+	return -ENOTSUP;
+}
+
+#endif /* RTE_EXEC_ENV_WINDOWS */
@@ -112,4 +112,14 @@ int
 rte_telemetry_init(const char *runtime_dir, const char *rte_version, rte_cpuset_t *cpuset,
 		rte_log_fn log_fn, uint32_t registered_logtype);
 
+/**
+ * @internal
+ * Set the directory of the shared memory counters region.
+ *
+ * @param runtime_dir
+ * The runtime directory of DPDK.
+ */
+void
+telemetry_counters_init(const char *runtime_dir);
+
 #endif
@@ -25,6 +25,7 @@
 #include <rte_memzone.h>
 #include <rte_malloc.h>
 #include <rte_errno.h>
+#include <rte_time.h>
 
 #include "rte_timer.h"
 
@@ -53,9 +54,14 @@ struct priv_timer {
 #endif
 } __rte_cache_aligned;
 
+struct timer_wheel;
+
 #define FL_ALLOCATED	(1 << 0)
 struct rte_timer_data {
 	struct priv_timer priv_timer[RTE_MAX_LCORE];
+	/** per-lcore timer wheels, NULL for the skiplist backend */
+	struct timer_wheel *wheel;
+	unsigned int wheel_shift;       /**< log2 of the wheel tick in cycles */
 	uint8_t internal_flags;
 };
 
@@ -91,18 +97,39 @@ timer_data_valid(uint32_t id)
 	timer_data = &rte_timer_data_arr[id];				\
 } while (0)
 
+static int timer_wheel_init(struct rte_timer_data *data, uint64_t tick_ns);
+
 int
 rte_timer_data_alloc(uint32_t *id_ptr)
 {
-	int i;
+	return rte_timer_data_alloc_conf(id_ptr, NULL);
+}
+
+int
+rte_timer_data_alloc_conf(uint32_t *id_ptr,
+			  const struct rte_timer_data_conf *conf)
+{
+	int i, ret;
 	struct rte_timer_data *data;
 
 	if (!rte_timer_subsystem_initialized)
 		return -ENOMEM;
 
+	if (conf != NULL && conf->backend != RTE_TIMER_BACKEND_SKIPLIST &&
+	    conf->backend != RTE_TIMER_BACKEND_WHEEL)
+		return -EINVAL;
+
 	for (i = 0; i < RTE_MAX_DATA_ELS; i++) {
 		data = &rte_timer_data_arr[i];
 		if (!(data->internal_flags & FL_ALLOCATED)) {
+			if (conf != NULL &&
+			    conf->backend == RTE_TIMER_BACKEND_WHEEL) {
+				ret = timer_wheel_init(data,
+						       conf->wheel_tick_ns);
+				if (ret < 0)
+					return ret;
+			}
+
 			data->internal_flags |= FL_ALLOCATED;
 
 			if (id_ptr)
@@ -123,6 +150,9 @@ rte_timer_data_dealloc(uint32_t id)
 
 	timer_data->internal_flags &= ~(FL_ALLOCATED);
 
+	rte_free(timer_data->wheel);
+	timer_data->wheel = NULL;
+
 	return 0;
 }
 
@@ -470,6 +500,737 @@ timer_del(struct rte_timer *tim, union rte_timer_status prev_status,
 		rte_spinlock_unlock(&priv_timer[prev_owner].list_lock);
 }
 
+/* round robin for tim_lcore */
+static unsigned int
+timer_get_lcore(unsigned int tim_lcore, struct priv_timer *priv_timer)
+{
+	unsigned int lcore_id = rte_lcore_id();
+
+	if (tim_lcore != (unsigned int)LCORE_ID_ANY)
+		return tim_lcore;
+
+	if (lcore_id < RTE_MAX_LCORE) {
+		/* EAL thread with valid lcore_id */
+		tim_lcore = rte_get_next_lcore(
+			priv_timer[lcore_id].prev_lcore,
+			0, 1);
+		priv_timer[lcore_id].prev_lcore = tim_lcore;
+	} else
+		/* non-EAL thread do not run rte_timer_manage(),
+		 * so schedule the timer on the first enabled lcore. */
+		tim_lcore = rte_get_next_lcore(LCORE_ID_ANY, 0, 1);
+
+	return tim_lcore;
+}
+
+/*
+ * Hierarchical timer wheel backend.
+ *
+ * Every lcore owns a wheel of WHEEL_LEVELS levels of WHEEL_SLOTS slots, a
+ * slot of level n spanning WHEEL_SLOTS^n ticks: resetting and stopping a
+ * timer is O(1) and expired timers are collected a whole slot at a time.
+ * The timers of a higher level slot are cascaded down when it is reached.
+ *
+ * A wheel is only ever accessed by its own lcore. Timers are handed over to
+ * it by the other lcores through a lock-free multi-producer single-consumer
+ * queue, the inbox, which the lcore drains from rte_timer_alt_manage(). The
+ * lcore holding a timer, i.e. having it in its wheel or inbox, is recorded
+ * in the timer itself. The skiplist links of the timers are not used by
+ * this backend, they hold this bookkeeping instead.
+ */
+#define WHEEL_BITS		6
+#define WHEEL_SLOTS		(1u << WHEEL_BITS)
+#define WHEEL_MASK		(WHEEL_SLOTS - 1)
+#define WHEEL_LEVELS		6
+#define WHEEL_DEFAULT_TICK_NS	1000
+
+struct timer_wheel {
+	uint64_t now;                   /**< last tick processed */
+	uint64_t occupied[WHEEL_LEVELS]; /**< bitmaps of non-empty slots */
+	struct rte_timer *slot[WHEEL_LEVELS][WHEEL_SLOTS];
+
+	/** timers handed over by other lcores */
+	struct rte_timer *inbox __rte_cache_aligned;
+} __rte_cache_aligned;
+
+/* Per-timer wheel bookkeeping, in place of the skiplist links */
+struct wheel_node {
+	struct rte_timer *next;         /* in wheel slot or expired list */
+	struct rte_timer *prev;         /* in wheel slot, NULL at the head */
+	uintptr_t pos;                  /* level * WHEEL_SLOTS + slot + 1 */
+	struct rte_timer *inbox_next;   /* in inbox */
+	uintptr_t ref;                  /* holding lcore + 1, REF_QUEUED */
+};
+
+/* the timer is in the inbox of the lcore holding it */
+#define REF_QUEUED		((uintptr_t)1 << 16)
+#define REF_HOLDER(ref)		((ref) & (REF_QUEUED - 1))
+
+static inline struct wheel_node *
+wheel_node(struct rte_timer *tim)
+{
+	RTE_BUILD_BUG_ON(sizeof(struct wheel_node) > sizeof(tim->sl_next));
+	return (struct wheel_node *)tim->sl_next;
+}
+
+static int
+timer_wheel_init(struct rte_timer_data *data, uint64_t tick_ns)
+{
+	unsigned int lcore_id;
+	uint64_t cycles, now;
+
+	if (tick_ns == 0)
+		tick_ns = WHEEL_DEFAULT_TICK_NS;
+	if (tick_ns > NSEC_PER_SEC)
+		return -EINVAL;
+
+	data->wheel = rte_zmalloc("rte_timer_wheel",
+				  RTE_MAX_LCORE * sizeof(*data->wheel),
+				  RTE_CACHE_LINE_SIZE);
+	if (data->wheel == NULL)
+		return -ENOMEM;
+
+	cycles = rte_get_timer_hz() * tick_ns / NSEC_PER_SEC;
+	data->wheel_shift = cycles > 1 ? rte_fls_u64(cycles) - 1 : 0;
+
+	now = rte_get_timer_cycles() >> data->wheel_shift;
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++)
+		data->wheel[lcore_id].now = now;
+
+	return 0;
+}
+
+/* tick at which the timer is due, rounded up: it never expires early */
+static inline uint64_t
+wheel_when(const struct rte_timer *tim, unsigned int shift)
+{
+	/* may be reset concurrently, wheel_drain() catches up with that */
+	uint64_t expire = __atomic_load_n(&tim->expire, __ATOMIC_RELAXED);
+
+	return (expire >> shift) +
+		((expire & ((UINT64_C(1) << shift) - 1)) != 0);
+}
+
+/* add in wheel, timer must not be in it */
+static void
+wheel_link(struct timer_wheel *w, struct rte_timer *tim, unsigned int shift)
+{
+	struct wheel_node *node = wheel_node(tim);
+	uint64_t base = w->now, when = wheel_when(tim, shift);
+	unsigned int lvl, sh, idx;
+
+	if (when <= base)
+		when = base + 1;
+
+	/* lowest level where the slot is less than a turn away */
+	for (lvl = 0; lvl < WHEEL_LEVELS - 1; lvl++) {
+		sh = lvl * WHEEL_BITS;
+		if ((when >> sh) - (base >> sh) < WHEEL_SLOTS)
+			break;
+	}
+	sh = lvl * WHEEL_BITS;
+	/* beyond the span of the wheel, park it in the farthest slot */
+	if ((when >> sh) - (base >> sh) >= WHEEL_SLOTS)
+		when = ((base >> sh) + WHEEL_MASK) << sh;
+	idx = (when >> sh) & WHEEL_MASK;
+
+	node->prev = NULL;
+	node->next = w->slot[lvl][idx];
+	if (node->next != NULL)
+		wheel_node(node->next)->prev = tim;
+	w->slot[lvl][idx] = tim;
+	w->occupied[lvl] |= UINT64_C(1) << idx;
+	node->pos = lvl * WHEEL_SLOTS + idx + 1;
+}
+
+/* remove from wheel, if in it */
+static void
+wheel_unlink(struct timer_wheel *w, struct rte_timer *tim)
+{
+	struct wheel_node *node = wheel_node(tim);
+	unsigned int lvl, idx;
+
+	if (node->pos == 0)
+		return;
+	lvl = (node->pos - 1) / WHEEL_SLOTS;
+	idx = (node->pos - 1) & WHEEL_MASK;
+
+	if (node->prev != NULL)
+		wheel_node(node->prev)->next = node->next;
+	else if ((w->slot[lvl][idx] = node->next) == NULL)
+		w->occupied[lvl] &= ~(UINT64_C(1) << idx);
+	if (node->next != NULL)
+		wheel_node(node->next)->prev = node->prev;
+	node->pos = 0;
+}
+
+/* next tick at which a slot has to be expired or cascaded */
+static uint64_t
+wheel_next_tick(const struct timer_wheel *w)
+{
+	uint64_t next = UINT64_MAX, bits, tick;
+	unsigned int lvl, sh, first;
+
+	for (lvl = 0; lvl < WHEEL_LEVELS; lvl++) {
+		bits = w->occupied[lvl];
+		if (bits == 0)
+			continue;
+
+		/* rotate the bitmap to start right after the current slot,
+		 * which is always empty
+		 */
+		sh = lvl * WHEEL_BITS;
+		first = ((w->now >> sh) + 1) & WHEEL_MASK;
+		if (first != 0)
+			bits = (bits >> first) | (bits << (WHEEL_SLOTS - first));
+
+		tick = ((w->now >> sh) + 1 + rte_bsf64(bits)) << sh;
+		if (tick < next)
+			next = tick;
+	}
+
+	return next;
+}
+
+/* advance wheel up to current tick, return the list of expired timers */
+static struct rte_timer *
+wheel_advance(struct timer_wheel *w, uint64_t cur, unsigned int shift)
+{
+	struct rte_timer *run_first_tim = NULL, **tail = &run_first_tim;
+	struct rte_timer *tim, *next_tim;
+	unsigned int lvl, sh, idx;
+	uint64_t tick;
+
+	while (w->now < cur) {
+		tick = wheel_next_tick(w);
+		if (tick > cur) {
+			w->now = cur;
+			break;
+		}
+
+		/* cascade the slots starting at this tick, from the top
+		 * level so that timers can fall through several levels
+		 */
+		w->now = tick;
+		for (lvl = WHEEL_LEVELS - 1; lvl > 0; lvl--) {
+			sh = lvl * WHEEL_BITS;
+			if ((tick & ((UINT64_C(1) << sh) - 1)) != 0)
+				continue;
+			idx = (tick >> sh) & WHEEL_MASK;
+			tim = w->slot[lvl][idx];
+			if (tim == NULL)
+				continue;
+
+			w->slot[lvl][idx] = NULL;
+			w->occupied[lvl] &= ~(UINT64_C(1) << idx);
+			for (; tim != NULL; tim = next_tim) {
+				next_tim = wheel_node(tim)->next;
+				if (wheel_when(tim, shift) > tick) {
+					wheel_link(w, tim, shift);
+					continue;
+				}
+				wheel_node(tim)->pos = 0;
+				*tail = tim;
+				tail = &wheel_node(tim)->next;
+			}
+			*tail = NULL;
+		}
+
+		/* the whole level 0 slot is expired */
+		idx = tick & WHEEL_MASK;
+		tim = w->slot[0][idx];
+		if (tim == NULL)
+			continue;
+
+		w->slot[0][idx] = NULL;
+		w->occupied[0] &= ~(UINT64_C(1) << idx);
+		*tail = tim;
+		for (; tim != NULL; tim = wheel_node(tim)->next) {
+			wheel_node(tim)->pos = 0;
+			tail = &wheel_node(tim)->next;
+		}
+	}
+
+	return run_first_tim;
+}
+
+static void
+wheel_push(struct timer_wheel *w, struct rte_timer *tim)
+{
+	struct wheel_node *node = wheel_node(tim);
+	struct rte_timer *head;
+
+	head = __atomic_load_n(&w->inbox, __ATOMIC_RELAXED);
+	do {
+		node->inbox_next = head;
+	} while (!__atomic_compare_exchange_n(&w->inbox, &head, tim, 1,
+					      __ATOMIC_RELEASE,
+					      __ATOMIC_RELAXED));
+}
+
+/*
+ * Queue a timer to the lcore holding it, so that it catches up with the
+ * status of the timer, which must have been updated before.
+ */
+static void
+wheel_request(struct rte_timer_data *data, struct rte_timer *tim)
+{
+	struct wheel_node *node = wheel_node(tim);
+	union rte_timer_status status, stopped;
+	uintptr_t ref, holder;
+
+	/* the status update and this access to the reference are ordered
+	 * against the reverse accesses of wheel_drain()
+	 */
+	ref = __atomic_load_n(&node->ref, __ATOMIC_SEQ_CST);
+	do {
+		/* the new status is seen when the timer is dequeued */
+		if (ref & REF_QUEUED)
+			return;
+
+		holder = REF_HOLDER(ref);
+		if (holder == 0) {
+			/* released meanwhile: only a pending timer needs
+			 * to go somewhere
+			 */
+			status.u32 = __atomic_load_n(&tim->status.u32,
+						     __ATOMIC_SEQ_CST);
+			if (status.state == RTE_TIMER_STOP &&
+			    status.owner != RTE_TIMER_NO_OWNER) {
+				stopped.state = RTE_TIMER_STOP;
+				stopped.owner = RTE_TIMER_NO_OWNER;
+				__atomic_compare_exchange_n(&tim->status.u32,
+					&status.u32, stopped.u32, 0,
+					__ATOMIC_RELEASE, __ATOMIC_RELAXED);
+			}
+			if (status.state != RTE_TIMER_PENDING)
+				return;
+			holder = status.owner + 1;
+		}
+	} while (!__atomic_compare_exchange_n(&node->ref, &ref,
+					      holder | REF_QUEUED, 0,
+					      __ATOMIC_SEQ_CST,
+					      __ATOMIC_SEQ_CST));
+
+	wheel_push(&data->wheel[holder - 1], tim);
+}
+
+/* hand a timer held by this lcore, not in its wheel, over to another one */
+static void
+wheel_forward(struct rte_timer_data *data, struct rte_timer *tim,
+	      unsigned int lcore_id, unsigned int dst_lcore)
+{
+	uintptr_t ref = lcore_id + 1;
+
+	/* if queued to us again meanwhile, it is forwarded when dequeued */
+	if (__atomic_compare_exchange_n(&wheel_node(tim)->ref, &ref,
+					(dst_lcore + 1) | REF_QUEUED, 0,
+					__ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+		wheel_push(&data->wheel[dst_lcore], tim);
+}
+
+/* stop holding a timer not in our wheel, fails if it was queued again */
+static inline int
+wheel_unhold(struct rte_timer *tim, unsigned int lcore_id)
+{
+	uintptr_t ref = lcore_id + 1;
+
+	return __atomic_compare_exchange_n(&wheel_node(tim)->ref, &ref, 0, 0,
+					   __ATOMIC_RELEASE,
+					   __ATOMIC_RELAXED) ? 0 : -1;
+}
+
+/* mark a timer held by this lcore, in RUNNING or CONFIG state, as stopped */
+static void
+wheel_set_stopped(struct rte_timer *tim, unsigned int lcore_id)
+{
+	union rte_timer_status status;
+
+	/* the timer belongs to the application again once it has no owner */
+	status.state = RTE_TIMER_STOP;
+	status.owner = wheel_unhold(tim, lcore_id) == 0 ?
+		RTE_TIMER_NO_OWNER : (int16_t)lcore_id;
+	__atomic_store_n(&tim->status.u32, status.u32, __ATOMIC_RELEASE);
+}
+
+/* release a stopped timer held by this lcore, not in its wheel */
+static void
+wheel_release(struct rte_timer *tim, unsigned int lcore_id,
+	      union rte_timer_status status)
+{
+	union rte_timer_status stopped;
+
+	if (wheel_unhold(tim, lcore_id) < 0 ||
+	    status.owner == RTE_TIMER_NO_OWNER)
+		return;
+
+	/* unless reconfigured meanwhile */
+	stopped.state = RTE_TIMER_STOP;
+	stopped.owner = RTE_TIMER_NO_OWNER;
+	__atomic_compare_exchange_n(&tim->status.u32, &status.u32,
+				    stopped.u32, 0,
+				    __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+}
+
+/* apply the status changes of the timers handed over to this lcore */
+static void
+wheel_drain(struct rte_timer_data *data, unsigned int lcore_id)
+{
+	struct timer_wheel *w = &data->wheel[lcore_id];
+	union rte_timer_status status;
+	struct rte_timer *tim, *next_tim;
+
+	tim = __atomic_exchange_n(&w->inbox, NULL, __ATOMIC_ACQUIRE);
+	for (; tim != NULL; tim = next_tim) {
+		next_tim = wheel_node(tim)->inbox_next;
+
+		/* dequeue before reading the status, so that any later
+		 * status change queues the timer again
+		 */
+		__atomic_store_n(&wheel_node(tim)->ref, lcore_id + 1,
+				 __ATOMIC_SEQ_CST);
+		status.u32 = __atomic_load_n(&tim->status.u32,
+					     __ATOMIC_SEQ_CST);
+
+		wheel_unlink(w, tim);
+		if (status.state == RTE_TIMER_PENDING) {
+			if (status.owner == (int16_t)lcore_id)
+				wheel_link(w, tim, data->wheel_shift);
+			else
+				wheel_forward(data, tim, lcore_id,
+					      status.owner);
+		} else if (status.state == RTE_TIMER_STOP) {
+			wheel_release(tim, lcore_id, status);
+		}
+		/* else still being configured, it is queued again after */
+	}
+}
+
+/*
+ * if timer is pending on this lcore, mark timer as running
+ */
+static int
+wheel_set_running_state(struct rte_timer *tim, unsigned int lcore_id)
+{
+	union rte_timer_status prev_status, status;
+
+	prev_status.state = RTE_TIMER_PENDING;
+	prev_status.owner = (int16_t)lcore_id;
+	status.state = RTE_TIMER_RUNNING;
+	status.owner = (int16_t)lcore_id;
+
+	return __atomic_compare_exchange_n(&tim->status.u32, &prev_status.u32,
+					   status.u32, 0, __ATOMIC_ACQUIRE,
+					   __ATOMIC_RELAXED) ? 0 : -1;
+}
+
+static int
+timer_wheel_reset(struct rte_timer *tim, uint64_t expire,
+		  uint64_t period, unsigned int tim_lcore,
+		  rte_timer_cb_t fct, void *arg,
+		  struct rte_timer_data *data)
+{
+	union rte_timer_status prev_status, status;
+	struct wheel_node *node = wheel_node(tim);
+	unsigned int lcore_id = rte_lcore_id();
+	struct priv_timer *priv_timer = data->priv_timer;
+	struct timer_wheel *w;
+	uintptr_t holder;
+
+	tim_lcore = timer_get_lcore(tim_lcore, priv_timer);
+
+	/* wait that the timer is in correct status before update,
+	 * and mark it as being configured */
+	if (timer_set_config_state(tim, &prev_status, priv_timer) < 0)
+		return -1;
+
+	__TIMER_STAT_ADD(priv_timer, reset, 1);
+	if (prev_status.state == RTE_TIMER_RUNNING &&
+	    lcore_id < RTE_MAX_LCORE) {
+		priv_timer[lcore_id].updated = 1;
+	}
+	if (prev_status.state == RTE_TIMER_PENDING)
+		__TIMER_STAT_ADD(priv_timer, pending, -1);
+
+	tim->period = period;
+	__atomic_store_n(&tim->expire, expire, __ATOMIC_RELAXED);
+	tim->f = fct;
+	tim->arg = arg;
+	__TIMER_STAT_ADD(priv_timer, pending, 1);
+
+	status.state = RTE_TIMER_PENDING;
+	status.owner = (int16_t)tim_lcore;
+
+	/* a timer nobody holds goes straight to the new owner */
+	holder = 0;
+	if (__atomic_compare_exchange_n(&node->ref, &holder, tim_lcore + 1, 0,
+					__ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST))
+		holder = tim_lcore + 1;
+	holder = REF_HOLDER(holder);
+
+	if (lcore_id < RTE_MAX_LCORE && holder == lcore_id + 1) {
+		/* held by us: no other lcore touches our wheel */
+		w = &data->wheel[lcore_id];
+		wheel_unlink(w, tim);
+		if (tim_lcore == lcore_id) {
+			wheel_link(w, tim, data->wheel_shift);
+			/* The "RELEASE" ordering guarantees the memory
+			 * operations above the status update are observed
+			 * before the update by all threads
+			 */
+			__atomic_store_n(&tim->status.u32, status.u32,
+					 __ATOMIC_RELEASE);
+		} else {
+			__atomic_store_n(&tim->status.u32, status.u32,
+					 __ATOMIC_SEQ_CST);
+			wheel_forward(data, tim, lcore_id, tim_lcore);
+		}
+		return 0;
+	}
+
+	/* let the lcore holding the timer move it */
+	__atomic_store_n(&tim->status.u32, status.u32, __ATOMIC_SEQ_CST);
+	wheel_request(data, tim);
+
+	return 0;
+}
+
+static int
+timer_wheel_stop(struct rte_timer *tim, struct rte_timer_data *data)
+{
+	union rte_timer_status prev_status, status;
+	unsigned int lcore_id = rte_lcore_id();
+	struct priv_timer *priv_timer = data->priv_timer;
+	uintptr_t holder;
+
+	/* wait that the timer is in correct status before update,
+	 * and mark it as being configured */
+	if (timer_set_config_state(tim, &prev_status, priv_timer) < 0)
+		return -1;
+
+	__TIMER_STAT_ADD(priv_timer, stop, 1);
+	if (prev_status.state == RTE_TIMER_RUNNING &&
+	    lcore_id < RTE_MAX_LCORE) {
+		priv_timer[lcore_id].updated = 1;
+	}
+	if (prev_status.state == RTE_TIMER_PENDING)
+		__TIMER_STAT_ADD(priv_timer, pending, -1);
+
+	holder = REF_HOLDER(__atomic_load_n(&wheel_node(tim)->ref,
+					    __ATOMIC_SEQ_CST));
+	if (lcore_id < RTE_MAX_LCORE && holder == lcore_id + 1) {
+		wheel_unlink(&data->wheel[lcore_id], tim);
+		wheel_set_stopped(tim, lcore_id);
+		return 0;
+	}
+
+	status.state = RTE_TIMER_STOP;
+	if (holder == 0) {
+		status.owner = RTE_TIMER_NO_OWNER;
+		__atomic_store_n(&tim->status.u32, status.u32,
+				 __ATOMIC_RELEASE);
+		return 0;
+	}
+
+	/* the holding lcore releases the timer at its next manage */
+	status.owner = (int16_t)(holder - 1);
+	__atomic_store_n(&tim->status.u32, status.u32, __ATOMIC_SEQ_CST);
+	wheel_request(data, tim);
+
+	return 0;
+}
+
+static void
+timer_wheel_manage(struct rte_timer_data *data, rte_timer_alt_manage_cb_t f)
+{
+	union rte_timer_status status;
+	struct rte_timer *tim, *next_tim;
+	struct rte_timer *run_first_tim, **pprev;
+	unsigned int lcore_id = rte_lcore_id();
+	struct priv_timer *priv_timer = data->priv_timer;
+	struct timer_wheel *w = &data->wheel[lcore_id];
+	unsigned int shift = data->wheel_shift;
+	uint64_t cur_time;
+
+	__TIMER_STAT_ADD(priv_timer, manage, 1);
+
+	if (__atomic_load_n(&w->inbox, __ATOMIC_RELAXED) != NULL)
+		wheel_drain(data, lcore_id);
+
+	cur_time = rte_get_timer_cycles();
+	/* optimize for the case where no tick elapsed */
+	if ((cur_time >> shift) == w->now)
+		return;
+
+	run_first_tim = wheel_advance(w, cur_time >> shift, shift);
+
+	/* transition run-list from PENDING to RUNNING */
+	pprev = &run_first_tim;
+	for (tim = run_first_tim; tim != NULL; tim = next_tim) {
+		next_tim = wheel_node(tim)->next;
+
+		if (unlikely(wheel_set_running_state(tim, lcore_id) < 0)) {
+			/* another core is re-configuring this one, it is
+			 * handed back through the inbox
+			 */
+			*pprev = next_tim;
+			continue;
+		}
+
+		if (unlikely(tim->expire > cur_time)) {
+			/* reset to a later time by another core, which
+			 * has not been dequeued yet
+			 */
+			status.state = RTE_TIMER_PENDING;
+			status.owner = (int16_t)lcore_id;
+			wheel_link(w, tim, shift);
+			__atomic_store_n(&tim->status.u32, status.u32,
+					 __ATOMIC_RELEASE);
+			*pprev = next_tim;
+			continue;
+		}
+
+		pprev = &wheel_node(tim)->next;
+	}
+
+	/* now scan expired list and call callbacks */
+	for (tim = run_first_tim; tim != NULL; tim = next_tim) {
+		next_tim = wheel_node(tim)->next;
+		priv_timer[lcore_id].updated = 0;
+		priv_timer[lcore_id].running_tim = tim;
+
+		/* Call the provided callback function */
+		f(tim);
+
+		__TIMER_STAT_ADD(priv_timer, pending, -1);
+		/* the timer was stopped or reloaded by the callback
+		 * function, we have nothing to do here */
+		if (priv_timer[lcore_id].updated == 1)
+			continue;
+
+		if (tim->period == 0) {
+			wheel_set_stopped(tim, lcore_id);
+		} else {
+			/* keep it in wheel and mark timer as pending */
+			tim->expire += tim->period;
+			__TIMER_STAT_ADD(priv_timer, pending, 1);
+			wheel_link(w, tim, shift);
+			status.state = RTE_TIMER_PENDING;
+			status.owner = (int16_t)lcore_id;
+			__atomic_store_n(&tim->status.u32, status.u32,
+					 __ATOMIC_RELEASE);
+		}
+	}
+	priv_timer[lcore_id].running_tim = NULL;
+}
+
+/* earliest expiry time of the timers in the wheel of this lcore */
+static uint64_t
+timer_wheel_next_expire(struct rte_timer_data *data, unsigned int lcore_id)
+{
+	struct timer_wheel *w = &data->wheel[lcore_id];
+	uint64_t next = UINT64_MAX, bits;
+	unsigned int lvl, sh, first, idx;
+	struct rte_timer *tim;
+
+	/* take into account the timers handed over by other lcores */
+	if (__atomic_load_n(&w->inbox, __ATOMIC_RELAXED) != NULL)
+		wheel_drain(data, lcore_id);
+
+	/* the first occupied slot of a level holds its earliest timers */
+	for (lvl = 0; lvl < WHEEL_LEVELS; lvl++) {
+		bits = w->occupied[lvl];
+		if (bits == 0)
+			continue;
+
+		sh = lvl * WHEEL_BITS;
+		first = ((w->now >> sh) + 1) & WHEEL_MASK;
+		if (first != 0)
+			bits = (bits >> first) | (bits << (WHEEL_SLOTS - first));
+		idx = (first + rte_bsf64(bits)) & WHEEL_MASK;
+
+		for (tim = w->slot[lvl][idx]; tim != NULL;
+		     tim = wheel_node(tim)->next)
+			if (tim->expire < next)
+				next = tim->expire;
+	}
+
+	return next;
+}
+
+static void
+timer_wheel_dump(struct rte_timer_data *data, FILE *f)
+{
+	unsigned int lcore_id, lvl, n;
+
+	fprintf(f, "Timer wheel: tick = %"PRIu64" cycles\n",
+		UINT64_C(1) << data->wheel_shift);
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		n = 0;
+		for (lvl = 0; lvl < WHEEL_LEVELS; lvl++)
+			n += __builtin_popcountll(
+				data->wheel[lcore_id].occupied[lvl]);
+		if (n != 0)
+			fprintf(f, "  lcore %u: %u occupied slots\n",
+				lcore_id, n);
+	}
+}
+
+/* stop a timer held by lcore_id, on behalf of rte_timer_stop_all() */
+static void
+wheel_stop_held(struct rte_timer_data *data, struct rte_timer *tim,
+		unsigned int lcore_id, rte_timer_stop_all_cb_t f, void *f_arg)
+{
+	union rte_timer_status status, config;
+
+	wheel_unlink(&data->wheel[lcore_id], tim);
+
+	status.u32 = __atomic_load_n(&tim->status.u32, __ATOMIC_ACQUIRE);
+	if (status.state == RTE_TIMER_STOP) {
+		wheel_release(tim, lcore_id, status);
+		return;
+	}
+	if (status.state != RTE_TIMER_PENDING)
+		return;
+
+	config.state = RTE_TIMER_CONFIG;
+	config.owner = (int16_t)rte_lcore_id();
+	if (!__atomic_compare_exchange_n(&tim->status.u32, &status.u32,
+					 config.u32, 0, __ATOMIC_ACQUIRE,
+					 __ATOMIC_RELAXED))
+		return;
+
+	__TIMER_STAT_ADD(data->priv_timer, stop, 1);
+	__TIMER_STAT_ADD(data->priv_timer, pending, -1);
+	wheel_set_stopped(tim, lcore_id);
+
+	if (f)
+		f(tim, f_arg);
+}
+
+static void
+timer_wheel_stop_all(struct rte_timer_data *data, unsigned int walk_lcore,
+		     rte_timer_stop_all_cb_t f, void *f_arg)
+{
+	struct timer_wheel *w = &data->wheel[walk_lcore];
+	struct rte_timer *tim, *next_tim;
+	unsigned int lvl, idx;
+
+	tim = __atomic_exchange_n(&w->inbox, NULL, __ATOMIC_ACQUIRE);
+	for (; tim != NULL; tim = next_tim) {
+		next_tim = wheel_node(tim)->inbox_next;
+		__atomic_store_n(&wheel_node(tim)->ref, walk_lcore + 1,
+				 __ATOMIC_SEQ_CST);
+		wheel_stop_held(data, tim, walk_lcore, f, f_arg);
+	}
+
+	for (lvl = 0; lvl < WHEEL_LEVELS; lvl++)
+		for (idx = 0; idx < WHEEL_SLOTS; idx++)
+			while ((tim = w->slot[lvl][idx]) != NULL)
+				wheel_stop_held(data, tim, walk_lcore,
+						f, f_arg);
+}
+
 /* Reset and start the timer associated with the timer handle (private func) */
 static int
 __rte_timer_reset(struct rte_timer *tim, uint64_t expire,
@@ -483,19 +1244,11 @@ __rte_timer_reset(struct rte_timer *tim, uint64_t expire,
 	unsigned lcore_id = rte_lcore_id();
 	struct priv_timer *priv_timer = timer_data->priv_timer;
 
-	/* round robin for tim_lcore */
-	if (tim_lcore == (unsigned)LCORE_ID_ANY) {
-		if (lcore_id < RTE_MAX_LCORE) {
-			/* EAL thread with valid lcore_id */
-			tim_lcore = rte_get_next_lcore(
-				priv_timer[lcore_id].prev_lcore,
-				0, 1);
-			priv_timer[lcore_id].prev_lcore = tim_lcore;
-		} else
-			/* non-EAL thread do not run rte_timer_manage(),
-			 * so schedule the timer on the first enabled lcore. */
-			tim_lcore = rte_get_next_lcore(LCORE_ID_ANY, 0, 1);
-	}
+	if (timer_data->wheel != NULL)
+		return timer_wheel_reset(tim, expire, period, tim_lcore,
+					 fct, arg, timer_data);
+
+	tim_lcore = timer_get_lcore(tim_lcore, priv_timer);
 
 	/* wait that the timer is in correct status before update,
 	 * and mark it as being configured */
@@ -595,6 +1348,9 @@ __rte_timer_stop(struct rte_timer *tim, int local_is_locked,
 	int ret;
 	struct priv_timer *priv_timer = timer_data->priv_timer;
 
+	if (timer_data->wheel != NULL)
+		return timer_wheel_stop(tim, timer_data);
+
 	/* wait that the timer is in correct status before update,
 	 * and mark it as being configured */
 	ret = timer_set_config_state(tim, &prev_status, priv_timer);
@@ -820,6 +1576,15 @@ rte_timer_alt_manage(uint32_t timer_data_id,
 	/* timer manager only runs on EAL thread with valid lcore_id */
 	assert(this_lcore < RTE_MAX_LCORE);
 
+	if (data->wheel != NULL) {
+		/* a wheel is only ever consumed by its own lcore */
+		for (i = 0; poll_lcores != NULL && i < nb_poll_lcores; i++)
+			if (poll_lcores[i] != this_lcore)
+				return -ENOTSUP;
+		timer_wheel_manage(data, f);
+		return 0;
+	}
+
 	__TIMER_STAT_ADD(data->priv_timer, manage, 1);
 
 	if (poll_lcores == NULL) {
@@ -990,6 +1755,13 @@ rte_timer_stop_all(uint32_t timer_data_id, unsigned int *walk_lcores,
 
 	TIMER_DATA_VALID_GET_OR_ERR_RET(timer_data_id, timer_data, -EINVAL);
 
+	if (timer_data->wheel != NULL) {
+		for (i = 0; i < nb_walk_lcores; i++)
+			timer_wheel_stop_all(timer_data, walk_lcores[i],
+					     f, f_arg);
+		return 0;
+	}
+
 	for (i = 0; i < nb_walk_lcores; i++) {
 		walk_lcore = walk_lcores[i];
 		priv_timer = &timer_data->priv_timer[walk_lcore];
@@ -1016,15 +1788,31 @@ rte_timer_stop_all(uint32_t timer_data_id, unsigned int *walk_lcores,
 
 int64_t
 rte_timer_next_ticks(void)
+{
+	return rte_timer_alt_next_ticks(default_data_id);
+}
+
+int64_t
+rte_timer_alt_next_ticks(uint32_t timer_data_id)
 {
 	unsigned int lcore_id = rte_lcore_id();
 	struct rte_timer_data *timer_data;
 	struct priv_timer *priv_timer;
 	const struct rte_timer *tm;
-	uint64_t cur_time;
+	uint64_t cur_time, expire;
 	int64_t left = -ENOENT;
 
-	TIMER_DATA_VALID_GET_OR_ERR_RET(default_data_id, timer_data, -EINVAL);
+	TIMER_DATA_VALID_GET_OR_ERR_RET(timer_data_id, timer_data, -EINVAL);
+
+	if (timer_data->wheel != NULL) {
+		if (lcore_id >= RTE_MAX_LCORE)
+			return -EINVAL;
+		expire = timer_wheel_next_expire(timer_data, lcore_id);
+		if (expire == UINT64_MAX)
+			return -ENOENT;
+		left = expire - rte_get_timer_cycles();
+		return left < 0 ? 0 : left;
+	}
 
 	priv_timer = timer_data->priv_timer;
 	cur_time = rte_get_timer_cycles();
@@ -1043,7 +1831,7 @@ rte_timer_next_ticks(void)
 
 /* dump statistics about timers */
 static void
-__rte_timer_dump_stats(struct rte_timer_data *timer_data __rte_unused, FILE *f)
+__rte_timer_dump_stats(struct rte_timer_data *timer_data, FILE *f)
 {
 #ifdef RTE_LIBRTE_TIMER_DEBUG
 	struct rte_timer_debug_stats sum;
@@ -1065,6 +1853,8 @@ __rte_timer_dump_stats(struct rte_timer_data *timer_data __rte_unused, FILE *f)
 #else
 	fprintf(f, "No timer statistics, RTE_LIBRTE_TIMER_DEBUG is disabled\n");
 #endif
+	if (timer_data->wheel != NULL)
+		timer_wheel_dump(timer_data, f);
 }
 
 int
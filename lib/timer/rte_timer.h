@@ -158,6 +158,69 @@ int rte_timer_data_alloc(uint32_t *id_ptr);
  */
 int rte_timer_data_dealloc(uint32_t id);
 
+/**
+ * Data structure used to track the pending timers of a timer data instance.
+ */
+enum rte_timer_backend {
+	/** Ordered skiplist per lcore, protected by a spinlock. */
+	RTE_TIMER_BACKEND_SKIPLIST = 0,
+	/**
+	 * Hierarchical timer wheel per lcore: O(1) reset and stop, expired
+	 * timers collected slot by slot. The wheel of an lcore is only
+	 * accessed by that lcore, timers are handed over from other lcores
+	 * through a lock-free queue.
+	 */
+	RTE_TIMER_BACKEND_WHEEL,
+};
+
+/**
+ * Configuration of a timer data instance.
+ */
+struct rte_timer_data_conf {
+	enum rte_timer_backend backend; /**< Pending timers data structure. */
+	/**
+	 * Granularity of the timer wheel in nanoseconds, rounded down to a
+	 * power of two number of timer cycles. Timers never expire early, but
+	 * may expire up to one tick late. 0 selects the default of 1 us.
+	 * Ignored by the skiplist backend.
+	 */
+	uint64_t wheel_tick_ns;
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Allocate a timer data instance with the given configuration.
+ *
+ * With the RTE_TIMER_BACKEND_WHEEL backend, the following restrictions
+ * apply to the timers of the instance:
+ *   - rte_timer_alt_manage() only processes the timers of the calling lcore,
+ *     *poll_lcores* must be NULL or contain only the calling lcore.
+ *   - A timer reset or stopped from an lcore other than the one it is
+ *     pending on is handed over to that lcore, which takes it into account
+ *     at its next call to rte_timer_alt_manage(). A stopped timer may only
+ *     be freed once the owner in its status is RTE_TIMER_NO_OWNER.
+ *   - rte_timer_stop_all() must not run concurrently with
+ *     rte_timer_alt_manage() on the walked lcores.
+ *
+ * @param id_ptr
+ *   Pointer to variable into which to write the identifier of the allocated
+ *   timer data instance.
+ * @param conf
+ *   The configuration of the timer data instance. NULL selects the
+ *   skiplist backend, as rte_timer_data_alloc() does.
+ *
+ * @return
+ *   - 0: Success
+ *   - -EINVAL: invalid configuration
+ *   - -ENOMEM: unable to allocate the timer wheels
+ *   - -ENOSPC: maximum number of timer data instances already allocated
+ */
+__rte_experimental
+int rte_timer_data_alloc_conf(uint32_t *id_ptr,
+			      const struct rte_timer_data_conf *conf);
+
 /**
  * Initialize the timer library.
  *
@@ -348,6 +411,28 @@ int rte_timer_pending(struct rte_timer *tim);
 __rte_experimental
 int64_t rte_timer_next_ticks(void);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Time until the next timer of a timer data instance on the current lcore.
+ *
+ * With the RTE_TIMER_BACKEND_WHEEL backend, the timers handed over to the
+ * current lcore by other lcores are taken into account first, so this
+ * function must not run concurrently with rte_timer_stop_all() walking
+ * the current lcore.
+ *
+ * @param timer_data_id
+ *   An identifier indicating which instance of timer data should be used.
+ * @return
+ *   - -EINVAL: invalid timer data instance identifier
+ *   - -ENOENT: no timer pending
+ *   - 0: a timer is pending and will run at next rte_timer_alt_manage()
+ *   - >0: ticks until the next timer is ready
+ */
+__rte_experimental
+int64_t rte_timer_alt_next_ticks(uint32_t timer_data_id);
+
 /**
  * Manage the timer list and execute callback functions.
  *
@@ -465,6 +550,8 @@ typedef void (*rte_timer_alt_manage_cb_t)(struct rte_timer *tim);
  * @return
  *   - 0: success
  *   - -EINVAL: invalid timer_data_id
+ *   - -ENOTSUP: lcores other than the calling one polled with the timer
+ *     wheel backend
  */
 int
 rte_timer_alt_manage(uint32_t timer_data_id, unsigned int *poll_lcores,
@@ -6,6 +6,7 @@
 #include <numaif.h>
 #endif
 
+#include <rte_malloc.h>
 #include <rte_tailq.h>
 
 #include "iotlb.h"
@@ -22,6 +23,67 @@ struct vhost_iotlb_entry {
 
 #define IOTLB_CACHE_SIZE 2048
 
+/*
+ * The translations are looked up first in a direct mapped cache, indexed by
+ * the 4K page of the IOVA, then by a binary search of the entries sorted by
+ * IOVA. The cache slots are filled by the readers, and cleared by the
+ * writers when an entry is removed.
+ */
+#define IOTLB_HCACHE_SIZE 256
+#define IOTLB_HCACHE_SHIFT 12
+
+static __rte_always_inline struct vhost_iotlb_entry **
+vhost_user_iotlb_hcache_slot(struct vhost_virtqueue *vq, uint64_t iova)
+{
+	return &vq->iotlb_hcache[(iova >> IOTLB_HCACHE_SHIFT) &
+			(IOTLB_HCACHE_SIZE - 1)];
+}
+
+/* Called with iotlb_lock write-locked, when entries are removed */
+static void
+vhost_user_iotlb_hcache_flush(struct vhost_virtqueue *vq)
+{
+	memset(vq->iotlb_hcache, 0,
+			IOTLB_HCACHE_SIZE * sizeof(*vq->iotlb_hcache));
+}
+
+/* Index of the first entry whose IOVA range ends after iova */
+static __rte_always_inline int
+vhost_user_iotlb_cache_search(struct vhost_virtqueue *vq, uint64_t iova)
+{
+	struct vhost_iotlb_entry *node;
+	int lo = 0, hi = vq->iotlb_cache_nr;
+	int mid;
+
+	while (lo < hi) {
+		mid = (lo + hi) / 2;
+		node = vq->iotlb_index[mid];
+		if (node->iova + node->size <= iova)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return lo;
+}
+
+/* Called with iotlb_lock write-locked */
+static void
+vhost_user_iotlb_cache_del(struct vhost_virtqueue *vq, int idx, int nb)
+{
+	int i;
+
+	for (i = idx; i < idx + nb; i++)
+		rte_mempool_put(vq->iotlb_pool, vq->iotlb_index[i]);
+
+	memmove(&vq->iotlb_index[idx], &vq->iotlb_index[idx + nb],
+			(vq->iotlb_cache_nr - idx - nb) *
+			sizeof(*vq->iotlb_index));
+	vq->iotlb_cache_nr -= nb;
+
+	vhost_user_iotlb_hcache_flush(vq);
+}
+
 static void
 vhost_user_iotlb_cache_random_evict(struct vhost_virtqueue *vq);
 
@@ -117,16 +179,9 @@ vhost_user_iotlb_pending_remove(struct vhost_virtqueue *vq,
 static void
 vhost_user_iotlb_cache_remove_all(struct vhost_virtqueue *vq)
 {
-	struct vhost_iotlb_entry *node, *temp_node;
-
 	rte_rwlock_write_lock(&vq->iotlb_lock);
 
-	TAILQ_FOREACH_SAFE(node, &vq->iotlb_list, next, temp_node) {
-		TAILQ_REMOVE(&vq->iotlb_list, node, next);
-		rte_mempool_put(vq->iotlb_pool, node);
-	}
-
-	vq->iotlb_cache_nr = 0;
+	vhost_user_iotlb_cache_del(vq, 0, vq->iotlb_cache_nr);
 
 	rte_rwlock_write_unlock(&vq->iotlb_lock);
 }
@@ -134,22 +189,11 @@ vhost_user_iotlb_cache_remove_all(struct vhost_virtqueue *vq)
 static void
 vhost_user_iotlb_cache_random_evict(struct vhost_virtqueue *vq)
 {
-	struct vhost_iotlb_entry *node, *temp_node;
-	int entry_idx;
-
 	rte_rwlock_write_lock(&vq->iotlb_lock);
 
-	entry_idx = rte_rand() % vq->iotlb_cache_nr;
-
-	TAILQ_FOREACH_SAFE(node, &vq->iotlb_list, next, temp_node) {
-		if (!entry_idx) {
-			TAILQ_REMOVE(&vq->iotlb_list, node, next);
-			rte_mempool_put(vq->iotlb_pool, node);
-			vq->iotlb_cache_nr--;
-			break;
-		}
-		entry_idx--;
-	}
+	if (vq->iotlb_cache_nr != 0)
+		vhost_user_iotlb_cache_del(vq,
+				rte_rand() % vq->iotlb_cache_nr, 1);
 
 	rte_rwlock_write_unlock(&vq->iotlb_lock);
 }
@@ -158,13 +202,13 @@ void
 vhost_user_iotlb_cache_insert(struct vhost_virtqueue *vq, uint64_t iova,
 				uint64_t uaddr, uint64_t size, uint8_t perm)
 {
-	struct vhost_iotlb_entry *node, *new_node;
-	int ret;
+	struct vhost_iotlb_entry *new_node;
+	int ret, idx;
 
 	ret = rte_mempool_get(vq->iotlb_pool, (void **)&new_node);
 	if (ret) {
 		VHOST_LOG_CONFIG(DEBUG, "IOTLB pool empty, clear entries\n");
-		if (!TAILQ_EMPTY(&vq->iotlb_list))
+		if (vq->iotlb_cache_nr != 0)
 			vhost_user_iotlb_cache_random_evict(vq);
 		else
 			vhost_user_iotlb_pending_remove_all(vq);
@@ -182,22 +226,25 @@ vhost_user_iotlb_cache_insert(struct vhost_virtqueue *vq, uint64_t iova,
 
 	rte_rwlock_write_lock(&vq->iotlb_lock);
 
-	TAILQ_FOREACH(node, &vq->iotlb_list, next) {
-		/*
-		 * Entries must be invalidated before being updated.
-		 * So if iova already in list, assume identical.
-		 */
-		if (node->iova == new_node->iova) {
-			rte_mempool_put(vq->iotlb_pool, new_node);
-			goto unlock;
-		} else if (node->iova > new_node->iova) {
-			TAILQ_INSERT_BEFORE(node, new_node, next);
-			vq->iotlb_cache_nr++;
-			goto unlock;
-		}
+	/* Index sorted by iova, the first entry not below the new one */
+	for (idx = vhost_user_iotlb_cache_search(vq, iova);
+			idx < vq->iotlb_cache_nr &&
+			vq->iotlb_index[idx]->iova < iova; idx++)
+		;
+
+	/*
+	 * Entries must be invalidated before being updated.
+	 * So if iova already in list, assume identical.
+	 */
+	if (idx < vq->iotlb_cache_nr && vq->iotlb_index[idx]->iova == iova) {
+		rte_mempool_put(vq->iotlb_pool, new_node);
+		goto unlock;
 	}
 
-	TAILQ_INSERT_TAIL(&vq->iotlb_list, new_node, next);
+	/* The pool size bounds the number of entries */
+	memmove(&vq->iotlb_index[idx + 1], &vq->iotlb_index[idx],
+			(vq->iotlb_cache_nr - idx) * sizeof(*vq->iotlb_index));
+	vq->iotlb_index[idx] = new_node;
 	vq->iotlb_cache_nr++;
 
 unlock:
@@ -211,25 +258,24 @@ void
 vhost_user_iotlb_cache_remove(struct vhost_virtqueue *vq,
 					uint64_t iova, uint64_t size)
 {
-	struct vhost_iotlb_entry *node, *temp_node;
+	int idx, end;
 
 	if (unlikely(!size))
 		return;
 
 	rte_rwlock_write_lock(&vq->iotlb_lock);
 
-	TAILQ_FOREACH_SAFE(node, &vq->iotlb_list, next, temp_node) {
+	/* The entries overlapping the range are contiguous in the index */
+	idx = vhost_user_iotlb_cache_search(vq, iova);
+	for (end = idx; end < vq->iotlb_cache_nr; end++) {
 		/* Sorted list */
-		if (unlikely(iova + size < node->iova))
+		if (unlikely(iova + size < vq->iotlb_index[end]->iova))
 			break;
-
-		if (iova < node->iova + node->size) {
-			TAILQ_REMOVE(&vq->iotlb_list, node, next);
-			rte_mempool_put(vq->iotlb_pool, node);
-			vq->iotlb_cache_nr--;
-		}
 	}
 
+	if (end != idx)
+		vhost_user_iotlb_cache_del(vq, idx, end - idx);
+
 	rte_rwlock_write_unlock(&vq->iotlb_lock);
 }
 
@@ -237,13 +283,26 @@ uint64_t
 vhost_user_iotlb_cache_find(struct vhost_virtqueue *vq, uint64_t iova,
 						uint64_t *size, uint8_t perm)
 {
-	struct vhost_iotlb_entry *node;
+	struct vhost_iotlb_entry *node, **slot;
 	uint64_t offset, vva = 0, mapped = 0;
+	int idx;
 
 	if (unlikely(!*size))
 		goto out;
 
-	TAILQ_FOREACH(node, &vq->iotlb_list, next) {
+	/* Fast path, the entry of the page maps the whole chunk */
+	slot = vhost_user_iotlb_hcache_slot(vq, iova);
+	node = __atomic_load_n(slot, __ATOMIC_RELAXED);
+	if (likely(node != NULL) && iova >= node->iova &&
+	    iova - node->iova < node->size &&
+	    *size <= node->size - (iova - node->iova) &&
+	    likely((perm & node->perm) == perm))
+		return node->uaddr + (iova - node->iova);
+
+	for (idx = vhost_user_iotlb_cache_search(vq, iova);
+			idx < vq->iotlb_cache_nr; idx++) {
+		node = vq->iotlb_index[idx];
+
 		/* List sorted by iova */
 		if (unlikely(iova < node->iova))
 			break;
@@ -257,8 +316,10 @@ vhost_user_iotlb_cache_find(struct vhost_virtqueue *vq, uint64_t iova,
 		}
 
 		offset = iova - node->iova;
-		if (!vva)
+		if (!vva) {
 			vva = node->uaddr + offset;
+			__atomic_store_n(slot, node, __ATOMIC_RELAXED);
+		}
 
 		mapped += node->size - offset;
 		iova = node->iova + node->size;
@@ -305,7 +366,6 @@ vhost_user_iotlb_init(struct virtio_net *dev, int vq_index)
 	rte_rwlock_init(&vq->iotlb_lock);
 	rte_rwlock_init(&vq->iotlb_pending_lock);
 
-	TAILQ_INIT(&vq->iotlb_list);
 	TAILQ_INIT(&vq->iotlb_pending_list);
 
 	snprintf(pool_name, sizeof(pool_name), "iotlb_%u_%d_%d",
@@ -329,6 +389,26 @@ vhost_user_iotlb_init(struct virtio_net *dev, int vq_index)
 		return -1;
 	}
 
+	rte_free(vq->iotlb_index);
+	rte_free(vq->iotlb_hcache);
+	vq->iotlb_index = rte_zmalloc_socket("iotlb_index",
+			IOTLB_CACHE_SIZE * sizeof(*vq->iotlb_index),
+			RTE_CACHE_LINE_SIZE, socket);
+	vq->iotlb_hcache = rte_zmalloc_socket("iotlb_hcache",
+			IOTLB_HCACHE_SIZE * sizeof(*vq->iotlb_hcache),
+			RTE_CACHE_LINE_SIZE, socket);
+	if (!vq->iotlb_index || !vq->iotlb_hcache) {
+		VHOST_LOG_CONFIG(ERR,
+				"Failed to allocate IOTLB cache index\n");
+		rte_free(vq->iotlb_index);
+		rte_free(vq->iotlb_hcache);
+		vq->iotlb_index = NULL;
+		vq->iotlb_hcache = NULL;
+		rte_mempool_free(vq->iotlb_pool);
+		vq->iotlb_pool = NULL;
+		return -1;
+	}
+
 	vq->iotlb_cache_nr = 0;
 
 	return 0;
@@ -902,6 +902,122 @@ rte_vhost_clr_inflight_desc_packed(int vid, uint16_t vring_idx,
  */
 int rte_vhost_vring_call(int vid, uint16_t vring_idx);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change, or be removed, without prior notice.
+ *
+ * Set the coalescing of the guest notifications of a vring.
+ *
+ * By default, the guest is notified, when it asked for it, each time used
+ * descriptors are added to the vring. With coalescing, the notifications
+ * are deferred until either *max_calls* of them are pending or *usecs*
+ * microseconds have elapsed since the last one was sent, which then notifies
+ * the guest of all the used descriptors at once. A pending notification is
+ * sent once due by the next burst on the vring, or by rte_vhost_vring_call().
+ *
+ * With a zero *usecs*, a pending notification is only sent when *max_calls*
+ * are pending, the application must then call rte_vhost_vring_call() on
+ * idle vrings. The setting is kept when the device is reset.
+ *
+ * @param vid
+ *  vhost device ID
+ * @param vring_idx
+ *  vring index
+ * @param max_calls
+ *  maximum number of deferred notifications, 0 for no limit
+ * @param usecs
+ *  maximum delay of a notification in microseconds, 0 for no limit
+ *  Coalescing is disabled when both *max_calls* and *usecs* are 0.
+ * @return
+ *  0 on success, -1 on failure
+ */
+__rte_experimental
+int rte_vhost_vring_call_coalesce_set(int vid, uint16_t vring_idx,
+		uint16_t max_calls, uint32_t usecs);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change, or be removed, without prior notice.
+ *
+ * Set the NUMA node of the metadata of a vring.
+ *
+ * By default, the vring metadata, which is accessed on every descriptor,
+ * is allocated on the NUMA node of the vring memory, while the lcore
+ * polling the vring may run on another one. This function moves the
+ * metadata to the given node right away, and keeps it there when the
+ * vring is set up again. It must be called when the vring is not being
+ * processed, typically from the new_device() callback, before polling.
+ *
+ * The NUMA nodes of the vring memory, metadata and polling lcore are
+ * reported by the /vhost/vring_numa telemetry command.
+ *
+ * @param vid
+ *  vhost device ID
+ * @param vring_idx
+ *  vring index
+ * @param socket_id
+ *  NUMA node of the metadata, SOCKET_ID_ANY for the node of the caller
+ * @return
+ *  0 on success, -1 on failure
+ */
+__rte_experimental
+int rte_vhost_vring_numa_node_set(int vid, uint16_t vring_idx, int socket_id);
+
+struct rte_gro_param;
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change, or be removed, without prior notice.
+ *
+ * Enable the generic receive offload of the packets dequeued from a vring.
+ *
+ * The TCP segments sent by the guest are merged by rte_vhost_dequeue_burst()
+ * with a GRO context kept by the vring, so that the segments of a flow
+ * received in successive bursts can be merged. The merged packets are held
+ * until *timeout_cycles* have elapsed since their first segment was
+ * dequeued, and returned by a later burst.
+ *
+ * The merged packets are flagged like the TSO packets sent by the guest:
+ * with PKT_TX_TCP_SEG and their segment size in tso_segsz, or with
+ * PKT_RX_LRO if RTE_VHOST_USER_NET_COMPLIANT_OL_FLAGS is set.
+ * The packet type and the header lengths of the TCP packets are set.
+ *
+ * If GRO is already enabled on the vring, its context is replaced and the
+ * packets it holds are freed. The context is kept when the vring is reset.
+ *
+ * @param vid
+ *  vhost device ID
+ * @param queue_id
+ *  virtio queue index of a guest Tx queue
+ * @param param
+ *  GRO parameters, only RTE_GRO_TCP_IPV4 and RTE_GRO_TCP_IPV6 are supported
+ * @param timeout_cycles
+ *  maximum time in TSC cycles a packet is held, 0 to merge the packets of
+ *  a burst only
+ * @return
+ *  0 on success, -1 on failure
+ */
+__rte_experimental
+int rte_vhost_gro_enable(int vid, uint16_t queue_id,
+		const struct rte_gro_param *param, uint64_t timeout_cycles);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change, or be removed, without prior notice.
+ *
+ * Disable the generic receive offload of the packets dequeued from a vring.
+ * The packets held by the GRO context of the vring are freed.
+ *
+ * @param vid
+ *  vhost device ID
+ * @param queue_id
+ *  virtio queue index of a guest Tx queue
+ * @return
+ *  0 on success, -1 on failure
+ */
+__rte_experimental
+int rte_vhost_gro_disable(int vid, uint16_t queue_id);
+
 /**
  * Get vhost RX queue avail count.
  *
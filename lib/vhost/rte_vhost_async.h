@@ -90,6 +90,8 @@ struct async_inflight_info {
 	struct rte_mbuf *mbuf;
 	uint16_t descs; /* num of descs inflight */
 	uint16_t nr_buffers; /* num of buffers inflight for packed ring */
+	bool cpu_done; /* dequeued packet entirely copied by the CPU */
+	struct virtio_net_hdr nethdr; /* virtio-net header of dequeued packet */
 };
 
 /**
@@ -193,4 +195,38 @@ __rte_experimental
 uint16_t rte_vhost_poll_enqueue_completed(int vid, uint16_t queue_id,
 		struct rte_mbuf **pkts, uint16_t count);
 
+/**
+ * This function tries to receive packets from the guest with offloading
+ * the copies of the packet data to the async channel. The packets whose
+ * copies are completed are returned in "pkts", in the order the guest
+ * transmitted them. The other packets, whose copies are submitted to the
+ * async channel but not completed yet, are called in-flight packets and
+ * are returned by a later call once their copies are completed.
+ *
+ * The mbufs of the in-flight packets are allocated from "mbuf_pool" and
+ * owned by vhost until they are returned. This function must not be mixed
+ * with rte_vhost_dequeue_burst() on the same queue while packets are in
+ * flight.
+ *
+ * @param vid
+ *  id of vhost device to dequeue data
+ * @param queue_id
+ *  queue id to dequeue data
+ * @param mbuf_pool
+ *  mbuf mempool for allocating the mbufs of the dequeued packets
+ * @param pkts
+ *  blank array to get the pointers of the completed packets
+ * @param count
+ *  size of the packet array
+ * @param nr_inflight
+ *  num of in-flight packets of the queue when this API returns. If an
+ *  error occurred, its value is set to -1.
+ * @return
+ *  num of packets returned
+ */
+__rte_experimental
+uint16_t rte_vhost_async_try_dequeue_burst(int vid, uint16_t queue_id,
+	struct rte_mempool *mbuf_pool, struct rte_mbuf **pkts, uint16_t count,
+	int *nr_inflight);
+
 #endif /* _RTE_VHOST_ASYNC_H_ */
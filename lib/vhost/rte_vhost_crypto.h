@@ -81,6 +81,13 @@ rte_vhost_crypto_free(int vid);
 /**
  *  Enable or disable zero copy feature
  *
+ * Zero copy is enabled by default. The guest buffers are then mapped to
+ * the mbufs given to the cryptodev, with one segment per contiguous part of
+ * the buffers. The requests whose buffers cannot be mapped, or whose mbuf
+ * layout is not supported by the cryptodev (see the RTE_CRYPTODEV_FF_OOP_*
+ * feature flags), are processed with copies.
+ * The option can be changed at any time, it applies to the next requests.
+ *
  * @param vid
  *  The identifier of the vhost device.
  * @param option
@@ -98,6 +105,10 @@ rte_vhost_crypto_set_zero_copy(int vid, enum rte_vhost_crypto_zero_copy option);
  * crypto operations. After this function is executed, the user can enqueue
  * the processed ops to the target cryptodev.
  *
+ * The invalid requests are returned to the guest right away, with their
+ * error status, so this function and rte_vhost_crypto_finalize_requests()
+ * shall not be called concurrently for the same virtio queue.
+ *
  * @param vid
  *  The identifier of the vhost device.
  * @param qid
@@ -118,6 +129,8 @@ rte_vhost_crypto_fetch_requests(int vid, uint32_t qid,
  * Finalize the dequeued crypto ops. After the translated crypto ops are
  * dequeued from the cryptodev, this function shall be called to write the
  * processed data back to the vring descriptor (if no-copy is turned off).
+ * The ops of a virtio queue are returned to the guest with a single update
+ * of the used ring index per burst.
  *
  * @param ops
  *  The address of an array of *rte_crypto_op* structure that was dequeued
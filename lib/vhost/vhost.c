@@ -2,6 +2,7 @@
  * Copyright(c) 2010-2017 Intel Corporation
  */
 
+#include <ctype.h>
 #include <linux/vhost.h>
 #include <linux/virtio_net.h>
 #include <stddef.h>
@@ -14,12 +15,14 @@
 
 #include <rte_errno.h>
 #include <rte_ethdev.h>
+#include <rte_gro.h>
 #include <rte_log.h>
 #include <rte_string_fns.h>
 #include <rte_memory.h>
 #include <rte_malloc.h>
 #include <rte_vhost.h>
 #include <rte_rwlock.h>
+#include <rte_telemetry.h>
 
 #include "iotlb.h"
 #include "vhost.h"
@@ -95,6 +98,27 @@ vhost_log_page(uint8_t *log_base, uint64_t page)
 	vhost_set_bit(page % 8, &log_base[page / 8]);
 }
 
+#define VHOST_LOG_WORD_BITS (sizeof(unsigned long) << 3)
+
+/*
+ * Atomically set the bits of a word of the dirty log.
+ */
+static __rte_always_inline void
+vhost_log_word(uint64_t log_base, uint32_t offset, unsigned long val)
+{
+	unsigned long *word = (unsigned long *)(uintptr_t)log_base + offset;
+
+#if defined(RTE_TOOLCHAIN_GCC) && (GCC_VERSION < 70100)
+	/*
+	 * '__sync' builtins are deprecated, but '__atomic' ones
+	 * are sub-optimized in older GCC versions.
+	 */
+	__sync_fetch_and_or(word, val);
+#else
+	__atomic_fetch_or(word, val, __ATOMIC_RELAXED);
+#endif
+}
+
 void
 __vhost_log_write(struct virtio_net *dev, uint64_t addr, uint64_t len)
 {
@@ -140,6 +164,7 @@ void
 __vhost_log_cache_sync(struct virtio_net *dev, struct vhost_virtqueue *vq)
 {
 	unsigned long *log_base;
+	uint32_t h;
 	int i;
 
 	if (unlikely(!dev->log_base))
@@ -149,23 +174,28 @@ __vhost_log_cache_sync(struct virtio_net *dev, struct vhost_virtqueue *vq)
 	if (unlikely(!vq->log_cache))
 		return;
 
-	rte_atomic_thread_fence(__ATOMIC_RELEASE);
+	/*
+	 * The guest memory updates must be visible before the dirty log
+	 * words are read, so that a word already dirty, hence skipped, is
+	 * not harvested by the front-end before these updates.
+	 */
+	rte_atomic_thread_fence(__ATOMIC_SEQ_CST);
 
 	log_base = (unsigned long *)(uintptr_t)dev->log_base;
 
 	for (i = 0; i < vq->log_cache_nb_elem; i++) {
 		struct log_cache_entry *elem = vq->log_cache + i;
 
-#if defined(RTE_TOOLCHAIN_GCC) && (GCC_VERSION < 70100)
-		/*
-		 * '__sync' builtins are deprecated, but '__atomic' ones
-		 * are sub-optimized in older GCC versions.
-		 */
-		__sync_fetch_and_or(log_base + elem->offset, elem->val);
-#else
-		__atomic_fetch_or(log_base + elem->offset, elem->val,
-				__ATOMIC_RELAXED);
-#endif
+		/* Skip the atomic operation if the pages are already dirty */
+		if ((__atomic_load_n(log_base + elem->offset,
+				__ATOMIC_RELAXED) & elem->val) != elem->val)
+			vhost_log_word(dev->log_base, elem->offset, elem->val);
+
+		/* Clear the hash index slot of the entry */
+		h = elem->offset & (VHOST_LOG_CACHE_HASH_NR - 1);
+		while (vq->log_cache_hash[h] != i + 1)
+			h = (h + 1) & (VHOST_LOG_CACHE_HASH_NR - 1);
+		vq->log_cache_hash[h] = 0;
 	}
 
 	rte_atomic_thread_fence(__ATOMIC_RELEASE);
@@ -173,52 +203,60 @@ __vhost_log_cache_sync(struct virtio_net *dev, struct vhost_virtqueue *vq)
 	vq->log_cache_nb_elem = 0;
 }
 
+/*
+ * Accumulate the dirty pages of a log word in the cache, the entry of the
+ * word is found with a hash index, by open addressing.
+ */
 static __rte_always_inline void
-vhost_log_cache_page(struct virtio_net *dev, struct vhost_virtqueue *vq,
-			uint64_t page)
+vhost_log_cache_word(struct virtio_net *dev, struct vhost_virtqueue *vq,
+			uint32_t offset, unsigned long val)
 {
-	uint32_t bit_nr = page % (sizeof(unsigned long) << 3);
-	uint32_t offset = page / (sizeof(unsigned long) << 3);
-	int i;
+	struct log_cache_entry *elem;
+	uint32_t h;
+	uint16_t idx;
 
 	if (unlikely(!vq->log_cache)) {
 		/* No logging cache allocated, write dirty log map directly */
 		rte_atomic_thread_fence(__ATOMIC_RELEASE);
-		vhost_log_page((uint8_t *)(uintptr_t)dev->log_base, page);
+		vhost_log_word(dev->log_base, offset, val);
 
 		return;
 	}
 
-	for (i = 0; i < vq->log_cache_nb_elem; i++) {
-		struct log_cache_entry *elem = vq->log_cache + i;
-
+	h = offset & (VHOST_LOG_CACHE_HASH_NR - 1);
+	while ((idx = vq->log_cache_hash[h]) != 0) {
+		elem = vq->log_cache + idx - 1;
 		if (elem->offset == offset) {
-			elem->val |= (1UL << bit_nr);
+			elem->val |= val;
 			return;
 		}
+		h = (h + 1) & (VHOST_LOG_CACHE_HASH_NR - 1);
 	}
 
-	if (unlikely(i >= VHOST_LOG_CACHE_NR)) {
+	if (unlikely(vq->log_cache_nb_elem >= VHOST_LOG_CACHE_NR)) {
 		/*
 		 * No more room for a new log cache entry,
 		 * so write the dirty log map directly.
 		 */
 		rte_atomic_thread_fence(__ATOMIC_RELEASE);
-		vhost_log_page((uint8_t *)(uintptr_t)dev->log_base, page);
+		vhost_log_word(dev->log_base, offset, val);
 
 		return;
 	}
 
-	vq->log_cache[i].offset = offset;
-	vq->log_cache[i].val = (1UL << bit_nr);
-	vq->log_cache_nb_elem++;
+	elem = vq->log_cache + vq->log_cache_nb_elem++;
+	elem->offset = offset;
+	elem->val = val;
+	vq->log_cache_hash[h] = vq->log_cache_nb_elem;
 }
 
 void
 __vhost_log_cache_write(struct virtio_net *dev, struct vhost_virtqueue *vq,
 			uint64_t addr, uint64_t len)
 {
-	uint64_t page;
+	uint64_t page, last;
+	uint32_t bit_nr, nb;
+	unsigned long val;
 
 	if (unlikely(!dev->log_base || !len))
 		return;
@@ -226,10 +264,18 @@ __vhost_log_cache_write(struct virtio_net *dev, struct vhost_virtqueue *vq,
 	if (unlikely(dev->log_size <= ((addr + len - 1) / VHOST_LOG_PAGE / 8)))
 		return;
 
+	/* Log the pages of each log word at once */
 	page = addr / VHOST_LOG_PAGE;
-	while (page * VHOST_LOG_PAGE < addr + len) {
-		vhost_log_cache_page(dev, vq, page);
-		page += 1;
+	last = (addr + len - 1) / VHOST_LOG_PAGE;
+	while (page <= last) {
+		bit_nr = page % VHOST_LOG_WORD_BITS;
+		nb = RTE_MIN(last - page + 1, VHOST_LOG_WORD_BITS - bit_nr);
+		if (nb == VHOST_LOG_WORD_BITS)
+			val = ~0UL;
+		else
+			val = ((1UL << nb) - 1) << bit_nr;
+		vhost_log_cache_word(dev, vq, page / VHOST_LOG_WORD_BITS, val);
+		page += nb;
 	}
 }
 
@@ -355,6 +401,26 @@ vhost_free_async_mem(struct vhost_virtqueue *vq)
 	vq->vec_pool = NULL;
 }
 
+/* Destroy a GRO context, dropping the packets it holds */
+static void
+vhost_gro_ctx_destroy(void *ctx)
+{
+	struct rte_mbuf *pkts[MAX_PKT_BURST];
+	uint16_t nb, i;
+
+	if (ctx == NULL)
+		return;
+
+	do {
+		nb = rte_gro_timeout_flush(ctx, 0, RTE_GRO_TCP_IPV4 |
+				RTE_GRO_TCP_IPV6, pkts, MAX_PKT_BURST);
+		for (i = 0; i < nb; i++)
+			rte_pktmbuf_free(pkts[i]);
+	} while (nb != 0);
+
+	rte_gro_ctx_destroy(ctx);
+}
+
 void
 free_vq(struct virtio_net *dev, struct vhost_virtqueue *vq)
 {
@@ -364,8 +430,11 @@ free_vq(struct virtio_net *dev, struct vhost_virtqueue *vq)
 		rte_free(vq->shadow_used_split);
 
 	vhost_free_async_mem(vq);
+	vhost_gro_ctx_destroy(vq->gro_ctx);
 	rte_free(vq->batch_copy_elems);
 	rte_mempool_free(vq->iotlb_pool);
+	rte_free(vq->iotlb_index);
+	rte_free(vq->iotlb_hcache);
 	rte_free(vq->log_cache);
 	rte_free(vq);
 }
@@ -569,6 +638,8 @@ init_vring_queue(struct virtio_net *dev, uint32_t vring_idx)
 	vq->kickfd = VIRTIO_UNINITIALIZED_EVENTFD;
 	vq->callfd = VIRTIO_UNINITIALIZED_EVENTFD;
 	vq->notif_enable = VIRTIO_UNINITIALIZED_NOTIF;
+	vq->numa_node = SOCKET_ID_ANY;
+	vq->poll_lcore = LCORE_ID_ANY;
 
 	vhost_user_iotlb_init(dev, vring_idx);
 }
@@ -577,6 +648,11 @@ static void
 reset_vring_queue(struct virtio_net *dev, uint32_t vring_idx)
 {
 	struct vhost_virtqueue *vq;
+	uint64_t call_coalesce_cycles;
+	uint64_t gro_timeout_cycles;
+	uint16_t call_coalesce_max;
+	void *gro_ctx;
+	int numa_node;
 	int callfd;
 
 	if (vring_idx >= VHOST_MAX_VRING) {
@@ -594,8 +670,99 @@ reset_vring_queue(struct virtio_net *dev, uint32_t vring_idx)
 	}
 
 	callfd = vq->callfd;
+	call_coalesce_cycles = vq->call_coalesce_cycles;
+	call_coalesce_max = vq->call_coalesce_max;
+	numa_node = vq->numa_node;
+	gro_ctx = vq->gro_ctx;
+	gro_timeout_cycles = vq->gro_timeout_cycles;
 	init_vring_queue(dev, vring_idx);
 	vq->callfd = callfd;
+	vq->call_coalesce_cycles = call_coalesce_cycles;
+	vq->call_coalesce_max = call_coalesce_max;
+	vq->numa_node = numa_node;
+	vq->gro_ctx = gro_ctx;
+	vq->gro_timeout_cycles = gro_timeout_cycles;
+}
+
+/*
+ * Return the NUMA node of the memory at addr, -1 if unknown.
+ */
+int
+vhost_numa_node(const void *addr)
+{
+#ifdef RTE_LIBRTE_VHOST_NUMA
+	int node;
+
+	if (addr == NULL || get_mempolicy(&node, NULL, 0, (void *)(uintptr_t)addr,
+			MPOL_F_NODE | MPOL_F_ADDR) != 0)
+		return -1;
+
+	return node;
+#else
+	RTE_SET_USED(addr);
+	return -1;
+#endif
+}
+
+/*
+ * Reallocate a virtqueue, with its shadow used ring and batch copy array,
+ * on a NUMA node. The virtqueue must not be processed meanwhile.
+ * Return the virtqueue, the former one if the reallocation failed.
+ */
+struct vhost_virtqueue *
+vhost_realloc_vring(struct virtio_net *dev, uint32_t vring_idx, int node)
+{
+	struct vhost_virtqueue *old_vq, *vq;
+	struct vring_used_elem *new_shadow_used_split;
+	struct vring_used_elem_packed *new_shadow_used_packed;
+	struct batch_copy_elem *new_batch_copy_elems;
+
+	old_vq = dev->virtqueue[vring_idx];
+
+	VHOST_LOG_CONFIG(INFO, "reallocate vq %u to node %d\n",
+			vring_idx, node);
+	vq = rte_malloc_socket(NULL, sizeof(*vq), 0, node);
+	if (!vq)
+		return old_vq;
+
+	memcpy(vq, old_vq, sizeof(*vq));
+
+	if (vq_is_packed(dev)) {
+		new_shadow_used_packed = rte_malloc_socket(NULL,
+				vq->size *
+				sizeof(struct vring_used_elem_packed),
+				RTE_CACHE_LINE_SIZE,
+				node);
+		if (new_shadow_used_packed) {
+			rte_free(vq->shadow_used_packed);
+			vq->shadow_used_packed = new_shadow_used_packed;
+		}
+	} else {
+		new_shadow_used_split = rte_malloc_socket(NULL,
+				vq->size *
+				sizeof(struct vring_used_elem),
+				RTE_CACHE_LINE_SIZE,
+				node);
+		if (new_shadow_used_split) {
+			rte_free(vq->shadow_used_split);
+			vq->shadow_used_split = new_shadow_used_split;
+		}
+	}
+
+	new_batch_copy_elems = rte_malloc_socket(NULL,
+		vq->size * sizeof(struct batch_copy_elem),
+		RTE_CACHE_LINE_SIZE,
+		node);
+	if (new_batch_copy_elems) {
+		rte_free(vq->batch_copy_elems);
+		vq->batch_copy_elems = new_batch_copy_elems;
+	}
+
+	rte_free(old_vq);
+	dev->virtqueue[vring_idx] = vq;
+	vhost_user_iotlb_init(dev, vring_idx);
+
+	return vq;
 }
 
 int
@@ -1292,6 +1459,148 @@ rte_vhost_vring_call(int vid, uint16_t vring_idx)
 	else
 		vhost_vring_call_split(dev, vq);
 
+	/* Flush the notifications deferred by coalescing */
+	if (vq->nr_calls_deferred)
+		vhost_vring_notify_guest(dev, vq);
+
+	return 0;
+}
+
+int
+rte_vhost_vring_call_coalesce_set(int vid, uint16_t vring_idx,
+		uint16_t max_calls, uint32_t usecs)
+{
+	struct virtio_net *dev;
+	struct vhost_virtqueue *vq;
+
+	dev = get_device(vid);
+	if (!dev)
+		return -1;
+
+	if (vring_idx >= VHOST_MAX_VRING)
+		return -1;
+
+	vq = dev->virtqueue[vring_idx];
+	if (!vq)
+		return -1;
+
+	rte_spinlock_lock(&vq->access_lock);
+
+	/* Do not leave a notification pending when disabling coalescing */
+	if (vq->nr_calls_deferred && vq->callfd >= 0)
+		vhost_vring_notify_guest(dev, vq);
+
+	vq->call_coalesce_max = max_calls;
+	vq->call_coalesce_cycles = rte_get_timer_hz() * usecs / US_PER_S;
+	vq->last_call_tsc = rte_get_timer_cycles();
+	vq->nr_calls_deferred = 0;
+
+	rte_spinlock_unlock(&vq->access_lock);
+
+	return 0;
+}
+
+int
+rte_vhost_vring_numa_node_set(int vid, uint16_t vring_idx, int socket_id)
+{
+	struct virtio_net *dev;
+	struct vhost_virtqueue *vq;
+
+	dev = get_device(vid);
+	if (!dev)
+		return -1;
+
+	if (vring_idx >= VHOST_MAX_VRING)
+		return -1;
+
+	vq = dev->virtqueue[vring_idx];
+	if (!vq)
+		return -1;
+
+	if (socket_id == SOCKET_ID_ANY)
+		socket_id = rte_socket_id();
+	if (socket_id < 0 || socket_id >= RTE_MAX_NUMA_NODES)
+		return -1;
+
+	vq->numa_node = socket_id;
+
+	/* Move the metadata now, the next ring setups will keep it there */
+	if (vhost_numa_node(vq) != socket_id &&
+			vhost_realloc_vring(dev, vring_idx, socket_id) == vq)
+		return -1;
+
+	return 0;
+}
+
+static struct vhost_virtqueue *
+vhost_gro_get_vq(int vid, uint16_t queue_id)
+{
+	struct virtio_net *dev;
+
+	dev = get_device(vid);
+	if (!dev)
+		return NULL;
+
+	/* only the guest Tx queues are dequeued */
+	if (queue_id >= VHOST_MAX_VRING || (queue_id & 1) == 0)
+		return NULL;
+
+	return dev->virtqueue[queue_id];
+}
+
+int
+rte_vhost_gro_enable(int vid, uint16_t queue_id,
+		const struct rte_gro_param *param, uint64_t timeout_cycles)
+{
+	struct vhost_virtqueue *vq;
+	void *ctx, *old_ctx;
+
+	vq = vhost_gro_get_vq(vid, queue_id);
+	if (!vq || !param)
+		return -1;
+
+	/* the merged packets are flagged for TSO, which only suits TCP */
+	if (param->gro_types == 0 || (param->gro_types &
+			~(RTE_GRO_TCP_IPV4 | RTE_GRO_TCP_IPV6)) != 0) {
+		VHOST_LOG_CONFIG(ERR, "unsupported GRO types %#"PRIx64"\n",
+			param->gro_types);
+		return -1;
+	}
+
+	ctx = rte_gro_ctx_create(param);
+	if (ctx == NULL) {
+		VHOST_LOG_CONFIG(ERR, "failed to create GRO context\n");
+		return -1;
+	}
+
+	rte_spinlock_lock(&vq->access_lock);
+	old_ctx = vq->gro_ctx;
+	vq->gro_ctx = ctx;
+	vq->gro_timeout_cycles = timeout_cycles;
+	rte_spinlock_unlock(&vq->access_lock);
+
+	vhost_gro_ctx_destroy(old_ctx);
+
+	return 0;
+}
+
+int
+rte_vhost_gro_disable(int vid, uint16_t queue_id)
+{
+	struct vhost_virtqueue *vq;
+	void *ctx;
+
+	vq = vhost_gro_get_vq(vid, queue_id);
+	if (!vq)
+		return -1;
+
+	rte_spinlock_lock(&vq->access_lock);
+	ctx = vq->gro_ctx;
+	vq->gro_ctx = NULL;
+	rte_spinlock_unlock(&vq->access_lock);
+
+	vhost_gro_ctx_destroy(ctx);
+
 	return 0;
 }
 
@@ -1780,5 +2089,114 @@ int rte_vhost_async_channel_unregister(int vid, uint16_t queue_id)
 	return ret;
 }
 
+static int
+vhost_handle_dev_list(const char *cmd __rte_unused,
+		const char *params __rte_unused,
+		struct rte_tel_data *d)
+{
+	int vid;
+
+	rte_tel_data_start_array(d, RTE_TEL_INT_VAL);
+	for (vid = 0; vid < MAX_VHOST_DEVICE; vid++)
+		if (vhost_devices[vid] != NULL)
+			rte_tel_data_add_array_int(d, vid);
+
+	return 0;
+}
+
+/* Parse the "vid,vring_idx" parameters of the vring telemetry commands */
+static struct vhost_virtqueue *
+vhost_telemetry_get_vring(const char *params)
+{
+	struct virtio_net *dev;
+	unsigned long vid, vring_idx;
+	char *end_param;
+
+	if (params == NULL || strlen(params) == 0 || !isdigit(*params))
+		return NULL;
+
+	vid = strtoul(params, &end_param, 0);
+	if (*end_param != ',' || !isdigit(*(end_param + 1)))
+		return NULL;
+	vring_idx = strtoul(end_param + 1, &end_param, 0);
+	if (*end_param != '\0')
+		VHOST_LOG_CONFIG(NOTICE,
+			"Extra parameters passed to vhost telemetry command, ignoring\n");
+
+	if (vid >= MAX_VHOST_DEVICE || vring_idx >= VHOST_MAX_VRING)
+		return NULL;
+
+	dev = vhost_devices[vid];
+	if (dev == NULL)
+		return NULL;
+
+	return dev->virtqueue[vring_idx];
+}
+
+static int
+vhost_handle_vring_stats(const char *cmd __rte_unused,
+		const char *params,
+		struct rte_tel_data *d)
+{
+	struct vhost_virtqueue *vq;
+
+	vq = vhost_telemetry_get_vring(params);
+	if (vq == NULL)
+		return -EINVAL;
+
+	rte_tel_data_start_dict(d);
+	rte_tel_data_add_dict_int(d, "enabled", vq->enabled);
+	rte_tel_data_add_dict_int(d, "notif_enable", vq->notif_enable);
+	rte_tel_data_add_dict_u64(d, "calls", vq->nr_calls);
+	rte_tel_data_add_dict_u64(d, "calls_coalesced", vq->nr_calls_coalesced);
+	rte_tel_data_add_dict_u64(d, "calls_pending", vq->nr_calls_deferred);
+	rte_tel_data_add_dict_u64(d, "coalesce_max_calls",
+			vq->call_coalesce_max);
+	rte_tel_data_add_dict_u64(d, "coalesce_usecs",
+			vq->call_coalesce_cycles * US_PER_S / rte_get_timer_hz());
+
+	return 0;
+}
+
+static int
+vhost_handle_vring_numa(const char *cmd __rte_unused,
+		const char *params,
+		struct rte_tel_data *d)
+{
+	struct vhost_virtqueue *vq;
+	unsigned int lcore_id;
+	int lcore_node = -1;
+
+	vq = vhost_telemetry_get_vring(params);
+	if (vq == NULL)
+		return -EINVAL;
+
+	lcore_id = vq->poll_lcore;
+	if (lcore_id < RTE_MAX_LCORE)
+		lcore_node = rte_lcore_to_socket_id(lcore_id);
+
+	rte_tel_data_start_dict(d);
+	rte_tel_data_add_dict_int(d, "ring_node", vhost_numa_node(vq->desc));
+	rte_tel_data_add_dict_int(d, "vq_node", vhost_numa_node(vq));
+	rte_tel_data_add_dict_int(d, "preferred_node", vq->numa_node);
+	rte_tel_data_add_dict_int(d, "poll_lcore",
+			lcore_id < RTE_MAX_LCORE ? (int)lcore_id : -1);
+	rte_tel_data_add_dict_int(d, "poll_lcore_node", lcore_node);
+
+	return 0;
+}
+
+RTE_INIT(vhost_init_telemetry)
+{
+	rte_telemetry_register_cmd("/vhost/list", vhost_handle_dev_list,
+			"Returns list of vhost device IDs. Takes no parameters");
+	rte_telemetry_register_cmd("/vhost/vring_stats",
+			vhost_handle_vring_stats,
+			"Returns the guest notification stats of a vring. Parameters: int vid, int vring_idx");
+	rte_telemetry_register_cmd("/vhost/vring_numa",
+			vhost_handle_vring_numa,
+			"Returns the NUMA nodes of a vring memory and polling lcore. Parameters: int vid, int vring_idx");
+}
+
 RTE_LOG_REGISTER_SUFFIX(vhost_config_log_level, config, INFO);
 RTE_LOG_REGISTER_SUFFIX(vhost_data_log_level, data, WARNING);
@@ -17,6 +17,7 @@
 
 #include <rte_log.h>
 #include <rte_ether.h>
+#include <rte_cycles.h>
 #include <rte_rwlock.h>
 #include <rte_malloc.h>
 
@@ -44,7 +45,12 @@
 
 #define BUF_VECTOR_MAX 256
 
-#define VHOST_LOG_CACHE_NR 32
+/*
+ * Dirty log words accumulated per virtqueue between two syncs, and size of
+ * their hash index, twice larger to keep the probes short.
+ */
+#define VHOST_LOG_CACHE_NR 256
+#define VHOST_LOG_CACHE_HASH_NR (VHOST_LOG_CACHE_NR * 2)
 
 #define MAX_PKT_BURST 32
 
@@ -63,6 +69,9 @@
 			    sizeof(struct vring_packed_desc))
 #define PACKED_BATCH_MASK (PACKED_BATCH_SIZE - 1)
 
+#define SPLIT_BATCH_SIZE (RTE_CACHE_LINE_SIZE / \
+			  sizeof(struct vring_desc))
+
 #ifdef VHOST_GCC_UNROLL_PRAGMA
 #define vhost_for_each_try_unroll(iter, val, size) _Pragma("GCC unroll 4") \
 	for (iter = val; iter < size; iter++)
@@ -171,19 +180,36 @@ struct vhost_virtqueue {
 	uint16_t		log_cache_nb_elem;
 	uint64_t		log_guest_addr;
 	struct log_cache_entry	*log_cache;
+	/* Entry index + 1 of the log words, allocated after the log cache */
+	uint16_t		*log_cache_hash;
 
 	rte_rwlock_t	iotlb_lock;
 	rte_rwlock_t	iotlb_pending_lock;
 	struct rte_mempool *iotlb_pool;
-	TAILQ_HEAD(, vhost_iotlb_entry) iotlb_list;
+	/* IOTLB entries sorted by IOVA, and their translation cache */
+	struct vhost_iotlb_entry **iotlb_index;
+	struct vhost_iotlb_entry **iotlb_hcache;
 	TAILQ_HEAD(, vhost_iotlb_entry) iotlb_pending_list;
 	int				iotlb_cache_nr;
 
 	/* Used to notify the guest (trigger interrupt) */
 	int			callfd;
+	/* Guest notifications coalescing, disabled when both limits are 0 */
+	uint64_t		call_coalesce_cycles;
+	uint64_t		last_call_tsc;
+	uint16_t		call_coalesce_max;
+	uint16_t		nr_calls_deferred;
+	/* Guest notifications statistics */
+	uint64_t		nr_calls;
+	uint64_t		nr_calls_coalesced;
 	/* Currently unused as polling mode is enabled */
 	int			kickfd;
 
+	/* Node preferred for the metadata, SOCKET_ID_ANY for the ring one */
+	int			numa_node;
+	/* Last lcore processing the virtqueue, LCORE_ID_ANY if none yet */
+	unsigned int		poll_lcore;
+
 	/* inflight share memory info */
 	union {
 		struct rte_vhost_inflight_info_split *inflight_split;
@@ -221,6 +247,10 @@ struct vhost_virtqueue {
 	bool		async_registered;
 	uint16_t	async_threshold;
 
+	/* GRO of the dequeued packets, NULL if disabled */
+	void			*gro_ctx;
+	uint64_t		gro_timeout_cycles;
+
 	int			notif_enable;
 #define VIRTIO_UNINITIALIZED_NOTIF	(-1)
 
@@ -626,6 +656,16 @@ gpa_to_first_hpa(struct virtio_net *dev, uint64_t gpa,
 	return 0;
 }
 
+/* Record the lcore processing the virtqueue, for the NUMA telemetry */
+static __rte_always_inline void
+vhost_vring_poll_lcore(struct vhost_virtqueue *vq)
+{
+	unsigned int lcore_id = rte_lcore_id();
+
+	if (unlikely(vq->poll_lcore != lcore_id))
+		vq->poll_lcore = lcore_id;
+}
+
 /* Convert guest physical address to host physical address */
 static __rte_always_inline rte_iova_t
 gpa_to_hpa(struct virtio_net *dev, uint64_t gpa, uint64_t size)
@@ -681,6 +721,9 @@ void cleanup_vq_inflight(struct virtio_net *dev, struct vhost_virtqueue *vq);
 void free_vq(struct virtio_net *dev, struct vhost_virtqueue *vq);
 
 int alloc_vring_queue(struct virtio_net *dev, uint32_t vring_idx);
+struct vhost_virtqueue *vhost_realloc_vring(struct virtio_net *dev,
+		uint32_t vring_idx, int node);
+int vhost_numa_node(const void *addr);
 
 void vhost_attach_vdpa_device(int vid, struct rte_vdpa_device *dev);
 
@@ -737,9 +780,80 @@ vhost_need_event(uint16_t event_idx, uint16_t new_idx, uint16_t old)
 	return (uint16_t)(new_idx - event_idx - 1) < (uint16_t)(new_idx - old);
 }
 
+static __rte_always_inline void
+vhost_vring_notify_guest(struct virtio_net *dev, struct vhost_virtqueue *vq)
+{
+	eventfd_write(vq->callfd, (eventfd_t)1);
+	if (dev->notify_ops->guest_notified)
+		dev->notify_ops->guest_notified(dev->vid);
+
+	vq->nr_calls++;
+	vq->nr_calls_deferred = 0;
+	if (vq->call_coalesce_cycles)
+		vq->last_call_tsc = rte_get_timer_cycles();
+}
+
+/*
+ * Check whether the deferred guest notifications are due, i.e. whether
+ * enough of them were deferred or the last one was sent long enough ago.
+ */
+static __rte_always_inline bool
+vhost_vring_call_due(struct vhost_virtqueue *vq)
+{
+	if (vq->call_coalesce_max &&
+			vq->nr_calls_deferred >= vq->call_coalesce_max)
+		return true;
+
+	return vq->call_coalesce_cycles &&
+		rte_get_timer_cycles() - vq->last_call_tsc >=
+			vq->call_coalesce_cycles;
+}
+
+/*
+ * Notify the guest if *kick* is set, or defer the notification when
+ * coalescing is enabled on the vring. A deferred notification stays
+ * pending until it is due, even if the guest would not request one for
+ * the next used descriptors, so that it is never lost.
+ */
+static __rte_always_inline void
+vhost_vring_call_coalesce(struct virtio_net *dev, struct vhost_virtqueue *vq,
+		bool kick)
+{
+	if (likely(!vq->call_coalesce_cycles && !vq->call_coalesce_max)) {
+		if (kick)
+			vhost_vring_notify_guest(dev, vq);
+		return;
+	}
+
+	if (kick) {
+		vq->nr_calls_deferred++;
+		if (!vhost_vring_call_due(vq)) {
+			vq->nr_calls_coalesced++;
+			return;
+		}
+	} else if (!vq->nr_calls_deferred || !vhost_vring_call_due(vq)) {
+		return;
+	}
+
+	vhost_vring_notify_guest(dev, vq);
+}
+
+/*
+ * Send the deferred guest notification of the vring once it is due, called
+ * at the start of each burst on the vring.
+ */
+static __rte_always_inline void
+vhost_vring_call_deferred(struct virtio_net *dev, struct vhost_virtqueue *vq)
+{
+	if (unlikely(vq->nr_calls_deferred))
+		vhost_vring_call_coalesce(dev, vq, false);
+}
+
 static __rte_always_inline void
 vhost_vring_call_split(struct virtio_net *dev, struct vhost_virtqueue *vq)
 {
+	bool kick;
+
 	/* Flush used->idx update before we read avail->flags. */
 	rte_atomic_thread_fence(__ATOMIC_SEQ_CST);
 
@@ -757,22 +871,16 @@ vhost_vring_call_split(struct virtio_net *dev, struct vhost_virtqueue *vq)
 			vhost_used_event(vq),
 			old, new);
 
-		if ((vhost_need_event(vhost_used_event(vq), new, old) &&
+		kick = (vhost_need_event(vhost_used_event(vq), new, old) &&
 					(vq->callfd >= 0)) ||
-				unlikely(!signalled_used_valid)) {
-			eventfd_write(vq->callfd, (eventfd_t) 1);
-			if (dev->notify_ops->guest_notified)
-				dev->notify_ops->guest_notified(dev->vid);
-		}
+				unlikely(!signalled_used_valid);
 	} else {
 		/* Kick the guest if necessary. */
-		if (!(vq->avail->flags & VRING_AVAIL_F_NO_INTERRUPT)
-				&& (vq->callfd >= 0)) {
-			eventfd_write(vq->callfd, (eventfd_t)1);
-			if (dev->notify_ops->guest_notified)
-				dev->notify_ops->guest_notified(dev->vid);
-		}
+		kick = !(vq->avail->flags & VRING_AVAIL_F_NO_INTERRUPT)
+				&& (vq->callfd >= 0);
 	}
+
+	vhost_vring_call_coalesce(dev, vq, kick);
 }
 
 static __rte_always_inline void
@@ -822,11 +930,7 @@ vhost_vring_call_packed(struct virtio_net *dev, struct vhost_virtqueue *vq)
 	if (vhost_need_event(off, new, old))
 		kick = true;
 kick:
-	if (kick) {
-		eventfd_write(vq->callfd, (eventfd_t)1);
-		if (dev->notify_ops->guest_notified)
-			dev->notify_ops->guest_notified(dev->vid);
-	}
+	vhost_vring_call_coalesce(dev, vq, kick);
 }
 
 static __rte_always_inline void
@@ -214,6 +214,8 @@ struct vhost_crypto {
 	struct virtio_net *dev;
 
 	uint8_t option;
+	/** Feature flags of the cryptodev, for the zero copy mbuf layouts */
+	uint64_t feature_flags;
 } __rte_cache_aligned;
 
 struct vhost_crypto_writeback_data {
@@ -522,32 +524,6 @@ reach_inhdr(struct vhost_crypto_data_req *vc_req,
 	return inhdr;
 }
 
-static __rte_always_inline int
-move_desc(struct vhost_crypto_desc *head,
-		struct vhost_crypto_desc **cur_desc,
-		uint32_t size, uint32_t max_n_descs)
-{
-	struct vhost_crypto_desc *desc = *cur_desc;
-	int left = size - desc->len;
-
-	while (desc->flags & VRING_DESC_F_NEXT && left > 0 &&
-			desc >= head &&
-			desc - head < (int)max_n_descs) {
-		desc++;
-		left -= desc->len;
-	}
-
-	if (unlikely(left > 0))
-		return -1;
-
-	if (unlikely(head - desc == (int)max_n_descs))
-		*cur_desc = NULL;
-	else
-		*cur_desc = desc + 1;
-
-	return 0;
-}
-
 static __rte_always_inline void *
 get_data_ptr(struct vhost_crypto_data_req *vc_req,
 		struct vhost_crypto_desc *cur_desc,
@@ -678,10 +654,224 @@ static void
 free_wb_data(struct vhost_crypto_writeback_data *wb_data,
 		struct rte_mempool *mp)
 {
-	while (wb_data->next != NULL)
-		free_wb_data(wb_data->next, mp);
+	struct vhost_crypto_writeback_data *next;
 
-	rte_mempool_put(mp, wb_data);
+	while (wb_data != NULL) {
+		next = wb_data->next;
+		rte_mempool_put(mp, wb_data);
+		wb_data = next;
+	}
+}
+
+/* Point the mbuf to its own data buffer again, after a zero copy use. */
+static __rte_always_inline void
+reset_mbuf(struct rte_mbuf *m)
+{
+	uint32_t mbuf_size = sizeof(struct rte_mbuf) +
+			rte_pktmbuf_priv_size(m->pool);
+
+	m->buf_addr = (char *)m + mbuf_size;
+	m->buf_iova = rte_mempool_virt2iova(m) + mbuf_size;
+	m->buf_len = rte_pktmbuf_data_room_size(m->pool);
+	m->data_off = 0;
+	m->next = NULL;
+	m->nb_segs = 1;
+}
+
+static __rte_always_inline void
+put_mbufs(struct rte_mbuf *m)
+{
+	struct rte_mbuf *next;
+
+	while (m != NULL) {
+		next = m->next;
+		reset_mbuf(m);
+		rte_mempool_put(m->pool, m);
+		m = next;
+	}
+}
+
+/**
+ * Map a guest buffer to a mbuf chain, without copy. Each segment points to
+ * a part of the buffer contiguous in both the host virtual and the IO
+ * address spaces, so the buffer may span several descriptors and pages.
+ *
+ * @param m
+ *   The first mbuf of the chain, the others are taken from the mbuf pool.
+ * @param cur_desc
+ *   The descriptor where the buffer starts, updated to the descriptor
+ *   following it on success.
+ * @param size
+ *   The size of the buffer.
+ * @return
+ *   0 on success, -1 if the buffer cannot be mapped.
+ */
+static __rte_always_inline int
+map_zero_copy_data(struct vhost_crypto *vcrypto,
+		struct vhost_crypto_data_req *vc_req,
+		struct rte_mbuf *m,
+		struct vhost_crypto_desc *head,
+		struct vhost_crypto_desc **cur_desc,
+		uint32_t size, uint32_t max_n_descs, uint8_t perm)
+{
+	struct vhost_crypto_desc *desc = *cur_desc;
+	struct rte_mbuf *seg = m;
+	uint64_t addr, remain, dlen, hlen;
+	uint32_t left = size;
+	uint16_t nb_segs = 0;
+	rte_iova_t iova;
+	void *data;
+
+	if (unlikely(desc == NULL || size == 0))
+		return -1;
+
+	while (1) {
+		addr = desc->addr;
+		remain = RTE_MIN(desc->len, left);
+		left -= remain;
+
+		while (remain) {
+			dlen = remain;
+			data = IOVA_TO_VVA(void *, vc_req, addr, &dlen, perm);
+			if (unlikely(data == NULL || dlen == 0))
+				return -1;
+			iova = gpa_to_first_hpa(vcrypto->dev, addr, dlen, &hlen);
+			if (unlikely(iova == 0))
+				return -1;
+			dlen = RTE_MIN(dlen, hlen);
+
+			if (nb_segs > 0) {
+				if (unlikely(nb_segs == VHOST_CRYPTO_MAX_N_DESC ||
+						rte_mempool_get(vcrypto->mbuf_pool,
+						(void **)&seg->next) < 0))
+					return -1;
+				seg = seg->next;
+				seg->next = NULL;
+			}
+
+			seg->buf_addr = data;
+			seg->buf_iova = iova;
+			seg->buf_len = (uint16_t)dlen;
+			seg->data_off = 0;
+			seg->data_len = (uint16_t)dlen;
+			nb_segs++;
+
+			addr += dlen;
+			remain -= dlen;
+		}
+
+		if (left == 0)
+			break;
+
+		if (unlikely(!(desc->flags & VRING_DESC_F_NEXT) ||
+				desc - head >= (int)max_n_descs - 1))
+			return -1;
+		desc++;
+	}
+
+	m->nb_segs = nb_segs;
+	m->pkt_len = size;
+
+	if (unlikely(desc - head == (int)max_n_descs))
+		*cur_desc = NULL;
+	else
+		*cur_desc = desc + 1;
+
+	return 0;
+}
+
+/**
+ * Map the source, destination and digest buffers of a request to the
+ * operation, without copy.
+ *
+ * @return
+ *   0 on success, -1 if some buffer cannot be mapped or if the cryptodev
+ *   does not support the resulting mbuf layout. The request shall then be
+ *   processed with copies, after zero_copy_fallback().
+ */
+static __rte_always_inline int
+map_zero_copy_op(struct vhost_crypto *vcrypto, struct rte_crypto_op *op,
+		struct vhost_crypto_data_req *vc_req,
+		struct vhost_crypto_desc *head,
+		struct vhost_crypto_desc **cur_desc,
+		uint32_t src_len, uint32_t dst_len, uint32_t digest_len,
+		uint32_t max_n_descs)
+{
+	struct rte_mbuf *m_src = op->sym->m_src, *m_dst = op->sym->m_dst;
+	struct vhost_crypto_desc *desc = *cur_desc;
+	uint64_t feature;
+	uint64_t dlen;
+
+	m_src->data_off = 0;
+	m_dst->data_off = 0;
+
+	if (unlikely(map_zero_copy_data(vcrypto, vc_req, m_src, head, &desc,
+			src_len, max_n_descs, VHOST_ACCESS_RO) < 0))
+		return -1;
+
+	desc = find_write_desc(head, desc, max_n_descs);
+	if (unlikely(map_zero_copy_data(vcrypto, vc_req, m_dst, head, &desc,
+			dst_len, max_n_descs, VHOST_ACCESS_RW) < 0))
+		return -1;
+
+	if (digest_len) {
+		if (unlikely(desc == NULL || desc->len < digest_len))
+			return -1;
+
+		dlen = digest_len;
+		op->sym->auth.digest.data = IOVA_TO_VVA(uint8_t *, vc_req,
+				desc->addr, &dlen, VHOST_ACCESS_RW);
+		op->sym->auth.digest.phys_addr = gpa_to_hpa(vcrypto->dev,
+				desc->addr, digest_len);
+		if (unlikely(op->sym->auth.digest.data == NULL ||
+				dlen != digest_len ||
+				op->sym->auth.digest.phys_addr == 0))
+			return -1;
+
+		if (unlikely(desc - head == (int)max_n_descs))
+			desc = NULL;
+		else
+			desc++;
+	}
+
+	if (m_src->nb_segs > 1)
+		feature = m_dst->nb_segs > 1 ?
+				RTE_CRYPTODEV_FF_OOP_SGL_IN_SGL_OUT :
+				RTE_CRYPTODEV_FF_OOP_SGL_IN_LB_OUT;
+	else
+		feature = m_dst->nb_segs > 1 ?
+				RTE_CRYPTODEV_FF_OOP_LB_IN_SGL_OUT :
+				RTE_CRYPTODEV_FF_OOP_LB_IN_LB_OUT;
+	if (unlikely(!(vcrypto->feature_flags & feature)))
+		return -1;
+
+	*cur_desc = desc;
+
+	return 0;
+}
+
+/* Release the zero copy mbufs of a request, to process it with copies. */
+static __rte_always_inline void
+zero_copy_fallback(struct rte_crypto_op *op,
+		struct vhost_crypto_data_req *vc_req)
+{
+	struct rte_mbuf *m_src = op->sym->m_src;
+
+	put_mbufs(m_src->next);
+	reset_mbuf(m_src);
+	put_mbufs(op->sym->m_dst);
+	op->sym->m_dst = NULL;
+	vc_req->zero_copy = 0;
+}
+
+/* Return a processed request to the guest, in the next used ring entry. */
+static __rte_always_inline void
+write_used_elem(struct vhost_virtqueue *vq, uint16_t desc_idx, uint32_t len)
+{
+	uint16_t used_idx = vq->last_used_idx++ & (vq->size - 1);
+
+	vq->used->ring[used_idx].id = desc_idx;
+	vq->used->ring[used_idx].len = len;
 }
 
 /**
@@ -719,7 +909,7 @@ prepare_write_back_data(struct vhost_crypto_data_req *vc_req,
 		uint64_t write_back_len,
 		uint32_t max_n_descs)
 {
-	struct vhost_crypto_writeback_data *wb_data, *head;
+	struct vhost_crypto_writeback_data *wb_data, *head = NULL;
 	struct vhost_crypto_desc *desc = *cur_desc;
 	uint64_t dlen;
 	uint8_t *dst;
@@ -732,6 +922,7 @@ prepare_write_back_data(struct vhost_crypto_data_req *vc_req,
 	}
 
 	wb_data = head;
+	wb_data->next = NULL;
 
 	if (likely(desc->len > offset)) {
 		wb_data->src = src + offset;
@@ -758,8 +949,8 @@ prepare_write_back_data(struct vhost_crypto_data_req *vc_req,
 			}
 
 			wb_data = wb_data->next;
-		} else
 			wb_data->next = NULL;
+		}
 	} else
 		offset -= desc->len;
 
@@ -801,8 +992,8 @@ prepare_write_back_data(struct vhost_crypto_data_req *vc_req,
 			}
 
 			wb_data = wb_data->next;
-		} else
 			wb_data->next = NULL;
+		}
 	}
 
 	if (unlikely(desc - head_desc == (int)max_n_descs))
@@ -841,7 +1032,7 @@ prepare_sym_cipher_op(struct vhost_crypto *vcrypto, struct rte_crypto_op *op,
 {
 	struct vhost_crypto_desc *desc = head;
 	struct vhost_crypto_writeback_data *ewb = NULL;
-	struct rte_mbuf *m_src = op->sym->m_src, *m_dst = op->sym->m_dst;
+	struct rte_mbuf *m_src = op->sym->m_src;
 	uint8_t *iv_data = rte_crypto_op_ctod_offset(op, uint8_t *, IV_OFFSET);
 	uint8_t ret = vhost_crypto_check_cipher_request(cipher);
 
@@ -856,29 +1047,13 @@ prepare_sym_cipher_op(struct vhost_crypto *vcrypto, struct rte_crypto_op *op,
 		goto error_exit;
 	}
 
-	switch (vcrypto->option) {
-	case RTE_VHOST_CRYPTO_ZERO_COPY_ENABLE:
-		m_src->data_len = cipher->para.src_data_len;
-		m_src->buf_iova = gpa_to_hpa(vcrypto->dev, desc->addr,
-				cipher->para.src_data_len);
-		m_src->buf_addr = get_data_ptr(vc_req, desc, VHOST_ACCESS_RO);
-		if (unlikely(m_src->buf_iova == 0 ||
-				m_src->buf_addr == NULL)) {
-			VC_LOG_ERR("zero_copy may fail due to cross page data");
-			ret = VIRTIO_CRYPTO_ERR;
-			goto error_exit;
-		}
-
-		if (unlikely(move_desc(head, &desc, cipher->para.src_data_len,
-				max_n_descs) < 0)) {
-			VC_LOG_ERR("Incorrect descriptor");
-			ret = VIRTIO_CRYPTO_ERR;
-			goto error_exit;
-		}
+	if (vc_req->zero_copy && unlikely(map_zero_copy_op(vcrypto, op,
+			vc_req, head, &desc, cipher->para.src_data_len,
+			cipher->para.dst_data_len, 0, max_n_descs) < 0))
+		zero_copy_fallback(op, vc_req);
 
-		break;
-	case RTE_VHOST_CRYPTO_ZERO_COPY_DISABLE:
-		vc_req->wb_pool = vcrypto->wb_pool;
+	if (!vc_req->zero_copy) {
+		/* src */
 		m_src->data_len = cipher->para.src_data_len;
 		if (unlikely(copy_data(rte_pktmbuf_mtod(m_src, uint8_t *),
 				vc_req, head, &desc, cipher->para.src_data_len,
@@ -886,41 +1061,15 @@ prepare_sym_cipher_op(struct vhost_crypto *vcrypto, struct rte_crypto_op *op,
 			ret = VIRTIO_CRYPTO_BADMSG;
 			goto error_exit;
 		}
-		break;
-	default:
-		ret = VIRTIO_CRYPTO_BADMSG;
-		goto error_exit;
-	}
-
-	/* dst */
-	desc = find_write_desc(head, desc, max_n_descs);
-	if (unlikely(!desc)) {
-		VC_LOG_ERR("Cannot find write location");
-		ret = VIRTIO_CRYPTO_BADMSG;
-		goto error_exit;
-	}
-
-	switch (vcrypto->option) {
-	case RTE_VHOST_CRYPTO_ZERO_COPY_ENABLE:
-		m_dst->buf_iova = gpa_to_hpa(vcrypto->dev,
-				desc->addr, cipher->para.dst_data_len);
-		m_dst->buf_addr = get_data_ptr(vc_req, desc, VHOST_ACCESS_RW);
-		if (unlikely(m_dst->buf_iova == 0 || m_dst->buf_addr == NULL)) {
-			VC_LOG_ERR("zero_copy may fail due to cross page data");
-			ret = VIRTIO_CRYPTO_ERR;
-			goto error_exit;
-		}
 
-		if (unlikely(move_desc(head, &desc, cipher->para.dst_data_len,
-				max_n_descs) < 0)) {
-			VC_LOG_ERR("Incorrect descriptor");
-			ret = VIRTIO_CRYPTO_ERR;
+		/* dst */
+		desc = find_write_desc(head, desc, max_n_descs);
+		if (unlikely(!desc)) {
+			VC_LOG_ERR("Cannot find write location");
+			ret = VIRTIO_CRYPTO_BADMSG;
 			goto error_exit;
 		}
 
-		m_dst->data_len = cipher->para.dst_data_len;
-		break;
-	case RTE_VHOST_CRYPTO_ZERO_COPY_DISABLE:
 		vc_req->wb = prepare_write_back_data(vc_req, head, &desc, &ewb,
 				rte_pktmbuf_mtod(m_src, uint8_t *), 0,
 				cipher->para.dst_data_len, max_n_descs);
@@ -928,11 +1077,6 @@ prepare_sym_cipher_op(struct vhost_crypto *vcrypto, struct rte_crypto_op *op,
 			ret = VIRTIO_CRYPTO_ERR;
 			goto error_exit;
 		}
-
-		break;
-	default:
-		ret = VIRTIO_CRYPTO_BADMSG;
-		goto error_exit;
 	}
 
 	/* src data */
@@ -942,6 +1086,11 @@ prepare_sym_cipher_op(struct vhost_crypto *vcrypto, struct rte_crypto_op *op,
 	op->sym->cipher.data.offset = 0;
 	op->sym->cipher.data.length = cipher->para.src_data_len;
 
+	if (unlikely(desc == NULL)) {
+		ret = VIRTIO_CRYPTO_BADMSG;
+		goto error_exit;
+	}
+
 	vc_req->inhdr = get_data_ptr(vc_req, desc, VHOST_ACCESS_WO);
 	if (unlikely(vc_req->inhdr == NULL)) {
 		ret = VIRTIO_CRYPTO_BADMSG;
@@ -954,8 +1103,10 @@ prepare_sym_cipher_op(struct vhost_crypto *vcrypto, struct rte_crypto_op *op,
 	return 0;
 
 error_exit:
-	if (vc_req->wb)
+	if (vc_req->wb) {
 		free_wb_data(vc_req->wb, vc_req->wb_pool);
+		vc_req->wb = NULL;
+	}
 
 	vc_req->len = INHDR_LEN;
 	return ret;
@@ -993,7 +1144,7 @@ prepare_sym_chain_op(struct vhost_crypto *vcrypto, struct rte_crypto_op *op,
 {
 	struct vhost_crypto_desc *desc = head, *digest_desc;
 	struct vhost_crypto_writeback_data *ewb = NULL, *ewb2 = NULL;
-	struct rte_mbuf *m_src = op->sym->m_src, *m_dst = op->sym->m_dst;
+	struct rte_mbuf *m_src = op->sym->m_src;
 	uint8_t *iv_data = rte_crypto_op_ctod_offset(op, uint8_t *, IV_OFFSET);
 	uint32_t digest_offset;
 	void *digest_addr;
@@ -1010,29 +1161,14 @@ prepare_sym_chain_op(struct vhost_crypto *vcrypto, struct rte_crypto_op *op,
 		goto error_exit;
 	}
 
-	switch (vcrypto->option) {
-	case RTE_VHOST_CRYPTO_ZERO_COPY_ENABLE:
-		m_src->data_len = chain->para.src_data_len;
-		m_dst->data_len = chain->para.dst_data_len;
+	if (vc_req->zero_copy && unlikely(map_zero_copy_op(vcrypto, op,
+			vc_req, head, &desc, chain->para.src_data_len,
+			chain->para.dst_data_len, chain->para.hash_result_len,
+			max_n_descs) < 0))
+		zero_copy_fallback(op, vc_req);
 
-		m_src->buf_iova = gpa_to_hpa(vcrypto->dev, desc->addr,
-				chain->para.src_data_len);
-		m_src->buf_addr = get_data_ptr(vc_req, desc, VHOST_ACCESS_RO);
-		if (unlikely(m_src->buf_iova == 0 || m_src->buf_addr == NULL)) {
-			VC_LOG_ERR("zero_copy may fail due to cross page data");
-			ret = VIRTIO_CRYPTO_ERR;
-			goto error_exit;
-		}
-
-		if (unlikely(move_desc(head, &desc, chain->para.src_data_len,
-				max_n_descs) < 0)) {
-			VC_LOG_ERR("Incorrect descriptor");
-			ret = VIRTIO_CRYPTO_ERR;
-			goto error_exit;
-		}
-		break;
-	case RTE_VHOST_CRYPTO_ZERO_COPY_DISABLE:
-		vc_req->wb_pool = vcrypto->wb_pool;
+	if (!vc_req->zero_copy) {
+		/* src */
 		m_src->data_len = chain->para.src_data_len;
 		if (unlikely(copy_data(rte_pktmbuf_mtod(m_src, uint8_t *),
 				vc_req, head, &desc, chain->para.src_data_len,
@@ -1041,58 +1177,14 @@ prepare_sym_chain_op(struct vhost_crypto *vcrypto, struct rte_crypto_op *op,
 			goto error_exit;
 		}
 
-		break;
-	default:
-		ret = VIRTIO_CRYPTO_BADMSG;
-		goto error_exit;
-	}
-
-	/* dst */
-	desc = find_write_desc(head, desc, max_n_descs);
-	if (unlikely(!desc)) {
-		VC_LOG_ERR("Cannot find write location");
-		ret = VIRTIO_CRYPTO_BADMSG;
-		goto error_exit;
-	}
-
-	switch (vcrypto->option) {
-	case RTE_VHOST_CRYPTO_ZERO_COPY_ENABLE:
-		m_dst->buf_iova = gpa_to_hpa(vcrypto->dev,
-				desc->addr, chain->para.dst_data_len);
-		m_dst->buf_addr = get_data_ptr(vc_req, desc, VHOST_ACCESS_RW);
-		if (unlikely(m_dst->buf_iova == 0 || m_dst->buf_addr == NULL)) {
-			VC_LOG_ERR("zero_copy may fail due to cross page data");
-			ret = VIRTIO_CRYPTO_ERR;
-			goto error_exit;
-		}
-
-		if (unlikely(move_desc(vc_req->head, &desc,
-				chain->para.dst_data_len, max_n_descs) < 0)) {
-			VC_LOG_ERR("Incorrect descriptor");
-			ret = VIRTIO_CRYPTO_ERR;
-			goto error_exit;
-		}
-
-		op->sym->auth.digest.phys_addr = gpa_to_hpa(vcrypto->dev,
-				desc->addr, chain->para.hash_result_len);
-		op->sym->auth.digest.data = get_data_ptr(vc_req, desc,
-				VHOST_ACCESS_RW);
-		if (unlikely(op->sym->auth.digest.phys_addr == 0)) {
-			VC_LOG_ERR("zero_copy may fail due to cross page data");
-			ret = VIRTIO_CRYPTO_ERR;
-			goto error_exit;
-		}
-
-		if (unlikely(move_desc(head, &desc,
-				chain->para.hash_result_len,
-				max_n_descs) < 0)) {
-			VC_LOG_ERR("Incorrect descriptor");
-			ret = VIRTIO_CRYPTO_ERR;
+		/* dst */
+		desc = find_write_desc(head, desc, max_n_descs);
+		if (unlikely(!desc)) {
+			VC_LOG_ERR("Cannot find write location");
+			ret = VIRTIO_CRYPTO_BADMSG;
 			goto error_exit;
 		}
 
-		break;
-	case RTE_VHOST_CRYPTO_ZERO_COPY_DISABLE:
 		vc_req->wb = prepare_write_back_data(vc_req, head, &desc, &ewb,
 				rte_pktmbuf_mtod(m_src, uint8_t *),
 				chain->para.cipher_start_src_offset,
@@ -1128,13 +1220,14 @@ prepare_sym_chain_op(struct vhost_crypto *vcrypto, struct rte_crypto_op *op,
 		op->sym->auth.digest.data = digest_addr;
 		op->sym->auth.digest.phys_addr = rte_pktmbuf_iova_offset(m_src,
 				digest_offset);
-		break;
-	default:
+	}
+
+	/* record inhdr */
+	if (unlikely(desc == NULL)) {
 		ret = VIRTIO_CRYPTO_BADMSG;
 		goto error_exit;
 	}
 
-	/* record inhdr */
 	vc_req->inhdr = get_data_ptr(vc_req, desc, VHOST_ACCESS_WO);
 	if (unlikely(vc_req->inhdr == NULL)) {
 		ret = VIRTIO_CRYPTO_BADMSG;
@@ -1158,8 +1251,10 @@ prepare_sym_chain_op(struct vhost_crypto *vcrypto, struct rte_crypto_op *op,
 	return 0;
 
 error_exit:
-	if (vc_req->wb)
+	if (vc_req->wb) {
 		free_wb_data(vc_req->wb, vc_req->wb_pool);
+		vc_req->wb = NULL;
+	}
 	vc_req->len = INHDR_LEN;
 	return ret;
 }
@@ -1187,6 +1282,11 @@ vhost_crypto_process_one_req(struct vhost_crypto *vcrypto,
 	vc_req->desc_idx = desc_idx;
 	vc_req->dev = vcrypto->dev;
 	vc_req->vq = vq;
+	vc_req->wb = NULL;
+	vc_req->wb_pool = vcrypto->wb_pool;
+	/* the fetch gives a destination mbuf to the zero copy requests only */
+	vc_req->zero_copy = op->sym->m_dst != NULL;
+	vc_req->len = 0;
 
 	if (unlikely((head->flags & VRING_DESC_F_INDIRECT) == 0)) {
 		VC_LOG_ERR("Invalid descriptor");
@@ -1215,14 +1315,16 @@ vhost_crypto_process_one_req(struct vhost_crypto *vcrypto,
 			}
 			if (inhdr_desc->len != sizeof(*inhdr))
 				return -1;
+			dlen = inhdr_desc->len;
 			inhdr = IOVA_TO_VVA(struct virtio_crypto_inhdr *,
 					vc_req, inhdr_desc->addr, &dlen,
 					VHOST_ACCESS_WO);
 			if (unlikely(!inhdr || dlen != inhdr_desc->len))
 				return -1;
 			inhdr->status = VIRTIO_CRYPTO_ERR;
-			return -1;
+			vc_req->len = INHDR_LEN;
 		}
+		return -1;
 	}
 
 	/* copy descriptors to local variable */
@@ -1242,7 +1344,6 @@ vhost_crypto_process_one_req(struct vhost_crypto *vcrypto,
 	}
 
 	vc_req->head = head;
-	vc_req->zero_copy = vcrypto->option;
 
 	nb_descs = desc - descs;
 	desc = descs;
@@ -1324,8 +1425,10 @@ vhost_crypto_process_one_req(struct vhost_crypto *vcrypto,
 error_exit:
 
 	inhdr = reach_inhdr(vc_req, descs, max_n_descs);
-	if (likely(inhdr != NULL))
+	if (likely(inhdr != NULL)) {
 		inhdr->status = (uint8_t)err;
+		vc_req->len = INHDR_LEN;
+	}
 
 	return -1;
 }
@@ -1338,7 +1441,6 @@ vhost_crypto_finalize_one_request(struct rte_crypto_op *op,
 	struct rte_mbuf *m_dst = op->sym->m_dst;
 	struct vhost_crypto_data_req *vc_req = rte_mbuf_to_priv(m_src);
 	struct vhost_virtqueue *vq = vc_req->vq;
-	uint16_t used_idx = vc_req->desc_idx, desc_idx;
 
 	if (unlikely(!vc_req)) {
 		VC_LOG_ERR("Failed to retrieve vc_req");
@@ -1348,23 +1450,21 @@ vhost_crypto_finalize_one_request(struct rte_crypto_op *op,
 	if (old_vq && (vq != old_vq))
 		return vq;
 
-	if (unlikely(op->status != RTE_CRYPTO_OP_STATUS_SUCCESS))
+	if (unlikely(op->status != RTE_CRYPTO_OP_STATUS_SUCCESS)) {
 		vc_req->inhdr->status = VIRTIO_CRYPTO_ERR;
-	else {
+		if (vc_req->wb)
+			free_wb_data(vc_req->wb, vc_req->wb_pool);
+	} else {
 		if (vc_req->zero_copy == 0)
 			write_back_data(vc_req);
 	}
 
-	desc_idx = vq->avail->ring[used_idx];
-	vq->used->ring[desc_idx].id = vq->avail->ring[desc_idx];
-	vq->used->ring[desc_idx].len = vc_req->len;
-
-	rte_mempool_put(m_src->pool, (void *)m_src);
+	write_used_elem(vq, vc_req->desc_idx, vc_req->len);
 
-	if (m_dst)
-		rte_mempool_put(m_dst->pool, (void *)m_dst);
+	put_mbufs(m_src);
+	put_mbufs(m_dst);
 
-	return vc_req->vq;
+	return vq;
 }
 
 static __rte_always_inline uint16_t
@@ -1394,7 +1494,8 @@ vhost_crypto_complete_one_vm_requests(struct rte_crypto_op **ops,
 
 	*callfd = vq->callfd;
 
-	*(volatile uint16_t *)&vq->used->idx += processed;
+	/* hand the whole burst of the queue over to the guest at once */
+	__atomic_add_fetch(&vq->used->idx, processed, __ATOMIC_RELEASE);
 
 	return processed;
 }
@@ -1428,6 +1529,7 @@ rte_vhost_crypto_create(int vid, uint8_t cryptodev_id,
 {
 	struct virtio_net *dev = get_device(vid);
 	struct rte_hash_parameters params = {0};
+	struct rte_cryptodev_info info;
 	struct vhost_crypto *vcrypto;
 	char name[128];
 	int ret;
@@ -1450,7 +1552,10 @@ rte_vhost_crypto_create(int vid, uint8_t cryptodev_id,
 	vcrypto->cache_session_id = UINT64_MAX;
 	vcrypto->last_session_id = 1;
 	vcrypto->dev = dev;
-	vcrypto->option = RTE_VHOST_CRYPTO_ZERO_COPY_DISABLE;
+	vcrypto->option = RTE_VHOST_CRYPTO_ZERO_COPY_ENABLE;
+
+	rte_cryptodev_info_get(cryptodev_id, &info);
+	vcrypto->feature_flags = info.feature_flags;
 
 	snprintf(name, 127, "HASH_VHOST_CRYPT_%u", (uint32_t)vid);
 	params.name = name;
@@ -1558,34 +1663,8 @@ rte_vhost_crypto_set_zero_copy(int vid, enum rte_vhost_crypto_zero_copy option)
 		return -ENOENT;
 	}
 
-	if (vcrypto->option == (uint8_t)option)
-		return 0;
-
-	if (!(rte_mempool_full(vcrypto->mbuf_pool)) ||
-			!(rte_mempool_full(vcrypto->wb_pool))) {
-		VC_LOG_ERR("Cannot update zero copy as mempool is not full");
-		return -EINVAL;
-	}
-
-	if (option == RTE_VHOST_CRYPTO_ZERO_COPY_DISABLE) {
-		char name[128];
-
-		snprintf(name, 127, "WB_POOL_VM_%u", (uint32_t)vid);
-		vcrypto->wb_pool = rte_mempool_create(name,
-				VHOST_CRYPTO_MBUF_POOL_SIZE,
-				sizeof(struct vhost_crypto_writeback_data),
-				128, 0, NULL, NULL, NULL, NULL,
-				rte_socket_id(), 0);
-		if (!vcrypto->wb_pool) {
-			VC_LOG_ERR("Failed to creath mbuf pool");
-			return -ENOMEM;
-		}
-	} else {
-		rte_mempool_free(vcrypto->wb_pool);
-		vcrypto->wb_pool = NULL;
-	}
-
-	vcrypto->option = (uint8_t)option;
+	/* The requests in flight keep the mode they were fetched with. */
+	__atomic_store_n(&vcrypto->option, (uint8_t)option, __ATOMIC_RELAXED);
 
 	return 0;
 }
@@ -1596,13 +1675,18 @@ rte_vhost_crypto_fetch_requests(int vid, uint32_t qid,
 {
 	struct rte_mbuf *mbufs[VHOST_CRYPTO_MAX_BURST_SIZE * 2];
 	struct vhost_crypto_desc descs[VHOST_CRYPTO_MAX_N_DESC];
+	uint16_t desc_idx[VHOST_CRYPTO_MAX_BURST_SIZE];
 	struct virtio_net *dev = get_device(vid);
+	struct vhost_crypto_data_req *vc_req;
 	struct vhost_crypto *vcrypto;
 	struct vhost_virtqueue *vq;
+	uint16_t nb_fetched = 0;
+	uint16_t nb_failed = 0;
 	uint16_t avail_idx;
 	uint16_t start_idx;
+	uint16_t nb_mbufs;
 	uint16_t count;
-	uint16_t i = 0;
+	uint16_t i;
 
 	if (unlikely(dev == NULL)) {
 		VC_LOG_ERR("Invalid vid %i", vid);
@@ -1622,8 +1706,8 @@ rte_vhost_crypto_fetch_requests(int vid, uint32_t qid,
 
 	vq = dev->virtqueue[qid];
 
-	avail_idx = *((volatile uint16_t *)&vq->avail->idx);
-	start_idx = vq->last_used_idx;
+	avail_idx = __atomic_load_n(&vq->avail->idx, __ATOMIC_ACQUIRE);
+	start_idx = vq->last_avail_idx;
 	count = avail_idx - start_idx;
 	count = RTE_MIN(count, VHOST_CRYPTO_MAX_BURST_SIZE);
 	count = RTE_MIN(count, nb_ops);
@@ -1631,74 +1715,55 @@ rte_vhost_crypto_fetch_requests(int vid, uint32_t qid,
 	if (unlikely(count == 0))
 		return 0;
 
+	/* read the whole burst of heads first, to prefetch their descriptors */
+	for (i = 0; i < count; i++) {
+		desc_idx[i] = vq->avail->ring[(start_idx + i) & (vq->size - 1)];
+		rte_prefetch0(&vq->desc[desc_idx[i]]);
+	}
+
 	/* for zero copy, we need 2 empty mbufs for src and dst, otherwise
-	 * we need only 1 mbuf as src and dst
+	 * we need only 1 mbuf as src and dst. The mode is read once, it may
+	 * be switched concurrently.
 	 */
-	switch (vcrypto->option) {
-	case RTE_VHOST_CRYPTO_ZERO_COPY_ENABLE:
-		if (unlikely(rte_mempool_get_bulk(vcrypto->mbuf_pool,
-				(void **)mbufs, count * 2) < 0)) {
-			VC_LOG_ERR("Insufficient memory");
-			return 0;
-		}
-
-		for (i = 0; i < count; i++) {
-			uint16_t used_idx = (start_idx + i) & (vq->size - 1);
-			uint16_t desc_idx = vq->avail->ring[used_idx];
-			struct vring_desc *head = &vq->desc[desc_idx];
-			struct rte_crypto_op *op = ops[i];
-
-			op->sym->m_src = mbufs[i * 2];
-			op->sym->m_dst = mbufs[i * 2 + 1];
-			op->sym->m_src->data_off = 0;
-			op->sym->m_dst->data_off = 0;
-
-			if (unlikely(vhost_crypto_process_one_req(vcrypto, vq,
-					op, head, descs, used_idx) < 0))
-				break;
-		}
-
-		if (unlikely(i < count))
-			rte_mempool_put_bulk(vcrypto->mbuf_pool,
-					(void **)&mbufs[i * 2],
-					(count - i) * 2);
-
-		break;
-
-	case RTE_VHOST_CRYPTO_ZERO_COPY_DISABLE:
-		if (unlikely(rte_mempool_get_bulk(vcrypto->mbuf_pool,
-				(void **)mbufs, count) < 0)) {
-			VC_LOG_ERR("Insufficient memory");
-			return 0;
-		}
+	nb_mbufs = __atomic_load_n(&vcrypto->option, __ATOMIC_RELAXED) ==
+			RTE_VHOST_CRYPTO_ZERO_COPY_ENABLE ? 2 : 1;
+	if (unlikely(rte_mempool_get_bulk(vcrypto->mbuf_pool,
+			(void **)mbufs, count * nb_mbufs) < 0)) {
+		VC_LOG_ERR("Insufficient memory");
+		return 0;
+	}
 
-		for (i = 0; i < count; i++) {
-			uint16_t used_idx = (start_idx + i) & (vq->size - 1);
-			uint16_t desc_idx = vq->avail->ring[used_idx];
-			struct vring_desc *head = &vq->desc[desc_idx];
-			struct rte_crypto_op *op = ops[i];
+	for (i = 0; i < count; i++) {
+		struct rte_crypto_op *op = ops[nb_fetched];
 
-			op->sym->m_src = mbufs[i];
-			op->sym->m_dst = NULL;
-			op->sym->m_src->data_off = 0;
+		op->sym->m_src = mbufs[i * nb_mbufs];
+		op->sym->m_dst = nb_mbufs == 2 ? mbufs[i * 2 + 1] : NULL;
+		op->sym->m_src->data_off = 0;
 
-			if (unlikely(vhost_crypto_process_one_req(vcrypto, vq,
-					op, head, descs, desc_idx) < 0))
-				break;
+		if (likely(vhost_crypto_process_one_req(vcrypto, vq, op,
+				&vq->desc[desc_idx[i]], descs,
+				desc_idx[i]) == 0)) {
+			nb_fetched++;
+			continue;
 		}
 
-		if (unlikely(i < count))
-			rte_mempool_put_bulk(vcrypto->mbuf_pool,
-					(void **)&mbufs[i],
-					count - i);
+		/* return the invalid request right away, with its status */
+		vc_req = rte_mbuf_to_priv(op->sym->m_src);
+		write_used_elem(vq, desc_idx[i], vc_req->len);
+		put_mbufs(op->sym->m_src);
+		put_mbufs(op->sym->m_dst);
+		nb_failed++;
+	}
 
-		break;
+	vq->last_avail_idx += count;
 
+	if (unlikely(nb_failed > 0)) {
+		__atomic_add_fetch(&vq->used->idx, nb_failed,
+				__ATOMIC_RELEASE);
+		vhost_vring_call_split(dev, vq);
 	}
 
-	vq->last_used_idx += i;
-
-	return i;
+	return nb_fetched;
 }
 
 uint16_t
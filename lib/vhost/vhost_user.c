@@ -474,79 +474,38 @@ vhost_user_set_vring_num(struct virtio_net **pdev,
 
 /*
  * Reallocate virtio_dev and vhost_virtqueue data structure to make them on the
- * same numa node as the memory of vring descriptor.
+ * same numa node as the memory of vring descriptor, or the vhost_virtqueue on
+ * the node preferred by the application.
  */
 #ifdef RTE_LIBRTE_VHOST_NUMA
 static struct virtio_net*
 numa_realloc(struct virtio_net *dev, int index)
 {
-	int oldnode, newnode;
+	int oldnode, newnode, vq_node;
 	struct virtio_net *old_dev;
-	struct vhost_virtqueue *old_vq, *vq;
-	struct vring_used_elem *new_shadow_used_split;
-	struct vring_used_elem_packed *new_shadow_used_packed;
-	struct batch_copy_elem *new_batch_copy_elems;
+	struct vhost_virtqueue *vq;
 	int ret;
 
 	if (dev->flags & VIRTIO_DEV_RUNNING)
 		return dev;
 
 	old_dev = dev;
-	vq = old_vq = dev->virtqueue[index];
+	vq = dev->virtqueue[index];
 
-	ret = get_mempolicy(&newnode, NULL, 0, old_vq->desc,
+	ret = get_mempolicy(&newnode, NULL, 0, vq->desc,
 			    MPOL_F_NODE | MPOL_F_ADDR);
 
 	/* check if we need to reallocate vq */
-	ret |= get_mempolicy(&oldnode, NULL, 0, old_vq,
+	ret |= get_mempolicy(&oldnode, NULL, 0, vq,
 			     MPOL_F_NODE | MPOL_F_ADDR);
 	if (ret) {
 		VHOST_LOG_CONFIG(ERR,
 			"Unable to get vq numa information.\n");
 		return dev;
 	}
-	if (oldnode != newnode) {
-		VHOST_LOG_CONFIG(INFO,
-			"reallocate vq from %d to %d node\n", oldnode, newnode);
-		vq = rte_malloc_socket(NULL, sizeof(*vq), 0, newnode);
-		if (!vq)
-			return dev;
-
-		memcpy(vq, old_vq, sizeof(*vq));
-
-		if (vq_is_packed(dev)) {
-			new_shadow_used_packed = rte_malloc_socket(NULL,
-					vq->size *
-					sizeof(struct vring_used_elem_packed),
-					RTE_CACHE_LINE_SIZE,
-					newnode);
-			if (new_shadow_used_packed) {
-				rte_free(vq->shadow_used_packed);
-				vq->shadow_used_packed = new_shadow_used_packed;
-			}
-		} else {
-			new_shadow_used_split = rte_malloc_socket(NULL,
-					vq->size *
-					sizeof(struct vring_used_elem),
-					RTE_CACHE_LINE_SIZE,
-					newnode);
-			if (new_shadow_used_split) {
-				rte_free(vq->shadow_used_split);
-				vq->shadow_used_split = new_shadow_used_split;
-			}
-		}
-
-		new_batch_copy_elems = rte_malloc_socket(NULL,
-			vq->size * sizeof(struct batch_copy_elem),
-			RTE_CACHE_LINE_SIZE,
-			newnode);
-		if (new_batch_copy_elems) {
-			rte_free(vq->batch_copy_elems);
-			vq->batch_copy_elems = new_batch_copy_elems;
-		}
-
-		rte_free(old_vq);
-	}
+	vq_node = vq->numa_node != SOCKET_ID_ANY ? vq->numa_node : newnode;
+	if (oldnode != vq_node)
+		vhost_realloc_vring(dev, index, vq_node);
 
 	/* check if we need to reallocate dev */
 	ret = get_mempolicy(&oldnode, NULL, 0, old_dev,
@@ -554,29 +513,21 @@ numa_realloc(struct virtio_net *dev, int index)
 	if (ret) {
 		VHOST_LOG_CONFIG(ERR,
 			"Unable to get dev numa information.\n");
-		goto out;
+		return dev;
 	}
 	if (oldnode != newnode) {
 		VHOST_LOG_CONFIG(INFO,
 			"reallocate dev from %d to %d node\n",
 			oldnode, newnode);
 		dev = rte_malloc_socket(NULL, sizeof(*dev), 0, newnode);
-		if (!dev) {
-			dev = old_dev;
-			goto out;
-		}
+		if (!dev)
+			return old_dev;
 
 		memcpy(dev, old_dev, sizeof(*dev));
 		rte_free(old_dev);
+		vhost_devices[dev->vid] = dev;
 	}
 
-out:
-	dev->virtqueue[index] = vq;
-	vhost_devices[dev->vid] = dev;
-
-	if (old_vq != vq)
-		vhost_user_iotlb_init(dev, index);
-
 	return dev;
 }
 #else
@@ -2013,6 +1964,7 @@ vhost_user_get_vring_base(struct virtio_net **pdev,
 
 	rte_free(vq->log_cache);
 	vq->log_cache = NULL;
+	vq->log_cache_hash = NULL;
 
 	msg->size = sizeof(msg->payload.state);
 	msg->fd_num = 0;
@@ -2173,8 +2125,10 @@ vhost_user_set_log_base(struct virtio_net **pdev, struct VhostUserMsg *msg,
 		rte_free(vq->log_cache);
 		vq->log_cache = NULL;
 		vq->log_cache_nb_elem = 0;
+		vq->log_cache_hash = NULL;
 		vq->log_cache = rte_zmalloc("vq log cache",
-				sizeof(struct log_cache_entry) * VHOST_LOG_CACHE_NR,
+				sizeof(struct log_cache_entry) * VHOST_LOG_CACHE_NR +
+				sizeof(uint16_t) * VHOST_LOG_CACHE_HASH_NR,
 				0);
 		/*
 		 * If log cache alloc fail, don't fail migration, but no
@@ -2182,6 +2136,9 @@ vhost_user_set_log_base(struct virtio_net **pdev, struct VhostUserMsg *msg,
 		 */
 		if (!vq->log_cache)
 			VHOST_LOG_CONFIG(ERR, "Failed to allocate VQ logging cache\n");
+		else
+			vq->log_cache_hash = (uint16_t *)
+				(vq->log_cache + VHOST_LOG_CACHE_NR);
 	}
 
 	/*
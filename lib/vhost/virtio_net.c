@@ -8,7 +8,9 @@
 
 #include <rte_mbuf.h>
 #include <rte_memcpy.h>
+#include <rte_gro.h>
 #include <rte_net.h>
+#include <rte_net_cksum.h>
 #include <rte_ether.h>
 #include <rte_ip.h>
 #include <rte_vhost.h>
@@ -901,7 +903,8 @@ copy_mbuf_to_desc(struct virtio_net *dev, struct vhost_virtqueue *vq,
 
 		if (likely(cpy_len > MAX_BATCH_LEN ||
 					vq->batch_copy_nb_elems >= vq->size)) {
-			rte_memcpy((void *)((uintptr_t)(buf_addr + buf_offset)),
+			/* the guest reads it, not worth caching if large */
+			rte_memcpy_nt((void *)((uintptr_t)(buf_addr + buf_offset)),
 				rte_pktmbuf_mtod_offset(m, void *, mbuf_offset),
 				cpy_len);
 			vhost_log_cache_write_iova(dev, vq,
@@ -1202,6 +1205,96 @@ vhost_enqueue_single_packed(struct virtio_net *dev,
 	return 0;
 }
 
+/*
+ * Enqueue a batch of single segment packets, each one to a single
+ * descriptor buffer large enough to hold it with its header.
+ */
+static __rte_always_inline int
+virtio_dev_rx_batch_split(struct virtio_net *dev,
+			  struct vhost_virtqueue *vq,
+			  struct rte_mbuf **pkts,
+			  uint16_t avail_head)
+{
+	struct vring_desc *descs = vq->desc;
+	uint16_t avail_idx = vq->last_avail_idx;
+	uint64_t desc_addrs[SPLIT_BATCH_SIZE];
+	struct virtio_net_hdr_mrg_rxbuf *hdrs[SPLIT_BATCH_SIZE];
+	uint32_t buf_offset = dev->vhost_hlen;
+	uint64_t lens[SPLIT_BATCH_SIZE];
+	uint16_t ids[SPLIT_BATCH_SIZE];
+	uint16_t i;
+
+	if (unlikely((uint16_t)(avail_head - avail_idx) < SPLIT_BATCH_SIZE))
+		return -1;
+
+	vhost_for_each_try_unroll(i, 0, SPLIT_BATCH_SIZE)
+		ids[i] = vq->avail->ring[(avail_idx + i) & (vq->size - 1)];
+
+	vhost_for_each_try_unroll(i, 0, SPLIT_BATCH_SIZE) {
+		if (unlikely(pkts[i]->next != NULL))
+			return -1;
+		if (unlikely(ids[i] >= vq->size))
+			return -1;
+		if (unlikely(descs[ids[i]].flags &
+			     (VRING_DESC_F_NEXT | VRING_DESC_F_INDIRECT)))
+			return -1;
+	}
+
+	vhost_for_each_try_unroll(i, 0, SPLIT_BATCH_SIZE)
+		lens[i] = descs[ids[i]].len;
+
+	vhost_for_each_try_unroll(i, 0, SPLIT_BATCH_SIZE) {
+		if (unlikely(lens[i] < buf_offset ||
+			     pkts[i]->pkt_len > (lens[i] - buf_offset)))
+			return -1;
+	}
+
+	vhost_for_each_try_unroll(i, 0, SPLIT_BATCH_SIZE)
+		desc_addrs[i] = vhost_iova_to_vva(dev, vq,
+						  descs[ids[i]].addr,
+						  &lens[i],
+						  VHOST_ACCESS_RW);
+
+	vhost_for_each_try_unroll(i, 0, SPLIT_BATCH_SIZE) {
+		if (unlikely(!desc_addrs[i]))
+			return -1;
+		if (unlikely(lens[i] != descs[ids[i]].len))
+			return -1;
+	}
+
+	vhost_for_each_try_unroll(i, 0, SPLIT_BATCH_SIZE) {
+		rte_prefetch0((void *)(uintptr_t)desc_addrs[i]);
+		hdrs[i] = (struct virtio_net_hdr_mrg_rxbuf *)
+					(uintptr_t)desc_addrs[i];
+		lens[i] = pkts[i]->pkt_len + buf_offset;
+	}
+
+	vhost_for_each_try_unroll(i, 0, SPLIT_BATCH_SIZE)
+		virtio_enqueue_offload(pkts[i], &hdrs[i]->hdr);
+
+	if (rxvq_is_mergeable(dev)) {
+		vhost_for_each_try_unroll(i, 0, SPLIT_BATCH_SIZE)
+			ASSIGN_UNLESS_EQUAL(hdrs[i]->num_buffers, 1);
+	}
+
+	vhost_for_each_try_unroll(i, 0, SPLIT_BATCH_SIZE) {
+		rte_memcpy((void *)(uintptr_t)(desc_addrs[i] + buf_offset),
+			   rte_pktmbuf_mtod_offset(pkts[i], void *, 0),
+			   pkts[i]->pkt_len);
+	}
+
+	vhost_for_each_try_unroll(i, 0, SPLIT_BATCH_SIZE)
+		vhost_log_cache_write_iova(dev, vq, descs[ids[i]].addr,
+					   lens[i]);
+
+	vhost_for_each_try_unroll(i, 0, SPLIT_BATCH_SIZE)
+		update_shadow_used_ring_split(vq, ids[i], lens[i]);
+
+	vq->last_avail_idx += SPLIT_BATCH_SIZE;
+
+	return 0;
+}
+
 static __rte_noinline uint32_t
 virtio_dev_rx_split(struct virtio_net *dev, struct vhost_virtqueue *vq,
 	struct rte_mbuf **pkts, uint32_t count)
@@ -1219,10 +1312,20 @@ virtio_dev_rx_split(struct virtio_net *dev, struct vhost_virtqueue *vq,
 
 	rte_prefetch0(&vq->avail->ring[vq->last_avail_idx & (vq->size - 1)]);
 
-	for (pkt_idx = 0; pkt_idx < count; pkt_idx++) {
-		uint32_t pkt_len = pkts[pkt_idx]->pkt_len + dev->vhost_hlen;
+	pkt_idx = 0;
+	while (pkt_idx < count) {
+		uint32_t pkt_len;
 		uint16_t nr_vec = 0;
 
+		if (count - pkt_idx >= SPLIT_BATCH_SIZE) {
+			if (!virtio_dev_rx_batch_split(dev, vq, &pkts[pkt_idx],
+						       avail_head)) {
+				pkt_idx += SPLIT_BATCH_SIZE;
+				continue;
+			}
+		}
+
+		pkt_len = pkts[pkt_idx]->pkt_len + dev->vhost_hlen;
 		if (unlikely(reserve_avail_buf_split(dev, vq,
 						pkt_len, buf_vec, &num_buffers,
 						avail_head, &nr_vec) < 0)) {
@@ -1245,6 +1348,7 @@ virtio_dev_rx_split(struct virtio_net *dev, struct vhost_virtqueue *vq,
 		}
 
 		vq->last_avail_idx += num_buffers;
+		pkt_idx++;
 	}
 
 	do_data_copy_enqueue(dev, vq);
@@ -1416,6 +1520,7 @@ virtio_dev_rx(struct virtio_net *dev, uint16_t queue_id,
 	vq = dev->virtqueue[queue_id];
 
 	rte_spinlock_lock(&vq->access_lock);
+	vhost_vring_poll_lcore(vq);
 
 	if (unlikely(!vq->enabled))
 		goto out_access_unlock;
@@ -1427,6 +1532,8 @@ virtio_dev_rx(struct virtio_net *dev, uint16_t queue_id,
 		if (unlikely(vring_translate(dev, vq) < 0))
 			goto out;
 
+	vhost_vring_call_deferred(dev, vq);
+
 	count = RTE_MIN((uint32_t)MAX_PKT_BURST, count);
 	if (count == 0)
 		goto out;
@@ -1469,8 +1576,18 @@ static __rte_always_inline uint16_t
 virtio_dev_rx_async_get_info_idx(uint16_t pkts_idx,
 	uint16_t vq_size, uint16_t n_inflight)
 {
-	return pkts_idx > n_inflight ? (pkts_idx - n_inflight) :
-		(vq_size - n_inflight + pkts_idx) & (vq_size - 1);
+	return pkts_idx >= n_inflight ? (pkts_idx - n_inflight) :
+		(vq_size - n_inflight + pkts_idx);
+}
+
+/*
+ * Wrap an index lower than twice the ring size. The async indexes of a packed
+ * ring are kept below the ring size, which is not necessarily a power of two.
+ */
+static __rte_always_inline uint16_t
+async_idx_wrap(struct vhost_virtqueue *vq, uint32_t idx)
+{
+	return idx >= vq->size ? idx - vq->size : idx;
 }
 
 static __rte_always_inline void
@@ -1565,11 +1682,11 @@ virtio_dev_rx_async_submit_split(struct virtio_net *dev,
 			break;
 		}
 
-		slot_idx = (vq->async_pkts_idx + num_async_pkts) &
-			(vq->size - 1);
 		if (it_pool[it_idx].count) {
 			uint16_t from, to;
 
+			slot_idx = (vq->async_pkts_idx + num_async_pkts) &
+				(vq->size - 1);
 			async_fill_desc(&tdes[pkt_burst_idx++],
 				&it_pool[it_idx], &it_pool[it_idx + 1]);
 			pkts_info[slot_idx].descs = num_buffers;
@@ -1579,9 +1696,8 @@ virtio_dev_rx_async_submit_split(struct virtio_net *dev,
 				vq->last_avail_idx;
 
 			iovec_idx += it_pool[it_idx].nr_segs;
-			it_idx += 2;
-
 			segs_await += it_pool[it_idx].nr_segs;
+			it_idx += 2;
 
 			/**
 			 * recover shadow used ring and keep DMA-occupied
@@ -1702,7 +1818,7 @@ vhost_update_used_packed(struct vhost_virtqueue *vq,
 	for (i = 0; i < count; i++) {
 		uint16_t flags;
 
-		if (vq->shadow_used_packed[i].len)
+		if (shadow_ring[i].len)
 			flags = VRING_DESC_F_WRITE;
 		else
 			flags = 0;
@@ -1862,12 +1978,13 @@ dma_error_handler_packed(struct vhost_virtqueue *vq, struct vring_packed_desc *a
 	*pkt_idx -= nr_err;
 	/* calculate the sum of buffers and descs of DMA-error packets. */
 	while (nr_err-- > 0) {
-		descs_err += pkts_info[slot_idx % vq->size].descs;
-		buffers_err += pkts_info[slot_idx % vq->size].nr_buffers;
-		slot_idx--;
+		descs_err += pkts_info[slot_idx].descs;
+		buffers_err += pkts_info[slot_idx].nr_buffers;
+		slot_idx = slot_idx ? slot_idx - 1 : vq->size - 1;
 	}
 
-	vq->async_buffer_idx_packed -= buffers_err;
+	vq->async_buffer_idx_packed = async_idx_wrap(vq,
+			vq->async_buffer_idx_packed + vq->size - buffers_err);
 
 	if (vq->last_avail_idx >= descs_err) {
 		vq->last_avail_idx -= descs_err;
@@ -1941,10 +2058,11 @@ virtio_dev_rx_async_submit_packed(struct virtio_net *dev,
 			dev->vid, vq->last_avail_idx,
 			vq->last_avail_idx + num_descs);
 
-		slot_idx = (vq->async_pkts_idx + num_async_pkts) % vq->size;
 		if (it_pool[it_idx].count) {
 			uint16_t from, to;
 
+			slot_idx = async_idx_wrap(vq,
+					vq->async_pkts_idx + num_async_pkts);
 			async_descs_idx += num_descs;
 			async_fill_desc(&tdes[pkt_burst_idx++],
 				&it_pool[it_idx], &it_pool[it_idx + 1]);
@@ -1953,20 +2071,20 @@ virtio_dev_rx_async_submit_packed(struct virtio_net *dev,
 			pkts_info[slot_idx].mbuf = pkts[pkt_idx];
 			num_async_pkts++;
 			iovec_idx += it_pool[it_idx].nr_segs;
-			it_idx += 2;
-
 			segs_await += it_pool[it_idx].nr_segs;
+			it_idx += 2;
 
 			/**
 			 * recover shadow used ring and keep DMA-occupied
 			 * descriptors.
 			 */
 			from = vq->shadow_used_idx - num_buffers;
-			to = vq->async_buffer_idx_packed % vq->size;
+			to = vq->async_buffer_idx_packed;
 			store_dma_desc_info_packed(vq->shadow_used_packed,
 					vq->async_buffers_packed, vq->size, from, to, num_buffers);
 
-			vq->async_buffer_idx_packed += num_buffers;
+			vq->async_buffer_idx_packed = async_idx_wrap(vq,
+					vq->async_buffer_idx_packed + num_buffers);
 			vq->shadow_used_idx -= num_buffers;
 		} else {
 			comp_pkts[num_done_pkts++] = pkts[pkt_idx];
@@ -2018,7 +2136,8 @@ virtio_dev_rx_async_submit_packed(struct virtio_net *dev,
 	if (unlikely(pkt_err))
 		dma_error_handler_packed(vq, async_descs, async_descs_idx, slot_idx, pkt_err,
 					&pkt_idx, &num_async_pkts, &num_done_pkts);
-	vq->async_pkts_idx += num_async_pkts;
+	vq->async_pkts_idx = async_idx_wrap(vq,
+			vq->async_pkts_idx + num_async_pkts);
 	*comp_count = num_done_pkts;
 
 	if (likely(vq->shadow_used_idx)) {
@@ -2067,16 +2186,16 @@ write_back_completed_descs_packed(struct vhost_virtqueue *vq,
 	uint16_t from, to;
 
 	do {
-		from = vq->last_async_buffer_idx_packed % vq->size;
-		to = (from + nr_left) % vq->size;
+		from = vq->last_async_buffer_idx_packed;
+		to = async_idx_wrap(vq, from + nr_left);
 		if (to > from) {
 			vhost_update_used_packed(vq, vq->async_buffers_packed + from, to - from);
-			vq->last_async_buffer_idx_packed += nr_left;
+			vq->last_async_buffer_idx_packed = to;
 			nr_left = 0;
 		} else {
 			vhost_update_used_packed(vq, vq->async_buffers_packed + from,
 				vq->size - from);
-			vq->last_async_buffer_idx_packed += vq->size - from;
+			vq->last_async_buffer_idx_packed = 0;
 			nr_left -= vq->size - from;
 		}
 	} while (nr_left > 0);
@@ -2131,7 +2250,7 @@ uint16_t rte_vhost_poll_enqueue_completed(int vid, uint16_t queue_id,
 
 	if (vq_is_packed(dev)) {
 		for (i = 0; i < n_pkts_put; i++) {
-			from = (start_idx + i) & (vq_size - 1);
+			from = async_idx_wrap(vq, start_idx + i);
 			n_buffers += pkts_info[from].nr_buffers;
 			pkts[i] = pkts_info[from].mbuf;
 		}
@@ -2160,7 +2279,8 @@ uint16_t rte_vhost_poll_enqueue_completed(int vid, uint16_t queue_id,
 		}
 	} else {
 		if (vq_is_packed(dev))
-			vq->last_async_buffer_idx_packed += n_buffers;
+			vq->last_async_buffer_idx_packed = async_idx_wrap(vq,
+				vq->last_async_buffer_idx_packed + n_buffers);
 		else
 			vq->last_async_desc_idx_split += n_descs;
 	}
@@ -2189,6 +2309,7 @@ virtio_dev_rx_async_submit(struct virtio_net *dev, uint16_t queue_id,
 	vq = dev->virtqueue[queue_id];
 
 	rte_spinlock_lock(&vq->access_lock);
+	vhost_vring_poll_lcore(vq);
 
 	if (unlikely(!vq->enabled || !vq->async_registered))
 		goto out_access_unlock;
@@ -2200,6 +2321,8 @@ virtio_dev_rx_async_submit(struct virtio_net *dev, uint16_t queue_id,
 		if (unlikely(vring_translate(dev, vq) < 0))
 			goto out;
 
+	vhost_vring_call_deferred(dev, vq);
+
 	count = RTE_MIN((uint32_t)MAX_PKT_BURST, count);
 	if (count == 0)
 		goto out;
@@ -2410,7 +2533,7 @@ vhost_dequeue_offload(struct virtio_net_hdr *hdr, struct rte_mbuf *m,
 			 */
 			uint16_t csum = 0, off;
 
-			if (rte_raw_cksum_mbuf(m, hdr->csum_start,
+			if (rte_net_raw_cksum_mbuf(m, hdr->csum_start,
 					rte_pktmbuf_pkt_len(m) - hdr->csum_start, &csum) < 0)
 				return;
 			if (likely(csum != 0xffff))
@@ -3059,6 +3182,100 @@ virtio_dev_tx_packed_compliant(struct virtio_net *dev,
 	return virtio_dev_tx_packed(dev, vq, mbuf_pool, pkts, count, false);
 }
 
+static __rte_always_inline bool
+vhost_gro_is_tcp(uint32_t ptype)
+{
+	return (ptype & RTE_PTYPE_L4_MASK) == RTE_PTYPE_L4_TCP &&
+		!RTE_ETH_IS_TUNNEL_PKT(ptype);
+}
+
+static __rte_always_inline uint32_t
+vhost_gro_payload_len(struct rte_mbuf *m)
+{
+	return m->pkt_len - m->l2_len - m->l3_len - m->l4_len;
+}
+
+/* Flag a merged TCP packet like a TSO packet sent by the guest */
+static void
+vhost_gro_set_offload(struct rte_mbuf *m, bool legacy_ol_flags)
+{
+	struct rte_ipv4_hdr *ipv4_hdr;
+	struct rte_ipv6_hdr *ipv6_hdr;
+	struct rte_tcp_hdr *tcp_hdr;
+	uint64_t ol_flags = PKT_TX_TCP_SEG;
+
+	/* GRO only updates the IP length, the segments get new checksums */
+	tcp_hdr = rte_pktmbuf_mtod_offset(m, struct rte_tcp_hdr *,
+		m->l2_len + m->l3_len);
+	if (RTE_ETH_IS_IPV4_HDR(m->packet_type)) {
+		ipv4_hdr = rte_pktmbuf_mtod_offset(m, struct rte_ipv4_hdr *,
+			m->l2_len);
+		ipv4_hdr->hdr_checksum = 0;
+		ipv4_hdr->hdr_checksum = rte_ipv4_cksum(ipv4_hdr);
+		ol_flags |= PKT_TX_IPV4;
+		tcp_hdr->cksum = rte_ipv4_phdr_cksum(ipv4_hdr, ol_flags);
+	} else {
+		ipv6_hdr = rte_pktmbuf_mtod_offset(m, struct rte_ipv6_hdr *,
+			m->l2_len);
+		ol_flags |= PKT_TX_IPV6;
+		tcp_hdr->cksum = rte_ipv6_phdr_cksum(ipv6_hdr, ol_flags);
+	}
+
+	if (legacy_ol_flags)
+		m->ol_flags |= ol_flags;
+	else
+		m->ol_flags |= PKT_RX_LRO | PKT_RX_L4_CKSUM_NONE;
+}
+
+/*
+ * Merge the TCP segments dequeued from the guest with the GRO context of
+ * the virtqueue, and return the packets not held by it along with the
+ * ones timed out, up to max.
+ */
+static __rte_noinline uint16_t
+vhost_dequeue_gro(struct virtio_net *dev, struct vhost_virtqueue *vq,
+	struct rte_mbuf **pkts, uint16_t count, uint16_t max)
+{
+	bool legacy_ol_flags = !!(dev->flags & VIRTIO_DEV_LEGACY_OL_FLAGS);
+	struct rte_net_hdr_lens hdr_lens;
+	struct rte_mbuf *m;
+	uint16_t i, nb;
+
+	for (i = 0; i < count; i++) {
+		m = pkts[i];
+		m->packet_type = rte_net_get_ptype(m, &hdr_lens,
+			RTE_PTYPE_ALL_MASK);
+		if (!vhost_gro_is_tcp(m->packet_type))
+			continue;
+
+		m->l2_len = hdr_lens.l2_len;
+		m->l3_len = hdr_lens.l3_len;
+		m->l4_len = hdr_lens.l4_len;
+		/* keep the segment size of the packets the guest did not send
+		 * with TSO, to find the merged ones
+		 */
+		if ((m->ol_flags & (PKT_TX_TCP_SEG | PKT_RX_LRO)) == 0)
+			m->tso_segsz = vhost_gro_payload_len(m);
+	}
+
+	nb = rte_gro_reassemble(pkts, count, vq->gro_ctx);
+	nb += rte_gro_timeout_flush(vq->gro_ctx, vq->gro_timeout_cycles,
+		RTE_GRO_TCP_IPV4 | RTE_GRO_TCP_IPV6, &pkts[nb], max - nb);
+
+	for (i = 0; i < nb; i++) {
+		m = pkts[i];
+		if (!vhost_gro_is_tcp(m->packet_type))
+			continue;
+
+		if (vhost_gro_payload_len(m) > m->tso_segsz)
+			vhost_gro_set_offload(m, legacy_ol_flags);
+		else if ((m->ol_flags & (PKT_TX_TCP_SEG | PKT_RX_LRO)) == 0)
+			m->tso_segsz = 0;
+	}
+
+	return nb;
+}
+
 uint16_t
 rte_vhost_dequeue_burst(int vid, uint16_t queue_id,
 	struct rte_mempool *mbuf_pool, struct rte_mbuf **pkts, uint16_t count)
@@ -3067,6 +3284,7 @@ rte_vhost_dequeue_burst(int vid, uint16_t queue_id,
 	struct rte_mbuf *rarp_mbuf = NULL;
 	struct vhost_virtqueue *vq;
 	int16_t success = 1;
+	uint16_t max_count;
 
 	dev = get_device(vid);
 	if (!dev)
@@ -3090,6 +3308,7 @@ rte_vhost_dequeue_burst(int vid, uint16_t queue_id,
 
 	if (unlikely(rte_spinlock_trylock(&vq->access_lock) == 0))
 		return 0;
+	vhost_vring_poll_lcore(vq);
 
 	if (unlikely(!vq->enabled)) {
 		count = 0;
@@ -3105,6 +3324,8 @@ rte_vhost_dequeue_burst(int vid, uint16_t queue_id,
 			goto out;
 		}
 
+	vhost_vring_call_deferred(dev, vq);
+
 	/*
 	 * Construct a RARP broadcast packet, and inject it to the "pkts"
 	 * array, to looks like that guest actually send such packet.
@@ -3134,6 +3355,7 @@ rte_vhost_dequeue_burst(int vid, uint16_t queue_id,
 		count -= 1;
 	}
 
+	max_count = count;
 	if (vq_is_packed(dev)) {
 		if (dev->flags & VIRTIO_DEV_LEGACY_OL_FLAGS)
 			count = virtio_dev_tx_packed_legacy(dev, vq, mbuf_pool, pkts, count);
@@ -3146,6 +3368,737 @@ rte_vhost_dequeue_burst(int vid, uint16_t queue_id,
 			count = virtio_dev_tx_split_compliant(dev, vq, mbuf_pool, pkts, count);
 	}
 
+	if (vq->gro_ctx != NULL)
+		count = vhost_dequeue_gro(dev, vq, pkts, count, max_count);
+
+out:
+	if (dev->features & (1ULL << VIRTIO_F_IOMMU_PLATFORM))
+		vhost_user_iotlb_rd_unlock(vq);
+
+out_access_unlock:
+	rte_spinlock_unlock(&vq->access_lock);
+
+	if (unlikely(rarp_mbuf != NULL)) {
+		/*
+		 * Inject it to the head of "pkts" array, so that switch's mac
+		 * learning table will get updated first.
+		 */
+		memmove(&pkts[1], pkts, count * sizeof(struct rte_mbuf *));
+		pkts[0] = rarp_mbuf;
+		count += 1;
+	}
+
+	return count;
+}
+
+static __rte_always_inline int
+async_desc_to_mbuf(struct virtio_net *dev, struct vhost_virtqueue *vq,
+		  struct buf_vector *buf_vec, uint16_t nr_vec,
+		  struct rte_mbuf *m, struct rte_mempool *mbuf_pool,
+		  struct virtio_net_hdr *nethdr,
+		  struct iovec *src_iovec, struct iovec *dst_iovec,
+		  struct rte_vhost_iov_iter *src_it,
+		  struct rte_vhost_iov_iter *dst_it)
+{
+	uint32_t buf_avail, buf_offset;
+	uint64_t buf_addr, buf_iova, buf_len;
+	uint32_t mbuf_avail, mbuf_offset;
+	uint32_t cpy_len, cpy_threshold;
+	struct rte_mbuf *cur = m, *prev = m;
+	/* A counter to avoid desc dead loop chain */
+	uint16_t vec_idx = 0;
+	struct batch_copy_elem *batch_copy = vq->batch_copy_elems;
+	uint64_t mapped_len;
+	uint32_t tlen = 0;
+	int tvec_idx = 0;
+	void *hpa;
+
+	cpy_threshold = vq->async_threshold;
+
+	buf_addr = buf_vec[vec_idx].buf_addr;
+	buf_iova = buf_vec[vec_idx].buf_iova;
+	buf_len = buf_vec[vec_idx].buf_len;
+
+	if (unlikely(buf_len < dev->vhost_hlen && nr_vec <= 1))
+		return -1;
+
+	/*
+	 * The header is read by the CPU, the offloads are only applied once
+	 * the packet data is copied.
+	 */
+	if (virtio_net_with_host_offload(dev)) {
+		if (unlikely(buf_len < sizeof(struct virtio_net_hdr)))
+			copy_vnet_hdr_from_desc(nethdr, buf_vec);
+		else
+			rte_memcpy(nethdr, (void *)(uintptr_t)buf_addr,
+				   sizeof(struct virtio_net_hdr));
+	}
+
+	if (unlikely(buf_len < dev->vhost_hlen)) {
+		buf_offset = dev->vhost_hlen - buf_len;
+		vec_idx++;
+		buf_addr = buf_vec[vec_idx].buf_addr;
+		buf_iova = buf_vec[vec_idx].buf_iova;
+		buf_len = buf_vec[vec_idx].buf_len;
+		buf_avail  = buf_len - buf_offset;
+	} else if (buf_len == dev->vhost_hlen) {
+		if (unlikely(++vec_idx >= nr_vec))
+			goto out;
+		buf_addr = buf_vec[vec_idx].buf_addr;
+		buf_iova = buf_vec[vec_idx].buf_iova;
+		buf_len = buf_vec[vec_idx].buf_len;
+
+		buf_offset = 0;
+		buf_avail = buf_len;
+	} else {
+		buf_offset = dev->vhost_hlen;
+		buf_avail = buf_vec[vec_idx].buf_len - dev->vhost_hlen;
+	}
+
+	mbuf_offset = 0;
+	mbuf_avail  = m->buf_len - RTE_PKTMBUF_HEADROOM;
+	while (1) {
+		cpy_len = RTE_MIN(buf_avail, mbuf_avail);
+
+		while (cpy_len && cpy_len >= cpy_threshold &&
+				tvec_idx < BUF_VECTOR_MAX) {
+			hpa = (void *)(uintptr_t)gpa_to_first_hpa(dev,
+					buf_iova + buf_offset,
+					cpy_len, &mapped_len);
+
+			if (unlikely(!hpa || mapped_len < cpy_threshold))
+				break;
+
+			async_fill_vec(src_iovec + tvec_idx, hpa,
+					(size_t)mapped_len);
+
+			async_fill_vec(dst_iovec + tvec_idx,
+				(void *)(uintptr_t)rte_pktmbuf_iova_offset(cur,
+				mbuf_offset), (size_t)mapped_len);
+
+			tlen += (uint32_t)mapped_len;
+			cpy_len -= (uint32_t)mapped_len;
+			mbuf_avail  -= (uint32_t)mapped_len;
+			mbuf_offset += (uint32_t)mapped_len;
+			buf_avail  -= (uint32_t)mapped_len;
+			buf_offset += (uint32_t)mapped_len;
+			tvec_idx++;
+		}
+
+		if (likely(cpy_len)) {
+			if (cpy_len > MAX_BATCH_LEN ||
+					vq->batch_copy_nb_elems >= vq->size) {
+				rte_memcpy(rte_pktmbuf_mtod_offset(cur, void *,
+							mbuf_offset),
+					(void *)((uintptr_t)(buf_addr +
+							buf_offset)), cpy_len);
+			} else {
+				batch_copy[vq->batch_copy_nb_elems].dst =
+					rte_pktmbuf_mtod_offset(cur, void *,
+							mbuf_offset);
+				batch_copy[vq->batch_copy_nb_elems].src =
+					(void *)((uintptr_t)(buf_addr +
+							buf_offset));
+				batch_copy[vq->batch_copy_nb_elems].len =
+					cpy_len;
+				vq->batch_copy_nb_elems++;
+			}
+
+			mbuf_avail  -= cpy_len;
+			mbuf_offset += cpy_len;
+			buf_avail -= cpy_len;
+			buf_offset += cpy_len;
+		}
+
+		/* This buf reaches to its end, get the next one */
+		if (buf_avail == 0) {
+			if (++vec_idx >= nr_vec)
+				break;
+
+			buf_addr = buf_vec[vec_idx].buf_addr;
+			buf_iova = buf_vec[vec_idx].buf_iova;
+			buf_len = buf_vec[vec_idx].buf_len;
+
+			buf_offset = 0;
+			buf_avail  = buf_len;
+		}
+
+		/*
+		 * This mbuf reaches to its end, get a new one
+		 * to hold more data.
+		 */
+		if (mbuf_avail == 0) {
+			cur = rte_pktmbuf_alloc(mbuf_pool);
+			if (unlikely(cur == NULL)) {
+				VHOST_LOG_DATA(ERR, "Failed to "
+					"allocate memory for mbuf.\n");
+				return -1;
+			}
+
+			prev->next = cur;
+			prev->data_len = mbuf_offset;
+			m->nb_segs += 1;
+			m->pkt_len += mbuf_offset;
+			prev = cur;
+
+			mbuf_offset = 0;
+			mbuf_avail  = cur->buf_len - RTE_PKTMBUF_HEADROOM;
+		}
+	}
+
+	prev->data_len = mbuf_offset;
+	m->pkt_len    += mbuf_offset;
+
+out:
+	if (tlen) {
+		async_fill_iter(src_it, tlen, src_iovec, tvec_idx);
+		async_fill_iter(dst_it, tlen, dst_iovec, tvec_idx);
+	} else {
+		src_it->count = 0;
+	}
+
+	return 0;
+}
+
+/*
+ * Copy the guest buffer of a packet to a mbuf and record the packet in its
+ * async in-flight slot. A packet which cannot be copied is dropped, its slot
+ * is kept with no mbuf so that its descriptors are still made used in order.
+ */
+static __rte_always_inline void
+async_tx_fill_pkt(struct virtio_net *dev, struct vhost_virtqueue *vq,
+		  struct buf_vector *buf_vec, uint16_t nr_vec, uint32_t buf_len,
+		  struct rte_mbuf *pkt, struct rte_mempool *mbuf_pool,
+		  struct async_inflight_info *pkt_info,
+		  struct iovec *src_iovec, struct iovec *dst_iovec,
+		  struct rte_vhost_iov_iter *src_it,
+		  struct rte_vhost_iov_iter *dst_it)
+{
+	uint16_t nb_elems = vq->batch_copy_nb_elems;
+	static bool allocerr_warned;
+
+	pkt_info->mbuf = pkt;
+
+	if (unlikely(virtio_dev_pktmbuf_prep(dev, pkt, buf_len))) {
+		if (!allocerr_warned) {
+			VHOST_LOG_DATA(ERR,
+				"Failed mbuf alloc of size %d from %s on %s.\n",
+				buf_len, mbuf_pool->name, dev->ifname);
+			allocerr_warned = true;
+		}
+		goto drop;
+	}
+
+	if (unlikely(async_desc_to_mbuf(dev, vq, buf_vec, nr_vec, pkt,
+					mbuf_pool, &pkt_info->nethdr,
+					src_iovec, dst_iovec,
+					src_it, dst_it) < 0)) {
+		if (!allocerr_warned) {
+			VHOST_LOG_DATA(ERR,
+				"Failed to copy desc to mbuf on %s.\n",
+				dev->ifname);
+			allocerr_warned = true;
+		}
+		goto drop;
+	}
+
+	pkt_info->cpu_done = src_it->count == 0;
+
+	return;
+
+drop:
+	/* Discard the CPU copies of the packet before freeing it */
+	vq->batch_copy_nb_elems = nb_elems;
+	src_it->count = 0;
+	rte_pktmbuf_free(pkt);
+	pkt_info->mbuf = NULL;
+	pkt_info->cpu_done = true;
+}
+
+/*
+ * Return the oldest in-flight packets which are copied, in the order they
+ * were dequeued, and make their descriptors used.
+ */
+static __rte_always_inline uint16_t
+async_poll_dequeue_completed(struct virtio_net *dev,
+		struct vhost_virtqueue *vq, uint16_t queue_id,
+		struct rte_mbuf **pkts, uint16_t count, bool legacy_ol_flags)
+{
+	struct async_inflight_info *pkts_info = vq->async_pkts_info;
+	uint16_t n_pkts = 0, n_slots = 0, n_dma_cpl = 0;
+	uint16_t start_idx, from;
+
+	if (vq->async_pkts_inflight_n == 0 || count == 0)
+		return 0;
+
+	start_idx = virtio_dev_rx_async_get_info_idx(
+		vq->async_pkts_idx % vq->size, vq->size,
+		vq->async_pkts_inflight_n);
+
+	if (count > vq->async_last_pkts_n)
+		n_dma_cpl = vq->async_ops.check_completed_copies(dev->vid,
+			queue_id, 0, count - vq->async_last_pkts_n);
+	n_dma_cpl += vq->async_last_pkts_n;
+
+	while (n_pkts < count && n_slots < vq->async_pkts_inflight_n) {
+		from = async_idx_wrap(vq, start_idx + n_slots);
+		if (!pkts_info[from].cpu_done) {
+			if (n_dma_cpl == 0)
+				break;
+			n_dma_cpl--;
+		}
+		n_slots++;
+
+		if (unlikely(pkts_info[from].mbuf == NULL))
+			continue;
+
+		pkts[n_pkts] = pkts_info[from].mbuf;
+		if (virtio_net_with_host_offload(dev))
+			vhost_dequeue_offload(&pkts_info[from].nethdr,
+					pkts[n_pkts], legacy_ol_flags);
+		n_pkts++;
+	}
+
+	vq->async_last_pkts_n = n_dma_cpl;
+	vq->async_pkts_inflight_n -= n_slots;
+
+	if (n_slots == 0)
+		return 0;
+
+	if (vq_is_packed(dev)) {
+		write_back_completed_descs_packed(vq, n_slots);
+
+		vhost_vring_call_packed(dev, vq);
+	} else {
+		write_back_completed_descs_split(vq, n_slots);
+
+		__atomic_add_fetch(&vq->used->idx, n_slots, __ATOMIC_RELEASE);
+		vhost_vring_call_split(dev, vq);
+	}
+
+	return n_pkts;
+}
+
+/*
+ * Submit the copies of the in-flight packets to the async channel. On a
+ * channel error, the packets from the first one not accepted on are freed
+ * and their number is returned, so that their descriptors are dequeued again.
+ */
+static __rte_always_inline uint16_t
+async_tx_transfer(struct virtio_net *dev, struct vhost_virtqueue *vq,
+		  uint16_t queue_id, struct rte_vhost_async_desc *tdes,
+		  const uint16_t *tdes_pkt_idx, uint16_t n_tdes,
+		  uint16_t nr_pkts)
+{
+	struct async_inflight_info *pkts_info = vq->async_pkts_info;
+	uint32_t n_xfer;
+	uint16_t i, slot_idx;
+
+	n_xfer = vq->async_ops.transfer_data(dev->vid, queue_id, tdes, 0,
+			n_tdes);
+	if (likely(n_xfer >= n_tdes))
+		return 0;
+
+	VHOST_LOG_DATA(DEBUG, "(%d) %s: failed to transfer %u packets\n",
+		dev->vid, __func__, n_tdes - n_xfer);
+
+	/* The CPU copies may target the mbufs to free */
+	do_data_copy_dequeue(vq);
+
+	for (i = tdes_pkt_idx[n_xfer]; i < nr_pkts; i++) {
+		slot_idx = (vq->async_pkts_idx + i) % vq->size;
+		rte_pktmbuf_free(pkts_info[slot_idx].mbuf);
+	}
+
+	return nr_pkts - tdes_pkt_idx[n_xfer];
+}
+
+__rte_always_inline
+static uint16_t
+virtio_dev_tx_async_split(struct virtio_net *dev,
+		struct vhost_virtqueue *vq, uint16_t queue_id,
+		struct rte_mempool *mbuf_pool, struct rte_mbuf **pkts,
+		uint16_t count, bool legacy_ol_flags)
+{
+	struct rte_mbuf *pkts_prealloc[MAX_PKT_BURST];
+	struct rte_vhost_async_desc tdes[MAX_PKT_BURST];
+	uint16_t tdes_pkt_idx[MAX_PKT_BURST];
+	struct rte_vhost_iov_iter *it_pool = vq->it_pool;
+	struct iovec *vec_pool = vq->vec_pool;
+	struct iovec *src_iovec = vec_pool;
+	struct iovec *dst_iovec = vec_pool + (VHOST_MAX_ASYNC_VEC >> 1);
+	struct async_inflight_info *pkts_info = vq->async_pkts_info;
+	uint16_t pkt_idx, pkt_burst_idx = 0, nr_pkts, nr_err = 0;
+	uint16_t iovec_idx = 0, it_idx = 0, segs_await = 0;
+	uint16_t free_entries, slot_idx, head_idx, to;
+
+	/*
+	 * The ordering between avail index and
+	 * desc reads needs to be enforced.
+	 */
+	free_entries = __atomic_load_n(&vq->avail->idx, __ATOMIC_ACQUIRE) -
+			vq->last_avail_idx;
+	if (free_entries == 0)
+		goto out;
+
+	rte_prefetch0(&vq->avail->ring[vq->last_avail_idx & (vq->size - 1)]);
+
+	nr_pkts = RTE_MIN(count, MAX_PKT_BURST);
+	nr_pkts = RTE_MIN(nr_pkts, free_entries);
+	nr_pkts = RTE_MIN(nr_pkts, vq->size - vq->async_pkts_inflight_n);
+	VHOST_LOG_DATA(DEBUG, "(%d) about to dequeue %u buffers\n",
+			dev->vid, nr_pkts);
+
+	if (rte_pktmbuf_alloc_bulk(mbuf_pool, pkts_prealloc, nr_pkts))
+		goto out;
+
+	for (pkt_idx = 0; pkt_idx < nr_pkts; pkt_idx++) {
+		struct buf_vector buf_vec[BUF_VECTOR_MAX];
+		uint32_t buf_len;
+		uint16_t nr_vec = 0;
+
+		if (unlikely(fill_vec_buf_split(dev, vq,
+						vq->last_avail_idx + pkt_idx,
+						&nr_vec, buf_vec,
+						&head_idx, &buf_len,
+						VHOST_ACCESS_RO) < 0))
+			break;
+
+		slot_idx = (vq->async_pkts_idx + pkt_idx) & (vq->size - 1);
+		async_tx_fill_pkt(dev, vq, buf_vec, nr_vec, buf_len,
+				pkts_prealloc[pkt_idx], mbuf_pool,
+				&pkts_info[slot_idx],
+				&src_iovec[iovec_idx], &dst_iovec[iovec_idx],
+				&it_pool[it_idx], &it_pool[it_idx + 1]);
+
+		/* keep the used element until the copy completion */
+		to = (vq->async_desc_idx_split + pkt_idx) & (vq->size - 1);
+		vq->async_descs_split[to].id = head_idx;
+		vq->async_descs_split[to].len = 0;
+
+		if (it_pool[it_idx].count) {
+			tdes_pkt_idx[pkt_burst_idx] = pkt_idx;
+			async_fill_desc(&tdes[pkt_burst_idx++],
+				&it_pool[it_idx], &it_pool[it_idx + 1]);
+			iovec_idx += it_pool[it_idx].nr_segs;
+			segs_await += it_pool[it_idx].nr_segs;
+			it_idx += 2;
+		}
+
+		/*
+		 * conditions to trigger async device transfer:
+		 * - buffered packet number reaches transfer threshold
+		 * - unused async iov number is less than max vhost vector
+		 */
+		if (unlikely(pkt_burst_idx >= VHOST_ASYNC_BATCH_THRESHOLD ||
+			((VHOST_MAX_ASYNC_VEC >> 1) - segs_await <
+			BUF_VECTOR_MAX))) {
+			nr_err = async_tx_transfer(dev, vq, queue_id, tdes,
+					tdes_pkt_idx, pkt_burst_idx,
+					pkt_idx + 1);
+			iovec_idx = 0;
+			it_idx = 0;
+			segs_await = 0;
+			pkt_burst_idx = 0;
+
+			if (unlikely(nr_err)) {
+				pkt_idx++;
+				break;
+			}
+		}
+	}
+
+	if (pkt_burst_idx)
+		nr_err = async_tx_transfer(dev, vq, queue_id, tdes,
+				tdes_pkt_idx, pkt_burst_idx, pkt_idx);
+
+	do_data_copy_dequeue(vq);
+
+	if (pkt_idx != nr_pkts)
+		rte_pktmbuf_free_bulk(&pkts_prealloc[pkt_idx],
+				nr_pkts - pkt_idx);
+
+	/* the failed packets are dequeued again on the next call */
+	pkt_idx -= nr_err;
+
+	vq->last_avail_idx += pkt_idx;
+	vq->async_desc_idx_split += pkt_idx;
+	vq->async_pkts_idx += pkt_idx;
+	vq->async_pkts_inflight_n += pkt_idx;
+
+out:
+	return async_poll_dequeue_completed(dev, vq, queue_id, pkts, count,
+			legacy_ol_flags);
+}
+
+__rte_noinline
+static uint16_t
+virtio_dev_tx_async_split_legacy(struct virtio_net *dev,
+		struct vhost_virtqueue *vq, uint16_t queue_id,
+		struct rte_mempool *mbuf_pool, struct rte_mbuf **pkts,
+		uint16_t count)
+{
+	return virtio_dev_tx_async_split(dev, vq, queue_id, mbuf_pool,
+			pkts, count, true);
+}
+
+__rte_noinline
+static uint16_t
+virtio_dev_tx_async_split_compliant(struct virtio_net *dev,
+		struct vhost_virtqueue *vq, uint16_t queue_id,
+		struct rte_mempool *mbuf_pool, struct rte_mbuf **pkts,
+		uint16_t count)
+{
+	return virtio_dev_tx_async_split(dev, vq, queue_id, mbuf_pool,
+			pkts, count, false);
+}
+
+__rte_always_inline
+static uint16_t
+virtio_dev_tx_async_packed(struct virtio_net *dev,
+		struct vhost_virtqueue *vq, uint16_t queue_id,
+		struct rte_mempool *mbuf_pool, struct rte_mbuf **pkts,
+		uint16_t count, bool legacy_ol_flags)
+{
+	struct rte_mbuf *pkts_prealloc[MAX_PKT_BURST];
+	struct rte_vhost_async_desc tdes[MAX_PKT_BURST];
+	uint16_t tdes_pkt_idx[MAX_PKT_BURST];
+	struct rte_vhost_iov_iter *it_pool = vq->it_pool;
+	struct iovec *vec_pool = vq->vec_pool;
+	struct iovec *src_iovec = vec_pool;
+	struct iovec *dst_iovec = vec_pool + (VHOST_MAX_ASYNC_VEC >> 1);
+	struct async_inflight_info *pkts_info = vq->async_pkts_info;
+	uint16_t pkt_idx, pkt_burst_idx = 0, nr_pkts, nr_err = 0;
+	uint16_t iovec_idx = 0, it_idx = 0, segs_await = 0;
+	uint16_t slot_idx, buf_id, desc_count, to;
+	struct {
+		uint16_t last_avail_idx;
+		bool avail_wrap_counter;
+	} async_pkts_log[MAX_PKT_BURST];
+
+	nr_pkts = RTE_MIN(count, MAX_PKT_BURST);
+	nr_pkts = RTE_MIN(nr_pkts, vq->size - vq->async_pkts_inflight_n);
+	if (nr_pkts == 0 ||
+	    !desc_is_avail(&vq->desc_packed[vq->last_avail_idx],
+			   vq->avail_wrap_counter))
+		goto out;
+
+	if (rte_pktmbuf_alloc_bulk(mbuf_pool, pkts_prealloc, nr_pkts))
+		goto out;
+
+	for (pkt_idx = 0; pkt_idx < nr_pkts; pkt_idx++) {
+		struct buf_vector buf_vec[BUF_VECTOR_MAX];
+		uint32_t buf_len;
+		uint16_t nr_vec = 0;
+
+		rte_prefetch0(&vq->desc_packed[vq->last_avail_idx]);
+
+		if (unlikely(fill_vec_buf_packed(dev, vq,
+						 vq->last_avail_idx,
+						 &desc_count, buf_vec, &nr_vec,
+						 &buf_id, &buf_len,
+						 VHOST_ACCESS_RO) < 0))
+			break;
+
+		slot_idx = async_idx_wrap(vq, vq->async_pkts_idx + pkt_idx);
+		async_tx_fill_pkt(dev, vq, buf_vec, nr_vec, buf_len,
+				pkts_prealloc[pkt_idx], mbuf_pool,
+				&pkts_info[slot_idx],
+				&src_iovec[iovec_idx], &dst_iovec[iovec_idx],
+				&it_pool[it_idx], &it_pool[it_idx + 1]);
+
+		/* keep the used buffer until the copy completion */
+		to = async_idx_wrap(vq,
+				vq->async_buffer_idx_packed + pkt_idx);
+		vq->async_buffers_packed[to].id = buf_id;
+		vq->async_buffers_packed[to].len = 0;
+		vq->async_buffers_packed[to].count = desc_count;
+
+		async_pkts_log[pkt_idx].last_avail_idx = vq->last_avail_idx;
+		async_pkts_log[pkt_idx].avail_wrap_counter =
+			vq->avail_wrap_counter;
+		vq_inc_last_avail_packed(vq, desc_count);
+
+		if (it_pool[it_idx].count) {
+			tdes_pkt_idx[pkt_burst_idx] = pkt_idx;
+			async_fill_desc(&tdes[pkt_burst_idx++],
+				&it_pool[it_idx], &it_pool[it_idx + 1]);
+			iovec_idx += it_pool[it_idx].nr_segs;
+			segs_await += it_pool[it_idx].nr_segs;
+			it_idx += 2;
+		}
+
+		/*
+		 * conditions to trigger async device transfer:
+		 * - buffered packet number reaches transfer threshold
+		 * - unused async iov number is less than max vhost vector
+		 */
+		if (unlikely(pkt_burst_idx >= VHOST_ASYNC_BATCH_THRESHOLD ||
+			((VHOST_MAX_ASYNC_VEC >> 1) - segs_await <
+			BUF_VECTOR_MAX))) {
+			nr_err = async_tx_transfer(dev, vq, queue_id, tdes,
+					tdes_pkt_idx, pkt_burst_idx,
+					pkt_idx + 1);
+			iovec_idx = 0;
+			it_idx = 0;
+			segs_await = 0;
+			pkt_burst_idx = 0;
+
+			if (unlikely(nr_err)) {
+				pkt_idx++;
+				break;
+			}
+		}
+	}
+
+	if (pkt_burst_idx)
+		nr_err = async_tx_transfer(dev, vq, queue_id, tdes,
+				tdes_pkt_idx, pkt_burst_idx, pkt_idx);
+
+	do_data_copy_dequeue(vq);
+
+	if (pkt_idx != nr_pkts)
+		rte_pktmbuf_free_bulk(&pkts_prealloc[pkt_idx],
+				nr_pkts - pkt_idx);
+
+	/* the failed packets are dequeued again on the next call */
+	if (unlikely(nr_err)) {
+		pkt_idx -= nr_err;
+		vq->last_avail_idx = async_pkts_log[pkt_idx].last_avail_idx;
+		vq->avail_wrap_counter =
+			async_pkts_log[pkt_idx].avail_wrap_counter;
+	}
+
+	vq->async_buffer_idx_packed = async_idx_wrap(vq,
+			vq->async_buffer_idx_packed + pkt_idx);
+	vq->async_pkts_idx = async_idx_wrap(vq, vq->async_pkts_idx + pkt_idx);
+	vq->async_pkts_inflight_n += pkt_idx;
+
+out:
+	return async_poll_dequeue_completed(dev, vq, queue_id, pkts, count,
+			legacy_ol_flags);
+}
+
+__rte_noinline
+static uint16_t
+virtio_dev_tx_async_packed_legacy(struct virtio_net *dev,
+		struct vhost_virtqueue *vq, uint16_t queue_id,
+		struct rte_mempool *mbuf_pool, struct rte_mbuf **pkts,
+		uint16_t count)
+{
+	return virtio_dev_tx_async_packed(dev, vq, queue_id, mbuf_pool,
+			pkts, count, true);
+}
+
+__rte_noinline
+static uint16_t
+virtio_dev_tx_async_packed_compliant(struct virtio_net *dev,
+		struct vhost_virtqueue *vq, uint16_t queue_id,
+		struct rte_mempool *mbuf_pool, struct rte_mbuf **pkts,
+		uint16_t count)
+{
+	return virtio_dev_tx_async_packed(dev, vq, queue_id, mbuf_pool,
+			pkts, count, false);
+}
+
+uint16_t
+rte_vhost_async_try_dequeue_burst(int vid, uint16_t queue_id,
+	struct rte_mempool *mbuf_pool, struct rte_mbuf **pkts, uint16_t count,
+	int *nr_inflight)
+{
+	struct virtio_net *dev;
+	struct rte_mbuf *rarp_mbuf = NULL;
+	struct vhost_virtqueue *vq;
+	int16_t success = 1;
+
+	*nr_inflight = -1;
+
+	dev = get_device(vid);
+	if (!dev)
+		return 0;
+
+	if (unlikely(!(dev->flags & VIRTIO_DEV_BUILTIN_VIRTIO_NET))) {
+		VHOST_LOG_DATA(ERR,
+			"(%d) %s: built-in vhost net backend is disabled.\n",
+			dev->vid, __func__);
+		return 0;
+	}
+
+	if (unlikely(!is_valid_virt_queue_idx(queue_id, 1, dev->nr_vring))) {
+		VHOST_LOG_DATA(ERR,
+			"(%d) %s: invalid virtqueue idx %d.\n",
+			dev->vid, __func__, queue_id);
+		return 0;
+	}
+
+	vq = dev->virtqueue[queue_id];
+
+	if (unlikely(rte_spinlock_trylock(&vq->access_lock) == 0))
+		return 0;
+	vhost_vring_poll_lcore(vq);
+
+	if (unlikely(!vq->async_registered)) {
+		VHOST_LOG_DATA(ERR, "(%d) %s: async not registered for queue id %d.\n",
+			dev->vid, __func__, queue_id);
+		count = 0;
+		goto out_access_unlock;
+	}
+
+	*nr_inflight = vq->async_pkts_inflight_n;
+
+	if (unlikely(!vq->enabled)) {
+		count = 0;
+		goto out_access_unlock;
+	}
+
+	if (dev->features & (1ULL << VIRTIO_F_IOMMU_PLATFORM))
+		vhost_user_iotlb_rd_lock(vq);
+
+	if (unlikely(!vq->access_ok))
+		if (unlikely(vring_translate(dev, vq) < 0)) {
+			count = 0;
+			goto out;
+		}
+
+	vhost_vring_call_deferred(dev, vq);
+
+	/*
+	 * Construct a RARP broadcast packet, and inject it to the "pkts"
+	 * array, to looks like that guest actually send such packet.
+	 *
+	 * Check user_send_rarp() for more information.
+	 */
+	if (unlikely(__atomic_load_n(&dev->broadcast_rarp, __ATOMIC_ACQUIRE) &&
+			__atomic_compare_exchange_n(&dev->broadcast_rarp,
+			&success, 0, 0, __ATOMIC_RELEASE, __ATOMIC_RELAXED))) {
+
+		rarp_mbuf = rte_net_make_rarp_packet(mbuf_pool, &dev->mac);
+		if (rarp_mbuf == NULL) {
+			VHOST_LOG_DATA(ERR, "Failed to make RARP packet.\n");
+			count = 0;
+			goto out;
+		}
+		count -= 1;
+	}
+
+	if (vq_is_packed(dev)) {
+		if (dev->flags & VIRTIO_DEV_LEGACY_OL_FLAGS)
+			count = virtio_dev_tx_async_packed_legacy(dev, vq,
+					queue_id, mbuf_pool, pkts, count);
+		else
+			count = virtio_dev_tx_async_packed_compliant(dev, vq,
+					queue_id, mbuf_pool, pkts, count);
+	} else {
+		if (dev->flags & VIRTIO_DEV_LEGACY_OL_FLAGS)
+			count = virtio_dev_tx_async_split_legacy(dev, vq,
+					queue_id, mbuf_pool, pkts, count);
+		else
+			count = virtio_dev_tx_async_split_compliant(dev, vq,
+					queue_id, mbuf_pool, pkts, count);
+	}
+
+	*nr_inflight = vq->async_pkts_inflight_n;
+
 out:
 	if (dev->features & (1ULL << VIRTIO_F_IOMMU_PLATFORM))
 		vhost_user_iotlb_rd_unlock(vq);